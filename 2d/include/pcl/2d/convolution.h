@@ -43,6 +43,8 @@
 #include <pcl/pcl_macros.h>
 #include <pcl/point_types.h>
 
+#include <vector>
+
 namespace pcl {
 
 /// Point cloud containing edge information.
@@ -101,7 +103,11 @@ public:
     BOUNDARY_OPTION_ZERO_PADDING
   };
 
-  Convolution() { boundary_options_ = BOUNDARY_OPTION_CLAMP; }
+  Convolution()
+  {
+    boundary_options_ = BOUNDARY_OPTION_CLAMP;
+    threads_ = 0;
+  }
 
   /** \brief Sets the kernel to be used for convolution
    * \param[in] kernel convolution kernel passed by reference
@@ -122,8 +128,19 @@ public:
     boundary_options_ = boundary_options;
   }
 
+  /** \brief Set the number of threads to use.
+   * \param[in] nr_threads the number of hardware threads to use (0 sets the value back
+   * to automatic)
+   */
+  inline void
+  setNumberOfThreads(unsigned int nr_threads = 0)
+  {
+    threads_ = nr_threads;
+  }
+
   /** \brief Performs 2D convolution of the input point cloud with the kernel.
-   * Uses clamp as the default boundary option.
+   * Uses clamp as the default boundary option. Separable kernels are applied as a
+   * row pass followed by a column pass.
    * \param[out] output Output point cloud passed by reference
    */
   void
@@ -136,8 +153,29 @@ protected:
   {}
 
 private:
+  /** \brief Index of the input row or column the extended image takes its value
+   * from at \a index, according to the boundary option, or -1 for zero padding.
+   * \param[in] index the row or column index, relative to the input image
+   * \param[in] size the height or width of the input image
+   */
+  int
+  borderIndex(int index, int size) const;
+
+  /** \brief Check whether the kernel is the outer product of a column and a row
+   * kernel, and compute them if so.
+   * \param[out] column_kernel the column kernel, of size kernel height
+   * \param[out] row_kernel the row kernel, of size kernel width
+   * \return true if the kernel is separable
+   */
+  bool
+  separateKernel(std::vector<float>& column_kernel,
+                 std::vector<float>& row_kernel) const;
+
   BOUNDARY_OPTIONS_ENUM boundary_options_;
   pcl::PointCloud<PointT> kernel_;
+
+  /** \brief The number of threads the scheduler should use. */
+  unsigned int threads_;
 };
 } // namespace pcl
 
@@ -123,6 +123,7 @@ private:
   float hysteresis_threshold_high_;
   float non_max_suppression_radius_x_;
   float non_max_suppression_radius_y_;
+  unsigned int threads_;
 
 public:
   Edge()
@@ -134,6 +135,7 @@ public:
   , hysteresis_threshold_high_(80)
   , non_max_suppression_radius_x_(3)
   , non_max_suppression_radius_y_(3)
+  , threads_(0)
   {}
 
   /** \brief Set the output type.
@@ -145,6 +147,17 @@ public:
     output_type_ = output_type;
   }
 
+  /** \brief Set the number of threads to use, also for the convolutions.
+   * \param[in] nr_threads the number of hardware threads to use (0 sets the value back
+   * to automatic)
+   */
+  void
+  setNumberOfThreads(unsigned int nr_threads = 0)
+  {
+    threads_ = nr_threads;
+    convolution_.setNumberOfThreads(nr_threads);
+  }
+
   void
   setHysteresisThresholdLow(float threshold)
   {
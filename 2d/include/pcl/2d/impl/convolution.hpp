@@ -38,101 +38,198 @@
 #pragma once
 
 #include <pcl/2d/convolution.h>
+#include <pcl/common/utils.h> // for getNumberOfThreads
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 namespace pcl {
+namespace detail {
+/** \brief Compute dst[x] = sum_m weights[m] * src[m][x] for x in [0, count), using
+ * AVX or SSE2 instructions when available. The terms are summed in the order of the
+ * weights in all paths, so the result does not depend on the instruction set.
+ */
+inline void
+convolveRow(const float* const* src, const float* weights, int n, float* dst, int count)
+{
+  int x = 0;
+#if defined(__AVX__)
+  for (; x + 8 <= count; x += 8) {
+    __m256 sum = _mm256_mul_ps(_mm256_set1_ps(weights[0]), _mm256_loadu_ps(src[0] + x));
+    for (int m = 1; m < n; ++m)
+      sum = _mm256_add_ps(
+          sum, _mm256_mul_ps(_mm256_set1_ps(weights[m]), _mm256_loadu_ps(src[m] + x)));
+    _mm256_storeu_ps(dst + x, sum);
+  }
+#endif
+#if defined(__SSE2__)
+  for (; x + 4 <= count; x += 4) {
+    __m128 sum = _mm_mul_ps(_mm_set1_ps(weights[0]), _mm_loadu_ps(src[0] + x));
+    for (int m = 1; m < n; ++m)
+      sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(weights[m]), _mm_loadu_ps(src[m] + x)));
+    _mm_storeu_ps(dst + x, sum);
+  }
+#endif
+  for (; x < count; ++x) {
+    float sum = weights[0] * src[0][x];
+    for (int m = 1; m < n; ++m)
+      sum += weights[m] * src[m][x];
+    dst[x] = sum;
+  }
+}
+} // namespace detail
+
+template <typename PointT>
+int
+Convolution<PointT>::borderIndex(int index, int size) const
+{
+  switch (boundary_options_) {
+  default:
+  case BOUNDARY_OPTION_CLAMP:
+    return std::min(std::max(index, 0), size - 1);
+
+  case BOUNDARY_OPTION_MIRROR:
+    if (index < 0)
+      index = -index - 1;
+    else if (index >= size)
+      index = 2 * size - 1 - index;
+    // kernels wider than twice the image are clamped after mirroring
+    return std::min(std::max(index, 0), size - 1);
+
+  case BOUNDARY_OPTION_ZERO_PADDING:
+    return (index < 0 || index >= size) ? -1 : index;
+  }
+}
+
+template <typename PointT>
+bool
+Convolution<PointT>::separateKernel(std::vector<float>& column_kernel,
+                                    std::vector<float>& row_kernel) const
+{
+  const int kw = static_cast<int>(kernel_.width);
+  const int kh = static_cast<int>(kernel_.height);
+
+  // the kernel is the outer product of its column and its row through the largest
+  // coefficient, if it is separable at all
+  int pivot_row = 0, pivot_col = 0;
+  for (int k = 0; k < kh; k++)
+    for (int l = 0; l < kw; l++)
+      if (std::abs(kernel_(l, k).intensity) >
+          std::abs(kernel_(pivot_col, pivot_row).intensity)) {
+        pivot_row = k;
+        pivot_col = l;
+      }
+  const float pivot = kernel_(pivot_col, pivot_row).intensity;
+  if (pivot == 0.0f)
+    return (false);
+
+  row_kernel.resize(kw);
+  column_kernel.resize(kh);
+  for (int l = 0; l < kw; l++)
+    row_kernel[l] = kernel_(l, pivot_row).intensity;
+  for (int k = 0; k < kh; k++)
+    column_kernel[k] = kernel_(pivot_col, k).intensity / pivot;
+
+  const float tolerance = 1e-5f * std::abs(pivot);
+  for (int k = 0; k < kh; k++)
+    for (int l = 0; l < kw; l++)
+      if (std::abs(column_kernel[k] * row_kernel[l] - kernel_(l, k).intensity) >
+          tolerance)
+        return (false);
+  return (true);
+}
 
 template <typename PointT>
 void
 Convolution<PointT>::filter(pcl::PointCloud<PointT>& output)
 {
-  int input_row = 0;
-  int input_col = 0;
-  // default boundary option : zero padding
-  output = *input_;
-
   int iw = static_cast<int>(input_->width), ih = static_cast<int>(input_->height),
       kw = static_cast<int>(kernel_.width), kh = static_cast<int>(kernel_.height);
-  switch (boundary_options_) {
-  default:
-  case BOUNDARY_OPTION_CLAMP: {
-    for (int i = 0; i < ih; i++) {
-      for (int j = 0; j < iw; j++) {
-        float intensity = 0;
-        for (int k = 0; k < kh; k++) {
-          for (int l = 0; l < kw; l++) {
-            int ikkh = i + k - kh / 2, jlkw = j + l - kw / 2;
-            if (ikkh < 0)
-              input_row = 0;
-            else if (ikkh >= ih)
-              input_row = ih - 1;
-            else
-              input_row = ikkh;
-
-            if (jlkw < 0)
-              input_col = 0;
-            else if (jlkw >= iw)
-              input_col = iw - 1;
-            else
-              input_col = jlkw;
-
-            intensity +=
-                kernel_(l, k).intensity * (*input_)(input_col, input_row).intensity;
-          }
-        }
-        output(j, i).intensity = intensity;
-      }
-    }
-    break;
+
+  // The input intensities, extended by kernel_height/2 rows and kernel_width/2
+  // columns on each side according to the boundary option, so that every output
+  // pixel is a plain weighted sum of the extended image.
+  int pw = iw + kw - 1, ph = ih + kh - 1;
+  std::vector<float> padded(static_cast<std::size_t>(pw) * ph);
+  std::vector<int> input_cols(pw);
+  for (int c = 0; c < pw; c++)
+    input_cols[c] = borderIndex(c - kw / 2, iw);
+  for (int r = 0; r < ph; r++) {
+    const int input_row = borderIndex(r - kh / 2, ih);
+    for (int c = 0; c < pw; c++)
+      padded[r * pw + c] = (input_row < 0 || input_cols[c] < 0)
+                               ? 0.0f
+                               : (*input_)(input_cols[c], input_row).intensity;
   }
 
-  case BOUNDARY_OPTION_MIRROR: {
-    for (int i = 0; i < ih; i++) {
-      for (int j = 0; j < iw; j++) {
-        float intensity = 0;
-        for (int k = 0; k < kh; k++) {
-          for (int l = 0; l < kw; l++) {
-            int ikkh = i + k - kh / 2, jlkw = j + l - kw / 2;
-            if (ikkh < 0)
-              input_row = -ikkh - 1;
-            else if (ikkh >= ih)
-              input_row = 2 * ih - 1 - ikkh;
-            else
-              input_row = ikkh;
-
-            if (jlkw < 0)
-              input_col = -jlkw - 1;
-            else if (jlkw >= iw)
-              input_col = 2 * iw - 1 - jlkw;
-            else
-              input_col = jlkw;
-
-            intensity +=
-                kernel_(l, k).intensity * ((*input_)(input_col, input_row).intensity);
-          }
-        }
-        output(j, i).intensity = intensity;
+  output = *input_;
+
+  std::vector<float> column_kernel, row_kernel;
+  if (kh > 1 && kw > 1 && separateKernel(column_kernel, row_kernel)) {
+    // horizontal pass over all the extended rows, then vertical pass
+    std::vector<float> horizontal(static_cast<std::size_t>(ph) * iw);
+
+    // clang-format off
+#pragma omp parallel \
+  default(none) \
+  shared(column_kernel, horizontal, ih, iw, kh, kw, output, padded, ph, pw, row_kernel) \
+  num_threads(pcl::utils::getNumberOfThreads(threads_))
+    // clang-format on
+    {
+      std::vector<const float*> src(std::max(kh, kw));
+      std::vector<float> result(iw);
+
+#pragma omp for
+      for (int r = 0; r < ph; r++) {
+        for (int l = 0; l < kw; l++)
+          src[l] = &padded[r * pw + l];
+        detail::convolveRow(src.data(), row_kernel.data(), kw, &horizontal[r * iw], iw);
+      }
+
+#pragma omp for
+      for (int i = 0; i < ih; i++) {
+        for (int k = 0; k < kh; k++)
+          src[k] = &horizontal[(i + k) * iw];
+        detail::convolveRow(src.data(), column_kernel.data(), kh, result.data(), iw);
+        for (int j = 0; j < iw; j++)
+          output(j, i).intensity = result[j];
       }
     }
-    break;
+    return;
   }
 
-  case BOUNDARY_OPTION_ZERO_PADDING: {
+  // full 2D kernel, summed in the same order as the kernel is stored
+  std::vector<float> weights(kh * kw);
+  for (int k = 0; k < kh; k++)
+    for (int l = 0; l < kw; l++)
+      weights[k * kw + l] = kernel_(l, k).intensity;
+
+  // clang-format off
+#pragma omp parallel \
+  default(none) \
+  shared(ih, iw, kh, kw, output, padded, pw, weights) \
+  num_threads(pcl::utils::getNumberOfThreads(threads_))
+  // clang-format on
+  {
+    std::vector<const float*> src(kh * kw);
+    std::vector<float> result(iw);
+
+#pragma omp for
     for (int i = 0; i < ih; i++) {
-      for (int j = 0; j < iw; j++) {
-        float intensity = 0;
-        for (int k = 0; k < kh; k++) {
-          for (int l = 0; l < kw; l++) {
-            int ikkh = i + k - kh / 2, jlkw = j + l - kw / 2;
-            if (ikkh < 0 || ikkh >= ih || jlkw < 0 || jlkw >= iw)
-              continue;
-            intensity += kernel_(l, k).intensity * ((*input_)(jlkw, ikkh).intensity);
-          }
-        }
-        output(j, i).intensity = intensity;
-      }
+      for (int k = 0; k < kh; k++)
+        for (int l = 0; l < kw; l++)
+          src[k * kw + l] = &padded[(i + k) * pw + l];
+      detail::convolveRow(src.data(), weights.data(), kh * kw, result.data(), iw);
+      for (int j = 0; j < iw; j++)
+        output(j, i).intensity = result[j];
     }
-    break;
   }
-  } // switch
 }
 } // namespace pcl
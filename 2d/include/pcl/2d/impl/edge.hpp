@@ -40,6 +40,10 @@
 #include <pcl/2d/convolution.h>
 #include <pcl/2d/edge.h>
 #include <pcl/common/angles.h> // for rad2deg
+#include <pcl/common/utils.h>  // for getNumberOfThreads
+
+#include <algorithm>
+#include <vector>
 
 namespace pcl {
 
@@ -47,36 +51,68 @@ template <typename PointInT, typename PointOutT>
 void
 Edge<PointInT, PointOutT>::detectEdgeSobel(pcl::PointCloud<PointOutT>& output)
 {
-  convolution_.setInputCloud(input_);
-  pcl::PointCloud<PointXYZI>::Ptr kernel_x(new pcl::PointCloud<PointXYZI>);
-  pcl::PointCloud<PointXYZI>::Ptr magnitude_x(new pcl::PointCloud<PointXYZI>);
+  pcl::PointCloud<PointXYZI> kernel_x;
   kernel_.setKernelType(kernel<PointXYZI>::SOBEL_X);
-  kernel_.fetchKernel(*kernel_x);
-  convolution_.setKernel(*kernel_x);
-  convolution_.filter(*magnitude_x);
+  kernel_.fetchKernel(kernel_x);
 
-  pcl::PointCloud<PointXYZI>::Ptr kernel_y(new pcl::PointCloud<PointXYZI>);
-  pcl::PointCloud<PointXYZI>::Ptr magnitude_y(new pcl::PointCloud<PointXYZI>);
+  pcl::PointCloud<PointXYZI> kernel_y;
   kernel_.setKernelType(kernel<PointXYZI>::SOBEL_Y);
-  kernel_.fetchKernel(*kernel_y);
-  convolution_.setKernel(*kernel_y);
-  convolution_.filter(*magnitude_y);
+  kernel_.fetchKernel(kernel_y);
 
-  const int height = input_->height;
-  const int width = input_->width;
+  int height = input_->height;
+  int width = input_->width;
 
   output.resize(height * width);
   output.height = height;
   output.width = width;
 
-  for (std::size_t i = 0; i < output.size(); ++i) {
-    output[i].magnitude_x = (*magnitude_x)[i].intensity;
-    output[i].magnitude_y = (*magnitude_y)[i].intensity;
-    output[i].magnitude =
-        std::sqrt((*magnitude_x)[i].intensity * (*magnitude_x)[i].intensity +
-                  (*magnitude_y)[i].intensity * (*magnitude_y)[i].intensity);
-    output[i].direction =
-        std::atan2((*magnitude_y)[i].intensity, (*magnitude_x)[i].intensity);
+  // Both derivatives are computed in one pass over the input extended by one clamped
+  // pixel on each side, as the convolution does by default, instead of convolving
+  // it twice into intermediate clouds.
+  int padded_width = width + 2;
+  std::vector<float> padded((height + 2) * padded_width);
+  for (int r = 0; r < height + 2; r++) {
+    const int row = std::min(std::max(r - 1, 0), height - 1);
+    for (int c = 0; c < padded_width; c++)
+      padded[r * padded_width + c] =
+          (*input_)(std::min(std::max(c - 1, 0), width - 1), row).intensity;
+  }
+
+  float weights_x[9], weights_y[9];
+  for (int k = 0; k < 3; k++) {
+    for (int l = 0; l < 3; l++) {
+      weights_x[k * 3 + l] = kernel_x(l, k).intensity;
+      weights_y[k * 3 + l] = kernel_y(l, k).intensity;
+    }
+  }
+
+  // clang-format off
+#pragma omp parallel \
+  default(none) \
+  shared(height, output, padded, padded_width, weights_x, weights_y, width) \
+  num_threads(pcl::utils::getNumberOfThreads(threads_))
+  // clang-format on
+  {
+    std::vector<float> magnitude_x(width), magnitude_y(width);
+    const float* src[9];
+
+#pragma omp for
+    for (int i = 0; i < height; i++) {
+      for (int k = 0; k < 3; k++)
+        for (int l = 0; l < 3; l++)
+          src[k * 3 + l] = &padded[(i + k) * padded_width + l];
+      detail::convolveRow(src, weights_x, 9, magnitude_x.data(), width);
+      detail::convolveRow(src, weights_y, 9, magnitude_y.data(), width);
+
+      for (int j = 0; j < width; j++) {
+        PointOutT& point = output(j, i);
+        point.magnitude_x = magnitude_x[j];
+        point.magnitude_y = magnitude_y[j];
+        point.magnitude =
+            std::sqrt(magnitude_x[j] * magnitude_x[j] + magnitude_y[j] * magnitude_y[j]);
+        point.direction = std::atan2(magnitude_y[j], magnitude_x[j]);
+      }
+    }
   }
 }
 
@@ -227,12 +263,18 @@ template <typename PointInT, typename PointOutT>
 void
 Edge<PointInT, PointOutT>::discretizeAngles(pcl::PointCloud<PointOutT>& thet)
 {
-  const int height = thet.height;
-  const int width = thet.width;
-  float angle;
+  int height = thet.height;
+  int width = thet.width;
+
+  // clang-format off
+#pragma omp parallel for \
+  default(none) \
+  shared(height, thet, width) \
+  num_threads(pcl::utils::getNumberOfThreads(threads_))
+  // clang-format on
   for (int i = 0; i < height; i++) {
     for (int j = 0; j < width; j++) {
-      angle = pcl::rad2deg(thet(j, i).direction);
+      const float angle = pcl::rad2deg(thet(j, i).direction);
       if (((angle <= 22.5) && (angle >= -22.5)) || (angle >= 157.5) ||
           (angle <= -157.5))
         thet(j, i).direction = 0;
@@ -256,8 +298,8 @@ Edge<PointInT, PointOutT>::suppressNonMaxima(
     pcl::PointCloud<PointXYZI>& maxima,
     float tLow)
 {
-  const int height = edges.height;
-  const int width = edges.width;
+  int height = edges.height;
+  int width = edges.width;
 
   maxima.height = height;
   maxima.width = width;
@@ -267,6 +309,12 @@ Edge<PointInT, PointOutT>::suppressNonMaxima(
     point.intensity = 0.0f;
 
   // tHigh and non-maximal supression
+  // clang-format off
+#pragma omp parallel for \
+  default(none) \
+  shared(edges, height, maxima, tLow, width) \
+  num_threads(pcl::utils::getNumberOfThreads(threads_))
+  // clang-format on
   for (int i = 1; i < height - 1; i++) {
     for (int j = 1; j < width - 1; j++) {
       const PointXYZIEdge& ptedge = edges(j, i);
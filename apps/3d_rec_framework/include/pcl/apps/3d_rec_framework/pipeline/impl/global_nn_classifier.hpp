@@ -17,31 +17,15 @@ pcl::rec_3d_framework::GlobalNNPipeline<Distance, PointInT, FeatureT>::
     std::string path =
         source_->getModelDescriptorDir(models->at(i), training_dir_, descr_name_);
 
-    for (const auto& dir_entry : bf::directory_iterator(path)) {
-      std::string file_name = (dir_entry.path().filename()).string();
-
-      std::vector<std::string> strs;
-      boost::split(strs, file_name, boost::is_any_of("_"));
-
-      if (strs[0] == "descriptor") {
-        std::string full_file_name = dir_entry.path().string();
-        std::vector<std::string> strs;
-        boost::split(strs, full_file_name, boost::is_any_of("/"));
-
-        typename pcl::PointCloud<FeatureT>::Ptr signature(
-            new pcl::PointCloud<FeatureT>);
-        pcl::io::loadPCDFile(full_file_name, *signature);
-
-        flann_model descr_model;
-        descr_model.first = models->at(i);
-        int size_feat = sizeof((*signature)[0].histogram) / sizeof(float);
-        descr_model.second.resize(size_feat);
-        memcpy(&descr_model.second[0],
-               &(*signature)[0].histogram[0],
-               size_feat * sizeof(float));
-
-        flann_models_.push_back(descr_model);
-      }
+    PersistenceUtils::DescriptorDatabase database;
+    PersistenceUtils::loadDescriptors<FeatureT>(path, database);
+
+    for (std::size_t d = 0; d < database.view_ids.size(); d++) {
+      const float* descr = &database.descriptors[d * database.size_feat];
+      flann_model descr_model;
+      descr_model.first = models->at(i);
+      descr_model.second.assign(descr, descr + database.size_feat);
+      flann_models_.push_back(descr_model);
     }
   }
 
@@ -96,23 +80,28 @@ pcl::rec_3d_framework::GlobalNNPipeline<Distance, PointInT, FeatureT>::classify(
   std::vector<index_score> indices_scores;
 
   if (!signatures.empty()) {
+    // query all the signatures at once
+    const int size_feat = sizeof(signatures[0][0].histogram) / sizeof(float);
+    std::vector<float> queries(signatures.size() * size_feat);
     for (std::size_t idx = 0; idx < signatures.size(); idx++) {
-      float* hist = signatures[idx][0].histogram;
-      int size_feat = sizeof(signatures[idx][0].histogram) / sizeof(float);
-      std::vector<float> std_hist(hist, hist + size_feat);
-      ModelT empty;
+      const float* hist = signatures[idx][0].histogram;
+      std::copy(hist, hist + size_feat, &queries[idx * size_feat]);
+    }
 
-      flann_model histogram(empty, std_hist);
-      flann::Matrix<int> indices;
-      flann::Matrix<float> distances;
-      nearestKSearch(flann_index_, histogram, NN_, indices, distances);
+    std::vector<int> indices_data(signatures.size() * NN_);
+    std::vector<float> distances_data(signatures.size() * NN_);
+    flann::Matrix<float> p(queries.data(), signatures.size(), size_feat);
+    flann::Matrix<int> indices(indices_data.data(), signatures.size(), NN_);
+    flann::Matrix<float> distances(distances_data.data(), signatures.size(), NN_);
+    flann_index_->knnSearch(p, indices, distances, NN_, flann::SearchParams(512));
 
-      // gather NN-search results
+    // gather NN-search results
+    for (std::size_t idx = 0; idx < signatures.size(); idx++) {
       for (int i = 0; i < NN_; ++i) {
         index_score is;
-        is.idx_models_ = indices[0][i];
+        is.idx_models_ = indices[idx][i];
         is.idx_input_ = static_cast<int>(idx);
-        is.score_ = distances[0][i];
+        is.score_ = distances[idx][i];
         indices_scores.push_back(is);
       }
     }
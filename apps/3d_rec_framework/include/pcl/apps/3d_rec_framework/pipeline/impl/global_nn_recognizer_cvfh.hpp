@@ -109,62 +109,44 @@ pcl::rec_3d_framework::GlobalNNCVFHRecognizer<Distance, PointInT, FeatureT>::
     std::string path =
         source_->getModelDescriptorDir(models->at(i), training_dir_, descr_name_);
 
-    for (const auto& dir_entry : bf::directory_iterator(path)) {
-      std::string file_name = (dir_entry.path().filename()).string();
-
-      std::vector<std::string> strs;
-      boost::split(strs, file_name, boost::is_any_of("_"));
-
-      if (strs[0] == "descriptor") {
-
-        int view_id = atoi(strs[1].c_str());
-        std::vector<std::string> strs1;
-        boost::split(strs1, strs[2], boost::is_any_of("."));
-        int descriptor_id = atoi(strs1[0].c_str());
-
-        std::string full_file_name = dir_entry.path().string();
-        typename pcl::PointCloud<FeatureT>::Ptr signature(
-            new pcl::PointCloud<FeatureT>);
-        pcl::io::loadPCDFile(full_file_name, *signature);
-
-        flann_model descr_model;
-        descr_model.model = models->at(i);
-        descr_model.view_id = view_id;
-        descr_model.descriptor_id = descriptor_id;
-
-        int size_feat = sizeof((*signature)[0].histogram) / sizeof(float);
-        descr_model.descr.resize(size_feat);
-        memcpy(&descr_model.descr[0],
-               &(*signature)[0].histogram[0],
-               size_feat * sizeof(float));
-
-        if (use_single_categories_) {
-          std::map<std::string, std::shared_ptr<std::vector<int>>>::iterator it;
-          std::string cat_model = models->at(i).class_;
-          it = single_categories.find(cat_model);
-          if (it == single_categories.end()) {
-            std::cout << cat_model << std::endl;
-            std::cout << "Should not happen..." << std::endl;
-          }
-          else {
-            it->second->push_back(static_cast<int>(flann_models_.size()));
-          }
+    PersistenceUtils::DescriptorDatabase database;
+    PersistenceUtils::loadDescriptors<FeatureT>(path, database);
+
+    for (std::size_t d = 0; d < database.view_ids.size(); d++) {
+      const float* descr = &database.descriptors[d * database.size_feat];
+      flann_model descr_model;
+      descr_model.model = models->at(i);
+      descr_model.view_id = database.view_ids[d];
+      descr_model.descriptor_id = database.descriptor_ids[d];
+      descr_model.descr.assign(descr, descr + database.size_feat);
+
+      if (use_single_categories_) {
+        std::map<std::string, std::shared_ptr<std::vector<int>>>::iterator it;
+        std::string cat_model = models->at(i).class_;
+        it = single_categories.find(cat_model);
+        if (it == single_categories.end()) {
+          std::cout << cat_model << std::endl;
+          std::cout << "Should not happen..." << std::endl;
         }
+        else {
+          it->second->push_back(static_cast<int>(flann_models_.size()));
+        }
+      }
 
-        flann_models_.push_back(descr_model);
-
-        if (use_cache_) {
+      flann_models_.push_back(descr_model);
 
-          std::stringstream dir_pose;
-          dir_pose << path << "/pose_" << descr_model.view_id << ".txt";
+      if (use_cache_) {
+        std::pair<std::string, int> pair_model_view =
+            std::make_pair(models->at(i).id_, descr_model.view_id);
+        if (poses_cache_.find(pair_model_view) != poses_cache_.end())
+          continue;
 
-          Eigen::Matrix4f pose_matrix;
-          PersistenceUtils::readMatrixFromFile(dir_pose.str(), pose_matrix);
+        std::stringstream dir_pose;
+        dir_pose << path << "/pose_" << descr_model.view_id << ".txt";
 
-          std::pair<std::string, int> pair_model_view =
-              std::make_pair(models->at(i).id_, descr_model.view_id);
-          poses_cache_[pair_model_view] = pose_matrix;
-        }
+        Eigen::Matrix4f pose_matrix;
+        PersistenceUtils::readMatrixFromFile(dir_pose.str(), pose_matrix);
+        poses_cache_[pair_model_view] = pose_matrix;
       }
     }
   }
@@ -20,64 +20,39 @@ pcl::rec_3d_framework::LocalRecognitionPipeline<Distance, PointInT, FeatureT>::
     std::string path =
         source_->getModelDescriptorDir(models->at(i), training_dir_, descr_name_);
 
-    for (const auto& dir_entry : bf::directory_iterator(path)) {
-      std::string file_name = (dir_entry.path().filename()).string();
-
-      std::vector<std::string> strs;
-      boost::split(strs, file_name, boost::is_any_of("_"));
-
-      if (strs[0] == "descriptor") {
-        std::string full_file_name = dir_entry.path().string();
-        std::string name = file_name.substr(0, file_name.length() - 4);
-        std::vector<std::string> strs;
-        boost::split(strs, name, boost::is_any_of("_"));
-
-        flann_model descr_model;
-        descr_model.model = models->at(i);
-        descr_model.view_id = atoi(strs[1].c_str());
-
-        if (use_cache_) {
-
-          std::stringstream dir_keypoints;
-          std::string path =
-              source_->getModelDescriptorDir(models->at(i), training_dir_, descr_name_);
-          dir_keypoints << path << "/keypoint_indices_" << descr_model.view_id
-                        << ".pcd";
-
-          std::stringstream dir_pose;
-          dir_pose << path << "/pose_" << descr_model.view_id << ".txt";
-
-          Eigen::Matrix4f pose_matrix;
-          PersistenceUtils::readMatrixFromFile(dir_pose.str(), pose_matrix);
-
-          std::pair<std::string, int> pair_model_view =
-              std::make_pair(models->at(i).id_, descr_model.view_id);
-          poses_cache_[pair_model_view] = pose_matrix;
-
-          // load keypoints and save them to cache
-          typename pcl::PointCloud<PointInT>::Ptr keypoints(
-              new pcl::PointCloud<PointInT>());
-          pcl::io::loadPCDFile(dir_keypoints.str(), *keypoints);
-          keypoints_cache_[pair_model_view] = keypoints;
-        }
-
-        typename pcl::PointCloud<FeatureT>::Ptr signature(
-            new pcl::PointCloud<FeatureT>());
-        pcl::io::loadPCDFile(full_file_name, *signature);
-
-        int size_feat = sizeof((*signature)[0].histogram) / sizeof(float);
-
-        for (std::size_t dd = 0; dd < signature->size(); dd++) {
-          descr_model.keypoint_id = static_cast<int>(dd);
-          descr_model.descr.resize(size_feat);
-
-          memcpy(&descr_model.descr[0],
-                 &(*signature)[dd].histogram[0],
-                 size_feat * sizeof(float));
-
-          flann_models_.push_back(descr_model);
-        }
+    PersistenceUtils::DescriptorDatabase database;
+    PersistenceUtils::loadDescriptors<FeatureT>(path, database);
+
+    for (std::size_t d = 0; d < database.view_ids.size(); d++) {
+      flann_model descr_model;
+      descr_model.model = models->at(i);
+      descr_model.view_id = database.view_ids[d];
+      descr_model.keypoint_id = database.descriptor_ids[d];
+
+      std::pair<std::string, int> pair_model_view =
+          std::make_pair(models->at(i).id_, descr_model.view_id);
+      if (use_cache_ &&
+          keypoints_cache_.find(pair_model_view) == keypoints_cache_.end()) {
+        std::stringstream dir_keypoints;
+        dir_keypoints << path << "/keypoint_indices_" << descr_model.view_id << ".pcd";
+
+        std::stringstream dir_pose;
+        dir_pose << path << "/pose_" << descr_model.view_id << ".txt";
+
+        Eigen::Matrix4f pose_matrix;
+        PersistenceUtils::readMatrixFromFile(dir_pose.str(), pose_matrix);
+        poses_cache_[pair_model_view] = pose_matrix;
+
+        // load keypoints and save them to cache
+        typename pcl::PointCloud<PointInT>::Ptr keypoints(
+            new pcl::PointCloud<PointInT>());
+        pcl::io::loadPCDFile(dir_keypoints.str(), *keypoints);
+        keypoints_cache_[pair_model_view] = keypoints;
       }
+
+      const float* descr = &database.descriptors[d * database.size_feat];
+      descr_model.descr.assign(descr, descr + database.size_feat);
+      flann_models_.push_back(descr_model);
     }
   }
 
@@ -235,14 +210,24 @@ pcl::rec_3d_framework::LocalRecognitionPipeline<Distance, PointInT, FeatureT>::
   // feature matching and object hypotheses
   std::map<std::string, ObjectHypothesis> object_hypotheses;
   {
+    // query all the signatures at once
+    std::vector<float> queries(signatures->size() * size_feat);
+    for (std::size_t idx = 0; idx < signatures->size(); idx++) {
+      const float* hist = (*signatures)[idx].histogram;
+      std::copy(hist, hist + size_feat, &queries[idx * size_feat]);
+    }
+
+    std::vector<int> indices_data(signatures->size());
+    std::vector<float> distances_data(signatures->size());
+    flann::Matrix<float> p(queries.data(), signatures->size(), size_feat);
+    flann::Matrix<int> all_indices(indices_data.data(), signatures->size(), 1);
+    flann::Matrix<float> all_distances(distances_data.data(), signatures->size(), 1);
+    flann_index_->knnSearch(
+        p, all_indices, all_distances, 1, flann::SearchParams(kdtree_splits_));
+
     for (std::size_t idx = 0; idx < signatures->size(); idx++) {
-      float* hist = (*signatures)[idx].histogram;
-      std::vector<float> std_hist(hist, hist + size_feat);
-      flann_model histogram;
-      histogram.descr = std_hist;
-      flann::Matrix<int> indices;
-      flann::Matrix<float> distances;
-      nearestKSearch(flann_index_, histogram, 1, indices, distances);
+      flann::Matrix<int> indices(all_indices[idx], 1, 1);
+      flann::Matrix<float> distances(all_distances[idx], 1, 1);
 
       // read view pose and keypoint coordinates, transform keypoint coordinates to
       // model coordinates
@@ -3,6 +3,7 @@
 #include <boost/algorithm/string.hpp>
 #include <boost/filesystem.hpp>
 
+#include <cstdint>
 #include <fstream>
 
 namespace pcl {
@@ -247,6 +248,113 @@ getPointCloudFromFile(std::string dir,
   pcl::io::loadPCDFile(view_file.str(), *cloud);
 }
 
+/** \brief Descriptors of the views of a model: the view and the descriptor (or
+ * keypoint) index of each one, and their histograms one after the other. */
+struct DescriptorDatabase {
+  int size_feat = 0;
+  std::vector<int> view_ids;
+  std::vector<int> descriptor_ids;
+  std::vector<float> descriptors;
+};
+
+inline bool
+writeDescriptorDatabase(const std::string& file, const DescriptorDatabase& database)
+{
+  std::ofstream out(file.c_str(), std::ios::binary);
+  if (!out) {
+    std::cout << "Cannot open file.\n";
+    return false;
+  }
+
+  const std::int32_t size_feat = database.size_feat;
+  const std::uint64_t count = database.view_ids.size();
+  out.write("RECDESC1", 8);
+  out.write(reinterpret_cast<const char*>(&size_feat), sizeof(size_feat));
+  out.write(reinterpret_cast<const char*>(&count), sizeof(count));
+  out.write(reinterpret_cast<const char*>(database.view_ids.data()),
+            count * sizeof(int));
+  out.write(reinterpret_cast<const char*>(database.descriptor_ids.data()),
+            count * sizeof(int));
+  out.write(reinterpret_cast<const char*>(database.descriptors.data()),
+            database.descriptors.size() * sizeof(float));
+  return static_cast<bool>(out);
+}
+
+inline bool
+readDescriptorDatabase(const std::string& file, DescriptorDatabase& database)
+{
+  std::ifstream in(file.c_str(), std::ios::binary);
+  if (!in)
+    return false;
+
+  char magic[8];
+  std::int32_t size_feat;
+  std::uint64_t count;
+  in.read(magic, 8);
+  in.read(reinterpret_cast<char*>(&size_feat), sizeof(size_feat));
+  in.read(reinterpret_cast<char*>(&count), sizeof(count));
+  if (!in || std::string(magic, 8) != "RECDESC1")
+    return false;
+
+  database.size_feat = size_feat;
+  database.view_ids.resize(count);
+  database.descriptor_ids.resize(count);
+  database.descriptors.resize(count * size_feat);
+  in.read(reinterpret_cast<char*>(database.view_ids.data()), count * sizeof(int));
+  in.read(reinterpret_cast<char*>(database.descriptor_ids.data()),
+          count * sizeof(int));
+  in.read(reinterpret_cast<char*>(database.descriptors.data()),
+          database.descriptors.size() * sizeof(float));
+  return static_cast<bool>(in);
+}
+
+/** \brief Load the descriptors of the views of a model from its descriptor directory.
+ * The descriptor_<view>_<id>.pcd files hold one descriptor each, and the
+ * descriptor_<view>.pcd files one descriptor per keypoint, whose index is the id. The
+ * first load gathers them in a single binary file, descriptors.bin, which the later
+ * loads read at once instead of one file per view.
+ */
+template <typename FeatureT>
+inline void
+loadDescriptors(const std::string& dir, DescriptorDatabase& database)
+{
+  const std::string database_file = dir + "/descriptors.bin";
+  if (readDescriptorDatabase(database_file, database))
+    return;
+
+  database = DescriptorDatabase();
+  database.size_feat = sizeof(FeatureT::histogram) / sizeof(float);
+
+  for (const auto& dir_entry : boost::filesystem::directory_iterator(dir)) {
+    std::string file_name = (dir_entry.path().filename()).string();
+    if (dir_entry.path().extension() != ".pcd")
+      continue;
+
+    std::vector<std::string> strs;
+    boost::split(strs,
+                 file_name.substr(0, file_name.length() - 4),
+                 boost::is_any_of("_"));
+    if (strs[0] != "descriptor")
+      continue;
+
+    pcl::PointCloud<FeatureT> signature;
+    pcl::io::loadPCDFile(dir_entry.path().string(), signature);
+
+    const int view_id = atoi(strs[1].c_str());
+    const std::size_t nr_descriptors = strs.size() > 2 ? 1 : signature.size();
+    for (std::size_t d = 0; d < nr_descriptors && d < signature.size(); d++) {
+      database.view_ids.push_back(view_id);
+      database.descriptor_ids.push_back(strs.size() > 2 ? atoi(strs[2].c_str())
+                                                        : static_cast<int>(d));
+      database.descriptors.insert(database.descriptors.end(),
+                                  signature[d].histogram,
+                                  signature[d].histogram + database.size_feat);
+    }
+  }
+
+  writeDescriptorDatabase(database_file, database);
+}
+
 } // namespace PersistenceUtils
 } // namespace rec_3d_framework
 } // namespace pcl
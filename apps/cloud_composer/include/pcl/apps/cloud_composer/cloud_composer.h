@@ -125,6 +125,10 @@ namespace pcl
         
         void
         enqueueToolAction (AbstractTool* tool);
+        
+        /** \brief Shows the progress of the running tool action in the status bar */
+        void
+        showToolProgress (const QString& tool_name, double progress);
        
       private:
         void
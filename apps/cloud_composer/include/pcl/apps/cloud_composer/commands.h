@@ -41,6 +41,8 @@
 
 #include <QUndoCommand>
 
+#include <functional>
+
 namespace pcl
 {
   namespace cloud_composer
@@ -83,7 +85,23 @@ namespace pcl
         {
           original_data_ = std::move(input_data);
         }
+        
+        /** \brief Set a function which runCommand calls after each processed item with the number of items done and the total
+         *  Returning false from it cancels the command, which then returns false from runCommand
+         */
+        inline void
+        setProgressCallback (std::function<bool (int, int)> progress_callback)
+        {
+          progress_callback_ = std::move(progress_callback);
+        }
       protected:
+        /** \brief Runs the tool on each original item separately, with the items processed in parallel on the global thread pool
+         *  \param[out] outputs The output of the tool for each item, in the order of original_data_
+         *  \return false if the command was cancelled through the progress callback, the outputs are deleted then
+         */
+        bool
+        performActionOnItems (AbstractTool* tool, QList <QList <CloudComposerItem*> >& outputs);
+        
         /** \brief Removes the original item(s) from the model and replaces with the replacement(s)
          *  Replacements are only inserted once, original items must have same parent
          *  This stores the removed items in removed_items_
@@ -116,6 +134,8 @@ namespace pcl
         
         bool can_use_templates_;
         int template_type_;
+        
+        std::function<bool (int, int)> progress_callback_;
     };
     
     class ModifyItemCommand : public CloudCommand
@@ -154,6 +154,10 @@ namespace pcl
         void 
         createNewCloudFromSelection ();
         
+        /** \brief Cancels the tool action which is running and the queued ones */
+        void
+        cancelToolActions ();
+        
         /** \brief Selects all items in the model */
         void 
         selectAllItems (QStandardItem* item = nullptr );
@@ -161,6 +165,10 @@ namespace pcl
         void
         enqueueNewAction (AbstractTool* tool, ConstItemList data);
         
+        /** \brief Progress of the running tool action, between 0 and 1 */
+        void
+        toolProgress (QString tool_name, double progress);
+        
         /** \brief Catch-all signal emitted whenever the model changes */
         void
         modelChanged ();
@@ -37,6 +37,7 @@
 
 #pragma once
 
+#include <QAtomicInt>
 #include <QQueue>
 
 #include <pcl/apps/cloud_composer/commands.h>
@@ -52,14 +53,25 @@ namespace pcl
     {
       CloudCommand* command;  
       AbstractTool* tool;
+      /** \brief Value of the cancel counter when the action was queued, the action is cancelled once they differ */
+      int generation;
     };
     
+    /** \brief Runs the queued tool actions one after the other on the thread it lives in
+     *  The items of an action are processed in parallel on the global thread pool (see CloudCommand::performActionOnItems)
+     */
     class WorkQueue : public QObject
     {
       Q_OBJECT
       public:
         WorkQueue (QObject* parent = nullptr);  
         ~WorkQueue();  
+        
+        /** \brief Cancels the running action and all queued ones
+         *  Thread safe, call it directly: the thread of the work queue is busy while an action runs, so a queued call would only be handled once it finished
+         */
+        void
+        cancelAll ();
       public Q_SLOTS:
         void
         enqueueNewAction (AbstractTool* new_tool, ConstItemList input_data);
@@ -79,6 +91,9 @@ namespace pcl
       private:
         QQueue <ActionPair> work_queue_;
         
+        /** \brief Incremented by cancelAll */
+        QAtomicInt cancel_generation_;
+        
     };
   }
 }
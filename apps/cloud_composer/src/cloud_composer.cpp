@@ -88,6 +88,9 @@ pcl::cloud_composer::ComposerMainWindow::connectEditActions ()
   multiplexer_->connect (action_delete_, SIGNAL (triggered ()), SLOT (deleteSelectedItems ()));
   multiplexer_->connect (SIGNAL (deleteAvailable (bool)), action_delete_, SLOT (setEnabled (bool)));
   
+  multiplexer_->connect (action_cancel_tools_, SIGNAL (triggered ()), SLOT (cancelToolActions ()));
+  multiplexer_->connect (SIGNAL (toolProgress (QString, double)), this, SLOT (showToolProgress (QString, double)));
+  
   multiplexer_->connect (this, SIGNAL (insertNewCloudFromFile()), SLOT (insertNewCloudFromFile()));
   multiplexer_->connect (this, SIGNAL (insertNewCloudFromRGBandDepth()), SLOT (insertNewCloudFromRGBandDepth()));
   multiplexer_->connect (this, SIGNAL (saveSelectedCloudToFile()), SLOT (saveSelectedCloudToFile()));
@@ -281,6 +284,15 @@ pcl::cloud_composer::ComposerMainWindow::enqueueToolAction (AbstractTool* tool)
     QMessageBox::warning (this, "No Project Open!", "Cannot use tool, no project is open!");
 }
 ///////// FILE MENU SLOTS ///////////
+void
+pcl::cloud_composer::ComposerMainWindow::showToolProgress (const QString& tool_name, double progress)
+{
+  if (progress < 1.0)
+    statusbar->showMessage (tr ("%1: %2%").arg (tool_name).arg (static_cast<int> (100.0 * progress)));
+  else
+    statusbar->showMessage (tr ("%1: done").arg (tool_name), 3000);
+}
+
 void
 pcl::cloud_composer::ComposerMainWindow::on_action_new_project__triggered (/*QString name*/)
 {
@@ -3,9 +3,14 @@
 #include <pcl/apps/cloud_composer/project_model.h>
 #include <pcl/apps/cloud_composer/merge_selection.h>
 
+#include <QAtomicInt>
+#include <QThread>
+#include <QtConcurrent>
+
 pcl::cloud_composer::CloudCommand::CloudCommand (QList <const CloudComposerItem*> input_data, QUndoCommand* parent)
   : QUndoCommand (parent)
   , original_data_ (std::move(input_data))
+  , last_was_undo_ (false)
   , can_use_templates_(false)
   , template_type_ (-1)
 {
@@ -88,6 +93,65 @@ pcl::cloud_composer::CloudCommand::canUseTemplates (ConstItemList &input_data)
   return true;
 }
 
+bool
+pcl::cloud_composer::CloudCommand::performActionOnItems (AbstractTool* tool, QList <QList <CloudComposerItem*> >& outputs)
+{
+  //Check the template types up front, canUseTemplates isn't safe to call from the pool threads
+  QList <int> template_types;
+  foreach (const CloudComposerItem *item, original_data_)
+  {
+    QList <const CloudComposerItem*> input_list;
+    input_list.append (item);
+    template_types.append (canUseTemplates (input_list) ? template_type_ : -1);
+  }
+  
+  //Queue all items on the global thread pool
+  QThread* command_thread = QThread::currentThread ();
+  QAtomicInt cancelled (0);
+  QList <QFuture <QList <CloudComposerItem*> > > futures;
+  for (int i = 0; i < original_data_.size (); ++i)
+  {
+    QList <const CloudComposerItem*> input_list;
+    input_list.append (original_data_.value (i));
+    const int template_type = template_types.value (i);
+    futures.append (QtConcurrent::run ([tool, input_list, template_type, command_thread, &cancelled] ()
+    {
+      QList <CloudComposerItem*> output;
+      //Items which haven't started when the command is cancelled are skipped
+      if (cancelled.loadAcquire ())
+        return output;
+      if (template_type >= 0)
+        output = tool->performAction (input_list, static_cast<PointTypeFlags::PointType> (template_type));
+      else
+        output = tool->performAction (input_list);
+      //The pool thread has no event loop, so hand the properties of the new items to the thread of the command
+      foreach (CloudComposerItem* item, output)
+        item->getPropertiesModel ()->moveToThread (command_thread);
+      return output;
+    }));
+  }
+  
+  //Collect the outputs in order, reporting progress as the items finish
+  outputs.clear ();
+  for (int i = 0; i < futures.size (); ++i)
+  {
+    futures[i].waitForFinished ();
+    outputs.append (futures[i].result ());
+    if (progress_callback_ && !progress_callback_ (i + 1, futures.size ()))
+      cancelled.storeRelease (1);
+  }
+  
+  if (cancelled.loadAcquire ())
+  {
+    qDebug () << "Command "<<this->text ()<<" cancelled, discarding its output";
+    foreach (const QList <CloudComposerItem*>& output, outputs)
+      qDeleteAll (output);
+    outputs.clear ();
+    return false;
+  }
+  return true;
+}
+
 /*
 QList <pcl::cloud_composer::CloudComposerItem*> 
 pcl::cloud_composer::CloudCommand::executeToolOnTemplateCloud (AbstractTool* tool, ConstItemList &input_data)
@@ -215,15 +279,14 @@ pcl::cloud_composer::ModifyItemCommand::runCommand (AbstractTool* tool)
   this->setText (tool->getToolName ());
   //For modify item cloud command, each selected item should be processed separately
   int num_items_returned = 0;
-  foreach (const CloudComposerItem *item, original_data_)
+  QList <QList <CloudComposerItem*> > outputs;
+  if (!performActionOnItems (tool, outputs))
+    return false;
+  for (int i = 0; i < original_data_.size (); ++i)
   {
     QList <const CloudComposerItem*> input_list;
-    input_list.append (item);
-    QList <CloudComposerItem*> output;
-    if (canUseTemplates(input_list))
-      output = tool->performAction (input_list, static_cast<PointTypeFlags::PointType> (template_type_));
-    else
-      output = tool->performAction (input_list);
+    input_list.append (original_data_.value (i));
+    const QList <CloudComposerItem*>& output = outputs.at (i);
     if (output.empty ())
       qWarning () << "Warning: Tool " << tool->getToolName () << "returned no item in a ModifyItemCommand";
     else 
@@ -291,15 +354,14 @@ pcl::cloud_composer::NewItemCloudCommand::runCommand (AbstractTool* tool)
   //For new item cloud command, each selected item should be processed separately
   //e.g. calculate normals for every selected cloud
   int num_new_items = 0;
-  foreach (const CloudComposerItem *item, original_data_)
+  QList <QList <CloudComposerItem*> > outputs;
+  if (!performActionOnItems (tool, outputs))
+    return false;
+  for (int i = 0; i < original_data_.size (); ++i)
   {
     QList <const CloudComposerItem*> input_list;
-    input_list.append (item);
-    QList <CloudComposerItem*> output;
-    if (canUseTemplates(input_list))
-      output = tool->performAction (input_list, static_cast<PointTypeFlags::PointType> (template_type_));
-    else
-      output = tool->performAction (input_list);
+    input_list.append (original_data_.value (i));
+    const QList <CloudComposerItem*>& output = outputs.at (i);
     if (output.empty ())
       qWarning () << "Warning: Tool " << tool->getToolName () << "returned no item in a NewItemCloudCommand";
     else 
@@ -394,16 +456,15 @@ pcl::cloud_composer::SplitCloudCommand::runCommand (AbstractTool* tool)
   //For split cloud command, each selected item should be processed separately
   //e.g. calculate normals for every selected cloud
   int num_new_items = 0;
-  foreach (const CloudComposerItem *item, original_data_)
+  QList <QList <CloudComposerItem*> > outputs;
+  if (!performActionOnItems (tool, outputs))
+    return false;
+  for (int i = 0; i < original_data_.size (); ++i)
   {
     //Check to see if this is a cloud
     QList <const CloudComposerItem*> input_list;
-    input_list.append (item);
-    QList <CloudComposerItem*> output;
-    if (canUseTemplates(input_list))
-      output = tool->performAction (input_list, static_cast<PointTypeFlags::PointType> (template_type_));
-    else
-      output = tool->performAction (input_list);
+    input_list.append (original_data_.value (i));
+    const QList <CloudComposerItem*>& output = outputs.at (i);
     if (output.empty ())
       qWarning () << "Warning: Tool " << tool->getToolName () << "returned no item in a SplitCloudCommand";
     else 
@@ -33,6 +33,8 @@ pcl::cloud_composer::ProjectModel::ProjectModel (QObject* parent)
            work_queue_, SLOT (enqueueNewAction (AbstractTool*, ConstItemList)));
   connect (work_queue_, SIGNAL (commandComplete (CloudCommand*)),
            this, SLOT (commandCompleted (CloudCommand*)));
+  connect (work_queue_, SIGNAL (commandProgress (QString, double)),
+           this, SIGNAL (toolProgress (QString, double)));
   work_thread_->start ();
   
   connect (this, SIGNAL (rowsInserted ( const QModelIndex, int, int)),
@@ -407,6 +409,13 @@ pcl::cloud_composer::ProjectModel::enqueueToolAction (AbstractTool* tool)
 }
 
 
+void
+pcl::cloud_composer::ProjectModel::cancelToolActions ()
+{
+  //Direct call, the work queue thread is busy with the running action
+  work_queue_->cancelAll ();
+}
+
 void
 pcl::cloud_composer::ProjectModel::commandCompleted (CloudCommand* command)
 {
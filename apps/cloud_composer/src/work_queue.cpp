@@ -3,6 +3,7 @@
 
 pcl::cloud_composer::WorkQueue::WorkQueue (QObject* parent)
   : QObject (parent)
+  , cancel_generation_ (0)
 {
     
     
@@ -23,11 +24,19 @@ pcl::cloud_composer::WorkQueue::enqueueNewAction (AbstractTool* new_tool, ConstI
   //Create a command which will manage data for the tool
   new_action.command = new_tool->createCommand (std::move(input_data));
   new_action.tool = new_tool;
+  new_action.generation = cancel_generation_.loadAcquire ();
  
   work_queue_.enqueue (new_action);
   checkQueue ();
 }
 
+void
+pcl::cloud_composer::WorkQueue::cancelAll ()
+{
+  qDebug () << "Cancelling all tool actions";
+  cancel_generation_.fetchAndAddOrdered (1);
+}
+
 void
 pcl::cloud_composer::WorkQueue::actionFinished (ActionPair finished_action)
 {
@@ -47,19 +56,27 @@ pcl::cloud_composer::WorkQueue::checkQueue ( )
   if (work_queue_.length () > 0)
   {
     ActionPair action_to_execute = work_queue_.dequeue ();
-    if (action_to_execute.command->runCommand (action_to_execute.tool))
+    const QString action_text = action_to_execute.tool->getToolName ();
+    const int generation = action_to_execute.generation;
+    //Report the progress after every item, and stop the command if it was cancelled meanwhile
+    action_to_execute.command->setProgressCallback ([this, action_text, generation] (int done, int total)
+    {
+      emit commandProgress (action_text, static_cast<double> (done) / total);
+      return generation == cancel_generation_.loadAcquire ();
+    });
+    
+    if (generation == cancel_generation_.loadAcquire () && action_to_execute.command->runCommand (action_to_execute.tool))
     {
       //Success, send the command back to the main thread
       actionFinished (action_to_execute);
     }
     else
     {
-      qDebug () << "FAILED TO EXECUTE COMMAND";
-     //Failure, what to do with data?? 
+      qDebug () << "Command "<<action_text<<" failed or was cancelled";
+      //Nothing was changed in the model, the command can go
+      delete action_to_execute.command;
+      action_to_execute.tool->deleteLater ();
+      checkQueue ();
     }
-      
-      
   }
-    
-  
 }
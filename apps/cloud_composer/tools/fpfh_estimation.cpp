@@ -3,7 +3,7 @@
 #include <pcl/apps/cloud_composer/items/normals_item.h>
 #include <pcl/apps/cloud_composer/items/fpfh_item.h>
 
-#include <pcl/features/fpfh.h>
+#include <pcl/features/fpfh_omp.h>
 #include <pcl/point_types.h>
 #include <pcl/filters/filter.h>
 
@@ -60,7 +60,7 @@ pcl::cloud_composer::FPFHEstimationTool::performAction (ConstItemList input_data
     //Get the normals cloud, we just use the first normals that were found if there are more than one
     pcl::PointCloud<pcl::Normal>::ConstPtr input_normals = normals_list.value(0)->data(ItemDataRole::CLOUD_TEMPLATED).value <pcl::PointCloud<pcl::Normal>::ConstPtr> ();
     
-    pcl::FPFHEstimation<pcl::PointXYZ, pcl::Normal, pcl::FPFHSignature33> fpfh;
+    pcl::FPFHEstimationOMP<pcl::PointXYZ, pcl::Normal, pcl::FPFHSignature33> fpfh;
  //   qDebug () << "Input cloud size = "<<cloud->size ();
 
     //////////////// THE WORK - COMPUTING FPFH ///////////////////
@@ -1,7 +1,7 @@
 #include <pcl/apps/cloud_composer/tools/normal_estimation.h>
 #include <pcl/apps/cloud_composer/items/normals_item.h>
 
-#include <pcl/features/normal_3d.h>
+#include <pcl/features/normal_3d_omp.h>
 #include <pcl/point_types.h>
 
 Q_PLUGIN_METADATA(IID "cloud_composer.ToolFactory/1.0")
@@ -46,7 +46,7 @@ pcl::cloud_composer::NormalEstimationTool::performAction (ConstItemList input_da
     pcl::PointCloud<pcl::PointXYZ>::Ptr cloud (new pcl::PointCloud<pcl::PointXYZ>);
     pcl::fromPCLPointCloud2 (*input_cloud, *cloud);
     // Create the normal estimation class, and pass the input dataset to it
-    pcl::NormalEstimation<pcl::PointXYZ, pcl::Normal> ne;
+    pcl::NormalEstimationOMP<pcl::PointXYZ, pcl::Normal> ne;
     ne.setInputCloud (cloud);
 
     // Create an empty kdtree representation, and pass it to the normal estimation object.
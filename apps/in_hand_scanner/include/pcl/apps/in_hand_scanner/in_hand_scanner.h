@@ -47,10 +47,13 @@
 #include <pcl/apps/in_hand_scanner/common_types.h>
 #include <pcl/apps/in_hand_scanner/opengl_viewer.h>
 
+#include <atomic>
+#include <condition_variable>
 #include <mutex>
 #include <string>
 #include <sstream>
 #include <iomanip>
+#include <thread>
 
 ////////////////////////////////////////////////////////////////////////////////
 // Forward declarations
@@ -231,10 +234,29 @@ namespace pcl
             ~VisualizationFPS () {}
         };
 
-        /** \brief Called when new data arries from the grabber. The grabbing - registration - integration pipeline is implemented here. */
+        /** \brief Output of the input data processing, handed from the grabber thread to the computation thread. */
+        struct ProcessedFrame
+        {
+          RunningMode          running_mode;
+          CloudXYZRGBNormalPtr cloud_data;
+          CloudXYZRGBNormalPtr cloud_discarded;
+          double               time_input_data_processing;
+        };
+
+        /** \brief Called when new data arries from the grabber. Runs the input data processing in the grabber thread and hands the result to the computation thread, so that the processing of the next frame overlaps the registration and integration of the current one.
+          * \note If the computation thread is still busy with the previous frame when the next one is processed, the previous one is dropped.
+          */
         void
         newDataCallback (const CloudXYZRGBAConstPtr& cloud_in);
 
+        /** \brief Waits for processed frames and passes them to processFrame until the destructor is called. */
+        void
+        computationThread ();
+
+        /** \brief The registration - integration part of the scanning pipeline. */
+        void
+        processFrame (const ProcessedFrame& frame);
+
         /** \see http://doc.qt.digia.com/qt/qwidget.html#paintEvent
           * \see http://doc.qt.digia.com/qt/opengl-overpainting.html
           */
@@ -264,8 +286,8 @@ namespace pcl
         /** \brief Please have a look at the documentation of VisualizationFPS. */
         VisualizationFPS visualization_fps_;
 
-        /** \brief Switch between different branches of the scanning pipeline. */
-        RunningMode running_mode_;
+        /** \brief Switch between different branches of the scanning pipeline. Atomic because the grabber thread reads it without locking the mutex. */
+        std::atomic <RunningMode> running_mode_;
 
         /** \brief The iteration of the scanning pipeline (grab - register - integrate). */
         unsigned int iteration_;
@@ -298,7 +320,25 @@ namespace pcl
         MeshPtr mesh_model_;
 
         /** \brief Prevent the application to crash while closing. */
-        bool destructor_called_;
+        std::atomic <bool> destructor_called_;
+
+        /** \brief Runs the registration and integration (see computationThread). */
+        std::thread computation_thread_;
+
+        /** \brief Synchronization of the hand over from the grabber thread to the computation thread. */
+        std::mutex mutex_frame_;
+
+        /** \brief Notifies the computation thread of a new frame or of the destructor call. */
+        std::condition_variable frame_available_;
+
+        /** \brief The last processed frame, not yet taken by the computation thread. */
+        ProcessedFrame pending_frame_;
+
+        /** \brief True if pending_frame_ holds a frame. */
+        bool frame_pending_;
+
+        /** \brief Tells the computation thread to return. */
+        bool quit_computation_;
 
       public:
         PCL_MAKE_ALIGNED_OPERATOR_NEW
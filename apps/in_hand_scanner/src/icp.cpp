@@ -203,8 +203,11 @@ pcl::ihs::ICP::findTransformation (const MeshConstPtr&              mesh_model,
   kd_tree_->setInputCloud (cloud_model_selected);
   t_build = sw.getTime ();
 
-  std::vector <int>   index (1);
-  std::vector <float> squared_distance (1);
+  // Per data point: the transformed point and the index of and squared distance to its nearest model point
+  CloudNormal         cloud_data_transformed;
+  std::vector <int>   corr_index (n_data);
+  std::vector <float> corr_squared_distance (n_data);
+  cloud_data_transformed.resize (n_data);
 
   // Clouds with one to one correspondences
   CloudNormal cloud_model_corr;
@@ -215,7 +218,7 @@ pcl::ihs::ICP::findTransformation (const MeshConstPtr&              mesh_model,
 
   // ICP main loop
   unsigned int iter = 1;
-  PointNormal pt_d;
+  const int n_data_int = static_cast <int> (n_data);
   const float dot_min = std::cos (max_angle_ * 17.45329252e-3); // deg to rad
   while (true)
   {
@@ -226,36 +229,60 @@ pcl::ihs::ICP::findTransformation (const MeshConstPtr&              mesh_model,
     cloud_model_corr.clear ();
     cloud_data_corr.clear ();
     sw.reset ();
-    for (CloudNormal::const_iterator it_d = cloud_data_selected->begin (); it_d!=cloud_data_selected->end (); ++it_d)
+
+    // The searches are independent and run in parallel. The correspondences are collected afterwards in the order
+    // of the data points, which keeps the result independent of the number of threads.
+    bool search_failed = false;
+#pragma omp parallel reduction(||:search_failed)
     {
-      // Transform the data point
-      pt_d = *it_d;
-      pt_d.getVector4fMap ()       = T_cur * pt_d.getVector4fMap ();
-      pt_d.getNormalVector4fMap () = T_cur * pt_d.getNormalVector4fMap ();
+      std::vector <int>   index (1);
+      std::vector <float> squared_distance (1);
 
-      // Find the correspondence to the model points
-      if (!kd_tree_->nearestKSearch (pt_d, 1, index, squared_distance))
+#pragma omp for schedule(static)
+      for (int i=0; i<n_data_int; ++i)
       {
-        std::cerr << "ERROR in icp.cpp: nearestKSearch failed!\n";
-        return (false);
+        // Transform the data point
+        PointNormal& pt_d = cloud_data_transformed [i];
+        pt_d = (*cloud_data_selected) [i];
+        pt_d.getVector4fMap ()       = T_cur * pt_d.getVector4fMap ();
+        pt_d.getNormalVector4fMap () = T_cur * pt_d.getNormalVector4fMap ();
+
+        // Find the correspondence to the model points
+        if (!kd_tree_->nearestKSearch (pt_d, 1, index, squared_distance))
+        {
+          search_failed = true;
+          continue;
+        }
+        corr_index [i]            = index [0];
+        corr_squared_distance [i] = squared_distance [0];
       }
+    }
+    if (search_failed)
+    {
+      std::cerr << "ERROR in icp.cpp: nearestKSearch failed!\n";
+      return (false);
+    }
+
+    for (int i=0; i<n_data_int; ++i)
+    {
+      const PointNormal& pt_d = cloud_data_transformed [i];
 
       // Check the distance threshold
-      if (squared_distance [0] < squared_distance_threshold)
+      if (corr_squared_distance [i] < squared_distance_threshold)
       {
-        if ((std::size_t) index [0] >= cloud_model_selected->size ())
+        if ((std::size_t) corr_index [i] >= cloud_model_selected->size ())
         {
           std::cerr << "ERROR in icp.cpp: Segfault!\n";
-          std::cerr << "  Trying to access index " << index [0] << " >= " << cloud_model_selected->size () << std::endl;
+          std::cerr << "  Trying to access index " << corr_index [i] << " >= " << cloud_model_selected->size () << std::endl;
           exit (EXIT_FAILURE);
         }
 
-        const PointNormal& pt_m = cloud_model_selected->operator [] (index [0]);
+        const PointNormal& pt_m = cloud_model_selected->operator [] (corr_index [i]);
 
         // Check the normals threshold
         if (pt_m.getNormalVector4fMap ().dot (pt_d.getNormalVector4fMap ()) > dot_min)
         {
-          squared_distance_sum += squared_distance [0];
+          squared_distance_sum += corr_squared_distance [i];
 
           cloud_model_corr.push_back (pt_m);
           cloud_data_corr.push_back (pt_d);
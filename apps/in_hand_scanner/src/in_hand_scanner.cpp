@@ -72,7 +72,9 @@ pcl::ihs::InHandScanner::InHandScanner (Base* parent)
     integration_           (new Integration ()),
     mesh_processing_       (new MeshProcessing ()),
     mesh_model_            (new Mesh ()),
-    destructor_called_     (false)
+    destructor_called_     (false),
+    frame_pending_         (false),
+    quit_computation_      (false)
 {
   // http://doc.qt.digia.com/qt/qmetatype.html#qRegisterMetaType
   qRegisterMetaType <pcl::ihs::InHandScanner::RunningMode> ("RunningMode");
@@ -94,11 +96,19 @@ pcl::ihs::InHandScanner::InHandScanner (Base* parent)
 
 pcl::ihs::InHandScanner::~InHandScanner ()
 {
-  std::lock_guard<std::mutex> lock (mutex_);
+  std::unique_lock<std::mutex> lock (mutex_);
   destructor_called_ = true;
 
   if (grabber_ && grabber_->isRunning ()) grabber_->stop ();
   if (new_data_connection_.connected ())  new_data_connection_.disconnect ();
+  lock.unlock ();
+
+  std::unique_lock<std::mutex> lock_frame (mutex_frame_);
+  quit_computation_ = true;
+  lock_frame.unlock ();
+  frame_available_.notify_one ();
+
+  if (computation_thread_.joinable ()) computation_thread_.join ();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -280,32 +290,77 @@ pcl::ihs::InHandScanner::keyPressEvent (QKeyEvent* event)
 void
 pcl::ihs::InHandScanner::newDataCallback (const CloudXYZRGBAConstPtr& cloud_in)
 {
-  Base::calcFPS (computation_fps_); // Must come before the lock!
-
-  std::unique_lock<std::mutex> lock (mutex_);
   if (destructor_called_) return;
 
   pcl::StopWatch sw;
 
-  // Input data processing
-  CloudXYZRGBNormalPtr cloud_data;
-  CloudXYZRGBNormalPtr cloud_discarded;
-  if (running_mode_ == RM_SHOW_MODEL)
+  // Input data processing. The mutex is not locked so that this overlaps the registration and integration of the previous frame.
+  ProcessedFrame frame;
+  frame.running_mode = running_mode_;
+  if (frame.running_mode == RM_SHOW_MODEL)
   {
-    cloud_data = CloudXYZRGBNormalPtr (new CloudXYZRGBNormal ());
+    frame.cloud_data = CloudXYZRGBNormalPtr (new CloudXYZRGBNormal ());
   }
-  else if (running_mode_ == RM_UNPROCESSED)
+  else if (frame.running_mode == RM_UNPROCESSED)
   {
-    if (!input_data_processing_->calculateNormals (cloud_in, cloud_data))
+    if (!input_data_processing_->calculateNormals (cloud_in, frame.cloud_data))
       return;
   }
-  else if (running_mode_ >= RM_PROCESSED)
+  else if (frame.running_mode >= RM_PROCESSED)
   {
-    if (!input_data_processing_->segment (cloud_in, cloud_data, cloud_discarded))
+    if (!input_data_processing_->segment (cloud_in, frame.cloud_data, frame.cloud_discarded))
       return;
   }
 
-  double time_input_data_processing = sw.getTime ();
+  frame.time_input_data_processing = sw.getTime ();
+
+  // Hand over to the computation thread, replacing a frame it did not take yet
+  std::unique_lock<std::mutex> lock_frame (mutex_frame_);
+  pending_frame_ = frame;
+  frame_pending_ = true;
+  lock_frame.unlock ();
+  frame_available_.notify_one ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void
+pcl::ihs::InHandScanner::computationThread ()
+{
+  while (true)
+  {
+    std::unique_lock<std::mutex> lock_frame (mutex_frame_);
+    frame_available_.wait (lock_frame, [this] {return (frame_pending_ || quit_computation_);});
+    if (quit_computation_) return;
+
+    const ProcessedFrame frame = pending_frame_;
+    pending_frame_ = ProcessedFrame ();
+    frame_pending_ = false;
+    lock_frame.unlock ();
+
+    this->processFrame (frame);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void
+pcl::ihs::InHandScanner::processFrame (const ProcessedFrame& frame)
+{
+  Base::calcFPS (computation_fps_); // Must come before the lock!
+
+  std::unique_lock<std::mutex> lock (mutex_);
+  if (destructor_called_) return;
+
+  // The running mode may have changed while the frame was processed. Drop it if it went through a different branch of the input data processing.
+  const auto branch = [] (const RunningMode rm) {return (rm >= RM_PROCESSED ? RM_PROCESSED : rm);};
+  if (branch (frame.running_mode) != branch (running_mode_)) return;
+
+  pcl::StopWatch sw;
+
+  CloudXYZRGBNormalPtr cloud_data      = frame.cloud_data;
+  CloudXYZRGBNormalPtr cloud_discarded = frame.cloud_discarded;
+  const double time_input_data_processing = frame.time_input_data_processing;
 
   // Registration & integration
   if (running_mode_ >= RM_REGISTRATION_CONT)
@@ -483,6 +538,9 @@ pcl::ihs::InHandScanner::startGrabberImpl ()
 
   std::function <void (const CloudXYZRGBAConstPtr&)> new_data_cb = [this] (const CloudXYZRGBAConstPtr& cloud) { newDataCallback (cloud); };
   new_data_connection_ = grabber_->registerCallback (new_data_cb);
+  if (!computation_thread_.joinable ())
+    computation_thread_ = std::thread ([this] { computationThread (); });
+
   grabber_->start ();
 
   starting_grabber_ = false;
@@ -116,10 +116,15 @@ pcl::ihs::InputDataProcessing::segment (const CloudXYZRGBAConstPtr& cloud_in,
   const float z_min = .01f * z_min_;
   const float z_max = .01f * z_max_;
 
-  float h, s, v;
-  for (MatrixXb::Index r=0; r<xyz_mask.rows (); ++r)
+  const int rows = static_cast <int> (xyz_mask.rows ());
+  const int cols = static_cast <int> (xyz_mask.cols ());
+
+  // The rows are independent
+#pragma omp parallel for schedule(static)
+  for (int r=0; r<rows; ++r)
   {
-    for (MatrixXb::Index c=0; c<xyz_mask.cols (); ++c)
+    float h, s, v;
+    for (int c=0; c<cols; ++c)
     {
       const PointXYZRGBA& xyzrgb = (*cloud_in)      [r*width + c];
       const Normal&       normal = (*cloud_normals) [r*width + c];
@@ -151,20 +156,21 @@ pcl::ihs::InputDataProcessing::segment (const CloudXYZRGBAConstPtr& cloud_in,
   else              hsv_mask.setZero ();
 
   // Copy the normals into the clouds.
-  cloud_out->reserve (cloud_in->size ());
-  cloud_discarded->reserve (cloud_in->size ());
+  cloud_out->resize (cloud_in->size ());
+  cloud_discarded->resize (cloud_in->size ());
 
-  pcl::PointXYZRGBNormal pt_out, pt_discarded;
-  pt_discarded.r = 50;
-  pt_discarded.g = 50;
-  pt_discarded.b = 230;
+#pragma omp parallel for schedule(static)
+  for (int r=0; r<rows; ++r)
+  {
+    pcl::PointXYZRGBNormal pt_out, pt_discarded;
+    pt_discarded.r = 50;
+    pt_discarded.g = 50;
+    pt_discarded.b = 230;
 
-  PointXYZRGBA xyzrgb;
-  Normal       normal;
+    PointXYZRGBA xyzrgb;
+    Normal       normal;
 
-  for (MatrixXb::Index r=0; r<xyz_mask.rows (); ++r)
-  {
-    for (MatrixXb::Index c=0; c<xyz_mask.cols (); ++c)
+    for (int c=0; c<cols; ++c)
     {
       if (xyz_mask (r, c))
       {
@@ -196,8 +202,8 @@ pcl::ihs::InputDataProcessing::segment (const CloudXYZRGBAConstPtr& cloud_in,
         pt_discarded.x = std::numeric_limits <float>::quiet_NaN ();
       }
 
-      cloud_out->push_back       (pt_out);
-      cloud_discarded->push_back (pt_discarded);
+      (*cloud_out)       [r*width + c] = pt_out;
+      (*cloud_discarded) [r*width + c] = pt_discarded;
     }
   }
 
@@ -234,28 +240,32 @@ pcl::ihs::InputDataProcessing::calculateNormals (const CloudXYZRGBAConstPtr& clo
   cloud_out->height   = cloud_in->height;
   cloud_out->is_dense = false;
 
-  CloudNormals::const_iterator it_n   = cloud_normals->begin ();
-  CloudXYZRGBNormal::iterator  it_out = cloud_out->begin ();
-
   PointXYZRGBNormal invalid_pt;
   invalid_pt.x        = invalid_pt.y        = invalid_pt.z        = std::numeric_limits <float>::quiet_NaN ();
   invalid_pt.normal_x = invalid_pt.normal_y = invalid_pt.normal_z = std::numeric_limits <float>::quiet_NaN ();
   invalid_pt.data   [3] = 1.f;
   invalid_pt.data_n [3] = 0.f;
 
-  for (auto it_in = cloud_in->begin (); it_in!=cloud_in->end (); ++it_in, ++it_n, ++it_out)
+  const int n = static_cast <int> (cloud_in->size ());
+
+#pragma omp parallel for schedule(static)
+  for (int i=0; i<n; ++i)
   {
-    if (!it_n->getNormalVector4fMap (). hasNaN ())
+    const PointXYZRGBA& pt_in  = (*cloud_in)      [i];
+    const Normal&       normal = (*cloud_normals) [i];
+    PointXYZRGBNormal&  pt_out = (*cloud_out)     [i];
+
+    if (!normal.getNormalVector4fMap (). hasNaN ())
     {
       // m -> cm
-      it_out->getVector4fMap ()       = 100.f * it_in->getVector4fMap ();
-      it_out->data [3]                = 1.f;
-      it_out->rgba                    = it_in->rgba;
-      it_out->getNormalVector4fMap () = it_n->getNormalVector4fMap ();
+      pt_out.getVector4fMap ()       = 100.f * pt_in.getVector4fMap ();
+      pt_out.data [3]                = 1.f;
+      pt_out.rgba                    = pt_in.rgba;
+      pt_out.getNormalVector4fMap () = normal.getNormalVector4fMap ();
     }
     else
     {
-      *it_out = invalid_pt;
+      pt_out = invalid_pt;
     }
   }
 
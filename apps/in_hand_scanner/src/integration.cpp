@@ -219,8 +219,6 @@ pcl::ihs::Integration::merge (const CloudXYZRGBNormalConstPtr& cloud_data,
     xyz_model->push_back (PointXYZ (pt.x, pt.y, pt.z));
   }
   kd_tree_->setInputCloud (xyz_model);
-  std::vector <int>   index (1);
-  std::vector <float> squared_distance (1);
 
   mesh_model->reserveVertices (mesh_model->sizeVertices () + cloud_data->size ());
   mesh_model->reserveEdges    (mesh_model->sizeEdges    () + (width-1) * height + width * (height-1) + (width-1) * (height-1));
@@ -236,36 +234,56 @@ pcl::ihs::Integration::merge (const CloudXYZRGBNormalConstPtr& cloud_data,
   // Store which vertex is set at which position (initialized with invalid indices)
   VertexIndices vertex_indices (cloud_data->size (), VertexIndex ());
 
-  // Set the transformed points not reached by the main loop
-  for (int c=0; c<width; ++c)
-  {
-    const PointXYZRGBNormal& pt_d = cloud_data->operator [] (c);
-    const float weight = -pt_d.normal_z; // weight = -dot (normal, [0; 0; 1])
+  // Transform the data points and search their nearest model vertex. The kd-tree holds the model vertices as they were
+  // before the merge, so the searches don't depend on the averaging below and run in parallel. The averaging and the
+  // connection of the mesh stay sequential.
+  std::vector <int>   nn_index (cloud_data->size (), -1);
+  std::vector <float> nn_squared_distance (cloud_data->size ());
+  bool search_failed = false;
 
-    if (!std::isnan (pt_d.x) && weight > min_weight_)
-    {
-      PointIHS& pt_d_t = cloud_data_transformed->operator [] (c);
-      pt_d_t = PointIHS (pt_d, weight);
-      pt_d_t.getVector4fMap ()       = T * pt_d_t.getVector4fMap ();
-      pt_d_t.getNormalVector4fMap () = T * pt_d_t.getNormalVector4fMap ();
-    }
-  }
-  for (int r=1; r<height; ++r)
+#pragma omp parallel reduction(||:search_failed)
   {
-    for (int c=0; c<2; ++c)
-    {
-      const PointXYZRGBNormal& pt_d = cloud_data->operator [] (r*width + c);
-      const float weight = -pt_d.normal_z; // weight = -dot (normal, [0; 0; 1])
+    std::vector <int>   index (1);
+    std::vector <float> squared_distance (1);
 
-      if (!std::isnan (pt_d.x) && weight > min_weight_)
+#pragma omp for schedule(static)
+    for (int r=0; r<height; ++r)
+    {
+      for (int c=0; c<width; ++c)
       {
-        PointIHS& pt_d_t = cloud_data_transformed->operator [] (r*width + c);
-        pt_d_t = PointIHS (pt_d, weight);
-        pt_d_t.getVector4fMap ()       = T * pt_d_t.getVector4fMap ();
-        pt_d_t.getNormalVector4fMap () = T * pt_d_t.getNormalVector4fMap ();
+        const int ind = r*width + c;
+        const PointXYZRGBNormal& pt_d = cloud_data->operator [] (ind);
+        const float weight = -pt_d.normal_z; // weight = -dot (normal, [0; 0; 1])
+
+        if (!std::isnan (pt_d.x) && weight > min_weight_)
+        {
+          PointIHS& pt_d_t = cloud_data_transformed->operator [] (ind);
+          pt_d_t = PointIHS (pt_d, weight);
+          pt_d_t.getVector4fMap ()       = T * pt_d_t.getVector4fMap ();
+          pt_d_t.getNormalVector4fMap () = T * pt_d_t.getNormalVector4fMap ();
+
+          // Points not reached by the main loop are not averaged
+          if (r < 1 || c < 2) continue;
+
+          pcl::PointXYZ tmp; tmp.getVector4fMap () = pt_d_t.getVector4fMap ();
+
+          // NN search
+          if (!kd_tree_->nearestKSearch (tmp, 1, index, squared_distance))
+          {
+            search_failed = true;
+            continue;
+          }
+          nn_index [ind]            = index [0];
+          nn_squared_distance [ind] = squared_distance [0];
+        }
       }
     }
   }
+  if (search_failed)
+  {
+    std::cerr << "ERROR in integration.cpp: nearestKSearch failed!\n";
+    return (false);
+  }
 
   // 4   2 - 1  //
   //     |   |  //
@@ -297,68 +315,49 @@ pcl::ihs::Integration::merge (const CloudXYZRGBNormalConstPtr& cloud_data,
       assert (ind_3 >= 0 && ind_3 < static_cast <int> (cloud_data->size ()));
       assert (ind_4 >= 0 && ind_4 < static_cast <int> (cloud_data->size ()));
 
-      const PointXYZRGBNormal& pt_d_0   = cloud_data->operator             [] (ind_0);
-      PointIHS&                pt_d_t_0 = cloud_data_transformed->operator [] (ind_0);
-      const PointIHS&          pt_d_t_1 = cloud_data_transformed->operator [] (ind_1);
-      const PointIHS&          pt_d_t_2 = cloud_data_transformed->operator [] (ind_2);
-      const PointIHS&          pt_d_t_3 = cloud_data_transformed->operator [] (ind_3);
-      const PointIHS&          pt_d_t_4 = cloud_data_transformed->operator [] (ind_4);
+      const PointIHS& pt_d_t_0 = cloud_data_transformed->operator [] (ind_0);
+      const PointIHS& pt_d_t_1 = cloud_data_transformed->operator [] (ind_1);
+      const PointIHS& pt_d_t_2 = cloud_data_transformed->operator [] (ind_2);
+      const PointIHS& pt_d_t_3 = cloud_data_transformed->operator [] (ind_3);
+      const PointIHS& pt_d_t_4 = cloud_data_transformed->operator [] (ind_4);
 
       VertexIndex& vi_0 = vertex_indices [ind_0];
 
-      const float weight = -pt_d_0.normal_z; // weight = -dot (normal, [0; 0; 1])
-
-      if (!std::isnan (pt_d_0.x) && weight > min_weight_)
+      // Average out corresponding points
+      if (nn_index [ind_0] >= 0 && nn_squared_distance [ind_0] <= max_squared_distance_)
       {
-        pt_d_t_0 = PointIHS (pt_d_0, weight);
-        pt_d_t_0.getVector4fMap ()       = T * pt_d_t_0.getVector4fMap ();
-        pt_d_t_0.getNormalVector4fMap () = T * pt_d_t_0.getNormalVector4fMap ();
-
-        pcl::PointXYZ tmp; tmp.getVector4fMap () = pt_d_t_0.getVector4fMap ();
-
-        // NN search
-        if (!kd_tree_->nearestKSearch (tmp, 1, index, squared_distance))
-        {
-          std::cerr << "ERROR in integration.cpp: nearestKSearch failed!\n";
-          return (false);
-        }
+        PointIHS& pt_m = mesh_model->getVertexDataCloud () [nn_index [ind_0]]; // Non-const reference!
 
-        // Average out corresponding points
-        if (squared_distance [0] <= max_squared_distance_)
+        if (pt_m.getNormalVector4fMap ().dot (pt_d_t_0.getNormalVector4fMap ()) >= dot_min)
         {
-          PointIHS& pt_m = mesh_model->getVertexDataCloud () [index [0]]; // Non-const reference!
-
-          if (pt_m.getNormalVector4fMap ().dot (pt_d_t_0.getNormalVector4fMap ()) >= dot_min)
-          {
-            vi_0 = VertexIndex (index [0]);
+          vi_0 = VertexIndex (nn_index [ind_0]);
 
-            const float W   = pt_m.weight;         // Old accumulated weight
-            const float w   = pt_d_t_0.weight;     // Weight of new point
-            const float WW  = pt_m.weight = W + w; // New accumulated weight
+          const float W   = pt_m.weight;         // Old accumulated weight
+          const float w   = pt_d_t_0.weight;     // Weight of new point
+          const float WW  = pt_m.weight = W + w; // New accumulated weight
 
-            const float r_m = static_cast <float> (pt_m.r);
-            const float g_m = static_cast <float> (pt_m.g);
-            const float b_m = static_cast <float> (pt_m.b);
+          const float r_m = static_cast <float> (pt_m.r);
+          const float g_m = static_cast <float> (pt_m.g);
+          const float b_m = static_cast <float> (pt_m.b);
 
-            const float r_d = static_cast <float> (pt_d_t_0.r);
-            const float g_d = static_cast <float> (pt_d_t_0.g);
-            const float b_d = static_cast <float> (pt_d_t_0.b);
+          const float r_d = static_cast <float> (pt_d_t_0.r);
+          const float g_d = static_cast <float> (pt_d_t_0.g);
+          const float b_d = static_cast <float> (pt_d_t_0.b);
 
-            pt_m.getVector4fMap ()       = ( W*pt_m.getVector4fMap ()       + w*pt_d_t_0.getVector4fMap ())       / WW;
-            pt_m.getNormalVector4fMap () = ((W*pt_m.getNormalVector4fMap () + w*pt_d_t_0.getNormalVector4fMap ()) / WW).normalized ();
-            pt_m.r                       = this->trimRGB ((W*r_m + w*r_d) / WW);
-            pt_m.g                       = this->trimRGB ((W*g_m + w*g_d) / WW);
-            pt_m.b                       = this->trimRGB ((W*b_m + w*b_d) / WW);
+          pt_m.getVector4fMap ()       = ( W*pt_m.getVector4fMap ()       + w*pt_d_t_0.getVector4fMap ())       / WW;
+          pt_m.getNormalVector4fMap () = ((W*pt_m.getNormalVector4fMap () + w*pt_d_t_0.getNormalVector4fMap ()) / WW).normalized ();
+          pt_m.r                       = this->trimRGB ((W*r_m + w*r_d) / WW);
+          pt_m.g                       = this->trimRGB ((W*g_m + w*g_d) / WW);
+          pt_m.b                       = this->trimRGB ((W*b_m + w*b_d) / WW);
 
-            // Point has been observed again -> give it some extra time to live
-            pt_m.age = 0;
+          // Point has been observed again -> give it some extra time to live
+          pt_m.age = 0;
 
-            // Add a direction
-            pcl::ihs::addDirection (pt_m.getNormalVector4fMap (), sensor_eye-pt_m.getVector4fMap (), pt_m.directions);
+          // Add a direction
+          pcl::ihs::addDirection (pt_m.getNormalVector4fMap (), sensor_eye-pt_m.getVector4fMap (), pt_m.directions);
 
-          } // dot normals
-        } // squared distance
-      } // !isnan && min weight
+        } // dot normals
+      } // squared distance
 
       // Connect
       // 4   2 - 1  //
@@ -40,6 +40,21 @@ private:
   vtkSmartPointer<vtkPolyData> polydata_;
   bool gen_organized_;
   std::function<bool(const Eigen::Vector3f&)> campos_constraints_func_;
+  unsigned int threads_;
+
+  /**
+   * \brief Converts the depth buffer of a rendered view to a cloud, in the coordinates
+   * of the model
+   * \param depth the depth buffer of the render window
+   * \param projection_inverted the inverse of the composite projection of the view
+   * \param back_to_real_scale the transform from the rendered model to the model
+   * \param cloud the organized or unorganized cloud of the view
+   */
+  void
+  depthToCloud(const std::vector<float>& depth,
+               const Eigen::Matrix4f& projection_inverted,
+               const Eigen::Matrix4f& back_to_real_scale,
+               pcl::PointCloud<pcl::PointXYZ>& cloud) const;
 
   struct camPosConstraintsAllTrue {
     bool
@@ -60,6 +75,7 @@ public:
     compute_entropy_ = false;
     gen_organized_ = false;
     campos_constraints_func_ = camPosConstraintsAllTrue();
+    threads_ = 0;
   }
 
   void
@@ -140,6 +156,17 @@ public:
     view_angle_ = angle;
   }
 
+  /**
+   * \brief Sets the number of threads used to convert the rendered views to clouds
+   * \param nr_threads the number of hardware threads to use (0 sets the value back to
+   * automatic)
+   */
+  void
+  setNumberOfThreads(unsigned int nr_threads = 0)
+  {
+    threads_ = nr_threads;
+  }
+
   /**
    * \brief adds the mesh to be used as a vtkPolyData
    * \param polydata vtkPolyData object
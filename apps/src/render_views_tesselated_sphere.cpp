@@ -6,6 +6,7 @@
  */
 
 #include <pcl/apps/render_views_tesselated_sphere.h>
+#include <pcl/common/utils.h> // for getNumberOfThreads
 #include <pcl/point_types.h>
 
 #include <vtkActor.h>
@@ -25,9 +26,60 @@
 #include <vtkTransform.h>
 #include <vtkTransformFilter.h>
 #include <vtkTriangle.h>
-#include <vtkWorldPointPicker.h>
 
 #include <array>
+#include <cmath>
+#include <limits>
+
+void
+pcl::apps::RenderViewsTesselatedSphere::depthToCloud(
+    const std::vector<float>& depth,
+    const Eigen::Matrix4f& projection_inverted,
+    const Eigen::Matrix4f& back_to_real_scale,
+    pcl::PointCloud<pcl::PointXYZ>& cloud) const
+{
+  // The organized cloud is transposed with respect to the depth buffer, i.e. the pixel
+  // (x, y) is the point (y, x)
+  int resolution = resolution_;
+  cloud.points.resize(resolution * resolution);
+  cloud.width = resolution;
+  cloud.height = resolution;
+  cloud.is_dense = false;
+
+  float step = 2.0f / float(resolution);
+#pragma omp parallel for default(none)                                                 \
+    shared(depth, projection_inverted, back_to_real_scale, cloud, resolution, step)      \
+    schedule(static) num_threads(pcl::utils::getNumberOfThreads(threads_))
+  for (int x = 0; x < resolution; x++) {
+    for (int y = 0; y < resolution; y++) {
+      pcl::PointXYZ& point = cloud[x * resolution + y];
+      const float value = depth[y * resolution + x];
+      if (value == 1.0) {
+        point.x = point.y = point.z = std::numeric_limits<float>::quiet_NaN();
+        continue;
+      }
+
+      Eigen::Vector4f coords =
+          projection_inverted *
+          Eigen::Vector4f(step * float(x) - 1.0f, step * float(y) - 1.0f, value, 1.0f);
+      coords /= coords[3];
+      point.getVector4fMap() = back_to_real_scale * coords;
+    }
+  }
+
+  if (!gen_organized_) {
+    // Keep the valid points, in the order of the organized cloud
+    std::size_t count_valid_depth_pixels = 0;
+    for (const auto& point : cloud.points) {
+      if (std::isfinite(point.x))
+        cloud[count_valid_depth_pixels++] = point;
+    }
+    cloud.points.resize(count_valid_depth_pixels);
+    cloud.width = static_cast<std::uint32_t>(count_valid_depth_pixels);
+    cloud.height = 1;
+    cloud.is_dense = true;
+  }
+}
 
 void
 pcl::apps::RenderViewsTesselatedSphere::generateViews()
@@ -173,12 +225,9 @@ pcl::apps::RenderViewsTesselatedSphere::generateViews()
   vtkSmartPointer<vtkRenderer> renderer = vtkSmartPointer<vtkRenderer>::New();
   render_win->AddRenderer(renderer);
   render_win->SetSize(resolution_, resolution_);
+  render_win->SetOffScreenRendering(1);
   renderer->SetBackground(1.0, 0, 0);
 
-  // create picker
-  vtkSmartPointer<vtkWorldPointPicker> worldPicker =
-      vtkSmartPointer<vtkWorldPointPicker>::New();
-
   vtkSmartPointer<vtkCamera> cam = vtkSmartPointer<vtkCamera>::New();
   cam->SetFocalPoint(0, 0, 0);
 
@@ -190,6 +239,9 @@ pcl::apps::RenderViewsTesselatedSphere::generateViews()
   cam->SetViewAngle(view_angle_);
   cam->Modified();
 
+  // Depth buffer of the render window, reused for all the views
+  std::vector<float> depth(resolution_ * resolution_);
+
   // For each camera position, traposesnsform the object and render view
   for (const auto& cam_position : cam_positions) {
     cam_pos[0] = cam_position[0];
@@ -288,71 +340,21 @@ pcl::apps::RenderViewsTesselatedSphere::generateViews()
         backToRealScale_eigen(x, y) =
             float(backToRealScale->GetMatrix()->GetElement(x, y));
 
-    pcl::PointCloud<pcl::PointXYZ>::Ptr cloud(new pcl::PointCloud<pcl::PointXYZ>);
-    cloud->points.resize(resolution_ * resolution_);
-
-    if (gen_organized_) {
-      cloud->width = resolution_;
-      cloud->height = resolution_;
-      cloud->is_dense = false;
-
-      double coords[3];
-      float* depth = new float[resolution_ * resolution_];
-      render_win->GetZbufferData(0, 0, resolution_ - 1, resolution_ - 1, &(depth[0]));
-
-      for (int x = 0; x < resolution_; x++) {
-        for (int y = 0; y < resolution_; y++) {
-          float value = depth[y * resolution_ + x];
-          if (value == 1.0) {
-            cloud->at(y, x).x = cloud->at(y, x).y = cloud->at(y, x).z =
-                std::numeric_limits<float>::quiet_NaN();
-          }
-          else {
-            worldPicker->Pick(x, y, value, renderer);
-            worldPicker->GetPickPosition(coords);
-            cloud->at(y, x).x = static_cast<float>(coords[0]);
-            cloud->at(y, x).y = static_cast<float>(coords[1]);
-            cloud->at(y, x).z = static_cast<float>(coords[2]);
-            cloud->at(y, x).getVector4fMap() =
-                backToRealScale_eigen * cloud->at(y, x).getVector4fMap();
-          }
-        }
-      }
+    render_win->GetZbufferData(0, 0, resolution_ - 1, resolution_ - 1, depth.data());
 
-      delete[] depth;
-    }
-    else {
-      cloud->width = resolution_ * resolution_;
-      cloud->height = 1;
-
-      double coords[3];
-      float* depth = new float[resolution_ * resolution_];
-      render_win->GetZbufferData(0, 0, resolution_ - 1, resolution_ - 1, &(depth[0]));
-
-      int count_valid_depth_pixels = 0;
-      for (int x = 0; x < resolution_; x++) {
-        for (int y = 0; y < resolution_; y++) {
-          float value = depth[y * resolution_ + x];
-          if (value == 1.0)
-            continue;
-
-          worldPicker->Pick(x, y, value, renderer);
-          worldPicker->GetPickPosition(coords);
-          (*cloud)[count_valid_depth_pixels].x = static_cast<float>(coords[0]);
-          (*cloud)[count_valid_depth_pixels].y = static_cast<float>(coords[1]);
-          (*cloud)[count_valid_depth_pixels].z = static_cast<float>(coords[2]);
-          (*cloud)[count_valid_depth_pixels].getVector4fMap() =
-              backToRealScale_eigen *
-              (*cloud)[count_valid_depth_pixels].getVector4fMap();
-          count_valid_depth_pixels++;
-        }
-      }
-
-      delete[] depth;
+    // Unproject the depth buffer with the inverse of the projection of the view,
+    // instead of picking every pixel
+    vtkSmartPointer<vtkMatrix4x4> composite_projection =
+        cam_tmp->GetCompositeProjectionTransformMatrix(
+            renderer->GetTiledAspectRatio(), 0, 1);
+    Eigen::Matrix4f projection_inverted;
+    for (int x = 0; x < 4; x++)
+      for (int y = 0; y < 4; y++)
+        projection_inverted(x, y) = float(composite_projection->GetElement(x, y));
+    projection_inverted = projection_inverted.inverse().eval();
 
-      cloud->points.resize(count_valid_depth_pixels);
-      cloud->width = count_valid_depth_pixels;
-    }
+    pcl::PointCloud<pcl::PointXYZ>::Ptr cloud(new pcl::PointCloud<pcl::PointXYZ>);
+    depthToCloud(depth, projection_inverted, backToRealScale_eigen, *cloud);
 
     if (compute_entropy_) {
       //////////////////////////////
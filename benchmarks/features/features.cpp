@@ -0,0 +1,151 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2024-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <pcl/benchmarks/clouds.h>
+#include <pcl/features/fpfh_omp.h>
+#include <pcl/features/normal_3d_omp.h>
+#include <pcl/features/shot_omp.h>
+#include <pcl/search/kdtree.h>
+
+#include <benchmark/benchmark.h>
+
+namespace
+{
+  const std::size_t nr_keypoints = 1000;
+
+  struct FeatureInput
+  {
+    pcl::PointCloud<pcl::PointXYZ>::ConstPtr cloud;
+    pcl::PointCloud<pcl::Normal>::ConstPtr normals;
+    pcl::IndicesConstPtr keypoints;
+    float spacing;
+  };
+
+  FeatureInput
+  makeInput (const pcl::PointCloud<pcl::PointXYZ>::ConstPtr &cloud)
+  {
+    FeatureInput input;
+    input.cloud = pcl::benchmarks::removeNaN (*cloud);
+    input.spacing = pcl::benchmarks::getPointSpacing (*input.cloud);
+
+    pcl::NormalEstimationOMP<pcl::PointXYZ, pcl::Normal> normal_estimation (0);
+    normal_estimation.setInputCloud (input.cloud);
+    normal_estimation.setKSearch (10);
+    pcl::PointCloud<pcl::Normal>::Ptr normals (new pcl::PointCloud<pcl::Normal>);
+    normal_estimation.compute (*normals);
+    input.normals = normals;
+
+    input.keypoints.reset (new pcl::Indices (pcl::benchmarks::getQueryIndices (*input.cloud, nr_keypoints)));
+    return (input);
+  }
+
+  void
+  BM_NormalEstimation (benchmark::State &state, const FeatureInput &input)
+  {
+    pcl::NormalEstimationOMP<pcl::PointXYZ, pcl::Normal> normal_estimation (static_cast<unsigned int> (state.range (1)));
+    normal_estimation.setInputCloud (input.cloud);
+    normal_estimation.setKSearch (static_cast<int> (state.range (0)));
+
+    pcl::PointCloud<pcl::Normal> normals;
+    for (auto _ : state)
+    {
+      normal_estimation.compute (normals);
+      benchmark::DoNotOptimize (normals.data ());
+    }
+    state.SetItemsProcessed (state.iterations () * input.cloud->size ());
+  }
+
+  void
+  BM_FPFHEstimation (benchmark::State &state, const FeatureInput &input)
+  {
+    pcl::FPFHEstimationOMP<pcl::PointXYZ, pcl::Normal, pcl::FPFHSignature33> fpfh (static_cast<unsigned int> (state.range (1)));
+    fpfh.setInputCloud (input.cloud);
+    fpfh.setInputNormals (input.normals);
+    fpfh.setIndices (input.keypoints);
+    // Radius in multiples of the point spacing
+    fpfh.setRadiusSearch (static_cast<double> (state.range (0)) * input.spacing);
+
+    pcl::PointCloud<pcl::FPFHSignature33> features;
+    for (auto _ : state)
+    {
+      fpfh.compute (features);
+      benchmark::DoNotOptimize (features.data ());
+    }
+    state.SetItemsProcessed (state.iterations () * input.keypoints->size ());
+  }
+
+  void
+  BM_SHOTEstimation (benchmark::State &state, const FeatureInput &input)
+  {
+    pcl::SHOTEstimationOMP<pcl::PointXYZ, pcl::Normal, pcl::SHOT352> shot (static_cast<unsigned int> (state.range (1)));
+    shot.setInputCloud (input.cloud);
+    shot.setInputNormals (input.normals);
+    shot.setIndices (input.keypoints);
+    shot.setRadiusSearch (static_cast<double> (state.range (0)) * input.spacing);
+
+    pcl::PointCloud<pcl::SHOT352> features;
+    for (auto _ : state)
+    {
+      shot.compute (features);
+      benchmark::DoNotOptimize (features.data ());
+    }
+    state.SetItemsProcessed (state.iterations () * input.keypoints->size ());
+  }
+}
+
+int
+main (int argc, char** argv)
+{
+  benchmark::Initialize (&argc, argv);
+  const auto clouds = pcl::benchmarks::loadClouds (argc, argv);
+  if (clouds.size () != static_cast<std::size_t> (argc - 1))
+    return (-1);
+
+  // Arguments: k or radius in point spacings, number of threads
+  for (const auto &named_cloud : pcl::benchmarks::getInputs (clouds))
+  {
+    const FeatureInput input = makeInput (named_cloud.cloud);
+    benchmark::RegisterBenchmark (("BM_NormalEstimation/" + named_cloud.name).c_str (), &BM_NormalEstimation, input)
+      ->ArgsProduct ({{10, 30}, {1, 4}})->Unit (benchmark::kMillisecond)->UseRealTime ();
+    benchmark::RegisterBenchmark (("BM_FPFHEstimation/" + named_cloud.name).c_str (), &BM_FPFHEstimation, input)
+      ->ArgsProduct ({{5, 10}, {1, 4}})->Unit (benchmark::kMillisecond)->UseRealTime ();
+    benchmark::RegisterBenchmark (("BM_SHOTEstimation/" + named_cloud.name).c_str (), &BM_SHOTEstimation, input)
+      ->ArgsProduct ({{5, 10}, {1, 4}})->Unit (benchmark::kMillisecond)->UseRealTime ();
+  }
+  benchmark::RunSpecifiedBenchmarks ();
+  return (0);
+}
@@ -0,0 +1,80 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2024-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <pcl/benchmarks/clouds.h>
+#include <pcl/filters/voxel_grid.h>
+
+#include <benchmark/benchmark.h>
+
+namespace
+{
+  void
+  BM_VoxelGrid (benchmark::State &state, const pcl::PointCloud<pcl::PointXYZ>::ConstPtr &cloud)
+  {
+    // Leaf size in multiples of the point spacing
+    const float leaf_size = static_cast<float> (state.range (0)) * pcl::benchmarks::getPointSpacing (*cloud);
+    pcl::VoxelGrid<pcl::PointXYZ> voxel_grid;
+    voxel_grid.setInputCloud (cloud);
+    voxel_grid.setLeafSize (leaf_size, leaf_size, leaf_size);
+    voxel_grid.setNumberOfThreads (static_cast<unsigned int> (state.range (1)));
+
+    pcl::PointCloud<pcl::PointXYZ> output;
+    for (auto _ : state)
+    {
+      voxel_grid.filter (output);
+      benchmark::DoNotOptimize (output.data ());
+    }
+    state.SetItemsProcessed (state.iterations () * cloud->size ());
+    state.counters["output_points"] = static_cast<double> (output.size ());
+  }
+}
+
+int
+main (int argc, char** argv)
+{
+  benchmark::Initialize (&argc, argv);
+  const auto clouds = pcl::benchmarks::loadClouds (argc, argv);
+  if (clouds.size () != static_cast<std::size_t> (argc - 1))
+    return (-1);
+
+  // Arguments: leaf size in point spacings, number of threads
+  for (const auto &input : pcl::benchmarks::getInputs (clouds))
+    benchmark::RegisterBenchmark (("BM_VoxelGrid/" + input.name).c_str (), &BM_VoxelGrid, pcl::benchmarks::removeNaN (*input.cloud))
+      ->ArgsProduct ({{2, 8}, {1, 4}})->Unit (benchmark::kMillisecond)->UseRealTime ();
+  benchmark::RunSpecifiedBenchmarks ();
+  return (0);
+}
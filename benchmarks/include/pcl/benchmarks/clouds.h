@@ -0,0 +1,159 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2024-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#pragma once
+
+#include <pcl/common/common.h> // for getMinMax3D
+#include <pcl/io/pcd_io.h>
+#include <pcl/point_cloud.h>
+#include <pcl/point_types.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace pcl
+{
+  namespace benchmarks
+  {
+    /** \brief A benchmark input, named after its file or its size. */
+    struct NamedCloud
+    {
+      std::string name;
+      PointCloud<PointXYZ>::ConstPtr cloud;
+    };
+
+    /** \brief The number of points of the synthetic inputs, to see how the algorithms scale. */
+    const std::vector<std::size_t> synthetic_sizes = {10000, 100000, 1000000};
+
+    /** \brief Load the PCD files given on the command line, after benchmark::Initialize removed its own flags.
+      * \return the clouds named after their files, empty if a file could not be read
+      */
+    inline std::vector<NamedCloud>
+    loadClouds (int argc, char** argv)
+    {
+      std::vector<NamedCloud> clouds;
+      for (int i = 1; i < argc; ++i)
+      {
+        PointCloud<PointXYZ>::Ptr cloud (new PointCloud<PointXYZ>);
+        if (io::loadPCDFile (argv[i], *cloud) < 0)
+        {
+          std::cerr << "Failed to read test file " << argv[i] << std::endl;
+          return {};
+        }
+        std::string name (argv[i]);
+        name = name.substr (name.find_last_of ("/\\") + 1);
+        name = name.substr (0, name.find_last_of ('.'));
+        clouds.push_back ({name, cloud});
+      }
+      return (clouds);
+    }
+
+    /** \brief Generate a smooth, slightly noisy surface over the unit square, the same for each size. */
+    inline PointCloud<PointXYZ>::Ptr
+    generateSurface (std::size_t nr_points)
+    {
+      PointCloud<PointXYZ>::Ptr cloud (new PointCloud<PointXYZ>);
+      std::mt19937 rng (42);
+      std::uniform_real_distribution<float> uniform (0.f, 1.f);
+      std::normal_distribution<float> noise (0.f, 0.001f);
+      cloud->resize (nr_points);
+      for (auto &point : *cloud)
+      {
+        point.x = uniform (rng);
+        point.y = uniform (rng);
+        point.z = 0.1f * std::sin (6.f * point.x) * std::cos (6.f * point.y) + noise (rng);
+      }
+      return (cloud);
+    }
+
+    /** \brief The clouds from the command line followed by the synthetic surfaces. */
+    inline std::vector<NamedCloud>
+    getInputs (const std::vector<NamedCloud> &clouds)
+    {
+      std::vector<NamedCloud> inputs = clouds;
+      for (const std::size_t size : synthetic_sizes)
+        inputs.push_back ({"surface_" + std::to_string (size), generateSurface (size)});
+      return (inputs);
+    }
+
+    /** \brief Copy the finite points of a cloud, as most algorithms expect dense inputs. */
+    inline PointCloud<PointXYZ>::Ptr
+    removeNaN (const PointCloud<PointXYZ> &cloud)
+    {
+      PointCloud<PointXYZ>::Ptr dense (new PointCloud<PointXYZ>);
+      dense->reserve (cloud.size ());
+      for (const auto &point : cloud)
+        if (std::isfinite (point.x) && std::isfinite (point.y) && std::isfinite (point.z))
+          dense->push_back (point);
+      return (dense);
+    }
+
+    /** \brief An estimate of the distance between neighboring points, assuming the points sample a surface.
+      *
+      * The benchmarks scale their radii and resolutions with it, so that the neighborhoods have a similar number
+      * of points on all the inputs.
+      */
+    inline float
+    getPointSpacing (const PointCloud<PointXYZ> &cloud)
+    {
+      Eigen::Vector4f min_pt, max_pt;
+      getMinMax3D (cloud, min_pt, max_pt);
+      const Eigen::Vector3f extent = (max_pt - min_pt).head<3> ();
+      // Area of the two largest sides of the bounding box
+      float sides[3] = {extent[0], extent[1], extent[2]};
+      std::sort (sides, sides + 3);
+      const float area = sides[1] * sides[2];
+      return (std::sqrt (area / static_cast<float> (std::max<std::size_t> (cloud.size (), 1))));
+    }
+
+    /** \brief Evenly spaced indices of a cloud, e.g. to query a fixed number of points on all the inputs. */
+    inline Indices
+    getQueryIndices (const PointCloud<PointXYZ> &cloud, std::size_t nr_queries)
+    {
+      Indices indices;
+      const std::size_t step = std::max<std::size_t> (cloud.size () / nr_queries, 1);
+      for (std::size_t i = 0; i < cloud.size () && indices.size () < nr_queries; i += step)
+        if (std::isfinite (cloud[i].x))
+          indices.push_back (static_cast<index_t> (i));
+      return (indices);
+    }
+  } // namespace benchmarks
+} // namespace pcl
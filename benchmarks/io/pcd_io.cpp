@@ -0,0 +1,122 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2024-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <pcl/benchmarks/clouds.h>
+#include <pcl/io/pcd_io.h>
+
+#include <benchmark/benchmark.h>
+
+#include <cstdio>
+
+namespace
+{
+  const char *file_name = "benchmark_pcd_io.pcd";
+
+  std::size_t
+  getFileSize (const char *path)
+  {
+    FILE *file = std::fopen (path, "rb");
+    if (!file)
+      return (0);
+    std::fseek (file, 0, SEEK_END);
+    const long size = std::ftell (file);
+    std::fclose (file);
+    return (size < 0 ? 0 : static_cast<std::size_t> (size));
+  }
+
+  void
+  write (pcl::PCDWriter &writer, const pcl::PointCloud<pcl::PointXYZ> &cloud, int format)
+  {
+    switch (format)
+    {
+      case 0: writer.writeASCII (file_name, cloud); break;
+      case 1: writer.writeBinary (file_name, cloud); break;
+      default: writer.writeBinaryCompressed (file_name, cloud); break;
+    }
+  }
+
+  void
+  BM_PCDWrite (benchmark::State &state, const pcl::PointCloud<pcl::PointXYZ>::ConstPtr &cloud)
+  {
+    const int format = static_cast<int> (state.range (0));
+    pcl::PCDWriter writer;
+    for (auto _ : state)
+      write (writer, *cloud, format);
+    state.SetItemsProcessed (state.iterations () * cloud->size ());
+    state.SetBytesProcessed (state.iterations () * getFileSize (file_name));
+  }
+
+  void
+  BM_PCDRead (benchmark::State &state, const pcl::PointCloud<pcl::PointXYZ>::ConstPtr &cloud)
+  {
+    const int format = static_cast<int> (state.range (0));
+    pcl::PCDWriter writer;
+    write (writer, *cloud, format);
+    const std::size_t file_size = getFileSize (file_name);
+
+    pcl::PCDReader reader;
+    pcl::PointCloud<pcl::PointXYZ> read_cloud;
+    for (auto _ : state)
+    {
+      reader.read (file_name, read_cloud);
+      benchmark::DoNotOptimize (read_cloud.data ());
+    }
+    state.SetItemsProcessed (state.iterations () * cloud->size ());
+    state.SetBytesProcessed (state.iterations () * file_size);
+  }
+}
+
+int
+main (int argc, char** argv)
+{
+  benchmark::Initialize (&argc, argv);
+  const auto clouds = pcl::benchmarks::loadClouds (argc, argv);
+  if (clouds.size () != static_cast<std::size_t> (argc - 1))
+    return (-1);
+
+  // Argument: 0 for ASCII, 1 for binary, 2 for compressed binary
+  for (const auto &input : pcl::benchmarks::getInputs (clouds))
+  {
+    benchmark::RegisterBenchmark (("BM_PCDWrite/" + input.name).c_str (), &BM_PCDWrite, input.cloud)
+      ->DenseRange (0, 2)->Unit (benchmark::kMillisecond)->UseRealTime ();
+    benchmark::RegisterBenchmark (("BM_PCDRead/" + input.name).c_str (), &BM_PCDRead, input.cloud)
+      ->DenseRange (0, 2)->Unit (benchmark::kMillisecond)->UseRealTime ();
+  }
+  benchmark::RunSpecifiedBenchmarks ();
+  std::remove (file_name);
+  return (0);
+}
@@ -0,0 +1,159 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2024-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <pcl/benchmarks/clouds.h>
+#include <pcl/common/centroid.h>
+#include <pcl/common/transforms.h>
+#include <pcl/filters/voxel_grid.h>
+#include <pcl/registration/gicp.h>
+#include <pcl/registration/icp.h>
+#include <pcl/registration/ndt.h>
+
+#include <benchmark/benchmark.h>
+
+namespace
+{
+  using Cloud = pcl::PointCloud<pcl::PointXYZ>;
+
+  struct RegistrationInput
+  {
+    Cloud::ConstPtr source;
+    Cloud::ConstPtr target;
+    float spacing;
+  };
+
+  /** \brief Downsample a cloud to about the given number of points, and misalign a copy of it. */
+  RegistrationInput
+  makeInput (const Cloud &cloud, std::size_t nr_points)
+  {
+    const Cloud::Ptr dense = pcl::benchmarks::removeNaN (cloud);
+    const float spacing = pcl::benchmarks::getPointSpacing (*dense);
+    const float leaf_size = spacing * std::sqrt (std::max (1.f, static_cast<float> (dense->size ()) / static_cast<float> (nr_points)));
+
+    pcl::VoxelGrid<pcl::PointXYZ> voxel_grid;
+    voxel_grid.setInputCloud (dense);
+    voxel_grid.setLeafSize (leaf_size, leaf_size, leaf_size);
+    Cloud::Ptr target (new Cloud);
+    voxel_grid.filter (*target);
+
+    Eigen::Vector4f centroid;
+    pcl::compute3DCentroid (*target, centroid);
+    const Eigen::Affine3f misalignment = Eigen::Translation3f (centroid.head<3> () + Eigen::Vector3f::Constant (2.f * leaf_size))
+                                       * Eigen::AngleAxisf (static_cast<float> (5.0 * M_PI / 180.0), Eigen::Vector3f::UnitZ ())
+                                       * Eigen::Translation3f (-centroid.head<3> ());
+    Cloud::Ptr source (new Cloud);
+    pcl::transformPointCloud (*target, *source, misalignment);
+
+    RegistrationInput input;
+    input.source = source;
+    input.target = target;
+    input.spacing = pcl::benchmarks::getPointSpacing (*target);
+    return (input);
+  }
+
+  template <typename RegistrationT> void
+  runRegistration (benchmark::State &state, RegistrationT &registration, const RegistrationInput &input)
+  {
+    registration.setInputSource (input.source);
+    registration.setInputTarget (input.target);
+    registration.setMaximumIterations (30);
+    registration.setTransformationEpsilon (1e-8);
+
+    Cloud output;
+    for (auto _ : state)
+    {
+      registration.align (output);
+      benchmark::DoNotOptimize (output.data ());
+    }
+    state.SetItemsProcessed (state.iterations () * input.source->size ());
+    state.counters["points"] = static_cast<double> (input.source->size ());
+    state.counters["converged"] = registration.hasConverged () ? 1. : 0.;
+    state.counters["fitness"] = registration.getFitnessScore ();
+  }
+
+  void
+  BM_ICP (benchmark::State &state, const RegistrationInput &input)
+  {
+    pcl::IterativeClosestPoint<pcl::PointXYZ, pcl::PointXYZ> icp;
+    icp.setMaxCorrespondenceDistance (10.0 * input.spacing);
+    runRegistration (state, icp, input);
+  }
+
+  void
+  BM_GICP (benchmark::State &state, const RegistrationInput &input)
+  {
+    pcl::GeneralizedIterativeClosestPoint<pcl::PointXYZ, pcl::PointXYZ> gicp;
+    gicp.setMaxCorrespondenceDistance (10.0 * input.spacing);
+    runRegistration (state, gicp, input);
+  }
+
+  void
+  BM_NDT (benchmark::State &state, const RegistrationInput &input)
+  {
+    pcl::NormalDistributionsTransform<pcl::PointXYZ, pcl::PointXYZ> ndt;
+    ndt.setResolution (static_cast<float> (5.0 * input.spacing));
+    ndt.setStepSize (input.spacing);
+    runRegistration (state, ndt, input);
+  }
+}
+
+int
+main (int argc, char** argv)
+{
+  benchmark::Initialize (&argc, argv);
+  const auto clouds = pcl::benchmarks::loadClouds (argc, argv);
+  if (clouds.size () != static_cast<std::size_t> (argc - 1))
+    return (-1);
+
+  // The inputs are downsampled to these sizes, the registrations scale with the number of points
+  for (const auto &named_cloud : pcl::benchmarks::getInputs (clouds))
+    for (const std::size_t nr_points : {5000, 20000})
+    {
+      if (named_cloud.cloud->size () < nr_points)
+        continue;
+      const std::string name = named_cloud.name + "/" + std::to_string (nr_points);
+      const RegistrationInput input = makeInput (*named_cloud.cloud, nr_points);
+      benchmark::RegisterBenchmark (("BM_ICP/" + name).c_str (), &BM_ICP, input)
+        ->Unit (benchmark::kMillisecond)->UseRealTime ();
+      benchmark::RegisterBenchmark (("BM_GICP/" + name).c_str (), &BM_GICP, input)
+        ->Unit (benchmark::kMillisecond)->UseRealTime ();
+      benchmark::RegisterBenchmark (("BM_NDT/" + name).c_str (), &BM_NDT, input)
+        ->Unit (benchmark::kMillisecond)->UseRealTime ();
+    }
+  benchmark::RunSpecifiedBenchmarks ();
+  return (0);
+}
@@ -0,0 +1,149 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2024-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <pcl/benchmarks/clouds.h>
+#include <pcl/sample_consensus/ransac.h>
+#include <pcl/sample_consensus/sac_model_line.h>
+#include <pcl/sample_consensus/sac_model_plane.h>
+#include <pcl/sample_consensus/sac_model_sphere.h>
+
+#include <benchmark/benchmark.h>
+
+namespace
+{
+  /** \brief Points of a model with 1% noise, among the given ratio of uniform outliers in the unit cube. */
+  template <typename Generator> pcl::PointCloud<pcl::PointXYZ>::Ptr
+  generateModel (std::size_t nr_points, float outlier_ratio, Generator generator)
+  {
+    pcl::PointCloud<pcl::PointXYZ>::Ptr cloud (new pcl::PointCloud<pcl::PointXYZ>);
+    std::mt19937 rng (42);
+    std::uniform_real_distribution<float> uniform (0.f, 1.f);
+    std::normal_distribution<float> noise (0.f, 0.01f);
+    cloud->resize (nr_points);
+    for (auto &point : *cloud)
+    {
+      if (uniform (rng) < outlier_ratio)
+        point.getVector3fMap () = Eigen::Vector3f (uniform (rng), uniform (rng), uniform (rng));
+      else
+        point.getVector3fMap () = generator (rng, uniform) + Eigen::Vector3f (noise (rng), noise (rng), noise (rng));
+    }
+    return (cloud);
+  }
+
+  pcl::PointCloud<pcl::PointXYZ>::Ptr
+  generatePlane (std::size_t nr_points)
+  {
+    return (generateModel (nr_points, 0.5f, [] (std::mt19937 &rng, std::uniform_real_distribution<float> &uniform)
+    {
+      return (Eigen::Vector3f (uniform (rng), uniform (rng), 0.5f));
+    }));
+  }
+
+  pcl::PointCloud<pcl::PointXYZ>::Ptr
+  generateSphere (std::size_t nr_points)
+  {
+    return (generateModel (nr_points, 0.5f, [] (std::mt19937 &rng, std::uniform_real_distribution<float> &uniform)
+    {
+      const float theta = 2.f * static_cast<float> (M_PI) * uniform (rng);
+      const float z = 2.f * uniform (rng) - 1.f;
+      const float r = std::sqrt (1.f - z * z);
+      return (Eigen::Vector3f (0.5f, 0.5f, 0.5f) + 0.3f * Eigen::Vector3f (r * std::cos (theta), r * std::sin (theta), z));
+    }));
+  }
+
+  pcl::PointCloud<pcl::PointXYZ>::Ptr
+  generateLine (std::size_t nr_points)
+  {
+    return (generateModel (nr_points, 0.5f, [] (std::mt19937 &rng, std::uniform_real_distribution<float> &uniform)
+    {
+      const float t = uniform (rng);
+      return (Eigen::Vector3f (t, t, 0.5f));
+    }));
+  }
+
+  template <typename ModelT> void
+  BM_RANSAC (benchmark::State &state, const pcl::PointCloud<pcl::PointXYZ>::ConstPtr &cloud, double threshold)
+  {
+    typename ModelT::Ptr model (new ModelT (cloud));
+    pcl::RandomSampleConsensus<pcl::PointXYZ> ransac (model, threshold);
+    ransac.setMaxIterations (1000);
+    ransac.setNumberOfThreads (static_cast<int> (state.range (0)));
+
+    pcl::Indices inliers;
+    for (auto _ : state)
+    {
+      ransac.computeModel ();
+      ransac.getInliers (inliers);
+    }
+    state.SetItemsProcessed (state.iterations () * cloud->size ());
+    state.counters["inliers"] = static_cast<double> (inliers.size ());
+  }
+}
+
+int
+main (int argc, char** argv)
+{
+  benchmark::Initialize (&argc, argv);
+  const auto clouds = pcl::benchmarks::loadClouds (argc, argv);
+  if (clouds.size () != static_cast<std::size_t> (argc - 1))
+    return (-1);
+
+  // Argument: number of threads, -1 for the serial implementation
+  const std::vector<std::int64_t> threads = {-1, 4};
+  for (const auto &input : clouds)
+  {
+    const auto cloud = pcl::benchmarks::removeNaN (*input.cloud);
+    benchmark::RegisterBenchmark (("BM_RANSAC_Plane/" + input.name).c_str (), &BM_RANSAC<pcl::SampleConsensusModelPlane<pcl::PointXYZ>>,
+                                  cloud, 2.0 * pcl::benchmarks::getPointSpacing (*cloud))
+      ->ArgsProduct ({threads})->Unit (benchmark::kMillisecond)->UseRealTime ();
+  }
+  for (const std::size_t size : pcl::benchmarks::synthetic_sizes)
+  {
+    const std::string suffix = "/synthetic_" + std::to_string (size);
+    benchmark::RegisterBenchmark (("BM_RANSAC_Plane" + suffix).c_str (), &BM_RANSAC<pcl::SampleConsensusModelPlane<pcl::PointXYZ>>,
+                                  generatePlane (size), 0.03)
+      ->ArgsProduct ({threads})->Unit (benchmark::kMillisecond)->UseRealTime ();
+    benchmark::RegisterBenchmark (("BM_RANSAC_Sphere" + suffix).c_str (), &BM_RANSAC<pcl::SampleConsensusModelSphere<pcl::PointXYZ>>,
+                                  generateSphere (size), 0.03)
+      ->ArgsProduct ({threads})->Unit (benchmark::kMillisecond)->UseRealTime ();
+    benchmark::RegisterBenchmark (("BM_RANSAC_Line" + suffix).c_str (), &BM_RANSAC<pcl::SampleConsensusModelLine<pcl::PointXYZ>>,
+                                  generateLine (size), 0.03)
+      ->ArgsProduct ({threads})->Unit (benchmark::kMillisecond)->UseRealTime ();
+  }
+  benchmark::RunSpecifiedBenchmarks ();
+  return (0);
+}
@@ -0,0 +1,154 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2024-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <pcl/benchmarks/clouds.h>
+#include <pcl/search/kdtree.h>
+#include <pcl/search/octree.h>
+#include <pcl/search/organized.h>
+
+#include <benchmark/benchmark.h>
+
+#include <functional>
+
+namespace
+{
+  using SearchPtr = pcl::search::Search<pcl::PointXYZ>::Ptr;
+  using SearchFactory = std::function<SearchPtr (float spacing)>;
+
+  const std::size_t nr_queries = 1000;
+
+  void
+  BM_Build (benchmark::State &state, const pcl::PointCloud<pcl::PointXYZ>::ConstPtr &cloud, const SearchFactory &factory)
+  {
+    const float spacing = pcl::benchmarks::getPointSpacing (*cloud);
+    for (auto _ : state)
+    {
+      SearchPtr search = factory (spacing);
+      search->setInputCloud (cloud);
+      benchmark::ClobberMemory ();
+    }
+    state.SetItemsProcessed (state.iterations () * cloud->size ());
+  }
+
+  void
+  BM_KnnSearch (benchmark::State &state, const pcl::PointCloud<pcl::PointXYZ>::ConstPtr &cloud, const SearchFactory &factory)
+  {
+    const int k = static_cast<int> (state.range (0));
+    SearchPtr search = factory (pcl::benchmarks::getPointSpacing (*cloud));
+    search->setInputCloud (cloud);
+    const pcl::Indices queries = pcl::benchmarks::getQueryIndices (*cloud, nr_queries);
+
+    pcl::Indices k_indices;
+    std::vector<float> k_sqr_distances;
+    for (auto _ : state)
+      for (const auto &query : queries)
+      {
+        search->nearestKSearch ((*cloud)[query], k, k_indices, k_sqr_distances);
+        benchmark::DoNotOptimize (k_indices.data ());
+      }
+    state.SetItemsProcessed (state.iterations () * queries.size ());
+  }
+
+  void
+  BM_RadiusSearch (benchmark::State &state, const pcl::PointCloud<pcl::PointXYZ>::ConstPtr &cloud, const SearchFactory &factory)
+  {
+    // Radius in multiples of the point spacing
+    const float spacing = pcl::benchmarks::getPointSpacing (*cloud);
+    const double radius = static_cast<double> (state.range (0)) * spacing;
+    SearchPtr search = factory (spacing);
+    search->setInputCloud (cloud);
+    const pcl::Indices queries = pcl::benchmarks::getQueryIndices (*cloud, nr_queries);
+
+    pcl::Indices k_indices;
+    std::vector<float> k_sqr_distances;
+    std::size_t nr_neighbors = 0;
+    for (auto _ : state)
+      for (const auto &query : queries)
+      {
+        nr_neighbors += search->radiusSearch ((*cloud)[query], radius, k_indices, k_sqr_distances);
+        benchmark::DoNotOptimize (k_indices.data ());
+      }
+    state.SetItemsProcessed (state.iterations () * queries.size ());
+    state.counters["neighbors"] = benchmark::Counter (static_cast<double> (nr_neighbors), benchmark::Counter::kAvgIterations);
+  }
+
+  void
+  registerBenchmarks (const std::string &name, const pcl::PointCloud<pcl::PointXYZ>::ConstPtr &cloud, const SearchFactory &factory)
+  {
+    benchmark::RegisterBenchmark (("BM_Build/" + name).c_str (), &BM_Build, cloud, factory)
+      ->Unit (benchmark::kMillisecond)->UseRealTime ();
+    benchmark::RegisterBenchmark (("BM_KnnSearch/" + name).c_str (), &BM_KnnSearch, cloud, factory)
+      ->Arg (1)->Arg (10)->Arg (50)->Unit (benchmark::kMillisecond)->UseRealTime ();
+    benchmark::RegisterBenchmark (("BM_RadiusSearch/" + name).c_str (), &BM_RadiusSearch, cloud, factory)
+      ->Arg (2)->Arg (5)->Unit (benchmark::kMillisecond)->UseRealTime ();
+  }
+}
+
+int
+main (int argc, char** argv)
+{
+  benchmark::Initialize (&argc, argv);
+  const auto clouds = pcl::benchmarks::loadClouds (argc, argv);
+  if (clouds.size () != static_cast<std::size_t> (argc - 1))
+    return (-1);
+
+  const SearchFactory kdtree = [] (float) -> SearchPtr
+  {
+    return (SearchPtr (new pcl::search::KdTree<pcl::PointXYZ>));
+  };
+  // Leaves of about ten points
+  const SearchFactory octree = [] (float spacing) -> SearchPtr
+  {
+    return (SearchPtr (new pcl::search::Octree<pcl::PointXYZ> (3.0 * spacing)));
+  };
+  const SearchFactory organized = [] (float) -> SearchPtr
+  {
+    return (SearchPtr (new pcl::search::OrganizedNeighbor<pcl::PointXYZ>));
+  };
+
+  for (const auto &input : pcl::benchmarks::getInputs (clouds))
+  {
+    const auto cloud = pcl::benchmarks::removeNaN (*input.cloud);
+    registerBenchmarks ("KdTree/" + input.name, cloud, kdtree);
+    registerBenchmarks ("Octree/" + input.name, cloud, octree);
+    // The organized search needs the original, projectable cloud
+    if (input.cloud->isOrganized ())
+      registerBenchmarks ("OrganizedNeighbor/" + input.name, input.cloud, organized);
+  }
+  benchmark::RunSpecifiedBenchmarks ();
+  return (0);
+}
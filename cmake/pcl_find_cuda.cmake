@@ -50,4 +50,13 @@ if(CUDA_FOUND)
   
   # Allow calling a constexpr __host__ function from a __device__ function.
   list(APPEND CUDA_NVCC_FLAGS "--expt-relaxed-constexpr")
+
+  # Kernels launched without a stream from different host threads (e.g. one pipeline per sensor) run concurrently
+  # instead of serializing on the legacy default stream.
+  option(PCL_CUDA_PER_THREAD_DEFAULT_STREAM "Use a separate default Cuda stream per host thread" OFF)
+  mark_as_advanced(PCL_CUDA_PER_THREAD_DEFAULT_STREAM)
+  if(PCL_CUDA_PER_THREAD_DEFAULT_STREAM)
+    list(APPEND CUDA_NVCC_FLAGS "--default-stream=per-thread")
+    add_definitions(-DCUDA_API_PER_THREAD_DEFAULT_STREAM)
+  endif()
 endif()
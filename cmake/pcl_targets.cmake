@@ -410,6 +410,40 @@ macro(PCL_ADD_TEST _name _exename)
   add_dependencies(tests ${_exename})
 endmacro()
 
+###############################################################################
+# Add a benchmark target.
+# _name The benchmark name, the executable is named benchmark_<_name>.
+# ARGN :
+#    FILES the source files for the benchmark
+#    ARGUMENTS Arguments for benchmark executable
+#    LINK_WITH link benchmark executable with libraries
+macro(PCL_ADD_BENCHMARK _name)
+  set(options)
+  set(oneValueArgs)
+  set(multiValueArgs FILES ARGUMENTS LINK_WITH)
+  cmake_parse_arguments(PCL_ADD_BENCHMARK "${options}" "${oneValueArgs}" "${multiValueArgs}" ${ARGN})
+  add_executable(benchmark_${_name} ${PCL_ADD_BENCHMARK_FILES})
+  if(NOT WIN32)
+    set_target_properties(benchmark_${_name} PROPERTIES RUNTIME_OUTPUT_DIRECTORY ${CMAKE_CURRENT_BINARY_DIR})
+  endif()
+  target_link_libraries(benchmark_${_name} benchmark::benchmark ${PCL_ADD_BENCHMARK_LINK_WITH})
+  target_link_libraries(benchmark_${_name} Threads::Threads)
+
+  #Only applies to MSVC
+  if(MSVC)
+    #Only add if there are arguments to the benchmark
+    if(PCL_ADD_BENCHMARK_ARGUMENTS AND NOT CMAKE_VERSION VERSION_LESS "3.13.0")
+      string (REPLACE ";" " " PCL_ADD_BENCHMARK_ARGUMENTS_STR "${PCL_ADD_BENCHMARK_ARGUMENTS}")
+      set_target_properties(benchmark_${_name} PROPERTIES VS_DEBUGGER_COMMAND_ARGUMENTS ${PCL_ADD_BENCHMARK_ARGUMENTS_STR})
+    endif()
+  endif()
+
+  set_target_properties(benchmark_${_name} PROPERTIES FOLDER "Benchmarks")
+  add_custom_target(run_benchmark_${_name} benchmark_${_name} ${PCL_ADD_BENCHMARK_ARGUMENTS})
+  set_target_properties(run_benchmark_${_name} PROPERTIES FOLDER "Benchmarks")
+  add_dependencies(run_benchmarks run_benchmark_${_name})
+endmacro()
+
 ###############################################################################
 # Add an example target.
 # _name The example name.
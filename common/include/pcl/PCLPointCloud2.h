@@ -84,6 +84,20 @@ namespace pcl
     {
       return (PCLPointCloud2 (*this) += rhs);
     }
+
+    /** \brief Get the memory used by the point cloud, i.e. the size of the object
+      * plus the allocated capacity of the data buffer and the field descriptions.
+      * \return memory in bytes
+      */
+    inline std::size_t
+    getMemoryUsage () const
+    {
+      std::size_t memory = sizeof (*this) + data.capacity () + header.frame_id.capacity () +
+                           fields.capacity () * sizeof (::pcl::PCLPointField);
+      for (const auto &field : fields)
+        memory += field.name.capacity ();
+      return (memory);
+    }
   }; // struct PCLPointCloud2
 
   using PCLPointCloud2Ptr = PCLPointCloud2::Ptr;
@@ -0,0 +1,176 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+#include <pcl/PCLHeader.h>
+#include <pcl/PCLPointCloud2.h>
+#include <pcl/PolygonMesh.h>
+
+namespace pcl
+{
+  /** \brief A triangle mesh with all the faces stored in a single flat buffer.
+    *
+    * Unlike pcl::PolygonMesh, which keeps one pcl::Vertices (and thus one heap
+    * allocation) per face, the faces of a TriangleMesh are stored as three
+    * consecutive vertex indices per triangle in \a triangles. The vertex
+    * attributes are kept in \a cloud, exactly as in a pcl::PolygonMesh, so a mesh
+    * can be converted from and to a pcl::PolygonMesh without copying them.
+    */
+  struct TriangleMesh
+  {
+    ::pcl::PCLHeader header;
+
+    ::pcl::PCLPointCloud2 cloud;
+
+    /** \brief The vertex indices of the triangles, three consecutive entries per triangle. */
+    std::vector<std::uint32_t> triangles;
+
+    /** \brief Get the number of triangles. */
+    inline std::size_t
+    size () const { return (triangles.size () / 3); }
+
+    /** \brief Check whether the mesh has no triangles. */
+    inline bool
+    empty () const { return (triangles.empty ()); }
+
+    /** \brief Get the three vertex indices of a triangle.
+      * \param[in] i the index of the triangle
+      */
+    inline const std::uint32_t*
+    getTriangle (std::size_t i) const { return (&triangles[3 * i]); }
+
+    /** \brief Append a triangle to the mesh.
+      * \param[in] a index of the first vertex
+      * \param[in] b index of the second vertex
+      * \param[in] c index of the third vertex
+      */
+    inline void
+    addTriangle (std::uint32_t a, std::uint32_t b, std::uint32_t c)
+    {
+      triangles.push_back (a);
+      triangles.push_back (b);
+      triangles.push_back (c);
+    }
+
+  public:
+    using Ptr = shared_ptr< ::pcl::TriangleMesh>;
+    using ConstPtr = shared_ptr<const ::pcl::TriangleMesh>;
+  }; // struct TriangleMesh
+
+  using TriangleMeshPtr = TriangleMesh::Ptr;
+  using TriangleMeshConstPtr = TriangleMesh::ConstPtr;
+
+  /** \brief Append the triangles of a set of polygons to a flat triangle buffer.
+    * Polygons with more than three vertices are split into a fan around their first
+    * vertex, polygons with less than three vertices are skipped.
+    * \param[in] polygons the input polygons
+    * \param[out] triangles the resultant vertex indices, three per triangle
+    */
+  inline void
+  polygonsToTriangles (const std::vector< ::pcl::Vertices> &polygons, std::vector<std::uint32_t> &triangles)
+  {
+    std::size_t nr_triangles = 0;
+    for (const auto &polygon : polygons)
+      if (polygon.vertices.size () >= 3)
+        nr_triangles += polygon.vertices.size () - 2;
+    triangles.clear ();
+    triangles.reserve (3 * nr_triangles);
+    for (const auto &polygon : polygons)
+      for (std::size_t j = 2; j < polygon.vertices.size (); ++j)
+      {
+        triangles.push_back (polygon.vertices[0]);
+        triangles.push_back (polygon.vertices[j - 1]);
+        triangles.push_back (polygon.vertices[j]);
+      }
+  }
+
+  /** \brief Create one pcl::Vertices per triangle of a flat triangle buffer.
+    * \param[in] triangles the vertex indices, three per triangle
+    * \param[out] polygons the resultant polygons
+    */
+  inline void
+  trianglesToPolygons (const std::vector<std::uint32_t> &triangles, std::vector< ::pcl::Vertices> &polygons)
+  {
+    polygons.resize (triangles.size () / 3);
+    for (std::size_t i = 0; i < polygons.size (); ++i)
+      polygons[i].vertices.assign (triangles.begin () + 3 * i, triangles.begin () + 3 * i + 3);
+  }
+
+  /** \brief Convert a pcl::PolygonMesh into a pcl::TriangleMesh, copying the vertex data.
+    * \param[in] mesh the input polygonal mesh
+    * \param[out] triangle_mesh the resultant triangle mesh
+    */
+  inline void
+  toTriangleMesh (const ::pcl::PolygonMesh &mesh, ::pcl::TriangleMesh &triangle_mesh)
+  {
+    triangle_mesh.header = mesh.header;
+    triangle_mesh.cloud = mesh.cloud;
+    polygonsToTriangles (mesh.polygons, triangle_mesh.triangles);
+  }
+
+  /** \brief Convert a pcl::PolygonMesh into a pcl::TriangleMesh, moving the vertex data.
+    * \param[in] mesh the input polygonal mesh, its cloud is left empty
+    * \param[out] triangle_mesh the resultant triangle mesh
+    */
+  inline void
+  toTriangleMesh (::pcl::PolygonMesh &&mesh, ::pcl::TriangleMesh &triangle_mesh)
+  {
+    triangle_mesh.header = std::move (mesh.header);
+    triangle_mesh.cloud = std::move (mesh.cloud);
+    polygonsToTriangles (mesh.polygons, triangle_mesh.triangles);
+    mesh.polygons.clear ();
+  }
+
+  /** \brief Convert a pcl::TriangleMesh into a pcl::PolygonMesh, copying the vertex data.
+    * \param[in] triangle_mesh the input triangle mesh
+    * \param[out] mesh the resultant polygonal mesh
+    */
+  inline void
+  toPolygonMesh (const ::pcl::TriangleMesh &triangle_mesh, ::pcl::PolygonMesh &mesh)
+  {
+    mesh.header = triangle_mesh.header;
+    mesh.cloud = triangle_mesh.cloud;
+    trianglesToPolygons (triangle_mesh.triangles, mesh.polygons);
+  }
+
+  /** \brief Convert a pcl::TriangleMesh into a pcl::PolygonMesh, moving the vertex data.
+    * \param[in] triangle_mesh the input triangle mesh, its cloud and triangles are left empty
+    * \param[out] mesh the resultant polygonal mesh
+    */
+  inline void
+  toPolygonMesh (::pcl::TriangleMesh &&triangle_mesh, ::pcl::PolygonMesh &mesh)
+  {
+    mesh.header = std::move (triangle_mesh.header);
+    mesh.cloud = std::move (triangle_mesh.cloud);
+    trianglesToPolygons (triangle_mesh.triangles, mesh.polygons);
+    triangle_mesh.triangles.clear ();
+  }
+
+  inline std::ostream& operator<<(std::ostream& s, const  ::pcl::TriangleMesh &v)
+  {
+    s << "header: " << std::endl;
+    s << v.header;
+    s << "cloud: " << std::endl;
+    s << v.cloud;
+    s << "triangles[]" << std::endl;
+    for (std::size_t i = 0; i < v.size (); ++i)
+    {
+      const std::uint32_t *t = v.getTriangle (i);
+      s << "  triangles[" << i << "]: " << t[0] << " " << t[1] << " " << t[2] << std::endl;
+    }
+    return (s);
+  }
+
+} // namespace pcl
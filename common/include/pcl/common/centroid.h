@@ -494,6 +494,119 @@ namespace pcl
     return (computeMeanAndCovarianceMatrix<PointT, double> (cloud, indices, covariance_matrix, centroid));
   }
 
+  /** \brief Compute the 3D (X-Y-Z) centroid of a set of points with several threads.
+    * \details The points are summed by blocks of consecutive points and the sums of the blocks are added
+    * in order, so the result does not depend on the number of threads. The points are summed relative to
+    * the first valid point, which keeps the precision for clouds far from the origin.
+    * \param[in] cloud the input point cloud
+    * \param[out] centroid the output centroid
+    * \param[in] nr_threads the number of threads (0 uses all the cores)
+    * \param[in] compensated use a compensated (Kahan) summation, for large clouds summed in single precision
+    * \return number of valid points used to determine the centroid
+    * \note if return value is 0, the centroid is not changed, thus not valid.
+    * \ingroup common
+    */
+  template <typename PointT, typename Scalar> inline unsigned int
+  compute3DCentroid (const pcl::PointCloud<PointT> &cloud,
+                     Eigen::Matrix<Scalar, 4, 1> &centroid,
+                     unsigned int nr_threads,
+                     bool compensated = false);
+
+  /** \brief Compute the 3D (X-Y-Z) centroid of a set of points using their indices with several threads.
+    * \details See compute3DCentroid (cloud, centroid, nr_threads, compensated).
+    * \param[in] cloud the input point cloud
+    * \param[in] indices the point cloud indices that need to be used
+    * \param[out] centroid the output centroid
+    * \param[in] nr_threads the number of threads (0 uses all the cores)
+    * \param[in] compensated use a compensated (Kahan) summation, for large clouds summed in single precision
+    * \return number of valid points used to determine the centroid
+    * \ingroup common
+    */
+  template <typename PointT, typename Scalar> inline unsigned int
+  compute3DCentroid (const pcl::PointCloud<PointT> &cloud,
+                     const Indices &indices,
+                     Eigen::Matrix<Scalar, 4, 1> &centroid,
+                     unsigned int nr_threads,
+                     bool compensated = false);
+
+  /** \brief Compute the (not normalized) 3x3 covariance matrix of a given set of points with several threads.
+    * \details The products are summed by blocks of consecutive points and the sums of the blocks are added
+    * in order, so the result does not depend on the number of threads.
+    * \param[in] cloud the input point cloud
+    * \param[in] centroid the centroid of the set of points in the cloud
+    * \param[out] covariance_matrix the resultant 3x3 covariance matrix
+    * \param[in] nr_threads the number of threads (0 uses all the cores)
+    * \param[in] compensated use a compensated (Kahan) summation, for large clouds summed in single precision
+    * \return number of valid points used to determine the covariance matrix
+    * \ingroup common
+    */
+  template <typename PointT, typename Scalar> inline unsigned int
+  computeCovarianceMatrix (const pcl::PointCloud<PointT> &cloud,
+                           const Eigen::Matrix<Scalar, 4, 1> &centroid,
+                           Eigen::Matrix<Scalar, 3, 3> &covariance_matrix,
+                           unsigned int nr_threads,
+                           bool compensated = false);
+
+  /** \brief Compute the (not normalized) 3x3 covariance matrix of a given set of points using their indices
+    * with several threads.
+    * \details See computeCovarianceMatrix (cloud, centroid, covariance_matrix, nr_threads, compensated).
+    * \param[in] cloud the input point cloud
+    * \param[in] indices the point cloud indices that need to be used
+    * \param[in] centroid the centroid of the set of points in the cloud
+    * \param[out] covariance_matrix the resultant 3x3 covariance matrix
+    * \param[in] nr_threads the number of threads (0 uses all the cores)
+    * \param[in] compensated use a compensated (Kahan) summation, for large clouds summed in single precision
+    * \return number of valid points used to determine the covariance matrix
+    * \ingroup common
+    */
+  template <typename PointT, typename Scalar> inline unsigned int
+  computeCovarianceMatrix (const pcl::PointCloud<PointT> &cloud,
+                           const Indices &indices,
+                           const Eigen::Matrix<Scalar, 4, 1> &centroid,
+                           Eigen::Matrix<Scalar, 3, 3> &covariance_matrix,
+                           unsigned int nr_threads,
+                           bool compensated = false);
+
+  /** \brief Compute the normalized 3x3 covariance matrix and the centroid of a given set of points in a single
+    * pass with several threads.
+    * \details The points are summed relative to the first valid point, by blocks of consecutive points whose
+    * sums are added in order. Unlike the single threaded version, the result therefore keeps its precision for
+    * clouds far from the origin, and it does not depend on the number of threads.
+    * \param[in] cloud the input point cloud
+    * \param[out] covariance_matrix the resultant 3x3 covariance matrix
+    * \param[out] centroid the centroid of the set of points in the cloud
+    * \param[in] nr_threads the number of threads (0 uses all the cores)
+    * \param[in] compensated use a compensated (Kahan) summation, for large clouds summed in single precision
+    * \return number of valid points used to determine the covariance matrix
+    * \ingroup common
+    */
+  template <typename PointT, typename Scalar> inline unsigned int
+  computeMeanAndCovarianceMatrix (const pcl::PointCloud<PointT> &cloud,
+                                  Eigen::Matrix<Scalar, 3, 3> &covariance_matrix,
+                                  Eigen::Matrix<Scalar, 4, 1> &centroid,
+                                  unsigned int nr_threads,
+                                  bool compensated = false);
+
+  /** \brief Compute the normalized 3x3 covariance matrix and the centroid of a given set of points using their
+    * indices in a single pass with several threads.
+    * \details See computeMeanAndCovarianceMatrix (cloud, covariance_matrix, centroid, nr_threads, compensated).
+    * \param[in] cloud the input point cloud
+    * \param[in] indices subset of points given by their indices
+    * \param[out] covariance_matrix the resultant 3x3 covariance matrix
+    * \param[out] centroid the centroid of the set of points in the cloud
+    * \param[in] nr_threads the number of threads (0 uses all the cores)
+    * \param[in] compensated use a compensated (Kahan) summation, for large clouds summed in single precision
+    * \return number of valid points used to determine the covariance matrix
+    * \ingroup common
+    */
+  template <typename PointT, typename Scalar> inline unsigned int
+  computeMeanAndCovarianceMatrix (const pcl::PointCloud<PointT> &cloud,
+                                  const Indices &indices,
+                                  Eigen::Matrix<Scalar, 3, 3> &covariance_matrix,
+                                  Eigen::Matrix<Scalar, 4, 1> &centroid,
+                                  unsigned int nr_threads,
+                                  bool compensated = false);
+
   /** \brief Compute the normalized 3x3 covariance matrix for a already demeaned point cloud.
     * Normalized means that every entry has been divided by the number of entries in the input point cloud.
     * For small number of points, or if you want explicitly the sample-variance, scale the covariance matrix
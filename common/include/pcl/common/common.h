@@ -38,6 +38,7 @@
 #pragma once
 
 #include <pcl/pcl_base.h>
+#include <pcl/point_cloud_soa.h>
 
 /**
   * \file pcl/common/common.h
@@ -150,6 +151,49 @@ namespace pcl
   getMinMax3D (const pcl::PointCloud<PointT> &cloud, const pcl::PointIndices &indices,
                Eigen::Vector4f &min_pt, Eigen::Vector4f &max_pt);
 
+  /** \brief Get the minimum and maximum values on each of the 3 (x-y-z) dimensions in a given pointcloud
+    * with several threads
+    * \param cloud the point cloud data message
+    * \param min_pt the resultant minimum bounds
+    * \param max_pt the resultant maximum bounds
+    * \param nr_threads the number of threads (0 uses all the cores)
+    * \ingroup common
+    */
+  template <typename PointT> inline void
+  getMinMax3D (const pcl::PointCloud<PointT> &cloud,
+               Eigen::Vector4f &min_pt, Eigen::Vector4f &max_pt, unsigned int nr_threads);
+
+  /** \brief Get the minimum and maximum values on each of the 3 (x-y-z) dimensions in a given pointcloud
+    * with several threads
+    * \param cloud the point cloud data message
+    * \param indices the vector of point indices to use from \a cloud
+    * \param min_pt the resultant minimum bounds
+    * \param max_pt the resultant maximum bounds
+    * \param nr_threads the number of threads (0 uses all the cores)
+    * \ingroup common
+    */
+  template <typename PointT> inline void
+  getMinMax3D (const pcl::PointCloud<PointT> &cloud, const Indices &indices,
+               Eigen::Vector4f &min_pt, Eigen::Vector4f &max_pt, unsigned int nr_threads);
+
+  namespace detail
+  {
+    template <typename PointT> void
+    getMinMax3D (const pcl::PointCloud<PointT> &cloud, const index_t *indices, std::size_t nr_points,
+                 Eigen::Vector4f &min_pt, Eigen::Vector4f &max_pt, unsigned int nr_threads);
+  }
+
+  /** \brief Get the minimum and maximum values on each of the 3 (x-y-z) dimensions of coordinates stored
+    * in a structure of arrays
+    * \param cloud the coordinates
+    * \param min_pt the resultant minimum bounds
+    * \param max_pt the resultant maximum bounds
+    * \note The coordinates are assumed to be finite.
+    * \ingroup common
+    */
+  PCL_EXPORTS void
+  getMinMax3D (const pcl::PointCloudSoA &cloud, Eigen::Vector4f &min_pt, Eigen::Vector4f &max_pt);
+
   /** \brief Compute the radius of a circumscribed circle for a triangle formed of three points pa, pb, and pc
     * \param pa the first point
     * \param pb the second point
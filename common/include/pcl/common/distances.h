@@ -39,6 +39,7 @@
 
 #include <limits>
 
+#include <pcl/point_cloud_fwd.h>
 #include <pcl/types.h>
 #include <pcl/point_types.h> // for PointXY
 #include <Eigen/Core> // for VectorXf
@@ -52,8 +53,6 @@
 /*@{*/
 namespace pcl
 {
-  template <typename PointT> class PointCloud;
-
   /** \brief Get the shortest 3D segment between two 3D lines
     * \param line_a the coefficients of the first line (point, direction)
     * \param line_b the coefficients of the second line (point, direction)
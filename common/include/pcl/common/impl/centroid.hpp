@@ -43,15 +43,188 @@
 #include <pcl/common/centroid.h>
 #include <pcl/conversions.h>
 #include <pcl/common/point_tests.h> // for pcl::isFinite
+#include <pcl/common/utils.h> // for pcl::utils::getNumberOfThreads
 
 #include <boost/fusion/algorithm/transformation/filter_if.hpp> // for boost::fusion::filter_if
 #include <boost/fusion/algorithm/iteration/for_each.hpp> // for boost::fusion::for_each
 #include <boost/mpl/size.hpp> // for boost::mpl::size
 
+#include <algorithm>
+#include <vector>
+
 
 namespace pcl
 {
 
+namespace detail
+{
+
+/** Sums of the coordinates of a block of points (relative to a shift) and of their products. */
+template <typename Scalar>
+struct MomentSums
+{
+  using Vector4 = Eigen::Matrix<Scalar, 4, 1>;
+
+  /// Sums of p, p * x, p * y and p * z, and their Kahan compensation terms.
+  Vector4 sum[4];
+  Vector4 compensation[4];
+  std::size_t count;
+
+  MomentSums () : count (0)
+  {
+    for (std::size_t k = 0; k < 4; ++k)
+    {
+      sum[k].setZero ();
+      compensation[k].setZero ();
+    }
+  }
+
+  inline void
+  add (std::size_t k, const Vector4 &value, bool compensated)
+  {
+    if (!compensated)
+    {
+      sum[k] += value;
+      return;
+    }
+    const Vector4 y = value - compensation[k];
+    const Vector4 t = sum[k] + y;
+    compensation[k] = (t - sum[k]) - y;
+    sum[k] = t;
+  }
+
+  PCL_MAKE_ALIGNED_OPERATOR_NEW
+};
+
+/** Find the first finite point of a cloud (or of its indices), relative to which the points are summed. */
+template <typename PointT, typename Scalar> bool
+getFirstFinitePoint (const pcl::PointCloud<PointT> &cloud, const index_t *indices, std::size_t nr_points,
+                     Eigen::Matrix<Scalar, 4, 1> &point)
+{
+  for (std::size_t i = 0; i < nr_points; ++i)
+  {
+    const PointT &p = cloud[indices ? indices[i] : i];
+    if (cloud.is_dense || isFinite (p))
+    {
+      point = Eigen::Matrix<Scalar, 4, 1> (p.x, p.y, p.z, 0);
+      return (true);
+    }
+  }
+  return (false);
+}
+
+/** Sum the coordinates of the valid points relative to a shift and, for second order moments, their outer
+  * products. The points are summed by fixed blocks whose sums are added in order, so the sums do not depend on
+  * the number of threads.
+  * \return the number of valid points */
+template <typename PointT, typename Scalar> std::size_t
+computeMomentSums (const pcl::PointCloud<PointT> &cloud, const index_t *indices, std::size_t nr_points,
+                   const Eigen::Matrix<Scalar, 4, 1> &shift, bool second_order,
+                   unsigned int nr_threads, bool compensated,
+                   Eigen::Matrix<Scalar, 4, 1> &sum, Eigen::Matrix<Scalar, 3, 3> &products)
+{
+  using Vector4 = Eigen::Matrix<Scalar, 4, 1>;
+  const std::size_t block_size = 4096;
+  const auto nr_blocks = static_cast<std::ptrdiff_t> ((nr_points + block_size - 1) / block_size);
+  std::vector<MomentSums<Scalar>, Eigen::aligned_allocator<MomentSums<Scalar> > > blocks (nr_blocks);
+  const bool is_dense = cloud.is_dense;
+
+  pcl::utils::ignore (nr_threads);
+#pragma omp parallel for \
+  default(none) \
+  shared(cloud, indices, nr_points, shift, second_order, compensated, blocks, nr_blocks, is_dense) \
+  num_threads(pcl::utils::getNumberOfThreads (nr_threads)) \
+  schedule(static)
+  for (std::ptrdiff_t b = 0; b < nr_blocks; ++b)
+  {
+    MomentSums<Scalar> &block = blocks[b];
+    const std::size_t end = std::min (nr_points, (b + 1) * block_size);
+    for (std::size_t i = b * block_size; i < end; ++i)
+    {
+      const PointT &point = cloud[indices ? indices[i] : i];
+      // If the data is dense, we don't need to check for NaN
+      if (!is_dense && !isFinite (point))
+        continue;
+
+      const Vector4 p (static_cast<Scalar> (point.x) - shift[0],
+                       static_cast<Scalar> (point.y) - shift[1],
+                       static_cast<Scalar> (point.z) - shift[2],
+                       0);
+      block.add (0, p, compensated);
+      if (second_order)
+      {
+        block.add (1, p * p[0], compensated);
+        block.add (2, p * p[1], compensated);
+        block.add (3, p * p[2], compensated);
+      }
+      ++block.count;
+    }
+  }
+
+  MomentSums<Scalar> total;
+  for (const auto &block : blocks)
+  {
+    for (std::size_t k = 0; k < 4; ++k)
+      total.add (k, block.sum[k] - block.compensation[k], compensated);
+    total.count += block.count;
+  }
+  sum = total.sum[0];
+  for (std::size_t k = 0; k < 3; ++k)
+    products.col (k) = total.sum[k + 1].template head<3> ();
+  return (total.count);
+}
+
+template <typename PointT, typename Scalar> unsigned int
+compute3DCentroid (const pcl::PointCloud<PointT> &cloud, const index_t *indices, std::size_t nr_points,
+                   Eigen::Matrix<Scalar, 4, 1> &centroid, unsigned int nr_threads, bool compensated)
+{
+  Eigen::Matrix<Scalar, 4, 1> shift;
+  if (!getFirstFinitePoint (cloud, indices, nr_points, shift))
+    return (0);
+
+  Eigen::Matrix<Scalar, 4, 1> sum;
+  Eigen::Matrix<Scalar, 3, 3> products;
+  const std::size_t point_count = computeMomentSums (cloud, indices, nr_points, shift, false, nr_threads, compensated, sum, products);
+  centroid = shift + sum / static_cast<Scalar> (point_count);
+  centroid[3] = 1;
+  return (static_cast<unsigned int> (point_count));
+}
+
+template <typename PointT, typename Scalar> unsigned int
+computeCovarianceMatrix (const pcl::PointCloud<PointT> &cloud, const index_t *indices, std::size_t nr_points,
+                         const Eigen::Matrix<Scalar, 4, 1> &centroid, Eigen::Matrix<Scalar, 3, 3> &covariance_matrix,
+                         unsigned int nr_threads, bool compensated)
+{
+  Eigen::Matrix<Scalar, 4, 1> shift (centroid[0], centroid[1], centroid[2], 0);
+  Eigen::Matrix<Scalar, 4, 1> sum;
+  Eigen::Matrix<Scalar, 3, 3> products;
+  const std::size_t point_count = computeMomentSums (cloud, indices, nr_points, shift, true, nr_threads, compensated, sum, products);
+  if (point_count != 0)
+    covariance_matrix = products;
+  return (static_cast<unsigned int> (point_count));
+}
+
+template <typename PointT, typename Scalar> unsigned int
+computeMeanAndCovarianceMatrix (const pcl::PointCloud<PointT> &cloud, const index_t *indices, std::size_t nr_points,
+                                Eigen::Matrix<Scalar, 3, 3> &covariance_matrix, Eigen::Matrix<Scalar, 4, 1> &centroid,
+                                unsigned int nr_threads, bool compensated)
+{
+  Eigen::Matrix<Scalar, 4, 1> shift;
+  if (!getFirstFinitePoint (cloud, indices, nr_points, shift))
+    return (0);
+
+  Eigen::Matrix<Scalar, 4, 1> sum;
+  Eigen::Matrix<Scalar, 3, 3> products;
+  const std::size_t point_count = computeMomentSums (cloud, indices, nr_points, shift, true, nr_threads, compensated, sum, products);
+  const Eigen::Matrix<Scalar, 3, 1> mean = sum.template head<3> () / static_cast<Scalar> (point_count);
+  covariance_matrix = products / static_cast<Scalar> (point_count) - mean * mean.transpose ();
+  centroid.template head<3> () = shift.template head<3> () + mean;
+  centroid[3] = 1;
+  return (static_cast<unsigned int> (point_count));
+}
+
+} // namespace detail
+
 template <typename PointT, typename Scalar> inline unsigned int
 compute3DCentroid (ConstCloudIterator<PointT> &cloud_iterator,
                    Eigen::Matrix<Scalar, 4, 1> &centroid)
@@ -623,6 +796,73 @@ computeMeanAndCovarianceMatrix (const pcl::PointCloud<PointT> &cloud,
 }
 
 
+template <typename PointT, typename Scalar> inline unsigned int
+compute3DCentroid (const pcl::PointCloud<PointT> &cloud,
+                   Eigen::Matrix<Scalar, 4, 1> &centroid,
+                   unsigned int nr_threads,
+                   bool compensated)
+{
+  return (detail::compute3DCentroid (cloud, nullptr, cloud.size (), centroid, nr_threads, compensated));
+}
+
+
+template <typename PointT, typename Scalar> inline unsigned int
+compute3DCentroid (const pcl::PointCloud<PointT> &cloud,
+                   const Indices &indices,
+                   Eigen::Matrix<Scalar, 4, 1> &centroid,
+                   unsigned int nr_threads,
+                   bool compensated)
+{
+  return (detail::compute3DCentroid (cloud, indices.data (), indices.size (), centroid, nr_threads, compensated));
+}
+
+
+template <typename PointT, typename Scalar> inline unsigned int
+computeCovarianceMatrix (const pcl::PointCloud<PointT> &cloud,
+                         const Eigen::Matrix<Scalar, 4, 1> &centroid,
+                         Eigen::Matrix<Scalar, 3, 3> &covariance_matrix,
+                         unsigned int nr_threads,
+                         bool compensated)
+{
+  return (detail::computeCovarianceMatrix (cloud, nullptr, cloud.size (), centroid, covariance_matrix, nr_threads, compensated));
+}
+
+
+template <typename PointT, typename Scalar> inline unsigned int
+computeCovarianceMatrix (const pcl::PointCloud<PointT> &cloud,
+                         const Indices &indices,
+                         const Eigen::Matrix<Scalar, 4, 1> &centroid,
+                         Eigen::Matrix<Scalar, 3, 3> &covariance_matrix,
+                         unsigned int nr_threads,
+                         bool compensated)
+{
+  return (detail::computeCovarianceMatrix (cloud, indices.data (), indices.size (), centroid, covariance_matrix, nr_threads, compensated));
+}
+
+
+template <typename PointT, typename Scalar> inline unsigned int
+computeMeanAndCovarianceMatrix (const pcl::PointCloud<PointT> &cloud,
+                                Eigen::Matrix<Scalar, 3, 3> &covariance_matrix,
+                                Eigen::Matrix<Scalar, 4, 1> &centroid,
+                                unsigned int nr_threads,
+                                bool compensated)
+{
+  return (detail::computeMeanAndCovarianceMatrix (cloud, nullptr, cloud.size (), covariance_matrix, centroid, nr_threads, compensated));
+}
+
+
+template <typename PointT, typename Scalar> inline unsigned int
+computeMeanAndCovarianceMatrix (const pcl::PointCloud<PointT> &cloud,
+                                const Indices &indices,
+                                Eigen::Matrix<Scalar, 3, 3> &covariance_matrix,
+                                Eigen::Matrix<Scalar, 4, 1> &centroid,
+                                unsigned int nr_threads,
+                                bool compensated)
+{
+  return (detail::computeMeanAndCovarianceMatrix (cloud, indices.data (), indices.size (), covariance_matrix, centroid, nr_threads, compensated));
+}
+
+
 template <typename PointT, typename Scalar> void
 demeanPointCloud (ConstCloudIterator<PointT> &cloud_iterator,
                   const Eigen::Matrix<Scalar, 4, 1> &centroid,
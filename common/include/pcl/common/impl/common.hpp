@@ -40,6 +40,7 @@
 
 #include <pcl/point_types.h>
 #include <pcl/common/common.h>
+#include <pcl/common/utils.h> // for pcl::utils::getNumberOfThreads
 #include <cfloat> // for FLT_MAX
 
 //////////////////////////////////////////////////////////////////////////////////////////////
@@ -386,6 +387,67 @@ pcl::getMinMax3D (const pcl::PointCloud<PointT> &cloud, const Indices &indices,
   }
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::detail::getMinMax3D (const pcl::PointCloud<PointT> &cloud, const index_t *indices, std::size_t nr_points,
+                          Eigen::Vector4f &min_pt, Eigen::Vector4f &max_pt, unsigned int nr_threads)
+{
+  Eigen::Array4f min_p, max_p;
+  min_p.setConstant (FLT_MAX);
+  max_p.setConstant (-FLT_MAX);
+  const auto nr = static_cast<std::ptrdiff_t> (nr_points);
+  const bool is_dense = cloud.is_dense;
+
+  // Every thread bounds its share of the points, the bounds are then merged
+  pcl::utils::ignore (nr_threads);
+#pragma omp parallel \
+  default(none) \
+  shared(cloud, indices, nr, is_dense, min_p, max_p) \
+  num_threads(pcl::utils::getNumberOfThreads (nr_threads))
+  {
+    Eigen::Array4f thread_min_p, thread_max_p;
+    thread_min_p.setConstant (FLT_MAX);
+    thread_max_p.setConstant (-FLT_MAX);
+#pragma omp for schedule(static) nowait
+    for (std::ptrdiff_t i = 0; i < nr; ++i)
+    {
+      const PointT &point = cloud[indices ? indices[i] : i];
+      // If the data is dense, we don't need to check for NaN
+      if (!is_dense &&
+          (!std::isfinite (point.x) ||
+           !std::isfinite (point.y) ||
+           !std::isfinite (point.z)))
+        continue;
+      const auto pt = point.getArray4fMap ();
+      thread_min_p = thread_min_p.min (pt);
+      thread_max_p = thread_max_p.max (pt);
+    }
+#pragma omp critical
+    {
+      min_p = min_p.min (thread_min_p);
+      max_p = max_p.max (thread_max_p);
+    }
+  }
+  min_pt = min_p;
+  max_pt = max_p;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> inline void
+pcl::getMinMax3D (const pcl::PointCloud<PointT> &cloud,
+                  Eigen::Vector4f &min_pt, Eigen::Vector4f &max_pt, unsigned int nr_threads)
+{
+  pcl::detail::getMinMax3D (cloud, nullptr, cloud.size (), min_pt, max_pt, nr_threads);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> inline void
+pcl::getMinMax3D (const pcl::PointCloud<PointT> &cloud, const Indices &indices,
+                  Eigen::Vector4f &min_pt, Eigen::Vector4f &max_pt, unsigned int nr_threads)
+{
+  pcl::detail::getMinMax3D (cloud, indices.data (), indices.size (), min_pt, max_pt, nr_threads);
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT> inline double 
 pcl::getCircumcircleRadius (const PointT &pa, const PointT &pb, const PointT &pc)
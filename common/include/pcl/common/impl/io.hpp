@@ -43,12 +43,65 @@
 #include <pcl/common/concatenate.h>
 #include <pcl/common/copy_point.h>
 #include <pcl/common/io.h>
+#include <pcl/common/utils.h> // for pcl::utils::getNumberOfThreads
 #include <pcl/point_types.h>
 
+#include <cstddef>
+#include <numeric>
+
 
 namespace pcl
 {
 
+namespace detail
+{
+  /** \brief Copy the points of \a cloud_in at the given indices into consecutive points starting at \a out.
+    * Every thread writes one contiguous range of the output, so the writes stream through memory
+    * and only the reads are scattered.
+    */
+  template <typename PointInT, typename PointOutT, typename IndexT> void
+  gatherPoints (const pcl::PointCloud<PointInT> &cloud_in, const IndexT *indices, std::size_t nr_indices,
+                PointOutT *out, unsigned int nr_threads)
+  {
+    const auto nr_points = static_cast<std::ptrdiff_t> (nr_indices);
+    pcl::utils::ignore (nr_threads);
+#pragma omp parallel for \
+  default(none) \
+  shared(cloud_in, indices, nr_points, out) \
+  num_threads(pcl::utils::getNumberOfThreads (nr_threads)) \
+  schedule(static)
+    for (std::ptrdiff_t i = 0; i < nr_points; ++i)
+      copyPoint (cloud_in[indices[i]], out[i]);
+  }
+
+  /** \brief Copy the points of all the clusters one after the other into \a out, with a single team of threads
+    * sharing the points of every cluster, so that neither many small nor a few large clusters serialize the copy.
+    */
+  template <typename PointInT, typename PointOutT> void
+  gatherClusters (const pcl::PointCloud<PointInT> &cloud_in, const std::vector<pcl::PointIndices> &clusters,
+                  PointOutT *out, unsigned int nr_threads)
+  {
+    std::vector<std::size_t> offsets (clusters.size () + 1, 0);
+    for (std::size_t c = 0; c < clusters.size (); ++c)
+      offsets[c + 1] = offsets[c] + clusters[c].indices.size ();
+    pcl::utils::ignore (nr_threads);
+#pragma omp parallel \
+  default(none) \
+  shared(cloud_in, clusters, offsets, out) \
+  num_threads(pcl::utils::getNumberOfThreads (nr_threads))
+    for (std::size_t c = 0; c < clusters.size (); ++c)
+    {
+      const auto &indices = clusters[c].indices;
+      const auto nr_points = static_cast<std::ptrdiff_t> (indices.size ());
+      PointOutT *cluster_out = out + offsets[c];
+#pragma omp for schedule(static) nowait
+      for (std::ptrdiff_t i = 0; i < nr_points; ++i)
+        copyPoint (cloud_in[indices[i]], cluster_out[i]);
+    }
+  }
+} // namespace detail
+
+
 template <typename PointT> int
 getFieldIndex (const pcl::PointCloud<PointT> &,
                const std::string &field_name,
@@ -146,7 +199,8 @@ copyPointCloud (const pcl::PointCloud<PointInT> &cloud_in,
 template <typename PointT, typename IndicesVectorAllocator> void
 copyPointCloud (const pcl::PointCloud<PointT> &cloud_in,
                 const IndicesAllocator< IndicesVectorAllocator> &indices,
-                pcl::PointCloud<PointT> &cloud_out)
+                pcl::PointCloud<PointT> &cloud_out,
+                unsigned int nr_threads)
 {
   // Do we want to copy everything?
   if (indices.size () == cloud_in.size ())
@@ -164,16 +218,15 @@ copyPointCloud (const pcl::PointCloud<PointT> &cloud_in,
   cloud_out.sensor_orientation_ = cloud_in.sensor_orientation_;
   cloud_out.sensor_origin_ = cloud_in.sensor_origin_;
 
-  // Iterate over each point
-  for (std::size_t i = 0; i < indices.size (); ++i)
-    cloud_out[i] = cloud_in[indices[i]];
+  detail::gatherPoints (cloud_in, indices.data (), indices.size (), cloud_out.points.data (), nr_threads);
 }
 
 
 template <typename PointInT, typename PointOutT, typename IndicesVectorAllocator> void
 copyPointCloud (const pcl::PointCloud<PointInT> &cloud_in,
                 const IndicesAllocator< IndicesVectorAllocator> &indices,
-                pcl::PointCloud<PointOutT> &cloud_out)
+                pcl::PointCloud<PointOutT> &cloud_out,
+                unsigned int nr_threads)
 {
   // Allocate enough space and copy the basics
   cloud_out.points.resize (indices.size ());
@@ -184,16 +237,15 @@ copyPointCloud (const pcl::PointCloud<PointInT> &cloud_in,
   cloud_out.sensor_orientation_ = cloud_in.sensor_orientation_;
   cloud_out.sensor_origin_ = cloud_in.sensor_origin_;
 
-  // Iterate over each point
-  for (std::size_t i = 0; i < indices.size (); ++i)
-    copyPoint (cloud_in[indices[i]], cloud_out[i]);
+  detail::gatherPoints (cloud_in, indices.data (), indices.size (), cloud_out.points.data (), nr_threads);
 }
 
 
 template <typename PointT> void
 copyPointCloud (const pcl::PointCloud<PointT> &cloud_in,
                 const pcl::PointIndices &indices,
-                     pcl::PointCloud<PointT> &cloud_out)
+                pcl::PointCloud<PointT> &cloud_out,
+                unsigned int nr_threads)
 {
   // Do we want to copy everything?
   if (indices.indices.size () == cloud_in.size ())
@@ -211,25 +263,25 @@ copyPointCloud (const pcl::PointCloud<PointT> &cloud_in,
   cloud_out.sensor_orientation_ = cloud_in.sensor_orientation_;
   cloud_out.sensor_origin_ = cloud_in.sensor_origin_;
 
-  // Iterate over each point
-  for (std::size_t i = 0; i < indices.indices.size (); ++i)
-    cloud_out[i] = cloud_in[indices.indices[i]];
+  detail::gatherPoints (cloud_in, indices.indices.data (), indices.indices.size (), cloud_out.points.data (), nr_threads);
 }
 
 
 template <typename PointInT, typename PointOutT> void
 copyPointCloud (const pcl::PointCloud<PointInT> &cloud_in,
                 const pcl::PointIndices &indices,
-                pcl::PointCloud<PointOutT> &cloud_out)
+                pcl::PointCloud<PointOutT> &cloud_out,
+                unsigned int nr_threads)
 {
-  copyPointCloud (cloud_in, indices.indices, cloud_out);
+  copyPointCloud (cloud_in, indices.indices, cloud_out, nr_threads);
 }
 
 
 template <typename PointT> void
 copyPointCloud (const pcl::PointCloud<PointT> &cloud_in,
                 const std::vector<pcl::PointIndices> &indices,
-                pcl::PointCloud<PointT> &cloud_out)
+                pcl::PointCloud<PointT> &cloud_out,
+                unsigned int nr_threads)
 {
   int nr_p = 0;
   for (const auto &index : indices)
@@ -251,25 +303,15 @@ copyPointCloud (const pcl::PointCloud<PointT> &cloud_in,
   cloud_out.sensor_orientation_ = cloud_in.sensor_orientation_;
   cloud_out.sensor_origin_ = cloud_in.sensor_origin_;
 
-  // Iterate over each cluster
-  int cp = 0;
-  for (const auto &cluster_index : indices)
-  {
-    // Iterate over each idx
-    for (const auto &index : cluster_index.indices)
-    {
-      // Iterate over each dimension
-      cloud_out[cp] = cloud_in[index];
-      cp++;
-    }
-  }
+  detail::gatherClusters (cloud_in, indices, cloud_out.points.data (), nr_threads);
 }
 
 
 template <typename PointInT, typename PointOutT> void
 copyPointCloud (const pcl::PointCloud<PointInT> &cloud_in,
                 const std::vector<pcl::PointIndices> &indices,
-                pcl::PointCloud<PointOutT> &cloud_out)
+                pcl::PointCloud<PointOutT> &cloud_out,
+                unsigned int nr_threads)
 {
   const auto nr_p = std::accumulate(indices.begin (), indices.end (), 0,
       [](const auto& acc, const auto& index) { return index.indices.size() + acc; });
@@ -290,17 +332,7 @@ copyPointCloud (const pcl::PointCloud<PointInT> &cloud_in,
   cloud_out.sensor_orientation_ = cloud_in.sensor_orientation_;
   cloud_out.sensor_origin_ = cloud_in.sensor_origin_;
 
-  // Iterate over each cluster
-  std::size_t cp = 0;
-  for (const auto &cluster_index : indices)
-  {
-    // Iterate over each idx
-    for (const auto &index : cluster_index.indices)
-    {
-      copyPoint (cloud_in[index], cloud_out[cp]);
-      ++cp;
-    }
-  }
+  detail::gatherClusters (cloud_in, indices, cloud_out.points.data (), nr_threads);
 }
 
 
@@ -0,0 +1,132 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved
+ */
+
+#pragma once
+
+#include <pcl/common/common.h> // for getMinMax3D
+#include <pcl/common/morton.h>
+#include <pcl/common/point_tests.h> // for pcl::isFinite
+#include <pcl/common/utils.h> // for getNumberOfThreads
+
+#include <Eigen/Core>
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace pcl
+{
+  namespace detail
+  {
+    /** \brief Spread the 21 low bits of \a v so that there are two zero bits between them. */
+    inline std::uint64_t
+    spreadBitsBy3 (std::uint32_t v)
+    {
+      std::uint64_t x = v & 0x1fffff;
+      x = (x | x << 32) & 0x1f00000000ffffULL;
+      x = (x | x << 16) & 0x1f0000ff0000ffULL;
+      x = (x | x << 8)  & 0x100f00f00f00f00fULL;
+      x = (x | x << 4)  & 0x10c30c30c30c30c3ULL;
+      x = (x | x << 2)  & 0x1249249249249249ULL;
+      return (x);
+    }
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+inline std::uint64_t
+pcl::encodeMorton (std::uint32_t x, std::uint32_t y, std::uint32_t z)
+{
+  return ((detail::spreadBitsBy3 (x) << 2) | (detail::spreadBitsBy3 (y) << 1) | detail::spreadBitsBy3 (z));
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::getMortonOrder (const pcl::PointCloud<PointT> &cloud, const Indices &indices, Indices &order,
+                     unsigned int nr_threads)
+{
+  const std::ptrdiff_t nr_points = static_cast<std::ptrdiff_t> (indices.empty () ? cloud.size () : indices.size ());
+  const auto point = [&cloud, &indices] (std::ptrdiff_t i) -> const PointT&
+  {
+    return (cloud[indices.empty () ? i : indices[i]]);
+  };
+  nr_threads = pcl::utils::getNumberOfThreads (nr_threads);
+
+  // Bounding box of the valid points
+  Eigen::Vector4f min_pt, max_pt;
+  if (indices.empty ())
+    getMinMax3D (cloud, min_pt, max_pt, nr_threads);
+  else
+    getMinMax3D (cloud, indices, min_pt, max_pt, nr_threads);
+  const Eigen::Array3f min_corner = min_pt.head<3> ().array ();
+
+  // Codes of the points on a grid of 2^21 cells per axis, the invalid points get the largest code
+  const float max_cell = static_cast<float> ((1 << 21) - 1);
+  const Eigen::Array3f scale = max_cell / (max_pt - min_pt).head<3> ().array ().max (std::numeric_limits<float>::min ());
+  std::vector<std::pair<std::uint64_t, index_t> > codes (nr_points);
+#pragma omp parallel for schedule(static) num_threads(nr_threads)
+  for (std::ptrdiff_t i = 0; i < nr_points; ++i)
+  {
+    const PointT &p = point (i);
+    std::uint64_t code = std::numeric_limits<std::uint64_t>::max ();
+    if (pcl::isFinite (p))
+    {
+      const Eigen::Array3f cell = ((p.getArray3fMap () - min_corner) * scale).min (max_cell).max (0.0f);
+      code = encodeMorton (static_cast<std::uint32_t> (cell[0]), static_cast<std::uint32_t> (cell[1]),
+                           static_cast<std::uint32_t> (cell[2]));
+    }
+    codes[i] = std::make_pair (code, static_cast<index_t> (i));
+  }
+
+  // Stable LSD radix sort on the 64 bits of the codes
+  std::vector<std::pair<std::uint64_t, index_t> > sorted_codes (nr_points);
+  for (unsigned int shift = 0; shift < 64; shift += 8)
+  {
+    std::size_t offsets[257] = {0};
+    for (const auto &code : codes)
+      ++offsets[((code.first >> shift) & 0xFF) + 1];
+    // all the codes in the same bucket, e.g. the high bytes of small grids, the pass would not change the order
+    if (std::find (offsets + 1, offsets + 257, codes.size ()) != offsets + 257)
+      continue;
+    for (std::size_t bucket = 1; bucket < 257; ++bucket)
+      offsets[bucket] += offsets[bucket - 1];
+    for (const auto &code : codes)
+      sorted_codes[offsets[(code.first >> shift) & 0xFF]++] = code;
+    codes.swap (sorted_codes);
+  }
+
+  order.resize (nr_points);
+  for (std::ptrdiff_t i = 0; i < nr_points; ++i)
+    order[i] = codes[i].second;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::reorderPointCloudMorton (const pcl::PointCloud<PointT> &cloud_in, pcl::PointCloud<PointT> &cloud_out,
+                              Indices &permutation, unsigned int nr_threads)
+{
+  getMortonOrder (cloud_in, permutation, nr_threads);
+
+  // The output can not be the input, the points are gathered from it
+  pcl::PointCloud<PointT> reordered;
+  reordered.header = cloud_in.header;
+  reordered.sensor_origin_ = cloud_in.sensor_origin_;
+  reordered.sensor_orientation_ = cloud_in.sensor_orientation_;
+  reordered.is_dense = cloud_in.is_dense;
+  reordered.resize (permutation.size ());
+  const std::ptrdiff_t nr_points = static_cast<std::ptrdiff_t> (permutation.size ());
+#pragma omp parallel for schedule(static) num_threads(pcl::utils::getNumberOfThreads (nr_threads))
+  for (std::ptrdiff_t i = 0; i < nr_points; ++i)
+    reordered[i] = cloud_in[permutation[i]];
+  reordered.width = static_cast<std::uint32_t> (permutation.size ());
+  reordered.height = 1;
+  cloud_out = std::move (reordered);
+}
@@ -40,6 +40,7 @@
 #pragma once
 
 #include <pcl/common/transforms.h>
+#include <pcl/common/utils.h> // for pcl::utils::getNumberOfThreads
 
 #if defined(__SSE2__)
 #include <xmmintrin.h>
@@ -221,7 +222,8 @@ template <typename PointT, typename Scalar> void
 transformPointCloud (const pcl::PointCloud<PointT> &cloud_in,
                      pcl::PointCloud<PointT> &cloud_out,
                      const Eigen::Transform<Scalar, 3, Eigen::Affine> &transform,
-                     bool copy_all_fields)
+                     bool copy_all_fields,
+                     unsigned int nr_threads)
 {
   if (&cloud_in != &cloud_out)
   {
@@ -239,24 +241,53 @@ transformPointCloud (const pcl::PointCloud<PointT> &cloud_in,
   }
 
   pcl::detail::Transformer<Scalar> tf (transform.matrix ());
-  if (cloud_in.is_dense)
-  {
-    // If the dataset is dense, simply transform it!
-    for (std::size_t i = 0; i < cloud_out.size (); ++i)
-      tf.se3 (cloud_in[i].data, cloud_out[i].data);
-  }
-  else
+  const auto nr_points = static_cast<std::ptrdiff_t> (cloud_out.size ());
+  const bool is_dense = cloud_in.is_dense;
+  // Every point is read and written by one thread only, so cloud_in may be cloud_out
+  pcl::utils::ignore (nr_threads);
+#pragma omp parallel for \
+  default(none) \
+  shared(cloud_in, cloud_out, tf, nr_points, is_dense) \
+  num_threads(pcl::utils::getNumberOfThreads (nr_threads)) \
+  schedule(static)
+  for (std::ptrdiff_t i = 0; i < nr_points; ++i)
   {
     // Dataset might contain NaNs and Infs, so check for them first,
     // otherwise we get errors during the multiplication (?)
-    for (std::size_t i = 0; i < cloud_out.size (); ++i)
-    {
-      if (!std::isfinite (cloud_in[i].x) ||
-          !std::isfinite (cloud_in[i].y) ||
-          !std::isfinite (cloud_in[i].z))
-        continue;
-      tf.se3 (cloud_in[i].data, cloud_out[i].data);
-    }
+    if (!is_dense &&
+        (!std::isfinite (cloud_in[i].x) ||
+         !std::isfinite (cloud_in[i].y) ||
+         !std::isfinite (cloud_in[i].z)))
+      continue;
+    tf.se3 (cloud_in[i].data, cloud_out[i].data);
+  }
+}
+
+
+template <typename Scalar> void
+transformPointCloud (const pcl::PointCloudSoA &cloud_in,
+                     pcl::PointCloudSoA &cloud_out,
+                     const Eigen::Transform<Scalar, 3, Eigen::Affine> &transform)
+{
+  if (&cloud_in != &cloud_out)
+    cloud_out = cloud_in;
+
+  // The coordinates are transformed in place, block by block, with the temporaries on the stack
+  const std::ptrdiff_t block_size = 1024;
+  using ArrayX = Eigen::Array<Scalar, Eigen::Dynamic, 1, 0, 1024, 1>;
+  const auto& m = transform.matrix ();
+  auto x = cloud_out.x ();
+  auto y = cloud_out.y ();
+  auto z = cloud_out.z ();
+  for (std::ptrdiff_t begin = 0; begin < x.size (); begin += block_size)
+  {
+    const std::ptrdiff_t count = std::min (block_size, x.size () - begin);
+    const ArrayX px = x.segment (begin, count).template cast<Scalar> ();
+    const ArrayX py = y.segment (begin, count).template cast<Scalar> ();
+    const ArrayX pz = z.segment (begin, count).template cast<Scalar> ();
+    x.segment (begin, count) = (m (0, 0) * px + m (0, 1) * py + m (0, 2) * pz + m (0, 3)).template cast<float> ();
+    y.segment (begin, count) = (m (1, 0) * px + m (1, 1) * py + m (1, 2) * pz + m (1, 3)).template cast<float> ();
+    z.segment (begin, count) = (m (2, 0) * px + m (2, 1) * py + m (2, 2) * pz + m (2, 3)).template cast<float> ();
   }
 }
 
@@ -266,44 +297,48 @@ transformPointCloud (const pcl::PointCloud<PointT> &cloud_in,
                      const Indices &indices,
                      pcl::PointCloud<PointT> &cloud_out,
                      const Eigen::Transform<Scalar, 3, Eigen::Affine> &transform,
-                     bool copy_all_fields)
+                     bool copy_all_fields,
+                     unsigned int nr_threads)
 {
+  // The points are gathered from a copy when a cloud is transformed into itself
+  pcl::PointCloud<PointT> cloud_in_copy;
+  if (&cloud_in == &cloud_out)
+    cloud_in_copy = cloud_in;
+  const pcl::PointCloud<PointT> &input = (&cloud_in == &cloud_out) ? cloud_in_copy : cloud_in;
+
   std::size_t npts = indices.size ();
   // In order to transform the data, we need to remove NaNs
-  cloud_out.is_dense = cloud_in.is_dense;
-  cloud_out.header   = cloud_in.header;
+  cloud_out.is_dense = input.is_dense;
+  cloud_out.header   = input.header;
   cloud_out.width    = static_cast<int> (npts);
   cloud_out.height   = 1;
   cloud_out.points.resize (npts);
-  cloud_out.sensor_orientation_ = cloud_in.sensor_orientation_;
-  cloud_out.sensor_origin_      = cloud_in.sensor_origin_;
+  cloud_out.sensor_orientation_ = input.sensor_orientation_;
+  cloud_out.sensor_origin_      = input.sensor_origin_;
 
   pcl::detail::Transformer<Scalar> tf (transform.matrix ());
-  if (cloud_in.is_dense)
-  {
-    // If the dataset is dense, simply transform it!
-    for (std::size_t i = 0; i < npts; ++i)
-    {
-      // Copy fields first, then transform xyz data
-      if (copy_all_fields)
-        cloud_out[i] = cloud_in[indices[i]];
-      tf.se3 (cloud_in[indices[i]].data, cloud_out[i].data);
-    }
-  }
-  else
+  const auto nr_points = static_cast<std::ptrdiff_t> (npts);
+  const bool is_dense = input.is_dense;
+  pcl::utils::ignore (nr_threads);
+#pragma omp parallel for \
+  default(none) \
+  shared(input, indices, cloud_out, tf, nr_points, is_dense, copy_all_fields) \
+  num_threads(pcl::utils::getNumberOfThreads (nr_threads)) \
+  schedule(static)
+  for (std::ptrdiff_t i = 0; i < nr_points; ++i)
   {
+    const PointT &point = input[indices[i]];
+    // Copy fields first, then transform xyz data
+    if (copy_all_fields)
+      cloud_out[i] = point;
     // Dataset might contain NaNs and Infs, so check for them first,
     // otherwise we get errors during the multiplication (?)
-    for (std::size_t i = 0; i < npts; ++i)
-    {
-      if (copy_all_fields)
-        cloud_out[i] = cloud_in[indices[i]];
-      if (!std::isfinite (cloud_in[indices[i]].x) ||
-          !std::isfinite (cloud_in[indices[i]].y) ||
-          !std::isfinite (cloud_in[indices[i]].z))
-        continue;
-      tf.se3 (cloud_in[indices[i]].data, cloud_out[i].data);
-    }
+    if (!is_dense &&
+        (!std::isfinite (point.x) ||
+         !std::isfinite (point.y) ||
+         !std::isfinite (point.z)))
+      continue;
+    tf.se3 (point.data, cloud_out[i].data);
   }
 }
 
@@ -312,7 +347,8 @@ template <typename PointT, typename Scalar> void
 transformPointCloudWithNormals (const pcl::PointCloud<PointT> &cloud_in,
                                 pcl::PointCloud<PointT> &cloud_out,
                                 const Eigen::Transform<Scalar, 3, Eigen::Affine> &transform,
-                                bool copy_all_fields)
+                                bool copy_all_fields,
+                                unsigned int nr_threads)
 {
   if (&cloud_in != &cloud_out)
   {
@@ -321,7 +357,7 @@ transformPointCloudWithNormals (const pcl::PointCloud<PointT> &cloud_in,
     cloud_out.width    = cloud_in.width;
     cloud_out.height   = cloud_in.height;
     cloud_out.is_dense = cloud_in.is_dense;
-    cloud_out.points.reserve (cloud_out.size ());
+    cloud_out.points.reserve (cloud_in.size ());
     if (copy_all_fields)
       cloud_out.points.assign (cloud_in.points.begin (), cloud_in.points.end ());
     else
@@ -331,27 +367,25 @@ transformPointCloudWithNormals (const pcl::PointCloud<PointT> &cloud_in,
   }
 
   pcl::detail::Transformer<Scalar> tf (transform.matrix ());
-  // If the data is dense, we don't need to check for NaN
-  if (cloud_in.is_dense)
+  const auto nr_points = static_cast<std::ptrdiff_t> (cloud_out.size ());
+  const bool is_dense = cloud_in.is_dense;
+  // Every point is read and written by one thread only, so cloud_in may be cloud_out
+  pcl::utils::ignore (nr_threads);
+#pragma omp parallel for \
+  default(none) \
+  shared(cloud_in, cloud_out, tf, nr_points, is_dense) \
+  num_threads(pcl::utils::getNumberOfThreads (nr_threads)) \
+  schedule(static)
+  for (std::ptrdiff_t i = 0; i < nr_points; ++i)
   {
-    for (std::size_t i = 0; i < cloud_out.size (); ++i)
-    {
-      tf.se3 (cloud_in[i].data, cloud_out[i].data);
-      tf.so3 (cloud_in[i].data_n, cloud_out[i].data_n);
-    }
-  }
-  // Dataset might contain NaNs and Infs, so check for them first.
-  else
-  {
-    for (std::size_t i = 0; i < cloud_out.size (); ++i)
-    {
-      if (!std::isfinite (cloud_in[i].x) ||
-          !std::isfinite (cloud_in[i].y) ||
-          !std::isfinite (cloud_in[i].z))
-        continue;
-      tf.se3 (cloud_in[i].data, cloud_out[i].data);
-      tf.so3 (cloud_in[i].data_n, cloud_out[i].data_n);
-    }
+    // If the data is dense, we don't need to check for NaN
+    if (!is_dense &&
+        (!std::isfinite (cloud_in[i].x) ||
+         !std::isfinite (cloud_in[i].y) ||
+         !std::isfinite (cloud_in[i].z)))
+      continue;
+    tf.se3 (cloud_in[i].data, cloud_out[i].data);
+    tf.so3 (cloud_in[i].data_n, cloud_out[i].data_n);
   }
 }
 
@@ -361,48 +395,48 @@ transformPointCloudWithNormals (const pcl::PointCloud<PointT> &cloud_in,
                                 const Indices &indices,
                                 pcl::PointCloud<PointT> &cloud_out,
                                 const Eigen::Transform<Scalar, 3, Eigen::Affine> &transform,
-                                bool copy_all_fields)
+                                bool copy_all_fields,
+                                unsigned int nr_threads)
 {
+  // The points are gathered from a copy when a cloud is transformed into itself
+  pcl::PointCloud<PointT> cloud_in_copy;
+  if (&cloud_in == &cloud_out)
+    cloud_in_copy = cloud_in;
+  const pcl::PointCloud<PointT> &input = (&cloud_in == &cloud_out) ? cloud_in_copy : cloud_in;
+
   std::size_t npts = indices.size ();
   // In order to transform the data, we need to remove NaNs
-  cloud_out.is_dense = cloud_in.is_dense;
-  cloud_out.header   = cloud_in.header;
+  cloud_out.is_dense = input.is_dense;
+  cloud_out.header   = input.header;
   cloud_out.width    = static_cast<int> (npts);
   cloud_out.height   = 1;
   cloud_out.points.resize (npts);
-  cloud_out.sensor_orientation_ = cloud_in.sensor_orientation_;
-  cloud_out.sensor_origin_      = cloud_in.sensor_origin_;
+  cloud_out.sensor_orientation_ = input.sensor_orientation_;
+  cloud_out.sensor_origin_      = input.sensor_origin_;
 
   pcl::detail::Transformer<Scalar> tf (transform.matrix ());
-  // If the data is dense, we don't need to check for NaN
-  if (cloud_in.is_dense)
+  const auto nr_points = static_cast<std::ptrdiff_t> (npts);
+  const bool is_dense = input.is_dense;
+  pcl::utils::ignore (nr_threads);
+#pragma omp parallel for \
+  default(none) \
+  shared(input, indices, cloud_out, tf, nr_points, is_dense, copy_all_fields) \
+  num_threads(pcl::utils::getNumberOfThreads (nr_threads)) \
+  schedule(static)
+  for (std::ptrdiff_t i = 0; i < nr_points; ++i)
   {
-    for (std::size_t i = 0; i < cloud_out.size (); ++i)
-    {
-      // Copy fields first, then transform
-      if (copy_all_fields)
-        cloud_out[i] = cloud_in[indices[i]];
-      tf.se3 (cloud_in[indices[i]].data, cloud_out[i].data);
-      tf.so3 (cloud_in[indices[i]].data_n, cloud_out[i].data_n);
-    }
-  }
-  // Dataset might contain NaNs and Infs, so check for them first.
-  else
-  {
-    for (std::size_t i = 0; i < cloud_out.size (); ++i)
-    {
-      // Copy fields first, then transform
-      if (copy_all_fields)
-        cloud_out[i] = cloud_in[indices[i]];
-
-      if (!std::isfinite (cloud_in[indices[i]].x) ||
-          !std::isfinite (cloud_in[indices[i]].y) ||
-          !std::isfinite (cloud_in[indices[i]].z))
-        continue;
-
-      tf.se3 (cloud_in[indices[i]].data, cloud_out[i].data);
-      tf.so3 (cloud_in[indices[i]].data_n, cloud_out[i].data_n);
-    }
+    const PointT &point = input[indices[i]];
+    // Copy fields first, then transform
+    if (copy_all_fields)
+      cloud_out[i] = point;
+    // If the data is dense, we don't need to check for NaN
+    if (!is_dense &&
+        (!std::isfinite (point.x) ||
+         !std::isfinite (point.y) ||
+         !std::isfinite (point.z)))
+      continue;
+    tf.se3 (point.data, cloud_out[i].data);
+    tf.so3 (point.data_n, cloud_out[i].data_n);
   }
 }
 
@@ -412,12 +446,13 @@ transformPointCloud (const pcl::PointCloud<PointT> &cloud_in,
                      pcl::PointCloud<PointT> &cloud_out,
                      const Eigen::Matrix<Scalar, 3, 1> &offset,
                      const Eigen::Quaternion<Scalar> &rotation,
-                     bool copy_all_fields)
+                     bool copy_all_fields,
+                     unsigned int nr_threads)
 {
   Eigen::Translation<Scalar, 3> translation (offset);
   // Assemble an Eigen Transform
   Eigen::Transform<Scalar, 3, Eigen::Affine> t (translation * rotation);
-  transformPointCloud (cloud_in, cloud_out, t, copy_all_fields);
+  transformPointCloud (cloud_in, cloud_out, t, copy_all_fields, nr_threads);
 }
 
 
@@ -426,12 +461,13 @@ transformPointCloudWithNormals (const pcl::PointCloud<PointT> &cloud_in,
                                 pcl::PointCloud<PointT> &cloud_out,
                                 const Eigen::Matrix<Scalar, 3, 1> &offset,
                                 const Eigen::Quaternion<Scalar> &rotation,
-                                bool copy_all_fields)
+                                bool copy_all_fields,
+                                unsigned int nr_threads)
 {
   Eigen::Translation<Scalar, 3> translation (offset);
   // Assemble an Eigen Transform
   Eigen::Transform<Scalar, 3, Eigen::Affine> t (translation * rotation);
-  transformPointCloudWithNormals (cloud_in, cloud_out, t, copy_all_fields);
+  transformPointCloudWithNormals (cloud_in, cloud_out, t, copy_all_fields, nr_threads);
 }
 
 
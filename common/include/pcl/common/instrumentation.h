@@ -0,0 +1,206 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2024-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#pragma once
+
+#include <pcl/pcl_exports.h>
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+  * \file pcl/common/instrumentation.h
+  * Define named timing scopes and counters to see where time goes in production, without a profiler
+  * \ingroup common
+  */
+
+/*@{*/
+namespace pcl
+{
+  namespace instrumentation
+  {
+    /** \brief Timing statistics of a named stage, over all the threads. */
+    struct StageStatistics
+    {
+      std::string name;
+      /** \brief Number of times the stage ran. */
+      std::uint64_t calls = 0;
+      /** \brief Total, shortest and longest time spent in the stage, in seconds. */
+      double total_time = 0.0;
+      double min_time = 0.0;
+      double max_time = 0.0;
+    };
+
+    /** \brief Value of a named counter, summed over all the threads. */
+    struct CounterValue
+    {
+      std::string name;
+      std::uint64_t value = 0;
+    };
+
+    /** \brief A snapshot of the statistics of all the stages and counters, sorted by name. */
+    struct Report
+    {
+      std::vector<StageStatistics> stages;
+      std::vector<CounterValue> counters;
+    };
+
+    /** \brief Enable or disable the instrumentation.
+      *
+      * The instrumentation is disabled by default, in which case a scope or a counter only costs the check of this
+      * flag. Define PCL_DISABLE_INSTRUMENTATION to remove the PCL_INSTRUMENT_* macros at compile time.
+      * \param[in] enable whether to record the stages and counters
+      */
+    PCL_EXPORTS void
+    setEnabled (bool enable);
+
+    /** \brief Whether the stages and counters are recorded. */
+    PCL_EXPORTS bool
+    isEnabled ();
+
+    /** \brief Set the maximum number of trace events each thread keeps for exportChromeTrace.
+      *
+      * The events over the capacity are dropped, the statistics of their stages are still recorded.
+      * \param[in] capacity the maximum number of events per thread, 0 disables the trace (default: 65536)
+      */
+    PCL_EXPORTS void
+    setTraceCapacity (std::size_t capacity);
+
+    /** \brief Record a run of a named stage.
+      * \param[in] name the name of the stage
+      * \param[in] start the time the stage started
+      * \param[in] end the time the stage ended
+      */
+    PCL_EXPORTS void
+    recordStage (const std::string &name,
+                 std::chrono::steady_clock::time_point start,
+                 std::chrono::steady_clock::time_point end);
+
+    /** \brief Add to a named counter, e.g. the number of neighbor queries of a stage.
+      *
+      * Each thread accumulates its own counters, they are only summed by getReport.
+      * \param[in] name the name of the counter
+      * \param[in] value the value to add (default: 1)
+      */
+    PCL_EXPORTS void
+    addCount (const std::string &name, std::uint64_t value = 1);
+
+    /** \brief Get the statistics recorded so far by all the threads, including the threads that exited. */
+    PCL_EXPORTS Report
+    getReport ();
+
+    /** \brief Clear the statistics, counters and trace events of all the threads. */
+    PCL_EXPORTS void
+    reset ();
+
+    /** \brief Write the recorded trace events in the Chrome trace event format, for chrome://tracing or Perfetto.
+      * \param[out] os the stream to write the JSON document to
+      */
+    PCL_EXPORTS void
+    exportChromeTrace (std::ostream &os);
+
+    /** \brief Write the statistics of the stages and the counters in the Prometheus text exposition format.
+      * \param[out] os the stream to write the metrics to
+      * \param[in] prefix the prefix of the metric names (default: "pcl")
+      */
+    PCL_EXPORTS void
+    exportPrometheus (std::ostream &os, const std::string &prefix = "pcl");
+
+    /** \brief Records the time spent in a scope as a run of a named stage.
+      *
+      * \code
+      * {
+      *   pcl::instrumentation::ScopedStage stage ("registration");
+      *   // ... perform the registration here
+      * }
+      * \endcode
+      *
+      * \ingroup common
+      */
+    class ScopedStage
+    {
+      public:
+        /** \brief Constructor, starts the stage if the instrumentation is enabled.
+          * \param[in] name the name of the stage
+          */
+        explicit ScopedStage (const std::string &name)
+          : enabled_ (isEnabled ())
+        {
+          if (enabled_)
+          {
+            name_ = name;
+            start_ = std::chrono::steady_clock::now ();
+          }
+        }
+
+        /** \brief Destructor, records the stage. */
+        ~ScopedStage ()
+        {
+          if (enabled_)
+            recordStage (name_, start_, std::chrono::steady_clock::now ());
+        }
+
+        ScopedStage (const ScopedStage&) = delete;
+        ScopedStage&
+        operator= (const ScopedStage&) = delete;
+
+      private:
+        std::string name_;
+        const bool enabled_;
+        std::chrono::steady_clock::time_point start_;
+    };
+  } // namespace instrumentation
+} // namespace pcl
+
+#define PCL_INSTRUMENT_CONCATENATE_IMPL(a, b) a ## b
+#define PCL_INSTRUMENT_CONCATENATE(a, b) PCL_INSTRUMENT_CONCATENATE_IMPL(a, b)
+
+#ifndef PCL_DISABLE_INSTRUMENTATION
+/** \brief Record the rest of the current scope as a run of the stage \a name (a std::string). */
+#define PCL_INSTRUMENT_SCOPE(name) \
+  const pcl::instrumentation::ScopedStage PCL_INSTRUMENT_CONCATENATE(pcl_instrument_scope_, __LINE__) (name)
+/** \brief Add \a value to the counter \a name if the instrumentation is enabled. */
+#define PCL_INSTRUMENT_COUNT(name, value) \
+  do { if (pcl::instrumentation::isEnabled ()) pcl::instrumentation::addCount ((name), (value)); } while (0)
+#else
+#define PCL_INSTRUMENT_SCOPE(name) static_cast<void> (0)
+#define PCL_INSTRUMENT_COUNT(name, value) static_cast<void> (0)
+#endif
+/*@}*/
@@ -338,25 +338,29 @@ namespace pcl
     * \param[in] cloud_in the input point cloud dataset
     * \param[in] indices the vector of indices representing the points to be copied from \a cloud_in
     * \param[out] cloud_out the resultant output point cloud dataset
+    * \param[in] nr_threads the number of threads copying the points (0 uses all the cores, default: 1)
     * \note Assumes unique indices.
     * \ingroup common
     */
   PCL_EXPORTS void
   copyPointCloud (const pcl::PCLPointCloud2 &cloud_in,
                   const Indices &indices,
-                  pcl::PCLPointCloud2 &cloud_out);
+                  pcl::PCLPointCloud2 &cloud_out,
+                  unsigned int nr_threads = 1);
 
   /** \brief Extract the indices of a given point cloud as a new point cloud
     * \param[in] cloud_in the input point cloud dataset
     * \param[in] indices the vector of indices representing the points to be copied from \a cloud_in
     * \param[out] cloud_out the resultant output point cloud dataset
+    * \param[in] nr_threads the number of threads copying the points (0 uses all the cores, default: 1)
     * \note Assumes unique indices.
     * \ingroup common
     */
   PCL_EXPORTS void
   copyPointCloud (const pcl::PCLPointCloud2 &cloud_in,
                   const IndicesAllocator< Eigen::aligned_allocator<int> > &indices,
-                  pcl::PCLPointCloud2 &cloud_out);
+                  pcl::PCLPointCloud2 &cloud_out,
+                  unsigned int nr_threads = 1);
 
   /** \brief Copy fields and point cloud data from \a cloud_in to \a cloud_out
     * \param[in] cloud_in the input point cloud dataset
@@ -378,37 +382,43 @@ namespace pcl
     * \param[in] cloud_in the input point cloud dataset
     * \param[in] indices the vector of indices representing the points to be copied from \a cloud_in
     * \param[out] cloud_out the resultant output point cloud dataset
+    * \param[in] nr_threads the number of threads copying the points (0 uses all the cores, default: 1)
     * \note Assumes unique indices.
     * \ingroup common
     */
   template <typename PointT, typename IndicesVectorAllocator = std::allocator<int>> void
   copyPointCloud (const pcl::PointCloud<PointT> &cloud_in,
                   const IndicesAllocator< IndicesVectorAllocator> &indices,
-                  pcl::PointCloud<PointT> &cloud_out);
+                  pcl::PointCloud<PointT> &cloud_out,
+                  unsigned int nr_threads = 1);
 
   /** \brief Extract the indices of a given point cloud as a new point cloud
     * \param[in] cloud_in the input point cloud dataset
     * \param[in] indices the PointIndices structure representing the points to be copied from cloud_in
     * \param[out] cloud_out the resultant output point cloud dataset
+    * \param[in] nr_threads the number of threads copying the points (0 uses all the cores, default: 1)
     * \note Assumes unique indices.
     * \ingroup common
     */
   template <typename PointT> void
   copyPointCloud (const pcl::PointCloud<PointT> &cloud_in,
                   const PointIndices &indices,
-                  pcl::PointCloud<PointT> &cloud_out);
+                  pcl::PointCloud<PointT> &cloud_out,
+                  unsigned int nr_threads = 1);
 
   /** \brief Extract the indices of a given point cloud as a new point cloud
     * \param[in] cloud_in the input point cloud dataset
     * \param[in] indices the vector of indices representing the points to be copied from \a cloud_in
     * \param[out] cloud_out the resultant output point cloud dataset
+    * \param[in] nr_threads the number of threads copying the points (0 uses all the cores, default: 1)
     * \note Assumes unique indices.
     * \ingroup common
     */
   template <typename PointT> void
   copyPointCloud (const pcl::PointCloud<PointT> &cloud_in,
                   const std::vector<pcl::PointIndices> &indices,
-                  pcl::PointCloud<PointT> &cloud_out);
+                  pcl::PointCloud<PointT> &cloud_out,
+                  unsigned int nr_threads = 1);
 
   /** \brief Copy all the fields from a given point cloud into a new point cloud
     * \param[in] cloud_in the input point cloud dataset
@@ -423,37 +433,43 @@ namespace pcl
     * \param[in] cloud_in the input point cloud dataset
     * \param[in] indices the vector of indices representing the points to be copied from \a cloud_in
     * \param[out] cloud_out the resultant output point cloud dataset
+    * \param[in] nr_threads the number of threads copying the points (0 uses all the cores, default: 1)
     * \note Assumes unique indices.
     * \ingroup common
     */
   template <typename PointInT, typename PointOutT, typename IndicesVectorAllocator = std::allocator<int>> void
   copyPointCloud (const pcl::PointCloud<PointInT> &cloud_in,
                   const IndicesAllocator<IndicesVectorAllocator> &indices,
-                  pcl::PointCloud<PointOutT> &cloud_out);
+                  pcl::PointCloud<PointOutT> &cloud_out,
+                  unsigned int nr_threads = 1);
 
   /** \brief Extract the indices of a given point cloud as a new point cloud
     * \param[in] cloud_in the input point cloud dataset
     * \param[in] indices the PointIndices structure representing the points to be copied from cloud_in
     * \param[out] cloud_out the resultant output point cloud dataset
+    * \param[in] nr_threads the number of threads copying the points (0 uses all the cores, default: 1)
     * \note Assumes unique indices.
     * \ingroup common
     */
   template <typename PointInT, typename PointOutT> void
   copyPointCloud (const pcl::PointCloud<PointInT> &cloud_in,
                   const PointIndices &indices,
-                  pcl::PointCloud<PointOutT> &cloud_out);
+                  pcl::PointCloud<PointOutT> &cloud_out,
+                  unsigned int nr_threads = 1);
 
   /** \brief Extract the indices of a given point cloud as a new point cloud
     * \param[in] cloud_in the input point cloud dataset
     * \param[in] indices the vector of indices representing the points to be copied from cloud_in
     * \param[out] cloud_out the resultant output point cloud dataset
+    * \param[in] nr_threads the number of threads copying the points (0 uses all the cores, default: 1)
     * \note Assumes unique indices.
     * \ingroup common
     */
   template <typename PointInT, typename PointOutT> void
   copyPointCloud (const pcl::PointCloud<PointInT> &cloud_in,
                   const std::vector<pcl::PointIndices> &indices,
-                  pcl::PointCloud<PointOutT> &cloud_out);
+                  pcl::PointCloud<PointOutT> &cloud_out,
+                  unsigned int nr_threads = 1);
 
   /** \brief Copy a point cloud inside a larger one interpolating borders.
     * \param[in] cloud_in the input point cloud dataset
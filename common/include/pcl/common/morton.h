@@ -0,0 +1,71 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved
+ */
+
+#pragma once
+
+#include <pcl/point_cloud.h>
+#include <pcl/types.h>
+
+#include <cstdint>
+
+namespace pcl
+{
+  /** \brief Interleave the bits of three 21 bit coordinates into a 63 bit Morton (Z-order) code, with x as the
+    * most significant bit of every level.
+    * \param[in] x the first coordinate
+    * \param[in] y the second coordinate
+    * \param[in] z the third coordinate
+    * \ingroup common
+    */
+  inline std::uint64_t
+  encodeMorton (std::uint32_t x, std::uint32_t y, std::uint32_t z);
+
+  /** \brief Order the points along the Morton (Z-order) curve of a grid of 2^21 cells per axis spanning their
+    * bounding box. Points which are close in space are then mostly close in the order, so that processing them in
+    * that order makes the neighbor queries hit the same parts of the search structure and of the cloud.
+    * The codes are computed in parallel and sorted with a radix sort, the points with the same code keep their
+    * order and the invalid points come last.
+    * \param[in] cloud the point cloud
+    * \param[in] indices the indices of the points in \a cloud to order, all the points if empty
+    * \param[out] order the positions in \a indices (or the indices of the points in \a cloud if \a indices is
+    * empty) in Morton order, a permutation of 0 to n-1
+    * \param[in] nr_threads the number of threads to compute the codes with (0 for automatic)
+    * \ingroup common
+    */
+  template <typename PointT> void
+  getMortonOrder (const pcl::PointCloud<PointT> &cloud, const Indices &indices, Indices &order,
+                  unsigned int nr_threads = 0);
+
+  /** \brief Order all the points of a cloud along the Morton (Z-order) curve, see the overload with indices.
+    * \param[in] cloud the point cloud
+    * \param[out] order the indices of the points in \a cloud in Morton order
+    * \param[in] nr_threads the number of threads to compute the codes with (0 for automatic)
+    * \ingroup common
+    */
+  template <typename PointT> inline void
+  getMortonOrder (const pcl::PointCloud<PointT> &cloud, Indices &order, unsigned int nr_threads = 0)
+  {
+    getMortonOrder (cloud, Indices (), order, nr_threads);
+  }
+
+  /** \brief Copy the points of a cloud in Morton (Z-order) order, e.g. a cloud read from a file or grabbed in
+    * acquisition order before computing features on it. The output cloud is not organized.
+    * \param[in] cloud_in the input point cloud
+    * \param[out] cloud_out the points of \a cloud_in in Morton order, cloud_out[i] = cloud_in[permutation[i]]
+    * \param[out] permutation the index in \a cloud_in of every point of \a cloud_out, which maps the results
+    * computed on \a cloud_out back to \a cloud_in
+    * \param[in] nr_threads the number of threads to compute the codes with (0 for automatic)
+    * \ingroup common
+    */
+  template <typename PointT> void
+  reorderPointCloudMorton (const pcl::PointCloud<PointT> &cloud_in, pcl::PointCloud<PointT> &cloud_out,
+                           Indices &permutation, unsigned int nr_threads = 0);
+}
+
+#include <pcl/common/impl/morton.hpp>
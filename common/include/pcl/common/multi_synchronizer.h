@@ -0,0 +1,381 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2014-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace pcl
+{
+  /** \brief Synchronizes N data streams of the same type, e.g. the clouds of several cameras.
+    *
+    * Data is added per stream with add (), together with a timestamp. Timestamps must be
+    * in the same unit for all streams and increasing within each stream. A set is formed
+    * from the newest of the oldest frames of the streams (the pivot) and, for every other
+    * stream, the frame closest in time to it, provided that it lies within the maximum
+    * time difference. A set is published as soon as no better match can arrive anymore,
+    * i.e. every stream already holds a frame at or after the pivot, or at the latest when
+    * the pivot has waited for the maximum latency.
+    *
+    * Frames that cannot be matched within the maximum latency after their arrival are
+    * dropped, so a stalled sensor delays the others by a bounded amount only.
+    *
+    * The registered callbacks run on a pool of worker threads: different callbacks run in
+    * parallel, while each single callback receives the sets one at a time and in order.
+    * If a callback falls behind, pending sets that exceeded the maximum latency are
+    * skipped in favor of the newest one.
+    *
+    * This class is thread safe.
+    * \ingroup common
+    */
+  template <typename T>
+  class MultiSynchronizer
+  {
+    public:
+      using CallbackFunction = std::function<void (const std::vector<T>&, const std::vector<unsigned long>&)>;
+      using Clock = std::chrono::steady_clock;
+
+      /** \brief Constructor.
+        * \param[in] num_streams the number of synchronized streams
+        * \param[in] max_time_difference the largest timestamp difference between frames of one set
+        * \param[in] max_latency how long a frame may wait to be published
+        * \param[in] num_threads the number of threads running the callbacks (0: one per hardware thread)
+        */
+      MultiSynchronizer (std::size_t num_streams,
+                         unsigned long max_time_difference,
+                         std::chrono::milliseconds max_latency = std::chrono::milliseconds (100),
+                         unsigned int num_threads = 1)
+        : queues_ (num_streams)
+        , max_time_difference_ (max_time_difference)
+        , max_latency_ (max_latency)
+        , callback_counter_ (0)
+        , dropped_frames_ (0)
+        , dropped_sets_ (0)
+        , stop_ (false)
+      {
+        if (num_threads == 0)
+          num_threads = std::max (1u, std::thread::hardware_concurrency ());
+        dispatcher_ = std::thread (&MultiSynchronizer::dispatch, this);
+        for (unsigned int i = 0; i < num_threads; ++i)
+          workers_.emplace_back (&MultiSynchronizer::work, this);
+      }
+
+      /** \brief Destructor. Stops all threads; sets not yet delivered are discarded. */
+      ~MultiSynchronizer ()
+      {
+        {
+          std::lock_guard<std::mutex> lock (mutex_);
+          stop_ = true;
+        }
+        dispatch_cond_.notify_all ();
+        work_cond_.notify_all ();
+        dispatcher_.join ();
+        for (auto &worker : workers_)
+          worker.join ();
+      }
+
+      MultiSynchronizer (const MultiSynchronizer&) = delete;
+      MultiSynchronizer& operator= (const MultiSynchronizer&) = delete;
+
+      /** \brief Register a callback invoked with the data and the timestamps of every set, ordered by stream.
+        * \return an id for removeCallback ()
+        */
+      int
+      addCallback (const CallbackFunction& callback)
+      {
+        std::lock_guard<std::mutex> lock (mutex_);
+        callbacks_[callback_counter_].function = callback;
+        return (callback_counter_++);
+      }
+
+      /** \brief Unregister a callback. A call that is already running finishes normally. */
+      void
+      removeCallback (int id)
+      {
+        std::lock_guard<std::mutex> lock (mutex_);
+        callbacks_.erase (id);
+      }
+
+      /** \brief Add a frame to a stream.
+        * \param[in] stream the stream index, smaller than the number of streams
+        * \param[in] data the frame
+        * \param[in] time the timestamp of the frame
+        */
+      void
+      add (std::size_t stream, const T& data, unsigned long time)
+      {
+        {
+          std::lock_guard<std::mutex> lock (mutex_);
+          if (stream >= queues_.size ())
+            return;
+          queues_[stream].push_back (Frame {time, Clock::now (), data});
+        }
+        dispatch_cond_.notify_one ();
+      }
+
+      /** \brief Get the number of frames dropped without being part of a set. */
+      std::size_t
+      getNumberOfDroppedFrames () const
+      {
+        std::lock_guard<std::mutex> lock (mutex_);
+        return (dropped_frames_);
+      }
+
+      /** \brief Get the number of sets skipped because a callback fell behind. */
+      std::size_t
+      getNumberOfDroppedSets () const
+      {
+        std::lock_guard<std::mutex> lock (mutex_);
+        return (dropped_sets_);
+      }
+
+    private:
+      struct Frame
+      {
+        unsigned long time;
+        Clock::time_point arrival;
+        T data;
+      };
+
+      struct Set
+      {
+        std::vector<T> data;
+        std::vector<unsigned long> times;
+        Clock::time_point ready;
+      };
+
+      struct CallbackState
+      {
+        CallbackFunction function;
+        std::deque<Set> pending;
+        bool busy = false;
+      };
+
+      static unsigned long
+      distance (unsigned long a, unsigned long b)
+      {
+        return (a > b ? a - b : b - a);
+      }
+
+      /** \brief Try to form one set from the queues. Expects mutex_ to be locked. */
+      bool
+      match (Clock::time_point now, Set &set)
+      {
+        while (true)
+        {
+          unsigned long pivot = 0;
+          std::size_t pivot_stream = 0;
+          for (std::size_t i = 0; i < queues_.size (); ++i)
+          {
+            if (queues_[i].empty ())
+              return (false);
+            if (i == 0 || queues_[i].front ().time > pivot)
+            {
+              pivot = queues_[i].front ().time;
+              pivot_stream = i;
+            }
+          }
+
+          // For every stream pick the frame closest to the pivot
+          std::vector<std::size_t> best (queues_.size ());
+          bool complete = true, settled = true;
+          Clock::time_point oldest_arrival = Clock::time_point::max ();
+          for (std::size_t i = 0; i < queues_.size () && complete; ++i)
+          {
+            const auto &queue = queues_[i];
+            std::size_t j = 0;
+            while (j + 1 < queue.size () && distance (queue[j + 1].time, pivot) <= distance (queue[j].time, pivot))
+              ++j;
+            best[i] = j;
+            complete = distance (queue[j].time, pivot) <= max_time_difference_;
+            // A later frame could still be closer if the best one lies before the pivot and is the last one
+            if (queue[j].time < pivot && j + 1 == queue.size ())
+              settled = false;
+            oldest_arrival = std::min (oldest_arrival, queue[j].arrival);
+          }
+
+          if (!complete)
+          {
+            // Some stream only has frames too old for the pivot, followed by frames too new for it.
+            // Later pivots are even newer, so drop the old frames and start over.
+            for (std::size_t i = 0; i < queues_.size (); ++i)
+            {
+              if (i == pivot_stream)
+                continue;
+              while (!queues_[i].empty () && queues_[i].front ().time + max_time_difference_ < pivot)
+              {
+                queues_[i].pop_front ();
+                ++dropped_frames_;
+              }
+            }
+            continue;
+          }
+
+          // Wait for a closer frame only as long as no frame of the set exceeds its latency
+          if (!settled && now < oldest_arrival + max_latency_)
+            return (false);
+
+          set.data.clear ();
+          set.times.clear ();
+          set.ready = now;
+          for (std::size_t i = 0; i < queues_.size (); ++i)
+          {
+            auto &queue = queues_[i];
+            set.data.push_back (queue[best[i]].data);
+            set.times.push_back (queue[best[i]].time);
+            dropped_frames_ += best[i];
+            queue.erase (queue.begin (), queue.begin () + best[i] + 1);
+          }
+          return (true);
+        }
+      }
+
+      /** \brief Drop frames that waited longer than the maximum latency. Expects mutex_ to be locked. */
+      void
+      dropExpired (Clock::time_point now)
+      {
+        for (auto &queue : queues_)
+        {
+          while (!queue.empty () && queue.front ().arrival + max_latency_ <= now)
+          {
+            queue.pop_front ();
+            ++dropped_frames_;
+          }
+        }
+      }
+
+      void
+      dispatch ()
+      {
+        std::unique_lock<std::mutex> lock (mutex_);
+        while (!stop_)
+        {
+          const Clock::time_point now = Clock::now ();
+          Set set;
+          bool published = false;
+          while (match (now, set))
+          {
+            for (auto &callback : callbacks_)
+              callback.second.pending.push_back (set);
+            published = true;
+          }
+          if (published)
+            work_cond_.notify_all ();
+          dropExpired (now);
+
+          // Sleep until new data arrives or the oldest frame reaches its deadline
+          Clock::time_point deadline = Clock::time_point::max ();
+          for (const auto &queue : queues_)
+            if (!queue.empty ())
+              deadline = std::min (deadline, queue.front ().arrival + max_latency_);
+          if (deadline == Clock::time_point::max ())
+            dispatch_cond_.wait (lock);
+          else
+            dispatch_cond_.wait_until (lock, deadline);
+        }
+      }
+
+      void
+      work ()
+      {
+        std::unique_lock<std::mutex> lock (mutex_);
+        while (true)
+        {
+          typename std::map<int, CallbackState>::iterator it;
+          work_cond_.wait (lock, [this, &it]
+          {
+            if (stop_)
+              return (true);
+            for (it = callbacks_.begin (); it != callbacks_.end (); ++it)
+              if (!it->second.busy && !it->second.pending.empty ())
+                return (true);
+            return (false);
+          });
+          if (stop_)
+            return;
+
+          const int id = it->first;
+          CallbackState &state = it->second;
+          const Clock::time_point now = Clock::now ();
+          while (state.pending.size () > 1 && state.pending.front ().ready + max_latency_ < now)
+          {
+            state.pending.pop_front ();
+            ++dropped_sets_;
+          }
+          Set set = std::move (state.pending.front ());
+          state.pending.pop_front ();
+          state.busy = true;
+          CallbackFunction function = state.function;
+
+          lock.unlock ();
+          if (function)
+            function (set.data, set.times);
+          lock.lock ();
+
+          const auto done = callbacks_.find (id);
+          if (done != callbacks_.end ())
+            done->second.busy = false;
+          work_cond_.notify_all ();
+        }
+      }
+
+      std::vector<std::deque<Frame> > queues_;
+      unsigned long max_time_difference_;
+      Clock::duration max_latency_;
+
+      std::map<int, CallbackState> callbacks_;
+      int callback_counter_;
+      std::size_t dropped_frames_;
+      std::size_t dropped_sets_;
+
+      mutable std::mutex mutex_;
+      std::condition_variable dispatch_cond_;
+      std::condition_variable work_cond_;
+      bool stop_;
+      std::thread dispatcher_;
+      std::vector<std::thread> workers_;
+  };
+} // namespace pcl
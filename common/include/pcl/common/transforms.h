@@ -40,6 +40,7 @@
 #pragma once
 
 #include <pcl/point_cloud.h>
+#include <pcl/point_cloud_soa.h>
 #include <pcl/point_types.h>
 #include <pcl/common/centroid.h>
 #include <pcl/common/eigen.h>
@@ -53,6 +54,7 @@ namespace pcl
     * \param[in] transform an affine transformation (typically a rigid transformation)
     * \param[in] copy_all_fields flag that controls whether the contents of the fields
     * (other than x, y, z) should be copied into the new transformed cloud
+    * \param[in] nr_threads the number of threads transforming the points (0 uses all the cores, default: 1)
     * \note Can be used with cloud_in equal to cloud_out
     * \ingroup common
     */
@@ -60,15 +62,17 @@ namespace pcl
   transformPointCloud (const pcl::PointCloud<PointT> &cloud_in, 
                        pcl::PointCloud<PointT> &cloud_out, 
                        const Eigen::Transform<Scalar, 3, Eigen::Affine> &transform,
-                       bool copy_all_fields = true);
+                       bool copy_all_fields = true,
+                       unsigned int nr_threads = 1);
 
   template <typename PointT> void 
   transformPointCloud (const pcl::PointCloud<PointT> &cloud_in, 
                        pcl::PointCloud<PointT> &cloud_out, 
                        const Eigen::Affine3f &transform,
-                       bool copy_all_fields = true)
+                       bool copy_all_fields = true,
+                       unsigned int nr_threads = 1)
   {
-    return (transformPointCloud<PointT, float> (cloud_in, cloud_out, transform, copy_all_fields));
+    return (transformPointCloud<PointT, float> (cloud_in, cloud_out, transform, copy_all_fields, nr_threads));
   }
 
   /** \brief Apply an affine transform defined by an Eigen Transform
@@ -78,6 +82,7 @@ namespace pcl
     * \param[in] transform an affine transformation (typically a rigid transformation)
     * \param[in] copy_all_fields flag that controls whether the contents of the fields
     * (other than x, y, z) should be copied into the new transformed cloud
+    * \param[in] nr_threads the number of threads transforming the points (0 uses all the cores, default: 1)
     * \ingroup common
     */
   template <typename PointT, typename Scalar> void 
@@ -85,16 +90,18 @@ namespace pcl
                        const Indices &indices,
                        pcl::PointCloud<PointT> &cloud_out, 
                        const Eigen::Transform<Scalar, 3, Eigen::Affine> &transform,
-                       bool copy_all_fields = true);
+                       bool copy_all_fields = true,
+                       unsigned int nr_threads = 1);
 
   template <typename PointT> void 
   transformPointCloud (const pcl::PointCloud<PointT> &cloud_in, 
                        const Indices &indices,
                        pcl::PointCloud<PointT> &cloud_out, 
                        const Eigen::Affine3f &transform,
-                       bool copy_all_fields = true)
+                       bool copy_all_fields = true,
+                       unsigned int nr_threads = 1)
   {
-    return (transformPointCloud<PointT, float> (cloud_in, indices, cloud_out, transform, copy_all_fields));
+    return (transformPointCloud<PointT, float> (cloud_in, indices, cloud_out, transform, copy_all_fields, nr_threads));
   }
 
   /** \brief Apply an affine transform defined by an Eigen Transform
@@ -104,6 +111,7 @@ namespace pcl
     * \param[in] transform an affine transformation (typically a rigid transformation)
     * \param[in] copy_all_fields flag that controls whether the contents of the fields
     * (other than x, y, z) should be copied into the new transformed cloud
+    * \param[in] nr_threads the number of threads transforming the points (0 uses all the cores, default: 1)
     * \ingroup common
     */
   template <typename PointT, typename Scalar> void 
@@ -111,9 +119,10 @@ namespace pcl
                        const pcl::PointIndices &indices,
                        pcl::PointCloud<PointT> &cloud_out, 
                        const Eigen::Transform<Scalar, 3, Eigen::Affine> &transform,
-                       bool copy_all_fields = true)
+                       bool copy_all_fields = true,
+                       unsigned int nr_threads = 1)
   {
-    return (transformPointCloud<PointT, Scalar> (cloud_in, indices.indices, cloud_out, transform, copy_all_fields));
+    return (transformPointCloud<PointT, Scalar> (cloud_in, indices.indices, cloud_out, transform, copy_all_fields, nr_threads));
   }
 
   template <typename PointT> void 
@@ -121,9 +130,10 @@ namespace pcl
                        const pcl::PointIndices &indices,
                        pcl::PointCloud<PointT> &cloud_out, 
                        const Eigen::Affine3f &transform,
-                       bool copy_all_fields = true)
+                       bool copy_all_fields = true,
+                       unsigned int nr_threads = 1)
   {
-    return (transformPointCloud<PointT, float> (cloud_in, indices, cloud_out, transform, copy_all_fields));
+    return (transformPointCloud<PointT, float> (cloud_in, indices, cloud_out, transform, copy_all_fields, nr_threads));
   }
 
   /** \brief Transform a point cloud and rotate its normals using an Eigen transform.
@@ -133,21 +143,24 @@ namespace pcl
     * \param[in] copy_all_fields flag that controls whether the contents of the fields
     * (other than x, y, z, normal_x, normal_y, normal_z) should be copied into the new
     * transformed cloud
+    * \param[in] nr_threads the number of threads transforming the points (0 uses all the cores, default: 1)
     * \note Can be used with cloud_in equal to cloud_out
     */
   template <typename PointT, typename Scalar> void 
   transformPointCloudWithNormals (const pcl::PointCloud<PointT> &cloud_in, 
                                   pcl::PointCloud<PointT> &cloud_out, 
                                   const Eigen::Transform<Scalar, 3, Eigen::Affine> &transform,
-                                  bool copy_all_fields = true);
+                                  bool copy_all_fields = true,
+                                  unsigned int nr_threads = 1);
 
   template <typename PointT> void 
   transformPointCloudWithNormals (const pcl::PointCloud<PointT> &cloud_in, 
                                   pcl::PointCloud<PointT> &cloud_out, 
                                   const Eigen::Affine3f &transform,
-                                  bool copy_all_fields = true)
+                                  bool copy_all_fields = true,
+                                  unsigned int nr_threads = 1)
   {
-    return (transformPointCloudWithNormals<PointT, float> (cloud_in, cloud_out, transform, copy_all_fields));
+    return (transformPointCloudWithNormals<PointT, float> (cloud_in, cloud_out, transform, copy_all_fields, nr_threads));
   }
 
   /** \brief Transform a point cloud and rotate its normals using an Eigen transform.
@@ -158,22 +171,25 @@ namespace pcl
     * \param[in] copy_all_fields flag that controls whether the contents of the fields
     * (other than x, y, z, normal_x, normal_y, normal_z) should be copied into the new
     * transformed cloud
+    * \param[in] nr_threads the number of threads transforming the points (0 uses all the cores, default: 1)
     */
   template <typename PointT, typename Scalar> void 
   transformPointCloudWithNormals (const pcl::PointCloud<PointT> &cloud_in, 
                                   const Indices &indices,
                                   pcl::PointCloud<PointT> &cloud_out, 
                                   const Eigen::Transform<Scalar, 3, Eigen::Affine> &transform,
-                                  bool copy_all_fields = true);
+                                  bool copy_all_fields = true,
+                                  unsigned int nr_threads = 1);
 
   template <typename PointT> void 
   transformPointCloudWithNormals (const pcl::PointCloud<PointT> &cloud_in, 
                                   const Indices &indices,
                                   pcl::PointCloud<PointT> &cloud_out, 
                                   const Eigen::Affine3f &transform,
-                                  bool copy_all_fields = true)
+                                  bool copy_all_fields = true,
+                                  unsigned int nr_threads = 1)
   {
-    return (transformPointCloudWithNormals<PointT, float> (cloud_in, indices, cloud_out, transform, copy_all_fields));
+    return (transformPointCloudWithNormals<PointT, float> (cloud_in, indices, cloud_out, transform, copy_all_fields, nr_threads));
   }
 
   /** \brief Transform a point cloud and rotate its normals using an Eigen transform.
@@ -184,15 +200,17 @@ namespace pcl
     * \param[in] copy_all_fields flag that controls whether the contents of the fields
     * (other than x, y, z, normal_x, normal_y, normal_z) should be copied into the new
     * transformed cloud
+    * \param[in] nr_threads the number of threads transforming the points (0 uses all the cores, default: 1)
     */
   template <typename PointT, typename Scalar> void 
   transformPointCloudWithNormals (const pcl::PointCloud<PointT> &cloud_in, 
                                   const pcl::PointIndices &indices,
                                   pcl::PointCloud<PointT> &cloud_out, 
                                   const Eigen::Transform<Scalar, 3, Eigen::Affine> &transform,
-                                  bool copy_all_fields = true)
+                                  bool copy_all_fields = true,
+                                  unsigned int nr_threads = 1)
   {
-    return (transformPointCloudWithNormals<PointT, Scalar> (cloud_in, indices.indices, cloud_out, transform, copy_all_fields));
+    return (transformPointCloudWithNormals<PointT, Scalar> (cloud_in, indices.indices, cloud_out, transform, copy_all_fields, nr_threads));
   }
 
 
@@ -201,9 +219,10 @@ namespace pcl
                                   const pcl::PointIndices &indices,
                                   pcl::PointCloud<PointT> &cloud_out, 
                                   const Eigen::Affine3f &transform,
-                                  bool copy_all_fields = true)
+                                  bool copy_all_fields = true,
+                                  unsigned int nr_threads = 1)
   {
-    return (transformPointCloudWithNormals<PointT, float> (cloud_in, indices, cloud_out, transform, copy_all_fields));
+    return (transformPointCloudWithNormals<PointT, float> (cloud_in, indices, cloud_out, transform, copy_all_fields, nr_threads));
   }
 
   /** \brief Apply a rigid transform defined by a 4x4 matrix
@@ -212,6 +231,7 @@ namespace pcl
     * \param[in] transform a rigid transformation 
     * \param[in] copy_all_fields flag that controls whether the contents of the fields
     * (other than x, y, z) should be copied into the new transformed cloud
+    * \param[in] nr_threads the number of threads transforming the points (0 uses all the cores, default: 1)
     * \note Can be used with cloud_in equal to cloud_out
     * \ingroup common
     */
@@ -219,19 +239,65 @@ namespace pcl
   transformPointCloud (const pcl::PointCloud<PointT> &cloud_in, 
                        pcl::PointCloud<PointT> &cloud_out, 
                        const Eigen::Matrix<Scalar, 4, 4> &transform,
-                       bool copy_all_fields = true)
+                       bool copy_all_fields = true,
+                       unsigned int nr_threads = 1)
   {
     Eigen::Transform<Scalar, 3, Eigen::Affine> t (transform);
-    return (transformPointCloud<PointT, Scalar> (cloud_in, cloud_out, t, copy_all_fields));
+    return (transformPointCloud<PointT, Scalar> (cloud_in, cloud_out, t, copy_all_fields, nr_threads));
   }
 
   template <typename PointT> void 
   transformPointCloud (const pcl::PointCloud<PointT> &cloud_in, 
                        pcl::PointCloud<PointT> &cloud_out, 
                        const Eigen::Matrix4f &transform,
-                       bool copy_all_fields = true)
+                       bool copy_all_fields = true,
+                       unsigned int nr_threads = 1)
   {
-    return (transformPointCloud<PointT, float> (cloud_in, cloud_out, transform, copy_all_fields));
+    return (transformPointCloud<PointT, float> (cloud_in, cloud_out, transform, copy_all_fields, nr_threads));
+  }
+
+  /** \brief Apply an affine transform to the coordinates stored in a structure of arrays
+    * \param[in] cloud_in the input coordinates
+    * \param[out] cloud_out the resultant transformed coordinates (with the indices of \a cloud_in)
+    * \param[in] transform an affine transformation (typically a rigid transformation)
+    * \note Can be used with cloud_in equal to cloud_out
+    * \ingroup common
+    */
+  template <typename Scalar> void
+  transformPointCloud (const pcl::PointCloudSoA &cloud_in,
+                       pcl::PointCloudSoA &cloud_out,
+                       const Eigen::Transform<Scalar, 3, Eigen::Affine> &transform);
+
+  inline void
+  transformPointCloud (const pcl::PointCloudSoA &cloud_in,
+                       pcl::PointCloudSoA &cloud_out,
+                       const Eigen::Affine3f &transform)
+  {
+    return (transformPointCloud<float> (cloud_in, cloud_out, transform));
+  }
+
+  /** \brief Apply a rigid transform defined by a 4x4 matrix to the coordinates stored in a structure of arrays
+    * \param[in] cloud_in the input coordinates
+    * \param[out] cloud_out the resultant transformed coordinates (with the indices of \a cloud_in)
+    * \param[in] transform a rigid transformation
+    * \note Can be used with cloud_in equal to cloud_out
+    * \ingroup common
+    */
+  template <typename Scalar> void
+  transformPointCloud (const pcl::PointCloudSoA &cloud_in,
+                       pcl::PointCloudSoA &cloud_out,
+                       const Eigen::Matrix<Scalar, 4, 4> &transform)
+  {
+    Eigen::Transform<Scalar, 3, Eigen::Affine> t (transform);
+    return (transformPointCloud<Scalar> (cloud_in, cloud_out, t));
+  }
+
+  inline void
+  transformPointCloud (const pcl::PointCloudSoA &cloud_in,
+                       pcl::PointCloudSoA &cloud_out,
+                       const Eigen::Matrix4f &transform)
+  {
+    return (transformPointCloud<float> (cloud_in, cloud_out, transform));
   }
 
   /** \brief Apply a rigid transform defined by a 4x4 matrix
@@ -241,6 +307,7 @@ namespace pcl
     * \param[in] transform a rigid transformation 
     * \param[in] copy_all_fields flag that controls whether the contents of the fields
     * (other than x, y, z) should be copied into the new transformed cloud
+    * \param[in] nr_threads the number of threads transforming the points (0 uses all the cores, default: 1)
     * \ingroup common
     */
   template <typename PointT, typename Scalar> void 
@@ -248,10 +315,11 @@ namespace pcl
                        const Indices &indices,
                        pcl::PointCloud<PointT> &cloud_out, 
                        const Eigen::Matrix<Scalar, 4, 4> &transform,
-                       bool copy_all_fields = true)
+                       bool copy_all_fields = true,
+                       unsigned int nr_threads = 1)
   {
     Eigen::Transform<Scalar, 3, Eigen::Affine> t (transform);
-    return (transformPointCloud<PointT, Scalar> (cloud_in, indices, cloud_out, t, copy_all_fields));
+    return (transformPointCloud<PointT, Scalar> (cloud_in, indices, cloud_out, t, copy_all_fields, nr_threads));
   }
 
   template <typename PointT> void 
@@ -259,9 +327,10 @@ namespace pcl
                        const Indices &indices,
                        pcl::PointCloud<PointT> &cloud_out, 
                        const Eigen::Matrix4f &transform,
-                       bool copy_all_fields = true)
+                       bool copy_all_fields = true,
+                       unsigned int nr_threads = 1)
   {
-    return (transformPointCloud<PointT, float> (cloud_in, indices, cloud_out, transform, copy_all_fields));
+    return (transformPointCloud<PointT, float> (cloud_in, indices, cloud_out, transform, copy_all_fields, nr_threads));
   }
 
   /** \brief Apply a rigid transform defined by a 4x4 matrix
@@ -271,6 +340,7 @@ namespace pcl
     * \param[in] transform a rigid transformation 
     * \param[in] copy_all_fields flag that controls whether the contents of the fields
     * (other than x, y, z) should be copied into the new transformed cloud
+    * \param[in] nr_threads the number of threads transforming the points (0 uses all the cores, default: 1)
     * \ingroup common
     */
   template <typename PointT, typename Scalar> void 
@@ -278,9 +348,10 @@ namespace pcl
                        const pcl::PointIndices &indices,
                        pcl::PointCloud<PointT> &cloud_out, 
                        const Eigen::Matrix<Scalar, 4, 4> &transform,
-                       bool copy_all_fields = true)
+                       bool copy_all_fields = true,
+                       unsigned int nr_threads = 1)
   {
-    return (transformPointCloud<PointT, Scalar> (cloud_in, indices.indices, cloud_out, transform, copy_all_fields));
+    return (transformPointCloud<PointT, Scalar> (cloud_in, indices.indices, cloud_out, transform, copy_all_fields, nr_threads));
   }
 
   template <typename PointT> void 
@@ -288,9 +359,10 @@ namespace pcl
                        const pcl::PointIndices &indices,
                        pcl::PointCloud<PointT> &cloud_out, 
                        const Eigen::Matrix4f &transform,
-                       bool copy_all_fields = true)
+                       bool copy_all_fields = true,
+                       unsigned int nr_threads = 1)
   {
-    return (transformPointCloud<PointT, float> (cloud_in, indices, cloud_out, transform, copy_all_fields));
+    return (transformPointCloud<PointT, float> (cloud_in, indices, cloud_out, transform, copy_all_fields, nr_threads));
   }
 
   /** \brief Transform a point cloud and rotate its normals using an Eigen transform.
@@ -300,6 +372,7 @@ namespace pcl
     * \param[in] copy_all_fields flag that controls whether the contents of the fields
     * (other than x, y, z, normal_x, normal_y, normal_z) should be copied into the new
     * transformed cloud
+    * \param[in] nr_threads the number of threads transforming the points (0 uses all the cores, default: 1)
     * \note Can be used with cloud_in equal to cloud_out
     * \ingroup common
     */
@@ -307,10 +380,11 @@ namespace pcl
   transformPointCloudWithNormals (const pcl::PointCloud<PointT> &cloud_in, 
                                   pcl::PointCloud<PointT> &cloud_out, 
                                   const Eigen::Matrix<Scalar, 4, 4> &transform,
-                                  bool copy_all_fields = true)
+                                  bool copy_all_fields = true,
+                                  unsigned int nr_threads = 1)
   {
     Eigen::Transform<Scalar, 3, Eigen::Affine> t (transform);
-    return (transformPointCloudWithNormals<PointT, Scalar> (cloud_in, cloud_out, t, copy_all_fields));
+    return (transformPointCloudWithNormals<PointT, Scalar> (cloud_in, cloud_out, t, copy_all_fields, nr_threads));
   }
 
 
@@ -318,9 +392,10 @@ namespace pcl
   transformPointCloudWithNormals (const pcl::PointCloud<PointT> &cloud_in, 
                                   pcl::PointCloud<PointT> &cloud_out, 
                                   const Eigen::Matrix4f &transform,
-                                  bool copy_all_fields = true)
+                                  bool copy_all_fields = true,
+                                  unsigned int nr_threads = 1)
   {
-    return (transformPointCloudWithNormals<PointT, float> (cloud_in, cloud_out, transform, copy_all_fields));
+    return (transformPointCloudWithNormals<PointT, float> (cloud_in, cloud_out, transform, copy_all_fields, nr_threads));
   }
 
   /** \brief Transform a point cloud and rotate its normals using an Eigen transform.
@@ -331,6 +406,7 @@ namespace pcl
     * \param[in] copy_all_fields flag that controls whether the contents of the fields
     * (other than x, y, z, normal_x, normal_y, normal_z) should be copied into the new
     * transformed cloud
+    * \param[in] nr_threads the number of threads transforming the points (0 uses all the cores, default: 1)
     * \note Can be used with cloud_in equal to cloud_out
     * \ingroup common
     */
@@ -339,10 +415,11 @@ namespace pcl
                                   const Indices &indices,
                                   pcl::PointCloud<PointT> &cloud_out, 
                                   const Eigen::Matrix<Scalar, 4, 4> &transform,
-                                  bool copy_all_fields = true)
+                                  bool copy_all_fields = true,
+                                  unsigned int nr_threads = 1)
   {
     Eigen::Transform<Scalar, 3, Eigen::Affine> t (transform);
-    return (transformPointCloudWithNormals<PointT, Scalar> (cloud_in, indices, cloud_out, t, copy_all_fields));
+    return (transformPointCloudWithNormals<PointT, Scalar> (cloud_in, indices, cloud_out, t, copy_all_fields, nr_threads));
   }
 
 
@@ -351,9 +428,10 @@ namespace pcl
                                   const Indices &indices,
                                   pcl::PointCloud<PointT> &cloud_out, 
                                   const Eigen::Matrix4f &transform,
-                                  bool copy_all_fields = true)
+                                  bool copy_all_fields = true,
+                                  unsigned int nr_threads = 1)
   {
-    return (transformPointCloudWithNormals<PointT, float> (cloud_in, indices, cloud_out, transform, copy_all_fields));
+    return (transformPointCloudWithNormals<PointT, float> (cloud_in, indices, cloud_out, transform, copy_all_fields, nr_threads));
   }
 
   /** \brief Transform a point cloud and rotate its normals using an Eigen transform.
@@ -364,6 +442,7 @@ namespace pcl
     * \param[in] copy_all_fields flag that controls whether the contents of the fields
     * (other than x, y, z, normal_x, normal_y, normal_z) should be copied into the new
     * transformed cloud
+    * \param[in] nr_threads the number of threads transforming the points (0 uses all the cores, default: 1)
     * \note Can be used with cloud_in equal to cloud_out
     * \ingroup common
     */
@@ -372,10 +451,11 @@ namespace pcl
                                   const pcl::PointIndices &indices,
                                   pcl::PointCloud<PointT> &cloud_out, 
                                   const Eigen::Matrix<Scalar, 4, 4> &transform,
-                                  bool copy_all_fields = true)
+                                  bool copy_all_fields = true,
+                                  unsigned int nr_threads = 1)
   {
     Eigen::Transform<Scalar, 3, Eigen::Affine> t (transform);
-    return (transformPointCloudWithNormals<PointT, Scalar> (cloud_in, indices, cloud_out, t, copy_all_fields));
+    return (transformPointCloudWithNormals<PointT, Scalar> (cloud_in, indices, cloud_out, t, copy_all_fields, nr_threads));
   }
 
 
@@ -384,9 +464,10 @@ namespace pcl
                                   const pcl::PointIndices &indices,
                                   pcl::PointCloud<PointT> &cloud_out, 
                                   const Eigen::Matrix4f &transform,
-                                  bool copy_all_fields = true)
+                                  bool copy_all_fields = true,
+                                  unsigned int nr_threads = 1)
   {
-    return (transformPointCloudWithNormals<PointT, float> (cloud_in, indices, cloud_out, transform, copy_all_fields));
+    return (transformPointCloudWithNormals<PointT, float> (cloud_in, indices, cloud_out, transform, copy_all_fields, nr_threads));
   }
 
   /** \brief Apply a rigid transform defined by a 3D offset and a quaternion
@@ -396,6 +477,7 @@ namespace pcl
     * \param[in] rotation the rotation component of the rigid transformation
     * \param[in] copy_all_fields flag that controls whether the contents of the fields
     * (other than x, y, z) should be copied into the new transformed cloud
+    * \param[in] nr_threads the number of threads transforming the points (0 uses all the cores, default: 1)
     * \ingroup common
     */
   template <typename PointT, typename Scalar> inline void 
@@ -403,16 +485,18 @@ namespace pcl
                        pcl::PointCloud<PointT> &cloud_out, 
                        const Eigen::Matrix<Scalar, 3, 1> &offset, 
                        const Eigen::Quaternion<Scalar> &rotation,
-                       bool copy_all_fields = true);
+                       bool copy_all_fields = true,
+                       unsigned int nr_threads = 1);
 
   template <typename PointT> inline void 
   transformPointCloud (const pcl::PointCloud<PointT> &cloud_in, 
                        pcl::PointCloud<PointT> &cloud_out, 
                        const Eigen::Vector3f &offset, 
                        const Eigen::Quaternionf &rotation,
-                       bool copy_all_fields = true)
+                       bool copy_all_fields = true,
+                       unsigned int nr_threads = 1)
   {
-    return (transformPointCloud<PointT, float> (cloud_in, cloud_out, offset, rotation, copy_all_fields));
+    return (transformPointCloud<PointT, float> (cloud_in, cloud_out, offset, rotation, copy_all_fields, nr_threads));
   }
 
   /** \brief Transform a point cloud and rotate its normals using an Eigen transform.
@@ -423,6 +507,7 @@ namespace pcl
     * \param[in] copy_all_fields flag that controls whether the contents of the fields
     * (other than x, y, z, normal_x, normal_y, normal_z) should be copied into the new
     * transformed cloud
+    * \param[in] nr_threads the number of threads transforming the points (0 uses all the cores, default: 1)
     * \ingroup common
     */
   template <typename PointT, typename Scalar> inline void 
@@ -430,16 +515,18 @@ namespace pcl
                                   pcl::PointCloud<PointT> &cloud_out, 
                                   const Eigen::Matrix<Scalar, 3, 1> &offset, 
                                   const Eigen::Quaternion<Scalar> &rotation,
-                                  bool copy_all_fields = true);
+                                  bool copy_all_fields = true,
+                                  unsigned int nr_threads = 1);
 
   template <typename PointT> void 
   transformPointCloudWithNormals (const pcl::PointCloud<PointT> &cloud_in, 
                                   pcl::PointCloud<PointT> &cloud_out, 
                                   const Eigen::Vector3f &offset, 
                                   const Eigen::Quaternionf &rotation,
-                                  bool copy_all_fields = true)
+                                  bool copy_all_fields = true,
+                                  unsigned int nr_threads = 1)
   {
-    return (transformPointCloudWithNormals<PointT, float> (cloud_in, cloud_out, offset, rotation, copy_all_fields));
+    return (transformPointCloudWithNormals<PointT, float> (cloud_in, cloud_out, offset, rotation, copy_all_fields, nr_threads));
   }
 
   /** \brief Transform a point with members x,y,z
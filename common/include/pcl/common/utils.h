@@ -38,9 +38,16 @@
 
 #pragma once
 
+#include <pcl/pcl_exports.h>
+
+#include <algorithm>
 #include <cmath>
 #include <limits>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace pcl
 {
   namespace utils
@@ -62,5 +69,69 @@ namespace pcl
     ignore(const T&...)
     {
     }
+
+    /** \brief Set the maximum number of threads a parallel algorithm runs with, for all the threads of the process.
+      *
+      * The parallel algorithms of PCL cap the number of threads they were configured with to this limit, so that
+      * an application running many algorithms concurrently, e.g. from the worker threads of a service, does not
+      * oversubscribe the cores. A ScopedMaxNumberOfThreads overrides it for a single calling thread.
+      * \param[in] nr_threads the maximum number of threads, 0 meaning no limit (default)
+      */
+    PCL_EXPORTS void
+    setMaxNumberOfThreads (unsigned int nr_threads);
+
+    /** \brief Get the maximum number of threads a parallel algorithm called from this thread runs with
+      * \return the limit of the innermost ScopedMaxNumberOfThreads of this thread if any, the limit set with
+      * setMaxNumberOfThreads otherwise, 0 meaning no limit
+      */
+    PCL_EXPORTS unsigned int
+    getMaxNumberOfThreads ();
+
+    /** \brief Overrides the maximum number of threads of the parallel algorithms called from the current thread,
+      * until it goes out of scope, e.g. to run the algorithms of each worker of a thread pool serially.
+      */
+    class PCL_EXPORTS ScopedMaxNumberOfThreads
+    {
+      public:
+        /** \brief Constructor
+          * \param[in] nr_threads the maximum number of threads, 0 meaning no limit
+          */
+        explicit ScopedMaxNumberOfThreads (unsigned int nr_threads);
+
+        /** \brief Destructor, restores the previous limit of the current thread. */
+        ~ScopedMaxNumberOfThreads ();
+
+        ScopedMaxNumberOfThreads (const ScopedMaxNumberOfThreads&) = delete;
+        ScopedMaxNumberOfThreads&
+        operator= (const ScopedMaxNumberOfThreads&) = delete;
+
+      private:
+        /** \brief The limit of the current thread before this one, if any. */
+        bool previous_set_;
+        unsigned int previous_nr_threads_;
+    };
+
+    /** \brief Get the number of threads an OpenMP loop runs with for a requested number of threads
+      *
+      * The number of threads is capped to getMaxNumberOfThreads, and a loop nested in a parallel region runs
+      * serially, as its threads would multiply with the ones of the enclosing region.
+      * \param[in] nr_threads the requested number of threads, 0 meaning all the cores
+      * \return 1 if PCL is compiled without OpenMP, the requested number of threads within the limits otherwise
+      */
+    inline unsigned int
+    getNumberOfThreads (unsigned int nr_threads)
+    {
+#ifdef _OPENMP
+      if (omp_in_parallel ())
+        return (1);
+      if (nr_threads == 0)
+        nr_threads = static_cast<unsigned int> (omp_get_num_procs ());
+      const unsigned int max_nr_threads = getMaxNumberOfThreads ();
+      return (max_nr_threads == 0 ? nr_threads : (std::min) (nr_threads, max_nr_threads));
+#else
+      ignore (nr_threads);
+      return (1);
+#endif
+    }
   } // namespace utils
 } // namespace pcl
@@ -0,0 +1,514 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved
+ */
+
+#pragma once
+
+#include <pcl/common/utils.h> // for pcl::utils::getNumberOfThreads
+#include <pcl/console/print.h>
+#include <pcl/memory.h>
+#include <pcl/pcl_macros.h>
+#include <pcl/point_cloud.h>
+#include <pcl/point_types.h>
+#include <pcl/types.h>
+
+#include <Eigen/Core>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+namespace pcl
+{
+  /** \brief Convert a float into an IEEE 754 half precision float, rounding to the nearest even value.
+    * \param[in] value the single precision value
+    * \return the bits of the half precision value
+    * \ingroup common
+    */
+  inline std::uint16_t
+  floatToHalf (float value)
+  {
+    std::uint32_t bits;
+    std::memcpy (&bits, &value, sizeof (bits));
+    const auto sign = static_cast<std::uint16_t> ((bits >> 16) & 0x8000u);
+    const std::uint32_t magnitude = bits & 0x7fffffffu;
+
+    // Infinity and NaN, keeping NaNs quiet
+    if (magnitude >= 0x7f800000u)
+      return (static_cast<std::uint16_t> (sign | 0x7c00u | (magnitude > 0x7f800000u ? 0x200u : 0u)));
+    // Too large, rounds to infinity
+    if (magnitude >= 0x477ff000u)
+      return (static_cast<std::uint16_t> (sign | 0x7c00u));
+    // Subnormal half, or zero below 2^-25
+    if (magnitude < 0x38800000u)
+    {
+      if (magnitude < 0x33000000u)
+        return (sign);
+      const std::uint32_t shift = 126u - (magnitude >> 23);
+      const std::uint32_t mantissa = (magnitude & 0x7fffffu) | 0x800000u;
+      std::uint32_t half = mantissa >> shift;
+      const std::uint32_t rest = mantissa & ((1u << shift) - 1u);
+      const std::uint32_t halfway = 1u << (shift - 1u);
+      if (rest > halfway || (rest == halfway && (half & 1u)))
+        ++half;
+      return (static_cast<std::uint16_t> (sign | half));
+    }
+    // Normal half: rebias the exponent and round the mantissa, a carry correctly increments the exponent
+    std::uint32_t half = (magnitude - 0x38000000u) >> 13;
+    const std::uint32_t rest = magnitude & 0x1fffu;
+    if (rest > 0x1000u || (rest == 0x1000u && (half & 1u)))
+      ++half;
+    return (static_cast<std::uint16_t> (sign | half));
+  }
+
+  /** \brief Convert an IEEE 754 half precision float into a float, exactly.
+    * \param[in] half the bits of the half precision value
+    * \return the single precision value
+    * \ingroup common
+    */
+  inline float
+  halfToFloat (std::uint16_t half)
+  {
+    const std::uint32_t sign = static_cast<std::uint32_t> (half & 0x8000u) << 16;
+    const std::uint32_t exponent = (half >> 10) & 0x1fu;
+    std::uint32_t mantissa = half & 0x3ffu;
+    std::uint32_t bits;
+    if (exponent == 0x1fu)
+      bits = sign | 0x7f800000u | (mantissa << 13);
+    else if (exponent != 0)
+      bits = sign | ((exponent + 112u) << 23) | (mantissa << 13);
+    else if (mantissa == 0)
+      bits = sign;
+    else
+    {
+      // Subnormal half, normal float
+      std::uint32_t float_exponent = 113u;
+      while (!(mantissa & 0x400u))
+      {
+        mantissa <<= 1;
+        --float_exponent;
+      }
+      bits = sign | (float_exponent << 23) | ((mantissa & 0x3ffu) << 13);
+    }
+    float value;
+    std::memcpy (&value, &bits, sizeof (value));
+    return (value);
+  }
+
+  /** \brief CompactPointCloud stores the points of a cloud with a fraction of the memory of pcl::PointCloud.
+    *
+    * The xyz point types of PCL are padded to 16 bytes, and e.g. pcl::PointXYZRGBNormal takes 48 bytes. A
+    * CompactPointCloud keeps the coordinates as 3 packed values of type \a CoordinateT per point:
+    *  - float (see pcl::PackedPointCloud): 12 bytes, the coordinates are stored exactly;
+    *  - std::int32_t or std::int16_t (see pcl::QuantizedPointCloud32 and pcl::QuantizedPointCloud16): 12 or
+    *    6 bytes, the coordinates are quantized to multiples of a resolution around an offset shared by the
+    *    whole cloud, so the error on every coordinate is at most half the resolution.
+    *
+    * Optionally the normals are kept as half precision floats (6 bytes) and the colors as packed rgba (4
+    * bytes), so e.g. a pcl::PointXYZRGBNormal cloud shrinks from 48 to 16 bytes per point with 16 bit
+    * coordinates. The other fields are dropped.
+    *
+    * The points are decoded on the fly into any point type (see \ref getPoint and \ref decode).
+    * pcl::KdTreeFLANN and pcl::VoxelGrid accept a CompactPointCloud directly and decode it point by point,
+    * without ever holding a decoded copy of the whole cloud.
+    *
+    * \ingroup common
+    */
+  template <typename CoordinateT>
+  class CompactPointCloud
+  {
+    static_assert (std::is_same<CoordinateT, float>::value ||
+                   std::is_same<CoordinateT, std::int32_t>::value ||
+                   std::is_same<CoordinateT, std::int16_t>::value,
+                   "The coordinates of a CompactPointCloud are float, std::int32_t or std::int16_t");
+
+    public:
+      using Ptr = shared_ptr<CompactPointCloud<CoordinateT> >;
+      using ConstPtr = shared_ptr<const CompactPointCloud<CoordinateT> >;
+
+      /** \brief Empty constructor. */
+      CompactPointCloud () = default;
+
+      /** \brief Encode the points of a cloud, replacing the content of this cloud.
+        * \param[in] cloud the input cloud
+        * \param[in] resolution the quantization step of the coordinates, ignored for float coordinates. 0 picks
+        * the finest resolution for which the bounding box of the cloud fits into the range of \a CoordinateT.
+        * \param[in] with_normals keep the normals, if PointT has any
+        * \param[in] with_colors keep the colors, if PointT has any
+        * \return false if the bounding box of the cloud does not fit into the range of \a CoordinateT with the
+        * given resolution, in which case the cloud is left empty
+        */
+      template <typename PointT> bool
+      assign (const pcl::PointCloud<PointT> &cloud, float resolution = 0.0f,
+              bool with_normals = true, bool with_colors = true)
+      {
+        clear ();
+        header = cloud.header;
+        if (!setQuantization (cloud, resolution))
+          return (false);
+
+        const std::size_t nr_points = cloud.size ();
+        xyz_.resize (3 * nr_points);
+        is_dense_ = true;
+        for (std::size_t i = 0; i < nr_points; ++i)
+          is_dense_ &= encodeXYZ (cloud[i], &xyz_[3 * i]);
+        if (with_normals)
+          encodeNormals (cloud);
+        if (with_colors)
+          encodeColors (cloud);
+        return (true);
+      }
+
+      /** \brief Remove all the points. */
+      inline void
+      clear ()
+      {
+        xyz_.clear ();
+        normals_.clear ();
+        colors_.clear ();
+        is_dense_ = true;
+      }
+
+      /** \brief Get the number of points. */
+      inline std::size_t
+      size () const { return (xyz_.size () / 3); }
+
+      /** \brief Whether the cloud holds no points. */
+      inline bool
+      empty () const { return (xyz_.empty ()); }
+
+      /** \brief Whether all the points have finite coordinates. */
+      inline bool
+      isDense () const { return (is_dense_); }
+
+      /** \brief Whether the normals of the points are stored. */
+      inline bool
+      hasNormals () const { return (!normals_.empty ()); }
+
+      /** \brief Whether the colors of the points are stored. */
+      inline bool
+      hasColors () const { return (!colors_.empty ()); }
+
+      /** \brief Get the quantization step of the coordinates (1 for float coordinates). */
+      inline float
+      getResolution () const { return (resolution_); }
+
+      /** \brief Get the point that the quantized coordinates are relative to (the origin for float coordinates). */
+      inline const Eigen::Vector3f&
+      getOffset () const { return (offset_); }
+
+      /** \brief Get the number of bytes used per point. */
+      inline std::size_t
+      getBytesPerPoint () const
+      {
+        return (3 * sizeof (CoordinateT) + (hasNormals () ? 3 * sizeof (std::uint16_t) : 0) +
+                (hasColors () ? sizeof (std::uint32_t) : 0));
+      }
+
+      /** \brief Whether the i-th point has finite coordinates. */
+      inline bool
+      isValid (std::size_t i) const { return (isValidCoordinate (xyz_[3 * i])); }
+
+      /** \brief Get the coordinates of the i-th point, NaN for an invalid point. */
+      inline Eigen::Vector3f
+      getXYZ (std::size_t i) const
+      {
+        const CoordinateT *xyz = &xyz_[3 * i];
+        if (!isValidCoordinate (xyz[0]))
+          return (Eigen::Vector3f::Constant (std::numeric_limits<float>::quiet_NaN ()));
+        return (Eigen::Vector3f (decodeCoordinate (xyz[0], 0), decodeCoordinate (xyz[1], 1),
+                                 decodeCoordinate (xyz[2], 2)));
+      }
+
+      /** \brief Get the normal of the i-th point (only if \ref hasNormals). */
+      inline Eigen::Vector3f
+      getNormal (std::size_t i) const
+      {
+        return (Eigen::Vector3f (halfToFloat (normals_[3 * i]), halfToFloat (normals_[3 * i + 1]),
+                                 halfToFloat (normals_[3 * i + 2])));
+      }
+
+      /** \brief Get the packed rgba color of the i-th point (only if \ref hasColors). */
+      inline std::uint32_t
+      getRGBA (std::size_t i) const { return (colors_[i]); }
+
+      /** \brief Decode the i-th point. The coordinates, and the normal and color if both this cloud and PointT
+        * have them, are set, the other fields keep their default values.
+        */
+      template <typename PointT> inline PointT
+      getPoint (std::size_t i) const
+      {
+        PointT point;
+        const Eigen::Vector3f xyz = getXYZ (i);
+        point.x = xyz[0];
+        point.y = xyz[1];
+        point.z = xyz[2];
+        decodeNormal (i, point);
+        decodeColor (i, point);
+        return (point);
+      }
+
+      /** \brief Decode all the points into a point cloud.
+        * \param[out] cloud the decoded cloud
+        * \param[in] nr_threads the number of threads decoding the points (0 uses all the cores, default: 1)
+        */
+      template <typename PointT> void
+      decode (pcl::PointCloud<PointT> &cloud, unsigned int nr_threads = 1) const
+      {
+        cloud.header = header;
+        cloud.width = static_cast<std::uint32_t> (size ());
+        cloud.height = 1;
+        cloud.is_dense = is_dense_;
+        cloud.points.resize (size ());
+        const auto nr_points = static_cast<std::ptrdiff_t> (size ());
+        pcl::utils::ignore (nr_threads);
+#pragma omp parallel for \
+  default(none) \
+  shared(cloud, nr_points) \
+  num_threads(pcl::utils::getNumberOfThreads (nr_threads)) \
+  schedule(static)
+        for (std::ptrdiff_t i = 0; i < nr_points; ++i)
+          cloud[i] = getPoint<PointT> (i);
+      }
+
+      /** \brief Decode a subset of the points into a point cloud.
+        * \param[in] indices the indices of the points to decode
+        * \param[out] cloud the decoded cloud, with one point per index
+        * \param[in] nr_threads the number of threads decoding the points (0 uses all the cores, default: 1)
+        */
+      template <typename PointT> void
+      decode (const Indices &indices, pcl::PointCloud<PointT> &cloud, unsigned int nr_threads = 1) const
+      {
+        cloud.header = header;
+        cloud.width = static_cast<std::uint32_t> (indices.size ());
+        cloud.height = 1;
+        cloud.is_dense = is_dense_;
+        cloud.points.resize (indices.size ());
+        const auto nr_points = static_cast<std::ptrdiff_t> (indices.size ());
+        pcl::utils::ignore (nr_threads);
+#pragma omp parallel for \
+  default(none) \
+  shared(cloud, indices, nr_points) \
+  num_threads(pcl::utils::getNumberOfThreads (nr_threads)) \
+  schedule(static)
+        for (std::ptrdiff_t i = 0; i < nr_points; ++i)
+          cloud[i] = getPoint<PointT> (indices[i]);
+      }
+
+      /** \brief Get the bounding box of the valid points, computed on the stored coordinates.
+        * \param[out] min_pt the minimum corner, with 0 as fourth coordinate
+        * \param[out] max_pt the maximum corner, with 0 as fourth coordinate
+        * \return false if there is no valid point
+        */
+      bool
+      getMinMax3D (Eigen::Vector4f &min_pt, Eigen::Vector4f &max_pt) const
+      {
+        CoordinateT min_q[3], max_q[3];
+        for (int d = 0; d < 3; ++d)
+        {
+          min_q[d] = std::numeric_limits<CoordinateT>::max ();
+          max_q[d] = std::numeric_limits<CoordinateT>::lowest ();
+        }
+        bool found = false;
+        for (std::size_t i = 0; i < size (); ++i)
+        {
+          const CoordinateT *xyz = &xyz_[3 * i];
+          if (!isValidCoordinate (xyz[0]) || !isFiniteCoordinate (xyz[1]) || !isFiniteCoordinate (xyz[2]))
+            continue;
+          found = true;
+          for (int d = 0; d < 3; ++d)
+          {
+            min_q[d] = (std::min) (min_q[d], xyz[d]);
+            max_q[d] = (std::max) (max_q[d], xyz[d]);
+          }
+        }
+        if (!found)
+          return (false);
+        for (int d = 0; d < 3; ++d)
+        {
+          min_pt[d] = decodeCoordinate (min_q[d], d);
+          max_pt[d] = decodeCoordinate (max_q[d], d);
+        }
+        min_pt[3] = max_pt[3] = 0.0f;
+        return (true);
+      }
+
+      /** \brief The header of the encoded cloud. */
+      pcl::PCLHeader header;
+
+    private:
+      static constexpr bool is_float = std::is_floating_point<CoordinateT>::value;
+
+      /** \brief The value marking an invalid point in the x coordinate of quantized clouds. */
+      static constexpr CoordinateT invalid_value = std::numeric_limits<CoordinateT>::lowest ();
+
+      inline static bool
+      isValidCoordinate (CoordinateT value)
+      {
+        return (is_float ? std::isfinite (static_cast<float> (value)) : value != invalid_value);
+      }
+
+      inline static bool
+      isFiniteCoordinate (CoordinateT value)
+      {
+        return (!is_float || std::isfinite (static_cast<float> (value)));
+      }
+
+      inline float
+      decodeCoordinate (CoordinateT value, int d) const
+      {
+        if (is_float)
+          return (static_cast<float> (value));
+        return (offset_[d] + static_cast<float> (value) * resolution_);
+      }
+
+      /** \brief Pick the offset and the resolution of quantized coordinates. */
+      template <typename PointT> bool
+      setQuantization (const pcl::PointCloud<PointT> &cloud, float resolution)
+      {
+        offset_.setZero ();
+        resolution_ = 1.0f;
+        if (is_float)
+          return (true);
+
+        Eigen::Vector3d min_p = Eigen::Vector3d::Constant (std::numeric_limits<double>::max ());
+        Eigen::Vector3d max_p = Eigen::Vector3d::Constant (std::numeric_limits<double>::lowest ());
+        for (const auto &point : cloud)
+          if (std::isfinite (point.x) && std::isfinite (point.y) && std::isfinite (point.z))
+          {
+            min_p = min_p.cwiseMin (point.getVector3fMap ().template cast<double> ());
+            max_p = max_p.cwiseMax (point.getVector3fMap ().template cast<double> ());
+          }
+        if (min_p[0] > max_p[0])
+          return (true);
+
+        offset_ = (0.5 * (min_p + max_p)).template cast<float> ();
+        // The largest magnitude of a coordinate relative to the offset, with some slack for the rounding of the offset
+        const double half_extent = (max_p - min_p).maxCoeff () / 2.0 +
+                                   offset_.template cast<double> ().cwiseAbs ().maxCoeff () * 1e-6;
+        const double max_value = static_cast<double> (std::numeric_limits<CoordinateT>::max ()) - 1.0;
+        if (resolution <= 0.0f)
+          resolution = half_extent > 0.0 ? static_cast<float> (half_extent / max_value) : 1.0f;
+        else if (half_extent / resolution > max_value)
+        {
+          PCL_ERROR ("[pcl::CompactPointCloud::assign] A resolution of %g is too fine for an extent of %g with %zu bit coordinates!\n",
+                     resolution, 2.0 * half_extent, 8 * sizeof (CoordinateT));
+          return (false);
+        }
+        resolution_ = resolution;
+        return (true);
+      }
+
+      template <typename PointT> inline bool
+      encodeXYZ (const PointT &point, CoordinateT *xyz) const
+      {
+        const bool valid = std::isfinite (point.x) && std::isfinite (point.y) && std::isfinite (point.z);
+        if (is_float)
+        {
+          xyz[0] = static_cast<CoordinateT> (point.x);
+          xyz[1] = static_cast<CoordinateT> (point.y);
+          xyz[2] = static_cast<CoordinateT> (point.z);
+          return (valid);
+        }
+        if (!valid)
+        {
+          xyz[0] = xyz[1] = xyz[2] = invalid_value;
+          return (false);
+        }
+        const float coordinates[3] = {point.x, point.y, point.z};
+        const double max_value = static_cast<double> (std::numeric_limits<CoordinateT>::max ());
+        for (int d = 0; d < 3; ++d)
+        {
+          const double value = std::round ((static_cast<double> (coordinates[d]) - offset_[d]) / resolution_);
+          xyz[d] = static_cast<CoordinateT> ((std::max) (-max_value, (std::min) (max_value, value)));
+        }
+        return (true);
+      }
+
+      template <typename PointT, traits::HasNormal<PointT> = true> void
+      encodeNormals (const pcl::PointCloud<PointT> &cloud)
+      {
+        normals_.resize (3 * cloud.size ());
+        for (std::size_t i = 0; i < cloud.size (); ++i)
+        {
+          normals_[3 * i] = floatToHalf (cloud[i].normal_x);
+          normals_[3 * i + 1] = floatToHalf (cloud[i].normal_y);
+          normals_[3 * i + 2] = floatToHalf (cloud[i].normal_z);
+        }
+      }
+
+      template <typename PointT, traits::HasNoNormal<PointT> = true> void
+      encodeNormals (const pcl::PointCloud<PointT> &) {}
+
+      template <typename PointT, traits::HasColor<PointT> = true> void
+      encodeColors (const pcl::PointCloud<PointT> &cloud)
+      {
+        colors_.resize (cloud.size ());
+        for (std::size_t i = 0; i < cloud.size (); ++i)
+          colors_[i] = cloud[i].rgba;
+      }
+
+      template <typename PointT, traits::HasNoColor<PointT> = true> void
+      encodeColors (const pcl::PointCloud<PointT> &) {}
+
+      template <typename PointT, traits::HasNormal<PointT> = true> inline void
+      decodeNormal (std::size_t i, PointT &point) const
+      {
+        if (normals_.empty ())
+          return;
+        point.normal_x = halfToFloat (normals_[3 * i]);
+        point.normal_y = halfToFloat (normals_[3 * i + 1]);
+        point.normal_z = halfToFloat (normals_[3 * i + 2]);
+      }
+
+      template <typename PointT, traits::HasNoNormal<PointT> = true> inline void
+      decodeNormal (std::size_t, PointT &) const {}
+
+      template <typename PointT, traits::HasColor<PointT> = true> inline void
+      decodeColor (std::size_t i, PointT &point) const
+      {
+        if (!colors_.empty ())
+          point.rgba = colors_[i];
+      }
+
+      template <typename PointT, traits::HasNoColor<PointT> = true> inline void
+      decodeColor (std::size_t, PointT &) const {}
+
+      /** \brief The coordinates, 3 consecutive values per point. */
+      std::vector<CoordinateT> xyz_;
+
+      /** \brief The normals as half precision floats, 3 per point, empty if not stored. */
+      std::vector<std::uint16_t> normals_;
+
+      /** \brief The packed rgba colors, empty if not stored. */
+      std::vector<std::uint32_t> colors_;
+
+      /** \brief The quantization step and the origin of the quantized coordinates. */
+      float resolution_ = 1.0f;
+      Eigen::Vector3f offset_ = Eigen::Vector3f::Zero ();
+
+      bool is_dense_ = true;
+
+    public:
+      PCL_MAKE_ALIGNED_OPERATOR_NEW
+  };
+
+  /** \brief A CompactPointCloud with packed float coordinates (12 bytes per point). */
+  using PackedPointCloud = CompactPointCloud<float>;
+
+  /** \brief A CompactPointCloud with 32 bit quantized coordinates (12 bytes per point). */
+  using QuantizedPointCloud32 = CompactPointCloud<std::int32_t>;
+
+  /** \brief A CompactPointCloud with 16 bit quantized coordinates (6 bytes per point). */
+  using QuantizedPointCloud16 = CompactPointCloud<std::int16_t>;
+}
@@ -43,12 +43,27 @@
 #include <pcl/pcl_exports.h>
 #include <pcl/pcl_config.h>
 
-#define PCL_ALWAYS(...)  pcl::console::print (pcl::console::L_ALWAYS, __VA_ARGS__)
-#define PCL_ERROR(...)   pcl::console::print (pcl::console::L_ERROR, __VA_ARGS__)
-#define PCL_WARN(...)    pcl::console::print (pcl::console::L_WARN, __VA_ARGS__)
-#define PCL_INFO(...)    pcl::console::print (pcl::console::L_INFO, __VA_ARGS__)
-#define PCL_DEBUG(...)   pcl::console::print (pcl::console::L_DEBUG, __VA_ARGS__)
-#define PCL_VERBOSE(...) pcl::console::print (pcl::console::L_VERBOSE, __VA_ARGS__)
+/** \brief The most verbose level compiled into the PCL_* print macros. The messages of the higher levels are
+  * removed at compile time, so neither their arguments are evaluated nor the call is made, e.g. define it to
+  * pcl::console::L_INFO to remove the debug and verbose messages from a release build.
+  */
+#ifndef PCL_COMPILED_VERBOSITY_LEVEL
+#define PCL_COMPILED_VERBOSITY_LEVEL pcl::console::L_VERBOSE
+#endif
+
+/** \brief Prints a message if the level is compiled in and enabled at run time. The arguments are only evaluated
+  * when the message is printed.
+  */
+#define PCL_LOG_LEVEL(level, ...) \
+    (((level) <= PCL_COMPILED_VERBOSITY_LEVEL && pcl::console::isVerbosityLevelEnabled (level)) ? \
+      pcl::console::print (level, __VA_ARGS__) : static_cast<void> (0))
+
+#define PCL_ALWAYS(...)  PCL_LOG_LEVEL (pcl::console::L_ALWAYS, __VA_ARGS__)
+#define PCL_ERROR(...)   PCL_LOG_LEVEL (pcl::console::L_ERROR, __VA_ARGS__)
+#define PCL_WARN(...)    PCL_LOG_LEVEL (pcl::console::L_WARN, __VA_ARGS__)
+#define PCL_INFO(...)    PCL_LOG_LEVEL (pcl::console::L_INFO, __VA_ARGS__)
+#define PCL_DEBUG(...)   PCL_LOG_LEVEL (pcl::console::L_DEBUG, __VA_ARGS__)
+#define PCL_VERBOSE(...) PCL_LOG_LEVEL (pcl::console::L_VERBOSE, __VA_ARGS__)
 
 #define PCL_ASSERT_ERROR_PRINT_CHECK(pred, msg) \
     do \
@@ -120,6 +135,25 @@ namespace pcl
     PCL_EXPORTS bool 
     isVerbosityLevelEnabled (VERBOSITY_LEVEL severity);
 
+    /** \brief Enable or disable the asynchronous output.
+      *
+      * When enabled, the messages are formatted by the printing thread and written by a background
+      * thread, so printing does not wait for the output streams. The messages of each thread keep their
+      * order. Disabling the output writes the pending messages before returning.
+      *
+      * \param enable whether to write the messages from a background thread (default: disabled)
+      */
+    PCL_EXPORTS void
+    enableAsynchronousOutput (bool enable);
+
+    /** \brief Whether the messages are written from a background thread. */
+    PCL_EXPORTS bool
+    isAsynchronousOutputEnabled ();
+
+    /** \brief Wait for the messages printed so far to be written, then flush stdout and stderr. */
+    PCL_EXPORTS void
+    flushOutput ();
+
     /** \brief Enable or disable colored text output, overriding the default behavior.
       *
       * By default, colored output is enabled for interactive terminals or when the environment
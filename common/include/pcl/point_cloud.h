@@ -45,6 +45,7 @@
 #include <Eigen/StdVector>
 #include <Eigen/Geometry>
 #include <pcl/PCLHeader.h>
+#include <pcl/point_cloud_fwd.h>
 #include <pcl/exceptions.h>
 #include <pcl/memory.h>
 #include <pcl/pcl_macros.h>
@@ -52,6 +53,7 @@
 #include <pcl/types.h>
 
 #include <algorithm>
+#include <memory>
 #include <utility>
 #include <vector>
 
@@ -67,8 +69,6 @@ namespace pcl
     };
   } // namespace detail
 
-  // Forward declarations
-  template <typename PointT> class PointCloud;
   using MsgFieldMap = std::vector<detail::FieldMapping>;
 
   /** \brief Helper functor structure for copying data between an Eigen type and a PointT. */
@@ -174,9 +174,15 @@ namespace pcl
     *   - \b sensor_origin_ - specifies the sensor acquisition pose (origin/translation). \a Optional.
     *   - \b sensor_orientation_ - specifies the sensor acquisition pose (rotation). \a Optional.
     *
+    * The points are allocated with \b AllocatorT, Eigen::aligned_allocator by default. A custom allocator
+    * lets the points live in an arena, in pinned or shared memory, so that they can be handed to a device
+    * or another process without copying. Copies use the allocator returned by
+    * std::allocator_traits::select_on_container_copy_construction. Note that most algorithms only accept
+    * clouds with the default allocator.
+    *
     * \author Patrick Mihelich, Radu B. Rusu
     */
-  template <typename PointT>
+  template <typename PointT, typename AllocatorT>
   class PCL_EXPORTS PointCloud
   {
     public:
@@ -196,7 +202,7 @@ namespace pcl
       // Ignore deprecated warning on clang compilers
       #pragma clang diagnostic push
       #pragma clang diagnostic ignored "-Wdeprecated-declarations"
-      PointCloud (const PointCloud<PointT> &pc) = default;
+      PointCloud (const PointCloud &pc) = default;
       #pragma clang diagnostic pop
       #pragma warning(pop)
 
@@ -204,9 +210,11 @@ namespace pcl
         * \param[in] pc the cloud to copy into this
         * \param[in] indices the subset to copy
         */
-      PointCloud (const PointCloud<PointT> &pc,
+      PointCloud (const PointCloud &pc,
                   const Indices &indices) :
-        header (pc.header), points (indices.size ()), width (indices.size ()), height (1), is_dense (pc.is_dense),
+        header (pc.header),
+        points (indices.size (), std::allocator_traits<AllocatorT>::select_on_container_copy_construction (pc.points.get_allocator ())),
+        width (indices.size ()), height (1), is_dense (pc.is_dense),
         sensor_origin_ (pc.sensor_origin_), sensor_orientation_ (pc.sensor_orientation_)
       {
         // Copy the obvious
@@ -219,13 +227,23 @@ namespace pcl
         * \param[in] width_ the cloud width
         * \param[in] height_ the cloud height
         * \param[in] value_ default value
+        * \param[in] alloc allocator used for the points
         */
-      PointCloud (std::uint32_t width_, std::uint32_t height_, const PointT& value_ = PointT ())
-        : points (width_ * height_, value_)
+      PointCloud (std::uint32_t width_, std::uint32_t height_, const PointT& value_ = PointT (),
+                  const AllocatorT& alloc = AllocatorT ())
+        : points (width_ * height_, value_, alloc)
         , width (width_)
         , height (height_)
       {}
 
+      /** \brief Construct an empty cloud whose points are allocated by \a alloc.
+        * \param[in] alloc allocator used for the points, e.g. one drawing from an arena,
+        * pinned or shared memory
+        */
+      explicit PointCloud (const AllocatorT& alloc)
+        : points (alloc)
+      {}
+
       //TODO: check if copy/move contructors/assignment operators are needed
 
       /** \brief Add a point cloud to the current cloud.
@@ -250,8 +268,8 @@ namespace pcl
       }
 
       inline static bool
-      concatenate(pcl::PointCloud<PointT> &cloud1,
-                  const pcl::PointCloud<PointT> &cloud2)
+      concatenate(PointCloud &cloud1,
+                  const PointCloud &cloud2)
       {
         // Make the resultant point cloud take the newest stamp
         cloud1.header.stamp = std::max (cloud1.header.stamp, cloud2.header.stamp);
@@ -267,9 +285,9 @@ namespace pcl
       }
 
       inline static bool
-      concatenate(const pcl::PointCloud<PointT> &cloud1,
-               const pcl::PointCloud<PointT> &cloud2,
-               pcl::PointCloud<PointT> &cloud_out)
+      concatenate(const PointCloud &cloud1,
+               const PointCloud &cloud2,
+               PointCloud &cloud_out)
       {
         cloud_out = cloud1;
         return concatenate(cloud_out, cloud2);
@@ -408,7 +426,7 @@ namespace pcl
       pcl::PCLHeader header;
 
       /** \brief The point data. */
-      std::vector<PointT, Eigen::aligned_allocator<PointT> > points;
+      std::vector<PointT, AllocatorT> points;
 
       /** \brief The point cloud width (if organized as an image-structure). */
       std::uint32_t width = 0;
@@ -424,14 +442,16 @@ namespace pcl
       Eigen::Quaternionf sensor_orientation_ = Eigen::Quaternionf::Identity ();
 
       using PointType = PointT;  // Make the template class available from the outside
-      using VectorType = std::vector<PointT, Eigen::aligned_allocator<PointT> >;
-      using CloudVectorType = std::vector<PointCloud<PointT>, Eigen::aligned_allocator<PointCloud<PointT> > >;
-      using Ptr = shared_ptr<PointCloud<PointT> >;
-      using ConstPtr = shared_ptr<const PointCloud<PointT> >;
+      using AllocatorType = AllocatorT;
+      using VectorType = std::vector<PointT, AllocatorT>;
+      using CloudVectorType = std::vector<PointCloud, Eigen::aligned_allocator<PointCloud> >;
+      using Ptr = shared_ptr<PointCloud>;
+      using ConstPtr = shared_ptr<const PointCloud>;
 
       // std container compatibility typedefs according to
       // http://en.cppreference.com/w/cpp/concept/Container
       using value_type = PointT;
+      using allocator_type = AllocatorT;
       using reference = PointT&;
       using const_reference = const PointT&;
       using difference_type = typename VectorType::difference_type;
@@ -462,6 +482,17 @@ namespace pcl
       inline bool empty () const { return points.empty (); }
       PointT* data() noexcept { return points.data(); }
       const PointT* data() const noexcept { return points.data(); }
+      allocator_type get_allocator () const noexcept { return (points.get_allocator ()); }
+
+      /** \brief Get the memory used by the point cloud, i.e. the size of the object
+        * plus the allocated (not only the used) capacity of the point vector.
+        * \return memory in bytes
+        */
+      inline std::size_t
+      getMemoryUsage () const
+      {
+        return (sizeof (*this) + points.capacity () * sizeof (PointT));
+      }
 
       /**
        * \brief Resizes the container to contain `count` elements
@@ -675,7 +706,7 @@ namespace pcl
         * \param[in,out] rhs point cloud to swap this with
         */
       inline void
-      swap (PointCloud<PointT> &rhs)
+      swap (PointCloud &rhs)
       {
         std::swap (header, rhs.header);
         this->points.swap (rhs.points);
@@ -701,7 +732,7 @@ namespace pcl
         * \return shared pointer to the copy of the cloud
         */
       inline Ptr
-      makeShared () const { return Ptr (new PointCloud<PointT> (*this)); }
+      makeShared () const { return Ptr (new PointCloud (*this)); }
 
     protected:
       /** \brief This is motivated by ROS integration. Users should not need to access mapping_.
@@ -724,8 +755,8 @@ namespace pcl
     }
   } // namespace detail
 
-  template <typename PointT> std::ostream&
-  operator << (std::ostream& s, const pcl::PointCloud<PointT> &p)
+  template <typename PointT, typename AllocatorT> std::ostream&
+  operator << (std::ostream& s, const pcl::PointCloud<PointT, AllocatorT> &p)
   {
     s << "header: " << p.header << std::endl;
     s << "points[]: " << p.size () << std::endl;
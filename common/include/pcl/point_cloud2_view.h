@@ -0,0 +1,224 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved
+ */
+
+#pragma once
+
+#include <pcl/PCLPointCloud2.h>
+#include <pcl/conversions.h>
+#include <pcl/point_cloud.h>
+
+#include <Eigen/Core>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace pcl
+{
+  /** \brief A non-owning, typed view of the points stored in a PCLPointCloud2 blob.
+    *
+    * Contrary to fromPCLPointCloud2, nothing is copied when the view is created: the points are decoded
+    * from the blob when they are accessed, using the same field mapping as the conversion. When the
+    * layout of the blob is exactly the one of \a PointT (the same fields at the same offsets, the same
+    * point size, no padding between the rows and suitably aligned data, e.g. a blob created with toPCLPointCloud2 from a
+    * pcl::PointCloud<PointT>), \ref data gives direct access to the points as an array of \a PointT.
+    *
+    * Single fields can be read without decoding whole points with \ref getFieldOffset and
+    * \ref getFieldValue, and \ref getXYZ only reads the coordinates.
+    *
+    * \note The view refers to the PCLPointCloud2 it was created from (and to the given data), which must
+    * outlive it and must not be resized while the view is used.
+    * \ingroup common
+    */
+  template <typename PointT>
+  class PCLPointCloud2View
+  {
+    public:
+      /** \brief Create a view of the points of a PCLPointCloud2.
+        * \param[in] msg the PCLPointCloud2 binary blob
+        */
+      explicit
+      PCLPointCloud2View (const pcl::PCLPointCloud2 &msg)
+        : PCLPointCloud2View (msg, msg.data.empty () ? nullptr : &msg.data[0])
+      {
+      }
+
+      /** \brief Create a view of points stored outside of a PCLPointCloud2, e.g. in a memory mapped file.
+        * \param[in] layout a PCLPointCloud2 describing the points (fields, width, height, point_step and
+        * row_step, its data is not used)
+        * \param[in] data the serialized points, laid out as described by \a layout
+        */
+      PCLPointCloud2View (const pcl::PCLPointCloud2 &layout, const std::uint8_t *data)
+        : msg_ (layout)
+        , data_ (data)
+        , x_offset_ (getFieldOffset ("x"))
+        , y_offset_ (getFieldOffset ("y"))
+        , z_offset_ (getFieldOffset ("z"))
+      {
+        createMapping<PointT> (layout.fields, field_map_);
+
+        // The blob can be used as is if it has exactly the fields toPCLPointCloud2 writes for PointT
+        std::vector<pcl::PCLPointField> fields;
+        for_each_type<typename traits::fieldList<PointT>::type> (detail::FieldAdder<PointT> (fields));
+        direct_ = (layout.point_step == sizeof (PointT) &&
+                   layout.row_step == layout.point_step * layout.width &&
+                   reinterpret_cast<std::uintptr_t> (data_) % alignof (PointT) == 0 &&
+                   std::equal (fields.cbegin (), fields.cend (), layout.fields.cbegin (), layout.fields.cend (),
+                               [] (const pcl::PCLPointField &a, const pcl::PCLPointField &b)
+                               {
+                                 return (a.name == b.name && a.offset == b.offset &&
+                                         a.datatype == b.datatype && a.count == b.count);
+                               }));
+      }
+
+      /** \brief Get the number of points. */
+      inline std::size_t
+      size () const { return (static_cast<std::size_t> (msg_.width) * msg_.height); }
+
+      inline bool
+      empty () const { return (size () == 0); }
+
+      inline std::uint32_t
+      width () const { return (msg_.width); }
+
+      inline std::uint32_t
+      height () const { return (msg_.height); }
+
+      inline bool
+      isOrganized () const { return (msg_.height > 1); }
+
+      inline bool
+      isDense () const { return (msg_.is_dense == 1); }
+
+      /** \brief Get the header of the viewed message. */
+      inline const pcl::PCLHeader&
+      header () const { return (msg_.header); }
+
+      /** \brief Whether the blob can be accessed directly as an array of \a PointT, see \ref data. */
+      inline bool
+      isDirect () const { return (direct_); }
+
+      /** \brief Get the points as an array of \a PointT, or a null pointer if the layout of the blob is not
+        * the one of \a PointT (see \ref isDirect).
+        */
+      inline const PointT*
+      data () const
+      {
+        return (direct_ ? reinterpret_cast<const PointT*> (data_) : nullptr);
+      }
+
+      /** \brief Get the number of bytes between two consecutive points of a row. */
+      inline std::uint32_t
+      getStride () const { return (msg_.point_step); }
+
+      /** \brief Get the address of the serialized data of a point.
+        * \param[in] index the index of the point, rows after rows
+        */
+      inline const std::uint8_t*
+      getPointData (std::size_t index) const
+      {
+        const std::size_t row = index / msg_.width;
+        const std::size_t col = index - row * msg_.width;
+        return (data_ + row * msg_.row_step + col * msg_.point_step);
+      }
+
+      /** \brief Decode a whole point.
+        * \param[in] index the index of the point, rows after rows
+        * \note Fields of \a PointT which are missing from the blob keep their default value.
+        */
+      inline PointT
+      at (std::size_t index) const
+      {
+        if (direct_)
+          return (reinterpret_cast<const PointT*> (data_)[index]);
+
+        PointT point;
+        std::uint8_t* point_data = reinterpret_cast<std::uint8_t*> (&point);
+        const std::uint8_t* msg_data = getPointData (index);
+        for (const detail::FieldMapping &mapping : field_map_)
+          memcpy (point_data + mapping.struct_offset, msg_data + mapping.serialized_offset, mapping.size);
+        return (point);
+      }
+
+      inline PointT
+      operator[] (std::size_t index) const { return (at (index)); }
+
+      /** \brief Decode a point of an organized cloud.
+        * \param[in] column the column coordinate
+        * \param[in] row the row coordinate
+        */
+      inline PointT
+      operator () (std::size_t column, std::size_t row) const { return (at (row * msg_.width + column)); }
+
+      /** \brief Get the offset of a field in the serialized points, or -1 if there is no such field.
+        * \param[in] name the name of the field
+        */
+      inline int
+      getFieldOffset (const std::string &name) const
+      {
+        const auto field = std::find_if (msg_.fields.cbegin (), msg_.fields.cend (),
+                                         [&name] (const pcl::PCLPointField &f) { return (f.name == name); });
+        return (field == msg_.fields.cend () ? -1 : static_cast<int> (field->offset));
+      }
+
+      /** \brief Read a single value of a point.
+        * \param[in] index the index of the point, rows after rows
+        * \param[in] offset the offset of the value in the serialized point, see \ref getFieldOffset
+        */
+      template <typename T> inline T
+      getFieldValue (std::size_t index, int offset) const
+      {
+        T value;
+        memcpy (&value, getPointData (index) + offset, sizeof (T));
+        return (value);
+      }
+
+      /** \brief Whether the blob has float x, y and z fields. */
+      inline bool
+      hasXYZ () const { return (x_offset_ >= 0 && y_offset_ >= 0 && z_offset_ >= 0); }
+
+      /** \brief Read the coordinates of a point (the blob must have x, y and z fields, see \ref hasXYZ).
+        * \param[in] index the index of the point, rows after rows
+        */
+      inline Eigen::Vector3f
+      getXYZ (std::size_t index) const
+      {
+        const std::uint8_t* msg_data = getPointData (index);
+        Eigen::Vector3f xyz;
+        memcpy (&xyz[0], msg_data + x_offset_, sizeof (float));
+        memcpy (&xyz[1], msg_data + y_offset_, sizeof (float));
+        memcpy (&xyz[2], msg_data + z_offset_, sizeof (float));
+        return (xyz);
+      }
+
+      /** \brief Copy the viewed points into a pcl::PointCloud, same as fromPCLPointCloud2 but reusing
+        * the field mapping of the view.
+        * \param[out] cloud the resultant pcl::PointCloud<T>
+        */
+      inline void
+      toPointCloud (pcl::PointCloud<PointT> &cloud) const
+      {
+        cloud.header = msg_.header;
+        cloud.width = msg_.width;
+        cloud.height = msg_.height;
+        cloud.is_dense = isDense ();
+        cloud.points.resize (size ());
+        for (std::size_t i = 0; i < size (); ++i)
+          cloud[i] = at (i);
+      }
+
+    private:
+      const pcl::PCLPointCloud2 &msg_;
+      const std::uint8_t* data_;
+      MsgFieldMap field_map_;
+      bool direct_;
+      int x_offset_, y_offset_, z_offset_;
+  };
+}
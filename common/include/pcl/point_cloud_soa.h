@@ -0,0 +1,217 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved
+ */
+
+#pragma once
+
+#include <pcl/memory.h>
+#include <pcl/pcl_macros.h>
+#include <pcl/point_cloud.h>
+#include <pcl/types.h>
+
+#include <Eigen/Core>
+
+#include <cmath>
+#include <vector>
+
+namespace pcl
+{
+  /** \brief PointCloudSoA stores the xyz coordinates of a point cloud as a structure of arrays, that is
+    * one contiguous array per coordinate.
+    *
+    * pcl::PointCloud stores whole points next to each other, so a kernel that only reads the coordinates
+    * of e.g. a pcl::PointXYZRGBNormal cloud still pulls the normals and colors through the cache and can
+    * not be vectorized over consecutive points. Copying the coordinates once into a PointCloudSoA lets
+    * such kernels (searches, transformations, bounding boxes) stream over exactly the data they need, and
+    * the arrays can be processed with Eigen array expressions through \ref x, \ref y and \ref z.
+    *
+    * The coordinates are a copy: after modifying the original cloud, the view has to be refreshed with
+    * \ref assign. Each point remembers the index of the point it was copied from (see \ref getIndex), so
+    * results computed on the view can be related to the original cloud, and transformed coordinates can
+    * be written back with \ref copyXYZTo.
+    *
+    * \ingroup common
+    */
+  class PointCloudSoA
+  {
+    public:
+      using Ptr = shared_ptr<PointCloudSoA>;
+      using ConstPtr = shared_ptr<const PointCloudSoA>;
+
+      using ArrayMap = Eigen::Map<Eigen::ArrayXf>;
+      using ConstArrayMap = Eigen::Map<const Eigen::ArrayXf>;
+
+      /** \brief Empty constructor. */
+      PointCloudSoA () = default;
+
+      /** \brief Construct the view from the coordinates of a point cloud.
+        * \param[in] cloud the point cloud
+        * \param[in] remove_invalid skip the points with non finite coordinates
+        */
+      template <typename PointT> explicit
+      PointCloudSoA (const pcl::PointCloud<PointT> &cloud, bool remove_invalid = false)
+      {
+        assign (cloud, remove_invalid);
+      }
+
+      /** \brief Replace the content of the view with the coordinates of a point cloud.
+        * \param[in] cloud the point cloud
+        * \param[in] remove_invalid skip the points with non finite coordinates
+        */
+      template <typename PointT> void
+      assign (const pcl::PointCloud<PointT> &cloud, bool remove_invalid = false)
+      {
+        clear ();
+        reserve (cloud.size ());
+        for (std::size_t i = 0; i < cloud.size (); ++i)
+          append (cloud[i], static_cast<index_t> (i), remove_invalid);
+      }
+
+      /** \brief Replace the content of the view with the coordinates of a subset of a point cloud.
+        * \param[in] cloud the point cloud
+        * \param[in] indices the indices of the points to copy from \a cloud
+        * \param[in] remove_invalid skip the points with non finite coordinates
+        */
+      template <typename PointT> void
+      assign (const pcl::PointCloud<PointT> &cloud, const Indices &indices, bool remove_invalid = false)
+      {
+        clear ();
+        reserve (indices.size ());
+        for (const auto &index : indices)
+          append (cloud[index], index, remove_invalid);
+      }
+
+      /** \brief Write the coordinates of the view back into the points they were copied from.
+        * \param[in,out] cloud the point cloud the view was created from (or a copy of it)
+        */
+      template <typename PointT> void
+      copyXYZTo (pcl::PointCloud<PointT> &cloud) const
+      {
+        for (std::size_t i = 0; i < size (); ++i)
+        {
+          PointT &point = cloud[getIndex (i)];
+          point.x = x_[i];
+          point.y = y_[i];
+          point.z = z_[i];
+        }
+      }
+
+      /** \brief Add a point at the end of the view.
+        * \param[in] x, y, z the coordinates of the point
+        * \param[in] index the index of the point in the original cloud
+        */
+      inline void
+      push_back (float x, float y, float z, index_t index)
+      {
+        if (identity_indices_)
+        {
+          // Materialize the indices as soon as they stop being 0, 1, 2, ...
+          if (index == static_cast<index_t> (size ()))
+          {
+            pushCoordinates (x, y, z);
+            return;
+          }
+          indices_.resize (size ());
+          for (std::size_t i = 0; i < indices_.size (); ++i)
+            indices_[i] = static_cast<index_t> (i);
+          identity_indices_ = false;
+        }
+        pushCoordinates (x, y, z);
+        indices_.push_back (index);
+      }
+
+      /** \brief Get the number of points in the view. */
+      inline std::size_t
+      size () const { return (x_.size ()); }
+
+      /** \brief Whether the view holds no points. */
+      inline bool
+      empty () const { return (x_.empty ()); }
+
+      /** \brief Remove all points. */
+      inline void
+      clear ()
+      {
+        x_.clear ();
+        y_.clear ();
+        z_.clear ();
+        indices_.clear ();
+        identity_indices_ = true;
+      }
+
+      /** \brief Reserve memory for the given number of points. */
+      inline void
+      reserve (std::size_t n)
+      {
+        x_.reserve (n);
+        y_.reserve (n);
+        z_.reserve (n);
+      }
+
+      /** \brief Get the index in the original cloud of the i-th point of the view. */
+      inline index_t
+      getIndex (std::size_t i) const
+      {
+        return (identity_indices_ ? static_cast<index_t> (i) : indices_[i]);
+      }
+
+      /** \brief Get the coordinates of the i-th point of the view. */
+      inline Eigen::Vector3f
+      getPoint (std::size_t i) const
+      {
+        return (Eigen::Vector3f (x_[i], y_[i], z_[i]));
+      }
+
+      /** \brief Access the x, y and z arrays as Eigen arrays. */
+      inline ArrayMap
+      x () { return (ArrayMap (x_.data (), x_.size ())); }
+      inline ArrayMap
+      y () { return (ArrayMap (y_.data (), y_.size ())); }
+      inline ArrayMap
+      z () { return (ArrayMap (z_.data (), z_.size ())); }
+      inline ConstArrayMap
+      x () const { return (ConstArrayMap (x_.data (), x_.size ())); }
+      inline ConstArrayMap
+      y () const { return (ConstArrayMap (y_.data (), y_.size ())); }
+      inline ConstArrayMap
+      z () const { return (ConstArrayMap (z_.data (), z_.size ())); }
+
+      /** \brief Raw pointers to the x, y and z arrays. */
+      inline const float*
+      xData () const { return (x_.data ()); }
+      inline const float*
+      yData () const { return (y_.data ()); }
+      inline const float*
+      zData () const { return (z_.data ()); }
+
+    private:
+      template <typename PointT> inline void
+      append (const PointT &point, index_t index, bool remove_invalid)
+      {
+        if (remove_invalid &&
+            (!std::isfinite (point.x) || !std::isfinite (point.y) || !std::isfinite (point.z)))
+          return;
+        push_back (point.x, point.y, point.z, index);
+      }
+
+      inline void
+      pushCoordinates (float x, float y, float z)
+      {
+        x_.push_back (x);
+        y_.push_back (y);
+        z_.push_back (z);
+      }
+
+      /** \brief The coordinates, one array per dimension. */
+      std::vector<float> x_, y_, z_;
+
+      /** \brief The index in the original cloud of every point (empty if the indices are 0, 1, 2, ...). */
+      Indices indices_;
+      bool identity_indices_ = true;
+  };
+}
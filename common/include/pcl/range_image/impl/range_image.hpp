@@ -241,15 +241,35 @@ RangeImage::doZBuffer (const PointCloudType& point_cloud, float noise_level, flo
   
   top=height; right=-1; bottom=-1; left=width;
   
+  // The projection into the image is independent per point and is done in parallel first.
+  // The z-buffer itself depends on the order of the points and is therefore filled serially afterwards.
+  const int no_of_points = static_cast<int> (points2.size ());
+  std::vector<Eigen::Vector3f, Eigen::aligned_allocator<Eigen::Vector3f> > projections (no_of_points);
+#pragma omp parallel for \
+  default(none) \
+  shared(points2, projections) \
+  firstprivate(no_of_points) \
+  schedule(static) \
+  num_threads(max_no_of_threads)
+  for (int point_idx=0; point_idx<no_of_points; ++point_idx)
+  {
+    const PointType2& point = points2[point_idx];
+    Eigen::Vector3f& projection = projections[point_idx];
+    if (!isFinite (point))  // Check for NAN etc
+    {
+      projection[2] = std::numeric_limits<float>::quiet_NaN ();
+      continue;
+    }
+    this->getImagePoint (point.getVector3fMap (), projection[0], projection[1], projection[2]);
+  }
+  
   float x_real, y_real, range_of_current_point;
   int x, y;
-  for (const auto& point: points2)
+  for (const auto& projection: projections)
   {
-    if (!isFinite (point))  // Check for NAN etc
+    x_real = projection[0];  y_real = projection[1];  range_of_current_point = projection[2];
+    if (std::isnan (range_of_current_point))
       continue;
-    Vector3fMapConst current_point = point.getVector3fMap ();
-    
-    this->getImagePoint (current_point, x_real, y_real, range_of_current_point);
     this->real2DToInt2D (x_real, y_real, x, y);
     
     if (range_of_current_point < min_range|| !isInImage (x, y))
@@ -0,0 +1,149 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2024-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#pragma once
+
+/**
+ * \file pcl/tracking_allocator.h
+ *
+ * \brief Defines an aligned allocator that accounts the memory it hands out.
+ * \ingroup common
+ */
+
+#include <pcl/pcl_exports.h>
+
+#include <Eigen/Core>  // for Eigen::aligned_allocator
+
+#include <cstddef>  // for std::size_t
+
+namespace pcl
+{
+/**
+ * \brief Get the number of bytes currently allocated through pcl::TrackingAllocator
+ * \ingroup common
+ */
+PCL_EXPORTS std::size_t
+getTrackedMemoryUsage();
+
+/**
+ * \brief Get the highest value of getTrackedMemoryUsage() since program start or the
+ *   last call to resetPeakTrackedMemoryUsage()
+ * \ingroup common
+ */
+PCL_EXPORTS std::size_t
+getPeakTrackedMemoryUsage();
+
+/**
+ * \brief Reset the peak to the current tracked memory usage
+ * \ingroup common
+ */
+PCL_EXPORTS void
+resetPeakTrackedMemoryUsage();
+
+namespace detail
+{
+PCL_EXPORTS void
+trackAllocation(std::size_t bytes);
+
+PCL_EXPORTS void
+trackDeallocation(std::size_t bytes);
+}
+
+/**
+ * \brief Drop-in replacement for Eigen::aligned_allocator that keeps process-wide
+ *   counters of the currently allocated and the peak number of bytes.
+ *
+ * Useful to find out how much memory a pipeline stage needs, e.g.
+ * \code
+ * std::vector<pcl::PointXYZ, pcl::TrackingAllocator<pcl::PointXYZ>> points;
+ * pcl::resetPeakTrackedMemoryUsage();
+ * // ... fill points ...
+ * std::size_t peak = pcl::getPeakTrackedMemoryUsage();
+ * \endcode
+ * \note The counters are shared by all instantiations and updated atomically.
+ * \ingroup common
+ */
+template <typename T>
+class TrackingAllocator : public Eigen::aligned_allocator<T>
+{
+public:
+  using value_type = T;
+  using pointer = T*;
+  using size_type = std::size_t;
+
+  template <typename U>
+  struct rebind
+  {
+    using other = TrackingAllocator<U>;
+  };
+
+  TrackingAllocator() = default;
+
+  template <typename U>
+  TrackingAllocator(const TrackingAllocator<U>&)
+  {}
+
+  pointer
+  allocate(size_type num, const void* /*hint*/ = nullptr)
+  {
+    pointer p = Eigen::aligned_allocator<T>::allocate(num);
+    detail::trackAllocation(num * sizeof(T));
+    return p;
+  }
+
+  void
+  deallocate(pointer p, size_type num)
+  {
+    detail::trackDeallocation(num * sizeof(T));
+    Eigen::aligned_allocator<T>::deallocate(p, num);
+  }
+};
+
+template <typename T, typename U>
+bool
+operator==(const TrackingAllocator<T>&, const TrackingAllocator<U>&)
+{
+  return true;
+}
+
+template <typename T, typename U>
+bool
+operator!=(const TrackingAllocator<T>&, const TrackingAllocator<U>&)
+{
+  return false;
+}
+}
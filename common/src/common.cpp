@@ -42,6 +42,20 @@
 #include <pcl/common/common.h>
 #include <pcl/console/print.h>
 
+//////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::getMinMax3D (const pcl::PointCloudSoA &cloud, Eigen::Vector4f &min_pt, Eigen::Vector4f &max_pt)
+{
+  if (cloud.empty ())
+  {
+    min_pt.setConstant (std::numeric_limits<float>::max ());
+    max_pt.setConstant (-std::numeric_limits<float>::max ());
+    return;
+  }
+  min_pt << cloud.x ().minCoeff (), cloud.y ().minCoeff (), cloud.z ().minCoeff (), 0.0f;
+  max_pt << cloud.x ().maxCoeff (), cloud.y ().maxCoeff (), cloud.z ().maxCoeff (), 0.0f;
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////
 void 
 pcl::getMinMax (const pcl::PCLPointCloud2 &cloud, int,
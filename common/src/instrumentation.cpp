@@ -0,0 +1,359 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2024-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <pcl/common/instrumentation.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+
+namespace
+{
+  using Clock = std::chrono::steady_clock;
+
+  struct StageData
+  {
+    std::uint64_t calls = 0;
+    double total_time = 0.0;
+    double min_time = 0.0;
+    double max_time = 0.0;
+
+    void
+    add (double time)
+    {
+      min_time = calls == 0 ? time : (std::min) (min_time, time);
+      max_time = calls == 0 ? time : (std::max) (max_time, time);
+      total_time += time;
+      ++calls;
+    }
+
+    void
+    merge (const StageData &other)
+    {
+      if (other.calls == 0)
+        return;
+      min_time = calls == 0 ? other.min_time : (std::min) (min_time, other.min_time);
+      max_time = calls == 0 ? other.max_time : (std::max) (max_time, other.max_time);
+      total_time += other.total_time;
+      calls += other.calls;
+    }
+  };
+
+  struct TraceEvent
+  {
+    std::string name;
+    Clock::time_point start;
+    Clock::duration duration;
+    unsigned int thread_id;
+  };
+
+  /** \brief The statistics of one thread. Its mutex is only contended while a report is read. */
+  struct ThreadData
+  {
+    unsigned int id = 0;
+    std::mutex mutex;
+    std::unordered_map<std::string, StageData> stages;
+    std::unordered_map<std::string, std::uint64_t> counters;
+    std::vector<TraceEvent> events;
+
+    void
+    clear ()
+    {
+      stages.clear ();
+      counters.clear ();
+      events.clear ();
+    }
+
+    void
+    mergeInto (ThreadData &other) const
+    {
+      for (const auto &stage : stages)
+        other.stages[stage.first].merge (stage.second);
+      for (const auto &counter : counters)
+        other.counters[counter.first] += counter.second;
+      other.events.insert (other.events.end (), events.begin (), events.end ());
+    }
+  };
+
+  struct Registry
+  {
+    std::mutex mutex;
+    std::vector<ThreadData*> threads;
+    /// Statistics of the threads that exited
+    ThreadData retired;
+    unsigned int next_id = 0;
+    const Clock::time_point epoch = Clock::now ();
+  };
+
+  /** \brief The registry is never destroyed, as the threads may exit after the static objects are destroyed. */
+  Registry&
+  registry ()
+  {
+    static Registry *registry = new Registry;
+    return (*registry);
+  }
+
+  struct ThreadDataHolder
+  {
+    ThreadData data;
+
+    ThreadDataHolder ()
+    {
+      Registry &reg = registry ();
+      std::lock_guard<std::mutex> lock (reg.mutex);
+      data.id = reg.next_id++;
+      reg.threads.push_back (&data);
+    }
+
+    ~ThreadDataHolder ()
+    {
+      Registry &reg = registry ();
+      std::lock_guard<std::mutex> lock (reg.mutex);
+      {
+        std::lock_guard<std::mutex> data_lock (data.mutex);
+        data.mergeInto (reg.retired);
+      }
+      reg.threads.erase (std::remove (reg.threads.begin (), reg.threads.end (), &data), reg.threads.end ());
+    }
+  };
+
+  ThreadData&
+  threadData ()
+  {
+    thread_local ThreadDataHolder holder;
+    return (holder.data);
+  }
+
+  std::atomic<bool> enabled {false};
+  std::atomic<std::size_t> trace_capacity {65536};
+
+  /** \brief Sum the statistics of all the threads. The caller holds the mutex of the registry. */
+  void
+  collect (Registry &reg, ThreadData &all)
+  {
+    reg.retired.mergeInto (all);
+    for (ThreadData *data : reg.threads)
+    {
+      std::lock_guard<std::mutex> lock (data->mutex);
+      data->mergeInto (all);
+    }
+  }
+
+  void
+  writeEscaped (std::ostream &os, const std::string &text, bool json)
+  {
+    for (const char c : text)
+    {
+      if (c == '"' || c == '\\')
+        os << '\\' << c;
+      else if (c == '\n')
+        os << "\\n";
+      else if (json && static_cast<unsigned char> (c) < 0x20)
+      {
+        char buffer[8];
+        std::snprintf (buffer, sizeof (buffer), "\\u%04x", static_cast<unsigned int> (c));
+        os << buffer;
+      }
+      else
+        os << c;
+    }
+  }
+
+  void
+  writeNumber (std::ostream &os, double value)
+  {
+    char buffer[32];
+    std::snprintf (buffer, sizeof (buffer), "%.9g", value);
+    os << buffer;
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////
+void
+pcl::instrumentation::setEnabled (bool enable)
+{
+  // Start the clock of the trace before the first event
+  registry ();
+  enabled.store (enable, std::memory_order_relaxed);
+}
+
+//////////////////////////////////////////////////////////////////////////
+bool
+pcl::instrumentation::isEnabled ()
+{
+  return (enabled.load (std::memory_order_relaxed));
+}
+
+//////////////////////////////////////////////////////////////////////////
+void
+pcl::instrumentation::setTraceCapacity (std::size_t capacity)
+{
+  trace_capacity.store (capacity, std::memory_order_relaxed);
+}
+
+//////////////////////////////////////////////////////////////////////////
+void
+pcl::instrumentation::recordStage (const std::string &name, Clock::time_point start, Clock::time_point end)
+{
+  ThreadData &data = threadData ();
+  const double time = std::chrono::duration<double> (end - start).count ();
+  std::lock_guard<std::mutex> lock (data.mutex);
+  data.stages[name].add (time);
+  if (data.events.size () < trace_capacity.load (std::memory_order_relaxed))
+    data.events.push_back ({name, start, end - start, data.id});
+}
+
+//////////////////////////////////////////////////////////////////////////
+void
+pcl::instrumentation::addCount (const std::string &name, std::uint64_t value)
+{
+  ThreadData &data = threadData ();
+  std::lock_guard<std::mutex> lock (data.mutex);
+  data.counters[name] += value;
+}
+
+//////////////////////////////////////////////////////////////////////////
+pcl::instrumentation::Report
+pcl::instrumentation::getReport ()
+{
+  ThreadData all;
+  {
+    Registry &reg = registry ();
+    std::lock_guard<std::mutex> lock (reg.mutex);
+    collect (reg, all);
+  }
+
+  Report report;
+  const std::map<std::string, StageData> stages (all.stages.begin (), all.stages.end ());
+  for (const auto &stage : stages)
+  {
+    StageStatistics statistics;
+    statistics.name = stage.first;
+    statistics.calls = stage.second.calls;
+    statistics.total_time = stage.second.total_time;
+    statistics.min_time = stage.second.min_time;
+    statistics.max_time = stage.second.max_time;
+    report.stages.push_back (statistics);
+  }
+  const std::map<std::string, std::uint64_t> counters (all.counters.begin (), all.counters.end ());
+  for (const auto &counter : counters)
+    report.counters.push_back ({counter.first, counter.second});
+  return (report);
+}
+
+//////////////////////////////////////////////////////////////////////////
+void
+pcl::instrumentation::reset ()
+{
+  Registry &reg = registry ();
+  std::lock_guard<std::mutex> lock (reg.mutex);
+  reg.retired.clear ();
+  for (ThreadData *data : reg.threads)
+  {
+    std::lock_guard<std::mutex> data_lock (data->mutex);
+    data->clear ();
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////
+void
+pcl::instrumentation::exportChromeTrace (std::ostream &os)
+{
+  ThreadData all;
+  Clock::time_point epoch;
+  {
+    Registry &reg = registry ();
+    std::lock_guard<std::mutex> lock (reg.mutex);
+    collect (reg, all);
+    epoch = reg.epoch;
+  }
+  std::stable_sort (all.events.begin (), all.events.end (),
+                    [] (const TraceEvent &a, const TraceEvent &b) { return (a.start < b.start); });
+
+  os << "{\"traceEvents\":[";
+  for (std::size_t i = 0; i < all.events.size (); ++i)
+  {
+    const TraceEvent &event = all.events[i];
+    os << (i == 0 ? "\n" : ",\n") << "{\"name\":\"";
+    writeEscaped (os, event.name, true);
+    os << "\",\"cat\":\"pcl\",\"ph\":\"X\",\"ts\":";
+    writeNumber (os, std::chrono::duration<double, std::micro> (event.start - epoch).count ());
+    os << ",\"dur\":";
+    writeNumber (os, std::chrono::duration<double, std::micro> (event.duration).count ());
+    os << ",\"pid\":0,\"tid\":" << event.thread_id << "}";
+  }
+  os << "\n],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+//////////////////////////////////////////////////////////////////////////
+void
+pcl::instrumentation::exportPrometheus (std::ostream &os, const std::string &prefix)
+{
+  const Report report = getReport ();
+
+  const auto write_stage_metric = [&] (const char *name, const char *type, const char *help, auto value)
+  {
+    os << "# HELP " << prefix << "_" << name << " " << help << "\n";
+    os << "# TYPE " << prefix << "_" << name << " " << type << "\n";
+    for (const auto &stage : report.stages)
+    {
+      os << prefix << "_" << name << "{stage=\"";
+      writeEscaped (os, stage.name, false);
+      os << "\"} ";
+      writeNumber (os, value (stage));
+      os << "\n";
+    }
+  };
+  write_stage_metric ("stage_calls_total", "counter", "Number of runs of the stage.",
+                      [] (const StageStatistics &stage) { return (static_cast<double> (stage.calls)); });
+  write_stage_metric ("stage_seconds_total", "counter", "Total time spent in the stage.",
+                      [] (const StageStatistics &stage) { return (stage.total_time); });
+  write_stage_metric ("stage_seconds_max", "gauge", "Longest run of the stage.",
+                      [] (const StageStatistics &stage) { return (stage.max_time); });
+
+  os << "# HELP " << prefix << "_counter_total Value of the counter.\n";
+  os << "# TYPE " << prefix << "_counter_total counter\n";
+  for (const auto &counter : report.counters)
+  {
+    os << prefix << "_counter_total{name=\"";
+    writeEscaped (os, counter.name, false);
+    os << "\"} " << counter.value << "\n";
+  }
+}
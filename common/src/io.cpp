@@ -40,6 +40,9 @@
 
 #include <pcl/point_types.h>
 #include <pcl/common/io.h>
+#include <pcl/common/utils.h> // for pcl::utils::getNumberOfThreads
+
+#include <cstddef>
 
 //////////////////////////////////////////////////////////////////////////
 void
@@ -413,11 +416,14 @@ pcl::getEigenAsPointCloud (Eigen::MatrixXf &in, pcl::PCLPointCloud2 &out)
 }
 
 //////////////////////////////////////////////////////////////////////////
-void 
-pcl::copyPointCloud (
-    const pcl::PCLPointCloud2 &cloud_in,
-    const Indices &indices,
-    pcl::PCLPointCloud2 &cloud_out)
+/** \brief Copy the points of \a cloud_in at the given indices into \a cloud_out, one row memcpy per point,
+  * every thread writing one contiguous range of the output.
+  */
+template <typename IndicesT> static void
+copyPointCloudIndices (const pcl::PCLPointCloud2 &cloud_in,
+                       const IndicesT &indices,
+                       pcl::PCLPointCloud2 &cloud_out,
+                       unsigned int nr_threads)
 {
   cloud_out.header       = cloud_in.header;
   cloud_out.height       = 1;
@@ -428,11 +434,31 @@ pcl::copyPointCloud (
   cloud_out.row_step     = cloud_in.point_step * static_cast<std::uint32_t> (indices.size ());
   cloud_out.is_dense     = cloud_in.is_dense;
 
-  cloud_out.data.resize (cloud_out.width * cloud_out.height * cloud_out.point_step);
+  cloud_out.data.resize (static_cast<std::size_t> (cloud_out.width) * cloud_out.height * cloud_out.point_step);
+
+  const std::size_t point_step = cloud_in.point_step;
+  const std::uint8_t *data_in = cloud_in.data.data ();
+  std::uint8_t *data_out = cloud_out.data.data ();
+  const auto nr_points = static_cast<std::ptrdiff_t> (indices.size ());
+  pcl::utils::ignore (nr_threads);
+#pragma omp parallel for \
+  default(none) \
+  shared(data_in, data_out, indices, nr_points, point_step) \
+  num_threads(pcl::utils::getNumberOfThreads (nr_threads)) \
+  schedule(static)
+  for (std::ptrdiff_t i = 0; i < nr_points; ++i)
+    memcpy (data_out + i * point_step, data_in + indices[i] * point_step, point_step);
+}
 
-  // Iterate over each point
-  for (std::size_t i = 0; i < indices.size (); ++i)
-    memcpy (&cloud_out.data[i * cloud_out.point_step], &cloud_in.data[indices[i] * cloud_in.point_step], cloud_in.point_step);
+//////////////////////////////////////////////////////////////////////////
+void 
+pcl::copyPointCloud (
+    const pcl::PCLPointCloud2 &cloud_in,
+    const Indices &indices,
+    pcl::PCLPointCloud2 &cloud_out,
+    unsigned int nr_threads)
+{
+  copyPointCloudIndices (cloud_in, indices, cloud_out, nr_threads);
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -440,22 +466,10 @@ void
 pcl::copyPointCloud (
     const pcl::PCLPointCloud2 &cloud_in,
     const IndicesAllocator< Eigen::aligned_allocator<int> > &indices,
-    pcl::PCLPointCloud2 &cloud_out)
+    pcl::PCLPointCloud2 &cloud_out,
+    unsigned int nr_threads)
 {
-  cloud_out.header       = cloud_in.header;
-  cloud_out.height       = 1;
-  cloud_out.width        = indices.size (); 
-  cloud_out.fields       = cloud_in.fields;
-  cloud_out.is_bigendian = cloud_in.is_bigendian;
-  cloud_out.point_step   = cloud_in.point_step;
-  cloud_out.row_step     = cloud_in.point_step * static_cast<std::uint32_t> (indices.size ());
-  cloud_out.is_dense     = cloud_in.is_dense;
-
-  cloud_out.data.resize (cloud_out.width * cloud_out.height * cloud_out.point_step);
-
-  // Iterate over each point
-  for (std::size_t i = 0; i < indices.size (); ++i)
-    memcpy (&cloud_out.data[i * cloud_out.point_step], &cloud_in.data[indices[i] * cloud_in.point_step], cloud_in.point_step);
+  copyPointCloudIndices (cloud_in, indices, cloud_out, nr_threads);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
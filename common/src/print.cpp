@@ -36,10 +36,15 @@
  */
 #include <pcl/console/print.h>
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <cstdlib>
 #include <cctype> // for toupper
 #include <map>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <boost/optional.hpp>
 
 #if defined _WIN32
@@ -91,11 +96,13 @@ convertAttributesColor (int attribute, int fg, int bg=0)
 
 // Map to store, for each output stream, whether to use colored output
 static std::map<FILE *, boost::optional<bool> > colored_output;
+static std::mutex colored_output_mutex;
 
 ////////////////////////////////////////////////////////////////////////////////
 inline bool
 useColoredOutput (FILE *stream)
 {
+  std::lock_guard<std::mutex> lock (colored_output_mutex);
   auto &colored = colored_output[stream];
   if (!colored)
   {
@@ -113,6 +120,7 @@ useColoredOutput (FILE *stream)
 void
 pcl::console::enableColoredOutput (FILE *stream, bool enable)
 {
+  std::lock_guard<std::mutex> lock (colored_output_mutex);
   colored_output[stream] = enable;
 }
 
@@ -167,18 +175,225 @@ pcl::console::reset_text_color (FILE *stream)
 #endif
 }
 
+namespace
+{
+  /** \brief A formatted message, with the colors to write it with. */
+  struct Message
+  {
+    FILE *stream;
+    /// Whether the text is written with the attribute and foreground color, or after a reset of the colors
+    bool colored;
+    int attribute;
+    int fg;
+    /// Whether the text is preceded by a highlighted "> "
+    bool highlight;
+    std::string text;
+    /// Next message in the queue of the asynchronous output
+    Message *next;
+  };
+
+  /** \brief Serializes the messages written to the streams, so that the messages of concurrent threads do not
+    * interleave with each other or with their colors.
+    */
+  std::mutex output_mutex;
+
+  ////////////////////////////////////////////////////////////////////////////////
+  void
+  writeMessage (const Message &message)
+  {
+    std::lock_guard<std::mutex> lock (output_mutex);
+    if (message.highlight)
+    {
+      pcl::console::change_text_color (message.stream, pcl::console::TT_BRIGHT, pcl::console::TT_GREEN);
+      fputs ("> ", message.stream);
+    }
+    if (message.colored)
+      pcl::console::change_text_color (message.stream, message.attribute, message.fg);
+    else
+      pcl::console::reset_text_color (message.stream);
+    fwrite (message.text.data (), 1, message.text.size (), message.stream);
+    if (message.colored)
+      pcl::console::reset_text_color (message.stream);
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
+  std::string
+  formatMessage (const char *format, va_list ap)
+  {
+    char buffer[512];
+    va_list ap_copy;
+    va_copy (ap_copy, ap);
+    const int size = vsnprintf (buffer, sizeof (buffer), format, ap_copy);
+    va_end (ap_copy);
+    if (size < 0)
+      return (std::string ());
+    if (static_cast<std::size_t> (size) < sizeof (buffer))
+      return (std::string (buffer, size));
+
+    std::string text (size, '\0');
+    vsnprintf (&text[0], size + 1, format, ap);
+    return (text);
+  }
+
+  /** \brief Writes the messages from a background thread. The printing threads push them on a lock-free stack,
+    * which the writer takes whole and reverses, so the messages are written in the order they were printed.
+    */
+  class AsynchronousOutput
+  {
+    public:
+      ~AsynchronousOutput ()
+      {
+        stop ();
+      }
+
+      void
+      start ()
+      {
+        std::lock_guard<std::mutex> control_lock (control_mutex_);
+        if (thread_.joinable ())
+          return;
+        {
+          std::lock_guard<std::mutex> lock (mutex_);
+          stop_ = false;
+        }
+        thread_ = std::thread (&AsynchronousOutput::run, this);
+        enabled_.store (true, std::memory_order_release);
+      }
+
+      void
+      stop ()
+      {
+        std::lock_guard<std::mutex> control_lock (control_mutex_);
+        enabled_.store (false, std::memory_order_release);
+        if (!thread_.joinable ())
+          return;
+        {
+          std::lock_guard<std::mutex> lock (mutex_);
+          stop_ = true;
+        }
+        wake_.notify_one ();
+        thread_.join ();
+        // Messages pushed while the output was being disabled
+        writeMessages (head_.exchange (nullptr, std::memory_order_acquire));
+      }
+
+      bool
+      isEnabled () const
+      {
+        return (enabled_.load (std::memory_order_acquire));
+      }
+
+      void
+      push (Message *message)
+      {
+        nr_pushed_.fetch_add (1, std::memory_order_relaxed);
+        message->next = head_.load (std::memory_order_relaxed);
+        while (!head_.compare_exchange_weak (message->next, message,
+                                             std::memory_order_release, std::memory_order_relaxed))
+          ;
+        if (sleeping_.load (std::memory_order_acquire))
+          wake_.notify_one ();
+      }
+
+      void
+      flush ()
+      {
+        const std::size_t nr_pushed = nr_pushed_.load (std::memory_order_relaxed);
+        std::unique_lock<std::mutex> lock (mutex_);
+        wake_.notify_one ();
+        written_.wait (lock, [this, nr_pushed] { return (nr_written_ >= nr_pushed || stop_); });
+      }
+
+    private:
+      void
+      run ()
+      {
+        std::unique_lock<std::mutex> lock (mutex_);
+        while (true)
+        {
+          Message *messages = head_.exchange (nullptr, std::memory_order_acquire);
+          if (!messages)
+          {
+            if (stop_)
+              break;
+            // A wake up missed by a push is only delayed by the timeout
+            sleeping_.store (true, std::memory_order_release);
+            if (!head_.load (std::memory_order_acquire))
+              wake_.wait_for (lock, std::chrono::milliseconds (10));
+            sleeping_.store (false, std::memory_order_release);
+            continue;
+          }
+          lock.unlock ();
+          const std::size_t nr_written = writeMessages (messages);
+          lock.lock ();
+          nr_written_ += nr_written;
+          written_.notify_all ();
+        }
+        written_.notify_all ();
+      }
+
+      static std::size_t
+      writeMessages (Message *messages)
+      {
+        // The stack holds the messages in the reverse order
+        Message *ordered = nullptr;
+        while (messages)
+        {
+          Message *next = messages->next;
+          messages->next = ordered;
+          ordered = messages;
+          messages = next;
+        }
+        std::size_t nr_written = 0;
+        while (ordered)
+        {
+          writeMessage (*ordered);
+          Message *next = ordered->next;
+          delete ordered;
+          ordered = next;
+          ++nr_written;
+        }
+        return (nr_written);
+      }
+
+      std::atomic<Message*> head_ {nullptr};
+      std::atomic<std::size_t> nr_pushed_ {0};
+      std::atomic<bool> sleeping_ {false};
+      std::atomic<bool> enabled_ {false};
+
+      std::mutex mutex_;
+      std::condition_variable wake_;
+      std::condition_variable written_;
+      std::size_t nr_written_ = 0;
+      bool stop_ = false;
+
+      std::mutex control_mutex_;
+      std::thread thread_;
+  };
+
+  AsynchronousOutput asynchronous_output;
+
+  ////////////////////////////////////////////////////////////////////////////////
+  void
+  vprint (FILE *stream, bool colored, int attribute, int fg, bool highlight, const char *format, va_list ap)
+  {
+    Message message {stream, colored, attribute, fg, highlight, formatMessage (format, ap), nullptr};
+    if (asynchronous_output.isEnabled ())
+      asynchronous_output.push (new Message (std::move (message)));
+    else
+      writeMessage (message);
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void
 pcl::console::print_color (FILE *stream, int attr, int fg, const char *format, ...)
 {
-  change_text_color (stream, attr, fg);
   va_list ap;
 
   va_start (ap, format);
-  vfprintf (stream, format, ap);
+  vprint (stream, true, attr, fg, false, format, ap);
   va_end (ap);
-  
-  reset_text_color (stream);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -187,12 +402,10 @@ pcl::console::print_info (const char *format, ...)
 {
   if (!isVerbosityLevelEnabled (L_INFO)) return; 
 
-  reset_text_color (stdout);
-
   va_list ap;
 
   va_start (ap, format);
-  vfprintf (stdout, format, ap);
+  vprint (stdout, false, TT_RESET, TT_WHITE, false, format, ap);
   va_end (ap);
 }
 
@@ -202,12 +415,10 @@ pcl::console::print_info (FILE *stream, const char *format, ...)
 {
   if (!isVerbosityLevelEnabled (L_INFO)) return;
 
-  reset_text_color (stream);
-
   va_list ap;
 
   va_start (ap, format);
-  vfprintf (stream, format, ap);
+  vprint (stream, false, TT_RESET, TT_WHITE, false, format, ap);
   va_end (ap);
 }
 
@@ -217,14 +428,10 @@ pcl::console::print_highlight (const char *format, ...)
 {
   //if (!isVerbosityLevelEnabled (L_ALWAYS)) return;
 
-  change_text_color (stdout, TT_BRIGHT, TT_GREEN);
-  fprintf (stdout, "> ");
-  reset_text_color (stdout);
-
   va_list ap;
 
   va_start (ap, format);
-  vfprintf (stdout, format, ap);
+  vprint (stdout, false, TT_RESET, TT_WHITE, true, format, ap);
   va_end (ap);
 }
 
@@ -234,14 +441,10 @@ pcl::console::print_highlight (FILE *stream, const char *format, ...)
 {
   //if (!isVerbosityLevelEnabled (L_ALWAYS)) return;
 
-  change_text_color (stream, TT_BRIGHT, TT_GREEN);
-  fprintf (stream, "> ");
-  reset_text_color (stream);
-
   va_list ap;
 
   va_start (ap, format);
-  vfprintf (stream, format, ap);
+  vprint (stream, false, TT_RESET, TT_WHITE, true, format, ap);
   va_end (ap);
 }
 
@@ -251,14 +454,11 @@ pcl::console::print_error (const char *format, ...)
 {
   if (!isVerbosityLevelEnabled (L_ERROR)) return;
 
-  change_text_color (stderr, TT_BRIGHT, TT_RED);
   va_list ap;
 
   va_start (ap, format);
-  vfprintf (stderr, format, ap);
+  vprint (stderr, true, TT_BRIGHT, TT_RED, false, format, ap);
   va_end (ap);
-  
-  reset_text_color (stderr);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -267,14 +467,11 @@ pcl::console::print_error (FILE *stream, const char *format, ...)
 {
   if (!isVerbosityLevelEnabled (L_ERROR)) return;
 
-  change_text_color (stream, TT_BRIGHT, TT_RED);
   va_list ap;
 
   va_start (ap, format);
-  vfprintf (stream, format, ap);
+  vprint (stream, true, TT_BRIGHT, TT_RED, false, format, ap);
   va_end (ap);
-  
-  reset_text_color (stream);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -283,14 +480,11 @@ pcl::console::print_warn (const char *format, ...)
 {
   if (!isVerbosityLevelEnabled (L_WARN)) return;
 
-  change_text_color (stderr, TT_BRIGHT, TT_YELLOW);
   va_list ap;
 
   va_start (ap, format);
-  vfprintf (stderr, format, ap);
+  vprint (stderr, true, TT_BRIGHT, TT_YELLOW, false, format, ap);
   va_end (ap);
-  
-  reset_text_color (stderr);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -299,14 +493,11 @@ pcl::console::print_warn (FILE *stream, const char *format, ...)
 {
   if (!isVerbosityLevelEnabled (L_WARN)) return;
 
-  change_text_color (stream, TT_BRIGHT, TT_YELLOW);
   va_list ap;
 
   va_start (ap, format);
-  vfprintf (stream, format, ap);
+  vprint (stream, true, TT_BRIGHT, TT_YELLOW, false, format, ap);
   va_end (ap);
-  
-  reset_text_color (stream);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -315,14 +506,11 @@ pcl::console::print_value (const char *format, ...)
 {
   //if (!isVerbosityLevelEnabled (L_ALWAYS)) return;
 
-  change_text_color (stdout, TT_RESET, TT_CYAN);
   va_list ap;
 
   va_start (ap, format);
-  vfprintf (stdout, format, ap);
+  vprint (stdout, true, TT_RESET, TT_CYAN, false, format, ap);
   va_end (ap);
-  
-  reset_text_color (stdout);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -331,14 +519,11 @@ pcl::console::print_value (FILE *stream, const char *format, ...)
 {
   //if (!isVerbosityLevelEnabled (L_ALWAYS)) return;
 
-  change_text_color (stream, TT_RESET, TT_CYAN);
   va_list ap;
 
   va_start (ap, format);
-  vfprintf (stream, format, ap);
+  vprint (stream, true, TT_RESET, TT_CYAN, false, format, ap);
   va_end (ap);
-  
-  reset_text_color (stream);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -347,14 +532,11 @@ pcl::console::print_debug (const char *format, ...)
 {
   if (!isVerbosityLevelEnabled (L_DEBUG)) return;
 
-  change_text_color (stdout, TT_RESET, TT_GREEN);
   va_list ap;
 
   va_start (ap, format);
-  vfprintf (stdout, format, ap);
+  vprint (stdout, true, TT_RESET, TT_GREEN, false, format, ap);
   va_end (ap);
-  
-  reset_text_color (stdout);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -363,96 +545,115 @@ pcl::console::print_debug (FILE *stream, const char *format, ...)
 {
   if (!isVerbosityLevelEnabled (L_DEBUG)) return;
 
-  change_text_color (stream, TT_RESET, TT_GREEN);
   va_list ap;
 
   va_start (ap, format);
-  vfprintf (stream, format, ap);
+  vprint (stream, true, TT_RESET, TT_GREEN, false, format, ap);
   va_end (ap);
-  
-  reset_text_color (stream);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-namespace pcl
+namespace
 {
-  namespace console
+  pcl::console::VERBOSITY_LEVEL
+  readVerbosityLevel ()
   {
-    static bool s_NeedVerbosityInit = true;
 #ifdef VERBOSITY_LEVEL_ALWAYS
-  static VERBOSITY_LEVEL s_VerbosityLevel = pcl::console::L_ALWAYS; 
+    pcl::console::VERBOSITY_LEVEL level = pcl::console::L_ALWAYS;
 #elif defined VERBOSITY_LEVEL_ERROR
-  static VERBOSITY_LEVEL s_VerbosityLevel = pcl::console::L_ERROR;
+    pcl::console::VERBOSITY_LEVEL level = pcl::console::L_ERROR;
 #elif defined VERBOSITY_LEVEL_WARN
-  static VERBOSITY_LEVEL s_VerbosityLevel = pcl::console::L_WARN;
+    pcl::console::VERBOSITY_LEVEL level = pcl::console::L_WARN;
 #elif defined VERBOSITY_LEVEL_DEBUG
-  static VERBOSITY_LEVEL s_VerbosityLevel = pcl::console::L_DEBUG;
+    pcl::console::VERBOSITY_LEVEL level = pcl::console::L_DEBUG;
 #elif defined VERBOSITY_LEVEL_VERBOSE
-  static VERBOSITY_LEVEL s_VerbosityLevel = pcl::console::L_VERBOSE; 
-#else 
-  static VERBOSITY_LEVEL s_VerbosityLevel = pcl::console::L_INFO; 
+    pcl::console::VERBOSITY_LEVEL level = pcl::console::L_VERBOSE;
+#else
+    pcl::console::VERBOSITY_LEVEL level = pcl::console::L_INFO; // Default value
 #endif
+
+    char* pcl_verbosity_level = getenv ( "PCL_VERBOSITY_LEVEL");
+    if (pcl_verbosity_level)
+    {
+      std::string s_pcl_verbosity_level (pcl_verbosity_level);
+      std::transform (s_pcl_verbosity_level.begin (), s_pcl_verbosity_level.end (), s_pcl_verbosity_level.begin (), toupper);
+
+      if (s_pcl_verbosity_level.find ("ALWAYS") != std::string::npos)          level = pcl::console::L_ALWAYS;
+      else if (s_pcl_verbosity_level.find ("ERROR") != std::string::npos)      level = pcl::console::L_ERROR;
+      else if (s_pcl_verbosity_level.find ("WARN") != std::string::npos)       level = pcl::console::L_WARN;
+      else if (s_pcl_verbosity_level.find ("INFO") != std::string::npos)       level = pcl::console::L_INFO;
+      else if (s_pcl_verbosity_level.find ("DEBUG") != std::string::npos)      level = pcl::console::L_DEBUG;
+      else if (s_pcl_verbosity_level.find ("VERBOSE") != std::string::npos)    level = pcl::console::L_VERBOSE;
+      else printf ("Warning: invalid PCL_VERBOSITY_LEVEL set (%s)\n", s_pcl_verbosity_level.c_str ());
+    }
+    return (level);
+  }
+
+  /** \brief The verbosity level, read from the environment the first time it is used. The level is checked on
+    * every message, so it is only loaded, without any lock.
+    */
+  std::atomic<pcl::console::VERBOSITY_LEVEL>&
+  verbosityLevel ()
+  {
+    static std::atomic<pcl::console::VERBOSITY_LEVEL> level (readVerbosityLevel ());
+    return (level);
   }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 void pcl::console::setVerbosityLevel (pcl::console::VERBOSITY_LEVEL level)
 {
-  if (s_NeedVerbosityInit) pcl::console::initVerbosityLevel ();
-  s_VerbosityLevel = level;
+  verbosityLevel ().store (level, std::memory_order_relaxed);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 pcl::console::VERBOSITY_LEVEL
 pcl::console::getVerbosityLevel ()
 {
-  if (s_NeedVerbosityInit) pcl::console::initVerbosityLevel ();
-  return s_VerbosityLevel;
+  return (verbosityLevel ().load (std::memory_order_relaxed));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 bool
 pcl::console::isVerbosityLevelEnabled (pcl::console::VERBOSITY_LEVEL level)
 {
-  if (s_NeedVerbosityInit) pcl::console::initVerbosityLevel ();
-  return level <= s_VerbosityLevel;  
+  return (level <= verbosityLevel ().load (std::memory_order_relaxed));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 bool 
 pcl::console::initVerbosityLevel ()
 {
-#ifdef VERBOSITY_LEVEL_ALWAYS
-  s_VerbosityLevel = pcl::console::L_ALWAYS; 
-#elif defined VERBOSITY_LEVEL_ERROR
-  s_VerbosityLevel = pcl::console::L_ERROR;
-#elif defined VERBOSITY_LEVEL_WARN
-  s_VerbosityLevel = pcl::console::L_WARN;
-#elif defined VERBOSITY_LEVEL_DEBUG
-  s_VerbosityLevel = pcl::console::L_DEBUG;
-#elif defined VERBOSITY_LEVEL_VERBOSE
-  s_VerbosityLevel = pcl::console::L_VERBOSE; 
-#else 
-  s_VerbosityLevel = pcl::console::L_INFO; // Default value
-#endif
+  verbosityLevel ().store (readVerbosityLevel (), std::memory_order_relaxed);
+  return true;
+}
 
-  char* pcl_verbosity_level = getenv ( "PCL_VERBOSITY_LEVEL");
-  if (pcl_verbosity_level)
-  {
-    std::string s_pcl_verbosity_level (pcl_verbosity_level);
-    std::transform (s_pcl_verbosity_level.begin (), s_pcl_verbosity_level.end (), s_pcl_verbosity_level.begin (), toupper);
-
-    if (s_pcl_verbosity_level.find ("ALWAYS") != std::string::npos)          s_VerbosityLevel = L_ALWAYS;
-    else if (s_pcl_verbosity_level.find ("ERROR") != std::string::npos)      s_VerbosityLevel = L_ERROR;
-    else if (s_pcl_verbosity_level.find ("WARN") != std::string::npos)       s_VerbosityLevel = L_WARN;
-    else if (s_pcl_verbosity_level.find ("INFO") != std::string::npos)       s_VerbosityLevel = L_INFO;
-    else if (s_pcl_verbosity_level.find ("DEBUG") != std::string::npos)      s_VerbosityLevel = L_DEBUG;
-    else if (s_pcl_verbosity_level.find ("VERBOSE") != std::string::npos)    s_VerbosityLevel = L_VERBOSE;
-    else printf ("Warning: invalid PCL_VERBOSITY_LEVEL set (%s)\n", s_pcl_verbosity_level.c_str ());
-  }
+////////////////////////////////////////////////////////////////////////////////
+void
+pcl::console::enableAsynchronousOutput (bool enable)
+{
+  if (enable)
+    asynchronous_output.start ();
+  else
+    asynchronous_output.stop ();
+}
 
-  s_NeedVerbosityInit = false;
-  return true;
+////////////////////////////////////////////////////////////////////////////////
+bool
+pcl::console::isAsynchronousOutputEnabled ()
+{
+  return (asynchronous_output.isEnabled ());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void
+pcl::console::flushOutput ()
+{
+  if (asynchronous_output.isEnabled ())
+    asynchronous_output.flush ();
+  std::lock_guard<std::mutex> lock (output_mutex);
+  fflush (stdout);
+  fflush (stderr);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -460,31 +661,32 @@ void
 pcl::console::print (pcl::console::VERBOSITY_LEVEL level, FILE *stream, const char *format, ...)
 {
   if (!isVerbosityLevelEnabled (level)) return;
+  bool colored = true;
+  int attribute = TT_RESET, fg = TT_WHITE;
   switch (level)
   {
     case L_DEBUG:
-      change_text_color (stream, TT_RESET, TT_GREEN);
+      attribute = TT_RESET; fg = TT_GREEN;
       break;
     case L_WARN:
-      change_text_color (stream, TT_BRIGHT, TT_YELLOW);
+      attribute = TT_BRIGHT; fg = TT_YELLOW;
       break;
     case L_ERROR:
-      change_text_color (stream, TT_BRIGHT, TT_RED);
+      attribute = TT_BRIGHT; fg = TT_RED;
       break;
     case L_ALWAYS:
     case L_INFO:
     case L_VERBOSE:
     default:
+      colored = false;
       break;
   }
 
   va_list ap;
 
   va_start (ap, format);
-  vfprintf (stream, format, ap);
+  vprint (stream, colored, attribute, fg, false, format, ap);
   va_end (ap);
-  
-  reset_text_color (stream);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -493,30 +695,30 @@ pcl::console::print (pcl::console::VERBOSITY_LEVEL level, const char *format, ..
 {
   if (!isVerbosityLevelEnabled (level)) return;
   FILE *stream = (level == L_WARN || level == L_ERROR) ? stderr : stdout;
+  bool colored = true;
+  int attribute = TT_RESET, fg = TT_WHITE;
   switch (level)
   {
     case L_DEBUG:
-      change_text_color (stream, TT_RESET, TT_GREEN);
+      attribute = TT_RESET; fg = TT_GREEN;
       break;
     case L_WARN:
-      change_text_color (stream, TT_BRIGHT, TT_YELLOW);
+      attribute = TT_BRIGHT; fg = TT_YELLOW;
       break;
     case L_ERROR:
-      change_text_color (stream, TT_BRIGHT, TT_RED);
+      attribute = TT_BRIGHT; fg = TT_RED;
       break;
     case L_ALWAYS:
     case L_INFO:
     case L_VERBOSE:
     default:
+      colored = false;
       break;
   }
-  
+
   va_list ap;
 
   va_start (ap, format);
-  vfprintf (stream, format, ap);
+  vprint (stream, colored, attribute, fg, false, format, ap);
   va_end (ap);
-  
-  reset_text_color (stream);
-
 }
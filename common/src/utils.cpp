@@ -0,0 +1,82 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2024-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <pcl/common/utils.h>
+
+#include <atomic>
+
+namespace
+{
+  /** \brief The process-wide limit, 0 meaning no limit. */
+  std::atomic<unsigned int> max_nr_threads {0};
+
+  /** \brief The limit of the innermost ScopedMaxNumberOfThreads of each thread. */
+  thread_local bool thread_max_nr_threads_set = false;
+  thread_local unsigned int thread_max_nr_threads = 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+void
+pcl::utils::setMaxNumberOfThreads (unsigned int nr_threads)
+{
+  max_nr_threads.store (nr_threads, std::memory_order_relaxed);
+}
+
+//////////////////////////////////////////////////////////////////////////
+unsigned int
+pcl::utils::getMaxNumberOfThreads ()
+{
+  if (thread_max_nr_threads_set)
+    return (thread_max_nr_threads);
+  return (max_nr_threads.load (std::memory_order_relaxed));
+}
+
+//////////////////////////////////////////////////////////////////////////
+pcl::utils::ScopedMaxNumberOfThreads::ScopedMaxNumberOfThreads (unsigned int nr_threads)
+  : previous_set_ (thread_max_nr_threads_set)
+  , previous_nr_threads_ (thread_max_nr_threads)
+{
+  thread_max_nr_threads_set = true;
+  thread_max_nr_threads = nr_threads;
+}
+
+//////////////////////////////////////////////////////////////////////////
+pcl::utils::ScopedMaxNumberOfThreads::~ScopedMaxNumberOfThreads ()
+{
+  thread_max_nr_threads_set = previous_set_;
+  thread_max_nr_threads = previous_nr_threads_;
+}
@@ -38,14 +38,12 @@
 #pragma once
 
 #include <pcl/cuda/point_cloud.h>
+#include <pcl/point_cloud_fwd.h>
 
 #include <pcl/pcl_exports.h>
 
 namespace pcl
 {
-  template <typename T>
-  class PointCloud;
-
   struct PointXYZRGB;
   struct PointXYZRGBNormal;
 
@@ -38,12 +38,10 @@
 #pragma once
 
 #include <pcl/cuda/point_cloud.h>
+#include <pcl/point_cloud_fwd.h>
 
 namespace pcl
 {
-  template <typename T>
-  class PointCloud;
-
   struct PointXYZRGB;
 
   namespace cuda
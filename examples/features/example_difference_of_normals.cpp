@@ -9,7 +9,7 @@
 #include <string>
 
 #include <pcl/io/pcd_io.h>
-#include <pcl/features/normal_3d_omp.h>
+#include <pcl/features/multiscale_normal_3d.h>
 #include <pcl/filters/conditional_removal.h>
 #include <pcl/segmentation/extract_clusters.h>
 #include <pcl/filters/voxel_grid.h>
@@ -17,7 +17,7 @@
 #include <pcl/features/don.h>
 
 #ifdef PCL_ONLY_CORE_POINT_TYPES
-#include <pcl/features/impl/normal_3d_omp.hpp>
+#include <pcl/features/impl/multiscale_normal_3d.hpp>
 #include <pcl/segmentation/impl/extract_clusters.hpp>
 #endif
 
@@ -106,7 +106,7 @@ int main (int argc, char *argv[])
   }
 
   // Compute normals using both small and large scales at each point
-  pcl::NormalEstimationOMP<PointT, PointNT> ne;
+  pcl::MultiscaleNormalEstimation<PointT, PointNT> ne;
   ne.setInputCloud (cloud);
         ne.setSearchMethod (tree);
 
@@ -122,25 +122,35 @@ int main (int argc, char *argv[])
   }
 
   //the normals calculated with the small scale
-  std::cout << "Calculating normals for scale..." << scale1 << std::endl;
   pcl::PointCloud<PointNT>::Ptr normals_small_scale (new pcl::PointCloud<PointNT>);
-
-  if(approx){
-    ne.setSearchSurface(small_cloud_downsampled);
-    }
-
-  ne.setRadiusSearch (scale1);
-  ne.compute (*normals_small_scale);
-
-  std::cout << "Calculating normals for scale..." << scale2 << std::endl;
   //the normals calculated with the large scale
   pcl::PointCloud<PointNT>::Ptr normals_large_scale (new pcl::PointCloud<PointNT>);
 
   if(approx){
+    // Each scale searches its own downsampled surface
+    std::cout << "Calculating normals for scale..." << scale1 << std::endl;
+    ne.setSearchSurface(small_cloud_downsampled);
+    ne.setRadiusSearch (scale1);
+    ne.compute (*normals_small_scale);
+
+    std::cout << "Calculating normals for scale..." << scale2 << std::endl;
     ne.setSearchSurface(large_cloud_downsampled);
+    ne.setRadiusSearch (scale2);
+    ne.compute (*normals_large_scale);
+  }
+  else{
+    // Both scales from a single neighbor search at the large scale
+    std::cout << "Calculating normals for scales..." << scale1 << " and " << scale2 << std::endl;
+    std::vector<pcl::PointCloud<PointNT>::Ptr> normals;
+    ne.setScales ({scale1, scale2});
+    ne.computeAtScales (normals);
+    if(normals.size () != 2){
+      std::cerr << "Error: Could not estimate the normals" << std::endl;
+      exit(EXIT_FAILURE);
+    }
+    normals_small_scale = normals[0];
+    normals_large_scale = normals[1];
   }
-  ne.setRadiusSearch (scale2);
-  ne.compute (*normals_large_scale);
 
   // Create output cloud for DoN results
   PointCloud<PointOutT>::Ptr doncloud (new pcl::PointCloud<PointOutT>);
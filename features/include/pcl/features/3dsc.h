@@ -179,6 +179,20 @@ namespace pcl
       bool
       computePoint (std::size_t index, const pcl::PointCloud<PointNT> &normals, float rf[9], std::vector<float> &desc);
 
+      /** \brief Estimate a descriptor for a given point, drawing the X axis of its reference frame from a given
+        * random number generator.
+        * \param[in] index the index of the point to estimate a descriptor for
+        * \param[in] normals a pointer to the set of normals
+        * \param[in] rf the reference frame
+        * \param[out] desc the resultant estimated descriptor
+        * \param[in,out] rng the random number generator used to draw the X axis
+        * \return true if the descriptor was computed successfully, false if there was an error
+        * (e.g. the nearest neighbor didn't return any neighbors)
+        */
+      bool
+      computePoint (std::size_t index, const pcl::PointCloud<PointNT> &normals, float rf[9], std::vector<float> &desc,
+                    std::mt19937 &rng) const;
+
       /** \brief Estimate the actual feature.
         * \param[out] output the resultant feature
         */
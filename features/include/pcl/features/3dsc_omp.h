@@ -0,0 +1,78 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved
+ */
+
+#pragma once
+
+#include <pcl/features/3dsc.h>
+
+namespace pcl
+{
+  /** \brief ShapeContext3DEstimationOMP estimates the 3D shape context descriptor of a given point cloud dataset
+    * containing points and normals, in parallel, using the OpenMP standard.
+    *
+    * The X axis of the reference frame of each point is drawn at random, as in \ref ShapeContext3DEstimation. A
+    * single random generator cannot be shared by the threads, so every point draws its axis from its own generator,
+    * seeded from the generator of the class and the position of the point. The descriptors do not depend on the
+    * number of threads, and are repeatable when the seed is not random, but they are not the same as the ones of
+    * ShapeContext3DEstimation, whose points draw their axes one after the other from a single generator.
+    *
+    * The suggested PointOutT is pcl::ShapeContext1980
+    *
+    * \ingroup features
+    */
+  template <typename PointInT, typename PointNT, typename PointOutT = pcl::ShapeContext1980>
+  class ShapeContext3DEstimationOMP : public ShapeContext3DEstimation<PointInT, PointNT, PointOutT>
+  {
+    public:
+      using Ptr = shared_ptr<ShapeContext3DEstimationOMP<PointInT, PointNT, PointOutT> >;
+      using ConstPtr = shared_ptr<const ShapeContext3DEstimationOMP<PointInT, PointNT, PointOutT> >;
+
+      using Feature<PointInT, PointOutT>::feature_name_;
+      using Feature<PointInT, PointOutT>::indices_;
+      using Feature<PointInT, PointOutT>::input_;
+      using FeatureFromNormals<PointInT, PointNT, PointOutT>::normals_;
+      using ShapeContext3DEstimation<PointInT, PointNT, PointOutT>::descriptor_length_;
+      using ShapeContext3DEstimation<PointInT, PointNT, PointOutT>::rng_;
+
+      using PointCloudOut = typename Feature<PointInT, PointOutT>::PointCloudOut;
+
+      /** \brief Constructor.
+        * \param[in] random If true the random seed is set to current time, else it is
+        * set to 12345 prior to computing the descriptor (used to select X axis)
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      ShapeContext3DEstimationOMP (bool random = false, unsigned int nr_threads = 0)
+        : ShapeContext3DEstimation<PointInT, PointNT, PointOutT> (random)
+      {
+        feature_name_ = "ShapeContext3DEstimationOMP";
+
+        setNumberOfThreads (nr_threads);
+      }
+
+      /** \brief Initialize the scheduler and set the number of threads to use.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      void
+      setNumberOfThreads (unsigned int nr_threads = 0);
+
+    protected:
+      /** \brief Estimate the actual feature.
+        * \param[out] output the resultant feature
+        */
+      void
+      computeFeature (PointCloudOut &output) override;
+
+      /** \brief The number of threads the scheduler should use. */
+      unsigned int threads_;
+  };
+}
+
+#ifdef PCL_NO_PRECOMPILE
+#include <pcl/features/impl/3dsc_omp.hpp>
+#endif
@@ -0,0 +1,70 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved
+ */
+
+#pragma once
+
+#include <pcl/features/boundary.h>
+
+namespace pcl
+{
+  /** \brief BoundaryEstimationOMP estimates whether a set of points is lying on surface boundaries using an angle
+    * criterion, in parallel, using the OpenMP standard.
+    * \ingroup features
+    */
+  template <typename PointInT, typename PointNT, typename PointOutT>
+  class BoundaryEstimationOMP : public BoundaryEstimation<PointInT, PointNT, PointOutT>
+  {
+    public:
+      using Ptr = shared_ptr<BoundaryEstimationOMP<PointInT, PointNT, PointOutT> >;
+      using ConstPtr = shared_ptr<const BoundaryEstimationOMP<PointInT, PointNT, PointOutT> >;
+
+      using Feature<PointInT, PointOutT>::feature_name_;
+      using Feature<PointInT, PointOutT>::input_;
+      using Feature<PointInT, PointOutT>::indices_;
+      using Feature<PointInT, PointOutT>::k_;
+      using Feature<PointInT, PointOutT>::search_parameter_;
+      using Feature<PointInT, PointOutT>::surface_;
+      using FeatureFromNormals<PointInT, PointNT, PointOutT>::normals_;
+      using BoundaryEstimation<PointInT, PointNT, PointOutT>::angle_threshold_;
+
+      using PointCloudOut = typename Feature<PointInT, PointOutT>::PointCloudOut;
+
+      /** \brief Initialize the scheduler and set the number of threads to use.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      BoundaryEstimationOMP (unsigned int nr_threads = 0)
+      {
+        feature_name_ = "BoundaryEstimationOMP";
+
+        setNumberOfThreads (nr_threads);
+      }
+
+      /** \brief Initialize the scheduler and set the number of threads to use.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      void
+      setNumberOfThreads (unsigned int nr_threads = 0);
+
+    protected:
+      /** \brief Estimate whether a set of points is lying on surface boundaries using an angle criterion for all points
+        * given in <setInputCloud (), setIndices ()> using the surface in setSearchSurface () and the spatial locator in
+        * setSearchMethod ()
+        * \param[out] output the resultant point cloud model dataset that contains boundary point estimates
+        */
+      void
+      computeFeature (PointCloudOut &output) override;
+
+      /** \brief The number of threads the scheduler should use. */
+      unsigned int threads_;
+  };
+}
+
+#ifdef PCL_NO_PRECOMPILE
+#include <pcl/features/impl/boundary_omp.hpp>
+#endif
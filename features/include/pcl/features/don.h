@@ -57,6 +57,8 @@ namespace pcl
    * feature estimation methods that extend FeatureFromNormals, which match the normals
    * with the search surface.
    *
+   * \note MultiscaleNormalEstimation estimates the normals of both scales with a single neighbor search.
+   *
    * \note For more information please see
    *    <b>Yani Ioannou. Automatic Urban Modelling using Mobile Urban LIDAR Data.
    *    Thesis (Master, Computing), Queen's University, March, 2010.</b>
@@ -43,6 +43,8 @@
 #include <pcl/features/feature.h>
 #define GRIDSIZE 64
 #define GRIDSIZE_H GRIDSIZE/2
+#include <cstdint>
+#include <ctime>
 #include <vector>
 
 namespace pcl
@@ -51,6 +53,10 @@ namespace pcl
     * dataset containing points. Shape functions are D2, D3, A3.  For more information about the ESF descriptor, see:
     * Walter Wohlkinger and Markus Vincze, "Ensemble of Shape Functions for 3D Object Classification", 
     * IEEE International Conference on Robotics and Biomimetics (IEEE-ROBIO), 2011
+    *
+    * The samples are drawn in fixed chunks, each with its own generator seeded from \ref setSeed, so that the
+    * descriptor of a cloud only depends on the seed and not on the number of threads. With a convergence threshold,
+    * the sampling stops as soon as the histogram changes less than the threshold between two rounds of samples.
     * \author Walter Wohlkinger
     * \ingroup features
     */
@@ -74,21 +80,52 @@ namespace pcl
       using PointCloudOut = typename Feature<PointInT, PointOutT>::PointCloudOut;
 
       /** \brief Empty constructor. */
-      ESFEstimation () : local_cloud_ ()
+      ESFEstimation () :
+        seed_ (static_cast<unsigned int> (time (nullptr))), sample_size_ (20000), convergence_threshold_ (0),
+        threads_ (1), lut_ (GRIDSIZE * GRIDSIZE * GRIDSIZE, 0), local_cloud_ ()
       {
         feature_name_ = "ESFEstimation";
-        lut_.resize (GRIDSIZE);
-        for (int i = 0; i < GRIDSIZE; ++i)
-        {
-          lut_[i].resize (GRIDSIZE);
-          for (int j = 0; j < GRIDSIZE; ++j)
-            lut_[i][j].resize (GRIDSIZE);
-        }
-        //lut_.resize (boost::extents[GRIDSIZE][GRIDSIZE][GRIDSIZE]);
         search_radius_ = 0;
         k_ = 5;
       }
 
+      /** \brief Set the seed of the random generators (the current time by default).
+        * \param[in] seed the seed, the same seed gives the same descriptors
+        */
+      inline void
+      setSeed (unsigned int seed) { seed_ = seed; }
+
+      /** \brief Get the seed of the random generators. */
+      inline unsigned int
+      getSeed () const { return (seed_); }
+
+      /** \brief Set the (maximum) number of point triples sampled from the cloud, 20000 by default.
+        * \param[in] sample_size the number of samples
+        */
+      inline void
+      setSampleSize (unsigned int sample_size) { sample_size_ = sample_size; }
+
+      /** \brief Get the (maximum) number of point triples sampled from the cloud. */
+      inline unsigned int
+      getSampleSize () const { return (sample_size_); }
+
+      /** \brief Stop the sampling before the sample size when the histogram converges.
+        * \param[in] threshold the L1 distance between the normalized histograms of two rounds of samples below
+        * which the sampling stops, 0 (the default) draws all the samples
+        */
+      inline void
+      setConvergenceThreshold (float threshold) { convergence_threshold_ = threshold; }
+
+      /** \brief Get the convergence threshold of the sampling. */
+      inline float
+      getConvergenceThreshold () const { return (convergence_threshold_); }
+
+      /** \brief Initialize the scheduler and set the number of threads to use.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      void
+      setNumberOfThreads (unsigned int nr_threads = 0);
+
       /** \brief Overloaded computed method from pcl::Feature.
         * \param[out] output the resultant point cloud model dataset containing the estimated features
         */
@@ -108,11 +145,47 @@ namespace pcl
       int
       lci (const int x1, const int y1, const int z1, 
            const int x2, const int y2, const int z2, 
-           float &ratio, int &incnt, int &pointcount);
+           float &ratio, int &incnt, int &pointcount) const;
      
       /** \brief ... */
       void
       computeESF (PointCloudIn &pc, std::vector<float> &hist);
+
+      /** \brief Draw the samples [begin, end) with their own generator.
+        * \param[in] pc the scaled cloud
+        * \param[in] voxels the voxels of the points of the cloud
+        * \param[in] chunk the index of the chunk of samples, which seeds the generator
+        * \param[in] begin the first sample
+        * \param[in] end past the last sample
+        * \param[out] d2v the D2 distances, three per sample
+        * \param[out] wt_d2 the IN, OUT, MIXED classes of the D2 distances
+        * \param[out] d3v the D3 areas, one per sample
+        * \param[out] wt_d3 the ratios of the D3 areas
+        * \param[out] partial the A3 IN, OUT, MIXED and the D2 ratio histograms of the chunk
+        */
+      void
+      sampleESF (const PointCloudIn &pc, const std::vector<Eigen::Vector3i> &voxels,
+                 std::size_t chunk, std::size_t begin, std::size_t end,
+                 std::vector<float> &d2v, std::vector<int> &wt_d2, std::vector<float> &d3v, std::vector<float> &wt_d3,
+                 float *partial) const;
+
+      /** \brief Build the normalized histogram of the first samples. */
+      void
+      accumulateESF (std::size_t nr_samples, std::size_t nr_chunks, const std::vector<float> &d2v,
+                     const std::vector<int> &wt_d2, const std::vector<float> &d3v, const std::vector<float> &wt_d3,
+                     const std::vector<float> &partials, std::vector<float> &hist) const;
+
+      /** \brief The seed of the random generators. */
+      unsigned int seed_;
+
+      /** \brief The (maximum) number of samples. */
+      unsigned int sample_size_;
+
+      /** \brief The L1 distance under which the histogram is converged, 0 to draw all the samples. */
+      float convergence_threshold_;
+
+      /** \brief The number of threads the scheduler should use. */
+      unsigned int threads_;
       
       /** \brief ... */
       void
@@ -128,8 +201,8 @@ namespace pcl
 
     private:
 
-      /** \brief ... */
-      std::vector<std::vector<std::vector<int> > > lut_;
+      /** \brief The occupied voxels of the grid, stored as [x][y][z] in a single array. */
+      std::vector<std::uint8_t> lut_;
       
       /** \brief ... */
       PointCloudIn local_cloud_;
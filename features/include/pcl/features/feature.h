@@ -49,6 +49,7 @@
 #include <pcl/pcl_base.h>
 #include <pcl/pcl_macros.h>
 #include <pcl/search/search.h>
+#include <pcl/features/neighborhood_cache.h>
 
 #include <functional>
 
@@ -126,13 +127,15 @@ namespace pcl
       using SearchMethod = std::function<int (std::size_t, double, std::vector<int> &, std::vector<float> &)>;
       using SearchMethodSurface = std::function<int (const PointCloudIn &cloud, std::size_t index, double, std::vector<int> &, std::vector<float> &)>;
 
+      using NeighborhoodCacheConstPtr = typename NeighborhoodCache<PointInT>::ConstPtr;
+
     public:
       /** \brief Empty constructor. */
       Feature () :
         feature_name_ (), search_method_surface_ (),
-        surface_(), tree_(),
+        surface_(), tree_(), neighborhood_cache_(),
         search_parameter_(0), search_radius_(0), k_(0),
-        fake_surface_(false)
+        spatial_query_order_(false), fake_surface_(false)
       {}
 
       /** \brief Empty destructor */
@@ -210,6 +213,39 @@ namespace pcl
         return (search_radius_);
       }
 
+      /** \brief Provide neighborhoods searched beforehand, shared with other features computed on the same points.
+        * \details The cache is used when it searched the same surface, with the same kind of search (radius or k) and
+        * a parameter at least as large as the one of this feature. The neighbors of the points which are not cached
+        * are searched with the search method.
+        * \param[in] cache the computed neighborhood cache, or a null pointer to search all the neighbors
+        */
+      inline void
+      setNeighborhoodCache (const NeighborhoodCacheConstPtr &cache) { neighborhood_cache_ = cache; }
+
+      /** \brief Get a pointer to the neighborhood cache used. */
+      inline NeighborhoodCacheConstPtr
+      getNeighborhoodCache () const
+      {
+        return (neighborhood_cache_);
+      }
+
+      /** \brief Set whether the points are processed along the Morton (Z-order) curve instead of in the order of the
+        * indices, so that consecutive neighbor queries visit the same parts of the search tree and of the surface,
+        * e.g. for clouds in acquisition order. The output stays in the order of the indices. Only the features
+        * which support it, like NormalEstimation, change their processing order.
+        * \param[in] spatial_query_order true to process the points in Morton order, false for the order of the
+        * indices (default)
+        */
+      inline void
+      setSpatialQueryOrder (bool spatial_query_order) { spatial_query_order_ = spatial_query_order; }
+
+      /** \brief Get whether the points are processed along the Morton (Z-order) curve. */
+      inline bool
+      getSpatialQueryOrder () const
+      {
+        return (spatial_query_order_);
+      }
+
       /** \brief Base method for feature estimation for all points given in
         * <setInputCloud (), setIndices ()> using the surface in setSearchSurface ()
         * and the spatial locator in setSearchMethod ()
@@ -233,6 +269,9 @@ namespace pcl
       /** \brief A pointer to the spatial search object. */
       KdTreePtr tree_;
 
+      /** \brief The neighborhoods searched beforehand, if any. */
+      NeighborhoodCacheConstPtr neighborhood_cache_;
+
       /** \brief The actual search parameter (from either \a search_radius_ or \a k_). */
       double search_parameter_;
 
@@ -242,6 +281,19 @@ namespace pcl
       /** \brief The number of K nearest neighbors to use for each point. */
       int k_;
 
+      /** \brief Whether the points are processed along the Morton curve. */
+      bool spatial_query_order_;
+
+      /** \brief The positions in \a indices_ in processing order, empty to process them in order. Set by initCompute. */
+      Indices query_order_;
+
+      /** \brief Get the position in \a indices_ of the i-th point to process. */
+      inline std::size_t
+      getQueryPosition (std::size_t i) const
+      {
+        return (query_order_.empty () ? i : static_cast<std::size_t> (query_order_[i]));
+      }
+
       /** \brief Get a string representation of the name of this class. */
       inline const std::string&
       getClassName () const { return (feature_name_); }
@@ -41,7 +41,10 @@
 #pragma once
 
 #include <pcl/features/feature.h>
+
+#include <cstdint>
 #include <set>
+#include <vector>
 
 namespace pcl
 {
@@ -91,11 +94,15 @@ namespace pcl
       using FeatureFromNormals<PointInT, PointNT, PointOutT>::normals_;
 
       using PointCloudOut = typename Feature<PointInT, PointOutT>::PointCloudOut;
+      using PointCloudInConstPtr = typename Feature<PointInT, PointOutT>::PointCloudInConstPtr;
+      using PointCloudNConstPtr = typename FeatureFromNormals<PointInT, PointNT, PointOutT>::PointCloudNConstPtr;
+      using KdTreePtr = typename Feature<PointInT, PointOutT>::KdTreePtr;
 
       /** \brief Empty constructor. */
       FPFHEstimation () : 
         nr_bins_f1_ (11), nr_bins_f2_ (11), nr_bins_f3_ (11), 
-        d_pi_ (1.0f / (2.0f * static_cast<float> (M_PI)))
+        d_pi_ (1.0f / (2.0f * static_cast<float> (M_PI))),
+        reuse_spfh_ (false), compact_spfh_ (false)
       {
         feature_name_ = "FPFHEstimation";
       };
@@ -177,6 +184,69 @@ namespace pcl
         nr_bins_f3 = nr_bins_f3_;
       }
 
+      /** \brief Set whether the SPFH signatures of the surface points are kept between the calls to compute (), to
+        * estimate the FPFH signatures of overlapping sets of points (e.g. sliding windows over a map) without
+        * computing the SPFH signatures of the shared points again.
+        * \details The kept signatures are used while the surface, its normals, the search method, the search
+        * parameter and the subdivisions do not change. When the points or normals of the surface are modified in
+        * place, the points whose neighborhood changed have to be given to invalidateSPFHSignatures ().
+        * \param[in] reuse true to keep the SPFH signatures (default: false)
+        */
+      inline void
+      setReuseSPFHSignatures (bool reuse)
+      {
+        reuse_spfh_ = reuse;
+        if (!reuse_spfh_)
+          clearSPFHSignatures ();
+      }
+
+      /** \brief Get whether the SPFH signatures of the surface points are kept between the calls to compute (). */
+      inline bool
+      getReuseSPFHSignatures () const
+      {
+        return (reuse_spfh_);
+      }
+
+      /** \brief Set whether the kept SPFH signatures are stored on 16 bits per bin instead of 32.
+        * \details The bins of a SPFH signature are in [0, 100], they are stored as fixed point values with a
+        * precision of 100 / 65535, which halves the memory of the signatures kept for large surfaces.
+        * \param[in] compact true to store the kept signatures on 16 bits (default: false)
+        */
+      inline void
+      setCompactSPFHSignatures (bool compact)
+      {
+        if (compact != compact_spfh_)
+          clearSPFHSignatures ();
+        compact_spfh_ = compact;
+      }
+
+      /** \brief Get whether the kept SPFH signatures are stored on 16 bits per bin. */
+      inline bool
+      getCompactSPFHSignatures () const
+      {
+        return (compact_spfh_);
+      }
+
+      /** \brief Mark the kept SPFH signatures of some surface points to be computed again by the next compute ().
+        * \details The signatures of the neighbors of these points, in the surface at the time of the next
+        * compute (), are computed again too. Give both the points which changed and the points which were their
+        * neighbors before they changed.
+        * \param[in] indices the indices of the points in the surface
+        */
+      inline void
+      invalidateSPFHSignatures (const std::vector<int> &indices)
+      {
+        spfh_dirty_.insert (spfh_dirty_.end (), indices.cbegin (), indices.cend ());
+      }
+
+      /** \brief Drop all the kept SPFH signatures. */
+      inline void
+      clearSPFHSignatures ()
+      {
+        spfh_cache_ = SPFHCache ();
+        spfh_dirty_.clear ();
+      }
+
     protected:
 
       /** \brief Estimate the set of all SPFH (Simple Point Feature Histograms) signatures for the input cloud
@@ -189,6 +259,39 @@ namespace pcl
       computeSPFHSignatures (std::vector<int> &spf_hist_lookup, 
                              Eigen::MatrixXf &hist_f1, Eigen::MatrixXf &hist_f2, Eigen::MatrixXf &hist_f3);
 
+      /** \brief Prepare the kept SPFH signatures for the current surface: drop them if the surface or the search
+        * changed, invalidate the dirty points and their neighbors, and allocate the signatures of the points which
+        * have none yet. Only used when setReuseSPFHSignatures () is enabled.
+        * \param[in] spfh_indices the surface points whose SPFH signatures are needed
+        */
+      void
+      prepareSPFHSignatures (const std::vector<int> &spfh_indices);
+
+      /** \brief Copy the kept SPFH signature of a surface point, if it is valid, to a row of the histograms.
+        * \param[in] p_idx the index of the point in the surface
+        * \param[in] row the row of the histograms
+        * \param[out] hist_f1 the SPFH histograms for feature f1
+        * \param[out] hist_f2 the SPFH histograms for feature f2
+        * \param[out] hist_f3 the SPFH histograms for feature f3
+        * \return false if no valid signature of the point is kept
+        */
+      bool
+      loadSPFHSignature (int p_idx, int row,
+                         Eigen::MatrixXf &hist_f1, Eigen::MatrixXf &hist_f2, Eigen::MatrixXf &hist_f3) const;
+
+      /** \brief Keep the SPFH signature of a surface point from a row of the histograms.
+        * \note The signature of the point has to be allocated by prepareSPFHSignatures (), the signatures of
+        * different points can then be stored concurrently.
+        * \param[in] p_idx the index of the point in the surface
+        * \param[in] row the row of the histograms
+        * \param[in] hist_f1 the SPFH histograms for feature f1
+        * \param[in] hist_f2 the SPFH histograms for feature f2
+        * \param[in] hist_f3 the SPFH histograms for feature f3
+        */
+      void
+      storeSPFHSignature (int p_idx, int row,
+                          const Eigen::MatrixXf &hist_f1, const Eigen::MatrixXf &hist_f2, const Eigen::MatrixXf &hist_f3);
+
       /** \brief Estimate the Fast Point Feature Histograms (FPFH) descriptors at a set of points given by
         * <setInputCloud (), setIndices ()> using the surface in setSearchSurface () and the spatial locator in
         * setSearchMethod ()
@@ -214,6 +317,36 @@ namespace pcl
 
       /** \brief Float constant = 1.0 / (2.0 * M_PI) */
       float d_pi_; 
+
+      /** \brief Whether the SPFH signatures are kept between the calls to compute (). */
+      bool reuse_spfh_;
+
+      /** \brief Whether the kept SPFH signatures are stored on 16 bits per bin. */
+      bool compact_spfh_;
+
+    private:
+      /** \brief The SPFH signatures kept between the calls to compute (), with what they were computed from. */
+      struct SPFHCache
+      {
+        PointCloudInConstPtr surface;
+        PointCloudNConstPtr normals;
+        KdTreePtr tree;
+        double search_parameter = 0;
+        int nr_bins[3] = {0, 0, 0};
+        /** \brief The row of the signature of each surface point, -1 if it has none. */
+        std::vector<int> rows;
+        /** \brief Whether the signature of each row is up to date. */
+        std::vector<std::uint8_t> valid;
+        /** \brief The bins of the signatures, row after row, in one of the two formats. */
+        std::vector<float> values;
+        std::vector<std::uint16_t> compact_values;
+        std::size_t nr_rows = 0;
+      };
+
+      SPFHCache spfh_cache_;
+
+      /** \brief The surface points whose kept signature has to be computed again, with their neighbors. */
+      std::vector<int> spfh_dirty_;
   };
 }
 
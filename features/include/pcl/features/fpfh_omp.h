@@ -87,6 +87,7 @@ namespace pcl
       using FPFHEstimation<PointInT, PointNT, PointOutT>::hist_f1_;
       using FPFHEstimation<PointInT, PointNT, PointOutT>::hist_f2_;
       using FPFHEstimation<PointInT, PointNT, PointOutT>::hist_f3_;
+      using FPFHEstimation<PointInT, PointNT, PointOutT>::reuse_spfh_;
       using FPFHEstimation<PointInT, PointNT, PointOutT>::weightPointSPFHSignature;
 
       using PointCloudOut = typename Feature<PointInT, PointOutT>::PointCloudOut;
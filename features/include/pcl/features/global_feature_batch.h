@@ -0,0 +1,104 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved
+ */
+
+#pragma once
+
+#include <pcl/memory.h>
+#include <pcl/point_cloud.h>
+#include <pcl/PointIndices.h>
+
+#include <vector>
+
+namespace pcl
+{
+  /** \brief GlobalFeatureBatch computes a global descriptor (e.g. VFH, CVFH, OUR-CVFH, ESF or GASD) for every
+    * cluster of a cloud, in parallel, using the OpenMP standard.
+    *
+    * The estimator given to the batch is a configured prototype: its input cloud is the cloud of the clusters, and
+    * its normals, when it estimates a feature from normals, are the normals of this cloud. Every cluster is copied in
+    * a cloud of its own (with its normals) and its descriptors are computed as if this cloud had been given to
+    * \ref PCLBase::setInputCloud of the prototype. Every thread works with its own copy of the prototype, so that the
+    * per-estimator setup (e.g. the lookup tables of ESF) is done once per thread instead of once per cluster.
+    *
+    * The search surface, the indices and the search method of the prototype are not used: every copy searches the
+    * cluster it is given with its own default search method.
+    *
+    * \code
+    * pcl::VFHEstimation<pcl::PointXYZ, pcl::Normal, pcl::VFHSignature308> vfh;
+    * vfh.setInputCloud (scene);
+    * vfh.setInputNormals (scene_normals);
+    * pcl::GlobalFeatureBatch<pcl::VFHEstimation<pcl::PointXYZ, pcl::Normal, pcl::VFHSignature308> > batch (vfh);
+    * std::vector<pcl::PointCloud<pcl::VFHSignature308>::Ptr> descriptors;
+    * batch.compute (clusters, descriptors);  // one VFH signature per cluster
+    * \endcode
+    *
+    * \ingroup features
+    */
+  template <typename FeatureEstimation>
+  class GlobalFeatureBatch
+  {
+    public:
+      using Ptr = shared_ptr<GlobalFeatureBatch<FeatureEstimation> >;
+      using ConstPtr = shared_ptr<const GlobalFeatureBatch<FeatureEstimation> >;
+
+      using PointCloudIn = typename FeatureEstimation::PointCloud;
+      using PointCloudOut = typename FeatureEstimation::PointCloudOut;
+      using PointCloudOutPtr = typename PointCloudOut::Ptr;
+
+      /** \brief Constructor.
+        * \param[in] estimator the configured prototype of the estimators
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      GlobalFeatureBatch (const FeatureEstimation &estimator = FeatureEstimation (), unsigned int nr_threads = 0) :
+        estimator_ (estimator)
+      {
+        setNumberOfThreads (nr_threads);
+      }
+
+      /** \brief Set the configured prototype of the estimators.
+        * \param[in] estimator the prototype, which is copied
+        */
+      inline void
+      setFeatureEstimator (const FeatureEstimation &estimator) { estimator_ = estimator; }
+
+      /** \brief Get the prototype of the estimators. */
+      inline FeatureEstimation&
+      getFeatureEstimator ()
+      {
+        return (estimator_);
+      }
+
+      /** \brief Initialize the scheduler and set the number of threads to use.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      void
+      setNumberOfThreads (unsigned int nr_threads = 0);
+
+      /** \brief Compute the descriptors of every cluster of the input cloud of the prototype.
+        * \param[in] clusters the indices of the points of every cluster in the input cloud
+        * \param[out] descriptors the descriptors of every cluster, in the order of the clusters, an empty cloud when
+        * the estimation of a cluster fails
+        * \return false if the prototype has no input cloud
+        */
+      bool
+      compute (const std::vector<pcl::PointIndices> &clusters, std::vector<PointCloudOutPtr> &descriptors);
+
+    protected:
+      /** \brief The configured prototype of the estimators. */
+      FeatureEstimation estimator_;
+
+      /** \brief The number of threads the scheduler should use. */
+      unsigned int threads_;
+
+    public:
+      PCL_MAKE_ALIGNED_OPERATOR_NEW
+  };
+}
+
+#include <pcl/features/impl/global_feature_batch.hpp>
@@ -132,6 +132,15 @@ pcl::ShapeContext3DEstimation<PointInT, PointNT, PointOutT>::initCompute ()
 template <typename PointInT, typename PointNT, typename PointOutT> bool
 pcl::ShapeContext3DEstimation<PointInT, PointNT, PointOutT>::computePoint (
     std::size_t index, const pcl::PointCloud<PointNT> &normals, float rf[9], std::vector<float> &desc)
+{
+  return (computePoint (index, normals, rf, desc, rng_));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointNT, typename PointOutT> bool
+pcl::ShapeContext3DEstimation<PointInT, PointNT, PointOutT>::computePoint (
+    std::size_t index, const pcl::PointCloud<PointNT> &normals, float rf[9], std::vector<float> &desc,
+    std::mt19937 &rng) const
 {
   // The RF is formed as this x_axis | y_axis | normal
   Eigen::Map<Eigen::Vector3f> x_axis (rf);
@@ -159,9 +168,10 @@ pcl::ShapeContext3DEstimation<PointInT, PointNT, PointOutT>::computePoint (
   normal = normals[minIndex].getNormalVector3fMap ();
 
   // Compute and store the RF direction
-  x_axis[0] = rnd ();
-  x_axis[1] = rnd ();
-  x_axis[2] = rnd ();
+  std::uniform_real_distribution<float> rng_dist (rng_dist_.param ());
+  x_axis[0] = rng_dist (rng);
+  x_axis[1] = rng_dist (rng);
+  x_axis[2] = rng_dist (rng);
   if (!pcl::utils::equal (normal[2], 0.0f))
     x_axis[2] = - (normal[0]*x_axis[0] + normal[1]*x_axis[1]) / normal[2];
   else if (!pcl::utils::equal (normal[1], 0.0f))
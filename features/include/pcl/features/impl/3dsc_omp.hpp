@@ -0,0 +1,72 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved
+ */
+
+#ifndef PCL_FEATURES_IMPL_3DSC_OMP_HPP_
+#define PCL_FEATURES_IMPL_3DSC_OMP_HPP_
+
+#include <pcl/features/3dsc_omp.h>
+#include <pcl/common/point_tests.h> // for pcl::isFinite
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointNT, typename PointOutT> void
+pcl::ShapeContext3DEstimationOMP<PointInT, PointNT, PointOutT>::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs ();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointNT, typename PointOutT> void
+pcl::ShapeContext3DEstimationOMP<PointInT, PointNT, PointOutT>::computeFeature (PointCloudOut &output)
+{
+  assert (descriptor_length_ == 1980);
+
+  // The generator of every point is seeded from the one of the class and the position of the point
+  std::mt19937::result_type seed = rng_ ();
+
+  output.is_dense = true;
+  // Iterate over all points and compute the descriptors
+#pragma omp parallel for \
+  default(none) \
+  shared(output, seed) \
+  num_threads(threads_) \
+  schedule(dynamic, 64)
+  for (std::ptrdiff_t point_index = 0; point_index < static_cast<std::ptrdiff_t> (indices_->size ()); point_index++)
+  {
+    // If the point is not finite, set the descriptor to NaN and continue
+    if (!isFinite ((*input_)[(*indices_)[point_index]]))
+    {
+      std::fill (output[point_index].descriptor, output[point_index].descriptor + descriptor_length_,
+                 std::numeric_limits<float>::quiet_NaN ());
+      std::fill (output[point_index].rf, output[point_index].rf + 9, 0);
+      output.is_dense = false;
+      continue;
+    }
+
+    std::mt19937 rng (seed + static_cast<std::mt19937::result_type> (point_index));
+    std::vector<float> descriptor (descriptor_length_);
+    if (!this->computePoint (point_index, *normals_, output[point_index].rf, descriptor, rng))
+      output.is_dense = false;
+    std::copy (descriptor.begin (), descriptor.end (), output[point_index].descriptor);
+  }
+}
+
+#define PCL_INSTANTIATE_ShapeContext3DEstimationOMP(T,NT,OutT) template class PCL_EXPORTS pcl::ShapeContext3DEstimationOMP<T,NT,OutT>;
+
+#endif  // PCL_FEATURES_IMPL_3DSC_OMP_HPP_
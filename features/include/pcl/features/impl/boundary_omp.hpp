@@ -0,0 +1,75 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved
+ */
+
+#ifndef PCL_FEATURES_IMPL_BOUNDARY_OMP_HPP_
+#define PCL_FEATURES_IMPL_BOUNDARY_OMP_HPP_
+
+#include <pcl/features/boundary_omp.h>
+#include <pcl/common/point_tests.h> // for pcl::isFinite
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointNT, typename PointOutT> void
+pcl::BoundaryEstimationOMP<PointInT, PointNT, PointOutT>::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs ();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointNT, typename PointOutT> void
+pcl::BoundaryEstimationOMP<PointInT, PointNT, PointOutT>::computeFeature (PointCloudOut &output)
+{
+  // Allocate enough space to hold the results
+  // \note This resize is irrelevant for a radiusSearch ().
+  std::vector<int> nn_indices (k_);
+  std::vector<float> nn_dists (k_);
+
+  output.is_dense = true;
+  // Save a few cycles by not checking every point for NaN/Inf values if the cloud is set to dense
+  const bool check_finite = !input_->is_dense;
+
+  // Iterating over the entire index vector
+#pragma omp parallel for \
+  default(none) \
+  shared(check_finite, output) \
+  firstprivate(nn_indices, nn_dists) \
+  num_threads(threads_) \
+  schedule(dynamic, 256)
+  for (std::ptrdiff_t idx = 0; idx < static_cast<std::ptrdiff_t> (indices_->size ()); ++idx)
+  {
+    if ((check_finite && !isFinite ((*input_)[(*indices_)[idx]])) ||
+        this->searchForNeighbors ((*indices_)[idx], search_parameter_, nn_indices, nn_dists) == 0)
+    {
+      output[idx].boundary_point = std::numeric_limits<std::uint8_t>::quiet_NaN ();
+      output.is_dense = false;
+      continue;
+    }
+
+    // Obtain a coordinate system on the least-squares plane
+    Eigen::Vector4f u, v;
+    this->getCoordinateSystemOnPlane ((*normals_)[(*indices_)[idx]], u, v);
+
+    // Estimate whether the point is lying on a boundary surface or not
+    output[idx].boundary_point = this->isBoundaryPoint (*surface_, (*input_)[(*indices_)[idx]], nn_indices, u, v, angle_threshold_);
+  }
+}
+
+#define PCL_INSTANTIATE_BoundaryEstimationOMP(T,NT,OutT) template class PCL_EXPORTS pcl::BoundaryEstimationOMP<T,NT,OutT>;
+
+#endif  // PCL_FEATURES_IMPL_BOUNDARY_OMP_HPP_
@@ -44,39 +44,104 @@
 #include <pcl/features/esf.h>
 #include <pcl/common/distances.h>
 #include <pcl/common/transforms.h>
+#include <algorithm>
+#include <limits>
+#include <random>
 #include <vector>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointOutT> void
+pcl::ESFEstimation<PointInT, PointOutT>::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs ();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointInT, typename PointOutT> void
 pcl::ESFEstimation<PointInT, PointOutT>::computeESF (
     PointCloudIn &pc, std::vector<float> &hist)
 {
   const int binsize = 64;
-  unsigned int sample_size = 20000;
-  // @TODO: Replace with c++ stdlib uniform_random_generator
-  srand (static_cast<unsigned int> (time (nullptr)));
-  const auto maxindex = pc.size ();
-
-  std::vector<float> d2v, d1v, d3v, wt_d3;
-  std::vector<int> wt_d2;
-  d1v.reserve (sample_size);
-  d2v.reserve (sample_size * 3);
-  d3v.reserve (sample_size);
-  wt_d2.reserve (sample_size * 3);
-  wt_d3.reserve (sample_size);
+  // The samples are drawn in chunks with their own generators, and the convergence is checked after each round
+  const std::size_t chunk_size = 250;
+  const std::size_t round_chunks = 8;
+  const std::size_t sample_size = sample_size_;
+  const std::size_t nr_chunks = (sample_size + chunk_size - 1) / chunk_size;
+
+  // The voxels of the points, which are the ends of the traced lines
+  std::vector<Eigen::Vector3i> voxels (pc.size ());
+  for (std::size_t i = 0; i < pc.size (); ++i)
+  {
+    const Eigen::Vector4f p = pc[i].getVector4fMap ();
+    for (int k = 0; k < 3; ++k)
+      voxels[i][k] = p[k] < 0.0? static_cast<int>(std::floor(p[k])+GRIDSIZE_H): static_cast<int>(std::ceil(p[k])+GRIDSIZE_H-1);
+  }
 
-  float h_in[binsize] = {0};
-  float h_out[binsize] = {0};
-  float h_mix[binsize] = {0};
-  float h_mix_ratio[binsize] = {0};
+  std::vector<float> d2v (sample_size * 3), d3v (sample_size), wt_d3 (sample_size);
+  std::vector<int> wt_d2 (sample_size * 3);
+  std::vector<float> partials (nr_chunks * binsize * 4, 0.0f);
 
-  float h_a3_in[binsize] = {0};
-  float h_a3_out[binsize] = {0};
-  float h_a3_mix[binsize] = {0};
+  std::vector<float> previous;
+  std::size_t chunks_done = 0;
+  while (chunks_done < nr_chunks)
+  {
+    const std::size_t round_end = (convergence_threshold_ > 0 ? std::min (nr_chunks, chunks_done + round_chunks) : nr_chunks);
+
+#pragma omp parallel for \
+  default(none) \
+  shared(chunks_done, d2v, d3v, partials, pc, round_end, sample_size, voxels, wt_d2, wt_d3) \
+  num_threads(threads_) \
+  schedule(dynamic, 1)
+    for (std::ptrdiff_t chunk = chunks_done; chunk < static_cast<std::ptrdiff_t> (round_end); ++chunk)
+    {
+      const std::size_t begin = chunk * chunk_size;
+      const std::size_t end = std::min (sample_size, begin + chunk_size);
+      this->sampleESF (pc, voxels, chunk, begin, end, d2v, wt_d2, d3v, wt_d3, &partials[chunk * binsize * 4]);
+    }
+    chunks_done = round_end;
 
-  float h_d3_in[binsize] = {0};
-  float h_d3_out[binsize] = {0};
-  float h_d3_mix[binsize] = {0};
+    hist.clear ();
+    accumulateESF (std::min (sample_size, chunks_done * chunk_size), chunks_done, d2v, wt_d2, d3v, wt_d3, partials, hist);
+    if (convergence_threshold_ > 0 && !previous.empty ())
+    {
+      float distance = 0;
+      for (std::size_t i = 0; i < hist.size (); ++i)
+        distance += std::abs (hist[i] - previous[i]);
+      if (distance < convergence_threshold_)
+        break;
+    }
+    previous = hist;
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointOutT> void
+pcl::ESFEstimation<PointInT, PointOutT>::sampleESF (
+    const PointCloudIn &pc, const std::vector<Eigen::Vector3i> &voxels,
+    std::size_t chunk, std::size_t begin, std::size_t end,
+    std::vector<float> &d2v, std::vector<int> &wt_d2, std::vector<float> &d3v, std::vector<float> &wt_d3,
+    float *partial) const
+{
+  const int binsize = 64;
+  std::seed_seq seq {seed_, static_cast<unsigned int> (chunk)};
+  std::mt19937 rng (seq);
+  std::uniform_int_distribution<std::size_t> dist (0, pc.size () - 1);
+
+  float *h_a3_in = partial;
+  float *h_a3_out = partial + binsize;
+  float *h_a3_mix = partial + 2 * binsize;
+  float *h_mix_ratio = partial + 3 * binsize;
 
   float ratio=0.0;
   float pih = static_cast<float>(M_PI) / 2.0f;
@@ -84,12 +149,12 @@ pcl::ESFEstimation<PointInT, PointOutT>::computeESF (
   int th1,th2,th3;
   int vxlcnt = 0;
   int pcnt1,pcnt2,pcnt3;
-  for (std::size_t nn_idx = 0; nn_idx < sample_size; ++nn_idx)
+  for (std::size_t nn_idx = begin; nn_idx < end; ++nn_idx)
   {
     // get a new random point
-    int index1 = rand()%maxindex;
-    int index2 = rand()%maxindex;
-    int index3 = rand()%maxindex;
+    const std::size_t index1 = dist (rng);
+    const std::size_t index2 = dist (rng);
+    const std::size_t index3 = dist (rng);
 
     if (index1==index2 || index1 == index3 || index2 == index3)
     {
@@ -137,60 +202,32 @@ pcl::ESFEstimation<PointInT, PointOutT>::computeESF (
     }
 
     // D2
-    d2v.push_back (pcl::euclideanDistance (pc[index1], pc[index2]));
-    d2v.push_back (pcl::euclideanDistance (pc[index1], pc[index3]));
-    d2v.push_back (pcl::euclideanDistance (pc[index2], pc[index3]));
+    d2v[3 * nn_idx] = pcl::euclideanDistance (pc[index1], pc[index2]);
+    d2v[3 * nn_idx + 1] = pcl::euclideanDistance (pc[index1], pc[index3]);
+    d2v[3 * nn_idx + 2] = pcl::euclideanDistance (pc[index2], pc[index3]);
 
     int vxlcnt_sum = 0;
     int p_cnt = 0;
-    // IN, OUT, MIXED, Ratio line tracing, index1->index2
+    // IN, OUT, MIXED, Ratio line tracing, index1->index2, index1->index3 and index2->index3
+    const std::size_t starts[3] = {index1, index1, index2};
+    const std::size_t targets[3] = {index2, index3, index3};
+    int *pcnts[3] = {&pcnt1, &pcnt2, &pcnt3};
+    for (int line = 0; line < 3; ++line)
     {
-      const int xs = p1[0] < 0.0? static_cast<int>(std::floor(p1[0])+GRIDSIZE_H): static_cast<int>(std::ceil(p1[0])+GRIDSIZE_H-1);
-      const int ys = p1[1] < 0.0? static_cast<int>(std::floor(p1[1])+GRIDSIZE_H): static_cast<int>(std::ceil(p1[1])+GRIDSIZE_H-1);
-      const int zs = p1[2] < 0.0? static_cast<int>(std::floor(p1[2])+GRIDSIZE_H): static_cast<int>(std::ceil(p1[2])+GRIDSIZE_H-1);
-      const int xt = p2[0] < 0.0? static_cast<int>(std::floor(p2[0])+GRIDSIZE_H): static_cast<int>(std::ceil(p2[0])+GRIDSIZE_H-1);
-      const int yt = p2[1] < 0.0? static_cast<int>(std::floor(p2[1])+GRIDSIZE_H): static_cast<int>(std::ceil(p2[1])+GRIDSIZE_H-1);
-      const int zt = p2[2] < 0.0? static_cast<int>(std::floor(p2[2])+GRIDSIZE_H): static_cast<int>(std::ceil(p2[2])+GRIDSIZE_H-1);
-      wt_d2.push_back (this->lci (xs, ys, zs, xt, yt, zt, ratio, vxlcnt, pcnt1));
-      if (wt_d2.back () == 2)
+      const Eigen::Vector3i &vs = voxels[starts[line]];
+      const Eigen::Vector3i &vt = voxels[targets[line]];
+      wt_d2[3 * nn_idx + line] = this->lci (vs[0], vs[1], vs[2], vt[0], vt[1], vt[2], ratio, vxlcnt, *pcnts[line]);
+      if (wt_d2[3 * nn_idx + line] == 2)
         h_mix_ratio[static_cast<int> (pcl_round (ratio * (binsize-1)))]++;
       vxlcnt_sum += vxlcnt;
-      p_cnt += pcnt1;
-    }
-    // IN, OUT, MIXED, Ratio line tracing, index1->index3
-    {
-      const int xs = p1[0] < 0.0? static_cast<int>(std::floor(p1[0])+GRIDSIZE_H): static_cast<int>(std::ceil(p1[0])+GRIDSIZE_H-1);
-      const int ys = p1[1] < 0.0? static_cast<int>(std::floor(p1[1])+GRIDSIZE_H): static_cast<int>(std::ceil(p1[1])+GRIDSIZE_H-1);
-      const int zs = p1[2] < 0.0? static_cast<int>(std::floor(p1[2])+GRIDSIZE_H): static_cast<int>(std::ceil(p1[2])+GRIDSIZE_H-1);
-      const int xt = p3[0] < 0.0? static_cast<int>(std::floor(p3[0])+GRIDSIZE_H): static_cast<int>(std::ceil(p3[0])+GRIDSIZE_H-1);
-      const int yt = p3[1] < 0.0? static_cast<int>(std::floor(p3[1])+GRIDSIZE_H): static_cast<int>(std::ceil(p3[1])+GRIDSIZE_H-1);
-      const int zt = p3[2] < 0.0? static_cast<int>(std::floor(p3[2])+GRIDSIZE_H): static_cast<int>(std::ceil(p3[2])+GRIDSIZE_H-1);
-      wt_d2.push_back (this->lci (xs, ys, zs, xt, yt, zt, ratio, vxlcnt, pcnt2));
-      if (wt_d2.back () == 2)
-        h_mix_ratio[static_cast<int>(pcl_round (ratio * (binsize-1)))]++;
-      vxlcnt_sum += vxlcnt;
-      p_cnt += pcnt2;
-    }
-    // IN, OUT, MIXED, Ratio line tracing, index2->index3
-    {
-      const int xs = p2[0] < 0.0? static_cast<int>(std::floor(p2[0])+GRIDSIZE_H): static_cast<int>(std::ceil(p2[0])+GRIDSIZE_H-1);
-      const int ys = p2[1] < 0.0? static_cast<int>(std::floor(p2[1])+GRIDSIZE_H): static_cast<int>(std::ceil(p2[1])+GRIDSIZE_H-1);
-      const int zs = p2[2] < 0.0? static_cast<int>(std::floor(p2[2])+GRIDSIZE_H): static_cast<int>(std::ceil(p2[2])+GRIDSIZE_H-1);
-      const int xt = p3[0] < 0.0? static_cast<int>(std::floor(p3[0])+GRIDSIZE_H): static_cast<int>(std::ceil(p3[0])+GRIDSIZE_H-1);
-      const int yt = p3[1] < 0.0? static_cast<int>(std::floor(p3[1])+GRIDSIZE_H): static_cast<int>(std::ceil(p3[1])+GRIDSIZE_H-1);
-      const int zt = p3[2] < 0.0? static_cast<int>(std::floor(p3[2])+GRIDSIZE_H): static_cast<int>(std::ceil(p3[2])+GRIDSIZE_H-1);
-      wt_d2.push_back (this->lci (xs,ys,zs,xt,yt,zt,ratio,vxlcnt,pcnt3));
-      if (wt_d2.back () == 2)
-        h_mix_ratio[static_cast<int>(pcl_round(ratio * (binsize-1)))]++;
-      vxlcnt_sum += vxlcnt;
-      p_cnt += pcnt3;
+      p_cnt += *pcnts[line];
     }
 
     // D3 ( herons formula )
-    d3v.push_back (std::sqrt (std::sqrt (s * (s-a) * (s-b) * (s-c))));
+    d3v[nn_idx] = std::sqrt (std::sqrt (s * (s-a) * (s-b) * (s-c)));
     if (vxlcnt_sum <= 21)
     {
-      wt_d3.push_back (0);
+      wt_d3[nn_idx] = 0;
       h_a3_out[th1] += static_cast<float> (pcnt3) / 32.0f;
       h_a3_out[th2] += static_cast<float> (pcnt1) / 32.0f;
       h_a3_out[th3] += static_cast<float> (pcnt2) / 32.0f;
@@ -201,36 +238,72 @@ pcl::ESFEstimation<PointInT, PointOutT>::computeESF (
         h_a3_in[th1] += static_cast<float> (pcnt3) / 32.0f;
         h_a3_in[th2] += static_cast<float> (pcnt1) / 32.0f;
         h_a3_in[th3] += static_cast<float> (pcnt2) / 32.0f;
-        wt_d3.push_back (1);
+        wt_d3[nn_idx] = 1;
       }
       else
       {
         h_a3_mix[th1] += static_cast<float> (pcnt3) / 32.0f;
         h_a3_mix[th2] += static_cast<float> (pcnt1) / 32.0f;
         h_a3_mix[th3] += static_cast<float> (pcnt2) / 32.0f;
-        wt_d3.push_back (static_cast<float> (vxlcnt_sum) / static_cast<float> (p_cnt));
+        wt_d3[nn_idx] = static_cast<float> (vxlcnt_sum) / static_cast<float> (p_cnt);
       }
   }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointOutT> void
+pcl::ESFEstimation<PointInT, PointOutT>::accumulateESF (
+    std::size_t nr_samples, std::size_t nr_chunks, const std::vector<float> &d2v,
+    const std::vector<int> &wt_d2, const std::vector<float> &d3v, const std::vector<float> &wt_d3,
+    const std::vector<float> &partials, std::vector<float> &hist) const
+{
+  const int binsize = 64;
+  float h_in[binsize] = {0};
+  float h_out[binsize] = {0};
+  float h_mix[binsize] = {0};
+  float h_mix_ratio[binsize] = {0};
+
+  float h_a3_in[binsize] = {0};
+  float h_a3_out[binsize] = {0};
+  float h_a3_mix[binsize] = {0};
+
+  float h_d3_in[binsize] = {0};
+  float h_d3_out[binsize] = {0};
+  float h_d3_mix[binsize] = {0};
+
+  // The A3 and ratio histograms of the chunks, summed in the order of the chunks
+  for (std::size_t chunk = 0; chunk < nr_chunks; ++chunk)
+  {
+    const float *partial = &partials[chunk * binsize * 4];
+    for (int i = 0; i < binsize; ++i)
+    {
+      h_a3_in[i] += partial[i];
+      h_a3_out[i] += partial[binsize + i];
+      h_a3_mix[i] += partial[2 * binsize + i];
+      h_mix_ratio[i] += partial[3 * binsize + i];
+    }
+  }
+
   // Normalizing, get max
   float maxd2 = 0;
   float maxd3 = 0;
 
-  for (std::size_t nn_idx = 0; nn_idx < sample_size; ++nn_idx)
+  for (std::size_t nn_idx = 0; nn_idx < nr_samples; ++nn_idx)
   {
     // get max of Dx
-    if (d2v[nn_idx] > maxd2)
-      maxd2 = d2v[nn_idx];
-    if (d2v[sample_size + nn_idx] > maxd2)
-      maxd2 = d2v[sample_size + nn_idx];
-    if (d2v[sample_size*2 +nn_idx] > maxd2)
-      maxd2 = d2v[sample_size*2 +nn_idx];
+    if (d2v[3 * nn_idx] > maxd2)
+      maxd2 = d2v[3 * nn_idx];
+    if (d2v[3 * nn_idx + 1] > maxd2)
+      maxd2 = d2v[3 * nn_idx + 1];
+    if (d2v[3 * nn_idx + 2] > maxd2)
+      maxd2 = d2v[3 * nn_idx + 2];
     if (d3v[nn_idx] > maxd3)
       maxd3 = d3v[nn_idx];
   }
 
   // Normalize and create histogram
   int index;
-  for (std::size_t nn_idx = 0; nn_idx < sample_size; ++nn_idx)
+  for (std::size_t nn_idx = 0; nn_idx < nr_samples; ++nn_idx)
   {
     if (wt_d3[nn_idx] >= 0.999) // IN
     {
@@ -255,7 +328,7 @@ pcl::ESFEstimation<PointInT, PointOutT>::computeESF (
     }
   }
   //normalize and create histogram
-  for (std::size_t nn_idx = 0; nn_idx < d2v.size(); ++nn_idx )
+  for (std::size_t nn_idx = 0; nn_idx < 3 * nr_samples; ++nn_idx )
   {
     if (wt_d2[nn_idx] == 0)
       h_in[static_cast<int>(pcl_round (d2v[nn_idx] / maxd2 * (binsize-1)))]++ ;
@@ -305,7 +378,7 @@ template <typename PointInT, typename PointOutT> int
 pcl::ESFEstimation<PointInT, PointOutT>::lci (
     const int x1, const int y1, const int z1, 
     const int x2, const int y2, const int z2, 
-    float &ratio, int &incnt, int &pointcount)
+    float &ratio, int &incnt, int &pointcount) const
 {
   int voxelcount = 0;
   int voxel_in = 0;
@@ -342,7 +415,7 @@ pcl::ESFEstimation<PointInT, PointOutT>::lci (
     for (int i = 1; i<l; i++)
     {
       voxelcount++;;
-      voxel_in +=  static_cast<int>(lut_[act_voxel[0]][act_voxel[1]][act_voxel[2]] == 1);
+      voxel_in +=  static_cast<int>(lut_[(act_voxel[0] * GRIDSIZE + act_voxel[1]) * GRIDSIZE + act_voxel[2]] == 1);
       if (err_1 > 0)
       {
         act_voxel[1] += y_inc;
@@ -365,7 +438,7 @@ pcl::ESFEstimation<PointInT, PointOutT>::lci (
     for (int i=1; i<m; i++)
     {
       voxelcount++;
-      voxel_in +=  static_cast<int>(lut_[act_voxel[0]][act_voxel[1]][act_voxel[2]] == 1);
+      voxel_in +=  static_cast<int>(lut_[(act_voxel[0] * GRIDSIZE + act_voxel[1]) * GRIDSIZE + act_voxel[2]] == 1);
       if (err_1 > 0)
       {
         act_voxel[0] +=  x_inc;
@@ -388,7 +461,7 @@ pcl::ESFEstimation<PointInT, PointOutT>::lci (
     for (int i=1; i<n; i++)
     {
       voxelcount++;
-      voxel_in +=  static_cast<int>(lut_[act_voxel[0]][act_voxel[1]][act_voxel[2]] == 1);
+      voxel_in +=  static_cast<int>(lut_[(act_voxel[0] * GRIDSIZE + act_voxel[1]) * GRIDSIZE + act_voxel[2]] == 1);
       if (err_1 > 0)
       {
         act_voxel[1] += y_inc;
@@ -405,7 +478,7 @@ pcl::ESFEstimation<PointInT, PointOutT>::lci (
     }
   }
   voxelcount++;
-  voxel_in +=  static_cast<int>(lut_[act_voxel[0]][act_voxel[1]][act_voxel[2]] == 1);
+  voxel_in +=  static_cast<int>(lut_[(act_voxel[0] * GRIDSIZE + act_voxel[1]) * GRIDSIZE + act_voxel[2]] == 1);
   incnt = voxel_in;
   pointcount = voxelcount;
 
@@ -442,7 +515,7 @@ pcl::ESFEstimation<PointInT, PointOutT>::voxelize9 (PointCloudIn &cluster)
             ;
           }
           else
-            this->lut_[xi][yi][zi] = 1;
+            this->lut_[(xi * GRIDSIZE + yi) * GRIDSIZE + zi] = 1;
         }
   }
 }
@@ -470,7 +543,7 @@ pcl::ESFEstimation<PointInT, PointOutT>::cleanup9 (PointCloudIn &cluster)
             ;
           }
           else
-            this->lut_[xi][yi][zi] = 0;
+            this->lut_[(xi * GRIDSIZE + yi) * GRIDSIZE + zi] = 0;
         }
   }
 }
@@ -532,6 +605,22 @@ pcl::ESFEstimation<PointInT, PointOutT>::compute (PointCloudOut &output)
 template <typename PointInT, typename PointOutT> void
 pcl::ESFEstimation<PointInT, PointOutT>::computeFeature (PointCloudOut &output)
 {
+  // We only output _1_ signature
+  output.points.resize (1);
+  output.width = 1;
+  output.height = 1;
+
+  // Triples of distinct points cannot be sampled from less than three points
+  if (surface_->size () < 3 || sample_size_ == 0)
+  {
+    PCL_ERROR ("[pcl::%s::computeFeature] Cannot sample %u triples from %zu points!\n",
+               getClassName ().c_str (), sample_size_, static_cast<std::size_t> (surface_->size ()));
+    for (float &bin : output[0].histogram)
+      bin = std::numeric_limits<float>::quiet_NaN ();
+    output.is_dense = false;
+    return;
+  }
+
   Eigen::Vector4f xyz_centroid;
   std::vector<float> hist;
   scale_points_unit_sphere (*surface_, static_cast<float>(GRIDSIZE_H), xyz_centroid);
@@ -539,11 +628,6 @@ pcl::ESFEstimation<PointInT, PointOutT>::computeFeature (PointCloudOut &output)
   this->computeESF (local_cloud_, hist);
   this->cleanup9 (local_cloud_);
 
-  // We only output _1_ signature
-  output.points.resize (1);
-  output.width = 1;
-  output.height = 1;
-
   for (std::size_t d = 0; d < hist.size (); ++d)
     output[0].histogram[d] = hist[d];
 }
@@ -42,6 +42,8 @@
 #define PCL_FEATURES_IMPL_FEATURE_H_
 
 #include <pcl/search/pcl_search.h>
+#include <pcl/common/instrumentation.h>
+#include <pcl/common/morton.h>
 
 
 namespace pcl
@@ -172,6 +174,37 @@ Feature<PointInT, PointOutT>::initCompute ()
       return (false);
     }
   }
+
+  // Read the neighborhoods of the cached points from the cache, and search the other ones
+  if (neighborhood_cache_)
+  {
+    const bool same_search = ((search_radius_ != 0.0) == (neighborhood_cache_->getRadiusSearch () > 0));
+    if (neighborhood_cache_->getSearchSurface () != surface_ || !same_search ||
+        !neighborhood_cache_->covers (search_parameter_))
+    {
+      PCL_WARN ("[pcl::%s::initCompute] The neighborhood cache was computed for another surface or search, ignoring it.\n",
+                getClassName ().c_str ());
+    }
+    else
+    {
+      const PointCloudIn *cached_cloud = neighborhood_cache_->getInputCloud ().get ();
+      const SearchMethodSurface search = search_method_surface_;
+      search_method_surface_ = [this, cached_cloud, search] (const PointCloudIn &cloud, std::size_t index, double parameter,
+                                                             std::vector<int> &k_indices, std::vector<float> &k_distances)
+      {
+        if (&cloud == cached_cloud &&
+            neighborhood_cache_->getNeighbors (static_cast<index_t> (index), parameter, k_indices, k_distances))
+          return (static_cast<int> (k_indices.size ()));
+        return (search (cloud, index, parameter, k_indices, k_distances));
+      };
+    }
+  }
+
+  // Order the queries along the Morton curve of the input points
+  if (spatial_query_order_)
+    pcl::getMortonOrder (*input_, *indices_, query_order_);
+  else
+    query_order_.clear ();
   return (true);
 }
 
@@ -192,6 +225,7 @@ Feature<PointInT, PointOutT>::deinitCompute ()
 template <typename PointInT, typename PointOutT> void
 Feature<PointInT, PointOutT>::compute (PointCloudOut &output)
 {
+  PCL_INSTRUMENT_SCOPE (getClassName ());
   if (!initCompute ())
   {
     output.width = output.height = 0;
@@ -222,6 +256,8 @@ Feature<PointInT, PointOutT>::compute (PointCloudOut &output)
 
   // Perform the actual feature computation
   computeFeature (output);
+  // One neighborhood is searched per point of interest
+  PCL_INSTRUMENT_COUNT (getClassName () + ".neighbor_queries", indices_->size ());
 
   deinitCompute ();
 }
@@ -45,6 +45,8 @@
 #include <pcl/common/point_tests.h> // for pcl::isFinite
 #include <pcl/features/pfh_tools.h>
 
+#include <algorithm>
+
 
 //////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointInT, typename PointNT, typename PointOutT> bool
@@ -176,6 +178,114 @@ pcl::FPFHEstimation<PointInT, PointNT, PointOutT>::weightPointSPFHSignature (
   std::transform(last, last + nr_bins_f3, last, denormalize_with (sum_f3));
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointNT, typename PointOutT> void
+pcl::FPFHEstimation<PointInT, PointNT, PointOutT>::prepareSPFHSignatures (const std::vector<int> &spfh_indices)
+{
+  // The kept signatures are only valid for the surface and the search they were computed with
+  SPFHCache &cache = spfh_cache_;
+  if (cache.surface != surface_ || cache.normals != normals_ || cache.tree != this->tree_ ||
+      cache.search_parameter != search_parameter_ || cache.nr_bins[0] != nr_bins_f1_ ||
+      cache.nr_bins[1] != nr_bins_f2_ || cache.nr_bins[2] != nr_bins_f3_)
+  {
+    cache = SPFHCache ();
+    cache.surface = surface_;
+    cache.normals = normals_;
+    cache.tree = this->tree_;
+    cache.search_parameter = search_parameter_;
+    cache.nr_bins[0] = nr_bins_f1_;
+    cache.nr_bins[1] = nr_bins_f2_;
+    cache.nr_bins[2] = nr_bins_f3_;
+  }
+  // The surface may have grown
+  cache.rows.resize (surface_->size (), -1);
+
+  // The signatures of the dirty points and of their current neighbors are computed again
+  std::vector<int> nn_indices (k_); // \note These resizes are irrelevant for a radiusSearch ().
+  std::vector<float> nn_dists (k_);
+  auto invalidate = [&cache] (int index)
+  {
+    if (cache.rows[index] >= 0)
+      cache.valid[cache.rows[index]] = 0;
+  };
+  for (const auto &p_idx : spfh_dirty_)
+  {
+    if (p_idx < 0 || static_cast<std::size_t> (p_idx) >= surface_->size ())
+      continue;
+    invalidate (p_idx);
+    if (!isFinite ((*surface_)[p_idx]) ||
+        this->searchForNeighbors (*surface_, p_idx, search_parameter_, nn_indices, nn_dists) == 0)
+      continue;
+    for (const auto &nn_index : nn_indices)
+      invalidate (nn_index);
+  }
+  spfh_dirty_.clear ();
+
+  // Allocate the signatures of the points which have none yet
+  const std::size_t nr_bins = nr_bins_f1_ + nr_bins_f2_ + nr_bins_f3_;
+  for (const auto &p_idx : spfh_indices)
+  {
+    if (cache.rows[p_idx] >= 0)
+      continue;
+    cache.rows[p_idx] = static_cast<int> (cache.nr_rows++);
+    cache.valid.push_back (0);
+  }
+  if (compact_spfh_)
+    cache.compact_values.resize (cache.nr_rows * nr_bins);
+  else
+    cache.values.resize (cache.nr_rows * nr_bins);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointNT, typename PointOutT> bool
+pcl::FPFHEstimation<PointInT, PointNT, PointOutT>::loadSPFHSignature (int p_idx, int row,
+    Eigen::MatrixXf &hist_f1, Eigen::MatrixXf &hist_f2, Eigen::MatrixXf &hist_f3) const
+{
+  const SPFHCache &cache = spfh_cache_;
+  const int cache_row = cache.rows[p_idx];
+  if (cache_row < 0 || !cache.valid[cache_row])
+    return (false);
+
+  const std::size_t nr_bins = nr_bins_f1_ + nr_bins_f2_ + nr_bins_f3_;
+  const std::size_t begin = cache_row * nr_bins;
+  auto value = [this, &cache] (std::size_t i)
+  {
+    return (compact_spfh_ ? cache.compact_values[i] * (100.0f / 65535.0f) : cache.values[i]);
+  };
+  for (int i = 0; i < nr_bins_f1_; ++i)
+    hist_f1 (row, i) = value (begin + i);
+  for (int i = 0; i < nr_bins_f2_; ++i)
+    hist_f2 (row, i) = value (begin + nr_bins_f1_ + i);
+  for (int i = 0; i < nr_bins_f3_; ++i)
+    hist_f3 (row, i) = value (begin + nr_bins_f1_ + nr_bins_f2_ + i);
+  return (true);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointNT, typename PointOutT> void
+pcl::FPFHEstimation<PointInT, PointNT, PointOutT>::storeSPFHSignature (int p_idx, int row,
+    const Eigen::MatrixXf &hist_f1, const Eigen::MatrixXf &hist_f2, const Eigen::MatrixXf &hist_f3)
+{
+  SPFHCache &cache = spfh_cache_;
+  const int cache_row = cache.rows[p_idx];
+  const std::size_t nr_bins = nr_bins_f1_ + nr_bins_f2_ + nr_bins_f3_;
+  const std::size_t begin = cache_row * nr_bins;
+  auto store = [this, &cache] (std::size_t i, float value)
+  {
+    if (compact_spfh_)
+      cache.compact_values[i] = static_cast<std::uint16_t> (std::min (std::max (value, 0.0f), 100.0f) * (65535.0f / 100.0f) + 0.5f);
+    else
+      cache.values[i] = value;
+  };
+  for (int i = 0; i < nr_bins_f1_; ++i)
+    store (begin + i, hist_f1 (row, i));
+  for (int i = 0; i < nr_bins_f2_; ++i)
+    store (begin + nr_bins_f1_ + i, hist_f2 (row, i));
+  for (int i = 0; i < nr_bins_f3_; ++i)
+    store (begin + nr_bins_f1_ + nr_bins_f2_ + i, hist_f3 (row, i));
+  cache.valid[cache_row] = 1;
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointInT, typename PointNT, typename PointOutT> void
 pcl::FPFHEstimation<PointInT, PointNT, PointOutT>::computeSPFHSignatures (std::vector<int> &spfh_hist_lookup,
@@ -215,16 +325,29 @@ pcl::FPFHEstimation<PointInT, PointNT, PointOutT>::computeSPFHSignatures (std::v
   hist_f2.setZero (data_size, nr_bins_f2_);
   hist_f3.setZero (data_size, nr_bins_f3_);
 
+  if (reuse_spfh_)
+    prepareSPFHSignatures (std::vector<int> (spfh_indices.cbegin (), spfh_indices.cend ()));
+
   // Compute SPFH signatures for every point that needs them
   std::size_t i = 0;
   for (const auto& p_idx: spfh_indices)
   {
+    // The signatures computed by the previous calls are reused
+    if (reuse_spfh_ && loadSPFHSignature (p_idx, i, hist_f1, hist_f2, hist_f3))
+    {
+      spfh_hist_lookup[p_idx] = i;
+      i++;
+      continue;
+    }
+
     // Find the neighborhood around p_idx
     if (this->searchForNeighbors (*surface_, p_idx, search_parameter_, nn_indices, nn_dists) == 0)
       continue;
 
     // Estimate the SPFH signature around p_idx
     computePointSPFHSignature (*surface_, *normals_, p_idx, i, nn_indices, hist_f1, hist_f2, hist_f3);
+    if (reuse_spfh_)
+      storeSPFHSignature (p_idx, i, hist_f1, hist_f2, hist_f3);
 
     // Populate a lookup table for converting a point index to its corresponding row in the spfh_hist_* matrices
     spfh_hist_lookup[p_idx] = i;
@@ -43,6 +43,7 @@
 #include <pcl/features/fpfh_omp.h>
 
 #include <pcl/common/point_tests.h> // for pcl::isFinite
+#include <pcl/common/utils.h> // for getNumberOfThreads
 
 #include <numeric>
 
@@ -106,18 +107,28 @@ pcl::FPFHEstimationOMP<PointInT, PointNT, PointOutT>::computeFeature (PointCloud
   std::vector<int> nn_indices (k_); // \note These resizes are irrelevant for a radiusSearch ().
   std::vector<float> nn_dists (k_); 
 
+  if (reuse_spfh_)
+    this->prepareSPFHSignatures (spfh_indices_vec);
+
   // Compute SPFH signatures for every point that needs them
 
 #pragma omp parallel for \
   default(none) \
   shared(spfh_hist_lookup, spfh_indices_vec) \
   firstprivate(nn_indices, nn_dists) \
-  num_threads(threads_)
+  num_threads(pcl::utils::getNumberOfThreads (threads_))
   for (std::ptrdiff_t i = 0; i < static_cast<std::ptrdiff_t> (spfh_indices_vec.size ()); ++i)
   {
     // Get the next point index
     int p_idx = spfh_indices_vec[i];
 
+    // The signatures computed by the previous calls are reused
+    if (reuse_spfh_ && this->loadSPFHSignature (p_idx, i, hist_f1_, hist_f2_, hist_f3_))
+    {
+      spfh_hist_lookup[p_idx] = i;
+      continue;
+    }
+
     // Find the neighborhood around p_idx
     if (!isFinite ((*input_)[p_idx]) ||
         this->searchForNeighbors (*surface_, p_idx, search_parameter_, nn_indices, nn_dists) == 0)
@@ -125,6 +136,8 @@ pcl::FPFHEstimationOMP<PointInT, PointNT, PointOutT>::computeFeature (PointCloud
 
     // Estimate the SPFH signature around p_idx
     this->computePointSPFHSignature (*surface_, *normals_, p_idx, i, nn_indices, hist_f1_, hist_f2_, hist_f3_);
+    if (reuse_spfh_)
+      this->storeSPFHSignature (p_idx, i, hist_f1_, hist_f2_, hist_f3_);
 
     // Populate a lookup table for converting a point index to its corresponding row in the spfh_hist_* matrices
     spfh_hist_lookup[p_idx] = i;
@@ -141,7 +154,7 @@ pcl::FPFHEstimationOMP<PointInT, PointNT, PointOutT>::computeFeature (PointCloud
   default(none) \
   shared(nr_bins, output, spfh_hist_lookup) \
   firstprivate(nn_dists, nn_indices) \
-  num_threads(threads_)
+  num_threads(pcl::utils::getNumberOfThreads (threads_))
   for (std::ptrdiff_t idx = 0; idx < static_cast<std::ptrdiff_t> (indices_->size ()); ++idx)
   {
     // Find the indices of point idx's neighbors...
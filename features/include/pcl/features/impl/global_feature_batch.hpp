@@ -0,0 +1,103 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved
+ */
+
+#ifndef PCL_FEATURES_IMPL_GLOBAL_FEATURE_BATCH_HPP_
+#define PCL_FEATURES_IMPL_GLOBAL_FEATURE_BATCH_HPP_
+
+#include <pcl/features/global_feature_batch.h>
+#include <pcl/common/io.h> // for copyPointCloud
+
+#include <type_traits>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace pcl
+{
+  namespace detail
+  {
+    /** \brief Give the normals of a cluster to an estimator of a feature from normals. */
+    template <typename FeatureEstimation> auto
+    setClusterNormals (FeatureEstimation &estimator, const FeatureEstimation &prototype,
+                       const pcl::PointIndices &cluster, int)
+      -> decltype (estimator.setInputNormals (prototype.getInputNormals ()), void ())
+    {
+      const auto normals = prototype.getInputNormals ();
+      if (!normals)
+        return;
+      using PointCloudN = typename std::decay<decltype (*normals)>::type;
+      typename PointCloudN::Ptr cluster_normals (new PointCloudN);
+      pcl::copyPointCloud (*normals, cluster, *cluster_normals);
+      estimator.setInputNormals (cluster_normals);
+    }
+
+    /** \brief The other estimators do not use normals. */
+    template <typename FeatureEstimation> void
+    setClusterNormals (FeatureEstimation &, const FeatureEstimation &, const pcl::PointIndices &, long)
+    {
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename FeatureEstimation> void
+pcl::GlobalFeatureBatch<FeatureEstimation>::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs ();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename FeatureEstimation> bool
+pcl::GlobalFeatureBatch<FeatureEstimation>::compute (const std::vector<pcl::PointIndices> &clusters,
+                                                     std::vector<PointCloudOutPtr> &descriptors)
+{
+  descriptors.clear ();
+  const auto cloud = estimator_.getInputCloud ();
+  if (!cloud)
+  {
+    PCL_ERROR ("[pcl::GlobalFeatureBatch::compute] The feature estimator has no input cloud!\n");
+    return (false);
+  }
+  descriptors.resize (clusters.size ());
+
+  // The clusters have very different sizes, they are given to the threads one at a time
+#pragma omp parallel \
+  default(none) \
+  shared(cloud, clusters, descriptors) \
+  num_threads(threads_)
+  {
+    FeatureEstimation estimator (estimator_);
+    estimator.setSearchSurface (typename PointCloudIn::ConstPtr ());
+    estimator.setSearchMethod (nullptr);
+    estimator.setIndices (IndicesPtr ());
+
+#pragma omp for schedule(dynamic, 1)
+    for (std::ptrdiff_t i = 0; i < static_cast<std::ptrdiff_t> (clusters.size ()); ++i)
+    {
+      typename PointCloudIn::Ptr cluster_cloud (new PointCloudIn);
+      pcl::copyPointCloud (*cloud, clusters[i], *cluster_cloud);
+      estimator.setInputCloud (cluster_cloud);
+      detail::setClusterNormals (estimator, estimator_, clusters[i], 0);
+
+      descriptors[i].reset (new PointCloudOut);
+      estimator.compute (*descriptors[i]);
+    }
+  }
+  return (true);
+}
+
+#endif  // PCL_FEATURES_IMPL_GLOBAL_FEATURE_BATCH_HPP_
@@ -41,8 +41,13 @@
 #ifndef PCL_INTEGRAL_IMAGE2D_IMPL_H_
 #define PCL_INTEGRAL_IMAGE2D_IMPL_H_
 
+#include <algorithm>
 #include <cstddef>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 
 namespace pcl
 {
@@ -54,6 +59,20 @@ IntegralImage2D<DataType, Dimension>::setSecondOrderComputation (bool compute_se
 }
 
 
+template <typename DataType, unsigned Dimension> void
+IntegralImage2D<DataType, Dimension>::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs ();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
+
+
 template <typename DataType, unsigned Dimension> void
 IntegralImage2D<DataType, Dimension>::setInput (const DataType * data, unsigned width,unsigned height, unsigned element_stride, unsigned row_stride)
 {
@@ -158,71 +177,135 @@ template <typename DataType, unsigned Dimension> void
 IntegralImage2D<DataType, Dimension>::computeIntegralImages (
     const DataType *data, unsigned row_stride, unsigned element_stride)
 {
-  ElementType* previous_row = &first_order_integral_image_[0];
-  ElementType* current_row  = previous_row + (width_ + 1);
-  memset (previous_row, 0, sizeof (ElementType) * (width_ + 1));
+  std::size_t stride = width_ + 1;
+  std::fill_n (first_order_integral_image_.begin (), stride, ElementType::Zero ());
+  std::fill_n (finite_values_integral_image_.begin (), stride, 0u);
+  if (compute_second_order_integral_images_)
+    std::fill_n (second_order_integral_image_.begin (), stride, SecondOrderType::Zero ());
+
+  if (threads_ == 1)
+  {
+    // The previous row is added while the row is still in the cache
+    for (std::size_t rowIdx = 0; rowIdx < height_; ++rowIdx, data += row_stride)
+    {
+      computeRowSums (data, rowIdx + 1, element_stride);
+      addPreviousRow (rowIdx + 1, 1, stride);
+    }
+    return;
+  }
+
+  // First pass: the prefix sums of every row, which do not depend on the other rows
+#pragma omp parallel for \
+  default(none) \
+  shared(data, element_stride, row_stride) \
+  num_threads(threads_)
+  for (std::ptrdiff_t rowIdx = 0; rowIdx < static_cast<std::ptrdiff_t> (height_); ++rowIdx)
+    computeRowSums (data + rowIdx * row_stride, rowIdx + 1, element_stride);
+
+  // Second pass: the sums of the rows above, every thread accumulates its own range of columns
+  std::size_t nr_chunks = std::max<std::size_t> (1, std::min<std::size_t> (threads_, width_));
+#pragma omp parallel for \
+  default(none) \
+  shared(nr_chunks) \
+  num_threads(threads_)
+  for (std::ptrdiff_t chunk = 0; chunk < static_cast<std::ptrdiff_t> (nr_chunks); ++chunk)
+  {
+    const std::size_t begin = 1 + width_ * chunk / nr_chunks;
+    const std::size_t end = 1 + width_ * (chunk + 1) / nr_chunks;
+    for (std::size_t rowIdx = 2; rowIdx <= height_; ++rowIdx)
+      addPreviousRow (rowIdx, begin, end);
+  }
+}
 
-  unsigned* count_previous_row = &finite_values_integral_image_[0];
-  unsigned* count_current_row  = count_previous_row + (width_ + 1);
-  memset (count_previous_row, 0, sizeof (unsigned) * (width_ + 1));
 
+template <typename DataType, unsigned Dimension> void
+IntegralImage2D<DataType, Dimension>::computeRowSums (
+    const DataType *row_data, std::size_t row, unsigned element_stride)
+{
+  ElementType* current_row = &first_order_integral_image_[row * (width_ + 1)];
+  unsigned* count_current_row = &finite_values_integral_image_[row * (width_ + 1)];
+
+  // The sums are accumulated in registers and stored at every column
+  ElementType sum = ElementType::Zero ();
+  unsigned count = 0;
+  current_row [0] = sum;
+  count_current_row [0] = count;
   if (!compute_second_order_integral_images_)
   {
-    for (unsigned rowIdx = 0; rowIdx < height_; ++rowIdx, data += row_stride,
-                                                previous_row = current_row, current_row += (width_ + 1),
-                                                count_previous_row = count_current_row, count_current_row += (width_ + 1))
+    for (unsigned colIdx = 0, valIdx = 0; colIdx < width_; ++colIdx, valIdx += element_stride)
     {
-      current_row [0].setZero ();
-      count_current_row [0] = 0;
-      for (unsigned colIdx = 0, valIdx = 0; colIdx < width_; ++colIdx, valIdx += element_stride)
+      const InputType* element = reinterpret_cast <const InputType*> (&row_data [valIdx]);
+      if (std::isfinite (element->sum ()))
       {
-        current_row [colIdx + 1] = previous_row [colIdx + 1] + current_row [colIdx] - previous_row [colIdx];
-        count_current_row [colIdx + 1] = count_previous_row [colIdx + 1] + count_current_row [colIdx] - count_previous_row [colIdx];
-        const InputType* element = reinterpret_cast <const InputType*> (&data [valIdx]);
-        if (std::isfinite (element->sum ()))
-        {
-          current_row [colIdx + 1] += element->template cast<typename IntegralImageTypeTraits<DataType>::IntegralType>();
-          ++(count_current_row [colIdx + 1]);
-        }
+        sum += element->template cast<typename IntegralImageTypeTraits<DataType>::IntegralType>();
+        ++count;
       }
+      current_row [colIdx + 1] = sum;
+      count_current_row [colIdx + 1] = count;
     }
   }
   else
   {
-    SecondOrderType* so_previous_row = &second_order_integral_image_[0];
-    SecondOrderType* so_current_row  = so_previous_row + (width_ + 1);
-    memset (so_previous_row, 0, sizeof (SecondOrderType) * (width_ + 1));
-
-    SecondOrderType so_element;
-    for (unsigned rowIdx = 0; rowIdx < height_; ++rowIdx, data += row_stride,
-                                                previous_row = current_row, current_row += (width_ + 1),
-                                                count_previous_row = count_current_row, count_current_row += (width_ + 1),
-                                                so_previous_row = so_current_row, so_current_row += (width_ + 1))
+    SecondOrderType* so_current_row = &second_order_integral_image_[row * (width_ + 1)];
+    SecondOrderType so_sum = SecondOrderType::Zero ();
+    so_current_row [0] = so_sum;
+    for (unsigned colIdx = 0, valIdx = 0; colIdx < width_; ++colIdx, valIdx += element_stride)
     {
-      current_row [0].setZero ();
-      so_current_row [0].setZero ();
-      count_current_row [0] = 0;
-      for (unsigned colIdx = 0, valIdx = 0; colIdx < width_; ++colIdx, valIdx += element_stride)
+      const InputType* element = reinterpret_cast <const InputType*> (&row_data [valIdx]);
+      if (std::isfinite (element->sum ()))
       {
-        current_row [colIdx + 1] = previous_row [colIdx + 1] + current_row [colIdx] - previous_row [colIdx];
-        so_current_row [colIdx + 1] = so_previous_row [colIdx + 1] + so_current_row [colIdx] - so_previous_row [colIdx];
-        count_current_row [colIdx + 1] = count_previous_row [colIdx + 1] + count_current_row [colIdx] - count_previous_row [colIdx];
-
-        const InputType* element = reinterpret_cast <const InputType*> (&data [valIdx]);
-        if (std::isfinite (element->sum ()))
-        {
-          current_row [colIdx + 1] += element->template cast<typename IntegralImageTypeTraits<DataType>::IntegralType>();
-          ++(count_current_row [colIdx + 1]);
-          for (unsigned myIdx = 0, elIdx = 0; myIdx < Dimension; ++myIdx)
-            for (unsigned mxIdx = myIdx; mxIdx < Dimension; ++mxIdx, ++elIdx)
-              so_current_row [colIdx + 1][elIdx] += (*element)[myIdx] * (*element)[mxIdx];
-        }
+        sum += element->template cast<typename IntegralImageTypeTraits<DataType>::IntegralType>();
+        ++count;
+        for (unsigned myIdx = 0, elIdx = 0; myIdx < Dimension; ++myIdx)
+          for (unsigned mxIdx = myIdx; mxIdx < Dimension; ++mxIdx, ++elIdx)
+            so_sum[elIdx] += (*element)[myIdx] * (*element)[mxIdx];
       }
+      current_row [colIdx + 1] = sum;
+      so_current_row [colIdx + 1] = so_sum;
+      count_current_row [colIdx + 1] = count;
     }
   }
 }
 
 
+template <typename DataType, unsigned Dimension> void
+IntegralImage2D<DataType, Dimension>::addPreviousRow (
+    std::size_t row, std::size_t begin, std::size_t end)
+{
+  ElementType* current_row = &first_order_integral_image_[row * (width_ + 1)];
+  const ElementType* previous_row = current_row - (width_ + 1);
+  unsigned* count_current_row = &finite_values_integral_image_[row * (width_ + 1)];
+  const unsigned* count_previous_row = count_current_row - (width_ + 1);
+  for (std::size_t colIdx = begin; colIdx < end; ++colIdx)
+  {
+    current_row [colIdx] += previous_row [colIdx];
+    count_current_row [colIdx] += count_previous_row [colIdx];
+  }
+
+  if (compute_second_order_integral_images_)
+  {
+    SecondOrderType* so_current_row = &second_order_integral_image_[row * (width_ + 1)];
+    const SecondOrderType* so_previous_row = so_current_row - (width_ + 1);
+    for (std::size_t colIdx = begin; colIdx < end; ++colIdx)
+      so_current_row [colIdx] += so_previous_row [colIdx];
+  }
+}
+
+
+template <typename DataType> void
+IntegralImage2D<DataType, 1>::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs ();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
+
+
 template <typename DataType> void
 IntegralImage2D<DataType, 1>::setInput (const DataType * data, unsigned width,unsigned height, unsigned element_stride, unsigned row_stride)
 {
@@ -327,64 +410,117 @@ template <typename DataType> void
 IntegralImage2D<DataType, 1>::computeIntegralImages (
     const DataType *data, unsigned row_stride, unsigned element_stride)
 {
-  ElementType* previous_row = &first_order_integral_image_[0];
-  ElementType* current_row  = previous_row + (width_ + 1);
-  memset (previous_row, 0, sizeof (ElementType) * (width_ + 1));
+  std::size_t stride = width_ + 1;
+  std::fill_n (first_order_integral_image_.begin (), stride, ElementType (0));
+  std::fill_n (finite_values_integral_image_.begin (), stride, 0u);
+  if (compute_second_order_integral_images_)
+    std::fill_n (second_order_integral_image_.begin (), stride, SecondOrderType (0));
+
+  if (threads_ == 1)
+  {
+    // The previous row is added while the row is still in the cache
+    for (std::size_t rowIdx = 0; rowIdx < height_; ++rowIdx, data += row_stride)
+    {
+      computeRowSums (data, rowIdx + 1, element_stride);
+      addPreviousRow (rowIdx + 1, 1, stride);
+    }
+    return;
+  }
+
+  // First pass: the prefix sums of every row, which do not depend on the other rows
+#pragma omp parallel for \
+  default(none) \
+  shared(data, element_stride, row_stride) \
+  num_threads(threads_)
+  for (std::ptrdiff_t rowIdx = 0; rowIdx < static_cast<std::ptrdiff_t> (height_); ++rowIdx)
+    computeRowSums (data + rowIdx * row_stride, rowIdx + 1, element_stride);
+
+  // Second pass: the sums of the rows above, every thread accumulates its own range of columns
+  std::size_t nr_chunks = std::max<std::size_t> (1, std::min<std::size_t> (threads_, width_));
+#pragma omp parallel for \
+  default(none) \
+  shared(nr_chunks) \
+  num_threads(threads_)
+  for (std::ptrdiff_t chunk = 0; chunk < static_cast<std::ptrdiff_t> (nr_chunks); ++chunk)
+  {
+    const std::size_t begin = 1 + width_ * chunk / nr_chunks;
+    const std::size_t end = 1 + width_ * (chunk + 1) / nr_chunks;
+    for (std::size_t rowIdx = 2; rowIdx <= height_; ++rowIdx)
+      addPreviousRow (rowIdx, begin, end);
+  }
+}
 
-  unsigned* count_previous_row = &finite_values_integral_image_[0];
-  unsigned* count_current_row  = count_previous_row + (width_ + 1);
-  memset (count_previous_row, 0, sizeof (unsigned) * (width_ + 1));
 
+template <typename DataType> void
+IntegralImage2D<DataType, 1>::computeRowSums (
+    const DataType *row_data, std::size_t row, unsigned element_stride)
+{
+  ElementType* current_row = &first_order_integral_image_[row * (width_ + 1)];
+  unsigned* count_current_row = &finite_values_integral_image_[row * (width_ + 1)];
+
+  // The sums are accumulated in registers and stored at every column
+  ElementType sum = 0;
+  unsigned count = 0;
+  current_row [0] = sum;
+  count_current_row [0] = count;
   if (!compute_second_order_integral_images_)
   {
-    for (unsigned rowIdx = 0; rowIdx < height_; ++rowIdx, data += row_stride,
-                                                previous_row = current_row, current_row += (width_ + 1),
-                                                count_previous_row = count_current_row, count_current_row += (width_ + 1))
+    for (unsigned colIdx = 0, valIdx = 0; colIdx < width_; ++colIdx, valIdx += element_stride)
     {
-      current_row [0] = 0.0;
-      count_current_row [0] = 0;
-      for (unsigned colIdx = 0, valIdx = 0; colIdx < width_; ++colIdx, valIdx += element_stride)
+      if (std::isfinite (row_data [valIdx]))
       {
-        current_row [colIdx + 1] = previous_row [colIdx + 1] + current_row [colIdx] - previous_row [colIdx];
-        count_current_row [colIdx + 1] = count_previous_row [colIdx + 1] + count_current_row [colIdx] - count_previous_row [colIdx];
-        if (std::isfinite (data [valIdx]))
-        {
-          current_row [colIdx + 1] += data [valIdx];
-          ++(count_current_row [colIdx + 1]);
-        }
+        sum += row_data [valIdx];
+        ++count;
       }
+      current_row [colIdx + 1] = sum;
+      count_current_row [colIdx + 1] = count;
     }
   }
   else
   {
-    SecondOrderType* so_previous_row = &second_order_integral_image_[0];
-    SecondOrderType* so_current_row  = so_previous_row + (width_ + 1);
-    memset (so_previous_row, 0, sizeof (SecondOrderType) * (width_ + 1));
-
-    for (unsigned rowIdx = 0; rowIdx < height_; ++rowIdx, data += row_stride,
-                                                previous_row = current_row, current_row += (width_ + 1),
-                                                count_previous_row = count_current_row, count_current_row += (width_ + 1),
-                                                so_previous_row = so_current_row, so_current_row += (width_ + 1))
+    SecondOrderType* so_current_row = &second_order_integral_image_[row * (width_ + 1)];
+    SecondOrderType so_sum = 0;
+    so_current_row [0] = so_sum;
+    for (unsigned colIdx = 0, valIdx = 0; colIdx < width_; ++colIdx, valIdx += element_stride)
     {
-      current_row [0] = 0.0;
-      so_current_row [0] = 0.0;
-      count_current_row [0] = 0;
-      for (unsigned colIdx = 0, valIdx = 0; colIdx < width_; ++colIdx, valIdx += element_stride)
+      if (std::isfinite (row_data [valIdx]))
       {
-        current_row [colIdx + 1] = previous_row [colIdx + 1] + current_row [colIdx] - previous_row [colIdx];
-        so_current_row [colIdx + 1] = so_previous_row [colIdx + 1] + so_current_row [colIdx] - so_previous_row [colIdx];
-        count_current_row [colIdx + 1] = count_previous_row [colIdx + 1] + count_current_row [colIdx] - count_previous_row [colIdx];
-        if (std::isfinite (data[valIdx]))
-        {
-          current_row [colIdx + 1] += data[valIdx];
-          so_current_row [colIdx + 1] += data[valIdx] * data[valIdx];
-          ++(count_current_row [colIdx + 1]);
-        }
+        sum += row_data [valIdx];
+        so_sum += row_data [valIdx] * row_data [valIdx];
+        ++count;
       }
+      current_row [colIdx + 1] = sum;
+      so_current_row [colIdx + 1] = so_sum;
+      count_current_row [colIdx + 1] = count;
     }
   }
 }
 
+
+template <typename DataType> void
+IntegralImage2D<DataType, 1>::addPreviousRow (
+    std::size_t row, std::size_t begin, std::size_t end)
+{
+  ElementType* current_row = &first_order_integral_image_[row * (width_ + 1)];
+  const ElementType* previous_row = current_row - (width_ + 1);
+  unsigned* count_current_row = &finite_values_integral_image_[row * (width_ + 1)];
+  const unsigned* count_previous_row = count_current_row - (width_ + 1);
+  for (std::size_t colIdx = begin; colIdx < end; ++colIdx)
+  {
+    current_row [colIdx] += previous_row [colIdx];
+    count_current_row [colIdx] += count_previous_row [colIdx];
+  }
+
+  if (compute_second_order_integral_images_)
+  {
+    SecondOrderType* so_current_row = &second_order_integral_image_[row * (width_ + 1)];
+    const SecondOrderType* so_previous_row = so_current_row - (width_ + 1);
+    for (std::size_t colIdx = begin; colIdx < end; ++colIdx)
+      so_current_row [colIdx] += so_previous_row [colIdx];
+  }
+}
+
+
 } // namespace pcl
 
 #endif    // PCL_INTEGRAL_IMAGE2D_IMPL_H_
@@ -50,7 +50,7 @@ pcl::IntensitySpinEstimation<PointInT, PointOutT>::computeIntensitySpinImage (
       int k,
       const std::vector<int> &indices, 
       const std::vector<float> &squared_distances, 
-      Eigen::MatrixXf &intensity_spin_image)
+      Eigen::MatrixXf &intensity_spin_image) const
 {
   // Determine the number of bins to use based on the size of intensity_spin_image
   int nr_distance_bins = static_cast<int> (intensity_spin_image.cols ());
@@ -0,0 +1,104 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved
+ */
+
+#ifndef PCL_FEATURES_IMPL_INTENSITY_SPIN_OMP_HPP_
+#define PCL_FEATURES_IMPL_INTENSITY_SPIN_OMP_HPP_
+
+#include <pcl/features/intensity_spin_omp.h>
+#include <pcl/common/utils.h> // for getNumberOfThreads
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointOutT> void
+pcl::IntensitySpinEstimationOMP<PointInT, PointOutT>::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs ();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointOutT> void
+pcl::IntensitySpinEstimationOMP<PointInT, PointOutT>::computeFeature (PointCloudOut &output)
+{
+  // Make sure a search radius is set
+  if (search_radius_ == 0.0)
+  {
+    PCL_ERROR ("[pcl::%s::computeFeature] The search radius must be set before computing the feature!\n",
+               getClassName ().c_str ());
+    output.width = output.height = 0;
+    output.points.clear ();
+    return;
+  }
+
+  // Make sure the spin image has valid dimensions
+  if (nr_intensity_bins_ <= 0)
+  {
+    PCL_ERROR ("[pcl::%s::computeFeature] The number of intensity bins must be greater than zero!\n",
+               getClassName ().c_str ());
+    output.width = output.height = 0;
+    output.points.clear ();
+    return;
+  }
+  if (nr_distance_bins_ <= 0)
+  {
+    PCL_ERROR ("[pcl::%s::computeFeature] The number of distance bins must be greater than zero!\n",
+               getClassName ().c_str ());
+    output.width = output.height = 0;
+    output.points.clear ();
+    return;
+  }
+
+  // Per-thread spin image and neighborhood, the radiusSearch resizes the latter as needed
+  Eigen::MatrixXf intensity_spin_image (nr_intensity_bins_, nr_distance_bins_);
+  std::vector<int> nn_indices;
+  std::vector<float> nn_dist_sqr;
+
+  output.is_dense = true;
+  // Iterating over the entire index vector
+#pragma omp parallel for \
+  default(none) \
+  shared(output) \
+  firstprivate(intensity_spin_image, nn_indices, nn_dist_sqr) \
+  num_threads(pcl::utils::getNumberOfThreads (threads_)) \
+  schedule(dynamic, 256)
+  for (std::ptrdiff_t idx = 0; idx < static_cast<std::ptrdiff_t> (indices_->size ()); ++idx)
+  {
+    // Find neighbors within the search radius
+    int k = tree_->radiusSearch ((*indices_)[idx], search_radius_, nn_indices, nn_dist_sqr);
+    if (k == 0)
+    {
+      for (int bin = 0; bin < nr_intensity_bins_ * nr_distance_bins_; ++bin)
+        output[idx].histogram[bin] = std::numeric_limits<float>::quiet_NaN ();
+      output.is_dense = false;
+      continue;
+    }
+
+    // Compute the intensity spin image
+    this->computeIntensitySpinImage (*surface_, static_cast<float> (search_radius_), sigma_, k, nn_indices, nn_dist_sqr, intensity_spin_image);
+
+    // Copy into the resultant cloud
+    std::size_t bin = 0;
+    for (Eigen::Index bin_j = 0; bin_j < intensity_spin_image.cols (); ++bin_j)
+      for (Eigen::Index bin_i = 0; bin_i < intensity_spin_image.rows (); ++bin_i)
+        output[idx].histogram[bin++] = intensity_spin_image (bin_i, bin_j);
+  }
+}
+
+#define PCL_INSTANTIATE_IntensitySpinEstimationOMP(T,NT) template class PCL_EXPORTS pcl::IntensitySpinEstimationOMP<T,NT>;
+
+#endif  // PCL_FEATURES_IMPL_INTENSITY_SPIN_OMP_HPP_
@@ -43,6 +43,10 @@
 #include <pcl/features/moment_of_inertia_estimation.h>
 #include <pcl/features/feature.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT>
 pcl::MomentOfInertiaEstimation<PointT>::MomentOfInertiaEstimation () :
@@ -50,6 +54,7 @@ pcl::MomentOfInertiaEstimation<PointT>::MomentOfInertiaEstimation () :
   step_ (10.0f),
   point_mass_ (0.0001f),
   normalize_ (true),
+  threads_ (1),
   mean_value_ (0.0f, 0.0f, 0.0f),
   major_axis_ (0.0f, 0.0f, 0.0f),
   middle_axis_ (0.0f, 0.0f, 0.0f),
@@ -108,6 +113,20 @@ pcl::MomentOfInertiaEstimation<PointT>::getNormalizePointMassFlag () const
   return (normalize_);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::MomentOfInertiaEstimation<PointT>::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs ();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT> void
 pcl::MomentOfInertiaEstimation<PointT>::setPointMass (const float point_mass)
@@ -156,6 +175,8 @@ pcl::MomentOfInertiaEstimation<PointT>::compute ()
 
   computeEigenVectors (covariance_matrix, major_axis_, middle_axis_, minor_axis_, major_value_, middle_value_, minor_value_);
 
+  // The rotated axes, in the order of the stored moments and eccentricities
+  std::vector <Eigen::Vector3f> axes;
   float theta = 0.0f;
   while (theta <= 90.0f)
   {
@@ -167,24 +188,36 @@ pcl::MomentOfInertiaEstimation<PointT>::compute ()
       Eigen::Vector3f current_axis;
       rotateVector (rotated_vector, minor_axis_, phi, current_axis);
       current_axis.normalize ();
+      axes.push_back (current_axis);
+
+      phi += step_;
+    }
+    theta += step_;
+  }
+
+  moment_of_inertia_.resize (axes.size ());
+  eccentricity_.resize (axes.size ());
+#pragma omp parallel \
+  default(none) \
+  shared(axes) \
+  num_threads(threads_)
+  {
+    typename pcl::PointCloud<PointT>::Ptr projected_cloud (new pcl::PointCloud<PointT> ());
+#pragma omp for schedule(dynamic, 4)
+    for (std::ptrdiff_t i_axis = 0; i_axis < static_cast<std::ptrdiff_t> (axes.size ()); i_axis++)
+    {
+      const Eigen::Vector3f& current_axis = axes[i_axis];
 
       //compute moment of inertia for the current axis
-      float current_moment_of_inertia = calculateMomentOfInertia (current_axis, mean_value_);
-      moment_of_inertia_.push_back (current_moment_of_inertia);
+      moment_of_inertia_[i_axis] = calculateMomentOfInertia (current_axis, mean_value_);
 
       //compute eccentricity for the current plane
-      typename pcl::PointCloud<PointT>::Ptr projected_cloud (new pcl::PointCloud<PointT> ());
       getProjectedCloud (current_axis, mean_value_, projected_cloud);
       Eigen::Matrix <float, 3, 3> covariance_matrix;
       covariance_matrix.setZero ();
       computeCovarianceMatrix (projected_cloud, covariance_matrix);
-      projected_cloud.reset ();
-      float current_eccentricity = computeEccentricity (covariance_matrix, current_axis);
-      eccentricity_.push_back (current_eccentricity);
-
-      phi += step_;
+      eccentricity_[i_axis] = computeEccentricity (covariance_matrix, current_axis);
     }
-    theta += step_;
   }
 
   computeOBB ();
@@ -400,7 +433,7 @@ pcl::MomentOfInertiaEstimation<PointT>::computeCovarianceMatrix (PointCloudConst
 template <typename PointT> void
 pcl::MomentOfInertiaEstimation<PointT>::computeEigenVectors (const Eigen::Matrix <float, 3, 3>& covariance_matrix,
   Eigen::Vector3f& major_axis, Eigen::Vector3f& middle_axis, Eigen::Vector3f& minor_axis, float& major_value,
-  float& middle_value, float& minor_value)
+  float& middle_value, float& minor_value) const
 {
   Eigen::EigenSolver <Eigen::Matrix <float, 3, 3> > eigen_solver;
   eigen_solver.compute (covariance_matrix);
@@ -524,7 +557,7 @@ pcl::MomentOfInertiaEstimation<PointT>::getProjectedCloud (const Eigen::Vector3f
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT> float
-pcl::MomentOfInertiaEstimation<PointT>::computeEccentricity (const Eigen::Matrix <float, 3, 3>& covariance_matrix, const Eigen::Vector3f& normal_vector)
+pcl::MomentOfInertiaEstimation<PointT>::computeEccentricity (const Eigen::Matrix <float, 3, 3>& covariance_matrix, const Eigen::Vector3f& normal_vector) const
 {
   Eigen::Vector3f major_axis (0.0f, 0.0f, 0.0f);
   Eigen::Vector3f middle_axis (0.0f, 0.0f, 0.0f);
@@ -42,6 +42,8 @@
 
 #include <pcl/features/multiscale_feature_persistence.h>
 
+#include <algorithm>
+
 //////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointSource, typename PointFeature>
 pcl::MultiscaleFeaturePersistence<PointSource, PointFeature>::MultiscaleFeaturePersistence () : 
@@ -91,11 +93,28 @@ pcl::MultiscaleFeaturePersistence<PointSource, PointFeature>::computeFeaturesAtA
   features_at_scale_.reserve (scale_values_.size ());
   features_at_scale_vectorized_.clear ();
   features_at_scale_vectorized_.reserve (scale_values_.size ());
+
+  // The neighborhoods are searched once at the largest scale, and the smaller scales are served from them
+  const auto user_cache = feature_estimator_->getNeighborhoodCache ();
+  if (!user_cache && feature_estimator_->getInputCloud ())
+  {
+    typename NeighborhoodCache<PointSource>::Ptr scale_cache (new NeighborhoodCache<PointSource>);
+    scale_cache->setInputCloud (feature_estimator_->getInputCloud ());
+    if (feature_estimator_->getIndices ())
+      scale_cache->setIndices (feature_estimator_->getIndices ());
+    scale_cache->setSearchSurface (feature_estimator_->getSearchSurface ());
+    scale_cache->setSearchMethod (feature_estimator_->getSearchMethod ());
+    scale_cache->setRadiusSearch (*std::max_element (scale_values_.cbegin (), scale_values_.cend ()));
+    scale_cache->setNumberOfThreads ();
+    if (scale_cache->compute ())
+      feature_estimator_->setNeighborhoodCache (scale_cache);
+  }
+
   for (std::size_t scale_i = 0; scale_i < scale_values_.size (); ++scale_i)
   {
     FeatureCloudPtr feature_cloud (new FeatureCloud ());
     computeFeatureAtScale (scale_values_[scale_i], feature_cloud);
-    features_at_scale_[scale_i] = feature_cloud;
+    features_at_scale_.push_back (feature_cloud);
 
     // Vectorize each feature and insert it into the vectorized feature storage
     std::vector<std::vector<float> > feature_cloud_vectorized;
@@ -109,6 +128,7 @@ pcl::MultiscaleFeaturePersistence<PointSource, PointFeature>::computeFeaturesAtA
     }
     features_at_scale_vectorized_.emplace_back (std::move(feature_cloud_vectorized));
   }
+  feature_estimator_->setNeighborhoodCache (user_cache);
 }
 
 
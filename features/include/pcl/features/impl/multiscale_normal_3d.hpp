@@ -0,0 +1,113 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved
+ */
+
+#ifndef PCL_FEATURES_IMPL_MULTISCALE_NORMAL_3D_H_
+#define PCL_FEATURES_IMPL_MULTISCALE_NORMAL_3D_H_
+
+#include <pcl/features/multiscale_normal_3d.h>
+#include <pcl/features/impl/normal_3d_omp.hpp>
+
+#include <algorithm>
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointOutT> void
+pcl::MultiscaleNormalEstimation<PointInT, PointOutT>::computeAtScales (std::vector<PointCloudOutPtr> &outputs)
+{
+  outputs.clear ();
+  if (scales_.empty () || *std::min_element (scales_.cbegin (), scales_.cend ()) <= 0)
+  {
+    PCL_ERROR ("[pcl::%s::computeAtScales] The scales must be positive search radii!\n", getClassName ().c_str ());
+    return;
+  }
+
+  // One radius search at the largest scale serves all the scales
+  const double search_radius = search_radius_;
+  const int k = k_;
+  search_radius_ = *std::max_element (scales_.cbegin (), scales_.cend ());
+  k_ = 0;
+  const bool initialized = this->initCompute ();
+  search_radius_ = search_radius;
+  k_ = k;
+  if (!initialized)
+    return;
+
+  std::size_t nr_scales = scales_.size ();
+  std::vector<float> sqr_scales (nr_scales);
+  for (std::size_t s = 0; s < nr_scales; ++s)
+    sqr_scales[s] = static_cast<float> (scales_[s] * scales_[s]);
+
+  outputs.resize (nr_scales);
+  for (auto &output : outputs)
+  {
+    output.reset (new PointCloudOut);
+    output->header = input_->header;
+    output->resize (indices_->size ());
+    if (indices_->size () != input_->size () || input_->width * input_->height == 0)
+    {
+      output->width = indices_->size ();
+      output->height = 1;
+    }
+    else
+    {
+      output->width = input_->width;
+      output->height = input_->height;
+    }
+    output->is_dense = true;
+  }
+
+  std::vector<std::vector<int> > nn_indices (detail::normal_batch_size);
+  std::vector<std::vector<float> > nn_dists (detail::normal_batch_size);
+  std::vector<std::vector<int> > scale_indices (detail::normal_batch_size);
+
+  // The normals are estimated by batches of neighborhoods, one batch after the other in each thread
+  std::size_t batch_size = detail::normal_batch_size;
+  std::ptrdiff_t nr_batches = (indices_->size () + batch_size - 1) / batch_size;
+#pragma omp parallel for \
+  default(none) \
+  shared(outputs, batch_size, nr_batches, nr_scales, sqr_scales) \
+  firstprivate(nn_indices, nn_dists, scale_indices) \
+  num_threads(pcl::utils::getNumberOfThreads (threads_))
+  for (std::ptrdiff_t batch = 0; batch < nr_batches; ++batch)
+  {
+    const std::size_t begin = batch * batch_size;
+    const std::size_t count = std::min (batch_size, indices_->size () - begin);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      const auto index = (*indices_)[this->getQueryPosition (begin + i)];
+      if ((!input_->is_dense && !isFinite ((*input_)[index])) ||
+          this->searchForNeighbors (index, search_parameter_, nn_indices[i], nn_dists[i]) == 0)
+      {
+        nn_indices[i].clear ();
+        nn_dists[i].clear ();
+      }
+    }
+
+    // The neighborhood of a scale is made of the neighbors of the largest one which are inside its radius
+    const std::vector<int> *neighborhoods[detail::normal_batch_size];
+    for (std::size_t s = 0; s < nr_scales; ++s)
+    {
+      for (std::size_t i = 0; i < count; ++i)
+      {
+        scale_indices[i].clear ();
+        for (std::size_t j = 0; j < nn_indices[i].size (); ++j)
+          if (nn_dists[i][j] <= sqr_scales[s])
+            scale_indices[i].push_back (nn_indices[i][j]);
+        neighborhoods[i] = &scale_indices[i];
+      }
+      if (!this->estimateNormalBatch (begin, count, neighborhoods, *outputs[s]))
+        outputs[s]->is_dense = false;
+    }
+  }
+
+  this->deinitCompute ();
+}
+
+#define PCL_INSTANTIATE_MultiscaleNormalEstimation(T,NT) template class PCL_EXPORTS pcl::MultiscaleNormalEstimation<T,NT>;
+
+#endif    // PCL_FEATURES_IMPL_MULTISCALE_NORMAL_3D_H_
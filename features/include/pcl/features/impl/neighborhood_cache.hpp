@@ -0,0 +1,129 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved
+ */
+
+#ifndef PCL_FEATURES_IMPL_NEIGHBORHOOD_CACHE_HPP_
+#define PCL_FEATURES_IMPL_NEIGHBORHOOD_CACHE_HPP_
+
+#include <pcl/features/neighborhood_cache.h>
+#include <pcl/common/point_tests.h> // for pcl::isFinite
+#include <pcl/search/kdtree.h>
+#include <pcl/search/organized.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::NeighborhoodCache<PointT>::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs ();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> bool
+pcl::NeighborhoodCache<PointT>::compute ()
+{
+  rows_.clear ();
+  offsets_.clear ();
+  neighbors_.clear ();
+  sqr_distances_.clear ();
+
+  if (!PCLBase<PointT>::initCompute ())
+    return (false);
+
+  if ((search_radius_ > 0) == (k_ > 0))
+  {
+    PCL_ERROR ("[pcl::NeighborhoodCache::compute] Set either a radius (%f) or a K (%d), and the other one to zero.\n",
+               search_radius_, k_);
+    PCLBase<PointT>::deinitCompute ();
+    return (false);
+  }
+
+  const PointCloudConstPtr surface = getSearchSurface ();
+  if (!tree_)
+  {
+    if (surface->isOrganized () && input_->isOrganized ())
+      tree_.reset (new pcl::search::OrganizedNeighbor<PointT> ());
+    else
+      tree_.reset (new pcl::search::KdTree<PointT> (false));
+  }
+  if (tree_->getInputCloud () != surface)
+    tree_->setInputCloud (surface);
+
+  // Every thread searches the neighborhoods of a contiguous range of the indices into its own buffers, which are
+  // then concatenated in the order of the indices
+  const std::size_t nr_rows = indices_->size ();
+  const std::size_t nr_chunks = std::max<std::size_t> (1, std::min<std::size_t> (threads_, nr_rows));
+  std::vector<std::vector<int> > chunk_neighbors (nr_chunks);
+  std::vector<std::vector<float> > chunk_sqr_distances (nr_chunks);
+  std::vector<std::size_t> counts (nr_rows, 0);
+  double search_parameter = (search_radius_ > 0 ? search_radius_ : k_);
+
+#pragma omp parallel for \
+  default(none) \
+  shared(chunk_neighbors, chunk_sqr_distances, counts, nr_chunks, nr_rows, search_parameter) \
+  num_threads(threads_)
+  for (std::ptrdiff_t chunk = 0; chunk < static_cast<std::ptrdiff_t> (nr_chunks); ++chunk)
+  {
+    const std::size_t begin = nr_rows * chunk / nr_chunks;
+    const std::size_t end = nr_rows * (chunk + 1) / nr_chunks;
+    std::vector<int> nn_indices;
+    std::vector<float> nn_dists;
+    for (std::size_t row = begin; row < end; ++row)
+    {
+      const index_t index = (*this->indices_)[row];
+      if (!isFinite ((*this->input_)[index]))
+        continue;
+      const int nr_neighbors = (this->search_radius_ > 0 ?
+          this->tree_->radiusSearch (*this->input_, index, search_parameter, nn_indices, nn_dists, 0) :
+          this->tree_->nearestKSearch (*this->input_, index, this->k_, nn_indices, nn_dists));
+      if (nr_neighbors <= 0)
+        continue;
+      counts[row] = static_cast<std::size_t> (nr_neighbors);
+      chunk_neighbors[chunk].insert (chunk_neighbors[chunk].end (), nn_indices.cbegin (), nn_indices.cbegin () + nr_neighbors);
+      chunk_sqr_distances[chunk].insert (chunk_sqr_distances[chunk].end (), nn_dists.cbegin (), nn_dists.cbegin () + nr_neighbors);
+    }
+  }
+
+  offsets_.resize (nr_rows + 1);
+  offsets_[0] = 0;
+  for (std::size_t row = 0; row < nr_rows; ++row)
+    offsets_[row + 1] = offsets_[row] + counts[row];
+  neighbors_.reserve (offsets_.back ());
+  sqr_distances_.reserve (offsets_.back ());
+  for (std::size_t chunk = 0; chunk < nr_chunks; ++chunk)
+  {
+    neighbors_.insert (neighbors_.end (), chunk_neighbors[chunk].cbegin (), chunk_neighbors[chunk].cend ());
+    sqr_distances_.insert (sqr_distances_.end (), chunk_sqr_distances[chunk].cbegin (), chunk_sqr_distances[chunk].cend ());
+  }
+
+  // Points listed several times in the indices are served from their first row
+  rows_.assign (input_->size (), -1);
+  for (std::size_t row = 0; row < nr_rows; ++row)
+  {
+    const index_t index = (*indices_)[row];
+    if (rows_[index] < 0)
+      rows_[index] = static_cast<int> (row);
+  }
+
+  PCLBase<PointT>::deinitCompute ();
+  return (true);
+}
+
+#define PCL_INSTANTIATE_NeighborhoodCache(T) template class PCL_EXPORTS pcl::NeighborhoodCache<T>;
+
+#endif  // PCL_FEATURES_IMPL_NEIGHBORHOOD_CACHE_HPP_
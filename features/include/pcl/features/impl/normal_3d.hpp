@@ -42,56 +42,76 @@
 #define PCL_FEATURES_IMPL_NORMAL_3D_H_
 
 #include <pcl/features/normal_3d.h>
+#include <pcl/features/impl/normal_3d_batch.hpp>
 
 ///////////////////////////////////////////////////////////////////////////////////////////
-template <typename PointInT, typename PointOutT> void
-pcl::NormalEstimation<PointInT, PointOutT>::computeFeature (PointCloudOut &output)
+template <typename PointInT, typename PointOutT> bool
+pcl::NormalEstimation<PointInT, PointOutT>::computeNormalBatch (std::size_t begin, std::size_t count,
+                                                                std::vector<std::vector<int> > &nn_indices,
+                                                                std::vector<float> &nn_dists,
+                                                                PointCloudOut &output) const
 {
-  // Allocate enough space to hold the results
-  // \note This resize is irrelevant for a radiusSearch ().
-  std::vector<int> nn_indices (k_);
-  std::vector<float> nn_dists (k_);
-
-  output.is_dense = true;
-  // Save a few cycles by not checking every point for NaN/Inf values if the cloud is set to dense
-  if (input_->is_dense)
+  // Search the neighborhoods of the batch, an empty neighborhood gives a NaN normal. The batch is made of the
+  // positions begin to begin + count in the processing order
+  const std::vector<int> *neighborhoods[detail::normal_batch_size];
+  for (std::size_t i = 0; i < count; ++i)
   {
-    // Iterating over the entire index vector
-    for (std::size_t idx = 0; idx < indices_->size (); ++idx)
-    {
-      if (this->searchForNeighbors ((*indices_)[idx], search_parameter_, nn_indices, nn_dists) == 0 ||
-          !computePointNormal (*surface_, nn_indices, output[idx].normal[0], output[idx].normal[1], output[idx].normal[2], output[idx].curvature))
-      {
-        output[idx].normal[0] = output[idx].normal[1] = output[idx].normal[2] = output[idx].curvature = std::numeric_limits<float>::quiet_NaN ();
-
-        output.is_dense = false;
-        continue;
-      }
+    const auto index = (*indices_)[this->getQueryPosition (begin + i)];
+    neighborhoods[i] = &nn_indices[i];
+    if ((!input_->is_dense && !isFinite ((*input_)[index])) ||
+        this->searchForNeighbors (index, search_parameter_, nn_indices[i], nn_dists) == 0)
+      nn_indices[i].clear ();
+  }
+  return (estimateNormalBatch (begin, count, neighborhoods, output));
+}
 
-      flipNormalTowardsViewpoint ((*input_)[(*indices_)[idx]], vpx_, vpy_, vpz_,
-                                  output[idx].normal[0], output[idx].normal[1], output[idx].normal[2]);
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointOutT> bool
+pcl::NormalEstimation<PointInT, PointOutT>::estimateNormalBatch (std::size_t begin, std::size_t count,
+                                                                 const std::vector<int> *const *neighborhoods,
+                                                                 PointCloudOut &output) const
+{
+  detail::NormalBatch batch;
+  detail::computeCovarianceBatch (*surface_, neighborhoods, count, batch);
+  detail::solvePlaneBatch (batch);
 
-    }
-  }
-  else
+  bool dense = true;
+  for (std::size_t i = 0; i < count; ++i)
   {
-    // Iterating over the entire index vector
-    for (std::size_t idx = 0; idx < indices_->size (); ++idx)
+    const std::size_t position = this->getQueryPosition (begin + i);
+    PointOutT &point = output[position];
+    point.normal[0] = batch.nx[i];
+    point.normal[1] = batch.ny[i];
+    point.normal[2] = batch.nz[i];
+    point.curvature = batch.curvature[i];
+    if (!batch.valid[i])
     {
-      if (!isFinite ((*input_)[(*indices_)[idx]]) ||
-          this->searchForNeighbors ((*indices_)[idx], search_parameter_, nn_indices, nn_dists) == 0 ||
-          !computePointNormal (*surface_, nn_indices, output[idx].normal[0], output[idx].normal[1], output[idx].normal[2], output[idx].curvature))
-      {
-        output[idx].normal[0] = output[idx].normal[1] = output[idx].normal[2] = output[idx].curvature = std::numeric_limits<float>::quiet_NaN ();
+      dense = false;
+      continue;
+    }
 
-        output.is_dense = false;
-        continue;
-      }
+    flipNormalTowardsViewpoint ((*input_)[(*indices_)[position]], vpx_, vpy_, vpz_,
+                                point.normal[0], point.normal[1], point.normal[2]);
+  }
+  return (dense);
+}
 
-      flipNormalTowardsViewpoint ((*input_)[(*indices_)[idx]], vpx_, vpy_, vpz_,
-                                  output[idx].normal[0], output[idx].normal[1], output[idx].normal[2]);
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointOutT> void
+pcl::NormalEstimation<PointInT, PointOutT>::computeFeature (PointCloudOut &output)
+{
+  // Allocate enough space to hold the results
+  // \note This resize is irrelevant for a radiusSearch ().
+  std::vector<std::vector<int> > nn_indices (detail::normal_batch_size, std::vector<int> (k_));
+  std::vector<float> nn_dists (k_);
 
-    }
+  output.is_dense = true;
+  // The normals are estimated by batches of neighborhoods
+  for (std::size_t begin = 0; begin < indices_->size (); begin += detail::normal_batch_size)
+  {
+    const std::size_t count = std::min (detail::normal_batch_size, indices_->size () - begin);
+    if (!computeNormalBatch (begin, count, nn_indices, nn_dists, output))
+      output.is_dense = false;
   }
 }
 
@@ -0,0 +1,246 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved
+ */
+
+#ifndef PCL_FEATURES_IMPL_NORMAL_3D_BATCH_HPP_
+#define PCL_FEATURES_IMPL_NORMAL_3D_BATCH_HPP_
+
+#include <pcl/point_cloud.h>
+#include <pcl/common/point_tests.h> // for pcl::isFinite
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace pcl
+{
+  namespace detail
+  {
+    /** \brief The number of neighborhoods whose normals are estimated at once.
+      *
+      * The covariance matrices and the plane fits of a batch are computed lane by lane: every coefficient has one
+      * small array with an entry per neighborhood, and the computations are plain loops over these arrays without
+      * branches, which the compiler vectorizes for the enabled instruction sets (SSE, AVX, NEON, ...). Only the
+      * trigonometric functions of the closed form eigenvalue solver are evaluated one lane after the other.
+      */
+    constexpr std::size_t normal_batch_size = 8;
+
+    /** \brief The covariance matrices of a batch of neighborhoods and their plane fits, one array per coefficient. */
+    struct NormalBatch
+    {
+      float xx[normal_batch_size];
+      float xy[normal_batch_size];
+      float xz[normal_batch_size];
+      float yy[normal_batch_size];
+      float yz[normal_batch_size];
+      float zz[normal_batch_size];
+      /** \brief Whether the neighborhood has at least 3 points, of which at least one is finite. */
+      std::uint8_t valid[normal_batch_size];
+      float nx[normal_batch_size];
+      float ny[normal_batch_size];
+      float nz[normal_batch_size];
+      float curvature[normal_batch_size];
+    };
+
+    /** \brief Compute the covariance matrices of count (at most normal_batch_size) neighborhoods, as
+      * pcl::computeMeanAndCovarianceMatrix does for each of them.
+      *
+      * The sums of all the neighborhoods advance together over their first neighbors, as many as the smallest
+      * neighborhood has, then the remaining neighbors of every neighborhood are added. Each sum is computed in
+      * the order of its neighbors, the results are the same as with the sums of a single neighborhood.
+      * \param[in] cloud the cloud the neighbors belong to
+      * \param[in] neighborhoods the indices of the neighbors in \a cloud, for each neighborhood
+      * \param[in] count the number of neighborhoods
+      * \param[out] batch the covariance matrices, the remaining lanes are not valid
+      */
+    template <typename PointT> inline void
+    computeCovarianceBatch (const pcl::PointCloud<PointT> &cloud, const std::vector<int> *const *neighborhoods,
+                            std::size_t count, NormalBatch &batch)
+    {
+      float accu[9][normal_batch_size];
+      float nr_points[normal_batch_size];
+      std::size_t sizes[normal_batch_size];
+      std::size_t common = std::numeric_limits<std::size_t>::max ();
+      for (std::size_t i = 0; i < normal_batch_size; ++i)
+      {
+        sizes[i] = (i < count && neighborhoods[i]->size () >= 3 ? neighborhoods[i]->size () : 0);
+        if (sizes[i] > 0)
+          common = std::min (common, sizes[i]);
+        for (auto &sum : accu)
+          sum[i] = 0.0f;
+        nr_points[i] = 0.0f;
+      }
+      if (common == std::numeric_limits<std::size_t>::max ())
+        common = 0;
+
+      // The neighbors which are not finite are not counted, as in computeMeanAndCovarianceMatrix
+      const bool is_dense = cloud.is_dense;
+      auto load = [&cloud, is_dense] (int index, float &x, float &y, float &z, float &weight)
+      {
+        const PointT &point = cloud[index];
+        const bool finite = is_dense || isFinite (point);
+        x = (finite ? point.x : 0.0f);
+        y = (finite ? point.y : 0.0f);
+        z = (finite ? point.z : 0.0f);
+        weight = (finite ? 1.0f : 0.0f);
+      };
+
+      float x[normal_batch_size], y[normal_batch_size], z[normal_batch_size], weight[normal_batch_size];
+      for (std::size_t j = 0; j < common; ++j)
+      {
+        for (std::size_t i = 0; i < normal_batch_size; ++i)
+        {
+          if (sizes[i] > 0)
+            load ((*neighborhoods[i])[j], x[i], y[i], z[i], weight[i]);
+          else
+            x[i] = y[i] = z[i] = weight[i] = 0.0f;
+        }
+        for (std::size_t i = 0; i < normal_batch_size; ++i)
+        {
+          accu[0][i] += x[i] * x[i];
+          accu[1][i] += x[i] * y[i];
+          accu[2][i] += x[i] * z[i];
+          accu[3][i] += y[i] * y[i];
+          accu[4][i] += y[i] * z[i];
+          accu[5][i] += z[i] * z[i];
+          accu[6][i] += x[i];
+          accu[7][i] += y[i];
+          accu[8][i] += z[i];
+          nr_points[i] += weight[i];
+        }
+      }
+      for (std::size_t i = 0; i < normal_batch_size; ++i)
+      {
+        for (std::size_t j = common; j < sizes[i]; ++j)
+        {
+          float px, py, pz, w;
+          load ((*neighborhoods[i])[j], px, py, pz, w);
+          accu[0][i] += px * px;
+          accu[1][i] += px * py;
+          accu[2][i] += px * pz;
+          accu[3][i] += py * py;
+          accu[4][i] += py * pz;
+          accu[5][i] += pz * pz;
+          accu[6][i] += px;
+          accu[7][i] += py;
+          accu[8][i] += pz;
+          nr_points[i] += w;
+        }
+      }
+
+      for (std::size_t i = 0; i < normal_batch_size; ++i)
+      {
+        const float n = std::max (nr_points[i], 1.0f);
+        const float mx = accu[6][i] / n, my = accu[7][i] / n, mz = accu[8][i] / n;
+        batch.xx[i] = accu[0][i] / n - mx * mx;
+        batch.xy[i] = accu[1][i] / n - mx * my;
+        batch.xz[i] = accu[2][i] / n - mx * mz;
+        batch.yy[i] = accu[3][i] / n - my * my;
+        batch.yz[i] = accu[4][i] / n - my * mz;
+        batch.zz[i] = accu[5][i] / n - mz * mz;
+        batch.valid[i] = static_cast<std::uint8_t> ((sizes[i] > 0) & (nr_points[i] > 0.0f));
+      }
+    }
+
+    /** \brief Fit a plane to every valid neighborhood of a batch, as pcl::solvePlaneParameters does for a single
+      * covariance matrix: the normal is the eigenvector of the smallest eigenvalue, obtained with the closed form
+      * of pcl::eigen33, and the curvature is the ratio of the smallest eigenvalue to their sum.
+      * \param[in,out] batch the covariance matrices, to which the normals and curvatures are written (NaN for the
+      * lanes which are not valid)
+      */
+    inline void
+    solvePlaneBatch (NormalBatch &batch)
+    {
+      const float s_inv3 = 1.0f / 3.0f;
+      const float s_sqrt3 = std::sqrt (3.0f);
+      const float nan = std::numeric_limits<float>::quiet_NaN ();
+
+      float scale[normal_batch_size];
+      float m00[normal_batch_size], m01[normal_batch_size], m02[normal_batch_size];
+      float m11[normal_batch_size], m12[normal_batch_size], m22[normal_batch_size];
+      float c0[normal_batch_size], c2_over_3[normal_batch_size], half_b[normal_batch_size];
+      float rho[normal_batch_size], root_q[normal_batch_size];
+      for (std::size_t i = 0; i < normal_batch_size; ++i)
+      {
+        // Scale the matrix so that its entries are in [-1, 1]
+        float s = std::max (std::max (std::max (std::abs (batch.xx[i]), std::abs (batch.xy[i])),
+                                      std::max (std::abs (batch.xz[i]), std::abs (batch.yy[i]))),
+                            std::max (std::abs (batch.yz[i]), std::abs (batch.zz[i])));
+        s = (s <= std::numeric_limits<float>::min () ? 1.0f : s);
+        scale[i] = s;
+        m00[i] = batch.xx[i] / s;
+        m01[i] = batch.xy[i] / s;
+        m02[i] = batch.xz[i] / s;
+        m11[i] = batch.yy[i] / s;
+        m12[i] = batch.yz[i] / s;
+        m22[i] = batch.zz[i] / s;
+
+        // The characteristic equation is x^3 - c2*x^2 + c1*x - c0 = 0
+        c0[i] = m00[i] * m11[i] * m22[i] + 2.0f * m01[i] * m02[i] * m12[i] - m00[i] * m12[i] * m12[i] -
+                m11[i] * m02[i] * m02[i] - m22[i] * m01[i] * m01[i];
+        const float c1 = m00[i] * m11[i] - m01[i] * m01[i] + m00[i] * m22[i] - m02[i] * m02[i] +
+                         m11[i] * m22[i] - m12[i] * m12[i];
+        const float c2 = m00[i] + m11[i] + m22[i];
+        c2_over_3[i] = c2 * s_inv3;
+        const float a_over_3 = std::min ((c1 - c2 * c2_over_3[i]) * s_inv3, 0.0f);
+        half_b[i] = 0.5f * (c0[i] + c2_over_3[i] * (2.0f * c2_over_3[i] * c2_over_3[i] - c1));
+        const float q = std::min (half_b[i] * half_b[i] + a_over_3 * a_over_3 * a_over_3, 0.0f);
+        rho[i] = std::sqrt (-a_over_3);
+        root_q[i] = std::sqrt (-q);
+      }
+
+      float cos_theta[normal_batch_size], sin_theta[normal_batch_size];
+      for (std::size_t i = 0; i < normal_batch_size; ++i)
+      {
+        const float theta = std::atan2 (root_q[i], half_b[i]) * s_inv3;
+        cos_theta[i] = std::cos (theta);
+        sin_theta[i] = std::sin (theta);
+      }
+
+      for (std::size_t i = 0; i < normal_batch_size; ++i)
+      {
+        // The smallest root, which is 0 when the matrix is singular or the roots are not positive
+        const float r0 = c2_over_3[i] + 2.0f * rho[i] * cos_theta[i];
+        const float r1 = c2_over_3[i] - rho[i] * (cos_theta[i] + s_sqrt3 * sin_theta[i]);
+        const float r2 = c2_over_3[i] - rho[i] * (cos_theta[i] - s_sqrt3 * sin_theta[i]);
+        const float smallest = std::min (r0, std::min (r1, r2));
+        const bool singular = (std::abs (c0[i]) < std::numeric_limits<float>::epsilon ()) | (smallest <= 0.0f);
+        const float eigenvalue = (singular ? 0.0f : smallest);
+
+        // The eigenvector is the largest cross product of two rows of the matrix minus the eigenvalue
+        const float d00 = m00[i] - eigenvalue, d11 = m11[i] - eigenvalue, d22 = m22[i] - eigenvalue;
+        const float a0 = m01[i] * m12[i] - m02[i] * d11, a1 = m02[i] * m01[i] - d00 * m12[i], a2 = d00 * d11 - m01[i] * m01[i];
+        const float b0 = m01[i] * d22 - m02[i] * m12[i], b1 = m02[i] * m02[i] - d00 * d22, b2 = d00 * m12[i] - m01[i] * m02[i];
+        const float e0 = d11 * d22 - m12[i] * m12[i], e1 = m12[i] * m02[i] - m01[i] * d22, e2 = m01[i] * m12[i] - d11 * m02[i];
+        const float len_a = std::sqrt (a0 * a0 + a1 * a1 + a2 * a2);
+        const float len_b = std::sqrt (b0 * b0 + b1 * b1 + b2 * b2);
+        const float len_e = std::sqrt (e0 * e0 + e1 * e1 + e2 * e2);
+        const bool pick_a = (len_a >= len_b) & (len_a >= len_e);
+        const bool pick_b = !pick_a & (len_b >= len_e);
+        const float length = (pick_a ? len_a : (pick_b ? len_b : len_e));
+        const float nx = (pick_a ? a0 : (pick_b ? b0 : e0)) / length;
+        const float ny = (pick_a ? a1 : (pick_b ? b1 : e1)) / length;
+        const float nz = (pick_a ? a2 : (pick_b ? b2 : e2)) / length;
+
+        // The curvature surface change
+        const float eig_sum = batch.xx[i] + batch.yy[i] + batch.zz[i];
+        const float curvature = (eig_sum != 0.0f ? std::abs (eigenvalue * scale[i] / eig_sum) : 0.0f);
+
+        const bool valid = (batch.valid[i] != 0);
+        batch.nx[i] = (valid ? nx : nan);
+        batch.ny[i] = (valid ? ny : nan);
+        batch.nz[i] = (valid ? nz : nan);
+        batch.curvature[i] = (valid ? curvature : nan);
+      }
+    }
+  }
+}
+
+#endif  // PCL_FEATURES_IMPL_NORMAL_3D_BATCH_HPP_
@@ -42,6 +42,7 @@
 #define PCL_FEATURES_IMPL_NORMAL_3D_OMP_H_
 
 #include <pcl/features/normal_3d_omp.h>
+#include <pcl/common/utils.h> // for getNumberOfThreads
 
 ///////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointInT, typename PointOutT> void
@@ -63,69 +64,24 @@ pcl::NormalEstimationOMP<PointInT, PointOutT>::computeFeature (PointCloudOut &ou
 {
   // Allocate enough space to hold the results
   // \note This resize is irrelevant for a radiusSearch ().
-  std::vector<int> nn_indices (k_);
+  std::vector<std::vector<int> > nn_indices (detail::normal_batch_size, std::vector<int> (k_));
   std::vector<float> nn_dists (k_);
 
   output.is_dense = true;
-  // Save a few cycles by not checking every point for NaN/Inf values if the cloud is set to dense
-  if (input_->is_dense)
-  {
+  // The normals are estimated by batches of neighborhoods, one batch after the other in each thread
+  std::size_t batch_size = detail::normal_batch_size;
+  std::ptrdiff_t nr_batches = (indices_->size () + batch_size - 1) / batch_size;
 #pragma omp parallel for \
   default(none) \
-  shared(output) \
+  shared(output, batch_size, nr_batches) \
   firstprivate(nn_indices, nn_dists) \
-  num_threads(threads_)
-    // Iterating over the entire index vector
-    for (std::ptrdiff_t idx = 0; idx < static_cast<std::ptrdiff_t> (indices_->size ()); ++idx)
-    {
-      Eigen::Vector4f n;
-      if (this->searchForNeighbors ((*indices_)[idx], search_parameter_, nn_indices, nn_dists) == 0 ||
-          !pcl::computePointNormal (*surface_, nn_indices, n, output[idx].curvature))
-      {
-        output[idx].normal[0] = output[idx].normal[1] = output[idx].normal[2] = output[idx].curvature = std::numeric_limits<float>::quiet_NaN ();
-
-        output.is_dense = false;
-        continue;
-      }
-
-      output[idx].normal_x = n[0];
-      output[idx].normal_y = n[1];
-      output[idx].normal_z = n[2];
-
-      flipNormalTowardsViewpoint ((*input_)[(*indices_)[idx]], vpx_, vpy_, vpz_,
-                                  output[idx].normal[0], output[idx].normal[1], output[idx].normal[2]);
-
-    }
-  }
-  else
+  num_threads(pcl::utils::getNumberOfThreads (threads_))
+  for (std::ptrdiff_t batch = 0; batch < nr_batches; ++batch)
   {
-#pragma omp parallel for \
-  default(none) \
-  shared(output) \
-  firstprivate(nn_indices, nn_dists) \
-  num_threads(threads_)
-    // Iterating over the entire index vector
-    for (std::ptrdiff_t idx = 0; idx < static_cast<std::ptrdiff_t> (indices_->size ()); ++idx)
-    {
-      Eigen::Vector4f n;
-      if (!isFinite ((*input_)[(*indices_)[idx]]) ||
-          this->searchForNeighbors ((*indices_)[idx], search_parameter_, nn_indices, nn_dists) == 0 ||
-          !pcl::computePointNormal (*surface_, nn_indices, n, output[idx].curvature))
-      {
-        output[idx].normal[0] = output[idx].normal[1] = output[idx].normal[2] = output[idx].curvature = std::numeric_limits<float>::quiet_NaN ();
-
-        output.is_dense = false;
-        continue;
-      }
-
-      output[idx].normal_x = n[0];
-      output[idx].normal_y = n[1];
-      output[idx].normal_z = n[2];
-
-      flipNormalTowardsViewpoint ((*input_)[(*indices_)[idx]], vpx_, vpy_, vpz_,
-                                  output[idx].normal[0], output[idx].normal[1], output[idx].normal[2]);
-
-    }
+    const std::size_t begin = batch * batch_size;
+    const std::size_t count = std::min (batch_size, indices_->size () - begin);
+    if (!this->computeNormalBatch (begin, count, nn_indices, nn_dists, output))
+      output.is_dense = false;
   }
 }
 
@@ -39,6 +39,7 @@
 #define PCL_FEATURES_IMPL_ORGANIZED_EDGE_DETECTION_H_
 
 #include <pcl/2d/edge.h>
+#include <pcl/common/utils.h> // for getNumberOfThreads
 #include <pcl/features/organized_edge_detection.h>
 
 /**
@@ -89,7 +90,7 @@ pcl::OrganizedEdgeBase<PointT, PointLT>::extractEdges (pcl::PointCloud<PointLT>&
   {
     // Fill lookup table for next points to visit
     const int num_of_ngbr = 8;
-    Neighbor directions [num_of_ngbr] = {Neighbor(-1, 0, -1),
+    const Neighbor directions [num_of_ngbr] = {Neighbor(-1, 0, -1),
       Neighbor(-1, -1, -labels.width - 1), 
       Neighbor( 0, -1, -labels.width    ),
       Neighbor( 1, -1, -labels.width + 1),
@@ -98,39 +99,46 @@ pcl::OrganizedEdgeBase<PointT, PointLT>::extractEdges (pcl::PointCloud<PointLT>&
       Neighbor( 0,  1,  labels.width    ),
       Neighbor(-1,  1,  labels.width - 1)};
 
-    for (int row = 1; row < int(input_->height) - 1; row++)
+    // The rows are independent, every pixel only writes its own label
+    const int height = static_cast<int> (input_->height);
+    const int width = static_cast<int> (input_->width);
+#pragma omp parallel for schedule(dynamic, 8) num_threads(pcl::utils::getNumberOfThreads (threads_))
+    for (int row = 1; row < height - 1; row++)
     {
-      for (int col = 1; col < int(input_->width) - 1; col++)
+      for (int col = 1; col < width - 1; col++)
       {
-        int curr_idx = row*int(input_->width) + col;
+        int curr_idx = row*width + col;
         if (!std::isfinite ((*input_)[curr_idx].z))
           continue;
 
         float curr_depth = std::abs ((*input_)[curr_idx].z);
 
-        // Calculate depth distances between current point and neighboring points
-        std::vector<float> nghr_dist;
-        nghr_dist.resize (8);
-        bool found_invalid_neighbor = false;
+        // Calculate depth distances between current point and neighboring points, and sum up the directions of the
+        // invalid neighbors. There are no early exits, so that the tests of the 8 neighbors are vectorized
+        float nghr_dist[num_of_ngbr];
+        int dx = 0;
+        int dy = 0;
+        int num_of_invalid_pt = 0;
         for (int d_idx = 0; d_idx < num_of_ngbr; d_idx++)
         {
-          int nghr_idx = curr_idx + directions[d_idx].d_index;
-          assert (nghr_idx >= 0 && nghr_idx < input_->size ());
-          if (!std::isfinite ((*input_)[nghr_idx].z))
-          {
-            found_invalid_neighbor = true;
-            break;
-          }
-          nghr_dist[d_idx] = curr_depth - std::abs ((*input_)[nghr_idx].z);
+          const float nghr_depth = (*input_)[curr_idx + directions[d_idx].d_index].z;
+          const int invalid = !std::isfinite (nghr_depth);
+          nghr_dist[d_idx] = curr_depth - std::abs (nghr_depth);
+          dx += invalid * directions[d_idx].d_x;
+          dy += invalid * directions[d_idx].d_y;
+          num_of_invalid_pt += invalid;
         }
 
-        if (!found_invalid_neighbor)
+        if (num_of_invalid_pt == 0)
         {
           // Every neighboring points are valid
-          std::vector<float>::const_iterator min_itr, max_itr;
-          std::tie (min_itr, max_itr) = std::minmax_element (nghr_dist.cbegin (), nghr_dist.cend ());
-          float nghr_dist_min = *min_itr;
-          float nghr_dist_max = *max_itr;
+          float nghr_dist_min = nghr_dist[0];
+          float nghr_dist_max = nghr_dist[0];
+          for (int d_idx = 1; d_idx < num_of_ngbr; d_idx++)
+          {
+            nghr_dist_min = std::min (nghr_dist_min, nghr_dist[d_idx]);
+            nghr_dist_max = std::max (nghr_dist_max, nghr_dist[d_idx]);
+          }
           float dist_dominant = std::max(std::abs (nghr_dist_min),std::abs (nghr_dist_max));
           if (std::abs (dist_dominant) > th_depth_discon_*std::abs (curr_depth))
           {
@@ -152,23 +160,6 @@ pcl::OrganizedEdgeBase<PointT, PointLT>::extractEdges (pcl::PointCloud<PointLT>&
           // Some neighboring points are not valid (nan points)
           // Search for corresponding point across invalid points
           // Search direction is determined by nan point locations with respect to current point
-          int dx = 0;
-          int dy = 0;
-          int num_of_invalid_pt = 0;
-          for (const auto &direction : directions)
-          {
-            int nghr_idx = curr_idx + direction.d_index;
-            assert (nghr_idx >= 0 && nghr_idx < input_->size ());
-            if (!std::isfinite ((*input_)[nghr_idx].z))
-            {
-              dx += direction.d_x;
-              dy += direction.d_y;
-              num_of_invalid_pt++;
-            }
-          }
-
-          // Search directions
-          assert (num_of_invalid_pt > 0);
           float f_dx = static_cast<float> (dx) / static_cast<float> (num_of_invalid_pt);
           float f_dy = static_cast<float> (dy) / static_cast<float> (num_of_invalid_pt);
 
@@ -179,12 +170,12 @@ pcl::OrganizedEdgeBase<PointT, PointLT>::extractEdges (pcl::PointCloud<PointLT>&
             int s_row = row + static_cast<int> (std::floor (f_dy*static_cast<float> (s_idx)));
             int s_col = col + static_cast<int> (std::floor (f_dx*static_cast<float> (s_idx)));
 
-            if (s_row < 0 || s_row >= int(input_->height) || s_col < 0 || s_col >= int(input_->width))
+            if (s_row < 0 || s_row >= height || s_col < 0 || s_col >= width)
               break;
 
-            if (std::isfinite ((*input_)[s_row*int(input_->width)+s_col].z))
+            if (std::isfinite ((*input_)[s_row*width+s_col].z))
             {
-              corr_depth = std::abs ((*input_)[s_row*int(input_->width)+s_col].z);
+              corr_depth = std::abs ((*input_)[s_row*width+s_col].z);
               break;
             }
           }
@@ -220,6 +211,20 @@ pcl::OrganizedEdgeBase<PointT, PointLT>::extractEdges (pcl::PointCloud<PointLT>&
   }
 }
 
+//////////////////////////////////////////////////////////////////////////////
+template<typename PointT, typename PointLT> void
+pcl::OrganizedEdgeBase<PointT, PointLT>::assignEdgeLabel (const pcl::PointCloud<pcl::PointXYZIEdge>& img_edge,
+                                                          unsigned label, pcl::PointCloud<PointLT>& labels) const
+{
+  const std::ptrdiff_t nr_points = static_cast<std::ptrdiff_t> (labels.size ());
+#pragma omp parallel for num_threads(pcl::utils::getNumberOfThreads (threads_))
+  for (std::ptrdiff_t idx = 0; idx < nr_points; idx++)
+  {
+    if (img_edge[idx].magnitude == 255.f)
+      labels[idx].label |= label;
+  }
+}
+
 
 //////////////////////////////////////////////////////////////////////////////
 template<typename PointT, typename PointLT> void
@@ -243,32 +248,34 @@ pcl::OrganizedEdgeFromRGB<PointT, PointLT>::extractEdges (pcl::PointCloud<PointL
 {
   if ((detecting_edge_types_ & EDGELABEL_RGB_CANNY))
   {
-    pcl::PointCloud<PointXYZI>::Ptr gray (new pcl::PointCloud<PointXYZI>);
-    gray->width = input_->width;
-    gray->height = input_->height;
-    gray->resize (input_->height*input_->width);
-
-    for (std::size_t i = 0; i < input_->size (); ++i)
-      (*gray)[i].intensity = float (((*input_)[i].r + (*input_)[i].g + (*input_)[i].b) / 3);
-
     pcl::PointCloud<pcl::PointXYZIEdge> img_edge_rgb;
-    pcl::Edge<PointXYZI, pcl::PointXYZIEdge> edge;
-    edge.setInputCloud (gray);
-    edge.setHysteresisThresholdLow (th_rgb_canny_low_);
-    edge.setHysteresisThresholdHigh (th_rgb_canny_high_);
-    edge.detectEdgeCanny (img_edge_rgb);
-    
-    for (std::uint32_t row=0; row<labels.height; row++)
-    {
-      for (std::uint32_t col=0; col<labels.width; col++)
-      {
-        if (img_edge_rgb (col, row).magnitude == 255.f)
-          labels[row * labels.width + col].label |= EDGELABEL_RGB_CANNY;
-      }
-    }
+    detectRGBCannyEdges (img_edge_rgb);
+    this->assignEdgeLabel (img_edge_rgb, EDGELABEL_RGB_CANNY, labels);
   }
 }
 
+//////////////////////////////////////////////////////////////////////////////
+template<typename PointT, typename PointLT> void
+pcl::OrganizedEdgeFromRGB<PointT, PointLT>::detectRGBCannyEdges (pcl::PointCloud<pcl::PointXYZIEdge>& img_edge_rgb) const
+{
+  pcl::PointCloud<PointXYZI>::Ptr gray (new pcl::PointCloud<PointXYZI>);
+  gray->width = input_->width;
+  gray->height = input_->height;
+  gray->resize (input_->height*input_->width);
+
+  const std::ptrdiff_t nr_points = static_cast<std::ptrdiff_t> (input_->size ());
+#pragma omp parallel for num_threads(pcl::utils::getNumberOfThreads (this->threads_))
+  for (std::ptrdiff_t i = 0; i < nr_points; ++i)
+    (*gray)[i].intensity = float (((*input_)[i].r + (*input_)[i].g + (*input_)[i].b) / 3);
+
+  pcl::Edge<PointXYZI, pcl::PointXYZIEdge> edge;
+  edge.setInputCloud (gray);
+  edge.setHysteresisThresholdLow (th_rgb_canny_low_);
+  edge.setHysteresisThresholdHigh (th_rgb_canny_high_);
+  edge.setNumberOfThreads (this->threads_);
+  edge.detectEdgeCanny (img_edge_rgb);
+}
+
 //////////////////////////////////////////////////////////////////////////////
 template<typename PointT, typename PointNT, typename PointLT> void
 pcl::OrganizedEdgeFromNormals<PointT, PointNT, PointLT>::compute (pcl::PointCloud<PointLT>& labels, std::vector<pcl::PointIndices>& label_indices) const
@@ -291,40 +298,38 @@ pcl::OrganizedEdgeFromNormals<PointT, PointNT, PointLT>::extractEdges (pcl::Poin
 {
   if ((detecting_edge_types_ & EDGELABEL_HIGH_CURVATURE))
   {
-
-    pcl::PointCloud<PointXYZI> nx, ny;
-    nx.width = normals_->width;
-    nx.height = normals_->height;
-    nx.resize (normals_->height*normals_->width);
-
-    ny.width = normals_->width;
-    ny.height = normals_->height;
-    ny.resize (normals_->height*normals_->width);
-
-    for (std::uint32_t row=0; row<normals_->height; row++)
-    {
-      for (std::uint32_t col=0; col<normals_->width; col++)
-      {
-        nx (col, row).intensity = (*normals_)[row*normals_->width + col].normal_x;
-        ny (col, row).intensity = (*normals_)[row*normals_->width + col].normal_y;
-      }
-    }
-
     pcl::PointCloud<pcl::PointXYZIEdge> img_edge;
-    pcl::Edge<PointXYZI, pcl::PointXYZIEdge> edge;
-    edge.setHysteresisThresholdLow (th_hc_canny_low_);
-    edge.setHysteresisThresholdHigh (th_hc_canny_high_);
-    edge.canny (nx, ny, img_edge);
+    detectHighCurvatureEdges (img_edge);
+    this->assignEdgeLabel (img_edge, EDGELABEL_HIGH_CURVATURE, labels);
+  }
+}
 
-    for (std::uint32_t row=0; row<labels.height; row++)
-    {
-      for (std::uint32_t col=0; col<labels.width; col++)
-      {
-        if (img_edge (col, row).magnitude == 255.f)
-          labels[row * labels.width + col].label |= EDGELABEL_HIGH_CURVATURE;
-      }
-    }
+//////////////////////////////////////////////////////////////////////////////
+template<typename PointT, typename PointNT, typename PointLT> void
+pcl::OrganizedEdgeFromNormals<PointT, PointNT, PointLT>::detectHighCurvatureEdges (pcl::PointCloud<pcl::PointXYZIEdge>& img_edge) const
+{
+  pcl::PointCloud<PointXYZI> nx, ny;
+  nx.width = normals_->width;
+  nx.height = normals_->height;
+  nx.resize (normals_->height*normals_->width);
+
+  ny.width = normals_->width;
+  ny.height = normals_->height;
+  ny.resize (normals_->height*normals_->width);
+
+  const std::ptrdiff_t nr_points = static_cast<std::ptrdiff_t> (nx.size ());
+#pragma omp parallel for num_threads(pcl::utils::getNumberOfThreads (this->threads_))
+  for (std::ptrdiff_t i = 0; i < nr_points; ++i)
+  {
+    nx[i].intensity = (*normals_)[i].normal_x;
+    ny[i].intensity = (*normals_)[i].normal_y;
   }
+
+  pcl::Edge<PointXYZI, pcl::PointXYZIEdge> edge;
+  edge.setHysteresisThresholdLow (th_hc_canny_low_);
+  edge.setHysteresisThresholdHigh (th_hc_canny_high_);
+  edge.setNumberOfThreads (this->threads_);
+  edge.canny (nx, ny, img_edge);
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -338,8 +343,28 @@ pcl::OrganizedEdgeFromRGBNormals<PointT, PointNT, PointLT>::compute (pcl::PointC
   labels.height = input_->height;
   
   OrganizedEdgeBase<PointT, PointLT>::extractEdges (labels);
-  OrganizedEdgeFromNormals<PointT, PointNT, PointLT>::extractEdges (labels);
-  OrganizedEdgeFromRGB<PointT, PointLT>::extractEdges (labels);
+
+  // Both Canny detections first, then a single pass over the labels
+  pcl::PointCloud<pcl::PointXYZIEdge> img_edge, img_edge_rgb;
+  const bool high_curvature = (detecting_edge_types_ & EDGELABEL_HIGH_CURVATURE);
+  const bool rgb_canny = (detecting_edge_types_ & EDGELABEL_RGB_CANNY);
+  if (high_curvature)
+    this->detectHighCurvatureEdges (img_edge);
+  if (rgb_canny)
+    this->detectRGBCannyEdges (img_edge_rgb);
+
+  if (high_curvature || rgb_canny)
+  {
+    const std::ptrdiff_t nr_points = static_cast<std::ptrdiff_t> (labels.size ());
+#pragma omp parallel for num_threads(pcl::utils::getNumberOfThreads (this->threads_))
+    for (std::ptrdiff_t idx = 0; idx < nr_points; idx++)
+    {
+      if (high_curvature && img_edge[idx].magnitude == 255.f)
+        labels[idx].label |= EDGELABEL_HIGH_CURVATURE;
+      if (rgb_canny && img_edge_rgb[idx].magnitude == 255.f)
+        labels[idx].label |= EDGELABEL_RGB_CANNY;
+    }
+  }
 
   this->assignLabelIndices (labels, label_indices);
 }
@@ -47,7 +47,7 @@
 template <typename PointInT, typename PointNT, typename PointOutT> bool
 pcl::PFHEstimation<PointInT, PointNT, PointOutT>::computePairFeatures (
       const pcl::PointCloud<PointInT> &cloud, const pcl::PointCloud<PointNT> &normals,
-      int p_idx, int q_idx, float &f1, float &f2, float &f3, float &f4)
+      int p_idx, int q_idx, float &f1, float &f2, float &f3, float &f4) const
 {
   pcl::computePairFeatures (cloud[p_idx].getVector4fMap (), normals[p_idx].getNormalVector4fMap (),
                             cloud[q_idx].getVector4fMap (), normals[q_idx].getNormalVector4fMap (),
@@ -60,8 +60,21 @@ template <typename PointInT, typename PointNT, typename PointOutT> void
 pcl::PFHEstimation<PointInT, PointNT, PointOutT>::computePointPFHSignature (
       const pcl::PointCloud<PointInT> &cloud, const pcl::PointCloud<PointNT> &normals,
       const std::vector<int> &indices, int nr_split, Eigen::VectorXf &pfh_histogram)
+{
+  computePointPFHSignature (cloud, normals, indices, nr_split, pfh_histogram,
+                            use_cache_ ? &feature_map_ : nullptr, &key_list_, max_cache_size_);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointNT, typename PointOutT> void
+pcl::PFHEstimation<PointInT, PointNT, PointOutT>::computePointPFHSignature (
+      const pcl::PointCloud<PointInT> &cloud, const pcl::PointCloud<PointNT> &normals,
+      const std::vector<int> &indices, int nr_split, Eigen::VectorXf &pfh_histogram,
+      PairFeatureMap *feature_map, PairFeatureKeys *key_list, std::size_t max_cache_size) const
 {
   int h_index, h_p;
+  int f_index[3];
+  Eigen::Vector4f pfh_tuple;
 
   // Clear the resultant point histogram
   pfh_histogram.setZero ();
@@ -75,40 +88,32 @@ pcl::PFHEstimation<PointInT, PointNT, PointOutT>::computePointPFHSignature (
   // Iterate over all the points in the neighborhood
   for (std::size_t i_idx = 0; i_idx < indices.size (); ++i_idx)
   {
+    // If the 3D points are invalid, don't bother estimating, just continue
+    if (!isFinite (cloud[indices[i_idx]]))
+      continue;
+
     for (std::size_t j_idx = 0; j_idx < i_idx; ++j_idx)
     {
-      // If the 3D points are invalid, don't bother estimating, just continue
-      if (!isFinite (cloud[indices[i_idx]]) || !isFinite (cloud[indices[j_idx]]))
+      if (!isFinite (cloud[indices[j_idx]]))
         continue;
 
-      if (use_cache_)
+      if (feature_map)
       {
-        // In order to create the key, always use the smaller index as the first key pair member
-        int p1, p2;
-  //      if (indices[i_idx] >= indices[j_idx])
-  //      {
-          p1 = indices[i_idx];
-          p2 = indices[j_idx];
-  //      }
-  //      else
-  //      {
-  //        p1 = indices[j_idx];
-  //        p2 = indices[i_idx];
-  //      }
-        key = std::pair<int, int> (p1, p2);
-
-        // Check to see if we already estimated this pair in the global hashmap
-        std::map<std::pair<int, int>, Eigen::Vector4f, std::less<>, Eigen::aligned_allocator<std::pair<const std::pair<int, int>, Eigen::Vector4f> > >::iterator fm_it = feature_map_.find (key);
-        if (fm_it != feature_map_.end ())
+        // The key is the ordered pair of indices, as the features are not symmetric
+        key = std::pair<int, int> (indices[i_idx], indices[j_idx]);
+
+        // Check to see if we already estimated this pair in the hashmap
+        const auto fm_it = feature_map->find (key);
+        if (fm_it != feature_map->end ())
         {
-          pfh_tuple_ = fm_it->second;
+          pfh_tuple = fm_it->second;
           key_found = true;
         }
         else
         {
           // Compute the pair NNi to NNj
           if (!computePairFeatures (cloud, normals, indices[i_idx], indices[j_idx],
-                                    pfh_tuple_[0], pfh_tuple_[1], pfh_tuple_[2], pfh_tuple_[3]))
+                                    pfh_tuple[0], pfh_tuple[1], pfh_tuple[2], pfh_tuple[3]))
             continue;
 
           key_found = false;
@@ -116,45 +121,45 @@ pcl::PFHEstimation<PointInT, PointNT, PointOutT>::computePointPFHSignature (
       }
       else
         if (!computePairFeatures (cloud, normals, indices[i_idx], indices[j_idx],
-                                  pfh_tuple_[0], pfh_tuple_[1], pfh_tuple_[2], pfh_tuple_[3]))
+                                  pfh_tuple[0], pfh_tuple[1], pfh_tuple[2], pfh_tuple[3]))
           continue;
 
       // Normalize the f1, f2, f3 features and push them in the histogram
-      f_index_[0] = static_cast<int> (std::floor (nr_split * ((pfh_tuple_[0] + M_PI) * d_pi_)));
-      if (f_index_[0] < 0)         f_index_[0] = 0;
-      if (f_index_[0] >= nr_split) f_index_[0] = nr_split - 1;
+      f_index[0] = static_cast<int> (std::floor (nr_split * ((pfh_tuple[0] + M_PI) * d_pi_)));
+      if (f_index[0] < 0)         f_index[0] = 0;
+      if (f_index[0] >= nr_split) f_index[0] = nr_split - 1;
 
-      f_index_[1] = static_cast<int> (std::floor (nr_split * ((pfh_tuple_[1] + 1.0) * 0.5)));
-      if (f_index_[1] < 0)         f_index_[1] = 0;
-      if (f_index_[1] >= nr_split) f_index_[1] = nr_split - 1;
+      f_index[1] = static_cast<int> (std::floor (nr_split * ((pfh_tuple[1] + 1.0) * 0.5)));
+      if (f_index[1] < 0)         f_index[1] = 0;
+      if (f_index[1] >= nr_split) f_index[1] = nr_split - 1;
 
-      f_index_[2] = static_cast<int> (std::floor (nr_split * ((pfh_tuple_[2] + 1.0) * 0.5)));
-      if (f_index_[2] < 0)         f_index_[2] = 0;
-      if (f_index_[2] >= nr_split) f_index_[2] = nr_split - 1;
+      f_index[2] = static_cast<int> (std::floor (nr_split * ((pfh_tuple[2] + 1.0) * 0.5)));
+      if (f_index[2] < 0)         f_index[2] = 0;
+      if (f_index[2] >= nr_split) f_index[2] = nr_split - 1;
 
       // Copy into the histogram
       h_index = 0;
       h_p     = 1;
-      for (const int &d : f_index_)
+      for (const int &d : f_index)
       {
         h_index += h_p * d;
         h_p     *= nr_split;
       }
       pfh_histogram[h_index] += hist_incr;
 
-      if (use_cache_ && !key_found)
+      if (feature_map && !key_found)
       {
         // Save the value in the hashmap
-        feature_map_[key] = pfh_tuple_;
+        (*feature_map)[key] = pfh_tuple;
 
         // Use a maximum cache so that we don't go overboard on RAM usage
-        key_list_.push (key);
+        key_list->push (key);
         // Check to see if we need to remove an element due to exceeding max_size
-        if (key_list_.size () > max_cache_size_)
+        if (key_list->size () > max_cache_size)
         {
           // Remove the oldest element.
-          feature_map_.erase (key_list_.front ());
-          key_list_.pop ();
+          feature_map->erase (key_list->front ());
+          key_list->pop ();
         }
       }
     }
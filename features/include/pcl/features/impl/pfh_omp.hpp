@@ -0,0 +1,88 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved
+ */
+
+#ifndef PCL_FEATURES_IMPL_PFH_OMP_HPP_
+#define PCL_FEATURES_IMPL_PFH_OMP_HPP_
+
+#include <pcl/features/pfh_omp.h>
+#include <pcl/common/point_tests.h> // for pcl::isFinite
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointNT, typename PointOutT> void
+pcl::PFHEstimationOMP<PointInT, PointNT, PointOutT>::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs ();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointNT, typename PointOutT> void
+pcl::PFHEstimationOMP<PointInT, PointNT, PointOutT>::computeFeature (PointCloudOut &output)
+{
+  int nr_bins = nr_subdiv_ * nr_subdiv_ * nr_subdiv_;
+
+  // Every thread processes a contiguous range of the indices with its own pair features cache, the threads share
+  // the maximum cache size
+  std::size_t nr_points = indices_->size ();
+  std::size_t nr_chunks = std::max<std::size_t> (1, std::min<std::size_t> (threads_, nr_points));
+  std::size_t chunk_cache_size = std::max<std::size_t> (1, max_cache_size_ / nr_chunks);
+
+  output.is_dense = true;
+
+#pragma omp parallel for \
+  default(none) \
+  shared(chunk_cache_size, nr_bins, nr_chunks, nr_points, output) \
+  num_threads(threads_)
+  for (std::ptrdiff_t chunk = 0; chunk < static_cast<std::ptrdiff_t> (nr_chunks); ++chunk)
+  {
+    const std::size_t begin = nr_points * chunk / nr_chunks;
+    const std::size_t end = nr_points * (chunk + 1) / nr_chunks;
+
+    PairFeatureMap feature_map;
+    PairFeatureKeys key_list;
+    Eigen::VectorXf pfh_histogram (nr_bins);
+    std::vector<int> nn_indices (k_); // \note These resizes are irrelevant for a radiusSearch ().
+    std::vector<float> nn_dists (k_);
+
+    for (std::size_t idx = begin; idx < end; ++idx)
+    {
+      if (!(input_->is_dense || isFinite ((*input_)[(*indices_)[idx]])) ||
+          this->searchForNeighbors ((*indices_)[idx], search_parameter_, nn_indices, nn_dists) == 0)
+      {
+        for (int d = 0; d < nr_bins; ++d)
+          output[idx].histogram[d] = std::numeric_limits<float>::quiet_NaN ();
+
+        output.is_dense = false;
+        continue;
+      }
+
+      // Estimate the PFH signature at each patch
+      this->computePointPFHSignature (*surface_, *normals_, nn_indices, nr_subdiv_, pfh_histogram,
+                                      use_cache_ ? &feature_map : nullptr, &key_list, chunk_cache_size);
+
+      // Copy into the resultant cloud
+      for (int d = 0; d < nr_bins; ++d)
+        output[idx].histogram[d] = pfh_histogram[d];
+    }
+  }
+}
+
+#define PCL_INSTANTIATE_PFHEstimationOMP(T,NT,OutT) template class PCL_EXPORTS pcl::PFHEstimationOMP<T,NT,OutT>;
+
+#endif  // PCL_FEATURES_IMPL_PFH_OMP_HPP_
@@ -47,7 +47,7 @@ template <typename PointInT, typename PointNT, typename PointOutT> bool
 pcl::PFHRGBEstimation<PointInT, PointNT, PointOutT>::computeRGBPairFeatures (
     const pcl::PointCloud<PointInT> &cloud, const pcl::PointCloud<PointNT> &normals,
     int p_idx, int q_idx,
-    float &f1, float &f2, float &f3, float &f4, float &f5, float &f6, float &f7)
+    float &f1, float &f2, float &f3, float &f4, float &f5, float &f6, float &f7) const
 {
   Eigen::Vector4i colors1 (cloud[p_idx].r, cloud[p_idx].g, cloud[p_idx].b, 0),
       colors2 (cloud[q_idx].r, cloud[q_idx].g, cloud[q_idx].b, 0);
@@ -63,9 +63,11 @@ pcl::PFHRGBEstimation<PointInT, PointNT, PointOutT>::computeRGBPairFeatures (
 template <typename PointInT, typename PointNT, typename PointOutT> void
 pcl::PFHRGBEstimation<PointInT, PointNT, PointOutT>::computePointPFHRGBSignature (
     const pcl::PointCloud<PointInT> &cloud, const pcl::PointCloud<PointNT> &normals,
-    const std::vector<int> &indices, int nr_split, Eigen::VectorXf &pfhrgb_histogram)
+    const std::vector<int> &indices, int nr_split, Eigen::VectorXf &pfhrgb_histogram) const
 {
   int h_index, h_p;
+  int f_index[7];
+  float pfhrgb_tuple[7];
 
   // Clear the resultant point histogram
   pfhrgb_histogram.setZero ();
@@ -84,25 +86,25 @@ pcl::PFHRGBEstimation<PointInT, PointNT, PointOutT>::computePointPFHRGBSignature
 
       // Compute the pair NNi to NNj
       if (!computeRGBPairFeatures (cloud, normals, index_i, index_j,
-                                   pfhrgb_tuple_[0], pfhrgb_tuple_[1], pfhrgb_tuple_[2], pfhrgb_tuple_[3],
-                                   pfhrgb_tuple_[4], pfhrgb_tuple_[5], pfhrgb_tuple_[6]))
+                                   pfhrgb_tuple[0], pfhrgb_tuple[1], pfhrgb_tuple[2], pfhrgb_tuple[3],
+                                   pfhrgb_tuple[4], pfhrgb_tuple[5], pfhrgb_tuple[6]))
         continue;
 
       // Normalize the f1, f2, f3, f5, f6, f7 features and push them in the histogram
-      f_index_[0] = static_cast<int> (std::floor (nr_split * ((pfhrgb_tuple_[0] + M_PI) * d_pi_)));
+      f_index[0] = static_cast<int> (std::floor (nr_split * ((pfhrgb_tuple[0] + M_PI) * d_pi_)));
       // @TODO: confirm "not to do for i == 3"
       for (int i = 1; i < 3; ++i)
       {
-        const float feature_value = nr_split * ((pfhrgb_tuple_[i] + 1.0) * 0.5);
-        f_index_[i] = static_cast<int> (std::floor (feature_value));
+        const float feature_value = nr_split * ((pfhrgb_tuple[i] + 1.0) * 0.5);
+        f_index[i] = static_cast<int> (std::floor (feature_value));
       }
       // color ratios are in [-1, 1]
       for (int i = 4; i < 7; ++i)
       {
-        const float feature_value = nr_split * ((pfhrgb_tuple_[i] + 1.0) * 0.5);
-        f_index_[i] = static_cast<int> (std::floor (feature_value));
+        const float feature_value = nr_split * ((pfhrgb_tuple[i] + 1.0) * 0.5);
+        f_index[i] = static_cast<int> (std::floor (feature_value));
       }
-      for (auto& feature: f_index_)
+      for (auto& feature: f_index)
       {
         feature = std::min(nr_split - 1, std::max(0, feature));
       }
@@ -112,7 +114,7 @@ pcl::PFHRGBEstimation<PointInT, PointNT, PointOutT>::computePointPFHRGBSignature
       h_p     = 1;
       for (int d = 0; d < 3; ++d)
       {
-        h_index += h_p * f_index_[d];
+        h_index += h_p * f_index[d];
         h_p     *= nr_split;
       }
       pfhrgb_histogram[h_index] += hist_incr;
@@ -122,7 +124,7 @@ pcl::PFHRGBEstimation<PointInT, PointNT, PointOutT>::computePointPFHRGBSignature
       h_p     = 1;
       for (int d = 4; d < 7; ++d)
       {
-        h_index += h_p * f_index_[d];
+        h_index += h_p * f_index[d];
         h_p     *= nr_split;
       }
       pfhrgb_histogram[h_index] += hist_incr;
@@ -136,7 +138,6 @@ pcl::PFHRGBEstimation<PointInT, PointNT, PointOutT>::computeFeature (PointCloudO
 {
   /// nr_subdiv^3 for RGB and nr_subdiv^3 for the angular features
   pfhrgb_histogram_.setZero (2 * nr_subdiv_ * nr_subdiv_ * nr_subdiv_);
-  pfhrgb_tuple_.setZero (7);
 
   // Allocate enough space to hold the results
   // \note This resize is irrelevant for a radiusSearch ().
@@ -0,0 +1,65 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved
+ */
+
+#ifndef PCL_FEATURES_IMPL_PFHRGB_OMP_HPP_
+#define PCL_FEATURES_IMPL_PFHRGB_OMP_HPP_
+
+#include <pcl/features/pfhrgb_omp.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointNT, typename PointOutT> void
+pcl::PFHRGBEstimationOMP<PointInT, PointNT, PointOutT>::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs ();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointNT, typename PointOutT> void
+pcl::PFHRGBEstimationOMP<PointInT, PointNT, PointOutT>::computeFeature (PointCloudOut &output)
+{
+  /// nr_subdiv^3 for RGB and nr_subdiv^3 for the angular features
+  Eigen::VectorXf pfhrgb_histogram = Eigen::VectorXf::Zero (2 * nr_subdiv_ * nr_subdiv_ * nr_subdiv_);
+
+  // Allocate enough space to hold the results
+  // \note This resize is irrelevant for a radiusSearch ().
+  std::vector<int> nn_indices (k_);
+  std::vector<float> nn_dists (k_);
+
+  // Iterating over the entire index vector
+#pragma omp parallel for \
+  default(none) \
+  shared(output) \
+  firstprivate(nn_indices, nn_dists, pfhrgb_histogram) \
+  num_threads(threads_)
+  for (std::ptrdiff_t idx = 0; idx < static_cast<std::ptrdiff_t> (indices_->size ()); ++idx)
+  {
+    this->searchForNeighbors ((*indices_)[idx], search_parameter_, nn_indices, nn_dists);
+
+    // Estimate the PFH signature at each patch
+    this->computePointPFHRGBSignature (*surface_, *normals_, nn_indices, nr_subdiv_, pfhrgb_histogram);
+
+    std::copy_n (pfhrgb_histogram.data (), pfhrgb_histogram.size (),
+                 output[idx].histogram);
+  }
+}
+
+#define PCL_INSTANTIATE_PFHRGBEstimationOMP(T,NT,OutT) template class PCL_EXPORTS pcl::PFHRGBEstimationOMP<T,NT,OutT>;
+
+#endif  // PCL_FEATURES_IMPL_PFHRGB_OMP_HPP_
@@ -67,54 +67,65 @@ pcl::PPFEstimation<PointInT, PointNT, PointOutT>::computeFeature (PointCloudOut
 
   // Compute point pair features for every pair of points in the cloud
   for (std::size_t index_i = 0; index_i < indices_->size (); ++index_i)
+    if (!computeReferencePointFeatures (index_i, output))
+      output.is_dense = false;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointNT, typename PointOutT> bool
+pcl::PPFEstimation<PointInT, PointNT, PointOutT>::computeReferencePointFeatures (std::size_t index_i,
+                                                                                 PointCloudOut &output) const
+{
+  const std::size_t i = (*indices_)[index_i];
+  bool is_dense = true;
+
+  // The transformation bringing the reference point to the origin and its normal onto the x axis only depends on
+  // the reference point, it is shared by all its pairs
+  const Eigen::Vector3f model_reference_point = (*input_)[i].getVector3fMap (),
+                        model_reference_normal = (*normals_)[i].getNormalVector3fMap ();
+  const float rotation_angle = std::acos (model_reference_normal.dot (Eigen::Vector3f::UnitX ()));
+  const bool parallel_to_x = (model_reference_normal.y() == 0.0f && model_reference_normal.z() == 0.0f);
+  const Eigen::Vector3f rotation_axis = (parallel_to_x)?(Eigen::Vector3f::UnitY ()):(model_reference_normal.cross (Eigen::Vector3f::UnitX ()). normalized());
+  const Eigen::AngleAxisf rotation_mg (rotation_angle, rotation_axis);
+  const Eigen::Affine3f transform_mg (Eigen::Translation3f ( rotation_mg * ((-1) * model_reference_point)) * rotation_mg);
+
+  for (std::size_t j = 0 ; j < input_->size (); ++j)
   {
-    std::size_t i = (*indices_)[index_i];
-    for (std::size_t j = 0 ; j < input_->size (); ++j)
+    PointOutT p;
+    if (i != j)
     {
-      PointOutT p;
-      if (i != j)
+      if (//pcl::computePPFPairFeature
+          pcl::computePairFeatures ((*input_)[i].getVector4fMap (),
+                                    (*normals_)[i].getNormalVector4fMap (),
+                                    (*input_)[j].getVector4fMap (),
+                                    (*normals_)[j].getNormalVector4fMap (),
+                                    p.f1, p.f2, p.f3, p.f4))
       {
-        if (//pcl::computePPFPairFeature
-            pcl::computePairFeatures ((*input_)[i].getVector4fMap (),
-                                      (*normals_)[i].getNormalVector4fMap (),
-                                      (*input_)[j].getVector4fMap (),
-                                      (*normals_)[j].getNormalVector4fMap (),
-                                      p.f1, p.f2, p.f3, p.f4))
-        {
-          // Calculate alpha_m angle
-          Eigen::Vector3f model_reference_point = (*input_)[i].getVector3fMap (),
-                          model_reference_normal = (*normals_)[i].getNormalVector3fMap (),
-                          model_point = (*input_)[j].getVector3fMap ();
-          float rotation_angle = std::acos (model_reference_normal.dot (Eigen::Vector3f::UnitX ()));
-          bool parallel_to_x = (model_reference_normal.y() == 0.0f && model_reference_normal.z() == 0.0f);
-          Eigen::Vector3f rotation_axis = (parallel_to_x)?(Eigen::Vector3f::UnitY ()):(model_reference_normal.cross (Eigen::Vector3f::UnitX ()). normalized());
-          Eigen::AngleAxisf rotation_mg (rotation_angle, rotation_axis);
-          Eigen::Affine3f transform_mg (Eigen::Translation3f ( rotation_mg * ((-1) * model_reference_point)) * rotation_mg);
-
-          Eigen::Vector3f model_point_transformed = transform_mg * model_point;
-          float angle = std::atan2 ( -model_point_transformed(2), model_point_transformed(1));
-          if (std::sin (angle) * model_point_transformed(2) < 0.0f)
-            angle *= (-1);
-          p.alpha_m = -angle;
-        }
-        else
-        {
-          PCL_ERROR ("[pcl::%s::computeFeature] Computing pair feature vector between points %u and %u went wrong.\n", getClassName ().c_str (), i, j);
-          p.f1 = p.f2 = p.f3 = p.f4 = p.alpha_m = std::numeric_limits<float>::quiet_NaN ();
-          output.is_dense = false;
-        }
+        // Calculate alpha_m angle
+        const Eigen::Vector3f model_point_transformed = transform_mg * (*input_)[j].getVector3fMap ();
+        float angle = std::atan2 ( -model_point_transformed(2), model_point_transformed(1));
+        if (std::sin (angle) * model_point_transformed(2) < 0.0f)
+          angle *= (-1);
+        p.alpha_m = -angle;
       }
-      // Do not calculate the feature for identity pairs (i, i) as they are not used
-      // in the following computations
       else
       {
+        PCL_ERROR ("[pcl::%s::computeFeature] Computing pair feature vector between points %u and %u went wrong.\n", getClassName ().c_str (), i, j);
         p.f1 = p.f2 = p.f3 = p.f4 = p.alpha_m = std::numeric_limits<float>::quiet_NaN ();
-        output.is_dense = false;
+        is_dense = false;
       }
-
-      output[index_i*input_->size () + j] = p;
     }
+    // Do not calculate the feature for identity pairs (i, i) as they are not used
+    // in the following computations
+    else
+    {
+      p.f1 = p.f2 = p.f3 = p.f4 = p.alpha_m = std::numeric_limits<float>::quiet_NaN ();
+      is_dense = false;
+    }
+
+    output[index_i*input_->size () + j] = p;
   }
+  return (is_dense);
 }
 
 #define PCL_INSTANTIATE_PPFEstimation(T,NT,OutT) template class PCL_EXPORTS pcl::PPFEstimation<T,NT,OutT>;
@@ -0,0 +1,60 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved
+ */
+
+#ifndef PCL_FEATURES_IMPL_PPF_OMP_HPP_
+#define PCL_FEATURES_IMPL_PPF_OMP_HPP_
+
+#include <pcl/features/ppf_omp.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointNT, typename PointOutT> void
+pcl::PPFEstimationOMP<PointInT, PointNT, PointOutT>::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs ();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointNT, typename PointOutT> void
+pcl::PPFEstimationOMP<PointInT, PointNT, PointOutT>::computeFeature (PointCloudOut &output)
+{
+  // Initialize output container - overwrite the sizes done by Feature::initCompute ()
+  output.points.resize (indices_->size () * input_->size ());
+  output.height = 1;
+  output.width = output.size ();
+
+  bool is_dense = true;
+
+  // Every row of reference point is written by a single thread
+#pragma omp parallel for \
+  default(none) \
+  shared(output) \
+  reduction(&&:is_dense) \
+  num_threads(threads_) \
+  schedule(dynamic)
+  for (std::ptrdiff_t index_i = 0; index_i < static_cast<std::ptrdiff_t> (indices_->size ()); ++index_i)
+    if (!this->computeReferencePointFeatures (index_i, output))
+      is_dense = false;
+
+  output.is_dense = is_dense;
+}
+
+#define PCL_INSTANTIATE_PPFEstimationOMP(T,NT,OutT) template class PCL_EXPORTS pcl::PPFEstimationOMP<T,NT,OutT>;
+
+#endif  // PCL_FEATURES_IMPL_PPF_OMP_HPP_
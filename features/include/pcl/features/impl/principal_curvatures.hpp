@@ -50,6 +50,16 @@ template <typename PointInT, typename PointNT, typename PointOutT> void
 pcl::PrincipalCurvaturesEstimation<PointInT, PointNT, PointOutT>::computePointPrincipalCurvatures (
       const pcl::PointCloud<PointNT> &normals, int p_idx, const std::vector<int> &indices,
       float &pcx, float &pcy, float &pcz, float &pc1, float &pc2)
+{
+  computePointPrincipalCurvatures (normals, p_idx, indices, projected_normals_, pcx, pcy, pcz, pc1, pc2);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointNT, typename PointOutT> void
+pcl::PrincipalCurvaturesEstimation<PointInT, PointNT, PointOutT>::computePointPrincipalCurvatures (
+      const pcl::PointCloud<PointNT> &normals, int p_idx, const std::vector<int> &indices,
+      ProjectedNormals &projected_normals,
+      float &pcx, float &pcy, float &pcz, float &pc1, float &pc2) const
 {
   EIGEN_ALIGN16 Eigen::Matrix3f I = Eigen::Matrix3f::Identity ();
   Eigen::Vector3f n_idx (normals[p_idx].normal[0], normals[p_idx].normal[1], normals[p_idx].normal[2]);
@@ -57,56 +67,57 @@ pcl::PrincipalCurvaturesEstimation<PointInT, PointNT, PointOutT>::computePointPr
 
   // Project normals into the tangent plane
   Eigen::Vector3f normal;
-  projected_normals_.resize (indices.size ());
-  xyz_centroid_.setZero ();
+  projected_normals.resize (indices.size ());
+  Eigen::Vector3f xyz_centroid = Eigen::Vector3f::Zero ();
   for (std::size_t idx = 0; idx < indices.size(); ++idx)
   {
     normal[0] = normals[indices[idx]].normal[0];
     normal[1] = normals[indices[idx]].normal[1];
     normal[2] = normals[indices[idx]].normal[2];
 
-    projected_normals_[idx] = M * normal;
-    xyz_centroid_ += projected_normals_[idx];
+    projected_normals[idx] = M * normal;
+    xyz_centroid += projected_normals[idx];
   }
 
   // Estimate the XYZ centroid
-  xyz_centroid_ /= static_cast<float> (indices.size ());
+  xyz_centroid /= static_cast<float> (indices.size ());
 
   // Initialize to 0
-  covariance_matrix_.setZero ();
+  EIGEN_ALIGN16 Eigen::Matrix3f covariance_matrix = Eigen::Matrix3f::Zero ();
 
   // For each point in the cloud
   for (std::size_t idx = 0; idx < indices.size (); ++idx)
   {
-    demean_ = projected_normals_[idx] - xyz_centroid_;
+    const Eigen::Vector3f demean = projected_normals[idx] - xyz_centroid;
 
-    double demean_xy = demean_[0] * demean_[1];
-    double demean_xz = demean_[0] * demean_[2];
-    double demean_yz = demean_[1] * demean_[2];
+    double demean_xy = demean[0] * demean[1];
+    double demean_xz = demean[0] * demean[2];
+    double demean_yz = demean[1] * demean[2];
 
-    covariance_matrix_(0, 0) += demean_[0] * demean_[0];
-    covariance_matrix_(0, 1) += static_cast<float> (demean_xy);
-    covariance_matrix_(0, 2) += static_cast<float> (demean_xz);
+    covariance_matrix(0, 0) += demean[0] * demean[0];
+    covariance_matrix(0, 1) += static_cast<float> (demean_xy);
+    covariance_matrix(0, 2) += static_cast<float> (demean_xz);
 
-    covariance_matrix_(1, 0) += static_cast<float> (demean_xy);
-    covariance_matrix_(1, 1) += demean_[1] * demean_[1];
-    covariance_matrix_(1, 2) += static_cast<float> (demean_yz);
+    covariance_matrix(1, 0) += static_cast<float> (demean_xy);
+    covariance_matrix(1, 1) += demean[1] * demean[1];
+    covariance_matrix(1, 2) += static_cast<float> (demean_yz);
 
-    covariance_matrix_(2, 0) += static_cast<float> (demean_xz);
-    covariance_matrix_(2, 1) += static_cast<float> (demean_yz);
-    covariance_matrix_(2, 2) += demean_[2] * demean_[2];
+    covariance_matrix(2, 0) += static_cast<float> (demean_xz);
+    covariance_matrix(2, 1) += static_cast<float> (demean_yz);
+    covariance_matrix(2, 2) += demean[2] * demean[2];
   }
 
   // Extract the eigenvalues and eigenvectors
-  pcl::eigen33 (covariance_matrix_, eigenvalues_);
-  pcl::computeCorrespondingEigenVector (covariance_matrix_, eigenvalues_ [2], eigenvector_);
+  Eigen::Vector3f eigenvalues, eigenvector;
+  pcl::eigen33 (covariance_matrix, eigenvalues);
+  pcl::computeCorrespondingEigenVector (covariance_matrix, eigenvalues [2], eigenvector);
 
-  pcx = eigenvector_ [0];
-  pcy = eigenvector_ [1];
-  pcz = eigenvector_ [2];
+  pcx = eigenvector [0];
+  pcy = eigenvector [1];
+  pcz = eigenvector [2];
   float indices_size = 1.0f / static_cast<float> (indices.size ());
-  pc1 = eigenvalues_ [2] * indices_size;
-  pc2 = eigenvalues_ [1] * indices_size;
+  pc1 = eigenvalues [2] * indices_size;
+  pc2 = eigenvalues [1] * indices_size;
 }
 
 
@@ -121,44 +132,24 @@ pcl::PrincipalCurvaturesEstimation<PointInT, PointNT, PointOutT>::computeFeature
 
   output.is_dense = true;
   // Save a few cycles by not checking every point for NaN/Inf values if the cloud is set to dense
-  if (input_->is_dense)
-  {
-    // Iterating over the entire index vector
-    for (std::size_t idx = 0; idx < indices_->size (); ++idx)
-    {
-      if (this->searchForNeighbors ((*indices_)[idx], search_parameter_, nn_indices, nn_dists) == 0)
-      {
-        output[idx].principal_curvature[0] = output[idx].principal_curvature[1] = output[idx].principal_curvature[2] =
-          output[idx].pc1 = output[idx].pc2 = std::numeric_limits<float>::quiet_NaN ();
-        output.is_dense = false;
-        continue;
-      }
-
-      // Estimate the principal curvatures at each patch
-      computePointPrincipalCurvatures (*normals_, (*indices_)[idx], nn_indices,
-                                       output[idx].principal_curvature[0], output[idx].principal_curvature[1], output[idx].principal_curvature[2],
-                                       output[idx].pc1, output[idx].pc2);
-    }
-  }
-  else
+  const bool check_finite = !input_->is_dense;
+
+  // Iterating over the entire index vector
+  for (std::size_t idx = 0; idx < indices_->size (); ++idx)
   {
-    // Iterating over the entire index vector
-    for (std::size_t idx = 0; idx < indices_->size (); ++idx)
+    if ((check_finite && !isFinite ((*input_)[(*indices_)[idx]])) ||
+        this->searchForNeighbors ((*indices_)[idx], search_parameter_, nn_indices, nn_dists) == 0)
     {
-      if (!isFinite ((*input_)[(*indices_)[idx]]) ||
-          this->searchForNeighbors ((*indices_)[idx], search_parameter_, nn_indices, nn_dists) == 0)
-      {
-        output[idx].principal_curvature[0] = output[idx].principal_curvature[1] = output[idx].principal_curvature[2] =
-          output[idx].pc1 = output[idx].pc2 = std::numeric_limits<float>::quiet_NaN ();
-        output.is_dense = false;
-        continue;
-      }
-
-      // Estimate the principal curvatures at each patch
-      computePointPrincipalCurvatures (*normals_, (*indices_)[idx], nn_indices,
-                                       output[idx].principal_curvature[0], output[idx].principal_curvature[1], output[idx].principal_curvature[2],
-                                       output[idx].pc1, output[idx].pc2);
+      output[idx].principal_curvature[0] = output[idx].principal_curvature[1] = output[idx].principal_curvature[2] =
+        output[idx].pc1 = output[idx].pc2 = std::numeric_limits<float>::quiet_NaN ();
+      output.is_dense = false;
+      continue;
     }
+
+    // Estimate the principal curvatures at each patch
+    computePointPrincipalCurvatures (*normals_, (*indices_)[idx], nn_indices, projected_normals_,
+                                     output[idx].principal_curvature[0], output[idx].principal_curvature[1], output[idx].principal_curvature[2],
+                                     output[idx].pc1, output[idx].pc2);
   }
 }
 
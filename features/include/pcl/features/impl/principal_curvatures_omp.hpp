@@ -0,0 +1,76 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved
+ */
+
+#ifndef PCL_FEATURES_IMPL_PRINCIPAL_CURVATURES_OMP_HPP_
+#define PCL_FEATURES_IMPL_PRINCIPAL_CURVATURES_OMP_HPP_
+
+#include <pcl/features/principal_curvatures_omp.h>
+#include <pcl/common/point_tests.h> // for pcl::isFinite
+#include <pcl/common/utils.h> // for getNumberOfThreads
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointNT, typename PointOutT> void
+pcl::PrincipalCurvaturesEstimationOMP<PointInT, PointNT, PointOutT>::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs ();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointNT, typename PointOutT> void
+pcl::PrincipalCurvaturesEstimationOMP<PointInT, PointNT, PointOutT>::computeFeature (PointCloudOut &output)
+{
+  // Allocate enough space to hold the results
+  // \note This resize is irrelevant for a radiusSearch ().
+  std::vector<int> nn_indices (k_);
+  std::vector<float> nn_dists (k_);
+  ProjectedNormals projected_normals;
+
+  output.is_dense = true;
+  // Save a few cycles by not checking every point for NaN/Inf values if the cloud is set to dense
+  const bool check_finite = !input_->is_dense;
+
+  // Iterating over the entire index vector
+#pragma omp parallel for \
+  default(none) \
+  shared(check_finite, output) \
+  firstprivate(nn_indices, nn_dists, projected_normals) \
+  num_threads(pcl::utils::getNumberOfThreads (threads_)) \
+  schedule(dynamic, 256)
+  for (std::ptrdiff_t idx = 0; idx < static_cast<std::ptrdiff_t> (indices_->size ()); ++idx)
+  {
+    if ((check_finite && !isFinite ((*input_)[(*indices_)[idx]])) ||
+        this->searchForNeighbors ((*indices_)[idx], search_parameter_, nn_indices, nn_dists) == 0)
+    {
+      output[idx].principal_curvature[0] = output[idx].principal_curvature[1] = output[idx].principal_curvature[2] =
+        output[idx].pc1 = output[idx].pc2 = std::numeric_limits<float>::quiet_NaN ();
+      output.is_dense = false;
+      continue;
+    }
+
+    // Estimate the principal curvatures at each patch
+    this->computePointPrincipalCurvatures (*normals_, (*indices_)[idx], nn_indices, projected_normals,
+                                           output[idx].principal_curvature[0], output[idx].principal_curvature[1], output[idx].principal_curvature[2],
+                                           output[idx].pc1, output[idx].pc2);
+  }
+}
+
+#define PCL_INSTANTIATE_PrincipalCurvaturesEstimationOMP(T,NT,OutT) template class PCL_EXPORTS pcl::PrincipalCurvaturesEstimationOMP<T,NT,OutT>;
+
+#endif  // PCL_FEATURES_IMPL_PRINCIPAL_CURVATURES_OMP_HPP_
@@ -48,7 +48,7 @@ template <typename PointInT, typename GradientT, typename PointOutT> void
 pcl::RIFTEstimation<PointInT, GradientT, PointOutT>::computeRIFT (
       const PointCloudIn &cloud, const PointCloudGradient &gradient, 
       int p_idx, float radius, const std::vector<int> &indices, 
-      const std::vector<float> &sqr_distances, Eigen::MatrixXf &rift_descriptor)
+      const std::vector<float> &sqr_distances, Eigen::MatrixXf &rift_descriptor) const
 {
   if (indices.empty ())
   {
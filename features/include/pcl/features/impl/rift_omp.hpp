@@ -0,0 +1,110 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved
+ */
+
+#ifndef PCL_FEATURES_IMPL_RIFT_OMP_HPP_
+#define PCL_FEATURES_IMPL_RIFT_OMP_HPP_
+
+#include <pcl/features/rift_omp.h>
+#include <pcl/common/utils.h> // for getNumberOfThreads
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename GradientT, typename PointOutT> void
+pcl::RIFTEstimationOMP<PointInT, GradientT, PointOutT>::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs ();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename GradientT, typename PointOutT> void
+pcl::RIFTEstimationOMP<PointInT, GradientT, PointOutT>::computeFeature (PointCloudOut &output)
+{
+  // Make sure a search radius is set
+  if (search_radius_ == 0.0)
+  {
+    PCL_ERROR ("[pcl::%s::computeFeature] The search radius must be set before computing the feature!\n",
+               getClassName ().c_str ());
+    output.width = output.height = 0;
+    output.points.clear ();
+    return;
+  }
+
+  // Make sure the RIFT descriptor has valid dimensions
+  if (nr_gradient_bins_ <= 0)
+  {
+    PCL_ERROR ("[pcl::%s::computeFeature] The number of gradient bins must be greater than zero!\n",
+               getClassName ().c_str ());
+    output.width = output.height = 0;
+    output.points.clear ();
+    return;
+  }
+  if (nr_distance_bins_ <= 0)
+  {
+    PCL_ERROR ("[pcl::%s::computeFeature] The number of distance bins must be greater than zero!\n",
+               getClassName ().c_str ());
+    output.width = output.height = 0;
+    output.points.clear ();
+    return;
+  }
+
+  // Check for valid input gradient
+  if (!gradient_)
+  {
+    PCL_ERROR ("[pcl::%s::computeFeature] No input gradient was given!\n", getClassName ().c_str ());
+    output.width = output.height = 0;
+    output.points.clear ();
+    return;
+  }
+  if (gradient_->size () != surface_->size ())
+  {
+    PCL_ERROR ("[pcl::%s::computeFeature] ", getClassName ().c_str ());
+    PCL_ERROR ("The number of points in the input dataset differs from the number of points in the gradient!\n");
+    output.width = output.height = 0;
+    output.points.clear ();
+    return;
+  }
+
+  // Per-thread descriptor and neighborhood
+  Eigen::MatrixXf rift_descriptor (nr_distance_bins_, nr_gradient_bins_);
+  std::vector<int> nn_indices;
+  std::vector<float> nn_dist_sqr;
+
+  // Iterating over the entire index vector
+#pragma omp parallel for \
+  default(none) \
+  shared(output) \
+  firstprivate(rift_descriptor, nn_indices, nn_dist_sqr) \
+  num_threads(pcl::utils::getNumberOfThreads (threads_)) \
+  schedule(dynamic, 256)
+  for (std::ptrdiff_t idx = 0; idx < static_cast<std::ptrdiff_t> (indices_->size ()); ++idx)
+  {
+    // Find neighbors within the search radius
+    tree_->radiusSearch ((*indices_)[idx], search_radius_, nn_indices, nn_dist_sqr);
+
+    // Compute the RIFT descriptor
+    this->computeRIFT (*surface_, *gradient_, (*indices_)[idx], static_cast<float> (search_radius_), nn_indices, nn_dist_sqr, rift_descriptor);
+
+    // Default layout is column major, copy elementwise
+    std::copy_n (rift_descriptor.data (), rift_descriptor.size (), output[idx].histogram);
+  }
+}
+
+#define PCL_INSTANTIATE_RIFTEstimationOMP(T,NT,OutT) template class PCL_EXPORTS pcl::RIFTEstimationOMP<T,NT,OutT>;
+
+#endif  // PCL_FEATURES_IMPL_RIFT_OMP_HPP_
@@ -42,7 +42,13 @@
 
 #include <pcl/features/rops_estimation.h>
 
+#include <algorithm>
 #include <array>
+#include <numeric>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointInT, typename PointOutT>
@@ -53,7 +59,9 @@ pcl::ROPSEstimation <PointInT, PointOutT>::ROPSEstimation () :
   sqr_support_radius_ (1.0f),
   step_ (22.5f),
   triangles_ (0),
-  triangles_of_the_point_ (0)
+  triangles_of_the_point_ (0),
+  triangles_offsets_ (0),
+  threads_ (1)
 {
 }
 
@@ -63,6 +71,7 @@ pcl::ROPSEstimation <PointInT, PointOutT>::~ROPSEstimation ()
 {
   triangles_.clear ();
   triangles_of_the_point_.clear ();
+  triangles_offsets_.clear ();
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -121,6 +130,7 @@ template <typename PointInT, typename PointOutT> void
 pcl::ROPSEstimation <PointInT, PointOutT>::setTriangles (const std::vector <pcl::Vertices>& triangles)
 {
   triangles_ = triangles;
+  triangles_offsets_.clear ();
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -130,6 +140,20 @@ pcl::ROPSEstimation <PointInT, PointOutT>::getTriangles (std::vector <pcl::Verti
   triangles = triangles_;
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointOutT> void
+pcl::ROPSEstimation <PointInT, PointOutT>::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs ();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointInT, typename PointOutT> void
 pcl::ROPSEstimation <PointInT, PointOutT>::computeFeature (PointCloudOut &output)
@@ -140,50 +164,61 @@ pcl::ROPSEstimation <PointInT, PointOutT>::computeFeature (PointCloudOut &output
     return;
   }
 
-  buildListOfPointsTriangles ();
+  // The lists of triangles are only built again when the triangles or the size of the surface change
+  if (triangles_offsets_.size () != surface_->size () + 1)
+    buildListOfPointsTriangles ();
 
   //feature size = number_of_rotations * number_of_axis_to_rotate_around * number_of_projections * number_of_central_moments
   unsigned int feature_size = number_of_rotations_ * 3 * 3 * 5;
-  const auto number_of_points = indices_->size ();
-  output.points.clear ();
-  output.points.reserve (number_of_points);
-
-  for (const auto& idx: *indices_)
+  std::size_t number_of_points = indices_->size ();
+  output.points.resize (number_of_points);
+
+  std::array<PointInT, 3> axes;
+  axes[0].x = 1.0f; axes[0].y = 0.0f; axes[0].z = 0.0f;
+  axes[1].x = 0.0f; axes[1].y = 1.0f; axes[1].z = 0.0f;
+  axes[2].x = 0.0f; axes[2].y = 0.0f; axes[2].z = 1.0f;
+
+  // Every point only reads the shared data, the local surfaces and the rotated clouds are owned by the iterations
+#pragma omp parallel for \
+  default(none) \
+  shared(axes, feature_size, number_of_points, output) \
+  num_threads(threads_) \
+  schedule(dynamic, 16)
+  for (std::ptrdiff_t i_point = 0; i_point < static_cast<std::ptrdiff_t> (number_of_points); ++i_point)
   {
-    std::set <unsigned int> local_triangles;
+    const PointInT& point = (*input_)[(*indices_)[i_point]];
+
+    std::vector <unsigned int> local_triangles;
     std::vector <int> local_points;
-    getLocalSurface ((*input_)[idx], local_triangles, local_points);
+    getLocalSurface (point, local_triangles, local_points);
 
     Eigen::Matrix3f lrf_matrix;
-    computeLRF ((*input_)[idx], local_triangles, lrf_matrix);
+    computeLRF (point, local_triangles, lrf_matrix);
 
     PointCloudIn transformed_cloud;
-    transformCloud ((*input_)[idx], lrf_matrix, local_points, transformed_cloud);
+    transformCloud (point, lrf_matrix, local_points, transformed_cloud);
 
-    std::array<PointInT, 3> axes;
-    axes[0].x = 1.0f; axes[0].y = 0.0f; axes[0].z = 0.0f;
-    axes[1].x = 0.0f; axes[1].y = 1.0f; axes[1].z = 0.0f;
-    axes[2].x = 0.0f; axes[2].y = 0.0f; axes[2].z = 1.0f;
     std::vector <float> feature;
+    feature.reserve (feature_size);
+    PointCloudIn rotated_cloud;
+    Eigen::MatrixXf distribution_matrix (number_of_bins_, number_of_bins_);
+    std::vector <float> moments;
     for (const auto &axis : axes)
     {
       float theta = step_;
       do
       {
         //rotate local surface and get bounding box
-        PointCloudIn rotated_cloud;
         Eigen::Vector3f min, max;
         rotateCloud (axis, theta, transformed_cloud, rotated_cloud, min, max);
 
         //for each projection (XY, XZ and YZ) compute distribution matrix and central moments
         for (unsigned int i_proj = 0; i_proj < 3; i_proj++)
         {
-          Eigen::MatrixXf distribution_matrix;
-          distribution_matrix.resize (number_of_bins_, number_of_bins_);
           getDistributionMatrix (i_proj, min, max, rotated_cloud, distribution_matrix);
 
           // TODO remove this needless copy due to API design
-          std::vector <float> moments;
+          moments.clear ();
           computeCentralMoments (distribution_matrix, moments);
 
           feature.insert (feature.end (), moments.begin (), moments.end ());
@@ -203,9 +238,8 @@ pcl::ROPSEstimation <PointInT, PointOutT>::computeFeature (PointCloudOut &output
     else
       invert_norm = 1.0f / norm;
 
-    output.points.emplace_back ();
     for (std::size_t i_dim = 0; i_dim < feature_size; i_dim++)
-      output.points.back().histogram[i_dim] = feature[i_dim] * invert_norm;
+      output[i_point].histogram[i_dim] = feature[i_dim] * invert_norm;
   }
 }
 
@@ -213,32 +247,43 @@ pcl::ROPSEstimation <PointInT, PointOutT>::computeFeature (PointCloudOut &output
 template <typename PointInT, typename PointOutT> void
 pcl::ROPSEstimation <PointInT, PointOutT>::buildListOfPointsTriangles ()
 {
-  triangles_of_the_point_.clear ();
-
-  std::vector <unsigned int> dummy;
-  dummy.reserve (100);
-  triangles_of_the_point_.resize (surface_->points. size (), dummy);
-
+  // The triangles of every point are stored contiguously, after the ones of the previous points
+  const std::size_t number_of_points = surface_->size ();
+  triangles_offsets_.assign (number_of_points + 1, 0);
+  for (const auto& triangle: triangles_)
+    for (const auto& vertex: triangle.vertices)
+      triangles_offsets_[vertex + 1]++;
+  for (std::size_t i_point = 0; i_point < number_of_points; i_point++)
+    triangles_offsets_[i_point + 1] += triangles_offsets_[i_point];
+
+  std::vector <std::size_t> next (triangles_offsets_.cbegin (), triangles_offsets_.cend () - 1);
+  triangles_of_the_point_.resize (triangles_offsets_.back ());
   for (std::size_t i_triangle = 0; i_triangle < triangles_.size (); i_triangle++)
     for (const auto& vertex: triangles_[i_triangle].vertices)
-      triangles_of_the_point_[vertex].push_back (i_triangle);
+      triangles_of_the_point_[next[vertex]++] = static_cast<unsigned int> (i_triangle);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointInT, typename PointOutT> void
-pcl::ROPSEstimation <PointInT, PointOutT>::getLocalSurface (const PointInT& point, std::set <unsigned int>& local_triangles, std::vector <int>& local_points) const
+pcl::ROPSEstimation <PointInT, PointOutT>::getLocalSurface (const PointInT& point, std::vector <unsigned int>& local_triangles, std::vector <int>& local_points) const
 {
   std::vector <float> distances;
   tree_->radiusSearch (point, support_radius_, local_points, distances);
 
+  local_triangles.clear ();
   for (const auto& pt: local_points)
-    local_triangles.insert (triangles_of_the_point_[pt].begin (),
-                            triangles_of_the_point_[pt].end ());
+    local_triangles.insert (local_triangles.end (),
+                            triangles_of_the_point_.cbegin () + triangles_offsets_[pt],
+                            triangles_of_the_point_.cbegin () + triangles_offsets_[pt + 1]);
+
+  // The triangles are visited in increasing order, every triangle once
+  std::sort (local_triangles.begin (), local_triangles.end ());
+  local_triangles.erase (std::unique (local_triangles.begin (), local_triangles.end ()), local_triangles.end ());
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointInT, typename PointOutT> void
-pcl::ROPSEstimation <PointInT, PointOutT>::computeLRF (const PointInT& point, const std::set <unsigned int>& local_triangles, Eigen::Matrix3f& lrf_matrix) const
+pcl::ROPSEstimation <PointInT, PointOutT>::computeLRF (const PointInT& point, const std::vector <unsigned int>& local_triangles, Eigen::Matrix3f& lrf_matrix) const
 {
   std::size_t number_of_triangles = local_triangles.size ();
 
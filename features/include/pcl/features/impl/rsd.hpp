@@ -150,30 +150,41 @@ pcl::computeRSD (const pcl::PointCloud<PointNT> &normals,
 		 const std::vector<int> &indices, const std::vector<float> &sqr_dists, double max_dist,
 		 int nr_subdiv, double plane_radius, PointOutT &radii, bool compute_histogram)
 {
-  // Check if the full histogram has to be saved or not
   Eigen::MatrixXf histogram;
-  if (compute_histogram)
-    histogram = Eigen::MatrixXf::Zero (nr_subdiv, nr_subdiv);
-  
+  std::vector<double> min_max_angle_by_dist;
+  computeRSD (normals, indices, sqr_dists, max_dist, nr_subdiv, plane_radius, radii,
+              min_max_angle_by_dist, compute_histogram ? &histogram : nullptr);
+  return histogram;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointNT, typename PointOutT> void
+pcl::computeRSD (const pcl::PointCloud<PointNT> &normals,
+                 const std::vector<int> &indices, const std::vector<float> &sqr_dists, double max_dist,
+                 int nr_subdiv, double plane_radius, PointOutT &radii,
+                 std::vector<double> &min_max_angle_by_dist, Eigen::MatrixXf *histogram)
+{
+  // Check if the full histogram has to be saved or not
+  if (histogram)
+    histogram->setZero (nr_subdiv, nr_subdiv);
+
   // Check if enough points are provided or not
   if (indices.size () < 2)
   {
     radii.r_max = 0;
     radii.r_min = 0;
-    return histogram;
+    return;
   }
-  
-  // Initialize minimum and maximum angle values in each distance bin
-  std::vector<std::vector<double> > min_max_angle_by_dist (nr_subdiv);
-  min_max_angle_by_dist[0].resize (2);
-  min_max_angle_by_dist[0][0] = min_max_angle_by_dist[0][1] = 0.0;
+
+  // Initialize minimum and maximum angle values in each distance bin, stored as (min, max) pairs
+  min_max_angle_by_dist.resize (2 * nr_subdiv);
+  min_max_angle_by_dist[0] = min_max_angle_by_dist[1] = 0.0;
   for (int di=1; di<nr_subdiv; di++)
   {
-    min_max_angle_by_dist[di].resize (2);
-    min_max_angle_by_dist[di][0] = +DBL_MAX;
-    min_max_angle_by_dist[di][1] = -DBL_MAX;
+    min_max_angle_by_dist[2 * di] = +DBL_MAX;
+    min_max_angle_by_dist[2 * di + 1] = -DBL_MAX;
   }
-  
+
   // Compute distance by normal angle distribution for points
   std::vector<int>::const_iterator i, begin (indices.begin()), end (indices.end());
   for (i = begin+1; i != end; ++i)
@@ -193,17 +204,17 @@ pcl::computeRSD (const pcl::PointCloud<PointNT> &normals,
     if (dist > max_dist)
       continue; /// \note: we neglect points that are outside the specified interval!
 
-    // compute bins and increase
-    int bin_d = static_cast<int> (std::floor (nr_subdiv * dist / max_dist));
-    if (compute_histogram)
+    // compute bins and increase, a point exactly at max_dist falls into the last bin
+    int bin_d = std::min (nr_subdiv-1, static_cast<int> (std::floor (nr_subdiv * dist / max_dist)));
+    if (histogram)
     {
       int bin_a = std::min (nr_subdiv-1, static_cast<int> (std::floor (nr_subdiv * angle / (M_PI/2))));
-      histogram(bin_a, bin_d)++;
+      (*histogram)(bin_a, bin_d)++;
     }
 
     // update min-max values for distance bins
-    if (min_max_angle_by_dist[bin_d][0] > angle) min_max_angle_by_dist[bin_d][0] = angle;
-    if (min_max_angle_by_dist[bin_d][1] < angle) min_max_angle_by_dist[bin_d][1] = angle;
+    if (min_max_angle_by_dist[2 * bin_d] > angle) min_max_angle_by_dist[2 * bin_d] = angle;
+    if (min_max_angle_by_dist[2 * bin_d + 1] < angle) min_max_angle_by_dist[2 * bin_d + 1] = angle;
   }
 
   // Estimate radius from min and max lines
@@ -212,10 +223,10 @@ pcl::computeRSD (const pcl::PointCloud<PointNT> &normals,
   for (int di=0; di<nr_subdiv; di++)
   {
     // combute the members of A'*A*r = A'*D
-    if (min_max_angle_by_dist[di][1] >= 0)
+    if (min_max_angle_by_dist[2 * di + 1] >= 0)
     {
-      double p_min = min_max_angle_by_dist[di][0];
-      double p_max = min_max_angle_by_dist[di][1];
+      double p_min = min_max_angle_by_dist[2 * di];
+      double p_max = min_max_angle_by_dist[2 * di + 1];
       double f = (di+0.5)*max_dist/nr_subdiv;
       Amint_Amin += p_min * p_min;
       Amint_d += p_min * f;
@@ -239,8 +250,6 @@ pcl::computeRSD (const pcl::PointCloud<PointNT> &normals,
     radii.r_max = min_radius;
     radii.r_min = max_radius;
   }
-  
-  return histogram;
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////
@@ -260,13 +269,14 @@ pcl::RSDEstimation<PointInT, PointNT, PointOutT>::computeFeature (PointCloudOut
   // \note resize is irrelevant for a radiusSearch ().
   std::vector<int> nn_indices;
   std::vector<float> nn_sqr_dists;
+  std::vector<double> min_max_angle_by_dist;
 
   // Check if the full histogram has to be saved or not
   if (save_histograms_)
   {
-    // Reserve space for the output histogram dataset
+    // Allocate the output histogram dataset
     histograms_.reset (new std::vector<Eigen::MatrixXf, Eigen::aligned_allocator<Eigen::MatrixXf> >);
-    histograms_->reserve (output.size ());
+    histograms_->resize (indices_->size ());
     
     // Iterating over the entire index vector
     for (std::size_t idx = 0; idx < indices_->size (); ++idx)
@@ -274,7 +284,8 @@ pcl::RSDEstimation<PointInT, PointNT, PointOutT>::computeFeature (PointCloudOut
       // Compute and store r_min and r_max in the output cloud
       this->searchForNeighbors ((*indices_)[idx], search_parameter_, nn_indices, nn_sqr_dists);
       //histograms_->push_back (computeRSD (*surface_, *normals_, nn_indices, search_radius_, nr_subdiv_, plane_radius_, output[idx], true));
-      histograms_->push_back (computeRSD (*normals_, nn_indices, nn_sqr_dists, search_radius_, nr_subdiv_, plane_radius_, output[idx], true));
+      computeRSD (*normals_, nn_indices, nn_sqr_dists, search_radius_, nr_subdiv_, plane_radius_, output[idx],
+                  min_max_angle_by_dist, &(*histograms_)[idx]);
     }
   }
   else
@@ -285,7 +296,8 @@ pcl::RSDEstimation<PointInT, PointNT, PointOutT>::computeFeature (PointCloudOut
       // Compute and store r_min and r_max in the output cloud
       this->searchForNeighbors ((*indices_)[idx], search_parameter_, nn_indices, nn_sqr_dists);
       //computeRSD (*surface_, *normals_, nn_indices, search_radius_, nr_subdiv_, plane_radius_, output[idx], false);
-      computeRSD (*normals_, nn_indices, nn_sqr_dists, search_radius_, nr_subdiv_, plane_radius_, output[idx], false);
+      computeRSD (*normals_, nn_indices, nn_sqr_dists, search_radius_, nr_subdiv_, plane_radius_, output[idx],
+                  min_max_angle_by_dist);
     }
   }
 }
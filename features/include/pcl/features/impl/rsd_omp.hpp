@@ -0,0 +1,82 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved
+ */
+
+#ifndef PCL_FEATURES_IMPL_RSD_OMP_HPP_
+#define PCL_FEATURES_IMPL_RSD_OMP_HPP_
+
+#include <pcl/features/rsd_omp.h>
+#include <pcl/common/utils.h> // for getNumberOfThreads
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointNT, typename PointOutT> void
+pcl::RSDEstimationOMP<PointInT, PointNT, PointOutT>::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs ();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointNT, typename PointOutT> void
+pcl::RSDEstimationOMP<PointInT, PointNT, PointOutT>::computeFeature (PointCloudOut &output)
+{
+  // Check if search_radius_ was set
+  if (search_radius_ < 0)
+  {
+    PCL_ERROR ("[pcl::%s::computeFeature] A search radius needs to be set!\n", getClassName ().c_str ());
+    output.width = output.height = 0;
+    output.points.clear ();
+    return;
+  }
+
+  const int nr_subdiv = this->getNrSubdivisions ();
+  const double plane_radius = this->getPlaneRadius ();
+
+  // Check if the full histogram has to be saved or not, each point writes its own entry
+  std::vector<Eigen::MatrixXf, Eigen::aligned_allocator<Eigen::MatrixXf> > *histograms = nullptr;
+  if (this->getSaveHistograms ())
+  {
+    histograms_.reset (new std::vector<Eigen::MatrixXf, Eigen::aligned_allocator<Eigen::MatrixXf> > (indices_->size ()));
+    histograms = histograms_.get ();
+  }
+
+  // List of indices and corresponding squared distances for a neighborhood, and the angle bounds by distance
+  // \note resize is irrelevant for a radiusSearch ().
+  std::vector<int> nn_indices;
+  std::vector<float> nn_sqr_dists;
+  std::vector<double> min_max_angle_by_dist;
+
+  // Iterating over the entire index vector
+#pragma omp parallel for \
+  default(none) \
+  shared(histograms, nr_subdiv, output, plane_radius) \
+  firstprivate(nn_indices, nn_sqr_dists, min_max_angle_by_dist) \
+  num_threads(pcl::utils::getNumberOfThreads (threads_)) \
+  schedule(dynamic, 256)
+  for (std::ptrdiff_t idx = 0; idx < static_cast<std::ptrdiff_t> (indices_->size ()); ++idx)
+  {
+    // Compute and store r_min and r_max in the output cloud
+    this->searchForNeighbors ((*indices_)[idx], search_parameter_, nn_indices, nn_sqr_dists);
+    computeRSD (*normals_, nn_indices, nn_sqr_dists, search_radius_, nr_subdiv, plane_radius, output[idx],
+                min_max_angle_by_dist, histograms ? &(*histograms)[idx] : nullptr);
+  }
+}
+
+#define PCL_INSTANTIATE_RSDEstimationOMP(T,NT,OutT) template class PCL_EXPORTS pcl::RSDEstimationOMP<T,NT,OutT>;
+
+#endif  // PCL_FEATURES_IMPL_RSD_OMP_HPP_
@@ -179,6 +179,10 @@ pcl::SHOTEstimationBase<PointInT, PointNT, PointOutT, PointRFT>::initCompute ()
   lrf_estimator->setIndices (indices_);
   if (!fake_surface_)
     lrf_estimator->setSearchSurface(surface_);
+  // The reference frames are computed from the cached neighborhoods when they cover the radius of the frames
+  const auto cache = this->getNeighborhoodCache ();
+  if (cache && cache->getRadiusSearch () > 0 && cache->covers (lrf_estimator->getRadiusSearch ()))
+    lrf_estimator->setNeighborhoodCache (cache);
 
   if (!FeatureWithLocalReferenceFrames<PointInT, PointRFT>::initLocalReferenceFrames (indices_->size (), lrf_estimator))
   {
@@ -43,6 +43,7 @@
 
 #include <pcl/common/point_tests.h> // for pcl::isFinite
 #include <pcl/common/time.h>
+#include <pcl/common/utils.h> // for getNumberOfThreads
 #include <pcl/features/shot_lrf_omp.h>
 
 
@@ -73,6 +74,10 @@ pcl::SHOTEstimationOMP<PointInT, PointNT, PointOutT, PointRFT>::initCompute ()
 
   if (!fake_surface_)
     lrf_estimator->setSearchSurface(surface_);
+  // The reference frames are computed from the cached neighborhoods when they cover the radius of the frames
+  const auto cache = this->getNeighborhoodCache ();
+  if (cache && cache->getRadiusSearch () > 0 && cache->covers (lrf_estimator->getRadiusSearch ()))
+    lrf_estimator->setNeighborhoodCache (cache);
 
   if (!FeatureWithLocalReferenceFrames<PointInT, PointRFT>::initLocalReferenceFrames (indices_->size (), lrf_estimator))
   {
@@ -111,6 +116,10 @@ pcl::SHOTColorEstimationOMP<PointInT, PointNT, PointOutT, PointRFT>::initCompute
 
   if (!fake_surface_)
     lrf_estimator->setSearchSurface(surface_);
+  // The reference frames are computed from the cached neighborhoods when they cover the radius of the frames
+  const auto cache = this->getNeighborhoodCache ();
+  if (cache && cache->getRadiusSearch () > 0 && cache->covers (lrf_estimator->getRadiusSearch ()))
+    lrf_estimator->setNeighborhoodCache (cache);
 
   if (!FeatureWithLocalReferenceFrames<PointInT, PointRFT>::initLocalReferenceFrames (indices_->size (), lrf_estimator))
   {
@@ -153,7 +162,7 @@ pcl::SHOTEstimationOMP<PointInT, PointNT, PointOutT, PointRFT>::computeFeature (
 #pragma omp parallel for \
   default(none) \
   shared(output) \
-  num_threads(threads_)
+  num_threads(pcl::utils::getNumberOfThreads (threads_))
   for (std::ptrdiff_t idx = 0; idx < static_cast<std::ptrdiff_t> (indices_->size ()); ++idx)
   {
 
@@ -240,7 +249,7 @@ pcl::SHOTColorEstimationOMP<PointInT, PointNT, PointOutT, PointRFT>::computeFeat
 #pragma omp parallel for \
   default(none) \
   shared(output) \
-  num_threads(threads_)
+  num_threads(pcl::utils::getNumberOfThreads (threads_))
   for (std::ptrdiff_t idx = 0; idx < static_cast<std::ptrdiff_t> (indices_->size ()); ++idx)
   {
     Eigen::VectorXf shot;
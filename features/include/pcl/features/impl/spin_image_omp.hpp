@@ -0,0 +1,80 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved
+ */
+
+#ifndef PCL_FEATURES_IMPL_SPIN_IMAGE_OMP_HPP_
+#define PCL_FEATURES_IMPL_SPIN_IMAGE_OMP_HPP_
+
+#include <pcl/features/spin_image_omp.h>
+
+#include <exception>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointNT, typename PointOutT> void
+pcl::SpinImageEstimationOMP<PointInT, PointNT, PointOutT>::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs ();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointNT, typename PointOutT> void
+pcl::SpinImageEstimationOMP<PointInT, PointNT, PointOutT>::computeFeature (PointCloudOut &output)
+{
+  // An exception cannot leave the parallel region, the first one is kept and thrown after it
+  std::exception_ptr error;
+
+#pragma omp parallel for \
+  default(none) \
+  shared(error, output) \
+  num_threads(threads_) \
+  schedule(dynamic, 64)
+  for (std::ptrdiff_t i_input = 0; i_input < static_cast<std::ptrdiff_t> (indices_->size ()); ++i_input)
+  {
+    Eigen::ArrayXXd res;
+    try
+    {
+      res = this->computeSiForPoint ((*indices_)[i_input]);
+    }
+    catch (...)
+    {
+#pragma omp critical
+      {
+        if (!error)
+          error = std::current_exception ();
+      }
+      continue;
+    }
+
+    // Copy into the resultant cloud
+    for (Eigen::Index iRow = 0; iRow < res.rows () ; iRow++)
+    {
+      for (Eigen::Index iCol = 0; iCol < res.cols () ; iCol++)
+      {
+        output[i_input].histogram[ iRow*res.cols () + iCol ] = static_cast<float> (res (iRow, iCol));
+      }
+    }
+  }
+
+  if (error)
+    std::rethrow_exception (error);
+}
+
+#define PCL_INSTANTIATE_SpinImageEstimationOMP(T,NT,OutT) template class PCL_EXPORTS pcl::SpinImageEstimationOMP<T,NT,OutT>;
+
+#endif    // PCL_FEATURES_IMPL_SPIN_IMAGE_OMP_HPP_
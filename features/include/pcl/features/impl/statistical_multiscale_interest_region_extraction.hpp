@@ -47,6 +47,8 @@
 #include <boost/graph/adjacency_list.hpp>
 #include <boost/graph/johnson_all_pairs_shortest.hpp>
 
+#include <algorithm>
+
 
 //////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT> void
@@ -202,6 +204,20 @@ pcl::StatisticalMultiscaleInterestRegionExtraction<PointT>::extractExtrema (std:
   std::vector<std::vector<bool> > is_min (scale_values_.size ()),
       is_max (scale_values_.size ());
 
+  // The geodesic neighborhood of every point is gathered once at the largest scale and sorted by distance, the
+  // neighborhood at a smaller scale is then one of its prefixes
+  float max_scale = *std::max_element (scale_values_.begin (), scale_values_.end ());
+  std::vector<std::vector<std::pair<float, int> > > neighborhoods (input_->size ());
+  for (std::size_t point_i = 0; point_i < input_->size (); ++point_i)
+  {
+    std::vector<int> nn_indices;
+    geodesicFixedRadiusSearch (point_i, max_scale, nn_indices);
+    neighborhoods[point_i].reserve (nn_indices.size ());
+    for (const int &nn_index : nn_indices)
+      neighborhoods[point_i].emplace_back (geodesic_distances_[point_i][nn_index], nn_index);
+    std::sort (neighborhoods[point_i].begin (), neighborhoods[point_i].end ());
+  }
+
   // for each point, check if it is a local extrema on each scale
   for (std::size_t scale_i = 0; scale_i < scale_values_.size (); ++scale_i)
   {
@@ -209,14 +225,16 @@ pcl::StatisticalMultiscaleInterestRegionExtraction<PointT>::extractExtrema (std:
         is_max_scale (input_->size ());
     for (std::size_t point_i = 0; point_i < input_->size (); ++point_i)
     {
-      std::vector<int> nn_indices;
-      geodesicFixedRadiusSearch (point_i, scale_values_[scale_i], nn_indices);
       bool is_max_point = true, is_min_point = true;
-      for (const int &nn_index : nn_indices)
-        if (F_scales_[scale_i][point_i] < F_scales_[scale_i][nn_index])
+      for (const auto &neighbor : neighborhoods[point_i])
+      {
+        if (neighbor.first >= scale_values_[scale_i])
+          break;
+        if (F_scales_[scale_i][point_i] < F_scales_[scale_i][neighbor.second])
           is_max_point = false;
         else
           is_min_point = false;
+      }
 
       is_min_scale[point_i] = is_min_point;
       is_max_scale[point_i] = is_max_point;
@@ -238,9 +256,12 @@ pcl::StatisticalMultiscaleInterestRegionExtraction<PointT>::extractExtrema (std:
         region->push_back (static_cast<int> (point_i));
 
         // and also add its scale-sized geodesic neighborhood
-        std::vector<int> nn_indices;
-        geodesicFixedRadiusSearch (point_i, scale_values_[scale_i], nn_indices);
-        region->insert (region->end (), nn_indices.begin (), nn_indices.end ());
+        for (const auto &neighbor : neighborhoods[point_i])
+        {
+          if (neighbor.first >= scale_values_[scale_i])
+            break;
+          region->push_back (neighbor.second);
+        }
         rois.push_back (region);
       }
   }
@@ -72,6 +72,13 @@ pcl::UniqueShapeContext<PointInT, PointOutT, PointRFT>::initCompute ()
     return (false);
   }
 
+  return (initIntervals ());
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointOutT, typename PointRFT> bool
+pcl::UniqueShapeContext<PointInT, PointOutT, PointRFT>::initIntervals ()
+{
   if (search_radius_< min_radius_)
   {
     PCL_ERROR ("[pcl::%s::initCompute] search_radius_ must be GREATER than min_radius_.\n", getClassName ().c_str ());
@@ -142,7 +149,7 @@ pcl::UniqueShapeContext<PointInT, PointOutT, PointRFT>::initCompute ()
 
 //////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointInT, typename PointOutT, typename PointRFT> void
-pcl::UniqueShapeContext<PointInT, PointOutT, PointRFT>::computePointDescriptor (std::size_t index, /*float rf[9],*/ std::vector<float> &desc)
+pcl::UniqueShapeContext<PointInT, PointOutT, PointRFT>::computePointDescriptor (std::size_t index, /*float rf[9],*/ std::vector<float> &desc) const
 {
   pcl::Vector3fMapConst origin = (*input_)[(*indices_)[index]].getVector3fMap ();
 
@@ -0,0 +1,107 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved
+ */
+
+#ifndef PCL_FEATURES_IMPL_USC_OMP_HPP_
+#define PCL_FEATURES_IMPL_USC_OMP_HPP_
+
+#include <pcl/features/usc_omp.h>
+#include <pcl/features/shot_lrf_omp.h>
+#include <pcl/common/point_tests.h> // for pcl::isFinite
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointOutT, typename PointRFT> void
+pcl::UniqueShapeContextOMP<PointInT, PointOutT, PointRFT>::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs ();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointOutT, typename PointRFT> bool
+pcl::UniqueShapeContextOMP<PointInT, PointOutT, PointRFT>::initCompute ()
+{
+  if (!Feature<PointInT, PointOutT>::initCompute ())
+  {
+    PCL_ERROR ("[pcl::%s::initCompute] Init failed.\n", getClassName ().c_str ());
+    return (false);
+  }
+
+  // Default LRF estimation alg: SHOTLocalReferenceFrameEstimationOMP
+  typename SHOTLocalReferenceFrameEstimationOMP<PointInT, PointRFT>::Ptr lrf_estimator(new SHOTLocalReferenceFrameEstimationOMP<PointInT, PointRFT>());
+  lrf_estimator->setRadiusSearch (local_radius_);
+  lrf_estimator->setInputCloud (input_);
+  lrf_estimator->setIndices (indices_);
+  lrf_estimator->setNumberOfThreads (threads_);
+  if (!fake_surface_)
+    lrf_estimator->setSearchSurface(surface_);
+
+  if (!FeatureWithLocalReferenceFrames<PointInT, PointRFT>::initLocalReferenceFrames (indices_->size (), lrf_estimator))
+  {
+    PCL_ERROR ("[pcl::%s::initCompute] Init failed.\n", getClassName ().c_str ());
+    return (false);
+  }
+
+  return (this->initIntervals ());
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointOutT, typename PointRFT> void
+pcl::UniqueShapeContextOMP<PointInT, PointOutT, PointRFT>::computeFeature (PointCloudOut &output)
+{
+  assert (descriptor_length_ == 1960);
+
+  output.is_dense = true;
+
+#pragma omp parallel for \
+  default(none) \
+  shared(output) \
+  num_threads(threads_) \
+  schedule(dynamic, 64)
+  for (std::ptrdiff_t point_index = 0; point_index < static_cast<std::ptrdiff_t> (indices_->size ()); ++point_index)
+  {
+    // If the point is not finite, set the descriptor to NaN and continue
+    const PointRFT& current_frame = (*frames_)[point_index];
+    if (!isFinite ((*input_)[(*indices_)[point_index]]) ||
+        !std::isfinite (current_frame.x_axis[0]) ||
+        !std::isfinite (current_frame.y_axis[0]) ||
+        !std::isfinite (current_frame.z_axis[0])  )
+    {
+      std::fill (output[point_index].descriptor, output[point_index].descriptor + descriptor_length_,
+                 std::numeric_limits<float>::quiet_NaN ());
+      std::fill (output[point_index].rf, output[point_index].rf + 9, 0);
+      output.is_dense = false;
+      continue;
+    }
+
+    for (int d = 0; d < 3; ++d)
+    {
+      output[point_index].rf[0 + d] = current_frame.x_axis[d];
+      output[point_index].rf[3 + d] = current_frame.y_axis[d];
+      output[point_index].rf[6 + d] = current_frame.z_axis[d];
+    }
+
+    std::vector<float> descriptor (descriptor_length_);
+    this->computePointDescriptor (point_index, descriptor);
+    std::copy (descriptor.begin (), descriptor.end (), output[point_index].descriptor);
+  }
+}
+
+#define PCL_INSTANTIATE_UniqueShapeContextOMP(T,OutT,RFT) template class PCL_EXPORTS pcl::UniqueShapeContextOMP<T,OutT,RFT>;
+
+#endif  // PCL_FEATURES_IMPL_USC_OMP_HPP_
@@ -123,7 +123,8 @@ namespace pcl
         second_order_integral_image_ (),
         width_ (1), 
         height_ (1), 
-        compute_second_order_integral_images_ (compute_second_order_integral_images)
+        compute_second_order_integral_images_ (compute_second_order_integral_images),
+        threads_ (1)
       {
       }
 
@@ -137,6 +138,12 @@ namespace pcl
       void 
       setSecondOrderComputation (bool compute_second_order_integral_images);
 
+      /** \brief Initialize the scheduler and set the number of threads to use to compute the integral images.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      void
+      setNumberOfThreads (unsigned int nr_threads = 0);
+
       /** \brief Set the input data to compute the integral image for
         * \param[in] data the input data
         * \param[in] width the width of the data
@@ -205,7 +212,9 @@ namespace pcl
     private:
       using InputType = Eigen::Matrix<typename IntegralImageTypeTraits<DataType>::Type, Dimension, 1>;
 
-      /** \brief Compute the actual integral image data
+      /** \brief Compute the actual integral image data. With several threads, the prefix sums of the rows are
+        * computed first (in parallel over the rows) and then the sums of the rows above (in parallel over the
+        * columns), which gives the same sums as a single thread
         * \param[in] data the input data
         * \param[in] element_stride the element stride of the data
         * \param[in] row_stride the row stride of the data
@@ -213,6 +222,22 @@ namespace pcl
       void
       computeIntegralImages (const DataType * data, unsigned row_stride, unsigned element_stride);
 
+      /** \brief Compute the prefix sums of a row of the input data, in the integral images of a single row
+        * \param[in] row_data the input data of the row
+        * \param[in] row the index of the row in the integral images (the index in the input data plus one)
+        * \param[in] element_stride the element stride of the data
+        */
+      void
+      computeRowSums (const DataType * row_data, std::size_t row, unsigned element_stride);
+
+      /** \brief Add the integral images of the previous row to the ones of a row, between two columns
+        * \param[in] row the index of the row in the integral images
+        * \param[in] begin the first column
+        * \param[in] end the column after the last one
+        */
+      void
+      addPreviousRow (std::size_t row, std::size_t begin, std::size_t end);
+
       std::vector<ElementType, Eigen::aligned_allocator<ElementType> > first_order_integral_image_;
       std::vector<SecondOrderType, Eigen::aligned_allocator<SecondOrderType> > second_order_integral_image_;
       std::vector<unsigned> finite_values_integral_image_;
@@ -224,6 +249,9 @@ namespace pcl
 
       /** \brief Indicates whether second order integral images are available **/
       bool compute_second_order_integral_images_;
+
+      /** \brief The number of threads the scheduler should use. */
+      unsigned int threads_;
    };
 
    /**
@@ -248,7 +276,8 @@ namespace pcl
         second_order_integral_image_ (),
         
         width_ (1), height_ (1), 
-        compute_second_order_integral_images_ (compute_second_order_integral_images)
+        compute_second_order_integral_images_ (compute_second_order_integral_images),
+        threads_ (1)
       {
       }
 
@@ -256,6 +285,12 @@ namespace pcl
       virtual
       ~IntegralImage2D () { }
 
+      /** \brief Initialize the scheduler and set the number of threads to use to compute the integral images.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      void
+      setNumberOfThreads (unsigned int nr_threads = 0);
+
       /** \brief Set the input data to compute the integral image for
         * \param[in] data the input data
         * \param[in] width the width of the data
@@ -324,7 +359,9 @@ namespace pcl
   private:
     //  using InputType = typename IntegralImageTypeTraits<DataType>::Type;
 
-      /** \brief Compute the actual integral image data
+      /** \brief Compute the actual integral image data. With several threads, the prefix sums of the rows are
+        * computed first (in parallel over the rows) and then the sums of the rows above (in parallel over the
+        * columns), which gives the same sums as a single thread
         * \param[in] data the input data
         * \param[in] element_stride the element stride of the data
         * \param[in] row_stride the row stride of the data
@@ -332,6 +369,22 @@ namespace pcl
       void
       computeIntegralImages (const DataType * data, unsigned row_stride, unsigned element_stride);
 
+      /** \brief Compute the prefix sums of a row of the input data, in the integral images of a single row
+        * \param[in] row_data the input data of the row
+        * \param[in] row the index of the row in the integral images (the index in the input data plus one)
+        * \param[in] element_stride the element stride of the data
+        */
+      void
+      computeRowSums (const DataType * row_data, std::size_t row, unsigned element_stride);
+
+      /** \brief Add the integral images of the previous row to the ones of a row, between two columns
+        * \param[in] row the index of the row in the integral images
+        * \param[in] begin the first column
+        * \param[in] end the column after the last one
+        */
+      void
+      addPreviousRow (std::size_t row, std::size_t begin, std::size_t end);
+
       std::vector<ElementType, Eigen::aligned_allocator<ElementType> > first_order_integral_image_;
       std::vector<SecondOrderType, Eigen::aligned_allocator<SecondOrderType> > second_order_integral_image_;
       std::vector<unsigned> finite_values_integral_image_;
@@ -343,6 +396,9 @@ namespace pcl
 
       /** \brief Indicates whether second order integral images are available **/
       bool compute_second_order_integral_images_;
+
+      /** \brief The number of threads the scheduler should use. */
+      unsigned int threads_;
    };
  }
 
@@ -130,6 +130,7 @@ namespace pcl
         , vpy_ (0.0f)
         , vpz_ (0.0f)
         , use_sensor_origin_ (true)
+        , threads_ (1)
       {
         feature_name_ = "IntegralImagesNormalEstimation";
         tree_.reset ();
@@ -146,6 +147,15 @@ namespace pcl
       void
       setRectSize (const int width, const int height);
 
+      /** \brief Initialize the scheduler and set the number of threads to use to compute the integral images and
+        * the normals.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        * \note The integral images are computed by \ref setInputCloud, call this method before it for them to be
+        * computed in parallel as well.
+        */
+      void
+      setNumberOfThreads (unsigned int nr_threads = 0);
+
       /** \brief Sets the policy for handling borders.
         * \param[in] border_policy the border policy.
         */
@@ -355,7 +365,7 @@ namespace pcl
       inline void
       flipNormalTowardsViewpoint (const PointInT &point, 
                                   float vp_x, float vp_y, float vp_z,
-                                  float &nx, float &ny, float &nz)
+                                  float &nx, float &ny, float &nz) const
       {
         // See if we need to flip any plane normals
         vp_x -= point.x;
@@ -444,6 +454,39 @@ namespace pcl
 
       /** whether the sensor origin of the input cloud or a user given viewpoint should be used.*/
       bool use_sensor_origin_;
+
+      /** \brief The number of threads the scheduler should use. */
+      unsigned int threads_;
+
+      /** \brief Computes the normal at the specified position, with a given size of the neighborhood region. The
+        * data of the normal estimation method has to be initialized.
+        * \param[in] pos_x x position (pixel)
+        * \param[in] pos_y y position (pixel)
+        * \param[in] point_index the position index of the point
+        * \param[in] rect_width the width of the neighborhood region
+        * \param[in] rect_height the height of the neighborhood region
+        * \param[out] normal the output estimated normal
+        */
+      void
+      computePointNormal (const int pos_x, const int pos_y, const unsigned point_index,
+                          const int rect_width, const int rect_height, PointOutT &normal) const;
+
+      /** \brief Computes the normal at the specified position with mirroring for border handling, with a given size
+        * of the neighborhood region. The data of the normal estimation method has to be initialized.
+        * \param[in] pos_x x position (pixel)
+        * \param[in] pos_y y position (pixel)
+        * \param[in] point_index the position index of the point
+        * \param[in] rect_width the width of the neighborhood region
+        * \param[in] rect_height the height of the neighborhood region
+        * \param[out] normal the output estimated normal
+        */
+      void
+      computePointNormalMirror (const int pos_x, const int pos_y, const unsigned point_index,
+                                const int rect_width, const int rect_height, PointOutT &normal) const;
+
+      /** \brief Initialize the data of the normal estimation method, if it was not yet. */
+      void
+      initNormalEstimationMethod ();
       
       /** \brief This method should get called before starting the actual computation. */
       bool
@@ -94,7 +94,7 @@ namespace pcl
                                  float radius, float sigma, int k, 
                                  const std::vector<int> &indices, 
                                  const std::vector<float> &squared_distances, 
-                                 Eigen::MatrixXf &intensity_spin_image);
+                                 Eigen::MatrixXf &intensity_spin_image) const;
 
       /** \brief Set the number of bins to use in the distance dimension of the spin image
         * \param[in] nr_distance_bins the number of bins to use in the distance dimension of the spin image
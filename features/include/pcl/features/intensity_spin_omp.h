@@ -0,0 +1,71 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved
+ */
+
+#pragma once
+
+#include <pcl/features/intensity_spin.h>
+
+namespace pcl
+{
+  /** \brief IntensitySpinEstimationOMP estimates the intensity-domain spin image descriptors of
+    * \ref IntensitySpinEstimation, in parallel, using the OpenMP standard.
+    *
+    * Each thread reuses its own neighborhood buffers and spin image, and the results are the same as the ones of
+    * the serial estimation.
+    * \ingroup features
+    */
+  template <typename PointInT, typename PointOutT>
+  class IntensitySpinEstimationOMP : public IntensitySpinEstimation<PointInT, PointOutT>
+  {
+    public:
+      using Ptr = shared_ptr<IntensitySpinEstimationOMP<PointInT, PointOutT> >;
+      using ConstPtr = shared_ptr<const IntensitySpinEstimationOMP<PointInT, PointOutT> >;
+      using Feature<PointInT, PointOutT>::feature_name_;
+      using Feature<PointInT, PointOutT>::getClassName;
+      using Feature<PointInT, PointOutT>::indices_;
+      using Feature<PointInT, PointOutT>::surface_;
+      using Feature<PointInT, PointOutT>::tree_;
+      using Feature<PointInT, PointOutT>::search_radius_;
+      using IntensitySpinEstimation<PointInT, PointOutT>::nr_distance_bins_;
+      using IntensitySpinEstimation<PointInT, PointOutT>::nr_intensity_bins_;
+      using IntensitySpinEstimation<PointInT, PointOutT>::sigma_;
+      using PointCloudOut = typename Feature<PointInT, PointOutT>::PointCloudOut;
+
+      /** \brief Initialize the scheduler and set the number of threads to use.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      IntensitySpinEstimationOMP (unsigned int nr_threads = 0)
+      {
+        feature_name_ = "IntensitySpinEstimationOMP";
+
+        setNumberOfThreads (nr_threads);
+      }
+
+      /** \brief Initialize the scheduler and set the number of threads to use.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      void
+      setNumberOfThreads (unsigned int nr_threads = 0);
+
+    protected:
+      /** \brief Estimate the intensity-domain descriptors at a set of points given by <setInputCloud (), setIndices ()>
+        *  using the surface in setSearchSurface (), and the spatial locator in setSearchMethod ().
+        *  \param[out] output the resultant point cloud model dataset that contains the intensity-domain spin image features
+        */
+      void
+      computeFeature (PointCloudOut &output) override;
+
+      /** \brief The number of threads the scheduler should use. */
+      unsigned int threads_;
+  };
+}
+
+#ifdef PCL_NO_PRECOMPILE
+#include <pcl/features/impl/intensity_spin_omp.hpp>
+#endif
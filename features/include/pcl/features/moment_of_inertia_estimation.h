@@ -129,6 +129,13 @@ namespace pcl
       void
       setNormalizePointMassFlag (bool need_to_normalize);
 
+      /** \brief Initialize the scheduler and set the number of threads to use for the moments of inertia and the
+        * eccentricities of the rotated axes.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      void
+      setNumberOfThreads (unsigned int nr_threads = 0);
+
       /** \brief Returns the normalize_ flag. */
       bool
       getNormalizePointMassFlag () const;
@@ -261,7 +268,7 @@ namespace pcl
       void
       computeEigenVectors (const Eigen::Matrix <float, 3, 3>& covariance_matrix, Eigen::Vector3f& major_axis,
                            Eigen::Vector3f& middle_axis, Eigen::Vector3f& minor_axis, float& major_value, float& middle_value,
-                           float& minor_value);
+                           float& minor_value) const;
 
       /** \brief This method returns the moment of inertia of a given input_ cloud.
         * Note that when moment of inertia is computed it is multiplied by the point mass.
@@ -286,7 +293,7 @@ namespace pcl
         * \param[in] normal_vector normal vector of the plane, it is used to discard the
         *            third eigen vector and eigen value*/
       float
-      computeEccentricity (const Eigen::Matrix <float, 3, 3>& covariance_matrix, const Eigen::Vector3f& normal_vector);
+      computeEccentricity (const Eigen::Matrix <float, 3, 3>& covariance_matrix, const Eigen::Vector3f& normal_vector) const;
 
     private:
 
@@ -303,6 +310,9 @@ namespace pcl
       /** \brief Stores the flag for mass normalization */
       bool normalize_;
 
+      /** \brief The number of threads the scheduler should use. */
+      unsigned int threads_;
+
       /** \brief Stores the mean value (center of mass) of the cloud */
       Eigen::Vector3f mean_value_;
 
@@ -78,7 +78,10 @@ namespace pcl
       /** \brief Empty destructor */
       ~MultiscaleFeaturePersistence () {}
 
-      /** \brief Method that calls computeFeatureAtScale () for each scale parameter */
+      /** \brief Method that calls computeFeatureAtScale () for each scale parameter
+       * \note Unless the feature estimator was given a NeighborhoodCache, the neighborhoods are searched once at the
+       * largest scale (in parallel) and the feature estimator reads the neighborhoods of all the scales from them.
+       */
       void
       computeFeaturesAtAllScales ();
 
@@ -0,0 +1,99 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved
+ */
+
+#pragma once
+
+#include <pcl/features/normal_3d_omp.h>
+
+#include <vector>
+
+namespace pcl
+{
+  /** \brief MultiscaleNormalEstimation estimates the surface normals and curvatures of the points at several
+    * search radii (scales) at once.
+    *
+    * Estimating the normals at each scale with its own NormalEstimationOMP searches the neighborhoods once per
+    * scale. MultiscaleNormalEstimation searches the neighborhood of each point once, at the largest scale, and
+    * derives the neighborhoods of the smaller scales from it by distance. The normals of every scale are the ones
+    * NormalEstimation gives with the same radius. This is what DifferenceOfNormalsEstimation needs:
+    * \code
+    * pcl::MultiscaleNormalEstimation<pcl::PointXYZ, pcl::PointNormal> ne;
+    * ne.setInputCloud (cloud);
+    * ne.setSearchMethod (tree);
+    * ne.setViewPoint (std::numeric_limits<float>::max (), std::numeric_limits<float>::max (), std::numeric_limits<float>::max ());
+    * ne.setScales ({scale_small, scale_large});
+    * std::vector<pcl::PointCloud<pcl::PointNormal>::Ptr> normals;
+    * ne.computeAtScales (normals);
+    * don.setNormalScaleSmall (normals[0]);
+    * don.setNormalScaleLarge (normals[1]);
+    * \endcode
+    *
+    * compute () estimates the normals at the single radius given by setRadiusSearch () or setKSearch (), as
+    * NormalEstimationOMP does.
+    * \ingroup features
+    */
+  template <typename PointInT, typename PointOutT>
+  class MultiscaleNormalEstimation: public NormalEstimationOMP<PointInT, PointOutT>
+  {
+    public:
+      using Ptr = shared_ptr<MultiscaleNormalEstimation<PointInT, PointOutT> >;
+      using ConstPtr = shared_ptr<const MultiscaleNormalEstimation<PointInT, PointOutT> >;
+      using NormalEstimationOMP<PointInT, PointOutT>::feature_name_;
+      using NormalEstimationOMP<PointInT, PointOutT>::getClassName;
+      using NormalEstimationOMP<PointInT, PointOutT>::indices_;
+      using NormalEstimationOMP<PointInT, PointOutT>::input_;
+      using NormalEstimationOMP<PointInT, PointOutT>::k_;
+      using NormalEstimationOMP<PointInT, PointOutT>::search_radius_;
+      using NormalEstimationOMP<PointInT, PointOutT>::search_parameter_;
+      using NormalEstimationOMP<PointInT, PointOutT>::threads_;
+
+      using PointCloudOut = typename NormalEstimationOMP<PointInT, PointOutT>::PointCloudOut;
+      using PointCloudOutPtr = typename PointCloudOut::Ptr;
+
+      /** \brief Initialize the scheduler and set the number of threads to use.
+        * \param nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      MultiscaleNormalEstimation (unsigned int nr_threads = 0) :
+        NormalEstimationOMP<PointInT, PointOutT> (nr_threads)
+      {
+        feature_name_ = "MultiscaleNormalEstimation";
+      }
+
+      /** \brief Set the search radii at which the normals are estimated by computeAtScales ().
+        * \param[in] scales the search radii, in any order
+        */
+      inline void
+      setScales (const std::vector<double> &scales) { scales_ = scales; }
+
+      /** \brief Get the search radii at which the normals are estimated. */
+      inline const std::vector<double>&
+      getScales () const
+      {
+        return (scales_);
+      }
+
+      /** \brief Estimate the normals at all the scales, for all points given in <setInputCloud (), setIndices ()>
+        * using the surface in setSearchSurface () and the spatial locator in setSearchMethod ().
+        * \param[out] outputs one normal cloud per scale, in the order of setScales (), empty if the estimation
+        * could not be initialized
+        * \note The radius and the number of neighbors given with setRadiusSearch () and setKSearch () are ignored. A
+        * NeighborhoodCache given with setNeighborhoodCache () is used if it covers the largest scale.
+        */
+      void
+      computeAtScales (std::vector<PointCloudOutPtr> &outputs);
+
+    protected:
+      /** \brief The search radii of computeAtScales (). */
+      std::vector<double> scales_;
+  };
+}
+
+#ifdef PCL_NO_PRECOMPILE
+#include <pcl/features/impl/multiscale_normal_3d.hpp>
+#endif
@@ -0,0 +1,238 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved
+ */
+
+#pragma once
+
+#include <pcl/memory.h>
+#include <pcl/pcl_base.h>
+#include <pcl/pcl_macros.h>
+#include <pcl/search/search.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace pcl
+{
+  /** \brief NeighborhoodCache searches the neighbors of a set of points once, and serves them to any number of
+    * features computed afterwards on the same points.
+    *
+    * A descriptor pipeline (e.g. normals, then FPFH, then SHOT) usually searches the same neighborhoods once per
+    * feature. The cache runs the searches in parallel and stores their results in a compressed sparse row layout:
+    * the neighbors of all the points are kept in a single array, and the neighbors of the i-th cached point are
+    * found between two consecutive offsets. A feature given the cache with \ref Feature::setNeighborhoodCache
+    * reads its neighborhoods from it, when the search parameters are compatible:
+    *   - a radius search with a radius not larger than the cached one is served by the cached neighbors closer
+    *     than the radius,
+    *   - a k nearest neighbors search with a k not larger than the cached one is served by the first neighbors
+    *     of the cached ones, which are sorted by distance.
+    *
+    * Other queries (points which are not cached, another query cloud, an incompatible parameter) are forwarded to
+    * the search method of the feature.
+    *
+    * \code
+    * pcl::NeighborhoodCache<pcl::PointXYZ>::Ptr cache (new pcl::NeighborhoodCache<pcl::PointXYZ>);
+    * cache->setInputCloud (cloud);
+    * cache->setRadiusSearch (0.03);
+    * cache->compute ();
+    * normal_estimation.setNeighborhoodCache (cache);  // any radius up to 0.03
+    * fpfh_estimation.setNeighborhoodCache (cache);
+    * \endcode
+    *
+    * \note The cache holds the neighbors of the points at the time of \ref compute, it has to be computed again
+    * when the clouds change.
+    * \ingroup features
+    */
+  template <typename PointT>
+  class NeighborhoodCache : public PCLBase<PointT>
+  {
+    public:
+      using Ptr = shared_ptr<NeighborhoodCache<PointT> >;
+      using ConstPtr = shared_ptr<const NeighborhoodCache<PointT> >;
+
+      using PointCloud = pcl::PointCloud<PointT>;
+      using PointCloudConstPtr = typename PointCloud::ConstPtr;
+
+      using KdTree = pcl::search::Search<PointT>;
+      using KdTreePtr = typename KdTree::Ptr;
+
+      using PCLBase<PointT>::input_;
+      using PCLBase<PointT>::indices_;
+
+      /** \brief Empty constructor. */
+      NeighborhoodCache () :
+        surface_ (), tree_ (), search_radius_ (0), k_ (0), threads_ (1), rows_ (), offsets_ (), neighbors_ (),
+        sqr_distances_ ()
+      {}
+
+      /** \brief Provide a pointer to the dataset in which the neighbors are searched, the input cloud is used if
+        * none is given.
+        * \param[in] cloud a pointer to the surface point cloud
+        */
+      inline void
+      setSearchSurface (const PointCloudConstPtr &cloud) { surface_ = cloud; }
+
+      /** \brief Get a pointer to the surface point cloud dataset, the input cloud when no surface was given. */
+      inline PointCloudConstPtr
+      getSearchSurface () const
+      {
+        return (surface_ ? surface_ : input_);
+      }
+
+      /** \brief Provide a pointer to the search object, created as in Feature when none is given.
+        * \param[in] tree a pointer to the spatial search object
+        */
+      inline void
+      setSearchMethod (const KdTreePtr &tree) { tree_ = tree; }
+
+      /** \brief Get a pointer to the search method used. */
+      inline KdTreePtr
+      getSearchMethod () const
+      {
+        return (tree_);
+      }
+
+      /** \brief Set the number of k nearest neighbors to store for each point.
+        * \param[in] k the number of k-nearest neighbors
+        */
+      inline void
+      setKSearch (int k) { k_ = k; }
+
+      /** \brief Get the number of k nearest neighbors stored for each point. */
+      inline int
+      getKSearch () const
+      {
+        return (k_);
+      }
+
+      /** \brief Set the sphere radius in which the neighbors of each point are stored.
+        * \param[in] radius the sphere radius used as the maximum distance to consider a point a neighbor
+        */
+      inline void
+      setRadiusSearch (double radius) { search_radius_ = radius; }
+
+      /** \brief Get the sphere radius in which the neighbors of each point are stored. */
+      inline double
+      getRadiusSearch () const
+      {
+        return (search_radius_);
+      }
+
+      /** \brief Initialize the scheduler and set the number of threads to use.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      void
+      setNumberOfThreads (unsigned int nr_threads = 0);
+
+      /** \brief Search and store the neighbors of all the points given in <setInputCloud (), setIndices ()>.
+        * \return false if the search parameters are not well defined
+        */
+      bool
+      compute ();
+
+      /** \brief Get the number of points whose neighbors are stored. */
+      inline std::size_t
+      size () const
+      {
+        return (offsets_.empty () ? 0 : offsets_.size () - 1);
+      }
+
+      /** \brief Whether the neighbors of a point of the input cloud are stored.
+        * \param[in] index the index of the point in the input cloud
+        */
+      inline bool
+      isCached (index_t index) const
+      {
+        return (index >= 0 && static_cast<std::size_t> (index) < rows_.size () && rows_[index] >= 0);
+      }
+
+      /** \brief Whether a search with \a parameter (a radius or a number of neighbors, as the cache) can be served
+        * from the stored neighbors.
+        */
+      inline bool
+      covers (double parameter) const
+      {
+        if (search_radius_ > 0)
+          return (parameter > 0 && parameter <= search_radius_);
+        return (parameter > 0 && parameter <= k_);
+      }
+
+      /** \brief Get the stored neighbors of a point of the input cloud, for a search with the given parameter.
+        * \param[in] index the index of the query point in the input cloud
+        * \param[in] parameter the search parameter, a radius when the cache stores a radius search and a number of
+        * neighbors otherwise
+        * \param[out] indices the indices of the neighbors in the surface
+        * \param[out] sqr_distances the squared distances from the query point to the neighbors
+        * \return false if the point is not cached or \a parameter is not covered by the cache, the outputs are not
+        * changed then
+        */
+      inline bool
+      getNeighbors (index_t index, double parameter, std::vector<int> &indices, std::vector<float> &sqr_distances) const
+      {
+        if (!isCached (index) || !covers (parameter))
+          return (false);
+        const std::size_t begin = offsets_[rows_[index]];
+        std::size_t end = offsets_[rows_[index] + 1];
+        indices.clear ();
+        sqr_distances.clear ();
+        if (search_radius_ > 0)
+        {
+          // The neighbors are not sorted, keep the ones inside the smaller sphere
+          const float sqr_radius = static_cast<float> (parameter * parameter);
+          for (std::size_t i = begin; i < end; ++i)
+          {
+            if (sqr_distances_[i] > sqr_radius)
+              continue;
+            indices.push_back (neighbors_[i]);
+            sqr_distances.push_back (sqr_distances_[i]);
+          }
+          return (true);
+        }
+        // The nearest neighbors are sorted by distance
+        end = std::min (end, begin + static_cast<std::size_t> (parameter));
+        indices.assign (neighbors_.cbegin () + begin, neighbors_.cbegin () + end);
+        sqr_distances.assign (sqr_distances_.cbegin () + begin, sqr_distances_.cbegin () + end);
+        return (true);
+      }
+
+    protected:
+      /** \brief An input point cloud describing the surface in which the neighbors are searched. */
+      PointCloudConstPtr surface_;
+
+      /** \brief A pointer to the spatial search object. */
+      KdTreePtr tree_;
+
+      /** \brief The nearest neighbors search radius for each point. */
+      double search_radius_;
+
+      /** \brief The number of K nearest neighbors to store for each point. */
+      int k_;
+
+      /** \brief The number of threads the scheduler should use. */
+      unsigned int threads_;
+
+      /** \brief The row of each point of the input cloud in the stored neighborhoods, -1 if it is not cached. */
+      std::vector<int> rows_;
+
+      /** \brief The neighbors of the i-th row are stored between offsets_[i] and offsets_[i + 1]. */
+      std::vector<std::size_t> offsets_;
+
+      /** \brief The stored neighbors of all the rows, as indices in the surface. */
+      std::vector<int> neighbors_;
+
+      /** \brief The squared distances from the query points to the stored neighbors. */
+      std::vector<float> sqr_distances_;
+
+    public:
+      PCL_MAKE_ALIGNED_OPERATOR_NEW
+  };
+}
+
+#ifdef PCL_NO_PRECOMPILE
+#include <pcl/features/impl/neighborhood_cache.hpp>
+#endif
@@ -401,6 +401,34 @@ namespace pcl
       void
       computeFeature (PointCloudOut &output) override;
 
+      /** \brief Estimate the normals of a batch of consecutive points of <setInputCloud (), setIndices ()> at once.
+        * \details The covariance matrices and plane fits of the batch are computed together by the kernels of
+        * pcl/features/impl/normal_3d_batch.hpp, with the same results as computePointNormal () for each point.
+        * With setSpatialQueryOrder, the batch is made of consecutive points along the Morton curve.
+        * \param[in] begin the position of the first point of the batch in the processing order
+        * \param[in] count the number of points of the batch, at most detail::normal_batch_size
+        * \param[out] nn_indices the buffers for the neighbors of the points, one per point of a batch
+        * \param[out] nn_dists the buffer for the distances to the neighbors
+        * \param[out] output the point cloud in which the normals and curvatures of the batch are written
+        * \return false if the normal of a point could not be estimated (and was set to NaN)
+        */
+      bool
+      computeNormalBatch (std::size_t begin, std::size_t count, std::vector<std::vector<int> > &nn_indices,
+                          std::vector<float> &nn_dists, PointCloudOut &output) const;
+
+      /** \brief Estimate the normals of a batch of consecutive points of <setInputCloud (), setIndices ()> from
+        * their given neighborhoods, as computeNormalBatch () does after searching them.
+        * \param[in] begin the position of the first point of the batch in the processing order
+        * \param[in] count the number of points of the batch, at most detail::normal_batch_size
+        * \param[in] neighborhoods the neighbors of the points of the batch in the surface, an empty (or too
+        * small) neighborhood gives a NaN normal
+        * \param[out] output the point cloud in which the normals and curvatures of the batch are written
+        * \return false if the normal of a point could not be estimated (and was set to NaN)
+        */
+      bool
+      estimateNormalBatch (std::size_t begin, std::size_t count, const std::vector<int> *const *neighborhoods,
+                           PointCloudOut &output) const;
+
       /** \brief Values describing the viewpoint ("pinhole" camera model assumed). For per point viewpoints, inherit
         * from NormalEstimation and provide your own computeFeature (). By default, the viewpoint is set to 0,0,0. */
       float vpx_, vpy_, vpz_;
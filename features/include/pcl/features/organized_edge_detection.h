@@ -38,6 +38,7 @@
 #pragma once
 
 #include <pcl/pcl_base.h>
+#include <pcl/2d/convolution.h> // for PointXYZIEdge
 #include <pcl/PointIndices.h>
 
 namespace pcl
@@ -51,6 +52,8 @@ namespace pcl
     * OrganizedEdgeFromNormals accepts PCL_XYZ_POINT_TYPES with PCL_NORMAL_POINT_TYPES and returns EDGELABEL_NAN_BOUNDARY, EDGELABEL_OCCLUDING, EDGELABEL_OCCLUDED, and EDGELABEL_HIGH_CURVATURE.
     * OrganizedEdgeFromRGBNormals accepts PCL_RGB_POINT_TYPES with PCL_NORMAL_POINT_TYPES and returns EDGELABEL_NAN_BOUNDARY, EDGELABEL_OCCLUDING, EDGELABEL_OCCLUDED, EDGELABEL_HIGH_CURVATURE, and EDGELABEL_RGB_CANNY.
     *
+    * The rows of the image are processed in parallel, see setNumberOfThreads.
+    *
     * \author Changhyun Choi
     */
   template <typename PointT, typename PointLT>
@@ -77,6 +80,7 @@ namespace pcl
         : th_depth_discon_ (0.02f)
         , max_search_neighbors_ (50)
         , detecting_edge_types_ (EDGELABEL_NAN_BOUNDARY | EDGELABEL_OCCLUDING | EDGELABEL_OCCLUDED)
+        , threads_ (0)
       {
       }
 
@@ -135,6 +139,15 @@ namespace pcl
         return detecting_edge_types_;
       }
       
+      /** \brief Set the number of threads to use, also for the Canny edge detections.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      inline void
+      setNumberOfThreads (unsigned int nr_threads = 0)
+      {
+        threads_ = nr_threads;
+      }
+
       enum {EDGELABEL_NAN_BOUNDARY=1, EDGELABEL_OCCLUDING=2, EDGELABEL_OCCLUDED=4, EDGELABEL_HIGH_CURVATURE=8, EDGELABEL_RGB_CANNY=16};
       static const int num_of_edgetype_ = 5;
 
@@ -151,6 +164,14 @@ namespace pcl
         */
       void
       assignLabelIndices (pcl::PointCloud<PointLT>& labels, std::vector<pcl::PointIndices>& label_indices) const;
+
+      /** \brief Add an edge label to the points which are edges of a Canny edge image
+        * \param[in] img_edge the Canny edge image, organized as the input cloud
+        * \param[in] label the edge label to add
+        * \param[out] labels a PointCloud of edge labels
+        */
+      void
+      assignEdgeLabel (const pcl::PointCloud<pcl::PointXYZIEdge>& img_edge, unsigned label, pcl::PointCloud<PointLT>& labels) const;
       
       struct Neighbor
       {
@@ -176,6 +197,9 @@ namespace pcl
 
       /** \brief The bit encoded value that represents edge types to detect */
       int detecting_edge_types_;
+
+      /** \brief The number of threads the scheduler should use (0 for automatic) */
+      unsigned int threads_;
   };
 
   template <typename PointT, typename PointLT>
@@ -257,6 +281,12 @@ namespace pcl
       void
       extractEdges (pcl::PointCloud<PointLT>& labels) const;
 
+      /** \brief Run the Canny edge detection on the gray levels of the input cloud
+        * \param[out] img_edge_rgb the Canny edge image
+        */
+      void
+      detectRGBCannyEdges (pcl::PointCloud<pcl::PointXYZIEdge>& img_edge_rgb) const;
+
       /** \brief The low threshold value for RGB Canny edge detection (default: 40.0) */
       float th_rgb_canny_low_;
 
@@ -364,6 +394,12 @@ namespace pcl
       void
       extractEdges (pcl::PointCloud<PointLT>& labels) const;
 
+      /** \brief Run the Canny edge detection on the x and y components of the input normals
+        * \param[out] img_edge the Canny edge image
+        */
+      void
+      detectHighCurvatureEdges (pcl::PointCloud<pcl::PointXYZIEdge>& img_edge) const;
+
       /** \brief A pointer to the input normals */
       PointCloudNConstPtr normals_;
 
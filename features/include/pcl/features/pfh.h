@@ -44,6 +44,7 @@
 #include <pcl/features/feature.h>
 #include <pcl/features/pfh_tools.h>
 #include <map>
+#include <queue>
 
 namespace pcl
 {
@@ -72,7 +73,7 @@ namespace pcl
     *     NaN data on x, y, or z, will have its PFH feature property set to NaN.
     *
     * \note The code is stateful as we do not expect this class to be multicore parallelized. Please look at
-    * \ref FPFHEstimationOMP for examples on parallel implementations of the FPFH (Fast Point Feature Histogram).
+    * \ref PFHEstimationOMP for a parallel implementation.
     *
     * \author Radu B. Rusu
     * \ingroup features
@@ -95,6 +96,9 @@ namespace pcl
       using PointCloudOut = typename Feature<PointInT, PointOutT>::PointCloudOut;
       using PointCloudIn = typename Feature<PointInT, PointOutT>::PointCloudIn;
 
+      using PairFeatureMap = std::map<std::pair<int, int>, Eigen::Vector4f, std::less<>, Eigen::aligned_allocator<std::pair<const std::pair<int, int>, Eigen::Vector4f> > >;
+      using PairFeatureKeys = std::queue<std::pair<int, int> >;
+
       /** \brief Empty constructor. 
         * Sets \a use_cache_ to false, \a nr_subdiv_ to 5, and the internal maximum cache size to 1GB.
         */
@@ -165,7 +169,7 @@ namespace pcl
         */
       bool 
       computePairFeatures (const pcl::PointCloud<PointInT> &cloud, const pcl::PointCloud<PointNT> &normals, 
-                           int p_idx, int q_idx, float &f1, float &f2, float &f3, float &f4);
+                           int p_idx, int q_idx, float &f1, float &f2, float &f3, float &f4) const;
 
       /** \brief Estimate the PFH (Point Feature Histograms) individual signatures of the three angular (f1, f2, f3)
         * features for a given point based on its spatial neighborhood of 3D points with normals
@@ -180,6 +184,24 @@ namespace pcl
                                 const std::vector<int> &indices, int nr_split, Eigen::VectorXf &pfh_histogram);
 
     protected:
+      /** \brief Estimate the PFH signature of a point as \ref computePointPFHSignature, with the pair features
+        * cache given explicitly instead of the internal one, so that several threads can estimate signatures at
+        * the same time with a cache each.
+        * \param[in] cloud the dataset containing the XYZ Cartesian coordinates of the two points
+        * \param[in] normals the dataset containing the surface normals at each point in \a cloud
+        * \param[in] indices the k-neighborhood point indices in the dataset
+        * \param[in] nr_split the number of subdivisions for each angular feature interval
+        * \param[out] pfh_histogram the resultant (combinatorial) PFH histogram representing the feature at the query point
+        * \param[in,out] feature_map the pair features cache, or nullptr to compute every pair
+        * \param[in,out] key_list the pairs saved in \a feature_map, from the oldest to the newest
+        * \param[in] max_cache_size the maximum number of pairs kept in \a feature_map
+        */
+      void
+      computePointPFHSignature (const pcl::PointCloud<PointInT> &cloud, const pcl::PointCloud<PointNT> &normals,
+                                const std::vector<int> &indices, int nr_split, Eigen::VectorXf &pfh_histogram,
+                                PairFeatureMap *feature_map, PairFeatureKeys *key_list,
+                                std::size_t max_cache_size) const;
+
       /** \brief Estimate the Point Feature Histograms (PFH) descriptors at a set of points given by
         * <setInputCloud (), setIndices ()> using the surface in setSearchSurface () and the spatial locator in
         * setSearchMethod ()
@@ -204,10 +226,10 @@ namespace pcl
       float d_pi_; 
 
       /** \brief Internal hashmap, used to optimize efficiency of redundant computations. */
-      std::map<std::pair<int, int>, Eigen::Vector4f, std::less<>, Eigen::aligned_allocator<std::pair<const std::pair<int, int>, Eigen::Vector4f> > > feature_map_;
+      PairFeatureMap feature_map_;
 
       /** \brief Queue of pairs saved, used to constrain memory usage. */
-      std::queue<std::pair<int, int> > key_list_;
+      PairFeatureKeys key_list_;
 
       /** \brief Maximum size of internal cache memory. */
       unsigned int max_cache_size_;
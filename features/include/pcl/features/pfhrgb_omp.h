@@ -0,0 +1,64 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved
+ */
+
+#pragma once
+
+#include <pcl/features/feature.h>
+#include <pcl/features/pfhrgb.h>
+
+namespace pcl
+{
+  /** \brief PFHRGBEstimationOMP estimates the Point Feature Histogram (PFH) descriptor with the color ratios of
+    * \ref PFHRGBEstimation for a given point cloud dataset containing points and normals, in parallel, using the
+    * OpenMP standard.
+    * \ingroup features
+    */
+  template <typename PointInT, typename PointNT, typename PointOutT = pcl::PFHRGBSignature250>
+  class PFHRGBEstimationOMP : public PFHRGBEstimation<PointInT, PointNT, PointOutT>
+  {
+    public:
+      using Ptr = shared_ptr<PFHRGBEstimationOMP<PointInT, PointNT, PointOutT> >;
+      using ConstPtr = shared_ptr<const PFHRGBEstimationOMP<PointInT, PointNT, PointOutT> >;
+      using PCLBase<PointInT>::indices_;
+      using Feature<PointInT, PointOutT>::feature_name_;
+      using Feature<PointInT, PointOutT>::surface_;
+      using Feature<PointInT, PointOutT>::k_;
+      using Feature<PointInT, PointOutT>::search_parameter_;
+      using FeatureFromNormals<PointInT, PointNT, PointOutT>::normals_;
+      using PFHRGBEstimation<PointInT, PointNT, PointOutT>::nr_subdiv_;
+      using PointCloudOut = typename Feature<PointInT, PointOutT>::PointCloudOut;
+
+      /** \brief Initialize the scheduler and set the number of threads to use.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      PFHRGBEstimationOMP (unsigned int nr_threads = 0)
+      {
+        feature_name_ = "PFHRGBEstimationOMP";
+
+        setNumberOfThreads (nr_threads);
+      }
+
+      /** \brief Initialize the scheduler and set the number of threads to use.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      void
+      setNumberOfThreads (unsigned int nr_threads = 0);
+
+    protected:
+      void
+      computeFeature (PointCloudOut &output) override;
+
+      /** \brief The number of threads the scheduler should use. */
+      unsigned int threads_;
+  };
+}
+
+#ifdef PCL_NO_PRECOMPILE
+#include <pcl/features/impl/pfhrgb_omp.hpp>
+#endif
@@ -89,6 +89,15 @@ namespace pcl
       PPFEstimation ();
 
 
+    protected:
+      /** \brief Compute the features of all the pairs of a reference point, in its row of the output.
+        * \param[in] index_i the index of the reference point in indices_
+        * \param[out] output the feature cloud, already resized to hold all the pairs
+        * \return false if a feature of the row could not be computed (the pair of the point with itself included)
+        */
+      bool
+      computeReferencePointFeatures (std::size_t index_i, PointCloudOut &output) const;
+
     private:
       /** \brief The method called for actually doing the computations
         * \param[out] output the resulting point cloud (which should be of type pcl::PPFSignature);
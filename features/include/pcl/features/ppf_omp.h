@@ -0,0 +1,66 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved
+ */
+
+#pragma once
+
+#include <pcl/features/ppf.h>
+
+namespace pcl
+{
+  /** \brief PPFEstimationOMP calculates the "surflet" features for each pair in the given pointcloud, in parallel,
+    * using the OpenMP standard. The rows of reference points are computed independently, the output is the same as
+    * the one of @ref PPFEstimation.
+    * \ingroup features
+    */
+  template <typename PointInT, typename PointNT, typename PointOutT>
+  class PPFEstimationOMP : public PPFEstimation<PointInT, PointNT, PointOutT>
+  {
+    public:
+      using Ptr = shared_ptr<PPFEstimationOMP<PointInT, PointNT, PointOutT> >;
+      using ConstPtr = shared_ptr<const PPFEstimationOMP<PointInT, PointNT, PointOutT> >;
+
+      using PCLBase<PointInT>::indices_;
+      using Feature<PointInT, PointOutT>::input_;
+      using Feature<PointInT, PointOutT>::feature_name_;
+
+      using PointCloudOut = typename PPFEstimation<PointInT, PointNT, PointOutT>::PointCloudOut;
+
+      /** \brief Initialize the scheduler and set the number of threads to use.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      PPFEstimationOMP (unsigned int nr_threads = 0)
+      {
+        feature_name_ = "PPFEstimationOMP";
+
+        setNumberOfThreads (nr_threads);
+      }
+
+      /** \brief Initialize the scheduler and set the number of threads to use.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      void
+      setNumberOfThreads (unsigned int nr_threads = 0);
+
+    protected:
+      /** \brief The method called for actually doing the computations
+        * \param[out] output the resulting point cloud (which should be of type pcl::PPFSignature);
+        * its size is the size of the input cloud, squared (i.e., one point for each pair in
+        * the input cloud);
+        */
+      void
+      computeFeature (PointCloudOut &output) override;
+
+      /** \brief The number of threads the scheduler should use. */
+      unsigned int threads_;
+  };
+}
+
+#ifdef PCL_NO_PRECOMPILE
+#include <pcl/features/impl/ppf_omp.hpp>
+#endif
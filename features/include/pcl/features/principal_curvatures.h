@@ -51,7 +51,7 @@ namespace pcl
     * The recommended PointOutT is pcl::PrincipalCurvatures.
     *
     * \note The code is stateful as we do not expect this class to be multicore parallelized. Please look at
-    * \ref NormalEstimationOMP for an example on how to extend this to parallel implementations.
+    * \ref PrincipalCurvaturesEstimationOMP for a parallel implementation.
     *
     * \author Radu B. Rusu, Jared Glover
     * \ingroup features
@@ -73,14 +73,10 @@ namespace pcl
 
       using PointCloudOut = typename Feature<PointInT, PointOutT>::PointCloudOut;
       using PointCloudIn = pcl::PointCloud<PointInT>;
+      using ProjectedNormals = std::vector<Eigen::Vector3f, Eigen::aligned_allocator<Eigen::Vector3f> >;
 
       /** \brief Empty constructor. */
-      PrincipalCurvaturesEstimation () : 
-        xyz_centroid_ (Eigen::Vector3f::Zero ()), 
-        demean_ (Eigen::Vector3f::Zero ()),
-        covariance_matrix_ (Eigen::Matrix3f::Zero ()),
-        eigenvector_ (Eigen::Vector3f::Zero ()),
-        eigenvalues_ (Eigen::Vector3f::Zero ())
+      PrincipalCurvaturesEstimation ()
       {
         feature_name_ = "PrincipalCurvaturesEstimation";
       };
@@ -102,6 +98,26 @@ namespace pcl
                                        int p_idx, const std::vector<int> &indices,
                                        float &pcx, float &pcy, float &pcz, float &pc1, float &pc2);
 
+      /** \brief Perform Principal Components Analysis (PCA) on the point normals of a surface patch in the tangent
+       *  plane of the given point normal, and return the principal curvature (eigenvector of the max eigenvalue),
+       *  along with both the max (pc1) and min (pc2) eigenvalues. This overload keeps no state in the class and
+       *  can be called concurrently, each caller passing its own buffer for the projected normals.
+       * \param[in] normals the point cloud normals
+       * \param[in] p_idx the query point at which the least-squares plane was estimated
+       * \param[in] indices the point cloud indices that need to be used
+       * \param[in,out] projected_normals buffer for the normals projected into the tangent plane, reused across calls
+       * \param[out] pcx the principal curvature X direction
+       * \param[out] pcy the principal curvature Y direction
+       * \param[out] pcz the principal curvature Z direction
+       * \param[out] pc1 the max eigenvalue of curvature
+       * \param[out] pc2 the min eigenvalue of curvature
+       */
+      void
+      computePointPrincipalCurvatures (const pcl::PointCloud<PointNT> &normals,
+                                       int p_idx, const std::vector<int> &indices,
+                                       ProjectedNormals &projected_normals,
+                                       float &pcx, float &pcy, float &pcz, float &pc1, float &pc2) const;
+
     protected:
 
       /** \brief Estimate the principal curvature (eigenvector of the max eigenvalue), along with both the max (pc1)
@@ -113,22 +129,8 @@ namespace pcl
       computeFeature (PointCloudOut &output) override;
 
     private:
-      /** \brief A pointer to the input dataset that contains the point normals of the XYZ dataset. */
-      std::vector<Eigen::Vector3f, Eigen::aligned_allocator<Eigen::Vector3f> > projected_normals_;
-
-      /** \brief SSE aligned placeholder for the XYZ centroid of a surface patch. */
-      Eigen::Vector3f xyz_centroid_;
-
-      /** \brief Temporary point placeholder. */
-      Eigen::Vector3f demean_;
-
-      /** \brief Placeholder for the 3x3 covariance matrix at each surface patch. */
-      EIGEN_ALIGN16 Eigen::Matrix3f covariance_matrix_;
-
-      /** \brief SSE aligned eigenvectors placeholder for a covariance matrix. */
-      Eigen::Vector3f eigenvector_;
-      /** \brief eigenvalues placeholder for a covariance matrix. */
-      Eigen::Vector3f eigenvalues_;
+      /** \brief Placeholder for the point normals of a surface patch projected into the tangent plane. */
+      ProjectedNormals projected_normals_;
   };
 }
 
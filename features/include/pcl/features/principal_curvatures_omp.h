@@ -0,0 +1,69 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved
+ */
+
+#pragma once
+
+#include <pcl/features/principal_curvatures.h>
+
+namespace pcl
+{
+  /** \brief PrincipalCurvaturesEstimationOMP estimates the directions (eigenvectors) and magnitudes (eigenvalues)
+    * of principal surface curvatures of \ref PrincipalCurvaturesEstimation, in parallel, using the OpenMP standard.
+    *
+    * Each thread reuses its own buffer for the projected normals of the neighborhoods, and the results are the
+    * same as the ones of the serial estimation.
+    * \ingroup features
+    */
+  template <typename PointInT, typename PointNT, typename PointOutT = pcl::PrincipalCurvatures>
+  class PrincipalCurvaturesEstimationOMP : public PrincipalCurvaturesEstimation<PointInT, PointNT, PointOutT>
+  {
+    public:
+      using Ptr = shared_ptr<PrincipalCurvaturesEstimationOMP<PointInT, PointNT, PointOutT> >;
+      using ConstPtr = shared_ptr<const PrincipalCurvaturesEstimationOMP<PointInT, PointNT, PointOutT> >;
+      using Feature<PointInT, PointOutT>::feature_name_;
+      using Feature<PointInT, PointOutT>::indices_;
+      using Feature<PointInT, PointOutT>::k_;
+      using Feature<PointInT, PointOutT>::search_parameter_;
+      using Feature<PointInT, PointOutT>::input_;
+      using FeatureFromNormals<PointInT, PointNT, PointOutT>::normals_;
+      using PointCloudOut = typename Feature<PointInT, PointOutT>::PointCloudOut;
+      using ProjectedNormals = typename PrincipalCurvaturesEstimation<PointInT, PointNT, PointOutT>::ProjectedNormals;
+
+      /** \brief Initialize the scheduler and set the number of threads to use.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      PrincipalCurvaturesEstimationOMP (unsigned int nr_threads = 0)
+      {
+        feature_name_ = "PrincipalCurvaturesEstimationOMP";
+
+        setNumberOfThreads (nr_threads);
+      }
+
+      /** \brief Initialize the scheduler and set the number of threads to use.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      void
+      setNumberOfThreads (unsigned int nr_threads = 0);
+
+    protected:
+      /** \brief Estimate the principal curvatures for all points given in <setInputCloud (), setIndices ()> using
+        * the surface in setSearchSurface () and the spatial locator in setSearchMethod ()
+        * \param[out] output the resultant point cloud model dataset that contains the principal curvature estimates
+        */
+      void
+      computeFeature (PointCloudOut &output) override;
+
+      /** \brief The number of threads the scheduler should use. */
+      unsigned int threads_;
+  };
+}
+
+#ifdef PCL_NO_PRECOMPILE
+#include <pcl/features/impl/principal_curvatures_omp.hpp>
+#endif
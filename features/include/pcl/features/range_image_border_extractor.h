@@ -37,6 +37,7 @@
 
 #pragma once
 
+#include <pcl/point_cloud_fwd.h>
 #include <pcl/point_types.h>
 #include <pcl/features/feature.h>
 
@@ -44,8 +45,6 @@ namespace pcl
 {
   // FORWARD DECLARATIONS:
   class RangeImage;
-  template <typename PointType>
-  class PointCloud;
 
   /** \brief @b Extract obstacle borders from range images, meaning positions where there is a transition from foreground
     * to background.
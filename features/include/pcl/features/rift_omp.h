@@ -0,0 +1,72 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved
+ */
+
+#pragma once
+
+#include <pcl/features/rift.h>
+
+namespace pcl
+{
+  /** \brief RIFTEstimationOMP estimates the Rotation Invariant Feature Transform descriptors of
+    * \ref RIFTEstimation, in parallel, using the OpenMP standard.
+    *
+    * Each thread reuses its own neighborhood buffers and descriptor matrix, and the results are the same as the
+    * ones of the serial estimation.
+    * \ingroup features
+    */
+  template <typename PointInT, typename GradientT, typename PointOutT>
+  class RIFTEstimationOMP : public RIFTEstimation<PointInT, GradientT, PointOutT>
+  {
+    public:
+      using Ptr = shared_ptr<RIFTEstimationOMP<PointInT, GradientT, PointOutT> >;
+      using ConstPtr = shared_ptr<const RIFTEstimationOMP<PointInT, GradientT, PointOutT> >;
+      using Feature<PointInT, PointOutT>::feature_name_;
+      using Feature<PointInT, PointOutT>::getClassName;
+      using Feature<PointInT, PointOutT>::surface_;
+      using Feature<PointInT, PointOutT>::indices_;
+      using Feature<PointInT, PointOutT>::tree_;
+      using Feature<PointInT, PointOutT>::search_radius_;
+      using RIFTEstimation<PointInT, GradientT, PointOutT>::gradient_;
+      using RIFTEstimation<PointInT, GradientT, PointOutT>::nr_distance_bins_;
+      using RIFTEstimation<PointInT, GradientT, PointOutT>::nr_gradient_bins_;
+      using PointCloudOut = typename Feature<PointInT, PointOutT>::PointCloudOut;
+
+      /** \brief Initialize the scheduler and set the number of threads to use.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      RIFTEstimationOMP (unsigned int nr_threads = 0)
+      {
+        feature_name_ = "RIFTEstimationOMP";
+
+        setNumberOfThreads (nr_threads);
+      }
+
+      /** \brief Initialize the scheduler and set the number of threads to use.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      void
+      setNumberOfThreads (unsigned int nr_threads = 0);
+
+    protected:
+      /** \brief Estimate the Rotation Invariant Feature Transform (RIFT) descriptors at a set of points given by
+        * <setInputCloud (), setIndices ()> using the surface in setSearchSurface (), the gradient in
+        * setInputGradient (), and the spatial locator in setSearchMethod ()
+        * \param[out] output the resultant point cloud model dataset that contains the RIFT feature estimates
+        */
+      void
+      computeFeature (PointCloudOut &output) override;
+
+      /** \brief The number of threads the scheduler should use. */
+      unsigned int threads_;
+  };
+}
+
+#ifdef PCL_NO_PRECOMPILE
+#include <pcl/features/impl/rift_omp.hpp>
+#endif
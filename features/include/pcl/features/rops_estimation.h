@@ -42,7 +42,7 @@
 #include <pcl/memory.h>
 #include <pcl/pcl_macros.h>
 #include <pcl/features/feature.h>
-#include <set>
+#include <vector>
 
 namespace pcl
 {
@@ -115,6 +115,12 @@ namespace pcl
       void
       getTriangles (std::vector <pcl::Vertices>& triangles) const;
 
+      /** \brief Initialize the scheduler and set the number of threads to use.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      void
+      setNumberOfThreads (unsigned int nr_threads = 0);
+
     private:
 
       /** \brief Abstract feature estimation method.
@@ -125,18 +131,19 @@ namespace pcl
 
       /** \brief This method simply builds the list of triangles for every point.
         * The list of triangles for each point consists of indices of triangles it belongs to.
-        * The only purpose of this method is to improve performance of the algorithm.
+        * The only purpose of this method is to improve performance of the algorithm. The lists
+        * only depend on the triangles and the size of the surface, they are kept until one of them changes.
         */
       void
       buildListOfPointsTriangles ();
 
       /** \brief This method crops all the triangles within the given radius of the given point.
         * \param[in] point point for which the local surface is computed
-        * \param[out] local_triangles stores the indices of the triangles that belong to the local surface
+        * \param[out] local_triangles stores the sorted indices of the triangles that belong to the local surface
         * \param[out] local_points stores the indices of the points that belong to the local surface
         */
       void
-      getLocalSurface (const PointInT& point, std::set <unsigned int>& local_triangles, std::vector <int>& local_points) const;
+      getLocalSurface (const PointInT& point, std::vector <unsigned int>& local_triangles, std::vector <int>& local_points) const;
 
       /** \brief This method computes LRF (Local Reference Frame) matrix for the given point.
         * \param[in] point point for which the LRF is computed
@@ -144,7 +151,7 @@ namespace pcl
         * \paran[out] lrf_matrix stores computed LRF matrix for the given point
         */
       void
-      computeLRF (const PointInT& point, const std::set <unsigned int>& local_triangles, Eigen::Matrix3f& lrf_matrix) const;
+      computeLRF (const PointInT& point, const std::vector <unsigned int>& local_triangles, Eigen::Matrix3f& lrf_matrix) const;
 
       /** \brief This method calculates the eigen values and eigen vectors
         * for the given covariance matrix. Note that it returns normalized eigen
@@ -218,8 +225,16 @@ namespace pcl
       /** \brief Stores the set of triangles representing the mesh. */
       std::vector <pcl::Vertices> triangles_;
 
-      /** \brief Stores the set of triangles for each point. Its purpose is to improve performance. */
-      std::vector <std::vector <unsigned int> > triangles_of_the_point_;
+      /** \brief Stores the set of triangles for each point, the triangles of the i-th point of the surface are
+        * stored between triangles_offsets_[i] and triangles_offsets_[i + 1]. Its purpose is to improve performance.
+        */
+      std::vector <unsigned int> triangles_of_the_point_;
+
+      /** \brief Stores the offsets of the triangles of each point in triangles_of_the_point_. */
+      std::vector <std::size_t> triangles_offsets_;
+
+      /** \brief The number of threads the scheduler should use. */
+      unsigned int threads_;
 
     public:
       PCL_MAKE_ALIGNED_OPERATOR_NEW
@@ -125,6 +125,26 @@ namespace pcl
     return computeRSD (*normals, indices, sqr_dists, max_dist, nr_subdiv, plane_radius, radii, compute_histogram);
   }
 
+  /** \brief Estimate the Radius-based Surface Descriptor (RSD) for a given point based on its spatial neighborhood of 3D points
+    * with normals, reusing the given buffer for the per-distance angle bounds. Concurrent calls are safe as long as each
+    * caller passes its own buffer.
+    * \param[in] normals the dataset containing the surface normals at each point in the dataset
+    * \param[in] indices the neighborhood point indices in the dataset (first point is used as the reference)
+    * \param[in] sqr_dists the squared distances from the first to all points in the neighborhood
+    * \param[in] max_dist the upper bound for the considered distance interval
+    * \param[in] nr_subdiv the number of subdivisions for the considered distance interval
+    * \param[in] plane_radius maximum radius, above which everything can be considered planar
+    * \param[out] radii the output point of a type that should have r_min and r_max fields
+    * \param[in,out] min_max_angle_by_dist buffer for the minimum and maximum angle of each distance bin, reused across calls
+    * \param[out] histogram if not null, the full neighborhood histogram, usable as a point signature
+    * \ingroup features
+    */
+  template <typename PointNT, typename PointOutT> void
+  computeRSD (const pcl::PointCloud<PointNT> &normals,
+              const std::vector<int> &indices, const std::vector<float> &sqr_dists, double max_dist,
+              int nr_subdiv, double plane_radius, PointOutT &radii,
+              std::vector<double> &min_max_angle_by_dist, Eigen::MatrixXf *histogram = nullptr);
+
   /** \brief @b RSDEstimation estimates the Radius-based Surface Descriptor (minimal and maximal radius of the local surface's curves)
     * for a given point cloud dataset containing points and normals.
     *
@@ -143,7 +163,8 @@ namespace pcl
     * </li>
     * </ul>
     *
-    * @note The code is stateful as we do not expect this class to be multicore parallelized.
+    * @note The code is stateful as we do not expect this class to be multicore parallelized. Please look at
+    * \ref RSDEstimationOMP for a parallel implementation.
     * \author Zoltan-Csaba Marton
     * \ingroup features
     */
@@ -0,0 +1,78 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved
+ */
+
+#pragma once
+
+#include <pcl/features/spin_image.h>
+
+namespace pcl
+{
+  /** \brief SpinImageEstimationOMP estimates the spin-image descriptors of a given point cloud dataset, in parallel,
+    * using the OpenMP standard.
+    *
+    * The spin-images are the same as the ones of \ref SpinImageEstimation. When the spin-image of a point cannot be
+    * estimated (e.g. too few points in its support), the exception of the first failing point met by the threads is
+    * thrown once all the threads are done.
+    *
+    * \ingroup features
+    */
+  template <typename PointInT, typename PointNT, typename PointOutT>
+  class SpinImageEstimationOMP : public SpinImageEstimation<PointInT, PointNT, PointOutT>
+  {
+    public:
+      using Ptr = shared_ptr<SpinImageEstimationOMP<PointInT, PointNT, PointOutT> >;
+      using ConstPtr = shared_ptr<const SpinImageEstimationOMP<PointInT, PointNT, PointOutT> >;
+      using Feature<PointInT, PointOutT>::feature_name_;
+      using Feature<PointInT, PointOutT>::indices_;
+
+      using PointCloudOut = typename Feature<PointInT, PointOutT>::PointCloudOut;
+
+      /** \brief Constructs empty spin image estimator.
+        *
+        * \param[in] image_width spin-image resolution, number of bins along one dimension
+        * \param[in] support_angle_cos minimal allowed cosine of the angle between
+        *   the normals of input point and search surface point for the point
+        *   to be retained in the support
+        * \param[in] min_pts_neighb min number of points in the support to correctly estimate
+        *   spin-image. If at some point the support contains less points, exception is thrown
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      SpinImageEstimationOMP (unsigned int image_width = 8,
+                              double support_angle_cos = 0.0,
+                              unsigned int min_pts_neighb = 0,
+                              unsigned int nr_threads = 0)
+        : SpinImageEstimation<PointInT, PointNT, PointOutT> (image_width, support_angle_cos, min_pts_neighb)
+      {
+        feature_name_ = "SpinImageEstimationOMP";
+
+        setNumberOfThreads (nr_threads);
+      }
+
+      /** \brief Initialize the scheduler and set the number of threads to use.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      void
+      setNumberOfThreads (unsigned int nr_threads = 0);
+
+    protected:
+      /** \brief Estimate the Spin Image descriptors at a set of points given by
+        * setInputWithNormals() using the surface in setSearchSurfaceWithNormals() and the spatial locator
+        * \param[out] output the resultant point cloud that contains the Spin Image feature estimates
+        */
+      void
+      computeFeature (PointCloudOut &output) override;
+
+      /** \brief The number of threads the scheduler should use. */
+      unsigned int threads_;
+  };
+}
+
+#ifdef PCL_NO_PRECOMPILE
+#include <pcl/features/impl/spin_image_omp.hpp>
+#endif
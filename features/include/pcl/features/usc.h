@@ -142,12 +142,19 @@ namespace pcl
         * \param[out] desc descriptor to compute
         */
       void
-      computePointDescriptor (std::size_t index, std::vector<float> &desc);
+      computePointDescriptor (std::size_t index, std::vector<float> &desc) const;
 
       /** \brief Initialize computation by allocating all the intervals and the volume lookup table. */
       bool
       initCompute () override;
 
+      /** \brief Allocate the radii, elevation and azimuth intervals and the volume lookup table, once the local
+        * reference frames are estimated.
+        * \return false if the search radius is smaller than the minimal radius
+        */
+      bool
+      initIntervals ();
+
       /** \brief The actual feature computation.
         * \param[out] output the resultant features
         */
@@ -0,0 +1,80 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved
+ */
+
+#pragma once
+
+#include <pcl/features/usc.h>
+
+namespace pcl
+{
+  /** \brief UniqueShapeContextOMP estimates the Unique Shape Context descriptor of a given point cloud dataset, in
+    * parallel, using the OpenMP standard.
+    *
+    * The default local reference frames are estimated in parallel too, with
+    * \ref SHOTLocalReferenceFrameEstimationOMP. The descriptors are the same as the ones of \ref UniqueShapeContext.
+    *
+    * The suggested PointOutT is pcl::UniqueShapeContext1960
+    *
+    * \ingroup features
+    */
+  template <typename PointInT, typename PointOutT = pcl::UniqueShapeContext1960, typename PointRFT = pcl::ReferenceFrame>
+  class UniqueShapeContextOMP : public UniqueShapeContext<PointInT, PointOutT, PointRFT>
+  {
+    public:
+      using Feature<PointInT, PointOutT>::feature_name_;
+      using Feature<PointInT, PointOutT>::getClassName;
+      using Feature<PointInT, PointOutT>::indices_;
+      using Feature<PointInT, PointOutT>::surface_;
+      using Feature<PointInT, PointOutT>::fake_surface_;
+      using Feature<PointInT, PointOutT>::input_;
+      using FeatureWithLocalReferenceFrames<PointInT, PointRFT>::frames_;
+      using UniqueShapeContext<PointInT, PointOutT, PointRFT>::descriptor_length_;
+      using UniqueShapeContext<PointInT, PointOutT, PointRFT>::local_radius_;
+
+      using PointCloudOut = typename Feature<PointInT, PointOutT>::PointCloudOut;
+      using Ptr = shared_ptr<UniqueShapeContextOMP<PointInT, PointOutT, PointRFT> >;
+      using ConstPtr = shared_ptr<const UniqueShapeContextOMP<PointInT, PointOutT, PointRFT> >;
+
+      /** \brief Constructor.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      UniqueShapeContextOMP (unsigned int nr_threads = 0)
+      {
+        feature_name_ = "UniqueShapeContextOMP";
+
+        setNumberOfThreads (nr_threads);
+      }
+
+      /** \brief Initialize the scheduler and set the number of threads to use.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      void
+      setNumberOfThreads (unsigned int nr_threads = 0);
+
+    protected:
+      /** \brief Initialize computation by estimating the local reference frames in parallel and allocating all the
+        * intervals and the volume lookup table.
+        */
+      bool
+      initCompute () override;
+
+      /** \brief The actual feature computation.
+        * \param[out] output the resultant features
+        */
+      void
+      computeFeature (PointCloudOut &output) override;
+
+      /** \brief The number of threads the scheduler should use. */
+      unsigned int threads_;
+  };
+}
+
+#ifdef PCL_NO_PRECOMPILE
+#include <pcl/features/impl/usc_omp.hpp>
+#endif
@@ -37,6 +37,7 @@
  */
 
 #include <pcl/features/impl/intensity_spin.hpp>
+#include <pcl/features/impl/intensity_spin_omp.hpp>
 
 #ifndef PCL_NO_PRECOMPILE
 #include <pcl/point_types.h>
@@ -44,8 +45,10 @@
 // Instantiations of specific point types
 #ifdef PCL_ONLY_CORE_POINT_TYPES
   PCL_INSTANTIATE_PRODUCT(IntensitySpinEstimation, ((pcl::PointXYZI))((pcl::Histogram<20>)))
+  PCL_INSTANTIATE_PRODUCT(IntensitySpinEstimationOMP, ((pcl::PointXYZI))((pcl::Histogram<20>)))
 #else
   PCL_INSTANTIATE_PRODUCT(IntensitySpinEstimation, ((pcl::PointXYZI)(pcl::PointXYZINormal))((pcl::Histogram<20>)))
+  PCL_INSTANTIATE_PRODUCT(IntensitySpinEstimationOMP, ((pcl::PointXYZI)(pcl::PointXYZINormal))((pcl::Histogram<20>)))
 #endif
 #endif    // PCL_NO_PRECOMPILE
 
@@ -369,14 +369,17 @@ void
 Narf::extractForInterestPoints (const RangeImage& range_image, const PointCloud<InterestPoint>& interest_points,
                                 int descriptor_size, float support_size, bool rotation_invariant, std::vector<Narf*>& feature_list)
 {
+  // Features are collected per interest point and appended in the order of the interest points afterwards
+  std::vector<std::vector<Narf*> > features_per_point (interest_points.size ());
 #pragma omp parallel for \
   default(none) \
-  shared(descriptor_size, feature_list, interest_points, range_image, rotation_invariant, support_size) \
+  shared(descriptor_size, features_per_point, interest_points, range_image, rotation_invariant, support_size) \
   schedule(dynamic, 10) \
   num_threads(max_no_of_threads)
   //!!! nizar 20110408 : for OpenMP sake on MSVC this must be kept signed
   for (std::ptrdiff_t idx = 0; idx < static_cast<std::ptrdiff_t>(interest_points.size ()); ++idx)
   {
+    std::vector<Narf*>& point_features = features_per_point[idx];
     const auto& interest_point = interest_points[idx];
     Vector3fMapConst point = interest_point.getVector3fMap ();
 
@@ -388,10 +391,7 @@ Narf::extractForInterestPoints (const RangeImage& range_image, const PointCloud<
     else {
       if (!rotation_invariant)
       {
-#       pragma omp critical
-        {
-          feature_list.push_back(feature);
-        }
+        point_features.push_back(feature);
       }
       else {
         std::vector<float> rotations, strengths;
@@ -408,16 +408,16 @@ Narf::extractForInterestPoints (const RangeImage& range_image, const PointCloud<
               delete feature2;
               continue;
             }
-#           pragma omp critical
-            {
-              feature_list.push_back(feature2);
-            }
+            point_features.push_back(feature2);
           }
         }
         delete feature;
       }
     }
   }
+
+  for (const auto& point_features : features_per_point)
+    feature_list.insert (feature_list.end (), point_features.begin (), point_features.end ());
 }
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -425,14 +425,26 @@ void
 Narf::extractForEveryRangeImagePointAndAddToList (const RangeImage& range_image, int descriptor_size, float support_size,
                                                   bool rotation_invariant, std::vector<Narf*>& feature_list)
 {
-  for (unsigned int y=0; y<range_image.height; ++y)
+  // Rows are processed in parallel and their features appended in row order afterwards
+  const int height = range_image.height;
+  std::vector<std::vector<Narf*> > features_per_row (height);
+#pragma omp parallel for \
+  default(none) \
+  shared(descriptor_size, features_per_row, range_image, rotation_invariant, support_size) \
+  firstprivate(height) \
+  schedule(dynamic, 1) \
+  num_threads(max_no_of_threads)
+  for (int y=0; y<height; ++y)
   {
     for (unsigned int x=0; x<range_image.width; ++x)
     {
       extractFromRangeImageAndAddToList(range_image, static_cast<float> (x), static_cast<float> (y), descriptor_size, support_size,
-                                        rotation_invariant, feature_list);
+                                        rotation_invariant, features_per_row[y]);
     }
   }
+
+  for (const auto& row_features : features_per_row)
+    feature_list.insert (feature_list.end (), row_features.begin (), row_features.end ());
 }
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////
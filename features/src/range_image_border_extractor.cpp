@@ -204,22 +204,36 @@ RangeImageBorderExtractor::extractBorderScoreImages ()
 float*
 RangeImageBorderExtractor::updatedScoresAccordingToNeighborValues (const float* border_scores) const
 {
-  float* new_scores = new float[range_image_->width*range_image_->height];
-  float* new_scores_ptr = new_scores;
-  for (int y=0; y < static_cast<int> (range_image_->height); ++y)
-    for (int x=0; x < static_cast<int> (range_image_->width); ++x)
-      *(new_scores_ptr++) = updatedScoreAccordingToNeighborValues(x, y, border_scores);
+  const int width  = range_image_->width,
+            height = range_image_->height;
+  float* new_scores = new float[width*height];
+#pragma omp parallel for \
+  default(none) \
+  shared(border_scores, new_scores) \
+  firstprivate(height, width) \
+  schedule(dynamic, 10) \
+  num_threads(parameters_.max_no_of_threads)
+  for (int y=0; y < height; ++y)
+    for (int x=0; x < width; ++x)
+      new_scores[y*width + x] = updatedScoreAccordingToNeighborValues(x, y, border_scores);
   return (new_scores);
 }
 
 std::vector<float>
 RangeImageBorderExtractor::updatedScoresAccordingToNeighborValues (const std::vector<float>& border_scores) const
 {
-  std::vector<float> new_border_scores;
-  new_border_scores.reserve (range_image_->width*range_image_->height);
-  for (int y=0; y < static_cast<int> (range_image_->height); ++y)
-    for (int x=0; x < static_cast<int> (range_image_->width); ++x)
-      new_border_scores.push_back (updatedScoreAccordingToNeighborValues(x, y, border_scores.data ()));
+  const int width  = range_image_->width,
+            height = range_image_->height;
+  std::vector<float> new_border_scores (width*height);
+#pragma omp parallel for \
+  default(none) \
+  shared(border_scores, new_border_scores) \
+  firstprivate(height, width) \
+  schedule(dynamic, 10) \
+  num_threads(parameters_.max_no_of_threads)
+  for (int y=0; y < height; ++y)
+    for (int x=0; x < width; ++x)
+      new_border_scores[y*width + x] = updatedScoreAccordingToNeighborValues(x, y, border_scores.data ());
   return new_border_scores;
 }
 
@@ -254,6 +268,15 @@ RangeImageBorderExtractor::findAndEvaluateShadowBorders ()
   int width  = range_image_->width,
       height = range_image_->height;
   shadow_border_informations_ = new ShadowBorderIndices*[width*height];
+
+  // Changing the left/right scores of a pixel only reads left/right scores of the same row and changing the top/bottom
+  // scores only reads top/bottom scores of the same column. Processing rows and then columns in parallel, each in the
+  // original scan order, therefore gives exactly the result of the serial scan.
+#pragma omp parallel for \
+  default(none) \
+  shared(height, width) \
+  schedule(dynamic, 10) \
+  num_threads(parameters_.max_no_of_threads)
   for (int y = 0; y < static_cast<int> (height); ++y)
   {
     for (int x = 0; x < static_cast<int> (width); ++x)
@@ -273,15 +296,39 @@ RangeImageBorderExtractor::findAndEvaluateShadowBorders ()
         shadow_border_indices = (shadow_border_indices==nullptr ? new ShadowBorderIndices : shadow_border_indices);
         shadow_border_indices->right = shadow_border_idx;
       }
-      if (changeScoreAccordingToShadowBorderValue(x, y, 0, -1, border_scores_top_.data (), border_scores_bottom_.data (), shadow_border_idx))
-      {
-        shadow_border_indices = (shadow_border_indices==nullptr ? new ShadowBorderIndices : shadow_border_indices);
-        shadow_border_indices->top = shadow_border_idx;
-      }
-      if (changeScoreAccordingToShadowBorderValue(x, y, 0, 1, border_scores_bottom_.data (), border_scores_top_.data (), shadow_border_idx))
+    }
+  }
+
+  // Columns are processed in tiles of neighboring columns to keep the row-major accesses cache friendly
+  const int tile_width = 64;
+  const int no_of_tiles = (width + tile_width - 1) / tile_width;
+#pragma omp parallel for \
+  default(none) \
+  shared(height, width) \
+  firstprivate(no_of_tiles, tile_width) \
+  schedule(dynamic, 1) \
+  num_threads(parameters_.max_no_of_threads)
+  for (int tile = 0; tile < no_of_tiles; ++tile)
+  {
+    const int x_end = (std::min) (width, (tile+1)*tile_width);
+    for (int y = 0; y < static_cast<int> (height); ++y)
+    {
+      for (int x = tile*tile_width; x < x_end; ++x)
       {
-        shadow_border_indices = (shadow_border_indices==nullptr ? new ShadowBorderIndices : shadow_border_indices);
-        shadow_border_indices->bottom = shadow_border_idx;
+        int index = y*width+x;
+        ShadowBorderIndices*& shadow_border_indices = shadow_border_informations_[index];
+        int shadow_border_idx;
+
+        if (changeScoreAccordingToShadowBorderValue(x, y, 0, -1, border_scores_top_.data (), border_scores_bottom_.data (), shadow_border_idx))
+        {
+          shadow_border_indices = (shadow_border_indices==nullptr ? new ShadowBorderIndices : shadow_border_indices);
+          shadow_border_indices->top = shadow_border_idx;
+        }
+        if (changeScoreAccordingToShadowBorderValue(x, y, 0, 1, border_scores_bottom_.data (), border_scores_top_.data (), shadow_border_idx))
+        {
+          shadow_border_indices = (shadow_border_indices==nullptr ? new ShadowBorderIndices : shadow_border_indices);
+          shadow_border_indices->bottom = shadow_border_idx;
+        }
       }
     }
   }
@@ -298,6 +345,11 @@ RangeImageBorderExtractor::getAnglesImageForBorderDirections ()
       array_size = width*height;
   float* angles_image = new float[array_size];
 
+#pragma omp parallel for \
+  default(none) \
+  shared(angles_image, height, width) \
+  schedule(dynamic, 10) \
+  num_threads(parameters_.max_no_of_threads)
   for (int y=0; y<height; ++y)
   {
     for (int x=0; x<width; ++x)
@@ -335,6 +387,11 @@ RangeImageBorderExtractor::getAnglesImageForSurfaceChangeDirections ()
       array_size = width*height;
   float* angles_image = new float[array_size];
 
+#pragma omp parallel for \
+  default(none) \
+  shared(angles_image, height, width) \
+  schedule(dynamic, 10) \
+  num_threads(parameters_.max_no_of_threads)
   for (int y=0; y<height; ++y)
   {
     for (int x=0; x<width; ++x)
@@ -485,6 +542,11 @@ RangeImageBorderExtractor::calculateBorderDirections ()
       height = range_image_->height,
       size   = width*height;
   border_directions_ = new Eigen::Vector3f*[size];
+#pragma omp parallel for \
+  default(none) \
+  shared(height, width) \
+  schedule(dynamic, 10) \
+  num_threads(parameters_.max_no_of_threads)
   for (int y=0; y<height; ++y)
   {
     for (int x=0; x<width; ++x)
@@ -497,6 +559,11 @@ RangeImageBorderExtractor::calculateBorderDirections ()
   int radius = parameters_.pixel_radius_border_direction;
   int minimum_weight = radius+1;
   float min_cos_angle=std::cos(deg2rad(120.0f));
+#pragma omp parallel for \
+  default(none) \
+  shared(average_border_directions, height, min_cos_angle, minimum_weight, radius, width) \
+  schedule(dynamic, 10) \
+  num_threads(parameters_.max_no_of_threads)
   for (int y=0; y<height; ++y)
   {
     for (int x=0; x<width; ++x)
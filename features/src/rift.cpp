@@ -37,6 +37,7 @@
  */
 
 #include <pcl/features/impl/rift.hpp>
+#include <pcl/features/impl/rift_omp.hpp>
 
 #ifndef PCL_NO_PRECOMPILE
 #include <pcl/point_types.h>
@@ -44,7 +45,9 @@
 // Instantiations of specific point types
 #ifdef PCL_ONLY_CORE_POINT_TYPES
   PCL_INSTANTIATE_PRODUCT(RIFTEstimation, ((pcl::PointXYZI))((pcl::IntensityGradient))((pcl::Histogram<32>)))
+  PCL_INSTANTIATE_PRODUCT(RIFTEstimationOMP, ((pcl::PointXYZI))((pcl::IntensityGradient))((pcl::Histogram<32>)))
 #else
   PCL_INSTANTIATE_PRODUCT(RIFTEstimation, ((pcl::PointXYZI)(pcl::PointXYZINormal))((pcl::IntensityGradient))((pcl::Histogram<32>)))
+  PCL_INSTANTIATE_PRODUCT(RIFTEstimationOMP, ((pcl::PointXYZI)(pcl::PointXYZINormal))((pcl::IntensityGradient))((pcl::Histogram<32>)))
 #endif
 #endif    // PCL_NO_PRECOMPILE
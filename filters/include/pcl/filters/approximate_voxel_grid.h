@@ -91,6 +91,10 @@ namespace pcl
   };
 
   /** \brief ApproximateVoxelGrid assembles a local 3D grid over a given PointCloud, and downsamples + filters the data.
+    *
+    * The points are accumulated in a small hash table of voxels, which is flushed to the output when two voxels
+    * collide, so that the points of a voxel can end up in several centroids. With \ref setExactVoxels, every voxel
+    * is instead output once, with the centroid of all its points.
     *
     * \author James Bowman, Radu B. Rusu
     * \ingroup filters
@@ -128,7 +132,9 @@ namespace pcl
         leaf_size_ (Eigen::Vector3f::Ones ()),
         inverse_leaf_size_ (Eigen::Array3f::Ones ()),
         downsample_all_data_ (true), histsize_ (512),
-        history_ (new he[histsize_])
+        history_ (new he[histsize_]),
+        exact_voxels_ (false),
+        threads_ (1)
       {
         filter_name_ = "ApproximateVoxelGrid";
       }
@@ -142,7 +148,9 @@ namespace pcl
         inverse_leaf_size_ (src.inverse_leaf_size_),
         downsample_all_data_ (src.downsample_all_data_), 
         histsize_ (src.histsize_),
-        history_ ()
+        history_ (),
+        exact_voxels_ (src.exact_voxels_),
+        threads_ (src.threads_)
       {
         history_ = new he[histsize_];
         for (std::size_t i = 0; i < histsize_; i++)
@@ -168,6 +176,8 @@ namespace pcl
         inverse_leaf_size_ = src.inverse_leaf_size_;
         downsample_all_data_ = src.downsample_all_data_;
         histsize_ = src.histsize_;
+        exact_voxels_ = src.exact_voxels_;
+        threads_ = src.threads_;
         history_ = new he[histsize_];
         for (std::size_t i = 0; i < histsize_; i++)
           history_[i] = src.history_[i];
@@ -211,6 +221,26 @@ namespace pcl
       inline bool 
       getDownsampleAllData () const { return (downsample_all_data_); }
 
+      /** \brief Set to true to output every voxel once, with the centroid of all its points.
+        * \details The points are then grouped with one hash map per thread instead of the bounded history buffer,
+        * the memory growing with the number of occupied voxels. The centroids are output in order of first
+        * appearance of their voxel, invalid points are skipped, and the result does not depend on the number of
+        * threads. The voxels are identified by 21 bits per axis, voxels 2^21 leaves apart share their centroid.
+        * \param[in] exact_voxels the new value (true/false)
+        */
+      inline void
+      setExactVoxels (bool exact_voxels) { exact_voxels_ = exact_voxels; }
+
+      /** \brief Returns true if every voxel is output once. */
+      inline bool
+      getExactVoxels () const { return (exact_voxels_); }
+
+      /** \brief Set the number of threads to use, when every voxel is output once.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      void
+      setNumberOfThreads (unsigned int nr_threads = 0);
+
     protected:
       /** \brief The size of a leaf. */
       Eigen::Vector3f leaf_size_;
@@ -227,6 +257,12 @@ namespace pcl
       /** \brief history buffer */
       struct he* history_;
 
+      /** \brief Set to true to output every voxel once. */
+      bool exact_voxels_;
+
+      /** \brief The number of threads to use. */
+      unsigned int threads_;
+
       using FieldList = typename pcl::traits::fieldList<PointT>::type;
 
       /** \brief Downsample a Point Cloud using a voxelized grid approach
@@ -239,6 +275,16 @@ namespace pcl
         */
       void 
       flush (PointCloud &output, std::size_t op, he *hhe, int rgba_index, int centroid_size);
+
+      /** \brief Add a point to the centroid of a voxel, unpacking it into scratch
+        */
+      void
+      accumulate (const PointT &point, he *hhe, Eigen::VectorXf &scratch, int rgba_index, int centroid_size) const;
+
+      /** \brief Output every voxel once, with the centroid of all its points
+        */
+      void
+      applyExactVoxels (PointCloud &output, int rgba_index, int centroid_size);
   };
 }
 
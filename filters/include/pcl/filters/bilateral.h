@@ -49,6 +49,10 @@ namespace pcl
     * <b>C. Tomasi and R. Manduchi. Bilateral Filtering for Gray and Color Images.
     * In Proceedings of the IEEE International Conference on Computer Vision,
     * 1998.</b>
+    *
+    * The neighbors of every point are found with a radius search. For organized clouds they can instead be looked
+    * for in an image window around the point, see \ref setOrganizedSearchWindow, which is much faster. Invalid points
+    * are left unchanged. To smooth the depth of organized clouds rather than their intensity, see FastBilateralFilter.
     * \author Luca Penasa
     * \ingroup filters
     */
@@ -71,7 +75,9 @@ namespace pcl
         */
       BilateralFilter () : sigma_s_ (0), 
                            sigma_r_ (std::numeric_limits<double>::max ()),
-                           tree_ ()
+                           tree_ (),
+                           search_window_ (0),
+                           threads_ (1)
       {
       }
 
@@ -122,8 +128,34 @@ namespace pcl
       setSearchMethod (const KdTreePtr &tree)
       { tree_ = tree; }
 
+      /** \brief Set the half width of the image window in which the neighbors are searched, for organized clouds.
+        * \details With a half width w > 0, the neighbors of a point of an organized cloud are the valid points among
+        * the (2w+1)x(2w+1) pixels centered on it which are within the search radius, instead of all the points of the
+        * cloud within the radius. The window should be large enough to contain the neighborhood of the points.
+        * Unorganized clouds always use the search method.
+        * \param[in] half_width the half width of the window in pixels (0, the default, disables the window)
+        */
+      inline void
+      setOrganizedSearchWindow (unsigned int half_width)
+      { search_window_ = half_width; }
+
+      /** \brief Get the half width of the image window in which the neighbors are searched, for organized clouds. */
+      inline unsigned int
+      getOrganizedSearchWindow () const
+      { return (search_window_); }
+
+      /** \brief Set the number of threads to use.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      void
+      setNumberOfThreads (unsigned int nr_threads = 0);
+
     private:
 
+      /** \brief Compute the intensity averages of the points with their neighbors in an image window. */
+      void
+      filterWindows (PointCloud &output);
+
       /** \brief The bilateral filter Gaussian distance kernel.
         * \param[in] x the spatial distance (distance or intensity)
         * \param[in] sigma standard deviation
@@ -139,6 +171,12 @@ namespace pcl
 
       /** \brief A pointer to the spatial search object. */
       KdTreePtr tree_;
+
+      /** \brief The half width of the image window in which the neighbors are searched (0 to use the search method). */
+      unsigned int search_window_;
+
+      /** \brief The number of threads to use. */
+      unsigned int threads_;
   };
 }
 
@@ -42,6 +42,9 @@
 #include <pcl/common/eigen.h>
 #include <pcl/filters/filter.h>
 
+#include <cstdint>
+#include <vector>
+
 namespace pcl
 {
   //////////////////////////////////////////////////////////////////////////////////////////
@@ -74,6 +77,20 @@ namespace pcl
         */
       int
       compare (const PointT& p, const double& val);
+
+      /** \brief Get the type of data. */
+      inline std::uint8_t
+      getDatatype () const
+      {
+        return (datatype_);
+      }
+
+      /** \brief Get the data offset. */
+      inline std::uint32_t
+      getOffset () const
+      {
+        return (offset_);
+      }
     protected:
       /** \brief The type of data. */
       std::uint8_t datatype_;
@@ -110,6 +127,13 @@ namespace pcl
       virtual bool
       evaluate (const PointT &point) const = 0;
 
+      /** \brief Get the comparison operator type. */
+      inline ComparisonOps::CompareOp
+      getComparisonOperator () const
+      {
+        return (op_);
+      }
+
     protected:
       /** \brief True if capable. */
       bool capable_;
@@ -175,6 +199,20 @@ namespace pcl
       bool
       evaluate (const PointT &point) const override;
 
+      /** \brief Get the constant value the field value is compared to. */
+      inline double
+      getCompareValue () const
+      {
+        return (compare_val_);
+      }
+
+      /** \brief Get the type and offset of the compared field (null if the comparison is not capable). */
+      inline const PointDataAtOffset<PointT>*
+      getPointData () const
+      {
+        return (point_data_);
+      }
+
     protected:
       /** \brief All types (that we care about) can be represented as a double. */
       double compare_val_;
@@ -487,6 +525,20 @@ namespace pcl
       virtual bool
       evaluate (const PointT &point) const = 0;
 
+      /** \brief Get the comparisons of this condition. */
+      inline const std::vector<ComparisonBaseConstPtr>&
+      getComparisons () const
+      {
+        return (comparisons_);
+      }
+
+      /** \brief Get the nested conditions of this condition. */
+      inline const std::vector<Ptr>&
+      getConditions () const
+      {
+        return (conditions_);
+      }
+
     protected:
       /** \brief True if capable. */
       bool capable_;
@@ -554,6 +606,76 @@ namespace pcl
       evaluate (const PointT &point) const override;
   };
 
+  namespace detail
+  {
+    //////////////////////////////////////////////////////////////////////////////////////////
+    /** \brief A condition tree flattened into an array of nodes, evaluated for blocks of points at once.
+      *
+      * Every FieldComparison reads its field for all the points of a block into a column, with the
+      * type and offset resolved once, and compares the whole column in a loop which the compiler
+      * vectorizes. The results are combined as masks of 0/1 bytes, the points are not visited through
+      * virtual calls. Other comparisons and conditions are evaluated point by point through their
+      * evaluate method.
+      *
+      * \note The compiled condition refers to the comparisons and conditions of the tree, which must
+      * outlive it and must not be modified while it is used.
+      */
+    template <typename PointT>
+    class CompiledCondition
+    {
+      public:
+        /** \brief Flatten a condition tree.
+          * \param[in] condition the root of the tree
+          */
+        explicit
+        CompiledCondition (const ConditionBase<PointT> &condition);
+
+        /** \brief The maximum number of points evaluated at once. */
+        static constexpr std::size_t block_size = 256;
+
+        /** \brief Evaluate the condition for a block of points.
+          * \param[in] cloud the point cloud
+          * \param[in] indices the indices of the points of the block
+          * \param[in] count the number of points of the block (at most \a block_size)
+          * \param[out] mask whether each point meets the condition
+          */
+        void
+        evaluate (const pcl::PointCloud<PointT> &cloud, const int *indices, std::size_t count,
+                  std::uint8_t *mask) const;
+
+      private:
+        struct Node
+        {
+          enum Kind { AND, OR, FIELD, COMPARISON, CONDITION };
+          Kind kind;
+          /** \brief The children of an AND or OR node. */
+          std::vector<std::size_t> children;
+          /** \brief The compared field of a FIELD node. */
+          std::uint8_t datatype;
+          std::uint32_t offset;
+          ComparisonOps::CompareOp op;
+          double value;
+          /** \brief The evaluated object of a COMPARISON or CONDITION node. */
+          const ComparisonBase<PointT> *comparison;
+          const ConditionBase<PointT> *condition;
+        };
+
+        /** \brief Add the nodes of a condition, and return the index of its root node. */
+        std::size_t
+        compile (const ConditionBase<PointT> &condition);
+
+        /** \brief Add the node of a comparison, and return its index. */
+        std::size_t
+        compile (const ComparisonBase<PointT> &comparison);
+
+        void
+        evaluateNode (std::size_t node, const pcl::PointCloud<PointT> &cloud, const int *indices,
+                      std::size_t count, std::uint8_t *mask) const;
+
+        std::vector<Node> nodes_;
+    };
+  }
+
   //////////////////////////////////////////////////////////////////////////////////////////
   /** \brief @b ConditionalRemoval filters data that satisfies certain conditions.
     *
@@ -614,7 +736,7 @@ namespace pcl
         */
       ConditionalRemoval (int extract_removed_indices = false) :
         Filter<PointT>::Filter (extract_removed_indices), capable_ (false), keep_organized_ (false), condition_ (),
-        user_filter_value_ (std::numeric_limits<float>::quiet_NaN ())
+        user_filter_value_ (std::numeric_limits<float>::quiet_NaN ()), compiled_ (true), threads_ (1)
       {
         filter_name_ = "ConditionalRemoval";
       }
@@ -659,6 +781,33 @@ namespace pcl
       void
       setCondition (ConditionBasePtr condition);
 
+      /** \brief Set whether the condition is compiled before filtering.
+        * \details A compiled condition is evaluated for blocks of points at once, the field comparisons
+        * reading and comparing whole columns of values instead of going through virtual calls for every
+        * point and comparison. The result is the same in both cases.
+        * \param[in] compiled false to evaluate the condition tree point by point (default: true)
+        */
+      inline void
+      setCompiledCondition (bool compiled)
+      {
+        compiled_ = compiled;
+      }
+
+      /** \brief Get whether the condition is compiled before filtering. */
+      inline bool
+      getCompiledCondition () const
+      {
+        return (compiled_);
+      }
+
+      /** \brief Set the number of threads to use to evaluate the condition.
+        * \details The points are evaluated independently of each other, so the result does not depend on the
+        * number of threads. The comparisons and conditions must be safe to evaluate concurrently.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      void
+      setNumberOfThreads (unsigned int nr_threads = 0);
+
     protected:
       /** \brief Filter a Point Cloud.
         * \param output the resultant point cloud message
@@ -681,6 +830,20 @@ namespace pcl
         * the correct field type. 
         */
       float user_filter_value_;
+
+      /** \brief Whether the condition is compiled before filtering. */
+      bool compiled_;
+
+      /** \brief The number of threads to use to evaluate the condition. */
+      unsigned int threads_;
+
+    private:
+      /** \brief Evaluate the condition for a list of points.
+        * \param[in] indices the indices of the points to evaluate
+        * \param[out] passes whether each point of \a indices meets the condition
+        */
+      void
+      evaluateCondition (const std::vector<int> &indices, std::vector<std::uint8_t> &passes) const;
   };
 }
 
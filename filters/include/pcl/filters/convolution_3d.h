@@ -258,6 +258,19 @@ namespace pcl
         inline double
         getRadiusSearch () { return (search_radius_); }
 
+        /** \brief Search the neighbors in a uniform grid of cells of the search radius
+          * instead of the search method. The points are binned once and every query
+          * only scans the 27 cells around it, which yields the same neighborhoods
+          * much faster than a kd-tree on unorganized clouds.
+          * \param[in] use_grid_search whether to use the grid
+          */
+        inline void
+        setUseGridSearch (bool use_grid_search) { use_grid_search_ = use_grid_search; }
+
+        /** \brief Get whether the neighbors are searched in a uniform grid. */
+        inline bool
+        getUseGridSearch () const { return (use_grid_search_); }
+
         /** Convolve point cloud.
           * \param[out] output the convolved cloud
           */
@@ -268,6 +281,14 @@ namespace pcl
         /** \brief initialize computation */
         bool initCompute ();
 
+        /** \brief Convolve the surface points, searching their neighbors in a uniform
+          * grid with cells of the search radius.
+          * \param[out] output the convolved cloud
+          * \return false if the grid would have too many cells to be indexed
+          */
+        bool
+        convolveGrid (PointCloudOut& output);
+
         /** \brief An input point cloud describing the surface that is to be used for nearest neighbors estimation. */
         PointCloudInConstPtr surface_;
 
@@ -280,6 +301,9 @@ namespace pcl
         /** \brief number of threads */
         unsigned int threads_;
 
+        /** \brief whether the neighbors are searched in a uniform grid */
+        bool use_grid_search_;
+
         /** \brief convlving kernel */
         KernelT kernel_;
     };
@@ -78,6 +78,7 @@ namespace pcl
  
       /** \brief Empty constructor. */
       CovarianceSampling ()
+        : threads_ (1)
       { filter_name_ = "CovarianceSampling"; }
 
       /** \brief Set number of indices to be sampled.
@@ -104,6 +105,12 @@ namespace pcl
       getNormals () const
       { return (input_normals_); }
 
+      /** \brief Set the number of threads to use for computing the 6D vectors of the points and sorting them along the
+        * eigenvectors of the covariance matrix. The result does not depend on the number of threads.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      void
+      setNumberOfThreads (unsigned int nr_threads = 0);
 
 
       /** \brief Compute the condition number of the input point cloud. The condition number is the ratio between the
@@ -139,9 +146,19 @@ namespace pcl
 
       std::vector<Eigen::Vector3f, Eigen::aligned_allocator<Eigen::Vector3f> > scaled_points_;
 
+      /** \brief The number of threads to use. */
+      unsigned int threads_;
+
       bool
       initCompute ();
 
+      /** \brief Computes the 6D vectors of the points (the torque and force of each point, i.e. the cross product of
+        * the scaled point and its normal, and the normal), whose outer products sum to the covariance matrix.
+        * \param[out] f_mat the 6D vectors, one column per index
+        */
+      void
+      computeFeatureMatrix (Eigen::Matrix<double, 6, Eigen::Dynamic> &f_mat);
+
       /** \brief Sample of point indices into a separate PointCloud
         * \param[out] output the resultant point cloud
         */
@@ -164,6 +164,12 @@ namespace pcl
         return (transform_);
       }
 
+      /** \brief Get the transformation from the points of the cloud to the local space of the box, that is
+        * the transformation set by setTransform followed by the inverse of the box translation and rotation.
+        */
+      Eigen::Affine3f
+      getLocalTransform () const;
+
     protected:
       using PCLBase<PointT>::input_;
       using PCLBase<PointT>::indices_;
@@ -192,6 +198,22 @@ namespace pcl
       Eigen::Affine3f transform_;
   };
 
+  /** \brief Apply several CropBox filters to the same cloud in a single pass.
+    *
+    * The result is the same as the one of filter (indices) for each box with \a cloud as input, but the points are
+    * read once and every block of points is tested against all the boxes while it is in cache, instead of streaming
+    * the whole cloud once per box. The min, max, translation, rotation, transform and negative parameters of every
+    * box are used, its input cloud and indices are ignored and no removed indices are extracted.
+    * \param[in] cloud the input point cloud
+    * \param[in] boxes the boxes to crop \a cloud with
+    * \param[out] indices the indices of the points of \a cloud kept by each box
+    * \ingroup filters
+    */
+  template <typename PointT> void
+  cropBoxes (const pcl::PointCloud<PointT> &cloud,
+             const std::vector<typename pcl::CropBox<PointT>::ConstPtr> &boxes,
+             std::vector<Indices> &indices);
+
   //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
   /** \brief CropBox is a filter that allows the user to filter all the data
     * inside of a given box.
@@ -41,10 +41,18 @@
 #include <pcl/Vertices.h>
 #include <pcl/filters/filter_indices.h>
 
+#include <cstdint>
+#include <vector>
+
 namespace pcl
 {
   /** \brief Filter points that lie inside or outside a 3D closed surface or 2D
     * closed polygon, as generated by the ConvexHull or ConcaveHull classes.
+    *
+    * The hull polygons (2D) or triangles (3D) are binned into a uniform grid
+    * beforehand, so each point is only tested against the few of them that
+    * can be crossed by its rays, and the points are tested in parallel (see
+    * \ref setNumberOfThreads).
     * \author James Crosby
     * \ingroup filters
     */
@@ -68,7 +76,8 @@ namespace pcl
       CropHull () :
         hull_cloud_(),
         dim_(3),
-        crop_outside_(true)
+        crop_outside_(true),
+        threads_(1)
       {
         filter_name_ = "CropHull";
       }
@@ -129,6 +138,13 @@ namespace pcl
         crop_outside_ = crop_outside;
       }
 
+      /** \brief Set the number of threads to use for testing the points.
+        * \details The points are independent of each other, so the result does not depend on the number of threads.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      void
+      setNumberOfThreads (unsigned int nr_threads = 0);
+
     protected:
       /** \brief Filter the input points using the 2D or 3D polygon hull.
         * \param[out] output The set of points that passed the filter
@@ -150,46 +166,75 @@ namespace pcl
       Eigen::Vector3f
       getHullCloudRange ();
       
-      /** \brief Apply the two-dimensional hull filter.
-        * All points are assumed to lie in the same plane as the 2D hull, an
-        * axis-aligned 2D coordinate system using the two dimensions specified
-        * (PlaneDim1, PlaneDim2) is used for calculations.
-        * \param[out] output The set of points that pass the 2D polygon filter.
+      /** \brief Test which of the input points lie inside the hull, in parallel.
+        * \param[out] inside for each of the indices, whether the point lies inside the hull
         */
-      template<unsigned PlaneDim1, unsigned PlaneDim2> void
-      applyFilter2D (PointCloud &output); 
+      void
+      classifyPoints (std::vector<std::uint8_t> &inside);
 
-      /** \brief Apply the two-dimensional hull filter.
+      /** \brief Test the points against the two-dimensional hull.
         * All points are assumed to lie in the same plane as the 2D hull, an
         * axis-aligned 2D coordinate system using the two dimensions specified
         * (PlaneDim1, PlaneDim2) is used for calculations.
-        * \param[out] indices The indices of the set of points that pass the
-        *                     2D polygon filter.
+        * The edges of the polygons are binned into slabs along PlaneDim1, so
+        * that the ray cast along PlaneDim2 from a point is only tested against
+        * the edges of its slab.
+        * \param[out] inside for each of the indices, whether the point lies inside one of the polygons
         */
       template<unsigned PlaneDim1, unsigned PlaneDim2> void
-      applyFilter2D (std::vector<int> &indices);
-
-       /** \brief Apply the three-dimensional hull filter.
-         * Polygon-ray crossings are used for three rays cast from each point
-         * being tested, and a  majority vote of the resulting
-         * polygon-crossings is used to decide  whether the point lies inside
-         * or outside the hull.
-         * \param[out] output The set of points that pass the 3D polygon hull
-         *                    filter.
-         */
-      void
-      applyFilter3D (PointCloud &output);
+      classifyPoints2D (std::vector<std::uint8_t> &inside);
 
-      /** \brief Apply the three-dimensional hull filter.
-        *  Polygon-ray crossings are used for three rays cast from each point
-        *  being tested, and a  majority vote of the resulting
-        *  polygon-crossings is used to decide  whether the point lies inside
-        *  or outside the hull.
-        * \param[out] indices The indices of the set of points that pass the 3D
-        *                     polygon hull filter.
+      /** \brief Test the points against the three-dimensional hull.
+        * Polygon-ray crossings are used for three rays cast from each point
+        * being tested, and a  majority vote of the resulting
+        * polygon-crossings is used to decide  whether the point lies inside
+        * or outside the hull. For each ray direction, the polygons are binned
+        * into a grid on the plane orthogonal to the ray, so that a ray is only
+        * tested against the polygons of the cell it starts in.
+        * \param[out] inside for each of the indices, whether the point lies inside the hull
         */
       void
-      applyFilter3D (std::vector<int> &indices);
+      classifyPoints3D (std::vector<std::uint8_t> &inside);
+
+      /** \brief Uniform grid over a 2D domain, listing for each cell the items
+        * (polygons or edges) whose bounding box overlaps the cell.
+        */
+      struct ItemGrid
+      {
+        /** \brief Bin the items given by their bounding boxes (min x, min y, max x, max y).
+          * \param[in] boxes the bounding boxes of the items
+          * \param[in] nr_cells_x the number of cells along x
+          * \param[in] nr_cells_y the number of cells along y
+          */
+        void
+        build (const std::vector<Eigen::Vector4f, Eigen::aligned_allocator<Eigen::Vector4f> > &boxes, int nr_cells_x, int nr_cells_y);
+
+        /** \brief Get the index of the cell containing (x, y), points outside the grid being clamped to the border cells. */
+        inline std::size_t
+        getCell (float x, float y) const
+        {
+          return (static_cast<std::size_t> (getBin (y, min_y, inv_size_y, nr_y)) * nr_x + getBin (x, min_x, inv_size_x, nr_x));
+        }
+
+        /** \brief Get the bin of a coordinate, monotonic in the coordinate so that a value lying between
+          * two others also lies between their bins.
+          */
+        static inline int
+        getBin (float value, float min, float inv_size, int nr_bins)
+        {
+          const float bin = (value - min) * inv_size;
+          if (!(bin > 0.0f))
+            return (0);
+          return (bin < static_cast<float> (nr_bins) ? static_cast<int> (bin) : nr_bins - 1);
+        }
+
+        float min_x = 0.0f, min_y = 0.0f;
+        float inv_size_x = 0.0f, inv_size_y = 0.0f;
+        int nr_x = 1, nr_y = 1;
+        /** \brief The items of cell i are items[offsets[i]] to items[offsets[i + 1] - 1], in increasing order. */
+        std::vector<std::size_t> offsets;
+        std::vector<std::uint32_t> items;
+      };
 
       /** \brief Test an individual point against a 2D polygon.
         * PlaneDim1 and PlaneDim2 specify the x/y/z coordinate axes to use.
@@ -202,6 +247,14 @@ namespace pcl
                                       const Vertices& verts,
                                       const PointCloud& cloud);
 
+      /** \brief Does the ray cast from a point along PlaneDim2 cross a 2D polygon edge?
+        * \param[in] point Point from which the ray is cast.
+        * \param[in] from First vertex of the edge.
+        * \param[in] to Second vertex of the edge.
+        */
+      template<unsigned PlaneDim1, unsigned PlaneDim2> inline static bool
+      isCrossedBy2DRay (const PointT& point, const PointT& from, const PointT& to);
+
       /** \brief Does a ray cast from a point intersect with an arbitrary
         * triangle in 3D?
         * See: http://softsurfer.com/Archive/algorithm_0105/algorithm_0105.htm#intersect_RayTriangle()
@@ -230,6 +283,9 @@ namespace pcl
        * false, those inside will be removed.
        */
       bool crop_outside_;
+
+      /** \brief The number of threads to use for testing the points. */
+      unsigned int threads_;
   };
 
 } // namespace pcl
@@ -43,6 +43,21 @@
 
 namespace pcl
 {
+  namespace detail
+  {
+    /** \brief Get the indices in [0, nr_points) that are not in \a indices, in increasing order.
+      * \details Runs in linear time with a mask over the points instead of sorting \a indices, and fills the
+      * output block by block in parallel. Indices out of range are ignored.
+      * \param[in] nr_points the number of points of the cloud
+      * \param[in] indices the indices to leave out, in any order and possibly repeated
+      * \param[out] complement the remaining indices, may be the same object as \a indices
+      * \param[in] nr_threads the number of threads filling the output (0 uses all the cores, default: 1)
+      */
+    PCL_EXPORTS void
+    complementIndices (std::size_t nr_points, const Indices &indices, Indices &complement,
+                       unsigned int nr_threads = 1);
+  }
+
   /** \brief @b ExtractIndices extracts a set of indices from a point cloud.
     * \details Usage example:
     * \code
@@ -83,12 +98,19 @@ namespace pcl
         * \param[in] extract_removed_indices Set to true if you want to be able to extract the indices of points being removed (default = false).
         */
       ExtractIndices (bool extract_removed_indices = false) :
-        FilterIndices<PointT>::FilterIndices (extract_removed_indices)
+        FilterIndices<PointT>::FilterIndices (extract_removed_indices),
+        threads_ (1)
       {
         use_indices_ = true;
         filter_name_ = "ExtractIndices";
       }
 
+      /** \brief Set the number of threads to use for building the complement of the indices and copying the points.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      void
+      setNumberOfThreads (unsigned int nr_threads = 0);
+
       /** \brief Apply the filter and store the results directly in the input cloud.
         * \details This method will save the time and memory copy of an output cloud but can not alter the original size of the input cloud:
         * It operates as though setKeepOrganized() is true and will overwrite the filtered points instead of remove them.
@@ -132,6 +154,9 @@ namespace pcl
         */
       void
       applyFilterIndices (std::vector<int> &indices);
+
+      /** \brief The number of threads to use. */
+      unsigned int threads_;
   };
 
   //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -165,12 +190,19 @@ namespace pcl
       using PCLPointCloud2ConstPtr = PCLPointCloud2::ConstPtr;
 
       /** \brief Empty constructor. */
-      ExtractIndices ()
+      ExtractIndices () :
+        threads_ (1)
       {
         use_indices_ = true;
         filter_name_ = "ExtractIndices";
       }
 
+      /** \brief Set the number of threads to use for building the complement of the indices and copying the points.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      void
+      setNumberOfThreads (unsigned int nr_threads = 0);
+
     protected:
       using PCLBase<PCLPointCloud2>::input_;
       using PCLBase<PCLPointCloud2>::indices_;
@@ -192,6 +224,9 @@ namespace pcl
         */
       void
       applyFilter (std::vector<int> &indices) override;
+
+      /** \brief The number of threads to use. */
+      unsigned int threads_;
   };
 }
 
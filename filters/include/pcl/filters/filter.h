@@ -41,6 +41,7 @@
 
 #include <pcl/pcl_base.h>
 #include <pcl/common/io.h>
+#include <pcl/common/instrumentation.h>
 #include <pcl/conversions.h>
 #include <pcl/filters/boost.h>
 #include <cfloat>
@@ -123,8 +124,10 @@ namespace pcl
       inline void
       filter (PointCloud &output)
       {
+        PCL_INSTRUMENT_SCOPE (getClassName ());
         if (!initCompute ())
           return;
+        PCL_INSTRUMENT_COUNT (getClassName () + ".input_points", indices_->size ());
 
         if (input_.get () == &output)  // cloud_in = cloud_out
         {
@@ -142,6 +145,7 @@ namespace pcl
           output.sensor_orientation_ = input_->sensor_orientation_;
           applyFilter (output);
         }
+        PCL_INSTRUMENT_COUNT (getClassName () + ".output_points", output.size ());
 
         deinitCompute ();
       }
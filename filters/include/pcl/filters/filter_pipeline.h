@@ -0,0 +1,153 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved
+ */
+
+#pragma once
+
+#include <pcl/filters/filter_indices.h>
+
+#include <functional>
+#include <vector>
+
+namespace pcl
+{
+  /** \brief FilterPipeline applies a sequence of filters to a point cloud, without copying the points between them.
+    *
+    * Chaining filters by hand materializes a full intermediate point cloud after every filter. The pipeline instead
+    * passes the indices kept by each FilterIndices stage (PassThrough, CropBox, StatisticalOutlierRemoval, ...) as
+    * the indices of the next one, so that all of them work on the original cloud, and only the final cloud is copied
+    * out. Filters which create new points (e.g. VoxelGrid) are run on the current indices and start a new cloud, on
+    * which the following stages work.
+    *
+    * Consecutive predicates, added with \ref addPredicate, are fused into a single pass over the points. All the
+    * predicates of a pass are evaluated for a point before moving to the next one.
+    *
+    * \code
+    * pcl::FilterPipeline<pcl::PointXYZ> pipeline;
+    * pipeline.addPredicate ([] (const pcl::PointCloud<pcl::PointXYZ> &cloud, pcl::index_t i) { return (cloud[i].z < 5.0f); });
+    * pipeline.addFilter (crop_box);       // a pcl::CropBox<pcl::PointXYZ>::Ptr
+    * pipeline.addFilter (voxel_grid);     // a pcl::VoxelGrid<pcl::PointXYZ>::Ptr
+    * pipeline.addFilter (outlier_removal); // a pcl::StatisticalOutlierRemoval<pcl::PointXYZ>::Ptr
+    * pipeline.setInputCloud (cloud);
+    * pipeline.filter (*output);
+    * \endcode
+    *
+    * \note The input cloud and indices of the stages are replaced when the pipeline is run.
+    * \ingroup filters
+    */
+  template <typename PointT>
+  class FilterPipeline : public Filter<PointT>
+  {
+    using PointCloud = typename Filter<PointT>::PointCloud;
+    using PointCloudPtr = typename PointCloud::Ptr;
+    using PointCloudConstPtr = typename PointCloud::ConstPtr;
+
+    public:
+      using Ptr = shared_ptr<FilterPipeline<PointT> >;
+      using ConstPtr = shared_ptr<const FilterPipeline<PointT> >;
+
+      using FilterPtr = typename Filter<PointT>::Ptr;
+      using FilterIndicesPtr = typename FilterIndices<PointT>::Ptr;
+
+      /** \brief A point-local condition, true for the points which are kept. */
+      using Predicate = std::function<bool (const PointCloud&, index_t)>;
+
+      /** \brief Constructor.
+        * \param[in] extract_removed_indices Set to true if you want to be able to extract the indices of points being
+        * removed (default = false), only possible when no stage creates new points.
+        */
+      FilterPipeline (bool extract_removed_indices = false) :
+        Filter<PointT> (extract_removed_indices)
+      {
+        filter_name_ = "FilterPipeline";
+      }
+
+      using Filter<PointT>::filter;
+
+      /** \brief Append a filter to the pipeline.
+        * \details Filters derived from FilterIndices only select points of the current cloud, the other ones create
+        * a new cloud from the points selected so far.
+        * \param[in] filter the filter to apply to the result of the previous stages
+        */
+      void
+      addFilter (const FilterPtr &filter);
+
+      /** \brief Append a predicate to the pipeline, fused with the predicates added just before it.
+        * \param[in] predicate the condition the points have to satisfy to be kept
+        */
+      void
+      addPredicate (Predicate predicate);
+
+      /** \brief Get the number of passes over the points, consecutive predicates making a single pass. */
+      inline std::size_t
+      getNumberOfStages () const
+      {
+        return (stages_.size ());
+      }
+
+      /** \brief Remove all the stages. */
+      inline void
+      clear ()
+      {
+        stages_.clear ();
+      }
+
+      /** \brief Calls the filtering method and returns the indices of the points of the input cloud which are kept.
+        * \details Only possible when no stage creates new points.
+        * \param[out] indices the resultant filtered point cloud indices
+        */
+      void
+      filter (Indices &indices);
+
+    protected:
+      using PCLBase<PointT>::input_;
+      using PCLBase<PointT>::indices_;
+      using Filter<PointT>::filter_name_;
+      using Filter<PointT>::getClassName;
+      using Filter<PointT>::removed_indices_;
+      using Filter<PointT>::extract_removed_indices_;
+      using Filter<PointT>::initCompute;
+      using Filter<PointT>::deinitCompute;
+
+      /** \brief Run the stages and copy the remaining points out.
+        * \param[out] output the resultant filtered point cloud
+        */
+      void
+      applyFilter (PointCloud &output) override;
+
+      /** \brief Run the stages on the input cloud.
+        * \param[out] cloud the cloud the final indices refer to
+        * \param[out] indices the indices of the remaining points of \a cloud
+        */
+      void
+      run (PointCloudConstPtr &cloud, IndicesPtr &indices);
+
+    private:
+      /** \brief A pass over the points: a filter selecting points, a filter creating new points or fused predicates. */
+      struct Stage
+      {
+        FilterIndicesPtr indices_filter;
+        FilterPtr cloud_filter;
+        std::vector<Predicate> predicates;
+      };
+
+      /** \brief Whether a stage creates new points, so that the indices no longer refer to the input cloud. */
+      bool
+      createsPoints () const;
+
+      /** \brief Set the removed indices to the input indices which are not in \a indices. */
+      void
+      extractRemovedIndices (const Indices &indices);
+
+      std::vector<Stage> stages_;
+  };
+}
+
+#ifdef PCL_NO_PRECOMPILE
+#include <pcl/filters/impl/filter_pipeline.hpp>
+#endif
@@ -40,6 +40,27 @@
 
 #include <pcl/common/io.h>
 #include <pcl/filters/approximate_voxel_grid.h>
+#include <pcl/filters/impl/voxel_hash_map.hpp>
+
+#include <cstdint>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::ApproximateVoxelGrid<PointT>::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs ();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT> void
@@ -59,6 +80,79 @@ pcl::ApproximateVoxelGrid<PointT>::flush (PointCloud &output, std::size_t op, he
   }
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::ApproximateVoxelGrid<PointT>::accumulate (const PointT &point, he *hhe, Eigen::VectorXf &scratch, int rgba_index, int centroid_size) const
+{
+  hhe->count++;
+
+  // Unpack the point into scratch, then accumulate
+  // ---[ RGB special case
+  if (rgba_index >= 0)
+  {
+    // fill r/g/b data
+    pcl::RGB rgb;
+    memcpy (&rgb, (reinterpret_cast<const char *> (&point)) + rgba_index, sizeof (RGB));
+    scratch[centroid_size-3] = rgb.r;
+    scratch[centroid_size-2] = rgb.g;
+    scratch[centroid_size-1] = rgb.b;
+  }
+  pcl::for_each_type <FieldList> (xNdCopyPointEigenFunctor <PointT> (point, scratch));
+  hhe->centroid += scratch;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::ApproximateVoxelGrid<PointT>::applyExactVoxels (PointCloud &output, int rgba_index, int centroid_size)
+{
+  // The key of the voxel of every point, packing 21 bits of every voxel coordinate
+  std::vector<std::uint64_t> keys (input_->size ());
+#pragma omp parallel for \
+  default(none) \
+  shared(keys) \
+  num_threads(threads_)
+  for (std::ptrdiff_t i = 0; i < static_cast<std::ptrdiff_t> (input_->size ()); ++i)
+  {
+    const PointT &point = (*input_)[i];
+    if (!std::isfinite (point.x) || !std::isfinite (point.y) || !std::isfinite (point.z))
+    {
+      keys[i] = detail::invalidVoxelKey ();
+      continue;
+    }
+    const std::uint64_t mask = (std::uint64_t (1) << 21) - 1;
+    const std::uint64_t ix = static_cast<std::uint64_t> (static_cast<std::int64_t> (std::floor (point.x * inverse_leaf_size_[0])));
+    const std::uint64_t iy = static_cast<std::uint64_t> (static_cast<std::int64_t> (std::floor (point.y * inverse_leaf_size_[1])));
+    const std::uint64_t iz = static_cast<std::uint64_t> (static_cast<std::int64_t> (std::floor (point.z * inverse_leaf_size_[2])));
+    keys[i] = (ix & mask) | ((iy & mask) << 21) | ((iz & mask) << 42);
+  }
+
+  detail::VoxelGroups groups;
+  detail::groupVoxelsInShards (keys, threads_, groups);
+
+  // The centroids are independent, and accumulated in order of the points
+  output.points.resize (groups.size ());
+#pragma omp parallel \
+  default(none) \
+  shared(centroid_size, groups, output, rgba_index) \
+  num_threads(threads_)
+  {
+    he voxel;
+    Eigen::VectorXf scratch = Eigen::VectorXf::Zero (centroid_size);
+#pragma omp for
+    for (std::ptrdiff_t v = 0; v < static_cast<std::ptrdiff_t> (groups.size ()); ++v)
+    {
+      voxel.count = 0;
+      voxel.centroid = Eigen::VectorXf::Zero (centroid_size);
+      for (unsigned int p = groups.begins[v]; p < groups.begins[v + 1]; ++p)
+        accumulate ((*input_)[groups.positions[p]], &voxel, scratch, rgba_index, centroid_size);
+      flush (output, v, &voxel, rgba_index, centroid_size);
+    }
+  }
+  output.width = output.size ();
+  output.height       = 1;                    // downsampling breaks the organized structure
+  output.is_dense     = false;
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT> void
 pcl::ApproximateVoxelGrid<PointT>::applyFilter (PointCloud &output)
@@ -79,6 +173,12 @@ pcl::ApproximateVoxelGrid<PointT>::applyFilter (PointCloud &output)
     centroid_size += 3;
   }
 
+  if (exact_voxels_)
+  {
+    applyExactVoxels (output, rgba_index, centroid_size);
+    return;
+  }
+
   for (std::size_t i = 0; i < histsize_; i++) 
   {
     history_[i].count = 0;
@@ -104,21 +204,7 @@ pcl::ApproximateVoxelGrid<PointT>::applyFilter (PointCloud &output)
     hhe->ix = ix;
     hhe->iy = iy;
     hhe->iz = iz;
-    hhe->count++;
-
-    // Unpack the point into scratch, then accumulate
-    // ---[ RGB special case
-    if (rgba_index >= 0)
-    {
-      // fill r/g/b data
-      pcl::RGB rgb;
-      memcpy (&rgb, (reinterpret_cast<const char *> (&point)) + rgba_index, sizeof (RGB));
-      scratch[centroid_size-3] = rgb.r;
-      scratch[centroid_size-2] = rgb.g;
-      scratch[centroid_size-1] = rgb.b;
-    }
-    pcl::for_each_type <FieldList> (xNdCopyPointEigenFunctor <PointT> (point, scratch));
-    hhe->centroid += scratch;
+    accumulate (point, hhe, scratch, rgba_index, centroid_size);
   }
   for (std::size_t i = 0; i < histsize_; i++) 
   {
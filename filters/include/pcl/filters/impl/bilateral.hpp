@@ -41,6 +41,28 @@
 #define PCL_FILTERS_BILATERAL_IMPL_H_
 
 #include <pcl/filters/bilateral.h>
+#include <pcl/common/distances.h> // for pcl::squaredEuclideanDistance
+#include <pcl/common/point_tests.h> // for pcl::isFinite
+
+#include <algorithm>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::BilateralFilter<PointT>::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs ();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
 
 //////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT> double
@@ -78,6 +100,15 @@ pcl::BilateralFilter<PointT>::applyFilter (PointCloud &output)
     PCL_ERROR ("[pcl::BilateralFilter::applyFilter] Need a sigma_s value given before continuing.\n");
     return;
   }
+  // Copy the input data into the output
+  output = *input_;
+
+  if (search_window_ > 0 && input_->isOrganized ())
+  {
+    filterWindows (output);
+    return;
+  }
+
   // In case a search method has not been given, initialize it using some defaults
   if (!tree_)
   {
@@ -93,12 +124,19 @@ pcl::BilateralFilter<PointT>::applyFilter (PointCloud &output)
   std::vector<int> k_indices;
   std::vector<float> k_distances;
 
-  // Copy the input data into the output
-  output = *input_;
-
   // For all the indices given (equal to the entire cloud if none given)
-  for (std::size_t i = 0; i < indices_->size (); ++i)
+  // Note: the searches only read the input, the points are averaged in parallel
+#pragma omp parallel for \
+  default(none) \
+  shared(output) \
+  firstprivate(k_indices, k_distances) \
+  num_threads(threads_)
+  for (std::ptrdiff_t i = 0; i < static_cast<std::ptrdiff_t> (indices_->size ()); ++i)
   {
+    // Invalid points have no neighbors, they are left unchanged
+    if (!pcl::isFinite ((*input_)[(*indices_)[i]]))
+      continue;
+
     // Perform a radius search to find the nearest neighbors
     tree_->radiusSearch ((*indices_)[i], sigma_s_ * 2, k_indices, k_distances);
 
@@ -106,6 +144,47 @@ pcl::BilateralFilter<PointT>::applyFilter (PointCloud &output)
     output[(*indices_)[i]].intensity = static_cast<float> (computePointWeight ((*indices_)[i], k_indices, k_distances));
   }
 }
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::BilateralFilter<PointT>::filterWindows (PointCloud &output)
+{
+  int width = static_cast<int> (input_->width), height = static_cast<int> (input_->height);
+  int window = static_cast<int> (search_window_);
+  double sqr_radius = 4 * sigma_s_ * sigma_s_;
+
+#pragma omp parallel for \
+  default(none) \
+  shared(output, height, width, window, sqr_radius) \
+  num_threads(threads_)
+  for (std::ptrdiff_t i = 0; i < static_cast<std::ptrdiff_t> (indices_->size ()); ++i)
+  {
+    const int index = (*indices_)[i];
+    const PointT &point = (*input_)[index];
+    if (!pcl::isFinite (point))
+      continue;
+
+    // The same average as computePointWeight, over the valid points of the window within the radius
+    double BF = 0, W = 0;
+    const int row = index / width, col = index % width;
+    const int r_end = std::min (row + window, height - 1), c_end = std::min (col + window, width - 1);
+    for (int r = std::max (row - window, 0); r <= r_end; ++r)
+      for (int c = std::max (col - window, 0); c <= c_end; ++c)
+      {
+        const PointT &neighbor = (*input_)[r * width + c];
+        if (!pcl::isFinite (neighbor))
+          continue;
+        const float sqr_dist = squaredEuclideanDistance (point, neighbor);
+        if (sqr_dist > sqr_radius)
+          continue;
+        double intensity_dist = std::abs (point.intensity - neighbor.intensity);
+        double weight = kernel (std::sqrt (sqr_dist), sigma_s_) * kernel (intensity_dist, sigma_r_);
+        BF += weight * neighbor.intensity;
+        W += weight;
+      }
+    output[index].intensity = static_cast<float> (BF / W);
+  }
+}
  
 #define PCL_INSTANTIATE_BilateralFilter(T) template class PCL_EXPORTS pcl::BilateralFilter<T>;
 
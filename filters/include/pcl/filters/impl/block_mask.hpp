@@ -0,0 +1,159 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved
+ */
+
+#ifndef PCL_FILTERS_IMPL_BLOCK_MASK_HPP_
+#define PCL_FILTERS_IMPL_BLOCK_MASK_HPP_
+
+#include <pcl/point_cloud.h>
+
+#include <Eigen/Core>
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+namespace pcl
+{
+  namespace detail
+  {
+    /** \brief The number of points tested at once by the block kernels of the filters.
+      *
+      * The coordinates of a block are gathered into one small array per dimension, so that the tests are
+      * plain loops over contiguous floats without branches, which the compiler vectorizes for the enabled
+      * instruction sets (SSE, AVX, NEON, ...). The result of every test is a mask of 0/1 bytes, from which
+      * the indices are compacted without branches either.
+      */
+    constexpr std::size_t filter_block_size = 256;
+
+    /** \brief The coordinates of a block of points, one array per dimension. */
+    struct XYZBlock
+    {
+      float x[filter_block_size];
+      float y[filter_block_size];
+      float z[filter_block_size];
+    };
+
+    /** \brief Gather the coordinates of count (at most filter_block_size) points of a cloud. */
+    template <typename PointT> inline void
+    loadXYZBlock (const pcl::PointCloud<PointT> &cloud, const int *indices, std::size_t count, XYZBlock &block)
+    {
+      for (std::size_t i = 0; i < count; ++i)
+      {
+        const PointT &point = cloud[indices[i]];
+        block.x[i] = point.x;
+        block.y[i] = point.y;
+        block.z[i] = point.z;
+      }
+    }
+
+    /** \brief Whether a value is finite, written so that it vectorizes (false for NaN and infinities). */
+    inline bool
+    isFiniteValue (float value)
+    {
+      return (std::abs (value) <= std::numeric_limits<float>::max ());
+    }
+
+    /** \brief Set mask[i] to whether the coordinates of the i-th point of the block are finite. */
+    inline void
+    maskFiniteXYZ (const XYZBlock &block, std::size_t count, std::uint8_t *mask)
+    {
+      for (std::size_t i = 0; i < count; ++i)
+        mask[i] = static_cast<std::uint8_t> (isFiniteValue (block.x[i]) & isFiniteValue (block.y[i]) &
+                                             isFiniteValue (block.z[i]));
+    }
+
+    /** \brief Set inside[i] to whether the i-th point of the block, transformed by \a transform, lies in the
+      * axis aligned box [min_pt, max_pt].
+      * \note A point with a NaN coordinate is inside the box, as it is not outside on any axis.
+      */
+    inline void
+    maskInsideBox (const XYZBlock &block, std::size_t count, const Eigen::Matrix4f &transform,
+                   const Eigen::Vector4f &min_pt, const Eigen::Vector4f &max_pt, std::uint8_t *inside)
+    {
+      const float m00 = transform (0, 0), m01 = transform (0, 1), m02 = transform (0, 2), m03 = transform (0, 3);
+      const float m10 = transform (1, 0), m11 = transform (1, 1), m12 = transform (1, 2), m13 = transform (1, 3);
+      const float m20 = transform (2, 0), m21 = transform (2, 1), m22 = transform (2, 2), m23 = transform (2, 3);
+      const float min_x = min_pt[0], min_y = min_pt[1], min_z = min_pt[2];
+      const float max_x = max_pt[0], max_y = max_pt[1], max_z = max_pt[2];
+      for (std::size_t i = 0; i < count; ++i)
+      {
+        const float x = block.x[i], y = block.y[i], z = block.z[i];
+        const float lx = m00 * x + m01 * y + m02 * z + m03;
+        const float ly = m10 * x + m11 * y + m12 * z + m13;
+        const float lz = m20 * x + m21 * y + m22 * z + m23;
+        const bool outside = (lx < min_x) | (ly < min_y) | (lz < min_z) |
+                             (lx > max_x) | (ly > max_y) | (lz > max_z);
+        inside[i] = static_cast<std::uint8_t> (!outside);
+      }
+    }
+
+    /** \brief Set inside[i] to whether the i-th point of the block is on the non positive side of all the planes.
+      * \param[in] planes the plane equations (a, b, c, d), one per column
+      */
+    template <int NrPlanes> inline void
+    maskInsidePlanes (const XYZBlock &block, std::size_t count, const Eigen::Matrix<float, 4, NrPlanes> &planes,
+                      std::uint8_t *inside)
+    {
+      for (std::size_t i = 0; i < count; ++i)
+        inside[i] = 1;
+      for (int p = 0; p < NrPlanes; ++p)
+      {
+        const float a = planes (0, p), b = planes (1, p), c = planes (2, p), d = planes (3, p);
+        for (std::size_t i = 0; i < count; ++i)
+          inside[i] &= static_cast<std::uint8_t> (a * block.x[i] + b * block.y[i] + c * block.z[i] + d <= 0);
+      }
+    }
+
+    /** \brief Append the indices of a block to the kept and removed indices according to two masks, without
+      * branches.
+      *
+      * Every index is written to both outputs and the output positions only advance where the masks are set,
+      * so both outputs need room for as many indices as there are input indices.
+      * \param[in] indices the indices of the points of the block
+      * \param[in] count the number of points of the block
+      * \param[in] keep whether each point is kept
+      * \param[in] remove whether each point is removed (points can be neither)
+      * \param[out] kept the kept indices, written from position \a nr_kept
+      * \param[in,out] nr_kept the number of kept indices
+      * \param[out] removed the removed indices, written from position \a nr_removed
+      * \param[in,out] nr_removed the number of removed indices
+      */
+    inline void
+    compactBlock (const int *indices, std::size_t count, const std::uint8_t *keep, const std::uint8_t *remove,
+                  int *kept, std::size_t &nr_kept, int *removed, std::size_t &nr_removed)
+    {
+      for (std::size_t i = 0; i < count; ++i)
+      {
+        kept[nr_kept] = indices[i];
+        nr_kept += keep[i];
+        removed[nr_removed] = indices[i];
+        nr_removed += remove[i];
+      }
+    }
+
+    /** \brief Append the indices of a block to the kept indices according to a mask, without branches.
+      * \param[in] indices the indices of the points of the block
+      * \param[in] count the number of points of the block
+      * \param[in] keep whether each point is kept
+      * \param[out] kept the kept indices, written from position \a nr_kept
+      * \param[in,out] nr_kept the number of kept indices
+      */
+    inline void
+    compactBlock (const int *indices, std::size_t count, const std::uint8_t *keep, int *kept, std::size_t &nr_kept)
+    {
+      for (std::size_t i = 0; i < count; ++i)
+      {
+        kept[nr_kept] = indices[i];
+        nr_kept += keep[i];
+      }
+    }
+  }
+}
+
+#endif  // PCL_FILTERS_IMPL_BLOCK_MASK_HPP_
@@ -42,6 +42,13 @@
 #include <pcl/common/copy_point.h>
 #include <pcl/filters/conditional_removal.h>
 
+#include <algorithm>
+#include <cstring>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 //////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////
@@ -639,6 +646,252 @@ pcl::ConditionOr<PointT>::evaluate (const PointT &point) const
 
 //////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+namespace pcl
+{
+  namespace detail
+  {
+    /** \brief Compare a field of a block of points to a value, as PointDataAtOffset::compare does.
+      *
+      * The field is first read for all the points into a column, which is then compared in a loop
+      * without branches.
+      */
+    template <typename T, typename PointT> inline void
+    compareFieldColumn (const pcl::PointCloud<PointT> &cloud, const int *indices, std::size_t count,
+                        std::uint32_t offset, ComparisonOps::CompareOp op, double value, std::uint8_t *mask)
+    {
+      // The value is converted to the type of the field before comparing
+      const T threshold = static_cast<T> (value);
+      T column[CompiledCondition<PointT>::block_size];
+      for (std::size_t i = 0; i < count; ++i)
+        memcpy (&column[i], reinterpret_cast<const std::uint8_t*> (&cloud[indices[i]]) + offset, sizeof (T));
+
+      switch (op)
+      {
+        case ComparisonOps::GT :
+          for (std::size_t i = 0; i < count; ++i)
+            mask[i] = static_cast<std::uint8_t> (column[i] > threshold);
+          break;
+        case ComparisonOps::GE :
+          for (std::size_t i = 0; i < count; ++i)
+            mask[i] = static_cast<std::uint8_t> (column[i] >= threshold);
+          break;
+        case ComparisonOps::LT :
+          for (std::size_t i = 0; i < count; ++i)
+            mask[i] = static_cast<std::uint8_t> (column[i] < threshold);
+          break;
+        case ComparisonOps::LE :
+          for (std::size_t i = 0; i < count; ++i)
+            mask[i] = static_cast<std::uint8_t> (column[i] <= threshold);
+          break;
+        case ComparisonOps::EQ :
+          for (std::size_t i = 0; i < count; ++i)
+            mask[i] = static_cast<std::uint8_t> (column[i] == threshold);
+          break;
+        default:
+          PCL_WARN ("[pcl::FieldComparison::evaluate] unrecognized op_!\n");
+          std::fill (mask, mask + count, static_cast<std::uint8_t> (0));
+      }
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////
+template <typename PointT> constexpr std::size_t pcl::detail::CompiledCondition<PointT>::block_size;
+
+//////////////////////////////////////////////////////////////////////////
+template <typename PointT>
+pcl::detail::CompiledCondition<PointT>::CompiledCondition (const ConditionBase<PointT> &condition)
+{
+  compile (condition);
+}
+
+//////////////////////////////////////////////////////////////////////////
+template <typename PointT> std::size_t
+pcl::detail::CompiledCondition<PointT>::compile (const ConditionBase<PointT> &condition)
+{
+  Node node {};
+  if (dynamic_cast<const ConditionAnd<PointT>*> (&condition))
+    node.kind = Node::AND;
+  else if (dynamic_cast<const ConditionOr<PointT>*> (&condition))
+    node.kind = Node::OR;
+  else
+  {
+    // Other conditions are evaluated as they are
+    node.kind = Node::CONDITION;
+    node.condition = &condition;
+  }
+  const std::size_t index = nodes_.size ();
+  nodes_.push_back (node);
+  if (node.kind == Node::CONDITION)
+    return (index);
+
+  for (const auto &comparison : condition.getComparisons ())
+  {
+    const std::size_t child = compile (*comparison);
+    nodes_[index].children.push_back (child);
+  }
+  for (const auto &nested : condition.getConditions ())
+  {
+    const std::size_t child = compile (*nested);
+    nodes_[index].children.push_back (child);
+  }
+  return (index);
+}
+
+//////////////////////////////////////////////////////////////////////////
+template <typename PointT> std::size_t
+pcl::detail::CompiledCondition<PointT>::compile (const ComparisonBase<PointT> &comparison)
+{
+  Node node {};
+  node.kind = Node::COMPARISON;
+  node.comparison = &comparison;
+
+  // Field comparisons of a known type read the field directly, the other ones are evaluated as they are
+  const auto field_comparison = dynamic_cast<const FieldComparison<PointT>*> (&comparison);
+  if (field_comparison && field_comparison->isCapable () && field_comparison->getPointData ())
+  {
+    const std::uint8_t datatype = field_comparison->getPointData ()->getDatatype ();
+    if (datatype >= pcl::PCLPointField::INT8 && datatype <= pcl::PCLPointField::FLOAT64)
+    {
+      node.kind = Node::FIELD;
+      node.datatype = datatype;
+      node.offset = field_comparison->getPointData ()->getOffset ();
+      node.op = field_comparison->getComparisonOperator ();
+      node.value = field_comparison->getCompareValue ();
+    }
+  }
+  nodes_.push_back (node);
+  return (nodes_.size () - 1);
+}
+
+//////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::detail::CompiledCondition<PointT>::evaluate (const pcl::PointCloud<PointT> &cloud, const int *indices,
+                                                  std::size_t count, std::uint8_t *mask) const
+{
+  evaluateNode (0, cloud, indices, count, mask);
+}
+
+//////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::detail::CompiledCondition<PointT>::evaluateNode (std::size_t node, const pcl::PointCloud<PointT> &cloud,
+                                                      const int *indices, std::size_t count,
+                                                      std::uint8_t *mask) const
+{
+  const Node &n = nodes_[node];
+  switch (n.kind)
+  {
+    case Node::AND :
+    case Node::OR :
+    {
+      // Empty conditions are true, otherwise the masks of the children are combined until the result is known
+      const bool is_and = (n.kind == Node::AND);
+      std::fill (mask, mask + count, static_cast<std::uint8_t> (is_and || n.children.empty ()));
+      std::uint8_t child_mask[block_size];
+      for (const std::size_t child : n.children)
+      {
+        evaluateNode (child, cloud, indices, count, child_mask);
+        std::uint8_t any = 0, all = 1;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+          mask[i] = static_cast<std::uint8_t> (is_and ? (mask[i] & child_mask[i]) : (mask[i] | child_mask[i]));
+          any |= mask[i];
+          all &= mask[i];
+        }
+        if ((is_and && !any) || (!is_and && all))
+          return;
+      }
+      return;
+    }
+    case Node::FIELD :
+      switch (n.datatype)
+      {
+        case pcl::PCLPointField::INT8 :
+          compareFieldColumn<std::int8_t> (cloud, indices, count, n.offset, n.op, n.value, mask);
+          return;
+        case pcl::PCLPointField::UINT8 :
+          compareFieldColumn<std::uint8_t> (cloud, indices, count, n.offset, n.op, n.value, mask);
+          return;
+        case pcl::PCLPointField::INT16 :
+          compareFieldColumn<std::int16_t> (cloud, indices, count, n.offset, n.op, n.value, mask);
+          return;
+        case pcl::PCLPointField::UINT16 :
+          compareFieldColumn<std::uint16_t> (cloud, indices, count, n.offset, n.op, n.value, mask);
+          return;
+        case pcl::PCLPointField::INT32 :
+          compareFieldColumn<std::int32_t> (cloud, indices, count, n.offset, n.op, n.value, mask);
+          return;
+        case pcl::PCLPointField::UINT32 :
+          compareFieldColumn<std::uint32_t> (cloud, indices, count, n.offset, n.op, n.value, mask);
+          return;
+        case pcl::PCLPointField::FLOAT32 :
+          compareFieldColumn<float> (cloud, indices, count, n.offset, n.op, n.value, mask);
+          return;
+        default :
+          compareFieldColumn<double> (cloud, indices, count, n.offset, n.op, n.value, mask);
+          return;
+      }
+    case Node::COMPARISON :
+      for (std::size_t i = 0; i < count; ++i)
+        mask[i] = static_cast<std::uint8_t> (n.comparison->evaluate (cloud[indices[i]]));
+      return;
+    case Node::CONDITION :
+      for (std::size_t i = 0; i < count; ++i)
+        mask[i] = static_cast<std::uint8_t> (n.condition->evaluate (cloud[indices[i]]));
+      return;
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::ConditionalRemoval<PointT>::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs ();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
+
+//////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::ConditionalRemoval<PointT>::evaluateCondition (const std::vector<int> &indices,
+                                                    std::vector<std::uint8_t> &passes) const
+{
+  passes.resize (indices.size ());
+  if (!compiled_)
+  {
+#pragma omp parallel for \
+  default(none) \
+  shared(indices, passes) \
+  num_threads(threads_)
+    for (std::ptrdiff_t i = 0; i < static_cast<std::ptrdiff_t> (indices.size ()); ++i)
+      passes[i] = static_cast<std::uint8_t> (condition_->evaluate ((*input_)[indices[i]]));
+    return;
+  }
+
+  // Every block of points is evaluated at once, independently of the other blocks
+  detail::CompiledCondition<PointT> compiled (*condition_);
+  std::size_t block_size = detail::CompiledCondition<PointT>::block_size;
+  std::ptrdiff_t nr_blocks = static_cast<std::ptrdiff_t> ((indices.size () + block_size - 1) / block_size);
+#pragma omp parallel for \
+  default(none) \
+  shared(compiled, block_size, indices, nr_blocks, passes) \
+  num_threads(threads_)
+  for (std::ptrdiff_t b = 0; b < nr_blocks; ++b)
+  {
+    const std::size_t begin = static_cast<std::size_t> (b) * block_size;
+    const std::size_t count = std::min (indices.size () - begin, block_size);
+    compiled.evaluate (*input_, indices.data () + begin, count, passes.data () + begin);
+  }
+}
+
 //////////////////////////////////////////////////////////////////////////
 template <typename PointT> void 
 pcl::ConditionalRemoval<PointT>::setCondition (ConditionBasePtr condition)
@@ -689,7 +942,20 @@ pcl::ConditionalRemoval<PointT>::applyFilter (PointCloud &output)
 
   if (!keep_organized_)
   {
+    // The condition is only evaluated for the finite points
+    std::vector<int> finite_indices;
+    finite_indices.reserve (Filter<PointT>::indices_->size ());
+    for (const auto index : (*Filter<PointT>::indices_))
+    {
+      const PointT& point = (*input_)[index];
+      if (std::isfinite (point.x) && std::isfinite (point.y) && std::isfinite (point.z))
+        finite_indices.push_back (index);
+    }
+    std::vector<std::uint8_t> passes;
+    evaluateCondition (finite_indices, passes);
+
     int nr_p = 0;
+    std::size_t fi = 0;  // fi = finite indices iterator
     for (std::size_t index: (*Filter<PointT>::indices_))
     {
 
@@ -707,7 +973,7 @@ pcl::ConditionalRemoval<PointT>::applyFilter (PointCloud &output)
         continue;
       }
 
-      if (condition_->evaluate (point))
+      if (passes[fi++])
       {
         copyPoint (point, output[nr_p]);
         nr_p++;
@@ -729,6 +995,12 @@ pcl::ConditionalRemoval<PointT>::applyFilter (PointCloud &output)
   {
     std::vector<int> indices = *Filter<PointT>::indices_;
     std::sort (indices.begin (), indices.end ());   //TODO: is this necessary or can we assume the indices to be sorted?
+
+    // Whether each point of the input meets the condition
+    std::vector<std::uint8_t> passes, point_passes (input_->size (), 0);
+    evaluateCondition (indices, passes);
+    for (std::size_t i = 0; i < indices.size (); ++i)
+      point_passes[indices[i]] = passes[i];
     bool removed_p = false;
     std::size_t ci = 0;
     for (std::size_t cp = 0; cp < input_->size (); ++cp)
@@ -745,7 +1017,7 @@ pcl::ConditionalRemoval<PointT>::applyFilter (PointCloud &output)
         // copy all the fields
         copyPoint ((*input_)[cp], output[cp]);
 
-        if (!condition_->evaluate ((*input_)[cp]))
+        if (!point_passes[cp])
         {
           output[cp].getVector4fMap ().setConstant (user_filter_value_);
           removed_p = true;
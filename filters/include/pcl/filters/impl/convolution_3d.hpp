@@ -40,12 +40,16 @@
 #ifndef PCL_FILTERS_CONVOLUTION_3D_IMPL_HPP
 #define PCL_FILTERS_CONVOLUTION_3D_IMPL_HPP
 
+#include <pcl/common/distances.h> // for squaredEuclideanDistance
+#include <pcl/common/utils.h> // for getNumberOfThreads
 #include <pcl/pcl_config.h>
 #include <pcl/point_types.h>
 
+#include <algorithm>
 #include <cmath>
 #include <cstdint>
 #include <limits>
+#include <utility>
 #include <vector>
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -177,6 +181,8 @@ pcl::filters::Convolution3D<PointInT, PointOutT, KernelT>::Convolution3D ()
   , surface_ ()
   , tree_ ()
   , search_radius_ (0)
+  , threads_ (0)
+  , use_grid_search_ (false)
 {}
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -188,8 +194,8 @@ pcl::filters::Convolution3D<PointInT, PointOutT, KernelT>::initCompute ()
     PCL_ERROR ("[pcl::filters::Convlution3D::initCompute] init failed!\n");
     return (false);
   }
-  // Initialize the spatial locator
-  if (!tree_)
+  // Initialize the spatial locator, unless the neighbors are searched in a grid
+  if (!tree_ && !use_grid_search_)
   {
     if (input_->isOrganized ())
       tree_.reset (new pcl::search::OrganizedNeighbor<PointInT> ());
@@ -200,7 +206,8 @@ pcl::filters::Convolution3D<PointInT, PointOutT, KernelT>::initCompute ()
   if (!surface_)
     surface_ = input_;
   // Send the surface dataset to the spatial locator
-  tree_->setInputCloud (surface_);
+  if (tree_)
+    tree_->setInputCloud (surface_);
   // Do a fast check to see if the search parameters are well defined
   if (search_radius_ <= 0.0)
   {
@@ -238,6 +245,22 @@ pcl::filters::Convolution3D<PointInT, PointOutT, KernelT>::convolve (PointCloudO
   output.width = surface_->width;
   output.height = surface_->height;
   output.is_dense = surface_->is_dense;
+
+  if (use_grid_search_)
+  {
+    if (convolveGrid (output))
+      return;
+    // the grid is too fine for the extent of the cloud, fall back to the search method
+    if (!tree_)
+    {
+      if (surface_->isOrganized ())
+        tree_.reset (new pcl::search::OrganizedNeighbor<PointInT> ());
+      else
+        tree_.reset (new pcl::search::KdTree<PointInT> (false));
+      tree_->setInputCloud (surface_);
+    }
+  }
+
   std::vector<int> nn_indices;
   std::vector<float> nn_distances;
 
@@ -245,7 +268,7 @@ pcl::filters::Convolution3D<PointInT, PointOutT, KernelT>::convolve (PointCloudO
   default(none) \
   shared(output) \
   firstprivate(nn_indices, nn_distances) \
-  num_threads(threads_)
+  num_threads(pcl::utils::getNumberOfThreads (threads_))
   for (std::int64_t point_idx = 0; point_idx < static_cast<std::int64_t> (surface_->size ()); ++point_idx)
   {
     const PointInT& point_in = surface_->points [point_idx];
@@ -263,4 +286,128 @@ pcl::filters::Convolution3D<PointInT, PointOutT, KernelT>::convolve (PointCloudO
   }
 }
 
+///////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointOutT, typename KernelT> bool
+pcl::filters::Convolution3D<PointInT, PointOutT, KernelT>::convolveGrid (PointCloudOut& output)
+{
+  const PointCloudIn& surface = *surface_;
+  int nr_points = static_cast<int> (surface.size ());
+
+  // Bounding box of the finite points
+  Eigen::Array3d min_pt = Eigen::Array3d::Constant (std::numeric_limits<double>::max ());
+  Eigen::Array3d max_pt = Eigen::Array3d::Constant (std::numeric_limits<double>::lowest ());
+  for (const auto& point : surface)
+  {
+    if (!isFinite (point))
+      continue;
+    const Eigen::Array3d p = point.getVector3fMap ().template cast<double> ();
+    min_pt = min_pt.min (p);
+    max_pt = max_pt.max (p);
+  }
+
+  if ((min_pt > max_pt).any ())
+  {
+    // no finite point at all
+    for (auto& point : output)
+      kernel_.makeInfinite (point);
+    output.is_dense = false;
+    return (true);
+  }
+
+  // Cells slightly larger than the radius, so that rounding never puts two neighbors
+  // more than one cell apart
+  double inverse_cell_size = 1.0 / (search_radius_ * (1.0 + 1e-6));
+  const Eigen::Array3d extent = ((max_pt - min_pt) * inverse_cell_size).floor () + 1.0;
+  if (extent.prod () > static_cast<double> (std::numeric_limits<std::int64_t>::max () / 2))
+    return (false);
+  std::int64_t dim_x = static_cast<std::int64_t> (extent[0]);
+  std::int64_t dim_y = static_cast<std::int64_t> (extent[1]);
+  std::int64_t dim_z = static_cast<std::int64_t> (extent[2]);
+
+  // Sort the finite points by cell
+  std::vector<std::pair<std::int64_t, int> > binned;
+  binned.reserve (nr_points);
+  for (int i = 0; i < nr_points; ++i)
+  {
+    if (!isFinite (surface[i]))
+      continue;
+    const Eigen::Array3d c = ((surface[i].getVector3fMap ().template cast<double> ().array () - min_pt) * inverse_cell_size).floor ();
+    binned.emplace_back ((static_cast<std::int64_t> (c[2]) * dim_y + static_cast<std::int64_t> (c[1])) * dim_x + static_cast<std::int64_t> (c[0]), i);
+  }
+  std::sort (binned.begin (), binned.end ());
+
+  // Occupied cells, and the range of the sorted points in each of them
+  std::vector<std::int64_t> cell_keys;
+  std::vector<int> cell_starts;
+  std::vector<int> sorted_indices (binned.size ());
+  for (std::size_t i = 0; i < binned.size (); ++i)
+  {
+    if (i == 0 || binned[i].first != binned[i - 1].first)
+    {
+      cell_keys.push_back (binned[i].first);
+      cell_starts.push_back (static_cast<int> (i));
+    }
+    sorted_indices[i] = binned[i].second;
+  }
+  cell_starts.push_back (static_cast<int> (binned.size ()));
+
+  float sqr_radius = static_cast<float> (search_radius_ * search_radius_);
+  bool is_dense = surface.is_dense;
+  std::vector<int> nn_indices;
+  std::vector<float> nn_distances;
+
+#pragma omp parallel for \
+  default(none) \
+  shared(cell_keys, cell_starts, dim_x, dim_y, dim_z, inverse_cell_size, min_pt, nr_points, output, sorted_indices, sqr_radius) \
+  firstprivate(nn_indices, nn_distances) \
+  reduction(&&:is_dense) \
+  schedule(dynamic, 256) \
+  num_threads(pcl::utils::getNumberOfThreads (threads_))
+  for (int point_idx = 0; point_idx < nr_points; ++point_idx)
+  {
+    const PointInT& point_in = (*surface_)[point_idx];
+    PointOutT& point_out = output[point_idx];
+    if (!isFinite (point_in))
+    {
+      kernel_.makeInfinite (point_out);
+      is_dense = false;
+      continue;
+    }
+
+    const Eigen::Array3d c = ((point_in.getVector3fMap ().template cast<double> ().array () - min_pt) * inverse_cell_size).floor ();
+    const std::int64_t cx = static_cast<std::int64_t> (c[0]);
+    const std::int64_t cy = static_cast<std::int64_t> (c[1]);
+    const std::int64_t cz = static_cast<std::int64_t> (c[2]);
+
+    nn_indices.clear ();
+    nn_distances.clear ();
+    for (std::int64_t z = std::max<std::int64_t> (cz - 1, 0); z <= std::min (cz + 1, dim_z - 1); ++z)
+      for (std::int64_t y = std::max<std::int64_t> (cy - 1, 0); y <= std::min (cy + 1, dim_y - 1); ++y)
+      {
+        // the cells of a row of x are consecutive keys
+        const std::int64_t row_key = (z * dim_y + y) * dim_x;
+        auto cell_it = std::lower_bound (cell_keys.begin (), cell_keys.end (), row_key + std::max<std::int64_t> (cx - 1, 0));
+        for (; cell_it != cell_keys.end () && *cell_it <= row_key + std::min (cx + 1, dim_x - 1); ++cell_it)
+        {
+          const std::size_t cell = cell_it - cell_keys.begin ();
+          for (int k = cell_starts[cell]; k < cell_starts[cell + 1]; ++k)
+          {
+            const int idx = sorted_indices[k];
+            const float sqr_distance = squaredEuclideanDistance (point_in, (*surface_)[idx]);
+            if (sqr_distance <= sqr_radius)
+            {
+              nn_indices.push_back (idx);
+              nn_distances.push_back (sqr_distance);
+            }
+          }
+        }
+      }
+
+    // the point itself is always a neighbor
+    point_out = kernel_ (nn_indices, nn_distances);
+  }
+  output.is_dense = is_dense;
+  return (true);
+}
+
 #endif
@@ -43,7 +43,27 @@
 
 #include <pcl/common/eigen.h>
 #include <pcl/filters/covariance_sampling.h>
-#include <list>
+
+#include <algorithm>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+template<typename PointT, typename PointNT> void
+pcl::CovarianceSampling<PointT, PointNT>::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs ();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
 
 ///////////////////////////////////////////////////////////////////////////////
 template<typename PointT, typename PointNT> bool
@@ -103,6 +123,23 @@ pcl::CovarianceSampling<PointT, PointNT>::computeConditionNumber (const Eigen::M
 }
 
 
+///////////////////////////////////////////////////////////////////////////////
+template<typename PointT, typename PointNT> void
+pcl::CovarianceSampling<PointT, PointNT>::computeFeatureMatrix (Eigen::Matrix<double, 6, Eigen::Dynamic> &f_mat)
+{
+  f_mat.resize (6, indices_->size ());
+#pragma omp parallel for \
+  default(none) \
+  shared(f_mat) \
+  num_threads(threads_)
+  for (std::ptrdiff_t p_i = 0; p_i < static_cast<std::ptrdiff_t> (scaled_points_.size ()); ++p_i)
+  {
+    f_mat.template block<3, 1> (0, p_i) = scaled_points_[p_i].cross (
+                                              (*input_normals_)[(*indices_)[p_i]].getNormalVector3fMap ()).template cast<double> ();
+    f_mat.template block<3, 1> (3, p_i) = (*input_normals_)[(*indices_)[p_i]].getNormalVector3fMap ().template cast<double> ();
+  }
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 template<typename PointT, typename PointNT> bool
 pcl::CovarianceSampling<PointT, PointNT>::computeCovarianceMatrix (Eigen::Matrix<double, 6, 6> &covariance_matrix)
@@ -112,13 +149,8 @@ pcl::CovarianceSampling<PointT, PointNT>::computeCovarianceMatrix (Eigen::Matrix
 
   //--- Part A from the paper
   // Set up matrix F
-  Eigen::Matrix<double, 6, Eigen::Dynamic> f_mat = Eigen::Matrix<double, 6, Eigen::Dynamic> (6, indices_->size ());
-  for (std::size_t p_i = 0; p_i < scaled_points_.size (); ++p_i)
-  {
-    f_mat.block<3, 1> (0, p_i) = scaled_points_[p_i].cross (
-                                     (*input_normals_)[(*indices_)[p_i]].getNormalVector3fMap ()).template cast<double> ();
-    f_mat.block<3, 1> (3, p_i) = (*input_normals_)[(*indices_)[p_i]].getNormalVector3fMap ().template cast<double> ();
-  }
+  Eigen::Matrix<double, 6, Eigen::Dynamic> f_mat;
+  computeFeatureMatrix (f_mat);
 
   // Compute the covariance matrix C and its 6 eigenvectors (initially complex, move them to a double matrix)
   covariance_matrix = f_mat * f_mat.transpose ();
@@ -129,51 +161,53 @@ pcl::CovarianceSampling<PointT, PointNT>::computeCovarianceMatrix (Eigen::Matrix
 template<typename PointT, typename PointNT> void
 pcl::CovarianceSampling<PointT, PointNT>::applyFilter (std::vector<int> &sampled_indices)
 {
-  Eigen::Matrix<double, 6, 6> c_mat;
-  // Invokes initCompute()
-  if (!computeCovarianceMatrix (c_mat))
+  if (!initCompute ())
     return;
 
+  // The 6D vectors of the points, both for the covariance matrix and the sampling
+  Eigen::Matrix<double, 6, Eigen::Dynamic> f_mat;
+  computeFeatureMatrix (f_mat);
+  const Eigen::Matrix<double, 6, 6> c_mat = f_mat * f_mat.transpose ();
+
   const Eigen::SelfAdjointEigenSolver<Eigen::Matrix<double, 6, 6> > solver (c_mat);
   const Eigen::Matrix<double, 6, 6> x = solver.eigenvectors ();
 
   //--- Part B from the paper
   /// TODO figure out how to fill the candidate_indices - see subsequent paper paragraphs
-  std::vector<std::size_t> candidate_indices;
-  candidate_indices.resize (indices_->size ());
-  for (std::size_t p_i = 0; p_i < candidate_indices.size (); ++p_i)
-    candidate_indices[p_i] = p_i;
-
-  // Compute the v 6-vectors
-  using Vector6d = Eigen::Matrix<double, 6, 1>;
-  std::vector<Vector6d, Eigen::aligned_allocator<Vector6d> > v;
-  v.resize (candidate_indices.size ());
-  for (std::size_t p_i = 0; p_i < candidate_indices.size (); ++p_i)
+  // All the points are candidates, the v 6-vectors being the columns of F
+  const std::size_t nr_candidates = indices_->size ();
+
+  // Project the v 6-vectors on the eigenvectors
+  Eigen::Matrix<double, 6, Eigen::Dynamic> dots (6, nr_candidates);
+#pragma omp parallel for \
+  default(none) \
+  shared(f_mat, x, dots, nr_candidates) \
+  num_threads(threads_)
+  for (std::ptrdiff_t p_i = 0; p_i < static_cast<std::ptrdiff_t> (nr_candidates); ++p_i)
+    for (int i = 0; i < 6; ++i)
+      dots (i, p_i) = f_mat.template block<6, 1> (0, p_i).dot (x.template block<6, 1> (0, i));
+
+  // Set up the lists to be sorted, in decreasing order of the magnitude of the projections
+  // Note: the sort is stable, so points with equal projections keep their input order
+  std::vector<std::vector<std::pair<int, double> > > L (6);
+#pragma omp parallel for \
+  default(none) \
+  shared(L, dots, nr_candidates) \
+  num_threads(threads_)
+  for (int i = 0; i < 6; ++i)
   {
-    v[p_i].block<3, 1> (0, 0) = scaled_points_[p_i].cross (
-                                  (*input_normals_)[(*indices_)[candidate_indices[p_i]]].getNormalVector3fMap ()).template cast<double> ();
-    v[p_i].block<3, 1> (3, 0) = (*input_normals_)[(*indices_)[candidate_indices[p_i]]].getNormalVector3fMap ().template cast<double> ();
-  }
-
-
-  // Set up the lists to be sorted
-  std::vector<std::list<std::pair<int, double> > > L;
-  L.resize (6);
-
-  for (std::size_t i = 0; i < 6; ++i)
-  {
-    for (std::size_t p_i = 0; p_i < candidate_indices.size (); ++p_i)
-      L[i].push_back (std::make_pair (p_i, std::abs (v[p_i].dot (x.block<6, 1> (0, i)))));
-
-    // Sort in decreasing order
-    L[i].sort (sort_dot_list_function);
+    L[i].resize (nr_candidates);
+    for (std::size_t p_i = 0; p_i < nr_candidates; ++p_i)
+      L[i][p_i] = std::make_pair (static_cast<int> (p_i), std::abs (dots (i, p_i)));
+    std::stable_sort (L[i].begin (), L[i].end (), sort_dot_list_function);
   }
 
-  // Initialize the 6 t's
+  // Initialize the 6 t's, and the position of the first point of each list that may not be sampled yet
   std::vector<double> t (6, 0.0);
+  std::vector<std::size_t> front (6, 0);
 
   sampled_indices.resize (num_samples_);
-  std::vector<bool> point_sampled (candidate_indices.size (), false);
+  std::vector<bool> point_sampled (nr_candidates, false);
   // Now select the actual points
   for (std::size_t sample_i = 0; sample_i < num_samples_; ++sample_i)
   {
@@ -186,24 +220,24 @@ pcl::CovarianceSampling<PointT, PointNT>::applyFilter (std::vector<int> &sampled
     }
 
     // Add the point from the top of the list corresponding to the dimension to the set of samples
-    while (point_sampled [L[min_t_i].front ().first])
-      L[min_t_i].pop_front ();
+    while (point_sampled [L[min_t_i][front[min_t_i]].first])
+      ++front[min_t_i];
 
-    sampled_indices[sample_i] = L[min_t_i].front ().first;
-    point_sampled[L[min_t_i].front ().first] = true;
-    L[min_t_i].pop_front ();
+    const int sample = L[min_t_i][front[min_t_i]++].first;
+    sampled_indices[sample_i] = sample;
+    point_sampled[sample] = true;
 
     // Update the running totals
     for (std::size_t i = 0; i < 6; ++i)
     {
-      double val = v[sampled_indices[sample_i]].dot (x.block<6, 1> (0, i));
+      const double val = dots (i, sample);
       t[i] += val * val;
     }
   }
 
   // Remap the sampled_indices to the input_ cloud
   for (int &sampled_index : sampled_indices)
-    sampled_index = (*indices_)[candidate_indices[sampled_index]];
+    sampled_index = (*indices_)[sampled_index];
 }
 
 
@@ -42,76 +42,108 @@
 #define PCL_FILTERS_IMPL_CROP_BOX_H_
 
 #include <pcl/filters/crop_box.h>
+#include <pcl/filters/impl/block_mask.hpp>
+
+#include <algorithm>
 
 ///////////////////////////////////////////////////////////////////////////////
-template<typename PointT> void
-pcl::CropBox<PointT>::applyFilter (std::vector<int> &indices)
+template<typename PointT> Eigen::Affine3f
+pcl::CropBox<PointT>::getLocalTransform () const
 {
-  indices.resize (input_->size ());
-  removed_indices_->resize (input_->size ());
-  int indices_count = 0;
-  int removed_indices_count = 0;
-
-  Eigen::Affine3f transform = Eigen::Affine3f::Identity ();
+  // Transform the points to world space, translate them and rotate them to the local space of the box
   Eigen::Affine3f inverse_transform = Eigen::Affine3f::Identity ();
-
   if (rotation_ != Eigen::Vector3f::Zero ())
   {
+    Eigen::Affine3f transform;
     pcl::getTransformation (0, 0, 0,
                             rotation_ (0), rotation_ (1), rotation_ (2),
                             transform);
     inverse_transform = transform.inverse ();
   }
+  return (inverse_transform * Eigen::Translation3f (-translation_) * transform_);
+}
 
-  bool transform_matrix_is_identity = transform_.matrix ().isIdentity ();
-  bool translation_is_zero = (translation_ == Eigen::Vector3f::Zero ());
-  bool inverse_transform_matrix_is_identity = inverse_transform.matrix ().isIdentity ();
+///////////////////////////////////////////////////////////////////////////////
+template<typename PointT> void
+pcl::CropBox<PointT>::applyFilter (std::vector<int> &indices)
+{
+  indices.resize (indices_->size ());
+  removed_indices_->resize (indices_->size ());
+  std::size_t indices_count = 0;
+  std::size_t removed_indices_count = 0;
 
-  for (const auto index : *indices_)
+  // The transforms are fused into one, applied to blocks of points at once
+  const Eigen::Matrix4f local_transform = getLocalTransform ().matrix ();
+  detail::XYZBlock block;
+  std::uint8_t valid[detail::filter_block_size], keep[detail::filter_block_size], remove[detail::filter_block_size];
+  for (std::size_t begin = 0; begin < indices_->size (); begin += detail::filter_block_size)
   {
-    if (!input_->is_dense)
-      // Check if the point is invalid
-      if (!isFinite ((*input_)[index]))
-        continue;
-
-    // Get local point
-    PointT local_pt = (*input_)[index];
+    const std::size_t count = std::min (indices_->size () - begin, detail::filter_block_size);
+    const int *block_indices = indices_->data () + begin;
+    detail::loadXYZBlock (*input_, block_indices, count, block);
+    detail::maskInsideBox (block, count, local_transform, min_pt_, max_pt_, keep);
 
-    // Transform point to world space
-    if (!transform_matrix_is_identity)
-      local_pt = pcl::transformPoint<PointT> (local_pt, transform_);
+    // Invalid points are neither kept nor removed
+    if (!input_->is_dense)
+      detail::maskFiniteXYZ (block, count, valid);
+    else
+      std::fill (valid, valid + count, static_cast<std::uint8_t> (1));
 
-    if (!translation_is_zero)
+    for (std::size_t i = 0; i < count; ++i)
     {
-      local_pt.x -= translation_ (0);
-      local_pt.y -= translation_ (1);
-      local_pt.z -= translation_ (2);
+      keep[i] = static_cast<std::uint8_t> ((keep[i] ^ negative_) & valid[i]);
+      remove[i] = static_cast<std::uint8_t> (!keep[i] & valid[i] & extract_removed_indices_);
     }
+    detail::compactBlock (block_indices, count, keep, remove,
+                          indices.data (), indices_count, removed_indices_->data (), removed_indices_count);
+  }
+  indices.resize (indices_count);
+  removed_indices_->resize (removed_indices_count);
+}
 
-    // Transform point to local space of crop box
-    if (!inverse_transform_matrix_is_identity)
-      local_pt = pcl::transformPoint<PointT> (local_pt, inverse_transform);
+///////////////////////////////////////////////////////////////////////////////
+template<typename PointT> void
+pcl::cropBoxes (const pcl::PointCloud<PointT> &cloud,
+                const std::vector<typename pcl::CropBox<PointT>::ConstPtr> &boxes,
+                std::vector<Indices> &indices)
+{
+  // The boxes are applied to each block of points while it is in cache, instead of streaming the whole cloud once
+  // per box
+  const std::size_t nr_boxes = boxes.size ();
+  std::vector<Eigen::Matrix4f, Eigen::aligned_allocator<Eigen::Matrix4f> > local_transforms (nr_boxes);
+  std::vector<std::size_t> indices_count (nr_boxes, 0);
+  indices.resize (nr_boxes);
+  for (std::size_t b = 0; b < nr_boxes; ++b)
+  {
+    local_transforms[b] = boxes[b]->getLocalTransform ().matrix ();
+    indices[b].resize (cloud.size ());
+  }
 
-    // If outside the cropbox
-    if ( (local_pt.x < min_pt_[0] || local_pt.y < min_pt_[1] || local_pt.z < min_pt_[2]) ||
-         (local_pt.x > max_pt_[0] || local_pt.y > max_pt_[1] || local_pt.z > max_pt_[2]))
-    {
-      if (negative_)
-        indices[indices_count++] = index;
-      else if (extract_removed_indices_)
-        (*removed_indices_)[removed_indices_count++] = static_cast<int> (index);
-    }
-    // If inside the cropbox
+  detail::XYZBlock block;
+  int block_indices[detail::filter_block_size];
+  std::uint8_t valid[detail::filter_block_size], keep[detail::filter_block_size];
+  for (std::size_t begin = 0; begin < cloud.size (); begin += detail::filter_block_size)
+  {
+    const std::size_t count = std::min (cloud.size () - begin, detail::filter_block_size);
+    for (std::size_t i = 0; i < count; ++i)
+      block_indices[i] = static_cast<int> (begin + i);
+    detail::loadXYZBlock (cloud, block_indices, count, block);
+    if (!cloud.is_dense)
+      detail::maskFiniteXYZ (block, count, valid);
     else
+      std::fill (valid, valid + count, static_cast<std::uint8_t> (1));
+
+    for (std::size_t b = 0; b < nr_boxes; ++b)
     {
-      if (negative_ && extract_removed_indices_)
-        (*removed_indices_)[removed_indices_count++] = static_cast<int> (index);
-      else if (!negative_) 
-        indices[indices_count++] = index;
+      detail::maskInsideBox (block, count, local_transforms[b], boxes[b]->getMin (), boxes[b]->getMax (), keep);
+      const bool negative = boxes[b]->getNegative ();
+      for (std::size_t i = 0; i < count; ++i)
+        keep[i] = static_cast<std::uint8_t> ((keep[i] ^ negative) & valid[i]);
+      detail::compactBlock (block_indices, count, keep, indices[b].data (), indices_count[b]);
     }
   }
-  indices.resize (indices_count);
-  removed_indices_->resize (removed_indices_count);
+  for (std::size_t b = 0; b < nr_boxes; ++b)
+    indices[b].resize (indices_count[b]);
 }
 
 #define PCL_INSTANTIATE_CropBox(T) template class PCL_EXPORTS pcl::CropBox<T>;
@@ -40,35 +40,57 @@
 
 #include <pcl/filters/crop_hull.h>
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template<typename PointT> void
-pcl::CropHull<PointT>::applyFilter (PointCloud &output)
+pcl::CropHull<PointT>::setNumberOfThreads (unsigned int nr_threads)
 {
-  if (dim_ == 2)
-  {
-    // in this case we are assuming all the points lie in the same plane as the
-    // 2D convex hull, so the choice of projection just changes the
-    // conditioning of the problem: choose to squash the XYZ component of the
-    // hull-points that has least variation - this will also give reasonable
-    // results if the points don't lie exactly in the same plane
-    const Eigen::Vector3f range = getHullCloudRange ();
-    if (range[0] <= range[1] && range[0] <= range[2])
-      applyFilter2D<1,2> (output);
-    else if (range[1] <= range[2] && range[1] <= range[0])
-      applyFilter2D<2,0> (output);
-    else
-      applyFilter2D<0,1> (output);
-  }
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs ();
+#else
+    threads_ = 1;
+#endif
   else
-  {
-    applyFilter3D (output);
-  }
+    threads_ = nr_threads;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointT> void
+pcl::CropHull<PointT>::applyFilter (PointCloud &output)
+{
+  std::vector<std::uint8_t> inside;
+  classifyPoints (inside);
+
+  for (std::size_t index = 0; index < indices_->size (); index++)
+    if (static_cast<bool> (inside[index]) == crop_outside_)
+      output.push_back ((*input_)[(*indices_)[index]]);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template<typename PointT> void
 pcl::CropHull<PointT>::applyFilter (std::vector<int> &indices)
 {
+  std::vector<std::uint8_t> inside;
+  classifyPoints (inside);
+
+  for (std::size_t index = 0; index < indices_->size (); index++)
+    if (static_cast<bool> (inside[index]) == crop_outside_)
+      indices.push_back ((*indices_)[index]);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointT> void
+pcl::CropHull<PointT>::classifyPoints (std::vector<std::uint8_t> &inside)
+{
+  inside.assign (indices_->size (), 0);
   if (dim_ == 2)
   {
     // in this case we are assuming all the points lie in the same plane as the
@@ -78,15 +100,15 @@ pcl::CropHull<PointT>::applyFilter (std::vector<int> &indices)
     // results if the points don't lie exactly in the same plane
     const Eigen::Vector3f range = getHullCloudRange ();
     if (range[0] <= range[1] && range[0] <= range[2])
-      applyFilter2D<1,2> (indices);
+      classifyPoints2D<1,2> (inside);
     else if (range[1] <= range[2] && range[1] <= range[0])
-      applyFilter2D<2,0> (indices);
+      classifyPoints2D<2,0> (inside);
     else
-      applyFilter2D<0,1> (indices);
+      classifyPoints2D<0,1> (inside);
   }
   else
   {
-    applyFilter3D (indices);
+    classifyPoints3D (inside);
   }
 }
 
@@ -118,118 +140,190 @@ pcl::CropHull<PointT>::getHullCloudRange ()
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-template<typename PointT> template<unsigned PlaneDim1, unsigned PlaneDim2> void 
-pcl::CropHull<PointT>::applyFilter2D (PointCloud &output)
+template<typename PointT> void
+pcl::CropHull<PointT>::ItemGrid::build (const std::vector<Eigen::Vector4f, Eigen::aligned_allocator<Eigen::Vector4f> > &boxes, int nr_cells_x, int nr_cells_y)
 {
-  for (std::size_t index = 0; index < indices_->size (); index++)
+  nr_x = std::max (nr_cells_x, 1);
+  nr_y = std::max (nr_cells_y, 1);
+
+  Eigen::Vector4f min_pt (Eigen::Vector4f::Constant (std::numeric_limits<float>::max ()));
+  Eigen::Vector4f max_pt (Eigen::Vector4f::Constant (-std::numeric_limits<float>::max ()));
+  for (const auto &box : boxes)
   {
-    // iterate over polygons faster than points because we expect this data
-    // to be, in general, more cache-local - the point cloud might be huge
-    std::size_t poly;
-    for (poly = 0; poly < hull_polygons_.size (); poly++)
+    min_pt = min_pt.cwiseMin (box);
+    max_pt = max_pt.cwiseMax (box);
+  }
+  min_x = boxes.empty () ? 0.0f : min_pt[0];
+  min_y = boxes.empty () ? 0.0f : min_pt[1];
+  const float size_x = boxes.empty () ? 0.0f : max_pt[2] - min_x;
+  const float size_y = boxes.empty () ? 0.0f : max_pt[3] - min_y;
+  inv_size_x = size_x > 0.0f ? static_cast<float> (nr_x) / size_x : 0.0f;
+  inv_size_y = size_y > 0.0f ? static_cast<float> (nr_y) / size_y : 0.0f;
+
+  // count the items of each cell, then fill them in the order of the items
+  const std::size_t nr_cells = static_cast<std::size_t> (nr_x) * nr_y;
+  offsets.assign (nr_cells + 1, 0);
+  for (int pass = 0; pass < 2; ++pass)
+  {
+    for (std::size_t item = 0; item < boxes.size (); ++item)
     {
-      if (isPointIn2DPolyWithVertIndices<PlaneDim1,PlaneDim2> (
-              (*input_)[(*indices_)[index]], hull_polygons_[poly], *hull_cloud_
-         ))
-      {
-        if (crop_outside_)
-          output.push_back ((*input_)[(*indices_)[index]]);
-        // once a point has tested +ve for being inside one polygon, we can
-        // stop checking the others:
-        break;
-      }
+      const Eigen::Vector4f &box = boxes[item];
+      const int x_end = getBin (box[2], min_x, inv_size_x, nr_x);
+      const int y_end = getBin (box[3], min_y, inv_size_y, nr_y);
+      for (int y = getBin (box[1], min_y, inv_size_y, nr_y); y <= y_end; ++y)
+        for (int x = getBin (box[0], min_x, inv_size_x, nr_x); x <= x_end; ++x)
+        {
+          const std::size_t cell = static_cast<std::size_t> (y) * nr_x + x;
+          if (pass == 0)
+            ++offsets[cell + 1];
+          else
+            items[offsets[cell]++] = static_cast<std::uint32_t> (item);
+        }
+    }
+
+    if (pass == 0)
+    {
+      for (std::size_t cell = 0; cell < nr_cells; ++cell)
+        offsets[cell + 1] += offsets[cell];
+      items.resize (offsets[nr_cells]);
     }
-    // If we're removing points *inside* the hull, only remove points that
-    // haven't been found inside any polygons
-    if (poly == hull_polygons_.size () && !crop_outside_)
-      output.push_back ((*input_)[(*indices_)[index]]);
   }
+  // the fill pass advanced each offset to the start of the next cell
+  for (std::size_t cell = nr_cells; cell > 0; --cell)
+    offsets[cell] = offsets[cell - 1];
+  offsets[0] = 0;
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-template<typename PointT> template<unsigned PlaneDim1, unsigned PlaneDim2> void 
-pcl::CropHull<PointT>::applyFilter2D (std::vector<int> &indices)
+template<typename PointT> template<unsigned PlaneDim1, unsigned PlaneDim2> void
+pcl::CropHull<PointT>::classifyPoints2D (std::vector<std::uint8_t> &inside)
 {
-  // see comments in (PointCloud& output) overload
-  for (std::size_t index = 0; index < indices_->size (); index++)
+  // The ray cast from a point along PlaneDim2 can only cross the edges whose
+  // PlaneDim1 range contains the point, so the edges are binned into slabs
+  // along PlaneDim1. Edges parallel to the ray are never crossed.
+  // Edges are listed polygon after polygon, and so are the items of a slab.
+  struct Edge
+  {
+    std::size_t polygon;
+    std::uint32_t from, to;
+  };
+  std::vector<Edge> edges;
+  std::vector<Eigen::Vector4f, Eigen::aligned_allocator<Eigen::Vector4f> > boxes;
+  for (std::size_t poly = 0; poly < hull_polygons_.size (); poly++)
+  {
+    const std::vector<std::uint32_t> &vertices = hull_polygons_[poly].vertices;
+    for (std::size_t i = 0; i < vertices.size (); i++)
+    {
+      const std::uint32_t from = vertices[i > 0 ? i - 1 : vertices.size () - 1];
+      const float x_from = (*hull_cloud_)[from].getVector3fMap ()[PlaneDim1];
+      const float x_to = (*hull_cloud_)[vertices[i]].getVector3fMap ()[PlaneDim1];
+      if (x_from == x_to)
+        continue;
+      edges.push_back ({poly, from, vertices[i]});
+      boxes.emplace_back (std::min (x_from, x_to), 0.0f, std::max (x_from, x_to), 0.0f);
+    }
+  }
+
+  ItemGrid grid;
+  grid.build (boxes, static_cast<int> (std::min<std::size_t> (std::max<std::size_t> (edges.size (), 1), 1 << 16)), 1);
+
+#pragma omp parallel for \
+  default(none) \
+  shared(inside, edges, grid) \
+  num_threads(threads_)
+  for (std::ptrdiff_t index = 0; index < static_cast<std::ptrdiff_t> (indices_->size ()); index++)
   {
-    std::size_t poly;
-    for (poly = 0; poly < hull_polygons_.size (); poly++)
+    // a point is inside if it is inside any of the polygons, i.e. crosses an
+    // odd number of edges of that polygon
+    const PointT &point = (*input_)[(*indices_)[index]];
+    const std::size_t cell = grid.getCell (point.getVector3fMap ()[PlaneDim1], 0.0f);
+    std::size_t polygon = hull_polygons_.size ();
+    bool in_poly = false;
+    for (std::size_t item = grid.offsets[cell]; item < grid.offsets[cell + 1] && !inside[index]; ++item)
     {
-      if (isPointIn2DPolyWithVertIndices<PlaneDim1,PlaneDim2> (
-              (*input_)[(*indices_)[index]], hull_polygons_[poly], *hull_cloud_
-         ))
+      const Edge &edge = edges[grid.items[item]];
+      if (edge.polygon != polygon)
       {
-        if (crop_outside_)      
-          indices.push_back ((*indices_)[index]);
-        break;
+        inside[index] = in_poly;
+        polygon = edge.polygon;
+        in_poly = false;
       }
+      if (isCrossedBy2DRay<PlaneDim1,PlaneDim2> (point, (*hull_cloud_)[edge.from], (*hull_cloud_)[edge.to]))
+        in_poly = !in_poly;
     }
-    if (poly == hull_polygons_.size () && !crop_outside_)
-      indices.push_back ((*indices_)[index]);
+    inside[index] = inside[index] || in_poly;
   }
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-template<typename PointT> void 
-pcl::CropHull<PointT>::applyFilter3D (PointCloud &output)
+template<typename PointT> void
+pcl::CropHull<PointT>::classifyPoints3D (std::vector<std::uint8_t> &inside)
 {
-  // This algorithm could definitely be sped up using kdtree/octree
-  // information, if that is available!
+  // test ray-crossings for three random rays, and take vote of crossings
+  // counts to determine if each point is inside the hull: the vote avoids
+  // tricky edge and corner cases when rays might fluke through the edge
+  // between two polygons
+  // 'random' rays are arbitrary - basically anything that is less likely to
+  // hit the edge between polygons than coordinate-axis aligned rays would
+  // be.
+  const Eigen::Vector3f rays[3] =
+  {
+    Eigen::Vector3f (0.264882f,  0.688399f, 0.675237f),
+    Eigen::Vector3f (0.0145419f, 0.732901f, 0.68018f),
+    Eigen::Vector3f (0.856514f,  0.508771f, 0.0868081f)
+  };
 
-  for (std::size_t index = 0; index < indices_->size (); index++)
+  // A ray can only cross the polygons whose projection along the ray
+  // contains the projection of its origin, so for each ray the polygons are
+  // binned by their projected bounding box, about one cell per polygon. The
+  // boxes are slightly enlarged, as the intersection test rounds differently.
+  const int nr_cells = std::min (static_cast<int> (std::ceil (std::sqrt (static_cast<double> (hull_polygons_.size ())))), 1024);
+  Eigen::Vector3f axes[3][2];
+  ItemGrid grids[3];
+  for (std::size_t ray = 0; ray < 3; ray++)
   {
-    // test ray-crossings for three random rays, and take vote of crossings
-    // counts to determine if each point is inside the hull: the vote avoids
-    // tricky edge and corner cases when rays might fluke through the edge
-    // between two polygons
-    // 'random' rays are arbitrary - basically anything that is less likely to
-    // hit the edge between polygons than coordinate-axis aligned rays would
-    // be.
-    std::size_t crossings[3] = {0,0,0};
-    Eigen::Vector3f rays[3] = 
-    {
-      Eigen::Vector3f (0.264882f,  0.688399f, 0.675237f),
-      Eigen::Vector3f (0.0145419f, 0.732901f, 0.68018f),
-      Eigen::Vector3f (0.856514f,  0.508771f, 0.0868081f)
-    };
+    axes[ray][0] = rays[ray].unitOrthogonal ();
+    axes[ray][1] = rays[ray].cross (axes[ray][0]).normalized ();
 
+    std::vector<Eigen::Vector4f, Eigen::aligned_allocator<Eigen::Vector4f> > boxes (hull_polygons_.size ());
+    float extent = 0.0f;
     for (std::size_t poly = 0; poly < hull_polygons_.size (); poly++)
-      for (std::size_t ray = 0; ray < 3; ray++)
-        crossings[ray] += rayTriangleIntersect
-          ((*input_)[(*indices_)[index]], rays[ray], hull_polygons_[poly], *hull_cloud_);
-
-    if (crop_outside_ && (crossings[0]&1) + (crossings[1]&1) + (crossings[2]&1) > 1)
-      output.push_back ((*input_)[(*indices_)[index]]);
-    else if (!crop_outside_)
-      output.push_back ((*input_)[(*indices_)[index]]);
+    {
+      Eigen::Vector2f min_pt (Eigen::Vector2f::Constant (std::numeric_limits<float>::max ()));
+      Eigen::Vector2f max_pt (Eigen::Vector2f::Constant (-std::numeric_limits<float>::max ()));
+      for (const auto &vertex : hull_polygons_[poly].vertices)
+      {
+        const Eigen::Vector3f p = (*hull_cloud_)[vertex].getVector3fMap ();
+        const Eigen::Vector2f q (axes[ray][0].dot (p), axes[ray][1].dot (p));
+        min_pt = min_pt.cwiseMin (q);
+        max_pt = max_pt.cwiseMax (q);
+      }
+      boxes[poly] << min_pt, max_pt;
+      extent = std::max (extent, (max_pt.cwiseAbs ().cwiseMax (min_pt.cwiseAbs ())).maxCoeff ());
+    }
+    const float margin = extent * 1e-5f;
+    for (auto &box : boxes)
+      box += Eigen::Vector4f (-margin, -margin, margin, margin);
+    grids[ray].build (boxes, nr_cells, nr_cells);
   }
-}
 
-//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-template<typename PointT> void 
-pcl::CropHull<PointT>::applyFilter3D (std::vector<int> &indices)
-{
-  // see comments in applyFilter3D (PointCloud& output)
-  for (std::size_t index = 0; index < indices_->size (); index++)
+#pragma omp parallel for \
+  default(none) \
+  shared(inside, rays, axes, grids) \
+  num_threads(threads_)
+  for (std::ptrdiff_t index = 0; index < static_cast<std::ptrdiff_t> (indices_->size ()); index++)
   {
+    const PointT &point = (*input_)[(*indices_)[index]];
+    const Eigen::Vector3f p = point.getVector3fMap ();
     std::size_t crossings[3] = {0,0,0};
-    Eigen::Vector3f rays[3] = 
+    for (std::size_t ray = 0; ray < 3; ray++)
     {
-      Eigen::Vector3f(0.264882f,  0.688399f, 0.675237f),
-      Eigen::Vector3f(0.0145419f, 0.732901f, 0.68018f),
-      Eigen::Vector3f(0.856514f,  0.508771f, 0.0868081f)
-    };
-
-    for (std::size_t poly = 0; poly < hull_polygons_.size (); poly++)
-      for (std::size_t ray = 0; ray < 3; ray++)
-        crossings[ray] += rayTriangleIntersect
-          ((*input_)[(*indices_)[index]], rays[ray], hull_polygons_[poly], *hull_cloud_);
-
-    if (crop_outside_ && (crossings[0]&1) + (crossings[1]&1) + (crossings[2]&1) > 1)
-      indices.push_back ((*indices_)[index]);
-    else if (!crop_outside_)
-      indices.push_back ((*indices_)[index]);
+      const ItemGrid &grid = grids[ray];
+      const std::size_t cell = grid.getCell (axes[ray][0].dot (p), axes[ray][1].dot (p));
+      for (std::size_t item = grid.offsets[cell]; item < grid.offsets[cell + 1]; ++item)
+        crossings[ray] += rayTriangleIntersect (point, rays[ray], hull_polygons_[grid.items[item]], *hull_cloud_);
+    }
+    inside[index] = (crossings[0]&1) + (crossings[1]&1) + (crossings[2]&1) > 1;
   }
 }
 
@@ -239,42 +333,46 @@ pcl::CropHull<PointT>::isPointIn2DPolyWithVertIndices (
   const PointT& point, const Vertices& verts, const PointCloud& cloud)
 {
   bool in_poly = false;
-  double x1, x2, y1, y2;
-
-  const int nr_poly_points = static_cast<int>(verts.vertices.size ());
-  double xold = cloud[verts.vertices[nr_poly_points - 1]].getVector3fMap ()[PlaneDim1];
-  double yold = cloud[verts.vertices[nr_poly_points - 1]].getVector3fMap ()[PlaneDim2];
-  for (int i = 0; i < nr_poly_points; i++)
+  const std::size_t nr_poly_points = verts.vertices.size ();
+  for (std::size_t i = 0; i < nr_poly_points; i++)
   {
-    const double xnew = cloud[verts.vertices[i]].getVector3fMap ()[PlaneDim1];
-    const double ynew = cloud[verts.vertices[i]].getVector3fMap ()[PlaneDim2];
-    if (xnew > xold)
-    {
-      x1 = xold;
-      x2 = xnew;
-      y1 = yold;
-      y2 = ynew;
-    }
-    else
-    {
-      x1 = xnew;
-      x2 = xold;
-      y1 = ynew;
-      y2 = yold;
-    }
-
-    if ((xnew < point.getVector3fMap ()[PlaneDim1]) == (point.getVector3fMap ()[PlaneDim1] <= xold) &&
-        (point.getVector3fMap ()[PlaneDim2] - y1) * (x2 - x1) < (y2 - y1) * (point.getVector3fMap ()[PlaneDim1] - x1))
-    {
+    const PointT &from = cloud[verts.vertices[i > 0 ? i - 1 : nr_poly_points - 1]];
+    if (isCrossedBy2DRay<PlaneDim1,PlaneDim2> (point, from, cloud[verts.vertices[i]]))
       in_poly = !in_poly;
-    }
-    xold = xnew;
-    yold = ynew;
   }
 
   return (in_poly);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointT> template<unsigned PlaneDim1, unsigned PlaneDim2> bool
+pcl::CropHull<PointT>::isCrossedBy2DRay (const PointT& point, const PointT& from, const PointT& to)
+{
+  double x1, x2, y1, y2;
+
+  const double xold = from.getVector3fMap ()[PlaneDim1];
+  const double yold = from.getVector3fMap ()[PlaneDim2];
+  const double xnew = to.getVector3fMap ()[PlaneDim1];
+  const double ynew = to.getVector3fMap ()[PlaneDim2];
+  if (xnew > xold)
+  {
+    x1 = xold;
+    x2 = xnew;
+    y1 = yold;
+    y2 = ynew;
+  }
+  else
+  {
+    x1 = xnew;
+    x2 = xold;
+    y1 = ynew;
+    y2 = yold;
+  }
+
+  return ((xnew < point.getVector3fMap ()[PlaneDim1]) == (point.getVector3fMap ()[PlaneDim1] <= xold) &&
+          (point.getVector3fMap ()[PlaneDim2] - y1) * (x2 - x1) < (y2 - y1) * (point.getVector3fMap ()[PlaneDim1] - x1));
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template<typename PointT> bool
 pcl::CropHull<PointT>::rayTriangleIntersect (const PointT& point,
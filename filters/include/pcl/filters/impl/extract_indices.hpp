@@ -42,6 +42,24 @@
 
 #include <pcl/filters/extract_indices.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::ExtractIndices<PointT>::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs ();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT> void
 pcl::ExtractIndices<PointT>::filterDirectly (PointCloudPtr &cloud)
@@ -108,7 +126,7 @@ pcl::ExtractIndices<PointT>::applyFilter (PointCloud &output)
   else
   {
     applyFilterIndices (indices);
-    copyPointCloud (*input_, indices, output);
+    copyPointCloud (*input_, indices, output, threads_);
   }
 }
 
@@ -130,34 +148,15 @@ pcl::ExtractIndices<PointT>::applyFilterIndices (std::vector<int> &indices)
 
     if (extract_removed_indices_)
     {
-      // Set up the full indices set
-      std::vector<int> full_indices (input_->size ());
-      for (int fii = 0; fii < static_cast<int> (full_indices.size ()); ++fii)  // fii = full indices iterator
-        full_indices[fii] = fii;
-
-      // Set up the sorted input indices
-      std::vector<int> sorted_input_indices = *indices_;
-      std::sort (sorted_input_indices.begin (), sorted_input_indices.end ());
-
-      // Store the difference in removed_indices
-      removed_indices_->clear ();
-      set_difference (full_indices.begin (), full_indices.end (), sorted_input_indices.begin (), sorted_input_indices.end (), inserter (*removed_indices_, removed_indices_->begin ()));
+      // A previous inverted run shares the removed indices with the input indices
+      if (removed_indices_ == indices_)
+        removed_indices_.reset (new Indices);
+      detail::complementIndices (input_->size (), *indices_, *removed_indices_, threads_);
     }
   }
   else  // Inverted functionality
   {
-    // Set up the full indices set
-    std::vector<int> full_indices (input_->size ());
-    for (int fii = 0; fii < static_cast<int> (full_indices.size ()); ++fii)  // fii = full indices iterator
-      full_indices[fii] = fii;
-
-    // Set up the sorted input indices
-    std::vector<int> sorted_input_indices = *indices_;
-    std::sort (sorted_input_indices.begin (), sorted_input_indices.end ());
-
-    // Store the difference in indices
-    indices.clear ();
-    set_difference (full_indices.begin (), full_indices.end (), sorted_input_indices.begin (), sorted_input_indices.end (), inserter (indices, indices.begin ()));
+    detail::complementIndices (input_->size (), *indices_, indices, threads_);
 
     if (extract_removed_indices_)
       removed_indices_ = indices_;
@@ -0,0 +1,150 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved
+ */
+
+#ifndef PCL_FILTERS_IMPL_FILTER_PIPELINE_HPP_
+#define PCL_FILTERS_IMPL_FILTER_PIPELINE_HPP_
+
+#include <pcl/filters/filter_pipeline.h>
+#include <pcl/common/io.h> // for pcl::copyPointCloud
+
+#include <algorithm>
+#include <numeric>
+
+///////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::FilterPipeline<PointT>::addFilter (const FilterPtr &filter)
+{
+  Stage stage;
+  stage.indices_filter = dynamic_pointer_cast<FilterIndices<PointT> > (filter);
+  if (!stage.indices_filter)
+    stage.cloud_filter = filter;
+  stages_.push_back (stage);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::FilterPipeline<PointT>::addPredicate (Predicate predicate)
+{
+  if (stages_.empty () || stages_.back ().predicates.empty ())
+    stages_.push_back (Stage ());
+  stages_.back ().predicates.push_back (std::move (predicate));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+template <typename PointT> bool
+pcl::FilterPipeline<PointT>::createsPoints () const
+{
+  return (std::any_of (stages_.cbegin (), stages_.cend (),
+                       [] (const Stage &stage) { return (static_cast<bool> (stage.cloud_filter)); }));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::FilterPipeline<PointT>::extractRemovedIndices (const Indices &indices)
+{
+  // The removed indices are the input indices which are not kept
+  std::vector<bool> kept (input_->size (), false);
+  for (const auto index : indices)
+    kept[index] = true;
+  for (const auto index : *indices_)
+    if (!kept[index])
+      removed_indices_->push_back (index);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::FilterPipeline<PointT>::run (PointCloudConstPtr &cloud, IndicesPtr &indices)
+{
+  cloud = input_;
+  indices = indices_;
+  for (const Stage &stage : stages_)
+  {
+    IndicesPtr next (new Indices);
+    if (!stage.predicates.empty ())
+    {
+      // All the predicates of the pass are evaluated for a point while it is in cache
+      next->reserve (indices->size ());
+      for (const auto index : *indices)
+      {
+        bool keep = true;
+        for (std::size_t p = 0; keep && p < stage.predicates.size (); ++p)
+          keep = stage.predicates[p] (*cloud, index);
+        if (keep)
+          next->push_back (index);
+      }
+      indices = next;
+    }
+    else if (stage.indices_filter)
+    {
+      stage.indices_filter->setInputCloud (cloud);
+      stage.indices_filter->setIndices (indices);
+      stage.indices_filter->filter (*next);
+      indices = next;
+    }
+    else
+    {
+      // The following stages work on the points created by the filter
+      PointCloudPtr points (new PointCloud);
+      stage.cloud_filter->setInputCloud (cloud);
+      stage.cloud_filter->setIndices (indices);
+      stage.cloud_filter->filter (*points);
+      next->resize (points->size ());
+      std::iota (next->begin (), next->end (), 0);
+      cloud = points;
+      indices = next;
+    }
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::FilterPipeline<PointT>::applyFilter (PointCloud &output)
+{
+  PointCloudConstPtr cloud;
+  IndicesPtr indices;
+  run (cloud, indices);
+
+  // Only the final points are copied
+  pcl::copyPointCloud (*cloud, *indices, output);
+
+  removed_indices_->clear ();
+  if (extract_removed_indices_ && cloud == input_)
+    extractRemovedIndices (*indices);
+  else if (extract_removed_indices_)
+    PCL_WARN ("[pcl::%s::applyFilter] A stage creates new points, no removed indices can be extracted.\n", getClassName ().c_str ());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::FilterPipeline<PointT>::filter (Indices &indices)
+{
+  indices.clear ();
+  if (createsPoints ())
+  {
+    PCL_ERROR ("[pcl::%s::filter] A stage creates new points, the result can not be given as indices of the input.\n", getClassName ().c_str ());
+    return;
+  }
+  if (!initCompute ())
+    return;
+
+  PointCloudConstPtr cloud;
+  IndicesPtr result;
+  run (cloud, result);
+  indices = *result;
+
+  removed_indices_->clear ();
+  if (extract_removed_indices_)
+    extractRemovedIndices (indices);
+
+  deinitCompute ();
+}
+
+#define PCL_INSTANTIATE_FilterPipeline(T) template class PCL_EXPORTS pcl::FilterPipeline<T>;
+
+#endif  // PCL_FILTERS_IMPL_FILTER_PIPELINE_HPP_
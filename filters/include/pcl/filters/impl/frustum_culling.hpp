@@ -39,6 +39,9 @@
 #define PCL_FILTERS_IMPL_FRUSTUM_CULLING_HPP_
 
 #include <pcl/filters/frustum_culling.h>
+#include <pcl/filters/impl/block_mask.hpp>
+
+#include <algorithm>
 #include <vector>
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -113,34 +116,30 @@ pcl::FrustumCulling<PointT>::applyFilter (std::vector<int> &indices)
   pl_t (3) = -T.dot (pl_t.head<3> ());
   pl_b (3) = -T.dot (pl_b.head<3> ());
 
-  if (extract_removed_indices_)
-  {
-    removed_indices_->resize (indices_->size ());
-  }
+  Eigen::Matrix<float, 4, 6> planes;
+  planes << pl_l, pl_r, pl_t, pl_b, pl_f, pl_n;
+
+  removed_indices_->resize (indices_->size ());
   indices.resize (indices_->size ());
   std::size_t indices_ctr = 0;
   std::size_t removed_ctr = 0;
-  for (std::size_t i = 0; i < indices_->size (); i++) 
+
+  // The points are tested against the six planes by blocks, the masks being computed without branches
+  detail::XYZBlock block;
+  std::uint8_t keep[detail::filter_block_size], remove[detail::filter_block_size];
+  for (std::size_t begin = 0; begin < indices_->size (); begin += detail::filter_block_size)
   {
-    int idx = indices_->at (i);
-    Eigen::Vector4f pt ((*input_)[idx].x,
-                        (*input_)[idx].y,
-                        (*input_)[idx].z,
-                        1.0f);
-    bool is_in_fov = (pt.dot (pl_l) <= 0) && 
-                     (pt.dot (pl_r) <= 0) &&
-                     (pt.dot (pl_t) <= 0) && 
-                     (pt.dot (pl_b) <= 0) && 
-                     (pt.dot (pl_f) <= 0) &&
-                     (pt.dot (pl_n) <= 0);
-    if (is_in_fov ^ negative_)
-    {
-      indices[indices_ctr++] = idx;
-    }
-    else if (extract_removed_indices_)
+    const std::size_t count = std::min (indices_->size () - begin, detail::filter_block_size);
+    const int *block_indices = indices_->data () + begin;
+    detail::loadXYZBlock (*input_, block_indices, count, block);
+    detail::maskInsidePlanes (block, count, planes, keep);
+    for (std::size_t i = 0; i < count; ++i)
     {
-      (*removed_indices_)[removed_ctr++] = idx;
+      keep[i] = static_cast<std::uint8_t> (keep[i] ^ negative_);
+      remove[i] = static_cast<std::uint8_t> (!keep[i] & extract_removed_indices_);
     }
+    detail::compactBlock (block_indices, count, keep, remove,
+                          indices.data (), indices_ctr, removed_indices_->data (), removed_ctr);
   }
   indices.resize (indices_ctr);
   removed_indices_->resize (removed_ctr);
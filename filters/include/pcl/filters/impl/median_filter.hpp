@@ -42,6 +42,26 @@
 #include <pcl/filters/median_filter.h>
 #include <pcl/common/point_tests.h> // for pcl::isFinite
 
+#include <algorithm>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+template <typename PointT> void
+pcl::MedianFilter<PointT>::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs ();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
+
 template <typename PointT> void
 pcl::MedianFilter<PointT>::applyFilter (PointCloud &output)
 {
@@ -54,36 +74,130 @@ pcl::MedianFilter<PointT>::applyFilter (PointCloud &output)
   // Copy everything from the input cloud to the output cloud (takes care of all the fields)
   copyPointCloud (*input_, output);
 
+  if (depth_resolution_ > 0.0f)
+  {
+    if (slideHistograms (output))
+      return;
+    PCL_WARN ("[pcl::MedianFilter] The depth resolution is too small for the range of the depths, sorting the windows instead\n");
+  }
+  sortWindows (output);
+}
+
+template <typename PointT> void
+pcl::MedianFilter<PointT>::sortWindows (PointCloud &output) const
+{
   int height = static_cast<int> (output.height);
   int width = static_cast<int> (output.width);
-  for (int y = 0; y < height; ++y)
-    for (int x = 0; x < width; ++x)
-      if (pcl::isFinite ((*input_)(x, y)))
+  int half = window_size_ / 2;
+
+  // The rows are independent, every thread reuses its own buffer of depths
+#pragma omp parallel \
+  default(none) \
+  shared(output, height, width, half) \
+  num_threads(threads_)
+  {
+    std::vector<float> vals;
+    vals.reserve ((2 * half + 1) * (2 * half + 1));
+#pragma omp for schedule(static)
+    for (int y = 0; y < height; ++y)
+      for (int x = 0; x < width; ++x)
       {
-        std::vector<float> vals;
-        vals.reserve (window_size_ * window_size_);
-        // Fill in the vector of values with the depths around the interest point
-        for (int y_dev = -window_size_/2; y_dev <= window_size_/2; ++y_dev)
-          for (int x_dev = -window_size_/2; x_dev <= window_size_/2; ++x_dev)
-          {
-            if (x + x_dev >= 0 && x + x_dev < width &&
-                y + y_dev >= 0 && y + y_dev < height &&
-                pcl::isFinite ((*input_)(x+x_dev, y+y_dev)))
-              vals.push_back ((*input_)(x+x_dev, y+y_dev).z);
-          }
-
-        if (vals.empty ())
+        if (!pcl::isFinite ((*input_)(x, y)))
           continue;
 
+        // Fill in the vector of values with the depths around the interest point
+        vals.clear ();
+        const int y_end = std::min (y + half, height - 1), x_end = std::min (x + half, width - 1);
+        for (int y_win = std::max (y - half, 0); y_win <= y_end; ++y_win)
+          for (int x_win = std::max (x - half, 0); x_win <= x_end; ++x_win)
+            if (pcl::isFinite ((*input_)(x_win, y_win)))
+              vals.push_back ((*input_)(x_win, y_win).z);
+
         // The output depth will be the median of all the depths in the window
-        partial_sort (vals.begin (), vals.begin () + vals.size () / 2 + 1, vals.end ());
-        float new_depth = vals[vals.size () / 2];
-        // Do not allow points to move more than the set max_allowed_movement_
-        if (std::abs (new_depth - (*input_)(x, y).z) < max_allowed_movement_)
-          output (x, y).z = new_depth;
-        else
-          output (x, y).z = (*input_)(x, y).z +
-                            max_allowed_movement_ * (new_depth - (*input_)(x, y).z) / std::abs (new_depth - (*input_)(x, y).z);
+        // Note: vals is never empty, it holds at least the depth of the interest point
+        std::nth_element (vals.begin (), vals.begin () + vals.size () / 2, vals.end ());
+        output (x, y).z = moveDepth ((*input_)(x, y).z, vals[vals.size () / 2]);
       }
+  }
 }
 
+template <typename PointT> bool
+pcl::MedianFilter<PointT>::slideHistograms (PointCloud &output) const
+{
+  int height = static_cast<int> (output.height);
+  int width = static_cast<int> (output.width);
+  int half = window_size_ / 2;
+
+  float min_depth = std::numeric_limits<float>::max (), max_depth = -std::numeric_limits<float>::max ();
+  for (const auto &point : *input_)
+    if (pcl::isFinite (point))
+    {
+      min_depth = std::min (min_depth, point.z);
+      max_depth = std::max (max_depth, point.z);
+    }
+  if (min_depth > max_depth)
+    return (true);
+  float resolution = depth_resolution_;
+  if ((max_depth - min_depth) / resolution > static_cast<float> (1 << 24))
+    return (false);
+  int nr_bins = static_cast<int> ((max_depth - min_depth) / resolution + 0.5f) + 1;
+
+  // The histogram bin of every depth, -1 for the invalid points
+  std::vector<int> bins (input_->size ());
+  for (std::size_t i = 0; i < input_->size (); ++i)
+    bins[i] = pcl::isFinite ((*input_)[i]) ? static_cast<int> (((*input_)[i].z - min_depth) / resolution + 0.5f) : -1;
+
+#pragma omp parallel \
+  default(none) \
+  shared(bins, output, height, width, half, nr_bins, min_depth, resolution) \
+  num_threads(threads_)
+  {
+    std::vector<int> histogram (nr_bins, 0);
+#pragma omp for schedule(static)
+    for (int y = 0; y < height; ++y)
+    {
+      // The number of depths in the window, the bin of their median and the number of depths in the lower bins
+      int count = 0, median = 0, below = 0;
+      const int y_begin = std::max (y - half, 0), y_end = std::min (y + half, height - 1);
+      const auto update = [&] (int x, int delta)
+      {
+        for (int y_win = y_begin; y_win <= y_end; ++y_win)
+        {
+          const int bin = bins[y_win * width + x];
+          if (bin < 0)
+            continue;
+          histogram[bin] += delta;
+          count += delta;
+          if (bin < median)
+            below += delta;
+        }
+      };
+
+      // Slide the window along the row, one column in and one column out
+      for (int x = 0; x < std::min (half, width); ++x)
+        update (x, 1);
+      for (int x = 0; x < width; ++x)
+      {
+        if (x + half < width)
+          update (x + half, 1);
+        if (x - half - 1 >= 0)
+          update (x - half - 1, -1);
+        if (bins[y * width + x] < 0)
+          continue;
+
+        // The median moves by few bins between neighboring pixels
+        const int k = count / 2;
+        while (below > k)
+          below -= histogram[--median];
+        while (below + histogram[median] <= k)
+          below += histogram[median++];
+        output (x, y).z = moveDepth ((*input_)(x, y).z, min_depth + static_cast<float> (median) * resolution);
+      }
+
+      // Empty the histogram for the next row
+      for (int x = std::max (width - 1 - half, 0); x < width; ++x)
+        update (x, -1);
+    }
+  }
+  return (true);
+}
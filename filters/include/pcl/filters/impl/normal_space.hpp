@@ -41,7 +41,24 @@
 #include <pcl/filters/normal_space.h>
 
 #include <vector>
-#include <list>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+template<typename PointT, typename NormalT> void
+pcl::NormalSpaceSampling<PointT, NormalT>::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs ();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
 
 ///////////////////////////////////////////////////////////////////////////////
 template<typename PointT, typename NormalT> bool
@@ -62,23 +79,9 @@ pcl::NormalSpaceSampling<PointT, NormalT>::initCompute ()
   return (true);
 }
 
-///////////////////////////////////////////////////////////////////////////////
-template<typename PointT, typename NormalT> bool 
-pcl::NormalSpaceSampling<PointT, NormalT>::isEntireBinSampled (boost::dynamic_bitset<> &array,
-                                                               unsigned int start_index,
-                                                               unsigned int length)
-{
-  bool status = true;
-  for (unsigned int i = start_index; i < start_index + length; i++)
-  {
-    status &= array.test (i);
-  }
-  return status;
-}
-
 ///////////////////////////////////////////////////////////////////////////////
 template<typename PointT, typename NormalT> unsigned int 
-pcl::NormalSpaceSampling<PointT, NormalT>::findBin (const float *normal)
+pcl::NormalSpaceSampling<PointT, NormalT>::findBin (const float *normal) const
 {
   const unsigned ix = static_cast<unsigned> (std::round (0.5f * (binsx_ - 1.f) * (normal[0] + 1.f)));
   const unsigned iy = static_cast<unsigned> (std::round (0.5f * (binsy_ - 1.f) * (normal[1] + 1.f)));
@@ -103,53 +106,44 @@ pcl::NormalSpaceSampling<PointT, NormalT>::applyFilter (std::vector<int> &indice
   
   // Allocate memory for the histogram of normals. Normals will then be sampled from each bin.
   unsigned int n_bins = binsx_ * binsy_ * binsz_;
-  // list<int> holds the indices of points in that bin. Using list to avoid repeated resizing of vectors.
-  // Helps when the point cloud is large.
-  std::vector<std::list <int> > normals_hg;
-  normals_hg.reserve (n_bins);
-  for (unsigned int i = 0; i < n_bins; i++)
-    normals_hg.emplace_back();
-
-  for (const auto index : *indices_)
-  {
-    unsigned int bin_number = findBin ((*input_normals_)[index].normal);
-    normals_hg[bin_number].push_back (index);
-  }
-
 
-  // Setting up random access for the list created above. Maintaining the iterators to individual elements of the list
-  // in a vector. Using vector now as the size of the list is known.
-  std::vector<std::vector<std::list<int>::iterator> > random_access (normals_hg.size ());
-  for (std::size_t i = 0; i < normals_hg.size (); i++)
-  {
-    random_access.emplace_back();
-    random_access[i].resize (normals_hg[i].size ());
-
-    std::size_t j = 0;
-    for (std::list<int>::iterator itr = normals_hg[i].begin (); itr != normals_hg[i].end (); ++itr, ++j)
-      random_access[i][j] = itr;
-  }
-  std::vector<std::size_t> start_index (normals_hg.size ());
+  // Find the bin of every point in parallel
+  std::vector<unsigned int> point_bins (indices_->size ());
+#pragma omp parallel for \
+  default(none) \
+  shared(point_bins) \
+  num_threads(threads_)
+  for (std::ptrdiff_t i = 0; i < static_cast<std::ptrdiff_t> (indices_->size ()); ++i)
+    point_bins[i] = findBin ((*input_normals_)[(*indices_)[i]].normal);
+
+  // Store the indices of the points bin after bin in a single array, the points of a bin keeping their input order.
+  // The points of bin j are binned_indices[start_index[j]] to binned_indices[start_index[j] + bin_size[j] - 1].
+  std::vector<unsigned int> bin_size (n_bins, 0);
+  for (const auto bin : point_bins)
+    ++bin_size[bin];
+  std::vector<std::size_t> start_index (n_bins);
   start_index[0] = 0;
-  std::size_t prev_index = 0;
-  for (std::size_t i = 1; i < normals_hg.size (); i++)
+  for (std::size_t i = 1; i < n_bins; i++)
+    start_index[i] = start_index[i-1] + bin_size[i-1];
+  std::vector<int> binned_indices (indices_->size ());
   {
-    start_index[i] = prev_index + normals_hg[i-1].size ();
-    prev_index = start_index[i];
+    std::vector<std::size_t> next_index = start_index;
+    for (std::size_t i = 0; i < indices_->size (); ++i)
+      binned_indices[next_index[point_bins[i]]++] = (*indices_)[i];
   }
 
   // Maintaining flags to check if a point is sampled
   boost::dynamic_bitset<> is_sampled_flag (input_normals_->size ());
-  // Maintaining flags to check if all points in the bin are sampled
-  boost::dynamic_bitset<> bin_empty_flag (normals_hg.size ());
+  // Maintaining the number of sampled points of each bin, to check if all points in the bin are sampled
+  std::vector<unsigned int> bin_sampled (n_bins, 0);
   unsigned int i = 0;
   while (i < sample_)
   {
     // Iterating through every bin and picking one point at random, until the required number of points are sampled.
-    for (std::size_t j = 0; j < normals_hg.size (); j++)
+    for (std::size_t j = 0; j < n_bins; j++)
     {
-      unsigned int M = static_cast<unsigned int> (normals_hg[j].size ());
-      if (M == 0 || bin_empty_flag.test (j)) // bin_empty_flag(i) is set if all points in that bin are sampled..
+      unsigned int M = bin_size[j];
+      if (M == 0 || bin_sampled[j] == M) // all points in that bin are sampled..
         continue;
 
       unsigned int pos = 0;
@@ -163,14 +157,10 @@ pcl::NormalSpaceSampling<PointT, NormalT>::applyFilter (std::vector<int> &indice
         pos = start_index[j] + random_index;
       } while (is_sampled_flag.test (pos));
 
-      is_sampled_flag.flip (start_index[j] + random_index);
-
-      // Checking if all points in bin j are sampled.
-      if (isEntireBinSampled (is_sampled_flag, start_index[j], static_cast<unsigned int> (normals_hg[j].size ()))) 
-        bin_empty_flag.flip (j);
+      is_sampled_flag.flip (pos);
+      ++bin_sampled[j];
 
-      unsigned int index = *(random_access[j][random_index]);
-      indices[i] = index;
+      indices[i] = binned_indices[pos];
       i++;
       if (i == sample_)
         break;
@@ -41,39 +41,21 @@
 #define PCL_FILTERS_IMPL_PASSTHROUGH_HPP_
 
 #include <pcl/filters/passthrough.h>
+#include <pcl/filters/impl/block_mask.hpp>
+
+#include <algorithm>
+#include <cstring>
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT> void
 pcl::PassThrough<PointT>::applyFilterIndices (std::vector<int> &indices)
 {
-  // The arrays to be used
-  indices.resize (indices_->size ());
-  removed_indices_->resize (indices_->size ());
-  int oii = 0, rii = 0;  // oii = output indices iterator, rii = removed indices iterator
-
-  // Has a field name been specified?
-  if (filter_field_name_.empty ())
+  // Attempt to get the field name's index, if a field name has been specified
+  std::vector<pcl::PCLPointField> fields;
+  int distance_idx = -1;
+  if (!filter_field_name_.empty ())
   {
-    // Only filter for non-finite entries then
-    for (const auto ii : *indices_)  // ii = input index
-    {
-      // Non-finite entries are always passed to removed indices
-      if (!std::isfinite ((*input_)[ii].x) ||
-          !std::isfinite ((*input_)[ii].y) ||
-          !std::isfinite ((*input_)[ii].z))
-      {
-        if (extract_removed_indices_)
-          (*removed_indices_)[rii++] = ii;
-        continue;
-      }
-      indices[oii++] = ii;
-    }
-  }
-  else
-  {
-    // Attempt to get the field name's index
-    std::vector<pcl::PCLPointField> fields;
-    int distance_idx = pcl::getFieldIndex<PointT> (filter_field_name_, fields);
+    distance_idx = pcl::getFieldIndex<PointT> (filter_field_name_, fields);
     if (distance_idx == -1)
     {
       PCL_WARN ("[pcl::%s::applyFilter] Unable to find field name in point type.\n", getClassName ().c_str ());
@@ -81,52 +63,48 @@ pcl::PassThrough<PointT>::applyFilterIndices (std::vector<int> &indices)
       removed_indices_->clear ();
       return;
     }
+  }
 
-    // Filter for non-finite entries and the specified field limits
-    for (const auto ii : *indices_)  // ii = input index
-    {
-      // Non-finite entries are always passed to removed indices
-      if (!std::isfinite ((*input_)[ii].x) ||
-          !std::isfinite ((*input_)[ii].y) ||
-          !std::isfinite ((*input_)[ii].z))
-      {
-        if (extract_removed_indices_)
-          (*removed_indices_)[rii++] = ii;
-        continue;
-      }
+  // The arrays to be used
+  indices.resize (indices_->size ());
+  removed_indices_->resize (indices_->size ());
+  std::size_t oii = 0, rii = 0;  // oii = output indices iterator, rii = removed indices iterator
 
-      // Get the field's value
-      const std::uint8_t* pt_data = reinterpret_cast<const std::uint8_t*> (&(*input_)[ii]);
-      float field_value = 0;
-      memcpy (&field_value, pt_data + fields[distance_idx].offset, sizeof (float));
+  // The points are tested by blocks, the masks being computed without branches
+  detail::XYZBlock block;
+  float field_values[detail::filter_block_size];
+  std::uint8_t keep[detail::filter_block_size], remove[detail::filter_block_size];
+  const float limit_min = filter_limit_min_, limit_max = filter_limit_max_;
+  for (std::size_t begin = 0; begin < indices_->size (); begin += detail::filter_block_size)
+  {
+    const std::size_t count = std::min (indices_->size () - begin, detail::filter_block_size);
+    const int *block_indices = indices_->data () + begin;
+    detail::loadXYZBlock (*input_, block_indices, count, block);
 
-      // Remove NAN/INF/-INF values. We expect passthrough to output clean valid data.
-      if (!std::isfinite (field_value))
-      {
-        if (extract_removed_indices_)
-          (*removed_indices_)[rii++] = ii;
-        continue;
-      }
+    // Non-finite entries are always passed to removed indices
+    detail::maskFiniteXYZ (block, count, keep);
 
-      // Outside of the field limits are passed to removed indices
-      if (!negative_ && (field_value < filter_limit_min_ || field_value > filter_limit_max_))
-      {
-        if (extract_removed_indices_)
-          (*removed_indices_)[rii++] = ii;
-        continue;
-      }
+    if (distance_idx != -1)
+    {
+      // Get the field's values
+      const std::size_t field_offset = fields[distance_idx].offset;
+      for (std::size_t i = 0; i < count; ++i)
+        memcpy (&field_values[i], reinterpret_cast<const std::uint8_t*> (&(*input_)[block_indices[i]]) + field_offset,
+                sizeof (float));
 
-      // Inside of the field limits are passed to removed indices if negative was set
-      if (negative_ && field_value >= filter_limit_min_ && field_value <= filter_limit_max_)
+      // Remove NAN/INF/-INF values, we expect passthrough to output clean valid data. Outside of the field limits
+      // (or inside of them if negative was set) are passed to removed indices
+      for (std::size_t i = 0; i < count; ++i)
       {
-        if (extract_removed_indices_)
-          (*removed_indices_)[rii++] = ii;
-        continue;
+        const float value = field_values[i];
+        const bool inside = (value >= limit_min) & (value <= limit_max);
+        keep[i] = static_cast<std::uint8_t> (keep[i] & detail::isFiniteValue (value) & (inside ^ negative_));
       }
-
-      // Otherwise it was a normal point for output (inlier)
-      indices[oii++] = ii;
     }
+
+    for (std::size_t i = 0; i < count; ++i)
+      remove[i] = static_cast<std::uint8_t> (!keep[i] & extract_removed_indices_);
+    detail::compactBlock (block_indices, count, keep, remove, indices.data (), oii, removed_indices_->data (), rii);
   }
 
   // Resize the output arrays
@@ -41,6 +41,20 @@
 #ifndef PCL_FILTERS_IMPL_PYRAMID_HPP
 #define PCL_FILTERS_IMPL_PYRAMID_HPP
 
+#include <pcl/common/distances.h>
+#include <pcl/common/point_tests.h> // for pcl::isFinite
+#include <pcl/common/utils.h> // for getNumberOfThreads
+#include <pcl/console/print.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 namespace pcl
 {
@@ -48,6 +62,69 @@ namespace pcl
 namespace filters
 {
 
+namespace detail
+{
+  /** \brief Compute the row \a row of the next pyramid level of the \a width x
+    * \a height channel \a src: the channel is smoothed with the separable
+    * \a kernel and subsampled by two, clamping the coordinates at the borders.
+    * The column pass runs over whole rows with AVX or SSE2 instructions.
+    * \param[in] src the channel of the previous level
+    * \param[in] width the width of the previous level
+    * \param[in] height the height of the previous level
+    * \param[in] row the row of the next level
+    * \param[in] kernel the separable smoothing kernel
+    * \param[in] kernel_size the size of the kernel
+    * \param[out] buffer a buffer of \a width floats
+    * \param[out] dst the row of the next level, of width / 2 values
+    */
+  inline void
+  decimateRow (const float* src, int width, int height, int row,
+               const float* kernel, int kernel_size, float* buffer, float* dst)
+  {
+    const int center = kernel_size / 2;
+    const float* rows[5];
+    for (int m = 0; m < kernel_size; ++m)
+      rows[m] = src + std::min (std::max (2 * row + m - center, 0), height - 1) * width;
+
+    // column pass on the whole rows
+    int x = 0;
+#if defined(__AVX__)
+    for (; x + 8 <= width; x += 8)
+    {
+      __m256 sum = _mm256_mul_ps (_mm256_set1_ps (kernel[0]), _mm256_loadu_ps (rows[0] + x));
+      for (int m = 1; m < kernel_size; ++m)
+        sum = _mm256_add_ps (sum, _mm256_mul_ps (_mm256_set1_ps (kernel[m]), _mm256_loadu_ps (rows[m] + x)));
+      _mm256_storeu_ps (buffer + x, sum);
+    }
+#endif
+#if defined(__SSE2__)
+    for (; x + 4 <= width; x += 4)
+    {
+      __m128 sum = _mm_mul_ps (_mm_set1_ps (kernel[0]), _mm_loadu_ps (rows[0] + x));
+      for (int m = 1; m < kernel_size; ++m)
+        sum = _mm_add_ps (sum, _mm_mul_ps (_mm_set1_ps (kernel[m]), _mm_loadu_ps (rows[m] + x)));
+      _mm_storeu_ps (buffer + x, sum);
+    }
+#endif
+    for (; x < width; ++x)
+    {
+      float sum = kernel[0] * rows[0][x];
+      for (int m = 1; m < kernel_size; ++m)
+        sum += kernel[m] * rows[m][x];
+      buffer[x] = sum;
+    }
+
+    // row pass, on the even columns only
+    for (int j = 0; j < width / 2; ++j)
+    {
+      float sum = 0;
+      for (int n = 0; n < kernel_size; ++n)
+        sum += kernel[n] * buffer[std::min (std::max (2 * j + n - center, 0), width - 1)];
+      dst[j] = sum;
+    }
+  }
+} // namespace detail
+
 template <typename PointT> bool
 Pyramid<PointT>::initCompute ()
 {
@@ -78,6 +155,7 @@ Pyramid<PointT>::initCompute ()
     Eigen::VectorXf k (5);
     k << 1.f/16.f, 1.f/4.f, 3.f/8.f, 1.f/4.f, 1.f/16.f;
     kernel_ = k * k.transpose ();
+    separable_kernel_ = k;
     if (threshold_ != std::numeric_limits<float>::infinity ())
       threshold_ *= 2 * threshold_;
 
@@ -87,6 +165,7 @@ Pyramid<PointT>::initCompute ()
     Eigen::VectorXf k (3);
     k << 1.f/4.f, 1.f/2.f, 1.f/4.f;
     kernel_ = k * k.transpose ();
+    separable_kernel_ = k;
     if (threshold_ != std::numeric_limits<float>::infinity ())
       threshold_ *= threshold_;
   }
@@ -94,10 +173,66 @@ Pyramid<PointT>::initCompute ()
   return (true);
 }
 
+template <typename PointT> template <typename Load, typename Store> void
+Pyramid<PointT>::computeDense (std::vector<PointCloudPtr>& output, int nr_channels, Load load, Store store)
+{
+  int width = static_cast<int> (input_->width);
+  int height = static_cast<int> (input_->height);
+  int kernel_size = static_cast<int> (separable_kernel_.size ());
+
+  // The channels of the previous and of the next level, one plane after the other.
+  // Each level is computed from the planes of the previous one, the two buffers being
+  // swapped between levels.
+  std::vector<float> previous (static_cast<std::size_t> (nr_channels) * width * height);
+  std::vector<float> next (static_cast<std::size_t> (nr_channels) * (width / 2) * (height / 2));
+  std::vector<float> values (nr_channels);
+  for (int idx = 0; idx < width * height; ++idx)
+  {
+    load ((*input_)[idx], values.data ());
+    for (int c = 0; c < nr_channels; ++c)
+      previous[c * width * height + idx] = values[c];
+  }
+
+  for (int l = 1; l <= levels_; ++l)
+  {
+    int next_width = width / 2;
+    int next_height = height / 2;
+    output[l].reset (new pcl::PointCloud<PointT> (next_width, next_height));
+    PointCloud<PointT> &next_cloud = *output[l];
+
+#pragma omp parallel \
+  default(none) \
+  shared(height, kernel_size, next, next_cloud, next_height, next_width, nr_channels, previous, store, width) \
+  num_threads(pcl::utils::getNumberOfThreads (threads_))
+    {
+      std::vector<float> buffer (width);
+      std::vector<float> point_values (nr_channels);
+
+#pragma omp for
+      for (int i = 0; i < next_height; ++i)
+      {
+        for (int c = 0; c < nr_channels; ++c)
+          detail::decimateRow (&previous[c * width * height], width, height, i,
+                               separable_kernel_.data (), kernel_size, buffer.data (),
+                               &next[(c * next_height + i) * next_width]);
+        for (int j = 0; j < next_width; ++j)
+        {
+          for (int c = 0; c < nr_channels; ++c)
+            point_values[c] = next[(c * next_height + i) * next_width + j];
+          store (point_values.data (), next_cloud[i * next_width + j]);
+        }
+      }
+    }
+
+    previous.swap (next);
+    width = next_width;
+    height = next_height;
+  }
+}
+
 template <typename PointT> void
 Pyramid<PointT>::compute (std::vector<PointCloudPtr>& output)
 {
-  std::cout << "compute" << std::endl;
   if (!initCompute ())
   {
     PCL_ERROR ("[pcl::%s::compute] initCompute failed!\n", getClassName ().c_str ());
@@ -115,39 +250,15 @@ Pyramid<PointT>::compute (std::vector<PointCloudPtr>& output)
 
   if (input_->is_dense)
   {
-    for (int l = 1; l <= levels_; ++l)
-    {
-      output[l].reset (new pcl::PointCloud<PointT> (output[l-1]->width/2, output[l-1]->height/2));
-      const PointCloud<PointT> &previous = *output[l-1];
-      PointCloud<PointT> &next = *output[l];
-#pragma omp parallel for \
-  default(none)          \
-  shared(next)           \
-  num_threads(threads_)
-      for(int i=0; i < next.height; ++i)
-      {
-        for(int j=0; j < next.width; ++j)
-        {
-          for(int m=0; m < kernel_rows; ++m)
-          {
-            int mm = kernel_rows - 1 - m;
-            for(int n=0; n < kernel_cols; ++n)
-            {
-              int nn = kernel_cols - 1 - n;
-
-              int ii = 2*i + (m - kernel_center_y);
-              int jj = 2*j + (n - kernel_center_x);
-
-              if (ii < 0) ii = 0;
-              if (ii >= previous.height) ii = previous.height - 1;
-              if (jj < 0) jj = 0;
-              if (jj >= previous.width) jj = previous.width - 1;
-              next.at (j,i) += previous.at (jj,ii) * kernel_ (mm,nn);
-            }
-          }
-        }
-      }
-    }
+    computeDense (output, 3,
+                  [] (const PointT& p, float* values)
+                  {
+                    values[0] = p.x; values[1] = p.y; values[2] = p.z;
+                  },
+                  [] (const float* values, PointT& p)
+                  {
+                    p.x = values[0]; p.y = values[1]; p.z = values[2];
+                  });
   }
   else
   {
@@ -158,8 +269,8 @@ Pyramid<PointT>::compute (std::vector<PointCloudPtr>& output)
       PointCloud<PointT> &next = *output[l];
 #pragma omp parallel for \
   default(none)          \
-  shared(next)           \
-  num_threads(threads_)
+  shared(kernel_center_x, kernel_center_y, kernel_cols, kernel_rows, next, previous) \
+  num_threads(pcl::utils::getNumberOfThreads (threads_))
       for(int i=0; i < next.height; ++i)
       {
         for(int j=0; j < next.width; ++j)
@@ -181,7 +292,9 @@ Pyramid<PointT>::compute (std::vector<PointCloudPtr>& output)
                 continue;
               if (pcl::squaredEuclideanDistance (previous.at (2*j,2*i), previous.at (jj,ii)) < threshold_)
               {
-                next.at (j,i) += previous.at (jj,ii).x * kernel_ (mm,nn);
+                next.at (j,i).x += previous.at (jj,ii).x * kernel_ (mm,nn);
+                next.at (j,i).y += previous.at (jj,ii).y * kernel_ (mm,nn);
+                next.at (j,i).z += previous.at (jj,ii).z * kernel_ (mm,nn);
                 weight+= kernel_ (mm,nn);
               }
             }
@@ -191,7 +304,7 @@ Pyramid<PointT>::compute (std::vector<PointCloudPtr>& output)
           else
           {
             weight = 1.f/weight;
-            next.at (j,i)*= weight;
+            next.at (j,i).x*= weight; next.at (j,i).y*= weight; next.at (j,i).z*= weight;
           }
         }
       }
@@ -200,10 +313,9 @@ Pyramid<PointT>::compute (std::vector<PointCloudPtr>& output)
 }
 
 
-template <> void
+template <> inline void
 Pyramid<pcl::PointXYZRGB>::compute (std::vector<Pyramid<pcl::PointXYZRGB>::PointCloudPtr> &output)
 {
-  std::cout << "PointXYZRGB" << std::endl;
   if (!initCompute ())
   {
     PCL_ERROR ("[pcl::%s::compute] initCompute failed!\n", getClassName ().c_str ());
@@ -221,49 +333,19 @@ Pyramid<pcl::PointXYZRGB>::compute (std::vector<Pyramid<pcl::PointXYZRGB>::Point
 
   if (input_->is_dense)
   {
-    for (int l = 1; l <= levels_; ++l)
-    {
-      output[l].reset (new pcl::PointCloud<pcl::PointXYZRGB> (output[l-1]->width/2, output[l-1]->height/2));
-      const PointCloud<pcl::PointXYZRGB> &previous = *output[l-1];
-      PointCloud<pcl::PointXYZRGB> &next = *output[l];
-#pragma omp parallel for \
-  default(none)          \
-  shared(next)           \
-  num_threads(threads_)
-      for(int i=0; i < next.height; ++i)              // rows
-      {
-        for(int j=0; j < next.width; ++j)          // columns
-        {
-          float r = 0, g = 0, b = 0;
-          for(int m=0; m < kernel_rows; ++m)     // kernel rows
-          {
-            int mm = kernel_rows - 1 - m;      // row index of flipped kernel
-            for(int n=0; n < kernel_cols; ++n) // kernel columns
-            {
-              int nn = kernel_cols - 1 - n;  // column index of flipped kernel
-              // index of input signal, used for checking boundary
-              int ii = 2*i + (m - kernel_center_y);
-              int jj = 2*j + (n - kernel_center_x);
-
-              // ignore input samples which are out of bound
-              if (ii < 0) ii = 0;
-              if (ii >= previous.height) ii = previous.height - 1;
-              if (jj < 0) jj = 0;
-              if (jj >= previous.width) jj = previous.width - 1;
-              next.at (j,i).x += previous.at (jj,ii).x * kernel_ (mm,nn);
-              next.at (j,i).y += previous.at (jj,ii).y * kernel_ (mm,nn);
-              next.at (j,i).z += previous.at (jj,ii).z * kernel_ (mm,nn);
-              b += previous.at (jj,ii).b * kernel_ (mm,nn);
-              g += previous.at (jj,ii).g * kernel_ (mm,nn);
-              r += previous.at (jj,ii).r * kernel_ (mm,nn);
-            }
-          }
-          next.at (j,i).b = static_cast<std::uint8_t> (b);
-          next.at (j,i).g = static_cast<std::uint8_t> (g);
-          next.at (j,i).r = static_cast<std::uint8_t> (r);
-        }
-      }
-    }
+    computeDense (output, 6,
+                  [] (const pcl::PointXYZRGB& p, float* values)
+                  {
+                    values[0] = p.x; values[1] = p.y; values[2] = p.z;
+                    values[3] = p.r; values[4] = p.g; values[5] = p.b;
+                  },
+                  [] (const float* values, pcl::PointXYZRGB& p)
+                  {
+                    p.x = values[0]; p.y = values[1]; p.z = values[2];
+                    p.r = static_cast<std::uint8_t> (values[3]);
+                    p.g = static_cast<std::uint8_t> (values[4]);
+                    p.b = static_cast<std::uint8_t> (values[5]);
+                  });
   }
   else
   {
@@ -274,8 +356,8 @@ Pyramid<pcl::PointXYZRGB>::compute (std::vector<Pyramid<pcl::PointXYZRGB>::Point
       PointCloud<pcl::PointXYZRGB> &next = *output[l];
 #pragma omp parallel for \
   default(none)          \
-  shared(next)           \
-  num_threads(threads_)
+  shared(kernel_center_x, kernel_center_y, kernel_cols, kernel_rows, next, previous) \
+  num_threads(pcl::utils::getNumberOfThreads (threads_))
       for(int i=0; i < next.height; ++i)
       {
         for(int j=0; j < next.width; ++j)
@@ -325,10 +407,9 @@ Pyramid<pcl::PointXYZRGB>::compute (std::vector<Pyramid<pcl::PointXYZRGB>::Point
   }
 }
 
-template <> void
+template <> inline void
 Pyramid<pcl::PointXYZRGBA>::compute (std::vector<Pyramid<pcl::PointXYZRGBA>::PointCloudPtr> &output)
 {
-  std::cout << "PointXYZRGBA" << std::endl;
   if (!initCompute ())
   {
     PCL_ERROR ("[pcl::%s::compute] initCompute failed!\n", getClassName ().c_str ());
@@ -346,51 +427,20 @@ Pyramid<pcl::PointXYZRGBA>::compute (std::vector<Pyramid<pcl::PointXYZRGBA>::Poi
 
   if (input_->is_dense)
   {
-    for (int l = 1; l <= levels_; ++l)
-    {
-      output[l].reset (new pcl::PointCloud<pcl::PointXYZRGBA> (output[l-1]->width/2, output[l-1]->height/2));
-      const PointCloud<pcl::PointXYZRGBA> &previous = *output[l-1];
-      PointCloud<pcl::PointXYZRGBA> &next = *output[l];
-#pragma omp parallel for \
-  default(none)          \
-  shared(next)           \
-  num_threads(threads_)
-      for(int i=0; i < next.height; ++i)              // rows
-      {
-        for(int j=0; j < next.width; ++j)          // columns
-        {
-          float r = 0, g = 0, b = 0, a = 0;
-          for(int m=0; m < kernel_rows; ++m)     // kernel rows
-          {
-            int mm = kernel_rows - 1 - m;      // row index of flipped kernel
-            for(int n=0; n < kernel_cols; ++n) // kernel columns
-            {
-              int nn = kernel_cols - 1 - n;  // column index of flipped kernel
-              // index of input signal, used for checking boundary
-              int ii = 2*i + (m - kernel_center_y);
-              int jj = 2*j + (n - kernel_center_x);
-
-              // ignore input samples which are out of bound
-              if (ii < 0) ii = 0;
-              if (ii >= previous.height) ii = previous.height - 1;
-              if (jj < 0) jj = 0;
-              if (jj >= previous.width) jj = previous.width - 1;
-              next.at (j,i).x += previous.at (jj,ii).x * kernel_ (mm,nn);
-              next.at (j,i).y += previous.at (jj,ii).y * kernel_ (mm,nn);
-              next.at (j,i).z += previous.at (jj,ii).z * kernel_ (mm,nn);
-              b += previous.at (jj,ii).b * kernel_ (mm,nn);
-              g += previous.at (jj,ii).g * kernel_ (mm,nn);
-              r += previous.at (jj,ii).r * kernel_ (mm,nn);
-              a += previous.at (jj,ii).a * kernel_ (mm,nn);
-            }
-          }
-          next.at (j,i).b = static_cast<std::uint8_t> (b);
-          next.at (j,i).g = static_cast<std::uint8_t> (g);
-          next.at (j,i).r = static_cast<std::uint8_t> (r);
-          next.at (j,i).a = static_cast<std::uint8_t> (a);
-        }
-      }
-    }
+    computeDense (output, 7,
+                  [] (const pcl::PointXYZRGBA& p, float* values)
+                  {
+                    values[0] = p.x; values[1] = p.y; values[2] = p.z;
+                    values[3] = p.r; values[4] = p.g; values[5] = p.b; values[6] = p.a;
+                  },
+                  [] (const float* values, pcl::PointXYZRGBA& p)
+                  {
+                    p.x = values[0]; p.y = values[1]; p.z = values[2];
+                    p.r = static_cast<std::uint8_t> (values[3]);
+                    p.g = static_cast<std::uint8_t> (values[4]);
+                    p.b = static_cast<std::uint8_t> (values[5]);
+                    p.a = static_cast<std::uint8_t> (values[6]);
+                  });
   }
   else
   {
@@ -401,8 +451,8 @@ Pyramid<pcl::PointXYZRGBA>::compute (std::vector<Pyramid<pcl::PointXYZRGBA>::Poi
       PointCloud<pcl::PointXYZRGBA> &next = *output[l];
 #pragma omp parallel for \
   default(none)          \
-  shared(next)           \
-  num_threads(threads_)
+  shared(kernel_center_x, kernel_center_y, kernel_cols, kernel_rows, next, previous) \
+  num_threads(pcl::utils::getNumberOfThreads (threads_))
       for(int i=0; i < next.height; ++i)
       {
         for(int j=0; j < next.width; ++j)
@@ -454,16 +504,15 @@ Pyramid<pcl::PointXYZRGBA>::compute (std::vector<Pyramid<pcl::PointXYZRGBA>::Poi
   }
 }
 
-template<> void
-Pyramid<pcl::RGB>::nullify (pcl::RGB& p)
+template<> inline void
+Pyramid<pcl::RGB>::nullify (pcl::RGB& p) const
 {
   p.r = 0; p.g = 0; p.b = 0;
 }
 
-template <> void
+template <> inline void
 Pyramid<pcl::RGB>::compute (std::vector<Pyramid<pcl::RGB>::PointCloudPtr> &output)
 {
-  std::cout << "RGB" << std::endl;
   if (!initCompute ())
   {
     PCL_ERROR ("[pcl::%s::compute] initCompute failed!\n", getClassName ().c_str ());
@@ -481,43 +530,17 @@ Pyramid<pcl::RGB>::compute (std::vector<Pyramid<pcl::RGB>::PointCloudPtr> &outpu
 
   if (input_->is_dense)
   {
-    for (int l = 1; l <= levels_; ++l)
-    {
-      output[l].reset (new pcl::PointCloud<pcl::RGB> (output[l-1]->width/2, output[l-1]->height/2));
-      const PointCloud<pcl::RGB> &previous = *output[l-1];
-      PointCloud<pcl::RGB> &next = *output[l];
-#pragma omp parallel for \
-  default(none)          \
-  shared(next)           \
-  num_threads(threads_)
-      for(int i=0; i < next.height; ++i)
-      {
-        for(int j=0; j < next.width; ++j)
-        {
-          float r = 0, g = 0, b = 0;
-          for(int m=0; m < kernel_rows; ++m)
-          {
-            int mm = kernel_rows - 1 - m;
-            for(int n=0; n < kernel_cols; ++n)
-            {
-              int nn = kernel_cols - 1 - n;
-              int ii = 2*i + (m - kernel_center_y);
-              int jj = 2*j + (n - kernel_center_x);
-              if (ii < 0) ii = 0;
-              if (ii >= previous.height) ii = previous.height - 1;
-              if (jj < 0) jj = 0;
-              if (jj >= previous.width) jj = previous.width - 1;
-              b += previous.at (jj,ii).b * kernel_ (mm,nn);
-              g += previous.at (jj,ii).g * kernel_ (mm,nn);
-              r += previous.at (jj,ii).r * kernel_ (mm,nn);
-            }
-          }
-          next.at (j,i).b = static_cast<std::uint8_t> (b);
-          next.at (j,i).g = static_cast<std::uint8_t> (g);
-          next.at (j,i).r = static_cast<std::uint8_t> (r);
-        }
-      }
-    }
+    computeDense (output, 3,
+                  [] (const pcl::RGB& p, float* values)
+                  {
+                    values[0] = p.r; values[1] = p.g; values[2] = p.b;
+                  },
+                  [] (const float* values, pcl::RGB& p)
+                  {
+                    p.r = static_cast<std::uint8_t> (values[0]);
+                    p.g = static_cast<std::uint8_t> (values[1]);
+                    p.b = static_cast<std::uint8_t> (values[2]);
+                  });
   }
   else
   {
@@ -528,8 +551,8 @@ Pyramid<pcl::RGB>::compute (std::vector<Pyramid<pcl::RGB>::PointCloudPtr> &outpu
       PointCloud<pcl::RGB> &next = *output[l];
 #pragma omp parallel for \
   default(none)          \
-  shared(next)           \
-  num_threads(threads_)
+  shared(kernel_center_x, kernel_center_y, kernel_cols, kernel_rows, next, previous) \
+  num_threads(pcl::utils::getNumberOfThreads (threads_))
       for(int i=0; i < next.height; ++i)
       {
         for(int j=0; j < next.width; ++j)
@@ -548,15 +571,11 @@ Pyramid<pcl::RGB>::compute (std::vector<Pyramid<pcl::RGB>::PointCloudPtr> &outpu
               if (ii >= previous.height) ii = previous.height - 1;
               if (jj < 0) jj = 0;
               if (jj >= previous.width) jj = previous.width - 1;
-              if (!isFinite (previous.at (jj,ii)))
-                continue;
-              if (pcl::squaredEuclideanDistance (previous.at (2*j,2*i), previous.at (jj,ii)) < threshold_)
-              {
-                b += previous.at (jj,ii).b * kernel_ (mm,nn);
-                g += previous.at (jj,ii).g * kernel_ (mm,nn);
-                r += previous.at (jj,ii).r * kernel_ (mm,nn);
-                weight+= kernel_ (mm,nn);
-              }
+              // RGB points carry no coordinates, the distance threshold does not apply
+              b += previous.at (jj,ii).b * kernel_ (mm,nn);
+              g += previous.at (jj,ii).g * kernel_ (mm,nn);
+              r += previous.at (jj,ii).r * kernel_ (mm,nn);
+              weight+= kernel_ (mm,nn);
             }
           }
           if (weight == 0)
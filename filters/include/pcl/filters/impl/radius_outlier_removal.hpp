@@ -41,6 +41,66 @@
 #define PCL_FILTERS_IMPL_RADIUS_OUTLIER_REMOVAL_H_
 
 #include <pcl/filters/radius_outlier_removal.h>
+#include <pcl/common/distances.h> // for pcl::squaredEuclideanDistance
+#include <pcl/common/point_tests.h> // for pcl::isFinite
+
+#include <algorithm>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::RadiusOutlierRemoval<PointT>::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs ();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::RadiusOutlierRemoval<PointT>::classifyWindowNeighbors (std::vector<std::uint8_t> &keep) const
+{
+  int width = static_cast<int> (input_->width), height = static_cast<int> (input_->height);
+  int window = static_cast<int> (search_window_);
+  double sqr_radius = search_radius_ * search_radius_;
+
+#pragma omp parallel for \
+  default(none) \
+  shared(keep, height, width, window, sqr_radius) \
+  num_threads(threads_)
+  for (std::ptrdiff_t iii = 0; iii < static_cast<std::ptrdiff_t> (indices_->size ()); ++iii)
+  {
+    // Count the valid points of the window within the radius, stopping once there are more than min_pts_radius_
+    // Note: k includes the query point, invalid points having no neighbors
+    const int index = (*indices_)[iii];
+    const PointT &point = (*input_)[index];
+    int k = 0;
+    if (isFinite (point))
+    {
+      const int row = index / width, col = index % width;
+      const int r_end = std::min (row + window, height - 1), c_end = std::min (col + window, width - 1);
+      for (int r = std::max (row - window, 0); r <= r_end && k <= min_pts_radius_; ++r)
+        for (int c = std::max (col - window, 0); c <= c_end && k <= min_pts_radius_; ++c)
+        {
+          const PointT &neighbor = (*input_)[r * width + c];
+          if (isFinite (neighbor) && squaredEuclideanDistance (point, neighbor) <= sqr_radius)
+            ++k;
+        }
+    }
+
+    // Points having too few neighbors are outliers and are passed to removed indices
+    // Unless negative was set, then it's the opposite condition
+    keep[iii] = !((!negative_ && k <= min_pts_radius_) || (negative_ && k > min_pts_radius_));
+  }
+}
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT> void
@@ -54,99 +114,118 @@ pcl::RadiusOutlierRemoval<PointT>::applyFilterIndices (std::vector<int> &indices
     return;
   }
 
-  // Initialize the search class
-  if (!searcher_)
-  {
-    if (input_->isOrganized ())
-      searcher_.reset (new pcl::search::OrganizedNeighbor<PointT> ());
-    else
-      searcher_.reset (new pcl::search::KdTree<PointT> (false));
-  }
-  searcher_->setInputCloud (input_);
+  // Whether each point is kept, classified in parallel and then compacted in order,
+  // so that the result does not depend on the number of threads
+  std::vector<std::uint8_t> keep (indices_->size ());
 
-  // The arrays to be used
-  std::vector<int> nn_indices (indices_->size ());
-  std::vector<float> nn_dists (indices_->size ());
-  indices.resize (indices_->size ());
-  removed_indices_->resize (indices_->size ());
-  int oii = 0, rii = 0;  // oii = output indices iterator, rii = removed indices iterator
-
-  // If the data is dense => use nearest-k search
-  if (input_->is_dense)
+  if (search_window_ > 0 && input_->isOrganized ())
+    classifyWindowNeighbors (keep);
+  else
   {
-    // Note: k includes the query point, so is always at least 1
-    int mean_k = min_pts_radius_ + 1;
-    double nn_dists_max = search_radius_ * search_radius_;
-
-    for (std::vector<int>::const_iterator it = indices_->begin (); it != indices_->end (); ++it)
+    // Initialize the search class
+    if (!searcher_)
     {
-      // Perform the nearest-k search
-      int k = searcher_->nearestKSearch (*it, mean_k, nn_indices, nn_dists);
+      if (input_->isOrganized ())
+        searcher_.reset (new pcl::search::OrganizedNeighbor<PointT> ());
+      else
+        searcher_.reset (new pcl::search::KdTree<PointT> (false));
+    }
+    searcher_->setInputCloud (input_);
 
-      // Check the number of neighbors
-      // Note: nn_dists is sorted, so check the last item
-      bool chk_neighbors = true;
-      if (k == mean_k)
+    // The arrays to be used
+    std::vector<int> nn_indices;
+    std::vector<float> nn_dists;
+
+    // If the data is dense => use nearest-k search
+    if (input_->is_dense)
+    {
+      // Note: k includes the query point, so is always at least 1
+      int mean_k = min_pts_radius_ + 1;
+      double nn_dists_max = search_radius_ * search_radius_;
+
+#pragma omp parallel for \
+  default(none) \
+  shared(keep, mean_k, nn_dists_max) \
+  firstprivate(nn_indices, nn_dists) \
+  num_threads(threads_)
+      for (std::ptrdiff_t iii = 0; iii < static_cast<std::ptrdiff_t> (indices_->size ()); ++iii)
       {
-        if (negative_)
+        // Perform the nearest-k search
+        int k = searcher_->nearestKSearch ((*indices_)[iii], mean_k, nn_indices, nn_dists);
+
+        // Check the number of neighbors
+        // Note: nn_dists is sorted, so check the last item
+        bool chk_neighbors = true;
+        if (k == mean_k)
         {
-          chk_neighbors = false;
-          if (nn_dists_max < nn_dists[k-1])
+          if (negative_)
+          {
+            chk_neighbors = false;
+            if (nn_dists_max < nn_dists[k-1])
+            {
+              chk_neighbors = true;
+            }
+          }
+          else
           {
             chk_neighbors = true;
+            if (nn_dists_max < nn_dists[k-1])
+            {
+              chk_neighbors = false;
+            }
           }
         }
         else
         {
-          chk_neighbors = true;
-          if (nn_dists_max < nn_dists[k-1])
-          {
+          if (negative_)
+            chk_neighbors = true;
+          else
             chk_neighbors = false;
-          }
         }
+        keep[iii] = chk_neighbors;
       }
-      else
-      {
-        if (negative_)
-          chk_neighbors = true;
-        else
-          chk_neighbors = false;
-      }
-
-      // Points having too few neighbors are outliers and are passed to removed indices
-      // Unless negative was set, then it's the opposite condition
-      if (!chk_neighbors)
+    }
+    // NaN or Inf values could exist => use radius search
+    else
+    {
+      // Only whether there are more than min_pts_radius_ neighbors matters, so the search can stop there
+      int max_nn = min_pts_radius_ + 1;
+
+#pragma omp parallel for \
+  default(none) \
+  shared(keep, max_nn) \
+  firstprivate(nn_indices, nn_dists) \
+  num_threads(threads_)
+      for (std::ptrdiff_t iii = 0; iii < static_cast<std::ptrdiff_t> (indices_->size ()); ++iii)
       {
-        if (extract_removed_indices_)
-          (*removed_indices_)[rii++] = *it;
-        continue;
+        // Perform the radius search, invalid points having no neighbors
+        // Note: k includes the query point, so is always at least 1
+        int k = 0;
+        if (isFinite ((*input_)[(*indices_)[iii]]))
+          k = searcher_->radiusSearch ((*indices_)[iii], search_radius_, nn_indices, nn_dists, max_nn);
+
+        // Points having too few neighbors are outliers and are passed to removed indices
+        // Unless negative was set, then it's the opposite condition
+        keep[iii] = !((!negative_ && k <= min_pts_radius_) || (negative_ && k > min_pts_radius_));
       }
-
-      // Otherwise it was a normal point for output (inlier)
-      indices[oii++] = *it;
     }
   }
-  // NaN or Inf values could exist => use radius search
-  else
+
+  indices.resize (indices_->size ());
+  removed_indices_->resize (indices_->size ());
+  int oii = 0, rii = 0;  // oii = output indices iterator, rii = removed indices iterator
+  for (std::size_t iii = 0; iii < indices_->size (); ++iii)
   {
-    for (std::vector<int>::const_iterator it = indices_->begin (); it != indices_->end (); ++it)
+    // Points having too few neighbors are outliers and are passed to removed indices
+    if (!keep[iii])
     {
-      // Perform the radius search
-      // Note: k includes the query point, so is always at least 1
-      int k = searcher_->radiusSearch (*it, search_radius_, nn_indices, nn_dists);
-
-      // Points having too few neighbors are outliers and are passed to removed indices
-      // Unless negative was set, then it's the opposite condition
-      if ((!negative_ && k <= min_pts_radius_) || (negative_ && k > min_pts_radius_))
-      {
-        if (extract_removed_indices_)
-          (*removed_indices_)[rii++] = *it;
-        continue;
-      }
-
-      // Otherwise it was a normal point for output (inlier)
-      indices[oii++] = *it;
+      if (extract_removed_indices_)
+        (*removed_indices_)[rii++] = (*indices_)[iii];
+      continue;
     }
+
+    // Otherwise it was a normal point for output (inlier)
+    indices[oii++] = (*indices_)[iii];
   }
 
   // Resize the output arrays
@@ -44,6 +44,24 @@
 #include <pcl/common/point_tests.h> // for pcl::isFinite
 #include <pcl/filters/sampling_surface_normal.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+template<typename PointT> void
+pcl::SamplingSurfaceNormal<PointT>::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs ();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 template<typename PointT> void
 pcl::SamplingSurfaceNormal<PointT>::applyFilter (PointCloud &output)
@@ -56,8 +74,23 @@ pcl::SamplingSurfaceNormal<PointT>::applyFilter (PointCloud &output)
   Vector max_vec (3, 1);
   Vector min_vec (3, 1);
   findXYZMaxMin (*input_, max_vec, min_vec);
-  PointCloud data = *input_;
-  partition (data, 0, npts, min_vec, max_vec, indices, output);
+  std::vector<std::pair<int, int> > grids;
+  partition (*input_, 0, static_cast<int> (npts), min_vec, max_vec, indices, grids);
+
+  // The normals of the grids are independent of each other
+  std::vector<Eigen::Vector4f, Eigen::aligned_allocator<Eigen::Vector4f> > normals (grids.size (), Eigen::Vector4f::Zero ());
+  std::vector<float> curvatures (grids.size (), 0.0f);
+#pragma omp parallel for \
+  default(none) \
+  shared(grids, indices, normals, curvatures) \
+  schedule(dynamic, 64) \
+  num_threads(threads_)
+  for (std::ptrdiff_t i = 0; i < static_cast<std::ptrdiff_t> (grids.size ()); ++i)
+    computePartitionNormal (*input_, grids[i].first, grids[i].second, indices, normals[i], curvatures[i]);
+
+  // The random numbers are drawn in the order of the grids
+  for (std::size_t i = 0; i < grids.size (); ++i)
+    samplePartition (*input_, grids[i].first, grids[i].second, indices, normals[i], curvatures[i], output);
   output.height = 1;
   output.width = output.size ();
 }
@@ -86,12 +119,12 @@ template<typename PointT> void
 pcl::SamplingSurfaceNormal<PointT>::partition (
     const PointCloud& cloud, const int first, const int last,
     const Vector min_values, const Vector max_values, 
-    std::vector<int>& indices, PointCloud&  output)
+    std::vector<int>& indices, std::vector<std::pair<int, int> >& grids)
 {
 	const int count (last - first);
   if (count <= static_cast<int> (sample_))
   {
-    samplePartition (cloud, first, last, indices, output);
+    grids.emplace_back (first, last);
     return;
   }
 	int cutDim = 0;
@@ -116,18 +149,18 @@ pcl::SamplingSurfaceNormal<PointT>::partition (
 	rightMinValues[cutDim] = cutVal;
 	
 	// recurse
-	partition (cloud, first, first + leftCount, min_values, leftMaxValues, indices, output);
-	partition (cloud, first + leftCount, last, rightMinValues, max_values, indices, output);
+	partition (cloud, first, first + leftCount, min_values, leftMaxValues, indices, grids);
+	partition (cloud, first + leftCount, last, rightMinValues, max_values, indices, grids);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-template<typename PointT> void 
-pcl::SamplingSurfaceNormal<PointT>::samplePartition (
+template<typename PointT> void
+pcl::SamplingSurfaceNormal<PointT>::computePartitionNormal (
     const PointCloud& data, const int first, const int last,
-    std::vector <int>& indices, PointCloud& output)
+    const std::vector<int>& indices, Eigen::Vector4f& normal, float& curvature)
 {
   pcl::PointCloud <PointT> cloud;
-  
+  cloud.reserve (last - first);
   for (int i = first; i < last; i++)
   {
     PointT pt;
@@ -139,20 +172,28 @@ pcl::SamplingSurfaceNormal<PointT>::samplePartition (
   cloud.height = 1;
   cloud.width = cloud.size ();
 
-  Eigen::Vector4f normal;
-  float curvature = 0;
   //pcl::computePointNormal<PointT> (cloud, normal, curvature);
-
   computeNormal (cloud, normal, curvature);
+}
 
-  for (const auto& point: cloud)
+///////////////////////////////////////////////////////////////////////////////
+template<typename PointT> void 
+pcl::SamplingSurfaceNormal<PointT>::samplePartition (
+    const PointCloud& data, const int first, const int last,
+    const std::vector<int>& indices, const Eigen::Vector4f& normal, float curvature,
+    PointCloud& output)
+{
+  for (int i = first; i < last; i++)
   {
     // TODO: change to Boost random number generators!
     const float r = float (std::rand ()) / float (RAND_MAX);
 
     if (r < ratio_)
     {
-      PointT pt = point;
+      PointT pt;
+      pt.x = data[indices[i]].x;
+      pt.y = data[indices[i]].y;
+      pt.z = data[indices[i]].z;
       pt.normal[0] = normal (0);
       pt.normal[1] = normal (1);
       pt.normal[2] = normal (2);
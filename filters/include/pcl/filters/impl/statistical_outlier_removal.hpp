@@ -41,24 +41,84 @@
 #define PCL_FILTERS_IMPL_STATISTICAL_OUTLIER_REMOVAL_H_
 
 #include <pcl/filters/statistical_outlier_removal.h>
+#include <pcl/common/distances.h> // for pcl::squaredEuclideanDistance
+#include <pcl/common/morton.h> // for pcl::getMortonOrder
+#include <pcl/common/point_tests.h> // for pcl::isFinite
+
+#include <algorithm>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT> void
-pcl::StatisticalOutlierRemoval<PointT>::applyFilterIndices (std::vector<int> &indices)
+pcl::StatisticalOutlierRemoval<PointT>::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs ();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> int
+pcl::StatisticalOutlierRemoval<PointT>::computeWindowMeanDistances (std::vector<float> &distances) const
 {
-  // Initialize the search class
-  if (!searcher_)
+  int width = static_cast<int> (input_->width), height = static_cast<int> (input_->height);
+  int window = static_cast<int> (search_window_);
+  std::vector<float> nn_dists;
+  nn_dists.reserve ((2 * window + 1) * (2 * window + 1));
+
+  int valid_distances = 0;
+#pragma omp parallel for \
+  default(none) \
+  shared(distances, height, width, window) \
+  firstprivate(nn_dists) \
+  reduction(+:valid_distances) \
+  num_threads(threads_)
+  for (std::ptrdiff_t iii = 0; iii < static_cast<std::ptrdiff_t> (indices_->size ()); ++iii)  // iii = input indices iterator
   {
-    if (input_->isOrganized ())
-      searcher_.reset (new pcl::search::OrganizedNeighbor<PointT> ());
-    else
-      searcher_.reset (new pcl::search::KdTree<PointT> (false));
+    const int index = (*indices_)[iii];
+    const PointT &point = (*input_)[index];
+    distances[iii] = 0.0;
+    if (!isFinite (point))
+      continue;
+
+    // The squared distances to the valid points of the window centered on the point
+    const int row = index / width, col = index % width;
+    nn_dists.clear ();
+    for (int r = std::max (row - window, 0); r <= std::min (row + window, height - 1); ++r)
+      for (int c = std::max (col - window, 0); c <= std::min (col + window, width - 1); ++c)
+      {
+        const PointT &neighbor = (*input_)[r * width + c];
+        if ((r != row || c != col) && isFinite (neighbor))
+          nn_dists.push_back (squaredEuclideanDistance (point, neighbor));
+      }
+    if (nn_dists.empty ())
+      continue;
+
+    // Calculate the mean distance to its nearest neighbors in the window
+    const std::size_t k = std::min (nn_dists.size (), static_cast<std::size_t> (mean_k_));
+    std::nth_element (nn_dists.begin (), nn_dists.begin () + (k - 1), nn_dists.end ());
+    double dist_sum = 0.0;
+    for (std::size_t j = 0; j < k; ++j)
+      dist_sum += sqrt (nn_dists[j]);
+    distances[iii] = static_cast<float> (dist_sum / static_cast<double> (k));
+    valid_distances++;
   }
-  searcher_->setInputCloud (input_);
+  return (valid_distances);
+}
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::StatisticalOutlierRemoval<PointT>::applyFilterIndices (std::vector<int> &indices)
+{
   // The arrays to be used
-  std::vector<int> nn_indices (mean_k_);
-  std::vector<float> nn_dists (mean_k_);
   std::vector<float> distances (indices_->size ());
   indices.resize (indices_->size ());
   removed_indices_->resize (indices_->size ());
@@ -66,30 +126,61 @@ pcl::StatisticalOutlierRemoval<PointT>::applyFilterIndices (std::vector<int> &in
 
   // First pass: Compute the mean distances for all points with respect to their k nearest neighbors
   int valid_distances = 0;
-  for (int iii = 0; iii < static_cast<int> (indices_->size ()); ++iii)  // iii = input indices iterator
+  if (search_window_ > 0 && input_->isOrganized ())
+    valid_distances = computeWindowMeanDistances (distances);
+  else
   {
-    if (!std::isfinite ((*input_)[(*indices_)[iii]].x) ||
-        !std::isfinite ((*input_)[(*indices_)[iii]].y) ||
-        !std::isfinite ((*input_)[(*indices_)[iii]].z))
+    // Initialize the search class
+    if (!searcher_)
     {
-      distances[iii] = 0.0;
-      continue;
+      if (input_->isOrganized ())
+        searcher_.reset (new pcl::search::OrganizedNeighbor<PointT> ());
+      else
+        searcher_.reset (new pcl::search::KdTree<PointT> (false));
     }
+    searcher_->setInputCloud (input_);
+
+    std::vector<int> nn_indices (mean_k_);
+    std::vector<float> nn_dists (mean_k_);
 
-    // Perform the nearest k search
-    if (searcher_->nearestKSearch ((*indices_)[iii], mean_k_ + 1, nn_indices, nn_dists) == 0)
+    // The positions in the indices in search order
+    Indices query_order;
+    if (spatial_query_order_)
+      getMortonOrder (*input_, *indices_, query_order, threads_);
+
+    // Every distance only depends on its point, so that the result does not depend on the number of threads
+#pragma omp parallel for \
+  default(none) \
+  shared(distances, query_order) \
+  firstprivate(nn_indices, nn_dists) \
+  reduction(+:valid_distances) \
+  num_threads(threads_)
+    for (std::ptrdiff_t qqq = 0; qqq < static_cast<std::ptrdiff_t> (indices_->size ()); ++qqq)  // qqq = query iterator
     {
-      distances[iii] = 0.0;
-      PCL_WARN ("[pcl::%s::applyFilter] Searching for the closest %d neighbors failed.\n", getClassName ().c_str (), mean_k_);
-      continue;
-    }
+      const std::ptrdiff_t iii = query_order.empty () ? qqq : query_order[qqq];  // iii = input indices iterator
+      if (!std::isfinite ((*input_)[(*indices_)[iii]].x) ||
+          !std::isfinite ((*input_)[(*indices_)[iii]].y) ||
+          !std::isfinite ((*input_)[(*indices_)[iii]].z))
+      {
+        distances[iii] = 0.0;
+        continue;
+      }
 
-    // Calculate the mean distance to its neighbors
-    double dist_sum = 0.0;
-    for (int k = 1; k < mean_k_ + 1; ++k)  // k = 0 is the query point
-      dist_sum += sqrt (nn_dists[k]);
-    distances[iii] = static_cast<float> (dist_sum / mean_k_);
-    valid_distances++;
+      // Perform the nearest k search
+      if (searcher_->nearestKSearch ((*indices_)[iii], mean_k_ + 1, nn_indices, nn_dists) == 0)
+      {
+        distances[iii] = 0.0;
+        PCL_WARN ("[pcl::%s::applyFilter] Searching for the closest %d neighbors failed.\n", getClassName ().c_str (), mean_k_);
+        continue;
+      }
+
+      // Calculate the mean distance to its neighbors
+      double dist_sum = 0.0;
+      for (int k = 1; k < mean_k_ + 1; ++k)  // k = 0 is the query point
+        dist_sum += sqrt (nn_dists[k]);
+      distances[iii] = static_cast<float> (dist_sum / mean_k_);
+      valid_distances++;
+    }
   }
 
   // Estimate the mean and the standard deviation of the distance vector
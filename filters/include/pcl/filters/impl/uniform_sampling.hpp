@@ -40,6 +40,27 @@
 
 #include <pcl/common/common.h>
 #include <pcl/filters/uniform_sampling.h>
+#include <pcl/filters/impl/voxel_hash_map.hpp>
+
+#include <cstdint>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::UniformSampling<PointT>::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs ();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT> void
@@ -79,63 +100,93 @@ pcl::UniformSampling<PointT>::applyFilter (PointCloud &output)
   // Set up the division multiplier
   divb_mul_ = Eigen::Vector4i (1, div_b_[0], div_b_[0] * div_b_[1], 0);
 
-  removed_indices_->clear();
-  // First pass: build a set of leaves with the point index closest to the leaf center
-  for (std::size_t cp = 0; cp < indices_->size (); ++cp)
+  // The voxels are numbered with 64 bit keys, which do not overflow for large grids
+  std::uint64_t key_mul_y = static_cast<std::uint64_t> (div_b_[0]);
+  std::uint64_t key_mul_z = static_cast<std::uint64_t> (div_b_[0]) * static_cast<std::uint64_t> (div_b_[1]);
+  if (static_cast<double> (div_b_[0]) * static_cast<double> (div_b_[1]) * static_cast<double> (div_b_[2]) >=
+      static_cast<double> (std::numeric_limits<std::int64_t>::max ()))
   {
+    PCL_WARN ("[pcl::%s::applyFilter] Leaf size is too small for the input dataset. Integer indices would overflow.\n", getClassName ().c_str ());
+    output = *input_;
+    return;
+  }
+
+  // First pass: compute the key of the voxel of every point, invalid points having none
+  std::vector<std::uint64_t> keys (indices_->size ());
+#pragma omp parallel for \
+  default(none) \
+  shared(keys, key_mul_y, key_mul_z) \
+  num_threads(threads_)
+  for (std::ptrdiff_t cp = 0; cp < static_cast<std::ptrdiff_t> (indices_->size ()); ++cp)
+  {
+    const PointT &point = (*input_)[(*indices_)[cp]];
     if (!input_->is_dense)
     {
       // Check if the point is invalid
-      if (!std::isfinite ((*input_)[(*indices_)[cp]].x) || 
-          !std::isfinite ((*input_)[(*indices_)[cp]].y) || 
-          !std::isfinite ((*input_)[(*indices_)[cp]].z))
+      if (!std::isfinite (point.x) || !std::isfinite (point.y) || !std::isfinite (point.z))
       {
-        if (extract_removed_indices_)
-          removed_indices_->push_back ((*indices_)[cp]);
+        keys[cp] = detail::invalidVoxelKey ();
         continue;
       }
     }
 
+    const std::int64_t i = static_cast<std::int64_t> (std::floor (point.x * inverse_leaf_size_[0])) - min_b_[0];
+    const std::int64_t j = static_cast<std::int64_t> (std::floor (point.y * inverse_leaf_size_[1])) - min_b_[1];
+    const std::int64_t k = static_cast<std::int64_t> (std::floor (point.z * inverse_leaf_size_[2])) - min_b_[2];
+    keys[cp] = static_cast<std::uint64_t> (i) + static_cast<std::uint64_t> (j) * key_mul_y +
+               static_cast<std::uint64_t> (k) * key_mul_z;
+  }
+
+  // Second pass: group the points by voxel, every thread hashing the voxels of its shard
+  detail::VoxelGroups groups;
+  detail::groupVoxelsInShards (keys, threads_, groups);
+
+  // Third pass: keep the point of every voxel which is the closest to the leaf center
+  // Note: ties are resolved as if the points had been processed in order of their indices
+  std::vector<unsigned int> selected (groups.size ());
+#pragma omp parallel for \
+  default(none) \
+  shared(groups, selected) \
+  num_threads(threads_)
+  for (std::ptrdiff_t v = 0; v < static_cast<std::ptrdiff_t> (groups.size ()); ++v)
+  {
+    unsigned int best = groups.positions[groups.begins[v]];
+    const PointT &first = (*input_)[(*indices_)[best]];
     Eigen::Vector4i ijk = Eigen::Vector4i::Zero ();
-    ijk[0] = static_cast<int> (std::floor ((*input_)[(*indices_)[cp]].x * inverse_leaf_size_[0]));
-    ijk[1] = static_cast<int> (std::floor ((*input_)[(*indices_)[cp]].y * inverse_leaf_size_[1]));
-    ijk[2] = static_cast<int> (std::floor ((*input_)[(*indices_)[cp]].z * inverse_leaf_size_[2]));
-
-    // Compute the leaf index
-    int idx = (ijk - min_b_).dot (divb_mul_);
-    Leaf& leaf = leaves_[idx];
-    // First time we initialize the index
-    if (leaf.idx == -1)
+    ijk[0] = static_cast<int> (std::floor (first.x * inverse_leaf_size_[0]));
+    ijk[1] = static_cast<int> (std::floor (first.y * inverse_leaf_size_[1]));
+    ijk[2] = static_cast<int> (std::floor (first.z * inverse_leaf_size_[2]));
+    float diff_best = (first.getVector4fMap () - ijk.cast<float> ()).squaredNorm ();
+    for (unsigned int p = groups.begins[v] + 1; p < groups.begins[v + 1]; ++p)
     {
-      leaf.idx = (*indices_)[cp];
-      continue;
+      // Check to see if this point is closer to the leaf center than the previous one we saved
+      const unsigned int cp = groups.positions[p];
+      float diff_cur = ((*input_)[(*indices_)[cp]].getVector4fMap () - ijk.cast<float> ()).squaredNorm ();
+      if (diff_cur < diff_best)
+      {
+        best = cp;
+        diff_best = diff_cur;
+      }
     }
+    selected[v] = best;
+  }
 
-    // Check to see if this point is closer to the leaf center than the previous one we saved
-    float diff_cur   = ((*input_)[(*indices_)[cp]].getVector4fMap () - ijk.cast<float> ()).squaredNorm ();
-    float diff_prev  = ((*input_)[leaf.idx].getVector4fMap ()        - ijk.cast<float> ()).squaredNorm ();
+  // Copy the selected points, and extract the other ones as removed
+  output.resize (selected.size ());
+  for (std::size_t v = 0; v < selected.size (); ++v)
+    output[v] = (*input_)[(*indices_)[selected[v]]];
+  output.width = output.size ();
 
-    // If current point is closer, copy its index instead
-    if (diff_cur < diff_prev)
-    {
-      if (extract_removed_indices_)
-        removed_indices_->push_back (leaf.idx);
-      leaf.idx = (*indices_)[cp];
-    }
-    else
-    {
-      if (extract_removed_indices_)
+  removed_indices_->clear ();
+  if (extract_removed_indices_)
+  {
+    std::vector<bool> kept (indices_->size (), false);
+    for (const auto cp : selected)
+      kept[cp] = true;
+    for (std::size_t cp = 0; cp < indices_->size (); ++cp)
+      if (!kept[cp])
         removed_indices_->push_back ((*indices_)[cp]);
-    }
   }
-
-  // Second pass: go over all leaves and copy data
-  output.resize (leaves_.size ());
-  int cp = 0;
-
-  for (const auto& leaf : leaves_)
-    output[cp++] = (*input_)[leaf.second.idx];
-  output.width = output.size ();
 }
 
 #define PCL_INSTANTIATE_UniformSampling(T) template class PCL_EXPORTS pcl::UniformSampling<T>;
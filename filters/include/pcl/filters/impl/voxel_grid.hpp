@@ -42,7 +42,15 @@
 #include <pcl/common/common.h>
 #include <pcl/common/io.h>
 #include <pcl/filters/voxel_grid.h>
-#include  <boost/sort/spreadsort/integer_sort.hpp>
+#include <pcl/filters/impl/voxel_hash_map.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 ///////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT> void
@@ -209,6 +217,203 @@ struct cloud_point_index_idx
   bool operator < (const cloud_point_index_idx &p) const { return (idx < p.idx); }
 };
 
+namespace pcl
+{
+  namespace detail
+  {
+    /** \brief Compute the leaf index of every point, in parallel.
+      * The points are split in \a nr_threads contiguous chunks, whose results are concatenated in order:
+      * \a index_vector is the same as if the points had been processed one after the other.
+      * \param[in] nr_points the number of points to process
+      * \param[in] nr_threads the number of threads to use
+      * \param[in] get_index a function (i, idx, cloud_point_index) setting the leaf index of the i-th
+      * point and its index in the input cloud, and returning false if the point has to be skipped
+      * \param[out] index_vector the leaf indices and point indices of the points which are not skipped
+      */
+    template <typename IndexFunction> void
+    computeVoxelIndices (std::size_t nr_points, unsigned int nr_threads, const IndexFunction &get_index,
+                         std::vector<cloud_point_index_idx> &index_vector)
+    {
+      index_vector.clear ();
+      std::size_t nr_chunks = std::min<std::size_t> (std::max (nr_threads, 1u), nr_points / 1024 + 1);
+      if (nr_chunks == 1)
+      {
+        index_vector.reserve (nr_points);
+        unsigned int idx, cloud_point_index;
+        for (std::size_t i = 0; i < nr_points; ++i)
+          if (get_index (i, idx, cloud_point_index))
+            index_vector.emplace_back (idx, cloud_point_index);
+        return;
+      }
+
+      std::vector<std::vector<cloud_point_index_idx> > chunks (nr_chunks);
+#pragma omp parallel for \
+  default(none) \
+  shared(chunks, get_index, nr_chunks, nr_points) \
+  num_threads(nr_threads)
+      for (std::ptrdiff_t c = 0; c < static_cast<std::ptrdiff_t> (nr_chunks); ++c)
+      {
+        std::size_t begin = nr_points * c / nr_chunks, end = nr_points * (c + 1) / nr_chunks;
+        chunks[c].reserve (end - begin);
+        unsigned int idx, cloud_point_index;
+        for (std::size_t i = begin; i < end; ++i)
+          if (get_index (i, idx, cloud_point_index))
+            chunks[c].emplace_back (idx, cloud_point_index);
+      }
+
+      std::vector<std::size_t> offsets (nr_chunks + 1, 0);
+      for (std::size_t c = 0; c < nr_chunks; ++c)
+        offsets[c + 1] = offsets[c] + chunks[c].size ();
+      index_vector.resize (offsets[nr_chunks]);
+#pragma omp parallel for \
+  default(none) \
+  shared(chunks, index_vector, nr_chunks, offsets) \
+  num_threads(nr_threads)
+      for (std::ptrdiff_t c = 0; c < static_cast<std::ptrdiff_t> (nr_chunks); ++c)
+        std::copy (chunks[c].cbegin (), chunks[c].cend (), index_vector.begin () + offsets[c]);
+    }
+
+    /** \brief Sort the points by leaf index with a parallel LSD radix sort.
+      * The sort is stable: the points of a leaf keep their order, so that the result (and the order in
+      * which the centroids are accumulated) does not depend on the number of threads.
+      * \param[in,out] index_vector the leaf indices and point indices to sort
+      * \param[in] nr_threads the number of threads to use
+      */
+    inline void
+    sortVoxelIndices (std::vector<cloud_point_index_idx> &index_vector, unsigned int nr_threads)
+    {
+      std::size_t nr_elements = index_vector.size ();
+      if (nr_elements < 2)
+        return;
+      std::size_t nr_chunks = std::min<std::size_t> (std::max (nr_threads, 1u), nr_elements / 1024 + 1);
+      unsigned int digit_bits = 8;
+      std::size_t nr_buckets = std::size_t (1) << digit_bits;
+
+      // Only sort on the digits which are used by the largest index
+      std::vector<unsigned int> chunk_max (nr_chunks, 0);
+#pragma omp parallel for \
+  default(none) \
+  shared(chunk_max, index_vector, nr_chunks, nr_elements) \
+  num_threads(nr_threads)
+      for (std::ptrdiff_t c = 0; c < static_cast<std::ptrdiff_t> (nr_chunks); ++c)
+      {
+        std::size_t begin = nr_elements * c / nr_chunks, end = nr_elements * (c + 1) / nr_chunks;
+        for (std::size_t i = begin; i < end; ++i)
+          chunk_max[c] = std::max (chunk_max[c], index_vector[i].idx);
+      }
+      const unsigned int max_idx = *std::max_element (chunk_max.cbegin (), chunk_max.cend ());
+
+      std::vector<cloud_point_index_idx> buffer (nr_elements);
+      std::vector<std::size_t> offsets (nr_chunks * nr_buckets);
+      for (unsigned int shift = 0; shift < 32 && (max_idx >> shift) != 0; shift += digit_bits)
+      {
+        // Count the digits of every chunk
+        std::fill (offsets.begin (), offsets.end (), 0);
+#pragma omp parallel for \
+  default(none) \
+  shared(index_vector, nr_buckets, nr_chunks, nr_elements, offsets, shift) \
+  num_threads(nr_threads)
+        for (std::ptrdiff_t c = 0; c < static_cast<std::ptrdiff_t> (nr_chunks); ++c)
+        {
+          std::size_t begin = nr_elements * c / nr_chunks, end = nr_elements * (c + 1) / nr_chunks;
+          std::size_t *counts = &offsets[c * nr_buckets];
+          for (std::size_t i = begin; i < end; ++i)
+            ++counts[(index_vector[i].idx >> shift) & (nr_buckets - 1)];
+        }
+
+        // The elements of a chunk go after the ones of the previous chunks with the same digit
+        std::size_t position = 0;
+        for (std::size_t digit = 0; digit < nr_buckets; ++digit)
+          for (std::size_t c = 0; c < nr_chunks; ++c)
+          {
+            const std::size_t count = offsets[c * nr_buckets + digit];
+            offsets[c * nr_buckets + digit] = position;
+            position += count;
+          }
+
+#pragma omp parallel for \
+  default(none) \
+  shared(buffer, index_vector, nr_buckets, nr_chunks, nr_elements, offsets, shift) \
+  num_threads(nr_threads)
+        for (std::ptrdiff_t c = 0; c < static_cast<std::ptrdiff_t> (nr_chunks); ++c)
+        {
+          std::size_t begin = nr_elements * c / nr_chunks, end = nr_elements * (c + 1) / nr_chunks;
+          std::size_t *positions = &offsets[c * nr_buckets];
+          for (std::size_t i = begin; i < end; ++i)
+            buffer[positions[(index_vector[i].idx >> shift) & (nr_buckets - 1)]++] = index_vector[i];
+        }
+        index_vector.swap (buffer);
+      }
+    }
+
+    /** \brief Whether the voxels of a grid of dx * dy * dz voxels can be numbered with 64 bit keys. */
+    inline bool
+    isHashableVoxelGrid (std::int64_t dx, std::int64_t dy, std::int64_t dz)
+    {
+      // The largest key is kept free to mark the empty slots of the hash map
+      return (dx > 0 && dy > 0 && dz > 0 &&
+              static_cast<double> (dx) * static_cast<double> (dy) * static_cast<double> (dz) <
+              static_cast<double> (std::numeric_limits<std::int64_t>::max ()));
+    }
+
+    /** \brief Group the points by voxel with a hash map of the voxel keys, in O(n) expected time.
+      * The voxels are numbered in order of first appearance, and the points of a voxel keep their order.
+      * \param[in] nr_points the number of points to process
+      * \param[in] get_key a function (i, key, cloud_point_index) setting the 64 bit voxel key of the i-th
+      * point and its index in the input cloud, and returning false if the point has to be skipped
+      * \param[out] index_vector the voxel numbers and point indices of the points which are not skipped,
+      * grouped by voxel
+      */
+    template <typename KeyFunction> void
+    computeHashedVoxelIndices (std::size_t nr_points, const KeyFunction &get_key,
+                               std::vector<cloud_point_index_idx> &index_vector)
+    {
+      VoxelHashMap voxels;
+      std::vector<unsigned int> offsets;
+      std::vector<cloud_point_index_idx> point_voxels;
+      point_voxels.reserve (nr_points);
+      std::uint64_t key;
+      unsigned int cloud_point_index;
+      for (std::size_t i = 0; i < nr_points; ++i)
+      {
+        if (!get_key (i, key, cloud_point_index))
+          continue;
+        const unsigned int voxel = voxels.insert (key, static_cast<unsigned int> (offsets.size ()));
+        if (voxel == offsets.size ())
+          offsets.push_back (0);
+        ++offsets[voxel];
+        point_voxels.emplace_back (voxel, cloud_point_index);
+      }
+
+      // Counting sort by voxel number
+      unsigned int position = 0;
+      for (unsigned int &offset : offsets)
+      {
+        const unsigned int count = offset;
+        offset = position;
+        position += count;
+      }
+      index_vector.resize (point_voxels.size ());
+      for (const cloud_point_index_idx &point : point_voxels)
+        index_vector[offsets[point.idx]++] = point;
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::VoxelGrid<PointT>::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs ();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT> void
 pcl::VoxelGrid<PointT>::applyFilter (PointCloud &output)
@@ -222,10 +427,6 @@ pcl::VoxelGrid<PointT>::applyFilter (PointCloud &output)
     return;
   }
 
-  // Copy the header (and thus the frame_id) + allocate enough space for points
-  output.height       = 1;                    // downsampling breaks the organized structure
-  output.is_dense     = true;                 // we filter out invalid points
-
   Eigen::Vector4f min_p, max_p;
   // Get the minimum and maximum dimensions
   if (!filter_field_name_.empty ()) // If we don't want to process the entire cloud...
@@ -233,16 +434,72 @@ pcl::VoxelGrid<PointT>::applyFilter (PointCloud &output)
   else
     getMinMax3D<PointT> (*input_, *indices_, min_p, max_p);
 
+  if (!computeCentroids (indices_->size (), [this] (std::size_t i) { return ((*indices_)[i]); },
+                         [this] (index_t index) -> const PointT& { return ((*input_)[index]); },
+                         input_->is_dense, min_p, max_p, output))
+    output = *input_;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> template <typename CoordinateT> void
+pcl::VoxelGrid<PointT>::filter (const CompactPointCloud<CoordinateT> &input, PointCloud &output)
+{
+  output.header = input.header;
+  output.sensor_origin_ = Eigen::Vector4f::Zero ();
+  output.sensor_orientation_ = Eigen::Quaternionf::Identity ();
+
+  Eigen::Vector4f min_p, max_p;
+  if (!input.getMinMax3D (min_p, max_p))
+  {
+    output.width = output.height = 0;
+    output.is_dense = true;
+    output.points.clear ();
+    return;
+  }
+
+  if (!computeCentroids (input.size (), [] (std::size_t i) { return (static_cast<index_t> (i)); },
+                         [&input] (index_t index) { return (input.template getPoint<PointT> (index)); },
+                         input.isDense (), min_p, max_p, output))
+    input.decode (output);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> template <typename IndexFunction, typename PointFunction> bool
+pcl::VoxelGrid<PointT>::computeCentroids (std::size_t nr_points, const IndexFunction &index_of,
+                                          const PointFunction &point_of, bool is_dense,
+                                          const Eigen::Vector4f &min_p, const Eigen::Vector4f &max_p,
+                                          PointCloud &output)
+{
   // Check that the leaf size is not too small, given the size of the data
   std::int64_t dx = static_cast<std::int64_t>((max_p[0] - min_p[0]) * inverse_leaf_size_[0])+1;
   std::int64_t dy = static_cast<std::int64_t>((max_p[1] - min_p[1]) * inverse_leaf_size_[1])+1;
   std::int64_t dz = static_cast<std::int64_t>((max_p[2] - min_p[2]) * inverse_leaf_size_[2])+1;
 
-  if ((dx*dy*dz) > static_cast<std::int64_t>(std::numeric_limits<std::int32_t>::max()))
+  if (voxel_hashing_)
+  {
+    if (!detail::isHashableVoxelGrid (dx, dy, dz))
+    {
+      PCL_WARN("[pcl::%s::applyFilter] Leaf size is too small for the input dataset. Integer indices would overflow.", getClassName().c_str());
+      return (false);
+    }
+  }
+  else if ((dx*dy*dz) > static_cast<std::int64_t>(std::numeric_limits<std::int32_t>::max()))
   {
     PCL_WARN("[pcl::%s::applyFilter] Leaf size is too small for the input dataset. Integer indices would overflow.", getClassName().c_str());
-    output = *input_;
-    return;
+    return (false);
+  }
+
+  // Copy the header (and thus the frame_id) + allocate enough space for points
+  output.height       = 1;                    // downsampling breaks the organized structure
+  output.is_dense     = true;                 // we filter out invalid points
+
+  // The leaf layout needs the grid indices, which are not computed when hashing the voxels
+  bool save_leaf_layout = save_leaf_layout_;
+  if (save_leaf_layout && voxel_hashing_)
+  {
+    PCL_WARN ("[pcl::%s::applyFilter] The leaf layout can not be saved when hashing the voxels.\n", getClassName ().c_str ());
+    leaf_layout_.clear ();
+    save_leaf_layout = false;
   }
 
   // Compute the minimum and maximum bounding box values
@@ -260,11 +517,9 @@ pcl::VoxelGrid<PointT>::applyFilter (PointCloud &output)
   // Set up the division multiplier
   divb_mul_ = Eigen::Vector4i (1, div_b_[0], div_b_[0] * div_b_[1], 0);
 
-  // Storage for mapping leaf and pointcloud indexes
-  std::vector<cloud_point_index_idx> index_vector;
-  index_vector.reserve (indices_->size ());
-
-  // If we don't want to process the entire cloud, but rather filter points far away from the viewpoint first...
+  // Get the distance field offset, if we don't want to process the entire cloud, but rather
+  // filter points far away from the viewpoint first
+  std::uint32_t distance_offset = 0;
   if (!filter_field_name_.empty ())
   {
     // Get the distance field index
@@ -272,76 +527,86 @@ pcl::VoxelGrid<PointT>::applyFilter (PointCloud &output)
     int distance_idx = pcl::getFieldIndex<PointT> (filter_field_name_, fields);
     if (distance_idx == -1)
       PCL_WARN ("[pcl::%s::applyFilter] Invalid filter field name. Index is %d.\n", getClassName ().c_str (), distance_idx);
+    distance_offset = fields[distance_idx].offset;
+  }
 
-    // First pass: go over all points and insert them into the index_vector vector
-    // with calculated idx. Points with the same idx value will contribute to the
-    // same point of resulting CloudPoint
-    for (std::vector<int>::const_iterator it = indices_->begin (); it != indices_->end (); ++it)
-    {
-      if (!input_->is_dense)
-        // Check if the point is invalid
-        if (!std::isfinite ((*input_)[*it].x) || 
-            !std::isfinite ((*input_)[*it].y) || 
-            !std::isfinite ((*input_)[*it].z))
-          continue;
-
-      // Get the distance value
-      const std::uint8_t* pt_data = reinterpret_cast<const std::uint8_t*> (&(*input_)[*it]);
-      float distance_value = 0;
-      memcpy (&distance_value, pt_data + fields[distance_idx].offset, sizeof (float));
+  // Check whether a point contributes to a centroid
+  const auto use_point = [this, distance_offset, is_dense] (const PointT &point)
+  {
+    if (!is_dense)
+      // Check if the point is invalid
+      if (!std::isfinite (point.x) ||
+          !std::isfinite (point.y) ||
+          !std::isfinite (point.z))
+        return (false);
+
+    if (filter_field_name_.empty ())
+      return (true);
+
+    // Get the distance value
+    const std::uint8_t* pt_data = reinterpret_cast<const std::uint8_t*> (&point);
+    float distance_value = 0;
+    memcpy (&distance_value, pt_data + distance_offset, sizeof (float));
+
+    if (filter_limit_negative_)
+      // Use a threshold for cutting out points which inside the interval
+      return (!((distance_value < filter_limit_max_) && (distance_value > filter_limit_min_)));
+    // Use a threshold for cutting out points which are too close/far away
+    return (!((distance_value > filter_limit_max_) || (distance_value < filter_limit_min_)));
+  };
 
-      if (filter_limit_negative_)
-      {
-        // Use a threshold for cutting out points which inside the interval
-        if ((distance_value < filter_limit_max_) && (distance_value > filter_limit_min_))
-          continue;
-      }
-      else
-      {
-        // Use a threshold for cutting out points which are too close/far away
-        if ((distance_value > filter_limit_max_) || (distance_value < filter_limit_min_))
-          continue;
-      }
-      
-      int ijk0 = static_cast<int> (std::floor ((*input_)[*it].x * inverse_leaf_size_[0]) - static_cast<float> (min_b_[0]));
-      int ijk1 = static_cast<int> (std::floor ((*input_)[*it].y * inverse_leaf_size_[1]) - static_cast<float> (min_b_[1]));
-      int ijk2 = static_cast<int> (std::floor ((*input_)[*it].z * inverse_leaf_size_[2]) - static_cast<float> (min_b_[2]));
+  // Storage for mapping leaf and pointcloud indexes
+  std::vector<cloud_point_index_idx> index_vector;
 
-      // Compute the centroid leaf index
-      int idx = ijk0 * divb_mul_[0] + ijk1 * divb_mul_[1] + ijk2 * divb_mul_[2];
-      index_vector.emplace_back(static_cast<unsigned int> (idx), *it);
-    }
+  if (voxel_hashing_)
+  {
+    // First pass: go over all points and group them by voxel, with the 64 bit index of their voxel
+    // as key. The voxels are numbered in order of appearance, no sort is needed
+    const std::uint64_t key_mul_y = static_cast<std::uint64_t> (dx);
+    const std::uint64_t key_mul_z = static_cast<std::uint64_t> (dx) * static_cast<std::uint64_t> (dy);
+    detail::computeHashedVoxelIndices (nr_points,
+                                       [&] (std::size_t i, std::uint64_t &key, unsigned int &cloud_point_index)
+    {
+      const PointT &point = point_of (index_of (i));
+      if (!use_point (point))
+        return (false);
+
+      std::int64_t ijk0 = static_cast<std::int64_t> (std::floor (point.x * inverse_leaf_size_[0]) - static_cast<float> (min_b_[0]));
+      std::int64_t ijk1 = static_cast<std::int64_t> (std::floor (point.y * inverse_leaf_size_[1]) - static_cast<float> (min_b_[1]));
+      std::int64_t ijk2 = static_cast<std::int64_t> (std::floor (point.z * inverse_leaf_size_[2]) - static_cast<float> (min_b_[2]));
+      key = static_cast<std::uint64_t> (ijk0) + static_cast<std::uint64_t> (ijk1) * key_mul_y +
+            static_cast<std::uint64_t> (ijk2) * key_mul_z;
+      cloud_point_index = index_of (i);
+      return (true);
+    }, index_vector);
   }
-  // No distance filtering, process all data
   else
   {
     // First pass: go over all points and insert them into the index_vector vector
     // with calculated idx. Points with the same idx value will contribute to the
     // same point of resulting CloudPoint
-    for (std::vector<int>::const_iterator it = indices_->begin (); it != indices_->end (); ++it)
+    detail::computeVoxelIndices (nr_points, threads_,
+                                 [&] (std::size_t i, unsigned int &idx, unsigned int &cloud_point_index)
     {
-      if (!input_->is_dense)
-        // Check if the point is invalid
-        if (!std::isfinite ((*input_)[*it].x) || 
-            !std::isfinite ((*input_)[*it].y) || 
-            !std::isfinite ((*input_)[*it].z))
-          continue;
+      const PointT &point = point_of (index_of (i));
+      if (!use_point (point))
+        return (false);
 
-      int ijk0 = static_cast<int> (std::floor ((*input_)[*it].x * inverse_leaf_size_[0]) - static_cast<float> (min_b_[0]));
-      int ijk1 = static_cast<int> (std::floor ((*input_)[*it].y * inverse_leaf_size_[1]) - static_cast<float> (min_b_[1]));
-      int ijk2 = static_cast<int> (std::floor ((*input_)[*it].z * inverse_leaf_size_[2]) - static_cast<float> (min_b_[2]));
+      int ijk0 = static_cast<int> (std::floor (point.x * inverse_leaf_size_[0]) - static_cast<float> (min_b_[0]));
+      int ijk1 = static_cast<int> (std::floor (point.y * inverse_leaf_size_[1]) - static_cast<float> (min_b_[1]));
+      int ijk2 = static_cast<int> (std::floor (point.z * inverse_leaf_size_[2]) - static_cast<float> (min_b_[2]));
 
       // Compute the centroid leaf index
-      int idx = ijk0 * divb_mul_[0] + ijk1 * divb_mul_[1] + ijk2 * divb_mul_[2];
-      index_vector.emplace_back(static_cast<unsigned int> (idx), *it);
-    }
+      idx = static_cast<unsigned int> (ijk0 * divb_mul_[0] + ijk1 * divb_mul_[1] + ijk2 * divb_mul_[2]);
+      cloud_point_index = index_of (i);
+      return (true);
+    }, index_vector);
+
+    // Second pass: sort the index_vector vector using value representing target cell as index
+    // in effect all points belonging to the same output cell will be next to each other
+    detail::sortVoxelIndices (index_vector, threads_);
   }
 
-  // Second pass: sort the index_vector vector using value representing target cell as index
-  // in effect all points belonging to the same output cell will be next to each other
-  auto rightshift_func = [](const cloud_point_index_idx &x, const unsigned offset) { return x.idx >> offset; };
-  boost::sort::spreadsort::integer_sort(index_vector.begin(), index_vector.end(), rightshift_func);
-  
   // Third pass: count output cells
   // we need to skip all the same, adjacent idx values
   unsigned int total = 0;
@@ -367,7 +632,7 @@ pcl::VoxelGrid<PointT>::applyFilter (PointCloud &output)
 
   // Fourth pass: compute centroids, insert them into their final position
   output.points.resize (total);
-  if (save_leaf_layout_)
+  if (save_leaf_layout)
   {
     try
     { 
@@ -393,16 +658,20 @@ pcl::VoxelGrid<PointT>::applyFilter (PointCloud &output)
     }
   }
   
-  index = 0;
-  for (const auto &cp : first_and_last_indices_vector)
+  // The centroids are independent of each other, and each of them is accumulated by a single thread
+#pragma omp parallel for \
+  default(none) \
+  shared(first_and_last_indices_vector, index_vector, output, point_of, save_leaf_layout) \
+  num_threads(threads_)
+  for (std::ptrdiff_t index = 0; index < static_cast<std::ptrdiff_t> (first_and_last_indices_vector.size ()); ++index)
   {
     // calculate centroid - sum values from all input points, that have the same idx value in index_vector array
-  	unsigned int first_index = cp.first;
-  	unsigned int last_index = cp.second;
+    unsigned int first_index = first_and_last_indices_vector[index].first;
+    unsigned int last_index = first_and_last_indices_vector[index].second;
 
     // index is centroid final position in resulting PointCloud
-    if (save_leaf_layout_)
-      leaf_layout_[index_vector[first_index].idx] = index;
+    if (save_leaf_layout)
+      leaf_layout_[index_vector[first_index].idx] = static_cast<int> (index);
 
     //Limit downsampling to coords
     if (!downsample_all_data_)
@@ -410,7 +679,7 @@ pcl::VoxelGrid<PointT>::applyFilter (PointCloud &output)
       Eigen::Vector4f centroid (Eigen::Vector4f::Zero ());
 
       for (unsigned int li = first_index; li < last_index; ++li)
-        centroid += (*input_)[index_vector[li].cloud_point_index].getVector4fMap ();
+        centroid += point_of (index_vector[li].cloud_point_index).getVector4fMap ();
 
       centroid /= static_cast<float> (last_index - first_index);
       output[index].getVector4fMap () = centroid;
@@ -421,14 +690,13 @@ pcl::VoxelGrid<PointT>::applyFilter (PointCloud &output)
 
       // fill in the accumulator with leaf points
       for (unsigned int li = first_index; li < last_index; ++li)
-        centroid.add ((*input_)[index_vector[li].cloud_point_index]);  
+        centroid.add (point_of (index_vector[li].cloud_point_index));
 
       centroid.get (output[index]);
     }
-     
-    ++index;
   }
   output.width = output.size ();
+  return (true);
 }
 
 #define PCL_INSTANTIATE_VoxelGrid(T) template class PCL_EXPORTS pcl::VoxelGrid<T>;
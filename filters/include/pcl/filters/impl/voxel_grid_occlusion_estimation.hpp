@@ -42,6 +42,9 @@
 #include <pcl/common/common.h>
 #include <pcl/filters/voxel_grid_occlusion_estimation.h>
 
+#include <algorithm>
+#include <cstdint>
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT> void
 pcl::VoxelGridOcclusionEstimation<PointT>::initializeVoxelGrid ()
@@ -138,36 +141,93 @@ pcl::VoxelGridOcclusionEstimation<PointT>::occlusionEstimationAll (std::vector<E
     return -1;
   }
 
-  // reserve space for the ray vector
-  int reserve_size = div_b_[0] * div_b_[1] * div_b_[2];
-  occluded_voxels.reserve (reserve_size);
-
-  // iterate over the entire voxel grid
-  for (int kk = min_b_.z (); kk <= max_b_.z (); ++kk)
-    for (int jj = min_b_.y (); jj <= max_b_.y (); ++jj)
-      for (int ii = min_b_.x (); ii <= max_b_.x (); ++ii)
-      {
-        Eigen::Vector3i ijk (ii, jj, kk);
-        // process all free voxels
-        int index = this->getCentroidIndexAt (ijk);
-        if (index == -1)
-        {
-          // estimate direction to target voxel
-          Eigen::Vector4f p = getCentroidCoordinate (ijk);
-          Eigen::Vector4f direction = p - sensor_origin_;
-          direction.normalize ();
-          
-          // estimate entry point into the voxel grid
-          float tmin = rayBoxIntersection (sensor_origin_, direction);
-
-          // ray traversal
-          int state = rayTraversal (ijk, sensor_origin_, direction, tmin);
-          
-          // if voxel is occluded
-          if (state == 1)
-            occluded_voxels.push_back (ijk);
-        }
-      }
+  // without a leaf layout, all voxels are free and visible
+  if (leaf_layout_.empty ())
+    return 0;
+
+  // the state of each voxel, estimated in parallel and then compacted in
+  // order, so that the result does not depend on the number of threads
+  const int nr_voxels = div_b_[0] * div_b_[1] * div_b_[2];
+  std::vector<std::uint8_t> occluded (nr_voxels, 0);
+
+  // iterate over the entire voxel grid, in the order of the leaf layout
+#pragma omp parallel for \
+  default(none) \
+  shared(occluded, nr_voxels) \
+  schedule(dynamic, 256) \
+  num_threads(threads_)
+  for (int index = 0; index < nr_voxels; ++index)
+  {
+    const Eigen::Vector3i ijk = min_b_.template head<3> () + Eigen::Vector3i (index % div_b_[0],
+                                                                     (index / div_b_[0]) % div_b_[1],
+                                                                     index / (div_b_[0] * div_b_[1]));
+    // process all free voxels
+    if (this->getCentroidIndexAt (ijk) == -1)
+    {
+      // estimate direction to target voxel
+      Eigen::Vector4f p = getCentroidCoordinate (ijk);
+      Eigen::Vector4f direction = p - sensor_origin_;
+      direction.normalize ();
+
+      // estimate entry point into the voxel grid
+      float tmin = rayBoxIntersection (sensor_origin_, direction);
+
+      // ray traversal, the voxel is occluded if the ray hits an occupied voxel first
+      occluded[index] = traverseRay (ijk, sensor_origin_, direction, tmin,
+                                     [this] (int leaf) { return (leaf_layout_[leaf] != -1); });
+    }
+  }
+
+  occluded_voxels.reserve (occluded_voxels.size () + std::count (occluded.begin (), occluded.end (), 1));
+  for (int index = 0; index < nr_voxels; ++index)
+    if (occluded[index])
+      occluded_voxels.push_back (min_b_.template head<3> () + Eigen::Vector3i (index % div_b_[0],
+                                                                      (index / div_b_[0]) % div_b_[1],
+                                                                      index / (div_b_[0] * div_b_[1])));
+  return 0;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> int
+pcl::VoxelGridOcclusionEstimation<PointT>::computeFreeSpaceCounts (std::vector<unsigned int>& free_counts)
+{
+  if (!initialized_)
+  {
+    PCL_ERROR ("Voxel grid not initialized; call initializeVoxelGrid () first! \n");
+    return -1;
+  }
+
+  free_counts.assign (leaf_layout_.size (), 0);
+  if (leaf_layout_.empty ())
+    return 0;
+
+  // one ray per occupied voxel, i.e. per point of the filtered cloud
+#pragma omp parallel for \
+  default(none) \
+  shared(free_counts) \
+  schedule(dynamic, 256) \
+  num_threads(threads_)
+  for (std::ptrdiff_t i = 0; i < static_cast<std::ptrdiff_t> (filtered_cloud_.size ()); ++i)
+  {
+    const PointT& point = filtered_cloud_[i];
+    const Eigen::Vector3i ijk = this->getGridCoordinates (point.x, point.y, point.z);
+
+    // estimate direction to target voxel
+    Eigen::Vector4f p = getCentroidCoordinate (ijk);
+    Eigen::Vector4f direction = p - sensor_origin_;
+    direction.normalize ();
+
+    // the ray starts at the sensor, or where it enters the voxel grid
+    float tmin = std::max (rayBoxIntersection (sensor_origin_, direction), 0.0f);
+
+    traverseRay (ijk, sensor_origin_, direction, tmin,
+                 [&free_counts] (int leaf)
+                 {
+#pragma omp atomic
+                   ++free_counts[leaf];
+                   return (false);
+                 });
+  }
   return 0;
 }
 
@@ -244,6 +304,23 @@ pcl::VoxelGridOcclusionEstimation<PointT>::rayTraversal (const Eigen::Vector3i&
                                                          const Eigen::Vector4f& origin, 
                                                          const Eigen::Vector4f& direction,
                                                          const float t_min)
+{
+  if (leaf_layout_.empty ())
+    return 0;
+
+  // the target voxel is occluded if the ray hits an occupied voxel first
+  const bool occluded = traverseRay (target_voxel, origin, direction, t_min,
+                                     [this] (int leaf) { return (this->leaf_layout_[leaf] != -1); });
+  return (occluded ? 1 : 0);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> template <typename VoxelFunction> bool
+pcl::VoxelGridOcclusionEstimation<PointT>::traverseRay (const Eigen::Vector3i& target_voxel,
+                                                        const Eigen::Vector4f& origin,
+                                                        const Eigen::Vector4f& direction,
+                                                        const float t_min,
+                                                        const VoxelFunction& visit) const
 {
   // coordinate of the boundary of the voxel grid
   Eigen::Vector4f start = origin + t_min * direction;
@@ -296,38 +373,44 @@ pcl::VoxelGridOcclusionEstimation<PointT>::rayTraversal (const Eigen::Vector3i&
   float t_delta_y = leaf_size_[1] / static_cast<float> (std::abs (direction[1]));
   float t_delta_z = leaf_size_[2] / static_cast<float> (std::abs (direction[2]));
 
+  // the index of the voxel in the leaf layout, updated along with ijk
+  int leaf = (ijk - min_b_.template head<3> ()).dot (divb_mul_.template head<3> ());
+  const int leaf_step_x = step_x * divb_mul_[0];
+  const int leaf_step_y = step_y * divb_mul_[1];
+  const int leaf_step_z = step_z * divb_mul_[2];
+
   while ( (ijk[0] < max_b_[0]+1) && (ijk[0] >= min_b_[0]) && 
           (ijk[1] < max_b_[1]+1) && (ijk[1] >= min_b_[1]) && 
           (ijk[2] < max_b_[2]+1) && (ijk[2] >= min_b_[2]) )
   {
     // check if we reached target voxel
     if (ijk[0] == target_voxel[0] && ijk[1] == target_voxel[1] && ijk[2] == target_voxel[2])
-      return 0;
+      return false;
 
-    // index of the point in the point cloud
-    int index = this->getCentroidIndexAt (ijk);
-    // check if voxel is occupied, if yes return 1 for occluded
-    if (index != -1)
-      return 1;
+    if (visit (leaf))
+      return true;
 
     // estimate next voxel
     if(t_max_x <= t_max_y && t_max_x <= t_max_z)
     {
       t_max_x += t_delta_x;
       ijk[0] += step_x;
+      leaf += leaf_step_x;
     }
     else if(t_max_y <= t_max_z && t_max_y <= t_max_x)
     {
       t_max_y += t_delta_y;
       ijk[1] += step_y;
+      leaf += leaf_step_y;
     }
     else
     {
       t_max_z += t_delta_z;
       ijk[2] += step_z;
+      leaf += leaf_step_z;
     }
   }
-  return 0;
+  return false;
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
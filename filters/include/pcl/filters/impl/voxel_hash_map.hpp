@@ -0,0 +1,226 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved
+ */
+
+#ifndef PCL_FILTERS_IMPL_VOXEL_HASH_MAP_HPP_
+#define PCL_FILTERS_IMPL_VOXEL_HASH_MAP_HPP_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace pcl
+{
+  namespace detail
+  {
+    /** \brief An open addressing (linear probing) hash map from 64 bit voxel keys to voxel numbers,
+      * which grows with the number of voxels instead of with the extent of the grid.
+      */
+    class VoxelHashMap
+    {
+      public:
+        VoxelHashMap () : size_ (0), last_key_ (empty_key ()), last_value_ (0)
+        {
+          resize (1024);
+        }
+
+        /** \brief Get the number of a voxel, inserting it with the number \a value if it is not in the map yet.
+          * \param[in] key the key of the voxel, which must not be the largest 64 bit value
+          * \param[in] value the number given to the voxel if it is new
+          * \return the number of the voxel
+          */
+        inline unsigned int
+        insert (std::uint64_t key, unsigned int value)
+        {
+          // Consecutive points of a scan often fall in the same voxel
+          if (key == last_key_)
+            return (last_value_);
+
+          const std::size_t mask = entries_.size () - 1;
+          std::size_t slot = hash (key);
+          while (entries_[slot].key != key)
+          {
+            if (entries_[slot].key == empty_key ())
+            {
+              entries_[slot].key = key;
+              entries_[slot].value = value;
+              // Keep the load factor below 1/2, so that the probe sequences stay short
+              if (++size_ * 2 > entries_.size ())
+                resize (entries_.size () * 2);
+              last_key_ = key;
+              last_value_ = value;
+              return (value);
+            }
+            slot = (slot + 1) & mask;
+          }
+          last_key_ = key;
+          last_value_ = entries_[slot].value;
+          return (last_value_);
+        }
+
+      private:
+        struct Entry
+        {
+          std::uint64_t key;
+          unsigned int value;
+        };
+
+        static inline std::uint64_t
+        empty_key ()
+        {
+          return (std::numeric_limits<std::uint64_t>::max ());
+        }
+
+        /** \brief Fibonacci hashing: the neighboring keys of a row of voxels are spread over the table. */
+        inline std::size_t
+        hash (std::uint64_t key) const
+        {
+          return (static_cast<std::size_t> ((key * 0x9E3779B97F4A7C15ull) >> shift_));
+        }
+
+        void
+        resize (std::size_t capacity)
+        {
+          std::vector<Entry> entries (capacity, Entry {empty_key (), 0});
+          entries.swap (entries_);
+          shift_ = 64;
+          for (std::size_t c = capacity; c > 1; c >>= 1)
+            --shift_;
+          for (const Entry &entry : entries)
+          {
+            if (entry.key == empty_key ())
+              continue;
+            std::size_t slot = hash (entry.key);
+            while (entries_[slot].key != empty_key ())
+              slot = (slot + 1) & (capacity - 1);
+            entries_[slot] = entry;
+          }
+        }
+
+        std::vector<Entry> entries_;
+        std::size_t size_;
+        unsigned int shift_;
+        std::uint64_t last_key_;
+        unsigned int last_value_;
+    };
+
+    /** \brief The key of the points which do not belong to any voxel, for \ref groupVoxelsInShards. */
+    inline std::uint64_t
+    invalidVoxelKey ()
+    {
+      return (std::numeric_limits<std::uint64_t>::max ());
+    }
+
+    /** \brief The points of a cloud grouped by voxel, the voxels being numbered in order of first appearance. */
+    struct VoxelGroups
+    {
+      /** \brief The points of voxel v are positions[begins[v]] to positions[begins[v + 1] - 1]. */
+      std::vector<unsigned int> begins;
+      /** \brief The positions of the points in the key vector, increasing within every voxel. */
+      std::vector<unsigned int> positions;
+
+      /** \brief The number of voxels. */
+      inline std::size_t
+      size () const
+      {
+        return (begins.empty () ? 0 : begins.size () - 1);
+      }
+    };
+
+    /** \brief Group points by voxel on several threads, with one hash map per thread.
+      *
+      * The voxels are split into as many shards as there are threads according to their key, and every thread
+      * builds the hash map of its own shard only, so that no locking is needed and the memory use is proportional
+      * to the number of points and of occupied voxels. The groups do not depend on the number of threads.
+      * \param[in] keys the voxel key of every point, invalidVoxelKey () for the points to skip
+      * \param[in] nr_threads the number of threads to use
+      * \param[out] groups the points of every voxel
+      */
+    inline void
+    groupVoxelsInShards (const std::vector<std::uint64_t> &keys, unsigned int nr_threads, VoxelGroups &groups)
+    {
+      unsigned int nr_shards = std::max (nr_threads, 1u);
+      std::size_t nr_points = keys.size ();
+      // The shard of a key, from the high bits of a hash unrelated to the one of VoxelHashMap
+      const auto shard_of = [nr_shards] (std::uint64_t key)
+      {
+        const std::uint64_t hash = (key * 0xC2B2AE3D27D4EB4Full) >> 32;
+        return (static_cast<unsigned int> ((hash * nr_shards) >> 32));
+      };
+
+      // First pass: every thread numbers the voxels of its shard in order of first appearance
+      std::vector<unsigned int> local_voxels (nr_points);
+      std::vector<std::vector<unsigned int> > firsts (nr_shards), counts (nr_shards);
+#pragma omp parallel for \
+  default(none) \
+  shared(counts, firsts, keys, local_voxels, nr_points, nr_shards, shard_of) \
+  schedule(static, 1) \
+  num_threads(nr_threads)
+      for (std::ptrdiff_t s = 0; s < static_cast<std::ptrdiff_t> (nr_shards); ++s)
+      {
+        VoxelHashMap voxels;
+        std::vector<unsigned int> &first = firsts[s], &count = counts[s];
+        for (std::size_t i = 0; i < nr_points; ++i)
+        {
+          if (keys[i] == invalidVoxelKey () || shard_of (keys[i]) != static_cast<unsigned int> (s))
+            continue;
+          const unsigned int voxel = voxels.insert (keys[i], static_cast<unsigned int> (first.size ()));
+          if (voxel == first.size ())
+          {
+            first.push_back (static_cast<unsigned int> (i));
+            count.push_back (0);
+          }
+          ++count[voxel];
+          local_voxels[i] = voxel;
+        }
+      }
+
+      // Number the voxels of all the shards by their first point
+      struct ShardVoxel
+      {
+        unsigned int first, shard, voxel;
+      };
+      std::vector<ShardVoxel> order;
+      for (unsigned int s = 0; s < nr_shards; ++s)
+        for (std::size_t v = 0; v < firsts[s].size (); ++v)
+          order.push_back (ShardVoxel {firsts[s][v], s, static_cast<unsigned int> (v)});
+      std::sort (order.begin (), order.end (),
+                 [] (const ShardVoxel &a, const ShardVoxel &b) { return (a.first < b.first); });
+
+      std::vector<std::vector<unsigned int> > numbers (nr_shards);
+      for (unsigned int s = 0; s < nr_shards; ++s)
+        numbers[s].resize (firsts[s].size ());
+      groups.begins.assign (order.size () + 1, 0);
+      for (std::size_t v = 0; v < order.size (); ++v)
+      {
+        numbers[order[v].shard][order[v].voxel] = static_cast<unsigned int> (v);
+        groups.begins[v + 1] = groups.begins[v] + counts[order[v].shard][order[v].voxel];
+      }
+
+      // Second pass: every thread places the points of its voxels, in order
+      std::vector<unsigned int> next (groups.begins.begin (), groups.begins.end () - 1);
+      groups.positions.resize (groups.begins.back ());
+#pragma omp parallel for \
+  default(none) \
+  shared(groups, keys, local_voxels, next, nr_points, nr_shards, numbers, shard_of) \
+  schedule(static, 1) \
+  num_threads(nr_threads)
+      for (std::ptrdiff_t s = 0; s < static_cast<std::ptrdiff_t> (nr_shards); ++s)
+        for (std::size_t i = 0; i < nr_points; ++i)
+        {
+          if (keys[i] == invalidVoxelKey () || shard_of (keys[i]) != static_cast<unsigned int> (s))
+            continue;
+          groups.positions[next[numbers[s][local_voxels[i]]]++] = static_cast<unsigned int> (i);
+        }
+    }
+  }
+}
+
+#endif  // PCL_FILTERS_IMPL_VOXEL_HASH_MAP_HPP_
@@ -50,6 +50,11 @@ namespace pcl
     * simple to implement and efficient, as it requires a single pass over the image. It consists of a moving window of
     * fixed size that replaces the pixel in the center with the median inside the window.
     *
+    * By default the depths of every window are partially sorted. With a depth resolution set by
+    * \ref setDepthResolution, the depths are instead quantized and the median is tracked in a histogram which slides
+    * along the rows, so that the cost per pixel grows with the window size instead of the window area. The rows are
+    * filtered in parallel with \ref setNumberOfThreads.
+    *
     * \note This algorithm filters only the depth (z-component) of _organized_ and untransformed (i.e., in camera coordinates)
     * point clouds. An error will be outputted if an unorganized cloud is given to the class instance.
     *
@@ -67,6 +72,8 @@ namespace pcl
       MedianFilter ()
         : window_size_ (5)
         , max_allowed_movement_ (std::numeric_limits<float>::max ())
+        , depth_resolution_ (0.0f)
+        , threads_ (1)
       { }
 
       /** \brief Set the window size of the filter.
@@ -97,6 +104,26 @@ namespace pcl
       getMaxAllowedMovement () const
       { return max_allowed_movement_; }
 
+      /** \brief Set the resolution to which the depths are quantized to compute the medians with a sliding histogram.
+        * \details The filtered depths are then rounded to the resolution, e.g. 0.001 for sensors which measure depth
+        * in millimeters. A resolution of 0 (the default) computes the exact medians by sorting the windows.
+        * \param[in] depth_resolution the size of a bin of the histogram, in the unit of the depths
+        */
+      inline void
+      setDepthResolution (float depth_resolution)
+      { depth_resolution_ = depth_resolution; }
+
+      /** \brief Get the resolution to which the depths are quantized, 0 if the exact medians are computed. */
+      inline float
+      getDepthResolution () const
+      { return depth_resolution_; }
+
+      /** \brief Set the number of threads to use.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      void
+      setNumberOfThreads (unsigned int nr_threads = 0);
+
       /** \brief Filter the input data and store the results into output.
         * \param[out] output the result point cloud
         */
@@ -104,8 +131,29 @@ namespace pcl
       applyFilter (PointCloud &output) override;
 
     protected:
+      /** \brief Compute the exact medians, sorting the depths of every window. */
+      void
+      sortWindows (PointCloud &output) const;
+
+      /** \brief Compute the medians of the quantized depths with a histogram sliding along the rows.
+        * \return false if the range of the depths is too large for the resolution
+        */
+      bool
+      slideHistograms (PointCloud &output) const;
+
+      /** \brief Move a depth to its median, by at most max_allowed_movement_. */
+      inline float
+      moveDepth (float depth, float median) const
+      {
+        if (std::abs (median - depth) < max_allowed_movement_)
+          return (median);
+        return (depth + max_allowed_movement_ * (median - depth) / std::abs (median - depth));
+      }
+
       int window_size_;
       float max_allowed_movement_;
+      float depth_resolution_;
+      unsigned int threads_;
   };
 }
 
@@ -79,6 +79,7 @@ namespace pcl
         , binsy_ ()
         , binsz_ ()
         , input_normals_ ()
+        , threads_ (1)
       {
         filter_name_ = "NormalSpaceSampling";
       }
@@ -143,6 +144,13 @@ namespace pcl
       inline NormalsConstPtr
       getNormals () const { return (input_normals_); }
 
+      /** \brief Set the number of threads to use for binning the normals.
+        * The result does not depend on the number of threads.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      void
+      setNumberOfThreads (unsigned int nr_threads = 0);
+
     protected:
       /** \brief Number of indices that will be returned. */
       unsigned int sample_;
@@ -159,6 +167,9 @@ namespace pcl
       /** \brief The normals computed at each point in the input cloud */
       NormalsConstPtr input_normals_;
 
+      /** \brief The number of threads to use for binning the normals. */
+      unsigned int threads_;
+
       /** \brief Sample of point indices
         * \param[out] indices the resultant point cloud indices
         */
@@ -173,15 +184,7 @@ namespace pcl
         * \param[in] normal the input normal 
         */
       unsigned int 
-      findBin (const float *normal);
-
-      /** \brief Checks of the entire bin is sampled, returns true or false
-        * \param[out] array flag which says whether a point is sampled or not
-        * \param[in] start_index the index to the first point of the bin in array.
-        * \param[in] length number of points in the bin
-        */
-      bool
-      isEntireBinSampled (boost::dynamic_bitset<> &array, unsigned int start_index, unsigned int length);
+      findBin (const float *normal) const;
 
       /** \brief Random engine */
       std::mt19937 rng_;
@@ -44,6 +44,9 @@
 #include <pcl/point_cloud.h>
 #include <pcl/pcl_config.h>
 
+#include <string>
+#include <vector>
+
 namespace pcl
 {
   namespace filters
@@ -136,6 +139,17 @@ namespace pcl
         bool 
         initCompute ();
 
+        /** \brief Build the levels of a dense input, smoothing and subsampling each float
+          * channel of the points with the separable kernel. The channels of a level are
+          * kept in planes the next level is computed from.
+          * \param[out] output the pyramid, already holding the input at level 0
+          * \param[in] nr_channels the number of channels of a point
+          * \param[in] load functor writing the channels of a point to a float array
+          * \param[in] store functor setting a point from an array of its channels
+          */
+        template <typename Load, typename Store> void
+        computeDense (std::vector<PointCloudPtr>& output, int nr_channels, Load load, Store store);
+
         /** \brief nullify a point 
           * \param[in][out] p point to nullify
           */
@@ -155,6 +169,8 @@ namespace pcl
         std::string name_;
         /// \brief smoothing kernel
         Eigen::MatrixXf kernel_;
+        /// \brief 1D smoothing kernel, kernel_ is its outer product with itself
+        Eigen::VectorXf separable_kernel_;
         /// Threshold distance between adjacent points
         float threshold_;
         /// \brief number of threads
@@ -42,6 +42,9 @@
 #include <pcl/filters/filter_indices.h>
 #include <pcl/search/pcl_search.h>
 
+#include <cstdint>
+#include <vector>
+
 namespace pcl
 {
   /** \brief @b RadiusOutlierRemoval filters points in a cloud based on the number of neighbors they have.
@@ -89,7 +92,9 @@ namespace pcl
         FilterIndices<PointT> (extract_removed_indices),
         searcher_ (),
         search_radius_ (0.0),
-        min_pts_radius_ (1)
+        min_pts_radius_ (1),
+        search_window_ (0),
+        threads_ (1)
       {
         filter_name_ = "RadiusOutlierRemoval";
       }
@@ -138,6 +143,33 @@ namespace pcl
         return (min_pts_radius_);
       }
 
+      /** \brief Set the number of threads to use for the neighbor searches.
+        * \details The searches are independent of each other, so the result does not depend on the number of threads.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      void
+      setNumberOfThreads (unsigned int nr_threads = 0);
+
+      /** \brief Set the half width of the image window in which the neighbors are searched, for organized clouds.
+        * \details With a half width w > 0, only the valid points among the (2w+1)x(2w+1) pixels centered on a point
+        * of an organized cloud are counted as its neighbors in the radius, instead of all the points of the cloud.
+        * This is much faster but approximate, points with neighbors outside of the window may be removed.
+        * Unorganized clouds always use the exact search.
+        * \param[in] half_width the half width of the window in pixels (0, the default, disables the window)
+        */
+      inline void
+      setOrganizedSearchWindow (unsigned int half_width)
+      {
+        search_window_ = half_width;
+      }
+
+      /** \brief Get the half width of the image window in which the neighbors are searched, for organized clouds. */
+      inline unsigned int
+      getOrganizedSearchWindow () const
+      {
+        return (search_window_);
+      }
+
     protected:
       using PCLBase<PointT>::input_;
       using PCLBase<PointT>::indices_;
@@ -164,6 +196,12 @@ namespace pcl
       void
       applyFilterIndices (std::vector<int> &indices);
 
+      /** \brief Classify the points of an organized cloud by counting their neighbors in the image window around them.
+        * \param[out] keep whether each point of the indices is kept
+        */
+      void
+      classifyWindowNeighbors (std::vector<std::uint8_t> &keep) const;
+
     private:
       /** \brief A pointer to the spatial search object. */
       SearcherPtr searcher_;
@@ -173,6 +211,12 @@ namespace pcl
 
       /** \brief The minimum number of neighbors that a point needs to have in the given search radius to be considered an inlier. */
       int min_pts_radius_;
+
+      /** \brief The half width of the image window in which the neighbors are searched (0 for the exact search). */
+      unsigned int search_window_;
+
+      /** \brief The number of threads to use for the neighbor searches. */
+      unsigned int threads_;
   };
 
   //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
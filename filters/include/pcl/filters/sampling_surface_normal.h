@@ -40,12 +40,16 @@
 #include <pcl/filters/filter.h>
 #include <ctime>
 #include <climits>
+#include <utility>
+#include <vector>
 
 namespace pcl
 {
   /** \brief @b SamplingSurfaceNormal divides the input space into grids until each grid contains a maximum of N points, 
     * and samples points randomly within each grid. Normal is computed using the N points of each grid. All points
     * sampled within a grid are assigned the same normal.
+    * The normals of the grids are computed in parallel (see \ref setNumberOfThreads), while the points are drawn in
+    * the order of the grids, so that the result only depends on the seed.
     *
     * \author Aravindhan K Krishnan. This code is ported from libpointmatcher (https://github.com/ethz-asl/libpointmatcher)
     * \ingroup filters
@@ -71,7 +75,7 @@ namespace pcl
 
       /** \brief Empty constructor. */
       SamplingSurfaceNormal () : 
-        sample_ (10), seed_ (static_cast<unsigned int> (time (nullptr))), ratio_ ()
+        sample_ (10), seed_ (static_cast<unsigned int> (time (nullptr))), ratio_ (), threads_ (1)
       {
         filter_name_ = "SamplingSurfaceNormal";
         srand (seed_);
@@ -126,6 +130,12 @@ namespace pcl
         return ratio_;
       }
 
+      /** \brief Set the number of threads to use for computing the normals of the grids.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      void
+      setNumberOfThreads (unsigned int nr_threads = 0);
+
     protected:
 
       /** \brief Maximum number of samples in each grid. */
@@ -134,6 +144,8 @@ namespace pcl
       unsigned int seed_;
       /** \brief Ratio of points to be sampled in each grid */
       float ratio_;
+      /** \brief The number of threads to use for computing the normals of the grids. */
+      unsigned int threads_;
 
       /** \brief Sample of point indices into a separate PointCloud
         * \param[out] output the resultant point cloud
@@ -180,30 +192,44 @@ namespace pcl
       findXYZMaxMin (const PointCloud& cloud, Vector& max_vec, Vector& min_vec);
 
       /** \brief Recursively partition the point cloud, stopping when each grid contains less than sample_ points
-        *  Points are randomly sampled when a grid is found
-        * \param cloud
-        * \param first
-        * \param last
-        * \param min_values
-        * \param max_values
-        * \param indices
-        * \param[out] outcloud output the resultant point cloud
+        * \param[in] cloud the input cloud
+        * \param[in] first the first position of the grid in \a indices
+        * \param[in] last the end position of the grid in \a indices
+        * \param[in] min_values the minimum bounds of the grid
+        * \param[in] max_values the maximum bounds of the grid
+        * \param[in,out] indices the indices of the points, reordered so that each grid is a contiguous range
+        * \param[out] grids the ranges [first, last) of the grids in \a indices, in depth-first order
         */
       void 
       partition (const PointCloud& cloud, const int first, const int last, 
                  const Vector min_values, const Vector max_values, 
-                 std::vector<int>& indices, PointCloud& outcloud);
+                 std::vector<int>& indices, std::vector<std::pair<int, int> >& grids);
+
+      /** \brief Computes the normal of the points of a grid.
+        * \param[in] data the input cloud
+        * \param[in] first the first position of the grid in \a indices
+        * \param[in] last the end position of the grid in \a indices
+        * \param[in] indices the indices of the points
+        * \param[out] normal the computed normal
+        * \param[out] curvature the computed curvature
+        */
+      void
+      computePartitionNormal (const PointCloud& data, const int first, const int last,
+                              const std::vector<int>& indices, Eigen::Vector4f& normal, float& curvature);
 
       /** \brief Randomly sample the points in each grid.
-        * \param[in] data 
-        * \param[in] first
-        * \param[in] last
-        * \param[out] indices 
-        * \param[out] output the resultant point cloud
+        * \param[in] data the input cloud
+        * \param[in] first the first position of the grid in \a indices
+        * \param[in] last the end position of the grid in \a indices
+        * \param[in] indices the indices of the points
+        * \param[in] normal the normal of the grid, assigned to the sampled points
+        * \param[in] curvature the curvature of the grid, assigned to the sampled points
+        * \param[out] outcloud the resultant point cloud
         */
       void 
       samplePartition (const PointCloud& data, const int first, const int last, 
-                       std::vector<int>& indices, PointCloud& outcloud);
+                       const std::vector<int>& indices, const Eigen::Vector4f& normal, float curvature,
+                       PointCloud& outcloud);
 
       /** \brief Returns the threshold for splitting in a given dimension.
         * \param[in] cloud the input cloud
@@ -98,7 +98,10 @@ namespace pcl
         FilterIndices<PointT> (extract_removed_indices),
         searcher_ (),
         mean_k_ (1),
-        std_mul_ (0.0)
+        std_mul_ (0.0),
+        search_window_ (0),
+        threads_ (1),
+        spatial_query_order_ (false)
       {
         filter_name_ = "StatisticalOutlierRemoval";
       }
@@ -142,6 +145,51 @@ namespace pcl
         return (std_mul_);
       }
 
+      /** \brief Set the number of threads to use for the neighbor searches.
+        * \details The searches are independent of each other, so the result does not depend on the number of threads.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      void
+      setNumberOfThreads (unsigned int nr_threads = 0);
+
+      /** \brief Set the half width of the image window in which the neighbors are searched, for organized clouds.
+        * \details With a half width w > 0, the neighbors of a point of an organized cloud are the mean_k nearest
+        * valid points among the (2w+1)x(2w+1) pixels centered on it, instead of its mean_k nearest neighbors in
+        * space. This is much faster but approximate: points far from their image neighbors (e.g. at depth
+        * discontinuities) get fewer close neighbors. Unorganized clouds always use the exact search.
+        * \param[in] half_width the half width of the window in pixels (0, the default, disables the window)
+        */
+      inline void
+      setOrganizedSearchWindow (unsigned int half_width)
+      {
+        search_window_ = half_width;
+      }
+
+      /** \brief Get the half width of the image window in which the neighbors are searched, for organized clouds. */
+      inline unsigned int
+      getOrganizedSearchWindow () const
+      {
+        return (search_window_);
+      }
+
+      /** \brief Set whether the neighbors of the points are searched along the Morton (Z-order) curve instead of in
+        * the order of the indices, so that consecutive searches visit the same parts of the search tree, e.g. for
+        * clouds in acquisition order. The result does not change.
+        * \param[in] spatial_query_order true to search in Morton order, false for the order of the indices (default)
+        */
+      inline void
+      setSpatialQueryOrder (bool spatial_query_order)
+      {
+        spatial_query_order_ = spatial_query_order;
+      }
+
+      /** \brief Get whether the neighbors of the points are searched along the Morton (Z-order) curve. */
+      inline bool
+      getSpatialQueryOrder () const
+      {
+        return (spatial_query_order_);
+      }
+
     protected:
       using PCLBase<PointT>::input_;
       using PCLBase<PointT>::indices_;
@@ -168,6 +216,14 @@ namespace pcl
       void
       applyFilterIndices (std::vector<int> &indices);
 
+      /** \brief Compute the mean distances of the points of an organized cloud to their nearest neighbors
+        * in the image window around them.
+        * \param[out] distances the mean distance of each point of the indices (0 for invalid points)
+        * \return the number of valid mean distances
+        */
+      int
+      computeWindowMeanDistances (std::vector<float> &distances) const;
+
     private:
       /** \brief A pointer to the spatial search object. */
       SearcherPtr searcher_;
@@ -178,6 +234,15 @@ namespace pcl
       /** \brief Standard deviations threshold (i.e., points outside of 
         * \f$ \mu \pm \sigma \cdot std\_mul \f$ will be marked as outliers). */
       double std_mul_;
+
+      /** \brief The half width of the image window in which the neighbors are searched (0 for the exact search). */
+      unsigned int search_window_;
+
+      /** \brief The number of threads to use for the neighbor searches. */
+      unsigned int threads_;
+
+      /** \brief Whether the neighbors are searched along the Morton curve. */
+      bool spatial_query_order_;
   };
 
   /** \brief @b StatisticalOutlierRemoval uses point neighborhood statistics to filter outlier data. For more
@@ -54,6 +54,10 @@ namespace pcl
     * a bit slower than approximating them with the center of the voxel, but it
     * represents the underlying surface more accurately.
     *
+    * The points are grouped by voxel with one hash map per thread, each thread owning a shard of the voxels (see
+    * \ref setNumberOfThreads), so that the memory use is proportional to the number of occupied voxels. The sampled
+    * points are output in order of first appearance of their voxel, whatever the number of threads.
+    *
     * \author Radu Bogdan Rusu
     * \ingroup filters
     */
@@ -83,7 +87,8 @@ namespace pcl
         max_b_ (Eigen::Vector4i::Zero ()),
         div_b_ (Eigen::Vector4i::Zero ()),
         divb_mul_ (Eigen::Vector4i::Zero ()),
-        search_radius_ (0)
+        search_radius_ (0),
+        threads_ (1)
       {
         filter_name_ = "UniformSampling";
       }
@@ -109,6 +114,12 @@ namespace pcl
         search_radius_ = radius;
       }
 
+      /** \brief Set the number of threads to use.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      void
+      setNumberOfThreads (unsigned int nr_threads = 0);
+
     protected:
       /** \brief Simple structure to hold an nD centroid and the number of points in a leaf. */
       struct Leaf
@@ -132,6 +143,9 @@ namespace pcl
       /** \brief The nearest neighbors search radius for each point. */
       double search_radius_;
 
+      /** \brief The number of threads to use. */
+      unsigned int threads_;
+
       /** \brief Downsample a Point Cloud using a voxelized grid approach
         * \param[out] output the resultant point cloud message
         */
@@ -39,6 +39,7 @@
 
 #pragma once
 
+#include <pcl/compact_point_cloud.h>
 #include <pcl/filters/boost.h>
 #include <pcl/filters/filter.h>
 #include <map>
@@ -205,7 +206,9 @@ namespace pcl
         filter_limit_min_ (-FLT_MAX),
         filter_limit_max_ (FLT_MAX),
         filter_limit_negative_ (false),
-        min_points_per_voxel_ (0)
+        min_points_per_voxel_ (0),
+        threads_ (1),
+        voxel_hashing_ (false)
       {
         filter_name_ = "VoxelGrid";
       }
@@ -272,6 +275,13 @@ namespace pcl
       inline unsigned int
       getMinimumPointsNumberPerVoxel () const { return min_points_per_voxel_; }
 
+      /** \brief Set the number of threads to use for computing the leaf indices, sorting the points and
+        * computing the centroids. The result does not depend on the number of threads.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      void
+      setNumberOfThreads (unsigned int nr_threads = 0);
+
       /** \brief Set to true if leaf layout information needs to be saved for later access.
         * \param[in] save_leaf_layout the new value (true/false)
         */
@@ -282,6 +292,21 @@ namespace pcl
       inline bool
       getSaveLeafLayout () const { return (save_leaf_layout_); }
 
+      /** \brief Set to true to group the points with a hash map of 64 bit voxel keys instead of sorting
+        * 32 bit grid indices. This supports grids of up to 2^63 leaves (the grid indices overflow when the
+        * bounding box of the data spans more than 2^31 leaves, e.g. for city scale clouds) in O(n) expected
+        * time, with a memory use proportional to the number of occupied voxels. The centroids are the same,
+        * but they are output in order of first appearance of their voxel instead of in grid order, the
+        * leaf layout can not be saved, and the points are grouped on a single thread.
+        * \param[in] voxel_hashing the new value (true/false)
+        */
+      inline void
+      setVoxelHashing (bool voxel_hashing) { voxel_hashing_ = voxel_hashing; }
+
+      /** \brief Returns true if the points are grouped with a hash map of the voxels. */
+      inline bool
+      getVoxelHashing () const { return (voxel_hashing_); }
+
       /** \brief Get the minimum coordinates of the bounding box (after
         * filtering is performed).
         */
@@ -451,6 +476,19 @@ namespace pcl
         return (filter_limit_negative_);
       }
 
+      using Filter<PointT>::filter;
+
+      /** \brief Downsample a compact point cloud. The points are decoded one at a time (see
+        * CompactPointCloud::getPoint) while they are binned and averaged, so no decoded copy of the whole
+        * cloud is made. The input cloud and indices set with setInputCloud and setIndices are not used.
+        * \param[in] input the compact point cloud
+        * \param[out] output the resultant point cloud
+        * \note With a filter field, the bounding box of the grid covers all the valid points of \a input,
+        * not only the ones within the filter limits. The centroids are the same, only the leaf layout may be larger.
+        */
+      template <typename CoordinateT> void
+      filter (const CompactPointCloud<CoordinateT> &input, PointCloud &output);
+
     protected:
       /** \brief The size of a leaf. */
       Eigen::Vector4f leaf_size_;
@@ -485,6 +523,12 @@ namespace pcl
       /** \brief Minimum number of points per voxel for the centroid to be computed */
       unsigned int min_points_per_voxel_;
 
+      /** \brief The number of threads to use. */
+      unsigned int threads_;
+
+      /** \brief Set to true to group the points with a hash map of the voxels instead of sorting them. */
+      bool voxel_hashing_;
+
       using FieldList = typename pcl::traits::fieldList<PointT>::type;
 
       /** \brief Downsample a Point Cloud using a voxelized grid approach
@@ -492,6 +536,21 @@ namespace pcl
         */
       void
       applyFilter (PointCloud &output) override;
+
+      /** \brief Compute the centroids of the voxels of a set of points, the core of \ref applyFilter.
+        * \param[in] nr_points the number of points to downsample
+        * \param[in] index_of maps 0 ... nr_points - 1 to the index of a point in the input
+        * \param[in] point_of returns the point (PointT or a reference to it) at an index of the input
+        * \param[in] is_dense whether all the points of the input are finite
+        * \param[in] min_p the minimum corner of the bounding box of the points
+        * \param[in] max_p the maximum corner of the bounding box of the points
+        * \param[out] output the centroids
+        * \return false if the leaf size is too small for the bounding box, in which case \a output is untouched
+        */
+      template <typename IndexFunction, typename PointFunction> bool
+      computeCentroids (std::size_t nr_points, const IndexFunction &index_of, const PointFunction &point_of,
+                        bool is_dense, const Eigen::Vector4f &min_p, const Eigen::Vector4f &max_p,
+                        PointCloud &output);
   };
 
   /** \brief VoxelGrid assembles a local 3D grid over a given PointCloud, and downsamples + filters the data.
@@ -531,7 +590,9 @@ namespace pcl
         filter_limit_min_ (-FLT_MAX),
         filter_limit_max_ (FLT_MAX),
         filter_limit_negative_ (false),
-        min_points_per_voxel_ (0)
+        min_points_per_voxel_ (0),
+        threads_ (1),
+        voxel_hashing_ (false)
       {
         filter_name_ = "VoxelGrid";
       }
@@ -598,6 +659,13 @@ namespace pcl
 	  inline unsigned int
 	  getMinimumPointsNumberPerVoxel () const { return min_points_per_voxel_; }
 
+      /** \brief Set the number of threads to use for computing the leaf indices, sorting the points and
+        * computing the centroids. The result does not depend on the number of threads.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      void
+      setNumberOfThreads (unsigned int nr_threads = 0);
+
       /** \brief Set to true if leaf layout information needs to be saved for later access.
         * \param[in] save_leaf_layout the new value (true/false)
         */
@@ -608,6 +676,21 @@ namespace pcl
       inline bool
       getSaveLeafLayout () const { return (save_leaf_layout_); }
 
+      /** \brief Set to true to group the points with a hash map of 64 bit voxel keys instead of sorting
+        * 32 bit grid indices. This supports grids of up to 2^63 leaves (the grid indices overflow when the
+        * bounding box of the data spans more than 2^31 leaves, e.g. for city scale clouds) in O(n) expected
+        * time, with a memory use proportional to the number of occupied voxels. The centroids are the same,
+        * but they are output in order of first appearance of their voxel instead of in grid order, the
+        * leaf layout can not be saved, and the points are grouped on a single thread.
+        * \param[in] voxel_hashing the new value (true/false)
+        */
+      inline void
+      setVoxelHashing (bool voxel_hashing) { voxel_hashing_ = voxel_hashing; }
+
+      /** \brief Returns true if the points are grouped with a hash map of the voxels. */
+      inline bool
+      getVoxelHashing () const { return (voxel_hashing_); }
+
       /** \brief Get the minimum coordinates of the bounding box (after
         * filtering is performed).
         */
@@ -839,6 +922,12 @@ namespace pcl
       /** \brief Minimum number of points per voxel for the centroid to be computed */
       unsigned int min_points_per_voxel_;
 
+      /** \brief The number of threads to use. */
+      unsigned int threads_;
+
+      /** \brief Set to true to group the points with a hash map of the voxels instead of sorting them. */
+      bool voxel_hashing_;
+
       /** \brief Downsample a Point Cloud using a voxelized grid approach
         * \param[out] output the resultant point cloud
         */
@@ -426,6 +426,23 @@ namespace pcl
         return voxel_centroids_;
       }
 
+      /** \brief Get the memory used by the voxel grid: the leaf map, the leaf layout,
+       * the voxel centroids and the kd-tree built on them.
+       * \note The map node overhead is estimated as four pointers per leaf.
+       * \return memory in bytes
+       */
+      inline std::size_t
+      getMemoryUsage () const
+      {
+        std::size_t memory = sizeof (*this) + leaf_layout_.capacity () * sizeof (int) +
+                             leaves_.size () * (sizeof (typename std::map<std::size_t, Leaf>::value_type) + 4 * sizeof (void*));
+        for (const auto &leaf : leaves_)
+          memory += leaf.second.centroid.size () * sizeof (float);
+        if (voxel_centroids_)
+          memory += voxel_centroids_->getMemoryUsage ();
+        return (memory + kdtree_.getMemoryUsage () - sizeof (kdtree_));
+      }
+
 
       /** \brief Get a cloud to visualize each voxels normal distribution.
        * \param[out] cell_cloud a cloud created by sampling the normal distributions of each voxel
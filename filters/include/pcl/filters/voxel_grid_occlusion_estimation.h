@@ -42,12 +42,17 @@
 
 #include <pcl/filters/voxel_grid.h>
 
+#include <vector>
+
 namespace pcl
 {
   /** \brief VoxelGrid to estimate occluded space in the scene.
     * The ray traversal algorithm is implemented by the work of 
     * 'John Amanatides and Andrew Woo, A Fast Voxel Traversal Algorithm for Ray Tracing'
     *
+    * The rays of \ref occlusionEstimationAll and \ref computeFreeSpaceCounts are
+    * traversed in parallel, with the number of threads given by \ref setNumberOfThreads.
+    *
     * \author Christian Potthast
     * \ingroup filters
     */
@@ -60,6 +65,9 @@ namespace pcl
       using VoxelGrid<PointT>::div_b_;
       using VoxelGrid<PointT>::leaf_size_;
       using VoxelGrid<PointT>::inverse_leaf_size_;
+      using VoxelGrid<PointT>::divb_mul_;
+      using VoxelGrid<PointT>::leaf_layout_;
+      using VoxelGrid<PointT>::threads_;
 
       using PointCloud = typename Filter<PointT>::PointCloud;
       using PointCloudPtr = typename PointCloud::Ptr;
@@ -113,12 +121,25 @@ namespace pcl
 
       /** \brief Computes the voxel coordinates (i, j, k) of all occluded
         * voxels in the voxel grid.
-        * \param[out] occluded_voxels the coordinates (i, j, k) of all occluded voxels
+        * \param[out] occluded_voxels the coordinates (i, j, k) of all occluded voxels,
+        * in the order of the leaf layout whatever the number of threads
         * \return 0 upon success and -1 if an error occurs
         */
       int
       occlusionEstimationAll (std::vector<Eigen::Vector3i, Eigen::aligned_allocator<Eigen::Vector3i> >& occluded_voxels);
 
+      /** \brief Casts a ray from the sensor origin to each occupied voxel, and counts
+        * for every voxel of the grid the rays passing through it before reaching
+        * their target, i.e. the number of times it was observed as free space.
+        * The rays start at the sensor origin, or where they enter the grid if the
+        * sensor lies outside of it.
+        * \param[out] free_counts the number of rays passing through each voxel, the voxel
+        * (i, j, k) being at (ijk - min_b).dot (division multiplier) like in the leaf layout
+        * \return 0 upon success and -1 if an error occurs
+        */
+      int
+      computeFreeSpaceCounts (std::vector<unsigned int>& free_counts);
+
       /** \brief Returns the voxel grid filtered point cloud
         * \return The voxel grid filtered point cloud
         */
@@ -144,7 +165,7 @@ namespace pcl
         * \return the (x,y,z) coordinate of the voxel centroid
         */
       inline Eigen::Vector4f
-      getCentroidCoordinate (const Eigen::Vector3i& ijk)
+      getCentroidCoordinate (const Eigen::Vector3i& ijk) const
       {
         int i,j,k;
         i = ((b_min_[0] < 0) ? (std::abs (min_b_[0]) + ijk[0]) : (ijk[0] - min_b_[0]));
@@ -207,12 +228,28 @@ namespace pcl
                     const Eigen::Vector4f& direction,
                     const float t_min);
 
+      /** \brief Walks the voxels on a ray until it reaches the target voxel or leaves the grid.
+        * \param[in] target_voxel The target voxel in the voxel grid with coordinate (i, j, k).
+        * \param[in] origin The sensor origin.
+        * \param[in] direction The sensor orientation
+        * \param[in] t_min The scaling value (tmin).
+        * \param[in] visit Called with the leaf layout index of each voxel before the target,
+        * the traversal stops if it returns true.
+        * \return true if the traversal was stopped by \a visit
+        */
+      template <typename VoxelFunction> bool
+      traverseRay (const Eigen::Vector3i& target_voxel,
+                   const Eigen::Vector4f& origin,
+                   const Eigen::Vector4f& direction,
+                   const float t_min,
+                   const VoxelFunction& visit) const;
+
       /** \brief Returns a rounded value. 
         * \param[in] d
         * \return rounded value
         */
       inline float
-      round (float d)
+      round (float d) const
       {
         return static_cast<float> (std::floor (d + 0.5f));
       }
@@ -224,7 +261,7 @@ namespace pcl
         * \param[in] z the Z point coordinate to get the (i, j, k) index at
         */
       inline Eigen::Vector3i
-      getGridCoordinatesRound (float x, float y, float z) 
+      getGridCoordinatesRound (float x, float y, float z) const
       {
         return Eigen::Vector3i (static_cast<int> (round (x * inverse_leaf_size_[0])), 
                                 static_cast<int> (round (y * inverse_leaf_size_[1])), 
@@ -39,6 +39,68 @@
  */
 
 #include <pcl/filters/impl/extract_indices.hpp>
+#include <pcl/common/utils.h> // for pcl::utils::getNumberOfThreads
+
+#include <cstddef>
+#include <numeric>
+
+///////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::detail::complementIndices (std::size_t nr_points, const Indices &indices, Indices &complement,
+                                unsigned int nr_threads)
+{
+  std::vector<std::uint8_t> removed (nr_points, 0);
+  for (const auto &index : indices)
+    if (index >= 0 && static_cast<std::size_t> (index) < nr_points)
+      removed[index] = 1;
+
+  // Count the remaining points of every block, then write every block at its offset
+  const std::size_t block_size = 1 << 16;
+  const auto nr_blocks = static_cast<std::ptrdiff_t> ((nr_points + block_size - 1) / block_size);
+  std::vector<std::size_t> offsets (nr_blocks + 1, 0);
+  pcl::utils::ignore (nr_threads);
+#pragma omp parallel for \
+  default(none) \
+  shared(nr_blocks, nr_points, offsets, removed) \
+  num_threads(pcl::utils::getNumberOfThreads (nr_threads))
+  for (std::ptrdiff_t b = 0; b < nr_blocks; ++b)
+  {
+    const std::size_t end = (std::min) (nr_points, (b + 1) * block_size);
+    std::size_t nr_remaining = 0;
+    for (std::size_t i = b * block_size; i < end; ++i)
+      nr_remaining += !removed[i];
+    offsets[b + 1] = nr_remaining;
+  }
+  std::partial_sum (offsets.begin (), offsets.end (), offsets.begin ());
+
+  complement.resize (offsets.back ());
+#pragma omp parallel for \
+  default(none) \
+  shared(complement, nr_blocks, nr_points, offsets, removed) \
+  num_threads(pcl::utils::getNumberOfThreads (nr_threads))
+  for (std::ptrdiff_t b = 0; b < nr_blocks; ++b)
+  {
+    const std::size_t end = (std::min) (nr_points, (b + 1) * block_size);
+    std::size_t j = offsets[b];
+    for (std::size_t i = b * block_size; i < end; ++i)
+      if (!removed[i])
+        complement[j++] = static_cast<index_t> (i);
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::ExtractIndices<pcl::PCLPointCloud2>::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs ();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
 
 ///////////////////////////////////////////////////////////////////////////////////////////
 void
@@ -57,18 +119,9 @@ pcl::ExtractIndices<pcl::PCLPointCloud2>::applyFilter (PCLPointCloud2 &output)
     }
     else
     {
-      // Prepare a vector holding all indices
-      std::vector<int> all_indices (input_->width * input_->height);
-      for (int i = 0; i < static_cast<int>(all_indices.size ()); ++i)
-        all_indices[i] = i;
-
-      std::vector<int> indices = *indices_;
-      std::sort (indices.begin (), indices.end ());
-
-      // Get the diference
-      std::vector<int> remaining_indices;
-      set_difference (all_indices.begin (), all_indices.end (), indices.begin (), indices.end (),
-                      inserter (remaining_indices, remaining_indices.begin ()));
+      Indices remaining_indices;
+      detail::complementIndices (static_cast<std::size_t> (input_->width) * input_->height, *indices_,
+                                 remaining_indices, threads_);
 
       // Prepare the output and copy the data
       for (const int &remaining_index : remaining_indices)
@@ -103,43 +156,17 @@ pcl::ExtractIndices<pcl::PCLPointCloud2>::applyFilter (PCLPointCloud2 &output)
     return;
   }
 
-  // Copy the common fields (header and fields should have already been copied)
-  output.is_bigendian = input_->is_bigendian;
-  output.point_step   = input_->point_step;
-  output.height       = 1;
-  // TODO: check the output cloud and assign is_dense based on whether the points are valid or not
-  output.is_dense     = false;
-
   if (negative_)
   {
-    // Prepare a vector holding all indices
-    std::vector<int> all_indices (input_->width * input_->height);
-    for (int i = 0; i < static_cast<int>(all_indices.size ()); ++i)
-      all_indices[i] = i;
-
-    std::vector<int> indices = *indices_;
-    std::sort (indices.begin (), indices.end ());
-
-    // Get the diference
-    std::vector<int> remaining_indices;
-    set_difference (all_indices.begin (), all_indices.end (), indices.begin (), indices.end (),
-                    inserter (remaining_indices, remaining_indices.begin ()));
-
-    // Prepare the output and copy the data
-    output.width = remaining_indices.size ();
-    output.data.resize (remaining_indices.size () * output.point_step);
-    for (std::size_t i = 0; i < remaining_indices.size (); ++i)
-      memcpy (&output.data[i * output.point_step], &input_->data[remaining_indices[i] * output.point_step], output.point_step);
+    Indices remaining_indices;
+    detail::complementIndices (static_cast<std::size_t> (input_->width) * input_->height, *indices_,
+                               remaining_indices, threads_);
+    copyPointCloud (*input_, remaining_indices, output, threads_);
   }
   else
-  {
-    // Prepare the output and copy the data
-    output.width = indices_->size ();
-    output.data.resize (indices_->size () * output.point_step);
-    for (std::size_t i = 0; i < indices_->size (); ++i)
-      memcpy (&output.data[i * output.point_step], &input_->data[(*indices_)[i] * output.point_step], output.point_step);
-  }
-  output.row_step = output.point_step * output.width;
+    copyPointCloud (*input_, *indices_, output, threads_);
+  // TODO: check the output cloud and assign is_dense based on whether the points are valid or not
+  output.is_dense = false;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -160,34 +187,17 @@ pcl::ExtractIndices<pcl::PCLPointCloud2>::applyFilter (std::vector<int> &indices
 
     if (extract_removed_indices_)
     {
-      // Set up the full indices set
-      std::vector<int> full_indices (input_->width * input_->height);
-      for (int fii = 0; fii < static_cast<int> (full_indices.size ()); ++fii)  // fii = full indices iterator
-        full_indices[fii] = fii;
-
-      // Set up the sorted input indices
-      std::vector<int> sorted_input_indices = *indices_;
-      std::sort (sorted_input_indices.begin (), sorted_input_indices.end ());
-
-      // Store the difference in removed_indices
-      removed_indices_->clear ();
-      std::set_difference (full_indices.begin (), full_indices.end (), sorted_input_indices.begin (), sorted_input_indices.end (), std::inserter (*removed_indices_, removed_indices_->begin ()));
+      // A previous inverted run shares the removed indices with the input indices
+      if (removed_indices_ == indices_)
+        removed_indices_.reset (new Indices);
+      detail::complementIndices (static_cast<std::size_t> (input_->width) * input_->height, *indices_,
+                                 *removed_indices_, threads_);
     }
   }
   else  // Inverted functionality
   {
-    // Set up the full indices set
-    std::vector<int> full_indices (input_->width * input_->height);
-    for (int fii = 0; fii < static_cast<int> (full_indices.size ()); ++fii)  // fii = full indices iterator
-      full_indices[fii] = fii;
-
-    // Set up the sorted input indices
-    std::vector<int> sorted_input_indices = *indices_;
-    std::sort (sorted_input_indices.begin (), sorted_input_indices.end ());
-
-    // Store the difference in indices
-    indices.clear ();
-    std::set_difference (full_indices.begin (), full_indices.end (), sorted_input_indices.begin (), sorted_input_indices.end (), std::inserter (indices, indices.begin ()));
+    detail::complementIndices (static_cast<std::size_t> (input_->width) * input_->height, *indices_,
+                               indices, threads_);
 
     if (extract_removed_indices_)
       removed_indices_ = indices_;
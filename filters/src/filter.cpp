@@ -49,8 +49,10 @@
 void
 pcl::Filter<pcl::PCLPointCloud2>::filter (PCLPointCloud2 &output)
 {
+  PCL_INSTRUMENT_SCOPE (getClassName ());
   if (!initCompute ())
     return;
+  PCL_INSTRUMENT_COUNT (getClassName () + ".input_points", indices_->size ());
 
   if (input_.get () == &output)  // cloud_in = cloud_out
   {
@@ -66,6 +68,7 @@ pcl::Filter<pcl::PCLPointCloud2>::filter (PCLPointCloud2 &output)
     output.header = input_->header;
     applyFilter (output);
   }
+  PCL_INSTRUMENT_COUNT (getClassName () + ".output_points", static_cast<std::uint64_t> (output.width) * output.height);
 
   deinitCompute ();
 }
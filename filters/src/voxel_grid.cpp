@@ -41,7 +41,6 @@
 #include <iostream>
 #include <pcl/common/io.h>
 #include <pcl/filters/impl/voxel_grid.hpp>
-#include <boost/sort/spreadsort/integer_sort.hpp>
 
 using Array4size_t = Eigen::Array<std::size_t, 4, 1>;
 
@@ -227,7 +226,8 @@ pcl::VoxelGrid<pcl::PCLPointCloud2>::applyFilter (PCLPointCloud2 &output)
   std::int64_t dy = static_cast<std::int64_t>((max_p[1] - min_p[1]) * inverse_leaf_size_[1])+1;
   std::int64_t dz = static_cast<std::int64_t>((max_p[2] - min_p[2]) * inverse_leaf_size_[2])+1;
 
-  if( (dx*dy*dz) > static_cast<std::int64_t>(std::numeric_limits<std::int32_t>::max()) )
+  if (voxel_hashing_ ? !detail::isHashableVoxelGrid (dx, dy, dz) :
+      (dx*dy*dz) > static_cast<std::int64_t>(std::numeric_limits<std::int32_t>::max()) )
   {
     PCL_WARN("[pcl::%s::applyFilter] Leaf size is too small for the input dataset. Integer indices would overflow.", getClassName().c_str());
     //output.width = output.height = 0;
@@ -235,6 +235,15 @@ pcl::VoxelGrid<pcl::PCLPointCloud2>::applyFilter (PCLPointCloud2 &output)
     //return;
   }
 
+  // The leaf layout needs the grid indices, which are not computed when hashing the voxels
+  bool save_leaf_layout = save_leaf_layout_;
+  if (save_leaf_layout && voxel_hashing_)
+  {
+    PCL_WARN ("[pcl::%s::applyFilter] The leaf layout can not be saved when hashing the voxels.\n", getClassName ().c_str ());
+    leaf_layout_.clear ();
+    save_leaf_layout = false;
+  }
+
   // Compute the minimum and maximum bounding box values
   min_b_[0] = static_cast<int> (std::floor (min_p[0] * inverse_leaf_size_[0]));
   max_b_[0] = static_cast<int> (std::floor (max_p[0] * inverse_leaf_size_[0]));
@@ -247,16 +256,8 @@ pcl::VoxelGrid<pcl::PCLPointCloud2>::applyFilter (PCLPointCloud2 &output)
   div_b_ = max_b_ - min_b_ + Eigen::Vector4i::Ones ();
   div_b_[3] = 0;
 
-  std::vector<cloud_point_index_idx> index_vector;
-  index_vector.reserve (nr_points);
-
-  // Create the first xyz_offset, and set up the division multiplier
-  Array4size_t xyz_offset (input_->fields[x_idx_].offset,
-                           input_->fields[y_idx_].offset,
-                           input_->fields[z_idx_].offset,
-                           0);
+  // Set up the division multiplier
   divb_mul_ = Eigen::Vector4i (1, div_b_[0], div_b_[0] * div_b_[1], 0);
-  Eigen::Vector4f pt  = Eigen::Vector4f::Zero ();
 
   int centroid_size = 4;
   int rgba_index = -1;
@@ -277,8 +278,9 @@ pcl::VoxelGrid<pcl::PCLPointCloud2>::applyFilter (PCLPointCloud2 &output)
       }
     }
   }
-  
+
   // If we don't want to process the entire cloud, but rather filter points far away from the viewpoint first...
+  std::uint32_t distance_offset = 0;
   if (!filter_field_name_.empty ())
   {
     // Get the distance field index
@@ -292,114 +294,120 @@ pcl::VoxelGrid<pcl::PCLPointCloud2>::applyFilter (PCLPointCloud2 &output)
       output.data.clear ();
       return;
     }
+    distance_offset = input_->fields[distance_idx].offset;
+  }
 
-    // First pass: go over all points and insert them into the index_vector vector
-    // with calculated idx. Points with the same idx value will contribute to the
-    // same point of resulting CloudPoint
-    float distance_value = 0;
-    for (std::size_t cp = 0; cp < nr_points; ++cp)
+  // Read the coordinates of the cp-th point, or return false if it does not contribute to a centroid
+  const Array4size_t xyz_offset (input_->fields[x_idx_].offset,
+                                 input_->fields[y_idx_].offset,
+                                 input_->fields[z_idx_].offset,
+                                 0);
+  const auto use_point = [this, &xyz_offset, distance_offset] (std::size_t cp, Eigen::Vector4f &pt)
+  {
+    std::size_t point_offset = cp * input_->point_step;
+    if (!filter_field_name_.empty ())
     {
-      std::size_t point_offset = cp * input_->point_step;
       // Get the distance value
-      memcpy (&distance_value, &input_->data[point_offset + input_->fields[distance_idx].offset], sizeof (float));
+      float distance_value = 0;
+      memcpy (&distance_value, &input_->data[point_offset + distance_offset], sizeof (float));
 
       if (filter_limit_negative_)
       {
         // Use a threshold for cutting out points which inside the interval
         if (distance_value < filter_limit_max_ && distance_value > filter_limit_min_)
-        {
-          xyz_offset += input_->point_step;
-          continue;
-        }
+          return (false);
       }
       else
       {
         // Use a threshold for cutting out points which are too close/far away
         if (distance_value > filter_limit_max_ || distance_value < filter_limit_min_)
-        {
-          xyz_offset += input_->point_step;
-          continue;
-        }
+          return (false);
       }
+    }
 
-      // Unoptimized memcpys: assume fields x, y, z are in random order
-      memcpy (&pt[0], &input_->data[xyz_offset[0]], sizeof (float));
-      memcpy (&pt[1], &input_->data[xyz_offset[1]], sizeof (float));
-      memcpy (&pt[2], &input_->data[xyz_offset[2]], sizeof (float));
+    // Unoptimized memcpys: assume fields x, y, z are in random order
+    memcpy (&pt[0], &input_->data[point_offset + xyz_offset[0]], sizeof (float));
+    memcpy (&pt[1], &input_->data[point_offset + xyz_offset[1]], sizeof (float));
+    memcpy (&pt[2], &input_->data[point_offset + xyz_offset[2]], sizeof (float));
 
-      // Check if the point is invalid
-      if (!std::isfinite (pt[0]) || 
-          !std::isfinite (pt[1]) || 
-          !std::isfinite (pt[2]))
-      {
-        xyz_offset += input_->point_step;
-        continue;
-      }
+    // Check if the point is invalid
+    return (std::isfinite (pt[0]) &&
+            std::isfinite (pt[1]) &&
+            std::isfinite (pt[2]));
+  };
 
-      int ijk0 = static_cast<int> (std::floor (pt[0] * inverse_leaf_size_[0]) - min_b_[0]);
-      int ijk1 = static_cast<int> (std::floor (pt[1] * inverse_leaf_size_[1]) - min_b_[1]);
-      int ijk2 = static_cast<int> (std::floor (pt[2] * inverse_leaf_size_[2]) - min_b_[2]);
-      // Compute the centroid leaf index
-      int idx = ijk0 * divb_mul_[0] + ijk1 * divb_mul_[1] + ijk2 * divb_mul_[2];
-      index_vector.emplace_back(idx, static_cast<unsigned int> (cp));
+  std::vector<cloud_point_index_idx> index_vector;
 
-      xyz_offset += input_->point_step;
-    }
+  if (voxel_hashing_)
+  {
+    // First pass: go over all points and group them by voxel, with the 64 bit index of their voxel
+    // as key. The voxels are numbered in order of appearance, no sort is needed
+    const std::uint64_t key_mul_y = static_cast<std::uint64_t> (dx);
+    const std::uint64_t key_mul_z = static_cast<std::uint64_t> (dx) * static_cast<std::uint64_t> (dy);
+    detail::computeHashedVoxelIndices (nr_points,
+                                       [&] (std::size_t cp, std::uint64_t &key, unsigned int &cloud_point_index)
+    {
+      Eigen::Vector4f pt = Eigen::Vector4f::Zero ();
+      if (!use_point (cp, pt))
+        return (false);
+
+      std::int64_t ijk0 = static_cast<std::int64_t> (std::floor (pt[0] * inverse_leaf_size_[0]) - min_b_[0]);
+      std::int64_t ijk1 = static_cast<std::int64_t> (std::floor (pt[1] * inverse_leaf_size_[1]) - min_b_[1]);
+      std::int64_t ijk2 = static_cast<std::int64_t> (std::floor (pt[2] * inverse_leaf_size_[2]) - min_b_[2]);
+      key = static_cast<std::uint64_t> (ijk0) + static_cast<std::uint64_t> (ijk1) * key_mul_y +
+            static_cast<std::uint64_t> (ijk2) * key_mul_z;
+      cloud_point_index = static_cast<unsigned int> (cp);
+      return (true);
+    }, index_vector);
   }
-  // No distance filtering, process all data
   else
   {
-    // First pass: go over all points and insert them into the right leaf
-    for (std::size_t cp = 0; cp < nr_points; ++cp)
+    // First pass: go over all points and insert them into the index_vector vector
+    // with calculated idx. Points with the same idx value will contribute to the
+    // same point of resulting CloudPoint
+    detail::computeVoxelIndices (nr_points, threads_,
+                                 [&] (std::size_t cp, unsigned int &idx, unsigned int &cloud_point_index)
     {
-      // Unoptimized memcpys: assume fields x, y, z are in random order
-      memcpy (&pt[0], &input_->data[xyz_offset[0]], sizeof (float));
-      memcpy (&pt[1], &input_->data[xyz_offset[1]], sizeof (float));
-      memcpy (&pt[2], &input_->data[xyz_offset[2]], sizeof (float));
-
-      // Check if the point is invalid
-      if (!std::isfinite (pt[0]) || 
-          !std::isfinite (pt[1]) || 
-          !std::isfinite (pt[2]))
-      {
-        xyz_offset += input_->point_step;
-        continue;
-      }
+      Eigen::Vector4f pt = Eigen::Vector4f::Zero ();
+      if (!use_point (cp, pt))
+        return (false);
 
       int ijk0 = static_cast<int> (std::floor (pt[0] * inverse_leaf_size_[0]) - min_b_[0]);
       int ijk1 = static_cast<int> (std::floor (pt[1] * inverse_leaf_size_[1]) - min_b_[1]);
       int ijk2 = static_cast<int> (std::floor (pt[2] * inverse_leaf_size_[2]) - min_b_[2]);
       // Compute the centroid leaf index
-      int idx = ijk0 * divb_mul_[0] + ijk1 * divb_mul_[1] + ijk2 * divb_mul_[2];
-      index_vector.emplace_back(idx, static_cast<unsigned int> (cp));
-      xyz_offset += input_->point_step;
-    }
+      idx = static_cast<unsigned int> (ijk0 * divb_mul_[0] + ijk1 * divb_mul_[1] + ijk2 * divb_mul_[2]);
+      cloud_point_index = static_cast<unsigned int> (cp);
+      return (true);
+    }, index_vector);
+
+    // Second pass: sort the index_vector vector using value representing target cell as index
+    // in effect all points belonging to the same output cell will be next to each other
+    detail::sortVoxelIndices (index_vector, threads_);
   }
 
-  // Second pass: sort the index_vector vector using value representing target cell as index
-  // in effect all points belonging to the same output cell will be next to each other
-  auto rightshift_func = [](const cloud_point_index_idx &x, const unsigned offset) { return x.idx >> offset; };
-  boost::sort::spreadsort::integer_sort(index_vector.begin(), index_vector.end(), rightshift_func);
-
   // Third pass: count output cells
   // we need to skip all the same, adjacenent idx values
-  std::size_t total = 0;
+  // first_and_last_indices_vector[i] holds the indices in index_vector of the first point of the
+  // i-th output cell, and of the first point not belonging to it
+  std::vector<std::pair<std::size_t, std::size_t> > first_and_last_indices_vector;
   std::size_t index = 0;
   while (index < index_vector.size ()) 
   {
     std::size_t i = index + 1;
     while (i < index_vector.size () && index_vector[i].idx == index_vector[index].idx) 
       ++i;
-    ++total;
+    first_and_last_indices_vector.emplace_back (index, i);
     index = i;
   }
+  std::size_t total = first_and_last_indices_vector.size ();
 
   // Fourth pass: compute centroids, insert them into their final position
   output.width = std::uint32_t (total);
   output.row_step = output.point_step * output.width;
   output.data.resize (output.width * output.point_step);
 
-  if (save_leaf_layout_) 
+  if (save_leaf_layout) 
   {
     try
     {
@@ -426,63 +434,46 @@ pcl::VoxelGrid<pcl::PCLPointCloud2>::applyFilter (PCLPointCloud2 &output)
   }
   
   // If we downsample each field, the {x,y,z}_idx_ offsets should correspond in input_ and output
+  Array4size_t output_xyz_offset;
   if (downsample_all_data_)
-    xyz_offset = Array4size_t (output.fields[x_idx_].offset,
-                               output.fields[y_idx_].offset,
-                               output.fields[z_idx_].offset,
-                               0);
+    output_xyz_offset = Array4size_t (output.fields[x_idx_].offset,
+                                      output.fields[y_idx_].offset,
+                                      output.fields[z_idx_].offset,
+                                      0);
   else
     // If not, we must have created a new xyzw cloud
-    xyz_offset = Array4size_t (0, 4, 8, 12);
-
-  index=0;
-  Eigen::VectorXf centroid = Eigen::VectorXf::Zero (centroid_size);
-  Eigen::VectorXf temporary = Eigen::VectorXf::Zero (centroid_size);
+    output_xyz_offset = Array4size_t (0, 4, 8, 12);
 
-  for (std::size_t cp = 0; cp < index_vector.size ();)
+  // The centroids are independent of each other, and each of them is accumulated by a single thread
+#pragma omp parallel \
+  default(none) \
+  shared(centroid_size, first_and_last_indices_vector, index_vector, output, output_xyz_offset, rgba_index, save_leaf_layout) \
+  num_threads(threads_)
   {
-    std::size_t point_offset = index_vector[cp].cloud_point_index * input_->point_step;
-    // Do we need to process all the fields?
-    if (!downsample_all_data_) 
-    {
-      memcpy (&pt[0], &input_->data[point_offset+input_->fields[x_idx_].offset], sizeof (float));
-      memcpy (&pt[1], &input_->data[point_offset+input_->fields[y_idx_].offset], sizeof (float));
-      memcpy (&pt[2], &input_->data[point_offset+input_->fields[z_idx_].offset], sizeof (float));
-      centroid[0] = pt[0];
-      centroid[1] = pt[1];
-      centroid[2] = pt[2];
-      centroid[3] = 0;
-    }
-    else
-    {
-      // ---[ RGB special case
-      // fill extra r/g/b centroid field
-      if (rgba_index >= 0)
-      {
-        pcl::RGB rgb;
-        memcpy (&rgb, &input_->data[point_offset + input_->fields[rgba_index].offset], sizeof (RGB));
-        centroid[centroid_size-4] = rgb.r;
-        centroid[centroid_size-3] = rgb.g;
-        centroid[centroid_size-2] = rgb.b;
-        centroid[centroid_size-1] = rgb.a;
-      }
-      // Copy all the fields
-      for (std::size_t d = 0; d < input_->fields.size (); ++d)
-        memcpy (&centroid[d], &input_->data[point_offset + input_->fields[d].offset], field_sizes_[d]);
-    }
+    Eigen::Vector4f pt = Eigen::Vector4f::Zero ();
+    Eigen::VectorXf centroid = Eigen::VectorXf::Zero (centroid_size);
+    Eigen::VectorXf temporary = Eigen::VectorXf::Zero (centroid_size);
 
-    std::size_t i = cp + 1;
-    while (i < index_vector.size () && index_vector[i].idx == index_vector[cp].idx) 
+#pragma omp for
+    for (std::ptrdiff_t index = 0; index < static_cast<std::ptrdiff_t> (first_and_last_indices_vector.size ()); ++index)
     {
-      std::size_t point_offset = index_vector[i].cloud_point_index * input_->point_step;
+      std::size_t cp = first_and_last_indices_vector[index].first;
+      std::size_t last = first_and_last_indices_vector[index].second;
+      std::size_t point_offset = index_vector[cp].cloud_point_index * input_->point_step;
+      // Fields smaller than a float only overwrite a part of their value, which must not depend on the
+      // voxels previously processed by this thread
+      centroid.setZero ();
+      temporary.setZero ();
+      // Do we need to process all the fields?
       if (!downsample_all_data_) 
       {
         memcpy (&pt[0], &input_->data[point_offset+input_->fields[x_idx_].offset], sizeof (float));
         memcpy (&pt[1], &input_->data[point_offset+input_->fields[y_idx_].offset], sizeof (float));
         memcpy (&pt[2], &input_->data[point_offset+input_->fields[z_idx_].offset], sizeof (float));
-        centroid[0] += pt[0];
-        centroid[1] += pt[1];
-        centroid[2] += pt[2];
+        centroid[0] = pt[0];
+        centroid[1] = pt[1];
+        centroid[2] = pt[2];
+        centroid[3] = 0;
       }
       else
       {
@@ -492,56 +483,98 @@ pcl::VoxelGrid<pcl::PCLPointCloud2>::applyFilter (PCLPointCloud2 &output)
         {
           pcl::RGB rgb;
           memcpy (&rgb, &input_->data[point_offset + input_->fields[rgba_index].offset], sizeof (RGB));
-          temporary[centroid_size-4] = rgb.r;
-          temporary[centroid_size-3] = rgb.g;
-          temporary[centroid_size-2] = rgb.b;
-          temporary[centroid_size-1] = rgb.a;
+          centroid[centroid_size-4] = rgb.r;
+          centroid[centroid_size-3] = rgb.g;
+          centroid[centroid_size-2] = rgb.b;
+          centroid[centroid_size-1] = rgb.a;
         }
         // Copy all the fields
         for (std::size_t d = 0; d < input_->fields.size (); ++d)
-          memcpy (&temporary[d], &input_->data[point_offset + input_->fields[d].offset], field_sizes_[d]);
-        centroid += temporary;
+          memcpy (&centroid[d], &input_->data[point_offset + input_->fields[d].offset], field_sizes_[d]);
       }
-      ++i;
-    }
 
-	  // Save leaf layout information for fast access to cells relative to current position
-    if (save_leaf_layout_)
-      leaf_layout_[index_vector[cp].idx] = static_cast<int> (index);
+      for (std::size_t i = cp + 1; i < last; ++i)
+      {
+        std::size_t point_offset = index_vector[i].cloud_point_index * input_->point_step;
+        if (!downsample_all_data_) 
+        {
+          memcpy (&pt[0], &input_->data[point_offset+input_->fields[x_idx_].offset], sizeof (float));
+          memcpy (&pt[1], &input_->data[point_offset+input_->fields[y_idx_].offset], sizeof (float));
+          memcpy (&pt[2], &input_->data[point_offset+input_->fields[z_idx_].offset], sizeof (float));
+          centroid[0] += pt[0];
+          centroid[1] += pt[1];
+          centroid[2] += pt[2];
+        }
+        else
+        {
+          // ---[ RGB special case
+          // fill extra r/g/b centroid field
+          if (rgba_index >= 0)
+          {
+            pcl::RGB rgb;
+            memcpy (&rgb, &input_->data[point_offset + input_->fields[rgba_index].offset], sizeof (RGB));
+            temporary[centroid_size-4] = rgb.r;
+            temporary[centroid_size-3] = rgb.g;
+            temporary[centroid_size-2] = rgb.b;
+            temporary[centroid_size-1] = rgb.a;
+          }
+          // Copy all the fields
+          for (std::size_t d = 0; d < input_->fields.size (); ++d)
+            memcpy (&temporary[d], &input_->data[point_offset + input_->fields[d].offset], field_sizes_[d]);
+          centroid += temporary;
+        }
+      }
 
-    // Normalize the centroid
-    centroid /= static_cast<float> (i - cp);
+      // Save leaf layout information for fast access to cells relative to current position
+      if (save_leaf_layout)
+        leaf_layout_[index_vector[cp].idx] = static_cast<int> (index);
 
-    // Do we need to process all the fields?
-    if (!downsample_all_data_)
-    {
-      // Copy the data
-      memcpy (&output.data[xyz_offset[0]], &centroid[0], sizeof (float));
-      memcpy (&output.data[xyz_offset[1]], &centroid[1], sizeof (float));
-      memcpy (&output.data[xyz_offset[2]], &centroid[2], sizeof (float));
-      xyz_offset += output.point_step;
-    }
-    else
-    {
-      std::size_t point_offset = index * output.point_step;
-      // Copy all the fields
-      for (std::size_t d = 0; d < output.fields.size (); ++d)
-        memcpy (&output.data[point_offset + output.fields[d].offset], &centroid[d], field_sizes_[d]);
-
-      // ---[ RGB special case
-      // full extra r/g/b centroid field
-      if (rgba_index >= 0) 
+      // Normalize the centroid
+      centroid /= static_cast<float> (last - cp);
+
+      // Do we need to process all the fields?
+      if (!downsample_all_data_)
       {
-        float r = centroid[centroid_size-4], g = centroid[centroid_size-3], b = centroid[centroid_size-2], a = centroid[centroid_size-1];
-        int rgb = (static_cast<int> (a) << 24) | (static_cast<int> (r) << 16) | (static_cast<int> (g) << 8) | static_cast<int> (b);
-        memcpy (&output.data[point_offset + output.fields[rgba_index].offset], &rgb, sizeof (float));
+        // Copy the data
+        std::size_t output_offset = index * output.point_step;
+        memcpy (&output.data[output_offset + output_xyz_offset[0]], &centroid[0], sizeof (float));
+        memcpy (&output.data[output_offset + output_xyz_offset[1]], &centroid[1], sizeof (float));
+        memcpy (&output.data[output_offset + output_xyz_offset[2]], &centroid[2], sizeof (float));
+      }
+      else
+      {
+        std::size_t point_offset = index * output.point_step;
+        // Copy all the fields
+        for (std::size_t d = 0; d < output.fields.size (); ++d)
+          memcpy (&output.data[point_offset + output.fields[d].offset], &centroid[d], field_sizes_[d]);
+
+        // ---[ RGB special case
+        // full extra r/g/b centroid field
+        if (rgba_index >= 0) 
+        {
+          float r = centroid[centroid_size-4], g = centroid[centroid_size-3], b = centroid[centroid_size-2], a = centroid[centroid_size-1];
+          int rgb = (static_cast<int> (a) << 24) | (static_cast<int> (r) << 16) | (static_cast<int> (g) << 8) | static_cast<int> (b);
+          memcpy (&output.data[point_offset + output.fields[rgba_index].offset], &rgb, sizeof (float));
+        }
       }
     }
-    cp = i;
-    ++index;
   }
 }
 
+///////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::VoxelGrid<pcl::PCLPointCloud2>::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs ();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
+
 #ifndef PCL_NO_PRECOMPILE
 #include <pcl/impl/instantiate.hpp>
 #include <pcl/point_types.h>
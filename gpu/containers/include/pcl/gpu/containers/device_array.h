@@ -118,6 +118,39 @@ namespace pcl
             template<typename A>
             void download(std::vector<T, A>& data) const;
 
+            /** \brief Queues the copy of the data on \a stream and returns. If destination size differs it will be reallocated.
+              * \param other destination container
+              * \param stream stream to queue the copy on
+              * */
+            void copyToAsync(DeviceArray& other, const Stream& stream) const;
+
+            /** \brief Queues the upload of data on \a stream and returns. See DeviceMemory::uploadAsync().
+              * \param host_ptr pointer to buffer to upload
+              * \param size elements number
+              * \param stream stream to queue the copy on
+              * */
+            void uploadAsync(const T *host_ptr, std::size_t size, const Stream& stream);
+
+            /** \brief Queues the download of data on \a stream and returns. See DeviceMemory::downloadAsync().
+              * \param host_ptr pointer to buffer to download
+              * \param stream stream to queue the copy on
+              * */
+            void downloadAsync(T *host_ptr, const Stream& stream) const;
+
+            /** \brief Queues the upload of a host vector on \a stream and returns, e.g. a std::vector with a PinnedAllocator.
+              * \param data host vector to upload from
+              * \param stream stream to queue the copy on
+              * */
+            template<class A>
+            void uploadAsync(const std::vector<T, A>& data, const Stream& stream);
+
+            /** \brief Resizes the host vector and queues the download to it on \a stream.
+              * \param data host vector to download to
+              * \param stream stream to queue the copy on
+              * */
+            template<typename A>
+            void downloadAsync(std::vector<T, A>& data, const Stream& stream) const;
+
             /** \brief Performs swap of data pointed with another device array. 
               * \param other_arg device array to swap with   
               * */
@@ -210,6 +243,28 @@ namespace pcl
               * */
             void download(void *host_ptr, std::size_t host_step) const;
 
+            /** \brief Queues the copy of the data on \a stream and returns. If destination size differs it will be reallocated.
+              * \param other destination container
+              * \param stream stream to queue the copy on
+              * */
+            void copyToAsync(DeviceArray2D& other, const Stream& stream) const;
+
+            /** \brief Queues the upload of data on \a stream and returns. See DeviceMemory2D::uploadAsync().
+              * \param host_ptr pointer to host buffer to upload
+              * \param host_step stride between two consecutive rows in bytes for host buffer
+              * \param rows number of rows to upload
+              * \param cols number of elements in each row
+              * \param stream stream to queue the copy on
+              * */
+            void uploadAsync(const void *host_ptr, std::size_t host_step, int rows, int cols, const Stream& stream);
+
+            /** \brief Queues the download of data on \a stream and returns. See DeviceMemory2D::downloadAsync().
+              * \param host_ptr pointer to host buffer to download
+              * \param host_step stride between two consecutive rows in bytes for host buffer
+              * \param stream stream to queue the copy on
+              * */
+            void downloadAsync(void *host_ptr, std::size_t host_step, const Stream& stream) const;
+
             /** \brief Performs swap of data pointed with another device array. 
               * \param other_arg device array to swap with   
               * */
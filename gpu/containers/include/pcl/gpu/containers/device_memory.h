@@ -38,6 +38,7 @@
 
 #include <pcl/pcl_exports.h>
 #include <pcl/gpu/containers/kernel_containers.h>
+#include <pcl/gpu/containers/stream.h>
 
 namespace pcl
 {
@@ -101,6 +102,26 @@ namespace pcl
               * */
             void download(void *host_ptr_arg) const;
 
+            /** \brief Queues the copy of the data on \a stream and returns. If destination size differs it will be reallocated.
+              * \param other destination container
+              * \param stream stream to queue the copy on
+              * */
+            void copyToAsync(DeviceMemory& other, const Stream& stream) const;
+
+            /** \brief Queues the upload of data on \a stream and returns. The host buffer must stay valid until the
+              * copy is done, and be page-locked (see PinnedAllocator) for the copy to overlap with other work.
+              * \param host_ptr_arg pointer to buffer to upload
+              * \param sizeBytes_arg buffer size
+              * \param stream stream to queue the copy on
+              * */
+            void uploadAsync(const void *host_ptr_arg, std::size_t sizeBytes_arg, const Stream& stream);
+
+            /** \brief Queues the download of data on \a stream and returns. The data is in the host buffer once the stream is done.
+              * \param host_ptr_arg pointer to buffer to download
+              * \param stream stream to queue the copy on
+              * */
+            void downloadAsync(void *host_ptr_arg, const Stream& stream) const;
+
             /** \brief Performs swap of data pointed with another device memory. 
               * \param other_arg device memory to swap with   
               * */
@@ -197,6 +218,29 @@ namespace pcl
               * */
             void download(void *host_ptr_arg, std::size_t host_step_arg) const;
 
+            /** \brief Queues the copy of the data on \a stream and returns. If destination size differs it will be reallocated.
+              * \param other destination container
+              * \param stream stream to queue the copy on
+              * */
+            void copyToAsync(DeviceMemory2D& other, const Stream& stream) const;
+
+            /** \brief Queues the upload of data on \a stream and returns. The host buffer must stay valid until the
+              * copy is done, and be page-locked (see PinnedAllocator) for the copy to overlap with other work.
+              * \param host_ptr_arg pointer to host buffer to upload
+              * \param host_step_arg stride between two consecutive rows in bytes for host buffer
+              * \param rows_arg number of rows to upload
+              * \param colsBytes_arg width of host buffer in bytes
+              * \param stream stream to queue the copy on
+              * */
+            void uploadAsync(const void *host_ptr_arg, std::size_t host_step_arg, int rows_arg, int colsBytes_arg, const Stream& stream);
+
+            /** \brief Queues the download of data on \a stream and returns. The data is in the host buffer once the stream is done.
+              * \param host_ptr_arg pointer to host buffer to download
+              * \param host_step_arg stride between two consecutive rows in bytes for host buffer
+              * \param stream stream to queue the copy on
+              * */
+            void downloadAsync(void *host_ptr_arg, std::size_t host_step_arg, const Stream& stream) const;
+
             /** \brief Performs swap of data pointed with another device memory. 
               * \param other_arg device memory to swap with   
               * */
@@ -78,6 +78,16 @@ template<class T> inline const T* DeviceArray<T>::ptr() const { return DeviceMem
 template<class T> template<class A> inline void DeviceArray<T>::upload(const std::vector<T, A>& data) { upload(&data[0], data.size()); }
 template<class T> template<class A> inline void DeviceArray<T>::download(std::vector<T, A>& data) const { data.resize(size()); if (!data.empty()) download(&data[0]); }
 
+template<class T> inline void DeviceArray<T>::copyToAsync(DeviceArray& other, const Stream& stream) const
+{ DeviceMemory::copyToAsync(other, stream); }
+template<class T> inline void DeviceArray<T>::uploadAsync(const T *host_ptr, std::size_t size, const Stream& stream)
+{ DeviceMemory::uploadAsync(host_ptr, size * elem_size, stream); }
+template<class T> inline void DeviceArray<T>::downloadAsync(T *host_ptr, const Stream& stream) const
+{ DeviceMemory::downloadAsync( host_ptr, stream ); }
+
+template<class T> template<class A> inline void DeviceArray<T>::uploadAsync(const std::vector<T, A>& data, const Stream& stream) { uploadAsync(&data[0], data.size(), stream); }
+template<class T> template<class A> inline void DeviceArray<T>::downloadAsync(std::vector<T, A>& data, const Stream& stream) const { data.resize(size()); if (!data.empty()) downloadAsync(&data[0], stream); }
+
 /////////////////////  Inline implementations of DeviceArray2D ////////////////////////////////////////////
 
 template<class T> inline DeviceArray2D<T>::DeviceArray2D() {}
@@ -99,6 +109,13 @@ template<class T> inline void DeviceArray2D<T>::upload(const void *host_ptr, std
 template<class T> inline void DeviceArray2D<T>::download(void *host_ptr, std::size_t host_step) const
 { DeviceMemory2D::download( host_ptr, host_step ); }
 
+template<class T> inline void DeviceArray2D<T>::copyToAsync(DeviceArray2D& other, const Stream& stream) const
+{ DeviceMemory2D::copyToAsync(other, stream); }
+template<class T> inline void DeviceArray2D<T>::uploadAsync(const void *host_ptr, std::size_t host_step, int rows, int cols, const Stream& stream)
+{ DeviceMemory2D::uploadAsync(host_ptr, host_step, rows, cols * elem_size, stream); }
+template<class T> inline void DeviceArray2D<T>::downloadAsync(void *host_ptr, std::size_t host_step, const Stream& stream) const
+{ DeviceMemory2D::downloadAsync( host_ptr, host_step, stream ); }
+
 template<class T> template<class A> inline void DeviceArray2D<T>::upload(const std::vector<T, A>& data, int cols)
 { upload(&data[0], cols * elem_size, data.size()/cols, cols); }
 
@@ -0,0 +1,131 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved
+ */
+
+#pragma once
+
+#include <pcl/pcl_exports.h>
+
+#include <cstddef>
+
+// Same types as cudaStream_t and cudaEvent_t, without including the Cuda headers
+struct CUstream_st;
+struct CUevent_st;
+
+namespace pcl
+{
+    namespace gpu
+    {
+        //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        /** \brief @b Stream class
+          *
+          * \note Owns a Cuda stream. The asynchronous copies of the containers are queued on it and its handle can
+          * be passed to kernel launches, so that the work of several pipelines (e.g. one per sensor) overlaps
+          * instead of serializing on the default stream.
+          */
+        class PCL_EXPORTS Stream
+        {
+        public:
+            /** \brief Creates a new non-blocking stream. */
+            Stream();
+
+            /** \brief Waits for the queued work and destroys the stream. */
+            ~Stream();
+
+            Stream(const Stream&) = delete;
+            Stream& operator=(const Stream&) = delete;
+
+            /** \brief Blocks until all the work queued on the stream is done. */
+            void waitForCompletion() const;
+
+            /** \brief Returns true if all the work queued on the stream is done, without blocking. */
+            bool queryIfComplete() const;
+
+            /** \brief Returns the cudaStream_t handle. */
+            CUstream_st* handle() const;
+
+        private:
+            CUstream_st* stream_;
+        };
+
+        //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        /** \brief @b Event class
+          *
+          * \note Owns a Cuda event, used to order work between streams or to wait on the host for part of the work
+          * queued on a stream.
+          */
+        class PCL_EXPORTS Event
+        {
+        public:
+            /** \brief Creates a new event.
+              * \param timing true to be able to measure the time elapsed between two events
+              */
+            Event(bool timing = false);
+
+            /** \brief Destroys the event. */
+            ~Event();
+
+            Event(const Event&) = delete;
+            Event& operator=(const Event&) = delete;
+
+            /** \brief Records the event once the work queued so far on \a stream is done. */
+            void record(const Stream& stream);
+
+            /** \brief Makes the work queued later on \a stream wait for the last recording of the event. */
+            void waitOn(const Stream& stream) const;
+
+            /** \brief Blocks until the last recording of the event is done. */
+            void waitForCompletion() const;
+
+            /** \brief Returns true if the last recording of the event is done, without blocking. */
+            bool queryIfComplete() const;
+
+            /** \brief Returns the time elapsed between the recordings of \a start and \a stop in milliseconds. */
+            static float elapsedTime(const Event& start, const Event& stop);
+
+            /** \brief Returns the cudaEvent_t handle. */
+            CUevent_st* handle() const;
+
+        private:
+            CUevent_st* event_;
+        };
+
+        /** \brief Allocates page-locked host memory, which the asynchronous copies need to overlap with the work of other streams. */
+        PCL_EXPORTS void* allocatePinned(std::size_t sizeBytes);
+
+        /** \brief Releases memory allocated with allocatePinned(). */
+        PCL_EXPORTS void freePinned(void* ptr);
+
+        //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        /** \brief @b PinnedAllocator class
+          *
+          * \note Allocator of page-locked host memory, e.g. for the std::vector a DeviceArray is uploaded from or
+          * downloaded to asynchronously.
+          */
+        template<class T>
+        struct PinnedAllocator
+        {
+            using value_type = T;
+
+            PinnedAllocator() = default;
+            template<class U> PinnedAllocator(const PinnedAllocator<U>&) {}
+
+            T* allocate(std::size_t n) { return static_cast<T*>(allocatePinned(n * sizeof(T))); }
+            void deallocate(T* ptr, std::size_t) { freePinned(ptr); }
+        };
+
+        template<class T, class U> bool operator==(const PinnedAllocator<T>&, const PinnedAllocator<U>&) { return true; }
+        template<class T, class U> bool operator!=(const PinnedAllocator<T>&, const PinnedAllocator<U>&) { return false; }
+    }
+
+    namespace device
+    {
+        using pcl::gpu::Stream;
+        using pcl::gpu::Event;
+    }
+}
@@ -58,6 +58,9 @@ void pcl::gpu::DeviceMemory::release() { throw_nogpu(); }
 void pcl::gpu::DeviceMemory::copyTo(DeviceMemory&) const { throw_nogpu(); }
 void pcl::gpu::DeviceMemory::upload(const void*, std::size_t) { throw_nogpu(); }
 void pcl::gpu::DeviceMemory::download(void*) const { throw_nogpu(); }
+void pcl::gpu::DeviceMemory::copyToAsync(DeviceMemory&, const Stream&) const { throw_nogpu(); }
+void pcl::gpu::DeviceMemory::uploadAsync(const void*, std::size_t, const Stream&) { throw_nogpu(); }
+void pcl::gpu::DeviceMemory::downloadAsync(void*, const Stream&) const { throw_nogpu(); }
 bool pcl::gpu::DeviceMemory::empty() const { throw_nogpu(); }
 pcl::gpu::DeviceMemory2D::DeviceMemory2D() { throw_nogpu(); }
 pcl::gpu::DeviceMemory2D::DeviceMemory2D(int, int)  { throw_nogpu(); }
@@ -70,6 +73,9 @@ void pcl::gpu::DeviceMemory2D::release()  { throw_nogpu(); }
 void pcl::gpu::DeviceMemory2D::copyTo(DeviceMemory2D&) const  { throw_nogpu(); }
 void pcl::gpu::DeviceMemory2D::upload(const void *, std::size_t, int, int )  { throw_nogpu(); }
 void pcl::gpu::DeviceMemory2D::download(void *, std::size_t ) const  { throw_nogpu(); }
+void pcl::gpu::DeviceMemory2D::copyToAsync(DeviceMemory2D&, const Stream&) const  { throw_nogpu(); }
+void pcl::gpu::DeviceMemory2D::uploadAsync(const void *, std::size_t, int, int, const Stream&)  { throw_nogpu(); }
+void pcl::gpu::DeviceMemory2D::downloadAsync(void *, std::size_t, const Stream&) const  { throw_nogpu(); }
 bool pcl::gpu::DeviceMemory2D::empty() const { throw_nogpu(); }
 
 #else
@@ -150,7 +156,7 @@ void pcl::gpu::DeviceMemory::copyTo(DeviceMemory& other) const
     {    
         other.create(sizeBytes_);    
         cudaSafeCall( cudaMemcpy(other.data_, data_, sizeBytes_, cudaMemcpyDeviceToDevice) );
-        cudaSafeCall( cudaDeviceSynchronize() );
+        cudaSafeCall( cudaStreamSynchronize(0) );
     }
 }
 
@@ -171,15 +177,37 @@ void pcl::gpu::DeviceMemory::upload(const void *host_ptr_arg, std::size_t sizeBy
 {
     create(sizeBytes_arg);
     cudaSafeCall( cudaMemcpy(data_, host_ptr_arg, sizeBytes_, cudaMemcpyHostToDevice) );
-    cudaSafeCall( cudaDeviceSynchronize() );
+    cudaSafeCall( cudaStreamSynchronize(0) );
 }
 
 void pcl::gpu::DeviceMemory::download(void *host_ptr_arg) const
 {    
     cudaSafeCall( cudaMemcpy(host_ptr_arg, data_, sizeBytes_, cudaMemcpyDeviceToHost) );
-    cudaSafeCall( cudaDeviceSynchronize() );
+    cudaSafeCall( cudaStreamSynchronize(0) );
 }          
 
+void pcl::gpu::DeviceMemory::copyToAsync(DeviceMemory& other, const Stream& stream) const
+{
+    if (empty())
+        other.release();
+    else
+    {    
+        other.create(sizeBytes_);    
+        cudaSafeCall( cudaMemcpyAsync(other.data_, data_, sizeBytes_, cudaMemcpyDeviceToDevice, stream.handle()) );
+    }
+}
+
+void pcl::gpu::DeviceMemory::uploadAsync(const void *host_ptr_arg, std::size_t sizeBytes_arg, const Stream& stream)
+{
+    create(sizeBytes_arg);
+    cudaSafeCall( cudaMemcpyAsync(data_, host_ptr_arg, sizeBytes_, cudaMemcpyHostToDevice, stream.handle()) );
+}
+
+void pcl::gpu::DeviceMemory::downloadAsync(void *host_ptr_arg, const Stream& stream) const
+{    
+    cudaSafeCall( cudaMemcpyAsync(host_ptr_arg, data_, sizeBytes_, cudaMemcpyDeviceToHost, stream.handle()) );
+}
+
 void pcl::gpu::DeviceMemory::swap(DeviceMemory& other_arg)
 {
     std::swap(data_, other_arg.data_);
@@ -277,7 +305,7 @@ void pcl::gpu::DeviceMemory2D::copyTo(DeviceMemory2D& other) const
     {
         other.create(rows_, colsBytes_);    
         cudaSafeCall( cudaMemcpy2D(other.data_, other.step_, data_, step_, colsBytes_, rows_, cudaMemcpyDeviceToDevice) );
-        cudaSafeCall( cudaDeviceSynchronize() );
+        cudaSafeCall( cudaStreamSynchronize(0) );
     }
 }
 
@@ -285,15 +313,37 @@ void pcl::gpu::DeviceMemory2D::upload(const void *host_ptr_arg, std::size_t host
 {
     create(rows_arg, colsBytes_arg);
     cudaSafeCall( cudaMemcpy2D(data_, step_, host_ptr_arg, host_step_arg, colsBytes_, rows_, cudaMemcpyHostToDevice) );        
-    cudaSafeCall( cudaDeviceSynchronize() );
+    cudaSafeCall( cudaStreamSynchronize(0) );
 }
 
 void pcl::gpu::DeviceMemory2D::download(void *host_ptr_arg, std::size_t host_step_arg) const
 {    
     cudaSafeCall( cudaMemcpy2D(host_ptr_arg, host_step_arg, data_, step_, colsBytes_, rows_, cudaMemcpyDeviceToHost) );
-    cudaSafeCall( cudaDeviceSynchronize() );
+    cudaSafeCall( cudaStreamSynchronize(0) );
 }      
 
+void pcl::gpu::DeviceMemory2D::copyToAsync(DeviceMemory2D& other, const Stream& stream) const
+{
+    if (empty())
+        other.release();
+    else
+    {
+        other.create(rows_, colsBytes_);    
+        cudaSafeCall( cudaMemcpy2DAsync(other.data_, other.step_, data_, step_, colsBytes_, rows_, cudaMemcpyDeviceToDevice, stream.handle()) );
+    }
+}
+
+void pcl::gpu::DeviceMemory2D::uploadAsync(const void *host_ptr_arg, std::size_t host_step_arg, int rows_arg, int colsBytes_arg, const Stream& stream)
+{
+    create(rows_arg, colsBytes_arg);
+    cudaSafeCall( cudaMemcpy2DAsync(data_, step_, host_ptr_arg, host_step_arg, colsBytes_, rows_, cudaMemcpyHostToDevice, stream.handle()) );
+}
+
+void pcl::gpu::DeviceMemory2D::downloadAsync(void *host_ptr_arg, std::size_t host_step_arg, const Stream& stream) const
+{    
+    cudaSafeCall( cudaMemcpy2DAsync(host_ptr_arg, host_step_arg, data_, step_, colsBytes_, rows_, cudaMemcpyDeviceToHost, stream.handle()) );
+}
+
 void pcl::gpu::DeviceMemory2D::swap(DeviceMemory2D& other_arg)
 {    
     std::swap(data_, other_arg.data_);
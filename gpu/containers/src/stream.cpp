@@ -0,0 +1,85 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved
+ */
+
+#include <pcl/gpu/containers/stream.h>
+#include <pcl/gpu/utils/safe_call.hpp>
+
+#include "cuda_runtime_api.h"
+
+////////////////////////    Stream    /////////////////////////////
+
+pcl::gpu::Stream::Stream() : stream_(nullptr)
+{
+    cudaSafeCall( cudaStreamCreateWithFlags(&stream_, cudaStreamNonBlocking) );
+}
+
+pcl::gpu::Stream::~Stream()
+{
+    cudaStreamSynchronize(stream_);
+    cudaStreamDestroy(stream_);
+}
+
+void pcl::gpu::Stream::waitForCompletion() const { cudaSafeCall( cudaStreamSynchronize(stream_) ); }
+
+bool pcl::gpu::Stream::queryIfComplete() const
+{
+    cudaError_t err = cudaStreamQuery(stream_);
+    if (err == cudaErrorNotReady)
+        return false;
+    cudaSafeCall(err);
+    return true;
+}
+
+CUstream_st* pcl::gpu::Stream::handle() const { return stream_; }
+
+////////////////////////    Event    /////////////////////////////
+
+pcl::gpu::Event::Event(bool timing) : event_(nullptr)
+{
+    cudaSafeCall( cudaEventCreateWithFlags(&event_, timing ? cudaEventDefault : cudaEventDisableTiming) );
+}
+
+pcl::gpu::Event::~Event() { cudaEventDestroy(event_); }
+
+void pcl::gpu::Event::record(const Stream& stream) { cudaSafeCall( cudaEventRecord(event_, stream.handle()) ); }
+void pcl::gpu::Event::waitOn(const Stream& stream) const { cudaSafeCall( cudaStreamWaitEvent(stream.handle(), event_, 0) ); }
+void pcl::gpu::Event::waitForCompletion() const { cudaSafeCall( cudaEventSynchronize(event_) ); }
+
+bool pcl::gpu::Event::queryIfComplete() const
+{
+    cudaError_t err = cudaEventQuery(event_);
+    if (err == cudaErrorNotReady)
+        return false;
+    cudaSafeCall(err);
+    return true;
+}
+
+float pcl::gpu::Event::elapsedTime(const Event& start, const Event& stop)
+{
+    float elapsed_time = 0.f;
+    cudaSafeCall( cudaEventElapsedTime(&elapsed_time, start.event_, stop.event_) );
+    return elapsed_time;
+}
+
+CUevent_st* pcl::gpu::Event::handle() const { return event_; }
+
+////////////////////////    Pinned memory    /////////////////////////////
+
+void* pcl::gpu::allocatePinned(std::size_t sizeBytes)
+{
+    void* ptr = nullptr;
+    cudaSafeCall( cudaMallocHost(&ptr, sizeBytes) );
+    return ptr;
+}
+
+void pcl::gpu::freePinned(void* ptr)
+{
+    if (ptr)
+        cudaSafeCall( cudaFreeHost(ptr) );
+}
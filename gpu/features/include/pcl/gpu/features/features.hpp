@@ -66,7 +66,17 @@ namespace pcl
             void setSearchSurface(const PointCloud& surface);
             void setIndices(const Indices& indices);
             void setRadiusSearch(float radius, int max_results);
+
+            /** \brief Provide the neighborhoods of the input points (or of the indices, if set) in the
+              * search surface, e.g. the result of a single Octree::radiusSearch shared by several
+              * estimators. The neighborhoods stay on the device and compute() then neither builds
+              * nor searches the octree. Pass an empty NeighborIndices to search again.
+              */
+            void setSearchNeighbors(const NeighborIndices& neighbors);
         protected:
+            /** \brief Return the neighborhoods given to setSearchNeighbors, or search them into \a nn_indices. */
+            const NeighborIndices& searchNeighbors(NeighborIndices& nn_indices);
+
             PointCloud cloud_;
             PointCloud surface_;
             Indices indices_;
@@ -74,6 +84,7 @@ namespace pcl
             int max_results_;
 
             Octree octree_;
+            NeighborIndices neighbors_;
         };
 
         ////////////////////////////////////////////////////////////////////////////////////////////  
@@ -52,6 +52,24 @@ void pcl::gpu::Feature::setInputCloud(const PointCloud& cloud) { cloud_ = cloud;
 void pcl::gpu::Feature::setSearchSurface(const PointCloud& surface) { surface_ = surface; }
 void pcl::gpu::Feature::setIndices(const Indices& indices) { indices_ = indices; }
 void pcl::gpu::Feature::setRadiusSearch(float radius, int max_results) { radius_ = radius; max_results_ = max_results; }
+void pcl::gpu::Feature::setSearchNeighbors(const NeighborIndices& neighbors) { neighbors_ = neighbors; }
+
+const pcl::gpu::NeighborIndices& pcl::gpu::Feature::searchNeighbors(NeighborIndices& nn_indices)
+{
+    if (!neighbors_.data.empty())
+        return neighbors_;
+
+    PointCloud& surface = surface_.empty() ? cloud_ : surface_;
+
+    octree_.setCloud(surface);
+    octree_.build();
+
+    if (indices_.empty())
+        octree_.radiusSearch(cloud_, radius_, max_results_, nn_indices);
+    else
+        octree_.radiusSearch(cloud_, indices_, radius_, max_results_, nn_indices);
+    return nn_indices;
+}
 
 /////////////////////////////////////////////////////////////////////////
 /// FeatureFromNormals
@@ -105,21 +123,13 @@ void pcl::gpu::NormalEstimation::compute(Normals& normals)
 
     PointCloud& surface = surface_.empty() ? cloud_ : surface_;
 
-    octree_.setCloud(surface);
-    octree_.build();
+    const NeighborIndices& neighbours = searchNeighbors(nn_indices_);
+    computeNormals(surface, neighbours, normals);
 
     if (indices_.empty() || (!indices_.empty() && indices_.size() == cloud_.size()))
-    {
-        octree_.radiusSearch(cloud_, radius_, max_results_, nn_indices_);        
-        computeNormals(surface, nn_indices_, normals);
         flipNormalTowardsViewpoint(cloud_, vpx_, vpy_, vpz_, normals);
-    }
     else
-    {
-        octree_.radiusSearch(cloud_, indices_, radius_, max_results_, nn_indices_);
-        computeNormals(surface, nn_indices_, normals);
         flipNormalTowardsViewpoint(cloud_, indices_, vpx_, vpy_, vpz_, normals);
-    }    
 }
 
 
@@ -146,21 +156,9 @@ void pcl::gpu::PFHEstimation::compute(DeviceArray2D<PFHSignature125>& features)
 {
     PointCloud& surface = surface_.empty() ? cloud_ : surface_;
 
-    octree_.setCloud(surface);
-    octree_.build();
-
     assert( cloud_.size() == normals_.size());
 
-    if (indices_.empty() || (!indices_.empty() && indices_.size() == cloud_.size()))
-    {        
-        octree_.radiusSearch(cloud_, radius_, max_results_, nn_indices_);       
-        compute(surface, normals_, nn_indices_, features);        
-    }
-    else
-    {        
-        octree_.radiusSearch(cloud_, indices_, radius_, max_results_, nn_indices_);                
-        compute(surface, normals_, nn_indices_, features);
-    }
+    compute(surface, normals_, searchNeighbors(nn_indices_), features);
 
 }
 
@@ -184,21 +182,9 @@ void pcl::gpu::PFHRGBEstimation::compute(DeviceArray2D<PFHRGBSignature250>& feat
 {
     PointCloud& surface = surface_.empty() ? cloud_ : surface_;
 
-    octree_.setCloud(surface);
-    octree_.build();
-
     assert( cloud_.size() == normals_.size());
 
-    if (indices_.empty() || (!indices_.empty() && indices_.size() == cloud_.size()))
-    {        
-        octree_.radiusSearch(cloud_, radius_, max_results_, nn_indices_);       
-        compute(surface, normals_, nn_indices_, features);        
-    }
-    else
-    {        
-        octree_.radiusSearch(cloud_, indices_, radius_, max_results_, nn_indices_);                
-        compute(surface, normals_, nn_indices_, features);
-    }
+    compute(surface, normals_, searchNeighbors(nn_indices_), features);
 }
 
 /////////////////////////////////////////////////////////////////////////
@@ -241,25 +227,23 @@ void pcl::gpu::FPFHEstimation::compute(DeviceArray2D<FPFHSignature33>& features)
     if (!hasInds && !hasSurf)
     {
         features.create (static_cast<int> (cloud_.size ()), 1);
-        octree_.setCloud(cloud_);
-        octree_.build();
         assert( cloud_.size() == normals_.size());    
-        octree_.radiusSearch(cloud_, radius_, max_results_, nn_indices_);
-        compute(cloud_, normals_, nn_indices_, features);
+        compute(cloud_, normals_, searchNeighbors(nn_indices_), features);
         return;
     }
 
     PointCloud& surface = surface_.empty() ? cloud_ : surface_;
 
-    octree_.setCloud(surface);
-    octree_.build();
+    const NeighborIndices& neighbours = searchNeighbors(nn_indices_);
 
-    if (hasInds)
-        octree_.radiusSearch(cloud_, indices_, radius_, max_results_, nn_indices_);
-    else
-        octree_.radiusSearch(cloud_, radius_, max_results_, nn_indices_);
+    // the neighborhoods of the neighbours are searched in any case
+    if (!neighbors_.data.empty())
+    {
+        octree_.setCloud(surface);
+        octree_.build();
+    }
 
-    int total = computeUniqueIndices(surface.size(), nn_indices_, unique_indices_storage, lookup);    
+    int total = computeUniqueIndices(surface.size(), neighbours, unique_indices_storage, lookup);    
 
     DeviceArray<int> unique_indices(unique_indices_storage.ptr(), total);
     octree_.radiusSearch(surface, unique_indices, radius_, max_results_, nn_indices2_);
@@ -271,7 +255,7 @@ void pcl::gpu::FPFHEstimation::compute(DeviceArray2D<FPFHSignature33>& features)
     device::computeSPFH(s, n, unique_indices, nn_indices2_, spfh33);
 
     DeviceArray2D<device::FPFHSignature33>& f = (DeviceArray2D<device::FPFHSignature33>&)features;
-    device::computeFPFH(c, indices_, s, nn_indices_, lookup, spfh33, f);
+    device::computeFPFH(c, indices_, s, neighbours, lookup, spfh33, f);
 }
 
 
@@ -323,17 +307,14 @@ void pcl::gpu::PPFRGBRegionEstimation::compute(DeviceArray<PPFRGBSignature>& fea
 
     features.create(indices_.size());
 
-    octree_.setCloud(cloud_);
-    octree_.build();
-
-    octree_.radiusSearch(cloud_, indices_, radius_, max_results_, nn_indices_);
+    const NeighborIndices& neighbours = searchNeighbors(nn_indices_);
 
     const device::PointCloud& c = (const device::PointCloud&)cloud_;
     const device::Normals&    n = (const device::Normals&)normals_;
 
     DeviceArray<device::PPFRGBSignature>& f = (DeviceArray<device::PPFRGBSignature>&)features;        
 
-    device::computePPFRGBRegion(c, n, indices_, nn_indices_, f);            
+    device::computePPFRGBRegion(c, n, indices_, neighbours, f);            
 }
 
 /////////////////////////////////////////////////////////////////////////
@@ -347,15 +328,7 @@ void pcl::gpu::PrincipalCurvaturesEstimation::compute(DeviceArray<PrincipalCurva
     assert(/*!indices_.empty() && */!cloud_.empty() && max_results_ > 0 && radius_ > 0.f);
     assert(surface_.empty() ? normals_.size() == cloud_.size() : normals_.size() == surface_.size());
 
-    PointCloud& surface = surface_.empty() ? cloud_ : surface_;
-
-    octree_.setCloud(surface);
-    octree_.build();
-
-    if(indices_.empty())
-        octree_.radiusSearch(cloud_, radius_, max_results_, nn_indices_);
-    else
-        octree_.radiusSearch(cloud_, indices_, radius_, max_results_, nn_indices_);
+    const NeighborIndices& neighbours = searchNeighbors(nn_indices_);
 
     const device::Normals& n = (const device::Normals&)normals_;
 
@@ -363,7 +336,7 @@ void pcl::gpu::PrincipalCurvaturesEstimation::compute(DeviceArray<PrincipalCurva
 
     DeviceArray<device::PrincipalCurvatures>& f = (DeviceArray<device::PrincipalCurvatures>&)features;
 
-    device::computePointPrincipalCurvatures(n, indices_, nn_indices_, f, proj_normals_buf);
+    device::computePointPrincipalCurvatures(n, indices_, neighbours, f, proj_normals_buf);
 }
 
 
@@ -530,9 +503,7 @@ void pcl::gpu::SpinImageEstimation::compute(DeviceArray2D<SpinImage>& features,
 		pcl::gpu::error("Rotation axis cloud have different size from input!", __FILE__, __LINE__);
 	
 	///////////////////////////////////////////////
-	octree_.setCloud(surface_);
-    octree_.build();
-    octree_.radiusSearch(cloud_, indices_, radius_, max_results_, nn_indices_);
+	const NeighborIndices& neighbours = searchNeighbors(nn_indices_);
 
 	// OK, we are interested in the points of the cylinder of height 2*r and base radius r, where r = m_dBinSize * in_iImageWidth
 	// it can be embedded to the sphere of radius sqrt(2) * m_dBinSize * in_iImageWidth
@@ -552,20 +523,20 @@ void pcl::gpu::SpinImageEstimation::compute(DeviceArray2D<SpinImage>& features,
 	{
 		float3 axis = make_float3(rotation_axis_.x, rotation_axis_.y, rotation_axis_.z);
 		computeSpinImagesCustomAxes(is_radial_, is_angular_, support_angle_cos_, indices_, c, in,
-			s, n, nn_indices_, min_pts_neighb_, image_width_, bin_size, axis, features);
+			s, n, neighbours, min_pts_neighb_, image_width_, bin_size, axis, features);
 	}
 	else if (use_custom_axes_cloud_)
 	{
 		const device::Normals& axes = (const device::Normals&)rotation_axes_cloud_;
 
 		computeSpinImagesCustomAxesCloud(is_radial_, is_angular_, support_angle_cos_, indices_, c, in,
-			s, n, nn_indices_, min_pts_neighb_, image_width_, bin_size, axes, features);
+			s, n, neighbours, min_pts_neighb_, image_width_, bin_size, axes, features);
 	}
 	else
 	{
 		computeSpinImagesOrigigNormal(is_radial_, is_angular_, support_angle_cos_, indices_, c, in,
-			s, n, nn_indices_, min_pts_neighb_, image_width_, bin_size, features);
+			s, n, neighbours, min_pts_neighb_, image_width_, bin_size, features);
 	}
 	
-	computeMask(nn_indices_, min_pts_neighb_, mask);
+	computeMask(neighbours, min_pts_neighb_, mask);
 }
@@ -40,6 +40,7 @@
 #include <pcl/memory.h>
 #include <pcl/pcl_macros.h>
 #include <pcl/gpu/containers/device_array.h>
+#include <pcl/gpu/containers/stream.h>
 #include <pcl/gpu/kinfu/pixel_rgb.h>
 #include <pcl/gpu/kinfu/tsdf_volume.h>
 #include <pcl/gpu/kinfu/color_volume.h>
@@ -134,6 +135,22 @@ namespace pcl
         void
         initColorIntegration(int max_weight = -1);
 
+        /** \brief Enables the pipelined mode. Processing a frame then returns as soon as its raycast is queued on the GPU
+          * instead of waiting for it, so that the raycast overlaps with the capture of the next frame and its upload with
+          * uploadDepthAsync(). The work is still ordered on the GPU, the getters of the last frame see the finished raycast.
+          * \param[in] pipelined true to enable the pipelined mode
+          */
+        void
+        setPipelined (bool pipelined = true);
+
+        /** \brief Queues the upload of the next depth frame on an internal stream and returns. The uploads alternate
+          * between two device buffers, so that the upload of frame N+1 runs while the GPU still processes frame N.
+          * \param[in] depth next frame in host memory with values in millimeters
+          * \return the device depth map to pass to operator(), valid until the next but one upload
+          */
+        const DepthMap&
+        uploadDepthAsync (const PtrStepSz<const unsigned short>& depth);
+
         /** \brief Returns cols passed to ctor */
         int
         cols ();
@@ -283,6 +300,30 @@ namespace pcl
 
         /** \brief ICP step is completely disabled. Only integration now. */
         bool disable_icp_;
+
+        /** \brief Processing a frame doesn't wait for its raycast. */
+        bool pipelined_;
+
+        /** \brief Stream of the uploads queued with uploadDepthAsync. */
+        Stream upload_stream_;
+        /** \brief Page-locked copy of the last uploaded frame, which the asynchronous upload needs. */
+        std::vector<unsigned short, PinnedAllocator<unsigned short> > depth_staging_;
+        /** \brief Device buffers the uploads alternate between. */
+        DepthMap depths_upload_[2];
+        /** \brief Recorded once the upload to each buffer is done. */
+        Event depth_uploaded_[2];
+        /** \brief Recorded once the processing of the frame in each buffer is done with it. */
+        Event depth_consumed_[2];
+        /** \brief Buffer of the last upload. */
+        int upload_index_;
+
+        /** \brief Returns the index of the upload buffer \a depth is, or -1 if it isn't one. */
+        int
+        uploadIndex (const DepthMap& depth) const;
+
+        /** \brief Records that the GPU work queued so far for the frame \a depth is the last to read it. */
+        void
+        releaseDepth (const DepthMap& depth);
         
         /** \brief Allocates all GPU internal buffers.
           * \param[in] rows_arg
@@ -70,7 +70,7 @@ namespace pcl
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-pcl::gpu::KinfuTracker::KinfuTracker (int rows, int cols) : rows_(rows), cols_(cols), global_time_(0), max_icp_distance_(0), integration_metric_threshold_(0.f), disable_icp_(false)
+pcl::gpu::KinfuTracker::KinfuTracker (int rows, int cols) : rows_(rows), cols_(cols), global_time_(0), max_icp_distance_(0), integration_metric_threshold_(0.f), disable_icp_(false), pipelined_(false), upload_index_(1)
 {
   const Vector3f volume_size = Vector3f::Constant (VOLUME_SIZE);
   const Vector3i volume_resolution(VOLUME_X, VOLUME_Y, VOLUME_Z);
@@ -221,11 +221,60 @@ pcl::gpu::KinfuTracker::allocateBufffers (int rows, int cols)
     coresps_[i].create (pyr_rows, pyr_cols);
   }  
   depthRawScaled_.create (rows, cols);
+  depths_upload_[0].create (rows, cols);
+  depths_upload_[1].create (rows, cols);
+  depth_staging_.resize (rows * cols);
   // see estimate transform for the magic numbers
   gbuf_.create (27, 20*60);
   sumbuf_.create (27);
 }
 
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::gpu::KinfuTracker::setPipelined (bool pipelined)
+{
+  pipelined_ = pipelined;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+const pcl::gpu::KinfuTracker::DepthMap&
+pcl::gpu::KinfuTracker::uploadDepthAsync (const PtrStepSz<const unsigned short>& depth)
+{
+  upload_index_ ^= 1;
+  DepthMap& buffer = depths_upload_[upload_index_];
+
+  // the staging buffer is free once the previous upload is done, which is short compared to a frame
+  upload_stream_.waitForCompletion ();
+  depth_staging_.resize (depth.rows * depth.cols);
+  for (int y = 0; y < depth.rows; ++y)
+    std::copy (depth.ptr (y), depth.ptr (y) + depth.cols, depth_staging_.begin () + y * depth.cols);
+
+  // the integration of the frame uploaded to this buffer before may still be queued
+  depth_consumed_[upload_index_].waitOn (upload_stream_);
+  buffer.uploadAsync (depth_staging_.data (), depth.cols * sizeof (unsigned short), depth.rows, depth.cols, upload_stream_);
+  depth_uploaded_[upload_index_].record (upload_stream_);
+  return (buffer);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+pcl::gpu::KinfuTracker::uploadIndex (const DepthMap& depth) const
+{
+  for (int i = 0; i < 2; ++i)
+    if (depth.ptr () == depths_upload_[i].ptr ())
+      return (i);
+  return (-1);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::gpu::KinfuTracker::releaseDepth (const DepthMap& depth)
+{
+  const int upload = uploadIndex (depth);
+  if (upload >= 0)
+    cudaSafeCall (cudaEventRecord (depth_consumed_[upload].handle (), 0));
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 bool
 pcl::gpu::KinfuTracker::operator() (const DepthMap& depth_raw, 
@@ -233,6 +282,11 @@ pcl::gpu::KinfuTracker::operator() (const DepthMap& depth_raw,
 {  
   device::Intr intr (fx_, fy_, cx_, cy_);
 
+  // the kernels run on the default stream, which has to wait for a frame uploaded with uploadDepthAsync
+  const int upload = uploadIndex (depth_raw);
+  if (upload >= 0)
+    cudaSafeCall (cudaStreamWaitEvent (0, depth_uploaded_[upload].handle (), 0));
+
   if (!disable_icp_)
   {
       {
@@ -274,6 +328,7 @@ pcl::gpu::KinfuTracker::operator() (const DepthMap& depth_raw,
         for (int i = 0; i < LEVELS; ++i)
           device::tranformMaps (vmaps_curr_[i], nmaps_curr_[i], device_Rcam, device_tcam, vmaps_g_prev_[i], nmaps_g_prev_[i]);
 
+        releaseDepth (depth_raw);
         ++global_time_;
         return (false);
       }
@@ -343,6 +398,7 @@ pcl::gpu::KinfuTracker::operator() (const DepthMap& depth_raw,
             {
               if (std::isnan (det)) std::cout << "qnan" << std::endl;
 
+              releaseDepth (depth_raw);
               reset ();
               return (false);
             }
@@ -410,6 +466,7 @@ pcl::gpu::KinfuTracker::operator() (const DepthMap& depth_raw,
     //integrateTsdfVolume(depth_raw, intr, device_volume_size, device_Rcurr_inv, device_tcurr, tranc_dist, volume_);
     integrateTsdfVolume (depth_raw, intr, device_volume_size, device_Rcurr_inv, device_tcurr, tsdf_volume_->getTsdfTruncDist(), tsdf_volume_->data(), depthRawScaled_);
   }
+  releaseDepth (depth_raw);
 
   ///////////////////////////////////////////////////////////////////////////////////////////
   // Ray casting
@@ -422,7 +479,9 @@ pcl::gpu::KinfuTracker::operator() (const DepthMap& depth_raw,
       resizeVMap (vmaps_g_prev_[i-1], vmaps_g_prev_[i]);
       resizeNMap (nmaps_g_prev_[i-1], nmaps_g_prev_[i]);
     }
-    pcl::device::sync ();
+    // in the pipelined mode the raycast overlaps with whatever the caller does until the next frame
+    if (!pipelined_)
+      pcl::device::sync ();
   }
 
   ++global_time_;
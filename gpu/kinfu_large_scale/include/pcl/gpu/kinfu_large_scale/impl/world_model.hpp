@@ -40,21 +40,103 @@
 #define PCL_WORLD_MODEL_IMPL_HPP_
 
 #include <pcl/gpu/kinfu_large_scale/world_model.h>
+#include <pcl/common/point_tests.h> // for pcl::isFinite
+
+#include <algorithm>
+#include <cmath>
+
+template <typename PointT>
+inline std::int64_t
+pcl::kinfuLS::WorldModel<PointT>::getBlockKey (double x, double y, double z) const
+{
+  // 21 bits per axis, centered on the origin
+  const std::int64_t offset = 1 << 20;
+  const std::int64_t mask = (1 << 21) - 1;
+  const std::int64_t bx = static_cast<std::int64_t> (std::floor (x / block_size_)) + offset;
+  const std::int64_t by = static_cast<std::int64_t> (std::floor (y / block_size_)) + offset;
+  const std::int64_t bz = static_cast<std::int64_t> (std::floor (z / block_size_)) + offset;
+  return (((bx & mask) << 42) | ((by & mask) << 21) | (bz & mask));
+}
+
+template <typename PointT> template <typename Function>
+void
+pcl::kinfuLS::WorldModel<PointT>::forEachBlockInBox (double min_x, double min_y, double min_z,
+                                                     double max_x, double max_y, double max_z, Function f)
+{
+  if (blocks_.empty () || min_x > max_x || min_y > max_y || min_z > max_z)
+    return;
+
+  const std::int64_t min_bx = static_cast<std::int64_t> (std::floor (min_x / block_size_));
+  const std::int64_t min_by = static_cast<std::int64_t> (std::floor (min_y / block_size_));
+  const std::int64_t min_bz = static_cast<std::int64_t> (std::floor (min_z / block_size_));
+  const std::int64_t max_bx = static_cast<std::int64_t> (std::floor (max_x / block_size_));
+  const std::int64_t max_by = static_cast<std::int64_t> (std::floor (max_y / block_size_));
+  const std::int64_t max_bz = static_cast<std::int64_t> (std::floor (max_z / block_size_));
+
+  const double nr_blocks_in_box = static_cast<double> (max_bx - min_bx + 1) * (max_by - min_by + 1) * (max_bz - min_bz + 1);
+  if (nr_blocks_in_box <= static_cast<double> (blocks_.size ()))
+  {
+    // look the blocks of the box up
+    for (std::int64_t bx = min_bx; bx <= max_bx; ++bx)
+      for (std::int64_t by = min_by; by <= max_by; ++by)
+        for (std::int64_t bz = min_bz; bz <= max_bz; ++bz)
+        {
+          const auto it = blocks_.find (getBlockKey ((bx + 0.5) * block_size_, (by + 0.5) * block_size_, (bz + 0.5) * block_size_));
+          if (it != blocks_.end ())
+            f (it->second);
+        }
+  }
+  else
+  {
+    // fewer blocks in the world than in the box
+    const std::int64_t offset = 1 << 20;
+    const std::int64_t mask = (1 << 21) - 1;
+    for (auto &block : blocks_)
+    {
+      const std::int64_t bx = ((block.first >> 42) & mask) - offset;
+      const std::int64_t by = ((block.first >> 21) & mask) - offset;
+      const std::int64_t bz = (block.first & mask) - offset;
+      if (bx >= min_bx && bx <= max_bx && by >= min_by && by <= max_by && bz >= min_bz && bz <= max_bz)
+        f (block.second);
+    }
+  }
+}
+
+template <typename PointT>
+void
+pcl::kinfuLS::WorldModel<PointT>::removeBox (double min_x, double min_y, double min_z, double max_x, double max_y, double max_z)
+{
+  forEachBlockInBox (min_x, min_y, min_z, max_x, max_y, max_z, [&] (Block &block)
+  {
+    const std::size_t previous_size = block.size ();
+    block.erase (std::remove_if (block.begin (), block.end (), [&] (const PointT &p)
+    {
+      return (p.x >= min_x && p.x < max_x && p.y >= min_y && p.y < max_y && p.z >= min_z && p.z < max_z);
+    }), block.end ());
+    world_size_ -= previous_size - block.size ();
+  });
+  world_up_to_date_ = false;
+}
 
 template <typename PointT>
 void 
 pcl::kinfuLS::WorldModel<PointT>::addSlice ( PointCloudPtr new_cloud)
 {
-  PCL_DEBUG("Adding new cloud. Current world contains %zu points.\n",
-            static_cast<std::size_t>(world_->size()));
+  PCL_DEBUG("Adding new cloud. Current world contains %zu points.\n", world_size_);
 
   PCL_DEBUG("New slice contains %zu points.\n",
             static_cast<std::size_t>(new_cloud->size()));
 
-  *world_ += *new_cloud;
+  for (const auto &p : *new_cloud)
+  {
+    if (!pcl::isFinite (p))
+      continue;
+    blocks_[getBlockKey (p.x, p.y, p.z)].push_back (p);
+    ++world_size_;
+  }
+  world_up_to_date_ = false;
 
-  PCL_DEBUG("World now contains  %zu points.\n",
-            static_cast<std::size_t>(world_->size()));
+  PCL_DEBUG("World now contains  %zu points.\n", world_size_);
 }
 
 template <typename PointT>
@@ -67,52 +149,24 @@ pcl::kinfuLS::WorldModel<PointT>::getExistingData(const double previous_origin_x
   double newLimitX = newOriginX + volume_x; 
   double newLimitY = newOriginY + volume_y; 
   double newLimitZ = newOriginZ + volume_z;
-	
-  // filter points in the space of the new cube
-  PointCloudPtr newCube (new pcl::PointCloud<PointT>);
-  // condition
-  ConditionAndPtr range_condAND (new pcl::ConditionAnd<PointT> ());
-  range_condAND->addComparison (FieldComparisonConstPtr (new pcl::FieldComparison<PointT> ("x", pcl::ComparisonOps::GE, newOriginX)));
-  range_condAND->addComparison (FieldComparisonConstPtr (new pcl::FieldComparison<PointT> ("x", pcl::ComparisonOps::LT, newLimitX)));
-  range_condAND->addComparison (FieldComparisonConstPtr (new pcl::FieldComparison<PointT> ("y", pcl::ComparisonOps::GE, newOriginY)));
-  range_condAND->addComparison (FieldComparisonConstPtr (new pcl::FieldComparison<PointT> ("y", pcl::ComparisonOps::LT, newLimitY)));
-  range_condAND->addComparison (FieldComparisonConstPtr (new pcl::FieldComparison<PointT> ("z", pcl::ComparisonOps::GE, newOriginZ)));
-  range_condAND->addComparison (FieldComparisonConstPtr (new pcl::FieldComparison<PointT> ("z", pcl::ComparisonOps::LT, newLimitZ))); 
-  
-  // build the filter
-  pcl::ConditionalRemoval<PointT> condremAND (true);
-  condremAND.setCondition (range_condAND);
-  condremAND.setInputCloud (world_);
-  condremAND.setKeepOrganized (false);
-  
-  // apply filter
-  condremAND.filter (*newCube);
-	
-  // filter points that belong to the new slice
-  ConditionOrPtr range_condOR (new pcl::ConditionOr<PointT> ());
-  
-  if(offset_x >= 0)
-	range_condOR->addComparison (FieldComparisonConstPtr (new pcl::FieldComparison<PointT> ("x", pcl::ComparisonOps::GE,  previous_origin_x + volume_x - 1.0 )));
-  else
-	range_condOR->addComparison (FieldComparisonConstPtr (new pcl::FieldComparison<PointT> ("x", pcl::ComparisonOps::LT,  previous_origin_x )));
-	
-  if(offset_y >= 0)
-	range_condOR->addComparison (FieldComparisonConstPtr (new pcl::FieldComparison<PointT> ("y", pcl::ComparisonOps::GE,  previous_origin_y + volume_y - 1.0 )));
-  else
-	range_condOR->addComparison (FieldComparisonConstPtr (new pcl::FieldComparison<PointT> ("y", pcl::ComparisonOps::LT,  previous_origin_y )));
-	
-  if(offset_z >= 0)
-	range_condOR->addComparison (FieldComparisonConstPtr (new pcl::FieldComparison<PointT> ("z", pcl::ComparisonOps::GE,  previous_origin_z + volume_z - 1.0 )));
-  else
-	range_condOR->addComparison (FieldComparisonConstPtr (new pcl::FieldComparison<PointT> ("z", pcl::ComparisonOps::LT,  previous_origin_z )));
-  
-  // build the filter
-  pcl::ConditionalRemoval<PointT> condrem (true);
-  condrem.setCondition (range_condOR);
-  condrem.setInputCloud (newCube);
-  condrem.setKeepOrganized (false);
-  // apply filter
-  condrem.filter (existing_slice);  
+
+  existing_slice.clear ();
+
+  // points of the new cube which belong to the new slice, looked for in the blocks of the new cube only
+  forEachBlockInBox (newOriginX, newOriginY, newOriginZ, newLimitX, newLimitY, newLimitZ, [&] (const Block &block)
+  {
+    for (const auto &p : block)
+    {
+      if (p.x < newOriginX || p.x >= newLimitX || p.y < newOriginY || p.y >= newLimitY || p.z < newOriginZ || p.z >= newLimitZ)
+        continue;
+
+      const bool in_slice_x = (offset_x >= 0) ? (p.x >= previous_origin_x + volume_x - 1.0) : (p.x < previous_origin_x);
+      const bool in_slice_y = (offset_y >= 0) ? (p.y >= previous_origin_y + volume_y - 1.0) : (p.y < previous_origin_y);
+      const bool in_slice_z = (offset_z >= 0) ? (p.z >= previous_origin_z + volume_z - 1.0) : (p.z < previous_origin_z);
+      if (in_slice_x || in_slice_y || in_slice_z)
+        existing_slice.push_back (p);
+    }
+  });
  
   if(!existing_slice.points.empty ())
   {
@@ -129,28 +183,54 @@ pcl::kinfuLS::WorldModel<PointT>::getExistingData(const double previous_origin_x
   }
 }
 
+template <typename PointT>
+void
+pcl::kinfuLS::WorldModel<PointT>::cleanWorldFromNans ()
+{
+  for (auto &block : blocks_)
+  {
+    const std::size_t previous_size = block.second.size ();
+    block.second.erase (std::remove_if (block.second.begin (), block.second.end (), [] (const PointT &p)
+    {
+      return (!pcl::isFinite (p));
+    }), block.second.end ());
+    world_size_ -= previous_size - block.second.size ();
+  }
+  world_up_to_date_ = false;
+}
+
+template <typename PointT>
+typename pcl::kinfuLS::WorldModel<PointT>::PointCloudPtr
+pcl::kinfuLS::WorldModel<PointT>::getWorld ()
+{
+  if (!world_up_to_date_)
+  {
+    world_->points.clear ();
+    world_->points.reserve (world_size_);
+    for (const auto &block : blocks_)
+      world_->points.insert (world_->points.end (), block.second.begin (), block.second.end ());
+    world_->width = world_->size ();
+    world_->height = 1;
+    world_->is_dense = true;
+    world_up_to_date_ = true;
+  }
+  return (world_);
+}
 
 template <typename PointT>
 void
 pcl::kinfuLS::WorldModel<PointT>::getWorldAsCubes (const double size, std::vector<typename WorldModel<PointT>::PointCloudPtr> &cubes, std::vector<Eigen::Vector3f, Eigen::aligned_allocator<Eigen::Vector3f> > &transforms, double overlap)
 {
   
-  if(world_->points.empty ())
+  if(world_size_ == 0)
   {
 	PCL_INFO("The world is empty, returning nothing\n");
 	return;
   }
 
-  PCL_INFO("Getting world as cubes. World contains %zu points.\n",
-           static_cast<std::size_t>(world_->size()));
-
-  // remove nans from world cloud
-  world_->is_dense = false;
-  std::vector<int> indices;
-  pcl::removeNaNFromPointCloud ( *world_, *world_, indices);
+  PCL_INFO("Getting world as cubes. World contains %zu points.\n", world_size_);
 
-  PCL_INFO("World contains %zu points after nan removal.\n",
-           static_cast<std::size_t>(world_->size()));
+  getWorld ();
 
   // check cube size value
   double cubeSide = size;
@@ -252,31 +332,10 @@ pcl::kinfuLS::WorldModel<PointT>::getWorldAsCubes (const double size, std::vecto
   std::cout << "returning " << cubes.size() << " cubes" << std::endl;
 }
 
-template <typename PointT>
-inline void 
-pcl::kinfuLS::WorldModel<PointT>::setIndicesAsNans (PointCloudPtr cloud, IndicesConstPtr indices)
-{
-  std::vector<pcl::PCLPointField> fields;
-  pcl::for_each_type<FieldList> (pcl::detail::FieldAdder<PointT> (fields));
-  float my_nan = std::numeric_limits<float>::quiet_NaN ();
-  
-  for (int rii = 0; rii < static_cast<int> (indices->size ()); ++rii)  // rii = removed indices iterator
-  {
-    std::uint8_t* pt_data = reinterpret_cast<std::uint8_t*> (&(*cloud)[(*indices)[rii]]);
-    for (const auto &field : fields)
-      memcpy (pt_data + field.offset, &my_nan, sizeof (float));
-  }
-}
-
-
 template <typename PointT>
 void 
 pcl::kinfuLS::WorldModel<PointT>::setSliceAsNans (const double origin_x, const double origin_y, const double origin_z, const double offset_x, const double offset_y, const double offset_z, const int size_x, const int size_y, const int size_z)
 { 
-  // PCL_DEBUG ("IN SETSLICE AS NANS\n");
-  
-  PointCloudPtr slice (new pcl::PointCloud<PointT>);
-  
   // prepare filter limits on all dimensions  
   double previous_origin_x = origin_x;
   double previous_limit_x = origin_x + size_x - 1;
@@ -293,7 +352,7 @@ pcl::kinfuLS::WorldModel<PointT>::setSliceAsNans (const double origin_x, const d
   double new_origin_z = origin_z + offset_z;
   double new_limit_z = previous_limit_z + offset_z; 
    
-  // get points of slice on X (we actually set a negative filter and set the ouliers (so, our slice points) to nan)
+  // the slice on each axis spans the previous cube on the two other axes, its points are removed from the world
   double lower_limit_x, upper_limit_x;
   if(offset_x >=0)
   {
@@ -305,33 +364,8 @@ pcl::kinfuLS::WorldModel<PointT>::setSliceAsNans (const double origin_x, const d
 	lower_limit_x = new_limit_x;
 	upper_limit_x = previous_limit_x;    
   }
+  removeBox (lower_limit_x, previous_origin_y, previous_origin_z, upper_limit_x, previous_limit_y, previous_limit_z);
   
-  // PCL_DEBUG ("Limit X: [%f - %f]\n", lower_limit_x, upper_limit_x);
-  
-  ConditionOrPtr range_cond_OR_x (new pcl::ConditionOr<PointT> ());
-  range_cond_OR_x->addComparison (FieldComparisonConstPtr (new pcl::FieldComparison<PointT> ("x", pcl::ComparisonOps::GE,  upper_limit_x ))); // filtered dimension
-  range_cond_OR_x->addComparison (FieldComparisonConstPtr (new pcl::FieldComparison<PointT> ("x", pcl::ComparisonOps::LT,  lower_limit_x ))); // filtered dimension
-	
-  range_cond_OR_x->addComparison (FieldComparisonConstPtr (new pcl::FieldComparison<PointT> ("y", pcl::ComparisonOps::GE,  previous_limit_y)));
-  range_cond_OR_x->addComparison (FieldComparisonConstPtr (new pcl::FieldComparison<PointT> ("y", pcl::ComparisonOps::LT,  previous_origin_y )));
-	
-  range_cond_OR_x->addComparison (FieldComparisonConstPtr (new pcl::FieldComparison<PointT> ("z", pcl::ComparisonOps::GE,  previous_limit_z)));
-  range_cond_OR_x->addComparison (FieldComparisonConstPtr (new pcl::FieldComparison<PointT> ("z", pcl::ComparisonOps::LT,  previous_origin_z )));
-
-  pcl::ConditionalRemoval<PointT> condrem_x (true);
-  condrem_x.setCondition (range_cond_OR_x);
-  condrem_x.setInputCloud (world_);
-  condrem_x.setKeepOrganized (false);
-  // apply filter
-  condrem_x.filter (*slice);  
-  IndicesConstPtr indices_x = condrem_x.getRemovedIndices ();
-  
-  //set outliers (so our slice points) to nan
-  setIndicesAsNans(world_, indices_x);
-  
-  // PCL_DEBUG("%d points set to nan on X\n", indices_x->size ());
-  
-  // get points of slice on Y (we actually set a negative filter and set the ouliers (so, our slice points) to nan)
   double lower_limit_y, upper_limit_y;
   if(offset_y >=0)
   {
@@ -343,32 +377,8 @@ pcl::kinfuLS::WorldModel<PointT>::setSliceAsNans (const double origin_x, const d
 	lower_limit_y = new_limit_y;
 	upper_limit_y = previous_limit_y;    
   }
+  removeBox (previous_origin_x, lower_limit_y, previous_origin_z, previous_limit_x, upper_limit_y, previous_limit_z);
   
-  // PCL_DEBUG ("Limit Y: [%f - %f]\n", lower_limit_y, upper_limit_y);
-  
-  ConditionOrPtr range_cond_OR_y (new pcl::ConditionOr<PointT> ());
-  range_cond_OR_y->addComparison (FieldComparisonConstPtr (new pcl::FieldComparison<PointT> ("x", pcl::ComparisonOps::GE,  previous_limit_x )));
-  range_cond_OR_y->addComparison (FieldComparisonConstPtr (new pcl::FieldComparison<PointT> ("x", pcl::ComparisonOps::LT,  previous_origin_x )));
-	
-  range_cond_OR_y->addComparison (FieldComparisonConstPtr (new pcl::FieldComparison<PointT> ("y", pcl::ComparisonOps::GE,  upper_limit_y))); // filtered dimension
-  range_cond_OR_y->addComparison (FieldComparisonConstPtr (new pcl::FieldComparison<PointT> ("y", pcl::ComparisonOps::LT,  lower_limit_y ))); // filtered dimension
-	
-  range_cond_OR_y->addComparison (FieldComparisonConstPtr (new pcl::FieldComparison<PointT> ("z", pcl::ComparisonOps::GE,  previous_limit_z)));
-  range_cond_OR_y->addComparison (FieldComparisonConstPtr (new pcl::FieldComparison<PointT> ("z", pcl::ComparisonOps::LT,  previous_origin_z )));
-
-  pcl::ConditionalRemoval<PointT> condrem_y (true);
-  condrem_y.setCondition (range_cond_OR_y);
-  condrem_y.setInputCloud (world_);
-  condrem_y.setKeepOrganized (false);
-  // apply filter
-  condrem_y.filter (*slice);  
-  IndicesConstPtr indices_y = condrem_y.getRemovedIndices ();
-  
-  //set outliers (so our slice points) to nan
-  setIndicesAsNans(world_, indices_y);
-  // PCL_DEBUG ("%d points set to nan on Y\n", indices_y->size ());
-  
-  // get points of slice on Z (we actually set a negative filter and set the ouliers (so, our slice points) to nan)
   double lower_limit_z, upper_limit_z;
   if(offset_z >=0)
   {
@@ -380,32 +390,7 @@ pcl::kinfuLS::WorldModel<PointT>::setSliceAsNans (const double origin_x, const d
 	lower_limit_z = new_limit_z;
 	upper_limit_z = previous_limit_z;    
   }
-  
-  // PCL_DEBUG ("Limit Z: [%f - %f]\n", lower_limit_z, upper_limit_z);
-  
-  ConditionOrPtr range_cond_OR_z (new pcl::ConditionOr<PointT> ());
-  range_cond_OR_z->addComparison (FieldComparisonConstPtr (new pcl::FieldComparison<PointT> ("x", pcl::ComparisonOps::GE,  previous_limit_x )));
-  range_cond_OR_z->addComparison (FieldComparisonConstPtr (new pcl::FieldComparison<PointT> ("x", pcl::ComparisonOps::LT,  previous_origin_x )));
-	
-  range_cond_OR_z->addComparison (FieldComparisonConstPtr (new pcl::FieldComparison<PointT> ("y", pcl::ComparisonOps::GE,  previous_limit_y)));
-  range_cond_OR_z->addComparison (FieldComparisonConstPtr (new pcl::FieldComparison<PointT> ("y", pcl::ComparisonOps::LT,  previous_origin_y )));
-	
-  range_cond_OR_z->addComparison (FieldComparisonConstPtr (new pcl::FieldComparison<PointT> ("z", pcl::ComparisonOps::GE,  upper_limit_z))); // filtered dimension
-  range_cond_OR_z->addComparison (FieldComparisonConstPtr (new pcl::FieldComparison<PointT> ("z", pcl::ComparisonOps::LT,  lower_limit_z ))); // filtered dimension
-
-  pcl::ConditionalRemoval<PointT> condrem_z (true);
-  condrem_z.setCondition (range_cond_OR_z);
-  condrem_z.setInputCloud (world_);
-  condrem_z.setKeepOrganized (false);
-  // apply filter
-  condrem_z.filter (*slice);  
-  IndicesConstPtr indices_z = condrem_z.getRemovedIndices ();
-  
-  //set outliers (so our slice points) to nan
-  setIndicesAsNans(world_, indices_z);
-  // PCL_DEBUG("%d points set to nan on Z\n", indices_z->size ());
-  
-  
+  removeBox (previous_origin_x, previous_origin_y, lower_limit_z, previous_limit_x, previous_limit_y, upper_limit_z);
 }
 
 #define PCL_INSTANTIATE_WorldModel(T) template class PCL_EXPORTS pcl::kinfuLS::WorldModel<T>;
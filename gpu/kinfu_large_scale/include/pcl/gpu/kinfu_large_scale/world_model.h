@@ -45,6 +45,10 @@
 #include <pcl/filters/conditional_removal.h>
 #include <pcl/point_types.h>
 #include <pcl/io/pcd_io.h>
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
 //#include <pcl/gpu/kinfu_large_scale/tsdf_buffer.h>
 //#include <boost/graph/buffer_concepts.hpp>
 
@@ -54,9 +58,11 @@ namespace pcl
   namespace kinfuLS
   {
     /** \brief WorldModel maintains a 3D point cloud that can be queried and updated via helper functions.\n
-      * The world is represented as a point cloud.\n
+      * The world is represented as a point cloud, stored sparsely in blocks of space indexed by a hash map,
+      * so that the updates done at each shift of the cube only visit the blocks it overlaps instead of the
+      * whole world.\n
       * When new points are added to the world, we replace old ones by the newest ones.
-      * This is achieved by setting old points to nan (for speed)
+      * This is achieved by removing the old points from their blocks.
       * \author Raphael Favier
       */
     template <typename PointT>
@@ -80,7 +86,10 @@ namespace pcl
         /** \brief Default constructor for the WorldModel.
           */
         WorldModel() : 
-          world_ (new PointCloud)
+          world_ (new PointCloud),
+          world_up_to_date_ (true),
+          world_size_ (0),
+          block_size_ (32.0)
         {
           world_->is_dense = false;
         }
@@ -89,11 +98,32 @@ namespace pcl
           */
         void reset()
         {
-          if(!world_->points.empty ())
+          if(world_size_ != 0)
           {
             PCL_WARN("Clearing world model\n");
-            world_->points.clear ();
           }
+          blocks_.clear ();
+          world_->points.clear ();
+          world_->width = 0;
+          world_->height = 1;
+          world_up_to_date_ = true;
+          world_size_ = 0;
+        }
+
+        /** \brief Set the side of the blocks the world is indexed with, in the units of the points (grid cells
+          * for kinfuLS). Clears the world.
+          * \param[in] block_size the side of a block
+          */
+        void setBlockSize (double block_size)
+        {
+          reset ();
+          block_size_ = block_size;
+        }
+
+        /** \brief Returns the side of the blocks the world is indexed with. */
+        double getBlockSize () const
+        {
+          return (block_size_);
         }
 
         /** \brief Append a new point cloud (slice) to the world.
@@ -135,25 +165,17 @@ namespace pcl
 
         /** \brief Remove points with nan values from the world.
           */
-        void cleanWorldFromNans () 
-        { 
-          world_->is_dense = false;
-          std::vector<int> indices; 
-          pcl::removeNaNFromPointCloud (*world_, *world_, indices);
-        }
+        void cleanWorldFromNans ();
 
         /** \brief Returns the world as a point cloud.
           */
-        PointCloudPtr getWorld () 
-        { 
-          return (world_); 
-        }
+        PointCloudPtr getWorld ();
         
         /** \brief Returns the number of points contained in the world.
           */      
         std::size_t getWorldSize () 
         { 
-          return (world_->size () );
+          return (world_size_);
         }
 
         /** \brief Returns the world as two vectors of cubes of size "size" (pointclouds) and transforms
@@ -167,15 +189,36 @@ namespace pcl
         
       private:
 
-        /** \brief cloud containing our world */
-        PointCloudPtr world_;
+        using Block = std::vector<PointT, Eigen::aligned_allocator<PointT> >;
+
+        /** \brief Returns the key of the block containing the point at (x, y, z). */
+        inline std::int64_t
+        getBlockKey (double x, double y, double z) const;
 
-        /** \brief set the points which index is in the indices vector to nan 
-          * \param[in] cloud the cloud that contains the point to be set to nan
-          * \param[in] indices the vector of indices to set to nan
+        /** \brief Call \a f on every block intersecting the box [min_x, max_x] x [min_y, max_y] x [min_z, max_z].
           */
-        inline void setIndicesAsNans (PointCloudPtr cloud, IndicesConstPtr indices);
-        
+        template <typename Function> void
+        forEachBlockInBox (double min_x, double min_y, double min_z,
+                           double max_x, double max_y, double max_z, Function f);
+
+        /** \brief Remove the points inside the box [min_x, max_x) x [min_y, max_y) x [min_z, max_z) from the world. */
+        void
+        removeBox (double min_x, double min_y, double min_z, double max_x, double max_y, double max_z);
+
+        /** \brief cloud containing our world, gathered from the blocks when needed */
+        PointCloudPtr world_;
+
+        /** \brief false if the blocks changed since world_ was gathered */
+        bool world_up_to_date_;
+
+        /** \brief the blocks of the world, by key */
+        std::unordered_map<std::int64_t, Block> blocks_;
+
+        /** \brief number of points in the blocks */
+        std::size_t world_size_;
+
+        /** \brief side of the blocks */
+        double block_size_;
     };
   }
 }
@@ -143,9 +143,7 @@ pcl::gpu::kinfuLS::CyclicalBuffer::performShift (const TsdfVolume::Ptr volume, c
                                buffer_.voxels_size.x, buffer_.voxels_size.y, buffer_.voxels_size.z);
 
 
-  PCL_INFO ("world contains %d points after update\n", world_model_.getWorldSize ());
-  world_model_.cleanWorldFromNans ();
-  PCL_INFO ("world contains %d points after cleaning\n", world_model_.getWorldSize ());
+  PCL_INFO ("world contains %zu points after update\n", world_model_.getWorldSize ());
 
   // clear buffer slice and update the world model
   pcl::device::kinfuLS::clearTSDFSlice (volume->data (), &buffer_, offset_x, offset_y, offset_z);
@@ -149,8 +149,13 @@ namespace pcl
           std::vector<float>            means_storage_;
           DeviceArray2D<int>            comps_;
           DeviceArray2D<unsigned char>  edges_;
+          DeviceArray<int>              comp_sizes_;
 
           void allocate_buffers(int rows = 480, int cols = 640);
+
+          /** \brief Labels the connected components of labels_smoothed_, drops the ones of invalid size on the GPU,
+            * downloads the labels and components and groups the pixels in blob_matrix_ */
+          void computeBlobs(const pcl::device::Depth& depth, const PointCloud<PointXYZ>& cloud, int min_pts_per_cluster);
       };
     }
   }
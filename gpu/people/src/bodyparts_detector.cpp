@@ -175,87 +175,14 @@ pcl::gpu::people::RDFBodyPartsDetector::process (const pcl::device::Depth& depth
   allocate_buffers(rows, cols);
 
   {
-    {
-      //ScopeTime time("--");
-      // Process the depthimage (CUDA)
-      impl_->process(depth, labels_);
-      device::smoothLabelImage(labels_, depth, labels_smoothed_, NUM_PARTS, 5, 300);
-    }
-
-    //AsyncCopy<unsigned char> async_labels_download(lmap_host_);
-
-    int c;
-    labels_smoothed_.download(lmap_host_, c);
-    //async_labels_download.download(labels_smoothed_);
-
-    // cc = generalized floodfill = approximation of euclidian clusterisation
-    device::ConnectedComponents::computeEdges(labels_smoothed_, depth, NUM_PARTS, cluster_tolerance_ * cluster_tolerance_, edges_);
-    device::ConnectedComponents::labelComponents(edges_, comps_);
-
-    comps_.download(dst_labels_, c);
-
-    //async_labels_download.waitForCompeltion();
+    //ScopeTime time("--");
+    // Process the depthimage (CUDA)
+    impl_->process(depth, labels_);
+    device::smoothLabelImage(labels_, depth, labels_smoothed_, NUM_PARTS, 5, 300);
   }
 
-  // This was sort indices to blob (sortIndicesToBlob2) method (till line 236)
-  {
-    //ScopeTime time("cvt");
-    std::fill(remap_.begin(), remap_.end(), -1);
-    std::fill(region_sizes_.begin(), region_sizes_.end(), 0);
-
-    std::fill(means_storage_.begin(), means_storage_.end(), 0);
-    float3* means = (float3*) &means_storage_[3];
-    int *rsizes = &region_sizes_[1];
-
-    for(auto &matrix : blob_matrix_)
-      matrix.clear();
-
-    for(std::size_t k = 0; k < dst_labels_.size(); ++k)
-    {
-      const PointXYZ& p = cloud[k];
-      int cc = dst_labels_[k];
-      means[cc].x += p.x;
-      means[cc].y += p.y;
-      means[cc].z += p.z;
-      ++rsizes[cc];
-    }
-
-    means[-1].z = 0; // cc == -1 means invalid
-
-    for(std::size_t k = 0; k < dst_labels_.size(); ++k)
-    {
-      int label = lmap_host_[k];
-      int cc    = dst_labels_[k];
-
-      if (means[cc].z != 0 && min_pts_per_cluster <= rsizes[cc] && rsizes[cc] <= max_cluster_size_)
-      {
-        int ccindex = remap_[cc];
-        if (ccindex == -1)
-        {
-          ccindex = static_cast<int> (blob_matrix_[label].size ());
-          blob_matrix_[label].resize(ccindex + 1);
-          remap_[cc] = ccindex;
-
-          blob_matrix_[label][ccindex].label = static_cast<part_t> (label);
-          blob_matrix_[label][ccindex].mean.coeffRef(0) = means[cc].x / static_cast<float> (rsizes[cc]);
-          blob_matrix_[label][ccindex].mean.coeffRef(1) = means[cc].y / static_cast<float> (rsizes[cc]);
-          blob_matrix_[label][ccindex].mean.coeffRef(2) = means[cc].z / static_cast<float> (rsizes[cc]);
-          blob_matrix_[label][ccindex].indices.indices.reserve(rsizes[cc]);
-        }
-        blob_matrix_[label][ccindex].indices.indices.push_back(static_cast<int> (k));
-      }
-    }
-
-    int id = 0;
-    for(auto &matrix : blob_matrix_)
-      for(std::size_t b = 0; b < matrix.size(); ++b)
-      {
-        matrix[b].id = id++;
-        matrix[b].lid = static_cast<int> (b);
-      }
-
-    buildRelations ( blob_matrix_ );
-  }
+  computeBlobs(depth, cloud, min_pts_per_cluster);
+  buildRelations ( blob_matrix_ );
 }
 
 void
@@ -277,77 +204,83 @@ pcl::gpu::people::RDFBodyPartsDetector::processSmooth (const pcl::device::Depth&
 {
   device::smoothLabelImage(labels_, depth, labels_smoothed_, NUM_PARTS, 5, 300);
 
-  //AsyncCopy<unsigned char> async_labels_download(lmap_host_);
-
-  int c;
-  labels_smoothed_.download(lmap_host_, c);
-  //async_labels_download.download(labels_smoothed_);
+  ScopeTime time("[pcl::gpu::people::RDFBodyPartsDetector::processSmooth] : cvt");
+  computeBlobs(depth, cloud, min_pts_per_cluster);
+}
 
+void
+pcl::gpu::people::RDFBodyPartsDetector::computeBlobs (const pcl::device::Depth& depth, const PointCloud<PointXYZ>& cloud, int min_pts_per_cluster)
+{
   // cc = generalized floodfill = approximation of euclidian clusterisation
   device::ConnectedComponents::computeEdges(labels_smoothed_, depth, NUM_PARTS, cluster_tolerance_ * cluster_tolerance_, edges_);
   device::ConnectedComponents::labelComponents(edges_, comps_);
+  // components too small or too large are dropped on the GPU, the host only visits the pixels of the others
+  device::ConnectedComponents::filterComponents(comps_, min_pts_per_cluster, max_cluster_size_, comp_sizes_);
 
+  int c;
+  labels_smoothed_.download(lmap_host_, c);
   comps_.download(dst_labels_, c);
 
-  //async_labels_download.waitForCompeltion();
+  // This was sort indices to blob (sortIndicesToBlob2) method
+  float3* means = (float3*) &means_storage_[3];
+  int *rsizes = &region_sizes_[1];
 
-  // This was sort indices to blob (sortIndicesToBlob2) method (till line 236)
-  {
-    ScopeTime time("[pcl::gpu::people::RDFBodyPartsDetector::processSmooth] : cvt");
-    std::fill(remap_.begin(), remap_.end(), -1);
-    std::fill(region_sizes_.begin(), region_sizes_.end(), 0);
-
-    std::fill(means_storage_.begin(), means_storage_.end(), 0);
-    float3* means = (float3*) &means_storage_[3];
-    int *rsizes = &region_sizes_[1];
+  for(auto &matrix : blob_matrix_)
+    matrix.clear();
 
-    for(auto &matrix : blob_matrix_)
-      matrix.clear();
+  // only the entries of the components present are reset, instead of whole image sized buffers
+  for(const int cc : dst_labels_)
+  {
+    if (cc < 0)
+      continue;
+    remap_[cc] = -1;
+    rsizes[cc] = 0;
+    means[cc].x = means[cc].y = means[cc].z = 0.f;
+  }
 
-    for(std::size_t k = 0; k < dst_labels_.size(); ++k)
-    {
-      const PointXYZ& p = cloud[k];
-      int cc = dst_labels_[k];
-      means[cc].x += p.x;
-      means[cc].y += p.y;
-      means[cc].z += p.z;
-      ++rsizes[cc];
-    }
+  for(std::size_t k = 0; k < dst_labels_.size(); ++k)
+  {
+    int cc = dst_labels_[k];
+    if (cc < 0)
+      continue;
+    const PointXYZ& p = cloud[k];
+    means[cc].x += p.x;
+    means[cc].y += p.y;
+    means[cc].z += p.z;
+    ++rsizes[cc];
+  }
 
-    means[-1].z = 0; // cc == -1 means invalid
+  for(std::size_t k = 0; k < dst_labels_.size(); ++k)
+  {
+    int label = lmap_host_[k];
+    int cc    = dst_labels_[k];
 
-    for(std::size_t k = 0; k < dst_labels_.size(); ++k)
+    if (cc >= 0 && means[cc].z != 0)
     {
-      int label = lmap_host_[k];
-      int cc    = dst_labels_[k];
-
-      if (means[cc].z != 0 && min_pts_per_cluster <= rsizes[cc] && rsizes[cc] <= max_cluster_size_)
+      int ccindex = remap_[cc];
+      if (ccindex == -1)
       {
-        int ccindex = remap_[cc];
-        if (ccindex == -1)
-        {
-          ccindex = static_cast<int> (blob_matrix_[label].size ());
-          blob_matrix_[label].resize(ccindex + 1);
-          remap_[cc] = ccindex;
-
-          blob_matrix_[label][ccindex].label = static_cast<part_t> (label);
-          blob_matrix_[label][ccindex].mean.coeffRef(0) = means[cc].x / static_cast<float> (rsizes[cc]);
-          blob_matrix_[label][ccindex].mean.coeffRef(1) = means[cc].y / static_cast<float> (rsizes[cc]);
-          blob_matrix_[label][ccindex].mean.coeffRef(2) = means[cc].z / static_cast<float> (rsizes[cc]);
-          blob_matrix_[label][ccindex].indices.indices.reserve(rsizes[cc]);
-        }
-        blob_matrix_[label][ccindex].indices.indices.push_back(static_cast<int> (k));
+        ccindex = static_cast<int> (blob_matrix_[label].size ());
+        blob_matrix_[label].resize(ccindex + 1);
+        remap_[cc] = ccindex;
+
+        blob_matrix_[label][ccindex].label = static_cast<part_t> (label);
+        blob_matrix_[label][ccindex].mean.coeffRef(0) = means[cc].x / static_cast<float> (rsizes[cc]);
+        blob_matrix_[label][ccindex].mean.coeffRef(1) = means[cc].y / static_cast<float> (rsizes[cc]);
+        blob_matrix_[label][ccindex].mean.coeffRef(2) = means[cc].z / static_cast<float> (rsizes[cc]);
+        blob_matrix_[label][ccindex].indices.indices.reserve(rsizes[cc]);
       }
+      blob_matrix_[label][ccindex].indices.indices.push_back(static_cast<int> (k));
     }
-
-    int id = 0;
-    for(auto &matrix : blob_matrix_)
-      for(std::size_t b = 0; b < matrix.size(); ++b)
-      {
-        matrix[b].id = id++;
-        matrix[b].lid = static_cast<int> (b);
-      }
   }
+
+  int id = 0;
+  for(auto &matrix : blob_matrix_)
+    for(std::size_t b = 0; b < matrix.size(); ++b)
+    {
+      matrix[b].id = id++;
+      matrix[b].lid = static_cast<int> (b);
+    }
 }
 
 int
@@ -548,3 +548,54 @@ void pcl::device::ConnectedComponents::labelComponents(const DeviceArray2D<unsig
   cudaSafeCall( cudaGetLastError() );
   cudaSafeCall( cudaDeviceSynchronize() );
 }
+
+///////////////////////////////////////////////////////////////////////////////////////
+////////////////////// Components size filtering //////////////////////////////////////
+
+namespace pcl
+{
+  namespace device
+  {
+    __global__ void countComponentSizesKernel(const PtrStepSz<int> comps, int* sizes)
+    {
+      int x = threadIdx.x + blockIdx.x * blockDim.x;
+      int y = threadIdx.y + blockIdx.y * blockDim.y;
+
+      if( x < comps.cols && y < comps.rows)
+      {
+        int comp = comps.ptr(y)[x];
+        if (comp >= 0)
+          atomicAdd(sizes + comp, 1);
+      }
+    }
+
+    __global__ void filterComponentsKernel(PtrStepSz<int> comps, const int* sizes, int min_size, int max_size)
+    {
+      int x = threadIdx.x + blockIdx.x * blockDim.x;
+      int y = threadIdx.y + blockIdx.y * blockDim.y;
+
+      if( x < comps.cols && y < comps.rows)
+      {
+        int comp = comps.ptr(y)[x];
+        if (comp >= 0 && (sizes[comp] < min_size || sizes[comp] > max_size))
+          comps.ptr(y)[x] = -1;
+      }
+    }
+  }
+}
+
+void pcl::device::ConnectedComponents::filterComponents(DeviceArray2D<int>& comps, int min_size, int max_size, DeviceArray<int>& sizes)
+{
+  sizes.create(comps.rows() * comps.cols());
+  cudaSafeCall( cudaMemset(sizes.ptr(), 0, sizes.sizeBytes()) );
+
+  dim3 block(CTA_SIZE_X, CTA_SIZE_Y);
+  dim3 grid(divUp(comps.cols(), block.x), divUp(comps.rows(), block.y));
+
+  countComponentSizesKernel<<<grid, block>>>(comps, sizes.ptr());
+  cudaSafeCall( cudaGetLastError() );
+
+  filterComponentsKernel<<<grid, block>>>(comps, sizes.ptr(), min_size, max_size);
+  cudaSafeCall( cudaGetLastError() );
+  cudaSafeCall( cudaDeviceSynchronize() );
+}
@@ -85,6 +85,8 @@ namespace pcl
         //static void computeEdges(const Labels& labels, const Cloud& cloud, int num_parts, float sq_radius, DeviceArray2D<unsigned char>& edges);
         static void computeEdges(const Labels& labels, const Depth& depth, int num_parts, float sq_radius, DeviceArray2D<unsigned char>& edges);
         static void labelComponents(const DeviceArray2D<unsigned char>& edges, DeviceArray2D<int>& comps);
+        /** \brief Sets to -1 the pixels of the components smaller than min_size or larger than max_size, sizes is a scratch buffer */
+        static void filterComponents(DeviceArray2D<int>& comps, int min_size, int max_size, DeviceArray<int>& sizes);
     };
 
     void computeCloud(const Depth& depth, const Intr& intr, Cloud& cloud);
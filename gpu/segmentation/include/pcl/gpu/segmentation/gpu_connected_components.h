@@ -0,0 +1,40 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved
+ */
+
+#pragma once
+
+#include <pcl/pcl_exports.h>
+#include <pcl/gpu/containers/device_array.h>
+#include <pcl/gpu/octree/device_format.hpp>
+
+namespace pcl
+{
+  namespace gpu
+  {
+    namespace detail
+    {
+      /** \brief Make every point of \a parent a root of its own component, i.e. parent[i] = i. */
+      PCL_EXPORTS void
+      initComponents (DeviceArray<int> &parent);
+
+      /** \brief Merge, in the union-find forest \a parent, the component of each query with the components of its
+        * neighbors. The roots are always the smallest point index of their component.
+        * \param[in] neighbors the result of a radius search for a batch of queries
+        * \param[in] query_offset the point index of the first query of the batch
+        * \param[in,out] parent the union-find forest, one entry per point
+        */
+      PCL_EXPORTS void
+      mergeComponents (const NeighborIndices &neighbors, int query_offset, DeviceArray<int> &parent);
+
+      /** \brief Point every entry of \a parent directly to the root of its component, which makes it a label. */
+      PCL_EXPORTS void
+      flattenComponents (DeviceArray<int> &parent);
+    }
+  }
+}
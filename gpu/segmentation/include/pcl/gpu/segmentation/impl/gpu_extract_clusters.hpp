@@ -40,6 +40,10 @@
 #define PCL_GPU_SEGMENTATION_IMPL_EXTRACT_CLUSTERS_H_
 
 #include <pcl/gpu/segmentation/gpu_extract_clusters.h>
+#include <pcl/gpu/segmentation/gpu_connected_components.h>
+
+#include <algorithm>
+#include <vector>
 
 void
 pcl::gpu::extractEuclideanClusters (const pcl::PointCloud<pcl::PointXYZ>::Ptr  &host_cloud_,
@@ -49,129 +53,63 @@ pcl::gpu::extractEuclideanClusters (const pcl::PointCloud<pcl::PointXYZ>::Ptr  &
                                     unsigned int                               min_pts_per_cluster,
                                     unsigned int                               max_pts_per_cluster)
 {
-
-  // Create a bool vector of processed point indices, and initialize it to false
-  // cloud is a DeviceArray<PointType>
-  std::vector<bool> processed (host_cloud_->size (), false);
+  const int cloud_size = static_cast<int> (host_cloud_->size ());
+  if (cloud_size == 0)
+    return;
 
   int max_answers;
 
   if(max_pts_per_cluster > host_cloud_->size())
-    max_answers = host_cloud_->size();
+    max_answers = cloud_size;
   else
     max_answers = max_pts_per_cluster;
-  std::cout << "Max_answers: " << max_answers << std::endl;
-
-  // to store the current cluster
-  pcl::PointIndices r;
 
-  DeviceArray<PointXYZ> queries_device_buffer;
-  queries_device_buffer.create(max_answers);
+  // The clusters are the connected components of the graph linking the points closer than the tolerance.
+  // They are found on the device with a union-find forest, merged along the neighborhoods of one batch
+  // of queries after the other, and only the final labels are downloaded.
+  const pcl::gpu::Octree::PointCloud &cloud_device = *tree->cloud_;
 
-  // Process all points in the cloud
-  for (std::size_t i = 0; i < host_cloud_->size (); ++i)
-  {
-    // if we already processed this point continue with the next one
-    if (processed[i])
-      continue;
-    // now we will process this point
-    processed[i] = true;
+  DeviceArray<int> labels_device (cloud_size);
+  detail::initComponents (labels_device);
 
-    // Create the query queue on the device, point based not indices
-    pcl::gpu::Octree::Queries queries_device;
-    // Create the query queue on the host
-	pcl::PointCloud<pcl::PointXYZ>::VectorType queries_host;
-    // Push the starting point in the vector
-    queries_host.push_back ((*host_cloud_)[i]);
-    // Clear vector
-    r.indices.clear();
-    // Push the starting point in
-    r.indices.push_back(i);
+  // bound the size of the neighborhoods of a batch to 64MB
+  const int max_batch_elements = 1 << 24;
+  const int batch_size = std::max (1, std::min (cloud_size, max_batch_elements / max_answers));
 
-    unsigned int found_points = queries_host.size ();
-    unsigned int previous_found_points = 0;
+  pcl::gpu::NeighborIndices result_device;
+  for (int begin = 0; begin < cloud_size; begin += batch_size)
+  {
+    const int count = std::min (batch_size, cloud_size - begin);
+    const pcl::gpu::Octree::Queries queries_device (const_cast<PointXYZ*> (cloud_device.ptr ()) + begin, count);
+    tree->radiusSearch (queries_device, tolerance, max_answers, result_device);
+    detail::mergeComponents (result_device, begin, labels_device);
+  }
+  detail::flattenComponents (labels_device);
 
-    pcl::gpu::NeighborIndices result_device;
+  std::vector<int> labels;
+  labels_device.download (labels);
 
-    // once the area stop growing, stop also iterating.
-    do
+  // The label of a point is the smallest index of its cluster, so the clusters come out in the same order
+  // as the seeds of a breadth-first search over the points, with sorted indices.
+  std::vector<int> cluster_of_label (cloud_size, -1);
+  std::vector<PointIndices> candidates;
+  for (int i = 0; i < cloud_size; ++i)
+  {
+    int &cluster = cluster_of_label[labels[i]];
+    if (cluster < 0)
     {
-      // Host buffer for results
-      std::vector<int> sizes, data;
-
-      // if the number of queries is not high enough implement search on Host here
-      if(queries_host.size () <= 10) ///@todo: adjust this to a variable number settable with method
-      {
-        std::cout << " CPU: ";
-        for(std::size_t p = 0; p < queries_host.size (); p++)
-        {
-          // Execute the radiusSearch on the host
-          tree->radiusSearchHost(queries_host[p], tolerance, data, max_answers);
-        }
-        // Store the previously found number of points
-        previous_found_points = found_points;
-        // Clear queries list
-        queries_host.clear();
-
-        //std::unique(data.begin(), data.end());
-        if(data.size () == 1)
-          continue;
-
-        // Process the results
-        for(std::size_t i = 0; i < data.size (); i++)
-        {
-          if(processed[data[i]])
-            continue;
-          processed[data[i]] = true;
-          queries_host.push_back ((*host_cloud_)[data[i]]);
-          found_points++;
-          r.indices.push_back(data[i]);
-        }
-      }
-
-      // If number of queries is high enough do it here
-      else
-      {
-        std::cout << " GPU: ";
-        // Copy buffer
-        queries_device = DeviceArray<PointXYZ>(queries_device_buffer.ptr(),queries_host.size());
-        // Move queries to GPU
-        queries_device.upload(queries_host);
-        // Execute search
-        tree->radiusSearch(queries_device, tolerance, max_answers, result_device);
-        // Copy results from GPU to Host
-        result_device.sizes.download (sizes);
-        result_device.data.download (data);
-        // Store the previously found number of points
-        previous_found_points = found_points;
-        // Clear queries list
-        queries_host.clear();
-        for(std::size_t qp = 0; qp < sizes.size (); qp++)
-        {
-          for(int qp_r = 0; qp_r < sizes[qp]; qp_r++)
-          {
-            if(processed[data[qp_r + qp * max_answers]])
-              continue;
-            processed[data[qp_r + qp * max_answers]] = true;
-            queries_host.push_back ((*host_cloud_)[data[qp_r + qp * max_answers]]);
-            found_points++;
-            r.indices.push_back(data[qp_r + qp * max_answers]);
-          }
-        }
-      }
-      std::cout << " data.size: " << data.size() << " foundpoints: " << found_points << " previous: " << previous_found_points;
-      std::cout << " new points: " << found_points - previous_found_points << " next queries size: " << queries_host.size() << std::endl;
+      cluster = static_cast<int> (candidates.size ());
+      candidates.emplace_back ();
     }
-    while (previous_found_points < found_points);
-    // If this queue is satisfactory, add to the clusters
-    if (found_points >= min_pts_per_cluster && found_points <= max_pts_per_cluster)
-    {
-      std::sort (r.indices.begin (), r.indices.end ());
-      // @todo: check if the following is actually still needed
-      //r.indices.erase (std::unique (r.indices.begin (), r.indices.end ()), r.indices.end ());
+    candidates[cluster].indices.push_back (i);
+  }
 
+  for (auto &r : candidates)
+  {
+    if (r.indices.size () >= min_pts_per_cluster && r.indices.size () <= max_pts_per_cluster)
+    {
       r.header = host_cloud_->header;
-      clusters.push_back (r);   // We could avoid a copy by working directly in the vector
+      clusters.push_back (std::move (r));
     }
   }
 }
@@ -201,7 +139,6 @@ pcl::gpu::EuclideanClusterExtraction::extract (std::vector<pcl::PointIndices> &c
 */
   // Extract the actual clusters
   extractEuclideanClusters (host_cloud_, tree_, cluster_tolerance_, clusters, min_pts_per_cluster_, max_pts_per_cluster_);
-  std::cout << "INFO: end of extractEuclideanClusters " << std::endl;
   // Sort the clusters based on their size (largest one first)
   //std::sort (clusters.rbegin (), clusters.rend (), comparePointClusters);
 }
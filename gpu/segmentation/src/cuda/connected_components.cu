@@ -0,0 +1,111 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved
+ */
+
+#include <pcl/gpu/segmentation/gpu_connected_components.h>
+#include <pcl/gpu/utils/safe_call.hpp>
+
+namespace pcl
+{
+  namespace device
+  {
+    // Root of the component of x, halving the path on the way. Concurrent updates only ever move an entry
+    // closer to its root, so the races are benign.
+    __device__ __forceinline__ int
+    findRoot (int *parent, int x)
+    {
+      int p = parent[x];
+      while (p != x)
+      {
+        const int gp = parent[p];
+        if (gp != p)
+          parent[x] = gp;
+        x = p;
+        p = gp;
+      }
+      return x;
+    }
+
+    // Hook the larger root under the smaller one, retrying if another thread hooked it first
+    __device__ __forceinline__ void
+    unite (int *parent, int a, int b)
+    {
+      a = findRoot (parent, a);
+      b = findRoot (parent, b);
+      while (a != b)
+      {
+        if (a < b)
+        {
+          const int t = a; a = b; b = t;
+        }
+        const int old = atomicCAS (parent + a, a, b);
+        if (old == a)
+          return;
+        a = findRoot (parent, old);
+        b = findRoot (parent, b);
+      }
+    }
+
+    __global__ void
+    initComponentsKernel (PtrSz<int> parent)
+    {
+      const int i = blockIdx.x * blockDim.x + threadIdx.x;
+      if (i < static_cast<int> (parent.size))
+        parent.data[i] = i;
+    }
+
+    __global__ void
+    mergeComponentsKernel (const int *sizes, PtrStep<int> data, int queries, int query_offset, int *parent)
+    {
+      const int q = blockIdx.x * blockDim.x + threadIdx.x;
+      if (q >= queries)
+        return;
+
+      const int *neighbors = data.ptr (q);
+      const int size = sizes[q];
+      for (int k = 0; k < size; ++k)
+        unite (parent, query_offset + q, neighbors[k]);
+    }
+
+    __global__ void
+    flattenComponentsKernel (PtrSz<int> parent)
+    {
+      const int i = blockIdx.x * blockDim.x + threadIdx.x;
+      if (i < static_cast<int> (parent.size))
+        parent.data[i] = findRoot (parent.data, i);
+    }
+  }
+}
+
+void
+pcl::gpu::detail::initComponents (DeviceArray<int> &parent)
+{
+  const int block = 256;
+  pcl::device::initComponentsKernel<<<divUp (static_cast<int> (parent.size ()), block), block>>> (parent);
+  cudaSafeCall (cudaGetLastError ());
+}
+
+void
+pcl::gpu::detail::mergeComponents (const NeighborIndices &neighbors, int query_offset, DeviceArray<int> &parent)
+{
+  const int queries = static_cast<int> (neighbors.sizes.size ());
+  if (queries == 0)
+    return;
+
+  const int block = 256;
+  pcl::device::mergeComponentsKernel<<<divUp (queries, block), block>>> (neighbors.sizes.ptr (), neighbors, queries, query_offset, parent.ptr ());
+  cudaSafeCall (cudaGetLastError ());
+}
+
+void
+pcl::gpu::detail::flattenComponents (DeviceArray<int> &parent)
+{
+  const int block = 256;
+  pcl::device::flattenComponentsKernel<<<divUp (static_cast<int> (parent.size ()), block), block>>> (parent);
+  cudaSafeCall (cudaGetLastError ());
+}
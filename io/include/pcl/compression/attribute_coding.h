@@ -0,0 +1,353 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#pragma once
+
+#include <pcl/PCLPointField.h>
+#include <pcl/point_cloud.h>
+
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace pcl
+{
+
+namespace octree
+{
+
+/** \brief @b AttributeCoding class
+ *  \note This class encodes one scalar point field (e.g. intensity, ring, label or a normal
+ *  \note component) for octree-based point cloud compression.
+ *  \note Field values are quantized with a fixed precision. The average of every voxel is
+ *  \note predicted from the previous voxel, and the points of a voxel are coded as differences
+ *  \note to its average. All residuals are stored as variable length integers.
+ *  \note typename: PointT: type of point used in pointcloud
+ */
+template<typename PointT>
+class AttributeCoding
+{
+  // public typedefs
+  using PointCloud = pcl::PointCloud<PointT>;
+  using PointCloudPtr = typename PointCloud::Ptr;
+  using PointCloudConstPtr = typename PointCloud::ConstPtr;
+
+public:
+  /** \brief Constructor.
+    * \param fieldName_arg: name of the coded point field
+    * \param precision_arg: quantization step of the field values
+    */
+  AttributeCoding (const std::string& fieldName_arg, double precision_arg) :
+    fieldName_ (fieldName_arg), precision_ (precision_arg), fieldOffset_ (0),
+    fieldDatatype_ (0), prevAvgValue_ (0)
+  {
+  }
+
+  /** \brief Empty class constructor. */
+  virtual
+  ~AttributeCoding ()
+  {
+  }
+
+  /** \brief Get name of the coded point field. */
+  inline const std::string&
+  getFieldName () const
+  {
+    return (fieldName_);
+  }
+
+  /** \brief Get quantization step of the field values. */
+  inline double
+  getPrecision () const
+  {
+    return (precision_);
+  }
+
+  /** \brief Define the location of the field within PointT.
+    * \param field_arg: point field description, as returned by pcl::getFieldIndex
+    */
+  inline void
+  setField (const pcl::PCLPointField& field_arg)
+  {
+    fieldOffset_ = field_arg.offset;
+    fieldDatatype_ = field_arg.datatype;
+  }
+
+  /** \brief Check whether PointT provides the field, so that its values can be accessed. */
+  inline bool
+  hasField () const
+  {
+    return (fieldDatatype_ != 0);
+  }
+
+  /** \brief Set amount of voxels containing point attributes and reserve memory
+    * \param voxelCount_arg: amounts of voxels
+    */
+  inline void
+  setVoxelCount (unsigned int voxelCount_arg)
+  {
+    pointAvgAttributeDataVector_.reserve (voxelCount_arg);
+  }
+
+  /** \brief Set amount of points within point cloud to be encoded and reserve memory
+    * \param pointCount_arg: amounts of points within point cloud
+    */
+  inline void
+  setPointCount (unsigned int pointCount_arg)
+  {
+    pointDiffAttributeDataVector_.reserve (pointCount_arg);
+  }
+
+  /** \brief Initialize encoding of attribute information */
+  void
+  initializeEncoding ()
+  {
+    pointAvgAttributeDataVector_.clear ();
+    pointDiffAttributeDataVector_.clear ();
+    prevAvgValue_ = 0;
+  }
+
+  /** \brief Initialize decoding of attribute information */
+  void
+  initializeDecoding ()
+  {
+    pointAvgAttributeDataVector_Iterator_ = pointAvgAttributeDataVector_.begin ();
+    pointDiffAttributeDataVector_Iterator_ = pointDiffAttributeDataVector_.begin ();
+    prevAvgValue_ = 0;
+  }
+
+  /** \brief Get reference to vector containing averaged attribute data */
+  std::vector<char>&
+  getAverageDataVector ()
+  {
+    return (pointAvgAttributeDataVector_);
+  }
+
+  /** \brief Get reference to vector containing differential attribute data */
+  std::vector<char>&
+  getDifferentialDataVector ()
+  {
+    return (pointDiffAttributeDataVector_);
+  }
+
+  /** \brief Encode attribute information of a subset of points from point cloud
+    * \param indexVector_arg indices defining a subset of points from points cloud
+    * \param inputCloud_arg input point cloud
+    * \param averageOnly_arg encode the voxel average only, e.g. for voxel grid encoding
+    */
+  void
+  encodePoints (const std::vector<int>& indexVector_arg, PointCloudConstPtr inputCloud_arg, bool averageOnly_arg = false)
+  {
+    const std::size_t len = indexVector_arg.size ();
+
+    // calculate average of quantized values
+    std::int64_t sum = 0;
+    for (const int& idx : indexVector_arg)
+      sum += quantize ((*inputCloud_arg)[idx]);
+
+    const std::int64_t avgValue = (len > 1) ? roundedDivision (sum, static_cast<std::int64_t> (len)) : sum;
+
+    // predict average from previous voxel
+    writeVarInt (avgValue - prevAvgValue_, pointAvgAttributeDataVector_);
+    prevAvgValue_ = avgValue;
+
+    if (len > 1 && !averageOnly_arg)
+    {
+      // differentially encode points to voxel average
+      for (const int& idx : indexVector_arg)
+        writeVarInt (quantize ((*inputCloud_arg)[idx]) - avgValue, pointDiffAttributeDataVector_);
+    }
+  }
+
+  /** \brief Decode attribute information
+    * \param outputCloud_arg output point cloud
+    * \param beginIdx_arg index indicating first point to be assigned with attribute information
+    * \param endIdx_arg index indicating last point to be assigned with attribute information
+    * \param averageOnly_arg decode the voxel average only, e.g. for voxel grid encoding
+    */
+  void
+  decodePoints (PointCloudPtr outputCloud_arg, std::size_t beginIdx_arg, std::size_t endIdx_arg, bool averageOnly_arg = false)
+  {
+    assert (beginIdx_arg <= endIdx_arg);
+
+    const std::size_t pointCount = endIdx_arg - beginIdx_arg;
+
+    // get averaged attribute information of current voxel
+    const std::int64_t avgValue = prevAvgValue_ + readVarInt (pointAvgAttributeDataVector_Iterator_,
+                                                              pointAvgAttributeDataVector_.cend ());
+    prevAvgValue_ = avgValue;
+
+    for (std::size_t i = beginIdx_arg; i < endIdx_arg; i++)
+    {
+      std::int64_t value = avgValue;
+      if (pointCount > 1 && !averageOnly_arg)
+        value += readVarInt (pointDiffAttributeDataVector_Iterator_, pointDiffAttributeDataVector_.cend ());
+
+      if (hasField ())
+        dequantize (value, (*outputCloud_arg)[i]);
+    }
+  }
+
+protected:
+  /** \brief Read the field of a point and quantize it, non-finite values are mapped to zero. */
+  std::int64_t
+  quantize (const PointT& point_arg) const
+  {
+    const std::uint8_t* fieldPtr = reinterpret_cast<const std::uint8_t*> (&point_arg) + fieldOffset_;
+    double value = 0.0;
+    switch (fieldDatatype_)
+    {
+      case pcl::PCLPointField::INT8: value = readField<std::int8_t> (fieldPtr); break;
+      case pcl::PCLPointField::UINT8: value = readField<std::uint8_t> (fieldPtr); break;
+      case pcl::PCLPointField::INT16: value = readField<std::int16_t> (fieldPtr); break;
+      case pcl::PCLPointField::UINT16: value = readField<std::uint16_t> (fieldPtr); break;
+      case pcl::PCLPointField::INT32: value = readField<std::int32_t> (fieldPtr); break;
+      case pcl::PCLPointField::UINT32: value = readField<std::uint32_t> (fieldPtr); break;
+      case pcl::PCLPointField::FLOAT32: value = readField<float> (fieldPtr); break;
+      case pcl::PCLPointField::FLOAT64: value = readField<double> (fieldPtr); break;
+    }
+
+    if (!std::isfinite (value))
+      return (0);
+    return (std::llround (value / precision_));
+  }
+
+  /** \brief Reconstruct a quantized value and write it to the field of a point. */
+  void
+  dequantize (std::int64_t value_arg, PointT& point_arg) const
+  {
+    std::uint8_t* fieldPtr = reinterpret_cast<std::uint8_t*> (&point_arg) + fieldOffset_;
+    const double value = static_cast<double> (value_arg) * precision_;
+    switch (fieldDatatype_)
+    {
+      case pcl::PCLPointField::INT8: writeField<std::int8_t> (std::llround (value), fieldPtr); break;
+      case pcl::PCLPointField::UINT8: writeField<std::uint8_t> (std::llround (value), fieldPtr); break;
+      case pcl::PCLPointField::INT16: writeField<std::int16_t> (std::llround (value), fieldPtr); break;
+      case pcl::PCLPointField::UINT16: writeField<std::uint16_t> (std::llround (value), fieldPtr); break;
+      case pcl::PCLPointField::INT32: writeField<std::int32_t> (std::llround (value), fieldPtr); break;
+      case pcl::PCLPointField::UINT32: writeField<std::uint32_t> (std::llround (value), fieldPtr); break;
+      case pcl::PCLPointField::FLOAT32: writeField<float> (value, fieldPtr); break;
+      case pcl::PCLPointField::FLOAT64: writeField<double> (value, fieldPtr); break;
+    }
+  }
+
+  /** \brief Read a field value of type T from unaligned memory. */
+  template<typename T> static T
+  readField (const std::uint8_t* fieldPtr_arg)
+  {
+    T value;
+    std::memcpy (&value, fieldPtr_arg, sizeof (T));
+    return (value);
+  }
+
+  /** \brief Write a value as type T to unaligned memory. */
+  template<typename T, typename ValueT> static void
+  writeField (ValueT value_arg, std::uint8_t* fieldPtr_arg)
+  {
+    const T value = static_cast<T> (value_arg);
+    std::memcpy (fieldPtr_arg, &value, sizeof (T));
+  }
+
+  /** \brief Division rounded to the nearest integer, halfway cases rounded away from zero. */
+  static std::int64_t
+  roundedDivision (std::int64_t dividend_arg, std::int64_t divisor_arg)
+  {
+    return ((dividend_arg >= 0) ? (dividend_arg + divisor_arg / 2) / divisor_arg
+                                : (dividend_arg - divisor_arg / 2) / divisor_arg);
+  }
+
+  /** \brief Append a zigzag mapped signed integer in 7 bit groups to a data vector. */
+  static void
+  writeVarInt (std::int64_t value_arg, std::vector<char>& dataVector_arg)
+  {
+    std::uint64_t zigzag = (static_cast<std::uint64_t> (value_arg) << 1) ^ static_cast<std::uint64_t> (value_arg >> 63);
+    while (zigzag >= 0x80)
+    {
+      dataVector_arg.push_back (static_cast<char> ((zigzag & 0x7F) | 0x80));
+      zigzag >>= 7;
+    }
+    dataVector_arg.push_back (static_cast<char> (zigzag));
+  }
+
+  /** \brief Read a zigzag mapped signed integer from a data vector, reading stops at its end. */
+  static std::int64_t
+  readVarInt (std::vector<char>::const_iterator& iterator_arg, std::vector<char>::const_iterator end_arg)
+  {
+    std::uint64_t zigzag = 0;
+    for (unsigned int shift = 0; iterator_arg != end_arg && shift < 64; shift += 7)
+    {
+      const std::uint8_t byte = static_cast<std::uint8_t> (*(iterator_arg++));
+      zigzag |= static_cast<std::uint64_t> (byte & 0x7F) << shift;
+      if (!(byte & 0x80))
+        break;
+    }
+    return (static_cast<std::int64_t> (zigzag >> 1) ^ -static_cast<std::int64_t> (zigzag & 1));
+  }
+
+  /** \brief Name of the coded point field. */
+  std::string fieldName_;
+
+  /** \brief Quantization step of the field values. */
+  double precision_;
+
+  /** \brief Offset of the field within PointT. */
+  std::uint32_t fieldOffset_;
+
+  /** \brief Datatype of the field within PointT, zero if PointT lacks the field. */
+  std::uint8_t fieldDatatype_;
+
+  /** \brief Quantized average of the previously coded voxel. */
+  std::int64_t prevAvgValue_;
+
+  /** \brief Vector for storing average attribute information  */
+  std::vector<char> pointAvgAttributeDataVector_;
+
+  /** \brief Iterator on average attribute information vector */
+  std::vector<char>::const_iterator pointAvgAttributeDataVector_Iterator_;
+
+  /** \brief Vector for storing differential attribute information  */
+  std::vector<char> pointDiffAttributeDataVector_;
+
+  /** \brief Iterator on differential attribute information vector */
+  std::vector<char>::const_iterator pointDiffAttributeDataVector_Iterator_;
+};
+
+} // namespace octree
+} // namespace pcl
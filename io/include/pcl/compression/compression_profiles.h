@@ -176,5 +176,25 @@ namespace pcl
         true /* doColorEncoding = */
     }};
 
+    // attribute quantization profile
+    struct attributeProfile_t
+    {
+      const char* fieldName;
+      double precision;
+    };
+
+    // predefined quantization steps of common point fields
+    const struct attributeProfile_t attributeProfiles_[] = {
+      {"intensity", 0.1},
+      {"ring", 1.0},
+      {"label", 1.0},
+      {"time", 1e-6},
+      {"timestamp", 1e-6},
+      {"normal_x", 1.0 / 512.0},
+      {"normal_y", 1.0 / 512.0},
+      {"normal_z", 1.0 / 512.0},
+      {"curvature", 1.0 / 512.0}
+    };
+
   }
 }
@@ -185,6 +185,89 @@ namespace pcl
       std::vector<char> outputCharVector_;
 
   };
+
+  //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  /** \brief @b InterleavedRansCoder compression class
+   *  \note This class provides static entropy coding based on range asymmetric numeral systems (rANS).
+   *  \note Its symbol frequency table is precomputed and encoded to the output stream. Four rANS states
+   *  \note are interleaved over the symbol sequence, so consecutive symbols are coded by independent
+   *  \note dependency chains and decoding uses a table lookup instead of a symbol search.
+   *  \note The resulting stream is not compatible with StaticRangeCoder.
+   */
+  //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  class InterleavedRansCoder
+  {
+    public:
+      /** \brief Empty constructor. */
+      InterleavedRansCoder ()
+      {
+      }
+
+      /** \brief Empty deconstructor. */
+      virtual
+      ~InterleavedRansCoder ()
+      {
+      }
+
+      /** \brief Encode integer vector to output stream
+        * \note Values up to 254 are entropy coded, larger values are escaped and stored verbatim.
+        * \param[in] inputIntVector_arg input vector
+        * \param[out] outputByteStream_arg output stream containing compressed data
+        * \return amount of bytes written to output stream
+        */
+      unsigned long
+      encodeIntVectorToStream (const std::vector<unsigned int>& inputIntVector_arg, std::ostream& outputByteStream_arg);
+
+      /** \brief Decode stream to output integer vector
+       * \param inputByteStream_arg input stream of compressed data
+       * \param outputIntVector_arg decompressed output vector
+       * \return amount of bytes read from input stream
+       */
+      unsigned long
+      decodeStreamToIntVector (std::istream& inputByteStream_arg, std::vector<unsigned int>& outputIntVector_arg);
+
+      /** \brief Encode char vector to output stream
+       * \param inputByteVector_arg input vector
+       * \param outputByteStream_arg output stream containing compressed data
+       * \return amount of bytes written to output stream
+       */
+      unsigned long
+      encodeCharVectorToStream (const std::vector<char>& inputByteVector_arg, std::ostream& outputByteStream_arg);
+
+      /** \brief Decode char stream to output vector
+       * \param inputByteStream_arg input stream of compressed data
+       * \param outputByteVector_arg decompressed output vector
+       * \return amount of bytes read from input stream
+       */
+      unsigned long
+      decodeStreamToCharVector (std::istream& inputByteStream_arg, std::vector<char>& outputByteVector_arg);
+
+    protected:
+      /** \brief Amount of interleaved rANS states. */
+      static constexpr unsigned int stateCount_ = 4;
+
+      /** \brief Precision of the normalized symbol frequencies in bits. */
+      static constexpr unsigned int scaleBits_ = 12;
+
+      /** \brief Lower bound of the normalized rANS state interval. */
+      static constexpr std::uint32_t stateLowerBound_ = static_cast<std::uint32_t> (1) << 23;
+
+    private:
+      /** \brief Normalized symbol frequency table, summing up to 1 << scaleBits_. */
+      std::uint32_t freqTable_[256];
+
+      /** \brief Cumulative normalized symbol frequency table. */
+      std::uint32_t cFreqTable_[256];
+
+      /** \brief Symbol lookup table over all 1 << scaleBits_ frequency slots. */
+      std::vector<std::uint8_t> slotSymbolTable_;
+
+      /** \brief Vector containing compressed data. */
+      std::vector<std::uint8_t> compressedDataVector_;
+
+      /** \brief Vector containing the symbols of integer vectors. */
+      std::vector<char> symbolVector_;
+  };
 }
 
 
@@ -622,5 +622,236 @@ pcl::StaticRangeCoder::decodeStreamToCharVector (std::istream& inputByteStream_a
   return (streamByteCount);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////
+unsigned long
+pcl::InterleavedRansCoder::encodeCharVectorToStream (const std::vector<char>& inputByteVector_arg,
+                                                     std::ostream& outputByteStream_arg)
+{
+  const std::uint32_t totalFreq = static_cast<std::uint32_t> (1) << scaleBits_;
+  const std::size_t input_size = inputByteVector_arg.size ();
+
+  // calculate frequency histogram
+  std::uint64_t FreqHist[256];
+  memset (FreqHist, 0, sizeof(FreqHist));
+  for (const char symbol : inputByteVector_arg)
+    FreqHist[static_cast<std::uint8_t> (symbol)]++;
+
+  // normalize frequencies to totalFreq, occurring symbols keep a frequency of at least one
+  std::uint32_t freqSum = 0;
+  unsigned int maxSymbol = 0;
+  for (unsigned int s = 0; s < 256; s++)
+  {
+    freqTable_[s] = 0;
+    if (FreqHist[s] > 0)
+      freqTable_[s] = std::max (static_cast<std::uint32_t> (FreqHist[s] * totalFreq / input_size), static_cast<std::uint32_t> (1));
+    freqSum += freqTable_[s];
+    if (freqTable_[s] > freqTable_[maxSymbol])
+      maxSymbol = s;
+  }
+
+  // distribute the rounding error over the most frequent symbols
+  if (input_size > 0)
+  {
+    if (freqSum < totalFreq)
+      freqTable_[maxSymbol] += totalFreq - freqSum;
+    while (freqSum > totalFreq)
+    {
+      maxSymbol = static_cast<unsigned int> (std::max_element (freqTable_, freqTable_ + 256) - freqTable_);
+      const std::uint32_t reduction = std::min (freqSum - totalFreq, freqTable_[maxSymbol] - 1);
+      freqTable_[maxSymbol] -= reduction;
+      freqSum -= reduction;
+    }
+  }
+
+  // convert to cumulative frequency table
+  std::uint16_t freq[256];
+  std::uint32_t cFreq = 0;
+  for (unsigned int s = 0; s < 256; s++)
+  {
+    freq[s] = static_cast<std::uint16_t> (freqTable_[s]);
+    cFreqTable_[s] = cFreq;
+    cFreq += freqTable_[s];
+  }
+
+  // write normalized frequency table to output stream
+  outputByteStream_arg.write (reinterpret_cast<const char*> (&freq[0]), sizeof(freq));
+  unsigned long streamByteCount = sizeof(freq);
+
+  // rANS encodes in reverse order, so the output buffer is filled from its end. Every symbol
+  // emits at most scaleBits_ bits.
+  compressedDataVector_.resize (2 * input_size + 1);
+  std::uint8_t* const bufEnd = compressedDataVector_.data () + compressedDataVector_.size ();
+  std::uint8_t* outPtr = bufEnd;
+
+  std::uint32_t state[stateCount_];
+  for (std::uint32_t& x : state)
+    x = stateLowerBound_;
+
+  // start encoding, symbol i is coded by state i % stateCount_
+  for (std::size_t i = input_size; i-- > 0;)
+  {
+    const std::uint8_t ch = static_cast<std::uint8_t> (inputByteVector_arg[i]);
+    std::uint32_t& x = state[i % stateCount_];
+
+    // renormalize so that x stays within its interval after coding the symbol
+    const std::uint32_t xMax = ((stateLowerBound_ >> scaleBits_) << 8) * freqTable_[ch];
+    while (x >= xMax)
+    {
+      *--outPtr = static_cast<std::uint8_t> (x & 0xFF);
+      x >>= 8;
+    }
+
+    // map to state
+    x = ((x / freqTable_[ch]) << scaleBits_) + (x % freqTable_[ch]) + cFreqTable_[ch];
+  }
+
+  // write final states and encoded data to stream
+  const std::uint64_t compressedSize = static_cast<std::uint64_t> (bufEnd - outPtr);
+  outputByteStream_arg.write (reinterpret_cast<const char*> (&compressedSize), sizeof(compressedSize));
+  outputByteStream_arg.write (reinterpret_cast<const char*> (&state[0]), sizeof(state));
+  outputByteStream_arg.write (reinterpret_cast<const char*> (outPtr), static_cast<std::streamsize> (compressedSize));
+
+  streamByteCount += static_cast<unsigned long> (sizeof(compressedSize) + sizeof(state) + compressedSize);
+
+  return (streamByteCount);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+unsigned long
+pcl::InterleavedRansCoder::decodeStreamToCharVector (std::istream& inputByteStream_arg,
+                                                     std::vector<char>& outputByteVector_arg)
+{
+  const std::uint32_t totalFreq = static_cast<std::uint32_t> (1) << scaleBits_;
+  const std::uint32_t slotMask = totalFreq - 1;
+  const std::size_t output_size = outputByteVector_arg.size ();
+
+  // read normalized frequency table
+  std::uint16_t freq[256];
+  inputByteStream_arg.read (reinterpret_cast<char*> (&freq[0]), sizeof(freq));
+  unsigned long streamByteCount = sizeof(freq);
+
+  // build cumulative frequency and symbol lookup tables
+  slotSymbolTable_.assign (totalFreq, 0);
+  std::uint32_t cFreq = 0;
+  for (unsigned int s = 0; s < 256; s++)
+  {
+    freqTable_[s] = std::min (static_cast<std::uint32_t> (freq[s]), totalFreq - cFreq);
+    cFreqTable_[s] = cFreq;
+    std::fill_n (slotSymbolTable_.begin () + cFreq, freqTable_[s], static_cast<std::uint8_t> (s));
+    cFreq += freqTable_[s];
+  }
+
+  // read initial states and encoded data
+  std::uint64_t compressedSize = 0;
+  std::uint32_t state[stateCount_];
+  inputByteStream_arg.read (reinterpret_cast<char*> (&compressedSize), sizeof(compressedSize));
+  inputByteStream_arg.read (reinterpret_cast<char*> (&state[0]), sizeof(state));
+  compressedDataVector_.resize (static_cast<std::size_t> (compressedSize));
+  inputByteStream_arg.read (reinterpret_cast<char*> (compressedDataVector_.data ()), static_cast<std::streamsize> (compressedSize));
+  streamByteCount += static_cast<unsigned long> (sizeof(compressedSize) + sizeof(state) + compressedSize);
+
+  const std::uint8_t* inPtr = compressedDataVector_.data ();
+  const std::uint8_t* const bufEnd = inPtr + compressedDataVector_.size ();
+
+  auto decodeSymbol = [&] (std::uint32_t& x)
+  {
+    // symbol lookup in slot table
+    const std::uint8_t symbol = slotSymbolTable_[x & slotMask];
+
+    // map to state
+    x = freqTable_[symbol] * (x >> scaleBits_) + (x & slotMask) - cFreqTable_[symbol];
+
+    // renormalize
+    while (x < stateLowerBound_ && inPtr != bufEnd)
+      x = (x << 8) | *inPtr++;
+
+    return (static_cast<char> (symbol));
+  };
+
+  // decoding, the interleaved states are independent within each group of stateCount_ symbols
+  std::size_t i = 0;
+  for (; i + stateCount_ <= output_size; i += stateCount_)
+  {
+    outputByteVector_arg[i] = decodeSymbol (state[0]);
+    outputByteVector_arg[i + 1] = decodeSymbol (state[1]);
+    outputByteVector_arg[i + 2] = decodeSymbol (state[2]);
+    outputByteVector_arg[i + 3] = decodeSymbol (state[3]);
+  }
+  for (; i < output_size; i++)
+    outputByteVector_arg[i] = decodeSymbol (state[i % stateCount_]);
+
+  return (streamByteCount);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+unsigned long
+pcl::InterleavedRansCoder::encodeIntVectorToStream (const std::vector<unsigned int>& inputIntVector_arg,
+                                                    std::ostream& outputByteStream_arg)
+{
+  const std::uint8_t escapeSymbol = 0xFF;
+
+  // values below the escape symbol are coded as symbols, larger values are stored verbatim
+  std::vector<std::uint32_t> escapedValues;
+  symbolVector_.resize (inputIntVector_arg.size ());
+  for (std::size_t i = 0; i < inputIntVector_arg.size (); i++)
+  {
+    if (inputIntVector_arg[i] < escapeSymbol)
+    {
+      symbolVector_[i] = static_cast<char> (inputIntVector_arg[i]);
+    }
+    else
+    {
+      symbolVector_[i] = static_cast<char> (escapeSymbol);
+      escapedValues.push_back (static_cast<std::uint32_t> (inputIntVector_arg[i]));
+    }
+  }
+
+  unsigned long streamByteCount = encodeCharVectorToStream (symbolVector_, outputByteStream_arg);
+
+  // write escaped values to stream
+  const std::uint64_t escapedCount = escapedValues.size ();
+  outputByteStream_arg.write (reinterpret_cast<const char*> (&escapedCount), sizeof(escapedCount));
+  outputByteStream_arg.write (reinterpret_cast<const char*> (escapedValues.data ()),
+                              static_cast<std::streamsize> (escapedCount * sizeof(std::uint32_t)));
+
+  streamByteCount += static_cast<unsigned long> (sizeof(escapedCount) + escapedCount * sizeof(std::uint32_t));
+
+  return (streamByteCount);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+unsigned long
+pcl::InterleavedRansCoder::decodeStreamToIntVector (std::istream& inputByteStream_arg,
+                                                    std::vector<unsigned int>& outputIntVector_arg)
+{
+  const std::uint8_t escapeSymbol = 0xFF;
+
+  symbolVector_.resize (outputIntVector_arg.size ());
+  unsigned long streamByteCount = decodeStreamToCharVector (inputByteStream_arg, symbolVector_);
+
+  // read escaped values from stream
+  std::uint64_t escapedCount = 0;
+  inputByteStream_arg.read (reinterpret_cast<char*> (&escapedCount), sizeof(escapedCount));
+  std::vector<std::uint32_t> escapedValues (static_cast<std::size_t> (escapedCount));
+  inputByteStream_arg.read (reinterpret_cast<char*> (escapedValues.data ()),
+                            static_cast<std::streamsize> (escapedCount * sizeof(std::uint32_t)));
+
+  streamByteCount += static_cast<unsigned long> (sizeof(escapedCount) + escapedCount * sizeof(std::uint32_t));
+
+  std::size_t escapedPos = 0;
+  for (std::size_t i = 0; i < outputIntVector_arg.size (); i++)
+  {
+    const std::uint8_t symbol = static_cast<std::uint8_t> (symbolVector_[i]);
+    if (symbol != escapeSymbol)
+      outputIntVector_arg[i] = symbol;
+    else if (escapedPos < escapedValues.size ())
+      outputIntVector_arg[i] = escapedValues[escapedPos++];
+    else
+      outputIntVector_arg[i] = 0;
+  }
+
+  return (streamByteCount);
+}
+
 #endif
 
@@ -0,0 +1,384 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+
+#ifndef OCTREE_COMPRESSION_ARCHIVE_HPP
+#define OCTREE_COMPRESSION_ARCHIVE_HPP
+
+#include <pcl/compression/octree_compression_archive.h>
+#include <pcl/console/print.h>
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+#include <string>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace pcl
+{
+  namespace io
+  {
+    namespace detail
+    {
+      const char archive_header_identifier[] = "<PCL-OCT-ARCHIVE>";
+      const char archive_index_identifier[] = "<PCL-OCT-INDEX>";
+      const std::uint32_t archive_version = 1;
+
+      // size of an index entry: offset, size, stamp, point count and frame type
+      const std::size_t archive_index_entry_size = 4 * sizeof (std::uint64_t) + sizeof (std::uint8_t);
+      // size of the trailer: index offset, frame count and index identifier
+      const std::size_t archive_trailer_size = 2 * sizeof (std::uint64_t) + sizeof (archive_index_identifier) - 1;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename PointT>
+    OctreeCompressionArchiveWriter<PointT>::OctreeCompressionArchiveWriter (std::ostream& archive_out_arg,
+                                                                            Encoder& encoder_arg) :
+      archive_out_ (archive_out_arg),
+      encoder_ (encoder_arg),
+      archive_size_ (0),
+      closed_ (false)
+    {
+      archive_out_.write (detail::archive_header_identifier, sizeof (detail::archive_header_identifier) - 1);
+      archive_out_.write (reinterpret_cast<const char*> (&detail::archive_version), sizeof (detail::archive_version));
+      archive_size_ = sizeof (detail::archive_header_identifier) - 1 + sizeof (detail::archive_version);
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename PointT>
+    OctreeCompressionArchiveWriter<PointT>::~OctreeCompressionArchiveWriter ()
+    {
+      if (!closed_)
+        close ();
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename PointT> void
+    OctreeCompressionArchiveWriter<PointT>::writeFrame (const PointCloudConstPtr& cloud_arg)
+    {
+      if (closed_)
+      {
+        PCL_ERROR ("[pcl::io::OctreeCompressionArchiveWriter::writeFrame] Archive has already been closed!\n");
+        return;
+      }
+
+      OctreeCompressionFrameInfo frame;
+      frame.offset = archive_size_;
+      frame.stamp = cloud_arg->header.stamp;
+      frame.point_count = cloud_arg->size ();
+      frame.key_frame = false;
+
+      std::ostringstream frame_data;
+      encoder_.encodePointCloud (cloud_arg, frame_data);
+      const std::string data = frame_data.str ();
+
+      // empty point clouds are dropped by the encoder and leave its state untouched
+      frame.size = data.size ();
+      if (!data.empty ())
+        frame.key_frame = encoder_.isLastFrameIFrame ();
+
+      archive_out_.write (data.data (), data.size ());
+      archive_size_ += data.size ();
+      frames_.push_back (frame);
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename PointT> void
+    OctreeCompressionArchiveWriter<PointT>::close ()
+    {
+      if (closed_)
+        return;
+
+      const std::uint64_t index_offset = archive_size_;
+      for (const OctreeCompressionFrameInfo& frame : frames_)
+      {
+        const std::uint8_t key_frame = frame.key_frame;
+        archive_out_.write (reinterpret_cast<const char*> (&frame.offset), sizeof (frame.offset));
+        archive_out_.write (reinterpret_cast<const char*> (&frame.size), sizeof (frame.size));
+        archive_out_.write (reinterpret_cast<const char*> (&frame.stamp), sizeof (frame.stamp));
+        archive_out_.write (reinterpret_cast<const char*> (&frame.point_count), sizeof (frame.point_count));
+        archive_out_.write (reinterpret_cast<const char*> (&key_frame), sizeof (key_frame));
+      }
+
+      const std::uint64_t frame_count = frames_.size ();
+      archive_out_.write (reinterpret_cast<const char*> (&index_offset), sizeof (index_offset));
+      archive_out_.write (reinterpret_cast<const char*> (&frame_count), sizeof (frame_count));
+      archive_out_.write (detail::archive_index_identifier, sizeof (detail::archive_index_identifier) - 1);
+      archive_out_.flush ();
+
+      archive_size_ += frames_.size () * detail::archive_index_entry_size + detail::archive_trailer_size;
+      closed_ = true;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename PointT>
+    OctreeCompressionArchiveReader<PointT>::OctreeCompressionArchiveReader () :
+      archive_in_ (nullptr),
+      archive_begin_ (0),
+      decoder_ (),
+      decoded_frame_idx_ (-1),
+      threads_ (1)
+    {
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename PointT> bool
+    OctreeCompressionArchiveReader<PointT>::open (std::istream& archive_in_arg)
+    {
+      archive_in_ = nullptr;
+      frames_.clear ();
+      key_frames_.clear ();
+      decoded_frame_idx_ = -1;
+
+      archive_begin_ = archive_in_arg.tellg ();
+
+      // check archive header
+      const std::size_t header_size = sizeof (detail::archive_header_identifier) - 1;
+      char header[sizeof (detail::archive_header_identifier)] = {};
+      std::uint32_t version = 0;
+      archive_in_arg.read (header, header_size);
+      archive_in_arg.read (reinterpret_cast<char*> (&version), sizeof (version));
+      if (!archive_in_arg || std::strcmp (header, detail::archive_header_identifier) != 0)
+      {
+        PCL_ERROR ("[pcl::io::OctreeCompressionArchiveReader::open] Stream holds no point cloud archive!\n");
+        return (false);
+      }
+      if (version != detail::archive_version)
+      {
+        PCL_ERROR ("[pcl::io::OctreeCompressionArchiveReader::open] Unsupported archive version %u!\n", version);
+        return (false);
+      }
+
+      // read trailer at the end of the stream
+      archive_in_arg.seekg (0, std::ios::end);
+      const std::streamoff archive_size = static_cast<std::streamoff> (archive_in_arg.tellg ()) - archive_begin_;
+      if (archive_size < static_cast<std::streamoff> (header_size + sizeof (version) + detail::archive_trailer_size))
+      {
+        PCL_ERROR ("[pcl::io::OctreeCompressionArchiveReader::open] Archive has no frame index!\n");
+        return (false);
+      }
+
+      std::uint64_t index_offset = 0;
+      std::uint64_t frame_count = 0;
+      char index_identifier[sizeof (detail::archive_index_identifier)] = {};
+      archive_in_arg.seekg (archive_begin_ + archive_size - static_cast<std::streamoff> (detail::archive_trailer_size));
+      archive_in_arg.read (reinterpret_cast<char*> (&index_offset), sizeof (index_offset));
+      archive_in_arg.read (reinterpret_cast<char*> (&frame_count), sizeof (frame_count));
+      archive_in_arg.read (index_identifier, sizeof (detail::archive_index_identifier) - 1);
+      if (!archive_in_arg || std::strcmp (index_identifier, detail::archive_index_identifier) != 0 ||
+          index_offset + frame_count * detail::archive_index_entry_size + detail::archive_trailer_size !=
+          static_cast<std::uint64_t> (archive_size))
+      {
+        PCL_ERROR ("[pcl::io::OctreeCompressionArchiveReader::open] Archive has no valid frame index!\n");
+        return (false);
+      }
+
+      // read frame index
+      archive_in_arg.seekg (archive_begin_ + static_cast<std::streamoff> (index_offset));
+      frames_.resize (frame_count);
+      for (std::size_t i = 0; i < frames_.size (); ++i)
+      {
+        OctreeCompressionFrameInfo& frame = frames_[i];
+        std::uint8_t key_frame = 0;
+        archive_in_arg.read (reinterpret_cast<char*> (&frame.offset), sizeof (frame.offset));
+        archive_in_arg.read (reinterpret_cast<char*> (&frame.size), sizeof (frame.size));
+        archive_in_arg.read (reinterpret_cast<char*> (&frame.stamp), sizeof (frame.stamp));
+        archive_in_arg.read (reinterpret_cast<char*> (&frame.point_count), sizeof (frame.point_count));
+        archive_in_arg.read (reinterpret_cast<char*> (&key_frame), sizeof (key_frame));
+        frame.key_frame = key_frame != 0;
+
+        if (!archive_in_arg || frame.offset + frame.size > index_offset)
+        {
+          PCL_ERROR ("[pcl::io::OctreeCompressionArchiveReader::open] Corrupt index entry for frame %zu!\n", i);
+          frames_.clear ();
+          key_frames_.clear ();
+          return (false);
+        }
+        if (frame.key_frame)
+          key_frames_.push_back (i);
+      }
+
+      archive_in_ = &archive_in_arg;
+      return (true);
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename PointT> std::size_t
+    OctreeCompressionArchiveReader<PointT>::getKeyFrame (std::size_t frame_idx) const
+    {
+      auto key_frame = std::upper_bound (key_frames_.begin (), key_frames_.end (), frame_idx);
+      // only empty frames can precede the first I-frame
+      if (key_frame == key_frames_.begin ())
+        return (frame_idx);
+      return (*(--key_frame));
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename PointT> bool
+    OctreeCompressionArchiveReader<PointT>::readFrame (std::size_t frame_idx, PointCloudPtr& cloud_arg)
+    {
+      if (!archive_in_ || frame_idx >= frames_.size ())
+      {
+        PCL_ERROR ("[pcl::io::OctreeCompressionArchiveReader::readFrame] Frame %zu is not available!\n", frame_idx);
+        return (false);
+      }
+
+      // continue from the last decoded frame if no I-frame lies in between
+      std::size_t next_frame_idx = getKeyFrame (frame_idx);
+      if (decoded_frame_idx_ >= static_cast<std::ptrdiff_t> (next_frame_idx) &&
+          decoded_frame_idx_ < static_cast<std::ptrdiff_t> (frame_idx))
+        next_frame_idx = decoded_frame_idx_ + 1;
+
+      std::string data;
+      for (; next_frame_idx <= frame_idx; ++next_frame_idx)
+      {
+        if (!readFrameData (next_frame_idx, data))
+          return (false);
+        decodeFrame (decoder_, data, cloud_arg);
+        decoded_frame_idx_ = next_frame_idx;
+      }
+      cloud_arg->header.stamp = frames_[frame_idx].stamp;
+
+      return (true);
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename PointT> bool
+    OctreeCompressionArchiveReader<PointT>::readFrames (std::size_t first_frame_idx, std::size_t last_frame_idx,
+                                                        std::vector<PointCloudPtr>& clouds_arg)
+    {
+      if (!archive_in_ || first_frame_idx > last_frame_idx || last_frame_idx >= frames_.size ())
+      {
+        PCL_ERROR ("[pcl::io::OctreeCompressionArchiveReader::readFrames] Frames %zu to %zu are not available!\n",
+                   first_frame_idx, last_frame_idx);
+        return (false);
+      }
+
+      // load compressed data sequentially, starting at the I-frame of the first frame
+      const std::size_t begin_frame_idx = getKeyFrame (first_frame_idx);
+      std::vector<std::string> data (last_frame_idx - begin_frame_idx + 1);
+      for (std::size_t i = 0; i < data.size (); ++i)
+        if (!readFrameData (begin_frame_idx + i, data[i]))
+          return (false);
+
+      // split into groups of frames that decode independently
+      std::vector<std::size_t> group_begin (1, begin_frame_idx);
+      for (const std::size_t key_frame : key_frames_)
+        if (key_frame > begin_frame_idx && key_frame <= last_frame_idx)
+          group_begin.push_back (key_frame);
+      group_begin.push_back (last_frame_idx + 1);
+
+      clouds_arg.resize (last_frame_idx - first_frame_idx + 1);
+#pragma omp parallel for schedule(dynamic,1) num_threads(threads_)
+      for (std::ptrdiff_t group = 0; group < static_cast<std::ptrdiff_t> (group_begin.size ()) - 1; ++group)
+      {
+        Decoder decoder;
+        PointCloudPtr cloud (new PointCloud);
+        for (std::size_t frame_idx = group_begin[group]; frame_idx < group_begin[group + 1]; ++frame_idx)
+        {
+          decodeFrame (decoder, data[frame_idx - begin_frame_idx], cloud);
+          if (frame_idx >= first_frame_idx)
+          {
+            cloud->header.stamp = frames_[frame_idx].stamp;
+            clouds_arg[frame_idx - first_frame_idx] = cloud;
+            cloud.reset (new PointCloud);
+          }
+        }
+      }
+
+      return (true);
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename PointT> void
+    OctreeCompressionArchiveReader<PointT>::setNumberOfThreads (unsigned int nr_threads)
+    {
+      if (nr_threads == 0)
+#ifdef _OPENMP
+        threads_ = omp_get_num_procs ();
+#else
+        threads_ = 1;
+#endif
+      else
+        threads_ = nr_threads;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename PointT> bool
+    OctreeCompressionArchiveReader<PointT>::readFrameData (std::size_t frame_idx, std::string& data_arg)
+    {
+      const OctreeCompressionFrameInfo& frame = frames_[frame_idx];
+      data_arg.resize (frame.size);
+      if (frame.size == 0)
+        return (true);
+
+      archive_in_->clear ();
+      archive_in_->seekg (archive_begin_ + static_cast<std::streamoff> (frame.offset));
+      archive_in_->read (&data_arg[0], static_cast<std::streamsize> (frame.size));
+      if (!*archive_in_)
+      {
+        PCL_ERROR ("[pcl::io::OctreeCompressionArchiveReader::readFrameData] Failed to read frame %zu!\n", frame_idx);
+        return (false);
+      }
+      return (true);
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename PointT> void
+    OctreeCompressionArchiveReader<PointT>::decodeFrame (Decoder& decoder_arg, const std::string& data_arg,
+                                                         PointCloudPtr& cloud_arg)
+    {
+      if (!cloud_arg)
+        cloud_arg.reset (new PointCloud);
+
+      // empty point clouds do not advance the decoder
+      if (data_arg.empty ())
+      {
+        cloud_arg->clear ();
+        return;
+      }
+
+      std::istringstream frame_data (data_arg);
+      decoder_arg.decodePointCloud (frame_data, cloud_arg);
+    }
+  }
+}
+
+#endif
@@ -42,6 +42,7 @@
 
 #include <iterator>
 #include <iostream>
+#include <sstream>
 #include <vector>
 #include <cstring>
 #include <iostream>
@@ -51,6 +52,43 @@ namespace pcl
 {
   namespace io
   {
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template<typename PointT, typename LeafT, typename BranchT, typename OctreeT> bool
+    OctreePointCloudCompression<PointT, LeafT, BranchT, OctreeT>::addAttributeEncoding (
+        const std::string& field_name_arg, double precision_arg)
+    {
+      std::vector<pcl::PCLPointField> fields;
+      const int field_index = pcl::getFieldIndex<PointT> (field_name_arg, fields);
+      if (field_index < 0)
+      {
+        PCL_ERROR ("[pcl::io::OctreePointCloudCompression::addAttributeEncoding] Point type has no field %s!\n",
+                   field_name_arg.c_str ());
+        return (false);
+      }
+
+      if (precision_arg <= 0.0)
+      {
+        // look up quantization profile of the field
+        precision_arg = 1.0;
+        for (const attributeProfile_t& profile : attributeProfiles_)
+          if (field_name_arg == profile.fieldName)
+            precision_arg = profile.precision;
+      }
+
+      attribute_coders_.emplace_back (field_name_arg, precision_arg);
+      attribute_coders_.back ().setField (fields[field_index]);
+      attributes_changed_ = true;
+      return (true);
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template<typename PointT, typename LeafT, typename BranchT, typename OctreeT> void
+    OctreePointCloudCompression<PointT, LeafT, BranchT, OctreeT>::clearAttributeEncoding ()
+    {
+      attribute_coders_.clear ();
+      attributes_changed_ = true;
+    }
+
     //////////////////////////////////////////////////////////////////////////////////////////////
     template<typename PointT, typename LeafT, typename BranchT, typename OctreeT> void OctreePointCloudCompression<
         PointT, LeafT, BranchT, OctreeT>::encodePointCloud (
@@ -92,6 +130,10 @@ namespace pcl
         // if octree depth changed, we enforce I-frame encoding
         i_frame_ |= (recent_tree_depth != this->getTreeDepth ());// | !(iFrameCounter%10);
 
+        // if encoded point fields changed, we enforce I-frame encoding
+        i_frame_ |= attributes_changed_;
+        attributes_changed_ = false;
+
         // enable I-frame rate
         if (i_frame_counter_++==i_frame_rate_)
         {
@@ -118,6 +160,14 @@ namespace pcl
         point_coder_.initializeEncoding ();
         point_coder_.setPointCount (static_cast<unsigned int> (cloud_arg->size ()));
 
+        // initialize attribute encoding
+        for (AttributeCoding<PointT>& attribute_coder : attribute_coders_)
+        {
+          attribute_coder.initializeEncoding ();
+          attribute_coder.setPointCount (static_cast<unsigned int> (cloud_arg->size ()));
+          attribute_coder.setVoxelCount (static_cast<unsigned int> (this->leaf_count_));
+        }
+
         // serialize octree
         if (i_frame_)
           // i-frame encoding - encode tree structure without referencing previous buffer
@@ -155,6 +205,8 @@ namespace pcl
           PCL_INFO ("XYZ bytes per point: %f bytes\n", bytes_per_XYZ);
           PCL_INFO ("Color compression percentage: %f%%\n", bytes_per_color / (sizeof (int)) * 100.0f);
           PCL_INFO ("Color bytes per point: %f bytes\n", bytes_per_color);
+          if (!attribute_coders_.empty ())
+            PCL_INFO ("Attribute bytes per point: %f bytes\n", static_cast<float> (compressed_attribute_data_len_) / static_cast<float> (point_count_));
           PCL_INFO ("Size of uncompressed point cloud: %f kBytes\n", static_cast<float> (point_count_) * (sizeof (int) + 3.0f * sizeof (float)) / 1024.0f);
           PCL_INFO ("Size of compressed point cloud: %f kBytes\n", static_cast<float> (compressed_point_data_len_ + compressed_color_data_len_) / 1024.0f);
           PCL_INFO ("Total bytes per point: %f bytes\n", bytes_per_XYZ + bytes_per_color);
@@ -162,6 +214,7 @@ namespace pcl
           PCL_INFO ("Compression ratio: %f\n\n", static_cast<float> (sizeof (int) + 3.0f * sizeof (float)) / static_cast<float> (bytes_per_XYZ + bytes_per_color));
         }
         
+        last_frame_i_frame_ = i_frame_;
         i_frame_ = false;
       } else {
         if (b_show_statistics_)
@@ -201,6 +254,7 @@ namespace pcl
 
       // read header from input stream
       this->readFrameHeader (compressed_tree_data_in_arg);
+      last_frame_i_frame_ = i_frame_;
 
       // decode data vectors from stream
       this->entropyDecoding (compressed_tree_data_in_arg);
@@ -208,6 +262,9 @@ namespace pcl
       // initialize color and point encoding
       color_coder_.initializeDecoding ();
       point_coder_.initializeDecoding ();
+      if (frame_with_attributes_)
+        for (AttributeCoding<PointT>& attribute_coder : attribute_coders_)
+          attribute_coder.initializeDecoding ();
 
       // initialize output cloud
       output_->points.clear ();
@@ -241,6 +298,8 @@ namespace pcl
         PCL_INFO ("XYZ bytes per point: %f bytes\n", bytes_per_XYZ);
         PCL_INFO ("Color compression percentage: %f%%\n", bytes_per_color / (sizeof (int)) * 100.0f);
         PCL_INFO ("Color bytes per point: %f bytes\n", bytes_per_color);
+        if (frame_with_attributes_)
+          PCL_INFO ("Attribute bytes per point: %f bytes\n", static_cast<float> (compressed_attribute_data_len_) / static_cast<float> (point_count_));
         PCL_INFO ("Size of uncompressed point cloud: %f kBytes\n", static_cast<float> (point_count_) * (sizeof (int) + 3.0f * sizeof (float)) / 1024.0f);
         PCL_INFO ("Size of compressed point cloud: %f kBytes\n", static_cast<float> (compressed_point_data_len_ + compressed_color_data_len_) / 1024.0f);
         PCL_INFO ("Total bytes per point: %f bytes\n", bytes_per_XYZ + bytes_per_color);
@@ -253,65 +312,126 @@ namespace pcl
     template<typename PointT, typename LeafT, typename BranchT, typename OctreeT> void
     OctreePointCloudCompression<PointT, LeafT, BranchT, OctreeT>::entropyEncoding (std::ostream& compressed_tree_data_out_arg)
     {
-      std::uint64_t binary_tree_data_vector_size;
-      std::uint64_t point_avg_color_data_vector_size;
-
-      compressed_point_data_len_ = 0;
-      compressed_color_data_len_ = 0;
-
-      // encode binary octree structure
-      binary_tree_data_vector_size = binary_tree_data_vector_.size ();
-      compressed_tree_data_out_arg.write (reinterpret_cast<const char*> (&binary_tree_data_vector_size), sizeof (binary_tree_data_vector_size));
-      compressed_point_data_len_ += entropy_coder_.encodeCharVectorToStream (binary_tree_data_vector_,
-                                                                             compressed_tree_data_out_arg);
-
-      if (cloud_with_color_)
+      // data vectors in the order of the stream: binary octree structure, averaged voxel
+      // colors, amount of points per voxel, differential point and color information,
+      // followed by the averaged and differential information of every point attribute
+      const int data_vector_count = 5 + 2 * static_cast<int> (attribute_coders_.size ());
+      std::vector<bool> data_vector_used = {
+          true,
+          cloud_with_color_,
+          !do_voxel_grid_enDecoding_,
+          !do_voxel_grid_enDecoding_,
+          !do_voxel_grid_enDecoding_ && cloud_with_color_};
+      for (std::size_t i = 0; i < attribute_coders_.size (); ++i)
       {
-        // encode averaged voxel color information
-        std::vector<char>& pointAvgColorDataVector = color_coder_.getAverageDataVector ();
-        point_avg_color_data_vector_size = pointAvgColorDataVector.size ();
-        compressed_tree_data_out_arg.write (reinterpret_cast<const char*> (&point_avg_color_data_vector_size),
-                                            sizeof (point_avg_color_data_vector_size));
-        compressed_color_data_len_ += entropy_coder_.encodeCharVectorToStream (pointAvgColorDataVector,
-                                                                               compressed_tree_data_out_arg);
+        data_vector_used.push_back (true);
+        data_vector_used.push_back (!do_voxel_grid_enDecoding_);
       }
 
-      if (!do_voxel_grid_enDecoding_)
+      // The data vectors are independent, so they are entropy coded in parallel, each by
+      // its own coder into its own buffer. The buffers are written in the usual order.
+      std::vector<std::uint64_t> data_vector_size (data_vector_count, 0);
+      std::vector<unsigned long> compressed_len (data_vector_count, 0);
+      std::vector<std::ostringstream> compressed_data (data_vector_count);
+
+#pragma omp parallel for schedule(dynamic, 1) num_threads(this->threads_)
+      for (int i = 0; i < data_vector_count; ++i)
       {
-        std::uint64_t pointCountDataVector_size;
-        std::uint64_t point_diff_data_vector_size;
-        std::uint64_t point_diff_color_data_vector_size;
+        if (!data_vector_used[i])
+          continue;
 
-        // encode amount of points per voxel
-        pointCountDataVector_size = point_count_data_vector_.size ();
-        compressed_tree_data_out_arg.write (reinterpret_cast<const char*> (&pointCountDataVector_size), sizeof (pointCountDataVector_size));
-        compressed_point_data_len_ += entropy_coder_.encodeIntVectorToStream (point_count_data_vector_,
-                                                                          compressed_tree_data_out_arg);
-
-        // encode differential point information
-        std::vector<char>& point_diff_data_vector = point_coder_.getDifferentialDataVector ();
-        point_diff_data_vector_size = point_diff_data_vector.size ();
-        compressed_tree_data_out_arg.write (reinterpret_cast<const char*> (&point_diff_data_vector_size), sizeof (point_diff_data_vector_size));
-        compressed_point_data_len_ += entropy_coder_.encodeCharVectorToStream (point_diff_data_vector,
-                                                                               compressed_tree_data_out_arg);
-        if (cloud_with_color_)
+        if (i == 2)
+          data_vector_size[i] = point_count_data_vector_.size ();
+        else
+          data_vector_size[i] = getCharDataVector (i).size ();
+
+        if (entropy_coder_type_ == EntropyCoder::INTERLEAVED_RANS)
         {
-          // encode differential color information
-          std::vector<char>& point_diff_color_data_vector = color_coder_.getDifferentialDataVector ();
-          point_diff_color_data_vector_size = point_diff_color_data_vector.size ();
-          compressed_tree_data_out_arg.write (reinterpret_cast<const char*> (&point_diff_color_data_vector_size),
-                                           sizeof (point_diff_color_data_vector_size));
-          compressed_color_data_len_ += entropy_coder_.encodeCharVectorToStream (point_diff_color_data_vector,
-                                                                                 compressed_tree_data_out_arg);
+          InterleavedRansCoder entropy_coder;
+          compressed_len[i] = entropyEncodeDataVector (i, entropy_coder, compressed_data[i]);
+        }
+        else
+        {
+          StaticRangeCoder entropy_coder;
+          compressed_len[i] = entropyEncodeDataVector (i, entropy_coder, compressed_data[i]);
         }
       }
+
+      compressed_point_data_len_ = 0;
+      compressed_color_data_len_ = 0;
+      compressed_attribute_data_len_ = 0;
+
+      for (int i = 0; i < data_vector_count; ++i)
+      {
+        if (!data_vector_used[i])
+          continue;
+
+        compressed_tree_data_out_arg.write (reinterpret_cast<const char*> (&data_vector_size[i]), sizeof (data_vector_size[i]));
+        const std::string data = compressed_data[i].str ();
+        compressed_tree_data_out_arg.write (data.data (), data.size ());
+
+        // account compressed data to point, color or attribute information
+        if (i >= 5)
+          compressed_attribute_data_len_ += compressed_len[i];
+        else if (i == 1 || i == 4)
+          compressed_color_data_len_ += compressed_len[i];
+        else
+          compressed_point_data_len_ += compressed_len[i];
+      }
+
       // flush output stream
       compressed_tree_data_out_arg.flush ();
     }
 
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template<typename PointT, typename LeafT, typename BranchT, typename OctreeT>
+    template<typename EntropyCoderT> unsigned long
+    OctreePointCloudCompression<PointT, LeafT, BranchT, OctreeT>::entropyEncodeDataVector (
+        int data_vector_idx, EntropyCoderT& entropy_coder_arg, std::ostream& compressed_data_out_arg)
+    {
+      if (data_vector_idx == 2)
+        return (entropy_coder_arg.encodeIntVectorToStream (point_count_data_vector_, compressed_data_out_arg));
+      return (entropy_coder_arg.encodeCharVectorToStream (getCharDataVector (data_vector_idx), compressed_data_out_arg));
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template<typename PointT, typename LeafT, typename BranchT, typename OctreeT> std::vector<char>&
+    OctreePointCloudCompression<PointT, LeafT, BranchT, OctreeT>::getCharDataVector (int data_vector_idx)
+    {
+      switch (data_vector_idx)
+      {
+        case 0:
+          return (binary_tree_data_vector_);
+        case 1:
+          return (color_coder_.getAverageDataVector ());
+        case 3:
+          return (point_coder_.getDifferentialDataVector ());
+        case 4:
+          return (color_coder_.getDifferentialDataVector ());
+      }
+
+      // averaged and differential data vectors of the point attributes
+      AttributeCoding<PointT>& attribute_coder = attribute_coders_[(data_vector_idx - 5) / 2];
+      if ((data_vector_idx - 5) % 2 == 0)
+        return (attribute_coder.getAverageDataVector ());
+      return (attribute_coder.getDifferentialDataVector ());
+    }
+
     //////////////////////////////////////////////////////////////////////////////////////////////
     template<typename PointT, typename LeafT, typename BranchT, typename OctreeT> void
     OctreePointCloudCompression<PointT, LeafT, BranchT, OctreeT>::entropyDecoding (std::istream& compressed_tree_data_in_arg)
+    {
+      if (frame_entropy_coder_type_ == EntropyCoder::INTERLEAVED_RANS)
+        entropyDecoding (compressed_tree_data_in_arg, rans_coder_);
+      else
+        entropyDecoding (compressed_tree_data_in_arg, entropy_coder_);
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template<typename PointT, typename LeafT, typename BranchT, typename OctreeT>
+    template<typename EntropyCoderT> void
+    OctreePointCloudCompression<PointT, LeafT, BranchT, OctreeT>::entropyDecoding (std::istream& compressed_tree_data_in_arg,
+                                                                                    EntropyCoderT& entropy_coder_arg)
     {
       std::uint64_t binary_tree_data_vector_size;
       std::uint64_t point_avg_color_data_vector_size;
@@ -322,8 +442,8 @@ namespace pcl
       // decode binary octree structure
       compressed_tree_data_in_arg.read (reinterpret_cast<char*> (&binary_tree_data_vector_size), sizeof (binary_tree_data_vector_size));
       binary_tree_data_vector_.resize (static_cast<std::size_t> (binary_tree_data_vector_size));
-      compressed_point_data_len_ += entropy_coder_.decodeStreamToCharVector (compressed_tree_data_in_arg,
-                                                                         binary_tree_data_vector_);
+      compressed_point_data_len_ += entropy_coder_arg.decodeStreamToCharVector (compressed_tree_data_in_arg,
+                                                                             binary_tree_data_vector_);
 
       if (data_with_color_)
       {
@@ -331,8 +451,8 @@ namespace pcl
         std::vector<char>& point_avg_color_data_vector = color_coder_.getAverageDataVector ();
         compressed_tree_data_in_arg.read (reinterpret_cast<char*> (&point_avg_color_data_vector_size), sizeof (point_avg_color_data_vector_size));
         point_avg_color_data_vector.resize (static_cast<std::size_t> (point_avg_color_data_vector_size));
-        compressed_color_data_len_ += entropy_coder_.decodeStreamToCharVector (compressed_tree_data_in_arg,
-                                                                           point_avg_color_data_vector);
+        compressed_color_data_len_ += entropy_coder_arg.decodeStreamToCharVector (compressed_tree_data_in_arg,
+                                                                               point_avg_color_data_vector);
       }
 
       if (!do_voxel_grid_enDecoding_)
@@ -344,15 +464,15 @@ namespace pcl
         // decode amount of points per voxel
         compressed_tree_data_in_arg.read (reinterpret_cast<char*> (&point_count_data_vector_size), sizeof (point_count_data_vector_size));
         point_count_data_vector_.resize (static_cast<std::size_t> (point_count_data_vector_size));
-        compressed_point_data_len_ += entropy_coder_.decodeStreamToIntVector (compressed_tree_data_in_arg, point_count_data_vector_);
+        compressed_point_data_len_ += entropy_coder_arg.decodeStreamToIntVector (compressed_tree_data_in_arg, point_count_data_vector_);
         point_count_data_vector_iterator_ = point_count_data_vector_.begin ();
 
         // decode differential point information
         std::vector<char>& pointDiffDataVector = point_coder_.getDifferentialDataVector ();
         compressed_tree_data_in_arg.read (reinterpret_cast<char*> (&point_diff_data_vector_size), sizeof (point_diff_data_vector_size));
         pointDiffDataVector.resize (static_cast<std::size_t> (point_diff_data_vector_size));
-        compressed_point_data_len_ += entropy_coder_.decodeStreamToCharVector (compressed_tree_data_in_arg,
-                                                                           pointDiffDataVector);
+        compressed_point_data_len_ += entropy_coder_arg.decodeStreamToCharVector (compressed_tree_data_in_arg,
+                                                                               pointDiffDataVector);
 
         if (data_with_color_)
         {
@@ -360,8 +480,27 @@ namespace pcl
           std::vector<char>& pointDiffColorDataVector = color_coder_.getDifferentialDataVector ();
           compressed_tree_data_in_arg.read (reinterpret_cast<char*> (&point_diff_color_data_vector_size), sizeof (point_diff_color_data_vector_size));
           pointDiffColorDataVector.resize (static_cast<std::size_t> (point_diff_color_data_vector_size));
-          compressed_color_data_len_ += entropy_coder_.decodeStreamToCharVector (compressed_tree_data_in_arg,
-                                                                             pointDiffColorDataVector);
+          compressed_color_data_len_ += entropy_coder_arg.decodeStreamToCharVector (compressed_tree_data_in_arg,
+                                                                                 pointDiffColorDataVector);
+        }
+      }
+
+      if (frame_with_attributes_)
+      {
+        compressed_attribute_data_len_ = 0;
+
+        // decode averaged and differential information of every point attribute
+        for (int i = 5; i < 5 + 2 * static_cast<int> (attribute_coders_.size ()); ++i)
+        {
+          if (do_voxel_grid_enDecoding_ && (i - 5) % 2 == 1)
+            continue;
+
+          std::uint64_t attribute_data_vector_size;
+          std::vector<char>& attribute_data_vector = getCharDataVector (i);
+          compressed_tree_data_in_arg.read (reinterpret_cast<char*> (&attribute_data_vector_size), sizeof (attribute_data_vector_size));
+          attribute_data_vector.resize (static_cast<std::size_t> (attribute_data_vector_size));
+          compressed_attribute_data_len_ += entropy_coder_arg.decodeStreamToCharVector (compressed_tree_data_in_arg,
+                                                                                        attribute_data_vector);
         }
       }
     }
@@ -370,8 +509,14 @@ namespace pcl
     template<typename PointT, typename LeafT, typename BranchT, typename OctreeT> void
     OctreePointCloudCompression<PointT, LeafT, BranchT, OctreeT>::writeFrameHeader (std::ostream& compressed_tree_data_out_arg)
     {
-      // encode header identifier
-      compressed_tree_data_out_arg.write (reinterpret_cast<const char*> (frame_header_identifier_), strlen (frame_header_identifier_));
+      // encode header identifier, its tags identify the entropy coder and additional point fields
+      std::string header_identifier (frame_header_identifier_, strlen (frame_header_identifier_) - 1);
+      if (entropy_coder_type_ == EntropyCoder::INTERLEAVED_RANS)
+        header_identifier += frame_header_rans_tag_;
+      if (!attribute_coders_.empty ())
+        header_identifier += frame_header_attribute_tag_;
+      header_identifier += '>';
+      compressed_tree_data_out_arg.write (header_identifier.data (), header_identifier.size ());
       // encode point cloud header id
       compressed_tree_data_out_arg.write (reinterpret_cast<const char*> (&frame_ID_), sizeof (frame_ID_));
       // encode frame type (I/P-frame)
@@ -410,6 +555,22 @@ namespace pcl
         compressed_tree_data_out_arg.write (reinterpret_cast<const char*> (&max_x), sizeof (max_x));
         compressed_tree_data_out_arg.write (reinterpret_cast<const char*> (&max_y), sizeof (max_y));
         compressed_tree_data_out_arg.write (reinterpret_cast<const char*> (&max_z), sizeof (max_z));
+
+        // encode names and quantization steps of additional point fields
+        if (!attribute_coders_.empty ())
+        {
+          const unsigned char attribute_count = static_cast<unsigned char> (attribute_coders_.size ());
+          compressed_tree_data_out_arg.write (reinterpret_cast<const char*> (&attribute_count), sizeof (attribute_count));
+          for (const AttributeCoding<PointT>& attribute_coder : attribute_coders_)
+          {
+            const std::string& field_name = attribute_coder.getFieldName ();
+            const unsigned char field_name_len = static_cast<unsigned char> (field_name.size ());
+            const double precision = attribute_coder.getPrecision ();
+            compressed_tree_data_out_arg.write (reinterpret_cast<const char*> (&field_name_len), sizeof (field_name_len));
+            compressed_tree_data_out_arg.write (field_name.data (), field_name_len);
+            compressed_tree_data_out_arg.write (reinterpret_cast<const char*> (&precision), sizeof (precision));
+          }
+        }
       }
     }
 
@@ -417,14 +578,38 @@ namespace pcl
     template<typename PointT, typename LeafT, typename BranchT, typename OctreeT> void
     OctreePointCloudCompression<PointT, LeafT, BranchT, OctreeT>::syncToHeader ( std::istream& compressed_tree_data_in_arg)
     {
-      // sync to frame header
-      unsigned int header_id_pos = 0;
-      while (header_id_pos < strlen (frame_header_identifier_))
+      // sync to frame header, all header identifiers start with "<PCL-OCT-COMPRESSED" and
+      // carry optional tags before the closing bracket
+      const unsigned int prefix_len = static_cast<unsigned int> (strlen (frame_header_identifier_)) - 1;
+      const std::size_t max_tags_len = strlen (frame_header_rans_tag_) + strlen (frame_header_attribute_tag_);
+      while (true)
       {
-        char readChar;
-        compressed_tree_data_in_arg.read (static_cast<char*> (&readChar), sizeof (readChar));
-        if (readChar != frame_header_identifier_[header_id_pos++])
-          header_id_pos = (frame_header_identifier_[0]==readChar)?1:0;
+        unsigned int header_id_pos = 0;
+        while (header_id_pos < prefix_len)
+        {
+          char readChar;
+          compressed_tree_data_in_arg.read (static_cast<char*> (&readChar), sizeof (readChar));
+          if (readChar != frame_header_identifier_[header_id_pos++])
+            header_id_pos = (frame_header_identifier_[0]==readChar)?1:0;
+        }
+
+        // read tags up to the closing bracket
+        std::string tags;
+        char readChar = '\0';
+        while (tags.size () <= max_tags_len && compressed_tree_data_in_arg.read (&readChar, sizeof (readChar)) && readChar != '>')
+          tags += readChar;
+        if (readChar != '>')
+          continue;
+
+        // the tags select the entropy coder and additional point fields, in this order
+        const bool with_rans = (tags.compare (0, strlen (frame_header_rans_tag_), frame_header_rans_tag_) == 0);
+        const std::string attribute_tags = tags.substr (with_rans ? strlen (frame_header_rans_tag_) : 0);
+        if (!attribute_tags.empty () && attribute_tags != frame_header_attribute_tag_)
+          continue;
+
+        frame_entropy_coder_type_ = with_rans ? EntropyCoder::INTERLEAVED_RANS : EntropyCoder::STATIC_RANGE;
+        frame_with_attributes_ = !attribute_tags.empty ();
+        return;
       }
     }
 
@@ -466,6 +651,29 @@ namespace pcl
         // configure color & point coding
         color_coder_.setBitDepth (color_bit_depth);
         point_coder_.setPrecision (static_cast<float> (point_resolution));
+
+        if (frame_with_attributes_)
+        {
+          // read additional point fields and locate them within the point type
+          unsigned char attribute_count = 0;
+          compressed_tree_data_in_arg.read (reinterpret_cast<char*> (&attribute_count), sizeof (attribute_count));
+          attribute_coders_.clear ();
+          for (unsigned char i = 0; i < attribute_count; ++i)
+          {
+            unsigned char field_name_len = 0;
+            double precision;
+            compressed_tree_data_in_arg.read (reinterpret_cast<char*> (&field_name_len), sizeof (field_name_len));
+            std::string field_name (field_name_len, '\0');
+            compressed_tree_data_in_arg.read (&field_name[0], field_name_len);
+            compressed_tree_data_in_arg.read (reinterpret_cast<char*> (&precision), sizeof (precision));
+
+            attribute_coders_.emplace_back (field_name, precision);
+            std::vector<pcl::PCLPointField> fields;
+            const int field_index = pcl::getFieldIndex<PointT> (field_name, fields);
+            if (field_index >= 0)
+              attribute_coders_.back ().setField (fields[field_index]);
+          }
+        }
       }
     }
 
@@ -502,6 +710,10 @@ namespace pcl
           // encode average color of all points within voxel
           color_coder_.encodeAverageOfPoints (leafIdx, point_color_offset_, this->input_);
       }
+
+      // encode additional point fields
+      for (AttributeCoding<PointT>& attribute_coder : attribute_coders_)
+        attribute_coder.encodePoints (leafIdx, this->input_, do_voxel_grid_enDecoding_);
     }
 
     //////////////////////////////////////////////////////////////////////////////////////////////
@@ -557,6 +769,12 @@ namespace pcl
           color_coder_.setDefaultColor (output_, output_->size () - pointCount,
                                        output_->size (), point_color_offset_);
       }
+
+      // decode additional point fields
+      if (frame_with_attributes_)
+        for (AttributeCoding<PointT>& attribute_coder : attribute_coders_)
+          attribute_coder.decodePoints (output_, output_->size () - pointCount,
+                                        output_->size (), do_voxel_grid_enDecoding_);
     }
   }
 }
@@ -0,0 +1,246 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#pragma once
+
+#include <pcl/compression/octree_pointcloud_compression.h>
+#include <pcl/point_cloud.h>
+
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+namespace pcl
+{
+  namespace io
+  {
+    /** \brief Index entry of a frame stored in a compressed point cloud archive. */
+    struct OctreeCompressionFrameInfo
+    {
+      /** \brief Position of the compressed frame, relative to the start of the archive. */
+      std::uint64_t offset;
+      /** \brief Size of the compressed frame in bytes, zero for empty point clouds. */
+      std::uint64_t size;
+      /** \brief Time stamp of the point cloud header. */
+      std::uint64_t stamp;
+      /** \brief Amount of points of the encoded point cloud. */
+      std::uint64_t point_count;
+      /** \brief The frame is an I-frame and can be decoded without its preceding frames. */
+      bool key_frame;
+    };
+
+    /** \brief @b OctreeCompressionArchiveWriter stores frames of an OctreePointCloudCompression
+      * encoder in a seekable archive.
+      *
+      * The archive holds the compressed frames, followed by an index with the position, time
+      * stamp, point count and frame type of every frame. The index is written by \ref close.
+      * Random access granularity is given by the I-frame rate of the encoder.
+      * \note typename: PointT: type of point used in pointcloud
+      * \ingroup io
+      */
+    template <typename PointT>
+    class OctreeCompressionArchiveWriter
+    {
+      public:
+        using PointCloud = pcl::PointCloud<PointT>;
+        using PointCloudConstPtr = typename PointCloud::ConstPtr;
+        using Encoder = OctreePointCloudCompression<PointT>;
+
+        /** \brief Constructor, writes the archive header.
+          * \param[in] archive_out_arg binary output stream, must stay valid until \ref close
+          * \param[in] encoder_arg configured point cloud encoder
+          */
+        OctreeCompressionArchiveWriter (std::ostream& archive_out_arg, Encoder& encoder_arg);
+
+        /** \brief Destructor, closes the archive. */
+        ~OctreeCompressionArchiveWriter ();
+
+        /** \brief Encode a point cloud and append it to the archive.
+          * \param[in] cloud_arg point cloud to be compressed
+          */
+        void
+        writeFrame (const PointCloudConstPtr& cloud_arg);
+
+        /** \brief Write the frame index, no frames can be added afterwards. */
+        void
+        close ();
+
+        /** \brief Get the amount of frames written so far. */
+        inline std::size_t
+        getFrameCount () const
+        {
+          return (frames_.size ());
+        }
+
+      protected:
+        /** \brief Archive output stream. */
+        std::ostream& archive_out_;
+
+        /** \brief Point cloud encoder. */
+        Encoder& encoder_;
+
+        /** \brief Index entries of all frames written. */
+        std::vector<OctreeCompressionFrameInfo> frames_;
+
+        /** \brief Amount of bytes written to the archive. */
+        std::uint64_t archive_size_;
+
+        /** \brief The frame index has been written. */
+        bool closed_;
+    };
+
+    /** \brief @b OctreeCompressionArchiveReader decodes frames of an archive written by
+      * OctreeCompressionArchiveWriter in any order.
+      *
+      * A frame is decoded starting from the last I-frame at or before it. Consecutive reads
+      * continue from the previously decoded frame, so sequential playback decodes every frame
+      * once. \ref readFrames decodes the groups of frames between I-frames in parallel.
+      * \note typename: PointT: type of point used in pointcloud
+      * \ingroup io
+      */
+    template <typename PointT>
+    class OctreeCompressionArchiveReader
+    {
+      public:
+        using PointCloud = pcl::PointCloud<PointT>;
+        using PointCloudPtr = typename PointCloud::Ptr;
+        using Decoder = OctreePointCloudCompression<PointT>;
+
+        /** \brief Empty constructor. */
+        OctreeCompressionArchiveReader ();
+
+        /** \brief Open an archive and read its frame index.
+          * \param[in] archive_in_arg seekable binary input stream positioned at the start of the
+          * archive, must stay valid while frames are read
+          * \return true on success, false if the stream holds no valid archive
+          */
+        bool
+        open (std::istream& archive_in_arg);
+
+        /** \brief Get the amount of frames in the archive. */
+        inline std::size_t
+        getFrameCount () const
+        {
+          return (frames_.size ());
+        }
+
+        /** \brief Get the index entry of a frame.
+          * \param[in] frame_idx index of the frame
+          */
+        inline const OctreeCompressionFrameInfo&
+        getFrameInfo (std::size_t frame_idx) const
+        {
+          return (frames_[frame_idx]);
+        }
+
+        /** \brief Get the indices of all I-frames, in increasing order. */
+        inline const std::vector<std::size_t>&
+        getKeyFrames () const
+        {
+          return (key_frames_);
+        }
+
+        /** \brief Get the index of the I-frame decoding of a frame has to start from.
+          * \param[in] frame_idx index of the frame
+          */
+        std::size_t
+        getKeyFrame (std::size_t frame_idx) const;
+
+        /** \brief Decode a single frame.
+          * \param[in] frame_idx index of the frame
+          * \param[out] cloud_arg decoded point cloud
+          * \return true on success
+          */
+        bool
+        readFrame (std::size_t frame_idx, PointCloudPtr& cloud_arg);
+
+        /** \brief Decode a range of frames, see \ref setNumberOfThreads.
+          * \param[in] first_frame_idx index of the first frame
+          * \param[in] last_frame_idx index of the last frame
+          * \param[out] clouds_arg decoded point clouds, one per frame of the range
+          * \return true on success
+          */
+        bool
+        readFrames (std::size_t first_frame_idx, std::size_t last_frame_idx,
+                    std::vector<PointCloudPtr>& clouds_arg);
+
+        /** \brief Set the number of threads used by \ref readFrames (default: 1).
+          * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+          */
+        void
+        setNumberOfThreads (unsigned int nr_threads = 0);
+
+      protected:
+        /** \brief Read the compressed data of a frame from the archive.
+          * \param[in] frame_idx index of the frame
+          * \param[out] data_arg compressed frame data
+          * \return true on success
+          */
+        bool
+        readFrameData (std::size_t frame_idx, std::string& data_arg);
+
+        /** \brief Decode a frame with a decoder that decoded the preceding frame.
+          * \param[in] decoder_arg point cloud decoder
+          * \param[in] data_arg compressed frame data
+          * \param[out] cloud_arg decoded point cloud
+          */
+        static void
+        decodeFrame (Decoder& decoder_arg, const std::string& data_arg, PointCloudPtr& cloud_arg);
+
+        /** \brief Archive input stream. */
+        std::istream* archive_in_;
+
+        /** \brief Position of the archive within the input stream. */
+        std::streamoff archive_begin_;
+
+        /** \brief Index entries of all frames. */
+        std::vector<OctreeCompressionFrameInfo> frames_;
+
+        /** \brief Indices of all I-frames. */
+        std::vector<std::size_t> key_frames_;
+
+        /** \brief Decoder used by \ref readFrame. */
+        Decoder decoder_;
+
+        /** \brief Index of the last frame decoded by decoder_, -1 if none. */
+        std::ptrdiff_t decoded_frame_idx_;
+
+        /** \brief The number of threads used by \ref readFrames. */
+        unsigned int threads_;
+    };
+  }
+}
@@ -42,6 +42,7 @@
 #include <pcl/octree/octree2buf_base.h>
 #include <pcl/octree/octree_pointcloud.h>
 #include "entropy_range_coder.h"
+#include "attribute_coding.h"
 #include "color_coding.h"
 #include "point_coding.h"
 
@@ -51,6 +52,7 @@
 #include <cstring>
 #include <iostream>
 #include <iterator>
+#include <string>
 #include <vector>
 
 using namespace pcl::octree;
@@ -59,6 +61,15 @@ namespace pcl
 {
   namespace io
   {
+    /** \brief Entropy coder applied to the data vectors of a compressed frame. */
+    enum class EntropyCoder
+    {
+      /** \brief StaticRangeCoder, compatible with all PCL versions. */
+      STATIC_RANGE,
+      /** \brief InterleavedRansCoder, faster to encode and decode. */
+      INTERLEAVED_RANS
+    };
+
     /** \brief @b Octree pointcloud compression class
      *  \note This class enables compression and decompression of point cloud data based on octree data structures.
      *  \note
@@ -117,7 +128,9 @@ namespace pcl
           compressed_point_data_len_ (), compressed_color_data_len_ (), selected_profile_(compressionProfile_arg),
           point_resolution_(pointResolution_arg), octree_resolution_(octreeResolution_arg),
           color_bit_resolution_(colorBitResolution_arg),
-          object_count_(0)
+          object_count_(0), entropy_coder_type_ (EntropyCoder::STATIC_RANGE),
+          frame_entropy_coder_type_ (EntropyCoder::STATIC_RANGE), attributes_changed_ (false),
+          frame_with_attributes_ (false), compressed_attribute_data_len_ (), last_frame_i_frame_ (false)
         {
           initialization();
         }
@@ -169,6 +182,17 @@ namespace pcl
           OctreePointCloud<PointT, LeafT, BranchT, OctreeT>::addPointIdx(pointIdx_arg);
         }
 
+        /** \brief Add point at index from input pointcloud dataset to an existing leaf container
+         * \param[in] leaf_arg the leaf container of the voxel the point falls into
+         * \param[in] pointIdx_arg the index representing the point in the dataset given by \a setInputCloud to be added
+         */
+        void
+        addPointIdxToLeaf (LeafT& leaf_arg, const int pointIdx_arg) override
+        {
+          ++object_count_;
+          OctreePointCloud<PointT, LeafT, BranchT, OctreeT>::addPointIdxToLeaf(leaf_arg, pointIdx_arg);
+        }
+
         /** \brief Provide a pointer to the output data set.
           * \param cloud_arg: the boost shared pointer to a PointCloud message
           */
@@ -190,6 +214,47 @@ namespace pcl
           return (output_);
         }
 
+        /** \brief Check whether the last encoded or decoded frame is an I-frame, which can be
+          * decoded without the preceding frames.
+          */
+        inline bool
+        isLastFrameIFrame () const
+        {
+          return (last_frame_i_frame_);
+        }
+
+        /** \brief Select the entropy coder used when encoding frames.
+          * \note The decoder detects the entropy coder of each frame from its header.
+          * \param[in] entropy_coder_arg: entropy coder (default: EntropyCoder::STATIC_RANGE)
+          */
+        inline void
+        setEntropyCoder (EntropyCoder entropy_coder_arg)
+        {
+          entropy_coder_type_ = entropy_coder_arg;
+        }
+
+        /** \brief Get the entropy coder used when encoding frames. */
+        inline EntropyCoder
+        getEntropyCoder () const
+        {
+          return (entropy_coder_type_);
+        }
+
+        /** \brief Encode an additional scalar point field, e.g. intensity, ring or a normal component.
+          * \note Changing the encoded fields enforces an I-frame. The decoder restores the fields
+          * \note that its point type provides.
+          * \param[in] field_name_arg: name of the point field
+          * \param[in] precision_arg: quantization step of the field values. If not positive, the
+          * step defined in attributeProfiles_ is used, or 1.0 for fields without profile.
+          * \return false if PointT does not provide the field
+          */
+        bool
+        addAttributeEncoding (const std::string& field_name_arg, double precision_arg = 0.0);
+
+        /** \brief Stop encoding additional point fields. */
+        void
+        clearAttributeEncoding ();
+
         /** \brief Encode point cloud to output stream
           * \param cloud_arg:  point cloud to be compressed
           * \param compressed_tree_data_out_arg:  binary output stream containing compressed data
@@ -218,24 +283,49 @@ namespace pcl
         void
         readFrameHeader (std::istream& compressed_tree_data_in_arg);
 
-        /** \brief Synchronize to frame header
+        /** \brief Synchronize to frame header and detect the entropy coder of the frame
           * \param compressed_tree_data_in_arg: binary input stream
           */
         void
         syncToHeader (std::istream& compressed_tree_data_in_arg);
 
         /** \brief Apply entropy encoding to encoded information and output to binary stream
+          * \note The data vectors are entropy coded in parallel, using the number of threads
+          * given by setNumberOfThreads.
           * \param compressed_tree_data_out_arg: binary output stream
           */
         void
         entropyEncoding (std::ostream& compressed_tree_data_out_arg);
 
+        /** \brief Entropy encode one of the data vectors of a frame
+          * \param data_vector_idx: index of the data vector in the order of the stream
+          * \param entropy_coder_arg: entropy coder instance
+          * \param compressed_data_out_arg: binary output stream
+          * \return amount of bytes written to output stream
+          */
+        template <typename EntropyCoderT> unsigned long
+        entropyEncodeDataVector (int data_vector_idx, EntropyCoderT& entropy_coder_arg, std::ostream& compressed_data_out_arg);
+
         /** \brief Entropy decoding of input binary stream and output to information vectors
           * \param compressed_tree_data_in_arg: binary input stream
           */
         void
         entropyDecoding (std::istream& compressed_tree_data_in_arg);
 
+        /** \brief Entropy decoding of input binary stream with the given entropy coder
+          * \param compressed_tree_data_in_arg: binary input stream
+          * \param entropy_coder_arg: entropy coder instance
+          */
+        template <typename EntropyCoderT> void
+        entropyDecoding (std::istream& compressed_tree_data_in_arg, EntropyCoderT& entropy_coder_arg);
+
+        /** \brief Get a character data vector of a frame
+          * \param data_vector_idx: index of the data vector in the order of the stream, the amount
+          * of points per voxel (index 2) is no character data vector
+          */
+        std::vector<char>&
+        getCharDataVector (int data_vector_idx);
+
         /** \brief Encode leaf node information during serialization
           * \param leaf_arg: reference to new leaf node
           * \param key_arg: octree key of new leaf node
@@ -272,9 +362,15 @@ namespace pcl
         /** \brief Point coding instance */
         PointCoding<PointT> point_coder_;
 
+        /** \brief Attribute coding instances, one per additional point field */
+        std::vector<AttributeCoding<PointT> > attribute_coders_;
+
         /** \brief Static range coder instance */
         StaticRangeCoder entropy_coder_;
 
+        /** \brief Interleaved rANS coder instance */
+        InterleavedRansCoder rans_coder_;
+
         bool do_voxel_grid_enDecoding_;
         std::uint32_t i_frame_rate_;
         std::uint32_t i_frame_counter_;
@@ -295,6 +391,11 @@ namespace pcl
         // frame header identifier
         static const char* frame_header_identifier_;
 
+        // frame header identifier tags of frames coded with the interleaved rANS coder and
+        // of frames with additional point fields
+        static const char* frame_header_rans_tag_;
+        static const char* frame_header_attribute_tag_;
+
         const compression_Profiles_e selected_profile_;
         const double point_resolution_;
         const double octree_resolution_;
@@ -302,11 +403,35 @@ namespace pcl
 
         std::size_t object_count_;
 
+        /** \brief Entropy coder used for encoding */
+        EntropyCoder entropy_coder_type_;
+
+        /** \brief Entropy coder of the frame being decoded */
+        EntropyCoder frame_entropy_coder_type_;
+
+        /** \brief Encoded point fields changed since the last I-frame */
+        bool attributes_changed_;
+
+        /** \brief Frame being decoded contains additional point fields */
+        bool frame_with_attributes_;
+
+        std::uint64_t compressed_attribute_data_len_;
+
+        /** \brief Frame type of the last encoded or decoded frame */
+        bool last_frame_i_frame_;
+
       };
 
     // define frame identifier
     template<typename PointT, typename LeafT, typename BranchT, typename OctreeT>
       const char* OctreePointCloudCompression<PointT, LeafT, BranchT, OctreeT>::frame_header_identifier_ = "<PCL-OCT-COMPRESSED>";
+
+    // define frame identifier tags, appended in this order before the closing bracket
+    template<typename PointT, typename LeafT, typename BranchT, typename OctreeT>
+      const char* OctreePointCloudCompression<PointT, LeafT, BranchT, OctreeT>::frame_header_rans_tag_ = "-RANS";
+
+    template<typename PointT, typename LeafT, typename BranchT, typename OctreeT>
+      const char* OctreePointCloudCompression<PointT, LeafT, BranchT, OctreeT>::frame_header_attribute_tag_ = "-ATTR";
   }
 
 }
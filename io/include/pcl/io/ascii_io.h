@@ -140,11 +140,27 @@ namespace pcl
       void 
       setExtension (const std::string &ext) { extension_ = ext; }
 
+      /** \brief Set the number of threads used to parse the lines of the file (default: 1).
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      void
+      setNumberOfThreads (unsigned int nr_threads = 0);
+
     protected:
       std::string sep_chars_;
       std::string extension_;
       std::vector<pcl::PCLPointField> fields_;
       std::string name_;
+      unsigned int threads_;
+
+      /** \brief Parses the tokens of a line into a point.
+        * \param[in] begin the first character of the line
+        * \param[in] end one past the last character of the line
+        * \param[out] data_target address that the point should be written to
+        *  returns false if the line is empty, a comment, or does not hold a valid point
+        */
+      bool
+      parseLine (const char *begin, const char *end, std::uint8_t *data_target);
 
 
       /** \brief Parses token based on field type.
@@ -0,0 +1,296 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved
+ */
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace pcl
+{
+  namespace io
+  {
+    namespace detail
+    {
+      /** \brief Parse the sign, digits, decimal point and exponent of a plain decimal number.
+        * \return false if [begin, end) is not such a number, or has more significant digits than
+        * fit in 64 bits
+        */
+      inline bool
+      parseDecimal (const char *begin, const char *end, bool &negative, std::uint64_t &mantissa,
+                    int &exponent)
+      {
+        const char *p = begin;
+        negative = false;
+        if (p != end && (*p == '-' || *p == '+'))
+          negative = (*p++ == '-');
+
+        mantissa = 0;
+        exponent = 0;
+        int nr_digits = 0, nr_significant = 0;
+        for (; p != end && *p >= '0' && *p <= '9'; ++p, ++nr_digits)
+        {
+          if (mantissa == 0 && *p == '0')
+            continue;
+          if (++nr_significant > 19)
+            return (false);
+          mantissa = mantissa * 10 + static_cast<std::uint64_t> (*p - '0');
+        }
+        if (p != end && *p == '.')
+        {
+          for (++p; p != end && *p >= '0' && *p <= '9'; ++p, ++nr_digits)
+          {
+            --exponent;
+            if (mantissa == 0 && *p == '0')
+              continue;
+            if (++nr_significant > 19)
+              return (false);
+            mantissa = mantissa * 10 + static_cast<std::uint64_t> (*p - '0');
+          }
+        }
+        if (nr_digits == 0)
+          return (false);
+
+        if (p != end && (*p == 'e' || *p == 'E'))
+        {
+          ++p;
+          bool negative_exponent = false;
+          if (p != end && (*p == '-' || *p == '+'))
+            negative_exponent = (*p++ == '-');
+          if (p == end)
+            return (false);
+          int exp = 0;
+          for (; p != end && *p >= '0' && *p <= '9'; ++p)
+          {
+            if (exp > 10000)
+              return (false);
+            exp = exp * 10 + (*p - '0');
+          }
+          exponent += negative_exponent ? -exp : exp;
+        }
+        return (p == end);
+      }
+
+      /** \brief Convert a decimal number to the nearest double, if this can be done exactly with a
+        * single multiplication or division (the mantissa and the power of ten are both exact doubles).
+        */
+      inline bool
+      decimalToDouble (bool negative, std::uint64_t mantissa, int exponent, double &value)
+      {
+        static const double powers_of_ten[] = {
+          1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+          1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+        if (mantissa > (std::uint64_t (1) << 53))
+          return (false);
+        if (mantissa == 0)
+          exponent = 0;
+        if (exponent < -22 || exponent > 22)
+          return (false);
+
+        value = static_cast<double> (mantissa);
+        if (exponent < 0)
+          value /= powers_of_ten[-exponent];
+        else
+          value *= powers_of_ten[exponent];
+        if (negative)
+          value = -value;
+        return (true);
+      }
+    }
+
+    /** \brief Convert a plain decimal number (e.g. "-1.25e-3") or "nan" to a floating point value.
+      *
+      * This is much faster than the stream and string conversion functions, and independent of the
+      * global locale. The result is the correctly rounded value, the same as the one of the standard
+      * conversions. Tokens which would need extended precision arithmetic to be converted exactly
+      * (many significant digits, very large or small exponents, values out of the range of \a T) are
+      * rejected, they have to be converted with the standard functions instead.
+      *
+      * \param[in] begin the first character of the token
+      * \param[in] end one past the last character of the token
+      * \param[out] value the converted value
+      * \return false if the token could not be converted
+      */
+    template <typename T> inline typename std::enable_if<std::is_floating_point<T>::value, bool>::type
+    parseNumber (const char *begin, const char *end, T &value)
+    {
+      if (end - begin == 3 && (begin[0] | 0x20) == 'n' && (begin[1] | 0x20) == 'a' && (begin[2] | 0x20) == 'n')
+      {
+        value = std::numeric_limits<T>::quiet_NaN ();
+        return (true);
+      }
+
+      bool negative;
+      std::uint64_t mantissa;
+      int exponent;
+      double result;
+      if (!detail::parseDecimal (begin, end, negative, mantissa, exponent) ||
+          !detail::decimalToDouble (negative, mantissa, exponent, result))
+        return (false);
+
+      if (sizeof (T) < sizeof (double))
+      {
+        // Rounding the correctly rounded double to T gives the correctly rounded T, unless the double
+        // lies exactly half way between two values of T (or is out of the normal range of T)
+        const double magnitude = std::abs (result);
+        if (magnitude != 0.0 && (magnitude < static_cast<double> (std::numeric_limits<T>::min ()) ||
+                                 magnitude > static_cast<double> (std::numeric_limits<T>::max ())))
+          return (false);
+        std::uint64_t bits;
+        memcpy (&bits, &result, sizeof (double));
+        const int dropped_bits = std::numeric_limits<double>::digits - std::numeric_limits<T>::digits;
+        const std::uint64_t dropped_mask = (std::uint64_t (1) << dropped_bits) - 1;
+        if ((bits & dropped_mask) == (std::uint64_t (1) << (dropped_bits - 1)))
+          return (false);
+      }
+      value = static_cast<T> (result);
+      return (true);
+    }
+
+    /** \brief Convert a decimal integer (e.g. "-42") to an integral value.
+      *
+      * Tokens with a fractional part, values out of the range of \a T and negative values for unsigned
+      * types are rejected, and have to be converted with the standard functions instead.
+      *
+      * \param[in] begin the first character of the token
+      * \param[in] end one past the last character of the token
+      * \param[out] value the converted value
+      * \return false if the token could not be converted
+      */
+    template <typename T> inline typename std::enable_if<std::is_integral<T>::value, bool>::type
+    parseNumber (const char *begin, const char *end, T &value)
+    {
+      const char *p = begin;
+      bool negative = false;
+      if (p != end && (*p == '-' || *p == '+'))
+        negative = (*p++ == '-');
+      if (p == end || end - p > 18 || (negative && std::is_unsigned<T>::value))
+        return (false);
+
+      std::int64_t result = 0;
+      for (; p != end; ++p)
+      {
+        if (*p < '0' || *p > '9')
+          return (false);
+        result = result * 10 + (*p - '0');
+      }
+      if (negative)
+        result = -result;
+      if (result < static_cast<std::int64_t> (std::numeric_limits<T>::min ()) ||
+          result > static_cast<std::int64_t> (std::numeric_limits<T>::max ()))
+        return (false);
+      value = static_cast<T> (result);
+      return (true);
+    }
+
+    /** \brief Read a text stream by large blocks of whole lines, instead of line by line.
+      *
+      * Every call to \ref readBlock reads about \a block_size bytes and splits them into lines, which
+      * then stay valid until the next call. This avoids the per line overhead of std::getline and lets
+      * the lines of a block be parsed in parallel.
+      */
+    class LineBlockReader
+    {
+      public:
+        /** \brief Constructor.
+          * \param[in] stream the stream to read from, from its current position
+          * \param[in] block_size the number of bytes to read at once
+          */
+        LineBlockReader (std::istream &stream, std::size_t block_size = 16 * 1024 * 1024)
+          : stream_ (stream), block_size_ (block_size), begin_ (0), end_ (0)
+        {
+        }
+
+        /** \brief Read the next lines.
+          * \param[out] lines the begin (and end, in the following element) of each line read: line i spans
+          * [lines[i], lines[i + 1] - 1), its end of line character is excluded
+          * \return false once the end of the stream is reached and no line is left
+          */
+        inline bool
+        readBlock (std::vector<const char*> &lines)
+        {
+          lines.clear ();
+
+          // Keep the incomplete last line of the previous block
+          buffer_.erase (buffer_.begin (), buffer_.begin () + begin_);
+          end_ -= begin_;
+          begin_ = 0;
+
+          // Read until there is at least one complete line, or the end of the stream
+          std::size_t last_newline = std::string::npos;
+          while (stream_.good ())
+          {
+            const std::size_t previous_size = buffer_.size ();
+            buffer_.resize (previous_size + block_size_);
+            stream_.read (&buffer_[previous_size], static_cast<std::streamsize> (block_size_));
+            buffer_.resize (previous_size + static_cast<std::size_t> (stream_.gcount ()));
+            end_ = buffer_.size ();
+            const void *newline = findLastNewline (&buffer_[0] + previous_size, end_ - previous_size);
+            if (newline)
+            {
+              last_newline = static_cast<const char*> (newline) - &buffer_[0];
+              break;
+            }
+          }
+          if (end_ == 0)
+            return (false);
+
+          // At the end of the stream the last line does not need an end of line character
+          std::size_t block_end = last_newline + 1;
+          if (last_newline == std::string::npos)
+          {
+            buffer_.push_back ('\n');
+            block_end = buffer_.size ();
+          }
+
+          const char *data = &buffer_[0];
+          lines.push_back (data);
+          for (const char *p = data; (p = static_cast<const char*> (memchr (p, '\n', data + block_end - p))) != nullptr; )
+            lines.push_back (++p);
+          begin_ = block_end;
+          end_ = buffer_.size ();
+          return (true);
+        }
+
+        /** \brief Give the read but unused bytes back to the stream, if it can seek. */
+        inline void
+        putBack ()
+        {
+          const std::size_t unused = end_ - begin_;
+          if (unused == 0)
+            return;
+          stream_.clear ();
+          stream_.seekg (-static_cast<std::streamoff> (unused), std::ios::cur);
+          begin_ = end_ = 0;
+          buffer_.clear ();
+        }
+
+      private:
+        static inline const void*
+        findLastNewline (const char *data, std::size_t size)
+        {
+          for (const char *p = data + size; p != data; )
+            if (*--p == '\n')
+              return (p);
+          return (nullptr);
+        }
+
+        std::istream &stream_;
+        std::size_t block_size_;
+        std::vector<char> buffer_;
+        std::size_t begin_, end_;
+    };
+  }
+}
@@ -0,0 +1,149 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved
+ */
+
+#pragma once
+
+#include <pcl/pcl_macros.h>
+#include <pcl/PCLPointCloud2.h>
+
+#include <Eigen/Geometry>
+
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace pcl
+{
+  namespace io
+  {
+    /** \brief Load point cloud files in the background, with a pool of I/O threads.
+      *
+      * Every call to \ref load queues a file and returns immediately with a future, which becomes ready
+      * once the file is read (and decompressed and parsed). While the caller processes a cloud, the
+      * following files are already being loaded, so that reading, decompressing and parsing many files
+      * is spread over several cores instead of being serialized with the processing.
+      *
+      * The number of queued files which are not being loaded yet is bounded: \ref load blocks while the
+      * queue is full. The clouds themselves are owned by the caller, who therefore controls how many
+      * loaded clouds are kept in memory, e.g. by never having more than a few futures pending:
+      *
+      * \code
+      * pcl::io::AsyncLoader loader (4);
+      * std::vector<pcl::PCLPointCloud2> clouds (file_names.size ());
+      * std::deque<std::future<int>> pending;
+      * std::size_t next = 0;
+      * for (std::size_t i = 0; i < file_names.size (); ++i)
+      * {
+      *   for (; next < file_names.size () && next < i + 8; ++next)
+      *     pending.push_back (loader.load (file_names[next], clouds[next]));
+      *   if (pending.front ().get () == 0)
+      *     process (clouds[i]);
+      *   pending.pop_front ();
+      * }
+      * \endcode
+      *
+      * PCD and PLY files are read with pcl::PCDReader and pcl::PLYReader, the other formats with
+      * pcl::io::load.
+      *
+      * \ingroup io
+      */
+    class PCL_EXPORTS AsyncLoader
+    {
+      public:
+        /** \brief Start the I/O threads.
+          * \param[in] nr_threads the number of files loaded concurrently (0 to use as many as there are
+          * hardware threads)
+          * \param[in] queue_size the maximum number of files waiting to be loaded
+          */
+        AsyncLoader (unsigned int nr_threads = 2, std::size_t queue_size = 16);
+
+        AsyncLoader (const AsyncLoader&) = delete;
+        AsyncLoader&
+        operator = (const AsyncLoader&) = delete;
+
+        /** \brief Load the files still queued, then stop the I/O threads. */
+        ~AsyncLoader ();
+
+        /** \brief Queue a file for loading, blocking while the queue is full.
+          * \param[in] file_name the name of the file to load
+          * \param[out] cloud the resultant cloud, which must not be accessed before the future is ready
+          * \param[out] origin the sensor acquisition origin (null if not stored in the file)
+          * \param[out] orientation the sensor acquisition orientation (identity if not stored in the file)
+          * \return a future holding the result of the reader (< 0 on error, 0 on success)
+          */
+        std::future<int>
+        load (const std::string &file_name, pcl::PCLPointCloud2 &cloud,
+              Eigen::Vector4f &origin, Eigen::Quaternionf &orientation);
+
+        /** \brief Queue a file for loading, blocking while the queue is full.
+          * \param[in] file_name the name of the file to load
+          * \param[out] cloud the resultant cloud, which must not be accessed before the future is ready
+          * \return a future holding the result of the reader (< 0 on error, 0 on success)
+          */
+        std::future<int>
+        load (const std::string &file_name, pcl::PCLPointCloud2 &cloud);
+
+        /** \brief Queue a PCD file for loading, whose header starts at a given offset (e.g. a PCD file
+          * stored inside a TAR archive), blocking while the queue is full.
+          * \param[in] file_name the name of the file to load
+          * \param[in] offset the offset of the PCD header in the file
+          * \param[out] cloud the resultant cloud, which must not be accessed before the future is ready
+          * \param[out] origin the sensor acquisition origin (null if not stored in the file)
+          * \param[out] orientation the sensor acquisition orientation (identity if not stored in the file)
+          * \return a future holding the result of the reader (< 0 on error, 0 on success)
+          */
+        std::future<int>
+        loadPCD (const std::string &file_name, int offset, pcl::PCLPointCloud2 &cloud,
+                 Eigen::Vector4f &origin, Eigen::Quaternionf &orientation);
+
+        /** \brief Get the number of I/O threads. */
+        inline unsigned int
+        getNumberOfThreads () const
+        {
+          return (static_cast<unsigned int> (threads_.size ()));
+        }
+
+        /** \brief Get the maximum number of files waiting to be loaded. */
+        inline std::size_t
+        getQueueSize () const
+        {
+          return (queue_size_);
+        }
+
+      private:
+        /** \brief Read a file with the reader matching its extension. */
+        static int
+        loadFile (const std::string &file_name, pcl::PCLPointCloud2 &cloud,
+                  Eigen::Vector4f &origin, Eigen::Quaternionf &orientation);
+
+        /** \brief Queue a task, blocking while the queue is full. */
+        std::future<int>
+        enqueue (std::packaged_task<int ()> &&task);
+
+        /** \brief The loop of the I/O threads. */
+        void
+        run ();
+
+        std::vector<std::thread> threads_;
+
+        /** \brief The files waiting to be loaded, bounded by \a queue_size_. */
+        std::deque<std::packaged_task<int ()> > queue_;
+        std::size_t queue_size_;
+
+        std::mutex mutex_;
+        std::condition_variable queue_not_empty_;
+        std::condition_variable queue_not_full_;
+        bool stop_;
+    };
+  }
+}
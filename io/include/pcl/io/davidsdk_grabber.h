@@ -43,6 +43,7 @@
 #include <pcl/common/time.h>
 #include <pcl/common/io.h>
 #include <pcl/PolygonMesh.h>
+#include <pcl/point_cloud_fwd.h>
 #include <pcl/io/grabber.h>
 
 #include <david.h>
@@ -52,8 +53,6 @@
 namespace pcl
 {
   struct PointXYZ;
-  template <typename T> class PointCloud;
-
   /** @brief Grabber for davidSDK structured light compliant devices.\n
    * The [davidSDK SDK](http://www.david-3d.com/en/products/david-sdk) allows to use a structured light scanner to
    * fetch clouds/meshes.\n
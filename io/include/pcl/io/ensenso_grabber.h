@@ -43,6 +43,7 @@
 #include <pcl/common/time.h>
 #include <pcl/common/io.h>
 #include <pcl/io/eigen.h>
+#include <pcl/point_cloud_fwd.h>
 #include <Eigen/Geometry>
 #include <Eigen/StdVector>
 #include <pcl/io/boost.h>
@@ -57,8 +58,6 @@
 namespace pcl
 {
   struct PointXYZ;
-  template <typename T> class PointCloud;
-
   /** @brief Grabber for IDS-Imaging Ensenso's devices.\n
    * The [Ensenso SDK](http://www.ensenso.de/manual/) allow to use multiple Ensenso devices to produce a single cloud.\n
    * This feature is not implemented here, it is up to the user to configure multiple Ensenso cameras.\n
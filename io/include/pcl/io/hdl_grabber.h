@@ -42,7 +42,9 @@
 #include <pcl/pcl_macros.h>
 
 #include <pcl/io/grabber.h>
-#include <pcl/io/impl/synchronized_queue.hpp>
+#include <pcl/io/impl/packet_ring_buffer.hpp>
+#include <pcl/io/point_cloud_pool.h>
+#include <pcl/io/sweep_deskew.h>
 #include <pcl/point_types.h>
 #include <pcl/point_cloud.h>
 #include <boost/asio.hpp>
@@ -200,12 +202,49 @@ namespace pcl
       virtual std::uint8_t
       getMaximumNumberOfLasers () const;
 
+      /** \brief Returns the number of packets dropped because the packet queue was full
+       */
+      std::size_t
+      getDroppedPacketCount () const;
+
+      /** \brief Only fill the scan and sweep clouds that have a connected callback.
+       *         The other clouds stay empty, which saves the time spent building them.
+       *         Default: true
+       */
+      void
+      setDecodeConnectedCloudsOnly (const bool connected_only);
+
+      /** \brief Returns true if only the clouds with a connected callback are filled
+       */
+      bool
+      getDecodeConnectedCloudsOnly () const;
+
+      /** \brief Correct the motion of the sensor while decoding the packets.
+       *         Every firing is moved into the frame of the sensor at the first firing of its sweep, with the
+       *         poses given to \a deskew. This applies to the scan and the sweep clouds, and costs one pose
+       *         interpolation per firing. The time base of the poses is the timestamp of the packets in
+       *         seconds past the hour, plus one hour at every wrap of the timestamp since the grabber was created.
+       *         Set it before start (), NULL disables the correction.
+       *         Default: NULL
+       */
+      void
+      setSweepDeskew (const pcl::io::SweepDeskew::Ptr &deskew);
+
+      /** \brief Returns the motion correction of the sweeps, NULL if disabled
+       */
+      pcl::io::SweepDeskew::Ptr
+      getSweepDeskew () const;
+
     protected:
       static const std::uint16_t HDL_DATA_PORT = 2368;
       static const std::uint16_t HDL_NUM_ROT_ANGLES = 36001;
       static const std::uint8_t HDL_LASER_PER_FIRING = 32;
       static const std::uint8_t HDL_MAX_NUM_LASERS = 64;
       static const std::uint8_t HDL_FIRING_PER_PKT = 12;
+      static const std::uint16_t HDL_PACKET_SIZE = 1206;
+      static const std::size_t HDL_PACKET_QUEUE_SIZE = 8192;
+      /** \brief Time between two firings of the HDL-32E, in seconds */
+      static constexpr double HDL_FIRING_PERIOD = 46.08e-6;
 
       enum HDLBlock
       {
@@ -235,6 +274,35 @@ namespace pcl
           std::uint8_t sensorType;
       };
 
+      /** \brief Per-laser calibration stored as arrays, see updateLaserTables () */
+      struct HDLLaserTables
+      {
+          float cos_vert[HDL_MAX_NUM_LASERS];
+          float sin_vert[HDL_MAX_NUM_LASERS];
+          float distance[HDL_MAX_NUM_LASERS];
+          float horizontal_offset[HDL_MAX_NUM_LASERS];
+          float vertical_offset[HDL_MAX_NUM_LASERS];
+          float cos_azimuth[HDL_MAX_NUM_LASERS];
+          float sin_azimuth[HDL_MAX_NUM_LASERS];
+      };
+
+      /** \brief Returns of one firing decoded into arrays, invalid returns have NaN coordinates */
+      struct HDLDecodedReturns
+      {
+          float x[HDL_LASER_PER_FIRING];
+          float y[HDL_LASER_PER_FIRING];
+          float z[HDL_LASER_PER_FIRING];
+          float intensity[HDL_LASER_PER_FIRING];
+      };
+
+      /** \brief Flags of the clouds filled while decoding */
+      enum HDLCloudFlags
+      {
+        SCAN_XYZ = 1, SCAN_XYZI = 2, SCAN_XYZRGBA = 4,
+        SWEEP_XYZ = 8, SWEEP_XYZI = 16, SWEEP_XYZRGBA = 32,
+        ALL_CLOUDS = 63
+      };
+
       struct HDLLaserCorrection
       {
           double azimuthCorrection;
@@ -249,10 +317,22 @@ namespace pcl
       };
 
       HDLLaserCorrection laser_corrections_[HDL_MAX_NUM_LASERS];
+      HDLLaserTables laser_tables_;
       std::uint16_t last_azimuth_;
+      std::uint32_t sweep_counter_;
+      std::size_t current_sweep_size_;
+      unsigned int decoded_clouds_;
       pcl::PointCloud<pcl::PointXYZ>::Ptr current_scan_xyz_, current_sweep_xyz_;
       pcl::PointCloud<pcl::PointXYZI>::Ptr current_scan_xyzi_, current_sweep_xyzi_;
       pcl::PointCloud<pcl::PointXYZRGBA>::Ptr current_scan_xyzrgba_, current_sweep_xyzrgba_;
+      // Clouds handed to the callbacks return here once released and are reused for later frames
+      pcl::io::PointCloudPool<pcl::PointXYZ> scan_xyz_pool_, sweep_xyz_pool_;
+      pcl::io::PointCloudPool<pcl::PointXYZI> scan_xyzi_pool_, sweep_xyzi_pool_;
+      pcl::io::PointCloudPool<pcl::PointXYZRGBA> scan_xyzrgba_pool_, sweep_xyzrgba_pool_;
+      pcl::io::SweepDeskew::Ptr sweep_deskew_;
+      // Unwrapping of the packet timestamps, which count the microseconds past the hour
+      std::uint32_t last_gps_timestamp_;
+      double gps_time_offset_;
       boost::signals2::signal<sig_cb_velodyne_hdl_sweep_point_cloud_xyz>* sweep_xyz_signal_;
       boost::signals2::signal<sig_cb_velodyne_hdl_sweep_point_cloud_xyzrgba>* sweep_xyzrgba_signal_;
       boost::signals2::signal<sig_cb_velodyne_hdl_sweep_point_cloud_xyzi>* sweep_xyzi_signal_;
@@ -272,11 +352,49 @@ namespace pcl
                    HDLLaserReturn laserReturn,
                    HDLLaserCorrection correction) const;
 
+      /** \brief Rebuild laser_tables_ from laser_corrections_. Must be called whenever the corrections change. */
+      void
+      updateLaserTables ();
+
+      /** \brief Refresh decoded_clouds_ from the connected callbacks, once per packet */
+      void
+      updateDecodedClouds ();
+
+      /** \brief Convert the returns of several lasers fired at the same azimuth.
+       *         The same computation as computeXYZI (), arranged so that the compiler vectorizes it.
+       * \param[in] returns the raw laser returns
+       * \param[in] count the number of returns, at most HDL_LASER_PER_FIRING
+       * \param[in] first_laser the laser index of the first return, used to look up the corrections
+       * \param[in] azimuth the azimuth in hundredths of a degree
+       * \param[out] decoded the decoded returns, written from index 0
+       */
+      void
+      decodeReturns (const HDLLaserReturn *returns,
+                     std::uint8_t count,
+                     std::uint8_t first_laser,
+                     std::uint16_t azimuth,
+                     HDLDecodedReturns &decoded) const;
+
+      /** \brief Fire the current sweep if it holds points and start a new one */
+      void
+      startNewSweep (time_t stamp);
+
+      /** \brief Returns the time of a packet in seconds, see setSweepDeskew (). Call it once per packet, in order */
+      double
+      getPacketTime (std::uint32_t gps_timestamp);
+
+      /** \brief Append one decoded return to the current sweep, and to the current scan if requested */
+      void
+      appendPoint (const HDLDecodedReturns &decoded,
+                   std::uint8_t index,
+                   const pcl::RGB &color,
+                   bool add_to_scan);
+
 
     private:
       static double *cos_lookup_table_;
       static double *sin_lookup_table_;
-      pcl::SynchronizedQueue<std::uint8_t *> hdl_data_;
+      pcl::PacketRingBuffer hdl_data_;
       boost::asio::ip::udp::endpoint udp_listener_endpoint_;
       boost::asio::ip::address source_address_filter_;
       std::uint16_t source_port_filter_;
@@ -289,6 +407,7 @@ namespace pcl
       pcl::RGB laser_rgb_mapping_[HDL_MAX_NUM_LASERS];
       float min_distance_threshold_;
       float max_distance_threshold_;
+      bool decode_connected_only_;
 
       virtual void
       toPointClouds (HDLDataPacket *dataPacket);
@@ -42,6 +42,7 @@
 
 #include <pcl/conversions.h>
 #include <pcl/memory.h>
+#include <pcl/point_cloud_fwd.h>
 #include <pcl/pcl_config.h>
 #include <pcl/common/time_trigger.h>
 #include <pcl/io/grabber.h>
@@ -195,7 +196,6 @@ namespace pcl
   };
 
   ////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-  template <typename T> class PointCloud;
   template <typename PointT> class ImageGrabber : public ImageGrabberBase, public FileGrabber<PointT>
   {
     public:
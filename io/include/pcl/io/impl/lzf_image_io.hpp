@@ -68,10 +68,32 @@ LZFDepth16ImageReader::read (
     PCL_ERROR ("[pcl::io::LZFDepth16ImageReader::read] Unable to read image data from %s.\n", filename.c_str ());
     return (false);
   }
+  return (decode (compressed_data, uncompressed_size, cloud));
+}
+
 
+template <typename PointT> bool
+LZFDepth16ImageReader::read (
+    const std::vector<char> &blob, pcl::PointCloud<PointT> &cloud)
+{
+  std::uint32_t uncompressed_size;
+  std::vector<char> compressed_data;
+  if (!loadImageBlob (blob.data (), blob.size (), compressed_data, uncompressed_size))
+  {
+    PCL_ERROR ("[pcl::io::LZFDepth16ImageReader::read] Unable to read image data from the blob.\n");
+    return (false);
+  }
+  return (decode (compressed_data, uncompressed_size, cloud));
+}
+
+
+template <typename PointT> bool
+LZFDepth16ImageReader::decode (
+    const std::vector<char> &compressed_data, std::uint32_t uncompressed_size, pcl::PointCloud<PointT> &cloud)
+{
   if (uncompressed_size != getWidth () * getHeight () * 2)
   {
-    PCL_DEBUG ("[pcl::io::LZFDepth16ImageReader::read] Uncompressed data has wrong size (%u), while in fact it should be %u bytes. \n[pcl::io::LZFDepth16ImageReader::read] Are you sure %s is a 16-bit depth PCLZF file? Identifier says: %s\n", uncompressed_size, getWidth () * getHeight () * 2, filename.c_str (), getImageType ().c_str ());
+    PCL_DEBUG ("[pcl::io::LZFDepth16ImageReader::decode] Uncompressed data has wrong size (%u), while in fact it should be %u bytes. \n[pcl::io::LZFDepth16ImageReader::decode] Is the data a 16-bit depth PCLZF file? Identifier says: %s\n", uncompressed_size, getWidth () * getHeight () * 2, getImageType ().c_str ());
     return (false);
   }
 
@@ -80,7 +102,7 @@ LZFDepth16ImageReader::read (
 
   if (uncompressed_data.empty ())
   {
-    PCL_ERROR ("[pcl::io::LZFDepth16ImageReader::read] Error uncompressing data stored in %s!\n", filename.c_str ());
+    PCL_ERROR ("[pcl::io::LZFDepth16ImageReader::decode] Error uncompressing data!\n");
     return (false);
   }
 
@@ -214,10 +236,32 @@ LZFRGB24ImageReader::read (
     PCL_ERROR ("[pcl::io::LZFRGB24ImageReader::read] Unable to read image data from %s.\n", filename.c_str ());
     return (false);
   }
+  return (decode (compressed_data, uncompressed_size, cloud));
+}
+
 
+template <typename PointT> bool
+LZFRGB24ImageReader::read (
+    const std::vector<char> &blob, pcl::PointCloud<PointT> &cloud)
+{
+  std::uint32_t uncompressed_size;
+  std::vector<char> compressed_data;
+  if (!loadImageBlob (blob.data (), blob.size (), compressed_data, uncompressed_size))
+  {
+    PCL_ERROR ("[pcl::io::LZFRGB24ImageReader::read] Unable to read image data from the blob.\n");
+    return (false);
+  }
+  return (decode (compressed_data, uncompressed_size, cloud));
+}
+
+
+template <typename PointT> bool
+LZFRGB24ImageReader::decode (
+    const std::vector<char> &compressed_data, std::uint32_t uncompressed_size, pcl::PointCloud<PointT> &cloud)
+{
   if (uncompressed_size != getWidth () * getHeight () * 3)
   {
-    PCL_DEBUG ("[pcl::io::LZFRGB24ImageReader::read] Uncompressed data has wrong size (%u), while in fact it should be %u bytes. \n[pcl::io::LZFRGB24ImageReader::read] Are you sure %s is a 24-bit RGB PCLZF file? Identifier says: %s\n", uncompressed_size, getWidth () * getHeight () * 3, filename.c_str (), getImageType ().c_str ());
+    PCL_DEBUG ("[pcl::io::LZFRGB24ImageReader::decode] Uncompressed data has wrong size (%u), while in fact it should be %u bytes. \n[pcl::io::LZFRGB24ImageReader::decode] Is the data a 24-bit RGB PCLZF file? Identifier says: %s\n", uncompressed_size, getWidth () * getHeight () * 3, getImageType ().c_str ());
     return (false);
   }
 
@@ -226,7 +270,7 @@ LZFRGB24ImageReader::read (
 
   if (uncompressed_data.empty ())
   {
-    PCL_ERROR ("[pcl::io::LZFRGB24ImageReader::read] Error uncompressing data stored in %s!\n", filename.c_str ());
+    PCL_ERROR ("[pcl::io::LZFRGB24ImageReader::decode] Error uncompressing data!\n");
     return (false);
   }
 
@@ -319,10 +363,32 @@ LZFYUV422ImageReader::read (
     PCL_ERROR ("[pcl::io::LZFYUV422ImageReader::read] Unable to read image data from %s.\n", filename.c_str ());
     return (false);
   }
+  return (decode (compressed_data, uncompressed_size, cloud));
+}
+
 
+template <typename PointT> bool
+LZFYUV422ImageReader::read (
+    const std::vector<char> &blob, pcl::PointCloud<PointT> &cloud)
+{
+  std::uint32_t uncompressed_size;
+  std::vector<char> compressed_data;
+  if (!loadImageBlob (blob.data (), blob.size (), compressed_data, uncompressed_size))
+  {
+    PCL_ERROR ("[pcl::io::LZFYUV422ImageReader::read] Unable to read image data from the blob.\n");
+    return (false);
+  }
+  return (decode (compressed_data, uncompressed_size, cloud));
+}
+
+
+template <typename PointT> bool
+LZFYUV422ImageReader::decode (
+    const std::vector<char> &compressed_data, std::uint32_t uncompressed_size, pcl::PointCloud<PointT> &cloud)
+{
   if (uncompressed_size != getWidth () * getHeight () * 2)
   {
-    PCL_DEBUG ("[pcl::io::LZFYUV422ImageReader::read] Uncompressed data has wrong size (%u), while in fact it should be %u bytes. \n[pcl::io::LZFYUV422ImageReader::read] Are you sure %s is a 16-bit YUV422 PCLZF file? Identifier says: %s\n", uncompressed_size, getWidth () * getHeight (), filename.c_str (), getImageType ().c_str ());
+    PCL_DEBUG ("[pcl::io::LZFYUV422ImageReader::decode] Uncompressed data has wrong size (%u), while in fact it should be %u bytes. \n[pcl::io::LZFYUV422ImageReader::decode] Is the data a 16-bit YUV422 PCLZF file? Identifier says: %s\n", uncompressed_size, getWidth () * getHeight (), getImageType ().c_str ());
     return (false);
   }
 
@@ -331,7 +397,7 @@ LZFYUV422ImageReader::read (
 
   if (uncompressed_data.empty ())
   {
-    PCL_ERROR ("[pcl::io::LZFYUV422ImageReader::read] Error uncompressing data stored in %s!\n", filename.c_str ());
+    PCL_ERROR ("[pcl::io::LZFYUV422ImageReader::decode] Error uncompressing data!\n");
     return (false);
   }
 
@@ -443,10 +509,32 @@ LZFBayer8ImageReader::read (
     PCL_ERROR ("[pcl::io::LZFBayer8ImageReader::read] Unable to read image data from %s.\n", filename.c_str ());
     return (false);
   }
+  return (decode (compressed_data, uncompressed_size, cloud));
+}
+
 
+template <typename PointT> bool
+LZFBayer8ImageReader::read (
+    const std::vector<char> &blob, pcl::PointCloud<PointT> &cloud)
+{
+  std::uint32_t uncompressed_size;
+  std::vector<char> compressed_data;
+  if (!loadImageBlob (blob.data (), blob.size (), compressed_data, uncompressed_size))
+  {
+    PCL_ERROR ("[pcl::io::LZFBayer8ImageReader::read] Unable to read image data from the blob.\n");
+    return (false);
+  }
+  return (decode (compressed_data, uncompressed_size, cloud));
+}
+
+
+template <typename PointT> bool
+LZFBayer8ImageReader::decode (
+    const std::vector<char> &compressed_data, std::uint32_t uncompressed_size, pcl::PointCloud<PointT> &cloud)
+{
   if (uncompressed_size != getWidth () * getHeight ())
   {
-    PCL_DEBUG ("[pcl::io::LZFBayer8ImageReader::read] Uncompressed data has wrong size (%u), while in fact it should be %u bytes. \n[pcl::io::LZFBayer8ImageReader::read] Are you sure %s is a 8-bit Bayer PCLZF file? Identifier says: %s\n", uncompressed_size, getWidth () * getHeight (), filename.c_str (), getImageType ().c_str ());
+    PCL_DEBUG ("[pcl::io::LZFBayer8ImageReader::decode] Uncompressed data has wrong size (%u), while in fact it should be %u bytes. \n[pcl::io::LZFBayer8ImageReader::decode] Is the data a 8-bit Bayer PCLZF file? Identifier says: %s\n", uncompressed_size, getWidth () * getHeight (), getImageType ().c_str ());
     return (false);
   }
 
@@ -455,7 +543,7 @@ LZFBayer8ImageReader::read (
 
   if (uncompressed_data.empty ())
   {
-    PCL_ERROR ("[pcl::io::LZFBayer8ImageReader::read] Error uncompressing data stored in %s!\n", filename.c_str ());
+    PCL_ERROR ("[pcl::io::LZFBayer8ImageReader::decode] Error uncompressing data!\n");
     return (false);
   }
 
@@ -0,0 +1,234 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace pcl
+{
+  /** \brief Bounded queue of network packets between one or more receiving threads and
+    * a single consuming thread.
+    *
+    * The slots and their byte buffers are allocated up front and reused, so the
+    * producers never allocate or take a lock: a packet is claimed with a single
+    * compare-and-swap on the write position (bounded MPMC scheme by D. Vyukov) and
+    * copied into the slot. When the queue is full the packet is dropped and counted
+    * instead of blocking the socket thread. The consumer takes packets by swapping
+    * buffers with the slot, and only sleeps on a condition variable while the queue
+    * is empty.
+    */
+  class PacketRingBuffer
+  {
+    public:
+      /** \brief Constructor.
+        * \param[in] capacity number of slots, rounded up to a power of two
+        * \param[in] packet_size number of bytes reserved in every slot; larger packets
+        * grow the slot buffer once and it is reused afterwards
+        */
+      PacketRingBuffer (std::size_t capacity, std::size_t packet_size) :
+        mask_ (roundUpPowerOfTwo (capacity) - 1), slots_ (new Slot[mask_ + 1]),
+        enqueue_pos_ (0), dequeue_pos_ (0), dropped_ (0), consumer_waiting_ (false),
+        request_to_end_ (false), packet_size_ (packet_size)
+      {
+        for (std::size_t i = 0; i <= mask_; ++i)
+        {
+          slots_[i].sequence.store (i, std::memory_order_relaxed);
+          slots_[i].data.reserve (packet_size);
+        }
+      }
+
+      /** \brief Copy a packet into the next free slot. Safe to call from several threads.
+        * \param[in] data the packet bytes
+        * \param[in] size the number of bytes in the packet
+        * \return false if the queue is full (the packet is dropped) or has been stopped
+        */
+      bool
+      enqueue (const std::uint8_t *data, std::size_t size)
+      {
+        if (request_to_end_.load (std::memory_order_relaxed))
+          return (false);
+
+        std::size_t pos = enqueue_pos_.load (std::memory_order_relaxed);
+        Slot *slot;
+        while (true)
+        {
+          slot = &slots_[pos & mask_];
+          const std::size_t seq = slot->sequence.load (std::memory_order_acquire);
+          const std::ptrdiff_t diff = static_cast<std::ptrdiff_t> (seq) - static_cast<std::ptrdiff_t> (pos);
+          if (diff == 0)
+          {
+            if (enqueue_pos_.compare_exchange_weak (pos, pos + 1, std::memory_order_relaxed))
+              break;
+          }
+          else if (diff < 0)
+          {
+            dropped_.fetch_add (1, std::memory_order_relaxed);
+            return (false);
+          }
+          else
+            pos = enqueue_pos_.load (std::memory_order_relaxed);
+        }
+
+        slot->data.assign (data, data + size);
+        slot->sequence.store (pos + 1, std::memory_order_release);
+
+        // Order the publication above before reading the flag, pairs with dequeue ()
+        std::atomic_thread_fence (std::memory_order_seq_cst);
+        if (consumer_waiting_.load ())
+        {
+          std::lock_guard<std::mutex> lock (mutex_);
+          cond_.notify_one ();
+        }
+        return (true);
+      }
+
+      /** \brief Take the oldest packet, waiting until one arrives or the queue is stopped.
+        * Must only be called from a single thread.
+        * \param[in,out] packet receives the packet; its previous buffer is handed back to
+        * the queue, so passing the same vector on every call avoids allocations
+        * \return false once the queue has been stopped
+        */
+      bool
+      dequeue (std::vector<std::uint8_t> &packet)
+      {
+        while (!request_to_end_.load ())
+        {
+          if (tryDequeue (packet))
+            return (true);
+
+          std::unique_lock<std::mutex> lock (mutex_);
+          consumer_waiting_.store (true);
+          if (!request_to_end_.load () && isEmpty ())
+            cond_.wait_for (lock, std::chrono::milliseconds (100));
+          consumer_waiting_.store (false);
+        }
+        return (false);
+      }
+
+      /** \brief Take the oldest packet without waiting. Must only be called from a single thread.
+        * \return false if the queue is empty
+        */
+      bool
+      tryDequeue (std::vector<std::uint8_t> &packet)
+      {
+        const std::size_t pos = dequeue_pos_.load (std::memory_order_relaxed);
+        Slot &slot = slots_[pos & mask_];
+        if (slot.sequence.load (std::memory_order_acquire) != pos + 1)
+          return (false);
+
+        if (packet.capacity () < packet_size_)
+          packet.reserve (packet_size_);
+        packet.swap (slot.data);
+        dequeue_pos_.store (pos + 1, std::memory_order_relaxed);
+        slot.sequence.store (pos + mask_ + 1, std::memory_order_release);
+        return (true);
+      }
+
+      /** \brief Wake up the consumer and make all further calls to enqueue and dequeue fail. */
+      void
+      stopQueue ()
+      {
+        std::lock_guard<std::mutex> lock (mutex_);
+        request_to_end_.store (true);
+        cond_.notify_one ();
+      }
+
+      /** \brief Check whether there is a packet ready to be dequeued. */
+      bool
+      isEmpty () const
+      {
+        const std::size_t pos = dequeue_pos_.load (std::memory_order_relaxed);
+        return (slots_[pos & mask_].sequence.load (std::memory_order_acquire) != pos + 1);
+      }
+
+      /** \brief Get the number of slots. */
+      std::size_t
+      capacity () const
+      {
+        return (mask_ + 1);
+      }
+
+      /** \brief Get the number of packets dropped because the queue was full. */
+      std::size_t
+      getDroppedPackets () const
+      {
+        return (dropped_.load (std::memory_order_relaxed));
+      }
+
+    private:
+      static std::size_t
+      roundUpPowerOfTwo (std::size_t n)
+      {
+        std::size_t p = 2;
+        while (p < n)
+          p <<= 1;
+        return (p);
+      }
+
+      struct Slot
+      {
+        std::atomic<std::size_t> sequence;
+        std::vector<std::uint8_t> data;
+      };
+
+      const std::size_t mask_;
+      std::unique_ptr<Slot[]> slots_;
+
+      // Keep the positions written by the producers and by the consumer on separate cache lines
+      char pad0_[64];
+      std::atomic<std::size_t> enqueue_pos_;
+      char pad1_[64];
+      std::atomic<std::size_t> dequeue_pos_;
+      char pad2_[64];
+      std::atomic<std::size_t> dropped_;
+
+      std::atomic<bool> consumer_waiting_;
+      std::atomic<bool> request_to_end_;
+      std::size_t packet_size_;
+      std::mutex mutex_;
+      std::condition_variable cond_;
+  };
+}
@@ -0,0 +1,51 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved
+ */
+
+#ifndef PCL_IO_IMPL_POINT_CLOUD_STREAM_HPP_
+#define PCL_IO_IMPL_POINT_CLOUD_STREAM_HPP_
+
+#include <pcl/io/point_cloud_stream.h>
+
+#include <sstream>
+
+namespace pcl
+{
+
+namespace io
+{
+
+template <typename PointT, typename Codec> bool
+PointCloudStreamServer<PointT, Codec>::publish (const PointCloudConstPtr &cloud)
+{
+  if (server_.getNumberOfClients () == 0)
+    return (false);
+
+  std::ostringstream compressed (std::ios_base::binary);
+  const bool key_frame = codec_.encode (cloud, compressed);
+  server_.publish (compressed.str (), key_frame);
+  return (true);
+}
+
+
+template <typename PointT, typename Codec> bool
+PointCloudStreamClient<PointT, Codec>::receive (PointCloudPtr &cloud)
+{
+  bool key_frame;
+  if (!client_.receive (payload_, key_frame))
+    return (false);
+
+  std::istringstream compressed (payload_, std::ios_base::binary);
+  return (codec_.decode (compressed, cloud));
+}
+
+} // namespace io
+
+} // namespace pcl
+
+#endif // PCL_IO_IMPL_POINT_CLOUD_STREAM_HPP_
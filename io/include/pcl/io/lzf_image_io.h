@@ -151,6 +151,18 @@ namespace pcl
                        std::vector<char> &data,
                        std::uint32_t &uncompressed_size);
 
+        /** \brief Parse an in-memory PCL-LZF blob
+          * \param[in] blob the PCL-LZF header followed by the compressed data
+          * \param[in] blob_size the number of bytes in the blob
+          * \param[out] data the compressed data
+          * \param[out] uncompressed_size the size of the data once decompressed
+          * \return true if operation successful, false otherwise
+          */
+        bool
+        loadImageBlob (const char *blob, std::size_t blob_size,
+                       std::vector<char> &data,
+                       std::uint32_t &uncompressed_size);
+
         /** \brief Realtime LZF decompression.
           * \param[in] input the array to decompress
           * \param[out] output the decompressed array
@@ -202,6 +214,13 @@ namespace pcl
           */
         template <typename PointT> bool
         read (const std::string &filename, pcl::PointCloud<PointT> &cloud);
+
+        /** \brief Read the data stored in an in-memory PCLZF depth blob and convert it to a pcl::PointCloud type.
+          * \param[in] blob the contents of a PCLZF file, e.g. as returned by pcl::io::LZFImagePlayer
+          * \param[out] cloud the resultant output point cloud
+          */
+        template <typename PointT> bool
+        read (const std::vector<char> &blob, pcl::PointCloud<PointT> &cloud);
         
         /** \brief Read the data stored in a PCLZF depth file and convert it to a pcl::PointCloud type.
           * \param[in] filename the file name to read the data from
@@ -220,6 +239,15 @@ namespace pcl
         readParameters (std::istream& is) override;
 
       protected:
+        /** \brief Decompress 16-bit depth data and convert it to a pcl::PointCloud type.
+          * \param[in] compressed_data the compressed data
+          * \param[in] uncompressed_size the size of the data once decompressed
+          * \param[out] cloud the resultant output point cloud
+          */
+        template <typename PointT> bool
+        decode (const std::vector<char> &compressed_data, std::uint32_t uncompressed_size,
+                pcl::PointCloud<PointT> &cloud);
+
         /** \brief Z-value depth multiplication factor 
           * (i.e., if raw data is in [mm] and we want [m], we need to multiply with 0.001)
           */
@@ -252,6 +280,13 @@ namespace pcl
           */
         template<typename PointT> bool
         read (const std::string &filename, pcl::PointCloud<PointT> &cloud);
+
+        /** \brief Read the data stored in an in-memory PCLZF RGB blob and convert it to a pcl::PointCloud type.
+          * \param[in] blob the contents of a PCLZF file, e.g. as returned by pcl::io::LZFImagePlayer
+          * \param[out] cloud the resultant output point cloud
+          */
+        template <typename PointT> bool
+        read (const std::vector<char> &blob, pcl::PointCloud<PointT> &cloud);
         
         /** \brief Read the data stored in a PCLZF RGB file and convert it to a pcl::PointCloud type.
           * Note that, unless massively multithreaded, this will likely not result in a significant speedup and may even slow performance.
@@ -271,6 +306,14 @@ namespace pcl
         readParameters (std::istream& is) override;
 
       protected:
+        /** \brief Decompress 24-bit RGB data and convert it to a pcl::PointCloud type.
+          * \param[in] compressed_data the compressed data
+          * \param[in] uncompressed_size the size of the data once decompressed
+          * \param[out] cloud the resultant output point cloud
+          */
+        template <typename PointT> bool
+        decode (const std::vector<char> &compressed_data, std::uint32_t uncompressed_size,
+                pcl::PointCloud<PointT> &cloud);
     };
 
     /** \brief PCL-LZF 8-bit Bayer image format reader.
@@ -299,6 +342,13 @@ namespace pcl
           */
         template<typename PointT> bool
         read (const std::string &filename, pcl::PointCloud<PointT> &cloud);
+
+        /** \brief Read the data stored in an in-memory PCLZF YUV422 16bit blob and convert it to a pcl::PointCloud type.
+          * \param[in] blob the contents of a PCLZF file, e.g. as returned by pcl::io::LZFImagePlayer
+          * \param[out] cloud the resultant output point cloud
+          */
+        template <typename PointT> bool
+        read (const std::vector<char> &blob, pcl::PointCloud<PointT> &cloud);
         
         /** \brief Read the data stored in a PCLZF YUV422 file and convert it to a pcl::PointCloud type.
           * Note that, unless massively multithreaded, this will likely not result in a significant speedup
@@ -309,6 +359,16 @@ namespace pcl
         template <typename PointT> bool
         readOMP (const std::string &filename, pcl::PointCloud<PointT> &cloud, 
                  unsigned int num_threads=0);
+
+      protected:
+        /** \brief Decompress 16-bit YUV422 data and convert it to a pcl::PointCloud type.
+          * \param[in] compressed_data the compressed data
+          * \param[in] uncompressed_size the size of the data once decompressed
+          * \param[out] cloud the resultant output point cloud
+          */
+        template <typename PointT> bool
+        decode (const std::vector<char> &compressed_data, std::uint32_t uncompressed_size,
+                pcl::PointCloud<PointT> &cloud);
     };
 
     /** \brief PCL-LZF 8-bit Bayer image format reader.
@@ -338,6 +398,13 @@ namespace pcl
         template<typename PointT> bool
         read (const std::string &filename, pcl::PointCloud<PointT> &cloud);
 
+        /** \brief Read the data stored in an in-memory PCLZF Bayer 8bit blob and convert it to a pcl::PointCloud type.
+          * \param[in] blob the contents of a PCLZF file, e.g. as returned by pcl::io::LZFImagePlayer
+          * \param[out] cloud the resultant output point cloud
+          */
+        template <typename PointT> bool
+        read (const std::vector<char> &blob, pcl::PointCloud<PointT> &cloud);
+
         /** \brief Read the data stored in a PCLZF Bayer 8bit file and convert it to a pcl::PointCloud type.
           * Note that, unless massively multithreaded, this will likely not result in a significant speedup and may even slow performance.
           * \param[in] filename the file name to read the data from
@@ -347,6 +414,16 @@ namespace pcl
         template <typename PointT> bool
         readOMP (const std::string &filename, pcl::PointCloud<PointT> &cloud, 
                  unsigned int num_threads=0);
+
+      protected:
+        /** \brief Decompress 8-bit Bayer data and convert it to a pcl::PointCloud type.
+          * \param[in] compressed_data the compressed data
+          * \param[in] uncompressed_size the size of the data once decompressed
+          * \param[out] cloud the resultant output point cloud
+          */
+        template <typename PointT> bool
+        decode (const std::vector<char> &compressed_data, std::uint32_t uncompressed_size,
+                pcl::PointCloud<PointT> &cloud);
     };
 
     /** \brief PCL-LZF image format writer.
@@ -402,6 +479,20 @@ namespace pcl
         writeParameters (const CameraParameters &parameters,
                          const std::string &filename) = 0;
 
+        /** \brief Compress an image into an in-memory PCL-LZF blob, i.e. what \ref write stores on disk.
+          * Unlike \ref write, this does not touch the file system and can be called concurrently.
+          * \param[in] data the array holding the image
+          * \param[in] width the with of the data array
+          * \param[in] height the height of the data array
+          * \param[out] blob the PCL-LZF header followed by the compressed data
+          * \return true if operation successful, false otherwise (also if the format has no encoder)
+          */
+        virtual bool
+        encode (const char*, std::uint32_t, std::uint32_t, std::vector<char> &) const
+        {
+          return (false);
+        }
+
         /** \brief Save an image and its camera parameters into PCL-LZF format.
           * \param[in] data the array holding the image
           * \param[in] width the with of the data array
@@ -463,7 +554,22 @@ namespace pcl
         compress (const char* input, std::uint32_t input_size, 
                   std::uint32_t width, std::uint32_t height,
                   const std::string &image_type,
-                  char *output);
+                  char *output) const;
+
+        /** \brief Compress an array into a PCL-LZF blob, allocating the output as needed.
+          * \param[in] input the array to compress
+          * \param[in] input_size the size of the array to compress
+          * \param[in] width the with of the data array
+          * \param[in] height the height of the data array
+          * \param[in] image_type the type of the image to save (see \ref compress)
+          * \param[out] blob the PCL-LZF header followed by the compressed data
+          * \return true if operation successful, false otherwise
+          */
+        bool
+        compress (const char* input, std::uint32_t input_size,
+                  std::uint32_t width, std::uint32_t height,
+                  const std::string &image_type,
+                  std::vector<char> &blob) const;
     };
 
     /** \brief PCL-LZF 16-bit depth image format writer.
@@ -499,6 +605,18 @@ namespace pcl
                std::uint32_t width, std::uint32_t height,
                const std::string &filename) override;
 
+        /** \brief Compress a 16-bit depth image into an in-memory PCL-LZF blob.
+          * \param[in] data the array holding the image
+          * \param[in] width the with of the data array
+          * \param[in] height the height of the data array
+          * \param[out] blob the PCL-LZF header followed by the compressed data
+          * \return true if operation successful, false otherwise
+          */
+        bool
+        encode (const char* data,
+                std::uint32_t width, std::uint32_t height,
+                std::vector<char> &blob) const override;
+
         /** \brief Write camera parameters to disk.
           * \param[in] parameters the camera parameters
           * \param[in] filename the file name to write
@@ -552,6 +670,18 @@ namespace pcl
                std::uint32_t width, std::uint32_t height,
                const std::string &filename) override;
 
+        /** \brief Compress a 24-bit RGB image into an in-memory PCL-LZF blob.
+          * \param[in] data the array holding the image
+          * \param[in] width the with of the data array
+          * \param[in] height the height of the data array
+          * \param[out] blob the PCL-LZF header followed by the compressed data
+          * \return true if operation successful, false otherwise
+          */
+        bool
+        encode (const char* data,
+                std::uint32_t width, std::uint32_t height,
+                std::vector<char> &blob) const override;
+
         /** \brief Write camera parameters to disk.
           * \param[in] parameters the camera parameters
           * \param[in] filename the file name to write
@@ -593,6 +723,18 @@ namespace pcl
         write (const char *data, 
                std::uint32_t width, std::uint32_t height,
                const std::string &filename) override;
+
+        /** \brief Compress a 16-bit YUV422 image into an in-memory PCL-LZF blob.
+          * \param[in] data the array holding the image
+          * \param[in] width the with of the data array
+          * \param[in] height the height of the data array
+          * \param[out] blob the PCL-LZF header followed by the compressed data
+          * \return true if operation successful, false otherwise
+          */
+        bool
+        encode (const char* data,
+                std::uint32_t width, std::uint32_t height,
+                std::vector<char> &blob) const override;
     };
 
     /** \brief PCL-LZF 8-bit Bayer image format writer.
@@ -624,6 +766,18 @@ namespace pcl
         write (const char *data, 
                std::uint32_t width, std::uint32_t height,
                const std::string &filename) override;
+
+        /** \brief Compress a 8-bit Bayer image into an in-memory PCL-LZF blob.
+          * \param[in] data the array holding the image
+          * \param[in] width the with of the data array
+          * \param[in] height the height of the data array
+          * \param[out] blob the PCL-LZF header followed by the compressed data
+          * \return true if operation successful, false otherwise
+          */
+        bool
+        encode (const char* data,
+                std::uint32_t width, std::uint32_t height,
+                std::vector<char> &blob) const override;
     };
   }
 }
@@ -0,0 +1,257 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved
+ */
+
+#pragma once
+
+#include <pcl/pcl_macros.h>
+#include <pcl/io/lzf_image_io.h>
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace pcl
+{
+  namespace io
+  {
+    /** \brief Records PCL-LZF images, compressing and writing them on background threads.
+      *
+      * \ref record copies an image into a bounded queue and returns immediately, so that the
+      * acquisition thread (e.g. a grabber callback) is never held up by compression or disk I/O.
+      * The images are compressed concurrently by a pool of threads, using the \ref LZFImageWriter
+      * passed along with each image.
+      *
+      * Every image is either written to its own PCLZF file, exactly like LZFImageWriter::write
+      * does, or appended to a single multi-frame file opened with \ref open. The latter simply
+      * holds the PCLZF blobs back to back, in the order in which they were recorded, and avoids
+      * creating a file per frame. It can be played back with pcl::io::LZFImagePlayer.
+      *
+      * \code
+      * pcl::io::LZFImageRecorder recorder;
+      * recorder.open ("capture.pclzf");
+      * auto depth_writer = std::make_shared<pcl::io::LZFDepth16ImageWriter> ();
+      * auto rgb_writer = std::make_shared<pcl::io::LZFRGB24ImageWriter> ();
+      * // For every frame, from the grabber callback:
+      * recorder.record (depth_writer, depth_data, 640 * 480 * 2, 640, 480);
+      * recorder.record (rgb_writer, rgb_data, 640 * 480 * 3, 640, 480);
+      * \endcode
+      *
+      * \ingroup io
+      */
+    class PCL_EXPORTS LZFImageRecorder
+    {
+      public:
+        /** \brief Start the compression threads.
+          * \param[in] nr_threads the number of images compressed concurrently (0 to use as many as
+          * there are hardware threads)
+          * \param[in] queue_size the maximum number of images waiting to be compressed
+          */
+        LZFImageRecorder (unsigned int nr_threads = 2, std::size_t queue_size = 16);
+
+        LZFImageRecorder (const LZFImageRecorder&) = delete;
+        LZFImageRecorder&
+        operator = (const LZFImageRecorder&) = delete;
+
+        /** \brief Write the images still queued, then stop the compression threads. */
+        ~LZFImageRecorder ();
+
+        /** \brief Open a multi-frame file, which the images recorded without a file name are appended to.
+          * A previously opened file is closed first.
+          * \param[in] file_name the name of the file to create
+          * \return true if operation successful, false otherwise
+          */
+        bool
+        open (const std::string &file_name);
+
+        /** \brief Write the images still queued and close the multi-frame file. */
+        void
+        close ();
+
+        /** \brief Queue an image for compression.
+          * \param[in] writer the writer compressing the image, shared with the compression threads
+          * \param[in] data the array holding the image, which is copied
+          * \param[in] data_size the number of bytes in the data array
+          * \param[in] width the with of the data array
+          * \param[in] height the height of the data array
+          * \param[in] file_name the PCLZF file to write the image to, or empty to append it to the
+          * multi-frame file
+          * \param[in] wait whether to block while the queue is full, or to drop the image instead
+          * \return true if the image was queued, false if it was dropped
+          */
+        bool
+        record (const std::shared_ptr<const LZFImageWriter> &writer,
+                const char *data, std::size_t data_size,
+                std::uint32_t width, std::uint32_t height,
+                const std::string &file_name = "", bool wait = true);
+
+        /** \brief Block until all the images recorded so far are written. */
+        void
+        flush ();
+
+        /** \brief Get the number of images dropped because the queue was full. */
+        std::size_t
+        getNumberOfDroppedFrames () const;
+
+        /** \brief Get the number of images which could not be compressed or written. */
+        std::size_t
+        getNumberOfFailedFrames () const;
+
+      private:
+        struct Frame
+        {
+          std::shared_ptr<const LZFImageWriter> writer;
+          std::vector<char> data;
+          std::uint32_t width;
+          std::uint32_t height;
+          std::string file_name;
+          /** \brief Position of the image in the multi-frame file. */
+          std::size_t index;
+        };
+
+        /** \brief The loop of the compression threads. */
+        void
+        run ();
+
+        /** \brief Append a compressed image to the multi-frame file, once all the images before it are written. */
+        bool
+        append (std::size_t index, const std::vector<char> &blob);
+
+        std::vector<std::thread> threads_;
+
+        /** \brief The images waiting to be compressed, bounded by \a queue_size_. */
+        std::deque<Frame> queue_;
+        std::size_t queue_size_;
+        /** \brief The number of images being compressed or written. */
+        std::size_t nr_active_;
+
+        /** \brief The multi-frame file, guarded by \a file_mutex_ so that writing it never blocks \ref record. */
+        std::ofstream file_;
+        std::mutex file_mutex_;
+        std::condition_variable frame_written_;
+        /** \brief The index given to the next image appended to the multi-frame file. */
+        std::size_t next_index_;
+        /** \brief The index of the next image to write to the multi-frame file. */
+        std::size_t next_written_;
+
+        std::size_t nr_dropped_;
+        std::size_t nr_failed_;
+
+        mutable std::mutex mutex_;
+        std::condition_variable queue_not_empty_;
+        std::condition_variable queue_not_full_;
+        std::condition_variable frames_done_;
+        bool stop_;
+    };
+
+    /** \brief Plays back PCL-LZF images, reading them ahead on a background thread.
+      *
+      * The images are read either from a multi-frame file written by pcl::io::LZFImageRecorder,
+      * or from a list of PCLZF files. While the caller decodes and processes an image, the
+      * following ones are already read from disk, up to a bounded number of images.
+      *
+      * The images are returned as in-memory PCLZF blobs, which the readers decode directly:
+      *
+      * \code
+      * pcl::io::LZFImagePlayer player;
+      * player.open ("capture.pclzf");
+      * pcl::io::LZFDepth16ImageReader depth_reader;
+      * pcl::io::LZFRGB24ImageReader rgb_reader;
+      * depth_reader.readParameters ("parameters.xml");
+      * std::vector<char> depth, rgb;
+      * while (player.getNextFrame (depth) && player.getNextFrame (rgb))
+      * {
+      *   pcl::PointCloud<pcl::PointXYZRGBA> cloud;
+      *   depth_reader.read (depth, cloud);
+      *   rgb_reader.read (rgb, cloud);
+      * }
+      * \endcode
+      *
+      * \ingroup io
+      */
+    class PCL_EXPORTS LZFImagePlayer
+    {
+      public:
+        /** \brief Constructor.
+          * \param[in] nr_prefetched the maximum number of images read ahead
+          */
+        LZFImagePlayer (std::size_t nr_prefetched = 8);
+
+        LZFImagePlayer (const LZFImagePlayer&) = delete;
+        LZFImagePlayer&
+        operator = (const LZFImagePlayer&) = delete;
+
+        /** \brief Stop the read-ahead thread. */
+        ~LZFImagePlayer ();
+
+        /** \brief Play back a multi-frame file. A previously opened file is closed first.
+          * \param[in] file_name the name of the file to read
+          * \return true if operation successful, false otherwise
+          */
+        bool
+        open (const std::string &file_name);
+
+        /** \brief Play back a list of PCLZF files, one image each. A previously opened file is closed first.
+          * \param[in] file_names the names of the files to read, in playback order
+          * \return true if operation successful, false otherwise
+          */
+        bool
+        open (const std::vector<std::string> &file_names);
+
+        /** \brief Stop reading ahead and discard the images read so far. */
+        void
+        close ();
+
+        /** \brief Get the next image, blocking until it is read.
+          * \param[out] blob the PCLZF blob holding the image
+          * \return true if an image was read, false at the end of the playback or on error
+          */
+        bool
+        getNextFrame (std::vector<char> &blob);
+
+      private:
+        /** \brief Start the read-ahead thread. */
+        void
+        start ();
+
+        /** \brief Read the next image from the multi-frame file or the list of files.
+          * \return false at the end of the playback or on error
+          */
+        bool
+        readFrame (std::vector<char> &blob);
+
+        /** \brief The loop of the read-ahead thread. */
+        void
+        run ();
+
+        std::thread thread_;
+
+        std::ifstream file_;
+        std::vector<std::string> file_names_;
+        std::size_t next_file_;
+
+        /** \brief The images read ahead, bounded by \a nr_prefetched_. */
+        std::deque<std::vector<char> > queue_;
+        std::size_t nr_prefetched_;
+        /** \brief Whether the read-ahead thread reached the end of the playback. */
+        bool done_;
+
+        std::mutex mutex_;
+        std::condition_variable queue_not_empty_;
+        std::condition_variable queue_not_full_;
+        bool stop_;
+    };
+  }
+}
@@ -38,6 +38,7 @@
 
 #include <pcl/memory.h>
 #include <pcl/TextureMesh.h>
+#include <pcl/TriangleMesh.h>
 #include <pcl/io/file_io.h>
 
 namespace pcl
@@ -94,7 +95,7 @@ namespace pcl
   {
     public:
       /** \brief empty constructor */
-      OBJReader() {}
+      OBJReader() : threads_ (1) {}
       /** \brief empty destructor */
       ~OBJReader() {}
       /** \brief Read a point cloud data header from a FILE file.
@@ -218,6 +219,34 @@ namespace pcl
       int
       read (const std::string &file_name, pcl::PolygonMesh &mesh, const int offset = 0);
 
+      /** \brief Read a mesh from an OBJ file and store it into a pcl/TriangleMesh.
+        *
+        * The faces are parsed straight into the flat triangle buffer, faces with more than three
+        * vertices are split into triangles.
+        * \param[in] file_name the name of the file containing data
+        * \param[out] mesh the resultant TriangleMesh read from disk
+        * \param[in] offset the offset in the file where to expect the true
+        * header to begin.
+        *
+        * \return 0 on success.
+        */
+      int
+      read (const std::string &file_name, pcl::TriangleMesh &mesh, const int offset = 0);
+
+      /** \brief Set the number of threads used to parse the vertices, normals and faces of the
+        * point cloud and mesh files (default: 1). The TextureMesh files are parsed by one thread.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      void
+      setNumberOfThreads (unsigned int nr_threads = 0);
+
+      /** \brief Get the number of threads used to read the files. */
+      inline unsigned int
+      getNumberOfThreads () const
+      {
+        return (threads_);
+      }
+
       /** \brief Read a point cloud data from any FILE file, and convert it to the given
         * template format.
         * \param[in] file_name the name of the file containing the actual PointCloud data
@@ -244,8 +273,25 @@ namespace pcl
       }
 
     private:
+      /** \brief Read the vertices, vertex normals and, if \a face_vertices is given, the faces of an
+        * OBJ file into a cloud prepared by readHeader. The lines are read by large blocks and parsed
+        * in parallel.
+        * \param[in] fs the file, at the beginning of the data
+        * \param[in,out] cloud the vertex data
+        * \param[out] face_vertices the vertex indices of all faces, one face after the other
+        * \param[out] face_offsets the index of the first vertex of every face in \a face_vertices,
+        * followed by the size of \a face_vertices
+        * \return 0 on success.
+        */
+      int
+      readBody (std::istream &fs, pcl::PCLPointCloud2 &cloud,
+                std::vector<std::uint32_t> *face_vertices, std::vector<std::size_t> *face_offsets);
+
       /// Usually OBJ files come MTL files where texture materials are stored
       std::vector<pcl::MTLReader> companions_;
+
+      /// The number of threads used to parse the files
+      unsigned int threads_;
   };
 
   namespace io
@@ -306,6 +352,21 @@ namespace pcl
       return (p.read (file_name, mesh));
     }
 
+    /** \brief Load any OBJ file into a TriangleMesh type. Faces with more than three
+      * vertices are split into triangles.
+      * \param[in] file_name the name of the file to load
+      * \param[out] mesh the resultant mesh
+      * \return 0 on success < 0 on error
+      *
+      * \ingroup io
+      */
+    inline int
+    loadOBJFile (const std::string &file_name, pcl::TriangleMesh &mesh)
+    {
+      pcl::OBJReader p;
+      return (p.read (file_name, mesh));
+    }
+
     /** \brief Load any OBJ file into a TextureMesh type.
       * \param[in] file_name the name of the file to load
       * \param[out] mesh the resultant mesh
@@ -342,5 +403,16 @@ namespace pcl
                  const pcl::PolygonMesh &mesh,
                  unsigned precision = 5);
 
+    /** \brief Saves a TriangleMesh in ascii OBJ format.
+      * \param[in] file_name the name of the file to write to disk
+      * \param[in] mesh the triangle mesh to save
+      * \param[in] precision the output ASCII precision default 5
+      * \ingroup io
+      */
+    PCL_EXPORTS int
+    saveOBJFile (const std::string &file_name,
+                 const pcl::TriangleMesh &mesh,
+                 unsigned precision = 5);
+
   }
 }
@@ -49,6 +49,7 @@
 #include <pcl/io/eigen.h>
 #include <pcl/io/boost.h>
 #include <pcl/io/grabber.h>
+#include <pcl/io/point_cloud_pool.h>
 #include <pcl/io/openni2/openni2_device.h>
 #include <string>
 #include <deque>
@@ -411,10 +412,12 @@ namespace pcl
         /** \brief Convert a Depth + RGB image pair to a pcl::PointCloud<PointT>
         * \param[in] image the RGB image to convert
         * \param[in] depth_image the depth image to convert
+        * \param[in] pool the pool the output cloud is taken from
         */
         template <typename PointT> typename pcl::PointCloud<PointT>::Ptr
         convertToXYZRGBPointCloud (const pcl::io::openni2::Image::Ptr &image,
-          const pcl::io::openni2::DepthImage::Ptr &depth_image);
+          const pcl::io::openni2::DepthImage::Ptr &depth_image,
+          pcl::io::PointCloudPool<PointT> &pool);
 
         /** \brief Convert a Depth + Intensity image pair to a pcl::PointCloud<pcl::PointXYZI>
         * \param[in] image the IR image to convert
@@ -424,6 +427,12 @@ namespace pcl
         convertToXYZIPointCloud (const pcl::io::openni2::IRImage::Ptr &image,
           const pcl::io::openni2::DepthImage::Ptr &depth_image);
 
+        // Clouds handed to the callbacks return here once released and are reused for later frames
+        pcl::io::PointCloudPool<pcl::PointXYZ> xyz_pool_;
+        pcl::io::PointCloudPool<pcl::PointXYZI> xyzi_pool_;
+        pcl::io::PointCloudPool<pcl::PointXYZRGB> xyzrgb_pool_;
+        pcl::io::PointCloudPool<pcl::PointXYZRGBA> xyzrgba_pool_;
+
         std::vector<std::uint8_t> color_resize_buffer_;
         std::vector<std::uint16_t> depth_resize_buffer_;
         std::vector<std::uint16_t> ir_resize_buffer_;
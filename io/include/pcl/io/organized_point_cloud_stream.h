@@ -0,0 +1,74 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved
+ */
+
+#pragma once
+
+#include <pcl/compression/organized_pointcloud_compression.h>
+#include <pcl/io/point_cloud_stream.h>
+
+namespace pcl
+{
+  namespace io
+  {
+    /** \brief Stream codec of PointCloudStreamServer and PointCloudStreamClient based on
+      * OrganizedPointCloudCompression, for the organized clouds of depth cameras.
+      *
+      * The depth image and the color image are compressed independently per frame with PNG, so every frame
+      * is a key frame and a lagging client only loses the frames that did not fit into its queue.
+      * \ingroup io
+      */
+    template <typename PointT>
+    class OrganizedStreamCodec
+    {
+      public:
+        using PointCloud = pcl::PointCloud<PointT>;
+        using PointCloudPtr = typename PointCloud::Ptr;
+        using PointCloudConstPtr = typename PointCloud::ConstPtr;
+        using Compression = OrganizedPointCloudCompression<PointT>;
+
+        /** \brief Constructor.
+          * \param[in] encode_color whether to send the color of the points
+          * \param[in] convert_to_mono whether to send the color as a gray value
+          * \param[in] png_level the PNG compression level, -1 for the default
+          */
+        OrganizedStreamCodec (bool encode_color = true, bool convert_to_mono = false, int png_level = -1) :
+          encode_color_ (encode_color), convert_to_mono_ (convert_to_mono), png_level_ (png_level)
+        {
+        }
+
+        /** \brief Encode a point cloud.
+          * \param[in] cloud the organized point cloud
+          * \param[out] out the compressed frame
+          * \return true, every frame is a key frame
+          */
+        bool
+        encode (const PointCloudConstPtr &cloud, std::ostream &out)
+        {
+          compression_.encodePointCloud (cloud, out, encode_color_, convert_to_mono_, false, png_level_);
+          return (true);
+        }
+
+        /** \brief Decode a point cloud.
+          * \param[in] in the compressed frame
+          * \param[out] cloud the point cloud
+          */
+        bool
+        decode (std::istream &in, PointCloudPtr &cloud)
+        {
+          return (compression_.decodePointCloud (in, cloud, false));
+        }
+
+      private:
+        Compression compression_;
+        bool encode_color_;
+        bool convert_to_mono_;
+        int png_level_;
+    };
+  }
+}
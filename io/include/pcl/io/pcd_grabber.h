@@ -45,6 +45,7 @@
 #include <pcl/common/time_trigger.h>
 #include <pcl/conversions.h>
 #include <pcl/memory.h>
+#include <pcl/point_cloud_fwd.h>
 
 #ifdef HAVE_OPENNI
 #include <pcl/io/openni_camera/openni_image.h>
@@ -52,6 +53,7 @@
 #include <pcl/io/openni_camera/openni_depth_image.h>
 #endif
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -125,6 +127,41 @@ namespace pcl
       std::size_t
       numFrames () const;
 
+      /** \brief Load the next clouds on background threads, ahead of their publication.
+        * This switches the grabber to indexed playback (see \ref seekToFrame); if it was streaming
+        * the files, the playback restarts at the first cloud.
+        * \param[in] nr_prefetched the number of clouds loaded ahead (0 to load each cloud when it is due)
+        * \param[in] nr_threads the number of clouds loaded concurrently (0 to use as many as there are
+        * hardware threads)
+        */
+      void
+      setPrefetching (std::size_t nr_prefetched, unsigned int nr_threads = 2);
+
+      /** \brief Continue the playback at a given cloud, i.e. publish it with the next trigger.
+        * This switches the grabber from streaming the files one after the other to indexed playback,
+        * which addresses the clouds (also the ones inside TAR files) through an index built once.
+        * \param[in] idx the index of the cloud, smaller than numFrames ()
+        * \return false if the index is out of bounds
+        */
+      bool
+      seekToFrame (std::size_t idx);
+
+      /** \brief Continue the playback at the cloud whose timestamp is closest to a given one.
+        * \param[in] timestamp the timestamp, in microseconds since 1970-01-01
+        * \return false if no cloud has a timestamp (see \ref getTimestampAtIndex)
+        */
+      bool
+      seekToTimestamp (std::uint64_t timestamp);
+
+      /** \brief Query the timestamp of a cloud, parsed from its file name (or name inside the TAR file),
+        * which has to be of the form frame_[ISO timestamp][_suffix].pcd, e.g. frame_20121214T142255.814212.pcd
+        * \param[in] idx the index of the cloud
+        * \param[out] timestamp the timestamp, in microseconds since 1970-01-01
+        * \return false if the index is out of bounds or the name holds no timestamp
+        */
+      bool
+      getTimestampAtIndex (std::size_t idx, std::uint64_t &timestamp) const;
+
     private:
       virtual void
       publish (const pcl::PCLPointCloud2& blob, const Eigen::Vector4f& origin, const Eigen::Quaternionf& orientation, const std::string& file_name) const = 0;
@@ -135,7 +172,6 @@ namespace pcl
   };
 
   ////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-  template <typename T> class PointCloud;
   template <typename PointT> class PCDGrabber : public PCDGrabberBase, public FileGrabber<PointT>
   {
     public:
@@ -42,10 +42,13 @@
 #include <pcl/memory.h>
 #include <pcl/pcl_macros.h>
 #include <pcl/point_cloud.h>
+#include <pcl/point_cloud2_view.h>
 #include <pcl/io/file_io.h>
 
 namespace pcl
 {
+  class PCDMappedFile;
+
   /** \brief Point Cloud Data (PCD) file format reader.
     * \author Radu B. Rusu
     * \ingroup io
@@ -54,7 +57,7 @@ namespace pcl
   {
     public:
       /** Empty constructor */
-      PCDReader () {}
+      PCDReader () : threads_ (1) {}
       /** Empty destructor */
       ~PCDReader () {}
 
@@ -69,7 +72,7 @@ namespace pcl
         *   - WIDTH ...
         *   - HEIGHT ...
         *   - POINTS ...
-        *   - DATA ascii/binary
+        *   - DATA ascii/binary/binary_compressed/binary_compressed_chunked
         *
         * Everything that follows \b DATA is interpreted as data points and
         * will be read accordingly.
@@ -101,7 +104,8 @@ namespace pcl
         * \param[out] origin the sensor acquisition origin (only for > PCD_V7 - null if not present)
         * \param[out] orientation the sensor acquisition orientation (only for > PCD_V7 - identity if not present)
         * \param[out] pcd_version the PCD version of the file (i.e., PCD_V6, PCD_V7)
-        * \param[out] data_type the type of data (0 = ASCII, 1 = Binary, 2 = Binary compressed)
+        * \param[out] data_type the type of data (0 = ASCII, 1 = Binary, 2 = Binary compressed,
+        * 3 = Binary compressed in chunks)
         * \param[out] data_idx the offset of cloud data within the file
         *
         * \return
@@ -129,7 +133,8 @@ namespace pcl
         * \param[out] origin the sensor acquisition origin (only for > PCD_V7 - null if not present)
         * \param[out] orientation the sensor acquisition orientation (only for > PCD_V7 - identity if not present)
         * \param[out] pcd_version the PCD version of the file (i.e., PCD_V6, PCD_V7)
-        * \param[out] data_type the type of data (0 = ASCII, 1 = Binary, 2 = Binary compressed)
+        * \param[out] data_type the type of data (0 = ASCII, 1 = Binary, 2 = Binary compressed,
+        * 3 = Binary compressed in chunks)
         * \param[out] data_idx the offset of cloud data within the file
         * \param[in] offset the offset of where to expect the PCD Header in the
         * file (optional parameter). One usage example for setting the offset
@@ -214,6 +219,38 @@ namespace pcl
       readBodyBinary (const unsigned char *data, pcl::PCLPointCloud2 &cloud,
                        int pcd_version, bool compressed, unsigned int data_idx);
 
+      /** \brief Read the point cloud data (body) of a binary_compressed_chunked PCD from a block of memory.
+        *
+        * For use after readHeader(), when the resulting data_type == 3. The chunks are decompressed
+        * in parallel, see \ref setNumberOfThreads.
+        *
+        * \param[in] data the memory location from which to read the body.
+        * \param[in] data_size the size of the memory block (to detect truncated files).
+        * \param[out] cloud the resultant point cloud dataset to be filled.
+        * \param[in] data_idx the offset of the body, as reported by readHeader().
+        *
+        * \return
+        *  * < 0 (-1) on error
+        *  * == 0 on success
+        */
+      int
+      readBodyBinaryCompressedChunked (const unsigned char *data, std::size_t data_size,
+                                       pcl::PCLPointCloud2 &cloud, std::size_t data_idx);
+
+      /** \brief Set the number of threads used to parse ASCII files, to decompress the chunks of
+        * binary_compressed_chunked files and to check the data for invalid values (default: 1).
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      void
+      setNumberOfThreads (unsigned int nr_threads = 0);
+
+      /** \brief Get the number of threads used to read the files. */
+      inline unsigned int
+      getNumberOfThreads () const
+      {
+        return (threads_);
+      }
+
       /** \brief Read a point cloud data from a PCD file and store it into a pcl/PCLPointCloud2.
         * \param[in] file_name the name of the file containing the actual PointCloud data
         * \param[out] cloud the resultant PointCloud message read from disk
@@ -286,6 +323,153 @@ namespace pcl
         return (res);
       }
 
+      /** \brief Read only some of the fields of a PCD file into a pcl/PCLPointCloud2.
+        *
+        * The selected fields are packed next to each other in the given order, the other ones are
+        * never copied. Binary files are memory mapped (see PCDMappedFile) and only the selected fields
+        * are touched; ASCII and compressed files have to be decoded completely first.
+        *
+        * \param[in] file_name the name of the file containing the actual PointCloud data
+        * \param[out] cloud the resultant PointCloud message read from disk
+        * \param[in] field_names the names of the fields to read (e.g. "x", "y", "z")
+        * \param[in] offset the offset of where to expect the PCD Header in the
+        * file (optional parameter).
+        *
+        * \return
+        *  * < 0 (-1) on error (e.g. if the file does not have one of the fields)
+        *  * == 0 on success
+        */
+      int
+      read (const std::string &file_name, pcl::PCLPointCloud2 &cloud,
+            const std::vector<std::string> &field_names, const int offset = 0);
+
+    private:
+      /** \brief Parse a PCD header, same as readHeader but \a cloud.data is only resized to hold the
+        * points if \a allocate_data is true.
+        */
+      int
+      parseHeader (std::istream &binary_istream, pcl::PCLPointCloud2 &cloud,
+                   Eigen::Vector4f &origin, Eigen::Quaternionf &orientation, int &pcd_version,
+                   int &data_type, unsigned int &data_idx, bool allocate_data);
+
+      /** \brief The number of threads used to read the files. */
+      unsigned int threads_;
+
+      friend class PCDMappedFile;
+
+    public:
+      PCL_MAKE_ALIGNED_OPERATOR_NEW
+  };
+
+  /** \brief Read-only memory mapping of a binary PCD file.
+    *
+    * The points of the file are not copied when it is opened: they are accessed in place, through the
+    * page cache, with \ref getView or \ref getData, and the operating system only reads the pages that
+    * are actually touched. This makes it cheap to look at a few fields or a few points of a large file,
+    * or to \ref read a subset of its fields.
+    *
+    * Only uncompressed binary files (DATA binary) can be mapped, the compressed ones have to be
+    * decoded with PCDReader anyway.
+    *
+    * \code
+    * pcl::PCDMappedFile file;
+    * if (file.open ("cloud.pcd") == 0)
+    * {
+    *   const auto view = file.getView<pcl::PointXYZ> ();
+    *   for (std::size_t i = 0; i < view.size (); ++i)
+    *     process (view.getXYZ (i));
+    * }
+    * \endcode
+    *
+    * \note The file must not be modified while it is mapped.
+    * \ingroup io
+    */
+  class PCL_EXPORTS PCDMappedFile
+  {
+    public:
+      PCDMappedFile ();
+
+      PCDMappedFile (const PCDMappedFile &) = delete;
+      PCDMappedFile&
+      operator = (const PCDMappedFile &) = delete;
+
+      /** \brief Destructor, unmaps the file. */
+      ~PCDMappedFile ();
+
+      /** \brief Map a binary PCD file, closing the previously mapped one.
+        * \param[in] file_name the name of the file to map
+        * \param[in] offset the offset of where to expect the PCD Header in the file
+        *
+        * \return
+        *  * < 0 (-1) on error (including files which are not uncompressed binary ones)
+        *  * == 0 on success
+        */
+      int
+      open (const std::string &file_name, const int offset = 0);
+
+      /** \brief Unmap the file. Views obtained from this object must not be used anymore. */
+      void
+      close ();
+
+      /** \brief Whether a file is currently mapped. */
+      inline bool
+      isOpen () const { return (map_ != nullptr); }
+
+      /** \brief Get the layout of the points (fields, width, height, point_step and row_step) as
+        * a pcl::PCLPointCloud2 with no data. is_dense is false as the points are not checked.
+        */
+      inline const pcl::PCLPointCloud2&
+      getLayout () const { return (layout_); }
+
+      /** \brief Get the address of the first point in the mapping, or a null pointer if no file is mapped. */
+      inline const std::uint8_t*
+      getData () const { return (map_ ? map_ + data_offset_ : nullptr); }
+
+      /** \brief Get the sensor acquisition origin stored in the file. */
+      inline const Eigen::Vector4f&
+      getSensorOrigin () const { return (origin_); }
+
+      /** \brief Get the sensor acquisition orientation stored in the file. */
+      inline const Eigen::Quaternionf&
+      getSensorOrientation () const { return (orientation_); }
+
+      /** \brief Get a typed view of the mapped points, see pcl::PCLPointCloud2View. The view is valid
+        * as long as the file stays mapped.
+        */
+      template <typename PointT> inline pcl::PCLPointCloud2View<PointT>
+      getView () const
+      {
+        return (pcl::PCLPointCloud2View<PointT> (layout_, getData ()));
+      }
+
+      /** \brief Copy some of the fields of the mapped points into a pcl::PCLPointCloud2.
+        * \param[out] cloud the resultant cloud, holding the selected fields packed in the given order
+        * \param[in] field_names the names of the fields to copy
+        *
+        * \return
+        *  * < 0 (-1) on error (no file mapped or unknown field)
+        *  * == 0 on success
+        */
+      int
+      read (pcl::PCLPointCloud2 &cloud, const std::vector<std::string> &field_names) const;
+
+    private:
+      /** \brief The layout of the points, with no data. */
+      pcl::PCLPointCloud2 layout_;
+
+      /** \brief The mapping of the file, from its first byte, and the offset of the points in it. */
+      std::uint8_t *map_;
+      std::size_t map_size_;
+      std::size_t data_offset_;
+
+      /** \brief The file descriptor, and the handle of the file mapping object on Windows. */
+      int fd_;
+      void *file_mapping_;
+
+      Eigen::Vector4f origin_;
+      Eigen::Quaternionf orientation_;
+
+    public:
       PCL_MAKE_ALIGNED_OPERATOR_NEW
   };
 
@@ -296,7 +480,7 @@ namespace pcl
   class PCL_EXPORTS PCDWriter : public FileWriter
   {
     public:
-      PCDWriter() : map_synchronization_(false) {}
+      PCDWriter() : map_synchronization_(false), threads_ (1), chunk_size_ (65536) {}
       ~PCDWriter() {}
 
       /** \brief Set whether mmap() synchornization via msync() is desired before munmap() calls.
@@ -313,6 +497,38 @@ namespace pcl
         map_synchronization_ = sync;
       }
 
+      /** \brief Set the number of threads used to compress the chunks of binary_compressed_chunked
+        * files (default: 1).
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      void
+      setNumberOfThreads (unsigned int nr_threads = 0);
+
+      /** \brief Get the number of threads used to compress binary_compressed_chunked files. */
+      inline unsigned int
+      getNumberOfThreads () const
+      {
+        return (threads_);
+      }
+
+      /** \brief Set the number of points stored in each independently compressed chunk of
+        * binary_compressed_chunked files (default: 65536). Smaller chunks allow more parallelism,
+        * larger ones compress slightly better.
+        * \param[in] nr_points the number of points per chunk
+        */
+      inline void
+      setCompressionChunkSize (unsigned int nr_points)
+      {
+        chunk_size_ = std::max (nr_points, 1u);
+      }
+
+      /** \brief Get the number of points stored in each chunk of binary_compressed_chunked files. */
+      inline unsigned int
+      getCompressionChunkSize () const
+      {
+        return (chunk_size_);
+      }
+
       /** \brief Generate the header of a PCD file format
         * \param[in] cloud the point cloud data message
         * \param[in] origin the sensor acquisition origin
@@ -431,6 +647,42 @@ namespace pcl
                              const Eigen::Vector4f &origin = Eigen::Vector4f::Zero (),
                              const Eigen::Quaternionf &orientation = Eigen::Quaternionf::Identity ());
 
+      /** \brief Save point cloud data to a PCD file containing n-D points, in BINARY_COMPRESSED_CHUNKED format
+        *
+        * Like BINARY_COMPRESSED, but the points are split into chunks of \ref getCompressionChunkSize
+        * points which are compressed independently, so that they can be compressed and decompressed in
+        * parallel (see \ref setNumberOfThreads and PCDReader::setNumberOfThreads). The data section holds
+        * the number of chunks and the number of points per chunk, then the compressed and uncompressed
+        * size of every chunk (the index), then the chunks.
+        * \param[in] file_name the output file name
+        * \param[in] cloud the point cloud data message
+        * \param[in] origin the sensor acquisition origin
+        * \param[in] orientation the sensor acquisition orientation
+        * \return
+        * (-1) for a general error
+        * (-2) if a chunk is too large for the file format
+        * 0 on success
+        */
+      int
+      writeBinaryCompressedChunked (const std::string &file_name, const pcl::PCLPointCloud2 &cloud,
+                                    const Eigen::Vector4f &origin = Eigen::Vector4f::Zero (),
+                                    const Eigen::Quaternionf &orientation = Eigen::Quaternionf::Identity ());
+
+      /** \brief Save point cloud data to a std::ostream containing n-D points, in BINARY_COMPRESSED_CHUNKED format
+        * \param[out] os the stream into which to write the data
+        * \param[in] cloud the point cloud data message
+        * \param[in] origin the sensor acquisition origin
+        * \param[in] orientation the sensor acquisition orientation
+        * \return
+        * (-1) for a general error
+        * (-2) if a chunk is too large for the file format
+        * 0 on success
+        */
+      int
+      writeBinaryCompressedChunked (std::ostream &os, const pcl::PCLPointCloud2 &cloud,
+                                    const Eigen::Vector4f &origin = Eigen::Vector4f::Zero (),
+                                    const Eigen::Quaternionf &orientation = Eigen::Quaternionf::Identity ());
+
       /** \brief Save point cloud data to a PCD file containing n-D points
         * \param[in] file_name the output file name
         * \param[in] cloud the point cloud data message
@@ -503,6 +755,20 @@ namespace pcl
       writeBinaryCompressed (const std::string &file_name,
                              const pcl::PointCloud<PointT> &cloud);
 
+      /** \brief Save point cloud data to a binary compressed PCD file made of independently compressed
+        * chunks, see writeBinaryCompressedChunked (const std::string&, const pcl::PCLPointCloud2&, ...).
+        * \param[in] file_name the output file name
+        * \param[in] cloud the point cloud data message
+        */
+      template <typename PointT> int
+      writeBinaryCompressedChunked (const std::string &file_name,
+                                    const pcl::PointCloud<PointT> &cloud)
+      {
+        pcl::PCLPointCloud2 blob;
+        pcl::toPCLPointCloud2 (cloud, blob);
+        return (writeBinaryCompressedChunked (file_name, blob, cloud.sensor_origin_, cloud.sensor_orientation_));
+      }
+
       /** \brief Save point cloud data to a PCD file containing n-D points, in BINARY format
         * \param[in] file_name the output file name
         * \param[in] cloud the point cloud data message
@@ -603,6 +869,12 @@ namespace pcl
     private:
       /** \brief Set to true if msync() should be called before munmap(). Prevents data loss on NFS systems. */
       bool map_synchronization_;
+
+      /** \brief The number of threads used to compress binary_compressed_chunked files. */
+      unsigned int threads_;
+
+      /** \brief The number of points per chunk of binary_compressed_chunked files. */
+      unsigned int chunk_size_;
   };
 
   namespace io
@@ -45,6 +45,7 @@
 #include <pcl/io/file_io.h>
 #include <pcl/io/ply/ply_parser.h>
 #include <pcl/PolygonMesh.h>
+#include <pcl/TriangleMesh.h>
 
 #include <sstream>
 #include <tuple>
@@ -98,6 +99,7 @@ namespace pcl
         , polygons_ (nullptr)
         , r_(0), g_(0), b_(0)
         , a_(0), rgba_(0)
+        , threads_ (1)
       {}
 
       PLYReader (const PLYReader &p)
@@ -112,6 +114,7 @@ namespace pcl
         , polygons_ (nullptr)
         , r_(0), g_(0), b_(0)
         , a_(0), rgba_(0)
+        , threads_ (1)
       {
         *this = p;
       }
@@ -123,6 +126,7 @@ namespace pcl
         orientation_ = p.orientation_;
         range_grid_ = p.range_grid_;
         polygons_ = p.polygons_;
+        threads_ = p.threads_;
         return (*this);
       }
 
@@ -244,12 +248,33 @@ namespace pcl
       int
       read (const std::string &file_name, pcl::PolygonMesh &mesh, const int offset = 0);
 
+      /** \brief Set the number of threads used to decode the vertices of binary files (default: 1).
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      void
+      setNumberOfThreads (unsigned int nr_threads = 0);
+
     private:
       ::pcl::io::ply::ply_parser parser_;
 
       bool
       parse (const std::string& istream_filename);
 
+      /** \brief Read the vertices of a binary file in bulk, bypassing the callbacks of the parser.
+        *
+        * Only files whose first element is the vertex element, with scalar properties only, and which
+        * have no camera, range_grid or obj_info information are handled. The resultant cloud is the same
+        * as the one built by the callbacks.
+        * \param[in] file_name the name of the file
+        * \param[out] cloud the resultant cloud
+        * \return
+        *  * < 0 (-1) on error
+        *  * == 0 on success
+        *  * > 0 (1) if the file has to be read with the parser
+        */
+      int
+      readBinaryVertices (const std::string &file_name, pcl::PCLPointCloud2 &cloud);
+
       /** \brief Info callback function
         * \param[in] filename PLY file read
         * \param[in] line_number line triggering the callback
@@ -538,6 +563,8 @@ namespace pcl
       std::int32_t r_, g_, b_;
       // Color values stored by vertexAlphaCallback()
       std::uint32_t a_, rgba_;
+      // The number of threads used by readBinaryVertices()
+      unsigned int threads_;
   };
 
   /** \brief Point Cloud Data (PLY) file format writer.
@@ -798,6 +825,22 @@ namespace pcl
       return (p.read (file_name, mesh));
     }
 
+    /** \brief Load a PLY file into a TriangleMesh type. Faces with more than three
+      * vertices are split into triangles.
+      * \param[in] file_name the name of the file to load
+      * \param[in] mesh the resultant triangle mesh
+      * \ingroup io
+      */
+    inline int
+    loadPLYFile (const std::string &file_name, pcl::TriangleMesh &mesh)
+    {
+      pcl::PLYReader p;
+      pcl::PolygonMesh polygon_mesh;
+      const int res = p.read (file_name, polygon_mesh);
+      pcl::toTriangleMesh (std::move (polygon_mesh), mesh);
+      return (res);
+    }
+
     /** \brief Save point cloud data to a PLY file containing n-D points
       * \param[in] file_name the output file name
       * \param[in] cloud the point cloud data message
@@ -891,5 +934,22 @@ namespace pcl
       */
     PCL_EXPORTS int
     savePLYFileBinary (const std::string &file_name, const pcl::PolygonMesh &mesh);
+
+    /** \brief Saves a TriangleMesh in ascii PLY format.
+      * \param[in] file_name the name of the file to write to disk
+      * \param[in] mesh the triangle mesh to save
+      * \param[in] precision the output ASCII precision default 5
+      * \ingroup io
+      */
+    PCL_EXPORTS int
+    savePLYFile (const std::string &file_name, const pcl::TriangleMesh &mesh, unsigned precision = 5);
+
+    /** \brief Saves a TriangleMesh in binary PLY format.
+      * \param[in] file_name the name of the file to write to disk
+      * \param[in] mesh the triangle mesh to save
+      * \ingroup io
+      */
+    PCL_EXPORTS int
+    savePLYFileBinary (const std::string &file_name, const pcl::TriangleMesh &mesh);
   }
 }
@@ -0,0 +1,155 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2014-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#pragma once
+
+#include <pcl/point_cloud.h>
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace pcl
+{
+
+  namespace io
+  {
+
+    /** A pool of point clouds that grabbers recycle between frames.
+      *
+      * get() returns a cleared cloud whose point storage is kept from an earlier
+      * frame, so filling it with a frame of similar size does not allocate. The
+      * returned pointer has a deleter that hands the cloud back to the pool once
+      * the last copy is released, i.e. when every consumer of the frame has let
+      * go of it. Consumers that keep a frame simply delay its reuse.
+      *
+      * At most max_size idle clouds are kept; the pool may be destroyed while
+      * clouds are still in use, they are then freed normally. All methods are
+      * thread-safe.
+      */
+    template <typename PointT>
+    class PointCloudPool
+    {
+      public:
+        using CloudPtr = typename pcl::PointCloud<PointT>::Ptr;
+
+        /** \brief Constructor.
+          * \param[in] max_size the maximum number of idle clouds kept for reuse
+          */
+        explicit PointCloudPool (std::size_t max_size = 4)
+          : storage_ (std::make_shared<Storage> ())
+        {
+          storage_->max_size = max_size;
+        }
+
+        /** \brief Get an empty cloud, reusing an idle one when available. */
+        CloudPtr
+        get ()
+        {
+          std::unique_ptr<pcl::PointCloud<PointT> > cloud;
+          {
+            std::lock_guard<std::mutex> lock (storage_->mutex);
+            if (!storage_->clouds.empty ())
+            {
+              cloud = std::move (storage_->clouds.back ());
+              storage_->clouds.pop_back ();
+            }
+          }
+
+          if (cloud)
+          {
+            // clear () keeps the capacity of the point vector
+            cloud->clear ();
+            cloud->header = pcl::PCLHeader ();
+            cloud->is_dense = true;
+            cloud->sensor_origin_.setZero ();
+            cloud->sensor_orientation_.setIdentity ();
+          }
+          else
+            cloud.reset (new pcl::PointCloud<PointT>);
+
+          return (CloudPtr (cloud.release (), Recycler {storage_}));
+        }
+
+        /** \brief Set the maximum number of idle clouds kept for reuse. */
+        void
+        setMaxSize (std::size_t max_size)
+        {
+          std::lock_guard<std::mutex> lock (storage_->mutex);
+          storage_->max_size = max_size;
+          if (storage_->clouds.size () > max_size)
+            storage_->clouds.resize (max_size);
+        }
+
+        /** \brief Get the number of idle clouds ready for reuse. */
+        std::size_t
+        size () const
+        {
+          std::lock_guard<std::mutex> lock (storage_->mutex);
+          return (storage_->clouds.size ());
+        }
+
+      private:
+        struct Storage
+        {
+          std::mutex mutex;
+          std::vector<std::unique_ptr<pcl::PointCloud<PointT> > > clouds;
+          std::size_t max_size;
+        };
+
+        struct Recycler
+        {
+          std::weak_ptr<Storage> storage;
+
+          void
+          operator() (pcl::PointCloud<PointT> *cloud) const
+          {
+            std::unique_ptr<pcl::PointCloud<PointT> > owned (cloud);
+            if (const auto pool = storage.lock ())
+            {
+              std::lock_guard<std::mutex> lock (pool->mutex);
+              if (pool->clouds.size () < pool->max_size)
+                pool->clouds.push_back (std::move (owned));
+            }
+          }
+        };
+
+        std::shared_ptr<Storage> storage_;
+    };
+  }
+}
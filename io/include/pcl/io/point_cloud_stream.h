@@ -0,0 +1,354 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved
+ */
+
+#pragma once
+
+#include <pcl/compression/octree_pointcloud_compression.h>
+#include <pcl/memory.h>
+#include <pcl/pcl_macros.h>
+#include <pcl/point_cloud.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <utility>
+
+namespace pcl
+{
+  namespace io
+  {
+    /** \brief Server side of a framed TCP channel, which sends the same frames to any number of clients.
+      *
+      * The frames are sent asynchronously by a network thread, \ref publish never blocks on a client. Each
+      * client has a queue of at most \ref setMaximumQueuedFrames frames. When the queue of a slow client is
+      * full, the new frames are dropped for this client until the next key frame, which can be decoded without
+      * the preceding frames. Newly connected clients also start with a key frame. A slow Wi-Fi link thus gets
+      * fewer frames instead of an ever growing latency, and does not hold back the other clients.
+      *
+      * The frames are made of an 8 byte header (magic number, flags and size) followed by the payload,
+      * see StreamClient.
+      * \ingroup io
+      */
+    class PCL_EXPORTS StreamServer
+    {
+      public:
+        using Ptr = shared_ptr<StreamServer>;
+        using ConstPtr = shared_ptr<const StreamServer>;
+
+        /** \brief Constructor.
+          * \param[in] port the TCP port to listen on, 0 for any free port (see \ref getPort)
+          */
+        StreamServer (unsigned short port);
+
+        /** \brief Destructor, stops the server. */
+        ~StreamServer ();
+
+        /** \brief Start accepting clients and sending frames.
+          * \return false if the port could not be opened
+          */
+        bool
+        start ();
+
+        /** \brief Disconnect all clients and stop listening. */
+        void
+        stop ();
+
+        /** \brief Check whether the server is listening. */
+        bool
+        isRunning () const;
+
+        /** \brief Get the port the server listens on, or the port given to the constructor if it is not running. */
+        unsigned short
+        getPort () const;
+
+        /** \brief Get the number of connected clients. */
+        std::size_t
+        getNumberOfClients () const;
+
+        /** \brief Check whether a connected client waits for a key frame, because it just connected or because
+          * frames were dropped for it.
+          */
+        bool
+        isKeyFrameRequested () const;
+
+        /** \brief Set the maximum number of frames queued for each client, including the one being sent.
+          * \param[in] max_queued_frames the queue length, at least 1 (default: 2)
+          */
+        void
+        setMaximumQueuedFrames (std::size_t max_queued_frames);
+
+        /** \brief Get the maximum number of frames queued for each client. */
+        std::size_t
+        getMaximumQueuedFrames () const;
+
+        /** \brief Get the number of frames dropped for slow or new clients since the server was started. */
+        std::size_t
+        getNumberOfDroppedFrames () const;
+
+        /** \brief Queue a frame for all connected clients.
+          * \param[in] payload the frame data, copied once for all clients
+          * \param[in] key_frame whether the frame can be decoded without the preceding frames
+          */
+        void
+        publish (const std::string &payload, bool key_frame);
+
+      private:
+        struct Impl;
+        std::unique_ptr<Impl> impl_;
+    };
+
+    /** \brief Client side of a framed TCP channel, receives the frames sent by a StreamServer.
+      * \ingroup io
+      */
+    class PCL_EXPORTS StreamClient
+    {
+      public:
+        using Ptr = shared_ptr<StreamClient>;
+        using ConstPtr = shared_ptr<const StreamClient>;
+
+        /** \brief Empty constructor. */
+        StreamClient ();
+
+        /** \brief Destructor, closes the connection. */
+        ~StreamClient ();
+
+        /** \brief Connect to a StreamServer.
+          * \param[in] host the host name or address of the server
+          * \param[in] port the port of the server
+          * \return false if the connection failed
+          */
+        bool
+        connect (const std::string &host, unsigned short port);
+
+        /** \brief Close the connection, a pending \ref receive returns false. */
+        void
+        close ();
+
+        /** \brief Check whether the client is connected. */
+        bool
+        isConnected () const;
+
+        /** \brief Wait for the next frame.
+          * \param[out] payload the frame data
+          * \param[out] key_frame whether the frame can be decoded without the preceding frames
+          * \return false if the connection was closed or a malformed frame was received
+          */
+        bool
+        receive (std::string &payload, bool &key_frame);
+
+      private:
+        struct Impl;
+        std::unique_ptr<Impl> impl_;
+    };
+
+    /** \brief Stream codec of PointCloudStreamServer and PointCloudStreamClient based on
+      * OctreePointCloudCompression.
+      *
+      * The online profiles encode differences to the previous frame between the I-frames, a new or a
+      * lagging client resumes at the next I-frame. A codec provides:
+      * - bool encode (const PointCloudConstPtr &cloud, std::ostream &out), returning whether the frame is a
+      *   key frame,
+      * - bool decode (std::istream &in, PointCloudPtr &cloud), returning false on errors.
+      * \ingroup io
+      */
+    template <typename PointT>
+    class OctreeStreamCodec
+    {
+      public:
+        using PointCloud = pcl::PointCloud<PointT>;
+        using PointCloudPtr = typename PointCloud::Ptr;
+        using PointCloudConstPtr = typename PointCloud::ConstPtr;
+        using Compression = OctreePointCloudCompression<PointT>;
+
+        /** \brief Constructor.
+          * \param[in] profile the compression profile of the encoder, not used for decoding
+          */
+        OctreeStreamCodec (compression_Profiles_e profile = MED_RES_ONLINE_COMPRESSION_WITH_COLOR) :
+          compression_ (profile)
+        {
+        }
+
+        /** \brief Encode a point cloud.
+          * \param[in] cloud the point cloud
+          * \param[out] out the compressed frame
+          * \return true for an I-frame
+          */
+        bool
+        encode (const PointCloudConstPtr &cloud, std::ostream &out)
+        {
+          compression_.encodePointCloud (cloud, out);
+          return (compression_.isLastFrameIFrame ());
+        }
+
+        /** \brief Decode a point cloud.
+          * \param[in] in the compressed frame
+          * \param[out] cloud the point cloud
+          */
+        bool
+        decode (std::istream &in, PointCloudPtr &cloud)
+        {
+          compression_.decodePointCloud (in, cloud);
+          return (!in.fail ());
+        }
+
+        /** \brief Get the compression, e.g. to change the entropy coder. */
+        inline Compression&
+        getCompression ()
+        {
+          return (compression_);
+        }
+
+      private:
+        Compression compression_;
+    };
+
+    /** \brief Sends compressed point clouds to any number of network clients, see StreamServer.
+      *
+      * Monitoring a robot over Wi-Fi with the octree compression:
+      * \code
+      * pcl::io::PointCloudStreamServer<pcl::PointXYZRGBA> server (11111);
+      * server.start ();
+      * // in the grabber callback
+      * server.publish (cloud);
+      * \endcode
+      * and on the monitoring side:
+      * \code
+      * pcl::io::PointCloudStreamClient<pcl::PointXYZRGBA> client;
+      * client.connect ("robot", 11111);
+      * pcl::PointCloud<pcl::PointXYZRGBA>::Ptr cloud (new pcl::PointCloud<pcl::PointXYZRGBA>);
+      * while (client.receive (cloud))
+      *   viewer.showCloud (cloud);
+      * \endcode
+      * The point clouds are only encoded while clients are connected.
+      * \note typename: Codec: OctreeStreamCodec, or OrganizedStreamCodec (pcl/io/organized_point_cloud_stream.h)
+      * for the organized clouds of depth cameras
+      * \ingroup io
+      */
+    template <typename PointT, typename Codec = OctreeStreamCodec<PointT> >
+    class PointCloudStreamServer
+    {
+      public:
+        using PointCloud = pcl::PointCloud<PointT>;
+        using PointCloudConstPtr = typename PointCloud::ConstPtr;
+
+        /** \brief Constructor.
+          * \param[in] port the TCP port to listen on, 0 for any free port
+          * \param[in] codec_args the arguments of the encoder constructor, e.g. the compression profile
+          */
+        template <typename... CodecArgs>
+        PointCloudStreamServer (unsigned short port, CodecArgs&&... codec_args) :
+          server_ (port), codec_ (std::forward<CodecArgs> (codec_args)...)
+        {
+        }
+
+        /** \brief Start accepting clients.
+          * \return false if the port could not be opened
+          */
+        inline bool
+        start ()
+        {
+          return (server_.start ());
+        }
+
+        /** \brief Disconnect all clients and stop listening. */
+        inline void
+        stop ()
+        {
+          server_.stop ();
+        }
+
+        /** \brief Encode a point cloud and queue it for all connected clients.
+          * \param[in] cloud the point cloud
+          * \return false if there is no client to send to
+          */
+        bool
+        publish (const PointCloudConstPtr &cloud);
+
+        /** \brief Get the network channel, e.g. to set the queue length. */
+        inline StreamServer&
+        getServer ()
+        {
+          return (server_);
+        }
+
+        /** \brief Get the encoder. */
+        inline Codec&
+        getCodec ()
+        {
+          return (codec_);
+        }
+
+      private:
+        StreamServer server_;
+        Codec codec_;
+    };
+
+    /** \brief Receives the compressed point clouds of a PointCloudStreamServer.
+      * \note typename: Codec: the codec of the server
+      * \ingroup io
+      */
+    template <typename PointT, typename Codec = OctreeStreamCodec<PointT> >
+    class PointCloudStreamClient
+    {
+      public:
+        using PointCloud = pcl::PointCloud<PointT>;
+        using PointCloudPtr = typename PointCloud::Ptr;
+
+        /** \brief Constructor.
+          * \param[in] codec_args the arguments of the decoder constructor
+          */
+        template <typename... CodecArgs>
+        PointCloudStreamClient (CodecArgs&&... codec_args) :
+          codec_ (std::forward<CodecArgs> (codec_args)...)
+        {
+        }
+
+        /** \brief Connect to a PointCloudStreamServer.
+          * \param[in] host the host name or address of the server
+          * \param[in] port the port of the server
+          * \return false if the connection failed
+          */
+        inline bool
+        connect (const std::string &host, unsigned short port)
+        {
+          return (client_.connect (host, port));
+        }
+
+        /** \brief Close the connection, a pending \ref receive returns false. */
+        inline void
+        close ()
+        {
+          client_.close ();
+        }
+
+        /** \brief Wait for the next point cloud and decode it.
+          * \param[out] cloud the point cloud, allocated by the caller
+          * \return false if the connection was closed or a frame could not be decoded
+          */
+        bool
+        receive (PointCloudPtr &cloud);
+
+        /** \brief Get the network channel. */
+        inline StreamClient&
+        getClient ()
+        {
+          return (client_);
+        }
+
+      private:
+        StreamClient client_;
+        Codec codec_;
+        std::string payload_;
+    };
+  }
+}
+
+#include <pcl/io/impl/point_cloud_stream.hpp>
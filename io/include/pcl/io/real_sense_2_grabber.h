@@ -42,6 +42,7 @@
 
 #include <pcl/io/boost.h>
 #include <pcl/io/grabber.h>
+#include <pcl/io/point_cloud_pool.h>
 #include <pcl/point_cloud.h>
 #include <pcl/point_types.h>
 
@@ -159,12 +160,13 @@ namespace pcl
     convertRGBADepthToPointXYZRGBA ( const rs2::points& points, const rs2::video_frame& rgb );
 
     /** \brief template function to convert realsense point cloud to PCL point cloud
+    * \param[in] pool the pool the output cloud is taken from
     * \param[in] points - realsense point cloud array
     * \param[in] mapColorFunc dynamic function to convert individual point color or intensity values
     */
     template <typename PointT, typename Functor>
     typename pcl::PointCloud<PointT>::Ptr
-    convertRealsensePointsToPointCloud ( const rs2::points& points, Functor mapColorFunc );
+    convertRealsensePointsToPointCloud ( pcl::io::PointCloudPool<PointT>& pool, const rs2::points& points, Functor mapColorFunc );
 
     /** \brief Retrieve pixel index for UV texture coordinate
     * \param[in] texture the texture
@@ -213,6 +215,11 @@ namespace pcl
     rs2::pointcloud pc_;
     /** \brief Declare RealSense pipeline, encapsulating the actual device and sensors */
     rs2::pipeline pipe_;
+    /** \brief Pools recycling the clouds passed to the callbacks once they are released */
+    pcl::io::PointCloudPool<pcl::PointXYZ> xyz_pool_;
+    pcl::io::PointCloudPool<pcl::PointXYZI> xyzi_pool_;
+    pcl::io::PointCloudPool<pcl::PointXYZRGB> xyzrgb_pool_;
+    pcl::io::PointCloudPool<pcl::PointXYZRGBA> xyzrgba_pool_;
   };
 
 }
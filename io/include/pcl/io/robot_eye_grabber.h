@@ -40,7 +40,7 @@
 #include "pcl/pcl_config.h"
 
 #include <pcl/io/grabber.h>
-#include <pcl/io/impl/synchronized_queue.hpp>
+#include <pcl/io/impl/packet_ring_buffer.hpp>
 #include <pcl/point_types.h>
 #include <pcl/point_cloud.h>
 #include <pcl/memory.h>
@@ -125,8 +125,9 @@ namespace pcl
       std::size_t signal_point_cloud_size_;
       unsigned short data_port_;
       enum { MAX_LENGTH = 65535 };
+      // Queue slots are sized for one Ethernet frame, larger packets grow their slot once
+      enum { PACKET_QUEUE_SIZE = 1024, PACKET_RESERVE = 1500 };
       unsigned char receive_buffer_[MAX_LENGTH];
-      unsigned int data_size_;
 
       boost::asio::ip::address sensor_address_;
       boost::asio::ip::udp::endpoint sender_endpoint_;
@@ -135,7 +136,7 @@ namespace pcl
       std::shared_ptr<std::thread> socket_thread_;
       std::shared_ptr<std::thread> consumer_thread_;
 
-      pcl::SynchronizedQueue<boost::shared_array<unsigned char> > packet_queue_;
+      pcl::PacketRingBuffer packet_queue_;
       pcl::PointCloud<pcl::PointXYZI>::Ptr point_cloud_xyzi_;
       boost::signals2::signal<sig_cb_robot_eye_point_cloud_xyzi>* point_cloud_signal_;
 
@@ -0,0 +1,149 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved
+ */
+
+#pragma once
+
+#include <pcl/memory.h>
+#include <pcl/pcl_macros.h>
+
+#include <Eigen/Geometry>
+#include <Eigen/StdDeque>
+
+#include <cstddef>
+#include <deque>
+#include <mutex>
+
+namespace pcl
+{
+  namespace io
+  {
+    /** \brief Motion compensation (deskewing) of the sweeps of a spinning LiDAR.
+      *
+      * A sweep of a spinning LiDAR takes e.g. 100 ms, during which a moving sensor travels and turns. The
+      * grabbers assemble the sweeps as if the sensor was static, so the points of a sweep are distorted.
+      * SweepDeskew moves every firing into the frame of the sensor at a reference time (the first firing
+      * of the sweep when used by a grabber), with the pose of the sensor interpolated at the time of the
+      * firing from poses given by e.g. an IMU or an odometry:
+      * \code
+      * auto deskew = std::make_shared<pcl::io::SweepDeskew> ();
+      * grabber.setSweepDeskew (deskew);
+      * // from the pose source, with the time of the LiDAR
+      * deskew->addPose (timestamp, sensor_pose);
+      * \endcode
+      *
+      * The poses are interpolated linearly in translation and spherically in rotation. After the last
+      * pose (and before the first), the motion between the two last (first) poses is extrapolated for at
+      * most \ref setMaximumExtrapolation seconds, so that a pose source lagging a little behind the sensor
+      * does not stall the sweeps. The reference pose is interpolated again for every firing, so it benefits
+      * from the poses added during the sweep. Poses older than the reference time are dropped as the sweeps
+      * advance.
+      *
+      * The methods are thread safe, the poses can be added while a grabber corrects its sweeps.
+      * \ingroup io
+      */
+    class PCL_EXPORTS SweepDeskew
+    {
+      public:
+        using Ptr = shared_ptr<SweepDeskew>;
+        using ConstPtr = shared_ptr<const SweepDeskew>;
+
+        /** \brief Empty constructor. */
+        SweepDeskew ();
+
+        /** \brief Add a pose of the sensor.
+          * \param[in] timestamp the time of the pose in seconds, in the time base of the sensor (see the grabbers)
+          * \param[in] pose the transformation from the sensor frame to a fixed frame
+          * \note The timestamps must increase, a pose not newer than the last one is ignored.
+          */
+        void
+        addPose (double timestamp, const Eigen::Isometry3d &pose);
+
+        /** \brief Remove all the poses and the reference time. */
+        void
+        clear ();
+
+        /** \brief Get the number of stored poses. */
+        std::size_t
+        getNumberOfPoses () const;
+
+        /** \brief Set for how long the motion is extrapolated beyond the first and the last poses.
+          * \param[in] seconds the maximum extrapolation time, 0.1 s by default
+          */
+        void
+        setMaximumExtrapolation (double seconds);
+
+        /** \brief Get the maximum extrapolation time in seconds. */
+        double
+        getMaximumExtrapolation () const;
+
+        /** \brief Get the pose of the sensor at a given time.
+          * \param[in] timestamp the time in seconds
+          * \param[out] pose the interpolated pose
+          * \return false if there is no pose at all
+          */
+        bool
+        getPose (double timestamp, Eigen::Isometry3d &pose) const;
+
+        /** \brief Set the time at which the points are expressed in the sensor frame, the start of a sweep.
+          * \param[in] timestamp the time in seconds
+          */
+        void
+        setReferenceTime (double timestamp);
+
+        /** \brief Check whether a reference time is set. */
+        bool
+        hasReferenceTime () const;
+
+        /** \brief Get the transformation from the sensor frame at a given time to the reference frame.
+          * \param[in] timestamp the time in seconds
+          * \param[out] transform the transformation, identity if there are no poses
+          * \note Without a reference time, \a timestamp becomes the reference time.
+          */
+        void
+        getTransform (double timestamp, Eigen::Isometry3d &transform);
+
+        /** \brief Move the points of one firing into the reference frame.
+          * \param[in] timestamp the time of the firing in seconds
+          * \param[in,out] x the x coordinates of the points
+          * \param[in,out] y the y coordinates of the points
+          * \param[in,out] z the z coordinates of the points
+          * \param[in] count the number of points
+          * \note Without a reference time, \a timestamp becomes the reference time.
+          */
+        void
+        deskew (double timestamp, float *x, float *y, float *z, std::size_t count);
+
+      private:
+        struct TimedPose
+        {
+          double timestamp;
+          Eigen::Quaterniond rotation;
+          Eigen::Vector3d translation;
+        };
+
+        /** \brief Interpolate the pose at a given time, the caller holds the lock. */
+        void
+        interpolate (double timestamp, Eigen::Quaterniond &rotation, Eigen::Vector3d &translation) const;
+
+        mutable std::mutex mutex_;
+
+        /** \brief The poses, by increasing timestamp. */
+        std::deque<TimedPose, Eigen::aligned_allocator<TimedPose> > poses_;
+
+        double max_extrapolation_;
+
+        bool has_reference_;
+
+        double reference_time_;
+
+      public:
+        PCL_MAKE_ALIGNED_OPERATOR_NEW
+    };
+  }
+}
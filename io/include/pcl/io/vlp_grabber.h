@@ -104,6 +104,8 @@ namespace pcl
     protected:
       static const std::uint8_t VLP_MAX_NUM_LASERS = 16;
       static const std::uint8_t VLP_DUAL_MODE = 0x39;
+      /** \brief Time between two firing sequences of the 16 lasers, in seconds */
+      static constexpr double VLP_FIRING_PERIOD = 55.296e-6;
 
     private:
       pcl::RGB laser_rgb_mapping_[VLP_MAX_NUM_LASERS];
@@ -43,6 +43,7 @@
 #include <pcl/pcl_macros.h>
 #include <pcl/PCLPointCloud2.h>
 #include <pcl/PolygonMesh.h>
+#include <pcl/TriangleMesh.h>
 
 // Please do not add any functions that depend on VTK structures to this file!
 // Use vtk_io_lib.h instead.
@@ -60,6 +61,31 @@ namespace pcl
     PCL_EXPORTS int 
     saveVTKFile (const std::string &file_name, const pcl::PolygonMesh &triangles, unsigned precision = 5);
 
+    /** \brief Saves a TriangleMesh in ascii VTK format.
+      * \param[in] file_name the name of the file to write to disk
+      * \param[in] triangles the triangle mesh to save
+      * \param[in] precision the output ASCII precision
+      * \ingroup io
+      */
+    PCL_EXPORTS int
+    saveVTKFile (const std::string &file_name, const pcl::TriangleMesh &triangles, unsigned precision = 5);
+
+    /** \brief Saves a PolygonMesh in binary VTK format (legacy format, big endian data).
+      * \param[in] file_name the name of the file to write to disk
+      * \param[in] triangles the polygonal mesh to save
+      * \ingroup io
+      */
+    PCL_EXPORTS int
+    saveVTKFileBinary (const std::string &file_name, const pcl::PolygonMesh &triangles);
+
+    /** \brief Saves a TriangleMesh in binary VTK format (legacy format, big endian data).
+      * \param[in] file_name the name of the file to write to disk
+      * \param[in] triangles the triangle mesh to save
+      * \ingroup io
+      */
+    PCL_EXPORTS int
+    saveVTKFileBinary (const std::string &file_name, const pcl::TriangleMesh &triangles);
+
     /** \brief Saves a PointCloud in ascii VTK format. 
       * \param[in] file_name the name of the file to write to disk
       * \param[in] cloud the point cloud to save
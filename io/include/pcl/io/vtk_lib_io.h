@@ -107,6 +107,8 @@ namespace pcl
               vtkSmartPointer<vtkPolyData>& poly_data);
 
     /** \brief Load a \ref PolygonMesh object given an input file name, based on the file extension
+      *
+      * The OBJ files are read by the native OBJReader, the other mesh formats through VTK.
       * \param[in] file_name the name of the file containing the polygon data
       * \param[out] mesh the object that we want to load the data in 
       * \ingroup io
@@ -116,6 +118,9 @@ namespace pcl
                      pcl::PolygonMesh& mesh);
 
     /** \brief Save a \ref PolygonMesh object given an input file name, based on the file extension
+      *
+      * The binary VTK and PLY files are written by the native writers (saveVTKFileBinary,
+      * savePLYFileBinary), the other files through VTK.
       * \param[in] file_name the name of the file to save the data to
       * \param[in] mesh the object that contains the data
       * \param[in] binary_format if true, exported file is in binary format
@@ -37,17 +37,25 @@
 
 #include <pcl/common/utils.h> // pcl::utils::ignore
 #include <pcl/io/ascii_io.h>
+#include <pcl/io/ascii_parsing.h>
+#include <algorithm>
+#include <cctype>
 #include <istream>
 #include <fstream>
 #include <boost/filesystem.hpp>
 #include <cstdint>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 //////////////////////////////////////////////////////////////////////////////
 pcl::ASCIIReader::ASCIIReader ()
 {
   extension_ = ".txt";
   sep_chars_ = ", \n\r\t";
   name_ = "AsciiReader";
+  threads_ = 1;
 
   {
     pcl::PCLPointField f;
@@ -109,10 +117,18 @@ pcl::ASCIIReader::readHeader (const std::string& file_name,
   for (std::size_t i = 0; i < fields_.size (); i++) 
     cloud.point_step += typeSize (cloud.fields[i].datatype);
 
-  std::fstream ifile (file_name.c_str (), std::fstream::in);
-  std::string line;
+  // Count the lines by blocks, the same way as std::getline would
+  std::ifstream ifile (file_name.c_str (), std::ios::binary);
+  std::vector<char> buffer (1 << 20);
   int total = 0;
-  while (std::getline (ifile, line))
+  char last = '\n';
+  while (ifile.read (&buffer[0], buffer.size ()) || ifile.gcount () > 0)
+  {
+    const auto end = buffer.cbegin () + ifile.gcount ();
+    total += static_cast<int> (std::count (buffer.cbegin (), end, '\n'));
+    last = *(end - 1);
+  }
+  if (last != '\n')
     total++;
 
   origin = Eigen::Vector4f::Zero ();
@@ -141,41 +157,130 @@ pcl::ASCIIReader::read (
     return (-1);
   cloud.data.resize (cloud.height * cloud.width * cloud.point_step);
 
-  std::string line;
-  std::fstream ifile (file_name.c_str (), std::fstream::in);
-
-  int total=0;
+  std::ifstream ifile (file_name.c_str (), std::ios::binary);
+  pcl::io::LineBlockReader reader (ifile);
+  std::vector<const char*> lines;
+  std::vector<std::uint8_t> valid;
 
-  std::uint8_t* data = &cloud.data[0];
-  while (std::getline (ifile, line))
+  // The lines of each block are parsed in parallel, then the invalid ones are dropped
+  std::size_t total = 0;
+  while (reader.readBlock (lines))
   {
-    boost::algorithm::trim (line);
-    if (line.find_first_not_of ('#') != 0) 
-      continue;   //skip comment lines
+    const std::ptrdiff_t nr_lines = static_cast<std::ptrdiff_t> (lines.size ()) - 1;
+    if ((total + nr_lines) * cloud.point_step > cloud.data.size ())
+      cloud.data.resize ((total + nr_lines) * cloud.point_step);
+    valid.assign (nr_lines, 0);
 
-   std::vector<std::string> tokens;
-   boost::algorithm::split (tokens, line,boost::algorithm::is_any_of (sep_chars_), boost::algorithm::token_compress_on);
+    std::uint8_t* data = &cloud.data[total * cloud.point_step];
+#pragma omp parallel for \
+  default(none) \
+  shared(cloud, data, lines, nr_lines, valid) \
+  num_threads(threads_)
+    for (std::ptrdiff_t i = 0; i < nr_lines; ++i)
+      valid[i] = parseLine (lines[i], lines[i + 1] - 1, data + i * cloud.point_step);
 
-   if (tokens.size () != fields_.size ()) 
-     continue;
-
-   std::uint32_t offset = 0;
-   try
-   {
-     for (std::size_t i = 0; i < fields_.size (); i++) 
-       offset += parse (tokens[i], fields_[i], data + offset);
-   }
-   catch (std::exception& /*e*/)
-   {
-     continue;
-   }
-   data += offset;
-   total++;
+    for (std::ptrdiff_t i = 0; i < nr_lines; ++i)
+    {
+      if (!valid[i])
+        continue;
+      if (&cloud.data[total * cloud.point_step] != data + i * cloud.point_step)
+        memmove (&cloud.data[total * cloud.point_step], data + i * cloud.point_step, cloud.point_step);
+      total++;
+    }
   }
+  // Comments and invalid lines were counted by readHeader
   cloud.data.resize (total * cloud.point_step);
+  cloud.width = static_cast<std::uint32_t> (total);
   return (cloud.width * cloud.height);
 }
 
+//////////////////////////////////////////////////////////////////////////////
+bool
+pcl::ASCIIReader::parseLine (const char *begin, const char *end, std::uint8_t *data_target)
+{
+  // Trim the line, and skip the empty and comment lines
+  while (begin != end && std::isspace (static_cast<unsigned char> (*begin)))
+    ++begin;
+  while (begin != end && std::isspace (static_cast<unsigned char> (*(end - 1))))
+    --end;
+  if (begin == end || *begin == '#')
+    return (false);
+
+  // Split the line at the separators, consecutive separators count as one
+  const auto is_separator = [this] (char c) { return (sep_chars_.find (c) != std::string::npos); };
+  const char *token = begin;
+  std::uint32_t offset = 0;
+  for (std::size_t i = 0; i < fields_.size (); i++)
+  {
+    if (i > 0)
+    {
+      // The previous token ended at a separator, the line must go on
+      if (token == end)
+        return (false);
+      while (token != end && is_separator (*token))
+        ++token;
+    }
+    const char *token_end = token;
+    while (token_end != end && !is_separator (*token_end))
+      ++token_end;
+
+    bool parsed = false;
+    switch (fields_[i].datatype)
+    {
+      // Single characters are parsed as characters by lexical_cast, not as numbers
+      case pcl::PCLPointField::INT16:
+        parsed = pcl::io::parseNumber (token, token_end, *reinterpret_cast<std::int16_t*> (data_target + offset));
+        break;
+      case pcl::PCLPointField::UINT16:
+        parsed = pcl::io::parseNumber (token, token_end, *reinterpret_cast<std::uint16_t*> (data_target + offset));
+        break;
+      case pcl::PCLPointField::INT32:
+        parsed = pcl::io::parseNumber (token, token_end, *reinterpret_cast<std::int32_t*> (data_target + offset));
+        break;
+      case pcl::PCLPointField::UINT32:
+        parsed = pcl::io::parseNumber (token, token_end, *reinterpret_cast<std::uint32_t*> (data_target + offset));
+        break;
+      case pcl::PCLPointField::FLOAT32:
+        parsed = pcl::io::parseNumber (token, token_end, *reinterpret_cast<float*> (data_target + offset));
+        break;
+      case pcl::PCLPointField::FLOAT64:
+        parsed = pcl::io::parseNumber (token, token_end, *reinterpret_cast<double*> (data_target + offset));
+        break;
+    }
+    if (parsed)
+      offset += typeSize (fields_[i].datatype);
+    else
+    {
+      try
+      {
+        offset += parse (std::string (token, token_end), fields_[i], data_target + offset);
+      }
+      catch (std::exception& /*e*/)
+      {
+        return (false);
+      }
+    }
+    token = token_end;
+  }
+
+  // Lines with more tokens than fields are skipped
+  return (token == end);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+void
+pcl::ASCIIReader::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs ();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
+
 //////////////////////////////////////////////////////////////////////////////
 void
 pcl::ASCIIReader::setInputFields (const std::vector<pcl::PCLPointField>& fields)
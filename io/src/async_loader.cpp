@@ -0,0 +1,129 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved
+ */
+
+#include <pcl/io/async_loader.h>
+#include <pcl/io/auto_io.h>
+#include <pcl/io/boost.h>
+#include <pcl/io/pcd_io.h>
+#include <pcl/io/ply_io.h>
+
+#include <algorithm>
+#include <cctype>
+
+///////////////////////////////////////////////////////////////////////////////////////////
+pcl::io::AsyncLoader::AsyncLoader (unsigned int nr_threads, std::size_t queue_size)
+  : queue_size_ (std::max<std::size_t> (queue_size, 1))
+  , stop_ (false)
+{
+  if (nr_threads == 0)
+    nr_threads = std::max (std::thread::hardware_concurrency (), 1u);
+  threads_.reserve (nr_threads);
+  for (unsigned int i = 0; i < nr_threads; ++i)
+    threads_.emplace_back (&AsyncLoader::run, this);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+pcl::io::AsyncLoader::~AsyncLoader ()
+{
+  {
+    std::lock_guard<std::mutex> lock (mutex_);
+    stop_ = true;
+  }
+  queue_not_empty_.notify_all ();
+  for (auto &thread : threads_)
+    thread.join ();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+std::future<int>
+pcl::io::AsyncLoader::load (const std::string &file_name, pcl::PCLPointCloud2 &cloud,
+                            Eigen::Vector4f &origin, Eigen::Quaternionf &orientation)
+{
+  return (enqueue (std::packaged_task<int ()> ([file_name, &cloud, &origin, &orientation] ()
+  {
+    return (loadFile (file_name, cloud, origin, orientation));
+  })));
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+std::future<int>
+pcl::io::AsyncLoader::load (const std::string &file_name, pcl::PCLPointCloud2 &cloud)
+{
+  return (enqueue (std::packaged_task<int ()> ([file_name, &cloud] ()
+  {
+    Eigen::Vector4f origin;
+    Eigen::Quaternionf orientation;
+    return (loadFile (file_name, cloud, origin, orientation));
+  })));
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+std::future<int>
+pcl::io::AsyncLoader::loadPCD (const std::string &file_name, int offset, pcl::PCLPointCloud2 &cloud,
+                               Eigen::Vector4f &origin, Eigen::Quaternionf &orientation)
+{
+  return (enqueue (std::packaged_task<int ()> ([file_name, offset, &cloud, &origin, &orientation] ()
+  {
+    int version;
+    return (pcl::PCDReader ().read (file_name, cloud, origin, orientation, version, offset));
+  })));
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+int
+pcl::io::AsyncLoader::loadFile (const std::string &file_name, pcl::PCLPointCloud2 &cloud,
+                                Eigen::Vector4f &origin, Eigen::Quaternionf &orientation)
+{
+  std::string extension = boost::filesystem::path (file_name).extension ().string ();
+  std::transform (extension.begin (), extension.end (), extension.begin (), ::tolower);
+
+  origin = Eigen::Vector4f::Zero ();
+  orientation = Eigen::Quaternionf::Identity ();
+  int version;
+  if (extension == ".pcd")
+    return (pcl::PCDReader ().read (file_name, cloud, origin, orientation, version));
+  if (extension == ".ply")
+    return (pcl::PLYReader ().read (file_name, cloud, origin, orientation, version));
+  return (pcl::io::load (file_name, cloud));
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+std::future<int>
+pcl::io::AsyncLoader::enqueue (std::packaged_task<int ()> &&task)
+{
+  std::future<int> result = task.get_future ();
+  {
+    std::unique_lock<std::mutex> lock (mutex_);
+    queue_not_full_.wait (lock, [this] { return (queue_.size () < queue_size_); });
+    queue_.push_back (std::move (task));
+  }
+  queue_not_empty_.notify_one ();
+  return (result);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::io::AsyncLoader::run ()
+{
+  while (true)
+  {
+    std::packaged_task<int ()> task;
+    {
+      std::unique_lock<std::mutex> lock (mutex_);
+      queue_not_empty_.wait (lock, [this] { return (stop_ || !queue_.empty ()); });
+      // Leave only once all the queued files are loaded, so that no future is left without a value
+      if (queue_.empty ())
+        return;
+      task = std::move (queue_.front ());
+      queue_.pop_front ();
+    }
+    queue_not_full_.notify_one ();
+    task ();
+  }
+}
@@ -46,9 +46,22 @@
 #include <pcl/compression/impl/octree_pointcloud_compression.hpp>
 
 template class PCL_EXPORTS pcl::io::OctreePointCloudCompression<pcl::PointXYZ>;
+template class PCL_EXPORTS pcl::io::OctreePointCloudCompression<pcl::PointXYZI>;
 template class PCL_EXPORTS pcl::io::OctreePointCloudCompression<pcl::PointXYZRGB>;
 template class PCL_EXPORTS pcl::io::OctreePointCloudCompression<pcl::PointXYZRGBA>;
 
+#include <pcl/compression/octree_compression_archive.h>
+#include <pcl/compression/impl/octree_compression_archive.hpp>
+
+template class PCL_EXPORTS pcl::io::OctreeCompressionArchiveWriter<pcl::PointXYZ>;
+template class PCL_EXPORTS pcl::io::OctreeCompressionArchiveWriter<pcl::PointXYZI>;
+template class PCL_EXPORTS pcl::io::OctreeCompressionArchiveWriter<pcl::PointXYZRGB>;
+template class PCL_EXPORTS pcl::io::OctreeCompressionArchiveWriter<pcl::PointXYZRGBA>;
+template class PCL_EXPORTS pcl::io::OctreeCompressionArchiveReader<pcl::PointXYZ>;
+template class PCL_EXPORTS pcl::io::OctreeCompressionArchiveReader<pcl::PointXYZI>;
+template class PCL_EXPORTS pcl::io::OctreeCompressionArchiveReader<pcl::PointXYZRGB>;
+template class PCL_EXPORTS pcl::io::OctreeCompressionArchiveReader<pcl::PointXYZRGBA>;
+
 #ifdef HAVE_PNG
 #ifdef HAVE_OPENNI
 #include <pcl/compression/organized_pointcloud_compression.h>
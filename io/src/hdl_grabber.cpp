@@ -60,18 +60,24 @@ using boost::asio::ip::udp;
 pcl::HDLGrabber::HDLGrabber (const std::string& correctionsFile,
                              const std::string& pcapFile) :
     last_azimuth_ (65000),
+    sweep_counter_ (0),
+    current_sweep_size_ (0),
+    decoded_clouds_ (ALL_CLOUDS),
     current_scan_xyz_ (new pcl::PointCloud<pcl::PointXYZ> ()),
     current_sweep_xyz_ (new pcl::PointCloud<pcl::PointXYZ> ()),
     current_scan_xyzi_ (new pcl::PointCloud<pcl::PointXYZI> ()),
     current_sweep_xyzi_ (new pcl::PointCloud<pcl::PointXYZI> ()),
     current_scan_xyzrgba_ (new pcl::PointCloud<pcl::PointXYZRGBA> ()),
     current_sweep_xyzrgba_ (new pcl::PointCloud<pcl::PointXYZRGBA> ()),
+    last_gps_timestamp_ (0),
+    gps_time_offset_ (0.0),
     sweep_xyz_signal_ (),
     sweep_xyzrgba_signal_ (),
     sweep_xyzi_signal_ (),
     scan_xyz_signal_ (),
     scan_xyzrgba_signal_ (),
     scan_xyzi_signal_ (),
+    hdl_data_ (HDL_PACKET_QUEUE_SIZE, HDL_PACKET_SIZE),
     source_address_filter_ (),
     source_port_filter_ (443),
     hdl_read_socket_service_ (),
@@ -80,7 +86,8 @@ pcl::HDLGrabber::HDLGrabber (const std::string& correctionsFile,
     queue_consumer_thread_ (nullptr),
     hdl_read_packet_thread_ (nullptr),
     min_distance_threshold_ (0.0),
-    max_distance_threshold_ (10000.0)
+    max_distance_threshold_ (10000.0),
+    decode_connected_only_ (true)
 {
   initialize (correctionsFile);
 }
@@ -90,18 +97,24 @@ pcl::HDLGrabber::HDLGrabber (const boost::asio::ip::address& ipAddress,
                              const std::uint16_t port,
                              const std::string& correctionsFile) :
     last_azimuth_ (65000),
+    sweep_counter_ (0),
+    current_sweep_size_ (0),
+    decoded_clouds_ (ALL_CLOUDS),
     current_scan_xyz_ (new pcl::PointCloud<pcl::PointXYZ> ()),
     current_sweep_xyz_ (new pcl::PointCloud<pcl::PointXYZ> ()),
     current_scan_xyzi_ (new pcl::PointCloud<pcl::PointXYZI> ()),
     current_sweep_xyzi_ (new pcl::PointCloud<pcl::PointXYZI> ()),
     current_scan_xyzrgba_ (new pcl::PointCloud<pcl::PointXYZRGBA> ()),
     current_sweep_xyzrgba_ (new pcl::PointCloud<pcl::PointXYZRGBA> ()),
+    last_gps_timestamp_ (0),
+    gps_time_offset_ (0.0),
     sweep_xyz_signal_ (),
     sweep_xyzrgba_signal_ (),
     sweep_xyzi_signal_ (),
     scan_xyz_signal_ (),
     scan_xyzrgba_signal_ (),
     scan_xyzi_signal_ (),
+    hdl_data_ (HDL_PACKET_QUEUE_SIZE, HDL_PACKET_SIZE),
     udp_listener_endpoint_ (ipAddress, port),
     source_address_filter_ (),
     source_port_filter_ (443),
@@ -110,7 +123,8 @@ pcl::HDLGrabber::HDLGrabber (const boost::asio::ip::address& ipAddress,
     queue_consumer_thread_ (nullptr),
     hdl_read_packet_thread_ (nullptr),
     min_distance_threshold_ (0.0),
-    max_distance_threshold_ (10000.0)
+    max_distance_threshold_ (10000.0),
+    decode_connected_only_ (true)
 {
   initialize (correctionsFile);
 }
@@ -152,6 +166,7 @@ pcl::HDLGrabber::initialize (const std::string& correctionsFile)
     laser_correction.sinVertOffsetCorrection = correction.verticalOffsetCorrection * correction.sinVertCorrection;
     laser_correction.cosVertOffsetCorrection = correction.verticalOffsetCorrection * correction.cosVertCorrection;
   }
+  updateLaserTables ();
   sweep_xyz_signal_ = createSignal<sig_cb_velodyne_hdl_sweep_point_cloud_xyz> ();
   sweep_xyzrgba_signal_ = createSignal<sig_cb_velodyne_hdl_sweep_point_cloud_xyzrgba> ();
   sweep_xyzi_signal_ = createSignal<sig_cb_velodyne_hdl_sweep_point_cloud_xyzi> ();
@@ -295,16 +310,9 @@ pcl::HDLGrabber::getDefaultNetworkAddress ()
 void
 pcl::HDLGrabber::processVelodynePackets ()
 {
-  while (true)
-  {
-    std::uint8_t *data;
-    if (!hdl_data_.dequeue (data))
-      return;
-
-    toPointClouds (reinterpret_cast<HDLDataPacket *> (data));
-
-    free (data);
-  }
+  std::vector<std::uint8_t> data;
+  while (hdl_data_.dequeue (data))
+    toPointClouds (reinterpret_cast<HDLDataPacket *> (data.data ()));
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -312,13 +320,14 @@ void
 pcl::HDLGrabber::toPointClouds (HDLDataPacket *dataPacket)
 {
   static std::uint32_t scan_counter = 0;
-  static std::uint32_t sweep_counter = 0;
   if (sizeof(HDLLaserReturn) != 3)
     return;
 
-  current_scan_xyz_.reset (new pcl::PointCloud<pcl::PointXYZ> ());
-  current_scan_xyzrgba_.reset (new pcl::PointCloud<pcl::PointXYZRGBA> ());
-  current_scan_xyzi_.reset (new pcl::PointCloud<pcl::PointXYZI> ());
+  updateDecodedClouds ();
+
+  current_scan_xyz_ = scan_xyz_pool_.get ();
+  current_scan_xyzrgba_ = scan_xyzrgba_pool_.get ();
+  current_scan_xyzi_ = scan_xyzi_pool_.get ();
 
   time_t system_time;
   time (&system_time);
@@ -332,63 +341,208 @@ pcl::HDLGrabber::toPointClouds (HDLDataPacket *dataPacket)
   current_scan_xyzi_->header.seq = scan_counter;
   scan_counter++;
 
+  const double packet_time = getPacketTime (dataPacket->gpsTimestamp);
+  int firing_index = -1;
+  std::uint16_t firing_azimuth = 0;
+
+  HDLDecodedReturns decoded;
   for (const auto &firing_data : dataPacket->firingData)
   {
     std::uint8_t offset = (firing_data.blockIdentifier == BLOCK_0_TO_31) ? 0 : 32;
 
+    // The upper and lower blocks of the HDL-64 fire together, at the same azimuth
+    if (firing_index < 0 || firing_data.rotationalPosition != firing_azimuth)
+    {
+      ++firing_index;
+      firing_azimuth = firing_data.rotationalPosition;
+    }
+    const double firing_time = packet_time + firing_index * HDL_FIRING_PERIOD;
+
+    if (firing_data.rotationalPosition < last_azimuth_)
+    {
+      startNewSweep (velodyne_time);
+      if (sweep_deskew_)
+        sweep_deskew_->setReferenceTime (firing_time);
+    }
+
+    decodeReturns (firing_data.laserReturns, HDL_LASER_PER_FIRING, offset, firing_data.rotationalPosition, decoded);
+    if (sweep_deskew_)
+      sweep_deskew_->deskew (firing_time, decoded.x, decoded.y, decoded.z, HDL_LASER_PER_FIRING);
+
     for (std::uint8_t j = 0; j < HDL_LASER_PER_FIRING; j++)
     {
-      if (firing_data.rotationalPosition < last_azimuth_)
-      {
-        if (!current_sweep_xyzrgba_->empty ())
-        {
-          current_sweep_xyz_->is_dense = current_sweep_xyzrgba_->is_dense = current_sweep_xyzi_->is_dense = false;
-          current_sweep_xyz_->header.stamp = velodyne_time;
-          current_sweep_xyzrgba_->header.stamp = velodyne_time;
-          current_sweep_xyzi_->header.stamp = velodyne_time;
-          current_sweep_xyz_->header.seq = sweep_counter;
-          current_sweep_xyzrgba_->header.seq = sweep_counter;
-          current_sweep_xyzi_->header.seq = sweep_counter;
+      if (std::isnan (decoded.x[j]))
+        continue;
 
-          sweep_counter++;
+      appendPoint (decoded, j, laser_rgb_mapping_[j + offset], true);
+      last_azimuth_ = firing_data.rotationalPosition;
+    }
+  }
 
-          fireCurrentSweep ();
-        }
-        current_sweep_xyz_.reset (new pcl::PointCloud<pcl::PointXYZ> ());
-        current_sweep_xyzrgba_.reset (new pcl::PointCloud<pcl::PointXYZRGBA> ());
-        current_sweep_xyzi_.reset (new pcl::PointCloud<pcl::PointXYZI> ());
-      }
+  current_scan_xyz_->is_dense = current_scan_xyzrgba_->is_dense = current_scan_xyzi_->is_dense = true;
+  fireCurrentScan (dataPacket->firingData[0].rotationalPosition, dataPacket->firingData[11].rotationalPosition);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void
+pcl::HDLGrabber::updateLaserTables ()
+{
+  for (std::uint8_t i = 0; i < HDL_MAX_NUM_LASERS; i++)
+  {
+    const HDLLaserCorrection &correction = laser_corrections_[i];
+    laser_tables_.cos_vert[i] = static_cast<float> (correction.cosVertCorrection);
+    laser_tables_.sin_vert[i] = static_cast<float> (correction.sinVertCorrection);
+    laser_tables_.distance[i] = static_cast<float> (correction.distanceCorrection);
+    laser_tables_.horizontal_offset[i] = static_cast<float> (correction.horizontalOffsetCorrection);
+    laser_tables_.vertical_offset[i] = static_cast<float> (correction.verticalOffsetCorrection);
+    laser_tables_.cos_azimuth[i] = static_cast<float> (std::cos (HDL_Grabber_toRadians (correction.azimuthCorrection)));
+    laser_tables_.sin_azimuth[i] = static_cast<float> (std::sin (HDL_Grabber_toRadians (correction.azimuthCorrection)));
+  }
+}
 
-      PointXYZ xyz;
-      PointXYZI xyzi;
-      PointXYZRGBA xyzrgba;
+/////////////////////////////////////////////////////////////////////////////
+void
+pcl::HDLGrabber::updateDecodedClouds ()
+{
+  if (!decode_connected_only_)
+  {
+    decoded_clouds_ = ALL_CLOUDS;
+    return;
+  }
 
-      computeXYZI (xyzi, firing_data.rotationalPosition, firing_data.laserReturns[j], laser_corrections_[j + offset]);
+  decoded_clouds_ = 0;
+  if (scan_xyz_signal_->num_slots () > 0)
+    decoded_clouds_ |= SCAN_XYZ;
+  if (scan_xyzi_signal_->num_slots () > 0)
+    decoded_clouds_ |= SCAN_XYZI;
+  if (scan_xyzrgba_signal_->num_slots () > 0)
+    decoded_clouds_ |= SCAN_XYZRGBA;
+  if (sweep_xyz_signal_->num_slots () > 0)
+    decoded_clouds_ |= SWEEP_XYZ;
+  if (sweep_xyzi_signal_->num_slots () > 0)
+    decoded_clouds_ |= SWEEP_XYZI;
+  if (sweep_xyzrgba_signal_->num_slots () > 0)
+    decoded_clouds_ |= SWEEP_XYZRGBA;
+}
 
-      xyz.x = xyzrgba.x = xyzi.x;
-      xyz.y = xyzrgba.y = xyzi.y;
-      xyz.z = xyzrgba.z = xyzi.z;
+/////////////////////////////////////////////////////////////////////////////
+void
+pcl::HDLGrabber::decodeReturns (const HDLLaserReturn *returns,
+                                std::uint8_t count,
+                                std::uint8_t first_laser,
+                                std::uint16_t azimuth,
+                                HDLDecodedReturns &decoded) const
+{
+  if (azimuth >= HDL_NUM_ROT_ANGLES)
+    azimuth = static_cast<std::uint16_t> (azimuth % 36000);
+  const float cos_azimuth = static_cast<float> (cos_lookup_table_[azimuth]);
+  const float sin_azimuth = static_cast<float> (sin_lookup_table_[azimuth]);
+
+  // Unpack the 3 byte returns first so that the arithmetic below runs on plain arrays
+  float distance[HDL_LASER_PER_FIRING];
+  for (std::uint8_t i = 0; i < count; i++)
+  {
+    distance[i] = static_cast<float> (returns[i].distance) * 0.002f;
+    decoded.intensity[i] = static_cast<float> (returns[i].intensity);
+  }
 
-      xyzrgba.rgba = laser_rgb_mapping_[j + offset].rgba;
-      if (std::isnan (xyz.x) || std::isnan (xyz.y) || std::isnan (xyz.z))
-      {
-        continue;
-      }
+  const float *cos_vert = laser_tables_.cos_vert + first_laser;
+  const float *sin_vert = laser_tables_.sin_vert + first_laser;
+  const float *distance_correction = laser_tables_.distance + first_laser;
+  const float *horizontal_offset = laser_tables_.horizontal_offset + first_laser;
+  const float *vertical_offset = laser_tables_.vertical_offset + first_laser;
+  const float *cos_correction = laser_tables_.cos_azimuth + first_laser;
+  const float *sin_correction = laser_tables_.sin_azimuth + first_laser;
+  const float min_distance = min_distance_threshold_;
+  const float max_distance = max_distance_threshold_;
+  const float bad_point = std::numeric_limits<float>::quiet_NaN ();
+
+  for (std::uint8_t i = 0; i < count; i++)
+  {
+    const bool in_range = (distance[i] >= min_distance) & (distance[i] <= max_distance);
+    const float d = distance[i] + distance_correction[i];
+
+    // cos and sin of (azimuth - azimuth correction)
+    const float cos_a = cos_azimuth * cos_correction[i] + sin_azimuth * sin_correction[i];
+    const float sin_a = sin_azimuth * cos_correction[i] - cos_azimuth * sin_correction[i];
+
+    const float xy_distance = d * cos_vert[i];
+    const float x = xy_distance * sin_a - horizontal_offset[i] * cos_a;
+    const float y = xy_distance * cos_a + horizontal_offset[i] * sin_a;
+    const float z = d * sin_vert[i] + vertical_offset[i];
+
+    // Bitwise operators keep the loop free of branches
+    const bool valid = in_range & ((x != 0.0f) | (y != 0.0f) | (z != 0.0f));
+    decoded.x[i] = valid ? x : bad_point;
+    decoded.y[i] = valid ? y : bad_point;
+    decoded.z[i] = valid ? z : bad_point;
+  }
+}
 
-      current_scan_xyz_->push_back (xyz);
-      current_scan_xyzi_->push_back (xyzi);
-      current_scan_xyzrgba_->push_back (xyzrgba);
+/////////////////////////////////////////////////////////////////////////////
+void
+pcl::HDLGrabber::startNewSweep (time_t stamp)
+{
+  if (current_sweep_size_ > 0)
+  {
+    current_sweep_xyz_->is_dense = current_sweep_xyzrgba_->is_dense = current_sweep_xyzi_->is_dense = false;
+    current_sweep_xyz_->header.stamp = stamp;
+    current_sweep_xyzrgba_->header.stamp = stamp;
+    current_sweep_xyzi_->header.stamp = stamp;
+    current_sweep_xyz_->header.seq = sweep_counter_;
+    current_sweep_xyzrgba_->header.seq = sweep_counter_;
+    current_sweep_xyzi_->header.seq = sweep_counter_;
+
+    sweep_counter_++;
+
+    fireCurrentSweep ();
+  }
+  current_sweep_xyz_ = sweep_xyz_pool_.get ();
+  current_sweep_xyzrgba_ = sweep_xyzrgba_pool_.get ();
+  current_sweep_xyzi_ = sweep_xyzi_pool_.get ();
+  current_sweep_size_ = 0;
+}
 
+/////////////////////////////////////////////////////////////////////////////
+void
+pcl::HDLGrabber::appendPoint (const HDLDecodedReturns &decoded,
+                              std::uint8_t index,
+                              const pcl::RGB &color,
+                              bool add_to_scan)
+{
+  const float x = decoded.x[index];
+  const float y = decoded.y[index];
+  const float z = decoded.z[index];
+
+  if (decoded_clouds_ & (SCAN_XYZ | SWEEP_XYZ))
+  {
+    const pcl::PointXYZ xyz (x, y, z);
+    if (add_to_scan && (decoded_clouds_ & SCAN_XYZ))
+      current_scan_xyz_->push_back (xyz);
+    if (decoded_clouds_ & SWEEP_XYZ)
       current_sweep_xyz_->push_back (xyz);
+  }
+  if (decoded_clouds_ & (SCAN_XYZI | SWEEP_XYZI))
+  {
+    const pcl::PointXYZI xyzi (x, y, z, decoded.intensity[index]);
+    if (add_to_scan && (decoded_clouds_ & SCAN_XYZI))
+      current_scan_xyzi_->push_back (xyzi);
+    if (decoded_clouds_ & SWEEP_XYZI)
       current_sweep_xyzi_->push_back (xyzi);
+  }
+  if (decoded_clouds_ & (SCAN_XYZRGBA | SWEEP_XYZRGBA))
+  {
+    pcl::PointXYZRGBA xyzrgba;
+    xyzrgba.x = x;
+    xyzrgba.y = y;
+    xyzrgba.z = z;
+    xyzrgba.rgba = color.rgba;
+    if (add_to_scan && (decoded_clouds_ & SCAN_XYZRGBA))
+      current_scan_xyzrgba_->push_back (xyzrgba);
+    if (decoded_clouds_ & SWEEP_XYZRGBA)
       current_sweep_xyzrgba_->push_back (xyzrgba);
-
-      last_azimuth_ = firing_data.rotationalPosition;
-    }
   }
-
-  current_scan_xyz_->is_dense = current_scan_xyzrgba_->is_dense = current_scan_xyzi_->is_dense = true;
-  fireCurrentScan (dataPacket->firingData[0].rotationalPosition, dataPacket->firingData[11].rotationalPosition);
+  current_sweep_size_++;
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -471,13 +625,8 @@ void
 pcl::HDLGrabber::enqueueHDLPacket (const std::uint8_t *data,
                                    std::size_t bytesReceived)
 {
-  if (bytesReceived == 1206)
-  {
-    std::uint8_t *dup = static_cast<std::uint8_t *> (malloc (bytesReceived * sizeof(std::uint8_t)));
-    memcpy (dup, data, bytesReceived * sizeof (std::uint8_t));
-
-    hdl_data_.enqueue (dup);
-  }
+  if (bytesReceived == HDL_PACKET_SIZE)
+    hdl_data_.enqueue (data, bytesReceived);
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -561,6 +710,52 @@ pcl::HDLGrabber::isRunning () const
   return (!hdl_data_.isEmpty () || hdl_read_packet_thread_);
 }
 
+/////////////////////////////////////////////////////////////////////////////
+std::size_t
+pcl::HDLGrabber::getDroppedPacketCount () const
+{
+  return (hdl_data_.getDroppedPackets ());
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void
+pcl::HDLGrabber::setDecodeConnectedCloudsOnly (const bool connected_only)
+{
+  decode_connected_only_ = connected_only;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+bool
+pcl::HDLGrabber::getDecodeConnectedCloudsOnly () const
+{
+  return (decode_connected_only_);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void
+pcl::HDLGrabber::setSweepDeskew (const pcl::io::SweepDeskew::Ptr &deskew)
+{
+  sweep_deskew_ = deskew;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+pcl::io::SweepDeskew::Ptr
+pcl::HDLGrabber::getSweepDeskew () const
+{
+  return (sweep_deskew_);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+double
+pcl::HDLGrabber::getPacketTime (std::uint32_t gps_timestamp)
+{
+  // The timestamp goes back to 0 at the top of every hour
+  if (last_gps_timestamp_ > gps_timestamp && last_gps_timestamp_ - gps_timestamp > 1800000000u)
+    gps_time_offset_ += 3600.0;
+  last_gps_timestamp_ = gps_timestamp;
+  return (gps_time_offset_ + static_cast<double> (gps_timestamp) * 1e-6);
+}
+
 /////////////////////////////////////////////////////////////////////////////
 std::string
 pcl::HDLGrabber::getName () const
@@ -113,7 +113,7 @@ pcl::io::LZFImageWriter::compress (const char* input,
                                    std::uint32_t width,
                                    std::uint32_t height,
                                    const std::string &image_type,
-                                   char *output)
+                                   char *output) const
 {
   static const int header_size = LZF_HEADER_SIZE;
   float finput_size = static_cast<float> (uncompressed_size);
@@ -149,31 +149,42 @@ pcl::io::LZFImageWriter::compress (const char* input,
   return (compressed_final_size);
 }
 
+//////////////////////////////////////////////////////////////////////////////
+bool
+pcl::io::LZFImageWriter::compress (const char* input,
+                                   std::uint32_t uncompressed_size,
+                                   std::uint32_t width,
+                                   std::uint32_t height,
+                                   const std::string &image_type,
+                                   std::vector<char> &blob) const
+{
+  blob.resize (std::size_t (float (uncompressed_size) * 1.5f + float (LZF_HEADER_SIZE)));
+  std::uint32_t compressed_size = compress (input, uncompressed_size, width, height, image_type, blob.data ());
+  blob.resize (compressed_size);
+  return (compressed_size != 0);
+}
+
 //////////////////////////////////////////////////////////////////////////////
 bool
 pcl::io::LZFDepth16ImageWriter::write (const char* data,
                                        std::uint32_t width, std::uint32_t height,
                                        const std::string &filename)
 {
-  // Prepare the compressed depth buffer
-  unsigned int depth_size = width * height * 2;
-  char* compressed_depth = static_cast<char*> (malloc (std::size_t (float (depth_size) * 1.5f + float (LZF_HEADER_SIZE))));
-
-  std::size_t compressed_size = compress (data,
-                                     depth_size,
-                                     width, height,
-                                     "depth16",
-                                     compressed_depth);
-  if (compressed_size == 0)
-  {
-    free (compressed_depth);
+  std::vector<char> compressed_depth;
+  if (!encode (data, width, height, compressed_depth))
     return (false);
-  }
 
   // Save the actual image
-  saveImageBlob (compressed_depth, compressed_size, filename);
-  free (compressed_depth);
-  return (true);
+  return (saveImageBlob (compressed_depth.data (), compressed_depth.size (), filename));
+}
+
+//////////////////////////////////////////////////////////////////////////////
+bool
+pcl::io::LZFDepth16ImageWriter::encode (const char* data,
+                                        std::uint32_t width, std::uint32_t height,
+                                        std::vector<char> &blob) const
+{
+  return (compress (data, width * height * 2, width, height, "depth16", blob));
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -224,6 +235,20 @@ bool
 pcl::io::LZFRGB24ImageWriter::write (const char *data, 
                                      std::uint32_t width, std::uint32_t height,
                                      const std::string &filename)
+{
+  std::vector<char> compressed_rgb;
+  if (!encode (data, width, height, compressed_rgb))
+    return (false);
+
+  // Save the actual image
+  return (saveImageBlob (compressed_rgb.data (), compressed_rgb.size (), filename));
+}
+
+//////////////////////////////////////////////////////////////////////////////
+bool
+pcl::io::LZFRGB24ImageWriter::encode (const char *data,
+                                      std::uint32_t width, std::uint32_t height,
+                                      std::vector<char> &blob) const
 {
   // Transform RGBRGB into RRGGBB for better compression
   std::vector<char> rrggbb (width * height * 3);
@@ -237,23 +262,11 @@ pcl::io::LZFRGB24ImageWriter::write (const char *data,
     rrggbb[ptr3] = data[i * 3 + 2];
   }
 
-  char* compressed_rgb = static_cast<char*> (malloc (std::size_t (float (rrggbb.size ()) * 1.5f + float (LZF_HEADER_SIZE))));
-  std::size_t compressed_size = compress (reinterpret_cast<const char*> (&rrggbb[0]), 
-                                     std::uint32_t (rrggbb.size ()),
-                                     width, height,
-                                     "rgb24",
-                                     compressed_rgb);
-
-  if (compressed_size == 0)
-  {
-    free (compressed_rgb);
-    return (false);
-  }
-
-  // Save the actual image
-  saveImageBlob (compressed_rgb, compressed_size, filename);
-  free (compressed_rgb);
-  return (true);
+  return (compress (reinterpret_cast<const char*> (&rrggbb[0]), 
+                    std::uint32_t (rrggbb.size ()),
+                    width, height,
+                    "rgb24",
+                    blob));
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -283,6 +296,20 @@ bool
 pcl::io::LZFYUV422ImageWriter::write (const char *data, 
                                       std::uint32_t width, std::uint32_t height,
                                       const std::string &filename)
+{
+  std::vector<char> compressed_yuv;
+  if (!encode (data, width, height, compressed_yuv))
+    return (false);
+
+  // Save the actual image
+  return (saveImageBlob (compressed_yuv.data (), compressed_yuv.size (), filename));
+}
+
+//////////////////////////////////////////////////////////////////////////////
+bool
+pcl::io::LZFYUV422ImageWriter::encode (const char *data,
+                                       std::uint32_t width, std::uint32_t height,
+                                       std::vector<char> &blob) const
 {
   // Transform YUV422 into UUUYYYYYYVVV for better compression
   std::vector<char> uuyyvv (width * height * 2);
@@ -298,23 +325,11 @@ pcl::io::LZFYUV422ImageWriter::write (const char *data,
     uuyyvv[ptr3] = data[i * 4 + 2];       // v
   }
 
-  char* compressed_yuv = static_cast<char*> (malloc (std::size_t (float (uuyyvv.size ()) * 1.5f + float (LZF_HEADER_SIZE))));
-  std::size_t compressed_size = compress (reinterpret_cast<const char*> (&uuyyvv[0]), 
-                                     std::uint32_t (uuyyvv.size ()),
-                                     width, height,
-                                     "yuv422",
-                                     compressed_yuv);
-
-  if (compressed_size == 0)
-  {
-    free (compressed_yuv);
-    return (false);
-  }
-
-  // Save the actual image
-  saveImageBlob (compressed_yuv, compressed_size, filename);
-  free (compressed_yuv);
-  return (true);
+  return (compress (reinterpret_cast<const char*> (&uuyyvv[0]), 
+                    std::uint32_t (uuyyvv.size ()),
+                    width, height,
+                    "yuv422",
+                    blob));
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -323,24 +338,21 @@ pcl::io::LZFBayer8ImageWriter::write (const char *data,
                                       std::uint32_t width, std::uint32_t height,
                                       const std::string &filename)
 {
-  unsigned int bayer_size = width * height;
-  char* compressed_bayer = static_cast<char*> (malloc (std::size_t (float (bayer_size) * 1.5f + float (LZF_HEADER_SIZE))));
-  std::size_t compressed_size = compress (data,
-                                     bayer_size,
-                                     width, height,
-                                     "bayer8",
-                                     compressed_bayer);
-
-  if (compressed_size == 0)
-  {
-    free (compressed_bayer);
+  std::vector<char> compressed_bayer;
+  if (!encode (data, width, height, compressed_bayer))
     return (false);
-  }
 
   // Save the actual image
-  saveImageBlob (compressed_bayer, compressed_size, filename);
-  free (compressed_bayer);
-  return (true);
+  return (saveImageBlob (compressed_bayer.data (), compressed_bayer.size (), filename));
+}
+
+//////////////////////////////////////////////////////////////////////////////
+bool
+pcl::io::LZFBayer8ImageWriter::encode (const char *data,
+                                       std::uint32_t width, std::uint32_t height,
+                                       std::vector<char> &blob) const
+{
+  return (compress (data, width * height, width, height, "bayer8", blob));
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -407,57 +419,63 @@ pcl::io::LZFImageReader::loadImageBlob (const std::string &filename,
   }
 #endif
 
-  // Check the header identifier here
-  char header_string[5];
-  memcpy (&header_string,    &map[0], 5);        // PCLZF
-  if (std::string (header_string).substr (0, 5) != "PCLZF")
+  if (!loadImageBlob (map, data_size, data, uncompressed_size))
   {
-    PCL_ERROR ("[pcl::io::LZFImageReader::loadImage] Wrong signature header! Should be 'P'C'L'Z'F'.\n");
+    PCL_ERROR ("[pcl::io::LZFImageReader::loadImage] Invalid PCLZF file %s.\n", filename.c_str ());
 #ifdef _WIN32
   UnmapViewOfFile (map);
   CloseHandle (fm);
 #else
     ::munmap (map, data_size);
 #endif
+    raw_close (fd);
     return (false);
   }
-  memcpy (&width_,            &map[5], sizeof (std::uint32_t));
-  memcpy (&height_,           &map[9], sizeof (std::uint32_t));
-  char imgtype_string[16];
-  memcpy (&imgtype_string,    &map[13], 16);       // BAYER8, RGB24_, YUV422_, ...
-  image_type_identifier_ = std::string (imgtype_string).substr (0, 15);
-  image_type_identifier_.insert (image_type_identifier_.end (), 1, '\0');
-
-  static const int header_size = LZF_HEADER_SIZE;
-  std::uint32_t compressed_size;
-  memcpy (&compressed_size,   &map[29], sizeof (std::uint32_t));
 
-  if (compressed_size + header_size != data_size)
-  {
-    PCL_ERROR ("[pcl::io::LZFImageReader::loadImage] Number of bytes to decompress written in file (%u) differs from what it should be (%u)!\n", compressed_size, data_size - header_size);
 #ifdef _WIN32
   UnmapViewOfFile (map);
   CloseHandle (fm);
 #else
-    ::munmap (map, data_size);
+  if (::munmap (map, data_size) == -1)
+    PCL_ERROR ("[pcl::io::LZFImageReader::loadImage] Munmap failure\n");
 #endif
+  raw_close (fd);
+
+  return (true);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+bool
+pcl::io::LZFImageReader::loadImageBlob (const char *blob, std::size_t blob_size,
+                                        std::vector<char> &data,
+                                        std::uint32_t &uncompressed_size)
+{
+  static const std::size_t header_size = LZF_HEADER_SIZE;
+  // Check the header identifier here
+  if (blob_size < header_size || std::string (blob, 5) != "PCLZF")
+  {
+    PCL_ERROR ("[pcl::io::LZFImageReader::loadImage] Wrong signature header! Should be 'P'C'L'Z'F'.\n");
     return (false);
   }
+  memcpy (&width_,            &blob[5], sizeof (std::uint32_t));
+  memcpy (&height_,           &blob[9], sizeof (std::uint32_t));
+  char imgtype_string[16];
+  memcpy (&imgtype_string,    &blob[13], 16);       // BAYER8, RGB24_, YUV422_, ...
+  image_type_identifier_ = std::string (imgtype_string, 16).substr (0, 15);
+  image_type_identifier_.insert (image_type_identifier_.end (), 1, '\0');
+
+  std::uint32_t compressed_size;
+  memcpy (&compressed_size,   &blob[29], sizeof (std::uint32_t));
 
-  memcpy (&uncompressed_size, &map[33], sizeof (std::uint32_t));
+  if (compressed_size + header_size != blob_size)
+  {
+    PCL_ERROR ("[pcl::io::LZFImageReader::loadImage] Number of bytes to decompress written in file (%u) differs from what it should be (%zu)!\n", compressed_size, blob_size - header_size);
+    return (false);
+  }
 
-  data.resize (compressed_size);
-  memcpy (&data[0], &map[header_size], compressed_size);
- 
-#ifdef _WIN32
-  UnmapViewOfFile (map);
-  CloseHandle (fm);
-#else
-  if (::munmap (map, data_size) == -1)
-    PCL_ERROR ("[pcl::io::LZFImageReader::loadImage] Munmap failure\n");
-#endif
-  raw_close (fd);
+  memcpy (&uncompressed_size, &blob[33], sizeof (std::uint32_t));
 
+  data.assign (blob + header_size, blob + blob_size);
   return (true);
 }
 
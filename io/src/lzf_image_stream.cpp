@@ -0,0 +1,354 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved
+ */
+
+#include <pcl/io/lzf_image_stream.h>
+#include <pcl/console/print.h>
+
+#include <algorithm>
+#include <cstring>
+
+#define LZF_HEADER_SIZE 37
+
+///////////////////////////////////////////////////////////////////////////////////////////
+pcl::io::LZFImageRecorder::LZFImageRecorder (unsigned int nr_threads, std::size_t queue_size)
+  : queue_size_ (std::max<std::size_t> (queue_size, 1))
+  , nr_active_ (0)
+  , next_index_ (0)
+  , next_written_ (0)
+  , nr_dropped_ (0)
+  , nr_failed_ (0)
+  , stop_ (false)
+{
+  if (nr_threads == 0)
+    nr_threads = std::max (std::thread::hardware_concurrency (), 1u);
+  threads_.reserve (nr_threads);
+  for (unsigned int i = 0; i < nr_threads; ++i)
+    threads_.emplace_back (&LZFImageRecorder::run, this);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+pcl::io::LZFImageRecorder::~LZFImageRecorder ()
+{
+  {
+    std::lock_guard<std::mutex> lock (mutex_);
+    stop_ = true;
+  }
+  queue_not_empty_.notify_all ();
+  for (auto &thread : threads_)
+    thread.join ();
+  if (file_.is_open ())
+    file_.close ();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+bool
+pcl::io::LZFImageRecorder::open (const std::string &file_name)
+{
+  close ();
+  {
+    std::lock_guard<std::mutex> lock (mutex_);
+    next_index_ = 0;
+  }
+  std::lock_guard<std::mutex> lock (file_mutex_);
+  next_written_ = 0;
+  file_.open (file_name.c_str (), std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!file_.is_open ())
+  {
+    PCL_ERROR ("[pcl::io::LZFImageRecorder::open] Could not create file %s.\n", file_name.c_str ());
+    return (false);
+  }
+  return (true);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::io::LZFImageRecorder::close ()
+{
+  flush ();
+  std::lock_guard<std::mutex> lock (file_mutex_);
+  if (file_.is_open ())
+    file_.close ();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+bool
+pcl::io::LZFImageRecorder::record (const std::shared_ptr<const LZFImageWriter> &writer,
+                                   const char *data, std::size_t data_size,
+                                   std::uint32_t width, std::uint32_t height,
+                                   const std::string &file_name, bool wait)
+{
+  {
+    std::unique_lock<std::mutex> lock (mutex_);
+    if (!wait && queue_.size () >= queue_size_)
+    {
+      ++nr_dropped_;
+      return (false);
+    }
+    queue_not_full_.wait (lock, [this] { return (queue_.size () < queue_size_); });
+
+    Frame frame;
+    frame.writer = writer;
+    frame.data.assign (data, data + data_size);
+    frame.width = width;
+    frame.height = height;
+    frame.file_name = file_name;
+    frame.index = file_name.empty () ? next_index_++ : 0;
+    queue_.push_back (std::move (frame));
+  }
+  queue_not_empty_.notify_one ();
+  return (true);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::io::LZFImageRecorder::flush ()
+{
+  std::unique_lock<std::mutex> lock (mutex_);
+  frames_done_.wait (lock, [this] { return (queue_.empty () && nr_active_ == 0); });
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+std::size_t
+pcl::io::LZFImageRecorder::getNumberOfDroppedFrames () const
+{
+  std::lock_guard<std::mutex> lock (mutex_);
+  return (nr_dropped_);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+std::size_t
+pcl::io::LZFImageRecorder::getNumberOfFailedFrames () const
+{
+  std::lock_guard<std::mutex> lock (mutex_);
+  return (nr_failed_);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::io::LZFImageRecorder::run ()
+{
+  std::vector<char> blob;
+  while (true)
+  {
+    Frame frame;
+    {
+      std::unique_lock<std::mutex> lock (mutex_);
+      queue_not_empty_.wait (lock, [this] { return (stop_ || !queue_.empty ()); });
+      // Leave only once all the queued images are written
+      if (queue_.empty ())
+        return;
+      frame = std::move (queue_.front ());
+      queue_.pop_front ();
+      ++nr_active_;
+    }
+    queue_not_full_.notify_one ();
+
+    bool success = frame.writer && frame.writer->encode (frame.data.data (), frame.width, frame.height, blob);
+    if (!success)
+      blob.clear ();
+
+    if (frame.file_name.empty ())
+      success = append (frame.index, blob) && success;
+    else if (success)
+    {
+      std::ofstream file (frame.file_name.c_str (), std::ios::out | std::ios::binary | std::ios::trunc);
+      success = file.write (blob.data (), blob.size ()).good ();
+    }
+    if (!success)
+      PCL_ERROR ("[pcl::io::LZFImageRecorder::run] Could not record an image of size %ux%u.\n", frame.width, frame.height);
+
+    {
+      std::lock_guard<std::mutex> lock (mutex_);
+      --nr_active_;
+      if (!success)
+        ++nr_failed_;
+    }
+    frames_done_.notify_all ();
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+bool
+pcl::io::LZFImageRecorder::append (std::size_t index, const std::vector<char> &blob)
+{
+  std::unique_lock<std::mutex> lock (file_mutex_);
+  // The images before this one are compressed by other threads, which will all get here
+  frame_written_.wait (lock, [this, index] { return (next_written_ == index); });
+  bool success = file_.is_open ();
+  if (success && !blob.empty ())
+    success = file_.write (blob.data (), blob.size ()).good ();
+  ++next_written_;
+  lock.unlock ();
+  frame_written_.notify_all ();
+  return (success);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+pcl::io::LZFImagePlayer::LZFImagePlayer (std::size_t nr_prefetched)
+  : next_file_ (0)
+  , nr_prefetched_ (std::max<std::size_t> (nr_prefetched, 1))
+  , done_ (true)
+  , stop_ (false)
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+pcl::io::LZFImagePlayer::~LZFImagePlayer ()
+{
+  close ();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+bool
+pcl::io::LZFImagePlayer::open (const std::string &file_name)
+{
+  close ();
+  file_.open (file_name.c_str (), std::ios::in | std::ios::binary);
+  if (!file_.is_open ())
+  {
+    PCL_ERROR ("[pcl::io::LZFImagePlayer::open] Could not open file %s.\n", file_name.c_str ());
+    return (false);
+  }
+  start ();
+  return (true);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+bool
+pcl::io::LZFImagePlayer::open (const std::vector<std::string> &file_names)
+{
+  close ();
+  file_names_ = file_names;
+  next_file_ = 0;
+  start ();
+  return (true);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::io::LZFImagePlayer::close ()
+{
+  {
+    std::lock_guard<std::mutex> lock (mutex_);
+    stop_ = true;
+    done_ = true;
+  }
+  queue_not_full_.notify_all ();
+  queue_not_empty_.notify_all ();
+  if (thread_.joinable ())
+    thread_.join ();
+
+  if (file_.is_open ())
+    file_.close ();
+  file_names_.clear ();
+  next_file_ = 0;
+  queue_.clear ();
+  stop_ = false;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+bool
+pcl::io::LZFImagePlayer::getNextFrame (std::vector<char> &blob)
+{
+  {
+    std::unique_lock<std::mutex> lock (mutex_);
+    queue_not_empty_.wait (lock, [this] { return (done_ || !queue_.empty ()); });
+    if (queue_.empty ())
+      return (false);
+    blob = std::move (queue_.front ());
+    queue_.pop_front ();
+  }
+  queue_not_full_.notify_one ();
+  return (true);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::io::LZFImagePlayer::start ()
+{
+  done_ = false;
+  thread_ = std::thread (&LZFImagePlayer::run, this);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+bool
+pcl::io::LZFImagePlayer::readFrame (std::vector<char> &blob)
+{
+  // List of files, one image each
+  if (!file_.is_open ())
+  {
+    if (next_file_ >= file_names_.size ())
+      return (false);
+    const std::string &file_name = file_names_[next_file_++];
+    std::ifstream file (file_name.c_str (), std::ios::in | std::ios::binary | std::ios::ate);
+    if (!file.is_open ())
+    {
+      PCL_ERROR ("[pcl::io::LZFImagePlayer::readFrame] Could not open file %s.\n", file_name.c_str ());
+      return (false);
+    }
+    blob.resize (static_cast<std::size_t> (file.tellg ()));
+    file.seekg (0, std::ios::beg);
+    return (file.read (blob.data (), blob.size ()).good ());
+  }
+
+  // Multi-frame file: the header tells how many compressed bytes follow it
+  static const std::size_t header_size = LZF_HEADER_SIZE;
+  blob.resize (header_size);
+  if (!file_.read (blob.data (), header_size))
+  {
+    if (file_.gcount () != 0)
+      PCL_ERROR ("[pcl::io::LZFImagePlayer::readFrame] Truncated PCLZF header at the end of the file.\n");
+    return (false);
+  }
+  if (std::string (blob.data (), 5) != "PCLZF")
+  {
+    PCL_ERROR ("[pcl::io::LZFImagePlayer::readFrame] Wrong signature header! Should be 'P'C'L'Z'F'.\n");
+    return (false);
+  }
+  std::uint32_t compressed_size;
+  memcpy (&compressed_size, &blob[29], sizeof (std::uint32_t));
+  blob.resize (header_size + compressed_size);
+  if (!file_.read (&blob[header_size], compressed_size))
+  {
+    PCL_ERROR ("[pcl::io::LZFImagePlayer::readFrame] Truncated PCLZF image at the end of the file.\n");
+    return (false);
+  }
+  return (true);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::io::LZFImagePlayer::run ()
+{
+  while (true)
+  {
+    {
+      std::unique_lock<std::mutex> lock (mutex_);
+      queue_not_full_.wait (lock, [this] { return (stop_ || queue_.size () < nr_prefetched_); });
+      if (stop_)
+        return;
+    }
+
+    // The file and the list of files are only touched by this thread while it runs
+    std::vector<char> blob;
+    const bool success = readFrame (blob);
+    {
+      std::lock_guard<std::mutex> lock (mutex_);
+      if (success)
+        queue_.push_back (std::move (blob));
+      else
+        done_ = true;
+    }
+    queue_not_empty_.notify_all ();
+    if (!success)
+      return;
+  }
+}
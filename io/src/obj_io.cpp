@@ -38,9 +38,136 @@
 #include <pcl/io/obj_io.h>
 #include <fstream>
 #include <pcl/common/io.h>
+#include <pcl/io/ascii_parsing.h>
 #include <pcl/io/boost.h>
 #include <pcl/console/time.h>
 
+#include <algorithm>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace
+{
+  /** \brief The kinds of OBJ lines the readers look at. */
+  enum class OBJLine
+  {
+    OTHER,
+    VERTEX,
+    VERTEX_NORMAL,
+    FACE,
+    MATERIAL_LIBRARY
+  };
+
+  /** \brief Whether a character separates the tokens of an OBJ line. */
+  inline bool
+  isOBJSeparator (char c)
+  {
+    return (c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f');
+  }
+
+  /** \brief Get the next token of a line.
+    * \return false at the end of the line
+    */
+  inline bool
+  nextOBJToken (const char *&p, const char *end, const char *&token, const char *&token_end)
+  {
+    while (p != end && isOBJSeparator (*p))
+      ++p;
+    if (p == end)
+      return (false);
+    token = p;
+    while (p != end && !isOBJSeparator (*p))
+      ++p;
+    token_end = p;
+    return (true);
+  }
+
+  /** \brief Get the kind of a line from its keyword, and move \a begin past the keyword. */
+  inline OBJLine
+  classifyOBJLine (const char *&begin, const char *end)
+  {
+    const char *keyword, *keyword_end;
+    if (!nextOBJToken (begin, end, keyword, keyword_end))
+      return (OBJLine::OTHER);
+    switch (keyword_end - keyword)
+    {
+      case 1:
+        if (keyword[0] == 'v')
+          return (OBJLine::VERTEX);
+        if (keyword[0] == 'f')
+          return (OBJLine::FACE);
+        break;
+      case 2:
+        if (keyword[0] == 'v' && keyword[1] == 'n')
+          return (OBJLine::VERTEX_NORMAL);
+        break;
+      case 6:
+        if (std::equal (keyword, keyword_end, "mtllib"))
+          return (OBJLine::MATERIAL_LIBRARY);
+        break;
+    }
+    return (OBJLine::OTHER);
+  }
+
+  /** \brief Convert the three values of a vertex or a vertex normal line, with the fast conversion if
+    * possible and boost::lexical_cast otherwise.
+    * \param[in] begin the first character after the keyword
+    * \param[in] end the end of the line
+    * \param[out] point the data of the point
+    * \param[in] fields the fields of the point
+    * \param[in] first_field the index of the field of the first value
+    * \return false if the line does not hold three numbers
+    */
+  bool
+  parseOBJValues (const char *begin, const char *end, std::uint8_t *point,
+                  const std::vector<pcl::PCLPointField> &fields, int first_field)
+  {
+    for (int f = first_field; f < first_field + 3; ++f)
+    {
+      const char *token, *token_end;
+      if (!nextOBJToken (begin, end, token, token_end))
+        return (false);
+      float value;
+      if (!pcl::io::parseNumber (token, token_end, value))
+      {
+        try
+        {
+          value = boost::lexical_cast<float> (std::string (token, token_end));
+        }
+        catch (const boost::bad_lexical_cast&)
+        {
+          return (false);
+        }
+      }
+      memcpy (point + fields[f].offset, &value, sizeof (float));
+    }
+    return (true);
+  }
+
+  /** \brief Append the vertex indices of a face line (v, v/vt, v//vn or v/vt/vn) to \a indices.
+    * \param[in] begin the first character after the keyword
+    * \param[in] end the end of the line
+    * \param[in] nr_vertices the number of vertices before the line, for the relative indices
+    * \param[out] indices the zero based vertex indices
+    * \return false if a vertex index is not a valid number
+    */
+  bool
+  parseOBJFace (const char *begin, const char *end, std::size_t nr_vertices, std::vector<std::uint32_t> &indices)
+  {
+    const char *token, *token_end;
+    while (nextOBJToken (begin, end, token, token_end))
+    {
+      int v;
+      if (!pcl::io::parseNumber (token, std::find (token, token_end, '/'), v) || v == 0)
+        return (false);
+      indices.push_back (static_cast<std::uint32_t> (v < 0 ? static_cast<int> (nr_vertices) + v : v - 1));
+    }
+    return (true);
+  }
+}
+
 pcl::MTLReader::MTLReader ()
 {
   xyz_to_rgb_matrix_ << 2.3706743, -0.9000405, -0.4706338,
@@ -341,7 +468,6 @@ pcl::OBJReader::readHeader (const std::string &file_name, pcl::PCLPointCloud2 &c
   data_idx = offset;
 
   std::ifstream fs;
-  std::string line;
 
   if (file_name.empty() || !boost::filesystem::exists (file_name))
   {
@@ -364,68 +490,40 @@ pcl::OBJReader::readHeader (const std::string &file_name, pcl::PCLPointCloud2 &c
 
   // Read the header and fill it in with wonderful values
   bool vertex_normal_found = false;
-  bool vertex_texture_found = false;
   // Material library, skip for now!
   // bool material_found = false;
   std::vector<std::string> material_files;
   std::size_t nr_point = 0;
 
-  try
+  // Only the keywords are looked at, by large blocks of lines
+  pcl::io::LineBlockReader reader (fs);
+  std::vector<const char*> lines;
+  while (reader.readBlock (lines))
   {
-    while (!fs.eof ())
+    for (std::size_t i = 0; i + 1 < lines.size (); ++i)
     {
-      getline (fs, line);
-      // Ignore empty lines
-      if (line.empty())
-        continue;
-
-      // Trim the line
-      boost::trim (line);
-      
-      // Ignore comments
-      if (line[0] == '#')
-        continue;
-
-      // Vertex, vertex texture or vertex normal
-      if (line[0] == 'v')
+      const char *begin = lines[i];
+      const char *end = lines[i + 1] - 1;
+      switch (classifyOBJLine (begin, end))
       {
-        // Vertex (v)
-        if (line[1] == ' ') {
+        case OBJLine::VERTEX:
           ++nr_point;
-          continue;
-        }
-
-        // Vertex texture (vt)
-        if ((line[1] == 't') && !vertex_texture_found)
-        {
-          vertex_texture_found = true;
-          continue;
-        }
-
-        // Vertex normal (vn)
-        if ((line[1] == 'n') && !vertex_normal_found)
-        {
+          break;
+        case OBJLine::VERTEX_NORMAL:
           vertex_normal_found = true;
-          continue;
+          break;
+        case OBJLine::MATERIAL_LIBRARY:
+        {
+          const char *token, *token_end;
+          if (nextOBJToken (begin, end, token, token_end))
+            material_files.emplace_back (token, token_end);
+          break;
         }
-      }
-
-      // Material library, skip for now!
-      if (line.substr (0, 6) == "mtllib")
-      {
-        std::vector<std::string> st;
-        boost::split(st, line, boost::is_any_of("\t\r "), boost::token_compress_on);
-        material_files.push_back (st.at (1));
-        continue;
+        default:
+          break;
       }
     }
   }
-  catch (const char *exception)
-  {
-    PCL_ERROR ("[pcl::OBJReader::readHeader] %s\n", exception);
-    fs.close ();
-    return (-1);
-  }
 
   if (!nr_point)
   {
@@ -521,98 +619,8 @@ pcl::OBJReader::read (const std::string &file_name, pcl::PCLPointCloud2 &cloud,
   // Seek at the given offset
   fs.seekg (data_idx, std::ios::beg);
 
-  // Get normal_x and rgba fields indices
-  int normal_x_field = -1;
-  // std::size_t rgba_field = 0;
-  for (std::size_t i = 0; i < cloud.fields.size (); ++i)
-    if (cloud.fields[i].name == "normal_x")
-    {
-      normal_x_field = i;
-      break;
-    }
-  // else if (cloud.fields[i].name == "rgba")
-  //   rgba_field = i;
-
-  std::vector<std::string> st;
-  try
-  {
-    std::size_t point_idx = 0;
-    std::size_t normal_idx = 0;
-
-    while (!fs.eof ())
-    {
-      std::string line;
-      getline (fs, line);
-      // Ignore empty lines
-      if (line.empty())
-        continue;
-
-      // Tokenize the line
-      std::stringstream sstream (line);
-      sstream.imbue (std::locale::classic ());
-      line = sstream.str ();
-      boost::trim (line);
-      boost::split (st, line, boost::is_any_of ("\t\r "), boost::token_compress_on);
-
-      // Ignore comments
-      if (st[0] == "#")
-        continue;
-
-      // Vertex
-      if (st[0] == "v")
-      {
-        try
-        {
-          for (int i = 1, f = 0; i < 4; ++i, ++f)
-          {
-            float value = boost::lexical_cast<float> (st[i]);
-            memcpy (&cloud.data[point_idx * cloud.point_step + cloud.fields[f].offset],
-                &value,
-                sizeof (float));
-          }
-          ++point_idx;
-        }
-        catch (const boost::bad_lexical_cast&)
-        {
-          PCL_ERROR ("Unable to convert %s to vertex coordinates!", line.c_str ());
-          return (-1);
-        }
-        continue;
-      }
-
-      // Vertex normal
-      if (st[0] == "vn")
-      {
-        if (normal_idx >= cloud.width) 
-        {
-          if (normal_idx == cloud.width)
-            PCL_WARN ("[pcl:OBJReader] Too many vertex normals (expected %d), skipping remaining normals.\n", cloud.width, normal_idx + 1);
-          ++normal_idx;
-          continue;
-        }
-        try
-        {
-          for (int i = 1, f = normal_x_field; i < 4; ++i, ++f)
-          {
-            float value = boost::lexical_cast<float> (st[i]);
-            memcpy (&cloud.data[normal_idx * cloud.point_step + cloud.fields[f].offset],
-                &value,
-                sizeof (float));
-          }
-          ++normal_idx;
-        }
-        catch (const boost::bad_lexical_cast&)
-        {
-          PCL_ERROR ("Unable to convert line %s to vertex normal!", line.c_str ());
-          return (-1);
-        }
-        continue;
-      }
-    }
-  }
-  catch (const char *exception)
+  if (readBody (fs, cloud, nullptr, nullptr))
   {
-    PCL_ERROR ("[pcl::OBJReader::read] %s\n", exception);
     fs.close ();
     return (-1);
   }
@@ -855,113 +863,229 @@ pcl::OBJReader::read (const std::string &file_name, pcl::PolygonMesh &mesh,
   // Seek at the given offset
   fs.seekg (data_idx, std::ios::beg);
 
-  // Get normal_x and rgba fields indices
+  std::vector<std::uint32_t> face_vertices;
+  std::vector<std::size_t> face_offsets;
+  if (readBody (fs, mesh.cloud, &face_vertices, &face_offsets))
+  {
+    fs.close ();
+    return (-1);
+  }
+
+  const std::ptrdiff_t nr_faces = static_cast<std::ptrdiff_t> (face_offsets.size ()) - 1;
+  mesh.polygons.resize (nr_faces);
+#pragma omp parallel for \
+  default(none) \
+  shared(face_offsets, face_vertices, mesh, nr_faces) \
+  num_threads(threads_)
+  for (std::ptrdiff_t i = 0; i < nr_faces; ++i)
+    mesh.polygons[i].vertices.assign (face_vertices.begin () + face_offsets[i],
+                                      face_vertices.begin () + face_offsets[i + 1]);
+
+  double total_time = tt.toc ();
+  PCL_DEBUG ("[pcl::OBJReader::read] Loaded %s as a PolygonMesh in %g ms with %u points and %zu polygons.\n",
+             file_name.c_str (), total_time,
+             mesh.cloud.width * mesh.cloud.height, mesh.polygons.size ());
+  fs.close ();
+  return (0);
+}
+
+int
+pcl::OBJReader::read (const std::string &file_name, pcl::TriangleMesh &mesh, const int offset)
+{
+  pcl::console::TicToc tt;
+  tt.tic ();
+
+  int file_version;
+  int data_type;
+  unsigned int data_idx;
+  Eigen::Vector4f origin;
+  Eigen::Quaternionf orientation;
+  if (readHeader (file_name, mesh.cloud, origin, orientation, file_version, data_type, data_idx, offset))
+  {
+    PCL_ERROR ("[pcl::OBJReader::read] Problem reading header!\n");
+    return (-1);
+  }
+
+  std::ifstream fs;
+  fs.open (file_name.c_str (), std::ios::binary);
+  if (!fs.is_open () || fs.fail ())
+  {
+    PCL_ERROR ("[pcl::OBJReader::read] Could not open file '%s'! Error : %s\n",
+               file_name.c_str (), strerror(errno));
+    fs.close ();
+    return (-1);
+  }
+
+  // Seek at the given offset
+  fs.seekg (data_idx, std::ios::beg);
+
+  std::vector<std::uint32_t> face_vertices;
+  std::vector<std::size_t> face_offsets;
+  if (readBody (fs, mesh.cloud, &face_vertices, &face_offsets))
+  {
+    fs.close ();
+    return (-1);
+  }
+
+  // Split the faces into a fan of triangles around their first vertex, as polygonsToTriangles
+  std::size_t nr_triangles = 0;
+  for (std::size_t i = 0; i + 1 < face_offsets.size (); ++i)
+    if (face_offsets[i + 1] - face_offsets[i] >= 3)
+      nr_triangles += face_offsets[i + 1] - face_offsets[i] - 2;
+  mesh.triangles.clear ();
+  mesh.triangles.reserve (3 * nr_triangles);
+  for (std::size_t i = 0; i + 1 < face_offsets.size (); ++i)
+    for (std::size_t j = face_offsets[i] + 2; j < face_offsets[i + 1]; ++j)
+      mesh.addTriangle (face_vertices[face_offsets[i]], face_vertices[j - 1], face_vertices[j]);
+
+  double total_time = tt.toc ();
+  PCL_DEBUG ("[pcl::OBJReader::read] Loaded %s as a TriangleMesh in %g ms with %u points and %zu triangles.\n",
+             file_name.c_str (), total_time,
+             mesh.cloud.width * mesh.cloud.height, mesh.size ());
+  fs.close ();
+  return (0);
+}
+
+void
+pcl::OBJReader::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs ();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
+
+int
+pcl::OBJReader::readBody (std::istream &fs, pcl::PCLPointCloud2 &cloud,
+                          std::vector<std::uint32_t> *face_vertices, std::vector<std::size_t> *face_offsets)
+{
   int normal_x_field = -1;
-  // std::size_t rgba_field = 0;
-  for (std::size_t i = 0; i < mesh.cloud.fields.size (); ++i)
-    if (mesh.cloud.fields[i].name == "normal_x")
+  for (std::size_t i = 0; i < cloud.fields.size (); ++i)
+    if (cloud.fields[i].name == "normal_x")
     {
-      normal_x_field = i;
+      normal_x_field = static_cast<int> (i);
       break;
     }
 
-  std::vector<std::string> st;
-  try
+  if (face_vertices)
   {
-    std::size_t v_idx = 0;
-    std::size_t vn_idx = 0;
+    face_vertices->clear ();
+    face_offsets->assign (1, 0);
+  }
 
-    while (!fs.eof ())
+  // The lines of a block are sorted by kind, and then parsed in parallel. The index is the one of the
+  // vertex or normal, and for the faces the number of vertices before, for the relative indices
+  struct Line
+  {
+    const char *begin;
+    const char *end;
+    std::size_t index;
+  };
+  std::vector<Line> vertex_lines, normal_lines, face_lines;
+
+  // The faces are parsed by chunks of consecutive lines, which are then appended in order
+  const std::size_t nr_threads = std::max (threads_, 1u);
+  std::vector<std::vector<std::uint32_t> > chunk_vertices (nr_threads);
+  std::vector<std::vector<std::size_t> > chunk_sizes (nr_threads);
+
+  pcl::io::LineBlockReader reader (fs);
+  std::vector<const char*> lines;
+  std::size_t nr_vertices = 0;
+  std::size_t nr_normals = 0;
+  bool valid = true;
+  while (valid && reader.readBlock (lines))
+  {
+    vertex_lines.clear ();
+    normal_lines.clear ();
+    face_lines.clear ();
+    for (std::size_t i = 0; i + 1 < lines.size (); ++i)
     {
-      std::string line;
-      getline (fs, line);
-      // Ignore empty lines
-      if (line.empty())
-        continue;
-
-      // Tokenize the line
-      std::stringstream sstream (line);
-      sstream.imbue (std::locale::classic ());
-      line = sstream.str ();
-      boost::trim (line);
-      boost::split (st, line, boost::is_any_of ("\t\r "), boost::token_compress_on);
-
-      // Ignore comments
-      if (st[0] == "#")
-        continue;
-
-      // Vertex
-      if (st[0] == "v")
+      const char *begin = lines[i];
+      const char *end = lines[i + 1] - 1;
+      switch (classifyOBJLine (begin, end))
       {
-        try
-        {
-          for (int i = 1, f = 0; i < 4; ++i, ++f)
-          {
-            float value = boost::lexical_cast<float> (st[i]);
-            memcpy (&mesh.cloud.data[v_idx * mesh.cloud.point_step + mesh.cloud.fields[f].offset],
-                &value,
-                sizeof (float));
-          }
-          ++v_idx;
-        }
-        catch (const boost::bad_lexical_cast&)
-        {
-          PCL_ERROR ("Unable to convert %s to vertex coordinates!", line.c_str ());
-          return (-1);
-        }
-        continue;
+        case OBJLine::VERTEX:
+          if (nr_vertices < cloud.width)
+            vertex_lines.push_back ({begin, end, nr_vertices});
+          ++nr_vertices;
+          break;
+        case OBJLine::VERTEX_NORMAL:
+          if (normal_x_field >= 0 && nr_normals < cloud.width)
+            normal_lines.push_back ({begin, end, nr_normals});
+          else if (nr_normals == cloud.width)
+            PCL_WARN ("[pcl:OBJReader] Too many vertex normals (expected %d), skipping remaining normals.\n", cloud.width);
+          ++nr_normals;
+          break;
+        case OBJLine::FACE:
+          if (face_vertices)
+            face_lines.push_back ({begin, end, nr_vertices});
+          break;
+        default:
+          break;
       }
+    }
 
-      // Vertex normal
-      if (st[0] == "vn")
+    const std::ptrdiff_t nr_vertex_lines = static_cast<std::ptrdiff_t> (vertex_lines.size ());
+#pragma omp parallel for \
+  default(none) \
+  shared(cloud, nr_vertex_lines, vertex_lines) \
+  reduction(&&:valid) \
+  num_threads(threads_)
+    for (std::ptrdiff_t i = 0; i < nr_vertex_lines; ++i)
+      valid = valid && parseOBJValues (vertex_lines[i].begin, vertex_lines[i].end,
+                                       &cloud.data[vertex_lines[i].index * cloud.point_step], cloud.fields, 0);
+
+    const std::ptrdiff_t nr_normal_lines = static_cast<std::ptrdiff_t> (normal_lines.size ());
+#pragma omp parallel for \
+  default(none) \
+  shared(cloud, normal_lines, normal_x_field, nr_normal_lines) \
+  reduction(&&:valid) \
+  num_threads(threads_)
+    for (std::ptrdiff_t i = 0; i < nr_normal_lines; ++i)
+      valid = valid && parseOBJValues (normal_lines[i].begin, normal_lines[i].end,
+                                       &cloud.data[normal_lines[i].index * cloud.point_step], cloud.fields,
+                                       normal_x_field);
+
+    if (face_lines.empty ())
+      continue;
+    const std::ptrdiff_t nr_chunks = static_cast<std::ptrdiff_t> (std::min (nr_threads, face_lines.size ()));
+#pragma omp parallel for \
+  default(none) \
+  shared(chunk_sizes, chunk_vertices, face_lines, nr_chunks) \
+  reduction(&&:valid) \
+  num_threads(threads_)
+    for (std::ptrdiff_t c = 0; c < nr_chunks; ++c)
+    {
+      std::vector<std::uint32_t> &vertices = chunk_vertices[c];
+      std::vector<std::size_t> &sizes = chunk_sizes[c];
+      vertices.clear ();
+      sizes.clear ();
+      const std::size_t chunk_end = face_lines.size () * (c + 1) / nr_chunks;
+      for (std::size_t i = face_lines.size () * c / nr_chunks; i < chunk_end && valid; ++i)
       {
-        try
-        {
-          for (int i = 1, f = normal_x_field; i < 4; ++i, ++f)
-          {
-            float value = boost::lexical_cast<float> (st[i]);
-            memcpy (&mesh.cloud.data[vn_idx * mesh.cloud.point_step + mesh.cloud.fields[f].offset],
-                &value,
-                sizeof (float));
-          }
-          ++vn_idx;
-        }
-        catch (const boost::bad_lexical_cast&)
-        {
-          PCL_ERROR ("Unable to convert line %s to vertex normal!", line.c_str ());
-          return (-1);
-        }
-        continue;
+        const std::size_t previous_size = vertices.size ();
+        valid = parseOBJFace (face_lines[i].begin, face_lines[i].end, face_lines[i].index, vertices);
+        sizes.push_back (vertices.size () - previous_size);
       }
+    }
 
-      // Face
-      if (st[0] == "f")
-      {
-        pcl::Vertices face_vertices; face_vertices.vertices.resize (st.size () - 1);
-        for (std::size_t i = 1; i < st.size (); ++i)
-        {
-          int v;
-          sscanf (st[i].c_str (), "%d", &v);
-          v = (v < 0) ? v_idx + v : v - 1;
-          face_vertices.vertices[i - 1] = v;
-        }
-        mesh.polygons.push_back (face_vertices);
-        continue;
-      }
+    for (std::ptrdiff_t c = 0; c < nr_chunks; ++c)
+    {
+      face_vertices->insert (face_vertices->end (), chunk_vertices[c].begin (), chunk_vertices[c].end ());
+      for (const std::size_t size : chunk_sizes[c])
+        face_offsets->push_back (face_offsets->back () + size);
     }
   }
-  catch (const char *exception)
+
+  if (!valid)
   {
-    PCL_ERROR ("[pcl::OBJReader::read] %s\n", exception);
-    fs.close ();
+    PCL_ERROR ("[pcl::OBJReader::read] Unable to convert a vertex, vertex normal or face line!\n");
     return (-1);
   }
-
-  double total_time = tt.toc ();
-  PCL_DEBUG ("[pcl::OBJReader::read] Loaded %s as a PolygonMesh in %g ms with %g points and %g polygons.\n",
-             file_name.c_str (), total_time,
-             mesh.cloud.width * mesh.cloud.height, mesh.polygons.size ());
-  fs.close ();
   return (0);
 }
 
@@ -1153,11 +1277,14 @@ pcl::io::saveOBJFile (const std::string &file_name,
   return (0);
 }
 
-int
-pcl::io::saveOBJFile (const std::string &file_name,
-                      const pcl::PolygonMesh &mesh, unsigned precision)
+/** \brief Save a mesh in ascii OBJ format, given its vertex data and a functor
+  * returning the [begin, end) range of the vertex indices of every face.
+  */
+template <typename FaceFunctor> static int
+saveOBJMesh (const std::string &file_name, const pcl::PCLPointCloud2 &cloud,
+             unsigned nr_faces, const FaceFunctor &face, unsigned precision)
 {
-  if (mesh.cloud.data.empty ())
+  if (cloud.data.empty ())
   {
     PCL_ERROR ("[pcl::io::saveOBJFile] Input point cloud has no data!\n");
     return (-1);
@@ -1169,13 +1296,11 @@ pcl::io::saveOBJFile (const std::string &file_name,
 
   /* Write 3D information */
   // number of points
-  int nr_points  = mesh.cloud.width * mesh.cloud.height;
+  int nr_points  = cloud.width * cloud.height;
   // point size
-  unsigned point_size = static_cast<unsigned> (mesh.cloud.data.size () / nr_points);
-  // number of faces for header
-  unsigned nr_faces = static_cast<unsigned> (mesh.polygons.size ());
+  unsigned point_size = static_cast<unsigned> (cloud.data.size () / nr_points);
   // Do we have vertices normals?
-  int normal_index = getFieldIndex (mesh.cloud, "normal_x");
+  int normal_index = getFieldIndex (cloud, "normal_x");
 
   // Write the header information
   fs << "####" << '\n';
@@ -1191,20 +1316,20 @@ pcl::io::saveOBJFile (const std::string &file_name,
   for (int i = 0; i < nr_points; ++i)
   {
     int xyz = 0;
-    for (std::size_t d = 0; d < mesh.cloud.fields.size (); ++d)
+    for (std::size_t d = 0; d < cloud.fields.size (); ++d)
     {
       // adding vertex
-      if ((mesh.cloud.fields[d].datatype == pcl::PCLPointField::FLOAT32) && (
-          mesh.cloud.fields[d].name == "x" ||
-          mesh.cloud.fields[d].name == "y" ||
-          mesh.cloud.fields[d].name == "z"))
+      if ((cloud.fields[d].datatype == pcl::PCLPointField::FLOAT32) && (
+          cloud.fields[d].name == "x" ||
+          cloud.fields[d].name == "y" ||
+          cloud.fields[d].name == "z"))
       {
-        if (mesh.cloud.fields[d].name == "x")
+        if (cloud.fields[d].name == "x")
            // write vertices beginning with v
           fs << "v ";
 
         float value;
-        memcpy (&value, &mesh.cloud.data[i * point_size + mesh.cloud.fields[d].offset], sizeof (float));
+        memcpy (&value, &cloud.data[i * point_size + cloud.fields[d].offset], sizeof (float));
         fs << value;
         if (++xyz == 3)
           break;
@@ -1228,20 +1353,20 @@ pcl::io::saveOBJFile (const std::string &file_name,
     for (int i = 0; i < nr_points; ++i)
     {
       int nxyz = 0;
-      for (std::size_t d = 0; d < mesh.cloud.fields.size (); ++d)
+      for (std::size_t d = 0; d < cloud.fields.size (); ++d)
       {
         // adding vertex
-        if ((mesh.cloud.fields[d].datatype == pcl::PCLPointField::FLOAT32) && (
-              mesh.cloud.fields[d].name == "normal_x" ||
-              mesh.cloud.fields[d].name == "normal_y" ||
-              mesh.cloud.fields[d].name == "normal_z"))
+        if ((cloud.fields[d].datatype == pcl::PCLPointField::FLOAT32) && (
+              cloud.fields[d].name == "normal_x" ||
+              cloud.fields[d].name == "normal_y" ||
+              cloud.fields[d].name == "normal_z"))
         {
-          if (mesh.cloud.fields[d].name == "normal_x")
+          if (cloud.fields[d].name == "normal_x")
             // write vertices beginning with vn
             fs << "vn ";
 
           float value;
-          memcpy (&value, &mesh.cloud.data[i * point_size + mesh.cloud.fields[d].offset], sizeof (float));
+          memcpy (&value, &cloud.data[i * point_size + cloud.fields[d].offset], sizeof (float));
           fs << value;
           if (++nxyz == 3)
             break;
@@ -1265,20 +1390,22 @@ pcl::io::saveOBJFile (const std::string &file_name,
   {
     for(unsigned i = 0; i < nr_faces; i++)
     {
+      const auto vertices = face (i);
       fs << "f ";      
-      for (std::size_t j = 0; j < mesh.polygons[i].vertices.size () - 1; ++j)
-        fs << mesh.polygons[i].vertices[j] + 1 << " ";
-      fs << mesh.polygons[i].vertices.back() + 1 << '\n';
+      for (auto v = vertices.first; v != vertices.second - 1; ++v)
+        fs << *v + 1 << " ";
+      fs << *(vertices.second - 1) + 1 << '\n';
     }
   }
   else
   {
     for(unsigned i = 0; i < nr_faces; i++)
     {
+      const auto vertices = face (i);
       fs << "f ";
-      for (std::size_t j = 0; j < mesh.polygons[i].vertices.size () - 1; ++j)
-        fs << mesh.polygons[i].vertices[j] + 1 << "//" << mesh.polygons[i].vertices[j] + 1 << " ";
-      fs << mesh.polygons[i].vertices.back() + 1 << "//" << mesh.polygons[i].vertices.back() + 1 << '\n';
+      for (auto v = vertices.first; v != vertices.second - 1; ++v)
+        fs << *v + 1 << "//" << *v + 1 << " ";
+      fs << *(vertices.second - 1) + 1 << "//" << *(vertices.second - 1) + 1 << '\n';
     }
   }
   fs << "# End of File" << std::endl;
@@ -1287,3 +1414,27 @@ pcl::io::saveOBJFile (const std::string &file_name,
   fs.close ();
   return 0;
 }
+
+int
+pcl::io::saveOBJFile (const std::string &file_name,
+                      const pcl::PolygonMesh &mesh, unsigned precision)
+{
+  const auto face = [&mesh] (std::size_t i)
+  {
+    const auto &vertices = mesh.polygons[i].vertices;
+    return (std::make_pair (vertices.data (), vertices.data () + vertices.size ()));
+  };
+  return (saveOBJMesh (file_name, mesh.cloud, static_cast<unsigned> (mesh.polygons.size ()), face, precision));
+}
+
+int
+pcl::io::saveOBJFile (const std::string &file_name,
+                      const pcl::TriangleMesh &mesh, unsigned precision)
+{
+  const auto face = [&mesh] (std::size_t i)
+  {
+    const std::uint32_t *vertices = mesh.getTriangle (i);
+    return (std::make_pair (vertices, vertices + 3));
+  };
+  return (saveOBJMesh (file_name, mesh.cloud, static_cast<unsigned> (mesh.size ()), face, precision));
+}
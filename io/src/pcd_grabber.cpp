@@ -35,12 +35,22 @@
  *
  */
 
+#include <pcl/io/async_loader.h>
 #include <pcl/io/low_level_io.h>
 #include <pcl/io/pcd_grabber.h>
 #include <pcl/io/pcd_io.h>
 #include <pcl/io/tar.h>
 #include <pcl/memory.h>
 
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/filesystem.hpp>
+
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <future>
+#include <memory>
+
 ///////////////////////////////////////////////////////////////////////////////////////////
 //////////////////////// GrabberImplementation //////////////////////
 struct pcl::PCDGrabberBase::PCDGrabberImpl
@@ -50,6 +60,14 @@ struct pcl::PCDGrabberBase::PCDGrabberImpl
   void trigger ();
   void readAhead ();
 
+  // Indexed playback
+  void readFrame ();
+  void prefetch ();
+  void clearPrefetched ();
+  bool seek (std::size_t idx);
+  void setPrefetching (std::size_t nr_prefetched, unsigned int nr_threads);
+  bool getTimestampAtIndex (std::size_t idx, std::uint64_t &timestamp);
+
   // TAR reading I/O
   int openTARFile (const std::string &file_name);
   void closeTARFile ();
@@ -94,11 +112,36 @@ struct pcl::PCDGrabberBase::PCDGrabberImpl
   bool scraped_;
   std::vector<int> tar_offsets_;
   std::vector<std::size_t> cloud_idx_to_file_idx_;
+  // The name of every cloud: the name stored in the TAR header, or the PCD file name
+  std::vector<std::string> cloud_names_;
+  std::mutex scrape_mutex_;
 
   // Mutex to ensure that two quick consecutive triggers do not cause
   // simultaneous asynchronous read-aheads
   std::mutex read_ahead_mutex_;
 
+  // True if the clouds are read by index (through the scraped offsets) instead of file by file
+  bool indexed_;
+  // The index of the cloud read by the next readAhead () in indexed playback
+  std::size_t next_frame_;
+
+  // A cloud being loaded by the prefetching threads
+  struct PrefetchedFrame
+  {
+    std::size_t idx;
+    pcl::PCLPointCloud2 cloud;
+    Eigen::Vector4f origin;
+    Eigen::Quaternionf orientation;
+    std::future<int> result;
+
+    PCL_MAKE_ALIGNED_OPERATOR_NEW
+  };
+  std::size_t nr_prefetched_;
+  std::size_t next_prefetched_;
+  std::deque<std::unique_ptr<PrefetchedFrame> > prefetched_;
+  // Declared after prefetched_, so that it finishes loading into the frames before they are destroyed
+  std::unique_ptr<pcl::io::AsyncLoader> loader_;
+
   PCL_MAKE_ALIGNED_OPERATOR_NEW
 };
 
@@ -114,6 +157,10 @@ pcl::PCDGrabberBase::PCDGrabberImpl::PCDGrabberImpl (pcl::PCDGrabberBase& grabbe
   , tar_offset_ (0)
   , tar_header_ ()
   , scraped_ (false)
+  , indexed_ (false)
+  , next_frame_ (0)
+  , nr_prefetched_ (0)
+  , next_prefetched_ (0)
 {
   pcd_files_.push_back (pcd_path);
   pcd_iterator_ = pcd_files_.begin ();
@@ -133,6 +180,10 @@ pcl::PCDGrabberBase::PCDGrabberImpl::PCDGrabberImpl (pcl::PCDGrabberBase& grabbe
   , tar_offset_ (0)
   , tar_header_ ()
   , scraped_ (false)
+  , indexed_ (false)
+  , next_frame_ (0)
+  , nr_prefetched_ (0)
+  , next_prefetched_ (0)
 {
   pcd_files_ = pcd_files;
   pcd_iterator_ = pcd_files_.begin ();
@@ -144,6 +195,12 @@ pcl::PCDGrabberBase::PCDGrabberImpl::PCDGrabberImpl (pcl::PCDGrabberBase& grabbe
 void
 pcl::PCDGrabberBase::PCDGrabberImpl::readAhead ()
 {
+  if (indexed_)
+  {
+    readFrame ();
+    return;
+  }
+
   PCDReader reader;
   int pcd_version;
 
@@ -276,9 +333,13 @@ pcl::PCDGrabberBase::PCDGrabberImpl::trigger ()
 void
 pcl::PCDGrabberBase::PCDGrabberImpl::scrapeForClouds (bool force)
 {
+  std::lock_guard<std::mutex> scrape_lock (scrape_mutex_);
   // Do nothing if we've already scraped (unless force is set)
   if (scraped_ && !force)
     return;
+  tar_offsets_.clear ();
+  cloud_idx_to_file_idx_.clear ();
+  cloud_names_.clear ();
   // Store temporary information
   int tmp_fd = tar_fd_;
   int tmp_offset = tar_offset_;
@@ -297,6 +358,7 @@ pcl::PCDGrabberBase::PCDGrabberImpl::scrapeForClouds (bool force)
     {
       tar_offsets_.push_back (0);
       cloud_idx_to_file_idx_.push_back (i);
+      cloud_names_.push_back (pcd_file);
     }
     else if (openTARFile (pcd_file) >= 0)
     {
@@ -304,6 +366,7 @@ pcl::PCDGrabberBase::PCDGrabberImpl::scrapeForClouds (bool force)
       {
         tar_offsets_.push_back (tar_offset_);
         cloud_idx_to_file_idx_.push_back (i);
+        cloud_names_.emplace_back (tar_header_.file_name, strnlen (tar_header_.file_name, sizeof (tar_header_.file_name)));
         // Update offset
         tar_offset_ += (tar_header_.getFileSize ()) + (512 - tar_header_.getFileSize () % 512);
         int result = static_cast<int> (io::raw_lseek (tar_fd_, tar_offset_, SEEK_SET));
@@ -338,7 +401,7 @@ pcl::PCDGrabberBase::PCDGrabberImpl::getCloudAt (std::size_t idx,
   PCDReader reader;
   int pcd_version;
   std::string filename = pcd_files_[cloud_idx_to_file_idx_[idx]];
-  return (reader.read (filename, blob, origin, orientation, pcd_version, tar_offsets_[idx]));
+  return (reader.read (filename, blob, origin, orientation, pcd_version, tar_offsets_[idx]) == 0);
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////
@@ -349,6 +412,139 @@ pcl::PCDGrabberBase::PCDGrabberImpl::numFrames ()
   return (cloud_idx_to_file_idx_.size ());
 }
 
+///////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::PCDGrabberBase::PCDGrabberImpl::readFrame ()
+{
+  const std::size_t nr_frames = numFrames ();
+  if (next_frame_ >= nr_frames && repeat_)
+    next_frame_ = 0;
+  if (next_frame_ >= nr_frames)
+  {
+    valid_ = false;
+    return;
+  }
+
+  if (loader_)
+  {
+    // The queue always starts with next_frame_, see seek ()
+    prefetch ();
+    std::unique_ptr<PrefetchedFrame> frame = std::move (prefetched_.front ());
+    prefetched_.pop_front ();
+    valid_ = (frame->result.get () == 0);
+    std::swap (next_cloud_, frame->cloud);
+    origin_ = frame->origin;
+    orientation_ = frame->orientation;
+    prefetch ();
+  }
+  else
+    valid_ = getCloudAt (next_frame_, next_cloud_, origin_, orientation_);
+
+  next_file_name_ = pcd_files_[cloud_idx_to_file_idx_[next_frame_]];
+  ++next_frame_;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::PCDGrabberBase::PCDGrabberImpl::prefetch ()
+{
+  const std::size_t nr_frames = numFrames ();
+  while (prefetched_.size () < nr_prefetched_)
+  {
+    if (next_prefetched_ >= nr_frames)
+    {
+      if (!repeat_ || nr_frames == 0)
+        return;
+      next_prefetched_ = 0;
+    }
+    std::unique_ptr<PrefetchedFrame> frame (new PrefetchedFrame);
+    frame->idx = next_prefetched_;
+    frame->result = loader_->loadPCD (pcd_files_[cloud_idx_to_file_idx_[frame->idx]], tar_offsets_[frame->idx],
+                                      frame->cloud, frame->origin, frame->orientation);
+    prefetched_.push_back (std::move (frame));
+    ++next_prefetched_;
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::PCDGrabberBase::PCDGrabberImpl::clearPrefetched ()
+{
+  // The loader writes into the frames until their results are ready
+  for (auto &frame : prefetched_)
+    frame->result.wait ();
+  prefetched_.clear ();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+bool
+pcl::PCDGrabberBase::PCDGrabberImpl::seek (std::size_t idx)
+{
+  std::lock_guard<std::mutex> read_ahead_lock (read_ahead_mutex_);
+  if (idx >= numFrames ())
+    return (false);
+  if (tar_fd_ != -1)
+    closeTARFile ();
+  indexed_ = true;
+  clearPrefetched ();
+  next_frame_ = next_prefetched_ = idx;
+  readAhead ();
+  return (true);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::PCDGrabberBase::PCDGrabberImpl::setPrefetching (std::size_t nr_prefetched, unsigned int nr_threads)
+{
+  std::lock_guard<std::mutex> read_ahead_lock (read_ahead_mutex_);
+  clearPrefetched ();
+  loader_.reset ();
+  nr_prefetched_ = nr_prefetched;
+  if (nr_prefetched_ > 0)
+    loader_.reset (new pcl::io::AsyncLoader (nr_threads, nr_prefetched_));
+
+  if (indexed_)
+  {
+    // Keep the cloud already read, and prefetch the ones after it
+    next_prefetched_ = next_frame_;
+    if (loader_)
+      prefetch ();
+  }
+  else
+  {
+    if (tar_fd_ != -1)
+      closeTARFile ();
+    indexed_ = true;
+    next_frame_ = next_prefetched_ = 0;
+    readAhead ();
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+bool
+pcl::PCDGrabberBase::PCDGrabberImpl::getTimestampAtIndex (std::size_t idx, std::uint64_t &timestamp)
+{
+  if (idx >= numFrames ())
+    return (false);
+  // For now, we assume the cloud is named frame_[22-char POSIX timestamp][_*].pcd
+  char timestamp_str[256];
+  const std::string name = boost::filesystem::path (cloud_names_[idx]).stem ().string ();
+  if (std::sscanf (name.c_str (), "frame_%22s", timestamp_str) != 1)
+    return (false);
+  try
+  {
+    // Convert to std::uint64_t, microseconds since 1970-01-01
+    boost::posix_time::ptime cur_date = boost::posix_time::from_iso_string (timestamp_str);
+    boost::posix_time::ptime zero_date (boost::gregorian::date (1970, boost::gregorian::Jan, 1));
+    timestamp = (cur_date - zero_date).total_microseconds ();
+  }
+  catch (const std::exception&)
+  {
+    return (false);
+  }
+  return (true);
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////
 //////////////////////// GrabberBase //////////////////////
 pcl::PCDGrabberBase::PCDGrabberBase (const std::string& pcd_path, float frames_per_second, bool repeat)
@@ -378,9 +574,7 @@ pcl::PCDGrabberBase::start ()
     impl_->time_trigger_.start ();
   }
   else // manual trigger
-  {
-    std::thread non_blocking_call (&PCDGrabberBase::PCDGrabberImpl::trigger, impl_);
-  }
+    impl_->trigger ();
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////
@@ -400,15 +594,15 @@ pcl::PCDGrabberBase::trigger ()
 {
   if (impl_->frames_per_second_ > 0)
     return;
-  std::thread non_blocking_call (&PCDGrabberBase::PCDGrabberImpl::trigger, impl_);
-
-//  impl_->trigger ();
+  impl_->trigger ();
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////
 bool
 pcl::PCDGrabberBase::isRunning () const
 {
+  if (impl_->indexed_)
+    return (impl_->running_ && impl_->valid_);
   return (impl_->running_ && (impl_->pcd_iterator_ != impl_->pcd_files_.end()));
 }
 
@@ -423,7 +617,10 @@ pcl::PCDGrabberBase::getName () const
 void
 pcl::PCDGrabberBase::rewind ()
 {
-  impl_->pcd_iterator_ = impl_->pcd_files_.begin ();
+  if (impl_->indexed_)
+    impl_->seek (0);
+  else
+    impl_->pcd_iterator_ = impl_->pcd_files_.begin ();
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////
@@ -456,3 +653,47 @@ pcl::PCDGrabberBase::numFrames () const
 {
   return (impl_->numFrames ());
 }
+
+///////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::PCDGrabberBase::setPrefetching (std::size_t nr_prefetched, unsigned int nr_threads)
+{
+  impl_->setPrefetching (nr_prefetched, nr_threads);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+bool
+pcl::PCDGrabberBase::seekToFrame (std::size_t idx)
+{
+  return (impl_->seek (idx));
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+bool
+pcl::PCDGrabberBase::seekToTimestamp (std::uint64_t timestamp)
+{
+  bool found = false;
+  std::size_t closest = 0;
+  std::uint64_t closest_distance = 0;
+  for (std::size_t i = 0; i < impl_->numFrames (); ++i)
+  {
+    std::uint64_t frame_timestamp;
+    if (!impl_->getTimestampAtIndex (i, frame_timestamp))
+      continue;
+    const std::uint64_t distance = frame_timestamp > timestamp ? frame_timestamp - timestamp : timestamp - frame_timestamp;
+    if (!found || distance < closest_distance)
+    {
+      found = true;
+      closest = i;
+      closest_distance = distance;
+    }
+  }
+  return (found && impl_->seek (closest));
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+bool
+pcl::PCDGrabberBase::getTimestampAtIndex (std::size_t idx, std::uint64_t &timestamp) const
+{
+  return (impl_->getTimestampAtIndex (idx, timestamp));
+}
@@ -37,6 +37,7 @@
  *
  */
 
+#include <algorithm>
 #include <fstream>
 #include <fcntl.h>
 #include <string>
@@ -44,6 +45,7 @@
 #include <pcl/io/boost.h>
 #include <pcl/common/utils.h> // pcl::utils::ignore
 #include <pcl/common/io.h>
+#include <pcl/io/ascii_parsing.h>
 #include <pcl/io/low_level_io.h>
 #include <pcl/io/lzf.h>
 #include <pcl/io/pcd_io.h>
@@ -52,6 +54,10 @@
 #include <cstring>
 #include <cerrno>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 ///////////////////////////////////////////////////////////////////////////////////////////
 void
 pcl::PCDWriter::setLockingPermissions (const std::string &file_name,
@@ -103,11 +109,262 @@ pcl::PCDWriter::resetLockingPermissions (const std::string &file_name,
 #endif
 }
 
+namespace
+{
+  /** \brief Check whether all the values of a binary cloud are finite. Only the floating point
+    * fields need to be checked. The points are checked in parallel.
+    */
+  bool
+  hasOnlyFiniteValues (const pcl::PCLPointCloud2 &cloud, unsigned int nr_threads)
+  {
+    std::vector<unsigned int> float_fields;
+    for (std::size_t d = 0; d < cloud.fields.size (); ++d)
+      if (cloud.fields[d].datatype == pcl::PCLPointField::FLOAT32 ||
+          cloud.fields[d].datatype == pcl::PCLPointField::FLOAT64)
+        float_fields.push_back (static_cast<unsigned int> (d));
+    if (float_fields.empty ())
+      return (true);
+
+    int point_size = static_cast<int> (cloud.data.size () / (cloud.height * cloud.width));
+    std::ptrdiff_t nr_points = static_cast<std::ptrdiff_t> (cloud.width) * cloud.height;
+    bool is_dense = true;
+#pragma omp parallel for \
+  default(none) \
+  shared(cloud, float_fields, nr_points, point_size) \
+  reduction(&&:is_dense) \
+  num_threads(nr_threads)
+    for (std::ptrdiff_t i = 0; i < nr_points; ++i)
+    {
+      for (const auto &d : float_fields)
+      {
+        for (std::uint32_t c = 0; c < cloud.fields[d].count; ++c)
+        {
+          if (cloud.fields[d].datatype == pcl::PCLPointField::FLOAT32)
+            is_dense = is_dense && pcl::isValueFinite<pcl::traits::asType<pcl::PCLPointField::FLOAT32>::type> (cloud, static_cast<unsigned int> (i), point_size, d, c);
+          else
+            is_dense = is_dense && pcl::isValueFinite<pcl::traits::asType<pcl::PCLPointField::FLOAT64>::type> (cloud, static_cast<unsigned int> (i), point_size, d, c);
+        }
+      }
+    }
+    return (is_dense);
+  }
+
+  /** \brief Get the fields stored in a PCD file (all but the padding ones) and their sizes. */
+  std::size_t
+  getStoredFields (const pcl::PCLPointCloud2 &cloud, std::vector<pcl::PCLPointField> &fields,
+                   std::vector<int> &fields_sizes)
+  {
+    std::size_t fsize = 0;
+    fields.clear ();
+    fields_sizes.clear ();
+    for (const auto &field : cloud.fields)
+    {
+      if (field.name == "_")
+        continue;
+      fields_sizes.push_back (field.count * pcl::getFieldSize (field.datatype));
+      fsize += fields_sizes.back ();
+      fields.push_back (field);
+    }
+    return (fsize);
+  }
+
+  /** \brief Whether a character separates the values of a line of an ASCII PCD file. */
+  inline bool
+  isASCIISeparator (char c)
+  {
+    return (c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f');
+  }
+
+  /** \brief Convert one value of an ASCII PCD file, with the fast conversion if possible and the
+    * same one as copyStringValue otherwise.
+    */
+  template <typename Type> inline void
+  copyASCIIValue (const char *begin, const char *end, pcl::PCLPointCloud2 &cloud, unsigned int point_index,
+                  unsigned int field_idx, unsigned int fields_count, bool &is_dense)
+  {
+    Type value;
+    if (pcl::io::parseNumber (begin, end, value))
+    {
+      if (std::is_floating_point<Type>::value && !std::isfinite (static_cast<double> (value)))
+        is_dense = false;
+      memcpy (&cloud.data[static_cast<std::size_t> (point_index) * cloud.point_step +
+                          cloud.fields[field_idx].offset + fields_count * sizeof (Type)], &value, sizeof (Type));
+      return;
+    }
+
+    // copyStringValue also updates is_dense, which the other threads may be reading
+    bool value_is_dense = true;
+#pragma omp critical (copyStringValue)
+    {
+      const bool was_dense = cloud.is_dense;
+      cloud.is_dense = true;
+      pcl::copyStringValue<Type> (std::string (begin, end), cloud, point_index, field_idx, fields_count);
+      value_is_dense = cloud.is_dense;
+      cloud.is_dense = was_dense;
+    }
+    is_dense = is_dense && value_is_dense;
+  }
+
+  /** \brief Parse the values of a point from a line of an ASCII PCD file.
+    * \return false if the line holds fewer values than the point has
+    */
+  bool
+  parseASCIIPoint (const char *begin, const char *end, pcl::PCLPointCloud2 &cloud, unsigned int idx,
+                   bool &is_dense)
+  {
+    const char *p = begin;
+    for (unsigned int d = 0; d < static_cast<unsigned int> (cloud.fields.size ()); ++d)
+    {
+      const pcl::PCLPointField &field = cloud.fields[d];
+      for (unsigned int c = 0; c < field.count; ++c)
+      {
+        while (p != end && isASCIISeparator (*p))
+          ++p;
+        if (p == end)
+          return (false);
+        const char *token = p;
+        while (p != end && !isASCIISeparator (*p))
+          ++p;
+
+        // Ignore invalid padded dimensions that are inherited from binary data
+        if (field.name == "_")
+          continue;
+
+        switch (field.datatype)
+        {
+          case pcl::PCLPointField::INT8:
+            copyASCIIValue<pcl::traits::asType<pcl::PCLPointField::INT8>::type> (token, p, cloud, idx, d, c, is_dense);
+            break;
+          case pcl::PCLPointField::UINT8:
+            copyASCIIValue<pcl::traits::asType<pcl::PCLPointField::UINT8>::type> (token, p, cloud, idx, d, c, is_dense);
+            break;
+          case pcl::PCLPointField::INT16:
+            copyASCIIValue<pcl::traits::asType<pcl::PCLPointField::INT16>::type> (token, p, cloud, idx, d, c, is_dense);
+            break;
+          case pcl::PCLPointField::UINT16:
+            copyASCIIValue<pcl::traits::asType<pcl::PCLPointField::UINT16>::type> (token, p, cloud, idx, d, c, is_dense);
+            break;
+          case pcl::PCLPointField::INT32:
+            copyASCIIValue<pcl::traits::asType<pcl::PCLPointField::INT32>::type> (token, p, cloud, idx, d, c, is_dense);
+            break;
+          case pcl::PCLPointField::UINT32:
+            copyASCIIValue<pcl::traits::asType<pcl::PCLPointField::UINT32>::type> (token, p, cloud, idx, d, c, is_dense);
+            break;
+          case pcl::PCLPointField::FLOAT32:
+            copyASCIIValue<pcl::traits::asType<pcl::PCLPointField::FLOAT32>::type> (token, p, cloud, idx, d, c, is_dense);
+            break;
+          case pcl::PCLPointField::FLOAT64:
+            copyASCIIValue<pcl::traits::asType<pcl::PCLPointField::FLOAT64>::type> (token, p, cloud, idx, d, c, is_dense);
+            break;
+          default:
+            PCL_WARN ("[pcl::PCDReader::read] Incorrect field data type specified (%d)!\n",cloud.fields[d].datatype);
+            break;
+        }
+      }
+    }
+    return (true);
+  }
+
+  /** \brief Copy the given fields of serialized points into \a cloud, packed in the given order.
+    * \param[in] layout the layout of the serialized points (its data is not used)
+    * \param[in] data the serialized points
+    * \param[in] field_names the names of the fields to copy
+    * \param[out] cloud the resultant cloud
+    * \return false if \a layout has no field with one of the names
+    */
+  bool
+  copySelectedFields (const pcl::PCLPointCloud2 &layout, const std::uint8_t *data,
+                      const std::vector<std::string> &field_names, pcl::PCLPointCloud2 &cloud)
+  {
+    std::vector<pcl::PCLPointField> fields;
+    std::vector<std::uint32_t> source_offsets, fields_sizes;
+    std::uint32_t point_step = 0;
+    for (const auto &name : field_names)
+    {
+      const auto field = std::find_if (layout.fields.cbegin (), layout.fields.cend (),
+                                       [&name] (const pcl::PCLPointField &f) { return (f.name == name); });
+      if (field == layout.fields.cend () || name == "_")
+      {
+        PCL_ERROR ("[pcl::PCDReader::read] No field named '%s' in the file (available dimensions: %s).\n",
+                   name.c_str (), pcl::getFieldsList (layout).c_str ());
+        return (false);
+      }
+      fields.push_back (*field);
+      fields.back ().offset = point_step;
+      source_offsets.push_back (field->offset);
+      fields_sizes.push_back (field->count * pcl::getFieldSize (field->datatype));
+      point_step += fields_sizes.back ();
+    }
+
+    cloud.header = layout.header;
+    cloud.width = layout.width;
+    cloud.height = layout.height;
+    cloud.is_bigendian = layout.is_bigendian;
+    cloud.fields = fields;
+    cloud.point_step = point_step;
+    cloud.row_step = point_step * layout.width;
+    cloud.data.resize (static_cast<std::size_t> (cloud.row_step) * layout.height);
+
+    std::uint8_t *out = cloud.data.data ();
+    for (std::uint32_t row = 0; row < layout.height; ++row)
+    {
+      const std::uint8_t *in = data + static_cast<std::size_t> (row) * layout.row_step;
+      for (std::uint32_t col = 0; col < layout.width; ++col, in += layout.point_step)
+      {
+        for (std::size_t f = 0; f < fields.size (); ++f)
+        {
+          memcpy (out, in + source_offsets[f], fields_sizes[f]);
+          out += fields_sizes[f];
+        }
+      }
+    }
+    return (true);
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::PCDReader::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs ();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::PCDWriter::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs ();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////
 int
 pcl::PCDReader::readHeader (std::istream &fs, pcl::PCLPointCloud2 &cloud,
                             Eigen::Vector4f &origin, Eigen::Quaternionf &orientation, 
                             int &pcd_version, int &data_type, unsigned int &data_idx)
+{
+  return (parseHeader (fs, cloud, origin, orientation, pcd_version, data_type, data_idx, true));
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+int
+pcl::PCDReader::parseHeader (std::istream &fs, pcl::PCLPointCloud2 &cloud,
+                             Eigen::Vector4f &origin, Eigen::Quaternionf &orientation,
+                             int &pcd_version, int &data_type, unsigned int &data_idx,
+                             bool allocate_data)
 {
   // Default values
   data_idx = 0;
@@ -304,7 +561,8 @@ pcl::PCDReader::readHeader (std::istream &fs, pcl::PCLPointCloud2 &cloud,
           throw "Number of POINTS specified before COUNT in header!";
         sstream >> nr_points;
         // Need to allocate: N * point_step
-        cloud.data.resize (nr_points * cloud.point_step);
+        if (allocate_data)
+          cloud.data.resize (nr_points * cloud.point_step);
         continue;
       }
 
@@ -312,7 +570,9 @@ pcl::PCDReader::readHeader (std::istream &fs, pcl::PCLPointCloud2 &cloud,
       if (line_type.substr (0, 4) == "DATA")
       {
         data_idx = static_cast<int> (fs.tellg ());
-        if (st.at (1).substr (0, 17) == "binary_compressed")
+        if (st.at (1) == "binary_compressed_chunked")
+          data_type = 3;
+        else if (st.at (1).substr (0, 17) == "binary_compressed")
          data_type = 2;
         else
           if (st.at (1).substr (0, 6) == "binary")
@@ -428,104 +688,47 @@ pcl::PCDReader::readBodyASCII (std::istream &fs, pcl::PCLPointCloud2 &cloud, int
   // Setting the is_dense property to true by default
   cloud.is_dense = true;
 
+  // The stream is read by large blocks of lines, whose points are then parsed in parallel
+  pcl::io::LineBlockReader reader (fs);
+  std::vector<const char*> lines;
+  std::vector<const char*> begins, ends;
   unsigned int idx = 0;
-  std::string line;
-  std::vector<std::string> st;
-
-  try
+  bool is_dense = true;
+  bool valid = true;
+  while (idx < nr_points && valid && reader.readBlock (lines))
   {
-    while (idx < nr_points && !fs.eof ())
+    // Ignore empty lines
+    begins.clear ();
+    ends.clear ();
+    for (std::size_t i = 0; i + 1 < lines.size () && idx + begins.size () < nr_points; ++i)
     {
-      getline (fs, line);
-      // Ignore empty lines
-      if (line.empty())
-        continue;
-
-      // Tokenize the line
-      boost::trim (line);
-      boost::split (st, line, boost::is_any_of ("\t\r "), boost::token_compress_on);
-
-      if (idx >= nr_points)
-      {
-        PCL_WARN ("[pcl::PCDReader::read] input has more points (%d) than advertised (%d)!\n", idx, nr_points);
-        break;
-      }
-
-      std::size_t total = 0;
-      // Copy data
-      for (unsigned int d = 0; d < static_cast<unsigned int> (cloud.fields.size ()); ++d)
+      const char *p = lines[i];
+      while (p < lines[i + 1] - 1 && isASCIISeparator (*p))
+        ++p;
+      if (p < lines[i + 1] - 1)
       {
-        // Ignore invalid padded dimensions that are inherited from binary data
-        if (cloud.fields[d].name == "_")
-        {
-          total += cloud.fields[d].count; // jump over this many elements in the string token
-          continue;
-        }
-        for (unsigned int c = 0; c < cloud.fields[d].count; ++c)
-        {
-          switch (cloud.fields[d].datatype)
-          {
-            case pcl::PCLPointField::INT8:
-            {
-              copyStringValue<pcl::traits::asType<pcl::PCLPointField::INT8>::type> (
-                  st.at (total + c), cloud, idx, d, c);
-              break;
-            }
-            case pcl::PCLPointField::UINT8:
-            {
-              copyStringValue<pcl::traits::asType<pcl::PCLPointField::UINT8>::type> (
-                  st.at (total + c), cloud, idx, d, c);
-              break;
-            }
-            case pcl::PCLPointField::INT16:
-            {
-              copyStringValue<pcl::traits::asType<pcl::PCLPointField::INT16>::type> (
-                  st.at (total + c), cloud, idx, d, c);
-              break;
-            }
-            case pcl::PCLPointField::UINT16:
-            {
-              copyStringValue<pcl::traits::asType<pcl::PCLPointField::UINT16>::type> (
-                  st.at (total + c), cloud, idx, d, c);
-              break;
-            }
-            case pcl::PCLPointField::INT32:
-            {
-              copyStringValue<pcl::traits::asType<pcl::PCLPointField::INT32>::type> (
-                  st.at (total + c), cloud, idx, d, c);
-              break;
-            }
-            case pcl::PCLPointField::UINT32:
-            {
-              copyStringValue<pcl::traits::asType<pcl::PCLPointField::UINT32>::type> (
-                  st.at (total + c), cloud, idx, d, c);
-              break;
-            }
-            case pcl::PCLPointField::FLOAT32:
-            {
-              copyStringValue<pcl::traits::asType<pcl::PCLPointField::FLOAT32>::type> (
-                  st.at (total + c), cloud, idx, d, c);
-              break;
-            }
-            case pcl::PCLPointField::FLOAT64:
-            {
-              copyStringValue<pcl::traits::asType<pcl::PCLPointField::FLOAT64>::type> (
-                  st.at (total + c), cloud, idx, d, c);
-              break;
-            }
-            default:
-              PCL_WARN ("[pcl::PCDReader::read] Incorrect field data type specified (%d)!\n",cloud.fields[d].datatype);
-              break;
-          }
-        }
-        total += cloud.fields[d].count; // jump over this many elements in the string token
+        begins.push_back (p);
+        ends.push_back (lines[i + 1] - 1);
       }
-      idx++;
     }
+
+    const std::ptrdiff_t nr_block_points = static_cast<std::ptrdiff_t> (begins.size ());
+#pragma omp parallel for \
+  default(none) \
+  shared(begins, cloud, ends, idx, nr_block_points) \
+  reduction(&&:is_dense, valid) \
+  num_threads(threads_)
+    for (std::ptrdiff_t i = 0; i < nr_block_points; ++i)
+      valid = valid && parseASCIIPoint (begins[i], ends[i], cloud, idx + static_cast<unsigned int> (i), is_dense);
+    idx += static_cast<unsigned int> (begins.size ());
   }
-  catch (const char *exception)
+  if (idx == nr_points)
+    reader.putBack ();
+  cloud.is_dense = is_dense;
+
+  if (!valid)
   {
-    PCL_ERROR ("[pcl::PCDReader::read] %s\n", exception);
+    PCL_ERROR ("[pcl::PCDReader::read] A line of the file does not hold all the values of a point!\n");
     return (-1);
   }
 
@@ -613,69 +816,98 @@ pcl::PCDReader::readBodyBinary (const unsigned char *map, pcl::PCLPointCloud2 &c
     memcpy (&cloud.data[0], &map[0] + data_idx, cloud.data.size ());
 
   // Extra checks (not needed for ASCII)
-  int point_size = static_cast<int> (cloud.data.size () / (cloud.height * cloud.width));
   // Once copied, we need to go over each field and check if it has NaN/Inf values and assign cloud.is_dense to true or false
-  for (std::uint32_t i = 0; i < cloud.width * cloud.height; ++i)
+  cloud.is_dense = hasOnlyFiniteValues (cloud, threads_);
+
+  return (0);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+pcl::PCDReader::readBodyBinaryCompressedChunked (const unsigned char *map, std::size_t map_size,
+                                                 pcl::PCLPointCloud2 &cloud, std::size_t data_idx)
+{
+  // The index: the number of chunks, the number of points per chunk, then the sizes of every chunk
+  std::uint32_t nr_chunks = 0, chunk_size = 0;
+  if (data_idx + 8 > map_size)
   {
-    for (unsigned int d = 0; d < static_cast<unsigned int> (cloud.fields.size ()); ++d)
+    PCL_ERROR ("[pcl::PCDReader::read] Corrupted PCD file. The chunk index is missing!\n");
+    return (-1);
+  }
+  memcpy (&nr_chunks, &map[data_idx + 0], 4);
+  memcpy (&chunk_size, &map[data_idx + 4], 4);
+  std::size_t nr_points = static_cast<std::size_t> (cloud.width) * cloud.height;
+  if (chunk_size == 0 || nr_chunks != (nr_points + chunk_size - 1) / chunk_size ||
+      data_idx + 8 + 8 * static_cast<std::size_t> (nr_chunks) > map_size)
+  {
+    PCL_ERROR ("[pcl::PCDReader::read] Corrupted PCD file. Invalid chunk index (%u chunks of %u points for %zu points)!\n",
+               nr_chunks, chunk_size, nr_points);
+    return (-1);
+  }
+
+  std::vector<std::size_t> chunk_offsets (nr_chunks + 1);
+  std::vector<std::uint32_t> compressed_sizes (nr_chunks), uncompressed_sizes (nr_chunks);
+  chunk_offsets[0] = data_idx + 8 + 8 * static_cast<std::size_t> (nr_chunks);
+  for (std::size_t c = 0; c < nr_chunks; ++c)
+  {
+    memcpy (&compressed_sizes[c], &map[data_idx + 8 + 8 * c + 0], 4);
+    memcpy (&uncompressed_sizes[c], &map[data_idx + 8 + 8 * c + 4], 4);
+    chunk_offsets[c + 1] = chunk_offsets[c] + compressed_sizes[c];
+  }
+  if (chunk_offsets.back () > map_size)
+  {
+    PCL_ERROR ("[pcl::PCDReader::read] Corrupted PCD file. The file is smaller than expected!\n");
+    return (-1);
+  }
+
+  std::vector<pcl::PCLPointField> fields;
+  std::vector<int> fields_sizes;
+  std::size_t fsize = getStoredFields (cloud, fields, fields_sizes);
+  std::size_t point_step = cloud.point_step;
+  cloud.data.resize (nr_points * point_step);
+
+  // Every chunk holds the planes (xxyyzz) of its points only, so the chunks are independent
+  int nr_failed = 0;
+#pragma omp parallel for \
+  default(none) \
+  shared(chunk_offsets, chunk_size, cloud, compressed_sizes, fields, fields_sizes, fsize, map, nr_chunks, nr_points, point_step, uncompressed_sizes) \
+  reduction(+:nr_failed) \
+  schedule(dynamic, 1) \
+  num_threads(threads_)
+  for (std::ptrdiff_t c = 0; c < static_cast<std::ptrdiff_t> (nr_chunks); ++c)
+  {
+    const std::size_t begin = static_cast<std::size_t> (c) * chunk_size;
+    const std::size_t end = std::min (begin + chunk_size, nr_points);
+    const std::size_t chunk_data_size = (end - begin) * fsize;
+    if (uncompressed_sizes[c] != chunk_data_size)
     {
-      for (std::uint32_t c = 0; c < cloud.fields[d].count; ++c)
-      {
-        switch (cloud.fields[d].datatype)
-        {
-          case pcl::PCLPointField::INT8:
-          {
-            if (!isValueFinite<pcl::traits::asType<pcl::PCLPointField::INT8>::type> (cloud, i, point_size, d, c))
-              cloud.is_dense = false;
-            break;
-          }
-          case pcl::PCLPointField::UINT8:
-          {
-            if (!isValueFinite<pcl::traits::asType<pcl::PCLPointField::UINT8>::type> (cloud, i, point_size, d, c))
-              cloud.is_dense = false;
-            break;
-          }
-          case pcl::PCLPointField::INT16:
-          {
-            if (!isValueFinite<pcl::traits::asType<pcl::PCLPointField::INT16>::type> (cloud, i, point_size, d, c))
-              cloud.is_dense = false;
-            break;
-          }
-          case pcl::PCLPointField::UINT16:
-          {
-            if (!isValueFinite<pcl::traits::asType<pcl::PCLPointField::UINT16>::type> (cloud, i, point_size, d, c))
-              cloud.is_dense = false;
-            break;
-          }
-          case pcl::PCLPointField::INT32:
-          {
-            if (!isValueFinite<pcl::traits::asType<pcl::PCLPointField::INT32>::type> (cloud, i, point_size, d, c))
-              cloud.is_dense = false;
-            break;
-          }
-          case pcl::PCLPointField::UINT32:
-          {
-            if (!isValueFinite<pcl::traits::asType<pcl::PCLPointField::UINT32>::type> (cloud, i, point_size, d, c))
-              cloud.is_dense = false;
-            break;
-          }
-          case pcl::PCLPointField::FLOAT32:
-          {
-            if (!isValueFinite<pcl::traits::asType<pcl::PCLPointField::FLOAT32>::type> (cloud, i, point_size, d, c))
-              cloud.is_dense = false;
-            break;
-          }
-          case pcl::PCLPointField::FLOAT64:
-          {
-            if (!isValueFinite<pcl::traits::asType<pcl::PCLPointField::FLOAT64>::type> (cloud, i, point_size, d, c))
-              cloud.is_dense = false;
-            break;
-          }
-        }
-      }
+      ++nr_failed;
+      continue;
+    }
+
+    std::vector<char> buf (chunk_data_size);
+    unsigned int tmp_size = pcl::lzfDecompress (&map[chunk_offsets[c]], compressed_sizes[c],
+                                                buf.data (), static_cast<unsigned int> (chunk_data_size));
+    if (tmp_size != chunk_data_size)
+    {
+      ++nr_failed;
+      continue;
+    }
+
+    const char *plane = buf.data ();
+    for (std::size_t j = 0; j < fields.size (); ++j)
+    {
+      for (std::size_t i = begin; i < end; ++i, plane += fields_sizes[j])
+        memcpy (&cloud.data[i * point_step + fields[j].offset], plane, fields_sizes[j]);
     }
   }
+  if (nr_failed > 0)
+  {
+    PCL_ERROR ("[pcl::PCDReader::read] Could not decompress %d of %u chunks. Data corruption?\n", nr_failed, nr_chunks);
+    return (-1);
+  }
 
+  cloud.is_dense = hasOnlyFiniteValues (cloud, threads_);
   return (0);
 }
 
@@ -739,7 +971,12 @@ pcl::PCDReader::read (const std::string &file_name, pcl::PCLPointCloud2 &cloud,
     io::raw_lseek (fd, 0, SEEK_SET);
 
     std::size_t mmap_size = offset + data_idx;   // ...because we mmap from the start of the file.
-    if (data_type == 2)
+    if (data_type == 3)
+    {
+      // The size of the chunks is only known from the index at the beginning of the data
+      mmap_size = file_size;
+    }
+    else if (data_type == 2)
     {
       // Seek to real start of data.
       long result = io::raw_lseek (fd, offset + data_idx, SEEK_SET);
@@ -805,7 +1042,10 @@ pcl::PCDReader::read (const std::string &file_name, pcl::PCLPointCloud2 &cloud,
     }
 #endif
 
-    res = readBodyBinary (map, cloud, pcd_version, data_type == 2, offset + data_idx);
+    if (data_type == 3)
+      res = readBodyBinaryCompressedChunked (map, mmap_size, cloud, offset + data_idx);
+    else
+      res = readBodyBinary (map, cloud, pcd_version, data_type == 2, offset + data_idx);
 
     // Unmap the pages of memory
 #ifdef _WIN32
@@ -844,6 +1084,186 @@ pcl::PCDReader::read (const std::string &file_name, pcl::PCLPointCloud2 &cloud,
   return (0);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+pcl::PCDReader::read (const std::string &file_name, pcl::PCLPointCloud2 &cloud,
+                      const std::vector<std::string> &field_names, const int offset)
+{
+  int data_type = 0;
+  {
+    pcl::PCLPointCloud2 layout;
+    Eigen::Vector4f origin;
+    Eigen::Quaternionf orientation;
+    int pcd_version;
+    unsigned int data_idx;
+    std::ifstream fs (file_name.c_str (), std::ios::binary);
+    if (!fs.is_open () || fs.fail ())
+    {
+      PCL_ERROR ("[pcl::PCDReader::read] Could not open file '%s'.\n", file_name.c_str ());
+      return (-1);
+    }
+    fs.seekg (offset, std::ios::beg);
+    if (parseHeader (fs, layout, origin, orientation, pcd_version, data_type, data_idx, false) < 0)
+      return (-1);
+  }
+
+  // Binary files are mapped, only the pages holding the points are read and nothing else is copied
+  if (data_type == 1)
+  {
+    pcl::PCDMappedFile file;
+    if (file.open (file_name, offset) < 0 || file.read (cloud, field_names) < 0)
+      return (-1);
+    return (0);
+  }
+
+  // The other formats have to be decoded completely
+  pcl::PCLPointCloud2 full;
+  if (read (file_name, full, offset) < 0)
+    return (-1);
+  if (!copySelectedFields (full, full.data.data (), field_names, cloud))
+    return (-1);
+  cloud.is_dense = full.is_dense;
+  return (0);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+pcl::PCDMappedFile::PCDMappedFile ()
+  : map_ (nullptr)
+  , map_size_ (0)
+  , data_offset_ (0)
+  , fd_ (-1)
+  , file_mapping_ (nullptr)
+  , origin_ (Eigen::Vector4f::Zero ())
+  , orientation_ (Eigen::Quaternionf::Identity ())
+{
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+pcl::PCDMappedFile::~PCDMappedFile ()
+{
+  close ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+pcl::PCDMappedFile::open (const std::string &file_name, const int offset)
+{
+  close ();
+
+  if (file_name.empty () || !boost::filesystem::exists (file_name))
+  {
+    PCL_ERROR ("[pcl::PCDMappedFile::open] Could not find file '%s'.\n", file_name.c_str ());
+    return (-1);
+  }
+
+  int pcd_version, data_type;
+  unsigned int data_idx;
+  {
+    std::ifstream fs (file_name.c_str (), std::ios::binary);
+    if (!fs.is_open () || fs.fail ())
+    {
+      PCL_ERROR ("[pcl::PCDMappedFile::open] Could not open file '%s'! Error : %s\n", file_name.c_str (), strerror (errno));
+      return (-1);
+    }
+    fs.seekg (offset, std::ios::beg);
+    pcl::PCDReader reader;
+    if (reader.parseHeader (fs, layout_, origin_, orientation_, pcd_version, data_type, data_idx, false) < 0)
+      return (-1);
+  }
+  if (data_type != 1)
+  {
+    PCL_ERROR ("[pcl::PCDMappedFile::open] Only binary PCD files can be mapped, %s is %s.\n",
+               file_name.c_str (), data_type == 0 ? "an ASCII one" : "a compressed one");
+    return (-1);
+  }
+  // The points are not checked
+  layout_.is_dense = false;
+
+  fd_ = io::raw_open (file_name.c_str (), O_RDONLY);
+  if (fd_ == -1)
+  {
+    PCL_ERROR ("[pcl::PCDMappedFile::open] Failure to open file %s\n", file_name.c_str () );
+    return (-1);
+  }
+
+  const std::size_t file_size = io::raw_lseek (fd_, 0, SEEK_END);
+  io::raw_lseek (fd_, 0, SEEK_SET);
+  data_offset_ = offset + data_idx;
+  map_size_ = data_offset_ + static_cast<std::size_t> (layout_.row_step) * layout_.height;
+  if (map_size_ > file_size)
+  {
+    PCL_ERROR ("[pcl::PCDMappedFile::open] Corrupted PCD file. The file is smaller than expected!\n");
+    close ();
+    return (-1);
+  }
+
+#ifdef _WIN32
+  HANDLE fm = CreateFileMapping ((HANDLE) _get_osfhandle (fd_), NULL, PAGE_READONLY, 0, 0, NULL);
+  std::uint8_t *map = static_cast<std::uint8_t*> (MapViewOfFile (fm, FILE_MAP_READ, 0, 0, 0));
+  if (map == NULL)
+  {
+    CloseHandle (fm);
+    PCL_ERROR ("[pcl::PCDMappedFile::open] Error mapping view of file, %s\n", file_name.c_str ());
+    close ();
+    return (-1);
+  }
+  file_mapping_ = fm;
+#else
+  std::uint8_t *map = static_cast<std::uint8_t*> (::mmap (nullptr, map_size_, PROT_READ, MAP_SHARED, fd_, 0));
+  if (map == reinterpret_cast<std::uint8_t*> (-1))    // MAP_FAILED
+  {
+    PCL_ERROR ("[pcl::PCDMappedFile::open] Error preparing mmap for binary PCD file.\n");
+    close ();
+    return (-1);
+  }
+#endif
+  map_ = map;
+  return (0);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::PCDMappedFile::close ()
+{
+  if (map_)
+  {
+#ifdef _WIN32
+    UnmapViewOfFile (map_);
+#else
+    if (::munmap (map_, map_size_) == -1)
+      PCL_ERROR ("[pcl::PCDMappedFile::close] Munmap failure\n");
+#endif
+    map_ = nullptr;
+  }
+#ifdef _WIN32
+  if (file_mapping_)
+    CloseHandle (static_cast<HANDLE> (file_mapping_));
+#endif
+  file_mapping_ = nullptr;
+  if (fd_ != -1)
+  {
+    io::raw_close (fd_);
+    fd_ = -1;
+  }
+  map_size_ = data_offset_ = 0;
+  layout_ = pcl::PCLPointCloud2 ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+pcl::PCDMappedFile::read (pcl::PCLPointCloud2 &cloud, const std::vector<std::string> &field_names) const
+{
+  if (!isOpen ())
+  {
+    PCL_ERROR ("[pcl::PCDMappedFile::read] No file is mapped.\n");
+    return (-1);
+  }
+  if (!copySelectedFields (layout_, getData (), field_names, cloud))
+    return (-1);
+  cloud.is_dense = cloud.data.empty () || hasOnlyFiniteValues (cloud, 1);
+  return (0);
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 std::string
 pcl::PCDWriter::generateHeaderASCII (const pcl::PCLPointCloud2 &cloud,
@@ -1543,3 +1963,119 @@ pcl::PCDWriter::writeBinaryCompressed (const std::string &file_name, const pcl::
   return (0);
 }
 
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+pcl::PCDWriter::writeBinaryCompressedChunked (std::ostream &os, const pcl::PCLPointCloud2 &cloud,
+                                              const Eigen::Vector4f &origin, const Eigen::Quaternionf &orientation)
+{
+  if (cloud.data.empty ())
+  {
+    PCL_ERROR ("[pcl::PCDWriter::writeBinaryCompressedChunked] Input point cloud has no data!\n");
+    return (-1);
+  }
+
+  if (generateHeaderBinaryCompressed (os, cloud, origin, orientation))
+  {
+    return (-1);
+  }
+
+  std::vector<pcl::PCLPointField> fields;
+  std::vector<int> fields_sizes;
+  std::size_t fsize = getStoredFields (cloud, fields, fields_sizes);
+  std::size_t nr_points = static_cast<std::size_t> (cloud.width) * cloud.height;
+  std::size_t chunk_size = std::min<std::size_t> (chunk_size_, nr_points);
+  std::size_t nr_chunks = (nr_points + chunk_size - 1) / chunk_size;
+
+  // The sizes of every chunk are stored on 32 bits
+  if (chunk_size * fsize * 3 / 2 > std::numeric_limits<std::uint32_t>::max () ||
+      nr_chunks > std::numeric_limits<std::uint32_t>::max ())
+  {
+    PCL_ERROR ("[pcl::PCDWriter::writeBinaryCompressedChunked] The chunks of %zu points exceed the maximum size of %zu bytes, use smaller chunks.\n",
+               chunk_size, static_cast<std::size_t> (std::numeric_limits<std::uint32_t>::max ()) * 2 / 3);
+    return (-2);
+  }
+
+  // Every chunk is converted from XYZRGBXYZRGB to XXYYZZRGBRGB (as for binary_compressed, but only
+  // over the points of the chunk) and compressed on its own
+  std::vector<std::vector<char> > chunks (nr_chunks);
+  int nr_failed = 0;
+#pragma omp parallel for \
+  default(none) \
+  shared(chunk_size, chunks, cloud, fields, fields_sizes, fsize, nr_chunks, nr_points) \
+  reduction(+:nr_failed) \
+  schedule(dynamic, 1) \
+  num_threads(threads_)
+  for (std::ptrdiff_t c = 0; c < static_cast<std::ptrdiff_t> (nr_chunks); ++c)
+  {
+    const std::size_t begin = static_cast<std::size_t> (c) * chunk_size;
+    const std::size_t end = std::min (begin + chunk_size, nr_points);
+    const std::size_t chunk_data_size = (end - begin) * fsize;
+
+    std::vector<char> planes (chunk_data_size);
+    char *plane = planes.data ();
+    for (std::size_t j = 0; j < fields.size (); ++j)
+    {
+      for (std::size_t i = begin; i < end; ++i, plane += fields_sizes[j])
+        memcpy (plane, &cloud.data[i * cloud.point_step + fields[j].offset], fields_sizes[j]);
+    }
+
+    // Tiny chunks may grow a little when compressed
+    std::vector<char> &chunk = chunks[c];
+    chunk.resize (chunk_data_size * 3 / 2 + 16);
+    unsigned int compressed_size = pcl::lzfCompress (planes.data (), static_cast<unsigned int> (chunk_data_size),
+                                                     chunk.data (), static_cast<unsigned int> (chunk.size ()));
+    if (compressed_size == 0)
+      ++nr_failed;
+    chunk.resize (compressed_size);
+  }
+  if (nr_failed > 0)
+  {
+    PCL_ERROR ("[pcl::PCDWriter::writeBinaryCompressedChunked] Could not compress %d of %zu chunks!\n", nr_failed, nr_chunks);
+    return (-1);
+  }
+
+  os.imbue (std::locale::classic ());
+  os << "DATA binary_compressed_chunked\n";
+
+  // The index, then the chunks
+  std::vector<std::uint32_t> index (2 + 2 * nr_chunks);
+  index[0] = static_cast<std::uint32_t> (nr_chunks);
+  index[1] = static_cast<std::uint32_t> (chunk_size);
+  for (std::size_t c = 0; c < nr_chunks; ++c)
+  {
+    index[2 + 2 * c + 0] = static_cast<std::uint32_t> (chunks[c].size ());
+    index[2 + 2 * c + 1] = static_cast<std::uint32_t> ((std::min ((c + 1) * chunk_size, nr_points) - c * chunk_size) * fsize);
+  }
+  os.write (reinterpret_cast<const char*> (index.data ()), index.size () * sizeof (std::uint32_t));
+  for (const auto &chunk : chunks)
+    os.write (chunk.data (), chunk.size ());
+  os.flush ();
+
+  return (os ? 0 : -1);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+pcl::PCDWriter::writeBinaryCompressedChunked (const std::string &file_name, const pcl::PCLPointCloud2 &cloud,
+                                              const Eigen::Vector4f &origin, const Eigen::Quaternionf &orientation)
+{
+  std::ofstream fs;
+  fs.open (file_name.c_str (), std::ios::binary);
+  if (!fs.is_open () || fs.fail ())
+  {
+    PCL_ERROR ("[pcl::PCDWriter::writeBinaryCompressedChunked] Could not open file '%s' for writing!\n", file_name.c_str ());
+    return (-1);
+  }
+
+  // Mandatory lock file
+  boost::interprocess::file_lock file_lock;
+  setLockingPermissions (file_name, file_lock);
+
+  int status = writeBinaryCompressedChunked (fs, cloud, origin, orientation);
+  fs.close ();
+  resetLockingPermissions (file_name, file_lock);
+  if (status)
+    PCL_ERROR ("[pcl::PCDWriter::writeBinaryCompressedChunked] Error while writing '%s'!\n", file_name.c_str ());
+  return (status);
+}
+
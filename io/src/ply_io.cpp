@@ -40,16 +40,22 @@
 #include <pcl/io/ply_io.h>
 #include <pcl/io/boost.h>
 
+#include <algorithm>
 #include <cstdlib>
 #include <fstream>
 #include <functional>
 #include <string>
 #include <tuple>
+#include <utility>
 
 // https://www.boost.org/doc/libs/1_70_0/libs/filesystem/doc/index.htm#Coding-guidelines
 #define BOOST_FILESYSTEM_NO_DEPRECATED
 #include <boost/filesystem.hpp>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace fs = boost::filesystem;
 
 std::tuple<std::function<void ()>, std::function<void ()> >
@@ -577,6 +583,282 @@ pcl::PLYReader::readHeader (const std::string &file_name, pcl::PCLPointCloud2 &c
   return 0;
 }
 
+////////////////////////////////////////////////////////////////////////////////////////
+namespace
+{
+  /** \brief How a vertex property of a binary PLY file is stored in the cloud. */
+  struct PLYVertexProperty
+  {
+    enum Conversion
+    {
+      COPY,       // the value as is
+      RGB,        // three uint8 red, green and blue properties, packed into a float rgb field
+      ALPHA,      // a uint8, packed into the rgba field
+      INTENSITY   // a uint8, converted to a float
+    };
+
+    Conversion conversion;
+    std::uint8_t datatype;
+    std::size_t size;
+    std::size_t file_offset;
+    std::size_t cloud_offset;
+  };
+
+  /** \brief Get the PCLPointField datatype of a PLY scalar type, 0 if unknown. */
+  std::uint8_t
+  getPLYDatatype (const std::string &type)
+  {
+    if (type == "int8" || type == "char")
+      return (pcl::PCLPointField::INT8);
+    if (type == "uint8" || type == "uchar")
+      return (pcl::PCLPointField::UINT8);
+    if (type == "int16" || type == "short")
+      return (pcl::PCLPointField::INT16);
+    if (type == "uint16" || type == "ushort")
+      return (pcl::PCLPointField::UINT16);
+    if (type == "int32" || type == "int")
+      return (pcl::PCLPointField::INT32);
+    if (type == "uint32" || type == "uint")
+      return (pcl::PCLPointField::UINT32);
+    if (type == "float32" || type == "float")
+      return (pcl::PCLPointField::FLOAT32);
+    if (type == "float64" || type == "double")
+      return (pcl::PCLPointField::FLOAT64);
+    return (0);
+  }
+
+  inline void
+  copySwapped (std::uint8_t *destination, const std::uint8_t *source, std::size_t size, bool swap)
+  {
+    if (swap)
+      std::reverse_copy (source, source + size, destination);
+    else
+      memcpy (destination, source, size);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::PLYReader::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs ();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+int
+pcl::PLYReader::readBinaryVertices (const std::string &file_name, pcl::PCLPointCloud2 &cloud)
+{
+  std::ifstream fs (file_name.c_str (), std::ios::in | std::ios::binary);
+  std::string line;
+  if (!std::getline (fs, line) || boost::trim_right_copy (line) != "ply")
+    return (1);
+
+  // Parse the header, giving up on anything the callbacks would treat specially
+  bool big_endian = false;
+  bool in_vertex = false, vertex_done = false;
+  std::size_t vertex_count = 0;
+  std::vector<std::string> property_names;
+  std::vector<std::uint8_t> property_types;
+  std::vector<std::string> st;
+  while (std::getline (fs, line))
+  {
+    boost::trim (line);
+    if (line.empty ())
+      continue;
+    boost::split (st, line, boost::is_any_of ("\t "), boost::token_compress_on);
+    if (st[0] == "comment")
+      continue;
+    if (st[0] == "end_header")
+      break;
+    if (st[0] == "format")
+    {
+      if (st.size () != 3 || (st[1] != "binary_little_endian" && st[1] != "binary_big_endian"))
+        return (1);
+      big_endian = (st[1] == "binary_big_endian");
+    }
+    else if (st[0] == "element" && st.size () == 3)
+    {
+      if (st[1] == "camera" || st[1] == "range_grid")
+        return (1);
+      vertex_done = vertex_done || in_vertex;
+      in_vertex = (st[1] == "vertex");
+      // The vertices must come first, and only once
+      if ((in_vertex && vertex_done) || (!in_vertex && !vertex_done))
+        return (1);
+      if (in_vertex && !boost::conversion::try_lexical_convert (st[2], vertex_count))
+        return (1);
+    }
+    else if (st[0] == "property" && st.size () == 3)
+    {
+      if (in_vertex)
+      {
+        property_types.push_back (getPLYDatatype (st[1]));
+        property_names.push_back (st[2]);
+        if (property_types.back () == 0)
+          return (1);
+      }
+    }
+    else if (!(st[0] == "property" && st.size () == 5 && st[1] == "list" && !in_vertex))
+      return (1);
+  }
+  if (!fs || property_names.empty ())
+    return (1);
+  const std::streampos data_start = fs.tellg ();
+
+  // Lay out the fields the same way as the callbacks do
+  const auto is_color = [&] (std::size_t i, const char *color)
+  {
+    return (i < property_names.size () && property_types[i] == pcl::PCLPointField::UINT8 &&
+            (property_names[i] == color || property_names[i] == std::string ("diffuse_") + color));
+  };
+  std::vector<pcl::PCLPointField> fields;
+  std::vector<PLYVertexProperty> properties;
+  std::size_t vertex_size = 0;
+  std::uint32_t point_step = 0;
+  int rgb_field = -1;
+  for (std::size_t i = 0; i < property_names.size (); ++i)
+  {
+    PLYVertexProperty property;
+    property.conversion = PLYVertexProperty::COPY;
+    property.datatype = property_types[i];
+    property.size = pcl::getFieldSize (property_types[i]);
+    property.file_offset = vertex_size;
+    property.cloud_offset = point_step;
+    vertex_size += property.size;
+
+    pcl::PCLPointField field;
+    field.name = property_names[i];
+    field.offset = point_step;
+    field.datatype = property_types[i];
+    field.count = 1;
+    if (is_color (i, "red"))
+    {
+      if (!is_color (i + 1, "green") || !is_color (i + 2, "blue") || rgb_field >= 0)
+        return (1);
+      property.conversion = PLYVertexProperty::RGB;
+      field.name = "rgb";
+      field.datatype = pcl::PCLPointField::FLOAT32;
+      rgb_field = static_cast<int> (fields.size ());
+      vertex_size += 2;
+      i += 2;
+    }
+    else if (is_color (i, "green") || is_color (i, "blue"))
+      return (1);
+    else if (is_color (i, "alpha"))
+    {
+      if (rgb_field < 0)
+        return (1);
+      property.conversion = PLYVertexProperty::ALPHA;
+      property.cloud_offset = fields[rgb_field].offset;
+      fields[rgb_field].name = "rgba";
+      fields[rgb_field].datatype = pcl::PCLPointField::UINT32;
+      properties.push_back (property);
+      continue;
+    }
+    else if (is_color (i, "intensity"))
+    {
+      property.conversion = PLYVertexProperty::INTENSITY;
+      field.datatype = pcl::PCLPointField::FLOAT32;
+    }
+    point_step += pcl::getFieldSize (field.datatype);
+    fields.push_back (field);
+    properties.push_back (property);
+  }
+
+  cloud.fields = fields;
+  cloud.width = static_cast<std::uint32_t> (vertex_count);
+  cloud.height = 1;
+  cloud.point_step = point_step;
+  cloud.row_step = point_step * cloud.width;
+  cloud.is_bigendian = false;
+  cloud.data.resize (static_cast<std::size_t> (point_step) * vertex_count);
+
+  const std::uint16_t endianness_test = 1;
+  const bool swap = (big_endian == (*reinterpret_cast<const std::uint8_t*> (&endianness_test) == 1));
+
+  // Read the vertices by blocks, and decode each block in parallel
+  fs.seekg (data_start);
+  const std::size_t block_size = std::max<std::size_t> ((32 << 20) / vertex_size, 1);
+  std::vector<std::uint8_t> buffer (std::min (block_size, vertex_count) * vertex_size);
+  bool is_dense = true;
+  for (std::size_t block_begin = 0; block_begin < vertex_count; block_begin += block_size)
+  {
+    const std::ptrdiff_t nr_block_vertices = static_cast<std::ptrdiff_t> (std::min (block_size, vertex_count - block_begin));
+    fs.read (reinterpret_cast<char*> (buffer.data ()), nr_block_vertices * vertex_size);
+    if (!fs)
+    {
+      PCL_ERROR ("[pcl::PLYReader::read] The file %s is smaller than its header tells!\n", file_name.c_str ());
+      return (-1);
+    }
+
+    std::uint8_t *block = &cloud.data[block_begin * point_step];
+#pragma omp parallel for \
+  default(none) \
+  shared(block, buffer, nr_block_vertices, point_step, properties, swap, vertex_size) \
+  reduction(&&:is_dense) \
+  num_threads(threads_)
+    for (std::ptrdiff_t v = 0; v < nr_block_vertices; ++v)
+    {
+      const std::uint8_t *in = &buffer[v * vertex_size];
+      std::uint8_t *out = block + v * point_step;
+      for (const auto &property : properties)
+      {
+        switch (property.conversion)
+        {
+          case PLYVertexProperty::COPY:
+          {
+            copySwapped (out + property.cloud_offset, in + property.file_offset, property.size, swap);
+            if (property.datatype == pcl::PCLPointField::FLOAT32)
+            {
+              float value;
+              memcpy (&value, out + property.cloud_offset, sizeof (float));
+              is_dense = is_dense && std::isfinite (value);
+            }
+            else if (property.datatype == pcl::PCLPointField::FLOAT64)
+            {
+              double value;
+              memcpy (&value, out + property.cloud_offset, sizeof (double));
+              is_dense = is_dense && std::isfinite (value);
+            }
+            break;
+          }
+          case PLYVertexProperty::RGB:
+          {
+            const std::int32_t rgb = std::int32_t (in[property.file_offset]) << 16 |
+                                     std::int32_t (in[property.file_offset + 1]) << 8 |
+                                     std::int32_t (in[property.file_offset + 2]);
+            memcpy (out + property.cloud_offset, &rgb, sizeof (std::int32_t));
+            break;
+          }
+          case PLYVertexProperty::ALPHA:
+          {
+            std::uint32_t rgba;
+            memcpy (&rgba, out + property.cloud_offset, sizeof (std::uint32_t));
+            rgba |= std::uint32_t (in[property.file_offset]) << 24;
+            memcpy (out + property.cloud_offset, &rgba, sizeof (std::uint32_t));
+            break;
+          }
+          case PLYVertexProperty::INTENSITY:
+          {
+            const float intensity (in[property.file_offset]);
+            memcpy (out + property.cloud_offset, &intensity, sizeof (float));
+            break;
+          }
+        }
+      }
+    }
+  }
+  cloud.is_dense = is_dense;
+  return (0);
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////
 int
 pcl::PLYReader::read (const std::string &file_name, pcl::PCLPointCloud2 &cloud,
@@ -592,7 +874,17 @@ pcl::PLYReader::read (const std::string &file_name, pcl::PCLPointCloud2 &cloud,
     return (-1);
   }
 
-  if (this->readHeader (file_name, cloud, origin, orientation, ply_version, data_type, data_idx))
+  // Most binary files can be read without going through the callbacks
+  const int bulk_result = readBinaryVertices (file_name, cloud);
+  if (bulk_result < 0)
+    return (-1);
+  if (bulk_result == 0)
+  {
+    cloud_ = &cloud;
+    origin = Eigen::Vector4f::Zero ();
+    orientation = Eigen::Quaternionf::Identity ();
+  }
+  else if (this->readHeader (file_name, cloud, origin, orientation, ply_version, data_type, data_idx))
   {
     PCL_ERROR ("[pcl::PLYReader::read] problem parsing header!\n");
     return (-1);
@@ -600,7 +892,7 @@ pcl::PLYReader::read (const std::string &file_name, pcl::PCLPointCloud2 &cloud,
 
   // a range_grid element was found ?
   std::size_t r_size;
-  if ((r_size  = (*range_grid_).size ()) > 0 && r_size != vertex_count_)
+  if (bulk_result > 0 && (r_size  = (*range_grid_).size ()) > 0 && r_size != vertex_count_)
   {
     //cloud.header = cloud_->header;
     std::vector<std::uint8_t> data ((*range_grid_).size () * cloud.point_step);
@@ -1460,10 +1752,14 @@ pcl::PLYWriter::writeBinary (const std::string &file_name,
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////
-int
-pcl::io::savePLYFile (const std::string &file_name, const pcl::PolygonMesh &mesh, unsigned precision)
+/** \brief Save a mesh in ascii PLY format, given its vertex data and a functor
+  * returning the [begin, end) range of the vertex indices of every face.
+  */
+template <typename FaceFunctor> static int
+savePLYMesh (const std::string &file_name, const pcl::PCLPointCloud2 &cloud,
+             std::size_t nr_faces, const FaceFunctor &face, unsigned precision)
 {
-  if (mesh.cloud.data.empty ())
+  if (cloud.data.empty ())
   {
     PCL_ERROR ("[pcl::io::savePLYFile] Input point cloud has no data!\n");
     return (-1);
@@ -1479,24 +1775,21 @@ pcl::io::savePLYFile (const std::string &file_name, const pcl::PolygonMesh &mesh
   }
 
   // number of points
-  std::size_t nr_points  = mesh.cloud.width * mesh.cloud.height;
-  std::size_t point_size = mesh.cloud.data.size () / nr_points;
-
-  // number of faces
-  std::size_t nr_faces = mesh.polygons.size ();
+  std::size_t nr_points  = cloud.width * cloud.height;
+  std::size_t point_size = cloud.data.size () / nr_points;
 
   // Write header
   fs << "ply";
   fs << "\nformat ascii 1.0";
   fs << "\ncomment PCL generated";
   // Vertices
-  fs << "\nelement vertex "<< mesh.cloud.width * mesh.cloud.height;
+  fs << "\nelement vertex "<< cloud.width * cloud.height;
   fs << "\nproperty float x"
         "\nproperty float y"
         "\nproperty float z";
   // Check if we have color on vertices
-  int rgba_index = getFieldIndex (mesh.cloud, "rgba"),
-  rgb_index = getFieldIndex (mesh.cloud, "rgb");
+  int rgba_index = getFieldIndex (cloud, "rgba"),
+  rgb_index = getFieldIndex (cloud, "rgb");
   if (rgba_index != -1)
   {
     fs << "\nproperty uchar red"
@@ -1511,9 +1804,9 @@ pcl::io::savePLYFile (const std::string &file_name, const pcl::PolygonMesh &mesh
           "\nproperty uchar blue";
   }
   // Check if we have normal on vertices
-  int normal_x_index = getFieldIndex(mesh.cloud, "normal_x");
-  int normal_y_index = getFieldIndex(mesh.cloud, "normal_y");
-  int normal_z_index = getFieldIndex(mesh.cloud, "normal_z");
+  int normal_x_index = getFieldIndex(cloud, "normal_x");
+  int normal_y_index = getFieldIndex(cloud, "normal_y");
+  int normal_z_index = getFieldIndex(cloud, "normal_z");
   if (normal_x_index != -1 && normal_y_index != -1 && normal_z_index != -1)
   {
       fs << "\nproperty float nx"
@@ -1521,7 +1814,7 @@ pcl::io::savePLYFile (const std::string &file_name, const pcl::PolygonMesh &mesh
             "\nproperty float nz";
   }
   // Check if we have curvature on vertices
-  int curvature_index = getFieldIndex(mesh.cloud, "curvature");
+  int curvature_index = getFieldIndex(cloud, "curvature");
   if ( curvature_index != -1)
   {
       fs << "\nproperty float curvature";
@@ -1535,52 +1828,52 @@ pcl::io::savePLYFile (const std::string &file_name, const pcl::PolygonMesh &mesh
   for (std::size_t i = 0; i < nr_points; ++i)
   {
     int xyz = 0;
-    for (std::size_t d = 0; d < mesh.cloud.fields.size (); ++d)
+    for (std::size_t d = 0; d < cloud.fields.size (); ++d)
     {
       int c = 0;
 
       // adding vertex
-      if ((mesh.cloud.fields[d].datatype == pcl::PCLPointField::FLOAT32) && (
-          mesh.cloud.fields[d].name == "x" ||
-          mesh.cloud.fields[d].name == "y" ||
-          mesh.cloud.fields[d].name == "z"))
+      if ((cloud.fields[d].datatype == pcl::PCLPointField::FLOAT32) && (
+          cloud.fields[d].name == "x" ||
+          cloud.fields[d].name == "y" ||
+          cloud.fields[d].name == "z"))
       {
         float value;
-        memcpy (&value, &mesh.cloud.data[i * point_size + mesh.cloud.fields[d].offset + c * sizeof (float)], sizeof (float));
+        memcpy (&value, &cloud.data[i * point_size + cloud.fields[d].offset + c * sizeof (float)], sizeof (float));
         fs << value;
         // if (++xyz == 3)
         //   break;
         ++xyz;
       }
-      else if ((mesh.cloud.fields[d].datatype == pcl::PCLPointField::FLOAT32) &&
-                (mesh.cloud.fields[d].name == "rgb"))
+      else if ((cloud.fields[d].datatype == pcl::PCLPointField::FLOAT32) &&
+                (cloud.fields[d].name == "rgb"))
 
       {
         pcl::RGB color;
-        memcpy (&color, &mesh.cloud.data[i * point_size + mesh.cloud.fields[rgb_index].offset + c * sizeof (float)], sizeof (RGB));
+        memcpy (&color, &cloud.data[i * point_size + cloud.fields[rgb_index].offset + c * sizeof (float)], sizeof (pcl::RGB));
         fs << int (color.r) << " " << int (color.g) << " " << int (color.b);
       }
-      else if ((mesh.cloud.fields[d].datatype == pcl::PCLPointField::UINT32) &&
-               (mesh.cloud.fields[d].name == "rgba"))
+      else if ((cloud.fields[d].datatype == pcl::PCLPointField::UINT32) &&
+               (cloud.fields[d].name == "rgba"))
       {
         pcl::RGB color;
-        memcpy (&color, &mesh.cloud.data[i * point_size + mesh.cloud.fields[rgba_index].offset + c * sizeof (std::uint32_t)], sizeof (RGB));
+        memcpy (&color, &cloud.data[i * point_size + cloud.fields[rgba_index].offset + c * sizeof (std::uint32_t)], sizeof (pcl::RGB));
         fs << int (color.r) << " " << int (color.g) << " " << int (color.b) << " " << int (color.a);
       }
-      else if ((mesh.cloud.fields[d].datatype == pcl::PCLPointField::FLOAT32) && (
-                mesh.cloud.fields[d].name == "normal_x" ||
-                mesh.cloud.fields[d].name == "normal_y" ||
-                mesh.cloud.fields[d].name == "normal_z"))
+      else if ((cloud.fields[d].datatype == pcl::PCLPointField::FLOAT32) && (
+                cloud.fields[d].name == "normal_x" ||
+                cloud.fields[d].name == "normal_y" ||
+                cloud.fields[d].name == "normal_z"))
       {
         float value;
-        memcpy (&value, &mesh.cloud.data[i * point_size + mesh.cloud.fields[d].offset + c * sizeof(float)], sizeof(float));
+        memcpy (&value, &cloud.data[i * point_size + cloud.fields[d].offset + c * sizeof(float)], sizeof(float));
         fs << value;
       }
-      else if ((mesh.cloud.fields[d].datatype == pcl::PCLPointField::FLOAT32) && (
-                mesh.cloud.fields[d].name == "curvature"))
+      else if ((cloud.fields[d].datatype == pcl::PCLPointField::FLOAT32) && (
+                cloud.fields[d].name == "curvature"))
       {
         float value;
-        memcpy(&value, &mesh.cloud.data[i * point_size + mesh.cloud.fields[d].offset + c * sizeof(float)], sizeof(float));
+        memcpy(&value, &cloud.data[i * point_size + cloud.fields[d].offset + c * sizeof(float)], sizeof(float));
         fs << value;
       }
       fs << " ";
@@ -1596,10 +1889,11 @@ pcl::io::savePLYFile (const std::string &file_name, const pcl::PolygonMesh &mesh
   // Write down faces
   for (std::size_t i = 0; i < nr_faces; i++)
   {
-    fs << mesh.polygons[i].vertices.size () << " ";
-    for (std::size_t j = 0; j < mesh.polygons[i].vertices.size () - 1; ++j)
-      fs << mesh.polygons[i].vertices[j] << " ";
-    fs << mesh.polygons[i].vertices.back() << '\n';
+    const auto vertices = face (i);
+    fs << vertices.second - vertices.first << " ";
+    for (auto v = vertices.first; v != vertices.second - 1; ++v)
+      fs << *v << " ";
+    fs << *(vertices.second - 1) << '\n';
   }
 
   // Close file
@@ -1608,17 +1902,37 @@ pcl::io::savePLYFile (const std::string &file_name, const pcl::PolygonMesh &mesh
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////
-int
-pcl::io::savePLYFileBinary (const std::string &file_name, const pcl::PolygonMesh &mesh)
+/** \brief Save a mesh in binary PLY format, given its vertex data and a functor
+  * returning the [begin, end) range of the vertex indices of every face.
+  *
+  * The vertices and the faces are converted into a buffer and written at once.
+  */
+template <typename FaceFunctor> static int
+savePLYMeshBinary (const std::string &file_name, const pcl::PCLPointCloud2 &cloud,
+                   std::size_t nr_faces, const FaceFunctor &face)
 {
-  if (mesh.cloud.data.empty ())
+  if (cloud.data.empty ())
   {
     PCL_ERROR ("[pcl::io::savePLYFile] Input point cloud has no data!\n");
     return (-1);
   }
+
+  // The byte offset in the point and the size of every vertex property, in the order of the header
+  std::vector<std::pair<std::size_t, std::size_t> > properties;
+  for (const char *name : {"x", "y", "z"})
+  {
+    const int index = getFieldIndex (cloud, name);
+    if (index == -1 || cloud.fields[index].datatype != pcl::PCLPointField::FLOAT32)
+    {
+      PCL_ERROR ("[pcl::io::savePLYFile] Input point cloud has no XYZ data!\n");
+      return (-2);
+    }
+    properties.emplace_back (cloud.fields[index].offset, sizeof (float));
+  }
+
   // Open file
   std::ofstream fs;
-  fs.open (file_name.c_str ());
+  fs.open (file_name.c_str (), std::ios::binary);
   if (!fs)
   {
     PCL_ERROR ("[pcl::io::savePLYFile] Error during opening (%s)!\n", file_name.c_str ());
@@ -1626,146 +1940,152 @@ pcl::io::savePLYFileBinary (const std::string &file_name, const pcl::PolygonMesh
   }
 
   // number of points
-  std::size_t nr_points  = mesh.cloud.width * mesh.cloud.height;
-  std::size_t point_size = mesh.cloud.data.size () / nr_points;
-
-  // number of faces
-  std::size_t nr_faces = mesh.polygons.size ();
+  std::size_t nr_points  = cloud.width * cloud.height;
+  std::size_t point_size = cloud.data.size () / nr_points;
 
   // Write header
   fs << "ply";
-  fs << "\nformat " << (mesh.cloud.is_bigendian ? "binary_big_endian" : "binary_little_endian") << " 1.0";
+  fs << "\nformat " << (cloud.is_bigendian ? "binary_big_endian" : "binary_little_endian") << " 1.0";
   fs << "\ncomment PCL generated";
   // Vertices
-  fs << "\nelement vertex "<< mesh.cloud.width * mesh.cloud.height;
+  fs << "\nelement vertex "<< cloud.width * cloud.height;
   fs << "\nproperty float x"
         "\nproperty float y"
         "\nproperty float z";
-  // Check if we have color on vertices
-  int rgba_index = getFieldIndex (mesh.cloud, "rgba"),
-  rgb_index = getFieldIndex (mesh.cloud, "rgb");
+  // Check if we have color on vertices, the bytes of pcl::RGB are b, g, r, a
+  int rgba_index = getFieldIndex (cloud, "rgba"),
+  rgb_index = getFieldIndex (cloud, "rgb");
   if (rgba_index != -1)
   {
     fs << "\nproperty uchar red"
           "\nproperty uchar green"
           "\nproperty uchar blue"
           "\nproperty uchar alpha";
+    for (const std::size_t byte : {2, 1, 0, 3})
+      properties.emplace_back (cloud.fields[rgba_index].offset + byte, 1);
   }
   else if (rgb_index != -1)
   {
     fs << "\nproperty uchar red"
           "\nproperty uchar green"
           "\nproperty uchar blue";
+    for (const std::size_t byte : {2, 1, 0})
+      properties.emplace_back (cloud.fields[rgb_index].offset + byte, 1);
   }
   // Check if we have normal on vertices
-  int normal_x_index = getFieldIndex(mesh.cloud, "normal_x");
-  int normal_y_index = getFieldIndex(mesh.cloud, "normal_y");
-  int normal_z_index = getFieldIndex(mesh.cloud, "normal_z");
+  int normal_x_index = getFieldIndex(cloud, "normal_x");
+  int normal_y_index = getFieldIndex(cloud, "normal_y");
+  int normal_z_index = getFieldIndex(cloud, "normal_z");
   if (normal_x_index != -1 && normal_y_index != -1 && normal_z_index != -1)
   {
-	  fs << "\nproperty float nx"
-		  "\nproperty float ny"
-		  "\nproperty float nz";
+    fs << "\nproperty float nx"
+          "\nproperty float ny"
+          "\nproperty float nz";
+    for (const int index : {normal_x_index, normal_y_index, normal_z_index})
+      properties.emplace_back (cloud.fields[index].offset, sizeof (float));
   }
   // Check if we have curvature on vertices
-  int curvature_index = getFieldIndex(mesh.cloud, "curvature");
+  int curvature_index = getFieldIndex(cloud, "curvature");
   if ( curvature_index != -1)
   {
-	  fs << "\nproperty float curvature";
+    fs << "\nproperty float curvature";
+    properties.emplace_back (cloud.fields[curvature_index].offset, sizeof (float));
   }
   // Faces
   fs << "\nelement face "<< nr_faces;
   fs << "\nproperty list uchar int vertex_indices";
   fs << "\nend_header\n";
 
-  // Close the file
-  fs.close ();
-  // Open file in binary appendable
-  std::ofstream fpout (file_name.c_str (), std::ios::app | std::ios::binary);
-  if (!fpout)
-  {
-    PCL_ERROR ("[pcl::io::writePLYFileBinary] Error during reopening (%s)!\n", file_name.c_str ());
-    return (-1);
-  }
-
   // Write down vertices
+  std::size_t vertex_size = 0;
+  for (const auto &property : properties)
+    vertex_size += property.second;
+  std::vector<char> buffer (vertex_size * nr_points);
+  char *p = buffer.data ();
   for (std::size_t i = 0; i < nr_points; ++i)
-  {
-    int xyz = 0;
-    for (std::size_t d = 0; d < mesh.cloud.fields.size (); ++d)
-    {
-      int c = 0;
-
-      // adding vertex
-      if ((mesh.cloud.fields[d].datatype == pcl::PCLPointField::FLOAT32) && (
-          mesh.cloud.fields[d].name == "x" ||
-          mesh.cloud.fields[d].name == "y" ||
-          mesh.cloud.fields[d].name == "z"))
-      {
-        float value;
-        memcpy (&value, &mesh.cloud.data[i * point_size + mesh.cloud.fields[d].offset + c * sizeof (float)], sizeof (float));
-        fpout.write (reinterpret_cast<const char*> (&value), sizeof (float));
-        // if (++xyz == 3)
-        //   break;
-        ++xyz;
-      }
-      else if ((mesh.cloud.fields[d].datatype == pcl::PCLPointField::FLOAT32) &&
-                (mesh.cloud.fields[d].name == "rgb"))
-
-      {
-        pcl::RGB color;
-        memcpy (&color, &mesh.cloud.data[i * point_size + mesh.cloud.fields[rgb_index].offset + c * sizeof (float)], sizeof (RGB));
-        fpout.write (reinterpret_cast<const char*> (&color.r), sizeof (unsigned char));
-        fpout.write (reinterpret_cast<const char*> (&color.g), sizeof (unsigned char));
-        fpout.write (reinterpret_cast<const char*> (&color.b), sizeof (unsigned char));
-      }
-      else if ((mesh.cloud.fields[d].datatype == pcl::PCLPointField::UINT32) &&
-               (mesh.cloud.fields[d].name == "rgba"))
-      {
-        pcl::RGB color;
-        memcpy (&color, &mesh.cloud.data[i * point_size + mesh.cloud.fields[rgba_index].offset + c * sizeof (std::uint32_t)], sizeof (RGB));
-        fpout.write (reinterpret_cast<const char*> (&color.r), sizeof (unsigned char));
-        fpout.write (reinterpret_cast<const char*> (&color.g), sizeof (unsigned char));
-        fpout.write (reinterpret_cast<const char*> (&color.b), sizeof (unsigned char));
-        fpout.write (reinterpret_cast<const char*> (&color.a), sizeof (unsigned char));
-      }
-      else if ((mesh.cloud.fields[d].datatype == pcl::PCLPointField::FLOAT32) && (
-               mesh.cloud.fields[d].name == "normal_x" ||
-               mesh.cloud.fields[d].name == "normal_y" ||
-               mesh.cloud.fields[d].name == "normal_z"))
-      {
-        float value;
-        memcpy (&value, &mesh.cloud.data[i * point_size + mesh.cloud.fields[d].offset + c * sizeof (float)], sizeof (float));
-        fpout.write (reinterpret_cast<const char*> (&value), sizeof (float));
-      }
-      else if ((mesh.cloud.fields[d].datatype == pcl::PCLPointField::FLOAT32) && 
-               (mesh.cloud.fields[d].name == "curvature"))
-      {
-        float value;
-        memcpy (&value, &mesh.cloud.data[i * point_size + mesh.cloud.fields[d].offset + c * sizeof (float)], sizeof (float));
-        fpout.write (reinterpret_cast<const char*> (&value), sizeof (float));        
-      }
-    }
-    if (xyz != 3)
+    for (const auto &property : properties)
     {
-      PCL_ERROR ("[pcl::io::savePLYFile] Input point cloud has no XYZ data!\n");
-      return (-2);
+      memcpy (p, &cloud.data[i * point_size + property.first], property.second);
+      p += property.second;
     }
-  }
+  fs.write (buffer.data (), buffer.size ());
 
   // Write down faces
+  std::size_t faces_size = 0;
   for (std::size_t i = 0; i < nr_faces; i++)
   {
-    unsigned char value = static_cast<unsigned char> (mesh.polygons[i].vertices.size ());
-    fpout.write (reinterpret_cast<const char*> (&value), sizeof (unsigned char));
-    for (const int value : mesh.polygons[i].vertices)
+    const auto vertices = face (i);
+    faces_size += sizeof (unsigned char) + sizeof (int) * (vertices.second - vertices.first);
+  }
+  buffer.resize (faces_size);
+  p = buffer.data ();
+  for (std::size_t i = 0; i < nr_faces; i++)
+  {
+    const auto vertices = face (i);
+    *p++ = static_cast<char> (vertices.second - vertices.first);
+    for (auto v = vertices.first; v != vertices.second; ++v)
     {
-      //fs << mesh.polygons[i].vertices[j] << " ";
-      fpout.write (reinterpret_cast<const char*> (&value), sizeof (int));
+      const int value = static_cast<int> (*v);
+      memcpy (p, &value, sizeof (int));
+      p += sizeof (int);
     }
   }
+  fs.write (buffer.data (), buffer.size ());
 
   // Close file
-  fpout.close ();
+  fs.close ();
+  if (!fs)
+  {
+    PCL_ERROR ("[pcl::io::savePLYFile] Error during writing (%s)!\n", file_name.c_str ());
+    return (-1);
+  }
   return (0);
 }
+
+////////////////////////////////////////////////////////////////////////////////////////
+int
+pcl::io::savePLYFile (const std::string &file_name, const pcl::PolygonMesh &mesh, unsigned precision)
+{
+  const auto face = [&mesh] (std::size_t i)
+  {
+    const auto &vertices = mesh.polygons[i].vertices;
+    return (std::make_pair (vertices.data (), vertices.data () + vertices.size ()));
+  };
+  return (savePLYMesh (file_name, mesh.cloud, mesh.polygons.size (), face, precision));
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+int
+pcl::io::savePLYFile (const std::string &file_name, const pcl::TriangleMesh &mesh, unsigned precision)
+{
+  const auto face = [&mesh] (std::size_t i)
+  {
+    const std::uint32_t *vertices = mesh.getTriangle (i);
+    return (std::make_pair (vertices, vertices + 3));
+  };
+  return (savePLYMesh (file_name, mesh.cloud, mesh.size (), face, precision));
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+int
+pcl::io::savePLYFileBinary (const std::string &file_name, const pcl::PolygonMesh &mesh)
+{
+  const auto face = [&mesh] (std::size_t i)
+  {
+    const auto &vertices = mesh.polygons[i].vertices;
+    return (std::make_pair (vertices.data (), vertices.data () + vertices.size ()));
+  };
+  return (savePLYMeshBinary (file_name, mesh.cloud, mesh.polygons.size (), face));
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+int
+pcl::io::savePLYFileBinary (const std::string &file_name, const pcl::TriangleMesh &mesh)
+{
+  const auto face = [&mesh] (std::size_t i)
+  {
+    const std::uint32_t *vertices = mesh.getTriangle (i);
+    return (std::make_pair (vertices, vertices + 3));
+  };
+  return (savePLYMeshBinary (file_name, mesh.cloud, mesh.size (), face));
+}
@@ -0,0 +1,419 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved
+ */
+
+#include <pcl/io/point_cloud_stream.h>
+#include <pcl/console/print.h>
+
+#include <boost/asio.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <deque>
+#include <list>
+#include <mutex>
+#include <thread>
+
+using boost::asio::ip::tcp;
+
+namespace
+{
+  constexpr std::uint16_t frame_magic = 0x5043;
+  constexpr std::uint16_t key_frame_flag = 0x0001;
+  constexpr std::size_t header_size = 8;
+
+  /** \brief Write the frame header in little endian byte order. */
+  void
+  writeHeader (std::uint8_t *header, std::uint16_t flags, std::uint32_t size)
+  {
+    header[0] = static_cast<std::uint8_t> (frame_magic & 0xff);
+    header[1] = static_cast<std::uint8_t> (frame_magic >> 8);
+    header[2] = static_cast<std::uint8_t> (flags & 0xff);
+    header[3] = static_cast<std::uint8_t> (flags >> 8);
+    for (int i = 0; i < 4; ++i)
+      header[4 + i] = static_cast<std::uint8_t> (size >> (8 * i));
+  }
+
+  /** \brief Read a frame header, returns false if the magic number does not match. */
+  bool
+  readHeader (const std::uint8_t *header, std::uint16_t &flags, std::uint32_t &size)
+  {
+    const auto magic = static_cast<std::uint16_t> (header[0] | (header[1] << 8));
+    flags = static_cast<std::uint16_t> (header[2] | (header[3] << 8));
+    size = 0;
+    for (int i = 0; i < 4; ++i)
+      size |= static_cast<std::uint32_t> (header[4 + i]) << (8 * i);
+    return (magic == frame_magic);
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+/** \brief The network state of StreamServer. Apart from the counters it is only accessed by the network
+  * thread, publish () posts the frames to it.
+  */
+struct pcl::io::StreamServer::Impl
+{
+  using Frame = std::shared_ptr<const std::string>;
+
+  struct Session
+  {
+    Session (boost::asio::io_service &io_service) : socket (io_service) {}
+
+    tcp::socket socket;
+    std::deque<Frame> queue;
+    bool writing = false;
+    bool wait_for_key_frame = true;
+    std::array<char, 64> read_buffer;
+  };
+  using SessionPtr = std::shared_ptr<Session>;
+
+  Impl (unsigned short port) : port (port), acceptor (io_service) {}
+
+  void
+  accept ()
+  {
+    auto session = std::make_shared<Session> (io_service);
+    acceptor.async_accept (session->socket, [this, session] (const boost::system::error_code &error)
+    {
+      if (error)
+        return;
+      boost::system::error_code ignored;
+      session->socket.set_option (tcp::no_delay (true), ignored);
+      sessions.push_back (session);
+      number_of_clients = sessions.size ();
+      updateKeyFrameRequested ();
+      read (session);
+      accept ();
+    });
+  }
+
+  /** \brief The clients do not send anything, reading only detects disconnections. */
+  void
+  read (const SessionPtr &session)
+  {
+    session->socket.async_read_some (boost::asio::buffer (session->read_buffer),
+                                     [this, session] (const boost::system::error_code &error, std::size_t)
+    {
+      if (error)
+        remove (session);
+      else
+        read (session);
+    });
+  }
+
+  void
+  write (const SessionPtr &session)
+  {
+    session->writing = true;
+    boost::asio::async_write (session->socket, boost::asio::buffer (*session->queue.front ()),
+                              [this, session] (const boost::system::error_code &error, std::size_t)
+    {
+      session->writing = false;
+      if (error)
+      {
+        remove (session);
+        return;
+      }
+      session->queue.pop_front ();
+      if (!session->queue.empty ())
+        write (session);
+    });
+  }
+
+  void
+  deliver (const Frame &frame, bool key_frame)
+  {
+    for (const auto &session : sessions)
+    {
+      if (session->wait_for_key_frame && !key_frame)
+      {
+        ++dropped_frames;
+        continue;
+      }
+      // A full queue means that the client does not keep up, skip to the next key frame
+      if (session->queue.size () >= max_queued_frames)
+      {
+        session->wait_for_key_frame = true;
+        ++dropped_frames;
+        continue;
+      }
+      session->wait_for_key_frame = false;
+      session->queue.push_back (frame);
+      if (!session->writing)
+        write (session);
+    }
+    updateKeyFrameRequested ();
+  }
+
+  void
+  remove (const SessionPtr &session)
+  {
+    const auto it = std::find (sessions.begin (), sessions.end (), session);
+    if (it == sessions.end ())
+      return;
+    boost::system::error_code ignored;
+    session->socket.close (ignored);
+    sessions.erase (it);
+    number_of_clients = sessions.size ();
+    updateKeyFrameRequested ();
+  }
+
+  void
+  updateKeyFrameRequested ()
+  {
+    key_frame_requested = std::any_of (sessions.begin (), sessions.end (),
+                                       [] (const SessionPtr &session) { return (session->wait_for_key_frame); });
+  }
+
+  unsigned short port;
+  boost::asio::io_service io_service;
+  tcp::acceptor acceptor;
+  std::thread thread;
+  std::list<SessionPtr> sessions;
+
+  std::atomic<bool> running {false};
+  std::atomic<std::size_t> max_queued_frames {2};
+  std::atomic<std::size_t> number_of_clients {0};
+  std::atomic<std::size_t> dropped_frames {0};
+  std::atomic<bool> key_frame_requested {false};
+  std::mutex mutex;
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////
+pcl::io::StreamServer::StreamServer (unsigned short port) : impl_ (new Impl (port))
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+pcl::io::StreamServer::~StreamServer ()
+{
+  stop ();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+bool
+pcl::io::StreamServer::start ()
+{
+  std::lock_guard<std::mutex> lock (impl_->mutex);
+  if (impl_->running)
+    return (true);
+
+  boost::system::error_code error;
+  const tcp::endpoint endpoint (tcp::v4 (), impl_->port);
+  impl_->acceptor.open (endpoint.protocol (), error);
+  if (!error)
+    impl_->acceptor.set_option (tcp::acceptor::reuse_address (true), error);
+  if (!error)
+    impl_->acceptor.bind (endpoint, error);
+  if (!error)
+    impl_->acceptor.listen (boost::asio::socket_base::max_connections, error);
+  if (error)
+  {
+    PCL_ERROR ("[pcl::io::StreamServer::start] Could not listen on port %u: %s\n",
+               static_cast<unsigned> (impl_->port), error.message ().c_str ());
+    boost::system::error_code ignored;
+    impl_->acceptor.close (ignored);
+    return (false);
+  }
+
+  impl_->dropped_frames = 0;
+  impl_->io_service.reset ();
+  impl_->accept ();
+  impl_->thread = std::thread ([this] { impl_->io_service.run (); });
+  impl_->running = true;
+  return (true);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::io::StreamServer::stop ()
+{
+  std::lock_guard<std::mutex> lock (impl_->mutex);
+  if (!impl_->running)
+    return;
+
+  impl_->io_service.stop ();
+  impl_->thread.join ();
+
+  // The network thread is gone, the sockets can be closed from here
+  boost::system::error_code ignored;
+  impl_->acceptor.close (ignored);
+  for (const auto &session : impl_->sessions)
+    session->socket.close (ignored);
+  impl_->sessions.clear ();
+  impl_->number_of_clients = 0;
+  impl_->key_frame_requested = false;
+  impl_->running = false;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+bool
+pcl::io::StreamServer::isRunning () const
+{
+  return (impl_->running);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+unsigned short
+pcl::io::StreamServer::getPort () const
+{
+  std::lock_guard<std::mutex> lock (impl_->mutex);
+  if (!impl_->running)
+    return (impl_->port);
+  boost::system::error_code error;
+  const tcp::endpoint endpoint = impl_->acceptor.local_endpoint (error);
+  return (error ? impl_->port : endpoint.port ());
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+std::size_t
+pcl::io::StreamServer::getNumberOfClients () const
+{
+  return (impl_->number_of_clients);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+bool
+pcl::io::StreamServer::isKeyFrameRequested () const
+{
+  return (impl_->key_frame_requested);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::io::StreamServer::setMaximumQueuedFrames (std::size_t max_queued_frames)
+{
+  impl_->max_queued_frames = std::max<std::size_t> (max_queued_frames, 1);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+std::size_t
+pcl::io::StreamServer::getMaximumQueuedFrames () const
+{
+  return (impl_->max_queued_frames);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+std::size_t
+pcl::io::StreamServer::getNumberOfDroppedFrames () const
+{
+  return (impl_->dropped_frames);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::io::StreamServer::publish (const std::string &payload, bool key_frame)
+{
+  if (!impl_->running)
+    return;
+
+  auto frame = std::make_shared<std::string> (header_size + payload.size (), '\0');
+  writeHeader (reinterpret_cast<std::uint8_t*> (&(*frame)[0]), key_frame ? key_frame_flag : 0,
+               static_cast<std::uint32_t> (payload.size ()));
+  std::copy (payload.begin (), payload.end (), frame->begin () + header_size);
+
+  Impl *impl = impl_.get ();
+  Impl::Frame shared_frame = std::move (frame);
+  impl->io_service.post ([impl, shared_frame, key_frame] { impl->deliver (shared_frame, key_frame); });
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+struct pcl::io::StreamClient::Impl
+{
+  Impl () : socket (io_service) {}
+
+  boost::asio::io_service io_service;
+  tcp::socket socket;
+  std::atomic<bool> connected {false};
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////
+pcl::io::StreamClient::StreamClient () : impl_ (new Impl)
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+pcl::io::StreamClient::~StreamClient ()
+{
+  close ();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+bool
+pcl::io::StreamClient::connect (const std::string &host, unsigned short port)
+{
+  boost::system::error_code error;
+  impl_->connected = false;
+  impl_->socket.close (error);
+
+  tcp::resolver resolver (impl_->io_service);
+  const auto endpoints = resolver.resolve (tcp::resolver::query (host, std::to_string (port)), error);
+  if (!error)
+    boost::asio::connect (impl_->socket, endpoints, error);
+  if (error)
+  {
+    PCL_ERROR ("[pcl::io::StreamClient::connect] Could not connect to %s:%u: %s\n",
+               host.c_str (), static_cast<unsigned> (port), error.message ().c_str ());
+    return (false);
+  }
+  impl_->socket.set_option (tcp::no_delay (true), error);
+  impl_->connected = true;
+  return (true);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::io::StreamClient::close ()
+{
+  // Only shut the socket down, so that a receive () blocked in another thread returns
+  boost::system::error_code ignored;
+  impl_->connected = false;
+  impl_->socket.shutdown (tcp::socket::shutdown_both, ignored);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+bool
+pcl::io::StreamClient::isConnected () const
+{
+  return (impl_->connected);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+bool
+pcl::io::StreamClient::receive (std::string &payload, bool &key_frame)
+{
+  if (!impl_->connected)
+    return (false);
+
+  boost::system::error_code error;
+  std::uint8_t header[header_size];
+  boost::asio::read (impl_->socket, boost::asio::buffer (header), error);
+
+  std::uint16_t flags = 0;
+  std::uint32_t size = 0;
+  if (!error && !readHeader (header, flags, size))
+  {
+    PCL_ERROR ("[pcl::io::StreamClient::receive] Malformed frame header.\n");
+    close ();
+    return (false);
+  }
+  if (!error)
+  {
+    payload.resize (size);
+    if (size > 0)
+      boost::asio::read (impl_->socket, boost::asio::buffer (&payload[0], size), error);
+  }
+  if (error)
+  {
+    impl_->connected = false;
+    return (false);
+  }
+  key_frame = (flags & key_frame_flag) != 0;
+  return (true);
+}
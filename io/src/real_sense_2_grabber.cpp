@@ -228,13 +228,13 @@ namespace pcl
   pcl::PointCloud<pcl::PointXYZ>::Ptr
   RealSense2Grabber::convertDepthToPointXYZ ( const rs2::points& points )
   {
-    return convertRealsensePointsToPointCloud<pcl::PointXYZ> ( points, []( pcl::PointXYZ& p, const rs2::texture_coordinate* uvptr ) {} );
+    return convertRealsensePointsToPointCloud ( xyz_pool_, points, []( pcl::PointXYZ& p, const rs2::texture_coordinate* uvptr ) {} );
   }
 
   pcl::PointCloud<pcl::PointXYZRGB>::Ptr
   RealSense2Grabber::convertRGBDepthToPointXYZRGB ( const rs2::points& points, const rs2::video_frame& texture )
   {
-    return convertRealsensePointsToPointCloud<pcl::PointXYZRGB> ( points, [&]( pcl::PointXYZRGB& p, const rs2::texture_coordinate* uvptr )
+    return convertRealsensePointsToPointCloud ( xyzrgb_pool_, points, [&]( pcl::PointXYZRGB& p, const rs2::texture_coordinate* uvptr )
     {
       auto clr = getTextureColor ( texture, uvptr->u, uvptr->v );
 
@@ -247,7 +247,7 @@ namespace pcl
   pcl::PointCloud<pcl::PointXYZRGBA>::Ptr
   RealSense2Grabber::convertRGBADepthToPointXYZRGBA ( const rs2::points& points, const rs2::video_frame& texture )
   {
-    return convertRealsensePointsToPointCloud<pcl::PointXYZRGBA> ( points, [&]( pcl::PointXYZRGBA& p, const rs2::texture_coordinate* uvptr )
+    return convertRealsensePointsToPointCloud ( xyzrgba_pool_, points, [&]( pcl::PointXYZRGBA& p, const rs2::texture_coordinate* uvptr )
     {
       auto clr = getTextureColor ( texture, uvptr->u, uvptr->v );
 
@@ -262,7 +262,7 @@ namespace pcl
   {
     if (texture.get_profile ().format () == RS2_FORMAT_UYVY)
     {
-      return convertRealsensePointsToPointCloud<pcl::PointXYZI> ( points, [&]( pcl::PointXYZI& p, const rs2::texture_coordinate* uvptr )
+      return convertRealsensePointsToPointCloud ( xyzi_pool_, points, [&]( pcl::PointXYZI& p, const rs2::texture_coordinate* uvptr )
       {
         auto clr = getTextureColor ( texture, uvptr->u, uvptr->v );
         p.intensity = 0.299f * static_cast <float> (clr.r) + 0.587f * static_cast <float> (clr.g) + 0.114f * static_cast <float> (clr.b);
@@ -270,7 +270,7 @@ namespace pcl
     }
     else
     {
-      return convertRealsensePointsToPointCloud<pcl::PointXYZI> ( points, [&]( pcl::PointXYZI& p, const rs2::texture_coordinate* uvptr )
+      return convertRealsensePointsToPointCloud ( xyzi_pool_, points, [&]( pcl::PointXYZI& p, const rs2::texture_coordinate* uvptr )
       {
         p.intensity = getTextureIntensity ( texture, uvptr->u, uvptr->v );
       } );
@@ -279,9 +279,9 @@ namespace pcl
 
   template <typename PointT, typename Functor>
   typename pcl::PointCloud<PointT>::Ptr
-  RealSense2Grabber::convertRealsensePointsToPointCloud ( const rs2::points& points, Functor mapColorFunc )
+  RealSense2Grabber::convertRealsensePointsToPointCloud ( pcl::io::PointCloudPool<PointT>& pool, const rs2::points& points, Functor mapColorFunc )
   {
-    typename pcl::PointCloud<PointT>::Ptr cloud ( new pcl::PointCloud<PointT> () );
+    typename pcl::PointCloud<PointT>::Ptr cloud = pool.get ();
 
     auto sp = points.get_profile ().as<rs2::video_stream_profile> ();
     cloud->width = sp.width ();
@@ -45,6 +45,7 @@ pcl::RobotEyeGrabber::RobotEyeGrabber ()
   , signal_point_cloud_size_ (1000)
   , data_port_ (443)
   , sensor_address_ (boost::asio::ip::address_v4::any ())
+  , packet_queue_ (PACKET_QUEUE_SIZE, PACKET_RESERVE)
 {
   point_cloud_signal_ = createSignal<sig_cb_robot_eye_point_cloud_xyzi> ();
   resetPointCloud ();
@@ -56,6 +57,7 @@ pcl::RobotEyeGrabber::RobotEyeGrabber (const boost::asio::ip::address& ipAddress
   , signal_point_cloud_size_ (1000)
   , data_port_ (port)
   , sensor_address_ (ipAddress)
+  , packet_queue_ (PACKET_QUEUE_SIZE, PACKET_RESERVE)
 {
   point_cloud_signal_ = createSignal<sig_cb_robot_eye_point_cloud_xyzi> ();
   resetPointCloud ();
@@ -150,13 +152,9 @@ pcl::RobotEyeGrabber::resetPointCloud ()
 void
 pcl::RobotEyeGrabber::consumerThreadLoop ()
 {
-  while (true)
-  {
-    boost::shared_array<unsigned char> data;
-    if (!packet_queue_.dequeue (data))
-      return;
-    convertPacketData (data.get(), data_size_);
-  }
+  std::vector<std::uint8_t> data;
+  while (packet_queue_.dequeue (data))
+    convertPacketData (data.data (), data.size ());
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -290,10 +288,7 @@ pcl::RobotEyeGrabber::socketCallback (const boost::system::error_code&, std::siz
   if (sensor_address_ == boost::asio::ip::address_v4::any ()
     || sensor_address_ == sender_endpoint_.address ())
   {
-    data_size_ = number_of_bytes;
-    unsigned char *dup = new unsigned char[number_of_bytes];
-    memcpy (dup, receive_buffer_, number_of_bytes);
-    packet_queue_.enqueue (boost::shared_array<unsigned char>(dup));
+    packet_queue_.enqueue (receive_buffer_, number_of_bytes);
   }
 
   asyncSocketReceive ();
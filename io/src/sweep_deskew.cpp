@@ -0,0 +1,178 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved
+ */
+
+#include <pcl/io/sweep_deskew.h>
+
+#include <algorithm>
+
+/////////////////////////////////////////////////////////////////////////////
+pcl::io::SweepDeskew::SweepDeskew () :
+  max_extrapolation_ (0.1),
+  has_reference_ (false),
+  reference_time_ (0.0)
+{
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void
+pcl::io::SweepDeskew::addPose (double timestamp, const Eigen::Isometry3d &pose)
+{
+  std::lock_guard<std::mutex> lock (mutex_);
+  if (!poses_.empty () && timestamp <= poses_.back ().timestamp)
+    return;
+  poses_.push_back ({timestamp, Eigen::Quaterniond (pose.rotation ()).normalized (), pose.translation ()});
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void
+pcl::io::SweepDeskew::clear ()
+{
+  std::lock_guard<std::mutex> lock (mutex_);
+  poses_.clear ();
+  has_reference_ = false;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+std::size_t
+pcl::io::SweepDeskew::getNumberOfPoses () const
+{
+  std::lock_guard<std::mutex> lock (mutex_);
+  return (poses_.size ());
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void
+pcl::io::SweepDeskew::setMaximumExtrapolation (double seconds)
+{
+  std::lock_guard<std::mutex> lock (mutex_);
+  max_extrapolation_ = seconds;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+double
+pcl::io::SweepDeskew::getMaximumExtrapolation () const
+{
+  std::lock_guard<std::mutex> lock (mutex_);
+  return (max_extrapolation_);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+bool
+pcl::io::SweepDeskew::getPose (double timestamp, Eigen::Isometry3d &pose) const
+{
+  std::lock_guard<std::mutex> lock (mutex_);
+  if (poses_.empty ())
+    return (false);
+  Eigen::Quaterniond rotation;
+  Eigen::Vector3d translation;
+  interpolate (timestamp, rotation, translation);
+  pose.linear () = rotation.toRotationMatrix ();
+  pose.translation () = translation;
+  pose.makeAffine ();
+  return (true);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void
+pcl::io::SweepDeskew::setReferenceTime (double timestamp)
+{
+  std::lock_guard<std::mutex> lock (mutex_);
+  reference_time_ = timestamp;
+  has_reference_ = true;
+
+  // Keep the last pose before the reference time, the sweep only needs the later ones
+  while (poses_.size () > 2 && poses_[1].timestamp <= timestamp)
+    poses_.pop_front ();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+bool
+pcl::io::SweepDeskew::hasReferenceTime () const
+{
+  std::lock_guard<std::mutex> lock (mutex_);
+  return (has_reference_);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void
+pcl::io::SweepDeskew::getTransform (double timestamp, Eigen::Isometry3d &transform)
+{
+  std::lock_guard<std::mutex> lock (mutex_);
+  if (!has_reference_)
+  {
+    reference_time_ = timestamp;
+    has_reference_ = true;
+  }
+  transform.setIdentity ();
+  if (poses_.empty ())
+    return;
+
+  Eigen::Quaterniond rotation, reference_rotation;
+  Eigen::Vector3d translation, reference_translation;
+  interpolate (timestamp, rotation, translation);
+  interpolate (reference_time_, reference_rotation, reference_translation);
+
+  // reference^-1 * pose
+  const Eigen::Quaterniond reference_inverse = reference_rotation.conjugate ();
+  transform.linear () = (reference_inverse * rotation).toRotationMatrix ();
+  transform.translation () = reference_inverse * (translation - reference_translation);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void
+pcl::io::SweepDeskew::deskew (double timestamp, float *x, float *y, float *z, std::size_t count)
+{
+  Eigen::Isometry3d transform;
+  getTransform (timestamp, transform);
+  const Eigen::Matrix<float, 3, 4> m = transform.matrix ().topRows<3> ().cast<float> ();
+  const float m00 = m (0, 0), m01 = m (0, 1), m02 = m (0, 2), m03 = m (0, 3);
+  const float m10 = m (1, 0), m11 = m (1, 1), m12 = m (1, 2), m13 = m (1, 3);
+  const float m20 = m (2, 0), m21 = m (2, 1), m22 = m (2, 2), m23 = m (2, 3);
+
+  // One transformation for the whole firing, applied to plain arrays so that the compiler vectorizes it.
+  // Invalid (NaN) points stay invalid.
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    const float px = x[i];
+    const float py = y[i];
+    const float pz = z[i];
+    x[i] = m00 * px + m01 * py + m02 * pz + m03;
+    y[i] = m10 * px + m11 * py + m12 * pz + m13;
+    z[i] = m20 * px + m21 * py + m22 * pz + m23;
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void
+pcl::io::SweepDeskew::interpolate (double timestamp, Eigen::Quaterniond &rotation, Eigen::Vector3d &translation) const
+{
+  if (poses_.size () == 1)
+  {
+    rotation = poses_.front ().rotation;
+    translation = poses_.front ().translation;
+    return;
+  }
+
+  // The two poses around the timestamp, or the two first or last ones to extrapolate
+  const double first_time = poses_.front ().timestamp;
+  const double last_time = poses_.back ().timestamp;
+  timestamp = std::min (std::max (timestamp, first_time - max_extrapolation_), last_time + max_extrapolation_);
+  auto next = std::upper_bound (poses_.begin (), poses_.end (), timestamp,
+                                [] (double time, const TimedPose &pose) { return (time < pose.timestamp); });
+  if (next == poses_.begin ())
+    ++next;
+  else if (next == poses_.end ())
+    --next;
+  const TimedPose &p0 = *(next - 1);
+  const TimedPose &p1 = *next;
+
+  const double t = (timestamp - p0.timestamp) / (p1.timestamp - p0.timestamp);
+  rotation = p0.rotation.slerp (t, p1.rotation).normalized ();
+  translation = p0.translation + t * (p1.translation - p0.translation);
+}
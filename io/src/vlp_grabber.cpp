@@ -46,6 +46,7 @@ pcl::VLPGrabber::VLPGrabber (const std::string& pcapFile) :
 {
   initializeLaserMapping ();
   loadVLP16Corrections ();
+  updateLaserTables ();
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -55,6 +56,7 @@ pcl::VLPGrabber::VLPGrabber (const boost::asio::ip::address& ipAddress,
 {
   initializeLaserMapping ();
   loadVLP16Corrections ();
+  updateLaserTables ();
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -101,18 +103,20 @@ pcl::VLPGrabber::getDefaultNetworkAddress ()
 void
 pcl::VLPGrabber::toPointClouds (HDLDataPacket *dataPacket)
 {
-  static std::uint32_t sweep_counter = 0;
   if (sizeof(HDLLaserReturn) != 3)
     return;
 
+  updateDecodedClouds ();
+
   time_t system_time;
   time (&system_time);
   time_t velodyne_time = (system_time & 0x00000000ffffffffl) << 32 | dataPacket->gpsTimestamp;
 
   double interpolated_azimuth_delta;
 
+  const bool dual_mode = (dataPacket->mode == VLP_DUAL_MODE);
   std::uint8_t index = 1;
-  if (dataPacket->mode == VLP_DUAL_MODE)
+  if (dual_mode)
   {
     index = 2;
   }
@@ -125,14 +129,20 @@ pcl::VLPGrabber::toPointClouds (HDLDataPacket *dataPacket)
     interpolated_azimuth_delta = (dataPacket->firingData[index].rotationalPosition - dataPacket->firingData[0].rotationalPosition) / 2.0;
   }
 
+  const double packet_time = getPacketTime (dataPacket->gpsTimestamp);
+
+  HDLDecodedReturns decoded, dual_decoded;
   for (std::uint8_t i = 0; i < HDL_FIRING_PER_PKT; ++i)
   {
-    HDLFiringData firing_data = dataPacket->firingData[i];
+    const HDLFiringData &firing_data = dataPacket->firingData[i];
+    // The two blocks of a dual return packet hold the same firings
+    const int block_index = dual_mode ? i / 2 : i;
 
-    for (std::uint8_t j = 0; j < HDL_LASER_PER_FIRING; j++)
+    // Each block holds two firing sequences of the 16 lasers, the second one at the interpolated azimuth
+    for (std::uint8_t sequence = 0; sequence < HDL_LASER_PER_FIRING / VLP_MAX_NUM_LASERS; ++sequence)
     {
       double current_azimuth = firing_data.rotationalPosition;
-      if (j >= VLP_MAX_NUM_LASERS)
+      if (sequence > 0)
       {
         current_azimuth += interpolated_azimuth_delta;
       }
@@ -140,73 +150,41 @@ pcl::VLPGrabber::toPointClouds (HDLDataPacket *dataPacket)
       {
         current_azimuth -= 36000;
       }
+      const double firing_time = packet_time + (2 * block_index + sequence) * VLP_FIRING_PERIOD;
       if (current_azimuth < HDLGrabber::last_azimuth_)
       {
-        if (!current_sweep_xyz_->empty ())
-        {
-          current_sweep_xyz_->is_dense = current_sweep_xyzrgba_->is_dense = current_sweep_xyzi_->is_dense = false;
-          current_sweep_xyz_->header.stamp = velodyne_time;
-          current_sweep_xyzrgba_->header.stamp = velodyne_time;
-          current_sweep_xyzi_->header.stamp = velodyne_time;
-          current_sweep_xyz_->header.seq = sweep_counter;
-          current_sweep_xyzrgba_->header.seq = sweep_counter;
-          current_sweep_xyzi_->header.seq = sweep_counter;
-
-          sweep_counter++;
-
-          HDLGrabber::fireCurrentSweep ();
-        }
-        current_sweep_xyz_.reset (new pcl::PointCloud<pcl::PointXYZ> ());
-        current_sweep_xyzrgba_.reset (new pcl::PointCloud<pcl::PointXYZRGBA> ());
-        current_sweep_xyzi_.reset (new pcl::PointCloud<pcl::PointXYZI> ());
+        startNewSweep (velodyne_time);
+        if (sweep_deskew_)
+          sweep_deskew_->setReferenceTime (firing_time);
       }
 
-      PointXYZ xyz;
-      PointXYZI xyzi;
-      PointXYZRGBA xyzrgba;
-      PointXYZ dual_xyz;
-      PointXYZI dual_xyzi;
-      PointXYZRGBA dual_xyzrgba;
-
-      HDLGrabber::computeXYZI (xyzi, current_azimuth, firing_data.laserReturns[j], laser_corrections_[j % VLP_MAX_NUM_LASERS]);
-
-      xyz.x = xyzrgba.x = xyzi.x;
-      xyz.y = xyzrgba.y = xyzi.y;
-      xyz.z = xyzrgba.z = xyzi.z;
-
-      xyzrgba.rgba = laser_rgb_mapping_[j % VLP_MAX_NUM_LASERS].rgba;
-
-      if (dataPacket->mode == VLP_DUAL_MODE)
+      const std::uint8_t first = static_cast<std::uint8_t> (sequence * VLP_MAX_NUM_LASERS);
+      const auto azimuth = static_cast<std::uint16_t> (current_azimuth);
+      decodeReturns (firing_data.laserReturns + first, VLP_MAX_NUM_LASERS, 0, azimuth, decoded);
+      if (dual_mode)
+        decodeReturns (dataPacket->firingData[i + 1].laserReturns + first, VLP_MAX_NUM_LASERS, 0, azimuth, dual_decoded);
+      if (sweep_deskew_)
       {
-        HDLGrabber::computeXYZI (dual_xyzi, current_azimuth, dataPacket->firingData[i + 1].laserReturns[j], laser_corrections_[j % VLP_MAX_NUM_LASERS]);
-
-        dual_xyz.x = dual_xyzrgba.x = dual_xyzi.x;
-        dual_xyz.y = dual_xyzrgba.y = dual_xyzi.y;
-        dual_xyz.z = dual_xyzrgba.z = dual_xyzi.z;
-
-        dual_xyzrgba.rgba = laser_rgb_mapping_[j % VLP_MAX_NUM_LASERS].rgba;
+        sweep_deskew_->deskew (firing_time, decoded.x, decoded.y, decoded.z, VLP_MAX_NUM_LASERS);
+        if (dual_mode)
+          sweep_deskew_->deskew (firing_time, dual_decoded.x, dual_decoded.y, dual_decoded.z, VLP_MAX_NUM_LASERS);
       }
 
-      if (! (std::isnan (xyz.x) || std::isnan (xyz.y) || std::isnan (xyz.z)))
-      {
-        current_sweep_xyz_->push_back (xyz);
-        current_sweep_xyzrgba_->push_back (xyzrgba);
-        current_sweep_xyzi_->push_back (xyzi);
-
-        last_azimuth_ = current_azimuth;
-      }
-      if (dataPacket->mode == VLP_DUAL_MODE)
+      for (std::uint8_t j = 0; j < VLP_MAX_NUM_LASERS; j++)
       {
-        if ((dual_xyz.x != xyz.x || dual_xyz.y != xyz.y || dual_xyz.z != xyz.z)
-            && ! (std::isnan (dual_xyz.x) || std::isnan (dual_xyz.y) || std::isnan (dual_xyz.z)))
+        if (!std::isnan (decoded.x[j]))
+        {
+          appendPoint (decoded, j, laser_rgb_mapping_[j], false);
+          last_azimuth_ = azimuth;
+        }
+        if (dual_mode && !std::isnan (dual_decoded.x[j])
+            && (dual_decoded.x[j] != decoded.x[j] || dual_decoded.y[j] != decoded.y[j] || dual_decoded.z[j] != decoded.z[j]))
         {
-          current_sweep_xyz_->push_back (dual_xyz);
-          current_sweep_xyzrgba_->push_back (dual_xyzrgba);
-          current_sweep_xyzi_->push_back (dual_xyzi);
+          appendPoint (dual_decoded, j, laser_rgb_mapping_[j], false);
         }
       }
     }
-    if (dataPacket->mode == VLP_DUAL_MODE)
+    if (dual_mode)
     {
       i++;
     }
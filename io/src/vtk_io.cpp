@@ -39,15 +39,19 @@
 
 #include <pcl/point_types.h>
 #include <pcl/io/vtk_io.h>
+#include <pcl/io/ply/byte_order.h>
 #include <fstream>
 #include <pcl/common/io.h>
 
 //////////////////////////////////////////////////////////////////////////////////////////////
-int
-pcl::io::saveVTKFile (const std::string &file_name, 
-                      const pcl::PolygonMesh &triangles, unsigned precision)
+/** \brief Save a mesh in ascii VTK format, given its vertex data and a functor
+  * returning the [begin, end) range of the vertex indices of every face.
+  */
+template <typename FaceFunctor> static int
+saveVTKMesh (const std::string &file_name, const pcl::PCLPointCloud2 &cloud,
+             std::size_t nr_faces, const FaceFunctor &face, unsigned precision)
 {
-  if (triangles.cloud.data.empty ())
+  if (cloud.data.empty ())
   {
     PCL_ERROR ("[pcl::io::saveVTKFile] Input point cloud has no data!\n");
     return (-1);
@@ -58,8 +62,8 @@ pcl::io::saveVTKFile (const std::string &file_name,
   fs.precision (precision);
   fs.open (file_name.c_str ());
 
-  unsigned int nr_points  = triangles.cloud.width * triangles.cloud.height;
-  unsigned int point_size = static_cast<unsigned int> (triangles.cloud.data.size () / nr_points);
+  unsigned int nr_points  = cloud.width * cloud.height;
+  unsigned int point_size = static_cast<unsigned int> (cloud.data.size () / nr_points);
 
   // Write the header information
   fs << "# vtk DataFile Version 3.0\nvtk output\nASCII\nDATASET POLYDATA\nPOINTS " << nr_points << " float" << '\n';
@@ -68,15 +72,15 @@ pcl::io::saveVTKFile (const std::string &file_name,
   for (unsigned int i = 0; i < nr_points; ++i)
   {
     int xyz = 0;
-    for (std::size_t d = 0; d < triangles.cloud.fields.size (); ++d)
+    for (std::size_t d = 0; d < cloud.fields.size (); ++d)
     {
-      if ((triangles.cloud.fields[d].datatype == pcl::PCLPointField::FLOAT32) && (
-           triangles.cloud.fields[d].name == "x" || 
-           triangles.cloud.fields[d].name == "y" || 
-           triangles.cloud.fields[d].name == "z"))
+      if ((cloud.fields[d].datatype == pcl::PCLPointField::FLOAT32) && (
+           cloud.fields[d].name == "x" || 
+           cloud.fields[d].name == "y" || 
+           cloud.fields[d].name == "z"))
       {
         float value;
-        memcpy (&value, &triangles.cloud.data[i * point_size + triangles.cloud.fields[d].offset], sizeof (float));
+        memcpy (&value, &cloud.data[i * point_size + cloud.fields[d].offset], sizeof (float));
         fs << value;
         if (++xyz == 3)
           break;
@@ -98,30 +102,39 @@ pcl::io::saveVTKFile (const std::string &file_name,
 
   // Write polygons
   // compute the correct number of values:
-  std::size_t triangle_size = triangles.polygons.size ();
-  std::size_t correct_number = triangle_size;
-  for (std::size_t i = 0; i < triangle_size; ++i)
-    correct_number += triangles.polygons[i].vertices.size ();
-  fs << "\nPOLYGONS " << triangle_size << " " << correct_number << '\n';
-  for (std::size_t i = 0; i < triangle_size; ++i)
+  std::size_t correct_number = nr_faces;
+  for (std::size_t i = 0; i < nr_faces; ++i)
   {
-    fs << triangles.polygons[i].vertices.size () << " ";
-    for (std::size_t j = 0; j < triangles.polygons[i].vertices.size () - 1; ++j)
-      fs << triangles.polygons[i].vertices[j] << " ";
-    fs << triangles.polygons[i].vertices.back() << '\n';
+    const auto vertices = face (i);
+    correct_number += vertices.second - vertices.first;
+  }
+  fs << "\nPOLYGONS " << nr_faces << " " << correct_number << '\n';
+  for (std::size_t i = 0; i < nr_faces; ++i)
+  {
+    const auto vertices = face (i);
+    fs << vertices.second - vertices.first << " ";
+    for (auto v = vertices.first; v != vertices.second - 1; ++v)
+      fs << *v << " ";
+    fs << *(vertices.second - 1) << '\n';
   }
 
   // Write RGB values
-  int field_index = getFieldIndex (triangles.cloud, "rgb");
+  int field_index = getFieldIndex (cloud, "rgb");
+  const int normal_x_index = getFieldIndex (cloud, "normal_x");
+  const int normal_y_index = getFieldIndex (cloud, "normal_y");
+  const int normal_z_index = getFieldIndex (cloud, "normal_z");
+  const bool has_normals = normal_x_index != -1 && normal_y_index != -1 && normal_z_index != -1;
+  if (field_index != -1 || has_normals)
+    fs << "\nPOINT_DATA " << nr_points;
   if (field_index != -1)
   {
-    fs << "\nPOINT_DATA " << nr_points << "\nCOLOR_SCALARS scalars 3\n";
+    fs << "\nCOLOR_SCALARS scalars 3\n";
     for (unsigned int i = 0; i < nr_points; ++i)
     {
-      if (triangles.cloud.fields[field_index].datatype == pcl::PCLPointField::FLOAT32)
+      if (cloud.fields[field_index].datatype == pcl::PCLPointField::FLOAT32)
       {
         pcl::RGB color;
-        memcpy (&color, &triangles.cloud.data[i * point_size + triangles.cloud.fields[field_index].offset], sizeof (RGB));
+        memcpy (&color, &cloud.data[i * point_size + cloud.fields[field_index].offset], sizeof (pcl::RGB));
         int r = color.r;
         int g = color.g;
         int b = color.b;
@@ -131,11 +144,216 @@ pcl::io::saveVTKFile (const std::string &file_name,
     }
   }
 
+  // Write normals
+  if (has_normals)
+  {
+    fs << "\nNORMALS normals float\n";
+    for (unsigned int i = 0; i < nr_points; ++i)
+    {
+      float normal[3];
+      memcpy (&normal[0], &cloud.data[i * point_size + cloud.fields[normal_x_index].offset], sizeof (float));
+      memcpy (&normal[1], &cloud.data[i * point_size + cloud.fields[normal_y_index].offset], sizeof (float));
+      memcpy (&normal[2], &cloud.data[i * point_size + cloud.fields[normal_z_index].offset], sizeof (float));
+      fs << normal[0] << " " << normal[1] << " " << normal[2] << '\n';
+    }
+  }
+
   // Close file
   fs.close ();
   return (0);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////
+/** \brief Append a value to a buffer, in the big endian byte order of the binary VTK files. */
+template <typename T> static inline char*
+writeVTKBinary (char *buffer, T value)
+{
+  if (pcl::io::ply::host_byte_order == pcl::io::ply::little_endian_byte_order)
+    pcl::io::ply::swap_byte_order (value);
+  memcpy (buffer, &value, sizeof (T));
+  return (buffer + sizeof (T));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+/** \brief Save a mesh in binary VTK format, given its vertex data and a functor
+  * returning the [begin, end) range of the vertex indices of every face.
+  *
+  * Every section is converted into a buffer and written at once.
+  */
+template <typename FaceFunctor> static int
+saveVTKMeshBinary (const std::string &file_name, const pcl::PCLPointCloud2 &cloud,
+                   std::size_t nr_faces, const FaceFunctor &face)
+{
+  if (cloud.data.empty ())
+  {
+    PCL_ERROR ("[pcl::io::saveVTKFileBinary] Input point cloud has no data!\n");
+    return (-1);
+  }
+
+  const int x_index = getFieldIndex (cloud, "x");
+  const int y_index = getFieldIndex (cloud, "y");
+  const int z_index = getFieldIndex (cloud, "z");
+  if (x_index == -1 || y_index == -1 || z_index == -1 ||
+      cloud.fields[x_index].datatype != pcl::PCLPointField::FLOAT32 ||
+      cloud.fields[y_index].datatype != pcl::PCLPointField::FLOAT32 ||
+      cloud.fields[z_index].datatype != pcl::PCLPointField::FLOAT32)
+  {
+    PCL_ERROR ("[pcl::io::saveVTKFileBinary] Input point cloud has no XYZ data!\n");
+    return (-2);
+  }
+
+  std::ofstream fs (file_name.c_str (), std::ios::binary);
+  if (!fs)
+  {
+    PCL_ERROR ("[pcl::io::saveVTKFileBinary] Error during opening (%s)!\n", file_name.c_str ());
+    return (-1);
+  }
+
+  const std::size_t nr_points = cloud.width * cloud.height;
+  const std::size_t point_size = cloud.data.size () / nr_points;
+  std::vector<char> buffer;
+
+  // Write the points
+  fs << "# vtk DataFile Version 3.0\nvtk output\nBINARY\nDATASET POLYDATA\nPOINTS " << nr_points << " float\n";
+  buffer.resize (3 * sizeof (float) * nr_points);
+  char *p = buffer.data ();
+  for (std::size_t i = 0; i < nr_points; ++i)
+    for (const int index : {x_index, y_index, z_index})
+    {
+      float value;
+      memcpy (&value, &cloud.data[i * point_size + cloud.fields[index].offset], sizeof (float));
+      p = writeVTKBinary (p, value);
+    }
+  fs.write (buffer.data (), buffer.size ());
+
+  // Write vertices
+  fs << "\nVERTICES " << nr_points << " " << 2 * nr_points << '\n';
+  buffer.resize (2 * sizeof (std::int32_t) * nr_points);
+  p = buffer.data ();
+  for (std::size_t i = 0; i < nr_points; ++i)
+  {
+    p = writeVTKBinary (p, std::int32_t (1));
+    p = writeVTKBinary (p, static_cast<std::int32_t> (i));
+  }
+  fs.write (buffer.data (), buffer.size ());
+
+  // Write polygons
+  std::size_t correct_number = nr_faces;
+  for (std::size_t i = 0; i < nr_faces; ++i)
+  {
+    const auto vertices = face (i);
+    correct_number += vertices.second - vertices.first;
+  }
+  fs << "\nPOLYGONS " << nr_faces << " " << correct_number << '\n';
+  buffer.resize (sizeof (std::int32_t) * correct_number);
+  p = buffer.data ();
+  for (std::size_t i = 0; i < nr_faces; ++i)
+  {
+    const auto vertices = face (i);
+    p = writeVTKBinary (p, static_cast<std::int32_t> (vertices.second - vertices.first));
+    for (auto v = vertices.first; v != vertices.second; ++v)
+      p = writeVTKBinary (p, static_cast<std::int32_t> (*v));
+  }
+  fs.write (buffer.data (), buffer.size ());
+
+  // Write RGB values, the binary color scalars are unsigned chars
+  const int rgb_index = getFieldIndex (cloud, "rgb");
+  const int normal_x_index = getFieldIndex (cloud, "normal_x");
+  const int normal_y_index = getFieldIndex (cloud, "normal_y");
+  const int normal_z_index = getFieldIndex (cloud, "normal_z");
+  const bool has_normals = normal_x_index != -1 && normal_y_index != -1 && normal_z_index != -1;
+  if (rgb_index != -1 || has_normals)
+    fs << "\nPOINT_DATA " << nr_points;
+  if (rgb_index != -1)
+  {
+    fs << "\nCOLOR_SCALARS scalars 3\n";
+    buffer.resize (3 * nr_points);
+    for (std::size_t i = 0; i < nr_points; ++i)
+    {
+      pcl::RGB color;
+      memcpy (&color, &cloud.data[i * point_size + cloud.fields[rgb_index].offset], sizeof (pcl::RGB));
+      buffer[3 * i + 0] = static_cast<char> (color.r);
+      buffer[3 * i + 1] = static_cast<char> (color.g);
+      buffer[3 * i + 2] = static_cast<char> (color.b);
+    }
+    fs.write (buffer.data (), buffer.size ());
+  }
+
+  // Write normals
+  if (has_normals)
+  {
+    fs << "\nNORMALS normals float\n";
+    buffer.resize (3 * sizeof (float) * nr_points);
+    p = buffer.data ();
+    for (std::size_t i = 0; i < nr_points; ++i)
+      for (const int index : {normal_x_index, normal_y_index, normal_z_index})
+      {
+        float value;
+        memcpy (&value, &cloud.data[i * point_size + cloud.fields[index].offset], sizeof (float));
+        p = writeVTKBinary (p, value);
+      }
+    fs.write (buffer.data (), buffer.size ());
+  }
+  fs << '\n';
+
+  if (!fs)
+  {
+    PCL_ERROR ("[pcl::io::saveVTKFileBinary] Error during writing (%s)!\n", file_name.c_str ());
+    return (-1);
+  }
+  return (0);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+int
+pcl::io::saveVTKFile (const std::string &file_name, 
+                      const pcl::PolygonMesh &triangles, unsigned precision)
+{
+  const auto face = [&triangles] (std::size_t i)
+  {
+    const auto &vertices = triangles.polygons[i].vertices;
+    return (std::make_pair (vertices.data (), vertices.data () + vertices.size ()));
+  };
+  return (saveVTKMesh (file_name, triangles.cloud, triangles.polygons.size (), face, precision));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+int
+pcl::io::saveVTKFile (const std::string &file_name,
+                      const pcl::TriangleMesh &triangles, unsigned precision)
+{
+  const auto face = [&triangles] (std::size_t i)
+  {
+    const std::uint32_t *vertices = triangles.getTriangle (i);
+    return (std::make_pair (vertices, vertices + 3));
+  };
+  return (saveVTKMesh (file_name, triangles.cloud, triangles.size (), face, precision));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+int
+pcl::io::saveVTKFileBinary (const std::string &file_name, const pcl::PolygonMesh &triangles)
+{
+  const auto face = [&triangles] (std::size_t i)
+  {
+    const auto &vertices = triangles.polygons[i].vertices;
+    return (std::make_pair (vertices.data (), vertices.data () + vertices.size ()));
+  };
+  return (saveVTKMeshBinary (file_name, triangles.cloud, triangles.polygons.size (), face));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+int
+pcl::io::saveVTKFileBinary (const std::string &file_name, const pcl::TriangleMesh &triangles)
+{
+  const auto face = [&triangles] (std::size_t i)
+  {
+    const std::uint32_t *vertices = triangles.getTriangle (i);
+    return (std::make_pair (vertices, vertices + 3));
+  };
+  return (saveVTKMeshBinary (file_name, triangles.cloud, triangles.size (), face));
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////
 int
 pcl::io::saveVTKFile (const std::string &file_name, 
@@ -37,6 +37,9 @@
 
 #include <pcl/io/vtk_lib_io.h>
 #include <pcl/io/impl/vtk_lib_io.hpp>
+#include <pcl/io/obj_io.h>
+#include <pcl/io/ply_io.h>
+#include <pcl/io/vtk_io.h>
 #include <pcl/PCLPointCloud2.h>
 #include <vtkVersion.h>
 #include <vtkCellArray.h>
@@ -70,7 +73,12 @@ pcl::io::loadPolygonFile (const std::string &file_name, pcl::PolygonMesh& mesh)
   if (extension == "ply")
    return (pcl::io::loadPolygonFilePLY (file_name, mesh));
   if (extension == "obj")
-    return (pcl::io::loadPolygonFileOBJ (file_name, mesh));
+  {
+    // The native reader parses the file straight into the mesh, without a vtkPolyData
+    if (pcl::io::loadOBJFile (file_name, mesh) < 0)
+      return (0);
+    return (static_cast<int> (mesh.cloud.width * mesh.cloud.height));
+  }
   if (extension == "stl" )
     return (pcl::io::loadPolygonFileSTL (file_name, mesh));
   PCL_ERROR ("[pcl::io::loadPolygonFile]: Unsupported file type (%s)\n", extension.c_str ());
@@ -87,10 +95,20 @@ pcl::io::savePolygonFile (const std::string &file_name,
   std::string extension = file_name.substr (file_name.find_last_of ('.') + 1);
   if (extension == "pcd")  // no Polygon, but only a point cloud
     return (pcl::io::savePCDFile (file_name, mesh.cloud, Eigen::Vector4f::Zero (), Eigen::Quaternionf::Identity (), binary_format) == 0);
+  // The binary files are written by the native writers, without a vtkPolyData. The ASCII ones are
+  // still written by VTK, which keeps the full precision of the values
   if (extension == "vtk")
+  {
+    if (binary_format)
+      return (pcl::io::saveVTKFileBinary (file_name, mesh) == 0);
     return (pcl::io::savePolygonFileVTK (file_name, mesh, binary_format));
+  }
   if (extension == "ply")
+  {
+    if (binary_format)
+      return (pcl::io::savePLYFileBinary (file_name, mesh) == 0);
     return (pcl::io::savePolygonFilePLY (file_name, mesh, binary_format));
+  }
   if (extension == "stl")
     return (pcl::io::savePolygonFileSTL (file_name, mesh, binary_format));
   PCL_ERROR ("[pcl::io::savePolygonFile]: Unsupported file type (%s)\n", extension.c_str ());
@@ -42,8 +42,12 @@
 #include <flann/flann.hpp>
 
 #include <pcl/kdtree/kdtree_flann.h>
+#include <pcl/common/utils.h>
 #include <pcl/console/print.h>
 
+#include <numeric>
+#include <type_traits>
+
 ///////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT, typename Dist>
 pcl::KdTreeFLANN<PointT, Dist>::KdTreeFLANN (bool sorted)
@@ -53,6 +57,7 @@ pcl::KdTreeFLANN<PointT, Dist>::KdTreeFLANN (bool sorted)
   , dim_ (0), total_nr_points_ (0)
   , param_k_ (::flann::SearchParams (-1 , epsilon_))
   , param_radius_ (::flann::SearchParams (-1, epsilon_, sorted))
+  , threads_ (1)
 {
 }
 
@@ -65,6 +70,7 @@ pcl::KdTreeFLANN<PointT, Dist>::KdTreeFLANN (const KdTreeFLANN<PointT, Dist> &k)
   , dim_ (0), total_nr_points_ (0)
   , param_k_ (::flann::SearchParams (-1 , epsilon_))
   , param_radius_ (::flann::SearchParams (-1, epsilon_, false))
+  , threads_ (1)
 {
   *this = k;
 }
@@ -120,11 +126,207 @@ pcl::KdTreeFLANN<PointT, Dist>::setInputCloud (const PointCloudConstPtr &cloud,
     return;
   }
 
-  flann_index_.reset (new FLANNIndex (::flann::Matrix<float> (cloud_.get (), 
-                                                              index_mapping_.size (), 
-                                                              dim_),
-                                      ::flann::KDTreeSingleIndexParams (15))); // max 15 points/leaf
-  flann_index_->buildIndex ();
+  buildIndex ();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT, typename Dist> template <typename CoordinateT> void
+pcl::KdTreeFLANN<PointT, Dist>::setInputCloud (const CompactPointCloud<CoordinateT> &cloud,
+                                               const IndicesConstPtr &indices)
+{
+  cleanup ();
+
+  epsilon_ = 0.0f;
+  dim_ = point_representation_->getNumberOfDimensions ();
+
+  // The points are decoded one by one, the tree keeps no decoded copy of the cloud
+  input_.reset ();
+  indices_ = indices;
+  const auto point_of = [&cloud] (int index) { return (cloud.template getPoint<PointT> (index)); };
+  if (cloud.empty ())
+    cloud_.reset ();
+  else if (indices_)
+  {
+    vectorizePoints (static_cast<int> (indices_->size ()), [this] (int i) { return ((*indices_)[i]); }, point_of);
+    identity_mapping_ = false;
+  }
+  else
+  {
+    vectorizePoints (static_cast<int> (cloud.size ()), [] (int i) { return (i); }, point_of);
+    identity_mapping_ = (index_mapping_.size () == cloud.size ());
+  }
+  total_nr_points_ = static_cast<int> (index_mapping_.size ());
+  if (total_nr_points_ == 0)
+  {
+    PCL_ERROR ("[pcl::KdTreeFLANN::setInputCloud] Cannot create a KDTree with an empty input cloud!\n");
+    return;
+  }
+
+  buildIndex ();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT, typename Dist> void
+pcl::KdTreeFLANN<PointT, Dist>::setInputArray (const PointCloudConstPtr &cloud, const std::shared_ptr<float> &data,
+                                               std::size_t nr_points, const IndicesConstPtr &indices)
+{
+  cleanup ();   // Perform an automatic cleanup of structures
+
+  epsilon_ = 0.0f;   // default error bound value
+  dim_ = point_representation_->getNumberOfDimensions ();
+
+  input_   = cloud;
+  indices_ = indices;
+
+  if (!input_ || !data)
+  {
+    PCL_ERROR ("[pcl::KdTreeFLANN::setInputArray] Invalid input!\n");
+    return;
+  }
+  if (indices_ && indices_->size () != nr_points)
+  {
+    PCL_ERROR ("[pcl::KdTreeFLANN::setInputArray] The number of indices (%zu) differs from the number of points (%zu)!\n",
+               indices_->size (), nr_points);
+    return;
+  }
+  if (nr_points == 0)
+  {
+    PCL_ERROR ("[pcl::KdTreeFLANN::setInputArray] Cannot create a KDTree with an empty input cloud!\n");
+    return;
+  }
+
+  cloud_ = data;
+  if (indices_)
+  {
+    index_mapping_ = *indices_;
+    identity_mapping_ = false;
+  }
+  else
+  {
+    index_mapping_.resize (nr_points);
+    std::iota (index_mapping_.begin (), index_mapping_.end (), 0);
+    identity_mapping_ = true;
+  }
+  total_nr_points_ = static_cast<int> (nr_points);
+
+  buildIndex ();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT, typename Dist> void
+pcl::KdTreeFLANN<PointT, Dist>::buildIndex ()
+{
+  flann_index_.reset ();
+  partitions_.clear ();
+
+  // Blocks only give the same neighbors as a single tree if the distance to a bounding box bounds the
+  // distance to every point inside it
+  const unsigned int threads = pcl::utils::getNumberOfThreads (threads_);
+  int nr_partitions = 1;
+  if (std::is_same<Dist, ::flann::L2_Simple<float> >::value || std::is_same<Dist, ::flann::L2<float> >::value)
+  {
+    while (static_cast<unsigned int> (2 * nr_partitions) <= threads &&
+           total_nr_points_ / (2 * nr_partitions) >= min_points_per_partition_)
+      nr_partitions *= 2;
+  }
+
+  if (nr_partitions == 1)
+  {
+    flann_index_.reset (new FLANNIndex (::flann::Matrix<float> (cloud_.get (), 
+                                                                total_nr_points_, 
+                                                                dim_),
+                                        ::flann::KDTreeSingleIndexParams (15))); // max 15 points/leaf
+    flann_index_->buildIndex ();
+    return;
+  }
+
+  // Build the top levels of the tree: split every block at the median of its widest dimension, until
+  // there is one block per thread
+  const float* data = cloud_.get ();
+  std::vector<int> order (total_nr_points_);
+  std::iota (order.begin (), order.end (), 0);
+  std::vector<std::pair<int, int> > blocks (1, std::make_pair (0, total_nr_points_));
+  while (static_cast<int> (blocks.size ()) < nr_partitions)
+  {
+    std::vector<std::pair<int, int> > next_blocks (2 * blocks.size ());
+#pragma omp parallel for \
+  default(none) \
+  shared(blocks, data, next_blocks, order) \
+  num_threads(threads)
+    for (int b = 0; b < static_cast<int> (blocks.size ()); ++b)
+    {
+      const int begin = blocks[b].first, end = blocks[b].second;
+      std::vector<float> min_pt (dim_, std::numeric_limits<float>::max ());
+      std::vector<float> max_pt (dim_, -std::numeric_limits<float>::max ());
+      for (int i = begin; i < end; ++i)
+      {
+        const float* row = data + static_cast<std::size_t> (order[i]) * dim_;
+        for (int d = 0; d < dim_; ++d)
+        {
+          min_pt[d] = std::min (min_pt[d], row[d]);
+          max_pt[d] = std::max (max_pt[d], row[d]);
+        }
+      }
+      int split_dim = 0;
+      for (int d = 1; d < dim_; ++d)
+        if (max_pt[d] - min_pt[d] > max_pt[split_dim] - min_pt[split_dim])
+          split_dim = d;
+
+      const int middle = begin + (end - begin) / 2;
+      std::nth_element (order.begin () + begin, order.begin () + middle, order.begin () + end,
+                        [&] (int a, int c) { return (data[static_cast<std::size_t> (a) * dim_ + split_dim] <
+                                                     data[static_cast<std::size_t> (c) * dim_ + split_dim]); });
+      next_blocks[2 * b] = std::make_pair (begin, middle);
+      next_blocks[2 * b + 1] = std::make_pair (middle, end);
+    }
+    blocks.swap (next_blocks);
+  }
+
+  // Store the rows block by block, so that every block is a contiguous FLANN matrix
+  std::shared_ptr<float> ordered_data (new float[static_cast<std::size_t> (total_nr_points_) * dim_],
+                                       std::default_delete<float[]> ());
+  std::vector<int> ordered_mapping (total_nr_points_);
+#pragma omp parallel for \
+  default(none) \
+  shared(data, order, ordered_data, ordered_mapping) \
+  num_threads(threads)
+  for (int i = 0; i < total_nr_points_; ++i)
+  {
+    std::copy_n (data + static_cast<std::size_t> (order[i]) * dim_, dim_,
+                 ordered_data.get () + static_cast<std::size_t> (i) * dim_);
+    ordered_mapping[i] = index_mapping_[order[i]];
+  }
+  cloud_ = ordered_data;
+  index_mapping_.swap (ordered_mapping);
+  identity_mapping_ = false;
+
+  // Build the subtrees concurrently
+  partitions_.resize (nr_partitions);
+#pragma omp parallel for \
+  default(none) \
+  shared(blocks, nr_partitions) \
+  num_threads(threads) \
+  schedule(dynamic, 1)
+  for (int p = 0; p < nr_partitions; ++p)
+  {
+    Partition &partition = partitions_[p];
+    partition.offset = blocks[p].first;
+    partition.size = blocks[p].second - blocks[p].first;
+    float* rows = cloud_.get () + static_cast<std::size_t> (partition.offset) * dim_;
+
+    partition.min_pt.assign (dim_, std::numeric_limits<float>::max ());
+    partition.max_pt.assign (dim_, -std::numeric_limits<float>::max ());
+    for (int i = 0; i < partition.size; ++i)
+      for (int d = 0; d < dim_; ++d)
+      {
+        partition.min_pt[d] = std::min (partition.min_pt[d], rows[i * dim_ + d]);
+        partition.max_pt[d] = std::max (partition.max_pt[d], rows[i * dim_ + d]);
+      }
+
+    partition.index.reset (new FLANNIndex (::flann::Matrix<float> (rows, partition.size, dim_),
+                                           ::flann::KDTreeSingleIndexParams (15))); // max 15 points/leaf
+    partition.index->buildIndex ();
+  }
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////
@@ -141,13 +343,16 @@ pcl::KdTreeFLANN<PointT, Dist>::nearestKSearch (const PointT &point, int k,
   k_indices.resize (k);
   k_distances.resize (k);
 
-  std::vector<float> query (dim_);
-  point_representation_->vectorize (static_cast<PointT> (point), query);
+  QueryBuffer query (dim_);
+  point_representation_->vectorize (static_cast<PointT> (point), query.data);
+
+  if (!partitions_.empty ())
+    return (nearestKSearchPartitions (query.data, k, k_indices, k_distances));
 
   ::flann::Matrix<int> k_indices_mat (&k_indices[0], 1, k);
   ::flann::Matrix<float> k_distances_mat (&k_distances[0], 1, k);
   // Wrap the k_indices and k_distances vectors (no data copy)
-  flann_index_->knnSearch (::flann::Matrix<float> (&query[0], 1, dim_), 
+  flann_index_->knnSearch (::flann::Matrix<float> (query.data, 1, dim_),
                            k_indices_mat, k_distances_mat,
                            k, param_k_);
 
@@ -171,30 +376,51 @@ pcl::KdTreeFLANN<PointT, Dist>::radiusSearch (const PointT &point, double radius
 {
   assert (point_representation_->isValid (point) && "Invalid (NaN, Inf) point coordinates given to radiusSearch!");
 
-  std::vector<float> query (dim_);
-  point_representation_->vectorize (static_cast<PointT> (point), query);
+  QueryBuffer query (dim_);
+  point_representation_->vectorize (static_cast<PointT> (point), query.data);
+  ::flann::Matrix<float> query_mat (query.data, 1, dim_);
 
   // Has max_nn been set properly?
   if (max_nn == 0 || max_nn > static_cast<unsigned int> (total_nr_points_))
     max_nn = total_nr_points_;
 
-  std::vector<std::vector<int> > indices(1);
-  std::vector<std::vector<float> > dists(1);
+  if (!partitions_.empty ())
+    return (radiusSearchPartitions (query.data, radius, k_indices, k_sqr_dists, max_nn));
 
+  // The results are written straight into the caller's vectors. Their current capacity is tried
+  // first, so a caller reusing the same vectors in a loop does not allocate once they are large
+  // enough. Only if the neighborhood overflows that capacity the neighbors are counted and the
+  // vectors grow to the exact size needed. Fresh vectors start with room for a few neighbors.
+  std::size_t capacity = std::min (std::max<std::size_t> (std::min (k_indices.capacity (), k_sqr_dists.capacity ()), 32),
+                                   static_cast<std::size_t> (max_nn));
   ::flann::SearchParams params (param_radius_);
-  if (max_nn == static_cast<unsigned int>(total_nr_points_))
-    params.max_neighbors = -1;  // return all neighbors in radius
-  else
-    params.max_neighbors = max_nn;
+  params.max_neighbors = static_cast<int> (capacity);
 
-  int neighbors_in_radius = flann_index_->radiusSearch (::flann::Matrix<float> (&query[0], 1, dim_),
-      indices,
-      dists,
-      static_cast<float> (radius * radius), 
-      params);
+  k_indices.resize (capacity);
+  k_sqr_dists.resize (capacity);
+  ::flann::Matrix<int> k_indices_mat (k_indices.data (), 1, capacity);
+  ::flann::Matrix<float> k_distances_mat (k_sqr_dists.data (), 1, capacity);
+  int neighbors_in_radius = flann_index_->radiusSearch (query_mat, k_indices_mat, k_distances_mat,
+                                                        static_cast<float> (radius * radius), params);
 
-  k_indices = indices[0];
-  k_sqr_dists = dists[0];
+  if (static_cast<std::size_t> (neighbors_in_radius) == capacity && capacity < max_nn)
+  {
+    // Overflow: count all the neighbors in radius (max_neighbors = 0) and search again
+    params.max_neighbors = 0;
+    std::size_t count = flann_index_->radiusSearch (query_mat, k_indices_mat, k_distances_mat,
+                                                    static_cast<float> (radius * radius), params);
+    capacity = std::min (count, static_cast<std::size_t> (max_nn));
+    params.max_neighbors = static_cast<int> (capacity);
+
+    k_indices.resize (capacity);
+    k_sqr_dists.resize (capacity);
+    k_indices_mat = ::flann::Matrix<int> (k_indices.data (), 1, capacity);
+    k_distances_mat = ::flann::Matrix<float> (k_sqr_dists.data (), 1, capacity);
+    neighbors_in_radius = flann_index_->radiusSearch (query_mat, k_indices_mat, k_distances_mat,
+                                                      static_cast<float> (radius * radius), params);
+  }
+  k_indices.resize (neighbors_in_radius);
+  k_sqr_dists.resize (neighbors_in_radius);
 
   // Do mapping to original point cloud
   if (!identity_mapping_) 
@@ -210,11 +436,117 @@ pcl::KdTreeFLANN<PointT, Dist>::radiusSearch (const PointT &point, double radius
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT, typename Dist> int
+pcl::KdTreeFLANN<PointT, Dist>::nearestKSearchPartitions (const float *query, int k, std::vector<int> &k_indices,
+                                                          std::vector<float> &k_distances) const
+{
+  if (k <= 0)
+    return (0);
+
+  // Visit the blocks by increasing distance, until the closest remaining block is farther away than
+  // the k-th neighbor found so far
+  std::vector<std::pair<float, std::size_t> > visit_order (partitions_.size ());
+  for (std::size_t p = 0; p < partitions_.size (); ++p)
+    visit_order[p] = std::make_pair (partitions_[p].sqrDistance (query), p);
+  std::sort (visit_order.begin (), visit_order.end ());
+
+  const auto closer = [] (const std::pair<float, int> &a, const std::pair<float, int> &b) { return (a.first < b.first); };
+  std::vector<std::pair<float, int> > neighbors;
+  neighbors.reserve (2 * k);
+  std::vector<int> block_indices (k);
+  std::vector<float> block_distances (k);
+  ::flann::Matrix<float> query_mat (const_cast<float*> (query), 1, dim_);
+  for (const auto &block : visit_order)
+  {
+    if (static_cast<int> (neighbors.size ()) == k && block.first > neighbors.back ().first)
+      break;
+
+    const Partition &partition = partitions_[block.second];
+    const int block_k = std::min (k, partition.size);
+    ::flann::Matrix<int> block_indices_mat (block_indices.data (), 1, block_k);
+    ::flann::Matrix<float> block_distances_mat (block_distances.data (), 1, block_k);
+    partition.index->knnSearch (query_mat, block_indices_mat, block_distances_mat, block_k, param_k_);
+
+    // Both the neighbors so far and the ones of the block are sorted by distance
+    const std::size_t nr_neighbors = neighbors.size ();
+    for (int i = 0; i < block_k; ++i)
+      neighbors.emplace_back (block_distances[i], partition.offset + block_indices[i]);
+    std::inplace_merge (neighbors.begin (), neighbors.begin () + nr_neighbors, neighbors.end (), closer);
+    if (static_cast<int> (neighbors.size ()) > k)
+      neighbors.resize (k);
+  }
+
+  for (int i = 0; i < k; ++i)
+  {
+    k_distances[i] = neighbors[i].first;
+    k_indices[i] = index_mapping_[neighbors[i].second];
+  }
+  return (k);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT, typename Dist> int
+pcl::KdTreeFLANN<PointT, Dist>::radiusSearchPartitions (const float *query, double radius, std::vector<int> &k_indices,
+                                                        std::vector<float> &k_sqr_dists, unsigned int max_nn) const
+{
+  const float sqr_radius = static_cast<float> (radius * radius);
+  ::flann::SearchParams params (param_radius_);
+  params.max_neighbors = static_cast<int> (max_nn);
+
+  std::vector<std::pair<float, int> > neighbors;
+  std::vector<std::vector<int> > block_indices (1);
+  std::vector<std::vector<float> > block_distances (1);
+  ::flann::Matrix<float> query_mat (const_cast<float*> (query), 1, dim_);
+  for (const auto &partition : partitions_)
+  {
+    if (partition.sqrDistance (query) > sqr_radius)
+      continue;
+
+    partition.index->radiusSearch (query_mat, block_indices, block_distances, sqr_radius, params);
+    for (std::size_t i = 0; i < block_indices[0].size (); ++i)
+      neighbors.emplace_back (block_distances[0][i], partition.offset + block_indices[0][i]);
+  }
+
+  // The blocks bound the number of neighbors each, and are sorted each
+  if (neighbors.size () > max_nn)
+  {
+    if (sorted_)
+      std::partial_sort (neighbors.begin (), neighbors.begin () + max_nn, neighbors.end ());
+    neighbors.resize (max_nn);
+  }
+  else if (sorted_)
+    std::sort (neighbors.begin (), neighbors.end ());
+
+  k_indices.resize (neighbors.size ());
+  k_sqr_dists.resize (neighbors.size ());
+  for (std::size_t i = 0; i < neighbors.size (); ++i)
+  {
+    k_sqr_dists[i] = neighbors[i].first;
+    k_indices[i] = index_mapping_[neighbors[i].second];
+  }
+  return (static_cast<int> (neighbors.size ()));
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT, typename Dist> std::size_t
+pcl::KdTreeFLANN<PointT, Dist>::getMemoryUsage () const
+{
+  std::size_t memory = sizeof (*this) + index_mapping_.capacity () * sizeof (int);
+  if (cloud_)
+    memory += static_cast<std::size_t> (total_nr_points_) * dim_ * sizeof (float);
+  if (flann_index_)
+    memory += static_cast<std::size_t> (flann_index_->usedMemory ());
+  for (const auto &partition : partitions_)
+    memory += sizeof (Partition) + 2 * dim_ * sizeof (float) + static_cast<std::size_t> (partition.index->usedMemory ());
+  return (memory);
+}
+
 template <typename PointT, typename Dist> void 
 pcl::KdTreeFLANN<PointT, Dist>::cleanup ()
 {
   // Data array cleanup
   index_mapping_.clear ();
+  partitions_.clear ();
 
   if (indices_)
     indices_.reset ();
@@ -231,27 +563,9 @@ pcl::KdTreeFLANN<PointT, Dist>::convertCloudToArray (const PointCloud &cloud)
     return;
   }
 
-  const auto original_no_of_points = cloud.size ();
-
-  cloud_.reset (new float[original_no_of_points * dim_], std::default_delete<float[]> ());
-  float* cloud_ptr = cloud_.get ();
-  index_mapping_.reserve (original_no_of_points);
-  identity_mapping_ = true;
-
-  for (std::size_t cloud_index = 0; cloud_index < original_no_of_points; ++cloud_index)
-  {
-    // Check if the point is invalid
-    if (!point_representation_->isValid (cloud[cloud_index]))
-    {
-      identity_mapping_ = false;
-      continue;
-    }
-
-    index_mapping_.push_back (cloud_index);
-
-    point_representation_->vectorize (cloud[cloud_index], cloud_ptr);
-    cloud_ptr += dim_;
-  }
+  vectorizePoints (static_cast<int> (cloud.size ()), [] (int i) { return (i); },
+                   [&cloud] (int index) -> const PointT& { return (cloud[index]); });
+  identity_mapping_ = (index_mapping_.size () == cloud.size ());
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////
@@ -265,11 +579,9 @@ pcl::KdTreeFLANN<PointT, Dist>::convertCloudToArray (const PointCloud &cloud, co
     return;
   }
 
-  int original_no_of_points = static_cast<int> (indices.size ());
-
-  cloud_.reset (new float[original_no_of_points * dim_], std::default_delete<float[]> ());
-  float* cloud_ptr = cloud_.get ();
-  index_mapping_.reserve (original_no_of_points);
+  // map from 0 - N -> indices [0] - indices [N]
+  vectorizePoints (static_cast<int> (indices.size ()), [&indices] (int i) { return (indices[i]); },
+                   [&cloud] (int index) -> const PointT& { return (cloud[index]); });
   // its a subcloud -> false
   // true only identity: 
   //     - indices size equals cloud size
@@ -278,19 +590,63 @@ pcl::KdTreeFLANN<PointT, Dist>::convertCloudToArray (const PointCloud &cloud, co
   //     => index is complete
   // But we can not guarantee that => identity_mapping_ = false
   identity_mapping_ = false;
-  
-  for (const int &index : indices)
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT, typename Dist> template <typename IndexFunction, typename PointFunction> void
+pcl::KdTreeFLANN<PointT, Dist>::vectorizePoints (int nr_points, const IndexFunction &index_of,
+                                                 const PointFunction &point_of)
+{
+  cloud_.reset (new float[static_cast<std::size_t> (nr_points) * dim_], std::default_delete<float[]> ());
+  index_mapping_.resize (nr_points);
+
+  // The points are converted in blocks. With several blocks, the valid points of every block are
+  // counted first, so that each block knows where to write its points in the compacted array.
+  const unsigned int threads = pcl::utils::getNumberOfThreads (threads_);
+  const int nr_blocks = std::max (std::min (4 * static_cast<int> (threads), nr_points / 4096), 1);
+  const int block_size = (nr_points + nr_blocks - 1) / nr_blocks;
+  std::vector<int> block_offsets (nr_blocks + 1, 0);
+  if (nr_blocks > 1)
   {
-    // Check if the point is invalid
-    if (!point_representation_->isValid (cloud[index]))
-      continue;
+#pragma omp parallel for \
+  default(none) \
+  shared(block_offsets, block_size, index_of, nr_blocks, nr_points, point_of) \
+  num_threads(threads)
+    for (int b = 0; b < nr_blocks; ++b)
+    {
+      const int end = std::min (nr_points, (b + 1) * block_size);
+      for (int i = b * block_size; i < end; ++i)
+        if (point_representation_->isValid (point_of (index_of (i))))
+          ++block_offsets[b + 1];
+    }
+    std::partial_sum (block_offsets.begin (), block_offsets.end (), block_offsets.begin ());
+  }
 
-    // map from 0 - N -> indices [0] - indices [N]
-    index_mapping_.push_back (index);  // If the returned index should be for the indices vector
-    
-    point_representation_->vectorize (cloud[index], cloud_ptr);
-    cloud_ptr += dim_;
+  int nr_valid = 0;
+#pragma omp parallel for \
+  default(none) \
+  shared(block_offsets, block_size, index_of, nr_blocks, nr_points, point_of) \
+  reduction(+:nr_valid) \
+  num_threads(threads)
+  for (int b = 0; b < nr_blocks; ++b)
+  {
+    int position = block_offsets[b];
+    float* cloud_ptr = cloud_.get () + static_cast<std::size_t> (position) * dim_;
+    const int end = std::min (nr_points, (b + 1) * block_size);
+    for (int i = b * block_size; i < end; ++i)
+    {
+      const PointT &point = point_of (index_of (i));
+      // Check if the point is invalid
+      if (!point_representation_->isValid (point))
+        continue;
+
+      index_mapping_[position++] = index_of (i);
+      point_representation_->vectorize (point, cloud_ptr);
+      cloud_ptr += dim_;
+    }
+    nr_valid += position - block_offsets[b];
   }
+  index_mapping_.resize (nr_valid);
 }
 
 #define PCL_INSTANTIATE_KdTreeFLANN(T) template class PCL_EXPORTS pcl::KdTreeFLANN<T>;
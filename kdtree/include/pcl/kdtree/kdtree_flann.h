@@ -40,10 +40,13 @@
 
 #pragma once
 
+#include <pcl/compact_point_cloud.h>
 #include <pcl/kdtree/kdtree.h>
 #include <flann/util/params.h>
 
+#include <algorithm>
 #include <memory>
+#include <vector>
 
 // Forward declarations
 namespace flann
@@ -114,6 +117,8 @@ namespace pcl
         total_nr_points_ = k.total_nr_points_;
         param_k_ = k.param_k_;
         param_radius_ = k.param_radius_;
+        threads_ = k.threads_;
+        partitions_ = k.partitions_;
         return (*this);
       }
 
@@ -143,6 +148,46 @@ namespace pcl
       void 
       setInputCloud (const PointCloudConstPtr &cloud, const IndicesConstPtr &indices = IndicesConstPtr ()) override;
 
+      /** \brief Build the tree on a compact point cloud. Every point is decoded into a PointT, whose
+        * coordinates, normal and color are set (see CompactPointCloud::getPoint), and written straight into
+        * the array searched by FLANN, so no decoded copy of the whole cloud is ever made.
+        * \param[in] cloud the compact point cloud, which is not referenced after the call
+        * \param[in] indices the point indices subset that is to be used from \a cloud - if NULL the whole cloud is used
+        * \note The tree has no input cloud afterwards (\ref getInputCloud returns NULL), so the searches for the
+        * neighbors of the point at an index of the input are not available. Search with query points instead.
+        */
+      template <typename CoordinateT> void
+      setInputCloud (const CompactPointCloud<CoordinateT> &cloud, const IndicesConstPtr &indices = IndicesConstPtr ());
+
+      /** \brief Build the tree on points that are already vectorized (e.g. by an earlier stage of a
+        * pipeline), instead of converting \a cloud again.
+        * \param[in] cloud the point cloud the rows of \a data were computed from
+        * \param[in] data row-major array with one row of getNumberOfDimensions () floats per point, as
+        * written by the point representation. All the rows must be valid (i.e., finite). The array is
+        * shared with the tree, not copied, and must not be modified while the tree is in use.
+        * \param[in] nr_points the number of rows in \a data
+        * \param[in] indices the index in \a cloud of every row - if NULL, row i is point i of \a cloud
+        * \note A tree built with several threads (see \ref setNumberOfThreads) reorders the rows and
+        * therefore still copies them, in parallel.
+        */
+      void
+      setInputArray (const PointCloudConstPtr &cloud, const std::shared_ptr<float> &data, std::size_t nr_points,
+                     const IndicesConstPtr &indices = IndicesConstPtr ());
+
+      /** \brief Set the number of threads used to build the tree.
+        * \param[in] nr_threads the number of threads, 0 meaning all the cores (default: 1)
+        *
+        * The points are converted in parallel. Large inputs are also split along their widest dimension
+        * into 2^n spatially disjoint blocks (the top levels of the tree) and one FLANN tree is built per
+        * block concurrently. Searches visit the blocks by increasing distance and skip the blocks that
+        * can not contain a neighbor, so they find the same neighbors as a single tree. Blocks are only
+        * used with Euclidean distances (::flann::L2_Simple and ::flann::L2), with any other \a Dist a
+        * single tree is built.
+        * \note Takes effect with the next call to \ref setInputCloud or \ref setInputArray.
+        */
+      void
+      setNumberOfThreads (unsigned int nr_threads = 0) { threads_ = nr_threads; }
+
       /** \brief Search for k-nearest neighbors for the given query point.
         * 
         * \attention This method does not do any bounds checking for the input index
@@ -175,17 +220,96 @@ namespace pcl
         * returned.
         * \return number of neighbors found in radius
         *
+        * \note The neighbors are written directly into \a k_indices and \a k_sqr_distances, using their
+        * capacity as result buffer. Reusing the same vectors for many queries (e.g. in a clustering loop)
+        * therefore performs no heap allocation, unless a neighborhood is larger than all the previous ones.
+        *
         * \exception asserts in debug mode if the index is not between 0 and the maximum number of points
         */
       int 
       radiusSearch (const PointT &point, double radius, std::vector<int> &k_indices,
                     std::vector<float> &k_sqr_distances, unsigned int max_nn = 0) const override;
 
+      /** \brief Get the memory used by the tree: the internal point array, the index
+        * mapping and the FLANN index itself.
+        * \note The input cloud and indices are shared with the caller and not included.
+        * \return memory in bytes
+        */
+      std::size_t
+      getMemoryUsage () const;
+
     private:
+      /** \brief Storage for a vectorized query point. Points with few dimensions (i.e. almost all of them)
+        * are kept on the stack, so that a query does not need to allocate.
+        */
+      struct QueryBuffer
+      {
+        QueryBuffer (int dim)
+        : data (stack_data)
+        {
+          if (dim > max_stack_dim)
+          {
+            heap_data.resize (dim);
+            data = heap_data.data ();
+          }
+        }
+
+        static constexpr int max_stack_dim = 32;
+        float stack_data[max_stack_dim];
+        std::vector<float> heap_data;
+        float* data;
+      };
+
+      /** \brief One spatially disjoint block of the points, with its own FLANN tree (see \ref setNumberOfThreads). */
+      struct Partition
+      {
+        /** \brief The tree over the rows [offset, offset + size) of the internal point array. */
+        std::shared_ptr<FLANNIndex> index;
+        int offset;
+        int size;
+        /** \brief The bounding box of the block, in the vectorized space. */
+        std::vector<float> min_pt, max_pt;
+
+        /** \brief Squared distance from a vectorized point to the bounding box. */
+        inline float
+        sqrDistance (const float *point) const
+        {
+          float sqr_distance = 0.0f;
+          for (std::size_t d = 0; d < min_pt.size (); ++d)
+          {
+            const float delta = std::max (std::max (min_pt[d] - point[d], point[d] - max_pt[d]), 0.0f);
+            sqr_distance += delta * delta;
+          }
+          return (sqr_distance);
+        }
+      };
+
       /** \brief Internal cleanup method. */
       void 
       cleanup ();
 
+      /** \brief Build the FLANN index (or one index per block) over the internal point array. */
+      void
+      buildIndex ();
+
+      /** \brief Search for the k nearest neighbors in the blocks of a tree built with several threads. */
+      int
+      nearestKSearchPartitions (const float *query, int k, std::vector<int> &k_indices,
+                                std::vector<float> &k_sqr_distances) const;
+
+      /** \brief Search for the neighbors in radius in the blocks of a tree built with several threads. */
+      int
+      radiusSearchPartitions (const float *query, double radius, std::vector<int> &k_indices,
+                              std::vector<float> &k_sqr_distances, unsigned int max_nn) const;
+
+      /** \brief Vectorize the valid points of a cloud into the internal point array, in parallel.
+        * \param[in] nr_points the number of points to convert
+        * \param[in] index_of maps 0 ... nr_points - 1 to the index of the point in the cloud
+        * \param[in] point_of returns the point (PointT or a reference to it) at an index of the cloud
+        */
+      template <typename IndexFunction, typename PointFunction> void
+      vectorizePoints (int nr_points, const IndexFunction &index_of, const PointFunction &point_of);
+
       /** \brief Converts a PointCloud to the internal FLANN point array representation. Returns the number
         * of points.
         * \param cloud the PointCloud 
@@ -229,6 +353,15 @@ namespace pcl
 
       /** \brief The KdTree search parameters for radius search. */
       ::flann::SearchParams param_radius_;
+
+      /** \brief The number of threads used to build the tree. */
+      unsigned int threads_;
+
+      /** \brief The blocks of a tree built with several threads (empty for a single tree). */
+      std::vector<Partition> partitions_;
+
+      /** \brief The minimum number of points per block of a tree built with several threads. */
+      static constexpr int min_points_per_partition_ = 16384;
   };
 }
 
@@ -276,9 +276,11 @@ pcl::HarrisKeypoint3D<PointInT, PointOutT, NormalT>::detectKeypoints (PointCloud
     output.points.clear ();
     output.points.reserve (response->size());
 
+    // maxima are flagged in parallel and collected in index order afterwards
+    std::vector<std::uint8_t> is_maxima_flags (response->size (), 0);
 #pragma omp parallel for \
   default(none) \
-  shared(output, response) \
+  shared(response, is_maxima_flags) \
   num_threads(threads_)
     for (int idx = 0; idx < static_cast<int> (response->size ()); ++idx)
     {
@@ -300,10 +302,15 @@ pcl::HarrisKeypoint3D<PointInT, PointOutT, NormalT>::detectKeypoints (PointCloud
         }
       }
       if (is_maxima)
-#pragma omp critical
+        is_maxima_flags[idx] = 1;
+    }
+
+    for (std::size_t idx = 0; idx < response->size (); ++idx)
+    {
+      if (is_maxima_flags[idx])
       {
         output.points.push_back ((*response)[idx]);
-        keypoints_indices_->indices.push_back (idx);
+        keypoints_indices_->indices.push_back (static_cast<int> (idx));
       }
     }
 
@@ -225,10 +225,13 @@ pcl::HarrisKeypoint6D<PointInT, PointOutT, NormalT>::detectKeypoints (PointCloud
     output.points.clear ();
     output.points.reserve (response->size());
 
+    // maxima are flagged in parallel and collected in index order afterwards
+    std::vector<std::uint8_t> is_maxima_flags (response->size (), 0);
 #pragma omp parallel for \
   default(none) \
+  shared(response, is_maxima_flags) \
   num_threads(threads_)
-    for (std::size_t idx = 0; idx < response->size (); ++idx)
+    for (int idx = 0; idx < static_cast<int> (response->size ()); ++idx)
     {
       if (!isFinite ((*response)[idx]) || (*response)[idx].intensity < threshold_)
         continue;
@@ -246,10 +249,15 @@ pcl::HarrisKeypoint6D<PointInT, PointOutT, NormalT>::detectKeypoints (PointCloud
         }
       }
       if (is_maxima)
-        #pragma omp critical
+        is_maxima_flags[idx] = 1;
+    }
+
+    for (std::size_t idx = 0; idx < response->size (); ++idx)
+    {
+      if (is_maxima_flags[idx])
       {
         output.points.push_back ((*response)[idx]);
-        keypoints_indices_->indices.push_back (idx);
+        keypoints_indices_->indices.push_back (static_cast<int> (idx));
       }
     }
 
@@ -271,11 +279,13 @@ pcl::HarrisKeypoint6D<PointInT, PointOutT, NormalT>::responseTomasi (PointCloudO
   Eigen::SelfAdjointEigenSolver <Eigen::Matrix<float, 6, 6> > solver;
   Eigen::Matrix<float, 6, 6> covariance;
 
+  output.resize (input_->size ());
 #pragma omp parallel for \
   default(none) \
+  shared(output) \
   firstprivate(pointOut, covar, covariance, solver) \
   num_threads(threads_)
-  for (unsigned pIdx = 0; pIdx < input_->size (); ++pIdx)
+  for (int pIdx = 0; pIdx < static_cast<int> (input_->size ()); ++pIdx)
   {
     const PointInT& pointIn = input_->points [pIdx];
     pointOut.intensity = 0.0; //std::numeric_limits<float>::quiet_NaN ();
@@ -345,8 +355,7 @@ pcl::HarrisKeypoint6D<PointInT, PointOutT, NormalT>::responseTomasi (PointCloudO
     pointOut.y = pointIn.y;
     pointOut.z = pointIn.z;
 
-    #pragma omp critical
-    output.points.push_back(pointOut);
+    output[pIdx] = pointOut;
   }
   output.height = input_->height;
   output.width = input_->width;
@@ -149,50 +149,33 @@ pcl::ISSKeypoint3D<PointInT, PointOutT, NormalT>::getBoundaryPoints (PointCloudI
 template<typename PointInT, typename PointOutT, typename NormalT> void
 pcl::ISSKeypoint3D<PointInT, PointOutT, NormalT>::getScatterMatrix (const int& current_index, Eigen::Matrix3d &cov_m)
 {
-  const PointInT& current_point = (*input_)[current_index];
-
-  double central_point[3];
-  memset(central_point, 0, sizeof(double) * 3);
+  std::vector<int> nn_indices;
+  std::vector<float> nn_distances;
+  getScatterMatrix (current_index, cov_m, nn_indices, nn_distances);
+}
 
-  central_point[0] = current_point.x;
-  central_point[1] = current_point.y;
-  central_point[2] = current_point.z;
+//////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointInT, typename PointOutT, typename NormalT> void
+pcl::ISSKeypoint3D<PointInT, PointOutT, NormalT>::getScatterMatrix (const int& current_index, Eigen::Matrix3d &cov_m,
+                                                                   std::vector<int> &nn_indices,
+                                                                   std::vector<float> &nn_distances)
+{
+  const Eigen::Vector3d central_point = (*input_)[current_index].getVector3fMap ().template cast<double> ();
 
   cov_m = Eigen::Matrix3d::Zero ();
 
-  std::vector<int> nn_indices;
-  std::vector<float> nn_distances;
-  int n_neighbors;
-
   this->searchForNeighbors (current_index, salient_radius_, nn_indices, nn_distances);
 
-  n_neighbors = static_cast<int> (nn_indices.size ());
+  const int n_neighbors = static_cast<int> (nn_indices.size ());
 
   if (n_neighbors < min_neighbors_)
     return;
 
-  double cov[9];
-  memset(cov, 0, sizeof(double) * 9);
-
   for (int n_idx = 0; n_idx < n_neighbors; n_idx++)
   {
-    const PointInT& n_point = (*input_)[nn_indices[n_idx]];
-
-    double neigh_point[3];
-    memset(neigh_point, 0, sizeof(double) * 3);
-
-    neigh_point[0] = n_point.x;
-    neigh_point[1] = n_point.y;
-    neigh_point[2] = n_point.z;
-
-    for (int i = 0; i < 3; i++)
-      for (int j = 0; j < 3; j++)
-        cov[i * 3 + j] += (neigh_point[i] - central_point[i]) * (neigh_point[j] - central_point[j]);
+    const Eigen::Vector3d diff = (*input_)[nn_indices[n_idx]].getVector3fMap ().template cast<double> () - central_point;
+    cov_m.noalias () += diff * diff.transpose ();
   }
-
-  cov_m << cov[0], cov[1], cov[2],
-	   cov[3], cov[4], cov[5],
-	   cov[6], cov[7], cov[8];
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////
@@ -326,43 +309,34 @@ pcl::ISSKeypoint3D<PointInT, PointOutT, NormalT>::detectKeypoints (PointCloudOut
     }
   }
 
-#ifdef _OPENMP
-  Eigen::Vector3d *omp_mem = new Eigen::Vector3d[threads_];
+  // The non maxima suppression neighborhood is contained in the salient one whenever its radius is not larger,
+  // so it is taken from the first pass for the points that pass the eigenvalue ratio test instead of searched again
+  const bool reuse_neighbors = (non_max_radius_ <= salient_radius_);
+  const float non_max_radius_sqr = static_cast<float> (non_max_radius_ * non_max_radius_);
+  std::vector<std::vector<int> > non_max_neighbors (reuse_neighbors ? input_->size () : 0);
 
-  for (std::size_t i = 0; i < threads_; i++)
-    omp_mem[i].setZero (3);
-#else
-  Eigen::Vector3d *omp_mem = new Eigen::Vector3d[1];
-
-  omp_mem[0].setZero (3);
-#endif
-
-  double *prg_local_mem = new double[input_->size () * 3];
-  double **prg_mem = new double * [input_->size ()];
-
-  for (std::size_t i = 0; i < input_->size (); i++)
-    prg_mem[i] = prg_local_mem + 3 * i;
+  // eigenvalue ratios e2/e1, e3/e2 and the third eigenvalue of every point (zero if not computed)
+  std::vector<Eigen::Vector3d> prg_mem (input_->size (), Eigen::Vector3d::Zero ());
 
 #pragma omp parallel for \
   default(none) \
-  shared(borders, omp_mem, prg_mem) \
+  shared(borders, non_max_neighbors, prg_mem) \
+  firstprivate(reuse_neighbors, non_max_radius_sqr) \
+  schedule(dynamic, 64) \
   num_threads(threads_)
   for (int index = 0; index < static_cast<int> (input_->size ()); index++)
   {
-#ifdef _OPENMP
-    int tid = omp_get_thread_num ();
-#else
-    int tid = 0;
-#endif
     PointInT current_point = (*input_)[index];
 
     if ((!borders[index]) && pcl::isFinite(current_point))
     {
       //if the considered point is not a border point and the point is "finite", then compute the scatter matrix
-      Eigen::Matrix3d cov_m = Eigen::Matrix3d::Zero ();
-      getScatterMatrix (static_cast<int> (index), cov_m);
+      Eigen::Matrix3d cov_m;
+      std::vector<int> nn_indices;
+      std::vector<float> nn_distances;
+      getScatterMatrix (static_cast<int> (index), cov_m, nn_indices, nn_distances);
 
-      Eigen::SelfAdjointEigenSolver<Eigen::Matrix3d> solver (cov_m);
+      Eigen::SelfAdjointEigenSolver<Eigen::Matrix3d> solver (cov_m, Eigen::EigenvaluesOnly);
 
       const double& e1c = solver.eigenvalues ()[2];
       const double& e2c = solver.eigenvalues ()[1];
@@ -378,13 +352,16 @@ pcl::ISSKeypoint3D<PointInT, PointOutT, NormalT>::detectKeypoints (PointCloudOut
 	continue;
       }
 
-      omp_mem[tid][0] = e2c / e1c;
-      omp_mem[tid][1] = e3c / e2c;;
-      omp_mem[tid][2] = e3c;
-    }
+      prg_mem[index] = Eigen::Vector3d (e2c / e1c, e3c / e2c, e3c);
 
-    for (Eigen::Index d = 0; d < omp_mem[tid].size (); d++)
-        prg_mem[index][d] = omp_mem[tid][d];
+      if (reuse_neighbors && (prg_mem[index][0] < gamma_21_) && (prg_mem[index][1] < gamma_32_))
+      {
+        std::vector<int> &neighbors = non_max_neighbors[index];
+        for (std::size_t j = 0; j < nn_indices.size (); j++)
+          if (nn_distances[j] <= non_max_radius_sqr)
+            neighbors.push_back (nn_indices[j]);
+      }
+    }
   }
 
   for (int index = 0; index < int (input_->size ()); index++)
@@ -400,7 +377,8 @@ pcl::ISSKeypoint3D<PointInT, PointOutT, NormalT>::detectKeypoints (PointCloudOut
 
 #pragma omp parallel for \
   default(none) \
-  shared(feat_max) \
+  shared(feat_max, non_max_neighbors) \
+  firstprivate(reuse_neighbors) \
   num_threads(threads_)
   for (int index = 0; index < int (input_->size ()); index++)
   {
@@ -411,18 +389,19 @@ pcl::ISSKeypoint3D<PointInT, PointOutT, NormalT>::detectKeypoints (PointCloudOut
     {
       std::vector<int> nn_indices;
       std::vector<float> nn_distances;
-      int n_neighbors;
 
-      this->searchForNeighbors (static_cast<int> (index), non_max_radius_, nn_indices, nn_distances);
+      if (!reuse_neighbors)
+        this->searchForNeighbors (static_cast<int> (index), non_max_radius_, nn_indices, nn_distances);
+      const std::vector<int> &neighbors = reuse_neighbors ? non_max_neighbors[index] : nn_indices;
 
-      n_neighbors = static_cast<int> (nn_indices.size ());
+      const int n_neighbors = static_cast<int> (neighbors.size ());
 
       if (n_neighbors >= min_neighbors_)
       {
         bool is_max = true;
 
         for (int j = 0 ; j < n_neighbors; j++)
-          if (third_eigen_value_[index] < third_eigen_value_[nn_indices[j]])
+          if (third_eigen_value_[index] < third_eigen_value_[neighbors[j]])
             is_max = false;
         if (is_max)
           feat_max[index] = true;
@@ -430,14 +409,10 @@ pcl::ISSKeypoint3D<PointInT, PointOutT, NormalT>::detectKeypoints (PointCloudOut
     }
   }
 
-#pragma omp parallel for \
-  default(none) \
-  shared(feat_max, output) \
-  num_threads(threads_)
+  // collect the keypoints in index order, independent of the number of threads
   for (int index = 0; index < int (input_->size ()); index++)
   {
     if (feat_max[index])
-#pragma omp critical
     {
       PointOutT p;
       p.getVector3fMap () = (*input_)[index].getVector3fMap ();
@@ -455,10 +430,7 @@ pcl::ISSKeypoint3D<PointInT, PointOutT, NormalT>::detectKeypoints (PointCloudOut
     normals_.reset (new pcl::PointCloud<NormalT>);
 
   delete[] borders;
-  delete[] prg_mem;
-  delete[] prg_local_mem;
   delete[] feat_max;
-  delete[] omp_mem;
 }
 
 #define PCL_INSTANTIATE_ISSKeypoint3D(T,U,N) template class PCL_EXPORTS pcl::ISSKeypoint3D<T,U,N>;
@@ -164,11 +164,12 @@ pcl::SIFTKeypoint<PointInT, PointOutT>::detectKeypointsForOctave (
     scales[i_scale] = base_scale * powf (2.0f, (1.0f * static_cast<float> (i_scale) - 1.0f) / static_cast<float> (nr_scales_per_octave));
   }
   Eigen::MatrixXf diff_of_gauss;
-  computeScaleSpace (input, tree, scales, diff_of_gauss);
+  std::vector<int> nearest_neighbors;
+  computeScaleSpace (input, tree, scales, diff_of_gauss, nearest_neighbors);
 
   // Find extrema in the DoG scale space
   std::vector<int> extrema_indices, extrema_scales;
-  findScaleSpaceExtrema (input, tree, diff_of_gauss, extrema_indices, extrema_scales);
+  findScaleSpaceExtrema (input, tree, diff_of_gauss, nearest_neighbors, extrema_indices, extrema_scales);
 
   output.points.reserve (output.size () + extrema_indices.size ());
   // Save scale?
@@ -208,13 +209,20 @@ pcl::SIFTKeypoint<PointInT, PointOutT>::detectKeypointsForOctave (
 template <typename PointInT, typename PointOutT> 
 void pcl::SIFTKeypoint<PointInT, PointOutT>::computeScaleSpace (
     const PointCloudIn &input, KdTree &tree, const std::vector<float> &scales, 
-    Eigen::MatrixXf &diff_of_gauss)
+    Eigen::MatrixXf &diff_of_gauss, std::vector<int> &nearest_neighbors)
 {
   diff_of_gauss.resize (input.size (), scales.size () - 1);
+  nearest_neighbors.assign (input.size () * nearest_neighbors_k_, -1);
 
   // For efficiency, we will only filter over points within 3 standard deviations 
   const float max_radius = 3.0f * scales.back ();
 
+#pragma omp parallel for \
+  default(none) \
+  shared(input, tree, scales, diff_of_gauss, nearest_neighbors) \
+  firstprivate(max_radius) \
+  schedule(dynamic, 64) \
+  num_threads(threads_)
   for (int i_point = 0; i_point < static_cast<int> (input.size ()); ++i_point)
   {
     std::vector<int> nn_indices;
@@ -224,6 +232,12 @@ void pcl::SIFTKeypoint<PointInT, PointOutT>::computeScaleSpace (
     //   regardless of the configurable search method specified by the user, so we directly employ tree.radiusSearch 
     //   here instead of using searchForNeighbors.
 
+    // The neighbors are sorted by distance, so whenever there are enough of them the first ones are the
+    // neighborhood findScaleSpaceExtrema needs and it does not have to search again
+    if (nn_indices.size () >= static_cast<std::size_t> (nearest_neighbors_k_))
+      std::copy (nn_indices.begin (), nn_indices.begin () + nearest_neighbors_k_,
+                 nearest_neighbors.begin () + static_cast<std::size_t> (i_point) * nearest_neighbors_k_);
+
     // For each scale, compute the Gaussian "filter response" at the current point
     float filter_response = 0.0f;
     for (std::size_t i_scale = 0; i_scale < scales.size (); ++i_scale)
@@ -258,22 +272,37 @@ void pcl::SIFTKeypoint<PointInT, PointOutT>::computeScaleSpace (
 template <typename PointInT, typename PointOutT> void 
 pcl::SIFTKeypoint<PointInT, PointOutT>::findScaleSpaceExtrema (
     const PointCloudIn &input, KdTree &tree, const Eigen::MatrixXf &diff_of_gauss, 
+    const std::vector<int> &nearest_neighbors,
     std::vector<int> &extrema_indices, std::vector<int> &extrema_scales)
 {
-  const int k = 25;
-  std::vector<int> nn_indices (k);
-  std::vector<float> nn_dist (k);
-
+  const int nr_points = static_cast<int> (input.size ());
   const int nr_scales = static_cast<int> (diff_of_gauss.cols ());
-  std::vector<float> min_val (nr_scales), max_val (nr_scales);
-
-  for (int i_point = 0; i_point < static_cast<int> (input.size ()); ++i_point)
+  // Extrema are flagged per point and scale and collected afterwards, keeping them ordered by point index
+  std::vector<std::uint8_t> is_extremum (static_cast<std::size_t> (nr_points) * nr_scales, 0);
+
+#pragma omp parallel for \
+  default(none) \
+  shared(tree, diff_of_gauss, nearest_neighbors, is_extremum) \
+  firstprivate(nr_points, nr_scales) \
+  schedule(dynamic, 64) \
+  num_threads(threads_)
+  for (int i_point = 0; i_point < nr_points; ++i_point)
   {
+    std::vector<float> min_val (nr_scales), max_val (nr_scales);
+
     // Define the local neighborhood around the current point
-    const std::size_t nr_nn = tree.nearestKSearch (i_point, k, nn_indices, nn_dist); //*
-    // * note: the neighborhood for finding local extrema is best defined as a small fixed-k neighborhood, regardless of
-    //   the configurable search method specified by the user, so we directly employ tree.nearestKSearch here instead 
-    //   of using searchForNeighbors
+    std::vector<int> nn_indices;
+    std::vector<float> nn_dist;
+    const int* neighbors = &nearest_neighbors[static_cast<std::size_t> (i_point) * nearest_neighbors_k_];
+    std::size_t nr_nn = nearest_neighbors_k_;
+    if (neighbors[0] == -1)
+    {
+      nr_nn = tree.nearestKSearch (i_point, nearest_neighbors_k_, nn_indices, nn_dist); //*
+      // * note: the neighborhood for finding local extrema is best defined as a small fixed-k neighborhood, regardless
+      //   of the configurable search method specified by the user, so we directly employ tree.nearestKSearch here
+      //   instead of using searchForNeighbors
+      neighbors = nn_indices.data ();
+    }
 
     // At each scale, find the extreme values of the DoG within the current neighborhood
     for (int i_scale = 0; i_scale < nr_scales; ++i_scale)
@@ -283,7 +312,7 @@ pcl::SIFTKeypoint<PointInT, PointOutT>::findScaleSpaceExtrema (
 
       for (std::size_t i_neighbor = 0; i_neighbor < nr_nn; ++i_neighbor)
       {
-        const float &d = diff_of_gauss (nn_indices[i_neighbor], i_scale);
+        const float &d = diff_of_gauss (neighbors[i_neighbor], i_scale);
 
         min_val[i_scale] = (std::min) (min_val[i_scale], d);
         max_val[i_scale] = (std::max) (max_val[i_scale], d);
@@ -303,20 +332,30 @@ pcl::SIFTKeypoint<PointInT, PointOutT>::findScaleSpaceExtrema (
             (val <  min_val[i_scale - 1]) && 
             (val <  min_val[i_scale + 1]))
         {
-          extrema_indices.push_back (i_point);
-          extrema_scales.push_back (i_scale);
+          is_extremum[static_cast<std::size_t> (i_point) * nr_scales + i_scale] = 1;
         }
         // Is it a local maximum?
         else if ((val == max_val[i_scale]) && 
                  (val >  max_val[i_scale - 1]) && 
                  (val >  max_val[i_scale + 1]))
         {
-          extrema_indices.push_back (i_point);
-          extrema_scales.push_back (i_scale);
+          is_extremum[static_cast<std::size_t> (i_point) * nr_scales + i_scale] = 1;
         }
       }
     }
   }
+
+  for (int i_point = 0; i_point < nr_points; ++i_point)
+  {
+    for (int i_scale = 1; i_scale < nr_scales - 1; ++i_scale)
+    {
+      if (is_extremum[static_cast<std::size_t> (i_point) * nr_scales + i_scale])
+      {
+        extrema_indices.push_back (i_point);
+        extrema_scales.push_back (i_scale);
+      }
+    }
+  }
 }
 
 #define PCL_INSTANTIATE_SIFTKeypoint(T,U) template class PCL_EXPORTS pcl::SIFTKeypoint<T,U>;
@@ -217,6 +217,16 @@ namespace pcl
       void
       getScatterMatrix (const int &current_index, Eigen::Matrix3d &cov_m);
 
+      /** \brief Compute the scatter matrix for a point index and return the salient neighborhood it was built from.
+        * \param[in] current_index the index of the point
+        * \param[out] cov_m the point scatter matrix
+        * \param[out] nn_indices the indices of the neighbors within the salient radius
+        * \param[out] nn_distances the squared distances of the neighbors within the salient radius
+        */
+      void
+      getScatterMatrix (const int &current_index, Eigen::Matrix3d &cov_m,
+                        std::vector<int> &nn_indices, std::vector<float> &nn_distances);
+
       /** \brief Perform the initial checks before computing the keypoints.
        *  \return true if all the checks are passed, false otherwise
         */
@@ -109,7 +109,7 @@ namespace pcl
 
       /** \brief Empty constructor. */
       SIFTKeypoint () : min_scale_ (0.0), nr_octaves_ (0), nr_scales_per_octave_ (0), 
-        min_contrast_ (-std::numeric_limits<float>::max ()), scale_idx_ (-1), 
+        min_contrast_ (-std::numeric_limits<float>::max ()), threads_ (0), scale_idx_ (-1), 
         getFieldValue_ ()
       {
         name_ = "SIFTKeypoint";
@@ -129,6 +129,12 @@ namespace pcl
       void 
       setMinimumContrast (float min_contrast);
 
+      /** \brief Initialize the scheduler and set the number of threads to use.
+        * \param nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      inline void
+      setNumberOfThreads (unsigned int nr_threads = 0) { threads_ = nr_threads; }
+
     protected:
       bool
       initCompute () override;
@@ -158,22 +164,27 @@ namespace pcl
         * \param tree a k-D tree of the points in \a input
         * \param scales a vector containing the scales over which to compute the DoG scale space
         * \param diff_of_gauss the resultant DoG scale space (in a number-of-points by number-of-scales matrix)
+        * \param nearest_neighbors the resultant nearest_neighbors_k_ nearest neighbors of each point, taken from the
+        * sorted radius search of the largest scale (-1 for the first entry of a point whose neighborhood was too small)
         */
       void 
       computeScaleSpace (const PointCloudIn &input, KdTree &tree, 
                          const std::vector<float> &scales, 
-                         Eigen::MatrixXf &diff_of_gauss);
+                         Eigen::MatrixXf &diff_of_gauss,
+                         std::vector<int> &nearest_neighbors);
 
       /** \brief Find the local minima and maxima in the provided difference-of-Gaussian (DoG) scale space
         * \param input the input point cloud 
         * \param tree a k-D tree of the points in \a input
         * \param diff_of_gauss the DoG scale space (in a number-of-points by number-of-scales matrix)
+        * \param nearest_neighbors the nearest neighbors of each point as computed by computeScaleSpace
         * \param extrema_indices the resultant vector containing the point indices of each keypoint
         * \param extrema_scales the resultant vector containing the scale indices of each keypoint
         */
       void 
       findScaleSpaceExtrema (const PointCloudIn &input, KdTree &tree, 
                              const Eigen::MatrixXf &diff_of_gauss,
+                             const std::vector<int> &nearest_neighbors,
                              std::vector<int> &extrema_indices, std::vector<int> &extrema_scales);
 
 
@@ -189,6 +200,12 @@ namespace pcl
       /** \brief The minimum contrast required for detection.*/
       float min_contrast_;
 
+      /** \brief The number of threads the scheduler should use. */
+      unsigned int threads_;
+
+      /** \brief The size of the neighborhood in which DoG extrema are searched for. */
+      static constexpr int nearest_neighbors_k_ = 25;
+
       /** \brief Set to a value different than -1 if the output cloud has a "scale" field and we have to save 
         * the keypoints scales. */
       int scale_idx_;
@@ -726,16 +726,25 @@ NarfKeypoint::calculateInterestPoints ()
   is_interest_point_image_.resize (size, false);
   
   using RealForPolynomial = double;
-  PolynomialCalculationsT<RealForPolynomial> polynomial_calculations;
-  BivariatePolynomialT<RealForPolynomial> polynomial (2);
-  std::vector<Eigen::Matrix<RealForPolynomial, 3, 1>, Eigen::aligned_allocator<Eigen::Matrix<RealForPolynomial, 3, 1> > > sample_points;
-  std::vector<RealForPolynomial> x_values, y_values;
-  std::vector<int> types;
-  std::vector<bool> invalid_beams, old_invalid_beams;
   
-  pcl::PointCloud<InterestPoint>::VectorType tmp_interest_points;
+  // Candidates are searched row by row in parallel and concatenated in row order,
+  // so that the result does not depend on the number of threads
+  std::vector<pcl::PointCloud<InterestPoint>::VectorType> row_interest_points (height);
+#pragma omp parallel for \
+  default(none) \
+  shared(border_descriptions, height, max_distance_squared, range_image, row_interest_points, width) \
+  schedule(dynamic, 1) \
+  num_threads(parameters_.max_no_of_threads)
   for (int y=0; y<height; ++y)
   {
+    PolynomialCalculationsT<RealForPolynomial> polynomial_calculations;
+    BivariatePolynomialT<RealForPolynomial> polynomial (2);
+    std::vector<Eigen::Matrix<RealForPolynomial, 3, 1>, Eigen::aligned_allocator<Eigen::Matrix<RealForPolynomial, 3, 1> > > sample_points;
+    std::vector<RealForPolynomial> x_values, y_values;
+    std::vector<int> types;
+    std::vector<bool> invalid_beams, old_invalid_beams;
+    pcl::PointCloud<InterestPoint>::VectorType& tmp_interest_points = row_interest_points[y];
+    
     for (int x=0; x<width; ++x)
     {
       int index = y*width + x;
@@ -837,6 +846,10 @@ NarfKeypoint::calculateInterestPoints ()
     }
   }
   
+  pcl::PointCloud<InterestPoint>::VectorType tmp_interest_points;
+  for (const auto& row_points : row_interest_points)
+    tmp_interest_points.insert (tmp_interest_points.end (), row_points.begin (), row_points.end ());
+  
   std::sort (tmp_interest_points.begin (), tmp_interest_points.end (), isBetterInterestPoint);
   
   float min_distance_squared = powf (parameters_.min_distance_between_interest_points*parameters_.support_size, 2);
@@ -53,6 +53,14 @@ public:
   /** Deconstructor for DenseCrf class. */
   ~DenseCrf();
 
+  /** Set the number of threads used by the inference.
+   *
+   * \param[in] nr_threads the number of threads to use (0 sets the value back to
+   *            automatic)
+   */
+  void
+  setNumberOfThreads(unsigned int nr_threads = 0);
+
   /** Set the input data vector.
    *
    *  The input data vector holds the measurements coordinates as ijk of the voxel grid.
@@ -157,6 +165,9 @@ protected:
   /** Input types */
   bool xyz_, rgb_, normal_;
 
+  /** Number of threads, 0 for automatic */
+  unsigned int threads_;
+
 public:
   PCL_MAKE_ALIGNED_OPERATOR_NEW
 };
@@ -61,6 +61,18 @@ public:
   /** Destructor. */
   virtual ~DecisionForestEvaluator();
 
+  /** Sets the number of threads used to evaluate the examples, each tree is
+   *  applied to the examples in parallel.
+   *
+   * \param[in] nr_threads the number of threads to use (0 sets the value back to
+   *            automatic)
+   */
+  inline void
+  setNumberOfThreads(unsigned int nr_threads = 0)
+  {
+    tree_evaluator_.setNumberOfThreads(nr_threads);
+  }
+
   /** Evaluates the specified examples using the supplied forest.
    *
    * \param[in] DecisionForestEvaluator the decision forest
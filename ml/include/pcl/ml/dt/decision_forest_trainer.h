@@ -202,6 +202,17 @@ public:
     decision_tree_trainer_.setRandomFeaturesAtSplitNode(b);
   }
 
+  /** Sets the number of threads used to train the trees.
+   *
+   * \param[in] nr_threads the number of threads to use (0 sets the value back to
+   *            automatic)
+   */
+  void
+  setNumberOfThreads(unsigned int nr_threads = 0)
+  {
+    decision_tree_trainer_.setNumberOfThreads(nr_threads);
+  }
+
   /** Trains a decision forest using the set training data and settings.
    *
    * \param[out] forest destination for the trained forest
@@ -61,6 +61,17 @@ public:
   /** Destructor. */
   virtual ~DecisionTreeEvaluator();
 
+  /** Sets the number of threads used to evaluate the examples.
+   *
+   * \param[in] nr_threads the number of threads to use (0 sets the value back to
+   *            automatic)
+   */
+  inline void
+  setNumberOfThreads(unsigned int nr_threads = 0)
+  {
+    threads_ = nr_threads;
+  }
+
   /** Evaluates the specified examples using the supplied tree.
    *
    * \param[in] tree the decision tree
@@ -137,6 +148,10 @@ public:
       DataSet& data_set,
       std::vector<ExampleIndex>& examples,
       std::vector<NodeType*>& nodes);
+
+private:
+  /** The number of threads, 0 for automatic. */
+  unsigned int threads_;
 };
 
 } // namespace pcl
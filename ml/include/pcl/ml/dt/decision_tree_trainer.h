@@ -191,6 +191,18 @@ public:
     random_features_at_split_node_ = b;
   }
 
+  /** Sets the number of threads used to evaluate the candidate features of a
+   *  node and to train several trees at once.
+   *
+   * \param[in] nr_threads the number of threads to use (0 sets the value back to
+   *            automatic)
+   */
+  inline void
+  setNumberOfThreads(unsigned int nr_threads = 0)
+  {
+    threads_ = nr_threads;
+  }
+
   /** Trains a decision tree using the set training data and settings.
    *
    * \param[out] tree destination for the trained tree
@@ -198,6 +210,18 @@ public:
   void
   train(DecisionTree<NodeType>& tree);
 
+  /** Trains several decision trees using the set training data and settings.
+   *
+   * If no data provider is set and the features are drawn once per tree, the
+   * features of all trees are drawn up front, in the same order as repeated calls
+   * to train(tree) would draw them, and the trees are grown in parallel. Otherwise
+   * the trees are trained one after the other.
+   *
+   * \param[out] trees destination for the trained trees, one per element
+   */
+  void
+  train(std::vector<DecisionTree<NodeType>>& trees);
+
 protected:
   /** Trains a decision tree node from the specified features, label data, and
    *  examples.
@@ -262,6 +286,8 @@ private:
   /** If true, random features are generated at each node, otherwise, at start of
    *  training the tree */
   bool random_features_at_split_node_;
+  /** The number of threads, 0 for automatic. */
+  unsigned int threads_;
 };
 
 } // namespace pcl
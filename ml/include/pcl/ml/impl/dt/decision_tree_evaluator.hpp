@@ -38,6 +38,7 @@
 #pragma once
 
 #include <pcl/common/common.h>
+#include <pcl/common/utils.h> // for getNumberOfThreads
 #include <pcl/ml/dt/decision_tree.h>
 #include <pcl/ml/feature_handler.h>
 #include <pcl/ml/stats_estimator.h>
@@ -53,6 +54,7 @@ template <class FeatureType,
           class NodeType>
 DecisionTreeEvaluator<FeatureType, DataSet, LabelType, ExampleIndex, NodeType>::
     DecisionTreeEvaluator()
+: threads_(0)
 {}
 
 template <class FeatureType,
@@ -79,8 +81,16 @@ DecisionTreeEvaluator<FeatureType, DataSet, LabelType, ExampleIndex, NodeType>::
              std::vector<ExampleIndex>& examples,
              std::vector<LabelType>& label_data)
 {
-  const std::size_t num_of_examples = examples.size();
+  int num_of_examples = static_cast<int>(examples.size());
   label_data.resize(num_of_examples);
+
+  // clang-format off
+#pragma omp parallel for \
+  default(none) \
+  shared(data_set, examples, feature_handler, label_data, num_of_examples, stats_estimator, tree) \
+  schedule(dynamic, 64) \
+  num_threads(pcl::utils::getNumberOfThreads(threads_))
+  // clang-format on
   for (int example_index = 0; example_index < num_of_examples; ++example_index) {
     NodeType* node = &(tree.getRoot());
 
@@ -117,7 +127,15 @@ DecisionTreeEvaluator<FeatureType, DataSet, LabelType, ExampleIndex, NodeType>::
         std::vector<ExampleIndex>& examples,
         std::vector<LabelType>& label_data)
 {
-  const std::size_t num_of_examples = examples.size();
+  int num_of_examples = static_cast<int>(examples.size());
+
+  // clang-format off
+#pragma omp parallel for \
+  default(none) \
+  shared(data_set, examples, feature_handler, label_data, num_of_examples, stats_estimator, tree) \
+  schedule(dynamic, 64) \
+  num_threads(pcl::utils::getNumberOfThreads(threads_))
+  // clang-format on
   for (int example_index = 0; example_index < num_of_examples; ++example_index) {
     NodeType* node = &(tree.getRoot());
 
@@ -37,6 +37,8 @@
 
 #pragma once
 
+#include <pcl/common/utils.h> // for getNumberOfThreads
+
 namespace pcl {
 
 template <class FeatureType,
@@ -56,6 +58,7 @@ DecisionTreeTrainer<FeatureType, DataSet, LabelType, ExampleIndex, NodeType>::
 , examples_()
 , decision_tree_trainer_data_provider_()
 , random_features_at_split_node_(false)
+, threads_(0)
 {}
 
 template <class FeatureType,
@@ -103,6 +106,49 @@ DecisionTreeTrainer<FeatureType, DataSet, LabelType, ExampleIndex, NodeType>::tr
   }
 }
 
+template <class FeatureType,
+          class DataSet,
+          class LabelType,
+          class ExampleIndex,
+          class NodeType>
+void
+DecisionTreeTrainer<FeatureType, DataSet, LabelType, ExampleIndex, NodeType>::train(
+    std::vector<pcl::DecisionTree<NodeType>>& trees)
+{
+  int num_of_trees = static_cast<int>(trees.size());
+
+  // the data provider and the features drawn at each split node are shared by all
+  // trees, and with fewer trees than threads the nodes are better split in parallel
+  if (decision_tree_trainer_data_provider_ || random_features_at_split_node_ ||
+      num_of_trees < static_cast<int>(pcl::utils::getNumberOfThreads(threads_))) {
+    for (auto& tree : trees)
+      train(tree);
+    return;
+  }
+
+  std::vector<std::vector<FeatureType>> features(num_of_trees);
+  for (auto& tree_features : features)
+    feature_handler_->createRandomFeatures(num_of_features_, tree_features);
+
+  // the nodes of each tree are split serially within this region
+  // clang-format off
+#pragma omp parallel for \
+  default(none) \
+  shared(features, num_of_trees, trees) \
+  schedule(dynamic, 1) \
+  num_threads(pcl::utils::getNumberOfThreads(threads_))
+  // clang-format on
+  for (int tree_index = 0; tree_index < num_of_trees; ++tree_index) {
+    NodeType root_node;
+    trees[tree_index].setRoot(root_node);
+    trainDecisionTreeNode(features[tree_index],
+                          examples_,
+                          label_data_,
+                          max_tree_depth_,
+                          trees[tree_index].getRoot());
+  }
+}
+
 template <class FeatureType,
           class DataSet,
           class LabelType,
@@ -116,7 +162,7 @@ DecisionTreeTrainer<FeatureType, DataSet, LabelType, ExampleIndex, NodeType>::
                           const std::size_t max_depth,
                           NodeType& node)
 {
-  const std::size_t num_of_examples = examples.size();
+  std::size_t num_of_examples = examples.size();
   if (num_of_examples == 0) {
     PCL_ERROR(
         "Reached invalid point in decision tree training: Number of examples is 0!");
@@ -138,67 +184,78 @@ DecisionTreeTrainer<FeatureType, DataSet, LabelType, ExampleIndex, NodeType>::
     feature_handler_->createRandomFeatures(num_of_features_, features);
   }
 
-  std::vector<float> feature_results;
-  std::vector<unsigned char> flags;
+  std::vector<float> feature_results(num_of_examples);
+  std::vector<unsigned char> flags(num_of_examples);
 
-  feature_results.reserve(num_of_examples);
-  flags.reserve(num_of_examples);
-
-  // find best feature for split
-  int best_feature_index = -1;
-  float best_feature_threshold = 0.0f;
-  float best_feature_information_gain = 0.0f;
+  // find the best threshold of each feature, the features are evaluated in parallel
+  int num_of_features = static_cast<int>(features.size());
+  std::vector<float> feature_information_gains(num_of_features, 0.0f);
+  std::vector<float> feature_thresholds(num_of_features, 0.0f);
 
-  const std::size_t num_of_features = features.size();
-  for (std::size_t feature_index = 0; feature_index < num_of_features;
-       ++feature_index) {
-    // evaluate features
-    feature_handler_->evaluateFeature(
-        features[feature_index], data_set_, examples, feature_results, flags);
+  // clang-format off
+#pragma omp parallel \
+  default(none) \
+  shared(examples, feature_information_gains, feature_thresholds, features, label_data, num_of_examples, num_of_features) \
+  num_threads(pcl::utils::getNumberOfThreads(threads_))
+  // clang-format on
+  {
+    std::vector<float> thread_feature_results(num_of_examples);
+    std::vector<unsigned char> thread_flags(num_of_examples);
+    std::vector<float> uniform_thresholds;
+    uniform_thresholds.reserve(num_of_thresholds_);
+
+#pragma omp for schedule(dynamic)
+    for (int feature_index = 0; feature_index < num_of_features; ++feature_index) {
+      // evaluate features
+      feature_handler_->evaluateFeature(features[feature_index],
+                                        data_set_,
+                                        examples,
+                                        thread_feature_results,
+                                        thread_flags);
+
+      // get list of thresholds
+      const std::vector<float>* thresholds = &thresholds_;
+      if (thresholds_.empty()) {
+        createThresholdsUniform(
+            num_of_thresholds_, thread_feature_results, uniform_thresholds);
+        thresholds = &uniform_thresholds;
+      }
 
-    // get list of thresholds
-    if (!thresholds_.empty()) {
       // compute information gain for each threshold and store threshold with highest
       // information gain
-      for (std::size_t threshold_index = 0; threshold_index < thresholds_.size();
-           ++threshold_index) {
-
+      float best_information_gain = 0.0f;
+      float best_threshold = 0.0f;
+      for (const float threshold : *thresholds) {
         const float information_gain =
             stats_estimator_->computeInformationGain(data_set_,
                                                      examples,
                                                      label_data,
-                                                     feature_results,
-                                                     flags,
-                                                     thresholds_[threshold_index]);
-
-        if (information_gain > best_feature_information_gain) {
-          best_feature_information_gain = information_gain;
-          best_feature_index = static_cast<int>(feature_index);
-          best_feature_threshold = thresholds_[threshold_index];
+                                                     thread_feature_results,
+                                                     thread_flags,
+                                                     threshold);
+
+        if (information_gain > best_information_gain) {
+          best_information_gain = information_gain;
+          best_threshold = threshold;
         }
       }
+
+      feature_information_gains[feature_index] = best_information_gain;
+      feature_thresholds[feature_index] = best_threshold;
     }
-    else {
-      std::vector<float> thresholds;
-      thresholds.reserve(num_of_thresholds_);
-      createThresholdsUniform(num_of_thresholds_, feature_results, thresholds);
+  }
 
-      // compute information gain for each threshold and store threshold with highest
-      // information gain
-      for (std::size_t threshold_index = 0; threshold_index < num_of_thresholds_;
-           ++threshold_index) {
-        const float threshold = thresholds[threshold_index];
-
-        // compute information gain
-        const float information_gain = stats_estimator_->computeInformationGain(
-            data_set_, examples, label_data, feature_results, flags, threshold);
-
-        if (information_gain > best_feature_information_gain) {
-          best_feature_information_gain = information_gain;
-          best_feature_index = static_cast<int>(feature_index);
-          best_feature_threshold = threshold;
-        }
-      }
+  // find best feature for split, scanning in order keeps the first feature among
+  // equally good ones
+  int best_feature_index = -1;
+  float best_feature_threshold = 0.0f;
+  float best_feature_information_gain = 0.0f;
+
+  for (int feature_index = 0; feature_index < num_of_features; ++feature_index) {
+    if (feature_information_gains[feature_index] > best_feature_information_gain) {
+      best_feature_information_gain = feature_information_gains[feature_index];
+      best_feature_index = feature_index;
+      best_feature_threshold = feature_thresholds[feature_index];
     }
   }
 
@@ -86,6 +86,30 @@ public:
     num_clusters_ = k;
   };
 
+  /** Set the number of threads used to assign the points to the clusters.
+   *
+   * \param[in] nr_threads the number of threads to use (0 sets the value back to
+   *            automatic)
+   */
+  void
+  setNumberOfThreads(unsigned int nr_threads = 0)
+  {
+    threads_ = nr_threads;
+  }
+
+  /** Choose the initial centroids with k-means++ instead of partitioning the
+   *  points among the clusters in turn.
+   *
+   * \param[in] use_kmeans_plus_plus whether to use the k-means++ seeding
+   * \param[in] seed the seed of the random generator picking the centroids
+   */
+  void
+  setUseKMeansPlusPlus(bool use_kmeans_plus_plus, unsigned int seed = 0)
+  {
+    use_kmeans_plus_plus_ = use_kmeans_plus_plus;
+    seed_ = seed;
+  }
+
   /*
         void
         setClusterField (std::string field_name)
@@ -125,6 +149,10 @@ public:
   void
   initialClusterPoints();
 
+  // Initial centroids chosen with k-means++, each point going to the closest one
+  void
+  initialClusterPointsPlusPlus();
+
   void
   computeCentroids();
 
@@ -178,6 +206,15 @@ protected:
   PointsToClusters points_to_clusters_;
   Centroids centroids_;
 
+  /** The number of threads, 0 for automatic. */
+  unsigned int threads_;
+
+  /** Whether the initial centroids are chosen with k-means++. */
+  bool use_kmeans_plus_plus_;
+
+  /** The seed of the k-means++ random generator. */
+  unsigned int seed_;
+
 public:
   PCL_MAKE_ALIGNED_OPERATOR_NEW
 };
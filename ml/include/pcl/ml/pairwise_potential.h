@@ -56,6 +56,17 @@ public:
   /** Deconstructor for PairwisePotential class. */
   ~PairwisePotential(){};
 
+  /** Set the number of threads used to filter the values.
+   *
+   * \param[in] nr_threads the number of threads to use (0 sets the value back to
+   *            automatic)
+   */
+  void
+  setNumberOfThreads(unsigned int nr_threads = 0)
+  {
+    lattice_.setNumberOfThreads(nr_threads);
+  }
+
   void
   compute(std::vector<float>& out,
           const std::vector<float>& in,
@@ -81,6 +81,23 @@ public:
   void
   init(const std::vector<float>& feature, const int feature_dimension, const int N);
 
+  /** Set the number of threads used by compute.
+   *
+   * \param[in] nr_threads the number of threads to use (0 sets the value back to
+   *            automatic)
+   */
+  inline void
+  setNumberOfThreads(unsigned int nr_threads = 0)
+  {
+    threads_ = nr_threads;
+  }
+
+  /** Filter the values of the variables with the lattice: splat them onto the
+   *  lattice vertices, blur along each lattice axis and slice them back.
+   *
+   * The lattice buffers are kept between calls, so compute must not be called
+   * concurrently on the same lattice.
+   */
   void
   compute(std::vector<float>& out,
           const std::vector<float>& in,
@@ -139,6 +156,19 @@ public:
   float* barycentricOLD_;
   std::vector<float> baryOLD_;
 
+  /// For each lattice vertex, the range of splat_points_ and splat_weights_ holding
+  /// the variables splatted onto it, in increasing order
+  std::vector<int> splat_offsets_;
+  std::vector<int> splat_points_;
+  std::vector<float> splat_weights_;
+
+  /// Lattice values reused by compute
+  mutable std::vector<float> values_;
+  mutable std::vector<float> new_values_;
+
+  /// Number of threads used by compute, 0 for automatic
+  unsigned int threads_;
+
 public:
   PCL_MAKE_ALIGNED_OPERATOR_NEW
 };
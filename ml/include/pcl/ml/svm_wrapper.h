@@ -388,14 +388,21 @@ protected:
   bool model_extern_copied_; // Set to 0 if the model is loaded from an extern file.
   bool predict_probability_; // Set to 1 to predict probabilities.
   std::vector<std::vector<double>> prediction_; // It stores the resulting prediction.
+  unsigned int threads_; // The number of threads, 0 for automatic.
 
   /** It scales the input dataset using the model information. */
   void
   scaleProblem(svm_problem& input, svm_scaling scaling);
 
+  /** It predicts the n samples of x in parallel, storing the result of each one in
+   *  prediction_. */
+  void
+  predictSamples(svm_node** x, int n);
+
 public:
   /** Constructor. */
-  SVMClassify() : model_extern_copied_(false), predict_probability_(false)
+  SVMClassify()
+  : model_extern_copied_(false), predict_probability_(false), threads_(0)
   {
     class_name_ = "SvmClassify";
   }
@@ -542,6 +549,26 @@ public:
   std::vector<double>
   classification(SVMData in);
 
+  /** Start the classification on several sets at once, classified in parallel.
+   *
+   *  To get the classification result, use getClassificationResult().
+   *
+   * \return false if fails
+   */
+  bool
+  classification(const std::vector<SVMData>& in);
+
+  /** Set the number of threads used to classify a dataset.
+   *
+   * \param[in] nr_threads the number of threads to use (0 sets the value back to
+   *            automatic)
+   */
+  void
+  setNumberOfThreads(unsigned int nr_threads = 0)
+  {
+    threads_ = nr_threads;
+  }
+
   /** Save the raw classification problem in a file (in svmlight format).
    *
    * \return false if fails
@@ -37,10 +37,11 @@
  *
  */
 
+#include <pcl/common/utils.h> // for getNumberOfThreads
 #include <pcl/ml/densecrf.h>
 
 pcl::DenseCrf::DenseCrf(int N, int m)
-: N_(N), M_(m), xyz_(false), rgb_(false), normal_(false)
+: N_(N), M_(m), xyz_(false), rgb_(false), normal_(false), threads_(0)
 {
   current_.resize(N_ * M_, 0.0f);
   next_.resize(N_ * M_, 0.0f);
@@ -53,6 +54,14 @@ pcl::DenseCrf::~DenseCrf()
     delete p;
 }
 
+void
+pcl::DenseCrf::setNumberOfThreads(unsigned int nr_threads)
+{
+  threads_ = nr_threads;
+  for (auto& p : pairwise_potential_)
+    p->setNumberOfThreads(threads_);
+}
+
 void
 pcl::DenseCrf::setDataVector(
     const std::vector<Eigen::Vector3i, Eigen::aligned_allocator<Eigen::Vector3i>> data)
@@ -80,8 +89,9 @@ pcl::DenseCrf::addPairwiseEnergy(const std::vector<float>& feature,
                                  const int feature_dimension,
                                  const float w)
 {
-  pairwise_potential_.push_back(
-      new PairwisePotential(feature, feature_dimension, N_, w));
+  auto* potential = new PairwisePotential(feature, feature_dimension, N_, w);
+  potential->setNumberOfThreads(threads_);
+  pairwise_potential_.push_back(potential);
 }
 
 void
@@ -237,29 +247,38 @@ pcl::DenseCrf::expAndNormalize(std::vector<float>& out,
                                float scale,
                                float relax) const
 {
-  std::vector<float> V(N_ + 10);
-  for (int i = 0; i < N_; i++) {
-    int b_idx = i * M_;
-    // Find the max and subtract it so that the std::exp doesn't explode
-    float mx = scale * in[b_idx];
-    for (int j = 1; j < M_; j++)
-      if (mx < scale * in[b_idx + j])
-        mx = scale * in[b_idx + j];
-    float tt = 0;
-    for (int j = 0; j < M_; j++) {
-      V[j] = std::exp(scale * in[b_idx + j] - mx);
-      tt += V[j];
+  // clang-format off
+#pragma omp parallel \
+  default(none) \
+  shared(in, out, relax, scale) \
+  num_threads(pcl::utils::getNumberOfThreads(threads_))
+  // clang-format on
+  {
+    std::vector<float> V(M_);
+#pragma omp for
+    for (int i = 0; i < N_; i++) {
+      int b_idx = i * M_;
+      // Find the max and subtract it so that the std::exp doesn't explode
+      float mx = scale * in[b_idx];
+      for (int j = 1; j < M_; j++)
+        if (mx < scale * in[b_idx + j])
+          mx = scale * in[b_idx + j];
+      float tt = 0;
+      for (int j = 0; j < M_; j++) {
+        V[j] = std::exp(scale * in[b_idx + j] - mx);
+        tt += V[j];
+      }
+      // Make it a probability
+      for (int j = 0; j < M_; j++)
+        V[j] /= tt;
+
+      int a_idx = i * M_;
+      for (int j = 0; j < M_; j++)
+        if (relax == 1)
+          out[a_idx + j] = V[j];
+        else
+          out[a_idx + j] = (1 - relax) * out[a_idx + j] + relax * V[j];
     }
-    // Make it a probability
-    for (int j = 0; j < M_; j++)
-      V[j] /= tt;
-
-    int a_idx = i * M_;
-    for (int j = 0; j < M_; j++)
-      if (relax == 1)
-        out[a_idx + j] = V[j];
-      else
-        out[a_idx + j] = (1 - relax) * out[a_idx + j] + relax * V[j];
   }
 }
 
@@ -47,13 +47,73 @@
 PCL_INSTANTIATE(Kmeans, PCL_POINT_TYPES);
 */
 
+#include <pcl/common/utils.h> // for getNumberOfThreads
 #include <pcl/ml/kmeans.h>
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+#include <algorithm> // for fill
+#include <limits>    // for numeric_limits
+#include <random>    // for mt19937
+
+namespace {
+/** Squared distance between the n dimensional points x and y. */
+inline float
+squaredDistance(const float* x, const float* y, const unsigned int n)
+{
+  unsigned int i = 0;
+  float total = 0.0f;
+#if defined(__AVX2__)
+  __m256 sum8 = _mm256_setzero_ps();
+  for (; i + 8 <= n; i += 8) {
+    const __m256 diff = _mm256_sub_ps(_mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i));
+    sum8 = _mm256_add_ps(sum8, _mm256_mul_ps(diff, diff));
+  }
+  __m128 sum4 =
+      _mm_add_ps(_mm256_castps256_ps128(sum8), _mm256_extractf128_ps(sum8, 1));
+  sum4 = _mm_add_ps(sum4, _mm_movehl_ps(sum4, sum4));
+  sum4 = _mm_add_ss(sum4, _mm_shuffle_ps(sum4, sum4, 1));
+  total = _mm_cvtss_f32(sum4);
+#elif defined(__SSE2__)
+  __m128 sum4 = _mm_setzero_ps();
+  for (; i + 4 <= n; i += 4) {
+    const __m128 diff = _mm_sub_ps(_mm_loadu_ps(x + i), _mm_loadu_ps(y + i));
+    sum4 = _mm_add_ps(sum4, _mm_mul_ps(diff, diff));
+  }
+  sum4 = _mm_add_ps(sum4, _mm_movehl_ps(sum4, sum4));
+  sum4 = _mm_add_ss(sum4, _mm_shuffle_ps(sum4, sum4, 1));
+  total = _mm_cvtss_f32(sum4);
+#elif defined(__ARM_NEON)
+  float32x4_t sum4 = vdupq_n_f32(0.0f);
+  for (; i + 4 <= n; i += 4) {
+    const float32x4_t diff = vsubq_f32(vld1q_f32(x + i), vld1q_f32(y + i));
+    sum4 = vmlaq_f32(sum4, diff, diff);
+  }
+  float32x2_t sum2 = vadd_f32(vget_low_f32(sum4), vget_high_f32(sum4));
+  total = vget_lane_f32(vpadd_f32(sum2, sum2), 0);
+#endif
+  for (; i < n; i++) {
+    const float diff = x[i] - y[i];
+    total += diff * diff;
+  }
+  return total;
+}
+} // namespace
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 pcl::Kmeans::Kmeans(unsigned int num_points, unsigned int num_dimensions)
 : num_points_(num_points)
 , num_dimensions_(num_dimensions)
 , points_to_clusters_(num_points_, 0)
+, threads_(0)
+, use_kmeans_plus_plus_(false)
+, seed_(0)
 // data_ (num_points_, Point (num_dimensions_))
 {}
 
@@ -64,18 +124,10 @@ pcl::Kmeans::~Kmeans() {}
 void
 pcl::Kmeans::initialClusterPoints()
 {
-  for (ClusterId i = 0; i < num_clusters_; i++) {
-    Point point; // each centroid is a point
-    for (unsigned int dim = 0; dim < num_dimensions_; dim++)
-      point.push_back(0.0);
-    SetPoints set_of_points;
-
-    // init centroids
-    centroids_.push_back(point);
-
-    // init clusterId -> set of points
-    clusters_to_points_.push_back(set_of_points);
-  }
+  // each centroid is a point
+  centroids_.assign(num_clusters_, Point(num_dimensions_, 0.0f));
+  // init clusterId -> set of points
+  clusters_to_points_.assign(num_clusters_, SetPoints());
 
   ClusterId cid;
 
@@ -88,31 +140,88 @@ pcl::Kmeans::initialClusterPoints()
   }
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::Kmeans::initialClusterPointsPlusPlus()
+{
+  centroids_.assign(num_clusters_, Point(num_dimensions_, 0.0f));
+  clusters_to_points_.assign(num_clusters_, SetPoints());
+
+  std::mt19937 rng(seed_);
+  std::uniform_int_distribution<PointId> pick_point(0, num_points_ - 1);
+
+  // squared distance of each point to its closest centroid so far
+  std::vector<float> min_distances(num_points_, std::numeric_limits<float>::max());
+  int num_points = static_cast<int>(num_points_);
+
+  PointId next_pid = pick_point(rng);
+  for (ClusterId cid = 0; cid < num_clusters_; cid++) {
+    centroids_[cid] = data_[next_pid];
+    const float* centroid = centroids_[cid].data();
+
+    // clang-format off
+#pragma omp parallel for \
+  default(none) \
+  shared(centroid, cid, min_distances, num_points) \
+  num_threads(pcl::utils::getNumberOfThreads(threads_))
+    // clang-format on
+    for (int pid = 0; pid < num_points; pid++) {
+      const float d = squaredDistance(data_[pid].data(), centroid, num_dimensions_);
+      if (d < min_distances[pid]) {
+        min_distances[pid] = d;
+        points_to_clusters_[pid] = cid;
+      }
+    }
+
+    // pick the next centroid with a probability proportional to the squared distance
+    double total = 0.0;
+    for (const float d : min_distances)
+      total += d;
+
+    if (total > 0.0) {
+      double r = std::uniform_real_distribution<double>(0.0, total)(rng);
+      for (next_pid = 0; next_pid + 1 < num_points_; next_pid++) {
+        r -= min_distances[next_pid];
+        if (r < 0.0)
+          break;
+      }
+    }
+    else
+      next_pid = pick_point(rng);
+  }
+
+  for (PointId pid = 0; pid < num_points_; pid++)
+    clusters_to_points_[points_to_clusters_[pid]].insert(pid);
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 void
 pcl::Kmeans::computeCentroids()
 {
-  ClusterId cid = 0;
-  // For each centroid
-  for (Centroids::value_type& centroid : centroids_) {
-    PointId num_points_in_cluster = 0;
+  int num_clusters = static_cast<int>(centroids_.size());
+
+  // clang-format off
+#pragma omp parallel for \
+  default(none) \
+  shared(num_clusters) \
+  schedule(dynamic) \
+  num_threads(pcl::utils::getNumberOfThreads(threads_))
+  // clang-format on
+  for (int cid = 0; cid < num_clusters; cid++) {
+    Point& centroid = centroids_[cid];
+    std::fill(centroid.begin(), centroid.end(), 0.0f);
 
     // For each PointId in this set
     for (const auto& pid : clusters_to_points_[cid]) {
-      Point p = data_[pid];
-      // Point p = ps__.getPoint(pid);
+      const Point& p = data_[pid];
       for (unsigned int i = 0; i < num_dimensions_; i++)
         centroid[i] += p[i];
-      num_points_in_cluster++;
     }
     // if no point in the clusters, this goes to inf (correct!)
-    for (unsigned int i = 0; i < num_dimensions_; i++) {
-      centroid[i] /= static_cast<float>(num_points_in_cluster);
-      // std::cout << centroid[i] << " ";
-    }
-    // std::cout << std::endl;
-
-    cid++;
+    const float num_points_in_cluster =
+        static_cast<float>(clusters_to_points_[cid].size());
+    for (unsigned int i = 0; i < num_dimensions_; i++)
+      centroid[i] /= num_points_in_cluster;
   }
 }
 
@@ -121,11 +230,17 @@ void
 pcl::Kmeans::kMeans()
 {
   bool not_converged = true;
-  ClusterId cid, to_cluster;
-  float d, min;
 
   // Initial partition of points
-  initialClusterPoints();
+  if (use_kmeans_plus_plus_)
+    initialClusterPointsPlusPlus();
+  else
+    initialClusterPoints();
+
+  // the centroids stored contiguously for the distance computations
+  std::vector<float> centroids(num_clusters_ * num_dimensions_);
+  PointsToClusters to_clusters(num_points_);
+  int num_points = static_cast<int>(num_points_);
 
   // Until not converge
   while (not_converged) {
@@ -133,35 +248,47 @@ pcl::Kmeans::kMeans()
     not_converged = false;
 
     computeCentroids();
-
-    // for each point
-    for (PointId pid = 0; pid < num_points_; pid++) {
+    for (ClusterId cid = 0; cid < num_clusters_; cid++)
+      std::copy(centroids_[cid].begin(),
+                centroids_[cid].end(),
+                centroids.begin() + cid * num_dimensions_);
+
+    // the centroids are fixed during a pass, so the points are assigned
+    // independently: each one moves to the closest centroid strictly closer than
+    // its current one
+    // clang-format off
+#pragma omp parallel for \
+  default(none) \
+  shared(centroids, num_points, to_clusters) \
+  num_threads(pcl::utils::getNumberOfThreads(threads_))
+    // clang-format on
+    for (int pid = 0; pid < num_points; pid++) {
+      const float* point = data_[pid].data();
+      ClusterId to_cluster = points_to_clusters_[pid];
       // distance from current cluster
-      min = distance(centroids_[points_to_clusters_[pid]], data_[pid]);
+      float min = squaredDistance(
+          &centroids[to_cluster * num_dimensions_], point, num_dimensions_);
 
       // foreach centroid
-      cid = 0;
-      bool move = false;
-      for (const auto& c : centroids_) {
-        d = distance(c, data_[pid]);
+      for (ClusterId cid = 0; cid < num_clusters_; cid++) {
+        const float d =
+            squaredDistance(&centroids[cid * num_dimensions_], point, num_dimensions_);
         if (d < min) {
           min = d;
-          move = true;
           to_cluster = cid;
-
-          // remove from current cluster
-          clusters_to_points_[points_to_clusters_[pid]].erase(pid);
-
-          not_converged = true;
         }
-        cid++;
       }
+      to_clusters[pid] = to_cluster;
+    }
+
+    // move towards a closer centroid
+    for (PointId pid = 0; pid < num_points_; pid++) {
+      if (to_clusters[pid] != points_to_clusters_[pid]) {
+        clusters_to_points_[points_to_clusters_[pid]].erase(pid);
+        points_to_clusters_[pid] = to_clusters[pid];
+        clusters_to_points_[to_clusters[pid]].insert(pid);
 
-      // move towards a closer centroid
-      if (move) {
-        // insert
-        points_to_clusters_[pid] = to_cluster;
-        clusters_to_points_[to_cluster].insert(pid);
+        not_converged = true;
       }
     }
   } // end while
@@ -35,10 +35,81 @@
  *
  */
 
+#include <pcl/common/utils.h> // for getNumberOfThreads
 #include <pcl/ml/permutohedral.h>
 #include <pcl/pcl_macros.h> // for pcl_round
 
-#include <map> // for multimap
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+#include <algorithm> // for fill
+#include <map>       // for multimap
+
+namespace {
+/** Add w * src to dst, over n values. */
+inline void
+addScaled(float* dst, const float* src, const float w, const int n)
+{
+  int k = 0;
+#if defined(__AVX2__)
+  const __m256 w8 = _mm256_set1_ps(w);
+  for (; k + 8 <= n; k += 8)
+    _mm256_storeu_ps(dst + k,
+                     _mm256_add_ps(_mm256_loadu_ps(dst + k),
+                                   _mm256_mul_ps(w8, _mm256_loadu_ps(src + k))));
+#elif defined(__SSE2__)
+  const __m128 w4 = _mm_set1_ps(w);
+  for (; k + 4 <= n; k += 4)
+    _mm_storeu_ps(
+        dst + k,
+        _mm_add_ps(_mm_loadu_ps(dst + k), _mm_mul_ps(w4, _mm_loadu_ps(src + k))));
+#elif defined(__ARM_NEON)
+  for (; k + 4 <= n; k += 4)
+    vst1q_f32(dst + k,
+              vaddq_f32(vld1q_f32(dst + k), vmulq_n_f32(vld1q_f32(src + k), w)));
+#endif
+  for (; k < n; k++)
+    dst[k] += w * src[k];
+}
+
+/** Blur one lattice vertex: dst = val + 0.5 * (n1 + n2), over n values. */
+inline void
+blurValues(float* dst, const float* val, const float* n1, const float* n2, const int n)
+{
+  int k = 0;
+#if defined(__AVX2__)
+  const __m256 half = _mm256_set1_ps(0.5f);
+  for (; k + 8 <= n; k += 8)
+    _mm256_storeu_ps(
+        dst + k,
+        _mm256_add_ps(_mm256_loadu_ps(val + k),
+                      _mm256_mul_ps(half,
+                                    _mm256_add_ps(_mm256_loadu_ps(n1 + k),
+                                                  _mm256_loadu_ps(n2 + k)))));
+#elif defined(__SSE2__)
+  const __m128 half = _mm_set1_ps(0.5f);
+  for (; k + 4 <= n; k += 4)
+    _mm_storeu_ps(dst + k,
+                  _mm_add_ps(_mm_loadu_ps(val + k),
+                             _mm_mul_ps(half,
+                                        _mm_add_ps(_mm_loadu_ps(n1 + k),
+                                                   _mm_loadu_ps(n2 + k)))));
+#elif defined(__ARM_NEON)
+  for (; k + 4 <= n; k += 4)
+    vst1q_f32(dst + k,
+              vaddq_f32(vld1q_f32(val + k),
+                        vmulq_n_f32(vaddq_f32(vld1q_f32(n1 + k), vld1q_f32(n2 + k)),
+                                    0.5f)));
+#endif
+  for (; k < n; k++)
+    dst[k] = val[k] + 0.5f * (n1[k] + n2[k]);
+}
+} // namespace
 
 pcl::Permutohedral::Permutohedral()
 : N_(0)
@@ -47,6 +118,7 @@ pcl::Permutohedral::Permutohedral()
 , blur_neighborsOLD_(nullptr)
 , offsetOLD_(nullptr)
 , barycentricOLD_(nullptr)
+, threads_(0)
 {}
 
 void
@@ -216,6 +288,23 @@ pcl::Permutohedral::init(const std::vector<float>& feature,
   // Get the number of vertices in the lattice
   M_ = static_cast<int>(hash_table.size());
 
+  // Invert offset_, so that compute can gather the variables of each vertex
+  // instead of scattering each variable over its vertices
+  splat_offsets_.assign(M_ + 1, 0);
+  for (const float o : offset_)
+    splat_offsets_[static_cast<int>(o) + 1]++;
+  for (int i = 0; i < M_; i++)
+    splat_offsets_[i + 1] += splat_offsets_[i];
+
+  splat_points_.resize(offset_.size());
+  splat_weights_.resize(offset_.size());
+  std::vector<int> splat_fill(splat_offsets_.begin(), splat_offsets_.end() - 1);
+  for (int i = 0; i < (d_ + 1) * N_; i++) {
+    const int pos = splat_fill[static_cast<int>(offset_[i])]++;
+    splat_points_[pos] = i / (d_ + 1);
+    splat_weights_[pos] = barycentric_[i];
+  }
+
   // Create the neighborhood structure
   if (!blur_neighbors_.empty())
     blur_neighbors_.clear();
@@ -270,35 +359,61 @@ pcl::Permutohedral::compute(std::vector<float>& out,
     out_size = N_ - out_offset;
 
   // Shift all values by 1 such that -1 -> 0 (used for blurring)
-  std::vector<float> values((M_ + 2) * value_size, 0.0f);
-  std::vector<float> new_values((M_ + 2) * value_size, 0.0f);
+  values_.resize((M_ + 2) * value_size);
+  new_values_.resize((M_ + 2) * value_size);
+  std::fill(new_values_.begin(), new_values_.begin() + value_size, 0.0f);
 
   // Splatting
-  for (int i = 0; i < in_size; i++) {
-    for (int j = 0; j <= d_; j++) {
-      int o = static_cast<int>(offset_[(in_offset + i) * (d_ + 1) + j]) + 1;
-      float w = barycentric_[(in_offset + i) * (d_ + 1) + j];
-      for (int k = 0; k < value_size; k++)
-        values[o * value_size + k] += w * in[i * value_size + k];
+  if (in_offset == 0 && in_size == N_) {
+    // gather the variables of each vertex, in the same order as the scatter below
+    std::fill(values_.begin(), values_.begin() + value_size, 0.0f);
+    const float* in_values = in.data();
+    // clang-format off
+#pragma omp parallel for \
+  default(none) \
+  shared(in_values, value_size) \
+  num_threads(pcl::utils::getNumberOfThreads(threads_))
+    // clang-format on
+    for (int i = 0; i < M_; i++) {
+      float* val = &values_[(i + 1) * value_size];
+      std::fill(val, val + value_size, 0.0f);
+      for (int s = splat_offsets_[i]; s < splat_offsets_[i + 1]; s++)
+        addScaled(val,
+                  in_values + splat_points_[s] * value_size,
+                  splat_weights_[s],
+                  value_size);
+    }
+  }
+  else {
+    std::fill(values_.begin(), values_.end(), 0.0f);
+    for (int i = 0; i < in_size; i++) {
+      for (int j = 0; j <= d_; j++) {
+        int o = static_cast<int>(offset_[(in_offset + i) * (d_ + 1) + j]) + 1;
+        float w = barycentric_[(in_offset + i) * (d_ + 1) + j];
+        addScaled(&values_[o * value_size], &in[i * value_size], w, value_size);
+      }
     }
   }
 
+  // Blurring
   for (int j = 0; j <= d_; j++) {
+    // clang-format off
+#pragma omp parallel for \
+  default(none) \
+  shared(j, value_size) \
+  num_threads(pcl::utils::getNumberOfThreads(threads_))
+    // clang-format on
     for (int i = 0; i < M_; i++) {
-      int old_val_idx = (i + 1) * value_size;
-      int new_val_idx = (i + 1) * value_size;
-
       int n1 = blur_neighbors_[j * M_ + i].n1 + 1;
       int n2 = blur_neighbors_[j * M_ + i].n2 + 1;
-      int n1_val_idx = n1 * value_size;
-      int n2_val_idx = n2 * value_size;
 
-      for (int k = 0; k < value_size; k++)
-        new_values[new_val_idx + k] =
-            values[old_val_idx + k] +
-            0.5f * (values[n1_val_idx + k] + values[n2_val_idx + k]);
+      blurValues(&new_values_[(i + 1) * value_size],
+                 &values_[(i + 1) * value_size],
+                 &values_[n1 * value_size],
+                 &values_[n2 * value_size],
+                 value_size);
     }
-    values.swap(new_values);
+    values_.swap(new_values_);
   }
 
   // Alpha is a magic scaling constant (write Andrew if you really wanna understand
@@ -306,14 +421,19 @@ pcl::Permutohedral::compute(std::vector<float>& out,
   float alpha = 1.0f / (1.0f + static_cast<float>(pow(2.0f, -d_)));
 
   // Slicing
+  // clang-format off
+#pragma omp parallel for \
+  default(none) \
+  shared(alpha, out, out_offset, out_size, value_size) \
+  num_threads(pcl::utils::getNumberOfThreads(threads_))
+  // clang-format on
   for (int i = 0; i < out_size; i++) {
-    for (int k = 0; k < value_size; k++)
-      out[i * value_size + k] = 0;
+    float* out_val = &out[i * value_size];
+    std::fill(out_val, out_val + value_size, 0.0f);
     for (int j = 0; j <= d_; j++) {
       int o = static_cast<int>(offset_[(out_offset + i) * (d_ + 1) + j]) + 1;
       float w = barycentric_[(out_offset + i) * (d_ + 1) + j];
-      for (int k = 0; k < value_size; k++)
-        out[i * value_size + k] += w * values[o * value_size + k] * alpha;
+      addScaled(out_val, &values_[o * value_size], w * alpha, value_size);
     }
   }
 }
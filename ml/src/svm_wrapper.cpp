@@ -39,6 +39,7 @@
 #ifndef PCL_SVM_WRAPPER_HPP_
 #define PCL_SVM_WRAPPER_HPP_
 
+#include <pcl/common/utils.h> // for getNumberOfThreads
 #include <pcl/ml/svm_wrapper.h>
 
 #include <cassert>
@@ -573,48 +574,19 @@ pcl::SVMClassify::classificationTest()
   double sump = 0, sumt = 0, sumpp = 0, sumtt = 0, sumpt = 0;
 
   int svm_type = svm_get_svm_type(&model_);
-  int nr_class = svm_get_nr_class(&model_);
-  double* prob_estimates = nullptr;
-
-  prediction_.clear();
-
-  if (predict_probability_) {
-    if (svm_type == NU_SVR || svm_type == EPSILON_SVR)
-      PCL_WARN("[pcl::%s::classificationTest] Prob. model for test data: target value "
-               "= predicted value + z,\nz: Laplace distribution "
-               "e^(-|z|/sigma)/(2sigma),sigma=%g\n",
-               getClassName().c_str(),
-               svm_get_svr_probability(&model_));
-    else {
-      prob_estimates = static_cast<double*>(malloc(nr_class * sizeof(double)));
-    }
-  }
-
-  int ii = 0;
 
-  prediction_.resize(prob_.l);
+  if (predict_probability_ && (svm_type == NU_SVR || svm_type == EPSILON_SVR))
+    PCL_WARN("[pcl::%s::classificationTest] Prob. model for test data: target value "
+             "= predicted value + z,\nz: Laplace distribution "
+             "e^(-|z|/sigma)/(2sigma),sigma=%g\n",
+             getClassName().c_str(),
+             svm_get_svr_probability(&model_));
 
-  while (ii < prob_.l) {
-    // int i = 0;
-    double target_label, predict_label;
-    // char *idx, *val, *endptr;
-    // int inst_max_index = -1; // strtol gives 0 if wrong format, and precomputed
-    // kernel has <index> start from 0
+  predictSamples(prob_.x, prob_.l);
 
-    target_label = prob_.y[ii]; // takes the first label
-
-    if (predict_probability_ && (svm_type == C_SVC || svm_type == NU_SVC)) {
-      predict_label = svm_predict_probability(&model_, prob_.x[ii], prob_estimates);
-      prediction_[ii].push_back(predict_label);
-
-      for (int j = 0; j < nr_class; j++) {
-        prediction_[ii].push_back(prob_estimates[j]);
-      }
-    }
-    else {
-      predict_label = svm_predict(&model_, prob_.x[ii]);
-      prediction_[ii].push_back(predict_label);
-    }
+  for (int ii = 0; ii < prob_.l; ii++) {
+    double target_label = prob_.y[ii]; // takes the first label
+    double predict_label = prediction_[ii][0];
 
     if (predict_label == target_label)
       ++correct;
@@ -627,7 +599,6 @@ pcl::SVMClassify::classificationTest()
     sumpt += predict_label * target_label;
 
     ++total;
-    ii++;
   }
 
   if (svm_type == NU_SVR || svm_type == EPSILON_SVR) {
@@ -646,9 +617,6 @@ pcl::SVMClassify::classificationTest()
         "%g%% (%d/%d)\n", double(correct) / total * 100, correct, total);
   }
 
-  if (predict_probability_)
-    free(prob_estimates);
-
   return true;
 }
 
@@ -682,57 +650,16 @@ pcl::SVMClassify::classification()
                getClassName().c_str());
   }
 
-  // int correct = 0;
-  int total = 0;
   int svm_type = svm_get_svm_type(&model_);
-  int nr_class = svm_get_nr_class(&model_);
 
-  double* prob_estimates = nullptr;
-
-  prediction_.clear();
-
-  if (predict_probability_) {
-    if (svm_type == NU_SVR || svm_type == EPSILON_SVR)
-      PCL_WARN("[pcl::%s::classificationTest] Prob. model for test data: target value "
-               "= predicted value + z,\nz: Laplace distribution "
-               "e^(-|z|/sigma)/(2sigma),sigma=%g\n",
-               getClassName().c_str(),
-               svm_get_svr_probability(&model_));
-    else {
-      prob_estimates = static_cast<double*>(malloc(nr_class * sizeof(double)));
-    }
-  }
+  if (predict_probability_ && (svm_type == NU_SVR || svm_type == EPSILON_SVR))
+    PCL_WARN("[pcl::%s::classificationTest] Prob. model for test data: target value "
+             "= predicted value + z,\nz: Laplace distribution "
+             "e^(-|z|/sigma)/(2sigma),sigma=%g\n",
+             getClassName().c_str(),
+             svm_get_svr_probability(&model_));
 
-  int ii = 0;
-
-  prediction_.resize(prob_.l);
-
-  while (ii < prob_.l) {
-    double predict_label;
-    // char *idx, *val, *endptr;
-    // int inst_max_index = -1; // strtol gives 0 if wrong format, and precomputed
-    // kernel has <index> start from 0
-
-    if (predict_probability_ && (svm_type == C_SVC || svm_type == NU_SVC)) {
-      predict_label = svm_predict_probability(&model_, prob_.x[ii], prob_estimates);
-      prediction_[ii].push_back(predict_label);
-
-      for (int j = 0; j < nr_class; j++) {
-        prediction_[ii].push_back(prob_estimates[j]);
-      }
-    }
-    else {
-      predict_label = svm_predict(&model_, prob_.x[ii]);
-      prediction_[ii].push_back(predict_label);
-    }
-
-    ++total;
-
-    ii++;
-  }
-
-  if (predict_probability_)
-    free(prob_estimates);
+  predictSamples(prob_.x, prob_.l);
 
   return (true);
 }
@@ -821,6 +748,100 @@ pcl::SVMClassify::classification(pcl::SVMData in)
   return prediction_[0];
 };
 
+bool
+pcl::SVMClassify::classification(const std::vector<pcl::SVMData>& in)
+{
+  if (model_.l == 0) {
+    PCL_ERROR("[pcl::%s::classification] Classifier model has no data.\n",
+              getClassName().c_str());
+    return false;
+  }
+
+  if (predict_probability_) {
+    if (svm_check_probability_model(&model_) == 0) {
+      PCL_WARN("[pcl::%s::classification] Classifier model does not support probabiliy "
+               "estimates. Automatically disabled.\n",
+               getClassName().c_str());
+      predict_probability_ = false;
+    }
+  }
+  else {
+    if (svm_check_probability_model(&model_) != 0)
+      PCL_WARN("[pcl::%s::classification] Classifier model supports probability "
+               "estimates, but disabled in prediction.\n",
+               getClassName().c_str());
+  }
+
+  int svm_type = svm_get_svm_type(&model_);
+
+  if (predict_probability_ && (svm_type == NU_SVR || svm_type == EPSILON_SVR))
+    PCL_WARN("[pcl::%s::classification] Prob. model for test data: target value = "
+             "predicted value + z,\nz: Laplace distribution "
+             "e^(-|z|/sigma)/(2sigma),sigma=%g\n",
+             getClassName().c_str(),
+             svm_get_svr_probability(&model_));
+
+  // scale the sets as the single set classification does
+  int n = static_cast<int>(in.size());
+  std::vector<std::vector<svm_node>> nodes(n);
+  std::vector<svm_node*> x(n);
+  for (int i = 0; i < n; i++) {
+    const std::vector<SVMDataPoint>& sv = in[i].SV;
+    nodes[i].resize(sv.size() + 1);
+
+    for (std::size_t j = 0; j < sv.size(); j++) {
+      nodes[i][j].index = sv[j].idx;
+
+      if (sv[j].idx < scaling_.max && scaling_.obj[sv[j].idx].index == 1)
+        nodes[i][j].value = sv[j].value / scaling_.obj[sv[j].idx].value;
+      else
+        nodes[i][j].value = sv[j].value;
+    }
+
+    nodes[i][sv.size()].index = -1;
+    x[i] = nodes[i].data();
+  }
+
+  predictSamples(x.data(), n);
+
+  return (true);
+}
+
+void
+pcl::SVMClassify::predictSamples(svm_node** x, int n)
+{
+  int svm_type = svm_get_svm_type(&model_);
+  int nr_class = svm_get_nr_class(&model_);
+  bool use_probability =
+      predict_probability_ && (svm_type == C_SVC || svm_type == NU_SVC);
+
+  prediction_.clear();
+  prediction_.resize(n);
+
+  // svm_predict only reads the model, each sample is predicted independently
+  // clang-format off
+#pragma omp parallel \
+  default(none) \
+  shared(n, nr_class, use_probability, x) \
+  num_threads(pcl::utils::getNumberOfThreads(threads_))
+  // clang-format on
+  {
+    std::vector<double> prob_estimates(nr_class);
+
+#pragma omp for schedule(dynamic, 16)
+    for (int i = 0; i < n; i++) {
+      if (use_probability) {
+        prediction_[i].push_back(
+            svm_predict_probability(&model_, x[i], prob_estimates.data()));
+        prediction_[i].insert(
+            prediction_[i].end(), prob_estimates.begin(), prob_estimates.end());
+      }
+      else
+        prediction_[i].push_back(svm_predict(&model_, x[i]));
+    }
+  }
+}
+
 void
 pcl::SVMClassify::scaleProblem(svm_problem& input, svm_scaling scaling)
 {
@@ -50,6 +50,7 @@ Octree2BufBase<LeafContainerT, BranchContainerT>::Octree2BufBase()
 , depth_mask_(0)
 , buffer_selector_(0)
 , tree_dirty_flag_(false)
+, reused_branches_valid_(true)
 , octree_depth_(0)
 , dynamic_depth_enabled_(false)
 {}
@@ -167,6 +168,8 @@ Octree2BufBase<LeafContainerT, BranchContainerT>::deleteTree()
     branch_count_ = 1;
 
     tree_dirty_flag_ = false;
+    reused_branches_.clear();
+    reused_branches_valid_ = true;
     depth_mask_ = 0;
     octree_depth_ = 0;
   }
@@ -179,7 +182,12 @@ Octree2BufBase<LeafContainerT, BranchContainerT>::switchBuffers()
 {
   if (tree_dirty_flag_) {
     // make sure that all unused branch nodes from previous buffer are deleted
-    treeCleanUpRecursive(root_node_);
+    treeCleanUp();
+  }
+  else {
+    // the taken over branches are part of the previous buffer after the switch
+    reused_branches_.clear();
+    reused_branches_valid_ = true;
   }
 
   // switch butter selector
@@ -213,6 +221,8 @@ Octree2BufBase<LeafContainerT, BranchContainerT>::serializeTree(
 
   // serializeTreeRecursive cleans-up unused octree nodes in previous octree
   tree_dirty_flag_ = false;
+  reused_branches_.clear();
+  reused_branches_valid_ = true;
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////
@@ -241,6 +251,8 @@ Octree2BufBase<LeafContainerT, BranchContainerT>::serializeTree(
 
   // serializeTreeRecursive cleans-up unused octree nodes in previous octree
   tree_dirty_flag_ = false;
+  reused_branches_.clear();
+  reused_branches_valid_ = true;
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////
@@ -261,6 +273,8 @@ Octree2BufBase<LeafContainerT, BranchContainerT>::serializeLeafs(
 
   // serializeLeafsRecursive cleans-up unused octree nodes in previous octree
   tree_dirty_flag_ = false;
+  reused_branches_.clear();
+  reused_branches_valid_ = true;
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////
@@ -290,6 +304,8 @@ Octree2BufBase<LeafContainerT, BranchContainerT>::deserializeTree(
 
   // we modified the octree structure -> clean-up/tree-reset might be required
   tree_dirty_flag_ = false;
+  reused_branches_.clear();
+  reused_branches_valid_ = true;
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////
@@ -329,6 +345,8 @@ Octree2BufBase<LeafContainerT, BranchContainerT>::deserializeTree(
 
   // we modified the octree structure -> clean-up/tree-reset might be required
   tree_dirty_flag_ = false;
+  reused_branches_.clear();
+  reused_branches_valid_ = true;
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////
@@ -348,6 +366,8 @@ Octree2BufBase<LeafContainerT, BranchContainerT>::serializeNewLeafs(
 
   // serializeLeafsRecursive cleans-up unused octree nodes in previous octree buffer
   tree_dirty_flag_ = false;
+  reused_branches_.clear();
+  reused_branches_valid_ = true;
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////
@@ -398,6 +418,7 @@ Octree2BufBase<LeafContainerT, BranchContainerT>::createLeafRecursive(
 
         // take child branch from previous buffer
         doNodeReset = true; // reset the branch pointer array of stolen child node
+        reused_branches_.push_back(child_branch);
       }
       else {
         // if required branch does not exist -> create it
@@ -431,6 +452,8 @@ Octree2BufBase<LeafContainerT, BranchContainerT>::createLeafRecursive(
       OctreeNode* child_node = branch_arg->getChildPtr(!buffer_selector_, child_idx);
       if (child_node->getNodeType() == LEAF_NODE) {
         child_leaf = static_cast<LeafNode*>(child_node);
+        // the container still holds the data of the previous buffer
+        child_leaf->getContainer().reset();
         branch_arg->setChildPtr(buffer_selector_, child_idx, child_node);
       }
       else {
@@ -785,6 +808,25 @@ Octree2BufBase<LeafContainerT, BranchContainerT>::deserializeTreeRecursive(
   }
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename LeafContainerT, typename BranchContainerT>
+void
+Octree2BufBase<LeafContainerT, BranchContainerT>::treeCleanUp()
+{
+  if (reused_branches_valid_) {
+    // branches created in the current buffer have no children in the previous buffer
+    branchCleanUp(*root_node_);
+    for (BranchNode* branch : reused_branches_)
+      branchCleanUp(*branch);
+  }
+  else {
+    treeCleanUpRecursive(root_node_);
+  }
+
+  reused_branches_.clear();
+  reused_branches_valid_ = true;
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////
 template <typename LeafContainerT, typename BranchContainerT>
 void
@@ -46,29 +46,35 @@
 namespace pcl {
 namespace octree {
 //////////////////////////////////////////////////////////////////////////////////////////////
-template <typename LeafContainerT, typename BranchContainerT>
-OctreeBase<LeafContainerT, BranchContainerT>::OctreeBase()
+template <typename LeafContainerT,
+          typename BranchContainerT,
+          template <typename> class NodeAllocatorT>
+OctreeBase<LeafContainerT, BranchContainerT, NodeAllocatorT>::OctreeBase()
 : leaf_count_(0)
 , branch_count_(1)
-, root_node_(new BranchNode())
+, root_node_(branch_allocator_.allocate())
 , depth_mask_(0)
 , octree_depth_(0)
 , dynamic_depth_enabled_(false)
 {}
 
 //////////////////////////////////////////////////////////////////////////////////////////////
-template <typename LeafContainerT, typename BranchContainerT>
-OctreeBase<LeafContainerT, BranchContainerT>::~OctreeBase()
+template <typename LeafContainerT,
+          typename BranchContainerT,
+          template <typename> class NodeAllocatorT>
+OctreeBase<LeafContainerT, BranchContainerT, NodeAllocatorT>::~OctreeBase()
 {
   // deallocate tree structure
   deleteTree();
-  delete (root_node_);
+  branch_allocator_.deallocate(root_node_);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////
-template <typename LeafContainerT, typename BranchContainerT>
+template <typename LeafContainerT,
+          typename BranchContainerT,
+          template <typename> class NodeAllocatorT>
 void
-OctreeBase<LeafContainerT, BranchContainerT>::setMaxVoxelIndex(
+OctreeBase<LeafContainerT, BranchContainerT, NodeAllocatorT>::setMaxVoxelIndex(
     unsigned int max_voxel_index_arg)
 {
   unsigned int tree_depth;
@@ -85,9 +91,11 @@ OctreeBase<LeafContainerT, BranchContainerT>::setMaxVoxelIndex(
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////
-template <typename LeafContainerT, typename BranchContainerT>
+template <typename LeafContainerT,
+          typename BranchContainerT,
+          template <typename> class NodeAllocatorT>
 void
-OctreeBase<LeafContainerT, BranchContainerT>::setTreeDepth(unsigned int depth_arg)
+OctreeBase<LeafContainerT, BranchContainerT, NodeAllocatorT>::setTreeDepth(unsigned int depth_arg)
 {
   assert(depth_arg > 0);
 
@@ -102,9 +110,11 @@ OctreeBase<LeafContainerT, BranchContainerT>::setTreeDepth(unsigned int depth_ar
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////
-template <typename LeafContainerT, typename BranchContainerT>
+template <typename LeafContainerT,
+          typename BranchContainerT,
+          template <typename> class NodeAllocatorT>
 LeafContainerT*
-OctreeBase<LeafContainerT, BranchContainerT>::findLeaf(unsigned int idx_x_arg,
+OctreeBase<LeafContainerT, BranchContainerT, NodeAllocatorT>::findLeaf(unsigned int idx_x_arg,
                                                        unsigned int idx_y_arg,
                                                        unsigned int idx_z_arg)
 {
@@ -116,9 +126,11 @@ OctreeBase<LeafContainerT, BranchContainerT>::findLeaf(unsigned int idx_x_arg,
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////
-template <typename LeafContainerT, typename BranchContainerT>
+template <typename LeafContainerT,
+          typename BranchContainerT,
+          template <typename> class NodeAllocatorT>
 LeafContainerT*
-OctreeBase<LeafContainerT, BranchContainerT>::createLeaf(unsigned int idx_x_arg,
+OctreeBase<LeafContainerT, BranchContainerT, NodeAllocatorT>::createLeaf(unsigned int idx_x_arg,
                                                          unsigned int idx_y_arg,
                                                          unsigned int idx_z_arg)
 {
@@ -130,9 +142,11 @@ OctreeBase<LeafContainerT, BranchContainerT>::createLeaf(unsigned int idx_x_arg,
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////
-template <typename LeafContainerT, typename BranchContainerT>
+template <typename LeafContainerT,
+          typename BranchContainerT,
+          template <typename> class NodeAllocatorT>
 bool
-OctreeBase<LeafContainerT, BranchContainerT>::existLeaf(unsigned int idx_x_arg,
+OctreeBase<LeafContainerT, BranchContainerT, NodeAllocatorT>::existLeaf(unsigned int idx_x_arg,
                                                         unsigned int idx_y_arg,
                                                         unsigned int idx_z_arg) const
 {
@@ -144,9 +158,11 @@ OctreeBase<LeafContainerT, BranchContainerT>::existLeaf(unsigned int idx_x_arg,
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////
-template <typename LeafContainerT, typename BranchContainerT>
+template <typename LeafContainerT,
+          typename BranchContainerT,
+          template <typename> class NodeAllocatorT>
 void
-OctreeBase<LeafContainerT, BranchContainerT>::removeLeaf(unsigned int idx_x_arg,
+OctreeBase<LeafContainerT, BranchContainerT, NodeAllocatorT>::removeLeaf(unsigned int idx_x_arg,
                                                          unsigned int idx_y_arg,
                                                          unsigned int idx_z_arg)
 {
@@ -158,9 +174,11 @@ OctreeBase<LeafContainerT, BranchContainerT>::removeLeaf(unsigned int idx_x_arg,
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////
-template <typename LeafContainerT, typename BranchContainerT>
+template <typename LeafContainerT,
+          typename BranchContainerT,
+          template <typename> class NodeAllocatorT>
 void
-OctreeBase<LeafContainerT, BranchContainerT>::deleteTree()
+OctreeBase<LeafContainerT, BranchContainerT, NodeAllocatorT>::deleteTree()
 {
 
   if (root_node_) {
@@ -172,9 +190,11 @@ OctreeBase<LeafContainerT, BranchContainerT>::deleteTree()
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////
-template <typename LeafContainerT, typename BranchContainerT>
+template <typename LeafContainerT,
+          typename BranchContainerT,
+          template <typename> class NodeAllocatorT>
 void
-OctreeBase<LeafContainerT, BranchContainerT>::serializeTree(
+OctreeBase<LeafContainerT, BranchContainerT, NodeAllocatorT>::serializeTree(
     std::vector<char>& binary_tree_out_arg)
 {
 
@@ -188,9 +208,11 @@ OctreeBase<LeafContainerT, BranchContainerT>::serializeTree(
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////
-template <typename LeafContainerT, typename BranchContainerT>
+template <typename LeafContainerT,
+          typename BranchContainerT,
+          template <typename> class NodeAllocatorT>
 void
-OctreeBase<LeafContainerT, BranchContainerT>::serializeTree(
+OctreeBase<LeafContainerT, BranchContainerT, NodeAllocatorT>::serializeTree(
     std::vector<char>& binary_tree_out_arg,
     std::vector<LeafContainerT*>& leaf_container_vector_arg)
 {
@@ -209,9 +231,11 @@ OctreeBase<LeafContainerT, BranchContainerT>::serializeTree(
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////
-template <typename LeafContainerT, typename BranchContainerT>
+template <typename LeafContainerT,
+          typename BranchContainerT,
+          template <typename> class NodeAllocatorT>
 void
-OctreeBase<LeafContainerT, BranchContainerT>::serializeLeafs(
+OctreeBase<LeafContainerT, BranchContainerT, NodeAllocatorT>::serializeLeafs(
     std::vector<LeafContainerT*>& leaf_container_vector_arg)
 {
   OctreeKey new_key;
@@ -225,9 +249,11 @@ OctreeBase<LeafContainerT, BranchContainerT>::serializeLeafs(
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////
-template <typename LeafContainerT, typename BranchContainerT>
+template <typename LeafContainerT,
+          typename BranchContainerT,
+          template <typename> class NodeAllocatorT>
 void
-OctreeBase<LeafContainerT, BranchContainerT>::deserializeTree(
+OctreeBase<LeafContainerT, BranchContainerT, NodeAllocatorT>::deserializeTree(
     std::vector<char>& binary_tree_out_arg)
 {
   OctreeKey new_key;
@@ -249,9 +275,11 @@ OctreeBase<LeafContainerT, BranchContainerT>::deserializeTree(
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////
-template <typename LeafContainerT, typename BranchContainerT>
+template <typename LeafContainerT,
+          typename BranchContainerT,
+          template <typename> class NodeAllocatorT>
 void
-OctreeBase<LeafContainerT, BranchContainerT>::deserializeTree(
+OctreeBase<LeafContainerT, BranchContainerT, NodeAllocatorT>::deserializeTree(
     std::vector<char>& binary_tree_in_arg,
     std::vector<LeafContainerT*>& leaf_container_vector_arg)
 {
@@ -282,9 +310,11 @@ OctreeBase<LeafContainerT, BranchContainerT>::deserializeTree(
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////
-template <typename LeafContainerT, typename BranchContainerT>
+template <typename LeafContainerT,
+          typename BranchContainerT,
+          template <typename> class NodeAllocatorT>
 unsigned int
-OctreeBase<LeafContainerT, BranchContainerT>::createLeafRecursive(
+OctreeBase<LeafContainerT, BranchContainerT, NodeAllocatorT>::createLeafRecursive(
     const OctreeKey& key_arg,
     unsigned int depth_mask_arg,
     BranchNode* branch_arg,
@@ -342,9 +372,11 @@ OctreeBase<LeafContainerT, BranchContainerT>::createLeafRecursive(
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////
-template <typename LeafContainerT, typename BranchContainerT>
+template <typename LeafContainerT,
+          typename BranchContainerT,
+          template <typename> class NodeAllocatorT>
 void
-OctreeBase<LeafContainerT, BranchContainerT>::findLeafRecursive(
+OctreeBase<LeafContainerT, BranchContainerT, NodeAllocatorT>::findLeafRecursive(
     const OctreeKey& key_arg,
     unsigned int depth_mask_arg,
     BranchNode* branch_arg,
@@ -380,9 +412,11 @@ OctreeBase<LeafContainerT, BranchContainerT>::findLeafRecursive(
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////
-template <typename LeafContainerT, typename BranchContainerT>
+template <typename LeafContainerT,
+          typename BranchContainerT,
+          template <typename> class NodeAllocatorT>
 bool
-OctreeBase<LeafContainerT, BranchContainerT>::deleteLeafRecursive(
+OctreeBase<LeafContainerT, BranchContainerT, NodeAllocatorT>::deleteLeafRecursive(
     const OctreeKey& key_arg, unsigned int depth_mask_arg, BranchNode* branch_arg)
 {
   // index to branch child
@@ -432,9 +466,11 @@ OctreeBase<LeafContainerT, BranchContainerT>::deleteLeafRecursive(
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////
-template <typename LeafContainerT, typename BranchContainerT>
+template <typename LeafContainerT,
+          typename BranchContainerT,
+          template <typename> class NodeAllocatorT>
 void
-OctreeBase<LeafContainerT, BranchContainerT>::serializeTreeRecursive(
+OctreeBase<LeafContainerT, BranchContainerT, NodeAllocatorT>::serializeTreeRecursive(
     const BranchNode* branch_arg,
     OctreeKey& key_arg,
     std::vector<char>* binary_tree_out_arg,
@@ -489,9 +525,11 @@ OctreeBase<LeafContainerT, BranchContainerT>::serializeTreeRecursive(
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////
-template <typename LeafContainerT, typename BranchContainerT>
+template <typename LeafContainerT,
+          typename BranchContainerT,
+          template <typename> class NodeAllocatorT>
 void
-OctreeBase<LeafContainerT, BranchContainerT>::deserializeTreeRecursive(
+OctreeBase<LeafContainerT, BranchContainerT, NodeAllocatorT>::deserializeTreeRecursive(
     BranchNode* branch_arg,
     unsigned int depth_mask_arg,
     OctreeKey& key_arg,
@@ -42,7 +42,15 @@
 #include <pcl/common/point_tests.h> // for pcl::isFinite
 #include <pcl/octree/impl/octree_base.hpp>
 
+#include <algorithm>
 #include <cassert>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 //////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT,
@@ -64,6 +72,7 @@ pcl::octree::OctreePointCloud<PointT, LeafContainerT, BranchContainerT, OctreeT>
 , max_z_(resolution)
 , bounding_box_defined_(false)
 , max_objs_per_leaf_(0)
+, threads_(1)
 {
   assert(resolution > 0.0f);
 }
@@ -77,24 +86,134 @@ void
 pcl::octree::OctreePointCloud<PointT, LeafContainerT, BranchContainerT, OctreeT>::
     addPointsFromInputCloud()
 {
+  std::vector<int> valid_indices;
   if (indices_) {
+    valid_indices.reserve(indices_->size());
     for (const int& index : *indices_) {
       assert((index >= 0) && (index < static_cast<int>(input_->size())));
 
-      if (isFinite((*input_)[index])) {
-        // add points to octree
-        this->addPointIdx(index);
-      }
+      if (isFinite((*input_)[index]))
+        valid_indices.push_back(index);
     }
   }
   else {
+    valid_indices.reserve(input_->size());
     for (std::size_t i = 0; i < input_->size(); i++) {
-      if (isFinite((*input_)[i])) {
-        // add points to octree
-        this->addPointIdx(static_cast<unsigned int>(i));
-      }
+      if (isFinite((*input_)[i]))
+        valid_indices.push_back(static_cast<int>(i));
     }
   }
+
+  if (this->dynamic_depth_enabled_) {
+    // leaf nodes are expanded depending on their point count - add points one by one
+    for (const int& index : valid_indices)
+      this->addPointIdx(index);
+    return;
+  }
+
+  // grow the bounding box in the same order as adding single points would do
+  for (const int& index : valid_indices)
+    adoptBoundingBoxToPoint((*input_)[index]);
+
+  addPointIndicesBulk(valid_indices);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT,
+          typename LeafContainerT,
+          typename BranchContainerT,
+          typename OctreeT>
+void
+pcl::octree::OctreePointCloud<PointT, LeafContainerT, BranchContainerT, OctreeT>::
+    setNumberOfThreads(unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT,
+          typename LeafContainerT,
+          typename BranchContainerT,
+          typename OctreeT>
+void
+pcl::octree::OctreePointCloud<PointT, LeafContainerT, BranchContainerT, OctreeT>::
+    addPointIndicesBulk(const std::vector<int>& indices_arg)
+{
+  const std::ptrdiff_t point_count = static_cast<std::ptrdiff_t>(indices_arg.size());
+  const unsigned int depth = this->octree_depth_;
+
+  // Points are sorted along the depth first order of the octree, which is the Morton
+  // order of the keys with x as the most significant bit of every level. Up to a depth
+  // of 21 the Morton code fits into 64 bit.
+  std::vector<OctreeKey> keys(point_count);
+  std::vector<std::pair<std::uint64_t, int>> codes(point_count);
+
+#pragma omp parallel for default(none) shared(codes, indices_arg, keys)                \
+    firstprivate(depth, point_count) num_threads(threads_)
+  for (std::ptrdiff_t i = 0; i < point_count; ++i) {
+    OctreeKey& key = keys[i];
+    this->genOctreeKeyforPoint((*input_)[indices_arg[i]], key);
+
+    std::uint64_t code = 0;
+    if (depth * 3 <= 64)
+      for (unsigned int depth_mask = 1u << (depth - 1); depth_mask; depth_mask >>= 1)
+        code = (code << 3) | key.getChildIdxWithDepthMask(depth_mask);
+    codes[i] = std::make_pair(code, static_cast<int>(i));
+  }
+
+  if (depth * 3 <= 64) {
+    // stable LSD radix sort on the used bits of the Morton codes
+    std::vector<std::pair<std::uint64_t, int>> sorted_codes(point_count);
+    for (unsigned int shift = 0; shift < depth * 3; shift += 8) {
+      std::size_t offsets[257] = {0};
+      for (const auto& code : codes)
+        ++offsets[((code.first >> shift) & 0xFF) + 1];
+      for (std::size_t bucket = 1; bucket < 257; ++bucket)
+        offsets[bucket] += offsets[bucket - 1];
+      for (const auto& code : codes)
+        sorted_codes[offsets[(code.first >> shift) & 0xFF]++] = code;
+      codes.swap(sorted_codes);
+    }
+  }
+  else {
+    std::stable_sort(codes.begin(),
+                     codes.end(),
+                     [&keys](const std::pair<std::uint64_t, int>& a,
+                             const std::pair<std::uint64_t, int>& b) {
+                       return keys[a.second].isMortonOrderLess(keys[b.second]);
+                     });
+  }
+
+  // Add every run of points sharing a voxel to its leaf node. Consecutive voxels often
+  // share their parent branch, in which case the tree is not traversed from the root.
+  LeafNode* leaf_node = nullptr;
+  BranchNode* parent_branch = nullptr;
+  const OctreeKey* previous_key = nullptr;
+  auto run_begin = codes.cbegin();
+  while (run_begin != codes.cend()) {
+    const OctreeKey& key = keys[run_begin->second];
+    if (previous_key && ((previous_key->x >> 1) == (key.x >> 1)) &&
+        ((previous_key->y >> 1) == (key.y >> 1)) &&
+        ((previous_key->z >> 1) == (key.z >> 1)))
+      this->createLeafRecursive(key, 1, parent_branch, leaf_node, parent_branch);
+    else
+      this->createLeafRecursive(
+          key, this->depth_mask_, this->root_node_, leaf_node, parent_branch);
+    previous_key = &key;
+
+    auto run_end = run_begin;
+    for (; run_end != codes.cend() && keys[run_end->second] == key; ++run_end)
+      addPointIdxToLeaf(leaf_node->getContainer(), indices_arg[run_end->second]);
+
+    run_begin = run_end;
+  }
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////
@@ -146,6 +265,50 @@ pcl::octree::OctreePointCloud<PointT, LeafContainerT, BranchContainerT, OctreeT>
   this->addPointFromCloud(static_cast<const int>(cloud_arg->size()) - 1, indices_arg);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT,
+          typename LeafContainerT,
+          typename BranchContainerT,
+          typename OctreeT>
+std::size_t
+pcl::octree::OctreePointCloud<PointT, LeafContainerT, BranchContainerT, OctreeT>::
+    addPointsFromQueue(OctreePointCloudInsertionQueue<PointT>& queue_arg,
+                       PointCloudPtr cloud_arg,
+                       IndicesPtr indices_arg)
+{
+  assert(cloud_arg == input_);
+  assert(indices_arg == indices_);
+
+  std::vector<PointCloud> batches;
+  queue_arg.take(batches);
+
+  std::vector<int> valid_indices;
+  for (const PointCloud& batch : batches) {
+    const int first_index = static_cast<int>(cloud_arg->size());
+    *cloud_arg += batch;
+
+    for (std::size_t i = 0; i < batch.size(); ++i) {
+      const int index = first_index + static_cast<int>(i);
+      if (indices_arg)
+        indices_arg->push_back(index);
+      if (isFinite(batch[i]))
+        valid_indices.push_back(index);
+    }
+  }
+
+  if (this->dynamic_depth_enabled_) {
+    for (const int& index : valid_indices)
+      this->addPointIdx(index);
+  }
+  else {
+    for (const int& index : valid_indices)
+      adoptBoundingBoxToPoint((*input_)[index]);
+    addPointIndicesBulk(valid_indices);
+  }
+
+  return (valid_indices.size());
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT,
           typename LeafContainerT,
@@ -541,7 +704,7 @@ pcl::octree::OctreePointCloud<PointT, LeafContainerT, BranchContainerT, OctreeT>
 
         BranchNode* newRootBranch;
 
-        newRootBranch = new BranchNode();
+        newRootBranch = this->createBranch();
         this->branch_count_++;
 
         this->setBranchChildPtr(*newRootBranch, child_idx, this->root_node_);
@@ -66,53 +66,76 @@ void
 pcl::octree::OctreePointCloudAdjacency<PointT, LeafContainerT, BranchContainerT>::
     addPointsFromInputCloud()
 {
-  // double t1,t2;
-  float minX = std::numeric_limits<float>::max(),
-        minY = std::numeric_limits<float>::max(),
-        minZ = std::numeric_limits<float>::max();
-  float maxX = -std::numeric_limits<float>::max(),
-        maxY = -std::numeric_limits<float>::max(),
-        maxZ = -std::numeric_limits<float>::max();
-
-  for (std::size_t i = 0; i < input_->size(); ++i) {
-    PointT temp((*input_)[i]);
-    if (transform_func_) // Search for point with
-      transform_func_(temp);
-    if (!pcl::isFinite(
-            temp)) // Check to make sure transform didn't make point not finite
-      continue;
-    if (temp.x < minX)
-      minX = temp.x;
-    if (temp.y < minY)
-      minY = temp.y;
-    if (temp.z < minZ)
-      minZ = temp.z;
-    if (temp.x > maxX)
-      maxX = temp.x;
-    if (temp.y > maxY)
-      maxY = temp.y;
-    if (temp.z > maxZ)
-      maxZ = temp.z;
+  // The bounding box of the transformed points, every thread reduces a contiguous chunk
+  const std::ptrdiff_t point_count = static_cast<std::ptrdiff_t>(input_->size());
+  const std::ptrdiff_t chunk_count = std::max<std::ptrdiff_t>(
+      1, std::min<std::ptrdiff_t>(this->threads_, point_count));
+  std::vector<Eigen::Array3f> chunk_min(
+      chunk_count, Eigen::Array3f::Constant(std::numeric_limits<float>::max()));
+  std::vector<Eigen::Array3f> chunk_max(
+      chunk_count, Eigen::Array3f::Constant(-std::numeric_limits<float>::max()));
+
+#pragma omp parallel for num_threads(this->threads_)
+  for (std::ptrdiff_t chunk = 0; chunk < chunk_count; ++chunk) {
+    const std::ptrdiff_t chunk_begin = point_count * chunk / chunk_count;
+    const std::ptrdiff_t chunk_end = point_count * (chunk + 1) / chunk_count;
+    for (std::ptrdiff_t i = chunk_begin; i < chunk_end; ++i) {
+      PointT temp((*input_)[i]);
+      if (transform_func_) // Search for point with
+        transform_func_(temp);
+      if (!pcl::isFinite(
+              temp)) // Check to make sure transform didn't make point not finite
+        continue;
+      chunk_min[chunk] = chunk_min[chunk].min(temp.getArray3fMap());
+      chunk_max[chunk] = chunk_max[chunk].max(temp.getArray3fMap());
+    }
   }
-  this->defineBoundingBox(minX, minY, minZ, maxX, maxY, maxZ);
 
-  OctreePointCloud<PointT, LeafContainerT, BranchContainerT>::addPointsFromInputCloud();
+  Eigen::Array3f min_pt = chunk_min.front(), max_pt = chunk_max.front();
+  for (std::ptrdiff_t chunk = 1; chunk < chunk_count; ++chunk) {
+    min_pt = min_pt.min(chunk_min[chunk]);
+    max_pt = max_pt.max(chunk_max[chunk]);
+  }
+  this->defineBoundingBox(
+      min_pt.x(), min_pt.y(), min_pt.z(), max_pt.x(), max_pt.y(), max_pt.z());
+
+  // the bounding box is defined by the transformed points, add all finite points in bulk
+  std::vector<int> valid_indices;
+  if (this->indices_) {
+    valid_indices.reserve(this->indices_->size());
+    for (const int& index : *this->indices_)
+      if (pcl::isFinite((*input_)[index]))
+        valid_indices.push_back(index);
+  }
+  else {
+    valid_indices.reserve(input_->size());
+    for (std::size_t i = 0; i < input_->size(); ++i)
+      if (pcl::isFinite((*input_)[i]))
+        valid_indices.push_back(static_cast<int>(i));
+  }
+  this->addPointIndicesBulk(valid_indices);
 
+  // Gather the leaves in depth first order
+  std::vector<OctreeKey> leaf_keys;
+  leaf_keys.reserve(this->getLeafCount());
   leaf_vector_.reserve(this->getLeafCount());
   for (auto leaf_itr = this->leaf_depth_begin(); leaf_itr != this->leaf_depth_end();
        ++leaf_itr) {
-    OctreeKey leaf_key = leaf_itr.getCurrentOctreeKey();
-    LeafContainerT* leaf_container = &(leaf_itr.getLeafContainer());
-
-    // Run the leaf's compute function
-    leaf_container->computeData();
-
-    computeNeighbors(leaf_key, leaf_container);
-
-    leaf_vector_.push_back(leaf_container);
+    leaf_keys.push_back(leaf_itr.getCurrentOctreeKey());
+    leaf_vector_.push_back(&(leaf_itr.getLeafContainer()));
   }
   // Make sure our leaf vector is correctly sized
   assert(leaf_vector_.size() == this->getLeafCount());
+
+  // Run the leaves' compute functions and find their neighbors. The tree is not
+  // modified anymore and every leaf only modifies itself, so the leaves are processed in
+  // parallel.
+  const std::ptrdiff_t leaf_count = static_cast<std::ptrdiff_t>(leaf_vector_.size());
+#pragma omp parallel for schedule(dynamic, 256) num_threads(this->threads_)
+  for (std::ptrdiff_t i = 0; i < leaf_count; ++i) {
+    leaf_vector_[i]->computeData();
+    computeNeighbors(leaf_keys[i], leaf_vector_[i]);
+  }
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////
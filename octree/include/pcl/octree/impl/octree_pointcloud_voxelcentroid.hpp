@@ -76,13 +76,17 @@ pcl::octree::OctreePointCloudVoxelCentroid<PointT, LeafContainerT, BranchContain
         typename OctreePointCloud<PointT, LeafContainerT, BranchContainerT>::
             AlignedPointTVector& voxel_centroid_list_arg) const
 {
-  OctreeKey new_key;
+  // gather the leaves in depth first order, then compute their centroids in parallel
+  std::vector<const LeafNode*> leaf_list;
+  leaf_list.reserve(this->leaf_count_);
+  getLeafNodesRecursive(this->root_node_, leaf_list);
 
-  // reset output vector
-  voxel_centroid_list_arg.clear();
-  voxel_centroid_list_arg.reserve(this->leaf_count_);
+  const std::ptrdiff_t leaf_count = static_cast<std::ptrdiff_t>(leaf_list.size());
+  voxel_centroid_list_arg.resize(leaf_count);
 
-  getVoxelCentroidsRecursive(this->root_node_, new_key, voxel_centroid_list_arg);
+#pragma omp parallel for schedule(dynamic, 256) num_threads(this->threads_)
+  for (std::ptrdiff_t i = 0; i < leaf_count; ++i)
+    leaf_list[i]->getContainer().getCentroid(voxel_centroid_list_arg[i]);
 
   // return size of centroid vector
   return (voxel_centroid_list_arg.size());
@@ -135,6 +139,25 @@ pcl::octree::OctreePointCloudVoxelCentroid<PointT, LeafContainerT, BranchContain
   }
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT, typename LeafContainerT, typename BranchContainerT>
+void
+pcl::octree::OctreePointCloudVoxelCentroid<PointT, LeafContainerT, BranchContainerT>::
+    getLeafNodesRecursive(const BranchNode* branch_arg,
+                          std::vector<const LeafNode*>& leaf_list_arg) const
+{
+  for (unsigned char child_idx = 0; child_idx < 8; child_idx++) {
+    const OctreeNode* child_node = branch_arg->getChildPtr(child_idx);
+    if (!child_node)
+      continue;
+
+    if (child_node->getNodeType() == BRANCH_NODE)
+      getLeafNodesRecursive(static_cast<const BranchNode*>(child_node), leaf_list_arg);
+    else
+      leaf_list_arg.push_back(static_cast<const LeafNode*>(child_node));
+  }
+}
+
 #define PCL_INSTANTIATE_OctreePointCloudVoxelCentroid(T)                               \
   template class PCL_EXPORTS pcl::octree::OctreePointCloudVoxelCentroid<T>;
 
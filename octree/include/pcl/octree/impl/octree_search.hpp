@@ -39,7 +39,10 @@
 #ifndef PCL_OCTREE_SEARCH_IMPL_H_
 #define PCL_OCTREE_SEARCH_IMPL_H_
 
+#include <algorithm>
+#include <array>
 #include <cassert>
+#include <numeric>
 
 namespace pcl {
 
@@ -83,7 +86,20 @@ OctreePointCloudSearch<PointT, LeafContainerT, BranchContainerT>::nearestKSearch
     const PointT& p_q,
     int k,
     std::vector<int>& k_indices,
-    std::vector<float>& k_sqr_distances)
+    std::vector<float>& k_sqr_distances) const
+{
+  std::vector<prioPointQueueEntry> point_candidates;
+  return (nearestKSearch(p_q, k, point_candidates, k_indices, k_sqr_distances));
+}
+
+template <typename PointT, typename LeafContainerT, typename BranchContainerT>
+int
+OctreePointCloudSearch<PointT, LeafContainerT, BranchContainerT>::nearestKSearch(
+    const PointT& p_q,
+    int k,
+    std::vector<prioPointQueueEntry>& point_candidates,
+    std::vector<int>& k_indices,
+    std::vector<float>& k_sqr_distances) const
 {
   assert(this->leaf_count_ > 0);
   assert(isFinite(p_q) &&
@@ -91,21 +107,20 @@ OctreePointCloudSearch<PointT, LeafContainerT, BranchContainerT>::nearestKSearch
 
   k_indices.clear();
   k_sqr_distances.clear();
+  point_candidates.clear();
 
   if (k < 1)
     return 0;
 
-  prioPointQueueEntry point_entry;
-  std::vector<prioPointQueueEntry> point_candidates;
-
   OctreeKey key;
   key.x = key.y = key.z = 0;
 
   // initialize smallest point distance in search with high value
   double smallest_dist = std::numeric_limits<double>::max();
 
+  SearchBudget budget;
   getKNearestNeighborRecursive(
-      p_q, k, this->root_node_, key, 1, smallest_dist, point_candidates);
+      p_q, k, this->root_node_, key, 1, smallest_dist, point_candidates, budget);
 
   unsigned int result_count = static_cast<unsigned int>(point_candidates.size());
 
@@ -123,12 +138,56 @@ OctreePointCloudSearch<PointT, LeafContainerT, BranchContainerT>::nearestKSearch
 template <typename PointT, typename LeafContainerT, typename BranchContainerT>
 int
 OctreePointCloudSearch<PointT, LeafContainerT, BranchContainerT>::nearestKSearch(
-    int index, int k, std::vector<int>& k_indices, std::vector<float>& k_sqr_distances)
+    int index,
+    int k,
+    std::vector<int>& k_indices,
+    std::vector<float>& k_sqr_distances) const
 {
   const PointT search_point = this->getPointByIndex(index);
   return (nearestKSearch(search_point, k, k_indices, k_sqr_distances));
 }
 
+template <typename PointT, typename LeafContainerT, typename BranchContainerT>
+void
+OctreePointCloudSearch<PointT, LeafContainerT, BranchContainerT>::nearestKSearch(
+    const PointCloud& cloud,
+    const std::vector<int>& indices,
+    int k,
+    std::vector<std::vector<int>>& k_indices,
+    std::vector<std::vector<float>>& k_sqr_distances) const
+{
+  const std::vector<int> query_order = getQueryOrder(cloud, indices);
+  const std::size_t nr_queries = query_order.size();
+
+  k_indices.resize(nr_queries);
+  k_sqr_distances.resize(nr_queries);
+
+#pragma omp parallel num_threads(this->threads_)
+  {
+    // candidate buffer reused by all queries of this thread
+    std::vector<prioPointQueueEntry> point_candidates;
+
+#pragma omp for schedule(dynamic, 64)
+    for (std::ptrdiff_t i = 0; i < static_cast<std::ptrdiff_t>(nr_queries); ++i) {
+      const int query_idx = query_order[i];
+      const PointT& query =
+          cloud[indices.empty() ? query_idx : indices[query_idx]];
+
+      if (!isFinite(query)) {
+        k_indices[query_idx].clear();
+        k_sqr_distances[query_idx].clear();
+        continue;
+      }
+
+      nearestKSearch(query,
+                     k,
+                     point_candidates,
+                     k_indices[query_idx],
+                     k_sqr_distances[query_idx]);
+    }
+  }
+}
+
 template <typename PointT, typename LeafContainerT, typename BranchContainerT>
 void
 OctreePointCloudSearch<PointT, LeafContainerT, BranchContainerT>::approxNearestSearch(
@@ -174,6 +233,7 @@ OctreePointCloudSearch<PointT, LeafContainerT, BranchContainerT>::radiusSearch(
   k_indices.clear();
   k_sqr_distances.clear();
 
+  SearchBudget budget;
   getNeighborsWithinRadiusRecursive(p_q,
                                     radius * radius,
                                     this->root_node_,
@@ -181,7 +241,8 @@ OctreePointCloudSearch<PointT, LeafContainerT, BranchContainerT>::radiusSearch(
                                     1,
                                     k_indices,
                                     k_sqr_distances,
-                                    max_nn);
+                                    max_nn,
+                                    budget);
 
   return (static_cast<int>(k_indices.size()));
 }
@@ -200,6 +261,38 @@ OctreePointCloudSearch<PointT, LeafContainerT, BranchContainerT>::radiusSearch(
   return (radiusSearch(search_point, radius, k_indices, k_sqr_distances, max_nn));
 }
 
+template <typename PointT, typename LeafContainerT, typename BranchContainerT>
+void
+OctreePointCloudSearch<PointT, LeafContainerT, BranchContainerT>::radiusSearch(
+    const PointCloud& cloud,
+    const std::vector<int>& indices,
+    const double radius,
+    std::vector<std::vector<int>>& k_indices,
+    std::vector<std::vector<float>>& k_sqr_distances,
+    unsigned int max_nn) const
+{
+  const std::vector<int> query_order = getQueryOrder(cloud, indices);
+  const std::size_t nr_queries = query_order.size();
+
+  k_indices.resize(nr_queries);
+  k_sqr_distances.resize(nr_queries);
+
+#pragma omp parallel for schedule(dynamic, 64) num_threads(this->threads_)
+  for (std::ptrdiff_t i = 0; i < static_cast<std::ptrdiff_t>(nr_queries); ++i) {
+    const int query_idx = query_order[i];
+    const PointT& query = cloud[indices.empty() ? query_idx : indices[query_idx]];
+
+    if (!isFinite(query)) {
+      k_indices[query_idx].clear();
+      k_sqr_distances[query_idx].clear();
+      continue;
+    }
+
+    radiusSearch(
+        query, radius, k_indices[query_idx], k_sqr_distances[query_idx], max_nn);
+  }
+}
+
 template <typename PointT, typename LeafContainerT, typename BranchContainerT>
 int
 OctreePointCloudSearch<PointT, LeafContainerT, BranchContainerT>::boxSearch(
@@ -228,10 +321,12 @@ OctreePointCloudSearch<PointT, LeafContainerT, BranchContainerT>::
         const OctreeKey& key,
         unsigned int tree_depth,
         const double squared_search_radius,
-        std::vector<prioPointQueueEntry>& point_candidates) const
+        std::vector<prioPointQueueEntry>& point_candidates,
+        SearchBudget& budget) const
 {
-  std::vector<prioBranchQueueEntry> search_heap;
-  search_heap.resize(8);
+  // at most eight children, kept on the stack to avoid an allocation per visited node
+  std::array<prioBranchQueueEntry, 8> search_heap;
+  std::size_t heap_size = 0;
 
   OctreeKey new_key;
 
@@ -244,38 +339,40 @@ OctreePointCloudSearch<PointT, LeafContainerT, BranchContainerT>::
   for (unsigned char child_idx = 0; child_idx < 8; child_idx++) {
     if (this->branchHasChild(*node, child_idx)) {
       PointT voxel_center;
+      prioBranchQueueEntry& entry = search_heap[heap_size++];
 
-      search_heap[child_idx].key.x = (key.x << 1) + (!!(child_idx & (1 << 2)));
-      search_heap[child_idx].key.y = (key.y << 1) + (!!(child_idx & (1 << 1)));
-      search_heap[child_idx].key.z = (key.z << 1) + (!!(child_idx & (1 << 0)));
+      entry.key.x = (key.x << 1) + (!!(child_idx & (1 << 2)));
+      entry.key.y = (key.y << 1) + (!!(child_idx & (1 << 1)));
+      entry.key.z = (key.z << 1) + (!!(child_idx & (1 << 0)));
 
       // generate voxel center point for voxel at key
-      this->genVoxelCenterFromOctreeKey(
-          search_heap[child_idx].key, tree_depth, voxel_center);
+      this->genVoxelCenterFromOctreeKey(entry.key, tree_depth, voxel_center);
 
       // generate new priority queue element
-      search_heap[child_idx].node = this->getBranchChildPtr(*node, child_idx);
-      search_heap[child_idx].point_distance = pointSquaredDist(voxel_center, point);
-    }
-    else {
-      search_heap[child_idx].point_distance = std::numeric_limits<float>::infinity();
+      entry.node = this->getBranchChildPtr(*node, child_idx);
+      entry.point_distance = pointSquaredDist(voxel_center, point);
     }
   }
 
-  std::sort(search_heap.begin(), search_heap.end());
+  std::sort(search_heap.begin(), search_heap.begin() + heap_size);
 
   // iterate over all children in priority queue
   // check if the distance to search candidate is smaller than the best point distance
-  // (smallest_squared_dist)
-  while ((!search_heap.empty()) &&
-         (search_heap.back().point_distance <
-          smallest_squared_dist + voxelSquaredDiameter / 4.0 +
-              sqrt(smallest_squared_dist * voxelSquaredDiameter) - this->epsilon_)) {
+  // (smallest_squared_dist), shrunk by the error bound of approximate searches
+  const double approx_scale = 1.0 / ((1.0 + approx_epsilon_) * (1.0 + approx_epsilon_));
+  double pruning_squared_dist = smallest_squared_dist * approx_scale;
+  while ((heap_size > 0) &&
+         (search_heap[heap_size - 1].point_distance <
+          pruning_squared_dist + voxelSquaredDiameter / 4.0 +
+              sqrt(pruning_squared_dist * voxelSquaredDiameter) - this->epsilon_)) {
+    if (point_candidates.size() == K && isBudgetExhausted(budget))
+      break;
+
     const OctreeNode* child_node;
 
     // read from priority queue element
-    child_node = search_heap.back().node;
-    new_key = search_heap.back().key;
+    child_node = search_heap[heap_size - 1].node;
+    new_key = search_heap[heap_size - 1].key;
 
     if (tree_depth < this->octree_depth_) {
       // we have not reached maximum tree depth
@@ -286,7 +383,8 @@ OctreePointCloudSearch<PointT, LeafContainerT, BranchContainerT>::
                                        new_key,
                                        tree_depth + 1,
                                        smallest_squared_dist,
-                                       point_candidates);
+                                       point_candidates,
+                                       budget);
     }
     else {
       // we reached leaf node level
@@ -296,6 +394,8 @@ OctreePointCloudSearch<PointT, LeafContainerT, BranchContainerT>::
 
       // decode leaf node into decoded_point_vector
       (*child_leaf)->getPointIndices(decoded_point_vector);
+      ++budget.leaf_checks;
+      budget.candidates += decoded_point_vector.size();
 
       // Linearly iterate over all decoded (unsorted) points
       for (const int& point_index : decoded_point_vector) {
@@ -323,8 +423,9 @@ OctreePointCloudSearch<PointT, LeafContainerT, BranchContainerT>::
       if (point_candidates.size() == K)
         smallest_squared_dist = point_candidates.back().point_distance_;
     }
+    pruning_squared_dist = smallest_squared_dist * approx_scale;
     // pop element from priority queue
-    search_heap.pop_back();
+    --heap_size;
   }
 
   return (smallest_squared_dist);
@@ -340,15 +441,22 @@ OctreePointCloudSearch<PointT, LeafContainerT, BranchContainerT>::
                                       unsigned int tree_depth,
                                       std::vector<int>& k_indices,
                                       std::vector<float>& k_sqr_distances,
-                                      unsigned int max_nn) const
+                                      unsigned int max_nn,
+                                      SearchBudget& budget) const
 {
   // get spatial voxel information
   double voxel_squared_diameter = this->getVoxelSquaredDiameter(tree_depth);
 
+  // approximate searches skip the voxels farther away than radius / (1 + epsilon)
+  const double pruning_radius_squared =
+      radiusSquared / ((1.0 + approx_epsilon_) * (1.0 + approx_epsilon_));
+
   // iterate over all children
   for (unsigned char child_idx = 0; child_idx < 8; child_idx++) {
     if (!this->branchHasChild(*node, child_idx))
       continue;
+    if (isBudgetExhausted(budget))
+      return;
 
     const OctreeNode* child_node;
     child_node = this->getBranchChildPtr(*node, child_idx);
@@ -370,8 +478,8 @@ OctreePointCloudSearch<PointT, LeafContainerT, BranchContainerT>::
 
     // if distance is smaller than search radius
     if (squared_dist + this->epsilon_ <=
-        voxel_squared_diameter / 4.0 + radiusSquared +
-            sqrt(voxel_squared_diameter * radiusSquared)) {
+        voxel_squared_diameter / 4.0 + pruning_radius_squared +
+            sqrt(voxel_squared_diameter * pruning_radius_squared)) {
 
       if (tree_depth < this->octree_depth_) {
         // we have not reached maximum tree depth
@@ -382,7 +490,8 @@ OctreePointCloudSearch<PointT, LeafContainerT, BranchContainerT>::
                                           tree_depth + 1,
                                           k_indices,
                                           k_sqr_distances,
-                                          max_nn);
+                                          max_nn,
+                                          budget);
         if (max_nn != 0 && k_indices.size() == static_cast<unsigned int>(max_nn))
           return;
       }
@@ -393,6 +502,8 @@ OctreePointCloudSearch<PointT, LeafContainerT, BranchContainerT>::
 
         // decode leaf node into decoded_point_vector
         (*child_leaf)->getPointIndices(decoded_point_vector);
+        ++budget.leaf_checks;
+        budget.candidates += decoded_point_vector.size();
 
         // Linearly iterate over all decoded (unsorted) points
         for (const int& index : decoded_point_vector) {
@@ -506,6 +617,47 @@ OctreePointCloudSearch<PointT, LeafContainerT, BranchContainerT>::
   }
 }
 
+template <typename PointT, typename LeafContainerT, typename BranchContainerT>
+std::vector<int>
+OctreePointCloudSearch<PointT, LeafContainerT, BranchContainerT>::getQueryOrder(
+    const PointCloud& cloud, const std::vector<int>& indices) const
+{
+  const std::size_t nr_queries = indices.empty() ? cloud.size() : indices.size();
+
+  std::vector<int> query_order(nr_queries);
+  std::iota(query_order.begin(), query_order.end(), 0);
+
+  // generate keys clamped to the octree bounds, invalid points are placed in front
+  std::vector<OctreeKey> keys(nr_queries);
+  std::vector<char> valid(nr_queries);
+  const double max_key = static_cast<double>(this->max_key_.x);
+
+  for (std::size_t i = 0; i < nr_queries; ++i) {
+    const PointT& point = cloud[indices.empty() ? i : indices[i]];
+    valid[i] = isFinite(point);
+    if (!valid[i])
+      continue;
+
+    const double coords[3] = {(point.x - this->min_x_) / this->resolution_,
+                              (point.y - this->min_y_) / this->resolution_,
+                              (point.z - this->min_z_) / this->resolution_};
+    unsigned int key_values[3];
+    for (int d = 0; d < 3; ++d)
+      key_values[d] =
+          static_cast<unsigned int>(std::min(std::max(coords[d], 0.0), max_key));
+
+    keys[i] = OctreeKey(key_values[0], key_values[1], key_values[2]);
+  }
+
+  std::stable_sort(query_order.begin(), query_order.end(), [&](int a, int b) {
+    if (valid[a] != valid[b])
+      return !valid[a];
+    return keys[a].isMortonOrderLess(keys[b]);
+  });
+
+  return (query_order);
+}
+
 template <typename PointT, typename LeafContainerT, typename BranchContainerT>
 float
 OctreePointCloudSearch<PointT, LeafContainerT, BranchContainerT>::pointSquaredDist(
@@ -659,6 +811,39 @@ OctreePointCloudSearch<PointT, LeafContainerT, BranchContainerT>::
   return (0);
 }
 
+template <typename PointT, typename LeafContainerT, typename BranchContainerT>
+void
+OctreePointCloudSearch<PointT, LeafContainerT, BranchContainerT>::
+    getIntersectedVoxelCenters(const std::vector<Eigen::Vector3f>& origins,
+                               const std::vector<Eigen::Vector3f>& directions,
+                               std::vector<AlignedPointTVector>& voxel_center_lists,
+                               int max_voxel_count) const
+{
+  assert(origins.size() == directions.size());
+  voxel_center_lists.resize(origins.size());
+
+#pragma omp parallel for schedule(dynamic, 256) num_threads(this->threads_)
+  for (std::ptrdiff_t i = 0; i < static_cast<std::ptrdiff_t>(origins.size()); ++i)
+    getIntersectedVoxelCenters(
+        origins[i], directions[i], voxel_center_lists[i], max_voxel_count);
+}
+
+template <typename PointT, typename LeafContainerT, typename BranchContainerT>
+void
+OctreePointCloudSearch<PointT, LeafContainerT, BranchContainerT>::
+    getIntersectedVoxelIndices(const std::vector<Eigen::Vector3f>& origins,
+                               const std::vector<Eigen::Vector3f>& directions,
+                               std::vector<std::vector<int>>& k_indices,
+                               int max_voxel_count) const
+{
+  assert(origins.size() == directions.size());
+  k_indices.resize(origins.size());
+
+#pragma omp parallel for schedule(dynamic, 256) num_threads(this->threads_)
+  for (std::ptrdiff_t i = 0; i < static_cast<std::ptrdiff_t>(origins.size()); ++i)
+    getIntersectedVoxelIndices(origins[i], directions[i], k_indices[i], max_voxel_count);
+}
+
 template <typename PointT, typename LeafContainerT, typename BranchContainerT>
 int
 OctreePointCloudSearch<PointT, LeafContainerT, BranchContainerT>::
@@ -45,6 +45,7 @@
 #include <pcl/octree/octree_pointcloud_adjacency.h>
 #include <pcl/octree/octree_pointcloud_changedetector.h>
 #include <pcl/octree/octree_pointcloud_density.h>
+#include <pcl/octree/octree_pointcloud_insertion_queue.h>
 #include <pcl/octree/octree_pointcloud_occupancy.h>
 #include <pcl/octree/octree_pointcloud_pointvector.h>
 #include <pcl/octree/octree_pointcloud_singlepoint.h>
@@ -344,6 +344,7 @@ public:
   , max_key_(source.max_key_)
   , buffer_selector_(source.buffer_selector_)
   , tree_dirty_flag_(source.tree_dirty_flag_)
+  , reused_branches_valid_(false)
   , octree_depth_(source.octree_depth_)
   , dynamic_depth_enabled_(source.dynamic_depth_enabled_)
   {}
@@ -359,6 +360,8 @@ public:
     max_key_ = source.max_key_;
     buffer_selector_ = source.buffer_selector_;
     tree_dirty_flag_ = source.tree_dirty_flag_;
+    reused_branches_.clear();
+    reused_branches_valid_ = false;
     octree_depth_ = source.octree_depth_;
     dynamic_depth_enabled_ = source.dynamic_depth_enabled_;
     return (*this);
@@ -452,6 +455,8 @@ public:
   deletePreviousBuffer()
   {
     treeCleanUpRecursive(root_node_);
+    reused_branches_.clear();
+    reused_branches_valid_ = true;
   }
 
   /** \brief Delete the octree structure in the current buffer. */
@@ -461,6 +466,8 @@ public:
     buffer_selector_ = !buffer_selector_;
     treeCleanUpRecursive(root_node_);
     leaf_count_ = 0;
+    reused_branches_.clear();
+    reused_branches_valid_ = false;
   }
 
   /** \brief Switch buffers and reset current octree structure. */
@@ -601,6 +608,9 @@ protected:
 
       // we changed the octree structure -> dirty
       tree_dirty_flag_ = true;
+
+      // deleted branches might still be listed as reused
+      reused_branches_valid_ = false;
     }
   }
 
@@ -793,6 +803,15 @@ protected:
     }
   }
 
+  /** \brief Create a new branch node that is not yet linked into the octree
+   *  \return pointer to new branch node
+   */
+  inline BranchNode*
+  createBranch()
+  {
+    return new BranchNode();
+  }
+
   /** \brief Fetch and add a new branch child to a branch class in current buffer
    *  \param branch_arg: reference to octree branch class
    *  \param child_idx_arg: index to child node
@@ -952,6 +971,30 @@ protected:
   void
   treeCleanUpRecursive(BranchNode* branch_arg);
 
+  /** \brief Remove the unused branch and leaf nodes of the previous buffer. Only the
+   * root and the branches taken over from the previous buffer can own such nodes, so
+   * unless the list of taken over branches is incomplete, the tree is not traversed.
+   **/
+  void
+  treeCleanUp();
+
+  /** \brief Remove the children of the previous buffer that are not referenced by the
+   * current buffer of a branch node.
+   *  \param branch_arg: branch node to clean up
+   **/
+  inline void
+  branchCleanUp(BranchNode& branch_arg)
+  {
+    const char unused_branches_bit_pattern =
+        getBranchBitPattern(branch_arg, !buffer_selector_) &
+        ~getBranchBitPattern(branch_arg, buffer_selector_);
+
+    if (unused_branches_bit_pattern)
+      for (unsigned char child_idx = 0; child_idx < 8; child_idx++)
+        if (unused_branches_bit_pattern & (1 << child_idx))
+          deleteBranchChild(branch_arg, !buffer_selector_, child_idx);
+  }
+
   /** \brief Helper function to calculate the binary logarithm
    * \param n_arg: some value
    * \return binary logarithm (log2) of argument n_arg
@@ -1012,6 +1055,14 @@ protected:
   // flags indicating if unused branches and leafs might exist in previous buffer
   bool tree_dirty_flag_;
 
+  /** \brief Branches of the current buffer that were taken over from the previous
+   * buffer since the last clean-up */
+  std::vector<BranchNode*> reused_branches_;
+
+  /** \brief Whether reused_branches_ lists all branches taken over from the previous
+   * buffer, otherwise the clean-up traverses the whole tree */
+  bool reused_branches_valid_;
+
   /** \brief Octree depth */
   unsigned int octree_depth_;
 
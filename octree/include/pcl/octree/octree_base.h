@@ -41,6 +41,7 @@
 #include <pcl/octree/octree_container.h>
 #include <pcl/octree/octree_iterator.h>
 #include <pcl/octree/octree_key.h>
+#include <pcl/octree/octree_node_pool.h>
 #include <pcl/octree/octree_nodes.h>
 #include <pcl/pcl_macros.h>
 
@@ -49,19 +50,43 @@
 namespace pcl {
 namespace octree {
 
+namespace detail {
+/** \brief Heap memory owned by a node container, 0 for containers that do not
+ * implement getDynamicMemoryUsage (e.g. plain integral types). */
+template <typename ContainerT>
+auto
+getContainerMemoryUsage(const ContainerT& container, int)
+    -> decltype(container.getDynamicMemoryUsage())
+{
+  return container.getDynamicMemoryUsage();
+}
+
+template <typename ContainerT>
+std::size_t
+getContainerMemoryUsage(const ContainerT&, long)
+{
+  return 0;
+}
+} // namespace detail
+
 /** \brief Octree class
  * \note The tree depth defines the maximum amount of octree voxels / leaf nodes (should
  * be initially defined).
  * \note All leaf nodes are addressed by integer indices.
  * \note The tree depth equates to the bit length of the voxel indices.
+ * \note NodeAllocatorT creates and destroys the branch and leaf nodes. The default
+ * OctreeNodeHeapAllocator creates every node on the heap, OctreeNodeArena places them
+ * in contiguous blocks, which makes building and destroying large trees considerably
+ * faster.
  * \ingroup octree
  * \author Julius Kammerl (julius@kammerl.de)
  */
 template <typename LeafContainerT = int,
-          typename BranchContainerT = OctreeContainerEmpty>
+          typename BranchContainerT = OctreeContainerEmpty,
+          template <typename> class NodeAllocatorT = OctreeNodeHeapAllocator>
 class OctreeBase {
 public:
-  using OctreeT = OctreeBase<LeafContainerT, BranchContainerT>;
+  using OctreeT = OctreeBase<LeafContainerT, BranchContainerT, NodeAllocatorT>;
 
   using BranchNode = OctreeBranchNode<BranchContainerT>;
   using LeafNode = OctreeLeafNode<LeafContainerT>;
@@ -74,6 +99,12 @@ protected:
   // Members
   ///////////////////////////////////////////////////////////////////////
 
+  /** \brief Allocator for branch nodes   **/
+  NodeAllocatorT<BranchNode> branch_allocator_;
+
+  /** \brief Allocator for leaf nodes   **/
+  NodeAllocatorT<LeafNode> leaf_allocator_;
+
   /** \brief Amount of leaf nodes   **/
   std::size_t leaf_count_;
 
@@ -237,22 +268,27 @@ public:
   OctreeBase(const OctreeBase& source)
   : leaf_count_(source.leaf_count_)
   , branch_count_(source.branch_count_)
-  , root_node_(new (BranchNode)(*(source.root_node_)))
+  , root_node_(branch_allocator_.allocate())
   , depth_mask_(source.depth_mask_)
   , octree_depth_(source.octree_depth_)
   , dynamic_depth_enabled_(source.dynamic_depth_enabled_)
   , max_key_(source.max_key_)
-  {}
+  {
+    copyBranch(*source.root_node_, *root_node_);
+  }
 
   /** \brief Copy operator. */
   OctreeBase&
   operator=(const OctreeBase& source)
   {
+    if (this == &source)
+      return (*this);
+
     leaf_count_ = source.leaf_count_;
     branch_count_ = source.branch_count_;
-    delete root_node_;
+    deleteBranch(*root_node_);
 
-    root_node_ = new (BranchNode)(*(source.root_node_));
+    copyBranch(*source.root_node_, *root_node_);
     depth_mask_ = source.depth_mask_;
     max_key_ = source.max_key_;
     octree_depth_ = source.octree_depth_;
@@ -338,6 +374,21 @@ public:
     return branch_count_;
   }
 
+  /** \brief Return the memory used by the octree, including the nodes, the memory
+   * held by the node allocators and the dynamic memory of all containers.
+   *  \return memory in bytes.
+   */
+  std::size_t
+  getMemoryUsage() const
+  {
+    std::size_t memory = sizeof(*this) +
+                         branch_allocator_.getMemoryUsage(branch_count_) +
+                         leaf_allocator_.getMemoryUsage(leaf_count_);
+    if (root_node_)
+      memory += getBranchMemoryUsage(*root_node_);
+    return memory;
+  }
+
   /** \brief Delete the octree structure and its leaf nodes.
    */
   void
@@ -524,12 +575,12 @@ protected:
         // free child branch recursively
         deleteBranch(*static_cast<BranchNode*>(branch_child));
         // delete branch node
-        delete branch_child;
+        branch_allocator_.deallocate(static_cast<BranchNode*>(branch_child));
       } break;
 
       case LEAF_NODE: {
         // delete leaf node
-        delete branch_child;
+        leaf_allocator_.deallocate(static_cast<LeafNode*>(branch_child));
         break;
       }
       default:
@@ -552,6 +603,61 @@ protected:
       deleteBranchChild(branch_arg, i);
   }
 
+  /** \brief Copy the children and containers of a branch into an empty branch
+   *  \param source_arg: branch to be copied
+   *  \param target_arg: branch without children that receives the copy
+   */
+  void
+  copyBranch(const BranchNode& source_arg, BranchNode& target_arg)
+  {
+    target_arg.getContainer() = source_arg.getContainer();
+
+    for (unsigned char i = 0; i < 8; i++) {
+      const OctreeNode* child = source_arg.getChildPtr(i);
+      if (!child)
+        continue;
+
+      if (child->getNodeType() == BRANCH_NODE)
+        copyBranch(*static_cast<const BranchNode*>(child),
+                   *createBranchChild(target_arg, i));
+      else
+        createLeafChild(target_arg, i)->getContainer() =
+            static_cast<const LeafNode*>(child)->getContainer();
+    }
+  }
+
+  /** \brief Sum up the dynamic memory of all containers below a branch
+   *  \param branch_arg: branch to start from
+   *  \return memory in bytes
+   */
+  std::size_t
+  getBranchMemoryUsage(const BranchNode& branch_arg) const
+  {
+    std::size_t memory = detail::getContainerMemoryUsage(branch_arg.getContainer(), 0);
+
+    for (unsigned char i = 0; i < 8; i++) {
+      const OctreeNode* child = branch_arg.getChildPtr(i);
+      if (!child)
+        continue;
+
+      if (child->getNodeType() == BRANCH_NODE)
+        memory += getBranchMemoryUsage(*static_cast<const BranchNode*>(child));
+      else
+        memory += detail::getContainerMemoryUsage(
+            static_cast<const LeafNode*>(child)->getContainer(), 0);
+    }
+    return memory;
+  }
+
+  /** \brief Create a new branch node that is not yet linked into the octree
+   *  \return pointer to new branch node
+   */
+  BranchNode*
+  createBranch()
+  {
+    return branch_allocator_.allocate();
+  }
+
   /** \brief Create and add a new branch child to a branch class
    *  \param branch_arg: reference to octree branch class
    *  \param child_idx_arg: index to child node
@@ -560,7 +666,7 @@ protected:
   BranchNode*
   createBranchChild(BranchNode& branch_arg, unsigned char child_idx_arg)
   {
-    BranchNode* new_branch_child = new BranchNode();
+    BranchNode* new_branch_child = branch_allocator_.allocate();
     branch_arg[child_idx_arg] = static_cast<OctreeNode*>(new_branch_child);
 
     return new_branch_child;
@@ -574,7 +680,7 @@ protected:
   LeafNode*
   createLeafChild(BranchNode& branch_arg, unsigned char child_idx_arg)
   {
-    LeafNode* new_leaf_child = new LeafNode();
+    LeafNode* new_leaf_child = leaf_allocator_.allocate();
     branch_arg[child_idx_arg] = static_cast<OctreeNode*>(new_leaf_child);
 
     return new_leaf_child;
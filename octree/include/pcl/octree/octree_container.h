@@ -84,6 +84,16 @@ public:
   virtual void
   reset() = 0;
 
+  /** \brief Get the heap memory owned by the container, excluding sizeof the
+   * container itself.
+   * \return memory in bytes
+   */
+  std::size_t
+  getDynamicMemoryUsage() const
+  {
+    return 0u;
+  }
+
   /** \brief Empty addPointIndex implementation. This leaf node does not store any point
    * indices.
    */
@@ -327,6 +337,15 @@ public:
     leafDataTVector_.clear();
   }
 
+  /** \brief Get the heap memory owned by the point indices vector.
+   * \return memory in bytes
+   */
+  std::size_t
+  getDynamicMemoryUsage() const
+  {
+    return leafDataTVector_.capacity() * sizeof(int);
+  }
+
 protected:
   /** \brief Leaf node DataT vector. */
   std::vector<int> leafDataTVector_;
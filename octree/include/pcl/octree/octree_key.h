@@ -105,6 +105,33 @@ public:
     return ((b.x <= this->x) && (b.y <= this->y) && (b.z <= this->z));
   }
 
+  /** \brief Compare octree keys along the depth first order of the octree (Morton
+   * order with x as the most significant bit of every level).
+   *  \return "true" if the voxel of this key is visited before the voxel of b ; "false"
+   * otherwise.
+   * */
+  bool
+  isMortonOrderLess(const OctreeKey& b) const
+  {
+    const auto less_msb = [](std::uint32_t lhs, std::uint32_t rhs) {
+      return (lhs < rhs) && (lhs < (lhs ^ rhs));
+    };
+
+    // the dimension with the most significant differing bit decides
+    std::uint32_t a_coord = this->x, b_coord = b.x;
+    std::uint32_t diff = a_coord ^ b_coord;
+    if (less_msb(diff, this->y ^ b.y)) {
+      a_coord = this->y;
+      b_coord = b.y;
+      diff = a_coord ^ b_coord;
+    }
+    if (less_msb(diff, this->z ^ b.z)) {
+      a_coord = this->z;
+      b_coord = b.z;
+    }
+    return (a_coord < b_coord);
+  }
+
   /** \brief push a child node to the octree key
    *  \param[in] childIndex index of child node to be added (0-7)
    * */
@@ -37,8 +37,12 @@
 
 #pragma once
 
+#include <pcl/memory.h>
 #include <pcl/pcl_macros.h>
 
+#include <cstddef>
+#include <new>
+#include <type_traits>
 #include <vector>
 
 namespace pcl {
@@ -108,5 +112,131 @@ protected:
   std::vector<NodeT*> nodePool_;
 };
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/** \brief @b Octree node allocator that creates every node on the heap
+ * \note Default node allocator of OctreeBase
+ */
+template <typename NodeT>
+class OctreeNodeHeapAllocator {
+public:
+  /** \brief Create a new default constructed node
+   *  \return Pointer to octree node
+   *  */
+  inline NodeT*
+  allocate()
+  {
+    return new NodeT();
+  }
+
+  /** \brief Destroy a node that was created by this allocator
+   *  \param node_arg: node to be destroyed
+   *  */
+  inline void
+  deallocate(NodeT* node_arg)
+  {
+    delete node_arg;
+  }
+
+  /** \brief Get the heap memory held by this allocator
+   *  \param nr_nodes_arg: number of nodes currently allocated
+   *  \return memory in bytes
+   *  */
+  std::size_t
+  getMemoryUsage(std::size_t nr_nodes_arg) const
+  {
+    return nr_nodes_arg * sizeof(NodeT);
+  }
+};
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/** \brief @b Octree node allocator that places nodes in contiguous blocks
+ * \note Nodes are constructed in blocks of block_size_arg nodes. Released nodes are
+ * destroyed and their memory is reused by later allocations, the blocks themselves are
+ * only returned when the allocator is destroyed. This avoids one heap allocation per
+ * node when octrees with millions of nodes are built and destroyed.
+ * \note All nodes have to be released before the allocator is destroyed.
+ */
+template <typename NodeT>
+class OctreeNodeArena {
+public:
+  /** \brief Constructor.
+   *  \param block_size_arg: number of nodes per memory block
+   *  */
+  explicit OctreeNodeArena(std::size_t block_size_arg = 4096)
+  : block_size_(block_size_arg > 0 ? block_size_arg : 1)
+  , block_fill_(block_size_)
+  {}
+
+  OctreeNodeArena(const OctreeNodeArena&) = delete;
+
+  OctreeNodeArena&
+  operator=(const OctreeNodeArena&) = delete;
+
+  /** \brief Destructor, returns all memory blocks. */
+  ~OctreeNodeArena()
+  {
+    for (NodeStorage* block : blocks_)
+      Eigen::aligned_allocator<NodeStorage>().deallocate(block, block_size_);
+  }
+
+  /** \brief Create a new default constructed node
+   *  \return Pointer to octree node
+   *  */
+  inline NodeT*
+  allocate()
+  {
+    void* slot;
+    if (!free_slots_.empty()) {
+      slot = free_slots_.back();
+      free_slots_.pop_back();
+    }
+    else {
+      if (block_fill_ == block_size_) {
+        blocks_.push_back(Eigen::aligned_allocator<NodeStorage>().allocate(block_size_));
+        block_fill_ = 0;
+      }
+      slot = blocks_.back() + block_fill_++;
+    }
+    return new (slot) NodeT();
+  }
+
+  /** \brief Destroy a node that was created by this allocator
+   *  \param node_arg: node to be destroyed
+   *  */
+  inline void
+  deallocate(NodeT* node_arg)
+  {
+    node_arg->~NodeT();
+    free_slots_.push_back(node_arg);
+  }
+
+  /** \brief Get the heap memory held by this allocator
+   *  \note Includes released slots, the blocks are kept until destruction.
+   *  \return memory in bytes
+   *  */
+  std::size_t
+  getMemoryUsage(std::size_t /*nr_nodes_arg*/) const
+  {
+    return blocks_.size() * block_size_ * sizeof(NodeStorage) +
+           blocks_.capacity() * sizeof(NodeStorage*) +
+           free_slots_.capacity() * sizeof(void*);
+  }
+
+protected:
+  using NodeStorage = typename std::aligned_storage<sizeof(NodeT), alignof(NodeT)>::type;
+
+  /** \brief Number of nodes per block */
+  std::size_t block_size_;
+
+  /** \brief Number of used nodes in the last block */
+  std::size_t block_fill_;
+
+  /** \brief Memory blocks */
+  std::vector<NodeStorage*> blocks_;
+
+  /** \brief Released node memory available for reuse */
+  std::vector<void*> free_slots_;
+};
+
 } // namespace octree
 } // namespace pcl
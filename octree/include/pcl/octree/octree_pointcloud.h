@@ -39,6 +39,7 @@
 #pragma once
 
 #include <pcl/octree/octree_base.h>
+#include <pcl/octree/octree_pointcloud_insertion_queue.h>
 #include <pcl/point_cloud.h>
 #include <pcl/point_types.h>
 
@@ -189,10 +190,24 @@ public:
     return this->octree_depth_;
   }
 
-  /** \brief Add points from input point cloud to octree. */
+  /** \brief Add points from input point cloud to octree.
+   * \note Unless dynamic depth is enabled, the keys of all points are generated first
+   * (in parallel, see setNumberOfThreads) and the points are sorted along the depth first
+   * order of the octree, so that every leaf node is only looked up once. Points within a
+   * voxel are added in the order of the input cloud or indices.
+   */
   void
   addPointsFromInputCloud();
 
+  /** \brief Set the number of threads used to generate octree keys in
+   * addPointsFromInputCloud, and by the derived octrees (e.g. for batch searches or
+   * centroid extraction).
+   * \param[in] nr_threads the number of hardware threads to use (0 sets the value back
+   * to automatic)
+   */
+  void
+  setNumberOfThreads(unsigned int nr_threads = 0);
+
   /** \brief Add point at given index from input point cloud to octree. Index will be
    * also added to indices vector.
    * \param[in] point_idx_arg index of point to be added
@@ -223,6 +238,21 @@ public:
                   PointCloudPtr cloud_arg,
                   IndicesPtr indices_arg);
 
+  /** \brief Add all points of an insertion queue simultaneously to octree and input
+   * point cloud. The queue may be filled from several threads, but the octree is only
+   * modified by the thread calling this method, in the order the batches were queued.
+   * \param[in] queue_arg queue to take the points from, it is left empty
+   * \param[in] cloud_arg pointer to input point cloud dataset (given by \a
+   * setInputCloud)
+   * \param[in] indices_arg pointer to indices vector of the dataset (given by \a
+   * setInputCloud), the indices of all queued points are added to it
+   * \return number of (finite) points added to the octree
+   */
+  std::size_t
+  addPointsFromQueue(OctreePointCloudInsertionQueue<PointT>& queue_arg,
+                     PointCloudPtr cloud_arg,
+                     IndicesPtr indices_arg = IndicesPtr());
+
   /** \brief Check if voxel at given point exist.
    * \param[in] point_arg point to be checked
    * \return "true" if voxel exist; "false" otherwise
@@ -430,6 +460,26 @@ protected:
   virtual void
   addPointIdx(const int point_idx_arg);
 
+  /** \brief Add points at the given indices to the octree, grouped by voxel. The
+   * bounding box has to contain all of the points already.
+   * \param[in] indices_arg indices of finite points in the dataset given by \a
+   * setInputCloud
+   */
+  void
+  addPointIndicesBulk(const std::vector<int>& indices_arg);
+
+  /** \brief Add point at index from input pointcloud dataset to an existing leaf
+   * container. Used by addPointIndicesBulk.
+   * \param[in] leaf_arg leaf container of the voxel the point falls into
+   * \param[in] point_idx_arg the index representing the point in the dataset given by
+   * \a setInputCloud
+   */
+  virtual void
+  addPointIdxToLeaf(LeafContainerT& leaf_arg, const int point_idx_arg)
+  {
+    leaf_arg.addPointIndex(point_idx_arg);
+  }
+
   /** \brief Add point at index from input pointcloud dataset to octree
    * \param[in] leaf_node to be expanded
    * \param[in] parent_branch parent of leaf node to be expanded
@@ -496,7 +546,7 @@ protected:
    * \param[in] point_arg the point addressing a voxel
    * \param[out] key_arg write octree key to this reference
    */
-  void
+  virtual void
   genOctreeKeyforPoint(const PointT& point_arg, OctreeKey& key_arg) const;
 
   /** \brief Generate octree key for voxel at a given point
@@ -597,6 +647,9 @@ protected:
    *  \note zero indicates a fixed/maximum depth octree structure
    * **/
   std::size_t max_objs_per_leaf_;
+
+  /** \brief The number of threads to use. */
+  unsigned int threads_;
 };
 
 } // namespace octree
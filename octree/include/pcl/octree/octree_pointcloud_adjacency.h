@@ -139,6 +139,10 @@ public:
   OctreePointCloudAdjacency(const double resolution_arg);
 
   /** \brief Adds points from cloud to the octree.
+   *
+   * The bounding box, the leaf data (LeafContainerT::computeData) and the neighbors of
+   * the leaves are computed in parallel, see setNumberOfThreads. The transform function
+   * and computeData must then be safe to call concurrently (on different leaves).
    *
    * \note This overrides addPointsFromInputCloud() from the OctreePointCloud class. */
   void
@@ -212,7 +216,19 @@ protected:
    * \param[in] point_arg Point to generate key for
    * \param[out] key_arg Resulting octree key */
   void
-  genOctreeKeyforPoint(const PointT& point_arg, OctreeKey& key_arg) const;
+  genOctreeKeyforPoint(const PointT& point_arg, OctreeKey& key_arg) const override;
+
+  /** \brief Add point at index from input pointcloud dataset to an existing leaf
+   * container.
+   *
+   * \param[in] leaf_arg leaf container of the voxel the point falls into
+   * \param[in] point_idx_arg The index representing the point in the dataset given by
+   * setInputCloud() */
+  void
+  addPointIdxToLeaf(LeafContainerT& leaf_arg, const int point_idx_arg) override
+  {
+    leaf_arg.addPoint((*this->input_)[point_idx_arg]);
+  }
 
 private:
   /** \brief Add point at given index from input point cloud to octree.
@@ -0,0 +1,122 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#pragma once
+
+#include <pcl/point_cloud.h>
+
+#include <cstddef>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace pcl {
+namespace octree {
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/** \brief @b Octree pointcloud insertion queue
+ * \note Collects points from several producer threads (e.g. one grabber callback per
+ * sensor) for a single octree. Producers only hold the queue lock while handing over
+ * a whole batch, the points are inserted into the octree by its owner with
+ * OctreePointCloud::addPointsFromQueue, which uses the parallel bulk insertion.
+ * \tparam PointT type of point used in pointcloud
+ * \ingroup octree
+ */
+template <typename PointT>
+class OctreePointCloudInsertionQueue {
+public:
+  using PointCloud = pcl::PointCloud<PointT>;
+
+  /** \brief Empty constructor. */
+  OctreePointCloudInsertionQueue() : point_count_(0) {}
+
+  /** \brief Queue a batch of points for insertion. Thread safe.
+   * \param[in] points_arg points to be added to the octree
+   */
+  void
+  push(const PointCloud& points_arg)
+  {
+    // copy outside of the lock
+    PointCloud points = points_arg;
+    push(std::move(points));
+  }
+
+  /** \brief Queue a batch of points for insertion. Thread safe.
+   * \param[in] points_arg points to be added to the octree
+   */
+  void
+  push(PointCloud&& points_arg)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    point_count_ += points_arg.size();
+    batches_.push_back(std::move(points_arg));
+  }
+
+  /** \brief Get the number of queued points. Thread safe. */
+  std::size_t
+  size() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return (point_count_);
+  }
+
+  /** \brief Take all queued batches, in the order they were pushed, leaving the queue
+   * empty. Thread safe.
+   * \param[out] batches_arg the queued batches
+   */
+  void
+  take(std::vector<PointCloud>& batches_arg)
+  {
+    batches_arg.clear();
+    std::lock_guard<std::mutex> lock(mutex_);
+    batches_arg.swap(batches_);
+    point_count_ = 0;
+  }
+
+private:
+  /** \brief Guards the queued batches. */
+  mutable std::mutex mutex_;
+
+  /** \brief Queued batches of points. */
+  std::vector<PointCloud> batches_;
+
+  /** \brief Number of queued points. */
+  std::size_t point_count_;
+};
+
+} // namespace octree
+} // namespace pcl
@@ -175,6 +175,16 @@ public:
     container->addPoint(point);
   }
 
+  /** \brief Add point at index to an existing leaf container.
+   * \param leaf_arg
+   * \param pointIdx_arg
+   */
+  void
+  addPointIdxToLeaf(LeafContainerT& leaf_arg, const int pointIdx_arg) override
+  {
+    leaf_arg.addPoint((*this->input_)[pointIdx_arg]);
+  }
+
   /** \brief Get centroid for a single voxel addressed by a PointT point.
    * \param[in] point_arg point addressing a voxel in octree
    * \param[out] voxel_centroid_arg centroid is written to this PointT reference
@@ -198,6 +208,9 @@ public:
   }
 
   /** \brief Get PointT vector of centroids for all occupied voxels.
+   *
+   * The centroids are in the depth first order of the leaves and are computed in
+   * parallel, see setNumberOfThreads.
    * \param[out] voxel_centroid_list_arg results are written to this vector of PointT
    * elements
    * \return number of occupied voxels
@@ -220,6 +233,15 @@ public:
       OctreeKey& key_arg,
       typename OctreePointCloud<PointT, LeafContainerT, BranchContainerT>::
           AlignedPointTVector& voxel_centroid_list_arg) const;
+
+  /** \brief Recursively explore the octree and collect its leaf nodes in depth first
+   * order.
+   * \param[in] branch_arg: current branch node
+   * \param[out] leaf_list_arg the leaf nodes are appended to this vector
+   */
+  void
+  getLeafNodesRecursive(const BranchNode* branch_arg,
+                        std::vector<const LeafNode*>& leaf_list_arg) const;
 };
 } // namespace octree
 } // namespace pcl
@@ -85,6 +85,25 @@ public:
   : OctreePointCloud<PointT, LeafContainerT, BranchContainerT>(resolution)
   {}
 
+  /** \brief Let the k-nearest neighbor and radius searches trade accuracy for speed.
+   * \param[in] epsilon relative error bound: voxels farther away from the query than
+   * the current k-th neighbor (or the radius) divided by (1 + epsilon) are skipped
+   * \param[in] max_leaf_checks maximum number of leaf voxels visited per query, 0 for
+   * no limit
+   * \param[in] max_candidates maximum number of points whose distance to the query is
+   * computed, 0 for no limit
+   * \note A k-nearest neighbor search only stops early once it has found k candidates.
+   */
+  void
+  setApproximateSearch(double epsilon,
+                       std::size_t max_leaf_checks = 0,
+                       std::size_t max_candidates = 0)
+  {
+    approx_epsilon_ = epsilon;
+    max_leaf_checks_ = max_leaf_checks;
+    max_candidates_ = max_candidates;
+  }
+
   /** \brief Search for neighbors within a voxel at given point
    * \param[in] point point addressing a leaf node voxel
    * \param[out] point_idx_data the resultant indices of the neighboring voxel points
@@ -117,7 +136,7 @@ public:
                  int index,
                  int k,
                  std::vector<int>& k_indices,
-                 std::vector<float>& k_sqr_distances)
+                 std::vector<float>& k_sqr_distances) const
   {
     return (nearestKSearch(cloud[index], k, k_indices, k_sqr_distances));
   }
@@ -135,7 +154,7 @@ public:
   nearestKSearch(const PointT& p_q,
                  int k,
                  std::vector<int>& k_indices,
-                 std::vector<float>& k_sqr_distances);
+                 std::vector<float>& k_sqr_distances) const;
 
   /** \brief Search for k-nearest neighbors at query point
    * \param[in] index index representing the query point in the dataset given by \a
@@ -152,7 +171,27 @@ public:
   nearestKSearch(int index,
                  int k,
                  std::vector<int>& k_indices,
-                 std::vector<float>& k_sqr_distances);
+                 std::vector<float>& k_sqr_distances) const;
+
+  /** \brief Search for k-nearest neighbors of a batch of query points.
+   * \note The queries are distributed over the number of threads given by
+   * setNumberOfThreads. They are processed in the depth first order of the octree, so
+   * that neighboring queries visit the same nodes one after the other.
+   * \param[in] cloud the point cloud data
+   * \param[in] indices the indices in \a cloud of the query points. If indices is empty,
+   * all points of \a cloud are queried.
+   * \param[in] k the number of neighbors to search for
+   * \param[out] k_indices the resultant indices of the neighboring points,
+   * k_indices[i] corresponds to the query i
+   * \param[out] k_sqr_distances the resultant squared distances to the neighboring
+   * points, k_sqr_distances[i] corresponds to the query i
+   */
+  void
+  nearestKSearch(const PointCloud& cloud,
+                 const std::vector<int>& indices,
+                 int k,
+                 std::vector<std::vector<int>>& k_indices,
+                 std::vector<std::vector<float>>& k_sqr_distances) const;
 
   /** \brief Search for approx. nearest neighbor at the query point.
    * \param[in] cloud the point cloud data
@@ -244,6 +283,30 @@ public:
                std::vector<float>& k_sqr_distances,
                unsigned int max_nn = 0) const;
 
+  /** \brief Search for all neighbors of a batch of query points that are within a given
+   * radius.
+   * \note The queries are distributed over the number of threads given by
+   * setNumberOfThreads. They are processed in the depth first order of the octree, so
+   * that neighboring queries visit the same nodes one after the other.
+   * \param[in] cloud the point cloud data
+   * \param[in] indices the indices in \a cloud of the query points. If indices is empty,
+   * all points of \a cloud are queried.
+   * \param[in] radius the radius of the sphere bounding all neighbors
+   * \param[out] k_indices the resultant indices of the neighboring points,
+   * k_indices[i] corresponds to the query i
+   * \param[out] k_sqr_distances the resultant squared distances to the neighboring
+   * points, k_sqr_distances[i] corresponds to the query i
+   * \param[in] max_nn if given, bounds the maximum returned neighbors per query to this
+   * value
+   */
+  void
+  radiusSearch(const PointCloud& cloud,
+               const std::vector<int>& indices,
+               const double radius,
+               std::vector<std::vector<int>>& k_indices,
+               std::vector<std::vector<float>>& k_sqr_distances,
+               unsigned int max_nn = 0) const;
+
   /** \brief Get a PointT vector of centers of all voxels that intersected by a ray
    * (origin, direction).
    * \param[in] origin ray origin
@@ -273,6 +336,42 @@ public:
                              std::vector<int>& k_indices,
                              int max_voxel_count = 0) const;
 
+  /** \brief Get the centers of the voxels intersected by each ray of a batch
+   * (origins[i], directions[i]).
+   * \note The rays are distributed over the number of threads given by
+   * setNumberOfThreads. Use max_voxel_count = 1 to stop each ray at its first occupied
+   * voxel.
+   * \param[in] origins ray origins
+   * \param[in] directions ray direction vectors, one per origin
+   * \param[out] voxel_center_lists the voxel centers intersected by each ray,
+   * voxel_center_lists[i] corresponds to the ray i
+   * \param[in] max_voxel_count stop raycasting when this many voxels intersected (0:
+   * disable)
+   */
+  void
+  getIntersectedVoxelCenters(const std::vector<Eigen::Vector3f>& origins,
+                             const std::vector<Eigen::Vector3f>& directions,
+                             std::vector<AlignedPointTVector>& voxel_center_lists,
+                             int max_voxel_count = 0) const;
+
+  /** \brief Get the point indices of the voxels intersected by each ray of a batch
+   * (origins[i], directions[i]).
+   * \note The rays are distributed over the number of threads given by
+   * setNumberOfThreads. Use max_voxel_count = 1 to stop each ray at its first occupied
+   * voxel.
+   * \param[in] origins ray origins
+   * \param[in] directions ray direction vectors, one per origin
+   * \param[out] k_indices the point indices from the voxels intersected by each ray,
+   * k_indices[i] corresponds to the ray i
+   * \param[in] max_voxel_count stop raycasting when this many voxels intersected (0:
+   * disable)
+   */
+  void
+  getIntersectedVoxelIndices(const std::vector<Eigen::Vector3f>& origins,
+                             const std::vector<Eigen::Vector3f>& directions,
+                             std::vector<std::vector<int>>& k_indices,
+                             int max_voxel_count = 0) const;
+
   /** \brief Search for points within rectangular search area
    * Points exactly on the edges of the search rectangle are included.
    * \param[in] min_pt lower corner of search area
@@ -361,6 +460,32 @@ protected:
     float point_distance_;
   };
 
+  /** \brief Search for k-nearest neighbors at given query point, using a caller
+   * provided candidate buffer.
+   * \param[in] p_q the given query point
+   * \param[in] k the number of neighbors to search for
+   * \param[in,out] point_candidates scratch buffer for the neighbor candidates
+   * \param[out] k_indices the resultant indices of the neighboring points
+   * \param[out] k_sqr_distances the resultant squared distances to the neighboring
+   * points
+   * \return number of neighbors found
+   */
+  int
+  nearestKSearch(const PointT& p_q,
+                 int k,
+                 std::vector<prioPointQueueEntry>& point_candidates,
+                 std::vector<int>& k_indices,
+                 std::vector<float>& k_sqr_distances) const;
+
+  /** \brief Order a batch of query points along the depth first traversal of the
+   * octree (Morton order of the voxel keys). Invalid points come first.
+   * \param[in] cloud the point cloud data
+   * \param[in] indices the indices in \a cloud of the query points, all points if empty
+   * \return the positions of the queries in \a indices (or \a cloud), in search order
+   */
+  std::vector<int>
+  getQueryOrder(const PointCloud& cloud, const std::vector<int>& indices) const;
+
   /** \brief Helper function to calculate the squared distance between two points
    * \param[in] point_a point A
    * \param[in] point_b point B
@@ -369,6 +494,20 @@ protected:
   float
   pointSquaredDist(const PointT& point_a, const PointT& point_b) const;
 
+  /** \brief The work done so far by a single approximate search. */
+  struct SearchBudget {
+    std::size_t leaf_checks = 0;
+    std::size_t candidates = 0;
+  };
+
+  /** \brief Whether a search has used up the limits set by setApproximateSearch. */
+  inline bool
+  isBudgetExhausted(const SearchBudget& budget) const
+  {
+    return ((max_leaf_checks_ > 0 && budget.leaf_checks >= max_leaf_checks_) ||
+            (max_candidates_ > 0 && budget.candidates >= max_candidates_));
+  }
+
   //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
   // Recursive search routine methods
   //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -382,6 +521,7 @@ protected:
    * \param[out] k_indices vector of indices found to be neighbors of query point
    * \param[out] k_sqr_distances squared distances of neighbors to query point
    * \param[in] max_nn maximum of neighbors to be found
+   * \param[in,out] budget the work done so far by the search
    */
   void
   getNeighborsWithinRadiusRecursive(const PointT& point,
@@ -391,7 +531,8 @@ protected:
                                     unsigned int tree_depth,
                                     std::vector<int>& k_indices,
                                     std::vector<float>& k_sqr_distances,
-                                    unsigned int max_nn) const;
+                                    unsigned int max_nn,
+                                    SearchBudget& budget) const;
 
   /** \brief Recursive search method that explores the octree and finds the K nearest
    * neighbors
@@ -402,6 +543,7 @@ protected:
    * \param[in] tree_depth current depth/level in the octree
    * \param[in] squared_search_radius squared search radius distance
    * \param[out] point_candidates priority queue of nearest neigbor point candidates
+   * \param[in,out] budget the work done so far by the search
    * \return squared search radius based on current point candidate set found
    */
   double
@@ -412,7 +554,8 @@ protected:
       const OctreeKey& key,
       unsigned int tree_depth,
       const double squared_search_radius,
-      std::vector<prioPointQueueEntry>& point_candidates) const;
+      std::vector<prioPointQueueEntry>& point_candidates,
+      SearchBudget& budget) const;
 
   /** \brief Recursive search method that explores the octree and finds the approximate
    * nearest neighbor
@@ -649,6 +792,15 @@ protected:
       return b;
     return c;
   }
+
+  /** \brief Relative error bound of the searches, see setApproximateSearch. */
+  double approx_epsilon_ = 0.0;
+
+  /** \brief Maximum number of leaf voxels visited per query (0: no limit). */
+  std::size_t max_leaf_checks_ = 0;
+
+  /** \brief Maximum number of points whose distance is computed per query (0: no limit). */
+  std::size_t max_candidates_ = 0;
 };
 } // namespace octree
 } // namespace pcl
@@ -93,6 +93,12 @@ public:
 
     while (size + item_size >= capacity_)
     {
+      // The item does not fit into the cache at all
+      if (key_it == key_index_.end ())
+      {
+        return false;
+      }
+
       const CacheIterator cache_it = cache_.find (*key_it);
 
       // Get tail item (Least Recently Used)
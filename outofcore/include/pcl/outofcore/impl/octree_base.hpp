@@ -48,6 +48,7 @@
 
 #include <pcl/filters/random_sample.h>
 #include <pcl/filters/extract_indices.h>
+#include <pcl/io/tar.h>
 
 // C++
 #include <iostream>
@@ -55,6 +56,15 @@
 #include <sstream>
 #include <string>
 #include <exception>
+#include <random>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <unordered_set>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 namespace pcl
 {
@@ -71,6 +81,12 @@ namespace pcl
     template<typename ContainerT, typename PointT>
     const int OutofcoreOctreeBase<ContainerT, PointT>::OUTOFCORE_VERSION_ = static_cast<int>(3);
 
+    template<typename ContainerT, typename PointT>
+    const std::string OutofcoreOctreeBase<ContainerT, PointT>::NODE_INDEX_EXTENSION_ = ".oct_bin";
+
+    template<typename ContainerT, typename PointT>
+    const std::string OutofcoreOctreeBase<ContainerT, PointT>::NODE_PACK_EXTENSION_ = ".oct_pack";
+
     ////////////////////////////////////////////////////////////////////////////////
 
     template<typename ContainerT, typename PointT>
@@ -80,6 +96,7 @@ namespace pcl
       , metadata_ (new OutofcoreOctreeBaseMetadata ())
       , sample_percent_ (0.125)
       , lod_filter_ptr_ (new pcl::RandomSample<pcl::PCLPointCloud2> ())
+      , threads_ (1)
     {
       //validate the root filename
       if (!this->checkExtension (root_name))
@@ -87,11 +104,34 @@ namespace pcl
         PCL_THROW_EXCEPTION (PCLException, "[pcl::outofcore::OutofcoreOctreeBase] Bad extension. Outofcore Octrees must have a root node ending in .oct_idx\n");
       }
       
+      // Read the metadata of all nodes from the binary node index, if the tree has one
+      boost::filesystem::path index_path = root_name.parent_path () / (boost::filesystem::basename (root_name) + NODE_INDEX_EXTENSION_);
+      if (boost::filesystem::exists (index_path) && this->loadNodeIndex (index_path))
+      {
+        // The point data of packed trees is read from the pack file through the node index
+        boost::filesystem::path pack_path = root_name.parent_path () / (boost::filesystem::basename (root_name) + NODE_PACK_EXTENSION_);
+        if (boost::filesystem::exists (pack_path))
+          node_pack_path_ = pack_path;
+      }
+
       // Create root_node_node
-      root_node_ = new OutofcoreOctreeBaseNode<ContainerT, PointT> (root_name, nullptr, load_all);
+      root_node_ = new OutofcoreOctreeBaseNode<ContainerT, PointT> (root_name, nullptr, false);
       // Set root_node_nodes tree to the newly created tree
       root_node_->m_tree_ = this;
 
+      const NodeIndexEntry* root_entry = this->getNodeIndexEntry (root_node_->node_metadata_->getDirectoryPathname ());
+      if (root_entry != nullptr)
+      {
+        root_node_->indexed_children_ = root_entry->children;
+        root_node_->num_children_ = root_node_->countNumChildren ();
+        if (!node_pack_path_.empty ())
+          root_node_->payload_->openPacked (node_pack_path_, root_entry->pack_offset);
+      }
+
+      // The children are loaded once the node index is accessible through the tree
+      if (load_all)
+        root_node_->loadChildren (true);
+
       // Set the path to the outofcore octree metadata (unique to the root folder) ending in .octree
       boost::filesystem::path treepath = root_name.parent_path () / (boost::filesystem::basename (root_name) + TREE_EXTENSION_);
 
@@ -108,6 +148,7 @@ namespace pcl
       , metadata_ (new OutofcoreOctreeBaseMetadata ())
       , sample_percent_ (0.125)
       , lod_filter_ptr_ (new pcl::RandomSample<pcl::PCLPointCloud2> ())
+      , threads_ (1)
     {
       //Enlarge the bounding box to a cube so our voxels will be cubes
       Eigen::Vector3d tmp_min = min;
@@ -130,6 +171,7 @@ namespace pcl
       , metadata_ (new OutofcoreOctreeBaseMetadata ())
       , sample_percent_ (0.125)
       , lod_filter_ptr_ (new pcl::RandomSample<pcl::PCLPointCloud2> ())
+      , threads_ (1)
     {
       //Create a new outofcore tree
       this->init (max_depth, min, max, root_node_name, coord_sys);
@@ -200,6 +242,295 @@ namespace pcl
     OutofcoreOctreeBase<ContainerT, PointT>::saveToFile ()
     {
       this->metadata_->serializeMetadataToDisk ();
+
+      if (!node_index_path_.empty ())
+        this->saveNodeIndex ();
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+
+    template<typename ContainerT, typename PointT> bool
+    OutofcoreOctreeBase<ContainerT, PointT>::saveNodeIndex ()
+    {
+      std::unique_lock < std::shared_timed_mutex > lock (read_write_mutex_);
+
+      const boost::filesystem::path& root_name = root_node_->node_metadata_->getMetadataFilename ();
+      const boost::filesystem::path index_path = root_name.parent_path () / (boost::filesystem::basename (root_name) + NODE_INDEX_EXTENSION_);
+      //write to a temporary file first so an interrupted save does not leave a truncated index behind
+      const boost::filesystem::path tmp_path = index_path.string () + ".tmp";
+
+      std::ofstream file (tmp_path.string ().c_str (), std::ios::out | std::ios::binary | std::ios::trunc);
+      if (!file)
+      {
+        PCL_ERROR ("[pcl::outofcore::OutofcoreOctreeBase::%s] Could not open %s for writing\n", __FUNCTION__, tmp_path.c_str ());
+        return (false);
+      }
+
+      const std::string magic ("<PCL-OCT-NODES>");
+      const std::uint32_t version = 2;
+      std::uint64_t node_count = 0;
+      file.write (magic.data (), magic.size ());
+      file.write (reinterpret_cast<const char*> (&version), sizeof (version));
+      const std::streampos count_position = file.tellp ();
+      file.write (reinterpret_cast<const char*> (&node_count), sizeof (node_count));
+
+      //write the nodes in depth first pre-order; the child masks are enough to recover the directories when reading
+      std::vector<BranchNode*> stack (1, root_node_);
+      while (!stack.empty ())
+      {
+        BranchNode* node = stack.back ();
+        stack.pop_back ();
+
+        if (node->hasUnloadedChildren ())
+          node->loadChildren (false);
+
+        std::uint8_t children = 0;
+        for (int i = 7; i >= 0; i--)
+        {
+          BranchNode* child = node->getChildPtr (i);
+          if (child != nullptr)
+          {
+            children |= static_cast<std::uint8_t> (1 << i);
+            stack.push_back (child);
+          }
+        }
+
+        const NodeIndexEntry* entry = this->getNodeIndexEntry (node->node_metadata_->getDirectoryPathname ());
+        const std::uint64_t pack_offset = (entry != nullptr) ? entry->pack_offset : 0;
+
+        file.write (reinterpret_cast<const char*> (&children), sizeof (children));
+        file.write (reinterpret_cast<const char*> (&pack_offset), sizeof (pack_offset));
+        node->node_metadata_->serializeMetadata (file);
+        node_count++;
+      }
+
+      file.seekp (count_position);
+      file.write (reinterpret_cast<const char*> (&node_count), sizeof (node_count));
+      file.close ();
+
+      if (!file)
+      {
+        PCL_ERROR ("[pcl::outofcore::OutofcoreOctreeBase::%s] Failed to write the node index %s\n", __FUNCTION__, tmp_path.c_str ());
+        return (false);
+      }
+
+      boost::filesystem::rename (tmp_path, index_path);
+      node_index_path_ = index_path;
+      return (true);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+
+    template<typename ContainerT, typename PointT> bool
+    OutofcoreOctreeBase<ContainerT, PointT>::packNodes (const bool remove_node_files)
+    {
+      const boost::filesystem::path& root_name = root_node_->node_metadata_->getMetadataFilename ();
+      const boost::filesystem::path root_dir = root_name.parent_path ();
+      const boost::filesystem::path pack_path = root_dir / (boost::filesystem::basename (root_name) + NODE_PACK_EXTENSION_);
+      const boost::filesystem::path tmp_path = pack_path.string () + ".tmp";
+
+      std::vector<BranchNode*> nodes;
+      std::vector<std::uint64_t> pack_offsets;
+      {
+        std::unique_lock < std::shared_timed_mutex > lock (read_write_mutex_);
+
+        std::ofstream file (tmp_path.string ().c_str (), std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!file)
+        {
+          PCL_ERROR ("[pcl::outofcore::OutofcoreOctreeBase::%s] Could not open %s for writing\n", __FUNCTION__, tmp_path.c_str ());
+          return (false);
+        }
+
+        const std::size_t block_size = 512;
+        const std::vector<char> zeros (2 * block_size, 0);
+
+        //same depth first pre-order as the node index
+        std::vector<BranchNode*> stack (1, root_node_);
+        while (!stack.empty ())
+        {
+          BranchNode* node = stack.back ();
+          stack.pop_back ();
+
+          if (node->hasUnloadedChildren ())
+            node->loadChildren (false);
+          for (int i = 7; i >= 0; i--)
+          {
+            if (node->getChildPtr (i) != nullptr)
+              stack.push_back (node->getChildPtr (i));
+          }
+
+          //reserve the tar header block, which is written once the size of the storage file is known
+          const std::streampos header_position = file.tellp ();
+          file.write (zeros.data (), block_size);
+          const std::uint64_t data_position = static_cast<std::uint64_t> (file.tellp ());
+
+          std::uint64_t size = 0;
+          if (!node->payload_->writeStorage (file, size))
+          {
+            PCL_ERROR ("[pcl::outofcore::OutofcoreOctreeBase::%s] Could not pack the point data of %s\n", __FUNCTION__, node->node_metadata_->getDirectoryPathname ().c_str ());
+            return (false);
+          }
+
+          nodes.push_back (node);
+          if (size == 0)
+          {
+            //empty nodes have no extent
+            file.seekp (header_position);
+            pack_offsets.push_back (0);
+            continue;
+          }
+          pack_offsets.push_back (data_position);
+          file.write (zeros.data (), (block_size - size % block_size) % block_size);
+          const std::streampos end_position = file.tellp ();
+
+          //the entry name is the path of the storage file relative to the root directory
+          std::string name = node->node_metadata_->getPCDFilename ().filename ().generic_string ();
+          std::string prefix;
+          for (boost::filesystem::path dir = node->node_metadata_->getDirectoryPathname (); dir != root_dir && !dir.empty (); dir = dir.parent_path ())
+            prefix = dir.filename ().generic_string () + (prefix.empty () ? "" : "/") + prefix;
+
+          pcl::io::TARHeader header;
+          std::memset (&header, 0, sizeof (header));
+          if (prefix.size () + 1 + name.size () < sizeof (header.file_name))
+          {
+            name = prefix.empty () ? name : prefix + "/" + name;
+            prefix.clear ();
+          }
+          std::strncpy (header.file_name, name.c_str (), sizeof (header.file_name));
+          std::strncpy (header.file_name_prefix, prefix.c_str (), sizeof (header.file_name_prefix));
+          std::snprintf (header.file_mode, sizeof (header.file_mode), "%07o", 0644);
+          std::snprintf (header.uid, sizeof (header.uid), "%07o", 0);
+          std::snprintf (header.gid, sizeof (header.gid), "%07o", 0);
+          std::snprintf (header.file_size, sizeof (header.file_size), "%011llo", static_cast<unsigned long long> (size));
+          std::snprintf (header.mtime, sizeof (header.mtime), "%011llo", static_cast<unsigned long long> (std::time (nullptr)));
+          header.file_type[0] = '0';
+          std::memcpy (header.ustar, "ustar", 6);
+          std::memcpy (header.ustar_version, "00", 2);
+
+          //the checksum is computed with the checksum field set to spaces
+          std::memset (header.chksum, ' ', sizeof (header.chksum));
+          unsigned int checksum = 0;
+          for (std::size_t i = 0; i < sizeof (header); i++)
+            checksum += reinterpret_cast<const unsigned char*> (&header)[i];
+          std::snprintf (header.chksum, sizeof (header.chksum), "%06o", checksum);
+
+          file.seekp (header_position);
+          file.write (reinterpret_cast<const char*> (&header), sizeof (header));
+          file.seekp (end_position);
+        }
+
+        //end of archive
+        file.write (zeros.data (), zeros.size ());
+        file.close ();
+        if (!file)
+        {
+          PCL_ERROR ("[pcl::outofcore::OutofcoreOctreeBase::%s] Failed to write the pack file %s\n", __FUNCTION__, tmp_path.c_str ());
+          return (false);
+        }
+        boost::filesystem::rename (tmp_path, pack_path);
+
+        //record the extents in the node index and read the point data from the pack from now on
+        for (std::size_t i = 0; i < nodes.size (); i++)
+        {
+          BranchNode* node = nodes[i];
+          NodeIndexEntry& entry = node_index_[node->node_metadata_->getDirectoryPathname ().string ()];
+          entry.metadata = *node->node_metadata_;
+          entry.children = 0;
+          for (int c = 0; c < 8; c++)
+          {
+            if (node->getChildPtr (c) != nullptr)
+              entry.children |= static_cast<std::uint8_t> (1 << c);
+          }
+          entry.pack_offset = pack_offsets[i];
+          node->indexed_children_ = entry.children;
+          node->payload_->openPacked (pack_path, entry.pack_offset);
+        }
+        node_pack_path_ = pack_path;
+      }
+
+      if (!this->saveNodeIndex ())
+        return (false);
+
+      if (remove_node_files)
+      {
+        boost::filesystem::remove (root_node_->node_metadata_->getPCDFilename ());
+        for (int i = 0; i < 8; i++)
+          boost::filesystem::remove_all (root_dir / std::to_string (i));
+      }
+      return (true);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+
+    template<typename ContainerT, typename PointT> bool
+    OutofcoreOctreeBase<ContainerT, PointT>::loadNodeIndex (const boost::filesystem::path& index_path)
+    {
+      node_index_.clear ();
+
+      std::ifstream file (index_path.string ().c_str (), std::ios::in | std::ios::binary);
+
+      const std::string magic ("<PCL-OCT-NODES>");
+      std::string file_magic (magic.size (), '\0');
+      std::uint32_t version = 0;
+      std::uint64_t node_count = 0;
+      if (!file.read (&file_magic[0], file_magic.size ()) || file_magic != magic ||
+          !file.read (reinterpret_cast<char*> (&version), sizeof (version)) || version < 1 || version > 2 ||
+          !file.read (reinterpret_cast<char*> (&node_count), sizeof (node_count)))
+      {
+        PCL_ERROR ("[pcl::outofcore::OutofcoreOctreeBase::%s] %s is not a node index; falling back to the JSON node metadata\n", __FUNCTION__, index_path.c_str ());
+        return (false);
+      }
+
+      node_index_.reserve (node_count);
+
+      //the directories follow from the pre-order of the nodes and their child masks
+      std::vector<boost::filesystem::path> stack (1, index_path.parent_path ());
+      for (std::uint64_t i = 0; i < node_count; i++)
+      {
+        if (stack.empty ())
+          break;
+
+        const boost::filesystem::path directory = stack.back ();
+        stack.pop_back ();
+
+        NodeIndexEntry entry;
+        entry.metadata.setDirectoryPathname (directory);
+        entry.pack_offset = 0;
+        //version 1 has no pack offsets
+        if (!file.read (reinterpret_cast<char*> (&entry.children), sizeof (entry.children)) ||
+            (version > 1 && !file.read (reinterpret_cast<char*> (&entry.pack_offset), sizeof (entry.pack_offset))) ||
+            !entry.metadata.loadMetadata (file))
+          break;
+
+        for (int child = 7; child >= 0; child--)
+        {
+          if ((entry.children >> child) & 1)
+            stack.push_back (directory / std::to_string (child));
+        }
+
+        node_index_.emplace (directory.string (), entry);
+      }
+
+      if (node_index_.size () != node_count || !stack.empty ())
+      {
+        PCL_ERROR ("[pcl::outofcore::OutofcoreOctreeBase::%s] The node index %s is corrupt; falling back to the JSON node metadata\n", __FUNCTION__, index_path.c_str ());
+        node_index_.clear ();
+        return (false);
+      }
+
+      node_index_path_ = index_path;
+      return (true);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+
+    template<typename ContainerT, typename PointT> const typename OutofcoreOctreeBase<ContainerT, PointT>::NodeIndexEntry*
+    OutofcoreOctreeBase<ContainerT, PointT>::getNodeIndexEntry (const boost::filesystem::path& directory) const
+    {
+      const auto it = node_index_.find (directory.string ());
+      if (it == node_index_.end ())
+        return (nullptr);
+      return (&it->second);
     }
 
     ////////////////////////////////////////////////////////////////////////////////
@@ -207,6 +538,12 @@ namespace pcl
     template<typename ContainerT, typename PointT> std::uint64_t
     OutofcoreOctreeBase<ContainerT, PointT>::addDataToLeaf (const AlignedPointTVector& p)
     {
+      if (!node_pack_path_.empty ())
+      {
+        PCL_ERROR ("[pcl::outofcore::OutofcoreOctreeBase::%s] Packed trees are read-only\n", __FUNCTION__);
+        return (0);
+      }
+
       std::unique_lock < std::shared_timed_mutex > lock (read_write_mutex_);
 
       const bool _FORCE_BB_CHECK = true;
@@ -231,6 +568,12 @@ namespace pcl
     template<typename ContainerT, typename PointT> std::uint64_t
     OutofcoreOctreeBase<ContainerT, PointT>::addPointCloud (pcl::PCLPointCloud2::Ptr &input_cloud, const bool skip_bb_check)
     {
+      if (!node_pack_path_.empty ())
+      {
+        PCL_ERROR ("[pcl::outofcore::OutofcoreOctreeBase::%s] Packed trees are read-only\n", __FUNCTION__);
+        return (0);
+      }
+
       std::uint64_t pt_added = this->root_node_->addPointCloud (input_cloud, skip_bb_check) ;
 //      assert (input_cloud->width*input_cloud->height == pt_added);
       return (pt_added);
@@ -242,6 +585,12 @@ namespace pcl
     template<typename ContainerT, typename PointT> std::uint64_t
     OutofcoreOctreeBase<ContainerT, PointT>::addPointCloud_and_genLOD (PointCloudConstPtr point_cloud)
     {
+      if (!node_pack_path_.empty ())
+      {
+        PCL_ERROR ("[pcl::outofcore::OutofcoreOctreeBase::%s] Packed trees are read-only\n", __FUNCTION__);
+        return (0);
+      }
+
       // Lock the tree while writing
       std::unique_lock < std::shared_timed_mutex > lock (read_write_mutex_);
       std::uint64_t pt_added = root_node_->addDataToLeaf_and_genLOD (point_cloud->points, false);
@@ -253,6 +602,12 @@ namespace pcl
     template<typename ContainerT, typename PointT> std::uint64_t
     OutofcoreOctreeBase<ContainerT, PointT>::addPointCloud_and_genLOD (pcl::PCLPointCloud2::Ptr &input_cloud)
     {
+      if (!node_pack_path_.empty ())
+      {
+        PCL_ERROR ("[pcl::outofcore::OutofcoreOctreeBase::%s] Packed trees are read-only\n", __FUNCTION__);
+        return (0);
+      }
+
       // Lock the tree while writing
       std::unique_lock < std::shared_timed_mutex > lock (read_write_mutex_);
       std::uint64_t pt_added = root_node_->addPointCloud_and_genLOD (input_cloud);
@@ -269,6 +624,12 @@ namespace pcl
     template<typename ContainerT, typename PointT> std::uint64_t
     OutofcoreOctreeBase<ContainerT, PointT>::addDataToLeaf_and_genLOD (AlignedPointTVector& src)
     {
+      if (!node_pack_path_.empty ())
+      {
+        PCL_ERROR ("[pcl::outofcore::OutofcoreOctreeBase::%s] Packed trees are read-only\n", __FUNCTION__);
+        return (0);
+      }
+
       // Lock the tree while writing
       std::unique_lock < std::shared_timed_mutex > lock (read_write_mutex_);
       std::uint64_t pt_added = root_node_->addDataToLeaf_and_genLOD (src, false);
@@ -579,6 +940,121 @@ namespace pcl
 
     ////////////////////////////////////////////////////////////////////////////////
 
+    template<typename ContainerT, typename PointT> void
+    OutofcoreOctreeBase<ContainerT, PointT>::buildLODBottomUp (const unsigned int voxel_resolution)
+    {
+      if (root_node_== nullptr)
+      {
+        PCL_ERROR ("[pcl::outofcore::OutofcoreOctreeBase::%s] Root node is null; aborting buildLODBottomUp.\n", __FUNCTION__);
+        return;
+      }
+
+      //cell keys are packed into 63 bits
+      if (voxel_resolution > (1u << 21))
+      {
+        PCL_ERROR ("[pcl::outofcore::OutofcoreOctreeBase::%s] Voxel resolution %u exceeds the maximum of %u; aborting buildLODBottomUp.\n", __FUNCTION__, voxel_resolution, 1u << 21);
+        return;
+      }
+
+      std::unique_lock < std::shared_timed_mutex > lock (read_write_mutex_);
+
+      const std::uint64_t max_depth = metadata_->getDepth ();
+      if (max_depth == 0)
+        return;
+
+      //collect the branch nodes of every level, loading the children serially
+      std::vector<std::vector<BranchNode*> > levels (max_depth);
+      levels[0].push_back (root_node_);
+      for (std::uint64_t depth = 0; depth < max_depth; depth++)
+      {
+        for (BranchNode* node : levels[depth])
+        {
+          if (node->hasUnloadedChildren ())
+            node->loadChildren (false);
+
+          if (depth + 1 == max_depth)
+            continue;
+
+          for (std::size_t i = 0; i < 8; i++)
+          {
+            BranchNode* child = node->getChildPtr (i);
+            if (child != nullptr)
+              levels[depth + 1].push_back (child);
+          }
+        }
+      }
+
+      //fill the levels from the leaves up; the nodes of a level only read their children
+      for (std::int64_t depth = static_cast<std::int64_t> (max_depth) - 1; depth >= 0; depth--)
+      {
+        metadata_->setLODPoints (depth, 0, false);
+        const std::vector<BranchNode*>& nodes = levels[depth];
+
+#pragma omp parallel for schedule(dynamic,1) num_threads(threads_)
+        for (std::int64_t i = 0; i < static_cast<std::int64_t> (nodes.size ()); i++)
+        {
+          BranchNode* node = nodes[i];
+
+          AlignedPointTVector children_points;
+          for (std::size_t c = 0; c < 8; c++)
+          {
+            BranchNode* child = node->getChildPtr (c);
+            if (child != nullptr)
+              child->payload_->readRange (0, child->payload_->size (), children_points);
+          }
+
+          AlignedPointTVector lod_points;
+          if (voxel_resolution > 0)
+          {
+            //keep the first point falling into each cell
+            Eigen::Vector3d min_bb, max_bb;
+            node->getBoundingBox (min_bb, max_bb);
+            const Eigen::Vector3d inverse_cell = Eigen::Vector3d::Constant (voxel_resolution).cwiseQuotient (max_bb - min_bb);
+            const std::int64_t max_cell = voxel_resolution - 1;
+
+            std::unordered_set<std::uint64_t> occupied;
+            for (const PointT& point : children_points)
+            {
+              std::uint64_t key = 0;
+              for (int axis = 0; axis < 3; axis++)
+              {
+                std::int64_t cell = static_cast<std::int64_t> (std::floor ((point.data[axis] - min_bb[axis]) * inverse_cell[axis]));
+                cell = std::max<std::int64_t> (0, std::min (max_cell, cell));
+                key = (key << 21) | static_cast<std::uint64_t> (cell);
+              }
+              if (occupied.insert (key).second)
+                lod_points.push_back (point);
+            }
+          }
+          else if (!children_points.empty ())
+          {
+            //partial Fisher-Yates shuffle, seeded per node so that the result does not depend on the thread count
+            std::size_t sample_size = static_cast<std::size_t> (static_cast<double> (children_points.size ()) * sample_percent_);
+            if (sample_size == 0)
+              sample_size = 1;
+
+            std::mt19937 rng (static_cast<std::uint32_t> (i));
+            for (std::size_t j = 0; j < sample_size; j++)
+            {
+              std::uniform_int_distribution<std::size_t> dist (j, children_points.size () - 1);
+              std::swap (children_points[j], children_points[dist (rng)]);
+            }
+            lod_points.assign (children_points.begin (), children_points.begin () + sample_size);
+          }
+
+          //clear this node in case we are updating the LOD
+          node->clearData ();
+          if (!lod_points.empty ())
+          {
+            node->payload_->insertRange (lod_points);
+            this->incrementPointsInLOD (depth, lod_points.size ());
+          }
+        }
+      }
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+
     template<typename ContainerT, typename PointT> void
     OutofcoreOctreeBase<ContainerT, PointT>::printBoundingBox (OutofcoreOctreeBaseNode<ContainerT, PointT>& node) const
     {
@@ -685,17 +1161,33 @@ namespace pcl
     template<typename ContainerT, typename PointT> void
     OutofcoreOctreeBase<ContainerT, PointT>::incrementPointsInLOD (std::uint64_t depth, std::uint64_t new_point_count)
     {
+      std::lock_guard<std::mutex> lock (lod_points_mutex_);
       if (std::numeric_limits<std::uint64_t>::max () - metadata_->getLODPoints (depth) < new_point_count)
       {
         PCL_ERROR ("[pcl::outofcore::OutofcoreOctreeBase::incrementPointsInLOD] Overflow error. Too many points in depth %d of outofcore octree with root at %s\n", depth, metadata_->getMetadataFilename().c_str());
         PCL_THROW_EXCEPTION (PCLException, "Overflow error");
       }
-        
+          
       metadata_->setLODPoints (depth, new_point_count, true /*true->increment*/);
     }
 
     ////////////////////////////////////////////////////////////////////////////////
 
+    template<typename ContainerT, typename PointT> void
+    OutofcoreOctreeBase<ContainerT, PointT>::setNumberOfThreads (unsigned int nr_threads)
+    {
+      if (nr_threads == 0)
+#ifdef _OPENMP
+        threads_ = omp_get_num_procs ();
+#else
+        threads_ = 1;
+#endif
+      else
+        threads_ = nr_threads;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+
     template<typename ContainerT, typename PointT> bool
     OutofcoreOctreeBase<ContainerT, PointT>::checkExtension (const boost::filesystem::path& path_name)
     {
@@ -97,6 +97,7 @@ namespace pcl
       , children_ (8, nullptr)
       , num_children_ (0)
       , num_loaded_children_ (0)
+      , indexed_children_ (-1)
       , payload_ ()
       , node_metadata_ (new OutofcoreOctreeNodeMetadata)
     {
@@ -114,6 +115,7 @@ namespace pcl
       , children_ (8, nullptr)
       , num_children_ (0)
       , num_loaded_children_ (0)
+      , indexed_children_ (-1)
       , payload_ ()
       , node_metadata_ (new OutofcoreOctreeNodeMetadata)
     {
@@ -140,34 +142,52 @@ namespace pcl
         depth_ = super->getDepth () + 1;
         root_node_ = super->root_node_;
 
-        boost::filesystem::directory_iterator directory_it_end; //empty constructor creates end of iterator
+        //take the metadata from the binary node index of the tree, if it has one
+        const typename OutofcoreOctreeBase<ContainerT, PointT>::NodeIndexEntry* entry = nullptr;
+        if (root_node_->m_tree_ != nullptr)
+          entry = root_node_->m_tree_->getNodeIndexEntry (directory_path);
 
-        //flag to test if the desired metadata file was found
-        bool b_loaded = false;
-
-        for (boost::filesystem::directory_iterator directory_it (node_metadata_->getDirectoryPathname ()); directory_it != directory_it_end; ++directory_it)
+        if (entry != nullptr)
         {
-          const boost::filesystem::path& file = *directory_it;
+          *node_metadata_ = entry->metadata;
+          indexed_children_ = entry->children;
+          parent_ = super;
+          payload_.reset (new ContainerT (node_metadata_->getPCDFilename ()));
+          if (!root_node_->m_tree_->node_pack_path_.empty ())
+            payload_->openPacked (root_node_->m_tree_->node_pack_path_, entry->pack_offset);
+        }
+        else
+        {
+          boost::filesystem::directory_iterator directory_it_end; //empty constructor creates end of iterator
 
-          if (!boost::filesystem::is_directory (file))
+          //flag to test if the desired metadata file was found
+          bool b_loaded = false;
+
+          for (boost::filesystem::directory_iterator directory_it (node_metadata_->getDirectoryPathname ()); directory_it != directory_it_end; ++directory_it)
           {
-            if (boost::filesystem::extension (file) == node_index_extension)
+            const boost::filesystem::path& file = *directory_it;
+
+            if (!boost::filesystem::is_directory (file))
             {
-              b_loaded = node_metadata_->loadMetadataFromDisk (file);
-              break;
+              if (boost::filesystem::extension (file) == node_index_extension)
+              {
+                b_loaded = node_metadata_->loadMetadataFromDisk (file);
+                break;
+              }
             }
           }
-        }
 
-        if (!b_loaded)
-        {
-          PCL_ERROR ("[pcl::outofcore::OutofcoreOctreeBaseNode] Could not find index\n");
-          PCL_THROW_EXCEPTION (PCLException, "[pcl::outofcore::OutofcoreOctreeBaseNode] Outofcore: Could not find node index");
+          if (!b_loaded)
+          {
+            PCL_ERROR ("[pcl::outofcore::OutofcoreOctreeBaseNode] Could not find index\n");
+            PCL_THROW_EXCEPTION (PCLException, "[pcl::outofcore::OutofcoreOctreeBaseNode] Outofcore: Could not find node index");
+          }
         }
       }
       
       //load the metadata
-      loadFromFile (node_metadata_->getMetadataFilename (), super);
+      if (indexed_children_ < 0)
+        loadFromFile (node_metadata_->getMetadataFilename (), super);
 
       //set the number of children in this node
       num_children_ = this->countNumChildren ();
@@ -188,6 +208,7 @@ namespace pcl
       , children_ (8, nullptr)
       , num_children_ (0)
       , num_loaded_children_ (0)
+      , indexed_children_ (-1)
       , payload_ ()
       , node_metadata_ (new OutofcoreOctreeNodeMetadata ())
     {
@@ -271,6 +292,13 @@ namespace pcl
       
       for(std::size_t i=0; i<8; i++)
       {
+        if (indexed_children_ >= 0)
+        {
+          if (children_[i] != nullptr || ((indexed_children_ >> i) & 1))
+            child_count++;
+          continue;
+        }
+
         boost::filesystem::path child_path = this->node_metadata_->getDirectoryPathname () / boost::filesystem::path (std::to_string(i));
         if (boost::filesystem::exists (child_path))
           child_count++;
@@ -315,7 +343,8 @@ namespace pcl
         {
           boost::filesystem::path child_dir = node_metadata_->getDirectoryPathname () / boost::filesystem::path (std::to_string(i));
           //if the directory exists and the child hasn't been created (set to 0 by this node's constructor)
-          if (boost::filesystem::exists (child_dir) && this->children_[i] == nullptr)
+          const bool child_exists = (indexed_children_ >= 0) ? ((indexed_children_ >> i) & 1) : boost::filesystem::exists (child_dir);
+          if (child_exists && this->children_[i] == nullptr)
           {
             //load the child node
             this->children_[i] = new OutofcoreOctreeBaseNode<ContainerT, PointT> (child_dir, this, recursive);
@@ -358,6 +387,10 @@ namespace pcl
       if (this->depth_ == this->root_node_->m_tree_->getDepth ())
         return (addDataAtMaxDepth( p, skip_bb_check));
 
+      const unsigned int threads = this->root_node_->m_tree_->getNumberOfThreads ();
+      if (this == this->root_node_ && threads > 1)
+        return (addDataToLeafParallel (p, skip_bb_check, threads));
+
       if (hasUnloadedChildren ())
         loadChildren (false);
 
@@ -501,6 +534,10 @@ namespace pcl
       
       if (this->depth_ == this->root_node_->m_tree_->getDepth ())
         return (addDataAtMaxDepth (input_cloud, true));
+
+      const unsigned int threads = this->root_node_->m_tree_->getNumberOfThreads ();
+      if (this == this->root_node_ && threads > 1 && !skip_bb_check)
+        return (addPointCloudParallel (input_cloud, threads));
       
       if( num_children_ < 8 )
         if(hasUnloadedChildren ())
@@ -554,6 +591,118 @@ namespace pcl
     }
 
 
+    ////////////////////////////////////////////////////////////////////////////////
+    template<typename ContainerT, typename PointT> std::uint64_t
+    OutofcoreOctreeBaseNode<ContainerT, PointT>::addDataToLeafParallel (const AlignedPointTVector& p, const bool skip_bb_check, const unsigned int threads)
+    {
+      std::vector<OutofcoreOctreeBaseNode*> nodes (1, this);
+      std::vector<std::vector<const PointT*> > node_points (1);
+      node_points[0].reserve (p.size ());
+      for (const PointT& pt : p)
+      {
+        if (!skip_bb_check && !this->pointInBoundingBox (pt))
+        {
+          PCL_ERROR ( "[pcl::outofcore::OutofcoreOctreeBaseNode::%s] Failed to place point within bounding box\n", __FUNCTION__ );
+          continue;
+        }
+        node_points[0].push_back (&pt);
+      }
+      if (node_points[0].empty ())
+        return (0);
+
+      //walk down the tree until there are enough independent subtrees to balance the threads
+      const std::uint64_t max_depth = this->root_node_->m_tree_->getDepth ();
+      while (nodes.size () < 4 * threads && nodes.front ()->depth_ < max_depth)
+      {
+        std::vector<OutofcoreOctreeBaseNode*> next_nodes;
+        std::vector<std::vector<const PointT*> > next_points;
+        for (std::size_t n = 0; n < nodes.size (); n++)
+        {
+          OutofcoreOctreeBaseNode* node = nodes[n];
+          if (node->hasUnloadedChildren ())
+            node->loadChildren (false);
+
+          std::vector<std::vector<const PointT*> > c (8);
+          const Eigen::Vector3d mid_xyz = node->node_metadata_->getVoxelCenter ();
+          for (const PointT* pt : node_points[n])
+          {
+            const std::size_t box = ((pt->z >= mid_xyz[2]) << 2) | ((pt->y >= mid_xyz[1]) << 1) | ((pt->x >= mid_xyz[0]) << 0);
+            c[box].push_back (pt);
+          }
+
+          for (std::size_t i = 0; i < 8; i++)
+          {
+            if (c[i].empty ())
+              continue;
+            if (!node->children_[i])
+              node->createChild (i);
+            next_nodes.push_back (node->children_[i]);
+            next_points.push_back (std::move (c[i]));
+          }
+        }
+        nodes.swap (next_nodes);
+        node_points.swap (next_points);
+      }
+
+      //the subtrees share no nodes, so they are filled and written to disk concurrently
+      std::uint64_t points_added = 0;
+#pragma omp parallel for schedule(dynamic,1) num_threads(threads) reduction(+:points_added)
+      for (std::ptrdiff_t n = 0; n < static_cast<std::ptrdiff_t> (nodes.size ()); n++)
+      {
+        points_added += nodes[n]->addDataToLeaf (node_points[n], true);
+      }
+      return (points_added);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+    template<typename ContainerT, typename PointT> std::uint64_t
+    OutofcoreOctreeBaseNode<ContainerT, PointT>::addPointCloudParallel (const pcl::PCLPointCloud2::Ptr& input_cloud, const unsigned int threads)
+    {
+      std::vector<OutofcoreOctreeBaseNode*> nodes (1, this);
+      std::vector<pcl::PCLPointCloud2::Ptr> node_clouds (1, input_cloud);
+
+      //walk down the tree until there are enough independent subtrees to balance the threads
+      const std::uint64_t max_depth = this->root_node_->m_tree_->getDepth ();
+      while (!nodes.empty () && nodes.size () < 4 * threads && nodes.front ()->depth_ < max_depth)
+      {
+        std::vector<OutofcoreOctreeBaseNode*> next_nodes;
+        std::vector<pcl::PCLPointCloud2::Ptr> next_clouds;
+        for (std::size_t n = 0; n < nodes.size (); n++)
+        {
+          OutofcoreOctreeBaseNode* node = nodes[n];
+          if (node->num_children_ < 8 && node->hasUnloadedChildren ())
+            node->loadChildren (false);
+
+          std::vector<std::vector<int> > indices (8);
+          node->sortOctantIndices (node_clouds[n], indices, node->node_metadata_->getVoxelCenter ());
+
+          for (std::size_t i = 0; i < 8; i++)
+          {
+            if (indices[i].empty ())
+              continue;
+            if (node->children_[i] == nullptr)
+              node->createChild (i);
+
+            pcl::PCLPointCloud2::Ptr dst_cloud (new pcl::PCLPointCloud2 ());
+            pcl::copyPointCloud (*node_clouds[n], indices[i], *dst_cloud);
+            next_nodes.push_back (node->children_[i]);
+            next_clouds.push_back (dst_cloud);
+          }
+        }
+        nodes.swap (next_nodes);
+        node_clouds.swap (next_clouds);
+      }
+
+      //the subtrees share no nodes, so they are filled and written to disk concurrently
+      std::uint64_t points_added = 0;
+#pragma omp parallel for schedule(dynamic,1) num_threads(threads) reduction(+:points_added)
+      for (std::ptrdiff_t n = 0; n < static_cast<std::ptrdiff_t> (nodes.size ()); n++)
+      {
+        points_added += nodes[n]->addPointCloud (node_clouds[n], false);
+      }
+      return (points_added);
+    }
+
     ////////////////////////////////////////////////////////////////////////////////
     template<typename ContainerT, typename PointT> void
     OutofcoreOctreeBaseNode<ContainerT, PointT>::randomSample(const AlignedPointTVector& p, AlignedPointTVector& insertBuff, const bool skip_bb_check)
@@ -1705,6 +1854,7 @@ namespace pcl
       , children_ (8, nullptr)
       , num_children_ ()
       , num_loaded_children_ (0)
+      , indexed_children_ (-1)
       , payload_ ()
       , node_metadata_ (new OutofcoreOctreeNodeMetadata)
     {
@@ -43,7 +43,10 @@
 // C++
 #include <sstream>
 #include <cassert>
+#include <cstring>
 #include <ctime>
+#include <iomanip>
+#include <locale>
 
 // Boost
 #include <pcl/outofcore/boost.h>
@@ -102,7 +105,10 @@ namespace pcl
 
     template<typename PointT>
     OutofcoreOctreeDiskContainer<PointT>::OutofcoreOctreeDiskContainer () 
-      : filelen_ (0)
+      : data_offset_ (0)
+      , data_point_step_ (0)
+      , packed_ (false)
+      , filelen_ (0)
       , writebuff_ (0)
     {
       getRandomUUIDString (disk_storage_filename_);
@@ -112,7 +118,10 @@ namespace pcl
 
     template<typename PointT>
     OutofcoreOctreeDiskContainer<PointT>::OutofcoreOctreeDiskContainer (const boost::filesystem::path& path)
-      : filelen_ (0)
+      : data_offset_ (0)
+      , data_point_step_ (0)
+      , packed_ (false)
+      , filelen_ (0)
       , writebuff_ (0)
     {
       if (boost::filesystem::exists (path))
@@ -128,24 +137,10 @@ namespace pcl
         }
         else
         {
-          std::uint64_t len = boost::filesystem::file_size (path);
-
           disk_storage_filename_ = path.string ();
 
-          filelen_ = len / sizeof(PointT);
-
-          pcl::PCLPointCloud2 cloud_info;
-          Eigen::Vector4f origin;
-          Eigen::Quaternionf orientation;
-          int pcd_version;
-          int data_type;
-          unsigned int data_index;
-          
           //read the header of the pcd file and get the number of points
-          PCDReader reader;
-          reader.readHeader (disk_storage_filename_, cloud_info, origin, orientation, pcd_version, data_type, data_index, 0);
-          
-          filelen_ = cloud_info.width * cloud_info.height;
+          readDataLayout ();
         }
       }
       else //path doesn't exist
@@ -168,28 +163,13 @@ namespace pcl
     {
       if (!writebuff_.empty ())
       {
-        //construct the point cloud for this node
-        typename pcl::PointCloud<PointT>::Ptr cloud (new pcl::PointCloud<PointT>);
-        
-        cloud->width = writebuff_.size ();
-        cloud->height = 1;
-
-        cloud->points = writebuff_;
-
-        //write data to a pcd file
-        pcl::PCDWriter writer;
-
-
-        PCL_WARN ("[pcl::outofcore::OutofcoreOctreeDiskContainer::%s] Flushing writebuffer in a dangerous way to file %s. This might overwrite data in destination file\n", __FUNCTION__, disk_storage_filename_.c_str ());
-        
-        // Write ascii for now to debug
-        int res = writer.writeBinaryCompressed (disk_storage_filename_, *cloud);
-        pcl::utils::ignore(res);
-        assert (res == 0);
-        if (force_cache_dealloc)
-        {
-          writebuff_.resize (0);
-        }
+        //append the buffered points to the end of the file
+        appendPoints (writebuff_.data (), writebuff_.size ());
+        writebuff_.clear ();
+      }
+      if (force_cache_dealloc)
+      {
+        AlignedPointTVector ().swap (writebuff_);
       }
     }
     ////////////////////////////////////////////////////////////////////////////////
@@ -249,15 +229,48 @@ namespace pcl
         PCL_THROW_EXCEPTION (PCLException, "[pcl::outofcore::OutofcoreOctreeDiskContainer] Outofcore Octree Exception: Read indices exceed range");
       }
 
-      pcl::PCDReader reader;
-      typename pcl::PointCloud<PointT>::Ptr cloud (new pcl::PointCloud<PointT> ());
-      
-      int res = reader.read (disk_storage_filename_, *cloud);
-      pcl::utils::ignore(res);
-      assert (res == 0);
-      
-      dst.insert(dst.end(), cloud->cbegin(), cloud->cend());
-      
+      const std::uint64_t filecount = (start < filelen_) ? std::min (count, filelen_ - start) : 0;
+      if (filecount > 0)
+      {
+        if (data_offset_ != 0)
+        {
+          //read the point records of the range at once
+          std::vector<char> data (filecount * data_point_step_);
+          FILE* f = fopen (disk_storage_filename_.c_str (), "rbe");
+          assert (f != NULL);
+          bool res = readData (f, start, filecount, data.data ());
+          pcl::utils::ignore(res);
+          assert (res);
+          fclose (f);
+
+          const std::vector<FieldCopy> copies = getFieldCopies ();
+          const std::size_t dst_start = dst.size ();
+          dst.resize (dst_start + filecount);
+          for (std::uint64_t i = 0; i < filecount; i++)
+          {
+            const char* record = &data[i * data_point_step_];
+            char* point = reinterpret_cast<char*> (&dst[dst_start + i]);
+            for (const FieldCopy& copy : copies)
+              memcpy (point + copy.point_offset, record + copy.record_offset, copy.size);
+          }
+        }
+        else
+        {
+          //files that are not in the fixed-stride binary format have to be read completely
+          pcl::PCDReader reader;
+          pcl::PointCloud<PointT> cloud;
+          int res = reader.read (disk_storage_filename_, cloud);
+          pcl::utils::ignore(res);
+          assert (res == 0);
+
+          dst.insert (dst.end (), cloud.begin () + start, cloud.begin () + start + filecount);
+        }
+      }
+
+      //points still in the write buffer
+      const std::uint64_t buffstart = (start > filelen_) ? (start - filelen_) : 0;
+      const std::uint64_t buffcount = count - filecount;
+      dst.insert (dst.end (), writebuff_.begin () + buffstart, writebuff_.begin () + buffstart + buffcount);
     }
     ////////////////////////////////////////////////////////////////////////////////
 
@@ -330,25 +343,7 @@ namespace pcl
         }
         std::sort (offsets.begin (), offsets.end ());
 
-        FILE* f = fopen (disk_storage_filename_.c_str (), "rbe");
-        assert (f != NULL);
-        PointT p;
-        char* loc = reinterpret_cast<char*> (&p);
-        
-        std::uint64_t filesamp = offsets.size ();
-        for (std::uint64_t i = 0; i < filesamp; i++)
-        {
-          int seekret = _fseeki64 (f, offsets[i] * static_cast<std::uint64_t> (sizeof(PointT)), SEEK_SET);
-          pcl::utils::ignore(seekret);
-          assert (seekret == 0);
-          std::size_t readlen = fread (loc, sizeof(PointT), 1, f);
-          pcl::utils::ignore(readlen);
-          assert (readlen == 1);
-
-          dst.push_back (p);
-        }
-
-        fclose (f);
+        readPoints (offsets, dst);
       }
     }
     ////////////////////////////////////////////////////////////////////////////////
@@ -429,24 +424,7 @@ namespace pcl
         }
         std::sort (offsets.begin (), offsets.end ());
 
-        FILE* f = fopen (disk_storage_filename_.c_str (), "rbe");
-        assert (f != NULL);
-        PointT p;
-        char* loc = reinterpret_cast<char*> (&p);
-        for (std::uint64_t i = 0; i < filesamp; i++)
-        {
-          int seekret = _fseeki64 (f, offsets[i] * static_cast<std::uint64_t> (sizeof(PointT)), SEEK_SET);
-          pcl::utils::ignore(seekret);
-          assert (seekret == 0);
-          std::size_t readlen = fread (loc, sizeof(PointT), 1, f);
-          pcl::utils::ignore(readlen);
-          assert (readlen == 1);
-
-          dst.push_back (p);
-        }
-        int res = fclose (f);
-        pcl::utils::ignore(res);
-        assert (res == 0);
+        readPoints (offsets, dst);
       }
     }
     ////////////////////////////////////////////////////////////////////////////////
@@ -465,44 +443,7 @@ namespace pcl
     template<typename PointT> void
     OutofcoreOctreeDiskContainer<PointT>::insertRange (const AlignedPointTVector& src)
     {
-      const std::uint64_t count = src.size ();
-      
-      typename pcl::PointCloud<PointT>::Ptr tmp_cloud (new pcl::PointCloud<PointT> ());
-      
-      // If there's a pcd file with data          
-      if (boost::filesystem::exists (disk_storage_filename_))
-      {
-        // Open the existing file
-        pcl::PCDReader reader;
-        int res = reader.read (disk_storage_filename_, *tmp_cloud);
-        pcl::utils::ignore(res);
-        assert (res == 0);
-      }
-      // Otherwise create the point cloud which will be saved to the pcd file for the first time
-      else 
-      {
-        tmp_cloud->width = count + writebuff_.size ();
-        tmp_cloud->height = 1;
-      }            
-
-      for (std::size_t i = 0; i < src.size (); i++)
-        tmp_cloud->push_back (src[i]);
-      
-      // If there are any points in the write cache writebuff_, a different write cache than this one, concatenate
-      for (std::size_t i = 0; i < writebuff_.size (); i++)
-      {
-        tmp_cloud->push_back (writebuff_[i]);
-      }
-
-      //assume unorganized point cloud
-      tmp_cloud->width = tmp_cloud->size ();
-            
-      //save and close
-      PCDWriter writer;
-      
-      int res = writer.writeBinaryCompressed (disk_storage_filename_, *tmp_cloud);
-      pcl::utils::ignore(res);
-      assert (res == 0);
+      insertRange (src.data (), src.size ());
     }
   
     ////////////////////////////////////////////////////////////////////////////////
@@ -510,53 +451,102 @@ namespace pcl
     template<typename PointT> void
     OutofcoreOctreeDiskContainer<PointT>::insertRange (const pcl::PCLPointCloud2::Ptr& input_cloud)
     {
-      pcl::PCLPointCloud2::Ptr tmp_cloud (new pcl::PCLPointCloud2 ());
-          
-      //if there's a pcd file with data associated with this node, read the data, concatenate, and resave
-      if (boost::filesystem::exists (disk_storage_filename_))
+      if (input_cloud->width * input_cloud->height == 0)
+      {
+        return;
+      }
+
+      if (packed_)
+      {
+        PCL_ERROR ("[pcl::outofcore::OutofcoreOctreeDiskContainer::%s] Packed containers are read-only\n", __FUNCTION__);
+        return;
+      }
+
+      std::vector<pcl::PCLPointField> fields;
+      std::vector<char> data;
+      packCloud (*input_cloud, fields, data);
+      const std::uint64_t count = input_cloud->width * input_cloud->height;
+
+      //append the point records in place if the file stores the same fields
+      if (data_offset_ != 0 && fields.size () == data_fields_.size () &&
+          std::equal (fields.begin (), fields.end (), data_fields_.begin (),
+                      [] (const pcl::PCLPointField& a, const pcl::PCLPointField& b)
+                      { return (a.name == b.name && a.datatype == b.datatype && a.count == b.count); }))
+      {
+        bool res = appendData (data.data (), count);
+        pcl::utils::ignore(res);
+        assert (res);
+      }
+      //otherwise if there's a pcd file with data associated with this node, read the data, concatenate, and resave
+      else if (boost::filesystem::exists (disk_storage_filename_))
       {
         //open the existing file
+        pcl::PCLPointCloud2 tmp_cloud;
         pcl::PCDReader reader;
-        int res = reader.read (disk_storage_filename_, *tmp_cloud);
+        int res = reader.read (disk_storage_filename_, tmp_cloud);
         pcl::utils::ignore(res);
         assert (res == 0);
-        pcl::PCDWriter writer;
         PCL_DEBUG ("[pcl::outofcore::OutofcoreOctreeDiskContainer::%s] Concatenating point cloud from %s to new cloud\n", __FUNCTION__, disk_storage_filename_.c_str ());
         
-        std::size_t previous_num_pts = tmp_cloud->width*tmp_cloud->height + input_cloud->width*input_cloud->height;
+        std::size_t previous_num_pts = tmp_cloud.width*tmp_cloud.height + input_cloud->width*input_cloud->height;
         //Concatenate will fail if the fields in input_cloud do not match the fields in the PCD file.
-        pcl::concatenate (*tmp_cloud, *input_cloud, *tmp_cloud);
-        std::size_t res_pts = tmp_cloud->width*tmp_cloud->height;
+        pcl::concatenate (tmp_cloud, *input_cloud, tmp_cloud);
+        std::size_t res_pts = tmp_cloud.width*tmp_cloud.height;
         
         pcl::utils::ignore(previous_num_pts);
         pcl::utils::ignore(res_pts);
         
         assert (previous_num_pts == res_pts);
         
-        writer.writeBinaryCompressed (disk_storage_filename_, *tmp_cloud);
-            
+        packCloud (tmp_cloud, fields, data);
+        writeData (fields, data.data (), tmp_cloud.width * tmp_cloud.height);
       }
-      else //otherwise create the point cloud which will be saved to the pcd file for the first time
+      else //otherwise create the pcd file for the first time
       {
-        pcl::PCDWriter writer;
-        int res = writer.writeBinaryCompressed (disk_storage_filename_, *input_cloud);
+        bool res = writeData (fields, data.data (), count);
         pcl::utils::ignore(res);
-        assert (res == 0);
+        assert (res);
       }            
-
     }
 
     ////////////////////////////////////////////////////////////////////////////////
 
     template<typename PointT> void
-    OutofcoreOctreeDiskContainer<PointT>::readRange (const std::uint64_t, const std::uint64_t, pcl::PCLPointCloud2::Ptr& dst)
+    OutofcoreOctreeDiskContainer<PointT>::readRange (const std::uint64_t start, const std::uint64_t count, pcl::PCLPointCloud2::Ptr& dst)
     {
       pcl::PCDReader reader;
 
       Eigen::Vector4f  origin;
       Eigen::Quaternionf  orientation;
 
-      if (boost::filesystem::exists (disk_storage_filename_))
+      if (data_offset_ != 0 && start + count <= filelen_)
+      {
+        //read the point records of the range at once
+        dst->fields = data_fields_;
+        dst->point_step = data_point_step_;
+        dst->width = static_cast<std::uint32_t> (count);
+        dst->height = 1;
+        dst->row_step = dst->point_step * dst->width;
+        dst->is_dense = false;
+        dst->data.resize (count * data_point_step_);
+        if (count == 0)
+        {
+          return;
+        }
+
+        FILE* f = fopen (disk_storage_filename_.c_str (), "rbe");
+        assert (f != NULL);
+        bool res = readData (f, start, count, reinterpret_cast<char*> (dst->data.data ()));
+        pcl::utils::ignore(res);
+        assert (res);
+        fclose (f);
+      }
+      else if (packed_)
+      {
+        //empty extent of a packed tree
+        *dst = pcl::PCLPointCloud2 ();
+      }
+      else if (boost::filesystem::exists (disk_storage_filename_))
       {
 //            PCL_INFO ("[pcl::outofcore::OutofcoreOctreeDiskContainer::%s] Reading points from disk from %s.\n", __FUNCTION__ , disk_storage_filename_->c_str ());
         int  pcd_version;
@@ -577,7 +567,11 @@ namespace pcl
     {
       pcl::PCLPointCloud2::Ptr temp_output_cloud (new pcl::PCLPointCloud2 ());
 
-      if (boost::filesystem::exists (disk_storage_filename_))
+      if (packed_)
+      {
+        readRange (0, filelen_, temp_output_cloud);
+      }
+      else if (boost::filesystem::exists (disk_storage_filename_))
       {
 //            PCL_INFO ("[pcl::outofcore::OutofcoreOctreeDiskContainer::%s] Reading points from disk from %s.\n", __FUNCTION__ , disk_storage_filename_->c_str ());
         int res = pcl::io::loadPCDFile (disk_storage_filename_, *temp_output_cloud);
@@ -627,50 +621,377 @@ namespace pcl
     template<typename PointT> void
     OutofcoreOctreeDiskContainer<PointT>::insertRange (const PointT* start, const std::uint64_t count)
     {
-      typename pcl::PointCloud<PointT>::Ptr tmp_cloud (new pcl::PointCloud<PointT> ());
+      // Add any points in the cache
+      flushWritebuff (false);
 
-      // If there's a pcd file with data, read it in from disk for appending
-      if (boost::filesystem::exists (disk_storage_filename_))
+      //add the new points passed with this function
+      appendPoints (start, count);
+    }
+    ////////////////////////////////////////////////////////////////////////////////
+
+    template<typename PointT> std::vector<pcl::PCLPointField>
+    OutofcoreOctreeDiskContainer<PointT>::getPointFields ()
+    {
+      std::vector<pcl::PCLPointField> fields;
+      std::uint32_t offset = 0;
+      for (pcl::PCLPointField field : pcl::getFields<PointT> ())
       {
-        pcl::PCDReader reader;
-        // Open it
-        int res = reader.read (disk_storage_filename_, *tmp_cloud);
-        pcl::utils::ignore(res); 
-        assert (res == 0);
+        if (field.name == "_")
+          continue;
+        //same convention as pcl::PCDWriter
+        if (field.name == "rgb")
+          field.datatype = pcl::PCLPointField::UINT32;
+        if (field.count == 0)
+          field.count = 1;
+        field.offset = offset;
+        offset += field.count * pcl::getFieldSize (field.datatype);
+        fields.push_back (field);
       }
-      else //otherwise create the pcd file
+      return (fields);
+    }
+    ////////////////////////////////////////////////////////////////////////////////
+
+    template<typename PointT> void
+    OutofcoreOctreeDiskContainer<PointT>::packCloud (const pcl::PCLPointCloud2 &cloud, std::vector<pcl::PCLPointField> &fields, std::vector<char> &data)
+    {
+      fields.clear ();
+      std::vector<std::uint32_t> cloud_offsets;
+      std::uint32_t offset = 0;
+      for (pcl::PCLPointField field : cloud.fields)
       {
-        tmp_cloud->width = count + writebuff_.size ();
-        tmp_cloud->height = 1;
-      }            
+        if (field.name == "_")
+          continue;
+        if (field.count == 0)
+          field.count = 1;
+        cloud_offsets.push_back (field.offset);
+        field.offset = offset;
+        offset += field.count * pcl::getFieldSize (field.datatype);
+        fields.push_back (field);
+      }
 
-      // Add any points in the cache
-      for (std::size_t i = 0; i < writebuff_.size (); i++)
+      const std::uint64_t count = cloud.width * cloud.height;
+      data.resize (count * offset);
+      for (std::uint64_t i = 0; i < count; i++)
       {
-        tmp_cloud->push_back (writebuff_ [i]);
+        for (std::size_t d = 0; d < fields.size (); d++)
+        {
+          memcpy (&data[i * offset + fields[d].offset], &cloud.data[i * cloud.point_step + cloud_offsets[d]],
+                  fields[d].count * pcl::getFieldSize (fields[d].datatype));
+        }
       }
+    }
+    ////////////////////////////////////////////////////////////////////////////////
 
-      //add the new points passed with this function
-      for (std::size_t i = 0; i < count; i++)
+    template<typename PointT> std::uint32_t
+    OutofcoreOctreeDiskContainer<PointT>::getRecordSize (const std::vector<pcl::PCLPointField> &fields)
+    {
+      if (fields.empty ())
       {
-        tmp_cloud->push_back (*(start + i));
+        return (0);
       }
+      return (fields.back ().offset + fields.back ().count * pcl::getFieldSize (fields.back ().datatype));
+    }
+    ////////////////////////////////////////////////////////////////////////////////
 
-      tmp_cloud->width = tmp_cloud->size ();
-      tmp_cloud->height = 1;
-            
-      //save and close
-      PCDWriter writer;
+    template<typename PointT> std::string
+    OutofcoreOctreeDiskContainer<PointT>::generateDataHeader (const std::vector<pcl::PCLPointField> &fields, const std::uint64_t nr_points)
+    {
+      std::ostringstream oss;
+      oss.imbue (std::locale::classic ());
+
+      oss << "# .PCD v0.7 - Point Cloud Data file format"
+             "\nVERSION 0.7"
+             "\nFIELDS";
+      for (const auto &field : fields)
+        oss << " " << field.name;
+      oss << "\nSIZE";
+      for (const auto &field : fields)
+        oss << " " << pcl::getFieldSize (field.datatype);
+      oss << "\nTYPE";
+      for (const auto &field : fields)
+        oss << " " << pcl::getFieldType (field.datatype);
+      oss << "\nCOUNT";
+      for (const auto &field : fields)
+        oss << " " << field.count;
+
+      //zero padded point counts keep the header size constant while points are appended
+      oss << "\nWIDTH " << std::setw (10) << std::setfill ('0') << nr_points
+          << "\nHEIGHT 1"
+             "\nVIEWPOINT 0 0 0 1 0 0 0"
+             "\nPOINTS " << std::setw (10) << std::setfill ('0') << nr_points
+          << "\nDATA binary\n";
+
+      return (oss.str ());
+    }
+    ////////////////////////////////////////////////////////////////////////////////
 
-      int res = writer.writeBinaryCompressed (disk_storage_filename_, *tmp_cloud);
+    template<typename PointT> void
+    OutofcoreOctreeDiskContainer<PointT>::readDataLayout ()
+    {
+      filelen_ = 0;
+      data_offset_ = 0;
+      data_fields_.clear ();
+      data_point_step_ = 0;
+
+      if (!boost::filesystem::exists (disk_storage_filename_))
+      {
+        return;
+      }
+
+      pcl::PCLPointCloud2 cloud_info;
+      Eigen::Vector4f origin;
+      Eigen::Quaternionf orientation;
+      int pcd_version;
+      int data_type;
+      unsigned int data_index;
+
+      PCDReader reader;
+      if (reader.readHeader (disk_storage_filename_, cloud_info, origin, orientation, pcd_version, data_type, data_index, 0) < 0)
+      {
+        return;
+      }
+
+      filelen_ = cloud_info.width * cloud_info.height;
+      data_fields_ = cloud_info.fields;
+      data_point_step_ = cloud_info.point_step;
+
+      //only binary files with a header generated by this container can be appended to in place
+      if (data_type != 1 || data_point_step_ != getRecordSize (data_fields_))
+      {
+        return;
+      }
+      const std::string header = generateDataHeader (data_fields_, filelen_);
+      if (header.size () != data_index)
+      {
+        return;
+      }
+
+      std::string file_header (header.size (), '\0');
+      FILE* f = fopen (disk_storage_filename_.c_str (), "rbe");
+      if (f == nullptr)
+      {
+        return;
+      }
+      std::size_t readlen = fread (&file_header[0], 1, file_header.size (), f);
+      fclose (f);
+
+      if (readlen == header.size () && file_header == header)
+      {
+        data_offset_ = data_index;
+      }
+    }
+    ////////////////////////////////////////////////////////////////////////////////
+
+    template<typename PointT> std::vector<typename OutofcoreOctreeDiskContainer<PointT>::FieldCopy>
+    OutofcoreOctreeDiskContainer<PointT>::getFieldCopies () const
+    {
+      std::vector<FieldCopy> copies;
+      for (const auto &point_field : pcl::getFields<PointT> ())
+      {
+        if (point_field.name == "_")
+          continue;
+        const std::uint32_t size = std::max<std::uint32_t> (point_field.count, 1) * pcl::getFieldSize (point_field.datatype);
+        for (const auto &data_field : data_fields_)
+        {
+          if (data_field.name == point_field.name && data_field.count * pcl::getFieldSize (data_field.datatype) == size)
+          {
+            copies.push_back ({data_field.offset, point_field.offset, size});
+            break;
+          }
+        }
+      }
+      return (copies);
+    }
+    ////////////////////////////////////////////////////////////////////////////////
+
+    template<typename PointT> bool
+    OutofcoreOctreeDiskContainer<PointT>::writeData (const std::vector<pcl::PCLPointField> &fields, const char* data, const std::uint64_t count)
+    {
+      const std::string header = generateDataHeader (fields, count);
+      const std::uint32_t point_step = getRecordSize (fields);
+
+      FILE* f = fopen (disk_storage_filename_.c_str (), "wbe");
+      if (f == nullptr)
+      {
+        PCL_ERROR ("[pcl::outofcore::OutofcoreOctreeDiskContainer::%s] Could not open %s for writing\n", __FUNCTION__, disk_storage_filename_.c_str ());
+        return (false);
+      }
+      bool res = (fwrite (header.data (), 1, header.size (), f) == header.size ()) &&
+                 (fwrite (data, point_step, count, f) == count);
+      res = (fclose (f) == 0) && res;
+
+      data_fields_ = fields;
+      data_point_step_ = point_step;
+      data_offset_ = header.size ();
+      filelen_ = count;
+
+      if (!res)
+      {
+        PCL_ERROR ("[pcl::outofcore::OutofcoreOctreeDiskContainer::%s] Error writing %s\n", __FUNCTION__, disk_storage_filename_.c_str ());
+        readDataLayout ();
+      }
+      return (res);
+    }
+    ////////////////////////////////////////////////////////////////////////////////
+
+    template<typename PointT> bool
+    OutofcoreOctreeDiskContainer<PointT>::appendData (const char* data, const std::uint64_t count)
+    {
+      if (count == 0)
+      {
+        return (true);
+      }
+
+      FILE* f = fopen (disk_storage_filename_.c_str (), "r+be");
+      if (f == nullptr)
+      {
+        PCL_ERROR ("[pcl::outofcore::OutofcoreOctreeDiskContainer::%s] Could not open %s for appending\n", __FUNCTION__, disk_storage_filename_.c_str ());
+        return (false);
+      }
+
+      //write the point records behind the existing ones, then update the point counts of the header
+      const std::string header = generateDataHeader (data_fields_, filelen_ + count);
+      bool res = (_fseeki64 (f, data_offset_ + filelen_ * data_point_step_, SEEK_SET) == 0) &&
+                 (fwrite (data, data_point_step_, count, f) == count) &&
+                 (_fseeki64 (f, 0, SEEK_SET) == 0) &&
+                 (fwrite (header.data (), 1, header.size (), f) == header.size ());
+      res = (fclose (f) == 0) && res;
+
+      if (!res)
+      {
+        PCL_ERROR ("[pcl::outofcore::OutofcoreOctreeDiskContainer::%s] Error appending to %s\n", __FUNCTION__, disk_storage_filename_.c_str ());
+        readDataLayout ();
+        return (false);
+      }
+      filelen_ += count;
+      return (true);
+    }
+    ////////////////////////////////////////////////////////////////////////////////
+
+    template<typename PointT> void
+    OutofcoreOctreeDiskContainer<PointT>::appendPoints (const PointT* start, const std::uint64_t count)
+    {
+      if (count == 0)
+      {
+        return;
+      }
+
+      if (packed_)
+      {
+        PCL_ERROR ("[pcl::outofcore::OutofcoreOctreeDiskContainer::%s] Packed containers are read-only\n", __FUNCTION__);
+        return;
+      }
+
+      //convert files of older versions once, so further points are appended in place
+      convertData ();
+
+      const bool create = (data_offset_ == 0);
+      if (create)
+      {
+        data_fields_ = getPointFields ();
+        data_point_step_ = getRecordSize (data_fields_);
+      }
+
+      //copy the points into the records of the file, fields missing in PointT are zero
+      std::vector<char> data (count * data_point_step_, 0);
+      const std::vector<FieldCopy> copies = getFieldCopies ();
+      for (std::uint64_t i = 0; i < count; i++)
+      {
+        const char* point = reinterpret_cast<const char*> (start + i);
+        for (const FieldCopy& copy : copies)
+          memcpy (&data[i * data_point_step_ + copy.record_offset], point + copy.point_offset, copy.size);
+      }
+
+      bool res = create ? writeData (data_fields_, data.data (), count) : appendData (data.data (), count);
+      pcl::utils::ignore(res);
+      assert (res);
+    }
+    ////////////////////////////////////////////////////////////////////////////////
+
+    template<typename PointT> void
+    OutofcoreOctreeDiskContainer<PointT>::convertData ()
+    {
+      if (data_offset_ != 0 || packed_ || !boost::filesystem::exists (disk_storage_filename_))
+      {
+        return;
+      }
+
+      PCL_DEBUG ("[pcl::outofcore::OutofcoreOctreeDiskContainer::%s] Converting %s to fixed-stride binary data\n", __FUNCTION__, disk_storage_filename_.c_str ());
+      pcl::PCDReader reader;
+      pcl::PCLPointCloud2 cloud;
+      int res = reader.read (disk_storage_filename_, cloud);
       pcl::utils::ignore(res);
       assert (res == 0);
+
+      std::vector<pcl::PCLPointField> fields;
+      std::vector<char> data;
+      packCloud (cloud, fields, data);
+      writeData (fields, data.data (), cloud.width * cloud.height);
+    }
+    ////////////////////////////////////////////////////////////////////////////////
+
+    template<typename PointT> bool
+    OutofcoreOctreeDiskContainer<PointT>::readData (FILE* f, const std::uint64_t start, const std::uint64_t count, char* dst) const
+    {
+      if (_fseeki64 (f, data_offset_ + start * data_point_step_, SEEK_SET) != 0)
+      {
+        return (false);
+      }
+      return (fread (dst, data_point_step_, count, f) == count);
+    }
+    ////////////////////////////////////////////////////////////////////////////////
+
+    template<typename PointT> void
+    OutofcoreOctreeDiskContainer<PointT>::readPoints (const std::vector<std::uint64_t> &offsets, AlignedPointTVector &dst) const
+    {
+      if (offsets.empty ())
+      {
+        return;
+      }
+
+      if (data_offset_ != 0)
+      {
+        FILE* f = fopen (disk_storage_filename_.c_str (), "rbe");
+        assert (f != NULL);
+        const std::vector<FieldCopy> copies = getFieldCopies ();
+        std::vector<char> record (data_point_step_);
+        for (const std::uint64_t offset : offsets)
+        {
+          bool res = readData (f, offset, 1, record.data ());
+          pcl::utils::ignore(res);
+          assert (res);
+
+          PointT p;
+          char* loc = reinterpret_cast<char*> (&p);
+          for (const FieldCopy& copy : copies)
+            memcpy (loc + copy.point_offset, &record[copy.record_offset], copy.size);
+          dst.push_back (p);
+        }
+        fclose (f);
+      }
+      else
+      {
+        //files that are not in the fixed-stride binary format have to be read completely
+        pcl::PCDReader reader;
+        pcl::PointCloud<PointT> cloud;
+        int res = reader.read (disk_storage_filename_, cloud);
+        pcl::utils::ignore(res);
+        assert (res == 0);
+
+        for (const std::uint64_t offset : offsets)
+          dst.push_back (cloud[offset]);
+      }
     }
     ////////////////////////////////////////////////////////////////////////////////
 
     template<typename PointT> std::uint64_t
     OutofcoreOctreeDiskContainer<PointT>::getDataSize () const
     {
+      if (packed_)
+      {
+        return (filelen_);
+      }
+
       pcl::PCLPointCloud2 cloud_info;
       Eigen::Vector4f origin;
       Eigen::Quaternionf orientation;
@@ -688,6 +1009,110 @@ namespace pcl
     }
     ////////////////////////////////////////////////////////////////////////////////
 
+    template<typename PointT> bool
+    OutofcoreOctreeDiskContainer<PointT>::openPacked (const boost::filesystem::path &pack_path, const std::uint64_t offset)
+    {
+      writebuff_.clear ();
+      disk_storage_filename_ = pack_path.string ();
+      packed_ = true;
+      filelen_ = 0;
+      data_offset_ = 0;
+      data_fields_.clear ();
+      data_point_step_ = 0;
+
+      if (offset == 0)
+      {
+        return (true);
+      }
+
+      FILE* f = fopen (disk_storage_filename_.c_str (), "rbe");
+      if (f == nullptr)
+      {
+        PCL_ERROR ("[pcl::outofcore::OutofcoreOctreeDiskContainer::%s] Could not open %s\n", __FUNCTION__, disk_storage_filename_.c_str ());
+        return (false);
+      }
+
+      //the header has a fixed size for the fields of the storage file, which is far below this bound
+      std::string header (4096, '\0');
+      bool res = (_fseeki64 (f, offset, SEEK_SET) == 0);
+      if (res)
+      {
+        header.resize (fread (&header[0], 1, header.size (), f));
+      }
+      fclose (f);
+
+      pcl::PCLPointCloud2 cloud_info;
+      Eigen::Vector4f origin;
+      Eigen::Quaternionf orientation;
+      int pcd_version;
+      int data_type;
+      unsigned int data_index;
+
+      std::istringstream header_stream (header);
+      PCDReader reader;
+      res = res && (reader.readHeader (header_stream, cloud_info, origin, orientation, pcd_version, data_type, data_index) == 0) &&
+            data_type == 1 && cloud_info.point_step == getRecordSize (cloud_info.fields) &&
+            header.compare (0, data_index, generateDataHeader (cloud_info.fields, cloud_info.width * cloud_info.height)) == 0;
+      if (!res)
+      {
+        PCL_ERROR ("[pcl::outofcore::OutofcoreOctreeDiskContainer::%s] No point data in the fixed-stride binary format at offset %lu of %s\n", __FUNCTION__, offset, disk_storage_filename_.c_str ());
+        return (false);
+      }
+
+      filelen_ = cloud_info.width * cloud_info.height;
+      data_fields_ = cloud_info.fields;
+      data_point_step_ = cloud_info.point_step;
+      data_offset_ = offset + data_index;
+      return (true);
+    }
+    ////////////////////////////////////////////////////////////////////////////////
+
+    template<typename PointT> bool
+    OutofcoreOctreeDiskContainer<PointT>::writeStorage (std::ostream &os, std::uint64_t &size)
+    {
+      size = 0;
+      flushWritebuff (false);
+      convertData ();
+
+      if (filelen_ == 0)
+      {
+        return (true);
+      }
+
+      //packed containers copy their extent of the packed tree file
+      const std::uint64_t header_size = generateDataHeader (data_fields_, filelen_).size ();
+      const std::uint64_t begin = data_offset_ - header_size;
+      const std::uint64_t end = data_offset_ + filelen_ * data_point_step_;
+
+      FILE* f = fopen (disk_storage_filename_.c_str (), "rbe");
+      if (f == nullptr || _fseeki64 (f, begin, SEEK_SET) != 0)
+      {
+        PCL_ERROR ("[pcl::outofcore::OutofcoreOctreeDiskContainer::%s] Could not read %s\n", __FUNCTION__, disk_storage_filename_.c_str ());
+        if (f != nullptr)
+          fclose (f);
+        return (false);
+      }
+
+      std::vector<char> buffer (1 << 20);
+      bool res = true;
+      for (std::uint64_t position = begin; res && position < end; )
+      {
+        const std::size_t length = static_cast<std::size_t> (std::min<std::uint64_t> (buffer.size (), end - position));
+        res = (fread (buffer.data (), 1, length, f) == length) && os.write (buffer.data (), length);
+        position += length;
+      }
+      fclose (f);
+
+      if (!res)
+      {
+        PCL_ERROR ("[pcl::outofcore::OutofcoreOctreeDiskContainer::%s] Error copying %s\n", __FUNCTION__, disk_storage_filename_.c_str ());
+        return (false);
+      }
+      size = end - begin;
+      return (true);
+    }
+    ////////////////////////////////////////////////////////////////////////////////
+
   }//namespace outofcore
 }//namespace pcl
 
@@ -63,7 +63,9 @@
 
 #include <pcl/PCLPointCloud2.h>
 
+#include <mutex>
 #include <shared_mutex>
+#include <unordered_map>
 
 namespace pcl
 {
@@ -475,11 +477,46 @@ namespace pcl
         // Mutators
         // -----------------------------------------------------------------------
 
+        /** \brief Write a binary index of the metadata of all nodes (bounding boxes, file names and children) next to
+         * the root node.
+         *
+         * Opening a tree reads the metadata of all nodes from this single file instead of listing the directory and
+         * parsing the JSON ".oct_idx" file of every node. The JSON files are still written and remain the exchange
+         * format. Once the tree has an index, it is rewritten whenever the tree is saved.
+         * \return true on success, false if the index could not be written
+         */
+        bool
+        saveNodeIndex ();
+
+        /** \brief Pack the point data of all nodes into a single file next to the root node.
+         *
+         * The file is a tar archive holding the storage file of every node at a 512 byte aligned extent, which
+         * is recorded in the binary node index (see \ref saveNodeIndex). A tree with a pack file reads the points
+         * of its nodes from the pack and is read-only, so packing should be the last step of building a tree.
+         * \param[in] remove_node_files remove the node directories and storage files after packing, which leaves
+         * the root node metadata, the tree metadata, the node index and the pack file
+         * \return true on success, false if the pack file or the node index could not be written
+         */
+        bool
+        packNodes (const bool remove_node_files = false);
+
         /** \brief Generate multi-resolution LODs for the tree, which are a uniform random sampling all child leafs below the node.
          */
         void
         buildLOD ();
 
+        /** \brief Generate multi-resolution LODs bottom-up once all points have been inserted into the leaves.
+         *
+         * Each branch node is filled with a subsample of the union of its children's points, starting one level
+         * above the leaves and moving towards the root, so every level is computed from the (already subsampled)
+         * level below instead of from the full resolution leaves. The nodes of a level are independent and are
+         * subsampled and written to disk in parallel (see \ref setNumberOfThreads).
+         * \param[in] voxel_resolution if non-zero, keep one point per cell of a voxel_resolution^3 grid spanning
+         * each node's bounding box; otherwise keep a random sample of \ref setSamplePercent of the children's points
+         */
+        void
+        buildLODBottomUp (const unsigned int voxel_resolution = 0);
+
         /** \brief Prints size of BBox to stdout
          */ 
         void
@@ -566,6 +603,21 @@ namespace pcl
         {
           this->sample_percent_ = std::fabs (sample_percent_arg) > 1.0 ? 1.0 : std::fabs (sample_percent_arg);
         }
+
+        /** \brief Set the number of threads used by \ref addDataToLeaf, \ref addPointCloud and \ref buildLODBottomUp (default: 1).
+         *
+         * The points are partitioned into independent subtrees, which are filled and written to disk in parallel.
+         * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+         */
+        void
+        setNumberOfThreads (unsigned int nr_threads = 0);
+
+        /** \brief Returns the number of threads used for inserting points and building the LOD */
+        inline unsigned int
+        getNumberOfThreads () const
+        {
+          return (threads_);
+        }
 	
       protected:
         void
@@ -595,6 +647,26 @@ namespace pcl
         void
         saveToFile ();
 
+        /** \brief Metadata of a node read from the binary node index */
+        struct NodeIndexEntry
+        {
+          OutofcoreOctreeNodeMetadata metadata;
+          /** \brief Bit mask of the existing children */
+          std::uint8_t children;
+          /** \brief Offset of the point data of the node in the pack file; 0 if the node is empty or not packed */
+          std::uint64_t pack_offset;
+        };
+
+        /** \brief Load the binary node index written by \ref saveNodeIndex
+         *  \return true on success, false if the file is missing or malformed
+         */
+        bool
+        loadNodeIndex (const boost::filesystem::path& index_path);
+
+        /** \brief Returns the index entry of the node stored in directory, or NULL if there is none */
+        const NodeIndexEntry*
+        getNodeIndexEntry (const boost::filesystem::path& directory) const;
+
         /** \brief recursive portion of lod builder */
         void
         buildLODRecursive (const std::vector<BranchNode*>& current_branch);
@@ -629,6 +701,9 @@ namespace pcl
         /** \brief shared mutex for controlling read/write access to disk */
         mutable std::shared_timed_mutex read_write_mutex_;
 
+        /** \brief mutex for the LOD point counts, which are incremented by parallel insertions */
+        std::mutex lod_points_mutex_;
+
         OutofcoreOctreeBaseMetadata::Ptr metadata_;
         
         /** \brief defined as ".octree" to append to treepath files
@@ -637,6 +712,21 @@ namespace pcl
         const static std::string TREE_EXTENSION_;
         const static int OUTOFCORE_VERSION_;
 
+        /** \brief defined as ".oct_bin" to append to the binary node index file */
+        const static std::string NODE_INDEX_EXTENSION_;
+
+        /** \brief Metadata of the nodes read from the binary node index, by directory */
+        std::unordered_map<std::string, NodeIndexEntry> node_index_;
+
+        /** \brief Path of the binary node index; empty if the tree has none */
+        boost::filesystem::path node_index_path_;
+
+        /** \brief defined as ".oct_pack" to append to the pack file */
+        const static std::string NODE_PACK_EXTENSION_;
+
+        /** \brief Path of the pack file holding the point data of all nodes; empty if the tree is not packed */
+        boost::filesystem::path node_pack_path_;
+
         const static std::uint64_t LOAD_COUNT_ = static_cast<std::uint64_t>(2e9);
 
       private:    
@@ -652,6 +742,9 @@ namespace pcl
         double sample_percent_;
 
         pcl::RandomSample<pcl::PCLPointCloud2>::Ptr lod_filter_ptr_;
+
+        /** \brief The number of threads used for inserting points and building the LOD */
+        unsigned int threads_;
         
     };
   }
@@ -521,6 +521,23 @@ namespace pcl
         void
         sortOctantIndices (const pcl::PCLPointCloud2::Ptr &input_cloud, std::vector< std::vector<int> > &indices, const Eigen::Vector3d &mid_xyz);
 
+        /** \brief Distributes points to the nodes below this node until there are enough independent
+         *  subtrees for the given number of threads, then fills the subtrees in parallel
+         *  \param[in] p vector of points to add
+         *  \param[in] skip_bb_check whether to check if the point's coordinates fall within the bounding box
+         *  \param[in] threads number of threads
+         */
+        std::uint64_t
+        addDataToLeafParallel (const AlignedPointTVector &p, const bool skip_bb_check, const unsigned int threads);
+
+        /** \brief Distributes a PCLPointCloud2 to the nodes below this node until there are enough
+         *  independent subtrees for the given number of threads, then fills the subtrees in parallel
+         *  \param[in] input_cloud points to add
+         *  \param[in] threads number of threads
+         */
+        std::uint64_t
+        addPointCloudParallel (const pcl::PCLPointCloud2::Ptr &input_cloud, const unsigned int threads);
+
         /** \brief Enlarges the shortest two sidelengths of the
          *  bounding box to a cubic shape; operation is done in
          *  place.
@@ -550,6 +567,11 @@ namespace pcl
          */
         std::uint64_t num_loaded_children_;
 
+        /** \brief Bit mask of the children stored in the binary node index of the tree; -1 if this node was not
+         *  loaded from the index, in which case the children are looked up on disk
+         */
+        int indexed_children_;
+
         /** \brief what holds the points. currently a custom class, but in theory
          * you could use an stl container if you rewrote some of this class. I used
          * to use deques for this... */
@@ -41,6 +41,7 @@
 
 // C++
 #include <mutex>
+#include <ostream>
 #include <vector>
 #include <string>
 
@@ -208,6 +209,11 @@ namespace pcl
         inline void
         clear () override
         {
+          if (packed_)
+          {
+            PCL_ERROR ("[pcl::outofcore::OutofcoreOctreeDiskContainer::clear] Packed containers are read-only\n");
+            return;
+          }
           //clear elements that have not yet been written to disk
           writebuff_.clear ();
           //remove the binary data in the directory
@@ -215,6 +221,9 @@ namespace pcl
           boost::filesystem::remove (boost::filesystem::path (disk_storage_filename_.c_str ()));
           //reset the size-of-file counter
           filelen_ = 0;
+          data_offset_ = 0;
+          data_fields_.clear ();
+          data_point_step_ = 0;
         }
 
         /** \brief write points to disk as ascii
@@ -224,7 +233,7 @@ namespace pcl
         void
         convertToXYZ (const boost::filesystem::path &path) override
         {
-          if (boost::filesystem::exists (disk_storage_filename_))
+          if (!packed_ && boost::filesystem::exists (disk_storage_filename_))
           {
             FILE* fxyz = fopen (path.string ().c_str (), "we");
 
@@ -271,6 +280,26 @@ namespace pcl
         /** \brief Returns the number of points in the PCD file by reading the PCD header. */
         std::uint64_t
         getDataSize () const;
+
+        /** \brief Read the points from an extent of a packed tree file instead of from the storage file of this container.
+         *
+         * The extent holds a storage file in the fixed-stride binary format, as written by \ref writeStorage.
+         * Packed containers are read-only.
+         * \param[in] pack_path path of the packed tree file
+         * \param[in] offset byte offset of the storage file in the packed tree file; 0 for an empty container
+         * \return true on success, false if the extent does not hold a storage file in the fixed-stride binary format
+         */
+        bool
+        openPacked (const boost::filesystem::path &pack_path, const std::uint64_t offset);
+
+        /** \brief Write the storage file of this container to a stream, converting files of older
+         * versions to the fixed-stride binary format first. Used to pack trees into a single file.
+         * \param[out] os stream the storage file is written to
+         * \param[out] size number of bytes written; 0 if the container is empty
+         * \return true on success
+         */
+        bool
+        writeStorage (std::ostream &os, std::uint64_t &size);
         
       private:
         //no copy construction
@@ -282,10 +311,103 @@ namespace pcl
 
         void
         flushWritebuff (const bool force_cache_dealloc);
-    
+
+        /** \brief Copy operation from a point field of PointT to a field of the point records in the storage file */
+        struct FieldCopy
+        {
+          std::uint32_t record_offset;
+          std::uint32_t point_offset;
+          std::uint32_t size;
+        };
+
+        /** \brief Returns the fields of PointT without padding, as stored in new storage files */
+        static std::vector<pcl::PCLPointField>
+        getPointFields ();
+
+        /** \brief Packs the fields of a point cloud into consecutive point records
+         * \param[in] cloud point cloud
+         * \param[out] fields fields of the point records
+         * \param[out] data point records
+         */
+        static void
+        packCloud (const pcl::PCLPointCloud2 &cloud, std::vector<pcl::PCLPointField> &fields, std::vector<char> &data);
+
+        /** \brief Returns the size of a point record with the given consecutive fields */
+        static std::uint32_t
+        getRecordSize (const std::vector<pcl::PCLPointField> &fields);
+
+        /** \brief Generates the header of the storage file. The point counts have a fixed width,
+         * so points can be appended without moving the point records.
+         */
+        static std::string
+        generateDataHeader (const std::vector<pcl::PCLPointField> &fields, const std::uint64_t nr_points);
+
+        /** \brief Reads the header of the storage file and checks whether the point records
+         * are stored in the fixed-stride binary format, which allows direct range reads and appends
+         */
+        void
+        readDataLayout ();
+
+        /** \brief Rewrites a storage file of an older version in the fixed-stride binary format */
+        void
+        convertData ();
+
+        /** \brief Returns the copy operations between PointT and the point records in the storage file */
+        std::vector<FieldCopy>
+        getFieldCopies () const;
+
+        /** \brief Writes a new storage file in the fixed-stride binary format
+         * \param[in] fields fields of the point records
+         * \param[in] data point records
+         * \param[in] count number of point records
+         */
+        bool
+        writeData (const std::vector<pcl::PCLPointField> &fields, const char* data, const std::uint64_t count);
+
+        /** \brief Appends point records to the storage file, which has to be in the fixed-stride binary format
+         * \param[in] data point records, using the fields of the storage file
+         * \param[in] count number of point records
+         */
+        bool
+        appendData (const char* data, const std::uint64_t count);
+
+        /** \brief Appends points to the storage file, converting older storage files to the fixed-stride binary format */
+        void
+        appendPoints (const PointT* start, const std::uint64_t count);
+
+        /** \brief Reads point records from the fixed-stride binary storage file
+         * \param[in] f opened storage file
+         * \param[in] start index of the first point record
+         * \param[in] count number of point records
+         * \param[out] dst destination of the point records
+         */
+        bool
+        readData (FILE* f, const std::uint64_t start, const std::uint64_t count, char* dst) const;
+
+        /** \brief Reads the points at the given sorted indices of the storage file
+         * \param[in] offsets sorted indices of the points to read
+         * \param[out] dst std::vector the points are appended to
+         */
+        void
+        readPoints (const std::vector<std::uint64_t> &offsets, AlignedPointTVector &dst) const;
+
         /** \brief Name of the storage file on disk (i.e., the PCD file) */
         std::string disk_storage_filename_;
 
+        /** \brief Byte offset of the point records in the storage file, 0 if the file is not stored
+         * in the fixed-stride binary format
+         */
+        std::uint64_t data_offset_;
+
+        /** \brief Fields of the point records in the storage file */
+        std::vector<pcl::PCLPointField> data_fields_;
+
+        /** \brief Size of a point record in the storage file */
+        std::uint32_t data_point_step_;
+
+        /** \brief Whether the storage file is an extent of a read-only packed tree file (see \ref openPacked) */
+        bool packed_;
+
         //--- possibly deprecated parameter variables --//
 
         //number of elements in file
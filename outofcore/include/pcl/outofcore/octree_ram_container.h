@@ -41,6 +41,7 @@
 
 // C++
 #include <mutex>
+#include <ostream>
 #include <random>
 #include <vector>
 
@@ -145,6 +146,27 @@ namespace pcl
         void
         convertToXYZ (const boost::filesystem::path &path);
 
+        /** \brief Packed trees are not supported by the RAM container
+         *  \return false
+         */
+        bool
+        openPacked (const boost::filesystem::path &, const std::uint64_t)
+        {
+          PCL_ERROR ("[pcl::outofcore::OutofcoreOctreeRamContainer] Packed trees are not supported\n");
+          return (false);
+        }
+
+        /** \brief Packed trees are not supported by the RAM container
+         *  \return false
+         */
+        bool
+        writeStorage (std::ostream &, std::uint64_t &size)
+        {
+          size = 0;
+          PCL_ERROR ("[pcl::outofcore::OutofcoreOctreeRamContainer] Packed trees are not supported\n");
+          return (false);
+        }
+
         inline PointT
         operator[] (std::uint64_t index) const
         {
@@ -45,6 +45,7 @@
 
 #include <pcl/common/eigen.h>
 
+#include <istream>
 #include <ostream>
 
 namespace pcl
@@ -158,6 +159,16 @@ namespace pcl
         int 
         loadMetadataFromDisk (const boost::filesystem::path& path_to_metadata);
 
+        /** \brief Writes the fields of the JSON file in binary form to a stream; the file names are stored relative to \ref directory_ */
+        void
+        serializeMetadata (std::ostream& os) const;
+
+        /** \brief Reads the fields written by \ref serializeMetadata; the directory must be set beforehand
+         *  \return true on success, false if the stream ended prematurely
+         */
+        bool
+        loadMetadata (std::istream& is);
+
         friend
         std::ostream& operator<<(std::ostream& os, const OutofcoreOctreeNodeMetadata& metadata_arg);
         
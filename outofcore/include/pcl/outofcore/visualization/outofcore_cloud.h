@@ -59,25 +59,32 @@ class OutofcoreCloud : public Object
 
     struct PcdQueueItem
     {
-      PcdQueueItem (std::string pcd_file, float coverage)
+      PcdQueueItem (std::string pcd_file, float coverage, bool prefetch = false)
       {
        this->pcd_file = pcd_file;
        this->coverage = coverage;
+       this->prefetch = prefetch;
       }
 
+      // Visible nodes are loaded before prefetched ones, larger screen coverage first
       bool operator< (const PcdQueueItem& rhs) const
       {
+       if (prefetch != rhs.prefetch)
+         return prefetch;
        return coverage < rhs.coverage;
       }
 
       std::string pcd_file;
       float coverage;
+      bool prefetch;
     };
 
     using PcdQueue = std::priority_queue<PcdQueueItem>;
     static PcdQueue pcd_queue;
     static std::mutex pcd_queue_mutex;
     static std::condition_variable pcd_queue_ready;
+    // Frame of the requests in pcd_queue; each rendered frame replaces the requests of the previous one
+    static std::size_t pcd_queue_timestamp;
 
     class CloudDataCacheItem : public LRUCacheItem< vtkSmartPointer<vtkPolyData> >
     {
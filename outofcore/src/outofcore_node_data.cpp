@@ -335,6 +335,64 @@ namespace pcl
       return (this->loadMetadataFromDisk ());
     }
 
+    ////////////////////////////////////////////////////////////////////////////////
+
+    namespace
+    {
+      void
+      writeFilename (std::ostream& os, const boost::filesystem::path& path)
+      {
+        const std::string name = path.filename ().generic_string ();
+        const std::uint16_t length = static_cast<std::uint16_t> (name.size ());
+        os.write (reinterpret_cast<const char*> (&length), sizeof (length));
+        os.write (name.data (), length);
+      }
+
+      bool
+      readFilename (std::istream& is, std::string& name)
+      {
+        std::uint16_t length = 0;
+        if (!is.read (reinterpret_cast<char*> (&length), sizeof (length)))
+          return (false);
+        name.resize (length);
+        return (length == 0 || static_cast<bool> (is.read (&name[0], length)));
+      }
+    }
+
+    void
+    OutofcoreOctreeNodeMetadata::serializeMetadata (std::ostream& os) const
+    {
+      const std::int32_t version = outofcore_version_;
+      os.write (reinterpret_cast<const char*> (&version), sizeof (version));
+      os.write (reinterpret_cast<const char*> (min_bb_.data ()), 3 * sizeof (double));
+      os.write (reinterpret_cast<const char*> (max_bb_.data ()), 3 * sizeof (double));
+      writeFilename (os, metadata_filename_);
+      writeFilename (os, binary_point_filename_);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+
+    bool
+    OutofcoreOctreeNodeMetadata::loadMetadata (std::istream& is)
+    {
+      std::int32_t version = 0;
+      std::string metadata_name, point_name;
+      if (!is.read (reinterpret_cast<char*> (&version), sizeof (version)) ||
+          !is.read (reinterpret_cast<char*> (min_bb_.data ()), 3 * sizeof (double)) ||
+          !is.read (reinterpret_cast<char*> (max_bb_.data ()), 3 * sizeof (double)) ||
+          !readFilename (is, metadata_name) || !readFilename (is, point_name))
+      {
+        PCL_ERROR ("[pcl::outofcore::OutofcoreOctreeNodeMetadata::%s] Unexpected end of binary node metadata in %s\n", __FUNCTION__, directory_.c_str ());
+        return (false);
+      }
+
+      outofcore_version_ = version;
+      metadata_filename_ = directory_ / metadata_name;
+      binary_point_filename_ = directory_ / point_name;
+      updateVoxelCenter ();
+      return (true);
+    }
+
     ////////////////////////////////////////////////////////////////////////////////    
 
     std::ostream& 
@@ -48,60 +48,58 @@ OutofcoreCloud::CloudDataCache OutofcoreCloud::cloud_data_cache(524288);
 std::mutex OutofcoreCloud::cloud_data_cache_mutex;
 
 OutofcoreCloud::PcdQueue OutofcoreCloud::pcd_queue;
+std::size_t OutofcoreCloud::pcd_queue_timestamp = 0;
 
 void
 OutofcoreCloud::pcdReaderThread ()
 {
-  std::size_t timestamp = 0;
-
   while (true)
   {
-    std::unique_lock<std::mutex> lock (pcd_queue_mutex);
-    pcd_queue_ready.wait(lock);
-
-    int queue_size = pcd_queue.size ();
-    for (int i=0; i < queue_size; i++)
+    std::string pcd_file;
+    float coverage;
+    std::size_t timestamp;
     {
-      const PcdQueueItem *pcd_queue_item = &pcd_queue.top();
+      std::unique_lock<std::mutex> lock (pcd_queue_mutex);
+      pcd_queue_ready.wait (lock, [] { return !pcd_queue.empty (); });
 
-      if (cloud_data_cache.hasKey(pcd_queue_item->pcd_file))
+      pcd_file = pcd_queue.top ().pcd_file;
+      coverage = pcd_queue.top ().coverage;
+      timestamp = pcd_queue_timestamp;
+      pcd_queue.pop ();
+    }
+
+    {
+      std::lock_guard<std::mutex> lock (cloud_data_cache_mutex);
+      if (cloud_data_cache.hasKey (pcd_file))
       {
-        CloudDataCacheItem *cloud_data_cache_item = &cloud_data_cache.get(pcd_queue_item->pcd_file);
-        cloud_data_cache_item->timestamp = timestamp;
+        cloud_data_cache.get (pcd_file).timestamp = timestamp;
+        continue;
       }
-      else
-      {
-        vtkSmartPointer<vtkPolyData> cloud_data = vtkSmartPointer<vtkPolyData>::New ();
-
-        pcl::PCLPointCloud2Ptr cloud (new pcl::PCLPointCloud2);
+    }
 
-        pcl::io::loadPCDFile (pcd_queue_item->pcd_file, *cloud);
-        pcl::io::pointCloudTovtkPolyData (cloud, cloud_data);
+    // Read the node without holding any lock so that the render thread can keep drawing and replacing stale requests
+    vtkSmartPointer<vtkPolyData> cloud_data = vtkSmartPointer<vtkPolyData>::New ();
 
-        CloudDataCacheItem cloud_data_cache_item(pcd_queue_item->pcd_file, pcd_queue_item->coverage, cloud_data, timestamp);
+    pcl::PCLPointCloud2Ptr cloud (new pcl::PCLPointCloud2);
 
-        cloud_data_cache_mutex.lock();
-        bool inserted = cloud_data_cache.insert(pcd_queue_item->pcd_file, cloud_data_cache_item);
-        cloud_data_cache_mutex.unlock();
+    pcl::io::loadPCDFile (pcd_file, *cloud);
+    pcl::io::pointCloudTovtkPolyData (cloud, cloud_data);
 
-        if (!inserted)
-        {
-          //std::cout << "CACHE FILLED" << std::endl;
-          while (!pcd_queue.empty())
-          {
-            //const PcdQueueItem *pcd_queue_item = &pcd_queue.top();
-            //std::cout << "Skipping: " << pcd_queue_item->pcd_file <<std::endl;
-            pcd_queue.pop();
-          }
-          break;
-        }
-        //std::cout << "Loaded: " << pcd_queue_item->pcd_file << std::endl;
-      }
+    CloudDataCacheItem cloud_data_cache_item (pcd_file, coverage, cloud_data, timestamp);
 
-      pcd_queue.pop();
+    bool inserted;
+    {
+      std::lock_guard<std::mutex> lock (cloud_data_cache_mutex);
+      inserted = cloud_data_cache.insert (pcd_file, cloud_data_cache_item);
     }
 
-    timestamp++;
+    // The cache is filled with nodes of the current frame; drop its remaining requests
+    if (!inserted)
+    {
+      std::lock_guard<std::mutex> lock (pcd_queue_mutex);
+      if (pcd_queue_timestamp == timestamp)
+        pcd_queue = PcdQueue ();
+    }
   }
 }
 
@@ -187,6 +185,14 @@ OutofcoreCloud::render (vtkRenderer* renderer)
 
     cloud_actors_->RemoveAllItems ();
 
+    // Requests of this frame; they replace the pending requests of previous frames once culling is done
+    PcdQueue pcd_requests;
+    std::size_t timestamp;
+    {
+      std::lock_guard<std::mutex> lock (pcd_queue_mutex);
+      timestamp = pcd_queue_timestamp + 1;
+    }
+
     while ( *breadth_first_it !=nullptr )
     {
       OctreeDiskNode *node = *breadth_first_it;
@@ -207,6 +213,17 @@ OutofcoreCloud::render (vtkRenderer* renderer)
       if (coverage <= lod_pixel_threshold_)
       {
         breadth_first_it.skipChildVoxels();
+
+        // Prefetch the children of nodes that are about to be refined when the camera gets closer
+        if (coverage > lod_pixel_threshold_ / 4 && node->getDepth () < display_depth_ && node->getNodeType () == pcl::octree::BRANCH_NODE)
+        {
+          for (unsigned char child_idx = 0; child_idx < 8; child_idx++)
+          {
+            OctreeDiskNode *child = octree_->getBranchChildPtr (*node, child_idx);
+            if (child)
+              pcd_requests.push (PcdQueueItem (child->getPCDFilename ().string (), coverage / 4, true));
+          }
+        }
       }
 
 //      for (int i=0; i < node->getDepth(); i++)
@@ -217,23 +234,17 @@ OutofcoreCloud::render (vtkRenderer* renderer)
 
       cloud_data_cache_mutex.lock();
 
-      PcdQueueItem pcd_queue_item(pcd_file, coverage);
-
-      // If we can lock the queue add another item
-      if (pcd_queue_mutex.try_lock())
-      {
-        pcd_queue.push(pcd_queue_item);
-        pcd_queue_mutex.unlock();
-      }
-
       if (cloud_data_cache.hasKey(pcd_file))
       {
+        // Mark the node as used by this frame so it is not evicted for the nodes still to be loaded
+        CloudDataCacheItem *cloud_data_cache_item = &cloud_data_cache.get(pcd_file);
+        cloud_data_cache_item->timestamp = timestamp;
+
         //std::cout << "Has Key for: " << pcd_file << std::endl;
         if (cloud_actors_map_.find (pcd_file) == cloud_actors_map_.end ())
         {
 
           vtkSmartPointer<vtkActor> cloud_actor = vtkSmartPointer<vtkActor>::New ();
-          CloudDataCacheItem *cloud_data_cache_item = &cloud_data_cache.get(pcd_file);
 
 #if VTK_RENDERING_BACKEND_OPENGL_VERSION < 2
           vtkSmartPointer<vtkVertexBufferObjectMapper> mapper = vtkSmartPointer<vtkVertexBufferObjectMapper>::New ();
@@ -264,13 +275,25 @@ OutofcoreCloud::render (vtkRenderer* renderer)
         cloud_actors_->AddItem (cloud_actors_map_[pcd_file]);
         addActor (cloud_actors_map_[pcd_file]);
       }
+      else
+      {
+        pcd_requests.push (PcdQueueItem (pcd_file, coverage));
+
+        // Release the actor of evicted node data
+        cloud_actors_map_.erase (pcd_file);
+      }
 
       cloud_data_cache_mutex.unlock();
 
       breadth_first_it++;
     }
 
-    // We're done culling, notify the pcd_reader thread the queue is read
+    // We're done culling, cancel the stale requests and notify the pcd_reader thread the queue is ready
+    {
+      std::lock_guard<std::mutex> lock (pcd_queue_mutex);
+      pcd_queue.swap (pcd_requests);
+      pcd_queue_timestamp = timestamp;
+    }
     pcd_queue_ready.notify_one();
 
     std::vector<vtkActor*> actors_to_remove;
@@ -95,7 +95,8 @@ getCloudFromFile (boost::filesystem::path pcd_path)
 
 int
 outofcoreProcess (std::vector<boost::filesystem::path> pcd_paths, boost::filesystem::path root_dir, 
-                  int depth, double resolution, int build_octree_with, bool gen_lod, bool overwrite, bool multiresolution)
+                  int depth, double resolution, int build_octree_with, bool gen_lod, bool overwrite, bool multiresolution,
+                  unsigned int threads, unsigned int lod_voxels, bool node_index, bool pack)
 {
   // Bounding box min/max pts
   PointT min_pt, max_pt;
@@ -176,6 +177,8 @@ outofcoreProcess (std::vector<boost::filesystem::path> pcd_paths, boost::filesys
     outofcore_octree = new octree_disk (bounding_box_min, bounding_box_max, resolution, octree_path_on_disk, "ECEF");
   }
 
+  outofcore_octree->setNumberOfThreads (threads);
+
   std::uint64_t total_pts = 0;
 
   // Iterate over all pcd files adding points to the octree
@@ -217,7 +220,23 @@ outofcoreProcess (std::vector<boost::filesystem::path> pcd_paths, boost::filesys
   {
     print_info ("Generating LOD...\n");
     outofcore_octree->setSamplePercent (0.25);
-    outofcore_octree->buildLOD ();
+    if (lod_voxels > 0)
+      outofcore_octree->buildLODBottomUp (lod_voxels);
+    else
+      outofcore_octree->buildLOD ();
+  }
+
+  if (node_index)
+  {
+    print_info ("Writing binary node index...\n");
+    outofcore_octree->saveNodeIndex ();
+  }
+
+  if (pack)
+  {
+    print_info ("Packing the node data into a single file...\n");
+    if (!outofcore_octree->packNodes (true))
+      PCL_ERROR ("Failed to pack the octree\n");
   }
 
   //free outofcore data structure; the destructor forces buffer flush to disk
@@ -239,6 +258,10 @@ printHelp (int, char **argv)
   print_info ("\t -gen_lod                      \t Generate octree LODs\n");
   print_info ("\t -overwrite                    \t Overwrite existing octree\n");
   print_info ("\t -multiresolution              \t Generate multiresolutoin LOD\n");
+  print_info ("\t -threads <threads>            \t Number of threads used for insertion and LOD generation (0: automatic, default: 1)\n");
+  print_info ("\t -lod_voxels <resolution>      \t Build the multiresolution LOD bottom-up, keeping one point per cell of a resolution^3 grid per node\n");
+  print_info ("\t -node_index                   \t Write a binary index of the node metadata for faster loading\n");
+  print_info ("\t -pack                         \t Pack the node data into a single read-only file and remove the node directories\n");
   print_info ("\t -h                            \t Display help\n");
   print_info ("\n");
 }
@@ -274,6 +297,10 @@ main (int argc, char* argv[])
   bool gen_lod = false;
   bool multiresolution = false;
   bool overwrite = false;
+  unsigned int threads = 1;
+  unsigned int lod_voxels = 0;
+  bool node_index = false;
+  bool pack = false;
   int build_octree_with = OCTREE_DEPTH;
 
   // If both depth and resolution specified
@@ -292,6 +319,10 @@ main (int argc, char* argv[])
   parse_argument (argc, argv, "-resolution", resolution);
   gen_lod = find_switch (argc, argv, "-gen_lod");
   overwrite = find_switch (argc, argv, "-overwrite");
+  node_index = find_switch (argc, argv, "-node_index");
+  pack = find_switch (argc, argv, "-pack");
+  parse_argument (argc, argv, "-threads", threads);
+  parse_argument (argc, argv, "-lod_voxels", lod_voxels);
 
   if (gen_lod && find_switch (argc, argv, "-multiresolution"))
   {
@@ -329,5 +360,5 @@ main (int argc, char* argv[])
   if (root_dir.extension () == ".pcd")
     root_dir = root_dir.parent_path () / (root_dir.stem().string() + "_tree").c_str();
 
-  return outofcoreProcess (pcd_paths, root_dir, depth, resolution, build_octree_with, gen_lod, overwrite, multiresolution);
+  return outofcoreProcess (pcd_paths, root_dir, depth, resolution, build_octree_with, gen_lod, overwrite, multiresolution, threads, lod_voxels, node_index, pack);
 }
@@ -137,6 +137,14 @@ namespace pcl
       void
       setClassifier (pcl::people::PersonClassifier<pcl::RGB> person_classifier);
 
+      /**
+       * \brief Set the number of threads the clusters are sub-clustered and classified with.
+       *
+       * \param[in] nr_threads The number of hardware threads to use (0 sets the value back to automatic).
+       */
+      void
+      setNumberOfThreads (unsigned int nr_threads = 0);
+
       /**
        * \brief Set the field of view of the point cloud in z direction.
        *
@@ -367,6 +375,9 @@ namespace pcl
       
       /** \brief flag stating if the classifier has been set or not */
       bool person_classifier_set_flag_;
+
+      /** \brief the number of threads the clusters are sub-clustered and classified with */
+      unsigned int threads_;
     };
   } /* namespace people */
 } /* namespace pcl */
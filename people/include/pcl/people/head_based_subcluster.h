@@ -189,6 +189,14 @@ namespace pcl
       float
       getMinimumDistanceBetweenHeads ();
 
+      /**
+       * \brief Set the number of threads the clusters are processed with.
+       *
+       * \param[in] nr_threads The number of hardware threads to use (0 sets the value back to automatic).
+       */
+      void
+      setNumberOfThreads (unsigned int nr_threads = 0);
+
     protected:
       /** \brief ground plane coefficients */
       Eigen::VectorXf ground_coeffs_;            
@@ -223,6 +231,9 @@ namespace pcl
       
       /** \brief minimum distance between persons' heads */
       float heads_minimum_distance_;           
+
+      /** \brief the number of threads the clusters are processed with */
+      unsigned int threads_;
     };
   } /* namespace people */
 } /* namespace pcl */
@@ -42,6 +42,7 @@
 #define PCL_PEOPLE_GROUND_BASED_PEOPLE_DETECTION_APP_HPP_
 
 #include <pcl/people/ground_based_people_detection_app.h>
+#include <pcl/common/utils.h> // for getNumberOfThreads
 
 template <typename PointT>
 pcl::people::GroundBasedPeopleDetectionApp<PointT>::GroundBasedPeopleDetectionApp ()
@@ -61,6 +62,7 @@ pcl::people::GroundBasedPeopleDetectionApp<PointT>::GroundBasedPeopleDetectionAp
   max_width_ = 8.0;
   updateMinMaxPoints ();
   heads_minimum_distance_ = 0.3;
+  threads_ = 0;
 
   // set flag values for mandatory parameters:
   sqrt_ground_coeffs_ = std::numeric_limits<float>::quiet_NaN();
@@ -129,6 +131,12 @@ pcl::people::GroundBasedPeopleDetectionApp<PointT>::setClassifier (pcl::people::
   person_classifier_set_flag_ = true;
 }
 
+template <typename PointT> void
+pcl::people::GroundBasedPeopleDetectionApp<PointT>::setNumberOfThreads (unsigned int nr_threads)
+{
+  threads_ = nr_threads;
+}
+
 template <typename PointT> void
 pcl::people::GroundBasedPeopleDetectionApp<PointT>::setFOV (float min_fov, float max_fov)
 {
@@ -390,6 +398,7 @@ pcl::people::GroundBasedPeopleDetectionApp<PointT>::compute (std::vector<pcl::pe
   subclustering.setHeightLimits(min_height_, max_height_);
   subclustering.setMinimumDistanceBetweenHeads(heads_minimum_distance_);
   subclustering.setSensorPortraitOrientation(vertical_);
+  subclustering.setNumberOfThreads(threads_);
   subclustering.subcluster(clusters);
 
   // Person confidence evaluation with HOG+SVM:
@@ -397,16 +406,23 @@ pcl::people::GroundBasedPeopleDetectionApp<PointT>::compute (std::vector<pcl::pe
   {
     swapDimensions(rgb_image_);
   }
-  for(typename std::vector<pcl::people::PersonCluster<PointT> >::iterator it = clusters.begin(); it != clusters.end(); ++it)
+  // the clusters are classified independently, HOG descriptors of different clusters are computed in parallel
+#pragma omp parallel for \
+  default(none) \
+  shared(clusters) \
+  schedule(dynamic) \
+  num_threads(pcl::utils::getNumberOfThreads (threads_))
+  for(int i = 0; i < static_cast<int>(clusters.size()); i++)
   {
+    pcl::people::PersonCluster<PointT>& cluster = clusters[i];
     //Evaluate confidence for the current PersonCluster:
-    Eigen::Vector3f centroid = intrinsics_matrix_transformed_ * (it->getTCenter());
+    Eigen::Vector3f centroid = intrinsics_matrix_transformed_ * (cluster.getTCenter());
     centroid /= centroid(2);
-    Eigen::Vector3f top = intrinsics_matrix_transformed_ * (it->getTTop());
+    Eigen::Vector3f top = intrinsics_matrix_transformed_ * (cluster.getTTop());
     top /= top(2);
-    Eigen::Vector3f bottom = intrinsics_matrix_transformed_ * (it->getTBottom());
+    Eigen::Vector3f bottom = intrinsics_matrix_transformed_ * (cluster.getTBottom());
     bottom /= bottom(2);
-    it->setPersonConfidence(person_classifier_.evaluate(rgb_image_, bottom, top, centroid, vertical_));
+    cluster.setPersonConfidence(person_classifier_.evaluate(rgb_image_, bottom, top, centroid, vertical_));
   }
  
   return (true);
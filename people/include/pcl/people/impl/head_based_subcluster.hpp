@@ -42,6 +42,7 @@
 #define PCL_PEOPLE_HEAD_BASED_SUBCLUSTER_HPP_
 
 #include <pcl/people/head_based_subcluster.h>
+#include <pcl/common/utils.h> // for getNumberOfThreads
 
 template <typename PointT>
 pcl::people::HeadBasedSubclustering<PointT>::HeadBasedSubclustering ()
@@ -54,6 +55,7 @@ pcl::people::HeadBasedSubclustering<PointT>::HeadBasedSubclustering ()
   min_points_ = 30;
   max_points_ = 5000;
   heads_minimum_distance_ = 0.3;
+  threads_ = 0;
 
   // set flag values for mandatory parameters:
   sqrt_ground_coeffs_ = std::numeric_limits<float>::quiet_NaN();
@@ -110,6 +112,12 @@ pcl::people::HeadBasedSubclustering<PointT>::setHeadCentroid (bool head_centroid
   head_centroid_ = head_centroid;
 }
 
+template <typename PointT> void
+pcl::people::HeadBasedSubclustering<PointT>::setNumberOfThreads (unsigned int nr_threads)
+{
+  threads_ = nr_threads;
+}
+
 template <typename PointT> void
 pcl::people::HeadBasedSubclustering<PointT>::getHeightLimits (float& min_height, float& max_height)
 {
@@ -271,12 +279,19 @@ pcl::people::HeadBasedSubclustering<PointT>::subcluster (std::vector<pcl::people
     return;
   }
 
-  // Person clusters creation from clusters indices:
-  for(std::vector<pcl::PointIndices>::const_iterator it = cluster_indices_.begin(); it != cluster_indices_.end(); ++it)
+  // Person clusters creation from clusters indices, in parallel and kept in the order of the indices:
+  std::vector<std::vector<pcl::people::PersonCluster<PointT> > > created_clusters(cluster_indices_.size());
+#pragma omp parallel for \
+  default(none) \
+  shared(created_clusters) \
+  schedule(dynamic) \
+  num_threads(pcl::utils::getNumberOfThreads (threads_))
+  for(int i = 0; i < static_cast<int>(cluster_indices_.size()); i++)
   {
-    pcl::people::PersonCluster<PointT> cluster(cloud_, *it, ground_coeffs_, sqrt_ground_coeffs_, head_centroid_, vertical_);  // PersonCluster creation
-    clusters.push_back(cluster);
+    created_clusters[i].emplace_back(cloud_, cluster_indices_[i], ground_coeffs_, sqrt_ground_coeffs_, head_centroid_, vertical_);  // PersonCluster creation
   }
+  for(const auto& created : created_clusters)
+    clusters.push_back(created.front());
 
   // Remove clusters with too high height from the ground plane:
   std::vector<pcl::people::PersonCluster<PointT> > new_clusters;
@@ -292,43 +307,56 @@ pcl::people::HeadBasedSubclustering<PointT>::subcluster (std::vector<pcl::people
   mergeClustersCloseInFloorCoordinates(clusters, new_clusters);
   clusters = new_clusters;
 
-  std::vector<pcl::people::PersonCluster<PointT> > subclusters;
   int cluster_min_points_sub = int(float(min_points_) * 1.5);
   //  int cluster_max_points_sub = max_points_;
 
-  // create HeightMap2D object:
-  pcl::people::HeightMap2D<PointT> height_map_obj;
-  height_map_obj.setGround(ground_coeffs_);
-  height_map_obj.setInputCloud(cloud_);
-  height_map_obj.setSensorPortraitOrientation(vertical_);
-  height_map_obj.setMinimumDistanceBetweenMaxima(heads_minimum_distance_);
-  for(typename std::vector<pcl::people::PersonCluster<PointT> >::iterator it = clusters.begin(); it != clusters.end(); ++it)   // for every cluster
+  // The clusters are sub-clustered independently, each into its own list so that the order is kept:
+  std::vector<std::vector<pcl::people::PersonCluster<PointT> > > cluster_subclusters(clusters.size());
+#pragma omp parallel for \
+  default(none) \
+  shared(cluster_min_points_sub, cluster_subclusters, clusters) \
+  schedule(dynamic) \
+  num_threads(pcl::utils::getNumberOfThreads (threads_))
+  for(int i = 0; i < static_cast<int>(clusters.size()); i++)   // for every cluster
   {
-    float height = it->getHeight();
-    int number_of_points = it->getNumberPoints();
+    pcl::people::PersonCluster<PointT>& cluster = clusters[i];
+    std::vector<pcl::people::PersonCluster<PointT> >& subclusters = cluster_subclusters[i];
+    float height = cluster.getHeight();
+    int number_of_points = cluster.getNumberPoints();
     if(height > min_height_ && height < max_height_)
     {
       if (number_of_points > cluster_min_points_sub) //  && number_of_points < cluster_max_points_sub)
       {
+        // create HeightMap2D object:
+        pcl::people::HeightMap2D<PointT> height_map_obj;
+        height_map_obj.setGround(ground_coeffs_);
+        height_map_obj.setInputCloud(cloud_);
+        height_map_obj.setSensorPortraitOrientation(vertical_);
+        height_map_obj.setMinimumDistanceBetweenMaxima(heads_minimum_distance_);
+
         // Compute height map associated to the current cluster and its local maxima (heads):
-        height_map_obj.compute(*it);
+        height_map_obj.compute(cluster);
         if (height_map_obj.getMaximaNumberAfterFiltering() > 1)        // if more than one maximum
         {
           // create new clusters from the current cluster and put corresponding indices into sub_clusters_indices:
-          createSubClusters(*it, height_map_obj.getMaximaNumberAfterFiltering(), height_map_obj.getMaximaCloudIndicesFiltered(), subclusters);
+          createSubClusters(cluster, height_map_obj.getMaximaNumberAfterFiltering(), height_map_obj.getMaximaCloudIndicesFiltered(), subclusters);
         }
         else
         {  // Only one maximum --> copy original cluster:
-          subclusters.push_back(*it);
+          subclusters.push_back(cluster);
         }
       }
       else
       {
         // Cluster properties not good for sub-clustering --> copy original cluster:
-        subclusters.push_back(*it);
+        subclusters.push_back(cluster);
       }
     }
   }
+
+  std::vector<pcl::people::PersonCluster<PointT> > subclusters;
+  for(const auto& current_subclusters : cluster_subclusters)
+    subclusters.insert(subclusters.end(), current_subclusters.begin(), current_subclusters.end());
   clusters = subclusters;    // substitute clusters with subclusters
 }
 
@@ -254,12 +254,10 @@ pcl::people::PersonClassifier<PointT>::evaluate (float height_person,
     float *descriptor = (float*) calloc(SVM_weights_.size(), sizeof(float));
     hog.compute(sample_float, descriptor);
  
-    // Calculate confidence value by dot product:
-    confidence = 0.0;
-    for(std::size_t i = 0; i < SVM_weights_.size(); i++)
-    { 
-      confidence += SVM_weights_[i] * descriptor[i];
-    }
+    // Calculate confidence value by dot product, accumulated in double precision as before but vectorized:
+    const Eigen::Map<const Eigen::VectorXf> weights (SVM_weights_.data (), SVM_weights_.size ());
+    const Eigen::Map<const Eigen::VectorXf> features (descriptor, SVM_weights_.size ());
+    confidence = weights.cast<double> ().dot (features.cast<double> ());
     // Confidence correction:
     confidence -= SVM_offset_;  
 
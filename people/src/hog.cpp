@@ -477,20 +477,23 @@ pcl::people::HOG::grad1 (float *I, float *Gx, float *Gy, int h, int w, int x) co
 float* 
 pcl::people::HOG::acosTable () const
 {
-  int n = 25000;
-  int n2 = n / 2;
-  static float a[25000];
-  static bool init = false;
-  if( init ) return a+n2;
-  float ni = 2.02f/(float) n;
-  for(int i=0; i<n; i++ )
+  const int n = 25000;
+  const int n2 = n / 2;
+  static float a[n];
+  // filled once, also when several threads compute descriptors concurrently
+  static const bool init = [&]
   {
-    float t = i*ni - 1.01f;
-    t = t<-1 ? -1 : (t>1 ? 1 : t);
-    t = (float) std::acos( t );
-    a[i] = (t <= M_PI-1e-5f) ? t : 0;
-  }
-  init = true;
+    float ni = 2.02f/(float) n;
+    for(int i=0; i<n; i++ )
+    {
+      float t = i*ni - 1.01f;
+      t = t<-1 ? -1 : (t>1 ? 1 : t);
+      t = (float) std::acos( t );
+      a[i] = (t <= M_PI-1e-5f) ? t : 0;
+    }
+    return true;
+  } ();
+  (void) init;
   return a+n2;
 }
       
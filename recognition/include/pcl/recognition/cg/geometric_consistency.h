@@ -64,6 +64,7 @@ namespace pcl
       GeometricConsistencyGrouping () 
         : gc_threshold_ (3)
         , gc_size_ (1.0)
+        , threads_ (1)
       {}
 
       
@@ -106,6 +107,12 @@ namespace pcl
         return (gc_size_);
       }
 
+      /** \brief Initialize the scheduler and set the number of threads to use for the consistency checks (1 by default).
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      void
+      setNumberOfThreads (unsigned int nr_threads = 0);
+
       /** \brief The main function, recognizes instances of the model into the scene set by the user.
         * 
         * \param[out] transformations a vector containing one transformation matrix for each instance of the model recognized into the scene.
@@ -136,6 +143,9 @@ namespace pcl
       /** \brief Resolution of the consensus set used to cluster correspondences together*/
       double gc_size_;
 
+      /** \brief The number of threads the scheduler should use. */
+      unsigned int threads_;
+
       /** \brief Transformations found by clusterCorrespondences method. */
       std::vector<Eigen::Matrix4f, Eigen::aligned_allocator<Eigen::Matrix4f> > found_transformations_;
 
@@ -96,6 +96,15 @@ namespace pcl
         int
         voteInt (const Eigen::Vector3d &single_vote_coord, double weight, int voter_id);
 
+        /** \brief Add the votes cast into another Hough space with the same dimensions, e.g. one filled by another thread.
+          * The voter ids of \a other are appended to the ones of this space, bin by bin.
+          *
+          * \param[in] other the Hough space to add.
+          * \return false if the dimensions of the two Hough spaces differ.
+          */
+        bool
+        merge (const HoughSpace3D &other);
+
         /** \brief Find the bins with most votes.
           *
           * \param[in] min_threshold the minimum number of votes to be included in a bin in order to have its value returned.
@@ -175,6 +184,7 @@ namespace pcl
         , local_rf_normals_search_radius_ (0.0f)
         , local_rf_search_radius_ (0.0f)
         , hough_space_initialized_ (false)
+        , threads_ (1)
       {}
 
       /** \brief Provide a pointer to the input dataset.
@@ -415,6 +425,12 @@ namespace pcl
       bool
       train ();
 
+      /** \brief Initialize the scheduler and set the number of threads to use for the Hough voting (1 by default).
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      void
+      setNumberOfThreads (unsigned int nr_threads = 0);
+
       /** \brief The main function, recognizes instances of the model into the scene set by the user.
         *
         * \param[out] transformations a vector containing one transformation matrix for each instance of the model recognized into the scene.
@@ -480,6 +496,9 @@ namespace pcl
         */
       bool hough_space_initialized_;
 
+      /** \brief The number of threads the scheduler should use. */
+      unsigned int threads_;
+
       /** \brief Cluster the input correspondences in order to distinguish between different instances of the model into the scene.
         *
         * \param[out] model_instances a vector containing the clustered correspondences for each model found on the scene.
@@ -195,6 +195,7 @@ namespace pcl
       using HypothesisVerification<ModelT, SceneT>::complete_models_;
       using HypothesisVerification<ModelT, SceneT>::resolution_;
       using HypothesisVerification<ModelT, SceneT>::inliers_threshold_;
+      using HypothesisVerification<ModelT, SceneT>::threads_;
 
       //class attributes
       using NormalEstimator_ = pcl::NormalEstimation<SceneT, pcl::Normal>;
@@ -222,6 +223,7 @@ namespace pcl
       int previous_duplicity_complete_models_;
       float previous_bad_info_;
       float previous_unexplained_;
+      int previous_active_hypotheses_; //number of active hypotheses in the current solution
 
       int max_iterations_; //max iterations without improvement
       SAModel best_seen_;
@@ -265,6 +267,16 @@ namespace pcl
         return previous_unexplained_;
       }
 
+      void setPreviousActiveHypotheses(int n)
+      {
+        previous_active_hypotheses_ = n;
+      }
+
+      int getPreviousActiveHypotheses()
+      {
+        return previous_active_hypotheses_;
+      }
+
       float getExplainedValue()
       {
         return previous_explained_value;
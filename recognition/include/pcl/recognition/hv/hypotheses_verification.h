@@ -40,6 +40,7 @@
 #include "pcl/recognition/hv/occlusion_reasoning.h"
 #include "pcl/recognition/impl/hv/occlusion_reasoning.hpp"
 #include <pcl/common/common.h>
+#include <pcl/common/utils.h> // for getNumberOfThreads
 #include <pcl/search/kdtree.h>
 #include <pcl/filters/voxel_grid.h>
 
@@ -128,6 +129,21 @@ namespace pcl
      * \brief Whether the normals have been set
      */
     bool normals_set_;
+
+    /*
+     * \brief Number of threads used to process the hypotheses, 0 meaning all the cores
+     */
+    unsigned int threads_;
+
+    /*
+     * \brief Depth buffer of occlusion_cloud_ when it is not organized, kept for the next calls to addModels
+     */
+    std::shared_ptr<pcl::occlusion_reasoning::ZBuffering<ModelT, SceneT> > zbuffer_scene_;
+
+    /*
+     * \brief The cloud zbuffer_scene_ was computed from
+     */
+    typename pcl::PointCloud<SceneT>::ConstPtr zbuffer_scene_cloud_;
   public:
 
     HypothesisVerification ()
@@ -140,6 +156,7 @@ namespace pcl
       occlusion_thres_ = 0.005f;
       normals_set_ = false;
       requires_normals_ = false;
+      threads_ = 0;
     }
 
     virtual
@@ -176,6 +193,15 @@ namespace pcl
       inliers_threshold_ = r;
     }
 
+    /*
+     *  \brief Sets the number of threads used to process the hypotheses
+     *  nr_threads the number of threads, 0 (default) meaning all the cores
+     */
+    void
+    setNumberOfThreads (unsigned int nr_threads = 0) {
+      threads_ = nr_threads;
+    }
+
     /*
      *  \brief Returns a vector of booleans representing which hypotheses have been accepted/rejected (true/false)
      *  mask vector of booleans
@@ -240,13 +266,25 @@ namespace pcl
           PCL_WARN("Scene not organized... filtering using computed depth buffer\n");
         }
 
-        pcl::occlusion_reasoning::ZBuffering<ModelT, SceneT> zbuffer_scene (zbuffer_scene_resolution_, zbuffer_scene_resolution_, 1.f);
-        if (!occlusion_cloud_->isOrganized ())
+        //the depth buffer of the scene only depends on the occlusion cloud, compute it once for all the calls
+        if (!occlusion_cloud_->isOrganized () && (!zbuffer_scene_ || zbuffer_scene_cloud_ != occlusion_cloud_))
         {
-          zbuffer_scene.computeDepthMap (occlusion_cloud_, true);
+          zbuffer_scene_.reset (new pcl::occlusion_reasoning::ZBuffering<ModelT, SceneT> (zbuffer_scene_resolution_, zbuffer_scene_resolution_, 1.f));
+          zbuffer_scene_->computeDepthMap (occlusion_cloud_, true);
+          zbuffer_scene_cloud_ = occlusion_cloud_;
         }
 
-        for (std::size_t i = 0; i < models.size (); i++)
+        bool filter_normals = normals_set_ && requires_normals_;
+        std::vector<typename pcl::PointCloud<ModelT>::ConstPtr> visible_models (models.size ());
+        std::vector<typename pcl::PointCloud<pcl::Normal>::ConstPtr> visible_normal_models (filter_normals ? models.size () : 0);
+
+        //the hypotheses are independent, each one only reads the shared depth buffer
+#pragma omp parallel for \
+  default(none) \
+  shared(filter_normals, models, visible_models, visible_normal_models) \
+  schedule(dynamic) \
+  num_threads(pcl::utils::getNumberOfThreads (threads_))
+        for (int i = 0; i < static_cast<int> (models.size ()); i++)
         {
 
           //self-occlusions
@@ -257,10 +295,10 @@ namespace pcl
           zbuffer_self_occlusion.filter (models[i], indices, 0.005f);
           pcl::copyPointCloud (*models[i], indices, *filtered);
 
-          if(normals_set_ && requires_normals_) {
+          if(filter_normals) {
             pcl::PointCloud<pcl::Normal>::Ptr filtered_normals (new pcl::PointCloud<pcl::Normal> ());
             pcl::copyPointCloud(*complete_normal_models_[i], indices, *filtered_normals);
-            visible_normal_models_.push_back(filtered_normals);
+            visible_normal_models[i] = filtered_normals;
           }
 
           typename pcl::PointCloud<ModelT>::ConstPtr const_filtered(new pcl::PointCloud<ModelT> (*filtered));
@@ -272,12 +310,15 @@ namespace pcl
           }
           else
           {
-            zbuffer_scene.filter (const_filtered, filtered, occlusion_thres_);
+            zbuffer_scene_->filter (const_filtered, filtered, occlusion_thres_);
           }
 
-          visible_models_.push_back (filtered);
+          visible_models[i] = filtered;
         }
 
+        visible_models_.insert (visible_models_.end (), visible_models.begin (), visible_models.end ());
+        visible_normal_models_.insert (visible_normal_models_.end (), visible_normal_models.begin (), visible_normal_models.end ());
+
         complete_models_ = models;
       }
 
@@ -299,6 +340,8 @@ namespace pcl
       visible_normal_models_.clear();
 
       scene_cloud_ = scene_cloud;
+      zbuffer_scene_.reset();
+      zbuffer_scene_cloud_.reset();
       scene_cloud_downsampled_.reset(new pcl::PointCloud<SceneT>());
 
       pcl::VoxelGrid<SceneT> voxel_grid;
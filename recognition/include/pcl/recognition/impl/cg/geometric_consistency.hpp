@@ -44,6 +44,147 @@
 #include <pcl/registration/correspondence_types.h>
 #include <pcl/registration/correspondence_rejection_sample_consensus.h>
 #include <pcl/common/io.h>
+#include <pcl/common/utils.h> // for getNumberOfThreads
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace pcl
+{
+  namespace detail
+  {
+    /** \brief The correspondences that may still join a consensus set, with their scene and model points stored
+      * coordinate by coordinate so that their consistency with a member of the set is checked with SIMD instructions.
+      */
+    struct ConsistencyCandidates
+    {
+      std::vector<int> ids;
+      std::vector<float> scene_x, scene_y, scene_z;
+      std::vector<float> model_x, model_y, model_z;
+
+      /** \brief Buffer for the consistency errors. */
+      std::vector<float> errors;
+
+      inline std::size_t
+      size () const
+      {
+        return (ids.size ());
+      }
+
+      inline void
+      clear ()
+      {
+        ids.clear ();
+        scene_x.clear (); scene_y.clear (); scene_z.clear ();
+        model_x.clear (); model_y.clear (); model_z.clear ();
+      }
+
+      inline void
+      push_back (int id, const Eigen::Vector3f &scene_point, const Eigen::Vector3f &model_point)
+      {
+        ids.push_back (id);
+        scene_x.push_back (scene_point[0]); scene_y.push_back (scene_point[1]); scene_z.push_back (scene_point[2]);
+        model_x.push_back (model_point[0]); model_y.push_back (model_point[1]); model_z.push_back (model_point[2]);
+      }
+
+      /** \brief Compute |dist (scene_point, scene_c) - dist (model_point, model_c)| for the candidates c in [begin, end). */
+      inline void
+      computeErrors (const Eigen::Vector3f &scene_point, const Eigen::Vector3f &model_point, std::size_t begin, std::size_t end)
+      {
+        std::size_t c = begin;
+#if defined(__SSE2__)
+        const __m128 sign_mask = _mm_set1_ps (-0.0f);
+        for (; c + 4 <= end; c += 4)
+        {
+          const __m128 dsx = _mm_sub_ps (_mm_set1_ps (scene_point[0]), _mm_loadu_ps (&scene_x[c]));
+          const __m128 dsy = _mm_sub_ps (_mm_set1_ps (scene_point[1]), _mm_loadu_ps (&scene_y[c]));
+          const __m128 dsz = _mm_sub_ps (_mm_set1_ps (scene_point[2]), _mm_loadu_ps (&scene_z[c]));
+          const __m128 dmx = _mm_sub_ps (_mm_set1_ps (model_point[0]), _mm_loadu_ps (&model_x[c]));
+          const __m128 dmy = _mm_sub_ps (_mm_set1_ps (model_point[1]), _mm_loadu_ps (&model_y[c]));
+          const __m128 dmz = _mm_sub_ps (_mm_set1_ps (model_point[2]), _mm_loadu_ps (&model_z[c]));
+          const __m128 scene_dist = _mm_sqrt_ps (_mm_add_ps (_mm_add_ps (_mm_mul_ps (dsx, dsx), _mm_mul_ps (dsy, dsy)), _mm_mul_ps (dsz, dsz)));
+          const __m128 model_dist = _mm_sqrt_ps (_mm_add_ps (_mm_add_ps (_mm_mul_ps (dmx, dmx), _mm_mul_ps (dmy, dmy)), _mm_mul_ps (dmz, dmz)));
+          // The andnot-function realizes an abs-operation: the sign bit is removed
+          _mm_storeu_ps (&errors[c], _mm_andnot_ps (sign_mask, _mm_sub_ps (scene_dist, model_dist)));
+        }
+#endif
+        for (; c < end; ++c)
+        {
+          const float dsx = scene_point[0] - scene_x[c], dsy = scene_point[1] - scene_y[c], dsz = scene_point[2] - scene_z[c];
+          const float dmx = model_point[0] - model_x[c], dmy = model_point[1] - model_y[c], dmz = model_point[2] - model_z[c];
+          errors[c] = std::abs (std::sqrt (dsx * dsx + dsy * dsy + dsz * dsz) - std::sqrt (dmx * dmx + dmy * dmy + dmz * dmz));
+        }
+      }
+
+      /** \brief Compute the consistency errors of the candidates from position begin on, in parallel blocks. */
+      inline void
+      computeErrors (const Eigen::Vector3f &scene_point, const Eigen::Vector3f &model_point, std::size_t begin, unsigned int threads)
+      {
+        const std::size_t n = size ();
+        errors.resize (n);
+        if (begin >= n)
+          return;
+
+        std::size_t block_size = 2048;
+        int nr_blocks = static_cast<int> ((n - begin + block_size - 1) / block_size);
+#pragma omp parallel for \
+  default(none) \
+  shared(begin, block_size, model_point, n, nr_blocks, scene_point) \
+  num_threads(pcl::utils::getNumberOfThreads (std::min (threads, static_cast<unsigned int> (nr_blocks))))
+        for (int b = 0; b < nr_blocks; ++b)
+        {
+          const std::size_t block_begin = begin + b * block_size;
+          computeErrors (scene_point, model_point, block_begin, std::min (block_begin + block_size, n));
+        }
+      }
+
+      /** \brief Remove the candidates from position begin on for which remove (position) is true, keeping the order of the others. */
+      template <typename Predicate> inline void
+      removeIf (std::size_t begin, const Predicate &remove)
+      {
+        std::size_t kept = begin;
+        for (std::size_t c = begin; c < size (); ++c)
+        {
+          if (remove (c))
+            continue;
+          ids[kept] = ids[c];
+          scene_x[kept] = scene_x[c]; scene_y[kept] = scene_y[c]; scene_z[kept] = scene_z[c];
+          model_x[kept] = model_x[c]; model_y[kept] = model_y[c]; model_z[kept] = model_z[c];
+          ++kept;
+        }
+        ids.resize (kept);
+        scene_x.resize (kept); scene_y.resize (kept); scene_z.resize (kept);
+        model_x.resize (kept); model_y.resize (kept); model_z.resize (kept);
+      }
+
+      /** \brief Remove the candidates from position begin on that are not consistent with the correspondence
+        * between scene_point and model_point, keeping the order of the others.
+        */
+      inline void
+      filter (const Eigen::Vector3f &scene_point, const Eigen::Vector3f &model_point, double gc_size,
+              std::size_t begin, unsigned int threads)
+      {
+        computeErrors (scene_point, model_point, begin, threads);
+        removeIf (begin, [this, gc_size] (std::size_t c) { return (errors[c] > gc_size); });
+      }
+
+      /** \brief The scene point of the candidate at position c. */
+      inline Eigen::Vector3f
+      scenePoint (std::size_t c) const
+      {
+        return (Eigen::Vector3f (scene_x[c], scene_y[c], scene_z[c]));
+      }
+
+      /** \brief The model point of the candidate at position c. */
+      inline Eigen::Vector3f
+      modelPoint (std::size_t c) const
+      {
+        return (Eigen::Vector3f (model_x[c], model_y[c], model_z[c]));
+      }
+    };
+  } // namespace detail
+} // namespace pcl
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 inline bool
@@ -52,6 +193,20 @@ gcCorrespSorter (pcl::Correspondence i, pcl::Correspondence j)
   return (i.distance < j.distance);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointModelT, typename PointSceneT> void
+pcl::GeometricConsistencyGrouping<PointModelT, PointSceneT>::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template<typename PointModelT, typename PointSceneT> void
 pcl::GeometricConsistencyGrouping<PointModelT, PointSceneT>::clusterCorrespondences (std::vector<Correspondences> &model_instances)
@@ -75,8 +230,6 @@ pcl::GeometricConsistencyGrouping<PointModelT, PointSceneT>::clusterCorresponden
   std::vector<int> consensus_set;
   std::vector<bool> taken_corresps (model_scene_corrs_->size (), false);
 
-  Eigen::Vector3f dist_ref, dist_trg;
-
   //temp copy of scene cloud with the type cast to ModelT in order to use Ransac
   PointCloudPtr temp_scene_cloud_ptr (new PointCloud ());
   pcl::copyPointCloud (*scene_, *temp_scene_cloud_ptr);
@@ -87,47 +240,36 @@ pcl::GeometricConsistencyGrouping<PointModelT, PointSceneT>::clusterCorresponden
   corr_rejector.setInputSource(input_);
   corr_rejector.setInputTarget (temp_scene_cloud_ptr);
 
-  for (std::size_t i = 0; i < model_scene_corrs_->size (); ++i)
+  //The correspondences not taken yet, in order, and the ones that may join the current consensus set
+  pcl::detail::ConsistencyCandidates not_taken, candidates;
+  for (std::size_t j = 0; j < model_scene_corrs_->size (); ++j)
   {
-    if (taken_corresps[i])
-      continue;
+    const Correspondence &corr_j = (*model_scene_corrs_)[j];
+    not_taken.push_back (static_cast<int> (j), (*scene_)[corr_j.index_match].getVector3fMap (), (*input_)[corr_j.index_query].getVector3fMap ());
+  }
 
+  for (std::size_t p = 0; p < not_taken.size (); )
+  {
+    const int i = not_taken.ids[p];
     consensus_set.clear ();
-    consensus_set.push_back (static_cast<int> (i));
-    
-    for (std::size_t j = 0; j < model_scene_corrs_->size (); ++j)
+    consensus_set.push_back (i);
+
+    //A correspondence fits into the consensus set if it is consistent with all its members. The candidates are
+    //filtered by each member as it joins, so the first remaining candidate always fits and joins next.
+    const Eigen::Vector3f scene_point_i = not_taken.scenePoint (p);
+    const Eigen::Vector3f model_point_i = not_taken.modelPoint (p);
+    not_taken.computeErrors (scene_point_i, model_point_i, 0, threads_);
+    candidates.clear ();
+    for (std::size_t c = 0; c < not_taken.size (); ++c)
     {
-      if ( j != i &&  !taken_corresps[j])
-      {
-        //Let's check if j fits into the current consensus set
-        bool is_a_good_candidate = true;
-        for (const int &k : consensus_set)
-        {
-          int scene_index_k = model_scene_corrs_->at (k).index_match;
-          int model_index_k = model_scene_corrs_->at (k).index_query;
-          int scene_index_j = model_scene_corrs_->at (j).index_match;
-          int model_index_j = model_scene_corrs_->at (j).index_query;
-          
-          const Eigen::Vector3f& scene_point_k = scene_->at (scene_index_k).getVector3fMap ();
-          const Eigen::Vector3f& model_point_k = input_->at (model_index_k).getVector3fMap ();
-          const Eigen::Vector3f& scene_point_j = scene_->at (scene_index_j).getVector3fMap ();
-          const Eigen::Vector3f& model_point_j = input_->at (model_index_j).getVector3fMap ();
-
-          dist_ref = scene_point_k - scene_point_j;
-          dist_trg = model_point_k - model_point_j;
-
-          double distance = std::abs (dist_ref.norm () - dist_trg.norm ());
-
-          if (distance > gc_size_)
-          {
-            is_a_good_candidate = false;
-            break;
-          }
-        }
+      if (c != p && !(not_taken.errors[c] > gc_size_))
+        candidates.push_back (not_taken.ids[c], not_taken.scenePoint (c), not_taken.modelPoint (c));
+    }
 
-        if (is_a_good_candidate)
-          consensus_set.push_back (static_cast<int> (j));
-      }
+    for (std::size_t c = 0; c < candidates.size (); ++c)
+    {
+      consensus_set.push_back (candidates.ids[c]);
+      candidates.filter (candidates.scenePoint (c), candidates.modelPoint (c), gc_size_, c + 1, threads_);
     }
     
     if (static_cast<int> (consensus_set.size ()) > gc_threshold_)
@@ -144,7 +286,12 @@ pcl::GeometricConsistencyGrouping<PointModelT, PointSceneT>::clusterCorresponden
       found_transformations_.push_back (corr_rejector.getBestTransformation ());
 
       model_instances.push_back (filtered_corrs);
+
+      not_taken.removeIf (0, [&not_taken, &taken_corresps] (std::size_t c) { return (taken_corresps[not_taken.ids[c]]); });
+      p = std::upper_bound (not_taken.ids.begin (), not_taken.ids.end (), i) - not_taken.ids.begin ();
     }
+    else
+      ++p;
   }
 }
 
@@ -47,6 +47,7 @@
 //#include <pcl/sample_consensus/sac_model_registration.h>
 #include <pcl/features/normal_3d.h>
 #include <pcl/features/board.h>
+#include <pcl/common/utils.h> // for getNumberOfThreads
 
 
 template<typename PointModelT, typename PointSceneT, typename PointModelRfT, typename PointSceneRfT>
@@ -132,6 +133,20 @@ pcl::Hough3DGrouping<PointModelT, PointSceneT, PointModelRfT, PointSceneRfT>::tr
   return (true);
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointModelT, typename PointSceneT, typename PointModelRfT, typename PointSceneRfT> void
+pcl::Hough3DGrouping<PointModelT, PointSceneT, PointModelRfT, PointSceneRfT>::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template<typename PointModelT, typename PointSceneT, typename PointModelRfT, typename PointSceneRfT> bool
 pcl::Hough3DGrouping<PointModelT, PointSceneT, PointModelRfT, PointSceneRfT>::houghVoting ()
@@ -186,14 +201,18 @@ pcl::Hough3DGrouping<PointModelT, PointSceneT, PointModelRfT, PointSceneRfT>::ho
 
   float max_distance = -std::numeric_limits<float>::max ();
 
-  // Calculating 3D Hough space dimensions and vote position for each match
+  // Calculating the vote position for each match
+#pragma omp parallel for \
+  default(none) \
+  shared(n_matches, scene_votes) \
+  num_threads(pcl::utils::getNumberOfThreads (threads_))
   for (int i=0; i< n_matches; ++i)
   {
-    int scene_index = model_scene_corrs_->at (i).index_match;
-    int model_index = model_scene_corrs_->at (i).index_query;
+    int scene_index = (*model_scene_corrs_)[i].index_match;
+    int model_index = (*model_scene_corrs_)[i].index_query;
 
-    const Eigen::Vector3f& scene_point = scene_->at (scene_index).getVector3fMap ();
-    const PointSceneRfT&   scene_point_rf = scene_rf_->at (scene_index);
+    const Eigen::Vector3f& scene_point = (*scene_)[scene_index].getVector3fMap ();
+    const PointSceneRfT&   scene_point_rf = (*scene_rf_)[scene_index];
     
     Eigen::Vector3f scene_point_rf_x (scene_point_rf.x_axis[0], scene_point_rf.x_axis[1], scene_point_rf.x_axis[2]);
     Eigen::Vector3f scene_point_rf_y (scene_point_rf.y_axis[0], scene_point_rf.y_axis[1], scene_point_rf.y_axis[2]);
@@ -205,49 +224,65 @@ pcl::Hough3DGrouping<PointModelT, PointSceneT, PointModelRfT, PointSceneRfT>::ho
     scene_votes[i].x () = scene_point_rf_x[0] * model_point_vote.x () + scene_point_rf_y[0] * model_point_vote.y () + scene_point_rf_z[0] * model_point_vote.z () + scene_point.x ();
     scene_votes[i].y () = scene_point_rf_x[1] * model_point_vote.x () + scene_point_rf_y[1] * model_point_vote.y () + scene_point_rf_z[1] * model_point_vote.z () + scene_point.y ();
     scene_votes[i].z () = scene_point_rf_x[2] * model_point_vote.x () + scene_point_rf_y[2] * model_point_vote.y () + scene_point_rf_z[2] * model_point_vote.z () + scene_point.z ();
+  }
 
-    if (scene_votes[i].x () < d_min.x ()) 
-      d_min.x () = scene_votes[i].x (); 
-    if (scene_votes[i].x () > d_max.x ()) 
-      d_max.x () = scene_votes[i].x (); 
-
-    if (scene_votes[i].y () < d_min.y ()) 
-      d_min.y () = scene_votes[i].y (); 
-    if (scene_votes[i].y () > d_max.y ()) 
-      d_max.y () = scene_votes[i].y (); 
-
-    if (scene_votes[i].z () < d_min.z ()) 
-      d_min.z () = scene_votes[i].z (); 
-    if (scene_votes[i].z () > d_max.z ()) 
-      d_max.z () = scene_votes[i].z ();
+  // Calculating 3D Hough space dimensions
+  for (int i=0; i< n_matches; ++i)
+  {
+    d_min = d_min.cwiseMin (scene_votes[i]);
+    d_max = d_max.cwiseMax (scene_votes[i]);
 
     // Calculate max distance for interpolated votes
-    if (use_interpolation_ && max_distance < model_scene_corrs_->at (i).distance)
+    if (use_interpolation_ && max_distance < (*model_scene_corrs_)[i].distance)
     {
-      max_distance = model_scene_corrs_->at (i).distance;
+      max_distance = (*model_scene_corrs_)[i].distance;
     }
   }
 
   // Hough Voting
   hough_space_.reset (new pcl::recognition::HoughSpace3D (d_min, bin_size, d_max));
 
-  for (int i = 0; i < n_matches; ++i)
+  // Each thread votes for a contiguous range of matches into its own Hough space. The spaces are
+  // merged in the order of the ranges, so the voter ids of each bin stay sorted as in a serial vote.
+  // Every space holds all the bins, so a thread is only worth it for a good number of matches.
+  const int n_spaces = std::max (1, std::min (static_cast<int> (pcl::utils::getNumberOfThreads (threads_)), n_matches / 1024));
+  std::vector<pcl::recognition::HoughSpace3D::Ptr> hough_spaces (n_spaces);
+  hough_spaces[0] = hough_space_;
+
+#pragma omp parallel for \
+  default(none) \
+  shared(bin_size, d_max, d_min, hough_spaces, max_distance, n_matches, n_spaces, scene_votes) \
+  schedule(static, 1) \
+  num_threads(n_spaces)
+  for (int t = 0; t < n_spaces; ++t)
   {
-    double weight = 1.0;
-    if (use_distance_weight_ && max_distance != 0)
-    {
-      weight = 1.0 - (model_scene_corrs_->at (i).distance / max_distance);
-    }
-    if (use_interpolation_)
-    {
-      hough_space_->voteInt (scene_votes[i], weight, i);
-    } 
-    else
+    if (t > 0)
+      hough_spaces[t].reset (new pcl::recognition::HoughSpace3D (d_min, bin_size, d_max));
+    pcl::recognition::HoughSpace3D &hough_space = *hough_spaces[t];
+
+    const int begin = static_cast<int> (static_cast<long> (n_matches) * t / n_spaces);
+    const int end = static_cast<int> (static_cast<long> (n_matches) * (t + 1) / n_spaces);
+    for (int i = begin; i < end; ++i)
     {
-      hough_space_->vote (scene_votes[i], weight, i);
+      double weight = 1.0;
+      if (use_distance_weight_ && max_distance != 0)
+      {
+        weight = 1.0 - ((*model_scene_corrs_)[i].distance / max_distance);
+      }
+      if (use_interpolation_)
+      {
+        hough_space.voteInt (scene_votes[i], weight, i);
+      } 
+      else
+      {
+        hough_space.vote (scene_votes[i], weight, i);
+      }
     }
   }
 
+  for (int t = 1; t < n_spaces; ++t)
+    hough_space_->merge (*hough_spaces[t]);
+
   hough_space_initialized_ = true;
 
   return (true);
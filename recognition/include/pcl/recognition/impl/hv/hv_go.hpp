@@ -39,8 +39,10 @@
 
 #include <pcl/recognition/hv/hv_go.h>
 #include <pcl/common/time.h>
+#include <pcl/common/utils.h> // for getNumberOfThreads
 #include <pcl/point_types.h>
 
+#include <algorithm>
 #include <memory>
 #include <numeric>
 
@@ -172,11 +174,9 @@ mets::gol_type pcl::GlobalHypothesesVerification<ModelT, SceneT>::evaluateSoluti
 
   setPreviousBadInfo (bad_info);
 
-  int n_active_hyp = 0;
-  for(const bool &i : active) {
-    if(i)
-      n_active_hyp++;
-  }
+  //a move toggles a single hypothesis
+  int n_active_hyp = getPreviousActiveHypotheses () + (active[changed] ? 1 : -1);
+  setPreviousActiveHypotheses (n_active_hyp);
 
   float duplicity_cm = static_cast<float> (getDuplicityCM ()) * w_occupied_multiple_cm_;
   return static_cast<mets::gol_type> ((good_info - bad_info - static_cast<float> (duplicity) - unexplained_info - duplicity_cm - static_cast<float> (n_active_hyp)) * -1.f); //return the dual to our max problem
@@ -284,12 +284,28 @@ void pcl::GlobalHypothesesVerification<ModelT, SceneT>::initialize()
   {
     pcl::ScopeTime tcues ("Computing cues");
     recognition_models_.resize (complete_models_.size ());
-    int valid = 0;
+    std::vector<char> added (complete_models_.size ());
+
+    //the hypotheses are independent, they only read the scene and its search tree
+#pragma omp parallel for \
+  default(none) \
+  shared(added) \
+  schedule(dynamic) \
+  num_threads(pcl::utils::getNumberOfThreads (threads_))
     for (int i = 0; i < static_cast<int> (complete_models_.size ()); i++)
     {
       //create recognition model
-      recognition_models_[valid].reset (new RecognitionModel ());
-      if(addModel (visible_models_[i], complete_models_[i], recognition_models_[valid])) {
+      recognition_models_[i].reset (new RecognitionModel ());
+      added[i] = addModel (visible_models_[i], complete_models_[i], recognition_models_[i]);
+    }
+
+    //keep the valid models in order
+    int valid = 0;
+    for (int i = 0; i < static_cast<int> (complete_models_.size ()); i++)
+    {
+      if (added[i])
+      {
+        recognition_models_[valid] = recognition_models_[i];
         indices_[valid] = i;
         valid++;
       }
@@ -334,27 +350,33 @@ void pcl::GlobalHypothesesVerification<ModelT, SceneT>::initialize()
 
   complete_cloud_occupancy_by_RM_.resize (size_x * size_y * size_z, 0);
 
-  for (std::size_t i = 0; i < recognition_models_.size (); i++)
+  //the cells occupied by each complete model, each counted once
+#pragma omp parallel for \
+  default(none) \
+  shared(min_pt_all, size_x, size_y) \
+  schedule(dynamic) \
+  num_threads(pcl::utils::getNumberOfThreads (threads_))
+  for (int i = 0; i < static_cast<int> (recognition_models_.size ()); i++)
   {
-
-    std::map<int, bool> banned;
-    std::map<int, bool>::iterator banned_it;
-
+    std::vector<int> &occupancy_indices = recognition_models_[i]->complete_cloud_occupancy_indices_;
+    occupancy_indices.clear ();
+    occupancy_indices.reserve (complete_models_[indices_[i]]->size ());
     for (const auto& point: *complete_models_[indices_[i]])
     {
       const int pos_x = static_cast<int> (std::floor ((point.x - min_pt_all.x) / res_occupancy_grid_));
       const int pos_y = static_cast<int> (std::floor ((point.y - min_pt_all.y) / res_occupancy_grid_));
       const int pos_z = static_cast<int> (std::floor ((point.z - min_pt_all.z) / res_occupancy_grid_));
 
-      const int idx = pos_z * size_x * size_y + pos_y * size_x + pos_x;
-      banned_it = banned.find (idx);
-      if (banned_it == banned.end ())
-      {
-        complete_cloud_occupancy_by_RM_[idx]++;
-        recognition_models_[i]->complete_cloud_occupancy_indices_.push_back (idx);
-        banned[idx] = true;
-      }
+      occupancy_indices.push_back (pos_z * size_x * size_y + pos_y * size_x + pos_x);
     }
+    std::sort (occupancy_indices.begin (), occupancy_indices.end ());
+    occupancy_indices.erase (std::unique (occupancy_indices.begin (), occupancy_indices.end ()), occupancy_indices.end ());
+  }
+
+  for (const auto &recognition_model : recognition_models_)
+  {
+    for (const int &idx : recognition_model->complete_cloud_occupancy_indices_)
+      complete_cloud_occupancy_by_RM_[idx]++;
   }
 
   {
@@ -362,7 +384,7 @@ void pcl::GlobalHypothesesVerification<ModelT, SceneT>::initialize()
 #pragma omp parallel for \
   default(none) \
   schedule(dynamic, 4) \
-  num_threads(omp_get_num_procs())
+  num_threads(pcl::utils::getNumberOfThreads (threads_))
     for (int j = 0; j < static_cast<int> (recognition_models_.size ()); j++)
       computeClutterCue (recognition_models_[j]);
   }
@@ -434,6 +456,7 @@ void pcl::GlobalHypothesesVerification<ModelT, SceneT>::SAOptimize(std::vector<i
   setPreviousDuplicity (duplicity);
   setPreviousBadInfo (bad_information_);
   setPreviousUnexplainedValue (unexplained_in_neighboorhod);
+  setPreviousActiveHypotheses (static_cast<int> (std::count (initial_solution.begin (), initial_solution.end (), true)));
 
   SAModel model;
   model.cost_ = static_cast<mets::gol_type> ((good_information_ - bad_information_
@@ -414,6 +414,15 @@ namespace pcl
         average_detections_ = average_detections;
       }
 
+      /** \brief Sets the number of threads used to match the templates.
+        * \param[in] nr_threads the number of threads to use (0 uses as many threads as there are processors).
+        */
+      inline void
+      setNumberOfThreads (unsigned int nr_threads = 0)
+      {
+        threads_ = nr_threads;
+      }
+
       /** \brief Returns the template with the specified ID.
         * \param[in] template_id the ID of the template to return.
         */
@@ -463,6 +472,22 @@ namespace pcl
 
 
     private:
+      /** \brief Appends the detections of a template, i.e. the positions whose score exceeds the detection threshold.
+        * \param[in] score_sums the summed responses of the template at every position of the linearized maps.
+        * \param[in] max_score the maximum possible summed response of the template.
+        * \param[in] mem_width the width of the linearized maps.
+        * \param[in] mem_height the height of the linearized maps.
+        * \param[in] step_size the step-size used to construct the linearized maps.
+        * \param[in] template_id the ID of the template.
+        * \param[in] scale the scale the template was matched at.
+        * \param[out] detections the destination for the detections.
+        */
+      void
+      collectDetections (const unsigned short * score_sums, int max_score,
+                         std::size_t mem_width, std::size_t mem_height, std::size_t step_size,
+                         int template_id, float scale,
+                         std::vector<LINEMODDetection> & detections) const;
+
       /** template response threshold */
       float template_threshold_;
       /** states whether non-max-suppression on detections is enabled or not */
@@ -471,6 +496,8 @@ namespace pcl
       bool average_detections_;
       /** template storage */
       std::vector<SparseQuantizedMultiModTemplate> templates_;
+      /** number of threads used for matching the templates, 0 for automatic */
+      unsigned int threads_;
   };
 
 }
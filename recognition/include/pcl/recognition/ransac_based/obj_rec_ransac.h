@@ -202,6 +202,14 @@ namespace pcl
           model_library_.ignoreCoplanarPointPairsOff ();
         }
 
+        /** \brief Set the number of threads used to sample the scene, generate and test the hypotheses and build the
+          * conflict graph. 0 (default) uses as many threads as there are processors. */
+        inline void
+        setNumberOfThreads (unsigned int nr_threads = 0)
+        {
+          threads_ = nr_threads;
+        }
+
         inline void
         icpHypothesesRefinementOn ()
         {
@@ -353,12 +361,12 @@ namespace pcl
         sampleOrientedPointPairs (int num_iterations, const std::vector<ORROctree::Node*>& full_scene_leaves, std::list<OrientedPointPair>& output) const;
 
         int
-        generateHypotheses (const std::list<OrientedPointPair>& pairs, std::list<HypothesisBase>& out) const;
+        generateHypotheses (const std::list<OrientedPointPair>& pairs, std::vector<HypothesisBase>& out) const;
 
         /** \brief Groups close hypotheses in 'hypotheses'. Saves a representative for each group in 'out'. Returns the
           * number of hypotheses after grouping. */
         int
-        groupHypotheses(std::list<HypothesisBase>& hypotheses, int num_hypotheses, RigidTransformSpace& transform_space,
+        groupHypotheses(std::vector<HypothesisBase>& hypotheses, int num_hypotheses, RigidTransformSpace& transform_space,
             HypothesisOctree& grouped_hypotheses) const;
 
         inline void
@@ -476,6 +484,7 @@ namespace pcl
         std::list<OrientedPointPair> sampled_oriented_point_pairs_;
         std::vector<Hypothesis> accepted_hypotheses_;
         Recognition_Mode rec_mode_;
+        unsigned int threads_;
     };
   } // namespace recognition
 } // namespace pcl
@@ -94,6 +94,17 @@ namespace pcl
               return *this;
             }
 
+            /** \brief Adds the (not yet averaged) rigid transforms accumulated in 'src' to this entry. */
+            inline const Entry&
+            merge (const Entry& src)
+            {
+              aux::add3 (this->axis_angle_, src.axis_angle_);
+              aux::add3 (this->translation_, src.translation_);
+              num_transforms_ += src.num_transforms_;
+
+              return *this;
+            }
+
             inline void
             computeAverageRigidTransform (float *rigid_transform = nullptr)
             {
@@ -167,6 +178,14 @@ namespace pcl
           return model_to_entry_[model].addRigidTransform (axis_angle, translation);
         }
 
+        /** \brief Adds the rigid transforms of all entries of 'src' to the entries of this cell. */
+        inline void
+        merge (const RotationSpaceCell& src)
+        {
+          for (const auto &entry : src.model_to_entry_)
+            model_to_entry_[entry.first].merge (entry.second);
+        }
+
       protected:
         std::map<const ModelLibrary::Model*,Entry> model_to_entry_;
     }; // class RotationSpaceCell
@@ -284,6 +303,22 @@ namespace pcl
           return (true);
         }
 
+        /** \brief Adds the rigid transforms stored in 'src' to this rotation space. Both spaces have to have the
+          * same discretization. The cells which are new to this space are appended in the order they were created
+          * in 'src'. */
+        inline void
+        merge (const RotationSpace& src)
+        {
+          for (const auto &src_leaf : src.octree_.getFullLeaves ())
+          {
+            const float *c = src_leaf->getCenter ();
+            CellOctree::Node* cell = octree_.createLeaf (c[0], c[1], c[2]);
+
+            if ( cell )
+              cell->getData ().merge (src_leaf->getData ());
+          }
+        }
+
       protected:
         CellOctree octree_;
         RotationSpaceCellCreator cell_creator_;
@@ -403,6 +438,23 @@ namespace pcl
           return (true);
         }
 
+        /** \brief Adds the rigid transforms stored in 'src' to this space. 'src' has to be built with the same
+          * bounds and cell sizes as this space. Merging the spaces filled with consecutive parts of a set of rigid
+          * transforms in that order gives the same space as adding all transforms to a single space (up to the
+          * floating point summation order). */
+        inline void
+        merge (const RigidTransformSpace& src)
+        {
+          for (const auto &src_rotation_space : src.getRotationSpaces ())
+          {
+            const float *c = src_rotation_space->getCenter ();
+            RotationSpaceOctree::Node* leaf = pos_octree_.createLeaf (c[0], c[1], c[2]);
+
+            if ( leaf )
+              leaf->getData ().merge (*src_rotation_space);
+          }
+        }
+
       protected:
         RotationSpaceOctree pos_octree_;
         RotationSpaceCreator rotation_space_creator_;
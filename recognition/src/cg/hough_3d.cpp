@@ -201,6 +201,28 @@ pcl::recognition::HoughSpace3D::voteInt (const Eigen::Vector3d &single_vote_coor
   return (central_bin_index);
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool
+pcl::recognition::HoughSpace3D::merge (const HoughSpace3D &other)
+{
+  if (bin_count_ != other.bin_count_ || min_coord_ != other.min_coord_ || bin_size_ != other.bin_size_)
+  {
+    PCL_ERROR ("[pcl::recognition::HoughSpace3D::merge] Error! The Hough spaces have different dimensions.\n");
+    return (false);
+  }
+
+  for (int i = 0; i < total_bins_count_; ++i)
+    hough_space_[i] += other.hough_space_[i];
+
+  for (const auto &bin : other.voter_ids_)
+  {
+    std::vector<int> &ids = voter_ids_[bin.first];
+    ids.insert (ids.end (), bin.second.begin (), bin.second.end ());
+  }
+
+  return (true);
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 double
 pcl::recognition::HoughSpace3D::findMaxima (double min_threshold, std::vector<double> &maxima_values, std::vector<std::vector<int> > &maxima_voter_ids)
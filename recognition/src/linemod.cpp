@@ -35,23 +35,134 @@
  *
  */
 
-//#define __SSE2__
-
+#include <pcl/common/utils.h> // for getNumberOfThreads
 #include <pcl/recognition/linemod.h>
 
-#ifdef __SSE2__
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
 #include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
 #endif
 
 #include <fstream>
 
-//#define LINEMOD_USE_SEPARATE_ENERGY_MAPS
+namespace
+{
+  /** \brief Adds the responses in 'data' to the 8 bit partial sums 'tmp_score_sums'. */
+  inline void
+  addResponses (unsigned char * tmp_score_sums, const unsigned char * data, const std::size_t mem_size)
+  {
+    std::size_t mem_index = 0;
+#if defined(__AVX2__)
+    for (; mem_index + 32 <= mem_size; mem_index += 32)
+    {
+      const __m256i sums = _mm256_loadu_si256 (reinterpret_cast<const __m256i*> (tmp_score_sums + mem_index));
+      const __m256i responses = _mm256_loadu_si256 (reinterpret_cast<const __m256i*> (data + mem_index));
+      _mm256_storeu_si256 (reinterpret_cast<__m256i*> (tmp_score_sums + mem_index), _mm256_add_epi8 (sums, responses));
+    }
+#elif defined(__SSE2__)
+    for (; mem_index + 16 <= mem_size; mem_index += 16)
+    {
+      const __m128i sums = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (tmp_score_sums + mem_index));
+      const __m128i responses = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (data + mem_index));
+      _mm_storeu_si128 (reinterpret_cast<__m128i*> (tmp_score_sums + mem_index), _mm_add_epi8 (sums, responses));
+    }
+#elif defined(__ARM_NEON)
+    for (; mem_index + 16 <= mem_size; mem_index += 16)
+      vst1q_u8 (tmp_score_sums + mem_index, vaddq_u8 (vld1q_u8 (tmp_score_sums + mem_index), vld1q_u8 (data + mem_index)));
+#endif
+    for (; mem_index < mem_size; ++mem_index)
+      tmp_score_sums[mem_index] = static_cast<unsigned char> (tmp_score_sums[mem_index] + data[mem_index]);
+  }
+
+  /** \brief Adds the 8 bit partial sums to the 16 bit score sums and resets the partial sums. */
+  inline void
+  flushResponses (unsigned short * score_sums, unsigned char * tmp_score_sums, const std::size_t mem_size)
+  {
+    std::size_t mem_index = 0;
+#if defined(__AVX2__)
+    for (; mem_index + 16 <= mem_size; mem_index += 16)
+    {
+      const __m256i partial = _mm256_cvtepu8_epi16 (_mm_loadu_si128 (reinterpret_cast<const __m128i*> (tmp_score_sums + mem_index)));
+      const __m256i sums = _mm256_loadu_si256 (reinterpret_cast<const __m256i*> (score_sums + mem_index));
+      _mm256_storeu_si256 (reinterpret_cast<__m256i*> (score_sums + mem_index), _mm256_add_epi16 (sums, partial));
+    }
+#elif defined(__SSE2__)
+    const __m128i zero = _mm_setzero_si128 ();
+    for (; mem_index + 16 <= mem_size; mem_index += 16)
+    {
+      const __m128i partial = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (tmp_score_sums + mem_index));
+      const __m128i sums_lo = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (score_sums + mem_index));
+      const __m128i sums_hi = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (score_sums + mem_index + 8));
+      _mm_storeu_si128 (reinterpret_cast<__m128i*> (score_sums + mem_index), _mm_add_epi16 (sums_lo, _mm_unpacklo_epi8 (partial, zero)));
+      _mm_storeu_si128 (reinterpret_cast<__m128i*> (score_sums + mem_index + 8), _mm_add_epi16 (sums_hi, _mm_unpackhi_epi8 (partial, zero)));
+    }
+#elif defined(__ARM_NEON)
+    for (; mem_index + 16 <= mem_size; mem_index += 16)
+    {
+      const uint8x16_t partial = vld1q_u8 (tmp_score_sums + mem_index);
+      vst1q_u16 (score_sums + mem_index, vaddw_u8 (vld1q_u16 (score_sums + mem_index), vget_low_u8 (partial)));
+      vst1q_u16 (score_sums + mem_index + 8, vaddw_u8 (vld1q_u16 (score_sums + mem_index + 8), vget_high_u8 (partial)));
+    }
+#endif
+    for (; mem_index < mem_size; ++mem_index)
+      score_sums[mem_index] = static_cast<unsigned short> (score_sums[mem_index] + tmp_score_sums[mem_index]);
+
+    memset (tmp_score_sums, 0, mem_size*sizeof (tmp_score_sums[0]));
+  }
+
+  /** \brief Sums the responses of all features of a template at every position of the linearized maps.
+    * The responses are accumulated with 8 bit precision and added to 'score_sums' before they can overflow.
+    * \return the maximum possible score of the template.
+    */
+  int
+  computeTemplateScores (const pcl::SparseQuantizedMultiModTemplate & linemod_template,
+                         std::vector<std::vector<pcl::LinearizedMaps> > & modality_linearized_maps,
+                         const float scale, const std::size_t mem_size,
+                         unsigned short * score_sums, unsigned char * tmp_score_sums)
+  {
+    // each response is at most 4, see the energy maps
+    const int max_response = 4;
+
+    memset (score_sums, 0, mem_size*sizeof (score_sums[0]));
+    memset (tmp_score_sums, 0, mem_size*sizeof (tmp_score_sums[0]));
+
+    int max_score = 0;
+    int max_tmp_score = 0;
+    for (const auto &feature : linemod_template.features)
+    {
+      for (std::size_t bin_index = 0; bin_index < 8; ++bin_index)
+      {
+        if ((feature.quantized_value & (0x1<<bin_index)) != 0)
+        {
+          if (max_tmp_score + max_response > 255)
+          {
+            flushResponses (score_sums, tmp_score_sums, mem_size);
+            max_tmp_score = 0;
+          }
+          max_score += max_response;
+          max_tmp_score += max_response;
+
+          const unsigned char * data = modality_linearized_maps[feature.modality_index][bin_index].getOffsetMap (
+              static_cast<std::size_t> (static_cast<float> (feature.x) * scale), static_cast<std::size_t> (static_cast<float> (feature.y) * scale));
+          addResponses (tmp_score_sums, data, mem_size);
+        }
+      }
+    }
+    flushResponses (score_sums, tmp_score_sums, mem_size);
+
+    return (max_score);
+  }
+}
 
 //////////////////////////////////////////////////////////////////////////////////////////////
 pcl::LINEMOD::LINEMOD () 
   : template_threshold_ (0.75f)
   , use_non_max_suppression_ (false)
   , average_detections_ (false)
+  , threads_ (0)
 {
 }
 
@@ -166,7 +277,7 @@ pcl::LINEMOD::matchTemplates (const std::vector<QuantizableModality*> & modaliti
   }
 
   // create linearized maps
-  const std::size_t step_size = 8;
+  std::size_t step_size = 8;
   std::vector<std::vector<LinearizedMaps> > modality_linearized_maps;
   for (std::size_t modality_index = 0; modality_index < nr_modalities; ++modality_index)
   {
@@ -209,123 +320,29 @@ pcl::LINEMOD::matchTemplates (const std::vector<QuantizableModality*> & modaliti
     modality_linearized_maps.push_back (linearized_maps);
   }
 
-  // compute scores for templates
-  const std::size_t width = modality_energy_maps[0].getWidth ();
-  const std::size_t height = modality_energy_maps[0].getHeight ();
-  for (std::size_t template_index = 0; template_index < templates_.size (); ++template_index)
+  // compute scores for templates; the templates are matched independently and their
+  // detections are stored in template order
+  std::size_t width = modality_energy_maps[0].getWidth ();
+  std::size_t height = modality_energy_maps[0].getHeight ();
+  std::size_t mem_width = width / step_size;
+  std::size_t mem_height = height / step_size;
+  std::size_t mem_size = mem_width * mem_height;
+  int nr_templates = static_cast<int> (templates_.size ());
+
+  std::vector<LINEMODDetection> template_detections (nr_templates);
+
+#pragma omp parallel for \
+  default(none) \
+  shared(modality_linearized_maps, template_detections, nr_templates, mem_width, mem_size, step_size) \
+  schedule(dynamic, 8) \
+  num_threads(pcl::utils::getNumberOfThreads (threads_))
+  for (int template_index = 0; template_index < nr_templates; ++template_index)
   {
-    const std::size_t mem_width = width / step_size;
-    const std::size_t mem_height = height / step_size;
-    const std::size_t mem_size = mem_width * mem_height;
-
-#ifdef __SSE2__
-    unsigned short * score_sums = reinterpret_cast<unsigned short*> (aligned_malloc (mem_size*sizeof(unsigned short)));
-    unsigned char * tmp_score_sums = reinterpret_cast<unsigned char*> (aligned_malloc (mem_size*sizeof(unsigned char)));
-    memset (score_sums, 0, mem_size*sizeof (score_sums[0]));
-    memset (tmp_score_sums, 0, mem_size*sizeof (tmp_score_sums[0]));
-
-    //__m128i * score_sums_m128i = reinterpret_cast<__m128i*> (score_sums);
-    __m128i * tmp_score_sums_m128i = reinterpret_cast<__m128i*> (tmp_score_sums);
-
-    const std::size_t mem_size_16 = mem_size / 16;
-    //const std::size_t mem_size_mod_16 = mem_size & 15;
-    const std::size_t mem_size_mod_16_base = mem_size_16 * 16;
+    std::vector<unsigned short> score_sums (mem_size);
+    std::vector<unsigned char> tmp_score_sums (mem_size);
 
-    std::size_t max_score = 0;
-    std::size_t copy_back_counter = 0;
-    for (const auto &feature : templates_[template_index].features)
-    {
-      for (std::size_t bin_index = 0; bin_index < 8; ++bin_index)
-      {
-        if ((feature.quantized_value & (0x1<<bin_index)) != 0)
-        {
-          max_score += 4;
-
-          unsigned char * data = modality_linearized_maps[feature.modality_index][bin_index].getOffsetMap (feature.x, feature.y);
-          __m128i * data_m128i = reinterpret_cast<__m128i*> (data);
-
-          for (std::size_t mem_index = 0; mem_index < mem_size_16; ++mem_index)
-          {
-            __m128i aligned_data_m128i = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (data_m128i + mem_index)); // SSE2
-            //__m128i aligned_data_m128i = _mm_lddqu_si128 (reinterpret_cast<const __m128i*> (data_m128i + mem_index)); // SSE3
-            tmp_score_sums_m128i[mem_index] = _mm_add_epi8 (tmp_score_sums_m128i[mem_index], aligned_data_m128i);
-          }
-          for (std::size_t mem_index = mem_size_mod_16_base; mem_index < mem_size; ++mem_index)
-          {
-            tmp_score_sums[mem_index] = static_cast<unsigned char> (tmp_score_sums[mem_index] + data[mem_index]);
-          }
-        }
-      }
-
-      ++copy_back_counter;
-
-      //if ((feature_index & 7) == 7)
-      //if ((feature_index & 63) == 63)
-      if (copy_back_counter > 63) // only valid if each feature has only one bit set..
-      {
-        copy_back_counter = 0;
-
-        for (std::size_t mem_index = 0; mem_index < mem_size_mod_16_base; mem_index += 16)
-        {
-          score_sums[mem_index+0]  = static_cast<unsigned short> (score_sums[mem_index+0]  + tmp_score_sums[mem_index+0]);
-          score_sums[mem_index+1]  = static_cast<unsigned short> (score_sums[mem_index+1]  + tmp_score_sums[mem_index+1]);
-          score_sums[mem_index+2]  = static_cast<unsigned short> (score_sums[mem_index+2]  + tmp_score_sums[mem_index+2]);
-          score_sums[mem_index+3]  = static_cast<unsigned short> (score_sums[mem_index+3]  + tmp_score_sums[mem_index+3]);
-          score_sums[mem_index+4]  = static_cast<unsigned short> (score_sums[mem_index+4]  + tmp_score_sums[mem_index+4]);
-          score_sums[mem_index+5]  = static_cast<unsigned short> (score_sums[mem_index+5]  + tmp_score_sums[mem_index+5]);
-          score_sums[mem_index+6]  = static_cast<unsigned short> (score_sums[mem_index+6]  + tmp_score_sums[mem_index+6]);
-          score_sums[mem_index+7]  = static_cast<unsigned short> (score_sums[mem_index+7]  + tmp_score_sums[mem_index+7]);
-          score_sums[mem_index+8]  = static_cast<unsigned short> (score_sums[mem_index+8]  + tmp_score_sums[mem_index+8]);
-          score_sums[mem_index+9]  = static_cast<unsigned short> (score_sums[mem_index+9]  + tmp_score_sums[mem_index+9]);
-          score_sums[mem_index+10] = static_cast<unsigned short> (score_sums[mem_index+10] + tmp_score_sums[mem_index+10]);
-          score_sums[mem_index+11] = static_cast<unsigned short> (score_sums[mem_index+11] + tmp_score_sums[mem_index+11]);
-          score_sums[mem_index+12] = static_cast<unsigned short> (score_sums[mem_index+12] + tmp_score_sums[mem_index+12]);
-          score_sums[mem_index+13] = static_cast<unsigned short> (score_sums[mem_index+13] + tmp_score_sums[mem_index+13]);
-          score_sums[mem_index+14] = static_cast<unsigned short> (score_sums[mem_index+14] + tmp_score_sums[mem_index+14]);
-          score_sums[mem_index+15] = static_cast<unsigned short> (score_sums[mem_index+15] + tmp_score_sums[mem_index+15]);
-        }
-        for (std::size_t mem_index = mem_size_mod_16_base; mem_index < mem_size; ++mem_index)
-        {
-          score_sums[mem_index] = static_cast<unsigned short> (score_sums[mem_index] + tmp_score_sums[mem_index]);
-        }
-
-        memset (tmp_score_sums, 0, mem_size*sizeof (tmp_score_sums[0]));
-      }
-    }
-    {
-      for (std::size_t mem_index = 0; mem_index < mem_size; ++mem_index)
-      {
-        score_sums[mem_index] = static_cast<unsigned short> (score_sums[mem_index] + tmp_score_sums[mem_index]);
-      }
-        
-      memset (tmp_score_sums, 0, mem_size*sizeof (tmp_score_sums[0]));
-    }
-#else
-    unsigned short * score_sums = new unsigned short[mem_size];
-    //unsigned char * score_sums = new unsigned char[mem_size];
-    memset (score_sums, 0, mem_size*sizeof (score_sums[0]));
-
-    std::size_t max_score = 0;
-    for (std::size_t feature_index = 0; feature_index < templates_[template_index].features.size (); ++feature_index)
-    {
-      const QuantizedMultiModFeature & feature = templates_[template_index].features[feature_index];
-
-      //feature.modality_index;
-      for (std::size_t bin_index = 0; bin_index < 8; ++bin_index)
-      {
-        if ((feature.quantized_value & (0x1<<bin_index)) != 0)
-        {
-          max_score += 4;
-
-          unsigned char * data = modality_linearized_maps[feature.modality_index][bin_index].getOffsetMap (feature.x, feature.y);
-          for (std::size_t mem_index = 0; mem_index < mem_size; ++mem_index)
-          {
-            score_sums[mem_index] += data[mem_index];
-          }
-        }
-      }
-    }
-#endif
+    const int max_score = computeTemplateScores (templates_[template_index], modality_linearized_maps, 1.0f, mem_size,
+                                                 score_sums.data (), tmp_score_sums.data ());
 
     const float inv_max_score = 1.0f / float (max_score);
     
@@ -343,22 +360,15 @@ pcl::LINEMOD::matchTemplates (const std::vector<QuantizableModality*> & modaliti
     const std::size_t max_col_index = (max_index % mem_width) * step_size;
     const std::size_t max_row_index = (max_index / mem_width) * step_size;
 
-    LINEMODDetection detection;
+    LINEMODDetection & detection = template_detections[template_index];
     detection.x = static_cast<int> (max_col_index);
     detection.y = static_cast<int> (max_row_index);
-    detection.template_id = static_cast<int> (template_index);
+    detection.template_id = template_index;
     detection.score = static_cast<float> (max_value) * inv_max_score;
-
-    detections.push_back (detection);
-
-#ifdef __SSE2__
-    aligned_free (score_sums);
-    aligned_free (tmp_score_sums);
-#else
-    delete[] score_sums;
-#endif
   }
 
+  detections.insert (detections.end (), template_detections.begin (), template_detections.end ());
+
   // release data
   for (std::size_t modality_index = 0; modality_index < modality_linearized_maps.size (); ++modality_index)
   {
@@ -374,11 +384,6 @@ pcl::LINEMOD::detectTemplates (const std::vector<QuantizableModality*> & modalit
 {
   // create energy maps
   std::vector<EnergyMaps> modality_energy_maps;
-#ifdef LINEMOD_USE_SEPARATE_ENERGY_MAPS
-  std::vector<EnergyMaps> modality_energy_maps_1;
-  std::vector<EnergyMaps> modality_energy_maps_2;
-  std::vector<EnergyMaps> modality_energy_maps_3;
-#endif
   const std::size_t nr_modalities = modalities.size();
   for (std::size_t modality_index = 0; modality_index < nr_modalities; ++modality_index)
   {
@@ -392,14 +397,6 @@ pcl::LINEMOD::detectTemplates (const std::vector<QuantizableModality*> & modalit
     const int nr_bins = 8;
     EnergyMaps energy_maps;
     energy_maps.initialize (width, height, nr_bins);
-#ifdef LINEMOD_USE_SEPARATE_ENERGY_MAPS
-    EnergyMaps energy_maps_1;
-    EnergyMaps energy_maps_2;
-    EnergyMaps energy_maps_3;
-    energy_maps_1.initialize (width, height, nr_bins);
-    energy_maps_2.initialize (width, height, nr_bins);
-    energy_maps_3.initialize (width, height, nr_bins);
-#endif
     //std::vector< unsigned char* > energy_maps(nr_bins);
     for (int bin_index = 0; bin_index < nr_bins; ++bin_index)
     {
@@ -415,81 +412,39 @@ pcl::LINEMOD::detectTemplates (const std::vector<QuantizableModality*> & modalit
       {
         if ((val0 & quantized_data[index]) != 0)
           ++energy_maps (bin_index, index);
-#ifdef LINEMOD_USE_SEPARATE_ENERGY_MAPS
-        if ((val1 & quantized_data[index]) != 0)
-          ++energy_maps_1 (bin_index, index);
-        if ((val2 & quantized_data[index]) != 0)
-          ++energy_maps_2 (bin_index, index);
-        if ((val3 & quantized_data[index]) != 0)
-          ++energy_maps_3 (bin_index, index);
-#else
         if ((val1 & quantized_data[index]) != 0)
           ++energy_maps (bin_index, index);
         if ((val2 & quantized_data[index]) != 0)
           ++energy_maps (bin_index, index);
         if ((val3 & quantized_data[index]) != 0)
           ++energy_maps (bin_index, index);
-#endif
       }
     }
 
     modality_energy_maps.push_back (energy_maps);
-#ifdef LINEMOD_USE_SEPARATE_ENERGY_MAPS
-    modality_energy_maps_1.push_back (energy_maps_1);
-    modality_energy_maps_2.push_back (energy_maps_2);
-    modality_energy_maps_3.push_back (energy_maps_3);
-#endif
   }
 
   // create linearized maps
-  const std::size_t step_size = 8;
+  std::size_t step_size = 8;
   std::vector<std::vector<LinearizedMaps> > modality_linearized_maps;
-#ifdef LINEMOD_USE_SEPARATE_ENERGY_MAPS
-  std::vector<std::vector<LinearizedMaps> > modality_linearized_maps_1;
-  std::vector<std::vector<LinearizedMaps> > modality_linearized_maps_2;
-  std::vector<std::vector<LinearizedMaps> > modality_linearized_maps_3;
-#endif
   for (std::size_t modality_index = 0; modality_index < nr_modalities; ++modality_index)
   {
     const std::size_t width = modality_energy_maps[modality_index].getWidth ();
     const std::size_t height = modality_energy_maps[modality_index].getHeight ();
 
     std::vector<LinearizedMaps> linearized_maps;
-#ifdef LINEMOD_USE_SEPARATE_ENERGY_MAPS
-    std::vector<LinearizedMaps> linearized_maps_1;
-    std::vector<LinearizedMaps> linearized_maps_2;
-    std::vector<LinearizedMaps> linearized_maps_3;
-#endif
     const std::size_t nr_bins = modality_energy_maps[modality_index].getNumOfBins ();
     for (std::size_t bin_index = 0; bin_index < nr_bins; ++bin_index)
     {
       unsigned char * energy_map = modality_energy_maps[modality_index] (bin_index);
-#ifdef LINEMOD_USE_SEPARATE_ENERGY_MAPS
-      unsigned char * energy_map_1 = modality_energy_maps_1[modality_index] (bin_index);
-      unsigned char * energy_map_2 = modality_energy_maps_2[modality_index] (bin_index);
-      unsigned char * energy_map_3 = modality_energy_maps_3[modality_index] (bin_index);
-#endif
 
       LinearizedMaps maps;
       maps.initialize (width, height, step_size);
-#ifdef LINEMOD_USE_SEPARATE_ENERGY_MAPS
-      LinearizedMaps maps_1;
-      LinearizedMaps maps_2;
-      LinearizedMaps maps_3;
-      maps_1.initialize (width, height, step_size);
-      maps_2.initialize (width, height, step_size);
-      maps_3.initialize (width, height, step_size);
-#endif
       for (std::size_t map_row = 0; map_row < step_size; ++map_row)
       {
         for (std::size_t map_col = 0; map_col < step_size; ++map_col)
         {
           unsigned char * linearized_map = maps (map_col, map_row);
-#ifdef LINEMOD_USE_SEPARATE_ENERGY_MAPS
-          unsigned char * linearized_map_1 = maps_1 (map_col, map_row);
-          unsigned char * linearized_map_2 = maps_2 (map_col, map_row);
-          unsigned char * linearized_map_3 = maps_3 (map_col, map_row);
-#endif
 
           // copy data from energy maps
           const std::size_t lin_width = width/step_size;
@@ -502,332 +457,55 @@ pcl::LINEMOD::detectTemplates (const std::vector<QuantizableModality*> & modalit
               const std::size_t tmp_row_index = row_index*step_size + map_row;
 
               linearized_map[row_index*lin_width + col_index] = energy_map[tmp_row_index*width + tmp_col_index];
-#ifdef LINEMOD_USE_SEPARATE_ENERGY_MAPS
-              linearized_map_1[row_index*lin_width + col_index] = energy_map_1[tmp_row_index*width + tmp_col_index];
-              linearized_map_2[row_index*lin_width + col_index] = energy_map_2[tmp_row_index*width + tmp_col_index];
-              linearized_map_3[row_index*lin_width + col_index] = energy_map_3[tmp_row_index*width + tmp_col_index];
-#endif
             }
           }
         }
       }
 
       linearized_maps.push_back (maps);
-#ifdef LINEMOD_USE_SEPARATE_ENERGY_MAPS
-      linearized_maps_1.push_back (maps_1);
-      linearized_maps_2.push_back (maps_2);
-      linearized_maps_3.push_back (maps_3);
-#endif
     }
 
     modality_linearized_maps.push_back (linearized_maps);
-#ifdef LINEMOD_USE_SEPARATE_ENERGY_MAPS
-    modality_linearized_maps_1.push_back (linearized_maps_1);
-    modality_linearized_maps_2.push_back (linearized_maps_2);
-    modality_linearized_maps_3.push_back (linearized_maps_3);
-#endif
   }
 
-  // compute scores for templates
-  const std::size_t width = modality_energy_maps[0].getWidth ();
-  const std::size_t height = modality_energy_maps[0].getHeight ();
-  for (std::size_t template_index = 0; template_index < templates_.size (); ++template_index)
+  // compute scores for templates; the templates are matched independently and their
+  // detections are stored in template order
+  std::size_t width = modality_energy_maps[0].getWidth ();
+  std::size_t height = modality_energy_maps[0].getHeight ();
+  std::size_t mem_width = width / step_size;
+  std::size_t mem_height = height / step_size;
+  std::size_t mem_size = mem_width * mem_height;
+  int nr_templates = static_cast<int> (templates_.size ());
+
+  std::vector<std::vector<LINEMODDetection> > template_detections (nr_templates);
+
+#pragma omp parallel for \
+  default(none) \
+  shared(modality_linearized_maps, template_detections, nr_templates, mem_width, mem_height, mem_size, step_size) \
+  schedule(dynamic, 8) \
+  num_threads(pcl::utils::getNumberOfThreads (threads_))
+  for (int template_index = 0; template_index < nr_templates; ++template_index)
   {
-    const std::size_t mem_width = width / step_size;
-    const std::size_t mem_height = height / step_size;
-    const std::size_t mem_size = mem_width * mem_height;
-
-#ifdef __SSE2__
-    unsigned short * score_sums = reinterpret_cast<unsigned short*> (aligned_malloc (mem_size*sizeof(unsigned short)));
-    unsigned char * tmp_score_sums = reinterpret_cast<unsigned char*> (aligned_malloc (mem_size*sizeof(unsigned char)));
-    memset (score_sums, 0, mem_size*sizeof (score_sums[0]));
-    memset (tmp_score_sums, 0, mem_size*sizeof (tmp_score_sums[0]));
-
-    //__m128i * score_sums_m128i = reinterpret_cast<__m128i*> (score_sums);
-    __m128i * tmp_score_sums_m128i = reinterpret_cast<__m128i*> (tmp_score_sums);
-
-    const std::size_t mem_size_16 = mem_size / 16;
-    //const std::size_t mem_size_mod_16 = mem_size & 15;
-    const std::size_t mem_size_mod_16_base = mem_size_16 * 16;
-
-    int max_score = 0;
-    std::size_t copy_back_counter = 0;
-    for (const auto &feature : templates_[template_index].features)
-    {
-      for (std::size_t bin_index = 0; bin_index < 8; ++bin_index)
-      {
-        if ((feature.quantized_value & (0x1<<bin_index)) != 0)
-        {
-          max_score += 4;
-
-          unsigned char * data = modality_linearized_maps[feature.modality_index][bin_index].getOffsetMap (feature.x, feature.y);
-          __m128i * data_m128i = reinterpret_cast<__m128i*> (data);
+    std::vector<unsigned short> score_sums (mem_size);
+    std::vector<unsigned char> tmp_score_sums (mem_size);
 
-          for (std::size_t mem_index = 0; mem_index < mem_size_16; ++mem_index)
-          {
-            __m128i aligned_data_m128i = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (data_m128i + mem_index)); // SSE2
-            //__m128i aligned_data_m128i = _mm_lddqu_si128 (reinterpret_cast<const __m128i*> (data_m128i + mem_index)); // SSE3
-            tmp_score_sums_m128i[mem_index] = _mm_add_epi8 (tmp_score_sums_m128i[mem_index], aligned_data_m128i);
-          }
-          for (std::size_t mem_index = mem_size_mod_16_base; mem_index < mem_size; ++mem_index)
-          {
-            tmp_score_sums[mem_index] = static_cast<unsigned char> (tmp_score_sums[mem_index] + data[mem_index]);
-          }
-        }
-      }
+    const int max_score = computeTemplateScores (templates_[template_index], modality_linearized_maps, 1.0f, mem_size,
+                                                 score_sums.data (), tmp_score_sums.data ());
 
-      ++copy_back_counter;
-
-      //if ((feature_index & 7) == 7)
-      //if ((feature_index & 63) == 63)
-      if (copy_back_counter > 63) // only valid if each feature has only one bit set..
-      {
-        copy_back_counter = 0;
-
-        for (std::size_t mem_index = 0; mem_index < mem_size_mod_16_base; mem_index += 16)
-        {
-          score_sums[mem_index+0]  = static_cast<unsigned short> (score_sums[mem_index+0]  + tmp_score_sums[mem_index+0]);
-          score_sums[mem_index+1]  = static_cast<unsigned short> (score_sums[mem_index+1]  + tmp_score_sums[mem_index+1]);
-          score_sums[mem_index+2]  = static_cast<unsigned short> (score_sums[mem_index+2]  + tmp_score_sums[mem_index+2]);
-          score_sums[mem_index+3]  = static_cast<unsigned short> (score_sums[mem_index+3]  + tmp_score_sums[mem_index+3]);
-          score_sums[mem_index+4]  = static_cast<unsigned short> (score_sums[mem_index+4]  + tmp_score_sums[mem_index+4]);
-          score_sums[mem_index+5]  = static_cast<unsigned short> (score_sums[mem_index+5]  + tmp_score_sums[mem_index+5]);
-          score_sums[mem_index+6]  = static_cast<unsigned short> (score_sums[mem_index+6]  + tmp_score_sums[mem_index+6]);
-          score_sums[mem_index+7]  = static_cast<unsigned short> (score_sums[mem_index+7]  + tmp_score_sums[mem_index+7]);
-          score_sums[mem_index+8]  = static_cast<unsigned short> (score_sums[mem_index+8]  + tmp_score_sums[mem_index+8]);
-          score_sums[mem_index+9]  = static_cast<unsigned short> (score_sums[mem_index+9]  + tmp_score_sums[mem_index+9]);
-          score_sums[mem_index+10] = static_cast<unsigned short> (score_sums[mem_index+10] + tmp_score_sums[mem_index+10]);
-          score_sums[mem_index+11] = static_cast<unsigned short> (score_sums[mem_index+11] + tmp_score_sums[mem_index+11]);
-          score_sums[mem_index+12] = static_cast<unsigned short> (score_sums[mem_index+12] + tmp_score_sums[mem_index+12]);
-          score_sums[mem_index+13] = static_cast<unsigned short> (score_sums[mem_index+13] + tmp_score_sums[mem_index+13]);
-          score_sums[mem_index+14] = static_cast<unsigned short> (score_sums[mem_index+14] + tmp_score_sums[mem_index+14]);
-          score_sums[mem_index+15] = static_cast<unsigned short> (score_sums[mem_index+15] + tmp_score_sums[mem_index+15]);
-        }
-        for (std::size_t mem_index = mem_size_mod_16_base; mem_index < mem_size; ++mem_index)
-        {
-          score_sums[mem_index] = static_cast<unsigned short> (score_sums[mem_index] + tmp_score_sums[mem_index]);
-        }
-
-        memset (tmp_score_sums, 0, mem_size*sizeof (tmp_score_sums[0]));
-      }
-    }
-    {
-      for (std::size_t mem_index = 0; mem_index < mem_size; ++mem_index)
-      {
-        score_sums[mem_index] = static_cast<unsigned short> (score_sums[mem_index] + tmp_score_sums[mem_index]);
-      }
-        
-      memset (tmp_score_sums, 0, mem_size*sizeof (tmp_score_sums[0]));
-    }
-#else
-    unsigned short * score_sums = new unsigned short[mem_size];
-    //unsigned char * score_sums = new unsigned char[mem_size];
-    memset (score_sums, 0, mem_size*sizeof (score_sums[0]));
-
-#ifdef LINEMOD_USE_SEPARATE_ENERGY_MAPS
-    unsigned short * score_sums_1 = new unsigned short[mem_size];
-    unsigned short * score_sums_2 = new unsigned short[mem_size];
-    unsigned short * score_sums_3 = new unsigned short[mem_size];
-    memset (score_sums_1, 0, mem_size*sizeof (score_sums_1[0]));
-    memset (score_sums_2, 0, mem_size*sizeof (score_sums_2[0]));
-    memset (score_sums_3, 0, mem_size*sizeof (score_sums_3[0]));
-#endif
-
-    int max_score = 0;
-    for (std::size_t feature_index = 0; feature_index < templates_[template_index].features.size (); ++feature_index)
-    {
-      const QuantizedMultiModFeature & feature = templates_[template_index].features[feature_index];
-
-      //feature.modality_index;
-      for (std::size_t bin_index = 0; bin_index < 8; ++bin_index)
-      {
-        if ((feature.quantized_value & (0x1<<bin_index)) != 0)
-        {
-#ifdef LINEMOD_USE_SEPARATE_ENERGY_MAPS
-          ++max_score;
-
-          unsigned char * data = modality_linearized_maps[feature.modality_index][bin_index].getOffsetMap (feature.x, feature.y);
-          unsigned char * data_1 = modality_linearized_maps_1[feature.modality_index][bin_index].getOffsetMap (feature.x, feature.y);
-          unsigned char * data_2 = modality_linearized_maps_2[feature.modality_index][bin_index].getOffsetMap (feature.x, feature.y);
-          unsigned char * data_3 = modality_linearized_maps_3[feature.modality_index][bin_index].getOffsetMap (feature.x, feature.y);
-          for (std::size_t mem_index = 0; mem_index < mem_size; ++mem_index)
-          {
-            score_sums[mem_index] += data[mem_index];
-            score_sums_1[mem_index] += data_1[mem_index];
-            score_sums_2[mem_index] += data_2[mem_index];
-            score_sums_3[mem_index] += data_3[mem_index];
-          }
-#else
-          max_score += 4;
-
-          unsigned char * data = modality_linearized_maps[feature.modality_index][bin_index].getOffsetMap (feature.x, feature.y);
-          for (std::size_t mem_index = 0; mem_index < mem_size; ++mem_index)
-          {
-            score_sums[mem_index] += data[mem_index];
-          }
-#endif
-        }
-      }
-    }
-#endif
-
-    const float inv_max_score = 1.0f / float (max_score);
-
-    // we compute a new threshold based on the threshold supplied by the user;
-    // this is due to the use of the cosine approx. in the response computation;
-#ifdef LINEMOD_USE_SEPARATE_ENERGY_MAPS
-    const float raw_threshold = (4.0f * float (max_score) / 2.0f + template_threshold_ * (4.0f * float (max_score) / 2.0f));
-#else
-    const float raw_threshold = (float (max_score) / 2.0f + template_threshold_ * (float (max_score) / 2.0f));
-#endif
-
-    //int max_value = 0;
-    //size_t max_index = 0;
-    for (std::size_t mem_index = 0; mem_index < mem_size; ++mem_index)
-    {
-      //const float score = score_sums[mem_index] * inv_max_score;
-
-#ifdef LINEMOD_USE_SEPARATE_ENERGY_MAPS
-      const float raw_score = score_sums[mem_index] 
-        + score_sums_1[mem_index]
-        + score_sums_2[mem_index]
-        + score_sums_3[mem_index];
-
-      const float score = 2.0f * static_cast<float> (raw_score) * 0.25f * inv_max_score - 1.0f;
-#else
-      const float raw_score = score_sums[mem_index];
-
-      const float score = 2.0f * static_cast<float> (raw_score) * inv_max_score - 1.0f;
-#endif
-
-
-      //if (score > template_threshold_) 
-      if (raw_score > raw_threshold) /// \todo Ask Stefan why this line was used instead of the one above
-      {
-        const std::size_t mem_col_index = (mem_index % mem_width);
-        const std::size_t mem_row_index = (mem_index / mem_width);
-
-        if (use_non_max_suppression_)
-        {
-          bool is_local_max = true;
-          for (std::size_t sup_row_index = mem_row_index-1; sup_row_index <= mem_row_index+1 && is_local_max; ++sup_row_index)
-          {
-            if (sup_row_index >= mem_height)
-              continue;
-
-            for (std::size_t sup_col_index = mem_col_index-1; sup_col_index <= mem_col_index+1; ++sup_col_index)
-            {
-              if (sup_col_index >= mem_width)
-                continue;
-
-              if (score_sums[mem_index] < score_sums[sup_row_index*mem_width + sup_col_index])
-              {
-                is_local_max = false;
-                break;
-              }
-            } 
-          }
-
-          if (!is_local_max)
-            continue;
-        }
-
-        LINEMODDetection detection;
-
-        if (average_detections_)
-        {
-          std::size_t average_col = 0;
-          std::size_t average_row = 0;
-          std::size_t sum = 0;
-
-          for (std::size_t sup_row_index = mem_row_index-1; sup_row_index <= mem_row_index+1; ++sup_row_index)
-          {
-            if (sup_row_index >= mem_height)
-              continue;
-
-            for (std::size_t sup_col_index = mem_col_index-1; sup_col_index <= mem_col_index+1; ++sup_col_index)
-            {
-              if (sup_col_index >= mem_width)
-                continue;
-
-              const std::size_t weight = static_cast<std::size_t> (score_sums[sup_row_index*mem_width + sup_col_index]);
-              average_col += sup_col_index * weight;
-              average_row += sup_row_index * weight;
-              sum += weight;
-            } 
-          }
-
-          average_col *= step_size;
-          average_row *= step_size;
-
-          average_col /= sum;
-          average_row /= sum;
-
-          //std::cerr << mem_col_index << ", " << mem_row_index << " - " << average_col << ", " << average_row << std::endl;
-          std::cerr << mem_col_index*step_size << ", " << mem_row_index*step_size << " - " << average_col << ", " << average_row << std::endl;
-
-          const std::size_t detection_col_index = average_col;// * step_size;
-          const std::size_t detection_row_index = average_row;// * step_size;
-
-          detection.x = static_cast<int> (detection_col_index);
-          detection.y = static_cast<int> (detection_row_index);
-        }
-        else
-        {
-          const std::size_t detection_col_index = mem_col_index * step_size;
-          const std::size_t detection_row_index = mem_row_index * step_size;
-
-          detection.x = static_cast<int> (detection_col_index);
-          detection.y = static_cast<int> (detection_row_index);
-        }
-
-        detection.template_id = static_cast<int> (template_index);
-        detection.score = score;
-
-#ifdef LINEMOD_USE_SEPARATE_ENERGY_MAPS
-        std::cerr << "score: " << static_cast<float> (raw_score) * inv_max_score * 0.25f << ", " << (2.0f * static_cast<float> (raw_score) * inv_max_score - 1.0f) << std::endl;
-        std::cerr << "score0: " << static_cast<float> (score_sums[mem_index]) * inv_max_score << ", " << (2.0f * static_cast<float> (score_sums[mem_index]) * inv_max_score - 1.0f) << std::endl;
-        std::cerr << "score1: " << static_cast<float> (score_sums_1[mem_index]) * inv_max_score << ", " << (2.0f * static_cast<float> (score_sums_1[mem_index]) * inv_max_score - 1.0f) << std::endl;
-        std::cerr << "score2: " << static_cast<float> (score_sums_2[mem_index]) * inv_max_score << ", " << (2.0f * static_cast<float> (score_sums_2[mem_index]) * inv_max_score - 1.0f) << std::endl;
-        std::cerr << "score3: " << static_cast<float> (score_sums_3[mem_index]) * inv_max_score << ", " << (2.0f * static_cast<float> (score_sums_3[mem_index]) * inv_max_score - 1.0f) << std::endl;
-#endif
-
-
-        detections.push_back (detection);
-      }
-    }
-
-#ifdef __SSE2__
-    aligned_free (score_sums);
-    aligned_free (tmp_score_sums);
-#else
-    delete[] score_sums;
-#endif
-
-#ifdef LINEMOD_USE_SEPARATE_ENERGY_MAPS
-    delete[] score_sums_1;
-    delete[] score_sums_2;
-    delete[] score_sums_3;
-#endif
+    collectDetections (score_sums.data (), max_score, mem_width, mem_height, step_size, template_index, 1.0f,
+                       template_detections[template_index]);
   }
 
+  for (const auto &detections_of_template : template_detections)
+    detections.insert (detections.end (), detections_of_template.begin (), detections_of_template.end ());
+
   // release data
   for (std::size_t modality_index = 0; modality_index < modality_linearized_maps.size (); ++modality_index)
   {
     modality_energy_maps[modality_index].releaseAll ();
-#ifdef LINEMOD_USE_SEPARATE_ENERGY_MAPS
-    modality_energy_maps_1[modality_index].releaseAll ();
-    modality_energy_maps_2[modality_index].releaseAll ();
-    modality_energy_maps_3[modality_index].releaseAll ();
-#endif
     for (auto &bin_index : modality_linearized_maps[modality_index])
     {
       bin_index.releaseAll ();
-#ifdef LINEMOD_USE_SEPARATE_ENERGY_MAPS
-      modality_linearized_maps_1[modality_index][bin_index].releaseAll ();
-      modality_linearized_maps_2[modality_index][bin_index].releaseAll ();
-      modality_linearized_maps_3[modality_index][bin_index].releaseAll ();
-#endif
     }
   }
 }
@@ -843,11 +521,6 @@ pcl::LINEMOD::detectTemplatesSemiScaleInvariant (
 {
   // create energy maps
   std::vector<EnergyMaps> modality_energy_maps;
-#ifdef LINEMOD_USE_SEPARATE_ENERGY_MAPS
-  std::vector<EnergyMaps> modality_energy_maps_1;
-  std::vector<EnergyMaps> modality_energy_maps_2;
-  std::vector<EnergyMaps> modality_energy_maps_3;
-#endif
   const std::size_t nr_modalities = modalities.size();
   for (std::size_t modality_index = 0; modality_index < nr_modalities; ++modality_index)
   {
@@ -861,14 +534,6 @@ pcl::LINEMOD::detectTemplatesSemiScaleInvariant (
     const int nr_bins = 8;
     EnergyMaps energy_maps;
     energy_maps.initialize (width, height, nr_bins);
-#ifdef LINEMOD_USE_SEPARATE_ENERGY_MAPS
-    EnergyMaps energy_maps_1;
-    EnergyMaps energy_maps_2;
-    EnergyMaps energy_maps_3;
-    energy_maps_1.initialize (width, height, nr_bins);
-    energy_maps_2.initialize (width, height, nr_bins);
-    energy_maps_3.initialize (width, height, nr_bins);
-#endif
     //std::vector< unsigned char* > energy_maps(nr_bins);
     for (int bin_index = 0; bin_index < nr_bins; ++bin_index)
     {
@@ -884,81 +549,39 @@ pcl::LINEMOD::detectTemplatesSemiScaleInvariant (
       {
         if ((val0 & quantized_data[index]) != 0)
           ++energy_maps (bin_index, index);
-#ifdef LINEMOD_USE_SEPARATE_ENERGY_MAPS
-        if ((val1 & quantized_data[index]) != 0)
-          ++energy_maps_1 (bin_index, index);
-        if ((val2 & quantized_data[index]) != 0)
-          ++energy_maps_2 (bin_index, index);
-        if ((val3 & quantized_data[index]) != 0)
-          ++energy_maps_3 (bin_index, index);
-#else
         if ((val1 & quantized_data[index]) != 0)
           ++energy_maps (bin_index, index);
         if ((val2 & quantized_data[index]) != 0)
           ++energy_maps (bin_index, index);
         if ((val3 & quantized_data[index]) != 0)
           ++energy_maps (bin_index, index);
-#endif
       }
     }
 
     modality_energy_maps.push_back (energy_maps);
-#ifdef LINEMOD_USE_SEPARATE_ENERGY_MAPS
-    modality_energy_maps_1.push_back (energy_maps_1);
-    modality_energy_maps_2.push_back (energy_maps_2);
-    modality_energy_maps_3.push_back (energy_maps_3);
-#endif
   }
 
   // create linearized maps
-  const std::size_t step_size = 8;
+  std::size_t step_size = 8;
   std::vector<std::vector<LinearizedMaps> > modality_linearized_maps;
-#ifdef LINEMOD_USE_SEPARATE_ENERGY_MAPS
-  std::vector<std::vector<LinearizedMaps> > modality_linearized_maps_1;
-  std::vector<std::vector<LinearizedMaps> > modality_linearized_maps_2;
-  std::vector<std::vector<LinearizedMaps> > modality_linearized_maps_3;
-#endif
   for (std::size_t modality_index = 0; modality_index < nr_modalities; ++modality_index)
   {
     const std::size_t width = modality_energy_maps[modality_index].getWidth ();
     const std::size_t height = modality_energy_maps[modality_index].getHeight ();
 
     std::vector<LinearizedMaps> linearized_maps;
-#ifdef LINEMOD_USE_SEPARATE_ENERGY_MAPS
-    std::vector<LinearizedMaps> linearized_maps_1;
-    std::vector<LinearizedMaps> linearized_maps_2;
-    std::vector<LinearizedMaps> linearized_maps_3;
-#endif
     const std::size_t nr_bins = modality_energy_maps[modality_index].getNumOfBins ();
     for (std::size_t bin_index = 0; bin_index < nr_bins; ++bin_index)
     {
       unsigned char * energy_map = modality_energy_maps[modality_index] (bin_index);
-#ifdef LINEMOD_USE_SEPARATE_ENERGY_MAPS
-      unsigned char * energy_map_1 = modality_energy_maps_1[modality_index] (bin_index);
-      unsigned char * energy_map_2 = modality_energy_maps_2[modality_index] (bin_index);
-      unsigned char * energy_map_3 = modality_energy_maps_3[modality_index] (bin_index);
-#endif
 
       LinearizedMaps maps;
       maps.initialize (width, height, step_size);
-#ifdef LINEMOD_USE_SEPARATE_ENERGY_MAPS
-      LinearizedMaps maps_1;
-      LinearizedMaps maps_2;
-      LinearizedMaps maps_3;
-      maps_1.initialize (width, height, step_size);
-      maps_2.initialize (width, height, step_size);
-      maps_3.initialize (width, height, step_size);
-#endif
       for (std::size_t map_row = 0; map_row < step_size; ++map_row)
       {
         for (std::size_t map_col = 0; map_col < step_size; ++map_col)
         {
           unsigned char * linearized_map = maps (map_col, map_row);
-#ifdef LINEMOD_USE_SEPARATE_ENERGY_MAPS
-          unsigned char * linearized_map_1 = maps_1 (map_col, map_row);
-          unsigned char * linearized_map_2 = maps_2 (map_col, map_row);
-          unsigned char * linearized_map_3 = maps_3 (map_col, map_row);
-#endif
 
           // copy data from energy maps
           const std::size_t lin_width = width/step_size;
@@ -971,337 +594,170 @@ pcl::LINEMOD::detectTemplatesSemiScaleInvariant (
               const std::size_t tmp_row_index = row_index*step_size + map_row;
 
               linearized_map[row_index*lin_width + col_index] = energy_map[tmp_row_index*width + tmp_col_index];
-#ifdef LINEMOD_USE_SEPARATE_ENERGY_MAPS
-              linearized_map_1[row_index*lin_width + col_index] = energy_map_1[tmp_row_index*width + tmp_col_index];
-              linearized_map_2[row_index*lin_width + col_index] = energy_map_2[tmp_row_index*width + tmp_col_index];
-              linearized_map_3[row_index*lin_width + col_index] = energy_map_3[tmp_row_index*width + tmp_col_index];
-#endif
             }
           }
         }
       }
 
       linearized_maps.push_back (maps);
-#ifdef LINEMOD_USE_SEPARATE_ENERGY_MAPS
-      linearized_maps_1.push_back (maps_1);
-      linearized_maps_2.push_back (maps_2);
-      linearized_maps_3.push_back (maps_3);
-#endif
     }
 
     modality_linearized_maps.push_back (linearized_maps);
-#ifdef LINEMOD_USE_SEPARATE_ENERGY_MAPS
-    modality_linearized_maps_1.push_back (linearized_maps_1);
-    modality_linearized_maps_2.push_back (linearized_maps_2);
-    modality_linearized_maps_3.push_back (linearized_maps_3);
-#endif
   }
 
-  // compute scores for templates
-  const std::size_t width = modality_energy_maps[0].getWidth ();
-  const std::size_t height = modality_energy_maps[0].getHeight ();
-  for (std::size_t template_index = 0; template_index < templates_.size (); ++template_index)
+  // compute scores for templates; the templates are matched independently at every scale and
+  // their detections are stored in template and scale order
+  std::size_t width = modality_energy_maps[0].getWidth ();
+  std::size_t height = modality_energy_maps[0].getHeight ();
+  std::size_t mem_width = width / step_size;
+  std::size_t mem_height = height / step_size;
+  std::size_t mem_size = mem_width * mem_height;
+
+  std::vector<float> scales;
+  for (float scale = min_scale; scale <= max_scale; scale *= scale_multiplier)
+    scales.push_back (scale);
+
+  int nr_scales = static_cast<int> (scales.size ());
+  int nr_matches = static_cast<int> (templates_.size ()) * nr_scales;
+
+  std::vector<std::vector<LINEMODDetection> > match_detections (nr_matches);
+
+#pragma omp parallel for \
+  default(none) \
+  shared(modality_linearized_maps, match_detections, scales, nr_scales, nr_matches, mem_width, mem_height, mem_size, step_size) \
+  schedule(dynamic, 8) \
+  num_threads(pcl::utils::getNumberOfThreads (threads_))
+  for (int match_index = 0; match_index < nr_matches; ++match_index)
   {
-    const std::size_t mem_width = width / step_size;
-    const std::size_t mem_height = height / step_size;
-    const std::size_t mem_size = mem_width * mem_height;
-
-    for (float scale = min_scale; scale <= max_scale; scale *= scale_multiplier)
-    {
-#ifdef __SSE2__
-      unsigned short * score_sums = reinterpret_cast<unsigned short*> (aligned_malloc (mem_size*sizeof(unsigned short)));
-      unsigned char * tmp_score_sums = reinterpret_cast<unsigned char*> (aligned_malloc (mem_size*sizeof(unsigned char)));
-      memset (score_sums, 0, mem_size*sizeof (score_sums[0]));
-      memset (tmp_score_sums, 0, mem_size*sizeof (tmp_score_sums[0]));
-
-      //__m128i * score_sums_m128i = reinterpret_cast<__m128i*> (score_sums);
-      __m128i * tmp_score_sums_m128i = reinterpret_cast<__m128i*> (tmp_score_sums);
-
-      const std::size_t mem_size_16 = mem_size / 16;
-      //const std::size_t mem_size_mod_16 = mem_size & 15;
-      const std::size_t mem_size_mod_16_base = mem_size_16 * 16;
-
-      int max_score = 0;
-      std::size_t copy_back_counter = 0;
-      for (const auto &feature : templates_[template_index].features)
-      {
-        for (std::size_t bin_index = 0; bin_index < 8; ++bin_index)
-        {
-          if ((feature.quantized_value & (0x1<<bin_index)) != 0)
-          {
-            max_score += 4;
-
-            unsigned char *data = modality_linearized_maps[feature.modality_index][bin_index].getOffsetMap (
-                std::size_t (float (feature.x) * scale), std::size_t (float (feature.y) * scale));
-            __m128i * data_m128i = reinterpret_cast<__m128i*> (data);
+    const int template_index = match_index / nr_scales;
+    const float scale = scales[match_index % nr_scales];
 
-            for (std::size_t mem_index = 0; mem_index < mem_size_16; ++mem_index)
-            {
-              __m128i aligned_data_m128i = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (data_m128i + mem_index)); // SSE2
-              //__m128i aligned_data_m128i = _mm_lddqu_si128 (reinterpret_cast<const __m128i*> (data_m128i + mem_index)); // SSE3
-              tmp_score_sums_m128i[mem_index] = _mm_add_epi8 (tmp_score_sums_m128i[mem_index], aligned_data_m128i);
-            }
-            for (std::size_t mem_index = mem_size_mod_16_base; mem_index < mem_size; ++mem_index)
-            {
-              tmp_score_sums[mem_index] = static_cast<unsigned char> (tmp_score_sums[mem_index] + data[mem_index]);
-            }
-          }
-        }
+    std::vector<unsigned short> score_sums (mem_size);
+    std::vector<unsigned char> tmp_score_sums (mem_size);
 
-        ++copy_back_counter;
+    const int max_score = computeTemplateScores (templates_[template_index], modality_linearized_maps, scale, mem_size,
+                                                 score_sums.data (), tmp_score_sums.data ());
 
-        //if ((feature_index & 7) == 7)
-        //if ((feature_index & 63) == 63)
-        if (copy_back_counter > 63) // only valid if each feature has only one bit set..
-        {
-          copy_back_counter = 0;
+    collectDetections (score_sums.data (), max_score, mem_width, mem_height, step_size, template_index, scale,
+                       match_detections[match_index]);
+  }
 
-          for (std::size_t mem_index = 0; mem_index < mem_size_mod_16_base; mem_index += 16)
-          {
-            score_sums[mem_index+0]  = static_cast<unsigned short> (score_sums[mem_index+0]  + tmp_score_sums[mem_index+0]);
-            score_sums[mem_index+1]  = static_cast<unsigned short> (score_sums[mem_index+1]  + tmp_score_sums[mem_index+1]);
-            score_sums[mem_index+2]  = static_cast<unsigned short> (score_sums[mem_index+2]  + tmp_score_sums[mem_index+2]);
-            score_sums[mem_index+3]  = static_cast<unsigned short> (score_sums[mem_index+3]  + tmp_score_sums[mem_index+3]);
-            score_sums[mem_index+4]  = static_cast<unsigned short> (score_sums[mem_index+4]  + tmp_score_sums[mem_index+4]);
-            score_sums[mem_index+5]  = static_cast<unsigned short> (score_sums[mem_index+5]  + tmp_score_sums[mem_index+5]);
-            score_sums[mem_index+6]  = static_cast<unsigned short> (score_sums[mem_index+6]  + tmp_score_sums[mem_index+6]);
-            score_sums[mem_index+7]  = static_cast<unsigned short> (score_sums[mem_index+7]  + tmp_score_sums[mem_index+7]);
-            score_sums[mem_index+8]  = static_cast<unsigned short> (score_sums[mem_index+8]  + tmp_score_sums[mem_index+8]);
-            score_sums[mem_index+9]  = static_cast<unsigned short> (score_sums[mem_index+9]  + tmp_score_sums[mem_index+9]);
-            score_sums[mem_index+10] = static_cast<unsigned short> (score_sums[mem_index+10] + tmp_score_sums[mem_index+10]);
-            score_sums[mem_index+11] = static_cast<unsigned short> (score_sums[mem_index+11] + tmp_score_sums[mem_index+11]);
-            score_sums[mem_index+12] = static_cast<unsigned short> (score_sums[mem_index+12] + tmp_score_sums[mem_index+12]);
-            score_sums[mem_index+13] = static_cast<unsigned short> (score_sums[mem_index+13] + tmp_score_sums[mem_index+13]);
-            score_sums[mem_index+14] = static_cast<unsigned short> (score_sums[mem_index+14] + tmp_score_sums[mem_index+14]);
-            score_sums[mem_index+15] = static_cast<unsigned short> (score_sums[mem_index+15] + tmp_score_sums[mem_index+15]);
-          }
-          for (std::size_t mem_index = mem_size_mod_16_base; mem_index < mem_size; ++mem_index)
-          {
-            score_sums[mem_index] = static_cast<unsigned short> (score_sums[mem_index] + tmp_score_sums[mem_index]);
-          }
+  for (const auto &detections_of_match : match_detections)
+    detections.insert (detections.end (), detections_of_match.begin (), detections_of_match.end ());
 
-          memset (tmp_score_sums, 0, mem_size*sizeof (tmp_score_sums[0]));
-        }
-      }
-      {
-        for (std::size_t mem_index = 0; mem_index < mem_size; ++mem_index)
-        {
-          score_sums[mem_index] = static_cast<unsigned short> (score_sums[mem_index] + tmp_score_sums[mem_index]);
-        }
-        
-        memset (tmp_score_sums, 0, mem_size*sizeof (tmp_score_sums[0]));
-      }
-#else
-      unsigned short * score_sums = new unsigned short[mem_size];
-      //unsigned char * score_sums = new unsigned char[mem_size];
-      memset (score_sums, 0, mem_size*sizeof (score_sums[0]));
-
-#ifdef LINEMOD_USE_SEPARATE_ENERGY_MAPS
-      unsigned short * score_sums_1 = new unsigned short[mem_size];
-      unsigned short * score_sums_2 = new unsigned short[mem_size];
-      unsigned short * score_sums_3 = new unsigned short[mem_size];
-      memset (score_sums_1, 0, mem_size*sizeof (score_sums_1[0]));
-      memset (score_sums_2, 0, mem_size*sizeof (score_sums_2[0]));
-      memset (score_sums_3, 0, mem_size*sizeof (score_sums_3[0]));
-#endif
+  // release data
+  for (std::size_t modality_index = 0; modality_index < modality_linearized_maps.size (); ++modality_index)
+  {
+    modality_energy_maps[modality_index].releaseAll ();
+    for (auto &bin_index : modality_linearized_maps[modality_index])
+    {
+      bin_index.releaseAll ();
+    }
+  }
+}
 
-      int max_score = 0;
-      for (std::size_t feature_index = 0; feature_index < templates_[template_index].features.size (); ++feature_index)
-      {
-        const QuantizedMultiModFeature & feature = templates_[template_index].features[feature_index];
+//////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::LINEMOD::collectDetections (const unsigned short * score_sums, const int max_score,
+                                 const std::size_t mem_width, const std::size_t mem_height, const std::size_t step_size,
+                                 const int template_id, const float scale,
+                                 std::vector<LINEMODDetection> & detections) const
+{
+  const std::size_t mem_size = mem_width * mem_height;
+  const float inv_max_score = 1.0f / float (max_score);
 
-        //feature.modality_index;
-        for (std::size_t bin_index = 0; bin_index < 8; ++bin_index)
-        {
-          if ((feature.quantized_value & (0x1<<bin_index)) != 0)
-          {
-#ifdef LINEMOD_USE_SEPARATE_ENERGY_MAPS
-            ++max_score;
-
-            unsigned char * data = modality_linearized_maps[feature.modality_index][bin_index].getOffsetMap (feature.x*scale, feature.y*scale);
-            unsigned char * data_1 = modality_linearized_maps_1[feature.modality_index][bin_index].getOffsetMap (feature.x*scale, feature.y*scale);
-            unsigned char * data_2 = modality_linearized_maps_2[feature.modality_index][bin_index].getOffsetMap (feature.x*scale, feature.y*scale);
-            unsigned char * data_3 = modality_linearized_maps_3[feature.modality_index][bin_index].getOffsetMap (feature.x*scale, feature.y*scale);
-            for (std::size_t mem_index = 0; mem_index < mem_size; ++mem_index)
-            {
-              score_sums[mem_index] += data[mem_index];
-              score_sums_1[mem_index] += data_1[mem_index];
-              score_sums_2[mem_index] += data_2[mem_index];
-              score_sums_3[mem_index] += data_3[mem_index];
-            }
-#else
-            max_score += 4;
+  // we compute a new threshold based on the threshold supplied by the user;
+  // this is due to the use of the cosine approx. in the response computation;
+  const float raw_threshold = (float (max_score) / 2.0f + template_threshold_ * (float (max_score) / 2.0f));
 
-            unsigned char * data = modality_linearized_maps[feature.modality_index][bin_index].getOffsetMap (static_cast<std::size_t> (feature.x*scale), static_cast<std::size_t> (feature.y*scale));
-            for (std::size_t mem_index = 0; mem_index < mem_size; ++mem_index)
-            {
-              score_sums[mem_index] += data[mem_index];
-            }
-#endif
-          }
-        }
-      }
-#endif
+  for (std::size_t mem_index = 0; mem_index < mem_size; ++mem_index)
+  {
+    const float raw_score = score_sums[mem_index];
 
-      const float inv_max_score = 1.0f / float (max_score);
+    const float score = 2.0f * static_cast<float> (raw_score) * inv_max_score - 1.0f;
 
-      // we compute a new threshold based on the threshold supplied by the user;
-      // this is due to the use of the cosine approx. in the response computation;
-#ifdef LINEMOD_USE_SEPARATE_ENERGY_MAPS
-      const float raw_threshold = (4.0f * float (max_score) / 2.0f + template_threshold_ * (4.0f * float (max_score) / 2.0f));
-#else
-      const float raw_threshold = (float (max_score) / 2.0f + template_threshold_ * (float (max_score) / 2.0f));
-#endif
+    //if (score > template_threshold_) 
+    if (raw_score > raw_threshold) /// \todo Ask Stefan why this line was used instead of the one above
+    {
+      const std::size_t mem_col_index = (mem_index % mem_width);
+      const std::size_t mem_row_index = (mem_index / mem_width);
 
-      //int max_value = 0;
-      //size_t max_index = 0;
-      for (std::size_t mem_index = 0; mem_index < mem_size; ++mem_index)
+      if (use_non_max_suppression_)
       {
-        //const float score = score_sums[mem_index] * inv_max_score;
-
-#ifdef LINEMOD_USE_SEPARATE_ENERGY_MAPS
-        const float raw_score = score_sums[mem_index] 
-          + score_sums_1[mem_index]
-          + score_sums_2[mem_index]
-          + score_sums_3[mem_index];
-
-        const float score = 2.0f * static_cast<float> (raw_score) * 0.25f * inv_max_score - 1.0f;
-#else
-        const float raw_score = score_sums[mem_index];
-
-        const float score = 2.0f * static_cast<float> (raw_score) * inv_max_score - 1.0f;
-#endif
-
-
-        //if (score > template_threshold_) 
-        if (raw_score > raw_threshold) /// \todo Ask Stefan why this line was used instead of the one above
+        bool is_local_max = true;
+        for (std::size_t sup_row_index = mem_row_index-1; sup_row_index <= mem_row_index+1 && is_local_max; ++sup_row_index)
         {
-          const std::size_t mem_col_index = (mem_index % mem_width);
-          const std::size_t mem_row_index = (mem_index / mem_width);
+          if (sup_row_index >= mem_height)
+            continue;
 
-          if (use_non_max_suppression_)
+          for (std::size_t sup_col_index = mem_col_index-1; sup_col_index <= mem_col_index+1; ++sup_col_index)
           {
-            bool is_local_max = true;
-            for (std::size_t sup_row_index = mem_row_index-1; sup_row_index <= mem_row_index+1 && is_local_max; ++sup_row_index)
-            {
-              if (sup_row_index >= mem_height)
-                continue;
-
-              for (std::size_t sup_col_index = mem_col_index-1; sup_col_index <= mem_col_index+1; ++sup_col_index)
-              {
-                if (sup_col_index >= mem_width)
-                  continue;
-
-                if (score_sums[mem_index] < score_sums[sup_row_index*mem_width + sup_col_index])
-                {
-                  is_local_max = false;
-                  break;
-                }
-              } 
-            }
-
-            if (!is_local_max)
+            if (sup_col_index >= mem_width)
               continue;
-          }
-
-          LINEMODDetection detection;
 
-          if (average_detections_)
-          {
-            std::size_t average_col = 0;
-            std::size_t average_row = 0;
-            std::size_t sum = 0;
-
-            for (std::size_t sup_row_index = mem_row_index-1; sup_row_index <= mem_row_index+1; ++sup_row_index)
+            if (score_sums[mem_index] < score_sums[sup_row_index*mem_width + sup_col_index])
             {
-              if (sup_row_index >= mem_height)
-                continue;
-
-              for (std::size_t sup_col_index = mem_col_index-1; sup_col_index <= mem_col_index+1; ++sup_col_index)
-              {
-                if (sup_col_index >= mem_width)
-                  continue;
-
-                const std::size_t weight = static_cast<std::size_t> (score_sums[sup_row_index*mem_width + sup_col_index]);
-                average_col += sup_col_index * weight;
-                average_row += sup_row_index * weight;
-                sum += weight;
-              } 
+              is_local_max = false;
+              break;
             }
+          } 
+        }
 
-            average_col *= step_size;
-            average_row *= step_size;
+        if (!is_local_max)
+          continue;
+      }
 
-            average_col /= sum;
-            average_row /= sum;
+      LINEMODDetection detection;
 
-            //std::cerr << mem_col_index << ", " << mem_row_index << " - " << average_col << ", " << average_row << std::endl;
-            std::cerr << mem_col_index*step_size << ", " << mem_row_index*step_size << " - " << average_col << ", " << average_row << std::endl;
+      if (average_detections_)
+      {
+        std::size_t average_col = 0;
+        std::size_t average_row = 0;
+        std::size_t sum = 0;
 
-            const std::size_t detection_col_index = average_col;// * step_size;
-            const std::size_t detection_row_index = average_row;// * step_size;
+        for (std::size_t sup_row_index = mem_row_index-1; sup_row_index <= mem_row_index+1; ++sup_row_index)
+        {
+          if (sup_row_index >= mem_height)
+            continue;
 
-            detection.x = static_cast<int> (detection_col_index);
-            detection.y = static_cast<int> (detection_row_index);
-          }
-          else
+          for (std::size_t sup_col_index = mem_col_index-1; sup_col_index <= mem_col_index+1; ++sup_col_index)
           {
-            const std::size_t detection_col_index = mem_col_index * step_size;
-            const std::size_t detection_row_index = mem_row_index * step_size;
+            if (sup_col_index >= mem_width)
+              continue;
 
-            detection.x = static_cast<int> (detection_col_index);
-            detection.y = static_cast<int> (detection_row_index);
-          }
+            const std::size_t weight = static_cast<std::size_t> (score_sums[sup_row_index*mem_width + sup_col_index]);
+            average_col += sup_col_index * weight;
+            average_row += sup_row_index * weight;
+            sum += weight;
+          } 
+        }
 
-          detection.template_id = static_cast<int> (template_index);
-          detection.score = score;
-          detection.scale = scale;
+        average_col *= step_size;
+        average_row *= step_size;
 
-#ifdef LINEMOD_USE_SEPARATE_ENERGY_MAPS
-          std::cerr << "score: " << static_cast<float> (raw_score) * inv_max_score * 0.25f << ", " << (2.0f * static_cast<float> (raw_score) * inv_max_score - 1.0f) << std::endl;
-          std::cerr << "score0: " << static_cast<float> (score_sums[mem_index]) * inv_max_score << ", " << (2.0f * static_cast<float> (score_sums[mem_index]) * inv_max_score - 1.0f) << std::endl;
-          std::cerr << "score1: " << static_cast<float> (score_sums_1[mem_index]) * inv_max_score << ", " << (2.0f * static_cast<float> (score_sums_1[mem_index]) * inv_max_score - 1.0f) << std::endl;
-          std::cerr << "score2: " << static_cast<float> (score_sums_2[mem_index]) * inv_max_score << ", " << (2.0f * static_cast<float> (score_sums_2[mem_index]) * inv_max_score - 1.0f) << std::endl;
-          std::cerr << "score3: " << static_cast<float> (score_sums_3[mem_index]) * inv_max_score << ", " << (2.0f * static_cast<float> (score_sums_3[mem_index]) * inv_max_score - 1.0f) << std::endl;
-#endif
+        average_col /= sum;
+        average_row /= sum;
 
+        const std::size_t detection_col_index = average_col;// * step_size;
+        const std::size_t detection_row_index = average_row;// * step_size;
 
-          detections.push_back (detection);
-        }
+        detection.x = static_cast<int> (detection_col_index);
+        detection.y = static_cast<int> (detection_row_index);
       }
+      else
+      {
+        const std::size_t detection_col_index = mem_col_index * step_size;
+        const std::size_t detection_row_index = mem_row_index * step_size;
 
-#ifdef __SSE2__
-      aligned_free (score_sums);
-      aligned_free (tmp_score_sums);
-#else
-      delete[] score_sums;
-#endif
+        detection.x = static_cast<int> (detection_col_index);
+        detection.y = static_cast<int> (detection_row_index);
+      }
 
-#ifdef LINEMOD_USE_SEPARATE_ENERGY_MAPS
-      delete[] score_sums_1;
-      delete[] score_sums_2;
-      delete[] score_sums_3;
-#endif
-    }
-  }
+      detection.template_id = template_id;
+      detection.score = score;
+      detection.scale = scale;
 
-  // release data
-  for (std::size_t modality_index = 0; modality_index < modality_linearized_maps.size (); ++modality_index)
-  {
-    modality_energy_maps[modality_index].releaseAll ();
-#ifdef LINEMOD_USE_SEPARATE_ENERGY_MAPS
-    modality_energy_maps_1[modality_index].releaseAll ();
-    modality_energy_maps_2[modality_index].releaseAll ();
-    modality_energy_maps_3[modality_index].releaseAll ();
-#endif
-    for (auto &bin_index : modality_linearized_maps[modality_index])
-    {
-      bin_index.releaseAll ();
-#ifdef LINEMOD_USE_SEPARATE_ENERGY_MAPS
-      modality_linearized_maps_1[modality_index][bin_index].releaseAll ();
-      modality_linearized_maps_2[modality_index][bin_index].releaseAll ();
-      modality_linearized_maps_3[modality_index][bin_index].releaseAll ();
-#endif
+      detections.push_back (detection);
     }
   }
 }
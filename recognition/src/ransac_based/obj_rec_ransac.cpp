@@ -38,8 +38,11 @@
  */
 
 #include <pcl/common/random.h>
+#include <pcl/common/utils.h> // for getNumberOfThreads
 #include <pcl/recognition/ransac_based/obj_rec_ransac.h>
 
+#include <algorithm>
+
 using namespace pcl::common;
 
 pcl::recognition::ObjRecRANSAC::ObjRecRANSAC (float pair_width, float voxel_size)
@@ -58,7 +61,8 @@ pcl::recognition::ObjRecRANSAC::ObjRecRANSAC (float pair_width, float voxel_size
   frac_of_points_for_icp_refinement_ (0.3f),
   do_icp_hypotheses_refinement_ (true),
   model_library_ (pair_width, voxel_size, max_coplanarity_angle_),
-  rec_mode_ (ObjRecRANSAC::FULL_RECOGNITION)
+  rec_mode_ (ObjRecRANSAC::FULL_RECOGNITION),
+  threads_ (0)
 {
 }
 
@@ -110,7 +114,7 @@ pcl::recognition::ObjRecRANSAC::recognize (const PointCloudIn& scene, const Poin
     return;
 
   // Generate hypotheses from the sampled opps
-  std::list<HypothesisBase> pre_hypotheses;
+  std::vector<HypothesisBase> pre_hypotheses;
   int num_hypotheses = this->generateHypotheses (sampled_oriented_point_pairs_, pre_hypotheses);
 
   // Cluster the hypotheses
@@ -187,40 +191,56 @@ pcl::recognition::ObjRecRANSAC::sampleOrientedPointPairs (int num_iterations, co
   for ( int i = 0 ; i < num_full_leaves ; ++i )
     ids[i] = i;
 
-  // Sample 'num_iterations' number of oriented point pairs
+  num_iterations = std::min (num_iterations, num_full_leaves);
+
+  // Choose the first leaf of each pair without repetitions. The selected id is replaced by the last not yet selected
+  // one, such that no ids have to be shifted.
+  std::vector<ORROctree::Node*> first_leaves (num_iterations);
   for ( int i = 0 ; i < num_iterations ; ++i )
   {
-    // Choose a random position within the array of ids
-    randgen.setParameters (0, static_cast<int> (ids.size ()) - 1);
+    int last_pos = num_full_leaves - 1 - i;
+    randgen.setParameters (0, last_pos);
     int rand_pos = randgen.run ();
 
-    // Get the leaf at that random position
-    ORROctree::Node *leaf1 = full_scene_leaves[ids[rand_pos]];
+    first_leaves[i] = full_scene_leaves[ids[rand_pos]];
+    ids[rand_pos] = ids[last_pos];
+  }
 
-    // Delete the selected id
-    ids.erase (ids.begin() + rand_pos);
+  // Randomly select a second leaf at the right distance from each first one
+  std::vector<ORROctree::Node*> second_leaves (num_iterations, nullptr);
 
+#pragma omp parallel for \
+  default(none) \
+  shared(first_leaves, second_leaves, num_iterations) \
+  schedule(dynamic, 64) \
+  num_threads(pcl::utils::getNumberOfThreads (threads_))
+  for ( int i = 0 ; i < num_iterations ; ++i )
+  {
     // Get the leaf's point and normal
-    const float *p1 = leaf1->getData ()->getPoint ();
-    const float *n1 = leaf1->getData ()->getNormal ();
+    const float *p1 = first_leaves[i]->getData ()->getPoint ();
+    const float *n1 = first_leaves[i]->getData ()->getNormal ();
 
-    // Randomly select a leaf at the right distance from 'leaf1'
     ORROctree::Node *leaf2 = scene_octree_.getRandomFullLeafOnSphere (p1, pair_width_);
     if ( !leaf2 )
       continue;
 
-    // Get the leaf's point and normal
-    const float *p2 = leaf2->getData ()->getPoint ();
-    const float *n2 = leaf2->getData ()->getNormal ();
-
     if ( ignore_coplanar_opps_ )
     {
-      if ( aux::pointsAreCoplanar (p1, n1, p2, n2, max_coplanarity_angle_) )
+      if ( aux::pointsAreCoplanar (p1, n1, leaf2->getData ()->getPoint (), leaf2->getData ()->getNormal (), max_coplanarity_angle_) )
         continue;
     }
 
-    // Save the sampled point pair
-    output.emplace_back(p1, n1, p2, n2);
+    second_leaves[i] = leaf2;
+  }
+
+  // Save the sampled point pairs
+  for ( int i = 0 ; i < num_iterations ; ++i )
+  {
+    if ( !second_leaves[i] )
+      continue;
+
+    output.emplace_back(first_leaves[i]->getData ()->getPoint (), first_leaves[i]->getData ()->getNormal (),
+                        second_leaves[i]->getData ()->getPoint (), second_leaves[i]->getData ()->getNormal ());
 
 #ifdef OBJ_REC_RANSAC_VERBOSE
     ++num_of_opps;
@@ -235,58 +255,87 @@ pcl::recognition::ObjRecRANSAC::sampleOrientedPointPairs (int num_iterations, co
 //===============================================================================================================================================
 
 int
-pcl::recognition::ObjRecRANSAC::generateHypotheses (const std::list<OrientedPointPair>& pairs, std::list<HypothesisBase>& out) const
+pcl::recognition::ObjRecRANSAC::generateHypotheses (const std::list<OrientedPointPair>& pairs, std::vector<HypothesisBase>& out) const
 {
 #ifdef OBJ_REC_RANSAC_VERBOSE
   printf("ObjRecRANSAC::%s(): generating hypotheses ... ", __func__); fflush (stdout);
 #endif
 
-  // Only for 3D hash tables: this is the max number of neighbors a 3D hash table cell can have!
-  ModelLibrary::HashTableCell *neigh_cells[27];
-  float hash_table_key[3];
-  int num_hypotheses = 0;
-
+  std::vector<const OrientedPointPair*> pair_ptrs;
+  pair_ptrs.reserve (pairs.size ());
   for (const auto &pair : pairs)
+    pair_ptrs.push_back (&pair);
+
+  // The pairs are split in consecutive chunks whose hypotheses are concatenated in order at the end, such that the
+  // output does not depend on the number of threads
+  int num_pairs = static_cast<int> (pair_ptrs.size ());
+  int num_chunks = std::max (1, std::min (4*static_cast<int> (pcl::utils::getNumberOfThreads (threads_)), num_pairs));
+  std::vector<std::vector<HypothesisBase> > chunk_hypotheses (num_chunks);
+
+#pragma omp parallel for \
+  default(none) \
+  shared(pair_ptrs, num_pairs, num_chunks, chunk_hypotheses) \
+  schedule(dynamic) \
+  num_threads(pcl::utils::getNumberOfThreads (threads_))
+  for ( int chunk = 0 ; chunk < num_chunks ; ++chunk )
   {
-    // Just to make the code more readable
-    const float *scene_p1 = pair.p1_;
-    const float *scene_n1 = pair.n1_;
-    const float *scene_p2 = pair.p2_;
-    const float *scene_n2 = pair.n2_;
-
-    // Use normals and points to compute a hash table key
-    compute_oriented_point_pair_signature (scene_p1, scene_n1, scene_p2, scene_n2, hash_table_key);
-    // Get the cell and its neighbors based on 'key'
-    int num_neigh_cells = model_library_.getHashTable ().getNeighbors (hash_table_key, neigh_cells);
-
-    for ( int i = 0 ; i < num_neigh_cells ; ++i )
+    // Only for 3D hash tables: this is the max number of neighbors a 3D hash table cell can have!
+    ModelLibrary::HashTableCell *neigh_cells[27];
+    float hash_table_key[3];
+    std::vector<HypothesisBase>& chunk_out = chunk_hypotheses[chunk];
+
+    for ( int p = chunk*num_pairs/num_chunks ; p < (chunk + 1)*num_pairs/num_chunks ; ++p )
     {
-      // Check for all models in the current cell
-      for (const auto &cell : *neigh_cells[i])
+      // Just to make the code more readable
+      const float *scene_p1 = pair_ptrs[p]->p1_;
+      const float *scene_n1 = pair_ptrs[p]->n1_;
+      const float *scene_p2 = pair_ptrs[p]->p2_;
+      const float *scene_n2 = pair_ptrs[p]->n2_;
+
+      // Use normals and points to compute a hash table key
+      compute_oriented_point_pair_signature (scene_p1, scene_n1, scene_p2, scene_n2, hash_table_key);
+      // Get the cell and its neighbors based on 'key'
+      int num_neigh_cells = model_library_.getHashTable ().getNeighbors (hash_table_key, neigh_cells);
+
+      for ( int i = 0 ; i < num_neigh_cells ; ++i )
       {
-        // For better code readability
-        const ModelLibrary::Model *obj_model = cell.first;
-        const ModelLibrary::node_data_pair_list& model_pairs = cell.second;
-
-        // Check for all pairs which belong to the current model
-        for (const auto &model_pair : model_pairs)
+        // Check for all models in the current cell
+        for (const auto &cell : *neigh_cells[i])
         {
-          // Get the points and normals
-          const float *model_p1 = model_pair.first->getPoint ();
-          const float *model_n1 = model_pair.first->getNormal ();
-          const float *model_p2 = model_pair.second->getPoint ();
-          const float *model_n2 = model_pair.second->getNormal ();
-
-          HypothesisBase hypothesis(obj_model);
-          // Get the rigid transform from model to scene
-          this->computeRigidTransform(model_p1, model_n1, model_p2, model_n2, scene_p1, scene_n1, scene_p2, scene_n2, hypothesis.rigid_transform_);
-          // Save the current object hypothesis
-          out.push_back(hypothesis);
-          ++num_hypotheses;
+          // For better code readability
+          const ModelLibrary::Model *obj_model = cell.first;
+          const ModelLibrary::node_data_pair_list& model_pairs = cell.second;
+
+          // Check for all pairs which belong to the current model
+          for (const auto &model_pair : model_pairs)
+          {
+            // Get the points and normals
+            const float *model_p1 = model_pair.first->getPoint ();
+            const float *model_n1 = model_pair.first->getNormal ();
+            const float *model_p2 = model_pair.second->getPoint ();
+            const float *model_n2 = model_pair.second->getNormal ();
+
+            HypothesisBase hypothesis(obj_model);
+            // Get the rigid transform from model to scene
+            this->computeRigidTransform(model_p1, model_n1, model_p2, model_n2, scene_p1, scene_n1, scene_p2, scene_n2, hypothesis.rigid_transform_);
+            // Save the current object hypothesis
+            chunk_out.push_back(hypothesis);
+          }
         }
       }
     }
   }
+
+  std::size_t num_generated = 0;
+  for (const auto &hypotheses : chunk_hypotheses)
+    num_generated += hypotheses.size ();
+
+  out.reserve (out.size () + num_generated);
+  for (const auto &hypotheses : chunk_hypotheses)
+    out.insert (out.end (), hypotheses.begin (), hypotheses.end ());
+
+  int num_hypotheses = static_cast<int> (num_generated);
+
 #ifdef OBJ_REC_RANSAC_VERBOSE
   printf("%i hypotheses\n", num_hypotheses);
 #endif
@@ -297,7 +346,7 @@ pcl::recognition::ObjRecRANSAC::generateHypotheses (const std::list<OrientedPoin
 //===============================================================================================================================================
 
 int
-pcl::recognition::ObjRecRANSAC::groupHypotheses(std::list<HypothesisBase>& hypotheses, int num_hypotheses,
+pcl::recognition::ObjRecRANSAC::groupHypotheses(std::vector<HypothesisBase>& hypotheses, int num_hypotheses,
     RigidTransformSpace& transform_space, HypothesisOctree& grouped_hypotheses) const
 {
 #ifdef OBJ_REC_RANSAC_VERBOSE
@@ -315,35 +364,65 @@ pcl::recognition::ObjRecRANSAC::groupHypotheses(std::list<HypothesisBase>& hypot
   HypothesisCreator hypothesis_creator;
   grouped_hypotheses.build (b, position_discretization_, &hypothesis_creator);
 
-  // Build the rigid transform space
-  transform_space.build (b, position_discretization_, rotation_discretization_);
-  float transformed_point[3];
-
-  // Add all rigid transforms to the discrete rigid transform space
-  for (const auto &hypothesis : hypotheses)
+  // Consecutive parts of the hypotheses are added to separate rigid transform spaces in parallel. Merging them in
+  // order gives the same space as adding all rigid transforms to a single one.
+  int num_transforms = static_cast<int> (hypotheses.size ());
+  int num_spaces = std::max (1, std::min (static_cast<int> (pcl::utils::getNumberOfThreads (threads_)), num_transforms/1024));
+  std::vector<RigidTransformSpace> partial_spaces (num_spaces - 1);
+
+#pragma omp parallel for \
+  default(none) \
+  shared(b, hypotheses, transform_space, partial_spaces, num_spaces, num_transforms) \
+  schedule(static, 1) \
+  num_threads(num_spaces)
+  for ( int space_id = 0 ; space_id < num_spaces ; ++space_id )
   {
-    // Transform the center of mass of the model
-    aux::transform (hypothesis.rigid_transform_, hypothesis.obj_model_->getOctreeCenterOfMass (), transformed_point);
+    RigidTransformSpace& space = space_id == 0 ? transform_space : partial_spaces[space_id - 1];
+    float transformed_point[3];
+
+    // Build the rigid transform space
+    space.build (b, position_discretization_, rotation_discretization_);
+
+    // Add the rigid transforms to the discrete rigid transform space
+    for ( int i = space_id*num_transforms/num_spaces ; i < (space_id + 1)*num_transforms/num_spaces ; ++i )
+    {
+      const HypothesisBase& hypothesis = hypotheses[i];
 
-    // Now add the rigid transform at the right place
-    transform_space.addRigidTransform (hypothesis.obj_model_, transformed_point, hypothesis.rigid_transform_);
+      // Transform the center of mass of the model
+      aux::transform (hypothesis.rigid_transform_, hypothesis.obj_model_->getOctreeCenterOfMass (), transformed_point);
+
+      // Now add the rigid transform at the right place
+      space.addRigidTransform (hypothesis.obj_model_, transformed_point, hypothesis.rigid_transform_);
+    }
   }
 
-  std::list<RotationSpace*>& rotation_spaces = transform_space.getRotationSpaces ();
+  for (const auto &partial_space : partial_spaces)
+    transform_space.merge (partial_space);
+
+  const std::list<RotationSpace*>& rotation_space_list = transform_space.getRotationSpaces ();
+  std::vector<RotationSpace*> rotation_spaces (rotation_space_list.begin (), rotation_space_list.end ());
+  int num_rotation_spaces = static_cast<int> (rotation_spaces.size ());
+  std::vector<Hypothesis> best_hypotheses (num_rotation_spaces);
   int num_accepted = 0;
 
 #ifdef OBJ_REC_RANSAC_VERBOSE
   printf("ObjRecRANSAC::%s(): done\n  testing the cluster representatives ...\n", __func__); fflush (stdout);
+#endif
   // These are some variables needed when printing the recognition progress
   float progress_factor = 100.0f/static_cast<float> (transform_space.getNumberOfOccupiedRotationSpaces ());
   int num_done = 0;
-#endif
 
-  // Now take the best hypothesis from each rotation space
-  for (const auto &rotation_space : rotation_spaces)
+  // Now take the best hypothesis from each rotation space. The rotation spaces are tested independently.
+#pragma omp parallel for \
+  default(none) \
+  shared(rotation_spaces, num_rotation_spaces, best_hypotheses, progress_factor, num_done) \
+  schedule(dynamic) \
+  num_threads(pcl::utils::getNumberOfThreads (threads_))
+  for ( int r = 0 ; r < num_rotation_spaces ; ++r )
   {
+    const RotationSpace *rotation_space = rotation_spaces[r];
     const std::map<std::string, ModelLibrary::Model*>& models = model_library_.getModels ();
-    Hypothesis best_hypothesis;
+    Hypothesis& best_hypothesis = best_hypotheses[r];
     best_hypothesis.match_confidence_ = 0.0f;
 
     // For each model in the library
@@ -387,19 +466,26 @@ pcl::recognition::ObjRecRANSAC::groupHypotheses(std::list<HypothesisBase>& hypot
       }
     }
 
-    if ( best_hypothesis.match_confidence_ > 0.0f )
+#ifdef OBJ_REC_RANSAC_VERBOSE
+    // Update the progress
+#pragma omp critical
+    {
+      printf ("\r  %.1f%% ", (static_cast<float> (++num_done))*progress_factor); fflush (stdout);
+    }
+#endif
+  }
+
+  // Save the accepted hypotheses in the order of the rotation spaces
+  for ( int r = 0 ; r < num_rotation_spaces ; ++r )
+  {
+    if ( best_hypotheses[r].match_confidence_ > 0.0f )
     {
-      const float *c = rotation_space->getCenter ();
+      const float *c = rotation_spaces[r]->getCenter ();
       HypothesisOctree::Node* node = grouped_hypotheses.createLeaf (c[0], c[1], c[2]);
 
-      node->setData (best_hypothesis);
+      node->setData (best_hypotheses[r]);
       ++num_accepted;
     }
-
-#ifdef OBJ_REC_RANSAC_VERBOSE
-    // Update the progress
-    printf ("\r  %.1f%% ", (static_cast<float> (++num_done))*progress_factor); fflush (stdout);
-#endif
   }
 
 #ifdef OBJ_REC_RANSAC_VERBOSE
@@ -426,20 +512,28 @@ pcl::recognition::ObjRecRANSAC::buildGraphOfCloseHypotheses (HypothesisOctree& h
   for ( std::vector<HypothesisOctree::Node*>::iterator hypo = hypo_leaves.begin () ; hypo != hypo_leaves.end () ; ++hypo, ++i )
     (*hypo)->getData ().setLinearId (i);
 
-  i = 0;
+  int num_hypo_leaves = static_cast<int> (hypo_leaves.size ());
 
-  // Now create the graph connectivity such that each two neighboring rotation spaces are neighbors in the graph
-  for ( std::vector<HypothesisOctree::Node*>::const_iterator hypo = hypo_leaves.begin () ; hypo != hypo_leaves.end () ; ++hypo, ++i )
+  // Now create the graph connectivity such that each two neighboring rotation spaces are neighbors in the graph.
+  // Each iteration only touches the graph node with its own id.
+#pragma omp parallel for \
+  default(none) \
+  shared(graph, hypo_leaves, num_hypo_leaves) \
+  schedule(dynamic, 16) \
+  num_threads(pcl::utils::getNumberOfThreads (threads_))
+  for ( int j = 0 ; j < num_hypo_leaves ; ++j )
   {
+    const HypothesisOctree::Node *hypo = hypo_leaves[j];
+
     // Compute the fitness of the graph node
-    graph.getNodes ()[i]->setFitness (static_cast<int> ((*hypo)->getData ().explained_pixels_.size ()));
-    graph.getNodes ()[i]->setData ((*hypo)->getData ());
+    graph.getNodes ()[j]->setFitness (static_cast<int> (hypo->getData ().explained_pixels_.size ()));
+    graph.getNodes ()[j]->setData (hypo->getData ());
 
     // Get the neighbors of the current rotation space
-    const std::set<HypothesisOctree::Node*>& neighbors = (*hypo)->getNeighbors ();
+    const std::set<HypothesisOctree::Node*>& neighbors = hypo->getNeighbors ();
 
     for (const auto &neighbor : neighbors)
-      graph.insertDirectedEdge ((*hypo)->getData ().getLinearId (), neighbor->getData ().getLinearId ());
+      graph.insertDirectedEdge (hypo->getData ().getLinearId (), neighbor->getData ().getLinearId ());
   }
 
 #ifdef OBJ_REC_RANSAC_VERBOSE
@@ -499,15 +593,21 @@ pcl::recognition::ObjRecRANSAC::buildGraphOfConflictingHypotheses (const BVHH& b
     graph.getNodes ()[lin_id]->setData ((*obj)->getData ());
   }
 
-  using ordered_int_pair = std::pair<int,int>;
-  // This is one is to make sure that we do not compute the same set intersection twice
-  std::set<ordered_int_pair, bool(*)(const ordered_int_pair&, const ordered_int_pair&)> ordered_hypotheses_ids (aux::compareOrderedPairs<int>);
-
-  // Project the hypotheses onto the "range image" and store in each pixel the corresponding hypothesis id
-  for (const auto &bounded_object : *bounded_objects)
+  int num_objects = static_cast<int> (bounded_objects->size ());
+  // The ids of the hypotheses each hypothesis is in conflict with
+  std::vector<std::vector<int> > conflicts (num_objects);
+
+  // Box intersection is symmetric, so each pair of hypotheses is tested only once, by the one with the smaller id.
+  // This replaces the set of already tested pairs and lets the hypotheses be tested in parallel.
+#pragma omp parallel for \
+  default(none) \
+  shared(bvh, bounded_objects, num_objects, conflicts) \
+  schedule(dynamic) \
+  num_threads(pcl::utils::getNumberOfThreads (threads_))
+  for ( int obj = 0 ; obj < num_objects ; ++obj )
   {
     // For better code readability
-    Hypothesis *hypo1 = bounded_object->getData ();
+    const Hypothesis *hypo1 = (*bounded_objects)[obj]->getData ();
 
     // Get the bounds of the current hypothesis
     float bounds[6];
@@ -520,47 +620,43 @@ pcl::recognition::ObjRecRANSAC::buildGraphOfConflictingHypotheses (const BVHH& b
     for (const auto &intersected_object : intersected_objects)
     {
       // For better code readability
-      Hypothesis *hypo2 = intersected_object->getData ();
-
-      // Build an ordered int pair out of the hypotheses ids
-      std::pair<int,int> id_pair;
-      if ( hypo1->getLinearId () < hypo2->getLinearId () )
-      {
-        id_pair.first  = hypo1->getLinearId ();
-        id_pair.second = hypo2->getLinearId ();
-      }
-      else
-      {
-        id_pair.first  = hypo2->getLinearId ();
-        id_pair.second = hypo1->getLinearId ();
-      }
+      const Hypothesis *hypo2 = intersected_object->getData ();
 
-      // Make sure that we do not compute the same set intersection twice
-      std::pair<std::set<ordered_int_pair, bool(*)(const ordered_int_pair&, const ordered_int_pair&)>::iterator, bool> res = ordered_hypotheses_ids.insert (id_pair);
+      if ( hypo2->getLinearId () < hypo1->getLinearId () )
+        continue; // That pair is tested by 'hypo2'
 
-      if ( !res.second )
-        continue; // We've already computed that std::set intersection -> check the next pair
+      // Do the more involved intersection test based on the number of range image pixels explained by both hypotheses
+      std::size_t num_common = 0;
+      std::set<int>::const_iterator it1 = hypo1->explained_pixels_.begin (), it2 = hypo2->explained_pixels_.begin ();
 
-      // Do the more involved intersection test based on a set intersection of the range image pixels which explained by the hypotheses
-      std::set<int> id_intersection;
-
-      // Compute the ids intersection of 'obj' and 'it'
-      std::set_intersection (hypo1->explained_pixels_.begin (),
-                             hypo1->explained_pixels_.end (),
-                             hypo2->explained_pixels_.begin (),
-                             hypo2->explained_pixels_.end (),
-                             std::inserter (id_intersection, id_intersection.begin ()));
+      while ( it1 != hypo1->explained_pixels_.end () && it2 != hypo2->explained_pixels_.end () )
+      {
+        if ( *it1 < *it2 )
+          ++it1;
+        else if ( *it2 < *it1 )
+          ++it2;
+        else
+        {
+          ++num_common;
+          ++it1;
+          ++it2;
+        }
+      }
 
       // Compute the intersection fractions
-      float frac_1 = static_cast<float> (id_intersection.size ())/static_cast <float> (hypo1->explained_pixels_.size ());
-      float frac_2 = static_cast<float> (id_intersection.size ())/static_cast <float> (hypo2->explained_pixels_.size ());
+      float frac_1 = static_cast<float> (num_common)/static_cast <float> (hypo1->explained_pixels_.size ());
+      float frac_2 = static_cast<float> (num_common)/static_cast <float> (hypo2->explained_pixels_.size ());
 
       // Check if the intersection set is large enough, i.e., if there is a conflict
       if ( frac_1 > intersection_fraction_ || frac_2 > intersection_fraction_ )
-        graph.insertUndirectedEdge (hypo1->getLinearId (), hypo2->getLinearId ());
+        conflicts[obj].push_back (hypo2->getLinearId ());
     }
   }
 
+  for ( int obj = 0 ; obj < num_objects ; ++obj )
+    for (const int &id : conflicts[obj])
+      graph.insertUndirectedEdge (obj, id);
+
 #ifdef OBJ_REC_RANSAC_VERBOSE
 	printf("done\n");
 #endif
@@ -100,6 +100,7 @@ namespace pcl
           , source_cloud_updated_ (true)
           , force_no_recompute_ (false)
           , force_no_recompute_reciprocal_ (false)
+          , threads_ (1)
         {
         }
       
@@ -277,6 +278,12 @@ namespace pcl
           point_representation_ = point_representation;
         }
 
+        /** \brief Initialize the scheduler and set the number of threads used to search the correspondences.
+          * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+          */
+        void
+        setNumberOfThreads (unsigned int nr_threads = 0);
+
         /** \brief Clone and cast to CorrespondenceEstimationBase */
         virtual typename CorrespondenceEstimationBase<PointSource, PointTarget, Scalar>::Ptr clone () const = 0;
 
@@ -335,6 +342,9 @@ namespace pcl
          * will never be recomputed*/
         bool force_no_recompute_reciprocal_;
 
+        /** \brief The number of threads the scheduler should use. */
+        unsigned int threads_;
+
      };
 
     /** \brief @b CorrespondenceEstimation represents the base class for
@@ -378,6 +388,7 @@ namespace pcl
         using CorrespondenceEstimationBase<PointSource, PointTarget, Scalar>::input_;
         using CorrespondenceEstimationBase<PointSource, PointTarget, Scalar>::indices_;
         using CorrespondenceEstimationBase<PointSource, PointTarget, Scalar>::input_fields_;
+        using CorrespondenceEstimationBase<PointSource, PointTarget, Scalar>::threads_;
         using PCLBase<PointSource>::deinitCompute;
 
         using KdTree = pcl::search::KdTree<PointTarget>;
@@ -403,6 +414,8 @@ namespace pcl
         ~CorrespondenceEstimation () {}
 
         /** \brief Determine the correspondences between input and target cloud.
+          * The source points are searched in parallel when \ref setNumberOfThreads is given more than one thread,
+          * the correspondences are in the order of the source indices in any case.
           * \param[out] correspondences the found correspondences (index of query point, index of target point, distance)
           * \param[in] max_distance maximum allowed distance between correspondences
           */
@@ -429,6 +442,15 @@ namespace pcl
           Ptr copy (new CorrespondenceEstimation<PointSource, PointTarget, Scalar> (*this));
           return (copy);
         }
+
+      protected:
+        /** \brief Concatenate the correspondences found by the threads, in the order of the threads.
+          * \param[in,out] chunk_correspondences the correspondences of every range of source indices
+          * \param[out] correspondences the concatenated correspondences
+          */
+        void
+        mergeCorrespondences (std::vector<pcl::Correspondences> &chunk_correspondences,
+                              pcl::Correspondences &correspondences) const;
      };
   }
 }
@@ -74,6 +74,7 @@ namespace pcl
         CorrespondenceRejectorMedianDistance () 
           : median_distance_ (0)
           , factor_ (1.0)
+          , threads_ (1)
         {
           rejection_name_ = "CorrespondenceRejectorMedianDistance";
         }
@@ -171,6 +172,13 @@ namespace pcl
             (data_container_)->setSearchMethodTarget (tree, force_no_recompute );
         }
 
+        /** \brief Initialize the scheduler and set the number of threads to use for the distances of the
+          * correspondences.
+          * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+          */
+        void
+        setNumberOfThreads (unsigned int nr_threads = 0);
+
         /** \brief Set the factor for correspondence rejection. Points with distance greater than median times factor
          *  will be rejected
          *  \param[in] factor value
@@ -202,6 +210,9 @@ namespace pcl
          */
         double factor_;
 
+        /** \brief The number of threads the scheduler should use. */
+        unsigned int threads_;
+
         using DataContainerPtr = DataContainerInterface::Ptr;
 
         /** \brief A pointer to the DataContainer object containing the input and target point clouds */
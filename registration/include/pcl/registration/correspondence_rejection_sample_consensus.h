@@ -81,6 +81,7 @@ namespace pcl
           , target_ ()
           , refine_ (false)
           , save_inliers_ (false)
+          , threads_ (1)
         {
           rejection_name_ = "CorrespondenceRejectorSampleConsensus";
         }
@@ -211,6 +212,13 @@ namespace pcl
         inline bool
         getSaveInliers () { return save_inliers_; }
 
+        /** \brief Set the number of threads of the RandomSampleConsensus, which draws and scores the samples in
+          * parallel when more than one thread is used.
+          * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+          */
+        void
+        setNumberOfThreads (unsigned int nr_threads = 0);
+
 
       protected:
 
@@ -237,6 +245,9 @@ namespace pcl
         std::vector<int> inlier_indices_;
         bool save_inliers_;
 
+        /** \brief The number of threads the scheduler should use. */
+        unsigned int threads_;
+
       public:
         PCL_MAKE_ALIGNED_OPERATOR_NEW
     };
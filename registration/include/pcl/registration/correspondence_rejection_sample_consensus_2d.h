@@ -68,6 +68,7 @@ namespace pcl
         using CorrespondenceRejectorSampleConsensus<PointT>::inlier_threshold_;
         using CorrespondenceRejectorSampleConsensus<PointT>::max_iterations_;
         using CorrespondenceRejectorSampleConsensus<PointT>::best_transformation_;
+        using CorrespondenceRejectorSampleConsensus<PointT>::threads_;
 
         using Ptr = shared_ptr<CorrespondenceRejectorSampleConsensus2D<PointT> >;
         using ConstPtr = shared_ptr<const CorrespondenceRejectorSampleConsensus2D<PointT> >;
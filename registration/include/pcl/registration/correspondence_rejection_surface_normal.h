@@ -72,6 +72,7 @@ namespace pcl
         /** \brief Empty constructor. Sets the threshold to 1.0. */
         CorrespondenceRejectorSurfaceNormal () 
           : threshold_ (1.0)
+          , threads_ (1)
         {
           rejection_name_ = "CorrespondenceRejectorSurfaceNormal";
         }
@@ -94,6 +95,13 @@ namespace pcl
         inline double
         getThreshold () const { return threshold_; };
 
+        /** \brief Initialize the scheduler and set the number of threads to use for the tests of the
+          * correspondences.
+          * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+          */
+        void
+        setNumberOfThreads (unsigned int nr_threads = 0);
+
         /** \brief Initialize the data container object for the point type and the normal type. */
         template <typename PointT, typename NormalT> inline void 
         initializeDataContainer ()
@@ -315,6 +323,9 @@ namespace pcl
         /** \brief The median distance threshold between two correspondent points in source <-> target. */
         double threshold_;
 
+        /** \brief The number of threads the scheduler should use. */
+        unsigned int threads_;
+
         using DataContainerPtr = DataContainerInterface::Ptr;
         /** \brief A pointer to the DataContainer object containing the input and target point clouds */
         DataContainerPtr data_container_;
@@ -96,7 +96,8 @@ namespace pcl
           loop_end_ (0), 
           reg_ (new pcl::IterativeClosestPoint<PointT, PointT>), 
           compute_loop_ (true),
-          vd_ ()
+          vd_ (),
+          threads_ (1)
         {};
       
         /** \brief Empty destructor */
@@ -171,6 +172,8 @@ namespace pcl
         }
 
         /** \brief Setter for the registration algorithm.
+         * \details Only the input source and target of the registration are set by compute (), its other settings are
+         * kept, so that a configured registration (e.g. a multithreaded one) can be shared between several instances.
          * \param[in] reg the registration algorithm used to compute the transformation between the start and the end of the loop
          */
         inline void
@@ -203,6 +206,12 @@ namespace pcl
         void
         compute ();
 
+        /** \brief Set the number of threads running the loop optimization and transforming the point clouds.
+          * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+          */
+        void
+        setNumberOfThreads (unsigned int nr_threads = 0);
+
       protected:
         using PCLBase<PointT>::deinitCompute;
 
@@ -246,6 +255,9 @@ namespace pcl
         /** \brief previously added node in the loop_graph_. */
         typename boost::graph_traits<LoopGraph>::vertex_descriptor vd_;
 
+        /** \brief The number of threads the scheduler should use. */
+        unsigned int threads_;
+
       public:
         PCL_MAKE_ALIGNED_OPERATOR_NEW
     };
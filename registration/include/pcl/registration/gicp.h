@@ -111,6 +111,7 @@ namespace pcl
         , max_inner_iterations_(20)
         ,translation_gradient_tolerance_(1e-2)
         ,rotation_gradient_tolerance_(1e-2) 
+        ,threads_(1)
       {
         min_number_correspondences_ = 4;
         reg_name_ = "GeneralizedIterativeClosestPoint";
@@ -274,6 +275,27 @@ namespace pcl
       double
       getRotationGradientTolerance () const { return rotation_gradient_tolerance_; }
 
+      /** \brief Initialize the scheduler and set the number of threads used to compute the covariances, to search the
+        * correspondences and to evaluate the objective and its gradient. The sums of the objective are split between
+        * the threads, so the results can slightly differ with the number of threads.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      void
+      setNumberOfThreads (unsigned int nr_threads = 0);
+
+      /** \brief compute points covariances matrices according to the K nearest
+        * neighbors. K is set via setCorrespondenceRandomness() method.
+        * \param cloud pointer to point cloud
+        * \param tree KD tree performer for nearest neighbors search
+        * \param[out] cloud_covariances covariances matrices for each point in the cloud
+        * \note The covariances of a target can be computed once with this method and given to several registrations
+        * with \ref setTargetCovariances, see \ref pcl::registration::PreparedTarget.
+        */
+      template<typename PointT>
+      void computeCovariances(typename pcl::PointCloud<PointT>::ConstPtr cloud,
+                              const typename pcl::search::KdTree<PointT>::Ptr tree,
+                              MatricesVector& cloud_covariances) const;
+
     protected:
 
       /** \brief The number of neighbors used for covariances computation.
@@ -326,16 +348,8 @@ namespace pcl
 	  /** \brief minimal rotation gradient for early optimization stop */
 	  double rotation_gradient_tolerance_;
 
-      /** \brief compute points covariances matrices according to the K nearest
-        * neighbors. K is set via setCorrespondenceRandomness() method.
-        * \param cloud pointer to point cloud
-        * \param tree KD tree performer for nearest neighbors search
-        * \param[out] cloud_covariances covariances matrices for each point in the cloud
-        */
-      template<typename PointT>
-      void computeCovariances(typename pcl::PointCloud<PointT>::ConstPtr cloud,
-                              const typename pcl::search::KdTree<PointT>::Ptr tree,
-                              MatricesVector& cloud_covariances);
+      /** \brief The number of threads the scheduler should use. */
+      unsigned int threads_;
 
       /** \return trace of mat1^t . mat2
         * \param mat1 matrix of dimension nxm
@@ -377,6 +391,33 @@ namespace pcl
       /// \brief compute transformation matrix from transformation matrix
       void applyState(Eigen::Matrix4f &t, const Vector6d& x) const;
 
+      /** \brief Find the correspondences of the source points transformed by transformation_ and compute their
+        * Mahalanobis matrices.
+        * \param[in] output the source points transformed by the guess
+        * \param[in] R the rotation of the current transformation and of the guess
+        * \param[out] source_indices the indices of the source points which have a correspondence
+        * \param[out] target_indices the indices of their correspondences in \ref getCorrespondenceTarget
+        * \return false if a source point has no nearest neighbor
+        */
+      virtual bool
+      findCorrespondences (const PointCloudSource &output, const Eigen::Matrix3d &R,
+                           std::vector<int> &source_indices, std::vector<int> &target_indices);
+
+      /** \brief The cloud whose points are the correspondences of the source points, the target by default. */
+      virtual const PointCloudTarget &
+      getCorrespondenceTarget () const
+      {
+        return (*target_);
+      }
+
+      /** \brief Compute the objective, and its gradient if \a g is given, for the current correspondences.
+        * \param[in] x the state of the transformation
+        * \param[out] f the objective
+        * \param[out] g the gradient of the objective, not computed if null
+        */
+      void
+      computeObjective (const Vector6d &x, double &f, Vector6d *g) const;
+
       /// \brief optimization functor structure
       struct OptimizationFunctorWithIndices : public BFGSDummyFunctor<double,6>
       {
@@ -38,9 +38,12 @@
 #pragma once
 
 #include <pcl/common/common.h>
+#include <pcl/point_cloud_soa.h>
 #include <pcl/registration/registration.h>
 #include <pcl/registration/matching_candidate.h>
 
+#include <random>
+
 namespace pcl
 {
   /** \brief Compute the mean point density of a given point cloud.
@@ -175,6 +178,25 @@ namespace pcl
       };
 
 
+      /** \brief Set the seed of the random generators (the current time by default).
+        * Each iteration draws its bases with a generator seeded from the seed and the iteration, so that without
+        * a maximum computation time the same seed gives the same result with any number of threads.
+        * \param[in] seed the seed
+        */
+      inline void
+      setSeed (unsigned int seed)
+      {
+        seed_ = seed;
+      };
+
+      /** \return the seed of the random generators. */
+      inline unsigned int
+      getSeed () const
+      {
+        return (seed_);
+      };
+
+
       /** \brief Set the constant factor delta which weights the internally calculated parameters.
         * \param[in] delta the weight factor delta
         * \param[in] normalize flag if delta should be normalized according to point cloud density
@@ -263,6 +285,8 @@ namespace pcl
 
 
       /** \brief Set the maximum computation time in seconds.
+        * \note The iterations run before the time is up depend on the speed of the machine and on the number of
+        * threads, so the result is only reproducible without a maximum computation time.
         * \param[in] max_runtime the maximum runtime of the method in seconds
         */
       inline void
@@ -337,6 +361,16 @@ namespace pcl
       int
       selectBaseTriangle (std::vector <int> &base_indices);
 
+      /** \return the random generator of the calling thread. */
+      std::mt19937 &
+      getRandomGenerator ();
+
+      /** \brief Choose a random index between 0 and n-1 with the random generator of the calling thread.
+        * \param[in] n the number of possible indices to choose from
+        */
+      int
+      getRandomIndex (int n);
+
       /** \brief Setup the base (four coplanar points) by ordering the points and computing intersection
         * ratios and segment to segment distances of base diagonal.
         *
@@ -355,6 +389,9 @@ namespace pcl
       segmentToSegmentDist (const std::vector <int> &base_indices, float (&ratio)[2]);
 
       /** \brief Search for corresponding point pairs given the distance between two base points.
+        *
+        * The squared distances between the sampled source points are computed in blocks over \ref source_points_,
+        * and only the pairs within the distance bounds are checked point by point.
         *
         * \param[in] idx1 first index of current base segment (in source cloud)
         * \param[in] idx2 second index of current base segment (in source cloud)
@@ -503,6 +540,12 @@ namespace pcl
       /** \brief Maximum allowed computation time in seconds (standard = 0 => ~unlimited). */
       int max_runtime_;
 
+      /** \brief Seed of the random generators (standard = current time). */
+      unsigned int seed_;
+
+      /** \brief One random generator per thread, reseeded by each iteration. */
+      std::vector <std::mt19937> rngs_;
+
 
       /** \brief Resulting fitness score of the best match. */
       float fitness_score_;
@@ -528,6 +571,9 @@ namespace pcl
       /** \brief A pointer to the vector of source point indices to use after sampling. */
       pcl::IndicesPtr source_indices_;
 
+      /** \brief The coordinates of the source points to use after sampling, in the order of source_indices_. */
+      pcl::PointCloudSoA source_points_;
+
       /** \brief A pointer to the vector of target point indices to use after sampling. */
       pcl::IndicesPtr target_indices_;
 
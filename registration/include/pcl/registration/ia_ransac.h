@@ -55,6 +55,8 @@ namespace pcl
   class SampleConsensusInitialAlignment : public Registration<PointSource, PointTarget>
   {
     public:
+      using Matrix4 = typename Registration<PointSource, PointTarget>::Matrix4;
+
       using Registration<PointSource, PointTarget>::reg_name_;
       using Registration<PointSource, PointTarget>::input_;
       using Registration<PointSource, PointTarget>::indices_;
@@ -138,7 +140,8 @@ namespace pcl
         input_features_ (), target_features_ (), 
         nr_samples_(3), min_sample_distance_ (0.0f), k_correspondences_ (10), 
         feature_tree_ (new pcl::KdTreeFLANN<FeatureT>),
-        error_functor_ ()
+        error_functor_ (),
+        threads_ (1)
       {
         reg_name_ = "SampleConsensusInitialAlignment";
         max_iterations_ = 1000;
@@ -212,6 +215,14 @@ namespace pcl
       ErrorFunctorPtr
       getErrorFunction () { return (error_functor_); }
 
+      /** \brief Initialize the scheduler and set the number of threads used to generate and evaluate the pose
+        * hypotheses. The samples are drawn one thread at a time, and the evaluation of a hypothesis stops as soon as
+        * its error exceeds the lowest error found by any thread.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      void
+      setNumberOfThreads (unsigned int nr_threads = 0);
+
     protected:
       /** \brief Choose a random index between 0 and n-1
         * \param n the number of possible indices to choose from
@@ -248,6 +259,16 @@ namespace pcl
       float 
       computeErrorMetric (const PointCloudSource &cloud, float threshold);
 
+      /** \brief An error metric for that computes the quality of the alignment between the given cloud and the target,
+        * which stops as soon as the error exceeds \a max_error.
+        * \param cloud the input cloud
+        * \param threshold distances greater than this value are capped
+        * \param max_error the error above which the alignment is rejected
+        * \return the error, or a partial error greater than \a max_error
+        */
+      float
+      computeErrorMetric (const PointCloudSource &cloud, float threshold, float max_error) const;
+
       /** \brief Rigid transformation computation method.
         * \param output the transformed input point cloud dataset using the rigid transformation found
         * \param guess The computed transforamtion
@@ -274,6 +295,9 @@ namespace pcl
       FeatureKdTreePtr feature_tree_;               
 
       ErrorFunctorPtr error_functor_;
+
+      /** \brief The number of threads the scheduler should use. */
+      unsigned int threads_;
     public:
       PCL_MAKE_ALIGNED_OPERATOR_NEW
   };
@@ -44,6 +44,12 @@
 #include <pcl/common/io.h>
 #include <pcl/common/copy_point.h>
 
+#include <algorithm>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 
 namespace pcl
 {
@@ -70,6 +76,20 @@ CorrespondenceEstimationBase<PointSource, PointTarget, Scalar>::setInputTarget (
 }
 
 
+template <typename PointSource, typename PointTarget, typename Scalar> void
+CorrespondenceEstimationBase<PointSource, PointTarget, Scalar>::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs ();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
+
+
 template <typename PointSource, typename PointTarget, typename Scalar> bool
 CorrespondenceEstimationBase<PointSource, PointTarget, Scalar>::initCompute ()
 {
@@ -125,51 +145,61 @@ CorrespondenceEstimation<PointSource, PointTarget, Scalar>::determineCorresponde
 
   double max_dist_sqr = max_distance * max_distance;
 
-  correspondences.resize (indices_->size ());
+  // Every thread searches a contiguous range of the source indices into its own buffer, the buffers are then
+  // concatenated in the order of the indices
+  const std::size_t nr_indices = indices_->size ();
+  std::size_t nr_chunks = std::max<std::size_t> (1, std::min<std::size_t> (threads_, nr_indices));
+  std::vector<pcl::Correspondences> chunk_correspondences (nr_chunks);
+
+#pragma omp parallel for \
+  default(none) \
+  shared(chunk_correspondences, max_dist_sqr, nr_chunks, nr_indices) \
+  num_threads(threads_)
+  for (std::ptrdiff_t chunk = 0; chunk < static_cast<std::ptrdiff_t> (nr_chunks); ++chunk)
+  {
+    const std::size_t begin = nr_indices * chunk / nr_chunks;
+    const std::size_t end = nr_indices * (chunk + 1) / nr_chunks;
+    pcl::Correspondences &chunk_corr = chunk_correspondences[chunk];
+    chunk_corr.reserve (end - begin);
 
-  std::vector<int> index (1);
-  std::vector<float> distance (1);
-  pcl::Correspondence corr;
-  unsigned int nr_valid_correspondences = 0;
+    std::vector<int> index (1);
+    std::vector<float> distance (1);
 
-  // Check if the template types are the same. If true, avoid a copy.
-  // Both point types MUST be registered using the POINT_CLOUD_REGISTER_POINT_STRUCT macro!
-  if (isSamePointType<PointSource, PointTarget> ())
-  {
-    // Iterate over the input set of source indices
-    for (std::vector<int>::const_iterator idx = indices_->begin (); idx != indices_->end (); ++idx)
+    // Check if the template types are the same. If true, avoid a copy.
+    // Both point types MUST be registered using the POINT_CLOUD_REGISTER_POINT_STRUCT macro!
+    if (isSamePointType<PointSource, PointTarget> ())
     {
-      tree_->nearestKSearch ((*input_)[*idx], 1, index, distance);
-      if (distance[0] > max_dist_sqr)
-        continue;
-
-      corr.index_query = *idx;
-      corr.index_match = index[0];
-      corr.distance = distance[0];
-      correspondences[nr_valid_correspondences++] = corr;
+      // Iterate over the input set of source indices
+      for (std::size_t i = begin; i < end; ++i)
+      {
+        const int idx = (*indices_)[i];
+        tree_->nearestKSearch ((*input_)[idx], 1, index, distance);
+        if (distance[0] > max_dist_sqr)
+          continue;
+
+        chunk_corr.emplace_back (idx, index[0], distance[0]);
+      }
     }
-  }
-  else
-  {
-    PointTarget pt;
-
-    // Iterate over the input set of source indices
-    for (std::vector<int>::const_iterator idx = indices_->begin (); idx != indices_->end (); ++idx)
+    else
     {
-      // Copy the source data to a target PointTarget format so we can search in the tree
-      copyPoint ((*input_)[*idx], pt);
+      PointTarget pt;
+
+      // Iterate over the input set of source indices
+      for (std::size_t i = begin; i < end; ++i)
+      {
+        const int idx = (*indices_)[i];
+        // Copy the source data to a target PointTarget format so we can search in the tree
+        copyPoint ((*input_)[idx], pt);
 
-      tree_->nearestKSearch (pt, 1, index, distance);
-      if (distance[0] > max_dist_sqr)
-        continue;
+        tree_->nearestKSearch (pt, 1, index, distance);
+        if (distance[0] > max_dist_sqr)
+          continue;
 
-      corr.index_query = *idx;
-      corr.index_match = index[0];
-      corr.distance = distance[0];
-      correspondences[nr_valid_correspondences++] = corr;
+        chunk_corr.emplace_back (idx, index[0], distance[0]);
+      }
     }
   }
-  correspondences.resize (nr_valid_correspondences);
+  mergeCorrespondences (chunk_correspondences, correspondences);
   deinitCompute ();
 }
 
@@ -187,72 +217,101 @@ CorrespondenceEstimation<PointSource, PointTarget, Scalar>::determineReciprocalC
     return;
   double max_dist_sqr = max_distance * max_distance;
 
-  correspondences.resize (indices_->size());
-  std::vector<int> index (1);
-  std::vector<float> distance (1);
-  std::vector<int> index_reciprocal (1);
-  std::vector<float> distance_reciprocal (1);
-  pcl::Correspondence corr;
-  unsigned int nr_valid_correspondences = 0;
-  int target_idx = 0;
-
-  // Check if the template types are the same. If true, avoid a copy.
-  // Both point types MUST be registered using the POINT_CLOUD_REGISTER_POINT_STRUCT macro!
-  if (isSamePointType<PointSource, PointTarget> ())
+  const std::size_t nr_indices = indices_->size ();
+  std::size_t nr_chunks = std::max<std::size_t> (1, std::min<std::size_t> (threads_, nr_indices));
+  std::vector<pcl::Correspondences> chunk_correspondences (nr_chunks);
+
+#pragma omp parallel for \
+  default(none) \
+  shared(chunk_correspondences, max_dist_sqr, nr_chunks, nr_indices) \
+  num_threads(threads_)
+  for (std::ptrdiff_t chunk = 0; chunk < static_cast<std::ptrdiff_t> (nr_chunks); ++chunk)
   {
-    // Iterate over the input set of source indices
-    for (std::vector<int>::const_iterator idx = indices_->begin (); idx != indices_->end (); ++idx)
+    const std::size_t begin = nr_indices * chunk / nr_chunks;
+    const std::size_t end = nr_indices * (chunk + 1) / nr_chunks;
+    pcl::Correspondences &chunk_corr = chunk_correspondences[chunk];
+    chunk_corr.reserve (end - begin);
+
+    std::vector<int> index (1);
+    std::vector<float> distance (1);
+    std::vector<int> index_reciprocal (1);
+    std::vector<float> distance_reciprocal (1);
+    int target_idx = 0;
+
+    // Check if the template types are the same. If true, avoid a copy.
+    // Both point types MUST be registered using the POINT_CLOUD_REGISTER_POINT_STRUCT macro!
+    if (isSamePointType<PointSource, PointTarget> ())
     {
-      tree_->nearestKSearch ((*input_)[*idx], 1, index, distance);
-      if (distance[0] > max_dist_sqr)
-        continue;
-
-      target_idx = index[0];
-
-      tree_reciprocal_->nearestKSearch ((*target_)[target_idx], 1, index_reciprocal, distance_reciprocal);
-      if (distance_reciprocal[0] > max_dist_sqr || *idx != index_reciprocal[0])
-        continue;
-
-      corr.index_query = *idx;
-      corr.index_match = index[0];
-      corr.distance = distance[0];
-      correspondences[nr_valid_correspondences++] = corr;
+      // Iterate over the input set of source indices
+      for (std::size_t i = begin; i < end; ++i)
+      {
+        const int idx = (*indices_)[i];
+        tree_->nearestKSearch ((*input_)[idx], 1, index, distance);
+        if (distance[0] > max_dist_sqr)
+          continue;
+
+        target_idx = index[0];
+
+        tree_reciprocal_->nearestKSearch ((*target_)[target_idx], 1, index_reciprocal, distance_reciprocal);
+        if (distance_reciprocal[0] > max_dist_sqr || idx != index_reciprocal[0])
+          continue;
+
+        chunk_corr.emplace_back (idx, index[0], distance[0]);
+      }
     }
-  }
-  else
-  {
-    PointTarget pt_src;
-    PointSource pt_tgt;
-
-    // Iterate over the input set of source indices
-    for (std::vector<int>::const_iterator idx = indices_->begin (); idx != indices_->end (); ++idx)
+    else
     {
-      // Copy the source data to a target PointTarget format so we can search in the tree
-      copyPoint ((*input_)[*idx], pt_src);
+      PointTarget pt_src;
+      PointSource pt_tgt;
 
-      tree_->nearestKSearch (pt_src, 1, index, distance);
-      if (distance[0] > max_dist_sqr)
-        continue;
+      // Iterate over the input set of source indices
+      for (std::size_t i = begin; i < end; ++i)
+      {
+        const int idx = (*indices_)[i];
+        // Copy the source data to a target PointTarget format so we can search in the tree
+        copyPoint ((*input_)[idx], pt_src);
 
-      target_idx = index[0];
+        tree_->nearestKSearch (pt_src, 1, index, distance);
+        if (distance[0] > max_dist_sqr)
+          continue;
 
-      // Copy the target data to a target PointSource format so we can search in the tree_reciprocal
-      copyPoint ((*target_)[target_idx], pt_tgt);
+        target_idx = index[0];
 
-      tree_reciprocal_->nearestKSearch (pt_tgt, 1, index_reciprocal, distance_reciprocal);
-      if (distance_reciprocal[0] > max_dist_sqr || *idx != index_reciprocal[0])
-        continue;
+        // Copy the target data to a target PointSource format so we can search in the tree_reciprocal
+        copyPoint ((*target_)[target_idx], pt_tgt);
 
-      corr.index_query = *idx;
-      corr.index_match = index[0];
-      corr.distance = distance[0];
-      correspondences[nr_valid_correspondences++] = corr;
+        tree_reciprocal_->nearestKSearch (pt_tgt, 1, index_reciprocal, distance_reciprocal);
+        if (distance_reciprocal[0] > max_dist_sqr || idx != index_reciprocal[0])
+          continue;
+
+        chunk_corr.emplace_back (idx, index[0], distance[0]);
+      }
     }
   }
-  correspondences.resize (nr_valid_correspondences);
+  mergeCorrespondences (chunk_correspondences, correspondences);
   deinitCompute ();
 }
 
+
+template <typename PointSource, typename PointTarget, typename Scalar> void
+CorrespondenceEstimation<PointSource, PointTarget, Scalar>::mergeCorrespondences (
+    std::vector<pcl::Correspondences> &chunk_correspondences, pcl::Correspondences &correspondences) const
+{
+  if (chunk_correspondences.size () == 1)
+  {
+    correspondences.swap (chunk_correspondences[0]);
+    return;
+  }
+
+  std::size_t nr_correspondences = 0;
+  for (const auto &chunk_corr : chunk_correspondences)
+    nr_correspondences += chunk_corr.size ();
+  correspondences.clear ();
+  correspondences.reserve (nr_correspondences);
+  for (const auto &chunk_corr : chunk_correspondences)
+    correspondences.insert (correspondences.end (), chunk_corr.begin (), chunk_corr.end ());
+}
+
 } // namespace registration
 } // namespace pcl
 
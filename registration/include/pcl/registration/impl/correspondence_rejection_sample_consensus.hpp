@@ -41,10 +41,13 @@
 #ifndef PCL_REGISTRATION_IMPL_CORRESPONDENCE_REJECTION_SAMPLE_CONSENSUS_HPP_
 #define PCL_REGISTRATION_IMPL_CORRESPONDENCE_REJECTION_SAMPLE_CONSENSUS_HPP_
 
-#include <unordered_map>
 #include <pcl/sample_consensus/ransac.h>
 #include <pcl/sample_consensus/sac_model_registration.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 
 namespace pcl
 {
@@ -52,6 +55,20 @@ namespace pcl
 namespace registration
 {
 
+template <typename PointT> void
+CorrespondenceRejectorSampleConsensus<PointT>::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs ();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
+
+
 template <typename PointT> void
 CorrespondenceRejectorSampleConsensus<PointT>::getRemainingCorrespondences (
     const pcl::Correspondences& original_correspondences,
@@ -94,6 +111,8 @@ CorrespondenceRejectorSampleConsensus<PointT>::getRemainingCorrespondences (
      // Create a RANSAC model
      pcl::RandomSampleConsensus<PointT> sac (model, inlier_threshold_);
      sac.setMaxIterations (max_iterations_);
+     // A negative number of threads keeps the serial RANSAC
+     sac.setNumberOfThreads (threads_ > 1 ? static_cast<int> (threads_) : -1);
 
      // Compute the set of inliers
      if (!sac.computeModel ())
@@ -117,7 +136,8 @@ CorrespondenceRejectorSampleConsensus<PointT>::getRemainingCorrespondences (
        best_transformation_.setIdentity ();
        return;
      }
-     std::unordered_map<int, int> index_to_correspondence;
+     // The inliers are source indices, look up their correspondence by source index
+     std::vector<int> index_to_correspondence (input_->size (), -1);
      for (int i = 0; i < nr_correspondences; ++i)
        index_to_correspondence[original_correspondences[i].index_query] = i;
 
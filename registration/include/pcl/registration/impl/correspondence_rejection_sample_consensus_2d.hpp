@@ -42,8 +42,6 @@
 #include <pcl/sample_consensus/sac_model_registration_2d.h>
 #include <pcl/sample_consensus/ransac.h>
 
-#include <unordered_map>
-
 
 namespace pcl
 {
@@ -94,6 +92,8 @@ CorrespondenceRejectorSampleConsensus2D<PointT>::getRemainingCorrespondences (
   // Create a RANSAC model
   pcl::RandomSampleConsensus<PointT> sac (model, inlier_threshold_);
   sac.setMaxIterations (max_iterations_);
+  // A negative number of threads keeps the serial RANSAC
+  sac.setNumberOfThreads (threads_ > 1 ? static_cast<int> (threads_) : -1);
 
   // Compute the set of inliers
   if (!sac.computeModel ())
@@ -117,7 +117,8 @@ CorrespondenceRejectorSampleConsensus2D<PointT>::getRemainingCorrespondences (
     return;
   }
 
-  std::unordered_map<int, int> index_to_correspondence;
+  // The inliers are source indices, look up their correspondence by source index
+  std::vector<int> index_to_correspondence (input_->size (), -1);
   for (int i = 0; i < nr_correspondences; ++i)
     index_to_correspondence[original_correspondences[i].index_query] = i;
 
@@ -44,12 +44,31 @@
 #include <algorithm>
 #include <list>
 #include <tuple>
+#include <vector>
 
 #include <pcl/common/transforms.h>
 #include <pcl/registration/eigen.h>
 #include <pcl/registration/boost.h>
 #include <pcl/registration/registration.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::registration::ELCH<PointT>::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs ();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT> void
 pcl::registration::ELCH<PointT>::loopOptimizerAlgorithm (LOAGraph &g, double *weights)
@@ -177,7 +196,17 @@ pcl::registration::ELCH<PointT>::initCompute ()
     *meta_start = *(*loop_graph_)[loop_start_].cloud;
     *meta_end = *(*loop_graph_)[loop_end_].cloud;
 
+    // Reserve the concatenated clouds once
     typename boost::graph_traits<LoopGraph>::adjacency_iterator si, si_end;
+    std::size_t meta_start_size = meta_start->size ();
+    for (std::tie (si, si_end) = adjacent_vertices (loop_start_, *loop_graph_); si != si_end; si++)
+      meta_start_size += (*loop_graph_)[*si].cloud->size ();
+    meta_start->reserve (meta_start_size);
+    std::size_t meta_end_size = meta_end->size ();
+    for (std::tie (si, si_end) = adjacent_vertices (loop_end_, *loop_graph_); si != si_end; si++)
+      meta_end_size += (*loop_graph_)[*si].cloud->size ();
+    meta_end->reserve (meta_end_size);
+
     for (std::tie (si, si_end) = adjacent_vertices (loop_start_, *loop_graph_); si != si_end; si++)
       *meta_start += *(*loop_graph_)[*si].cloud;
 
@@ -230,12 +259,17 @@ pcl::registration::ELCH<PointT>::compute ()
       add_edge (source (*edge_it, *loop_graph_), target (*edge_it, *loop_graph_), 1, j);  //TODO add variance
   }
 
-  double *weights[4];
+  // The optimizations of the four graphs are independent
+  const std::size_t nr_vertices = num_vertices (*loop_graph_);
+  std::vector<double> weights[4];
+  for (auto &w : weights)
+    w.resize (nr_vertices);
+#pragma omp parallel for \
+  default(none) \
+  shared(grb, weights) \
+  num_threads(std::min (threads_, 4u))
   for (int i = 0; i < 4; i++)
-  {
-    weights[i] = new double[num_vertices (*loop_graph_)];
-    loopOptimizerAlgorithm (grb[i], weights[i]);
-  }
+    loopOptimizerAlgorithm (grb[i], weights[i].data ());
 
   //TODO use pose
   //Eigen::Vector4f cend;
@@ -247,7 +281,13 @@ pcl::registration::ELCH<PointT>::compute ()
   //TODO iterate ovr loop_graph_
   //typename boost::graph_traits<LoopGraph>::vertex_iterator vertex_it, vertex_it_end;
   //for (std::tie (vertex_it, vertex_it_end) = vertices (*loop_graph_); vertex_it != vertex_it_end; vertex_it++)
-  for (std::size_t i = 0; i < num_vertices (*loop_graph_); i++)
+  // Every vertex only transforms its own point cloud
+#pragma omp parallel for \
+  default(none) \
+  shared(nr_vertices, weights) \
+  num_threads(threads_) \
+  schedule(dynamic)
+  for (std::ptrdiff_t i = 0; i < static_cast<std::ptrdiff_t> (nr_vertices); i++)
   {
     Eigen::Vector3f t2;
     t2[0] = loop_transform_ (0, 3) * static_cast<float> (weights[0][i]);
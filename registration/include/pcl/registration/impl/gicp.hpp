@@ -44,15 +44,35 @@
 #include <pcl/registration/boost.h>
 #include <pcl/registration/exceptions.h>
 
+#include <algorithm>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 
 namespace pcl
 {
 
+template <typename PointSource, typename PointTarget> void
+GeneralizedIterativeClosestPoint<PointSource, PointTarget>::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs ();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
+
+
 template <typename PointSource, typename PointTarget>
 template<typename PointT> void
 GeneralizedIterativeClosestPoint<PointSource, PointTarget>::computeCovariances(typename pcl::PointCloud<PointT>::ConstPtr cloud,
                                                                                const typename pcl::search::KdTree<PointT>::Ptr kdtree,
-                                                                               MatricesVector& cloud_covariances)
+                                                                               MatricesVector& cloud_covariances) const
 {
   if (k_correspondences_ > int (cloud->size ()))
   {
@@ -60,7 +80,6 @@ GeneralizedIterativeClosestPoint<PointSource, PointTarget>::computeCovariances(t
     return;
   }
 
-  Eigen::Vector3d mean;
   std::vector<int> nn_indecies; nn_indecies.reserve (k_correspondences_);
   std::vector<float> nn_dist_sq; nn_dist_sq.reserve (k_correspondences_);
 
@@ -68,13 +87,17 @@ GeneralizedIterativeClosestPoint<PointSource, PointTarget>::computeCovariances(t
   if(cloud_covariances.size () < cloud->size ())
     cloud_covariances.resize (cloud->size ());
 
-  MatricesVector::iterator matrices_iterator = cloud_covariances.begin ();
-  for(auto points_iterator = cloud->begin ();
-      points_iterator != cloud->end ();
-      ++points_iterator, ++matrices_iterator)
+#pragma omp parallel for \
+  default(none) \
+  shared(cloud, cloud_covariances, kdtree) \
+  firstprivate(nn_indecies, nn_dist_sq) \
+  num_threads(threads_) \
+  schedule(dynamic, 256)
+  for (std::ptrdiff_t i = 0; i < static_cast<std::ptrdiff_t> (cloud->size ()); ++i)
   {
-    const PointT &query_point = *points_iterator;
-    Eigen::Matrix3d &cov = *matrices_iterator;
+    const PointT &query_point = (*cloud)[i];
+    Eigen::Matrix3d &cov = cloud_covariances[i];
+    Eigen::Vector3d mean;
     // Zero out the cov and mean
     cov.setZero ();
     mean.setZero ();
@@ -248,101 +271,95 @@ GeneralizedIterativeClosestPoint<PointSource, PointTarget>::estimateRigidTransfo
 }
 
 
-template <typename PointSource, typename PointTarget> inline double
-GeneralizedIterativeClosestPoint<PointSource, PointTarget>::OptimizationFunctorWithIndices::operator() (const Vector6d& x)
+template <typename PointSource, typename PointTarget> void
+GeneralizedIterativeClosestPoint<PointSource, PointTarget>::computeObjective (const Vector6d& x, double& f, Vector6d* g) const
 {
-  Eigen::Matrix4f transformation_matrix = gicp_->base_transformation_;
-  gicp_->applyState(transformation_matrix, x);
-  double f = 0;
-  int m = static_cast<int> (gicp_->tmp_idx_src_->size ());
-  for (int i = 0; i < m; ++i)
+  Eigen::Matrix4f transformation_matrix = base_transformation_;
+  applyState(transformation_matrix, x);
+  const int m = static_cast<int> (tmp_idx_src_->size ());
+
+  // Every thread sums a contiguous range of the correspondences, the partial sums are added in the order of the
+  // ranges so that a single thread sums in the order of the correspondences
+  std::size_t nr_chunks = std::max<std::size_t> (1, std::min<std::size_t> (threads_, m));
+  std::vector<double> chunk_f (nr_chunks, 0.);
+  std::vector<Eigen::Vector3d> chunk_g (nr_chunks, Eigen::Vector3d::Zero ());
+  MatricesVector chunk_R (nr_chunks, Eigen::Matrix3d::Zero ());
+
+#pragma omp parallel for \
+  default(none) \
+  shared(chunk_f, chunk_g, chunk_R, g, m, nr_chunks, transformation_matrix) \
+  num_threads(threads_)
+  for (std::ptrdiff_t chunk = 0; chunk < static_cast<std::ptrdiff_t> (nr_chunks); ++chunk)
   {
-    // The last coordinate, p_src[3] is guaranteed to be set to 1.0 in registration.hpp
-    Vector4fMapConst p_src = (*gicp_->tmp_src_)[(*gicp_->tmp_idx_src_)[i]].getVector4fMap ();
-    // The last coordinate, p_tgt[3] is guaranteed to be set to 1.0 in registration.hpp
-    Vector4fMapConst p_tgt = (*gicp_->tmp_tgt_)[(*gicp_->tmp_idx_tgt_)[i]].getVector4fMap ();
-    Eigen::Vector4f pp (transformation_matrix * p_src);
-    // Estimate the distance (cost function)
-    // The last coordinate is still guaranteed to be set to 1.0
-    Eigen::Vector3d res(pp[0] - p_tgt[0], pp[1] - p_tgt[1], pp[2] - p_tgt[2]);
-    Eigen::Vector3d temp (gicp_->mahalanobis((*gicp_->tmp_idx_src_)[i]) * res);
-    //increment= res'*temp/num_matches = temp'*M*temp/num_matches (we postpone 1/num_matches after the loop closes)
-    f+= double(res.transpose() * temp);
+    const int begin = static_cast<int> (m * chunk / nr_chunks);
+    const int end = static_cast<int> (m * (chunk + 1) / nr_chunks);
+    for (int i = begin; i < end; ++i)
+    {
+      // The last coordinate, p_src[3] is guaranteed to be set to 1.0 in registration.hpp
+      Vector4fMapConst p_src = (*tmp_src_)[(*tmp_idx_src_)[i]].getVector4fMap ();
+      // The last coordinate, p_tgt[3] is guaranteed to be set to 1.0 in registration.hpp
+      Vector4fMapConst p_tgt = (*tmp_tgt_)[(*tmp_idx_tgt_)[i]].getVector4fMap ();
+      Eigen::Vector4f pp (transformation_matrix * p_src);
+      // Estimate the distance (cost function)
+      // The last coordinate is still guaranteed to be set to 1.0
+      Eigen::Vector3d res (pp[0] - p_tgt[0], pp[1] - p_tgt[1], pp[2] - p_tgt[2]);
+      // temp = M*res
+      Eigen::Vector3d temp (mahalanobis((*tmp_idx_src_)[i]) * res);
+      //increment= res'*temp/num_matches = temp'*M*temp/num_matches (we postpone 1/num_matches after the loop closes)
+      chunk_f[chunk]+= double(res.transpose() * temp);
+      if (!g)
+        continue;
+      // Increment translation gradient
+      // g.head<3> ()+= 2*M*res/num_matches (we postpone 2/num_matches after the loop closes)
+      chunk_g[chunk]+= temp;
+      // Increment rotation gradient
+      pp = base_transformation_ * p_src;
+      Eigen::Vector3d p_src3 (pp[0], pp[1], pp[2]);
+      chunk_R[chunk]+= p_src3 * temp.transpose();
+    }
   }
-  return f/m;
-}
 
+  f = 0;
+  for (std::size_t chunk = 0; chunk < nr_chunks; ++chunk)
+    f+= chunk_f[chunk];
+  f/= double(m);
+  if (!g)
+    return;
 
-template <typename PointSource, typename PointTarget> inline void
-GeneralizedIterativeClosestPoint<PointSource, PointTarget>::OptimizationFunctorWithIndices::df (const Vector6d& x, Vector6d& g)
-{
-  Eigen::Matrix4f transformation_matrix = gicp_->base_transformation_;
-  gicp_->applyState(transformation_matrix, x);
-  //Zero out g
-  g.setZero ();
-  //Eigen::Vector3d g_t = g.head<3> ();
+  g->setZero ();
   Eigen::Matrix3d R = Eigen::Matrix3d::Zero ();
-  int m = static_cast<int> (gicp_->tmp_idx_src_->size ());
-  for (int i = 0; i < m; ++i)
+  for (std::size_t chunk = 0; chunk < nr_chunks; ++chunk)
   {
-    // The last coordinate, p_src[3] is guaranteed to be set to 1.0 in registration.hpp
-    Vector4fMapConst p_src = (*gicp_->tmp_src_)[(*gicp_->tmp_idx_src_)[i]].getVector4fMap ();
-    // The last coordinate, p_tgt[3] is guaranteed to be set to 1.0 in registration.hpp
-    Vector4fMapConst p_tgt = (*gicp_->tmp_tgt_)[(*gicp_->tmp_idx_tgt_)[i]].getVector4fMap ();
-
-    Eigen::Vector4f pp (transformation_matrix * p_src);
-    // The last coordinate is still guaranteed to be set to 1.0
-    Eigen::Vector3d res (pp[0] - p_tgt[0], pp[1] - p_tgt[1], pp[2] - p_tgt[2]);
-    // temp = M*res
-    Eigen::Vector3d temp (gicp_->mahalanobis ((*gicp_->tmp_idx_src_)[i]) * res);
-    // Increment translation gradient
-    // g.head<3> ()+= 2*M*res/num_matches (we postpone 2/num_matches after the loop closes)
-    g.head<3> ()+= temp;
-    // Increment rotation gradient
-    pp = gicp_->base_transformation_ * p_src;
-    Eigen::Vector3d p_src3 (pp[0], pp[1], pp[2]);
-    R+= p_src3 * temp.transpose();
+    g->head<3> ()+= chunk_g[chunk];
+    R+= chunk_R[chunk];
   }
-  g.head<3> ()*= 2.0/m;
+  g->head<3> ()*= double(2.0/m);
   R*= 2.0/m;
-  gicp_->computeRDerivative(x, R, g);
+  computeRDerivative(x, R, *g);
+}
+
+
+template <typename PointSource, typename PointTarget> inline double
+GeneralizedIterativeClosestPoint<PointSource, PointTarget>::OptimizationFunctorWithIndices::operator() (const Vector6d& x)
+{
+  double f;
+  gicp_->computeObjective (x, f, nullptr);
+  return f;
+}
+
+
+template <typename PointSource, typename PointTarget> inline void
+GeneralizedIterativeClosestPoint<PointSource, PointTarget>::OptimizationFunctorWithIndices::df (const Vector6d& x, Vector6d& g)
+{
+  double f;
+  gicp_->computeObjective (x, f, &g);
 }
 
 
 template <typename PointSource, typename PointTarget> inline void
 GeneralizedIterativeClosestPoint<PointSource, PointTarget>::OptimizationFunctorWithIndices::fdf (const Vector6d& x, double& f, Vector6d& g)
 {
-  Eigen::Matrix4f transformation_matrix = gicp_->base_transformation_;
-  gicp_->applyState(transformation_matrix, x);
-  f = 0;
-  g.setZero ();
-  Eigen::Matrix3d R = Eigen::Matrix3d::Zero ();
-  const int m = static_cast<int> (gicp_->tmp_idx_src_->size ());
-  for (int i = 0; i < m; ++i)
-  {
-    // The last coordinate, p_src[3] is guaranteed to be set to 1.0 in registration.hpp
-    Vector4fMapConst p_src = (*gicp_->tmp_src_)[(*gicp_->tmp_idx_src_)[i]].getVector4fMap ();
-    // The last coordinate, p_tgt[3] is guaranteed to be set to 1.0 in registration.hpp
-    Vector4fMapConst p_tgt = (*gicp_->tmp_tgt_)[(*gicp_->tmp_idx_tgt_)[i]].getVector4fMap ();
-    Eigen::Vector4f pp (transformation_matrix * p_src);
-    // The last coordinate is still guaranteed to be set to 1.0
-    Eigen::Vector3d res (pp[0] - p_tgt[0], pp[1] - p_tgt[1], pp[2] - p_tgt[2]);
-    // temp = M*res
-    Eigen::Vector3d temp (gicp_->mahalanobis((*gicp_->tmp_idx_src_)[i]) * res);
-    // Increment total error
-    f+= double(res.transpose() * temp);
-    // Increment translation gradient
-    // g.head<3> ()+= 2*M*res/num_matches (we postpone 2/num_matches after the loop closes)
-    g.head<3> ()+= temp;
-    pp = gicp_->base_transformation_ * p_src;
-    Eigen::Vector3d p_src3 (pp[0], pp[1], pp[2]);
-    // Increment rotation gradient
-    R+= p_src3 * temp.transpose();
-  }
-  f/= double(m);
-  g.head<3> ()*= double(2.0/m);
-  R*= 2.0/m;
-  gicp_->computeRDerivative(x, R, g);
+  gicp_->computeObjective (x, f, &g);
 }
 
 template <typename PointSource, typename PointTarget> inline BFGSSpace::Status
@@ -366,6 +383,70 @@ GeneralizedIterativeClosestPoint<PointSource, PointTarget>::OptimizationFunctorW
   return BFGSSpace::Running;
 }
 
+template <typename PointSource, typename PointTarget> bool
+GeneralizedIterativeClosestPoint<PointSource, PointTarget>::findCorrespondences (
+    const PointCloudSource &output, const Eigen::Matrix3d &R,
+    std::vector<int> &source_indices, std::vector<int> &target_indices)
+{
+  double dist_threshold = corr_dist_threshold_ * corr_dist_threshold_;
+  std::size_t N = indices_->size ();
+  // The correspondence of each source point, -1 if it is too far and -2 if the search failed
+  std::vector<int> matches (N, -1);
+  std::vector<int> nn_indices (1);
+  std::vector<float> nn_dists (1);
+
+#pragma omp parallel for \
+  default(none) \
+  shared(dist_threshold, matches, N, output, R) \
+  firstprivate(nn_indices, nn_dists) \
+  num_threads(threads_) \
+  schedule(dynamic, 256)
+  for (std::ptrdiff_t i = 0; i < static_cast<std::ptrdiff_t> (N); i++)
+  {
+    PointSource query = output[i];
+    query.getVector4fMap () = this->transformation_ * query.getVector4fMap ();
+
+    if (!this->searchForNeighbors (query, nn_indices, nn_dists))
+    {
+      matches[i] = -2;
+      continue;
+    }
+
+    // Check if the distance to the nearest neighbor is smaller than the user imposed threshold
+    if (nn_dists[0] < dist_threshold)
+    {
+      Eigen::Matrix3d &C1 = (*input_covariances_)[i];
+      Eigen::Matrix3d &C2 = (*target_covariances_)[nn_indices[0]];
+      Eigen::Matrix3d &M = mahalanobis_[i];
+      // M = R*C1
+      M = R * C1;
+      // temp = M*R' + C2 = R*C1*R' + C2
+      Eigen::Matrix3d temp = M * R.transpose();
+      temp+= C2;
+      // M = temp^-1
+      M = temp.inverse ();
+      matches[i] = nn_indices[0];
+    }
+  }
+
+  source_indices.clear ();
+  target_indices.clear ();
+  for (std::size_t i = 0; i < N; i++)
+  {
+    if (matches[i] == -2)
+    {
+      PCL_ERROR ("[pcl::%s::computeTransformation] Unable to find a nearest neighbor in the target dataset for point %d in the source!\n", getClassName ().c_str (), (*indices_)[i]);
+      return (false);
+    }
+    if (matches[i] < 0)
+      continue;
+    source_indices.push_back (static_cast<int> (i));
+    target_indices.push_back (matches[i]);
+  }
+  return (true);
+}
+
+
 template <typename PointSource, typename PointTarget> inline void
 GeneralizedIterativeClosestPoint<PointSource, PointTarget>::computeTransformation (PointCloudSource &output, const Eigen::Matrix4f& guess)
 {
@@ -392,17 +473,13 @@ GeneralizedIterativeClosestPoint<PointSource, PointTarget>::computeTransformatio
   base_transformation_ = Eigen::Matrix4f::Identity();
   nr_iterations_ = 0;
   converged_ = false;
-  double dist_threshold = corr_dist_threshold_ * corr_dist_threshold_;
-  std::vector<int> nn_indices (1);
-  std::vector<float> nn_dists (1);
 
   pcl::transformPointCloud(output, output, guess);
 
   while(!converged_)
   {
-    std::size_t cnt = 0;
-    std::vector<int> source_indices (indices_->size ());
-    std::vector<int> target_indices (indices_->size ());
+    std::vector<int> source_indices;
+    std::vector<int> target_indices;
 
     // guess corresponds to base_t and transformation_ to t
     Eigen::Matrix4d transform_R = Eigen::Matrix4d::Zero ();
@@ -413,43 +490,14 @@ GeneralizedIterativeClosestPoint<PointSource, PointTarget>::computeTransformatio
 
     Eigen::Matrix3d R = transform_R.topLeftCorner<3,3> ();
 
-    for (std::size_t i = 0; i < N; i++)
-    {
-      PointSource query = output[i];
-      query.getVector4fMap () = transformation_ * query.getVector4fMap ();
-
-      if (!searchForNeighbors (query, nn_indices, nn_dists))
-      {
-        PCL_ERROR ("[pcl::%s::computeTransformation] Unable to find a nearest neighbor in the target dataset for point %d in the source!\n", getClassName ().c_str (), (*indices_)[i]);
-        return;
-      }
-
-      // Check if the distance to the nearest neighbor is smaller than the user imposed threshold
-      if (nn_dists[0] < dist_threshold)
-      {
-        Eigen::Matrix3d &C1 = (*input_covariances_)[i];
-        Eigen::Matrix3d &C2 = (*target_covariances_)[nn_indices[0]];
-        Eigen::Matrix3d &M = mahalanobis_[i];
-        // M = R*C1
-        M = R * C1;
-        // temp = M*R' + C2 = R*C1*R' + C2
-        Eigen::Matrix3d temp = M * R.transpose();
-        temp+= C2;
-        // M = temp^-1
-        M = temp.inverse ();
-        source_indices[cnt] = static_cast<int> (i);
-        target_indices[cnt] = nn_indices[0];
-        cnt++;
-      }
-    }
-    // Resize to the actual number of valid correspondences
-    source_indices.resize(cnt); target_indices.resize(cnt);
+    if (!findCorrespondences (output, R, source_indices, target_indices))
+      return;
     /* optimize transformation using the current assignment and Mahalanobis metrics*/
     previous_transformation_ = transformation_;
     //optimization right here
     try
     {
-      rigid_transformation_estimation_(output, source_indices, *target_, target_indices, transformation_);
+      rigid_transformation_estimation_(output, source_indices, getCorrespondenceTarget (), target_indices, transformation_);
       /* compute the delta from this iteration */
       delta = 0.;
       for(int k = 0; k < 4; k++) {
@@ -45,12 +45,16 @@
 #include <pcl/sample_consensus/sac_model_plane.h>
 #include <pcl/registration/transformation_estimation_3point.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 ///////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT> inline float
 pcl::getMeanPointDensity (const typename pcl::PointCloud<PointT>::ConstPtr &cloud, float max_dist, int nr_threads)
 {
   const float max_dist_sqr = max_dist * max_dist;
-  const std::size_t s = cloud.size ();
+  const std::size_t s = cloud->size ();
 
   pcl::search::KdTree <PointT> tree;
   tree.setInputCloud (cloud);
@@ -60,17 +64,23 @@ pcl::getMeanPointDensity (const typename pcl::PointCloud<PointT>::ConstPtr &clou
   std::vector <int> ids (2);
   std::vector <float> dists_sqr (2);
 
+  // The points are drawn before the parallel loop, so that the density does not depend on the number of threads
+  std::mt19937 rng (12345u);
+  std::vector <int> samples (1000);
+  for (int &sample : samples)
+    sample = static_cast <int> (rng () % s);
+
   pcl::utils::ignore(nr_threads);
 #pragma omp parallel for \
   default(none) \
-  shared(tree, cloud) \
+  shared(tree, cloud, samples) \
   firstprivate(ids, dists_sqr) \
   reduction(+:mean_dist, num) \
-  firstprivate(s, max_dist_sqr) \
+  firstprivate(max_dist_sqr) \
   num_threads(nr_threads)
   for (int i = 0; i < 1000; i++)
   {
-    tree.nearestKSearch ((*cloud)[rand () % s], 2, ids, dists_sqr);
+    tree.nearestKSearch ((*cloud)[samples[i]], 2, ids, dists_sqr);
     if (dists_sqr[1] < max_dist_sqr)
     {
       mean_dist += std::sqrt (dists_sqr[1]);
@@ -98,25 +108,31 @@ pcl::getMeanPointDensity (const typename pcl::PointCloud<PointT>::ConstPtr &clou
   std::vector <int> ids (2);
   std::vector <float> dists_sqr (2);
 
+  // The points are drawn before the parallel loop, so that the density does not depend on the number of threads
+  std::mt19937 rng (12345u);
+  std::vector <int> samples (1000);
+  for (int &sample : samples)
+    sample = indices[rng () % s];
+
   pcl::utils::ignore(nr_threads);
 #if OPENMP_LEGACY_CONST_DATA_SHARING_RULE
 #pragma omp parallel for \
   default(none) \
-  shared(tree, cloud, indices) \
+  shared(tree, cloud, samples) \
   firstprivate(ids, dists_sqr) \
   reduction(+:mean_dist, num) \
   num_threads(nr_threads)
 #else
 #pragma omp parallel for \
   default(none) \
-  shared(tree, cloud, indices, s, max_dist_sqr) \
+  shared(tree, cloud, samples, max_dist_sqr) \
   firstprivate(ids, dists_sqr) \
   reduction(+:mean_dist, num) \
   num_threads(nr_threads)
 #endif
   for (int i = 0; i < 1000; i++)
   {
-    tree.nearestKSearch ((*cloud)[indices[rand () % s]], 2, ids, dists_sqr);
+    tree.nearestKSearch ((*cloud)[samples[i]], 2, ids, dists_sqr);
     if (dists_sqr[1] < max_dist_sqr)
     {
       mean_dist += std::sqrt (dists_sqr[1]);
@@ -140,6 +156,7 @@ pcl::registration::FPCSInitialAlignment <PointSource, PointTarget, NormalT, Scal
   nr_samples_ (0),
   max_norm_diff_ (90.f),
   max_runtime_ (0),
+  seed_ (static_cast <unsigned int> (std::time (nullptr))),
   fitness_score_ (FLT_MAX),
   diameter_ (),
   max_base_diameter_sqr_ (),
@@ -173,25 +190,34 @@ pcl::registration::FPCSInitialAlignment <PointSource, PointTarget, NormalT, Scal
   std::vector <MatchingCandidates> all_candidates (max_iterations_);
   pcl::StopWatch timer;
 
+  // The iterations after the first one reaching the score threshold are skipped and the candidates of the ones
+  // which ran anyway discarded, like serially, so that the result does not depend on the number of threads
+  int nr_iterations = max_iterations_;
+
   #pragma omp parallel \
     default(none) \
-    shared(abort, all_candidates, timer) \
+    shared(abort, all_candidates, nr_iterations, timer) \
     num_threads(nr_threads_)
   {
     #ifdef _OPENMP
-    std::srand (static_cast <unsigned int> (std::time (NULL)) ^ omp_get_thread_num ());    
     #pragma omp for schedule(dynamic)
     #endif
     for (int i = 0; i < max_iterations_; i++)
     {
-      #pragma omp flush (abort)
+      bool skip;
+      #pragma omp critical(fpcs_abort)
+      skip = abort || i >= nr_iterations;
 
       MatchingCandidates candidates (1);
       std::vector <int> base_indices (4);
       all_candidates[i] = candidates;
 
-      if (!abort)
+      if (!skip)
       {
+        // each iteration draws its bases with its own generator
+        std::seed_seq seq {seed_, static_cast <unsigned int> (i)};
+        getRandomGenerator ().seed (seq);
+
         float ratio[2];
         // select four coplanar point base
         if (selectBase (base_indices, ratio) == 0)
@@ -214,17 +240,20 @@ pcl::registration::FPCSInitialAlignment <PointSource, PointTarget, NormalT, Scal
         }
 
         // check terminate early (time or fitness_score threshold reached)
-        abort = (!candidates.empty () ? candidates[0].fitness_score < score_threshold_ : abort);
-        abort = (abort ? abort : timer.getTimeSeconds () > max_runtime_);
-
-
-        #pragma omp flush (abort)
+        const bool threshold_reached = !candidates.empty () && candidates[0].fitness_score < score_threshold_;
+        const bool timeout = timer.getTimeSeconds () > max_runtime_;
+        #pragma omp critical(fpcs_abort)
+        {
+          if (threshold_reached)
+            nr_iterations = std::min (nr_iterations, i + 1);
+          abort = abort || timeout;
+        }
       }
     }
   }
-  
 
   // determine best match over all tries
+  all_candidates.resize (nr_iterations);
   finalCompute (all_candidates);
 
   // apply the final transformation
@@ -238,7 +267,8 @@ pcl::registration::FPCSInitialAlignment <PointSource, PointTarget, NormalT, Scal
 template <typename PointSource, typename PointTarget, typename NormalT, typename Scalar> bool
 pcl::registration::FPCSInitialAlignment <PointSource, PointTarget, NormalT, Scalar>::initCompute ()
 {
-  std::srand (static_cast <unsigned int> (std::time (nullptr)));
+  // one random generator per thread, the iterations reseed them
+  rngs_.assign (std::max (nr_threads_, 1), std::mt19937 (seed_));
 
   // basic pcl initialization
   if (!pcl::PCLBase <PointSource>::initCompute ())
@@ -268,11 +298,12 @@ pcl::registration::FPCSInitialAlignment <PointSource, PointTarget, NormalT, Scal
 
     source_indices_ = pcl::IndicesPtr (new std::vector <int>);
     for (int i = 0; i < ss; i++)
-    if (rand () % sample_fraction_src == 0)
+    if (getRandomIndex (sample_fraction_src) == 0)
       source_indices_->push_back ((*indices_) [i]);
   }
   else
     source_indices_ = indices_;
+  source_points_.assign (*input_, *source_indices_);
 
   // check usage of normals
   if (source_normals_ && target_normals_  && source_normals_->size () == input_->size () && target_normals_->size () == target_->size ())
@@ -411,14 +442,14 @@ pcl::registration::FPCSInitialAlignment <PointSource, PointTarget, NormalT, Scal
   float best_t = 0.f;
 
   // choose random first point
-  base_indices[0] = (*target_indices_)[rand () % nr_points];
+  base_indices[0] = (*target_indices_)[getRandomIndex (nr_points)];
   int *index1 = &base_indices[0];
 
   // random search for 2 other points (as far away as overlap allows)
   for (int i = 0; i < ransac_iterations_; i++)
   {
-    int *index2 = &(*target_indices_)[rand () % nr_points];
-    int *index3 = &(*target_indices_)[rand () % nr_points];
+    int *index2 = &(*target_indices_)[getRandomIndex (nr_points)];
+    int *index3 = &(*target_indices_)[getRandomIndex (nr_points)];
 
     Eigen::Vector3f u = (*target_)[*index2].getVector3fMap () - (*target_)[*index1].getVector3fMap ();
     Eigen::Vector3f v = (*target_)[*index3].getVector3fMap () - (*target_)[*index1].getVector3fMap ();
@@ -438,6 +469,26 @@ pcl::registration::FPCSInitialAlignment <PointSource, PointTarget, NormalT, Scal
 }
 
 
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointSource, typename PointTarget, typename NormalT, typename Scalar> std::mt19937 &
+pcl::registration::FPCSInitialAlignment <PointSource, PointTarget, NormalT, Scalar>::getRandomGenerator ()
+{
+#ifdef _OPENMP
+  return (rngs_[omp_get_thread_num ()]);
+#else
+  return (rngs_[0]);
+#endif
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointSource, typename PointTarget, typename NormalT, typename Scalar> int
+pcl::registration::FPCSInitialAlignment <PointSource, PointTarget, NormalT, Scalar>::getRandomIndex (int n)
+{
+  return (static_cast <int> (getRandomGenerator () () % static_cast <unsigned int> (n)));
+}
+
+
 ///////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointSource, typename PointTarget, typename NormalT, typename Scalar> void
 pcl::registration::FPCSInitialAlignment <PointSource, PointTarget, NormalT, Scalar>::setupBase (
@@ -589,16 +640,41 @@ pcl::registration::FPCSInitialAlignment <PointSource, PointTarget, NormalT, Scal
   float ref_norm_angle = (use_normals_ ? ((*target_normals_)[idx1].getNormalVector3fMap () -
                                           (*target_normals_)[idx2].getNormalVector3fMap ()).norm () : 0.f);
 
+  // bounds of the squared pair distances, widened by a margin above the rounding errors so that the block test
+  // below never rejects a pair accepted by the exact test
+  const float margin = 1e-5f * (ref_dist + max_pair_diff_);
+  const float min_dist = std::max (ref_dist - max_pair_diff_ - margin, 0.f);
+  const float max_dist = ref_dist + max_pair_diff_ + margin;
+  // the bounds are tested as a single distance to their centre, a branch which is nearly always taken
+  const float mid_dist_sqr = 0.5f * (min_dist * min_dist + max_dist * max_dist);
+  const float half_range_sqr = 0.5f * (max_dist * max_dist - min_dist * min_dist) * (1.f + 1e-5f);
+
   // loop over all pairs of points in source point cloud
-  auto it_out = source_indices_->begin (), it_out_e = source_indices_->end () - 1;
-  auto it_in_e = source_indices_->end ();
-  for ( ; it_out != it_out_e; it_out++)
+  using ConstArrayMap = PointCloudSoA::ConstArrayMap;
+  const std::size_t nr_points = source_indices_->size ();
+  const float *xs = source_points_.xData ();
+  const float *ys = source_points_.yData ();
+  const float *zs = source_points_.zData ();
+  std::vector <float> dists_sqr_diff (nr_points);
+  for (std::size_t i = 0; i + 1 < nr_points; i++)
   {
-    auto it_in = it_out + 1;
-    const PointSource *pt1 = &(*input_)[*it_out];
-    for ( ; it_in != it_in_e; it_in++)
+    const int idx_out = (*source_indices_)[i];
+    const PointSource *pt1 = &(*input_)[idx_out];
+
+    // deviations of the squared distances to all following points at once
+    const std::size_t count = nr_points - i - 1;
+    Eigen::Map <Eigen::ArrayXf> (dists_sqr_diff.data (), count) =
+      ((ConstArrayMap (xs + i + 1, count) - xs[i]).square () +
+       (ConstArrayMap (ys + i + 1, count) - ys[i]).square () +
+       (ConstArrayMap (zs + i + 1, count) - zs[i]).square () - mid_dist_sqr).abs ();
+
+    for (std::size_t j = 0; j < count; j++)
     {
-      const PointSource *pt2 = &(*input_)[*it_in];
+      if (dists_sqr_diff[j] > half_range_sqr)
+        continue;
+
+      const int idx_in = (*source_indices_)[i + 1 + j];
+      const PointSource *pt2 = &(*input_)[idx_in];
 
       // check point distance compared to reference dist (from base)
       float dist = pcl::euclideanDistance (*pt1, *pt2);
@@ -607,8 +683,8 @@ pcl::registration::FPCSInitialAlignment <PointSource, PointTarget, NormalT, Scal
         // add here normal evaluation if normals are given
         if (use_normals_)
         {
-          const NormalT *pt1_n = &((*source_normals_)[*it_out]);
-          const NormalT *pt2_n = &((*source_normals_)[*it_in]);
+          const NormalT *pt1_n = &((*source_normals_)[idx_out]);
+          const NormalT *pt2_n = &((*source_normals_)[idx_in]);
 
           float norm_angle_1 = (pt1_n->getNormalVector3fMap () - pt2_n->getNormalVector3fMap ()).norm ();
           float norm_angle_2 = (pt1_n->getNormalVector3fMap () + pt2_n->getNormalVector3fMap ()).norm ();
@@ -618,8 +694,8 @@ pcl::registration::FPCSInitialAlignment <PointSource, PointTarget, NormalT, Scal
             continue;
         }
 
-        pairs.push_back (pcl::Correspondence (*it_in, *it_out, dist));
-        pairs.push_back (pcl::Correspondence (*it_out, *it_in, dist));
+        pairs.push_back (pcl::Correspondence (idx_in, idx_out, dist));
+        pairs.push_back (pcl::Correspondence (idx_out, idx_in, dist));
       }
     }
   }
@@ -91,7 +91,7 @@ KFPCSInitialAlignment <PointSource, PointTarget, NormalT, Scalar>::initCompute (
     indices_validation_ = indices_;
   else
     for (int i = 0; i < ransac_iterations_; i++)
-      indices_validation_->push_back ((*indices_)[rand () % nr_indices]);
+      indices_validation_->push_back ((*indices_)[this->getRandomIndex (static_cast <int> (nr_indices))]);
 
   return (true);
 }
@@ -43,6 +43,11 @@
 
 #include <pcl/common/distances.h>
 
+#include <limits>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 namespace pcl
 {
@@ -72,6 +77,20 @@ SampleConsensusInitialAlignment<PointSource, PointTarget, FeatureT>::setTargetFe
 }
 
 
+template <typename PointSource, typename PointTarget, typename FeatureT> void
+SampleConsensusInitialAlignment<PointSource, PointTarget, FeatureT>::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs ();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
+
+
 template <typename PointSource, typename PointTarget, typename FeatureT> void
 SampleConsensusInitialAlignment<PointSource, PointTarget, FeatureT>::selectSamples (
     const PointCloudSource &cloud, int nr_samples, float min_sample_distance,
@@ -156,7 +175,15 @@ SampleConsensusInitialAlignment<PointSource, PointTarget, FeatureT>::findSimilar
 
 template <typename PointSource, typename PointTarget, typename FeatureT> float
 SampleConsensusInitialAlignment<PointSource, PointTarget, FeatureT>::computeErrorMetric (
-    const PointCloudSource &cloud, float)
+    const PointCloudSource &cloud, float threshold)
+{
+  return (computeErrorMetric (cloud, threshold, std::numeric_limits<float>::max ()));
+}
+
+
+template <typename PointSource, typename PointTarget, typename FeatureT> float
+SampleConsensusInitialAlignment<PointSource, PointTarget, FeatureT>::computeErrorMetric (
+    const PointCloudSource &cloud, float, float max_error) const
 {
   std::vector<int> nn_index (1);
   std::vector<float> nn_distance (1);
@@ -169,8 +196,10 @@ SampleConsensusInitialAlignment<PointSource, PointTarget, FeatureT>::computeErro
     // Find the distance between cloud[i] and its nearest neighbor in the target point cloud
     tree_->nearestKSearch (cloud, i, 1, nn_index, nn_distance);
 
-    // Compute the error
+    // Compute the error, the terms are positive so the alignment can be rejected once it exceeds max_error
     error += compute_error (nn_distance[0]);
+    if (error > max_error)
+      break;
   }
   return (error);
 }
@@ -216,40 +245,62 @@ SampleConsensusInitialAlignment<PointSource, PointTarget, FeatureT>::computeTran
   std::vector<int> sample_indices (nr_samples_);
   std::vector<int> corresponding_indices (nr_samples_);
   PointCloudSource input_transformed;
-  float lowest_error (0);
+  float lowest_error (std::numeric_limits<float>::max ());
+  // Whether lowest_error is the error of a pose, the first hypothesis is kept whatever its error
+  bool has_lowest_error = false;
 
   final_transformation_ = guess;
-  int i_iter = 0;
+  int first_iteration = 0;
   converged_ = false;
   if (!guess.isApprox (Eigen::Matrix4f::Identity (), 0.01f))
   {
     // If guess is not the Identity matrix we check it.
     transformPointCloud (*input_, input_transformed, final_transformation_);
     lowest_error = computeErrorMetric (input_transformed, static_cast<float> (corr_dist_threshold_));
-    i_iter = 1;
+    has_lowest_error = true;
+    first_iteration = 1;
   }
 
-  for (; i_iter < max_iterations_; ++i_iter)
+  // The samples are drawn in a critical section, so that a single thread draws the same hypotheses as before
+#pragma omp parallel for \
+  default(none) \
+  shared(first_iteration, has_lowest_error, lowest_error) \
+  firstprivate(sample_indices, corresponding_indices, input_transformed) \
+  num_threads(threads_) \
+  schedule(dynamic)
+  for (int i_iter = first_iteration; i_iter < this->max_iterations_; ++i_iter)
   {
-    // Draw nr_samples_ random samples
-    selectSamples (*input_, nr_samples_, min_sample_distance_, sample_indices);
+#pragma omp critical(ia_ransac_samples)
+    {
+      // Draw nr_samples_ random samples
+      selectSamples (*this->input_, nr_samples_, min_sample_distance_, sample_indices);
 
-    // Find corresponding features in the target cloud
-    findSimilarFeatures (*input_features_, sample_indices, corresponding_indices);
+      // Find corresponding features in the target cloud
+      findSimilarFeatures (*input_features_, sample_indices, corresponding_indices);
+    }
 
     // Estimate the transform from the samples to their corresponding points
-    transformation_estimation_->estimateRigidTransformation (*input_, sample_indices, *target_, corresponding_indices, transformation_);
+    Matrix4 transformation;
+    this->transformation_estimation_->estimateRigidTransformation (*this->input_, sample_indices, *this->target_, corresponding_indices, transformation);
+
+    // The evaluation stops as soon as the error exceeds the lowest error found by any thread
+    float max_error;
+#pragma omp critical(ia_ransac_update)
+    max_error = lowest_error;
 
     // Transform the data and compute the error
-    transformPointCloud (*input_, input_transformed, transformation_);
-    float error = computeErrorMetric (input_transformed, static_cast<float> (corr_dist_threshold_));
+    transformPointCloud (*this->input_, input_transformed, transformation);
+    const float error = computeErrorMetric (input_transformed, static_cast<float> (this->corr_dist_threshold_), max_error);
 
     // If the new error is lower, update the final transformation
-    if (i_iter == 0 || error < lowest_error)
+#pragma omp critical(ia_ransac_update)
+    if (!has_lowest_error || error < lowest_error)
     {
       lowest_error = error;
-      final_transformation_ = transformation_;
-      converged_=true;
+      has_lowest_error = true;
+      this->transformation_ = transformation;
+      this->final_transformation_ = transformation;
+      this->converged_ = true;
     }
   }
 
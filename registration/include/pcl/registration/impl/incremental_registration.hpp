@@ -63,6 +63,31 @@ IncrementalRegistration<PointT, Scalar>::registerCloud (const PointCloudConstPtr
     return (true);
   }
 
+  if (local_map_)
+  {
+    if (local_map_->empty ())
+      local_map_->addKeyframe (*last_cloud_, abs_transform_);
+
+    // The cloud is aligned to the map, starting from the estimated absolute transform
+    local_map_->assignTo (*registration_);
+    registration_->setInputSource (cloud);
+    {
+    pcl::PointCloud<PointT> p;
+    registration_->align (p, Matrix4 (abs_transform_ * delta_estimate));
+    }
+
+    const bool converged = registration_->hasConverged ();
+    if (converged)
+    {
+      const Matrix4 abs_transform = registration_->getFinalTransformation ();
+      delta_transform_ = abs_transform_.inverse () * abs_transform;
+      abs_transform_ = abs_transform;
+      last_cloud_ = cloud;
+      local_map_->update (*cloud, abs_transform_);
+    }
+    return (converged);
+  }
+
   registration_->setInputSource (cloud);
   registration_->setInputTarget (last_cloud_);
 
@@ -98,6 +123,8 @@ template <typename PointT, typename Scalar> inline void
 IncrementalRegistration<PointT, Scalar>::reset ()
 {
   last_cloud_.reset ();
+  if (local_map_)
+    local_map_->clear ();
   delta_transform_ = abs_transform_ = Matrix4::Identity ();
 }
 
@@ -107,6 +134,18 @@ IncrementalRegistration<PointT, Scalar>::setRegistration (RegistrationPtr regist
   registration_ = registration;
 }
 
+template <typename PointT, typename Scalar> inline void
+IncrementalRegistration<PointT, Scalar>::setLocalMap (const LocalMapPtr &local_map)
+{
+  local_map_ = local_map;
+}
+
+template <typename PointT, typename Scalar> inline typename pcl::registration::IncrementalRegistration<PointT, Scalar>::LocalMapPtr
+IncrementalRegistration<PointT, Scalar>::getLocalMap () const
+{
+  return (local_map_);
+}
+
 } // namespace registration
 } // namespace pcl
 
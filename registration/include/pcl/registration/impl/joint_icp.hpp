@@ -43,10 +43,27 @@
 #include <pcl/correspondence.h>
 #include <pcl/console/print.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 namespace pcl
 {
 
+template <typename PointSource, typename PointTarget, typename Scalar> void
+JointIterativeClosestPoint<PointSource, PointTarget, Scalar>::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs ();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
+
+
 template <typename PointSource, typename PointTarget, typename Scalar> void
 JointIterativeClosestPoint<PointSource, PointTarget, Scalar>::computeTransformation (
     PointCloudSource &output, const Matrix4 &guess)
@@ -164,28 +181,42 @@ JointIterativeClosestPoint<PointSource, PointTarget, Scalar>::computeTransformat
     // Save the previously estimated transformation
     previous_transformation_ = transformation_;
 
-    // Set the source each iteration, to ensure the dirty flag is updated
+    // Set the source each iteration, to ensure the dirty flag is updated. The pairs are independent, each has its
+    // own estimation (and search trees), so they are estimated concurrently; the first iteration also builds the trees
     correspondences_->clear ();
-    for (std::size_t i = 0; i < correspondence_estimations_.size (); i++)
+    const std::ptrdiff_t nr_pairs = static_cast<std::ptrdiff_t> (correspondence_estimations_.size ());
+    const bool use_reciprocal_correspondence = use_reciprocal_correspondence_;
+    const double corr_dist_threshold = corr_dist_threshold_;
+    std::vector<CorrespondenceEstimationPtr> &correspondence_estimations = correspondence_estimations_;
+#pragma omp parallel for \
+  default(none) \
+  shared(correspondence_estimations, corr_dist_threshold, inputs_transformed, nr_pairs, partial_correspondences_, use_reciprocal_correspondence) \
+  num_threads(threads_) \
+  schedule(dynamic, 1)
+    for (std::ptrdiff_t i = 0; i < nr_pairs; i++)
     {
-      correspondence_estimations_[i]->setInputSource (inputs_transformed[i]);
+      correspondence_estimations[i]->setInputSource (inputs_transformed[i]);
       // Get blob data if needed
-      if (correspondence_estimations_[i]->requiresSourceNormals ())
+      if (correspondence_estimations[i]->requiresSourceNormals ())
       {
         PCLPointCloud2::Ptr input_transformed_blob (new PCLPointCloud2);
         toPCLPointCloud2 (*inputs_transformed[i], *input_transformed_blob);
-        correspondence_estimations_[i]->setSourceNormals (input_transformed_blob);
+        correspondence_estimations[i]->setSourceNormals (input_transformed_blob);
       }
 
       // Estimate correspondences on each cloud pair separately
-      if (use_reciprocal_correspondence_)
+      if (use_reciprocal_correspondence)
       {
-        correspondence_estimations_[i]->determineReciprocalCorrespondences (*partial_correspondences_[i], corr_dist_threshold_);
+        correspondence_estimations[i]->determineReciprocalCorrespondences (*partial_correspondences_[i], corr_dist_threshold);
       }
       else
       {
-        correspondence_estimations_[i]->determineCorrespondences (*partial_correspondences_[i], corr_dist_threshold_);
+        correspondence_estimations[i]->determineCorrespondences (*partial_correspondences_[i], corr_dist_threshold);
       }
+    }
+
+    for (std::size_t i = 0; i < correspondence_estimations_.size (); i++)
+    {
       PCL_DEBUG ("[pcl::%s::computeTransformation] Found %d partial correspondences for cloud [%d]\n",
           getClassName ().c_str (),
           partial_correspondences_[i]->size (), i);
@@ -239,7 +270,12 @@ JointIterativeClosestPoint<PointSource, PointTarget, Scalar>::computeTransformat
     // Transform the combined data
     this->transformCloud (*inputs_transformed_combined, *inputs_transformed_combined, transformation_);
     // And all its components
-    for (std::size_t i = 0; i < sources_.size (); i++)
+    const std::ptrdiff_t nr_sources = static_cast<std::ptrdiff_t> (sources_.size ());
+#pragma omp parallel for \
+  default(none) \
+  shared(inputs_transformed, nr_sources) \
+  num_threads(threads_)
+    for (std::ptrdiff_t i = 0; i < nr_sources; i++)
     {
       this->transformCloud (*inputs_transformed[i], *inputs_transformed[i], transformation_);
     }
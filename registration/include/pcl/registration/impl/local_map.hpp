@@ -0,0 +1,154 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved
+ */
+
+#ifndef PCL_REGISTRATION_IMPL_LOCAL_MAP_HPP_
+#define PCL_REGISTRATION_IMPL_LOCAL_MAP_HPP_
+
+#include <pcl/common/point_tests.h>
+
+#include <algorithm>
+
+namespace pcl
+{
+
+namespace registration
+{
+
+template <typename PointT>
+LocalMap<PointT>::LocalMap ()
+  : tree_ (new IncrementalTree)
+  , resolution_ (0.0f)
+  , max_keyframes_ (10)
+  , max_distance_ (0.0f)
+  , keyframe_distance_ (1.0f)
+  , keyframe_angle_ (0.2f)
+{
+  search_.reset (new Search (tree_));
+}
+
+
+template <typename PointT> template <typename Scalar> bool
+LocalMap<PointT>::update (const PointCloud &cloud, const Eigen::Matrix<Scalar, 4, 4> &pose)
+{
+  const Eigen::Matrix4f pose_f = pose.template cast<float> ();
+  const Eigen::Vector3f position = pose_f.template block<3, 1> (0, 3);
+  bool is_keyframe = keyframes_.empty ();
+  if (!is_keyframe)
+  {
+    const Keyframe &last = keyframes_.back ();
+    const Eigen::Quaternionf orientation (Eigen::Matrix3f (pose_f.template topLeftCorner<3, 3> ()));
+    is_keyframe = (position - last.position).norm () >= keyframe_distance_ ||
+                  last.orientation.angularDistance (orientation) >= keyframe_angle_;
+  }
+
+  if (is_keyframe)
+    addKeyframe (cloud, pose);
+  else
+    removeKeyframes (position);
+  return (is_keyframe);
+}
+
+
+template <typename PointT> template <typename Scalar> void
+LocalMap<PointT>::addKeyframe (const PointCloud &cloud, const Eigen::Matrix<Scalar, 4, 4> &pose)
+{
+  const Eigen::Matrix4f pose_f = pose.template cast<float> ();
+  Keyframe keyframe;
+  keyframe.position = pose_f.template block<3, 1> (0, 3);
+  keyframe.orientation = Eigen::Quaternionf (Eigen::Matrix3f (pose_f.template topLeftCorner<3, 3> ())).normalized ();
+
+  PointCloud transformed;
+  transformScan (cloud, transformed, pose);
+
+  // Keep the first point of every voxel not yet occupied by the map
+  if (resolution_ > 0.0f)
+  {
+    std::size_t nr_points = 0;
+    for (const auto &point : transformed)
+      if (isFinite (point) && occupied_voxels_.insert (getVoxelKey (point)).second)
+        transformed[nr_points++] = point;
+    transformed.resize (nr_points);
+  }
+
+  tree_->addPoints (transformed, keyframe.point_indices);
+  keyframe.point_indices.erase (std::remove (keyframe.point_indices.begin (), keyframe.point_indices.end (), UNAVAILABLE),
+                                keyframe.point_indices.end ());
+  keyframes_.push_back (keyframe);
+
+  removeKeyframes (keyframe.position);
+}
+
+
+template <typename PointT> void
+LocalMap<PointT>::clear ()
+{
+  // The tree is emptied in place, the registrations keep searching it through search_
+  tree_->setInputCloud (PointCloudConstPtr (new PointCloud));
+  keyframes_.clear ();
+  occupied_voxels_.clear ();
+}
+
+
+template <typename PointT> void
+LocalMap<PointT>::getMapCloud (PointCloud &cloud) const
+{
+  cloud.clear ();
+  const PointCloudConstPtr map_cloud = tree_->getInputCloud ();
+  for (const auto &keyframe : keyframes_)
+    for (const auto &index : keyframe.point_indices)
+      cloud.push_back ((*map_cloud)[index]);
+}
+
+
+template <typename PointT> template <typename PointSource, typename Scalar> void
+LocalMap<PointT>::assignTo (Registration<PointSource, PointT, Scalar> &reg) const
+{
+  reg.setInputTarget (tree_->getInputCloud ());
+  reg.setSearchMethodTarget (search_, true);
+}
+
+
+template <typename PointT> void
+LocalMap<PointT>::removeKeyframe (std::size_t keyframe)
+{
+  const Indices &point_indices = keyframes_[keyframe].point_indices;
+  if (resolution_ > 0.0f)
+  {
+    const PointCloudConstPtr map_cloud = tree_->getInputCloud ();
+    for (const auto &index : point_indices)
+      occupied_voxels_.erase (getVoxelKey ((*map_cloud)[index]));
+  }
+  tree_->removePoints (point_indices);
+  keyframes_.erase (keyframes_.begin () + keyframe);
+}
+
+
+template <typename PointT> void
+LocalMap<PointT>::removeKeyframes (const Eigen::Vector3f &position)
+{
+  while (max_keyframes_ > 0 && keyframes_.size () > max_keyframes_)
+    removeKeyframe (0);
+
+  if (max_distance_ > 0.0f)
+  {
+    for (std::size_t keyframe = 0; keyframe + 1 < keyframes_.size (); )
+    {
+      if ((keyframes_[keyframe].position - position).norm () > max_distance_)
+        removeKeyframe (keyframe);
+      else
+        ++keyframe;
+    }
+  }
+}
+
+} // namespace registration
+
+} // namespace pcl
+
+#endif // PCL_REGISTRATION_IMPL_LOCAL_MAP_HPP_
@@ -41,8 +41,16 @@
 #ifndef PCL_REGISTRATION_IMPL_LUM_HPP_
 #define PCL_REGISTRATION_IMPL_LUM_HPP_
 
+#include <Eigen/Sparse>
+#include <Eigen/SparseQR>
+
+#include <algorithm>
 #include <tuple>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 
 namespace pcl
 {
@@ -99,6 +107,20 @@ LUM<PointT>::getConvergenceThreshold () const
 }
 
 
+template<typename PointT> void
+LUM<PointT>::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs ();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
+
+
 template<typename PointT> typename LUM<PointT>::Vertex
 LUM<PointT>::addPointCloud (const PointCloudPtr &cloud, const Eigen::Vector6f &pose)
 {
@@ -222,45 +244,95 @@ LUM<PointT>::compute ()
     PCL_ERROR("[pcl::registration::LUM::compute] The slam graph needs at least 2 vertices.\n");
     return;
   }
+  typename SLAMGraph::edge_iterator e, e_end;
+  std::vector<Edge> graph_edges;
+  for (std::tie (e, e_end) = edges (*slam_graph_); e != e_end; ++e)
+    graph_edges.push_back (*e);
+
+  using SparseMatrix = Eigen::SparseMatrix<float>;
+  using Neighbor = std::pair<int, std::pair<Edge, bool> >;
+  std::vector<Eigen::Triplet<float> > triplets;
+  std::vector<Neighbor> neighbors;
+
   for (int i = 0; i < max_iterations_; ++i)
   {
     // Linearized computation of C^-1 and C^-1*D and convergence checking for all edges in the graph (results stored in slam_graph_)
-    typename SLAMGraph::edge_iterator e, e_end;
-    for (std::tie (e, e_end) = edges (*slam_graph_); e != e_end; ++e)
-      computeEdge (*e);
-
-    // Declare matrices G and B
-    Eigen::MatrixXf G = Eigen::MatrixXf::Zero (6 * (n - 1), 6 * (n - 1));
+    // The edges only write their own properties
+#pragma omp parallel for \
+  default(none) \
+  shared(graph_edges) \
+  num_threads(threads_) \
+  schedule(dynamic)
+    for (std::ptrdiff_t ei = 0; ei < static_cast<std::ptrdiff_t> (graph_edges.size ()); ++ei)
+      computeEdge (graph_edges[ei]);
+
+    // Assemble the sparse matrix G and the vector B, G has a 6x6 block for every vertex and for every pair of
+    // vertices joined by an edge
     Eigen::VectorXf B = Eigen::VectorXf::Zero (6 * (n - 1));
+    triplets.clear ();
+    bool symmetric = true;
 
     // Start at 1 because 0 is the reference pose
     for (int vi = 1; vi != n; ++vi)
     {
-      for (int vj = 0; vj != n; ++vj)
+      // Use the forward edge to a neighbor, otherwise the backward edge, and sum them in the order of the neighbors
+      neighbors.clear ();
+      typename SLAMGraph::out_edge_iterator oe, oe_end;
+      for (std::tie (oe, oe_end) = out_edges (vi, *slam_graph_); oe != oe_end; ++oe)
+        neighbors.emplace_back (static_cast<int> (target (*oe, *slam_graph_)), std::make_pair (*oe, true));
+      typename SLAMGraph::in_edge_iterator ie, ie_end;
+      for (std::tie (ie, ie_end) = in_edges (vi, *slam_graph_); ie != ie_end; ++ie)
       {
-        // Attempt to use the forward edge, otherwise use backward edge, otherwise there was no edge
-        Edge e;
-        bool present1;
-        std::tie (e, present1) = edge (vi, vj, *slam_graph_);
-        if (!present1)
-        {
-          bool present2;
-          std::tie (e, present2) = edge (vj, vi, *slam_graph_);
-          if (!present2)
-            continue;
-        }
+        const int vj = static_cast<int> (source (*ie, *slam_graph_));
+        if (edge (vi, vj, *slam_graph_).second)
+          symmetric = false;
+        else
+          neighbors.emplace_back (vj, std::make_pair (*ie, false));
+      }
+      std::sort (neighbors.begin (), neighbors.end (),
+                 [] (const Neighbor &a, const Neighbor &b) { return (a.first < b.first); });
+
+      Eigen::Matrix6f diagonal = Eigen::Matrix6f::Zero ();
+      for (const Neighbor &neighbor : neighbors)
+      {
+        const int vj = neighbor.first;
+        const EdgeProperties &edge_properties = (*slam_graph_)[neighbor.second.first];
 
         // Fill in elements of G and B
         if (vj > 0)
-          G.block (6 * (vi - 1), 6 * (vj - 1), 6, 6) = -(*slam_graph_)[e].cinv_;
-        G.block (6 * (vi - 1), 6 * (vi - 1), 6, 6) += (*slam_graph_)[e].cinv_;
-        B.segment (6 * (vi - 1), 6) += (present1 ? 1 : -1) * (*slam_graph_)[e].cinvd_;
+          for (int r = 0; r < 6; ++r)
+            for (int c = 0; c < 6; ++c)
+              triplets.emplace_back (6 * (vi - 1) + r, 6 * (vj - 1) + c, -edge_properties.cinv_ (r, c));
+        diagonal += edge_properties.cinv_;
+        B.segment (6 * (vi - 1), 6) += (neighbor.second.second ? 1 : -1) * edge_properties.cinvd_;
       }
+      for (int r = 0; r < 6; ++r)
+        for (int c = 0; c < 6; ++c)
+          triplets.emplace_back (6 * (vi - 1) + r, 6 * (vi - 1) + c, diagonal (r, c));
     }
+    SparseMatrix G (6 * (n - 1), 6 * (n - 1));
+    G.setFromTriplets (triplets.begin (), triplets.end ());
 
     // Computation of the linear equation system: GX = B
-    // TODO investigate accuracy vs. speed tradeoff and find the best solving method for our type of linear equation (sparse)
-    Eigen::VectorXf X = G.colPivHouseholderQr ().solve (B);
+    // G is symmetric positive definite unless both directions of an edge are given or parts of the graph are not
+    // connected to the reference pose, a QR decomposition solves the remaining cases
+    Eigen::VectorXf X;
+    bool solved = false;
+    if (symmetric)
+    {
+      Eigen::SimplicialLDLT<SparseMatrix> ldlt (G);
+      if (ldlt.info () == Eigen::Success)
+      {
+        X = ldlt.solve (B);
+        solved = (ldlt.info () == Eigen::Success) && X.allFinite ();
+      }
+    }
+    if (!solved)
+    {
+      G.makeCompressed ();
+      Eigen::SparseQR<SparseMatrix, Eigen::COLAMDOrdering<int> > qr (G);
+      X = qr.solve (B);
+    }
 
     // Update the poses
     float sum = 0.0;
@@ -312,6 +384,9 @@ LUM<PointT>::computeEdge (const Edge &e)
   Eigen::Vector6f target_pose = (*slam_graph_)[target (e, *slam_graph_)].pose_;
   pcl::CorrespondencesPtr corrs = (*slam_graph_)[e].corrs_;
 
+  const Eigen::Affine3f source_transformation = pcl::getTransformation (source_pose (0), source_pose (1), source_pose (2), source_pose (3), source_pose (4), source_pose (5));
+  const Eigen::Affine3f target_transformation = pcl::getTransformation (target_pose (0), target_pose (1), target_pose (2), target_pose (3), target_pose (4), target_pose (5));
+
   // Build the average and difference vectors for all correspondences
   std::vector<Eigen::Vector3f, Eigen::aligned_allocator<Eigen::Vector3f> > corrs_aver (corrs->size ());
   std::vector<Eigen::Vector3f, Eigen::aligned_allocator<Eigen::Vector3f> > corrs_diff (corrs->size ());
@@ -319,8 +394,8 @@ LUM<PointT>::computeEdge (const Edge &e)
   for (int ici = 0; ici != static_cast<int> (corrs->size ()); ++ici)  // ici = input correspondence iterator
   {
     // Compound the point pair onto the current pose
-    Eigen::Vector3f source_compounded = pcl::getTransformation (source_pose (0), source_pose (1), source_pose (2), source_pose (3), source_pose (4), source_pose (5)) * (*source_cloud)[(*corrs)[ici].index_query].getVector3fMap ();
-    Eigen::Vector3f target_compounded = pcl::getTransformation (target_pose (0), target_pose (1), target_pose (2), target_pose (3), target_pose (4), target_pose (5)) * (*target_cloud)[(*corrs)[ici].index_match].getVector3fMap ();
+    Eigen::Vector3f source_compounded = source_transformation * (*source_cloud)[(*corrs)[ici].index_query].getVector3fMap ();
+    Eigen::Vector3f target_compounded = target_transformation * (*target_cloud)[(*corrs)[ici].index_match].getVector3fMap ();
 
     // NaN points can not be passed to the remaining computational pipeline
     if (!std::isfinite (source_compounded (0)) || !std::isfinite (source_compounded (1)) || !std::isfinite (source_compounded (2)) || !std::isfinite (target_compounded (0)) || !std::isfinite (target_compounded (1)) || !std::isfinite (target_compounded (2)))
@@ -0,0 +1,153 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved
+ */
+
+#ifndef PCL_REGISTRATION_IMPL_MULTI_RESOLUTION_REGISTRATION_HPP_
+#define PCL_REGISTRATION_IMPL_MULTI_RESOLUTION_REGISTRATION_HPP_
+
+#include <pcl/common/transforms.h>
+#include <pcl/filters/voxel_grid.h>
+#include <pcl/registration/gicp.h>
+
+namespace pcl
+{
+
+namespace registration
+{
+
+template <typename PointSource, typename PointTarget, typename Scalar>
+MultiResolutionRegistration<PointSource, PointTarget, Scalar>::MultiResolutionRegistration ()
+  : final_transformation_ (Matrix4::Identity ())
+  , converged_ (false)
+{}
+
+
+template <typename PointSource, typename PointTarget, typename Scalar> void
+MultiResolutionRegistration<PointSource, PointTarget, Scalar>::addLevel (float leaf_size,
+                                                                         double max_correspondence_distance,
+                                                                         int max_iterations)
+{
+  levels_.push_back ({leaf_size, max_correspondence_distance, max_iterations});
+  source_pyramid_.clear ();
+  target_pyramid_.clear ();
+}
+
+
+template <typename PointSource, typename PointTarget, typename Scalar> void
+MultiResolutionRegistration<PointSource, PointTarget, Scalar>::clearLevels ()
+{
+  levels_.clear ();
+  source_pyramid_.clear ();
+  target_pyramid_.clear ();
+}
+
+
+template <typename PointSource, typename PointTarget, typename Scalar> void
+MultiResolutionRegistration<PointSource, PointTarget, Scalar>::setInputSource (const PointCloudSourceConstPtr &cloud)
+{
+  source_ = cloud;
+  source_pyramid_.clear ();
+}
+
+
+template <typename PointSource, typename PointTarget, typename Scalar> void
+MultiResolutionRegistration<PointSource, PointTarget, Scalar>::setInputTarget (const PointCloudTargetConstPtr &cloud)
+{
+  target_ = cloud;
+  target_pyramid_.clear ();
+}
+
+
+template <typename PointSource, typename PointTarget, typename Scalar> void
+MultiResolutionRegistration<PointSource, PointTarget, Scalar>::buildPyramids ()
+{
+  if (source_pyramid_.empty ())
+  {
+    pcl::VoxelGrid<PointSource> grid;
+    grid.setInputCloud (source_);
+    for (const Level &level : levels_)
+    {
+      if (level.leaf_size <= 0)
+      {
+        source_pyramid_.push_back (source_);
+        continue;
+      }
+      PointCloudSourcePtr cloud (new PointCloudSource);
+      grid.setLeafSize (level.leaf_size, level.leaf_size, level.leaf_size);
+      grid.filter (*cloud);
+      source_pyramid_.push_back (cloud);
+    }
+  }
+
+  if (target_pyramid_.empty ())
+  {
+    pcl::VoxelGrid<PointTarget> grid;
+    grid.setInputCloud (target_);
+    for (const Level &level : levels_)
+    {
+      PointCloudTargetConstPtr cloud = target_;
+      if (level.leaf_size > 0)
+      {
+        PointCloudTargetPtr filtered (new PointCloudTarget);
+        grid.setLeafSize (level.leaf_size, level.leaf_size, level.leaf_size);
+        grid.filter (*filtered);
+        cloud = filtered;
+      }
+      target_pyramid_.emplace_back (new PreparedTarget<PointTarget> (cloud));
+    }
+  }
+}
+
+
+template <typename PointSource, typename PointTarget, typename Scalar> bool
+MultiResolutionRegistration<PointSource, PointTarget, Scalar>::align (PointCloudSource &output, const Matrix4 &guess)
+{
+  converged_ = false;
+  if (!registration_ || !source_ || !target_ || levels_.empty ())
+  {
+    PCL_ERROR ("[pcl::registration::MultiResolutionRegistration::align] Set a registration, a source, a target and at least a level first!\n");
+    return (false);
+  }
+
+  buildPyramids ();
+
+  // The covariances of a GeneralizedIterativeClosestPoint are prepared with the target levels
+  using GICP = pcl::GeneralizedIterativeClosestPoint<PointSource, PointTarget>;
+  const shared_ptr<GICP> gicp = dynamic_pointer_cast<GICP> (registration_);
+
+  Matrix4 transformation = guess;
+  PointCloudSource level_output;
+  for (std::size_t i = 0; i < levels_.size (); ++i)
+  {
+    PreparedTarget<PointTarget> &target = *target_pyramid_[i];
+    registration_->setInputSource (source_pyramid_[i]);
+    if (gicp)
+    {
+      if (!target.getCovariances ())
+        target.computeCovariances (*gicp);
+      target.assignTo (*gicp);
+    }
+    else
+      target.assignTo (*registration_);
+    registration_->setMaxCorrespondenceDistance (levels_[i].max_correspondence_distance);
+    registration_->setMaximumIterations (levels_[i].max_iterations);
+    registration_->align (level_output, transformation);
+    transformation = registration_->getFinalTransformation ();
+  }
+
+  final_transformation_ = transformation;
+  converged_ = registration_->hasConverged ();
+  pcl::transformPointCloud (*source_, output, final_transformation_);
+  return (converged_);
+}
+
+} // namespace registration
+
+} // namespace pcl
+
+#endif // PCL_REGISTRATION_IMPL_MULTI_RESOLUTION_REGISTRATION_HPP_
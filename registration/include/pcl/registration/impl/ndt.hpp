@@ -41,6 +41,11 @@
 #ifndef PCL_REGISTRATION_NDT_IMPL_H_
 #define PCL_REGISTRATION_NDT_IMPL_H_
 
+#include <algorithm>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 namespace pcl
 {
@@ -54,6 +59,8 @@ NormalDistributionsTransform<PointSource, PointTarget>::NormalDistributionsTrans
   , gauss_d1_ ()
   , gauss_d2_ ()
   , trans_probability_ ()
+  , search_method_ (KDTREE)
+  , threads_ (1)
 {
   reg_name_ = "NormalDistributionsTransform";
 
@@ -71,6 +78,50 @@ NormalDistributionsTransform<PointSource, PointTarget>::NormalDistributionsTrans
 }
 
 
+template<typename PointSource, typename PointTarget> void
+NormalDistributionsTransform<PointSource, PointTarget>::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs ();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
+
+
+template<typename PointSource, typename PointTarget> Eigen::Matrix<int, 3, Eigen::Dynamic>
+NormalDistributionsTransform<PointSource, PointTarget>::getNeighborCellOffsets () const
+{
+  Eigen::Matrix<int, 3, Eigen::Dynamic> offsets;
+  switch (search_method_)
+  {
+    case DIRECT26:
+      offsets.resize (3, 27);
+      offsets.col (0).setZero ();
+      offsets.rightCols (26) = pcl::getAllNeighborCellIndices ();
+      break;
+    case DIRECT7:
+      offsets.setZero (3, 7);
+      offsets (0, 1) = 1;
+      offsets (0, 2) = -1;
+      offsets (1, 3) = 1;
+      offsets (1, 4) = -1;
+      offsets (2, 5) = 1;
+      offsets (2, 6) = -1;
+      break;
+    case DIRECT1:
+      offsets.setZero (3, 1);
+      break;
+    default:
+      break;
+  }
+  return (offsets);
+}
+
+
 template<typename PointSource, typename PointTarget> void
 NormalDistributionsTransform<PointSource, PointTarget>::computeTransformation (PointCloudSource &output, const Eigen::Matrix4f &guess)
 {
@@ -182,52 +233,71 @@ NormalDistributionsTransform<PointSource, PointTarget>::computeDerivatives (Eige
                                                                             Eigen::Matrix<double, 6, 1> &p,
                                                                             bool compute_hessian)
 {
-  // Original Point and Transformed Point
-  PointSource x_pt, x_trans_pt;
-  // Original Point and Transformed Point (for math)
-  Eigen::Vector3d x, x_trans;
-  // Occupied Voxel
-  TargetGridLeafConstPtr cell;
-  // Inverse Covariance of Occupied Voxel
-  Eigen::Matrix3d c_inv;
-
-  score_gradient.setZero ();
-  hessian.setZero ();
-  double score = 0;
-
   // Precompute Angular Derivatives (eq. 6.19 and 6.21)[Magnusson 2009]
   computeAngleDerivatives (p);
 
-  // Update gradient and hessian for each point, line 17 in Algorithm 2 [Magnusson 2009]
-  for (std::size_t idx = 0; idx < input_->size (); idx++)
+  // Every thread sums the contributions of a contiguous range of the points, the partial sums are added in the
+  // order of the ranges so that a single thread sums in the order of the points
+  std::size_t nr_points = input_->size ();
+  std::size_t nr_chunks = std::max<std::size_t> (1, std::min<std::size_t> (threads_, nr_points));
+  std::vector<double> chunk_score (nr_chunks, 0.);
+  std::vector<Eigen::Matrix<double, 6, 1>, Eigen::aligned_allocator<Eigen::Matrix<double, 6, 1> > >
+    chunk_gradient (nr_chunks, Eigen::Matrix<double, 6, 1>::Zero ());
+  std::vector<Eigen::Matrix<double, 6, 6>, Eigen::aligned_allocator<Eigen::Matrix<double, 6, 6> > >
+    chunk_hessian (nr_chunks, Eigen::Matrix<double, 6, 6>::Zero ());
+  Eigen::Matrix<int, 3, Eigen::Dynamic> offsets = getNeighborCellOffsets ();
+
+#pragma omp parallel for \
+  default(none) \
+  shared(chunk_gradient, chunk_hessian, chunk_score, compute_hessian, nr_chunks, nr_points, offsets, trans_cloud) \
+  num_threads(threads_)
+  for (std::ptrdiff_t chunk = 0; chunk < static_cast<std::ptrdiff_t> (nr_chunks); ++chunk)
   {
-    x_trans_pt = trans_cloud[idx];
-
-    // Find nieghbors (Radius search has been experimentally faster than direct neighbor checking.
+    const std::size_t begin = nr_points * chunk / nr_chunks;
+    const std::size_t end = nr_points * (chunk + 1) / nr_chunks;
+    // The entries of the point derivatives which do not depend on the point are set in computeTransformation
+    Eigen::Matrix<double, 3, 6> point_gradient = this->point_gradient_;
+    Eigen::Matrix<double, 18, 6> point_hessian = this->point_hessian_;
     std::vector<TargetGridLeafConstPtr> neighborhood;
     std::vector<float> distances;
-    target_cells_.radiusSearch (x_trans_pt, resolution_, neighborhood, distances);
 
-    for (typename std::vector<TargetGridLeafConstPtr>::iterator neighborhood_it = neighborhood.begin (); neighborhood_it != neighborhood.end (); ++neighborhood_it)
+    // Update gradient and hessian for each point, line 17 in Algorithm 2 [Magnusson 2009]
+    for (std::size_t idx = begin; idx < end; idx++)
     {
-      cell = *neighborhood_it;
-      x_pt = (*input_)[idx];
-      x = Eigen::Vector3d (x_pt.x, x_pt.y, x_pt.z);
+      const PointSource &x_trans_pt = trans_cloud[idx];
 
-      x_trans = Eigen::Vector3d (x_trans_pt.x, x_trans_pt.y, x_trans_pt.z);
-
-      // Denorm point, x_k' in Equations 6.12 and 6.13 [Magnusson 2009]
-      x_trans -= cell->getMean ();
-      // Uses precomputed covariance for speed.
-      c_inv = cell->getInverseCov ();
+      // Find nieghbors (Radius search has been experimentally faster than direct neighbor checking.
+      this->findNeighborCells (x_trans_pt, offsets, neighborhood, distances);
+      if (neighborhood.empty ())
+        continue;
 
+      const PointSource &x_pt = (*this->input_)[idx];
+      const Eigen::Vector3d x (x_pt.x, x_pt.y, x_pt.z);
       // Compute derivative of transform function w.r.t. transform vector, J_E and H_E in Equations 6.18 and 6.20 [Magnusson 2009]
-      computePointDerivatives (x);
-      // Update score, gradient and hessian, lines 19-21 in Algorithm 2, according to Equations 6.10, 6.12 and 6.13, respectively [Magnusson 2009]
-      score += updateDerivatives (score_gradient, hessian, x_trans, c_inv, compute_hessian);
+      this->computePointDerivatives (x, point_gradient, point_hessian);
 
+      for (const TargetGridLeafConstPtr &cell : neighborhood)
+      {
+        Eigen::Vector3d x_trans (x_trans_pt.x, x_trans_pt.y, x_trans_pt.z);
+        // Denorm point, x_k' in Equations 6.12 and 6.13 [Magnusson 2009]
+        x_trans -= cell->getMean ();
+        // Update score, gradient and hessian, lines 19-21 in Algorithm 2, according to Equations 6.10, 6.12 and 6.13, respectively [Magnusson 2009]
+        // Uses precomputed covariance for speed.
+        chunk_score[chunk] += this->updateDerivatives (chunk_gradient[chunk], chunk_hessian[chunk], point_gradient, point_hessian,
+                                                       x_trans, cell->getInverseCov (), compute_hessian);
+      }
     }
   }
+
+  score_gradient.setZero ();
+  hessian.setZero ();
+  double score = 0;
+  for (std::size_t chunk = 0; chunk < nr_chunks; ++chunk)
+  {
+    score += chunk_score[chunk];
+    score_gradient += chunk_gradient[chunk];
+    hessian += chunk_hessian[chunk];
+  }
   return (score);
 }
 
@@ -311,17 +381,27 @@ NormalDistributionsTransform<PointSource, PointTarget>::computeAngleDerivatives
 
 template<typename PointSource, typename PointTarget> void
 NormalDistributionsTransform<PointSource, PointTarget>::computePointDerivatives (Eigen::Vector3d &x, bool compute_hessian)
+{
+  computePointDerivatives (x, point_gradient_, point_hessian_, compute_hessian);
+}
+
+
+template<typename PointSource, typename PointTarget> void
+NormalDistributionsTransform<PointSource, PointTarget>::computePointDerivatives (const Eigen::Vector3d &x,
+                                                                                 Eigen::Matrix<double, 3, 6> &point_gradient,
+                                                                                 Eigen::Matrix<double, 18, 6> &point_hessian,
+                                                                                 bool compute_hessian) const
 {
   // Calculate first derivative of Transformation Equation 6.17 w.r.t. transform vector p.
   // Derivative w.r.t. ith element of transform vector corresponds to column i, Equation 6.18 and 6.19 [Magnusson 2009]
-  point_gradient_ (1, 3) = x.dot (j_ang_a_);
-  point_gradient_ (2, 3) = x.dot (j_ang_b_);
-  point_gradient_ (0, 4) = x.dot (j_ang_c_);
-  point_gradient_ (1, 4) = x.dot (j_ang_d_);
-  point_gradient_ (2, 4) = x.dot (j_ang_e_);
-  point_gradient_ (0, 5) = x.dot (j_ang_f_);
-  point_gradient_ (1, 5) = x.dot (j_ang_g_);
-  point_gradient_ (2, 5) = x.dot (j_ang_h_);
+  point_gradient (1, 3) = x.dot (j_ang_a_);
+  point_gradient (2, 3) = x.dot (j_ang_b_);
+  point_gradient (0, 4) = x.dot (j_ang_c_);
+  point_gradient (1, 4) = x.dot (j_ang_d_);
+  point_gradient (2, 4) = x.dot (j_ang_e_);
+  point_gradient (0, 5) = x.dot (j_ang_f_);
+  point_gradient (1, 5) = x.dot (j_ang_g_);
+  point_gradient (2, 5) = x.dot (j_ang_h_);
 
   if (compute_hessian)
   {
@@ -337,15 +417,15 @@ NormalDistributionsTransform<PointSource, PointTarget>::computePointDerivatives
 
     // Calculate second derivative of Transformation Equation 6.17 w.r.t. transform vector p.
     // Derivative w.r.t. ith and jth elements of transform vector corresponds to the 3x1 block matrix starting at (3i,j), Equation 6.20 and 6.21 [Magnusson 2009]
-    point_hessian_.block<3, 1>(9, 3) = a;
-    point_hessian_.block<3, 1>(12, 3) = b;
-    point_hessian_.block<3, 1>(15, 3) = c;
-    point_hessian_.block<3, 1>(9, 4) = b;
-    point_hessian_.block<3, 1>(12, 4) = d;
-    point_hessian_.block<3, 1>(15, 4) = e;
-    point_hessian_.block<3, 1>(9, 5) = c;
-    point_hessian_.block<3, 1>(12, 5) = e;
-    point_hessian_.block<3, 1>(15, 5) = f;
+    point_hessian.block<3, 1>(9, 3) = a;
+    point_hessian.block<3, 1>(12, 3) = b;
+    point_hessian.block<3, 1>(15, 3) = c;
+    point_hessian.block<3, 1>(9, 4) = b;
+    point_hessian.block<3, 1>(12, 4) = d;
+    point_hessian.block<3, 1>(15, 4) = e;
+    point_hessian.block<3, 1>(9, 5) = c;
+    point_hessian.block<3, 1>(12, 5) = e;
+    point_hessian.block<3, 1>(15, 5) = f;
   }
 }
 
@@ -355,6 +435,18 @@ NormalDistributionsTransform<PointSource, PointTarget>::updateDerivatives (Eigen
                                                                            Eigen::Matrix<double, 6, 6> &hessian,
                                                                            Eigen::Vector3d &x_trans, Eigen::Matrix3d &c_inv,
                                                                            bool compute_hessian)
+{
+  return (updateDerivatives (score_gradient, hessian, point_gradient_, point_hessian_, x_trans, c_inv, compute_hessian));
+}
+
+
+template<typename PointSource, typename PointTarget> double
+NormalDistributionsTransform<PointSource, PointTarget>::updateDerivatives (Eigen::Matrix<double, 6, 1> &score_gradient,
+                                                                           Eigen::Matrix<double, 6, 6> &hessian,
+                                                                           const Eigen::Matrix<double, 3, 6> &point_gradient,
+                                                                           const Eigen::Matrix<double, 18, 6> &point_hessian,
+                                                                           const Eigen::Vector3d &x_trans, const Eigen::Matrix3d &c_inv,
+                                                                           bool compute_hessian) const
 {
   Eigen::Vector3d cov_dxd_pi;
   // e^(-d_2/2 * (x_k - mu_k)^T Sigma_k^-1 (x_k - mu_k)) Equation 6.9 [Magnusson 2009]
@@ -375,7 +467,7 @@ NormalDistributionsTransform<PointSource, PointTarget>::updateDerivatives (Eigen
   for (int i = 0; i < 6; i++)
   {
     // Sigma_k^-1 d(T(x,p))/dpi, Reusable portion of Equation 6.12 and 6.13 [Magnusson 2009]
-    cov_dxd_pi = c_inv * point_gradient_.col (i);
+    cov_dxd_pi = c_inv * point_gradient.col (i);
 
     // Update gradient, Equation 6.12 [Magnusson 2009]
     score_gradient (i) += x_trans.dot (cov_dxd_pi) * e_x_cov_x;
@@ -385,9 +477,9 @@ NormalDistributionsTransform<PointSource, PointTarget>::updateDerivatives (Eigen
       for (Eigen::Index j = 0; j < hessian.cols (); j++)
       {
         // Update hessian, Equation 6.13 [Magnusson 2009]
-        hessian (i, j) += e_x_cov_x * (-gauss_d2_ * x_trans.dot (cov_dxd_pi) * x_trans.dot (c_inv * point_gradient_.col (j)) +
-                                    x_trans.dot (c_inv * point_hessian_.block<3, 1>(3 * i, j)) +
-                                    point_gradient_.col (j).dot (cov_dxd_pi) );
+        hessian (i, j) += e_x_cov_x * (-gauss_d2_ * x_trans.dot (cov_dxd_pi) * x_trans.dot (c_inv * point_gradient.col (j)) +
+                                    x_trans.dot (c_inv * point_hessian.block<3, 1>(3 * i, j)) +
+                                    point_gradient.col (j).dot (cov_dxd_pi) );
       }
     }
   }
@@ -400,56 +492,73 @@ template<typename PointSource, typename PointTarget> void
 NormalDistributionsTransform<PointSource, PointTarget>::computeHessian (Eigen::Matrix<double, 6, 6> &hessian,
                                                                         PointCloudSource &trans_cloud, Eigen::Matrix<double, 6, 1> &)
 {
-  // Original Point and Transformed Point
-  PointSource x_pt, x_trans_pt;
-  // Original Point and Transformed Point (for math)
-  Eigen::Vector3d x, x_trans;
-  // Occupied Voxel
-  TargetGridLeafConstPtr cell;
-  // Inverse Covariance of Occupied Voxel
-  Eigen::Matrix3d c_inv;
-
-  hessian.setZero ();
-
   // Precompute Angular Derivatives unessisary because only used after regular derivative calculation
 
-  // Update hessian for each point, line 17 in Algorithm 2 [Magnusson 2009]
-  for (std::size_t idx = 0; idx < input_->size (); idx++)
+  // The partial sums are added as in computeDerivatives
+  std::size_t nr_points = input_->size ();
+  std::size_t nr_chunks = std::max<std::size_t> (1, std::min<std::size_t> (threads_, nr_points));
+  std::vector<Eigen::Matrix<double, 6, 6>, Eigen::aligned_allocator<Eigen::Matrix<double, 6, 6> > >
+    chunk_hessian (nr_chunks, Eigen::Matrix<double, 6, 6>::Zero ());
+  Eigen::Matrix<int, 3, Eigen::Dynamic> offsets = getNeighborCellOffsets ();
+
+#pragma omp parallel for \
+  default(none) \
+  shared(chunk_hessian, nr_chunks, nr_points, offsets, trans_cloud) \
+  num_threads(threads_)
+  for (std::ptrdiff_t chunk = 0; chunk < static_cast<std::ptrdiff_t> (nr_chunks); ++chunk)
   {
-    x_trans_pt = trans_cloud[idx];
-
-    // Find nieghbors (Radius search has been experimentally faster than direct neighbor checking.
+    const std::size_t begin = nr_points * chunk / nr_chunks;
+    const std::size_t end = nr_points * (chunk + 1) / nr_chunks;
+    Eigen::Matrix<double, 3, 6> point_gradient = this->point_gradient_;
+    Eigen::Matrix<double, 18, 6> point_hessian = this->point_hessian_;
     std::vector<TargetGridLeafConstPtr> neighborhood;
     std::vector<float> distances;
-    target_cells_.radiusSearch (x_trans_pt, resolution_, neighborhood, distances);
 
-    for (typename std::vector<TargetGridLeafConstPtr>::iterator neighborhood_it = neighborhood.begin (); neighborhood_it != neighborhood.end (); ++neighborhood_it)
+    // Update hessian for each point, line 17 in Algorithm 2 [Magnusson 2009]
+    for (std::size_t idx = begin; idx < end; idx++)
     {
-      cell = *neighborhood_it;
+      const PointSource &x_trans_pt = trans_cloud[idx];
 
-      {
-        x_pt = (*input_)[idx];
-        x = Eigen::Vector3d (x_pt.x, x_pt.y, x_pt.z);
+      // Find nieghbors (Radius search has been experimentally faster than direct neighbor checking.
+      this->findNeighborCells (x_trans_pt, offsets, neighborhood, distances);
+      if (neighborhood.empty ())
+        continue;
 
-        x_trans = Eigen::Vector3d (x_trans_pt.x, x_trans_pt.y, x_trans_pt.z);
+      const PointSource &x_pt = (*this->input_)[idx];
+      const Eigen::Vector3d x (x_pt.x, x_pt.y, x_pt.z);
+      // Compute derivative of transform function w.r.t. transform vector, J_E and H_E in Equations 6.18 and 6.20 [Magnusson 2009]
+      this->computePointDerivatives (x, point_gradient, point_hessian);
 
+      for (const TargetGridLeafConstPtr &cell : neighborhood)
+      {
+        Eigen::Vector3d x_trans (x_trans_pt.x, x_trans_pt.y, x_trans_pt.z);
         // Denorm point, x_k' in Equations 6.12 and 6.13 [Magnusson 2009]
         x_trans -= cell->getMean ();
-        // Uses precomputed covariance for speed.
-        c_inv = cell->getInverseCov ();
-
-        // Compute derivative of transform function w.r.t. transform vector, J_E and H_E in Equations 6.18 and 6.20 [Magnusson 2009]
-        computePointDerivatives (x);
         // Update hessian, lines 21 in Algorithm 2, according to Equations 6.10, 6.12 and 6.13, respectively [Magnusson 2009]
-        updateHessian (hessian, x_trans, c_inv);
+        // Uses precomputed covariance for speed.
+        this->updateHessian (chunk_hessian[chunk], point_gradient, point_hessian, x_trans, cell->getInverseCov ());
       }
     }
   }
+
+  hessian.setZero ();
+  for (std::size_t chunk = 0; chunk < nr_chunks; ++chunk)
+    hessian += chunk_hessian[chunk];
 }
 
 
 template<typename PointSource, typename PointTarget> void
 NormalDistributionsTransform<PointSource, PointTarget>::updateHessian (Eigen::Matrix<double, 6, 6> &hessian, Eigen::Vector3d &x_trans, Eigen::Matrix3d &c_inv)
+{
+  updateHessian (hessian, point_gradient_, point_hessian_, x_trans, c_inv);
+}
+
+
+template<typename PointSource, typename PointTarget> void
+NormalDistributionsTransform<PointSource, PointTarget>::updateHessian (Eigen::Matrix<double, 6, 6> &hessian,
+                                                                       const Eigen::Matrix<double, 3, 6> &point_gradient,
+                                                                       const Eigen::Matrix<double, 18, 6> &point_hessian,
+                                                                       const Eigen::Vector3d &x_trans, const Eigen::Matrix3d &c_inv) const
 {
   Eigen::Vector3d cov_dxd_pi;
   // e^(-d_2/2 * (x_k - mu_k)^T Sigma_k^-1 (x_k - mu_k)) Equation 6.9 [Magnusson 2009]
@@ -465,14 +574,14 @@ NormalDistributionsTransform<PointSource, PointTarget>::updateHessian (Eigen::Ma
   for (int i = 0; i < 6; i++)
   {
     // Sigma_k^-1 d(T(x,p))/dpi, Reusable portion of Equation 6.12 and 6.13 [Magnusson 2009]
-    cov_dxd_pi = c_inv * point_gradient_.col (i);
+    cov_dxd_pi = c_inv * point_gradient.col (i);
 
     for (Eigen::Index j = 0; j < hessian.cols (); j++)
     {
       // Update hessian, Equation 6.13 [Magnusson 2009]
-      hessian (i, j) += e_x_cov_x * (-gauss_d2_ * x_trans.dot (cov_dxd_pi) * x_trans.dot (c_inv * point_gradient_.col (j)) +
-                                  x_trans.dot (c_inv * point_hessian_.block<3, 1>(3 * i, j)) +
-                                  point_gradient_.col (j).dot (cov_dxd_pi) );
+      hessian (i, j) += e_x_cov_x * (-gauss_d2_ * x_trans.dot (cov_dxd_pi) * x_trans.dot (c_inv * point_gradient.col (j)) +
+                                  x_trans.dot (c_inv * point_hessian.block<3, 1>(3 * i, j)) +
+                                  point_gradient.col (j).dot (cov_dxd_pi) );
     }
   }
 
@@ -44,9 +44,14 @@
 #include <pcl/registration/eigen.h>
 #include <pcl/registration/boost.h>
 
+#include <algorithm>
 #include <cmath>
 #include <memory>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace pcl
 {
 
@@ -315,18 +320,23 @@ public:
     * \param[in] about Centre of the grid for normal distributions model
     * \param[in] extent Extent of grid for normal distributions model
     * \param[in] step Size of region that each normal distribution will model
+    * \param[in] nr_threads the number of threads building the four grids
     */
   NDT2D (PointCloudConstPtr cloud,
        const Eigen::Vector2f& about,
        const Eigen::Vector2f& extent,
-       const Eigen::Vector2f& step)
+       const Eigen::Vector2f& step,
+       unsigned int nr_threads = 1)
   {
-    Eigen::Vector2f dx (step[0]/2, 0);
-    Eigen::Vector2f dy (0, step[1]/2);
-    single_grids_[0].reset(new SingleGrid (cloud, about,        extent, step));
-    single_grids_[1].reset(new SingleGrid (cloud, about +dx,    extent, step));
-    single_grids_[2].reset(new SingleGrid (cloud, about +dy,    extent, step));
-    single_grids_[3].reset(new SingleGrid (cloud, about +dx+dy, extent, step));
+    const Eigen::Vector2f dx (step[0]/2, 0);
+    const Eigen::Vector2f dy (0, step[1]/2);
+    const Eigen::Vector2f centres[4] = {about, about + dx, about + dy, about + dx + dy};
+#pragma omp parallel for \
+  default(none) \
+  shared(centres, cloud, extent, step) \
+  num_threads(std::min (nr_threads, 4u))
+    for (int i = 0; i < 4; i++)
+      single_grids_[i].reset (new SingleGrid (cloud, centres[i], extent, step));
   }
 
   /** \brief Return the 'score' (denormalised likelihood) and derivatives of score of the point p given this distribution.
@@ -381,6 +391,19 @@ struct NumTraits<pcl::ndt2d::NormalDist<PointT> >
 namespace pcl
 {
 
+template <typename PointSource, typename PointTarget> void
+NormalDistributionsTransform2D<PointSource, PointTarget>::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs ();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
+
 template <typename PointSource, typename PointTarget> void
 NormalDistributionsTransform2D<PointSource, PointTarget>::computeTransformation (PointCloudSource &output, const Eigen::Matrix4f &guess)
 {
@@ -396,7 +419,7 @@ NormalDistributionsTransform2D<PointSource, PointTarget>::computeTransformation
   }
 
   // build Normal Distribution Transform of target cloud:
-  ndt2d::NDT2D<PointTarget> target_ndt (target_, grid_centre_, grid_extent_, grid_step_);
+  ndt2d::NDT2D<PointTarget> target_ndt (target_, grid_centre_, grid_extent_, grid_step_, threads_);
 
   // can't seem to use .block<> () member function on transformation_
   // directly... gcc bug?
@@ -421,9 +444,25 @@ NormalDistributionsTransform2D<PointSource, PointTarget>::computeTransformation
     const double sin_theta = std::sin (xytheta_transformation[2]);
     previous_transformation_ = transformation;
 
+    // Every thread sums the contributions of a contiguous range of the points, the partial sums are added in the
+    // order of the ranges so that a single thread sums in the order of the points
+    const std::size_t nr_points = intm_cloud.size ();
+    const std::size_t nr_chunks = std::max<std::size_t> (1, std::min<std::size_t> (threads_, nr_points));
+    std::vector<ndt2d::ValueAndDerivatives<3, double> > chunk_score (nr_chunks, ndt2d::ValueAndDerivatives<3, double>::Zero ());
+#pragma omp parallel for \
+  default(none) \
+  shared(chunk_score, cos_theta, intm_cloud, nr_chunks, nr_points, sin_theta, target_ndt) \
+  num_threads(threads_)
+    for (std::ptrdiff_t chunk = 0; chunk < static_cast<std::ptrdiff_t> (nr_chunks); ++chunk)
+    {
+      const std::size_t begin = nr_points * chunk / nr_chunks;
+      const std::size_t end = nr_points * (chunk + 1) / nr_chunks;
+      for (std::size_t i = begin; i < end; i++)
+        chunk_score[chunk] += target_ndt.test (intm_cloud[i], cos_theta, sin_theta);
+    }
     ndt2d::ValueAndDerivatives<3, double> score = ndt2d::ValueAndDerivatives<3, double>::Zero ();
-    for (std::size_t i = 0; i < intm_cloud.size (); i++)
-      score += target_ndt.test (intm_cloud[i], cos_theta, sin_theta);
+    for (const auto &partial_score : chunk_score)
+      score += partial_score;
 
     PCL_DEBUG ("[pcl::NormalDistributionsTransform2D::computeTransformation] NDT score %f (x=%f,y=%f,r=%f)\n",
       float (score.value), xytheta_transformation[0], xytheta_transformation[1], xytheta_transformation[2]
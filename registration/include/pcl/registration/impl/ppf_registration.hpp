@@ -48,6 +48,25 @@
 #include <pcl/common/transforms.h>
 
 #include <pcl/features/pfh.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointSource, typename PointTarget> void
+pcl::PPFRegistration<PointSource, PointTarget>::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs ();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointSource, typename PointTarget> void
 pcl::PPFRegistration<PointSource, PointTarget>::setInputTarget (const PointCloudTargetConstPtr &cloud)
@@ -73,19 +92,29 @@ pcl::PPFRegistration<PointSource, PointTarget>::computeTransformation (PointClou
     PCL_ERROR("[pcl::PPFRegistration::computeTransformation] setting initial transform (guess) not implemented!\n");
   }
 
-  const auto aux_size = static_cast<std::size_t>(
+  std::size_t aux_size = static_cast<std::size_t>(
       std::floor(2 * M_PI / search_method_->getAngleDiscretizationStep()));
 
-  const std::vector<unsigned int> tmp_vec(aux_size, 0);
-  std::vector<std::vector<unsigned int>> accumulator_array(input_->size(), tmp_vec);
+  // The accumulator array is flattened, row model_reference_index holds the votes of the aux_size angles; every
+  // thread gets its own copy
+  std::vector<unsigned int> accumulator_array (input_->size () * aux_size, 0);
 
-  PCL_INFO ("Accumulator array size: %u x %u.\n", accumulator_array.size (), accumulator_array.back ().size ());
+  PCL_INFO ("Accumulator array size: %u x %u.\n", input_->size (), aux_size);
 
-  PoseWithVotesList voted_poses;
   // Consider every <scene_reference_point_sampling_rate>-th point as the reference point => fix s_r
-  float f1, f2, f3, f4;
-  for (std::size_t scene_reference_index = 0; scene_reference_index < target_->size (); scene_reference_index += scene_reference_point_sampling_rate_)
+  // The poses are stored by reference point and listed afterwards in the order of the serial voting
+  const std::size_t nr_scene_reference_points = (target_->size () + scene_reference_point_sampling_rate_ - 1) / scene_reference_point_sampling_rate_;
+  std::vector<Eigen::Affine3f, Eigen::aligned_allocator<Eigen::Affine3f> > reference_poses (nr_scene_reference_points);
+  std::vector<unsigned int> reference_votes (nr_scene_reference_points);
+#pragma omp parallel for \
+  default(none) \
+  shared(aux_size, nr_scene_reference_points, reference_poses, reference_votes) \
+  firstprivate(accumulator_array) \
+  num_threads(threads_) \
+  schedule(dynamic)
+  for (std::ptrdiff_t reference_i = 0; reference_i < static_cast<std::ptrdiff_t> (nr_scene_reference_points); ++reference_i)
   {
+    const std::size_t scene_reference_index = reference_i * scene_reference_point_sampling_rate_;
     Eigen::Vector3f scene_reference_point = (*target_)[scene_reference_index].getVector3fMap (),
         scene_reference_normal = (*target_)[scene_reference_index].getNormalVector3fMap ();
 
@@ -102,19 +131,18 @@ pcl::PPFRegistration<PointSource, PointTarget>::computeTransformation (PointClou
                                      search_method_->getModelDiameter () /2,
                                      indices,
                                      distances);
-    for(const std::size_t &scene_point_index : indices)
-//    for(std::size_t i = 0; i < target_->size (); ++i)
+    std::vector<std::pair<std::size_t, std::size_t> > nearest_indices;
+    for (const std::size_t scene_point_index : indices)
     {
-      //size_t scene_point_index = i;
       if (scene_reference_index != scene_point_index)
       {
+        float f1, f2, f3, f4;
         if (/*pcl::computePPFPairFeature*/pcl::computePairFeatures ((*target_)[scene_reference_index].getVector4fMap (),
                                         (*target_)[scene_reference_index].getNormalVector4fMap (),
                                         (*target_)[scene_point_index].getVector4fMap (),
                                         (*target_)[scene_point_index].getNormalVector4fMap (),
                                         f1, f2, f3, f4))
         {
-          std::vector<std::pair<std::size_t, std::size_t> > nearest_indices;
           search_method_->nearestNeighborSearch (f1, f2, f3, f4, nearest_indices);
 
           // Compute alpha_s angle
@@ -134,28 +162,27 @@ pcl::PPFRegistration<PointSource, PointTarget>::computeTransformation (PointClou
             // Calculate angle alpha = alpha_m - alpha_s
             float alpha = search_method_->alpha_m_[model_reference_index][model_point_index] - alpha_s;
             unsigned int alpha_discretized = static_cast<unsigned int> (std::floor (alpha) + std::floor (M_PI / search_method_->getAngleDiscretizationStep ()));
-            accumulator_array[model_reference_index][alpha_discretized] ++;
+            accumulator_array[model_reference_index * aux_size + alpha_discretized] ++;
           }
         }
         else PCL_ERROR ("[pcl::PPFRegistration::computeTransformation] Computing pair feature vector between points %u and %u went wrong.\n", scene_reference_index, scene_point_index);
       }
     }
 
-    std::size_t max_votes_i = 0, max_votes_j = 0;
+    std::size_t max_votes_index = 0;
     unsigned int max_votes = 0;
 
     for (std::size_t i = 0; i < accumulator_array.size (); ++i)
-      for (std::size_t j = 0; j < accumulator_array.back ().size (); ++j)
+    {
+      if (accumulator_array[i] > max_votes)
       {
-        if (accumulator_array[i][j] > max_votes)
-        {
-          max_votes = accumulator_array[i][j];
-          max_votes_i = i;
-          max_votes_j = j;
-        }
-        // Reset accumulator_array for the next set of iterations with a new scene reference point
-        accumulator_array[i][j] = 0;
+        max_votes = accumulator_array[i];
+        max_votes_index = i;
       }
+      // Reset accumulator_array for the next set of iterations with a new scene reference point
+      accumulator_array[i] = 0;
+    }
+    const std::size_t max_votes_i = max_votes_index / aux_size, max_votes_j = max_votes_index % aux_size;
 
     Eigen::Vector3f model_reference_point = (*input_)[max_votes_i].getVector3fMap (),
         model_reference_normal = (*input_)[max_votes_i].getNormalVector3fMap ();
@@ -164,13 +191,17 @@ pcl::PPFRegistration<PointSource, PointTarget>::computeTransformation (PointClou
     Eigen::Vector3f rotation_axis_mg = (parallel_to_x_mg)?(Eigen::Vector3f::UnitY ()):(model_reference_normal.cross (Eigen::Vector3f::UnitX ()). normalized());
     Eigen::AngleAxisf rotation_mg (rotation_angle_mg, rotation_axis_mg);
     Eigen::Affine3f transform_mg (Eigen::Translation3f ( rotation_mg * ((-1) * model_reference_point)) * rotation_mg);
-    Eigen::Affine3f max_transform = 
+    reference_poses[reference_i] =
       transform_sg.inverse () * 
       Eigen::AngleAxisf ((static_cast<float> (max_votes_j) - std::floor (static_cast<float> (M_PI) / search_method_->getAngleDiscretizationStep ())) * search_method_->getAngleDiscretizationStep (), Eigen::Vector3f::UnitX ()) * 
       transform_mg;
-
-    voted_poses.push_back (PoseWithVotes (max_transform, max_votes));
+    reference_votes[reference_i] = max_votes;
   }
+
+  PoseWithVotesList voted_poses;
+  voted_poses.reserve (nr_scene_reference_points);
+  for (std::size_t reference_i = 0; reference_i < nr_scene_reference_points; ++reference_i)
+    voted_poses.push_back (PoseWithVotes (reference_poses[reference_i], reference_votes[reference_i]));
   PCL_DEBUG ("Done with the Hough Transform ...\n");
 
   // Cluster poses for filtering out outliers and obtaining more precise results
@@ -0,0 +1,81 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved
+ */
+
+#ifndef PCL_REGISTRATION_IMPL_PREPARED_TARGET_HPP_
+#define PCL_REGISTRATION_IMPL_PREPARED_TARGET_HPP_
+
+namespace pcl
+{
+
+namespace registration
+{
+
+template <typename PointTarget>
+PreparedTarget<PointTarget>::PreparedTarget (const PointCloudTargetConstPtr &target, const KdTreePtr &tree)
+  : target_ (target)
+  , tree_ (tree ? tree : KdTreePtr (new KdTree))
+{
+  tree_->setInputCloud (target_);
+}
+
+
+template <typename PointTarget> template <typename PointSource> void
+PreparedTarget<PointTarget>::computeCovariances (const GeneralizedIterativeClosestPoint<PointSource, PointTarget> &gicp)
+{
+  MatricesVectorPtr covariances (new MatricesVector);
+  gicp.template computeCovariances<PointTarget> (target_, tree_, *covariances);
+  covariances_ = covariances;
+}
+
+
+template <typename PointTarget> void
+PreparedTarget<PointTarget>::computeCells (float resolution)
+{
+  shared_ptr<TargetGrid> cells (new TargetGrid);
+  cells->setLeafSize (resolution, resolution, resolution);
+  cells->setInputCloud (target_);
+  cells->filter (true);
+  cells_ = cells;
+}
+
+
+template <typename PointTarget> template <typename PointSource, typename Scalar> void
+PreparedTarget<PointTarget>::assignTo (Registration<PointSource, PointTarget, Scalar> &reg) const
+{
+  reg.setInputTarget (target_);
+  reg.setSearchMethodTarget (tree_, true);
+}
+
+
+template <typename PointTarget> template <typename PointSource> void
+PreparedTarget<PointTarget>::assignTo (GeneralizedIterativeClosestPoint<PointSource, PointTarget> &reg) const
+{
+  // setInputTarget resets the covariances of the registration
+  reg.setInputTarget (target_);
+  reg.setSearchMethodTarget (tree_, true);
+  if (covariances_)
+    reg.setTargetCovariances (covariances_);
+}
+
+
+template <typename PointTarget> template <typename PointSource> void
+PreparedTarget<PointTarget>::assignTo (NormalDistributionsTransform<PointSource, PointTarget> &reg) const
+{
+  if (cells_)
+    reg.setInputTarget (target_, cells_);
+  else
+    reg.setInputTarget (target_);
+  reg.setSearchMethodTarget (tree_, true);
+}
+
+} // namespace registration
+
+} // namespace pcl
+
+#endif // PCL_REGISTRATION_IMPL_PREPARED_TARGET_HPP_
@@ -161,6 +161,7 @@ Registration<PointSource, PointTarget, Scalar>::align (PointCloudSource &output)
 template <typename PointSource, typename PointTarget, typename Scalar> inline void
 Registration<PointSource, PointTarget, Scalar>::align (PointCloudSource &output, const Matrix4& guess)
 {
+  PCL_INSTRUMENT_SCOPE (getClassName ());
   if (!initCompute ())
     return;
 
@@ -199,6 +200,7 @@ Registration<PointSource, PointTarget, Scalar>::align (PointCloudSource &output,
     output[i].data[3] = 1.0;
 
   computeTransformation (output, guess);
+  PCL_INSTRUMENT_COUNT (getClassName () + ".iterations", nr_iterations_);
 
   deinitCompute ();
 }
@@ -41,6 +41,9 @@
 #ifndef PCL_REGISTRATION_SAMPLE_CONSENSUS_PREREJECTIVE_HPP_
 #define PCL_REGISTRATION_SAMPLE_CONSENSUS_PREREJECTIVE_HPP_
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 namespace pcl
 {
@@ -70,9 +73,23 @@ SampleConsensusPrerejective<PointSource, PointTarget, FeatureT>::setTargetFeatur
 }
 
 
+template <typename PointSource, typename PointTarget, typename FeatureT> void
+SampleConsensusPrerejective<PointSource, PointTarget, FeatureT>::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs ();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
+
+
 template <typename PointSource, typename PointTarget, typename FeatureT> void
 SampleConsensusPrerejective<PointSource, PointTarget, FeatureT>::selectSamples (
-    const PointCloudSource &cloud, int nr_samples, std::vector<int> &sample_indices)
+    const PointCloudSource &cloud, int nr_samples, std::vector<int> &sample_indices, std::mt19937 &rng)
 {
   if (nr_samples > static_cast<int> (cloud.size ()))
   {
@@ -91,7 +108,7 @@ SampleConsensusPrerejective<PointSource, PointTarget, FeatureT>::selectSamples (
   for (int i = 0; i < nr_samples; i++)
   {
     // Select a random number
-    sample_indices[i] = getRandomIndex (static_cast<int> (cloud.size ()) - i);
+    sample_indices[i] = getRandomIndex (static_cast<int> (cloud.size ()) - i, rng);
 
     // Run trough list of numbers, starting at the lowest, to avoid duplicates
     for (int j = 0; j < i; j++)
@@ -120,7 +137,8 @@ template <typename PointSource, typename PointTarget, typename FeatureT> void
 SampleConsensusPrerejective<PointSource, PointTarget, FeatureT>::findSimilarFeatures (
         const std::vector<int> &sample_indices,
         std::vector<std::vector<int> >& similar_features,
-        std::vector<int> &corresponding_indices)
+        std::vector<int> &corresponding_indices,
+        std::mt19937 &rng)
 {
   // Allocate results
   corresponding_indices.resize (sample_indices.size ());
@@ -140,7 +158,7 @@ SampleConsensusPrerejective<PointSource, PointTarget, FeatureT>::findSimilarFeat
     if (k_correspondences_ == 1)
       corresponding_indices[i] = similar_features[idx][0];
     else
-      corresponding_indices[i] = similar_features[idx][getRandomIndex (k_correspondences_)];
+      corresponding_indices[i] = similar_features[idx][getRandomIndex (k_correspondences_, rng)];
   }
 }
 
@@ -213,18 +231,16 @@ SampleConsensusPrerejective<PointSource, PointTarget, FeatureT>::computeTransfor
   final_transformation_ = guess;
   inliers_.clear ();
   float lowest_error = std::numeric_limits<float>::max ();
+  int lowest_error_iteration = -1;
   converged_ = false;
 
-  // Temporaries
-  std::vector<int> inliers;
-  float inlier_fraction;
-  float error;
-
   // If guess is not the Identity matrix we check it
   if (!guess.isApprox (Eigen::Matrix4f::Identity (), 0.01f))
   {
+    std::vector<int> inliers;
+    float error;
     getFitness (inliers, error);
-    inlier_fraction = static_cast<float> (inliers.size ()) / static_cast<float> (input_->size ());
+    const float inlier_fraction = static_cast<float> (inliers.size ()) / static_cast<float> (input_->size ());
 
     if (inlier_fraction >= inlier_fraction_ && error < lowest_error)
     {
@@ -237,51 +253,65 @@ SampleConsensusPrerejective<PointSource, PointTarget, FeatureT>::computeTransfor
   // Feature correspondence cache
   std::vector<std::vector<int> > similar_features (input_->size ());
 
-  // Start
-  for (int i = 0; i < max_iterations_; ++i)
+  // Start, each hypothesis is drawn with its own generator, so that it only depends on the seed and the iteration,
+  // and the cache is filled in a critical section
+#pragma omp parallel for \
+  default(none) \
+  shared(lowest_error, lowest_error_iteration, num_rejections, similar_features) \
+  num_threads(threads_) \
+  schedule(dynamic)
+  for (int i = 0; i < this->max_iterations_; ++i)
   {
     // Temporary containers
     std::vector<int> sample_indices;
     std::vector<int> corresponding_indices;
 
+    std::seed_seq seq {seed_, static_cast<unsigned int> (i)};
+    std::mt19937 rng (seq);
+
     // Draw nr_samples_ random samples
-    selectSamples (*input_, nr_samples_, sample_indices);
+    selectSamples (*this->input_, nr_samples_, sample_indices, rng);
 
-    // Find corresponding features in the target cloud
-    findSimilarFeatures (sample_indices, similar_features, corresponding_indices);
+#pragma omp critical(prerejective_samples)
+    {
+      // Find corresponding features in the target cloud
+      findSimilarFeatures (sample_indices, similar_features, corresponding_indices, rng);
+    }
 
     // Apply prerejection
     if (!correspondence_rejector_poly_->thresholdPolygon (sample_indices, corresponding_indices))
     {
+#pragma omp atomic
       ++num_rejections;
       continue;
     }
 
-    // Estimate the transform from the correspondences, write to transformation_
-    transformation_estimation_->estimateRigidTransformation (*input_, sample_indices, *target_, corresponding_indices, transformation_);
+    // Estimate the transform from the correspondences
+    Matrix4 transformation;
+    this->transformation_estimation_->estimateRigidTransformation (*this->input_, sample_indices, *this->target_, corresponding_indices, transformation);
 
-    // Take a backup of previous result
-    const Matrix4 final_transformation_prev = final_transformation_;
-
-    // Set final result to current transformation
-    final_transformation_ = transformation_;
-
-    // Transform the input and compute the error (uses input_ and final_transformation_)
-    getFitness (inliers, error);
-
-    // Restore previous result
-    final_transformation_ = final_transformation_prev;
+    // Transform the input and compute the error
+    std::vector<int> inliers;
+    float error;
+    getFitness (transformation, inliers, error);
 
     // If the new fit is better, update results
-    inlier_fraction = static_cast<float> (inliers.size ()) / static_cast<float> (input_->size ());
+    const float inlier_fraction = static_cast<float> (inliers.size ()) / static_cast<float> (this->input_->size ());
 
-    // Update result if pose hypothesis is better
-    if (inlier_fraction >= inlier_fraction_ && error < lowest_error)
+    // Update result if pose hypothesis is better, the first of the iterations with the same error wins whatever the
+    // order the threads finish them in
+    if (inlier_fraction >= inlier_fraction_)
     {
-      inliers_ = inliers;
-      lowest_error = error;
-      converged_ = true;
-      final_transformation_ = transformation_;
+#pragma omp critical(prerejective_update)
+      if (error < lowest_error || (error == lowest_error && i < lowest_error_iteration))
+      {
+        inliers_.swap (inliers);
+        lowest_error = error;
+        lowest_error_iteration = i;
+        this->converged_ = true;
+        this->transformation_ = transformation;
+        this->final_transformation_ = transformation;
+      }
     }
   }
 
@@ -297,6 +327,15 @@ SampleConsensusPrerejective<PointSource, PointTarget, FeatureT>::computeTransfor
 
 template <typename PointSource, typename PointTarget, typename FeatureT> void
 SampleConsensusPrerejective<PointSource, PointTarget, FeatureT>::getFitness (std::vector<int>& inliers, float& fitness_score)
+{
+  getFitness (final_transformation_, inliers, fitness_score);
+}
+
+
+template <typename PointSource, typename PointTarget, typename FeatureT> void
+SampleConsensusPrerejective<PointSource, PointTarget, FeatureT>::getFitness (const Matrix4 &transformation,
+                                                                          std::vector<int>& inliers,
+                                                                          float& fitness_score) const
 {
   // Initialize variables
   inliers.clear ();
@@ -306,17 +345,19 @@ SampleConsensusPrerejective<PointSource, PointTarget, FeatureT>::getFitness (std
   // Use squared distance for comparison with NN search results
   const float max_range = corr_dist_threshold_ * corr_dist_threshold_;
 
-  // Transform the input dataset using the final transformation
+  // Transform the input dataset using the given transformation
   PointCloudSource input_transformed;
   input_transformed.resize (input_->size ());
-  transformPointCloud (*input_, input_transformed, final_transformation_);
+  transformPointCloud (*input_, input_transformed, transformation);
 
   // For each point in the source dataset
+  std::vector<int> nn_indices (1);
+  std::vector<float> nn_dists (1);
+  const float nr_points = static_cast<float> (input_transformed.size ());
+  std::size_t nr_outliers = 0;
   for (std::size_t i = 0; i < input_transformed.size (); ++i)
   {
     // Find its nearest neighbor in the target
-    std::vector<int> nn_indices (1);
-    std::vector<float> nn_dists (1);
     tree_->nearestKSearch (input_transformed[i], 1, nn_indices, nn_dists);
 
     // Check if point is an inlier
@@ -328,6 +369,12 @@ SampleConsensusPrerejective<PointSource, PointTarget, FeatureT>::getFitness (std
       // Update fitness score
       fitness_score += nn_dists[0];
     }
+    // Stop when the inlier fraction can no longer be reached, even if all the remaining points are inliers
+    else if (static_cast<float> (input_transformed.size () - ++nr_outliers) / nr_points < inlier_fraction_)
+    {
+      fitness_score = std::numeric_limits<float>::max ();
+      return;
+    }
   }
 
   // Calculate MSE
@@ -45,6 +45,10 @@
 #include <pcl/registration/distances.h>
 #include <unsupported/Eigen/NonLinearOptimization>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 
 //////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointSource, typename PointTarget, typename MatScalar>
@@ -54,9 +58,25 @@ pcl::registration::TransformationEstimationLM<PointSource, PointTarget, MatScala
   , tmp_idx_src_ ()
   , tmp_idx_tgt_ ()
   , warp_point_ (new WarpPointRigid6D<PointSource, PointTarget, MatScalar>)
+  , use_analytic_jacobian_ (false)
+  , threads_ (1)
 {
 };
 
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointSource, typename PointTarget, typename MatScalar> void
+pcl::registration::TransformationEstimationLM<PointSource, PointTarget, MatScalar>::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs ();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointSource, typename PointTarget, typename MatScalar> void
 pcl::registration::TransformationEstimationLM<PointSource, PointTarget, MatScalar>::estimateRigidTransformation (
@@ -92,14 +112,26 @@ pcl::registration::TransformationEstimationLM<PointSource, PointTarget, MatScala
   tmp_tgt_ = &cloud_tgt;
 
   OptimizationFunctor functor (static_cast<int> (cloud_src.size ()), this);
-  Eigen::NumericalDiff<OptimizationFunctor> num_diff (functor);
-  //Eigen::LevenbergMarquardt<Eigen::NumericalDiff<OptimizationFunctor>, double> lm (num_diff);
-  Eigen::LevenbergMarquardt<Eigen::NumericalDiff<OptimizationFunctor>, MatScalar> lm (num_diff);
-  int info = lm.minimize (x);
+  int info;
+  double residual_norm;
+  if (use_analytic_jacobian_ && warp_point_->hasJacobian ())
+  {
+    Eigen::LevenbergMarquardt<OptimizationFunctor, MatScalar> lm (functor);
+    info = lm.minimize (x);
+    residual_norm = lm.fvec.norm ();
+  }
+  else
+  {
+    Eigen::NumericalDiff<OptimizationFunctor> num_diff (functor);
+    //Eigen::LevenbergMarquardt<Eigen::NumericalDiff<OptimizationFunctor>, double> lm (num_diff);
+    Eigen::LevenbergMarquardt<Eigen::NumericalDiff<OptimizationFunctor>, MatScalar> lm (num_diff);
+    info = lm.minimize (x);
+    residual_norm = lm.fvec.norm ();
+  }
 
   // Compute the norm of the residuals
   PCL_DEBUG ("[pcl::registration::TransformationEstimationLM::estimateRigidTransformation]");
-  PCL_DEBUG ("LM solver finished with exit code %i, having a residual norm of %g. \n", info, lm.fvec.norm ());
+  PCL_DEBUG ("LM solver finished with exit code %i, having a residual norm of %g. \n", info, residual_norm);
   PCL_DEBUG ("Final solution: [%f", x[0]);
   for (int i = 1; i < n_unknowns; ++i) 
     PCL_DEBUG (" %f", x[i]);
@@ -177,13 +209,25 @@ pcl::registration::TransformationEstimationLM<PointSource, PointTarget, MatScala
   tmp_idx_tgt_ = &indices_tgt;
 
   OptimizationFunctorWithIndices functor (static_cast<int> (indices_src.size ()), this);
-  Eigen::NumericalDiff<OptimizationFunctorWithIndices> num_diff (functor);
-  //Eigen::LevenbergMarquardt<Eigen::NumericalDiff<OptimizationFunctorWithIndices> > lm (num_diff);
-  Eigen::LevenbergMarquardt<Eigen::NumericalDiff<OptimizationFunctorWithIndices>, MatScalar> lm (num_diff);
-  int info = lm.minimize (x);
+  int info;
+  double residual_norm;
+  if (use_analytic_jacobian_ && warp_point_->hasJacobian ())
+  {
+    Eigen::LevenbergMarquardt<OptimizationFunctorWithIndices, MatScalar> lm (functor);
+    info = lm.minimize (x);
+    residual_norm = lm.fvec.norm ();
+  }
+  else
+  {
+    Eigen::NumericalDiff<OptimizationFunctorWithIndices> num_diff (functor);
+    //Eigen::LevenbergMarquardt<Eigen::NumericalDiff<OptimizationFunctorWithIndices> > lm (num_diff);
+    Eigen::LevenbergMarquardt<Eigen::NumericalDiff<OptimizationFunctorWithIndices>, MatScalar> lm (num_diff);
+    info = lm.minimize (x);
+    residual_norm = lm.fvec.norm ();
+  }
 
   // Compute the norm of the residuals
-  PCL_DEBUG ("[pcl::registration::TransformationEstimationLM::estimateRigidTransformation] LM solver finished with exit code %i, having a residual norm of %g. \n", info, lm.fvec.norm ());
+  PCL_DEBUG ("[pcl::registration::TransformationEstimationLM::estimateRigidTransformation] LM solver finished with exit code %i, having a residual norm of %g. \n", info, residual_norm);
   PCL_DEBUG ("Final solution: [%f", x[0]);
   for (int i = 1; i < n_unknowns; ++i) 
     PCL_DEBUG (" %f", x[i]);
@@ -225,12 +269,17 @@ pcl::registration::TransformationEstimationLM<PointSource, PointTarget, MatScala
 {
   const PointCloud<PointSource> & src_points = *estimator_->tmp_src_;
   const PointCloud<PointTarget> & tgt_points = *estimator_->tmp_tgt_;
+  const int nr_values = values ();
 
   // Initialize the warp function with the given parameters
   estimator_->warp_point_->setParam (x);
 
   // Transform each source point and compute its distance to the corresponding target point
-  for (int i = 0; i < values (); ++i)
+#pragma omp parallel for \
+  default(none) \
+  shared(fvec, nr_values, src_points, tgt_points) \
+  num_threads(estimator_->threads_)
+  for (int i = 0; i < nr_values; ++i)
   {
     const PointSource & p_src = src_points[i];
     const PointTarget & p_tgt = tgt_points[i];
@@ -245,6 +294,40 @@ pcl::registration::TransformationEstimationLM<PointSource, PointTarget, MatScala
   return (0);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointSource, typename PointTarget, typename MatScalar> int
+pcl::registration::TransformationEstimationLM<PointSource, PointTarget, MatScalar>::OptimizationFunctor::df (
+    const VectorX &x, typename Functor<MatScalar>::JacobianType &fjac) const
+{
+  const PointCloud<PointSource> & src_points = *estimator_->tmp_src_;
+  const PointCloud<PointTarget> & tgt_points = *estimator_->tmp_tgt_;
+  const int nr_values = values ();
+
+  estimator_->warp_point_->setParam (x);
+
+  // Every row is the gradient of the distance times the derivatives of the warped point
+#pragma omp parallel \
+  default(none) \
+  shared(fjac, nr_values, src_points, tgt_points, x) \
+  num_threads(estimator_->threads_)
+  {
+    Eigen::Matrix<MatScalar, 3, Eigen::Dynamic> jacobian (3, x.size ());
+#pragma omp for
+    for (int i = 0; i < nr_values; ++i)
+    {
+      const PointSource & p_src = src_points[i];
+      const PointTarget & p_tgt = tgt_points[i];
+
+      Vector4 p_src_warped, gradient;
+      estimator_->warp_point_->warpPoint (p_src, p_src_warped);
+      estimator_->computeDistanceGradient (p_src_warped, p_tgt, gradient);
+      estimator_->warp_point_->getJacobian (p_src, jacobian);
+      fjac.row (i) = gradient.template head<3> ().transpose () * jacobian;
+    }
+  }
+  return (0);
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointSource, typename PointTarget, typename MatScalar> int
 pcl::registration::TransformationEstimationLM<PointSource, PointTarget, MatScalar>::OptimizationFunctorWithIndices::operator() (
@@ -254,12 +337,17 @@ pcl::registration::TransformationEstimationLM<PointSource, PointTarget, MatScala
   const PointCloud<PointTarget> & tgt_points = *estimator_->tmp_tgt_;
   const std::vector<int> & src_indices = *estimator_->tmp_idx_src_;
   const std::vector<int> & tgt_indices = *estimator_->tmp_idx_tgt_;
+  const int nr_values = values ();
 
   // Initialize the warp function with the given parameters
   estimator_->warp_point_->setParam (x);
 
   // Transform each source point and compute its distance to the corresponding target point
-  for (int i = 0; i < values (); ++i)
+#pragma omp parallel for \
+  default(none) \
+  shared(fvec, nr_values, src_points, tgt_points, src_indices, tgt_indices) \
+  num_threads(estimator_->threads_)
+  for (int i = 0; i < nr_values; ++i)
   {
     const PointSource & p_src = src_points[src_indices[i]];
     const PointTarget & p_tgt = tgt_points[tgt_indices[i]];
@@ -274,6 +362,42 @@ pcl::registration::TransformationEstimationLM<PointSource, PointTarget, MatScala
   return (0);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointSource, typename PointTarget, typename MatScalar> int
+pcl::registration::TransformationEstimationLM<PointSource, PointTarget, MatScalar>::OptimizationFunctorWithIndices::df (
+    const VectorX &x, typename Functor<MatScalar>::JacobianType &fjac) const
+{
+  const PointCloud<PointSource> & src_points = *estimator_->tmp_src_;
+  const PointCloud<PointTarget> & tgt_points = *estimator_->tmp_tgt_;
+  const std::vector<int> & src_indices = *estimator_->tmp_idx_src_;
+  const std::vector<int> & tgt_indices = *estimator_->tmp_idx_tgt_;
+  const int nr_values = values ();
+
+  estimator_->warp_point_->setParam (x);
+
+  // Every row is the gradient of the distance times the derivatives of the warped point
+#pragma omp parallel \
+  default(none) \
+  shared(fjac, nr_values, src_points, tgt_points, src_indices, tgt_indices, x) \
+  num_threads(estimator_->threads_)
+  {
+    Eigen::Matrix<MatScalar, 3, Eigen::Dynamic> jacobian (3, x.size ());
+#pragma omp for
+    for (int i = 0; i < nr_values; ++i)
+    {
+      const PointSource & p_src = src_points[src_indices[i]];
+      const PointTarget & p_tgt = tgt_points[tgt_indices[i]];
+
+      Vector4 p_src_warped, gradient;
+      estimator_->warp_point_->warpPoint (p_src, p_src_warped);
+      estimator_->computeDistanceGradient (p_src_warped, p_tgt, gradient);
+      estimator_->warp_point_->getJacobian (p_src, jacobian);
+      fjac.row (i) = gradient.template head<3> ().transpose () * jacobian;
+    }
+  }
+  return (0);
+}
+
 //#define PCL_INSTANTIATE_TransformationEstimationLM(T,U) template class PCL_EXPORTS pcl::registration::TransformationEstimationLM<T,U>;
 
 #endif /* PCL_REGISTRATION_TRANSFORMATION_ESTIMATION_LM_HPP_ */
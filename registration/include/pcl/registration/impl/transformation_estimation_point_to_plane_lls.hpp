@@ -43,6 +43,9 @@
 
 #include <pcl/cloud_iterator.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 namespace pcl
 {
@@ -50,6 +53,20 @@ namespace pcl
 namespace registration
 {
 
+template <typename PointSource, typename PointTarget, typename Scalar> void
+TransformationEstimationPointToPlaneLLS<PointSource, PointTarget, Scalar>::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs ();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
+
+
 template <typename PointSource, typename PointTarget, typename Scalar> inline void
 TransformationEstimationPointToPlaneLLS<PointSource, PointTarget, Scalar>::
 estimateRigidTransformation (const pcl::PointCloud<PointSource> &cloud_src,
@@ -129,9 +146,34 @@ estimateRigidTransformation (const pcl::PointCloud<PointSource> &cloud_src,
                              const pcl::Correspondences &correspondences,
                              Matrix4 &transformation_matrix) const
 {
-  ConstCloudIterator<PointSource> source_it (cloud_src, correspondences, true);
-  ConstCloudIterator<PointTarget> target_it (cloud_tgt, correspondences, false);
-  estimateRigidTransformation (source_it, target_it, transformation_matrix);
+  // Every thread accumulates the normal equations of a contiguous range of correspondences, the ranges are summed
+  // in their order so that a single thread accumulates in the order of the correspondences
+  const std::size_t nr_correspondences = correspondences.size ();
+  std::size_t nr_chunks = std::max<std::size_t> (1, std::min<std::size_t> (threads_, nr_correspondences));
+  std::vector<Matrix6d, Eigen::aligned_allocator<Matrix6d> > chunk_ATA (nr_chunks, Matrix6d::Zero ());
+  std::vector<Vector6d, Eigen::aligned_allocator<Vector6d> > chunk_ATb (nr_chunks, Vector6d::Zero ());
+
+#pragma omp parallel for \
+  default(none) \
+  shared(chunk_ATA, chunk_ATb, cloud_src, cloud_tgt, correspondences, nr_chunks, nr_correspondences) \
+  num_threads(threads_)
+  for (std::ptrdiff_t chunk = 0; chunk < static_cast<std::ptrdiff_t> (nr_chunks); ++chunk)
+  {
+    const std::size_t begin = nr_correspondences * chunk / nr_chunks;
+    const std::size_t end = nr_correspondences * (chunk + 1) / nr_chunks;
+    for (std::size_t i = begin; i < end; ++i)
+      addCorrespondence (cloud_src[correspondences[i].index_query], cloud_tgt[correspondences[i].index_match],
+                         chunk_ATA[chunk], chunk_ATb[chunk]);
+  }
+
+  Matrix6d ATA = chunk_ATA[0];
+  Vector6d ATb = chunk_ATb[0];
+  for (std::size_t chunk = 1; chunk < nr_chunks; ++chunk)
+  {
+    ATA += chunk_ATA[chunk];
+    ATb += chunk_ATb[chunk];
+  }
+  solveNormalEquations (ATA, ATb, transformation_matrix);
 }
 
 
@@ -162,104 +204,50 @@ constructTransformationMatrix (const double & alpha, const double & beta, const
 
 template <typename PointSource, typename PointTarget, typename Scalar> inline void
 TransformationEstimationPointToPlaneLLS<PointSource, PointTarget, Scalar>::
-estimateRigidTransformation (ConstCloudIterator<PointSource>& source_it, ConstCloudIterator<PointTarget>& target_it, Matrix4 &transformation_matrix) const
+addCorrespondence (const PointSource &source, const PointTarget &target, Matrix6d &ATA, Vector6d &ATb) const
 {
-  using Vector6d = Eigen::Matrix<double, 6, 1>;
-  using Matrix6d = Eigen::Matrix<double, 6, 6>;
+  if (!std::isfinite (source.x) ||
+      !std::isfinite (source.y) ||
+      !std::isfinite (source.z) ||
+      !std::isfinite (target.x) ||
+      !std::isfinite (target.y) ||
+      !std::isfinite (target.z) ||
+      !std::isfinite (target.normal_x) ||
+      !std::isfinite (target.normal_y) ||
+      !std::isfinite (target.normal_z))
+    return;
 
-  Matrix6d ATA;
-  Vector6d ATb;
-  ATA.setZero ();
-  ATb.setZero ();
+  const float & sx = source.x;
+  const float & sy = source.y;
+  const float & sz = source.z;
+  const float & dx = target.x;
+  const float & dy = target.y;
+  const float & dz = target.z;
+  const float & nx = target.normal[0];
+  const float & ny = target.normal[1];
+  const float & nz = target.normal[2];
+
+  double a = nz*sy - ny*sz;
+  double b = nx*sz - nz*sx;
+  double c = ny*sx - nx*sy;
+
+  // The rows of the rotation are accumulated with one outer product, the products of the normal coordinates are
+  // kept in single precision
+  const Vector6d v (a, b, c, nx, ny, nz);
+  const Eigen::Vector3f n (nx, ny, nz);
+  ATA.template topRows<3> () += v.template head<3> () * v.transpose ();
+  ATA.template bottomRightCorner<3, 3> () += (n * n.transpose ()).template cast<double> ();
+
+  double d = nx*dx + ny*dy + nz*dz - nx*sx - ny*sy - nz*sz;
+  ATb += v * d;
+}
 
-  // Approximate as a linear least squares problem
-  while (source_it.isValid () && target_it.isValid ())
-  {
-    if (!std::isfinite (source_it->x) ||
-        !std::isfinite (source_it->y) ||
-        !std::isfinite (source_it->z) ||
-        !std::isfinite (target_it->x) ||
-        !std::isfinite (target_it->y) ||
-        !std::isfinite (target_it->z) ||
-        !std::isfinite (target_it->normal_x) ||
-        !std::isfinite (target_it->normal_y) ||
-        !std::isfinite (target_it->normal_z))
-    {
-      ++target_it;
-      ++source_it;
-      continue;
-    }
-
-    const float & sx = source_it->x;
-    const float & sy = source_it->y;
-    const float & sz = source_it->z;
-    const float & dx = target_it->x;
-    const float & dy = target_it->y;
-    const float & dz = target_it->z;
-    const float & nx = target_it->normal[0];
-    const float & ny = target_it->normal[1];
-    const float & nz = target_it->normal[2];
-
-    double a = nz*sy - ny*sz;
-    double b = nx*sz - nz*sx;
-    double c = ny*sx - nx*sy;
-
-    //    0  1  2  3  4  5
-    //    6  7  8  9 10 11
-    //   12 13 14 15 16 17
-    //   18 19 20 21 22 23
-    //   24 25 26 27 28 29
-    //   30 31 32 33 34 35
-
-    ATA.coeffRef (0) += a * a;
-    ATA.coeffRef (1) += a * b;
-    ATA.coeffRef (2) += a * c;
-    ATA.coeffRef (3) += a * nx;
-    ATA.coeffRef (4) += a * ny;
-    ATA.coeffRef (5) += a * nz;
-    ATA.coeffRef (7) += b * b;
-    ATA.coeffRef (8) += b * c;
-    ATA.coeffRef (9) += b * nx;
-    ATA.coeffRef (10) += b * ny;
-    ATA.coeffRef (11) += b * nz;
-    ATA.coeffRef (14) += c * c;
-    ATA.coeffRef (15) += c * nx;
-    ATA.coeffRef (16) += c * ny;
-    ATA.coeffRef (17) += c * nz;
-    ATA.coeffRef (21) += nx * nx;
-    ATA.coeffRef (22) += nx * ny;
-    ATA.coeffRef (23) += nx * nz;
-    ATA.coeffRef (28) += ny * ny;
-    ATA.coeffRef (29) += ny * nz;
-    ATA.coeffRef (35) += nz * nz;
-
-    double d = nx*dx + ny*dy + nz*dz - nx*sx - ny*sy - nz*sz;
-    ATb.coeffRef (0) += a * d;
-    ATb.coeffRef (1) += b * d;
-    ATb.coeffRef (2) += c * d;
-    ATb.coeffRef (3) += nx * d;
-    ATb.coeffRef (4) += ny * d;
-    ATb.coeffRef (5) += nz * d;
-
-    ++target_it;
-    ++source_it;
-  }
 
-  ATA.coeffRef (6) = ATA.coeff (1);
-  ATA.coeffRef (12) = ATA.coeff (2);
-  ATA.coeffRef (13) = ATA.coeff (8);
-  ATA.coeffRef (18) = ATA.coeff (3);
-  ATA.coeffRef (19) = ATA.coeff (9);
-  ATA.coeffRef (20) = ATA.coeff (15);
-  ATA.coeffRef (24) = ATA.coeff (4);
-  ATA.coeffRef (25) = ATA.coeff (10);
-  ATA.coeffRef (26) = ATA.coeff (16);
-  ATA.coeffRef (27) = ATA.coeff (22);
-  ATA.coeffRef (30) = ATA.coeff (5);
-  ATA.coeffRef (31) = ATA.coeff (11);
-  ATA.coeffRef (32) = ATA.coeff (17);
-  ATA.coeffRef (33) = ATA.coeff (23);
-  ATA.coeffRef (34) = ATA.coeff (29);
+template <typename PointSource, typename PointTarget, typename Scalar> inline void
+TransformationEstimationPointToPlaneLLS<PointSource, PointTarget, Scalar>::
+solveNormalEquations (Matrix6d &ATA, const Vector6d &ATb, Matrix4 &transformation_matrix) const
+{
+  ATA.template bottomLeftCorner<3, 3> () = ATA.template topRightCorner<3, 3> ().transpose ();
 
   // Solve A*x = b
   Vector6d x = static_cast<Vector6d> (ATA.inverse () * ATb);
@@ -268,6 +256,23 @@ estimateRigidTransformation (ConstCloudIterator<PointSource>& source_it, ConstCl
   constructTransformationMatrix (x (0), x (1), x (2), x (3), x (4), x (5), transformation_matrix);
 }
 
+
+template <typename PointSource, typename PointTarget, typename Scalar> inline void
+TransformationEstimationPointToPlaneLLS<PointSource, PointTarget, Scalar>::
+estimateRigidTransformation (ConstCloudIterator<PointSource>& source_it, ConstCloudIterator<PointTarget>& target_it, Matrix4 &transformation_matrix) const
+{
+  Matrix6d ATA;
+  Vector6d ATb;
+  ATA.setZero ();
+  ATb.setZero ();
+
+  // Approximate as a linear least squares problem
+  for (; source_it.isValid () && target_it.isValid (); ++source_it, ++target_it)
+    addCorrespondence (*source_it, *target_it, ATA, ATb);
+
+  solveNormalEquations (ATA, ATb, transformation_matrix);
+}
+
 } // namespace registration
 } // namespace pcl
 
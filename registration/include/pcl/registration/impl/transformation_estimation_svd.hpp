@@ -43,6 +43,9 @@
 
 #include <pcl/common/eigen.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 namespace pcl
 {
@@ -50,6 +53,20 @@ namespace pcl
 namespace registration
 {
 
+template <typename PointSource, typename PointTarget, typename Scalar> void
+TransformationEstimationSVD<PointSource, PointTarget, Scalar>::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs ();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
+
+
 template <typename PointSource, typename PointTarget, typename Scalar> inline void
 TransformationEstimationSVD<PointSource, PointTarget, Scalar>::estimateRigidTransformation (
     const pcl::PointCloud<PointSource> &cloud_src,
@@ -124,6 +141,33 @@ TransformationEstimationSVD<PointSource, PointTarget, Scalar>::estimateRigidTran
     const pcl::Correspondences &correspondences,
     Matrix4 &transformation_matrix) const
 {
+  if (use_umeyama_)
+  {
+    // Gather the corresponding points by index in parallel, instead of through the iterators
+    const int npts = static_cast <int> (correspondences.size ());
+    Eigen::Matrix<Scalar, 3, Eigen::Dynamic> src (3, npts);
+    Eigen::Matrix<Scalar, 3, Eigen::Dynamic> tgt (3, npts);
+
+#pragma omp parallel for \
+  default(none) \
+  shared(cloud_src, cloud_tgt, correspondences, npts, src, tgt) \
+  num_threads(threads_)
+    for (int i = 0; i < npts; ++i)
+    {
+      const PointSource &p_src = cloud_src[correspondences[i].index_query];
+      const PointTarget &p_tgt = cloud_tgt[correspondences[i].index_match];
+      src (0, i) = p_src.x;
+      src (1, i) = p_src.y;
+      src (2, i) = p_src.z;
+      tgt (0, i) = p_tgt.x;
+      tgt (1, i) = p_tgt.y;
+      tgt (2, i) = p_tgt.z;
+    }
+
+    transformation_matrix = pcl::umeyama (src, tgt, false);
+    return;
+  }
+
   ConstCloudIterator<PointSource> source_it (cloud_src, correspondences, true);
   ConstCloudIterator<PointTarget> target_it (cloud_tgt, correspondences, false);
   estimateRigidTransformation (source_it, target_it, transformation_matrix);
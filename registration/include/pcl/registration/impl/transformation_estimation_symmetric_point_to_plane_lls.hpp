@@ -39,6 +39,9 @@
 
 #include <pcl/cloud_iterator.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 namespace pcl
 {
@@ -46,6 +49,20 @@ namespace pcl
 namespace registration
 {
 
+template <typename PointSource, typename PointTarget, typename Scalar> void
+TransformationEstimationSymmetricPointToPlaneLLS<PointSource, PointTarget, Scalar>::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs ();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
+
+
 template <typename PointSource, typename PointTarget, typename Scalar> inline void
 TransformationEstimationSymmetricPointToPlaneLLS<PointSource, PointTarget, Scalar>::
 estimateRigidTransformation (const pcl::PointCloud<PointSource> &cloud_src,
@@ -125,9 +142,34 @@ estimateRigidTransformation (const pcl::PointCloud<PointSource> &cloud_src,
                              const pcl::Correspondences &correspondences,
                              Matrix4 &transformation_matrix) const
 {
-  ConstCloudIterator<PointSource> source_it (cloud_src, correspondences, true);
-  ConstCloudIterator<PointTarget> target_it (cloud_tgt, correspondences, false);
-  estimateRigidTransformation (source_it, target_it, transformation_matrix);
+  // Every thread accumulates the normal equations of a contiguous range of correspondences, the ranges are summed
+  // in their order so that a single thread accumulates in the order of the correspondences
+  const std::size_t nr_correspondences = correspondences.size ();
+  std::size_t nr_chunks = std::max<std::size_t> (1, std::min<std::size_t> (threads_, nr_correspondences));
+  std::vector<Matrix6, Eigen::aligned_allocator<Matrix6> > chunk_ATA (nr_chunks, Matrix6::Zero ());
+  std::vector<Vector6, Eigen::aligned_allocator<Vector6> > chunk_ATb (nr_chunks, Vector6::Zero ());
+
+#pragma omp parallel for \
+  default(none) \
+  shared(chunk_ATA, chunk_ATb, cloud_src, cloud_tgt, correspondences, nr_chunks, nr_correspondences) \
+  num_threads(threads_)
+  for (std::ptrdiff_t chunk = 0; chunk < static_cast<std::ptrdiff_t> (nr_chunks); ++chunk)
+  {
+    const std::size_t begin = nr_correspondences * chunk / nr_chunks;
+    const std::size_t end = nr_correspondences * (chunk + 1) / nr_chunks;
+    for (std::size_t i = begin; i < end; ++i)
+      addCorrespondence (cloud_src[correspondences[i].index_query], cloud_tgt[correspondences[i].index_match],
+                         chunk_ATA[chunk], chunk_ATb[chunk]);
+  }
+
+  Matrix6 ATA = chunk_ATA[0];
+  Vector6 ATb = chunk_ATb[0];
+  for (std::size_t chunk = 1; chunk < nr_chunks; ++chunk)
+  {
+    ATA += chunk_ATA[chunk];
+    ATb += chunk_ATb[chunk];
+  }
+  solveNormalEquations (ATA, ATb, transformation_matrix);
 }
 
 
@@ -150,58 +192,70 @@ constructTransformationMatrix (const Vector6 &parameters,
 
 template <typename PointSource, typename PointTarget, typename Scalar> inline void
 TransformationEstimationSymmetricPointToPlaneLLS<PointSource, PointTarget, Scalar>::
-estimateRigidTransformation (ConstCloudIterator<PointSource>& source_it, ConstCloudIterator<PointTarget>& target_it, Matrix4 &transformation_matrix) const
+addCorrespondence (const PointSource &source, const PointTarget &target, Matrix6 &ATA, Vector6 &ATb) const
 {
-  using Matrix6 = Eigen::Matrix<Scalar, 6, 6>;
   using Vector3 = Eigen::Matrix<Scalar, 3, 1>;
 
+  const Vector3 p (source.x, source.y, source.z);
+  const Vector3 q (target.x, target.y, target.z);
+  const Vector3 n1 (source.getNormalVector3fMap().template cast<Scalar>());
+  const Vector3 n2 (target.getNormalVector3fMap().template cast<Scalar>());
+  Vector3 n;
+  if (enforce_same_direction_normals_)
+  {
+      if (n1.dot (n2) >= 0.)
+          n = n1 + n2;
+      else
+          n = n1 - n2;
+  }
+  else
+  {
+      n = n1 + n2;
+  }
+
+  if (!p.array().isFinite().all() ||
+      !q.array().isFinite().all() ||
+      !n.array().isFinite().all())
+  {
+    return;
+  }
+
+  Vector6 v;
+  v << (p + q).cross (n), n;
+  ATA.template selfadjointView<Eigen::Upper> ().rankUpdate (v);
+
+  ATb += v * (q - p).dot (n);
+}
+
+
+template <typename PointSource, typename PointTarget, typename Scalar> inline void
+TransformationEstimationSymmetricPointToPlaneLLS<PointSource, PointTarget, Scalar>::
+solveNormalEquations (const Matrix6 &ATA, const Vector6 &ATb, Matrix4 &transformation_matrix) const
+{
+  // Solve A*x = b
+  const Vector6 x = ATA.template selfadjointView<Eigen::Upper> ().ldlt ().solve (ATb);
+
+  // Construct the transformation matrix from x
+  constructTransformationMatrix (x, transformation_matrix);
+}
+
+
+template <typename PointSource, typename PointTarget, typename Scalar> inline void
+TransformationEstimationSymmetricPointToPlaneLLS<PointSource, PointTarget, Scalar>::
+estimateRigidTransformation (ConstCloudIterator<PointSource>& source_it, ConstCloudIterator<PointTarget>& target_it, Matrix4 &transformation_matrix) const
+{
   Matrix6 ATA;
   Vector6 ATb;
   ATA.setZero ();
   ATb.setZero ();
-  auto M = ATA.template selfadjointView<Eigen::Upper> ();
 
   // Approximate as a linear least squares problem
   source_it.reset ();
   target_it.reset ();
   for (; source_it.isValid () && target_it.isValid (); ++source_it, ++target_it)
-  {
-    const Vector3 p (source_it->x, source_it->y, source_it->z);
-    const Vector3 q (target_it->x, target_it->y, target_it->z);
-    const Vector3 n1 (source_it->getNormalVector3fMap().template cast<Scalar>());
-    const Vector3 n2 (target_it->getNormalVector3fMap().template cast<Scalar>());
-    Vector3 n;
-    if (enforce_same_direction_normals_)
-    {
-        if (n1.dot (n2) >= 0.)
-            n = n1 + n2;
-        else
-            n = n1 - n2;
-    }
-    else
-    {
-        n = n1 + n2;
-    }
-
-    if (!p.array().isFinite().all() ||
-        !q.array().isFinite().all() ||
-        !n.array().isFinite().all())
-    {
-      continue;
-    }
-
-    Vector6 v;
-    v << (p + q).cross (n), n;
-    M.rankUpdate (v);
-
-    ATb += v * (q - p).dot (n);
-  }
-
-  // Solve A*x = b
-  const Vector6 x = M.ldlt ().solve (ATb);
+    addCorrespondence (*source_it, *target_it, ATA, ATb);
 
-  // Construct the transformation matrix from x
-  constructTransformationMatrix (x, transformation_matrix);
+  solveNormalEquations (ATA, ATb, transformation_matrix);
 }
 
 
@@ -0,0 +1,127 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved
+ */
+
+#ifndef PCL_REGISTRATION_IMPL_VOXELIZED_GICP_HPP_
+#define PCL_REGISTRATION_IMPL_VOXELIZED_GICP_HPP_
+
+#include <pcl/common/point_tests.h> // for pcl::isFinite
+
+#include <cmath>
+
+namespace pcl
+{
+
+template <typename PointSource, typename PointTarget> void
+VoxelizedGeneralizedIterativeClosestPoint<PointSource, PointTarget>::computeVoxels ()
+{
+  voxel_map_.clear ();
+  voxel_means_.clear ();
+  voxel_covariances_.clear ();
+
+  std::vector<Eigen::Vector3d> sums;
+  std::vector<int> counts;
+  for (std::size_t i = 0; i < target_->size (); ++i)
+  {
+    const PointTarget &pt = (*target_)[i];
+    if (!isFinite (pt))
+      continue;
+    const auto it = voxel_map_.emplace (getVoxelKey (getVoxelCoordinates (pt.getVector3fMap ())), static_cast<int> (sums.size ())).first;
+    if (static_cast<std::size_t> (it->second) == sums.size ())
+    {
+      sums.emplace_back (Eigen::Vector3d::Zero ());
+      counts.push_back (0);
+      voxel_covariances_.emplace_back (Eigen::Matrix3d::Zero ());
+    }
+    sums[it->second]+= pt.getVector3fMap ().template cast<double> ();
+    voxel_covariances_[it->second]+= (*target_covariances_)[i];
+    ++counts[it->second];
+  }
+
+  voxel_means_.resize (sums.size ());
+  for (std::size_t v = 0; v < sums.size (); ++v)
+  {
+    const Eigen::Vector3d mean = sums[v] / static_cast<double> (counts[v]);
+    PointTarget &pt = voxel_means_[v];
+    pt.x = static_cast<float> (mean[0]);
+    pt.y = static_cast<float> (mean[1]);
+    pt.z = static_cast<float> (mean[2]);
+    pt.data[3] = 1.f;
+    voxel_covariances_[v]/= static_cast<double> (counts[v]);
+  }
+  voxelized_covariances_ = target_covariances_;
+}
+
+
+template <typename PointSource, typename PointTarget> bool
+VoxelizedGeneralizedIterativeClosestPoint<PointSource, PointTarget>::findCorrespondences (
+    const PointCloudSource &output, const Eigen::Matrix3d &R,
+    std::vector<int> &source_indices, std::vector<int> &target_indices)
+{
+  if (!voxelized_covariances_ || voxelized_covariances_ != target_covariances_)
+    computeVoxels ();
+
+  float dist_threshold = static_cast<float> (corr_dist_threshold_ * corr_dist_threshold_);
+  std::size_t N = indices_->size ();
+  // The closest voxel of each source point, -1 if there is none closer than the threshold
+  std::vector<int> matches (N, -1);
+
+#pragma omp parallel for \
+  default(none) \
+  shared(dist_threshold, matches, N, output, R) \
+  num_threads(threads_) \
+  schedule(dynamic, 256)
+  for (std::ptrdiff_t i = 0; i < static_cast<std::ptrdiff_t> (N); i++)
+  {
+    const Eigen::Vector4f query = this->transformation_ * output[i].getVector4fMap ();
+    const Eigen::Vector3i ijk = this->getVoxelCoordinates (query.head<3> ());
+    int voxel = -1;
+    float voxel_dist = dist_threshold;
+    for (int di = -1; di <= 1; ++di)
+      for (int dj = -1; dj <= 1; ++dj)
+        for (int dk = -1; dk <= 1; ++dk)
+        {
+          const auto it = this->voxel_map_.find (getVoxelKey (ijk + Eigen::Vector3i (di, dj, dk)));
+          if (it == this->voxel_map_.end ())
+            continue;
+          const float dist = (this->voxel_means_[it->second].getVector3fMap () - query.head<3> ()).squaredNorm ();
+          if (dist < voxel_dist)
+          {
+            voxel = it->second;
+            voxel_dist = dist;
+          }
+        }
+    if (voxel < 0)
+      continue;
+
+    const Eigen::Matrix3d &C1 = (*this->input_covariances_)[i];
+    const Eigen::Matrix3d &C2 = this->voxel_covariances_[voxel];
+    Eigen::Matrix3d &M = this->mahalanobis_[i];
+    // M = (R*C1*R' + C2)^-1
+    M = R * C1;
+    Eigen::Matrix3d temp = M * R.transpose();
+    temp+= C2;
+    M = temp.inverse ();
+    matches[i] = voxel;
+  }
+
+  source_indices.clear ();
+  target_indices.clear ();
+  for (std::size_t i = 0; i < N; i++)
+  {
+    if (matches[i] < 0)
+      continue;
+    source_indices.push_back (static_cast<int> (i));
+    target_indices.push_back (matches[i]);
+  }
+  return (true);
+}
+
+} // namespace pcl
+
+#endif // PCL_REGISTRATION_IMPL_VOXELIZED_GICP_HPP_
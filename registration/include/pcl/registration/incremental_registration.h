@@ -38,6 +38,7 @@
 #pragma once
 
 #include <pcl/point_cloud.h>
+#include <pcl/registration/local_map.h>
 #include <pcl/registration/registration.h>
 
 namespace pcl {
@@ -66,6 +67,10 @@ namespace pcl {
       * }
       * \endcode
       *
+      * Registering each cloud only to the previous one accumulates the errors of all the registrations. Given a
+      * @ref LocalMap with @ref setLocalMap, each cloud is instead registered to a map made of the last keyframes (scan to
+      * map registration), which is updated incrementally with the registered clouds.
+      *
       * \author Michael 'v4hn' Goerner
       * \ingroup registration
       */
@@ -78,6 +83,8 @@ namespace pcl {
         using RegistrationPtr = typename pcl::Registration<PointT,PointT,Scalar>::Ptr;
         using Matrix4 = typename pcl::Registration<PointT,PointT,Scalar>::Matrix4;
 
+        using LocalMapPtr = typename LocalMap<PointT>::Ptr;
+
         IncrementalRegistration ();
 
         /** \brief Empty destructor */
@@ -101,13 +108,25 @@ namespace pcl {
         inline Matrix4
         getAbsoluteTransform () const;
 
-        /** \brief Reset incremental Registration without resetting registration_ */
+        /** \brief Reset incremental Registration without resetting registration_, the local map is cleared */
         inline void
         reset ();
 
         /** \brief Set registration instance used to align clouds */
         inline void
         setRegistration (RegistrationPtr);
+
+        /** \brief Register the clouds to a local map of the last keyframes instead of to the last cloud.
+          * \param[in] local_map the local map, updated by @ref registerCloud
+          * \note The local map replaces the target search method of the registration for good (see
+          * @ref LocalMap::assignTo), the registration can not be used to register to the last cloud afterwards.
+          */
+        inline void
+        setLocalMap (const LocalMapPtr &local_map);
+
+        /** \brief Get the local map the clouds are registered to, null if none. */
+        inline LocalMapPtr
+        getLocalMap () const;
       protected:
 
         /** \brief last registered point cloud */
@@ -116,6 +135,9 @@ namespace pcl {
         /** \brief registration instance to align clouds */
         RegistrationPtr registration_;
 
+        /** \brief local map the clouds are registered to */
+        LocalMapPtr local_map_;
+
         /** \brief estimated transforms */
         Matrix4 delta_transform_;
         Matrix4 abs_transform_;
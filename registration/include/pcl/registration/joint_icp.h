@@ -116,6 +116,7 @@ namespace pcl
 
       /** \brief Empty constructor. */
       JointIterativeClosestPoint ()
+        : threads_ (1)
       {
         IterativeClosestPoint<PointSource, PointTarget, Scalar> ();
         reg_name_ = "JointIterativeClosestPoint";
@@ -204,6 +205,15 @@ namespace pcl
       clearCorrespondenceEstimations ()
       { correspondence_estimations_.clear (); }
 
+      /** \brief Initialize the scheduler and set the number of threads used to estimate the correspondences of the
+        * source / target pairs, one pair per thread, and to transform the sources.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        * \note The correspondence estimations given with \ref addCorrespondenceEstimation are then used concurrently,
+        * each by one thread, they must not share their search trees.
+        */
+      void
+      setNumberOfThreads (unsigned int nr_threads = 0);
+
 
     protected:
 
@@ -221,6 +231,9 @@ namespace pcl
       std::vector<PointCloudSourceConstPtr> sources_;
       std::vector<PointCloudTargetConstPtr> targets_;
       std::vector<CorrespondenceEstimationPtr> correspondence_estimations_;
+
+      /** \brief The number of threads the scheduler should use. */
+      unsigned int threads_;
   };
 
 }
@@ -0,0 +1,365 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved
+ */
+
+#pragma once
+
+#include <pcl/memory.h>
+#include <pcl/pcl_macros.h>
+#include <pcl/point_cloud.h>
+#include <pcl/type_traits.h>
+#include <pcl/common/transforms.h>
+#include <pcl/registration/registration.h>
+#include <pcl/search/incremental_kdtree.h>
+#include <pcl/search/kdtree.h>
+
+#include <Eigen/StdDeque>
+
+#include <cstdint>
+#include <deque>
+#include <unordered_set>
+
+namespace pcl
+{
+  namespace registration
+  {
+    /** \brief LocalMapSearch exposes a search::IncrementalKdTree through the search::KdTree interface of the
+      * registrations, so that they can search a map updated in place instead of building a new tree for every
+      * alignment.
+      *
+      * The searches are forwarded to the incremental tree, \ref setInputCloud only records the cloud: the content
+      * of the tree is managed by its owner. The registrations must therefore be given this object with
+      * force_no_recompute set, as done by \ref LocalMap::assignTo.
+      * \ingroup registration
+      */
+    template <typename PointT>
+    class LocalMapSearch : public pcl::search::KdTree<PointT>
+    {
+      public:
+        using Ptr = shared_ptr<LocalMapSearch<PointT> >;
+        using ConstPtr = shared_ptr<const LocalMapSearch<PointT> >;
+
+        using PointCloudConstPtr = typename pcl::search::KdTree<PointT>::PointCloudConstPtr;
+        using IncrementalTree = pcl::search::IncrementalKdTree<PointT>;
+        using IncrementalTreeConstPtr = shared_ptr<const IncrementalTree>;
+
+        using pcl::search::KdTree<PointT>::nearestKSearch;
+        using pcl::search::KdTree<PointT>::radiusSearch;
+
+        /** \brief Constructor.
+          * \param[in] tree the incremental tree the searches are forwarded to
+          */
+        LocalMapSearch (const IncrementalTreeConstPtr &tree)
+          : pcl::search::KdTree<PointT> (true)
+          , map_tree_ (tree)
+        {
+        }
+
+        /** \brief Record the cloud, the incremental tree is not modified.
+          * \param[in] cloud the cloud of the incremental tree
+          * \param[in] indices ignored
+          */
+        void
+        setInputCloud (const PointCloudConstPtr& cloud,
+                       const IndicesConstPtr& indices = IndicesConstPtr ()) override
+        {
+          pcl::utils::ignore (indices);
+          this->input_ = cloud;
+        }
+
+        int
+        nearestKSearch (const PointT &point, int k,
+                        Indices &k_indices,
+                        std::vector<float> &k_sqr_distances) const override
+        {
+          return (map_tree_->nearestKSearch (point, k, k_indices, k_sqr_distances));
+        }
+
+        int
+        radiusSearch (const PointT& point, double radius,
+                      Indices &k_indices,
+                      std::vector<float> &k_sqr_distances,
+                      unsigned int max_nn = 0) const override
+        {
+          return (map_tree_->radiusSearch (point, radius, k_indices, k_sqr_distances, max_nn));
+        }
+
+      protected:
+        /** \brief The incremental tree holding the map. */
+        IncrementalTreeConstPtr map_tree_;
+    };
+
+    /** \brief LocalMap maintains the map a stream of scans is registered against (scan to map registration), in a
+      * search::IncrementalKdTree updated with every keyframe instead of rebuilt.
+      *
+      * A scan becomes a keyframe when the sensor moved more than a distance or turned more than an angle since the
+      * last keyframe. Its points are transformed into the map frame and inserted into the tree, at most one point per
+      * voxel of the map when a resolution is set. The map is a sliding window: the oldest keyframes are removed when
+      * there are more than a maximum number of them, and keyframes farther than a maximum distance from the current
+      * pose are removed as well. The cost of an update depends on the size of a scan and the cost of a search on the
+      * size of the window, neither grows with the length of the trajectory.
+      * \code
+      * pcl::registration::LocalMap<pcl::PointXYZ> map;
+      * map.setResolution (0.2f);
+      * map.setMaximumNumberOfKeyframes (20);
+      * map.update (*scan, pose);           // the first scan defines the map frame
+      * // for the next scans
+      * map.assignTo (icp);
+      * icp.setInputSource (scan);
+      * icp.align (aligned, pose);
+      * pose = icp.getFinalTransformation ();
+      * map.update (*scan, pose);
+      * \endcode
+      * IncrementalRegistration does the above when given a LocalMap with \ref IncrementalRegistration::setLocalMap.
+      *
+      * \note The voxel of a point belongs to its keyframe, the points of later keyframes falling into it are not
+      * inserted and the voxel is empty again once that keyframe is removed, until the next keyframe observes it.
+      * \note The target cloud of the registrations keeps the slots of the removed points (the searches never return
+      * them), the registrations only reading the target points found by the searches, like the IterativeClosestPoint
+      * variants, are the ones suited to a LocalMap.
+      * \ingroup registration
+      */
+    template <typename PointT>
+    class LocalMap
+    {
+      public:
+        using Ptr = shared_ptr<LocalMap<PointT> >;
+        using ConstPtr = shared_ptr<const LocalMap<PointT> >;
+
+        using PointCloud = pcl::PointCloud<PointT>;
+        using PointCloudConstPtr = typename PointCloud::ConstPtr;
+
+        using IncrementalTree = pcl::search::IncrementalKdTree<PointT>;
+        using IncrementalTreePtr = typename IncrementalTree::Ptr;
+
+        using Search = LocalMapSearch<PointT>;
+        using SearchPtr = typename Search::Ptr;
+
+        /** \brief Empty constructor. */
+        LocalMap ();
+
+        /** \brief Set the side length of the voxels holding at most one point of the map.
+          * \param[in] resolution the side length, 0 (the default) to insert all the points of the keyframes
+          * \note The resolution has to be set while the map is empty.
+          */
+        inline void
+        setResolution (float resolution)
+        {
+          resolution_ = resolution;
+        }
+
+        /** \brief Get the side length of the voxels of the map. */
+        inline float
+        getResolution () const
+        {
+          return (resolution_);
+        }
+
+        /** \brief Set the number of keyframes kept in the map.
+          * \param[in] nr_keyframes the maximum number of keyframes, 0 for no limit (10 by default)
+          */
+        inline void
+        setMaximumNumberOfKeyframes (std::size_t nr_keyframes)
+        {
+          max_keyframes_ = nr_keyframes;
+        }
+
+        /** \brief Get the maximum number of keyframes kept in the map. */
+        inline std::size_t
+        getMaximumNumberOfKeyframes () const
+        {
+          return (max_keyframes_);
+        }
+
+        /** \brief Set the distance from the current pose beyond which the keyframes are removed.
+          * \param[in] distance the maximum distance, 0 (the default) for no limit
+          */
+        inline void
+        setMaximumDistance (float distance)
+        {
+          max_distance_ = distance;
+        }
+
+        /** \brief Get the distance from the current pose beyond which the keyframes are removed. */
+        inline float
+        getMaximumDistance () const
+        {
+          return (max_distance_);
+        }
+
+        /** \brief Set the motion since the last keyframe making a scan a new keyframe.
+          * \param[in] distance the translation, 1 by default
+          * \param[in] angle the rotation in radians, 0.2 by default
+          */
+        inline void
+        setKeyframeThresholds (float distance, float angle)
+        {
+          keyframe_distance_ = distance;
+          keyframe_angle_ = angle;
+        }
+
+        /** \brief Get the translation making a scan a new keyframe. */
+        inline float
+        getKeyframeDistance () const
+        {
+          return (keyframe_distance_);
+        }
+
+        /** \brief Get the rotation in radians making a scan a new keyframe. */
+        inline float
+        getKeyframeAngle () const
+        {
+          return (keyframe_angle_);
+        }
+
+        /** \brief Update the map with a registered scan, added as a keyframe if the sensor moved enough since the
+          * last keyframe (or if the map is empty).
+          * \param[in] cloud the scan, in the sensor frame
+          * \param[in] pose the transformation from the sensor frame to the map frame
+          * \return true if the scan was added as a keyframe
+          */
+        template <typename Scalar> bool
+        update (const PointCloud &cloud, const Eigen::Matrix<Scalar, 4, 4> &pose);
+
+        /** \brief Add a scan as a keyframe, regardless of the motion since the last keyframe.
+          * \param[in] cloud the scan, in the sensor frame
+          * \param[in] pose the transformation from the sensor frame to the map frame
+          */
+        template <typename Scalar> void
+        addKeyframe (const PointCloud &cloud, const Eigen::Matrix<Scalar, 4, 4> &pose);
+
+        /** \brief Remove all the keyframes. */
+        void
+        clear ();
+
+        /** \brief Check whether the map holds no keyframe. */
+        inline bool
+        empty () const
+        {
+          return (keyframes_.empty ());
+        }
+
+        /** \brief Get the number of keyframes in the map. */
+        inline std::size_t
+        getNumberOfKeyframes () const
+        {
+          return (keyframes_.size ());
+        }
+
+        /** \brief Get the number of points in the map. */
+        inline std::size_t
+        getNumberOfPoints () const
+        {
+          return (tree_->getNumberOfPoints ());
+        }
+
+        /** \brief Copy the points of the map, in the map frame.
+          * \param[out] cloud the points of all the keyframes
+          */
+        void
+        getMapCloud (PointCloud &cloud) const;
+
+        /** \brief Get the cloud the indices returned by the searches refer to, including the slots of removed points. */
+        inline PointCloudConstPtr
+        getInputTarget () const
+        {
+          return (tree_->getInputCloud ());
+        }
+
+        /** \brief Get the search object of the map, for the registrations. */
+        inline const SearchPtr &
+        getSearchMethodTarget () const
+        {
+          return (search_);
+        }
+
+        /** \brief Set the map as the target of a registration, with its search object.
+          * \param[in,out] reg the registration
+          * \note The registration keeps the search object of the map (force_no_recompute is set) until it is given
+          * another one with setSearchMethodTarget.
+          */
+        template <typename PointSource, typename Scalar> void
+        assignTo (Registration<PointSource, PointT, Scalar> &reg) const;
+
+      protected:
+        struct Keyframe
+        {
+          /** \brief The position of the sensor. */
+          Eigen::Vector3f position;
+          /** \brief The orientation of the sensor. */
+          Eigen::Quaternionf orientation;
+          /** \brief The indices of the points of this keyframe in the tree. */
+          Indices point_indices;
+
+          PCL_MAKE_ALIGNED_OPERATOR_NEW
+        };
+
+        /** \brief Remove a keyframe and its points from the map.
+          * \param[in] keyframe the position of the keyframe in keyframes_
+          */
+        void
+        removeKeyframe (std::size_t keyframe);
+
+        /** \brief Remove the keyframes beyond the maximum number of keyframes or the maximum distance, the last
+          * keyframe is always kept.
+          * \param[in] position the current position of the sensor
+          */
+        void
+        removeKeyframes (const Eigen::Vector3f &position);
+
+        /** \brief Transform a scan into the map frame, with its normals. */
+        template <typename Scalar, typename PointType = PointT, traits::HasNormal<PointType> = true> static void
+        transformScan (const PointCloud &cloud, PointCloud &transformed, const Eigen::Matrix<Scalar, 4, 4> &pose)
+        {
+          pcl::transformPointCloudWithNormals (cloud, transformed, pose);
+        }
+
+        /** \brief Transform a scan into the map frame. */
+        template <typename Scalar, typename PointType = PointT, traits::HasNoNormal<PointType> = true> static void
+        transformScan (const PointCloud &cloud, PointCloud &transformed, const Eigen::Matrix<Scalar, 4, 4> &pose)
+        {
+          pcl::transformPointCloud (cloud, transformed, pose);
+        }
+
+        /** \brief The key of the voxel containing a point, made of its coordinates on 21 bits each. */
+        inline std::uint64_t
+        getVoxelKey (const PointT &point) const
+        {
+          const Eigen::Array3i ijk = (point.getArray3fMap () / resolution_).floor ().template cast<int> ();
+          const std::uint64_t mask = (std::uint64_t (1) << 21) - 1;
+          return (((static_cast<std::uint64_t> (ijk[0]) & mask) << 42) |
+                  ((static_cast<std::uint64_t> (ijk[1]) & mask) << 21) |
+                   (static_cast<std::uint64_t> (ijk[2]) & mask));
+        }
+
+        /** \brief The incremental tree holding the points of the keyframes. */
+        IncrementalTreePtr tree_;
+
+        /** \brief The search object forwarding to tree_. */
+        SearchPtr search_;
+
+        /** \brief The keyframes in the map, oldest first. */
+        std::deque<Keyframe, Eigen::aligned_allocator<Keyframe> > keyframes_;
+
+        /** \brief The voxels holding a point of the map, used when resolution_ is set. */
+        std::unordered_set<std::uint64_t> occupied_voxels_;
+
+        float resolution_;
+
+        std::size_t max_keyframes_;
+
+        float max_distance_;
+
+        float keyframe_distance_;
+
+        float keyframe_angle_;
+    };
+  }
+}
+
+#include <pcl/registration/impl/local_map.hpp>
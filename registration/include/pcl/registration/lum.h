@@ -143,6 +143,7 @@ namespace pcl
           : slam_graph_ (new SLAMGraph)
           , max_iterations_ (5)
           , convergence_threshold_ (0.0)
+          , threads_ (1)
         {
         }
 
@@ -200,6 +201,12 @@ namespace pcl
         inline float
         getConvergenceThreshold () const;
 
+        /** \brief Set the number of threads linearizing the edges of the SLAM graph in the compute() method.
+          * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+          */
+        void
+        setNumberOfThreads (unsigned int nr_threads = 0);
+
         /** \brief Add a new point cloud to the SLAM graph.
           * \details This method will add a new vertex to the SLAM graph and attach a point cloud to that vertex.
           * Optionally you can specify a pose estimate for this point cloud.
@@ -336,6 +343,9 @@ namespace pcl
 
         /** \brief The convergence threshold for the summed vector lengths of all poses. */
         float convergence_threshold_;
+
+        /** \brief The number of threads the scheduler should use. */
+        unsigned int threads_;
     };
   }
 }
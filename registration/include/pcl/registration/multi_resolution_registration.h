@@ -0,0 +1,188 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved
+ */
+
+#pragma once
+
+#include <pcl/memory.h>
+#include <pcl/pcl_macros.h>
+#include <pcl/point_cloud.h>
+#include <pcl/registration/registration.h>
+#include <pcl/registration/prepared_target.h>
+
+#include <vector>
+
+namespace pcl
+{
+  namespace registration
+  {
+    /** \brief MultiResolutionRegistration aligns a source to a target coarse to fine, with a @ref Registration run
+      * on voxel grid pyramids of both clouds.
+      *
+      * Each level downsamples the clouds with a VoxelGrid of its leaf size (the full clouds for a leaf size of 0) and
+      * runs the registration with its own maximum correspondence distance and number of iterations, starting from
+      * the transformation found at the previous level. The coarse levels converge quickly from far away on few
+      * points, and the fine levels only refine the transformation.
+      *
+      * The pyramid of the target and the search trees of its levels are built once, and reused by the following
+      * alignments until another target or other levels are set. The covariances of the target levels are kept as
+      * well when the registration is a GeneralizedIterativeClosestPoint.
+      *
+      * \code
+      * pcl::IterativeClosestPoint<pcl::PointXYZ, pcl::PointXYZ>::Ptr icp (new pcl::IterativeClosestPoint<pcl::PointXYZ, pcl::PointXYZ>);
+      * pcl::registration::MultiResolutionRegistration<pcl::PointXYZ, pcl::PointXYZ> mrreg;
+      * mrreg.setRegistration (icp);
+      * mrreg.addLevel (0.4f, 2.0, 10);   // coarse level, loose criteria
+      * mrreg.addLevel (0.1f, 0.5, 10);
+      * mrreg.addLevel (0.0f, 0.2, 30);   // full resolution
+      * mrreg.setInputTarget (map);
+      * mrreg.setInputSource (scan);
+      * mrreg.align (aligned, guess);
+      * \endcode
+      *
+      * \note The registration is given the search trees of the levels as never recomputed (see
+      * Registration::setSearchMethodTarget), it should be given a new search tree before being used without the
+      * driver.
+      * \ingroup registration
+      */
+    template <typename PointSource, typename PointTarget, typename Scalar = float>
+    class MultiResolutionRegistration
+    {
+      public:
+        using Ptr = shared_ptr<MultiResolutionRegistration<PointSource, PointTarget, Scalar> >;
+        using ConstPtr = shared_ptr<const MultiResolutionRegistration<PointSource, PointTarget, Scalar> >;
+
+        using PointCloudSource = pcl::PointCloud<PointSource>;
+        using PointCloudSourcePtr = typename PointCloudSource::Ptr;
+        using PointCloudSourceConstPtr = typename PointCloudSource::ConstPtr;
+
+        using PointCloudTarget = pcl::PointCloud<PointTarget>;
+        using PointCloudTargetPtr = typename PointCloudTarget::Ptr;
+        using PointCloudTargetConstPtr = typename PointCloudTarget::ConstPtr;
+
+        using RegistrationPtr = typename pcl::Registration<PointSource, PointTarget, Scalar>::Ptr;
+        using Matrix4 = typename pcl::Registration<PointSource, PointTarget, Scalar>::Matrix4;
+
+        /** \brief The parameters of a level of the pyramid. */
+        struct Level
+        {
+          /** \brief The leaf size of the voxel grid downsampling the clouds, 0 for the full clouds. */
+          float leaf_size;
+          /** \brief The maximum correspondence distance of the registration. */
+          double max_correspondence_distance;
+          /** \brief The maximum number of iterations of the registration. */
+          int max_iterations;
+        };
+
+        /** \brief Empty constructor. */
+        MultiResolutionRegistration ();
+
+        /** \brief Set the registration run at every level. */
+        inline void
+        setRegistration (const RegistrationPtr &registration)
+        {
+          registration_ = registration;
+        }
+
+        /** \brief Get the registration run at every level. */
+        inline RegistrationPtr
+        getRegistration () const
+        {
+          return (registration_);
+        }
+
+        /** \brief Add a level after the existing ones, the levels are run in the order they are added and should go
+          * from the coarsest to the finest.
+          * \param[in] leaf_size the leaf size of the voxel grid downsampling the clouds, 0 for the full clouds
+          * \param[in] max_correspondence_distance the maximum correspondence distance of the registration
+          * \param[in] max_iterations the maximum number of iterations of the registration
+          */
+        void
+        addLevel (float leaf_size, double max_correspondence_distance, int max_iterations);
+
+        /** \brief Remove all the levels. */
+        void
+        clearLevels ();
+
+        /** \brief Get the levels, from the coarsest to the finest. */
+        inline const std::vector<Level> &
+        getLevels () const
+        {
+          return (levels_);
+        }
+
+        /** \brief Provide the source point cloud.
+          * \param[in] cloud the source point cloud
+          */
+        void
+        setInputSource (const PointCloudSourceConstPtr &cloud);
+
+        /** \brief Provide the target point cloud, its pyramid is built at the next alignment.
+          * \param[in] cloud the target point cloud
+          */
+        void
+        setInputTarget (const PointCloudTargetConstPtr &cloud);
+
+        /** \brief Align the source to the target through all the levels.
+          * \param[out] output the source transformed by the final transformation
+          * \param[in] guess the initial estimate of the transformation
+          * \return true if the registration converged at the finest level
+          */
+        bool
+        align (PointCloudSource &output, const Matrix4 &guess = Matrix4::Identity ());
+
+        /** \brief Get the transformation found by the last alignment. */
+        inline Matrix4
+        getFinalTransformation () const
+        {
+          return (final_transformation_);
+        }
+
+        /** \brief Whether the last alignment converged at the finest level. */
+        inline bool
+        hasConverged () const
+        {
+          return (converged_);
+        }
+
+      protected:
+        /** \brief Build the pyramids of the clouds which changed. */
+        void
+        buildPyramids ();
+
+        /** \brief The registration run at every level. */
+        RegistrationPtr registration_;
+
+        /** \brief The levels, from the coarsest to the finest. */
+        std::vector<Level> levels_;
+
+        /** \brief The source point cloud. */
+        PointCloudSourceConstPtr source_;
+
+        /** \brief The target point cloud. */
+        PointCloudTargetConstPtr target_;
+
+        /** \brief The downsampled source of each level, empty when it has to be built. */
+        std::vector<PointCloudSourceConstPtr> source_pyramid_;
+
+        /** \brief The downsampled target of each level with its search tree, empty when it has to be built. */
+        std::vector<typename PreparedTarget<PointTarget>::Ptr> target_pyramid_;
+
+        /** \brief The transformation found by the last alignment. */
+        Matrix4 final_transformation_;
+
+        /** \brief Whether the last alignment converged. */
+        bool converged_;
+
+      public:
+        PCL_MAKE_ALIGNED_OPERATOR_NEW
+    };
+  }
+}
+
+#include <pcl/registration/impl/multi_resolution_registration.hpp>
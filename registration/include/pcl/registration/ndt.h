@@ -91,6 +91,15 @@ namespace pcl
       using Ptr = shared_ptr< NormalDistributionsTransform<PointSource, PointTarget> >;
       using ConstPtr = shared_ptr< const NormalDistributionsTransform<PointSource, PointTarget> >;
 
+      /** \brief The ways of finding the cells of the target grid which contribute to the score of a point. */
+      enum NeighborSearchMethod
+      {
+        KDTREE,   ///< the cells whose centroid is closer than the resolution, found in a kd-tree of the centroids
+        DIRECT26, ///< the cell containing the point and its 26 neighbors
+        DIRECT7,  ///< the cell containing the point and its 6 face neighbors
+        DIRECT1   ///< the cell containing the point
+      };
+
 
       /** \brief Constructor.
         * Sets \ref outlier_ratio_ to 0.35, \ref step_size_ to 0.05 and \ref resolution_ to 1.0
@@ -110,6 +119,20 @@ namespace pcl
         init ();
       }
 
+      /** \brief Provide a pointer to the input target together with a voxel grid built from it beforehand, which can
+        * be shared by several registrations (e.g. through a \ref pcl::registration::PreparedTarget). The resolution is
+        * set to the leaf size of the grid, and the grid is used until another target or resolution is set.
+        * \param[in] cloud the input point cloud target
+        * \param[in] cells the searchable voxel grid of the target
+        */
+      inline void
+      setInputTarget (const PointCloudTargetConstPtr &cloud, const shared_ptr<const TargetGrid> &cells)
+      {
+        Registration<PointSource, PointTarget>::setInputTarget (cloud);
+        shared_cells_ = cells;
+        resolution_ = cells->getLeafSize ()[0];
+      }
+
       /** \brief Set/change the voxel grid resolution.
         * \param[in] resolution side length of voxels
         */
@@ -120,7 +143,7 @@ namespace pcl
         if (resolution_ != resolution)
         {
           resolution_ = resolution;
-          if (input_)
+          if (input_ || shared_cells_)
             init ();
         }
       }
@@ -134,6 +157,32 @@ namespace pcl
         return (resolution_);
       }
 
+      /** \brief Set the way of finding the cells of the target grid which contribute to the score of a point. The
+        * direct lookups are faster than the default kd-tree search, and DIRECT7 and DIRECT1 trade some robustness to
+        * the initial misalignment for more speed.
+        * \param[in] method the method used to find the neighboring cells of a point
+        */
+      inline void
+      setNeighborSearchMethod (NeighborSearchMethod method)
+      {
+        search_method_ = method;
+      }
+
+      /** \brief Get the way of finding the cells of the target grid which contribute to the score of a point. */
+      inline NeighborSearchMethod
+      getNeighborSearchMethod () const
+      {
+        return (search_method_);
+      }
+
+      /** \brief Initialize the scheduler and set the number of threads used to compute the score, the gradient and
+        * the hessian. The contributions of the points are summed per thread, so the results can slightly differ with
+        * the number of threads.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      void
+      setNumberOfThreads (unsigned int nr_threads = 0);
+
       /** \brief Get the newton line search maximum step length.
         * \return maximum step length
         */
@@ -253,6 +302,7 @@ namespace pcl
       void inline
       init ()
       {
+        shared_cells_.reset ();
         target_cells_.setLeafSize (resolution_, resolution_, resolution_);
         target_cells_.setInputCloud ( target_ );
         // Initiate voxel structure.
@@ -288,6 +338,24 @@ namespace pcl
                          Eigen::Vector3d &x_trans, Eigen::Matrix3d &c_inv,
                          bool compute_hessian = true);
 
+      /** \brief Compute individual point contirbutions to derivatives of probability function w.r.t. the transformation vector,
+        * using the given point derivatives instead of the members used by the other overload.
+        * \param[in,out] score_gradient the gradient vector of the probability function w.r.t. the transformation vector
+        * \param[in,out] hessian the hessian matrix of the probability function w.r.t. the transformation vector
+        * \param[in] point_gradient the first order derivative of the transformation of the point, \f$ J_E \f$
+        * \param[in] point_hessian the second order derivative of the transformation of the point, \f$ H_E \f$
+        * \param[in] x_trans transformed point minus mean of occupied covariance voxel
+        * \param[in] c_inv covariance of occupied covariance voxel
+        * \param[in] compute_hessian flag to calculate hessian, unnessissary for step calculation.
+        */
+      double
+      updateDerivatives (Eigen::Matrix<double, 6, 1> &score_gradient,
+                         Eigen::Matrix<double, 6, 6> &hessian,
+                         const Eigen::Matrix<double, 3, 6> &point_gradient,
+                         const Eigen::Matrix<double, 18, 6> &point_hessian,
+                         const Eigen::Vector3d &x_trans, const Eigen::Matrix3d &c_inv,
+                         bool compute_hessian = true) const;
+
       /** \brief Precompute anglular components of derivatives.
         * \note Equation 6.19 and 6.21 [Magnusson 2009].
         * \param[in] p the current transform vector
@@ -304,6 +372,20 @@ namespace pcl
       void
       computePointDerivatives (Eigen::Vector3d &x, bool compute_hessian = true);
 
+      /** \brief Compute point derivatives into the given matrices, whose constant entries are set as in \ref
+        * point_gradient_ and \ref point_hessian_.
+        * \note Equation 6.18-21 [Magnusson 2009].
+        * \param[in] x point from the input cloud
+        * \param[in,out] point_gradient the first order derivative of the transformation of the point, \f$ J_E \f$
+        * \param[in,out] point_hessian the second order derivative of the transformation of the point, \f$ H_E \f$
+        * \param[in] compute_hessian flag to calculate hessian, unnessissary for step calculation.
+        */
+      void
+      computePointDerivatives (const Eigen::Vector3d &x,
+                               Eigen::Matrix<double, 3, 6> &point_gradient,
+                               Eigen::Matrix<double, 18, 6> &point_hessian,
+                               bool compute_hessian = true) const;
+
       /** \brief Compute hessian of probability function w.r.t. the transformation vector.
         * \note Equation 6.13 [Magnusson 2009].
         * \param[out] hessian the hessian matrix of the probability function w.r.t. the transformation vector
@@ -325,6 +407,47 @@ namespace pcl
       updateHessian (Eigen::Matrix<double, 6, 6> &hessian,
                      Eigen::Vector3d &x_trans, Eigen::Matrix3d &c_inv);
 
+      /** \brief Compute individual point contirbutions to hessian of probability function w.r.t. the transformation vector,
+        * using the given point derivatives instead of the members used by the other overload.
+        * \param[in,out] hessian the hessian matrix of the probability function w.r.t. the transformation vector
+        * \param[in] point_gradient the first order derivative of the transformation of the point, \f$ J_E \f$
+        * \param[in] point_hessian the second order derivative of the transformation of the point, \f$ H_E \f$
+        * \param[in] x_trans transformed point minus mean of occupied covariance voxel
+        * \param[in] c_inv covariance of occupied covariance voxel
+        */
+      void
+      updateHessian (Eigen::Matrix<double, 6, 6> &hessian,
+                     const Eigen::Matrix<double, 3, 6> &point_gradient,
+                     const Eigen::Matrix<double, 18, 6> &point_hessian,
+                     const Eigen::Vector3d &x_trans, const Eigen::Matrix3d &c_inv) const;
+
+      /** \brief Get the voxel grid of the target, the one given with the target when there is one. */
+      inline const TargetGrid &
+      getTargetCells () const
+      {
+        return (shared_cells_ ? *shared_cells_ : target_cells_);
+      }
+
+      /** \brief Get the displacements of the cells searched around a point by the direct neighbor search methods. */
+      Eigen::Matrix<int, 3, Eigen::Dynamic>
+      getNeighborCellOffsets () const;
+
+      /** \brief Find the cells of the target grid which contribute to the score of a transformed point.
+        * \param[in] x_trans_pt the transformed point
+        * \param[in] offsets the displacements of the searched cells, from \ref getNeighborCellOffsets
+        * \param[out] neighborhood the cells found
+        * \param[out] distances a buffer for the distances of the kd-tree search
+        */
+      inline void
+      findNeighborCells (const PointSource &x_trans_pt, const Eigen::Matrix<int, 3, Eigen::Dynamic> &offsets,
+                         std::vector<TargetGridLeafConstPtr> &neighborhood, std::vector<float> &distances) const
+      {
+        if (search_method_ == KDTREE)
+          getTargetCells ().radiusSearch (x_trans_pt, resolution_, neighborhood, distances);
+        else
+          getTargetCells ().getNeighborhoodAtPoint (offsets, x_trans_pt, neighborhood);
+      }
+
       /** \brief Compute line search step length and update transform and probability derivatives using More-Thuente method.
         * \note Search Algorithm [More, Thuente 1994]
         * \param[in] x initial transformation vector, \f$ x \f$ in Equation 1.3 (Moore, Thuente 1994) and \f$ \vec{p} \f$ in Algorithm 2 [Magnusson 2009]
@@ -419,6 +542,9 @@ namespace pcl
       /** \brief The voxel grid generated from target cloud containing point means and covariances. */
       TargetGrid target_cells_;
 
+      /** \brief The voxel grid given with the target, used instead of \ref target_cells_ when set. */
+      shared_ptr<const TargetGrid> shared_cells_;
+
       //double fitness_epsilon_;
 
       /** \brief The side length of voxels. */
@@ -459,6 +585,12 @@ namespace pcl
       /** \brief The second order derivative of the transformation of a point w.r.t. the transform vector, \f$ H_E \f$ in Equation 6.20 [Magnusson 2009]. */
       Eigen::Matrix<double, 18, 6> point_hessian_;
 
+      /** \brief The way of finding the cells of the target grid which contribute to the score of a point. */
+      NeighborSearchMethod search_method_;
+
+      /** \brief The number of threads the scheduler should use. */
+      unsigned int threads_;
+
     public:
       PCL_MAKE_ALIGNED_OPERATOR_NEW
   };
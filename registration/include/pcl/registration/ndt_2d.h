@@ -77,7 +77,7 @@ namespace pcl
       /** \brief Empty constructor. */
       NormalDistributionsTransform2D ()
         : Registration<PointSource,PointTarget> (),
-          grid_centre_ (0,0), grid_step_ (1,1), grid_extent_ (20,20), newton_lambda_ (1,1,1)
+          grid_centre_ (0,0), grid_step_ (1,1), grid_extent_ (20,20), newton_lambda_ (1,1,1), threads_ (1)
       {
         reg_name_ = "NormalDistributionsTransform2D";
       }
@@ -122,6 +122,14 @@ namespace pcl
        virtual void
        setOptimizationStepSize (const Eigen::Vector3d& lambda) { newton_lambda_ = lambda; }
 
+      /** \brief Initialize the scheduler and set the number of threads used to build the grids of the target and
+        * to compute the score, the gradient and the hessian. The contributions of the points are summed per thread,
+        * so the results can slightly differ with the number of threads.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      void
+      setNumberOfThreads (unsigned int nr_threads = 0);
+
     protected:
       /** \brief Rigid transformation computation method with initial guess.
         * \param[out] output the transformed input point cloud dataset using the rigid transformation found
@@ -147,6 +155,9 @@ namespace pcl
       Eigen::Vector2f grid_step_;
       Eigen::Vector2f grid_extent_;
       Eigen::Vector3d newton_lambda_;
+
+      /** \brief The number of threads the scheduler should use. */
+      unsigned int threads_;
     public:
       PCL_MAKE_ALIGNED_OPERATOR_NEW
   };
@@ -88,8 +88,7 @@ namespace pcl
        */
       PPFHashMapSearch (float angle_discretization_step = 12.0f / 180.0f * static_cast<float> (M_PI),
                         float distance_discretization_step = 0.01f)
-        : feature_hash_map_ (new FeatureHashMapType)
-        , internals_initialized_ (false)
+        : internals_initialized_ (false)
         , angle_discretization_step_ (angle_discretization_step)
         , distance_discretization_step_ (distance_discretization_step)
         , max_dist_ (-1.0f)
@@ -97,6 +96,8 @@ namespace pcl
       }
 
       /** \brief Method that sets the feature cloud to be inserted in the hash map
+       * \note The pairs are grouped by discretized feature in a flat open addressing table, the pairs of a point with
+       * itself (whose features are not finite) are not inserted.
        * \param feature_cloud a const smart pointer to the PPFSignature feature cloud
        */
       void
@@ -109,10 +110,11 @@ namespace pcl
        * \param f4 The 4th value describing the query PPFSignature feature
        * \param indices a vector of pair indices representing the feature pairs that have been found in the bin
        * corresponding to the query feature
+       * \note The search does not modify the hash map, it can be run concurrently from several threads
        */
       void
       nearestNeighborSearch (float &f1, float &f2, float &f3, float &f4,
-                             std::vector<std::pair<std::size_t, std::size_t> > &indices);
+                             std::vector<std::pair<std::size_t, std::size_t> > &indices) const;
 
       /** \brief Convenience method for returning a copy of the class instance as a shared_ptr */
       Ptr
@@ -132,7 +134,33 @@ namespace pcl
 
       std::vector <std::vector <float> > alpha_m_;
     private:
-      FeatureHashMapTypePtr feature_hash_map_;
+      /** \brief A slot of the open addressing table: a discretized feature and the range of its pairs in pairs_,
+        * the slot is empty when end is 0 */
+      struct Bucket
+      {
+        HashKeyStruct key;
+        std::size_t begin = 0, end = 0;
+      };
+
+      /** \brief Discretize a feature into the key of its bin */
+      HashKeyStruct
+      discretize (float f1, float f2, float f3, float f4) const;
+
+      /** \brief Returns the slot of a key in buckets_, the slot of the key if it is in the table, the empty slot where
+        * it would be inserted otherwise */
+      std::size_t
+      findBucket (const HashKeyStruct &key) const;
+
+      /** \brief Returns the slot of a key in buckets_, inserting it and growing the table if needed */
+      std::size_t
+      insertBucket (const HashKeyStruct &key);
+
+      /** \brief The open addressing table with linear probing, its size is a power of two */
+      std::vector<Bucket> buckets_;
+      /** \brief The number of non empty slots in buckets_ */
+      std::size_t nr_used_buckets_ = 0;
+      /** \brief The pairs of the feature cloud, grouped by bin */
+      std::vector<std::pair<std::size_t, std::size_t> > pairs_;
       bool internals_initialized_;
 
       float angle_discretization_step_, distance_discretization_step_;
@@ -192,7 +220,8 @@ namespace pcl
       :  Registration<PointSource, PointTarget> (),
          scene_reference_point_sampling_rate_ (5),
          clustering_position_diff_threshold_ (0.01f),
-         clustering_rotation_diff_threshold_ (20.0f / 180.0f * static_cast<float> (M_PI))
+         clustering_rotation_diff_threshold_ (20.0f / 180.0f * static_cast<float> (M_PI)),
+         threads_ (1)
       {}
 
       /** \brief Method for setting the position difference clustering parameter
@@ -231,6 +260,14 @@ namespace pcl
       inline unsigned int
       getSceneReferencePointSamplingRate () { return scene_reference_point_sampling_rate_; }
 
+      /** \brief Initialize the scheduler and set the number of threads to use for the voting.
+        * The scene reference points are voted for in parallel, each thread with its own accumulator array, the
+        * result does not depend on the number of threads.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      void
+      setNumberOfThreads (unsigned int nr_threads = 0);
+
       /** \brief Function that sets the search method for the algorithm
        * \note Right now, the only available method is the one initially proposed by
        * the authors - by using a hash map with discretized feature vectors
@@ -266,6 +303,9 @@ namespace pcl
         * poses are considered to be in the same cluster (for the clustering phase of the algorithm) */
       float clustering_position_diff_threshold_, clustering_rotation_diff_threshold_;
 
+      /** \brief The number of threads the scheduler should use. */
+      unsigned int threads_;
+
       /** \brief use a kd-tree with range searches of range max_dist to skip an O(N) pass through the point cloud */
       typename pcl::KdTreeFLANN<PointTarget>::Ptr scene_search_tree_;
 
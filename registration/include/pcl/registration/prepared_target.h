@@ -0,0 +1,153 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved
+ */
+
+#pragma once
+
+#include <pcl/memory.h>
+#include <pcl/pcl_macros.h>
+#include <pcl/registration/registration.h>
+#include <pcl/registration/gicp.h>
+#include <pcl/registration/ndt.h>
+#include <pcl/filters/voxel_grid_covariance.h>
+#include <pcl/search/kdtree.h>
+
+namespace pcl
+{
+  namespace registration
+  {
+    /** \brief PreparedTarget holds the state a registration builds from its target (the search tree, the covariances
+      * of GeneralizedIterativeClosestPoint, the voxel grid of NormalDistributionsTransform), built once and shared by
+      * any number of registrations aligning sources to the same target.
+      *
+      * The prepared state is never modified by the registrations it is assigned to, so they can run in parallel
+      * threads once the preparation is done:
+      * \code
+      * pcl::registration::PreparedTarget<pcl::PointXYZ>::Ptr map (new pcl::registration::PreparedTarget<pcl::PointXYZ> (map_cloud));
+      * map->computeCovariances (gicp);  // optional, for GeneralizedIterativeClosestPoint
+      * map->computeCells (1.0f);       // optional, for NormalDistributionsTransform
+      * // then in each thread
+      * map->assignTo (gicp);
+      * gicp.setInputSource (scan);
+      * gicp.align (aligned);
+      * \endcode
+      *
+      * \note The normals used by the point to plane estimations are fields of the target points, they are computed
+      * once with the target cloud and are not recomputed by the registrations.
+      * \ingroup registration
+      */
+    template <typename PointTarget>
+    class PreparedTarget
+    {
+      public:
+        using Ptr = shared_ptr<PreparedTarget<PointTarget> >;
+        using ConstPtr = shared_ptr<const PreparedTarget<PointTarget> >;
+
+        using PointCloudTarget = pcl::PointCloud<PointTarget>;
+        using PointCloudTargetConstPtr = typename PointCloudTarget::ConstPtr;
+
+        using KdTree = pcl::search::KdTree<PointTarget>;
+        using KdTreePtr = typename KdTree::Ptr;
+
+        using MatricesVector = std::vector< Eigen::Matrix3d, Eigen::aligned_allocator<Eigen::Matrix3d> >;
+        using MatricesVectorPtr = shared_ptr<MatricesVector>;
+
+        using TargetGrid = VoxelGridCovariance<PointTarget>;
+        using TargetGridConstPtr = shared_ptr<const TargetGrid>;
+
+        /** \brief Build the search tree of a target.
+          * \param[in] target the target point cloud
+          * \param[in] tree the search object to build, a new KdTree if none is given
+          */
+        PreparedTarget (const PointCloudTargetConstPtr &target, const KdTreePtr &tree = KdTreePtr ());
+
+        /** \brief Get the target point cloud. */
+        inline const PointCloudTargetConstPtr &
+        getInputTarget () const
+        {
+          return (target_);
+        }
+
+        /** \brief Get the search tree of the target. */
+        inline const KdTreePtr &
+        getSearchMethodTarget () const
+        {
+          return (tree_);
+        }
+
+        /** \brief Compute the covariances of the target points as \a gicp would, with its number of neighbors,
+          * epsilon and number of threads.
+          * \param[in] gicp the registration defining the parameters of the covariances
+          */
+        template <typename PointSource> void
+        computeCovariances (const GeneralizedIterativeClosestPoint<PointSource, PointTarget> &gicp);
+
+        /** \brief Provide covariances of the target points computed externally. */
+        inline void
+        setCovariances (const MatricesVectorPtr &covariances)
+        {
+          covariances_ = covariances;
+        }
+
+        /** \brief Get the covariances of the target points, null if they were not computed. */
+        inline const MatricesVectorPtr &
+        getCovariances () const
+        {
+          return (covariances_);
+        }
+
+        /** \brief Build the searchable voxel grid used by NormalDistributionsTransform.
+          * \param[in] resolution the side length of the voxels
+          */
+        void
+        computeCells (float resolution);
+
+        /** \brief Get the voxel grid of the target, null if it was not built. */
+        inline const TargetGridConstPtr &
+        getCells () const
+        {
+          return (cells_);
+        }
+
+        /** \brief Set the target of a registration, with the prepared search tree.
+          * \param[in,out] reg the registration
+          */
+        template <typename PointSource, typename Scalar> void
+        assignTo (Registration<PointSource, PointTarget, Scalar> &reg) const;
+
+        /** \brief Set the target of a GeneralizedIterativeClosestPoint, with the prepared search tree and the prepared
+          * covariances if they were computed.
+          * \param[in,out] reg the registration
+          */
+        template <typename PointSource> void
+        assignTo (GeneralizedIterativeClosestPoint<PointSource, PointTarget> &reg) const;
+
+        /** \brief Set the target of a NormalDistributionsTransform, with the prepared search tree and the prepared
+          * voxel grid if it was built.
+          * \param[in,out] reg the registration
+          */
+        template <typename PointSource> void
+        assignTo (NormalDistributionsTransform<PointSource, PointTarget> &reg) const;
+
+      protected:
+        /** \brief The target point cloud. */
+        PointCloudTargetConstPtr target_;
+
+        /** \brief The search tree of the target. */
+        KdTreePtr tree_;
+
+        /** \brief The covariances of the target points. */
+        MatricesVectorPtr covariances_;
+
+        /** \brief The searchable voxel grid of the target. */
+        TargetGridConstPtr cells_;
+    };
+  }
+}
+
+#include <pcl/registration/impl/prepared_target.hpp>
@@ -43,6 +43,7 @@
 // PCL includes
 #include <pcl/pcl_base.h>
 #include <pcl/common/transforms.h>
+#include <pcl/common/instrumentation.h>
 #include <pcl/memory.h>
 #include <pcl/pcl_macros.h>
 #include <pcl/search/kdtree.h>
@@ -45,6 +45,9 @@
 #include <pcl/registration/transformation_validation.h>
 #include <pcl/registration/correspondence_rejection_poly.h>
 
+#include <cstdlib>
+#include <random>
+
 namespace pcl
 {
   /** \brief Pose estimation and alignment class using a prerejective RANSAC routine.
@@ -122,6 +125,8 @@ namespace pcl
         , feature_tree_ (new pcl::KdTreeFLANN<FeatureT>)
         , correspondence_rejector_poly_ (new CorrespondenceRejectorPoly)
         , inlier_fraction_ (0.0f)
+        , threads_ (1)
+        , seed_ (static_cast<unsigned int> (std::rand ()))
       {
         reg_name_ = "SampleConsensusPrerejective";
         correspondence_rejector_poly_->setSimilarityThreshold (0.6f);
@@ -239,14 +244,35 @@ namespace pcl
         return inliers_;
       }
 
+      /** \brief Initialize the scheduler and set the number of threads used to generate and evaluate the pose
+        * hypotheses. The hypotheses are drawn, prerejected, estimated and evaluated in parallel, and the result
+        * does not depend on the number of threads.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      void
+      setNumberOfThreads (unsigned int nr_threads = 0);
+
+      /** \brief Set the seed of the random generators (drawn with std::rand when the object is constructed by
+        * default). Each pose hypothesis is drawn with its own generator, seeded from the seed and the iteration, so
+        * that the same seed gives the same transformation with any number of threads.
+        * \param[in] seed the seed
+        */
+      inline void
+      setSeed (unsigned int seed) { seed_ = seed; }
+
+      /** \brief Get the seed of the random generators. */
+      inline unsigned int
+      getSeed () const { return (seed_); }
+
     protected:
       /** \brief Choose a random index between 0 and n-1
         * \param n the number of possible indices to choose from
+        * \param rng the random generator of the pose hypothesis
         */
       inline int 
-      getRandomIndex (int n) const
+      getRandomIndex (int n, std::mt19937 &rng) const
       {
-        return (static_cast<int> (n * (rand () / (RAND_MAX + 1.0))));
+        return (static_cast<int> (n * (rng () / (static_cast<double> (std::mt19937::max ()) + 1.0))));
       };
       
       /** \brief Select \a nr_samples sample points from cloud while making sure that their pairwise distances are 
@@ -254,9 +280,10 @@ namespace pcl
         * \param cloud the input point cloud
         * \param nr_samples the number of samples to select
         * \param sample_indices the resulting sample indices
+        * \param rng the random generator of the pose hypothesis
         */
       void 
-      selectSamples (const PointCloudSource &cloud, int nr_samples, std::vector<int> &sample_indices);
+      selectSamples (const PointCloudSource &cloud, int nr_samples, std::vector<int> &sample_indices, std::mt19937 &rng);
 
       /** \brief For each of the sample points, find a list of points in the target cloud whose features are similar to 
         * the sample points' features. From these, select one randomly which will be considered that sample point's 
@@ -264,11 +291,13 @@ namespace pcl
         * \param sample_indices the indices of each sample point
         * \param similar_features correspondence cache, which is used to read/write already computed correspondences
         * \param corresponding_indices the resulting indices of each sample's corresponding point in the target cloud
+        * \param rng the random generator of the pose hypothesis
         */
       void 
       findSimilarFeatures (const std::vector<int> &sample_indices,
               std::vector<std::vector<int> >& similar_features,
-              std::vector<int> &corresponding_indices);
+              std::vector<int> &corresponding_indices,
+              std::mt19937 &rng);
 
       /** \brief Rigid transformation computation method.
         * \param output the transformed input point cloud dataset using the rigid transformation found
@@ -288,6 +317,16 @@ namespace pcl
       void 
       getFitness (std::vector<int>& inliers, float& fitness_score);
 
+      /** \brief Obtain the fitness of a given transformation, see getFitness.
+        * The evaluation stops as soon as too many points are outliers to reach the required inlier fraction, the
+        * fitness score is then the maximum float value.
+        * \param transformation the transformation to evaluate
+        * \param inliers indices of source point cloud inliers
+        * \param fitness_score output fitness score as RMSE
+        */
+      void
+      getFitness (const Matrix4 &transformation, std::vector<int>& inliers, float& fitness_score) const;
+
       /** \brief The source point cloud's feature descriptors. */
       FeatureCloudConstPtr input_features_;
 
@@ -311,6 +350,12 @@ namespace pcl
       
       /** \brief Inlier points of final transformation as indices into source */
       std::vector<int> inliers_;
+
+      /** \brief The number of threads the scheduler should use. */
+      unsigned int threads_;
+
+      /** \brief The seed of the random generators of the pose hypotheses. */
+      unsigned int seed_;
   };
 }
 
@@ -86,7 +86,9 @@ namespace pcl
           tmp_tgt_ (src.tmp_tgt_), 
           tmp_idx_src_ (src.tmp_idx_src_), 
           tmp_idx_tgt_ (src.tmp_idx_tgt_), 
-          warp_point_ (src.warp_point_)
+          warp_point_ (src.warp_point_),
+          use_analytic_jacobian_ (src.use_analytic_jacobian_),
+          threads_ (src.threads_)
         {};
 
         /** \brief Copy operator. 
@@ -100,6 +102,9 @@ namespace pcl
           tmp_idx_src_ = src.tmp_idx_src_;
           tmp_idx_tgt_ = src.tmp_idx_tgt_; 
           warp_point_ = src.warp_point_;
+          use_analytic_jacobian_ = src.use_analytic_jacobian_;
+          threads_ = src.threads_;
+          return (*this);
         }
 
          /** \brief Destructor. */
@@ -167,6 +172,35 @@ namespace pcl
           warp_point_ = warp_fcn;
         }
 
+        /** \brief Set whether the optimizer uses the analytic Jacobian of the residuals instead of numerical
+          * differentiation, when the warp function provides its derivatives (see WarpPointRigid::hasJacobian).
+          * Default: false.
+          *
+          * \note Subclasses overriding computeDistance have to override computeDistanceGradient accordingly.
+          * \param[in] use_analytic_jacobian whether to use the analytic Jacobian
+          */
+        inline void
+        setUseAnalyticJacobian (bool use_analytic_jacobian)
+        {
+          use_analytic_jacobian_ = use_analytic_jacobian;
+        }
+
+        /** \brief Get whether the optimizer uses the analytic Jacobian of the residuals. */
+        inline bool
+        getUseAnalyticJacobian () const
+        {
+          return (use_analytic_jacobian_);
+        }
+
+        /** \brief Set the number of threads computing the residuals and their Jacobian.
+          * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+          *
+          * \note computeDistance and computeDistanceGradient are called concurrently when more than a thread is
+          * used.
+          */
+        void
+        setNumberOfThreads (unsigned int nr_threads = 0);
+
       protected:
         /** \brief Compute the distance between a source point and its corresponding target point
           * \param[in] p_src The source point
@@ -202,6 +236,24 @@ namespace pcl
           return ((p_src - t).norm ());
         }
 
+        /** \brief Compute the derivatives of computeDistance with respect to the warped source point.
+          * \param[in] p_src The warped source point
+          * \param[in] p_tgt The target point
+          * \param[out] gradient The derivatives of the distance with respect to the coordinates of \a p_src
+          *
+          * \note Used by the analytic Jacobian (see setUseAnalyticJacobian), to be overridden together with
+          * computeDistance.
+          */
+        virtual void
+        computeDistanceGradient (const Vector4 &p_src, const PointTarget &p_tgt, Vector4 &gradient) const
+        {
+          Vector4 t (p_tgt.x, p_tgt.y, p_tgt.z, 0);
+          gradient = p_src - t;
+          const MatScalar norm = gradient.norm ();
+          if (norm > 0)
+            gradient /= norm;
+        }
+
         /** \brief Temporary pointer to the source dataset. */
         mutable const PointCloudSource *tmp_src_;
 
@@ -216,6 +268,12 @@ namespace pcl
 
         /** \brief The parameterized function used to warp the source to the target. */
         typename pcl::registration::WarpPointRigid<PointSource, PointTarget, MatScalar>::Ptr warp_point_;
+
+        /** \brief Whether the optimizer uses the analytic Jacobian of the residuals. */
+        bool use_analytic_jacobian_;
+
+        /** \brief The number of threads the scheduler should use. */
+        unsigned int threads_;
         
         /** Base functor all the models that need non linear optimization must
           * define their own one and implement operator() (const Eigen::VectorXd& x, Eigen::VectorXd& fvec)
@@ -296,6 +354,13 @@ namespace pcl
           int 
           operator () (const VectorX &x, VectorX &fvec) const;
 
+          /** Fill the Jacobian of the f values at the state vector x, from the derivatives of the warp.
+            * \param[in] x state vector
+            * \param[out] fjac the Jacobian of the f values
+            */
+          int
+          df (const VectorX &x, typename Functor<MatScalar>::JacobianType &fjac) const;
+
           const TransformationEstimationLM<PointSource, PointTarget, MatScalar> *estimator_;
         };
 
@@ -342,6 +407,13 @@ namespace pcl
           int 
           operator () (const VectorX &x, VectorX &fvec) const;
 
+          /** Fill the Jacobian of the f values at the state vector x, from the derivatives of the warp.
+            * \param[in] x state vector
+            * \param[out] fjac the Jacobian of the f values
+            */
+          int
+          df (const VectorX &x, typename Functor<MatScalar>::JacobianType &fjac) const;
+
           const TransformationEstimationLM<PointSource, PointTarget, MatScalar> *estimator_;
         };
       public:
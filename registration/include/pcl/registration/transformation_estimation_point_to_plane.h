@@ -93,6 +93,14 @@ namespace pcl
           return ((p_src - t).dot (n));
         }
 
+        void
+        computeDistanceGradient (const Vector4 &p_src, const PointTarget &p_tgt, Vector4 &gradient) const override
+        {
+          // The point-to-plane distance is linear along the normal
+          (void) p_src;
+          gradient = Vector4 (p_tgt.normal_x, p_tgt.normal_y, p_tgt.normal_z, 0);
+        }
+
     };
   }
 }
@@ -68,9 +68,16 @@ namespace pcl
 
         using Matrix4 = typename TransformationEstimation<PointSource, PointTarget, Scalar>::Matrix4;
         
-        TransformationEstimationPointToPlaneLLS () {};
+        TransformationEstimationPointToPlaneLLS () : threads_ (1) {};
         ~TransformationEstimationPointToPlaneLLS () {};
 
+        /** \brief Initialize the scheduler and set the number of threads to use for the accumulation of the normal
+          * equations of correspondences. A single thread gives the same result as the serial accumulation.
+          * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+          */
+        void
+        setNumberOfThreads (unsigned int nr_threads = 0);
+
         /** \brief Estimate a rigid rotation transformation between a source and a target point cloud using SVD.
           * \param[in] cloud_src the source point cloud dataset
           * \param[in] cloud_tgt the target point cloud dataset
@@ -124,7 +131,27 @@ namespace pcl
             Matrix4 &transformation_matrix) const override;
 
       protected:
-        
+        using Vector6d = Eigen::Matrix<double, 6, 1>;
+        using Matrix6d = Eigen::Matrix<double, 6, 6>;
+
+        /** \brief Add the equations of a pair of corresponding points to the normal equations, skipped if a coordinate
+          * or the normal is not finite. Only the three upper rows and the lower right block of ATA are accumulated.
+          * \param[in] source the source point
+          * \param[in] target the target point with its normal
+          * \param[in,out] ATA the normal matrix
+          * \param[in,out] ATb the right hand side
+          */
+        inline void
+        addCorrespondence (const PointSource &source, const PointTarget &target, Matrix6d &ATA, Vector6d &ATb) const;
+
+        /** \brief Complete the normal matrix by symmetry, solve the normal equations and construct the transformation.
+          * \param[in,out] ATA the normal matrix accumulated by addCorrespondence
+          * \param[in] ATb the right hand side
+          * \param[out] transformation_matrix the resultant transformation matrix
+          */
+        inline void
+        solveNormalEquations (Matrix6d &ATA, const Vector6d &ATb, Matrix4 &transformation_matrix) const;
+
         /** \brief Estimate a rigid rotation transformation between a source and a target
           * \param[in] source_it an iterator over the source point cloud dataset
           * \param[in] target_it an iterator over the target point cloud dataset
@@ -149,6 +176,9 @@ namespace pcl
                                        const double & tx,    const double & ty,   const double & tz,
                                        Matrix4 &transformation_matrix) const;
 
+        /** \brief The number of threads the scheduler should use. */
+        unsigned int threads_;
+
     };
   }
 }
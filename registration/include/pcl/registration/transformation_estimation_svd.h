@@ -67,6 +67,7 @@ namespace pcl
           * \param[in] use_umeyama Toggles whether or not to use 3rd party software*/
         TransformationEstimationSVD (bool use_umeyama=true):
           use_umeyama_ (use_umeyama)
+          , threads_ (1)
         {}
 
         ~TransformationEstimationSVD () {};
@@ -123,6 +124,12 @@ namespace pcl
             const pcl::Correspondences &correspondences,
             Matrix4 &transformation_matrix) const override;
 
+        /** \brief Set the number of threads gathering the points of correspondences.
+          * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+          */
+        void
+        setNumberOfThreads (unsigned int nr_threads = 0);
+
       protected:
 
         /** \brief Estimate a rigid rotation transformation between a source and a target
@@ -151,6 +158,9 @@ namespace pcl
             Matrix4 &transformation_matrix) const;
 
         bool use_umeyama_;
+
+        /** \brief The number of threads the scheduler should use. */
+        unsigned int threads_;
      };
 
   }
@@ -67,7 +67,7 @@ namespace pcl
         using Matrix4 = typename TransformationEstimation<PointSource, PointTarget, Scalar>::Matrix4;
         using Vector6 = Eigen::Matrix<Scalar, 6, 1>;
 
-        TransformationEstimationSymmetricPointToPlaneLLS () : enforce_same_direction_normals_ (true) {};
+        TransformationEstimationSymmetricPointToPlaneLLS () : enforce_same_direction_normals_ (true), threads_ (1) {};
         ~TransformationEstimationSymmetricPointToPlaneLLS () {};
 
         /** \brief Estimate a rigid rotation transformation between a source and a target point cloud using SVD.
@@ -132,7 +132,32 @@ namespace pcl
         inline bool
         getEnforceSameDirectionNormals ();
 
+        /** \brief Set the number of threads accumulating the normal equations of correspondences.
+          * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+          */
+        void
+        setNumberOfThreads (unsigned int nr_threads = 0);
+
       protected:
+        using Matrix6 = Eigen::Matrix<Scalar, 6, 6>;
+
+        /** \brief Add the equation of a correspondence to the normal equations, only the upper triangle of \a ATA is
+          * updated. The correspondences with non finite points or normals are skipped.
+          * \param[in] source the source point
+          * \param[in] target the target point
+          * \param[in,out] ATA the upper triangle of the matrix of the normal equations
+          * \param[in,out] ATb the right hand side of the normal equations
+          */
+        inline void
+        addCorrespondence (const PointSource &source, const PointTarget &target, Matrix6 &ATA, Vector6 &ATb) const;
+
+        /** \brief Solve the normal equations and construct the transformation from the solution.
+          * \param[in] ATA the upper triangle of the matrix of the normal equations
+          * \param[in] ATb the right hand side of the normal equations
+          * \param[out] transformation_matrix the resultant transformation matrix
+          */
+        inline void
+        solveNormalEquations (const Matrix6 &ATA, const Vector6 &ATb, Matrix4 &transformation_matrix) const;
 
         /** \brief Estimate a rigid rotation transformation between a source and a target
           * \param[in] source_it an iterator over the source point cloud dataset
@@ -155,6 +180,9 @@ namespace pcl
       /** \brief Whether or not to negate source and/or target normals such that they point in the same direction */
         bool enforce_same_direction_normals_;
 
+        /** \brief The number of threads the scheduler should use. */
+        unsigned int threads_;
+
     };
   }
 }
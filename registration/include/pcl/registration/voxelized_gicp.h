@@ -0,0 +1,163 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved
+ */
+
+#pragma once
+
+#include <pcl/registration/gicp.h>
+
+#include <cstdint>
+#include <unordered_map>
+
+namespace pcl
+{
+  /** \brief VoxelizedGeneralizedIterativeClosestPoint is a GeneralizedIterativeClosestPoint which aggregates the
+    * target into voxels, in the manner of the voxelized GICP of Koide et al., "Voxelized GICP for Fast and Accurate
+    * 3D Point Cloud Registration", ICRA 2021.
+    *
+    * The target points and their covariances are averaged in each voxel of a regular grid, once per target. The
+    * correspondence of a source point is then the voxel with the closest mean among the voxel it falls in and its
+    * 26 neighbors, found with hash lookups instead of a search in a kd-tree at every iteration, and the distribution
+    * of that voxel is used in the Mahalanobis distance. The voxels which are farther than the maximum
+    * correspondence distance from the source point are rejected.
+    *
+    * \code
+    * pcl::VoxelizedGeneralizedIterativeClosestPoint<pcl::PointXYZ, pcl::PointXYZ> vgicp;
+    * vgicp.setInputSource (source);
+    * vgicp.setInputTarget (target);
+    * vgicp.setResolution (0.5f);
+    * vgicp.setNumberOfThreads (0);
+    * vgicp.align (aligned);
+    * \endcode
+    *
+    * \note The resolution should be a few times the distance between the target points, so that enough points are
+    * averaged in each voxel, and the alignment has to be initialized within about a voxel.
+    * \ingroup registration
+    */
+  template <typename PointSource, typename PointTarget>
+  class VoxelizedGeneralizedIterativeClosestPoint : public GeneralizedIterativeClosestPoint<PointSource, PointTarget>
+  {
+    public:
+      using GeneralizedIterativeClosestPoint<PointSource, PointTarget>::reg_name_;
+      using GeneralizedIterativeClosestPoint<PointSource, PointTarget>::getClassName;
+      using GeneralizedIterativeClosestPoint<PointSource, PointTarget>::indices_;
+      using GeneralizedIterativeClosestPoint<PointSource, PointTarget>::target_;
+      using GeneralizedIterativeClosestPoint<PointSource, PointTarget>::transformation_;
+      using GeneralizedIterativeClosestPoint<PointSource, PointTarget>::corr_dist_threshold_;
+      using GeneralizedIterativeClosestPoint<PointSource, PointTarget>::input_covariances_;
+      using GeneralizedIterativeClosestPoint<PointSource, PointTarget>::target_covariances_;
+      using GeneralizedIterativeClosestPoint<PointSource, PointTarget>::mahalanobis_;
+      using GeneralizedIterativeClosestPoint<PointSource, PointTarget>::threads_;
+
+      using PointCloudSource = typename GeneralizedIterativeClosestPoint<PointSource, PointTarget>::PointCloudSource;
+      using PointCloudTarget = typename GeneralizedIterativeClosestPoint<PointSource, PointTarget>::PointCloudTarget;
+      using PointCloudTargetConstPtr = typename PointCloudTarget::ConstPtr;
+
+      using MatricesVector = typename GeneralizedIterativeClosestPoint<PointSource, PointTarget>::MatricesVector;
+      using MatricesVectorPtr = typename GeneralizedIterativeClosestPoint<PointSource, PointTarget>::MatricesVectorPtr;
+
+      using Ptr = shared_ptr< VoxelizedGeneralizedIterativeClosestPoint<PointSource, PointTarget> >;
+      using ConstPtr = shared_ptr< const VoxelizedGeneralizedIterativeClosestPoint<PointSource, PointTarget> >;
+
+      /** \brief Empty constructor. */
+      VoxelizedGeneralizedIterativeClosestPoint ()
+        : resolution_ (1.f)
+      {
+        reg_name_ = "VoxelizedGeneralizedIterativeClosestPoint";
+      }
+
+      /** \brief Provide a pointer to the input target (e.g., the point cloud that we want to align the input source to)
+        * \param[in] target the input point cloud target
+        */
+      inline void
+      setInputTarget (const PointCloudTargetConstPtr &target) override
+      {
+        GeneralizedIterativeClosestPoint<PointSource, PointTarget>::setInputTarget (target);
+        voxelized_covariances_.reset ();
+      }
+
+      /** \brief Set the side length of the voxels in which the target is aggregated.
+        * \param[in] resolution the side length of the voxels
+        */
+      inline void
+      setResolution (float resolution)
+      {
+        resolution_ = resolution;
+        voxelized_covariances_.reset ();
+      }
+
+      /** \brief Get the side length of the voxels in which the target is aggregated. */
+      inline float
+      getResolution () const
+      {
+        return (resolution_);
+      }
+
+      /** \brief Get the number of voxels the target was aggregated into, during the last alignment. */
+      inline std::size_t
+      getNumberOfVoxels () const
+      {
+        return (voxel_means_.size ());
+      }
+
+    protected:
+      /** \brief Find the closest voxel of each transformed source point and compute the Mahalanobis matrices with
+        * the voxel distributions, the voxels are built first if the target, its covariances or the resolution changed.
+        */
+      bool
+      findCorrespondences (const PointCloudSource &output, const Eigen::Matrix3d &R,
+                           std::vector<int> &source_indices, std::vector<int> &target_indices) override;
+
+      /** \brief The correspondences are the means of the voxels. */
+      const PointCloudTarget &
+      getCorrespondenceTarget () const override
+      {
+        return (voxel_means_);
+      }
+
+      /** \brief Aggregate the target points and covariances into the voxels. */
+      void
+      computeVoxels ();
+
+      /** \brief The coordinates of the voxel containing a point. */
+      inline Eigen::Vector3i
+      getVoxelCoordinates (const Eigen::Vector3f &p) const
+      {
+        return (Eigen::Vector3i (static_cast<int> (std::floor (p[0] / resolution_)),
+                                 static_cast<int> (std::floor (p[1] / resolution_)),
+                                 static_cast<int> (std::floor (p[2] / resolution_))));
+      }
+
+      /** \brief The key of a voxel, made of its coordinates on 21 bits each. */
+      static inline std::uint64_t
+      getVoxelKey (const Eigen::Vector3i &ijk)
+      {
+        const std::uint64_t mask = (std::uint64_t (1) << 21) - 1;
+        return (((static_cast<std::uint64_t> (ijk[0]) & mask) << 42) |
+                ((static_cast<std::uint64_t> (ijk[1]) & mask) << 21) |
+                 (static_cast<std::uint64_t> (ijk[2]) & mask));
+      }
+
+      /** \brief The side length of the voxels. */
+      float resolution_;
+
+      /** \brief The mean of the target points of each voxel. */
+      PointCloudTarget voxel_means_;
+
+      /** \brief The mean of the target covariances of each voxel. */
+      MatricesVector voxel_covariances_;
+
+      /** \brief The index of each voxel in voxel_means_, by key. */
+      std::unordered_map<std::uint64_t, int> voxel_map_;
+
+      /** \brief The target covariances the voxels were built from, null when they have to be built again. */
+      MatricesVectorPtr voxelized_covariances_;
+  };
+}
+
+#include <pcl/registration/impl/voxelized_gicp.hpp>
@@ -113,6 +113,24 @@ namespace pcl
           pnt_out[3] = 0.0;
         }
 
+        /** \brief Whether the warp provides the derivatives of the warped points with respect to its parameters
+          * (see getJacobian).
+          */
+        virtual bool
+        hasJacobian () const { return (false); }
+
+        /** \brief Get the derivatives of a warped point with respect to the warp parameters, at the parameters
+          * last given to setParam. Only valid when hasJacobian () is true.
+          * \param[in] pnt_in the point to warp (transform)
+          * \param[out] jacobian the 3 x getDimension () derivatives of the coordinates of the warped point
+          */
+        virtual void
+        getJacobian (const PointSourceT& pnt_in, Eigen::Matrix<Scalar, 3, Eigen::Dynamic>& jacobian) const
+        {
+          (void) pnt_in;
+          jacobian.setZero (3, nr_dim_);
+        }
+
         /** \brief Get the number of dimensions. */
         inline int 
         getDimension () const { return (nr_dim_); }
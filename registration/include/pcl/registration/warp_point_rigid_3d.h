@@ -90,6 +90,26 @@ namespace pcl
           Eigen::Rotation2D<Scalar> r (p[2]);
           trans.topLeftCorner (2, 2) = r.toRotationMatrix ();
         }
+
+        /** \brief The warp provides its derivatives. */
+        bool
+        hasJacobian () const override { return (true); }
+
+        /** \brief Get the derivatives of a warped point with respect to (tx ty rz).
+          * \param[in] pnt_in the point to warp (transform)
+          * \param[out] jacobian the 3 x 3 derivatives of the coordinates of the warped point
+          */
+        void
+        getJacobian (const PointSourceT& pnt_in, Eigen::Matrix<Scalar, 3, Eigen::Dynamic>& jacobian) const override
+        {
+          const Matrix4 &trans = this->transform_matrix_;
+          jacobian.setZero (3, 3);
+          jacobian (0, 0) = 1;
+          jacobian (1, 1) = 1;
+          // The derivative of the rotation is the rotation by 90 degrees more
+          jacobian (0, 2) = -trans (1, 0) * pnt_in.x - trans (1, 1) * pnt_in.y;
+          jacobian (1, 2) =  trans (0, 0) * pnt_in.x + trans (0, 1) * pnt_in.y;
+        }
     };
   }
 }
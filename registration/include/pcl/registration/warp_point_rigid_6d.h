@@ -91,7 +91,49 @@ namespace pcl
           q.w () = static_cast<Scalar> (std::sqrt (1 - q.dot (q)));
           q.normalize ();
           transform_matrix_.topLeftCorner (3, 3) = q.toRotationMatrix ();
+
+          // Derivatives of the rotation with respect to qx, qy and qz, w depending on them through
+          // dw/dk = -k/w
+          const Scalar w = q.w (), x = q.x (), y = q.y (), z = q.z ();
+          Eigen::Matrix<Scalar, 3, 3> d_w, d_x, d_y, d_z;
+          d_w <<  0, -2*z,  2*y,
+                2*z,    0, -2*x,
+               -2*y,  2*x,    0;
+          d_x <<  0,  2*y,  2*z,
+                2*y, -4*x, -2*w,
+                2*z,  2*w, -4*x;
+          d_y << -4*y, 2*x,  2*w,
+                  2*x,   0,  2*z,
+                 -2*w, 2*z, -4*y;
+          d_z << -4*z, -2*w, 2*x,
+                  2*w, -4*z, 2*y,
+                  2*x,  2*y,   0;
+          rotation_derivatives_[0] = d_x - d_w * (x / w);
+          rotation_derivatives_[1] = d_y - d_w * (y / w);
+          rotation_derivatives_[2] = d_z - d_w * (z / w);
         }
+
+        /** \brief The warp provides its derivatives. */
+        bool
+        hasJacobian () const override { return (true); }
+
+        /** \brief Get the derivatives of a warped point with respect to (tx ty tz qx qy qz).
+          * \param[in] pnt_in the point to warp (transform)
+          * \param[out] jacobian the 3 x 6 derivatives of the coordinates of the warped point
+          */
+        void
+        getJacobian (const PointSourceT& pnt_in, Eigen::Matrix<Scalar, 3, Eigen::Dynamic>& jacobian) const override
+        {
+          const Eigen::Matrix<Scalar, 3, 1> p (pnt_in.x, pnt_in.y, pnt_in.z);
+          jacobian.resize (3, 6);
+          jacobian.template leftCols<3> ().setIdentity ();
+          for (int k = 0; k < 3; ++k)
+            jacobian.col (3 + k) = rotation_derivatives_[k] * p;
+        }
+
+      protected:
+        /** \brief The derivatives of the rotation with respect to qx, qy and qz. */
+        Eigen::Matrix<Scalar, 3, 3> rotation_derivatives_[3];
     };
   }
 }
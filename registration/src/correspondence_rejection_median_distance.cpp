@@ -39,6 +39,24 @@
 
 #include <pcl/registration/correspondence_rejection_median_distance.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::registration::CorrespondenceRejectorMedianDistance::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs ();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////
 void
 pcl::registration::CorrespondenceRejectorMedianDistance::getRemainingCorrespondences (
@@ -48,7 +66,11 @@ pcl::registration::CorrespondenceRejectorMedianDistance::getRemainingCorresponde
   std::vector <double> dists;
   dists.resize (original_correspondences.size ());
 
-  for (std::size_t i = 0; i < original_correspondences.size (); ++i)
+#pragma omp parallel for \
+  default(none) \
+  shared(dists, original_correspondences) \
+  num_threads(threads_)
+  for (std::ptrdiff_t i = 0; i < static_cast<std::ptrdiff_t> (original_correspondences.size ()); ++i)
   {
     if (data_container_)
       dists[i] = data_container_->getCorrespondenceScore (original_correspondences[i]);
@@ -56,6 +78,7 @@ pcl::registration::CorrespondenceRejectorMedianDistance::getRemainingCorresponde
       dists[i] = original_correspondences[i].distance;
   }
 
+  // The median is selected in linear time, without sorting the distances
   std::vector <double> nth (dists);
   nth_element (nth.begin (), nth.begin () + (nth.size () / 2), nth.end ());
   median_distance_ = nth [nth.size () / 2];
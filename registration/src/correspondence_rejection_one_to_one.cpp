@@ -45,24 +45,28 @@ pcl::registration::CorrespondenceRejectorOneToOne::getRemainingCorrespondences (
     const pcl::Correspondences& original_correspondences,
     pcl::Correspondences& remaining_correspondences)
 {
-  /* not really an efficient implementation */
-  pcl::Correspondences input = original_correspondences;
+  // Keep the closest correspondence of every match index, in a table indexed by match index instead of sorting
+  // the correspondences; the first one is kept on equal distances
+  int max_index_match = -1;
+  for (const auto &correspondence : original_correspondences)
+    max_index_match = std::max (max_index_match, correspondence.index_match);
 
-  std::sort (input.begin (), input.end (), pcl::registration::sortCorrespondencesByMatchIndexAndDistance ());
-
-  remaining_correspondences.resize (input.size ());
-  int index_last = -1;
-  unsigned int number_valid_correspondences = 0;
-  for (const auto &i : input)
+  std::vector<int> closest (max_index_match + 1, -1);
+  for (std::size_t i = 0; i < original_correspondences.size (); ++i)
   {
-    if (i.index_match < 0)
+    const int index_match = original_correspondences[i].index_match;
+    if (index_match < 0)
       continue;
-    if (i.index_match != index_last)
-    {
-      remaining_correspondences[number_valid_correspondences] = i;
-      index_last = i.index_match;
-      ++number_valid_correspondences;
-    }
+    int &closest_i = closest[index_match];
+    if (closest_i < 0 || original_correspondences[i].distance < original_correspondences[closest_i].distance)
+      closest_i = static_cast<int> (i);
   }
+
+  // The correspondences are listed by increasing match index
+  remaining_correspondences.resize (original_correspondences.size ());
+  unsigned int number_valid_correspondences = 0;
+  for (const int &closest_i : closest)
+    if (closest_i >= 0)
+      remaining_correspondences[number_valid_correspondences++] = original_correspondences[closest_i];
   remaining_correspondences.resize (number_valid_correspondences);
 }
@@ -39,6 +39,24 @@
 
 #include <pcl/registration/correspondence_rejection_surface_normal.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::registration::CorrespondenceRejectorSurfaceNormal::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs ();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////
 void
 pcl::registration::CorrespondenceRejectorSurfaceNormal::getRemainingCorrespondences (
@@ -51,14 +69,19 @@ pcl::registration::CorrespondenceRejectorSurfaceNormal::getRemainingCorresponden
     return;
   }
 
+  // Test each correspondence, in parallel, then keep the valid ones in their order
+  std::vector<std::uint8_t> valid (original_correspondences.size ());
+#pragma omp parallel for \
+  default(none) \
+  shared(valid, original_correspondences) \
+  num_threads(threads_)
+  for (std::ptrdiff_t i = 0; i < static_cast<std::ptrdiff_t> (original_correspondences.size ()); ++i)
+    valid[i] = data_container_->getCorrespondenceScoreFromNormals (original_correspondences[i]) > threshold_;
+
   unsigned int number_valid_correspondences = 0;
   remaining_correspondences.resize (original_correspondences.size ());
-
-  // Test each correspondence
-  for (const auto &original_correspondence : original_correspondences)
-  {
-    if (data_container_->getCorrespondenceScoreFromNormals (original_correspondence) > threshold_)
-      remaining_correspondences[number_valid_correspondences++] = original_correspondence;
-  }
+  for (std::size_t i = 0; i < original_correspondences.size (); ++i)
+    if (valid[i])
+      remaining_correspondences[number_valid_correspondences++] = original_correspondences[i];
   remaining_correspondences.resize (number_valid_correspondences);
 }
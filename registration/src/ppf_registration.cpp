@@ -49,29 +49,49 @@
 void
 pcl::PPFHashMapSearch::setInputFeatureCloud (PointCloud<PPFSignature>::ConstPtr feature_cloud)
 {
-  // Discretize the feature cloud and insert it in the hash map
-  feature_hash_map_->clear ();
-  unsigned int n = static_cast<unsigned int> (std::sqrt (static_cast<float> (feature_cloud->size ())));
-  int d1, d2, d3, d4;
+  const std::size_t n = static_cast<std::size_t> (std::sqrt (static_cast<float> (feature_cloud->size ())));
   max_dist_ = -1.0;
-  alpha_m_.resize (n);
+  alpha_m_.assign (n, std::vector<float> (n));
+  buckets_.assign (16, Bucket ());
+  nr_used_buckets_ = 0;
+
+  // Discretize the feature cloud and count the pairs of every bin, in the end of its slot
+  std::size_t nr_pairs = 0;
   for (std::size_t i = 0; i < n; ++i)
-  {
-    std::vector <float> alpha_m_row (n);
     for (std::size_t j = 0; j < n; ++j)
     {
-      d1 = static_cast<int> (std::floor ((*feature_cloud)[i*n+j].f1 / angle_discretization_step_));
-      d2 = static_cast<int> (std::floor ((*feature_cloud)[i*n+j].f2 / angle_discretization_step_));
-      d3 = static_cast<int> (std::floor ((*feature_cloud)[i*n+j].f3 / angle_discretization_step_));
-      d4 = static_cast<int> (std::floor ((*feature_cloud)[i*n+j].f4 / distance_discretization_step_));
-      feature_hash_map_->insert (std::pair<HashKeyStruct, std::pair<std::size_t, std::size_t> > (HashKeyStruct (d1, d2, d3, d4), std::pair<std::size_t, std::size_t> (i, j)));
-      alpha_m_row [j] = (*feature_cloud)[i*n + j].alpha_m;
-
-      if (max_dist_ < (*feature_cloud)[i*n + j].f4)
-        max_dist_ = (*feature_cloud)[i*n + j].f4;
+      const PPFSignature &feature = (*feature_cloud)[i*n + j];
+      alpha_m_[i][j] = feature.alpha_m;
+
+      if (max_dist_ < feature.f4)
+        max_dist_ = feature.f4;
+
+      if (!std::isfinite (feature.f1) || !std::isfinite (feature.f2) || !std::isfinite (feature.f3) || !std::isfinite (feature.f4))
+        continue;
+      ++buckets_[insertBucket (discretize (feature.f1, feature.f2, feature.f3, feature.f4))].end;
+      ++nr_pairs;
+    }
+
+  // Give every bin its range of pairs, begin is used as the insertion position
+  std::size_t offset = 0;
+  for (Bucket &bucket : buckets_)
+    if (bucket.end != 0)
+    {
+      offset += bucket.end;
+      bucket.begin = bucket.end = offset;
+    }
+
+  // Insert the pairs from the back of their range
+  pairs_.resize (nr_pairs);
+  for (std::size_t i = 0; i < n; ++i)
+    for (std::size_t j = 0; j < n; ++j)
+    {
+      const PPFSignature &feature = (*feature_cloud)[i*n + j];
+      if (!std::isfinite (feature.f1) || !std::isfinite (feature.f2) || !std::isfinite (feature.f3) || !std::isfinite (feature.f4))
+        continue;
+      Bucket &bucket = buckets_[findBucket (discretize (feature.f1, feature.f2, feature.f3, feature.f4))];
+      pairs_[--bucket.begin] = std::pair<std::size_t, std::size_t> (i, j);
     }
-    alpha_m_[i] = alpha_m_row;
-  }
 
   internals_initialized_ = true;
 }
@@ -80,7 +100,7 @@ pcl::PPFHashMapSearch::setInputFeatureCloud (PointCloud<PPFSignature>::ConstPtr
 //////////////////////////////////////////////////////////////////////////////////////////////
 void
 pcl::PPFHashMapSearch::nearestNeighborSearch (float &f1, float &f2, float &f3, float &f4,
-                                              std::vector<std::pair<std::size_t, std::size_t> > &indices)
+                                              std::vector<std::pair<std::size_t, std::size_t> > &indices) const
 {
   if (!internals_initialized_)
   {
@@ -88,15 +108,63 @@ pcl::PPFHashMapSearch::nearestNeighborSearch (float &f1, float &f2, float &f3, f
     return;
   }
 
-  int d1 = static_cast<int> (std::floor (f1 / angle_discretization_step_)),
-      d2 = static_cast<int> (std::floor (f2 / angle_discretization_step_)),
-      d3 = static_cast<int> (std::floor (f3 / angle_discretization_step_)),
-      d4 = static_cast<int> (std::floor (f4 / distance_discretization_step_));
-
-  indices.clear ();
-  HashKeyStruct key = HashKeyStruct (d1, d2, d3, d4);
-  auto map_iterator_pair = feature_hash_map_->equal_range (key);
-  for (; map_iterator_pair.first != map_iterator_pair.second; ++ map_iterator_pair.first)
-    indices.emplace_back(map_iterator_pair.first->second.first,
-                                                  map_iterator_pair.first->second.second);
+  const Bucket &bucket = buckets_[findBucket (discretize (f1, f2, f3, f4))];
+  indices.assign (pairs_.begin () + bucket.begin, pairs_.begin () + bucket.end);
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+pcl::PPFHashMapSearch::HashKeyStruct
+pcl::PPFHashMapSearch::discretize (float f1, float f2, float f3, float f4) const
+{
+  return (HashKeyStruct (static_cast<int> (std::floor (f1 / angle_discretization_step_)),
+                         static_cast<int> (std::floor (f2 / angle_discretization_step_)),
+                         static_cast<int> (std::floor (f3 / angle_discretization_step_)),
+                         static_cast<int> (std::floor (f4 / distance_discretization_step_))));
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+std::size_t
+pcl::PPFHashMapSearch::findBucket (const HashKeyStruct &key) const
+{
+  // Mix the four values, the low bits of the hash are used for the slot
+  std::uint64_t hash = static_cast<std::uint32_t> (key.first);
+  hash = hash * 0x9E3779B97F4A7C15ull + static_cast<std::uint32_t> (key.second.first);
+  hash = hash * 0x9E3779B97F4A7C15ull + static_cast<std::uint32_t> (key.second.second.first);
+  hash = hash * 0x9E3779B97F4A7C15ull + static_cast<std::uint32_t> (key.second.second.second);
+  hash ^= hash >> 29;
+  hash *= 0xBF58476D1CE4E5B9ull;
+  hash ^= hash >> 32;
+
+  const std::size_t mask = buckets_.size () - 1;
+  std::size_t slot = static_cast<std::size_t> (hash) & mask;
+  while (buckets_[slot].end != 0 && buckets_[slot].key != key)
+    slot = (slot + 1) & mask;
+  return (slot);
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+std::size_t
+pcl::PPFHashMapSearch::insertBucket (const HashKeyStruct &key)
+{
+  std::size_t slot = findBucket (key);
+  if (buckets_[slot].end != 0)
+    return (slot);
+
+  // Keep the table at most half full, so that the probe sequences stay short
+  if (2 * (nr_used_buckets_ + 1) > buckets_.size ())
+  {
+    std::vector<Bucket> buckets (2 * buckets_.size ());
+    buckets.swap (buckets_);
+    for (const Bucket &bucket : buckets)
+      if (bucket.end != 0)
+        buckets_[findBucket (bucket.key)] = bucket;
+    slot = findBucket (key);
+  }
+
+  buckets_[slot].key = key;
+  ++nr_used_buckets_;
+  return (slot);
 }
@@ -42,6 +42,15 @@
 #define PCL_SAMPLE_CONSENSUS_IMPL_LMEDS_H_
 
 #include <pcl/sample_consensus/lmeds.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#if defined _OPENMP && _OPENMP >= 201107 // We need OpenMP 3.1 for the atomic constructs
+#define OPENMP_AVAILABLE_LMEDS true
+#else
+#define OPENMP_AVAILABLE_LMEDS false
+#endif
 
 //////////////////////////////////////////////////////////////////////////
 template <typename PointT> bool
@@ -64,86 +73,152 @@ pcl::LeastMedianSquares<PointT>::computeModel (int debug_verbosity_level)
   unsigned skipped_count = 0;
   // suppress infinite loops by just allowing 10 x maximum allowed iterations for invalid model parameters!
   const unsigned max_skip = max_iterations_ * 10;
-  
-  // Iterate
-  while ((iterations_ < max_iterations_) && (skipped_count < max_skip))
-  {
-    // Get X samples which satisfy the model criteria
-    sac_model_->getSamples (iterations_, selection);
 
-    if (selection.empty ())
+  int threads = threads_;
+  if (threads >= 0)
+  {
+#if OPENMP_AVAILABLE_LMEDS
+    if (threads == 0)
     {
-      break;
+      threads = omp_get_num_procs();
+      PCL_DEBUG ("[pcl::LeastMedianSquares::computeModel] Automatic number of threads requested, choosing %i threads.\n", threads);
     }
+#else
+    // Parallelization desired, but not available
+    PCL_WARN ("[pcl::LeastMedianSquares::computeModel] Parallelization is requested, but OpenMP 3.1 is not available! Continuing without parallelization.\n");
+    threads = -1;
+#endif
+  }
 
-    // Search for inliers in the point cloud for the current plane model M
-    if (!sac_model_->computeModelCoefficients (selection, model_coefficients))
+#if OPENMP_AVAILABLE_LMEDS
+#pragma omp parallel if(threads > 0) num_threads(threads) shared(skipped_count, d_best_penalty) firstprivate(selection, model_coefficients, distances)
+#endif
+  {
+    // Iterate
+    while (true)
     {
-      //iterations_++;
-      ++skipped_count;
-      continue;
-    }
+      int iterations_tmp;
+      unsigned skipped_count_tmp;
+#if OPENMP_AVAILABLE_LMEDS
+#pragma omp atomic read
+#endif
+      iterations_tmp = iterations_;
+#if OPENMP_AVAILABLE_LMEDS
+#pragma omp atomic read
+#endif
+      skipped_count_tmp = skipped_count;
+      if ((iterations_tmp >= max_iterations_) || (skipped_count_tmp >= max_skip))
+        break;
 
-    double d_cur_penalty;
-    // d_cur_penalty = sum (min (dist, threshold))
+      // Get X samples which satisfy the model criteria
+#if OPENMP_AVAILABLE_LMEDS
+#pragma omp critical(samples)
+#endif
+      {
+        sac_model_->getSamples (iterations_, selection); // The random number generator used when choosing the samples should not be called in parallel
+      }
 
-    // Iterate through the 3d points and calculate the distances from them to the model
-    sac_model_->getDistancesToModel (model_coefficients, distances);
-    
-    // No distances? The model must not respect the user given constraints
-    if (distances.empty ())
-    {
-      //iterations_++;
-      ++skipped_count;
-      continue;
-    }
-    // Move all NaNs in distances to the end
-    const auto new_end = (sac_model_->getInputCloud()->is_dense ? distances.end() : std::partition (distances.begin(), distances.end(), [](double d){return !std::isnan (d);}));
-    const auto nr_valid_dists = std::distance (distances.begin (), new_end);
-
-    // d_cur_penalty = median (distances)
-    const std::size_t mid = nr_valid_dists / 2;
-    PCL_DEBUG ("[pcl::LeastMedianSquares::computeModel] There are %lu valid distances remaining after removing NaN values.\n", nr_valid_dists);
-    if (nr_valid_dists == 0)
-    {
-      //iterations_++;
-      ++skipped_count;
-      continue;
-    }
+      if (selection.empty ())
+      {
+        break;
+      }
 
-    // Do we have a "middle" point or should we "estimate" one ?
-    if ((nr_valid_dists % 2) == 0)
-    {
-      // Looking at two values instead of one probably doesn't matter because they are mostly barely different, but let's do it for accuracy's sake
-      std::nth_element (distances.begin (), distances.begin () + (mid - 1), new_end);
-      const double tmp = distances[mid-1];
-      const double tmp2 = *(std::min_element (distances.begin () + mid, new_end));
-      d_cur_penalty = (sqrt (tmp) + sqrt (tmp2)) / 2.0;
-      PCL_DEBUG ("[pcl::LeastMedianSquares::computeModel] Computing median with two values (%g and %g) because number of distances is even.\n", tmp, distances[mid]);
-    }
-    else
-    {
-      std::nth_element (distances.begin (), distances.begin () + mid, new_end);
-      d_cur_penalty = sqrt (distances[mid]);
-      PCL_DEBUG ("[pcl::LeastMedianSquares::computeModel] Computing median with one value (%g) because number of distances is odd.\n", distances[mid]);
-    }
+      // Search for inliers in the point cloud for the current plane model M
+      if (!sac_model_->computeModelCoefficients (selection, model_coefficients))
+      {
+        //iterations_++;
+#if OPENMP_AVAILABLE_LMEDS
+#pragma omp atomic
+#endif
+        ++skipped_count;
+        continue;
+      }
 
-    // Better match ?
-    if (d_cur_penalty < d_best_penalty)
-    {
-      d_best_penalty = d_cur_penalty;
+      double d_cur_penalty;
+      // d_cur_penalty = sum (min (dist, threshold))
 
-      // Save the current model/coefficients selection as being the best so far
-      model_              = selection;
-      model_coefficients_ = model_coefficients;
-    }
+      // Iterate through the 3d points and calculate the distances from them to the model
+      sac_model_->getDistancesToModel (model_coefficients, distances);
 
-    ++iterations_;
-    if (debug_verbosity_level > 1)
-    {
-      PCL_DEBUG ("[pcl::LeastMedianSquares::computeModel] Trial %d out of %d. Best penalty is %f.\n", iterations_, max_iterations_, d_best_penalty);
-    }
-  }
+      // No distances? The model must not respect the user given constraints
+      if (distances.empty ())
+      {
+        //iterations_++;
+#if OPENMP_AVAILABLE_LMEDS
+#pragma omp atomic
+#endif
+        ++skipped_count;
+        continue;
+      }
+      // Move all NaNs in distances to the end
+      const auto new_end = (sac_model_->getInputCloud()->is_dense ? distances.end() : std::partition (distances.begin(), distances.end(), [](double d){return !std::isnan (d);}));
+      const auto nr_valid_dists = std::distance (distances.begin (), new_end);
+
+      // d_cur_penalty = median (distances)
+      const std::size_t mid = nr_valid_dists / 2;
+      PCL_DEBUG ("[pcl::LeastMedianSquares::computeModel] There are %lu valid distances remaining after removing NaN values.\n", nr_valid_dists);
+      if (nr_valid_dists == 0)
+      {
+        //iterations_++;
+#if OPENMP_AVAILABLE_LMEDS
+#pragma omp atomic
+#endif
+        ++skipped_count;
+        continue;
+      }
+
+      // Do we have a "middle" point or should we "estimate" one ?
+      if ((nr_valid_dists % 2) == 0)
+      {
+        // Looking at two values instead of one probably doesn't matter because they are mostly barely different, but let's do it for accuracy's sake
+        std::nth_element (distances.begin (), distances.begin () + (mid - 1), new_end);
+        const double tmp = distances[mid-1];
+        const double tmp2 = *(std::min_element (distances.begin () + mid, new_end));
+        d_cur_penalty = (sqrt (tmp) + sqrt (tmp2)) / 2.0;
+        PCL_DEBUG ("[pcl::LeastMedianSquares::computeModel] Computing median with two values (%g and %g) because number of distances is even.\n", tmp, distances[mid]);
+      }
+      else
+      {
+        std::nth_element (distances.begin (), distances.begin () + mid, new_end);
+        d_cur_penalty = sqrt (distances[mid]);
+        PCL_DEBUG ("[pcl::LeastMedianSquares::computeModel] Computing median with one value (%g) because number of distances is odd.\n", distances[mid]);
+      }
+
+      double d_best_penalty_tmp;
+#if OPENMP_AVAILABLE_LMEDS
+#pragma omp atomic read
+#endif
+      d_best_penalty_tmp = d_best_penalty;
+
+      // Better match ?
+      if (d_cur_penalty < d_best_penalty_tmp)
+      {
+#if OPENMP_AVAILABLE_LMEDS
+#pragma omp critical(update) // d_best_penalty, model_, model_coefficients_ are shared and read/write must be protected
+#endif
+        {
+          if (d_cur_penalty < d_best_penalty)
+          {
+            d_best_penalty = d_cur_penalty;
+
+            // Save the current model/coefficients selection as being the best so far
+            model_              = selection;
+            model_coefficients_ = model_coefficients;
+          }
+          d_best_penalty_tmp = d_best_penalty;
+        } // omp critical
+      }
+
+#if OPENMP_AVAILABLE_LMEDS
+#pragma omp atomic capture
+#endif
+      iterations_tmp = ++iterations_;
+      if (debug_verbosity_level > 1)
+      {
+        PCL_DEBUG ("[pcl::LeastMedianSquares::computeModel] Trial %d out of %d. Best penalty is %f.\n", iterations_tmp, max_iterations_, d_best_penalty_tmp);
+      }
+    } // while
+  } // omp parallel
 
   if (model_.empty ())
   {
@@ -42,6 +42,7 @@
 #define PCL_SAMPLE_CONSENSUS_IMPL_RANSAC_H_
 
 #include <pcl/sample_consensus/ransac.h>
+#include <pcl/common/utils.h> // for getNumberOfThreads
 #ifdef _OPENMP
 #include <omp.h>
 #endif
@@ -78,6 +79,106 @@ pcl::RandomSampleConsensus<PointT>::computeModel (int)
   // suppress infinite loops by just allowing 10 x maximum allowed iterations for invalid model parameters!
   const unsigned max_skip = max_iterations_ * 10;
 
+  // Compute the k parameter (k=std::log(z)/std::log(1-w^n)). With the SPRT, the hypothesis of a good sample is
+  // rejected with a probability of 1/A, so a good sample is found with a probability of w^n(1-1/A)
+  const auto compute_k = [log_probability] (double w, std::size_t sample_size, double log_a)
+  {
+    double p_no_outliers = 1.0 - std::pow (w, static_cast<double> (sample_size)) * (1.0 - std::exp (-log_a));
+    p_no_outliers = (std::max) (std::numeric_limits<double>::epsilon (), p_no_outliers);       // Avoid division by -Inf
+    p_no_outliers = (std::min) (1.0 - std::numeric_limits<double>::epsilon (), p_no_outliers);   // Avoid division by 0.
+    return (log_probability / std::log (p_no_outliers));
+  };
+
+  // The SPRT verifies a random part of the points, by blocks after which it decides whether to reject the hypothesis.
+  // The bad hypotheses are rejected after a few blocks, and the inliers of the others are counted on all the points
+  // in their order, which is much faster than in a random one. epsilon and delta are the probabilities that a point
+  // is an inlier of a good and of a bad model, epsilon is the inlier ratio of the best model so far and delta the
+  // inlier ratio of the rejected models. No hypothesis is rejected before a first model was verified.
+  std::vector<Indices> sprt_blocks;
+  double sprt_epsilon = 0.0, sprt_delta = 0.01;
+  double sprt_log_a = std::numeric_limits<double>::infinity ();
+  double sprt_log_inlier = 0.0, sprt_log_outlier = 0.0;
+  std::size_t sprt_rejected_inliers = 0, sprt_rejected_points = 0;
+  if (use_sprt_)
+  {
+    // The test draws the points it verifies from the first ones of the partially shuffled indices
+    Indices shuffled_indices (*sac_model_->getIndices ());
+    const std::size_t nr_sprt_points = (std::min) (shuffled_indices.size (), (std::max) (shuffled_indices.size () / 128, std::size_t (1024)));
+    for (std::size_t i = 0; i < nr_sprt_points; ++i)
+      std::swap (shuffled_indices[i], shuffled_indices[i + static_cast<std::size_t> (static_cast<double> (shuffled_indices.size () - i) * rnd ())]);
+
+    const std::size_t block_size = 64;
+    for (std::size_t i = 0; i < nr_sprt_points; i += block_size)
+      sprt_blocks.emplace_back (shuffled_indices.cbegin () + i, shuffled_indices.cbegin () + (std::min) (i + block_size, nr_sprt_points));
+  }
+
+  // Score a hypothesis: count its inliers, or with the SPRT verify it against the given thresholds. Returns true
+  // if the SPRT rejected it, the inliers are then counted on the n_verified points verified only
+  const auto score_hypothesis = [this, &sprt_blocks] (const Eigen::VectorXf &coefficients, double log_a, double log_inlier, double log_outlier,
+                                                      std::size_t &n_inliers_count, std::size_t &n_verified)
+  {
+    n_inliers_count = 0;
+    n_verified = 0;
+    if (!use_sprt_)
+    {
+      n_inliers_count = sac_model_->countWithinDistance (coefficients, threshold_); // This functions has to be thread-safe. Most work is done here
+      return (false);
+    }
+
+    // The likelihood ratio of the hypothesis being bad rather than good, the hypothesis is rejected when it exceeds A
+    double log_lambda = 0.0;
+    for (const Indices &block : sprt_blocks)
+    {
+      const std::size_t block_inliers = sac_model_->countSamplesWithinDistance (block, coefficients, threshold_); // This functions has to be thread-safe
+      n_inliers_count += block_inliers;
+      n_verified += block.size ();
+      log_lambda += static_cast<double> (block_inliers) * log_inlier + static_cast<double> (block.size () - block_inliers) * log_outlier;
+      if (log_lambda > log_a)
+        return (true);
+    }
+    n_inliers_count = sac_model_->countWithinDistance (coefficients, threshold_); // This functions has to be thread-safe. Most work is done here
+    return (false);
+  };
+
+  // Update the SPRT with a rejected hypothesis
+  const auto reject_hypothesis = [&] (std::size_t n_inliers_count, std::size_t n_verified, std::size_t sample_size)
+  {
+    sprt_rejected_inliers += n_inliers_count;
+    sprt_rejected_points += n_verified;
+    sprt_delta = (std::max) (static_cast<double> (sprt_rejected_inliers) / static_cast<double> (sprt_rejected_points), one_over_indices);
+    sprt_log_a = computeSPRTThreshold (sprt_epsilon, sprt_delta);
+    if (std::isfinite (sprt_log_a))
+    {
+      sprt_log_inlier = std::log (sprt_delta / sprt_epsilon);
+      sprt_log_outlier = std::log ((1.0 - sprt_delta) / (1.0 - sprt_epsilon));
+    }
+    k = compute_k (sprt_epsilon, sample_size, sprt_log_a);
+    PCL_DEBUG ("[pcl::RandomSampleConsensus::computeModel] Hypothesis rejected after verifying %lu points.\n", n_verified);
+  };
+
+  // Save a hypothesis with more inliers than the best one so far
+  const auto accept_hypothesis = [&] (std::size_t n_inliers_count, const Indices &sample, const Eigen::VectorXf &coefficients)
+  {
+    n_best_inliers_count = n_inliers_count;
+
+    // Save the current model/inlier/coefficients selection as being the best so far
+    model_              = sample;
+    model_coefficients_ = coefficients;
+
+    const double w = static_cast<double> (n_best_inliers_count) * one_over_indices;
+    if (use_sprt_)
+    {
+      sprt_epsilon = w;
+      sprt_log_a = computeSPRTThreshold (sprt_epsilon, sprt_delta);
+      if (std::isfinite (sprt_log_a))
+      {
+        sprt_log_inlier = std::log (sprt_delta / sprt_epsilon);
+        sprt_log_outlier = std::log ((1.0 - sprt_delta) / (1.0 - sprt_epsilon));
+      }
+    }
+    k = compute_k (w, sample.size (), sprt_log_a);
+  };
+
   int threads = threads_;
   if (threads >= 0)
   {
@@ -87,6 +188,8 @@ pcl::RandomSampleConsensus<PointT>::computeModel (int)
       threads = omp_get_num_procs();
       PCL_DEBUG ("[pcl::RandomSampleConsensus::computeModel] Automatic number of threads requested, choosing %i threads.\n", threads);
     }
+    // Within the limit of threads of the process, and serially when nested in another parallel region
+    threads = static_cast<int> (pcl::utils::getNumberOfThreads (static_cast<unsigned int> (threads)));
 #else
     // Parallelization desired, but not available
     PCL_WARN ("[pcl::RandomSampleConsensus::computeModel] Parallelization is requested, but OpenMP 3.1 is not available! Continuing without parallelization.\n");
@@ -94,113 +197,187 @@ pcl::RandomSampleConsensus<PointT>::computeModel (int)
 #endif
   }
 
-#if OPENMP_AVAILABLE_RANSAC
-#pragma omp parallel if(threads > 0) num_threads(threads) shared(k, skipped_count, n_best_inliers_count) firstprivate(selection, model_coefficients) // would be nice to have a default(none)-clause here, but then some compilers complain about the shared const variables
-#endif
+  if (deterministic_)
   {
-#if OPENMP_AVAILABLE_RANSAC
-    if (omp_in_parallel())
-#pragma omp master
-      PCL_DEBUG ("[pcl::RandomSampleConsensus::computeModel] Computing in parallel with up to %i threads.\n", omp_get_num_threads());
-    else
-#endif
-      PCL_DEBUG ("[pcl::RandomSampleConsensus::computeModel] Computing not parallel.\n");
+    // The samples of a batch are drawn serially in the order of the iterations, and the hypotheses are accepted in
+    // that order once the whole batch is scored. The size of the batches must not depend on the number of threads
+    const int batch_size = 64;
+    std::vector<Indices> batch_samples (batch_size);
+    std::vector<Eigen::VectorXf> batch_coefficients (batch_size);
+    std::vector<std::size_t> batch_inliers (batch_size), batch_verified (batch_size);
+    std::vector<char> batch_valid (batch_size), batch_rejected (batch_size);
+
+    PCL_DEBUG ("[pcl::RandomSampleConsensus::computeModel] Computing deterministically with up to %i threads.\n", (std::max) (threads, 1));
 
-    // Iterate
-    while (true) // infinite loop with four possible breaks
+    bool done = false;
+    while (!done)
     {
-      // Get X samples which satisfy the model criteria
+      int nr_samples = 0;
+      for (; nr_samples < batch_size; ++nr_samples)
+      {
+        sac_model_->getSamples (iterations_, batch_samples[nr_samples]);
+        if (batch_samples[nr_samples].empty ())
+          break;
+      }
+
+      // The whole batch is tested against the thresholds of the SPRT at its start
+      const double log_a = sprt_log_a, log_inlier = sprt_log_inlier, log_outlier = sprt_log_outlier;
 #if OPENMP_AVAILABLE_RANSAC
-#pragma omp critical(samples)
+#pragma omp parallel for if(threads > 0) num_threads(threads) schedule(dynamic)
 #endif
+      for (int i = 0; i < nr_samples; ++i)
       {
-        sac_model_->getSamples (iterations_, selection); // The random number generator used when choosing the samples should not be called in parallel
+        batch_valid[i] = sac_model_->computeModelCoefficients (batch_samples[i], batch_coefficients[i]); // This function has to be thread-safe
+        if (batch_valid[i])
+          batch_rejected[i] = score_hypothesis (batch_coefficients[i], log_a, log_inlier, log_outlier, batch_inliers[i], batch_verified[i]);
       }
 
-      if (selection.empty ())
+      for (int i = 0; i < nr_samples && !done; ++i)
+      {
+        if (!batch_valid[i])
+        {
+          done = ++skipped_count >= max_skip;
+          continue;
+        }
+
+        if (batch_rejected[i])
+          reject_hypothesis (batch_inliers[i], batch_verified[i], batch_samples[i].size ());
+        else if (batch_inliers[i] > n_best_inliers_count)
+          accept_hypothesis (batch_inliers[i], batch_samples[i], batch_coefficients[i]);
+
+        ++iterations_;
+        PCL_DEBUG ("[pcl::RandomSampleConsensus::computeModel] Trial %d out of %f: %u inliers (best is: %u so far).\n", iterations_, k, batch_inliers[i], n_best_inliers_count);
+        if (iterations_ > k)
+          done = true;
+        else if (iterations_ > max_iterations_)
+        {
+          PCL_DEBUG ("[pcl::RandomSampleConsensus::computeModel] RANSAC reached the maximum number of trials.\n");
+          done = true;
+        }
+      }
+
+      if (!done && nr_samples < batch_size)
       {
         PCL_ERROR ("[pcl::RandomSampleConsensus::computeModel] No samples could be selected!\n");
-        break;
+        done = true;
       }
+    }
+  }
+  else
+  {
+#if OPENMP_AVAILABLE_RANSAC
+#pragma omp parallel if(threads > 0) num_threads(threads) shared(k, skipped_count, n_best_inliers_count, sprt_epsilon, sprt_delta, sprt_log_a, sprt_log_inlier, sprt_log_outlier, sprt_rejected_inliers, sprt_rejected_points) firstprivate(selection, model_coefficients) // would be nice to have a default(none)-clause here, but then some compilers complain about the shared const variables
+#endif
+    {
+#if OPENMP_AVAILABLE_RANSAC
+      if (omp_in_parallel())
+#pragma omp master
+        PCL_DEBUG ("[pcl::RandomSampleConsensus::computeModel] Computing in parallel with up to %i threads.\n", omp_get_num_threads());
+      else
+#endif
+        PCL_DEBUG ("[pcl::RandomSampleConsensus::computeModel] Computing not parallel.\n");
 
-      // Search for inliers in the point cloud for the current plane model M
-      if (!sac_model_->computeModelCoefficients (selection, model_coefficients)) // This function has to be thread-safe
+      // Iterate
+      while (true) // infinite loop with four possible breaks
       {
-        //++iterations_;
-        unsigned skipped_count_tmp;
+        // Get X samples which satisfy the model criteria
 #if OPENMP_AVAILABLE_RANSAC
-#pragma omp atomic capture
+#pragma omp critical(samples)
 #endif
-        skipped_count_tmp = ++skipped_count;
-        if (skipped_count_tmp < max_skip)
-          continue;
-        else
+        {
+          sac_model_->getSamples (iterations_, selection); // The random number generator used when choosing the samples should not be called in parallel
+        }
+
+        if (selection.empty ())
+        {
+          PCL_ERROR ("[pcl::RandomSampleConsensus::computeModel] No samples could be selected!\n");
           break;
-      }
+        }
 
-      // Select the inliers that are within threshold_ from the model
-      //sac_model_->selectWithinDistance (model_coefficients, threshold_, inliers);
-      //if (inliers.empty () && k > 1.0)
-      //  continue;
+        // Search for inliers in the point cloud for the current plane model M
+        if (!sac_model_->computeModelCoefficients (selection, model_coefficients)) // This function has to be thread-safe
+        {
+          //++iterations_;
+          unsigned skipped_count_tmp;
+#if OPENMP_AVAILABLE_RANSAC
+#pragma omp atomic capture
+#endif
+          skipped_count_tmp = ++skipped_count;
+          if (skipped_count_tmp < max_skip)
+            continue;
+          else
+            break;
+        }
+
+        double log_a = 0.0, log_inlier = 0.0, log_outlier = 0.0;
+        if (use_sprt_)
+        {
+#if OPENMP_AVAILABLE_RANSAC
+#pragma omp critical(update)
+#endif
+          {
+            log_a = sprt_log_a;
+            log_inlier = sprt_log_inlier;
+            log_outlier = sprt_log_outlier;
+          }
+        }
 
-      std::size_t n_inliers_count = sac_model_->countWithinDistance (model_coefficients, threshold_); // This functions has to be thread-safe. Most work is done here
+        std::size_t n_inliers_count, n_verified;
+        const bool rejected = score_hypothesis (model_coefficients, log_a, log_inlier, log_outlier, n_inliers_count, n_verified);
+        if (rejected)
+        {
+#if OPENMP_AVAILABLE_RANSAC
+#pragma omp critical(update)
+#endif
+          reject_hypothesis (n_inliers_count, n_verified, selection.size ());
+        }
 
-      std::size_t n_best_inliers_count_tmp;
+        std::size_t n_best_inliers_count_tmp;
 #if OPENMP_AVAILABLE_RANSAC
 #pragma omp atomic read
 #endif
-      n_best_inliers_count_tmp = n_best_inliers_count;
+        n_best_inliers_count_tmp = n_best_inliers_count;
 
-      if (n_inliers_count > n_best_inliers_count_tmp) // This condition is false most of the time, and the critical region is not entered, hopefully leading to more efficient concurrency
-      {
+        if (!rejected && n_inliers_count > n_best_inliers_count_tmp) // This condition is false most of the time, and the critical region is not entered, hopefully leading to more efficient concurrency
+        {
 #if OPENMP_AVAILABLE_RANSAC
 #pragma omp critical(update) // n_best_inliers_count, model_, model_coefficients_, k are shared and read/write must be protected
 #endif
-        {
-          // Better match ?
-          if (n_inliers_count > n_best_inliers_count)
           {
-            n_best_inliers_count = n_inliers_count; // This write and the previous read of n_best_inliers_count must be consecutive and must not be interrupted!
-            n_best_inliers_count_tmp = n_best_inliers_count;
-
-            // Save the current model/inlier/coefficients selection as being the best so far
-            model_              = selection;
-            model_coefficients_ = model_coefficients;
-
-            // Compute the k parameter (k=std::log(z)/std::log(1-w^n))
-            const double w = static_cast<double> (n_best_inliers_count) * one_over_indices;
-            double p_no_outliers = 1.0 - std::pow (w, static_cast<double> (selection.size ()));
-            p_no_outliers = (std::max) (std::numeric_limits<double>::epsilon (), p_no_outliers);       // Avoid division by -Inf
-            p_no_outliers = (std::min) (1.0 - std::numeric_limits<double>::epsilon (), p_no_outliers);   // Avoid division by 0.
-            k = log_probability / std::log (p_no_outliers);
-          }
-        } // omp critical
-      }
+            // Better match ?
+            if (n_inliers_count > n_best_inliers_count)
+            {
+              accept_hypothesis (n_inliers_count, selection, model_coefficients); // This write and the previous read of n_best_inliers_count must be consecutive and must not be interrupted!
+              n_best_inliers_count_tmp = n_best_inliers_count;
+            }
+          } // omp critical
+        }
 
-      int iterations_tmp;
-      double k_tmp;
+        int iterations_tmp;
+        double k_tmp;
 #if OPENMP_AVAILABLE_RANSAC
 #pragma omp atomic capture
 #endif
-      iterations_tmp = ++iterations_;
+        iterations_tmp = ++iterations_;
 #if OPENMP_AVAILABLE_RANSAC
 #pragma omp atomic read
 #endif
-      k_tmp = k;
+        k_tmp = k;
 #if OPENMP_AVAILABLE_RANSAC
-      PCL_DEBUG ("[pcl::RandomSampleConsensus::computeModel] Trial %d out of %f: %u inliers (best is: %u so far) (thread %d).\n", iterations_tmp, k_tmp, n_inliers_count, n_best_inliers_count_tmp, omp_get_thread_num());
+        PCL_DEBUG ("[pcl::RandomSampleConsensus::computeModel] Trial %d out of %f: %u inliers (best is: %u so far) (thread %d).\n", iterations_tmp, k_tmp, n_inliers_count, n_best_inliers_count_tmp, omp_get_thread_num());
 #else
-      PCL_DEBUG ("[pcl::RandomSampleConsensus::computeModel] Trial %d out of %f: %u inliers (best is: %u so far).\n", iterations_tmp, k_tmp, n_inliers_count, n_best_inliers_count_tmp);
+        PCL_DEBUG ("[pcl::RandomSampleConsensus::computeModel] Trial %d out of %f: %u inliers (best is: %u so far).\n", iterations_tmp, k_tmp, n_inliers_count, n_best_inliers_count_tmp);
 #endif
-      if (iterations_tmp > k_tmp)
-        break;
-      if (iterations_tmp > max_iterations_)
-      {
-        PCL_DEBUG ("[pcl::RandomSampleConsensus::computeModel] RANSAC reached the maximum number of trials.\n");
-        break;
-      }
-    } // while
-  } // omp parallel
+        if (iterations_tmp > k_tmp)
+          break;
+        if (iterations_tmp > max_iterations_)
+        {
+          PCL_DEBUG ("[pcl::RandomSampleConsensus::computeModel] RANSAC reached the maximum number of trials.\n");
+          break;
+        }
+      } // while
+    } // omp parallel
+  }
 
   PCL_DEBUG ("[pcl::RandomSampleConsensus::computeModel] Model: %lu size, %u inliers.\n", model_.size (), n_best_inliers_count);
 
@@ -216,6 +393,33 @@ pcl::RandomSampleConsensus<PointT>::computeModel (int)
   return (true);
 }
 
+//////////////////////////////////////////////////////////////////////////
+template <typename PointT> double
+pcl::RandomSampleConsensus<PointT>::computeSPRTThreshold (double epsilon, double delta)
+{
+  // The test cannot tell the good models from the bad ones
+  if (!(epsilon > delta) || epsilon >= 1.0)
+    return (std::numeric_limits<double>::infinity ());
+
+  // The time to compute a model in units of the time to verify a point, and the number of models per sample
+  const double t_m = 200.0;
+  const double m_s = 1.0;
+
+  // A is the fixed point of A = t_m * C / m_s + 1 + log (A), which is found by iterating from A_0 = t_m * C / m_s + 1
+  const double c = (1.0 - delta) * std::log ((1.0 - delta) / (1.0 - epsilon)) + delta * std::log (delta / epsilon);
+  const double a_0 = t_m * c / m_s + 1.0;
+  double a = a_0;
+  for (int i = 0; i < 10; ++i)
+  {
+    const double a_next = a_0 + std::log (a);
+    const bool converged = std::abs (a_next - a) < 1e-6 * a;
+    a = a_next;
+    if (converged)
+      break;
+  }
+  return (std::log (a));
+}
+
 #define PCL_INSTANTIATE_RandomSampleConsensus(T) template class PCL_EXPORTS pcl::RandomSampleConsensus<T>;
 
 #endif    // PCL_SAMPLE_CONSENSUS_IMPL_RANSAC_H_
@@ -42,6 +42,15 @@
 #define PCL_SAMPLE_CONSENSUS_IMPL_RMSAC_H_
 
 #include <pcl/sample_consensus/rmsac.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#if defined _OPENMP && _OPENMP >= 201107 // We need OpenMP 3.1 for the atomic constructs
+#define OPENMP_AVAILABLE_RMSAC true
+#else
+#define OPENMP_AVAILABLE_RMSAC false
+#endif
 
 //////////////////////////////////////////////////////////////////////////
 template <typename PointT> bool
@@ -71,79 +80,156 @@ pcl::RandomizedMEstimatorSampleConsensus<PointT>::computeModel (int debug_verbos
   // Number of samples to try randomly
   std::size_t fraction_nr_points = pcl_lrint (static_cast<double>(sac_model_->getIndices ()->size ()) * fraction_nr_pretest_ / 100.0);
 
-  // Iterate
-  while (iterations_ < k && skipped_count < max_skip)
+  int threads = threads_;
+  if (threads >= 0)
   {
-    // Get X samples which satisfy the model criteria
-    sac_model_->getSamples (iterations_, selection);
-
-    if (selection.empty ()) break;
-
-    // Search for inliers in the point cloud for the current plane model M
-    if (!sac_model_->computeModelCoefficients (selection, model_coefficients))
+#if OPENMP_AVAILABLE_RMSAC
+    if (threads == 0)
     {
-      //iterations_++;
-      ++ skipped_count;
-      continue;
+      threads = omp_get_num_procs();
+      PCL_DEBUG ("[pcl::RandomizedMEstimatorSampleConsensus::computeModel] Automatic number of threads requested, choosing %i threads.\n", threads);
     }
+#else
+    // Parallelization desired, but not available
+    PCL_WARN ("[pcl::RandomizedMEstimatorSampleConsensus::computeModel] Parallelization is requested, but OpenMP 3.1 is not available! Continuing without parallelization.\n");
+    threads = -1;
+#endif
+  }
 
-    // RMSAC addon: verify a random fraction of the data
-    // Get X random samples which satisfy the model criterion
-    this->getRandomSamples (sac_model_->getIndices (), fraction_nr_points, indices_subset);
-
-    if (!sac_model_->doSamplesVerifyModel (indices_subset, model_coefficients, threshold_))
+#if OPENMP_AVAILABLE_RMSAC
+#pragma omp parallel if(threads > 0) num_threads(threads) shared(k, skipped_count, d_best_penalty, n_inliers_count) firstprivate(selection, model_coefficients, distances, indices_subset)
+#endif
+  {
+    // Iterate
+    while (true)
     {
-      // Unfortunately we cannot "continue" after the first iteration, because k might not be set, while iterations gets incremented
-      if (k != 1.0)
+      int iterations_tmp;
+      double k_tmp;
+      unsigned skipped_count_tmp;
+#if OPENMP_AVAILABLE_RMSAC
+#pragma omp atomic read
+#endif
+      iterations_tmp = iterations_;
+#if OPENMP_AVAILABLE_RMSAC
+#pragma omp atomic read
+#endif
+      k_tmp = k;
+#if OPENMP_AVAILABLE_RMSAC
+#pragma omp atomic read
+#endif
+      skipped_count_tmp = skipped_count;
+      if (iterations_tmp >= k_tmp || iterations_tmp > max_iterations_ || skipped_count_tmp >= max_skip)
+        break;
+
+      // Get X samples which satisfy the model criteria
+#if OPENMP_AVAILABLE_RMSAC
+#pragma omp critical(samples)
+#endif
       {
-        ++iterations_;
-        continue;
+        sac_model_->getSamples (iterations_, selection); // The random number generator used when choosing the samples should not be called in parallel
       }
-    }
 
-    double d_cur_penalty = 0;
-    // Iterate through the 3d points and calculate the distances from them to the model
-    sac_model_->getDistancesToModel (model_coefficients, distances);
+      if (selection.empty ()) break;
 
-    if (distances.empty () && k > 1.0)
-      continue;
+      // Search for inliers in the point cloud for the current plane model M
+      if (!sac_model_->computeModelCoefficients (selection, model_coefficients))
+      {
+        //iterations_++;
+#if OPENMP_AVAILABLE_RMSAC
+#pragma omp atomic
+#endif
+        ++skipped_count;
+        continue;
+      }
 
-    for (const double &distance : distances)
-      d_cur_penalty += std::min (distance, threshold_);
+      // RMSAC addon: verify a random fraction of the data
+      // Get X random samples which satisfy the model criterion
+#if OPENMP_AVAILABLE_RMSAC
+#pragma omp critical(samples)
+#endif
+      {
+        this->getRandomSamples (sac_model_->getIndices (), fraction_nr_points, indices_subset);
+      }
 
-    // Better match ?
-    if (d_cur_penalty < d_best_penalty)
-    {
-      d_best_penalty = d_cur_penalty;
+      if (!sac_model_->doSamplesVerifyModel (indices_subset, model_coefficients, threshold_))
+      {
+        // Unfortunately we cannot "continue" after the first iteration, because k might not be set, while iterations gets incremented
+        if (k_tmp != 1.0)
+        {
+#if OPENMP_AVAILABLE_RMSAC
+#pragma omp atomic
+#endif
+          ++iterations_;
+          continue;
+        }
+      }
+
+      double d_cur_penalty = 0;
+      // Iterate through the 3d points and calculate the distances from them to the model
+      sac_model_->getDistancesToModel (model_coefficients, distances);
 
-      // Save the current model/coefficients selection as being the best so far
-      model_              = selection;
-      model_coefficients_ = model_coefficients;
+      if (distances.empty () && k_tmp > 1.0)
+        continue;
 
-      n_inliers_count = 0;
-      // Need to compute the number of inliers for this model to adapt k
       for (const double &distance : distances)
-        if (distance <= threshold_)
-          n_inliers_count++;
-
-      // Compute the k parameter (k=std::log(z)/std::log(1-w^n))
-      double w = static_cast<double> (n_inliers_count) / static_cast<double>(sac_model_->getIndices ()->size ());
-      double p_no_outliers = 1 - std::pow (w, static_cast<double> (selection.size ()));
-      p_no_outliers = (std::max) (std::numeric_limits<double>::epsilon (), p_no_outliers);       // Avoid division by -Inf
-      p_no_outliers = (std::min) (1 - std::numeric_limits<double>::epsilon (), p_no_outliers);   // Avoid division by 0.
-      k = std::log (1 - probability_) / std::log (p_no_outliers);
-    }
+        d_cur_penalty += std::min (distance, threshold_);
 
-    ++iterations_;
-    if (debug_verbosity_level > 1)
-      PCL_DEBUG ("[pcl::RandomizedMEstimatorSampleConsensus::computeModel] Trial %d out of %d. Best penalty is %f.\n", iterations_, static_cast<int> (std::ceil (k)), d_best_penalty);
-    if (iterations_ > max_iterations_)
-    {
-      if (debug_verbosity_level > 0)
-        PCL_DEBUG ("[pcl::RandomizedMEstimatorSampleConsensus::computeModel] MSAC reached the maximum number of trials.\n");
-      break;
-    }
-  }
+      double d_best_penalty_tmp;
+#if OPENMP_AVAILABLE_RMSAC
+#pragma omp atomic read
+#endif
+      d_best_penalty_tmp = d_best_penalty;
+
+      // Better match ?
+      if (d_cur_penalty < d_best_penalty_tmp)
+      {
+#if OPENMP_AVAILABLE_RMSAC
+#pragma omp critical(update) // d_best_penalty, model_, model_coefficients_, k are shared and read/write must be protected
+#endif
+        {
+          if (d_cur_penalty < d_best_penalty)
+          {
+            d_best_penalty = d_cur_penalty;
+
+            // Save the current model/coefficients selection as being the best so far
+            model_              = selection;
+            model_coefficients_ = model_coefficients;
+
+            n_inliers_count = 0;
+            // Need to compute the number of inliers for this model to adapt k
+            for (const double &distance : distances)
+              if (distance <= threshold_)
+                n_inliers_count++;
+
+            // Compute the k parameter (k=std::log(z)/std::log(1-w^n))
+            double w = static_cast<double> (n_inliers_count) / static_cast<double>(sac_model_->getIndices ()->size ());
+            double p_no_outliers = 1 - std::pow (w, static_cast<double> (selection.size ()));
+            p_no_outliers = (std::max) (std::numeric_limits<double>::epsilon (), p_no_outliers);       // Avoid division by -Inf
+            p_no_outliers = (std::min) (1 - std::numeric_limits<double>::epsilon (), p_no_outliers);   // Avoid division by 0.
+            k = std::log (1 - probability_) / std::log (p_no_outliers);
+          }
+          d_best_penalty_tmp = d_best_penalty;
+        } // omp critical
+      }
+
+#if OPENMP_AVAILABLE_RMSAC
+#pragma omp atomic capture
+#endif
+      iterations_tmp = ++iterations_;
+#if OPENMP_AVAILABLE_RMSAC
+#pragma omp atomic read
+#endif
+      k_tmp = k;
+      if (debug_verbosity_level > 1)
+        PCL_DEBUG ("[pcl::RandomizedMEstimatorSampleConsensus::computeModel] Trial %d out of %d. Best penalty is %f.\n", iterations_tmp, static_cast<int> (std::ceil (k_tmp)), d_best_penalty_tmp);
+      if (iterations_tmp > max_iterations_)
+      {
+        if (debug_verbosity_level > 0)
+          PCL_DEBUG ("[pcl::RandomizedMEstimatorSampleConsensus::computeModel] MSAC reached the maximum number of trials.\n");
+        break;
+      }
+    } // while
+  } // omp parallel
 
   if (model_.empty ())
   {
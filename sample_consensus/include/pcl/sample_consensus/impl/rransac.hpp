@@ -42,6 +42,15 @@
 #define PCL_SAMPLE_CONSENSUS_IMPL_RRANSAC_H_
 
 #include <pcl/sample_consensus/rransac.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#if defined _OPENMP && _OPENMP >= 201107 // We need OpenMP 3.1 for the atomic constructs
+#define OPENMP_AVAILABLE_RRANSAC true
+#else
+#define OPENMP_AVAILABLE_RRANSAC false
+#endif
 
 //////////////////////////////////////////////////////////////////////////
 template <typename PointT> bool
@@ -65,7 +74,6 @@ pcl::RandomizedRandomSampleConsensus<PointT>::computeModel (int debug_verbosity_
   const double log_probability  = std::log (1.0 - probability_);
   const double one_over_indices = 1.0 / static_cast<double> (sac_model_->getIndices ()->size ());
 
-  std::size_t n_inliers_count;
   unsigned skipped_count = 0;
   // suppress infinite loops by just allowing 10 x maximum allowed iterations for invalid model parameters!
   const unsigned max_skip = max_iterations_ * 10;
@@ -73,76 +81,149 @@ pcl::RandomizedRandomSampleConsensus<PointT>::computeModel (int debug_verbosity_
   // Number of samples to try randomly
   const std::size_t fraction_nr_points = pcl_lrint (static_cast<double>(sac_model_->getIndices ()->size ()) * fraction_nr_pretest_ / 100.0);
 
-  // Iterate
-  while (iterations_ < k)
+  int threads = threads_;
+  if (threads >= 0)
   {
-    // Get X samples which satisfy the model criteria
-    sac_model_->getSamples (iterations_, selection);
-
-    if (selection.empty ())
+#if OPENMP_AVAILABLE_RRANSAC
+    if (threads == 0)
     {
-      PCL_ERROR ("[pcl::RandomizedRandomSampleConsensus::computeModel] No samples could be selected!\n");
-      break;
+      threads = omp_get_num_procs();
+      PCL_DEBUG ("[pcl::RandomizedRandomSampleConsensus::computeModel] Automatic number of threads requested, choosing %i threads.\n", threads);
     }
+#else
+    // Parallelization desired, but not available
+    PCL_WARN ("[pcl::RandomizedRandomSampleConsensus::computeModel] Parallelization is requested, but OpenMP 3.1 is not available! Continuing without parallelization.\n");
+    threads = -1;
+#endif
+  }
 
-    // Search for inliers in the point cloud for the current plane model M
-    if (!sac_model_->computeModelCoefficients (selection, model_coefficients))
+#if OPENMP_AVAILABLE_RRANSAC
+#pragma omp parallel if(threads > 0) num_threads(threads) shared(k, skipped_count, n_best_inliers_count) firstprivate(selection, model_coefficients, indices_subset)
+#endif
+  {
+    // Iterate
+    while (true)
     {
-      //iterations_++;
-      ++skipped_count;
-      if (skipped_count < max_skip)
+      int iterations_tmp;
+      double k_tmp;
+#if OPENMP_AVAILABLE_RRANSAC
+#pragma omp atomic read
+#endif
+      iterations_tmp = iterations_;
+#if OPENMP_AVAILABLE_RRANSAC
+#pragma omp atomic read
+#endif
+      k_tmp = k;
+      if (iterations_tmp >= k_tmp || iterations_tmp > max_iterations_)
+        break;
+
+      // Get X samples which satisfy the model criteria
+#if OPENMP_AVAILABLE_RRANSAC
+#pragma omp critical(samples)
+#endif
       {
-        PCL_DEBUG ("[pcl::RandomizedRandomSampleConsensus::computeModel] The function computeModelCoefficients failed, so continue with next iteration.\n");
-        continue;
+        sac_model_->getSamples (iterations_, selection); // The random number generator used when choosing the samples should not be called in parallel
       }
-      else
+
+      if (selection.empty ())
       {
-        PCL_DEBUG ("[pcl::RandomizedRandomSampleConsensus::computeModel] The function computeModelCoefficients failed, and RRANSAC reached the maximum number of trials.\n");
+        PCL_ERROR ("[pcl::RandomizedRandomSampleConsensus::computeModel] No samples could be selected!\n");
         break;
       }
-    }
 
-    // RRANSAC addon: verify a random fraction of the data
-    // Get X random samples which satisfy the model criterion
-    this->getRandomSamples (sac_model_->getIndices (), fraction_nr_points, indices_subset);
-    if (!sac_model_->doSamplesVerifyModel (indices_subset, model_coefficients, threshold_))
-    {
-      ++iterations_;
-      PCL_DEBUG ("[pcl::RandomizedRandomSampleConsensus::computeModel] The function doSamplesVerifyModel failed, so continue with next iteration.\n");
-      continue;
-    }
+      // Search for inliers in the point cloud for the current plane model M
+      if (!sac_model_->computeModelCoefficients (selection, model_coefficients))
+      {
+        //iterations_++;
+        unsigned skipped_count_tmp;
+#if OPENMP_AVAILABLE_RRANSAC
+#pragma omp atomic capture
+#endif
+        skipped_count_tmp = ++skipped_count;
+        if (skipped_count_tmp < max_skip)
+        {
+          PCL_DEBUG ("[pcl::RandomizedRandomSampleConsensus::computeModel] The function computeModelCoefficients failed, so continue with next iteration.\n");
+          continue;
+        }
+        else
+        {
+          PCL_DEBUG ("[pcl::RandomizedRandomSampleConsensus::computeModel] The function computeModelCoefficients failed, and RRANSAC reached the maximum number of trials.\n");
+          break;
+        }
+      }
 
-    // Select the inliers that are within threshold_ from the model
-    n_inliers_count = sac_model_->countWithinDistance (model_coefficients, threshold_);
+      // RRANSAC addon: verify a random fraction of the data
+      // Get X random samples which satisfy the model criterion
+#if OPENMP_AVAILABLE_RRANSAC
+#pragma omp critical(samples)
+#endif
+      {
+        this->getRandomSamples (sac_model_->getIndices (), fraction_nr_points, indices_subset);
+      }
+      if (!sac_model_->doSamplesVerifyModel (indices_subset, model_coefficients, threshold_))
+      {
+#if OPENMP_AVAILABLE_RRANSAC
+#pragma omp atomic
+#endif
+        ++iterations_;
+        PCL_DEBUG ("[pcl::RandomizedRandomSampleConsensus::computeModel] The function doSamplesVerifyModel failed, so continue with next iteration.\n");
+        continue;
+      }
 
-    // Better match ?
-    if (n_inliers_count > n_best_inliers_count)
-    {
-      n_best_inliers_count = n_inliers_count;
-
-      // Save the current model/inlier/coefficients selection as being the best so far
-      model_              = selection;
-      model_coefficients_ = model_coefficients;
-
-      // Compute the k parameter (k=std::log(z)/std::log(1-w^n))
-      const double w = static_cast<double> (n_inliers_count) * one_over_indices;
-      double p_no_outliers = 1.0 - std::pow (w, static_cast<double> (selection.size ()));
-      p_no_outliers = (std::max) (std::numeric_limits<double>::epsilon (), p_no_outliers);       // Avoid division by -Inf
-      p_no_outliers = (std::min) (1.0 - std::numeric_limits<double>::epsilon (), p_no_outliers);   // Avoid division by 0.
-      k = log_probability / std::log (p_no_outliers);
-    }
+      // Select the inliers that are within threshold_ from the model
+      const std::size_t n_inliers_count = sac_model_->countWithinDistance (model_coefficients, threshold_);
 
-    ++iterations_;
+      std::size_t n_best_inliers_count_tmp;
+#if OPENMP_AVAILABLE_RRANSAC
+#pragma omp atomic read
+#endif
+      n_best_inliers_count_tmp = n_best_inliers_count;
 
-    if (debug_verbosity_level > 1)
-      PCL_DEBUG ("[pcl::RandomizedRandomSampleConsensus::computeModel] Trial %d out of %d: %u inliers (best is: %u so far).\n", iterations_, static_cast<int> (std::ceil (k)), n_inliers_count, n_best_inliers_count);
-    if (iterations_ > max_iterations_)
-    {
-      if (debug_verbosity_level > 0)
-        PCL_DEBUG ("[pcl::RandomizedRandomSampleConsensus::computeModel] RRANSAC reached the maximum number of trials.\n");
-      break;
-    }
-  }
+      // Better match ?
+      if (n_inliers_count > n_best_inliers_count_tmp)
+      {
+#if OPENMP_AVAILABLE_RRANSAC
+#pragma omp critical(update) // n_best_inliers_count, model_, model_coefficients_, k are shared and read/write must be protected
+#endif
+        {
+          if (n_inliers_count > n_best_inliers_count)
+          {
+            n_best_inliers_count = n_inliers_count;
+
+            // Save the current model/inlier/coefficients selection as being the best so far
+            model_              = selection;
+            model_coefficients_ = model_coefficients;
+
+            // Compute the k parameter (k=std::log(z)/std::log(1-w^n))
+            const double w = static_cast<double> (n_inliers_count) * one_over_indices;
+            double p_no_outliers = 1.0 - std::pow (w, static_cast<double> (selection.size ()));
+            p_no_outliers = (std::max) (std::numeric_limits<double>::epsilon (), p_no_outliers);       // Avoid division by -Inf
+            p_no_outliers = (std::min) (1.0 - std::numeric_limits<double>::epsilon (), p_no_outliers);   // Avoid division by 0.
+            k = log_probability / std::log (p_no_outliers);
+          }
+          n_best_inliers_count_tmp = n_best_inliers_count;
+        } // omp critical
+      }
+
+#if OPENMP_AVAILABLE_RRANSAC
+#pragma omp atomic capture
+#endif
+      iterations_tmp = ++iterations_;
+#if OPENMP_AVAILABLE_RRANSAC
+#pragma omp atomic read
+#endif
+      k_tmp = k;
+
+      if (debug_verbosity_level > 1)
+        PCL_DEBUG ("[pcl::RandomizedRandomSampleConsensus::computeModel] Trial %d out of %d: %u inliers (best is: %u so far).\n", iterations_tmp, static_cast<int> (std::ceil (k_tmp)), n_inliers_count, n_best_inliers_count_tmp);
+      if (iterations_tmp > max_iterations_)
+      {
+        if (debug_verbosity_level > 0)
+          PCL_DEBUG ("[pcl::RandomizedRandomSampleConsensus::computeModel] RRANSAC reached the maximum number of trials.\n");
+        break;
+      }
+    } // while
+  } // omp parallel
 
   if (debug_verbosity_level > 0)
     PCL_DEBUG ("[pcl::RandomizedRandomSampleConsensus::computeModel] Model: %lu size, %u inliers.\n", model_.size (), n_best_inliers_count);
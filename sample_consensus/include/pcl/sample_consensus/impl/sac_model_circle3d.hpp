@@ -127,6 +127,14 @@ pcl::SampleConsensusModelCircle3D<PointT>::getDistancesToModel (const Eigen::Vec
   }
   distances.resize (indices_->size ());
 
+  // C : Circle Center
+  const Eigen::Vector3d C (model_coefficients[0], model_coefficients[1], model_coefficients[2]);
+  // N : Circle (Plane) Normal
+  const Eigen::Vector3d N (model_coefficients[4], model_coefficients[5], model_coefficients[6]);
+  const double N_sqr_norm = N.squaredNorm ();
+  // r : Radius
+  const double r = model_coefficients[3];
+
   // Iterate through the 3d points and calculate the distances from them to the sphere
   for (std::size_t i = 0; i < indices_->size (); ++i)
   // Calculate the distance from the point to the circle:
@@ -139,16 +147,10 @@ pcl::SampleConsensusModelCircle3D<PointT>::getDistancesToModel (const Eigen::Vec
     // what i have:
     // P : Sample Point
     Eigen::Vector3d P ((*input_)[(*indices_)[i]].x, (*input_)[(*indices_)[i]].y, (*input_)[(*indices_)[i]].z);
-    // C : Circle Center
-    Eigen::Vector3d C (model_coefficients[0], model_coefficients[1], model_coefficients[2]);
-    // N : Circle (Plane) Normal
-    Eigen::Vector3d N (model_coefficients[4], model_coefficients[5], model_coefficients[6]);
-    // r : Radius
-    double r = model_coefficients[3];
 
     Eigen::Vector3d helper_vectorPC = P - C;
     // 1.1. get line parameter
-    double lambda = (helper_vectorPC.dot (N)) / N.squaredNorm ();
+    double lambda = (helper_vectorPC.dot (N)) / N_sqr_norm;
 
     // Projected Point on plane
     Eigen::Vector3d P_proj = P + lambda * N;
@@ -219,22 +221,24 @@ pcl::SampleConsensusModelCircle3D<PointT>::countWithinDistance (
     return (0);
   std::size_t nr_p = 0;
 
+  // C : Circle Center
+  const Eigen::Vector3d C (model_coefficients[0], model_coefficients[1], model_coefficients[2]);
+  // N : Circle (Plane) Normal
+  const Eigen::Vector3d N (model_coefficients[4], model_coefficients[5], model_coefficients[6]);
+  const double NdotN = N.dot (N);
+  // r : Radius
+  const double r = model_coefficients[3];
+
   // Iterate through the 3d points and calculate the distances from them to the sphere
   for (std::size_t i = 0; i < indices_->size (); ++i)
   {
     // what i have:
     // P : Sample Point
     Eigen::Vector3d P ((*input_)[(*indices_)[i]].x, (*input_)[(*indices_)[i]].y, (*input_)[(*indices_)[i]].z);
-    // C : Circle Center
-    Eigen::Vector3d C (model_coefficients[0], model_coefficients[1], model_coefficients[2]);
-    // N : Circle (Plane) Normal
-    Eigen::Vector3d N (model_coefficients[4], model_coefficients[5], model_coefficients[6]);
-    // r : Radius
-    double r = model_coefficients[3];
 
     Eigen::Vector3d helper_vectorPC = P - C;
     // 1.1. get line parameter
-    double lambda = (-(helper_vectorPC.dot (N))) / N.dot (N);
+    double lambda = (-(helper_vectorPC.dot (N))) / NdotN;
 
     // Projected Point on plane
     Eigen::Vector3d P_proj = P + lambda * N;
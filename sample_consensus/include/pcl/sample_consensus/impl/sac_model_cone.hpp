@@ -271,31 +271,37 @@ pcl::SampleConsensusModelCone<PointT, PointNT>::countWithinDistance (
 
   float apexdotdir = apex.dot (axis_dir);
   float dirdotdir = 1.0f / axis_dir.dot (axis_dir);
+  // With both weights non-negative the weighted sum is at least the weighted Euclidean distance, so the points
+  // too far from the cone are rejected before computing their (much more expensive) angular distance
+  const bool euclid_reject = normal_distance_weight_ >= 0.0 && normal_distance_weight_ <= 1.0;
   // Iterate through the 3d points and calculate the distances from them to the cone
   for (std::size_t i = 0; i < indices_->size (); ++i)
   {
     Eigen::Vector4f pt ((*input_)[(*indices_)[i]].x, (*input_)[(*indices_)[i]].y, (*input_)[(*indices_)[i]].z, 0.0f);
-    Eigen::Vector4f n  ((*normals_)[(*indices_)[i]].normal[0], (*normals_)[(*indices_)[i]].normal[1], (*normals_)[(*indices_)[i]].normal[2], 0.0f);
 
     // Calculate the point's projection on the cone axis
     float k = (pt.dot (axis_dir) - apexdotdir) * dirdotdir;
     Eigen::Vector4f pt_proj = apex + k * axis_dir;
 
-    // Calculate the direction of the point from center
-    Eigen::Vector4f pp_pt_dir = pt - pt_proj;
-    pp_pt_dir.normalize ();
-
     // Calculate the actual radius of the cone at the level of the projected point
     Eigen::Vector4f height = apex - pt_proj;
     double actual_cone_radius = tan(opening_angle) * height.norm ();
-    height.normalize ();
-
-    // Calculate the cones perfect normals
-    Eigen::Vector4f cone_normal = sinf (opening_angle) * height + std::cos (opening_angle) * pp_pt_dir;
 
     // Approximate the distance from the point to the cone as the difference between
     // dist(point,cone_axis) and actual cone radius
     double d_euclid = std::abs (pointToAxisDistance (pt, model_coefficients) - actual_cone_radius);
+    if (euclid_reject && (1.0 - normal_distance_weight_) * d_euclid >= threshold)
+      continue;
+
+    Eigen::Vector4f n  ((*normals_)[(*indices_)[i]].normal[0], (*normals_)[(*indices_)[i]].normal[1], (*normals_)[(*indices_)[i]].normal[2], 0.0f);
+
+    // Calculate the direction of the point from center
+    Eigen::Vector4f pp_pt_dir = pt - pt_proj;
+    pp_pt_dir.normalize ();
+    height.normalize ();
+
+    // Calculate the cones perfect normals
+    Eigen::Vector4f cone_normal = sinf (opening_angle) * height + std::cos (opening_angle) * pp_pt_dir;
 
     // Calculate the angular distance between the point normal and the (dir=pt_proj->pt) vector
     double d_normal = std::abs (getAngle3D (n, cone_normal));
@@ -228,6 +228,14 @@ pcl::SampleConsensusModelCylinder<PointT, PointNT>::selectWithinDistance (
 template <typename PointT, typename PointNT> std::size_t
 pcl::SampleConsensusModelCylinder<PointT, PointNT>::countWithinDistance (
       const Eigen::VectorXf &model_coefficients, const double threshold) const
+{
+  return (countSamplesWithinDistance (*indices_, model_coefficients, threshold));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT, typename PointNT> std::size_t
+pcl::SampleConsensusModelCylinder<PointT, PointNT>::countSamplesWithinDistance (
+      const Indices &indices, const Eigen::VectorXf &model_coefficients, const double threshold) const
 {
   // Check if the model is valid given the user constraints
   if (!isModelValid (model_coefficients))
@@ -239,14 +247,20 @@ pcl::SampleConsensusModelCylinder<PointT, PointNT>::countWithinDistance (
   Eigen::Vector4f line_dir (model_coefficients[3], model_coefficients[4], model_coefficients[5], 0);
   float ptdotdir = line_pt.dot (line_dir);
   float dirdotdir = 1.0f / line_dir.dot (line_dir);
+  // With both weights non-negative the weighted sum is at least the weighted Euclidean distance, so the points
+  // too far from the cylinder are rejected before computing their (much more expensive) angular distance
+  const bool euclid_reject = normal_distance_weight_ >= 0.0 && normal_distance_weight_ <= 1.0;
   // Iterate through the 3d points and calculate the distances from them to the sphere
-  for (std::size_t i = 0; i < indices_->size (); ++i)
+  for (const index_t &index : indices)
   {
     // Approximate the distance from the point to the cylinder as the difference between
     // dist(point,cylinder_axis) and cylinder radius
-    Eigen::Vector4f pt ((*input_)[(*indices_)[i]].x, (*input_)[(*indices_)[i]].y, (*input_)[(*indices_)[i]].z, 0.0f);
-    Eigen::Vector4f n  ((*normals_)[(*indices_)[i]].normal[0], (*normals_)[(*indices_)[i]].normal[1], (*normals_)[(*indices_)[i]].normal[2], 0.0f);
+    Eigen::Vector4f pt ((*input_)[index].x, (*input_)[index].y, (*input_)[index].z, 0.0f);
     double d_euclid = std::abs (pointToLineDistance (pt, model_coefficients) - model_coefficients[6]);
+    if (euclid_reject && (1.0 - normal_distance_weight_) * d_euclid >= threshold)
+      continue;
+
+    Eigen::Vector4f n  ((*normals_)[index].normal[0], (*normals_)[index].normal[1], (*normals_)[index].normal[2], 0.0f);
 
     // Calculate the point's projection on the cylinder axis
     float k = (pt.dot (line_dir) - ptdotdir) * dirdotdir;
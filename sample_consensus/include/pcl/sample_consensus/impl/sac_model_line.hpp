@@ -118,8 +118,35 @@ pcl::SampleConsensusModelLine<PointT>::getDistancesToModel (
   Eigen::Vector4f line_dir (model_coefficients[3], model_coefficients[4], model_coefficients[5], 0);
   line_dir.normalize ();
 
-  // Iterate through the 3d points and calculate the distances from them to the line
-  for (std::size_t i = 0; i < indices_->size (); ++i)
+  std::size_t i = 0;
+#if defined (__AVX__) && defined (__AVX2__)
+  {
+    const __m256 px_vec = _mm256_set1_ps (line_pt[0]), py_vec = _mm256_set1_ps (line_pt[1]), pz_vec = _mm256_set1_ps (line_pt[2]);
+    const __m256 dx_vec = _mm256_set1_ps (line_dir[0]), dy_vec = _mm256_set1_ps (line_dir[1]), dz_vec = _mm256_set1_ps (line_dir[2]);
+    for (; (i + 8) <= indices_->size (); i += 8)
+    {
+      // The square root is taken in double precision, as for the remaining points
+      const __m256 sqr_dist = sqrDist8 (i, px_vec, py_vec, pz_vec, dx_vec, dy_vec, dz_vec);
+      _mm256_storeu_pd (&distances[i], _mm256_sqrt_pd (_mm256_cvtps_pd (_mm256_castps256_ps128 (sqr_dist))));
+      _mm256_storeu_pd (&distances[i + 4], _mm256_sqrt_pd (_mm256_cvtps_pd (_mm256_extractf128_ps (sqr_dist, 1))));
+    }
+  }
+#elif defined (__SSE__) && defined (__SSE2__) && defined (__SSE4_1__)
+  {
+    const __m128 px_vec = _mm_set1_ps (line_pt[0]), py_vec = _mm_set1_ps (line_pt[1]), pz_vec = _mm_set1_ps (line_pt[2]);
+    const __m128 dx_vec = _mm_set1_ps (line_dir[0]), dy_vec = _mm_set1_ps (line_dir[1]), dz_vec = _mm_set1_ps (line_dir[2]);
+    for (; (i + 4) <= indices_->size (); i += 4)
+    {
+      // The square root is taken in double precision, as for the remaining points
+      const __m128 sqr_dist = sqrDist4 (i, px_vec, py_vec, pz_vec, dx_vec, dy_vec, dz_vec);
+      _mm_storeu_pd (&distances[i], _mm_sqrt_pd (_mm_cvtps_pd (sqr_dist)));
+      _mm_storeu_pd (&distances[i + 2], _mm_sqrt_pd (_mm_cvtps_pd (_mm_movehl_ps (sqr_dist, sqr_dist))));
+    }
+  }
+#endif
+
+  // Iterate through the remaining 3d points and calculate the distances from them to the line
+  for (; i < indices_->size (); ++i)
   {
     // Calculate the distance from the point to the line
     // D = ||(P2-P1) x (P1-P0)|| / ||P2-P1|| = norm (cross (p2-p1, p2-p0)) / norm(p2-p1)
@@ -174,6 +201,45 @@ pcl::SampleConsensusModelLine<PointT>::countWithinDistance (
   if (!isModelValid (model_coefficients))
     return (0);
 
+#if defined (__AVX__) && defined (__AVX2__)
+  return countWithinDistanceAVX (model_coefficients, threshold);
+#elif defined (__SSE__) && defined (__SSE2__) && defined (__SSE4_1__)
+  return countWithinDistanceSSE (model_coefficients, threshold);
+#else
+  return countWithinDistanceStandard (model_coefficients, threshold);
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////
+template <typename PointT> std::size_t
+pcl::SampleConsensusModelLine<PointT>::countSamplesWithinDistance (
+      const Indices &indices, const Eigen::VectorXf &model_coefficients, const double threshold) const
+{
+  // Needs a valid set of model coefficients
+  if (!isModelValid (model_coefficients))
+    return (0);
+
+  const double sqr_threshold = threshold * threshold;
+
+  // Obtain the line point and direction
+  Eigen::Vector4f line_pt  (model_coefficients[0], model_coefficients[1], model_coefficients[2], 0.0f);
+  Eigen::Vector4f line_dir (model_coefficients[3], model_coefficients[4], model_coefficients[5], 0.0f);
+  line_dir.normalize ();
+
+  std::size_t nr_p = 0;
+  for (const index_t &index : indices)
+  {
+    if ((line_pt - (*input_)[index].getVector4fMap ()).cross3 (line_dir).squaredNorm () < sqr_threshold)
+      nr_p++;
+  }
+  return (nr_p);
+}
+
+//////////////////////////////////////////////////////////////////////////
+template <typename PointT> std::size_t
+pcl::SampleConsensusModelLine<PointT>::countWithinDistanceStandard (
+      const Eigen::VectorXf &model_coefficients, const double threshold, std::size_t i) const
+{
   double sqr_threshold = threshold * threshold;
 
   std::size_t nr_p = 0;
@@ -184,7 +250,7 @@ pcl::SampleConsensusModelLine<PointT>::countWithinDistance (
   line_dir.normalize ();
 
   // Iterate through the 3d points and calculate the distances from them to the line
-  for (std::size_t i = 0; i < indices_->size (); ++i)
+  for (; i < indices_->size (); ++i)
   {
     // Calculate the distance from the point to the line
     // D = ||(P2-P1) x (P1-P0)|| / ||P2-P1|| = norm (cross (p2-p1, p2-p0)) / norm(p2-p1)
@@ -196,6 +262,63 @@ pcl::SampleConsensusModelLine<PointT>::countWithinDistance (
   return (nr_p);
 }
 
+//////////////////////////////////////////////////////////////////////////
+#if defined (__SSE__) && defined (__SSE2__) && defined (__SSE4_1__)
+template <typename PointT> std::size_t
+pcl::SampleConsensusModelLine<PointT>::countWithinDistanceSSE (
+      const Eigen::VectorXf &model_coefficients, const double threshold, std::size_t i) const
+{
+  // Obtain the line point and direction
+  Eigen::Vector4f line_pt  (model_coefficients[0], model_coefficients[1], model_coefficients[2], 0.0f);
+  Eigen::Vector4f line_dir (model_coefficients[3], model_coefficients[4], model_coefficients[5], 0.0f);
+  line_dir.normalize ();
+
+  const __m128 px_vec = _mm_set1_ps (line_pt[0]), py_vec = _mm_set1_ps (line_pt[1]), pz_vec = _mm_set1_ps (line_pt[2]);
+  const __m128 dx_vec = _mm_set1_ps (line_dir[0]), dy_vec = _mm_set1_ps (line_dir[1]), dz_vec = _mm_set1_ps (line_dir[2]);
+  const __m128 sqr_threshold_vec = _mm_set1_ps (static_cast<float> (threshold * threshold));
+  __m128i res = _mm_setzero_si128 (); // 4 32bit integers that, summed together, hold the number of inliers
+  for (; (i + 4) <= indices_->size (); i += 4)
+  {
+    // The mask has all bits set (the integer -1) where the points are inliers, so subtracting it counts them
+    const __m128 mask = _mm_cmplt_ps (sqrDist4 (i, px_vec, py_vec, pz_vec, dx_vec, dy_vec, dz_vec), sqr_threshold_vec);
+    res = _mm_sub_epi32 (res, _mm_castps_si128 (mask));
+  }
+  std::size_t nr_p = static_cast<std::size_t> (_mm_extract_epi32 (res, 0)) + static_cast<std::size_t> (_mm_extract_epi32 (res, 1)) +
+                     static_cast<std::size_t> (_mm_extract_epi32 (res, 2)) + static_cast<std::size_t> (_mm_extract_epi32 (res, 3));
+  return (nr_p + countWithinDistanceStandard (model_coefficients, threshold, i));
+}
+#endif
+
+//////////////////////////////////////////////////////////////////////////
+#if defined (__AVX__) && defined (__AVX2__)
+template <typename PointT> std::size_t
+pcl::SampleConsensusModelLine<PointT>::countWithinDistanceAVX (
+      const Eigen::VectorXf &model_coefficients, const double threshold, std::size_t i) const
+{
+  // Obtain the line point and direction
+  Eigen::Vector4f line_pt  (model_coefficients[0], model_coefficients[1], model_coefficients[2], 0.0f);
+  Eigen::Vector4f line_dir (model_coefficients[3], model_coefficients[4], model_coefficients[5], 0.0f);
+  line_dir.normalize ();
+
+  const __m256 px_vec = _mm256_set1_ps (line_pt[0]), py_vec = _mm256_set1_ps (line_pt[1]), pz_vec = _mm256_set1_ps (line_pt[2]);
+  const __m256 dx_vec = _mm256_set1_ps (line_dir[0]), dy_vec = _mm256_set1_ps (line_dir[1]), dz_vec = _mm256_set1_ps (line_dir[2]);
+  const __m256 sqr_threshold_vec = _mm256_set1_ps (static_cast<float> (threshold * threshold));
+  __m256i res = _mm256_setzero_si256 (); // 8 32bit integers that, summed together, hold the number of inliers
+  for (; (i + 8) <= indices_->size (); i += 8)
+  {
+    // The mask has all bits set (the integer -1) where the points are inliers, so subtracting it counts them
+    const __m256 mask = _mm256_cmp_ps (sqrDist8 (i, px_vec, py_vec, pz_vec, dx_vec, dy_vec, dz_vec), sqr_threshold_vec, _CMP_LT_OQ);
+    res = _mm256_sub_epi32 (res, _mm256_castps_si256 (mask));
+  }
+  std::size_t nr_p = 0;
+  alignas (32) std::int32_t counts[8];
+  _mm256_store_si256 (reinterpret_cast<__m256i*> (counts), res);
+  for (const std::int32_t count : counts)
+    nr_p += static_cast<std::size_t> (count);
+  return (nr_p + countWithinDistanceStandard (model_coefficients, threshold, i));
+}
+#endif
+
 //////////////////////////////////////////////////////////////////////////
 template <typename PointT> void
 pcl::SampleConsensusModelLine<PointT>::optimizeModelCoefficients (
@@ -111,6 +111,20 @@ pcl::SampleConsensusModelNormalPlane<PointT, PointNT>::countWithinDistance (
     return (0);
   }
 
+  return (countSamplesWithinDistance (*indices_, model_coefficients, threshold));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT, typename PointNT> std::size_t
+pcl::SampleConsensusModelNormalPlane<PointT, PointNT>::countSamplesWithinDistance (
+      const Indices &indices, const Eigen::VectorXf &model_coefficients, const double threshold) const
+{
+  if (!normals_)
+  {
+    PCL_ERROR ("[pcl::SampleConsensusModelNormalPlane::countSamplesWithinDistance] No input dataset containing normals was given!\n");
+    return (0);
+  }
+
   // Check if the model is valid given the user constraints
   if (!isModelValid (model_coefficients))
     return (0);
@@ -122,23 +136,28 @@ pcl::SampleConsensusModelNormalPlane<PointT, PointNT>::countWithinDistance (
   std::size_t nr_p = 0;
 
   // Iterate through the 3d points and calculate the distances from them to the plane
-  for (std::size_t i = 0; i < indices_->size (); ++i)
+  for (const index_t &index : indices)
   {
-    const PointT  &pt = (*input_)[(*indices_)[i]];
-    const PointNT &nt = (*normals_)[(*indices_)[i]];
+    const PointT  &pt = (*input_)[index];
+    const PointNT &nt = (*normals_)[index];
     // Calculate the distance from the point to the plane normal as the dot product
     // D = (P-A).N/|N|
     Eigen::Vector4f p (pt.x, pt.y, pt.z, 0.0f);
-    Eigen::Vector4f n (nt.normal_x, nt.normal_y, nt.normal_z, 0.0f);
     double d_euclid = std::abs (coeff.dot (p) + model_coefficients[3]);
 
+    // Weight with the point curvature. On flat surfaces, curvature -> 0, which means the normal will have a higher influence
+    double weight = normal_distance_weight_ * (1.0 - nt.curvature);
+
+    // With both weights non-negative the weighted sum is at least the weighted Euclidean distance, so the points
+    // too far from the plane are rejected before computing their (much more expensive) angular distance
+    if (weight >= 0.0 && weight <= 1.0 && (1.0 - weight) * d_euclid >= threshold)
+      continue;
+
     // Calculate the angular distance between the point normal and the plane normal
+    Eigen::Vector4f n (nt.normal_x, nt.normal_y, nt.normal_z, 0.0f);
     double d_normal = std::abs (getAngle3D (n, coeff));
     d_normal = (std::min) (d_normal, M_PI - d_normal);
 
-    // Weight with the point curvature. On flat surfaces, curvature -> 0, which means the normal will have a higher influence
-    double weight = normal_distance_weight_ * (1.0 - nt.curvature);
-
     if (std::abs (weight * d_normal + (1.0 - weight) * d_euclid) < threshold)
       nr_p++;
   }
@@ -124,8 +124,39 @@ pcl::SampleConsensusModelPlane<PointT>::getDistancesToModel (
 
   distances.resize (indices_->size ());
 
-  // Iterate through the 3d points and calculate the distances from them to the plane
-  for (std::size_t i = 0; i < indices_->size (); ++i)
+  std::size_t i = 0;
+#if defined (__AVX__) && defined (__AVX2__)
+  {
+    const __m256 a_vec = _mm256_set1_ps (model_coefficients[0]);
+    const __m256 b_vec = _mm256_set1_ps (model_coefficients[1]);
+    const __m256 c_vec = _mm256_set1_ps (model_coefficients[2]);
+    const __m256 d_vec = _mm256_set1_ps (model_coefficients[3]);
+    const __m256 abs_help = _mm256_set1_ps (-0.0F); // -0.0F (negative zero) means that all bits are 0, only the sign bit is 1
+    for (; (i + 8) <= indices_->size (); i += 8)
+    {
+      const __m256 dist = dist8 (i, a_vec, b_vec, c_vec, d_vec, abs_help);
+      _mm256_storeu_pd (&distances[i], _mm256_cvtps_pd (_mm256_castps256_ps128 (dist)));
+      _mm256_storeu_pd (&distances[i + 4], _mm256_cvtps_pd (_mm256_extractf128_ps (dist, 1)));
+    }
+  }
+#elif defined (__SSE__) && defined (__SSE2__) && defined (__SSE4_1__)
+  {
+    const __m128 a_vec = _mm_set1_ps (model_coefficients[0]);
+    const __m128 b_vec = _mm_set1_ps (model_coefficients[1]);
+    const __m128 c_vec = _mm_set1_ps (model_coefficients[2]);
+    const __m128 d_vec = _mm_set1_ps (model_coefficients[3]);
+    const __m128 abs_help = _mm_set1_ps (-0.0F); // -0.0F (negative zero) means that all bits are 0, only the sign bit is 1
+    for (; (i + 4) <= indices_->size (); i += 4)
+    {
+      const __m128 dist = dist4 (i, a_vec, b_vec, c_vec, d_vec, abs_help);
+      _mm_storeu_pd (&distances[i], _mm_cvtps_pd (dist));
+      _mm_storeu_pd (&distances[i + 2], _mm_cvtps_pd (_mm_movehl_ps (dist, dist)));
+    }
+  }
+#endif
+
+  // Iterate through the remaining 3d points and calculate the distances from them to the plane
+  for (; i < indices_->size (); ++i)
   {
     // Calculate the distance from the point to the plane normal as the dot product
     // D = (P-A).N/|N|
@@ -191,10 +222,43 @@ pcl::SampleConsensusModelPlane<PointT>::countWithinDistance (
     return (0);
   }
 
+#if defined (__AVX__) && defined (__AVX2__)
+  return countWithinDistanceAVX (model_coefficients, threshold);
+#elif defined (__SSE__) && defined (__SSE2__) && defined (__SSE4_1__)
+  return countWithinDistanceSSE (model_coefficients, threshold);
+#else
+  return countWithinDistanceStandard (model_coefficients, threshold);
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////
+template <typename PointT> std::size_t
+pcl::SampleConsensusModelPlane<PointT>::countSamplesWithinDistance (
+      const Indices &indices, const Eigen::VectorXf &model_coefficients, const double threshold) const
+{
+  // Needs a valid set of model coefficients
+  if (!isModelValid (model_coefficients))
+    return (0);
+
+  std::size_t nr_p = 0;
+  for (const index_t &index : indices)
+  {
+    Eigen::Vector4f pt ((*input_)[index].x, (*input_)[index].y, (*input_)[index].z, 1.0f);
+    if (std::abs (model_coefficients.dot (pt)) < threshold)
+      nr_p++;
+  }
+  return (nr_p);
+}
+
+//////////////////////////////////////////////////////////////////////////
+template <typename PointT> std::size_t
+pcl::SampleConsensusModelPlane<PointT>::countWithinDistanceStandard (
+      const Eigen::VectorXf &model_coefficients, const double threshold, std::size_t i) const
+{
   std::size_t nr_p = 0;
 
   // Iterate through the 3d points and calculate the distances from them to the plane
-  for (std::size_t i = 0; i < indices_->size (); ++i)
+  for (; i < indices_->size (); ++i)
   {
     // Calculate the distance from the point to the plane normal as the dot product
     // D = (P-A).N/|N|
@@ -210,6 +274,59 @@ pcl::SampleConsensusModelPlane<PointT>::countWithinDistance (
   return (nr_p);
 }
 
+//////////////////////////////////////////////////////////////////////////
+#if defined (__SSE__) && defined (__SSE2__) && defined (__SSE4_1__)
+template <typename PointT> std::size_t
+pcl::SampleConsensusModelPlane<PointT>::countWithinDistanceSSE (
+      const Eigen::VectorXf &model_coefficients, const double threshold, std::size_t i) const
+{
+  const __m128 a_vec = _mm_set1_ps (model_coefficients[0]);
+  const __m128 b_vec = _mm_set1_ps (model_coefficients[1]);
+  const __m128 c_vec = _mm_set1_ps (model_coefficients[2]);
+  const __m128 d_vec = _mm_set1_ps (model_coefficients[3]);
+  const __m128 threshold_vec = _mm_set1_ps (static_cast<float> (threshold));
+  const __m128 abs_help = _mm_set1_ps (-0.0F); // -0.0F (negative zero) means that all bits are 0, only the sign bit is 1
+  __m128i res = _mm_setzero_si128 (); // 4 32bit integers that, summed together, hold the number of inliers
+  for (; (i + 4) <= indices_->size (); i += 4)
+  {
+    // The mask has all bits set (the integer -1) where the points are inliers, so subtracting it counts them
+    const __m128 mask = _mm_cmplt_ps (dist4 (i, a_vec, b_vec, c_vec, d_vec, abs_help), threshold_vec);
+    res = _mm_sub_epi32 (res, _mm_castps_si128 (mask));
+  }
+  std::size_t nr_p = static_cast<std::size_t> (_mm_extract_epi32 (res, 0)) + static_cast<std::size_t> (_mm_extract_epi32 (res, 1)) +
+                     static_cast<std::size_t> (_mm_extract_epi32 (res, 2)) + static_cast<std::size_t> (_mm_extract_epi32 (res, 3));
+  return (nr_p + countWithinDistanceStandard (model_coefficients, threshold, i));
+}
+#endif
+
+//////////////////////////////////////////////////////////////////////////
+#if defined (__AVX__) && defined (__AVX2__)
+template <typename PointT> std::size_t
+pcl::SampleConsensusModelPlane<PointT>::countWithinDistanceAVX (
+      const Eigen::VectorXf &model_coefficients, const double threshold, std::size_t i) const
+{
+  const __m256 a_vec = _mm256_set1_ps (model_coefficients[0]);
+  const __m256 b_vec = _mm256_set1_ps (model_coefficients[1]);
+  const __m256 c_vec = _mm256_set1_ps (model_coefficients[2]);
+  const __m256 d_vec = _mm256_set1_ps (model_coefficients[3]);
+  const __m256 threshold_vec = _mm256_set1_ps (static_cast<float> (threshold));
+  const __m256 abs_help = _mm256_set1_ps (-0.0F); // -0.0F (negative zero) means that all bits are 0, only the sign bit is 1
+  __m256i res = _mm256_setzero_si256 (); // 8 32bit integers that, summed together, hold the number of inliers
+  for (; (i + 8) <= indices_->size (); i += 8)
+  {
+    // The mask has all bits set (the integer -1) where the points are inliers, so subtracting it counts them
+    const __m256 mask = _mm256_cmp_ps (dist8 (i, a_vec, b_vec, c_vec, d_vec, abs_help), threshold_vec, _CMP_LT_OQ);
+    res = _mm256_sub_epi32 (res, _mm256_castps_si256 (mask));
+  }
+  std::size_t nr_p = 0;
+  alignas (32) std::int32_t counts[8];
+  _mm256_store_si256 (reinterpret_cast<__m256i*> (counts), res);
+  for (const std::int32_t count : counts)
+    nr_p += static_cast<std::size_t> (count);
+  return (nr_p + countWithinDistanceStandard (model_coefficients, threshold, i));
+}
+#endif
+
 //////////////////////////////////////////////////////////////////////////
 template <typename PointT> void
 pcl::SampleConsensusModelPlane<PointT>::optimizeModelCoefficients (
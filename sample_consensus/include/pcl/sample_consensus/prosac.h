@@ -48,6 +48,8 @@ namespace pcl
   /** \brief @b RandomSampleConsensus represents an implementation of the RANSAC (RAndom SAmple Consensus) algorithm, as
     * described in: "Matching with PROSAC – Progressive Sample Consensus", Chum, O. and Matas, J.G., CVPR, I: 220-226
     * 2005.
+    * \note The number of threads is ignored: the sampling pool grows with the iterations and is swapped into the
+    * indices of the model while sampling, so the hypotheses are drawn and evaluated one after the other.
     * \author Vincent Rabaud
     * \ingroup sample_consensus
     */
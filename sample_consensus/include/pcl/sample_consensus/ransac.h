@@ -49,6 +49,17 @@ namespace pcl
     * described in: "Random Sample Consensus: A Paradigm for Model Fitting with Applications to Image Analysis and 
     * Automated Cartography", Martin A. Fischler and Robert C. Bolles, Comm. Of the ACM 24: 381–395, June 1981.
     * A parallel variant is available, enable with setNumberOfThreads. Default is non-parallel.
+    *
+    * The hypotheses can be scored with the sequential probability ratio test (SPRT) of "Optimal Randomized RANSAC",
+    * Ondrej Chum and Jiri Matas, PAMI 30(8): 1472–1482, 2008, enable with setUseSPRT. The points are then
+    * verified in a random order, and a hypothesis is rejected as soon as it is likely to be worse than the best one
+    * found so far, after a small part of the points most of the time. The number of iterations is increased to
+    * account for the good hypotheses which are rejected. Default is to verify all the points of every hypothesis.
+    *
+    * In parallel, the threads draw and accept the hypotheses in the order they finish them, so the model found
+    * depends on the scheduling. With setDeterministic, the samples are drawn in the order of the iterations and the
+    * hypotheses are accepted in that order too, so that the model only depends on the seed of the sample consensus
+    * model and not on the number of threads.
     * \author Radu B. Rusu
     * \ingroup sample_consensus
     */
@@ -70,12 +81,15 @@ namespace pcl
       using SampleConsensus<PointT>::inliers_;
       using SampleConsensus<PointT>::probability_;
       using SampleConsensus<PointT>::threads_;
+      using SampleConsensus<PointT>::rnd;
 
       /** \brief RANSAC (RAndom SAmple Consensus) main constructor
         * \param[in] model a Sample Consensus model
         */
       RandomSampleConsensus (const SampleConsensusModelPtr &model) 
         : SampleConsensus<PointT> (model)
+        , use_sprt_ (false)
+        , deterministic_ (false)
       {
         // Maximum number of trials before we give up.
         max_iterations_ = 10000;
@@ -87,6 +101,8 @@ namespace pcl
         */
       RandomSampleConsensus (const SampleConsensusModelPtr &model, double threshold) 
         : SampleConsensus<PointT> (model, threshold)
+        , use_sprt_ (false)
+        , deterministic_ (false)
       {
         // Maximum number of trials before we give up.
         max_iterations_ = 10000;
@@ -97,6 +113,48 @@ namespace pcl
         */
       bool 
       computeModel (int debug_verbosity_level = 0) override;
+
+      /** \brief Set whether the hypotheses are scored with the sequential probability ratio test (SPRT), which
+        * rejects most of the bad hypotheses after verifying a small part of the points.
+        * \param[in] use_sprt true to score the hypotheses with the SPRT, false to verify all the points (default)
+        */
+      inline void
+      setUseSPRT (bool use_sprt) { use_sprt_ = use_sprt; }
+
+      /** \brief Get whether the hypotheses are scored with the sequential probability ratio test (SPRT). */
+      inline bool
+      getUseSPRT () const { return (use_sprt_); }
+
+      /** \brief Set whether the model found is independent of the number of threads. The hypotheses are then
+        * generated in batches, the samples of a batch are drawn serially, the batch is scored in parallel and its
+        * hypotheses are accepted in the order of the iterations. Without the SPRT, the model is the same as without
+        * parallelization, with the SPRT the hypotheses of a batch are tested against the thresholds at the start of
+        * the batch.
+        * \param[in] deterministic true for the same model with any number of threads, false to accept the
+        * hypotheses as soon as they are scored (default)
+        */
+      inline void
+      setDeterministic (bool deterministic) { deterministic_ = deterministic; }
+
+      /** \brief Get whether the model found is independent of the number of threads. */
+      inline bool
+      getDeterministic () const { return (deterministic_); }
+
+    protected:
+      /** \brief Compute the logarithm of the decision threshold A of the SPRT, for which the average time to
+        * reach a solution is minimal.
+        * \param[in] epsilon the probability that a point is an inlier of a good model
+        * \param[in] delta the probability that a point is an inlier of a bad model
+        * \return the logarithm of A, or infinity if no hypothesis should be rejected
+        */
+      static double
+      computeSPRTThreshold (double epsilon, double delta);
+
+      /** \brief Whether the hypotheses are scored with the SPRT. */
+      bool use_sprt_;
+
+      /** \brief Whether the hypotheses are accepted in the order of the iterations. */
+      bool deterministic_;
   };
 }
 
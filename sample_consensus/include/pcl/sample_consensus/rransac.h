@@ -69,6 +69,7 @@ namespace pcl
       using SampleConsensus<PointT>::model_coefficients_;
       using SampleConsensus<PointT>::inliers_;
       using SampleConsensus<PointT>::probability_;
+      using SampleConsensus<PointT>::threads_;
 
       /** \brief RANSAC (Randomized RAndom SAmple Consensus) main constructor
         * \param[in] model a Sample Consensus model
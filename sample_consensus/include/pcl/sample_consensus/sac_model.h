@@ -57,6 +57,14 @@
 
 #include <pcl/search/search.h>
 
+#if defined (__SSE__) && defined (__SSE2__) && defined (__SSE4_1__)
+#include <smmintrin.h>
+#endif
+
+#if defined (__AVX__) && defined (__AVX2__)
+#include <immintrin.h>
+#endif
+
 namespace pcl
 {
   template<class T> class ProgressiveSampleConsensus;
@@ -264,6 +272,34 @@ namespace pcl
       countWithinDistance (const Eigen::VectorXf &model_coefficients,
                            const double threshold) const = 0;
 
+      /** \brief Count the points among the given indices which respect the given model coefficients as
+        * inliers. This scores a model on a part of the points only, e.g. for the sequential probability
+        * ratio test of RandomSampleConsensus.
+        * Implementations of this function must be thread-safe.
+        * \note The default implementation verifies the points one by one with doSamplesVerifyModel, the
+        * common models override it with a direct computation.
+        * \param[in] indices the data indices that need to be tested against the model
+        * \param[in] model_coefficients the coefficients of a model that we need to compute distances to
+        * \param[in] threshold a maximum admissible distance threshold for determining the inliers from the outliers
+        * \return the number of inliers among the given indices
+        */
+      virtual std::size_t
+      countSamplesWithinDistance (const Indices &indices,
+                                  const Eigen::VectorXf &model_coefficients,
+                                  const double threshold) const
+      {
+        std::size_t nr_p = 0;
+        std::set<index_t> sample;
+        for (const index_t &index : indices)
+        {
+          sample.clear ();
+          sample.insert (index);
+          if (doSamplesVerifyModel (sample, model_coefficients, threshold))
+            ++nr_p;
+        }
+        return (nr_p);
+      }
+
       /** \brief Create a new point cloud with inliers projected onto the model. Pure virtual.
         * \param[in] inliers the data inliers that we want to project on the model
         * \param[in] model_coefficients the coefficients of a model
@@ -442,6 +478,38 @@ namespace pcl
 
     protected:
 
+#if defined (__SSE__) && defined (__SSE2__) && defined (__SSE4_1__)
+      /** \brief Gather the coordinates of the 4 points starting at the i-th index into SSE registers, the k-th lane
+        * holding the (i+k)-th point. Used by the SSE implementations of the distance computations.
+        */
+      inline void
+      gatherXYZ4 (const std::size_t i, __m128 &x, __m128 &y, __m128 &z) const
+      {
+        const PointT &p0 = (*input_)[(*indices_)[i  ]], &p1 = (*input_)[(*indices_)[i+1]];
+        const PointT &p2 = (*input_)[(*indices_)[i+2]], &p3 = (*input_)[(*indices_)[i+3]];
+        x = _mm_setr_ps (p0.x, p1.x, p2.x, p3.x);
+        y = _mm_setr_ps (p0.y, p1.y, p2.y, p3.y);
+        z = _mm_setr_ps (p0.z, p1.z, p2.z, p3.z);
+      }
+#endif
+
+#if defined (__AVX__) && defined (__AVX2__)
+      /** \brief Gather the coordinates of the 8 points starting at the i-th index into AVX registers, the k-th lane
+        * holding the (i+k)-th point. Used by the AVX implementations of the distance computations.
+        */
+      inline void
+      gatherXYZ8 (const std::size_t i, __m256 &x, __m256 &y, __m256 &z) const
+      {
+        const PointT &p0 = (*input_)[(*indices_)[i  ]], &p1 = (*input_)[(*indices_)[i+1]];
+        const PointT &p2 = (*input_)[(*indices_)[i+2]], &p3 = (*input_)[(*indices_)[i+3]];
+        const PointT &p4 = (*input_)[(*indices_)[i+4]], &p5 = (*input_)[(*indices_)[i+5]];
+        const PointT &p6 = (*input_)[(*indices_)[i+6]], &p7 = (*input_)[(*indices_)[i+7]];
+        x = _mm256_setr_ps (p0.x, p1.x, p2.x, p3.x, p4.x, p5.x, p6.x, p7.x);
+        y = _mm256_setr_ps (p0.y, p1.y, p2.y, p3.y, p4.y, p5.y, p6.y, p7.y);
+        z = _mm256_setr_ps (p0.z, p1.z, p2.z, p3.z, p4.z, p5.z, p6.z, p7.z);
+      }
+#endif
+
       /** \brief Fills a sample array with random samples from the indices_ vector
         * \param[out] sample the set of indices of target_ to analyze
         */
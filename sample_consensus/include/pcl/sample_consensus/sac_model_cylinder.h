@@ -200,6 +200,17 @@ namespace pcl
       countWithinDistance (const Eigen::VectorXf &model_coefficients,
                            const double threshold) const override;
 
+      /** \brief Count the points among the given indices which respect the given model coefficients as inliers.
+        * \param[in] indices the data indices that need to be tested against the model
+        * \param[in] model_coefficients the coefficients of a model that we need to compute distances to
+        * \param[in] threshold maximum admissible distance threshold for determining the inliers from the outliers
+        * \return the number of inliers among the given indices
+        */
+      std::size_t
+      countSamplesWithinDistance (const Indices &indices,
+                                  const Eigen::VectorXf &model_coefficients,
+                                  const double threshold) const override;
+
       /** \brief Recompute the cylinder coefficients using the given inlier set and return them to the user.
         * @note: these are the coefficients of the cylinder model after refinement (e.g. after SVD)
         * \param[in] inliers the data inliers found as supporting the model
@@ -143,6 +143,17 @@ namespace pcl
       countWithinDistance (const Eigen::VectorXf &model_coefficients,
                            const double threshold) const override;
 
+      /** \brief Count the points among the given indices which respect the given model coefficients as inliers.
+        * \param[in] indices the data indices that need to be tested against the model
+        * \param[in] model_coefficients the coefficients of a model that we need to compute distances to
+        * \param[in] threshold maximum admissible distance threshold for determining the inliers from the outliers
+        * \return the number of inliers among the given indices
+        */
+      std::size_t
+      countSamplesWithinDistance (const Indices &indices,
+                                  const Eigen::VectorXf &model_coefficients,
+                                  const double threshold) const override;
+
       /** \brief Recompute the line coefficients using the given inlier set and return them to the user.
         * @note: these are the coefficients of the line model after refinement (e.g. after SVD)
         * \param[in] inliers the data inliers found as supporting the model
@@ -190,6 +201,77 @@ namespace pcl
         */
       bool
       isSampleGood (const Indices &samples) const override;
+
+      /** \brief Count the inliers from the i-th index on without SIMD instructions. It is not intended for
+        * normal use, countWithinDistance automatically uses the fastest implementation available.
+        */
+      std::size_t
+      countWithinDistanceStandard (const Eigen::VectorXf &model_coefficients,
+                                   const double threshold,
+                                   std::size_t i = 0) const;
+
+#if defined (__SSE__) && defined (__SSE2__) && defined (__SSE4_1__)
+      /** \brief Count the inliers from the i-th index on with SSE instructions. It is not intended for
+        * normal use, countWithinDistance automatically uses the fastest implementation available.
+        */
+      std::size_t
+      countWithinDistanceSSE (const Eigen::VectorXf &model_coefficients,
+                              const double threshold,
+                              std::size_t i = 0) const;
+#endif
+
+#if defined (__AVX__) && defined (__AVX2__)
+      /** \brief Count the inliers from the i-th index on with AVX instructions. It is not intended for
+        * normal use, countWithinDistance automatically uses the fastest implementation available.
+        */
+      std::size_t
+      countWithinDistanceAVX (const Eigen::VectorXf &model_coefficients,
+                              const double threshold,
+                              std::size_t i = 0) const;
+#endif
+
+    private:
+#if defined (__SSE__) && defined (__SSE2__) && defined (__SSE4_1__)
+      /** \brief The squared distances of the 4 points starting at the i-th index to the line through (px, py, pz)
+        * with the normalized direction (dx, dy, dz).
+        */
+      inline __m128
+      sqrDist4 (const std::size_t i, const __m128 &px_vec, const __m128 &py_vec, const __m128 &pz_vec,
+                const __m128 &dx_vec, const __m128 &dy_vec, const __m128 &dz_vec) const
+      {
+        __m128 x, y, z;
+        this->gatherXYZ4 (i, x, y, z);
+        x = _mm_sub_ps (px_vec, x);
+        y = _mm_sub_ps (py_vec, y);
+        z = _mm_sub_ps (pz_vec, z);
+        // The cross product of (line_pt - pt) with the line direction
+        const __m128 cx = _mm_sub_ps (_mm_mul_ps (y, dz_vec), _mm_mul_ps (z, dy_vec));
+        const __m128 cy = _mm_sub_ps (_mm_mul_ps (z, dx_vec), _mm_mul_ps (x, dz_vec));
+        const __m128 cz = _mm_sub_ps (_mm_mul_ps (x, dy_vec), _mm_mul_ps (y, dx_vec));
+        return (_mm_add_ps (_mm_add_ps (_mm_mul_ps (cx, cx), _mm_mul_ps (cy, cy)), _mm_mul_ps (cz, cz)));
+      }
+#endif
+
+#if defined (__AVX__) && defined (__AVX2__)
+      /** \brief The squared distances of the 8 points starting at the i-th index to the line through (px, py, pz)
+        * with the normalized direction (dx, dy, dz).
+        */
+      inline __m256
+      sqrDist8 (const std::size_t i, const __m256 &px_vec, const __m256 &py_vec, const __m256 &pz_vec,
+                const __m256 &dx_vec, const __m256 &dy_vec, const __m256 &dz_vec) const
+      {
+        __m256 x, y, z;
+        this->gatherXYZ8 (i, x, y, z);
+        x = _mm256_sub_ps (px_vec, x);
+        y = _mm256_sub_ps (py_vec, y);
+        z = _mm256_sub_ps (pz_vec, z);
+        // The cross product of (line_pt - pt) with the line direction
+        const __m256 cx = _mm256_sub_ps (_mm256_mul_ps (y, dz_vec), _mm256_mul_ps (z, dy_vec));
+        const __m256 cy = _mm256_sub_ps (_mm256_mul_ps (z, dx_vec), _mm256_mul_ps (x, dz_vec));
+        const __m256 cz = _mm256_sub_ps (_mm256_mul_ps (x, dy_vec), _mm256_mul_ps (y, dx_vec));
+        return (_mm256_add_ps (_mm256_add_ps (_mm256_mul_ps (cx, cx), _mm256_mul_ps (cy, cy)), _mm256_mul_ps (cz, cz)));
+      }
+#endif
   };
 }
 
@@ -147,6 +147,17 @@ namespace pcl
       countWithinDistance (const Eigen::VectorXf &model_coefficients,
                            const double threshold) const override;
 
+      /** \brief Count the points among the given indices which respect the given model coefficients as inliers.
+        * \param[in] indices the data indices that need to be tested against the model
+        * \param[in] model_coefficients the coefficients of a model that we need to compute distances to
+        * \param[in] threshold maximum admissible distance threshold for determining the inliers from the outliers
+        * \return the number of inliers among the given indices
+        */
+      std::size_t
+      countSamplesWithinDistance (const Indices &indices,
+                                  const Eigen::VectorXf &model_coefficients,
+                                  const double threshold) const override;
+
       /** \brief Compute all distances from the cloud data to a given plane model.
         * \param[in] model_coefficients the coefficients of a plane model that we need to compute distances to
         * \param[out] distances the resultant estimated distances
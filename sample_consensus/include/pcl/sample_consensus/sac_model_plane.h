@@ -216,6 +216,17 @@ namespace pcl
       countWithinDistance (const Eigen::VectorXf &model_coefficients,
                            const double threshold) const override;
 
+      /** \brief Count the points among the given indices which respect the given model coefficients as inliers.
+        * \param[in] indices the data indices that need to be tested against the model
+        * \param[in] model_coefficients the coefficients of a model that we need to compute distances to
+        * \param[in] threshold maximum admissible distance threshold for determining the inliers from the outliers
+        * \return the number of inliers among the given indices
+        */
+      std::size_t
+      countSamplesWithinDistance (const Indices &indices,
+                                  const Eigen::VectorXf &model_coefficients,
+                                  const double threshold) const override;
+
       /** \brief Recompute the plane coefficients using the given inlier set and return them to the user.
         * @note: these are the coefficients of the plane model after refinement (e.g. after SVD)
         * \param[in] inliers the data inliers found as supporting the model
@@ -257,6 +268,34 @@ namespace pcl
       using SampleConsensusModel<PointT>::sample_size_;
       using SampleConsensusModel<PointT>::model_size_;
 
+      /** \brief Count the inliers from the i-th index on without SIMD instructions. It is not intended for
+        * normal use, countWithinDistance automatically uses the fastest implementation available.
+        */
+      std::size_t
+      countWithinDistanceStandard (const Eigen::VectorXf &model_coefficients,
+                                   const double threshold,
+                                   std::size_t i = 0) const;
+
+#if defined (__SSE__) && defined (__SSE2__) && defined (__SSE4_1__)
+      /** \brief Count the inliers from the i-th index on with SSE instructions. It is not intended for
+        * normal use, countWithinDistance automatically uses the fastest implementation available.
+        */
+      std::size_t
+      countWithinDistanceSSE (const Eigen::VectorXf &model_coefficients,
+                              const double threshold,
+                              std::size_t i = 0) const;
+#endif
+
+#if defined (__AVX__) && defined (__AVX2__)
+      /** \brief Count the inliers from the i-th index on with AVX instructions. It is not intended for
+        * normal use, countWithinDistance automatically uses the fastest implementation available.
+        */
+      std::size_t
+      countWithinDistanceAVX (const Eigen::VectorXf &model_coefficients,
+                              const double threshold,
+                              std::size_t i = 0) const;
+#endif
+
     private:
       /** \brief Check if a sample of indices results in a good sample of points
         * indices.
@@ -264,6 +303,30 @@ namespace pcl
         */
       bool
       isSampleGood (const Indices &samples) const override;
+
+#if defined (__SSE__) && defined (__SSE2__) && defined (__SSE4_1__)
+      /** \brief The distances of the 4 points starting at the i-th index to the plane a*x+b*y+c*z+d=0. */
+      inline __m128
+      dist4 (const std::size_t i, const __m128 &a_vec, const __m128 &b_vec, const __m128 &c_vec, const __m128 &d_vec, const __m128 &abs_help) const
+      {
+        __m128 x, y, z;
+        this->gatherXYZ4 (i, x, y, z);
+        // The andnot-function realizes an abs-operation: the sign bit is removed
+        return (_mm_andnot_ps (abs_help, _mm_add_ps (_mm_add_ps (_mm_add_ps (_mm_mul_ps (a_vec, x), _mm_mul_ps (b_vec, y)), _mm_mul_ps (c_vec, z)), d_vec)));
+      }
+#endif
+
+#if defined (__AVX__) && defined (__AVX2__)
+      /** \brief The distances of the 8 points starting at the i-th index to the plane a*x+b*y+c*z+d=0. */
+      inline __m256
+      dist8 (const std::size_t i, const __m256 &a_vec, const __m256 &b_vec, const __m256 &c_vec, const __m256 &d_vec, const __m256 &abs_help) const
+      {
+        __m256 x, y, z;
+        this->gatherXYZ8 (i, x, y, z);
+        // The andnot-function realizes an abs-operation: the sign bit is removed
+        return (_mm256_andnot_ps (abs_help, _mm256_add_ps (_mm256_add_ps (_mm256_add_ps (_mm256_mul_ps (a_vec, x), _mm256_mul_ps (b_vec, y)), _mm256_mul_ps (c_vec, z)), d_vec)));
+      }
+#endif
   };
 }
 
@@ -37,6 +37,7 @@
 
 #pragma once
 
+#include <pcl/point_cloud_soa.h>
 #include <pcl/search/search.h>
 
 namespace pcl
@@ -44,6 +45,14 @@ namespace pcl
   namespace search
   {
     /** \brief Implementation of a simple brute force search algorithm.
+      *
+      * The coordinates of the (finite) input points are copied into a pcl::PointCloudSoA when the input
+      * cloud is set, so that the distances to a query are computed for blocks of points at once with the
+      * vectorized Eigen array kernels (SSE/AVX/NEON, depending on the enabled instruction sets). For small
+      * clouds this is usually faster than building and querying a tree.
+      *
+      * \note As the coordinates are copied, \ref setInputCloud has to be called again after modifying
+      * the input cloud.
       * \author Suat Gedikli
       * \ingroup search
       */
@@ -81,9 +90,10 @@ namespace pcl
         }
       };
 
-      // replace by some metric functor
-      float getDistSqr (const PointT& point1, const PointT& point2) const;
       public:
+        using pcl::search::Search<PointT>::nearestKSearch;
+        using pcl::search::Search<PointT>::radiusSearch;
+
         BruteForce (bool sorted_results = false)
         : Search<PointT> ("BruteForce", sorted_results)
         {
@@ -95,6 +105,14 @@ namespace pcl
         {
         }
 
+        /** \brief Provide a pointer to the input dataset.
+          * \param[in] cloud the const boost shared pointer to a PointCloud message
+          * \param[in] indices the point indices subset that is to be used from \a cloud
+          */
+        void
+        setInputCloud (const PointCloudConstPtr& cloud,
+                       const IndicesConstPtr& indices = IndicesConstPtr ()) override;
+
         /** \brief Search for the k-nearest neighbors for the given query point.
           * \param[in] point the given query point
           * \param[in] k the number of neighbors to search for
@@ -122,21 +140,18 @@ namespace pcl
                       unsigned int max_nn = 0) const override;
 
       private:
-        int
-        denseKSearch (const PointT &point, int k, Indices &k_indices, std::vector<float> &k_distances) const;
-
-        int
-        sparseKSearch (const PointT &point, int k, Indices &k_indices, std::vector<float> &k_distances) const;
+        /** \brief Compute the squared distances between \a point and \a count input points starting at
+          * position \a begin of the coordinate arrays.
+          */
+        void
+        computeSqrDistances (const Eigen::Vector3f& point, std::size_t begin, std::size_t count,
+                             float* sqr_distances) const;
 
-        int
-        denseRadiusSearch (const PointT& point, double radius,
-                           Indices &k_indices, std::vector<float> &k_sqr_distances,
-                           unsigned int max_nn = 0) const;
+        /** \brief The number of points whose distances are computed at once. */
+        static const std::size_t block_size_ = 256;
 
-        int
-        sparseRadiusSearch (const PointT& point, double radius,
-                            Indices &k_indices, std::vector<float> &k_sqr_distances,
-                            unsigned int max_nn = 0) const;
+        /** \brief The coordinates of the finite input points, as a structure of arrays. */
+        PointCloudSoA points_;
     };
   }
 }
@@ -250,6 +250,25 @@ namespace pcl
           return (checks_);
         }
 
+        /** \brief Let the searches trade accuracy for speed. The \a epsilon of the settings becomes the
+          * FLANN error bound and the smaller non zero limit of \a max_checks and \a max_candidates the
+          * FLANN number of checks (FLANN counts the points checked in the leaves). Without limits the
+          * number of checks is left unchanged.
+          * \param[in] params the approximation settings
+          */
+        void
+        setApproximateSearch (const ApproximateSearchParams &params) override
+        {
+          Search<PointT>::setApproximateSearch (params);
+          eps_ = params.epsilon;
+          if (params.max_checks > 0 || params.max_candidates > 0)
+          {
+            const unsigned int checks = (params.max_checks == 0 || (params.max_candidates > 0 && params.max_candidates < params.max_checks))
+                                        ? params.max_candidates : params.max_checks;
+            checks_ = static_cast<int> (checks);
+          }
+        }
+
         /** \brief Provide a pointer to the input dataset.
           * \param[in] cloud the const boost shared pointer to a PointCloud message
           * \param[in] indices the point indices subset that is to be used from \a cloud
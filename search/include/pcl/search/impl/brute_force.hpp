@@ -39,14 +39,33 @@
 
 #include <pcl/common/point_tests.h> // for pcl::isFinite
 #include <pcl/search/brute_force.h>
-#include <queue>
+#include <algorithm>
 
 //////////////////////////////////////////////////////////////////////////////////////////////
-template <typename PointT> float
-pcl::search::BruteForce<PointT>::getDistSqr (
-    const PointT& point1, const PointT& point2) const
+template <typename PointT> void
+pcl::search::BruteForce<PointT>::setInputCloud (
+    const PointCloudConstPtr& cloud, const IndicesConstPtr& indices)
 {
-  return (point1.getVector3fMap () - point2.getVector3fMap ()).squaredNorm ();
+  Search<PointT>::setInputCloud (cloud, indices);
+
+  // Dropping the non finite points here means the searches need no dense and sparse variants
+  if (indices_)
+    points_.assign (*input_, *indices_, true);
+  else
+    points_.assign (*input_, true);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::search::BruteForce<PointT>::computeSqrDistances (
+    const Eigen::Vector3f& point, std::size_t begin, std::size_t count, float* sqr_distances) const
+{
+  using ConstArrayMap = PointCloudSoA::ConstArrayMap;
+  const ConstArrayMap x (points_.xData () + begin, count);
+  const ConstArrayMap y (points_.yData () + begin, count);
+  const ConstArrayMap z (points_.zData () + begin, count);
+  Eigen::Map<Eigen::ArrayXf> (sqr_distances, count) =
+    (x - point.x ()).square () + (y - point.y ()).square () + (z - point.z ()).square ();
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////
@@ -58,206 +77,78 @@ pcl::search::BruteForce<PointT>::nearestKSearch (
   
   k_indices.clear ();
   k_distances.clear ();
-  if (k < 1)
+  if (k < 1 || points_.empty ())
     return 0;
 
-  if (input_->is_dense)
-    return denseKSearch (point, k, k_indices, k_distances);
-  return sparseKSearch (point, k, k_indices, k_distances);
-}
+  const Eigen::Vector3f query = point.getVector3fMap ();
+  const std::size_t size = points_.size ();
+  const std::size_t nr_neighbors = std::min (static_cast<std::size_t> (k), size);
 
-//////////////////////////////////////////////////////////////////////////////////////////////
-template <typename PointT> int
-pcl::search::BruteForce<PointT>::denseKSearch (
-    const PointT &point, int k, Indices &k_indices, std::vector<float> &k_distances) const
-{
-  // container for first k elements -> O(1) for insertion, since order not required here
-  std::vector<Entry> result;
-  result.reserve (k);
-  std::priority_queue<Entry> queue;
-  if (indices_)
+  // Max-heap on the distance holding the best candidates so far. Once it is full, most points are
+  // rejected by a single comparison with the distance of its top.
+  std::vector<Entry> heap;
+  heap.reserve (nr_neighbors);
+  float sqr_distances[block_size_];
+  for (std::size_t begin = 0; begin < size; begin += block_size_)
   {
-    auto iIt = indices_->cbegin ();
-    auto iEnd = indices_->cbegin () + std::min (static_cast<unsigned> (k), static_cast<unsigned> (indices_->size ()));
-    for (; iIt != iEnd; ++iIt)
-      result.push_back (Entry (*iIt, getDistSqr ((*input_)[*iIt], point)));
-
-    queue = std::priority_queue<Entry> (result.begin (), result.end ());
-
-    // add the rest
-    Entry entry;
-    for (; iIt != indices_->cend (); ++iIt)
+    const std::size_t count = (size - begin < block_size_) ? size - begin : block_size_;
+    computeSqrDistances (query, begin, count, sqr_distances);
+    for (std::size_t i = 0; i < count; ++i)
     {
-      entry.distance = getDistSqr ((*input_)[*iIt], point);
-      if (queue.top ().distance > entry.distance)
+      if (heap.size () < nr_neighbors)
       {
-        entry.index = *iIt;
-        queue.pop ();
-        queue.push (entry);
+        heap.push_back (Entry (static_cast<index_t> (begin + i), sqr_distances[i]));
+        std::push_heap (heap.begin (), heap.end ());
       }
-    }
-  }
-  else
-  {
-    Entry entry;
-    for (entry.index = 0; entry.index < std::min<pcl::index_t> (k, input_->size ()); ++entry.index)
-    {
-      entry.distance = getDistSqr ((*input_)[entry.index], point);
-      result.push_back (entry);
-    }
-
-    queue = std::priority_queue<Entry> (result.begin (), result.end ());
-
-    // add the rest
-    for (; entry.index < static_cast<pcl::index_t>(input_->size ()); ++entry.index)
-    {
-      entry.distance = getDistSqr ((*input_)[entry.index], point);
-      if (queue.top ().distance > entry.distance)
+      else if (sqr_distances[i] < heap.front ().distance)
       {
-        queue.pop ();
-        queue.push (entry);
-      }      
+        std::pop_heap (heap.begin (), heap.end ());
+        heap.back () = Entry (static_cast<index_t> (begin + i), sqr_distances[i]);
+        std::push_heap (heap.begin (), heap.end ());
+      }
     }
   }
 
-  k_indices.resize (queue.size ());
-  k_distances.resize (queue.size ());
-  std::size_t idx = queue.size () - 1;
-  while (!queue.empty ())
+  std::sort_heap (heap.begin (), heap.end ());
+  k_indices.resize (heap.size ());
+  k_distances.resize (heap.size ());
+  for (std::size_t i = 0; i < heap.size (); ++i)
   {
-    k_indices [idx] = queue.top ().index;
-    k_distances [idx] = queue.top ().distance;
-    queue.pop ();
-    --idx;
+    k_indices[i] = points_.getIndex (heap[i].index);
+    k_distances[i] = heap[i].distance;
   }
-  
   return (static_cast<int> (k_indices.size ()));
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT> int
-pcl::search::BruteForce<PointT>::sparseKSearch (
-    const PointT &point, int k, Indices &k_indices, std::vector<float> &k_distances) const
+pcl::search::BruteForce<PointT>::radiusSearch (
+    const PointT& point, double radius, Indices &k_indices,
+    std::vector<float> &k_sqr_distances, unsigned int max_nn) const
 {
-  // result used to collect the first k neighbors -> unordered
-  std::vector<Entry> result;
-  result.reserve (k);
-  
-  std::priority_queue<Entry> queue;
-  if (indices_)
-  {
-    auto iIt =indices_->cbegin ();
-    for (; iIt != indices_->cend () && result.size () < static_cast<unsigned> (k); ++iIt)
-    {
-      if (std::isfinite ((*input_)[*iIt].x))
-        result.push_back (Entry (*iIt, getDistSqr ((*input_)[*iIt], point)));
-    }
-    
-    queue = std::priority_queue<Entry> (result.begin (), result.end ());
-
-    // either we have k elements, or there are none left to iterate >in either case we're fine
-    // add the rest
-    Entry entry;
-    for (; iIt != indices_->cend (); ++iIt)
-    {
-      if (!std::isfinite ((*input_)[*iIt].x))
-        continue;
-
-      entry.distance = getDistSqr ((*input_)[*iIt], point);
-      if (queue.top ().distance > entry.distance)
-      {
-        entry.index = *iIt;
-        queue.pop ();
-        queue.push (entry);
-      }
-    }
-  }
-  else
-  {
-    Entry entry;
-    for (entry.index = 0; (entry.index < static_cast<pcl::index_t>(input_->size ())) && (result.size () < static_cast<std::size_t> (k)); ++entry.index)
-    {
-      if (std::isfinite ((*input_)[entry.index].x))
-      {
-        entry.distance = getDistSqr ((*input_)[entry.index], point);
-        result.push_back (entry);
-      }
-    }
-    queue = std::priority_queue<Entry> (result.begin (), result.end ());
-    
-    // add the rest
-    for (; entry.index < static_cast<pcl::index_t>(input_->size ()); ++entry.index)
-    {
-      if (!std::isfinite ((*input_)[entry.index].x))
-        continue;
-
-      entry.distance = getDistSqr ((*input_)[entry.index], point);
-      if (queue.top ().distance > entry.distance)
-      {
-        queue.pop ();
-        queue.push (entry);
-      }
-    }
-  }
+  assert (isFinite (point) && "Invalid (NaN, Inf) point coordinates given to nearestKSearch!");
   
-  k_indices.resize (queue.size ());
-  k_distances.resize (queue.size ());
-  std::size_t idx = queue.size () - 1;
-  while (!queue.empty ())
-  {
-    k_indices [idx] = queue.top ().index;
-    k_distances [idx] = queue.top ().distance;
-    queue.pop ();
-    --idx;
-  }
-  return (static_cast<int> (k_indices.size ()));
-}
-
-//////////////////////////////////////////////////////////////////////////////////////////////
-template <typename PointT> int
-pcl::search::BruteForce<PointT>::denseRadiusSearch (
-    const PointT& point, double radius,
-    Indices &k_indices, std::vector<float> &k_sqr_distances,
-    unsigned int max_nn) const
-{  
-  radius *= radius;
+  k_indices.clear ();
+  k_sqr_distances.clear ();
+  if (radius <= 0)
+    return 0;
 
-  std::size_t reserve = max_nn;
-  if (reserve == 0)
-  {
-    if (indices_)
-      reserve = std::min (indices_->size (), input_->size ());
-    else
-      reserve = input_->size ();
-  }
-  k_indices.reserve (reserve);
-  k_sqr_distances.reserve (reserve);
-  float distance;
-  if (indices_)
-  {
-    for (const auto& idx : *indices_)
-    {
-      distance = getDistSqr ((*input_)[idx], point);
-      if (distance <= radius)
-      {
-        k_indices.push_back (idx);
-        k_sqr_distances.push_back (distance);
-        if (k_indices.size () == max_nn) // max_nn = 0 -> never true
-          break;
-      }
-    }
-  }
-  else
+  const Eigen::Vector3f query = point.getVector3fMap ();
+  const float sqr_radius = static_cast<float> (radius * radius);
+  const std::size_t size = points_.size ();
+  // max_nn = 0 -> no limit
+  const std::size_t limit = (max_nn == 0) ? size : max_nn;
+  float sqr_distances[block_size_];
+  for (std::size_t begin = 0; begin < size && k_indices.size () < limit; begin += block_size_)
   {
-    for (std::size_t index = 0; index < input_->size (); ++index)
+    const std::size_t count = (size - begin < block_size_) ? size - begin : block_size_;
+    computeSqrDistances (query, begin, count, sqr_distances);
+    for (std::size_t i = 0; i < count && k_indices.size () < limit; ++i)
     {
-      distance = getDistSqr ((*input_)[index], point);
-      if (distance <= radius)
+      if (sqr_distances[i] <= sqr_radius)
       {
-        k_indices.push_back (index);
-        k_sqr_distances.push_back (distance);
-        if (k_indices.size () == max_nn) // never true if max_nn = 0
-          break;
+        k_indices.push_back (points_.getIndex (begin + i));
+        k_sqr_distances.push_back (sqr_distances[i]);
       }
     }
   }
@@ -268,83 +159,4 @@ pcl::search::BruteForce<PointT>::denseRadiusSearch (
   return (static_cast<int> (k_indices.size ()));
 }
 
-//////////////////////////////////////////////////////////////////////////////////////////////
-template <typename PointT> int
-pcl::search::BruteForce<PointT>::sparseRadiusSearch (
-    const PointT& point, double radius,
-    Indices &k_indices, std::vector<float> &k_sqr_distances,
-    unsigned int max_nn) const
-{
-  radius *= radius;
-
-  std::size_t reserve = max_nn;
-  if (reserve == 0)
-  {
-    if (indices_)
-      reserve = std::min (indices_->size (), input_->size ());
-    else
-      reserve = input_->size ();
-  }
-  k_indices.reserve (reserve);
-  k_sqr_distances.reserve (reserve);
-
-  float distance;
-  if (indices_)
-  {
-    for (const auto& idx : *indices_)
-    {
-      if (!std::isfinite ((*input_)[idx].x))
-        continue;
-
-      distance = getDistSqr ((*input_)[idx], point);
-      if (distance <= radius)
-      {
-        k_indices.push_back (idx);
-        k_sqr_distances.push_back (distance);
-        if (k_indices.size () == max_nn) // never true if max_nn = 0
-          break;
-      }
-    }
-  }
-  else
-  {
-    for (std::size_t index = 0; index < input_->size (); ++index)
-    {
-      if (!std::isfinite ((*input_)[index].x))
-        continue;
-      distance = getDistSqr ((*input_)[index], point);
-      if (distance <= radius)
-      {
-        k_indices.push_back (index);
-        k_sqr_distances.push_back (distance);
-        if (k_indices.size () == max_nn) // never true if max_nn = 0
-          break;
-      }
-    }
-  }
-
-  if (sorted_results_)
-    this->sortResults (k_indices, k_sqr_distances);
-
-  return (static_cast<int> (k_indices.size ()));
-}
-
-//////////////////////////////////////////////////////////////////////////////////////////////
-template <typename PointT> int
-pcl::search::BruteForce<PointT>::radiusSearch (
-    const PointT& point, double radius, Indices &k_indices,
-    std::vector<float> &k_sqr_distances, unsigned int max_nn) const
-{
-  assert (isFinite (point) && "Invalid (NaN, Inf) point coordinates given to nearestKSearch!");
-  
-  k_indices.clear ();
-  k_sqr_distances.clear ();
-  if (radius <= 0)
-    return 0;
-
-  if (input_->is_dense)
-    return denseRadiusSearch (point, radius, k_indices, k_sqr_distances, max_nn);
-  return sparseRadiusSearch (point, radius, k_indices, k_sqr_distances, max_nn);
-}
-
 #define PCL_INSTANTIATE_BruteForce(T) template class PCL_EXPORTS pcl::search::BruteForce<T>;
@@ -0,0 +1,506 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved
+ */
+
+#ifndef PCL_SEARCH_IMPL_INCREMENTAL_KDTREE_HPP_
+#define PCL_SEARCH_IMPL_INCREMENTAL_KDTREE_HPP_
+
+#include <pcl/common/point_tests.h> // for pcl::isFinite
+#include <pcl/search/incremental_kdtree.h>
+
+#include <algorithm>
+#include <limits>
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT>
+pcl::search::IncrementalKdTree<PointT>::IncrementalKdTree (bool sorted)
+  : pcl::search::Search<PointT> ("IncrementalKdTree", sorted)
+  , root_ (-1)
+  , min_rebuild_size_ (16)
+  , balance_factor_ (0.7f)
+  , delete_factor_ (0.5f)
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::search::IncrementalKdTree<PointT>::setInputCloud (
+    const PointCloudConstPtr& cloud, const IndicesConstPtr& indices)
+{
+  nodes_.clear ();
+  free_nodes_.clear ();
+  free_points_.clear ();
+  root_ = -1;
+
+  // Copy all points, so that the indices into the given cloud stay valid
+  cloud_.reset (new PointCloud (*cloud));
+  input_ = cloud_;
+  indices_ = indices;
+  point_to_node_.assign (cloud_->size (), -1);
+
+  std::vector<index_t> points;
+  std::vector<bool> used (cloud_->size (), false);
+  if (indices)
+  {
+    points.reserve (indices->size ());
+    for (const auto& index : *indices)
+    {
+      if (!used[index] && isFinite ((*cloud_)[index]))
+        points.push_back (index);
+      used[index] = true;
+    }
+  }
+  else
+  {
+    points.reserve (cloud_->size ());
+    for (index_t index = 0; index < static_cast<index_t> (cloud_->size ()); ++index)
+      if (isFinite ((*cloud_)[index]))
+        points.push_back (index);
+  }
+
+  root_ = build (points.begin (), points.end (), -1);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::search::IncrementalKdTree<PointT>::addPoints (const PointCloud& cloud, Indices& point_indices)
+{
+  if (!cloud_)
+  {
+    cloud_.reset (new PointCloud);
+    input_ = cloud_;
+  }
+
+  // Inserting a batch which is larger than the tree point by point is slower than building
+  // the whole tree from scratch
+  bool bulk_build = cloud.size () > getNumberOfPoints ();
+
+  point_indices.assign (cloud.size (), UNAVAILABLE);
+  for (std::size_t i = 0; i < cloud.size (); ++i)
+  {
+    if (!isFinite (cloud[i]))
+      continue;
+
+    index_t index;
+    if (!free_points_.empty ())
+    {
+      index = free_points_.back ();
+      free_points_.pop_back ();
+      (*cloud_)[index] = cloud[i];
+    }
+    else
+    {
+      index = static_cast<index_t> (cloud_->size ());
+      cloud_->push_back (cloud[i]);
+      point_to_node_.push_back (-1);
+    }
+    point_indices[i] = index;
+
+    if (!bulk_build)
+      insert (index);
+  }
+
+  if (bulk_build)
+  {
+    std::vector<index_t> points;
+    points.reserve (getNumberOfPoints () + cloud.size ());
+    if (root_ >= 0)
+      releaseSubtree (root_, points);
+    for (const auto& index : point_indices)
+      if (index != UNAVAILABLE)
+        points.push_back (index);
+
+    nodes_.clear ();
+    free_nodes_.clear ();
+    root_ = build (points.begin (), points.end (), -1);
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::search::IncrementalKdTree<PointT>::removePoints (const Indices& point_indices)
+{
+  for (const auto& index : point_indices)
+  {
+    if (index < 0 || index >= static_cast<index_t> (point_to_node_.size ()) || point_to_node_[index] < 0)
+      continue;
+
+    int node = point_to_node_[index];
+    markDeleted (node);
+    rebalancePath (node);
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::search::IncrementalKdTree<PointT>::removePointsInBox (
+    const Eigen::Vector4f& min_pt, const Eigen::Vector4f& max_pt)
+{
+  if (root_ < 0)
+    return;
+
+  Eigen::Array3f box_min = min_pt.head<3> ().array ();
+  Eigen::Array3f box_max = max_pt.head<3> ().array ();
+  removeInBox (root_, box_min, box_max);
+  rebalanceBox (root_, box_min, box_max);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> int
+pcl::search::IncrementalKdTree<PointT>::nearestKSearch (
+    const PointT &point, int k, Indices &k_indices, std::vector<float> &k_sqr_distances) const
+{
+  assert (isFinite (point) && "Invalid (NaN, Inf) point coordinates given to nearestKSearch!");
+
+  k_indices.clear ();
+  k_sqr_distances.clear ();
+  if (k < 1 || root_ < 0)
+    return (0);
+
+  std::priority_queue<Entry> queue;
+  std::size_t nr_visited = 0;
+  const float sqr_scale = (1.0f + approximate_params_.epsilon) * (1.0f + approximate_params_.epsilon);
+  nearestKSearchRecursive (root_, point.getArray3fMap (), static_cast<unsigned int> (k), sqr_scale, queue, nr_visited);
+
+  k_indices.resize (queue.size ());
+  k_sqr_distances.resize (queue.size ());
+  for (std::size_t idx = queue.size (); idx-- > 0; queue.pop ())
+  {
+    k_indices[idx] = queue.top ().index;
+    k_sqr_distances[idx] = queue.top ().distance;
+  }
+  return (static_cast<int> (k_indices.size ()));
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> int
+pcl::search::IncrementalKdTree<PointT>::radiusSearch (
+    const PointT& point, double radius, Indices &k_indices,
+    std::vector<float> &k_sqr_distances, unsigned int max_nn) const
+{
+  assert (isFinite (point) && "Invalid (NaN, Inf) point coordinates given to radiusSearch!");
+
+  k_indices.clear ();
+  k_sqr_distances.clear ();
+  if (radius <= 0 || root_ < 0)
+    return (0);
+
+  std::size_t nr_visited = 0;
+  const float sqr_radius = static_cast<float> (radius * radius);
+  const float sqr_scale = (1.0f + approximate_params_.epsilon) * (1.0f + approximate_params_.epsilon);
+  radiusSearchRecursive (root_, point.getArray3fMap (), sqr_radius, sqr_radius / sqr_scale, max_nn,
+                         k_indices, k_sqr_distances, nr_visited);
+
+  if (sorted_results_)
+    this->sortResults (k_indices, k_sqr_distances);
+  return (static_cast<int> (k_indices.size ()));
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> int
+pcl::search::IncrementalKdTree<PointT>::build (
+    std::vector<index_t>::iterator begin, std::vector<index_t>::iterator end, int parent)
+{
+  if (begin == end)
+    return (-1);
+
+  Eigen::Array3f min_pt = Eigen::Array3f::Constant (std::numeric_limits<float>::max ());
+  Eigen::Array3f max_pt = Eigen::Array3f::Constant (std::numeric_limits<float>::lowest ());
+  for (auto it = begin; it != end; ++it)
+  {
+    min_pt = min_pt.min ((*cloud_)[*it].getArray3fMap ());
+    max_pt = max_pt.max ((*cloud_)[*it].getArray3fMap ());
+  }
+
+  // Split along the axis of largest extent, at the median
+  int axis;
+  (max_pt - min_pt).maxCoeff (&axis);
+  auto middle = begin + (end - begin) / 2;
+  std::nth_element (begin, middle, end, [this, axis] (index_t a, index_t b)
+  {
+    return ((*cloud_)[a].data[axis] < (*cloud_)[b].data[axis]);
+  });
+
+  int id = allocateNode ();
+  Node& node = nodes_[id];
+  node.point = *middle;
+  node.parent = parent;
+  node.axis = axis;
+  node.deleted = false;
+  node.size = static_cast<std::size_t> (end - begin);
+  node.deleted_size = 0;
+  node.min_pt = min_pt;
+  node.max_pt = max_pt;
+  point_to_node_[*middle] = id;
+
+  // allocateNode may grow nodes_, so no reference to the node is kept across the recursion
+  int left = build (begin, middle, id);
+  int right = build (middle + 1, end, id);
+  nodes_[id].left = left;
+  nodes_[id].right = right;
+  return (id);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::search::IncrementalKdTree<PointT>::rebuild (int node)
+{
+  int parent = nodes_[node].parent;
+  bool is_left_child = parent >= 0 && nodes_[parent].left == node;
+  std::size_t removed = nodes_[node].deleted_size;
+
+  std::vector<index_t> points;
+  points.reserve (nodes_[node].size - removed);
+  releaseSubtree (node, points);
+
+  int subtree = build (points.begin (), points.end (), parent);
+  if (parent < 0)
+    root_ = subtree;
+  else if (is_left_child)
+    nodes_[parent].left = subtree;
+  else
+    nodes_[parent].right = subtree;
+
+  for (int id = parent; id >= 0; id = nodes_[id].parent)
+  {
+    nodes_[id].size -= removed;
+    nodes_[id].deleted_size -= removed;
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::search::IncrementalKdTree<PointT>::releaseSubtree (int node, std::vector<index_t>& points)
+{
+  std::vector<int> stack (1, node);
+  while (!stack.empty ())
+  {
+    int id = stack.back ();
+    stack.pop_back ();
+    const Node& current = nodes_[id];
+    if (!current.deleted)
+      points.push_back (current.point);
+    if (current.left >= 0)
+      stack.push_back (current.left);
+    if (current.right >= 0)
+      stack.push_back (current.right);
+    free_nodes_.push_back (id);
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> bool
+pcl::search::IncrementalKdTree<PointT>::needsRebuild (int node) const
+{
+  const Node& current = nodes_[node];
+  if (current.size < min_rebuild_size_)
+    return (false);
+  if (static_cast<float> (current.deleted_size) > delete_factor_ * static_cast<float> (current.size))
+    return (true);
+
+  std::size_t left_size = current.left >= 0 ? nodes_[current.left].size : 0;
+  std::size_t right_size = current.right >= 0 ? nodes_[current.right].size : 0;
+  return (static_cast<float> (std::max (left_size, right_size)) > balance_factor_ * static_cast<float> (current.size - 1));
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::search::IncrementalKdTree<PointT>::rebalancePath (int node)
+{
+  std::vector<int> path;
+  for (int id = node; id >= 0; id = nodes_[id].parent)
+    path.push_back (id);
+
+  for (auto it = path.rbegin (); it != path.rend (); ++it)
+  {
+    if (needsRebuild (*it))
+    {
+      rebuild (*it);
+      return;
+    }
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::search::IncrementalKdTree<PointT>::rebalanceBox (
+    int node, const Eigen::Array3f& min_pt, const Eigen::Array3f& max_pt)
+{
+  if (node < 0 || (nodes_[node].min_pt > max_pt).any () || (nodes_[node].max_pt < min_pt).any ())
+    return;
+
+  if (needsRebuild (node))
+  {
+    rebuild (node);
+    return;
+  }
+  rebalanceBox (nodes_[node].left, min_pt, max_pt);
+  rebalanceBox (nodes_[node].right, min_pt, max_pt);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::search::IncrementalKdTree<PointT>::insert (index_t point)
+{
+  const Eigen::Array3f position = (*cloud_)[point].getArray3fMap ();
+
+  int id = allocateNode ();
+  Node& node = nodes_[id];
+  node.point = point;
+  node.parent = node.left = node.right = -1;
+  node.axis = 0;
+  node.deleted = false;
+  node.size = 1;
+  node.deleted_size = 0;
+  node.min_pt = node.max_pt = position;
+  point_to_node_[point] = id;
+
+  if (root_ < 0)
+  {
+    root_ = id;
+    return;
+  }
+
+  for (int current_id = root_;;)
+  {
+    Node& current = nodes_[current_id];
+    ++current.size;
+    current.min_pt = current.min_pt.min (position);
+    current.max_pt = current.max_pt.max (position);
+
+    int& child = position[current.axis] < (*cloud_)[current.point].data[current.axis] ? current.left : current.right;
+    if (child < 0)
+    {
+      child = id;
+      nodes_[id].parent = current_id;
+      nodes_[id].axis = (current.axis + 1) % 3;
+      break;
+    }
+    current_id = child;
+  }
+
+  rebalancePath (id);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::search::IncrementalKdTree<PointT>::markDeleted (int node)
+{
+  nodes_[node].deleted = true;
+  point_to_node_[nodes_[node].point] = -1;
+  free_points_.push_back (nodes_[node].point);
+  for (int id = node; id >= 0; id = nodes_[id].parent)
+    ++nodes_[id].deleted_size;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::search::IncrementalKdTree<PointT>::removeInBox (
+    int node, const Eigen::Array3f& min_pt, const Eigen::Array3f& max_pt)
+{
+  if (node < 0)
+    return;
+
+  const Node& current = nodes_[node];
+  if (current.deleted_size == current.size || (current.min_pt > max_pt).any () || (current.max_pt < min_pt).any ())
+    return;
+
+  if (!current.deleted)
+  {
+    const Eigen::Array3f position = (*cloud_)[current.point].getArray3fMap ();
+    if ((position >= min_pt).all () && (position <= max_pt).all ())
+      markDeleted (node);
+  }
+  removeInBox (current.left, min_pt, max_pt);
+  removeInBox (current.right, min_pt, max_pt);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> int
+pcl::search::IncrementalKdTree<PointT>::allocateNode ()
+{
+  if (!free_nodes_.empty ())
+  {
+    int id = free_nodes_.back ();
+    free_nodes_.pop_back ();
+    return (id);
+  }
+  nodes_.emplace_back ();
+  return (static_cast<int> (nodes_.size ()) - 1);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::search::IncrementalKdTree<PointT>::nearestKSearchRecursive (
+    int node, const Eigen::Array3f& point, unsigned int k, float sqr_scale,
+    std::priority_queue<Entry>& queue, std::size_t& nr_visited) const
+{
+  const Node& current = nodes_[node];
+  if (current.deleted_size == current.size ||
+      (queue.size () == k && (boxSqrDistance (current, point) * sqr_scale > queue.top ().distance ||
+                              isBudgetExhausted (nr_visited))))
+    return;
+  ++nr_visited;
+
+  if (!current.deleted)
+  {
+    float sqr_distance = ((*cloud_)[current.point].getArray3fMap () - point).matrix ().squaredNorm ();
+    if (queue.size () < k)
+      queue.push (Entry (current.point, sqr_distance));
+    else if (sqr_distance < queue.top ().distance)
+    {
+      queue.pop ();
+      queue.push (Entry (current.point, sqr_distance));
+    }
+  }
+
+  // Descend into the child closer to the query first, it is more likely to shrink the search radius
+  int first = current.left;
+  int second = current.right;
+  if (first >= 0 && second >= 0 &&
+      boxSqrDistance (nodes_[second], point) < boxSqrDistance (nodes_[first], point))
+    std::swap (first, second);
+  if (first >= 0)
+    nearestKSearchRecursive (first, point, k, sqr_scale, queue, nr_visited);
+  if (second >= 0)
+    nearestKSearchRecursive (second, point, k, sqr_scale, queue, nr_visited);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::search::IncrementalKdTree<PointT>::radiusSearchRecursive (
+    int node, const Eigen::Array3f& point, float sqr_radius, float sqr_pruning_radius, unsigned int max_nn,
+    Indices& k_indices, std::vector<float>& k_sqr_distances, std::size_t& nr_visited) const
+{
+  const Node& current = nodes_[node];
+  if ((max_nn > 0 && k_indices.size () >= max_nn) || current.deleted_size == current.size ||
+      boxSqrDistance (current, point) > sqr_pruning_radius || isBudgetExhausted (nr_visited))
+    return;
+  ++nr_visited;
+
+  if (!current.deleted)
+  {
+    float sqr_distance = ((*cloud_)[current.point].getArray3fMap () - point).matrix ().squaredNorm ();
+    if (sqr_distance <= sqr_radius && (max_nn == 0 || k_indices.size () < max_nn))
+    {
+      k_indices.push_back (current.point);
+      k_sqr_distances.push_back (sqr_distance);
+    }
+  }
+
+  if (current.left >= 0)
+    radiusSearchRecursive (current.left, point, sqr_radius, sqr_pruning_radius, max_nn, k_indices, k_sqr_distances,
+                           nr_visited);
+  if (current.right >= 0)
+    radiusSearchRecursive (current.right, point, sqr_radius, sqr_pruning_radius, max_nn, k_indices, k_sqr_distances,
+                           nr_visited);
+}
+
+#define PCL_INSTANTIATE_IncrementalKdTree(T) template class PCL_EXPORTS pcl::search::IncrementalKdTree<T>;
+
+#endif  // PCL_SEARCH_IMPL_INCREMENTAL_KDTREE_HPP_
@@ -68,16 +68,29 @@ pcl::search::KdTree<PointT,Tree>::setSortedResults (bool sorted_results)
 template <typename PointT, class Tree> void
 pcl::search::KdTree<PointT,Tree>::setEpsilon (float eps)
 {
+  approximate_params_.epsilon = eps;
   tree_->setEpsilon (eps);
 }
 
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT, class Tree> void
+pcl::search::KdTree<PointT,Tree>::setApproximateSearch (const ApproximateSearchParams &params)
+{
+  Search<PointT>::setApproximateSearch (params);
+  tree_->setEpsilon (params.epsilon);
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT, class Tree> void
 pcl::search::KdTree<PointT,Tree>::setInputCloud (
     const PointCloudConstPtr& cloud, 
     const IndicesConstPtr& indices)
 {
+  // The tree is built with the same threads as the batch searches
+  tree_->setNumberOfThreads (this->threads_);
   tree_->setInputCloud (cloud, indices);
+  // Building the tree resets its error bound
+  tree_->setEpsilon (approximate_params_.epsilon);
   input_ = cloud;
   indices_ = indices;
 }
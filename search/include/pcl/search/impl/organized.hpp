@@ -45,6 +45,12 @@
 #include <pcl/common/time.h>
 #include <Eigen/Eigenvalues>
 
+#include <algorithm>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 //////////////////////////////////////////////////////////////////////////////////////////////
 template<typename PointT> int
 pcl::search::OrganizedNeighbor<PointT>::radiusSearch (const               PointT &query,
@@ -67,7 +73,9 @@ pcl::search::OrganizedNeighbor<PointT>::radiusSearch (const               PointT
 
   squared_radius = radius * radius;
 
-  this->getProjectedRadiusSearchBox (query, static_cast<float> (squared_radius), left, right, top, bottom);
+  // approximate searches only scan the window of the radius divided by (1 + epsilon)
+  const float approx_scale = 1.0f / ((1.0f + this->approximate_params_.epsilon) * (1.0f + this->approximate_params_.epsilon));
+  this->getProjectedRadiusSearchBox (query, static_cast<float> (squared_radius) * approx_scale, left, right, top, bottom);
 
   // iterate over search box
   if (max_nn == 0 || max_nn >= static_cast<unsigned int> (input_->size ()))
@@ -127,12 +135,88 @@ pcl::search::OrganizedNeighbor<PointT>::nearestKSearch (const PointT &query,
     return (0);
   }
 
-  Eigen::Vector3f queryvec (query.x, query.y, query.z);
-  // project query point on the image plane
-  //Eigen::Vector3f q = KR_ * query.getVector3fMap () + projection_matrix_.block <3, 1> (0, 3);
-  Eigen::Vector3f q (KR_ * queryvec + projection_matrix_.block <3, 1> (0, 3));
-  int xBegin = int(q [0] / q [2] + 0.5f);
-  int yBegin = int(q [1] / q [2] + 0.5f);
+  int x, y;
+  projectQuery (query, x, y);
+  std::vector<Entry> results;
+  return (nearestKSearchFromPixel (query, k, x, y, results, k_indices, k_sqr_distances));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointT> int
+pcl::search::OrganizedNeighbor<PointT>::nearestKSearch (const PointCloud &cloud,
+                                                        index_t index,
+                                                        int k,
+                                                        Indices &k_indices,
+                                                        std::vector<float> &k_sqr_distances) const
+{
+  std::vector<Entry> results;
+  return (nearestKSearch (cloud, index, k, results, k_indices, k_sqr_distances));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointT> void
+pcl::search::OrganizedNeighbor<PointT>::nearestKSearch (const PointCloud& cloud,
+                                                        const Indices& indices,
+                                                        int k,
+                                                        BatchSearchResult& result) const
+{
+  // one candidate buffer per thread, reused by all the queries of that thread
+  std::vector<std::vector<Entry> > buffers (std::max (this->threads_, 1u));
+  this->batchSearch (cloud, indices, result,
+                     [&] (index_t query, Indices& nn_indices, std::vector<float>& nn_dists)
+                     {
+#ifdef _OPENMP
+                       std::vector<Entry> &results = buffers[omp_get_thread_num ()];
+#else
+                       std::vector<Entry> &results = buffers[0];
+#endif
+                       return (nearestKSearch (cloud, query, k, results, nn_indices, nn_dists));
+                     });
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointT> int
+pcl::search::OrganizedNeighbor<PointT>::nearestKSearch (const PointCloud &cloud,
+                                                        index_t index,
+                                                        int k,
+                                                        std::vector<Entry> &results,
+                                                        Indices &k_indices,
+                                                        std::vector<float> &k_sqr_distances) const
+{
+  assert (index >= 0 && index < static_cast<index_t> (cloud.size ()) && "Out-of-bounds error in nearestKSearch!");
+  const PointT &query = cloud[index];
+  assert (isFinite (query) && "Invalid (NaN, Inf) point coordinates given to nearestKSearch!");
+  if (k < 1)
+  {
+    k_indices.clear ();
+    k_sqr_distances.clear ();
+    return (0);
+  }
+
+  // A point of the input cloud lies on its own pixel, no need to project it
+  int x, y;
+  if (&cloud == input_.get ())
+  {
+    x = static_cast<int> (index % input_->width);
+    y = static_cast<int> (index / input_->width);
+  }
+  else
+    projectQuery (query, x, y);
+  return (nearestKSearchFromPixel (query, k, x, y, results, k_indices, k_sqr_distances));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointT> int
+pcl::search::OrganizedNeighbor<PointT>::nearestKSearchFromPixel (const PointT &query,
+                                                                 int k,
+                                                                 int x,
+                                                                 int y,
+                                                                 std::vector<Entry> &results,
+                                                                 Indices &k_indices,
+                                                                 std::vector<float> &k_sqr_distances) const
+{
+  int xBegin = x;
+  int yBegin = y;
   int xEnd   = xBegin + 1; // end is the pixel that is not used anymore, like in iterators
   int yEnd   = yBegin + 1;
 
@@ -142,9 +226,7 @@ pcl::search::OrganizedNeighbor<PointT>::nearestKSearch (const PointT &query,
   unsigned top = 0;
   unsigned bottom = input_->height - 1;
 
-  std::priority_queue <Entry> results;
-  //std::vector<Entry> k_results;
-  //k_results.reserve (k);
+  results.clear ();
   // add point laying on the projection of the query point.
   if (xBegin >= 0 && 
       xBegin < static_cast<int> (input_->width) && 
@@ -174,10 +256,26 @@ pcl::search::OrganizedNeighbor<PointT>::nearestKSearch (const PointT &query,
   }
 
   
+  // approximate searches stop after a number of rings or tested points, once they found k candidates
+  const ApproximateSearchParams &approx = this->approximate_params_;
+  const float approx_scale = 1.0f / ((1.0f + approx.epsilon) * (1.0f + approx.epsilon));
+  std::size_t nr_rings = 0, nr_candidates = 0;
+  const auto test = [&] (index_t idx)
+  {
+    ++nr_candidates;
+    return (testPoint (query, k, results, idx));
+  };
+
   // stop used as isChanged as well as stop.
   bool stop = false;
   do
   {
+    if (results.size () == static_cast<std::size_t> (k) &&
+        ((approx.max_checks > 0 && nr_rings >= approx.max_checks) ||
+         (approx.max_candidates > 0 && nr_candidates >= approx.max_candidates)))
+      break;
+    ++nr_rings;
+
     // increment box size
     --xBegin;
     ++xEnd;
@@ -198,7 +296,7 @@ pcl::search::OrganizedNeighbor<PointT>::nearestKSearch (const PointT &query,
         index_t idx   = yBegin * input_->width + xFrom;
         index_t idxTo = idx + xTo - xFrom;
         for (; idx < idxTo; ++idx)
-          stop = testPoint (query, k, results, idx) || stop;
+          stop = test (idx) || stop;
       }
       
 
@@ -210,7 +308,7 @@ pcl::search::OrganizedNeighbor<PointT>::nearestKSearch (const PointT &query,
         index_t idxTo = idx + xTo - xFrom;
 
         for (; idx < idxTo; ++idx)
-          stop = testPoint (query, k, results, idx) || stop;
+          stop = test (idx) || stop;
       }
       
       // skip first row and last row (already handled above)
@@ -227,7 +325,7 @@ pcl::search::OrganizedNeighbor<PointT>::nearestKSearch (const PointT &query,
           index_t idxTo = yTo * input_->width + xBegin;
 
           for (; idx < idxTo; idx += input_->width)
-            stop = testPoint (query, k, results, idx) || stop;
+            stop = test (idx) || stop;
         }
         
         if (xEnd > 0 && xEnd <= static_cast<int> (input_->width))
@@ -236,13 +334,13 @@ pcl::search::OrganizedNeighbor<PointT>::nearestKSearch (const PointT &query,
           index_t idxTo = yTo * input_->width + xEnd - 1;
 
           for (; idx < idxTo; idx += input_->width)
-            stop = testPoint (query, k, results, idx) || stop;
+            stop = test (idx) || stop;
         }
         
       }
       // stop here means that the k-nearest neighbor changed -> recalculate bounding box of ellipse.
       if (stop)
-        getProjectedRadiusSearchBox (query, results.top ().distance, left, right, top, bottom);
+        getProjectedRadiusSearchBox (query, results.front ().distance * approx_scale, left, right, top, bottom);
       
     }
     // now we use it as stop flag -> if bounding box is completely within the already examined search box were done!
@@ -254,17 +352,16 @@ pcl::search::OrganizedNeighbor<PointT>::nearestKSearch (const PointT &query,
   } while (!stop);
 
   
+  // sorting the heap leaves the candidates in ascending order of their distance
+  std::sort_heap (results.begin (), results.end ());
   k_indices.resize (results.size ());
   k_sqr_distances.resize (results.size ());
-  std::size_t idx = results.size () - 1;
-  while (!results.empty ())
+  for (std::size_t idx = 0; idx < results.size (); ++idx)
   {
-    k_indices [idx] = results.top ().index;
-    k_sqr_distances [idx] = results.top ().distance;
-    results.pop ();
-    --idx;
+    k_indices [idx] = results[idx].index;
+    k_sqr_distances [idx] = results[idx].distance;
   }
-  
+
   return (static_cast<int> (k_indices.size ()));
 }
 
@@ -40,12 +40,20 @@
 
 #include <pcl/search/search.h>
 
+#include <algorithm>
+#include <numeric>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 ///////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT>
 pcl::search::Search<PointT>::Search (const std::string& name, bool sorted)
   : input_ () 
   , sorted_results_ (sorted)
   , name_ (name)
+  , threads_ (1)
 {
 }
 
@@ -70,6 +78,20 @@ pcl::search::Search<PointT>::getSortedResults ()
   return (sorted_results_);
 }
  
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::search::Search<PointT>::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs ();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT> void
 pcl::search::Search<PointT>::setInputCloud (
@@ -119,18 +141,41 @@ pcl::search::Search<PointT>::nearestKSearch (
   {
     k_indices.resize (cloud.size ());
     k_sqr_distances.resize (cloud.size ());
-    for (std::size_t i = 0; i < cloud.size (); i++)
+#pragma omp parallel for \
+  default(none) \
+  shared(cloud, k, k_indices, k_sqr_distances) \
+  schedule(dynamic, 64) \
+  num_threads(threads_)
+    for (std::ptrdiff_t i = 0; i < static_cast<std::ptrdiff_t> (cloud.size ()); i++)
       nearestKSearch (cloud, static_cast<index_t> (i), k, k_indices[i], k_sqr_distances[i]);
   }
   else
   {
     k_indices.resize (indices.size ());
     k_sqr_distances.resize (indices.size ());
-    for (std::size_t i = 0; i < indices.size (); i++)
+#pragma omp parallel for \
+  default(none) \
+  shared(cloud, indices, k, k_indices, k_sqr_distances) \
+  schedule(dynamic, 64) \
+  num_threads(threads_)
+    for (std::ptrdiff_t i = 0; i < static_cast<std::ptrdiff_t> (indices.size ()); i++)
       nearestKSearch (cloud, indices[i], k, k_indices[i], k_sqr_distances[i]);
   }
 }
 
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::search::Search<PointT>::nearestKSearch (
+    const PointCloud& cloud, const Indices& indices,
+    int k, BatchSearchResult& result) const
+{
+  batchSearch (cloud, indices, result,
+               [&] (index_t query, Indices& nn_indices, std::vector<float>& nn_dists)
+               {
+                 return (nearestKSearch (cloud, query, k, nn_indices, nn_dists));
+               });
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT> int
 pcl::search::Search<PointT>::radiusSearch (
@@ -171,18 +216,102 @@ pcl::search::Search<PointT>::radiusSearch (
   {
     k_indices.resize (cloud.size ());
     k_sqr_distances.resize (cloud.size ());
-    for (std::size_t i = 0; i < cloud.size (); i++)
+#pragma omp parallel for \
+  default(none) \
+  shared(cloud, radius, k_indices, k_sqr_distances, max_nn) \
+  schedule(dynamic, 64) \
+  num_threads(threads_)
+    for (std::ptrdiff_t i = 0; i < static_cast<std::ptrdiff_t> (cloud.size ()); i++)
       radiusSearch (cloud, static_cast<index_t> (i), radius,k_indices[i], k_sqr_distances[i], max_nn);
   }
   else
   {
     k_indices.resize (indices.size ());
     k_sqr_distances.resize (indices.size ());
-    for (std::size_t i = 0; i < indices.size (); i++)
+#pragma omp parallel for \
+  default(none) \
+  shared(cloud, indices, radius, k_indices, k_sqr_distances, max_nn) \
+  schedule(dynamic, 64) \
+  num_threads(threads_)
+    for (std::ptrdiff_t i = 0; i < static_cast<std::ptrdiff_t> (indices.size ()); i++)
       radiusSearch (cloud,indices[i],radius,k_indices[i],k_sqr_distances[i], max_nn);
   }
 }
 
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::search::Search<PointT>::radiusSearch (
+    const PointCloud& cloud,
+    const Indices& indices,
+    double radius,
+    BatchSearchResult& result,
+    unsigned int max_nn) const
+{
+  batchSearch (cloud, indices, result,
+               [&] (index_t query, Indices& nn_indices, std::vector<float>& nn_dists)
+               {
+                 return (radiusSearch (cloud, query, radius, nn_indices, nn_dists, max_nn));
+               });
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> template <typename SearchFunctor> void
+pcl::search::Search<PointT>::batchSearch (
+    const PointCloud& cloud, const Indices& indices,
+    BatchSearchResult& result, const SearchFunctor& search) const
+{
+  std::size_t nr_queries = indices.empty () ? cloud.size () : indices.size ();
+  result.offsets.assign (nr_queries + 1, 0);
+  if (nr_queries == 0)
+  {
+    result.indices.clear ();
+    result.sqr_distances.clear ();
+    return;
+  }
+
+  // The queries are split into contiguous blocks. Each block appends its neighbors to a buffer of
+  // its own, so the blocks can be copied into the flat output in query order afterwards. Using a
+  // few more blocks than threads keeps the load balanced when the neighborhood sizes vary.
+  std::size_t nr_blocks = std::min<std::size_t> (nr_queries, 8 * static_cast<std::size_t> (std::max (threads_, 1u)));
+  std::vector<Indices> block_indices (nr_blocks);
+  std::vector<std::vector<float> > block_sqr_distances (nr_blocks);
+
+#pragma omp parallel for \
+  default(none) \
+  shared(block_indices, block_sqr_distances, cloud, indices, nr_blocks, nr_queries, result, search) \
+  schedule(dynamic, 1) \
+  num_threads(threads_)
+  for (std::ptrdiff_t block = 0; block < static_cast<std::ptrdiff_t> (nr_blocks); ++block)
+  {
+    Indices nn_indices;
+    std::vector<float> nn_dists;
+    Indices &out_indices = block_indices[block];
+    std::vector<float> &out_dists = block_sqr_distances[block];
+
+    std::size_t begin = nr_queries * block / nr_blocks;
+    std::size_t end = nr_queries * (block + 1) / nr_blocks;
+    for (std::size_t i = begin; i < end; ++i)
+    {
+      index_t query = indices.empty () ? static_cast<index_t> (i) : indices[i];
+      std::size_t found = std::max (search (query, nn_indices, nn_dists), 0);
+      found = std::min (found, std::min (nn_indices.size (), nn_dists.size ()));
+      out_indices.insert (out_indices.end (), nn_indices.begin (), nn_indices.begin () + found);
+      out_dists.insert (out_dists.end (), nn_dists.begin (), nn_dists.begin () + found);
+      result.offsets[i + 1] = found;
+    }
+  }
+
+  std::partial_sum (result.offsets.begin (), result.offsets.end (), result.offsets.begin ());
+  result.indices.resize (result.offsets.back ());
+  result.sqr_distances.resize (result.offsets.back ());
+  for (std::size_t block = 0; block < nr_blocks; ++block)
+  {
+    std::size_t start = result.offsets[nr_queries * block / nr_blocks];
+    std::copy (block_indices[block].begin (), block_indices[block].end (), result.indices.begin () + start);
+    std::copy (block_sqr_distances[block].begin (), block_sqr_distances[block].end (), result.sqr_distances.begin () + start);
+  }
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT> void
 pcl::search::Search<PointT>::sortResults (
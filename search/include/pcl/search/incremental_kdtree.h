@@ -0,0 +1,304 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved
+ */
+
+#pragma once
+
+#include <pcl/search/search.h>
+
+#include <queue>
+#include <vector>
+
+namespace pcl
+{
+  namespace search
+  {
+    /** \brief @b search::IncrementalKdTree is a 3D kd-tree that supports inserting and removing points
+      * without rebuilding the whole index.
+      *
+      * Every node of the tree stores one point. Removed points are only marked as deleted (lazy
+      * deletion) and skipped by the searches. A subtree is rebuilt into a balanced one as soon as one
+      * of its children holds more than a fraction \a balance_factor of its nodes or more than a fraction
+      * \a delete_factor of them are deleted, similar to the scapegoat trees used in ikd-tree (Cai et al.,
+      * "ikd-Tree: An Incremental K-D Tree for Robotic Applications", 2021). Insertions, removals and
+      * searches therefore all stay logarithmic on average, which makes the class suited for maps that
+      * are updated with every new scan.
+      *
+      * The class owns a copy of the points. The indices returned by the searches refer to the cloud
+      * returned by \ref getInputCloud: the points given to \ref setInputCloud keep their index, points
+      * added later are appended, and the slots of removed points are recycled by later insertions.
+      * Being an ordinary search::Search, the class can be used as the target search method of the
+      * registration algorithms or as the search method of the features (only the xyz coordinates are used).
+      *
+      * \ingroup search
+      */
+    template<typename PointT>
+    class IncrementalKdTree : public Search<PointT>
+    {
+      public:
+        using PointCloud = typename Search<PointT>::PointCloud;
+        using PointCloudPtr = typename Search<PointT>::PointCloudPtr;
+        using PointCloudConstPtr = typename Search<PointT>::PointCloudConstPtr;
+
+        using pcl::search::Search<PointT>::indices_;
+        using pcl::search::Search<PointT>::input_;
+        using pcl::search::Search<PointT>::sorted_results_;
+        using pcl::search::Search<PointT>::approximate_params_;
+        using pcl::search::Search<PointT>::nearestKSearch;
+        using pcl::search::Search<PointT>::radiusSearch;
+
+        using Ptr = shared_ptr<IncrementalKdTree<PointT> >;
+        using ConstPtr = shared_ptr<const IncrementalKdTree<PointT> >;
+
+        /** \brief Constructor.
+          * \param[in] sorted set to true if the radius search results need to be sorted in ascending order
+          * based on their distance to the query point (the k-nearest neighbors are always sorted)
+          */
+        IncrementalKdTree (bool sorted = false);
+
+        /** \brief Destructor. */
+        ~IncrementalKdTree ()
+        {
+        }
+
+        /** \brief Build the tree from the given points, discarding the previous content.
+          * \param[in] cloud the const boost shared pointer to a PointCloud message
+          * \param[in] indices the point indices subset that is to be used from \a cloud
+          */
+        void
+        setInputCloud (const PointCloudConstPtr& cloud,
+                       const IndicesConstPtr& indices = IndicesConstPtr ()) override;
+
+        /** \brief Insert points into the tree. Points with non finite coordinates are skipped.
+          * \param[in] cloud the points to insert
+          * \param[out] point_indices the index assigned to each point of \a cloud in the cloud returned by
+          * \ref getInputCloud (-1 for the skipped points)
+          */
+        void
+        addPoints (const PointCloud& cloud, Indices& point_indices);
+
+        /** \brief Insert points into the tree. Points with non finite coordinates are skipped.
+          * \param[in] cloud the points to insert
+          */
+        void
+        addPoints (const PointCloud& cloud)
+        {
+          Indices point_indices;
+          addPoints (cloud, point_indices);
+        }
+
+        /** \brief Remove points from the tree.
+          * \param[in] point_indices the indices of the points to remove (as returned by the searches)
+          */
+        void
+        removePoints (const Indices& point_indices);
+
+        /** \brief Remove all points within an axis aligned box from the tree.
+          * \param[in] min_pt the minimum corner of the box
+          * \param[in] max_pt the maximum corner of the box
+          */
+        void
+        removePointsInBox (const Eigen::Vector4f& min_pt, const Eigen::Vector4f& max_pt);
+
+        /** \brief Get the number of points stored (and not removed) in the tree. */
+        inline std::size_t
+        getNumberOfPoints () const
+        {
+          return (root_ < 0 ? 0 : nodes_[root_].size - nodes_[root_].deleted_size);
+        }
+
+        /** \brief Set the fraction of nodes of a subtree that one of its children may hold before the
+          * subtree is rebuilt (default 0.7). Must be in (0.5, 1).
+          * \param[in] balance_factor the balance factor
+          */
+        inline void
+        setBalanceFactor (float balance_factor)
+        {
+          balance_factor_ = balance_factor;
+        }
+
+        /** \brief Get the balance factor. */
+        inline float
+        getBalanceFactor () const
+        {
+          return (balance_factor_);
+        }
+
+        /** \brief Set the fraction of nodes of a subtree that may be deleted before the subtree is
+          * rebuilt (default 0.5). Must be in (0, 1).
+          * \param[in] delete_factor the delete factor
+          */
+        inline void
+        setDeleteFactor (float delete_factor)
+        {
+          delete_factor_ = delete_factor;
+        }
+
+        /** \brief Get the delete factor. */
+        inline float
+        getDeleteFactor () const
+        {
+          return (delete_factor_);
+        }
+
+        /** \brief Search for the k-nearest neighbors for the given query point.
+          * \param[in] point the given query point
+          * \param[in] k the number of neighbors to search for
+          * \param[out] k_indices the resultant indices of the neighboring points
+          * \param[out] k_sqr_distances the resultant squared distances to the neighboring points
+          * \return number of neighbors found
+          */
+        int
+        nearestKSearch (const PointT &point, int k, Indices &k_indices,
+                        std::vector<float> &k_sqr_distances) const override;
+
+        /** \brief Search for all the nearest neighbors of the query point in a given radius.
+          * \param[in] point the given query point
+          * \param[in] radius the radius of the sphere bounding all of p_q's neighbors
+          * \param[out] k_indices the resultant indices of the neighboring points
+          * \param[out] k_sqr_distances the resultant squared distances to the neighboring points
+          * \param[in] max_nn if given, bounds the maximum returned neighbors to this value. If \a max_nn is set to
+          * 0 or to a number higher than the number of points in the input cloud, all neighbors in \a radius will be
+          * returned.
+          * \return number of neighbors found in radius
+          */
+        int
+        radiusSearch (const PointT& point, double radius, Indices &k_indices,
+                      std::vector<float> &k_sqr_distances, unsigned int max_nn = 0) const override;
+
+      protected:
+        /** \brief A node of the tree, holding one point. */
+        struct Node
+        {
+          /** \brief Index of the point in the cloud. */
+          index_t point;
+          /** \brief Index of the parent and children nodes (-1 if none). */
+          int parent, left, right;
+          /** \brief The axis (0, 1 or 2) this node splits its subtree along. */
+          int axis;
+          /** \brief Whether the point of this node is deleted. */
+          bool deleted;
+          /** \brief The number of nodes, and the number of deleted nodes in this subtree. */
+          std::size_t size, deleted_size;
+          /** \brief The bounding box of all points of this subtree. */
+          Eigen::Array3f min_pt, max_pt;
+        };
+
+        struct Entry
+        {
+          Entry (index_t idx, float dist) : index (idx), distance (dist) {}
+
+          index_t index;
+          float distance;
+
+          inline bool
+          operator < (const Entry& other) const
+          {
+            return (distance < other.distance);
+          }
+        };
+
+        /** \brief Build a balanced subtree from the points given in [begin, end). Returns the id of its root. */
+        int
+        build (std::vector<index_t>::iterator begin, std::vector<index_t>::iterator end, int parent);
+
+        /** \brief Rebuild a subtree into a balanced one, dropping its deleted nodes. */
+        void
+        rebuild (int node);
+
+        /** \brief Append the remaining (not deleted) points of a subtree to \a points and release its nodes. */
+        void
+        releaseSubtree (int node, std::vector<index_t>& points);
+
+        /** \brief Rebuild the highest subtree on the path from the root to \a node which violates the
+          * balance or the delete criterion (if any).
+          */
+        void
+        rebalancePath (int node);
+
+        /** \brief Rebuild all the subtrees violating the balance or delete criterion which intersect
+          * the given box (top-down, once a subtree is rebuilt its children are not visited).
+          */
+        void
+        rebalanceBox (int node, const Eigen::Array3f& min_pt, const Eigen::Array3f& max_pt);
+
+        /** \brief Whether the subtree rooted at \a node needs to be rebuilt. */
+        bool
+        needsRebuild (int node) const;
+
+        /** \brief Insert the point with the given index in the cloud into the tree. */
+        void
+        insert (index_t point);
+
+        /** \brief Mark the point of \a node as deleted and update the counters of its ancestors. */
+        void
+        markDeleted (int node);
+
+        /** \brief Mark all points of the subtree at \a node which lie in the box as deleted. */
+        void
+        removeInBox (int node, const Eigen::Array3f& min_pt, const Eigen::Array3f& max_pt);
+
+        /** \brief Get a free node, recycling the ones of removed subtrees. */
+        int
+        allocateNode ();
+
+        /** \brief Get the squared distance between a point and the bounding box of a subtree. */
+        inline float
+        boxSqrDistance (const Node& node, const Eigen::Array3f& point) const
+        {
+          return ((node.min_pt - point).max (point - node.max_pt).max (0.0f).matrix ().squaredNorm ());
+        }
+
+        /** \brief Whether an approximate search that visited \a nr_visited nodes has to stop. */
+        inline bool
+        isBudgetExhausted (std::size_t nr_visited) const
+        {
+          // every node is both a leaf and a candidate
+          return ((approximate_params_.max_checks > 0 && nr_visited >= approximate_params_.max_checks) ||
+                  (approximate_params_.max_candidates > 0 && nr_visited >= approximate_params_.max_candidates));
+        }
+
+        /** \brief Recursive k-nearest neighbor search. Subtrees farther away than the k-th candidate
+          * times \a sqr_scale are skipped (see ApproximateSearchParams).
+          */
+        void
+        nearestKSearchRecursive (int node, const Eigen::Array3f& point, unsigned int k, float sqr_scale,
+                                 std::priority_queue<Entry>& queue, std::size_t& nr_visited) const;
+
+        /** \brief Recursive radius search. Subtrees farther away than \a sqr_pruning_radius are skipped. */
+        void
+        radiusSearchRecursive (int node, const Eigen::Array3f& point, float sqr_radius, float sqr_pruning_radius,
+                               unsigned int max_nn, Indices& k_indices, std::vector<float>& k_sqr_distances,
+                               std::size_t& nr_visited) const;
+
+        /** \brief The points of the tree, including the removed ones whose slot was not recycled yet. */
+        PointCloudPtr cloud_;
+
+        /** \brief The nodes of the tree, with \a root_ being the root (-1 for an empty tree). */
+        std::vector<Node> nodes_;
+        int root_;
+
+        /** \brief For each point of the cloud the node holding it (-1 if the point is not in the tree). */
+        std::vector<int> point_to_node_;
+
+        /** \brief Nodes and cloud slots that may be reused. */
+        std::vector<int> free_nodes_;
+        Indices free_points_;
+
+        /** \brief Subtrees with fewer nodes than this are never rebuilt because of the criteria. */
+        std::size_t min_rebuild_size_;
+
+        float balance_factor_;
+        float delete_factor_;
+    };
+  }
+}
+
+#ifdef PCL_NO_PRECOMPILE
+#include <pcl/search/impl/incremental_kdtree.hpp>
+#endif
@@ -71,6 +71,7 @@ namespace pcl
         using pcl::search::Search<PointT>::nearestKSearch;
         using pcl::search::Search<PointT>::radiusSearch;
         using pcl::search::Search<PointT>::sorted_results_;
+        using pcl::search::Search<PointT>::approximate_params_;
 
         using Ptr = shared_ptr<KdTree<PointT, Tree> >;
         using ConstPtr = shared_ptr<const KdTree<PointT, Tree> >;
@@ -119,6 +120,13 @@ namespace pcl
         void
         setEpsilon (float eps);
 
+        /** \brief Let the searches trade accuracy for speed. The FLANN kd-tree honors the \a epsilon
+          * of the settings, its single tree index has no limit on the number of visited leaves.
+          * \param[in] params the approximation settings
+          */
+        void
+        setApproximateSearch (const ApproximateSearchParams &params) override;
+
         /** \brief Get the search epsilon precision (error bound) for nearest neighbors searches. */
         inline float
         getEpsilon () const
@@ -126,9 +134,19 @@ namespace pcl
           return (tree_->getEpsilon ());
         }
 
+        /** \brief Get the memory used by the search object and its internal tree.
+          * \return memory in bytes
+          */
+        inline std::size_t
+        getMemoryUsage () const
+        {
+          return (sizeof (*this) + (tree_ ? tree_->getMemoryUsage () : 0));
+        }
+
         /** \brief Provide a pointer to the input dataset.
           * \param[in] cloud the const boost shared pointer to a PointCloud message
           * \param[in] indices the point indices subset that is to be used from \a cloud 
+          * \note The tree is built with the number of threads given by \ref setNumberOfThreads.
           */
         void
         setInputCloud (const PointCloudConstPtr& cloud, 
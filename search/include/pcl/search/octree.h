@@ -84,6 +84,9 @@ namespace pcl
         using pcl::search::Search<PointT>::input_;
         using pcl::search::Search<PointT>::indices_;
         using pcl::search::Search<PointT>::sorted_results_;
+        using pcl::search::Search<PointT>::threads_;
+        using pcl::search::Search<PointT>::nearestKSearch;
+        using pcl::search::Search<PointT>::radiusSearch;
 
         /** \brief Octree constructor.
           * \param[in] resolution octree resolution at lowest octree level
@@ -100,6 +103,28 @@ namespace pcl
         {
         }
 
+        /** \brief Set the number of threads used by the batch search methods. The batch
+          * queries are forwarded to the octree, which processes them in its depth first order.
+          * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+          */
+        void
+        setNumberOfThreads (unsigned int nr_threads = 0) override
+        {
+          Search<PointT>::setNumberOfThreads (nr_threads);
+          tree_->setNumberOfThreads (threads_);
+        }
+
+        /** \brief Let the searches trade accuracy for speed. The octree honors all the settings, its
+          * leaves being the voxels at the lowest level.
+          * \param[in] params the approximation settings
+          */
+        void
+        setApproximateSearch (const ApproximateSearchParams &params) override
+        {
+          Search<PointT>::setApproximateSearch (params);
+          tree_->setApproximateSearch (params.epsilon, params.max_checks, params.max_candidates);
+        }
+
         /** \brief Provide a pointer to the input dataset.
           * \param[in] cloud the const boost shared pointer to a PointCloud message
           */
@@ -126,6 +151,15 @@ namespace pcl
           indices_ = indices;
         }
 
+        /** \brief Get the memory used by the search object and its internal octree.
+          * \return memory in bytes
+          */
+        inline std::size_t
+        getMemoryUsage () const
+        {
+          return (sizeof (*this) + (tree_ ? tree_->getMemoryUsage () : 0));
+        }
+
         /** \brief Search for the k-nearest neighbors for the given query point.
           * \param[in] cloud the point cloud data
           * \param[in] index the index in \a cloud representing the query point
@@ -174,6 +208,22 @@ namespace pcl
           return (tree_->nearestKSearch (index, k, k_indices, k_sqr_distances));
         }
 
+        /** \brief Search for the k-nearest neighbors of a batch of query points.
+          * \param[in] cloud the point cloud data
+          * \param[in] indices a vector of point cloud indices to query for nearest neighbors. If indices is empty,
+          * neighbors will be searched for all points.
+          * \param[in] k the number of neighbors to search for
+          * \param[out] k_indices the resultant indices of the neighboring points, k_indices[i] corresponds to the neighbors of the query point i
+          * \param[out] k_sqr_distances the resultant squared distances to the neighboring points, k_sqr_distances[i] corresponds to the neighbors of the query point i
+          */
+        inline void
+        nearestKSearch (const PointCloud& cloud, const Indices& indices, int k,
+                        std::vector<Indices>& k_indices,
+                        std::vector< std::vector<float> >& k_sqr_distances) const override
+        {
+          tree_->nearestKSearch (cloud, indices, k, k_indices, k_sqr_distances);
+        }
+
         /** \brief search for all neighbors of query point that are within a given radius.
          * \param cloud the point cloud data
          * \param index the index in \a cloud representing the query point
@@ -237,6 +287,27 @@ namespace pcl
           return (static_cast<int> (k_indices.size ()));
         }
 
+        /** \brief Search for all the nearest neighbors of a batch of query points in a given radius.
+          * \param[in] cloud the point cloud data
+          * \param[in] indices the indices in \a cloud. If indices is empty, neighbors will be searched for all points.
+          * \param[in] radius the radius of the sphere bounding all of p_q's neighbors
+          * \param[out] k_indices the resultant indices of the neighboring points, k_indices[i] corresponds to the neighbors of the query point i
+          * \param[out] k_sqr_distances the resultant squared distances to the neighboring points, k_sqr_distances[i] corresponds to the neighbors of the query point i
+          * \param[in] max_nn if given, bounds the maximum returned neighbors to this value
+          */
+        inline void
+        radiusSearch (const PointCloud& cloud,
+                      const Indices& indices,
+                      double radius,
+                      std::vector<Indices>& k_indices,
+                      std::vector< std::vector<float> > &k_sqr_distances,
+                      unsigned int max_nn = 0) const override
+        {
+          tree_->radiusSearch (cloud, indices, radius, k_indices, k_sqr_distances, max_nn);
+          if (sorted_results_)
+            for (std::size_t i = 0; i < k_indices.size (); ++i)
+              this->sortResults (k_indices[i], k_sqr_distances[i]);
+        }
 
         /** \brief Search for approximate nearest neighbor at the query point.
           * \param[in] cloud the point cloud data
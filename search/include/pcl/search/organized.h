@@ -76,6 +76,8 @@ namespace pcl
         using pcl::search::Search<PointT>::indices_;
         using pcl::search::Search<PointT>::sorted_results_;
         using pcl::search::Search<PointT>::input_;
+        using pcl::search::Search<PointT>::nearestKSearch;
+        using pcl::search::Search<PointT>::radiusSearch;
 
         /** \brief Constructor
           * \param[in] sorted_results whether the results should be return sorted in ascending order on the distances or not.
@@ -181,6 +183,37 @@ namespace pcl
                         Indices &k_indices,
                         std::vector<float> &k_sqr_distances) const override;
 
+        /** \brief Search for the k-nearest neighbors of the point at position \a index in \a cloud.
+          * \note If \a cloud is the input cloud, the search starts at the pixel of the query point instead of
+          * projecting it onto the image plane.
+          * \param[in] cloud the point cloud data
+          * \param[in] index the index in \a cloud representing the query point
+          * \param[in] k the number of neighbors to search for
+          * \param[out] k_indices the resultant indices of the neighboring points
+          * \param[out] k_sqr_distances the resultant squared distances to the neighboring points
+          * \return number of neighbors found
+          */
+        int
+        nearestKSearch (const PointCloud &cloud,
+                        index_t index,
+                        int k,
+                        Indices &k_indices,
+                        std::vector<float> &k_sqr_distances) const override;
+
+        /** \brief Search for the k-nearest neighbors of a batch of query points of \a cloud.
+          * \note The queries are split into contiguous blocks, one per thread, so queries given in row-major
+          * order of the image walk over neighboring pixels. Each thread reuses a single candidate buffer.
+          * \param[in] cloud the point cloud data
+          * \param[in] indices the indices in \a cloud of the query points
+          * \param[in] k the number of neighbors to search for
+          * \param[out] result the neighbors of all queries, in the order of \a indices
+          */
+        void
+        nearestKSearch (const PointCloud& cloud,
+                        const Indices& indices,
+                        int k,
+                        BatchSearchResult& result) const override;
+
         /** \brief projects a point into the image
           * \param[in] p point in 3D World Coordinate Frame to be projected onto the image plane
           * \param[out] q the 2D projected point in pixel coordinates (u,v)
@@ -237,6 +270,82 @@ namespace pcl
           return false;
         }
 
+        /** \brief test if point given by index is among the k NN in results to the query point.
+          * \param[in] query query point
+          * \param[in] k number of maximum nn interested in
+          * \param[in,out] heap max-heap (see std::push_heap) with the k NN
+          * \param[in] index index on point to be tested
+          * \return whether the top element changed or not.
+          */
+        inline bool
+        testPoint (const PointT& query, unsigned k, std::vector<Entry>& heap, index_t index) const
+        {
+          const PointT& point = input_->points [index];
+          if (mask_ [index] && std::isfinite (point.x))
+          {
+            float dist_x = point.x - query.x;
+            float dist_y = point.y - query.y;
+            float dist_z = point.z - query.z;
+            float squared_distance = dist_x * dist_x + dist_y * dist_y + dist_z * dist_z;
+            if (heap.size () < k)
+            {
+              heap.emplace_back (index, squared_distance);
+              std::push_heap (heap.begin (), heap.end ());
+              return heap.size () == k;
+            }
+            if (heap.front ().distance > squared_distance)
+            {
+              std::pop_heap (heap.begin (), heap.end ());
+              heap.back () = Entry (index, squared_distance);
+              std::push_heap (heap.begin (), heap.end ());
+              return true; // top element has changed!
+            }
+          }
+          return false;
+        }
+
+        /** \brief Get the pixel a query point projects to.
+          * \param[in] query query point
+          * \param[out] x the column of the pixel, may lie outside the image
+          * \param[out] y the row of the pixel, may lie outside the image
+          */
+        inline void
+        projectQuery (const PointT& query, int& x, int& y) const
+        {
+          const Eigen::Vector3f q (KR_ * query.getVector3fMap () + projection_matrix_.template block <3, 1> (0, 3));
+          x = static_cast<int> (q [0] / q [2] + 0.5f);
+          y = static_cast<int> (q [1] / q [2] + 0.5f);
+        }
+
+        /** \brief Search for the k-nearest neighbors of \a cloud[index], reusing the candidate buffer \a results. */
+        int
+        nearestKSearch (const PointCloud &cloud,
+                        index_t index,
+                        int k,
+                        std::vector<Entry> &results,
+                        Indices &k_indices,
+                        std::vector<float> &k_sqr_distances) const;
+
+        /** \brief Search for the k-nearest neighbors in square rings of pixels growing around the pixel (x, y), until
+          * the projected bounding box of the sphere through the k-th candidate lies inside the examined window.
+          * \param[in] query query point
+          * \param[in] k the number of neighbors to search for
+          * \param[in] x the column of the start pixel
+          * \param[in] y the row of the start pixel
+          * \param[in,out] results buffer for the candidates, reused across queries
+          * \param[out] k_indices the resultant indices of the neighboring points
+          * \param[out] k_sqr_distances the resultant squared distances to the neighboring points
+          * \return number of neighbors found
+          */
+        int
+        nearestKSearchFromPixel (const PointT &query,
+                                 int k,
+                                 int x,
+                                 int y,
+                                 std::vector<Entry> &results,
+                                 Indices &k_indices,
+                                 std::vector<float> &k_sqr_distances) const;
+
         inline void
         clipRange (int& begin, int &end, int min, int max) const
         {
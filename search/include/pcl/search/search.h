@@ -48,6 +48,90 @@ namespace pcl
 {
   namespace search
   {
+    /** \brief Flat (CSR-style) storage for the results of a batch of neighbor queries.
+      *
+      * Instead of one vector per query, the neighbors of all queries are stored back to back in
+      * \a indices and \a sqr_distances. The neighbors of the i-th query are found in the range
+      * [offsets[i], offsets[i + 1]), so \a offsets always holds one element more than there are
+      * queries. The buffers are only resized, never shrunk, which lets callers reuse one object
+      * across many batches without reallocating.
+      *
+      * \ingroup search
+      */
+    struct BatchSearchResult
+    {
+      /** \brief Start of the neighbors of each query in \a indices and \a sqr_distances, plus the total size at the end. */
+      std::vector<std::size_t> offsets;
+
+      /** \brief The indices of the neighbors of all queries. */
+      Indices indices;
+
+      /** \brief The squared distances of the neighbors of all queries. */
+      std::vector<float> sqr_distances;
+
+      /** \brief Get the number of queries stored. */
+      inline std::size_t
+      size () const
+      {
+        return (offsets.empty () ? 0 : offsets.size () - 1);
+      }
+
+      /** \brief Get the number of neighbors found for the query \a query. */
+      inline std::size_t
+      count (std::size_t query) const
+      {
+        return (offsets[query + 1] - offsets[query]);
+      }
+
+      /** \brief Get a pointer to the first neighbor index of the query \a query. */
+      inline const index_t*
+      neighbors (std::size_t query) const
+      {
+        return (indices.data () + offsets[query]);
+      }
+
+      /** \brief Get a pointer to the first squared neighbor distance of the query \a query. */
+      inline const float*
+      distances (std::size_t query) const
+      {
+        return (sqr_distances.data () + offsets[query]);
+      }
+    };
+
+    /** \brief Settings that let the searches trade accuracy for speed, see Search::setApproximateSearch.
+      *
+      * The default values make all searches exact.
+      *
+      * \ingroup search
+      */
+    struct ApproximateSearchParams
+    {
+      /** \brief Relative error bound. The searches may skip the parts of the search structure that are
+        * farther away from the query than the current k-th neighbor (or the radius) divided by
+        * (1 + epsilon): the i-th neighbor returned by a k-nearest neighbor search is at most (1 + epsilon)
+        * times farther away than the true i-th neighbor, and a radius search returns at least all the
+        * neighbors closer than radius / (1 + epsilon).
+        */
+      float epsilon = 0.0f;
+
+      /** \brief Maximum number of leaves (e.g. tree leaves or octree voxels) visited per query, 0 for no
+        * limit. A k-nearest neighbor search only stops early once it has found k candidates.
+        */
+      unsigned int max_checks = 0;
+
+      /** \brief Maximum number of points whose distance to the query is computed, 0 for no limit.
+        * A k-nearest neighbor search only stops early once it has found k candidates.
+        */
+      unsigned int max_candidates = 0;
+
+      /** \brief Whether the settings make the searches exact. */
+      inline bool
+      isExact () const
+      {
+        return (epsilon <= 0.0f && max_checks == 0 && max_candidates == 0);
+      }
+    };
+
     /** \brief Generic search class. All search wrappers must inherit from this.
       *
       * Each search method must implement 2 different types of search:
@@ -111,6 +195,47 @@ namespace pcl
         virtual bool 
         getSortedResults ();
 
+        /** \brief Set the number of threads used by the batch search methods (the ones taking a
+          * cloud and a vector of query indices). The single point queries of all search methods
+          * are thread safe, so the queries of a batch are simply distributed over the threads.
+          * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+          */
+        virtual void
+        setNumberOfThreads (unsigned int nr_threads = 0);
+
+        /** \brief Get the number of threads used by the batch search methods. */
+        inline unsigned int
+        getNumberOfThreads () const
+        {
+          return (threads_);
+        }
+
+        /** \brief Let the searches trade accuracy for speed (see ApproximateSearchParams), e.g. for
+          * features or registrations that tolerate slightly wrong neighbors.
+          *
+          * Every search method applies the settings its structure supports:
+          *   - KdTree: \a epsilon (FLANN's single kd-tree index has no limit on the visited leaves)
+          *   - FlannSearch: \a epsilon, and the smaller non zero limit as FLANN's number of checks
+          *   - Octree: all settings, the leaves being the octree voxels
+          *   - OrganizedNeighbor: \a epsilon, and for k-nearest neighbor searches the limits, the
+          *     leaves being the rings of pixels around the projection of the query
+          *   - IncrementalKdTree: all settings, every node being both a leaf and a candidate
+          *   - BruteForce: none, it always computes all distances
+          * \param[in] params the approximation settings
+          */
+        virtual void
+        setApproximateSearch (const ApproximateSearchParams &params)
+        {
+          approximate_params_ = params;
+        }
+
+        /** \brief Get the approximation settings of the searches. */
+        inline const ApproximateSearchParams&
+        getApproximateSearch () const
+        {
+          return (approximate_params_);
+        }
+
         
         /** \brief Pass the input dataset that the search will be performed on.
           * \param[in] cloud a const pointer to the PointCloud data
@@ -219,6 +344,18 @@ namespace pcl
                         int k, std::vector<Indices>& k_indices,
                         std::vector< std::vector<float> >& k_sqr_distances) const;
 
+        /** \brief Search for the k-nearest neighbors of a batch of query points, storing the results in flat buffers.
+          * The queries are distributed over the number of threads given by \ref setNumberOfThreads.
+          * \param[in] cloud the point cloud data
+          * \param[in] indices a vector of point cloud indices to query for nearest neighbors. If indices is empty,
+          * neighbors will be searched for all points.
+          * \param[in] k the number of neighbors to search for
+          * \param[out] result the neighbors of all queries, in the same order as the queries
+          */
+        virtual void
+        nearestKSearch (const PointCloud& cloud, const Indices& indices,
+                        int k, BatchSearchResult& result) const;
+
         /** \brief Search for the k-nearest neighbors for the given query point. Use this method if the query points are of a different type than the points in the data set (e.g. PointXYZRGBA instead of PointXYZ).
           * \param[in] cloud the point cloud data
           * \param[in] indices a vector of point cloud indices to query for nearest neighbors
@@ -355,6 +492,24 @@ namespace pcl
                       std::vector< std::vector<float> > &k_sqr_distances,
                       unsigned int max_nn = 0) const;
 
+        /** \brief Search for all the nearest neighbors of a batch of query points in a given radius, storing the
+          * results in flat buffers. The queries are distributed over the number of threads given by
+          * \ref setNumberOfThreads.
+          * \param[in] cloud the point cloud data
+          * \param[in] indices the indices in \a cloud. If indices is empty, neighbors will be searched for all points.
+          * \param[in] radius the radius of the sphere bounding all of p_q's neighbors
+          * \param[out] result the neighbors of all queries, in the same order as the queries
+          * \param[in] max_nn if given, bounds the maximum returned neighbors to this value. If \a max_nn is set to
+          * 0 or to a number higher than the number of points in the input cloud, all neighbors in \a radius will be
+          * returned.
+          */
+        virtual void
+        radiusSearch (const PointCloud& cloud,
+                      const Indices& indices,
+                      double radius,
+                      BatchSearchResult& result,
+                      unsigned int max_nn = 0) const;
+
         /** \brief Search for all the nearest neighbors of the query points in a given radius.
           * \param[in] cloud the point cloud data
           * \param[in] indices a vector of point cloud indices to query for nearest neighbors
@@ -400,10 +555,26 @@ namespace pcl
         void 
         sortResults (Indices& indices, std::vector<float>& distances) const;
 
+        /** \brief Run a batch of queries in parallel and gather the results in flat buffers.
+          * \param[in] cloud the point cloud holding the query points
+          * \param[in] indices the indices of the query points in \a cloud (all points if empty)
+          * \param[out] result the neighbors of all queries
+          * \param[in] search a callable (index_t query, Indices&, std::vector<float>&) -> int running a single query
+          */
+        template <typename SearchFunctor> void
+        batchSearch (const PointCloud& cloud, const Indices& indices,
+                     BatchSearchResult& result, const SearchFunctor& search) const;
+
         PointCloudConstPtr input_;
         IndicesConstPtr indices_;
         bool sorted_results_;
         std::string name_;
+
+        /** \brief The number of threads used by the batch search methods. */
+        unsigned int threads_;
+
+        /** \brief The approximation settings of the searches. */
+        ApproximateSearchParams approximate_params_;
         
       private:
         struct Compare
@@ -0,0 +1,16 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved
+ */
+
+#include <pcl/impl/instantiate.hpp>
+#include <pcl/point_types.h>
+#include <pcl/search/incremental_kdtree.h>
+#include <pcl/search/impl/incremental_kdtree.hpp>
+
+// Instantiations of specific point types
+PCL_INSTANTIATE (IncrementalKdTree, PCL_XYZ_POINT_TYPES)
@@ -143,6 +143,17 @@ namespace pcl
 
     protected:
 
+      /** \brief Replace every cell of the grid by the lowest (erosion) or highest (dilation) cell of the square window
+        * centered on it, ignoring the empty (NaN) cells. The rows and then the columns are filtered with the algorithm
+        * of van Herk and Gil-Werman, in a constant number of comparisons per cell whatever the window size.
+        * \param[in] grid the grid to filter
+        * \param[in] half_size the half size of the window, in cells
+        * \param[in] erode whether to take the lowest cell (erosion) or the highest one (dilation)
+        * \param[in,out] filtered the filtered grid: the cells whose window is empty are left unchanged
+        */
+      void
+      applyWindowFilter (const Eigen::MatrixXf &grid, int half_size, bool erode, Eigen::MatrixXf &filtered) const;
+
       /** \brief Maximum window size to be used in filtering ground returns. */
       int max_window_size_;
 
@@ -42,6 +42,7 @@
 #include <pcl/pcl_macros.h>
 #include <pcl/search/pcl_search.h>
 
+#include <cstdint>
 #include <functional>
 
 namespace pcl
@@ -92,6 +93,10 @@ namespace pcl
       using PCLBase<PointT>::deinitCompute;
 
     public:
+      /** \brief The type of the batched condition, see setBatchConditionFunction(). */
+      using BatchConditionFunction = std::function<void (const PointCloud<PointT>&, index_t, const Indices&,
+                                                         const std::vector<float>&, std::vector<std::uint8_t>&)>;
+
       /** \brief Constructor.
         * \param[in] extract_removed_clusters Set to true if you want to be able to extract the clusters that are too large or too small (default = false)
         */
@@ -103,7 +108,8 @@ namespace pcl
           max_cluster_size_ (std::numeric_limits<int>::max ()),
           extract_removed_clusters_ (extract_removed_clusters),
           small_clusters_ (new pcl::IndicesClusters),
-          large_clusters_ (new pcl::IndicesClusters)
+          large_clusters_ (new pcl::IndicesClusters),
+          threads_ (1)
       {
       }
 
@@ -145,6 +151,7 @@ namespace pcl
       setConditionFunction (bool (*condition_function) (const PointT&, const PointT&, float))
       {
         condition_function_ = condition_function;
+        batch_condition_function_ = nullptr;
       }
 
       /** \brief Set the condition that needs to hold for neighboring points to be considered part of the same cluster.
@@ -153,6 +160,48 @@ namespace pcl
       setConditionFunction (std::function<bool (const PointT&, const PointT&, float)> condition_function)
       {
         condition_function_ = condition_function;
+        batch_condition_function_ = nullptr;
+      }
+
+      /** \brief Set the condition that needs to hold for neighboring points to be considered part of the same cluster,
+        * evaluated on all the candidate neighbors of a point at once, which allows vectorizing it. It replaces the
+        * condition set with setConditionFunction().
+        * \details The input arguments of the condition function are:
+        * <ul>
+        *  <li>PointCloud The input cloud</li>
+        *  <li>index_t The index of the first point of the point pairs</li>
+        *  <li>Indices The indices of the second points of the point pairs, closer than the cluster tolerance</li>
+        *  <li>std::vector<float> The squared distances between the first point and the second points</li>
+        *  <li>std::vector<std::uint8_t> The results, as many as the second points and all zero on input, to set to non
+        *      zero for the second points to merge into the cluster of the first point</li>
+        * </ul>
+        * \param[in] batch_condition_function The condition function that needs to hold for clustering
+        */
+      inline void
+      setBatchConditionFunction (BatchConditionFunction batch_condition_function)
+      {
+        batch_condition_function_ = batch_condition_function;
+        condition_function_ = nullptr;
+      }
+
+      /** \brief Set the number of threads to use.
+        * \details With several threads the neighbors of all the points are searched and the condition evaluated in
+        * parallel, and the clusters are the connected components of the point pairs for which the condition holds. If
+        * the condition is symmetric, which it has to be then, these are the same clusters as with a single thread, in
+        * the same order, but with sorted indices. The condition is called concurrently.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value automatically, default = 1)
+        */
+      inline void
+      setNumberOfThreads (unsigned int nr_threads)
+      {
+        threads_ = nr_threads;
+      }
+
+      /** \brief Get the number of threads to use, as set by the user. */
+      inline unsigned int
+      getNumberOfThreads () const
+      {
+        return (threads_);
       }
 
       /** \brief Set the spatial tolerance for new cluster candidates.
@@ -241,6 +290,9 @@ namespace pcl
       /** \brief The condition function that needs to hold for clustering */
       std::function<bool (const PointT&, const PointT&, float)> condition_function_;
 
+      /** \brief The batched condition function that needs to hold for clustering, if set instead of condition_function_ */
+      BatchConditionFunction batch_condition_function_;
+
       /** \brief The distance to scan for cluster candidates (default = 0.0) */
       float cluster_tolerance_;
 
@@ -259,6 +311,13 @@ namespace pcl
       /** \brief The resultant clusters that contain more than max_cluster_size points */
       pcl::IndicesClustersPtr large_clusters_;
 
+      /** \brief The number of threads to use (0 for automatic, default = 1) */
+      unsigned int threads_;
+
+      /** \brief Store a cluster in the valid, small or large clusters according to its size */
+      void
+      addCluster (std::vector<int> &cluster, IndicesClusters &clusters);
+
     public:
       PCL_MAKE_ALIGNED_OPERATOR_NEW
   };
@@ -85,6 +85,7 @@ namespace pcl
       using LCCP::concavity_tolerance_threshold_;
       using LCCP::seed_resolution_;
       using LCCP::supervoxels_set_;
+      using LCCP::threads_;
 
     public:
       CPCSegmentation ();
@@ -242,6 +243,14 @@ namespace pcl
           }
 
         protected:
+          /** \brief Score of a plane: the mean (directed) weight of all points closer than the threshold to it
+            * \param[in] model_coefficients the plane coefficients
+            * \note Uses the same point to plane distance as SampleConsensusModelPlane::selectWithinDistance,
+            * but is const so that several hypotheses can be scored in parallel
+            */
+          double
+          scoreModel (const Eigen::VectorXf &model_coefficients) const;
+
           /** \brief Initialize the model parameters. Called by the constructors. */
           void
           initialize ()
@@ -80,6 +80,49 @@ namespace pcl
       const typename search::Search<PointT>::Ptr &tree, float tolerance, std::vector<PointIndices> &clusters,
       unsigned int min_pts_per_cluster = 1, unsigned int max_pts_per_cluster = (std::numeric_limits<int>::max) ());
 
+  //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  /** \brief Decompose a region of space into clusters based on the Euclidean distance between points, with several
+    * threads. The neighbors of the points are searched in parallel and the clusters are merged concurrently, the
+    * clusters are the same as with the serial version, in the same order.
+    * \param cloud the point cloud message
+    * \param indices a list of point indices to use from \a cloud
+    * \param tree the spatial locator (e.g., kd-tree) used for nearest neighbors searching
+    * \note the tree has to be created as a spatial locator on \a cloud and \a indices, and its searches have to be
+    * thread-safe
+    * \param tolerance the spatial cluster tolerance as a measure in L2 Euclidean space
+    * \param clusters the resultant clusters containing point indices (as a vector of PointIndices)
+    * \param min_pts_per_cluster minimum number of points that a cluster may contain
+    * \param max_pts_per_cluster maximum number of points that a cluster may contain
+    * \param nr_threads the number of threads to use (0 sets the value automatically, 1 runs the serial version)
+    * \ingroup segmentation
+    */
+  template <typename PointT> void 
+  extractEuclideanClusters (
+      const PointCloud<PointT> &cloud, const std::vector<int> &indices,
+      const typename search::Search<PointT>::Ptr &tree, float tolerance, std::vector<PointIndices> &clusters,
+      unsigned int min_pts_per_cluster, unsigned int max_pts_per_cluster, unsigned int nr_threads);
+
+  //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  /** \brief Decompose a region of space into clusters based on the Euclidean distance between points, on a voxel
+    * grid instead of radius searches. The points are hashed into voxels whose diagonal is the tolerance, so that the
+    * points of a voxel are always in the same cluster, and two nearby voxels are merged as soon as one pair of their
+    * points is closer than the tolerance. The clusters are the same as with the radius search, in the same order (up
+    * to the rounding of the distances equal to the tolerance), but the cost does not grow with the number of points
+    * within the tolerance, which makes it much faster for large tolerances on dense clouds.
+    * \param cloud the point cloud message
+    * \param indices a list of point indices to use from \a cloud
+    * \param tolerance the spatial cluster tolerance as a measure in L2 Euclidean space
+    * \param clusters the resultant clusters containing point indices (as a vector of PointIndices)
+    * \param min_pts_per_cluster minimum number of points that a cluster may contain (default: 1)
+    * \param max_pts_per_cluster maximum number of points that a cluster may contain (default: max int)
+    * \ingroup segmentation
+    */
+  template <typename PointT> void
+  extractEuclideanClustersOnGrid (
+      const PointCloud<PointT> &cloud, const std::vector<int> &indices,
+      float tolerance, std::vector<PointIndices> &clusters,
+      unsigned int min_pts_per_cluster = 1, unsigned int max_pts_per_cluster = (std::numeric_limits<int>::max) ());
+
   //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
   /** \brief Decompose a region of space into clusters based on the euclidean distance between points, and the normal
     * angular deviation
@@ -323,7 +366,9 @@ namespace pcl
       EuclideanClusterExtraction () : tree_ (), 
                                       cluster_tolerance_ (0),
                                       min_pts_per_cluster_ (1), 
-                                      max_pts_per_cluster_ (std::numeric_limits<int>::max ())
+                                      max_pts_per_cluster_ (std::numeric_limits<int>::max ()),
+                                      threads_ (1),
+                                      use_grid_ (false)
       {};
 
       /** \brief Provide a pointer to the search object.
@@ -392,6 +437,41 @@ namespace pcl
         return (max_pts_per_cluster_); 
       }
 
+      /** \brief Set the number of threads to use, the clusters are the same with any number of threads.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value automatically, 1 runs the
+        * serial version, default)
+        */
+      inline void
+      setNumberOfThreads (unsigned int nr_threads)
+      {
+        threads_ = nr_threads;
+      }
+
+      /** \brief Get the number of threads to use, as set by the user. */
+      inline unsigned int
+      getNumberOfThreads () const
+      {
+        return (threads_);
+      }
+
+      /** \brief Set whether to cluster the points on a voxel grid instead of with radius searches. The clusters are
+        * the same, but the grid is much faster when the tolerance is large compared to the density of the cloud, as
+        * it does not enumerate the neighborhoods. The search method and the number of threads are not used then.
+        * \param[in] use_grid true to cluster on a voxel grid (default: false)
+        */
+      inline void
+      setUseGrid (bool use_grid)
+      {
+        use_grid_ = use_grid;
+      }
+
+      /** \brief Get whether the points are clustered on a voxel grid instead of with radius searches. */
+      inline bool
+      getUseGrid () const
+      {
+        return (use_grid_);
+      }
+
       /** \brief Cluster extraction in a PointCloud given by <setInputCloud (), setIndices ()>
         * \param[out] clusters the resultant point clusters
         */
@@ -417,6 +497,12 @@ namespace pcl
       /** \brief The maximum number of points that a cluster needs to contain in order to be considered valid (default = MAXINT). */
       int max_pts_per_cluster_;
 
+      /** \brief The number of threads to use (0 for automatic, default = 1). */
+      unsigned int threads_;
+
+      /** \brief Whether to cluster the points on a voxel grid instead of with radius searches (default = false). */
+      bool use_grid_;
+
       /** \brief Class getName method. */
       virtual std::string getClassName () const { return ("EuclideanClusterExtraction"); }
 
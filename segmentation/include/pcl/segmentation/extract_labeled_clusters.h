@@ -59,6 +59,27 @@ namespace pcl
       unsigned int min_pts_per_cluster = 1, unsigned int max_pts_per_cluster = std::numeric_limits<unsigned int>::max (),
       unsigned int max_label = std::numeric_limits<unsigned int>::max ());
 
+  //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  /** \brief Decompose a region of space into clusters based on the Euclidean distance between points, with several
+    * threads. The clusters are the same as with the serial version, in the same order.
+    * \param[in] cloud the point cloud message
+    * \param[in] tree the spatial locator (e.g., kd-tree) used for nearest neighbors searching
+    * \note the tree has to be created as a spatial locator on \a cloud, and its searches have to be thread-safe
+    * \param[in] tolerance the spatial cluster tolerance as a measure in L2 Euclidean space
+    * \param[out] labeled_clusters the resultant clusters containing point indices (as a vector of PointIndices)
+    * \param[in] min_pts_per_cluster minimum number of points that a cluster may contain
+    * \param[in] max_pts_per_cluster maximum number of points that a cluster may contain
+    * \param[in] max_label
+    * \param[in] nr_threads the number of threads to use (0 sets the value automatically, 1 runs the serial version)
+    * \ingroup segmentation
+    */
+  template <typename PointT> void 
+  extractLabeledEuclideanClusters (
+      const PointCloud<PointT> &cloud, const typename search::Search<PointT>::Ptr &tree,
+      float tolerance, std::vector<std::vector<PointIndices> > &labeled_clusters,
+      unsigned int min_pts_per_cluster, unsigned int max_pts_per_cluster,
+      unsigned int max_label, unsigned int nr_threads);
+
   //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
   //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
   //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -89,7 +110,8 @@ namespace pcl
         cluster_tolerance_ (0),
         min_pts_per_cluster_ (1), 
         max_pts_per_cluster_ (std::numeric_limits<int>::max ()),
-        max_label_ (std::numeric_limits<int>::max ())
+        max_label_ (std::numeric_limits<int>::max ()),
+        threads_ (1)
       {};
 
       /** \brief Provide a pointer to the search object.
@@ -142,6 +164,17 @@ namespace pcl
       inline unsigned int 
       getMaxLabels () const { return (max_label_); }
 
+      /** \brief Set the number of threads to use, the clusters are the same with any number of threads.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value automatically, 1 runs the
+        * serial version, default)
+        */
+      inline void
+      setNumberOfThreads (unsigned int nr_threads) { threads_ = nr_threads; }
+
+      /** \brief Get the number of threads to use, as set by the user. */
+      inline unsigned int
+      getNumberOfThreads () const { return (threads_); }
+
       /** \brief Cluster extraction in a PointCloud given by <setInputCloud (), setIndices ()>
         * \param[out] labeled_clusters the resultant point clusters
         */
@@ -170,6 +203,9 @@ namespace pcl
       /** \brief The maximum number of labels we can find in this pointcloud (default = MAXINT)*/
       unsigned int max_label_;
 
+      /** \brief The number of threads to use (0 for automatic, default = 1). */
+      unsigned int threads_;
+
       /** \brief Class getName method. */
       virtual std::string getClassName () const { return ("LabeledEuclideanClusterExtraction"); }
 
@@ -125,10 +125,7 @@ pcl::ApproximateProgressiveMorphologicalFilter<PointT>::extract (std::vector<int
   Eigen::MatrixXf Zf (rows, cols);
   Zf.setConstant (std::numeric_limits<float>::quiet_NaN ());
 
-#pragma omp parallel for \
-  default(none) \
-  shared(A, global_min) \
-  num_threads(threads_)
+  // Several points fall in the same cell, keep the lowest one
   for (int i = 0; i < (int)input_->size (); ++i)
   {
     // ...then test for lower points within the cell
@@ -157,89 +154,29 @@ pcl::ApproximateProgressiveMorphologicalFilter<PointT>::extract (std::vector<int
     pcl::copyPointCloud<PointT> (*input_, ground, *cloud);
 
     // Apply the morphological opening operation at the current window size.
-#pragma omp parallel for \
-  default(none) \
-  shared(A, cols, half_sizes, i, rows, Z) \
-  num_threads(threads_)
-    for (int row = 0; row < rows; ++row)
-    {
-      int rs, re;
-      rs = ((row - half_sizes[i]) < 0) ? 0 : row - half_sizes[i];
-      re = ((row + half_sizes[i]) > (rows-1)) ? (rows-1) : row + half_sizes[i];
-
-      for (int col = 0; col < cols; ++col)
-      {
-        int cs, ce;
-        cs = ((col - half_sizes[i]) < 0) ? 0 : col - half_sizes[i];
-        ce = ((col + half_sizes[i]) > (cols-1)) ? (cols-1) : col + half_sizes[i];
-
-        float min_coeff = std::numeric_limits<float>::max ();
-
-        for (int j = rs; j < (re + 1); ++j)
-        {
-          for (int k = cs; k < (ce + 1); ++k)
-          {
-            if (A (j, k) != std::numeric_limits<float>::quiet_NaN ())
-            {
-              if (A (j, k) < min_coeff)
-                min_coeff = A (j, k);
-            }
-          }
-        }
-
-        if (min_coeff != std::numeric_limits<float>::max ())
-          Z(row, col) = min_coeff;
-      }
-    }
+    applyWindowFilter (A, half_sizes[i], true, Z);
+    applyWindowFilter (Z, half_sizes[i], false, Zf);
 
+    // Find indices of the points whose difference between the source and
+    // filtered point clouds is less than the current height threshold.
+    std::vector<unsigned char> is_ground (ground.size ());
 #pragma omp parallel for \
   default(none) \
-  shared(cols, half_sizes, i, rows, Z, Zf) \
+  shared(cloud, global_min, height_thresholds, i, is_ground, Zf) \
   num_threads(threads_)
-    for (int row = 0; row < rows; ++row)
-    {
-      int rs, re;
-      rs = ((row - half_sizes[i]) < 0) ? 0 : row - half_sizes[i];
-      re = ((row + half_sizes[i]) > (rows-1)) ? (rows-1) : row + half_sizes[i];
-
-      for (int col = 0; col < cols; ++col)
-      {
-        int cs, ce;
-        cs = ((col - half_sizes[i]) < 0) ? 0 : col - half_sizes[i];
-        ce = ((col + half_sizes[i]) > (cols-1)) ? (cols-1) : col + half_sizes[i];
-
-        float max_coeff = -std::numeric_limits<float>::max ();
-
-        for (int j = rs; j < (re + 1); ++j)
-        {
-          for (int k = cs; k < (ce + 1); ++k)
-          {
-            if (Z (j, k) != std::numeric_limits<float>::quiet_NaN ())
-            {
-              if (Z (j, k) > max_coeff)
-                max_coeff = Z (j, k);
-            }
-          }
-        }
-
-        if (max_coeff != -std::numeric_limits<float>::max ())
-          Zf (row, col) = max_coeff;
-      }
-    }
-
-    // Find indices of the points whose difference between the source and
-    // filtered point clouds is less than the current height threshold.
-    std::vector<int> pt_indices;
-    for (std::size_t p_idx = 0; p_idx < ground.size (); ++p_idx)
+    for (std::ptrdiff_t p_idx = 0; p_idx < static_cast<std::ptrdiff_t> (is_ground.size ()); ++p_idx)
     {
       PointT p = (*cloud)[p_idx];
       int erow = static_cast<int> (std::floor ((p.y - global_min.y ()) / cell_size_));
       int ecol = static_cast<int> (std::floor ((p.x - global_min.x ()) / cell_size_));
 
       float diff = p.z - Zf (erow, ecol);
-      if (diff < height_thresholds[i])
-        pt_indices.push_back (ground[p_idx]);
+      is_ground[p_idx] = diff < height_thresholds[i];
     }
+    std::vector<int> pt_indices;
+    for (std::size_t p_idx = 0; p_idx < ground.size (); ++p_idx)
+      if (is_ground[p_idx])
+        pt_indices.push_back (ground[p_idx]);
 
     A.swap (Zf);
 
@@ -252,6 +189,73 @@ pcl::ApproximateProgressiveMorphologicalFilter<PointT>::extract (std::vector<int
   deinitCompute ();
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::ApproximateProgressiveMorphologicalFilter<PointT>::applyWindowFilter (const Eigen::MatrixXf &grid, int half_size, bool erode,
+                                                                            Eigen::MatrixXf &filtered) const
+{
+  const int rows = static_cast<int> (grid.rows ());
+  const int cols = static_cast<int> (grid.cols ());
+  const int window = 2 * half_size + 1;
+
+  // The empty cells, and the cells out of the grid, hold a value that never wins
+  const float none = erode ? std::numeric_limits<float>::max () : -std::numeric_limits<float>::max ();
+  const auto best = [erode] (float a, float b) { return (erode ? std::min (a, b) : std::max (a, b)); };
+
+  // Extremum over the windows of a padded line, from the prefix and suffix extrema of blocks of the window size
+  const auto filter_line = [&] (std::vector<float> &line, std::vector<float> &prefix, std::vector<float> &suffix, int size)
+  {
+    const int padded_size = ((size + 2 * half_size + window - 1) / window) * window;
+    line.resize (padded_size, none);
+    prefix.resize (padded_size);
+    suffix.resize (padded_size);
+    for (int start = 0; start < padded_size; start += window)
+    {
+      prefix[start] = line[start];
+      for (int j = start + 1; j < start + window; ++j)
+        prefix[j] = best (prefix[j - 1], line[j]);
+      suffix[start + window - 1] = line[start + window - 1];
+      for (int j = start + window - 2; j >= start; --j)
+        suffix[j] = best (suffix[j + 1], line[j]);
+    }
+    for (int j = 0; j < size; ++j)
+      line[j] = best (suffix[j], prefix[j + 2 * half_size]);
+  };
+
+  Eigen::MatrixXf columns_filtered (rows, cols);
+#pragma omp parallel \
+  default(none) \
+  shared(cols, columns_filtered, erode, filter_line, filtered, grid, half_size, none, rows) \
+  num_threads(threads_)
+  {
+    std::vector<float> line, prefix, suffix;
+#pragma omp for
+    for (int col = 0; col < cols; ++col)
+    {
+      line.assign (half_size, none);
+      for (int row = 0; row < rows; ++row)
+      {
+        const float value = grid (row, col);
+        line.push_back ((erode ? value < none : value > none) ? value : none);
+      }
+      filter_line (line, prefix, suffix, rows);
+      for (int row = 0; row < rows; ++row)
+        columns_filtered (row, col) = line[row];
+    }
+
+#pragma omp for
+    for (int row = 0; row < rows; ++row)
+    {
+      line.assign (half_size, none);
+      for (int col = 0; col < cols; ++col)
+        line.push_back (columns_filtered (row, col));
+      filter_line (line, prefix, suffix, cols);
+      for (int col = 0; col < cols; ++col)
+        if (line[col] != none)
+          filtered (row, col) = line[col];
+    }
+  }
+}
 
 #define PCL_INSTANTIATE_ApproximateProgressiveMorphologicalFilter(T) template class pcl::ApproximateProgressiveMorphologicalFilter<T>;
 
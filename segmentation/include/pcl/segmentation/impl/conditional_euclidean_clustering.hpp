@@ -38,6 +38,7 @@
 #define PCL_SEGMENTATION_IMPL_CONDITIONAL_EUCLIDEAN_CLUSTERING_HPP_
 
 #include <pcl/segmentation/conditional_euclidean_clustering.h>
+#include <pcl/segmentation/impl/extract_clusters.hpp> // for detail::extractEuclideanComponentsBatched
 
 template<typename PointT> void
 pcl::ConditionalEuclideanClustering<PointT>::segment (pcl::IndicesClusters &clusters)
@@ -51,7 +52,7 @@ pcl::ConditionalEuclideanClustering<PointT>::segment (pcl::IndicesClusters &clus
   }
 
   // Validity checks
-  if (!initCompute () || input_->points.empty () || indices_->empty () || !condition_function_)
+  if (!initCompute () || input_->points.empty () || indices_->empty () || (!condition_function_ && !batch_condition_function_))
     return;
 
   // Initialize the search class
@@ -64,10 +65,43 @@ pcl::ConditionalEuclideanClustering<PointT>::segment (pcl::IndicesClusters &clus
   }
   searcher_->setInputCloud (input_, indices_);
 
+  unsigned int nr_threads = threads_;
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    nr_threads = omp_get_num_procs ();
+#else
+    nr_threads = 1;
+#endif
+  if (nr_threads > 1)
+  {
+    // Evaluate the condition on the neighbors of all the points in parallel, and merge the pairs for which it holds
+    const auto connected = [this] (int index, const Indices &candidates, const std::vector<float> &sqr_distances,
+                                   std::vector<std::uint8_t> &conditions)
+    {
+      if (batch_condition_function_)
+        batch_condition_function_ (*input_, index, candidates, sqr_distances, conditions);
+      else
+        for (std::size_t i = 0; i < candidates.size (); ++i)
+          conditions[i] = condition_function_ ((*input_)[index], (*input_)[candidates[i]], sqr_distances[i]);
+    };
+    std::vector<std::vector<int> > components;
+    detail::extractEuclideanComponentsBatched (*input_, *indices_, searcher_, cluster_tolerance_, connected, nr_threads, components);
+    for (auto &component : components)
+      addCluster (component, clusters);
+
+    deinitCompute ();
+    return;
+  }
+
   // Temp variables used by search class
   std::vector<int> nn_indices;
   std::vector<float> nn_distances;
 
+  // Temp variables used by the batched condition
+  Indices candidates;
+  std::vector<float> candidate_distances;
+  std::vector<std::uint8_t> conditions;
+
   // Create a bool vector of processed point indices, and initialize it to false
   // Need to have it contain all possible points because radius search can not return indices into indices
   std::vector<bool> processed (input_->size (), false);
@@ -97,8 +131,37 @@ pcl::ConditionalEuclideanClustering<PointT>::segment (pcl::IndicesClusters &clus
         continue;
       }
 
-      // Process the neighbors
-      for (int nii = 1; nii < static_cast<int> (nn_indices.size ()); ++nii)  // nii = neighbor indices iterator
+      if (batch_condition_function_)
+      {
+        // Evaluate the condition on all the neighbors that have not been processed before (the seed point itself is
+        // among them, whether the search results are sorted or not)
+        candidates.clear ();
+        candidate_distances.clear ();
+        for (int nii = 0; nii < static_cast<int> (nn_indices.size ()); ++nii)  // nii = neighbor indices iterator
+        {
+          if (nn_indices[nii] == -1 || processed[nn_indices[nii]])
+            continue;
+          candidates.push_back (nn_indices[nii]);
+          candidate_distances.push_back (nn_distances[nii]);
+        }
+        conditions.assign (candidates.size (), 0);
+        batch_condition_function_ (*input_, current_cluster[cii], candidates, candidate_distances, conditions);
+
+        for (std::size_t ci = 0; ci < candidates.size (); ++ci)  // ci = candidates iterator
+        {
+          if (conditions[ci])
+          {
+            // Add the point to the cluster
+            current_cluster.push_back (candidates[ci]);
+            processed[candidates[ci]] = true;
+          }
+        }
+        cii++;
+        continue;
+      }
+
+      // Process the neighbors (the seed point itself is among them, whether the search results are sorted or not)
+      for (int nii = 0; nii < static_cast<int> (nn_indices.size ()); ++nii)  // nii = neighbor indices iterator
       {
         // Has this point been processed before?
         if (nn_indices[nii] == -1 || processed[nn_indices[nii]])
@@ -115,29 +178,33 @@ pcl::ConditionalEuclideanClustering<PointT>::segment (pcl::IndicesClusters &clus
       cii++;
     }
 
-    // If extracting removed clusters, all clusters need to be saved, otherwise only the ones within the given cluster size range
-    if (extract_removed_clusters_ ||
-        (static_cast<int> (current_cluster.size ()) >= min_cluster_size_ &&
-         static_cast<int> (current_cluster.size ()) <= max_cluster_size_))
-    {
-      pcl::PointIndices pi;
-      pi.header = input_->header;
-      pi.indices.resize (current_cluster.size ());
-      for (int ii = 0; ii < static_cast<int> (current_cluster.size ()); ++ii)  // ii = indices iterator
-        pi.indices[ii] = current_cluster[ii];
-
-      if (extract_removed_clusters_ && static_cast<int> (current_cluster.size ()) < min_cluster_size_)
-        small_clusters_->push_back (pi);
-      else if (extract_removed_clusters_ && static_cast<int> (current_cluster.size ()) > max_cluster_size_)
-        large_clusters_->push_back (pi);
-      else
-        clusters.push_back (pi);
-    }
+    addCluster (current_cluster, clusters);
   }
 
   deinitCompute ();
 }
 
+template<typename PointT> void
+pcl::ConditionalEuclideanClustering<PointT>::addCluster (std::vector<int> &cluster, pcl::IndicesClusters &clusters)
+{
+  // If extracting removed clusters, all clusters need to be saved, otherwise only the ones within the given cluster size range
+  if (extract_removed_clusters_ ||
+      (static_cast<int> (cluster.size ()) >= min_cluster_size_ &&
+       static_cast<int> (cluster.size ()) <= max_cluster_size_))
+  {
+    pcl::PointIndices pi;
+    pi.header = input_->header;
+    pi.indices.swap (cluster);
+
+    if (extract_removed_clusters_ && static_cast<int> (pi.indices.size ()) < min_cluster_size_)
+      small_clusters_->push_back (pi);
+    else if (extract_removed_clusters_ && static_cast<int> (pi.indices.size ()) > max_cluster_size_)
+      large_clusters_->push_back (pi);
+    else
+      clusters.push_back (pi);
+  }
+}
+
 #define PCL_INSTANTIATE_ConditionalEuclideanClustering(T) template class PCL_EXPORTS pcl::ConditionalEuclideanClustering<T>;
 
 #endif  // PCL_SEGMENTATION_IMPL_CONDITIONAL_EUCLIDEAN_CLUSTERING_HPP_
@@ -40,6 +40,10 @@
 
 #include <pcl/segmentation/cpc_segmentation.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 template <typename PointT>
 pcl::CPCSegmentation<PointT>::CPCSegmentation () :
     max_cuts_ (20),
@@ -161,6 +165,8 @@ pcl::CPCSegmentation<PointT>::applyCuttingPlane (std::uint32_t depth_levels_left
 
     weight_sac.setWeights (weights, use_directed_weights_);
     weight_sac.setMaxIterations (ransac_itrs_);
+    if (threads_ > 1)
+      weight_sac.setNumberOfThreads (threads_);
 
     // if not enough inliers are found
     if (!weight_sac.computeModel ())
@@ -301,8 +307,83 @@ pcl::CPCSegmentation<PointT>::WeightedRandomSampleConsensus::computeModel (int)
   // suppress infinite loops by just allowing 10 x maximum allowed iterations for invalid model parameters!
   const unsigned max_skip = max_iterations_ * 10;
 
+  if (threads_ >= 0)
+  {
+    int threads = threads_;
+#ifdef _OPENMP
+    if (threads == 0)
+      threads = omp_get_num_procs ();
+#else
+    threads = 1;
+#endif
+    // The hypotheses are drawn in batches, in the same order as in the serial loop below. Only their scoring,
+    // which visits the whole edge cloud, is parallel, and the best one is then picked in order: the result is the same.
+    const std::size_t batch_size = 32 * static_cast<std::size_t> (threads);
+    std::vector<Eigen::VectorXf> batch_coefficients;
+    std::vector<Indices> batch_selections;
+    std::vector<double> batch_scores;
+    bool last_hypothesis_scored = false;
+    bool samples_left = true;
+    while (samples_left && iterations_ < max_iterations_ && skipped_count < max_skip)
+    {
+      batch_coefficients.clear ();
+      batch_selections.clear ();
+      while (iterations_ + static_cast<int> (batch_selections.size ()) < max_iterations_ && skipped_count < max_skip && batch_selections.size () < batch_size)
+      {
+        // Get X samples which satisfy the model criteria and which have a weight > 0
+        sac_model_->setIndices (model_pt_indices_);
+        int sample_iterations = iterations_ + static_cast<int> (batch_selections.size ());
+        sac_model_->getSamples (sample_iterations, selection);
+        last_hypothesis_scored = false;
+
+        if (selection.empty ())
+        {
+          PCL_ERROR ("[pcl::CPCSegmentation<PointT>::WeightedRandomSampleConsensus::computeModel] No samples could be selected!\n");
+          samples_left = false;
+          break;
+        }
+
+        if (!sac_model_->computeModelCoefficients (selection, model_coefficients))
+        {
+          ++skipped_count;
+          continue;
+        }
+        batch_selections.push_back (selection);
+        batch_coefficients.push_back (model_coefficients);
+        last_hypothesis_scored = true;
+      }
+
+      const int nr_hypotheses = static_cast<int> (batch_coefficients.size ());
+      batch_scores.resize (nr_hypotheses);
+#pragma omp parallel for \
+  default(none) \
+  shared(batch_coefficients, batch_scores, nr_hypotheses) \
+  schedule(static) \
+  num_threads(threads)
+      for (int h = 0; h < nr_hypotheses; ++h)
+        batch_scores[h] = scoreModel (batch_coefficients[h]);
+
+      for (int h = 0; h < nr_hypotheses; ++h)
+      {
+        // Better match ?
+        if (batch_scores[h] > best_score_)
+        {
+          best_score_ = batch_scores[h];
+          // Save the current model/inlier/coefficients selection as being the best so far
+          model_ = batch_selections[h];
+          model_coefficients_ = batch_coefficients[h];
+        }
+        ++iterations_;
+        PCL_DEBUG ("[pcl::CPCSegmentation<PointT>::WeightedRandomSampleConsensus::computeModel] Trial %d (max %d): score is %f (best is: %f so far).\n", iterations_, max_iterations_, batch_scores[h], best_score_);
+      }
+    }
+    // The serial loop evaluates its last valid hypothesis on all the points
+    if (last_hypothesis_scored)
+      sac_model_->setIndices (full_cloud_pt_indices_);
+  }
+
   // Iterate
-  while (iterations_ < max_iterations_ && skipped_count < max_skip)
+  while (threads_ < 0 && iterations_ < max_iterations_ && skipped_count < max_skip)
   {
     // Get X samples which satisfy the model criteria and which have a weight > 0
     sac_model_->setIndices (model_pt_indices_);
@@ -371,4 +452,31 @@ pcl::CPCSegmentation<PointT>::WeightedRandomSampleConsensus::computeModel (int)
   return (true);
 }
 
+template <typename PointT> double
+pcl::CPCSegmentation<PointT>::WeightedRandomSampleConsensus::scoreModel (const Eigen::VectorXf &model_coefficients) const
+{
+  // weight distances to get the score (only using connected inliers)
+  double current_score = 0;
+  std::size_t nr_inliers = 0;
+  Eigen::Vector3f plane_normal (model_coefficients[0], model_coefficients[1], model_coefficients[2]);
+  for (const int &current_index : *full_cloud_pt_indices_)
+  {
+    const WeightSACPointType &point = (*point_cloud_ptr_)[current_index];
+    Eigen::Vector4f pt (point.x, point.y, point.z, 1.0f);
+    float distance = std::abs (model_coefficients.dot (pt));
+    if (!(distance < threshold_))
+      continue;
+
+    double index_score = weights_[current_index];
+    if (use_directed_weights_)
+      // the sqrt(2) factor was used in the paper and was meant for making the scores better comparable between directed and undirected weights
+      index_score *= 1.414 * (std::abs (plane_normal.dot (point.getNormalVector3fMap ())));
+
+    current_score += index_score;
+    ++nr_inliers;
+  }
+  // normalize by the total number of inliers
+  return (current_score / nr_inliers);
+}
+
 #endif // PCL_SEGMENTATION_IMPL_CPC_SEGMENTATION_HPP_
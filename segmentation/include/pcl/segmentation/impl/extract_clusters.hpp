@@ -39,6 +39,153 @@
 #define PCL_SEGMENTATION_IMPL_EXTRACT_CLUSTERS_H_
 
 #include <pcl/segmentation/extract_clusters.h>
+#include <pcl/common/point_tests.h> // for pcl::isFinite
+
+#include <atomic>
+#include <cstdint>
+#include <unordered_map>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace pcl
+{
+namespace detail
+{
+/** \brief Find the connected components of the graph linking the points closer than a tolerance, with several
+  * threads. The neighbors of the points are searched in parallel, and the components of the points are merged as
+  * they are found in a concurrent union-find, where the root of a component is always its smallest point index.
+  * \param[in] cloud the point cloud
+  * \param[in] indices the indices of the points to cluster
+  * \param[in] tree the spatial locator built on \a cloud and \a indices
+  * \param[in] tolerance the spatial cluster tolerance as a measure in L2 Euclidean space
+  * \param[in] connected a predicate called with a point index, the indices of its neighbors closer than the tolerance
+  * (without the point itself), their squared distances and a vector of as many flags, all zero, which it sets to non
+  * zero for the neighbors in the same cluster as the point. It is called concurrently
+  * \param[in] nr_threads the number of threads to use
+  * \param[out] components the point indices of every component, sorted and without duplicates, in the order of their
+  * first point in \a indices, which is the order in which the serial cluster extraction finds them
+  */
+template <typename PointT, typename BatchPredicate> void
+extractEuclideanComponentsBatched (const PointCloud<PointT> &cloud,
+                                   const std::vector<int> &indices,
+                                   const typename search::Search<PointT>::Ptr &tree,
+                                   float tolerance,
+                                   const BatchPredicate &connected,
+                                   unsigned int nr_threads,
+                                   std::vector<std::vector<int> > &components)
+{
+  std::vector<std::atomic<int> > parent (cloud.size ());
+  for (std::size_t i = 0; i < parent.size (); ++i)
+    parent[i].store (static_cast<int> (i), std::memory_order_relaxed);
+
+  // The parent of a point is never larger than the point, so replacing it by its grandparent (path halving) keeps a
+  // valid forest even when another thread links the root meanwhile
+  const auto find = [&parent] (int x)
+  {
+    while (true)
+    {
+      int p = parent[x].load ();
+      if (p == x)
+        return (x);
+      const int gp = parent[p].load ();
+      if (gp != p)
+        parent[x].compare_exchange_weak (p, gp);
+      x = gp;
+    }
+  };
+  // Link the larger root below the smaller one, unless another thread linked it first
+  const auto unite = [&parent, &find] (int a, int b)
+  {
+    while (true)
+    {
+      a = find (a);
+      b = find (b);
+      if (a == b)
+        return;
+      if (a < b)
+        std::swap (a, b);
+      int expected = a;
+      if (parent[a].compare_exchange_strong (expected, b))
+        return;
+    }
+  };
+
+  std::vector<int> nn_indices, candidates;
+  std::vector<float> nn_distances, candidate_distances;
+  std::vector<std::uint8_t> flags;
+#pragma omp parallel for \
+  shared(cloud, indices, tree, tolerance, connected, unite) \
+  firstprivate(nn_indices, nn_distances, candidates, candidate_distances, flags) \
+  schedule(dynamic, 256) \
+  num_threads(nr_threads)
+  for (std::ptrdiff_t i = 0; i < static_cast<std::ptrdiff_t> (indices.size ()); ++i)
+  {
+    const int index = indices[i];
+    if (tree->radiusSearch (cloud[index], tolerance, nn_indices, nn_distances) <= 0)
+      continue;
+
+    candidates.clear ();
+    candidate_distances.clear ();
+    for (std::size_t j = 0; j < nn_indices.size (); ++j)
+    {
+      if (nn_indices[j] == -1 || nn_indices[j] == index)
+        continue;
+      candidates.push_back (nn_indices[j]);
+      candidate_distances.push_back (nn_distances[j]);
+    }
+    flags.assign (candidates.size (), 0);
+    connected (index, candidates, candidate_distances, flags);
+    for (std::size_t j = 0; j < candidates.size (); ++j)
+      if (flags[j])
+        unite (index, candidates[j]);
+  }
+
+  // Number the components in the order of their first point
+  components.clear ();
+  std::vector<int> component_of (cloud.size (), -1);
+  for (const int &index : indices)
+  {
+    int &component = component_of[find (index)];
+    if (component == -1)
+    {
+      component = static_cast<int> (components.size ());
+      components.emplace_back ();
+    }
+    components[component].push_back (index);
+  }
+  for (auto &component : components)
+  {
+    std::sort (component.begin (), component.end ());
+    component.erase (std::unique (component.begin (), component.end ()), component.end ());
+  }
+}
+
+/** \brief Find the connected components of the graph linking the points closer than a tolerance, with several
+  * threads, as extractEuclideanComponentsBatched, with a predicate telling whether two points closer than the
+  * tolerance are in the same cluster.
+  */
+template <typename PointT, typename Predicate> void
+extractEuclideanComponents (const PointCloud<PointT> &cloud,
+                            const std::vector<int> &indices,
+                            const typename search::Search<PointT>::Ptr &tree,
+                            float tolerance,
+                            const Predicate &connected,
+                            unsigned int nr_threads,
+                            std::vector<std::vector<int> > &components)
+{
+  extractEuclideanComponentsBatched (cloud, indices, tree, tolerance,
+                                     [&connected] (int index, const std::vector<int> &candidates,
+                                                   const std::vector<float> &, std::vector<std::uint8_t> &flags)
+                                     {
+                                       for (std::size_t j = 0; j < candidates.size (); ++j)
+                                         flags[j] = connected (index, candidates[j]);
+                                     },
+                                     nr_threads, components);
+}
+} // namespace detail
+} // namespace pcl
 
 //////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT> void
@@ -209,6 +356,222 @@ pcl::extractEuclideanClusters (const PointCloud<PointT> &cloud,
   }
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::extractEuclideanClusters (const PointCloud<PointT> &cloud,
+                               const std::vector<int> &indices,
+                               const typename search::Search<PointT>::Ptr &tree,
+                               float tolerance, std::vector<PointIndices> &clusters,
+                               unsigned int min_pts_per_cluster,
+                               unsigned int max_pts_per_cluster,
+                               unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    nr_threads = omp_get_num_procs ();
+#else
+    nr_threads = 1;
+#endif
+  if (nr_threads == 1)
+  {
+    extractEuclideanClusters (cloud, indices, tree, tolerance, clusters, min_pts_per_cluster, max_pts_per_cluster);
+    return;
+  }
+
+  if (tree->getInputCloud()->size() != cloud.size()) {
+    PCL_ERROR("[pcl::extractEuclideanClusters] Tree built for a different point cloud "
+              "dataset (%zu) than the input cloud (%zu)!\n",
+              static_cast<std::size_t>(tree->getInputCloud()->size()),
+              static_cast<std::size_t>(cloud.size()));
+    return;
+  }
+  if (tree->getIndices()->size() != indices.size()) {
+    PCL_ERROR("[pcl::extractEuclideanClusters] Tree built for a different set of "
+              "indices (%zu) than the input set (%zu)!\n",
+              static_cast<std::size_t>(tree->getIndices()->size()),
+              indices.size());
+    return;
+  }
+
+  std::vector<std::vector<int> > components;
+  detail::extractEuclideanComponents (cloud, indices, tree, tolerance, [] (int, int) { return (true); }, nr_threads, components);
+
+  for (auto &component : components)
+  {
+    // If this component is satisfactory, add to the clusters
+    if (component.size () >= min_pts_per_cluster && component.size () <= max_pts_per_cluster)
+    {
+      pcl::PointIndices r;
+      r.indices.swap (component);
+      r.header = cloud.header;
+      clusters.push_back (std::move (r));
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::extractEuclideanClustersOnGrid (const PointCloud<PointT> &cloud,
+                                     const std::vector<int> &indices,
+                                     float tolerance, std::vector<PointIndices> &clusters,
+                                     unsigned int min_pts_per_cluster,
+                                     unsigned int max_pts_per_cluster)
+{
+  if (!(tolerance > 0.0f))
+  {
+    PCL_ERROR ("[pcl::extractEuclideanClustersOnGrid] Invalid tolerance (%g)!\n", tolerance);
+    return;
+  }
+
+  // The diagonal of the voxels is the tolerance, so that all the points of a voxel are in the same cluster
+  const float leaf_size = tolerance / std::sqrt (3.0f);
+  const float inverse_leaf_size = 1.0f / leaf_size;
+  const float sqr_tolerance = tolerance * tolerance;
+
+  // Compute the bounds of the finite points
+  Eigen::Array3f min_p = Eigen::Array3f::Constant (std::numeric_limits<float>::max ());
+  Eigen::Array3f max_p = Eigen::Array3f::Constant (-std::numeric_limits<float>::max ());
+  for (const int &index : indices)
+  {
+    if (!isFinite (cloud[index]))
+      continue;
+    const Eigen::Array3f p = cloud[index].getArray3fMap ();
+    min_p = min_p.min (p);
+    max_p = max_p.max (p);
+  }
+
+  if (!(min_p <= max_p).all ())
+    min_p = max_p = Eigen::Array3f::Zero ();
+
+  // The number of voxels along each axis, with a margin of two voxels on each side for the neighbor offsets
+  const Eigen::Array3d size = ((max_p - min_p) * inverse_leaf_size).template cast<double> ().floor () + 5.0;
+  if (size.prod () > static_cast<double> (std::numeric_limits<std::int64_t>::max () / 2))
+  {
+    PCL_ERROR ("[pcl::extractEuclideanClustersOnGrid] Tolerance is too small for the input dataset, the voxel indices would overflow!\n");
+    return;
+  }
+  const std::int64_t size_x = static_cast<std::int64_t> (size[0]);
+  const std::int64_t size_xy = size_x * static_cast<std::int64_t> (size[1]);
+
+  // Compute the voxel of each finite point, and sort the points by voxel
+  std::vector<std::pair<std::int64_t, int> > point_voxels;
+  point_voxels.reserve (indices.size ());
+  for (const int &index : indices)
+  {
+    if (!isFinite (cloud[index]))
+      continue;
+    const Eigen::Array3i ijk = ((cloud[index].getArray3fMap () - min_p) * inverse_leaf_size).floor ().template cast<int> () + 2;
+    point_voxels.emplace_back (ijk[0] + ijk[1] * size_x + ijk[2] * size_xy, index);
+  }
+  std::sort (point_voxels.begin (), point_voxels.end ());
+  point_voxels.erase (std::unique (point_voxels.begin (), point_voxels.end ()), point_voxels.end ());
+
+  // Gather the points of each voxel contiguously, and index the voxels by their key
+  std::vector<Eigen::Vector3f> points (point_voxels.size ());
+  std::vector<std::size_t> voxel_begin;
+  std::vector<std::int64_t> voxel_keys;
+  std::vector<int> voxel_of_point (cloud.size (), -1);
+  for (std::size_t i = 0; i < point_voxels.size (); ++i)
+  {
+    if (i == 0 || point_voxels[i].first != point_voxels[i - 1].first)
+    {
+      voxel_begin.push_back (i);
+      voxel_keys.push_back (point_voxels[i].first);
+    }
+    points[i] = cloud[point_voxels[i].second].getVector3fMap ();
+    voxel_of_point[point_voxels[i].second] = static_cast<int> (voxel_keys.size ()) - 1;
+  }
+  const int nr_voxels = static_cast<int> (voxel_keys.size ());
+  voxel_begin.push_back (point_voxels.size ());
+
+  std::unordered_map<std::int64_t, int> voxel_index;
+  voxel_index.reserve (nr_voxels);
+  for (int v = 0; v < nr_voxels; ++v)
+    voxel_index.emplace (voxel_keys[v], v);
+
+  // Union-find on the voxels, the root of a component is its smallest voxel
+  std::vector<int> parent (nr_voxels);
+  for (int v = 0; v < nr_voxels; ++v)
+    parent[v] = v;
+  const auto find = [&parent] (int v)
+  {
+    while (parent[v] != v)
+      v = parent[v] = parent[parent[v]];
+    return (v);
+  };
+
+  // Points closer than the tolerance are at most two voxels apart along each axis. Every pair of voxels is visited
+  // once, from the one with the smaller key, and its points are compared only if the voxels are not already merged
+  for (int v = 0; v < nr_voxels; ++v)
+  {
+    for (int dz = -2; dz <= 2; ++dz)
+      for (int dy = -2; dy <= 2; ++dy)
+        for (int dx = -2; dx <= 2; ++dx)
+        {
+          const std::int64_t key = voxel_keys[v] + dx + dy * size_x + dz * size_xy;
+          if (key <= voxel_keys[v])
+            continue;
+          const auto it = voxel_index.find (key);
+          if (it == voxel_index.end ())
+            continue;
+
+          int root_v = find (v), root_w = find (it->second);
+          if (root_v == root_w)
+            continue;
+
+          bool connected = false;
+          for (std::size_t i = voxel_begin[v]; i < voxel_begin[v + 1] && !connected; ++i)
+            for (std::size_t j = voxel_begin[it->second]; j < voxel_begin[it->second + 1] && !connected; ++j)
+              connected = (points[i] - points[j]).squaredNorm () <= sqr_tolerance;
+          if (connected)
+          {
+            if (root_v < root_w)
+              parent[root_w] = root_v;
+            else
+              parent[root_v] = root_w;
+          }
+        }
+  }
+
+  // Number the components in the order of their first point, as the radius search based extraction does, the
+  // points which are not finite are isolated
+  std::vector<int> component_of_root (nr_voxels, -1);
+  std::vector<std::vector<int> > components;
+  std::vector<bool> processed (cloud.size (), false);
+  for (const int &index : indices)
+  {
+    if (processed[index])
+      continue;
+    processed[index] = true;
+
+    if (voxel_of_point[index] == -1)
+    {
+      components.emplace_back (1, index);
+      continue;
+    }
+    int &component = component_of_root[find (voxel_of_point[index])];
+    if (component == -1)
+    {
+      component = static_cast<int> (components.size ());
+      components.emplace_back ();
+    }
+    components[component].push_back (index);
+  }
+
+  for (auto &component : components)
+  {
+    // If this component is satisfactory, add to the clusters
+    if (component.size () >= min_pts_per_cluster && component.size () <= max_pts_per_cluster)
+    {
+      pcl::PointIndices r;
+      r.indices.swap (component);
+      std::sort (r.indices.begin (), r.indices.end ());
+      r.header = cloud.header;
+      clusters.push_back (std::move (r));
+    }
+  }
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////////////////////
@@ -224,6 +587,17 @@ pcl::EuclideanClusterExtraction<PointT>::extract (std::vector<PointIndices> &clu
     return;
   }
 
+  if (use_grid_)
+  {
+    extractEuclideanClustersOnGrid (*input_, *indices_, static_cast<float> (cluster_tolerance_), clusters, min_pts_per_cluster_, max_pts_per_cluster_);
+
+    // Sort the clusters based on their size (largest one first)
+    std::sort (clusters.rbegin (), clusters.rend (), comparePointClusters);
+
+    deinitCompute ();
+    return;
+  }
+
   // Initialize the spatial locator
   if (!tree_)
   {
@@ -235,7 +609,7 @@ pcl::EuclideanClusterExtraction<PointT>::extract (std::vector<PointIndices> &clu
 
   // Send the input dataset to the spatial locator
   tree_->setInputCloud (input_, indices_);
-  extractEuclideanClusters (*input_, *indices_, tree_, static_cast<float> (cluster_tolerance_), clusters, min_pts_per_cluster_, max_pts_per_cluster_);
+  extractEuclideanClusters (*input_, *indices_, tree_, static_cast<float> (cluster_tolerance_), clusters, min_pts_per_cluster_, max_pts_per_cluster_, threads_);
 
   //tree_->setInputCloud (input_);
   //extractEuclideanClusters (*input_, tree_, cluster_tolerance_, clusters, min_pts_per_cluster_, max_pts_per_cluster_);
@@ -248,6 +622,8 @@ pcl::EuclideanClusterExtraction<PointT>::extract (std::vector<PointIndices> &clu
 
 #define PCL_INSTANTIATE_EuclideanClusterExtraction(T) template class PCL_EXPORTS pcl::EuclideanClusterExtraction<T>;
 #define PCL_INSTANTIATE_extractEuclideanClusters(T) template void PCL_EXPORTS pcl::extractEuclideanClusters<T>(const pcl::PointCloud<T> &, const typename pcl::search::Search<T>::Ptr &, float , std::vector<pcl::PointIndices> &, unsigned int, unsigned int);
-#define PCL_INSTANTIATE_extractEuclideanClusters_indices(T) template void PCL_EXPORTS pcl::extractEuclideanClusters<T>(const pcl::PointCloud<T> &, const std::vector<int> &, const typename pcl::search::Search<T>::Ptr &, float , std::vector<pcl::PointIndices> &, unsigned int, unsigned int);
+#define PCL_INSTANTIATE_extractEuclideanClusters_indices(T) template void PCL_EXPORTS pcl::extractEuclideanClusters<T>(const pcl::PointCloud<T> &, const std::vector<int> &, const typename pcl::search::Search<T>::Ptr &, float , std::vector<pcl::PointIndices> &, unsigned int, unsigned int); \
+  template void PCL_EXPORTS pcl::extractEuclideanClusters<T>(const pcl::PointCloud<T> &, const std::vector<int> &, const typename pcl::search::Search<T>::Ptr &, float , std::vector<pcl::PointIndices> &, unsigned int, unsigned int, unsigned int); \
+  template void PCL_EXPORTS pcl::extractEuclideanClustersOnGrid<T>(const pcl::PointCloud<T> &, const std::vector<int> &, float , std::vector<pcl::PointIndices> &, unsigned int, unsigned int);
 
 #endif        // PCL_EXTRACT_CLUSTERS_IMPL_H_
@@ -38,6 +38,7 @@
 #define PCL_SEGMENTATION_IMPL_EXTRACT_LABELED_CLUSTERS_H_
 
 #include <pcl/segmentation/extract_labeled_clusters.h>
+#include <pcl/segmentation/impl/extract_clusters.hpp> // for detail::extractEuclideanComponents
 
 //////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT> void
@@ -57,6 +58,8 @@ pcl::extractLabeledEuclideanClusters (const PointCloud<PointT> &cloud,
               static_cast<std::size_t>(cloud.size()));
     return;
   }
+  // Check if the tree is sorted -- if it is we don't need to check the first element
+  int nn_start_idx = tree->getSortedResults () ? 1 : 0;
   // Create a bool vector of processed point indices, and initialize it to false
   std::vector<bool> processed (cloud.size (), false);
 
@@ -87,7 +90,7 @@ pcl::extractLabeledEuclideanClusters (const PointCloud<PointT> &cloud,
         continue;
       }
 
-      for (std::size_t j = 1; j < nn_indices.size (); ++j)             // nn_indices[0] should be sq_idx
+      for (std::size_t j = nn_start_idx; j < nn_indices.size (); ++j)             // can't assume sorted (default isn't!)
       {
         if (processed[nn_indices[j]])                             // Has this point been processed before ?
           continue;
@@ -118,6 +121,61 @@ pcl::extractLabeledEuclideanClusters (const PointCloud<PointT> &cloud,
     }
   }
 }
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::extractLabeledEuclideanClusters (const PointCloud<PointT> &cloud,
+                                      const typename search::Search<PointT>::Ptr &tree,
+                                      float tolerance,
+                                      std::vector<std::vector<PointIndices> > &labeled_clusters,
+                                      unsigned int min_pts_per_cluster,
+                                      unsigned int max_pts_per_cluster,
+                                      unsigned int max_label,
+                                      unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    nr_threads = omp_get_num_procs ();
+#else
+    nr_threads = 1;
+#endif
+  if (nr_threads == 1)
+  {
+    extractLabeledEuclideanClusters (cloud, tree, tolerance, labeled_clusters, min_pts_per_cluster, max_pts_per_cluster, max_label);
+    return;
+  }
+
+  if (tree->getInputCloud ()->size () != cloud.size ())
+  {
+    PCL_ERROR("[pcl::extractLabeledEuclideanClusters] Tree built for a different point "
+              "cloud dataset (%zu) than the input cloud (%zu)!\n",
+              static_cast<std::size_t>(tree->getInputCloud()->size()),
+              static_cast<std::size_t>(cloud.size()));
+    return;
+  }
+
+  // The neighbors are in the same cluster if they have the same label
+  std::vector<int> indices (cloud.size ());
+  for (std::size_t i = 0; i < indices.size (); ++i)
+    indices[i] = static_cast<int> (i);
+  std::vector<std::vector<int> > components;
+  detail::extractEuclideanComponents (cloud, indices, tree, tolerance,
+                                      [&cloud] (int a, int b) { return (cloud[a].label == cloud[b].label); },
+                                      nr_threads, components);
+
+  for (auto &component : components)
+  {
+    // If this component is satisfactory, add to the clusters
+    if (component.size () >= min_pts_per_cluster && component.size () <= max_pts_per_cluster)
+    {
+      pcl::PointIndices r;
+      r.indices.swap (component);
+      r.header = cloud.header;
+      labeled_clusters[cloud[r.indices.front ()].label].push_back (std::move (r));
+    }
+  }
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////////////////////
@@ -144,7 +202,7 @@ pcl::LabeledEuclideanClusterExtraction<PointT>::extract (std::vector<std::vector
 
   // Send the input dataset to the spatial locator
   tree_->setInputCloud (input_);
-  extractLabeledEuclideanClusters (*input_, tree_, static_cast<float> (cluster_tolerance_), labeled_clusters, min_pts_per_cluster_, max_pts_per_cluster_, max_label_);
+  extractLabeledEuclideanClusters (*input_, tree_, static_cast<float> (cluster_tolerance_), labeled_clusters, min_pts_per_cluster_, max_pts_per_cluster_, max_label_, threads_);
 
   // Sort the clusters based on their size (largest one first)
   for (auto &labeled_cluster : labeled_clusters)
@@ -154,6 +212,7 @@ pcl::LabeledEuclideanClusterExtraction<PointT>::extract (std::vector<std::vector
 }
 
 #define PCL_INSTANTIATE_LabeledEuclideanClusterExtraction(T) template class PCL_EXPORTS pcl::LabeledEuclideanClusterExtraction<T>;
-#define PCL_INSTANTIATE_extractLabeledEuclideanClusters(T) template void PCL_EXPORTS pcl::extractLabeledEuclideanClusters<T>(const pcl::PointCloud<T> &, const typename pcl::search::Search<T>::Ptr &, float , std::vector<std::vector<pcl::PointIndices> > &, unsigned int, unsigned int, unsigned int);
+#define PCL_INSTANTIATE_extractLabeledEuclideanClusters(T) template void PCL_EXPORTS pcl::extractLabeledEuclideanClusters<T>(const pcl::PointCloud<T> &, const typename pcl::search::Search<T>::Ptr &, float , std::vector<std::vector<pcl::PointIndices> > &, unsigned int, unsigned int, unsigned int); \
+  template void PCL_EXPORTS pcl::extractLabeledEuclideanClusters<T>(const pcl::PointCloud<T> &, const typename pcl::search::Search<T>::Ptr &, float , std::vector<std::vector<pcl::PointIndices> > &, unsigned int, unsigned int, unsigned int, unsigned int);
 
 #endif        // PCL_EXTRACT_CLUSTERS_IMPL_H_
@@ -41,6 +41,12 @@
 #include <pcl/segmentation/lccp_segmentation.h>
 #include <pcl/common/common.h>
 
+#include <algorithm> // for std::sort
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 
 //////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////
@@ -61,7 +67,8 @@ pcl::LCCPSegmentation<PointT>::LCCPSegmentation () :
   seed_resolution_ (0),
   voxel_resolution_ (0),
   k_factor_ (0),
-  min_segment_size_ (0)
+  min_segment_size_ (0),
+  threads_ (1)
 {
 }
 
@@ -74,6 +81,10 @@ template <typename PointT> void
 pcl::LCCPSegmentation<PointT>::reset ()
 {
   sv_adjacency_list_.clear ();
+  sv_vertices_.clear ();
+  sv_neighbor_offsets_.clear ();
+  sv_neighbors_.clear ();
+  sv_neighbor_edges_.clear ();
   processed_.clear ();
   sv_label_to_supervoxel_map_.clear ();
   sv_label_to_seg_label_map_.clear ();
@@ -108,6 +119,19 @@ pcl::LCCPSegmentation<PointT>::segment ()
 }
 
 
+template <typename PointT> void
+pcl::LCCPSegmentation<PointT>::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs ();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
+
 template <typename PointT> void
 pcl::LCCPSegmentation<PointT>::relabelCloud (pcl::PointCloud<pcl::PointXYZL> &labeled_cloud_arg)
 {
@@ -285,6 +309,44 @@ pcl::LCCPSegmentation<PointT>::prepareSegmentation (const std::map<std::uint32_t
     processed_[sv_label] = false;
     sv_label_to_seg_label_map_[sv_label] = 0;
   }
+
+  computeFlatAdjacency ();
+}
+
+template <typename PointT> void
+pcl::LCCPSegmentation<PointT>::computeFlatAdjacency ()
+{
+  sv_vertices_.clear ();
+  sv_vertices_.reserve (boost::num_vertices (sv_adjacency_list_));
+  std::map<VertexID, std::size_t> vertex_positions;
+  VertexIterator sv_itr, sv_itr_end;
+  for (std::tie (sv_itr, sv_itr_end) = boost::vertices (sv_adjacency_list_); sv_itr != sv_itr_end; ++sv_itr)
+  {
+    vertex_positions[*sv_itr] = sv_vertices_.size ();
+    sv_vertices_.push_back (*sv_itr);
+  }
+
+  sv_neighbor_offsets_.assign (1, 0);
+  sv_neighbor_offsets_.reserve (sv_vertices_.size () + 1);
+  sv_neighbors_.clear ();
+  sv_neighbor_edges_.clear ();
+  std::vector<std::pair<std::size_t, EdgeID> > neighbors;
+  for (const VertexID &vertex : sv_vertices_)
+  {
+    // Sorted neighbors let applyKconvexity find the common neighbors of two vertices with a single merge
+    neighbors.clear ();
+    OutEdgeIterator out_edge_itr, out_edge_itr_end;
+    for (std::tie (out_edge_itr, out_edge_itr_end) = boost::out_edges (vertex, sv_adjacency_list_); out_edge_itr != out_edge_itr_end; ++out_edge_itr)
+      neighbors.emplace_back (vertex_positions[boost::target (*out_edge_itr, sv_adjacency_list_)], *out_edge_itr);
+    std::sort (neighbors.begin (), neighbors.end (),
+               [] (const std::pair<std::size_t, EdgeID> &a, const std::pair<std::size_t, EdgeID> &b) { return (a.first < b.first); });
+    for (const auto &neighbor : neighbors)
+    {
+      sv_neighbors_.push_back (neighbor.first);
+      sv_neighbor_edges_.push_back (neighbor.second);
+    }
+    sv_neighbor_offsets_.push_back (sv_neighbors_.size ());
+  }
 }
 
 
@@ -303,21 +365,44 @@ pcl::LCCPSegmentation<PointT>::doGrouping ()
     sv_label_to_seg_label_map_[sv_label] = 0;
   }
   
-  VertexIterator sv_itr, sv_itr_end;
-  // Perform depth search on the graph and recursively group all supervoxels with convex connections
-  //The vertices in the supervoxel adjacency list are the supervoxel centroids
-  // Note: *sv_itr is of type " boost::graph_traits<VoxelAdjacencyList>::vertex_descriptor " which it nothing but a typedef of std::size_t..
+  // Perform depth search on the graph and group all supervoxels with convex connections
+  // The segments are labelled in the order of their first vertex, the same labels as the recursive segment growing gives, but
+  // the flat adjacency and an explicit stack avoid both the graph traversal and the recursion depth on large segments
+  const std::size_t nr_vertices = sv_vertices_.size ();
+  std::vector<unsigned int> vertex_segment_labels (nr_vertices, 0);
+  std::vector<std::size_t> stack;
   unsigned int segment_label = 1;  // This starts at 1, because 0 is reserved for errors
-  for (std::tie(sv_itr, sv_itr_end) = boost::vertices (sv_adjacency_list_); sv_itr != sv_itr_end; ++sv_itr)  // For all supervoxels
+  for (std::size_t seed = 0; seed < nr_vertices; ++seed)  // For all supervoxels
   {
-    const VertexID sv_vertex_id = *sv_itr;
-    const std::uint32_t& sv_label = sv_adjacency_list_[sv_vertex_id];
-    if (!processed_[sv_label])
+    if (vertex_segment_labels[seed] != 0)
+      continue;
+
+    // Add neighbors (and their neighbors etc.) to group if similarity constraint is met
+    vertex_segment_labels[seed] = segment_label;
+    stack.push_back (seed);
+    while (!stack.empty ())
     {
-      // Add neighbors (and their neighbors etc.) to group if similarity constraint is met
-      recursiveSegmentGrowing (sv_vertex_id, segment_label);
-      ++segment_label;  // After recursive grouping ended (no more neighbors to consider) -> go to next group
+      const std::size_t current = stack.back ();
+      stack.pop_back ();
+      for (std::size_t n = sv_neighbor_offsets_[current]; n < sv_neighbor_offsets_[current + 1]; ++n)
+      {
+        const std::size_t neighbor = sv_neighbors_[n];
+        if (vertex_segment_labels[neighbor] == 0 && sv_adjacency_list_[sv_neighbor_edges_[n]].is_valid)
+        {
+          vertex_segment_labels[neighbor] = segment_label;
+          stack.push_back (neighbor);
+        }
+      }
     }
+    ++segment_label;  // After grouping ended (no more neighbors to consider) -> go to next group
+  }
+
+  for (std::size_t i = 0; i < nr_vertices; ++i)
+  {
+    const std::uint32_t& sv_label = sv_adjacency_list_[sv_vertices_[i]];
+    processed_[sv_label] = true;
+    sv_label_to_seg_label_map_[sv_label] = vertex_segment_labels[i];
+    seg_label_to_sv_list_map_[vertex_segment_labels[i]].insert (sv_label);
   }
 }
 
@@ -357,53 +442,50 @@ pcl::LCCPSegmentation<PointT>::applyKconvexity (const unsigned int k_arg)
   if (k_arg == 0)
     return;
 
-  EdgeIterator edge_itr, edge_itr_end, next_edge;
-  // Check all edges in the graph for k-convexity
-  for (std::tie (edge_itr, edge_itr_end) = boost::edges (sv_adjacency_list_), next_edge = edge_itr; edge_itr != edge_itr_end; edge_itr = next_edge)
+  // Check all edges in the graph for k-convexity, every edge once from its vertex with the lower position
+  // Only is_valid of the checked edge is written, the convexity of the others is only read
+  const int nr_vertices = static_cast<int> (sv_vertices_.size ());
+#pragma omp parallel for \
+  default(none) \
+  shared(k_arg, nr_vertices) \
+  schedule(dynamic, 64) \
+  num_threads(threads_)
+  for (int source = 0; source < nr_vertices; ++source)
   {
-    ++next_edge;  // next_edge iterator is necessary, because removing an edge invalidates the iterator to the current edge
-
-    bool is_convex = sv_adjacency_list_[*edge_itr].is_convex;
-
-    if (is_convex)  // If edge is (0-)convex
+    const std::size_t source_begin = sv_neighbor_offsets_[source];
+    const std::size_t source_end = sv_neighbor_offsets_[source + 1];
+    for (std::size_t e = source_begin; e < source_end; ++e)
     {
-      unsigned int kcount = 0;
+      const std::size_t target = sv_neighbors_[e];
+      if (target <= static_cast<std::size_t> (source))
+        continue;
 
-      const VertexID source = boost::source (*edge_itr, sv_adjacency_list_);
-      const VertexID target = boost::target (*edge_itr, sv_adjacency_list_);
+      EdgeProperties& edge_properties = sv_adjacency_list_[sv_neighbor_edges_[e]];
+      if (!edge_properties.is_convex)  // If edge is not (0-)convex
+        continue;
 
-      OutEdgeIterator source_neighbors_itr, source_neighbors_itr_end;
       // Find common neighbors, check their connection
-      for (std::tie(source_neighbors_itr, source_neighbors_itr_end) = boost::out_edges (source, sv_adjacency_list_); source_neighbors_itr != source_neighbors_itr_end; ++source_neighbors_itr)  // For all supervoxels
+      unsigned int kcount = 0;
+      std::size_t s = source_begin, t = sv_neighbor_offsets_[target];
+      const std::size_t target_end = sv_neighbor_offsets_[target + 1];
+      while (s < source_end && t < target_end && kcount < k_arg)
       {
-        VertexID source_neighbor_ID = boost::target (*source_neighbors_itr, sv_adjacency_list_);
-
-        OutEdgeIterator target_neighbors_itr, target_neighbors_itr_end;
-        for (std::tie(target_neighbors_itr, target_neighbors_itr_end) = boost::out_edges (target, sv_adjacency_list_); target_neighbors_itr != target_neighbors_itr_end; ++target_neighbors_itr)  // For all supervoxels
+        if (sv_neighbors_[s] < sv_neighbors_[t])
+          ++s;
+        else if (sv_neighbors_[t] < sv_neighbors_[s])
+          ++t;
+        else  // Common neighbor
         {
-          VertexID target_neighbor_ID = boost::target (*target_neighbors_itr, sv_adjacency_list_);
-          if (source_neighbor_ID == target_neighbor_ID)  // Common neighbor
-          {
-            EdgeID src_edge = boost::edge (source, source_neighbor_ID, sv_adjacency_list_).first;
-            EdgeID tar_edge = boost::edge (target, source_neighbor_ID, sv_adjacency_list_).first;
-
-            bool src_is_convex = (sv_adjacency_list_)[src_edge].is_convex;
-            bool tar_is_convex = (sv_adjacency_list_)[tar_edge].is_convex;
-
-            if (src_is_convex && tar_is_convex)
-              ++kcount;
-
-            break;
-          }
+          if (sv_adjacency_list_[sv_neighbor_edges_[s]].is_convex && sv_adjacency_list_[sv_neighbor_edges_[t]].is_convex)
+            ++kcount;
+          ++s;
+          ++t;
         }
-
-        if (kcount >= k_arg)  // Connection is k-convex, stop search
-          break;
       }
 
       // Check k convexity
       if (kcount < k_arg)
-        (sv_adjacency_list_)[*edge_itr].is_valid = false;
+        edge_properties.is_valid = false;
     }
   }
 }
@@ -412,19 +494,29 @@ template <typename PointT> void
 pcl::LCCPSegmentation<PointT>::calculateConvexConnections (SupervoxelAdjacencyList& adjacency_list_arg)
 {
 
-  EdgeIterator edge_itr, edge_itr_end, next_edge;
-  for (std::tie(edge_itr, edge_itr_end) = boost::edges (adjacency_list_arg), next_edge = edge_itr; edge_itr != edge_itr_end; edge_itr = next_edge)
+  std::vector<EdgeID> edges;
+  edges.reserve (boost::num_edges (adjacency_list_arg));
+  EdgeIterator edge_itr, edge_itr_end;
+  for (std::tie(edge_itr, edge_itr_end) = boost::edges (adjacency_list_arg); edge_itr != edge_itr_end; ++edge_itr)
+    edges.push_back (*edge_itr);
+
+  // The connections are independent, each one only writes the properties of its own edge
+  const int nr_edges = static_cast<int> (edges.size ());
+#pragma omp parallel for \
+  default(none) \
+  shared(adjacency_list_arg, edges, nr_edges) \
+  schedule(dynamic, 256) \
+  num_threads(threads_)
+  for (int i = 0; i < nr_edges; ++i)
   {
-    ++next_edge;  // next_edge iterator is necessary, because removing an edge invalidates the iterator to the current edge
-
-    std::uint32_t source_sv_label = adjacency_list_arg[boost::source (*edge_itr, adjacency_list_arg)];
-    std::uint32_t target_sv_label = adjacency_list_arg[boost::target (*edge_itr, adjacency_list_arg)];
+    std::uint32_t source_sv_label = adjacency_list_arg[boost::source (edges[i], adjacency_list_arg)];
+    std::uint32_t target_sv_label = adjacency_list_arg[boost::target (edges[i], adjacency_list_arg)];
 
     float normal_difference;
     bool is_convex = connIsConvex (source_sv_label, target_sv_label, normal_difference);
-    adjacency_list_arg[*edge_itr].is_convex = is_convex;
-    adjacency_list_arg[*edge_itr].is_valid = is_convex;
-    adjacency_list_arg[*edge_itr].normal_difference = normal_difference;
+    adjacency_list_arg[edges[i]].is_convex = is_convex;
+    adjacency_list_arg[edges[i]].is_valid = is_convex;
+    adjacency_list_arg[edges[i]].normal_difference = normal_difference;
   }
 }
 
@@ -433,8 +525,9 @@ pcl::LCCPSegmentation<PointT>::connIsConvex (const std::uint32_t source_label_ar
                                              const std::uint32_t target_label_arg,
                                              float &normal_angle)
 {
-  typename pcl::Supervoxel<PointT>::Ptr& sv_source = sv_label_to_supervoxel_map_[source_label_arg];
-  typename pcl::Supervoxel<PointT>::Ptr& sv_target = sv_label_to_supervoxel_map_[target_label_arg];
+  // at () never inserts, the connections are classified in parallel
+  typename pcl::Supervoxel<PointT>::Ptr& sv_source = sv_label_to_supervoxel_map_.at (source_label_arg);
+  typename pcl::Supervoxel<PointT>::Ptr& sv_target = sv_label_to_supervoxel_map_.at (target_label_arg);
 
   const Eigen::Vector3f& source_centroid = sv_source->centroid_.getVector3fMap ();
   const Eigen::Vector3f& target_centroid = sv_target->centroid_.getVector3fMap ();
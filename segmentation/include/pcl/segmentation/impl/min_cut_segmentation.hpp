@@ -43,6 +43,7 @@
 #include <pcl/segmentation/min_cut_segmentation.h>
 #include <pcl/search/search.h>
 #include <pcl/search/kdtree.h>
+#include <algorithm>
 #include <cstdlib>
 #include <cmath>
 
@@ -65,7 +66,8 @@ pcl::MinCutSegmentation<PointT>::MinCutSegmentation () :
   edge_marker_ (0),
   source_ (),/////////////////////////////////
   sink_ (),///////////////////////////////////
-  max_flow_ (0.0)
+  max_flow_ (0.0),
+  use_incremental_max_flow_ (false)
 {
 }
 
@@ -78,6 +80,7 @@ pcl::MinCutSegmentation<PointT>::~MinCutSegmentation ()
   clusters_.clear ();
   vertices_.clear ();
   edge_marker_.clear ();
+  incremental_edges_.clear ();
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -214,6 +217,24 @@ pcl::MinCutSegmentation<PointT>::setBackgroundPoints (typename pcl::PointCloud<P
   unary_potentials_are_valid_ = false;
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::MinCutSegmentation<PointT>::setUseIncrementalMaxFlow (bool use_incremental_max_flow)
+{
+  if (use_incremental_max_flow_ != use_incremental_max_flow)
+  {
+    use_incremental_max_flow_ = use_incremental_max_flow;
+    graph_is_valid_ = false;
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> bool
+pcl::MinCutSegmentation<PointT>::getUseIncrementalMaxFlow () const
+{
+  return (use_incremental_max_flow_);
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT> void
 pcl::MinCutSegmentation<PointT>::extract (std::vector <pcl::PointIndices>& clusters)
@@ -237,6 +258,40 @@ pcl::MinCutSegmentation<PointT>::extract (std::vector <pcl::PointIndices>& clust
 
   clusters_.clear ();
 
+  if (use_incremental_max_flow_)
+  {
+    if (!graph_is_valid_ || !binary_potentials_are_valid_)
+    {
+      bool success = buildIncrementalGraph (!graph_is_valid_);
+      if (!success)
+      {
+        deinitCompute ();
+        return;
+      }
+      graph_is_valid_ = true;
+      binary_potentials_are_valid_ = true;
+    }
+    else if (!unary_potentials_are_valid_)
+      recalculateIncrementalUnaryPotentials ();
+    unary_potentials_are_valid_ = true;
+
+    max_flow_ = incremental_max_flow_.solve ();
+
+    clusters_.resize (2);
+    for (std::size_t i_point = 0; i_point < indices_->size (); i_point++)
+    {
+      if (incremental_max_flow_.inSourceSet (static_cast<int> (i_point)))
+        clusters_[1].indices.push_back ((*indices_)[i_point]);
+      else
+        clusters_[0].indices.push_back ((*indices_)[i_point]);
+    }
+
+    clusters.reserve (clusters_.size ());
+    std::copy (clusters_.begin (), clusters_.end (), std::back_inserter (clusters));
+    deinitCompute ();
+    return;
+  }
+
   if ( !graph_is_valid_ )
   {
     bool success = buildGraph ();
@@ -561,6 +616,74 @@ pcl::MinCutSegmentation<PointT>::assembleLabels (ResidualCapacityMap& residual_c
   }
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> bool
+pcl::MinCutSegmentation<PointT>::buildIncrementalGraph (bool search_neighbours)
+{
+  const auto number_of_indices = indices_->size ();
+
+  if (input_->points.empty () || number_of_indices == 0 || foreground_points_.empty () == true )
+    return (false);
+
+  if (search_neighbours)
+  {
+    if (!search_)
+      search_.reset (new pcl::search::KdTree<PointT>);
+
+    std::vector<int> node_of_point (input_->size (), -1);
+    for (std::size_t i_point = 0; i_point < number_of_indices; i_point++)
+      node_of_point[(*indices_)[i_point]] = static_cast<int> (i_point);
+
+    // Every pair of neighbours is connected once, whichever of the two points found the other
+    incremental_edges_.clear ();
+    incremental_edges_.reserve (number_of_indices * number_of_neighbours_);
+    std::vector<int> neighbours;
+    std::vector<float> distances;
+    search_->setInputCloud (input_, indices_);
+    for (std::size_t i_point = 0; i_point < number_of_indices; i_point++)
+    {
+      search_->nearestKSearch (i_point, number_of_neighbours_, neighbours, distances);
+      for (std::size_t i_nghbr = 1; i_nghbr < neighbours.size (); i_nghbr++)
+      {
+        const int node = node_of_point[neighbours[i_nghbr]];
+        if (node != static_cast<int> (i_point))
+          incremental_edges_.emplace_back (std::min (node, static_cast<int> (i_point)), std::max (node, static_cast<int> (i_point)));
+      }
+    }
+    std::sort (incremental_edges_.begin (), incremental_edges_.end ());
+    incremental_edges_.erase (std::unique (incremental_edges_.begin (), incremental_edges_.end ()), incremental_edges_.end ());
+  }
+
+  incremental_max_flow_.reset (static_cast<int> (number_of_indices));
+  for (const auto &edge : incremental_edges_)
+  {
+    double weight = calculateBinaryPotential ((*indices_)[edge.first], (*indices_)[edge.second]);
+    incremental_max_flow_.addEdge (edge.first, edge.second, weight, weight);
+  }
+  for (std::size_t i_point = 0; i_point < number_of_indices; i_point++)
+  {
+    double source_weight = 0.0;
+    double sink_weight = 0.0;
+    calculateUnaryPotential ((*indices_)[i_point], source_weight, sink_weight);
+    incremental_max_flow_.setTerminalWeights (static_cast<int> (i_point), source_weight, sink_weight);
+  }
+
+  return (true);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::MinCutSegmentation<PointT>::recalculateIncrementalUnaryPotentials ()
+{
+  for (std::size_t i_point = 0; i_point < indices_->size (); i_point++)
+  {
+    double source_weight = 0.0;
+    double sink_weight = 0.0;
+    calculateUnaryPotential ((*indices_)[i_point], source_weight, sink_weight);
+    incremental_max_flow_.setTerminalWeights (static_cast<int> (i_point), source_weight, sink_weight);
+  }
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT> pcl::PointCloud<pcl::PointXYZRGB>::Ptr
 pcl::MinCutSegmentation<PointT>::getColoredCloud ()
@@ -42,6 +42,10 @@
 
 #include <pcl/segmentation/organized_connected_component_segmentation.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 /**
  *  Directions: 1 2 3
  *              0 x 4
@@ -113,9 +117,45 @@ pcl::OrganizedConnectedComponentSegmentation<PointT, PointLT>::findLabeledRegion
   } while ( curr_idx != start_idx);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointT, typename PointLT> void
+pcl::OrganizedConnectedComponentSegmentation<PointT, PointLT>::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs ();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template<typename PointT, typename PointLT> void
 pcl::OrganizedConnectedComponentSegmentation<PointT, PointLT>::segment (pcl::PointCloud<PointLT>& labels, std::vector<pcl::PointIndices>& label_indices) const
+{
+  const auto compare = [this] (int idx1, int idx2) { return (compare_->compare (idx1, idx2)); };
+  if (threads_ > 1 && input_->height > 1)
+    segmentParallel (compare, labels, label_indices);
+  else
+    segmentSerial (compare, labels, label_indices);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointT, typename PointLT> template <typename ComparatorT> void
+pcl::OrganizedConnectedComponentSegmentation<PointT, PointLT>::segment (const ComparatorT& compare, pcl::PointCloud<PointLT>& labels, std::vector<pcl::PointIndices>& label_indices) const
+{
+  const auto compare_static = [&compare] (int idx1, int idx2) { return (compare.ComparatorT::compare (idx1, idx2)); };
+  if (threads_ > 1 && input_->height > 1)
+    segmentParallel (compare_static, labels, label_indices);
+  else
+    segmentSerial (compare_static, labels, label_indices);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointT, typename PointLT> template <typename CompareFunctor> void
+pcl::OrganizedConnectedComponentSegmentation<PointT, PointLT>::segmentSerial (const CompareFunctor& compare, pcl::PointCloud<PointLT>& labels, std::vector<pcl::PointIndices>& label_indices) const
 {
   std::vector<unsigned> run_ids;
 
@@ -139,7 +179,7 @@ pcl::OrganizedConnectedComponentSegmentation<PointT, PointLT>::segment (pcl::Poi
   {
     if (!std::isfinite ((*input_)[colIdx].x))
       continue;
-    if (compare_->compare (colIdx, colIdx - 1 ))
+    if (compare (colIdx, colIdx - 1 ))
     {
       labels[colIdx].label = labels[colIdx - 1].label;
     }
@@ -158,7 +198,7 @@ pcl::OrganizedConnectedComponentSegmentation<PointT, PointLT>::segment (pcl::Poi
     // First pixel
     if (std::isfinite ((*input_)[current_row].x))
     {
-      if (compare_->compare (current_row, previous_row))
+      if (compare (current_row, previous_row))
       {
         labels[current_row].label = labels[previous_row].label;
       }
@@ -174,11 +214,11 @@ pcl::OrganizedConnectedComponentSegmentation<PointT, PointLT>::segment (pcl::Poi
     {
       if (std::isfinite ((*input_)[current_row + colIdx].x))
       {
-        if (compare_->compare (current_row + colIdx, current_row + colIdx - 1))
+        if (compare (current_row + colIdx, current_row + colIdx - 1))
         {
           labels[current_row + colIdx].label = labels[current_row + colIdx - 1].label;
         }
-        if (compare_->compare (current_row + colIdx, previous_row + colIdx) )
+        if (compare (current_row + colIdx, previous_row + colIdx) )
         {
           if (labels[current_row + colIdx].label == invalid_label)
             labels[current_row + colIdx].label = labels[previous_row + colIdx].label;
@@ -226,6 +266,142 @@ pcl::OrganizedConnectedComponentSegmentation<PointT, PointLT>::segment (pcl::Poi
   }
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointT, typename PointLT> template <typename CompareFunctor> void
+pcl::OrganizedConnectedComponentSegmentation<PointT, PointLT>::segmentParallel (const CompareFunctor& compare, pcl::PointCloud<PointLT>& labels, std::vector<pcl::PointIndices>& label_indices) const
+{
+  const unsigned invalid_label = std::numeric_limits<unsigned>::max ();
+  PointLT invalid_pt;
+  invalid_pt.label = invalid_label;
+  labels.points.resize (input_->size (), invalid_pt);
+  labels.width = input_->width;
+  labels.height = input_->height;
+
+  const int width = static_cast<int> (input_->width);
+  const int height = static_cast<int> (input_->height);
+  const int nr_bands = std::min (static_cast<int> (threads_), height);
+
+  // A pixel is labeled if it is finite, except on the first row and column, where a pixel similar to an
+  // unlabeled neighbor takes its (invalid) label in the serial segmentation: follow these chains first
+  std::vector<unsigned char> valid (input_->size (), 0);
+  std::vector<unsigned char> border_join (input_->size (), 0);
+  valid[0] = std::isfinite ((*input_)[0].x);
+  for (int col = 1; col < width; ++col)
+  {
+    if (!std::isfinite ((*input_)[col].x))
+      continue;
+    if (compare (col, col - 1))
+      valid[col] = border_join[col] = valid[col - 1];
+    else
+      valid[col] = 1;
+  }
+  for (int row = 1; row < height; ++row)
+  {
+    const int idx = row * width;
+    if (!std::isfinite ((*input_)[idx].x))
+      continue;
+    if (compare (idx, idx - width))
+      valid[idx] = border_join[idx] = valid[idx - width];
+    else
+      valid[idx] = 1;
+  }
+
+#pragma omp parallel for \
+  default(none) \
+  shared(height, valid, width) \
+  num_threads(threads_)
+  for (int row = 1; row < height; ++row)
+    for (int col = 1; col < width; ++col)
+      valid[row * width + col] = std::isfinite ((*input_)[row * width + col].x);
+
+  // Union-find over the pixels, the root of a component being its first pixel in raster order
+  std::vector<int> parent (input_->size (), -1);
+  const auto find_root = [&parent] (int idx)
+  {
+    while (parent[idx] != idx)
+    {
+      parent[idx] = parent[parent[idx]];
+      idx = parent[idx];
+    }
+    return (idx);
+  };
+  const auto merge = [&parent, &find_root] (int idx1, int idx2)
+  {
+    const int root1 = find_root (idx1);
+    const int root2 = find_root (idx2);
+    if (root1 < root2)
+      parent[root2] = root1;
+    else
+      parent[root1] = root2;
+  };
+
+  // Each band only merges pixels of its own rows, the links to the row above a band are kept for later
+  std::vector<std::vector<unsigned char> > deferred_joins (nr_bands);
+#pragma omp parallel for \
+  default(none) \
+  shared(border_join, compare, deferred_joins, height, merge, nr_bands, parent, valid, width) \
+  schedule(static, 1) \
+  num_threads(threads_)
+  for (int band = 0; band < nr_bands; ++band)
+  {
+    const int first_row = band * height / nr_bands;
+    const int end_row = (band + 1) * height / nr_bands;
+    deferred_joins[band].assign (width, 0);
+    for (int row = first_row; row < end_row; ++row)
+    {
+      for (int col = 0; col < width; ++col)
+      {
+        const int idx = row * width + col;
+        if (!valid[idx])
+          continue;
+        parent[idx] = idx;
+
+        if (col > 0)
+        {
+          if (row == 0 ? border_join[idx] : compare (idx, idx - 1) && valid[idx - 1])
+            merge (idx, idx - 1);
+        }
+        if (row > 0)
+        {
+          const bool join = col == 0 ? border_join[idx] : compare (idx, idx - width) && valid[idx - width];
+          if (join && row == first_row)
+            deferred_joins[band][col] = 1;
+          else if (join)
+            merge (idx, idx - width);
+        }
+      }
+    }
+  }
+
+  for (int band = 1; band < nr_bands; ++band)
+  {
+    const int first_row = band * height / nr_bands;
+    for (int col = 0; col < width; ++col)
+      if (deferred_joins[band][col])
+        merge (first_row * width + col, (first_row - 1) * width + col);
+  }
+
+  // A root is met before the other pixels of its component, which numbers the components as the serial segmentation
+  unsigned nr_components = 0;
+  for (std::size_t idx = 0; idx < input_->size (); ++idx)
+  {
+    if (!valid[idx])
+    {
+      labels[idx].label = invalid_label;
+      continue;
+    }
+    const int root = find_root (static_cast<int> (idx));
+    labels[idx].label = root == static_cast<int> (idx) ? nr_components++ : labels[root].label;
+  }
+
+  label_indices.resize (nr_components + 1);
+  for (std::size_t idx = 0; idx < input_->size (); idx++)
+  {
+    if (labels[idx].label != invalid_label)
+      label_indices[labels[idx].label].indices.push_back (idx);
+  }
+}
+
 #define PCL_INSTANTIATE_OrganizedConnectedComponentSegmentation(T,LT) template class PCL_EXPORTS pcl::OrganizedConnectedComponentSegmentation<T,LT>;
 
 #endif //#ifndef PCL_SEGMENTATION_IMPL_ORGANIZED_CONNECTED_COMPONENT_SEGMENTATION_H_
@@ -42,10 +42,17 @@
 
 #include <pcl/segmentation/boost.h>
 #include <pcl/segmentation/organized_connected_component_segmentation.h>
+#include <pcl/segmentation/impl/organized_connected_component_segmentation.hpp>
 #include <pcl/segmentation/organized_multi_plane_segmentation.h>
 #include <pcl/common/centroid.h>
 #include <pcl/common/eigen.h>
 
+#include <typeinfo>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT> pcl::PointCloud<PointT>
 projectToPlaneFromViewpoint (pcl::PointCloud<PointT>& cloud, Eigen::Vector4f& normal, Eigen::Vector3f& centroid, Eigen::Vector3f& vp)
@@ -67,6 +74,20 @@ projectToPlaneFromViewpoint (pcl::PointCloud<PointT>& cloud, Eigen::Vector4f& no
   return (projected_cloud);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointT, typename PointNT, typename PointLT> void
+pcl::OrganizedMultiPlaneSegmentation<PointT, PointNT, PointLT>::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs ();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template<typename PointT, typename PointNT, typename PointLT> void
 pcl::OrganizedMultiPlaneSegmentation<PointT, PointNT, PointLT>::segment (std::vector<ModelCoefficients>& model_coefficients, 
@@ -120,7 +141,11 @@ pcl::OrganizedMultiPlaneSegmentation<PointT, PointNT, PointLT>::segment (std::ve
   // Calculate range part of planes' hessian normal form
   std::vector<float> plane_d (input_->size ());
   
-  for (std::size_t i = 0; i < input_->size (); ++i)
+#pragma omp parallel for \
+  default(none) \
+  shared(plane_d) \
+  num_threads(threads_)
+  for (std::ptrdiff_t i = 0; i < static_cast<std::ptrdiff_t> (input_->size ()); ++i)
     plane_d[i] = (*input_)[i].getVector3fMap ().dot ((*normals_)[i].getNormalVector3fMap ());
   
   // Make a comparator
@@ -134,59 +159,77 @@ pcl::OrganizedMultiPlaneSegmentation<PointT, PointNT, PointLT>::segment (std::ve
   // Set up the output
   OrganizedConnectedComponentSegmentation<PointT,PointLT> connected_component (compare_);
   connected_component.setInputCloud (input_);
-  connected_component.segment (labels, label_indices);
+  connected_component.setNumberOfThreads (threads_);
+  // The default comparator is compared without virtual calls, the derived ones through their overrides
+  if (typeid (*compare_) == typeid (PlaneComparator))
+    connected_component.segment (static_cast<const PlaneComparator&> (*compare_), labels, label_indices);
+  else
+    connected_component.segment (labels, label_indices);
+
+  // Fit planes to the large enough clusters
+  std::vector<std::size_t> clusters;
+  for (std::size_t i = 0; i < label_indices.size (); ++i)
+    if (static_cast<unsigned> (label_indices[i].indices.size ()) > min_inliers_)
+      clusters.push_back (i);
+
+  std::vector<Eigen::Vector4f, Eigen::aligned_allocator<Eigen::Vector4f> > clust_centroids (clusters.size ());
+  std::vector<Eigen::Matrix3f, Eigen::aligned_allocator<Eigen::Matrix3f> > clust_covs (clusters.size ());
+  std::vector<Eigen::Vector3f, Eigen::aligned_allocator<Eigen::Vector3f> > eigen_vectors (clusters.size ());
+  std::vector<float> eigen_values (clusters.size ());
+#pragma omp parallel for \
+  default(none) \
+  shared(clust_centroids, clust_covs, clusters, eigen_values, eigen_vectors, label_indices) \
+  schedule(dynamic) \
+  num_threads(threads_)
+  for (std::ptrdiff_t i = 0; i < static_cast<std::ptrdiff_t> (clusters.size ()); ++i)
+  {
+    pcl::computeMeanAndCovarianceMatrix (*input_, label_indices[clusters[i]].indices, clust_covs[i], clust_centroids[i]);
+    pcl::eigen33 (clust_covs[i], eigen_values[i], eigen_vectors[i]);
+  }
 
-  Eigen::Vector4f clust_centroid = Eigen::Vector4f::Zero ();
   Eigen::Vector4f vp = Eigen::Vector4f::Zero ();
-  Eigen::Matrix3f clust_cov;
   pcl::ModelCoefficients model;
   model.values.resize (4);
 
-  // Fit Planes to each cluster
-  for (const auto &label_index : label_indices)
+  // The viewpoint is accumulated over the clusters, so the planes are oriented in order
+  for (std::size_t i = 0; i < clusters.size (); ++i)
   {
-    if (static_cast<unsigned> (label_index.indices.size ()) > min_inliers_)
+    const Eigen::Vector4f &clust_centroid = clust_centroids[i];
+    const Eigen::Matrix3f &clust_cov = clust_covs[i];
+    Eigen::Vector4f plane_params;
+    plane_params[0] = eigen_vectors[i][0];
+    plane_params[1] = eigen_vectors[i][1];
+    plane_params[2] = eigen_vectors[i][2];
+    plane_params[3] = 0;
+    plane_params[3] = -1 * plane_params.dot (clust_centroid);
+
+    vp -= clust_centroid;
+    float cos_theta = vp.dot (plane_params);
+    if (cos_theta < 0)
     {
-      pcl::computeMeanAndCovarianceMatrix (*input_, label_index.indices, clust_cov, clust_centroid);
-      Eigen::Vector4f plane_params;
-      
-      EIGEN_ALIGN16 Eigen::Vector3f::Scalar eigen_value;
-      EIGEN_ALIGN16 Eigen::Vector3f eigen_vector;
-      pcl::eigen33 (clust_cov, eigen_value, eigen_vector);
-      plane_params[0] = eigen_vector[0];
-      plane_params[1] = eigen_vector[1];
-      plane_params[2] = eigen_vector[2];
+      plane_params *= -1;
       plane_params[3] = 0;
       plane_params[3] = -1 * plane_params.dot (clust_centroid);
-
-      vp -= clust_centroid;
-      float cos_theta = vp.dot (plane_params);
-      if (cos_theta < 0)
-      {
-        plane_params *= -1;
-        plane_params[3] = 0;
-        plane_params[3] = -1 * plane_params.dot (clust_centroid);
-      }
-      
-      // Compute the curvature surface change
-      float curvature;
-      float eig_sum = clust_cov.coeff (0) + clust_cov.coeff (4) + clust_cov.coeff (8);
-      if (eig_sum != 0)
-        curvature = std::abs (eigen_value / eig_sum);
-      else
-        curvature = 0;
-
-      if (curvature < maximum_curvature_)
-      {
-        model.values[0] = plane_params[0];
-        model.values[1] = plane_params[1];
-        model.values[2] = plane_params[2];
-        model.values[3] = plane_params[3];
-        model_coefficients.push_back (model);
-        inlier_indices.push_back (label_index);
-        centroids.push_back (clust_centroid);
-        covariances.push_back (clust_cov);
-      }
+    }
+    
+    // Compute the curvature surface change
+    float curvature;
+    float eig_sum = clust_cov.coeff (0) + clust_cov.coeff (4) + clust_cov.coeff (8);
+    if (eig_sum != 0)
+      curvature = std::abs (eigen_values[i] / eig_sum);
+    else
+      curvature = 0;
+
+    if (curvature < maximum_curvature_)
+    {
+      model.values[0] = plane_params[0];
+      model.values[1] = plane_params[1];
+      model.values[2] = plane_params[2];
+      model.values[3] = plane_params[3];
+      model_coefficients.push_back (model);
+      inlier_indices.push_back (label_indices[clusters[i]]);
+      centroids.push_back (clust_centroid);
+      covariances.push_back (clust_cov);
     }
   }
   deinitCompute ();
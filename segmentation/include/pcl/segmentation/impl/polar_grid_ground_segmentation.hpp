@@ -0,0 +1,273 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved
+ */
+
+#ifndef PCL_SEGMENTATION_POLAR_GRID_GROUND_SEGMENTATION_HPP_
+#define PCL_SEGMENTATION_POLAR_GRID_GROUND_SEGMENTATION_HPP_
+
+#include <pcl/segmentation/polar_grid_ground_segmentation.h>
+#include <pcl/common/point_tests.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT>
+pcl::PolarGridGroundSegmentation<PointT>::PolarGridGroundSegmentation () :
+  sensor_height_ (1.73f),
+  number_of_segments_ (360),
+  number_of_bins_ (160),
+  max_range_ (80.0f),
+  max_slope_ (0.3f),
+  max_fit_error_ (0.05f),
+  max_start_height_ (0.2f),
+  max_distance_ (0.1f),
+  scan_count_ (0)
+{
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> int
+pcl::PolarGridGroundSegmentation<PointT>::getSegment (const PointT &point) const
+{
+  if (!pcl::isFinite (point) || point.x * point.x + point.y * point.y >= max_range_ * max_range_)
+    return (-1);
+
+  const float angle = std::atan2 (point.y, point.x) + static_cast<float> (M_PI);
+  const int segment = static_cast<int> (angle * static_cast<float> (number_of_segments_) / static_cast<float> (2.0 * M_PI));
+  return (std::min (std::max (segment, 0), number_of_segments_ - 1));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::PolarGridGroundSegmentation<PointT>::segmentSegment (const typename PointCloud::VectorType &points,
+                                                          const std::vector<int> &indices,
+                                                          std::vector<bool> &is_ground) const
+{
+  const float bin_size = max_range_ / static_cast<float> (number_of_bins_);
+
+  // The lowest point of every bin
+  std::vector<int> point_bins (indices.size ());
+  std::vector<float> bin_ranges (number_of_bins_, 0.0f);
+  std::vector<float> bin_heights (number_of_bins_, std::numeric_limits<float>::max ());
+  for (std::size_t i = 0; i < indices.size (); ++i)
+  {
+    const PointT &point = points[indices[i]];
+    const float range = std::sqrt (point.x * point.x + point.y * point.y);
+    const int bin = std::min (static_cast<int> (range / bin_size), number_of_bins_ - 1);
+    point_bins[i] = bin;
+    if (point.z < bin_heights[bin])
+    {
+      bin_heights[bin] = point.z;
+      bin_ranges[bin] = range;
+    }
+  }
+
+  // Fit the lines in order of range: a line is extended with the lowest point of the next bin as long as this point
+  // is close to the line and the line stays flat and straight enough, and a new line only starts close to the
+  // height of the previous one
+  std::vector<float> slopes (number_of_bins_, 0.0f);
+  std::vector<float> intercepts (number_of_bins_, 0.0f);
+  std::vector<bool> has_line (number_of_bins_, false);
+  float previous_slope = 0.0f;
+  float previous_intercept = -sensor_height_;
+
+  int first_bin = 0;
+  int last_bin = 0;
+  int n = 0;
+  double sum_r = 0.0, sum_z = 0.0, sum_rr = 0.0, sum_rz = 0.0, sum_zz = 0.0;
+
+  auto fit = [&] (int count, double sr, double sz, double srr, double srz, double szz, float &slope, float &intercept)
+  {
+    if (count < 2)
+    {
+      slope = previous_slope;
+      intercept = static_cast<float> (sz - previous_slope * sr);
+      return (0.0);
+    }
+    const double var_r = srr - sr * sr / count;
+    const double cov_rz = srz - sr * sz / count;
+    const double var_z = szz - sz * sz / count;
+    const double m = (var_r > 0.0) ? cov_rz / var_r : 0.0;
+    slope = static_cast<float> (m);
+    intercept = static_cast<float> ((sz - m * sr) / count);
+    return (std::sqrt (std::max (var_z - m * cov_rz, 0.0) / count));
+  };
+
+  auto store_line = [&] ()
+  {
+    if (n == 0)
+      return;
+    fit (n, sum_r, sum_z, sum_rr, sum_rz, sum_zz, previous_slope, previous_intercept);
+    for (int bin = first_bin; bin <= last_bin; ++bin)
+    {
+      slopes[bin] = previous_slope;
+      intercepts[bin] = previous_intercept;
+      has_line[bin] = true;
+    }
+    n = 0;
+    sum_r = sum_z = sum_rr = sum_rz = sum_zz = 0.0;
+  };
+
+  for (int bin = 0; bin < number_of_bins_; ++bin)
+  {
+    if (bin_heights[bin] == std::numeric_limits<float>::max ())
+      continue;
+    const double r = bin_ranges[bin];
+    const double z = bin_heights[bin];
+
+    if (n > 0)
+    {
+      float slope, intercept;
+      fit (n, sum_r, sum_z, sum_rr, sum_rz, sum_zz, slope, intercept);
+      const bool on_line = (n < 2) || std::abs (z - (slope * r + intercept)) <= max_distance_;
+      const double error = fit (n + 1, sum_r + r, sum_z + z, sum_rr + r * r, sum_rz + r * z, sum_zz + z * z,
+                                slope, intercept);
+      if (on_line && std::abs (slope) <= max_slope_ && error <= max_fit_error_)
+      {
+        ++n;
+        sum_r += r; sum_z += z; sum_rr += r * r; sum_rz += r * z; sum_zz += z * z;
+        last_bin = bin;
+        continue;
+      }
+      store_line ();
+    }
+
+    if (std::abs (z - (previous_slope * r + previous_intercept)) <= max_start_height_)
+    {
+      n = 1;
+      sum_r = r; sum_z = z; sum_rr = r * r; sum_rz = r * z; sum_zz = z * z;
+      first_bin = last_bin = bin;
+    }
+  }
+  store_line ();
+
+  // The ground returns are the points close to the line of their bin
+  is_ground.assign (indices.size (), false);
+  for (std::size_t i = 0; i < indices.size (); ++i)
+  {
+    const int bin = point_bins[i];
+    if (!has_line[bin])
+      continue;
+    const PointT &point = points[indices[i]];
+    const float range = std::sqrt (point.x * point.x + point.y * point.y);
+    is_ground[i] = std::abs (point.z - (slopes[bin] * range + intercepts[bin])) <= max_distance_;
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::PolarGridGroundSegmentation<PointT>::extract (std::vector<int>& ground)
+{
+  ground.clear ();
+
+  bool segmentation_is_possible = initCompute ();
+  if (!segmentation_is_possible || number_of_segments_ < 1 || number_of_bins_ < 1)
+  {
+    deinitCompute ();
+    return;
+  }
+
+  std::vector<std::vector<int> > segments (number_of_segments_);
+  for (const int &index : *indices_)
+  {
+    const int segment = getSegment ((*input_)[index]);
+    if (segment >= 0)
+      segments[segment].push_back (index);
+  }
+
+  std::vector<bool> is_ground;
+  for (const auto &segment : segments)
+  {
+    segmentSegment (input_->points, segment, is_ground);
+    for (std::size_t i = 0; i < segment.size (); ++i)
+      if (is_ground[i])
+        ground.push_back (segment[i]);
+  }
+  std::sort (ground.begin (), ground.end ());
+
+  deinitCompute ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::PolarGridGroundSegmentation<PointT>::reset ()
+{
+  pending_.assign (std::max (number_of_segments_, 0), typename PointCloud::VectorType ());
+  last_scan_.assign (std::max (number_of_segments_, 0), 0);
+  scan_count_ = 0;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::PolarGridGroundSegmentation<PointT>::flushSegment (int segment, PointCloud &ground, PointCloud &non_ground)
+{
+  typename PointCloud::VectorType &points = pending_[segment];
+  std::vector<int> indices (points.size ());
+  std::iota (indices.begin (), indices.end (), 0);
+
+  std::vector<bool> is_ground;
+  segmentSegment (points, indices, is_ground);
+  for (std::size_t i = 0; i < points.size (); ++i)
+  {
+    if (is_ground[i])
+      ground.push_back (points[i]);
+    else
+      non_ground.push_back (points[i]);
+  }
+  points.clear ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::PolarGridGroundSegmentation<PointT>::addScan (const PointCloudConstPtr &scan,
+                                                   PointCloud &ground, PointCloud &non_ground)
+{
+  ground.clear ();
+  non_ground.clear ();
+  if (!scan || number_of_segments_ < 1 || number_of_bins_ < 1)
+    return;
+  ground.header = non_ground.header = scan->header;
+
+  if (static_cast<int> (pending_.size ()) != number_of_segments_)
+    reset ();
+  ++scan_count_;
+
+  for (const auto &point : *scan)
+  {
+    const int segment = getSegment (point);
+    if (segment < 0)
+    {
+      non_ground.push_back (point);
+      continue;
+    }
+    pending_[segment].push_back (point);
+    last_scan_[segment] = scan_count_;
+  }
+
+  for (int segment = 0; segment < number_of_segments_; ++segment)
+    if (!pending_[segment].empty () && last_scan_[segment] != scan_count_)
+      flushSegment (segment, ground, non_ground);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::PolarGridGroundSegmentation<PointT>::flush (PointCloud &ground, PointCloud &non_ground)
+{
+  ground.clear ();
+  non_ground.clear ();
+  for (int segment = 0; segment < static_cast<int> (pending_.size ()); ++segment)
+    if (!pending_[segment].empty ())
+      flushSegment (segment, ground, non_ground);
+}
+
+#define PCL_INSTANTIATE_PolarGridGroundSegmentation(T) template class pcl::PolarGridGroundSegmentation<T>;
+
+#endif    // PCL_SEGMENTATION_POLAR_GRID_GROUND_SEGMENTATION_HPP_
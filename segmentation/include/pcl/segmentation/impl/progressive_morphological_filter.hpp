@@ -43,6 +43,7 @@
 #include <pcl/common/io.h>
 #include <pcl/filters/morphological_filter.h>
 #include <pcl/filters/extract_indices.h>
+#include <pcl/octree/octree_search.h>
 #include <pcl/segmentation/progressive_morphological_filter.h>
 #include <pcl/point_cloud.h>
 #include <pcl/point_types.h>
@@ -56,7 +57,8 @@ pcl::ProgressiveMorphologicalFilter<PointT>::ProgressiveMorphologicalFilter () :
   initial_distance_ (0.15f),
   cell_size_ (1.0f),
   base_ (2.0f),
-  exponential_ (true)
+  exponential_ (true),
+  threads_ (0)
 {
 }
 
@@ -125,7 +127,7 @@ pcl::ProgressiveMorphologicalFilter<PointT>::extract (std::vector<int>& ground)
     // Create new cloud to hold the filtered results. Apply the morphological
     // opening operation at the current window size.
     typename pcl::PointCloud<PointT>::Ptr cloud_f (new pcl::PointCloud<PointT>);
-    pcl::applyMorphologicalOperator<PointT> (cloud, window_sizes[i], MORPH_OPEN, *cloud_f);
+    applyOpening (cloud, window_sizes[i], *cloud_f);
 
     // Find indices of the points whose difference between the source and
     // filtered point clouds is less than the current height threshold.
@@ -146,6 +148,52 @@ pcl::ProgressiveMorphologicalFilter<PointT>::extract (std::vector<int>& ground)
   deinitCompute ();
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::ProgressiveMorphologicalFilter<PointT>::applyOpening (const typename PointCloud::ConstPtr &cloud, float window_size,
+                                                           PointCloud &cloud_out) const
+{
+  if (cloud->empty ())
+    return;
+
+  pcl::copyPointCloud (*cloud, cloud_out);
+
+  pcl::octree::OctreePointCloudSearch<PointT> tree (window_size);
+  tree.setInputCloud (cloud);
+  tree.addPointsFromInputCloud ();
+
+  const float half_res = window_size / 2.0f;
+  const int number_of_points = static_cast<int> (cloud->size ());
+
+  // The windows only depend on x and y, which the erosion keeps: both passes search the same octree
+  PointCloud cloud_temp;
+  pcl::copyPointCloud (*cloud, cloud_temp);
+  for (const bool erode : {true, false})
+  {
+    const PointCloud &cloud_src = erode ? *cloud : cloud_temp;
+    PointCloud &cloud_dst = erode ? cloud_temp : cloud_out;
+#pragma omp parallel for \
+  default(none) \
+  shared(cloud_dst, cloud_src, erode, half_res, number_of_points, tree) \
+  schedule(dynamic, 256) \
+  num_threads(threads_)
+    for (int p_idx = 0; p_idx < number_of_points; ++p_idx)
+    {
+      std::vector<int> pt_indices;
+      const Eigen::Vector3f bbox_min (cloud_src[p_idx].x - half_res, cloud_src[p_idx].y - half_res, -std::numeric_limits<float>::max ());
+      const Eigen::Vector3f bbox_max (cloud_src[p_idx].x + half_res, cloud_src[p_idx].y + half_res, std::numeric_limits<float>::max ());
+      tree.boxSearch (bbox_min, bbox_max, pt_indices);
+
+      if (!pt_indices.empty ())
+      {
+        Eigen::Vector4f min_pt, max_pt;
+        pcl::getMinMax3D<PointT> (cloud_src, pt_indices, min_pt, max_pt);
+        cloud_dst[p_idx].z = erode ? min_pt.z () : max_pt.z ();
+      }
+    }
+  }
+}
+
 #define PCL_INSTANTIATE_ProgressiveMorphologicalFilter(T) template class pcl::ProgressiveMorphologicalFilter<T>;
 
 #endif    // PCL_SEGMENTATION_PROGRESSIVE_MORPHOLOGICAL_FILTER_HPP_
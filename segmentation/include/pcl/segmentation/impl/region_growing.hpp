@@ -52,6 +52,10 @@
 #include <cmath>
 #include <ctime>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT, typename NormalT>
 pcl::RegionGrowing<PointT, NormalT>::RegionGrowing () :
@@ -71,7 +75,8 @@ pcl::RegionGrowing<PointT, NormalT>::RegionGrowing () :
   normal_flag_ (true),
   num_pts_in_segment_ (0),
   clusters_ (0),
-  number_of_segments_ (0)
+  number_of_segments_ (0),
+  threads_ (1)
 {
 }
 
@@ -245,6 +250,27 @@ pcl::RegionGrowing<PointT, NormalT>::setInputNormals (const NormalPtr& norm)
   normals_ = norm;
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT, typename NormalT> void
+pcl::RegionGrowing<PointT, NormalT>::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs ();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT, typename NormalT> unsigned int
+pcl::RegionGrowing<PointT, NormalT>::getNumberOfThreads () const
+{
+  return (threads_);
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT, typename NormalT> void
 pcl::RegionGrowing<PointT, NormalT>::extract (std::vector <pcl::PointIndices>& clusters)
@@ -347,27 +373,23 @@ pcl::RegionGrowing<PointT, NormalT>::findPointNeighbours ()
   std::vector<float> distances;
 
   point_neighbours_.resize (input_->size (), neighbours);
-  if (input_->is_dense)
+  const bool check_finite = !input_->is_dense;
+
+  // The searches are independent, and each of them writes the neighbours of its own point
+#pragma omp parallel for \
+  default(none) \
+  shared(point_number, check_finite) \
+  firstprivate(neighbours, distances) \
+  schedule(dynamic, 256) \
+  num_threads(threads_)
+  for (int i_point = 0; i_point < point_number; i_point++)
   {
-    for (int i_point = 0; i_point < point_number; i_point++)
-    {
-      int point_index = (*indices_)[i_point];
-      neighbours.clear ();
-      search_->nearestKSearch (i_point, neighbour_number_, neighbours, distances);
-      point_neighbours_[point_index].swap (neighbours);
-    }
-  }
-  else
-  {
-    for (int i_point = 0; i_point < point_number; i_point++)
-    {
-      neighbours.clear ();
-      int point_index = (*indices_)[i_point];
-      if (!pcl::isFinite ((*input_)[point_index]))
-        continue;
-      search_->nearestKSearch (i_point, neighbour_number_, neighbours, distances);
-      point_neighbours_[point_index].swap (neighbours);
-    }
+    neighbours.clear ();
+    int point_index = (*indices_)[i_point];
+    if (check_finite && !pcl::isFinite ((*input_)[point_index]))
+      continue;
+    search_->nearestKSearch (i_point, neighbour_number_, neighbours, distances);
+    point_neighbours_[point_index].swap (neighbours);
   }
 }
 
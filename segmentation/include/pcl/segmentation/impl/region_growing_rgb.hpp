@@ -278,6 +278,13 @@ pcl::RegionGrowingRGB<PointT, NormalT>::findPointNeighbours ()
   point_neighbours_.resize (input_->size (), neighbours);
   point_distances_.resize (input_->size (), distances);
 
+  // The searches are independent, and each of them writes the neighbours of its own point
+#pragma omp parallel for \
+  default(none) \
+  shared(point_number) \
+  firstprivate(neighbours, distances) \
+  schedule(dynamic, 256) \
+  num_threads(threads_)
   for (int i_point = 0; i_point < point_number; i_point++)
   {
     int point_index = (*indices_)[i_point];
@@ -298,6 +305,10 @@ pcl::RegionGrowingRGB<PointT, NormalT>::findSegmentNeighbours ()
   segment_neighbours_.resize (number_of_segments_, neighbours);
   segment_distances_.resize (number_of_segments_, distances);
 
+#pragma omp parallel for \
+  default(none) \
+  schedule(dynamic, 64) \
+  num_threads(threads_)
   for (int i_seg = 0; i_seg < number_of_segments_; i_seg++)
   {
     std::vector<int> nghbrs;
@@ -312,9 +323,10 @@ pcl::RegionGrowingRGB<PointT, NormalT>::findSegmentNeighbours ()
 template <typename PointT,typename NormalT> void
 pcl::RegionGrowingRGB<PointT, NormalT>::findRegionsKNN (int index, int nghbr_number, std::vector<int>& nghbrs, std::vector<float>& dist)
 {
-  std::vector<float> distances;
-  float max_dist = std::numeric_limits<float>::max ();
-  distances.resize (clusters_.size (), max_dist);
+  // Gather the segments of the neighbours of the points of this segment, with their distances. Only the segments
+  // actually touched are visited, instead of all the segments of the cloud for each segment
+  std::vector<std::pair<int, float> > touched_segments;
+  touched_segments.reserve (num_pts_in_segment_[index] * region_neighbour_number_);
 
   int number_of_points = num_pts_in_segment_[index];
   //loop through every point in this segment and check neighbours
@@ -323,28 +335,26 @@ pcl::RegionGrowingRGB<PointT, NormalT>::findRegionsKNN (int index, int nghbr_num
     int point_index = clusters_[index].indices[i_point];
     int number_of_neighbours = static_cast<int> (point_neighbours_[point_index].size ());
     //loop through every neighbour of the current point, find out to which segment it belongs
-    //and if it belongs to neighbouring segment and is close enough then remember segment and its distance
+    //and if it belongs to neighbouring segment then remember segment and its distance
     for (int i_nghbr = 0; i_nghbr < number_of_neighbours; i_nghbr++)
     {
       // find segment
-      int segment_index = -1;
-      segment_index = point_labels_[ point_neighbours_[point_index][i_nghbr] ];
-
+      int segment_index = point_labels_[ point_neighbours_[point_index][i_nghbr] ];
       if ( segment_index != index )
-      {
-        // try to push it to the queue
-        if (distances[segment_index] > point_distances_[point_index][i_nghbr])
-          distances[segment_index] = point_distances_[point_index][i_nghbr];
-      }
+        touched_segments.emplace_back (segment_index, point_distances_[point_index][i_nghbr]);
     }
   }// next point
+  std::sort (touched_segments.begin (), touched_segments.end ());
 
+  // After the sort, the first pair of each segment holds its distance to this segment
   std::priority_queue<std::pair<float, int> > segment_neighbours;
-  for (int i_seg = 0; i_seg < number_of_segments_; i_seg++)
+  for (std::size_t i = 0; i < touched_segments.size (); i++)
   {
-    if (distances[i_seg] < max_dist)
+    if (i > 0 && touched_segments[i].first == touched_segments[i - 1].first)
+      continue;
+    if (touched_segments[i].second < std::numeric_limits<float>::max ())
     {
-      segment_neighbours.push (std::make_pair (distances[i_seg], i_seg) );
+      segment_neighbours.push (std::make_pair (touched_segments[i].second, touched_segments[i].first) );
       if (int (segment_neighbours.size ()) > nghbr_number)
         segment_neighbours.pop ();
     }
@@ -71,11 +71,13 @@
 #include <pcl/sample_consensus/sac_model_stick.h>
 
 #include <pcl/memory.h>  // for static_pointer_cast
+#include <pcl/common/instrumentation.h>
 
 //////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT> void
 pcl::SACSegmentation<PointT>::segment (PointIndices &inliers, ModelCoefficients &model_coefficients)
 {
+  PCL_INSTRUMENT_SCOPE (getClassName ());
   // Copy the header information
   inliers.header = model_coefficients.header = input_->header;
 
@@ -126,6 +128,79 @@ pcl::SACSegmentation<PointT>::segment (PointIndices &inliers, ModelCoefficients
     model_coefficients.values.resize (coeff.size ());
     memcpy (&model_coefficients.values[0], &coeff[0], coeff.size () * sizeof (float));
   }
+  PCL_INSTRUMENT_COUNT (getClassName () + ".inliers", inliers.indices.size ());
+
+  deinitCompute ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::SACSegmentation<PointT>::segment (std::vector<PointIndices> &inliers,
+                                       std::vector<ModelCoefficients> &model_coefficients,
+                                       std::size_t max_models,
+                                       std::size_t min_inliers)
+{
+  inliers.clear ();
+  model_coefficients.clear ();
+
+  if (!initCompute ())
+    return;
+
+  // Initialize the Sample Consensus model and method once, for all the models
+  if (!initSACModel (model_type_))
+  {
+    PCL_ERROR ("[pcl::%s::segment] Error initializing the SAC model!\n", getClassName ().c_str ());
+    deinitCompute ();
+    return;
+  }
+  initSAC (method_type_);
+
+  // The model owns a copy of the indices, from which the inliers of the models found are removed
+  const IndicesPtr remaining = model_->getIndices ();
+  std::vector<bool> is_inlier (input_->size (), false);
+
+  while (inliers.size () < max_models && remaining->size () >= (std::max) (min_inliers, static_cast<std::size_t> (model_->getSampleSize ())))
+  {
+    if (!sac_->computeModel (0))
+      break;
+
+    PointIndices model_inliers;
+    ModelCoefficients coefficients;
+    model_inliers.header = coefficients.header = input_->header;
+    sac_->getInliers (model_inliers.indices);
+
+    Eigen::VectorXf coeff;
+    sac_->getModelCoefficients (coeff);
+
+    // If the user needs optimized coefficients
+    if (optimize_coefficients_)
+    {
+      Eigen::VectorXf coeff_refined;
+      model_->optimizeModelCoefficients (model_inliers.indices, coeff, coeff_refined);
+      coeff = coeff_refined;
+      // Refine inliers
+      model_->selectWithinDistance (coeff, threshold_, model_inliers.indices);
+    }
+
+    if (model_inliers.indices.size () < min_inliers || model_inliers.indices.empty ())
+      break;
+    coefficients.values.assign (coeff.data (), coeff.data () + coeff.size ());
+
+    // Remove the inliers from the indices in place, and let the model update its copy of them
+    for (const index_t &index : model_inliers.indices)
+      is_inlier[index] = true;
+    std::size_t nr_remaining = 0;
+    for (const index_t &index : *remaining)
+      if (!is_inlier[index])
+        (*remaining)[nr_remaining++] = index;
+    remaining->resize (nr_remaining);
+    for (const index_t &index : model_inliers.indices)
+      is_inlier[index] = false;
+    model_->setIndices (remaining);
+
+    inliers.push_back (std::move (model_inliers));
+    model_coefficients.push_back (std::move (coefficients));
+  }
 
   deinitCompute ();
 }
@@ -42,6 +42,14 @@
 #include <pcl/common/io.h>
 #include <pcl/common/point_tests.h> // for pcl::isFinite
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 
 //////////////////////////////////////////////////////////////////////////
 template <typename PointT> void
@@ -51,30 +59,55 @@ pcl::getPointCloudDifference (
     const typename pcl::search::Search<PointT>::Ptr &tree,
     pcl::PointCloud<PointT> &output)
 {
-  // We're interested in a single nearest neighbor only
-  std::vector<int> nn_indices (1);
-  std::vector<float> nn_distances (1);
+  getPointCloudDifference (src, threshold, tree, output, 1);
+}
 
-  // The input cloud indices that do not have a neighbor in the target cloud
-  std::vector<int> src_indices;
+//////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::getPointCloudDifference (
+    const pcl::PointCloud<PointT> &src,
+    double threshold,
+    const typename pcl::search::Search<PointT>::Ptr &tree,
+    pcl::PointCloud<PointT> &output,
+    unsigned int nr_threads)
+{
+  // Whether the input points have no neighbor in the target cloud, written by the point index so that
+  // the order of the output does not depend on the scheduling
+  std::vector<unsigned char> is_different (src.size (), 0);
 
-  // Iterate through the source data set
-  for (int i = 0; i < static_cast<int> (src.size ()); ++i)
+#pragma omp parallel \
+  default(none) \
+  shared(is_different, src, threshold, tree) \
+  num_threads(nr_threads)
   {
-    // Ignore invalid points in the inpout cloud
-    if (!isFinite (src[i]))
-      continue;
-    // Search for the closest point in the target data set (number of neighbors to find = 1)
-    if (!tree->nearestKSearch (src[i], 1, nn_indices, nn_distances))
+    // We're interested in a single nearest neighbor only
+    std::vector<int> nn_indices (1);
+    std::vector<float> nn_distances (1);
+
+    // Iterate through the source data set
+#pragma omp for schedule(dynamic, 1024)
+    for (std::ptrdiff_t i = 0; i < static_cast<std::ptrdiff_t> (src.size ()); ++i)
     {
-      PCL_WARN ("No neighbor found for point %lu (%f %f %f)!\n", i, src[i].x, src[i].y, src[i].z);
-      continue;
+      // Ignore invalid points in the inpout cloud
+      if (!isFinite (src[i]))
+        continue;
+      // Search for the closest point in the target data set (number of neighbors to find = 1)
+      if (!tree->nearestKSearch (src[i], 1, nn_indices, nn_distances))
+      {
+        PCL_WARN ("No neighbor found for point %ld (%f %f %f)!\n", static_cast<long> (i), src[i].x, src[i].y, src[i].z);
+        continue;
+      }
+      // Mark points without a corresponding point in the target cloud
+      is_different[i] = nn_distances[0] > threshold;
     }
-    // Add points without a corresponding point in the target cloud to the output cloud
-    if (nn_distances[0] > threshold)
-      src_indices.push_back (i);
   }
 
+  // The input cloud indices that do not have a neighbor in the target cloud
+  std::vector<int> src_indices;
+  for (std::size_t i = 0; i < is_different.size (); ++i)
+    if (is_different[i])
+      src_indices.push_back (static_cast<int> (i));
+
   // Copy all the data fields from the input cloud to the output one
   copyPointCloud (src, src_indices, output);
 
@@ -82,6 +115,20 @@ pcl::getPointCloudDifference (
   output.is_dense = true;
 }
 
+//////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::SegmentDifferences<PointT>::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs ();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
+
 //////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////
@@ -104,6 +151,13 @@ pcl::SegmentDifferences<PointT>::segment (PointCloud &output)
     return;
   }
 
+  if (tile_size_ > 0)
+  {
+    segmentTiles (output);
+    deinitCompute ();
+    return;
+  }
+
   // Initialize the spatial locator
   if (!tree_)
   {
@@ -115,11 +169,125 @@ pcl::SegmentDifferences<PointT>::segment (PointCloud &output)
   // Send the input dataset to the spatial locator
   tree_->setInputCloud (target_);
 
-  getPointCloudDifference (*input_, distance_threshold_, tree_, output);
+  getPointCloudDifference (*input_, distance_threshold_, tree_, output, threads_);
 
   deinitCompute ();
 }
 
+//////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::SegmentDifferences<PointT>::segmentTiles (PointCloud &output)
+{
+  // The distances of the search are squared, so the nearest target point of an input point closer than the
+  // threshold lies at most sqrt (threshold) away from it, within the margin of the tile of the input point
+  const float margin = static_cast<float> (std::sqrt (distance_threshold_));
+
+  // Lay the tiles over the finite input points
+  float min_x = std::numeric_limits<float>::max (), min_y = std::numeric_limits<float>::max ();
+  float max_x = -std::numeric_limits<float>::max (), max_y = -std::numeric_limits<float>::max ();
+  for (const auto &point : input_->points)
+  {
+    if (!isFinite (point))
+      continue;
+    min_x = std::min (min_x, point.x); max_x = std::max (max_x, point.x);
+    min_y = std::min (min_y, point.y); max_y = std::max (max_y, point.y);
+  }
+  if (min_x > max_x)
+  {
+    // No finite input point, hence no difference
+    output.width = output.height = 0;
+    output.points.clear ();
+    output.is_dense = true;
+    return;
+  }
+  const std::size_t cols = static_cast<std::size_t> (std::floor ((max_x - min_x) / tile_size_)) + 1;
+  const std::size_t rows = static_cast<std::size_t> (std::floor ((max_y - min_y) / tile_size_)) + 1;
+
+  // Bucket the input points by tile, and the target points in every tile whose margin they fall into
+  std::vector<std::vector<int> > input_tiles (cols * rows), target_tiles (cols * rows);
+  for (std::size_t i = 0; i < input_->size (); ++i)
+  {
+    const PointT &point = (*input_)[i];
+    if (!isFinite (point))
+      continue;
+    const std::size_t col = std::min (cols - 1, static_cast<std::size_t> ((point.x - min_x) / tile_size_));
+    const std::size_t row = std::min (rows - 1, static_cast<std::size_t> ((point.y - min_y) / tile_size_));
+    input_tiles[row * cols + col].push_back (static_cast<int> (i));
+  }
+  for (std::size_t i = 0; i < target_->size (); ++i)
+  {
+    const PointT &point = (*target_)[i];
+    if (!isFinite (point))
+      continue;
+    const float col_lo = std::floor ((point.x - margin - min_x) / tile_size_), col_hi = std::floor ((point.x + margin - min_x) / tile_size_);
+    const float row_lo = std::floor ((point.y - margin - min_y) / tile_size_), row_hi = std::floor ((point.y + margin - min_y) / tile_size_);
+    if (col_hi < 0 || row_hi < 0 || col_lo >= static_cast<float> (cols) || row_lo >= static_cast<float> (rows))
+      continue;
+    const std::size_t col_begin = static_cast<std::size_t> (std::max (col_lo, 0.0f));
+    const std::size_t row_begin = static_cast<std::size_t> (std::max (row_lo, 0.0f));
+    const std::size_t col_end = std::min (cols - 1, static_cast<std::size_t> (col_hi));
+    const std::size_t row_end = std::min (rows - 1, static_cast<std::size_t> (row_hi));
+    for (std::size_t row = row_begin; row <= row_end; ++row)
+      for (std::size_t col = col_begin; col <= col_end; ++col)
+        if (!input_tiles[row * cols + col].empty ())
+          target_tiles[row * cols + col].push_back (static_cast<int> (i));
+  }
+
+  // The tiles hold unorganized subsets of the target cloud
+  if (!tree_ || target_->isOrganized ())
+    tree_.reset (new pcl::search::KdTree<PointT> (false));
+
+  std::vector<unsigned char> is_different (input_->size (), 0);
+  typename PointCloud::Ptr tile_target (new PointCloud);
+  for (std::size_t tile = 0; tile < input_tiles.size (); ++tile)
+  {
+    const std::vector<int> &tile_input = input_tiles[tile];
+    if (tile_input.empty ())
+      continue;
+
+    // Without target points near the tile, no input point of the tile has a correspondence
+    if (target_tiles[tile].empty ())
+    {
+      for (const int &idx : tile_input)
+        is_different[idx] = 1;
+      continue;
+    }
+
+    copyPointCloud (*target_, target_tiles[tile], *tile_target);
+    // Release the bucket as soon as its points are copied
+    std::vector<int> ().swap (target_tiles[tile]);
+    tree_->setInputCloud (tile_target);
+
+#pragma omp parallel \
+  default(none) \
+  shared(is_different, tile_input) \
+  num_threads(threads_)
+    {
+      std::vector<int> nn_indices (1);
+      std::vector<float> nn_distances (1);
+#pragma omp for schedule(dynamic, 1024)
+      for (std::ptrdiff_t i = 0; i < static_cast<std::ptrdiff_t> (tile_input.size ()); ++i)
+      {
+        const int idx = tile_input[i];
+        if (!tree_->nearestKSearch ((*input_)[idx], 1, nn_indices, nn_distances))
+          is_different[idx] = 1;
+        else
+          is_different[idx] = nn_distances[0] > distance_threshold_;
+      }
+    }
+  }
+
+  std::vector<int> src_indices;
+  for (std::size_t i = 0; i < is_different.size (); ++i)
+    if (is_different[i])
+      src_indices.push_back (static_cast<int> (i));
+
+  copyPointCloud (*input_, src_indices, output);
+  output.header = input_->header;
+  output.is_dense = true;
+}
+
 #define PCL_INSTANTIATE_SegmentDifferences(T) template class PCL_EXPORTS pcl::SegmentDifferences<T>;
-#define PCL_INSTANTIATE_getPointCloudDifference(T) template PCL_EXPORTS void pcl::getPointCloudDifference<T>(const pcl::PointCloud<T> &, double, const typename pcl::search::Search<T>::Ptr &, pcl::PointCloud<T> &);
+#define PCL_INSTANTIATE_getPointCloudDifference(T) template PCL_EXPORTS void pcl::getPointCloudDifference<T>(const pcl::PointCloud<T> &, double, const typename pcl::search::Search<T>::Ptr &, pcl::PointCloud<T> &); \
+  template PCL_EXPORTS void pcl::getPointCloudDifference<T>(const pcl::PointCloud<T> &, double, const typename pcl::search::Search<T>::Ptr &, pcl::PointCloud<T> &, unsigned int);
 
@@ -42,6 +42,10 @@
 
 #include <pcl/segmentation/supervoxel_clustering.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT>
 pcl::SupervoxelClustering<PointT>::SupervoxelClustering (float voxel_resolution, float seed_resolution) :
@@ -52,7 +56,9 @@ pcl::SupervoxelClustering<PointT>::SupervoxelClustering (float voxel_resolution,
   color_importance_ (0.1f),
   spatial_importance_ (0.4f),
   normal_importance_ (1.0f),
-  use_default_transform_behaviour_ (true)
+  use_default_transform_behaviour_ (true),
+  threads_ (1),
+  use_previous_seeds_ (false)
 {
   adjacency_octree_.reset (new OctreeAdjacencyT (resolution_));
 }
@@ -116,9 +122,18 @@ pcl::SupervoxelClustering<PointT>::extract (std::map<std::uint32_t,typename Supe
   //double t_prep = timer_.getTime ();
   //std::cout << "Placing Seeds" << std::endl;
   std::vector<int> seed_indices;
-  selectInitialSupervoxelSeeds (seed_indices);
-  //std::cout << "Creating helpers "<<std::endl;
-  createSupervoxelHelpers (seed_indices);
+  if (use_previous_seeds_ && !previous_seeds_.empty ())
+  {
+    std::vector<std::uint32_t> seed_labels;
+    selectPreviousSupervoxelSeeds (seed_indices, seed_labels);
+    createSupervoxelHelpers (seed_indices, seed_labels);
+  }
+  else
+  {
+    selectInitialSupervoxelSeeds (seed_indices);
+    //std::cout << "Creating helpers "<<std::endl;
+    createSupervoxelHelpers (seed_indices);
+  }
   //double t_seeds = timer_.getTime ();
   
   
@@ -156,10 +171,19 @@ pcl::SupervoxelClustering<PointT>::refineSupervoxels (int num_itr, std::map<std:
   int max_depth = static_cast<int> (1.8f*seed_resolution_/resolution_);
   for (int i = 0; i < num_itr; ++i)
   {
+    // Each helper only writes the normals of its own voxels
+    std::vector<SupervoxelHelper*> helpers;
+    helpers.reserve (supervoxel_helpers_.size ());
     for (typename HelperListT::iterator sv_itr = supervoxel_helpers_.begin (); sv_itr != supervoxel_helpers_.end (); ++sv_itr)
-    {
-      sv_itr->refineNormals ();
-    }
+      helpers.push_back (&(*sv_itr));
+    const int nr_helpers = static_cast<int> (helpers.size ());
+#pragma omp parallel for \
+  default(none) \
+  shared(helpers, nr_helpers) \
+  schedule(dynamic, 16) \
+  num_threads(threads_)
+    for (int h = 0; h < nr_helpers; ++h)
+      helpers[h]->refineNormals ();
     
     reseedSupervoxels ();
     expandSupervoxels (max_depth);
@@ -184,6 +208,21 @@ pcl::SupervoxelClustering<PointT>::prepareForSegmentation ()
   if ( input_->points.empty () )
     return (false);
   
+  //The octree still holds the previous frame: keep its supervoxels if needed, then start from an empty octree
+  if (adjacency_octree_->getLeafCount () > 0)
+  {
+    previous_seeds_.clear ();
+    if (use_previous_seeds_)
+    {
+      previous_seeds_.reserve (supervoxel_helpers_.size ());
+      for (typename HelperListT::const_iterator sv_itr = supervoxel_helpers_.cbegin (); sv_itr != supervoxel_helpers_.cend (); ++sv_itr)
+        previous_seeds_.emplace_back (sv_itr->getLabel (), sv_itr->getXYZ ());
+    }
+    supervoxel_helpers_.clear ();
+    adjacency_octree_.reset (new OctreeAdjacencyT (resolution_));
+    adjacency_octree_->setInputCloud (input_);
+  }
+  
   //Add the new cloud of data to the octree
   //std::cout << "Populating adjacency octree with new cloud \n";
   //double prep_start = timer_.getTime ();
@@ -191,6 +230,7 @@ pcl::SupervoxelClustering<PointT>::prepareForSegmentation ()
        || (!use_default_transform_behaviour_ && use_single_camera_transform_))
       adjacency_octree_->setTransformFunction ([this] (PointT &p) { transformFunction (p); });
 
+  adjacency_octree_->setNumberOfThreads (threads_);
   adjacency_octree_->addPointsFromInputCloud ();
   //double prep_end = timer_.getTime ();
   //std::cout<<"Time elapsed populating octree with next frame ="<<prep_end-prep_start<<" ms\n";
@@ -200,6 +240,9 @@ pcl::SupervoxelClustering<PointT>::prepareForSegmentation ()
   computeVoxelData ();
   //double normals_end = timer_.getTime ();
   //std::cout << "Time elapsed finding normals and pushing into octree ="<<normals_end-normals_start<<" ms\n";
+  
+  voxel_kdtree_.reset (new pcl::search::KdTree<PointT>);
+  voxel_kdtree_->setInputCloud (voxel_centroid_cloud_);
     
   return true;
 }
@@ -219,6 +262,7 @@ pcl::SupervoxelClustering<PointT>::computeVoxelData ()
     //voxel_centroid_cloud_->push_back(new_voxel_data.getPoint ());
     new_voxel_data.idx_ = idx;
   }
+  const int nr_leaves = static_cast<int> (adjacency_octree_->size ());
   
   //If normals were provided
   if (input_normals_)
@@ -226,44 +270,65 @@ pcl::SupervoxelClustering<PointT>::computeVoxelData ()
     //Verify that input normal cloud size is same as input cloud size
     assert (input_normals_->size () == input_->size ());
     //For every point in the input cloud, find its corresponding leaf
-    typename NormalCloudT::const_iterator normal_itr = input_normals_->begin ();
-    for (typename PointCloudT::const_iterator input_itr = input_->begin (); input_itr != input_->end (); ++input_itr, ++normal_itr)
+    const int nr_points = static_cast<int> (input_->size ());
+    std::vector<LeafContainerT*> point_leaves (nr_points, nullptr);
+#pragma omp parallel for \
+  default(none) \
+  shared(nr_points, point_leaves) \
+  schedule(static) \
+  num_threads(threads_)
+    for (int i = 0; i < nr_points; ++i)
     {
-      //If the point is not finite we ignore it
-      if ( !pcl::isFinite<PointT> (*input_itr))
+      //If the point is not finite we ignore it, otherwise look up its leaf container
+      if (pcl::isFinite<PointT> ((*input_)[i]))
+        point_leaves[i] = adjacency_octree_->getLeafContainerAtPoint ((*input_)[i]);
+    }
+    //Add the normals in the order of the points (we will normalize at the end)
+    for (int i = 0; i < nr_points; ++i)
+    {
+      if (!point_leaves[i])
         continue;
-      //Otherwise look up its leaf container
-      LeafContainerT* leaf = adjacency_octree_->getLeafContainerAtPoint (*input_itr);
-
       //Get the voxel data object
-      VoxelData& voxel_data = leaf->getData ();
-      //Add this normal in (we will normalize at the end)
-      voxel_data.normal_ += normal_itr->getNormalVector4fMap ();
-      voxel_data.curvature_ += normal_itr->curvature;
+      VoxelData& voxel_data = point_leaves[i]->getData ();
+      voxel_data.normal_ += (*input_normals_)[i].getNormalVector4fMap ();
+      voxel_data.curvature_ += (*input_normals_)[i].curvature;
     }
     //Now iterate through the leaves and normalize 
-    for (leaf_itr = adjacency_octree_->begin (); leaf_itr != adjacency_octree_->end (); ++leaf_itr)
+#pragma omp parallel for \
+  default(none) \
+  shared(nr_leaves) \
+  schedule(static) \
+  num_threads(threads_)
+    for (int idx = 0; idx < nr_leaves; ++idx)
     {
-      VoxelData& voxel_data = (*leaf_itr)->getData ();
+      LeafContainerT* leaf = adjacency_octree_->at (idx);
+      VoxelData& voxel_data = leaf->getData ();
       voxel_data.normal_.normalize ();
       voxel_data.owner_ = nullptr;
       voxel_data.distance_ = std::numeric_limits<float>::max ();
       //Get the number of points in this leaf
-      int num_points = (*leaf_itr)->getPointCounter ();
+      int num_points = leaf->getPointCounter ();
       voxel_data.curvature_ /= num_points;
     }
   }
   else //Otherwise just compute the normals
   {
-    for (leaf_itr = adjacency_octree_->begin (); leaf_itr != adjacency_octree_->end (); ++leaf_itr)
+    //Every leaf only writes its own data, the centroid cloud is read only
+#pragma omp parallel for \
+  default(none) \
+  shared(nr_leaves) \
+  schedule(dynamic, 64) \
+  num_threads(threads_)
+    for (int idx = 0; idx < nr_leaves; ++idx)
     {
-      VoxelData& new_voxel_data = (*leaf_itr)->getData ();
+      LeafContainerT* leaf = adjacency_octree_->at (idx);
+      VoxelData& new_voxel_data = leaf->getData ();
       //For every point, get its neighbors, build an index vector, compute normal
       std::vector<int> indices;
       indices.reserve (81); 
       //Push this point
       indices.push_back (new_voxel_data.idx_);
-      for (typename LeafContainerT::const_iterator neighb_itr=(*leaf_itr)->cbegin (); neighb_itr!=(*leaf_itr)->cend (); ++neighb_itr)
+      for (typename LeafContainerT::const_iterator neighb_itr=leaf->cbegin (); neighb_itr!=leaf->cend (); ++neighb_itr)
       {
         VoxelData& neighb_voxel_data = (*neighb_itr)->getData ();
         //Push neighbor index
@@ -302,7 +367,9 @@ pcl::SupervoxelClustering<PointT>::expandSupervoxels ( int depth )
         sv_itr->expand ();
       }
       
-      //Update the centers to reflect new centers
+      //Remove the supervoxels which lost all their voxels
+      std::vector<SupervoxelHelper*> helpers;
+      helpers.reserve (supervoxel_helpers_.size ());
       for (typename HelperListT::iterator sv_itr = supervoxel_helpers_.begin (); sv_itr != supervoxel_helpers_.end (); )
       {
         if (sv_itr->size () == 0)
@@ -311,10 +378,20 @@ pcl::SupervoxelClustering<PointT>::expandSupervoxels ( int depth )
         }
         else
         {
-          sv_itr->updateCentroid ();
+          helpers.push_back (&(*sv_itr));
           ++sv_itr;
         } 
       }
+      
+      //Update the centers to reflect new centers
+      const int nr_helpers = static_cast<int> (helpers.size ());
+#pragma omp parallel for \
+  default(none) \
+  shared(helpers, nr_helpers) \
+  schedule(dynamic, 16) \
+  num_threads(threads_)
+      for (int h = 0; h < nr_helpers; ++h)
+        helpers[h]->updateCentroid ();
 
   }
 
@@ -341,12 +418,23 @@ pcl::SupervoxelClustering<PointT>::makeSupervoxels (std::map<std::uint32_t,typen
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT> void
 pcl::SupervoxelClustering<PointT>::createSupervoxelHelpers (std::vector<int> &seed_indices)
+{
+  
+  std::vector<std::uint32_t> seed_labels (seed_indices.size ());
+  for (std::size_t i = 0; i < seed_indices.size (); ++i)
+    seed_labels[i] = static_cast<std::uint32_t> (i+1);
+  createSupervoxelHelpers (seed_indices, seed_labels);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::SupervoxelClustering<PointT>::createSupervoxelHelpers (const std::vector<int> &seed_indices, const std::vector<std::uint32_t> &seed_labels)
 {
   
   supervoxel_helpers_.clear ();
   for (std::size_t i = 0; i < seed_indices.size (); ++i)
   {
-    supervoxel_helpers_.push_back (new SupervoxelHelper(i+1,this));
+    supervoxel_helpers_.push_back (new SupervoxelHelper(seed_labels[i],this));
     //Find which leaf corresponds to this seed index
     LeafContainerT* seed_leaf = adjacency_octree_->at(seed_indices[i]);//adjacency_octree_->getLeafContainerAtPoint (seed_points[i]);
     if (seed_leaf)
@@ -380,44 +468,111 @@ pcl::SupervoxelClustering<PointT>::selectInitialSupervoxelSeeds (std::vector<int
   std::vector<int> seed_indices_orig;
   seed_indices_orig.resize (num_seeds, 0);
   seed_indices.clear ();
-  std::vector<int> closest_index;
-  std::vector<float> distance;
-  closest_index.resize(1,0);
-  distance.resize(1,0);
-  if (!voxel_kdtree_)
+  
+  float search_radius = 0.5f*seed_resolution_;
+  // This is 1/20th of the number of voxels which fit in a planar slice through search volume
+  // Area of planar slice / area of voxel side. (Note: This is smaller than the value mentioned in the original paper)
+  float min_points = 0.05f * (search_radius)*(search_radius) * 3.1415926536f  / (resolution_*resolution_);
+  // The searches are independent, the seeds which pass the density check are collected in order afterwards
+  std::vector<std::uint8_t> is_dense (num_seeds, 0);
+#pragma omp parallel \
+  default(none) \
+  shared(num_seeds, voxel_centers, seed_indices_orig, is_dense, search_radius, min_points) \
+  num_threads(threads_)
   {
-    voxel_kdtree_.reset (new pcl::search::KdTree<PointT>);
-    voxel_kdtree_ ->setInputCloud (voxel_centroid_cloud_);
+    std::vector<int> closest_index (1, 0);
+    std::vector<float> distance (1, 0);
+    std::vector<int> neighbors;
+    std::vector<float> sqr_distances;
+#pragma omp for schedule(dynamic, 16)
+    for (int i = 0; i < num_seeds; ++i)  
+    {
+      voxel_kdtree_->nearestKSearch (voxel_centers[i], 1, closest_index, distance);
+      seed_indices_orig[i] = closest_index[0];
+      int num = voxel_kdtree_->radiusSearch (seed_indices_orig[i], search_radius , neighbors, sqr_distances);
+      is_dense[i] = (num > min_points);
+    }
   }
   
-  for (int i = 0; i < num_seeds; ++i)  
+  seed_indices.reserve (seed_indices_orig.size ());
+  for (int i = 0; i < num_seeds; ++i)
   {
-    voxel_kdtree_->nearestKSearch (voxel_centers[i], 1, closest_index, distance);
-    seed_indices_orig[i] = closest_index[0];
+    if (is_dense[i])
+      seed_indices.push_back (seed_indices_orig[i]);
   }
+ // std::cout << "Number of seed points after filtering="<<seed_points.size ()<<std::endl;
   
-  std::vector<int> neighbors;
-  std::vector<float> sqr_distances;
-  seed_indices.reserve (seed_indices_orig.size ());
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::SupervoxelClustering<PointT>::selectPreviousSupervoxelSeeds (std::vector<int> &seed_indices, std::vector<std::uint32_t> &seed_labels)
+{
+  //The regular seeds, used where no previous supervoxel is left
+  std::vector<int> grid_seed_indices;
+  selectInitialSupervoxelSeeds (grid_seed_indices);
+  
+  seed_indices.clear ();
+  seed_labels.clear ();
   float search_radius = 0.5f*seed_resolution_;
-  // This is 1/20th of the number of voxels which fit in a planar slice through search volume
-  // Area of planar slice / area of voxel side. (Note: This is smaller than the value mentioned in the original paper)
+  //Same density check as for the regular seeds
   float min_points = 0.05f * (search_radius)*(search_radius) * 3.1415926536f  / (resolution_*resolution_);
-  for (const int &index_orig : seed_indices_orig)
+  
+  //Find the voxel closest to each previous centroid, and the voxels around it
+  const int nr_previous = static_cast<int> (previous_seeds_.size ());
+  std::vector<int> previous_leaves (nr_previous, -1);
+  std::vector<std::vector<int> > previous_neighbors (nr_previous);
+#pragma omp parallel \
+  default(none) \
+  shared(nr_previous, previous_leaves, previous_neighbors, search_radius, min_points) \
+  num_threads(threads_)
   {
-    int num = voxel_kdtree_->radiusSearch (index_orig, search_radius , neighbors, sqr_distances);
-    int min_index = index_orig;
-    if ( num > min_points)
+    std::vector<int> closest_index (1, 0);
+    std::vector<float> distance (1, 0);
+    std::vector<float> sqr_distances;
+#pragma omp for schedule(dynamic, 16)
+    for (int i = 0; i < nr_previous; ++i)
     {
-      seed_indices.push_back (min_index);
+      PointT point;
+      point.x = previous_seeds_[i].second[0];
+      point.y = previous_seeds_[i].second[1];
+      point.z = previous_seeds_[i].second[2];
+      //The supervoxel left the scene
+      if (voxel_kdtree_->nearestKSearch (point, 1, closest_index, distance) < 1 || distance[0] > search_radius*search_radius)
+        continue;
+      int num = voxel_kdtree_->radiusSearch (closest_index[0], search_radius, previous_neighbors[i], sqr_distances);
+      if (num > min_points)
+        previous_leaves[i] = closest_index[0];
     }
-    
   }
- // std::cout << "Number of seed points after filtering="<<seed_points.size ()<<std::endl;
   
+  //Keep the previous supervoxels with their labels, two of them can't share the same seed
+  std::vector<bool> is_covered (voxel_centroid_cloud_->size (), false);
+  std::vector<bool> is_seed (voxel_centroid_cloud_->size (), false);
+  std::uint32_t max_label = 0;
+  for (int i = 0; i < nr_previous; ++i)
+  {
+    max_label = std::max (max_label, previous_seeds_[i].first);
+    if (previous_leaves[i] < 0 || is_seed[previous_leaves[i]])
+      continue;
+    is_seed[previous_leaves[i]] = true;
+    seed_indices.push_back (previous_leaves[i]);
+    seed_labels.push_back (previous_seeds_[i].first);
+    for (const int &neighbor : previous_neighbors[i])
+      is_covered[neighbor] = true;
+  }
+  
+  //New labels for the regular seeds in the regions none of the previous supervoxels covers
+  for (const int &index : grid_seed_indices)
+  {
+    if (is_covered[index])
+      continue;
+    seed_indices.push_back (index);
+    seed_labels.push_back (++max_label);
+  }
 }
 
-
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT> void
 pcl::SupervoxelClustering<PointT>::reseedSupervoxels ()
@@ -428,19 +583,38 @@ pcl::SupervoxelClustering<PointT>::reseedSupervoxels ()
     sv_itr->removeAllLeaves ();
   }
   
-  std::vector<int> closest_index;
-  std::vector<float> distance;
-  //Now go through each supervoxel, find voxel closest to its center, add it in
+  std::vector<SupervoxelHelper*> helpers;
+  helpers.reserve (supervoxel_helpers_.size ());
   for (typename HelperListT::iterator sv_itr = supervoxel_helpers_.begin (); sv_itr != supervoxel_helpers_.end (); ++sv_itr)
+    helpers.push_back (&(*sv_itr));
+  
+  //Now go through each supervoxel, find voxel closest to its center
+  const int nr_helpers = static_cast<int> (helpers.size ());
+  std::vector<int> closest_leaves (nr_helpers);
+#pragma omp parallel \
+  default(none) \
+  shared(helpers, nr_helpers, closest_leaves) \
+  num_threads(threads_)
   {
-    PointT point;
-    sv_itr->getXYZ (point.x, point.y, point.z);
-    voxel_kdtree_->nearestKSearch (point, 1, closest_index, distance);
-    
-    LeafContainerT* seed_leaf = adjacency_octree_->at (closest_index[0]);
+    std::vector<int> closest_index (1, 0);
+    std::vector<float> distance (1, 0);
+#pragma omp for schedule(dynamic, 16)
+    for (int h = 0; h < nr_helpers; ++h)
+    {
+      PointT point;
+      helpers[h]->getXYZ (point.x, point.y, point.z);
+      voxel_kdtree_->nearestKSearch (point, 1, closest_index, distance);
+      closest_leaves[h] = closest_index[0];
+    }
+  }
+  
+  //And add it in, in the order of the supervoxels
+  for (int h = 0; h < nr_helpers; ++h)
+  {
+    LeafContainerT* seed_leaf = adjacency_octree_->at (closest_leaves[h]);
     if (seed_leaf)
     {
-      sv_itr->addLeaf (seed_leaf);
+      helpers[h]->addLeaf (seed_leaf);
     }
     else
     {
@@ -678,6 +852,41 @@ pcl::SupervoxelClustering<PointT>::setUseSingleCameraTransform (bool val)
   use_single_camera_transform_ = val;
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::SupervoxelClustering<PointT>::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs ();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> unsigned int
+pcl::SupervoxelClustering<PointT>::getNumberOfThreads () const
+{
+  return (threads_);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::SupervoxelClustering<PointT>::setUsePreviousSeeds (bool val)
+{
+  use_previous_seeds_ = val;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> bool
+pcl::SupervoxelClustering<PointT>::getUsePreviousSeeds () const
+{
+  return (use_previous_seeds_);
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT> int
 pcl::SupervoxelClustering<PointT>::getMaxLabel () const
@@ -0,0 +1,180 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved
+ */
+
+#pragma once
+
+#include <pcl/pcl_macros.h>
+
+#include <deque>
+#include <vector>
+
+namespace pcl
+{
+  namespace segmentation
+  {
+    /** \brief @b IncrementalMaxFlow computes the maximum flow / minimum cut of a graph with the algorithm of
+      * Boykov and Kolmogorov ("An Experimental Comparison of Min-Cut/Max-Flow Algorithms for Energy
+      * Minimization in Vision", 2004), on a graph stored in flat arrays.
+      *
+      * Once solved, the terminal (source and sink) weights of the nodes can be changed and the graph solved
+      * again: the flow and the search trees of the previous solution are kept and only repaired around the
+      * nodes that changed, as in the dynamic graph cuts of Kohli and Torr ("Dynamic Graph Cuts for Efficient
+      * Inference in Markov Random Fields", 2007). Changing the weights of the edges between the nodes
+      * requires to build the graph again.
+      *
+      * Usage: \ref reset, \ref addEdge for every edge, \ref setTerminalWeights for the nodes connected to
+      * the terminals, then \ref solve; later \ref setTerminalWeights and \ref solve again.
+      */
+    class PCL_EXPORTS IncrementalMaxFlow
+    {
+      public:
+        /** \brief Constructor. */
+        IncrementalMaxFlow ();
+
+        /** \brief Remove the edges and the results, and allocate the given number of nodes.
+          * \param[in] number_of_nodes the number of nodes of the graph
+          */
+        void
+        reset (int number_of_nodes);
+
+        /** \brief Get the number of nodes of the graph. */
+        int
+        getNumberOfNodes () const { return (static_cast<int> (tr_cap_.size ())); }
+
+        /** \brief Add an edge between two nodes. Only allowed before the first call to \ref solve after \ref reset.
+          * \param[in] u the first node
+          * \param[in] v the second node
+          * \param[in] cap_uv the capacity from u to v
+          * \param[in] cap_vu the capacity from v to u
+          */
+        void
+        addEdge (int u, int v, double cap_uv, double cap_vu);
+
+        /** \brief Set the capacities of the edges from the source to a node and from the node to the sink.
+          * \param[in] u the node
+          * \param[in] source_cap the capacity of the edge from the source
+          * \param[in] sink_cap the capacity of the edge to the sink
+          */
+        void
+        setTerminalWeights (int u, double source_cap, double sink_cap);
+
+        /** \brief Compute the maximum flow, starting from the previous solution if there is one.
+          * \return the value of the maximum flow
+          */
+        double
+        solve ();
+
+        /** \brief Get the value of the last maximum flow. */
+        double
+        getFlow () const { return (flow_); }
+
+        /** \brief Return true if the node is reachable from the source in the residual graph, i.e. it lies on
+          * the source side of the (smallest) minimum cut.
+          * \param[in] u the node
+          */
+        bool
+        inSourceSet (int u) const { return (parent_[u] != NONE && !is_sink_[u]); }
+
+      private:
+        /** \brief Sort the edges added with addEdge by node and set their sister arcs. */
+        void
+        buildArcs ();
+
+        /** \brief Initialize the search trees from the terminal capacities. */
+        void
+        initializeTrees ();
+
+        /** \brief Repair the search trees of the previous solution around the nodes whose weights changed. */
+        void
+        reuseTrees ();
+
+        /** \brief Grow the search trees and augment the paths found until no active node is left. */
+        void
+        expandTrees ();
+
+        /** \brief Push the bottleneck flow along the path through the given arc between the two trees. */
+        void
+        augment (int middle_arc);
+
+        /** \brief Find a new parent for the orphans or free them. */
+        void
+        adoptOrphans ();
+
+        /** \brief Find a new parent for an orphan or free it. */
+        void
+        processOrphan (int u);
+
+        /** \brief Mark a node as active. */
+        inline void
+        setActive (int u)
+        {
+          if (!in_queue_[u])
+          {
+            in_queue_[u] = true;
+            active_.push_back (u);
+          }
+        }
+
+        /** \brief Parent of a node in one of the trees: an arc to the parent, or one of these states. */
+        static constexpr int NONE = -1;
+        static constexpr int TERMINAL = -2;
+        static constexpr int ORPHAN = -3;
+
+        /** \brief Distance of the nodes whose origin is not known. */
+        static constexpr int INFINITE_DISTANCE = 1 << 30;
+
+        /** \brief The first arc of every node (and the end of the last one). */
+        std::vector<int> first_arc_;
+
+        /** \brief The node at the end of every arc. */
+        std::vector<int> head_;
+
+        /** \brief The arc in the opposite direction of every arc. */
+        std::vector<int> sister_;
+
+        /** \brief The residual capacity of every arc. */
+        std::vector<double> r_cap_;
+
+        /** \brief The edges (u, v, cap_uv, cap_vu) added before the arcs are built. */
+        std::vector<int> edge_nodes_;
+        std::vector<double> edge_caps_;
+
+        /** \brief Residual capacity from the source (positive) or to the sink (negative) of every node. */
+        std::vector<double> tr_cap_;
+
+        /** \brief The terminal weights set for every node. */
+        std::vector<double> source_caps_;
+        std::vector<double> sink_caps_;
+
+        /** \brief The search trees, with the time stamp and the distance to the terminal of the heuristics. */
+        std::vector<int> parent_;
+        std::vector<bool> is_sink_;
+        std::vector<int> time_stamp_;
+        std::vector<int> distance_;
+        int time_;
+
+        /** \brief The active nodes. */
+        std::deque<int> active_;
+        std::vector<bool> in_queue_;
+
+        /** \brief The orphans waiting for a new parent. */
+        std::deque<int> orphans_;
+
+        /** \brief The nodes whose weights changed since the last solve. */
+        std::vector<int> changed_;
+        std::vector<bool> is_changed_;
+
+        /** \brief Whether there is a previous solution to start from. */
+        bool solved_;
+
+        /** \brief The value of the flow. */
+        double flow_;
+    };
+  }
+}
@@ -245,6 +245,19 @@ namespace pcl
         min_segment_size_ = min_segment_size_arg;
       }
 
+      /** \brief Set the number of threads used to classify the connections (and by \ref CPCSegmentation to search the cutting planes)
+       *  \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+       *  \note The segmentation does not depend on the number of threads. */
+      void
+      setNumberOfThreads (unsigned int nr_threads = 0);
+
+      /** \brief Get the number of threads used by the segmentation */
+      inline unsigned int
+      getNumberOfThreads () const
+      {
+        return (threads_);
+      }
+
     protected:
 
       /** \brief Segments smaller than \ref min_segment_size_ are merged to the label of largest neighbor */
@@ -262,6 +275,11 @@ namespace pcl
       prepareSegmentation (const std::map<std::uint32_t, typename pcl::Supervoxel<PointT>::Ptr> &supervoxel_clusters_arg,
                            const std::multimap<std::uint32_t, std::uint32_t> &label_adjacency_arg);
 
+      /** \brief Builds the flat (compressed sparse row) copy of \ref sv_adjacency_list_ used by \ref applyKconvexity and \ref doGrouping.
+       *  Is called within \ref prepareSegmentation, the structure of the graph does not change afterwards. */
+      void
+      computeFlatAdjacency ();
+
 
       /** Perform depth search on the graph and recursively group all supervoxels with convex connections
        *  \note The vertices in the supervoxel adjacency list are the supervoxel centroids */
@@ -327,6 +345,9 @@ namespace pcl
       /** \brief Minimum segment size */
       std::uint32_t min_segment_size_;
 
+      /** \brief The number of threads the scheduler should use */
+      unsigned int threads_;
+
       /** \brief Stores which supervoxel labels were already visited during recursive grouping.
        *  \note processed_[sv_Label] = false (default)/true (already processed) */
       std::map<std::uint32_t, bool> processed_;
@@ -334,6 +355,18 @@ namespace pcl
       /** \brief Adjacency graph with the supervoxel labels as nodes and edges between adjacent supervoxels */
       SupervoxelAdjacencyList sv_adjacency_list_;
 
+      /** \brief The vertices of \ref sv_adjacency_list_ in the order of boost::vertices, their position in this vector is used by the flat adjacency */
+      std::vector<VertexID> sv_vertices_;
+
+      /** \brief The neighbors of the vertex at position i are stored from sv_neighbor_offsets_[i] to sv_neighbor_offsets_[i+1] in \ref sv_neighbors_ and \ref sv_neighbor_edges_ */
+      std::vector<std::size_t> sv_neighbor_offsets_;
+
+      /** \brief Positions of the neighbors of each vertex, sorted increasingly */
+      std::vector<std::size_t> sv_neighbors_;
+
+      /** \brief The edge connecting each vertex to each of its neighbors in \ref sv_neighbors_ */
+      std::vector<EdgeID> sv_neighbor_edges_;
+
       /** \brief map from the supervoxel labels to the supervoxel objects  */
       std::map<std::uint32_t, typename pcl::Supervoxel<PointT>::Ptr> sv_label_to_supervoxel_map_;
 
@@ -39,6 +39,7 @@
 #pragma once
 
 #include <pcl/segmentation/boost.h>
+#include <pcl/segmentation/incremental_max_flow.h>
 #include <pcl/memory.h>
 #include <pcl/pcl_base.h>
 #include <pcl/pcl_macros.h>
@@ -200,11 +201,25 @@ namespace pcl
       void
       extract (std::vector <pcl::PointIndices>& clusters);
 
+      /** \brief Allows to solve the minimum cut on a graph stored in flat arrays, whose flow is kept between the calls
+        * to \ref extract. When only the foreground points (or the other unary potentials) change, the next
+        * extraction starts from the previous flow and search trees instead of solving the whole graph again,
+        * which makes the interactive segmentation much faster. The object then consists of the points on the source
+        * side of the minimum cut, and \ref getGraph does not return the graph used for the segmentation.
+        * \param[in] use_incremental_max_flow whether to use the incremental max flow (disabled by default)
+        */
+      void
+      setUseIncrementalMaxFlow (bool use_incremental_max_flow);
+
+      /** \brief Returns whether the incremental max flow is used. */
+      bool
+      getUseIncrementalMaxFlow () const;
+
       /** \brief Returns that flow value that was calculated during the segmentation. */
       double
       getMaxFlow () const;
 
-      /** \brief Returns the graph that was build for finding the minimum cut. */
+      /** \brief Returns the graph that was build for finding the minimum cut (unless the incremental max flow is used). */
       mGraphPtr
       getGraph () const;
 
@@ -257,6 +272,16 @@ namespace pcl
       void
       assembleLabels (ResidualCapacityMap& residual_capacity);
 
+      /** \brief This method builds the flat graph of the incremental max flow.
+        * \param[in] search_neighbours whether to search the neighbours again or to keep the edges of the previous graph
+        */
+      bool
+      buildIncrementalGraph (bool search_neighbours);
+
+      /** \brief This method updates the unary potentials(data cost) of the incremental max flow, keeping its flow. */
+      void
+      recalculateIncrementalUnaryPotentials ();
+
     protected:
 
       /** \brief Stores the sigma coefficient. It is used for finding smooth costs. More information can be found in the article. */
@@ -319,6 +344,15 @@ namespace pcl
       /** \brief Stores the maximum flow value that was calculated during the segmentation. */
       double max_flow_;
 
+      /** \brief Signalizes if the incremental max flow is used instead of the boost graph. */
+      bool use_incremental_max_flow_;
+
+      /** \brief Stores the flat graph and the flow of the incremental max flow. Its nodes are the positions in the indices. */
+      pcl::segmentation::IncrementalMaxFlow incremental_max_flow_;
+
+      /** \brief Stores the pairs of neighbouring nodes of the incremental max flow. */
+      std::vector<std::pair<int, int> > incremental_edges_;
+
     public:
       PCL_MAKE_ALIGNED_OPERATOR_NEW
   };
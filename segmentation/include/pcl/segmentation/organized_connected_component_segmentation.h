@@ -80,6 +80,7 @@ namespace pcl
         */
       OrganizedConnectedComponentSegmentation (const ComparatorConstPtr& compare)
         : compare_ (compare)
+        , threads_ (1)
       {
       }
 
@@ -102,12 +103,37 @@ namespace pcl
       ComparatorConstPtr
       getComparator () const { return (compare_); }
 
+      /** \brief Set the number of threads to use.
+        * \details With more than one thread the image is split into bands of rows which are labeled
+        * concurrently and merged afterwards: the comparator is then called from several threads at once.
+        * The labels are the same as the ones of the single threaded segmentation.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      void
+      setNumberOfThreads (unsigned int nr_threads = 0);
+
+      /** \brief Get the number of threads to use. */
+      unsigned int
+      getNumberOfThreads () const { return (threads_); }
+
       /** \brief Perform the connected component segmentation.
         * \param[out] labels a PointCloud of labels: each connected component will have a unique id.
         * \param[out] label_indices a vector of PointIndices corresponding to each label / component id.
         */
       void
       segment (pcl::PointCloud<PointLT>& labels, std::vector<pcl::PointIndices>& label_indices) const;
+
+      /** \brief Perform the connected component segmentation with a comparator whose type is known at compile time.
+        * \details The comparator is called as compare.ComparatorT::compare (idx1, idx2), which the compiler can
+        * inline instead of going through the virtual call of the comparator set with setComparator, which is ignored.
+        * ComparatorT has to be the actual type of compare, otherwise the overrides of its derived classes are skipped.
+        * This member template is defined in impl/organized_connected_component_segmentation.hpp.
+        * \param[in] compare the comparator
+        * \param[out] labels a PointCloud of labels: each connected component will have a unique id.
+        * \param[out] label_indices a vector of PointIndices corresponding to each label / component id.
+        */
+      template <typename ComparatorT> void
+      segment (const ComparatorT& compare, pcl::PointCloud<PointLT>& labels, std::vector<pcl::PointIndices>& label_indices) const;
       
       /** \brief Find the boundary points / contour of a connected component
         * \param[in] start_idx the first (lowest) index of the connected component for which a boundary should be returned
@@ -120,6 +146,9 @@ namespace pcl
 
     protected:
       ComparatorConstPtr compare_;
+
+      /** \brief The number of threads the scheduler should use. */
+      unsigned int threads_;
       
       inline unsigned
       findRoot (const std::vector<unsigned>& runs, unsigned index) const
@@ -132,6 +161,22 @@ namespace pcl
       }
 
     private:
+      /** \brief Label the components one pixel after the other, merging the runs of the rows below with a union-find.
+        * \param[in] compare a functor returning whether two (neighboring) points belong to the same component
+        * \param[out] labels the label cloud
+        * \param[out] label_indices the indices of each label
+        */
+      template <typename CompareFunctor> void
+      segmentSerial (const CompareFunctor& compare, pcl::PointCloud<PointLT>& labels, std::vector<pcl::PointIndices>& label_indices) const;
+
+      /** \brief Label the components of bands of rows concurrently and merge them along the borders of the bands.
+        * \param[in] compare a functor returning whether two (neighboring) points belong to the same component
+        * \param[out] labels the label cloud
+        * \param[out] label_indices the indices of each label
+        */
+      template <typename CompareFunctor> void
+      segmentParallel (const CompareFunctor& compare, pcl::PointCloud<PointLT>& labels, std::vector<pcl::PointIndices>& label_indices) const;
+
       struct Neighbor
       {
         Neighbor (int dx, int dy, int didx)
@@ -0,0 +1,204 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved
+ */
+
+#pragma once
+
+#include <pcl/pcl_base.h>
+#include <pcl/point_cloud.h>
+#include <pcl/point_types.h>
+
+#include <vector>
+
+namespace pcl
+{
+  /** \brief
+    * Implements a ground segmentation for rotating multi-beam LiDARs (e.g. the clouds of pcl::HDLGrabber and
+    * pcl::VLPGrabber), described in the article
+    * "Fast Segmentation of 3D Point Clouds for Ground Vehicles"
+    * by M. Himmelsbach, F. v. Hundelshausen and H.-J. Wuensche.
+    *
+    * The plane around the sensor is divided in a polar grid of angular segments and radial bins. In every
+    * segment the lowest point of every bin is kept, and lines are fitted incrementally to these points in order
+    * of range, starting from the ground below the sensor. A point is a ground return if it lies close to the
+    * line fitted to its bin. The sensor is at the origin, with the z axis pointing up.
+    *
+    * Since every segment is segmented independently of the others, the points can be given as a full sweep
+    * with \ref extract, or in streaming fashion as the scans (packets) of the sensor arrive with \ref addScan:
+    * a segment is segmented as soon as a scan does not bring points to it any more, i.e. one scan after the
+    * sensor moved past it.
+    */
+  template <typename PointT>
+  class PCL_EXPORTS PolarGridGroundSegmentation : public pcl::PCLBase<PointT>
+  {
+    public:
+
+      using PointCloud = pcl::PointCloud<PointT>;
+      using PointCloudConstPtr = typename PointCloud::ConstPtr;
+
+      using PCLBase <PointT>::input_;
+      using PCLBase <PointT>::indices_;
+      using PCLBase <PointT>::initCompute;
+      using PCLBase <PointT>::deinitCompute;
+
+    public:
+
+      /** \brief Constructor that sets default values for member variables. */
+      PolarGridGroundSegmentation ();
+
+      /** \brief Get the height of the sensor above the ground. */
+      inline float
+      getSensorHeight () const { return (sensor_height_); }
+
+      /** \brief Set the height of the sensor above the ground. */
+      inline void
+      setSensorHeight (float sensor_height) { sensor_height_ = sensor_height; }
+
+      /** \brief Get the number of angular segments of the grid. */
+      inline int
+      getNumberOfSegments () const { return (number_of_segments_); }
+
+      /** \brief Set the number of angular segments of the grid. Resets the points waiting in \ref addScan. */
+      inline void
+      setNumberOfSegments (int number_of_segments) { number_of_segments_ = number_of_segments; reset (); }
+
+      /** \brief Get the number of radial bins of every segment. */
+      inline int
+      getNumberOfBins () const { return (number_of_bins_); }
+
+      /** \brief Set the number of radial bins of every segment. */
+      inline void
+      setNumberOfBins (int number_of_bins) { number_of_bins_ = number_of_bins; }
+
+      /** \brief Get the range of the grid: the points further from the sensor are not ground returns. */
+      inline float
+      getMaxRange () const { return (max_range_); }
+
+      /** \brief Set the range of the grid: the points further from the sensor are not ground returns. */
+      inline void
+      setMaxRange (float max_range) { max_range_ = max_range; }
+
+      /** \brief Get the maximum slope of a ground line. */
+      inline float
+      getMaxSlope () const { return (max_slope_); }
+
+      /** \brief Set the maximum slope of a ground line. */
+      inline void
+      setMaxSlope (float max_slope) { max_slope_ = max_slope; }
+
+      /** \brief Get the maximum root mean square distance of the lowest points of the bins to their line. */
+      inline float
+      getMaxFitError () const { return (max_fit_error_); }
+
+      /** \brief Set the maximum root mean square distance of the lowest points of the bins to their line. */
+      inline void
+      setMaxFitError (float max_fit_error) { max_fit_error_ = max_fit_error; }
+
+      /** \brief Get the maximum height difference between the start of a line and the ground before it. */
+      inline float
+      getMaxStartHeight () const { return (max_start_height_); }
+
+      /** \brief Set the maximum height difference between the start of a line and the ground before it (the
+        * previous line, or the ground below the sensor for the first line).
+        */
+      inline void
+      setMaxStartHeight (float max_start_height) { max_start_height_ = max_start_height; }
+
+      /** \brief Get the maximum distance to the line of its bin for a point to be considered a ground return. */
+      inline float
+      getMaxDistance () const { return (max_distance_); }
+
+      /** \brief Set the maximum distance to the line of its bin for a point to be considered a ground return. */
+      inline void
+      setMaxDistance (float max_distance) { max_distance_ = max_distance; }
+
+      /** \brief This method launches the segmentation algorithm on the input cloud and returns indices of
+        * points determined to be ground returns.
+        * \param[out] ground indices of points determined to be ground returns.
+        */
+      virtual void
+      extract (std::vector<int>& ground);
+
+      /** \brief Add a scan (e.g. from the scan callbacks of pcl::HDLGrabber) to the stream of points, and return
+        * the points of the segments which are complete, i.e. which the scan did not bring points to.
+        * \param[in] scan the points of the scan
+        * \param[out] ground the ground returns of the completed segments
+        * \param[out] non_ground the other points of the completed segments
+        */
+      void
+      addScan (const PointCloudConstPtr &scan, PointCloud &ground, PointCloud &non_ground);
+
+      /** \brief Segment the points waiting in the segments which are not complete yet, e.g. at the end of a
+        * sweep or of the stream.
+        * \param[out] ground the ground returns of these segments
+        * \param[out] non_ground the other points of these segments
+        */
+      void
+      flush (PointCloud &ground, PointCloud &non_ground);
+
+      /** \brief Remove the points waiting in \ref addScan. */
+      void
+      reset ();
+
+    protected:
+
+      /** \brief Get the segment of a point, or -1 if the point is not finite or out of the range of the grid. */
+      int
+      getSegment (const PointT &point) const;
+
+      /** \brief Find the ground lines of a segment and mark its points which are ground returns.
+        * \param[in] points the points of the cloud
+        * \param[in] indices the points of the segment in the cloud
+        * \param[out] is_ground whether each of these points is a ground return
+        */
+      void
+      segmentSegment (const typename PointCloud::VectorType &points, const std::vector<int> &indices,
+                      std::vector<bool> &is_ground) const;
+
+      /** \brief Segment the points waiting in a segment and empty it. */
+      void
+      flushSegment (int segment, PointCloud &ground, PointCloud &non_ground);
+
+      /** \brief Height of the sensor above the ground. */
+      float sensor_height_;
+
+      /** \brief Number of angular segments of the grid. */
+      int number_of_segments_;
+
+      /** \brief Number of radial bins of every segment. */
+      int number_of_bins_;
+
+      /** \brief Range of the grid. */
+      float max_range_;
+
+      /** \brief Maximum slope of a ground line. */
+      float max_slope_;
+
+      /** \brief Maximum root mean square distance of the lowest points of the bins to their line. */
+      float max_fit_error_;
+
+      /** \brief Maximum height difference between the start of a line and the ground before it. */
+      float max_start_height_;
+
+      /** \brief Maximum distance to the line of its bin for a point to be considered a ground return. */
+      float max_distance_;
+
+      /** \brief The points of every segment waiting in \ref addScan. */
+      std::vector<typename PointCloud::VectorType> pending_;
+
+      /** \brief The last scan that brought points to every segment. */
+      std::vector<unsigned int> last_scan_;
+
+      /** \brief The number of scans added. */
+      unsigned int scan_count_;
+  };
+}
+
+#ifdef PCL_NO_PRECOMPILE
+#include <pcl/segmentation/impl/polar_grid_ground_segmentation.hpp>
+#endif
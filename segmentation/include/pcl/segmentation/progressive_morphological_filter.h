@@ -128,6 +128,13 @@ namespace pcl
       inline void
       setExponential (bool exponential) { exponential_ = exponential; }
 
+      /** \brief Initialize the scheduler and set the number of threads to use.
+        * The ground returns do not depend on the number of threads.
+        * \param nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      inline void
+      setNumberOfThreads (unsigned int nr_threads = 0) { threads_ = nr_threads; }
+
       /** \brief This method launches the segmentation algorithm and returns indices of
         * points determined to be ground returns.
         * \param[out] ground indices of points determined to be ground returns.
@@ -137,6 +144,16 @@ namespace pcl
 
     protected:
 
+      /** \brief Apply a morphological opening to the heights of the points, as pcl::applyMorphologicalOperator
+        * with MORPH_OPEN does: the erosion and then the dilation take the lowest, then the highest point in the
+        * square window centered on every point, the windows being searched in parallel.
+        * \param[in] cloud the points to open
+        * \param[in] window_size the side of the square windows
+        * \param[out] cloud_out the opened points
+        */
+      void
+      applyOpening (const typename PointCloud::ConstPtr &cloud, float window_size, PointCloud &cloud_out) const;
+
       /** \brief Maximum window size to be used in filtering ground returns. */
       int max_window_size_;
 
@@ -157,6 +174,9 @@ namespace pcl
 
       /** \brief Exponentially grow window sizes? */
       bool exponential_;
+
+      /** \brief Number of threads to be used. */
+      unsigned int threads_;
   };
 }
 
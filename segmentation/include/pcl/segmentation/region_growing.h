@@ -202,6 +202,17 @@ namespace pcl
       void
       setInputNormals (const NormalPtr& norm);
 
+      /** \brief Set the number of threads used to search the neighbours of the points. The segments are the same
+        * with any number of threads, as only the searches are run in parallel.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value automatically, default: 1)
+        */
+      void
+      setNumberOfThreads (unsigned int nr_threads);
+
+      /** \brief Returns the number of threads used to search the neighbours of the points. */
+      unsigned int
+      getNumberOfThreads () const;
+
       /** \brief This method launches the segmentation algorithm and returns the clusters that were
         * obtained during the segmentation.
         * \param[out] clusters clusters that were obtained. Each cluster is an array of point indices.
@@ -333,6 +344,9 @@ namespace pcl
       /** \brief Stores the number of segments. */
       int number_of_segments_;
 
+      /** \brief The number of threads used to search the neighbours of the points. */
+      unsigned int threads_;
+
     public:
       PCL_MAKE_ALIGNED_OPERATOR_NEW
   };
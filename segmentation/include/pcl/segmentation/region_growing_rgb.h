@@ -77,6 +77,7 @@ namespace pcl
       using RegionGrowing<PointT, NormalT>::num_pts_in_segment_;
       using RegionGrowing<PointT, NormalT>::clusters_;
       using RegionGrowing<PointT, NormalT>::number_of_segments_;
+      using RegionGrowing<PointT, NormalT>::threads_;
       using RegionGrowing<PointT, NormalT>::applySmoothRegionGrowingAlgorithm;
       using RegionGrowing<PointT, NormalT>::assembleRegions;
 
@@ -250,6 +250,24 @@ namespace pcl
       virtual void 
       segment (PointIndices &inliers, ModelCoefficients &model_coefficients);
 
+      /** \brief Segment several models one after the other in a PointCloud given by <setInputCloud (), setIndices ()>.
+        * The inliers of every model found are removed from the indices of the SAC model, in place, before the next
+        * one is searched. The SAC model and method are only initialized once, and keep their buffers from a model to
+        * the next.
+        * \param[out] inliers the point indices that support each model found (inliers)
+        * \param[out] model_coefficients the coefficients of each model found
+        * \param[in] max_models the maximum number of models to segment
+        * \param[in] min_inliers the minimum number of inliers of a model, the segmentation stops at the first model
+        * with less inliers, which is not returned
+        * \note The hypotheses of each model are evaluated in parallel by the SAC methods which support it, see
+        * setNumberOfThreads.
+        */
+      void
+      segment (std::vector<PointIndices> &inliers,
+               std::vector<ModelCoefficients> &model_coefficients,
+               std::size_t max_models,
+               std::size_t min_inliers = 0);
+
     protected:
       /** \brief Initialize the Sample Consensus model and set its parameters.
         * \param[in] model_type the type of SAC model that is to be used
@@ -59,6 +59,23 @@ namespace pcl
       const typename pcl::search::Search<PointT>::Ptr &tree,
       pcl::PointCloud<PointT> &output);
 
+  /** \brief Obtain the difference between two aligned point clouds as another point cloud, given a distance threshold,
+    * searching the nearest neighbors of the points in parallel. The output does not depend on the number of threads.
+    * \param src the input point cloud source
+    * \param threshold the distance threshold (tolerance) for point correspondences
+    * \param tree the spatial locator (e.g., kd-tree) used for nearest neighbors searching built over the target cloud
+    * \param output the resultant output point cloud difference
+    * \param nr_threads the number of threads to use
+    * \ingroup segmentation
+    */
+  template <typename PointT>
+  void getPointCloudDifference (
+      const pcl::PointCloud<PointT> &src,
+      double threshold,
+      const typename pcl::search::Search<PointT>::Ptr &tree,
+      pcl::PointCloud<PointT> &output,
+      unsigned int nr_threads);
+
   template <typename PointT>
   PCL_DEPRECATED(1, 12, "tgt parameter is not used; it is deprecated and will be removed in future releases")
   inline void getPointCloudDifference (
@@ -98,7 +115,7 @@ namespace pcl
 
       /** \brief Empty constructor. */
       SegmentDifferences () : 
-        tree_ (), target_ (), distance_threshold_ (0)
+        tree_ (), target_ (), distance_threshold_ (0), tile_size_ (0), threads_ (1)
       {};
 
       /** \brief Provide a pointer to the target dataset against which we
@@ -137,6 +154,31 @@ namespace pcl
       inline double 
       getDistanceThreshold () { return (distance_threshold_); }
 
+      /** \brief Set the side of the square tiles, in the XY plane, in which the clouds are compared.
+        *
+        * When set (positive), the search object is built for the target points of one tile (and of a margin of the
+        * distance tolerance around it) at a time instead of the whole target cloud, which bounds the memory used by
+        * the search to the size of the tiles. The differences are the same as without tiles.
+        * \param tile_size the side of the tiles, or 0 to compare the whole clouds at once (default)
+        */
+      inline void
+      setTileSize (float tile_size) { tile_size_ = tile_size; }
+
+      /** \brief Get the side of the square tiles in which the clouds are compared. */
+      inline float
+      getTileSize () const { return (tile_size_); }
+
+      /** \brief Set the number of threads to use to search the nearest neighbors of the input points.
+        * The differences do not depend on the number of threads.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      void
+      setNumberOfThreads (unsigned int nr_threads = 0);
+
+      /** \brief Get the number of threads to use. */
+      inline unsigned int
+      getNumberOfThreads () const { return (threads_); }
+
       /** \brief Segment differences between two input point clouds.
         * \param output the resultant difference between the two point clouds as a PointCloud
         */
@@ -161,6 +203,18 @@ namespace pcl
         */
       double distance_threshold_;
 
+      /** \brief The side of the tiles in which the clouds are compared, or 0 to compare the whole clouds. */
+      float tile_size_;
+
+      /** \brief The number of threads the scheduler should use. */
+      unsigned int threads_;
+
+      /** \brief Segment the differences tile by tile, see \ref setTileSize.
+        * \param output the resultant difference between the two point clouds as a PointCloud
+        */
+      void
+      segmentTiles (PointCloud &output);
+
       /** \brief Class getName method. */
       virtual std::string 
       getClassName () const { return ("SegmentDifferences"); }
@@ -245,6 +245,30 @@ namespace pcl
       void
       setUseSingleCameraTransform (bool val);
 
+      /** \brief Set the number of threads used to build the adjacency octree, compute the voxel data, select the seeds and refine the supervoxels
+       *  \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+       *  \note The flow expansion itself stays serial, supervoxels steal voxels from each other in a fixed order
+       */
+      void
+      setNumberOfThreads (unsigned int nr_threads = 0);
+
+      /** \brief Get the number of threads used by the segmentation */
+      unsigned int
+      getNumberOfThreads () const;
+
+      /** \brief Set whether to seed each call to extract() with the supervoxels of the previous call
+       *  \note Meant for streams of frames: every supervoxel of the previous frame whose centroid still lies on the
+       *  new cloud is seeded at the nearest voxel and keeps its label, regular seeds are only added in the regions
+       *  which none of them covers. This keeps the labels stable from frame to frame.
+       *  \param[in] val true to reuse the previous supervoxels (false by default)
+       */
+      void
+      setUsePreviousSeeds (bool val);
+
+      /** \brief Get whether each call to extract() is seeded with the supervoxels of the previous call */
+      bool
+      getUsePreviousSeeds () const;
+
       /** \brief This method launches the segmentation algorithm and returns the supervoxels that were
        * obtained during the segmentation.
        * \param[out] supervoxel_clusters A map of labels to pointers to supervoxel structures
@@ -341,12 +365,26 @@ namespace pcl
       void
       selectInitialSupervoxelSeeds (std::vector<int> &seed_indices);
 
+      /** \brief This selects the seeds from the supervoxels of the previous call, completed by the regular seeds
+       *  \param[out] seed_indices The selected leaf indices
+       *  \param[out] seed_labels The label of the supervoxel grown from each seed
+       */
+      void
+      selectPreviousSupervoxelSeeds (std::vector<int> &seed_indices, std::vector<std::uint32_t> &seed_labels);
+
       /** \brief This method creates the internal supervoxel helpers based on the provided seed points
        *  \param[in] seed_indices Indices of the leaves to use as seeds
        */
       void
       createSupervoxelHelpers (std::vector<int> &seed_indices);
 
+      /** \brief This method creates the internal supervoxel helpers based on the provided seed points
+       *  \param[in] seed_indices Indices of the leaves to use as seeds
+       *  \param[in] seed_labels Label of the supervoxel of each seed
+       */
+      void
+      createSupervoxelHelpers (const std::vector<int> &seed_indices, const std::vector<std::uint32_t> &seed_labels);
+
       /** \brief This performs the superpixel evolution */
       void
       expandSupervoxels (int depth);
@@ -404,6 +442,15 @@ namespace pcl
       /** \brief Whether to use default transform behavior or not */
       bool use_default_transform_behaviour_;
 
+      /** \brief The number of threads the scheduler should use */
+      unsigned int threads_;
+
+      /** \brief Whether to seed extract() with the supervoxels of the previous call */
+      bool use_previous_seeds_;
+
+      /** \brief Label and centroid of the supervoxels of the previous call to extract() */
+      std::vector<std::pair<std::uint32_t, Eigen::Vector3f> > previous_seeds_;
+
       /** \brief Internal storage class for supervoxels
        * \note Stores pointers to leaves of clustering internal octree,
        * \note so should not be used outside of clustering class
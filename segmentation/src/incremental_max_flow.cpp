@@ -0,0 +1,439 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved
+ */
+
+#include <pcl/segmentation/incremental_max_flow.h>
+
+#include <algorithm>
+#include <cassert>
+
+constexpr int pcl::segmentation::IncrementalMaxFlow::NONE;
+constexpr int pcl::segmentation::IncrementalMaxFlow::TERMINAL;
+constexpr int pcl::segmentation::IncrementalMaxFlow::ORPHAN;
+constexpr int pcl::segmentation::IncrementalMaxFlow::INFINITE_DISTANCE;
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+pcl::segmentation::IncrementalMaxFlow::IncrementalMaxFlow ()
+  : time_ (0)
+  , solved_ (false)
+  , flow_ (0.0)
+{
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::segmentation::IncrementalMaxFlow::reset (int number_of_nodes)
+{
+  first_arc_.clear ();
+  head_.clear ();
+  sister_.clear ();
+  r_cap_.clear ();
+  edge_nodes_.clear ();
+  edge_caps_.clear ();
+  tr_cap_.assign (number_of_nodes, 0.0);
+  source_caps_.assign (number_of_nodes, 0.0);
+  sink_caps_.assign (number_of_nodes, 0.0);
+  parent_.assign (number_of_nodes, NONE);
+  is_sink_.assign (number_of_nodes, false);
+  time_stamp_.assign (number_of_nodes, 0);
+  distance_.assign (number_of_nodes, 0);
+  time_ = 0;
+  active_.clear ();
+  in_queue_.assign (number_of_nodes, false);
+  orphans_.clear ();
+  changed_.clear ();
+  is_changed_.assign (number_of_nodes, false);
+  solved_ = false;
+  flow_ = 0.0;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::segmentation::IncrementalMaxFlow::addEdge (int u, int v, double cap_uv, double cap_vu)
+{
+  assert (!solved_ && u != v);
+  edge_nodes_.push_back (u);
+  edge_nodes_.push_back (v);
+  edge_caps_.push_back (cap_uv);
+  edge_caps_.push_back (cap_vu);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::segmentation::IncrementalMaxFlow::setTerminalWeights (int u, double source_cap, double sink_cap)
+{
+  // Only the difference of the terminal capacities matters for the cut: apply the change to the residual
+  // capacity and account the capacity common to both terminals as flow
+  double delta_source = source_cap - source_caps_[u];
+  double delta_sink = sink_cap - sink_caps_[u];
+  source_caps_[u] = source_cap;
+  sink_caps_[u] = sink_cap;
+
+  if (tr_cap_[u] > 0.0)
+    delta_source += tr_cap_[u];
+  else
+    delta_sink -= tr_cap_[u];
+  flow_ += std::min (delta_source, delta_sink);
+  tr_cap_[u] = delta_source - delta_sink;
+
+  if (solved_ && !is_changed_[u])
+  {
+    is_changed_[u] = true;
+    changed_.push_back (u);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+double
+pcl::segmentation::IncrementalMaxFlow::solve ()
+{
+  if (!solved_)
+  {
+    buildArcs ();
+    initializeTrees ();
+    solved_ = true;
+  }
+  else
+    reuseTrees ();
+
+  expandTrees ();
+  return (flow_);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::segmentation::IncrementalMaxFlow::buildArcs ()
+{
+  const int number_of_nodes = getNumberOfNodes ();
+  const int number_of_edges = static_cast<int> (edge_caps_.size () / 2);
+
+  first_arc_.assign (number_of_nodes + 1, 0);
+  for (const int node : edge_nodes_)
+    ++first_arc_[node + 1];
+  for (int u = 0; u < number_of_nodes; ++u)
+    first_arc_[u + 1] += first_arc_[u];
+
+  head_.resize (2 * number_of_edges);
+  sister_.resize (2 * number_of_edges);
+  r_cap_.resize (2 * number_of_edges);
+  std::vector<int> next_arc (first_arc_.begin (), first_arc_.end () - 1);
+  for (int e = 0; e < number_of_edges; ++e)
+  {
+    const int u = edge_nodes_[2 * e];
+    const int v = edge_nodes_[2 * e + 1];
+    const int a_uv = next_arc[u]++;
+    const int a_vu = next_arc[v]++;
+    head_[a_uv] = v;
+    head_[a_vu] = u;
+    sister_[a_uv] = a_vu;
+    sister_[a_vu] = a_uv;
+    r_cap_[a_uv] = edge_caps_[2 * e];
+    r_cap_[a_vu] = edge_caps_[2 * e + 1];
+  }
+
+  edge_nodes_.clear ();
+  edge_nodes_.shrink_to_fit ();
+  edge_caps_.clear ();
+  edge_caps_.shrink_to_fit ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::segmentation::IncrementalMaxFlow::initializeTrees ()
+{
+  time_ = 0;
+  for (int u = 0; u < getNumberOfNodes (); ++u)
+  {
+    time_stamp_[u] = 0;
+    if (tr_cap_[u] != 0.0)
+    {
+      is_sink_[u] = tr_cap_[u] < 0.0;
+      parent_[u] = TERMINAL;
+      distance_[u] = 1;
+      setActive (u);
+    }
+    else
+      parent_[u] = NONE;
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::segmentation::IncrementalMaxFlow::reuseTrees ()
+{
+  ++time_;
+  for (const int u : changed_)
+  {
+    is_changed_[u] = false;
+    setActive (u);
+
+    if (tr_cap_[u] == 0.0)
+    {
+      // The node lost its terminal residual capacity: look for a new parent
+      if (parent_[u] != NONE)
+      {
+        parent_[u] = ORPHAN;
+        orphans_.push_back (u);
+      }
+      continue;
+    }
+
+    const bool sink = tr_cap_[u] < 0.0;
+    if (parent_[u] == NONE || is_sink_[u] != sink)
+    {
+      // The node moves to the other tree: the children it had are orphaned, and its neighbors of the other
+      // tree are activated to look for the paths now going through it
+      is_sink_[u] = sink;
+      for (int a = first_arc_[u]; a < first_arc_[u + 1]; ++a)
+      {
+        const int v = head_[a];
+        if (is_changed_[v])
+          continue;
+        if (parent_[v] == sister_[a])
+        {
+          parent_[v] = ORPHAN;
+          orphans_.push_back (v);
+        }
+        if (parent_[v] != NONE && is_sink_[v] != sink && (sink ? r_cap_[sister_[a]] : r_cap_[a]) > 0.0)
+          setActive (v);
+      }
+    }
+    parent_[u] = TERMINAL;
+    time_stamp_[u] = time_;
+    distance_[u] = 1;
+  }
+  changed_.clear ();
+
+  adoptOrphans ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::segmentation::IncrementalMaxFlow::expandTrees ()
+{
+  int current = -1;
+  while (true)
+  {
+    int u = current;
+    if (u >= 0)
+    {
+      in_queue_[u] = false;
+      if (parent_[u] == NONE)
+        u = -1;
+    }
+    while (u < 0 && !active_.empty ())
+    {
+      u = active_.front ();
+      active_.pop_front ();
+      in_queue_[u] = false;
+      if (parent_[u] == NONE)
+        u = -1;
+    }
+    if (u < 0)
+      break;
+
+    // Grow the tree of the node, until an arc reaching the other tree is found
+    int middle_arc = -1;
+    for (int a = first_arc_[u]; a < first_arc_[u + 1]; ++a)
+    {
+      if ((is_sink_[u] ? r_cap_[sister_[a]] : r_cap_[a]) == 0.0)
+        continue;
+      const int v = head_[a];
+      if (parent_[v] == NONE)
+      {
+        is_sink_[v] = is_sink_[u];
+        parent_[v] = sister_[a];
+        time_stamp_[v] = time_stamp_[u];
+        distance_[v] = distance_[u] + 1;
+        setActive (v);
+      }
+      else if (is_sink_[v] != is_sink_[u])
+      {
+        // The middle arc goes from the source tree to the sink tree
+        middle_arc = is_sink_[u] ? sister_[a] : a;
+        break;
+      }
+      else if (time_stamp_[v] <= time_stamp_[u] && distance_[v] > distance_[u])
+      {
+        // Shorten the path from v to its terminal
+        parent_[v] = sister_[a];
+        time_stamp_[v] = time_stamp_[u];
+        distance_[v] = distance_[u] + 1;
+      }
+    }
+
+    ++time_;
+
+    if (middle_arc >= 0)
+    {
+      // Keep on growing from the same node once the path is augmented
+      in_queue_[u] = true;
+      current = u;
+      augment (middle_arc);
+      adoptOrphans ();
+    }
+    else
+      current = -1;
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::segmentation::IncrementalMaxFlow::augment (int middle_arc)
+{
+  // Find the bottleneck capacity
+  double bottleneck = r_cap_[middle_arc];
+  int u = head_[sister_[middle_arc]];
+  for (; parent_[u] != TERMINAL; u = head_[parent_[u]])
+    bottleneck = std::min (bottleneck, r_cap_[sister_[parent_[u]]]);
+  bottleneck = std::min (bottleneck, tr_cap_[u]);
+  u = head_[middle_arc];
+  for (; parent_[u] != TERMINAL; u = head_[parent_[u]])
+    bottleneck = std::min (bottleneck, r_cap_[parent_[u]]);
+  bottleneck = std::min (bottleneck, -tr_cap_[u]);
+
+  // Push it along the path, the nodes whose arc to their parent gets saturated become orphans
+  r_cap_[sister_[middle_arc]] += bottleneck;
+  r_cap_[middle_arc] -= bottleneck;
+  u = head_[sister_[middle_arc]];
+  while (parent_[u] != TERMINAL)
+  {
+    const int a = parent_[u];
+    r_cap_[a] += bottleneck;
+    r_cap_[sister_[a]] -= bottleneck;
+    if (r_cap_[sister_[a]] == 0.0)
+    {
+      parent_[u] = ORPHAN;
+      orphans_.push_front (u);
+    }
+    u = head_[a];
+  }
+  tr_cap_[u] -= bottleneck;
+  if (tr_cap_[u] == 0.0)
+  {
+    parent_[u] = ORPHAN;
+    orphans_.push_front (u);
+  }
+
+  u = head_[middle_arc];
+  while (parent_[u] != TERMINAL)
+  {
+    const int a = parent_[u];
+    r_cap_[sister_[a]] += bottleneck;
+    r_cap_[a] -= bottleneck;
+    if (r_cap_[a] == 0.0)
+    {
+      parent_[u] = ORPHAN;
+      orphans_.push_front (u);
+    }
+    u = head_[a];
+  }
+  tr_cap_[u] += bottleneck;
+  if (tr_cap_[u] == 0.0)
+  {
+    parent_[u] = ORPHAN;
+    orphans_.push_front (u);
+  }
+
+  flow_ += bottleneck;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::segmentation::IncrementalMaxFlow::adoptOrphans ()
+{
+  while (!orphans_.empty ())
+  {
+    const int u = orphans_.front ();
+    orphans_.pop_front ();
+    processOrphan (u);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::segmentation::IncrementalMaxFlow::processOrphan (int u)
+{
+  const bool sink = is_sink_[u];
+  int min_arc = -1;
+  int min_distance = INFINITE_DISTANCE;
+
+  // Look for a neighbor of the same tree, with residual capacity towards u, that still originates from the terminal
+  for (int a0 = first_arc_[u]; a0 < first_arc_[u + 1]; ++a0)
+  {
+    if ((sink ? r_cap_[a0] : r_cap_[sister_[a0]]) == 0.0)
+      continue;
+    int v = head_[a0];
+    if (is_sink_[v] != sink || parent_[v] == NONE)
+      continue;
+
+    int d = 0;
+    while (true)
+    {
+      if (time_stamp_[v] == time_)
+      {
+        d += distance_[v];
+        break;
+      }
+      const int a = parent_[v];
+      ++d;
+      if (a == TERMINAL)
+      {
+        time_stamp_[v] = time_;
+        distance_[v] = 1;
+        break;
+      }
+      if (a == ORPHAN)
+      {
+        d = INFINITE_DISTANCE;
+        break;
+      }
+      v = head_[a];
+    }
+
+    if (d < INFINITE_DISTANCE)
+    {
+      if (d < min_distance)
+      {
+        min_arc = a0;
+        min_distance = d;
+      }
+      // Remember the distances along the path
+      for (v = head_[a0]; time_stamp_[v] != time_; v = head_[parent_[v]])
+      {
+        time_stamp_[v] = time_;
+        distance_[v] = d--;
+      }
+    }
+  }
+
+  if (min_arc >= 0)
+  {
+    parent_[u] = min_arc;
+    time_stamp_[u] = time_;
+    distance_[u] = min_distance + 1;
+    return;
+  }
+
+  // No parent found: free the node, orphan its children and activate the neighbors that could grow into it
+  parent_[u] = NONE;
+  for (int a0 = first_arc_[u]; a0 < first_arc_[u + 1]; ++a0)
+  {
+    const int v = head_[a0];
+    const int a = parent_[v];
+    if (is_sink_[v] != sink || a == NONE)
+      continue;
+    if ((sink ? r_cap_[a0] : r_cap_[sister_[a0]]) > 0.0)
+      setActive (v);
+    if (a != TERMINAL && a != ORPHAN && head_[a] == u)
+    {
+      parent_[v] = ORPHAN;
+      orphans_.push_back (v);
+    }
+  }
+}
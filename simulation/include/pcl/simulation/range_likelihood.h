@@ -191,6 +191,16 @@ public:
     use_color_ = use_color;
   }
 
+  /** Read the depth buffer back asynchronously: render() queues the copy into a pixel
+   *  buffer object, and getDepthBuffer() only waits for it to complete, so that the CPU
+   *  work done in between overlaps with the transfer.
+   */
+  void
+  setAsyncReadback(bool async_readback)
+  {
+    async_readback_ = async_readback;
+  }
+
   const std::uint8_t*
   getColorBuffer() const;
 
@@ -233,6 +243,14 @@ private:
   void
   computeScores(float* reference, std::vector<float>& scores);
 
+  /** Score every model image against the reference image with a cost function. */
+  template <typename CostFunction>
+  void
+  scoreTiles(const float* depth,
+             const float* reference,
+             CostFunction cost,
+             std::vector<float>& scores);
+
   void
   computeScoresShader(float* reference);
 
@@ -280,6 +298,7 @@ private:
   mutable bool depth_buffer_dirty_;
   mutable bool color_buffer_dirty_;
   mutable bool score_buffer_dirty_;
+  mutable bool depth_readback_pending_;
 
   int which_cost_function_;
   double floor_proportion_;
@@ -296,17 +315,20 @@ private:
   GLuint score_summarized_texture_;
   GLuint sensor_texture_;
   GLuint likelihood_texture_;
+  GLuint depth_pbo_;
 
   bool compute_likelihood_on_cpu_;
   bool aggregate_on_cpu_;
   bool use_instancing_;
   bool generate_color_image_;
   bool use_color_;
+  bool async_readback_;
 
   gllib::Program::Ptr likelihood_program_;
   GLuint quad_vbo_;
   std::vector<Eigen::Vector3f, Eigen::aligned_allocator<Eigen::Vector3f>> vertices_;
   float* score_buffer_;
+  std::vector<float> score_sum_;
   Quad quad_;
   SumReduce sum_reduce_;
 };
@@ -13,6 +13,7 @@
 #include <GL/glu.h>
 #endif
 
+#include <algorithm>
 #include <ctime>
 #include <random>
 
@@ -282,6 +283,7 @@ pcl::simulation::RangeLikelihood::RangeLikelihood(
 , depth_buffer_dirty_(true)
 , color_buffer_dirty_(true)
 , score_buffer_dirty_(true)
+, depth_readback_pending_(false)
 , fbo_(0)
 , depth_render_buffer_(0)
 , color_render_buffer_(0)
@@ -290,10 +292,12 @@ pcl::simulation::RangeLikelihood::RangeLikelihood(
 , score_summarized_texture_(0)
 , sensor_texture_(0)
 , likelihood_texture_(0)
+, depth_pbo_(0)
 , compute_likelihood_on_cpu_(false)
 , aggregate_on_cpu_(false)
 , use_instancing_(false)
 , use_color_(true)
+, async_readback_(false)
 , sum_reduce_(cols * col_width, rows * row_height, max_level(col_width, row_height))
 {
   height_ = rows_ * row_height;
@@ -480,6 +484,13 @@ pcl::simulation::RangeLikelihood::RangeLikelihood(
   glUseProgram(0);
 
   score_buffer_ = new float[width_ * height_];
+
+  // Pixel buffer object the depth buffer is read back into asynchronously
+  glGenBuffers(1, &depth_pbo_);
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, depth_pbo_);
+  glBufferData(
+      GL_PIXEL_PACK_BUFFER, width_ * height_ * sizeof(float), nullptr, GL_STREAM_READ);
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
 }
 
 pcl::simulation::RangeLikelihood::~RangeLikelihood()
@@ -495,6 +506,7 @@ pcl::simulation::RangeLikelihood::~RangeLikelihood()
   glDeleteFramebuffers(1, &score_fbo_);
   glDeleteRenderbuffers(1, &depth_render_buffer_);
   glDeleteRenderbuffers(1, &color_render_buffer_);
+  glDeleteBuffers(1, &depth_pbo_);
 
   delete[] depth_buffer_;
   delete[] color_buffer_;
@@ -745,6 +757,54 @@ costFunction5(double measured_depth,
   return std::log(lhood);
 }
 
+namespace {
+// Wraps a cost function in a type of its own, so that scoreTiles is instantiated for it
+template <float (*Cost)(float, float)>
+struct CostFunctor {
+  float
+  operator()(float ref_val, float depth_val) const
+  {
+    return Cost(ref_val, depth_val);
+  }
+};
+} // namespace
+
+// The cost function is a template parameter so that it is inlined in the pixel loop
+// instead of being selected for every pixel. The tiles are independent, so they are
+// scored in parallel.
+template <typename CostFunction>
+void
+pcl::simulation::RangeLikelihood::scoreTiles(const float* depth,
+                                             const float* reference,
+                                             CostFunction cost,
+                                             std::vector<float>& scores)
+{
+  int cols = cols_;
+  int row_height = row_height_;
+  int col_width = col_width_;
+  int width = width_;
+  int tiles = rows_ * cols_;
+  float* score_buffer = score_buffer_;
+#pragma omp parallel for default(none)                                                 \
+    shared(depth, reference, cost, scores, cols, row_height, col_width, width, tiles,    \
+           score_buffer) schedule(static)
+  for (int tile = 0; tile < tiles; ++tile) {
+    const int offset = (tile / cols) * row_height * width + (tile % cols) * col_width;
+    float sum = 0;
+    for (int y = 0; y < row_height; ++y) {
+      const float* ref = reference + y * col_width;
+      const float* depth_row = depth + offset + y * width;
+      float* score_row = score_buffer + offset + y * width;
+      for (int x = 0; x < col_width; ++x) {
+        const float score = cost(ref[x], depth_row[x]);
+        score_row[x] = score;
+        sum += score;
+      }
+    }
+    scores[tile] += sum;
+  }
+}
+
 void
 pcl::simulation::RangeLikelihood::computeScores(float* reference,
                                                 std::vector<float>& scores)
@@ -765,41 +825,39 @@ pcl::simulation::RangeLikelihood::computeScores(float* reference,
 
   // ref[col%col_width] - z/depth value in metres,   0-> ~20
   // depth_val - contents of depth buffer [0->1]
-
-  // for row across each image in a row of model images
-  for (int row = 0; row < rows_ * row_height_; row++) {
-    float* ref = reference + col_width_ * (row % row_height_);
-    // for each column: across each image in a column of model images
-    for (int col = 0; col < cols_ * col_width_; col++) {
-      float depth_val =
-          (*depth++); // added jan 2012 - check this is not a breaking fix later mfallon
-      float score = 0;
-      if (which_cost_function_ == 0) {
-        score = costFunction0(ref[col % col_width_], depth_val);
-      }
-      else if (which_cost_function_ == 1) {
-        score = costFunction1(ref[col % col_width_], depth_val);
-      }
-      else if (which_cost_function_ == 2) {
-        score = costFunction2(ref[col % col_width_], depth_val);
-      }
-      else if (which_cost_function_ == 3) {
-        score = costFunction3(ref[col % col_width_], depth_val);
-      }
-      else if (which_cost_function_ == 4) {
-        score = costFunction4(ref[col % col_width_], depth_val);
-      }
-      else if (which_cost_function_ == 5) {
-        // double sigma = 0.025;
-        // double floor_proportion_ = 0.999;
-        score = static_cast<float>(
-            costFunction5(ref[col % col_width_], depth_val, sigma_, floor_proportion_));
-      }
-      scores[row / row_height_ * cols_ + col / col_width_] += score;
-      // std::cout << "(" << scores[row/row_height_ * cols_ + col/col_width_] <<"," <<
-      // score << "," << ref[col%col_width_] << "," << depth_val << ") ";
-      score_buffer_[row * width_ + col] = score;
-    }
+  switch (which_cost_function_) {
+  case 0:
+    scoreTiles(depth, reference, CostFunctor<costFunction0>(), scores);
+    break;
+  case 1:
+    scoreTiles(depth, reference, CostFunctor<costFunction1>(), scores);
+    break;
+  case 2:
+    scoreTiles(depth, reference, CostFunctor<costFunction2>(), scores);
+    break;
+  case 3:
+    scoreTiles(depth, reference, CostFunctor<costFunction3>(), scores);
+    break;
+  case 4:
+    scoreTiles(depth, reference, CostFunctor<costFunction4>(), scores);
+    break;
+  case 5: {
+    const double sigma = sigma_;
+    const double floor_proportion = floor_proportion_;
+    scoreTiles(
+        depth,
+        reference,
+        [sigma, floor_proportion](float ref_val, float depth_val) {
+          return static_cast<float>(
+              costFunction5(ref_val, depth_val, sigma, floor_proportion));
+        },
+        scores);
+    break;
+  }
+  default:
+    // Unknown cost functions score 0 on every pixel
+    std::fill(score_buffer_, score_buffer_ + width_ * height_, 0.0f);
+    break;
   }
   score_buffer_dirty_ = false;
 }
@@ -1023,15 +1081,15 @@ RangeLikelihood::computeLikelihoods(
       int reduced_col_width = col_width_ >> levels;
       int reduced_row_height = row_height_ >> levels;
 
-      float* score_sum = new float[reduced_width * reduced_height];
-      sum_reduce_.sum(score_texture_, score_sum);
+      // Kept across calls, the size only depends on the tiling
+      score_sum_.resize(reduced_width * reduced_height);
+      sum_reduce_.sum(score_texture_, score_sum_.data());
       for (int n = 0, row = 0; row < reduced_height; ++row) {
         for (int col = 0; col < reduced_width; ++col, ++n) {
           scores[row / reduced_row_height * cols_ + col / reduced_col_width] +=
-              score_sum[n];
+              score_sum_[n];
         }
       }
-      delete[] score_sum;
     }
   }
 
@@ -1194,6 +1252,14 @@ RangeLikelihood::render(
   drawParticles(poses);
 
   glPopAttrib();
+
+  if (async_readback_) {
+    // Queue the copy of the depth buffer, getDepthBuffer() maps it once it is needed
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, depth_pbo_);
+    glReadPixels(0, 0, width_, height_, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    depth_readback_pending_ = true;
+  }
   glFlush();
 
   glBindFramebuffer(GL_FRAMEBUFFER, 0);
@@ -1223,10 +1289,24 @@ const float*
 RangeLikelihood::getDepthBuffer() const
 {
   if (depth_buffer_dirty_) {
-    // Read depth
-    glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
-    glReadPixels(0, 0, width_, height_, GL_DEPTH_COMPONENT, GL_FLOAT, depth_buffer_);
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    if (depth_readback_pending_) {
+      // The copy was queued by render(), mapping waits for it to complete
+      glBindBuffer(GL_PIXEL_PACK_BUFFER, depth_pbo_);
+      const float* pixels =
+          static_cast<const float*>(glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY));
+      if (pixels) {
+        std::copy(pixels, pixels + width_ * height_, depth_buffer_);
+      }
+      glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+      glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+      depth_readback_pending_ = false;
+    }
+    else {
+      // Read depth
+      glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
+      glReadPixels(0, 0, width_, height_, GL_DEPTH_COMPONENT, GL_FLOAT, depth_buffer_);
+      glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    }
 
     if (gllib::getGLError() != GL_NO_ERROR) {
       std::cerr << "GL Error: RangeLikelihoodGLSL::getDepthBuffer" << std::endl;
@@ -83,6 +83,7 @@ public:
   using DisparityMapConverter<PointDEM>::disparity_map_height_;
   using DisparityMapConverter<PointDEM>::disparity_threshold_min_;
   using DisparityMapConverter<PointDEM>::disparity_threshold_max_;
+  using DisparityMapConverter<PointDEM>::threads_;
 
   /** \brief DigitalElevationMapBuilder constructor. */
   DigitalElevationMapBuilder();
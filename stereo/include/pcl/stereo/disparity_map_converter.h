@@ -157,6 +157,13 @@ public:
   inline float
   getDisparityThresholdMax() const;
 
+  /** \brief Set the number of threads to use for the conversion.
+   * \param[in] nr_threads the number of hardware threads to use (0 sets the value back
+   * to automatic).
+   */
+  inline void
+  setNumberOfThreads(unsigned int nr_threads = 0);
+
   /** \brief Set an image, that will be used for coloring of the output cloud.
    * \param[in] image the image.
    */
@@ -251,6 +258,9 @@ protected:
   /** \brief Thresholds of the disparity. */
   float disparity_threshold_min_;
   float disparity_threshold_max_;
+
+  /** \brief The number of threads the conversion should use. */
+  unsigned int threads_;
 };
 
 } // namespace pcl
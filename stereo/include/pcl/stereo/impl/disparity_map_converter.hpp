@@ -38,6 +38,7 @@
 #define PCL_DISPARITY_MAP_CONVERTER_IMPL_H_
 
 #include <pcl/common/intensity.h>
+#include <pcl/common/utils.h> // for getNumberOfThreads
 #include <pcl/console/print.h>
 #include <pcl/stereo/disparity_map_converter.h>
 #include <pcl/point_types.h>
@@ -56,6 +57,7 @@ pcl::DisparityMapConverter<PointT>::DisparityMapConverter()
 , disparity_map_height_(480)
 , disparity_threshold_min_(0.0f)
 , disparity_threshold_max_(std::numeric_limits<float>::max())
+, threads_(0)
 {}
 
 template <typename PointT>
@@ -148,6 +150,13 @@ pcl::DisparityMapConverter<PointT>::getDisparityThresholdMax() const
   return disparity_threshold_max_;
 }
 
+template <typename PointT>
+inline void
+pcl::DisparityMapConverter<PointT>::setNumberOfThreads(unsigned int nr_threads)
+{
+  threads_ = nr_threads;
+}
+
 template <typename PointT>
 void
 pcl::DisparityMapConverter<PointT>::setImage(
@@ -246,11 +255,16 @@ template <typename PointT>
 void
 pcl::DisparityMapConverter<PointT>::compute(PointCloud& out_cloud)
 {
-  // Initialize the output cloud.
-  out_cloud.clear();
-  out_cloud.width = disparity_map_width_;
-  out_cloud.height = disparity_map_height_;
-  out_cloud.resize(out_cloud.width * out_cloud.height);
+  // Initialize the output cloud, reusing its points if it already has the size of
+  // the disparity map. Every point is overwritten below.
+  if (out_cloud.width != disparity_map_width_ ||
+      out_cloud.height != disparity_map_height_ ||
+      out_cloud.size() != disparity_map_width_ * disparity_map_height_) {
+    out_cloud.clear();
+    out_cloud.width = disparity_map_width_;
+    out_cloud.height = disparity_map_height_;
+    out_cloud.resize(out_cloud.width * out_cloud.height);
+  }
 
   if (is_color_ && !image_) {
     PCL_ERROR("[pcl::DisparityMapConverter::compute] Memory for the image was not "
@@ -258,7 +272,15 @@ pcl::DisparityMapConverter<PointT>::compute(PointCloud& out_cloud)
     return;
   }
 
-  for (std::size_t row = 0; row < disparity_map_height_; ++row) {
+  int height = static_cast<int>(disparity_map_height_);
+
+  // clang-format off
+#pragma omp parallel for \
+  default(none) \
+  shared(height, out_cloud) \
+  num_threads(pcl::utils::getNumberOfThreads(threads_))
+  // clang-format on
+  for (int row = 0; row < height; ++row) {
     for (std::size_t column = 0; column < disparity_map_width_; ++column) {
       // ID of current disparity point.
       std::size_t disparity_point = column + row * disparity_map_width_;
@@ -194,6 +194,18 @@ public:
     lr_check_th_ = lr_check_th;
   };
 
+  /** \brief setter for the number of threads the image rows are matched and converted
+   * to a point cloud with
+   *
+   * \param[in] nr_threads the number of threads to use (0 sets the value back to
+   *            automatic)
+   */
+  void
+  setNumberOfThreads(unsigned int nr_threads = 0)
+  {
+    threads_ = nr_threads;
+  };
+
   /** \brief stereo processing, it computes a disparity map stored internally by the
    * class
    *
@@ -328,6 +340,9 @@ protected:
   /** \brief Threshold for the left-right consistency check, typically either 0 or 1 */
   int lr_check_th_;
 
+  /** \brief The number of threads used by compute_impl, 0 for automatic */
+  unsigned int threads_;
+
   virtual void
   preProcessing(unsigned char* img, unsigned char* pp_img) = 0;
 
@@ -35,6 +35,7 @@
  */
 
 #include <pcl/common/feature_histogram.h>
+#include <pcl/common/utils.h> // for getNumberOfThreads
 #include <pcl/console/print.h>
 #include <pcl/stereo/digital_elevation_map.h>
 
@@ -88,8 +89,8 @@ pcl::DigitalElevationMapBuilder::compute(pcl::PointCloud<PointDEM>& out_cloud)
   out_cloud.resize(out_cloud.width * out_cloud.height);
 
   // Initialize steps.
-  const std::size_t kColumnStep = (disparity_map_width_ - 1) / resolution_column_ + 1;
-  const float kDisparityStep =
+  std::size_t kColumnStep = (disparity_map_width_ - 1) / resolution_column_ + 1;
+  float kDisparityStep =
       (disparity_threshold_max_ - disparity_threshold_min_) / resolution_disparity_;
 
   // Initialize histograms.
@@ -122,37 +123,58 @@ pcl::DigitalElevationMapBuilder::compute(pcl::PointCloud<PointDEM>& out_cloud)
     return;
   }
 
-  for (std::size_t column = 0; column < disparity_map_width_; ++column) {
-    for (std::size_t row = 0; row < disparity_map_height_; ++row) {
-      float disparity = disparity_map_[column + row * disparity_map_width_];
-      if (disparity_threshold_min_ < disparity &&
-          disparity < disparity_threshold_max_) {
-        // Find a height and an intensity of the point of interest.
-        PointXYZ point_3D = translateCoordinates(row, column, disparity);
-        float height = point_3D.y;
-
-        RGB point_RGB = (*image_)[column + row * disparity_map_width_];
-        float intensity =
-            static_cast<float>((point_RGB.r + point_RGB.g + point_RGB.b) / 3);
-
-        // Calculate index of histograms.
-        std::size_t index_column = column / kColumnStep;
-        std::size_t index_disparity = static_cast<std::size_t>(
-            (disparity - disparity_threshold_min_) / kDisparityStep);
-
-        std::size_t index = index_column + index_disparity * resolution_column_;
-
-        // Increase the histograms.
-        height_histograms[index].addValue(height);
-        intensity_histograms[index].addValue(intensity);
-
-      } // if
-    }   // row
-  }     // column
+  // The histograms of a DEM column are only fed by the image columns of its column
+  // step, so the DEM columns are filled in parallel.
+  int number_of_columns = static_cast<int>(resolution_column_);
+
+  // clang-format off
+#pragma omp parallel for \
+  default(none) \
+  shared(height_histograms, intensity_histograms, kColumnStep, kDisparityStep, \
+         number_of_columns) \
+  num_threads(pcl::utils::getNumberOfThreads(threads_))
+  // clang-format on
+  for (int index_column = 0; index_column < number_of_columns; ++index_column) {
+    const std::size_t column_end =
+        std::min((index_column + 1) * kColumnStep, disparity_map_width_);
+    for (std::size_t column = index_column * kColumnStep; column < column_end;
+         ++column) {
+      for (std::size_t row = 0; row < disparity_map_height_; ++row) {
+        float disparity = disparity_map_[column + row * disparity_map_width_];
+        if (disparity_threshold_min_ < disparity &&
+            disparity < disparity_threshold_max_) {
+          // Find a height and an intensity of the point of interest.
+          PointXYZ point_3D = translateCoordinates(row, column, disparity);
+          float height = point_3D.y;
+
+          RGB point_RGB = (*image_)[column + row * disparity_map_width_];
+          float intensity =
+              static_cast<float>((point_RGB.r + point_RGB.g + point_RGB.b) / 3);
+
+          // Calculate index of histograms.
+          std::size_t index_disparity = static_cast<std::size_t>(
+              (disparity - disparity_threshold_min_) / kDisparityStep);
+
+          std::size_t index = index_column + index_disparity * resolution_column_;
+
+          // Increase the histograms.
+          height_histograms[index].addValue(height);
+          intensity_histograms[index].addValue(intensity);
+
+        } // if
+      }   // row
+    }     // column
+  }       // index_column
 
   // For all histograms.
-  for (std::size_t index_column = 0; index_column < resolution_column_;
-       ++index_column) {
+  // clang-format off
+#pragma omp parallel for \
+  default(none) \
+  shared(height_histograms, intensity_histograms, kColumnStep, kDisparityStep, \
+         number_of_columns, out_cloud) \
+  num_threads(pcl::utils::getNumberOfThreads(threads_))
+  // clang-format on
+  for (int index_column = 0; index_column < number_of_columns; ++index_column) {
     for (std::size_t index_disparity = 0; index_disparity < resolution_disparity_;
          ++index_disparity) {
       std::size_t index = index_column + index_disparity * resolution_column_;
@@ -186,4 +208,4 @@ pcl::DigitalElevationMapBuilder::compute(pcl::PointCloud<PointDEM>& out_cloud)
 
     } // index_disparity
   }   // index_column
-}
\ No newline at end of file
+}
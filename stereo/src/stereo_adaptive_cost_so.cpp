@@ -38,6 +38,91 @@
 
 #include "pcl/stereo/stereo_matching.h"
 
+#include <pcl/common/utils.h> // for getNumberOfThreads
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+#include <algorithm> // for reverse_copy
+#include <cstring>   // for memcpy
+#include <vector>
+
+namespace {
+/** \brief Add the weighted SADs of one row of the support window to the costs of
+ * the disparities [0, n): w = wl * wt[d], num[d] += w * |ref - trg[d]| and
+ * sumw[d] += w. The target row and its weights are stored reversed, so that the
+ * disparities are contiguous.
+ */
+inline void
+accumulateCosts(float* num,
+                float* sumw,
+                const float wl,
+                const unsigned char ref,
+                const float* wt,
+                const unsigned char* trg,
+                const int n)
+{
+  int d = 0;
+#if defined(__AVX2__)
+  const __m256 wl8 = _mm256_set1_ps(wl);
+  const __m256i ref8 = _mm256_set1_epi32(ref);
+  for (; d + 8 <= n; d += 8) {
+    const __m256 w = _mm256_mul_ps(wl8, _mm256_loadu_ps(wt + d));
+    const __m256 sad = _mm256_cvtepi32_ps(_mm256_abs_epi32(_mm256_sub_epi32(
+        ref8,
+        _mm256_cvtepu8_epi32(
+            _mm_loadl_epi64(reinterpret_cast<const __m128i*>(trg + d))))));
+    _mm256_storeu_ps(num + d,
+                     _mm256_add_ps(_mm256_loadu_ps(num + d), _mm256_mul_ps(w, sad)));
+    _mm256_storeu_ps(sumw + d, _mm256_add_ps(_mm256_loadu_ps(sumw + d), w));
+  }
+#elif defined(__SSE2__)
+  const __m128i zero = _mm_setzero_si128();
+  const __m128 wl4 = _mm_set1_ps(wl);
+  const __m128i ref4 = _mm_set1_epi32(ref);
+  for (; d + 4 <= n; d += 4) {
+    int t_bytes;
+    std::memcpy(&t_bytes, trg + d, sizeof(int));
+    const __m128 w = _mm_mul_ps(wl4, _mm_loadu_ps(wt + d));
+    // |x| as (x ^ sign) - sign, SSE2 has no abs for 32 bit integers
+    const __m128i diff = _mm_sub_epi32(
+        ref4,
+        _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(t_bytes), zero), zero));
+    const __m128i diff_sign = _mm_srai_epi32(diff, 31);
+    const __m128 sad =
+        _mm_cvtepi32_ps(_mm_sub_epi32(_mm_xor_si128(diff, diff_sign), diff_sign));
+    _mm_storeu_ps(num + d, _mm_add_ps(_mm_loadu_ps(num + d), _mm_mul_ps(w, sad)));
+    _mm_storeu_ps(sumw + d, _mm_add_ps(_mm_loadu_ps(sumw + d), w));
+  }
+#elif defined(__ARM_NEON)
+  const float32x4_t wl4 = vdupq_n_f32(wl);
+  const uint8x8_t ref8 = vdup_n_u8(ref);
+  for (; d + 8 <= n; d += 8) {
+    const uint16x8_t sad = vabdl_u8(ref8, vld1_u8(trg + d));
+    const float32x4_t w_lo = vmulq_f32(wl4, vld1q_f32(wt + d));
+    const float32x4_t w_hi = vmulq_f32(wl4, vld1q_f32(wt + d + 4));
+    const float32x4_t sad_lo = vcvtq_f32_u32(vmovl_u16(vget_low_u16(sad)));
+    const float32x4_t sad_hi = vcvtq_f32_u32(vmovl_u16(vget_high_u16(sad)));
+    // multiply and add separately, a fused multiply-add would round differently
+    vst1q_f32(num + d, vaddq_f32(vld1q_f32(num + d), vmulq_f32(w_lo, sad_lo)));
+    vst1q_f32(num + d + 4, vaddq_f32(vld1q_f32(num + d + 4), vmulq_f32(w_hi, sad_hi)));
+    vst1q_f32(sumw + d, vaddq_f32(vld1q_f32(sumw + d), w_lo));
+    vst1q_f32(sumw + d + 4, vaddq_f32(vld1q_f32(sumw + d + 4), w_hi));
+  }
+#endif
+  for (; d < n; d++) {
+    const float w = wl * wt[d];
+    num[d] += w * static_cast<float>(std::abs(ref - trg[d]));
+    sumw[d] += w;
+  }
+}
+} // namespace
+
 //////////////////////////////////////////////////////////////////////////////
 pcl::AdaptiveCostSOStereoMatching::AdaptiveCostSOStereoMatching()
 {
@@ -55,27 +140,10 @@ void
 pcl::AdaptiveCostSOStereoMatching::compute_impl(unsigned char* ref_img,
                                                 unsigned char* trg_img)
 {
-  // int n = radius_ * 2 + 1;
-  // int sad_max = std::numeric_limits<int>::max ();
-
-  float** acc = new float*[width_];
-  for (int d = 0; d < width_; d++) {
-    acc[d] = new float[max_disp_];
-    memset(acc[d], 0, sizeof(float) * max_disp_);
-  }
-
-  // data structures for Scanline Optimization
-  float** fwd = new float*[width_];
-  float** bck = new float*[width_];
-  for (int d = 0; d < width_; d++) {
-    fwd[d] = new float[max_disp_];
-    memset(fwd[d], 0, sizeof(float) * max_disp_);
-    bck[d] = new float[max_disp_];
-    memset(bck[d], 0, sizeof(float) * max_disp_);
-  }
+  int n = radius_ * 2 + 1;
 
   // spatial distance init
-  float* ds = new float[2 * radius_ + 1];
+  std::vector<float> ds(n);
   for (int j = -radius_; j <= radius_; j++)
     ds[j + radius_] = static_cast<float>(std::exp(-std::abs(j) / gamma_s_));
 
@@ -84,133 +152,163 @@ pcl::AdaptiveCostSOStereoMatching::compute_impl(unsigned char* ref_img,
   for (int j = 0; j < 256; j++)
     lut[j] = float(std::exp(-j / gamma_c_));
 
-  // left weight array alloc
-  float* wl = new float[2 * radius_ + 1];
-
-  for (int y = radius_ + 1; y < height_ - radius_; y++) {
-    for (int x = x_off_ + max_disp_ + 1; x < width_; x++) {
-      for (int j = -radius_; j <= radius_; j++)
-        wl[j + radius_] =
-            lut[std::abs(ref_img[(y + j) * width_ + x] - ref_img[y * width_ + x])] *
-            ds[j + radius_];
-
-      for (int d = 0; d < max_disp_; d++) {
-        float sumw = 0.0;
-        float num = 0.0;
-
-        for (int j = -radius_; j <= radius_; j++) {
-          float weight_r = lut[std::abs(trg_img[(y + j) * width_ + x - d - x_off_] -
-                                        trg_img[y * width_ + x - d - x_off_])] *
-                           ds[j + radius_];
-          int sad = std::abs(ref_img[(y + j) * width_ + x] -
-                             trg_img[(y + j) * width_ + x - d - x_off_]);
-          num += wl[j + radius_] * weight_r * static_cast<float>(sad);
-          sumw += wl[j + radius_] * weight_r;
-        }
+  // the target rows reversed, so that the pixels matched by increasing disparities
+  // are contiguous: trg (x - d - x_off) is trg_rev[width - 1 - x + x_off + d]
+  std::vector<unsigned char> trg_rev(width_ * height_);
+  for (int y = 0; y < height_; y++)
+    std::reverse_copy(trg_img + y * width_,
+                      trg_img + (y + 1) * width_,
+                      trg_rev.begin() + y * width_);
+
+  // the rows are independent: each one is aggregated and optimized on its own
+  // clang-format off
+#pragma omp parallel \
+  default(none) \
+  shared(ds, lut, n, ref_img, trg_rev) \
+  num_threads(pcl::utils::getNumberOfThreads(threads_))
+  // clang-format on
+  {
+    std::vector<float> acc(width_ * max_disp_, 0.0f);
 
-        acc[x][d] = num / sumw;
-
-      } // d
-    }   // x
-
-    // Forward
-    for (int d = 0; d < max_disp_; d++)
-      fwd[max_disp_ + 1][d] = acc[max_disp_ + 1][d];
-
-    for (int x = x_off_ + max_disp_ + 2; x < width_; x++) {
-      float c_min = fwd[x - 1][0];
-      for (int d = 1; d < max_disp_; d++)
-        if (fwd[x - 1][d] < c_min)
-          c_min = fwd[x - 1][d];
-
-      fwd[x][0] =
-          acc[x][0] - c_min +
-          std::min(fwd[x - 1][0],
-                   std::min(fwd[x - 1][1] + static_cast<float>(smoothness_weak_),
-                            c_min + static_cast<float>(smoothness_strong_)));
-      for (int d = 1; d < max_disp_ - 1; d++) {
-        fwd[x][d] =
-            acc[x][d] - c_min +
-            std::min(std::min(fwd[x - 1][d],
-                              fwd[x - 1][d - 1] + static_cast<float>(smoothness_weak_)),
-                     std::min(fwd[x - 1][d + 1] + static_cast<float>(smoothness_weak_),
-                              c_min + static_cast<float>(smoothness_strong_)));
+    // data structures for Scanline Optimization
+    std::vector<float> fwd(width_ * max_disp_, 0.0f);
+    std::vector<float> bck(width_ * max_disp_, 0.0f);
+
+    // left weights, and target weights of the whole row (reversed like trg_rev)
+    std::vector<float> wl(n);
+    std::vector<float> wt(n * width_);
+    std::vector<float> num(max_disp_);
+    std::vector<float> sumw(max_disp_);
+
+#pragma omp for schedule(dynamic)
+    for (int y = radius_ + 1; y < height_ - radius_; y++) {
+      // the target weights depend on the target pixel only, not on the disparity
+      const unsigned char* trg_center = &trg_rev[y * width_];
+      for (int j = -radius_; j <= radius_; j++) {
+        const unsigned char* trg_row = &trg_rev[(y + j) * width_];
+        float* wt_row = &wt[(j + radius_) * width_];
+        for (int k = 0; k < width_; k++)
+          wt_row[k] = lut[std::abs(trg_row[k] - trg_center[k])] * ds[j + radius_];
       }
-      fwd[x][max_disp_ - 1] =
-          acc[x][max_disp_ - 1] - c_min +
-          std::min(
-              fwd[x - 1][max_disp_ - 1],
-              std::min(fwd[x - 1][max_disp_ - 2] + static_cast<float>(smoothness_weak_),
-                       c_min + static_cast<float>(smoothness_strong_)));
-    } // x
-
-    // Backward
-    for (int d = 0; d < max_disp_; d++)
-      bck[width_ - 1][d] = acc[width_ - 1][d];
-
-    for (int x = width_ - 2; x > max_disp_ + x_off_; x--) {
-
-      float c_min = bck[x + 1][0];
-      for (int d = 1; d < max_disp_; d++)
-        if (bck[x + 1][d] < c_min)
-          c_min = bck[x + 1][d];
-
-      bck[x][0] =
-          acc[x][0] - c_min +
-          std::min(bck[x + 1][0],
-                   std::min(bck[x + 1][1] + static_cast<float>(smoothness_weak_),
-                            c_min + static_cast<float>(smoothness_strong_)));
-      for (int d = 1; d < max_disp_ - 1; d++)
-        bck[x][d] =
-            acc[x][d] - c_min +
-            std::min(std::min(bck[x + 1][d],
-                              bck[x + 1][d - 1] + static_cast<float>(smoothness_weak_)),
-                     std::min(bck[x + 1][d + 1] + static_cast<float>(smoothness_weak_),
-                              c_min + static_cast<float>(smoothness_strong_)));
-      bck[x][max_disp_ - 1] =
-          acc[x][max_disp_ - 1] - c_min +
-          std::min(
-              bck[x + 1][max_disp_ - 1],
-              std::min(bck[x + 1][max_disp_ - 2] + static_cast<float>(smoothness_weak_),
-                       c_min + static_cast<float>(smoothness_strong_)));
-    } // x
-
-    // last scan
-    for (int x = x_off_ + max_disp_ + 1; x < width_; x++) {
-      float c_min = std::numeric_limits<float>::max();
-      short int dbest = 0;
-
-      for (int d = 0; d < max_disp_; d++) {
-        acc[x][d] = fwd[x][d] + bck[x][d];
-        if (acc[x][d] < c_min) {
-          c_min = acc[x][d];
-          dbest = static_cast<short int>(d);
+
+      for (int x = x_off_ + max_disp_ + 1; x < width_; x++) {
+        for (int j = -radius_; j <= radius_; j++)
+          wl[j + radius_] =
+              lut[std::abs(ref_img[(y + j) * width_ + x] - ref_img[y * width_ + x])] *
+              ds[j + radius_];
+
+        std::fill(num.begin(), num.end(), 0.0f);
+        std::fill(sumw.begin(), sumw.end(), 0.0f);
+        const int k = width_ - 1 - x + x_off_;
+        for (int j = -radius_; j <= radius_; j++)
+          accumulateCosts(num.data(),
+                          sumw.data(),
+                          wl[j + radius_],
+                          ref_img[(y + j) * width_ + x],
+                          &wt[(j + radius_) * width_ + k],
+                          &trg_rev[(y + j) * width_ + k],
+                          max_disp_);
+
+        float* acc_x = &acc[x * max_disp_];
+        for (int d = 0; d < max_disp_; d++)
+          acc_x[d] = num[d] / sumw[d];
+      } // x
+
+      // Forward
+      for (int d = 0; d < max_disp_; d++)
+        fwd[(max_disp_ + 1) * max_disp_ + d] = acc[(max_disp_ + 1) * max_disp_ + d];
+
+      for (int x = x_off_ + max_disp_ + 2; x < width_; x++) {
+        const float* acc_x = &acc[x * max_disp_];
+        const float* fwd_prev = &fwd[(x - 1) * max_disp_];
+        float* fwd_x = &fwd[x * max_disp_];
+
+        float c_min = fwd_prev[0];
+        for (int d = 1; d < max_disp_; d++)
+          if (fwd_prev[d] < c_min)
+            c_min = fwd_prev[d];
+
+        fwd_x[0] = acc_x[0] - c_min +
+                   std::min(fwd_prev[0],
+                            std::min(fwd_prev[1] + static_cast<float>(smoothness_weak_),
+                                     c_min + static_cast<float>(smoothness_strong_)));
+        for (int d = 1; d < max_disp_ - 1; d++) {
+          fwd_x[d] =
+              acc_x[d] - c_min +
+              std::min(std::min(fwd_prev[d],
+                                fwd_prev[d - 1] + static_cast<float>(smoothness_weak_)),
+                       std::min(fwd_prev[d + 1] + static_cast<float>(smoothness_weak_),
+                                c_min + static_cast<float>(smoothness_strong_)));
         }
-      }
+        fwd_x[max_disp_ - 1] =
+            acc_x[max_disp_ - 1] - c_min +
+            std::min(
+                fwd_prev[max_disp_ - 1],
+                std::min(fwd_prev[max_disp_ - 2] + static_cast<float>(smoothness_weak_),
+                         c_min + static_cast<float>(smoothness_strong_)));
+      } // x
 
-      if (ratio_filter_ > 0)
-        dbest = doStereoRatioFilter(acc[x], dbest, c_min, ratio_filter_, max_disp_);
-      if (peak_filter_ > 0)
-        dbest = doStereoPeakFilter(acc[x], dbest, peak_filter_, max_disp_);
+      // Backward
+      for (int d = 0; d < max_disp_; d++)
+        bck[(width_ - 1) * max_disp_ + d] = acc[(width_ - 1) * max_disp_ + d];
 
-      disp_map_[y * width_ + x] = static_cast<short int>(dbest * 16);
+      for (int x = width_ - 2; x > max_disp_ + x_off_; x--) {
+        const float* acc_x = &acc[x * max_disp_];
+        const float* bck_next = &bck[(x + 1) * max_disp_];
+        float* bck_x = &bck[x * max_disp_];
 
-      // subpixel refinement
-      if (dbest > 0 && dbest < max_disp_ - 1)
-        disp_map_[y * width_ + x] = computeStereoSubpixel(
-            dbest, acc[x][dbest - 1], acc[x][dbest], acc[x][dbest + 1]);
-    } // x
-  }   // y
+        float c_min = bck_next[0];
+        for (int d = 1; d < max_disp_; d++)
+          if (bck_next[d] < c_min)
+            c_min = bck_next[d];
 
-  for (int x = 0; x < width_; x++) {
-    delete[] fwd[x];
-    delete[] bck[x];
-    delete[] acc[x];
-  }
-  delete[] fwd;
-  delete[] bck;
-  delete[] acc;
+        bck_x[0] = acc_x[0] - c_min +
+                   std::min(bck_next[0],
+                            std::min(bck_next[1] + static_cast<float>(smoothness_weak_),
+                                     c_min + static_cast<float>(smoothness_strong_)));
+        for (int d = 1; d < max_disp_ - 1; d++)
+          bck_x[d] =
+              acc_x[d] - c_min +
+              std::min(std::min(bck_next[d],
+                                bck_next[d - 1] + static_cast<float>(smoothness_weak_)),
+                       std::min(bck_next[d + 1] + static_cast<float>(smoothness_weak_),
+                                c_min + static_cast<float>(smoothness_strong_)));
+        bck_x[max_disp_ - 1] =
+            acc_x[max_disp_ - 1] - c_min +
+            std::min(
+                bck_next[max_disp_ - 1],
+                std::min(bck_next[max_disp_ - 2] + static_cast<float>(smoothness_weak_),
+                         c_min + static_cast<float>(smoothness_strong_)));
+      } // x
+
+      // last scan
+      for (int x = x_off_ + max_disp_ + 1; x < width_; x++) {
+        float* acc_x = &acc[x * max_disp_];
+        const float* fwd_x = &fwd[x * max_disp_];
+        const float* bck_x = &bck[x * max_disp_];
+        float c_min = std::numeric_limits<float>::max();
+        short int dbest = 0;
+
+        for (int d = 0; d < max_disp_; d++) {
+          acc_x[d] = fwd_x[d] + bck_x[d];
+          if (acc_x[d] < c_min) {
+            c_min = acc_x[d];
+            dbest = static_cast<short int>(d);
+          }
+        }
+
+        if (ratio_filter_ > 0)
+          dbest = doStereoRatioFilter(acc_x, dbest, c_min, ratio_filter_, max_disp_);
+        if (peak_filter_ > 0)
+          dbest = doStereoPeakFilter(acc_x, dbest, peak_filter_, max_disp_);
 
-  delete[] wl;
-  delete[] ds;
+        disp_map_[y * width_ + x] = static_cast<short int>(dbest * 16);
+
+        // subpixel refinement
+        if (dbest > 0 && dbest < max_disp_ - 1)
+          disp_map_[y * width_ + x] = computeStereoSubpixel(
+              dbest, acc_x[dbest - 1], acc_x[dbest], acc_x[dbest + 1]);
+      } // x
+    }   // y
+  }
 }
@@ -38,6 +38,112 @@
 
 #include "pcl/stereo/stereo_matching.h"
 
+#include <pcl/common/utils.h> // for getNumberOfThreads
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+#include <algorithm> // for reverse_copy
+#include <cstring>   // for memcpy
+#include <vector>
+
+namespace {
+/** \brief Slide the column SADs of a pixel down by one row and update the window SADs
+ * with them, for the disparities [0, n):
+ * v[d] += |ref - trg[d]| - |ref_old - trg_old[d]| and acc[d] += v[d] - v_old[d].
+ * The target rows are stored reversed, so that the disparities are contiguous.
+ */
+inline void
+slideCosts(int* v,
+           int* acc,
+           const int* v_old,
+           const unsigned char ref,
+           const unsigned char* trg,
+           const unsigned char ref_old,
+           const unsigned char* trg_old,
+           const int n)
+{
+  int d = 0;
+#if defined(__AVX2__)
+  const __m256i ref8 = _mm256_set1_epi32(ref);
+  const __m256i ref_old8 = _mm256_set1_epi32(ref_old);
+  for (; d + 8 <= n; d += 8) {
+    const __m256i t = _mm256_cvtepu8_epi32(
+        _mm_loadl_epi64(reinterpret_cast<const __m128i*>(trg + d)));
+    const __m256i t_old = _mm256_cvtepu8_epi32(
+        _mm_loadl_epi64(reinterpret_cast<const __m128i*>(trg_old + d)));
+    __m256i vd = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(v + d));
+    vd = _mm256_add_epi32(
+        vd,
+        _mm256_sub_epi32(_mm256_abs_epi32(_mm256_sub_epi32(ref8, t)),
+                         _mm256_abs_epi32(_mm256_sub_epi32(ref_old8, t_old))));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(v + d), vd);
+    const __m256i ad = _mm256_add_epi32(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(acc + d)),
+        _mm256_sub_epi32(
+            vd, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(v_old + d))));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(acc + d), ad);
+  }
+#elif defined(__SSE2__)
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i ref4 = _mm_set1_epi32(ref);
+  const __m128i ref_old4 = _mm_set1_epi32(ref_old);
+  for (; d + 4 <= n; d += 4) {
+    int t_bytes, t_old_bytes;
+    std::memcpy(&t_bytes, trg + d, sizeof(int));
+    std::memcpy(&t_old_bytes, trg_old + d, sizeof(int));
+    const __m128i t = _mm_unpacklo_epi16(
+        _mm_unpacklo_epi8(_mm_cvtsi32_si128(t_bytes), zero), zero);
+    const __m128i t_old = _mm_unpacklo_epi16(
+        _mm_unpacklo_epi8(_mm_cvtsi32_si128(t_old_bytes), zero), zero);
+    // |x| as (x ^ sign) - sign, SSE2 has no abs for 32 bit integers
+    const __m128i diff = _mm_sub_epi32(ref4, t);
+    const __m128i diff_sign = _mm_srai_epi32(diff, 31);
+    const __m128i diff_old = _mm_sub_epi32(ref_old4, t_old);
+    const __m128i diff_old_sign = _mm_srai_epi32(diff_old, 31);
+    __m128i vd = _mm_loadu_si128(reinterpret_cast<const __m128i*>(v + d));
+    vd = _mm_add_epi32(
+        vd,
+        _mm_sub_epi32(
+            _mm_sub_epi32(_mm_xor_si128(diff, diff_sign), diff_sign),
+            _mm_sub_epi32(_mm_xor_si128(diff_old, diff_old_sign), diff_old_sign)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(v + d), vd);
+    const __m128i ad = _mm_add_epi32(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(acc + d)),
+        _mm_sub_epi32(vd,
+                      _mm_loadu_si128(reinterpret_cast<const __m128i*>(v_old + d))));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(acc + d), ad);
+  }
+#elif defined(__ARM_NEON)
+  const uint8x8_t ref8 = vdup_n_u8(ref);
+  const uint8x8_t ref_old8 = vdup_n_u8(ref_old);
+  for (; d + 8 <= n; d += 8) {
+    const int16x8_t delta = vreinterpretq_s16_u16(
+        vsubq_u16(vabdl_u8(ref8, vld1_u8(trg + d)), vabdl_u8(ref_old8, vld1_u8(trg_old + d))));
+    const int32x4_t v_lo = vaddq_s32(vld1q_s32(v + d), vmovl_s16(vget_low_s16(delta)));
+    const int32x4_t v_hi =
+        vaddq_s32(vld1q_s32(v + d + 4), vmovl_s16(vget_high_s16(delta)));
+    vst1q_s32(v + d, v_lo);
+    vst1q_s32(v + d + 4, v_hi);
+    vst1q_s32(acc + d,
+              vaddq_s32(vld1q_s32(acc + d), vsubq_s32(v_lo, vld1q_s32(v_old + d))));
+    vst1q_s32(
+        acc + d + 4,
+        vaddq_s32(vld1q_s32(acc + d + 4), vsubq_s32(v_hi, vld1q_s32(v_old + d + 4))));
+  }
+#endif
+  for (; d < n; d++) {
+    v[d] += std::abs(ref - trg[d]) - std::abs(ref_old - trg_old[d]);
+    acc[d] += v[d] - v_old[d];
+  }
+}
+} // namespace
+
 //////////////////////////////////////////////////////////////////////////////
 pcl::BlockBasedStereoMatching::BlockBasedStereoMatching()
 {
@@ -50,109 +156,100 @@ pcl::BlockBasedStereoMatching::compute_impl(unsigned char* ref_img,
                                             unsigned char* trg_img)
 {
   int n = radius_ * 2 + 1;
-  int sad_min;
-  short int dbest = 0;
-
   int sad_max = std::numeric_limits<int>::max();
 
-  int* acc = new int[max_disp_];
-  memset(acc, 0, sizeof(int) * max_disp_);
-
-  int** v = new int*[width_];
-  for (int d = 0; d < width_; d++) {
-    v[d] = new int[max_disp_];
-    memset(v[d], 0, sizeof(int) * max_disp_);
-  }
-
-  // First row
-  for (int x = max_disp_ + x_off_; x < max_disp_ + x_off_ + n; x++) {
-    for (int d = 0; d < max_disp_; d++) {
-      for (int y = 0; y < n; y++)
-        v[x][d] +=
-            std::abs(ref_img[y * width_ + x] - trg_img[y * width_ + x - d - x_off_]);
-      // acc[d] += V[x][d];
-    }
-  }
-
-  // STAGE 2: other positions
-  for (int x = max_disp_ + x_off_ + radius_ + 1; x < width_ - radius_; x++) {
-    for (int d = 0; d < max_disp_; d++) {
-      for (int y = 0; y < n; y++) {
-        v[x + radius_][d] += std::abs(ref_img[y * width_ + x + radius_] -
-                                      trg_img[y * width_ + x + radius_ - d - x_off_]);
-      }
-      acc[d] += v[x + radius_][d] - v[x - radius_ - 1][d];
-    } // d
-  }   // x
-
-  // 2
-  const int ind1 = radius_ + radius_ + max_disp_ + x_off_;
-
-  for (int y = radius_ + 1; y < height_ - radius_; y++) {
-    // first position
-    for (int d = 0; d < max_disp_; d++) {
-      acc[d] = 0;
-      for (int x = max_disp_ + x_off_; x < max_disp_ + x_off_ + n; x++) {
-        v[x][d] += std::abs(ref_img[(y + radius_) * width_ + x] -
-                            trg_img[(y + radius_) * width_ + x - d - x_off_]) -
-                   std::abs(ref_img[(y - radius_ - 1) * width_ + x] -
-                            trg_img[(y - radius_ - 1) * width_ + x - d - x_off_]);
-
-        acc[d] += v[x][d];
+  // the target rows reversed, so that the pixels matched by increasing disparities
+  // are contiguous: trg (x - d - x_off) is trg_rev[width - 1 - x + x_off + d]
+  std::vector<unsigned char> trg_rev(width_ * height_);
+  for (int y = 0; y < height_; y++)
+    std::reverse_copy(trg_img + y * width_,
+                      trg_img + (y + 1) * width_,
+                      trg_rev.begin() + y * width_);
+
+  // the rows are split in bands, each one running its own column sums from scratch
+  int y_begin = radius_ + 1;
+  int y_end = height_ - radius_;
+  int num_bands = std::max(
+      1,
+      std::min(static_cast<int>(pcl::utils::getNumberOfThreads(threads_)),
+               y_end - y_begin));
+
+  // clang-format off
+#pragma omp parallel for \
+  default(none) \
+  shared(n, num_bands, ref_img, sad_max, trg_rev, y_begin, y_end) \
+  schedule(static, 1) \
+  num_threads(num_bands)
+  // clang-format on
+  for (int band = 0; band < num_bands; band++) {
+    const int band_begin = y_begin + (y_end - y_begin) * band / num_bands;
+    const int band_end = y_begin + (y_end - y_begin) * (band + 1) / num_bands;
+
+    std::vector<int> acc(max_disp_, 0);
+    std::vector<int> zeros(max_disp_, 0);
+    std::vector<int> v(width_ * max_disp_, 0);
+
+    // column sums over the window of the row before the band
+    for (int y = band_begin - 1 - radius_; y < band_begin + radius_; y++) {
+      for (int x = max_disp_ + x_off_; x < width_; x++) {
+        const unsigned char* trg = &trg_rev[y * width_ + width_ - 1 - x + x_off_];
+        for (int d = 0; d < max_disp_; d++)
+          v[x * max_disp_ + d] += std::abs(ref_img[y * width_ + x] - trg[d]);
       }
     }
 
-    // all other positions
-    unsigned char* lp =
-        static_cast<unsigned char*>(ref_img) + (y + radius_) * width_ + ind1;
-    unsigned char* rp =
-        static_cast<unsigned char*>(trg_img) + (y + radius_) * width_ + ind1 - x_off_;
-    unsigned char* lpp =
-        static_cast<unsigned char*>(ref_img) + (y - radius_ - 1) * width_ + ind1;
-    unsigned char* rpp = static_cast<unsigned char*>(trg_img) +
-                         (y - radius_ - 1) * width_ + ind1 - x_off_;
-
-    for (int x = max_disp_ + x_off_ + radius_ + 1; x < width_ - radius_; x++) {
-      sad_min = sad_max;
-
-      lp++;
-      rp++;
-      lpp++;
-      rpp++;
-
-      for (int d = 0; d < max_disp_; d++) {
-        v[x + radius_][d] += std::abs(*lp - *rp) - std::abs(*lpp - *rpp);
-        rp--;
-        rpp--;
-
-        acc[d] += v[x + radius_][d] - v[x - radius_ - 1][d];
-
-        if (acc[d] < sad_min) {
-          sad_min = acc[d];
-          dbest = static_cast<short int>(d);
+    for (int y = band_begin; y < band_end; y++) {
+      const unsigned char* ref_row = ref_img + (y + radius_) * width_;
+      const unsigned char* ref_row_old = ref_img + (y - radius_ - 1) * width_;
+      const unsigned char* trg_row = &trg_rev[(y + radius_) * width_ + width_ - 1 + x_off_];
+      const unsigned char* trg_row_old =
+          &trg_rev[(y - radius_ - 1) * width_ + width_ - 1 + x_off_];
+
+      // first position
+      std::fill(acc.begin(), acc.end(), 0);
+      for (int x = max_disp_ + x_off_; x < max_disp_ + x_off_ + n; x++)
+        slideCosts(&v[x * max_disp_],
+                   acc.data(),
+                   zeros.data(),
+                   ref_row[x],
+                   trg_row - x,
+                   ref_row_old[x],
+                   trg_row_old - x,
+                   max_disp_);
+
+      // all other positions
+      for (int x = max_disp_ + x_off_ + radius_ + 1; x < width_ - radius_; x++) {
+        slideCosts(&v[(x + radius_) * max_disp_],
+                   acc.data(),
+                   &v[(x - radius_ - 1) * max_disp_],
+                   ref_row[x + radius_],
+                   trg_row - x - radius_,
+                   ref_row_old[x + radius_],
+                   trg_row_old - x - radius_,
+                   max_disp_);
+
+        int sad_min = sad_max;
+        short int dbest = 0;
+        for (int d = 0; d < max_disp_; d++) {
+          if (acc[d] < sad_min) {
+            sad_min = acc[d];
+            dbest = static_cast<short int>(d);
+          }
         }
-      }
-
-      rp += max_disp_;
-      rpp += max_disp_;
-
-      if (ratio_filter_ > 0)
-        dbest = doStereoRatioFilter(acc, dbest, sad_min, ratio_filter_, max_disp_);
-      if (peak_filter_ > 0)
-        dbest = doStereoPeakFilter(acc, dbest, peak_filter_, max_disp_);
-
-      disp_map_[y * width_ + x] = static_cast<short int>(dbest * 16);
-
-      // subpixel refinement
-      if (dbest > 0 && dbest < max_disp_ - 1)
-        disp_map_[y * width_ + x] =
-            computeStereoSubpixel(dbest, acc[dbest - 1], acc[dbest], acc[dbest + 1]);
-
-    } // x
-  }   // y
 
-  for (int d = 0; d < width_; d++)
-    delete[] v[d];
-  delete[] v;
-  delete[] acc;
+        if (ratio_filter_ > 0)
+          dbest = doStereoRatioFilter(
+              acc.data(), dbest, sad_min, ratio_filter_, max_disp_);
+        if (peak_filter_ > 0)
+          dbest = doStereoPeakFilter(acc.data(), dbest, peak_filter_, max_disp_);
+
+        disp_map_[y * width_ + x] = static_cast<short int>(dbest * 16);
+
+        // subpixel refinement
+        if (dbest > 0 && dbest < max_disp_ - 1)
+          disp_map_[y * width_ + x] =
+              computeStereoSubpixel(dbest, acc[dbest - 1], acc[dbest], acc[dbest + 1]);
+      } // x
+    }   // y
+  }     // band
 }
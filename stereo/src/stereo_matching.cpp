@@ -38,6 +38,7 @@
 
 #include "pcl/stereo/stereo_matching.h"
 
+#include <pcl/common/utils.h>   // for getNumberOfThreads
 #include <pcl/console/print.h> // for PCL_ERROR
 
 //////////////////////////////////////////////////////////////////////////////
@@ -64,6 +65,8 @@ pcl::StereoMatching::StereoMatching()
   is_pre_proc_ = false;
   is_lr_check_ = false;
   lr_check_th_ = 1;
+
+  threads_ = 0;
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -218,45 +221,34 @@ pcl::StereoMatching::getPointCloud(float u_c,
     cloud->is_dense = false;
   }
 
-  // Loop
-  pcl::PointXYZRGB temp_point;
-  /*pcl::PointXYZRGB nan_point;
-  nan_point.x = std::numeric_limits<float>::quiet_NaN();
-  nan_point.y = std::numeric_limits<float>::quiet_NaN();
-  nan_point.z = std::numeric_limits<float>::quiet_NaN();
-  nan_point.r = std::numeric_limits<unsigned char>::quiet_NaN();
-  nan_point.g = std::numeric_limits<unsigned char>::quiet_NaN();
-  nan_point.b = std::numeric_limits<unsigned char>::quiet_NaN();*/
-
   // all disparities are multiplied by a constant equal to 16;
   // this must be taken into account when computing z values
   float depth_scale = baseline * focal * 16.0f;
 
+  // clang-format off
+#pragma omp parallel for \
+  default(none) \
+  shared(cloud, depth_scale, focal, texture, u_c, v_c) \
+  num_threads(pcl::utils::getNumberOfThreads(threads_))
+  // clang-format on
   for (int j = 0; j < height_; j++) {
     for (int i = 0; i < width_; i++) {
+      pcl::PointXYZRGB temp_point;
       if (disp_map_[j * width_ + i] > 0) {
         temp_point.z = (depth_scale) / (disp_map_[j * width_ + i]);
         temp_point.x = ((static_cast<float>(i) - u_c) * temp_point.z) / focal;
         temp_point.y = ((static_cast<float>(j) - v_c) * temp_point.z) / focal;
-
-        // temp_point.intensity = ( texture->at(j*width_+i).r +texture->at(j*width_+i).g
-        // + texture->at(j*width_+i).b) / 3.0f;
-        temp_point.r = texture->at(j * width_ + i).r;
-        temp_point.g = texture->at(j * width_ + i).g;
-        temp_point.b = texture->at(j * width_ + i).b;
-
-        (*cloud)[j * width_ + i] = temp_point;
       }
       // adding NaN value
       else {
         temp_point.x = std::numeric_limits<float>::quiet_NaN();
         temp_point.y = std::numeric_limits<float>::quiet_NaN();
         temp_point.z = std::numeric_limits<float>::quiet_NaN();
-        temp_point.r = texture->at(j * width_ + i).r;
-        temp_point.g = texture->at(j * width_ + i).g;
-        temp_point.b = texture->at(j * width_ + i).b;
-        (*cloud)[j * width_ + i] = temp_point;
       }
+      temp_point.r = (*texture)[j * width_ + i].r;
+      temp_point.g = (*texture)[j * width_ + i].g;
+      temp_point.b = (*texture)[j * width_ + i].b;
+      (*cloud)[j * width_ + i] = temp_point;
     }
   }
 
@@ -295,26 +287,28 @@ pcl::StereoMatching::getPointCloud(float u_c,
   if (cloud->is_dense)
     cloud->is_dense = false;
 
-  // Loop
-  pcl::PointXYZ temp_point;
   pcl::PointXYZ nan_point;
   nan_point.x = std::numeric_limits<float>::quiet_NaN();
   nan_point.y = std::numeric_limits<float>::quiet_NaN();
   nan_point.z = std::numeric_limits<float>::quiet_NaN();
-  // nan_point.intensity = std::numeric_limits<float>::quiet_NaN();
 
   // all disparities are multiplied by a constant equal to 16;
   // this must be taken into account when computing z values
   float depth_scale = baseline * focal * 16.0f;
 
+  // clang-format off
+#pragma omp parallel for \
+  default(none) \
+  shared(cloud, depth_scale, focal, nan_point, u_c, v_c) \
+  num_threads(pcl::utils::getNumberOfThreads(threads_))
+  // clang-format on
   for (int j = 0; j < height_; j++) {
     for (int i = 0; i < width_; i++) {
       if (disp_map_[j * width_ + i] > 0) {
-
+        pcl::PointXYZ temp_point;
         temp_point.z = depth_scale / disp_map_[j * width_ + i];
         temp_point.x = ((static_cast<float>(i) - u_c) * temp_point.z) / focal;
         temp_point.y = ((static_cast<float>(j) - v_c) * temp_point.z) / focal;
-        // temp_point.intensity = 255;
 
         (*cloud)[j * width_ + i] = temp_point;
       }
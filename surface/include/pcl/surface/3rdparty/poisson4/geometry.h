@@ -199,6 +199,8 @@ namespace pcl
     class PCL_EXPORTS CoredMeshData
     {
       public:
+        virtual ~CoredMeshData( void ) { }
+
         std::vector<Point3D<float> > inCorePoints;
         virtual void resetIterator( void ) = 0;
 
@@ -284,7 +286,7 @@ namespace pcl
         int outOfCorePointCount( void );
         int polygonCount( void );
     };
-    class CoredFileMeshData : public CoredMeshData
+    class PCL_EXPORTS CoredFileMeshData : public CoredMeshData
     {
         FILE *oocPointFile , *polygonFile;
         int oocPoints , polygons;
@@ -167,6 +167,42 @@ namespace pcl
         return (dimension_);
       }
 
+      /** \brief Set whether 2D hulls are computed with Andrew's monotone chain algorithm instead of qhull.
+        * The monotone chain sorts the projected points in place of copying them for qhull, and is faster for the
+        * small planar hulls computed every frame. The hull vertices are returned in the same order.
+        * \param[in] value true to use the monotone chain for 2D hulls
+        */
+      inline void
+      setUseMonotoneChain (bool value)
+      {
+        use_monotone_chain_ = value;
+      }
+
+      /** \brief Returns whether 2D hulls are computed with Andrew's monotone chain algorithm. */
+      inline bool
+      getUseMonotoneChain () const
+      {
+        return (use_monotone_chain_);
+      }
+
+      /** \brief Add points to a hull computed over a stream of clouds.
+        * The hull is updated from its previous vertices and the new points only, so the points inside the
+        * hull are not processed again. The input cloud is replaced by these points, and the indices returned
+        * by getHullPointIndices () refer to them.
+        * \param[in] cloud the new points
+        * \param[out] points the vertices of the hull of all the points added since the last resetHull ()
+        * \param[out] polygons the polygons of the hull, as in reconstruct ()
+        */
+      void
+      addPoints (const PointCloud &cloud, PointCloud &points, std::vector<pcl::Vertices> &polygons);
+
+      /** \brief Forget the points added with addPoints (). */
+      inline void
+      resetHull ()
+      {
+        incremental_hull_.clear ();
+      }
+
       /** \brief Retrieve the indices of the input point cloud that for the convex hull.
         *
         * \note Should only be called after reconstruction was performed.
@@ -267,6 +303,12 @@ namespace pcl
       /* \brief vector containing the point cloud indices of the convex hull points. */
       pcl::PointIndices hull_indices_;
 
+      /** \brief Whether 2D hulls are computed with the monotone chain algorithm instead of qhull. */
+      bool use_monotone_chain_ = false;
+
+      /** \brief The vertices of the hull of the points added with addPoints (). */
+      PointCloud incremental_hull_;
+
       public:
         PCL_MAKE_ALIGNED_OPERATOR_NEW
   };
@@ -163,6 +163,8 @@ namespace pcl
         eps_angle_(M_PI/4), //45 degrees,
         consistent_(false), 
         consistent_ordering_ (false),
+        tile_size_ (0),
+        threads_ (1),
         angles_ (),
         R_ (),
         is_current_free_ (false),
@@ -264,6 +266,31 @@ namespace pcl
       inline bool 
       getConsistentVertexOrdering () const { return (consistent_ordering_); }
 
+      /** \brief Set the side of the cubic tiles in which the points are triangulated independently, in parallel.
+        *
+        * When set (positive), the points of every tile, and of a margin of twice the search radius around it,
+        * are triangulated by their own greedy front propagation. A tile keeps the triangles whose centroid lies
+        * in it, and the tiles are stitched in order by dropping the triangles that would make an edge shared by
+        * more than two triangles. The mesh matches the serial one away from the seams between the tiles.
+        * \param[in] tile_size the side of the tiles, or 0 to triangulate all the points at once (default)
+        */
+      inline void
+      setTileSize (double tile_size) { tile_size_ = tile_size; }
+
+      /** \brief Get the side of the tiles in which the points are triangulated. */
+      inline double
+      getTileSize () const { return (tile_size_); }
+
+      /** \brief Set the number of threads used to triangulate the tiles, see setTileSize ().
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      void
+      setNumberOfThreads (unsigned int nr_threads = 0);
+
+      /** \brief Get the number of threads used to triangulate the tiles. */
+      inline unsigned int
+      getNumberOfThreads () const { return (threads_); }
+
       /** \brief Get the state of each point after reconstruction.
         * \note Options are defined as constants: FREE, FRINGE, COMPLETED, BOUNDARY and NONE
         */
@@ -310,6 +337,12 @@ namespace pcl
       /** \brief Set this to true if the output triangle vertices should be consistently oriented. */
       bool consistent_ordering_;
 
+      /** \brief The side of the tiles triangulated in parallel, or 0 to triangulate all the points at once. */
+      double tile_size_;
+
+      /** \brief The number of threads the scheduler should use. */
+      unsigned int threads_;
+
      private:
       /** \brief Struct for storing the angles to nearest neighbors **/
       struct nnAngle
@@ -413,6 +446,12 @@ namespace pcl
       bool
       reconstructPolygons (std::vector<pcl::Vertices> &polygons);
 
+      /** \brief Triangulate the tiles in parallel and stitch their triangles, see setTileSize ().
+        * \param[out] polygons the resultant polygons, as a set of vertices. The Vertices structure contains an array of point indices.
+        */
+      bool
+      reconstructPolygonsInTiles (std::vector<pcl::Vertices> &polygons);
+
       /** \brief Class get name method. */
       std::string 
       getClassName () const override { return ("GreedyProjectionTriangulation"); }
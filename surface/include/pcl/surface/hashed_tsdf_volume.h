@@ -0,0 +1,202 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved
+ */
+
+#pragma once
+
+#include <pcl/memory.h>
+#include <pcl/pcl_macros.h>
+#include <pcl/point_cloud.h>
+#include <pcl/point_types.h>
+
+#include <Eigen/Geometry>
+
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace pcl
+{
+  /** \brief Truncated signed distance function (TSDF) volume fused from depth images on the CPU, the counterpart of
+    * the Cuda TSDF volume of KinectFusion for devices without an NVIDIA GPU.
+    *
+    * The volume is sparse: voxels are grouped in blocks of 8x8x8, allocated when a depth measurement falls within
+    * the truncation distance of them and found through a hash map, so that the memory follows the observed
+    * surface instead of a bounding box. A row of 8 voxels is integrated at once with fixed-size Eigen arrays, which
+    * vectorize, and the blocks and the rays of the raycast are distributed over OpenMP threads.
+    *
+    * Depth images are in millimeters, like the ones of KinfuTracker, and the volume is in meters.
+    * \ingroup surface
+    */
+  class PCL_EXPORTS HashedTSDFVolume
+  {
+    public:
+      using Ptr = shared_ptr<HashedTSDFVolume>;
+      using ConstPtr = shared_ptr<const HashedTSDFVolume>;
+
+      /** \brief Constructor.
+        * \param[in] voxel_size the edge length of a voxel in meters
+        * \param[in] truncation_distance the distance to the surface beyond which the TSDF is truncated, in meters
+        */
+      HashedTSDFVolume (float voxel_size = 0.01f, float truncation_distance = 0.03f);
+
+      /** \brief Set the edge length of a voxel in meters. Clears the volume. */
+      void
+      setVoxelSize (float voxel_size);
+
+      /** \brief Get the edge length of a voxel in meters. */
+      inline float
+      getVoxelSize () const { return (voxel_size_); }
+
+      /** \brief Set the truncation distance in meters, usually a few voxels. */
+      inline void
+      setTruncationDistance (float truncation_distance) { truncation_distance_ = truncation_distance; }
+
+      /** \brief Get the truncation distance in meters. */
+      inline float
+      getTruncationDistance () const { return (truncation_distance_); }
+
+      /** \brief Set the maximum weight of a voxel. Lower values let the volume follow changes of the scene faster. */
+      inline void
+      setMaxWeight (float max_weight) { max_weight_ = max_weight; }
+
+      /** \brief Get the maximum weight of a voxel. */
+      inline float
+      getMaxWeight () const { return (max_weight_); }
+
+      /** \brief Set the intrinsics of the depth camera.
+        * \param[in] fx focal length x
+        * \param[in] fy focal length y
+        * \param[in] cx principal point x
+        * \param[in] cy principal point y
+        */
+      void
+      setDepthIntrinsics (float fx, float fy, float cx, float cy);
+
+      /** \brief Set the range of the depth measurements integrated and of the raycast, in meters. */
+      void
+      setDepthRange (float min_depth, float max_depth);
+
+      /** \brief Set the number of threads to use.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      inline void
+      setNumberOfThreads (unsigned int nr_threads = 0) { threads_ = nr_threads; }
+
+      /** \brief Remove all the blocks. */
+      void
+      reset ();
+
+      /** \brief Get the number of allocated blocks of 8x8x8 voxels. */
+      inline std::size_t
+      getNumberOfBlocks () const { return (blocks_.size ()); }
+
+      /** \brief Fuse a depth image into the volume.
+        * \param[in] depth the depth image, row major, in millimeters, 0 for no measurement
+        * \param[in] width the width of the depth image
+        * \param[in] height the height of the depth image
+        * \param[in] pose the pose of the camera, i.e. the transform from the camera to the volume coordinates
+        */
+      void
+      integrate (const unsigned short *depth, int width, int height, const Eigen::Affine3f &pose);
+
+      /** \brief Render the surface seen from a camera with the intrinsics of the depth camera.
+        * \param[in] pose the pose of the camera, i.e. the transform from the camera to the volume coordinates
+        * \param[in] width the width of the rendered image
+        * \param[in] height the height of the rendered image
+        * \param[out] cloud the organized cloud of surface points and normals in volume coordinates, NaN where the
+        * ray does not hit the surface
+        */
+      void
+      raycast (const Eigen::Affine3f &pose, int width, int height, pcl::PointCloud<pcl::PointNormal> &cloud) const;
+
+      /** \brief Get the TSDF at a point, interpolated trilinearly between the voxels around it.
+        * \param[in] point the point in volume coordinates
+        * \param[out] tsdf the TSDF, between -1 and 1
+        * \return false if one of the voxels around the point was never observed
+        */
+      bool
+      getTsdfValue (const Eigen::Vector3f &point, float &tsdf) const;
+
+      /** \brief Convert the observed voxels near the surface to a cloud, with the TSDF as intensity. */
+      void
+      convertToTsdfCloud (pcl::PointCloud<pcl::PointXYZI> &cloud) const;
+
+    protected:
+      /** \brief Edge length of a block in voxels. */
+      static constexpr int BLOCK_SIZE = 8;
+      static constexpr int BLOCK_VOXELS = BLOCK_SIZE * BLOCK_SIZE * BLOCK_SIZE;
+
+      /** \brief Voxels of a block, x fastest, so that a row along x is contiguous. */
+      struct Block
+      {
+        std::array<float, BLOCK_VOXELS> tsdf;
+        std::array<float, BLOCK_VOXELS> weight;
+      };
+
+      /** \brief Key of the block with coordinates (bx, by, bz), 21 bits per axis centered on the origin. */
+      static inline std::int64_t
+      getBlockKey (int bx, int by, int bz)
+      {
+        const std::int64_t offset = 1 << 20;
+        const std::int64_t mask = (1 << 21) - 1;
+        return ((((bx + offset) & mask) << 42) | (((by + offset) & mask) << 21) | ((bz + offset) & mask));
+      }
+
+      /** \brief Coordinates of the block a voxel index falls in. */
+      static inline int
+      blockCoord (int voxel) { return (voxel >= 0 ? voxel / BLOCK_SIZE : (voxel + 1) / BLOCK_SIZE - 1); }
+
+      /** \brief Get the block with the given key, nullptr if it isn't allocated. */
+      inline const Block*
+      findBlock (std::int64_t key) const
+      {
+        const auto it = block_index_.find (key);
+        return (it == block_index_.end () ? nullptr : &blocks_[it->second]);
+      }
+
+      /** \brief Get the TSDF of the voxel (x, y, z), false if it was never observed. */
+      bool
+      getVoxel (int x, int y, int z, float &tsdf) const;
+
+      /** \brief Collect the keys of the blocks within the truncation distance of the measurements of a depth image. */
+      void
+      collectBlocks (const unsigned short *depth, int width, int height, const Eigen::Affine3f &pose,
+                     std::vector<std::int64_t> &keys) const;
+
+      /** \brief Fuse a depth image into one block. */
+      void
+      integrateBlock (std::int64_t key, Block &block, const unsigned short *depth, int width, int height,
+                      const Eigen::Matrix3f &R_inv, const Eigen::Vector3f &t_inv) const;
+
+      /** \brief Edge length of a voxel in meters. */
+      float voxel_size_;
+
+      /** \brief Truncation distance in meters. */
+      float truncation_distance_;
+
+      /** \brief Maximum weight of a voxel. */
+      float max_weight_;
+
+      /** \brief Depth camera intrinsics. */
+      float fx_, fy_, cx_, cy_;
+
+      /** \brief Range of the depth measurements in meters. */
+      float min_depth_, max_depth_;
+
+      /** \brief The number of threads the scheduler should use. */
+      unsigned int threads_;
+
+      /** \brief Index in blocks_ of each allocated block. */
+      std::unordered_map<std::int64_t, std::size_t> block_index_;
+
+      /** \brief Allocated blocks. */
+      std::vector<Block> blocks_;
+  };
+}
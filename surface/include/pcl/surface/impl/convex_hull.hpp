@@ -131,104 +131,161 @@ pcl::ConvexHull<PointInT>::performReconstruction2D (PointCloud &hull, std::vecto
     yz_proj_safe = false;
   }
 
-  // True if qhull should free points in qh_freeqhull() or reallocation
-  boolT ismalloc = True;
-  // output from qh_produce_output(), use NULL to skip qh_produce_output()
-  FILE *outfile = nullptr;
-
-#ifndef HAVE_QHULL_2011
-  if (compute_area_)
-    outfile = stderr;
-#endif
+  if (!xy_proj_safe && !yz_proj_safe && !xz_proj_safe)
+  {
+    // This should only happen if we had invalid input
+    PCL_ERROR ("[pcl::%s::performReconstruction2D] Invalid input!\n", getClassName ().c_str ());
+  }
 
-  // option flags for qhull, see qh_opt.htm
-  const char* flags = qhull_flags.c_str ();
-  // error messages from qhull code
-  FILE *errfile = stderr;
+  // The coordinates of the i-th point in the chosen projection
+  const auto projected = [&] (std::size_t i)
+  {
+    const PointInT &point = (*input_)[(*indices_)[i]];
+    if (xy_proj_safe)
+      return Eigen::Vector2d (point.x, point.y);
+    if (yz_proj_safe)
+      return Eigen::Vector2d (point.y, point.z);
+    return Eigen::Vector2d (point.x, point.z);
+  };
+
+  // The hull vertices, as positions in indices_
+  std::vector<int> hull_positions;
+  if (use_monotone_chain_)
+  {
+    // Andrew's monotone chain: sort the points, then build the lower and upper chains,
+    // dropping every point that does not make a counter-clockwise turn
+    std::vector<int> order (indices_->size ());
+    for (std::size_t i = 0; i < order.size (); ++i)
+      order[i] = static_cast<int> (i);
+    std::sort (order.begin (), order.end (), [&] (int a, int b)
+    {
+      const Eigen::Vector2d pa = projected (a), pb = projected (b);
+      return (pa[0] < pb[0] || (pa[0] == pb[0] && pa[1] < pb[1]));
+    });
 
-  // Array of coordinates for each point
-  coordT *points = reinterpret_cast<coordT*> (calloc (indices_->size () * dimension, sizeof (coordT)));
+    const auto cross = [&] (int o, int a, int b)
+    {
+      const Eigen::Vector2d po = projected (o), pa = projected (a), pb = projected (b);
+      return ((pa[0] - po[0]) * (pb[1] - po[1]) - (pa[1] - po[1]) * (pb[0] - po[0]));
+    };
 
-  // Build input data, using appropriate projection
-  int j = 0;
-  if (xy_proj_safe)
-  {
-    for (std::size_t i = 0; i < indices_->size (); ++i, j+=dimension)
+    std::vector<int> chain (2 * order.size ());
+    std::size_t k = 0;
+    for (std::size_t i = 0; i < order.size (); ++i)
     {
-      points[j + 0] = static_cast<coordT> ((*input_)[(*indices_)[i]].x);
-      points[j + 1] = static_cast<coordT> ((*input_)[(*indices_)[i]].y);
+      while (k >= 2 && cross (chain[k - 2], chain[k - 1], order[i]) <= 0)
+        --k;
+      chain[k++] = order[i];
     }
-  } 
-  else if (yz_proj_safe)
-  {
-    for (std::size_t i = 0; i < indices_->size (); ++i, j+=dimension)
+    for (std::size_t i = order.size () - 1, lower_size = k + 1; i > 0; --i)
     {
-      points[j + 0] = static_cast<coordT> ((*input_)[(*indices_)[i]].y);
-      points[j + 1] = static_cast<coordT> ((*input_)[(*indices_)[i]].z);
+      while (k >= lower_size && cross (chain[k - 2], chain[k - 1], order[i - 1]) <= 0)
+        --k;
+      chain[k++] = order[i - 1];
     }
-  }
-  else if (xz_proj_safe)
-  {
-    for (std::size_t i = 0; i < indices_->size (); ++i, j+=dimension)
+    // The last point closes the chain
+    chain.resize (k > 0 ? k - 1 : 0);
+
+    if (chain.size () < 3)
+    {
+      PCL_ERROR ("[pcl::%s::performReconstrution2D] ERROR: unable to compute a convex hull for the given point cloud (%lu)!\n", getClassName ().c_str (), indices_->size ());
+
+      hull.points.resize (0);
+      hull.width = hull.height = 0;
+      polygons.resize (0);
+      return;
+    }
+
+    if (compute_area_)
     {
-      points[j + 0] = static_cast<coordT> ((*input_)[(*indices_)[i]].x);
-      points[j + 1] = static_cast<coordT> ((*input_)[(*indices_)[i]].z);
+      double area = 0.0;
+      for (std::size_t i = 0; i < chain.size (); ++i)
+      {
+        const Eigen::Vector2d pa = projected (chain[i]), pb = projected (chain[(i + 1) % chain.size ()]);
+        area += pa[0] * pb[1] - pa[1] * pb[0];
+      }
+      total_area_ = 0.5 * std::abs (area);
+      total_volume_ = 0.0;
     }
+    hull_positions.swap (chain);
   }
   else
   {
-    // This should only happen if we had invalid input
-    PCL_ERROR ("[pcl::%s::performReconstruction2D] Invalid input!\n", getClassName ().c_str ());
-  }
-   
-  // Compute convex hull
-  int exitcode = qh_new_qhull (dimension, static_cast<int> (indices_->size ()), points, ismalloc, const_cast<char*> (flags), outfile, errfile);
+    // True if qhull should free points in qh_freeqhull() or reallocation
+    boolT ismalloc = True;
+    // output from qh_produce_output(), use NULL to skip qh_produce_output()
+    FILE *outfile = nullptr;
+
+#ifndef HAVE_QHULL_2011
+    if (compute_area_)
+      outfile = stderr;
+#endif
+
+    // option flags for qhull, see qh_opt.htm
+    const char* flags = qhull_flags.c_str ();
+    // error messages from qhull code
+    FILE *errfile = stderr;
+
+    // Array of coordinates for each point
+    coordT *points = reinterpret_cast<coordT*> (calloc (indices_->size () * dimension, sizeof (coordT)));
+
+    // Build input data, using appropriate projection
+    for (std::size_t i = 0; i < indices_->size (); ++i)
+    {
+      const Eigen::Vector2d point = projected (i);
+      points[i * dimension + 0] = static_cast<coordT> (point[0]);
+      points[i * dimension + 1] = static_cast<coordT> (point[1]);
+    }
+
+    // Compute convex hull
+    int exitcode = qh_new_qhull (dimension, static_cast<int> (indices_->size ()), points, ismalloc, const_cast<char*> (flags), outfile, errfile);
 #ifdef HAVE_QHULL_2011
-  if (compute_area_)
-  {
-    qh_prepare_output();
-  }
+    if (compute_area_)
+    {
+      qh_prepare_output();
+    }
 #endif
-    
-  // 0 if no error from qhull or it doesn't find any vertices
-  if (exitcode != 0 || qh num_vertices == 0)
-  {
-    PCL_ERROR ("[pcl::%s::performReconstrution2D] ERROR: qhull was unable to compute a convex hull for the given point cloud (%lu)!\n", getClassName ().c_str (), indices_->size ());
 
-    hull.points.resize (0);
-    hull.width = hull.height = 0;
-    polygons.resize (0);
+    // 0 if no error from qhull or it doesn't find any vertices
+    if (exitcode != 0 || qh num_vertices == 0)
+    {
+      PCL_ERROR ("[pcl::%s::performReconstrution2D] ERROR: qhull was unable to compute a convex hull for the given point cloud (%lu)!\n", getClassName ().c_str (), indices_->size ());
 
-    qh_freeqhull (!qh_ALL);
-    int curlong, totlong;
-    qh_memfreeshort (&curlong, &totlong);
+      hull.points.resize (0);
+      hull.width = hull.height = 0;
+      polygons.resize (0);
 
-    return;
-  }
+      qh_freeqhull (!qh_ALL);
+      int curlong, totlong;
+      qh_memfreeshort (&curlong, &totlong);
 
-  // Qhull returns the area in volume for 2D
-  if (compute_area_)
-  {
-    total_area_ = qh totvol;
-    total_volume_ = 0.0;
-  }
+      return;
+    }
 
-  int num_vertices = qh num_vertices;
-  hull.points.resize (num_vertices);
-  memset (&hull.points[0], hull.size (), sizeof (PointInT));
+    // Qhull returns the area in volume for 2D
+    if (compute_area_)
+    {
+      total_area_ = qh totvol;
+      total_volume_ = 0.0;
+    }
 
-  vertexT * vertex;
-  int i = 0;
+    hull_positions.reserve (qh num_vertices);
+    vertexT * vertex;
+    FORALLvertices
+      hull_positions.push_back (qh_pointid (vertex->point));
 
-  std::vector<std::pair<int, Eigen::Vector4f>, Eigen::aligned_allocator<std::pair<int, Eigen::Vector4f> > > idx_points (num_vertices);
-  idx_points.resize (hull.size ());
-  memset (&idx_points[0], hull.size (), sizeof (std::pair<int, Eigen::Vector4f>));
+    qh_freeqhull (!qh_ALL);
+    int curlong, totlong;
+    qh_memfreeshort (&curlong, &totlong);
+  }
 
-  FORALLvertices
+  hull.points.resize (hull_positions.size ());
+  std::vector<std::pair<int, Eigen::Vector4f>, Eigen::aligned_allocator<std::pair<int, Eigen::Vector4f> > > idx_points (hull.size ());
+  for (std::size_t i = 0; i < hull_positions.size (); ++i)
   {
-    hull[i] = (*input_)[(*indices_)[qh_pointid (vertex->point)]];
-    idx_points[i].first = qh_pointid (vertex->point);
-    ++i;
+    hull[i] = (*input_)[(*indices_)[hull_positions[i]]];
+    idx_points[i].first = hull_positions[i];
+    idx_points[i].second.setZero ();
   }
 
   // Sort
@@ -273,10 +330,6 @@ pcl::ConvexHull<PointInT>::performReconstruction2D (PointCloud &hull, std::vecto
     hull[j] = (*input_)[(*indices_)[idx_points[j].first]];
     polygons[0].vertices[j] = static_cast<unsigned int> (j);
   }
-    
-  qh_freeqhull (!qh_ALL);
-  int curlong, totlong;
-  qh_memfreeshort (&curlong, &totlong);
 
   hull.width = hull.size ();
   hull.height = 1;
@@ -497,6 +550,27 @@ pcl::ConvexHull<PointInT>::reconstruct (PointCloud &points, std::vector<pcl::Ver
 
   deinitCompute ();
 }
+//////////////////////////////////////////////////////////////////////////
+template <typename PointInT> void
+pcl::ConvexHull<PointInT>::addPoints (const PointCloud &cloud, PointCloud &points,
+                                      std::vector<pcl::Vertices> &polygons)
+{
+  // The hull of the new points and of the previous hull vertices is the hull of all the points
+  PointCloudPtr merged (new PointCloud);
+  merged->header = cloud.header;
+  merged->reserve (incremental_hull_.size () + cloud.size ());
+  merged->insert (merged->end (), incremental_hull_.begin (), incremental_hull_.end ());
+  for (const auto &point : cloud)
+    if (pcl::isFinite (point))
+      merged->push_back (point);
+
+  this->setInputCloud (merged);
+  indices_.reset ();
+  reconstruct (points, polygons);
+  if (!points.empty ())
+    incremental_hull_ = points;
+}
+
 //////////////////////////////////////////////////////////////////////////
 template <typename PointInT> void
 pcl::ConvexHull<PointInT>::getHullPointIndices (pcl::PointIndices &hull_point_indices) const
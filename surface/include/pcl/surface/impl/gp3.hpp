@@ -39,6 +39,15 @@
 #define PCL_SURFACE_IMPL_GP3_H_
 
 #include <pcl/surface/gp3.h>
+#include <pcl/search/kdtree.h> // for KdTree
+
+#include <map>
+#include <tuple>
+#include <unordered_map>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 /////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointInT> void
@@ -77,6 +86,9 @@ pcl::GreedyProjectionTriangulation<PointInT>::reconstructPolygons (std::vector<p
     polygons.clear ();
     return (false);
   }
+  if (tile_size_ > 0)
+    return (reconstructPolygonsInTiles (polygons));
+
   const double sqr_mu = mu_*mu_;
   const double sqr_max_edge = search_radius_*search_radius_;
   if (nnn_ > static_cast<int> (indices_->size ()))
@@ -1050,6 +1062,190 @@ pcl::GreedyProjectionTriangulation<PointInT>::reconstructPolygons (std::vector<p
   return (true);
 }
 
+/////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT> void
+pcl::GreedyProjectionTriangulation<PointInT>::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs ();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT> bool
+pcl::GreedyProjectionTriangulation<PointInT>::reconstructPolygonsInTiles (std::vector<pcl::Vertices> &polygons)
+{
+  using TileKey = std::tuple<int, int, int>;
+  const auto tileKey = [this] (const Eigen::Vector3f &p, float offset)
+  {
+    return (TileKey (static_cast<int> (std::floor ((p[0] + offset) / tile_size_)),
+                     static_cast<int> (std::floor ((p[1] + offset) / tile_size_)),
+                     static_cast<int> (std::floor ((p[2] + offset) / tile_size_))));
+  };
+  // The fronts of a tile are propagated over a margin around it, so that they meet the seams as they would
+  // without tiles as long as the triangles, whose edges are shorter than the search radius, stay local
+  const float margin = static_cast<float> (2 * search_radius_);
+  const int nr_points = static_cast<int> (indices_->size ());
+
+  part_.assign (nr_points, -1);
+  state_.assign (nr_points, NONE);
+  source_.assign (nr_points, NONE);
+  ffn_.assign (nr_points, NONE);
+  sfn_.assign (nr_points, NONE);
+
+  // The points of every tile, as positions in indices_: first the points in the tile, then those of its margin
+  std::map<TileKey, std::vector<int> > tile_points;
+  std::vector<unsigned char> is_finite (nr_points, 0);
+  for (int cp = 0; cp < nr_points; ++cp)
+  {
+    const PointInT &point = (*input_)[(*indices_)[cp]];
+    if (!std::isfinite (point.x) || !std::isfinite (point.y) || !std::isfinite (point.z))
+      continue;
+    is_finite[cp] = 1;
+    tile_points[tileKey (point.getVector3fMap (), 0)].push_back (cp);
+  }
+  std::vector<std::size_t> nr_core_points;
+  nr_core_points.reserve (tile_points.size ());
+  for (const auto &tile : tile_points)
+    nr_core_points.push_back (tile.second.size ());
+  for (int cp = 0; cp < nr_points; ++cp)
+  {
+    if (!is_finite[cp])
+      continue;
+    const Eigen::Vector3f p = (*input_)[(*indices_)[cp]].getVector3fMap ();
+    const TileKey own = tileKey (p, 0), lo = tileKey (p, -margin), hi = tileKey (p, margin);
+    for (int x = std::get<0> (lo); x <= std::get<0> (hi); ++x)
+      for (int y = std::get<1> (lo); y <= std::get<1> (hi); ++y)
+        for (int z = std::get<2> (lo); z <= std::get<2> (hi); ++z)
+        {
+          const TileKey key (x, y, z);
+          if (key == own)
+            continue;
+          const auto tile = tile_points.find (key);
+          if (tile != tile_points.end ())
+            tile->second.push_back (cp);
+        }
+  }
+
+  std::vector<TileKey> tile_keys;
+  std::vector<const std::vector<int>*> tiles;
+  tile_keys.reserve (tile_points.size ());
+  tiles.reserve (tile_points.size ());
+  for (const auto &tile : tile_points)
+  {
+    tile_keys.push_back (tile.first);
+    tiles.push_back (&tile.second);
+  }
+
+  // Triangulate every tile on its own, keeping the triangles centered in it and the state of its own points
+  std::vector<std::vector<pcl::Vertices> > tile_polygons (tiles.size ());
+  std::vector<int> nr_tile_parts (tiles.size (), 0);
+  std::vector<int> point_tile (nr_points, -1);
+#pragma omp parallel for \
+  default(none) \
+  shared(nr_core_points, nr_tile_parts, point_tile, tile_keys, tile_polygons, tileKey, tiles) \
+  schedule(dynamic, 1) \
+  num_threads(threads_)
+  for (std::ptrdiff_t t = 0; t < static_cast<std::ptrdiff_t> (tiles.size ()); ++t)
+  {
+    const std::vector<int> &positions = *tiles[t];
+    for (std::size_t i = 0; i < nr_core_points[t]; ++i)
+    {
+      point_tile[positions[i]] = static_cast<int> (t);
+      state_[positions[i]] = FREE;
+    }
+    // The front propagation needs at least a starting triangle
+    if (positions.size () < 3)
+      continue;
+
+    pcl::IndicesPtr tile_indices (new std::vector<int> (positions.size ()));
+    for (std::size_t i = 0; i < positions.size (); ++i)
+      (*tile_indices)[i] = (*indices_)[positions[i]];
+
+    GreedyProjectionTriangulation<PointInT> gp3;
+    gp3.setMu (mu_);
+    gp3.setSearchRadius (search_radius_);
+    gp3.setMaximumNearestNeighbors (nnn_);
+    gp3.setMinimumAngle (minimum_angle_);
+    gp3.setMaximumAngle (maximum_angle_);
+    gp3.setMaximumSurfaceAngle (eps_angle_);
+    gp3.setNormalConsistency (consistent_);
+    gp3.setConsistentVertexOrdering (consistent_ordering_);
+    gp3.setInputCloud (input_);
+    gp3.setIndices (tile_indices);
+    gp3.setSearchMethod (typename pcl::search::KdTree<PointInT>::Ptr (new pcl::search::KdTree<PointInT> (false)));
+
+    std::vector<pcl::Vertices> local_polygons;
+    gp3.reconstruct (local_polygons);
+
+    for (auto &polygon : local_polygons)
+    {
+      Eigen::Vector3f centroid = Eigen::Vector3f::Zero ();
+      for (auto &vertex : polygon.vertices)
+      {
+        vertex = positions[vertex];
+        centroid += (*input_)[(*indices_)[vertex]].getVector3fMap ();
+      }
+      if (tileKey (centroid / static_cast<float> (polygon.vertices.size ()), 0) == tile_keys[t])
+        tile_polygons[t].push_back (polygon);
+    }
+
+    // The points of this tile are written by this tile only
+    const auto toGlobal = [&positions] (int local) { return (local < 0 ? local : positions[local]); };
+    for (std::size_t i = 0; i < nr_core_points[t]; ++i)
+    {
+      const int cp = positions[i];
+      state_[cp] = gp3.state_[i];
+      part_[cp] = gp3.part_[i];
+      source_[cp] = toGlobal (gp3.source_[i]);
+      ffn_[cp] = toGlobal (gp3.ffn_[i]);
+      sfn_[cp] = toGlobal (gp3.sfn_[i]);
+      nr_tile_parts[t] = (std::max) (nr_tile_parts[t], gp3.part_[i] + 1);
+    }
+  }
+
+  // Number the parts of the tiles one after the other
+  std::vector<int> part_offsets (tiles.size (), 0);
+  for (std::size_t t = 1; t < tiles.size (); ++t)
+    part_offsets[t] = part_offsets[t - 1] + nr_tile_parts[t - 1];
+  for (int cp = 0; cp < nr_points; ++cp)
+    if (part_[cp] >= 0)
+      part_[cp] += part_offsets[point_tile[cp]];
+
+  // Stitch the tiles in order, dropping the triangles that overlap the ones of a previous tile across a seam
+  std::unordered_map<std::uint64_t, int> edge_triangles;
+  const auto edgeKey = [nr_points] (std::uint32_t a, std::uint32_t b)
+  {
+    return (static_cast<std::uint64_t> ((std::min) (a, b)) * nr_points + (std::max) (a, b));
+  };
+  for (const auto &local_polygons : tile_polygons)
+    for (const auto &polygon : local_polygons)
+    {
+      const std::uint64_t edges[3] = {edgeKey (polygon.vertices[0], polygon.vertices[1]),
+                                      edgeKey (polygon.vertices[1], polygon.vertices[2]),
+                                      edgeKey (polygon.vertices[2], polygon.vertices[0])};
+      bool is_manifold = true;
+      for (const auto &edge : edges)
+      {
+        const auto it = edge_triangles.find (edge);
+        if (it != edge_triangles.end () && it->second >= 2)
+          is_manifold = false;
+      }
+      if (!is_manifold)
+        continue;
+      for (const auto &edge : edges)
+        ++edge_triangles[edge];
+      polygons.push_back (polygon);
+    }
+
+  return (true);
+}
+
 /////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointInT> void
 pcl::GreedyProjectionTriangulation<PointInT>::closeTriangle (std::vector<pcl::Vertices> &polygons)
@@ -41,12 +41,34 @@
 #include <pcl/common/vector_average.h>
 #include <pcl/Vertices.h>
 
+#include <algorithm>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+template <typename PointNT> constexpr int pcl::MarchingCubes<PointNT>::block_size_;
+
 //////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointNT>
 pcl::MarchingCubes<PointNT>::~MarchingCubes ()
 {
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointNT> void
+pcl::MarchingCubes<PointNT>::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs ();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointNT> void
 pcl::MarchingCubes<PointNT>::getBoundingBox ()
@@ -84,6 +106,24 @@ pcl::MarchingCubes<PointNT>::createSurface (const std::vector<float> &leaf_node,
                                             const Eigen::Vector3i &index_3d,
                                             pcl::PointCloud<PointNT> &cloud)
 {
+  std::vector<std::uint64_t> vertex_edges;
+  createSurface (leaf_node, index_3d, cloud, vertex_edges);
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointNT> void
+pcl::MarchingCubes<PointNT>::createSurface (const std::vector<float> &leaf_node,
+                                            const Eigen::Vector3i &index_3d,
+                                            pcl::PointCloud<PointNT> &cloud,
+                                            std::vector<std::uint64_t> &vertex_edges)
+{
+  // The first corner and the axis of the 12 edges of the cube, with the corners numbered as in p below
+  static const int edge_corner[12][4] = {
+    {0, 0, 0, 0}, {1, 0, 0, 2}, {0, 0, 1, 0}, {0, 0, 0, 2},
+    {0, 1, 0, 0}, {1, 1, 0, 2}, {0, 1, 1, 0}, {0, 1, 0, 2},
+    {0, 0, 0, 1}, {1, 0, 0, 1}, {1, 0, 1, 1}, {0, 0, 1, 1}};
+
   int cubeindex = 0;
   if (leaf_node[0] < iso_level_) cubeindex |= 1;
   if (leaf_node[1] < iso_level_) cubeindex |= 2;
@@ -147,15 +187,17 @@ pcl::MarchingCubes<PointNT>::createSurface (const std::vector<float> &leaf_node,
     interpolateEdge (p[3], p[7], leaf_node[3], leaf_node[7], vertex_list[11]);
 
   // Create the triangle
-  for (int i = 0; triTable[cubeindex][i] != -1; i += 3)
+  for (int i = 0; triTable[cubeindex][i] != -1; ++i)
   {
-    PointNT p1, p2, p3;
-    p1.getVector3fMap () = vertex_list[triTable[cubeindex][i]];
+    const int edge = triTable[cubeindex][i];
+    PointNT p1;
+    p1.getVector3fMap () = vertex_list[edge];
     cloud.push_back (p1);
-    p2.getVector3fMap () = vertex_list[triTable[cubeindex][i+1]];
-    cloud.push_back (p2);
-    p3.getVector3fMap () = vertex_list[triTable[cubeindex][i+2]];
-    cloud.push_back (p3);
+
+    const std::uint64_t x = index_3d[0] + edge_corner[edge][0],
+                        y = index_3d[1] + edge_corner[edge][1],
+                        z = index_3d[2] + edge_corner[edge][2];
+    vertex_edges.push_back (((x * res_y_ + y) * res_z_ + z) * 3 + edge_corner[edge][3]);
   }
 }
 
@@ -199,10 +241,136 @@ pcl::MarchingCubes<PointNT>::getGridValue (Eigen::Vector3i pos)
   if (pos[2] < 0 || pos[2] >= res_z_)
     return -1.0f;
 
+  if (sparse_grid_)
+  {
+    const std::uint64_t block = (static_cast<std::uint64_t> (pos[0] / block_size_) * res_y_
+      + pos[1] / block_size_) * res_z_ + pos[2] / block_size_;
+    const auto it = grid_blocks_.find (block);
+    if (it == grid_blocks_.end ())
+      return NAN;
+    return it->second[((pos[0] % block_size_) * block_size_ + pos[1] % block_size_) * block_size_
+      + pos[2] % block_size_];
+  }
+
   return grid_[pos[0]*res_y_*res_z_ + pos[1]*res_z_ + pos[2]];
 }
 
 
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointNT> void
+pcl::MarchingCubes<PointNT>::setGridValue (const Eigen::Vector3i &pos, float value)
+{
+  if (sparse_grid_)
+  {
+    const std::uint64_t block = (static_cast<std::uint64_t> (pos[0] / block_size_) * res_y_
+      + pos[1] / block_size_) * res_z_ + pos[2] / block_size_;
+    const auto it = grid_blocks_.find (block);
+    if (it != grid_blocks_.end ())
+      it->second[((pos[0] % block_size_) * block_size_ + pos[1] % block_size_) * block_size_
+        + pos[2] % block_size_] = value;
+    return;
+  }
+
+  grid_[pos[0]*res_y_*res_z_ + pos[1]*res_z_ + pos[2]] = value;
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointNT> void
+pcl::MarchingCubes<PointNT>::allocateGrid ()
+{
+  grid_blocks_.clear ();
+  if (!sparse_grid_)
+  {
+    grid_ = std::vector<float> (res_x_*res_y_*res_z_, NAN);
+    return;
+  }
+  grid_.clear ();
+
+  // Every block holding a point, and the blocks around it, so that the cubes near the points are complete
+  const Eigen::Vector3i nr_blocks ((res_x_ + block_size_ - 1) / block_size_,
+                                   (res_y_ + block_size_ - 1) / block_size_,
+                                   (res_z_ + block_size_ - 1) / block_size_);
+  for (const auto &point : *input_)
+  {
+    if (!pcl::isFinite (point))
+      continue;
+    const Eigen::Array3f voxel = (point.getArray3fMap () - lower_boundary_) / size_voxel_;
+    Eigen::Vector3i block;
+    for (int d = 0; d < 3; ++d)
+      block[d] = std::min (std::max (static_cast<int> (voxel[d]), 0), nr_blocks[d] * block_size_ - 1) / block_size_;
+
+    for (int bx = std::max (block[0] - 1, 0); bx <= std::min (block[0] + 1, nr_blocks[0] - 1); ++bx)
+      for (int by = std::max (block[1] - 1, 0); by <= std::min (block[1] + 1, nr_blocks[1] - 1); ++by)
+        for (int bz = std::max (block[2] - 1, 0); bz <= std::min (block[2] + 1, nr_blocks[2] - 1); ++bz)
+        {
+          const std::uint64_t key = (static_cast<std::uint64_t> (bx) * res_y_ + by) * res_z_ + bz;
+          if (grid_blocks_.find (key) == grid_blocks_.end ())
+            grid_blocks_[key] = std::vector<float> (block_size_ * block_size_ * block_size_, NAN);
+        }
+  }
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointNT> void
+pcl::MarchingCubes<PointNT>::getGridBoxes (
+    std::vector<Eigen::Vector3i, Eigen::aligned_allocator<Eigen::Vector3i> > &box_origins,
+    Eigen::Vector3i &box_size) const
+{
+  box_origins.clear ();
+  if (!sparse_grid_)
+  {
+    box_size = Eigen::Vector3i (1, res_y_, res_z_);
+    for (int x = 0; x < res_x_; ++x)
+      box_origins.emplace_back (x, 0, 0);
+    return;
+  }
+
+  box_size = Eigen::Vector3i::Constant (block_size_);
+  std::vector<std::uint64_t> keys;
+  keys.reserve (grid_blocks_.size ());
+  for (const auto &block : grid_blocks_)
+    keys.push_back (block.first);
+  std::sort (keys.begin (), keys.end ());
+
+  box_origins.reserve (keys.size ());
+  for (const std::uint64_t key : keys)
+    box_origins.emplace_back (static_cast<int> (key / res_z_ / res_y_) * block_size_,
+                              static_cast<int> (key / res_z_ % res_y_) * block_size_,
+                              static_cast<int> (key % res_z_) * block_size_);
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointNT> void
+pcl::MarchingCubes<PointNT>::computeGridValues (const std::function<float (const Eigen::Vector3i &)> &value)
+{
+  std::vector<Eigen::Vector3i, Eigen::aligned_allocator<Eigen::Vector3i> > box_origins;
+  Eigen::Vector3i box_size;
+  getGridBoxes (box_origins, box_size);
+
+  const int nr_boxes = static_cast<int> (box_origins.size ());
+#pragma omp parallel for \
+  default(none) \
+  shared(box_origins, box_size, nr_boxes, value) \
+  schedule(dynamic) \
+  num_threads(threads_)
+  for (int b = 0; b < nr_boxes; ++b)
+  {
+    const Eigen::Vector3i &origin = box_origins[b];
+    const Eigen::Vector3i end = (origin + box_size).cwiseMin (Eigen::Vector3i (res_x_, res_y_, res_z_));
+    for (int x = origin[0]; x < end[0]; ++x)
+      for (int y = origin[1]; y < end[1]; ++y)
+        for (int z = origin[2]; z < end[2]; ++z)
+        {
+          const Eigen::Vector3i pos (x, y, z);
+          setGridValue (pos, value (pos));
+        }
+  }
+}
+
+
 //////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointNT> void
 pcl::MarchingCubes<PointNT>::performReconstruction (pcl::PolygonMesh &output)
@@ -215,10 +383,33 @@ pcl::MarchingCubes<PointNT>::performReconstruction (pcl::PolygonMesh &output)
 }
 
 
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointNT> void
+pcl::MarchingCubes<PointNT>::performTriangleMeshReconstruction (pcl::TriangleMesh &output)
+{
+  pcl::PointCloud<PointNT> points;
+
+  extractTriangles (points, output.triangles);
+
+  pcl::toPCLPointCloud2 (points, output.cloud);
+}
+
+
 //////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointNT> void
 pcl::MarchingCubes<PointNT>::performReconstruction (pcl::PointCloud<PointNT> &points,
                                                     std::vector<pcl::Vertices> &polygons)
+{
+  std::vector<std::uint32_t> triangles;
+  extractTriangles (points, triangles);
+  pcl::trianglesToPolygons (triangles, polygons);
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointNT> void
+pcl::MarchingCubes<PointNT>::extractTriangles (pcl::PointCloud<PointNT> &points,
+                                               std::vector<std::uint32_t> &triangles)
 {
   if (!(iso_level_ >= 0 && iso_level_ < 1))
   {
@@ -226,52 +417,90 @@ pcl::MarchingCubes<PointNT>::performReconstruction (pcl::PointCloud<PointNT> &po
         getClassName ().c_str (), iso_level_);
     points.width = points.height = 0;
     points.points.clear ();
-    polygons.clear ();
+    triangles.clear ();
     return;
   }
 
   // the point cloud really generated from Marching Cubes, prev intermediate_cloud_
   pcl::PointCloud<PointNT> intermediate_cloud;
 
-  // Create grid
-  grid_ = std::vector<float> (res_x_*res_y_*res_z_, NAN);
-
   // Compute bounding box and voxel size
   getBoundingBox ();
   size_voxel_ = (upper_boundary_ - lower_boundary_) 
     * Eigen::Array3f (res_x_, res_y_, res_z_).inverse ();
 
+  // Create grid
+  allocateGrid ();
+
   // Transform the point cloud into a voxel grid
   // This needs to be implemented in a child class
   voxelizeData ();
 
-  // preallocate memory assuming a hull. suppose 6 point per voxel
-  double size_reserve = std::min((double) intermediate_cloud.points.max_size (),
-      2.0 * 6.0 * (double) (res_y_*res_z_ + res_x_*res_z_ + res_x_*res_y_));
-  intermediate_cloud.reserve ((std::size_t) size_reserve);
-
-  for (int x = 1; x < res_x_-1; ++x)
-    for (int y = 1; y < res_y_-1; ++y)
-      for (int z = 1; z < res_z_-1; ++z)
-      {
-        Eigen::Vector3i index_3d (x, y, z);
-        std::vector<float> leaf_node;
-        getNeighborList1D (leaf_node, index_3d);
-        if (!leaf_node.empty ())
-          createSurface (leaf_node, index_3d, intermediate_cloud);
-      }
-
-  points.swap (intermediate_cloud);
-
-  polygons.resize (points.size () / 3);
-  for (std::size_t i = 0; i < polygons.size (); ++i)
+  // Extract the triangles of every box of the grid separately, then concatenate them in order
+  std::vector<Eigen::Vector3i, Eigen::aligned_allocator<Eigen::Vector3i> > box_origins;
+  Eigen::Vector3i box_size;
+  getGridBoxes (box_origins, box_size);
+
+  const int nr_boxes = static_cast<int> (box_origins.size ());
+  std::vector<pcl::PointCloud<PointNT> > box_clouds (nr_boxes);
+  std::vector<std::vector<std::uint64_t> > box_edges (nr_boxes);
+#pragma omp parallel for \
+  default(none) \
+  shared(box_origins, box_size, nr_boxes, box_clouds, box_edges) \
+  schedule(dynamic) \
+  num_threads(threads_)
+  for (int b = 0; b < nr_boxes; ++b)
+  {
+    const Eigen::Vector3i begin = box_origins[b].cwiseMax (Eigen::Vector3i::Ones ());
+    const Eigen::Vector3i end = (box_origins[b] + box_size).cwiseMin (Eigen::Vector3i (res_x_-1, res_y_-1, res_z_-1));
+    std::vector<float> leaf_node;
+    for (int x = begin[0]; x < end[0]; ++x)
+      for (int y = begin[1]; y < end[1]; ++y)
+        for (int z = begin[2]; z < end[2]; ++z)
+        {
+          Eigen::Vector3i index_3d (x, y, z);
+          getNeighborList1D (leaf_node, index_3d);
+          if (!leaf_node.empty ())
+            createSurface (leaf_node, index_3d, box_clouds[b], box_edges[b]);
+        }
+  }
+
+  std::size_t nr_vertices = 0;
+  for (const auto &box_cloud : box_clouds)
+    nr_vertices += box_cloud.size ();
+  intermediate_cloud.reserve (nr_vertices);
+  std::vector<std::uint64_t> vertex_edges;
+  vertex_edges.reserve (nr_vertices);
+  for (int b = 0; b < nr_boxes; ++b)
+  {
+    intermediate_cloud.insert (intermediate_cloud.end (), box_clouds[b].begin (), box_clouds[b].end ());
+    vertex_edges.insert (vertex_edges.end (), box_edges[b].begin (), box_edges[b].end ());
+  }
+
+  triangles.resize (intermediate_cloud.size () / 3 * 3);
+  if (!weld_vertices_)
+  {
+    points.swap (intermediate_cloud);
+
+    for (std::size_t i = 0; i < triangles.size (); ++i)
+      triangles[i] = static_cast<std::uint32_t> (i);
+    return;
+  }
+
+  // Keep one vertex per grid edge
+  std::unordered_map<std::uint64_t, std::uint32_t> edge_vertex;
+  edge_vertex.reserve (nr_vertices / 2);
+  pcl::PointCloud<PointNT> welded_cloud;
+  welded_cloud.reserve (nr_vertices / 2);
+  for (std::size_t i = 0; i < triangles.size (); ++i)
   {
-    pcl::Vertices v;
-    v.vertices.resize (3);
-    for (int j = 0; j < 3; ++j)
-      v.vertices[j] = static_cast<int> (i) * 3 + j;
-    polygons[i] = v;
+    const auto inserted = edge_vertex.emplace (vertex_edges[i],
+                                               static_cast<std::uint32_t> (welded_cloud.size ()));
+    if (inserted.second)
+      welded_cloud.push_back (intermediate_cloud[i]);
+    triangles[i] = inserted.first->second;
   }
+  points.swap (welded_cloud);
 }
 
 #define PCL_INSTANTIATE_MarchingCubes(T) template class PCL_EXPORTS pcl::MarchingCubes<T>;
@@ -43,6 +43,14 @@
 #include <pcl/common/common.h>
 #include <pcl/common/vector_average.h>
 #include <pcl/Vertices.h>
+#include <pcl/search/kdtree.h>
+
+#include <Eigen/IterativeLinearSolvers>
+#include <Eigen/SparseCore>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 //////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointNT>
@@ -54,6 +62,12 @@ pcl::MarchingCubesRBF<PointNT>::~MarchingCubesRBF ()
 template <typename PointNT> void
 pcl::MarchingCubesRBF<PointNT>::voxelizeData ()
 {
+  if (support_radius_ > 0.0f)
+  {
+    voxelizeDataCompact ();
+    return;
+  }
+
   // Initialize data structures
   const unsigned int N = static_cast<unsigned int> (input_->size ());
   Eigen::MatrixXd M (2*N, 2*N),
@@ -90,22 +104,20 @@ pcl::MarchingCubesRBF<PointNT>::voxelizeData ()
     weights[i + N] = w (i + N, 0);
   }
 
-  for (int x = 0; x < res_x_; ++x)
-    for (int y = 0; y < res_y_; ++y)
-      for (int z = 0; z < res_z_; ++z)
-      {
-        const Eigen::Vector3f point_f = (size_voxel_ * Eigen::Array3f (x, y, z) 
-            + lower_boundary_).matrix ();
-        const Eigen::Vector3d point = point_f.cast<double> ();
-
-        double f = 0.0;
-        std::vector<double>::const_iterator w_it (weights.begin());
-        for (std::vector<Eigen::Vector3d, Eigen::aligned_allocator<Eigen::Vector3d> >::const_iterator c_it = centers.begin ();
-             c_it != centers.end (); ++c_it, ++w_it)
-          f += *w_it * kernel (*c_it, point);
-
-        grid_[x * res_y_*res_z_ + y * res_z_ + z] = float (f);
-      }
+  computeGridValues ([this, &weights, &centers] (const Eigen::Vector3i &pos)
+  {
+    const Eigen::Vector3f point_f = (size_voxel_ * pos.cast<float> ().array ()
+        + lower_boundary_).matrix ();
+    const Eigen::Vector3d point = point_f.cast<double> ();
+
+    double f = 0.0;
+    std::vector<double>::const_iterator w_it (weights.begin());
+    for (std::vector<Eigen::Vector3d, Eigen::aligned_allocator<Eigen::Vector3d> >::const_iterator c_it = centers.begin ();
+         c_it != centers.end (); ++c_it, ++w_it)
+      f += *w_it * kernel (*c_it, point);
+
+    return float (f);
+  });
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////
@@ -116,6 +128,107 @@ pcl::MarchingCubesRBF<PointNT>::kernel (Eigen::Vector3d c, Eigen::Vector3d x)
   return (r * r * r);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointNT> double
+pcl::MarchingCubesRBF<PointNT>::compactKernel (double r) const
+{
+  const double q = r / support_radius_;
+  if (q >= 1.0)
+    return (0.0);
+  const double t = (1.0 - q) * (1.0 - q);
+  return (t * t * (4.0 * q + 1.0));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointNT> void
+pcl::MarchingCubesRBF<PointNT>::voxelizeDataCompact ()
+{
+  if (off_surface_epsilon_ >= support_radius_)
+    PCL_WARN ("[pcl::MarchingCubesRBF::voxelizeData] The off-surface displacement %f should be smaller than the support radius %f.\n",
+              off_surface_epsilon_, support_radius_);
+
+  // The centers on the surface, then outside and inside of it
+  pcl::PointCloud<pcl::PointXYZ>::Ptr centers (new pcl::PointCloud<pcl::PointXYZ>);
+  std::vector<double> values;
+  for (int side = 0; side < 3; ++side)
+  {
+    const float offset = side == 0 ? 0.0f : (side == 1 ? off_surface_epsilon_ : -off_surface_epsilon_);
+    for (const auto &point : *input_)
+    {
+      if (!pcl::isFinite (point) || !std::isfinite (point.normal_x) || !std::isfinite (point.normal_y) ||
+          !std::isfinite (point.normal_z))
+        continue;
+      pcl::PointXYZ center;
+      center.getVector3fMap () = point.getVector3fMap () + offset * point.getNormalVector3fMap ();
+      centers->push_back (center);
+      values.push_back (offset);
+    }
+  }
+  if (centers->empty ())
+    return;
+
+  pcl::search::KdTree<pcl::PointXYZ> centers_tree;
+  centers_tree.setInputCloud (centers);
+
+  // Only the centers closer than the support radius interact, so the system is sparse
+  const int nr_centers = static_cast<int> (centers->size ());
+  std::vector<std::vector<Eigen::Triplet<double> > > rows (nr_centers);
+#pragma omp parallel for \
+  default(none) \
+  shared(centers, centers_tree, nr_centers, rows) \
+  schedule(dynamic, 256) \
+  num_threads(threads_)
+  for (int row_i = 0; row_i < nr_centers; ++row_i)
+  {
+    pcl::Indices nn_indices;
+    std::vector<float> nn_sqr_dists;
+    centers_tree.radiusSearch ((*centers)[row_i], support_radius_, nn_indices, nn_sqr_dists);
+    rows[row_i].reserve (nn_indices.size ());
+    for (std::size_t i = 0; i < nn_indices.size (); ++i)
+      rows[row_i].emplace_back (row_i, nn_indices[i], compactKernel (std::sqrt (nn_sqr_dists[i])));
+  }
+
+  std::vector<Eigen::Triplet<double> > triplets;
+  std::size_t nr_triplets = 0;
+  for (const auto &row : rows)
+    nr_triplets += row.size ();
+  triplets.reserve (nr_triplets);
+  for (auto &row : rows)
+  {
+    triplets.insert (triplets.end (), row.begin (), row.end ());
+    std::vector<Eigen::Triplet<double> > ().swap (row);
+  }
+
+  Eigen::SparseMatrix<double> M (nr_centers, nr_centers);
+  M.setFromTriplets (triplets.begin (), triplets.end ());
+  std::vector<Eigen::Triplet<double> > ().swap (triplets);
+
+  // Solve for the weights; the matrix is symmetric positive definite
+  Eigen::ConjugateGradient<Eigen::SparseMatrix<double>, Eigen::Lower | Eigen::Upper> solver;
+  solver.setTolerance (1e-5);
+  solver.compute (M);
+  const Eigen::VectorXd weights = solver.solve (Eigen::Map<const Eigen::VectorXd> (values.data (), nr_centers));
+  if (solver.info () != Eigen::Success)
+    PCL_WARN ("[pcl::MarchingCubesRBF::voxelizeData] The weights did not converge (error %g after %d iterations).\n",
+              solver.error (), static_cast<int> (solver.iterations ()));
+
+  computeGridValues ([this, &centers_tree, &weights] (const Eigen::Vector3i &pos)
+  {
+    pcl::PointXYZ point;
+    point.getVector3fMap () = (size_voxel_ * pos.cast<float> ().array () + lower_boundary_).matrix ();
+
+    pcl::Indices nn_indices;
+    std::vector<float> nn_sqr_dists;
+    if (centers_tree.radiusSearch (point, support_radius_, nn_indices, nn_sqr_dists) == 0)
+      return std::numeric_limits<float>::quiet_NaN ();
+
+    double f = 0.0;
+    for (std::size_t i = 0; i < nn_indices.size (); ++i)
+      f += weights[nn_indices[i]] * compactKernel (std::sqrt (nn_sqr_dists[i]));
+    return float (f);
+  });
+}
+
 #define PCL_INSTANTIATE_MarchingCubesRBF(T) template class PCL_EXPORTS pcl::MarchingCubesRBF<T>;
 
 #endif    // PCL_SURFACE_IMPL_MARCHING_CUBES_HOPPE_H_
@@ -48,9 +48,12 @@
 #include <pcl/common/centroid.h>
 #include <pcl/common/eigen.h>
 #include <pcl/common/geometry.h>
+#include <pcl/common/utils.h> // for getNumberOfThreads
 #include <pcl/search/kdtree.h> // for KdTree
 #include <pcl/search/organized.h> // for OrganizedNeighbor
 
+#include <algorithm> // for sort
+
 #ifdef _OPENMP
 #include <omp.h>
 #endif
@@ -113,8 +116,11 @@ pcl::MovingLeastSquares<PointInT, PointOutT>::process (PointCloudOut &output)
     // Initialize random number generator if necessary
     case (RANDOM_UNIFORM_DENSITY):
     {
+      // One generator per thread, as the points are upsampled in parallel
       std::random_device rd;
-      rng_.seed (rd());
+      rng_.resize (threads_ == 0 ? 1 : threads_);
+      for (auto &rng : rng_)
+        rng.seed (rd ());
       const double tmp = search_radius_ / 2.0;
       rng_uniform_distribution_.reset (new std::uniform_real_distribution<> (-tmp, tmp));
 
@@ -218,11 +224,19 @@ pcl::MovingLeastSquares<PointInT, PointOutT>::computeMLSPointNormal (int index,
       }
       else
       {
+        // Draw from the generator of this thread
+#ifdef _OPENMP
+        std::mt19937 &rng = rng_[omp_get_thread_num ()];
+#else
+        std::mt19937 &rng = rng_[0];
+#endif
+        std::uniform_real_distribution<> uniform_distribution (rng_uniform_distribution_->param ());
+
         // Sample the local plane
         for (int num_added = 0; num_added < num_points_to_add;)
         {
-          const double u = (*rng_uniform_distribution_) (rng_);
-          const double v = (*rng_uniform_distribution_) (rng_);
+          const double u = uniform_distribution (rng);
+          const double v = uniform_distribution (rng);
 
           // Check if inside circle; if not, try another coin flip
           if (u * u + v * v > search_radius_ * search_radius_ / 4)
@@ -287,7 +301,7 @@ pcl::MovingLeastSquares<PointInT, PointOutT>::performProcessing (PointCloudOut &
 
 #ifdef _OPENMP
   // (Maximum) number of threads
-  const unsigned int threads = threads_ == 0 ? 1 : threads_;
+  const unsigned int threads = pcl::utils::getNumberOfThreads (threads_ == 0 ? 1 : threads_);
   // Create temporaries for each thread in order to avoid synchronization
   typename PointCloudOut::CloudVectorType projected_points (threads);
   typename NormalCloud::CloudVectorType projected_points_normals (threads);
@@ -368,67 +382,87 @@ pcl::MovingLeastSquares<PointInT, PointOutT>::performProcessing (PointCloudOut &
 template <typename PointInT, typename PointOutT> void
 pcl::MovingLeastSquares<PointInT, PointOutT>::performUpsampling (PointCloudOut &output)
 {
+  if (upsample_method_ != DISTINCT_CLOUD && upsample_method_ != VOXEL_GRID_DILATION)
+    return;
 
-  if (upsample_method_ == DISTINCT_CLOUD)
-  {
-    corresponding_input_indices_.reset (new PointIndices);
-    for (std::size_t dp_i = 0; dp_i < distinct_cloud_->size (); ++dp_i) // dp_i = distinct_point_i
-    {
-      // Distinct cloud may have nan points, skip them
-      if (!std::isfinite ((*distinct_cloud_)[dp_i].x))
-        continue;
-
-      // Get 3D position of point
-      //Eigen::Vector3f pos = (*distinct_cloud_)[dp_i].getVector3fMap ();
-      std::vector<int> nn_indices;
-      std::vector<float> nn_dists;
-      tree_->nearestKSearch ((*distinct_cloud_)[dp_i], 1, nn_indices, nn_dists);
-      int input_index = nn_indices.front ();
-
-      // If the closest point did not have a valid MLS fitting result
-      // OR if it is too far away from the sampled point
-      if (mls_results_[input_index].valid == false)
-        continue;
-
-      Eigen::Vector3d add_point = (*distinct_cloud_)[dp_i].getVector3fMap ().template cast<double> ();
-      MLSResult::MLSProjectionResults proj =  mls_results_[input_index].projectPoint (add_point, projection_method_,  5 * nr_coeff_);
-      addProjectedPointNormal (input_index, proj.point, proj.normal, mls_results_[input_index].curvature, output, *normals_, *corresponding_input_indices_);
-    }
-  }
+  corresponding_input_indices_.reset (new PointIndices);
 
-  // For the voxel grid upsampling method, generate the voxel grid and dilate it
-  // Then, project the newly obtained points to the MLS surface
+  // The points to project on the MLS surface of their closest input point
+  PointCloudIn voxel_centers;
   if (upsample_method_ == VOXEL_GRID_DILATION)
   {
-    corresponding_input_indices_.reset (new PointIndices);
-
+    // For the voxel grid upsampling method, generate the voxel grid and dilate it
+    // Then, project the centers of the voxels to the MLS surface
     MLSVoxelGrid voxel_grid (input_, indices_, voxel_size_);
     for (int iteration = 0; iteration < dilation_iteration_num_; ++iteration)
       voxel_grid.dilate ();
 
-    for (typename MLSVoxelGrid::HashMap::iterator m_it = voxel_grid.voxel_grid_.begin (); m_it != voxel_grid.voxel_grid_.end (); ++m_it)
+    // Visit the voxels in the order of their index, independently of the hashing
+    std::vector<std::uint64_t> voxel_indices;
+    voxel_indices.reserve (voxel_grid.voxel_grid_.size ());
+    for (const auto &voxel : voxel_grid.voxel_grid_)
+      voxel_indices.push_back (voxel.first);
+    std::sort (voxel_indices.begin (), voxel_indices.end ());
+
+    voxel_centers.resize (voxel_indices.size ());
+    for (std::size_t i = 0; i < voxel_indices.size (); ++i)
     {
-      // Get 3D position of point
       Eigen::Vector3f pos;
-      voxel_grid.getPosition (m_it->first, pos);
+      voxel_grid.getPosition (voxel_indices[i], pos);
+      voxel_centers[i].x = pos[0];
+      voxel_centers[i].y = pos[1];
+      voxel_centers[i].z = pos[2];
+    }
+  }
+  const PointCloudIn &samples = upsample_method_ == DISTINCT_CLOUD ? *distinct_cloud_ : voxel_centers;
 
-      PointInT p;
-      p.x = pos[0];
-      p.y = pos[1];
-      p.z = pos[2];
+  // (Maximum) number of threads
+  const unsigned int threads = pcl::utils::getNumberOfThreads (threads_ == 0 ? 1 : threads_);
+
+  // The samples are projected in parallel by blocks, each projection written at the place of its sample,
+  // and appended to the output in order, so that the output does not depend on the number of threads
+  const std::size_t block_size = 65536;
+  std::vector<int> sample_input_indices;
+  std::vector<MLSResult::MLSProjectionResults> sample_projections;
+  for (std::size_t block_begin = 0; block_begin < samples.size (); block_begin += block_size)
+  {
+    const std::size_t block_end = std::min (samples.size (), block_begin + block_size);
+    sample_input_indices.assign (block_end - block_begin, -1);
+    sample_projections.resize (block_end - block_begin);
+
+#pragma omp parallel for \
+  default(none) \
+  shared(block_begin, block_end, sample_input_indices, sample_projections, samples) \
+  schedule(dynamic,1000) \
+  num_threads(threads)
+    for (std::ptrdiff_t sp_i = static_cast<std::ptrdiff_t> (block_begin); sp_i < static_cast<std::ptrdiff_t> (block_end); ++sp_i)
+    {
+      // Distinct cloud may have nan points, skip them
+      if (!std::isfinite (samples[sp_i].x))
+        continue;
 
       std::vector<int> nn_indices;
       std::vector<float> nn_dists;
-      tree_->nearestKSearch (p, 1, nn_indices, nn_dists);
-      int input_index = nn_indices.front ();
+      if (tree_->nearestKSearch (samples[sp_i], 1, nn_indices, nn_dists) == 0)
+        continue;
+      const int input_index = nn_indices.front ();
 
       // If the closest point did not have a valid MLS fitting result
       // OR if it is too far away from the sampled point
       if (mls_results_[input_index].valid == false)
         continue;
 
-      Eigen::Vector3d add_point = p.getVector3fMap ().template cast<double> ();
-      MLSResult::MLSProjectionResults proj = mls_results_[input_index].projectPoint (add_point, projection_method_,  5 * nr_coeff_);
+      const Eigen::Vector3d add_point = samples[sp_i].getVector3fMap ().template cast<double> ();
+      sample_projections[sp_i - block_begin] = mls_results_[input_index].projectPoint (add_point, projection_method_, 5 * nr_coeff_);
+      sample_input_indices[sp_i - block_begin] = input_index;
+    }
+
+    for (std::size_t i = 0; i < sample_input_indices.size (); ++i)
+    {
+      const int input_index = sample_input_indices[i];
+      if (input_index < 0)
+        continue;
+      const MLSResult::MLSProjectionResults &proj = sample_projections[i];
       addProjectedPointNormal (input_index, proj.point, proj.normal, mls_results_[input_index].curvature, output, *normals_, *corresponding_input_indices_);
     }
   }
@@ -853,8 +887,7 @@ pcl::MovingLeastSquares<PointInT, PointOutT>::MLSVoxelGrid::MLSVoxelGrid (PointC
 
       std::uint64_t index_1d;
       getIndexIn1D (pos, index_1d);
-      Leaf leaf;
-      voxel_grid_[index_1d] = leaf;
+      voxel_grid_.emplace (index_1d, Leaf ());
     }
 }
 
@@ -863,10 +896,12 @@ template <typename PointInT, typename PointOutT> void
 pcl::MovingLeastSquares<PointInT, PointOutT>::MLSVoxelGrid::dilate ()
 {
   HashMap new_voxel_grid = voxel_grid_;
-  for (typename MLSVoxelGrid::HashMap::iterator m_it = voxel_grid_.begin (); m_it != voxel_grid_.end (); ++m_it)
+  // A dilation step grows a surface-like set of voxels a few times at most
+  new_voxel_grid.reserve (4 * voxel_grid_.size ());
+  for (const auto &voxel : voxel_grid_)
   {
     Eigen::Vector3i index;
-    getIndexIn3D (m_it->first, index);
+    getIndexIn3D (voxel.first, index);
 
     // Now dilate all of its voxels
     for (int x = -1; x <= 1; ++x)
@@ -879,11 +914,10 @@ pcl::MovingLeastSquares<PointInT, PointOutT>::MLSVoxelGrid::dilate ()
 
             std::uint64_t index_1d;
             getIndexIn1D (new_index, index_1d);
-            Leaf leaf;
-            new_voxel_grid[index_1d] = leaf;
+            new_voxel_grid.emplace (index_1d, Leaf ());
           }
   }
-  voxel_grid_ = new_voxel_grid;
+  voxel_grid_.swap (new_voxel_grid);
 }
 
 
@@ -43,16 +43,52 @@
 
 #include <pcl/surface/organized_fast_mesh.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 /////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointInT> void
 pcl::OrganizedFastMesh<PointInT>::performReconstruction (pcl::PolygonMesh &output)
 {
   reconstructPolygons (output.polygons);
+  resetNonFinitePoints (output.cloud);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT> void
+pcl::OrganizedFastMesh<PointInT>::performTriangleMeshReconstruction (pcl::TriangleMesh &output)
+{
+  pcl::Indices face_vertices;
+  makeFaces (triangulation_type_, face_vertices);
+
+  if (triangulation_type_ == QUAD_MESH)
+  {
+    // Split every quad (a, b, c, d) into the triangles (a, b, c) and (a, c, d)
+    const std::size_t nr_quads = face_vertices.size () / 4;
+    output.triangles.resize (6 * nr_quads);
+    for (std::size_t i = 0; i < nr_quads; ++i)
+    {
+      const auto *quad = &face_vertices[4 * i];
+      std::uint32_t *triangles = &output.triangles[6 * i];
+      triangles[0] = quad[0]; triangles[1] = quad[1]; triangles[2] = quad[2];
+      triangles[3] = quad[0]; triangles[4] = quad[2]; triangles[5] = quad[3];
+    }
+  }
+  else
+    output.triangles.assign (face_vertices.begin (), face_vertices.end ());
 
+  resetNonFinitePoints (output.cloud);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT> void
+pcl::OrganizedFastMesh<PointInT>::resetNonFinitePoints (pcl::PCLPointCloud2 &cloud)
+{
   // Get the field names
-  int x_idx = pcl::getFieldIndex (output.cloud, "x");
-  int y_idx = pcl::getFieldIndex (output.cloud, "y");
-  int z_idx = pcl::getFieldIndex (output.cloud, "z");
+  int x_idx = pcl::getFieldIndex (cloud, "x");
+  int y_idx = pcl::getFieldIndex (cloud, "y");
+  int z_idx = pcl::getFieldIndex (cloud, "z");
   if (x_idx == -1 || y_idx == -1 || z_idx == -1)
     return;
   // correct all measurements,
@@ -61,7 +97,7 @@ pcl::OrganizedFastMesh<PointInT>::performReconstruction (pcl::PolygonMesh &outpu
   // avoid to do that here (only needed for ASCII mesh file output, e.g., in vtk files
   for (std::size_t i = 0; i < input_->size (); ++i)
     if (!isFinite ((*input_)[i]))
-      resetPointData (i, output, 0.0f, x_idx, y_idx, z_idx);
+      resetPointData (i, cloud, 0.0f, x_idx, y_idx, z_idx);
 }
 
 /////////////////////////////////////////////////////////////////////////////////////////////
@@ -71,6 +107,35 @@ pcl::OrganizedFastMesh<PointInT>::performReconstruction (std::vector<pcl::Vertic
   reconstructPolygons (polygons);
 }
 
+/////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT> void
+pcl::OrganizedFastMesh<PointInT>::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs ();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT> void
+pcl::OrganizedFastMesh<PointInT>::reconstructFaces (pcl::Indices &face_vertices)
+{
+  if (!this->initCompute ())
+  {
+    face_vertices.clear ();
+    return;
+  }
+
+  makeFaces (triangulation_type_, face_vertices);
+
+  this->deinitCompute ();
+}
+
 /////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointInT> void
 pcl::OrganizedFastMesh<PointInT>::reconstructPolygons (std::vector<pcl::Vertices> &polygons)
@@ -87,194 +152,198 @@ pcl::OrganizedFastMesh<PointInT>::reconstructPolygons (std::vector<pcl::Vertices
 
 /////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointInT> void
-pcl::OrganizedFastMesh<PointInT>::makeQuadMesh (std::vector<pcl::Vertices>& polygons)
+pcl::OrganizedFastMesh<PointInT>::makeRowFaces (int y, TriangulationType type, pcl::Indices &face_vertices)
 {
-  int last_column = input_->width - triangle_pixel_size_columns_;
-  int last_row = input_->height - triangle_pixel_size_rows_;
+  const int last_column = input_->width - triangle_pixel_size_columns_;
+  const int y_big_incr = triangle_pixel_size_rows_ * input_->width,
+            x_big_incr = y_big_incr + triangle_pixel_size_columns_;
+
+  // Initialize a new row
+  int i = y * input_->width;
+  int index_right = i + triangle_pixel_size_columns_;
+  int index_down = i + y_big_incr;
+  int index_down_right = i + x_big_incr;
 
-  int i = 0, index_down = 0, index_right = 0, index_down_right = 0, idx = 0;
-  int y_big_incr = triangle_pixel_size_rows_ * input_->width,
-      x_big_incr = y_big_incr + triangle_pixel_size_columns_;
-  // Reserve enough space
-  polygons.resize (input_->width * input_->height);
+  const auto add_triangle = [&face_vertices] (int a, int b, int c)
+  {
+    face_vertices.push_back (a);
+    face_vertices.push_back (b);
+    face_vertices.push_back (c);
+  };
 
-  // Go over the rows first
-  for (int y = 0; y < last_row; y += triangle_pixel_size_rows_)
+  // Go over the columns
+  for (int x = 0; x < last_column; x += triangle_pixel_size_columns_,
+                                   i += triangle_pixel_size_columns_,
+                                   index_right += triangle_pixel_size_columns_,
+                                   index_down += triangle_pixel_size_columns_,
+                                   index_down_right += triangle_pixel_size_columns_)
   {
-    // Initialize a new row
-    i = y * input_->width;
-    index_right = i + triangle_pixel_size_columns_;
-    index_down = i + y_big_incr;
-    index_down_right = i + x_big_incr;
-
-    // Go over the columns
-    for (int x = 0; x < last_column; x += triangle_pixel_size_columns_,
-                                     i += triangle_pixel_size_columns_,
-                                     index_right += triangle_pixel_size_columns_,
-                                     index_down += triangle_pixel_size_columns_,
-                                     index_down_right += triangle_pixel_size_columns_)
+    switch (type)
     {
-      if (isValidQuad (i, index_right, index_down_right, index_down))
-        if (store_shadowed_faces_ || !isShadowedQuad (i, index_right, index_down_right, index_down))
-          addQuad (i, index_right, index_down_right, index_down, idx++, polygons);
+      case QUAD_MESH:
+      {
+        if (isValidQuad (i, index_right, index_down_right, index_down))
+          if (store_shadowed_faces_ || !isShadowedQuad (i, index_right, index_down_right, index_down))
+          {
+            face_vertices.push_back (i);
+            face_vertices.push_back (index_right);
+            face_vertices.push_back (index_down_right);
+            face_vertices.push_back (index_down);
+          }
+        break;
+      }
+      case TRIANGLE_RIGHT_CUT:
+      {
+        if (isValidTriangle (i, index_down_right, index_right))
+          if (store_shadowed_faces_ || !isShadowedTriangle (i, index_down_right, index_right))
+            add_triangle (i, index_down_right, index_right);
+
+        if (isValidTriangle (i, index_down, index_down_right))
+          if (store_shadowed_faces_ || !isShadowedTriangle (i, index_down, index_down_right))
+            add_triangle (i, index_down, index_down_right);
+        break;
+      }
+      case TRIANGLE_LEFT_CUT:
+      {
+        if (isValidTriangle (i, index_down, index_right))
+          if (store_shadowed_faces_ || !isShadowedTriangle (i, index_down, index_right))
+            add_triangle (i, index_down, index_right);
+
+        if (isValidTriangle (index_right, index_down, index_down_right))
+          if (store_shadowed_faces_ || !isShadowedTriangle (index_right, index_down, index_down_right))
+            add_triangle (index_right, index_down, index_down_right);
+        break;
+      }
+      case TRIANGLE_ADAPTIVE_CUT:
+      {
+        const bool right_cut_upper = isValidTriangle (i, index_down_right, index_right);
+        const bool right_cut_lower = isValidTriangle (i, index_down, index_down_right);
+        const bool left_cut_upper = isValidTriangle (i, index_down, index_right);
+        const bool left_cut_lower = isValidTriangle (index_right, index_down, index_down_right);
+
+        if (right_cut_upper && right_cut_lower && left_cut_upper && left_cut_lower)
+        {
+          float dist_right_cut = std::abs ((*input_)[index_down].z - (*input_)[index_right].z);
+          float dist_left_cut = std::abs ((*input_)[i].z - (*input_)[index_down_right].z);
+          if (dist_right_cut >= dist_left_cut)
+          {
+            if (store_shadowed_faces_ || !isShadowedTriangle (i, index_down_right, index_right))
+              add_triangle (i, index_down_right, index_right);
+            if (store_shadowed_faces_ || !isShadowedTriangle (i, index_down, index_down_right))
+              add_triangle (i, index_down, index_down_right);
+          }
+          else
+          {
+            if (store_shadowed_faces_ || !isShadowedTriangle (i, index_down, index_right))
+              add_triangle (i, index_down, index_right);
+            if (store_shadowed_faces_ || !isShadowedTriangle (index_right, index_down, index_down_right))
+              add_triangle (index_right, index_down, index_down_right);
+          }
+        }
+        else
+        {
+          if (right_cut_upper)
+            if (store_shadowed_faces_ || !isShadowedTriangle (i, index_down_right, index_right))
+              add_triangle (i, index_down_right, index_right);
+          if (right_cut_lower)
+            if (store_shadowed_faces_ || !isShadowedTriangle (i, index_down, index_down_right))
+              add_triangle (i, index_down, index_down_right);
+          if (left_cut_upper)
+            if (store_shadowed_faces_ || !isShadowedTriangle (i, index_down, index_right))
+              add_triangle (i, index_down, index_right);
+          if (left_cut_lower)
+            if (store_shadowed_faces_ || !isShadowedTriangle (index_right, index_down, index_down_right))
+              add_triangle (index_right, index_down, index_down_right);
+        }
+        break;
+      }
     }
   }
-  polygons.resize (idx);
 }
 
 /////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointInT> void
-pcl::OrganizedFastMesh<PointInT>::makeRightCutMesh (std::vector<pcl::Vertices>& polygons)
+pcl::OrganizedFastMesh<PointInT>::makeFaces (TriangulationType type, pcl::Indices &face_vertices)
 {
-  int last_column = input_->width - triangle_pixel_size_columns_;
-  int last_row = input_->height - triangle_pixel_size_rows_;
+  const int last_row = input_->height - triangle_pixel_size_rows_;
+  const int nr_rows = last_row > 0 ? (last_row + triangle_pixel_size_rows_ - 1) / triangle_pixel_size_rows_ : 0;
 
-  int i = 0, index_down = 0, index_right = 0, index_down_right = 0, idx = 0;
-  int y_big_incr = triangle_pixel_size_rows_ * input_->width,
-      x_big_incr = y_big_incr + triangle_pixel_size_columns_;
-  // Reserve enough space
-  polygons.resize (input_->width * input_->height * 2);
-
-  // Go over the rows first
-  for (int y = 0; y < last_row; y += triangle_pixel_size_rows_)
+  // Mesh every row into its own buffer, then copy the buffers one after the other
+  std::vector<pcl::Indices> row_vertices (nr_rows);
+#pragma omp parallel for \
+  default(none) \
+  shared(nr_rows, row_vertices, type) \
+  schedule(dynamic, 8) \
+  num_threads(threads_)
+  for (int row = 0; row < nr_rows; ++row)
   {
-    // Initialize a new row
-    i = y * input_->width;
-    index_right = i + triangle_pixel_size_columns_;
-    index_down = i + y_big_incr;
-    index_down_right = i + x_big_incr;
-
-    // Go over the columns
-    for (int x = 0; x < last_column; x += triangle_pixel_size_columns_,
-                                     i += triangle_pixel_size_columns_,
-                                     index_right += triangle_pixel_size_columns_,
-                                     index_down += triangle_pixel_size_columns_,
-                                     index_down_right += triangle_pixel_size_columns_)
-    {
-      if (isValidTriangle (i, index_down_right, index_right))
-        if (store_shadowed_faces_ || !isShadowedTriangle (i, index_down_right, index_right))
-          addTriangle (i, index_down_right, index_right, idx++, polygons);
-
-      if (isValidTriangle (i, index_down, index_down_right))
-        if (store_shadowed_faces_ || !isShadowedTriangle (i, index_down, index_down_right))
-          addTriangle (i, index_down, index_down_right, idx++, polygons);
-    }
+    row_vertices[row].reserve (2 * 3 * input_->width / triangle_pixel_size_columns_);
+    makeRowFaces (row * triangle_pixel_size_rows_, type, row_vertices[row]);
   }
-  polygons.resize (idx);
+
+  std::vector<std::size_t> row_offsets (nr_rows + 1, 0);
+  for (int row = 0; row < nr_rows; ++row)
+    row_offsets[row + 1] = row_offsets[row] + row_vertices[row].size ();
+
+  face_vertices.resize (row_offsets[nr_rows]);
+#pragma omp parallel for \
+  default(none) \
+  shared(nr_rows, row_vertices, row_offsets, face_vertices) \
+  num_threads(threads_)
+  for (int row = 0; row < nr_rows; ++row)
+    std::copy (row_vertices[row].begin (), row_vertices[row].end (), face_vertices.begin () + row_offsets[row]);
 }
 
 /////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointInT> void
-pcl::OrganizedFastMesh<PointInT>::makeLeftCutMesh (std::vector<pcl::Vertices>& polygons)
+pcl::OrganizedFastMesh<PointInT>::makePolygons (const pcl::Indices &face_vertices, int vertices_per_face,
+                                                std::vector<pcl::Vertices>& polygons)
 {
-  int last_column = input_->width - triangle_pixel_size_columns_;
-  int last_row = input_->height - triangle_pixel_size_rows_;
+  const int nr_faces = static_cast<int> (face_vertices.size ()) / vertices_per_face;
+  polygons.resize (nr_faces);
+#pragma omp parallel for \
+  default(none) \
+  shared(face_vertices, vertices_per_face, nr_faces, polygons) \
+  num_threads(threads_)
+  for (int face = 0; face < nr_faces; ++face)
+    polygons[face].vertices.assign (face_vertices.begin () + face * vertices_per_face,
+                                    face_vertices.begin () + (face + 1) * vertices_per_face);
+}
 
-  int i = 0, index_down = 0, index_right = 0, index_down_right = 0, idx = 0;
-  int y_big_incr = triangle_pixel_size_rows_ * input_->width,
-      x_big_incr = y_big_incr + triangle_pixel_size_columns_;
-  // Reserve enough space
-  polygons.resize (input_->width * input_->height * 2);
+/////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT> void
+pcl::OrganizedFastMesh<PointInT>::makeQuadMesh (std::vector<pcl::Vertices>& polygons)
+{
+  pcl::Indices face_vertices;
+  makeFaces (QUAD_MESH, face_vertices);
+  makePolygons (face_vertices, 4, polygons);
+}
 
-  // Go over the rows first
-  for (int y = 0; y < last_row; y += triangle_pixel_size_rows_)
-  {
-    // Initialize a new row
-    i = y * input_->width;
-    index_right = i + triangle_pixel_size_columns_;
-    index_down = i + y_big_incr;
-    index_down_right = i + x_big_incr;
-
-    // Go over the columns
-    for (int x = 0; x < last_column; x += triangle_pixel_size_columns_,
-                                     i += triangle_pixel_size_columns_,
-                                     index_right += triangle_pixel_size_columns_,
-                                     index_down += triangle_pixel_size_columns_,
-                                     index_down_right += triangle_pixel_size_columns_)
-    {
-      if (isValidTriangle (i, index_down, index_right))
-        if (store_shadowed_faces_ || !isShadowedTriangle (i, index_down, index_right))
-          addTriangle (i, index_down, index_right, idx++, polygons);
+/////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT> void
+pcl::OrganizedFastMesh<PointInT>::makeRightCutMesh (std::vector<pcl::Vertices>& polygons)
+{
+  pcl::Indices face_vertices;
+  makeFaces (TRIANGLE_RIGHT_CUT, face_vertices);
+  makePolygons (face_vertices, 3, polygons);
+}
 
-      if (isValidTriangle (index_right, index_down, index_down_right))
-        if (store_shadowed_faces_ || !isShadowedTriangle (index_right, index_down, index_down_right))
-          addTriangle (index_right, index_down, index_down_right, idx++, polygons);
-    }
-  }
-  polygons.resize (idx);
+/////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT> void
+pcl::OrganizedFastMesh<PointInT>::makeLeftCutMesh (std::vector<pcl::Vertices>& polygons)
+{
+  pcl::Indices face_vertices;
+  makeFaces (TRIANGLE_LEFT_CUT, face_vertices);
+  makePolygons (face_vertices, 3, polygons);
 }
 
 /////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointInT> void
 pcl::OrganizedFastMesh<PointInT>::makeAdaptiveCutMesh (std::vector<pcl::Vertices>& polygons)
 {
-  int last_column = input_->width - triangle_pixel_size_columns_;
-  int last_row = input_->height - triangle_pixel_size_rows_;
-
-  int i = 0, index_down = 0, index_right = 0, index_down_right = 0, idx = 0;
-  int y_big_incr = triangle_pixel_size_rows_ * input_->width,
-      x_big_incr = y_big_incr + triangle_pixel_size_columns_;
-  // Reserve enough space
-  polygons.resize (input_->width * input_->height * 2);
-
-  // Go over the rows first
-  for (int y = 0; y < last_row; y += triangle_pixel_size_rows_)
-  {
-    // Initialize a new row
-    i = y * input_->width;
-    index_right = i + triangle_pixel_size_columns_;
-    index_down = i + y_big_incr;
-    index_down_right = i + x_big_incr;
-
-    // Go over the columns
-    for (int x = 0; x < last_column; x += triangle_pixel_size_columns_,
-                                     i += triangle_pixel_size_columns_,
-                                     index_right += triangle_pixel_size_columns_,
-                                     index_down += triangle_pixel_size_columns_,
-                                     index_down_right += triangle_pixel_size_columns_)
-    {
-      const bool right_cut_upper = isValidTriangle (i, index_down_right, index_right);
-      const bool right_cut_lower = isValidTriangle (i, index_down, index_down_right);
-      const bool left_cut_upper = isValidTriangle (i, index_down, index_right);
-      const bool left_cut_lower = isValidTriangle (index_right, index_down, index_down_right);
-
-      if (right_cut_upper && right_cut_lower && left_cut_upper && left_cut_lower)
-      {
-        float dist_right_cut = std::abs ((*input_)[index_down].z - (*input_)[index_right].z);
-        float dist_left_cut = std::abs ((*input_)[i].z - (*input_)[index_down_right].z);
-        if (dist_right_cut >= dist_left_cut)
-        {
-          if (store_shadowed_faces_ || !isShadowedTriangle (i, index_down_right, index_right))
-            addTriangle (i, index_down_right, index_right, idx++, polygons);
-          if (store_shadowed_faces_ || !isShadowedTriangle (i, index_down, index_down_right))
-            addTriangle (i, index_down, index_down_right, idx++, polygons);
-        }
-        else
-        {
-          if (store_shadowed_faces_ || !isShadowedTriangle (i, index_down, index_right))
-            addTriangle (i, index_down, index_right, idx++, polygons);
-          if (store_shadowed_faces_ || !isShadowedTriangle (index_right, index_down, index_down_right))
-            addTriangle (index_right, index_down, index_down_right, idx++, polygons);
-        }
-      }
-      else
-      {
-        if (right_cut_upper)
-          if (store_shadowed_faces_ || !isShadowedTriangle (i, index_down_right, index_right))
-            addTriangle (i, index_down_right, index_right, idx++, polygons);
-        if (right_cut_lower)
-          if (store_shadowed_faces_ || !isShadowedTriangle (i, index_down, index_down_right))
-            addTriangle (i, index_down, index_down_right, idx++, polygons);
-        if (left_cut_upper)
-          if (store_shadowed_faces_ || !isShadowedTriangle (i, index_down, index_right))
-            addTriangle (i, index_down, index_right, idx++, polygons);
-        if (left_cut_lower)
-          if (store_shadowed_faces_ || !isShadowedTriangle (index_right, index_down, index_down_right))
-            addTriangle (index_right, index_down, index_down_right, idx++, polygons);
-      }
-    }
-  }
-  polygons.resize (idx);
+  pcl::Indices face_vertices;
+  makeFaces (TRIANGLE_ADAPTIVE_CUT, face_vertices);
+  makePolygons (face_vertices, 3, polygons);
 }
 
 #define PCL_INSTANTIATE_OrganizedFastMesh(T)                \
@@ -55,8 +55,13 @@
 #define MEMORY_ALLOCATOR_BLOCK_SIZE 1<<12
 
 #include <cstdarg>
+#include <memory>
 #include <string>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 using namespace pcl;
 
 //////////////////////////////////////////////////////////////////////////////////////////////
@@ -81,6 +86,8 @@ pcl::Poisson<PointNT>::Poisson ()
   , show_residual_ (false)
   , min_iterations_ (8)
   , solver_accuracy_ (1e-3f)
+  , threads_ (1)
+  , out_of_core_mesh_ (false)
 {
 }
 
@@ -90,9 +97,23 @@ pcl::Poisson<PointNT>::~Poisson ()
 {
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointNT> void
+pcl::Poisson<PointNT>::setThreads (int threads)
+{
+  if (threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs ();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = threads;
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointNT> template <int Degree> void
-pcl::Poisson<PointNT>::execute (poisson::CoredVectorMeshData &mesh,
+pcl::Poisson<PointNT>::execute (poisson::CoredMeshData &mesh,
                                 poisson::Point3D<float> &center,
                                 float &scale)
 {
@@ -100,8 +121,7 @@ pcl::Poisson<PointNT>::execute (poisson::CoredVectorMeshData &mesh,
   poisson::TreeNodeData::UseIndex = 1;
   poisson::Octree<Degree> tree;
 
-  /// TODO OPENMP stuff
-  //    tree.threads = Threads.value;
+  tree.threads = threads_;
   center.coords[0] = center.coords[1] = center.coords[2] = 0;
 
 
@@ -151,80 +171,9 @@ pcl::Poisson<PointNT>::execute (poisson::CoredVectorMeshData &mesh,
 template <typename PointNT> void
 pcl::Poisson<PointNT>::performReconstruction (PolygonMesh &output)
 {
-  poisson::CoredVectorMeshData mesh;
-  poisson::Point3D<float> center;
-  float scale = 1.0f;
-
-  switch (degree_)
-  {
-  case 1:
-  {
-    execute<1> (mesh, center, scale);
-    break;
-  }
-  case 2:
-  {
-    execute<2> (mesh, center, scale);
-    break;
-  }
-  case 3:
-  {
-    execute<3> (mesh, center, scale);
-    break;
-  }
-  case 4:
-  {
-    execute<4> (mesh, center, scale);
-    break;
-  }
-  case 5:
-  {
-    execute<5> (mesh, center, scale);
-    break;
-  }
-  default:
-  {
-    PCL_ERROR (stderr, "Degree %d not supported\n", degree_);
-  }
-  }
-
-  // Write output PolygonMesh
   pcl::PointCloud<pcl::PointXYZ> cloud;
-  cloud.points.resize (int (mesh.outOfCorePointCount () + mesh.inCorePoints.size ()));
-  poisson::Point3D<float> p;
-  for (int i = 0; i < int (mesh.inCorePoints.size ()); i++)
-  {
-    p = mesh.inCorePoints[i];
-    cloud[i].x = p.coords[0]*scale+center.coords[0];
-    cloud[i].y = p.coords[1]*scale+center.coords[1];
-    cloud[i].z = p.coords[2]*scale+center.coords[2];
-  }
-  for (int i = int (mesh.inCorePoints.size ()); i < int (mesh.outOfCorePointCount () + mesh.inCorePoints.size ()); i++)
-  {
-    mesh.nextOutOfCorePoint (p);
-    cloud[i].x = p.coords[0]*scale+center.coords[0];
-    cloud[i].y = p.coords[1]*scale+center.coords[1];
-    cloud[i].z = p.coords[2]*scale+center.coords[2];
-  }
+  reconstructMesh (cloud, output.polygons);
   pcl::toPCLPointCloud2 (cloud, output.cloud);
-  output.polygons.resize (mesh.polygonCount ());
-
-  // Write faces
-  std::vector<poisson::CoredVertexIndex> polygon;
-  for (int p_i = 0; p_i < mesh.polygonCount (); p_i++)
-  {
-    pcl::Vertices v;
-    mesh.nextPolygon (polygon);
-    v.vertices.resize (polygon.size ());
-
-    for (int i = 0; i < static_cast<int> (polygon.size ()); ++i)
-      if (polygon[i].inCore )
-        v.vertices[i] = polygon[i].idx;
-      else
-        v.vertices[i] = polygon[i].idx + int (mesh.inCorePoints.size ());
-
-    output.polygons[p_i] = v;
-  }
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////
@@ -232,7 +181,19 @@ template <typename PointNT> void
 pcl::Poisson<PointNT>::performReconstruction (pcl::PointCloud<PointNT> &points,
                                               std::vector<pcl::Vertices> &polygons)
 {
-  poisson::CoredVectorMeshData mesh;
+  reconstructMesh (points, polygons);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointNT> template <typename PointT> void
+pcl::Poisson<PointNT>::reconstructMesh (pcl::PointCloud<PointT> &points,
+                                        std::vector<pcl::Vertices> &polygons)
+{
+  std::unique_ptr<poisson::CoredMeshData> mesh;
+  if (out_of_core_mesh_)
+    mesh.reset (new poisson::CoredFileMeshData);
+  else
+    mesh.reset (new poisson::CoredVectorMeshData);
   poisson::Point3D<float> center;
   float scale = 1.0f;
 
@@ -240,27 +201,27 @@ pcl::Poisson<PointNT>::performReconstruction (pcl::PointCloud<PointNT> &points,
   {
   case 1:
   {
-    execute<1> (mesh, center, scale);
+    execute<1> (*mesh, center, scale);
     break;
   }
   case 2:
   {
-    execute<2> (mesh, center, scale);
+    execute<2> (*mesh, center, scale);
     break;
   }
   case 3:
   {
-    execute<3> (mesh, center, scale);
+    execute<3> (*mesh, center, scale);
     break;
   }
   case 4:
   {
-    execute<4> (mesh, center, scale);
+    execute<4> (*mesh, center, scale);
     break;
   }
   case 5:
   {
-    execute<5> (mesh, center, scale);
+    execute<5> (*mesh, center, scale);
     break;
   }
   default:
@@ -269,40 +230,43 @@ pcl::Poisson<PointNT>::performReconstruction (pcl::PointCloud<PointNT> &points,
   }
   }
 
+  // Read the out-of-core vertices and the polygons from their start
+  mesh->resetIterator ();
+
   // Write output PolygonMesh
   // Write vertices
-  points.resize (int (mesh.outOfCorePointCount () + mesh.inCorePoints.size ()));
+  points.resize (int (mesh->outOfCorePointCount () + mesh->inCorePoints.size ()));
   poisson::Point3D<float> p;
-  for (int i = 0; i < int(mesh.inCorePoints.size ()); i++)
+  for (int i = 0; i < int(mesh->inCorePoints.size ()); i++)
   {
-    p = mesh.inCorePoints[i];
+    p = mesh->inCorePoints[i];
     points[i].x = p.coords[0]*scale+center.coords[0];
     points[i].y = p.coords[1]*scale+center.coords[1];
     points[i].z = p.coords[2]*scale+center.coords[2];
   }
-  for (int i = int(mesh.inCorePoints.size()); i < int (mesh.outOfCorePointCount() + mesh.inCorePoints.size ()); i++)
+  for (int i = int(mesh->inCorePoints.size()); i < int (mesh->outOfCorePointCount() + mesh->inCorePoints.size ()); i++)
   {
-    mesh.nextOutOfCorePoint (p);
+    mesh->nextOutOfCorePoint (p);
     points[i].x = p.coords[0]*scale+center.coords[0];
     points[i].y = p.coords[1]*scale+center.coords[1];
     points[i].z = p.coords[2]*scale+center.coords[2];
   }
 
-  polygons.resize (mesh.polygonCount ());
+  polygons.resize (mesh->polygonCount ());
 
   // Write faces
   std::vector<poisson::CoredVertexIndex> polygon;
-  for (int p_i = 0; p_i < mesh.polygonCount (); p_i++)
+  for (int p_i = 0; p_i < mesh->polygonCount (); p_i++)
   {
     pcl::Vertices v;
-    mesh.nextPolygon (polygon);
+    mesh->nextPolygon (polygon);
     v.vertices.resize (polygon.size ());
 
     for (int i = 0; i < static_cast<int> (polygon.size ()); ++i)
       if (polygon[i].inCore )
         v.vertices[i] = polygon[i].idx;
       else
-        v.vertices[i] = polygon[i].idx + int (mesh.inCorePoints.size ());
+        v.vertices[i] = polygon[i].idx + int (mesh->inCorePoints.size ());
 
     polygons[p_i] = v;
   }
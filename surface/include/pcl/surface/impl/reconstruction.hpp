@@ -126,6 +126,57 @@ SurfaceReconstruction<PointInT>::reconstruct (pcl::PointCloud<PointInT> &points,
 }
 
 
+template <typename PointInT> void
+SurfaceReconstruction<PointInT>::reconstruct (pcl::TriangleMesh &output)
+{
+  // Copy the header
+  output.header = input_->header;
+
+  if (!initCompute ())
+  {
+    output.cloud.width = output.cloud.height = 0;
+    output.cloud.data.clear ();
+    output.triangles.clear ();
+    return;
+  }
+
+  // Check if a space search locator was given
+  if (check_tree_)
+  {
+    if (!tree_)
+    {
+      if (input_->isOrganized ())
+        tree_.reset (new pcl::search::OrganizedNeighbor<PointInT> ());
+      else
+        tree_.reset (new pcl::search::KdTree<PointInT> (false));
+    }
+
+    // Send the surface dataset to the spatial locator
+    tree_->setInputCloud (input_, indices_);
+  }
+
+  // Set up the output dataset
+  pcl::toPCLPointCloud2 (*input_, output.cloud);
+  output.triangles.clear ();
+  // Perform the actual surface reconstruction
+  performTriangleMeshReconstruction (output);
+
+  deinitCompute ();
+}
+
+
+template <typename PointInT> void
+SurfaceReconstruction<PointInT>::performTriangleMeshReconstruction (pcl::TriangleMesh &output)
+{
+  pcl::PolygonMesh mesh;
+  mesh.header = output.header;
+  mesh.cloud = std::move (output.cloud);
+  mesh.polygons.reserve (2 * indices_->size ()); /// NOTE: usually the number of triangles is around twice the number of vertices
+  performReconstruction (mesh);
+  pcl::toTriangleMesh (std::move (mesh), output);
+}
+
+
 template <typename PointInT> void
 MeshConstruction<PointInT>::reconstruct (pcl::PolygonMesh &output)
 {
@@ -199,6 +250,55 @@ MeshConstruction<PointInT>::reconstruct (std::vector<pcl::Vertices> &polygons)
   deinitCompute ();
 }
 
+template <typename PointInT> void
+MeshConstruction<PointInT>::reconstruct (pcl::TriangleMesh &output)
+{
+  // Copy the header
+  output.header = input_->header;
+
+  if (!initCompute ())
+  {
+    output.cloud.width = output.cloud.height = 1;
+    output.cloud.data.clear ();
+    output.triangles.clear ();
+    return;
+  }
+
+  // Check if a space search locator was given
+  if (check_tree_)
+  {
+    if (!tree_)
+    {
+      if (input_->isOrganized ())
+        tree_.reset (new pcl::search::OrganizedNeighbor<PointInT> ());
+      else
+        tree_.reset (new pcl::search::KdTree<PointInT> (false));
+    }
+
+    // Send the surface dataset to the spatial locator
+    tree_->setInputCloud (input_, indices_);
+  }
+
+  // Set up the output dataset
+  pcl::toPCLPointCloud2 (*input_, output.cloud);
+  output.triangles.clear ();
+  // Perform the actual surface reconstruction
+  performTriangleMeshReconstruction (output);
+
+  deinitCompute ();
+}
+
+
+template <typename PointInT> void
+MeshConstruction<PointInT>::performTriangleMeshReconstruction (pcl::TriangleMesh &output)
+{
+  pcl::PolygonMesh mesh;
+  mesh.header = output.header;
+  mesh.cloud = std::move (output.cloud);
+  performReconstruction (mesh);
+  pcl::toTriangleMesh (std::move (mesh), output);
+}
+
 } // namespace pcl
 
 #endif  // PCL_SURFACE_RECONSTRUCTION_IMPL_H_
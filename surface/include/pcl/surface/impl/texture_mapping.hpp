@@ -42,6 +42,24 @@
 #include <pcl/surface/texture_mapping.h>
 #include <unordered_set>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointInT> void
+pcl::TextureMapping<PointInT>::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs ();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////
 template<typename PointInT> std::vector<Eigen::Vector2f, Eigen::aligned_allocator<Eigen::Vector2f> >
 pcl::TextureMapping<PointInT>::mapTexture2Face (
@@ -419,20 +437,31 @@ pcl::TextureMapping<PointInT>::removeOccludedPoints (const PointCloudPtr &input_
   octree.defineBoundingBox ();
   // add points in the tree
   octree.addPointsFromInputCloud ();
+  octree.setNumberOfThreads (threads_);
 
   visible_indices.clear ();
 
   // for each point of the cloud, raycast toward camera and check intersected voxels.
-  Eigen::Vector3f direction;
-  std::vector<int> indices;
+  // The rays are cast in blocks, so that the intersected indices of a block stay small.
+  constexpr std::size_t ray_block_size = 16384;
+  std::vector<Eigen::Vector3f> origins, directions;
+  std::vector<std::vector<int> > block_indices;
   for (std::size_t i = 0; i < input_cloud->size (); ++i)
   {
-    direction (0) = (*input_cloud)[i].x;
-    direction (1) = (*input_cloud)[i].y;
-    direction (2) = (*input_cloud)[i].z;
-
-    // if point is not occluded
-    octree.getIntersectedVoxelIndices (direction, -direction, indices);
+    const std::size_t block_pos = i % ray_block_size;
+    if (block_pos == 0)
+    {
+      const std::size_t block_end = std::min (i + ray_block_size, input_cloud->size ());
+      origins.clear ();
+      directions.clear ();
+      for (std::size_t j = i; j < block_end; ++j)
+      {
+        origins.push_back ((*input_cloud)[j].getVector3fMap ());
+        directions.push_back (-(*input_cloud)[j].getVector3fMap ());
+      }
+      octree.getIntersectedVoxelIndices (origins, directions, block_indices);
+    }
+    const std::vector<int> &indices = block_indices[block_pos];
 
     int nbocc = static_cast<int> (indices.size ());
     for (const int &index : indices)
@@ -640,26 +669,39 @@ pcl::TextureMapping<PointInT>::showOcclusions (const PointCloudPtr &input_cloud,
   octree.defineBoundingBox ();
   // add points in the tree
   octree.addPointsFromInputCloud ();
+  octree.setNumberOfThreads (threads_);
 
-  // ray direction
-  Eigen::Vector3f direction;
+  // rays of the current block
+  constexpr std::size_t ray_block_size = 16384;
+  std::vector<Eigen::Vector3f> origins, directions;
+  std::vector<std::vector<int> > block_indices;
 
-  std::vector<int> indices;
   // point from where we ray-trace
   pcl::PointXYZI pt;
 
   std::vector<double> zDist;
   std::vector<double> ptDist;
   // for each point of the cloud, ray-trace toward the camera and check intersected voxels.
-  for (const auto& point: *input_cloud)
+  for (std::size_t i = 0; i < input_cloud->size (); ++i)
   {
-    direction = pt.getVector3fMap() = point.getVector3fMap();
+    const std::size_t block_pos = i % ray_block_size;
+    if (block_pos == 0)
+    {
+      const std::size_t block_end = std::min (i + ray_block_size, input_cloud->size ());
+      origins.clear ();
+      directions.clear ();
+      for (std::size_t j = i; j < block_end; ++j)
+      {
+        origins.push_back ((*input_cloud)[j].getVector3fMap ());
+        directions.push_back (-(*input_cloud)[j].getVector3fMap ());
+      }
+      octree.getIntersectedVoxelIndices (origins, directions, block_indices);
+    }
+    pt.getVector3fMap () = (*input_cloud)[i].getVector3fMap ();
 
     // get number of occlusions for that point
-    indices.clear ();
-    int nbocc = octree.getIntersectedVoxelIndices (direction, -direction, indices);
-
-    nbocc = static_cast<int> (indices.size ());
+    const std::vector<int> &indices = block_indices[block_pos];
+    int nbocc = static_cast<int> (indices.size ());
 
     // TODO need to clean this up and find tricks to get remove aliasaing effect on planes
     for (const int &index : indices)
@@ -733,143 +775,148 @@ pcl::TextureMapping<PointInT>::textureMeshwithMultipleCameras (pcl::TextureMesh
     // CREATE UV MAP FOR CURRENT FACES
     pcl::PointCloud<pcl::PointXY>::Ptr projections (new pcl::PointCloud<pcl::PointXY>);
     std::vector<bool> visibility;
-    visibility.resize (mesh.tex_polygons[current_cam].size ());
-    std::vector<UvIndex> indexes_uv_to_points;
-    // for each current face
-
-    //TODO change this
-    pcl::PointXY nan_point;
-    nan_point.x = std::numeric_limits<float>::quiet_NaN ();
-    nan_point.y = std::numeric_limits<float>::quiet_NaN ();
-    UvIndex u_null;
-    u_null.idx_cloud = -1;
-    u_null.idx_face = -1;
-
-    int cpt_invisible=0;
-    for (int idx_face = 0; idx_face <  static_cast<int> (mesh.tex_polygons[current_cam].size ()); ++idx_face)
+    if (use_z_buffer_)
+      computeFaceVisibilityZBuffer (mesh, current_cam, cameras[current_cam], *camera_cloud, *projections, visibility);
+    else
     {
-      //project each vertice, if one is out of view, stop
-      pcl::PointXY uv_coord1;
-      pcl::PointXY uv_coord2;
-      pcl::PointXY uv_coord3;
-
-      if (isFaceProjected (cameras[current_cam],
-                           (*camera_cloud)[mesh.tex_polygons[current_cam][idx_face].vertices[0]],
-                           (*camera_cloud)[mesh.tex_polygons[current_cam][idx_face].vertices[1]],
-                           (*camera_cloud)[mesh.tex_polygons[current_cam][idx_face].vertices[2]],
-                           uv_coord1,
-                           uv_coord2,
-                           uv_coord3))
-       {
-        // face is in the camera's FOV
-
-        // add UV coordinates
-        projections->points.push_back (uv_coord1);
-        projections->points.push_back (uv_coord2);
-        projections->points.push_back (uv_coord3);
-
-        // remember corresponding face
-        UvIndex u1, u2, u3;
-        u1.idx_cloud = mesh.tex_polygons[current_cam][idx_face].vertices[0];
-        u2.idx_cloud = mesh.tex_polygons[current_cam][idx_face].vertices[1];
-        u3.idx_cloud = mesh.tex_polygons[current_cam][idx_face].vertices[2];
-        u1.idx_face = idx_face; u2.idx_face = idx_face; u3.idx_face = idx_face;
-        indexes_uv_to_points.push_back (u1);
-        indexes_uv_to_points.push_back (u2);
-        indexes_uv_to_points.push_back (u3);
-
-        //keep track of visibility
-        visibility[idx_face] = true;
-      }
-      else
+      visibility.resize (mesh.tex_polygons[current_cam].size ());
+      std::vector<UvIndex> indexes_uv_to_points;
+      // for each current face
+
+      //TODO change this
+      pcl::PointXY nan_point;
+      nan_point.x = std::numeric_limits<float>::quiet_NaN ();
+      nan_point.y = std::numeric_limits<float>::quiet_NaN ();
+      UvIndex u_null;
+      u_null.idx_cloud = -1;
+      u_null.idx_face = -1;
+
+      int cpt_invisible=0;
+      for (int idx_face = 0; idx_face <  static_cast<int> (mesh.tex_polygons[current_cam].size ()); ++idx_face)
       {
-        projections->points.push_back (nan_point);
-        projections->points.push_back (nan_point);
-        projections->points.push_back (nan_point);
-        indexes_uv_to_points.push_back (u_null);
-        indexes_uv_to_points.push_back (u_null);
-        indexes_uv_to_points.push_back (u_null);
-        //keep track of visibility
-        visibility[idx_face] = false;
-        cpt_invisible++;
+        //project each vertice, if one is out of view, stop
+        pcl::PointXY uv_coord1;
+        pcl::PointXY uv_coord2;
+        pcl::PointXY uv_coord3;
+
+        if (isFaceProjected (cameras[current_cam],
+                             (*camera_cloud)[mesh.tex_polygons[current_cam][idx_face].vertices[0]],
+                             (*camera_cloud)[mesh.tex_polygons[current_cam][idx_face].vertices[1]],
+                             (*camera_cloud)[mesh.tex_polygons[current_cam][idx_face].vertices[2]],
+                             uv_coord1,
+                             uv_coord2,
+                             uv_coord3))
+         {
+          // face is in the camera's FOV
+
+          // add UV coordinates
+          projections->points.push_back (uv_coord1);
+          projections->points.push_back (uv_coord2);
+          projections->points.push_back (uv_coord3);
+
+          // remember corresponding face
+          UvIndex u1, u2, u3;
+          u1.idx_cloud = mesh.tex_polygons[current_cam][idx_face].vertices[0];
+          u2.idx_cloud = mesh.tex_polygons[current_cam][idx_face].vertices[1];
+          u3.idx_cloud = mesh.tex_polygons[current_cam][idx_face].vertices[2];
+          u1.idx_face = idx_face; u2.idx_face = idx_face; u3.idx_face = idx_face;
+          indexes_uv_to_points.push_back (u1);
+          indexes_uv_to_points.push_back (u2);
+          indexes_uv_to_points.push_back (u3);
+
+          //keep track of visibility
+          visibility[idx_face] = true;
+        }
+        else
+        {
+          projections->points.push_back (nan_point);
+          projections->points.push_back (nan_point);
+          projections->points.push_back (nan_point);
+          indexes_uv_to_points.push_back (u_null);
+          indexes_uv_to_points.push_back (u_null);
+          indexes_uv_to_points.push_back (u_null);
+          //keep track of visibility
+          visibility[idx_face] = false;
+          cpt_invisible++;
+        }
       }
-    }
 
-    // projections contains all UV points of the current faces
-    // indexes_uv_to_points links a uv point to its point in the camera cloud
-    // visibility contains tells if a face was in the camera FOV (false = skip)
+      // projections contains all UV points of the current faces
+      // indexes_uv_to_points links a uv point to its point in the camera cloud
+      // visibility contains tells if a face was in the camera FOV (false = skip)
 
-    // TODO handle case were no face could be projected
-    if (visibility.size () - cpt_invisible !=0)
-    {
-        //create kdtree
-        pcl::KdTreeFLANN<pcl::PointXY> kdtree;
-        kdtree.setInputCloud (projections);
-
-        std::vector<int> idxNeighbors;
-        std::vector<float> neighborsSquaredDistance;
-        // af first (idx_pcan < current_cam), check if some of the faces attached to previous cameras occlude the current faces
-        // then (idx_pcam == current_cam), check for self occlusions. At this stage, we skip faces that were already marked as occluded
-        cpt_invisible = 0;
-        for (int idx_pcam = 0 ; idx_pcam <= current_cam ; ++idx_pcam)
-        {
-          // project all faces
-          for (int idx_face = 0; idx_face <  static_cast<int> (mesh.tex_polygons[idx_pcam].size ()); ++idx_face)
+      // TODO handle case were no face could be projected
+      if (visibility.size () - cpt_invisible !=0)
+      {
+          //create kdtree
+          pcl::KdTreeFLANN<pcl::PointXY> kdtree;
+          kdtree.setInputCloud (projections);
+
+          std::vector<int> idxNeighbors;
+          std::vector<float> neighborsSquaredDistance;
+          // af first (idx_pcan < current_cam), check if some of the faces attached to previous cameras occlude the current faces
+          // then (idx_pcam == current_cam), check for self occlusions. At this stage, we skip faces that were already marked as occluded
+          cpt_invisible = 0;
+          for (int idx_pcam = 0 ; idx_pcam <= current_cam ; ++idx_pcam)
           {
-
-            if (idx_pcam == current_cam && !visibility[idx_face])
+            // project all faces
+            for (int idx_face = 0; idx_face <  static_cast<int> (mesh.tex_polygons[idx_pcam].size ()); ++idx_face)
             {
-              // we are now checking for self occlusions within the current faces
-              // the current face was already declared as occluded.
-              // therefore, it cannot occlude another face anymore => we skip it
-              continue;
-            }
 
-            // project each vertice, if one is out of view, stop
-            pcl::PointXY uv_coord1;
-            pcl::PointXY uv_coord2;
-            pcl::PointXY uv_coord3;
-
-            if (isFaceProjected (cameras[current_cam],
-                                 (*camera_cloud)[mesh.tex_polygons[idx_pcam][idx_face].vertices[0]],
-                                 (*camera_cloud)[mesh.tex_polygons[idx_pcam][idx_face].vertices[1]],
-                                 (*camera_cloud)[mesh.tex_polygons[idx_pcam][idx_face].vertices[2]],
-                                 uv_coord1,
-                                 uv_coord2,
-                                 uv_coord3))
-             {
-              // face is in the camera's FOV
-              //get its circumsribed circle
-              double radius;
-              pcl::PointXY center;
-              // getTriangleCircumcenterAndSize (uv_coord1, uv_coord2, uv_coord3, center, radius);
-              getTriangleCircumcscribedCircleCentroid(uv_coord1, uv_coord2, uv_coord3, center, radius); // this function yields faster results than getTriangleCircumcenterAndSize
-
-              // get points inside circ.circle
-              if (kdtree.radiusSearch (center, radius, idxNeighbors, neighborsSquaredDistance) > 0 )
+              if (idx_pcam == current_cam && !visibility[idx_face])
               {
-                // for each neighbor
-                for (const int &idxNeighbor : idxNeighbors)
+                // we are now checking for self occlusions within the current faces
+                // the current face was already declared as occluded.
+                // therefore, it cannot occlude another face anymore => we skip it
+                continue;
+              }
+
+              // project each vertice, if one is out of view, stop
+              pcl::PointXY uv_coord1;
+              pcl::PointXY uv_coord2;
+              pcl::PointXY uv_coord3;
+
+              if (isFaceProjected (cameras[current_cam],
+                                   (*camera_cloud)[mesh.tex_polygons[idx_pcam][idx_face].vertices[0]],
+                                   (*camera_cloud)[mesh.tex_polygons[idx_pcam][idx_face].vertices[1]],
+                                   (*camera_cloud)[mesh.tex_polygons[idx_pcam][idx_face].vertices[2]],
+                                   uv_coord1,
+                                   uv_coord2,
+                                   uv_coord3))
+               {
+                // face is in the camera's FOV
+                //get its circumsribed circle
+                double radius;
+                pcl::PointXY center;
+                // getTriangleCircumcenterAndSize (uv_coord1, uv_coord2, uv_coord3, center, radius);
+                getTriangleCircumcscribedCircleCentroid(uv_coord1, uv_coord2, uv_coord3, center, radius); // this function yields faster results than getTriangleCircumcenterAndSize
+
+                // get points inside circ.circle
+                if (kdtree.radiusSearch (center, radius, idxNeighbors, neighborsSquaredDistance) > 0 )
                 {
-                  if (std::max ((*camera_cloud)[mesh.tex_polygons[idx_pcam][idx_face].vertices[0]].z,
-                                std::max ((*camera_cloud)[mesh.tex_polygons[idx_pcam][idx_face].vertices[1]].z, 
-                                          (*camera_cloud)[mesh.tex_polygons[idx_pcam][idx_face].vertices[2]].z))
-                     < (*camera_cloud)[indexes_uv_to_points[idxNeighbor].idx_cloud].z)
+                  // for each neighbor
+                  for (const int &idxNeighbor : idxNeighbors)
                   {
-                    // neighbor is farther than all the face's points. Check if it falls into the triangle
-                    if (checkPointInsideTriangle(uv_coord1, uv_coord2, uv_coord3, (*projections)[idxNeighbor]))
+                    if (std::max ((*camera_cloud)[mesh.tex_polygons[idx_pcam][idx_face].vertices[0]].z,
+                                  std::max ((*camera_cloud)[mesh.tex_polygons[idx_pcam][idx_face].vertices[1]].z, 
+                                            (*camera_cloud)[mesh.tex_polygons[idx_pcam][idx_face].vertices[2]].z))
+                       < (*camera_cloud)[indexes_uv_to_points[idxNeighbor].idx_cloud].z)
                     {
-                      // current neighbor is inside triangle and is closer => the corresponding face
-                      visibility[indexes_uv_to_points[idxNeighbor].idx_face] = false;
-                      cpt_invisible++;
-                      //TODO we could remove the projections of this face from the kd-tree cloud, but I fond it slower, and I need the point to keep ordered to querry UV coordinates later
+                      // neighbor is farther than all the face's points. Check if it falls into the triangle
+                      if (checkPointInsideTriangle(uv_coord1, uv_coord2, uv_coord3, (*projections)[idxNeighbor]))
+                      {
+                        // current neighbor is inside triangle and is closer => the corresponding face
+                        visibility[indexes_uv_to_points[idxNeighbor].idx_face] = false;
+                        cpt_invisible++;
+                        //TODO we could remove the projections of this face from the kd-tree cloud, but I fond it slower, and I need the point to keep ordered to querry UV coordinates later
+                      }
                     }
                   }
                 }
-              }
-             }
+               }
+            }
           }
-        }
+      }
     }
 
     // now, visibility is true for each face that belongs to the current camera
@@ -949,6 +996,148 @@ pcl::TextureMapping<PointInT>::textureMeshwithMultipleCameras (pcl::TextureMesh
 
 }
 
+///////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointInT> void
+pcl::TextureMapping<PointInT>::computeFaceVisibilityZBuffer (const pcl::TextureMesh &mesh, int current_cam,
+                                                            const Camera &camera, const PointCloud &camera_cloud,
+                                                            pcl::PointCloud<pcl::PointXY> &projections,
+                                                            std::vector<bool> &visibility)
+{
+  const int width = std::max (1, static_cast<int> (camera.width));
+  const int height = std::max (1, static_cast<int> (camera.height));
+
+  // All the faces of the mesh: the ones given to the previous cameras, and the current ones
+  std::vector<const pcl::Vertices*> faces;
+  for (int idx_cam = 0; idx_cam <= current_cam; ++idx_cam)
+    for (const auto &face : mesh.tex_polygons[idx_cam])
+      faces.push_back (&face);
+  const int nr_faces = static_cast<int> (faces.size ());
+  const int nr_current_faces = static_cast<int> (mesh.tex_polygons[current_cam].size ());
+  const int first_current_face = nr_faces - nr_current_faces;
+
+  // Project the faces in pixels, and keep their farthest depth
+  std::vector<Eigen::Matrix<float, 2, 3>, Eigen::aligned_allocator<Eigen::Matrix<float, 2, 3> > > face_pixels (nr_faces);
+  std::vector<float> face_depths (nr_faces, std::numeric_limits<float>::quiet_NaN ());
+  std::vector<pcl::PointXY> face_uvs (3 * nr_current_faces);
+#pragma omp parallel for \
+  default(none) \
+  shared(camera, camera_cloud, faces, nr_faces, first_current_face, face_pixels, face_depths, face_uvs, width, height) \
+  num_threads(threads_)
+  for (int idx_face = 0; idx_face < nr_faces; ++idx_face)
+  {
+    const pcl::Vertices &face = *faces[idx_face];
+    pcl::PointXY uv[3];
+    if (!isFaceProjected (camera, camera_cloud[face.vertices[0]], camera_cloud[face.vertices[1]],
+                          camera_cloud[face.vertices[2]], uv[0], uv[1], uv[2]))
+      continue;
+
+    for (int k = 0; k < 3; ++k)
+    {
+      face_pixels[idx_face] (0, k) = uv[k].x * static_cast<float> (width);
+      face_pixels[idx_face] (1, k) = uv[k].y * static_cast<float> (height);
+      if (idx_face >= first_current_face)
+        face_uvs[3 * (idx_face - first_current_face) + k] = uv[k];
+    }
+    face_depths[idx_face] = std::max (camera_cloud[face.vertices[0]].z,
+                                      std::max (camera_cloud[face.vertices[1]].z, camera_cloud[face.vertices[2]].z));
+  }
+
+  // Sort the faces into bands of rows, which are rasterized in parallel
+  const int band_height = 32;
+  const int nr_bands = (height + band_height - 1) / band_height;
+  std::vector<std::vector<int> > band_faces (nr_bands);
+  for (int idx_face = 0; idx_face < nr_faces; ++idx_face)
+  {
+    if (std::isnan (face_depths[idx_face]))
+      continue;
+    const int min_row = std::max (0, static_cast<int> (face_pixels[idx_face].row (1).minCoeff ()));
+    const int max_row = std::min (height - 1, static_cast<int> (face_pixels[idx_face].row (1).maxCoeff ()));
+    for (int band = min_row / band_height; band <= max_row / band_height; ++band)
+      band_faces[band].push_back (idx_face);
+  }
+
+  // Every pixel holds the smallest farthest depth of the faces covering its center
+  std::vector<float> z_buffer (static_cast<std::size_t> (width) * height, std::numeric_limits<float>::max ());
+#pragma omp parallel for \
+  default(none) \
+  shared(band_faces, face_pixels, face_depths, z_buffer, width, height, nr_bands, band_height) \
+  schedule(dynamic) \
+  num_threads(threads_)
+  for (int band = 0; band < nr_bands; ++band)
+  {
+    const int band_begin = band * band_height;
+    const int band_end = std::min (height, band_begin + band_height);
+    for (const int idx_face : band_faces[band])
+    {
+      const Eigen::Matrix<float, 2, 3> &p = face_pixels[idx_face];
+      const float area = (p (0, 1) - p (0, 0)) * (p (1, 2) - p (1, 0)) - (p (1, 1) - p (1, 0)) * (p (0, 2) - p (0, 0));
+      if (area == 0.0f)
+        continue;
+
+      const int min_col = std::max (0, static_cast<int> (std::floor (p.row (0).minCoeff () - 0.5f)));
+      const int max_col = std::min (width - 1, static_cast<int> (std::ceil (p.row (0).maxCoeff () - 0.5f)));
+      const int min_row = std::max (band_begin, static_cast<int> (std::floor (p.row (1).minCoeff () - 0.5f)));
+      const int max_row = std::min (band_end - 1, static_cast<int> (std::ceil (p.row (1).maxCoeff () - 0.5f)));
+      for (int row = min_row; row <= max_row; ++row)
+      {
+        const float y = static_cast<float> (row) + 0.5f;
+        for (int col = min_col; col <= max_col; ++col)
+        {
+          const float x = static_cast<float> (col) + 0.5f;
+          // The pixel center is inside if it is on the same side of the three edges as the triangle
+          bool inside = true;
+          for (int k = 0; k < 3 && inside; ++k)
+          {
+            const int k1 = (k + 1) % 3;
+            const float edge = (p (0, k1) - p (0, k)) * (y - p (1, k)) - (p (1, k1) - p (1, k)) * (x - p (0, k));
+            inside = (area > 0.0f) ? (edge >= 0.0f) : (edge <= 0.0f);
+          }
+          if (!inside)
+            continue;
+
+          float &depth = z_buffer[static_cast<std::size_t> (row) * width + col];
+          depth = std::min (depth, face_depths[idx_face]);
+        }
+      }
+    }
+  }
+
+  // A face is occluded if one of its vertices is farther than the faces covering it
+  std::vector<char> visible (nr_current_faces, 0);
+#pragma omp parallel for \
+  default(none) \
+  shared(camera_cloud, faces, first_current_face, nr_current_faces, face_pixels, face_depths, z_buffer, visible, width, height) \
+  num_threads(threads_)
+  for (int idx_face = 0; idx_face < nr_current_faces; ++idx_face)
+  {
+    const int idx = first_current_face + idx_face;
+    if (std::isnan (face_depths[idx]))
+      continue;
+
+    bool occluded = false;
+    for (int k = 0; k < 3 && !occluded; ++k)
+    {
+      const int col = std::min (width - 1, std::max (0, static_cast<int> (face_pixels[idx] (0, k))));
+      const int row = std::min (height - 1, std::max (0, static_cast<int> (face_pixels[idx] (1, k))));
+      occluded = camera_cloud[faces[idx]->vertices[k]].z > z_buffer[static_cast<std::size_t> (row) * width + col];
+    }
+    visible[idx_face] = !occluded;
+  }
+
+  pcl::PointXY nan_point;
+  nan_point.x = std::numeric_limits<float>::quiet_NaN ();
+  nan_point.y = std::numeric_limits<float>::quiet_NaN ();
+  projections.resize (3 * nr_current_faces);
+  visibility.resize (nr_current_faces);
+  for (int idx_face = 0; idx_face < nr_current_faces; ++idx_face)
+  {
+    const bool projected = !std::isnan (face_depths[first_current_face + idx_face]);
+    for (int k = 0; k < 3; ++k)
+      projections[3 * idx_face + k] = projected ? face_uvs[3 * idx_face + k] : nan_point;
+    visibility[idx_face] = (visible[idx_face] != 0);
+  }
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////
 template<typename PointInT> inline void
 pcl::TextureMapping<PointInT>::getTriangleCircumcenterAndSize(const pcl::PointXY &p1, const pcl::PointXY &p2, const pcl::PointXY &p3, pcl::PointXY &circomcenter, double &radius)
@@ -40,6 +40,9 @@
 #include <pcl/surface/boost.h>
 #include <pcl/surface/reconstruction.h>
 
+#include <functional>
+#include <unordered_map>
+
 namespace pcl
 {
   /*
@@ -434,10 +437,66 @@ namespace pcl
       getPercentageExtendGrid ()
       { return percentage_extend_grid_; }
 
+      /** \brief Method that sets whether the grid is stored sparsely, as hashed blocks of voxels near the points.
+        * A sparse grid only holds (and evaluates) the blocks of 8x8x8 voxels that contain points, and the blocks
+        * around them, so its memory grows with the surface rather than with the resolution. Surfaces are only
+        * extracted in this narrow band; away from the points the grid has no value, as with setDistanceIgnore ()
+        * in MarchingCubesHoppe.
+        * \param[in] sparse_grid true to store the grid sparsely, false for a dense grid (default)
+        */
+      inline void
+      setSparseGrid (bool sparse_grid)
+      { sparse_grid_ = sparse_grid; }
+
+      /** \brief Method that returns whether the grid is stored sparsely. */
+      inline bool
+      getSparseGrid () const
+      { return sparse_grid_; }
+
+      /** \brief Method that sets whether the vertices shared by adjacent triangles are merged.
+        * Without welding, every triangle has its own three vertices.
+        * \param[in] weld_vertices true to merge the vertices lying on the same grid edge
+        */
+      inline void
+      setWeldVertices (bool weld_vertices)
+      { weld_vertices_ = weld_vertices; }
+
+      /** \brief Method that returns whether the vertices shared by adjacent triangles are merged. */
+      inline bool
+      getWeldVertices () const
+      { return weld_vertices_; }
+
+      /** \brief Set the number of threads to use to evaluate the grid and to extract the triangles.
+        * The output does not depend on the number of threads.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      void
+      setNumberOfThreads (unsigned int nr_threads = 0);
+
+      /** \brief Get the number of threads to use. */
+      inline unsigned int
+      getNumberOfThreads () const
+      { return threads_; }
+
     protected:
       /** \brief The data structure storing the 3D grid */
       std::vector<float> grid_;
 
+      /** \brief The side, in voxels, of the blocks of the sparse grid */
+      static constexpr int block_size_ = 8;
+
+      /** \brief The blocks of the sparse grid, by block index, each holding its voxels in x, y, z order */
+      std::unordered_map<std::uint64_t, std::vector<float> > grid_blocks_;
+
+      /** \brief Whether the grid is stored in blocks near the points */
+      bool sparse_grid_ = false;
+
+      /** \brief Whether the vertices on the same grid edge are merged */
+      bool weld_vertices_ = false;
+
+      /** \brief The number of threads the scheduler should use */
+      unsigned int threads_ = 1;
+
       /** \brief The grid resolution */
       int res_x_ = 32, res_y_ = 32, res_z_ = 32;
 
@@ -481,6 +540,18 @@ namespace pcl
                      const Eigen::Vector3i &index_3d,
                      pcl::PointCloud<PointNT> &cloud);
 
+      /** \brief Calculate out the corresponding polygons in the leaf node, and the grid edges of their vertices
+        * \param leaf_node the leaf node to be checked
+        * \param index_3d the 3d index of the leaf node to be checked
+        * \param cloud point cloud to store the vertices of the polygon
+        * \param vertex_edges the index of the grid edge of every vertex added to cloud
+        */
+      void
+      createSurface (const std::vector<float> &leaf_node,
+                     const Eigen::Vector3i &index_3d,
+                     pcl::PointCloud<PointNT> &cloud,
+                     std::vector<std::uint64_t> &vertex_edges);
+
       /** \brief Get the bounding box for the input data points. 
         */
       void
@@ -493,6 +564,34 @@ namespace pcl
       virtual float
       getGridValue (Eigen::Vector3i pos);
 
+      /** \brief Method that sets the scalar value at the given grid position, which must be inside the grid.
+        * In a sparse grid, positions outside the allocated blocks are ignored.
+        * \param[in] pos The 3D position in the grid
+        * \param[in] value The scalar value
+        */
+      void
+      setGridValue (const Eigen::Vector3i &pos, float value);
+
+      /** \brief Evaluate the scalar field in parallel at every voxel of the grid: every voxel of a dense grid, or
+        * every voxel of the blocks of a sparse grid. The voxels without a value keep NaN.
+        * \param[in] value the scalar value at a grid position, or NaN if undefined; called from several threads
+        */
+      void
+      computeGridValues (const std::function<float (const Eigen::Vector3i &)> &value);
+
+      /** \brief Allocate the grid: the dense grid, or the blocks of the sparse grid around the points. */
+      void
+      allocateGrid ();
+
+      /** \brief Get the first corner and the side of the boxes of voxels in which the grid is processed in parallel:
+        * the x-slabs of a dense grid, or the blocks of a sparse grid, in a fixed order.
+        * \param[out] box_origins the first corner of every box
+        * \param[out] box_size the side of the boxes along x, y and z
+        */
+      void
+      getGridBoxes (std::vector<Eigen::Vector3i, Eigen::aligned_allocator<Eigen::Vector3i> > &box_origins,
+                    Eigen::Vector3i &box_size) const;
+
       /** \brief Method that returns the scalar values of the neighbors of a given 3D position in the grid.
         * \param[in] index3d the point in the grid
         * \param[out] leaf the set of values
@@ -518,6 +617,20 @@ namespace pcl
        performReconstruction (pcl::PointCloud<PointNT> &points,
                               std::vector<pcl::Vertices> &polygons) override;
 
+       /** \brief Extract the surface straight into a flat triangle mesh.
+         * \param[out] output the resultant triangle mesh
+         */
+       void
+       performTriangleMeshReconstruction (pcl::TriangleMesh &output) override;
+
+       /** \brief Extract the surface as a flat buffer of triangles.
+         * \param[out] points the points of the extracted mesh
+         * \param[out] triangles the vertex indices of the extracted triangles, three per triangle
+         */
+       void
+       extractTriangles (pcl::PointCloud<PointNT> &points,
+                         std::vector<std::uint32_t> &triangles);
+
     public:
       PCL_MAKE_ALIGNED_OPERATOR_NEW
   };
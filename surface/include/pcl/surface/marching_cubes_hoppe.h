@@ -65,6 +65,7 @@ namespace pcl
       using MarchingCubes<PointNT>::size_voxel_;
       using MarchingCubes<PointNT>::upper_boundary_;
       using MarchingCubes<PointNT>::lower_boundary_;
+      using MarchingCubes<PointNT>::computeGridValues;
 
       using PointCloudPtr = typename pcl::PointCloud<PointNT>::Ptr;
 
@@ -48,6 +48,13 @@ namespace pcl
     * "Reconstruction and representation of 3D objects with radial basis functions"
     * SIGGRAPH '01
     *
+    * With a support radius (see setSupportRadius ()), the compactly supported kernel of:
+    * Wendland H., "Piecewise polynomial, positive definite and compactly supported radial functions of minimal
+    * degree", Advances in Computational Mathematics, 1995
+    * is used instead, as in Morse B.S., Yoo T.S., Rheingans P., Chen D.T. and Subramanian K.R.,
+    * "Interpolating implicit surfaces from scattered surface data using compactly supported radial basis functions",
+    * SMI '01
+    *
     * \author Alexandru E. Ichim
     * \ingroup surface
     */
@@ -67,6 +74,8 @@ namespace pcl
       using MarchingCubes<PointNT>::size_voxel_;
       using MarchingCubes<PointNT>::upper_boundary_;
       using MarchingCubes<PointNT>::lower_boundary_;
+      using MarchingCubes<PointNT>::computeGridValues;
+      using MarchingCubes<PointNT>::threads_;
 
       using PointCloudPtr = typename pcl::PointCloud<PointNT>::Ptr;
 
@@ -79,7 +88,8 @@ namespace pcl
                         const float percentage_extend_grid = 0.0f,
                         const float iso_level = 0.0f) :
         MarchingCubes<PointNT> (percentage_extend_grid, iso_level),
-        off_surface_epsilon_ (off_surface_epsilon)
+        off_surface_epsilon_ (off_surface_epsilon),
+        support_radius_ (0.0f)
       {
       }
 
@@ -104,15 +114,46 @@ namespace pcl
       getOffSurfaceDisplacement ()
       { return off_surface_epsilon_; }
 
+      /** \brief Set the support radius of a compactly supported kernel, to use instead of the global one.
+        * The global kernel needs a dense system of all the points, of cubic cost, and every point in the value of
+        * every voxel. The compact kernel only relates the points closer than the support radius, so the system is
+        * sparse and solved iteratively, and the voxels farther than the support radius from all the points are left
+        * without a value. The points are then constrained on both sides of the surface, at the off-surface
+        * displacement, which must be smaller than the support radius. For large clouds, use it with setSparseGrid ().
+        * \param[in] support_radius the support radius, a few times the point spacing, or 0 for the global kernel
+        * (default)
+        */
+      inline void
+      setSupportRadius (float support_radius)
+      { support_radius_ = support_radius; }
+
+      /** \brief Get the support radius of the compactly supported kernel (0 for the global kernel). */
+      inline float
+      getSupportRadius () const
+      { return support_radius_; }
+
 
     protected:
       /** \brief the Radial Basis Function kernel. */
       double
       kernel (Eigen::Vector3d c, Eigen::Vector3d x);
 
+      /** \brief the compactly supported Radial Basis Function kernel (Wendland's C2 function).
+        * \param[in] r the distance to the center
+        */
+      double
+      compactKernel (double r) const;
+
+      /** \brief Convert the point cloud into voxel data, with the compactly supported kernel. */
+      void
+      voxelizeDataCompact ();
+
       /** \brief The off-surface displacement value. */
       float off_surface_epsilon_;
 
+      /** \brief The support radius of the compactly supported kernel, or 0 for the global kernel. */
+      float support_radius_;
+
     public:
       PCL_MAKE_ALIGNED_OPERATOR_NEW
   };
@@ -0,0 +1,112 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved
+ */
+
+#pragma once
+
+#include <pcl/surface/processing.h>
+#include <pcl/PCLPointCloud2.h>
+#include <pcl/TriangleMesh.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace pcl
+{
+  /** \brief Mesh decimation by quadric error edge collapses (Garland and Heckbert, "Surface Simplification Using
+    * Quadric Error Metrics", SIGGRAPH 1997), working on the PCL mesh data directly, without the conversions to and
+    * from vtkPolyData of MeshQuadricDecimationVTK.
+    *
+    * Polygons with more than three vertices are split into triangles first. The edges are collapsed in the order of
+    * increasing quadric error until the requested fraction of the triangles is removed; collapses that would flip a
+    * triangle or make the mesh non-manifold are skipped. Boundary edges are kept in place by additional quadrics of
+    * the planes orthogonal to the boundary triangles, weighted by setBoundaryWeight (). The vertices left unused by
+    * the collapses are removed from the output, like SimplificationRemoveUnusedVertices does, and the surviving
+    * vertices keep all the other fields of the input point they stem from.
+    *
+    * The quadrics, the initial collapse costs and the output are computed with OpenMP threads; the collapses
+    * themselves are inherently sequential. The result does not depend on the number of threads.
+    * \ingroup surface
+    */
+  class PCL_EXPORTS MeshQuadricDecimation : public MeshProcessing
+  {
+    public:
+      using Ptr = shared_ptr<MeshQuadricDecimation>;
+      using ConstPtr = shared_ptr<const MeshQuadricDecimation>;
+
+      /** \brief Empty constructor */
+      MeshQuadricDecimation ();
+
+      /** \brief Set the fraction of the triangles that should be removed, in [0, 1).
+        * \param[in] factor the factor
+        */
+      inline void
+      setTargetReductionFactor (float factor) { target_reduction_factor_ = factor; }
+
+      /** \brief Get the target reduction factor */
+      inline float
+      getTargetReductionFactor () const { return (target_reduction_factor_); }
+
+      /** \brief Set the weight of the boundary constraints relative to the surface error. 0 lets the boundaries
+        * shrink freely.
+        * \param[in] weight the weight, 1000 by default
+        */
+      inline void
+      setBoundaryWeight (float weight) { boundary_weight_ = weight; }
+
+      /** \brief Get the weight of the boundary constraints */
+      inline float
+      getBoundaryWeight () const { return (boundary_weight_); }
+
+      /** \brief Set the number of threads to use.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      inline void
+      setNumberOfThreads (unsigned int nr_threads = 0) { threads_ = nr_threads; }
+
+      /** \brief Get the number of threads to use, 0 meaning automatic. */
+      inline unsigned int
+      getNumberOfThreads () const { return (threads_); }
+
+      /** \brief Decimate a triangle mesh, without going through the input mesh and a pcl::PolygonMesh.
+        * \param[in] input the input triangle mesh
+        * \param[out] output the decimated triangle mesh
+        */
+      void
+      decimate (const pcl::TriangleMesh &input, pcl::TriangleMesh &output);
+
+    protected:
+      void
+      performProcessing (pcl::PolygonMesh &output) override;
+
+      /** \brief Class get name method. */
+      std::string
+      getClassName () const override { return ("MeshQuadricDecimation"); }
+
+      /** \brief Decimate a mesh given as vertex data and a flat buffer of triangles.
+        * \param[in] cloud the vertices of the input mesh, with x, y and z fields
+        * \param[in] triangles the vertex indices of the input triangles, three per triangle
+        * \param[out] output_cloud the vertices of the decimated mesh
+        * \param[out] output_triangles the vertex indices of the decimated triangles, three per triangle
+        */
+      void
+      decimateTriangles (const pcl::PCLPointCloud2 &cloud, const std::vector<std::uint32_t> &triangles,
+                         pcl::PCLPointCloud2 &output_cloud, std::vector<std::uint32_t> &output_triangles) const;
+
+    private:
+      /** \brief The fraction of the triangles to remove. */
+      float target_reduction_factor_;
+
+      /** \brief The weight of the boundary constraint quadrics. */
+      float boundary_weight_;
+
+      /** \brief The number of threads the scheduler should use, 0 meaning automatic. */
+      unsigned int threads_;
+  };
+}
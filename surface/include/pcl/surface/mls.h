@@ -40,8 +40,9 @@
 #pragma once
 
 #include <functional>
-#include <map>
 #include <random>
+#include <unordered_map>
+#include <vector>
 #include <Eigen/Core> // for Vector3i, Vector3d, ...
 
 // PCL includes
@@ -643,7 +644,7 @@ namespace pcl
               point[i] = static_cast<Eigen::Vector3f::Scalar> (index_3d[i]) * voxel_size_ + bounding_min_[i];
           }
 
-          typedef std::map<std::uint64_t, Leaf> HashMap;
+          typedef std::unordered_map<std::uint64_t, Leaf> HashMap;
           HashMap voxel_grid_;
           Eigen::Vector4f bounding_min_, bounding_max_;
           std::uint64_t data_size_;
@@ -731,8 +732,8 @@ namespace pcl
       performUpsampling (PointCloudOut &output);
 
     private:
-      /** \brief Random number generator algorithm. */
-      mutable std::mt19937 rng_;
+      /** \brief Random number generator algorithm, one per thread. */
+      mutable std::vector<std::mt19937> rng_;
 
       /** \brief Random number generator using an uniform distribution of floats
         * \note Used only in the case of RANDOM_UNIFORM_DENSITY upsampling
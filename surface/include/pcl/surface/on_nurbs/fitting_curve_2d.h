@@ -207,6 +207,18 @@ namespace pcl
           in_accuracy = accuracy;
         }
 
+        /** \brief Set the number of threads used for the inverse mapping of the interior points.
+          * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic) */
+        void
+        setNumberOfThreads (unsigned int nr_threads = 0);
+
+        /** \brief Store and solve the system of equations sparsely (see NurbsSolve::setSparse). */
+        inline void
+        setSparse (bool val)
+        {
+          m_solver.setSparse (val);
+        }
+
       protected:
         /** \brief Add minimization constraint: point-to-curve distance (point-distance-minimization). */
         virtual void
@@ -220,10 +232,16 @@ namespace pcl
         virtual void
         assembleInterior (double wInt, double rScale, unsigned &row);
 
+        /** \brief Inverse mapping of all interior points, computed in parallel. Updates m_data->interior_param
+          * and returns the closest points, tangents and distances in the order of m_data->interior. */
+        void
+        inverseMappingInteriorPoints (double rScale, std::vector<double> &error, vector_vec2d &pt, vector_vec2d &t);
+
         NurbsSolve m_solver;
         bool m_quiet;
         int in_max_steps;
         double in_accuracy;
+        unsigned int m_threads = 1;
 
     };
   }
@@ -144,6 +144,19 @@ namespace pcl
       void
       setInvMapParams (unsigned in_max_steps, double in_accuracy);
 
+      /** \brief Set the number of threads used for the inverse mapping of interior and boundary points.
+       * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+       */
+      void
+      setNumberOfThreads (unsigned int nr_threads = 0);
+
+      /** \brief Store and solve the system of equations sparsely (see NurbsSolve::setSparse). */
+      inline void
+      setSparse (bool val)
+      {
+        m_solver.setSparse (val);
+      }
+
       /** \brief Get the elements of a B-Spline surface.*/
       static std::vector<double>
       getElementVector (const ON_NurbsSurface &nurbs, int dim);
@@ -249,6 +262,16 @@ namespace pcl
       virtual void
       assembleBoundary (double wBnd, unsigned &row);
 
+      /** \brief Inverse mapping of all interior points, computed in parallel. Updates m_data->interior_param and
+       * returns the closest points, tangents and distances in the order of m_data->interior. */
+      void
+      inverseMappingInteriorPoints (std::vector<double> &error, vector_vec3d &pt, vector_vec3d &tu, vector_vec3d &tv);
+
+      /** \brief Inverse mapping of all boundary points, computed in parallel. Updates m_data->boundary_param and
+       * returns the closest points, tangents and distances in the order of m_data->boundary. */
+      void
+      inverseMappingBoundaryPoints (std::vector<double> &error, vector_vec3d &pt, vector_vec3d &tu, vector_vec3d &tv);
+
       /** \brief Add minimization constraint: point-to-surface distance (point-distance-minimization). */
       virtual void
       addPointConstraint (const Eigen::Vector2d &params, const Eigen::Vector3d &point, double weight, unsigned &row);
@@ -289,6 +312,8 @@ namespace pcl
       int in_max_steps;
       double in_accuracy;
 
+      unsigned int m_threads = 1;
+
       // index routines
       int
       grc2gl (int I, int J) const
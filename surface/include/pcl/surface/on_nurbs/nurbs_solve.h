@@ -56,7 +56,7 @@ namespace pcl
     public:
       /** \brief Empty constructor */
       NurbsSolve () :
-        m_quiet (true)
+        m_quiet (true), m_sparse (false)
       {
       }
 
@@ -114,6 +114,22 @@ namespace pcl
         m_quiet = val;
       }
 
+      /** \brief Store the system matrix K sparsely and solve the normal equations K^T K x = K^T f
+       *  with a sparse Cholesky factorization instead of a dense SVD (Eigen backend only, the
+       *  UmfPack backend is always sparse). Call before assign(). */
+      inline void
+      setSparse (bool val)
+      {
+        m_sparse = val;
+      }
+
+      /** \brief Whether the system matrix K is stored and solved sparsely. */
+      inline bool
+      getSparse () const
+      {
+        return (m_sparse);
+      }
+
       /** \brief get size of system */
       inline void
       getSize (unsigned &rows, unsigned &cols, unsigned &dims)
@@ -125,6 +141,7 @@ namespace pcl
 
     private:
       bool m_quiet;
+      bool m_sparse;
       SparseMat m_Ksparse;
       Eigen::MatrixXd m_Keig;
       Eigen::MatrixXd m_xeig;
@@ -229,6 +229,35 @@ namespace pcl
         use_depth_as_distance_ = enable;
       }
 
+      /** \brief Set the number of threads to use for meshing the rows of the input.
+        * The output does not depend on the number of threads.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      void
+      setNumberOfThreads (unsigned int nr_threads = 0);
+
+      /** \brief Get the number of threads to use. */
+      inline unsigned int
+      getNumberOfThreads () const
+      {
+        return (threads_);
+      }
+
+      /** \brief Get the number of vertices of every face: 4 for \a QUAD_MESH, 3 otherwise. */
+      inline int
+      getVerticesPerFace () const
+      {
+        return (triangulation_type_ == QUAD_MESH ? 4 : 3);
+      }
+
+      /** \brief Create the surface into a flat buffer of vertex indices, without a pcl::Vertices per face.
+        * The faces are stored one after the other, each as getVerticesPerFace () indices of the input cloud,
+        * in the same order as the polygons of reconstruct ().
+        * \param[out] face_vertices the indices of the vertices of all the faces
+        */
+      void
+      reconstructFaces (pcl::Indices &face_vertices);
+
     protected:
       /** \brief max length of edge, scalar component */
       float max_edge_length_a_;
@@ -270,6 +299,9 @@ namespace pcl
           This flag may be set using useDepthAsDistance(true) for (RGB-)Depth cameras to skip computations and gain additional speed up. */
       bool use_depth_as_distance_;
 
+      /** \brief The number of threads the scheduler should use. */
+      unsigned int threads_ = 1;
+
 
       /** \brief Perform the actual polygonal reconstruction.
         * \param[out] polygons the resultant polygons
@@ -293,6 +325,13 @@ namespace pcl
       void
       performReconstruction (pcl::PolygonMesh &output) override;
 
+      /** \brief Create the surface straight into a flat triangle mesh. Quads are split
+        * into two triangles.
+        * \param[out] output the resultant triangle mesh
+        */
+      void
+      performTriangleMeshReconstruction (pcl::TriangleMesh &output) override;
+
       /** \brief Add a new triangle to the current polygon mesh
         * \param[in] a index of the first vertex
         * \param[in] b index of the second vertex
@@ -340,13 +379,35 @@ namespace pcl
       inline void
       resetPointData (const int &point_index, pcl::PolygonMesh &mesh, const float &value = 0.0f,
                       int field_x_idx = 0, int field_y_idx = 1, int field_z_idx = 2)
+      {
+        resetPointData (point_index, mesh.cloud, value, field_x_idx, field_y_idx, field_z_idx);
+      }
+
+      /** \brief Set (all) coordinates of a particular point to the specified value
+        * \param[in] point_index index of point
+        * \param[out] cloud the vertex data of the mesh to modify
+        * \param[in] value value to use when re-setting
+        * \param[in] field_x_idx the X coordinate of the point
+        * \param[in] field_y_idx the Y coordinate of the point
+        * \param[in] field_z_idx the Z coordinate of the point
+        */
+      inline void
+      resetPointData (const int &point_index, pcl::PCLPointCloud2 &cloud, const float &value = 0.0f,
+                      int field_x_idx = 0, int field_y_idx = 1, int field_z_idx = 2)
       {
         float new_value = value;
-        memcpy (&mesh.cloud.data[point_index * mesh.cloud.point_step + mesh.cloud.fields[field_x_idx].offset], &new_value, sizeof (float));
-        memcpy (&mesh.cloud.data[point_index * mesh.cloud.point_step + mesh.cloud.fields[field_y_idx].offset], &new_value, sizeof (float));
-        memcpy (&mesh.cloud.data[point_index * mesh.cloud.point_step + mesh.cloud.fields[field_z_idx].offset], &new_value, sizeof (float));
+        memcpy (&cloud.data[point_index * cloud.point_step + cloud.fields[field_x_idx].offset], &new_value, sizeof (float));
+        memcpy (&cloud.data[point_index * cloud.point_step + cloud.fields[field_y_idx].offset], &new_value, sizeof (float));
+        memcpy (&cloud.data[point_index * cloud.point_step + cloud.fields[field_z_idx].offset], &new_value, sizeof (float));
       }
 
+      /** \brief Set the coordinates of all the non-finite points of the mesh vertex data to zero
+        * (only needed for ASCII mesh file output, e.g., in vtk files).
+        * \param[out] cloud the vertex data of the mesh to modify
+        */
+      void
+      resetNonFinitePoints (pcl::PCLPointCloud2 &cloud);
+
       /** \brief Check if a point is shadowed by another point
         * \param[in] point_a the first point
         * \param[in] point_b the second point
@@ -460,6 +521,29 @@ namespace pcl
         return (false);
       }
 
+      /** \brief Create the faces of one row of quads of the input.
+        * \param[in] y the row of the top left corners of the quads
+        * \param[in] type the triangulation type
+        * \param[out] face_vertices the buffer to append the indices of the vertices of the faces to
+        */
+      void
+      makeRowFaces (int y, TriangulationType type, pcl::Indices &face_vertices);
+
+      /** \brief Create the faces of all the rows of the input in parallel.
+        * \param[in] type the triangulation type
+        * \param[out] face_vertices the indices of the vertices of all the faces, in row order
+        */
+      void
+      makeFaces (TriangulationType type, pcl::Indices &face_vertices);
+
+      /** \brief Create a polygon for every face of a flat buffer of vertex indices.
+        * \param[in] face_vertices the indices of the vertices of the faces
+        * \param[in] vertices_per_face the number of vertices of every face
+        * \param[out] polygons the resultant mesh
+        */
+      void
+      makePolygons (const pcl::Indices &face_vertices, int vertices_per_face, std::vector<pcl::Vertices>& polygons);
+
       /** \brief Create a quad mesh.
         * \param[out] polygons the resultant mesh
         */
@@ -45,7 +45,7 @@ namespace pcl
 {
   namespace poisson
   {
-    class CoredVectorMeshData;
+    class CoredMeshData;
     template <class Real> struct Point3D;
   }
 
@@ -216,6 +216,30 @@ namespace pcl
       inline bool
       getManifold () { return manifold_; }
 
+      /** \brief Set the number of threads to use for building the octree, solving the Laplacian equation and
+        * extracting the iso-surface.
+        * \param[in] threads the number of threads (0 sets the value back to automatic)
+        */
+      void
+      setThreads (int threads);
+
+      /** \brief Get the number of threads to use */
+      inline int
+      getThreads () { return threads_; }
+
+      /** \brief Set the out-of-core mesh flag.
+        * \note Enabling this flag tells the reconstructor to store the vertices and polygons of the iso-surface in
+        * temporary files while they are extracted, instead of in memory. At high depths (above 11 or so), the
+        * extracted mesh takes as much memory as the octree; the files are read back once to fill the output.
+        * \param[in] out_of_core_mesh the given flag
+        */
+      inline void
+      setOutOfCoreMesh (bool out_of_core_mesh) { out_of_core_mesh_ = out_of_core_mesh; }
+
+      /** \brief Get the out-of-core mesh flag */
+      inline bool
+      getOutOfCoreMesh () { return out_of_core_mesh_; }
+
     protected:
       /** \brief Class get name method. */
       std::string
@@ -243,9 +267,19 @@ namespace pcl
       bool show_residual_;
       int min_iterations_;
       float solver_accuracy_;
+      int threads_;
+      bool out_of_core_mesh_;
+
+      /** \brief Reconstruct the surface and read the vertices and the polygons of the extracted mesh.
+        * \param[out] points the vertex positions of the resulting mesh
+        * \param[out] polygons the connectivity of the resulting mesh
+        */
+      template<typename PointT> void
+      reconstructMesh (pcl::PointCloud<PointT> &points,
+                       std::vector<pcl::Vertices> &polygons);
 
       template<int Degree> void
-      execute (poisson::CoredVectorMeshData &mesh,
+      execute (poisson::CoredMeshData &mesh,
                poisson::Point3D<float> &translate,
                float &scale);
 
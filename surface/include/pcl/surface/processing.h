@@ -41,11 +41,10 @@
 
 #include <pcl/pcl_base.h>
 #include <pcl/PolygonMesh.h>
+#include <pcl/point_cloud_fwd.h>
 
 namespace pcl
 {
-  template <typename PointT> class PointCloud;
-
   /** \brief @b CloudSurfaceProcessing represents the base class for algorithms that takes a point cloud as input and
     * produces a new output cloud that has been modified towards a better surface representation. These types of
     * algorithms include surface smoothing, hole filling, cloud upsampling etc.
@@ -41,6 +41,7 @@
 
 #include <pcl/pcl_base.h>
 #include <pcl/PolygonMesh.h>
+#include <pcl/TriangleMesh.h>
 #include <pcl/search/pcl_search.h>
 #include <pcl/conversions.h>
 #include <pcl/surface/boost.h>
@@ -53,6 +54,7 @@ namespace pcl
     *
     *  - \b setSearchMethod(&SearchPtr): passes a search locator
     *  - \b reconstruct(&PolygonMesh): creates a PolygonMesh object from the input data
+    *  - \b reconstruct(&TriangleMesh): creates a TriangleMesh object from the input data
     *
     * \author Radu B. Rusu, Michael Dixon, Alexandru E. Ichim
     */
@@ -92,6 +94,19 @@ namespace pcl
       virtual void 
       reconstruct (pcl::PolygonMesh &output) = 0;
 
+      /** \brief Base method for surface reconstruction into a flat triangle mesh for
+        * all points given in <setInputCloud (), setIndices ()>. Faces with more than
+        * three vertices are split into triangles.
+        * \param[out] output the resultant reconstructed surface model
+        */
+      virtual void
+      reconstruct (pcl::TriangleMesh &output)
+      {
+        pcl::PolygonMesh mesh;
+        reconstruct (mesh);
+        pcl::toTriangleMesh (std::move (mesh), output);
+      }
+
     protected:
       /** \brief A pointer to the spatial search object. */
       KdTreePtr tree_;
@@ -151,6 +166,13 @@ namespace pcl
       reconstruct (pcl::PointCloud<PointInT> &points,
                    std::vector<pcl::Vertices> &polygons);
 
+      /** \brief Base method for surface reconstruction into a flat triangle mesh for
+        * all points given in <setInputCloud (), setIndices ()>
+        * \param[out] output the resultant reconstructed surface model
+        */
+      void
+      reconstruct (pcl::TriangleMesh &output) override;
+
     protected:
       /** \brief A flag specifying whether or not the derived reconstruction
         * algorithm needs the search object \a tree.*/
@@ -169,6 +191,14 @@ namespace pcl
       virtual void 
       performReconstruction (pcl::PointCloud<PointInT> &points, 
                              std::vector<pcl::Vertices> &polygons) = 0;
+
+      /** \brief Surface reconstruction method into a flat triangle mesh. The default
+        * implementation runs performReconstruction (pcl::PolygonMesh &) and
+        * triangulates the resultant polygons; override it to write the triangles directly.
+        * \param[out] output the output triangle mesh, with the input data already in its cloud
+        */
+      virtual void
+      performTriangleMeshReconstruction (pcl::TriangleMesh &output);
   };
 
   /** \brief MeshConstruction represents a base surface reconstruction
@@ -223,6 +253,13 @@ namespace pcl
       virtual void 
       reconstruct (std::vector<pcl::Vertices> &polygons);
 
+      /** \brief Base method for mesh construction into a flat triangle mesh for all
+        * points given in <setInputCloud (), setIndices ()>
+        * \param[out] output the resultant reconstructed surface model
+        */
+      void
+      reconstruct (pcl::TriangleMesh &output) override;
+
     protected:
       /** \brief A flag specifying whether or not the derived reconstruction
         * algorithm needs the search object \a tree.*/
@@ -239,6 +276,14 @@ namespace pcl
         */
       virtual void 
       performReconstruction (std::vector<pcl::Vertices> &polygons) = 0;
+
+      /** \brief Mesh construction method into a flat triangle mesh. The default
+        * implementation runs performReconstruction (pcl::PolygonMesh &) and
+        * triangulates the resultant polygons; override it to write the triangles directly.
+        * \param[out] output the output triangle mesh, with the input data already in its cloud
+        */
+      virtual void
+      performTriangleMeshReconstruction (pcl::TriangleMesh &output);
   };
 }
 
@@ -165,6 +165,39 @@ namespace pcl
         tex_material_ = tex_material;
       }
 
+      /** \brief Set whether textureMeshwithMultipleCameras () finds the occluded faces with a z-buffer per camera.
+        * Every face seen by the camera is rasterized into a depth buffer of the camera's resolution, holding its
+        * farthest depth, and a face is occluded if one of its vertices lies behind the buffer. This replaces the
+        * per-face radius searches in a kd-tree of the projections, and is computed in parallel.
+        * \param[in] use_z_buffer true to use a z-buffer, false to use the kd-tree (default)
+        */
+      inline void
+      setUseZBuffer (bool use_z_buffer)
+      {
+        use_z_buffer_ = use_z_buffer;
+      }
+
+      /** \brief Get whether the occluded faces are found with a z-buffer per camera. */
+      inline bool
+      getUseZBuffer () const
+      {
+        return (use_z_buffer_);
+      }
+
+      /** \brief Set the number of threads to use for the z-buffer of textureMeshwithMultipleCameras ()
+        * and for the occlusion ray casting of removeOccludedPoints () and showOcclusions ().
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      void
+      setNumberOfThreads (unsigned int nr_threads = 0);
+
+      /** \brief Get the number of threads to use. */
+      inline unsigned int
+      getNumberOfThreads () const
+      {
+        return (threads_);
+      }
+
       /** \brief Map texture to a mesh synthesis algorithm
         * \param[in] tex_mesh texture mesh
         */
@@ -347,6 +380,12 @@ namespace pcl
       /** \brief list of texture materials */
       TexMaterial tex_material_;
 
+      /** \brief Whether the occluded faces are found with a z-buffer per camera. */
+      bool use_z_buffer_ = false;
+
+      /** \brief The number of threads the scheduler should use. */
+      unsigned int threads_ = 1;
+
       /** \brief Map texture to a face
         * \param[in] p1 the first point
         * \param[in] p2 the second point
@@ -412,6 +451,19 @@ namespace pcl
       inline bool
       checkPointInsideTriangle (const pcl::PointXY &p1, const pcl::PointXY &p2, const pcl::PointXY &p3, const pcl::PointXY &pt);
 
+      /** \brief Find which faces of the sub-mesh of a camera are visible, using a z-buffer of all the faces it sees.
+        * \param[in] mesh the mesh, whose sub-meshes up to current_cam hold all the faces
+        * \param[in] current_cam the index of the camera, and of the sub-mesh to check
+        * \param[in] camera the camera
+        * \param[in] camera_cloud the points of the mesh in the camera's frame
+        * \param[out] projections the uv coordinates of the 3 vertices of every face of the sub-mesh (NaN if not projected)
+        * \param[out] visibility true for the faces of the sub-mesh that are projected and not occluded
+        */
+      void
+      computeFaceVisibilityZBuffer (const pcl::TextureMesh &mesh, int current_cam, const Camera &camera,
+                                    const PointCloud &camera_cloud, pcl::PointCloud<pcl::PointXY> &projections,
+                                    std::vector<bool> &visibility);
+
       /** \brief Class get name method. */
       std::string
       getClassName () const
@@ -26,6 +26,9 @@ ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF S
 DAMAGE.
 */
 #include <pcl/surface/3rdparty/poisson4/geometry.h>
+#include <pcl/surface/3rdparty/poisson4/poisson_exceptions.h>
+
+#include <cstdio>
 
 ///////////////////
 // CoredMeshData //
@@ -123,5 +126,64 @@ namespace pcl
     int CoredVectorMeshData2::outOfCorePointCount(void){return int(oocPoints.size());}
     int CoredVectorMeshData2::polygonCount( void ) { return int( polygons.size() ); }
 
+    ///////////////////////
+    // CoredFileMeshData //
+    ///////////////////////
+    CoredFileMeshData::CoredFileMeshData( void )
+    {
+      oocPoints = polygons = 0;
+      oocPointFile = std::tmpfile();
+      polygonFile = std::tmpfile();
+      if( !oocPointFile || !polygonFile )
+      {
+        if( oocPointFile ) std::fclose( oocPointFile );
+        if( polygonFile ) std::fclose( polygonFile );
+        POISSON_THROW_EXCEPTION (pcl::poisson::PoissonBadInitException, "Failed to create the temporary files of the out-of-core mesh.");
+      }
+    }
+    CoredFileMeshData::~CoredFileMeshData( void )
+    {
+      std::fclose( oocPointFile );
+      std::fclose( polygonFile );
+    }
+    void CoredFileMeshData::resetIterator ( void )
+    {
+      std::fseek( oocPointFile , 0 , SEEK_SET );
+      std::fseek( polygonFile , 0 , SEEK_SET );
+    }
+    int CoredFileMeshData::addOutOfCorePoint( const Point3D<float>& p )
+    {
+      std::fwrite( &p , sizeof( Point3D<float> ) , 1 , oocPointFile );
+      return oocPoints++;
+    }
+    int CoredFileMeshData::addPolygon( const std::vector< CoredVertexIndex >& vertices )
+    {
+      std::vector< int > polygon( vertices.size()+1 );
+      polygon[0] = int( vertices.size() );
+      for( int i=0 ; i<int(vertices.size()) ; i++ )
+        if( vertices[i].inCore ) polygon[i+1] =  vertices[i].idx;
+        else                     polygon[i+1] = -vertices[i].idx-1;
+      std::fwrite( &polygon[0] , sizeof( int ) , polygon.size() , polygonFile );
+      return polygons++;
+    }
+    int CoredFileMeshData::nextOutOfCorePoint( Point3D<float>& p )
+    {
+      return std::fread( &p , sizeof( Point3D<float> ) , 1 , oocPointFile ) == 1 ? 1 : 0;
+    }
+    int CoredFileMeshData::nextPolygon( std::vector< CoredVertexIndex >& vertices )
+    {
+      int pSize;
+      if( std::fread( &pSize , sizeof( int ) , 1 , polygonFile ) != 1 ) return 0;
+      std::vector< int > polygon( pSize );
+      if( pSize && std::fread( &polygon[0] , sizeof( int ) , pSize , polygonFile ) != std::size_t( pSize ) ) return 0;
+      vertices.resize( pSize );
+      for( int i=0 ; i<pSize ; i++ )
+        if( polygon[i]<0 ) vertices[i].idx = -polygon[i]-1 , vertices[i].inCore = false;
+        else               vertices[i].idx =  polygon[i]   , vertices[i].inCore = true;
+      return 1;
+    }
+    int CoredFileMeshData::outOfCorePointCount( void ) { return oocPoints; }
+    int CoredFileMeshData::polygonCount( void ) { return polygons; }
+
   }
 }
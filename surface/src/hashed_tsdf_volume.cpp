@@ -0,0 +1,387 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved
+ */
+
+#include <pcl/surface/hashed_tsdf_volume.h>
+#include <pcl/common/utils.h> // for getNumberOfThreads
+#include <pcl/console/print.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+constexpr int pcl::HashedTSDFVolume::BLOCK_SIZE;
+constexpr int pcl::HashedTSDFVolume::BLOCK_VOXELS;
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+pcl::HashedTSDFVolume::HashedTSDFVolume (float voxel_size, float truncation_distance)
+  : voxel_size_ (voxel_size)
+  , truncation_distance_ (truncation_distance)
+  , max_weight_ (128.f)
+  , fx_ (585.f), fy_ (585.f), cx_ (319.5f), cy_ (239.5f)
+  , min_depth_ (0.3f), max_depth_ (4.f)
+  , threads_ (0)
+{
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::HashedTSDFVolume::setVoxelSize (float voxel_size)
+{
+  voxel_size_ = voxel_size;
+  reset ();
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::HashedTSDFVolume::setDepthIntrinsics (float fx, float fy, float cx, float cy)
+{
+  fx_ = fx;
+  fy_ = fy;
+  cx_ = cx;
+  cy_ = cy;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::HashedTSDFVolume::setDepthRange (float min_depth, float max_depth)
+{
+  min_depth_ = min_depth;
+  max_depth_ = max_depth;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::HashedTSDFVolume::reset ()
+{
+  block_index_.clear ();
+  blocks_.clear ();
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::HashedTSDFVolume::collectBlocks (const unsigned short *depth, int width, int height, const Eigen::Affine3f &pose,
+                                      std::vector<std::int64_t> &keys) const
+{
+  const float block_length = BLOCK_SIZE * voxel_size_;
+
+  // clang-format off
+#pragma omp parallel \
+  default(none) \
+  shared(block_length, depth, height, keys, pose, width) \
+  num_threads(pcl::utils::getNumberOfThreads (threads_))
+  // clang-format on
+  {
+    std::vector<std::int64_t> local_keys;
+#pragma omp for schedule(static)
+    for (int v = 0; v < height; ++v)
+    {
+      // neighboring pixels mostly touch the same blocks, only new ranges are collected
+      Eigen::Array3i last_min (1, 1, 1), last_max (0, 0, 0);
+      for (int u = 0; u < width; ++u)
+      {
+        const float d = depth[v * width + u] * 0.001f;
+        if (d < min_depth_ || d > max_depth_)
+          continue;
+
+        const Eigen::Vector3f point = pose * Eigen::Vector3f ((u - cx_) * d / fx_, (v - cy_) * d / fy_, d);
+        const Eigen::Array3i min_block = ((point.array () - truncation_distance_) / block_length).floor ().cast<int> ();
+        const Eigen::Array3i max_block = ((point.array () + truncation_distance_) / block_length).floor ().cast<int> ();
+        if ((min_block == last_min).all () && (max_block == last_max).all ())
+          continue;
+        last_min = min_block;
+        last_max = max_block;
+
+        for (int bz = min_block[2]; bz <= max_block[2]; ++bz)
+          for (int by = min_block[1]; by <= max_block[1]; ++by)
+            for (int bx = min_block[0]; bx <= max_block[0]; ++bx)
+              local_keys.push_back (getBlockKey (bx, by, bz));
+      }
+    }
+#pragma omp critical
+    keys.insert (keys.end (), local_keys.begin (), local_keys.end ());
+  }
+
+  std::sort (keys.begin (), keys.end ());
+  keys.erase (std::unique (keys.begin (), keys.end ()), keys.end ());
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::HashedTSDFVolume::integrateBlock (std::int64_t key, Block &block, const unsigned short *depth, int width, int height,
+                                       const Eigen::Matrix3f &R_inv, const Eigen::Vector3f &t_inv) const
+{
+  using Row = Eigen::Array<float, BLOCK_SIZE, 1>;
+
+  const std::int64_t offset = 1 << 20;
+  const std::int64_t mask = (1 << 21) - 1;
+  const int x0 = static_cast<int> (((key >> 42) & mask) - offset) * BLOCK_SIZE;
+  const int y0 = static_cast<int> (((key >> 21) & mask) - offset) * BLOCK_SIZE;
+  const int z0 = static_cast<int> ((key & mask) - offset) * BLOCK_SIZE;
+
+  // camera coordinates of the voxels of a row, one voxel step apart along the volume x axis
+  const Row steps = Row::LinSpaced (BLOCK_SIZE, 0.f, BLOCK_SIZE - 1.f);
+  const Eigen::Vector3f dx = R_inv.col (0) * voxel_size_;
+  const float inv_truncation = 1.f / truncation_distance_;
+
+  for (int z = 0; z < BLOCK_SIZE; ++z)
+    for (int y = 0; y < BLOCK_SIZE; ++y)
+    {
+      const Eigen::Vector3f cam = R_inv * (Eigen::Vector3f (x0, y0 + y, z0 + z) * voxel_size_) + t_inv;
+      const Row X = cam[0] + steps * dx[0];
+      const Row Y = cam[1] + steps * dx[1];
+      const Row Z = cam[2] + steps * dx[2];
+      const Row u = fx_ * X / Z + cx_;
+      const Row v = fy_ * Y / Z + cy_;
+
+      // the only scalar part: gathering the measurements the voxels project to
+      Row d = Row::Zero ();
+      for (int x = 0; x < BLOCK_SIZE; ++x)
+      {
+        if (Z[x] <= 0.f || !(u[x] >= -0.5f && u[x] < width - 0.5f && v[x] >= -0.5f && v[x] < height - 0.5f))
+          continue;
+        const int ui = static_cast<int> (u[x] + 0.5f);
+        const int vi = static_cast<int> (v[x] + 0.5f);
+        const float measurement = depth[vi * width + ui] * 0.001f;
+        if (measurement >= min_depth_ && measurement <= max_depth_)
+          d[x] = measurement;
+      }
+
+      const Row sdf = d - Z;
+      const auto valid = (d > 0.f) && (sdf >= -truncation_distance_);
+      if (!valid.any ())
+        continue;
+
+      Eigen::Map<Row> tsdf (block.tsdf.data () + (z * BLOCK_SIZE + y) * BLOCK_SIZE);
+      Eigen::Map<Row> weight (block.weight.data () + (z * BLOCK_SIZE + y) * BLOCK_SIZE);
+      const Row weight_sum = weight + 1.f;
+      const Row fused = (tsdf * weight + (sdf * inv_truncation).min (1.f)) / weight_sum;
+      tsdf = valid.select (fused, tsdf);
+      weight = valid.select (weight_sum.min (max_weight_), weight);
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::HashedTSDFVolume::integrate (const unsigned short *depth, int width, int height, const Eigen::Affine3f &pose)
+{
+  if (!depth || width <= 0 || height <= 0)
+  {
+    PCL_ERROR ("[pcl::HashedTSDFVolume::integrate] Invalid depth image!\n");
+    return;
+  }
+
+  std::vector<std::int64_t> keys;
+  collectBlocks (depth, width, height, pose, keys);
+
+  // allocation is serial, the blocks are then updated independently
+  std::vector<std::size_t> indices (keys.size ());
+  for (std::size_t i = 0; i < keys.size (); ++i)
+  {
+    const auto result = block_index_.emplace (keys[i], blocks_.size ());
+    if (result.second)
+    {
+      blocks_.emplace_back ();
+      blocks_.back ().tsdf.fill (1.f);
+      blocks_.back ().weight.fill (0.f);
+    }
+    indices[i] = result.first->second;
+  }
+
+  const Eigen::Matrix3f R_inv = pose.linear ().transpose ();
+  const Eigen::Vector3f t_inv = -R_inv * pose.translation ();
+
+  // clang-format off
+#pragma omp parallel for \
+  default(none) \
+  shared(depth, height, indices, keys, R_inv, t_inv, width) \
+  schedule(dynamic, 16) \
+  num_threads(pcl::utils::getNumberOfThreads (threads_))
+  // clang-format on
+  for (std::ptrdiff_t i = 0; i < static_cast<std::ptrdiff_t> (keys.size ()); ++i)
+    integrateBlock (keys[i], blocks_[indices[i]], depth, width, height, R_inv, t_inv);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+bool
+pcl::HashedTSDFVolume::getVoxel (int x, int y, int z, float &tsdf) const
+{
+  const int bx = blockCoord (x), by = blockCoord (y), bz = blockCoord (z);
+  const Block *block = findBlock (getBlockKey (bx, by, bz));
+  if (!block)
+    return (false);
+
+  const int index = ((z - bz * BLOCK_SIZE) * BLOCK_SIZE + (y - by * BLOCK_SIZE)) * BLOCK_SIZE + (x - bx * BLOCK_SIZE);
+  if (block->weight[index] == 0.f)
+    return (false);
+  tsdf = block->tsdf[index];
+  return (true);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+bool
+pcl::HashedTSDFVolume::getTsdfValue (const Eigen::Vector3f &point, float &tsdf) const
+{
+  const Eigen::Array3f g = point.array () / voxel_size_;
+  const Eigen::Array3f g0 = g.floor ();
+  const Eigen::Array3f a = g - g0;
+  const int x = static_cast<int> (g0[0]), y = static_cast<int> (g0[1]), z = static_cast<int> (g0[2]);
+
+  float c[8];
+  const int bx = blockCoord (x), by = blockCoord (y), bz = blockCoord (z);
+  const int lx = x - bx * BLOCK_SIZE, ly = y - by * BLOCK_SIZE, lz = z - bz * BLOCK_SIZE;
+  if (lx < BLOCK_SIZE - 1 && ly < BLOCK_SIZE - 1 && lz < BLOCK_SIZE - 1)
+  {
+    // all 8 voxels in the same block, a single lookup
+    const Block *block = findBlock (getBlockKey (bx, by, bz));
+    if (!block)
+      return (false);
+    for (int k = 0; k < 8; ++k)
+    {
+      const int index = ((lz + (k >> 2)) * BLOCK_SIZE + ly + ((k >> 1) & 1)) * BLOCK_SIZE + lx + (k & 1);
+      if (block->weight[index] == 0.f)
+        return (false);
+      c[k] = block->tsdf[index];
+    }
+  }
+  else
+  {
+    for (int k = 0; k < 8; ++k)
+      if (!getVoxel (x + (k & 1), y + ((k >> 1) & 1), z + (k >> 2), c[k]))
+        return (false);
+  }
+
+  const float c00 = c[0] + (c[1] - c[0]) * a[0];
+  const float c10 = c[2] + (c[3] - c[2]) * a[0];
+  const float c01 = c[4] + (c[5] - c[4]) * a[0];
+  const float c11 = c[6] + (c[7] - c[6]) * a[0];
+  const float c0 = c00 + (c10 - c00) * a[1];
+  const float c1 = c01 + (c11 - c01) * a[1];
+  tsdf = c0 + (c1 - c0) * a[2];
+  return (true);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::HashedTSDFVolume::raycast (const Eigen::Affine3f &pose, int width, int height,
+                                pcl::PointCloud<pcl::PointNormal> &cloud) const
+{
+  const float nan = std::numeric_limits<float>::quiet_NaN ();
+  pcl::PointNormal invalid;
+  invalid.x = invalid.y = invalid.z = nan;
+  invalid.normal_x = invalid.normal_y = invalid.normal_z = nan;
+  invalid.curvature = nan;
+
+  cloud.width = width;
+  cloud.height = height;
+  cloud.is_dense = false;
+  cloud.points.assign (static_cast<std::size_t> (width) * height, invalid);
+
+  const Eigen::Matrix3f R = pose.linear ();
+  const Eigen::Vector3f origin = pose.translation ();
+  const float block_length = BLOCK_SIZE * voxel_size_;
+
+  // clang-format off
+#pragma omp parallel for \
+  default(none) \
+  shared(block_length, cloud, height, origin, R, width) \
+  schedule(dynamic) \
+  num_threads(pcl::utils::getNumberOfThreads (threads_))
+  // clang-format on
+  for (int v = 0; v < height; ++v)
+  {
+    for (int u = 0; u < width; ++u)
+    {
+      // direction scaled so that the ray parameter is the depth of the pixel
+      const Eigen::Vector3f dir = R * Eigen::Vector3f ((u - cx_) / fx_, (v - cy_) / fy_, 1.f);
+      const float inv_scale = 1.f / dir.norm ();
+
+      float depth = min_depth_;
+      float prev_depth = depth, prev_tsdf = 0.f;
+      bool prev_valid = false;
+      while (depth < max_depth_)
+      {
+        const Eigen::Vector3f point = origin + dir * depth;
+        float tsdf, step;
+        if (getTsdfValue (point, tsdf))
+        {
+          if (prev_valid && prev_tsdf > 0.f && tsdf <= 0.f)
+          {
+            // zero crossing from the front, interpolated between the last two samples
+            const float hit = prev_depth + (depth - prev_depth) * prev_tsdf / (prev_tsdf - tsdf);
+            const Eigen::Vector3f surface = origin + dir * hit;
+            pcl::PointNormal &p = cloud.points[v * width + u];
+            p.getVector3fMap () = surface;
+
+            Eigen::Vector3f gradient;
+            bool has_gradient = true;
+            for (int i = 0; i < 3 && has_gradient; ++i)
+            {
+              Eigen::Vector3f delta = Eigen::Vector3f::Zero ();
+              delta[i] = voxel_size_;
+              float f_plus, f_minus;
+              has_gradient = getTsdfValue (surface + delta, f_plus) && getTsdfValue (surface - delta, f_minus);
+              if (has_gradient)
+                gradient[i] = f_plus - f_minus;
+            }
+            if (has_gradient && gradient.squaredNorm () > 0.f)
+            {
+              p.getNormalVector3fMap () = gradient.normalized ();
+              p.curvature = 0.f;
+            }
+            break;
+          }
+          prev_valid = true;
+          prev_tsdf = tsdf;
+          prev_depth = depth;
+          // the TSDF bounds the distance to the surface in front of the sample
+          step = tsdf > 0.f ? std::max (tsdf * truncation_distance_ * 0.8f, voxel_size_) : voxel_size_;
+        }
+        else
+        {
+          prev_valid = false;
+          // unallocated blocks are crossed quickly, the surface is always inside allocated ones
+          const Eigen::Array3i voxel = (point.array () / voxel_size_).floor ().cast<int> ();
+          const bool allocated = findBlock (getBlockKey (blockCoord (voxel[0]), blockCoord (voxel[1]), blockCoord (voxel[2]))) != nullptr;
+          step = allocated ? voxel_size_ : block_length * 0.5f;
+        }
+        depth += step * inv_scale;
+      }
+    }
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::HashedTSDFVolume::convertToTsdfCloud (pcl::PointCloud<pcl::PointXYZI> &cloud) const
+{
+  const std::int64_t offset = 1 << 20;
+  const std::int64_t mask = (1 << 21) - 1;
+
+  cloud.clear ();
+  for (const auto &entry : block_index_)
+  {
+    const Block &block = blocks_[entry.second];
+    const int x0 = static_cast<int> (((entry.first >> 42) & mask) - offset) * BLOCK_SIZE;
+    const int y0 = static_cast<int> (((entry.first >> 21) & mask) - offset) * BLOCK_SIZE;
+    const int z0 = static_cast<int> ((entry.first & mask) - offset) * BLOCK_SIZE;
+
+    for (int i = 0; i < BLOCK_VOXELS; ++i)
+    {
+      if (block.weight[i] == 0.f || std::abs (block.tsdf[i]) >= 1.f)
+        continue;
+
+      pcl::PointXYZI p;
+      p.x = (x0 + i % BLOCK_SIZE) * voxel_size_;
+      p.y = (y0 + (i / BLOCK_SIZE) % BLOCK_SIZE) * voxel_size_;
+      p.z = (z0 + i / (BLOCK_SIZE * BLOCK_SIZE)) * voxel_size_;
+      p.intensity = block.tsdf[i];
+      cloud.push_back (p);
+    }
+  }
+}
@@ -0,0 +1,481 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved
+ */
+
+#include <pcl/surface/mesh_quadric_decimation.h>
+#include <pcl/common/io.h> // for getFieldIndex
+#include <pcl/common/utils.h> // for getNumberOfThreads
+#include <pcl/console/print.h>
+
+#include <Eigen/LU>
+#include <Eigen/StdVector>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <queue>
+#include <utility>
+
+namespace
+{
+  using Quadric = Eigen::Matrix4d;
+  using Quadrics = std::vector<Quadric, Eigen::aligned_allocator<Quadric> >;
+
+  /** \brief Weighted quadric of the squared distance to a plane given by its unit normal and a point. */
+  inline Quadric
+  planeQuadric (const Eigen::Vector3d &normal, const Eigen::Vector3d &point, double weight)
+  {
+    const Eigen::Vector4d plane (normal[0], normal[1], normal[2], -normal.dot (point));
+    return (weight * plane * plane.transpose ());
+  }
+
+  /** \brief Evaluate a quadric at a position. */
+  inline double
+  quadricError (const Quadric &quadric, const Eigen::Vector3d &position)
+  {
+    const Eigen::Vector4d h (position[0], position[1], position[2], 1.0);
+    return ((std::max) (0.0, h.dot (quadric * h)));
+  }
+
+  /** \brief A candidate edge collapse, valid as long as the versions of both vertices did not change. */
+  struct Collapse
+  {
+    double cost;
+    std::uint32_t v0, v1;
+    std::uint32_t version0, version1;
+    Eigen::Vector3d position;
+
+    /** \brief Order for a min-heap on the cost, ties broken on the vertices for determinism. */
+    bool
+    operator< (const Collapse &other) const
+    {
+      if (cost != other.cost)
+        return (cost > other.cost);
+      return (std::make_pair (v0, v1) > std::make_pair (other.v0, other.v1));
+    }
+  };
+
+  /** \brief Find the position minimizing the combined quadric of an edge and its error. The unconstrained
+    * minimum is only used if it lies within one edge length of the edge midpoint, the best of the midpoint and
+    * the end points otherwise.
+    */
+  Collapse
+  computeCollapse (const Quadric &quadric, std::uint32_t v0, std::uint32_t v1,
+                   const std::vector<Eigen::Vector3d> &positions, const std::vector<std::uint32_t> &versions)
+  {
+    const Eigen::Vector3d &p0 = positions[v0], &p1 = positions[v1];
+    const Eigen::Vector3d midpoint = 0.5 * (p0 + p1);
+
+    Collapse collapse;
+    collapse.v0 = v0;
+    collapse.v1 = v1;
+    collapse.version0 = versions[v0];
+    collapse.version1 = versions[v1];
+    collapse.position = midpoint;
+    collapse.cost = quadricError (quadric, midpoint);
+    for (const Eigen::Vector3d &candidate : {p0, p1})
+    {
+      const double error = quadricError (quadric, candidate);
+      if (error < collapse.cost)
+      {
+        collapse.cost = error;
+        collapse.position = candidate;
+      }
+    }
+
+    const Eigen::Matrix3d a = quadric.topLeftCorner<3, 3> ();
+    const double scale = a.norm ();
+    Eigen::Matrix3d inverse;
+    double determinant;
+    bool invertible;
+    a.computeInverseAndDetWithCheck (inverse, determinant, invertible, 1e-10 * scale * scale * scale);
+    if (invertible)
+    {
+      const Eigen::Vector3d optimum = -inverse * quadric.topRightCorner<3, 1> ();
+      const double error = quadricError (quadric, optimum);
+      if ((optimum - midpoint).norm () <= (p1 - p0).norm () && error < collapse.cost)
+      {
+        collapse.cost = error;
+        collapse.position = optimum;
+      }
+    }
+    return (collapse);
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+pcl::MeshQuadricDecimation::MeshQuadricDecimation ()
+  : target_reduction_factor_ (0.5f)
+  , boundary_weight_ (1000.f)
+  , threads_ (0)
+{
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::MeshQuadricDecimation::performProcessing (pcl::PolygonMesh &output)
+{
+  std::vector<std::uint32_t> triangles, output_triangles;
+  pcl::polygonsToTriangles (input_mesh_->polygons, triangles);
+  decimateTriangles (input_mesh_->cloud, triangles, output.cloud, output_triangles);
+  pcl::trianglesToPolygons (output_triangles, output.polygons);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::MeshQuadricDecimation::decimate (const pcl::TriangleMesh &input, pcl::TriangleMesh &output)
+{
+  output.header = input.header;
+  decimateTriangles (input.cloud, input.triangles, output.cloud, output.triangles);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::MeshQuadricDecimation::decimateTriangles (const pcl::PCLPointCloud2 &cloud,
+                                               const std::vector<std::uint32_t> &triangles,
+                                               pcl::PCLPointCloud2 &output_cloud,
+                                               std::vector<std::uint32_t> &output_triangles) const
+{
+  const std::size_t nr_points = static_cast<std::size_t> (cloud.width) * cloud.height;
+  const std::size_t nr_faces = triangles.size () / 3;
+
+  const int field_indices[3] = {pcl::getFieldIndex (cloud, "x"),
+                                pcl::getFieldIndex (cloud, "y"),
+                                pcl::getFieldIndex (cloud, "z")};
+  for (const int field_index : field_indices)
+    if (field_index == -1 || cloud.fields[field_index].datatype != pcl::PCLPointField::FLOAT32)
+    {
+      PCL_ERROR ("[pcl::%s::decimateTriangles] The input mesh has no float x, y and z fields!\n",
+                 getClassName ().c_str ());
+      output_cloud = cloud;
+      output_triangles.assign (triangles.begin (), triangles.begin () + 3 * nr_faces);
+      return;
+    }
+  if (std::any_of (triangles.begin (), triangles.begin () + 3 * nr_faces,
+                   [nr_points] (std::uint32_t v) { return (v >= nr_points); }))
+  {
+    PCL_ERROR ("[pcl::%s::decimateTriangles] The input mesh has vertex indices out of the cloud!\n",
+               getClassName ().c_str ());
+    output_cloud = cloud;
+    output_triangles.assign (triangles.begin (), triangles.begin () + 3 * nr_faces);
+    return;
+  }
+  const std::uint32_t offsets[3] = {cloud.fields[field_indices[0]].offset,
+                                    cloud.fields[field_indices[1]].offset,
+                                    cloud.fields[field_indices[2]].offset};
+
+  // Read the vertices, in double precision and relative to their bounding box center
+  std::vector<Eigen::Vector3d> positions (nr_points);
+  const std::ptrdiff_t nr_points_signed = static_cast<std::ptrdiff_t> (nr_points);
+#pragma omp parallel for \
+  default(none) \
+  shared(cloud, nr_points_signed, offsets, positions) \
+  num_threads(pcl::utils::getNumberOfThreads (threads_))
+  for (std::ptrdiff_t i = 0; i < nr_points_signed; ++i)
+    for (int d = 0; d < 3; ++d)
+    {
+      float value;
+      memcpy (&value, &cloud.data[i * cloud.point_step + offsets[d]], sizeof (float));
+      positions[i][d] = value;
+    }
+  Eigen::Vector3d min_p = Eigen::Vector3d::Constant (std::numeric_limits<double>::max ());
+  Eigen::Vector3d max_p = Eigen::Vector3d::Constant (std::numeric_limits<double>::lowest ());
+  for (const auto &position : positions)
+    if (position.allFinite ())
+    {
+      min_p = min_p.cwiseMin (position);
+      max_p = max_p.cwiseMax (position);
+    }
+  const Eigen::Vector3d center = nr_points > 0 && min_p[0] <= max_p[0] ? Eigen::Vector3d (0.5 * (min_p + max_p))
+                                                                       : Eigen::Vector3d::Zero ();
+  for (auto &position : positions)
+    position -= center;
+
+  // Drop the triangles with a repeated or non-finite vertex, and list the triangles of every vertex
+  std::vector<std::uint32_t> faces (triangles.begin (), triangles.begin () + 3 * nr_faces);
+  std::vector<std::uint8_t> face_alive (nr_faces, 0);
+  std::vector<std::vector<std::uint32_t> > vertex_faces (nr_points);
+  std::size_t nr_alive = 0;
+  for (std::size_t f = 0; f < nr_faces; ++f)
+  {
+    const std::uint32_t *face = &faces[3 * f];
+    if (face[0] == face[1] || face[1] == face[2] || face[0] == face[2] ||
+        !positions[face[0]].allFinite () || !positions[face[1]].allFinite () || !positions[face[2]].allFinite ())
+      continue;
+    face_alive[f] = 1;
+    ++nr_alive;
+    for (int k = 0; k < 3; ++k)
+      vertex_faces[face[k]].push_back (static_cast<std::uint32_t> (f));
+  }
+
+  const double factor = (std::min) ((std::max) (static_cast<double> (target_reduction_factor_), 0.0), 1.0);
+  const std::size_t target = static_cast<std::size_t> (std::ceil ((1.0 - factor) * static_cast<double> (nr_alive)));
+
+  // Quadric of every vertex: the planes of its triangles, weighted by their area
+  std::vector<Eigen::Vector4d, Eigen::aligned_allocator<Eigen::Vector4d> > face_planes (nr_faces, Eigen::Vector4d::Zero ());
+  const std::ptrdiff_t nr_faces_signed = static_cast<std::ptrdiff_t> (nr_faces);
+#pragma omp parallel for \
+  default(none) \
+  shared(face_alive, face_planes, faces, nr_faces_signed, positions) \
+  num_threads(pcl::utils::getNumberOfThreads (threads_))
+  for (std::ptrdiff_t f = 0; f < nr_faces_signed; ++f)
+  {
+    if (!face_alive[f])
+      continue;
+    const Eigen::Vector3d &p0 = positions[faces[3 * f]];
+    const Eigen::Vector3d cross = (positions[faces[3 * f + 1]] - p0).cross (positions[faces[3 * f + 2]] - p0);
+    const double norm = cross.norm ();
+    if (norm > 0.0)
+    {
+      const Eigen::Vector3d normal = cross / norm;
+      face_planes[f] << normal, -normal.dot (p0);
+      // Scale the plane so that its quadric is weighted by the area of the triangle
+      face_planes[f] *= std::sqrt (0.5 * norm);
+    }
+  }
+
+  Quadrics quadrics (nr_points, Quadric::Zero ());
+#pragma omp parallel for \
+  default(none) \
+  shared(face_planes, nr_points_signed, quadrics, vertex_faces) \
+  schedule(dynamic, 256) \
+  num_threads(pcl::utils::getNumberOfThreads (threads_))
+  for (std::ptrdiff_t v = 0; v < nr_points_signed; ++v)
+    for (const auto f : vertex_faces[v])
+      quadrics[v] += face_planes[f] * face_planes[f].transpose ();
+  face_planes.clear ();
+  face_planes.shrink_to_fit ();
+
+  // List every edge once, from its lower vertex, with the number of triangles it belongs to
+  struct Edge { std::uint32_t v0, v1, face, nr_faces; };
+  std::vector<std::size_t> edge_offsets (nr_points + 1, 0);
+  for (std::size_t v = 0; v < nr_points; ++v)
+    edge_offsets[v + 1] = edge_offsets[v] + 2 * vertex_faces[v].size ();
+  std::vector<Edge> edges (edge_offsets[nr_points]);
+  std::vector<std::size_t> nr_vertex_edges (nr_points, 0);
+#pragma omp parallel for \
+  default(none) \
+  shared(edge_offsets, edges, faces, nr_points_signed, nr_vertex_edges, vertex_faces) \
+  schedule(dynamic, 256) \
+  num_threads(pcl::utils::getNumberOfThreads (threads_))
+  for (std::ptrdiff_t v = 0; v < nr_points_signed; ++v)
+  {
+    Edge *begin = edges.data () + edge_offsets[v], *end = begin;
+    for (const auto f : vertex_faces[v])
+      for (int k = 0; k < 3; ++k)
+        if (faces[3 * f + k] == static_cast<std::uint32_t> (v))
+          for (const std::uint32_t n : {faces[3 * f + (k + 1) % 3], faces[3 * f + (k + 2) % 3]})
+            if (n > v)
+              *end++ = {static_cast<std::uint32_t> (v), n, f, 1};
+    std::sort (begin, end, [] (const Edge &a, const Edge &b)
+    {
+      return (a.v1 < b.v1 || (a.v1 == b.v1 && a.face < b.face));
+    });
+    Edge *last = begin;
+    for (Edge *edge = begin; edge != end; ++edge)
+      if (last != begin && (last - 1)->v1 == edge->v1)
+        ++(last - 1)->nr_faces;
+      else
+        *last++ = *edge;
+    nr_vertex_edges[v] = last - begin;
+  }
+
+  std::size_t nr_edges = 0;
+  for (std::size_t v = 0; v < nr_points; ++v)
+    for (std::size_t i = 0; i < nr_vertex_edges[v]; ++i)
+    {
+      const Edge edge = edges[edge_offsets[v] + i];
+      edges[nr_edges++] = edge;
+
+      // Keep the boundary in place with a plane through the edge, orthogonal to its triangle
+      if (edge.nr_faces == 1 && boundary_weight_ > 0.f)
+      {
+        const std::uint32_t *face = &faces[3 * edge.face];
+        const Eigen::Vector3d &p0 = positions[face[0]];
+        const Eigen::Vector3d face_normal = (positions[face[1]] - p0).cross (positions[face[2]] - p0);
+        const Eigen::Vector3d direction = positions[edge.v1] - positions[edge.v0];
+        const Eigen::Vector3d normal = direction.cross (face_normal);
+        const double norm = normal.norm ();
+        if (norm > 0.0)
+        {
+          const Quadric quadric = planeQuadric (normal / norm, positions[edge.v0],
+                                                boundary_weight_ * direction.squaredNorm ());
+          quadrics[edge.v0] += quadric;
+          quadrics[edge.v1] += quadric;
+        }
+      }
+    }
+  edges.resize (nr_edges);
+  std::vector<std::size_t> ().swap (edge_offsets);
+  std::vector<std::size_t> ().swap (nr_vertex_edges);
+
+  // Initial collapse costs
+  std::vector<std::uint32_t> versions (nr_points, 0);
+  std::vector<Collapse> collapses (nr_edges);
+  const std::ptrdiff_t nr_edges_signed = static_cast<std::ptrdiff_t> (nr_edges);
+#pragma omp parallel for \
+  default(none) \
+  shared(collapses, edges, nr_edges_signed, positions, quadrics, versions) \
+  num_threads(pcl::utils::getNumberOfThreads (threads_))
+  for (std::ptrdiff_t e = 0; e < nr_edges_signed; ++e)
+  {
+    const std::uint32_t v0 = edges[e].v0, v1 = edges[e].v1;
+    collapses[e] = computeCollapse (quadrics[v0] + quadrics[v1], v0, v1, positions, versions);
+  }
+  std::vector<Edge> ().swap (edges);
+  std::priority_queue<Collapse> heap (std::less<Collapse> (), std::move (collapses));
+
+  // Collapse the cheapest edges until enough triangles are removed
+  std::vector<std::uint8_t> vertex_alive (nr_points, 1);
+  std::vector<std::uint32_t> ring0, ring1, common;
+  const auto gather_ring = [&faces, &face_alive, &vertex_faces] (std::uint32_t v, std::vector<std::uint32_t> &ring)
+  {
+    ring.clear ();
+    for (const auto f : vertex_faces[v])
+      if (face_alive[f])
+        for (int k = 0; k < 3; ++k)
+          if (faces[3 * f + k] != v)
+            ring.push_back (faces[3 * f + k]);
+    std::sort (ring.begin (), ring.end ());
+    ring.erase (std::unique (ring.begin (), ring.end ()), ring.end ());
+  };
+  const auto face_contains = [&faces] (std::uint32_t f, std::uint32_t v)
+  {
+    return (faces[3 * f] == v || faces[3 * f + 1] == v || faces[3 * f + 2] == v);
+  };
+  // Check that no triangle around a vertex flips when the vertex moves to the collapse position
+  const auto keeps_orientation = [&] (std::uint32_t v, std::uint32_t other, const Eigen::Vector3d &position)
+  {
+    for (const auto f : vertex_faces[v])
+    {
+      if (!face_alive[f] || face_contains (f, other))
+        continue;
+      Eigen::Vector3d corners[3], moved[3];
+      for (int k = 0; k < 3; ++k)
+      {
+        corners[k] = positions[faces[3 * f + k]];
+        moved[k] = faces[3 * f + k] == v ? position : corners[k];
+      }
+      const Eigen::Vector3d normal = (corners[1] - corners[0]).cross (corners[2] - corners[0]);
+      const Eigen::Vector3d moved_normal = (moved[1] - moved[0]).cross (moved[2] - moved[0]);
+      if (normal.dot (moved_normal) <= 0.0)
+        return (false);
+    }
+    return (true);
+  };
+
+  while (nr_alive > target && !heap.empty ())
+  {
+    const Collapse collapse = heap.top ();
+    heap.pop ();
+    const std::uint32_t v0 = collapse.v0, v1 = collapse.v1;
+    if (!vertex_alive[v0] || !vertex_alive[v1] ||
+        versions[v0] != collapse.version0 || versions[v1] != collapse.version1)
+      continue;
+
+    // Link condition: the vertices adjacent to both end points are exactly the apexes of the edge triangles
+    std::size_t nr_shared = 0;
+    for (const auto f : vertex_faces[v0])
+      if (face_alive[f] && face_contains (f, v1))
+        ++nr_shared;
+    gather_ring (v0, ring0);
+    gather_ring (v1, ring1);
+    common.clear ();
+    std::set_intersection (ring0.begin (), ring0.end (), ring1.begin (), ring1.end (), std::back_inserter (common));
+    if (nr_shared == 0 || common.size () != nr_shared)
+      continue;
+    if (!keeps_orientation (v0, v1, collapse.position) || !keeps_orientation (v1, v0, collapse.position))
+      continue;
+
+    // Merge v1 into v0
+    positions[v0] = collapse.position;
+    quadrics[v0] += quadrics[v1];
+    for (const auto f : vertex_faces[v1])
+    {
+      if (!face_alive[f])
+        continue;
+      if (face_contains (f, v0))
+      {
+        face_alive[f] = 0;
+        --nr_alive;
+        continue;
+      }
+      for (int k = 0; k < 3; ++k)
+        if (faces[3 * f + k] == v1)
+          faces[3 * f + k] = v0;
+      vertex_faces[v0].push_back (f);
+    }
+    std::vector<std::uint32_t> ().swap (vertex_faces[v1]);
+    vertex_alive[v1] = 0;
+    auto &v0_faces = vertex_faces[v0];
+    v0_faces.erase (std::remove_if (v0_faces.begin (), v0_faces.end (),
+                                    [&face_alive] (std::uint32_t f) { return (!face_alive[f]); }),
+                    v0_faces.end ());
+    ++versions[v0];
+
+    gather_ring (v0, ring0);
+    for (const auto v : ring0)
+      heap.push (computeCollapse (quadrics[v0] + quadrics[v], v0, v, positions, versions));
+  }
+
+  // Keep the vertices of the remaining triangles, in their input order
+  std::vector<std::uint32_t> new_indices (nr_points, std::numeric_limits<std::uint32_t>::max ());
+  for (std::size_t f = 0; f < nr_faces; ++f)
+    if (face_alive[f])
+      for (int k = 0; k < 3; ++k)
+        new_indices[faces[3 * f + k]] = 0;
+  std::vector<std::uint32_t> used;
+  used.reserve (nr_points);
+  for (std::size_t i = 0; i < nr_points; ++i)
+    if (new_indices[i] == 0)
+    {
+      new_indices[i] = static_cast<std::uint32_t> (used.size ());
+      used.push_back (static_cast<std::uint32_t> (i));
+    }
+
+  pcl::PCLPointCloud2 result;
+  result.header = cloud.header;
+  result.fields = cloud.fields;
+  result.is_bigendian = cloud.is_bigendian;
+  result.point_step = cloud.point_step;
+  result.height = 1;
+  result.width = static_cast<std::uint32_t> (used.size ());
+  result.row_step = result.point_step * result.width;
+  result.is_dense = cloud.is_dense;
+  result.data.resize (used.size () * cloud.point_step);
+  const std::ptrdiff_t nr_used = static_cast<std::ptrdiff_t> (used.size ());
+#pragma omp parallel for \
+  default(none) \
+  shared(center, cloud, nr_used, offsets, positions, result, used, versions) \
+  num_threads(pcl::utils::getNumberOfThreads (threads_))
+  for (std::ptrdiff_t i = 0; i < nr_used; ++i)
+  {
+    std::uint8_t *point = &result.data[i * cloud.point_step];
+    memcpy (point, &cloud.data[used[i] * cloud.point_step], cloud.point_step);
+    // Only the vertices that absorbed a collapse moved
+    if (versions[used[i]] == 0)
+      continue;
+    for (int d = 0; d < 3; ++d)
+    {
+      const float value = static_cast<float> (positions[used[i]][d] + center[d]);
+      memcpy (point + offsets[d], &value, sizeof (float));
+    }
+  }
+
+  std::vector<std::uint32_t> result_triangles;
+  result_triangles.reserve (3 * nr_alive);
+  for (std::size_t f = 0; f < nr_faces; ++f)
+    if (face_alive[f])
+      for (int k = 0; k < 3; ++k)
+        result_triangles.push_back (new_indices[faces[3 * f + k]]);
+
+  output_cloud = std::move (result);
+  output_triangles = std::move (result_triangles);
+}
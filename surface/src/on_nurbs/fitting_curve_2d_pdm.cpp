@@ -37,8 +37,13 @@
 
 #include <pcl/surface/on_nurbs/fitting_curve_2d_pdm.h>
 #include <pcl/pcl_macros.h>
+#include <algorithm>
 #include <stdexcept>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 using namespace pcl;
 using namespace on_nurbs;
 
@@ -512,6 +517,44 @@ FittingCurve2dPDM::getElementVector (const ON_NurbsCurve &nurbs)
   return result;
 }
 
+void
+FittingCurve2dPDM::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    m_threads = omp_get_num_procs ();
+#else
+    m_threads = 1;
+#endif
+  else
+    m_threads = nr_threads;
+}
+
+void
+FittingCurve2dPDM::inverseMappingInteriorPoints (double rScale, std::vector<double> &error, vector_vec2d &pt, vector_vec2d &t)
+{
+  const int nInt = static_cast<int> (m_data->interior.size ());
+  // points with a parameter from the previous iteration start from there
+  const int nHint = std::min (nInt, static_cast<int> (m_data->interior_param.size ()));
+  m_data->interior_param.resize (nInt);
+  error.resize (nInt);
+  pt.resize (nInt);
+  t.resize (nInt);
+
+#pragma omp parallel for default(none) shared(error, pt, t) firstprivate(nInt, nHint, rScale) schedule(dynamic, 64) num_threads(m_threads)
+  for (int p = 0; p < nInt; p++)
+  {
+    const Eigen::Vector2d &pcp = m_data->interior[p];
+    double param;
+    if (p < nHint)
+      param = findClosestElementMidPoint (m_nurbs, pcp, m_data->interior_param[p]);
+    else
+      param = findClosestElementMidPoint (m_nurbs, pcp);
+    m_data->interior_param[p] = inverseMapping (m_nurbs, pcp, param, error[p], pt[p], t[p], rScale, in_max_steps,
+                                                in_accuracy, m_quiet);
+  }
+}
+
 void
 FittingCurve2dPDM::assembleInterior (double wInt, double rScale, unsigned &row)
 {
@@ -521,26 +564,17 @@ FittingCurve2dPDM::assembleInterior (double wInt, double rScale, unsigned &row)
   m_data->interior_line_start.clear ();
   m_data->interior_line_end.clear ();
 
+  // inverse mapping of all points (in parallel)
+  std::vector<double> errors;
+  vector_vec2d points, tangents;
+  inverseMappingInteriorPoints (rScale, errors, points, tangents);
+
   for (int p = 0; p < nInt; p++)
   {
     Eigen::Vector2d &pcp = m_data->interior[p];
 
-    // inverse mapping
-    double param;
-    Eigen::Vector2d pt, t;
-    double error;
-    if (p < int (m_data->interior_param.size ()))
-    {
-      param = findClosestElementMidPoint (m_nurbs, pcp, m_data->interior_param[p]);
-      param = inverseMapping (m_nurbs, pcp, param, error, pt, t, rScale, in_max_steps, in_accuracy, m_quiet);
-      m_data->interior_param[p] = param;
-    }
-    else
-    {
-      param = findClosestElementMidPoint (m_nurbs, pcp);
-      param = inverseMapping (m_nurbs, pcp, param, error, pt, t, rScale, in_max_steps, in_accuracy, m_quiet);
-      m_data->interior_param.push_back (param);
-    }
+    Eigen::Vector2d pt (points[p]), t (tangents[p]);
+    double error = errors[p];
 
     m_data->interior_error.push_back (error);
 
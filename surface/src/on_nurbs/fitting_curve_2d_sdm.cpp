@@ -229,26 +229,18 @@ FittingCurve2dSDM::assembleInterior (double wInt, double rScale, unsigned &row)
     updateTNR = true;
   }
 
+  // inverse mapping of all points (in parallel)
+  std::vector<double> errors;
+  vector_vec2d points, tangents;
+  inverseMappingInteriorPoints (rScale, errors, points, tangents);
+
   for (unsigned p = 0; p < nInt; p++)
   {
     Eigen::Vector2d &pcp = m_data->interior[p];
 
-    // inverse mapping
-    double param;
-    Eigen::Vector2d pt, t, n;
-    double error;
-    if (p < static_cast<unsigned int>(m_data->interior_param.size ()))
-    {
-      param = findClosestElementMidPoint (m_nurbs, pcp, m_data->interior_param[p]);
-      param = inverseMapping (m_nurbs, pcp, param, error, pt, t, rScale, in_max_steps, in_accuracy, m_quiet);
-      m_data->interior_param[p] = param;
-    }
-    else
-    {
-      param = findClosestElementMidPoint (m_nurbs, pcp);
-      param = inverseMapping (m_nurbs, pcp, param, error, pt, t, rScale, in_max_steps, in_accuracy, m_quiet);
-      m_data->interior_param.push_back (param);
-    }
+    double param = m_data->interior_param[p];
+    Eigen::Vector2d pt (points[p]), t (tangents[p]), n;
+    double error = errors[p];
 
     m_data->interior_error.push_back (error);
 
@@ -194,26 +194,16 @@ FittingCurve2dTDM::assembleInterior (double wInt, double rScale, unsigned &row)
   m_data->interior_line_end.clear ();
   m_data->interior_error.clear ();
   m_data->interior_normals.clear ();
+  // inverse mapping of all points (in parallel)
+  std::vector<double> errors;
+  vector_vec2d points, tangents;
+  inverseMappingInteriorPoints (rScale, errors, points, tangents);
+
   for (int p = 0; p < nInt; p++)
   {
-    Eigen::Vector2d &pcp = m_data->interior[p];
-
-    // inverse mapping
-    double param;
-    Eigen::Vector2d pt, t, n;
-    double error;
-    if (p < int (m_data->interior_param.size ()))
-    {
-      param = findClosestElementMidPoint (m_nurbs, pcp, m_data->interior_param[p]);
-      param = inverseMapping (m_nurbs, pcp, param, error, pt, t, rScale, in_max_steps, in_accuracy, m_quiet);
-      m_data->interior_param[p] = param;
-    }
-    else
-    {
-      param = findClosestElementMidPoint (m_nurbs, pcp);
-      param = inverseMapping (m_nurbs, pcp, param, error, pt, t, rScale, in_max_steps, in_accuracy, m_quiet);
-      m_data->interior_param.push_back (param);
-    }
+    double param = m_data->interior_param[p];
+    Eigen::Vector2d pt (points[p]), t (tangents[p]), n;
+    double error = errors[p];
 
     m_data->interior_error.push_back (error);
 
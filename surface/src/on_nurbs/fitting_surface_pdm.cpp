@@ -38,8 +38,13 @@
 #include <pcl/surface/on_nurbs/fitting_surface_pdm.h>
 #include <pcl/pcl_macros.h>
 
+#include <algorithm>
 #include <stdexcept>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 using namespace pcl;
 using namespace on_nurbs;
 using namespace Eigen;
@@ -242,6 +247,62 @@ FittingSurface::setInvMapParams (unsigned in_max_steps, double in_accuracy)
   this->in_accuracy = in_accuracy;
 }
 
+void
+FittingSurface::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    m_threads = omp_get_num_procs ();
+#else
+    m_threads = 1;
+#endif
+  else
+    m_threads = nr_threads;
+}
+
+void
+FittingSurface::inverseMappingInteriorPoints (std::vector<double> &error, vector_vec3d &pt, vector_vec3d &tu,
+                                              vector_vec3d &tv)
+{
+  const int nInt = static_cast<int> (m_data->interior.size ());
+  // points with a parameter from the previous iteration start from there
+  const int nHint = std::min (nInt, static_cast<int> (m_data->interior_param.size ()));
+  m_data->interior_param.resize (nInt);
+  error.resize (nInt);
+  pt.resize (nInt);
+  tu.resize (nInt);
+  tv.resize (nInt);
+
+#pragma omp parallel for default(none) shared(error, pt, tu, tv) firstprivate(nInt, nHint) schedule(dynamic, 64) num_threads(m_threads)
+  for (int p = 0; p < nInt; p++)
+  {
+    const Vector3d &pcp = m_data->interior[p];
+    const Vector2d hint = p < nHint ? m_data->interior_param[p] : findClosestElementMidPoint (m_nurbs, pcp);
+    m_data->interior_param[p] = inverseMapping (m_nurbs, pcp, hint, error[p], pt[p], tu[p], tv[p], in_max_steps,
+                                                in_accuracy);
+  }
+}
+
+void
+FittingSurface::inverseMappingBoundaryPoints (std::vector<double> &error, vector_vec3d &pt, vector_vec3d &tu,
+                                              vector_vec3d &tv)
+{
+  const int nBnd = static_cast<int> (m_data->boundary.size ());
+  if (static_cast<int> (m_data->boundary_param.size ()) < nBnd)
+    m_data->boundary_param.resize (nBnd);
+  error.resize (nBnd);
+  pt.resize (nBnd);
+  tu.resize (nBnd);
+  tv.resize (nBnd);
+
+#pragma omp parallel for default(none) shared(error, pt, tu, tv) firstprivate(nBnd) schedule(dynamic, 64) num_threads(m_threads)
+  for (int p = 0; p < nBnd; p++)
+  {
+    m_data->boundary_param[p] = inverseMappingBoundary (m_nurbs, m_data->boundary[p], error[p], pt[p], tu[p], tv[p],
+                                                        in_max_steps, in_accuracy);
+  }
+}
+
 std::vector<double>
 FittingSurface::getElementVector (const ON_NurbsSurface &nurbs, int dim) // !
 {
@@ -279,25 +340,18 @@ FittingSurface::assembleInterior (double wInt, unsigned &row)
   m_data->interior_error.clear ();
   m_data->interior_normals.clear ();
   unsigned nInt = static_cast<unsigned> (m_data->interior.size ());
+
+  // inverse mapping of all points (in parallel)
+  std::vector<double> errors;
+  vector_vec3d points, tangentsU, tangentsV;
+  inverseMappingInteriorPoints (errors, points, tangentsU, tangentsV);
+
   for (unsigned p = 0; p < nInt; p++)
   {
     Vector3d &pcp = m_data->interior[p];
 
-    // inverse mapping
-    Vector2d params;
-    Vector3d pt, tu, tv, n;
-    double error;
-    if (p < m_data->interior_param.size ())
-    {
-      params = inverseMapping (m_nurbs, pcp, m_data->interior_param[p], error, pt, tu, tv, in_max_steps, in_accuracy);
-      m_data->interior_param[p] = params;
-    }
-    else
-    {
-      params = findClosestElementMidPoint (m_nurbs, pcp);
-      params = inverseMapping (m_nurbs, pcp, params, error, pt, tu, tv, in_max_steps, in_accuracy);
-      m_data->interior_param.push_back (params);
-    }
+    Vector3d pt (points[p]), tu (tangentsU[p]), tv (tangentsV[p]), n;
+    double error = errors[p];
     m_data->interior_error.push_back (error);
 
     n = tu.cross (tv);
@@ -323,24 +377,20 @@ FittingSurface::assembleBoundary (double wBnd, unsigned &row)
   m_data->boundary_error.clear ();
   m_data->boundary_normals.clear ();
   unsigned nBnd = static_cast<unsigned> (m_data->boundary.size ());
+
+  // inverse mapping of all points (in parallel)
+  std::vector<double> errors;
+  vector_vec3d points, tangentsU, tangentsV;
+  inverseMappingBoundaryPoints (errors, points, tangentsU, tangentsV);
+
   for (unsigned p = 0; p < nBnd; p++)
   {
     Vector3d &pcp = m_data->boundary[p];
 
-    double error;
-    Vector3d pt, tu, tv, n;
-    Vector2d params = inverseMappingBoundary (m_nurbs, pcp, error, pt, tu, tv, in_max_steps, in_accuracy);
+    Vector3d pt (points[p]), tu (tangentsU[p]), tv (tangentsV[p]), n;
+    double error = errors[p];
     m_data->boundary_error.push_back (error);
 
-    if (p < m_data->boundary_param.size ())
-    {
-      m_data->boundary_param[p] = params;
-    }
-    else
-    {
-      m_data->boundary_param.push_back (params);
-    }
-
     n = tu.cross (tv);
     n.normalize ();
 
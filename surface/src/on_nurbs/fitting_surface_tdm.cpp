@@ -145,25 +145,18 @@ FittingSurfaceTDM::assembleInterior (double wInt, double wTangent, unsigned &row
   m_data->interior_error.clear ();
   m_data->interior_normals.clear ();
   unsigned nInt = static_cast<unsigned> (m_data->interior.size ());
+
+  // inverse mapping of all points (in parallel)
+  std::vector<double> errors;
+  vector_vec3d points, tangentsU, tangentsV;
+  inverseMappingInteriorPoints (errors, points, tangentsU, tangentsV);
+
   for (unsigned p = 0; p < nInt; p++)
   {
     Vector3d &pcp = m_data->interior[p];
 
-    // inverse mapping
-    Vector2d params;
-    Vector3d pt, tu, tv, n;
-    double error;
-    if (p < m_data->interior_param.size ())
-    {
-      params = inverseMapping (m_nurbs, pcp, m_data->interior_param[p], error, pt, tu, tv, in_max_steps, in_accuracy);
-      m_data->interior_param[p] = params;
-    }
-    else
-    {
-      params = FittingSurface::findClosestElementMidPoint (m_nurbs, pcp);
-      params = inverseMapping (m_nurbs, pcp, params, error, pt, tu, tv, in_max_steps, in_accuracy);
-      m_data->interior_param.push_back (params);
-    }
+    Vector3d pt (points[p]), tu (tangentsU[p]), tv (tangentsV[p]), n;
+    double error = errors[p];
     m_data->interior_error.push_back (error);
 
     tu.normalize ();
@@ -190,24 +183,20 @@ FittingSurfaceTDM::assembleBoundary (double wBnd, double wTangent, unsigned &row
   m_data->boundary_error.clear ();
   m_data->boundary_normals.clear ();
   unsigned nBnd = static_cast<unsigned> (m_data->boundary.size ());
+
+  // inverse mapping of all points (in parallel)
+  std::vector<double> errors;
+  vector_vec3d points, tangentsU, tangentsV;
+  inverseMappingBoundaryPoints (errors, points, tangentsU, tangentsV);
+
   for (unsigned p = 0; p < nBnd; p++)
   {
     Vector3d &pcp = m_data->boundary[p];
 
-    double error;
-    Vector3d pt, tu, tv, n;
-    Vector2d params = inverseMappingBoundary (m_nurbs, pcp, error, pt, tu, tv, in_max_steps, in_accuracy);
+    Vector3d pt (points[p]), tu (tangentsU[p]), tv (tangentsV[p]), n;
+    double error = errors[p];
     m_data->boundary_error.push_back (error);
 
-    if (p < m_data->boundary_param.size ())
-    {
-      m_data->boundary_param[p] = params;
-    }
-    else
-    {
-      m_data->boundary_param.push_back (params);
-    }
-
     tu.normalize ();
     tv.normalize ();
     n = tu.cross (tv);
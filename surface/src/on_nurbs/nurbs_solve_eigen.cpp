@@ -40,13 +40,19 @@
 
 #include <pcl/surface/on_nurbs/nurbs_solve.h>
 
+#include <Eigen/Sparse>
+
 using namespace pcl;
 using namespace on_nurbs;
 
 void
 NurbsSolve::assign (unsigned rows, unsigned cols, unsigned dims)
 {
-  m_Keig = Eigen::MatrixXd::Zero (rows, cols);
+  m_Ksparse.clear ();
+  if (m_sparse)
+    m_Keig.resize (0, 0);
+  else
+    m_Keig = Eigen::MatrixXd::Zero (rows, cols);
   m_xeig = Eigen::MatrixXd::Zero (cols, dims);
   m_feig = Eigen::MatrixXd::Zero (rows, dims);
 }
@@ -54,7 +60,10 @@ NurbsSolve::assign (unsigned rows, unsigned cols, unsigned dims)
 void
 NurbsSolve::K (unsigned i, unsigned j, double v)
 {
-  m_Keig (i, j) = v;
+  if (m_sparse)
+    m_Ksparse.set (i, j, v);
+  else
+    m_Keig (i, j) = v;
 }
 void
 NurbsSolve::x (unsigned i, unsigned j, double v)
@@ -70,6 +79,8 @@ NurbsSolve::f (unsigned i, unsigned j, double v)
 double
 NurbsSolve::K (unsigned i, unsigned j)
 {
+  if (m_sparse)
+    return m_Ksparse.get (i, j);
   return m_Keig (i, j);
 }
 double
@@ -87,12 +98,19 @@ void
 NurbsSolve::resize (unsigned rows)
 {
   m_feig.conservativeResize (rows, m_feig.cols ());
-  m_Keig.conservativeResize (rows, m_Keig.cols ());
+  if (!m_sparse)
+    m_Keig.conservativeResize (rows, m_Keig.cols ());
 }
 
 void
 NurbsSolve::printK ()
 {
+  if (m_sparse)
+  {
+    m_Ksparse.printLong ();
+    return;
+  }
+
   for (Eigen::Index r = 0; r < m_Keig.rows (); r++)
   {
     for (Eigen::Index c = 0; c < m_Keig.cols (); c++)
@@ -129,9 +147,59 @@ NurbsSolve::printF ()
   }
 }
 
+namespace
+{
+  /** \brief Copy the entries of K inside the (rows x cols) system into an Eigen sparse matrix. */
+  Eigen::SparseMatrix<double>
+  toEigenSparse (SparseMat &Ksparse, Eigen::Index rows, Eigen::Index cols)
+  {
+    std::vector<int> rowinds;
+    std::vector<int> colinds;
+    std::vector<double> values;
+    Ksparse.get (rowinds, colinds, values);
+
+    std::vector<Eigen::Triplet<double> > triplets;
+    triplets.reserve (values.size ());
+    for (std::size_t i = 0; i < values.size (); i++)
+      if (rowinds[i] < rows && colinds[i] < cols)
+        triplets.emplace_back (rowinds[i], colinds[i], values[i]);
+
+    Eigen::SparseMatrix<double> K (rows, cols);
+    K.setFromTriplets (triplets.begin (), triplets.end ());
+    return (K);
+  }
+}
+
 bool
 NurbsSolve::solve ()
 {
+  if (m_sparse)
+  {
+    // least squares via the normal equations, K^T K is symmetric positive (semi-)definite
+    const Eigen::SparseMatrix<double> K = toEigenSparse (m_Ksparse, m_feig.rows (), m_xeig.rows ());
+    const Eigen::SparseMatrix<double> Kt = K.transpose ();
+    const Eigen::SparseMatrix<double> KtK = Kt * K;
+
+    Eigen::SimplicialLDLT<Eigen::SparseMatrix<double> > ldlt (KtK);
+    if (ldlt.info () != Eigen::Success)
+    {
+      if (!m_quiet)
+        printf ("[NurbsSolve::solve] Warning: sparse factorization of K^T K failed.\n");
+      return false;
+    }
+
+    const Eigen::MatrixXd x = ldlt.solve (Kt * m_feig);
+    if (ldlt.info () != Eigen::Success)
+    {
+      if (!m_quiet)
+        printf ("[NurbsSolve::solve] Warning: sparse solve failed.\n");
+      return false;
+    }
+    m_xeig = x;
+
+    return true;
+  }
+
   //  m_xeig = m_Keig.colPivHouseholderQr().solve(m_feig);
   //  Eigen::MatrixXd x = A.householderQr().solve(b);
   m_xeig = m_Keig.jacobiSvd (Eigen::ComputeThinU | Eigen::ComputeThinV).solve (m_feig);
@@ -142,7 +210,13 @@ NurbsSolve::solve ()
 Eigen::MatrixXd
 NurbsSolve::diff ()
 {
+  if (m_sparse)
+  {
+    const Eigen::SparseMatrix<double> K = toEigenSparse (m_Ksparse, m_feig.rows (), m_xeig.rows ());
+    Eigen::MatrixXd f (K * m_xeig);
+    return (f - m_feig);
+  }
+
   Eigen::MatrixXd f (m_Keig * m_xeig);
   return (f - m_feig);
 }
-
@@ -111,8 +111,7 @@ SparseMat::set (int i, int j, double v)
 
     it_row->second.erase (it_col);
     if (it_row->second.empty ())
-    {}
-    m_mat.erase (it_row);
+      m_mat.erase (it_row);
 
   }
   else
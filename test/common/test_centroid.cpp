@@ -1094,6 +1094,74 @@ TEST (PCL, demeanPointCloud)
   EXPECT_NEAR (mat_demean (2, cloud_demean.size () - 1), -0.071702, 1e-4);
 }
 
+TEST (PCL, computeMeanAndCovarianceThreads)
+{
+  // A large cloud far from the origin, with some invalid points
+  PointCloud<PointXYZ> cloud;
+  const Eigen::Vector3f offset (1000.f, -2000.f, 500.f);
+  for (std::size_t i = 0; i < 20000; ++i)
+  {
+    Eigen::Vector3f p = offset + Eigen::Vector3f::Random ().cwiseProduct (Eigen::Vector3f (1.f, 2.f, 0.5f));
+    cloud.push_back (PointXYZ (p[0], p[1], p[2]));
+  }
+  for (std::size_t i = 0; i < cloud.size (); i += 97)
+    cloud[i].y = std::numeric_limits<float>::quiet_NaN ();
+  cloud.is_dense = false;
+  Indices indices;
+  for (index_t i = 0; i < static_cast<index_t> (cloud.size ()); i += 3)
+    indices.push_back (i);
+
+  // Two passes in double precision as the reference (the single pass version squares the coordinates in float)
+  Eigen::Matrix3d covariance_exp;
+  Eigen::Vector4d centroid_exp;
+  const unsigned int count_exp = compute3DCentroid (cloud, centroid_exp);
+  EXPECT_EQ (count_exp, computeCovarianceMatrixNormalized (cloud, centroid_exp, covariance_exp));
+
+  // The result does not depend on the number of threads
+  Eigen::Matrix3d covariance, covariance_threads;
+  Eigen::Vector4d centroid, centroid_threads;
+  EXPECT_EQ (count_exp, computeMeanAndCovarianceMatrix (cloud, covariance, centroid, 1));
+  EXPECT_EQ (count_exp, computeMeanAndCovarianceMatrix (cloud, covariance_threads, centroid_threads, 4));
+  EXPECT_EQ (covariance, covariance_threads);
+  EXPECT_EQ (centroid, centroid_threads);
+  EXPECT_TRUE (covariance.isApprox (covariance_exp, 1e-6));
+  EXPECT_TRUE (centroid.isApprox (centroid_exp, 1e-9));
+
+  // In single precision, the points summed relative to the first point keep the precision
+  Eigen::Matrix3f covariance_f;
+  Eigen::Vector4f centroid_f;
+  EXPECT_EQ (count_exp, computeMeanAndCovarianceMatrix (cloud, covariance_f, centroid_f, 4, true));
+  EXPECT_TRUE (covariance_f.cast<double> ().isApprox (covariance_exp, 1e-3));
+  EXPECT_TRUE (centroid_f.cast<double> ().isApprox (centroid_exp, 1e-6));
+
+  Eigen::Vector4d centroid_only;
+  EXPECT_EQ (count_exp, compute3DCentroid (cloud, centroid_only, 4));
+  EXPECT_TRUE (centroid_only.isApprox (centroid_exp, 1e-9));
+  EXPECT_EQ (count_exp, computeCovarianceMatrix (cloud, centroid_exp, covariance, 4, true));
+  EXPECT_TRUE ((covariance / count_exp).isApprox (covariance_exp, 1e-9));
+
+  // Indices
+  const unsigned int indices_count_exp = compute3DCentroid (cloud, indices, centroid_exp);
+  computeCovarianceMatrixNormalized (cloud, indices, centroid_exp, covariance_exp);
+  EXPECT_EQ (indices_count_exp, computeMeanAndCovarianceMatrix (cloud, indices, covariance, centroid, 3));
+  EXPECT_TRUE (covariance.isApprox (covariance_exp, 1e-6));
+  EXPECT_TRUE (centroid.isApprox (centroid_exp, 1e-9));
+  EXPECT_EQ (compute3DCentroid (cloud, indices, centroid_exp),
+             compute3DCentroid (cloud, indices, centroid_only, 3));
+  EXPECT_TRUE (centroid_only.isApprox (centroid_exp, 1e-9));
+  Eigen::Matrix3d covariance_indices_exp;
+  EXPECT_EQ (computeCovarianceMatrix (cloud, indices, centroid_exp, covariance_indices_exp),
+             computeCovarianceMatrix (cloud, indices, centroid_exp, covariance, 3));
+  EXPECT_TRUE (covariance.isApprox (covariance_indices_exp, 1e-6));
+
+  // No valid point
+  PointCloud<PointXYZ> invalid;
+  invalid.push_back (PointXYZ (std::numeric_limits<float>::quiet_NaN (), 0.f, 0.f));
+  invalid.is_dense = false;
+  EXPECT_EQ (0, compute3DCentroid (invalid, centroid, 2));
+  EXPECT_EQ (0, computeMeanAndCovarianceMatrix (invalid, covariance, centroid, 2));
+}
+
 int
 main (int argc, char** argv)
 {
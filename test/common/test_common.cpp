@@ -43,10 +43,13 @@
 #include <pcl/common/distances.h>
 #include <pcl/common/intersections.h>
 #include <pcl/common/io.h>
+#include <pcl/common/morton.h>
 #include <pcl/common/eigen.h>
 #include <pcl/point_types.h>
 #include <pcl/point_cloud.h>
 #include <pcl/common/point_tests.h> // for isFinite
+#include <pcl/common/utils.h>
+#include <pcl/tracking_allocator.h>
 
 using namespace pcl;
 
@@ -558,6 +561,255 @@ TEST (PCL, GetMaxDistance)
   test::EXPECT_EQ_VECTORS (max_exp_pt, max_pt);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, GetMinMax3DThreads)
+{
+  PointCloud<PointXYZ> cloud;
+  for (std::size_t i = 0; i < 10000; ++i)
+  {
+    const Eigen::Vector3f p = Eigen::Vector3f::Random () * 10.f;
+    cloud.push_back (PointXYZ (p[0], p[1], p[2]));
+  }
+  cloud[42].x = std::numeric_limits<float>::infinity ();
+  cloud.is_dense = false;
+  Indices indices;
+  for (index_t i = 0; i < static_cast<index_t> (cloud.size ()); i += 7)
+    indices.push_back (i);
+
+  Eigen::Vector4f min_pt, max_pt, min_exp_pt, max_exp_pt;
+  getMinMax3D (cloud, min_exp_pt, max_exp_pt);
+  getMinMax3D (cloud, min_pt, max_pt, 4);
+  test::EXPECT_EQ_VECTORS (min_exp_pt, min_pt);
+  test::EXPECT_EQ_VECTORS (max_exp_pt, max_pt);
+
+  getMinMax3D (cloud, indices, min_exp_pt, max_exp_pt);
+  getMinMax3D (cloud, indices, min_pt, max_pt, 4);
+  test::EXPECT_EQ_VECTORS (min_exp_pt, min_pt);
+  test::EXPECT_EQ_VECTORS (max_exp_pt, max_pt);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, MortonOrder)
+{
+  EXPECT_EQ (0u, encodeMorton (0, 0, 0));
+  EXPECT_EQ (4u, encodeMorton (1, 0, 0));
+  EXPECT_EQ (2u, encodeMorton (0, 1, 0));
+  EXPECT_EQ (1u, encodeMorton (0, 0, 1));
+  EXPECT_EQ (7u << 3, encodeMorton (2, 2, 2));
+
+  // The corners of a cube in Z-order, the invalid point last
+  PointCloud<PointXYZ> cloud;
+  cloud.push_back (PointXYZ (1.f, 1.f, 1.f));
+  cloud.push_back (PointXYZ (std::numeric_limits<float>::quiet_NaN (), 0.f, 0.f));
+  cloud.push_back (PointXYZ (0.f, 0.f, 1.f));
+  cloud.push_back (PointXYZ (1.f, 0.f, 0.f));
+  cloud.push_back (PointXYZ (0.f, 0.f, 0.f));
+  cloud.is_dense = false;
+
+  Indices order;
+  getMortonOrder (cloud, order);
+  EXPECT_EQ (Indices ({4, 2, 3, 0, 1}), order);
+
+  // With indices, the order is made of positions in the indices
+  getMortonOrder (cloud, Indices ({0, 3, 4}), order, 2);
+  EXPECT_EQ (Indices ({2, 1, 0}), order);
+
+  // The reordered cloud maps back to the input through the permutation, with any number of threads
+  for (std::size_t i = 0; i < 10000; ++i)
+  {
+    const Eigen::Vector3f p = Eigen::Vector3f::Random () * 10.f;
+    cloud.push_back (PointXYZ (p[0], p[1], p[2]));
+  }
+  PointCloud<PointXYZ> reordered;
+  Indices permutation, serial_permutation;
+  reorderPointCloudMorton (cloud, reordered, permutation, 4);
+  getMortonOrder (cloud, serial_permutation, 1);
+  EXPECT_EQ (serial_permutation, permutation);
+  ASSERT_EQ (cloud.size (), reordered.size ());
+  EXPECT_FALSE (reordered.is_dense);
+  for (std::size_t i = 0; i + 1 < reordered.size (); ++i)
+    EXPECT_EQ (cloud[permutation[i]].getVector3fMap (), reordered[i].getVector3fMap ());
+  EXPECT_EQ (1, permutation.back ());
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, PointCloudSoA)
+{
+  PointCloud<PointXYZ> cloud;
+  cloud.push_back (PointXYZ (1.f, -2.f, 3.f));
+  cloud.push_back (PointXYZ (std::numeric_limits<float>::quiet_NaN (), 0.f, 0.f));
+  cloud.push_back (PointXYZ (-4.f, 5.f, 0.5f));
+  cloud.is_dense = false;
+
+  // All points, the indices stay implicit
+  PointCloudSoA soa (cloud);
+  ASSERT_EQ (3, soa.size ());
+  EXPECT_EQ (2, soa.getIndex (2));
+  EXPECT_EQ (5.f, soa.y ()[2]);
+
+  // Without the invalid point
+  soa.assign (cloud, true);
+  ASSERT_EQ (2, soa.size ());
+  EXPECT_EQ (0, soa.getIndex (0));
+  EXPECT_EQ (2, soa.getIndex (1));
+  test::EXPECT_EQ_VECTORS (cloud[2].getVector3fMap (), soa.getPoint (1));
+
+  Eigen::Vector4f min_pt, max_pt, min_exp_pt, max_exp_pt;
+  getMinMax3D (soa, min_pt, max_pt);
+  getMinMax3D (cloud, min_exp_pt, max_exp_pt);
+  test::EXPECT_EQ_VECTORS (min_exp_pt.head<3> (), min_pt.head<3> ());
+  test::EXPECT_EQ_VECTORS (max_exp_pt.head<3> (), max_pt.head<3> ());
+
+  // A subset
+  Indices indices (1, 2);
+  soa.assign (cloud, indices);
+  ASSERT_EQ (1, soa.size ());
+  EXPECT_EQ (2, soa.getIndex (0));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, MaxNumberOfThreads)
+{
+  EXPECT_EQ (0u, utils::getMaxNumberOfThreads ());
+#ifdef _OPENMP
+  EXPECT_EQ (8u, utils::getNumberOfThreads (8));
+
+  utils::setMaxNumberOfThreads (2);
+  EXPECT_EQ (2u, utils::getNumberOfThreads (8));
+  EXPECT_EQ (1u, utils::getNumberOfThreads (1));
+  {
+    // The scoped limit of this thread overrides the one of the process
+    utils::ScopedMaxNumberOfThreads limit (4);
+    EXPECT_EQ (4u, utils::getNumberOfThreads (8));
+    {
+      utils::ScopedMaxNumberOfThreads no_limit (0);
+      EXPECT_EQ (8u, utils::getNumberOfThreads (8));
+    }
+    EXPECT_EQ (4u, utils::getNumberOfThreads (8));
+  }
+  EXPECT_EQ (2u, utils::getNumberOfThreads (8));
+  utils::setMaxNumberOfThreads (0);
+
+  // A loop nested in a parallel region runs serially
+  unsigned int nested_nr_threads = 0;
+#pragma omp parallel num_threads(2) default(none) shared(nested_nr_threads)
+  {
+#pragma omp single
+    nested_nr_threads = utils::getNumberOfThreads (8);
+  }
+  EXPECT_EQ (1u, nested_nr_threads);
+#else
+  EXPECT_EQ (1u, utils::getNumberOfThreads (8));
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, MemoryUsage)
+{
+  PointCloud<PointXYZ> cloud;
+  const std::size_t empty_memory = cloud.getMemoryUsage ();
+  EXPECT_EQ (sizeof (cloud), empty_memory);
+  cloud.resize (100);
+  EXPECT_EQ (empty_memory + cloud.points.capacity () * sizeof (PointXYZ), cloud.getMemoryUsage ());
+
+  PCLPointCloud2 blob;
+  blob.data.resize (1000);
+  EXPECT_GE (blob.getMemoryUsage (), sizeof (blob) + 1000);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, TrackingAllocator)
+{
+  const std::size_t base = getTrackedMemoryUsage ();
+  resetPeakTrackedMemoryUsage ();
+  {
+    std::vector<PointXYZ, TrackingAllocator<PointXYZ>> points (100);
+    EXPECT_EQ (base + 100 * sizeof (PointXYZ), getTrackedMemoryUsage ());
+    EXPECT_EQ (0u, reinterpret_cast<std::uintptr_t> (points.data ()) % 16);
+    points.resize (1000);
+    EXPECT_EQ (base + points.capacity () * sizeof (PointXYZ), getTrackedMemoryUsage ());
+    // old and new buffer coexisted during the reallocation
+    EXPECT_EQ (base + 1100 * sizeof (PointXYZ), getPeakTrackedMemoryUsage ());
+  }
+  EXPECT_EQ (base, getTrackedMemoryUsage ());
+  resetPeakTrackedMemoryUsage ();
+  EXPECT_EQ (base, getPeakTrackedMemoryUsage ());
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/** \brief Minimal stateful allocator drawing from a fixed buffer, like a per-frame arena. */
+template <typename T>
+struct ArenaAllocator
+{
+  using value_type = T;
+
+  struct Arena
+  {
+    alignas (16) unsigned char buffer[1 << 16];
+    std::size_t used = 0;
+  };
+
+  explicit ArenaAllocator (Arena& arena) : arena_ (&arena) {}
+  template <typename U> ArenaAllocator (const ArenaAllocator<U>& other) : arena_ (other.arena_) {}
+
+  T*
+  allocate (std::size_t n)
+  {
+    const std::size_t bytes = (n * sizeof (T) + 15) & ~std::size_t (15);
+    if (arena_->used + bytes > sizeof (arena_->buffer))
+      throw std::bad_alloc ();
+    T* p = reinterpret_cast<T*> (arena_->buffer + arena_->used);
+    arena_->used += bytes;
+    return (p);
+  }
+
+  void
+  deallocate (T*, std::size_t) {}
+
+  Arena* arena_;
+};
+
+template <typename T, typename U> bool
+operator== (const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) { return (a.arena_ == b.arena_); }
+template <typename T, typename U> bool
+operator!= (const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) { return (a.arena_ != b.arena_); }
+
+TEST (PCL, PointCloudCustomAllocator)
+{
+  using TrackedCloud = PointCloud<PointXYZ, TrackingAllocator<PointXYZ>>;
+  const std::size_t base = getTrackedMemoryUsage ();
+  {
+    TrackedCloud cloud (10, 2, PointXYZ (1.f, 2.f, 3.f));
+    EXPECT_EQ (base + 20 * sizeof (PointXYZ), getTrackedMemoryUsage ());
+    EXPECT_TRUE (cloud.isOrganized ());
+
+    TrackedCloud::Ptr copy = cloud.makeShared ();
+    TrackedCloud subset (cloud, Indices {0, 5});
+    EXPECT_EQ (base + 42 * sizeof (PointXYZ), getTrackedMemoryUsage ());
+    EXPECT_EQ (2, subset.size ());
+    EXPECT_EQ (cloud[5].getVector3fMap (), subset[1].getVector3fMap ());
+
+    *copy += subset;
+    EXPECT_EQ (22, copy->size ());
+  }
+  EXPECT_EQ (base, getTrackedMemoryUsage ());
+
+  using ArenaCloud = PointCloud<PointXYZ, ArenaAllocator<PointXYZ>>;
+  ArenaAllocator<PointXYZ>::Arena arena;
+  ArenaCloud cloud ((ArenaAllocator<PointXYZ> (arena)));
+  cloud.resize (100);
+  EXPECT_EQ (100, cloud.width);
+  EXPECT_EQ (reinterpret_cast<unsigned char*> (cloud.data ()), arena.buffer);
+  EXPECT_GE (arena.used, 100 * sizeof (PointXYZ));
+  EXPECT_TRUE (cloud.get_allocator () == ArenaAllocator<PointXYZ> (arena));
+
+  ArenaCloud other ((ArenaAllocator<PointXYZ> (arena)));
+  other.push_back (PointXYZ (1.f, 2.f, 3.f));
+  cloud.swap (other);
+  EXPECT_EQ (1, cloud.size ());
+  EXPECT_EQ (100, other.size ());
+}
+
 /* ---[ */
 int
 main (int argc, char** argv)
@@ -0,0 +1,181 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved
+ */
+
+#include <pcl/test/gtest.h>
+
+#include <pcl/compact_point_cloud.h>
+#include <pcl/point_types.h>
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+
+using namespace pcl;
+
+static PointCloud<PointXYZRGBNormal>
+randomCloud (std::size_t nr_points, float extent)
+{
+  std::mt19937 generator (42);
+  std::uniform_real_distribution<float> coordinate (-extent, extent);
+  std::uniform_real_distribution<float> component (-1.f, 1.f);
+  PointCloud<PointXYZRGBNormal> cloud;
+  for (std::size_t i = 0; i < nr_points; ++i)
+  {
+    PointXYZRGBNormal point;
+    point.x = coordinate (generator) + 100.f;
+    point.y = coordinate (generator);
+    point.z = 0.5f * coordinate (generator);
+    point.getNormalVector3fMap () = Eigen::Vector3f (component (generator), component (generator), 1.f).normalized ();
+    point.rgba = static_cast<std::uint32_t> (generator ());
+    cloud.push_back (point);
+  }
+  return (cloud);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, HalfFloat)
+{
+  // Exact values, including subnormals and the largest half
+  for (const float value : {0.f, -0.f, 1.f, -2.5f, 0.333251953125f, 65504.f, 6.103515625e-05f, 5.9604644775390625e-08f})
+    EXPECT_EQ (value, halfToFloat (floatToHalf (value)));
+  EXPECT_EQ (0x3c00, floatToHalf (1.f));
+  EXPECT_EQ (0x0001, floatToHalf (5.9604644775390625e-08f));
+
+  // Rounding to the nearest even value, overflow and underflow
+  EXPECT_EQ (0x3c00, floatToHalf (1.f + 1.f / 2048.f));
+  EXPECT_EQ (0x3c02, floatToHalf (1.f + 3.f / 2048.f));
+  EXPECT_EQ (0x7c00, floatToHalf (65520.f));
+  EXPECT_EQ (0x7bff, floatToHalf (65519.f));
+  EXPECT_EQ (0x0000, floatToHalf (2.9802322387695312e-08f));
+  EXPECT_TRUE (std::isinf (halfToFloat (floatToHalf (std::numeric_limits<float>::infinity ()))));
+  EXPECT_TRUE (std::isnan (halfToFloat (floatToHalf (std::numeric_limits<float>::quiet_NaN ()))));
+
+  // Relative error of at most 2^-11 over the normal range
+  std::mt19937 generator (1);
+  std::uniform_real_distribution<float> exponent (-14.f, 15.f);
+  for (int i = 0; i < 10000; ++i)
+  {
+    const float value = std::pow (2.f, exponent (generator));
+    EXPECT_LE (std::abs (halfToFloat (floatToHalf (value)) - value), value / 2048.f);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, PackedPointCloud)
+{
+  PointCloud<PointXYZRGBNormal> cloud = randomCloud (1000, 10.f);
+  cloud[3].x = std::numeric_limits<float>::quiet_NaN ();
+
+  PackedPointCloud packed;
+  ASSERT_TRUE (packed.assign (cloud));
+  EXPECT_EQ (cloud.size (), packed.size ());
+  EXPECT_FALSE (packed.isDense ());
+  EXPECT_TRUE (packed.hasNormals ());
+  EXPECT_TRUE (packed.hasColors ());
+  EXPECT_EQ (22u, packed.getBytesPerPoint ());
+  EXPECT_FALSE (packed.isValid (3));
+
+  PointCloud<PointXYZRGBNormal> decoded;
+  packed.decode (decoded, 2);
+  ASSERT_EQ (cloud.size (), decoded.size ());
+  EXPECT_FALSE (decoded.is_dense);
+  for (std::size_t i = 0; i < cloud.size (); ++i)
+  {
+    if (i == 3)
+      continue;
+    EXPECT_EQ (cloud[i].getVector3fMap (), decoded[i].getVector3fMap ());
+    EXPECT_EQ (cloud[i].rgba, decoded[i].rgba);
+    EXPECT_LE ((cloud[i].getNormalVector3fMap () - decoded[i].getNormalVector3fMap ()).norm (), 1e-3f);
+  }
+  EXPECT_TRUE (std::isnan (decoded[3].x));
+
+  // Without normals and colors, or into a type without them
+  ASSERT_TRUE (packed.assign (cloud, 0.f, false, false));
+  EXPECT_EQ (12u, packed.getBytesPerPoint ());
+  PointCloud<PointXYZ> xyz;
+  packed.decode ({5, 7}, xyz);
+  ASSERT_EQ (2u, xyz.size ());
+  EXPECT_EQ (cloud[7].getVector3fMap (), xyz[1].getVector3fMap ());
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename CloudT> static void
+checkQuantization (const PointCloud<PointXYZRGBNormal> &cloud, const CloudT &compact)
+{
+  ASSERT_EQ (cloud.size (), compact.size ());
+  const float max_error = 0.5f * compact.getResolution () + 1e-5f * 110.f;
+  Eigen::Vector4f min_pt, max_pt;
+  ASSERT_TRUE (compact.getMinMax3D (min_pt, max_pt));
+  for (std::size_t i = 0; i < cloud.size (); ++i)
+  {
+    if (!std::isfinite (cloud[i].x) || !std::isfinite (cloud[i].y) || !std::isfinite (cloud[i].z))
+    {
+      EXPECT_FALSE (compact.isValid (i));
+      continue;
+    }
+    const auto point = compact.template getPoint<PointXYZRGBNormal> (i);
+    EXPECT_LE ((cloud[i].getVector3fMap () - point.getVector3fMap ()).cwiseAbs ().maxCoeff (), max_error);
+    if (compact.hasColors ())
+    {
+      EXPECT_EQ (cloud[i].rgba, point.rgba);
+    }
+    EXPECT_TRUE ((point.getArray4fMap () >= min_pt.array ()).template head<3> ().all ());
+    EXPECT_TRUE ((point.getArray4fMap () <= max_pt.array ()).template head<3> ().all ());
+  }
+}
+
+TEST (PCL, QuantizedPointCloud)
+{
+  PointCloud<PointXYZRGBNormal> cloud = randomCloud (1000, 10.f);
+  cloud[10].z = std::numeric_limits<float>::infinity ();
+
+  // The finest resolution fitting the extent of the cloud
+  QuantizedPointCloud16 cloud16;
+  ASSERT_TRUE (cloud16.assign (cloud));
+  EXPECT_EQ (16u, cloud16.getBytesPerPoint ());
+  EXPECT_LT (cloud16.getResolution (), 20.f / 65000.f);
+  EXPECT_FALSE (cloud16.isDense ());
+  checkQuantization (cloud, cloud16);
+
+  QuantizedPointCloud32 cloud32;
+  ASSERT_TRUE (cloud32.assign (cloud));
+  checkQuantization (cloud, cloud32);
+
+  // A given resolution
+  ASSERT_TRUE (cloud16.assign (cloud, 0.001f, false, false));
+  EXPECT_EQ (6u, cloud16.getBytesPerPoint ());
+  EXPECT_EQ (0.001f, cloud16.getResolution ());
+  checkQuantization (cloud, cloud16);
+
+  // A resolution too fine for 16 bits
+  EXPECT_FALSE (cloud16.assign (cloud, 0.0001f));
+  EXPECT_TRUE (cloud16.empty ());
+  ASSERT_TRUE (cloud32.assign (cloud, 0.0001f));
+  checkQuantization (cloud, cloud32);
+
+  // A single point, and an empty cloud
+  PointCloud<PointXYZ> single;
+  single.push_back (PointXYZ (1.f, 2.f, 3.f));
+  ASSERT_TRUE (cloud16.assign (single));
+  EXPECT_EQ (Eigen::Vector3f (1.f, 2.f, 3.f), cloud16.getXYZ (0));
+  ASSERT_TRUE (cloud16.assign (PointCloud<PointXYZ> ()));
+  EXPECT_TRUE (cloud16.empty ());
+  Eigen::Vector4f min_pt, max_pt;
+  EXPECT_FALSE (cloud16.getMinMax3D (min_pt, max_pt));
+}
+
+/* ---[ */
+int
+main (int argc, char** argv)
+{
+  testing::InitGoogleTest (&argc, argv);
+  return (RUN_ALL_TESTS ());
+}
+/* ]--- */
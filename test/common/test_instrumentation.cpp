@@ -0,0 +1,146 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2024-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <pcl/test/gtest.h>
+#include <pcl/common/instrumentation.h>
+
+#include <sstream>
+#include <thread>
+#include <vector>
+
+using namespace pcl::instrumentation;
+
+///////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, InstrumentationDisabled)
+{
+  reset ();
+  setEnabled (false);
+  {
+    PCL_INSTRUMENT_SCOPE ("stage");
+    PCL_INSTRUMENT_COUNT ("counter", 1);
+  }
+  const Report report = getReport ();
+  EXPECT_TRUE (report.stages.empty ());
+  EXPECT_TRUE (report.counters.empty ());
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, InstrumentationThreads)
+{
+  reset ();
+  setEnabled (true);
+
+  const int nr_threads = 4, nr_runs = 100;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < nr_threads; ++t)
+    threads.emplace_back ([]
+    {
+      for (int i = 0; i < nr_runs; ++i)
+      {
+        PCL_INSTRUMENT_SCOPE ("outer");
+        {
+          PCL_INSTRUMENT_SCOPE ("inner \"quoted\"");
+          PCL_INSTRUMENT_COUNT ("queries", 3);
+        }
+      }
+    });
+  // The statistics of the threads are kept after they exit
+  for (auto &thread : threads)
+    thread.join ();
+  {
+    PCL_INSTRUMENT_SCOPE ("outer");
+  }
+  setEnabled (false);
+
+  const Report report = getReport ();
+  ASSERT_EQ (2, report.stages.size ());
+  EXPECT_EQ ("inner \"quoted\"", report.stages[0].name);
+  EXPECT_EQ (nr_threads * nr_runs, report.stages[0].calls);
+  EXPECT_EQ ("outer", report.stages[1].name);
+  EXPECT_EQ (nr_threads * nr_runs + 1, report.stages[1].calls);
+  EXPECT_LE (report.stages[1].min_time, report.stages[1].max_time);
+  EXPECT_LE (report.stages[1].max_time, report.stages[1].total_time);
+  ASSERT_EQ (1, report.counters.size ());
+  EXPECT_EQ ("queries", report.counters[0].name);
+  EXPECT_EQ (3 * nr_threads * nr_runs, report.counters[0].value);
+
+  std::ostringstream trace;
+  exportChromeTrace (trace);
+  EXPECT_EQ (0, trace.str ().find ("{\"traceEvents\":["));
+  EXPECT_NE (std::string::npos, trace.str ().find ("{\"name\":\"inner \\\"quoted\\\"\",\"cat\":\"pcl\",\"ph\":\"X\""));
+
+  std::ostringstream metrics;
+  exportPrometheus (metrics);
+  EXPECT_NE (std::string::npos, metrics.str ().find ("pcl_stage_calls_total{stage=\"outer\"} 401\n"));
+  EXPECT_NE (std::string::npos, metrics.str ().find ("pcl_counter_total{name=\"queries\"} 1200\n"));
+
+  reset ();
+  EXPECT_TRUE (getReport ().stages.empty ());
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, InstrumentationTraceCapacity)
+{
+  reset ();
+  setEnabled (true);
+  setTraceCapacity (2);
+  for (int i = 0; i < 5; ++i)
+  {
+    PCL_INSTRUMENT_SCOPE ("stage");
+  }
+  setEnabled (false);
+  setTraceCapacity (65536);
+
+  // The events over the capacity are dropped from the trace, not from the statistics
+  EXPECT_EQ (5, getReport ().stages[0].calls);
+  std::ostringstream trace;
+  exportChromeTrace (trace);
+  std::size_t nr_events = 0;
+  for (std::size_t pos = trace.str ().find ("\"ph\":\"X\""); pos != std::string::npos; pos = trace.str ().find ("\"ph\":\"X\"", pos + 1))
+    ++nr_events;
+  EXPECT_EQ (2, nr_events);
+  reset ();
+}
+
+/* ---[ */
+int
+main (int argc, char** argv)
+{
+  testing::InitGoogleTest (&argc, argv);
+  return (RUN_ALL_TESTS ());
+}
+/* ]--- */
@@ -39,6 +39,7 @@
 #include <pcl/pcl_tests.h>
 #include <pcl/point_types.h>
 #include <pcl/common/io.h>
+#include <pcl/point_cloud2_view.h>
 
 using namespace pcl;
 
@@ -470,6 +471,97 @@ TEST (PCL, CopyPointCloudWithSameTypes)
   ASSERT_EQ (0, cloud_out.size ());
 }
 
+///////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, CopyPointCloudWithIndicesMultithreaded)
+{
+  CloudXYZRGBA cloud_in;
+  for (int i = 0; i < 10000; ++i)
+  {
+    PointXYZRGBA point;
+    point.x = static_cast<float> (i);
+    point.rgba = static_cast<std::uint32_t> (i);
+    cloud_in.push_back (point);
+  }
+  std::vector<PointIndices> clusters (3);
+  for (int i = 0; i < 5000; ++i)
+    clusters[i % 7 == 0 ? 0 : 2].indices.push_back (9999 - 2 * i);
+  const Indices &indices = clusters[2].indices;
+
+  for (const unsigned int nr_threads : {1u, 4u})
+  {
+    CloudXYZRGBA cloud_out;
+    copyPointCloud (cloud_in, indices, cloud_out, nr_threads);
+    ASSERT_EQ (indices.size (), cloud_out.size ());
+    for (std::size_t i = 0; i < indices.size (); ++i)
+      EXPECT_EQ (cloud_in[indices[i]].rgba, cloud_out[i].rgba);
+
+    CloudXYZ cloud_xyz;
+    copyPointCloud (cloud_in, clusters, cloud_xyz, nr_threads);
+    ASSERT_EQ (clusters[0].indices.size () + indices.size (), cloud_xyz.size ());
+    EXPECT_XYZ_EQ (cloud_in[clusters[0].indices.back ()], cloud_xyz[clusters[0].indices.size () - 1]);
+    EXPECT_XYZ_EQ (cloud_in[indices.front ()], cloud_xyz[clusters[0].indices.size ()]);
+    EXPECT_XYZ_EQ (cloud_in[indices.back ()], cloud_xyz.back ());
+
+    PCLPointCloud2 blob_in, blob_out;
+    toPCLPointCloud2 (cloud_in, blob_in);
+    copyPointCloud (blob_in, indices, blob_out, nr_threads);
+    EXPECT_EQ (indices.size (), blob_out.width);
+    EXPECT_EQ (blob_in.point_step * blob_out.width, blob_out.row_step);
+    CloudXYZRGBA cloud_blob;
+    fromPCLPointCloud2 (blob_out, cloud_blob);
+    ASSERT_EQ (cloud_out.size (), cloud_blob.size ());
+    for (std::size_t i = 0; i < cloud_out.size (); ++i)
+      EXPECT_EQ (cloud_out[i].rgba, cloud_blob[i].rgba);
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, PCLPointCloud2View)
+{
+  CloudXYZRGBNormal cloud;
+  for (int i = 0; i < 10; ++i)
+  {
+    PointXYZRGBNormal point;
+    point.x = static_cast<float> (i);
+    point.y = static_cast<float> (2 * i);
+    point.z = static_cast<float> (3 * i);
+    point.r = static_cast<std::uint8_t> (i);
+    point.normal_z = 1.0f;
+    cloud.push_back (point);
+  }
+  PCLPointCloud2 msg;
+  toPCLPointCloud2 (cloud, msg);
+
+  // Same layout, the blob is accessed directly
+  PCLPointCloud2View<PointXYZRGBNormal> view (msg);
+  ASSERT_EQ (cloud.size (), view.size ());
+  EXPECT_TRUE (view.isDirect ());
+  ASSERT_NE (nullptr, view.data ());
+  EXPECT_EQ (reinterpret_cast<const void*> (&msg.data[0]), reinterpret_cast<const void*> (view.data ()));
+  EXPECT_EQ (cloud[4].normal_z, view[4].normal_z);
+
+  // Different layout, the points are decoded on access
+  PCLPointCloud2View<PointXYZ> xyz_view (msg);
+  EXPECT_FALSE (xyz_view.isDirect ());
+  EXPECT_EQ (nullptr, xyz_view.data ());
+  ASSERT_TRUE (xyz_view.hasXYZ ());
+  for (std::size_t i = 0; i < cloud.size (); ++i)
+  {
+    EXPECT_XYZ_EQ (cloud[i], xyz_view[i]);
+    test::EXPECT_EQ_VECTORS (cloud[i].getVector3fMap (), xyz_view.getXYZ (i));
+  }
+
+  const int rgb_offset = xyz_view.getFieldOffset ("rgb");
+  ASSERT_GE (rgb_offset, 0);
+  EXPECT_EQ (cloud[7].rgba, xyz_view.getFieldValue<std::uint32_t> (7, rgb_offset));
+  EXPECT_EQ (-1, xyz_view.getFieldOffset ("intensity"));
+
+  CloudXYZ cloud_xyz;
+  xyz_view.toPointCloud (cloud_xyz);
+  ASSERT_EQ (cloud.size (), cloud_xyz.size ());
+  EXPECT_XYZ_EQ (cloud[9], cloud_xyz[9]);
+}
+
 /* ---[ */
 int
 main (int argc, char** argv)
@@ -0,0 +1,129 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2014-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+
+#include <pcl/test/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <pcl/common/multi_synchronizer.h>
+
+using namespace std::chrono_literals;
+
+TEST (MultiSynchronizer, MatchesClosestFrames)
+{
+  pcl::MultiSynchronizer<int> sync (3, 5, 200ms);
+  std::mutex mutex;
+  std::vector<std::vector<unsigned long> > sets;
+  sync.addCallback ([&] (const std::vector<int>& data, const std::vector<unsigned long>& times)
+  {
+    std::lock_guard<std::mutex> lock (mutex);
+    ASSERT_EQ (3, data.size ());
+    for (std::size_t i = 0; i < data.size (); ++i)
+      EXPECT_EQ (static_cast<int> (times[i]), data[i]);
+    sets.push_back (times);
+  });
+
+  // Stream 2 starts late, so the first frames of streams 0 and 1 cannot be matched
+  sync.add (0, 0, 0);
+  sync.add (1, 2, 2);
+  sync.add (0, 33, 33);
+  sync.add (1, 31, 31);
+  sync.add (2, 30, 30);
+  sync.add (0, 66, 66);
+  sync.add (1, 64, 64);
+  sync.add (2, 63, 63);
+  std::this_thread::sleep_for (400ms);
+
+  std::lock_guard<std::mutex> lock (mutex);
+  ASSERT_EQ (2, sets.size ());
+  EXPECT_EQ ((std::vector<unsigned long> {33, 31, 30}), sets[0]);
+  EXPECT_EQ ((std::vector<unsigned long> {66, 64, 63}), sets[1]);
+  EXPECT_EQ (2, sync.getNumberOfDroppedFrames ());
+}
+
+TEST (MultiSynchronizer, BoundedLatency)
+{
+  pcl::MultiSynchronizer<int> sync (2, 5, 50ms);
+  std::atomic<int> count (0);
+  sync.addCallback ([&] (const std::vector<int>&, const std::vector<unsigned long>&) { ++count; });
+
+  // Stream 1 never delivers, the frame of stream 0 has to be dropped after the deadline
+  sync.add (0, 0, 0);
+  std::this_thread::sleep_for (200ms);
+  EXPECT_EQ (0, count);
+  EXPECT_EQ (1, sync.getNumberOfDroppedFrames ());
+}
+
+TEST (MultiSynchronizer, ParallelCallbacks)
+{
+  pcl::MultiSynchronizer<int> sync (2, 5, 500ms, 2);
+  std::atomic<int> running (0), max_running (0), count (0);
+  auto callback = [&] (const std::vector<int>&, const std::vector<unsigned long>&)
+  {
+    const int now = ++running;
+    int expected = max_running;
+    while (now > expected && !max_running.compare_exchange_weak (expected, now))
+      ;
+    std::this_thread::sleep_for (100ms);
+    --running;
+    ++count;
+  };
+  sync.addCallback (callback);
+  sync.addCallback (callback);
+
+  sync.add (0, 0, 10);
+  sync.add (1, 0, 10);
+  sync.add (0, 0, 20);
+  sync.add (1, 0, 20);
+  std::this_thread::sleep_for (400ms);
+  EXPECT_EQ (4, count);
+  EXPECT_EQ (2, max_running);
+}
+
+/* ---[ */
+int
+main (int argc, char** argv)
+{
+  testing::InitGoogleTest (&argc, argv);
+  return (RUN_ALL_TESTS ());
+}
+/* ]--- */
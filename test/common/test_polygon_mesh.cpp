@@ -39,6 +39,7 @@
 
 #include <pcl/pcl_tests.h>
 #include <pcl/PolygonMesh.h>
+#include <pcl/TriangleMesh.h>
 
 #include <pcl/point_types.h>
 #include <pcl/conversions.h>
@@ -126,6 +127,46 @@ TEST(PolygonMesh, concatenate_vertices)
     }
 }
 
+TEST(TriangleMesh, conversions)
+{
+    PolygonMesh mesh;
+    mesh.header.seq = 3;
+    mesh.cloud.width = 6;
+    mesh.cloud.height = 1;
+    mesh.cloud.data.resize(6 * 12, 7);
+    mesh.polygons.resize(3);
+    mesh.polygons[0].vertices = {0, 1, 2};
+    mesh.polygons[1].vertices = {1, 2, 3, 4, 5}; // split into a fan of 3 triangles
+    mesh.polygons[2].vertices = {4, 5};          // degenerate, dropped
+
+    TriangleMesh triangle_mesh;
+    toTriangleMesh(mesh, triangle_mesh);
+    EXPECT_EQ(mesh.header.seq, triangle_mesh.header.seq);
+    EXPECT_EQ(mesh.cloud.data, triangle_mesh.cloud.data);
+    const std::vector<std::uint32_t> triangles = {0, 1, 2, 1, 2, 3, 1, 3, 4, 1, 4, 5};
+    EXPECT_EQ(triangles, triangle_mesh.triangles);
+    ASSERT_EQ(4, triangle_mesh.size());
+    EXPECT_EQ(3u, triangle_mesh.getTriangle(2)[1]);
+
+    // Moving the mesh hands over the vertex data without copying it
+    const std::uint8_t* data = mesh.cloud.data.data();
+    TriangleMesh moved_mesh;
+    toTriangleMesh(std::move(mesh), moved_mesh);
+    EXPECT_EQ(data, moved_mesh.cloud.data.data());
+    EXPECT_EQ(triangles, moved_mesh.triangles);
+
+    PolygonMesh back;
+    toPolygonMesh(std::move(moved_mesh), back);
+    EXPECT_EQ(data, back.cloud.data.data());
+    ASSERT_EQ(4, back.polygons.size());
+    for (std::size_t i = 0; i < back.polygons.size(); ++i)
+    {
+        ASSERT_EQ(3, back.polygons[i].vertices.size());
+        for (std::size_t j = 0; j < 3; ++j)
+            EXPECT_EQ(triangles[3 * i + j], back.polygons[i].vertices[j]);
+    }
+}
+
 int
 main(int argc, char** argv)
 {
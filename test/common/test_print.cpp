@@ -0,0 +1,160 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2024-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <pcl/test/gtest.h>
+#include <pcl/console/print.h>
+
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace pcl::console;
+
+namespace
+{
+  std::vector<std::string>
+  readLines (FILE *stream)
+  {
+    std::string content;
+    rewind (stream);
+    char buffer[256];
+    std::size_t size;
+    while ((size = fread (buffer, 1, sizeof (buffer), stream)) > 0)
+      content.append (buffer, size);
+
+    std::vector<std::string> lines;
+    std::istringstream iss (content);
+    std::string line;
+    while (std::getline (iss, line))
+      lines.push_back (line);
+    return (lines);
+  }
+
+  void
+  printConcurrently (FILE *stream, int nr_threads, int nr_messages)
+  {
+    std::vector<std::thread> threads;
+    for (int t = 0; t < nr_threads; ++t)
+      threads.emplace_back ([stream, t, nr_messages]
+      {
+        for (int i = 0; i < nr_messages; ++i)
+          print (L_INFO, stream, "thread %d message %d of a message long enough to be split by the stream\n", t, i);
+      });
+    for (auto &thread : threads)
+      thread.join ();
+  }
+
+  void
+  checkMessages (const std::vector<std::string> &lines, int nr_threads, int nr_messages)
+  {
+    ASSERT_EQ (static_cast<std::size_t> (nr_threads * nr_messages), lines.size ());
+    std::vector<int> next (nr_threads, 0);
+    for (const auto &line : lines)
+    {
+      int t = -1, i = -1;
+      ASSERT_EQ (2, sscanf (line.c_str (), "thread %d message %d of a message long enough to be split by the stream", &t, &i)) << line;
+      ASSERT_TRUE (t >= 0 && t < nr_threads);
+      // The messages of each thread are written in order
+      EXPECT_EQ (next[t]++, i);
+    }
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, PrintCompiledOutArguments)
+{
+  const VERBOSITY_LEVEL level = getVerbosityLevel ();
+  setVerbosityLevel (L_ERROR);
+  int nr_evaluations = 0;
+  PCL_DEBUG ("%d\n", ++nr_evaluations);
+  PCL_VERBOSE ("%d\n", ++nr_evaluations);
+  EXPECT_EQ (0, nr_evaluations);
+  setVerbosityLevel (level);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, PrintConcurrent)
+{
+  FILE *stream = tmpfile ();
+  ASSERT_NE (nullptr, stream);
+  enableColoredOutput (stream, false);
+  const VERBOSITY_LEVEL level = getVerbosityLevel ();
+  setVerbosityLevel (L_INFO);
+
+  printConcurrently (stream, 8, 500);
+  checkMessages (readLines (stream), 8, 500);
+
+  setVerbosityLevel (level);
+  fclose (stream);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, PrintAsynchronous)
+{
+  FILE *stream = tmpfile ();
+  ASSERT_NE (nullptr, stream);
+  enableColoredOutput (stream, false);
+  const VERBOSITY_LEVEL level = getVerbosityLevel ();
+  setVerbosityLevel (L_INFO);
+
+  enableAsynchronousOutput (true);
+  EXPECT_TRUE (isAsynchronousOutputEnabled ());
+  printConcurrently (stream, 8, 500);
+  flushOutput ();
+  checkMessages (readLines (stream), 8, 500);
+
+  // Disabling the output writes the pending messages
+  fseek (stream, 0, SEEK_END);
+  print (L_INFO, stream, "thread 0 message 500 of a message long enough to be split by the stream\n");
+  enableAsynchronousOutput (false);
+  EXPECT_FALSE (isAsynchronousOutputEnabled ());
+  EXPECT_EQ (8u * 500u + 1u, readLines (stream).size ());
+
+  setVerbosityLevel (level);
+  fclose (stream);
+}
+
+/* ---[ */
+int
+main (int argc, char** argv)
+{
+  testing::InitGoogleTest (&argc, argv);
+  return (RUN_ALL_TESTS ());
+}
+/* ]--- */
@@ -211,6 +211,77 @@ TYPED_TEST (Transforms, PointCloudXYZRGBNormalDenseIndexed)
   }
 }
 
+TYPED_TEST (Transforms, PointCloudSoA)
+{
+  // The structure of arrays keeps the indices of the points it was created from
+  pcl::PointCloudSoA soa;
+  soa.assign (this->p_xyz_normal, this->indices);
+  pcl::PointCloudSoA p;
+  pcl::transformPointCloud (soa, p, this->tf);
+  ASSERT_EQ (p.size (), this->indices.size ());
+  for (std::size_t i = 0; i < p.size (); ++i)
+  {
+    ASSERT_EQ (p.getIndex (i), this->indices[i]);
+    ASSERT_XYZ_NEAR (PointXYZ (p.getPoint (i).x (), p.getPoint (i).y (), p.getPoint (i).z ()),
+                     this->p_xyz_normal_trans[i * 2], this->ABS_ERROR);
+  }
+
+  // In place, then written back into the original cloud
+  pcl::PointCloud<pcl::PointXYZRGBNormal> cloud = this->p_xyz_normal;
+  soa.assign (cloud);
+  pcl::transformPointCloud (soa, soa, this->tf);
+  soa.copyXYZTo (cloud);
+  for (std::size_t i = 0; i < cloud.size (); ++i)
+  {
+    ASSERT_XYZ_NEAR (cloud[i], this->p_xyz_normal_trans[i], this->ABS_ERROR);
+    ASSERT_NORMAL_NEAR (cloud[i], this->p_xyz_normal[i], this->ABS_ERROR);
+  }
+}
+
+TYPED_TEST (Transforms, PointCloudXYZNormalThreads)
+{
+  pcl::PointCloud<pcl::PointXYZRGBNormal> p, p_threads;
+  pcl::transformPointCloudWithNormals (this->p_xyz_normal, p, this->tf, true, 1);
+  pcl::transformPointCloudWithNormals (this->p_xyz_normal, p_threads, this->tf, true, 4);
+  ASSERT_METADATA_EQ (p_threads, this->p_xyz_normal);
+  ASSERT_EQ (p_threads.size (), p.size ());
+  for (std::size_t i = 0; i < p.size (); ++i)
+  {
+    ASSERT_XYZ_EQ (p_threads[i], p[i]);
+    ASSERT_NORMAL_EQ (p_threads[i], p[i]);
+    ASSERT_EQ (p_threads[i].rgb, p[i].rgb);
+  }
+
+  // In place, with non finite points
+  pcl::PointCloud<pcl::PointXYZ> cloud = this->p_xyz;
+  cloud[1].x = std::numeric_limits<float>::quiet_NaN ();
+  cloud.is_dense = false;
+  pcl::transformPointCloud (cloud, cloud, this->tf, true, 4);
+  ASSERT_EQ (cloud.size (), this->p_xyz.size ());
+  EXPECT_TRUE (std::isnan (cloud[1].x));
+  for (std::size_t i = 0; i < cloud.size (); ++i)
+  {
+    if (i != 1)
+    {
+      ASSERT_XYZ_NEAR (cloud[i], this->p_xyz_trans[i], this->ABS_ERROR);
+    }
+  }
+}
+
+TYPED_TEST (Transforms, PointCloudXYZNormalIndicesInPlace)
+{
+  // The indexed points are gathered into the cloud they are read from
+  pcl::PointCloud<pcl::PointXYZRGBNormal> cloud = this->p_xyz_normal;
+  pcl::transformPointCloudWithNormals (cloud, this->indices, cloud, this->tf, true, 4);
+  ASSERT_EQ (cloud.size (), this->indices.size ());
+  for (std::size_t i = 0; i < cloud.size (); ++i)
+  {
+    ASSERT_XYZ_NEAR (cloud[i], this->p_xyz_normal_trans[this->indices[i]], this->ABS_ERROR);
+    ASSERT_NORMAL_NEAR (cloud[i], this->p_xyz_normal_trans[this->indices[i]], this->ABS_ERROR);
+    ASSERT_EQ (cloud[i].rgb, this->p_xyz_normal[this->indices[i]].rgb);
+  }
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////
 TEST (PCL, Matrix4Affine3Transform)
 {
@@ -41,6 +41,7 @@
 #include <pcl/point_cloud.h>
 #include <pcl/features/normal_3d.h>
 #include <pcl/features/boundary.h>
+#include <pcl/features/boundary_omp.h>
 #include <pcl/io/pcd_io.h>
 
 using namespace pcl;
@@ -128,6 +129,43 @@ TEST (PCL, BoundaryEstimation)
   EXPECT_TRUE (pt);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, BoundaryEstimationOMP)
+{
+  NormalEstimation<PointXYZ, Normal> n;
+  PointCloud<Normal>::Ptr normals (new PointCloud<Normal> ());
+  n.setInputCloud (cloud.makeShared ());
+  n.setSearchMethod (tree);
+  n.setKSearch (10);
+  n.compute (*normals);
+
+  BoundaryEstimation<PointXYZ, Normal, Boundary> b;
+  b.setInputCloud (cloud.makeShared ());
+  b.setInputNormals (normals);
+  b.setSearchMethod (tree);
+  b.setKSearch (10);
+  PointCloud<Boundary> bps;
+  b.compute (bps);
+
+  BoundaryEstimationOMP<PointXYZ, Normal, Boundary> b_omp (4);
+  b_omp.setInputCloud (cloud.makeShared ());
+  b_omp.setInputNormals (normals);
+  b_omp.setSearchMethod (tree);
+  b_omp.setKSearch (10);
+  PointCloud<Boundary> bps_omp;
+  b_omp.compute (bps_omp);
+
+  ASSERT_EQ (bps.size (), bps_omp.size ());
+  EXPECT_EQ (bps.is_dense, bps_omp.is_dense);
+  int nr_boundary_points = 0;
+  for (std::size_t i = 0; i < bps.size (); ++i)
+  {
+    EXPECT_EQ (bps[i].boundary_point, bps_omp[i].boundary_point);
+    nr_boundary_points += bps[i].boundary_point;
+  }
+  EXPECT_GT (nr_boundary_points, 0);
+}
+
 /* ---[ */
 int
 main (int argc, char** argv)
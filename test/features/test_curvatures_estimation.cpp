@@ -41,6 +41,7 @@
 #include <pcl/point_cloud.h>
 #include <pcl/features/normal_3d.h>
 #include <pcl/features/principal_curvatures.h>
+#include <pcl/features/principal_curvatures_omp.h>
 #include <pcl/io/pcd_io.h>
 
 using namespace pcl;
@@ -142,6 +143,45 @@ TEST (PCL, PrincipalCurvaturesEstimation)
   EXPECT_NEAR ((*pcs)[indices.size () - 1].pc2, 0.17906941473484039, 1e-4);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, PrincipalCurvaturesEstimationOMP)
+{
+  // Estimate normals first
+  NormalEstimation<PointXYZ, Normal> n;
+  PointCloud<Normal>::Ptr normals (new PointCloud<Normal> ());
+  n.setInputCloud (cloud.makeShared ());
+  n.setSearchMethod (tree);
+  n.setKSearch (10);
+  n.compute (*normals);
+
+  PrincipalCurvaturesEstimation<PointXYZ, Normal, PrincipalCurvatures> pc;
+  pc.setInputCloud (cloud.makeShared ());
+  pc.setInputNormals (normals);
+  pc.setSearchMethod (tree);
+  pc.setKSearch (20);
+  PointCloud<PrincipalCurvatures> pcs;
+  pc.compute (pcs);
+
+  PrincipalCurvaturesEstimationOMP<PointXYZ, Normal, PrincipalCurvatures> pc_omp (4);
+  pc_omp.setInputCloud (cloud.makeShared ());
+  pc_omp.setInputNormals (normals);
+  pc_omp.setSearchMethod (tree);
+  pc_omp.setKSearch (20);
+  PointCloud<PrincipalCurvatures> pcs_omp;
+  pc_omp.compute (pcs_omp);
+
+  // Each thread uses its own buffers, the results are the ones of the serial estimation
+  ASSERT_EQ (pcs.size (), pcs_omp.size ());
+  EXPECT_EQ (pcs.is_dense, pcs_omp.is_dense);
+  for (std::size_t i = 0; i < pcs.size (); ++i)
+  {
+    for (int d = 0; d < 3; ++d)
+      EXPECT_EQ (pcs[i].principal_curvature[d], pcs_omp[i].principal_curvature[d]);
+    EXPECT_EQ (pcs[i].pc1, pcs_omp[i].pc1);
+    EXPECT_EQ (pcs[i].pc2, pcs_omp[i].pc2);
+  }
+}
+
 /* ---[ */
 int
 main (int argc, char** argv)
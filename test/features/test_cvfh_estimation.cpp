@@ -41,6 +41,12 @@
 #include <pcl/point_cloud.h>
 #include <pcl/features/normal_3d.h>
 #include <pcl/features/cvfh.h>
+#include <pcl/features/esf.h>
+#include <pcl/features/gasd.h>
+#include <pcl/features/global_feature_batch.h>
+#include <pcl/features/vfh.h>
+#include <pcl/common/centroid.h>
+#include <pcl/common/io.h>
 #include <pcl/io/pcd_io.h>
 #include <pcl/filters/voxel_grid.h>
 
@@ -118,6 +124,138 @@ TEST (PCL, CVFHEstimationMilk)
   EXPECT_EQ (static_cast<int>(vfhs->size ()), 2);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointOutT> void
+setClusterNormals (Feature<PointXYZ, PointOutT> &, const PointCloud<Normal>::Ptr &, const PointIndices &)
+{
+}
+
+template <typename PointOutT> void
+setClusterNormals (FeatureFromNormals<PointXYZ, Normal, PointOutT> &estimator, const PointCloud<Normal>::Ptr &normals,
+                   const PointIndices &cluster)
+{
+  PointCloud<Normal>::Ptr cluster_normals (new PointCloud<Normal>);
+  copyPointCloud (*normals, cluster, *cluster_normals);
+  estimator.setInputNormals (cluster_normals);
+}
+
+template <typename FeatureEstimation> void
+checkBatchAgainstClusters (FeatureEstimation &estimator, const PointCloud<Normal>::Ptr &normals,
+                           const std::vector<PointIndices> &clusters)
+{
+  GlobalFeatureBatch<FeatureEstimation> batch (estimator, 4);
+  std::vector<typename FeatureEstimation::PointCloudOut::Ptr> descriptors;
+  ASSERT_TRUE (batch.compute (clusters, descriptors));
+  ASSERT_EQ (clusters.size (), descriptors.size ());
+
+  for (std::size_t i = 0; i < clusters.size (); ++i)
+  {
+    CloudPtr cluster_cloud (new PointCloud<PointXYZ>);
+    copyPointCloud (cloud, clusters[i], *cluster_cloud);
+    FeatureEstimation serial (estimator);
+    serial.setInputCloud (cluster_cloud);
+    serial.setSearchMethod (KdTreePtr (new search::KdTree<PointXYZ> (false)));
+    setClusterNormals (serial, normals, clusters[i]);
+    typename FeatureEstimation::PointCloudOut expected;
+    serial.compute (expected);
+
+    ASSERT_EQ (expected.size (), descriptors[i]->size ());
+    for (std::size_t j = 0; j < expected.size (); ++j)
+      for (int k = 0; k < FeatureEstimation::PointCloudOut::PointType::descriptorSize (); ++k)
+        EXPECT_NEAR (expected[j].histogram[k], (*descriptors[i])[j].histogram[k], 1e-4);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, GlobalFeatureBatch)
+{
+  NormalEstimation<PointXYZ, Normal> n;
+  PointCloud<Normal>::Ptr normals (new PointCloud<Normal> ());
+  n.setInputCloud (cloud.makeShared ());
+  n.setSearchMethod (tree);
+  n.setKSearch (10);
+  n.compute (*normals);
+
+  // Split the bunny in four clusters around its centroid, and add the whole bunny
+  Eigen::Vector4f centroid;
+  compute3DCentroid (cloud, centroid);
+  std::vector<PointIndices> clusters (5);
+  for (std::size_t i = 0; i < cloud.size (); ++i)
+  {
+    const int quadrant = (cloud[i].x > centroid[0] ? 1 : 0) + (cloud[i].y > centroid[1] ? 2 : 0);
+    clusters[quadrant].indices.push_back (static_cast<int> (i));
+    clusters[4].indices.push_back (static_cast<int> (i));
+  }
+
+  VFHEstimation<PointXYZ, Normal, VFHSignature308> vfh;
+  vfh.setInputCloud (cloud.makeShared ());
+  vfh.setInputNormals (normals);
+  checkBatchAgainstClusters (vfh, normals, clusters);
+
+  CVFHEstimation<PointXYZ, Normal, VFHSignature308> cvfh;
+  cvfh.setInputCloud (cloud.makeShared ());
+  cvfh.setInputNormals (normals);
+  checkBatchAgainstClusters (cvfh, normals, clusters);
+
+  GASDEstimation<PointXYZ, GASDSignature512> gasd;
+  gasd.setInputCloud (cloud.makeShared ());
+  checkBatchAgainstClusters (gasd, PointCloud<Normal>::Ptr (), clusters);
+
+  // ESF samples the clouds randomly, the same seed gives the same samples
+  using ESF = ESFEstimation<PointXYZ, ESFSignature640>;
+  ESF esf;
+  esf.setInputCloud (cloud.makeShared ());
+  esf.setSeed (42);
+  checkBatchAgainstClusters (esf, PointCloud<Normal>::Ptr (), clusters);
+
+  std::vector<PointCloud<ESFSignature640>::Ptr> esf_descriptors;
+  // Without an input cloud there is nothing to compute
+  GlobalFeatureBatch<ESF> empty_batch;
+  EXPECT_FALSE (empty_batch.compute (clusters, esf_descriptors));
+  EXPECT_TRUE (esf_descriptors.empty ());
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, ESFEstimation)
+{
+  ESFEstimation<PointXYZ, ESFSignature640> esf;
+  esf.setInputCloud (cloud.makeShared ());
+  esf.setSeed (7);
+  PointCloud<ESFSignature640> serial, parallel, converged;
+  esf.compute (serial);
+  ASSERT_EQ (1, serial.size ());
+  float sum = 0;
+  for (const float bin : serial[0].histogram)
+    sum += bin;
+  EXPECT_NEAR (1.0f, sum, 1e-4);
+
+  // The descriptor only depends on the seed
+  esf.setNumberOfThreads (4);
+  esf.compute (parallel);
+  ASSERT_EQ (1, parallel.size ());
+  for (int i = 0; i < ESFSignature640::descriptorSize (); ++i)
+    EXPECT_EQ (serial[0].histogram[i], parallel[0].histogram[i]);
+
+  // A converged histogram is close to the one of all the samples
+  esf.setConvergenceThreshold (0.05f);
+  esf.compute (converged);
+  ASSERT_EQ (1, converged.size ());
+  float distance = 0;
+  for (int i = 0; i < ESFSignature640::descriptorSize (); ++i)
+    distance += std::abs (serial[0].histogram[i] - converged[0].histogram[i]);
+  EXPECT_LT (distance, 0.2f);
+
+  // Less than three points cannot be sampled
+  PointCloud<PointXYZ>::Ptr two_points (new PointCloud<PointXYZ>);
+  two_points->push_back (cloud[0]);
+  two_points->push_back (cloud[1]);
+  esf.setInputCloud (two_points);
+  PointCloud<ESFSignature640> invalid;
+  esf.compute (invalid);
+  ASSERT_EQ (1, invalid.size ());
+  EXPECT_FALSE (std::isfinite (invalid[0].histogram[0]));
+}
+
 /* ---[ */
 int
 main (int argc, char** argv)
@@ -489,6 +489,63 @@ TEST (PCL, IINormalEstimationSimple3DGradient)
   }
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, IINormalEstimationThreads)
+{
+  // A curved surface with a few holes, the normals computed in parallel are the same as the serial ones
+  PointCloud<PointXYZ>::Ptr surface (new PointCloud<PointXYZ> (64, 48));
+  for (std::size_t v = 0; v < surface->height; ++v)
+  {
+    for (std::size_t u = 0; u < surface->width; ++u)
+    {
+      PointXYZ& point = (*surface) (u, v);
+      point.x = static_cast<float> (u) * 0.01f;
+      point.y = static_cast<float> (v) * 0.01f;
+      point.z = 1.0f + 0.2f * std::sin (point.x * 5.0f) * std::cos (point.y * 3.0f);
+      if ((u * 7 + v * 13) % 97 == 0)
+        point.z = std::numeric_limits<float>::quiet_NaN ();
+    }
+  }
+  surface->is_dense = false;
+
+  const IntegralImageNormalEstimation<PointXYZ, Normal>::NormalEstimationMethod methods[] =
+      {ne.COVARIANCE_MATRIX, ne.AVERAGE_3D_GRADIENT, ne.AVERAGE_DEPTH_CHANGE, ne.SIMPLE_3D_GRADIENT};
+  for (const auto method : methods)
+  {
+    for (const auto border_policy : {ne.BORDER_POLICY_IGNORE, ne.BORDER_POLICY_MIRROR})
+    {
+      if (method == ne.SIMPLE_3D_GRADIENT && border_policy == ne.BORDER_POLICY_MIRROR)
+        continue;
+
+      PointCloud<Normal> output[2];
+      for (int i = 0; i < 2; ++i)
+      {
+        IntegralImageNormalEstimation<PointXYZ, Normal> estimation;
+        estimation.setNumberOfThreads (i == 0 ? 1 : 4);
+        estimation.setNormalEstimationMethod (method);
+        estimation.setBorderPolicy (border_policy);
+        estimation.setNormalSmoothingSize (5.0f);
+        estimation.setDepthDependentSmoothing (true);
+        estimation.setInputCloud (surface);
+        estimation.compute (output[i]);
+      }
+
+      ASSERT_EQ (output[0].size (), output[1].size ());
+      for (std::size_t i = 0; i < output[0].size (); ++i)
+      {
+        if (!std::isfinite (output[0][i].normal_x))
+        {
+          EXPECT_FALSE (std::isfinite (output[1][i].normal_x));
+          continue;
+        }
+        EXPECT_EQ (output[0][i].normal_x, output[1][i].normal_x);
+        EXPECT_EQ (output[0][i].normal_y, output[1][i].normal_y);
+        EXPECT_EQ (output[0][i].normal_z, output[1][i].normal_z);
+      }
+    }
+  }
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 TEST (PCL, IINormalEstimationSimple3DGradientUnorganized)
 {
@@ -106,6 +106,31 @@ TEST (MomentOfInertia, InvalidParameters)
   EXPECT_LT (0.0f, point_mass);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (MomentOfInertia, Threads)
+{
+  pcl::MomentOfInertiaEstimation <pcl::PointXYZ> feature_extractor;
+  feature_extractor.setInputCloud (cloud);
+  feature_extractor.compute ();
+  std::vector <float> moment_of_inertia, eccentricity;
+  feature_extractor.getMomentOfInertia (moment_of_inertia);
+  feature_extractor.getEccentricity (eccentricity);
+
+  feature_extractor.setNumberOfThreads (4);
+  feature_extractor.compute ();
+  std::vector <float> moment_of_inertia_threads, eccentricity_threads;
+  EXPECT_TRUE (feature_extractor.getMomentOfInertia (moment_of_inertia_threads));
+  EXPECT_TRUE (feature_extractor.getEccentricity (eccentricity_threads));
+
+  ASSERT_EQ (moment_of_inertia.size (), moment_of_inertia_threads.size ());
+  ASSERT_EQ (eccentricity.size (), eccentricity_threads.size ());
+  for (std::size_t i = 0; i < moment_of_inertia.size (); ++i)
+  {
+    EXPECT_EQ (moment_of_inertia[i], moment_of_inertia_threads[i]);
+    EXPECT_EQ (eccentricity[i], eccentricity_threads[i]);
+  }
+}
+
 /* ---[ */
 int
 main (int argc, char** argv)
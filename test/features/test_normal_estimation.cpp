@@ -42,6 +42,8 @@
 #include <pcl/common/utils.h> // pcl::utils::ignore
 #include <pcl/features/normal_3d.h>
 #include <pcl/features/normal_3d_omp.h>
+#include <pcl/features/multiscale_normal_3d.h>
+#include <pcl/features/neighborhood_cache.h>
 #include <pcl/features/integral_image_normal.h>
 #include <pcl/io/pcd_io.h>
 
@@ -271,6 +273,222 @@ TEST (PCL, NormalEstimationOpenMP)
   }
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, NormalEstimationBatches)
+{
+  // Neighborhoods of different sizes and points which are not finite, in batches which are not all full
+  PointCloud<PointXYZ>::Ptr cloudptr (new PointCloud<PointXYZ> (cloud));
+  for (std::size_t i = 0; i < cloudptr->size (); i += 7)
+    (*cloudptr)[i].x = std::numeric_limits<float>::quiet_NaN ();
+  cloudptr->is_dense = false;
+  pcl::IndicesPtr subset (new pcl::Indices);
+  for (std::size_t i = 0; i < cloudptr->size () - 3; ++i)
+    subset->push_back (static_cast<int> (i));
+
+  search::KdTree<PointXYZ>::Ptr kdtree (new search::KdTree<PointXYZ> (false));
+  kdtree->setInputCloud (cloudptr);
+  NormalEstimation<PointXYZ, Normal> n;
+  n.setInputCloud (cloudptr);
+  n.setIndices (subset);
+  n.setSearchMethod (kdtree);
+  n.setRadiusSearch (0.01);
+  PointCloud<Normal> normals;
+  n.compute (normals);
+  ASSERT_EQ (normals.size (), subset->size ());
+  EXPECT_FALSE (normals.is_dense);
+
+  NormalEstimationOMP<PointXYZ, Normal> n_omp (2);
+  n_omp.setInputCloud (cloudptr);
+  n_omp.setIndices (subset);
+  n_omp.setSearchMethod (kdtree);
+  n_omp.setRadiusSearch (0.01);
+  PointCloud<Normal> normals_omp;
+  n_omp.compute (normals_omp);
+  ASSERT_EQ (normals_omp.size (), subset->size ());
+
+  std::vector<int> nn_indices;
+  std::vector<float> nn_dists;
+  for (std::size_t i = 0; i < subset->size (); ++i)
+  {
+    const int index = (*subset)[i];
+    Eigen::Vector4f plane;
+    float curvature;
+    if (!isFinite ((*cloudptr)[index]) || kdtree->radiusSearch (index, 0.01, nn_indices, nn_dists) == 0 ||
+        !computePointNormal (*cloudptr, nn_indices, plane, curvature))
+    {
+      EXPECT_FALSE (std::isfinite (normals[i].curvature));
+      EXPECT_FALSE (std::isfinite (normals_omp[i].curvature));
+      continue;
+    }
+    flipNormalTowardsViewpoint ((*cloudptr)[index], 0.0f, 0.0f, 0.0f, plane);
+    for (int d = 0; d < 3; ++d)
+    {
+      EXPECT_NEAR (plane[d], normals[i].normal[d], 1e-4);
+      EXPECT_NEAR (plane[d], normals_omp[i].normal[d], 1e-4);
+    }
+    EXPECT_NEAR (curvature, normals[i].curvature, 1e-5);
+    EXPECT_NEAR (curvature, normals_omp[i].curvature, 1e-5);
+  }
+
+  // The same normals in the order of the indices when the points are processed in Morton order
+  n_omp.setSpatialQueryOrder (true);
+  EXPECT_TRUE (n_omp.getSpatialQueryOrder ());
+  PointCloud<Normal> normals_ordered;
+  n_omp.compute (normals_ordered);
+  ASSERT_EQ (normals_ordered.size (), subset->size ());
+  EXPECT_FALSE (normals_ordered.is_dense);
+  for (std::size_t i = 0; i < subset->size (); ++i)
+  {
+    if (!std::isfinite (normals_omp[i].curvature))
+    {
+      EXPECT_FALSE (std::isfinite (normals_ordered[i].curvature));
+      continue;
+    }
+    for (int d = 0; d < 3; ++d)
+      EXPECT_NEAR (normals_omp[i].normal[d], normals_ordered[i].normal[d], 1e-4);
+    EXPECT_NEAR (normals_omp[i].curvature, normals_ordered[i].curvature, 1e-5);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, NormalEstimationNeighborhoodCache)
+{
+  PointCloud<PointXYZ>::Ptr cloudptr = cloud.makeShared ();
+  auto expectSameNormals = [] (const PointCloud<Normal> &expected, const PointCloud<Normal> &normals)
+  {
+    ASSERT_EQ (expected.size (), normals.size ());
+    for (std::size_t i = 0; i < expected.size (); ++i)
+    {
+      if (!std::isfinite (expected[i].curvature))
+      {
+        EXPECT_FALSE (std::isfinite (normals[i].curvature));
+        continue;
+      }
+      for (int d = 0; d < 3; ++d)
+        EXPECT_NEAR (expected[i].normal[d], normals[i].normal[d], 1e-4);
+      EXPECT_NEAR (expected[i].curvature, normals[i].curvature, 1e-4);
+    }
+  };
+
+  // A radius smaller than the cached one is served from the cache
+  NeighborhoodCache<PointXYZ>::Ptr cache (new NeighborhoodCache<PointXYZ>);
+  cache->setInputCloud (cloudptr);
+  cache->setRadiusSearch (0.04);
+  cache->setNumberOfThreads (2);
+  ASSERT_TRUE (cache->compute ());
+  EXPECT_EQ (cache->size (), cloud.size ());
+  EXPECT_TRUE (cache->isCached (0));
+  EXPECT_TRUE (cache->covers (0.03));
+  EXPECT_FALSE (cache->covers (0.05));
+
+  NormalEstimationOMP<PointXYZ, Normal> n (2);
+  n.setInputCloud (cloudptr);
+  n.setRadiusSearch (0.03);
+  PointCloud<Normal> expected, normals;
+  n.compute (expected);
+  n.setNeighborhoodCache (cache);
+  EXPECT_EQ (n.getNeighborhoodCache (), cache);
+  n.compute (normals);
+  expectSameNormals (expected, normals);
+
+  // Only some of the points are cached, the other ones are searched
+  pcl::IndicesPtr half (new pcl::Indices);
+  for (std::size_t i = 0; i < cloud.size (); i += 2)
+    half->push_back (static_cast<int> (i));
+  cache->setIndices (half);
+  ASSERT_TRUE (cache->compute ());
+  EXPECT_EQ (cache->size (), half->size ());
+  EXPECT_FALSE (cache->isCached (1));
+  n.compute (normals);
+  expectSameNormals (expected, normals);
+
+  // A larger radius is not served from the cache
+  n.setRadiusSearch (0.05);
+  n.setNeighborhoodCache (NeighborhoodCache<PointXYZ>::ConstPtr ());
+  n.compute (expected);
+  n.setNeighborhoodCache (cache);
+  n.compute (normals);
+  expectSameNormals (expected, normals);
+
+  // The nearest neighbors are served by the first cached ones
+  NeighborhoodCache<PointXYZ>::Ptr k_cache (new NeighborhoodCache<PointXYZ>);
+  k_cache->setInputCloud (cloudptr);
+  k_cache->setKSearch (20);
+  ASSERT_TRUE (k_cache->compute ());
+  n.setRadiusSearch (0);
+  n.setKSearch (10);
+  n.setNeighborhoodCache (NeighborhoodCache<PointXYZ>::ConstPtr ());
+  n.compute (expected);
+  n.setNeighborhoodCache (k_cache);
+  n.compute (normals);
+  expectSameNormals (expected, normals);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, MultiscaleNormalEstimation)
+{
+  // Points which are not finite, on a subset of the cloud
+  PointCloud<PointXYZ>::Ptr cloudptr (new PointCloud<PointXYZ> (cloud));
+  for (std::size_t i = 0; i < cloudptr->size (); i += 11)
+    (*cloudptr)[i].x = std::numeric_limits<float>::quiet_NaN ();
+  cloudptr->is_dense = false;
+  pcl::IndicesPtr subset (new pcl::Indices);
+  for (std::size_t i = 0; i < cloudptr->size () - 5; ++i)
+    subset->push_back (static_cast<int> (i));
+
+  MultiscaleNormalEstimation<PointXYZ, Normal> n (2);
+  n.setInputCloud (cloudptr);
+  n.setIndices (subset);
+  n.setRadiusSearch (0.02);
+  const std::vector<double> scales = {0.03, 0.01, 0.02};
+  n.setScales (scales);
+  EXPECT_EQ (scales, n.getScales ());
+  std::vector<PointCloud<Normal>::Ptr> normals;
+  n.computeAtScales (normals);
+  ASSERT_EQ (scales.size (), normals.size ());
+  EXPECT_EQ (0.02, n.getRadiusSearch ());
+
+  // Every scale has the normals of NormalEstimationOMP at the same radius
+  NormalEstimationOMP<PointXYZ, Normal> n_omp (2);
+  n_omp.setInputCloud (cloudptr);
+  n_omp.setIndices (subset);
+  for (std::size_t s = 0; s < scales.size (); ++s)
+  {
+    n_omp.setRadiusSearch (scales[s]);
+    PointCloud<Normal> expected;
+    n_omp.compute (expected);
+    ASSERT_EQ (expected.size (), normals[s]->size ());
+    EXPECT_EQ (expected.is_dense, normals[s]->is_dense);
+    for (std::size_t i = 0; i < expected.size (); ++i)
+    {
+      if (!std::isfinite (expected[i].curvature))
+      {
+        EXPECT_FALSE (std::isfinite ((*normals[s])[i].curvature));
+        continue;
+      }
+      for (int d = 0; d < 3; ++d)
+        EXPECT_NEAR (expected[i].normal[d], (*normals[s])[i].normal[d], 1e-4);
+      EXPECT_NEAR (expected[i].curvature, (*normals[s])[i].curvature, 1e-5);
+    }
+  }
+
+  // The single scale estimation is the one of NormalEstimationOMP
+  PointCloud<Normal> single;
+  n.compute (single);
+  n_omp.setRadiusSearch (0.02);
+  PointCloud<Normal> expected;
+  n_omp.compute (expected);
+  ASSERT_EQ (expected.size (), single.size ());
+  for (std::size_t i = 0; i < expected.size (); ++i)
+    if (std::isfinite (expected[i].curvature))
+      EXPECT_NEAR (expected[i].curvature, single[i].curvature, 1e-5);
+
+  // Without valid scales there is no output
+  n.setScales ({0.01, 0.0});
+  n.computeAtScales (normals);
+  EXPECT_TRUE (normals.empty ());
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // This tests the indexing issue from #3573
 // In certain cases when you used a subset of the indices
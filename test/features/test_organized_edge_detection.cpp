@@ -0,0 +1,94 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved
+ */
+
+#include <pcl/test/gtest.h>
+#include <pcl/point_types.h>
+#include <pcl/features/organized_edge_detection.h>
+
+#include <limits>
+
+using namespace pcl;
+
+PointCloud<PointXYZRGBA>::Ptr cloud (new PointCloud<PointXYZRGBA>);
+PointCloud<Normal>::Ptr normals (new PointCloud<Normal>);
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, OrganizedEdgeFromRGBNormalsThreads)
+{
+  OrganizedEdgeFromRGBNormals<PointXYZRGBA, Normal, Label> oed;
+  oed.setInputCloud (cloud);
+  oed.setInputNormals (normals);
+
+  oed.setNumberOfThreads (1);
+  PointCloud<Label> labels_serial;
+  std::vector<PointIndices> label_indices_serial;
+  oed.compute (labels_serial, label_indices_serial);
+
+  oed.setNumberOfThreads (4);
+  PointCloud<Label> labels_parallel;
+  std::vector<PointIndices> label_indices_parallel;
+  oed.compute (labels_parallel, label_indices_parallel);
+
+  ASSERT_EQ (labels_serial.size (), cloud->size ());
+  ASSERT_EQ (labels_parallel.size (), cloud->size ());
+  for (std::size_t i = 0; i < cloud->size (); ++i)
+    EXPECT_EQ (labels_serial[i].label, labels_parallel[i].label);
+
+  ASSERT_EQ (label_indices_serial.size (), label_indices_parallel.size ());
+  for (std::size_t i = 0; i < label_indices_serial.size (); ++i)
+    EXPECT_EQ (label_indices_serial[i].indices, label_indices_parallel[i].indices);
+
+  // The depth steps, the normal discontinuities and the color stripes are found
+  using OED = OrganizedEdgeBase<PointXYZRGBA, Label>;
+  for (const int edge_type : {OED::EDGELABEL_OCCLUDED, OED::EDGELABEL_HIGH_CURVATURE, OED::EDGELABEL_RGB_CANNY})
+  {
+    std::size_t nr_edge_points = 0;
+    for (const auto &label : labels_serial)
+      nr_edge_points += (label.label & edge_type) ? 1 : 0;
+    EXPECT_GT (nr_edge_points, 0u);
+  }
+}
+
+/* ---[ */
+int
+main (int argc, char** argv)
+{
+  // An organized cloud with depth steps, a band of invalid points, color stripes and normal discontinuities
+  const unsigned width = 320, height = 240;
+  cloud->resize (width * height);
+  cloud->width = width;
+  cloud->height = height;
+  cloud->is_dense = false;
+  normals->resize (width * height);
+  normals->width = width;
+  normals->height = height;
+  for (unsigned r = 0; r < height; ++r)
+    for (unsigned c = 0; c < width; ++c)
+    {
+      PointXYZRGBA &p = (*cloud) (c, r);
+      float z = 2.0f + ((c / 80) % 2) * 0.3f;
+      if (c >= 200 && c < 210)
+        z = std::numeric_limits<float>::quiet_NaN ();
+      p.x = (static_cast<float> (c) - width / 2) * z / 525.0f;
+      p.y = (static_cast<float> (r) - height / 2) * z / 525.0f;
+      p.z = z;
+      p.r = ((c / 40) % 2) ? 200 : 20;
+      p.g = ((r / 50) % 2) ? 180 : 30;
+      p.b = 100;
+
+      Normal &n = (*normals) (c, r);
+      n.normal_x = ((c / 60) % 2) ? 0.7f : 0.0f;
+      n.normal_y = ((r / 70) % 2) ? 0.7f : 0.0f;
+      n.normal_z = 0.7f;
+    }
+
+  testing::InitGoogleTest (&argc, argv);
+  return (RUN_ALL_TESTS ());
+}
+/* ]--- */
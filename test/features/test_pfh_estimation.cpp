@@ -45,6 +45,9 @@
 #include <pcl/test/gtest.h>
 #include <pcl/point_cloud.h>
 #include <pcl/features/pfh.h>
+#include <pcl/features/pfh_omp.h>
+#include <pcl/features/pfhrgb.h>
+#include <pcl/features/pfhrgb_omp.h>
 #include <pcl/features/fpfh.h>
 #include <pcl/features/fpfh_omp.h>
 #include <pcl/features/vfh.h>
@@ -259,6 +262,80 @@ TEST (PCL, PFHEstimation)
   (cloud, cloud, test_indices, 125);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, PFHEstimationOMP)
+{
+  using pcl::PFHSignature125;
+
+  // The pair features cache changes the order of the computations, not their results
+  pcl::PFHEstimation<PointT, PointT, PFHSignature125> pfh;
+  pfh.setInputCloud (cloud);
+  pfh.setInputNormals (cloud);
+  pfh.setSearchMethod (tree);
+  pfh.setKSearch (30);
+  PointCloud<PFHSignature125> pfhs;
+  pfh.compute (pfhs);
+
+  pcl::PFHEstimationOMP<PointT, PointT, PFHSignature125> pfh_omp (4);
+  pfh_omp.setInputCloud (cloud);
+  pfh_omp.setInputNormals (cloud);
+  pfh_omp.setSearchMethod (tree);
+  pfh_omp.setKSearch (30);
+  for (const bool use_cache : {false, true})
+  {
+    pfh_omp.setUseInternalCache (use_cache);
+    // A small cache also evicts pairs before they are reused
+    pfh_omp.setMaximumCacheSize (use_cache ? 1000 : pfh.getMaximumCacheSize ());
+    PointCloud<PFHSignature125> pfhs_omp;
+    pfh_omp.compute (pfhs_omp);
+    ASSERT_EQ (pfhs.size (), pfhs_omp.size ());
+    for (std::size_t i = 0; i < pfhs.size (); ++i)
+      for (int d = 0; d < 125; ++d)
+        EXPECT_EQ (pfhs[i].histogram[d], pfhs_omp[i].histogram[d]);
+  }
+
+  pcl::IndicesPtr test_indices (new pcl::Indices (0));
+  for (std::size_t i = 0; i < cloud->size (); i+=3)
+    test_indices->push_back (static_cast<int> (i));
+
+  testIndicesAndSearchSurface<pcl::PFHEstimationOMP, PointT, PointT, PFHSignature125>
+  (cloud, cloud, test_indices, 125);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, PFHRGBEstimationOMP)
+{
+  using pcl::PFHRGBSignature250;
+
+  PointCloud<pcl::PointXYZRGBNormal>::Ptr colored (new PointCloud<pcl::PointXYZRGBNormal> ());
+  pcl::copyPointCloud (*cloud, *colored);
+  for (std::size_t i = 0; i < colored->size (); ++i)
+  {
+    (*colored)[i].r = static_cast<std::uint8_t> (i % 256);
+    (*colored)[i].g = static_cast<std::uint8_t> ((3 * i) % 256);
+    (*colored)[i].b = static_cast<std::uint8_t> ((7 * i) % 256);
+  }
+
+  pcl::PFHRGBEstimation<pcl::PointXYZRGBNormal, pcl::PointXYZRGBNormal, PFHRGBSignature250> pfhrgb;
+  pfhrgb.setInputCloud (colored);
+  pfhrgb.setInputNormals (colored);
+  pfhrgb.setKSearch (20);
+  PointCloud<PFHRGBSignature250> pfhrgbs;
+  pfhrgb.compute (pfhrgbs);
+
+  pcl::PFHRGBEstimationOMP<pcl::PointXYZRGBNormal, pcl::PointXYZRGBNormal, PFHRGBSignature250> pfhrgb_omp (4);
+  pfhrgb_omp.setInputCloud (colored);
+  pfhrgb_omp.setInputNormals (colored);
+  pfhrgb_omp.setKSearch (20);
+  PointCloud<PFHRGBSignature250> pfhrgbs_omp;
+  pfhrgb_omp.compute (pfhrgbs_omp);
+
+  ASSERT_EQ (pfhrgbs.size (), pfhrgbs_omp.size ());
+  for (std::size_t i = 0; i < pfhrgbs.size (); ++i)
+    for (int d = 0; d < 250; ++d)
+      EXPECT_EQ (pfhrgbs[i].histogram[d], pfhrgbs_omp[i].histogram[d]);
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 using pcl::FPFHEstimation;
@@ -449,6 +526,73 @@ TYPED_TEST (FPFHTest, Estimation)
 }
 
 
+TYPED_TEST (FPFHTest, ReuseSPFHSignatures)
+{
+  // A copy of the cloud, which is modified in place
+  PointCloud<PointT>::Ptr surface (new PointCloud<PointT> (*cloud));
+  KdTreePtr kdtree (new pcl::search::KdTree<PointT> (false));
+  kdtree->setInputCloud (surface);
+
+  auto computeWindow = [&] (TypeParam &fpfh, std::size_t begin, std::size_t end, PointCloud<FPFHSignature33> &output)
+  {
+    pcl::IndicesPtr window (new pcl::Indices);
+    for (std::size_t i = begin; i < end; ++i)
+      window->push_back (static_cast<int> (i));
+    fpfh.setInputCloud (surface);
+    fpfh.setInputNormals (surface);
+    fpfh.setSearchSurface (surface);
+    fpfh.setIndices (window);
+    fpfh.setSearchMethod (kdtree);
+    fpfh.setRadiusSearch (0.02);
+    fpfh.compute (output);
+  };
+  auto expectSameHistograms = [] (const PointCloud<FPFHSignature33> &expected, const PointCloud<FPFHSignature33> &output, float tolerance)
+  {
+    ASSERT_EQ (expected.size (), output.size ());
+    for (std::size_t i = 0; i < expected.size (); ++i)
+      for (int d = 0; d < 33; ++d)
+      {
+        if (std::isfinite (expected[i].histogram[d]))
+          EXPECT_NEAR (expected[i].histogram[d], output[i].histogram[d], tolerance);
+        else
+          EXPECT_FALSE (std::isfinite (output[i].histogram[d]));
+      }
+  };
+
+  TypeParam& fpfh = this->fpfh;
+  for (const bool compact : {false, true})
+  {
+    fpfh.setReuseSPFHSignatures (true);
+    fpfh.setCompactSPFHSignatures (compact);
+    EXPECT_TRUE (fpfh.getReuseSPFHSignatures ());
+    EXPECT_EQ (compact, fpfh.getCompactSPFHSignatures ());
+    const float tolerance = (compact ? 1e-2f : 1e-5f);
+
+    // Overlapping windows reuse the signatures of the shared points
+    const std::size_t size = surface->size ();
+    for (std::size_t begin = 0; begin + size / 4 < size; begin += size / 4)
+    {
+      const std::size_t end = std::min (begin + size / 2, size);
+      PointCloud<FPFHSignature33> expected, output;
+      TypeParam reference;
+      computeWindow (reference, begin, end, expected);
+      computeWindow (fpfh, begin, end, output);
+      expectSameHistograms (expected, output, tolerance);
+    }
+
+    // A point whose normal changes invalidates the signatures around it
+    const int changed = static_cast<int> (size / 2);
+    (*surface)[changed].getNormalVector3fMap () = -(*surface)[changed].getNormalVector3fMap ();
+    fpfh.invalidateSPFHSignatures (std::vector<int> (1, changed));
+    PointCloud<FPFHSignature33> expected, output;
+    TypeParam reference;
+    computeWindow (reference, size / 4, 3 * size / 4, expected);
+    computeWindow (fpfh, size / 4, 3 * size / 4, output);
+    expectSameHistograms (expected, output, tolerance);
+  }
+  fpfh.setReuseSPFHSignatures (false);
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 TEST (PCL, VFHEstimation)
 {
@@ -41,6 +41,7 @@
 #include <pcl/point_cloud.h>
 #include <pcl/features/normal_3d.h>
 #include <pcl/features/ppf.h>
+#include <pcl/features/ppf_omp.h>
 #include <pcl/io/pcd_io.h>
 
 using namespace pcl;
@@ -98,6 +99,55 @@ TEST (PCL, PPFEstimation)
   EXPECT_NEAR ((*feature_cloud)[45381].alpha_m, -1.97276, 1e-4);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, PPFEstimationOMP)
+{
+  // Estimate normals
+  NormalEstimation<PointXYZ, Normal> normal_estimation;
+  PointCloud<Normal>::Ptr normals (new PointCloud<Normal> ());
+  normal_estimation.setInputCloud (cloud.makeShared ());
+  normal_estimation.setSearchMethod (tree);
+  normal_estimation.setKSearch (10);
+  normal_estimation.compute (*normals);
+
+  // Compute the features of a subset of reference points
+  pcl::IndicesPtr reference_indices (new pcl::Indices);
+  for (std::size_t i = 0; i < cloud.size (); i += 7)
+    reference_indices->push_back (static_cast<int> (i));
+
+  PPFEstimation <PointXYZ, Normal, PPFSignature> ppf_estimation;
+  ppf_estimation.setInputCloud (cloud.makeShared ());
+  ppf_estimation.setInputNormals (normals);
+  ppf_estimation.setIndices (reference_indices);
+  PointCloud<PPFSignature> features;
+  ppf_estimation.compute (features);
+
+  PPFEstimationOMP <PointXYZ, Normal, PPFSignature> ppf_estimation_omp (4);
+  ppf_estimation_omp.setInputCloud (cloud.makeShared ());
+  ppf_estimation_omp.setInputNormals (normals);
+  ppf_estimation_omp.setIndices (reference_indices);
+  PointCloud<PPFSignature> features_omp;
+  ppf_estimation_omp.compute (features_omp);
+
+  // The rows are computed independently, the features are the same
+  ASSERT_EQ (features_omp.size (), reference_indices->size () * cloud.size ());
+  ASSERT_EQ (features_omp.size (), features.size ());
+  EXPECT_EQ (features_omp.is_dense, features.is_dense);
+  for (std::size_t i = 0; i < features.size (); ++i)
+  {
+    if (std::isnan (features[i].f1))
+    {
+      EXPECT_TRUE (std::isnan (features_omp[i].f1));
+      continue;
+    }
+    EXPECT_EQ (features_omp[i].f1, features[i].f1);
+    EXPECT_EQ (features_omp[i].f2, features[i].f2);
+    EXPECT_EQ (features_omp[i].f3, features[i].f3);
+    EXPECT_EQ (features_omp[i].f4, features[i].f4);
+    EXPECT_EQ (features_omp[i].alpha_m, features[i].alpha_m);
+  }
+}
+
 /* ---[ */
 int
 main (int argc, char** argv)
@@ -40,6 +40,7 @@
 #include <pcl/test/gtest.h>
 #include <pcl/point_cloud.h>
 #include <pcl/features/rift.h>
+#include <pcl/features/rift_omp.h>
 
 using namespace pcl;
 
@@ -139,6 +140,22 @@ TEST (PCL, RIFTEstimation)
   }
   for (int i = 0; i < 32; ++i)
     EXPECT_NEAR (rift.histogram[i], correct_rift_feature_values[i], 1e-4);
+
+  // The parallel estimation gives the same descriptors
+  RIFTEstimationOMP<PointXYZI, IntensityGradient, RIFTDescriptor> rift_est_omp (4);
+  rift_est_omp.setSearchMethod (treept4);
+  rift_est_omp.setRadiusSearch (10.0);
+  rift_est_omp.setNrDistanceBins (4);
+  rift_est_omp.setNrGradientBins (8);
+  rift_est_omp.setInputCloud (cloud_xyzi.makeShared ());
+  rift_est_omp.setInputGradient (gradient.makeShared ());
+  PointCloud<RIFTDescriptor> rift_output_omp;
+  rift_est_omp.compute (rift_output_omp);
+
+  ASSERT_EQ (rift_output.size (), rift_output_omp.size ());
+  for (std::size_t i = 0; i < rift_output.size (); ++i)
+    for (int j = 0; j < 32; ++j)
+      EXPECT_EQ (rift_output[i].histogram[j], rift_output_omp[i].histogram[j]);
 }
 
 /* ---[ */
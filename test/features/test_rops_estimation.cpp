@@ -73,6 +73,44 @@ TEST (ROPSFeature, FeatureExtraction)
   EXPECT_NE (0, histograms->size ());
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (ROPSFeature, Threads)
+{
+  float support_radius = 0.0285f;
+
+  pcl::search::KdTree<pcl::PointXYZ>::Ptr search_method (new pcl::search::KdTree<pcl::PointXYZ>);
+  search_method->setInputCloud (cloud);
+
+  pcl::ROPSEstimation <pcl::PointXYZ, pcl::Histogram <135> > feature_estimator;
+  feature_estimator.setSearchMethod (search_method);
+  feature_estimator.setSearchSurface (cloud);
+  feature_estimator.setInputCloud (cloud);
+  feature_estimator.setIndices (indices);
+  feature_estimator.setTriangles (triangles);
+  feature_estimator.setRadiusSearch (support_radius);
+  feature_estimator.setSupportRadius (support_radius);
+
+  pcl::PointCloud<pcl::Histogram <135> > histograms, histograms_threads, histograms_again;
+  feature_estimator.compute (histograms);
+  feature_estimator.setNumberOfThreads (4);
+  feature_estimator.compute (histograms_threads);
+  // The lists of triangles of the points are built again with the new triangles
+  feature_estimator.setTriangles (triangles);
+  feature_estimator.compute (histograms_again);
+
+  ASSERT_EQ (indices->indices.size (), histograms.size ());
+  ASSERT_EQ (histograms.size (), histograms_threads.size ());
+  ASSERT_EQ (histograms.size (), histograms_again.size ());
+  for (std::size_t i = 0; i < histograms.size (); ++i)
+  {
+    for (int j = 0; j < 135; ++j)
+    {
+      EXPECT_EQ (histograms[i].histogram[j], histograms_threads[i].histogram[j]);
+      EXPECT_EQ (histograms[i].histogram[j], histograms_again[i].histogram[j]);
+    }
+  }
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 TEST (ROPSFeature, InvalidParameters)
 {
@@ -41,6 +41,7 @@
 #include <pcl/test/gtest.h>
 #include <pcl/point_cloud.h>
 #include <pcl/features/rsd.h>
+#include <pcl/features/rsd_omp.h>
 #include <pcl/features/normal_3d.h>
 #include <pcl/io/pcd_io.h>
 
@@ -117,6 +118,50 @@ TEST (PCL, RSDEstimation)
   
 }
 
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, RSDEstimationOMP)
+{
+  // Estimate normals first
+  NormalEstimation<PointXYZ, Normal> n;
+  PointCloud<Normal>::Ptr normals (new PointCloud<Normal> ());
+  n.setInputCloud (cloud);
+  n.setSearchMethod (tree);
+  n.setRadiusSearch (0.02);
+  n.compute (*normals);
+
+  RSDEstimation<PointXYZ, Normal, PrincipalRadiiRSD> rsd;
+  rsd.setInputCloud (cloud);
+  rsd.setInputNormals (normals);
+  rsd.setPlaneRadius (0.1);
+  rsd.setSearchMethod (tree);
+  rsd.setRadiusSearch (0.03);
+  rsd.setSaveHistograms (true);
+  PointCloud<PrincipalRadiiRSD> rsds;
+  rsd.compute (rsds);
+
+  RSDEstimationOMP<PointXYZ, Normal, PrincipalRadiiRSD> rsd_omp (4);
+  rsd_omp.setInputCloud (cloud);
+  rsd_omp.setInputNormals (normals);
+  rsd_omp.setPlaneRadius (0.1);
+  rsd_omp.setSearchMethod (tree);
+  rsd_omp.setRadiusSearch (0.03);
+  rsd_omp.setSaveHistograms (true);
+  PointCloud<PrincipalRadiiRSD> rsds_omp;
+  rsd_omp.compute (rsds_omp);
+
+  // Each thread uses its own buffers, the results are the ones of the serial estimation
+  ASSERT_EQ (rsds.size (), rsds_omp.size ());
+  auto histograms = rsd.getHistograms ();
+  auto histograms_omp = rsd_omp.getHistograms ();
+  ASSERT_EQ (histograms->size (), histograms_omp->size ());
+  for (std::size_t i = 0; i < rsds.size (); ++i)
+  {
+    EXPECT_EQ (rsds[i].r_min, rsds_omp[i].r_min);
+    EXPECT_EQ (rsds[i].r_max, rsds_omp[i].r_max);
+    EXPECT_TRUE ((*histograms)[i] == (*histograms_omp)[i]);
+  }
+}
+
 /* ---[ */
 int
 main (int argc, char** argv)
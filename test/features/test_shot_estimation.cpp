@@ -45,7 +45,9 @@
 #include <pcl/features/shot_omp.h>
 #include "pcl/features/shot_lrf.h"
 #include <pcl/features/3dsc.h>
+#include <pcl/features/3dsc_omp.h>
 #include <pcl/features/usc.h>
+#include <pcl/features/usc_omp.h>
 
 using namespace pcl;
 using namespace pcl::io;
@@ -822,6 +824,85 @@ TEST (PCL, USCEstimation)
   testSHOTLocalReferenceFrame<UniqueShapeContext<PointXYZ, UniqueShapeContext1960>, PointXYZ, Normal, UniqueShapeContext1960> (cloud.makeShared (), normals, test_indices);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, 3DSCEstimationOMP)
+{
+  float meshRes = 0.002f;
+  float radius = 20.0f * meshRes;
+  float rmin = radius / 10.0f;
+  float ptDensityRad = radius / 5.0f;
+
+  PointCloud<PointXYZ>::Ptr cloudptr = cloud.makeShared ();
+
+  // Estimate normals first
+  NormalEstimation<PointXYZ, Normal> ne;
+  PointCloud<Normal>::Ptr normals (new PointCloud<Normal> ());
+  ne.setInputCloud (cloudptr);
+  ne.setSearchMethod (tree);
+  ne.setRadiusSearch (radius);
+  ne.compute (*normals);
+
+  // Every point draws its own X axis, the descriptors do not depend on the number of threads
+  PointCloud<ShapeContext1980> sc3ds[2];
+  const unsigned int nr_threads[2] = {1, 4};
+  for (int t = 0; t < 2; ++t)
+  {
+    ShapeContext3DEstimationOMP<PointXYZ, Normal, ShapeContext1980> sc3d (false, nr_threads[t]);
+    sc3d.setInputCloud (cloudptr);
+    sc3d.setInputNormals (normals);
+    sc3d.setSearchMethod (tree);
+    sc3d.setRadiusSearch (radius);
+    sc3d.setMinimalRadius (rmin);
+    sc3d.setPointDensityRadius (ptDensityRad);
+    sc3d.compute (sc3ds[t]);
+    EXPECT_EQ (sc3ds[t].size (), cloud.size ());
+  }
+
+  for (std::size_t i = 0; i < cloud.size (); ++i)
+  {
+    for (int j = 0; j < 9; ++j)
+      EXPECT_EQ (sc3ds[1][i].rf[j], 0.0f);
+    for (int j = 0; j < 1980; ++j)
+      EXPECT_EQ (sc3ds[0][i].descriptor[j], sc3ds[1][i].descriptor[j]);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, USCEstimationOMP)
+{
+  float meshRes = 0.002f;
+  float radius = 20.0f * meshRes;
+  float rmin = radius / 10.0f;
+  float ptDensityRad = radius / 5.0f;
+
+  UniqueShapeContext<PointXYZ, UniqueShapeContext1960> uscd;
+  UniqueShapeContextOMP<PointXYZ, UniqueShapeContext1960> uscd_omp (4);
+  uscd.setInputCloud (cloud.makeShared ());
+  uscd.setSearchMethod (tree);
+  uscd.setRadiusSearch (radius);
+  uscd.setMinimalRadius (rmin);
+  uscd.setPointDensityRadius (ptDensityRad);
+  uscd.setLocalRadius (radius);
+  uscd_omp.setInputCloud (cloud.makeShared ());
+  uscd_omp.setSearchMethod (tree);
+  uscd_omp.setRadiusSearch (radius);
+  uscd_omp.setMinimalRadius (rmin);
+  uscd_omp.setPointDensityRadius (ptDensityRad);
+  uscd_omp.setLocalRadius (radius);
+
+  PointCloud<UniqueShapeContext1960> uscds, uscds_omp;
+  uscd.compute (uscds);
+  uscd_omp.compute (uscds_omp);
+  ASSERT_EQ (uscds.size (), uscds_omp.size ());
+  for (std::size_t i = 0; i < uscds.size (); ++i)
+  {
+    for (int j = 0; j < 9; ++j)
+      EXPECT_EQ (uscds[i].rf[j], uscds_omp[i].rf[j]);
+    for (int j = 0; j < 1960; ++j)
+      EXPECT_EQ (uscds[i].descriptor[j], uscds_omp[i].descriptor[j]);
+  }
+}
+
 /* ---[ */
 int
 main (int argc, char** argv)
@@ -42,7 +42,9 @@
 #include <pcl/features/normal_3d.h>
 #include <pcl/io/pcd_io.h>
 #include <pcl/features/spin_image.h>
+#include <pcl/features/spin_image_omp.h>
 #include <pcl/features/intensity_spin.h>
+#include <pcl/features/intensity_spin_omp.h>
 
 using namespace pcl;
 using namespace pcl::io;
@@ -231,6 +233,60 @@ TEST (PCL, SpinImageEstimation)
   EXPECT_NEAR ((*spin_images)[300].histogram[144], 0.272542, 1e-4);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, SpinImageEstimationOMP)
+{
+  // Estimate normals first
+  double mr = 0.002;
+  NormalEstimation<PointXYZ, Normal> n;
+  PointCloud<Normal>::Ptr normals (new PointCloud<Normal> ());
+  // set parameters
+  n.setInputCloud (cloud.makeShared ());
+  pcl::IndicesPtr indicesptr (new pcl::Indices (indices));
+  n.setIndices (indicesptr);
+  n.setSearchMethod (tree);
+  n.setRadiusSearch (20 * mr);
+  n.compute (*normals);
+
+  using SpinImage = Histogram<153>;
+  SpinImageEstimation<PointXYZ, Normal, SpinImage> spin_est (8, 0.5, 16);
+  SpinImageEstimationOMP<PointXYZ, Normal, SpinImage> spin_est_omp (8, 0.5, 16, 4);
+  spin_est.setInputCloud (cloud.makeShared ());
+  spin_est.setInputNormals (normals);
+  spin_est.setIndices (indicesptr);
+  spin_est.setSearchMethod (tree);
+  spin_est.setRadiusSearch (40*mr);
+  spin_est_omp.setInputCloud (cloud.makeShared ());
+  spin_est_omp.setInputNormals (normals);
+  spin_est_omp.setIndices (indicesptr);
+  spin_est_omp.setSearchMethod (tree);
+  spin_est_omp.setRadiusSearch (40*mr);
+
+  // The parallel estimation gives the same spin-images for all the structures and domains
+  PointCloud<SpinImage> spin_images, spin_images_omp;
+  for (const bool radial : {true, false})
+  {
+    for (const bool angular : {false, true})
+    {
+      spin_est.setRadialStructure (radial);
+      spin_est.setAngularDomain (angular);
+      spin_est_omp.setRadialStructure (radial);
+      spin_est_omp.setAngularDomain (angular);
+      spin_est.compute (spin_images);
+      spin_est_omp.compute (spin_images_omp);
+
+      ASSERT_EQ (spin_images.size (), spin_images_omp.size ());
+      for (std::size_t i = 0; i < spin_images.size (); ++i)
+        for (int j = 0; j < 153; ++j)
+          EXPECT_EQ (spin_images[i].histogram[j], spin_images_omp[i].histogram[j]);
+    }
+  }
+
+  // Too few points in the support are reported with the same exception
+  spin_est_omp.setMinPointCountInNeighbourhood (static_cast<unsigned int> (cloud.size () + 1));
+  EXPECT_THROW (spin_est_omp.compute (spin_images_omp), PCLException);
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 TEST (PCL, IntensitySpinEstimation)
 {
@@ -277,6 +333,21 @@ TEST (PCL, IntensitySpinEstimation)
   {
     EXPECT_NEAR (ispin.histogram[i], correct_ispin_feature_values[i], 1e-4);
   }
+
+  // The parallel estimation gives the same descriptors
+  IntensitySpinEstimationOMP<PointXYZI, IntensitySpin> ispin_est_omp (4);
+  ispin_est_omp.setSearchMethod (treept3);
+  ispin_est_omp.setRadiusSearch (10.0);
+  ispin_est_omp.setNrDistanceBins (4);
+  ispin_est_omp.setNrIntensityBins (5);
+  ispin_est_omp.setInputCloud (cloud_xyzi.makeShared ());
+  PointCloud<IntensitySpin> ispin_output_omp;
+  ispin_est_omp.compute (ispin_output_omp);
+
+  ASSERT_EQ (ispin_output.size (), ispin_output_omp.size ());
+  for (std::size_t i = 0; i < ispin_output.size (); ++i)
+    for (int j = 0; j < 20; ++j)
+      EXPECT_EQ (ispin_output[i].histogram[j], ispin_output_omp[i].histogram[j]);
 }
 
 /* ---[ */
@@ -42,6 +42,7 @@
 #include <pcl/io/pcd_io.h>
 #include <pcl/filters/fast_bilateral.h>
 #include <pcl/filters/fast_bilateral_omp.h>
+#include <pcl/filters/bilateral.h>
 #include <pcl/console/time.h>
 
 using namespace pcl;
@@ -127,6 +128,52 @@ TEST (FastBilateralFilterOMP, Filters_Bilateral)
 
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (BilateralFilter, OrganizedWindow)
+{
+  // A noisy intensity image on a plane facing the camera, with some invalid pixels
+  PointCloud<PointXYZI>::Ptr image (new PointCloud<PointXYZI> (64, 48));
+  for (std::size_t row = 0; row < image->height; ++row)
+    for (std::size_t col = 0; col < image->width; ++col)
+    {
+      PointXYZI &point = (*image) (col, row);
+      point.x = (static_cast<float> (col) - 32.0f) * 0.01f;
+      point.y = (static_cast<float> (row) - 24.0f) * 0.01f;
+      point.z = 1.0f;
+      point.intensity = static_cast<float> ((col * 7 + row * 13) % 10) + (col < 32 ? 0.0f : 50.0f);
+      if ((row * image->width + col) % 17 == 0)
+        point.x = point.y = point.z = std::numeric_limits<float>::quiet_NaN ();
+    }
+  image->is_dense = false;
+
+  BilateralFilter<PointXYZI> bf;
+  bf.setInputCloud (image);
+  bf.setHalfSize (0.01);
+  bf.setStdDev (5.0);
+  PointCloud<PointXYZI> searched;
+  bf.filter (searched);
+
+  // The radius of 2 pixels is within the window, the neighbors are the same
+  bf.setOrganizedSearchWindow (3);
+  bf.setNumberOfThreads (0);
+  PointCloud<PointXYZI> windowed;
+  bf.filter (windowed);
+
+  ASSERT_EQ (searched.size (), windowed.size ());
+  for (std::size_t i = 0; i < image->size (); ++i)
+    if (std::isfinite ((*image)[i].z))
+      EXPECT_NEAR (searched[i].intensity, windowed[i].intensity, 1e-4);
+
+  // The intensities are smoothed but the edge between the two halves is kept
+  for (std::size_t col = 0; col < image->width; ++col)
+  {
+    if (col < 32)
+      EXPECT_LT (windowed (col, 10).intensity, 10.0f);
+    else
+      EXPECT_GT (windowed (col, 10).intensity, 49.5f);
+  }
+}
+
 /* ---[ */
 int
 main (int argc,
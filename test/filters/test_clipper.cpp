@@ -50,6 +50,8 @@
 #include <pcl/common/transforms.h>
 #include <pcl/common/eigen.h>
 
+#include <random>
+
 using namespace pcl;
 using namespace Eigen;
 
@@ -770,6 +772,50 @@ TEST (CropBox, Filters)
 
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (CropBox_Multiple, Filters)
+{
+  // A random cloud spanning several blocks of points, with a few invalid points
+  PointCloud<PointXYZ>::Ptr input (new PointCloud<PointXYZ>);
+  std::mt19937 rng (42);
+  std::uniform_real_distribution<float> dist (-2.0f, 2.0f);
+  for (int i = 0; i < 2000; ++i)
+    input->push_back (PointXYZ (dist (rng), dist (rng), dist (rng)));
+  for (std::size_t i = 3; i < input->size (); i += 101)
+    (*input)[i].y = std::numeric_limits<float>::quiet_NaN ();
+  input->is_dense = false;
+
+  std::vector<CropBox<PointXYZ>::ConstPtr> boxes;
+  for (int b = 0; b < 5; ++b)
+  {
+    CropBox<PointXYZ>::Ptr box (new CropBox<PointXYZ>);
+    box->setMin (Vector4f (-0.5f - 0.1f * b, -0.5f, -1.0f, 1.0f));
+    box->setMax (Vector4f (0.5f, 0.3f * b, 1.0f, 1.0f));
+    box->setTranslation (Vector3f (0.1f * b, 0.0f, -0.2f));
+    box->setRotation (Vector3f (0.0f, 0.2f * b, 0.1f));
+    box->setTransform (getTransformation (0.0f, 0.1f, 0.0f, 0.3f, 0.0f, 0.0f));
+    box->setNegative (b == 2);
+    boxes.push_back (box);
+  }
+
+  // The fused filter gives the same indices as the boxes applied one after the other
+  std::vector<Indices> indices;
+  cropBoxes (*input, boxes, indices);
+  ASSERT_EQ (boxes.size (), indices.size ());
+  for (std::size_t b = 0; b < boxes.size (); ++b)
+  {
+    CropBox<PointXYZ> box (*boxes[b]);
+    box.setInputCloud (input);
+    Indices expected;
+    box.filter (expected);
+    EXPECT_FALSE (expected.empty ());
+    EXPECT_EQ (expected, indices[b]);
+  }
+
+  cropBoxes (*input, std::vector<CropBox<PointXYZ>::ConstPtr> (), indices);
+  EXPECT_TRUE (indices.empty ());
+}
+
 /* ---[ */
 int
 main (int argc, char** argv)
@@ -0,0 +1,141 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved
+ */
+
+#include <pcl/test/gtest.h>
+#include <pcl/point_cloud.h>
+#include <pcl/point_types.h>
+#include <pcl/filters/crop_hull.h>
+
+#include <cmath>
+#include <random>
+
+using namespace pcl;
+
+// Points spread over [-2, 2]^3, avoiding the neighborhood of the hull surfaces
+PointCloud<PointXYZ>::Ptr
+randomPoints (std::size_t nr_points, bool flat)
+{
+  std::mt19937 rng (5);
+  std::uniform_real_distribution<float> coordinate (-2.0f, 2.0f);
+  PointCloud<PointXYZ>::Ptr cloud (new PointCloud<PointXYZ>);
+  while (cloud->size () < nr_points)
+  {
+    PointXYZ p (coordinate (rng), coordinate (rng), flat ? 0.0f : coordinate (rng));
+    const float radius = std::sqrt (p.x * p.x + p.y * p.y);
+    if (std::abs (radius - 1.0f) > 1e-2f && std::abs (std::abs (p.x) - 1.0f) > 1e-2f &&
+        std::abs (std::abs (p.y) - 1.0f) > 1e-2f && std::abs (std::abs (p.z) - 1.0f) > 1e-2f)
+      cloud->push_back (p);
+  }
+  return (cloud);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+TEST (CropHull, Polygon2D)
+{
+  // a disc of radius 1, and the square [1.5, 1.9]^2 as a second polygon
+  PointCloud<PointXYZ>::Ptr hull_cloud (new PointCloud<PointXYZ>);
+  std::vector<Vertices> polygons (2);
+  constexpr int nr_edges = 720;
+  for (int i = 0; i < nr_edges; ++i)
+  {
+    const double angle = 2.0 * M_PI * i / nr_edges;
+    polygons[0].vertices.push_back (static_cast<std::uint32_t> (hull_cloud->size ()));
+    hull_cloud->push_back (PointXYZ (static_cast<float> (std::cos (angle)), static_cast<float> (std::sin (angle)), 0.0f));
+  }
+  for (const auto &corner : {PointXYZ (1.5f, 1.5f, 0.0f), PointXYZ (1.9f, 1.5f, 0.0f), PointXYZ (1.9f, 1.9f, 0.0f), PointXYZ (1.5f, 1.9f, 0.0f)})
+  {
+    polygons[1].vertices.push_back (static_cast<std::uint32_t> (hull_cloud->size ()));
+    hull_cloud->push_back (corner);
+  }
+
+  const auto cloud = randomPoints (20000, true);
+  const auto is_inside = [] (const PointXYZ &p)
+  {
+    return (p.x * p.x + p.y * p.y < 1.0f || (p.x > 1.5f && p.x < 1.9f && p.y > 1.5f && p.y < 1.9f));
+  };
+
+  CropHull<PointXYZ> crop;
+  crop.setInputCloud (cloud);
+  crop.setHullCloud (hull_cloud);
+  crop.setHullIndices (polygons);
+  crop.setDim (2);
+  crop.setNumberOfThreads (4);
+
+  std::vector<int> inside, outside;
+  crop.filter (inside);
+  crop.setCropOutside (false);
+  crop.filter (outside);
+  ASSERT_EQ (inside.size () + outside.size (), cloud->size ());
+  for (const auto &index : inside)
+    EXPECT_TRUE (is_inside ((*cloud)[index]));
+  for (const auto &index : outside)
+    EXPECT_FALSE (is_inside ((*cloud)[index]));
+
+  PointCloud<PointXYZ> output;
+  crop.filter (output);
+  ASSERT_EQ (output.size (), outside.size ());
+  for (std::size_t i = 0; i < outside.size (); ++i)
+    EXPECT_EQ (output[i].getVector3fMap (), (*cloud)[outside[i]].getVector3fMap ());
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+TEST (CropHull, Surface3D)
+{
+  // the cube [-1, 1]^3 made of 12 triangles
+  PointCloud<PointXYZ>::Ptr hull_cloud (new PointCloud<PointXYZ>);
+  for (int i = 0; i < 8; ++i)
+    hull_cloud->push_back (PointXYZ (i & 1 ? 1.0f : -1.0f, i & 2 ? 1.0f : -1.0f, i & 4 ? 1.0f : -1.0f));
+  const std::uint32_t faces[6][4] = {{0, 1, 3, 2}, {4, 5, 7, 6}, {0, 1, 5, 4}, {2, 3, 7, 6}, {0, 2, 6, 4}, {1, 3, 7, 5}};
+  std::vector<Vertices> polygons;
+  for (const auto &face : faces)
+  {
+    Vertices triangle;
+    triangle.vertices = {face[0], face[1], face[2]};
+    polygons.push_back (triangle);
+    triangle.vertices = {face[0], face[2], face[3]};
+    polygons.push_back (triangle);
+  }
+
+  const auto cloud = randomPoints (20000, false);
+  const auto is_inside = [] (const PointXYZ &p)
+  {
+    return (std::abs (p.x) < 1.0f && std::abs (p.y) < 1.0f && std::abs (p.z) < 1.0f);
+  };
+
+  CropHull<PointXYZ> crop;
+  crop.setInputCloud (cloud);
+  crop.setHullCloud (hull_cloud);
+  crop.setHullIndices (polygons);
+  crop.setDim (3);
+
+  std::vector<int> inside, outside;
+  crop.filter (inside);
+  crop.setCropOutside (false);
+  crop.filter (outside);
+  ASSERT_EQ (inside.size () + outside.size (), cloud->size ());
+  for (const auto &index : inside)
+    EXPECT_TRUE (is_inside ((*cloud)[index]));
+  for (const auto &index : outside)
+    EXPECT_FALSE (is_inside ((*cloud)[index]));
+
+  // the result does not depend on the number of threads
+  std::vector<int> outside_parallel;
+  crop.setNumberOfThreads (4);
+  crop.filter (outside_parallel);
+  EXPECT_EQ (outside_parallel, outside);
+}
+
+/* ---[ */
+int
+main (int argc, char** argv)
+{
+  testing::InitGoogleTest (&argc, argv);
+  return (RUN_ALL_TESTS ());
+}
+/* ]--- */
@@ -43,11 +43,14 @@
 #include <pcl/io/pcd_io.h>
 #include <pcl/features/normal_3d.h>
 #include <pcl/filters/filter.h>
+#include <pcl/filters/filter_pipeline.h>
+#include <pcl/filters/crop_box.h>
 #include <pcl/filters/passthrough.h>
 #include <pcl/filters/shadowpoints.h>
 #include <pcl/filters/frustum_culling.h>
 #include <pcl/filters/sampling_surface_normal.h>
 #include <pcl/filters/voxel_grid.h>
+#include <pcl/filters/approximate_voxel_grid.h>
 #include <pcl/filters/voxel_grid_covariance.h>
 #include <pcl/filters/extract_indices.h>
 #include <pcl/filters/project_inliers.h>
@@ -62,6 +65,9 @@
 
 #include <pcl/segmentation/sac_segmentation.h>
 
+#include <random>
+#include <tuple>
+
 using namespace pcl;
 using namespace pcl::io;
 using namespace Eigen;
@@ -274,6 +280,63 @@ TEST (ExtractIndices, Filters)
   */
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (ExtractIndices_Multithreaded, Filters)
+{
+  // Unsorted, repeated and out of range indices over more points than one block of the complement
+  PointCloud<PointXYZ>::Ptr input (new PointCloud<PointXYZ>);
+  for (int i = 0; i < 150000; ++i)
+    input->push_back (PointXYZ (static_cast<float> (i), 0.0f, 0.0f));
+  pcl::IndicesPtr indices (new pcl::Indices);
+  for (int i = 149999; i >= 0; i -= 3)
+    indices->push_back (i);
+  indices->push_back (149999);
+  indices->push_back (150000);
+  indices->push_back (-1);
+  std::vector<bool> selected (input->size (), false);
+  for (const auto &index : *indices)
+    if (index >= 0 && index < static_cast<int> (input->size ()))
+      selected[index] = true;
+
+  ExtractIndices<PointXYZ> ei (true);
+  ei.setInputCloud (input);
+  ei.setIndices (indices);
+  ei.setNegative (true);
+  ei.setNumberOfThreads (4);
+  PointCloud<PointXYZ> output;
+  ei.filter (output);
+  pcl::Indices remaining;
+  for (std::size_t i = 0; i < selected.size (); ++i)
+    if (!selected[i])
+      remaining.push_back (static_cast<int> (i));
+  ASSERT_EQ (remaining.size (), output.size ());
+  for (std::size_t i = 0; i < remaining.size (); ++i)
+    EXPECT_EQ (static_cast<float> (remaining[i]), output[i].x);
+
+  // The removed indices of a normal run are the same complement
+  ei.setNegative (false);
+  pcl::Indices kept;
+  ei.filter (kept);
+  EXPECT_EQ (*indices, kept);
+  EXPECT_EQ (remaining, *ei.getRemovedIndices ());
+
+  // PCLPointCloud2
+  PCLPointCloud2::Ptr input_blob (new PCLPointCloud2);
+  toPCLPointCloud2 (*input, *input_blob);
+  ExtractIndices<PCLPointCloud2> ei2;
+  ei2.setInputCloud (input_blob);
+  ei2.setIndices (indices);
+  ei2.setNegative (true);
+  ei2.setNumberOfThreads (4);
+  PCLPointCloud2 output_blob;
+  ei2.filter (output_blob);
+  PointCloud<PointXYZ> output2;
+  fromPCLPointCloud2 (output_blob, output2);
+  ASSERT_EQ (output.size (), output2.size ());
+  for (std::size_t i = 0; i < output.size (); ++i)
+    EXPECT_EQ (output[i].x, output2[i].x);
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 TEST (PassThrough, Filters)
 {
@@ -1243,6 +1306,302 @@ TEST (VoxelGrid_XYZNormal, Filters)
 
 #endif
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (VoxelGrid_Multithreaded, Filters)
+{
+  // A large cloud with invalid points, so that every thread gets many points
+  PointCloud<PointXYZRGB>::Ptr input (new PointCloud<PointXYZRGB>);
+  std::mt19937 rng (42);
+  std::uniform_real_distribution<float> coordinate (-1.0f, 1.0f);
+  std::uniform_int_distribution<int> color (0, 255);
+  for (int i = 0; i < 200000; ++i)
+  {
+    PointXYZRGB p;
+    p.x = coordinate (rng);
+    p.y = coordinate (rng);
+    p.z = (i % 101 == 0) ? std::numeric_limits<float>::quiet_NaN () : coordinate (rng);
+    p.r = static_cast<std::uint8_t> (color (rng));
+    p.g = static_cast<std::uint8_t> (color (rng));
+    p.b = static_cast<std::uint8_t> (color (rng));
+    input->push_back (p);
+  }
+  input->is_dense = false;
+  PCLPointCloud2::Ptr input_blob (new PCLPointCloud2);
+  toPCLPointCloud2 (*input, *input_blob);
+  pcl::IndicesPtr indices (new pcl::Indices);
+  for (int i = static_cast<int> (input->size ()) - 1; i >= 0; i -= 3)
+    indices->push_back (i);
+
+  for (const bool downsample_all_data : {true, false})
+  {
+    for (int setup = 0; setup < 3; ++setup)
+    {
+      PointCloud<PointXYZRGB> output, output_mt;
+      VoxelGrid<PointXYZRGB> grid;
+      grid.setLeafSize (0.05f, 0.05f, 0.05f);
+      grid.setDownsampleAllData (downsample_all_data);
+      grid.setSaveLeafLayout (true);
+      grid.setMinimumPointsNumberPerVoxel (2);
+      grid.setInputCloud (input);
+      if (setup == 1)
+      {
+        grid.setFilterFieldName ("z");
+        grid.setFilterLimits (-0.5, 0.5);
+      }
+      else if (setup == 2)
+        grid.setIndices (indices);
+
+      grid.filter (output);
+      const std::vector<int> leaf_layout = grid.getLeafLayout ();
+      grid.setNumberOfThreads (4);
+      grid.filter (output_mt);
+
+      ASSERT_GT (output.size (), 1000u);
+      ASSERT_EQ (output.size (), output_mt.size ());
+      EXPECT_EQ (leaf_layout, grid.getLeafLayout ());
+      bool equal = true;
+      for (std::size_t i = 0; i < output.size (); ++i)
+        equal = equal && output[i].x == output_mt[i].x && output[i].y == output_mt[i].y &&
+                output[i].z == output_mt[i].z && output[i].rgba == output_mt[i].rgba;
+      EXPECT_TRUE (equal);
+
+      PCLPointCloud2 output_blob, output_blob_mt;
+      VoxelGrid<PCLPointCloud2> grid_blob;
+      grid_blob.setLeafSize (0.05f, 0.05f, 0.05f);
+      grid_blob.setDownsampleAllData (downsample_all_data);
+      grid_blob.setSaveLeafLayout (true);
+      grid_blob.setInputCloud (input_blob);
+      if (setup == 1)
+      {
+        grid_blob.setFilterFieldName ("z");
+        grid_blob.setFilterLimits (-0.5, 0.5);
+      }
+      else if (setup == 2)
+        continue;
+
+      grid_blob.filter (output_blob);
+      const std::vector<int> leaf_layout_blob = grid_blob.getLeafLayout ();
+      grid_blob.setNumberOfThreads (4);
+      grid_blob.filter (output_blob_mt);
+
+      EXPECT_GT (output_blob.width, 1000u);
+      EXPECT_EQ (output_blob.width, output_blob_mt.width);
+      EXPECT_EQ (leaf_layout_blob, grid_blob.getLeafLayout ());
+      EXPECT_TRUE (output_blob.data == output_blob_mt.data);
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (VoxelGrid_Hashing, Filters)
+{
+  PointCloud<PointXYZRGB>::Ptr input (new PointCloud<PointXYZRGB>);
+  std::mt19937 rng (7);
+  std::uniform_real_distribution<float> coordinate (-1.0f, 1.0f);
+  std::uniform_int_distribution<int> color (0, 255);
+  for (int i = 0; i < 20000; ++i)
+  {
+    PointXYZRGB p;
+    p.x = coordinate (rng);
+    p.y = coordinate (rng);
+    p.z = (i % 101 == 0) ? std::numeric_limits<float>::quiet_NaN () : coordinate (rng);
+    p.r = static_cast<std::uint8_t> (color (rng));
+    p.g = static_cast<std::uint8_t> (color (rng));
+    p.b = static_cast<std::uint8_t> (color (rng));
+    input->push_back (p);
+  }
+  input->is_dense = false;
+  PCLPointCloud2::Ptr input_blob (new PCLPointCloud2);
+  toPCLPointCloud2 (*input, *input_blob);
+
+  // The centroids are the same, only their order differs
+  const auto sorted = [] (PointCloud<PointXYZRGB> cloud)
+  {
+    std::sort (cloud.begin (), cloud.end (), [] (const PointXYZRGB &a, const PointXYZRGB &b)
+    {
+      return (std::make_tuple (a.x, a.y, a.z) < std::make_tuple (b.x, b.y, b.z));
+    });
+    return (cloud);
+  };
+  const auto expect_same_points = [] (const PointCloud<PointXYZRGB> &a, const PointCloud<PointXYZRGB> &b)
+  {
+    ASSERT_EQ (a.size (), b.size ());
+    for (std::size_t i = 0; i < a.size (); ++i)
+    {
+      EXPECT_EQ (a[i].x, b[i].x);
+      EXPECT_EQ (a[i].y, b[i].y);
+      EXPECT_EQ (a[i].z, b[i].z);
+      EXPECT_EQ (a[i].rgba, b[i].rgba);
+    }
+  };
+
+  PointCloud<PointXYZRGB> output, output_hashed;
+  VoxelGrid<PointXYZRGB> grid;
+  grid.setLeafSize (0.1f, 0.1f, 0.1f);
+  grid.setMinimumPointsNumberPerVoxel (3);
+  grid.setFilterFieldName ("z");
+  grid.setFilterLimits (-0.5, 0.5);
+  grid.setInputCloud (input);
+  grid.filter (output);
+  grid.setVoxelHashing (true);
+  EXPECT_TRUE (grid.getVoxelHashing ());
+  grid.filter (output_hashed);
+  EXPECT_GT (output.size (), 500u);
+  expect_same_points (sorted (output), sorted (output_hashed));
+
+  PCLPointCloud2 output_blob, output_blob_hashed;
+  VoxelGrid<PCLPointCloud2> grid_blob;
+  grid_blob.setLeafSize (0.1f, 0.1f, 0.1f);
+  grid_blob.setInputCloud (input_blob);
+  grid_blob.filter (output_blob);
+  grid_blob.setVoxelHashing (true);
+  grid_blob.filter (output_blob_hashed);
+  PointCloud<PointXYZRGB> output_from_blob, output_from_blob_hashed;
+  fromPCLPointCloud2 (output_blob, output_from_blob);
+  fromPCLPointCloud2 (output_blob_hashed, output_from_blob_hashed);
+  EXPECT_GT (output_from_blob.size (), 1000u);
+  expect_same_points (sorted (output_from_blob), sorted (output_from_blob_hashed));
+
+  // A grid of 80000^3 leaves, too large for 32 bit indices: the voxels are found in order of appearance
+  PointCloud<PointXYZ>::Ptr sparse (new PointCloud<PointXYZ>);
+  const std::vector<Eigen::Vector3f> corners = {{-20000.0f, 0.0f, 5.0f}, {20000.0f, -20000.0f, 0.0f}, {3.0f, 20000.0f, -20000.0f}};
+  for (const float offset : {0.1f, 0.2f, 0.3f})
+    for (const auto &corner : corners)
+      sparse->push_back (PointXYZ (corner[0] + offset, corner[1] + offset, corner[2] + offset));
+  PointCloud<PointXYZ> sparse_output;
+  VoxelGrid<PointXYZ> sparse_grid;
+  sparse_grid.setLeafSize (0.5f, 0.5f, 0.5f);
+  sparse_grid.setVoxelHashing (true);
+  sparse_grid.setInputCloud (sparse);
+  sparse_grid.filter (sparse_output);
+  ASSERT_EQ (sparse_output.size (), corners.size ());
+  for (std::size_t i = 0; i < corners.size (); ++i)
+    for (int d = 0; d < 3; ++d)
+      EXPECT_NEAR (sparse_output[i].getVector3fMap ()[d], corners[i][d] + 0.2f, 1e-2);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (VoxelGrid_CompactPointCloud, Filters)
+{
+  PointCloud<PointXYZRGB>::Ptr input (new PointCloud<PointXYZRGB>);
+  std::mt19937 rng (11);
+  std::uniform_real_distribution<float> coordinate (-1.0f, 1.0f);
+  for (int i = 0; i < 20000; ++i)
+  {
+    PointXYZRGB p;
+    p.x = coordinate (rng) + 10.0f;
+    p.y = coordinate (rng);
+    p.z = (i % 97 == 0) ? std::numeric_limits<float>::quiet_NaN () : coordinate (rng);
+    p.rgba = static_cast<std::uint32_t> (rng ());
+    input->push_back (p);
+  }
+  input->is_dense = false;
+
+  const auto expect_same_points = [] (const PointCloud<PointXYZRGB> &a, const PointCloud<PointXYZRGB> &b)
+  {
+    ASSERT_EQ (a.size (), b.size ());
+    for (std::size_t i = 0; i < a.size (); ++i)
+    {
+      EXPECT_EQ (a[i].getVector3fMap (), b[i].getVector3fMap ());
+      EXPECT_EQ (a[i].rgba, b[i].rgba);
+    }
+  };
+
+  VoxelGrid<PointXYZRGB> grid;
+  grid.setLeafSize (0.1f, 0.1f, 0.1f);
+  grid.setFilterFieldName ("z");
+  grid.setFilterLimits (-0.5, 0.5);
+
+  // Packed float coordinates are exact, the compact cloud gives the same centroids as the original one
+  PackedPointCloud packed;
+  ASSERT_TRUE (packed.assign (*input));
+  PointCloud<PointXYZRGB> output, output_packed;
+  grid.setInputCloud (input);
+  grid.filter (output);
+  grid.filter (packed, output_packed);
+  EXPECT_GT (output.size (), 1000u);
+  expect_same_points (output, output_packed);
+
+  // Quantized coordinates give the same centroids as the decoded cloud, for all the ways to bin the points
+  QuantizedPointCloud16 quantized;
+  ASSERT_TRUE (quantized.assign (*input));
+  PointCloud<PointXYZRGB>::Ptr decoded (new PointCloud<PointXYZRGB>);
+  quantized.decode (*decoded);
+  grid.setInputCloud (decoded);
+  for (const bool hashing : {false, true})
+  {
+    grid.setVoxelHashing (hashing);
+    grid.setNumberOfThreads (hashing ? 1 : 2);
+    PointCloud<PointXYZRGB> output_decoded, output_quantized;
+    grid.filter (output_decoded);
+    grid.filter (quantized, output_quantized);
+    EXPECT_GT (output_quantized.size (), 1000u);
+    expect_same_points (output_decoded, output_quantized);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (ApproximateVoxelGrid_ExactVoxels, Filters)
+{
+  PointCloud<PointXYZRGB>::Ptr input (new PointCloud<PointXYZRGB>);
+  std::mt19937 rng (11);
+  std::uniform_real_distribution<float> coordinate (-1.0f, 1.0f);
+  std::uniform_int_distribution<int> color (0, 255);
+  for (int i = 0; i < 20000; ++i)
+  {
+    PointXYZRGB p;
+    p.x = coordinate (rng);
+    p.y = coordinate (rng);
+    p.z = (i % 101 == 0) ? std::numeric_limits<float>::quiet_NaN () : coordinate (rng);
+    p.r = static_cast<std::uint8_t> (color (rng));
+    p.g = static_cast<std::uint8_t> (color (rng));
+    p.b = static_cast<std::uint8_t> (color (rng));
+    input->push_back (p);
+  }
+  input->is_dense = false;
+
+  // The history buffer splits the voxels which collide, the exact voxels are those of VoxelGrid
+  ApproximateVoxelGrid<PointXYZRGB> approximate;
+  approximate.setLeafSize (0.1f, 0.1f, 0.1f);
+  approximate.setInputCloud (input);
+  PointCloud<PointXYZRGB> approximate_output, exact_output;
+  approximate.filter (approximate_output);
+  approximate.setExactVoxels (true);
+  EXPECT_TRUE (approximate.getExactVoxels ());
+  approximate.filter (exact_output);
+
+  PointCloud<PointXYZRGB> grid_output;
+  VoxelGrid<PointXYZRGB> grid;
+  grid.setLeafSize (0.1f, 0.1f, 0.1f);
+  grid.setInputCloud (input);
+  grid.setVoxelHashing (true);
+  grid.filter (grid_output);
+
+  EXPECT_GT (approximate_output.size (), exact_output.size ());
+  ASSERT_EQ (grid_output.size (), exact_output.size ());
+  for (std::size_t i = 0; i < grid_output.size (); ++i)
+  {
+    // Both are in order of first appearance of the voxels
+    EXPECT_NEAR (grid_output[i].x, exact_output[i].x, 1e-5);
+    EXPECT_NEAR (grid_output[i].y, exact_output[i].y, 1e-5);
+    EXPECT_NEAR (grid_output[i].z, exact_output[i].z, 1e-5);
+    EXPECT_NEAR (grid_output[i].r, exact_output[i].r, 1);
+    EXPECT_NEAR (grid_output[i].g, exact_output[i].g, 1);
+    EXPECT_NEAR (grid_output[i].b, exact_output[i].b, 1);
+  }
+
+  // The result does not depend on the number of threads
+  approximate.setNumberOfThreads (3);
+  PointCloud<PointXYZRGB> threads_output;
+  approximate.filter (threads_output);
+  ASSERT_EQ (exact_output.size (), threads_output.size ());
+  for (std::size_t i = 0; i < exact_output.size (); ++i)
+  {
+    EXPECT_EQ (exact_output[i].getVector3fMap (), threads_output[i].getVector3fMap ());
+    EXPECT_EQ (exact_output[i].rgba, threads_output[i].rgba);
+  }
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 TEST (VoxelGridCovariance, Filters)
 {
@@ -1547,6 +1906,180 @@ TEST (StatisticalOutlierRemoval, Filters)
   EXPECT_NEAR (output[output.size () - 1].z, -0.0444, 1e-4);
 }
 
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (OutlierRemoval_Multithreaded, Filters)
+{
+  // Add a few invalid points, so that the radius search is used
+  PointCloud<PointXYZ>::Ptr cloud_nan (new PointCloud<PointXYZ> (*cloud));
+  for (std::size_t i = 0; i < cloud_nan->size (); i += 23)
+    (*cloud_nan)[i].x = std::numeric_limits<float>::quiet_NaN ();
+  cloud_nan->is_dense = false;
+
+  for (const bool negative : {false, true})
+  {
+    StatisticalOutlierRemoval<PointXYZ> sor (true);
+    sor.setInputCloud (cloud_nan);
+    sor.setMeanK (20);
+    sor.setStddevMulThresh (0.5);
+    sor.setNegative (negative);
+    pcl::Indices sor_indices, sor_indices_mt;
+    sor.filter (sor_indices);
+    const pcl::Indices sor_removed = *sor.getRemovedIndices ();
+    sor.setNumberOfThreads (4);
+    sor.filter (sor_indices_mt);
+    EXPECT_FALSE (sor_indices.empty ());
+    EXPECT_EQ (sor_indices, sor_indices_mt);
+    EXPECT_EQ (sor_removed, *sor.getRemovedIndices ());
+
+    // The same result when the neighbors are searched in Morton order
+    pcl::Indices sor_indices_ordered;
+    sor.setSpatialQueryOrder (true);
+    sor.filter (sor_indices_ordered);
+    EXPECT_EQ (sor_indices, sor_indices_ordered);
+    EXPECT_EQ (sor_removed, *sor.getRemovedIndices ());
+
+    for (const auto &input : {cloud, cloud_nan})
+    {
+      RadiusOutlierRemoval<PointXYZ> ror (true);
+      ror.setInputCloud (input);
+      ror.setRadiusSearch (0.02);
+      ror.setMinNeighborsInRadius (14);
+      ror.setNegative (negative);
+      pcl::Indices ror_indices, ror_indices_mt;
+      ror.filter (ror_indices);
+      const pcl::Indices ror_removed = *ror.getRemovedIndices ();
+      ror.setNumberOfThreads (4);
+      ror.filter (ror_indices_mt);
+      EXPECT_FALSE (ror_indices.empty ());
+      EXPECT_EQ (ror_indices, ror_indices_mt);
+      EXPECT_EQ (ror_removed, *ror.getRemovedIndices ());
+    }
+  }
+}
+//////////////////////////////////////////////////////////////////////////////////////////////
+TEST (OutlierRemoval_OrganizedWindow, Filters)
+{
+  // A flat organized grid, with a few invalid points and a few points lifted off the plane
+  PointCloud<PointXYZ>::Ptr grid (new PointCloud<PointXYZ> (64, 48));
+  for (std::size_t r = 0; r < grid->height; ++r)
+    for (std::size_t c = 0; c < grid->width; ++c)
+      (*grid) (c, r) = PointXYZ (0.01f * static_cast<float> (c), 0.01f * static_cast<float> (r), 1.0f);
+  for (std::size_t i = 7; i < grid->size (); i += 97)
+    (*grid)[i].x = std::numeric_limits<float>::quiet_NaN ();
+  const pcl::Indices outliers = {400, 1210, 2000, 2650};
+  for (const auto &i : outliers)
+    (*grid)[i].z = 1.5f;
+  grid->is_dense = false;
+
+  for (const unsigned int nr_threads : {1u, 4u})
+  {
+    StatisticalOutlierRemoval<PointXYZ> sor (true);
+    sor.setInputCloud (grid);
+    sor.setMeanK (8);
+    sor.setStddevMulThresh (1.0);
+    sor.setOrganizedSearchWindow (2);
+    sor.setNumberOfThreads (nr_threads);
+    EXPECT_EQ (2u, sor.getOrganizedSearchWindow ());
+    pcl::Indices sor_indices;
+    sor.filter (sor_indices);
+    pcl::Indices sor_removed = *sor.getRemovedIndices ();
+    for (const auto &i : outliers)
+      EXPECT_NE (sor_removed.end (), std::find (sor_removed.begin (), sor_removed.end (), i));
+    EXPECT_EQ (grid->size (), sor_indices.size () + sor_removed.size ());
+    EXPECT_GT (sor_indices.size (), grid->size () * 9 / 10);
+
+    RadiusOutlierRemoval<PointXYZ> ror (true);
+    ror.setInputCloud (grid);
+    ror.setRadiusSearch (0.025);
+    ror.setMinNeighborsInRadius (4);
+    ror.setNumberOfThreads (nr_threads);
+    pcl::Indices ror_indices, ror_window_indices;
+    ror.filter (ror_indices);
+    // All the neighbors in the radius are in the window, so the result has to be the exact one
+    ror.setOrganizedSearchWindow (3);
+    ror.filter (ror_window_indices);
+    EXPECT_EQ (ror_indices, ror_window_indices);
+    pcl::Indices ror_removed = *ror.getRemovedIndices ();
+    for (const auto &i : outliers)
+      EXPECT_NE (ror_removed.end (), std::find (ror_removed.begin (), ror_removed.end (), i));
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+TEST (FilterPipeline, Filters)
+{
+  PassThrough<PointXYZ>::Ptr pass (new PassThrough<PointXYZ>);
+  pass->setFilterFieldName ("z");
+  pass->setFilterLimits (0.0f, 0.05f);
+  CropBox<PointXYZ>::Ptr crop (new CropBox<PointXYZ>);
+  crop->setMin (Vector4f (-0.08f, 0.05f, -1.0f, 1.0f));
+  crop->setMax (Vector4f (0.05f, 0.2f, 1.0f, 1.0f));
+  VoxelGrid<PointXYZ>::Ptr grid (new VoxelGrid<PointXYZ>);
+  grid->setLeafSize (0.005f, 0.005f, 0.005f);
+  StatisticalOutlierRemoval<PointXYZ>::Ptr sor (new StatisticalOutlierRemoval<PointXYZ>);
+  sor->setMeanK (10);
+  sor->setStddevMulThresh (1.0);
+  const auto below_y = [] (const PointCloud<PointXYZ> &points, pcl::index_t i) { return (points[i].y < 0.18f); };
+  const auto left_x = [] (const PointCloud<PointXYZ> &points, pcl::index_t i) { return (points[i].x < 0.04f); };
+
+  // The same filters chained by hand, with intermediate clouds
+  PointCloud<PointXYZ>::Ptr step1 (new PointCloud<PointXYZ>), step2 (new PointCloud<PointXYZ>),
+                            step3 (new PointCloud<PointXYZ>), step4 (new PointCloud<PointXYZ>);
+  pass->setInputCloud (cloud);
+  pass->filter (*step1);
+  for (pcl::index_t i = 0; i < static_cast<pcl::index_t> (step1->size ()); ++i)
+    if (below_y (*step1, i) && left_x (*step1, i))
+      step2->push_back ((*step1)[i]);
+  crop->setInputCloud (step2);
+  crop->filter (*step3);
+  grid->setInputCloud (step3);
+  grid->filter (*step4);
+  PointCloud<PointXYZ> expected;
+  sor->setInputCloud (step4);
+  sor->filter (expected);
+  ASSERT_GT (expected.size (), 0);
+
+  FilterPipeline<PointXYZ> pipeline;
+  pipeline.addFilter (pass);
+  pipeline.addPredicate (below_y);
+  pipeline.addPredicate (left_x);
+  pipeline.addFilter (crop);
+  pipeline.addFilter (grid);
+  pipeline.addFilter (sor);
+  EXPECT_EQ (5, pipeline.getNumberOfStages ());
+  pipeline.setInputCloud (cloud);
+  PointCloud<PointXYZ> output;
+  pipeline.filter (output);
+  ASSERT_EQ (expected.size (), output.size ());
+  for (std::size_t i = 0; i < output.size (); ++i)
+  {
+    EXPECT_EQ (expected[i].x, output[i].x);
+    EXPECT_EQ (expected[i].y, output[i].y);
+    EXPECT_EQ (expected[i].z, output[i].z);
+  }
+
+  // Without the voxel grid, the result is a subset of the input
+  FilterPipeline<PointXYZ> subset (true);
+  subset.addFilter (pass);
+  subset.addPredicate (below_y);
+  subset.addFilter (crop);
+  subset.setInputCloud (cloud);
+  pcl::Indices indices;
+  subset.filter (indices);
+  EXPECT_FALSE (indices.empty ());
+  EXPECT_EQ (cloud->size (), indices.size () + subset.getRemovedIndices ()->size ());
+  for (const auto &index : indices)
+  {
+    EXPECT_TRUE ((*cloud)[index].z >= 0.0f && (*cloud)[index].z <= 0.05f);
+    EXPECT_LT ((*cloud)[index].y, 0.18f);
+  }
+
+  // The voxel grid creates new points, which can not be given as input indices
+  pipeline.filter (indices);
+  EXPECT_TRUE (indices.empty ());
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////
 TEST (ConditionalRemoval, Filters)
 {
@@ -1643,6 +2176,81 @@ TEST (ConditionalRemoval, Filters)
   EXPECT_EQ (num_not_nan, cloud->size()-condrem_.getRemovedIndices()->size());
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////
+TEST (ConditionalRemoval_Compiled, Filters)
+{
+  // An organized cloud with fields of several types, and a few invalid points
+  PointCloud<PointXYZRGBL>::Ptr input (new PointCloud<PointXYZRGBL> (40, 30));
+  std::mt19937 rng (7);
+  std::uniform_real_distribution<float> coordinate (-1.0f, 1.0f);
+  std::uniform_int_distribution<int> byte (0, 255);
+  for (auto &point : *input)
+  {
+    point.x = coordinate (rng);
+    point.y = coordinate (rng);
+    point.z = coordinate (rng);
+    point.r = static_cast<std::uint8_t> (byte (rng));
+    point.g = static_cast<std::uint8_t> (byte (rng));
+    point.b = static_cast<std::uint8_t> (byte (rng));
+    point.label = static_cast<std::uint32_t> (byte (rng) % 4);
+  }
+  for (std::size_t i = 0; i < input->size (); i += 37)
+    (*input)[i].z = std::numeric_limits<float>::quiet_NaN ();
+  input->is_dense = false;
+
+  // (x > -0.5 && z < 0.5 && label == 3) || (y <= 0 && r > 100)
+  ConditionAnd<PointXYZRGBL>::Ptr first (new ConditionAnd<PointXYZRGBL> ());
+  first->addComparison (FieldComparison<PointXYZRGBL>::ConstPtr (new FieldComparison<PointXYZRGBL> ("x", ComparisonOps::GT, -0.5)));
+  first->addComparison (FieldComparison<PointXYZRGBL>::ConstPtr (new FieldComparison<PointXYZRGBL> ("z", ComparisonOps::LT, 0.5)));
+  first->addComparison (FieldComparison<PointXYZRGBL>::ConstPtr (new FieldComparison<PointXYZRGBL> ("label", ComparisonOps::EQ, 3)));
+  ConditionAnd<PointXYZRGBL>::Ptr second (new ConditionAnd<PointXYZRGBL> ());
+  second->addComparison (FieldComparison<PointXYZRGBL>::ConstPtr (new FieldComparison<PointXYZRGBL> ("y", ComparisonOps::LE, 0.0)));
+  second->addComparison (PackedRGBComparison<PointXYZRGBL>::ConstPtr (new PackedRGBComparison<PointXYZRGBL> ("r", ComparisonOps::GT, 100)));
+  ConditionOr<PointXYZRGBL>::Ptr condition (new ConditionOr<PointXYZRGBL> ());
+  condition->addCondition (first);
+  condition->addCondition (second);
+
+  for (const bool keep_organized : {false, true})
+  {
+    ConditionalRemoval<PointXYZRGBL> reference (true);
+    reference.setCondition (condition);
+    reference.setCompiledCondition (false);
+    reference.setKeepOrganized (keep_organized);
+    reference.setInputCloud (input);
+    PointCloud<PointXYZRGBL> expected;
+    reference.filter (expected);
+    const pcl::Indices expected_removed = *reference.getRemovedIndices ();
+    EXPECT_GT (expected_removed.size (), input->size () / 4);
+    EXPECT_LT (expected_removed.size (), input->size () * 3 / 4);
+
+    for (const unsigned int nr_threads : {1u, 4u})
+    {
+      ConditionalRemoval<PointXYZRGBL> filter (true);
+      filter.setCondition (condition);
+      filter.setKeepOrganized (keep_organized);
+      filter.setNumberOfThreads (nr_threads);
+      filter.setInputCloud (input);
+      EXPECT_TRUE (filter.getCompiledCondition ());
+      PointCloud<PointXYZRGBL> output;
+      filter.filter (output);
+      EXPECT_EQ (expected_removed, *filter.getRemovedIndices ());
+      ASSERT_EQ (expected.size (), output.size ());
+      EXPECT_EQ (expected.width, output.width);
+      for (std::size_t i = 0; i < output.size (); ++i)
+      {
+        if (std::isnan (expected[i].x))
+        {
+          EXPECT_TRUE (std::isnan (output[i].x));
+          continue;
+        }
+        EXPECT_EQ (expected[i].x, output[i].x);
+        EXPECT_EQ (expected[i].label, output[i].label);
+        EXPECT_EQ (expected[i].rgba, output[i].rgba);
+      }
+    }
+  }
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////
 TEST (ConditionalRemovalSetIndices, Filters)
 {
@@ -1793,6 +2401,21 @@ TEST (SamplingSurfaceNormal, Filters)
     EXPECT_NEAR (point.normal[1], 0, 1e-3);
     EXPECT_NEAR (point.normal[2], 1, 1e-3);
   }
+
+  // The sampling only depends on the seed, not on the number of threads
+  PointCloud <PointNormal> outcloud_serial, outcloud_parallel;
+  ssn_filter.setSample (20);
+  ssn_filter.setSeed (7);
+  ssn_filter.filter (outcloud_serial);
+  ssn_filter.setSeed (7);
+  ssn_filter.setNumberOfThreads (4);
+  ssn_filter.filter (outcloud_parallel);
+  ASSERT_EQ (outcloud_serial.size (), outcloud_parallel.size ());
+  for (std::size_t i = 0; i < outcloud_serial.size (); ++i)
+  {
+    EXPECT_EQ (outcloud_serial[i].getVector3fMap (), outcloud_parallel[i].getVector3fMap ());
+    EXPECT_EQ (outcloud_serial[i].getNormalVector3fMap (), outcloud_parallel[i].getNormalVector3fMap ());
+  }
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////
@@ -2139,6 +2762,20 @@ TEST (MedianFilter, Filters)
   EXPECT_NEAR (1.177000045f, out_3(128, 128).z, 1e-5);
   EXPECT_NEAR (0.778999984f, out_3(256, 256).z, 1e-5);
   EXPECT_NEAR (0.703000009f, out_3(428, 300).z, 1e-5);
+
+  // The depths are measured in millimeters, the sliding histograms give the same medians
+  median_filter_xyzrgb.setDepthResolution (0.001f);
+  median_filter_xyzrgb.setNumberOfThreads (0);
+  PointCloud<PointXYZRGB> out_4;
+  median_filter_xyzrgb.filter (out_4);
+  ASSERT_EQ (out_3.size (), out_4.size ());
+  for (std::size_t i = 0; i < out_3.size (); ++i)
+  {
+    if (std::isfinite (out_3[i].z))
+      EXPECT_NEAR (out_3[i].z, out_4[i].z, 1e-4);
+    else
+      EXPECT_FALSE (std::isfinite (out_4[i].z));
+  }
 }
 
 
@@ -80,6 +80,14 @@ TEST (CovarianceSampling, Filters)
   // Ensure it respects the requested sampling size
   EXPECT_EQ (static_cast<unsigned int> (cloud_walls_normals->size ()) / 4, walls_indices->size ());
 
+  // The sampling does not depend on the number of threads
+  std::vector<int> walls_indices_parallel;
+  covariance_sampling.setIndices (IndicesPtr ());
+  covariance_sampling.setNumberOfThreads (4);
+  covariance_sampling.filter (walls_indices_parallel);
+  EXPECT_EQ (*walls_indices, walls_indices_parallel);
+  covariance_sampling.setNumberOfThreads (1);
+
   covariance_sampling.setInputCloud (cloud_turtle_normals);
   covariance_sampling.setNormals (cloud_turtle_normals);
   covariance_sampling.setIndices (IndicesPtr ());
@@ -142,6 +150,12 @@ TEST (NormalSpaceSampling, Filters)
   EXPECT_EQ (8u, walls_indices->size ());
   for (const auto& bucket : buckets)
     EXPECT_EQ (1u, bucket.size ());
+
+  // The sampling only depends on the seed, not on the number of threads
+  Indices indices_parallel;
+  normal_space_sampling.setNumberOfThreads (4);
+  normal_space_sampling.filter (indices_parallel);
+  EXPECT_EQ (*walls_indices, indices_parallel);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
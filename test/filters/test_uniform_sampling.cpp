@@ -41,6 +41,11 @@
 #include <pcl/filters/uniform_sampling.h>
 #include <pcl/point_types.h>
 
+#include <cmath>
+#include <limits>
+#include <set>
+#include <tuple>
+
 TEST(UniformSampling, extractRemovedIndices)
 {
   using namespace pcl::common;
@@ -74,6 +79,46 @@ TEST(UniformSampling, extractRemovedIndices)
   ASSERT_TRUE(removed_indices_set.size() == removed_indices->size());
 }
 
+TEST(UniformSampling, threads)
+{
+  using namespace pcl::common;
+  const int SEED = 4321;
+  CloudGenerator<pcl::PointXYZ, UniformGenerator<float>> generator;
+  UniformGenerator<float>::Parameters params(-2, 2, SEED);
+  generator.setParameters(params);
+  pcl::PointCloud<pcl::PointXYZ>::Ptr xyz(new pcl::PointCloud<pcl::PointXYZ>);
+  generator.fill(200, 100, *xyz);
+  (*xyz)[10].x = std::numeric_limits<float>::quiet_NaN();
+  xyz->is_dense = false;
+
+  pcl::UniformSampling<pcl::PointXYZ> us(true);
+  us.setInputCloud(xyz);
+  us.setRadiusSearch(0.25);
+  pcl::PointCloud<pcl::PointXYZ> output;
+  us.filter(output);
+  const std::size_t nr_removed = us.getRemovedIndices()->size();
+  EXPECT_EQ(output.size() + nr_removed, xyz->size());
+
+  // Every voxel is sampled once
+  std::set<std::tuple<int, int, int>> voxels;
+  for (const auto& point : output)
+    voxels.emplace(static_cast<int>(std::floor(point.x / 0.25f)),
+                   static_cast<int>(std::floor(point.y / 0.25f)),
+                   static_cast<int>(std::floor(point.z / 0.25f)));
+  EXPECT_EQ(voxels.size(), output.size());
+
+  // The result does not depend on the number of threads
+  for (const unsigned int nr_threads : {2u, 3u, 8u}) {
+    us.setNumberOfThreads(nr_threads);
+    pcl::PointCloud<pcl::PointXYZ> output_threads;
+    us.filter(output_threads);
+    ASSERT_EQ(output.size(), output_threads.size());
+    for (std::size_t i = 0; i < output.size(); ++i)
+      EXPECT_EQ(output[i].getVector3fMap(), output_threads[i].getVector3fMap());
+    EXPECT_EQ(nr_removed, us.getRemovedIndices()->size());
+  }
+}
+
 int
 main(int argc, char** argv)
 {
@@ -0,0 +1,110 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved
+ */
+
+#include <pcl/test/gtest.h>
+#include <pcl/point_cloud.h>
+#include <pcl/point_types.h>
+#include <pcl/filters/voxel_grid_occlusion_estimation.h>
+
+#include <algorithm>
+
+using namespace pcl;
+
+using VoxelVector = std::vector<Eigen::Vector3i, Eigen::aligned_allocator<Eigen::Vector3i> >;
+
+// A wall at x = 2, a back wall at x = 4, and a few points at x = 0 extending the grid towards the sensor
+PointCloud<PointXYZ>::Ptr
+makeScene ()
+{
+  PointCloud<PointXYZ>::Ptr cloud (new PointCloud<PointXYZ>);
+  for (float y = -1.0f; y <= 1.0f; y += 0.05f)
+    for (float z = -1.0f; z <= 1.0f; z += 0.05f)
+    {
+      cloud->push_back (PointXYZ (2.05f, y, z));
+      cloud->push_back (PointXYZ (4.05f, 2.0f * y, 2.0f * z));
+    }
+  for (float y : {-2.0f, 2.0f})
+    for (float z : {-2.0f, 2.0f})
+      cloud->push_back (PointXYZ (0.05f, y, z));
+  cloud->sensor_origin_ = Eigen::Vector4f (-3.0f, 0.01f, 0.02f, 0.0f);
+  return (cloud);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+TEST (VoxelGridOcclusionEstimation, OcclusionEstimationAll)
+{
+  VoxelGridOcclusionEstimation<PointXYZ> estimation;
+  estimation.setInputCloud (makeScene ());
+  estimation.setLeafSize (0.1f, 0.1f, 0.1f);
+  estimation.initializeVoxelGrid ();
+
+  VoxelVector occluded;
+  ASSERT_EQ (estimation.occlusionEstimationAll (occluded), 0);
+  ASSERT_FALSE (occluded.empty ());
+
+  // the voxels right behind the center of the wall are occluded, those in front of it are not
+  const auto contains = [&occluded] (const Eigen::Vector3i &ijk)
+  {
+    return (std::find (occluded.begin (), occluded.end (), ijk) != occluded.end ());
+  };
+  EXPECT_TRUE (contains (Eigen::Vector3i (30, 0, 0)));
+  EXPECT_FALSE (contains (Eigen::Vector3i (10, 0, 0)));
+
+  // each voxel agrees with the estimation of its own ray
+  for (const auto &ijk : {Eigen::Vector3i (30, 0, 0), Eigen::Vector3i (10, 0, 0), Eigen::Vector3i (35, 5, -3)})
+  {
+    int state = -1;
+    ASSERT_EQ (estimation.occlusionEstimation (state, ijk), 0);
+    EXPECT_EQ (state == 1, contains (ijk));
+  }
+
+  // the result does not depend on the number of threads
+  VoxelVector occluded_parallel;
+  estimation.setNumberOfThreads (4);
+  estimation.occlusionEstimationAll (occluded_parallel);
+  EXPECT_EQ (occluded_parallel, occluded);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+TEST (VoxelGridOcclusionEstimation, FreeSpaceCounts)
+{
+  VoxelGridOcclusionEstimation<PointXYZ> estimation;
+  estimation.setInputCloud (makeScene ());
+  estimation.setLeafSize (0.1f, 0.1f, 0.1f);
+  estimation.initializeVoxelGrid ();
+
+  std::vector<unsigned int> free_counts;
+  ASSERT_EQ (estimation.computeFreeSpaceCounts (free_counts), 0);
+  ASSERT_EQ (free_counts.size (), estimation.getLeafLayout ().size ());
+
+  const Eigen::Vector3i min_b = estimation.getMinBoxCoordinates ();
+  const Eigen::Vector3i divb_mul = estimation.getDivisionMultiplier ();
+  const auto count_at = [&] (const Eigen::Vector3i &ijk) { return (free_counts[(ijk - min_b).dot (divb_mul)]); };
+
+  // the rays to the walls cross the space in front of the first wall, and the
+  // rays to the back wall cross the first wall
+  EXPECT_GT (count_at (Eigen::Vector3i (10, 0, 0)), 0u);
+  EXPECT_GT (count_at (Eigen::Vector3i (20, 0, 0)), 0u);
+  // the rays end at the back wall
+  EXPECT_EQ (count_at (Eigen::Vector3i (40, 0, 0)), 0u);
+
+  std::vector<unsigned int> free_counts_parallel;
+  estimation.setNumberOfThreads (4);
+  estimation.computeFreeSpaceCounts (free_counts_parallel);
+  EXPECT_EQ (free_counts_parallel, free_counts);
+}
+
+/* ---[ */
+int
+main (int argc, char** argv)
+{
+  testing::InitGoogleTest (&argc, argv);
+  return (RUN_ALL_TESTS ());
+}
+/* ]--- */
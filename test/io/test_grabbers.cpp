@@ -99,6 +99,47 @@ TEST (PCL, PCDGrabber)
 
 }
 
+TEST (PCL, PCDGrabberSeekAndPrefetch)
+{
+  pcl::PCDGrabber<PointT> grabber (pcd_files_, 0, true);
+  std::vector<std::string> file_names;
+  std::vector<CloudT::ConstPtr> grabbed_clouds;
+  std::function<void (const std::string&)> name_fxn = [&] (const std::string& file_name) { file_names.push_back (file_name); };
+  std::function<void (const CloudT::ConstPtr&)> cloud_fxn = [&] (const CloudT::ConstPtr& cloud) { grabbed_clouds.push_back (cloud); };
+  grabber.registerCallback (name_fxn);
+  grabber.registerCallback (cloud_fxn);
+  grabber.setPrefetching (2);
+
+  // Jump into the sequence, and wrap around at its end
+  ASSERT_TRUE (grabber.seekToFrame (1));
+  for (std::size_t i = 0; i < pcd_files_.size () + 1; ++i)
+    grabber.trigger ();
+  ASSERT_EQ (file_names.size (), pcd_files_.size () + 1);
+  for (std::size_t i = 0; i < file_names.size (); ++i)
+  {
+    const std::size_t idx = (i + 1) % pcd_files_.size ();
+    EXPECT_EQ (file_names[i], pcd_files_[idx]);
+    ASSERT_EQ (grabbed_clouds[i]->size (), pcds_[idx]->size ());
+    for (std::size_t j = 0; j < pcds_[idx]->size (); j += 1000)
+      EXPECT_EQ (grabbed_clouds[i]->at (j).rgba, pcds_[idx]->at (j).rgba);
+  }
+  EXPECT_FALSE (grabber.seekToFrame (pcd_files_.size ()));
+
+  // The files are named frame_[timestamp].pcd
+  std::uint64_t first, last;
+  ASSERT_TRUE (grabber.getTimestampAtIndex (0, first));
+  ASSERT_TRUE (grabber.getTimestampAtIndex (pcd_files_.size () - 1, last));
+  EXPECT_LT (first, last);
+  file_names.clear ();
+  ASSERT_TRUE (grabber.seekToTimestamp (last + 1000));
+  grabber.setPrefetching (0);
+  grabber.trigger ();
+  grabber.trigger ();
+  ASSERT_EQ (file_names.size (), 2u);
+  EXPECT_EQ (file_names[0], pcd_files_.back ());
+  EXPECT_EQ (file_names[1], pcd_files_.front ());
+}
+
 TEST (PCL, ImageGrabberTIFF)
 {
   // Get all clouds from the grabber
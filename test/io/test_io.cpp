@@ -43,13 +43,18 @@
 #include <pcl/point_types.h>
 #include <pcl/common/io.h>
 #include <pcl/console/print.h>
+#include <pcl/io/async_loader.h>
 #include <pcl/io/auto_io.h>
+#include <pcl/io/lzf_image_stream.h>
 #include <pcl/io/pcd_io.h>
 #include <pcl/io/ply_io.h>
 #include <pcl/io/ascii_io.h>
+#include <pcl/io/ascii_parsing.h>
 #include <pcl/io/obj_io.h>
+#include <pcl/io/vtk_io.h>
 #include <fstream>
 #include <locale>
+#include <random>
 #include <stdexcept>
 
 using namespace pcl;
@@ -822,6 +827,128 @@ TEST (PCL, ASCIIRead)
   remove ("test_pcd.txt");
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, ASCIIParseNumber)
+{
+  // The fast conversion must give exactly the values of the standard one, or refuse the token
+  std::mt19937 rng (42);
+  std::uniform_real_distribution<double> mantissa (-1.0, 1.0);
+  std::uniform_int_distribution<int> exponent (-30, 30);
+  std::size_t nr_parsed = 0;
+  for (int i = 0; i < 100000; ++i)
+  {
+    std::ostringstream os;
+    os.imbue (std::locale::classic ());
+    os << std::setprecision (i % 17 + 1) << mantissa (rng) * std::pow (10.0, exponent (rng));
+    const std::string token = os.str ();
+
+    float f, expected_f;
+    double d, expected_d;
+    std::istringstream (token) >> expected_f;
+    std::istringstream (token) >> expected_d;
+    if (io::parseNumber (token.data (), token.data () + token.size (), f))
+    {
+      EXPECT_EQ (f, expected_f) << token;
+      ++nr_parsed;
+    }
+    if (io::parseNumber (token.data (), token.data () + token.size (), d))
+      EXPECT_EQ (d, expected_d) << token;
+  }
+  // Most tokens as written by the PCD writer take the fast path
+  EXPECT_GT (nr_parsed, 50000u);
+
+  float f;
+  std::int16_t i16;
+  std::uint32_t u32;
+  const auto parse = [] (const std::string &token, auto &value)
+  {
+    return (io::parseNumber (token.data (), token.data () + token.size (), value));
+  };
+  EXPECT_TRUE (parse ("nan", f));
+  EXPECT_TRUE (std::isnan (f));
+  EXPECT_TRUE (parse ("-1.5e2", f));
+  EXPECT_EQ (f, -150.0f);
+  EXPECT_FALSE (parse ("1.5x", f));
+  EXPECT_FALSE (parse ("e5", f));
+  EXPECT_FALSE (parse ("", f));
+  EXPECT_TRUE (parse ("-1234", i16));
+  EXPECT_EQ (i16, -1234);
+  EXPECT_FALSE (parse ("40000", i16));
+  EXPECT_FALSE (parse ("-1", u32));
+  EXPECT_TRUE (parse ("4294967295", u32));
+  EXPECT_EQ (u32, 4294967295u);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, ASCIIReadMultithreaded)
+{
+  PointCloud<PointXYZRGBNormal> cloud;
+  cloud.width = 5000;
+  cloud.height = 1;
+  cloud.points.resize (cloud.width);
+  std::mt19937 rng (7);
+  std::uniform_real_distribution<float> distribution (-100.0f, 100.0f);
+  for (auto &point : cloud)
+  {
+    point.getVector3fMap () = Eigen::Vector3f (distribution (rng), distribution (rng), distribution (rng));
+    point.getNormalVector3fMap () = Eigen::Vector3f (distribution (rng), distribution (rng), distribution (rng));
+    point.rgba = static_cast<std::uint32_t> (rng ());
+    point.curvature = distribution (rng);
+  }
+  cloud[10].x = std::numeric_limits<float>::quiet_NaN ();
+  cloud.is_dense = false;
+
+  PCDWriter writer;
+  writer.writeASCII ("test_pcl_io_ascii_threads.pcd", cloud, 12);
+
+  PCDReader reader;
+  PCLPointCloud2 blob_single, blob_multi;
+  EXPECT_EQ (reader.read ("test_pcl_io_ascii_threads.pcd", blob_single), 0);
+  reader.setNumberOfThreads (4);
+  EXPECT_EQ (reader.read ("test_pcl_io_ascii_threads.pcd", blob_multi), 0);
+  EXPECT_FALSE (blob_single.is_dense);
+  EXPECT_FALSE (blob_multi.is_dense);
+  EXPECT_EQ (blob_single.data, blob_multi.data);
+
+  PointCloud<PointXYZRGBNormal> cloud2;
+  fromPCLPointCloud2 (blob_multi, cloud2);
+  ASSERT_EQ (cloud2.size (), cloud.size ());
+  EXPECT_TRUE (std::isnan (cloud2[10].x));
+  for (std::size_t i = 11; i < cloud.size (); ++i)
+  {
+    EXPECT_EQ (cloud2[i].x, cloud[i].x);
+    EXPECT_EQ (cloud2[i].normal_z, cloud[i].normal_z);
+    EXPECT_EQ (cloud2[i].rgba, cloud[i].rgba);
+    EXPECT_EQ (cloud2[i].curvature, cloud[i].curvature);
+  }
+  remove ("test_pcl_io_ascii_threads.pcd");
+
+  // The same for a plain list of coordinates, with comments and invalid lines which are skipped
+  std::ofstream file ("test_pcl_io_ascii_threads.txt");
+  file << std::setprecision (9);
+  file << "# x y z\n";
+  for (std::size_t i = 0; i < cloud.size (); ++i)
+  {
+    file << cloud[i].y << ", " << cloud[i].z << "\t" << cloud[i].curvature << "\n";
+    if (i % 1000 == 0)
+      file << "1, 2\n\n";
+  }
+  file.close ();
+
+  ASCIIReader ascii_reader;
+  ascii_reader.setNumberOfThreads (4);
+  PointCloud<PointXYZ> cloud3;
+  EXPECT_GE (ascii_reader.read ("test_pcl_io_ascii_threads.txt", cloud3), 0);
+  ASSERT_EQ (cloud3.size (), cloud.size ());
+  for (std::size_t i = 0; i < cloud.size (); ++i)
+  {
+    EXPECT_EQ (cloud3[i].x, cloud[i].y);
+    EXPECT_EQ (cloud3[i].y, cloud[i].z);
+    EXPECT_EQ (cloud3[i].z, cloud[i].curvature);
+  }
+  remove ("test_pcl_io_ascii_threads.txt");
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 TEST(PCL, OBJRead)
 {
@@ -913,6 +1040,140 @@ TEST(PCL, OBJRead)
   remove ("test_obj.mtl");
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, OBJReadMesh)
+{
+  std::ofstream fs;
+  fs.open ("test_obj_mesh.obj", std::ios::binary);
+  fs << "# Faces with texture and normal indices, relative indices and tabs\r\n"
+        "v 0 0 0\r\n"
+        "v\t1.5 0 0\n"
+        "  v 1.5 1e0 0 0.5 0.5 0.5\n"
+        "v 0 1 0\n"
+        "vn 0 0 1\n"
+        "vt 0 0\n"
+        "g group\n"
+        "f 1/1/1 2/1/1 3/1/1 4/1/1\n"
+        "v 0.5 0.5 -1\n"
+        "f -1 -5\t-4\r\n"
+        "f 5//1 2//1 3//1";
+  fs.close ();
+
+  pcl::OBJReader reader;
+  pcl::PolygonMesh mesh;
+  ASSERT_EQ (0, reader.read ("test_obj_mesh.obj", mesh));
+  EXPECT_EQ (5, mesh.cloud.width);
+  ASSERT_EQ (3, mesh.polygons.size ());
+  EXPECT_EQ (std::vector<std::uint32_t> ({0, 1, 2, 3}), mesh.polygons[0].vertices);
+  EXPECT_EQ (std::vector<std::uint32_t> ({4, 0, 1}), mesh.polygons[1].vertices);
+  EXPECT_EQ (std::vector<std::uint32_t> ({4, 1, 2}), mesh.polygons[2].vertices);
+
+  pcl::PointCloud<pcl::PointNormal> cloud;
+  pcl::fromPCLPointCloud2 (mesh.cloud, cloud);
+  EXPECT_EQ (1.5f, cloud[2].x);
+  EXPECT_EQ (1.0f, cloud[2].y);
+  EXPECT_EQ (-1.0f, cloud[4].z);
+  EXPECT_EQ (1.0f, cloud[0].normal_z);
+
+  // Parsing in parallel gives the same mesh, the triangle mesh holds the faces split into triangles
+  reader.setNumberOfThreads (4);
+  pcl::PolygonMesh mesh_threads;
+  ASSERT_EQ (0, reader.read ("test_obj_mesh.obj", mesh_threads));
+  EXPECT_EQ (mesh.cloud.data, mesh_threads.cloud.data);
+  ASSERT_EQ (mesh.polygons.size (), mesh_threads.polygons.size ());
+  for (std::size_t i = 0; i < mesh.polygons.size (); ++i)
+    EXPECT_EQ (mesh.polygons[i].vertices, mesh_threads.polygons[i].vertices);
+
+  pcl::TriangleMesh triangle_mesh;
+  ASSERT_EQ (0, pcl::io::loadOBJFile ("test_obj_mesh.obj", triangle_mesh));
+  EXPECT_EQ (mesh.cloud.data, triangle_mesh.cloud.data);
+  EXPECT_EQ (std::vector<std::uint32_t> ({0, 1, 2, 0, 2, 3, 4, 0, 1, 4, 1, 2}), triangle_mesh.triangles);
+
+  // A face with an invalid index is an error
+  fs.open ("test_obj_mesh.obj");
+  fs << "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 x\n";
+  fs.close ();
+  EXPECT_EQ (-1, reader.read ("test_obj_mesh.obj", mesh));
+
+  remove ("test_obj_mesh.obj");
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, BinaryMeshWriters)
+{
+  pcl::PointCloud<pcl::PointXYZRGBNormal> cloud;
+  for (int i = 0; i < 4; ++i)
+  {
+    pcl::PointXYZRGBNormal point;
+    point.x = static_cast<float> (i);
+    point.y = static_cast<float> (i % 2);
+    point.z = 0.25f * static_cast<float> (i);
+    point.r = static_cast<std::uint8_t> (10 * i);
+    point.g = static_cast<std::uint8_t> (20 * i);
+    point.b = static_cast<std::uint8_t> (30 * i);
+    point.normal_x = point.normal_y = 0.0f;
+    point.normal_z = 1.0f;
+    point.curvature = 0.5f;
+    cloud.push_back (point);
+  }
+  pcl::TriangleMesh mesh;
+  pcl::toPCLPointCloud2 (cloud, mesh.cloud);
+  mesh.addTriangle (0, 1, 2);
+  mesh.addTriangle (2, 1, 3);
+
+  ASSERT_EQ (0, pcl::io::savePLYFileBinary ("test_mesh_binary.ply", mesh));
+  pcl::PolygonMesh ply_mesh;
+  ASSERT_EQ (0, pcl::io::loadPLYFile ("test_mesh_binary.ply", ply_mesh));
+  pcl::PointCloud<pcl::PointXYZRGBNormal> ply_cloud;
+  pcl::fromPCLPointCloud2 (ply_mesh.cloud, ply_cloud);
+  ASSERT_EQ (cloud.size (), ply_cloud.size ());
+  for (std::size_t i = 0; i < cloud.size (); ++i)
+  {
+    EXPECT_EQ (cloud[i].getVector3fMap (), ply_cloud[i].getVector3fMap ());
+    EXPECT_EQ (cloud[i].rgba & 0xffffff, ply_cloud[i].rgba & 0xffffff);
+    EXPECT_EQ (cloud[i].getNormalVector3fMap (), ply_cloud[i].getNormalVector3fMap ());
+    EXPECT_EQ (cloud[i].curvature, ply_cloud[i].curvature);
+  }
+  ASSERT_EQ (2, ply_mesh.polygons.size ());
+  EXPECT_EQ (std::vector<std::uint32_t> ({2, 1, 3}), ply_mesh.polygons[1].vertices);
+
+  // The binary VTK sections hold big endian values
+  ASSERT_EQ (0, pcl::io::saveVTKFileBinary ("test_mesh_binary.vtk", mesh));
+  std::ifstream vtk ("test_mesh_binary.vtk", std::ios::binary);
+  std::string line;
+  for (int i = 0; i < 5; ++i)
+    std::getline (vtk, line);
+  EXPECT_EQ ("POINTS 4 float", line);
+  unsigned char bytes[24];
+  vtk.read (reinterpret_cast<char*> (bytes), 24);
+  vtk.seekg (6 * 4 + 1, std::ios::cur);
+  EXPECT_EQ (0x3f, bytes[12]);  // x of the second point, 1.0f = 0x3f800000
+  EXPECT_EQ (0x80, bytes[13]);
+  std::getline (vtk, line);
+  EXPECT_EQ ("VERTICES 4 8", line);
+  vtk.seekg (8 * 4 + 1, std::ios::cur);
+  std::getline (vtk, line);
+  EXPECT_EQ ("POLYGONS 2 8", line);
+  vtk.read (reinterpret_cast<char*> (bytes), 8);
+  EXPECT_EQ (3, bytes[3]);
+  EXPECT_EQ (0, bytes[7]);
+  vtk.seekg (6 * 4 + 1, std::ios::cur);
+  std::getline (vtk, line);
+  EXPECT_EQ ("POINT_DATA 4", line);
+  std::getline (vtk, line);
+  EXPECT_EQ ("COLOR_SCALARS scalars 3", line);
+  vtk.read (reinterpret_cast<char*> (bytes), 12);
+  EXPECT_EQ (10, bytes[3]);
+  EXPECT_EQ (30, bytes[5]);
+  vtk.seekg (1, std::ios::cur);
+  std::getline (vtk, line);
+  EXPECT_EQ ("NORMALS normals float", line);
+  vtk.close ();
+
+  remove ("test_mesh_binary.ply");
+  remove ("test_mesh_binary.vtk");
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 struct PointXYZFPFH33
@@ -1236,6 +1497,289 @@ TEST (PCL, LZFInMem)
   }
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, LZFChunked)
+{
+  PointCloud<PointXYZRGBNormal> cloud, cloud2;
+  cloud.width  = 640;
+  cloud.height = 480;
+  cloud.points.resize (cloud.width * cloud.height);
+  cloud.is_dense = true;
+
+  srand (static_cast<unsigned int> (time (nullptr)));
+  const auto nr_p = cloud.size ();
+  // Randomly create a new point cloud
+  for (std::size_t i = 0; i < nr_p; ++i)
+  {
+    cloud[i].x = static_cast<float> (1024 * rand () / (RAND_MAX + 1.0));
+    cloud[i].y = static_cast<float> (1024 * rand () / (RAND_MAX + 1.0));
+    cloud[i].z = static_cast<float> (1024 * rand () / (RAND_MAX + 1.0));
+    cloud[i].normal_x = static_cast<float> (1024 * rand () / (RAND_MAX + 1.0));
+    cloud[i].normal_y = static_cast<float> (1024 * rand () / (RAND_MAX + 1.0));
+    cloud[i].normal_z = static_cast<float> (1024 * rand () / (RAND_MAX + 1.0));
+    cloud[i].rgb = static_cast<float> (1024 * rand () / (RAND_MAX + 1.0));
+  }
+  // An invalid point in the last (partial) chunk
+  cloud.back ().z = std::numeric_limits<float>::quiet_NaN ();
+  cloud.is_dense = false;
+
+  // The last chunk only holds part of the chunk size
+  PCDWriter writer;
+  writer.setNumberOfThreads (4);
+  writer.setCompressionChunkSize (10000);
+  int res = writer.writeBinaryCompressedChunked<PointXYZRGBNormal> ("test_pcl_io_compressed_chunked.pcd", cloud);
+  EXPECT_EQ (res, 0);
+
+  pcl::PCLPointCloud2 blob;
+  Eigen::Vector4f origin;
+  Eigen::Quaternionf orientation;
+  int pcd_version = -1;
+  int data_type = -1;
+  unsigned int data_idx = 0;
+  PCDReader reader;
+  res = reader.readHeader ("test_pcl_io_compressed_chunked.pcd", blob, origin, orientation, pcd_version, data_type, data_idx);
+  EXPECT_EQ (res, 0);
+  EXPECT_EQ (data_type, 3);
+
+  for (const unsigned int nr_threads : {1u, 4u})
+  {
+    reader.setNumberOfThreads (nr_threads);
+    res = reader.read<PointXYZRGBNormal> ("test_pcl_io_compressed_chunked.pcd", cloud2);
+    EXPECT_EQ (res, 0);
+
+    EXPECT_EQ (cloud2.width, cloud.width);
+    EXPECT_EQ (cloud2.height, cloud.height);
+    EXPECT_EQ (cloud2.is_dense, cloud.is_dense);
+    ASSERT_EQ (cloud2.size (), cloud.size ());
+
+    for (std::size_t i = 0; i < cloud2.size () - 1; ++i)
+    {
+      EXPECT_EQ (cloud2[i].x, cloud[i].x);
+      EXPECT_EQ (cloud2[i].y, cloud[i].y);
+      EXPECT_EQ (cloud2[i].z, cloud[i].z);
+      EXPECT_EQ (cloud2[i].normal_x, cloud[i].normal_x);
+      EXPECT_EQ (cloud2[i].normal_y, cloud[i].normal_y);
+      EXPECT_EQ (cloud2[i].normal_z, cloud[i].normal_z);
+      EXPECT_EQ (cloud2[i].rgb, cloud[i].rgb);
+    }
+    EXPECT_TRUE (std::isnan (cloud2.back ().z));
+  }
+
+  remove ("test_pcl_io_compressed_chunked.pcd");
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, PCDMappedFile)
+{
+  PointCloud<PointXYZRGBNormal> cloud;
+  cloud.width  = 64;
+  cloud.height = 48;
+  cloud.points.resize (cloud.width * cloud.height);
+  cloud.is_dense = true;
+  for (std::size_t i = 0; i < cloud.size (); ++i)
+  {
+    cloud[i].x = static_cast<float> (i);
+    cloud[i].y = static_cast<float> (i) * 2.0f;
+    cloud[i].z = static_cast<float> (i) * 3.0f;
+    cloud[i].normal_x = -static_cast<float> (i);
+    cloud[i].rgb = static_cast<float> (i % 255);
+  }
+
+  PCDWriter writer;
+  EXPECT_EQ (writer.writeBinary ("test_pcl_io_mapped.pcd", cloud), 0);
+  EXPECT_EQ (writer.writeBinaryCompressed ("test_pcl_io_mapped_compressed.pcd", cloud), 0);
+
+  PCDMappedFile file;
+  ASSERT_EQ (file.open ("test_pcl_io_mapped.pcd"), 0);
+  EXPECT_TRUE (file.isOpen ());
+  EXPECT_EQ (file.getLayout ().width, cloud.width);
+  EXPECT_EQ (file.getLayout ().height, cloud.height);
+  EXPECT_TRUE (file.getLayout ().data.empty ());
+
+  // The padding of the point type is not stored in the file
+  const auto view = file.getView<PointXYZRGBNormal> ();
+  EXPECT_FALSE (view.isDirect ());
+  ASSERT_EQ (view.size (), cloud.size ());
+  ASSERT_TRUE (view.hasXYZ ());
+  for (std::size_t i = 0; i < cloud.size (); ++i)
+  {
+    EXPECT_EQ (view.getXYZ (i), cloud[i].getVector3fMap ());
+    EXPECT_EQ (view[i].normal_x, cloud[i].normal_x);
+    EXPECT_EQ (view[i].rgb, cloud[i].rgb);
+  }
+
+  // Only the coordinates
+  PCLPointCloud2 xyz;
+  EXPECT_EQ (file.read (xyz, {"x", "y", "z"}), 0);
+  EXPECT_EQ (xyz.point_step, 3 * sizeof (float));
+  EXPECT_EQ (xyz.fields.size (), 3u);
+  EXPECT_TRUE (xyz.is_dense);
+  PointCloud<PointXYZ> cloud_xyz;
+  fromPCLPointCloud2 (xyz, cloud_xyz);
+  ASSERT_EQ (cloud_xyz.size (), cloud.size ());
+  for (std::size_t i = 0; i < cloud.size (); ++i)
+    EXPECT_EQ (cloud_xyz[i].getVector3fMap (), cloud[i].getVector3fMap ());
+  EXPECT_LT (file.read (xyz, {"x", "intensity"}), 0);
+  file.close ();
+  EXPECT_FALSE (file.isOpen ());
+
+  // Compressed files can not be mapped, but the fields can still be selected when reading
+  EXPECT_LT (file.open ("test_pcl_io_mapped_compressed.pcd"), 0);
+  PCDReader reader;
+  for (const auto &file_name : {"test_pcl_io_mapped.pcd", "test_pcl_io_mapped_compressed.pcd"})
+  {
+    PCLPointCloud2 normal_x;
+    EXPECT_EQ (reader.read (file_name, normal_x, {"normal_x", "x"}), 0);
+    EXPECT_EQ (normal_x.point_step, 2 * sizeof (float));
+    ASSERT_EQ (normal_x.fields.size (), 2u);
+    EXPECT_EQ (normal_x.fields[0].name, "normal_x");
+    EXPECT_EQ (normal_x.fields[1].offset, sizeof (float));
+    for (std::size_t i = 0; i < cloud.size (); ++i)
+    {
+      float values[2];
+      memcpy (values, &normal_x.data[i * normal_x.point_step], sizeof (values));
+      EXPECT_EQ (values[0], cloud[i].normal_x);
+      EXPECT_EQ (values[1], cloud[i].x);
+    }
+  }
+
+  remove ("test_pcl_io_mapped.pcd");
+  remove ("test_pcl_io_mapped_compressed.pcd");
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, AsyncLoader)
+{
+  const std::size_t nr_files = 12;
+  std::vector<std::string> file_names;
+  PCDWriter pcd_writer;
+  PLYWriter ply_writer;
+  for (std::size_t f = 0; f < nr_files; ++f)
+  {
+    PointCloud<PointXYZ> cloud;
+    for (std::size_t i = 0; i < 100 * (f + 1); ++i)
+      cloud.push_back (PointXYZ (static_cast<float> (f), static_cast<float> (i), 1.0f));
+    cloud.sensor_origin_ = Eigen::Vector4f (static_cast<float> (f), 0.0f, 0.0f, 0.0f);
+    file_names.push_back ("test_pcl_io_async_" + std::to_string (f) + (f % 3 == 2 ? ".ply" : ".pcd"));
+    if (f % 3 == 0)
+      pcd_writer.writeBinaryCompressed (file_names.back (), cloud);
+    else if (f % 3 == 1)
+      pcd_writer.writeASCII (file_names.back (), cloud);
+    else
+      ply_writer.write (file_names.back (), cloud, true);
+  }
+  file_names.push_back ("test_pcl_io_async_missing.pcd");
+
+  std::vector<PCLPointCloud2> clouds (file_names.size ());
+  std::vector<std::future<int> > results;
+  std::vector<Eigen::Vector4f, Eigen::aligned_allocator<Eigen::Vector4f> > origins (file_names.size ());
+  std::vector<Eigen::Quaternionf, Eigen::aligned_allocator<Eigen::Quaternionf> > orientations (file_names.size ());
+  {
+    // A queue shorter than the number of files, load blocks until the threads catch up
+    io::AsyncLoader loader (3, 2);
+    EXPECT_EQ (loader.getNumberOfThreads (), 3u);
+    for (std::size_t f = 0; f < file_names.size (); ++f)
+      results.push_back (loader.load (file_names[f], clouds[f], origins[f], orientations[f]));
+
+    for (std::size_t f = 0; f < nr_files; ++f)
+    {
+      ASSERT_EQ (results[f].get (), 0);
+      EXPECT_EQ (clouds[f].width * clouds[f].height, 100 * (f + 1));
+      PointCloud<PointXYZ> cloud;
+      fromPCLPointCloud2 (clouds[f], cloud);
+      EXPECT_EQ (cloud.back ().x, static_cast<float> (f));
+      EXPECT_EQ (cloud.back ().y, static_cast<float> (100 * (f + 1) - 1));
+      if (f % 3 != 2)
+        EXPECT_EQ (origins[f][0], static_cast<float> (f));
+    }
+    EXPECT_LT (results.back ().get (), 0);
+
+    // Files still queued when the loader is destroyed are loaded first
+    PCLPointCloud2 last;
+    results.push_back (loader.load (file_names[0], last));
+    results.back ().wait ();
+    EXPECT_EQ (last.width * last.height, 100u);
+  }
+
+  for (std::size_t f = 0; f < nr_files; ++f)
+    remove (file_names[f].c_str ());
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, LZFImageRecorderAndPlayer)
+{
+  const std::uint32_t width = 32, height = 24;
+  const std::size_t nr_frames = 10;
+  auto depth_writer = std::make_shared<LZFDepth16ImageWriter> ();
+  auto rgb_writer = std::make_shared<LZFRGB24ImageWriter> ();
+
+  std::vector<std::string> rgb_file_names;
+  {
+    LZFImageRecorder recorder (3, 2);
+    ASSERT_TRUE (recorder.open ("test_pcl_io_recorder.pclzf"));
+    for (std::size_t f = 0; f < nr_frames; ++f)
+    {
+      std::vector<std::uint16_t> depth (width * height);
+      std::vector<std::uint8_t> rgb (width * height * 3);
+      for (std::size_t i = 0; i < depth.size (); ++i)
+      {
+        depth[i] = static_cast<std::uint16_t> (1000 + 10 * f + i % 7);
+        rgb[i * 3 + 0] = static_cast<std::uint8_t> (f);
+        rgb[i * 3 + 1] = static_cast<std::uint8_t> (i);
+        rgb[i * 3 + 2] = 42;
+      }
+      EXPECT_TRUE (recorder.record (depth_writer, reinterpret_cast<const char*> (depth.data ()), depth.size () * 2, width, height));
+      rgb_file_names.push_back ("test_pcl_io_recorder_" + std::to_string (f) + ".pclzf");
+      EXPECT_TRUE (recorder.record (rgb_writer, reinterpret_cast<const char*> (rgb.data ()), rgb.size (), width, height, rgb_file_names.back ()));
+    }
+    recorder.close ();
+    EXPECT_EQ (recorder.getNumberOfDroppedFrames (), 0u);
+    EXPECT_EQ (recorder.getNumberOfFailedFrames (), 0u);
+  }
+
+  CameraParameters parameters;
+  parameters.focal_length_x = parameters.focal_length_y = 500.0;
+  parameters.principal_point_x = width / 2.0;
+  parameters.principal_point_y = height / 2.0;
+  LZFDepth16ImageReader depth_reader;
+  depth_reader.setParameters (parameters);
+  LZFRGB24ImageReader rgb_reader;
+
+  // Both the multi-frame file and the single-frame files come back in recording order
+  LZFImagePlayer depth_player (2), rgb_player (2);
+  ASSERT_TRUE (depth_player.open ("test_pcl_io_recorder.pclzf"));
+  ASSERT_TRUE (rgb_player.open (rgb_file_names));
+  std::vector<char> blob;
+  for (std::size_t f = 0; f < nr_frames; ++f)
+  {
+    PointCloud<PointXYZRGBA> cloud;
+    ASSERT_TRUE (depth_player.getNextFrame (blob));
+    ASSERT_TRUE (depth_reader.read (blob, cloud));
+    ASSERT_TRUE (rgb_player.getNextFrame (blob));
+    ASSERT_TRUE (rgb_reader.read (blob, cloud));
+    ASSERT_EQ (cloud.width, width);
+    ASSERT_EQ (cloud.height, height);
+    for (std::size_t i = 0; i < cloud.size (); i += 37)
+    {
+      EXPECT_NEAR (cloud[i].z, 0.001 * (1000 + 10 * f + i % 7), 1e-6);
+      EXPECT_EQ (cloud[i].r, f);
+      EXPECT_EQ (cloud[i].g, i % 256);
+      EXPECT_EQ (cloud[i].b, 42);
+    }
+  }
+  EXPECT_FALSE (depth_player.getNextFrame (blob));
+  EXPECT_FALSE (rgb_player.getNextFrame (blob));
+
+  // The single-frame files are regular PCLZF files
+  PointCloud<PointXYZRGBA> cloud;
+  EXPECT_TRUE (rgb_reader.read (rgb_file_names.back (), cloud));
+  EXPECT_EQ (cloud[0].r, nr_frames - 1);
+
+  remove ("test_pcl_io_recorder.pclzf");
+  for (const auto &file_name : rgb_file_names)
+    remove (file_name.c_str ());
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 TEST (PCL, Locale)
 {
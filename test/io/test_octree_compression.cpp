@@ -39,6 +39,7 @@
 #include <pcl/octree/octree.h>
 #include <pcl/io/pcd_io.h>
 #include <pcl/compression/octree_pointcloud_compression.h>
+#include <pcl/compression/octree_compression_archive.h>
 #include <pcl/compression/compression_profiles.h>
 
 #include <exception>
@@ -153,6 +154,193 @@ TEST (PCL, OctreeDeCompressionRandomPointXYZ)
   } // compression profiles
 } // TEST
 
+TEST (PCL, OctreeDeCompressionEntropyCoders)
+{
+  srand(static_cast<unsigned int> (time(NULL)));
+
+  pcl::PointCloud<pcl::PointXYZRGBA>::Ptr cloud(new pcl::PointCloud<pcl::PointXYZRGBA>());
+  for (int point = 0; point < MAX_POINTS; point++)
+  {
+    pcl::PointXYZRGBA new_point;
+    new_point.x = static_cast<float> (MAX_XYZ * rand() / RAND_MAX);
+    new_point.y = static_cast<float> (MAX_XYZ * rand() / RAND_MAX);
+    new_point.z = static_cast<float> (MAX_XYZ * rand() / RAND_MAX);
+    new_point.rgba = static_cast<std::uint32_t> (rand());
+    cloud->push_back(new_point);
+  }
+
+  // encode the same I- and P-frames with both entropy coders, switching the coder between frames
+  pcl::io::OctreePointCloudCompression<pcl::PointXYZRGBA> range_encoder(pcl::io::MED_RES_OFFLINE_COMPRESSION_WITH_COLOR, false);
+  pcl::io::OctreePointCloudCompression<pcl::PointXYZRGBA> rans_encoder(pcl::io::MED_RES_OFFLINE_COMPRESSION_WITH_COLOR, false);
+  rans_encoder.setEntropyCoder(pcl::io::EntropyCoder::INTERLEAVED_RANS);
+  pcl::io::OctreePointCloudCompression<pcl::PointXYZRGBA> range_decoder;
+  pcl::io::OctreePointCloudCompression<pcl::PointXYZRGBA> rans_decoder;
+  std::stringstream range_data;
+  std::stringstream rans_data;
+
+  for (int frame = 0; frame < 3; frame++)
+  {
+    if (frame == 1)
+      rans_encoder.setEntropyCoder(pcl::io::EntropyCoder::STATIC_RANGE);
+    if (frame == 2)
+      rans_encoder.setEntropyCoder(pcl::io::EntropyCoder::INTERLEAVED_RANS);
+
+    range_encoder.encodePointCloud(cloud, range_data);
+    rans_encoder.encodePointCloud(cloud, rans_data);
+
+    pcl::PointCloud<pcl::PointXYZRGBA>::Ptr range_cloud_out(new pcl::PointCloud<pcl::PointXYZRGBA>());
+    pcl::PointCloud<pcl::PointXYZRGBA>::Ptr rans_cloud_out(new pcl::PointCloud<pcl::PointXYZRGBA>());
+    range_decoder.decodePointCloud(range_data, range_cloud_out);
+    rans_decoder.decodePointCloud(rans_data, rans_cloud_out);
+
+    // both coders are lossless, so the decoded clouds are identical
+    ASSERT_EQ(range_cloud_out->size(), rans_cloud_out->size());
+    EXPECT_GT(rans_cloud_out->size(), 0u);
+    for (std::size_t i = 0; i < rans_cloud_out->size(); i++)
+    {
+      EXPECT_EQ((*range_cloud_out)[i].x, (*rans_cloud_out)[i].x);
+      EXPECT_EQ((*range_cloud_out)[i].y, (*rans_cloud_out)[i].y);
+      EXPECT_EQ((*range_cloud_out)[i].z, (*rans_cloud_out)[i].z);
+      EXPECT_EQ((*range_cloud_out)[i].rgba, (*rans_cloud_out)[i].rgba);
+    }
+  }
+} // TEST
+
+TEST (PCL, OctreeDeCompressionAttributes)
+{
+  srand(static_cast<unsigned int> (time(NULL)));
+
+  // the intensity is a function of the x coordinate, so that it can be checked for every decoded point
+  pcl::PointCloud<pcl::PointXYZI>::Ptr cloud(new pcl::PointCloud<pcl::PointXYZI>());
+  for (int point = 0; point < MAX_POINTS; point++)
+  {
+    const int cell = rand() % 16;
+    pcl::PointXYZI new_point;
+    new_point.x = static_cast<float> (cell * 64 + 1 + 62.0 * rand() / RAND_MAX);
+    new_point.y = static_cast<float> (MAX_XYZ * rand() / RAND_MAX);
+    new_point.z = static_cast<float> (MAX_XYZ * rand() / RAND_MAX);
+    new_point.intensity = static_cast<float> (cell * 8);
+    cloud->push_back(new_point);
+  }
+
+  for (const auto compression_profile: {pcl::io::MED_RES_ONLINE_COMPRESSION_WITHOUT_COLOR, pcl::io::LOW_RES_ONLINE_COMPRESSION_WITHOUT_COLOR})
+  {
+    pcl::io::OctreePointCloudCompression<pcl::PointXYZI> pointcloud_encoder(compression_profile, false);
+    pcl::io::OctreePointCloudCompression<pcl::PointXYZI> pointcloud_decoder;
+    pcl::io::OctreePointCloudCompression<pcl::PointXYZ> xyz_decoder;
+    EXPECT_TRUE(pointcloud_encoder.addAttributeEncoding("intensity"));
+    EXPECT_FALSE(pointcloud_encoder.addAttributeEncoding("rgb"));
+
+    for (int frame = 0; frame < 3; frame++)
+    {
+      std::stringstream compressed_data;
+      pointcloud_encoder.encodePointCloud(cloud, compressed_data);
+      const std::string data = compressed_data.str();
+
+      pcl::PointCloud<pcl::PointXYZI>::Ptr cloud_out(new pcl::PointCloud<pcl::PointXYZI>());
+      pointcloud_decoder.decodePointCloud(compressed_data, cloud_out);
+      ASSERT_GT(cloud_out->size(), 0u);
+      for (const auto& point : *cloud_out)
+      {
+        const int cell = static_cast<int> (std::floor(point.x / 64.0f));
+        EXPECT_NEAR(cell * 8.0f, point.intensity, 0.05f);
+      }
+
+      // decoders without the point field skip its data
+      std::stringstream xyz_compressed_data(data);
+      pcl::PointCloud<pcl::PointXYZ>::Ptr xyz_cloud_out(new pcl::PointCloud<pcl::PointXYZ>());
+      xyz_decoder.decodePointCloud(xyz_compressed_data, xyz_cloud_out);
+      EXPECT_EQ(cloud_out->size(), xyz_cloud_out->size());
+    }
+  }
+} // TEST
+
+TEST (PCL, OctreeCompressionArchive)
+{
+  srand(static_cast<unsigned int> (time(NULL)));
+
+  // a sequence of random point clouds with an empty frame, an I-frame every fourth frame
+  const std::size_t frame_count = 11;
+  std::vector<pcl::PointCloud<pcl::PointXYZ>::Ptr> clouds;
+  for (std::size_t frame = 0; frame < frame_count; frame++)
+  {
+    pcl::PointCloud<pcl::PointXYZ>::Ptr cloud(new pcl::PointCloud<pcl::PointXYZ>());
+    cloud->header.stamp = 1000 * frame;
+    if (frame != 5)
+    {
+      for (int point = 0; point < MAX_POINTS / 10; point++)
+        cloud->push_back(pcl::PointXYZ(static_cast<float> (MAX_XYZ * rand() / RAND_MAX),
+                                       static_cast<float> (MAX_XYZ * rand() / RAND_MAX),
+                                       static_cast<float> (MAX_XYZ * rand() / RAND_MAX)));
+    }
+    clouds.push_back(cloud);
+  }
+
+  std::stringstream archive;
+  std::vector<pcl::PointCloud<pcl::PointXYZ>::Ptr> sequential_clouds;
+  {
+    pcl::io::OctreePointCloudCompression<pcl::PointXYZ> pointcloud_encoder(pcl::io::MANUAL_CONFIGURATION, false, 0.001, 8.0, false, 4, false);
+    pcl::io::OctreePointCloudCompression<pcl::PointXYZ> pointcloud_decoder;
+    pcl::io::OctreeCompressionArchiveWriter<pcl::PointXYZ> archive_writer(archive, pointcloud_encoder);
+    pcl::io::OctreePointCloudCompression<pcl::PointXYZ> sequential_encoder(pcl::io::MANUAL_CONFIGURATION, false, 0.001, 8.0, false, 4, false);
+    for (const auto& cloud : clouds)
+    {
+      archive_writer.writeFrame(cloud);
+
+      // reference result of a plain compressed stream
+      std::stringstream compressed_data;
+      sequential_encoder.encodePointCloud(cloud, compressed_data);
+      pcl::PointCloud<pcl::PointXYZ>::Ptr cloud_out(new pcl::PointCloud<pcl::PointXYZ>());
+      if (!cloud->empty())
+        pointcloud_decoder.decodePointCloud(compressed_data, cloud_out);
+      sequential_clouds.push_back(cloud_out);
+    }
+    archive_writer.close();
+  }
+
+  pcl::io::OctreeCompressionArchiveReader<pcl::PointXYZ> archive_reader;
+  std::stringstream invalid_archive("<PCL-OCT-COMPRESSED>");
+  EXPECT_FALSE(archive_reader.open(invalid_archive));
+  ASSERT_TRUE(archive_reader.open(archive));
+  ASSERT_EQ(frame_count, archive_reader.getFrameCount());
+  ASSERT_EQ(4u, archive_reader.getKeyFrames().size());
+  EXPECT_TRUE(archive_reader.getFrameInfo(0).key_frame);
+  // the empty frame restarts the I-frame interval
+  EXPECT_EQ(6u, archive_reader.getKeyFrame(7));
+  EXPECT_EQ(8000u, archive_reader.getFrameInfo(8).stamp);
+  EXPECT_EQ(0u, archive_reader.getFrameInfo(5).size);
+
+  const auto expect_equal_clouds = [] (const pcl::PointCloud<pcl::PointXYZ>& cloud_a, const pcl::PointCloud<pcl::PointXYZ>& cloud_b)
+  {
+    ASSERT_EQ(cloud_a.size(), cloud_b.size());
+    for (std::size_t i = 0; i < cloud_a.size(); i++)
+    {
+      EXPECT_EQ(cloud_a[i].x, cloud_b[i].x);
+      EXPECT_EQ(cloud_a[i].y, cloud_b[i].y);
+      EXPECT_EQ(cloud_a[i].z, cloud_b[i].z);
+    }
+  };
+
+  // random access
+  for (const std::size_t frame : {6u, 2u, 3u, 9u, 5u, 10u, 0u, 7u})
+  {
+    pcl::PointCloud<pcl::PointXYZ>::Ptr cloud_out(new pcl::PointCloud<pcl::PointXYZ>());
+    ASSERT_TRUE(archive_reader.readFrame(frame, cloud_out));
+    EXPECT_EQ(clouds[frame]->header.stamp, cloud_out->header.stamp);
+    expect_equal_clouds(*sequential_clouds[frame], *cloud_out);
+  }
+  pcl::PointCloud<pcl::PointXYZ>::Ptr cloud_out;
+  EXPECT_FALSE(archive_reader.readFrame(frame_count, cloud_out));
+
+  // parallel decoding of a frame range
+  archive_reader.setNumberOfThreads(2);
+  std::vector<pcl::PointCloud<pcl::PointXYZ>::Ptr> clouds_out;
+  ASSERT_TRUE(archive_reader.readFrames(2, 9, clouds_out));
+  ASSERT_EQ(8u, clouds_out.size());
+  for (std::size_t i = 0; i < clouds_out.size(); i++)
+    expect_equal_clouds(*sequential_clouds[i + 2], *clouds_out[i]);
+} // TEST
+
 TEST(PCL, OctreeDeCompressionFile)
 {
   pcl::PointCloud<pcl::PointXYZRGB>::Ptr input_cloud_ptr (new pcl::PointCloud<pcl::PointXYZRGB>);
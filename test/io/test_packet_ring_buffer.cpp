@@ -0,0 +1,128 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2014-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <pcl/test/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include <pcl/io/impl/packet_ring_buffer.hpp>
+
+TEST (PacketRingBuffer, FIFOAndOverflow)
+{
+  pcl::PacketRingBuffer queue (3, 8);
+  EXPECT_EQ (4, queue.capacity ());
+  EXPECT_TRUE (queue.isEmpty ());
+
+  std::vector<std::uint8_t> packet;
+  EXPECT_FALSE (queue.tryDequeue (packet));
+
+  for (std::uint8_t i = 0; i < 4; ++i)
+  {
+    const std::vector<std::uint8_t> data (i + 1, i);
+    EXPECT_TRUE (queue.enqueue (data.data (), data.size ()));
+  }
+  const std::uint8_t extra = 42;
+  EXPECT_FALSE (queue.enqueue (&extra, 1));
+  EXPECT_EQ (1, queue.getDroppedPackets ());
+
+  for (std::uint8_t i = 0; i < 4; ++i)
+  {
+    ASSERT_TRUE (queue.tryDequeue (packet));
+    EXPECT_EQ (std::vector<std::uint8_t> (i + 1, i), packet);
+  }
+  EXPECT_TRUE (queue.isEmpty ());
+
+  // Slots are reused once they have been consumed
+  const std::vector<std::uint8_t> large (100, 7);
+  EXPECT_TRUE (queue.enqueue (large.data (), large.size ()));
+  ASSERT_TRUE (queue.dequeue (packet));
+  EXPECT_EQ (large, packet);
+}
+
+TEST (PacketRingBuffer, MultipleProducers)
+{
+  const std::size_t num_producers = 4;
+  const std::uint32_t num_packets = 20000;
+  pcl::PacketRingBuffer queue (64, sizeof (std::uint32_t) + 1);
+
+  std::vector<std::thread> producers;
+  for (std::size_t p = 0; p < num_producers; ++p)
+    producers.emplace_back ([&queue, p, num_packets] ()
+    {
+      for (std::uint32_t i = 0; i < num_packets; ++i)
+      {
+        std::uint8_t data[sizeof (std::uint32_t) + 1];
+        data[0] = static_cast<std::uint8_t> (p);
+        std::memcpy (data + 1, &i, sizeof (i));
+        while (!queue.enqueue (data, sizeof (data)))
+          std::this_thread::yield ();
+      }
+    });
+
+  // Packets of every producer arrive complete and in order
+  std::vector<std::uint32_t> next (num_producers, 0);
+  std::vector<std::uint8_t> packet;
+  for (std::size_t n = 0; n < num_producers * num_packets; ++n)
+  {
+    ASSERT_TRUE (queue.dequeue (packet));
+    ASSERT_EQ (sizeof (std::uint32_t) + 1, packet.size ());
+    std::uint32_t i;
+    std::memcpy (&i, packet.data () + 1, sizeof (i));
+    ASSERT_LT (packet[0], num_producers);
+    EXPECT_EQ (next[packet[0]]++, i);
+  }
+  for (auto &producer : producers)
+    producer.join ();
+  EXPECT_TRUE (queue.isEmpty ());
+
+  queue.stopQueue ();
+  EXPECT_FALSE (queue.dequeue (packet));
+  const std::uint8_t data = 0;
+  EXPECT_FALSE (queue.enqueue (&data, 1));
+}
+
+/* ---[ */
+int
+main (int argc, char** argv)
+{
+  testing::InitGoogleTest (&argc, argv);
+  return (RUN_ALL_TESTS ());
+}
+/* ]--- */
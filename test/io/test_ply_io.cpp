@@ -36,11 +36,14 @@
  */
 #include <pcl/io/ply_io.h>
 #include <pcl/conversions.h>
+#include <pcl/common/io.h>
 #include <pcl/PolygonMesh.h>
 #include <pcl/PCLPointCloud2.h>
 #include <pcl/point_cloud.h>
 #include <pcl/point_types.h>
 #include <pcl/test/gtest.h>
+#include <boost/filesystem.hpp>
+#include <algorithm>
 #include <fstream> // for ofstream
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -532,6 +535,128 @@ TEST_F (PLYTest, CommentAtTheEnd)
   ASSERT_EQ (cloud.empty(), false);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+struct PLYBinaryTest : public PLYTest
+{
+  /** \brief Write a binary file with all kinds of vertex properties, and a face list after the vertices */
+  void
+  writeFile (const std::string &file_name, bool big_endian, bool with_obj_info)
+  {
+    std::ofstream fs (file_name.c_str (), std::ios::binary);
+    fs << "ply\n"
+          "format " << (big_endian ? "binary_big_endian" : "binary_little_endian") << " 1.0\n"
+          "comment a comment\n";
+    if (with_obj_info)
+      fs << "obj_info some information\n";
+    fs << "element vertex " << nr_vertices_ << "\n"
+          "property float x\n"
+          "property float y\n"
+          "property float z\n"
+          "property uchar red\n"
+          "property uchar green\n"
+          "property uchar blue\n"
+          "property double nx\n"
+          "property short label\n"
+          "property uchar alpha\n"
+          "property uchar intensity\n"
+          "property int index\n"
+          "property uchar flags\n"
+          "element face 1\n"
+          "property list uchar int vertex_indices\n"
+          "end_header\n";
+
+    const auto write = [&fs, big_endian] (auto value)
+    {
+      char bytes[sizeof (value)];
+      memcpy (bytes, &value, sizeof (value));
+      if (big_endian)
+        std::reverse (bytes, bytes + sizeof (value));
+      fs.write (bytes, sizeof (value));
+    };
+    for (int i = 0; i < nr_vertices_; ++i)
+    {
+      write (static_cast<float> (i) * 0.5f);
+      write (i == 7 ? std::numeric_limits<float>::quiet_NaN () : -static_cast<float> (i));
+      write (1.0f);
+      write (static_cast<std::uint8_t> (i));
+      write (static_cast<std::uint8_t> (2 * i));
+      write (static_cast<std::uint8_t> (3 * i));
+      write (static_cast<double> (i) / 3.0);
+      write (static_cast<std::int16_t> (-i));
+      write (static_cast<std::uint8_t> (255 - i));
+      write (static_cast<std::uint8_t> (i % 100));
+      write (static_cast<std::int32_t> (i * 1000));
+      write (static_cast<std::uint8_t> (i % 2));
+    }
+    write (static_cast<std::uint8_t> (3));
+    write (std::int32_t (0));
+    write (std::int32_t (1));
+    write (std::int32_t (2));
+  }
+
+  const int nr_vertices_ = 100;
+};
+
+TEST_F (PLYBinaryTest, BulkReadMatchesParser)
+{
+  // The obj_info line makes the reader go through the parser callbacks
+  const std::string parsed_file = "ply_file_parsed.ply";
+  for (const bool big_endian : {false, true})
+  {
+    writeFile (mesh_file_ply_, big_endian, false);
+    writeFile (parsed_file, big_endian, true);
+
+    pcl::PLYReader reader;
+    reader.setNumberOfThreads (4);
+    pcl::PCLPointCloud2 bulk, parsed;
+    ASSERT_EQ (reader.read (mesh_file_ply_, bulk), 0);
+    ASSERT_EQ (reader.read (parsed_file, parsed), 0);
+
+    EXPECT_EQ (bulk.width, parsed.width);
+    EXPECT_EQ (bulk.height, parsed.height);
+    EXPECT_EQ (bulk.point_step, parsed.point_step);
+    EXPECT_EQ (bulk.row_step, parsed.row_step);
+    EXPECT_FALSE (bulk.is_dense);
+    EXPECT_EQ (bulk.is_dense, parsed.is_dense);
+    ASSERT_EQ (bulk.fields.size (), parsed.fields.size ());
+    for (std::size_t i = 0; i < bulk.fields.size (); ++i)
+    {
+      EXPECT_EQ (bulk.fields[i].name, parsed.fields[i].name);
+      EXPECT_EQ (bulk.fields[i].offset, parsed.fields[i].offset);
+      EXPECT_EQ (bulk.fields[i].datatype, parsed.fields[i].datatype);
+      EXPECT_EQ (bulk.fields[i].count, parsed.fields[i].count);
+    }
+    EXPECT_EQ (bulk.data, parsed.data);
+
+    pcl::PointCloud<pcl::PointXYZRGBA> cloud;
+    pcl::fromPCLPointCloud2 (bulk, cloud);
+    ASSERT_EQ (cloud.size (), static_cast<std::size_t> (nr_vertices_));
+    EXPECT_EQ (cloud[10].x, 5.0f);
+    EXPECT_EQ (cloud[10].r, 10);
+    EXPECT_EQ (cloud[10].g, 20);
+    EXPECT_EQ (cloud[10].b, 30);
+    EXPECT_EQ (cloud[10].a, 245);
+    const int nx_index = pcl::getFieldIndex (bulk, "normal_x");
+    ASSERT_GE (nx_index, 0);
+    EXPECT_EQ (bulk.fields[nx_index].datatype, pcl::PCLPointField::FLOAT64);
+    double nx;
+    memcpy (&nx, &bulk.data[10 * bulk.point_step + bulk.fields[nx_index].offset], sizeof (double));
+    EXPECT_EQ (nx, 10.0 / 3.0);
+  }
+  remove (parsed_file.c_str ());
+}
+
+TEST_F (PLYBinaryTest, TruncatedFile)
+{
+  writeFile (mesh_file_ply_, false, false);
+  const auto size = boost::filesystem::file_size (mesh_file_ply_);
+  boost::filesystem::resize_file (mesh_file_ply_, size / 2);
+
+  pcl::PLYReader reader;
+  pcl::PCLPointCloud2 cloud;
+  EXPECT_LT (reader.read (mesh_file_ply_, cloud), 0);
+}
+
 /* ---[ */
 int
 main (int argc, char** argv)
@@ -0,0 +1,96 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2014-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <pcl/test/gtest.h>
+#include <pcl/io/point_cloud_pool.h>
+#include <pcl/point_types.h>
+
+TEST (PointCloudPool, RecyclesReleasedClouds)
+{
+  pcl::io::PointCloudPool<pcl::PointXYZ> pool (1);
+  EXPECT_EQ (0, pool.size ());
+
+  auto cloud = pool.get ();
+  cloud->resize (1000);
+  cloud->header.seq = 5;
+  cloud->is_dense = false;
+  const pcl::PointXYZ *storage = cloud->data ();
+
+  // A consumer still holding the frame keeps it out of the pool
+  pcl::PointCloud<pcl::PointXYZ>::ConstPtr consumer = cloud;
+  cloud.reset ();
+  EXPECT_EQ (0, pool.size ());
+  consumer.reset ();
+  EXPECT_EQ (1, pool.size ());
+
+  // The recycled cloud comes back empty but keeps its point storage
+  auto reused = pool.get ();
+  EXPECT_EQ (0, pool.size ());
+  EXPECT_TRUE (reused->empty ());
+  EXPECT_EQ (0, reused->header.seq);
+  EXPECT_TRUE (reused->is_dense);
+  EXPECT_GE (reused->points.capacity (), 1000);
+  reused->resize (1000);
+  EXPECT_EQ (storage, reused->data ());
+
+  // Only max_size idle clouds are kept
+  auto other = pool.get ();
+  reused.reset ();
+  other.reset ();
+  EXPECT_EQ (1, pool.size ());
+}
+
+TEST (PointCloudPool, OutlivesPool)
+{
+  pcl::PointCloud<pcl::PointXYZ>::Ptr cloud;
+  {
+    pcl::io::PointCloudPool<pcl::PointXYZ> pool;
+    cloud = pool.get ();
+    cloud->resize (10);
+  }
+  EXPECT_EQ (10, cloud->size ());
+  cloud.reset ();
+}
+
+/* ---[ */
+int
+main (int argc, char** argv)
+{
+  testing::InitGoogleTest (&argc, argv);
+  return (RUN_ALL_TESTS ());
+}
+/* ]--- */
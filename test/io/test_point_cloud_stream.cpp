@@ -0,0 +1,137 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved
+ */
+
+#include <pcl/test/gtest.h>
+#include <pcl/io/point_cloud_stream.h>
+#include <pcl/point_types.h>
+
+#include <chrono>
+#include <thread>
+
+using pcl::io::StreamClient;
+using pcl::io::StreamServer;
+
+static bool
+waitForClients (const StreamServer &server, std::size_t number_of_clients)
+{
+  for (int i = 0; i < 500 && server.getNumberOfClients () != number_of_clients; ++i)
+    std::this_thread::sleep_for (std::chrono::milliseconds (10));
+  return (server.getNumberOfClients () == number_of_clients);
+}
+
+TEST (StreamServer, SendsFramesFromKeyFrame)
+{
+  StreamServer server (0);
+  ASSERT_TRUE (server.start ());
+  EXPECT_FALSE (server.isKeyFrameRequested ());
+
+  StreamClient client;
+  ASSERT_TRUE (client.connect ("127.0.0.1", server.getPort ()));
+  ASSERT_TRUE (waitForClients (server, 1));
+  EXPECT_TRUE (server.isKeyFrameRequested ());
+
+  // A new client starts with a key frame
+  server.publish ("delta", false);
+  server.publish ("key", true);
+  server.publish ("", false);
+  server.publish (std::string (100000, 'x'), false);
+
+  std::string payload;
+  bool key_frame = false;
+  ASSERT_TRUE (client.receive (payload, key_frame));
+  EXPECT_EQ ("key", payload);
+  EXPECT_TRUE (key_frame);
+  ASSERT_TRUE (client.receive (payload, key_frame));
+  EXPECT_EQ ("", payload);
+  EXPECT_FALSE (key_frame);
+  ASSERT_TRUE (client.receive (payload, key_frame));
+  EXPECT_EQ (std::string (100000, 'x'), payload);
+  EXPECT_GE (server.getNumberOfDroppedFrames (), 1u);
+  EXPECT_FALSE (server.isKeyFrameRequested ());
+
+  client.close ();
+  EXPECT_FALSE (client.isConnected ());
+  EXPECT_FALSE (client.receive (payload, key_frame));
+  EXPECT_TRUE (waitForClients (server, 0));
+
+  server.setMaximumQueuedFrames (0);
+  EXPECT_EQ (1u, server.getMaximumQueuedFrames ());
+  server.stop ();
+  EXPECT_FALSE (server.isRunning ());
+}
+
+TEST (StreamServer, FansOutToClients)
+{
+  StreamServer server (0);
+  ASSERT_TRUE (server.start ());
+
+  StreamClient clients[3];
+  for (auto &client : clients)
+    ASSERT_TRUE (client.connect ("127.0.0.1", server.getPort ()));
+  ASSERT_TRUE (waitForClients (server, 3));
+
+  for (int i = 0; i < 2; ++i)
+    server.publish (std::to_string (i), true);
+
+  for (auto &client : clients)
+  {
+    std::string payload;
+    bool key_frame = false;
+    ASSERT_TRUE (client.receive (payload, key_frame));
+    EXPECT_EQ ("0", payload);
+    ASSERT_TRUE (client.receive (payload, key_frame));
+    EXPECT_EQ ("1", payload);
+  }
+
+  // Stopping the server disconnects the clients
+  server.stop ();
+  std::string payload;
+  bool key_frame = false;
+  EXPECT_FALSE (clients[0].receive (payload, key_frame));
+}
+
+TEST (PointCloudStreamServer, SendsCompressedClouds)
+{
+  using Cloud = pcl::PointCloud<pcl::PointXYZ>;
+  pcl::io::PointCloudStreamServer<pcl::PointXYZ> server (0, pcl::io::HIGH_RES_ONLINE_COMPRESSION_WITHOUT_COLOR);
+  ASSERT_TRUE (server.start ());
+
+  Cloud::Ptr cloud (new Cloud);
+  for (int i = 0; i < 10; ++i)
+    for (int j = 0; j < 10; ++j)
+      cloud->push_back (pcl::PointXYZ (0.1f * i, 0.1f * j, 1.0f));
+  EXPECT_FALSE (server.publish (cloud));
+
+  pcl::io::PointCloudStreamClient<pcl::PointXYZ> client;
+  ASSERT_TRUE (client.connect ("127.0.0.1", server.getServer ().getPort ()));
+  ASSERT_TRUE (waitForClients (server.getServer (), 1));
+
+  // The encoder starts with an I-frame, which the new client can decode
+  EXPECT_TRUE (server.publish (cloud));
+  EXPECT_TRUE (server.publish (cloud));
+
+  for (int frame = 0; frame < 2; ++frame)
+  {
+    Cloud::Ptr received (new Cloud);
+    ASSERT_TRUE (client.receive (received));
+    ASSERT_EQ (cloud->size (), received->size ());
+    for (const auto &point : *received)
+    {
+      EXPECT_NEAR (1.0f, point.z, 0.01f);
+      EXPECT_LE (point.x, 0.91f);
+    }
+  }
+}
+
+int
+main (int argc, char** argv)
+{
+  testing::InitGoogleTest (&argc, argv);
+  return (RUN_ALL_TESTS ());
+}
@@ -167,6 +167,63 @@ TEST (PCL, Static_Range_Coder_Test)
 }
 
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, Interleaved_Rans_Coder_Test)
+{
+  // Run test for different vector sizes, including sizes that are no multiple of the interleaving
+  for (unsigned int vectorSize: { 0, 1, 7, 253, 10000 })
+  {
+    std::stringstream sstream;
+    std::vector<char> inputCharData (vectorSize);
+    std::vector<char> skewedCharData (vectorSize);
+    std::vector<char> outputCharData (vectorSize);
+
+    std::vector<unsigned int> inputIntData (vectorSize);
+    std::vector<unsigned int> outputIntData (vectorSize);
+
+    // fill vectors with random data, the skewed vector is dominated by a few symbols and the
+    // integer vector mixes small values with values that have to be escaped
+    for (std::size_t i=0; i<vectorSize; i++)
+    {
+      inputCharData[i] = static_cast<char> (rand () & 0xFF);
+      skewedCharData[i] = static_cast<char> ((rand () % 100) ? (rand () & 0x3) : (rand () & 0xFF));
+      inputIntData[i] = static_cast<unsigned int> ((rand () % 10) ? (rand () & 0xFF) : rand ());
+    }
+
+    pcl::InterleavedRansCoder ransCoder;
+
+    for (const std::vector<char>* charData: { &inputCharData, &skewedCharData })
+    {
+      const std::size_t streamPos = sstream.str ().length ();
+
+      // encode char vector to stringstream
+      unsigned long writeByteLen = ransCoder.encodeCharVectorToStream (*charData, sstream);
+
+      // decode stringstream to char vector
+      unsigned long readByteLen = ransCoder.decodeStreamToCharVector (sstream, outputCharData);
+
+      // compare amount of bytes that are read and written to/from stream
+      EXPECT_EQ (writeByteLen, readByteLen);
+      EXPECT_EQ (streamPos + writeByteLen, sstream.str ().length ());
+
+      // compare input and output vector - should be identical
+      EXPECT_EQ (*charData, outputCharData);
+    }
+
+    // encode integer vector to stringstream
+    unsigned long writeByteLen = ransCoder.encodeIntVectorToStream (inputIntData, sstream);
+
+    // decode stringstream to integer vector
+    unsigned long readByteLen = ransCoder.decodeStreamToIntVector (sstream, outputIntData);
+
+    // compare amount of bytes that are read and written to/from stream
+    EXPECT_EQ (writeByteLen, readByteLen);
+
+    // compare input and output vector - should be identical
+    EXPECT_EQ (inputIntData, outputIntData);
+  }
+}
+
 
 /* ---[ */
 int
@@ -0,0 +1,103 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved
+ */
+
+#include <pcl/test/gtest.h>
+#include <pcl/io/sweep_deskew.h>
+
+#include <cmath>
+#include <limits>
+
+using pcl::io::SweepDeskew;
+
+static Eigen::Isometry3d
+pose (double yaw, const Eigen::Vector3d &translation)
+{
+  Eigen::Isometry3d result = Eigen::Isometry3d::Identity ();
+  result.linear () = Eigen::AngleAxisd (yaw, Eigen::Vector3d::UnitZ ()).toRotationMatrix ();
+  result.translation () = translation;
+  return (result);
+}
+
+TEST (SweepDeskew, InterpolatesPoses)
+{
+  SweepDeskew deskew;
+  Eigen::Isometry3d result;
+  EXPECT_FALSE (deskew.getPose (0.0, result));
+
+  deskew.addPose (10.0, pose (0.0, Eigen::Vector3d::Zero ()));
+  deskew.addPose (11.0, pose (M_PI / 2, Eigen::Vector3d (1.0, 2.0, 0.0)));
+  deskew.addPose (10.5, pose (1.0, Eigen::Vector3d::Zero ()));  // older than the last pose, ignored
+  EXPECT_EQ (2u, deskew.getNumberOfPoses ());
+
+  ASSERT_TRUE (deskew.getPose (10.5, result));
+  EXPECT_TRUE (result.isApprox (pose (M_PI / 4, Eigen::Vector3d (0.5, 1.0, 0.0)), 1e-9));
+
+  // Constant motion beyond the poses, for at most the maximum extrapolation time
+  deskew.getPose (11.05, result);
+  EXPECT_TRUE (result.isApprox (pose (1.05 * M_PI / 2, Eigen::Vector3d (1.05, 2.1, 0.0)), 1e-9));
+  deskew.getPose (20.0, result);
+  EXPECT_TRUE (result.isApprox (pose (1.1 * M_PI / 2, Eigen::Vector3d (1.1, 2.2, 0.0)), 1e-9));
+  deskew.setMaximumExtrapolation (0.0);
+  deskew.getPose (9.0, result);
+  EXPECT_TRUE (result.isApprox (pose (0.0, Eigen::Vector3d::Zero ()), 1e-9));
+}
+
+TEST (SweepDeskew, CorrectsFirings)
+{
+  // The sensor moves along x at 10 m/s and turns at 1 rad/s, a static point is seen from the moving sensor
+  SweepDeskew deskew;
+  for (int i = 0; i <= 20; ++i)
+  {
+    const double t = 0.01 * i;
+    deskew.addPose (t, pose (t, Eigen::Vector3d (10.0 * t, 0.0, 0.0)));
+  }
+  const Eigen::Vector3d fixed_point (20.0, 5.0, 1.0);
+  const Eigen::Isometry3d reference = pose (0.05, Eigen::Vector3d (0.5, 0.0, 0.0));
+  deskew.setReferenceTime (0.05);
+  EXPECT_TRUE (deskew.hasReferenceTime ());
+
+  for (const double t : {0.05, 0.071, 0.1234, 0.15})
+  {
+    const Eigen::Vector3d measured = pose (t, Eigen::Vector3d (10.0 * t, 0.0, 0.0)).inverse () * fixed_point;
+    float x[3] = {static_cast<float> (measured[0]), 0.0f, std::numeric_limits<float>::quiet_NaN ()};
+    float y[3] = {static_cast<float> (measured[1]), 0.0f, 0.0f};
+    float z[3] = {static_cast<float> (measured[2]), 0.0f, 0.0f};
+    deskew.deskew (t, x, y, z, 3);
+
+    // The point is where the sensor at the reference time sees it, the invalid point stays invalid
+    const Eigen::Vector3d expected = reference.inverse () * fixed_point;
+    EXPECT_NEAR (expected[0], x[0], 1e-4);
+    EXPECT_NEAR (expected[1], y[0], 1e-4);
+    EXPECT_NEAR (expected[2], z[0], 1e-4);
+    EXPECT_TRUE (std::isnan (x[2]));
+  }
+
+  // The poses before the reference time are dropped, except the one needed to interpolate
+  deskew.setReferenceTime (0.105);
+  EXPECT_EQ (11u, deskew.getNumberOfPoses ());
+  deskew.clear ();
+  EXPECT_FALSE (deskew.hasReferenceTime ());
+
+  // Without poses the points are not moved, the first firing becomes the reference
+  float x = 1.0f, y = 2.0f, z = 3.0f;
+  deskew.deskew (5.0, &x, &y, &z, 1);
+  EXPECT_TRUE (deskew.hasReferenceTime ());
+  EXPECT_EQ (1.0f, x);
+  EXPECT_EQ (2.0f, y);
+  EXPECT_EQ (3.0f, z);
+}
+
+/* ---[ */
+int
+main (int argc, char** argv)
+{
+  testing::InitGoogleTest (&argc, argv);
+  return (RUN_ALL_TESTS ());
+}
+/* ]--- */
@@ -50,6 +50,7 @@
 #include <boost/property_tree/xml_parser.hpp>
 
 #include <algorithm>
+#include <limits>
 #include <iostream>  // For debug
 #include <map>
 
@@ -157,6 +158,45 @@ TEST (PCL, KdTreeFLANN_radiusSearch)
   }
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, KdTreeFLANN_radiusSearchReuseBuffers)
+{
+  KdTreeFLANN<MyPoint> kdtree;
+  kdtree.setInputCloud (cloud.makeShared ());
+  MyPoint test_point (0.0f, 0.0f, 0.0f);
+
+  // The reference results, obtained with fresh vectors for every radius
+  std::vector<double> radii = {0.05, 0.15, 0.5, 1.0, 0.25, 0.05};
+  std::vector<std::vector<int> > expected_indices;
+  for (const double radius : radii)
+  {
+    std::vector<int> k_indices;
+    std::vector<float> k_distances;
+    kdtree.radiusSearch (test_point, radius, k_indices, k_distances);
+    expected_indices.push_back (k_indices);
+  }
+  // A radius of 1 covers more neighbors than the default capacity and must trigger the overflow path
+  ASSERT_GT (expected_indices[3].size (), 32u);
+
+  // Reusing the same (growing and shrinking) vectors for all radii gives the same results
+  std::vector<int> k_indices;
+  std::vector<float> k_distances;
+  for (std::size_t i = 0; i < radii.size (); ++i)
+  {
+    int found = kdtree.radiusSearch (test_point, radii[i], k_indices, k_distances);
+    ASSERT_EQ (expected_indices[i].size (), static_cast<std::size_t> (found));
+    ASSERT_EQ (k_indices.size (), k_distances.size ());
+    EXPECT_EQ (expected_indices[i], k_indices);
+    for (std::size_t j = 0; j < k_indices.size (); ++j)
+      EXPECT_NEAR (squaredEuclideanDistance (cloud[k_indices[j]], test_point), k_distances[j], 1e-5);
+  }
+
+  // max_nn bounds the number of neighbors, also when the vectors have more capacity
+  int found = kdtree.radiusSearch (test_point, 1.0, k_indices, k_distances, 5);
+  EXPECT_EQ (5, found);
+  EXPECT_EQ (5u, k_indices.size ());
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 TEST (PCL, KdTreeFLANN_nearestKSearch)
 {
@@ -207,6 +247,120 @@ TEST (PCL, KdTreeFLANN_nearestKSearch)
   }
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, KdTreeFLANN_setNumberOfThreads)
+{
+  // Some invalid points, which the parallel conversion has to skip
+  PointCloud<MyPoint>::Ptr input = cloud_big.makeShared ();
+  for (std::size_t i = 0; i < input->size (); i += 1000)
+    (*input)[i].x = std::numeric_limits<float>::quiet_NaN ();
+
+  KdTreeFLANN<MyPoint> single_tree;
+  single_tree.setInputCloud (input);
+
+  // Trees split into blocks find the same neighbors as a single tree
+  for (const unsigned int threads : {2u, 4u, 8u})
+  {
+    KdTreeFLANN<MyPoint> tree;
+    tree.setNumberOfThreads (threads);
+    tree.setInputCloud (input);
+
+    for (std::size_t i = 1; i < input->size (); i += input->size () / 50)
+    {
+      std::vector<int> k_indices, expected_indices;
+      std::vector<float> k_distances, expected_distances;
+      ASSERT_EQ (single_tree.nearestKSearch ((*input)[i], 20, expected_indices, expected_distances),
+                 tree.nearestKSearch ((*input)[i], 20, k_indices, k_distances));
+      EXPECT_EQ (expected_indices, k_indices);
+      EXPECT_EQ (expected_distances, k_distances);
+
+      // Neighbors at the same distance may come in any order
+      ASSERT_EQ (single_tree.radiusSearch ((*input)[i], 30.0, expected_indices, expected_distances),
+                 tree.radiusSearch ((*input)[i], 30.0, k_indices, k_distances));
+      EXPECT_EQ (expected_distances, k_distances);
+      std::sort (expected_indices.begin (), expected_indices.end ());
+      std::sort (k_indices.begin (), k_indices.end ());
+      EXPECT_EQ (expected_indices, k_indices);
+
+      ASSERT_EQ (single_tree.radiusSearch ((*input)[i], 30.0, expected_indices, expected_distances, 5),
+                 tree.radiusSearch ((*input)[i], 30.0, k_indices, k_distances, 5));
+      EXPECT_EQ (expected_distances, k_distances);
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, KdTreeFLANN_setInputArray)
+{
+  // Vectorize every other point, as an earlier stage of a pipeline would
+  PointCloud<MyPoint>::ConstPtr input = cloud.makeShared ();
+  DefaultPointRepresentation<MyPoint> representation;
+  IndicesPtr indices (new Indices);
+  std::shared_ptr<float> data (new float[input->size () * 3], std::default_delete<float[]> ());
+  float* row = data.get ();
+  for (std::size_t i = 0; i < input->size (); i += 2, row += 3)
+  {
+    representation.vectorize ((*input)[i], row);
+    indices->push_back (static_cast<int> (i));
+  }
+
+  KdTreeFLANN<MyPoint> reference_tree, tree;
+  reference_tree.setInputCloud (input, indices);
+  tree.setInputArray (input, data, indices->size (), indices);
+
+  MyPoint test_point (0.01f, 0.01f, 0.01f);
+  std::vector<int> k_indices, expected_indices;
+  std::vector<float> k_distances, expected_distances;
+  reference_tree.nearestKSearch (test_point, 10, expected_indices, expected_distances);
+  EXPECT_EQ (10, tree.nearestKSearch (test_point, 10, k_indices, k_distances));
+  EXPECT_EQ (expected_indices, k_indices);
+  EXPECT_EQ (expected_distances, k_distances);
+  for (const int &k_index : k_indices)
+    EXPECT_EQ (0, k_index % 2);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, KdTreeFLANN_setInputCloudCompact)
+{
+  PointCloud<PointXYZ> input;
+  for (const auto &point : cloud_big)
+    input.push_back (PointXYZ (point.x, point.y, point.z));
+  input[5].z = std::numeric_limits<float>::quiet_NaN ();
+  input.is_dense = false;
+
+  // The tree built on the compact cloud finds the same neighbors as the tree built on the decoded cloud
+  QuantizedPointCloud16 compact;
+  ASSERT_TRUE (compact.assign (input));
+  PointCloud<PointXYZ>::Ptr decoded (new PointCloud<PointXYZ>);
+  compact.decode (*decoded);
+
+  IndicesPtr indices (new Indices);
+  for (std::size_t i = 0; i < input.size (); i += 3)
+    indices->push_back (static_cast<int> (i));
+
+  for (const auto &subset : {IndicesPtr (), indices})
+  {
+    KdTreeFLANN<PointXYZ> reference_tree, tree;
+    reference_tree.setInputCloud (decoded, subset);
+    tree.setInputCloud (compact, subset);
+    EXPECT_EQ (nullptr, tree.getInputCloud ());
+
+    std::vector<int> k_indices, expected_indices;
+    std::vector<float> k_distances, expected_distances;
+    for (std::size_t i = 0; i < 100; ++i)
+    {
+      const PointXYZ &query = input[i * 97 + 1];
+      reference_tree.nearestKSearch (query, 8, expected_indices, expected_distances);
+      EXPECT_EQ (8, tree.nearestKSearch (query, 8, k_indices, k_distances));
+      EXPECT_EQ (expected_indices, k_indices);
+      EXPECT_EQ (expected_distances, k_distances);
+      reference_tree.radiusSearch (query, 20.0, expected_indices, expected_distances);
+      tree.radiusSearch (query, 20.0, k_indices, k_distances);
+      EXPECT_EQ (expected_indices, k_indices);
+    }
+  }
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 class MyPointRepresentationXY : public PointRepresentation<MyPoint>
 {
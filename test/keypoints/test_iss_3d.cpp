@@ -153,6 +153,35 @@ TEST (PCL, ISSKeypoint3D_BE)
   tree.reset (new search::KdTree<PointXYZ> ());
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, ISSKeypoint3D_Threads)
+{
+  PointCloud<PointXYZ> keypoints_single, keypoints_multi;
+
+  ISSKeypoint3D<PointXYZ, PointXYZ> iss_detector;
+  iss_detector.setSearchMethod (tree);
+  iss_detector.setSalientRadius (6 * cloud_resolution);
+  iss_detector.setNonMaxRadius (4 * cloud_resolution);
+  iss_detector.setThreshold21 (0.975);
+  iss_detector.setThreshold32 (0.975);
+  iss_detector.setMinNeighbors (5);
+  iss_detector.setInputCloud (cloud);
+
+  iss_detector.setNumberOfThreads (1);
+  iss_detector.compute (keypoints_single);
+  const auto indices_single = iss_detector.getKeypointsIndices ()->indices;
+
+  iss_detector.setNumberOfThreads (4);
+  iss_detector.compute (keypoints_multi);
+  const auto indices_multi = iss_detector.getKeypointsIndices ()->indices;
+
+  // Same keypoints in the same order, whatever the number of threads
+  ASSERT_EQ (keypoints_single.size (), keypoints_multi.size ());
+  EXPECT_EQ (indices_single, indices_multi);
+
+  tree.reset (new search::KdTree<PointXYZ> ());
+}
+
 //* ---[ */
 int
 main (int argc, char** argv)
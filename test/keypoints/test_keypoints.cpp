@@ -121,6 +121,32 @@ TEST (PCL, SIFTKeypoint)
 
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, SIFTKeypoint_threads)
+{
+  PointCloud<KeypointT> keypoints_single, keypoints_multi;
+
+  SIFTKeypoint<PointXYZI, KeypointT> sift_detector;
+  sift_detector.setScales (0.02f, 5, 3);
+  sift_detector.setMinimumContrast (0.03f);
+  sift_detector.setInputCloud (cloud_xyzi);
+
+  sift_detector.setNumberOfThreads (1);
+  sift_detector.compute (keypoints_single);
+  sift_detector.setNumberOfThreads (4);
+  sift_detector.compute (keypoints_multi);
+
+  // The keypoints do not depend on the number of threads, neither in number nor in order
+  ASSERT_EQ (keypoints_single.size (), keypoints_multi.size ());
+  for (std::size_t i = 0; i < keypoints_single.size (); ++i)
+  {
+    EXPECT_EQ (keypoints_single[i].x, keypoints_multi[i].x);
+    EXPECT_EQ (keypoints_single[i].y, keypoints_multi[i].y);
+    EXPECT_EQ (keypoints_single[i].z, keypoints_multi[i].z);
+    EXPECT_EQ (keypoints_single[i].scale, keypoints_multi[i].scale);
+  }
+}
+
 TEST (PCL, SIFTKeypoint_radiusSearch)
 {
   const int nr_scales_per_octave = 3;
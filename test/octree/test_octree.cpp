@@ -38,6 +38,11 @@
  */
 #include <pcl/test/gtest.h>
 
+#include <algorithm>
+#include <random>
+#include <set>
+#include <thread>
+#include <tuple>
 #include <vector>
 
 #include <pcl/common/time.h>
@@ -606,6 +611,50 @@ TEST (PCL, Octree2Buf_Base_Double_Buffering_Test)
   }
 }
 
+TEST (PCL, Octree2Buf_Base_Switch_Buffers_Test)
+{
+  constexpr unsigned int pool_size = 400;
+  constexpr unsigned int frames = 30;
+
+  // voxels are picked from a small pool, so that consecutive frames share most of the
+  // tree and the branches are taken over from the previous buffer
+  std::vector<OctreeKey> pool;
+  for (unsigned int i = 0; i < pool_size; i++)
+    pool.emplace_back (rand () % 256, rand () % 256, rand () % 256);
+
+  Octree2BufBase<int> octree;
+  octree.setTreeDepth (8);
+
+  std::set<std::tuple<unsigned int, unsigned int, unsigned int> > previous_frame;
+  for (unsigned int frame = 0; frame < frames; frame++)
+  {
+    octree.switchBuffers ();
+
+    std::set<std::tuple<unsigned int, unsigned int, unsigned int> > current_frame;
+    for (const OctreeKey& key : pool)
+    {
+      if (rand () % 3 == 0)
+        continue;
+      *octree.createLeaf (key.x, key.y, key.z) = 1;
+      current_frame.emplace (key.x, key.y, key.z);
+    }
+
+    ASSERT_EQ (current_frame.size (), octree.getLeafCount ());
+    for (const OctreeKey& key : pool)
+      ASSERT_EQ (current_frame.count (std::make_tuple (key.x, key.y, key.z)) > 0,
+                 octree.existLeaf (key.x, key.y, key.z));
+
+    previous_frame.swap (current_frame);
+  }
+
+  // the previous buffer has survived the clean-ups of the last switch
+  octree.switchBuffers ();
+  octree.deleteCurrentBuffer ();
+  for (const OctreeKey& key : pool)
+    EXPECT_EQ (previous_frame.count (std::make_tuple (key.x, key.y, key.z)) > 0,
+               octree.existLeaf (key.x, key.y, key.z));
+}
+
 TEST (PCL, Octree2Buf_Base_Double_Buffering_XOR_Test)
 {
 
@@ -810,6 +859,211 @@ TEST (PCL, Octree_Pointcloud_Test)
   }
 }
 
+TEST (PCL, Octree_Pointcloud_Arena_Allocator)
+{
+  using ArenaOctree = OctreeBase<OctreeContainerPointIndices, OctreeContainerEmpty, OctreeNodeArena>;
+  using ArenaOctreePointCloud = OctreePointCloud<PointXYZ, OctreeContainerPointIndices, OctreeContainerEmpty, ArenaOctree>;
+
+  constexpr int test_runs = 10;
+  constexpr int pointcount = 1000;
+  constexpr float resolution = 1.0f;
+
+  PointCloud<PointXYZ>::Ptr cloud (new PointCloud<PointXYZ> ());
+
+  OctreePointCloudPointVector<PointXYZ> octreeA (resolution);
+  ArenaOctreePointCloud octreeB (resolution);
+
+  for (int test = 0; test < test_runs; ++test)
+  {
+    cloud->clear ();
+    for (int point = 0; point < pointcount; point++)
+      cloud->push_back (PointXYZ (static_cast<float> (1024.0 * rand () / RAND_MAX),
+                                  static_cast<float> (1024.0 * rand () / RAND_MAX),
+                                  static_cast<float> (1024.0 * rand () / RAND_MAX)));
+
+    // the bounding box is adapted dynamically, which adds new root nodes
+    octreeA.deleteTree ();
+    octreeA.setInputCloud (cloud);
+    octreeA.addPointsFromInputCloud ();
+
+    octreeB.deleteTree ();
+    octreeB.setInputCloud (cloud);
+    octreeB.addPointsFromInputCloud ();
+
+    ASSERT_EQ (octreeA.getLeafCount (), octreeB.getLeafCount ());
+    ASSERT_EQ (octreeA.getBranchCount (), octreeB.getBranchCount ());
+
+    ArenaOctreePointCloud::AlignedPointTVector centersA, centersB;
+    octreeA.getOccupiedVoxelCenters (centersA);
+    octreeB.getOccupiedVoxelCenters (centersB);
+    ASSERT_EQ (centersA.size (), centersB.size ());
+    for (std::size_t i = 0; i < centersA.size (); ++i)
+      EXPECT_EQ (centersA[i].getVector3fMap (), centersB[i].getVector3fMap ());
+
+    // copies allocate their nodes from their own arena
+    ArenaOctree octreeC (octreeB);
+    ASSERT_EQ (octreeB.getLeafCount (), octreeC.getLeafCount ());
+    std::vector<char> treeB, treeC;
+    octreeB.serializeTree (treeB);
+    octreeC.serializeTree (treeC);
+    EXPECT_EQ (treeB, treeC);
+  }
+}
+
+TEST (PCL, Octree_Memory_Usage)
+{
+  using ArenaOctree = OctreeBase<OctreeContainerPointIndices, OctreeContainerEmpty, OctreeNodeArena>;
+  using ArenaOctreePointCloud = OctreePointCloud<PointXYZ, OctreeContainerPointIndices, OctreeContainerEmpty, ArenaOctree>;
+
+  PointCloud<PointXYZ>::Ptr cloud (new PointCloud<PointXYZ> ());
+  for (int point = 0; point < 1000; point++)
+    cloud->push_back (PointXYZ (static_cast<float> (64.0 * rand () / RAND_MAX),
+                                static_cast<float> (64.0 * rand () / RAND_MAX),
+                                static_cast<float> (64.0 * rand () / RAND_MAX)));
+
+  // trees without dynamic container memory
+  OctreeBase<int> octree_int;
+  const std::size_t empty_memory = octree_int.getMemoryUsage ();
+  EXPECT_GE (empty_memory, sizeof (octree_int));
+  octree_int.setTreeDepth (4);
+  octree_int.createLeaf (1, 2, 3);
+  EXPECT_GT (octree_int.getMemoryUsage (), empty_memory);
+
+  OctreePointCloudSearch<PointXYZ> octreeA (1.0);
+  octreeA.setInputCloud (cloud);
+  const std::size_t memory_before = octreeA.getMemoryUsage ();
+  octreeA.addPointsFromInputCloud ();
+
+  // nodes plus at least one index per point
+  const std::size_t expected =
+      octreeA.getLeafCount () * sizeof (OctreePointCloudSearch<PointXYZ>::LeafNode) +
+      octreeA.getBranchCount () * sizeof (OctreePointCloudSearch<PointXYZ>::BranchNode) +
+      cloud->size () * sizeof (int);
+  EXPECT_GE (octreeA.getMemoryUsage (), memory_before + expected - sizeof (OctreePointCloudSearch<PointXYZ>::BranchNode));
+
+  // the arena keeps whole blocks
+  ArenaOctreePointCloud octreeB (1.0);
+  octreeB.setInputCloud (cloud);
+  octreeB.addPointsFromInputCloud ();
+  const std::size_t arena_memory = octreeB.getMemoryUsage ();
+  EXPECT_GE (arena_memory, 4096 * sizeof (ArenaOctreePointCloud::LeafNode));
+  octreeB.deleteTree ();
+  EXPECT_GE (octreeB.getMemoryUsage (), 4096 * sizeof (ArenaOctreePointCloud::LeafNode));
+}
+
+TEST (PCL, Octree_Pointcloud_Bulk_Build)
+{
+  constexpr int pointcount = 20000;
+  constexpr float resolution = 4.0f;
+
+  PointCloud<PointXYZ>::Ptr cloud (new PointCloud<PointXYZ> ());
+  for (int point = 0; point < pointcount; point++)
+    cloud->push_back (PointXYZ (static_cast<float> (256.0 * rand () / RAND_MAX),
+                                static_cast<float> (256.0 * rand () / RAND_MAX),
+                                static_cast<float> (256.0 * rand () / RAND_MAX)));
+
+  // reference: add points one by one
+  OctreePointCloudPointVector<PointXYZ> octreeA (resolution);
+  octreeA.setInputCloud (cloud);
+  for (int point = 0; point < pointcount; point++)
+    octreeA.addPointFromCloud (point, IndicesPtr ());
+
+  for (const unsigned int threads : {1u, 4u})
+  {
+    OctreePointCloudPointVector<PointXYZ> octreeB (resolution);
+    octreeB.setNumberOfThreads (threads);
+    octreeB.setInputCloud (cloud);
+    octreeB.addPointsFromInputCloud ();
+
+    ASSERT_EQ (octreeA.getLeafCount (), octreeB.getLeafCount ());
+    ASSERT_EQ (octreeA.getBranchCount (), octreeB.getBranchCount ());
+
+    double minxA, minyA, minzA, maxxA, maxyA, maxzA;
+    double minxB, minyB, minzB, maxxB, maxyB, maxzB;
+    octreeA.getBoundingBox (minxA, minyA, minzA, maxxA, maxyA, maxzA);
+    octreeB.getBoundingBox (minxB, minyB, minzB, maxxB, maxyB, maxzB);
+    EXPECT_EQ (minxA, minxB);
+    EXPECT_EQ (minyA, minyB);
+    EXPECT_EQ (minzA, minzB);
+    EXPECT_EQ (maxxA, maxxB);
+
+    // same leaves with the same point indices in the same order
+    auto it_a = octreeA.leaf_depth_begin ();
+    auto it_b = octreeB.leaf_depth_begin ();
+    for (; it_a != octreeA.leaf_depth_end () && it_b != octreeB.leaf_depth_end (); ++it_a, ++it_b)
+    {
+      ASSERT_EQ (it_a.getCurrentOctreeKey (), it_b.getCurrentOctreeKey ());
+      std::vector<int> indicesA, indicesB;
+      it_a.getLeafContainer ().getPointIndices (indicesA);
+      it_b.getLeafContainer ().getPointIndices (indicesB);
+      ASSERT_EQ (indicesA, indicesB);
+    }
+    EXPECT_TRUE (it_a == octreeA.leaf_depth_end ());
+    EXPECT_TRUE (it_b == octreeB.leaf_depth_end ());
+  }
+}
+
+TEST (PCL, Octree_Pointcloud_Insertion_Queue)
+{
+  constexpr int producers = 4;
+  constexpr int batches_per_producer = 20;
+  constexpr int batch_size = 250;
+
+  PointCloud<PointXYZ>::Ptr cloud (new PointCloud<PointXYZ> ());
+  OctreePointCloudPointVector<PointXYZ> octree (2.0);
+  octree.setInputCloud (cloud);
+
+  OctreePointCloudInsertionQueue<PointXYZ> queue;
+  std::vector<std::thread> threads;
+  for (int producer = 0; producer < producers; ++producer)
+    threads.emplace_back ([&queue, producer] ()
+    {
+      std::mt19937 rng (producer);
+      std::uniform_real_distribution<float> coord (-50.0f, 50.0f);
+      for (int batch = 0; batch < batches_per_producer; ++batch)
+      {
+        PointCloud<PointXYZ> points;
+        for (int point = 0; point < batch_size; ++point)
+          points.push_back (PointXYZ (coord (rng), coord (rng), coord (rng)));
+        queue.push (points);
+      }
+    });
+
+  // insert while the producers are still running
+  std::size_t added = octree.addPointsFromQueue (queue, cloud);
+  for (auto& thread : threads)
+    thread.join ();
+  added += octree.addPointsFromQueue (queue, cloud);
+
+  constexpr std::size_t total = producers * batches_per_producer * batch_size;
+  EXPECT_EQ (total, added);
+  EXPECT_EQ (total, cloud->size ());
+  EXPECT_EQ (0u, queue.size ());
+
+  // same leaves as building the octree from the final cloud
+  OctreePointCloudPointVector<PointXYZ> reference (2.0);
+  reference.setInputCloud (cloud);
+  for (std::size_t point = 0; point < cloud->size (); point++)
+    reference.addPointFromCloud (static_cast<int> (point), IndicesPtr ());
+
+  ASSERT_EQ (reference.getLeafCount (), octree.getLeafCount ());
+  std::size_t point_count = 0;
+  auto it_a = reference.leaf_depth_begin ();
+  auto it_b = octree.leaf_depth_begin ();
+  for (; it_a != reference.leaf_depth_end () && it_b != octree.leaf_depth_end (); ++it_a, ++it_b)
+  {
+    ASSERT_EQ (it_a.getCurrentOctreeKey (), it_b.getCurrentOctreeKey ());
+    std::vector<int> indicesA, indicesB;
+    it_a.getLeafContainer ().getPointIndices (indicesA);
+    it_b.getLeafContainer ().getPointIndices (indicesB);
+    std::sort (indicesA.begin (), indicesA.end ());
+    std::sort (indicesB.begin (), indicesB.end ());
+    ASSERT_EQ (indicesA, indicesB);
+    point_count += indicesB.size ();
+  }
+  EXPECT_EQ (total, point_count);
+}
+
 TEST (PCL, Octree_Pointcloud_Density_Test)
 {
   // instantiate point cloud and fill it with point data
@@ -1220,6 +1474,73 @@ TEST (PCL, Octree_Pointcloud_Nearest_K_Neighbour_Search)
   }
 }
 
+TEST (PCL, Octree_Pointcloud_Batch_Search)
+{
+  constexpr int pointcount = 5000;
+  constexpr int querycount = 500;
+  constexpr int k = 8;
+  constexpr double radius = 0.1;
+
+  PointCloud<PointXYZ>::Ptr cloud (new PointCloud<PointXYZ> ());
+  for (int point = 0; point < pointcount; point++)
+    cloud->push_back (PointXYZ (static_cast<float> (rand () / double (RAND_MAX)),
+                                static_cast<float> (rand () / double (RAND_MAX)),
+                                static_cast<float> (rand () / double (RAND_MAX))));
+
+  // queries inside and outside of the octree bounds, and one invalid point
+  PointCloud<PointXYZ> queries;
+  for (int point = 0; point < querycount; point++)
+    queries.push_back (PointXYZ (static_cast<float> (1.4 * rand () / RAND_MAX - 0.2),
+                                 static_cast<float> (1.4 * rand () / RAND_MAX - 0.2),
+                                 static_cast<float> (1.4 * rand () / RAND_MAX - 0.2)));
+  queries[querycount / 2].x = std::numeric_limits<float>::quiet_NaN ();
+
+  std::vector<int> query_indices;
+  for (int point = querycount - 1; point >= 0; point -= 2)
+    query_indices.push_back (point);
+
+  for (const unsigned int threads : {1u, 4u})
+  {
+    OctreePointCloudSearch<PointXYZ> octree (0.05);
+    octree.setNumberOfThreads (threads);
+    octree.setInputCloud (cloud);
+    octree.addPointsFromInputCloud ();
+
+    for (const auto& indices : {std::vector<int> (), query_indices})
+    {
+      std::vector<std::vector<int>> k_indices, radius_indices;
+      std::vector<std::vector<float>> k_sqr_distances, radius_sqr_distances;
+      octree.nearestKSearch (queries, indices, k, k_indices, k_sqr_distances);
+      octree.radiusSearch (queries, indices, radius, radius_indices, radius_sqr_distances);
+
+      const std::size_t nr_queries = indices.empty () ? queries.size () : indices.size ();
+      ASSERT_EQ (nr_queries, k_indices.size ());
+      ASSERT_EQ (nr_queries, radius_indices.size ());
+
+      for (std::size_t i = 0; i < nr_queries; ++i)
+      {
+        const PointXYZ& query = queries[indices.empty () ? i : indices[i]];
+        if (!isFinite (query))
+        {
+          EXPECT_TRUE (k_indices[i].empty ());
+          EXPECT_TRUE (radius_indices[i].empty ());
+          continue;
+        }
+
+        std::vector<int> single_indices;
+        std::vector<float> single_sqr_distances;
+        octree.nearestKSearch (query, k, single_indices, single_sqr_distances);
+        EXPECT_EQ (single_indices, k_indices[i]);
+        EXPECT_EQ (single_sqr_distances, k_sqr_distances[i]);
+
+        octree.radiusSearch (query, radius, single_indices, single_sqr_distances);
+        EXPECT_EQ (single_indices, radius_indices[i]);
+        EXPECT_EQ (single_sqr_distances, radius_sqr_distances[i]);
+      }
+    }
+  }
+}
+
 TEST (PCL, Octree_Pointcloud_Box_Search)
 {
   constexpr unsigned int test_runs = 30;
@@ -1529,6 +1850,61 @@ TEST (PCL, Octree_Pointcloud_Ray_Traversal)
   }
 }
 
+TEST (PCL, Octree_Pointcloud_Ray_Traversal_Batch)
+{
+  constexpr int pointcount = 5000;
+  constexpr int raycount = 1000;
+
+  PointCloud<PointXYZ>::Ptr cloud (new PointCloud<PointXYZ> ());
+  for (int point = 0; point < pointcount; point++)
+    cloud->push_back (PointXYZ (static_cast<float> (10.0 * rand () / RAND_MAX),
+                                static_cast<float> (10.0 * rand () / RAND_MAX),
+                                static_cast<float> (10.0 * rand () / RAND_MAX)));
+
+  // rays from outside and inside of the octree bounds
+  std::vector<Eigen::Vector3f> origins, directions;
+  for (int ray = 0; ray < raycount; ray++)
+  {
+    origins.emplace_back (static_cast<float> (14.0 * rand () / RAND_MAX - 2.0),
+                          static_cast<float> (14.0 * rand () / RAND_MAX - 2.0),
+                          static_cast<float> (14.0 * rand () / RAND_MAX - 2.0));
+    directions.emplace_back (static_cast<float> (2.0 * rand () / RAND_MAX - 1.0),
+                             static_cast<float> (2.0 * rand () / RAND_MAX - 1.0),
+                             static_cast<float> (2.0 * rand () / RAND_MAX - 1.0));
+  }
+
+  for (const unsigned int threads : {1u, 4u})
+  {
+    octree::OctreePointCloudSearch<PointXYZ> octree_search (0.5f);
+    octree_search.setNumberOfThreads (threads);
+    octree_search.setInputCloud (cloud);
+    octree_search.addPointsFromInputCloud ();
+
+    for (const int max_voxel_count : {0, 1})
+    {
+      std::vector<pcl::PointCloud<pcl::PointXYZ>::VectorType> voxel_center_lists;
+      std::vector<std::vector<int> > indices_lists;
+      octree_search.getIntersectedVoxelCenters (origins, directions, voxel_center_lists, max_voxel_count);
+      octree_search.getIntersectedVoxelIndices (origins, directions, indices_lists, max_voxel_count);
+      ASSERT_EQ (origins.size (), voxel_center_lists.size ());
+      ASSERT_EQ (origins.size (), indices_lists.size ());
+
+      for (std::size_t i = 0; i < origins.size (); ++i)
+      {
+        pcl::PointCloud<pcl::PointXYZ>::VectorType voxel_centers;
+        std::vector<int> indices;
+        octree_search.getIntersectedVoxelCenters (origins[i], directions[i], voxel_centers, max_voxel_count);
+        octree_search.getIntersectedVoxelIndices (origins[i], directions[i], indices, max_voxel_count);
+
+        ASSERT_EQ (voxel_centers.size (), voxel_center_lists[i].size ());
+        for (std::size_t j = 0; j < voxel_centers.size (); ++j)
+          EXPECT_EQ (voxel_centers[j].getVector3fMap (), voxel_center_lists[i][j].getVector3fMap ());
+        EXPECT_EQ (indices, indices_lists[i]);
+      }
+    }
+  }
+}
+
 TEST (PCL, Octree_Pointcloud_Adjacency)
 {
   constexpr unsigned int test_runs = 100;
@@ -1600,6 +1976,47 @@ TEST (PCL, Octree_Pointcloud_Adjacency)
   }
 }
 
+TEST (PCL, Octree_Pointcloud_Adjacency_Threads)
+{
+  std::mt19937 rng (42);
+  std::uniform_real_distribution<float> coordinate (0.0f, 1.0f);
+  PointCloud<PointXYZ>::Ptr cloudIn (new PointCloud<PointXYZ> ());
+  for (std::size_t i = 0; i < 20000; ++i)
+    cloudIn->push_back (PointXYZ (coordinate (rng), coordinate (rng), 0.1f * coordinate (rng)));
+
+  // The leaves, their data and their neighbors do not depend on the number of threads
+  OctreePointCloudAdjacency<PointXYZ> octree (0.02);
+  octree.setInputCloud (cloudIn);
+  octree.addPointsFromInputCloud ();
+
+  OctreePointCloudAdjacency<PointXYZ> octree_mt (0.02);
+  octree_mt.setNumberOfThreads (4);
+  octree_mt.setInputCloud (cloudIn);
+  octree_mt.addPointsFromInputCloud ();
+
+  ASSERT_EQ (octree.size (), octree_mt.size ());
+  for (std::size_t i = 0; i < octree.size (); ++i)
+  {
+    EXPECT_EQ (octree.at (i)->size (), octree_mt.at (i)->size ());
+    EXPECT_EQ (octree.at (i)->getPointCounter (), octree_mt.at (i)->getPointCounter ());
+    EXPECT_EQ (octree.at (i)->getData ().getVector3fMap (), octree_mt.at (i)->getData ().getVector3fMap ());
+  }
+
+  // Same for the voxel centroids, which are in depth first order
+  OctreePointCloudVoxelCentroid<PointXYZ> centroid_octree (0.02);
+  centroid_octree.setInputCloud (cloudIn);
+  centroid_octree.addPointsFromInputCloud ();
+  pcl::PointCloud<PointXYZ>::VectorType centroids, centroids_mt;
+  centroid_octree.getVoxelCentroids (centroids);
+  centroid_octree.setNumberOfThreads (4);
+  centroid_octree.getVoxelCentroids (centroids_mt);
+
+  ASSERT_EQ (centroid_octree.getLeafCount (), centroids.size ());
+  ASSERT_EQ (centroids.size (), centroids_mt.size ());
+  for (std::size_t i = 0; i < centroids.size (); ++i)
+    EXPECT_EQ (centroids[i].getVector3fMap (), centroids_mt[i].getVector3fMap ());
+}
+
 TEST (PCL, Octree_Pointcloud_Bounds)
 {
     const double SOME_RESOLUTION (10 + 1/3.0);
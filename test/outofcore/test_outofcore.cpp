@@ -45,8 +45,10 @@
 #include <pcl/test/gtest.h>
 
 #include <vector>
+#include <algorithm>
 #include <iostream>
 #include <random>
+#include <tuple>
 
 #include <pcl/common/time.h>
 
@@ -57,6 +59,7 @@
 #include <pcl/outofcore/outofcore_impl.h>
 
 #include <pcl/PCLPointCloud2.h>
+#include <pcl/io/pcd_io.h>
 
 using namespace pcl::outofcore;
 
@@ -569,6 +572,82 @@ TEST_F (OutofcoreTest, Outofcore_PointsOnBoundaries)
 
 }
 
+TEST_F (OutofcoreTest, Outofcore_DiskContainerRanges)
+{
+  const boost::filesystem::path container_path ("disk_container");
+  boost::filesystem::remove_all (container_path);
+  boost::filesystem::create_directory (container_path);
+
+  AlignedPointTVector some_points;
+  for (unsigned int i = 0; i < 250; i++)
+    some_points.push_back (PointT (static_cast<float> (i), static_cast<float> (rand () % 1024), static_cast<float> (rand () % 1024)));
+
+  //appended ranges are read back in place
+  const boost::filesystem::path raw_file = container_path / "raw.pcd";
+  {
+    OutofcoreOctreeDiskContainer<PointT> container (raw_file);
+    container.insertRange (some_points.data (), 100);
+    container.insertRange (some_points.data () + 100, 150);
+    ASSERT_EQ (250u, container.size ());
+
+    AlignedPointTVector range;
+    container.readRange (100, 50, range);
+    ASSERT_EQ (50u, range.size ());
+    for (std::size_t i = 0; i < range.size (); i++)
+      EXPECT_TRUE (compPt (some_points[100 + i], range[i]));
+
+    AlignedPointTVector sample;
+    container.readRangeSubSample (0, 250, 0.2, sample);
+    EXPECT_FALSE (sample.empty ());
+    for (const auto& p : sample)
+      EXPECT_TRUE (compPt (some_points[static_cast<std::size_t> (p.x)], p));
+  }
+
+  //the storage file stays a valid PCD file and can be reopened
+  pcl::PointCloud<PointT> cloud;
+  ASSERT_EQ (0, pcl::io::loadPCDFile (raw_file.string (), cloud));
+  ASSERT_EQ (250u, cloud.size ());
+  for (std::size_t i = 0; i < cloud.size (); i++)
+    EXPECT_TRUE (compPt (some_points[i], cloud[i]));
+
+  {
+    OutofcoreOctreeDiskContainer<PointT> container (raw_file);
+    ASSERT_EQ (250u, container.size ());
+
+    pcl::PCLPointCloud2::Ptr blob (new pcl::PCLPointCloud2 ());
+    container.readRange (240, 10, blob);
+    pcl::PointCloud<PointT> blob_cloud;
+    pcl::fromPCLPointCloud2 (*blob, blob_cloud);
+    ASSERT_EQ (10u, blob_cloud.size ());
+    for (std::size_t i = 0; i < blob_cloud.size (); i++)
+      EXPECT_TRUE (compPt (some_points[240 + i], blob_cloud[i]));
+  }
+
+  //compressed files of older trees are converted when points are appended
+  const boost::filesystem::path compressed_file = container_path / "compressed.pcd";
+  pcl::PointCloud<PointT> first_points;
+  first_points.insert (first_points.end (), some_points.begin (), some_points.begin () + 20);
+  pcl::io::savePCDFileBinaryCompressed (compressed_file.string (), first_points);
+  {
+    OutofcoreOctreeDiskContainer<PointT> container (compressed_file);
+    ASSERT_EQ (20u, container.size ());
+
+    AlignedPointTVector range;
+    container.readRange (5, 5, range);
+    ASSERT_EQ (5u, range.size ());
+    EXPECT_TRUE (compPt (some_points[5], range[0]));
+
+    container.insertRange (some_points.data () + 20, 10);
+    range.clear ();
+    container.readRange (0, 30, range);
+    ASSERT_EQ (30u, range.size ());
+    for (std::size_t i = 0; i < range.size (); i++)
+      EXPECT_TRUE (compPt (some_points[i], range[i]));
+  }
+
+  boost::filesystem::remove_all (container_path);
+}
+
 /*
 TEST_F (OutofcoreTest, Outofcore_PointCloud2Basic)
 {
@@ -733,6 +812,235 @@ TEST_F (OutofcoreTest, PointCloud2_Constructors)
   EXPECT_EQ (octreeB.addPointCloud_and_genLOD (point_cloud), point_cloud->width*point_cloud->height) << "Number of points inserted when generating LOD does not match the size of the point cloud\n";
 }
 
+TEST_F (OutofcoreTest, Outofcore_ParallelInsertion)
+{
+  cleanUpFilesystem ();
+
+  const Eigen::Vector3d min (-1024.0, -1024.0, -1024.0);
+  const Eigen::Vector3d max (1024.0, 1024.0, 1024.0);
+
+  pcl::PointCloud<PointT>::Ptr test_cloud (new pcl::PointCloud<PointT> ());
+  for (std::size_t i = 0; i < numPts; i++)
+    test_cloud->push_back (PointT (static_cast<float> (rand () % 2000 - 1000), static_cast<float> (rand () % 2000 - 1000), static_cast<float> (rand () % 2000 - 1000)));
+
+  pcl::PCLPointCloud2::Ptr point_cloud (new pcl::PCLPointCloud2);
+  pcl::toPCLPointCloud2 (*test_cloud, *point_cloud);
+
+  //the same points inserted serially, and in parallel as point vector and as PCLPointCloud2
+  const std::uint64_t depth = 4;
+  octree_disk octreeA (depth, min, max, filename_otreeA, "ECEF");
+  octree_disk octreeB (depth, min, max, filename_otreeB, "ECEF");
+  octree_disk octreeC (depth, min, max, outofcore_path, "ECEF");
+  octreeB.setNumberOfThreads (4);
+  octreeC.setNumberOfThreads (4);
+
+  EXPECT_EQ (test_cloud->size (), octreeA.addPointCloud (test_cloud));
+  EXPECT_EQ (test_cloud->size (), octreeB.addPointCloud (test_cloud));
+  EXPECT_EQ (test_cloud->size (), octreeC.addPointCloud (point_cloud, false));
+
+  EXPECT_EQ (test_cloud->size (), octreeB.getNumPointsAtDepth (depth));
+  EXPECT_EQ (test_cloud->size (), octreeC.getNumPointsAtDepth (depth));
+
+  //every leaf holds the same points
+  const Eigen::Vector3d query_min (-500.0, -300.0, -1024.0);
+  const Eigen::Vector3d query_max (700.0, 1024.0, 100.0);
+  AlignedPointTVector points_a, points_b, points_c;
+  octreeA.queryBBIncludes (query_min, query_max, depth, points_a);
+  octreeB.queryBBIncludes (query_min, query_max, depth, points_b);
+  octreeC.queryBBIncludes (query_min, query_max, depth, points_c);
+
+  const auto less = [] (const PointT& p1, const PointT& p2)
+  {
+    return (std::tie (p1.x, p1.y, p1.z) < std::tie (p2.x, p2.y, p2.z));
+  };
+  std::sort (points_a.begin (), points_a.end (), less);
+  std::sort (points_b.begin (), points_b.end (), less);
+  std::sort (points_c.begin (), points_c.end (), less);
+
+  EXPECT_FALSE (points_a.empty ());
+  ASSERT_EQ (points_a.size (), points_b.size ());
+  ASSERT_EQ (points_a.size (), points_c.size ());
+  for (std::size_t i = 0; i < points_a.size (); i++)
+  {
+    EXPECT_TRUE (compPt (points_a[i], points_b[i]));
+    EXPECT_TRUE (compPt (points_a[i], points_c[i]));
+  }
+}
+
+TEST_F (OutofcoreTest, Outofcore_BottomUpLOD)
+{
+  cleanUpFilesystem ();
+
+  const Eigen::Vector3d min (-1024.0, -1024.0, -1024.0);
+  const Eigen::Vector3d max (1024.0, 1024.0, 1024.0);
+
+  pcl::PointCloud<PointT>::Ptr test_cloud (new pcl::PointCloud<PointT> ());
+  for (std::size_t i = 0; i < numPts; i++)
+    test_cloud->push_back (PointT (static_cast<float> (rand () % 2000 - 1000), static_cast<float> (rand () % 2000 - 1000), static_cast<float> (rand () % 2000 - 1000)));
+
+  const std::uint64_t depth = 4;
+  octree_disk octreeA (depth, min, max, filename_otreeA, "ECEF");
+  octree_disk octreeB (depth, min, max, filename_otreeB, "ECEF");
+  octree_disk octreeC (depth, min, max, outofcore_path, "ECEF");
+  octreeB.setNumberOfThreads (4);
+  octreeC.setNumberOfThreads (4);
+
+  ASSERT_EQ (test_cloud->size (), octreeA.addPointCloud (test_cloud));
+  ASSERT_EQ (test_cloud->size (), octreeB.addPointCloud (test_cloud));
+  ASSERT_EQ (test_cloud->size (), octreeC.addPointCloud (test_cloud));
+
+  //random sampling gives the same LOD regardless of the number of threads
+  octreeA.setSamplePercent (0.25);
+  octreeB.setSamplePercent (0.25);
+  octreeA.buildLODBottomUp ();
+  octreeB.buildLODBottomUp ();
+  //rebuilding replaces the LOD instead of adding to it
+  octreeB.buildLODBottomUp ();
+
+  for (std::uint64_t i = 0; i < depth; i++)
+  {
+    EXPECT_GE (octreeA.getNumPointsAtDepth (i), 1) << "No points in the LOD indicates buildLODBottomUp failed\n";
+    EXPECT_LE (octreeA.getNumPointsAtDepth (i), octreeA.getNumPointsAtDepth (i + 1));
+    EXPECT_EQ (octreeA.getNumPointsAtDepth (i), octreeB.getNumPointsAtDepth (i));
+  }
+  EXPECT_EQ (test_cloud->size (), octreeA.getNumPointsAtDepth (depth)) << "Points in leaves were lost while building LOD!\n";
+
+  AlignedPointTVector points_a, points_b;
+  octreeA.queryBBIncludes (min, max, 2, points_a);
+  octreeB.queryBBIncludes (min, max, 2, points_b);
+  EXPECT_EQ (octreeA.getNumPointsAtDepth (2), points_a.size ());
+  ASSERT_EQ (points_a.size (), points_b.size ());
+  for (std::size_t i = 0; i < points_a.size (); i++)
+    EXPECT_TRUE (compPt (points_a[i], points_b[i]));
+
+  //voxel sampling keeps at most one point per cell of each node
+  octreeC.buildLODBottomUp (2);
+  EXPECT_GE (octreeC.getNumPointsAtDepth (0), 1);
+  EXPECT_LE (octreeC.getNumPointsAtDepth (0), 8);
+  for (std::uint64_t i = 1; i < depth; i++)
+  {
+    EXPECT_GE (octreeC.getNumPointsAtDepth (i), octreeC.getNumPointsAtDepth (i - 1));
+    EXPECT_LE (octreeC.getNumPointsAtDepth (i), octreeC.getNumPointsAtDepth (i + 1));
+  }
+  EXPECT_EQ (test_cloud->size (), octreeC.getNumPointsAtDepth (depth));
+}
+
+TEST_F (OutofcoreTest, Outofcore_NodeIndex)
+{
+  cleanUpFilesystem ();
+
+  const Eigen::Vector3d min (-1024.0, -1024.0, -1024.0);
+  const Eigen::Vector3d max (1024.0, 1024.0, 1024.0);
+  const std::uint64_t depth = 4;
+
+  pcl::PointCloud<PointT>::Ptr test_cloud (new pcl::PointCloud<PointT> ());
+  for (std::size_t i = 0; i < numPts; i++)
+    test_cloud->push_back (PointT (static_cast<float> (rand () % 1000), static_cast<float> (rand () % 1000), static_cast<float> (rand () % 1000)));
+
+  {
+    octree_disk octree (depth, min, max, filename_otreeA, "ECEF");
+    ASSERT_EQ (test_cloud->size (), octree.addPointCloud (test_cloud));
+    EXPECT_TRUE (octree.saveNodeIndex ());
+  }
+  ASSERT_TRUE (boost::filesystem::exists (filename_otreeA.parent_path () / "tree_test.oct_bin"));
+
+  //without the JSON metadata of the nodes below the root, the tree can only be opened through the node index
+  std::vector<boost::filesystem::path> node_metadata;
+  for (boost::filesystem::recursive_directory_iterator it (filename_otreeA.parent_path ()), end; it != end; ++it)
+  {
+    if (boost::filesystem::extension (it->path ()) == ".oct_idx" && it->path ().parent_path () != filename_otreeA.parent_path ())
+      node_metadata.push_back (it->path ());
+  }
+  ASSERT_FALSE (node_metadata.empty ());
+  for (const boost::filesystem::path& path : node_metadata)
+    boost::filesystem::remove (path);
+
+  pcl::PointCloud<PointT>::Ptr second_cloud (new pcl::PointCloud<PointT> ());
+  for (std::size_t i = 0; i < numPts; i++)
+    second_cloud->push_back (PointT (static_cast<float> (-(rand () % 1000)), static_cast<float> (-(rand () % 1000)), static_cast<float> (-(rand () % 1000))));
+
+  {
+    octree_disk octree (filename_otreeA, true);
+    AlignedPointTVector points_in_tree;
+    octree.queryBBIncludes (min, max, depth, points_in_tree);
+    EXPECT_EQ (test_cloud->size (), points_in_tree.size ());
+
+    //the index is rewritten with the new nodes when the tree is saved
+    ASSERT_EQ (second_cloud->size (), octree.addPointCloud (second_cloud));
+  }
+
+  octree_disk octree (filename_otreeA, false);
+  AlignedPointTVector points_in_tree;
+  octree.queryBBIncludes (min, max, depth, points_in_tree);
+  EXPECT_EQ (test_cloud->size () + second_cloud->size (), points_in_tree.size ());
+}
+
+TEST_F (OutofcoreTest, Outofcore_PackedNodes)
+{
+  cleanUpFilesystem ();
+
+  const Eigen::Vector3d min (-1024.0, -1024.0, -1024.0);
+  const Eigen::Vector3d max (1024.0, 1024.0, 1024.0);
+  const std::uint64_t depth = 4;
+
+  pcl::PointCloud<PointT>::Ptr test_cloud (new pcl::PointCloud<PointT> ());
+  for (std::size_t i = 0; i < numPts; i++)
+    test_cloud->push_back (PointT (static_cast<float> (rand () % 2000 - 1000), static_cast<float> (rand () % 2000 - 1000), static_cast<float> (rand () % 2000 - 1000)));
+
+  const auto less = [] (const PointT& p1, const PointT& p2)
+  {
+    return (std::tie (p1.x, p1.y, p1.z) < std::tie (p2.x, p2.y, p2.z));
+  };
+
+  const Eigen::Vector3d query_min (-500.0, -300.0, -1024.0);
+  const Eigen::Vector3d query_max (700.0, 1024.0, 100.0);
+  AlignedPointTVector points_before;
+
+  {
+    octree_disk octree (depth, min, max, filename_otreeA, "ECEF");
+    ASSERT_EQ (test_cloud->size (), octree.addPointCloud (test_cloud));
+    octree.setSamplePercent (0.25);
+    octree.buildLODBottomUp ();
+    octree.queryBBIncludes (query_min, query_max, depth, points_before);
+
+    ASSERT_TRUE (octree.packNodes (true));
+
+    //the nodes read their points from the pack right away
+    AlignedPointTVector points_packed;
+    octree.queryBBIncludes (query_min, query_max, depth, points_packed);
+    EXPECT_EQ (points_before.size (), points_packed.size ());
+
+    //packed trees are read-only
+    EXPECT_EQ (0, octree.addPointCloud (test_cloud));
+  }
+
+  //only the root node metadata, the tree metadata, the node index and the pack file are left
+  std::size_t file_count = 0;
+  for (boost::filesystem::directory_iterator it (filename_otreeA.parent_path ()), end; it != end; ++it)
+  {
+    EXPECT_FALSE (boost::filesystem::is_directory (it->path ()));
+    file_count++;
+  }
+  EXPECT_EQ (4, file_count);
+
+  octree_disk octree (filename_otreeA, true);
+  EXPECT_EQ (test_cloud->size (), octree.getNumPointsAtDepth (depth));
+
+  AlignedPointTVector points_after;
+  octree.queryBBIncludes (query_min, query_max, depth, points_after);
+  std::sort (points_before.begin (), points_before.end (), less);
+  std::sort (points_after.begin (), points_after.end (), less);
+  EXPECT_FALSE (points_before.empty ());
+  ASSERT_EQ (points_before.size (), points_after.size ());
+  for (std::size_t i = 0; i < points_before.size (); i++)
+    EXPECT_TRUE (compPt (points_before[i], points_after[i]));
+
+  //the LOD is packed as well
+  pcl::PCLPointCloud2::Ptr lod_cloud (new pcl::PCLPointCloud2 ());
+  octree.queryBBIncludes (min, max, 1, lod_cloud);
+  EXPECT_EQ (octree.getNumPointsAtDepth (1), lod_cloud->width * lod_cloud->height);
+}
+
 TEST_F (OutofcoreTest, PointCloud2_Insertion)
 {
   cleanUpFilesystem ();
@@ -158,6 +158,60 @@ TEST (PCL, GeometricConsistencyGrouping)
   EXPECT_LT (computeRmsE (model_, scene_, rototranslations[0]), 1E-4);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, GeometricConsistencyGroupingThreads)
+{
+  std::vector<Eigen::Matrix4f, Eigen::aligned_allocator<Eigen::Matrix4f> > rototranslations;
+  std::vector<Correspondences> clustered_corrs;
+
+  GeometricConsistencyGrouping<PointType, PointType> clusterer;
+  clusterer.setInputCloud (model_downsampled_);
+  clusterer.setSceneCloud (scene_downsampled_);
+  clusterer.setModelSceneCorrespondences (model_scene_corrs_);
+  clusterer.setGCSize (0.015);
+  clusterer.setGCThreshold (25);
+  clusterer.setNumberOfThreads (4);
+  EXPECT_TRUE (clusterer.recognize (rototranslations, clustered_corrs));
+
+  //Assertions
+  EXPECT_EQ (rototranslations.size (), 1);
+  EXPECT_EQ (clustered_corrs.size (), 1);
+  EXPECT_LT (computeRmsE (model_, scene_, rototranslations[0]), 1E-4);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, HoughSpace3DMerge)
+{
+  const Eigen::Vector3d min_coord (0, 0, 0), bin_size (0.1, 0.1, 0.1), max_coord (1, 1, 1);
+  recognition::HoughSpace3D single (min_coord, bin_size, max_coord);
+  recognition::HoughSpace3D first (min_coord, bin_size, max_coord);
+  recognition::HoughSpace3D second (min_coord, bin_size, max_coord);
+
+  // Votes cast into two spaces and merged equal the votes cast into one
+  const int n_votes = 500;
+  for (int i = 0; i < n_votes; ++i)
+  {
+    const Eigen::Vector3d vote (0.001 * i, 0.5 + 0.0007 * i, 0.9 - 0.0013 * i);
+    single.voteInt (vote, 1.0, i);
+    if (i < n_votes / 2)
+      first.voteInt (vote, 1.0, i);
+    else
+      second.voteInt (vote, 1.0, i);
+  }
+  EXPECT_TRUE (first.merge (second));
+
+  std::vector<double> single_values, merged_values;
+  std::vector<std::vector<int> > single_ids, merged_ids;
+  single.findMaxima (1.0, single_values, single_ids);
+  first.findMaxima (1.0, merged_values, merged_ids);
+  ASSERT_EQ (single_values.size (), merged_values.size ());
+  for (std::size_t i = 0; i < single_values.size (); ++i)
+    EXPECT_NEAR (single_values[i], merged_values[i], 1e-9);
+  EXPECT_EQ (single_ids, merged_ids);
+
+  recognition::HoughSpace3D other (min_coord, bin_size, Eigen::Vector3d (2, 2, 2));
+  EXPECT_FALSE (first.merge (other));
+}
 
 /* ---[ */
 int
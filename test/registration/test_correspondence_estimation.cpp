@@ -119,6 +119,46 @@ TEST (CorrespondenceEstimation, CorrespondenceEstimationSetSearchMethod)
   
 }
 
+//////////////////////////////////////////////////////////////////////////////////////
+TEST (CorrespondenceEstimation, Threads)
+{
+  pcl::PointCloud<pcl::PointXYZ>::Ptr cloud1 (new pcl::PointCloud<pcl::PointXYZ> ());
+  pcl::PointCloud<pcl::PointXYZ>::Ptr cloud2 (new pcl::PointCloud<pcl::PointXYZ> ());
+  for (std::size_t i = 0; i < 1000; i++)
+  {
+    cloud1->points.emplace_back (float (rand () % 1000), float (rand () % 1000), float (rand () % 1000));
+    cloud2->points.emplace_back (float (rand () % 1000), float (rand () % 1000), float (rand () % 1000));
+  }
+
+  pcl::registration::CorrespondenceEstimation<pcl::PointXYZ, pcl::PointXYZ> ce;
+  ce.setInputSource (cloud1);
+  ce.setInputTarget (cloud2);
+  pcl::Correspondences corr, corr_reciprocal;
+  ce.determineCorrespondences (corr, 50.0);
+  ce.determineReciprocalCorrespondences (corr_reciprocal, 50.0);
+  EXPECT_LT (corr_reciprocal.size (), corr.size ());
+
+  ce.setNumberOfThreads (4);
+  pcl::Correspondences corr_threads, corr_reciprocal_threads;
+  ce.determineCorrespondences (corr_threads, 50.0);
+  ce.determineReciprocalCorrespondences (corr_reciprocal_threads, 50.0);
+
+  // The correspondences are found in the same order
+  ASSERT_EQ (corr.size (), corr_threads.size ());
+  for (std::size_t i = 0; i < corr.size (); i++)
+  {
+    EXPECT_EQ (corr[i].index_query, corr_threads[i].index_query);
+    EXPECT_EQ (corr[i].index_match, corr_threads[i].index_match);
+    EXPECT_EQ (corr[i].distance, corr_threads[i].distance);
+  }
+  ASSERT_EQ (corr_reciprocal.size (), corr_reciprocal_threads.size ());
+  for (std::size_t i = 0; i < corr_reciprocal.size (); i++)
+  {
+    EXPECT_EQ (corr_reciprocal[i].index_query, corr_reciprocal_threads[i].index_query);
+    EXPECT_EQ (corr_reciprocal[i].index_match, corr_reciprocal_threads[i].index_match);
+  }
+}
+
 /* ---[ */
 int
   main (int argc, char** argv)
@@ -45,7 +45,9 @@
 #include <pcl/common/transforms.h>
 #include <pcl/io/pcd_io.h>
 #include <pcl/registration/correspondence_rejection_median_distance.h>
+#include <pcl/registration/correspondence_rejection_one_to_one.h>
 #include <pcl/registration/correspondence_rejection_poly.h>
+#include <pcl/registration/correspondence_rejection_sample_consensus.h>
 
 pcl::PointCloud<pcl::PointXYZ> cloud;
 
@@ -70,6 +72,74 @@ TEST (CorrespondenceRejectors, CorrespondenceRejectionMedianDistance)
   EXPECT_EQ (corresps_filtered.size (), 8);
   for (int i = 0; i < 8; ++i)
     EXPECT_NEAR (corresps_filtered[i].distance, static_cast<float> (i * i), 1e-5);
+
+  // Same rejection with the distances computed in parallel
+  rejector.setNumberOfThreads (4);
+  rejector.getCorrespondences (corresps_filtered);
+
+  EXPECT_EQ (corresps_filtered.size (), 8);
+  for (int i = 0; i < 8; ++i)
+    EXPECT_NEAR (corresps_filtered[i].distance, static_cast<float> (i * i), 1e-5);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (CorrespondenceRejectors, CorrespondenceRejectionOneToOne)
+{
+  // Matches 0 to 4, each with three queries at decreasing distances, and some invalid matches
+  pcl::Correspondences corresps;
+  for (int i = 0; i < 15; ++i)
+    corresps.emplace_back (i, 4 - i % 5, static_cast<float> (15 - i));
+  corresps.emplace_back (15, -1, 0.0f);
+  corresps.emplace_back (16, 2, 20.0f);
+  corresps.emplace_back (17, 2, 3.0f);
+
+  pcl::registration::CorrespondenceRejectorOneToOne rejector;
+  pcl::Correspondences corresps_filtered;
+  rejector.getRemainingCorrespondences (corresps, corresps_filtered);
+
+  // The closest correspondence of every match is kept, by increasing match index, the first one on equal distances
+  ASSERT_EQ (corresps_filtered.size (), 5);
+  for (int i = 0; i < 5; ++i)
+  {
+    EXPECT_EQ (corresps_filtered[i].index_match, i);
+    EXPECT_EQ (corresps_filtered[i].index_query, 14 - i);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (CorrespondenceRejectors, CorrespondenceRejectionSampleConsensusThreads)
+{
+  const int size = static_cast<int> (cloud.size ());
+
+  // Scramble the first half of the ground truth correspondences
+  pcl::Correspondences corr (size);
+  for (int i = 0; i < size; ++i)
+    corr[i].index_query = corr[i].index_match = i;
+  for (int i = 0; i < size / 2; ++i)
+    corr[i].index_match = (i + size / 4) % size;
+
+  pcl::PointCloud<pcl::PointXYZ> target;
+  Eigen::Vector3f t (0.1f, 0.2f, 0.3f);
+  Eigen::Quaternionf q (float (std::cos (0.5*M_PI_4)), 0.0f, 0.0f, float (std::sin (0.5*M_PI_4)));
+  pcl::transformPointCloud (cloud, target, t, q);
+
+  pcl::registration::CorrespondenceRejectorSampleConsensus<pcl::PointXYZ> reject;
+  reject.setInputSource (cloud.makeShared ());
+  reject.setInputTarget (target.makeShared ());
+  reject.setInlierThreshold (0.001);
+  reject.setNumberOfThreads (4);
+
+  pcl::Correspondences result;
+  reject.getRemainingCorrespondences (corr, result);
+
+  // The parallel RANSAC keeps the unscrambled correspondences
+  EXPECT_GE (result.size (), static_cast<std::size_t> (size - size / 2));
+  std::size_t true_positives = 0;
+  for (const auto &correspondence : result)
+    if (correspondence.index_query == correspondence.index_match)
+      ++true_positives;
+  EXPECT_EQ (true_positives, static_cast<std::size_t> (size - size / 2));
+  EXPECT_LE (result.size () - true_positives, static_cast<std::size_t> (size / 100));
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
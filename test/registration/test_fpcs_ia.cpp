@@ -84,6 +84,22 @@ TEST (PCL, FPCSInitialAlignment)
   //for (int i = 0; i < 4; ++i)
   //  for (int j = 0; j < 4; ++j)
   //    EXPECT_NEAR (transform_res_from_fpcs (i,j), transform_from_fpcs[i][j], 0.5);
+
+  // the same seed gives the same transformation with any number of threads
+  const auto align_with_seed = [&] (int threads)
+  {
+    FPCSInitialAlignment <PointXYZ, PointXYZ> seeded_ia;
+    seeded_ia.setInputSource (cloud_source_ptr);
+    seeded_ia.setInputTarget (cloud_target_ptr);
+    seeded_ia.setNumberOfThreads (threads);
+    seeded_ia.setApproxOverlap (approx_overlap);
+    seeded_ia.setDelta (delta, true);
+    seeded_ia.setNumberOfSamples (nr_samples);
+    seeded_ia.setSeed (42);
+    seeded_ia.align (source_aligned);
+    return (Eigen::Matrix4f (seeded_ia.getFinalTransformation ()));
+  };
+  EXPECT_EQ (align_with_seed (1), align_with_seed (4));
 }
 
 
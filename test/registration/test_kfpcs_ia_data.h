@@ -1,6 +1,6 @@
 #pragma once
 
-const int nr_threads = 1;
+const int nr_threads = 2;
 const float voxel_size = 0.1f;
 const float approx_overlap = 0.9f;
 const float abort_score = 0.0f;
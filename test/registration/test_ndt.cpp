@@ -94,6 +94,45 @@ TEST (PCL, NormalDistributionsTransform)
   }
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, NormalDistributionsTransformNeighborSearch)
+{
+  using PointT = PointNormal;
+  using NDT = NormalDistributionsTransform<PointT, PointT>;
+  PointCloud<PointT>::Ptr src (new PointCloud<PointT>);
+  copyPointCloud (cloud_source, *src);
+  PointCloud<PointT>::Ptr tgt (new PointCloud<PointT>);
+  copyPointCloud (cloud_target, *tgt);
+  PointCloud<PointT> output;
+
+  NDT reg;
+  reg.setStepSize (0.05);
+  reg.setResolution (0.025f);
+  reg.setInputSource (src);
+  reg.setInputTarget (tgt);
+  reg.setMaximumIterations (50);
+  reg.setTransformationEpsilon (1e-8);
+  EXPECT_EQ (reg.getNeighborSearchMethod (), NDT::KDTREE);
+  reg.align (output);
+  const Eigen::Matrix4f serial_transformation = reg.getFinalTransformation ();
+
+  // The partial sums are added in another order, the alignment converges to the same pose
+  reg.setNumberOfThreads (4);
+  reg.align (output);
+  EXPECT_EQ (output.size (), cloud_source.size ());
+  EXPECT_LT (reg.getFitnessScore (), 0.001);
+  EXPECT_TRUE (reg.getFinalTransformation ().isApprox (serial_transformation, 1e-3f));
+
+  for (const auto method : {NDT::DIRECT26, NDT::DIRECT7, NDT::DIRECT1})
+  {
+    reg.setNeighborSearchMethod (method);
+    EXPECT_EQ (reg.getNeighborSearchMethod (), method);
+    reg.align (output);
+    EXPECT_EQ (output.size (), cloud_source.size ());
+    EXPECT_LT (reg.getFitnessScore (), 0.001);
+  }
+}
+
 int
 main (int argc, char** argv)
 {
@@ -48,6 +48,13 @@
 #include <pcl/registration/icp_nl.h>
 #include <pcl/registration/gicp.h>
 #include <pcl/registration/gicp6d.h>
+#include <pcl/registration/voxelized_gicp.h>
+#include <pcl/registration/ndt.h>
+#include <pcl/registration/ndt_2d.h>
+#include <pcl/registration/prepared_target.h>
+#include <pcl/registration/multi_resolution_registration.h>
+#include <pcl/registration/incremental_registration.h>
+#include <pcl/registration/local_map.h>
 #include <pcl/registration/transformation_estimation_point_to_plane.h>
 #include <pcl/registration/transformation_validation_euclidean.h>
 #include <pcl/registration/correspondence_rejection_median_distance.h>
@@ -57,9 +64,16 @@
 #include <pcl/registration/pyramid_feature_matching.h>
 #include <pcl/features/ppf.h>
 #include <pcl/registration/ppf_registration.h>
+#include <pcl/registration/lum.h>
+#include <pcl/registration/elch.h>
 #include <pcl/filters/voxel_grid.h>
 // We need Histogram<2> to function, so we'll explicitly add kdtree_flann.hpp here
 #include <pcl/kdtree/impl/kdtree_flann.hpp>
+
+#include <random>
+#include <set>
+#include <thread>
+#include <tuple>
 //(pcl::Histogram<2>)
 
 using namespace pcl;
@@ -364,6 +378,70 @@ TEST (PCL, JointIterativeClosestPoint)
   }
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, JointIterativeClosestPointThreads)
+{
+  JointIterativeClosestPoint<PointXYZ, PointXYZ> reg, reg_threads;
+  reg_threads.setNumberOfThreads (4);
+  Eigen::Affine3f delta_transform;
+  sampleRandomTransform (delta_transform, 0., 0.05);
+  for (std::size_t i = 0; i < 8; i++)
+  {
+    Eigen::Affine3f net_transform;
+    sampleRandomTransform (net_transform, 2*M_PI, 10.);
+    PointCloud<PointXYZ>::Ptr source_trans (new PointCloud<PointXYZ>);
+    PointCloud<PointXYZ>::Ptr target_trans (new PointCloud<PointXYZ>);
+    pcl::transformPointCloud (cloud_source, *source_trans, delta_transform.inverse () * net_transform);
+    pcl::transformPointCloud (cloud_source, *target_trans, net_transform);
+    for (auto r : {&reg, &reg_threads})
+    {
+      r->setMaximumIterations (50);
+      r->setTransformationEpsilon (1e-8);
+      r->setMaxCorrespondenceDistance (0.25);
+      r->addInputSource (source_trans);
+      r->addInputTarget (target_trans);
+    }
+  }
+
+  // The pairs are estimated concurrently but their correspondences are merged in the same order
+  reg.align (cloud_reg);
+  reg_threads.align (cloud_reg);
+  EXPECT_TRUE (reg_threads.hasConverged ());
+  EXPECT_EQ (reg_threads.getFinalTransformation (), reg.getFinalTransformation ());
+  EXPECT_TRUE (reg_threads.getFinalTransformation ().isApprox (delta_transform.matrix (), 1e-2f));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, NormalDistributionsTransform2DThreads)
+{
+  using PointT = PointXYZ;
+  PointCloud<PointT>::Ptr src (new PointCloud<PointT>);
+  copyPointCloud (cloud_source, *src);
+  Eigen::Affine3f delta_transform (Eigen::AngleAxisf (0.05f, Eigen::Vector3f::UnitZ ()));
+  delta_transform.translation () << 0.01f, -0.005f, 0.0f;
+  PointCloud<PointT>::Ptr tgt (new PointCloud<PointT>);
+  transformPointCloud (*src, *tgt, delta_transform);
+  PointCloud<PointT> output;
+
+  NormalDistributionsTransform2D<PointT, PointT> reg;
+  reg.setInputSource (src);
+  reg.setInputTarget (tgt);
+  reg.setMaximumIterations (50);
+  reg.setTransformationEpsilon (1e-8);
+  reg.setGridCentre (Eigen::Vector2f (0.0f, 0.1f));
+  reg.setGridExtent (Eigen::Vector2f (0.2f, 0.2f));
+  reg.setGridStep (Eigen::Vector2f (0.02f, 0.02f));
+  reg.setOptimizationStepSize (0.4);
+  reg.align (output);
+  const Eigen::Matrix4f serial_transformation = reg.getFinalTransformation ();
+
+  // The partial sums of the score are added in another order, the alignment converges to the same pose
+  reg.setNumberOfThreads (4);
+  reg.align (output);
+  EXPECT_EQ (output.size (), cloud_source.size ());
+  EXPECT_TRUE (reg.getFinalTransformation ().isApprox (serial_transformation, 1e-3f));
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 TEST (PCL, IterativeClosestPointNonLinear)
 {
@@ -585,6 +663,294 @@ TEST (PCL, GeneralizedIterativeClosestPoint)
   EXPECT_LT (reg.getFitnessScore (), 0.0001);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, GeneralizedIterativeClosestPointThreads)
+{
+  using PointT = PointXYZ;
+  PointCloud<PointT>::Ptr src (new PointCloud<PointT>);
+  copyPointCloud (cloud_source, *src);
+  PointCloud<PointT>::Ptr tgt (new PointCloud<PointT>);
+  copyPointCloud (cloud_target, *tgt);
+  PointCloud<PointT> output;
+
+  GeneralizedIterativeClosestPoint<PointT, PointT> reg;
+  reg.setInputSource (src);
+  reg.setInputTarget (tgt);
+  reg.setMaximumIterations (50);
+  reg.setTransformationEpsilon (1e-8);
+  reg.align (output);
+  const Eigen::Matrix4f serial_transformation = reg.getFinalTransformation ();
+
+  // The partial sums of the objective are added in another order, the alignment converges to the same pose
+  GeneralizedIterativeClosestPoint<PointT, PointT> reg_threads;
+  reg_threads.setInputSource (src);
+  reg_threads.setInputTarget (tgt);
+  reg_threads.setMaximumIterations (50);
+  reg_threads.setTransformationEpsilon (1e-8);
+  reg_threads.setNumberOfThreads (4);
+  reg_threads.align (output);
+  EXPECT_EQ (output.size (), cloud_source.size ());
+  EXPECT_LT (reg_threads.getFitnessScore (), 0.0001);
+  EXPECT_TRUE (reg_threads.getFinalTransformation ().isApprox (serial_transformation, 1e-3f));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, VoxelizedGeneralizedIterativeClosestPoint)
+{
+  using PointT = PointXYZ;
+  PointCloud<PointT>::Ptr src (new PointCloud<PointT>);
+  copyPointCloud (cloud_source, *src);
+  PointCloud<PointT>::Ptr tgt (new PointCloud<PointT>);
+  copyPointCloud (cloud_target, *tgt);
+  PointCloud<PointT> output;
+
+  VoxelizedGeneralizedIterativeClosestPoint<PointT, PointT> reg;
+  reg.setInputSource (src);
+  reg.setInputTarget (tgt);
+  reg.setResolution (0.02f);
+  reg.setMaximumIterations (50);
+  reg.setTransformationEpsilon (1e-8);
+  reg.setNumberOfThreads (2);
+  EXPECT_FLOAT_EQ (reg.getResolution (), 0.02f);
+
+  // Register
+  reg.align (output);
+  EXPECT_EQ (output.size (), cloud_source.size ());
+  EXPECT_GT (reg.getNumberOfVoxels (), 0);
+  EXPECT_LT (reg.getNumberOfVoxels (), cloud_target.size ());
+  EXPECT_LT (reg.getFitnessScore (), 0.0001);
+
+  // The voxels are built again for a new resolution
+  const std::size_t nr_voxels = reg.getNumberOfVoxels ();
+  reg.setResolution (0.03f);
+  reg.align (output);
+  EXPECT_LT (reg.getNumberOfVoxels (), nr_voxels);
+  EXPECT_LT (reg.getFitnessScore (), 0.0001);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, PreparedTarget)
+{
+  using PointT = PointXYZ;
+  PointCloud<PointT>::Ptr src (new PointCloud<PointT>);
+  copyPointCloud (cloud_source, *src);
+  PointCloud<PointT>::Ptr tgt (new PointCloud<PointT>);
+  copyPointCloud (cloud_target, *tgt);
+  PointCloud<PointT> output;
+
+  GeneralizedIterativeClosestPoint<PointT, PointT> gicp;
+  gicp.setMaximumIterations (50);
+  gicp.setTransformationEpsilon (1e-8);
+  NormalDistributionsTransform<PointT, PointT> ndt;
+  ndt.setStepSize (0.05);
+  ndt.setResolution (0.025f);
+  ndt.setMaximumIterations (50);
+  ndt.setTransformationEpsilon (1e-8);
+
+  registration::PreparedTarget<PointT>::Ptr prepared (new registration::PreparedTarget<PointT> (tgt));
+  EXPECT_EQ (prepared->getInputTarget (), tgt);
+  EXPECT_EQ (prepared->getSearchMethodTarget ()->getInputCloud (), tgt);
+  EXPECT_FALSE (prepared->getCovariances ());
+  EXPECT_FALSE (prepared->getCells ());
+  prepared->computeCovariances (gicp);
+  prepared->computeCells (0.025f);
+  ASSERT_TRUE (prepared->getCovariances ());
+  EXPECT_EQ (prepared->getCovariances ()->size (), tgt->size ());
+  ASSERT_TRUE (prepared->getCells ());
+
+  // The registrations give the same alignments with their own target state and with the prepared one
+  IterativeClosestPoint<PointT, PointT> icp;
+  icp.setInputSource (src);
+  icp.setInputTarget (tgt);
+  icp.align (output);
+  const Eigen::Matrix4f icp_transformation = icp.getFinalTransformation ();
+  gicp.setInputSource (src);
+  gicp.setInputTarget (tgt);
+  gicp.align (output);
+  const Eigen::Matrix4f gicp_transformation = gicp.getFinalTransformation ();
+  ndt.setInputSource (src);
+  ndt.setInputTarget (tgt);
+  ndt.align (output);
+  const Eigen::Matrix4f ndt_transformation = ndt.getFinalTransformation ();
+
+  gicp.setInputTarget (src);
+  prepared->assignTo (gicp);
+  gicp.align (output);
+  EXPECT_EQ (gicp.getSearchMethodTarget (), prepared->getSearchMethodTarget ());
+  EXPECT_TRUE (gicp.getFinalTransformation ().isApprox (gicp_transformation, 1e-5f));
+  ndt.setInputTarget (src);
+  prepared->assignTo (ndt);
+  ndt.align (output);
+  EXPECT_FLOAT_EQ (ndt.getResolution (), 0.025f);
+  EXPECT_TRUE (ndt.getFinalTransformation ().isApprox (ndt_transformation, 1e-5f));
+
+  // Several registrations share the prepared target in parallel
+  const std::size_t nr_registrations = 4;
+  std::vector<Eigen::Matrix4f, Eigen::aligned_allocator<Eigen::Matrix4f> > transformations (nr_registrations);
+  std::vector<std::thread> threads;
+  for (std::size_t i = 0; i < nr_registrations; ++i)
+    threads.emplace_back ([&prepared, &src, &transformations, i] ()
+    {
+      IterativeClosestPoint<PointT, PointT> reg;
+      prepared->assignTo (reg);
+      reg.setInputSource (src);
+      PointCloud<PointT> aligned;
+      reg.align (aligned);
+      transformations[i] = reg.getFinalTransformation ();
+    });
+  for (auto &thread : threads)
+    thread.join ();
+  for (const auto &transformation : transformations)
+    EXPECT_TRUE (transformation.isApprox (icp_transformation, 1e-5f));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, MultiResolutionRegistration)
+{
+  using PointT = PointXYZ;
+  PointCloud<PointT>::Ptr src (new PointCloud<PointT>);
+  copyPointCloud (cloud_source, *src);
+  PointCloud<PointT>::Ptr tgt (new PointCloud<PointT>);
+  copyPointCloud (cloud_target, *tgt);
+  PointCloud<PointT> output;
+
+  registration::MultiResolutionRegistration<PointT, PointT> mrreg;
+  EXPECT_FALSE (mrreg.align (output));
+  mrreg.addLevel (0.02f, 0.1, 10);
+  mrreg.addLevel (0.01f, 0.05, 10);
+  mrreg.addLevel (0.0f, 0.05, 20);
+  ASSERT_EQ (mrreg.getLevels ().size (), 3);
+  EXPECT_FLOAT_EQ (mrreg.getLevels ()[0].leaf_size, 0.02f);
+  mrreg.setInputSource (src);
+  mrreg.setInputTarget (tgt);
+
+  IterativeClosestPoint<PointT, PointT>::Ptr icp (new IterativeClosestPoint<PointT, PointT>);
+  mrreg.setRegistration (icp);
+  EXPECT_TRUE (mrreg.align (output));
+  EXPECT_EQ (output.size (), cloud_source.size ());
+  EXPECT_EQ (icp->getInputTarget (), tgt);
+
+  // The registration at full resolution gives the fitness of the final transformation
+  EXPECT_LT (icp->getFitnessScore (), 0.001);
+  const Eigen::Matrix4f icp_transformation = mrreg.getFinalTransformation ();
+
+  // The target pyramid is reused by the next alignments
+  EXPECT_TRUE (mrreg.align (output, icp_transformation));
+  EXPECT_TRUE (mrreg.getFinalTransformation ().isApprox (icp_transformation, 1e-3f));
+
+  GeneralizedIterativeClosestPoint<PointT, PointT>::Ptr gicp (new GeneralizedIterativeClosestPoint<PointT, PointT>);
+  gicp->setTransformationEpsilon (1e-8);
+  mrreg.setRegistration (gicp);
+  EXPECT_TRUE (mrreg.align (output));
+  EXPECT_LT (gicp->getFitnessScore (), 0.0001);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, LocalMap)
+{
+  using PointT = PointXYZ;
+  registration::LocalMap<PointT> map;
+  map.setResolution (0.005f);
+  map.setMaximumNumberOfKeyframes (3);
+  map.setKeyframeThresholds (0.01f, 0.1f);
+  EXPECT_TRUE (map.empty ());
+
+  // The same scene seen from poses moving along x, in the frame of each pose
+  std::vector<PointCloud<PointT>::Ptr> scans;
+  std::vector<Eigen::Matrix4f, Eigen::aligned_allocator<Eigen::Matrix4f> > poses;
+  for (int i = 0; i < 10; ++i)
+  {
+    Eigen::Matrix4f pose = Eigen::Matrix4f::Identity ();
+    pose (0, 3) = 0.004f * static_cast<float> (i);
+    PointCloud<PointT>::Ptr scan (new PointCloud<PointT>);
+    transformPointCloud (cloud_target, *scan, Eigen::Matrix4f (pose.inverse ()));
+    scans.push_back (scan);
+    poses.push_back (pose);
+  }
+
+  // Only the scans 0.01 away from the last keyframe are keyframes
+  EXPECT_TRUE (map.update (*scans[0], poses[0]));
+  EXPECT_FALSE (map.update (*scans[1], poses[1]));
+  EXPECT_FALSE (map.update (*scans[2], poses[2]));
+  EXPECT_TRUE (map.update (*scans[3], poses[3]));
+  EXPECT_EQ (map.getNumberOfKeyframes (), 2);
+
+  // The voxels of the map hold at most one point, the second keyframe sees the same scene as the first one
+  const std::size_t nr_points = map.getNumberOfPoints ();
+  EXPECT_LT (nr_points, 2 * cloud_target.size ());
+  PointCloud<PointT> map_cloud;
+  map.getMapCloud (map_cloud);
+  EXPECT_EQ (map_cloud.size (), nr_points);
+  std::set<std::tuple<int, int, int> > voxels;
+  for (const auto &point : map_cloud)
+  {
+    const Eigen::Array3i ijk = (point.getArray3fMap () / 0.005f).floor ().cast<int> ();
+    EXPECT_TRUE (voxels.emplace (ijk[0], ijk[1], ijk[2]).second);
+    Indices indices;
+    std::vector<float> distances;
+    ASSERT_EQ (map.getSearchMethodTarget ()->nearestKSearch (point, 1, indices, distances), 1);
+    EXPECT_EQ (distances[0], 0.0f);
+    EXPECT_EQ ((*map.getInputTarget ())[indices[0]].getVector3fMap (), point.getVector3fMap ());
+  }
+
+  // The window slides over the keyframes, the map does not grow
+  for (int i = 4; i < 10; ++i)
+    map.addKeyframe (*scans[i], poses[i]);
+  EXPECT_EQ (map.getNumberOfKeyframes (), 3);
+  EXPECT_LE (map.getNumberOfPoints (), 2 * nr_points);
+  map.getMapCloud (map_cloud);
+  EXPECT_EQ (map_cloud.size (), map.getNumberOfPoints ());
+
+  // The keyframes too far from the current pose are dropped, the last one is kept
+  map.setMaximumDistance (0.1f);
+  Eigen::Matrix4f far_pose = Eigen::Matrix4f::Identity ();
+  far_pose (1, 3) = 1.0f;
+  EXPECT_TRUE (map.update (*scans[0], far_pose));
+  EXPECT_EQ (map.getNumberOfKeyframes (), 1);
+
+  map.clear ();
+  EXPECT_TRUE (map.empty ());
+  EXPECT_EQ (map.getNumberOfPoints (), 0);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, IncrementalRegistrationLocalMap)
+{
+  using PointT = PointXYZ;
+  IterativeClosestPoint<PointT, PointT>::Ptr icp (new IterativeClosestPoint<PointT, PointT>);
+  icp->setMaxCorrespondenceDistance (0.02);
+  icp->setMaximumIterations (50);
+  icp->setTransformationEpsilon (1e-8);
+
+  registration::LocalMap<PointT>::Ptr map (new registration::LocalMap<PointT>);
+  map->setResolution (0.002f);
+  map->setKeyframeThresholds (0.005f, 0.05f);
+  registration::IncrementalRegistration<PointT> iicp;
+  iicp.setRegistration (icp);
+  iicp.setLocalMap (map);
+  EXPECT_EQ (iicp.getLocalMap (), map);
+
+  // The scans of a sensor moving along x and turning, registered with the motion of the previous scan as estimate
+  Eigen::Matrix4f pose = Eigen::Matrix4f::Identity ();
+  Eigen::Matrix4f delta = Eigen::Matrix4f::Identity ();
+  delta.topLeftCorner<3, 3> () = Eigen::AngleAxisf (0.02f, Eigen::Vector3f::UnitZ ()).toRotationMatrix ();
+  delta (0, 3) = 0.003f;
+  for (int i = 0; i < 8; ++i)
+  {
+    PointCloud<PointT>::Ptr scan (new PointCloud<PointT>);
+    transformPointCloud (cloud_target, *scan, Eigen::Matrix4f (pose.inverse ()));
+    EXPECT_TRUE (iicp.registerCloud (scan, i > 1 ? iicp.getDeltaTransform () : Eigen::Matrix4f::Identity ()));
+    EXPECT_TRUE (iicp.getAbsoluteTransform ().isApprox (pose, 1e-3f));
+    pose = pose * delta;
+  }
+  EXPECT_TRUE (iicp.getDeltaTransform ().isApprox (delta, 1e-3f));
+  EXPECT_GT (map->getNumberOfKeyframes (), 1);
+  EXPECT_EQ (icp->getSearchMethodTarget (), map->getSearchMethodTarget ());
+
+  iicp.reset ();
+  EXPECT_TRUE (map->empty ());
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 TEST (PCL, GeneralizedIterativeClosestPoint6D)
 {
@@ -805,6 +1171,156 @@ TEST (PCL, PPFRegistration)
 }
 #endif
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, PPFRegistrationThreads)
+{
+  // Estimate normals for both clouds
+  NormalEstimation<PointXYZ, Normal> normal_estimation;
+  search::KdTree<PointXYZ>::Ptr search_tree (new search::KdTree<PointXYZ> ());
+  normal_estimation.setSearchMethod (search_tree);
+  normal_estimation.setRadiusSearch (0.05);
+  PointCloud<Normal>::Ptr normals_source (new PointCloud<Normal> ()),
+      normals_target (new PointCloud<Normal> ());
+  normal_estimation.setInputCloud (cloud_source.makeShared ());
+  normal_estimation.compute (*normals_source);
+  normal_estimation.setInputCloud (cloud_target.makeShared ());
+  normal_estimation.compute (*normals_target);
+
+  PointCloud<PointNormal>::Ptr cloud_source_with_normals (new PointCloud<PointNormal> ()),
+      cloud_target_with_normals (new PointCloud<PointNormal> ());
+  concatenateFields (cloud_source, *normals_source, *cloud_source_with_normals);
+  concatenateFields (cloud_target, *normals_target, *cloud_target_with_normals);
+
+  // Train the source cloud
+  PPFEstimation<PointXYZ, Normal, PPFSignature> ppf_estimator;
+  PointCloud<PPFSignature>::Ptr features_source (new PointCloud<PPFSignature> ());
+  ppf_estimator.setInputCloud (cloud_source.makeShared ());
+  ppf_estimator.setInputNormals (normals_source);
+  ppf_estimator.compute (*features_source);
+
+  PPFHashMapSearch::Ptr hash_map_search (new PPFHashMapSearch (15.0 / 180 * M_PI, 0.01));
+  hash_map_search->setInputFeatureCloud (features_source);
+
+  // Every pair of the source with a finite feature is found in its bin
+  std::vector<std::pair<std::size_t, std::size_t> > pairs;
+  const PPFSignature &feature = (*features_source)[1];
+  float f1 = feature.f1, f2 = feature.f2, f3 = feature.f3, f4 = feature.f4;
+  hash_map_search->nearestNeighborSearch (f1, f2, f3, f4, pairs);
+  EXPECT_NE (std::find (pairs.begin (), pairs.end (), std::pair<std::size_t, std::size_t> (0, 1)), pairs.end ());
+
+  PPFRegistration<PointNormal, PointNormal> ppf_registration;
+  ppf_registration.setSceneReferencePointSamplingRate (10);
+  ppf_registration.setPositionClusteringThreshold (0.02f);
+  ppf_registration.setRotationClusteringThreshold (30.0f / 180.0f * static_cast<float> (M_PI));
+  ppf_registration.setSearchMethod (hash_map_search);
+  ppf_registration.setInputSource (cloud_source_with_normals);
+  ppf_registration.setInputTarget (cloud_target_with_normals);
+
+  PointCloud<PointNormal> cloud_output;
+  ppf_registration.align (cloud_output);
+  EXPECT_TRUE (ppf_registration.hasConverged ());
+  const Eigen::Matrix4f transformation = ppf_registration.getFinalTransformation ();
+
+  // The voting of the scene reference points does not depend on the number of threads
+  ppf_registration.setNumberOfThreads (4);
+  ppf_registration.align (cloud_output);
+  EXPECT_TRUE (ppf_registration.hasConverged ());
+  EXPECT_EQ (ppf_registration.getFinalTransformation (), transformation);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, LUM)
+{
+  // Views of the source along a loop, with noise on the points and on the initial poses
+  const int nr_views = 8;
+  std::mt19937 rng (12345);
+  std::normal_distribution<float> noise (0.0f, 1.0f);
+  pcl::registration::LUM<PointXYZ> lum;
+  std::vector<Eigen::Vector6f, Eigen::aligned_allocator<Eigen::Vector6f> > poses;
+  for (int v = 0; v < nr_views; ++v)
+  {
+    const float angle = 2.0f * static_cast<float> (M_PI) * static_cast<float> (v) / nr_views;
+    Eigen::Vector6f pose;
+    pose << 0.05f * std::sin (angle), 0.02f * (1.0f - std::cos (angle)), 0.0f,
+            0.0f, 0.0f, 0.1f * std::sin (angle);
+    poses.push_back (pose);
+
+    PointCloud<PointXYZ>::Ptr view (new PointCloud<PointXYZ>);
+    const Eigen::Affine3f transformation = pcl::getTransformation (pose (0), pose (1), pose (2), pose (3), pose (4), pose (5));
+    transformPointCloud (cloud_source, *view, transformation.inverse ());
+    for (auto &point : view->points)
+      point.getVector3fMap () += 0.0002f * Eigen::Vector3f (noise (rng), noise (rng), noise (rng));
+
+    Eigen::Vector6f guess = pose;
+    if (v > 0)
+      guess += 0.005f * Eigen::Vector6f (noise (rng), noise (rng), noise (rng), noise (rng), noise (rng), noise (rng));
+    lum.addPointCloud (view, guess);
+  }
+  CorrespondencesPtr correspondences (new Correspondences);
+  for (std::size_t i = 0; i < cloud_source.size (); ++i)
+    correspondences->push_back (Correspondence (i, i, 0.0f));
+  for (int v = 0; v < nr_views; ++v)
+    lum.setCorrespondences (v, (v + 1) % nr_views, correspondences);
+  lum.setCorrespondences (nr_views / 2, 0, correspondences);
+  lum.setMaxIterations (5);
+
+  // A copy of the graph, before the poses are computed
+  pcl::registration::LUM<PointXYZ> lum_threads;
+  lum_threads.setLoopGraph (pcl::make_shared<pcl::registration::LUM<PointXYZ>::SLAMGraph> (*lum.getLoopGraph ()));
+  lum_threads.setMaxIterations (5);
+
+  lum.compute ();
+  for (int v = 1; v < nr_views; ++v)
+    for (int k = 0; k < 6; ++k)
+      EXPECT_NEAR (lum.getPose (v) (k), poses[v] (k), 1e-3);
+
+  // The edges are linearized independently of the number of threads
+  lum_threads.setNumberOfThreads (4);
+  lum_threads.compute ();
+  for (int v = 1; v < nr_views; ++v)
+    EXPECT_EQ (lum_threads.getPose (v), lum.getPose (v));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, ELCH)
+{
+  // A chain of copies of the source closed by a known loop transformation
+  const int nr_views = 10;
+  Eigen::Matrix4f loop_transform = Eigen::Matrix4f::Identity ();
+  loop_transform.topLeftCorner<3, 3> () = Eigen::AngleAxisf (0.1f, Eigen::Vector3f::UnitZ ()).toRotationMatrix ();
+  loop_transform (0, 3) = 0.05f;
+  loop_transform (1, 3) = -0.02f;
+
+  pcl::registration::ELCH<PointXYZ> elch, elch_threads;
+  for (int v = 0; v < nr_views; ++v)
+  {
+    elch.addPointCloud (cloud_source.makeShared ());
+    elch_threads.addPointCloud (cloud_source.makeShared ());
+  }
+  for (auto e : {&elch, &elch_threads})
+  {
+    e->setLoopStart (0);
+    e->setLoopEnd (nr_views - 1);
+    e->setLoopTransform (loop_transform);
+  }
+  elch.compute ();
+  elch_threads.setNumberOfThreads (4);
+  elch_threads.compute ();
+
+  // The start of the loop keeps its pose and the end gets the full loop transformation
+  const pcl::registration::ELCH<PointXYZ>::LoopGraph &graph = *elch.getLoopGraph ();
+  EXPECT_TRUE (graph[0].transform.matrix ().isApprox (Eigen::Matrix4f::Identity (), 1e-5f));
+  EXPECT_TRUE (graph[nr_views - 1].transform.matrix ().isApprox (loop_transform, 1e-5f));
+
+  const pcl::registration::ELCH<PointXYZ>::LoopGraph &graph_threads = *elch_threads.getLoopGraph ();
+  for (int v = 0; v < nr_views; ++v)
+  {
+    EXPECT_EQ (graph_threads[v].transform.matrix (), graph[v].transform.matrix ());
+    for (std::size_t i = 0; i < graph[v].cloud->size (); i += 100)
+      EXPECT_EQ ((*graph_threads[v].cloud)[i].getVector3fMap (), (*graph[v].cloud)[i].getVector3fMap ());
+  }
+}
+
 /* ---[ */
 int
 main (int argc, char** argv)
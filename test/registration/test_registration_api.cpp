@@ -59,6 +59,7 @@
 #include <pcl/registration/transformation_estimation_point_to_plane_lls.h>
 #include <pcl/registration/transformation_estimation_point_to_plane.h>
 #include <pcl/registration/transformation_estimation_symmetric_point_to_plane_lls.h>
+#include <pcl/registration/warp_point_rigid_3d.h>
 #include <pcl/features/normal_3d.h>
 
 #include "test_registration_api_data.h"
@@ -656,6 +657,134 @@ TEST (PCL, TransformationEstimationPointToPlane)
       EXPECT_NEAR (estimated_transform_double (i, j), ground_truth_tform (i, j), 1e-3);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, TransformationEstimationLMAnalyticJacobian)
+{
+  CloudXYZConstPtr source (new CloudXYZ (cloud_target));
+  CloudXYZPtr      target (new CloudXYZ ());
+  pcl::transformPointCloud (*source, *target, T_ref);
+
+  pcl::Correspondences corr;
+  corr.reserve (source->size ());
+  for (std::size_t i = 0; i < source->size (); ++i)
+    corr.push_back (pcl::Correspondence (i, i, 0.f));
+
+  pcl::registration::TransformationEstimationLM<PointXYZ, PointXYZ, double> trans_est_lm;
+  trans_est_lm.setUseAnalyticJacobian (true);
+  EXPECT_TRUE (trans_est_lm.getUseAnalyticJacobian ());
+
+  Eigen::Matrix4d T_LM;
+  trans_est_lm.estimateRigidTransformation (*source, *target, corr, T_LM);
+
+  const Eigen::Quaterniond   R_LM (T_LM.topLeftCorner  <3, 3> ());
+  const Eigen::Translation3d t_LM (T_LM.topRightCorner <3, 1> ());
+
+  EXPECT_NEAR (R_LM.x (), R_ref.x (), 1e-6);
+  EXPECT_NEAR (R_LM.y (), R_ref.y (), 1e-6);
+  EXPECT_NEAR (R_LM.z (), R_ref.z (), 1e-6);
+  EXPECT_NEAR (R_LM.w (), R_ref.w (), 1e-6);
+
+  EXPECT_NEAR (t_LM.x (), t_ref.x (), 1e-6);
+  EXPECT_NEAR (t_LM.y (), t_ref.y (), 1e-6);
+  EXPECT_NEAR (t_LM.z (), t_ref.z (), 1e-6);
+
+  // The residuals and the Jacobian do not depend on the number of threads
+  Eigen::Matrix4d T_LM_threads;
+  trans_est_lm.setNumberOfThreads (4);
+  trans_est_lm.estimateRigidTransformation (*source, *target, corr, T_LM_threads);
+  EXPECT_EQ (T_LM, T_LM_threads);
+
+  // Point to plane, with the warp restricted to a translation in the plane and a rotation around z
+  pcl::PointCloud<pcl::PointNormal>::Ptr src (new pcl::PointCloud<pcl::PointNormal>);
+  for (float x = -5.0f; x <= 5.0f; x += 0.5f)
+    for (float y = -5.0f; y <= 5.0f; y += 0.5f)
+    {
+      pcl::PointNormal p;
+      p.x = x;
+      p.y = y;
+      p.z = 0.1f * powf (x, 2.0f) + 0.2f * p.x * p.y - 0.3f * y + 1.0f;
+      Eigen::Vector3f n (-0.2f * p.x - 0.2f, 0.6f * p.y - 0.2f, 1.0f);
+      p.getNormalVector3fMap () = n.normalized ();
+      src->push_back (p);
+    }
+
+  Eigen::Matrix4f ground_truth_tform = Eigen::Matrix4f::Identity ();
+  ground_truth_tform.topLeftCorner<2, 2> () = Eigen::Rotation2Df (0.05f).toRotationMatrix ();
+  ground_truth_tform (0, 3) = 0.1f;
+  ground_truth_tform (1, 3) = -0.2f;
+
+  pcl::PointCloud<pcl::PointNormal>::Ptr tgt (new pcl::PointCloud<pcl::PointNormal>);
+  pcl::transformPointCloudWithNormals (*src, *tgt, ground_truth_tform);
+
+  pcl::registration::TransformationEstimationPointToPlane<pcl::PointNormal, pcl::PointNormal, double> transform_estimator;
+  transform_estimator.setWarpFunction (pcl::make_shared<pcl::registration::WarpPointRigid3D<pcl::PointNormal, pcl::PointNormal, double> > ());
+  transform_estimator.setUseAnalyticJacobian (true);
+  Eigen::Matrix4d estimated_transform;
+  transform_estimator.estimateRigidTransformation (*src, *tgt, estimated_transform);
+
+  for (int i = 0; i < 4; ++i)
+    for (int j = 0; j < 4; ++j)
+      EXPECT_NEAR (estimated_transform (i, j), ground_truth_tform (i, j), 1e-4);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, TransformationEstimationThreads)
+{
+  pcl::PointCloud<pcl::PointNormal>::Ptr src (new pcl::PointCloud<pcl::PointNormal>);
+  for (float x = -5.0f; x <= 5.0f; x += 0.5f)
+    for (float y = -5.0f; y <= 5.0f; y += 0.5f)
+    {
+      pcl::PointNormal p;
+      p.x = x;
+      p.y = y;
+      p.z = 0.1f * powf (x, 2.0f) + 0.2f * p.x * p.y - 0.3f * y + 1.0f;
+      Eigen::Vector3f n (-0.2f * p.x - 0.2f, 0.6f * p.y - 0.2f, 1.0f);
+      p.getNormalVector3fMap () = n.normalized ();
+      src->push_back (p);
+    }
+
+  Eigen::Matrix4f ground_truth_tform = Eigen::Matrix4f::Identity ();
+  ground_truth_tform.row (0) <<  0.9938f,  0.0988f,  0.0517f,  0.1000f;
+  ground_truth_tform.row (1) << -0.0997f,  0.9949f,  0.0149f, -0.2000f;
+  ground_truth_tform.row (2) << -0.0500f, -0.0200f,  0.9986f,  0.3000f;
+
+  pcl::PointCloud<pcl::PointNormal>::Ptr tgt (new pcl::PointCloud<pcl::PointNormal>);
+  pcl::transformPointCloudWithNormals (*src, *tgt, ground_truth_tform);
+
+  pcl::Correspondences corr;
+  for (std::size_t i = 0; i < src->size (); ++i)
+    corr.push_back (pcl::Correspondence (i, i, 0.f));
+
+  // A single thread accumulates the correspondences in the order of the iterators
+  Eigen::Matrix4f T_cloud, T_corr, T_threads;
+  pcl::registration::TransformationEstimationPointToPlaneLLS<pcl::PointNormal, pcl::PointNormal> lls;
+  lls.estimateRigidTransformation (*src, *tgt, T_cloud);
+  lls.estimateRigidTransformation (*src, *tgt, corr, T_corr);
+  EXPECT_EQ (T_cloud, T_corr);
+  lls.setNumberOfThreads (4);
+  lls.estimateRigidTransformation (*src, *tgt, corr, T_threads);
+  for (int i = 0; i < 4; ++i)
+    for (int j = 0; j < 4; ++j)
+      EXPECT_NEAR (T_threads (i, j), T_cloud (i, j), 1e-5);
+
+  pcl::registration::TransformationEstimationSymmetricPointToPlaneLLS<pcl::PointNormal, pcl::PointNormal> symmetric;
+  symmetric.estimateRigidTransformation (*src, *tgt, T_cloud);
+  symmetric.estimateRigidTransformation (*src, *tgt, corr, T_corr);
+  EXPECT_EQ (T_cloud, T_corr);
+  symmetric.setNumberOfThreads (4);
+  symmetric.estimateRigidTransformation (*src, *tgt, corr, T_threads);
+  for (int i = 0; i < 4; ++i)
+    for (int j = 0; j < 4; ++j)
+      EXPECT_NEAR (T_threads (i, j), T_cloud (i, j), 1e-5);
+
+  // Gathering the points does not change the order of their sums
+  pcl::registration::TransformationEstimationSVD<pcl::PointNormal, pcl::PointNormal> svd;
+  svd.estimateRigidTransformation (*src, *tgt, T_cloud);
+  svd.setNumberOfThreads (4);
+  svd.estimateRigidTransformation (*src, *tgt, corr, T_threads);
+  EXPECT_EQ (T_cloud, T_threads);
+}
+
 TEST (PCL, TransformationEstimationSymmetricPointToPlaneLLS)
 {
   pcl::registration::TransformationEstimationSymmetricPointToPlaneLLS<pcl::PointNormal, pcl::PointNormal> transform_estimator;
@@ -133,6 +133,12 @@ TEST (PCL, SampleConsensusInitialAlignment)
     EXPECT_EQ (cloud_reg.size (), cloud_source.size ());
     EXPECT_LT (reg.getFitnessScore (), 0.0005);
   }
+
+  // Check again, with the hypotheses generated and evaluated in parallel
+  reg.setNumberOfThreads (4);
+  reg.align (cloud_reg);
+  EXPECT_EQ (cloud_reg.size (), cloud_source.size ());
+  EXPECT_LT (reg.getFitnessScore (), 0.0005);
 }
 
 
@@ -233,6 +239,27 @@ TEST (PCL, SampleConsensusPrerejective)
     inlier_fraction = static_cast<float> (reg.getInliers ().size ()) / static_cast<float> (cloud_source.size ());
     EXPECT_GT (inlier_fraction, 0.95f);
   }
+
+  // Check again, with the hypotheses generated and evaluated in parallel, and the evaluation of the hypotheses
+  // stopped early when they cannot reach the required inlier fraction
+  reg.setNumberOfThreads (4);
+  reg.setInlierFraction (0.5f);
+  reg.align (cloud_reg);
+  EXPECT_TRUE (reg.hasConverged ());
+  EXPECT_EQ (cloud_reg.size (), cloud_source.size ());
+  inlier_fraction = static_cast<float> (reg.getInliers ().size ()) / static_cast<float> (cloud_source.size ());
+  EXPECT_GT (inlier_fraction, 0.95f);
+
+  // The same seed gives the same transformation with any number of threads
+  reg.setSeed (42);
+  reg.setNumberOfThreads (1);
+  reg.align (cloud_reg);
+  const Eigen::Matrix4f serial_transformation = reg.getFinalTransformation ();
+  const std::vector<int> serial_inliers = reg.getInliers ();
+  reg.setNumberOfThreads (4);
+  reg.align (cloud_reg);
+  EXPECT_EQ (serial_transformation, reg.getFinalTransformation ());
+  EXPECT_EQ (serial_inliers, reg.getInliers ());
 }
 
 int
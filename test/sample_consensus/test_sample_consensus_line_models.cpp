@@ -107,6 +107,61 @@ TEST (SampleConsensusModelLine, RANSAC)
   EXPECT_XYZ_NEAR (PointXYZ (16.0, 17.0, 18.0), proj_points[5], 1e-4);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT>
+class SampleConsensusModelLineTest : private SampleConsensusModelLine<PointT>
+{
+  public:
+    using SampleConsensusModelLine<PointT>::SampleConsensusModelLine;
+    using SampleConsensusModelLine<PointT>::countWithinDistanceStandard;
+#if defined (__SSE__) && defined (__SSE2__) && defined (__SSE4_1__)
+    using SampleConsensusModelLine<PointT>::countWithinDistanceSSE;
+#endif
+#if defined (__AVX__) && defined (__AVX2__)
+    using SampleConsensusModelLine<PointT>::countWithinDistanceAVX;
+#endif
+};
+
+TEST (SampleConsensusModelLine, SIMD_countWithinDistance) // Test if all countWithinDistance implementations return the same value
+{
+  srand (0);
+  for (std::size_t i = 0; i < 100; ++i)
+  {
+    // Generate a cloud with 1000 random points, half of them indexed
+    PointCloud<PointXYZ> cloud;
+    Indices indices;
+    cloud.resize (1000);
+    for (std::size_t idx = 0; idx < cloud.size (); ++idx)
+    {
+      cloud[idx].x = 2.0f * static_cast<float> (rand ()) / RAND_MAX - 1.0f; // [-1;1]
+      cloud[idx].y = 2.0f * static_cast<float> (rand ()) / RAND_MAX - 1.0f; // [-1;1]
+      cloud[idx].z = 2.0f * static_cast<float> (rand ()) / RAND_MAX - 1.0f; // [-1;1]
+      if (rand () % 2 == 0)
+        indices.push_back (static_cast<index_t> (idx));
+    }
+    SampleConsensusModelLineTest<PointXYZ> model (cloud.makeShared (), indices, true);
+
+    // Generate random model parameters
+    Eigen::VectorXf model_coefficients (6);
+    model_coefficients << 2.0f * static_cast<float> (rand ()) / RAND_MAX - 1.0f,
+                          2.0f * static_cast<float> (rand ()) / RAND_MAX - 1.0f,
+                          2.0f * static_cast<float> (rand ()) / RAND_MAX - 1.0f,
+                          2.0f * static_cast<float> (rand ()) / RAND_MAX - 1.0f,
+                          2.0f * static_cast<float> (rand ()) / RAND_MAX - 1.0f,
+                          2.0f * static_cast<float> (rand ()) / RAND_MAX - 1.0f;
+    const double threshold = 0.1 * static_cast<double> (rand ()) / RAND_MAX; // threshold in [0; 0.1]
+
+    const std::size_t res_standard = model.countWithinDistanceStandard (model_coefficients, threshold);
+    EXPECT_LE (res_standard, indices.size ());
+#if defined (__SSE__) && defined (__SSE2__) && defined (__SSE4_1__)
+    EXPECT_EQ (res_standard, model.countWithinDistanceSSE (model_coefficients, threshold));
+#endif
+#if defined (__AVX__) && defined (__AVX2__)
+    EXPECT_EQ (res_standard, model.countWithinDistanceAVX (model_coefficients, threshold));
+#endif
+  }
+}
+
 TEST (SampleConsensusModelLine, OnGroundPlane)
 {
   PointCloud<PointXYZ> cloud;
@@ -147,6 +147,78 @@ TEST (SampleConsensusModelPlane, RANSAC)
   verifyPlaneSac (model, sac);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (SampleConsensusModelPlane, RANSAC_SPRT)
+{
+  srand (0);
+
+  // Create a shared plane model pointer directly
+  SampleConsensusModelPlanePtr model (new SampleConsensusModelPlane<PointXYZ> (cloud_));
+
+  // Create the RANSAC object, which rejects the bad hypotheses early
+  RandomSampleConsensus<PointXYZ> sac (model, 0.03);
+  sac.setUseSPRT (true);
+  EXPECT_TRUE (sac.getUseSPRT ());
+
+  verifyPlaneSac (model, sac);
+
+  // The state of the test is shared by the threads
+  sac.setNumberOfThreads (2);
+  verifyPlaneSac (model, sac);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (SampleConsensusModelPlane, RANSAC_Deterministic)
+{
+  // The same seed gives the same model with any number of threads, with or without the SPRT
+  for (const bool use_sprt : {false, true})
+  {
+    Indices first_inliers;
+    Eigen::VectorXf first_coefficients;
+    for (const int threads : {-1, 1, 2, 4})
+    {
+      SampleConsensusModelPlanePtr model (new SampleConsensusModelPlane<PointXYZ> (cloud_));
+      RandomSampleConsensus<PointXYZ> sac (model, 0.03);
+      sac.setUseSPRT (use_sprt);
+      sac.setDeterministic (true);
+      EXPECT_TRUE (sac.getDeterministic ());
+      sac.setNumberOfThreads (threads);
+      ASSERT_TRUE (sac.computeModel ());
+
+      Indices inliers;
+      Eigen::VectorXf coefficients;
+      sac.getInliers (inliers);
+      sac.getModelCoefficients (coefficients);
+      if (threads == -1)
+      {
+        first_inliers = inliers;
+        first_coefficients = coefficients;
+      }
+      EXPECT_EQ (first_inliers, inliers);
+      EXPECT_EQ (first_coefficients, coefficients);
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (SampleConsensusModelPlane, countSamplesWithinDistance)
+{
+  SampleConsensusModelPlanePtr model (new SampleConsensusModelPlane<PointXYZ> (cloud_));
+
+  // The counts over the parts of the indices add up to the count over all of them
+  Eigen::VectorXf coeff (4);
+  coeff << plane_coeffs_[0], plane_coeffs_[1], plane_coeffs_[2], 1.0f;
+  coeff /= coeff.head<3> ().norm ();
+  const Indices &indices = *model->getIndices ();
+  const Indices first_half (indices.cbegin (), indices.cbegin () + indices.size () / 2);
+  const Indices second_half (indices.cbegin () + indices.size () / 2, indices.cend ());
+  const std::size_t count = model->countWithinDistance (coeff, 0.03);
+  EXPECT_LT (2000, count);
+  EXPECT_EQ (count, model->countSamplesWithinDistance (first_half, coeff, 0.03) +
+                    model->countSamplesWithinDistance (second_half, coeff, 0.03));
+  EXPECT_EQ (0, model->countSamplesWithinDistance (Indices (), coeff, 0.03));
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 TEST (SampleConsensusModelPlane, LMedS)
 {
@@ -223,6 +295,97 @@ TEST (SampleConsensusModelPlane, RMSAC)
   verifyPlaneSac (model, sac, 600, 1.0f, 1.0f, 0.01f);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (SampleConsensusModelPlane, ParallelEstimators)
+{
+  srand (0);
+
+  // Create a shared plane model pointer directly
+  SampleConsensusModelPlanePtr model (new SampleConsensusModelPlane<PointXYZ> (cloud_));
+
+  // The hypotheses are evaluated by several threads, the models found only differ by the order of the samples
+  LeastMedianSquares<PointXYZ> lmeds (model, 0.03);
+  lmeds.setNumberOfThreads (2);
+  verifyPlaneSac (model, lmeds);
+
+  MEstimatorSampleConsensus<PointXYZ> msac (model, 0.03);
+  msac.setNumberOfThreads (2);
+  verifyPlaneSac (model, msac);
+
+  MaximumLikelihoodSampleConsensus<PointXYZ> mlesac (model, 0.03);
+  mlesac.setNumberOfThreads (2);
+  verifyPlaneSac (model, mlesac, 1000, 0.3f, 0.2f, 0.01f);
+
+  RandomizedRandomSampleConsensus<PointXYZ> rransac (model, 0.03);
+  rransac.setFractionNrPretest (0.1);
+  rransac.setNumberOfThreads (2);
+  verifyPlaneSac (model, rransac, 600, 1.0f, 1.0f, 0.01f);
+
+  // The first hypotheses decide how long RMSAC runs, so the model it finds depends too much on which thread
+  // evaluates them first to be compared with the reference plane
+  RandomizedMEstimatorSampleConsensus<PointXYZ> rmsac (model, 0.03);
+  rmsac.setFractionNrPretest (10.0);
+  rmsac.setNumberOfThreads (2);
+  ASSERT_TRUE (rmsac.computeModel ());
+  std::vector<int> sample;
+  rmsac.getModel (sample);
+  EXPECT_EQ (3, sample.size ());
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT>
+class SampleConsensusModelPlaneTest : private SampleConsensusModelPlane<PointT>
+{
+  public:
+    using SampleConsensusModelPlane<PointT>::SampleConsensusModelPlane;
+    using SampleConsensusModelPlane<PointT>::countWithinDistanceStandard;
+#if defined (__SSE__) && defined (__SSE2__) && defined (__SSE4_1__)
+    using SampleConsensusModelPlane<PointT>::countWithinDistanceSSE;
+#endif
+#if defined (__AVX__) && defined (__AVX2__)
+    using SampleConsensusModelPlane<PointT>::countWithinDistanceAVX;
+#endif
+};
+
+TEST (SampleConsensusModelPlane, SIMD_countWithinDistance) // Test if all countWithinDistance implementations return the same value
+{
+  srand (0);
+  for (std::size_t i = 0; i < 100; ++i)
+  {
+    // Generate a cloud with 1000 random points, half of them indexed
+    PointCloud<PointXYZ> cloud;
+    Indices indices;
+    cloud.resize (1000);
+    for (std::size_t idx = 0; idx < cloud.size (); ++idx)
+    {
+      cloud[idx].x = 2.0f * static_cast<float> (rand ()) / RAND_MAX - 1.0f; // [-1;1]
+      cloud[idx].y = 2.0f * static_cast<float> (rand ()) / RAND_MAX - 1.0f; // [-1;1]
+      cloud[idx].z = 2.0f * static_cast<float> (rand ()) / RAND_MAX - 1.0f; // [-1;1]
+      if (rand () % 2 == 0)
+        indices.push_back (static_cast<index_t> (idx));
+    }
+    SampleConsensusModelPlaneTest<PointXYZ> model (cloud.makeShared (), indices, true);
+
+    // Generate random model parameters
+    Eigen::VectorXf model_coefficients (4);
+    model_coefficients << 2.0f * static_cast<float> (rand ()) / RAND_MAX - 1.0f,
+                          2.0f * static_cast<float> (rand ()) / RAND_MAX - 1.0f,
+                          2.0f * static_cast<float> (rand ()) / RAND_MAX - 1.0f,
+                          0.5f * static_cast<float> (rand ()) / RAND_MAX - 0.25f;
+    model_coefficients.head<3> ().normalize ();
+    const double threshold = 0.1 * static_cast<double> (rand ()) / RAND_MAX; // threshold in [0; 0.1]
+
+    const std::size_t res_standard = model.countWithinDistanceStandard (model_coefficients, threshold);
+    EXPECT_LE (res_standard, indices.size ());
+#if defined (__SSE__) && defined (__SSE2__) && defined (__SSE4_1__)
+    EXPECT_EQ (res_standard, model.countWithinDistanceSSE (model_coefficients, threshold));
+#endif
+#if defined (__AVX__) && defined (__AVX2__)
+    EXPECT_EQ (res_standard, model.countWithinDistanceAVX (model_coefficients, threshold));
+#endif
+  }
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 TEST (SampleConsensusModelNormalPlane, RANSAC)
 {
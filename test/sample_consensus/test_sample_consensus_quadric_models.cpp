@@ -107,6 +107,59 @@ TEST (SampleConsensusModelSphere, RANSAC)
   EXPECT_NEAR (2, coeff_refined[2] / coeff_refined[3], 1e-2);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT>
+class SampleConsensusModelSphereTest : private SampleConsensusModelSphere<PointT>
+{
+  public:
+    using SampleConsensusModelSphere<PointT>::SampleConsensusModelSphere;
+    using SampleConsensusModelSphere<PointT>::countWithinDistanceStandard;
+#if defined (__SSE__) && defined (__SSE2__) && defined (__SSE4_1__)
+    using SampleConsensusModelSphere<PointT>::countWithinDistanceSSE;
+#endif
+#if defined (__AVX__) && defined (__AVX2__)
+    using SampleConsensusModelSphere<PointT>::countWithinDistanceAVX;
+#endif
+};
+
+TEST (SampleConsensusModelSphere, SIMD_countWithinDistance) // Test if all countWithinDistance implementations return the same value
+{
+  srand (0);
+  for (std::size_t i = 0; i < 100; ++i)
+  {
+    // Generate a cloud with 1000 random points, half of them indexed
+    PointCloud<PointXYZ> cloud;
+    Indices indices;
+    cloud.resize (1000);
+    for (std::size_t idx = 0; idx < cloud.size (); ++idx)
+    {
+      cloud[idx].x = 2.0f * static_cast<float> (rand ()) / RAND_MAX - 1.0f; // [-1;1]
+      cloud[idx].y = 2.0f * static_cast<float> (rand ()) / RAND_MAX - 1.0f; // [-1;1]
+      cloud[idx].z = 2.0f * static_cast<float> (rand ()) / RAND_MAX - 1.0f; // [-1;1]
+      if (rand () % 2 == 0)
+        indices.push_back (static_cast<index_t> (idx));
+    }
+    SampleConsensusModelSphereTest<PointXYZ> model (cloud.makeShared (), indices, true);
+
+    // Generate random model parameters
+    Eigen::VectorXf model_coefficients (4);
+    model_coefficients << 2.0f * static_cast<float> (rand ()) / RAND_MAX - 1.0f,
+                          2.0f * static_cast<float> (rand ()) / RAND_MAX - 1.0f,
+                          2.0f * static_cast<float> (rand ()) / RAND_MAX - 1.0f,
+                          0.15f * static_cast<float> (rand ()) / RAND_MAX; // radius in [0; 0.15]
+    const double threshold = 0.1 * static_cast<double> (rand ()) / RAND_MAX; // threshold in [0; 0.1]
+
+    const std::size_t res_standard = model.countWithinDistanceStandard (model_coefficients, threshold);
+    EXPECT_LE (res_standard, indices.size ());
+#if defined (__SSE__) && defined (__SSE2__) && defined (__SSE4_1__)
+    EXPECT_EQ (res_standard, model.countWithinDistanceSSE (model_coefficients, threshold));
+#endif
+#if defined (__AVX__) && defined (__AVX2__)
+    EXPECT_EQ (res_standard, model.countWithinDistanceAVX (model_coefficients, threshold));
+#endif
+  }
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 TEST (SampleConsensusModelNormalSphere, RANSAC)
 {
@@ -0,0 +1,209 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved
+ */
+
+#include <pcl/test/gtest.h>
+#include <pcl/point_cloud.h>
+#include <pcl/point_types.h>
+#include <pcl/search/brute_force.h>
+#include <pcl/search/incremental_kdtree.h>
+
+#include <algorithm>
+#include <random>
+
+using namespace pcl;
+
+PointCloud<PointXYZ>::Ptr
+createRandomCloud (std::mt19937& rng, std::size_t size, float offset = 0.0f)
+{
+  std::uniform_real_distribution<float> distribution (0.0f, 1.0f);
+  PointCloud<PointXYZ>::Ptr cloud (new PointCloud<PointXYZ>);
+  for (std::size_t i = 0; i < size; ++i)
+    cloud->push_back (PointXYZ (distribution (rng) + offset, distribution (rng), distribution (rng)));
+  return (cloud);
+}
+
+/** \brief Compare the searches of the incremental tree with a brute force search over the points it should contain */
+void
+compareWithBruteForce (const search::IncrementalKdTree<PointXYZ>& tree, const std::vector<bool>& alive,
+                       const PointCloud<PointXYZ>& queries)
+{
+  // The cloud of the tree contains the removed points as well, mask them with the indices
+  PointCloud<PointXYZ>::ConstPtr cloud = tree.getInputCloud ();
+  IndicesPtr alive_indices (new Indices);
+  for (std::size_t i = 0; i < alive.size (); ++i)
+    if (alive[i])
+      alive_indices->push_back (static_cast<index_t> (i));
+  ASSERT_EQ (alive_indices->size (), tree.getNumberOfPoints ());
+
+  search::BruteForce<PointXYZ> brute_force (true);
+  brute_force.setInputCloud (cloud, alive_indices);
+
+  Indices indices, expected_indices;
+  std::vector<float> distances, expected_distances;
+  for (const auto& query : queries)
+  {
+    tree.nearestKSearch (query, 8, indices, distances);
+    brute_force.nearestKSearch (query, 8, expected_indices, expected_distances);
+    ASSERT_EQ (expected_indices.size (), indices.size ());
+    for (std::size_t i = 0; i < indices.size (); ++i)
+      EXPECT_FLOAT_EQ (expected_distances[i], distances[i]);
+
+    tree.radiusSearch (query, 0.1, indices, distances);
+    brute_force.radiusSearch (query, 0.1, expected_indices, expected_distances);
+    ASSERT_EQ (expected_indices.size (), indices.size ());
+    for (std::size_t i = 0; i < indices.size (); ++i)
+    {
+      EXPECT_EQ (expected_indices[i], indices[i]);
+      EXPECT_FLOAT_EQ (expected_distances[i], distances[i]);
+    }
+  }
+}
+
+TEST (PCL, IncrementalKdTree_setInputCloud)
+{
+  std::mt19937 rng (42);
+  PointCloud<PointXYZ>::Ptr cloud = createRandomCloud (rng, 2000);
+  PointCloud<PointXYZ>::Ptr queries = createRandomCloud (rng, 100);
+
+  search::IncrementalKdTree<PointXYZ> tree (true);
+  tree.setInputCloud (cloud);
+  EXPECT_EQ (cloud->size (), tree.getNumberOfPoints ());
+  compareWithBruteForce (tree, std::vector<bool> (cloud->size (), true), *queries);
+
+  // Only the indexed points
+  IndicesPtr indices (new Indices);
+  std::vector<bool> alive (cloud->size (), false);
+  for (index_t i = 0; i < static_cast<index_t> (cloud->size ()); i += 3)
+  {
+    indices->push_back (i);
+    alive[i] = true;
+  }
+  tree.setInputCloud (cloud, indices);
+  EXPECT_EQ (indices->size (), tree.getNumberOfPoints ());
+  compareWithBruteForce (tree, alive, *queries);
+}
+
+TEST (PCL, IncrementalKdTree_addAndRemovePoints)
+{
+  std::mt19937 rng (1234);
+  PointCloud<PointXYZ>::Ptr queries = createRandomCloud (rng, 100, 0.5f);
+
+  search::IncrementalKdTree<PointXYZ> tree (true);
+  tree.setInputCloud (createRandomCloud (rng, 1000));
+  std::vector<bool> alive (1000, true);
+
+  // Simulate a sliding map: every frame adds a scan shifted along x and drops the oldest points
+  for (int frame = 0; frame < 10; ++frame)
+  {
+    PointCloud<PointXYZ>::Ptr scan = createRandomCloud (rng, 200, 0.1f * static_cast<float> (frame));
+    Indices scan_indices;
+    tree.addPoints (*scan, scan_indices);
+    ASSERT_EQ (scan->size (), scan_indices.size ());
+    for (const auto& index : scan_indices)
+    {
+      if (static_cast<std::size_t> (index) >= alive.size ())
+        alive.resize (index + 1, false);
+      EXPECT_FALSE (alive[index]);
+      alive[index] = true;
+      EXPECT_EQ ((*scan)[&index - &scan_indices[0]].x, (*tree.getInputCloud ())[index].x);
+    }
+
+    Eigen::Vector4f min_pt (-1.0f, -1.0f, -1.0f, 0.0f);
+    Eigen::Vector4f max_pt (0.1f * static_cast<float> (frame), 2.0f, 2.0f, 0.0f);
+    tree.removePointsInBox (min_pt, max_pt);
+    for (std::size_t i = 0; i < alive.size (); ++i)
+      if (alive[i] && (*tree.getInputCloud ())[i].x <= max_pt[0])
+        alive[i] = false;
+
+    // Remove a few random points by index as well
+    Indices to_remove;
+    for (std::size_t i = 0; i < alive.size (); i += 17)
+    {
+      if (alive[i])
+      {
+        to_remove.push_back (static_cast<index_t> (i));
+        alive[i] = false;
+      }
+    }
+    tree.removePoints (to_remove);
+
+    compareWithBruteForce (tree, alive, *queries);
+  }
+}
+
+TEST (PCL, IncrementalKdTree_emptyTree)
+{
+  search::IncrementalKdTree<PointXYZ> tree;
+  Indices indices;
+  std::vector<float> distances;
+  EXPECT_EQ (0, tree.nearestKSearch (PointXYZ (0.0f, 0.0f, 0.0f), 5, indices, distances));
+
+  // Inserting into an empty tree, point by point and in bulk
+  std::mt19937 rng (7);
+  tree.addPoints (*createRandomCloud (rng, 1));
+  tree.addPoints (*createRandomCloud (rng, 500));
+  EXPECT_EQ (501u, tree.getNumberOfPoints ());
+  EXPECT_EQ (5, tree.nearestKSearch (PointXYZ (0.5f, 0.5f, 0.5f), 5, indices, distances));
+
+  Indices all (501);
+  for (std::size_t i = 0; i < all.size (); ++i)
+    all[i] = static_cast<index_t> (i);
+  tree.removePoints (all);
+  EXPECT_EQ (0u, tree.getNumberOfPoints ());
+  EXPECT_EQ (0, tree.nearestKSearch (PointXYZ (0.5f, 0.5f, 0.5f), 5, indices, distances));
+}
+
+TEST (PCL, IncrementalKdTree_approximateSearch)
+{
+  std::mt19937 rng (11);
+  PointCloud<PointXYZ>::Ptr cloud = createRandomCloud (rng, 5000);
+  PointCloud<PointXYZ>::Ptr queries = createRandomCloud (rng, 100);
+
+  search::IncrementalKdTree<PointXYZ> tree (true);
+  tree.setInputCloud (cloud);
+  search::BruteForce<PointXYZ> brute_force (true);
+  brute_force.setInputCloud (cloud);
+
+  search::ApproximateSearchParams params;
+  params.epsilon = 0.5f;
+  tree.setApproximateSearch (params);
+
+  Indices indices, expected_indices;
+  std::vector<float> distances, expected_distances;
+  for (const auto& query : *queries)
+  {
+    // Every neighbor is at most (1 + epsilon) times farther away than the exact one
+    ASSERT_EQ (10, tree.nearestKSearch (query, 10, indices, distances));
+    brute_force.nearestKSearch (query, 10, expected_indices, expected_distances);
+    for (std::size_t i = 0; i < indices.size (); ++i)
+      EXPECT_LE (distances[i], expected_distances[i] * 1.5f * 1.5f + 1e-6f);
+
+    // All the neighbors closer than radius / (1 + epsilon) are found
+    tree.radiusSearch (query, 0.15, indices, distances);
+    brute_force.radiusSearch (query, 0.1, expected_indices, expected_distances);
+    for (const auto& index : expected_indices)
+      EXPECT_NE (indices.end (), std::find (indices.begin (), indices.end (), index));
+  }
+
+  // With a limit on the visited nodes, the k-nearest neighbor search still finds k neighbors
+  params = search::ApproximateSearchParams ();
+  params.max_checks = 5;
+  tree.setApproximateSearch (params);
+  EXPECT_EQ (10, tree.nearestKSearch ((*queries)[0], 10, indices, distances));
+  EXPECT_GE (5, tree.radiusSearch ((*queries)[0], 0.5, indices, distances));
+}
+
+/* ---[ */
+int
+main (int argc, char** argv)
+{
+  testing::InitGoogleTest (&argc, argv);
+  return (RUN_ALL_TESTS ());
+}
+/* ]--- */
@@ -36,10 +36,13 @@
  *
  */
 #include <pcl/test/gtest.h>
+#include <algorithm>
+#include <random>
 #include <vector>
 #include <pcl/common/time.h>
 #include <pcl/point_cloud.h>
 #include <pcl/point_types.h>
+#include <pcl/search/brute_force.h>
 #include <pcl/search/pcl_search.h>
 
 using namespace pcl;
@@ -348,6 +351,49 @@ TEST (PCL, Octree_Pointcloud_Neighbours_Within_Radius_Search)
   }
 }
 
+TEST (PCL, Octree_ApproximateSearch)
+{
+  std::mt19937 rng (5);
+  std::uniform_real_distribution<float> distribution (0.0f, 10.0f);
+  PointCloud<PointXYZ>::Ptr cloudIn (new PointCloud<PointXYZ> ());
+  for (std::size_t i = 0; i < 5000; i++)
+    cloudIn->push_back (PointXYZ (distribution (rng), distribution (rng), distribution (rng)));
+
+  pcl::search::Octree<PointXYZ> octree (0.5);
+  octree.setInputCloud (cloudIn);
+  pcl::search::BruteForce<PointXYZ> brute_force (true);
+  brute_force.setInputCloud (cloudIn);
+
+  pcl::search::ApproximateSearchParams params;
+  params.epsilon = 0.5f;
+  octree.setApproximateSearch (params);
+
+  std::vector<int> k_indices, bf_indices;
+  std::vector<float> k_sqr_distances, bf_sqr_distances;
+  for (unsigned int test_id = 0; test_id < 100; test_id++)
+  {
+    const PointXYZ searchPoint (distribution (rng), distribution (rng), distribution (rng));
+
+    // every neighbor is at most (1 + epsilon) times farther away than the exact one
+    ASSERT_EQ (10, octree.nearestKSearch (searchPoint, 10, k_indices, k_sqr_distances));
+    brute_force.nearestKSearch (searchPoint, 10, bf_indices, bf_sqr_distances);
+    for (std::size_t i = 0; i < k_indices.size (); ++i)
+      EXPECT_LE (k_sqr_distances[i], bf_sqr_distances[i] * 1.5f * 1.5f + 1e-5f);
+
+    // all the neighbors closer than radius / (1 + epsilon) are found
+    octree.radiusSearch (searchPoint, 1.5, k_indices, k_sqr_distances);
+    brute_force.radiusSearch (searchPoint, 1.0, bf_indices, bf_sqr_distances);
+    for (const int index : bf_indices)
+      EXPECT_NE (k_indices.end (), std::find (k_indices.begin (), k_indices.end (), index));
+  }
+
+  // with a limit on the visited leaves, the k-nearest neighbor search still finds k neighbors
+  params = pcl::search::ApproximateSearchParams ();
+  params.max_checks = 1;
+  octree.setApproximateSearch (params);
+  EXPECT_EQ (10, octree.nearestKSearch (PointXYZ (5.0f, 5.0f, 5.0f), 10, k_indices, k_sqr_distances));
+}
+
 /* ---[ */
 int
 main (int argc, char** argv)
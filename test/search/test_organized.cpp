@@ -284,6 +284,53 @@ TEST (PCL, Organized_Neighbor_Pointcloud_Neighbours_Within_Radius_Search)
   }
 }
 
+TEST (PCL, Organized_Neighbor_Pointcloud_Batch_Nearest_K_Neighbour_Search)
+{
+  PointCloud<PointXYZ>::Ptr cloudIn (new PointCloud<PointXYZ> ());
+  cloudIn->width = 64;
+  cloudIn->height = 48;
+  cloudIn->points.reserve (cloudIn->width * cloudIn->height);
+
+  constexpr double oneOverFocalLength = 0.0018;
+  const int centerX = cloudIn->width >> 1;
+  const int centerY = cloudIn->height >> 1;
+  srand (17);
+  for (int ypos = -centerY; ypos < centerY; ypos++)
+    for (int xpos = -centerX; xpos < centerX; xpos++)
+    {
+      double z = 15.0 * (double (rand ()) / double (RAND_MAX+1.0))+20;
+      cloudIn->points.emplace_back (float (xpos * oneOverFocalLength * z), float (ypos * oneOverFocalLength * z), float (z));
+    }
+
+  search::OrganizedNeighbor<PointXYZ> organizedNeighborSearch;
+  organizedNeighborSearch.setInputCloud (cloudIn);
+  organizedNeighborSearch.setNumberOfThreads (4);
+
+  constexpr int K = 8;
+  pcl::Indices queries;
+  for (std::size_t i = 0; i < cloudIn->size (); i += 7)
+    queries.push_back (static_cast<pcl::index_t> (i));
+
+  search::BatchSearchResult result;
+  organizedNeighborSearch.nearestKSearch (*cloudIn, queries, K, result);
+  ASSERT_EQ (result.size (), queries.size ());
+
+  // the batch, which starts at the pixel of each query, agrees with the search by projecting the point
+  std::vector<int> k_indices;
+  std::vector<float> k_sqr_distances;
+  for (std::size_t q = 0; q < queries.size (); ++q)
+  {
+    organizedNeighborSearch.nearestKSearch ((*cloudIn)[queries[q]], K, k_indices, k_sqr_distances);
+    ASSERT_EQ (result.offsets[q + 1] - result.offsets[q], k_indices.size ());
+    for (std::size_t i = 0; i < k_indices.size (); ++i)
+    {
+      EXPECT_EQ (result.indices[result.offsets[q] + i], k_indices[i]);
+      EXPECT_FLOAT_EQ (result.sqr_distances[result.offsets[q] + i], k_sqr_distances[i]);
+    }
+    EXPECT_EQ (k_indices.front (), queries[q]);
+  }
+}
+
 /* ---[ */
 int
 main (int argc, char** argv)
@@ -66,6 +66,7 @@ using namespace pcl;
 #define TEST_ORGANIZED_SPARSE_VIEW_KNN                1
 #define TEST_ORGANIZED_SPARSE_COMPLETE_RADIUS         1
 #define TEST_ORGANIZED_SPARSE_VIEW_RADIUS             1
+#define TEST_ORGANIZED_SPARSE_BATCH                   1
 
 #if EXCESSIVE_TESTING
 /** \brief number of points used for creating unordered point clouds */
@@ -538,6 +539,62 @@ TEST (PCL, Organized_Sparse_View_Radius)
 }
 #endif
 
+#if TEST_ORGANIZED_SPARSE_BATCH
+/** \brief tests whether the flat, multithreaded batch searches return the same neighbors as the single point searches
+  * \param point_cloud the point cloud to be searched
+  * \param search_methods vector of all search methods to be tested
+  * \param query_indices indices of query points in the point cloud (not necessarily in input_indices)
+  */
+template<typename PointT> void
+testBatchSearch (typename PointCloud<PointT>::ConstPtr point_cloud, std::vector<search::Search<PointT>*> search_methods,
+                 const std::vector<int>& query_indices)
+{
+  const int knn = 10;
+  const double radius = 0.02;
+  std::vector<int> indices;
+  std::vector<float> distances;
+  for (auto &search_method : search_methods)
+  {
+    search_method->setInputCloud (point_cloud);
+    search_method->setNumberOfThreads (4);
+
+    search::BatchSearchResult knn_result, radius_result;
+    search_method->nearestKSearch (*point_cloud, query_indices, knn, knn_result);
+    search_method->radiusSearch (*point_cloud, query_indices, radius, radius_result);
+    ASSERT_EQ (query_indices.size (), knn_result.size ());
+    ASSERT_EQ (query_indices.size (), radius_result.size ());
+    EXPECT_EQ (knn_result.indices.size (), knn_result.offsets.back ());
+    EXPECT_EQ (radius_result.sqr_distances.size (), radius_result.offsets.back ());
+
+    for (std::size_t qIdx = 0; qIdx < query_indices.size (); ++qIdx)
+    {
+      search_method->nearestKSearch ((*point_cloud)[query_indices[qIdx]], knn, indices, distances);
+      ASSERT_EQ (indices.size (), knn_result.count (qIdx)) << search_method->getName ();
+      for (std::size_t nIdx = 0; nIdx < indices.size (); ++nIdx)
+      {
+        EXPECT_EQ (indices[nIdx], knn_result.neighbors (qIdx)[nIdx]);
+        EXPECT_EQ (distances[nIdx], knn_result.distances (qIdx)[nIdx]);
+      }
+
+      search_method->radiusSearch ((*point_cloud)[query_indices[qIdx]], radius, indices, distances);
+      ASSERT_EQ (indices.size (), radius_result.count (qIdx)) << search_method->getName ();
+      for (std::size_t nIdx = 0; nIdx < indices.size (); ++nIdx)
+      {
+        EXPECT_EQ (indices[nIdx], radius_result.neighbors (qIdx)[nIdx]);
+        EXPECT_EQ (distances[nIdx], radius_result.distances (qIdx)[nIdx]);
+      }
+    }
+    search_method->setNumberOfThreads (1);
+  }
+}
+
+/* Test the batch searches on organized and sparse point clouds, for all search methods */
+TEST (PCL, Organized_Sparse_Batch)
+{
+  testBatchSearch (organized_sparse_cloud, organized_search_methods, organized_sparse_query_indices);
+}
+#endif
+
 /** \brief create subset of point in cloud to use as query points
   * \param[out] query_indices resulting query indices - not guaranteed to have size of query_count but guaranteed not to exceed that value
   * \param cloud input cloud required to check for nans and to get number of points
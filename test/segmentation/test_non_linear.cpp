@@ -76,6 +76,61 @@ TEST (SACSegmentation, Segmentation)
   EXPECT_NEAR (static_cast<int> (inliers->indices.size ()), 3516, 15);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////
+TEST (SACSegmentation, SegmentationMultipleModels)
+{
+  // Three planar patches of 1000 points each, which do not cross the planes of the others, and 200 scattered points
+  PointCloud<PointXYZ>::Ptr cloud (new PointCloud<PointXYZ>);
+  srand (0);
+  for (int i = 0; i < 1000; ++i)
+  {
+    const float u = static_cast<float> (rand ()) / RAND_MAX, v = static_cast<float> (rand ()) / RAND_MAX;
+    cloud->push_back (PointXYZ (u, v, 0.0f));
+    cloud->push_back (PointXYZ (2.0f, u, v + 1.0f));
+    cloud->push_back (PointXYZ (u, 3.0f, v + 2.0f));
+  }
+  for (int i = 0; i < 200; ++i)
+    cloud->push_back (PointXYZ (5.0f * static_cast<float> (rand ()) / RAND_MAX + 5.0f,
+                                5.0f * static_cast<float> (rand ()) / RAND_MAX + 5.0f,
+                                5.0f * static_cast<float> (rand ()) / RAND_MAX + 5.0f));
+
+  SACSegmentation<PointXYZ> seg;
+  seg.setOptimizeCoefficients (true);
+  seg.setModelType (SACMODEL_PLANE);
+  seg.setMethodType (SAC_RANSAC);
+  seg.setDistanceThreshold (0.01);
+  seg.setInputCloud (cloud);
+
+  std::vector<PointIndices> inliers;
+  std::vector<ModelCoefficients> coefficients;
+  seg.segment (inliers, coefficients, 10, 500);
+  ASSERT_EQ (3, inliers.size ());
+  ASSERT_EQ (3, coefficients.size ());
+
+  // Every patch is found once, and the inliers of the models are disjoint
+  std::vector<int> nr_models (cloud->size (), 0);
+  int found_axes = 0;
+  for (std::size_t m = 0; m < inliers.size (); ++m)
+  {
+    EXPECT_EQ (1000, inliers[m].indices.size ());
+    for (const auto &index : inliers[m].indices)
+      ++nr_models[index];
+    ASSERT_EQ (4, coefficients[m].values.size ());
+    const Eigen::Vector3f normal (coefficients[m].values[0], coefficients[m].values[1], coefficients[m].values[2]);
+    Eigen::Vector3f::Index axis;
+    EXPECT_NEAR (1.0, normal.cwiseAbs ().maxCoeff (&axis), 1e-3);
+    found_axes |= 1 << axis;
+  }
+  EXPECT_EQ (7, found_axes);
+  for (const int &n : nr_models)
+    EXPECT_GE (1, n);
+
+  // A single model at most
+  seg.segment (inliers, coefficients, 1);
+  EXPECT_EQ (1, inliers.size ());
+  EXPECT_EQ (1, coefficients.size ());
+}
+
 //* ---[ */
 int
   main (int argc, char** argv)
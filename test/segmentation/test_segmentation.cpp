@@ -40,15 +40,27 @@
 #include <pcl/test/gtest.h>
 #include <pcl/point_types.h>
 #include <pcl/point_cloud.h>
+#include <pcl/common/io.h> // for copyPointCloud
 #include <pcl/io/pcd_io.h>
 #include <pcl/search/search.h>
 #include <pcl/features/normal_3d.h>
 
+#include <pcl/segmentation/conditional_euclidean_clustering.h>
+#include <pcl/segmentation/extract_clusters.h>
+#include <pcl/segmentation/extract_labeled_clusters.h>
 #include <pcl/segmentation/extract_polygonal_prism_data.h>
 #include <pcl/segmentation/segment_differences.h>
 #include <pcl/segmentation/region_growing.h>
 #include <pcl/segmentation/region_growing_rgb.h>
 #include <pcl/segmentation/min_cut_segmentation.h>
+#include <pcl/segmentation/organized_multi_plane_segmentation.h>
+#include <pcl/segmentation/euclidean_plane_coefficient_comparator.h>
+#include <pcl/segmentation/lccp_segmentation.h>
+#include <pcl/segmentation/cpc_segmentation.h>
+#include <pcl/segmentation/supervoxel_clustering.h>
+#include <pcl/segmentation/polar_grid_ground_segmentation.h>
+
+#include <set>
 
 using namespace pcl;
 using namespace pcl::io;
@@ -201,6 +213,341 @@ TEST (RegionGrowingTest, SegmentFromPoint)
   EXPECT_NE (0, cluster.indices.size());
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (RegionGrowingTest, Parallel)
+{
+  pcl::RegionGrowing<pcl::PointXYZ, pcl::Normal> rg;
+  rg.setInputCloud (cloud_);
+  rg.setInputNormals (normals_);
+
+  std::vector <pcl::PointIndices> serial_clusters;
+  rg.extract (serial_clusters);
+
+  // The segments are the same with several threads
+  rg.setNumberOfThreads (4);
+  EXPECT_EQ (4, rg.getNumberOfThreads ());
+  std::vector <pcl::PointIndices> parallel_clusters;
+  rg.extract (parallel_clusters);
+  ASSERT_EQ (serial_clusters.size (), parallel_clusters.size ());
+  for (std::size_t i = 0; i < serial_clusters.size (); ++i)
+    EXPECT_EQ (serial_clusters[i].indices, parallel_clusters[i].indices);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (RegionGrowingRGBTest, Parallel)
+{
+  RegionGrowingRGB<pcl::PointXYZRGB> rg;
+  rg.setInputCloud (colored_cloud);
+  rg.setDistanceThreshold (10);
+  rg.setRegionColorThreshold (5);
+  rg.setPointColorThreshold (6);
+  rg.setMinClusterSize (20);
+
+  std::vector <pcl::PointIndices> serial_clusters;
+  rg.extract (serial_clusters);
+
+  rg.setNumberOfThreads (4);
+  std::vector <pcl::PointIndices> parallel_clusters;
+  rg.extract (parallel_clusters);
+  ASSERT_EQ (serial_clusters.size (), parallel_clusters.size ());
+  for (std::size_t i = 0; i < serial_clusters.size (); ++i)
+    EXPECT_EQ (serial_clusters[i].indices, parallel_clusters[i].indices);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (EuclideanClusterExtraction, Parallel)
+{
+  pcl::EuclideanClusterExtraction<pcl::PointXYZ> ec;
+  ec.setInputCloud (another_cloud_);
+  ec.setClusterTolerance (0.1);
+  ec.setMinClusterSize (10);
+
+  std::vector<pcl::PointIndices> serial_clusters;
+  ec.extract (serial_clusters);
+  EXPECT_LT (1, serial_clusters.size ());
+
+  // The parallel version finds the same clusters, in the same order
+  ec.setNumberOfThreads (4);
+  EXPECT_EQ (4, ec.getNumberOfThreads ());
+  std::vector<pcl::PointIndices> parallel_clusters;
+  ec.extract (parallel_clusters);
+  ASSERT_EQ (serial_clusters.size (), parallel_clusters.size ());
+  for (std::size_t i = 0; i < serial_clusters.size (); ++i)
+    EXPECT_EQ (serial_clusters[i].indices, parallel_clusters[i].indices);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (EuclideanClusterExtraction, Grid)
+{
+  pcl::EuclideanClusterExtraction<pcl::PointXYZ> ec;
+  ec.setInputCloud (another_cloud_);
+  ec.setMinClusterSize (10);
+
+  for (const double tolerance : {0.02, 0.1, 0.5})
+  {
+    ec.setClusterTolerance (tolerance);
+    ec.setUseGrid (false);
+    std::vector<pcl::PointIndices> search_clusters;
+    ec.extract (search_clusters);
+
+    // The clusters on the voxel grid are the same, in the same order
+    ec.setUseGrid (true);
+    EXPECT_TRUE (ec.getUseGrid ());
+    std::vector<pcl::PointIndices> grid_clusters;
+    ec.extract (grid_clusters);
+    ASSERT_EQ (search_clusters.size (), grid_clusters.size ());
+    for (std::size_t i = 0; i < search_clusters.size (); ++i)
+      EXPECT_EQ (search_clusters[i].indices, grid_clusters[i].indices);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (ConditionalEuclideanClustering, BatchedAndParallel)
+{
+  pcl::ConditionalEuclideanClustering<pcl::PointXYZ> cec;
+  cec.setInputCloud (another_cloud_);
+  cec.setClusterTolerance (0.1f);
+  cec.setMinClusterSize (10);
+
+  // Points at similar heights only
+  const std::function<bool (const pcl::PointXYZ&, const pcl::PointXYZ&, float)> condition =
+      [] (const pcl::PointXYZ &a, const pcl::PointXYZ &b, float) { return (std::abs (a.z - b.z) < 0.03f); };
+  const auto batch_condition = [] (const pcl::PointCloud<pcl::PointXYZ> &cloud, pcl::index_t index,
+                                   const pcl::Indices &candidates, const std::vector<float> &,
+                                   std::vector<std::uint8_t> &conditions)
+  {
+    for (std::size_t i = 0; i < candidates.size (); ++i)
+      conditions[i] = std::abs (cloud[index].z - cloud[candidates[i]].z) < 0.03f;
+  };
+
+  cec.setConditionFunction (condition);
+  pcl::IndicesClusters clusters;
+  cec.segment (clusters);
+  EXPECT_LT (1, clusters.size ());
+
+  // The batched condition gives the same clusters
+  cec.setBatchConditionFunction (batch_condition);
+  pcl::IndicesClusters batch_clusters;
+  cec.segment (batch_clusters);
+  ASSERT_EQ (clusters.size (), batch_clusters.size ());
+  for (std::size_t i = 0; i < clusters.size (); ++i)
+    EXPECT_EQ (clusters[i].indices, batch_clusters[i].indices);
+
+  // And so do several threads, with both conditions, up to the order of the indices in the clusters
+  for (auto &cluster : clusters)
+    std::sort (cluster.indices.begin (), cluster.indices.end ());
+  cec.setNumberOfThreads (4);
+  for (const bool batched : {false, true})
+  {
+    if (batched)
+      cec.setBatchConditionFunction (batch_condition);
+    else
+      cec.setConditionFunction (condition);
+    pcl::IndicesClusters parallel_clusters;
+    cec.segment (parallel_clusters);
+    ASSERT_EQ (clusters.size (), parallel_clusters.size ());
+    for (std::size_t i = 0; i < clusters.size (); ++i)
+      EXPECT_EQ (clusters[i].indices, parallel_clusters[i].indices);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (LabeledEuclideanClusterExtraction, Parallel)
+{
+  // Split the car in two labels
+  pcl::PointCloud<pcl::PointXYZL>::Ptr cloud (new pcl::PointCloud<pcl::PointXYZL>);
+  pcl::copyPointCloud (*another_cloud_, *cloud);
+  for (auto &point : *cloud)
+    point.label = point.x > -37.0f ? 1 : 0;
+
+  pcl::LabeledEuclideanClusterExtraction<pcl::PointXYZL> lec;
+  lec.setInputCloud (cloud);
+  lec.setClusterTolerance (0.1);
+  lec.setMinClusterSize (10);
+  lec.setMaxLabels (2);
+
+  std::vector<std::vector<pcl::PointIndices> > serial_clusters (2);
+  lec.extract (serial_clusters);
+
+  lec.setNumberOfThreads (4);
+  std::vector<std::vector<pcl::PointIndices> > parallel_clusters (2);
+  lec.extract (parallel_clusters);
+  for (std::size_t label = 0; label < 2; ++label)
+  {
+    EXPECT_LT (0, serial_clusters[label].size ());
+    ASSERT_EQ (serial_clusters[label].size (), parallel_clusters[label].size ());
+    for (std::size_t i = 0; i < serial_clusters[label].size (); ++i)
+      EXPECT_EQ (serial_clusters[label][i].indices, parallel_clusters[label][i].indices);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (SupervoxelClustering, ParallelAndPreviousSeeds)
+{
+  pcl::SupervoxelClustering<pcl::PointXYZRGB> serial (0.008f, 0.1f);
+  serial.setInputCloud (colored_cloud);
+  std::map<std::uint32_t, pcl::Supervoxel<pcl::PointXYZRGB>::Ptr> supervoxels;
+  serial.extract (supervoxels);
+  EXPECT_LT (1, supervoxels.size ());
+  pcl::PointCloud<pcl::PointXYZL>::Ptr serial_labels = serial.getLabeledCloud ();
+
+  pcl::SupervoxelClustering<pcl::PointXYZRGB> parallel (0.008f, 0.1f);
+  parallel.setNumberOfThreads (4);
+  parallel.setInputCloud (colored_cloud);
+  // A second call on the same object starts again from an empty octree
+  for (int repetition = 0; repetition < 2; ++repetition)
+  {
+    std::map<std::uint32_t, pcl::Supervoxel<pcl::PointXYZRGB>::Ptr> parallel_supervoxels;
+    parallel.extract (parallel_supervoxels);
+    EXPECT_EQ (supervoxels.size (), parallel_supervoxels.size ());
+    pcl::PointCloud<pcl::PointXYZL>::Ptr parallel_labels = parallel.getLabeledCloud ();
+    ASSERT_EQ (serial_labels->size (), parallel_labels->size ());
+    for (std::size_t i = 0; i < serial_labels->size (); ++i)
+      EXPECT_EQ ((*serial_labels)[i].label, (*parallel_labels)[i].label);
+  }
+
+  // Seeded with the previous supervoxels, most points keep their label
+  parallel.setUsePreviousSeeds (true);
+  std::map<std::uint32_t, pcl::Supervoxel<pcl::PointXYZRGB>::Ptr> next_supervoxels;
+  parallel.extract (next_supervoxels);
+  EXPECT_LT (1, next_supervoxels.size ());
+  pcl::PointCloud<pcl::PointXYZL>::Ptr next_labels = parallel.getLabeledCloud ();
+  std::size_t nr_kept = 0;
+  for (std::size_t i = 0; i < serial_labels->size (); ++i)
+    if ((*serial_labels)[i].label == (*next_labels)[i].label)
+      ++nr_kept;
+  EXPECT_LT (0.8 * serial_labels->size (), nr_kept);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (LCCPSegmentation, Parallel)
+{
+  pcl::SupervoxelClustering<pcl::PointXYZRGB> supervoxel_clustering (0.008f, 0.05f);
+  supervoxel_clustering.setInputCloud (colored_cloud);
+  std::map<std::uint32_t, pcl::Supervoxel<pcl::PointXYZRGB>::Ptr> supervoxels;
+  supervoxel_clustering.extract (supervoxels);
+  std::multimap<std::uint32_t, std::uint32_t> adjacency;
+  supervoxel_clustering.getSupervoxelAdjacency (adjacency);
+
+  // The segment labels follow the (pointer) order of the graph vertices, compare the partitions
+  const auto same_partition = [] (const std::map<std::uint32_t, std::uint32_t> &a, const std::map<std::uint32_t, std::uint32_t> &b)
+  {
+    std::map<std::uint32_t, std::uint32_t> a_to_b, b_to_a;
+    for (const auto &supervoxel : a)
+    {
+      const std::uint32_t b_segment = b.at (supervoxel.first);
+      if (a_to_b.emplace (supervoxel.second, b_segment).first->second != b_segment ||
+          b_to_a.emplace (b_segment, supervoxel.second).first->second != supervoxel.second)
+        return (false);
+    }
+    return (a.size () == b.size ());
+  };
+
+  for (const std::uint32_t k : {0, 1, 2})
+  {
+    pcl::LCCPSegmentation<pcl::PointXYZRGB> serial, parallel;
+    parallel.setNumberOfThreads (4);
+    for (pcl::LCCPSegmentation<pcl::PointXYZRGB> *lccp : {&serial, &parallel})
+    {
+      lccp->setConcavityToleranceThreshold (10);
+      lccp->setSanityCheck (true);
+      lccp->setKFactor (k);
+      lccp->setInputSupervoxels (supervoxels, adjacency);
+      lccp->segment ();
+    }
+    std::map<std::uint32_t, std::uint32_t> serial_segments, parallel_segments;
+    serial.getSupervoxelToSegmentMap (serial_segments);
+    parallel.getSupervoxelToSegmentMap (parallel_segments);
+    EXPECT_EQ (supervoxels.size (), serial_segments.size ());
+    EXPECT_TRUE (same_partition (serial_segments, parallel_segments));
+  }
+
+  pcl::CPCSegmentation<pcl::PointXYZRGB> serial, parallel;
+  parallel.setNumberOfThreads (4);
+  for (pcl::CPCSegmentation<pcl::PointXYZRGB> *cpc : {&serial, &parallel})
+  {
+    cpc->setConcavityToleranceThreshold (10);
+    cpc->setCutting (5, 0, 0.16f);
+    cpc->setRANSACIterations (1000);
+    cpc->setInputSupervoxels (supervoxels, adjacency);
+    cpc->segment ();
+  }
+  std::map<std::uint32_t, std::uint32_t> serial_segments, parallel_segments;
+  serial.getSupervoxelToSegmentMap (serial_segments);
+  parallel.getSupervoxelToSegmentMap (parallel_segments);
+  EXPECT_TRUE (same_partition (serial_segments, parallel_segments));
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (OrganizedMultiPlaneSegmentation, Parallel)
+{
+  // A floor and two walls seen by a 320x240 camera, with holes
+  pcl::PointCloud<pcl::PointXYZ>::Ptr cloud (new pcl::PointCloud<pcl::PointXYZ> (320, 240));
+  pcl::PointCloud<pcl::Normal>::Ptr normals (new pcl::PointCloud<pcl::Normal> (320, 240));
+  for (int row = 0; row < 240; ++row)
+  {
+    for (int col = 0; col < 320; ++col)
+    {
+      const float x = (col - 160) / 262.5f, y = (row - 120) / 262.5f;
+      float z;
+      Eigen::Vector3f normal;
+      if (row > 150)
+      {
+        z = 0.5f / y;
+        normal = Eigen::Vector3f (0.0f, -1.0f, 0.0f);
+      }
+      else if (col < 100)
+      {
+        z = 2.0f + x;
+        normal = Eigen::Vector3f (1.0f, 0.0f, 1.0f).normalized ();
+      }
+      else
+      {
+        z = 3.0f;
+        normal = Eigen::Vector3f (0.0f, 0.0f, -1.0f);
+      }
+      (*cloud) (col, row).getVector3fMap () = Eigen::Vector3f (x * z, y * z, z);
+      if ((row * 7 + col * 13) % 31 == 0 || (row > 50 && row < 55))
+        (*cloud) (col, row).x = (*cloud) (col, row).y = (*cloud) (col, row).z = std::numeric_limits<float>::quiet_NaN ();
+      (*normals) (col, row).getNormalVector3fMap () = normal;
+      (*normals) (col, row).curvature = 0.0f;
+    }
+  }
+
+  for (const bool euclidean : {false, true})
+  {
+    std::vector<pcl::ModelCoefficients> coefficients[2];
+    std::vector<pcl::PointIndices> inliers[2], label_indices[2];
+    std::vector<Eigen::Vector4f, Eigen::aligned_allocator<Eigen::Vector4f> > centroids[2];
+    std::vector<Eigen::Matrix3f, Eigen::aligned_allocator<Eigen::Matrix3f> > covariances[2];
+    pcl::PointCloud<pcl::Label> labels[2];
+    for (int i = 0; i < 2; ++i)
+    {
+      pcl::OrganizedMultiPlaneSegmentation<pcl::PointXYZ, pcl::Normal, pcl::Label> mps;
+      if (euclidean)
+        mps.setComparator (pcl::EuclideanPlaneCoefficientComparator<pcl::PointXYZ, pcl::Normal>::Ptr (new pcl::EuclideanPlaneCoefficientComparator<pcl::PointXYZ, pcl::Normal>));
+      mps.setNumberOfThreads (i == 0 ? 1 : 4);
+      mps.setMinInliers (100);
+      mps.setInputCloud (cloud);
+      mps.setInputNormals (normals);
+      mps.segment (coefficients[i], inliers[i], centroids[i], covariances[i], labels[i], label_indices[i]);
+    }
+    EXPECT_EQ (3, coefficients[0].size ());
+    ASSERT_EQ (coefficients[0].size (), coefficients[1].size ());
+    for (std::size_t j = 0; j < coefficients[0].size (); ++j)
+    {
+      EXPECT_EQ (coefficients[0][j].values, coefficients[1][j].values);
+      EXPECT_EQ (inliers[0][j].indices, inliers[1][j].indices);
+    }
+    ASSERT_EQ (labels[0].size (), labels[1].size ());
+    for (std::size_t j = 0; j < labels[0].size (); ++j)
+      EXPECT_EQ (labels[0][j].label, labels[1][j].label);
+    ASSERT_EQ (label_indices[0].size (), label_indices[1].size ());
+    for (std::size_t j = 0; j < label_indices[0].size (); ++j)
+      EXPECT_EQ (label_indices[0][j].indices, label_indices[1][j].indices);
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////
 TEST (MinCutSegmentationTest, Segment)
 {
@@ -236,6 +583,54 @@ TEST (MinCutSegmentationTest, Segment)
   EXPECT_EQ (2, num_of_segments);
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (MinCutSegmentationTest, IncrementalMaxFlow)
+{
+  pcl::PointCloud<pcl::PointXYZ>::Ptr foreground_points (new pcl::PointCloud<pcl::PointXYZ> ());
+  pcl::PointXYZ object_center;
+  object_center.x = -36.01f;
+  object_center.y = -64.73f;
+  object_center.z = -6.18f;
+  foreground_points->points.push_back (object_center);
+
+  pcl::MinCutSegmentation<pcl::PointXYZ> incremental;
+  incremental.setUseIncrementalMaxFlow (true);
+  incremental.setInputCloud (another_cloud_);
+  for (const std::size_t point : {0, 200, 400})
+  {
+    // Each click adds a foreground point, the incremental segmentation keeps its flow
+    if (point > 0)
+      foreground_points->points.push_back ((*another_cloud_)[point]);
+    pcl::MinCutSegmentation<pcl::PointXYZ> boost_graph, fresh;
+    fresh.setUseIncrementalMaxFlow (true);
+    for (pcl::MinCutSegmentation<pcl::PointXYZ> *mc_seg : {&boost_graph, &fresh, &incremental})
+    {
+      mc_seg->setForegroundPoints (foreground_points);
+      if (mc_seg != &incremental)
+        mc_seg->setInputCloud (another_cloud_);
+      mc_seg->setRadius (3.8003856);
+      mc_seg->setSigma (0.25);
+      mc_seg->setSourceWeight (0.8);
+      mc_seg->setNumberOfNeighbours (14);
+    }
+
+    std::vector <pcl::PointIndices> boost_clusters, fresh_clusters, incremental_clusters;
+    boost_graph.extract (boost_clusters);
+    fresh.extract (fresh_clusters);
+    incremental.extract (incremental_clusters);
+    ASSERT_EQ (2, incremental_clusters.size ());
+    EXPECT_NEAR (boost_graph.getMaxFlow (), incremental.getMaxFlow (), 1e-6 * boost_graph.getMaxFlow ());
+    EXPECT_EQ (fresh_clusters[0].indices, incremental_clusters[0].indices);
+    EXPECT_EQ (fresh_clusters[1].indices, incremental_clusters[1].indices);
+    EXPECT_EQ (another_cloud_->size (), incremental_clusters[0].indices.size () + incremental_clusters[1].indices.size ());
+
+    // The boost graph only labels the points whose source edge is not saturated as object, which all lie on the source side of the cut
+    std::set<int> object (incremental_clusters[1].indices.begin (), incremental_clusters[1].indices.end ());
+    for (const auto &index : boost_clusters[1].indices)
+      EXPECT_EQ (1, object.count (index));
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////
 TEST (MinCutSegmentationTest, SegmentWithoutForegroundPoints)
 {
@@ -334,6 +729,73 @@ TEST (MinCutSegmentationTest, SegmentWithWrongParameters)
   EXPECT_EQ (2, num_of_segments);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PolarGridGroundSegmentation, BatchAndStreaming)
+{
+  // A sweep around a sensor 1.73 m above a ground which starts rising 20 m away, with a wall in front of it
+  PointCloud<PointXYZ>::Ptr sweep (new PointCloud<PointXYZ>);
+  std::vector<bool> is_wall;
+  for (int a = 0; a < 720; ++a)
+  {
+    const float azimuth = static_cast<float> (a) * 0.5f * static_cast<float> (M_PI) / 180.0f;
+    for (int r = 4; r <= 80; ++r)
+    {
+      const float range = 0.5f * static_cast<float> (r);
+      const float height = -1.73f + ((range > 20.0f) ? 0.05f * (range - 20.0f) : 0.0f);
+      sweep->push_back (PointXYZ (range * std::cos (azimuth), range * std::sin (azimuth), height));
+      is_wall.push_back (false);
+    }
+    const float y = 10.0f * std::tan (azimuth);
+    if (std::cos (azimuth) > 0.0f && std::abs (y) < 1.0f)
+    {
+      for (int z = 0; z < 20; ++z)
+      {
+        sweep->push_back (PointXYZ (10.0f, y, -1.5f + 0.1f * static_cast<float> (z)));
+        is_wall.push_back (true);
+      }
+    }
+  }
+
+  PolarGridGroundSegmentation<PointXYZ> pggs;
+  pggs.setInputCloud (sweep);
+  std::vector<int> ground;
+  pggs.extract (ground);
+
+  std::vector<bool> is_ground (sweep->size (), false);
+  for (const int &index : ground)
+    is_ground[index] = true;
+  std::size_t ground_returns = 0;
+  for (std::size_t i = 0; i < sweep->size (); ++i)
+  {
+    if (is_wall[i])
+      EXPECT_FALSE (is_ground[i]);
+    else
+      ++ground_returns;
+  }
+  // Only the points right after the slope change may be missed
+  EXPECT_GE (ground.size (), ground_returns * 99 / 100);
+
+  // The same sweep given in scans of 1000 points
+  std::size_t streamed_ground = 0;
+  std::size_t streamed_points = 0;
+  PointCloud<PointXYZ> scan_ground, scan_non_ground;
+  for (std::size_t start = 0; start < sweep->size (); start += 1000)
+  {
+    PointCloud<PointXYZ>::Ptr scan (new PointCloud<PointXYZ>);
+    for (std::size_t i = start; i < std::min (start + 1000, sweep->size ()); ++i)
+      scan->push_back ((*sweep)[i]);
+    pggs.addScan (scan, scan_ground, scan_non_ground);
+    streamed_ground += scan_ground.size ();
+    streamed_points += scan_ground.size () + scan_non_ground.size ();
+  }
+  pggs.flush (scan_ground, scan_non_ground);
+  streamed_ground += scan_ground.size ();
+  streamed_points += scan_ground.size () + scan_non_ground.size ();
+
+  EXPECT_EQ (sweep->size (), streamed_points);
+  EXPECT_EQ (ground.size (), streamed_ground);
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////
 TEST (SegmentDifferences, Segmentation)
 {
@@ -363,6 +825,37 @@ TEST (SegmentDifferences, Segmentation)
   //savePCDFile ("./test/t-0.pcd", output);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////
+TEST (SegmentDifferences, TilesAndThreads)
+{
+  SegmentDifferences<PointXYZ> sd;
+  sd.setInputCloud (cloud_);
+  sd.setTargetCloud (cloud_t_);
+  sd.setDistanceThreshold (0.00005);
+
+  PointCloud<PointXYZ> reference;
+  sd.segment (reference);
+
+  // The differences depend neither on the tiles nor on the number of threads
+  for (const float tile_size : {0.0f, 0.01f, 0.05f})
+  {
+    for (const unsigned int nr_threads : {1u, 4u})
+    {
+      sd.setTileSize (tile_size);
+      sd.setNumberOfThreads (nr_threads);
+      PointCloud<PointXYZ> output;
+      sd.segment (output);
+      ASSERT_EQ (output.size (), reference.size ());
+      for (std::size_t i = 0; i < output.size (); ++i)
+      {
+        EXPECT_EQ (output[i].x, reference[i].x);
+        EXPECT_EQ (output[i].y, reference[i].y);
+        EXPECT_EQ (output[i].z, reference[i].z);
+      }
+    }
+  }
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////
 TEST (ExtractPolygonalPrism, Segmentation)
 {
@@ -371,6 +371,62 @@ TEST (PCL, ConvexHull_2dsquare)
   }
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, ConvexHull_2dsquare_monotone_chain_and_incremental)
+{
+  //Generate data
+  pcl::PointCloud<pcl::PointXYZ>::Ptr input_cloud (new pcl::PointCloud<pcl::PointXYZ> ());
+  std::mt19937 rng (12345u);
+  std::uniform_real_distribution<float> rd (-1.0f, 1.0f);
+  for (int i = 0; i < 10000; ++i)
+    input_cloud->push_back (pcl::PointXYZ (rd (rng), rd (rng), 1.0f));
+
+  //The monotone chain gives the same hull as qhull
+  pcl::PointCloud<pcl::PointXYZ> hull_qhull, hull_chain;
+  std::vector<pcl::Vertices> polygons_qhull, polygons_chain;
+  pcl::ConvexHull<pcl::PointXYZ> chull;
+  chull.setInputCloud (input_cloud);
+  chull.setDimension (2);
+  chull.setComputeAreaVolume (true);
+  chull.reconstruct (hull_qhull, polygons_qhull);
+  const double area_qhull = chull.getTotalArea ();
+
+  chull.setUseMonotoneChain (true);
+  chull.reconstruct (hull_chain, polygons_chain);
+  ASSERT_EQ (hull_qhull.size (), hull_chain.size ());
+  for (std::size_t i = 0; i < hull_qhull.size (); ++i)
+  {
+    EXPECT_EQ (hull_qhull[i].x, hull_chain[i].x);
+    EXPECT_EQ (hull_qhull[i].y, hull_chain[i].y);
+  }
+  ASSERT_EQ (1u, polygons_chain.size ());
+  EXPECT_EQ (hull_chain.size (), polygons_chain[0].vertices.size ());
+  EXPECT_NEAR (area_qhull, chull.getTotalArea (), 1e-6);
+
+  //Adding the points in chunks gives the hull of all of them
+  pcl::ConvexHull<pcl::PointXYZ> incremental;
+  incremental.setDimension (2);
+  incremental.setUseMonotoneChain (true);
+  pcl::PointCloud<pcl::PointXYZ> hull_incremental;
+  std::vector<pcl::Vertices> polygons_incremental;
+  for (std::size_t start = 0; start < input_cloud->size (); start += 1000)
+  {
+    pcl::PointCloud<pcl::PointXYZ> chunk;
+    chunk.insert (chunk.end (), input_cloud->begin () + start, input_cloud->begin () + start + 1000);
+    incremental.addPoints (chunk, hull_incremental, polygons_incremental);
+  }
+  ASSERT_EQ (hull_chain.size (), hull_incremental.size ());
+  for (std::size_t i = 0; i < hull_chain.size (); ++i)
+  {
+    EXPECT_EQ (hull_chain[i].x, hull_incremental[i].x);
+    EXPECT_EQ (hull_chain[i].y, hull_incremental[i].y);
+  }
+
+  incremental.resetHull ();
+  incremental.addPoints (pcl::PointCloud<pcl::PointXYZ> (*input_cloud, {0, 1, 2, 3}), hull_incremental, polygons_incremental);
+  EXPECT_LE (hull_incremental.size (), 4u);
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 TEST (PCL, ConvexHull_3dcube)
 {
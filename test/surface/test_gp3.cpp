@@ -49,6 +49,9 @@
 #include <pcl/io/obj_io.h>
 #include <pcl/TextureMesh.h>
 #include <pcl/surface/texture_mapping.h>
+
+#include <map>
+
 using namespace pcl;
 using namespace pcl::io;
 
@@ -110,6 +113,44 @@ TEST (PCL, GreedyProjectionTriangulation)
   EXPECT_EQ (states[393], gp3.BOUNDARY);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, GreedyProjectionTriangulation_Tiles)
+{
+  GreedyProjectionTriangulation<PointNormal> gp3;
+  gp3.setInputCloud (cloud_with_normals);
+  gp3.setSearchMethod (tree2);
+  gp3.setSearchRadius (0.025);
+  gp3.setMu (2.5);
+  gp3.setMaximumNearestNeighbors (100);
+  gp3.setMaximumSurfaceAngle(M_PI/4); // 45 degrees
+  gp3.setMinimumAngle(M_PI/18); // 10 degrees
+  gp3.setMaximumAngle(2*M_PI/3); // 120 degrees
+  gp3.setNormalConsistency(false);
+  gp3.setTileSize (0.05);
+
+  PolygonMesh serial, parallel;
+  gp3.setNumberOfThreads (1);
+  gp3.reconstruct (serial);
+  gp3.setNumberOfThreads (4);
+  gp3.reconstruct (parallel);
+
+  // The tiles are stitched in order, independently of the number of threads
+  ASSERT_EQ (serial.polygons.size (), parallel.polygons.size ());
+  for (std::size_t i = 0; i < serial.polygons.size (); ++i)
+    EXPECT_EQ (serial.polygons[i].vertices, parallel.polygons[i].vertices);
+  EXPECT_NEAR (int (parallel.polygons.size ()), 685, 70);
+
+  // No edge is shared by more than two triangles across the seams
+  std::map<std::pair<std::uint32_t, std::uint32_t>, int> edges;
+  for (const auto &polygon : parallel.polygons)
+    for (std::size_t j = 0; j < 3; ++j)
+    {
+      const std::uint32_t a = polygon.vertices[j], b = polygon.vertices[(j + 1) % 3];
+      EXPECT_LE (++edges[std::make_pair ((std::min) (a, b), (std::max) (a, b))], 2);
+    }
+  EXPECT_EQ (int (gp3.getPartIDs ().size ()), int (cloud_with_normals->size ()));
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 TEST (PCL, GreedyProjectionTriangulation_Merge2Meshes)
 {
@@ -238,6 +279,64 @@ TEST (PCL, UpdateMesh_With_TextureMapping)
   }
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, TextureMapping_ZBufferOcclusions)
+{
+  // A small square in front of a large one, both facing the camera
+  PointCloud<PointXYZ> planes;
+  std::vector<Vertices> faces;
+  const auto add_square = [&planes, &faces] (float z, float half_size, int n)
+  {
+    const std::uint32_t base = static_cast<std::uint32_t> (planes.size ());
+    for (int i = 0; i <= n; ++i)
+      for (int j = 0; j <= n; ++j)
+        planes.push_back (PointXYZ (-half_size + 2 * half_size * i / n, -half_size + 2 * half_size * j / n, z));
+    for (int i = 0; i < n; ++i)
+      for (int j = 0; j < n; ++j)
+      {
+        const std::uint32_t a = base + i * (n + 1) + j;
+        Vertices face;
+        face.vertices = {a, a + n + 1, a + 1};
+        faces.push_back (face);
+        face.vertices = {a + 1, a + n + 1, a + n + 2};
+        faces.push_back (face);
+      }
+  };
+  add_square (4.0f, 1.5f, 40);
+  const std::size_t nr_back_points = planes.size ();
+  add_square (2.0f, 0.3f, 10);
+
+  TextureMesh tex_mesh;
+  toPCLPointCloud2 (planes, tex_mesh.cloud);
+  tex_mesh.tex_polygons.push_back (faces);
+
+  texture_mapping::CameraVector cameras (1);
+  cameras[0].pose = Eigen::Affine3f::Identity ();
+  cameras[0].focal_length = 500.0;
+  cameras[0].width = 640.0;
+  cameras[0].height = 480.0;
+
+  TextureMapping<PointXYZ> tm;
+  tm.setUseZBuffer (true);
+  tm.setNumberOfThreads (4);
+  tm.textureMeshwithMultipleCameras (tex_mesh, cameras);
+
+  // Every face of the front square is visible, and the ones behind it are moved to the last sub-mesh
+  ASSERT_EQ (2u, tex_mesh.tex_polygons.size ());
+  EXPECT_EQ (faces.size (), tex_mesh.tex_polygons[0].size () + tex_mesh.tex_polygons[1].size ());
+  EXPECT_EQ (3 * tex_mesh.tex_polygons[0].size (), tex_mesh.tex_coordinates[0].size ());
+  std::size_t nr_front_faces = 0;
+  for (const auto &face : tex_mesh.tex_polygons[0])
+    if (static_cast<std::size_t> (face.vertices[0]) >= nr_back_points)
+      ++nr_front_faces;
+  EXPECT_EQ (200u, nr_front_faces);
+  // The front square hides 16x16 cells of the back one, and partly hides the cells around them
+  EXPECT_GE (tex_mesh.tex_polygons[1].size (), 512u);
+  EXPECT_LE (tex_mesh.tex_polygons[1].size (), 648u);
+  for (const auto &face : tex_mesh.tex_polygons[1])
+    EXPECT_LT (static_cast<std::size_t> (face.vertices[0]), nr_back_points);
+}
+
 /* ---[ */
 int
 main (int argc, char** argv)
@@ -0,0 +1,89 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved
+ */
+
+#include <pcl/test/gtest.h>
+
+#include <pcl/surface/hashed_tsdf_volume.h>
+
+#include <cmath>
+#include <vector>
+
+using namespace pcl;
+
+constexpr int width = 160;
+constexpr int height = 120;
+
+// depth image of a plane facing the camera at 1 meter
+static std::vector<unsigned short>
+planeDepth ()
+{
+  return (std::vector<unsigned short> (width * height, 1000));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+TEST (HashedTSDFVolume, Integrate)
+{
+  HashedTSDFVolume volume (0.01f, 0.03f);
+  volume.setDepthIntrinsics (150.f, 150.f, width / 2 - 0.5f, height / 2 - 0.5f);
+
+  const std::vector<unsigned short> depth = planeDepth ();
+  volume.integrate (depth.data (), width, height, Eigen::Affine3f::Identity ());
+  EXPECT_GT (volume.getNumberOfBlocks (), 0u);
+
+  float tsdf;
+  ASSERT_TRUE (volume.getTsdfValue (Eigen::Vector3f (0.f, 0.f, 0.985f), tsdf));
+  EXPECT_NEAR (tsdf, 0.5f, 1e-3);
+  ASSERT_TRUE (volume.getTsdfValue (Eigen::Vector3f (0.f, 0.f, 1.015f), tsdf));
+  EXPECT_NEAR (tsdf, -0.5f, 1e-3);
+
+  // a second frame doesn't allocate anything new
+  const std::size_t nr_blocks = volume.getNumberOfBlocks ();
+  volume.integrate (depth.data (), width, height, Eigen::Affine3f::Identity ());
+  EXPECT_EQ (volume.getNumberOfBlocks (), nr_blocks);
+
+  volume.reset ();
+  EXPECT_EQ (volume.getNumberOfBlocks (), 0u);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+TEST (HashedTSDFVolume, Raycast)
+{
+  HashedTSDFVolume volume (0.01f, 0.03f);
+  volume.setDepthIntrinsics (150.f, 150.f, width / 2 - 0.5f, height / 2 - 0.5f);
+  volume.setNumberOfThreads (2);
+
+  const std::vector<unsigned short> depth = planeDepth ();
+  volume.integrate (depth.data (), width, height, Eigen::Affine3f::Identity ());
+
+  // render from a camera moved sideways, the plane stays at the same depth
+  Eigen::Affine3f pose = Eigen::Affine3f::Identity ();
+  pose.translation () << 0.05f, 0.f, 0.f;
+  pcl::PointCloud<pcl::PointNormal> cloud;
+  volume.raycast (pose, width, height, cloud);
+  ASSERT_EQ (cloud.width, static_cast<std::uint32_t> (width));
+  ASSERT_EQ (cloud.height, static_cast<std::uint32_t> (height));
+
+  const pcl::PointNormal &center = cloud.at (width / 2, height / 2);
+  ASSERT_TRUE (std::isfinite (center.z));
+  EXPECT_NEAR (center.z, 1.f, 2e-3);
+  EXPECT_NEAR (center.normal_z, -1.f, 1e-3);
+
+  // rays leaving the observed part of the plane don't hit
+  const pcl::PointNormal &corner = cloud.at (width - 1, height / 2);
+  EXPECT_FALSE (std::isfinite (corner.z));
+}
+
+/* ---[ */
+int
+main (int argc, char** argv)
+{
+  testing::InitGoogleTest (&argc, argv);
+  return (RUN_ALL_TESTS ());
+}
+/* ]--- */
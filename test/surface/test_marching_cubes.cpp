@@ -99,6 +99,94 @@ TEST (PCL, MarchingCubesTest)
   EXPECT_EQ (vertices[vertices.size ()/2].vertices[2], 4277);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, MarchingCubesSparseGridThreadsAndWelding)
+{
+  MarchingCubesHoppe<PointNormal> hoppe;
+  hoppe.setIsoLevel (0);
+  hoppe.setGridResolution (30, 30, 30);
+  hoppe.setPercentageExtendGrid (0.3f);
+  hoppe.setDistanceIgnore (1e-4f);
+  hoppe.setInputCloud (cloud_with_normals);
+  PointCloud<PointNormal> points;
+  std::vector<Vertices> vertices;
+  hoppe.reconstruct (points, vertices);
+  ASSERT_FALSE (vertices.empty ());
+
+  // The number of threads does not change the output
+  hoppe.setNumberOfThreads (4);
+  PointCloud<PointNormal> points_threads;
+  std::vector<Vertices> vertices_threads;
+  hoppe.reconstruct (points_threads, vertices_threads);
+  ASSERT_EQ (points.size (), points_threads.size ());
+  for (std::size_t i = 0; i < points.size (); ++i)
+  {
+    EXPECT_EQ (points[i].x, points_threads[i].x);
+    EXPECT_EQ (points[i].y, points_threads[i].y);
+    EXPECT_EQ (points[i].z, points_threads[i].z);
+  }
+
+  // The sparse grid covers every voxel near the points, so it finds the same triangles
+  hoppe.setSparseGrid (true);
+  PointCloud<PointNormal> points_sparse;
+  std::vector<Vertices> vertices_sparse;
+  hoppe.reconstruct (points_sparse, vertices_sparse);
+  EXPECT_EQ (vertices.size (), vertices_sparse.size ());
+  EXPECT_EQ (points.size (), points_sparse.size ());
+
+  // Welding shares the vertices between the triangles, and keeps every triangle
+  hoppe.setWeldVertices (true);
+  PointCloud<PointNormal> points_welded;
+  std::vector<Vertices> vertices_welded;
+  hoppe.reconstruct (points_welded, vertices_welded);
+  EXPECT_EQ (vertices.size (), vertices_welded.size ());
+  EXPECT_LT (points_welded.size (), points.size () / 2);
+  for (const auto &polygon : vertices_welded)
+  {
+    ASSERT_EQ (polygon.vertices.size (), 3u);
+    for (const auto vertex : polygon.vertices)
+      EXPECT_LT (static_cast<std::size_t> (vertex), points_welded.size ());
+  }
+
+  // The triangle mesh holds the same triangles
+  TriangleMesh triangle_mesh;
+  hoppe.reconstruct (triangle_mesh);
+  EXPECT_EQ (points_welded.size (), triangle_mesh.cloud.width * triangle_mesh.cloud.height);
+  ASSERT_EQ (vertices_welded.size (), triangle_mesh.size ());
+  for (std::size_t i = 0; i < vertices_welded.size (); ++i)
+    for (std::size_t j = 0; j < 3; ++j)
+      EXPECT_EQ (vertices_welded[i].vertices[j], triangle_mesh.getTriangle (i)[j]);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, MarchingCubesRBFCompactSupport)
+{
+  MarchingCubesRBF<PointNormal> rbf;
+  rbf.setIsoLevel (0);
+  rbf.setGridResolution (30, 30, 30);
+  rbf.setPercentageExtendGrid (0.1f);
+  rbf.setInputCloud (cloud_with_normals);
+  rbf.setOffSurfaceDisplacement (0.005f);
+  rbf.setSupportRadius (0.03f);
+  rbf.setSparseGrid (true);
+  rbf.setNumberOfThreads (2);
+  PointCloud<PointNormal> points;
+  std::vector<Vertices> vertices;
+  rbf.reconstruct (points, vertices);
+
+  ASSERT_FALSE (vertices.empty ());
+  EXPECT_EQ (points.size (), vertices.size () * 3);
+
+  // The surface only exists within the support of the kernels, up to a voxel
+  std::vector<int> nn_indices;
+  std::vector<float> nn_sqr_dists;
+  for (const auto &point : points)
+  {
+    tree2->nearestKSearch (point, 1, nn_indices, nn_sqr_dists);
+    EXPECT_LT (nn_sqr_dists[0], 0.04f * 0.04f);
+  }
+}
+
 
 /* ---[ */
 int
@@ -0,0 +1,137 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved
+ */
+
+#include <pcl/test/gtest.h>
+
+#include <pcl/conversions.h>
+#include <pcl/point_types.h>
+#include <pcl/surface/mesh_quadric_decimation.h>
+
+#include <cmath>
+#include <vector>
+
+using namespace pcl;
+
+constexpr int grid_size = 41;
+
+// regular grid of grid_size x grid_size points on the height field z = f (x, y), two triangles per cell
+template <typename Function> static PolygonMesh::Ptr
+gridMesh (const Function &f)
+{
+  PointCloud<PointXYZRGB> cloud;
+  for (int y = 0; y < grid_size; ++y)
+    for (int x = 0; x < grid_size; ++x)
+    {
+      PointXYZRGB point;
+      point.x = static_cast<float> (x) / (grid_size - 1);
+      point.y = static_cast<float> (y) / (grid_size - 1);
+      point.z = f (point.x, point.y);
+      point.r = static_cast<std::uint8_t> (x);
+      point.g = static_cast<std::uint8_t> (y);
+      point.b = 7;
+      cloud.push_back (point);
+    }
+  PolygonMesh::Ptr mesh (new PolygonMesh);
+  toPCLPointCloud2 (cloud, mesh->cloud);
+  for (std::uint32_t y = 0; y + 1 < grid_size; ++y)
+    for (std::uint32_t x = 0; x + 1 < grid_size; ++x)
+    {
+      const std::uint32_t i = y * grid_size + x;
+      Vertices quad;
+      quad.vertices = {i, i + 1, i + 1 + grid_size, i + grid_size};
+      mesh->polygons.push_back (quad);
+    }
+  return (mesh);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+TEST (MeshQuadricDecimation, Plane)
+{
+  const PolygonMesh::Ptr mesh = gridMesh ([] (float, float) { return (0.f); });
+  const std::size_t nr_triangles = 2 * mesh->polygons.size ();
+
+  MeshQuadricDecimation decimation;
+  decimation.setInputMesh (mesh);
+  decimation.setTargetReductionFactor (0.9f);
+  PolygonMesh output;
+  decimation.process (output);
+
+  EXPECT_LE (output.polygons.size (), nr_triangles / 10 + 1);
+  EXPECT_GT (output.polygons.size (), 0u);
+
+  // The plane stays flat, keeps its boundary and all its area, and the colors are carried over
+  PointCloud<PointXYZRGB> points;
+  fromPCLPointCloud2 (output.cloud, points);
+  EXPECT_LT (points.size (), static_cast<std::size_t> (grid_size * grid_size / 5));
+  double area = 0.0;
+  for (const auto &polygon : output.polygons)
+  {
+    ASSERT_EQ (3u, polygon.vertices.size ());
+    const Eigen::Vector3f p0 = points[polygon.vertices[0]].getVector3fMap ();
+    const Eigen::Vector3f normal = (points[polygon.vertices[1]].getVector3fMap () - p0).cross (points[polygon.vertices[2]].getVector3fMap () - p0);
+    EXPECT_GT (normal.z (), 0.f);
+    area += 0.5 * normal.norm ();
+  }
+  EXPECT_NEAR (1.0, area, 1e-4);
+  for (const auto &point : points)
+  {
+    EXPECT_NEAR (0.f, point.z, 1e-6f);
+    EXPECT_GE (point.x, -1e-6f);
+    EXPECT_LE (point.x, 1.f + 1e-6f);
+    EXPECT_EQ (7, point.b);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+TEST (MeshQuadricDecimation, CurvedSurfaceAndThreads)
+{
+  const auto f = [] (float x, float y) { return (0.2f * std::sin (3.f * x) * std::cos (2.f * y)); };
+  const PolygonMesh::Ptr mesh = gridMesh (f);
+
+  MeshQuadricDecimation decimation;
+  decimation.setInputMesh (mesh);
+  decimation.setTargetReductionFactor (0.75f);
+  decimation.setNumberOfThreads (1);
+  PolygonMesh output;
+  decimation.process (output);
+  EXPECT_LE (output.polygons.size (), 2 * mesh->polygons.size () / 4 + 1);
+
+  // The vertices stay close to the surface
+  PointCloud<PointXYZRGB> points;
+  fromPCLPointCloud2 (output.cloud, points);
+  for (const auto &point : points)
+    EXPECT_NEAR (f (point.x, point.y), point.z, 5e-3f);
+
+  // The result does not depend on the number of threads
+  decimation.setNumberOfThreads (4);
+  PolygonMesh output_threads;
+  decimation.process (output_threads);
+  EXPECT_EQ (output.cloud.data, output_threads.cloud.data);
+  ASSERT_EQ (output.polygons.size (), output_threads.polygons.size ());
+  for (std::size_t i = 0; i < output.polygons.size (); ++i)
+    EXPECT_EQ (output.polygons[i].vertices, output_threads.polygons[i].vertices);
+
+  // The triangle mesh gives the same result
+  TriangleMesh triangle_mesh, triangle_output;
+  toTriangleMesh (*mesh, triangle_mesh);
+  decimation.decimate (triangle_mesh, triangle_output);
+  EXPECT_EQ (output.cloud.data, triangle_output.cloud.data);
+  std::vector<std::uint32_t> triangles;
+  polygonsToTriangles (output.polygons, triangles);
+  EXPECT_EQ (triangles, triangle_output.triangles);
+}
+
+/* ---[ */
+int
+main (int argc, char** argv)
+{
+  testing::InitGoogleTest (&argc, argv);
+  return (RUN_ALL_TESTS ());
+}
+/* ]--- */
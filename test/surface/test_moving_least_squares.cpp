@@ -167,6 +167,39 @@ TEST (PCL, MovingLeastSquaresOMP)
   EXPECT_NEAR (std::abs ((*mls_normals)[0].normal[2]), 0.795969, 1e-3);
   EXPECT_NEAR ((*mls_normals)[0].curvature, 0.012019, 1e-3);
 }
+
+TEST (PCL, MovingLeastSquaresOMPUpsampling)
+{
+  MovingLeastSquares<PointXYZ, PointNormal> mls;
+  mls.setInputCloud (cloud);
+  mls.setComputeNormals (true);
+  mls.setPolynomialOrder (2);
+  mls.setSearchMethod (tree);
+  mls.setSearchRadius (0.03);
+  mls.setUpsamplingMethod (MovingLeastSquares<PointXYZ, PointNormal>::VOXEL_GRID_DILATION);
+  mls.setDilationIterations (2);
+  mls.setDilationVoxelSize (0.005f);
+
+  PointCloud<PointNormal> serial, parallel;
+  mls.process (serial);
+  mls.setNumberOfThreads (4);
+  mls.process (parallel);
+
+  // The upsampled points do not depend on the number of threads
+  ASSERT_EQ (serial.size (), parallel.size ());
+  for (std::size_t i = 0; i < serial.size (); ++i)
+  {
+    EXPECT_EQ (serial[i].x, parallel[i].x);
+    EXPECT_EQ (serial[i].y, parallel[i].y);
+    EXPECT_EQ (serial[i].z, parallel[i].z);
+  }
+
+  // Every thread draws its random samples from its own generator
+  mls.setUpsamplingMethod (MovingLeastSquares<PointXYZ, PointNormal>::RANDOM_UNIFORM_DENSITY);
+  mls.setPointDensity (60);
+  mls.process (parallel);
+  EXPECT_FALSE (parallel.empty ());
+}
 #endif
 
 /* ---[ */
@@ -108,6 +108,71 @@ TEST (PCL, Organized)
   EXPECT_EQ (int (triangles.polygons.at (0).vertices.at (2)), 1);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, OrganizedFacesAndThreads)
+{
+  //construct dataset
+  pcl::PointCloud<pcl::PointXYZ>::Ptr cloud_organized (new pcl::PointCloud<pcl::PointXYZ> (64, 48));
+  for (std::size_t i = 0; i < cloud_organized->height; i++)
+  {
+    for (std::size_t j = 0; j < cloud_organized->width; j++)
+    {
+      pcl::PointXYZ &point = (*cloud_organized) (j, i);
+      point.x = static_cast<float> (j) * 0.01f;
+      point.y = static_cast<float> (i) * 0.01f;
+      point.z = (j < cloud_organized->width / 2) ? 1.0f : 2.0f;
+      if ((i * 7 + j * 3) % 17 == 0)
+        point.x = point.y = point.z = std::numeric_limits<float>::quiet_NaN ();
+    }
+  }
+
+  const OrganizedFastMesh<PointXYZ>::TriangulationType types[] = {
+    OrganizedFastMesh<PointXYZ>::TRIANGLE_RIGHT_CUT, OrganizedFastMesh<PointXYZ>::TRIANGLE_LEFT_CUT,
+    OrganizedFastMesh<PointXYZ>::TRIANGLE_ADAPTIVE_CUT, OrganizedFastMesh<PointXYZ>::QUAD_MESH};
+  for (const auto type : types)
+  {
+    OrganizedFastMesh<PointXYZ> ofm;
+    ofm.setInputCloud (cloud_organized);
+    ofm.setMaxEdgeLength (0.05f);
+    ofm.setTrianglePixelSize (2);
+    ofm.setTriangulationType (type);
+
+    std::vector<Vertices> polygons;
+    ofm.reconstruct (polygons);
+    ASSERT_FALSE (polygons.empty ());
+
+    // The rows meshed in parallel give the same faces, in the same order
+    ofm.setNumberOfThreads (4);
+    std::vector<Vertices> polygons_threads;
+    ofm.reconstruct (polygons_threads);
+    ASSERT_EQ (polygons.size (), polygons_threads.size ());
+    for (std::size_t i = 0; i < polygons.size (); ++i)
+      EXPECT_EQ (polygons[i].vertices, polygons_threads[i].vertices);
+
+    // The flat buffer holds the same faces
+    pcl::Indices face_vertices;
+    ofm.reconstructFaces (face_vertices);
+    const std::size_t vertices_per_face = ofm.getVerticesPerFace ();
+    ASSERT_EQ (polygons.size () * vertices_per_face, face_vertices.size ());
+    for (std::size_t i = 0; i < polygons.size (); ++i)
+    {
+      ASSERT_EQ (vertices_per_face, polygons[i].vertices.size ());
+      for (std::size_t j = 0; j < vertices_per_face; ++j)
+        EXPECT_EQ (polygons[i].vertices[j], face_vertices[i * vertices_per_face + j]);
+    }
+
+    // The triangle mesh holds the same faces, with every quad split into two triangles
+    PolygonMesh mesh;
+    ofm.reconstruct (mesh);
+    TriangleMesh triangle_mesh;
+    ofm.reconstruct (triangle_mesh);
+    EXPECT_EQ (mesh.cloud.data, triangle_mesh.cloud.data);
+    std::vector<std::uint32_t> triangles;
+    polygonsToTriangles (mesh.polygons, triangles);
+    EXPECT_EQ (triangles, triangle_mesh.triangles);
+  }
+}
+
 /* ---[ */
 int
 main (int argc, char** argv)
@@ -91,6 +91,31 @@ TEST (PCL, Poisson)
   EXPECT_EQ (mesh.polygons[1000].vertices[2], 715);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, PoissonThreadsAndOutOfCoreMesh)
+{
+  Poisson<PointNormal> poisson;
+  poisson.setInputCloud (cloud_with_normals);
+  PolygonMesh mesh;
+  poisson.reconstruct (mesh);
+
+  // The mesh read back from the temporary files is the one kept in memory
+  poisson.setOutOfCoreMesh (true);
+  PolygonMesh out_of_core_mesh;
+  poisson.reconstruct (out_of_core_mesh);
+  ASSERT_EQ (out_of_core_mesh.polygons.size (), mesh.polygons.size ());
+  EXPECT_EQ (out_of_core_mesh.cloud.data, mesh.cloud.data);
+  for (std::size_t i = 0; i < mesh.polygons.size (); ++i)
+    EXPECT_EQ (out_of_core_mesh.polygons[i].vertices, mesh.polygons[i].vertices);
+
+  // The threads sum the solver terms in another order, which barely changes the surface
+  poisson.setOutOfCoreMesh (false);
+  poisson.setThreads (4);
+  PolygonMesh parallel_mesh;
+  poisson.reconstruct (parallel_mesh);
+  EXPECT_NEAR (double (parallel_mesh.polygons.size ()), double (mesh.polygons.size ()), 0.01 * mesh.polygons.size ());
+}
+
 /* ---[ */
 int
 main (int argc, char** argv)
@@ -44,8 +44,10 @@
 
 **/
 
+#include <deque>
 #include <iostream>
 #include <pcl/console/time.h>
+#include <pcl/io/async_loader.h>
 #include <pcl/io/pcd_io.h>
 #include <pcl/point_types.h>
 
@@ -88,14 +90,15 @@ parseFileExtensionArgument (int argc, char** argv, std::string extension)
 }
 
 bool
-loadCloud (const std::string &filename, pcl::PCLPointCloud2 &cloud)
+loadCloud (const std::string &filename, std::future<int> &loaded, const pcl::PCLPointCloud2 &cloud)
 {
   using namespace pcl::console;
   TicToc tt;
   print_highlight ("Loading "); print_value ("%s ", filename.c_str ());
 
+  // The file is read in the background, only wait for it here
   tt.tic ();
-  if (pcl::io::loadPCDFile (filename, cloud, translation, orientation) < 0)
+  if (loaded.get () < 0)
     return (false);
   print_info ("[done, "); print_value ("%g", tt.toc ()); print_info (" ms : "); print_value ("%d", cloud.width * cloud.height); print_info (" points]\n");
   print_info ("Available dimensions: "); print_value ("%s\n", pcl::getFieldsList (cloud).c_str ());
@@ -132,13 +135,32 @@ main (int argc, char** argv)
 
   std::vector<int> file_indices = parseFileExtensionArgument (argc, argv, ".pcd");
 
+  // Keep a few files loading ahead of the one being concatenated
+  const std::size_t nr_prefetched = 4;
+  pcl::io::AsyncLoader loader (nr_prefetched);
+  std::deque<pcl::PCLPointCloud2> clouds;
+  std::deque<std::future<int> > loaded;
+  std::size_t nr_queued = 0;
+
   //pcl::PointCloud<pcl::PointXYZ> cloud_all;
   pcl::PCLPointCloud2 cloud_all;
   for (const int &file_index : file_indices)
   {
+    for (; nr_queued < file_indices.size () && loaded.size () < nr_prefetched; ++nr_queued)
+    {
+      // The output gets the viewpoint of the last file
+      clouds.emplace_back ();
+      if (nr_queued + 1 == file_indices.size ())
+        loaded.push_back (loader.load (argv[file_indices[nr_queued]], clouds.back (), translation, orientation));
+      else
+        loaded.push_back (loader.load (argv[file_indices[nr_queued]], clouds.back ()));
+    }
+
     // Load the Point Cloud
-    pcl::PCLPointCloud2 cloud;
-    loadCloud (argv[file_index], cloud);
+    loadCloud (argv[file_index], loaded.front (), clouds.front ());
+    pcl::PCLPointCloud2 cloud = std::move (clouds.front ());
+    clouds.pop_front ();
+    loaded.pop_front ();
     //pcl::PointCloud<pcl::PointXYZ> cloud;
     //pcl::io::loadPCDFile (argv[file_indices[i]], cloud);
     //cloud_all += cloud;
@@ -39,6 +39,7 @@
 #include <pcl/common/time.h> //fps calculations
 #include <pcl/io/openni_grabber.h>
 #include <pcl/io/lzf_image_io.h>
+#include <pcl/io/lzf_image_stream.h>
 #include <pcl/visualization/boost.h>
 #include <pcl/visualization/common/float_image_utils.h>
 #include <pcl/visualization/image_viewer.h>
@@ -270,26 +271,25 @@ class Writer
       std::stringstream ss1, ss2, ss3;
 
       std::string time_string = boost::posix_time::to_iso_string (frame->time);
-      // Save RGB data
+      // Save RGB data, compressed and written by the recorder threads
       ss1 << "frame_" << time_string << "_rgb.pclzf";
+      const char *rgb_data = reinterpret_cast<const char*> (&frame->image->getMetaData ().Data ()[0]);
+      const std::uint32_t rgb_width = frame->image->getWidth (), rgb_height = frame->image->getHeight ();
       switch (frame->image->getEncoding ())
       {
         case openni_wrapper::Image::YUV422:
         {
-          io::LZFYUV422ImageWriter lrgb;
-          lrgb.write (reinterpret_cast<const char*> (&frame->image->getMetaData ().Data ()[0]), frame->image->getWidth (), frame->image->getHeight (), ss1.str ());
+          recorder_.record (yuv_writer_, rgb_data, rgb_width * rgb_height * 2, rgb_width, rgb_height, ss1.str ());
           break;
         }
         case openni_wrapper::Image::RGB:
         {
-          io::LZFRGB24ImageWriter lrgb;
-          lrgb.write (reinterpret_cast<const char*> (&frame->image->getMetaData ().Data ()[0]), frame->image->getWidth (), frame->image->getHeight (), ss1.str ());
+          recorder_.record (rgb_writer_, rgb_data, rgb_width * rgb_height * 3, rgb_width, rgb_height, ss1.str ());
           break;
         }
         case openni_wrapper::Image::BAYER_GRBG:
         {
-          io::LZFBayer8ImageWriter lrgb;
-          lrgb.write (reinterpret_cast<const char*> (&frame->image->getMetaData ().Data ()[0]), frame->image->getWidth (), frame->image->getHeight (), ss1.str ());
+          recorder_.record (bayer_writer_, rgb_data, rgb_width * rgb_height, rgb_width, rgb_height, ss1.str ());
           break;
         }
       }
@@ -298,7 +298,9 @@ class Writer
       ss2 << "frame_" + time_string + "_depth.pclzf";
       io::LZFDepth16ImageWriter ld;
       //io::LZFShift11ImageWriter ld;
-      ld.write (reinterpret_cast<const char*> (&frame->depth_image->getDepthMetaData ().Data ()[0]), frame->depth_image->getWidth (), frame->depth_image->getHeight (), ss2.str ());
+      const std::uint32_t depth_width = frame->depth_image->getWidth (), depth_height = frame->depth_image->getHeight ();
+      recorder_.record (depth_writer_, reinterpret_cast<const char*> (&frame->depth_image->getDepthMetaData ().Data ()[0]),
+                        depth_width * depth_height * 2, depth_width, depth_height, ss2.str ());
       
       // Save depth data
       ss3 << "frame_" << time_string << ".xml";
@@ -345,6 +347,11 @@ class Writer
   public:
     Writer (Buffer &buf)
       : buf_ (buf)
+      , recorder_ (0)
+      , depth_writer_ (new io::LZFDepth16ImageWriter)
+      , rgb_writer_ (new io::LZFRGB24ImageWriter)
+      , yuv_writer_ (new io::LZFYUV422ImageWriter)
+      , bayer_writer_ (new io::LZFBayer8ImageWriter)
     {
       thread_.reset (new std::thread (&Writer::receiveAndProcess, this));
     }
@@ -354,12 +361,15 @@ class Writer
     stop ()
     {
       thread_->join ();
+      recorder_.flush ();
       std::lock_guard<std::mutex> io_lock (io_mutex);
       print_highlight ("Writer done.\n");
     }
 
   private:
     Buffer &buf_;
+    io::LZFImageRecorder recorder_;
+    std::shared_ptr<const io::LZFImageWriter> depth_writer_, rgb_writer_, yuv_writer_, bayer_writer_;
     std::shared_ptr<std::thread> thread_;
 };
 
@@ -17,6 +17,7 @@ class ApproxNearestPairPointCloudCoherence
 public:
   using PointCoherencePtr =
       typename NearestPairPointCloudCoherence<PointInT>::PointCoherencePtr;
+  using PointCloudIn = typename NearestPairPointCloudCoherence<PointInT>::PointCloudIn;
   using PointCloudInConstPtr =
       typename NearestPairPointCloudCoherence<PointInT>::PointCloudInConstPtr;
   // using NearestPairPointCloudCoherence<PointInT>::search_;
@@ -34,6 +35,23 @@ public:
     coherence_name_ = "ApproxNearestPairPointCloudCoherence";
   }
 
+  /** \brief Provide a pointer to a octree search object, e.g. one that is shared
+   * with other coherences and already indexes the target cloud.
+   * \param[in] search a pointer to a spatial search object.
+   */
+  inline void
+  setSearchMethod(const typename pcl::search::Octree<PointInT>::Ptr& search)
+  {
+    search_ = search;
+  }
+
+  /** \brief Get a pointer to the octree search object. */
+  inline typename pcl::search::Octree<PointInT>::Ptr
+  getSearchMethod()
+  {
+    return (search_);
+  }
+
 protected:
   /** \brief This method should get called before starting the actual
    * computation.
@@ -49,6 +67,19 @@ protected:
                    const IndicesConstPtr& indices,
                    float& w_j) override;
 
+  /** \brief compute the nearest pairs of \a cloud transformed by \a trans and
+   * compute coherence using point_coherences_, without copying \a cloud */
+  void
+  computeTransformedCoherence(const PointCloudInConstPtr& cloud,
+                              const Eigen::Affine3f& trans,
+                              float& w_j) override;
+
+  /** \brief Sum up the coherence of the points of \a cloud and their nearest
+   * target points, each point being passed through \a transform first. */
+  template <typename PointTransform>
+  double
+  sumCoherence(const PointCloudIn& cloud, const PointTransform& transform);
+
   typename pcl::search::Octree<PointInT>::Ptr search_;
 };
 } // namespace tracking
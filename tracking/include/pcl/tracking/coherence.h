@@ -2,6 +2,8 @@
 
 #include <pcl/pcl_base.h>
 
+#include <Eigen/Geometry> // for Affine3f
+
 namespace pcl {
 
 namespace tracking {
@@ -78,6 +80,17 @@ public:
           const IndicesConstPtr& indices,
           float& w_i);
 
+  /** \brief compute coherence between the target pointcloud and \a cloud
+   * transformed by \a trans. Each point (and its normal, if the point type has
+   * one) is transformed right before it is compared, so that no transformed copy
+   * of \a cloud is allocated.
+   * \param[in] cloud the untransformed pointcloud, e.g. the tracking reference
+   * \param[in] trans the transformation to apply to \a cloud, e.g. a particle pose
+   * \param[out] w_i the resultant coherence
+   */
+  inline void
+  compute(const PointCloudInConstPtr& cloud, const Eigen::Affine3f& trans, float& w_i);
+
   /** \brief get a list of pcl::tracking::PointCoherence.*/
   inline std::vector<PointCoherencePtr>
   getPointCoherences()
@@ -124,6 +137,15 @@ protected:
                    const IndicesConstPtr& indices,
                    float& w_j) = 0;
 
+  /** \brief Compute coherence of a transformed pointcloud. The default
+   * implementation transforms \a cloud into a temporary pointcloud and calls
+   * computeCoherence, derived classes should transform the points on the fly.
+   */
+  virtual void
+  computeTransformedCoherence(const PointCloudInConstPtr& cloud,
+                              const Eigen::Affine3f& trans,
+                              float& w_j);
+
   inline double
   calcPointCoherence(PointInT& source, PointInT& target);
 
@@ -7,17 +7,16 @@
 namespace pcl {
 namespace tracking {
 template <typename PointInT>
-void
-ApproxNearestPairPointCloudCoherence<PointInT>::computeCoherence(
-    const PointCloudInConstPtr& cloud, const IndicesConstPtr&, float& w)
+template <typename PointTransform>
+double
+ApproxNearestPairPointCloudCoherence<PointInT>::sumCoherence(
+    const PointCloudIn& cloud, const PointTransform& transform)
 {
   double val = 0.0;
-  // for (std::size_t i = 0; i < indices->size (); i++)
-  for (const auto& point : *cloud) {
+  for (const auto& point : cloud) {
     int k_index = 0;
     float k_distance = 0.0;
-    // PointInT input_point = cloud->points[(*indices)[i]];
-    PointInT input_point = point;
+    PointInT input_point = transform(point);
     search_->approxNearestSearch(input_point, k_index, k_distance);
     if (k_distance < maximum_distance_ * maximum_distance_) {
       PointInT target_point = (*target_input_)[k_index];
@@ -30,7 +29,26 @@ ApproxNearestPairPointCloudCoherence<PointInT>::computeCoherence(
       val += coherence_val;
     }
   }
-  w = -static_cast<float>(val);
+  return val;
+}
+
+template <typename PointInT>
+void
+ApproxNearestPairPointCloudCoherence<PointInT>::computeCoherence(
+    const PointCloudInConstPtr& cloud, const IndicesConstPtr&, float& w)
+{
+  w = -static_cast<float>(
+      sumCoherence(*cloud, [](const PointInT& point) { return point; }));
+}
+
+template <typename PointInT>
+void
+ApproxNearestPairPointCloudCoherence<PointInT>::computeTransformedCoherence(
+    const PointCloudInConstPtr& cloud, const Eigen::Affine3f& trans, float& w)
+{
+  w = -static_cast<float>(sumCoherence(*cloud, [&trans](const PointInT& point) {
+    return detail::transformCoherencePoint(point, trans);
+  }));
 }
 
 template <typename PointInT>
@@ -49,7 +67,9 @@ ApproxNearestPairPointCloudCoherence<PointInT>::initCompute()
     search_.reset(new pcl::search::Octree<PointInT>(0.01));
 
   if (new_target_ && target_input_) {
-    search_->setInputCloud(target_input_);
+    // a search shared with other coherences may already index the target
+    if (search_->getInputCloud() != target_input_)
+      search_->setInputCloud(target_input_);
     new_target_ = false;
   }
 
@@ -1,11 +1,29 @@
 #ifndef PCL_TRACKING_IMPL_COHERENCE_H_
 #define PCL_TRACKING_IMPL_COHERENCE_H_
 
+#include <pcl/common/transforms.h>
 #include <pcl/console/print.h>
 #include <pcl/tracking/coherence.h>
 
 namespace pcl {
 namespace tracking {
+namespace detail {
+/** \brief Transform a point and, if the point type has one, its normal. */
+template <typename PointT>
+inline std::enable_if_t<pcl::traits::has_normal<PointT>::value, PointT>
+transformCoherencePoint(const PointT& point, const Eigen::Affine3f& trans)
+{
+  return pcl::transformPointWithNormal(point, trans);
+}
+
+template <typename PointT>
+inline std::enable_if_t<!pcl::traits::has_normal<PointT>::value, PointT>
+transformCoherencePoint(const PointT& point, const Eigen::Affine3f& trans)
+{
+  return pcl::transformPoint(point, trans);
+}
+} // namespace detail
+
 
 template <typename PointInT>
 double
@@ -55,6 +73,30 @@ PointCloudCoherence<PointInT>::compute(const PointCloudInConstPtr& cloud,
   }
   computeCoherence(cloud, indices, w);
 }
+
+template <typename PointInT>
+void
+PointCloudCoherence<PointInT>::compute(const PointCloudInConstPtr& cloud,
+                                       const Eigen::Affine3f& trans,
+                                       float& w)
+{
+  if (!initCompute()) {
+    PCL_ERROR("[pcl::%s::compute] Init failed.\n", getClassName().c_str());
+    return;
+  }
+  computeTransformedCoherence(cloud, trans, w);
+}
+
+template <typename PointInT>
+void
+PointCloudCoherence<PointInT>::computeTransformedCoherence(
+    const PointCloudInConstPtr& cloud, const Eigen::Affine3f& trans, float& w)
+{
+  PointCloudInPtr transformed(new PointCloudIn(*cloud));
+  for (auto& point : *transformed)
+    point = detail::transformCoherencePoint(point, trans);
+  computeCoherence(transformed, IndicesConstPtr(), w);
+}
 } // namespace tracking
 } // namespace pcl
 
@@ -11,10 +11,9 @@ template <typename PointInT>
 double
 DistanceCoherence<PointInT>::computeCoherence(PointInT& source, PointInT& target)
 {
-  Eigen::Vector4f p = source.getVector4fMap();
-  Eigen::Vector4f p_dash = target.getVector4fMap();
-  double d = (p - p_dash).norm();
-  return 1.0 / (1.0 + d * d * weight_);
+  // squared norm of the packed 4-float difference, no square root needed
+  const double d2 = (source.getVector4fMap() - target.getVector4fMap()).squaredNorm();
+  return 1.0 / (1.0 + d2 * weight_);
 }
 } // namespace tracking
 } // namespace pcl
@@ -14,14 +14,6 @@ KLDAdaptiveParticleFilterTracker<PointInT, StateT>::initCompute()
     return (false);
   }
 
-  if (transed_reference_vector_.empty()) {
-    // only one time allocation
-    transed_reference_vector_.resize(maximum_particle_number_);
-    for (unsigned int i = 0; i < maximum_particle_number_; i++) {
-      transed_reference_vector_[i] = PointCloudInPtr(new PointCloudIn());
-    }
-  }
-
   coherence_->setTargetCloud(input_);
 
   if (!change_detector_)
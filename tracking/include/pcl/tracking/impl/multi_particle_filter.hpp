@@ -0,0 +1,120 @@
+#ifndef PCL_TRACKING_IMPL_MULTI_PARTICLE_FILTER_H_
+#define PCL_TRACKING_IMPL_MULTI_PARTICLE_FILTER_H_
+
+#include <pcl/common/utils.h> // for getNumberOfThreads
+#include <pcl/filters/approximate_voxel_grid.h>
+#include <pcl/tracking/approx_nearest_pair_point_cloud_coherence.h>
+#include <pcl/tracking/multi_particle_filter.h>
+#include <pcl/tracking/nearest_pair_point_cloud_coherence.h>
+
+namespace pcl {
+namespace tracking {
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename StateT>
+void
+MultiParticleFilterTracker<PointInT, StateT>::setNumberOfThreads(unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename StateT>
+std::size_t
+MultiParticleFilterTracker<PointInT, StateT>::addTracker(const TrackerPtr& tracker)
+{
+  tracker->setUseCropping(false);
+  trackers_.push_back(tracker);
+  return (trackers_.size() - 1);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename StateT>
+void
+MultiParticleFilterTracker<PointInT, StateT>::prepareFrame()
+{
+  if (leaf_size_ > 0.0f) {
+    PointCloudInPtr downsampled(new PointCloudIn);
+    pcl::ApproximateVoxelGrid<PointInT> grid;
+    grid.setLeafSize(leaf_size_, leaf_size_, leaf_size_);
+    grid.setInputCloud(input_);
+    grid.filter(*downsampled);
+    frame_ = downsampled;
+  }
+  else
+    frame_ = input_;
+
+  bool use_kdtree = false;
+  bool use_octree = false;
+  for (const auto& tracker : trackers_) {
+    const auto coherence = tracker->getCloudCoherence();
+    if (std::dynamic_pointer_cast<ApproxNearestPairPointCloudCoherence<PointInT>>(
+            coherence))
+      use_octree = true;
+    else if (std::dynamic_pointer_cast<NearestPairPointCloudCoherence<PointInT>>(
+                 coherence))
+      use_kdtree = true;
+  }
+
+  // index the frame once, the coherences see it is already indexed and skip
+  // rebuilding their own search
+  if (use_kdtree) {
+    if (!kdtree_)
+      kdtree_.reset(new KdTree(false));
+    kdtree_->setInputCloud(frame_);
+  }
+  if (use_octree) {
+    if (!octree_)
+      octree_.reset(new Octree(octree_resolution_));
+    octree_->setInputCloud(frame_);
+  }
+
+  for (const auto& tracker : trackers_) {
+    const auto coherence = tracker->getCloudCoherence();
+    if (const auto approx =
+            std::dynamic_pointer_cast<ApproxNearestPairPointCloudCoherence<PointInT>>(
+                coherence))
+      approx->setSearchMethod(octree_);
+    else if (const auto nearest =
+                 std::dynamic_pointer_cast<NearestPairPointCloudCoherence<PointInT>>(
+                     coherence))
+      nearest->setSearchMethod(kdtree_);
+    tracker->setInputCloud(frame_);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename StateT>
+void
+MultiParticleFilterTracker<PointInT, StateT>::compute()
+{
+  if (!input_) {
+    PCL_ERROR("[pcl::%s::compute] No input dataset given!\n", getClassName().c_str());
+    return;
+  }
+
+  prepareFrame();
+
+  // each tracker runs its own particle loop serially when nested in this region
+  // clang-format off
+#pragma omp parallel for \
+  default(none) \
+  schedule(dynamic) \
+  num_threads(pcl::utils::getNumberOfThreads (threads_))
+  // clang-format on
+  for (int i = 0; i < static_cast<int>(trackers_.size()); i++)
+    trackers_[i]->compute();
+}
+} // namespace tracking
+} // namespace pcl
+
+#define PCL_INSTANTIATE_MultiParticleFilterTracker(T, ST)                              \
+  template class PCL_EXPORTS pcl::tracking::MultiParticleFilterTracker<T, ST>;
+
+#endif
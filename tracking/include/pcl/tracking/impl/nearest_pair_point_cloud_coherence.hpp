@@ -8,22 +8,20 @@
 namespace pcl {
 namespace tracking {
 template <typename PointInT>
-void
-NearestPairPointCloudCoherence<PointInT>::computeCoherence(
-    const PointCloudInConstPtr& cloud, const IndicesConstPtr&, float& w)
+template <typename PointTransform>
+double
+NearestPairPointCloudCoherence<PointInT>::sumCoherence(const PointCloudIn& cloud,
+                                                       const PointTransform& transform)
 {
   double val = 0.0;
-  // for (std::size_t i = 0; i < indices->size (); i++)
-  for (std::size_t i = 0; i < cloud->size(); i++) {
-    PointInT input_point = (*cloud)[i];
-    std::vector<int> k_indices(1);
-    std::vector<float> k_distances(1);
+  std::vector<int> k_indices(1);
+  std::vector<float> k_distances(1);
+  for (const auto& point : cloud) {
+    PointInT input_point = transform(point);
     search_->nearestKSearch(input_point, 1, k_indices, k_distances);
     int k_index = k_indices[0];
     float k_distance = k_distances[0];
     if (k_distance < maximum_distance_ * maximum_distance_) {
-      // nearest_targets.push_back (k_index);
-      // nearest_inputs.push_back (i);
       PointInT target_point = (*target_input_)[k_index];
       double coherence_val = 1.0;
       for (std::size_t i = 0; i < point_coherences_.size(); i++) {
@@ -34,7 +32,26 @@ NearestPairPointCloudCoherence<PointInT>::computeCoherence(
       val += coherence_val;
     }
   }
-  w = -static_cast<float>(val);
+  return val;
+}
+
+template <typename PointInT>
+void
+NearestPairPointCloudCoherence<PointInT>::computeCoherence(
+    const PointCloudInConstPtr& cloud, const IndicesConstPtr&, float& w)
+{
+  w = -static_cast<float>(
+      sumCoherence(*cloud, [](const PointInT& point) { return point; }));
+}
+
+template <typename PointInT>
+void
+NearestPairPointCloudCoherence<PointInT>::computeTransformedCoherence(
+    const PointCloudInConstPtr& cloud, const Eigen::Affine3f& trans, float& w)
+{
+  w = -static_cast<float>(sumCoherence(*cloud, [&trans](const PointInT& point) {
+    return detail::transformCoherencePoint(point, trans);
+  }));
 }
 
 template <typename PointInT>
@@ -53,7 +70,9 @@ NearestPairPointCloudCoherence<PointInT>::initCompute()
     search_.reset(new pcl::search::KdTree<PointInT>(false));
 
   if (new_target_ && target_input_) {
-    search_->setInputCloud(target_input_);
+    // a search shared with other coherences may already index the target
+    if (search_->getInputCloud() != target_input_)
+      search_->setInputCloud(target_input_);
     new_target_ = false;
   }
 
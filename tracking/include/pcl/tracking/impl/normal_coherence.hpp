@@ -11,21 +11,24 @@ template <typename PointInT>
 double
 NormalCoherence<PointInT>::computeCoherence(PointInT& source, PointInT& target)
 {
-  Eigen::Vector4f n = source.getNormalVector4fMap();
-  Eigen::Vector4f n_dash = target.getNormalVector4fMap();
-  if (n.norm() <= 1e-5 || n_dash.norm() <= 1e-5) {
+  const Eigen::Vector4f n = source.getNormalVector4fMap();
+  const Eigen::Vector4f n_dash = target.getNormalVector4fMap();
+  const float n_sqr_norm = n.squaredNorm();
+  const float n_dash_sqr_norm = n_dash.squaredNorm();
+  if (n_sqr_norm <= 1e-10f || n_dash_sqr_norm <= 1e-10f) {
     PCL_ERROR("norm might be ZERO!\n");
     std::cout << "source: " << source << std::endl;
     std::cout << "target: " << target << std::endl;
     exit(1);
     return 0.0;
   }
-  n.normalize();
-  n_dash.normalize();
-  double theta = pcl::getAngle3D(n, n_dash);
-  if (!std::isnan(theta))
-    return 1.0 / (1.0 + weight_ * theta * theta);
-  return 0.0;
+  // angle between the normals, normalizing both with a single square root
+  const double cos_theta =
+      n.dot(n_dash) / std::sqrt(static_cast<double>(n_sqr_norm) * n_dash_sqr_norm);
+  if (std::isnan(cos_theta))
+    return 0.0;
+  const double theta = std::acos(std::min(1.0, std::max(-1.0, cos_theta)));
+  return 1.0 / (1.0 + weight_ * theta * theta);
 }
 } // namespace tracking
 } // namespace pcl
@@ -2,6 +2,7 @@
 #define PCL_TRACKING_IMPL_PARTICLE_FILTER_H_
 
 #include <pcl/common/common.h>
+#include <pcl/common/point_tests.h> // for isFinite
 #include <pcl/common/transforms.h>
 #include <pcl/tracking/particle_filter.h>
 
@@ -18,14 +19,6 @@ ParticleFilterTracker<PointInT, StateT>::initCompute()
     return (false);
   }
 
-  if (transed_reference_vector_.empty()) {
-    // only one time allocation
-    transed_reference_vector_.resize(particle_num_);
-    for (int i = 0; i < particle_num_; i++) {
-      transed_reference_vector_[i] = PointCloudInPtr(new PointCloudIn());
-    }
-  }
-
   coherence_->setTargetCloud(input_);
 
   if (!change_detector_)
@@ -42,7 +35,8 @@ int
 ParticleFilterTracker<PointInT, StateT>::sampleWithReplacement(
     const std::vector<int>& a, const std::vector<double>& q)
 {
-  static std::mt19937 rng{std::random_device{}()};
+  // one generator per thread, trackers may run concurrently
+  static thread_local std::mt19937 rng{std::random_device{}()};
   std::uniform_real_distribution<> rd(0.0, 1.0);
 
   double rU = rd(rng) * static_cast<double>(particles_->size());
@@ -194,23 +188,27 @@ ParticleFilterTracker<PointInT, StateT>::calcBoundingBox(double& x_min,
   x_min = y_min = z_min = std::numeric_limits<double>::max();
   x_max = y_max = z_max = -std::numeric_limits<double>::max();
 
-  for (std::size_t i = 0; i < transed_reference_vector_.size(); i++) {
-    PointCloudInPtr target = transed_reference_vector_[i];
-    PointInT Pmin, Pmax;
-    pcl::getMinMax3D(*target, Pmin, Pmax);
-    if (x_min > Pmin.x)
-      x_min = Pmin.x;
-    if (x_max < Pmax.x)
-      x_max = Pmax.x;
-    if (y_min > Pmin.y)
-      y_min = Pmin.y;
-    if (y_max < Pmax.y)
-      y_max = Pmax.y;
-    if (z_min > Pmin.z)
-      z_min = Pmin.z;
-    if (z_max < Pmax.z)
-      z_max = Pmax.z;
+  // bounding box of the reference transformed by all the particles
+  Eigen::Array3f min_pt = Eigen::Array3f::Constant(std::numeric_limits<float>::max());
+  Eigen::Array3f max_pt = Eigen::Array3f::Constant(std::numeric_limits<float>::lowest());
+  for (const auto& particle : *particles_) {
+    const Eigen::Affine3f trans = toEigenMatrix(particle);
+    for (const auto& point : *ref_) {
+      if (!ref_->is_dense && !pcl::isFinite(point))
+        continue;
+      const Eigen::Array3f p = (trans * point.getVector3fMap()).array();
+      min_pt = min_pt.min(p);
+      max_pt = max_pt.max(p);
+    }
   }
+  if ((min_pt > max_pt).any())
+    return;
+  x_min = min_pt.x();
+  y_min = min_pt.y();
+  z_min = min_pt.z();
+  x_max = max_pt.x();
+  y_max = max_pt.y();
+  z_max = max_pt.z();
 }
 
 template <typename PointInT, typename StateT>
@@ -231,41 +229,18 @@ template <typename PointInT, typename StateT>
 void
 ParticleFilterTracker<PointInT, StateT>::weight()
 {
-  if (!use_normal_) {
-    for (std::size_t i = 0; i < particles_->size(); i++) {
-      computeTransformedPointCloudWithoutNormal((*particles_)[i],
-                                                *transed_reference_vector_[i]);
-    }
-
-    PointCloudInPtr coherence_input(new PointCloudIn);
-    cropInputPointCloud(input_, *coherence_input);
-
-    coherence_->setTargetCloud(coherence_input);
-    coherence_->initCompute();
-    for (std::size_t i = 0; i < particles_->size(); i++) {
-      IndicesPtr indices;
-      coherence_->compute(
-          transed_reference_vector_[i], indices, (*particles_)[i].weight);
-    }
+  PointCloudInConstPtr coherence_input = input_;
+  if (use_cropping_) {
+    PointCloudInPtr cropped(new PointCloudIn);
+    cropInputPointCloud(input_, *cropped);
+    coherence_input = cropped;
   }
-  else {
-    for (std::size_t i = 0; i < particles_->size(); i++) {
-      IndicesPtr indices(new std::vector<int>);
-      computeTransformedPointCloudWithNormal(
-          (*particles_)[i], *indices, *transed_reference_vector_[i]);
-    }
 
-    PointCloudInPtr coherence_input(new PointCloudIn);
-    cropInputPointCloud(input_, *coherence_input);
-
-    coherence_->setTargetCloud(coherence_input);
-    coherence_->initCompute();
-    for (std::size_t i = 0; i < particles_->size(); i++) {
-      IndicesPtr indices(new std::vector<int>);
-      coherence_->compute(
-          transed_reference_vector_[i], indices, (*particles_)[i].weight);
-    }
-  }
+  // the reference is transformed point by point, no cloud is allocated per particle
+  coherence_->setTargetCloud(coherence_input);
+  coherence_->initCompute();
+  for (auto& particle : *particles_)
+    coherence_->compute(ref_, toEigenMatrix(particle), particle.weight);
 
   normalizeWeight();
 }
@@ -1,6 +1,7 @@
 #ifndef PCL_TRACKING_IMPL_PARTICLE_OMP_FILTER_H_
 #define PCL_TRACKING_IMPL_PARTICLE_OMP_FILTER_H_
 
+#include <pcl/common/utils.h> // for getNumberOfThreads
 #include <pcl/tracking/particle_filter_omp.h>
 
 namespace pcl {
@@ -25,87 +26,38 @@ template <typename PointInT, typename StateT>
 void
 ParticleFilterOMPTracker<PointInT, StateT>::weight()
 {
+  PointCloudInConstPtr coherence_input = input_;
+  if (use_cropping_) {
+    PointCloudInPtr cropped(new PointCloudIn);
+    this->cropInputPointCloud(input_, *cropped);
+    coherence_input = cropped;
+  }
   if (!use_normal_) {
-    // clang-format off
-#pragma omp parallel for \
-  default(none) \
-  num_threads(threads_)
-    // clang-format on
-    for (int i = 0; i < particle_num_; i++)
-      this->computeTransformedPointCloudWithoutNormal((*particles_)[i],
-                                                      *transed_reference_vector_[i]);
-
-    PointCloudInPtr coherence_input(new PointCloudIn);
-    this->cropInputPointCloud(input_, *coherence_input);
     if (change_counter_ == 0) {
       // test change detector
-      if (!use_change_detector_ || this->testChangeDetection(coherence_input)) {
-        changed_ = true;
-        change_counter_ = change_detector_interval_;
-        coherence_->setTargetCloud(coherence_input);
-        coherence_->initCompute();
-        // clang-format off
-#pragma omp parallel for \
-  default(none) \
-  num_threads(threads_)
-        // clang-format on
-        for (int i = 0; i < particle_num_; i++) {
-          IndicesPtr indices; // dummy
-          coherence_->compute(
-              transed_reference_vector_[i], indices, (*particles_)[i].weight);
-        }
-      }
-      else
+      if (use_change_detector_ && !this->testChangeDetection(coherence_input)) {
         changed_ = false;
-    }
-    else {
-      --change_counter_;
-      coherence_->setTargetCloud(coherence_input);
-      coherence_->initCompute();
-      // clang-format off
-#pragma omp parallel for \
-  default(none) \
-  num_threads(threads_)
-      // clang-format on
-      for (int i = 0; i < particle_num_; i++) {
-        IndicesPtr indices; // dummy
-        coherence_->compute(
-            transed_reference_vector_[i], indices, (*particles_)[i].weight);
+        normalizeWeight();
+        return;
       }
+      changed_ = true;
+      change_counter_ = change_detector_interval_;
     }
+    else
+      --change_counter_;
   }
-  else {
-    std::vector<IndicesPtr> indices_list(particle_num_);
-    for (int i = 0; i < particle_num_; i++) {
-      indices_list[i] = IndicesPtr(new std::vector<int>);
-    }
-    // clang-format off
-#pragma omp parallel for \
-  default(none) \
-  shared(indices_list) \
-  num_threads(threads_)
-    // clang-format on	
-    for (int i = 0; i < particle_num_; i++) {
-      this->computeTransformedPointCloudWithNormal(
-          (*particles_)[i], *indices_list[i], *transed_reference_vector_[i]);
-    }
-
-    PointCloudInPtr coherence_input(new PointCloudIn);
-    this->cropInputPointCloud(input_, *coherence_input);
 
-    coherence_->setTargetCloud(coherence_input);
-    coherence_->initCompute();
-    // clang-format off
+  // the reference is transformed point by point, no cloud is allocated per particle
+  coherence_->setTargetCloud(coherence_input);
+  coherence_->initCompute();
+  // clang-format off
 #pragma omp parallel for \
   default(none) \
-  shared(indices_list) \
-  num_threads(threads_)
-    // clang-format on	
-    for (int i = 0; i < particle_num_; i++) {
-      coherence_->compute(
-          transed_reference_vector_[i], indices_list[i], (*particles_)[i].weight);
-    }
-  }
+  num_threads(pcl::utils::getNumberOfThreads (threads_))
+  // clang-format on
+  for (int i = 0; i < particle_num_; i++)
+    coherence_->compute(
+        ref_, this->toEigenMatrix((*particles_)[i]), (*particles_)[i].weight);
 
   normalizeWeight();
 }
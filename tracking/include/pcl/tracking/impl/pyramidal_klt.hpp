@@ -42,8 +42,53 @@
 #include <pcl/common/time.h>
 #include <pcl/common/utils.h>
 
+#include <algorithm>
+#include <vector>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 namespace pcl {
 namespace tracking {
+namespace detail {
+/** \brief Compute dst[x] = sum_m weights[m] * src[m][x] for x in [0, count), using
+ * AVX or SSE2 instructions when available. The terms are summed in the same order
+ * in all paths, so the result does not depend on the instruction set.
+ */
+inline void
+weightedSum(
+    const float* const* src, const float* weights, int n, float* dst, int count)
+{
+  int x = 0;
+#if defined(__AVX__)
+  for (; x + 8 <= count; x += 8) {
+    __m256 sum = _mm256_mul_ps(_mm256_set1_ps(weights[0]), _mm256_loadu_ps(src[0] + x));
+    for (int m = 1; m < n; ++m)
+      sum = _mm256_add_ps(
+          sum, _mm256_mul_ps(_mm256_set1_ps(weights[m]), _mm256_loadu_ps(src[m] + x)));
+    _mm256_storeu_ps(dst + x, sum);
+  }
+#endif
+#if defined(__SSE2__)
+  for (; x + 4 <= count; x += 4) {
+    __m128 sum = _mm_mul_ps(_mm_set1_ps(weights[0]), _mm_loadu_ps(src[0] + x));
+    for (int m = 1; m < n; ++m)
+      sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(weights[m]), _mm_loadu_ps(src[m] + x)));
+    _mm_storeu_ps(dst + x, sum);
+  }
+#endif
+  for (; x < count; ++x) {
+    float sum = weights[0] * src[0][x];
+    for (int m = 1; m < n; ++m)
+      sum += weights[m] * src[m][x];
+    dst[x] = sum;
+  }
+}
+} // namespace detail
+
 ///////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointInT, typename IntensityT>
 inline void
@@ -190,14 +235,19 @@ PyramidalKLTTracker<PointInT, IntensityT>::derivatives(const FloatImage& src,
     grad_y = FloatImage(src.width, src.height);
 
   int height = src.height, width = src.width;
-  float* row0 = new float[src.width + 2];
-  float* row1 = new float[src.width + 2];
-  float* trow0 = row0;
-  ++trow0;
-  float* trow1 = row1;
-  ++trow1;
+  // one padded row per thread for each of the two vertical passes
+  std::vector<float> row0(width + 2), row1(width + 2);
   const float* src_ptr = &(src[0]);
+  float smooth[3] = {3.f, 10.f, 3.f};
+  float difference[2] = {-1.f, 1.f};
 
+  // clang-format off
+#pragma omp parallel for \
+  default(none) \
+  shared(difference, grad_x, grad_y, height, smooth, src_ptr, width) \
+  firstprivate(row0, row1) \
+  num_threads(threads_)
+  // clang-format on
   for (int y = 0; y < height; y++) {
     const float* srow0 = src_ptr + (y > 0 ? y - 1 : height > 1 ? 1 : 0) * width;
     const float* srow1 = src_ptr + y * width;
@@ -205,12 +255,14 @@ PyramidalKLTTracker<PointInT, IntensityT>::derivatives(const FloatImage& src,
         src_ptr + (y < height - 1 ? y + 1 : height > 1 ? height - 2 : 0) * width;
     float* grad_x_row = &(grad_x[y * width]);
     float* grad_y_row = &(grad_y[y * width]);
+    float* trow0 = row0.data() + 1;
+    float* trow1 = row1.data() + 1;
 
     // do vertical convolution
-    for (int x = 0; x < width; x++) {
-      trow0[x] = (srow0[x] + srow2[x]) * 3 + srow1[x] * 10;
-      trow1[x] = srow2[x] - srow0[x];
-    }
+    const float* smooth_rows[3] = {srow0, srow1, srow2};
+    detail::weightedSum(smooth_rows, smooth, 3, trow0, width);
+    const float* difference_rows[2] = {srow0, srow2};
+    detail::weightedSum(difference_rows, difference, 2, trow1, width);
 
     // make border
     int x0 = width > 1 ? 1 : 0, x1 = width > 1 ? width - 2 : 0;
@@ -220,10 +272,10 @@ PyramidalKLTTracker<PointInT, IntensityT>::derivatives(const FloatImage& src,
     trow1[width] = trow1[x1];
 
     // do horizontal convolution and store results
-    for (int x = 0; x < width; x++) {
-      grad_x_row[x] = trow0[x + 1] - trow0[x - 1];
-      grad_y_row[x] = (trow1[x + 1] + trow1[x - 1]) * 3 + trow1[x] * 10;
-    }
+    const float* grad_x_rows[2] = {trow0 - 1, trow0 + 1};
+    detail::weightedSum(grad_x_rows, difference, 2, grad_x_row, width);
+    const float* grad_y_rows[3] = {trow1 - 1, trow1, trow1 + 1};
+    detail::weightedSum(grad_y_rows, smooth, 3, grad_y_row, width);
   }
 }
 
@@ -233,27 +285,52 @@ void
 PyramidalKLTTracker<PointInT, IntensityT>::downsample(const FloatImageConstPtr& input,
                                                       FloatImageConstPtr& output) const
 {
-  FloatImage smoothed(input->width, input->height);
-  convolve(input, smoothed);
-
-  int width = (smoothed.width + 1) / 2;
-  int height = (smoothed.height + 1) / 2;
-  std::vector<int> ii(width);
-  for (int i = 0; i < width; ++i)
-    ii[i] = 2 * i;
-
-  FloatImagePtr down(new FloatImage(width, height));
+  // smooth and decimate in one go: the rows are smoothed at full resolution but
+  // only their even columns are kept, and the columns are smoothed only at the
+  // even rows
+  int width = input->width;
+  int height = input->height;
+  int down_width = (width + 1) / 2;
+  int down_height = (height + 1) / 2;
+  int last_x = width - kernel_size_2_;
+  int last_y = height - kernel_size_2_;
+  Eigen::Array<float, 5, 1> weights = kernel_.reverse();
+
+  FloatImage smoothed_rows(down_width, height);
+  std::vector<float> row(width);
   // clang-format off
 #pragma omp parallel for \
   default(none) \
-  shared(down, height, output, smoothed, width) \
-  firstprivate(ii) \
+  shared(down_width, height, input, last_x, smoothed_rows, weights, width) \
+  firstprivate(row) \
   num_threads(threads_)
-  // clang-format on	
+  // clang-format on
   for (int j = 0; j < height; ++j) {
-    int jj = 2 * j;
-    for (int i = 0; i < width; ++i)
-      (*down)(i, j) = smoothed(ii[i], jj);
+    const float* src = &(*input)(0, j);
+    const float* rows[5] = {src, src + 1, src + 2, src + 3, src + 4};
+    detail::weightedSum(rows,
+                        weights.data(),
+                        kernel_last_ + 1,
+                        row.data() + kernel_size_2_,
+                        last_x - kernel_size_2_);
+    for (int i = 0; i < down_width; ++i)
+      smoothed_rows(i, j) = row[std::min(std::max(2 * i, kernel_size_2_), last_x - 1)];
+  }
+
+  FloatImagePtr down(new FloatImage(down_width, down_height));
+  // clang-format off
+#pragma omp parallel for \
+  default(none) \
+  shared(down, down_height, down_width, last_y, smoothed_rows, weights) \
+  num_threads(threads_)
+  // clang-format on
+  for (int j = 0; j < down_height; ++j) {
+    int jj = std::min(std::max(2 * j, kernel_size_2_), last_y - 1) - kernel_size_2_;
+    const float* rows[5];
+    for (int k = 0; k <= kernel_last_; ++k)
+      rows[k] = &smoothed_rows(0, jj + k);
+    detail::weightedSum(
+        rows, weights.data(), kernel_last_ + 1, &(*down)(0, j), down_width);
   }
 
   output = down;
@@ -269,8 +346,8 @@ PyramidalKLTTracker<PointInT, IntensityT>::downsample(
     FloatImageConstPtr& output_grad_y) const
 {
   downsample(input, output);
-  FloatImagePtr grad_x(new FloatImage(input->width, input->height));
-  FloatImagePtr grad_y(new FloatImage(input->width, input->height));
+  FloatImagePtr grad_x(new FloatImage(output->width, output->height));
+  FloatImagePtr grad_y(new FloatImage(output->width, output->height));
   derivatives(*output, *grad_x, *grad_y);
   output_grad_x = grad_x;
   output_grad_y = grad_y;
@@ -297,21 +374,22 @@ PyramidalKLTTracker<PointInT, IntensityT>::convolveRows(
   int height = input->height;
   int last = input->width - kernel_size_2_;
   int w = last - 1;
+  Eigen::Array<float, 5, 1> weights = kernel_.reverse();
 
   // clang-format off
 #pragma omp parallel for \
   default(none) \
-  shared(input, height, last, output, w, width) \
+  shared(input, height, last, output, w, weights, width) \
   num_threads(threads_)
   // clang-format on
   for (int j = 0; j < height; ++j) {
-    for (int i = kernel_size_2_; i < last; ++i) {
-      double result = 0;
-      for (int k = kernel_last_, l = i - kernel_size_2_; k > -1; --k, ++l)
-        result += kernel_[k] * (*input)(l, j);
-
-      output(i, j) = static_cast<float>(result);
-    }
+    const float* src = &(*input)(0, j);
+    const float* rows[5] = {src, src + 1, src + 2, src + 3, src + 4};
+    detail::weightedSum(rows,
+                        weights.data(),
+                        kernel_last_ + 1,
+                        &output(kernel_size_2_, j),
+                        last - kernel_size_2_);
 
     for (int i = last; i < width; ++i)
       output(i, j) = output(w, j);
@@ -333,27 +411,27 @@ PyramidalKLTTracker<PointInT, IntensityT>::convolveCols(const FloatImageConstPtr
   int height = input->height;
   int last = input->height - kernel_size_2_;
   int h = last - 1;
+  Eigen::Array<float, 5, 1> weights = kernel_.reverse();
 
+  // row by row, so that every pass reads and writes contiguous memory
   // clang-format off
 #pragma omp parallel for \
   default(none) \
-  shared(input, h, height, last, output, width) \
+  shared(input, last, output, weights, width) \
   num_threads(threads_)
   // clang-format on
-  for (int i = 0; i < width; ++i) {
-    for (int j = kernel_size_2_; j < last; ++j) {
-      double result = 0;
-      for (int k = kernel_last_, l = j - kernel_size_2_; k > -1; --k, ++l)
-        result += kernel_[k] * (*input)(i, l);
-      output(i, j) = static_cast<float>(result);
-    }
+  for (int j = kernel_size_2_; j < last; ++j) {
+    const float* rows[5];
+    for (int k = 0; k <= kernel_last_; ++k)
+      rows[k] = &(*input)(0, j - kernel_size_2_ + k);
+    detail::weightedSum(rows, weights.data(), kernel_last_ + 1, &output(0, j), width);
+  }
 
-    for (int j = last; j < height; ++j)
-      output(i, j) = output(i, h);
+  for (int j = last; j < height; ++j)
+    std::copy_n(&output(0, h), width, &output(0, j));
 
-    for (int j = 0; j < kernel_size_2_; ++j)
-      output(i, j) = output(i, kernel_size_2_);
-  }
+  for (int j = 0; j < kernel_size_2_; ++j)
+    std::copy_n(&output(0, kernel_size_2_), width, &output(0, j));
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////
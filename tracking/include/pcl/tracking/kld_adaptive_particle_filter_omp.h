@@ -35,9 +35,11 @@ public:
   using KLDAdaptiveParticleFilterTracker<PointInT, StateT>::changed_;
   using KLDAdaptiveParticleFilterTracker<PointInT, StateT>::coherence_;
   using KLDAdaptiveParticleFilterTracker<PointInT, StateT>::use_normal_;
+  using KLDAdaptiveParticleFilterTracker<PointInT, StateT>::use_cropping_;
   using KLDAdaptiveParticleFilterTracker<PointInT, StateT>::particle_num_;
   using KLDAdaptiveParticleFilterTracker<PointInT, StateT>::change_detector_filter_;
   using KLDAdaptiveParticleFilterTracker<PointInT, StateT>::transed_reference_vector_;
+  using KLDAdaptiveParticleFilterTracker<PointInT, StateT>::ref_;
   // using KLDAdaptiveParticleFilterTracker<PointInT, StateT>::calcLikelihood;
   using KLDAdaptiveParticleFilterTracker<PointInT, StateT>::normalizeWeight;
   using KLDAdaptiveParticleFilterTracker<PointInT, StateT>::normalizeParticleWeight;
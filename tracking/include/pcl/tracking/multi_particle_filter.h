@@ -0,0 +1,201 @@
+#pragma once
+
+#include <pcl/search/kdtree.h>
+#include <pcl/search/octree.h>
+#include <pcl/tracking/particle_filter.h>
+#include <pcl/memory.h>
+
+#include <string>
+#include <vector>
+
+namespace pcl {
+namespace tracking {
+/** \brief @b MultiParticleFilterTracker tracks several objects in the same
+ * measured PointCloud, one ParticleFilterTracker per object. The per-frame work
+ * that does not depend on the object (downsampling the input and indexing it
+ * for the nearest pair coherences) is done once and shared by all trackers,
+ * which are then updated in parallel using the OpenMP standard.
+ *
+ * The trackers are switched to setUseCropping (false) when added, so that
+ * their coherences can reuse the search structure built over the whole frame.
+ * Point types with normals keep the normals of the input frame, they are not
+ * estimated again per tracker.
+ * \ingroup tracking
+ */
+template <typename PointInT, typename StateT>
+class MultiParticleFilterTracker {
+public:
+  using Ptr = shared_ptr<MultiParticleFilterTracker<PointInT, StateT>>;
+  using ConstPtr = shared_ptr<const MultiParticleFilterTracker<PointInT, StateT>>;
+
+  using Tracker = ParticleFilterTracker<PointInT, StateT>;
+  using TrackerPtr = typename Tracker::Ptr;
+
+  using PointCloudIn = pcl::PointCloud<PointInT>;
+  using PointCloudInPtr = typename PointCloudIn::Ptr;
+  using PointCloudInConstPtr = typename PointCloudIn::ConstPtr;
+
+  using KdTree = pcl::search::KdTree<PointInT>;
+  using KdTreePtr = typename KdTree::Ptr;
+  using Octree = pcl::search::Octree<PointInT>;
+  using OctreePtr = typename Octree::Ptr;
+
+  /** \brief Initialize the scheduler and set the number of threads to use.
+   * \param nr_threads the number of hardware threads to use (0 sets the value
+   * back to automatic)
+   */
+  MultiParticleFilterTracker(unsigned int nr_threads = 0)
+  : leaf_size_(0.0f), octree_resolution_(0.01), frame_(), kdtree_(), octree_()
+  {
+    setNumberOfThreads(nr_threads);
+  }
+
+  /** \brief Initialize the scheduler and set the number of threads to use.
+   * \param nr_threads the number of hardware threads to use (0 sets the value
+   * back to automatic)
+   */
+  void
+  setNumberOfThreads(unsigned int nr_threads = 0);
+
+  /** \brief Add a tracker for one more object. Its reference cloud and
+   * coherence have to be set up by the caller, as for a single tracker.
+   * \param[in] tracker the tracker to add.
+   * \return the index of the tracker.
+   */
+  std::size_t
+  addTracker(const TrackerPtr& tracker);
+
+  /** \brief Get the number of trackers. */
+  inline std::size_t
+  size() const
+  {
+    return (trackers_.size());
+  }
+
+  /** \brief Get the tracker at \a index. */
+  inline TrackerPtr
+  getTracker(std::size_t index) const
+  {
+    return (trackers_[index]);
+  }
+
+  /** \brief Set the leaf size of the voxel grid the input is downsampled with
+   * once per frame. 0 (default) disables the downsampling.
+   * \param[in] leaf_size the leaf size in meters.
+   */
+  inline void
+  setLeafSize(float leaf_size)
+  {
+    leaf_size_ = leaf_size;
+  }
+
+  /** \brief Get the leaf size of the voxel grid. */
+  inline float
+  getLeafSize() const
+  {
+    return (leaf_size_);
+  }
+
+  /** \brief Provide the kd-tree shared by the NearestPairPointCloudCoherence
+   * of the trackers. If not set, one is created when needed.
+   * \param[in] search a pointer to a kd-tree search object.
+   */
+  inline void
+  setSearchMethod(const KdTreePtr& search)
+  {
+    kdtree_ = search;
+  }
+
+  /** \brief Get the kd-tree shared by the trackers. */
+  inline KdTreePtr
+  getSearchMethod() const
+  {
+    return (kdtree_);
+  }
+
+  /** \brief Set the resolution of the octree shared by the
+   * ApproxNearestPairPointCloudCoherence of the trackers.
+   * \param[in] resolution the octree resolution in meters.
+   */
+  inline void
+  setOctreeResolution(double resolution)
+  {
+    octree_resolution_ = resolution;
+    octree_.reset();
+  }
+
+  /** \brief Get the resolution of the shared octree. */
+  inline double
+  getOctreeResolution() const
+  {
+    return (octree_resolution_);
+  }
+
+  /** \brief Provide a pointer to the measured frame.
+   * \param[in] cloud the const boost shared pointer to a PointCloud message
+   */
+  inline void
+  setInputCloud(const PointCloudInConstPtr& cloud)
+  {
+    input_ = cloud;
+  }
+
+  /** \brief Get the frame the trackers were last updated with, i.e. the
+   * downsampled input. */
+  inline PointCloudInConstPtr
+  getFrame() const
+  {
+    return (frame_);
+  }
+
+  /** \brief Update all the trackers with the input cloud. */
+  void
+  compute();
+
+protected:
+  /** \brief Get a string representation of the name of this class. */
+  inline const std::string&
+  getClassName() const
+  {
+    return (tracker_name_);
+  }
+
+  /** \brief Downsample the input into frame_ and rebuild the search
+   * structures the coherences of the trackers use. */
+  void
+  prepareFrame();
+
+  /** \brief The tracker name. */
+  std::string tracker_name_{"MultiParticleFilterTracker"};
+
+  /** \brief The trackers, one per object. */
+  std::vector<TrackerPtr> trackers_;
+
+  /** \brief The number of threads the scheduler should use. */
+  unsigned int threads_;
+
+  /** \brief The leaf size of the voxel grid, 0 if not downsampling. */
+  float leaf_size_;
+
+  /** \brief The resolution of the shared octree. */
+  double octree_resolution_;
+
+  /** \brief The measured frame. */
+  PointCloudInConstPtr input_;
+
+  /** \brief The frame shared by the trackers. */
+  PointCloudInConstPtr frame_;
+
+  /** \brief The kd-tree over frame_ shared by the nearest pair coherences. */
+  KdTreePtr kdtree_;
+
+  /** \brief The octree over frame_ shared by the approximate nearest pair
+   * coherences. */
+  OctreePtr octree_;
+};
+} // namespace tracking
+} // namespace pcl
+
+#ifdef PCL_NO_PRECOMPILE
+#include <pcl/tracking/impl/multi_particle_filter.hpp>
+#endif
@@ -18,6 +18,7 @@ public:
   using PointCloudCoherence<PointInT>::target_input_;
 
   using PointCoherencePtr = typename PointCloudCoherence<PointInT>::PointCoherencePtr;
+  using PointCloudIn = typename PointCloudCoherence<PointInT>::PointCloudIn;
   using PointCloudInConstPtr =
       typename PointCloudCoherence<PointInT>::PointCloudInConstPtr;
   using BaseClass = PointCloudCoherence<PointInT>;
@@ -96,6 +97,19 @@ protected:
   computeCoherence(const PointCloudInConstPtr& cloud,
                    const IndicesConstPtr& indices,
                    float& w_j) override;
+
+  /** \brief compute the nearest pairs of \a cloud transformed by \a trans and
+   * compute coherence using point_coherences_, without copying \a cloud */
+  void
+  computeTransformedCoherence(const PointCloudInConstPtr& cloud,
+                              const Eigen::Affine3f& trans,
+                              float& w_j) override;
+
+  /** \brief Sum up the coherence of the points of \a cloud and their nearest
+   * target points, each point being passed through \a transform first. */
+  template <typename PointTransform>
+  double
+  sumCoherence(const PointCloudIn& cloud, const PointTransform& transform);
 };
 } // namespace tracking
 } // namespace pcl
@@ -75,6 +75,7 @@ public:
   , change_detector_interval_(10)
   , change_detector_resolution_(0.01)
   , use_change_detector_(false)
+  , use_cropping_(true)
   {
     tracker_name_ = "ParticleFilterTracker";
     pass_x_.setFilterFieldName("x");
@@ -320,6 +321,26 @@ public:
     return use_change_detector_;
   }
 
+  /** \brief Set the value of use_cropping_. If true (default), the input is
+   * cropped to the bounding box of the hypotheses before the coherence is
+   * computed, which requires the coherence to index the cropped points every
+   * frame. If false, the coherence uses the whole input, so that a search
+   * structure built once over the input can be reused, e.g. by several trackers.
+   * \param[in] use_cropping the value of use_cropping_.
+   */
+  inline void
+  setUseCropping(bool use_cropping)
+  {
+    use_cropping_ = use_cropping;
+  }
+
+  /** \brief Get the value of use_cropping_. */
+  inline bool
+  getUseCropping() const
+  {
+    return use_cropping_;
+  }
+
   /** \brief Set the motion ratio
    * \param[in] motion_ratio the ratio of hypothesis to use motion model.
    */
@@ -605,7 +626,10 @@ protected:
    * bounding box. */
   pcl::PassThrough<PointInT> pass_z_;
 
-  /** \brief A list of the pointers to pointclouds. */
+  /** \brief A list of the pointers to pointclouds.
+   * \note No longer filled by weight(), the coherence transforms the reference
+   * on the fly. Kept for derived classes.
+   */
   std::vector<PointCloudInPtr> transed_reference_vector_;
 
   /** \brief Change detector used as a trigger to track. */
@@ -630,6 +654,10 @@ protected:
 
   /** \brief The flag which will be true if using change detection. */
   bool use_change_detector_;
+
+  /** \brief The flag which will be true if the input is cropped to the
+   * bounding box of the hypotheses. */
+  bool use_cropping_;
 };
 } // namespace tracking
 } // namespace pcl
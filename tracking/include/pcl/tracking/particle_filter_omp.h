@@ -27,9 +27,11 @@ public:
   using ParticleFilterTracker<PointInT, StateT>::changed_;
   using ParticleFilterTracker<PointInT, StateT>::coherence_;
   using ParticleFilterTracker<PointInT, StateT>::use_normal_;
+  using ParticleFilterTracker<PointInT, StateT>::use_cropping_;
   using ParticleFilterTracker<PointInT, StateT>::particle_num_;
   using ParticleFilterTracker<PointInT, StateT>::change_detector_filter_;
   using ParticleFilterTracker<PointInT, StateT>::transed_reference_vector_;
+  using ParticleFilterTracker<PointInT, StateT>::ref_;
   // using ParticleFilterTracker<PointInT, StateT>::calcLikelihood;
   using ParticleFilterTracker<PointInT, StateT>::normalizeWeight;
   using ParticleFilterTracker<PointInT, StateT>::normalizeParticleWeight;
@@ -36,6 +36,7 @@
  */
 #include <pcl/tracking/impl/particle_filter.hpp>
 #include <pcl/tracking/impl/particle_filter_omp.hpp>
+#include <pcl/tracking/impl/multi_particle_filter.hpp>
 
 #ifndef PCL_NO_PRECOMPILE
 #include <pcl/impl/instantiate.hpp>
@@ -53,6 +54,11 @@ PCL_INSTANTIATE_PRODUCT(ParticleFilterOMPTracker,
                          (pcl::PointXYZINormal)
                          (pcl::PointXYZRGBNormal))
                         (PCL_STATE_POINT_TYPES))
+PCL_INSTANTIATE_PRODUCT(MultiParticleFilterTracker,
+                        ((pcl::PointNormal)
+                         (pcl::PointXYZINormal)
+                         (pcl::PointXYZRGBNormal))
+                        (PCL_STATE_POINT_TYPES))
 // clang-format on
 #undef PCL_TRACKING_NORMAL_SUPPORTED
 // clang-format off
@@ -76,5 +82,15 @@ PCL_INSTANTIATE_PRODUCT(ParticleFilterOMPTracker,
                          (pcl::PointWithViewpoint)
                          (pcl::PointWithScale))
                         (PCL_STATE_POINT_TYPES))
+PCL_INSTANTIATE_PRODUCT(MultiParticleFilterTracker,
+                        ((pcl::PointXYZ)
+                         (pcl::PointXYZI)
+                         (pcl::PointXYZRGBA)
+                         (pcl::PointXYZRGB)
+                         (pcl::InterestPoint)
+                         (pcl::PointWithRange)
+                         (pcl::PointWithViewpoint)
+                         (pcl::PointWithScale))
+                        (PCL_STATE_POINT_TYPES))
 // clang-format on
 #endif // PCL_NO_PRECOMPILE
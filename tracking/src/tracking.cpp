@@ -42,7 +42,8 @@
 double
 pcl::tracking::sampleNormal(double mean, double sigma)
 {
-  static std::mt19937 rng([] {
+  // one generator per thread, trackers may run concurrently
+  static thread_local std::mt19937 rng([] {
     std::random_device rd;
     return rd();
   }());
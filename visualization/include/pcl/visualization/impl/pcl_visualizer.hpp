@@ -61,6 +61,7 @@
 #include <vtkTextProperty.h>
 #include <vtkLODActor.h>
 #include <vtkLineSource.h>
+#include <vtkFloatArray.h>
 
 #include <pcl/visualization/common/shapes.h>
 
@@ -1496,6 +1497,7 @@ pcl::visualization::PCLVisualizer::updatePointCloud (const typename pcl::PointCl
 
   // Update the mapper
   reinterpret_cast<vtkPolyDataMapper*> (am_it->second.actor->GetMapper ())->SetInputData (polydata);
+  updateLODs (am_it->second.actor);
   return (true);
 }
 
@@ -1530,6 +1532,7 @@ pcl::visualization::PCLVisualizer::updatePointCloud (const typename pcl::PointCl
 
   // Update the mapper
   reinterpret_cast<vtkPolyDataMapper*> (am_it->second.actor->GetMapper ())->SetInputData (polydata);
+  updateLODs (am_it->second.actor);
   return (true);
 }
 
@@ -1610,6 +1613,41 @@ pcl::visualization::PCLVisualizer::updatePointCloud (const typename pcl::PointCl
 
   // Update the mapper
   reinterpret_cast<vtkPolyDataMapper*> (am_it->second.actor->GetMapper ())->SetInputData (polydata);
+  updateLODs (am_it->second.actor);
+  return (true);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> bool
+pcl::visualization::PCLVisualizer::updatePointCloudPoints (const typename pcl::PointCloud<PointT>::ConstPtr &cloud,
+                                                           const std::string &id,
+                                                           std::size_t begin,
+                                                           std::size_t end)
+{
+  // Check to see if this ID entry already exists (has it been already added to the visualizer?)
+  CloudActorMap::iterator am_it = cloud_actor_map_->find (id);
+
+  if (am_it == cloud_actor_map_->end ())
+    return (false);
+
+  vtkPolyData *polydata = vtkPolyData::SafeDownCast (am_it->second.actor->GetMapper ()->GetInput ());
+  if (!polydata || !polydata->GetPoints ())
+    return (false);
+
+  // The points are updated in place, so the cloud on screen must have the same size
+  vtkPoints *points = polydata->GetPoints ();
+  vtkFloatArray *array = vtkFloatArray::SafeDownCast (points->GetData ());
+  if (!array || array->GetNumberOfTuples () != static_cast<vtkIdType> (cloud->size ()))
+    return (false);
+
+  end = std::min (end, cloud->size ());
+  float *data = array->GetPointer (0);
+  for (std::size_t i = begin; i < end; ++i)
+    std::copy (&(*cloud)[i].x, &(*cloud)[i].x + 3, &data[3 * i]);
+
+  // Marks the points for upload and invalidates their bounds
+  points->Modified ();
+  updateLODs (am_it->second.actor);
   return (true);
 }
 
@@ -41,6 +41,7 @@
 // PCL includes
 #include <pcl/correspondence.h>
 #include <pcl/ModelCoefficients.h>
+#include <pcl/point_cloud_fwd.h>
 #include <pcl/PolygonMesh.h>
 #include <pcl/TextureMesh.h>
 //
@@ -53,6 +54,8 @@
 #include <pcl/visualization/area_picking_event.h>
 #include <pcl/visualization/interactor_style.h>
 
+#include <limits>
+
 // VTK includes
 class vtkPolyData;
 class vtkTextActor;
@@ -71,7 +74,6 @@ class vtkUnstructuredGrid;
 
 namespace pcl
 {
-  template <typename T> class PointCloud;
   template <typename T> class PlanarPolygon;
 
   namespace visualization
@@ -702,6 +704,23 @@ namespace pcl
                           const PointCloudColorHandler<PointT> &color_handler,
                           const std::string &id = "cloud");
 
+        /** \brief Updates the XYZ data of a range of points of an existing cloud object id in place.
+          * The coordinates are written directly into the points of the cloud on screen, which are neither
+          * reallocated nor filtered, and its vertices and colors are kept. This is the fast path for streams of
+          * clouds of a constant size, e.g. from a LiDAR, where only part of the points may change.
+          * \param[in] cloud the input point cloud dataset, dense and with as many points as the one on screen
+          * \param[in] id the point cloud object id to update (default: cloud)
+          * \param[in] begin the index of the first point to update (default: 0)
+          * \param[in] end the index after the last point to update (default: the end of the cloud)
+          * \return false if no cloud with the specified ID was found or if its number of points differs, in which
+          * case updatePointCloud has to be used
+          */
+        template <typename PointT> bool
+        updatePointCloudPoints (const typename pcl::PointCloud<PointT>::ConstPtr &cloud,
+                                const std::string &id = "cloud",
+                                std::size_t begin = 0,
+                                std::size_t end = std::numeric_limits<std::size_t>::max ());
+
         /** \brief Add a Point Cloud (templated) to screen.
           * \param[in] cloud the input point cloud dataset
           * \param[in] geometry_handler use a geometry handler object to extract the XYZ data
@@ -1936,6 +1955,15 @@ namespace pcl
         void
         setUseVbos (bool use_vbos);
 
+        /** \brief Render the point clouds of more than \a nr_points points with levels of detail.
+          * The clouds are subsampled on the cells of octrees of decreasing depth, and VTK renders the finest level
+          * that fits in the frame time while the camera moves, and the full cloud once it stops. Applies to the
+          * clouds added or updated afterwards.
+          * \param[in] nr_points the number of points above which the levels are built (0 disables them, default)
+          */
+        void
+        setLODPointThreshold (int nr_points);
+
         /** \brief Set the ID of a cloud or shape to be used for LUT display
           * \param[in] id The id of the cloud/shape look up table to be displayed
           * The look up table is displayed by pressing 'u' in the PCLVisualizer */
@@ -2093,6 +2121,9 @@ namespace pcl
         /** \brief Boolean that holds whether or not to use the vtkVertexBufferObjectMapper*/
         bool use_vbos_;
 
+        /** \brief Number of points above which the clouds get octree levels of detail, 0 to disable them. */
+        int lod_threshold_;
+
         /** \brief Internal method. Removes a vtk actor from the screen.
           * \param[in] actor a pointer to the vtk actor object
           * \param[in] viewport the view port where the actor should be removed from (default: all)
@@ -2148,6 +2179,13 @@ namespace pcl
                                    vtkSmartPointer<vtkLODActor> &actor,
                                    bool use_scalars = true) const;
 
+        /** \brief Internal method. Replaces the levels of detail of a cloud actor with subsamplings of the data
+          * of its mapper, if it has more than lod_threshold_ points.
+          * \param[in] actor the vtk actor of the cloud
+          */
+        void
+        updateLODs (vtkLODActor* actor) const;
+
         /** \brief Converts a PCL templated PointCloud object to a vtk polydata object.
           * \param[in] cloud the input PCL PointCloud dataset
           * \param[out] polydata the resultant polydata containing the cloud
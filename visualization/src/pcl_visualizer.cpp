@@ -91,6 +91,8 @@
 #include <vtkTIFFReader.h>
 #include <vtkLookupTable.h>
 #include <vtkTextureUnitManager.h>
+#include <vtkIdList.h>
+#include <vtkMapperCollection.h>
 
 #if VTK_MAJOR_VERSION > 7
 #include <vtkTexture.h>
@@ -109,6 +111,11 @@
 #include <pcl/common/utils.h> // pcl::utils::ignore
 #include <pcl/console/parse.h>
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <unordered_set>
+
 // Support for VTK 7.1 upwards
 #ifdef vtkGenericDataArray_h
 #define SetTupleValue SetTypedTuple
@@ -372,6 +379,9 @@ void pcl::visualization::PCLVisualizer::setupRenderWindow (const std::string& na
   // By default, don't use vertex buffer objects
   use_vbos_ = false;
 
+  // By default, render the clouds at full resolution
+  lod_threshold_ = 0;
+
   // Add all renderers to the window
   rens_->InitTraversal ();
   vtkRenderer* renderer = nullptr;
@@ -1102,6 +1112,47 @@ getDefaultScalarInterpolationForDataSet (vtkDataSet* data)
   return (polyData && polyData->GetNumberOfCells () != polyData->GetNumberOfVerts ());
 }
 
+// Subsamples a cloud on the cells of an octree of the given depth over the bounds, keeping the first point that
+// falls in each cell together with its point data (e.g. the colors).
+vtkSmartPointer<vtkPolyData>
+subsampleOnOctree (vtkPolyData* data, const double bounds[6], int depth)
+{
+  const double extent = std::max ({bounds[1] - bounds[0], bounds[3] - bounds[2], bounds[5] - bounds[4], 1e-9});
+  const double cells = static_cast<double> (std::uint64_t (1) << depth);
+  const double scale = cells / extent;
+
+  vtkPoints* points = data->GetPoints ();
+  std::unordered_set<std::uint64_t> occupied;
+  vtkSmartPointer<vtkIdList> kept = vtkSmartPointer<vtkIdList>::New ();
+  for (vtkIdType i = 0; i < data->GetNumberOfPoints (); ++i)
+  {
+    double p[3];
+    points->GetPoint (i, p);
+    std::uint64_t key = 0;
+    for (int d = 0; d < 3; ++d)
+      key = (key << 21) | static_cast<std::uint64_t> (std::min (cells - 1.0, std::max (0.0, (p[d] - bounds[2 * d]) * scale)));
+    if (occupied.insert (key).second)
+      kept->InsertNextId (i);
+  }
+
+  const vtkIdType nr_kept = kept->GetNumberOfIds ();
+  vtkSmartPointer<vtkPoints> level_points = vtkSmartPointer<vtkPoints>::New ();
+  level_points->SetDataType (points->GetDataType ());
+  points->GetPoints (kept, level_points);
+
+  vtkSmartPointer<vtkPolyData> level = vtkSmartPointer<vtkPolyData>::New ();
+  level->SetPoints (level_points);
+  level->GetPointData ()->CopyAllocate (data->GetPointData (), nr_kept);
+  vtkSmartPointer<vtkCellArray> vertices = vtkSmartPointer<vtkCellArray>::New ();
+  for (vtkIdType i = 0; i < nr_kept; ++i)
+  {
+    level->GetPointData ()->CopyData (data->GetPointData (), kept->GetId (i), i);
+    vertices->InsertNextCell (1, &i);
+  }
+  level->SetVerts (vertices);
+  return (level);
+}
+
 }
 
 /////////////////////////////////////////////////////////////////////////////////////////////
@@ -1180,6 +1231,49 @@ pcl::visualization::PCLVisualizer::createActorFromVTKDataSet (const vtkSmartPoin
 
     actor->SetMapper (mapper);
   }
+
+  updateLODs (actor);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::visualization::PCLVisualizer::updateLODs (vtkLODActor* actor) const
+{
+  // Levels below this size are not worth the switch
+  const vtkIdType min_level_points = 10000;
+
+  actor->GetLODMappers ()->RemoveAllItems ();
+  if (lod_threshold_ <= 0 || !actor->GetMapper ())
+    return;
+
+  // Only clouds, i.e. polydata made of vertices
+  vtkPolyData* data = vtkPolyData::SafeDownCast (actor->GetMapper ()->GetInput ());
+  if (!data || data->GetNumberOfPoints () <= lod_threshold_ || data->GetNumberOfCells () != data->GetNumberOfVerts ())
+    return;
+
+  double bounds[6];
+  data->GetBounds (bounds);
+
+  // Start at the depth where a surface, which occupies about 4^depth cells, keeps an eighth of the points, and
+  // subsample every level from the previous one. vtkLODActor picks among these instead of its random subsamplings.
+  vtkSmartPointer<vtkPolyData> source = data;
+  vtkIdType previous = data->GetNumberOfPoints ();
+  int depth = std::min (20, std::max (1, static_cast<int> (std::log (previous / 8.0) / std::log (4.0))));
+  for (; depth > 0 && previous > min_level_points; --depth)
+  {
+    vtkSmartPointer<vtkPolyData> level = subsampleOnOctree (source, bounds, depth);
+    // Not coarse enough yet, try the next depth
+    if (level->GetNumberOfPoints () * 2 > previous)
+      continue;
+
+    vtkSmartPointer<vtkPolyDataMapper> mapper = vtkSmartPointer<vtkPolyDataMapper>::New ();
+    mapper->ShallowCopy (actor->GetMapper ());
+    mapper->SetInputData (level);
+    actor->AddLODMapper (mapper);
+
+    source = level;
+    previous = level->GetNumberOfPoints ();
+  }
 }
 
 /////////////////////////////////////////////////////////////////////////////////////////////
@@ -4387,6 +4481,13 @@ pcl::visualization::PCLVisualizer::setUseVbos (bool use_vbos)
 #endif
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::visualization::PCLVisualizer::setLODPointThreshold (int nr_points)
+{
+  lod_threshold_ = nr_points;
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////
 void
 pcl::visualization::PCLVisualizer::setLookUpTableID (const std::string id)